@@ -0,0 +1,194 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./BenchmarkComparison.h"
+
+#include <cmath> // for std::sqrt()
+#include <cstdint> // for std::int64_t
+#include <iomanip> // for std::setprecision()
+#include <map> // for std::map
+#include <string> // for std::string
+#include <tuple> // for std::tuple
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Critical values of the one-sided t-distribution at 95% confidence</summary>
+  /// <remarks>
+  ///   Indexed by the degrees of freedom minus one. Beyond 30 degrees of freedom,
+  ///   the t-distribution is close enough to the normal distribution to use its value.
+  /// </remarks>
+  const double CriticalTValues[] = {
+    6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+    1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+    1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697
+  };
+
+  /// <summary>Critical value of the one-sided normal distribution at 95% confidence</summary>
+  const double CriticalNormalValue = 1.645;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a benchmark and problem space across runs</summary>
+  typedef std::tuple<std::string, std::string, std::int64_t> BenchmarkKey;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Forms the key under which a result is matched with its counterpart</summary>
+  /// <param name="result">Result for which the key will be formed</param>
+  /// <returns>The key identifying the result's benchmark and problem space</returns>
+  BenchmarkKey getKey(const Nuclex::Audio::BenchmarkResult &result) {
+    return BenchmarkKey(result.Group, result.Experiment, result.ProblemSpace);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a result's benchmark and problem space for the report</summary>
+  /// <param name="result">Result that will be described</param>
+  /// <returns>A string naming the result's benchmark and problem space</returns>
+  std::string describe(const Nuclex::Audio::BenchmarkResult &result) {
+    return (
+      result.Group + u8"." + result.Experiment + u8" [" +
+      std::to_string(result.ProblemSpace) + u8"]"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the candidate is significantly slower than the baseline</summary>
+  /// <param name="baseline">Result of the benchmark in the baseline run</param>
+  /// <param name="candidate">Result of the benchmark in the candidate run</param>
+  /// <returns>True if Welch's t-test finds the candidate slower with 95% confidence</returns>
+  bool isSignificantlySlower(
+    const Nuclex::Audio::BenchmarkResult &baseline,
+    const Nuclex::Audio::BenchmarkResult &candidate
+  ) {
+    if((baseline.SampleCount < 2) || (candidate.SampleCount < 2)) {
+      return false; // Without a spread, there's nothing to judge significance by
+    }
+
+    double baselineVariance = (
+      baseline.StandardDeviation * baseline.StandardDeviation /
+      static_cast<double>(baseline.SampleCount)
+    );
+    double candidateVariance = (
+      candidate.StandardDeviation * candidate.StandardDeviation /
+      static_cast<double>(candidate.SampleCount)
+    );
+    double combinedVariance = baselineVariance + candidateVariance;
+    if(combinedVariance <= 0.0) {
+      return (candidate.MeanMicroseconds > baseline.MeanMicroseconds);
+    }
+
+    double t = (
+      (candidate.MeanMicroseconds - baseline.MeanMicroseconds) / std::sqrt(combinedVariance)
+    );
+
+    // Welch-Satterthwaite approximation of the degrees of freedom
+    double degreesOfFreedom = combinedVariance * combinedVariance / (
+      (baselineVariance * baselineVariance / static_cast<double>(baseline.SampleCount - 1)) +
+      (candidateVariance * candidateVariance / static_cast<double>(candidate.SampleCount - 1))
+    );
+
+    std::size_t tableCount = sizeof(CriticalTValues) / sizeof(CriticalTValues[0]);
+    double criticalValue = CriticalNormalValue;
+    if(degreesOfFreedom < static_cast<double>(tableCount)) {
+      std::size_t index = static_cast<std::size_t>(degreesOfFreedom); // round down, safer
+      criticalValue = CriticalTValues[(index < 1) ? 0 : (index - 1)];
+    }
+
+    return (t > criticalValue);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CompareBenchmarkResults(
+    const std::vector<BenchmarkResult> &baseline,
+    const std::vector<BenchmarkResult> &candidate,
+    double thresholdPercent,
+    std::ostream &report
+  ) {
+    std::map<BenchmarkKey, const BenchmarkResult *> baselineResults;
+    for(const BenchmarkResult &result : baseline) {
+      baselineResults[getKey(result)] = &result;
+    }
+
+    std::size_t regressionCount = 0;
+    std::size_t improvementCount = 0;
+
+    report << std::fixed << std::setprecision(3);
+    for(const BenchmarkResult &result : candidate) {
+      std::map<BenchmarkKey, const BenchmarkResult *>::iterator match = (
+        baselineResults.find(getKey(result))
+      );
+      if(match == baselineResults.end()) {
+        report << u8"NEW          " << describe(result) << u8"\n";
+        continue;
+      }
+
+      const BenchmarkResult &previous = *match->second;
+      double changePercent = 0.0;
+      if(previous.MeanMicroseconds > 0.0) {
+        changePercent = (
+          (result.MeanMicroseconds - previous.MeanMicroseconds) /
+          previous.MeanMicroseconds * 100.0
+        );
+      }
+
+      const char *verdict;
+      if((changePercent > thresholdPercent) && isSignificantlySlower(previous, result)) {
+        verdict = u8"REGRESSION   ";
+        ++regressionCount;
+      } else if((-changePercent > thresholdPercent) && isSignificantlySlower(result, previous)) {
+        verdict = u8"IMPROVEMENT  ";
+        ++improvementCount;
+      } else {
+        verdict = u8"unchanged    ";
+      }
+
+      report << verdict << describe(result) << u8": " <<
+        previous.MeanMicroseconds << u8" us -> " << result.MeanMicroseconds << u8" us (" <<
+        std::showpos << changePercent << std::noshowpos << u8"%)\n";
+
+      baselineResults.erase(match);
+    }
+
+    for(const std::pair<const BenchmarkKey, const BenchmarkResult *> &missing : baselineResults) {
+      report << u8"REMOVED      " << describe(*missing.second) << u8"\n";
+    }
+
+    report << u8"\n" << regressionCount << u8" regression(s), " <<
+      improvementCount << u8" improvement(s) beyond " << thresholdPercent << u8"%\n";
+
+    return regressionCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
@@ -0,0 +1,65 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_BENCHMARKCOMPARISON_H
+#define NUCLEX_AUDIO_BENCHMARKCOMPARISON_H
+
+#include "Nuclex/Audio/Config.h"
+#include "./BenchmarkReport.h"
+
+#include <cstddef> // for std::size_t
+#include <ostream> // for std::ostream
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares two benchmark runs and reports the benchmarks that got slower</summary>
+  /// <param name="baseline">Results of the run the other is compared against</param>
+  /// <param name="candidate">Results of the run that is checked for regressions</param>
+  /// <param name="thresholdPercent">
+  ///   Slowdown, in percent, below which a difference is not considered a regression
+  /// </param>
+  /// <param name="report">Stream that receives a line for each compared benchmark</param>
+  /// <returns>The number of benchmarks that regressed</returns>
+  /// <remarks>
+  ///   <para>
+  ///     A benchmark has regressed if its mean time per iteration rose by more than
+  ///     the threshold and a one-sided Welch's t-test says, with 95% confidence, that the
+  ///     candidate is slower. The test uses the sample count, mean and standard deviation
+  ///     Celero records, so runs with more samples can detect smaller regressions.
+  ///   </para>
+  ///   <para>
+  ///     Benchmarks present in only one of the runs are listed but never counted as
+  ///     regressions so that adding or removing benchmarks doesn't fail a CI build.
+  ///   </para>
+  /// </remarks>
+  std::size_t CompareBenchmarkResults(
+    const std::vector<BenchmarkResult> &baseline,
+    const std::vector<BenchmarkResult> &candidate,
+    double thresholdPercent,
+    std::ostream &report
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_BENCHMARKCOMPARISON_H
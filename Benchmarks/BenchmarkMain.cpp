@@ -21,11 +21,237 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Config.h"
+#include "./BenchmarkReport.h"
+#include "./BenchmarkComparison.h"
+#include "./DecodeCostFuzzer.h"
+#include "./HardwareCounters.h"
+#include "../Tests/Storage/ResourceDirectoryLocator.h"
 
 #include <celero/Celero.h>
 
+#include <chrono> // for std::chrono::milliseconds
+#include <cstdlib> // for std::strtod(), std::strtoull()
+#include <exception> // for std::exception
+#include <iostream> // for std::cout, std::cerr
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Slowdown, in percent, tolerated by the comparison mode unless specified</summary>
+  const double DefaultThresholdPercent = 5.0;
+
+  /// <summary>Number of inputs the fuzzer tries unless specified</summary>
+  const std::size_t DefaultFuzzIterationCount = 1000;
+
+  /// <summary>Milliseconds per decoded second the fuzzer allows unless specified</summary>
+  const std::size_t DefaultFuzzTimeBudget = 50;
+
+  /// <summary>Heap memory, in MiB, the fuzzer allows unless specified</summary>
+  const std::size_t DefaultFuzzHeapBudget = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks for the path of the result table Celero was asked to write</summary>
+  /// <param name="argc">Number of command line arguments</param>
+  /// <param name="argv">Command line arguments the benchmark was started with</param>
+  /// <returns>The path of the result table or an empty string if none is written</returns>
+  std::string findResultTablePath(int argc, char **argv) {
+    for(int index = 1; index + 1 < argc; ++index) {
+      std::string argument(argv[index]);
+      if((argument == u8"-t") || (argument == u8"--outputTable")) {
+        return std::string(argv[index + 1]);
+      }
+    }
+
+    return std::string();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the path of the JSON report written next to a result table</summary>
+  /// <param name="tablePath">Path of the result table Celero writes</param>
+  /// <returns>The path with its extension replaced by .json</returns>
+  std::string getReportPath(const std::string &tablePath) {
+    std::string::size_type dotIndex = tablePath.find_last_of('.');
+    std::string::size_type slashIndex = tablePath.find_last_of(u8"/\\");
+    if(
+      (dotIndex != std::string::npos) &&
+      ((slashIndex == std::string::npos) || (dotIndex > slashIndex))
+    ) {
+      return tablePath.substr(0, dotIndex) + u8".json";
+    } else {
+      return tablePath + u8".json";
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints the environment the benchmarks are running in</summary>
+  /// <param name="environment">Environment that will be printed</param>
+  void printEnvironment(const Nuclex::Audio::BenchmarkEnvironment &environment) {
+    std::cout <<
+      u8"CPU:                " << environment.CpuName << u8" (" <<
+        environment.HardwareThreadCount << u8" threads)\n" <<
+      u8"Conversion kernels: " << environment.ConversionKernelSet << u8"\n" <<
+      u8"Compiler:           " << environment.Compiler << u8" (" <<
+        environment.Architecture << u8", " <<
+        (environment.IsOptimizedBuild ? u8"optimized" : u8"debug") << u8")\n" <<
+      std::endl;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares the result tables of two benchmark runs</summary>
+  /// <param name="argc">Number of command line arguments</param>
+  /// <param name="argv">Command line arguments the benchmark was started with</param>
+  /// <returns>0 if nothing regressed, 1 if something did, 2 if the arguments are wrong</returns>
+  int compareRuns(int argc, char **argv) {
+    if((argc < 4) || (argc > 5)) {
+      std::cerr <<
+        u8"Usage: " << argv[0] << u8" --compare <baseline.csv> <candidate.csv> [threshold %]" <<
+        std::endl;
+      return 2;
+    }
+
+    double thresholdPercent = DefaultThresholdPercent;
+    if(argc == 5) {
+      thresholdPercent = std::strtod(argv[4], nullptr);
+    }
+
+    std::size_t regressionCount = Nuclex::Audio::CompareBenchmarkResults(
+      Nuclex::Audio::ReadCeleroResultTable(argv[2]),
+      Nuclex::Audio::ReadCeleroResultTable(argv[3]),
+      thresholdPercent,
+      std::cout
+    );
+
+    return (regressionCount == 0) ? 0 : 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Searches for inputs that are costly to decode</summary>
+  /// <param name="argc">Number of command line arguments</param>
+  /// <param name="argv">Command line arguments the benchmark was started with</param>
+  /// <returns>0 if all inputs were within budget, 1 if one wasn't, 2 for wrong arguments</returns>
+  int fuzzDecodeCost(int argc, char **argv) {
+    if(argc > 5) {
+      std::cerr <<
+        u8"Usage: " << argv[0] << u8" --fuzz [iterations] [ms per decoded second] [heap MiB]" <<
+        std::endl;
+      return 2;
+    }
+
+    std::size_t iterationCount = DefaultFuzzIterationCount;
+    if(argc >= 3) {
+      iterationCount = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10));
+    }
+
+    Nuclex::Audio::DecodeCostBudget budget;
+    budget.TimePerDecodedSecond = std::chrono::milliseconds(DefaultFuzzTimeBudget);
+    budget.HeapBytes = DefaultFuzzHeapBudget * 1024 * 1024;
+    if(argc >= 4) {
+      budget.TimePerDecodedSecond = std::chrono::milliseconds(std::strtoull(argv[3], nullptr, 10));
+    }
+    if(argc >= 5) {
+      budget.HeapBytes = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10)) << 20;
+    }
+
+    std::size_t overBudgetCount = Nuclex::Audio::FuzzDecodeCost(
+      iterationCount, budget, Nuclex::Audio::GetResourcesDirectory(), std::cout
+    );
+
+    return (overBudgetCount == 0) ? 0 : 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns on hardware counters if requested and hides the flag from Celero</summary>
+  /// <param name="argc">Number of command line arguments, updated</param>
+  /// <param name="argv">Command line arguments the benchmark was started with, updated</param>
+  void enableHardwareCountersIfRequested(int &argc, char **argv) {
+    for(int index = 1; index < argc; ++index) {
+      if(std::string(argv[index]) == u8"--counters") {
+        for(int shiftIndex = index + 1; shiftIndex < argc; ++shiftIndex) {
+          argv[shiftIndex - 1] = argv[shiftIndex];
+        }
+        --argc;
+
+        if(Nuclex::Audio::HardwareCounters::TryEnable()) {
+          std::cout << u8"Hardware counters:  enabled\n" << std::endl;
+        } else {
+          std::cout << u8"Hardware counters:  unavailable on this system\n" << std::endl;
+        }
+        return;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 // --------------------------------------------------------------------------------------------- //
 
-CELERO_MAIN
+/// <summary>Runs the benchmarks, compares the results of two runs or fuzzes decoders</summary>
+/// <param name="argc">Number of command line arguments</param>
+/// <param name="argv">Command line arguments the benchmark was started with</param>
+/// <returns>The exit code of the benchmark executable</returns>
+/// <remarks>
+///   <para>
+///     All arguments are passed on to Celero. If Celero is told to write its result
+///     table with -t results.csv, a results.json holding the same results plus
+///     the environment they were measured in is written next to it.
+///   </para>
+///   <para>
+///     With --compare baseline.csv candidate.csv, no benchmarks are run. Instead,
+///     the two result tables are compared and the exit code is 1 if any benchmark
+///     got significantly slower, so a CI build can fail on performance regressions.
+///   </para>
+///   <para>
+///     With --fuzz, no benchmarks are run either. Instead, mutated test signals are
+///     decoded to find inputs that take too long or too much memory to decode, which
+///     are recorded in the resources directory for the worst case decode benchmark.
+///     The exit code is 1 if any input exceeded the budget.
+///   </para>
+///   <para>
+///     With --counters, the conversion and decode throughput benchmarks additionally
+///     report instructions per sample, instructions per cycle and cache, branch and TLB
+///     misses per thousand samples, read from the processor's performance counters.
+///   </para>
+/// </remarks>
+int main(int argc, char **argv) {
+  try {
+    if((argc >= 2) && (std::string(argv[1]) == u8"--compare")) {
+      return compareRuns(argc, argv);
+    }
+    if((argc >= 2) && (std::string(argv[1]) == u8"--fuzz")) {
+      return fuzzDecodeCost(argc, argv);
+    }
+
+    Nuclex::Audio::BenchmarkEnvironment environment = (
+      Nuclex::Audio::BenchmarkEnvironment::Detect()
+    );
+    printEnvironment(environment);
+    enableHardwareCountersIfRequested(argc, argv);
+
+    celero::Run(argc, argv);
+
+    std::string tablePath = findResultTablePath(argc, argv);
+    if(!tablePath.empty()) {
+      Nuclex::Audio::WriteBenchmarkReport(
+        getReportPath(tablePath), environment, Nuclex::Audio::ReadCeleroResultTable(tablePath)
+      );
+    }
+  }
+  catch(const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
 
 // --------------------------------------------------------------------------------------------- //
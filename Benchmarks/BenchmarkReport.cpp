@@ -0,0 +1,386 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./BenchmarkReport.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+
+#include <cstdio> // for std::snprintf()
+#include <cstdlib> // for std::strtod(), std::strtoll()
+#include <cstring> // for std::memcpy()
+#include <fstream> // for std::ifstream, std::ofstream
+#include <stdexcept> // for std::runtime_error
+#include <thread> // for std::thread::hardware_concurrency()
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h> // for __cpuid()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h> // for __get_cpuid()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Removes leading and trailing whitespace from a string</summary>
+  /// <param name="text">String that will be trimmed</param>
+  /// <returns>The string without leading or trailing whitespace</returns>
+  std::string trim(const std::string &text) {
+    std::string::size_type start = text.find_first_not_of(u8" \t\r\n");
+    if(start == std::string::npos) {
+      return std::string();
+    }
+
+    std::string::size_type end = text.find_last_not_of(u8" \t\r\n");
+    return text.substr(start, end - start + 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits a line of a CSV file into its fields</summary>
+  /// <param name="line">Line that will be split</param>
+  /// <returns>The fields in the line with quotes removed</returns>
+  std::vector<std::string> splitCsvLine(const std::string &line) {
+    std::vector<std::string> fields;
+
+    std::string field;
+    bool isQuoted = false;
+    for(std::string::size_type index = 0; index < line.length(); ++index) {
+      char character = line[index];
+      if(isQuoted) {
+        if(character == '"') {
+          if((index + 1 < line.length()) && (line[index + 1] == '"')) {
+            field.push_back('"'); // Doubled quote is an escaped quote
+            ++index;
+          } else {
+            isQuoted = false;
+          }
+        } else {
+          field.push_back(character);
+        }
+      } else if(character == '"') {
+        isQuoted = true;
+      } else if(character == ',') {
+        fields.push_back(trim(field));
+        field.clear();
+      } else {
+        field.push_back(character);
+      }
+    }
+    fields.push_back(trim(field));
+
+    return fields;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the value of a column in a result</summary>
+  /// <param name="result">Result in which the column will be looked up</param>
+  /// <param name="name">Name of the column whose value will be returned</param>
+  /// <returns>The value of the column or an empty string if it doesn't exist</returns>
+  std::string getColumn(const Nuclex::Audio::BenchmarkResult &result, const char *name) {
+    for(const std::pair<std::string, std::string> &column : result.Columns) {
+      if(column.first == name) {
+        return column.second;
+      }
+    }
+
+    return std::string();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a string holds nothing but a number</summary>
+  /// <param name="text">String that will be checked</param>
+  /// <returns>True if the whole string forms a number</returns>
+  bool isNumber(const std::string &text) {
+    if(text.empty() || (text.find_first_not_of(u8"0123456789+-.eE") != std::string::npos)) {
+      return false; // Also keeps out "inf" and "nan", which JSON can't represent
+    }
+
+    char *end = nullptr;
+    std::strtod(text.c_str(), &end);
+    return (*end == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Escapes a string for use in a JSON document</summary>
+  /// <param name="text">String that will be escaped</param>
+  /// <returns>The string in quotes with all special characters escaped</returns>
+  std::string toJsonString(const std::string &text) {
+    std::string escaped(1, '"');
+    for(char character : text) {
+      switch(character) {
+        case '"': { escaped.append(u8"\\\""); break; }
+        case '\\': { escaped.append(u8"\\\\"); break; }
+        case '\n': { escaped.append(u8"\\n"); break; }
+        case '\r': { escaped.append(u8"\\r"); break; }
+        case '\t': { escaped.append(u8"\\t"); break; }
+        default: {
+          if(static_cast<unsigned char>(character) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), u8"\\u%04x", static_cast<unsigned>(character));
+            escaped.append(code);
+          } else {
+            escaped.push_back(character);
+          }
+          break;
+        }
+      }
+    }
+    escaped.push_back('"');
+
+    return escaped;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Asks the CPU or the operating system for the name of the CPU</summary>
+  /// <returns>The brand name of the CPU or "unknown" if it can't be determined</returns>
+  std::string getCpuName() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if(static_cast<unsigned int>(registers[0]) >= 0x80000004) {
+      char brand[49] = {};
+      for(int leaf = 0; leaf < 3; ++leaf) {
+        __cpuid(registers, 0x80000002 + leaf);
+        std::memcpy(brand + (leaf * 16), registers, 16);
+      }
+      return trim(brand);
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int registers[4];
+    if(__get_cpuid(0x80000000, &registers[0], &registers[1], &registers[2], &registers[3])) {
+      if(registers[0] >= 0x80000004) {
+        char brand[49] = {};
+        for(unsigned int leaf = 0; leaf < 3; ++leaf) {
+          __get_cpuid(
+            0x80000002 + leaf, &registers[0], &registers[1], &registers[2], &registers[3]
+          );
+          std::memcpy(brand + (leaf * 16), registers, 16);
+        }
+        return trim(brand);
+      }
+    }
+#elif defined(NUCLEX_AUDIO_LINUX)
+    std::ifstream cpuInfo(u8"/proc/cpuinfo");
+    std::string line;
+    while(std::getline(cpuInfo, line)) {
+      std::string::size_type colonIndex = line.find(':');
+      if(colonIndex != std::string::npos) {
+        std::string key = trim(line.substr(0, colonIndex));
+        if((key == u8"model name") || (key == u8"Hardware") || (key == u8"Model")) {
+          return trim(line.substr(colonIndex + 1));
+        }
+      }
+    }
+#endif
+    return std::string(u8"unknown", 7);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the compiler the benchmarks were built with</summary>
+  /// <returns>The name and version of the compiler</returns>
+  std::string getCompiler() {
+#if defined(__clang__)
+    return std::string(u8"Clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return (
+      std::string(u8"GCC ") + std::to_string(__GNUC__) + u8"." +
+      std::to_string(__GNUC_MINOR__) + u8"." + std::to_string(__GNUC_PATCHLEVEL__)
+    );
+#elif defined(_MSC_VER)
+    return std::string(u8"MSVC ") + std::to_string(_MSC_FULL_VER);
+#else
+    return std::string(u8"unknown", 7);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Names the processor architecture the benchmarks were compiled for</summary>
+  /// <returns>The name of the targeted processor architecture</returns>
+  const char *getArchitecture() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return u8"x86-64";
+#elif defined(_M_IX86) || defined(__i386__)
+    return u8"x86";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    return u8"AArch64";
+#elif defined(_M_ARM) || defined(__arm__)
+    return u8"ARM";
+#else
+    return u8"unknown";
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BenchmarkEnvironment BenchmarkEnvironment::Detect() {
+    BenchmarkEnvironment environment;
+
+    environment.CpuName = getCpuName();
+    environment.HardwareThreadCount = std::thread::hardware_concurrency();
+    environment.ConversionKernelSet = (
+      Processing::ConversionKernels::GetActiveKernelSetName()
+    );
+    environment.Compiler = getCompiler();
+    environment.Architecture = getArchitecture();
+#if defined(NDEBUG)
+    environment.IsOptimizedBuild = true;
+#else
+    environment.IsOptimizedBuild = false;
+#endif
+
+    environment.Codecs.emplace_back(u8"Microsoft Waveform");
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    environment.Codecs.emplace_back(u8"FLAC");
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    environment.Codecs.emplace_back(u8"Vorbis");
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    environment.Codecs.emplace_back(u8"Opus");
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    environment.Codecs.emplace_back(u8"WavPack");
+#endif
+
+    return environment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<BenchmarkResult> ReadCeleroResultTable(const std::string &path) {
+    std::ifstream file(path);
+    if(!file) {
+      throw std::runtime_error(u8"Could not open benchmark result table '" + path + u8"'");
+    }
+
+    std::string line;
+    if(!std::getline(file, line)) {
+      throw std::runtime_error(u8"Benchmark result table '" + path + u8"' is empty");
+    }
+    std::vector<std::string> header = splitCsvLine(line);
+
+    std::vector<BenchmarkResult> results;
+    while(std::getline(file, line)) {
+      if(trim(line).empty()) {
+        continue;
+      }
+
+      std::vector<std::string> fields = splitCsvLine(line);
+
+      BenchmarkResult result;
+      for(std::size_t index = 0; index < header.size(); ++index) {
+        result.Columns.emplace_back(
+          header[index], (index < fields.size()) ? fields[index] : std::string()
+        );
+      }
+
+      result.Group = getColumn(result, u8"Group");
+      result.Experiment = getColumn(result, u8"Experiment");
+      result.ProblemSpace = std::strtoll(getColumn(result, u8"Problem Space").c_str(), nullptr, 10);
+      result.SampleCount = static_cast<std::size_t>(
+        std::strtoll(getColumn(result, u8"Samples").c_str(), nullptr, 10)
+      );
+
+      // Older Celero versions only write the mean as "us/Iteration"
+      std::string mean = getColumn(result, u8"Mean (us)");
+      if(mean.empty()) {
+        mean = getColumn(result, u8"us/Iteration");
+      }
+      result.MeanMicroseconds = std::strtod(mean.c_str(), nullptr);
+      result.StandardDeviation = std::strtod(
+        getColumn(result, u8"Standard Deviation").c_str(), nullptr
+      );
+
+      results.push_back(std::move(result));
+    }
+
+    return results;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBenchmarkReport(
+    const std::string &path,
+    const BenchmarkEnvironment &environment,
+    const std::vector<BenchmarkResult> &results
+  ) {
+    std::ofstream file(path);
+    if(!file) {
+      throw std::runtime_error(u8"Could not create benchmark report '" + path + u8"'");
+    }
+
+    file << u8"{\n";
+    file << u8"  \"environment\": {\n";
+    file << u8"    \"cpu\": " << toJsonString(environment.CpuName) << u8",\n";
+    file << u8"    \"hardwareThreads\": " << environment.HardwareThreadCount << u8",\n";
+    file << u8"    \"conversionKernels\": " <<
+      toJsonString(environment.ConversionKernelSet) << u8",\n";
+    file << u8"    \"compiler\": " << toJsonString(environment.Compiler) << u8",\n";
+    file << u8"    \"architecture\": " << toJsonString(environment.Architecture) << u8",\n";
+    file << u8"    \"optimized\": " << (environment.IsOptimizedBuild ? u8"true" : u8"false") <<
+      u8",\n";
+    file << u8"    \"codecs\": [";
+    for(std::size_t index = 0; index < environment.Codecs.size(); ++index) {
+      file << ((index == 0) ? u8" " : u8", ") << toJsonString(environment.Codecs[index]);
+    }
+    file << u8" ]\n";
+    file << u8"  },\n";
+
+    file << u8"  \"results\": [";
+    for(std::size_t index = 0; index < results.size(); ++index) {
+      file << ((index == 0) ? u8"\n" : u8",\n") << u8"    {";
+
+      const std::vector<std::pair<std::string, std::string>> &columns = results[index].Columns;
+      for(std::size_t column = 0; column < columns.size(); ++column) {
+        file << ((column == 0) ? u8" " : u8", ") << toJsonString(columns[column].first) << u8": ";
+        if(isNumber(columns[column].second)) {
+          file << columns[column].second;
+        } else {
+          file << toJsonString(columns[column].second);
+        }
+      }
+
+      file << u8" }";
+    }
+    file << u8"\n  ]\n";
+    file << u8"}\n";
+
+    if(!file) {
+      throw std::runtime_error(u8"Could not write benchmark report '" + path + u8"'");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
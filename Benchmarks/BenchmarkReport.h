@@ -0,0 +1,106 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_BENCHMARKREPORT_H
+#define NUCLEX_AUDIO_BENCHMARKREPORT_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int64_t
+#include <string> // for std::string
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the machine and build a benchmark run was performed with</summary>
+  /// <remarks>
+  ///   Timings from two runs can only be compared if they were taken on the same kind of
+  ///   machine with the same build, so this is stored alongside the results.
+  /// </remarks>
+  struct BenchmarkEnvironment {
+
+    /// <summary>Looks up the environment the benchmark executable is running in</summary>
+    /// <returns>A description of the current machine and build</returns>
+    public: static BenchmarkEnvironment Detect();
+
+    /// <summary>Brand name of the CPU as reported by the processor or the OS</summary>
+    public: std::string CpuName;
+    /// <summary>Number of threads the CPU can run at the same time</summary>
+    public: std::size_t HardwareThreadCount;
+    /// <summary>Instruction set the bulk sample conversion kernels picked</summary>
+    public: std::string ConversionKernelSet;
+    /// <summary>Name and version of the compiler the benchmarks were built with</summary>
+    public: std::string Compiler;
+    /// <summary>Processor architecture the benchmarks were compiled for</summary>
+    public: std::string Architecture;
+    /// <summary>Whether the benchmarks were compiled with assertions disabled</summary>
+    public: bool IsOptimizedBuild;
+    /// <summary>Names of the codecs the benchmarks were compiled with</summary>
+    public: std::vector<std::string> Codecs;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Results of one benchmark and problem space as written by Celero</summary>
+  struct BenchmarkResult {
+
+    /// <summary>Group the benchmark belongs to</summary>
+    public: std::string Group;
+    /// <summary>Name of the benchmark within its group</summary>
+    public: std::string Experiment;
+    /// <summary>Experiment value the benchmark was run with</summary>
+    public: std::int64_t ProblemSpace;
+    /// <summary>Number of samples the statistics were collected from</summary>
+    public: std::size_t SampleCount;
+    /// <summary>Mean time per iteration in microseconds</summary>
+    public: double MeanMicroseconds;
+    /// <summary>Standard deviation of the time per iteration in microseconds</summary>
+    public: double StandardDeviation;
+    /// <summary>All columns of the result as found in the file, name and value</summary>
+    public: std::vector<std::pair<std::string, std::string>> Columns;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the result table Celero writes with its -t option</summary>
+  /// <param name="path">Path of the CSV file holding the result table</param>
+  /// <returns>The results of all benchmarks listed in the table</returns>
+  std::vector<BenchmarkResult> ReadCeleroResultTable(const std::string &path);
+
+  /// <summary>Writes benchmark results and their environment into a JSON file</summary>
+  /// <param name="path">Path of the JSON file that will be written</param>
+  /// <param name="environment">Environment the benchmarks were run in</param>
+  /// <param name="results">Results of the benchmarks</param>
+  void WriteBenchmarkReport(
+    const std::string &path,
+    const BenchmarkEnvironment &environment,
+    const std::vector<BenchmarkResult> &results
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_BENCHMARKREPORT_H
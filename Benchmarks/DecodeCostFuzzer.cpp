@@ -0,0 +1,533 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./DecodeCostFuzzer.h"
+#include "./HeapUsage.h"
+#include "./Storage/EncodedTestSignal.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::min(), std::max(), std::copy_n()
+#include <cstdint> // for std::uint32_t
+#include <fstream> // for std::ifstream, std::ofstream
+#include <iomanip> // for std::setprecision()
+#include <iterator> // for std::size()
+#include <limits> // for std::numeric_limits
+#include <new> // for std::bad_alloc
+#include <optional> // for std::optional
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded per call when decoding a file front to back</summary>
+  const std::size_t ChunkFrameCount = 4096;
+
+  /// <summary>Number of positions that are decoded after seeking</summary>
+  const std::size_t SeekCount = 8;
+
+  /// <summary>Number of frames decoded at each position after seeking</summary>
+  const std::size_t SeekFrameCount = 1024;
+
+  /// <summary>Seconds of audio rejected files are charged for</summary>
+  const double MinimumChargedSeconds = 0.1;
+
+  /// <summary>Time after which decoding a single input is cut off</summary>
+  const std::chrono::seconds InputTimeLimit(2);
+
+  /// <summary>Most mutations that are applied to an input at once</summary>
+  const std::size_t MaximumMutationCount = 4;
+
+  /// <summary>Size up to which inputs may grow by duplicating ranges</summary>
+  const std::size_t MaximumInputSize = 16 * 1024 * 1024;
+
+  /// <summary>Number of leading bytes in which header fields are overwritten</summary>
+  const std::size_t HeaderSize = 512;
+
+  /// <summary>Values header fields are overwritten with, besides random ones</summary>
+  const std::uint32_t ExtremeFieldValues[] = { 0x00000000, 0x00000001, 0x7FFFFFFF, 0xFFFFFFFF };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Input that was found to be costly to decode</summary>
+  struct ScoredInput {
+
+    /// <summary>Contents of the input file</summary>
+    public: std::vector<std::byte> Contents;
+    /// <summary>What decoding the input cost</summary>
+    public: Nuclex::Audio::DecodeCost Cost;
+    /// <summary>Fraction of the budget decoding the input used</summary>
+    public: double Score;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Linear congruential generator that picks the mutations</summary>
+  /// <remarks>
+  ///   The standard library's engines are only guaranteed to produce the same sequence,
+  ///   not the same distributions, so this keeps the inputs identical across compilers.
+  /// </remarks>
+  class Random {
+
+    /// <summary>Initializes a new random number generator</summary>
+    /// <param name="seed">Seed from which the sequence will start</param>
+    public: Random(std::uint32_t seed) : state(seed) {}
+
+    /// <summary>Advances the generator</summary>
+    /// <returns>The next pseudo-random number</returns>
+    public: std::uint32_t Next() {
+      this->state = this->state * 1664525u + 1013904223u;
+      return this->state;
+    }
+
+    /// <summary>Picks a pseudo-random number below the specified limit</summary>
+    /// <param name="limit">Limit the number will be below, must not be zero</param>
+    /// <returns>A pseudo-random number between zero and the limit</returns>
+    public: std::size_t Below(std::size_t limit) {
+      return static_cast<std::size_t>(Next() >> 8) % limit;
+    }
+
+    /// <summary>Current state of the generator</summary>
+    private: std::uint32_t state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lists the codecs whose test signals serve as seeds</summary>
+  /// <returns>The names of all codecs the benchmarks were compiled with</returns>
+  std::vector<std::string> getSeedCodecs() {
+    std::vector<std::string> codecs;
+    codecs.emplace_back(Nuclex::Audio::Storage::WaveformTestCodec::GetName());
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    codecs.emplace_back(Nuclex::Audio::Storage::FlacTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    codecs.emplace_back(Nuclex::Audio::Storage::VorbisTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    codecs.emplace_back(Nuclex::Audio::Storage::OpusTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    codecs.emplace_back(Nuclex::Audio::Storage::WavPackTestCodec::GetName());
+#endif
+    return codecs;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the heap bytes in use, not counting a buffer of the caller</summary>
+  /// <param name="ownBytes">Bytes the caller itself holds on the heap</param>
+  /// <returns>The number of bytes in use on the heap minus the caller's bytes</returns>
+  std::size_t countHeapBytesInUseExcept(std::size_t ownBytes) {
+    std::size_t heapBytes = Nuclex::Audio::CountHeapBytesInUse();
+    return (heapBytes > ownBytes) ? (heapBytes - ownBytes) : 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the entire contents of a virtual file into memory</summary>
+  /// <param name="file">File whose contents will be read</param>
+  /// <returns>The contents of the file</returns>
+  std::vector<std::byte> readAll(const Nuclex::Audio::Storage::VirtualFile &file) {
+    std::vector<std::byte> contents(static_cast<std::size_t>(file.GetSize()));
+    if(!contents.empty()) {
+      file.ReadAt(0, contents.size(), contents.data());
+    }
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Exposes a copy of the specified bytes as a virtual file</summary>
+  /// <param name="contents">Bytes the virtual file will provide</param>
+  /// <returns>A virtual file that reads from a copy of the bytes</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> wrapInFile(
+    const std::vector<std::byte> &contents
+  ) {
+    std::shared_ptr<std::byte[]> memory(new std::byte[std::max<std::size_t>(contents.size(), 1)]);
+    std::copy_n(contents.data(), contents.size(), memory.get());
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, contents.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a file on disk into memory if it exists</summary>
+  /// <param name="path">Path of the file that will be read</param>
+  /// <param name="contents">Receives the contents of the file</param>
+  /// <returns>True if the file existed and was read, false otherwise</returns>
+  bool tryReadInput(const std::string &path, std::vector<std::byte> &contents) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file.good()) {
+      return false;
+    }
+
+    contents.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(contents.data()), contents.size());
+
+    return file.good();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an input into a file on disk</summary>
+  /// <param name="path">Path of the file that will be written</param>
+  /// <param name="contents">Contents that will be written into the file</param>
+  void writeInput(const std::string &path, const std::vector<std::byte> &contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(contents.data()), contents.size());
+    if(!file.good()) {
+      throw std::runtime_error(u8"Could not write worst case input to '" + path + u8"'");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Applies a single random mutation to an input</summary>
+  /// <param name="contents">Input that will be mutated</param>
+  /// <param name="random">Random number generator that picks the mutation</param>
+  void mutate(std::vector<std::byte> &contents, Random &random) {
+    if(contents.size() < 4) {
+      contents.push_back(static_cast<std::byte>(random.Next()));
+      return;
+    }
+
+    switch(random.Below(6)) {
+      case 0: { // Flip a few bits anywhere in the file
+        std::size_t flipCount = 1 + random.Below(8);
+        for(std::size_t index = 0; index < flipCount; ++index) {
+          contents[random.Below(contents.size())] ^= static_cast<std::byte>(1 << random.Below(8));
+        }
+        break;
+      }
+      case 1: { // Overwrite a few bytes anywhere in the file
+        std::size_t start = random.Below(contents.size());
+        std::size_t end = std::min(start + 1 + random.Below(16), contents.size());
+        for(std::size_t index = start; index < end; ++index) {
+          contents[index] = static_cast<std::byte>(random.Next() >> 24);
+        }
+        break;
+      }
+      case 2: { // Set a 32 bit field in the header to an extreme value
+        std::size_t start = random.Below(std::min(contents.size(), HeaderSize) - 3);
+        std::uint32_t value = random.Next();
+        if(random.Below(2) == 0) {
+          value = ExtremeFieldValues[random.Below(std::size(ExtremeFieldValues))];
+        }
+        for(std::size_t index = 0; index < 4; ++index) {
+          contents[start + index] = static_cast<std::byte>(value >> (index * 8));
+        }
+        break;
+      }
+      case 3: { // Cut the file off somewhere
+        contents.resize(random.Below(contents.size()));
+        break;
+      }
+      case 4: { // Repeat a range of the file, duplicating pages, blocks or headers
+        if(contents.size() < MaximumInputSize) {
+          std::size_t start = random.Below(contents.size());
+          std::size_t length = 1 + random.Below(
+            std::min<std::size_t>(contents.size() - start, 65536)
+          );
+          std::vector<std::byte> range(
+            contents.begin() + start, contents.begin() + start + length
+          );
+
+          std::size_t repeatCount = 1 + random.Below(16);
+          std::size_t target = random.Below(contents.size());
+          for(std::size_t index = 0; index < repeatCount; ++index) {
+            contents.insert(contents.begin() + target, range.begin(), range.end());
+          }
+        }
+        break;
+      }
+      default: { // Remove a range of the file
+        std::size_t start = random.Below(contents.size());
+        std::size_t length = 1 + random.Below(std::min<std::size_t>(contents.size() - start, 4096));
+        contents.erase(contents.begin() + start, contents.begin() + start + length);
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds an input to the list of worst inputs if it is among the worst</summary>
+  /// <param name="worstInputs">Worst inputs found so far, worst first</param>
+  /// <param name="contents">Contents of the input that was decoded</param>
+  /// <param name="cost">What decoding the input cost</param>
+  /// <param name="score">Fraction of the budget decoding the input used</param>
+  void considerWorstInput(
+    std::vector<ScoredInput> &worstInputs,
+    const std::vector<std::byte> &contents,
+    const Nuclex::Audio::DecodeCost &cost,
+    double score
+  ) {
+    if(
+      (worstInputs.size() >= Nuclex::Audio::WorstCaseInputCount) &&
+      (score <= worstInputs.back().Score)
+    ) {
+      return;
+    }
+
+    // Mutations don't always change anything and keeping what is the same input
+    // several times would just crowd out others that exercise different slow paths
+    for(const ScoredInput &worstInput : worstInputs) {
+      if(worstInput.Contents == contents) {
+        return;
+      }
+    }
+
+    std::vector<ScoredInput>::iterator position = worstInputs.begin();
+    while((position != worstInputs.end()) && (position->Score >= score)) {
+      ++position;
+    }
+    worstInputs.insert(position, ScoredInput { contents, cost, score });
+
+    if(worstInputs.size() > Nuclex::Audio::WorstCaseInputCount) {
+      worstInputs.pop_back();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a one-line description of what decoding an input cost</summary>
+  /// <param name="report">Stream the description will be written to</param>
+  /// <param name="cost">Cost of decoding the input</param>
+  /// <param name="score">Fraction of the budget decoding the input used</param>
+  void describeCost(std::ostream &report, const Nuclex::Audio::DecodeCost &cost, double score) {
+    report <<
+      std::fixed << std::setprecision(2) << score << u8"x budget, " <<
+      (static_cast<double>(cost.ElapsedTime.count()) / 1000.0) << u8" ms for " <<
+      cost.DecodedSeconds << u8" s of audio, " <<
+      (static_cast<double>(cost.PeakHeapBytes) / 1024.0) << u8" KiB peak heap";
+    if(cost.WasRejected) {
+      report << u8", rejected";
+    }
+    if(cost.RanOutOfMemory) {
+      report << u8", out of memory";
+    }
+    if(cost.WasCutOff) {
+      report << u8", cut off";
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodeCost MeasureDecodeCost(
+    const std::shared_ptr<const Storage::VirtualFile> &file,
+    std::chrono::microseconds timeLimit
+  ) {
+    typedef std::chrono::steady_clock Clock;
+
+    DecodeCost cost = DecodeCost();
+    std::vector<float> samples;
+    std::size_t sampleBytes = 0;
+
+    Clock::time_point startTime = Clock::now();
+    Clock::time_point endTime = startTime + timeLimit;
+    std::size_t initialHeapBytes = CountHeapBytesInUse();
+    std::size_t peakHeapBytes = initialHeapBytes;
+    try {
+      Storage::AudioLoader loader;
+      std::optional<ContainerInfo> info = loader.TryReadInfo(file);
+      if(!info.has_value() || info->Tracks.empty()) {
+        cost.WasRejected = true;
+      } else {
+        std::shared_ptr<Storage::AudioTrackDecoder> decoder = loader.OpenDecoder(file);
+        peakHeapBytes = std::max(peakHeapBytes, CountHeapBytesInUse());
+
+        // The sample buffer is the measurement's and not the decoder's, so it is
+        // subtracted from the heap figures
+        std::uint64_t frameCount = decoder->CountFrames();
+        samples.resize(ChunkFrameCount * decoder->CountChannels());
+        sampleBytes = samples.size() * sizeof(float);
+
+        std::uint64_t position = 0;
+        while(position < frameCount) {
+          if(Clock::now() >= endTime) {
+            cost.WasCutOff = true;
+            break;
+          }
+
+          std::size_t chunkFrameCount = static_cast<std::size_t>(
+            std::min<std::uint64_t>(ChunkFrameCount, frameCount - position)
+          );
+          decoder->DecodeInterleaved<float>(samples.data(), position, chunkFrameCount);
+          position += chunkFrameCount;
+          cost.DecodedFrameCount += chunkFrameCount;
+
+          peakHeapBytes = std::max(peakHeapBytes, countHeapBytesInUseExcept(sampleBytes));
+        }
+
+        for(std::size_t index = 0; index < SeekCount; ++index) {
+          if(cost.WasCutOff || (frameCount < SeekFrameCount)) {
+            break;
+          }
+          if(Clock::now() >= endTime) {
+            cost.WasCutOff = true;
+            break;
+          }
+
+          std::uint64_t seekPosition = (frameCount - SeekFrameCount) * index / SeekCount;
+          decoder->DecodeInterleaved<float>(samples.data(), seekPosition, SeekFrameCount);
+          cost.DecodedFrameCount += SeekFrameCount;
+
+          peakHeapBytes = std::max(peakHeapBytes, countHeapBytesInUseExcept(sampleBytes));
+        }
+
+        if(0 < info->Tracks[0].SampleRate) {
+          cost.DecodedSeconds = (
+            static_cast<double>(cost.DecodedFrameCount) /
+            static_cast<double>(info->Tracks[0].SampleRate)
+          );
+        }
+      }
+    }
+    catch(const std::bad_alloc &) {
+      cost.RanOutOfMemory = true;
+    }
+    catch(const std::exception &) {
+      cost.WasRejected = true;
+    }
+
+    cost.ElapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - startTime
+    );
+    cost.PeakHeapBytes = peakHeapBytes - initialHeapBytes;
+
+    return cost;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double RateDecodeCost(const DecodeCost &cost, const DecodeCostBudget &budget) {
+    if(cost.RanOutOfMemory) {
+      return std::numeric_limits<double>::infinity();
+    }
+
+    double chargedSeconds = std::max(cost.DecodedSeconds, MinimumChargedSeconds);
+    double timeFraction = (
+      static_cast<double>(cost.ElapsedTime.count()) /
+      (chargedSeconds * static_cast<double>(budget.TimePerDecodedSecond.count()))
+    );
+    double heapFraction = (
+      static_cast<double>(cost.PeakHeapBytes) / static_cast<double>(budget.HeapBytes)
+    );
+
+    return std::max(timeFraction, heapFraction);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string GetWorstCaseInputPath(const std::string &directory, std::size_t index) {
+    return directory + u8"worst-case-decode-" + std::to_string(index) + u8".bin";
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t FuzzDecodeCost(
+    std::size_t iterationCount,
+    const DecodeCostBudget &budget,
+    const std::string &directory,
+    std::ostream &report
+  ) {
+    std::vector<std::vector<std::byte>> seeds;
+    for(const std::string &codecName : getSeedCodecs()) {
+      seeds.push_back(readAll(*Storage::EncodeTestSignal(codecName, 2)));
+    }
+
+    std::size_t overBudgetCount = 0;
+    std::vector<ScoredInput> worstInputs;
+
+    // Continue from the worst inputs of earlier runs. If they still exceed the budget,
+    // whatever made them slow hasn't been fixed, so they count again.
+    for(std::size_t index = 0; index < WorstCaseInputCount; ++index) {
+      std::vector<std::byte> contents;
+      if(tryReadInput(GetWorstCaseInputPath(directory, index), contents)) {
+        DecodeCost cost = MeasureDecodeCost(wrapInFile(contents), InputTimeLimit);
+        double score = RateDecodeCost(cost, budget);
+        if(score > 1.0) {
+          ++overBudgetCount;
+          report << u8"OVER BUDGET  earlier worst case " << index << u8": ";
+          describeCost(report, cost, score);
+          report << std::endl;
+        }
+        considerWorstInput(worstInputs, contents, cost, score);
+      }
+    }
+
+    Random random(12345u);
+    for(std::size_t iteration = 0; iteration < iterationCount; ++iteration) {
+      std::vector<std::byte> contents;
+      if(!worstInputs.empty() && (random.Below(2) == 0)) {
+        contents = worstInputs[random.Below(worstInputs.size())].Contents;
+      } else {
+        contents = seeds[random.Below(seeds.size())];
+      }
+
+      std::size_t mutationCount = 1 + random.Below(MaximumMutationCount);
+      for(std::size_t index = 0; index < mutationCount; ++index) {
+        mutate(contents, random);
+      }
+
+      DecodeCost cost = MeasureDecodeCost(wrapInFile(contents), InputTimeLimit);
+      double score = RateDecodeCost(cost, budget);
+      if(score > 1.0) {
+        ++overBudgetCount;
+        report << u8"OVER BUDGET  input " << iteration << u8": ";
+        describeCost(report, cost, score);
+        report << std::endl;
+      }
+
+      considerWorstInput(worstInputs, contents, cost, score);
+    }
+
+    report << u8"\nWorst inputs:\n";
+    for(std::size_t index = 0; index < worstInputs.size(); ++index) {
+      std::string path = GetWorstCaseInputPath(directory, index);
+      writeInput(path, worstInputs[index].Contents);
+
+      report << u8"  " << path << u8": ";
+      describeCost(report, worstInputs[index].Cost, worstInputs[index].Score);
+      report << u8"\n";
+    }
+    report << std::endl;
+
+    return overBudgetCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
@@ -0,0 +1,155 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_DECODECOSTFUZZER_H
+#define NUCLEX_AUDIO_DECODECOSTFUZZER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::microseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <ostream> // for std::ostream
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of worst case inputs the fuzzer keeps</summary>
+  const std::size_t WorstCaseInputCount = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a decoder must stay within when it's fed untrusted input</summary>
+  struct DecodeCostBudget {
+
+    /// <summary>Time the decoder may spend per second of audio it delivers</summary>
+    public: std::chrono::microseconds TimePerDecodedSecond;
+    /// <summary>Number of bytes the decoder may hold on the heap at any point</summary>
+    public: std::size_t HeapBytes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>What it cost to open and decode a file</summary>
+  struct DecodeCost {
+
+    /// <summary>Time spent opening the file and decoding all of it that could be</summary>
+    public: std::chrono::microseconds ElapsedTime;
+    /// <summary>Number of frames the decoder delivered</summary>
+    public: std::uint64_t DecodedFrameCount;
+    /// <summary>Seconds of audio the decoder delivered</summary>
+    public: double DecodedSeconds;
+    /// <summary>Most bytes the decoder held on the heap at any point</summary>
+    public: std::size_t PeakHeapBytes;
+    /// <summary>Whether the decoder rejected the file with an error</summary>
+    public: bool WasRejected;
+    /// <summary>Whether the decoder ran out of memory</summary>
+    public: bool RanOutOfMemory;
+    /// <summary>Whether decoding was cut off because it took too long</summary>
+    public: bool WasCutOff;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file and decodes it completely, measuring what that costs</summary>
+  /// <param name="file">File that will be opened and decoded</param>
+  /// <param name="timeLimit">Time after which decoding will be cut off</param>
+  /// <returns>The time and memory it took to decode the file</returns>
+  /// <remarks>
+  ///   After decoding the file from start to end, a few short ranges at spread out
+  ///   positions are decoded, too, because seeking is where some formats have their slow
+  ///   paths. The time limit is checked between decode calls, so a decoder that hangs
+  ///   inside a single call will hang the measurement as well.
+  /// </remarks>
+  DecodeCost MeasureDecodeCost(
+    const std::shared_ptr<const Storage::VirtualFile> &file,
+    std::chrono::microseconds timeLimit
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rates the cost of decoding a file relative to a budget</summary>
+  /// <param name="cost">Cost of decoding the file</param>
+  /// <param name="budget">Budget the cost will be compared against</param>
+  /// <returns>
+  ///   The largest fraction of the budget used, anything above 1.0 exceeded the budget
+  /// </returns>
+  /// <remarks>
+  ///   Files that were rejected still count as if they had delivered a tenth of a second
+  ///   of audio, so a decoder taking long to notice a file is broken exceeds the budget
+  ///   as well. Running out of memory always exceeds the budget.
+  /// </remarks>
+  double RateDecodeCost(const DecodeCost &cost, const DecodeCostBudget &budget);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the path under which a worst case input is stored</summary>
+  /// <param name="directory">Directory holding the worst case inputs</param>
+  /// <param name="index">Index of the worst case input, 0 being the worst</param>
+  /// <returns>The path of the worst case input with the specified index</returns>
+  std::string GetWorstCaseInputPath(const std::string &directory, std::size_t index);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mutates encoded test signals to find inputs that are costly to decode</summary>
+  /// <param name="iterationCount">Number of mutated inputs that will be tried</param>
+  /// <param name="budget">Limits above which an input is reported</param>
+  /// <param name="directory">Directory the worst inputs will be written into</param>
+  /// <param name="report">Stream that receives a line for each input above budget</param>
+  /// <returns>The number of inputs that exceeded the budget</returns>
+  /// <remarks>
+  ///   <para>
+  ///     The encoded test signals of all codecs the library was compiled with serve as
+  ///     seeds. Each input is either a seed or one of the worst inputs found so far with
+  ///     a few random bit flips, overwritten header fields, truncations, duplicated or
+  ///     removed ranges applied, so the search drifts toward the decoders' slow paths.
+  ///   </para>
+  ///   <para>
+  ///     The worst inputs are written to the directory, replacing those of earlier runs,
+  ///     where the worst case decode benchmark picks them up. The random sequence is
+  ///     fixed, so two runs over the same library build try the same inputs.
+  ///   </para>
+  /// </remarks>
+  std::size_t FuzzDecodeCost(
+    std::size_t iterationCount,
+    const DecodeCostBudget &budget,
+    const std::string &directory,
+    std::ostream &report
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_DECODECOSTFUZZER_H
@@ -0,0 +1,300 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./HardwareCounters.h"
+
+#if defined(NUCLEX_AUDIO_LINUX)
+#include <linux/perf_event.h> // for ::perf_event_attr, PERF_COUNT_HW_*
+#include <sys/ioctl.h> // for ::ioctl()
+#include <sys/syscall.h> // for ::syscall(), __NR_perf_event_open
+#include <unistd.h> // for ::read(), ::close()
+#endif
+
+#include <cstring> // for std::memset()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether the benchmarks should collect hardware counters</summary>
+  bool countersEnabled = false;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measurement showing one hardware counter per processed sample</summary>
+  class CounterMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new counter measurement</summary>
+    /// <param name="name">Name that will be shown in the result table</param>
+    public: CounterMeasurement(const char *name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name that will be shown in the result table</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_LINUX)
+
+  /// <summary>Describes one of the hardware events that will be counted</summary>
+  struct CounterEvent {
+
+    /// <summary>Kind of event, either a generic hardware or a cache event</summary>
+    public: std::uint32_t Type;
+    /// <summary>Event of the specified kind that will be counted</summary>
+    public: std::uint64_t Config;
+
+  };
+
+  /// <summary>Builds the configuration value of a cache read miss event</summary>
+  /// <param name="cache">Cache for which read misses should be counted</param>
+  /// <returns>The configuration value for a perf_event_attr</returns>
+  constexpr std::uint64_t cacheReadMiss(std::uint64_t cache) {
+    return (
+      cache |
+      (std::uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8) |
+      (std::uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16)
+    );
+  }
+
+  /// <summary>Events counted, in the order of the fields in HardwareCounterReading</summary>
+  const CounterEvent CounterEvents[] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_DTLB) }
+  };
+
+  /// <summary>Number of events that will be counted</summary>
+  const std::size_t CounterEventCount = sizeof(CounterEvents) / sizeof(CounterEvent);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a counter for the specified event on the calling thread</summary>
+  /// <param name="event">Event that the counter will count</param>
+  /// <param name="groupFileDescriptor">Counter leading the group or -1 to start a group</param>
+  /// <returns>The file descriptor of the counter or -1 if it couldn't be opened</returns>
+  int openCounter(const CounterEvent &event, int groupFileDescriptor) {
+    ::perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = event.Type;
+    attributes.config = event.Config;
+    attributes.disabled = (groupFileDescriptor == -1) ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = (
+      PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+    );
+
+    return static_cast<int>(
+      ::syscall(__NR_perf_event_open, &attributes, 0, -1, groupFileDescriptor, 0)
+    );
+  }
+
+#endif // defined(NUCLEX_AUDIO_LINUX)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool HardwareCounters::TryEnable() {
+    countersEnabled = HardwareCounters().IsAvailable();
+    return countersEnabled;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool HardwareCounters::IsEnabled() {
+    return countersEnabled;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HardwareCounters::HardwareCounters() {
+#if defined(NUCLEX_AUDIO_LINUX)
+    // Counters the processor doesn't have are skipped, but without the instruction
+    // counter leading the group, nothing else would make sense either.
+    for(std::size_t index = 0; index < CounterEventCount; ++index) {
+      int groupFileDescriptor = this->fileDescriptors.empty() ? -1 : this->fileDescriptors[0];
+      int fileDescriptor = openCounter(CounterEvents[index], groupFileDescriptor);
+      if(fileDescriptor == -1) {
+        if(index == 0) {
+          return;
+        }
+      } else {
+        this->fileDescriptors.push_back(fileDescriptor);
+        this->fieldIndices.push_back(index);
+      }
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HardwareCounters::~HardwareCounters() {
+#if defined(NUCLEX_AUDIO_LINUX)
+    for(std::size_t index = this->fileDescriptors.size(); index > 0; --index) {
+      ::close(this->fileDescriptors[index - 1]);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool HardwareCounters::IsAvailable() const {
+    return !this->fileDescriptors.empty();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HardwareCounters::Start() {
+#if defined(NUCLEX_AUDIO_LINUX)
+    if(!this->fileDescriptors.empty()) {
+      ::ioctl(this->fileDescriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(this->fileDescriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HardwareCounterReading HardwareCounters::Stop() {
+    std::uint64_t fields[6] = { 0, 0, 0, 0, 0, 0 };
+
+#if defined(NUCLEX_AUDIO_LINUX)
+    if(!this->fileDescriptors.empty()) {
+      ::ioctl(this->fileDescriptors[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+      // With PERF_FORMAT_GROUP, the leader delivers the number of counters, the time
+      // the group was enabled and running, followed by the value of each counter
+      std::uint64_t values[3 + CounterEventCount];
+      ::ssize_t byteCount = ::read(this->fileDescriptors[0], values, sizeof(values));
+      if(byteCount >= static_cast<::ssize_t>(3 * sizeof(std::uint64_t))) {
+        std::uint64_t counterCount = values[0];
+        std::uint64_t timeEnabled = values[1];
+        std::uint64_t timeRunning = values[2];
+
+        // If the kernel had to multiplex the counters, extrapolate to the full time
+        double scale = 1.0;
+        if((0 < timeRunning) && (timeRunning < timeEnabled)) {
+          scale = static_cast<double>(timeEnabled) / static_cast<double>(timeRunning);
+        }
+
+        for(std::size_t index = 0; index < this->fieldIndices.size(); ++index) {
+          if(index < counterCount) {
+            fields[this->fieldIndices[index]] = static_cast<std::uint64_t>(
+              static_cast<double>(values[3 + index]) * scale
+            );
+          }
+        }
+      }
+    }
+#endif
+
+    HardwareCounterReading reading;
+    reading.Instructions = fields[0];
+    reading.Cycles = fields[1];
+    reading.L1DataCacheMisses = fields[2];
+    reading.LastLevelCacheMisses = fields[3];
+    reading.BranchMispredictions = fields[4];
+    reading.DataTlbMisses = fields[5];
+    return reading;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HardwareCounterMeasurements::HardwareCounterMeasurements() {
+    if(HardwareCounters::IsEnabled()) {
+      this->counters = std::make_shared<HardwareCounters>();
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"instr/sample"));
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"IPC"));
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"L1D miss/ks"));
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"LLC miss/ks"));
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"branch miss/ks"));
+      this->measurements.push_back(std::make_shared<CounterMeasurement>(u8"dTLB miss/ks"));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<
+    std::shared_ptr<celero::UserDefinedMeasurement>
+  > HardwareCounterMeasurements::Get() const {
+    return std::vector<std::shared_ptr<celero::UserDefinedMeasurement>>(
+      this->measurements.begin(), this->measurements.end()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HardwareCounterMeasurements::Start() {
+    if(static_cast<bool>(this->counters)) {
+      this->counters->Start();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HardwareCounterMeasurements::Stop(std::uint64_t sampleCount) {
+    if(!static_cast<bool>(this->counters)) {
+      return;
+    }
+
+    HardwareCounterReading reading = this->counters->Stop();
+    if(sampleCount == 0) {
+      return;
+    }
+
+    // Misses are shown per thousand samples, raw per-sample figures would be tiny fractions
+    double samples = static_cast<double>(sampleCount);
+    double kilosamples = samples / 1000.0;
+    this->measurements[0]->addValue(static_cast<double>(reading.Instructions) / samples);
+    if(0 < reading.Cycles) {
+      this->measurements[1]->addValue(
+        static_cast<double>(reading.Instructions) / static_cast<double>(reading.Cycles)
+      );
+    }
+    this->measurements[2]->addValue(static_cast<double>(reading.L1DataCacheMisses) / kilosamples);
+    this->measurements[3]->addValue(
+      static_cast<double>(reading.LastLevelCacheMisses) / kilosamples
+    );
+    this->measurements[4]->addValue(
+      static_cast<double>(reading.BranchMispredictions) / kilosamples
+    );
+    this->measurements[5]->addValue(static_cast<double>(reading.DataTlbMisses) / kilosamples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
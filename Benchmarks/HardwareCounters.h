@@ -0,0 +1,154 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_HARDWARECOUNTERS_H
+#define NUCLEX_AUDIO_HARDWARECOUNTERS_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <celero/Celero.h>
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Event counts collected by the processor's performance monitoring unit</summary>
+  /// <remarks>
+  ///   Events the processor (or the virtual machine) doesn't expose are reported as zero.
+  /// </remarks>
+  struct HardwareCounterReading {
+
+    /// <summary>Number of instructions retired</summary>
+    public: std::uint64_t Instructions;
+    /// <summary>Number of processor cycles that elapsed</summary>
+    public: std::uint64_t Cycles;
+    /// <summary>Number of loads that missed the level 1 data cache</summary>
+    public: std::uint64_t L1DataCacheMisses;
+    /// <summary>Number of accesses that missed the last level cache and went to memory</summary>
+    public: std::uint64_t LastLevelCacheMisses;
+    /// <summary>Number of branches the processor predicted wrongly</summary>
+    public: std::uint64_t BranchMispredictions;
+    /// <summary>Number of loads whose address missed the data TLB</summary>
+    public: std::uint64_t DataTlbMisses;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts hardware events while the calling thread runs a benchmark</summary>
+  /// <remarks>
+  ///   <para>
+  ///     On Linux, this uses perf_event_open() to count user-mode events of the calling
+  ///     thread only. This needs /proc/sys/kernel/perf_event_paranoid to be 2 or less,
+  ///     which is the default on most distributions, but many containers and virtual
+  ///     machines don't provide a performance monitoring unit at all.
+  ///   </para>
+  ///   <para>
+  ///     The counters are off unless the benchmark executable is run with --counters
+  ///     because reading them adds two system calls to each sample and the extra columns
+  ///     clutter the result table.
+  ///   </para>
+  /// </remarks>
+  class HardwareCounters {
+
+    /// <summary>Turns on hardware counters for all benchmarks that support them</summary>
+    /// <returns>True if the counters could be opened, false if they're unavailable</returns>
+    public: static bool TryEnable();
+
+    /// <summary>Checks whether the hardware counters have been turned on</summary>
+    /// <returns>True if the benchmarks should collect hardware counters</returns>
+    public: static bool IsEnabled();
+
+    /// <summary>Opens the hardware counters for the calling thread</summary>
+    public: HardwareCounters();
+    /// <summary>Closes the hardware counters</summary>
+    public: ~HardwareCounters();
+
+    /// <summary>Checks whether the hardware counters could be opened</summary>
+    /// <returns>True if the counters are usable, false otherwise</returns>
+    public: bool IsAvailable() const;
+
+    /// <summary>Resets all counters to zero and begins counting</summary>
+    public: void Start();
+
+    /// <summary>Stops counting and reports the counts since the last call to Start()</summary>
+    /// <returns>The number of events that have been counted</returns>
+    public: HardwareCounterReading Stop();
+
+    /// <summary>Opened counters, the first one leading the group</summary>
+    private: std::vector<int> fileDescriptors;
+    /// <summary>Index of the reading field each opened counter is recorded in</summary>
+    private: std::vector<std::size_t> fieldIndices;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reports hardware counters per processed sample in Celero's result table</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Fixtures call <see cref="Start" /> at the end of setUp() and <see cref="Stop" /> at
+  ///     the beginning of tearDown(), so the counts cover exactly the iterations of one
+  ///     sample. Since the instructions executed and the cache misses suffered by a kernel
+  ///     are what decides between compute bound and memory bound, the counts are divided
+  ///     by the number of audio samples processed in between.
+  ///   </para>
+  ///   <para>
+  ///     If the counters are not enabled, no measurements are provided and the fixture's
+  ///     results look exactly like they did without this.
+  ///   </para>
+  /// </remarks>
+  class HardwareCounterMeasurements {
+
+    /// <summary>Initializes the measurements and, if enabled, opens the counters</summary>
+    public: HardwareCounterMeasurements();
+
+    /// <summary>Provides the measurements for the fixture's result table</summary>
+    /// <returns>
+    ///   The measurements holding the counters per sample or nothing if counters are off
+    /// </returns>
+    public: std::vector<std::shared_ptr<celero::UserDefinedMeasurement>> Get() const;
+
+    /// <summary>Begins counting the hardware events of the calling thread</summary>
+    public: void Start();
+
+    /// <summary>Stops counting and records the counts per sample</summary>
+    /// <param name="sampleCount">Number of audio samples processed since Start()</param>
+    public: void Stop(std::uint64_t sampleCount);
+
+    /// <summary>Hardware counters or nothing if the counters are off</summary>
+    private: std::shared_ptr<HardwareCounters> counters;
+    /// <summary>Measurements that receive the counts per sample</summary>
+    private: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurementTemplate<double>>
+    > measurements;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_HARDWARECOUNTERS_H
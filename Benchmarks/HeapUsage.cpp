@@ -0,0 +1,59 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./HeapUsage.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include <malloc.h> // for ::_heapwalk()
+#elif defined(__GLIBC__)
+#include <malloc.h> // for ::mallinfo2(), ::mallinfo()
+#endif
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CountHeapBytesInUse() {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    std::size_t byteCount = 0;
+
+    ::_HEAPINFO entry;
+    entry._pentry = nullptr;
+    while(::_heapwalk(&entry) == _HEAPOK) {
+      if(entry._useflag == _USEDENTRY) {
+        byteCount += entry._size;
+      }
+    }
+
+    return byteCount;
+#elif defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    return ::mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return static_cast<std::size_t>(static_cast<unsigned int>(::mallinfo().uordblks));
+#else
+    return 0;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
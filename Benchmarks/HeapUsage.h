@@ -0,0 +1,51 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_HEAPUSAGE_H
+#define NUCLEX_AUDIO_HEAPUSAGE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the number of bytes currently in use on the C runtime's heap</summary>
+  /// <returns>The number of bytes in all allocated heap blocks</returns>
+  /// <remarks>
+  ///   <para>
+  ///     Unlike the allocation counter, this sees memory that the codec libraries obtain
+  ///     through malloc() directly and it reports what is still held rather than what was
+  ///     handed out. It covers all threads, so it should only be compared between points
+  ///     where no other thread is allocating.
+  ///   </para>
+  ///   <para>
+  ///     On platforms where the heap can't be inspected, zero is returned and anything
+  ///     measured with it will read zero, too.
+  ///   </para>
+  /// </remarks>
+  std::size_t CountHeapBytesInUse();
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_HEAPUSAGE_H
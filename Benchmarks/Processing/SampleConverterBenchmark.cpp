@@ -0,0 +1,453 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "../HardwareCounters.h"
+
+#include <celero/Celero.h>
+
+#include <cmath> // for std::sin(), std::round()
+#include <cstdint> // for std::uint8_t, std::int16_t, std::int32_t
+#include <memory> // for std::shared_ptr
+#include <type_traits> // for std::is_floating_point<>, std::is_same<>
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Buffer sizes, in samples, each conversion is measured with</summary>
+  /// <remarks>
+  ///   Ranges from a tiny buffer where the loop setup dominates over a buffer that comfortably
+  ///   sits in the L1 cache up to one that spills out of the L2 cache on most processors.
+  /// </remarks>
+  const std::int64_t SampleCounts[] = { 64, 1024, 16384, 262144 };
+
+  /// <summary>Number of conversions performed in each sample</summary>
+  /// <remarks>
+  ///   Stated in the experiment values so the fixture knows how many samples were converted
+  ///   when it reports hardware counters per converted sample.
+  /// </remarks>
+  const std::int64_t IterationsPerSample = 100;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a sample into a floating point value between -1.0 and +1.0</summary>
+  /// <typeparam name="TSample">Type of the sample that will be normalized</typeparam>
+  /// <param name="sample">Sample that will be normalized</param>
+  /// <param name="bitCount">Number of valid bits in the sample</param>
+  /// <returns>The sample as a floating point value between -1.0 and +1.0</returns>
+  template<typename TSample>
+  double normalize(TSample sample, std::size_t bitCount) {
+    if constexpr(std::is_floating_point<TSample>::value) {
+      (void)bitCount;
+      return static_cast<double>(sample);
+    } else if constexpr(std::is_same<TSample, std::uint8_t>::value) {
+      std::int32_t value = static_cast<std::int32_t>(sample >> (8 - bitCount));
+      std::int32_t midpoint = (1 << bitCount) / 2;
+      return static_cast<double>(value - midpoint) / static_cast<double>(midpoint - 1);
+    } else {
+      std::int64_t value = static_cast<std::int64_t>(sample) >> (sizeof(TSample) * 8 - bitCount);
+      return static_cast<double>(value) / static_cast<double>((1LL << (bitCount - 1)) - 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a floating point value between -1.0 and +1.0 into a sample</summary>
+  /// <typeparam name="TSample">Type of sample that will be produced</typeparam>
+  /// <param name="value">Value between -1.0 and +1.0 that will be quantized</param>
+  /// <param name="bitCount">Number of valid bits in the produced sample</param>
+  /// <returns>The sample equivalent to the specified floating point value</returns>
+  template<typename TSample>
+  TSample denormalize(double value, std::size_t bitCount) {
+    if(value < -1.0) {
+      value = -1.0;
+    } else if(value > 1.0) {
+      value = 1.0;
+    }
+
+    if constexpr(std::is_floating_point<TSample>::value) {
+      (void)bitCount;
+      return static_cast<TSample>(value);
+    } else if constexpr(std::is_same<TSample, std::uint8_t>::value) {
+      std::int32_t midpoint = (1 << bitCount) / 2;
+      std::int32_t quantized = static_cast<std::int32_t>(std::round(value * (midpoint - 1)));
+      return static_cast<std::uint8_t>((quantized + midpoint) << (8 - bitCount));
+    } else {
+      std::int64_t limit = (1LL << (bitCount - 1)) - 1;
+      std::int64_t quantized = static_cast<std::int64_t>(std::round(value * limit));
+      return static_cast<TSample>(
+        static_cast<std::uint64_t>(quantized) << (sizeof(TSample) * 8 - bitCount)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts samples one by one through a double, the way naive code would</summary>
+  /// <typeparam name="TSourceSample">Type of the source samples</typeparam>
+  /// <typeparam name="TTargetSample">Type of the target samples</typeparam>
+  /// <param name="source">Pointer to the first source sample</param>
+  /// <param name="sourceBitCount">Number of valid bits in the source samples</param>
+  /// <param name="target">Pointer to which the converted samples will be written</param>
+  /// <param name="targetBitCount">Number of valid bits in the target samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSourceSample, typename TTargetSample>
+  void convertNaively(
+    const TSourceSample *source, std::size_t sourceBitCount,
+    TTargetSample *target, std::size_t targetBitCount,
+    std::size_t sampleCount
+  ) {
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      target[index] = denormalize<TTargetSample>(
+        normalize(source[index], sourceBitCount), targetBitCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides source and target buffers for one pair of sample formats</summary>
+  /// <typeparam name="TSourceSample">Type of the source samples</typeparam>
+  /// <typeparam name="SourceBitCount">Number of valid bits in the source samples</typeparam>
+  /// <typeparam name="TTargetSample">Type of the target samples</typeparam>
+  /// <typeparam name="TargetBitCount">Number of valid bits in the target samples</typeparam>
+  template<
+    typename TSourceSample, std::size_t SourceBitCount,
+    typename TTargetSample, std::size_t TargetBitCount
+  >
+  class SampleConversionFixture : public celero::TestFixture {
+
+    /// <summary>Number of valid bits in the source samples</summary>
+    public: static constexpr std::size_t SourceBits = SourceBitCount;
+    /// <summary>Number of valid bits in the target samples</summary>
+    public: static constexpr std::size_t TargetBits = TargetBitCount;
+
+    /// <summary>Lists the buffer sizes the conversion will be measured with</summary>
+    /// <returns>The number of samples converted in each experiment, plus iterations</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t sampleCount : SampleCounts) {
+        experimentValues.emplace_back(sampleCount, IterationsPerSample);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The hardware counters per sample if they are enabled</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return this->counters.Get();
+    }
+
+    /// <summary>Scales the results so Celero reports samples per second</summary>
+    /// <returns>The number of samples converted in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return static_cast<double>(this->Source.size());
+    }
+
+    /// <summary>Prepares the buffers for the next experiment</summary>
+    /// <param name="experimentValue">Number of samples that will be converted</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      std::size_t sampleCount = static_cast<std::size_t>(experimentValue.Value);
+
+      // Generate a sine sweep in floating point and bring it into the source format
+      // through the library itself so the integer samples have their valid bits in place
+      std::vector<float> waveform(sampleCount);
+      for(std::size_t index = 0; index < sampleCount; ++index) {
+        waveform[index] = 0.9f * std::sin(static_cast<float>(index) * 0.0123f);
+      }
+
+      this->Source.resize(sampleCount);
+      Nuclex::Audio::Processing::SampleConverter::Convert(
+        waveform.data(), 32, this->Source.data(), SourceBitCount, sampleCount
+      );
+      this->Target.resize(sampleCount);
+
+      this->counters.Start();
+    }
+
+    /// <summary>Records the hardware counters of the finished experiment</summary>
+    public: void tearDown() override {
+      this->counters.Stop(this->Source.size() * IterationsPerSample);
+    }
+
+    /// <summary>Samples in the source format that will be converted</summary>
+    protected: std::vector<TSourceSample> Source;
+    /// <summary>Receives the samples converted into the target format</summary>
+    protected: std::vector<TTargetSample> Target;
+    /// <summary>Counts cache misses and such if hardware counters are enabled</summary>
+    private: Nuclex::Audio::HardwareCounterMeasurements counters;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Conversion from 8-bit std::uint8_t to 16-bit std::int16_t samples</summary>
+  using UInt8ToInt16Fixture = SampleConversionFixture<std::uint8_t, 8, std::int16_t, 16>;
+
+  /// <summary>Conversion from 8-bit std::uint8_t to 24-bit std::int32_t samples</summary>
+  using UInt8ToInt24Fixture = SampleConversionFixture<std::uint8_t, 8, std::int32_t, 24>;
+
+  /// <summary>Conversion from 8-bit std::uint8_t to 32-bit std::int32_t samples</summary>
+  using UInt8ToInt32Fixture = SampleConversionFixture<std::uint8_t, 8, std::int32_t, 32>;
+
+  /// <summary>Conversion from 8-bit std::uint8_t to 32-bit float samples</summary>
+  using UInt8ToFloatFixture = SampleConversionFixture<std::uint8_t, 8, float, 32>;
+
+  /// <summary>Conversion from 8-bit std::uint8_t to 64-bit double samples</summary>
+  using UInt8ToDoubleFixture = SampleConversionFixture<std::uint8_t, 8, double, 64>;
+
+  /// <summary>Conversion from 16-bit std::int16_t to 8-bit std::uint8_t samples</summary>
+  using Int16ToUInt8Fixture = SampleConversionFixture<std::int16_t, 16, std::uint8_t, 8>;
+
+  /// <summary>Conversion from 16-bit std::int16_t to 24-bit std::int32_t samples</summary>
+  using Int16ToInt24Fixture = SampleConversionFixture<std::int16_t, 16, std::int32_t, 24>;
+
+  /// <summary>Conversion from 16-bit std::int16_t to 32-bit std::int32_t samples</summary>
+  using Int16ToInt32Fixture = SampleConversionFixture<std::int16_t, 16, std::int32_t, 32>;
+
+  /// <summary>Conversion from 16-bit std::int16_t to 32-bit float samples</summary>
+  using Int16ToFloatFixture = SampleConversionFixture<std::int16_t, 16, float, 32>;
+
+  /// <summary>Conversion from 16-bit std::int16_t to 64-bit double samples</summary>
+  using Int16ToDoubleFixture = SampleConversionFixture<std::int16_t, 16, double, 64>;
+
+  /// <summary>Conversion from 24-bit std::int32_t to 8-bit std::uint8_t samples</summary>
+  using Int24ToUInt8Fixture = SampleConversionFixture<std::int32_t, 24, std::uint8_t, 8>;
+
+  /// <summary>Conversion from 24-bit std::int32_t to 16-bit std::int16_t samples</summary>
+  using Int24ToInt16Fixture = SampleConversionFixture<std::int32_t, 24, std::int16_t, 16>;
+
+  /// <summary>Conversion from 24-bit std::int32_t to 32-bit std::int32_t samples</summary>
+  using Int24ToInt32Fixture = SampleConversionFixture<std::int32_t, 24, std::int32_t, 32>;
+
+  /// <summary>Conversion from 24-bit std::int32_t to 32-bit float samples</summary>
+  using Int24ToFloatFixture = SampleConversionFixture<std::int32_t, 24, float, 32>;
+
+  /// <summary>Conversion from 24-bit std::int32_t to 64-bit double samples</summary>
+  using Int24ToDoubleFixture = SampleConversionFixture<std::int32_t, 24, double, 64>;
+
+  /// <summary>Conversion from 32-bit std::int32_t to 8-bit std::uint8_t samples</summary>
+  using Int32ToUInt8Fixture = SampleConversionFixture<std::int32_t, 32, std::uint8_t, 8>;
+
+  /// <summary>Conversion from 32-bit std::int32_t to 16-bit std::int16_t samples</summary>
+  using Int32ToInt16Fixture = SampleConversionFixture<std::int32_t, 32, std::int16_t, 16>;
+
+  /// <summary>Conversion from 32-bit std::int32_t to 24-bit std::int32_t samples</summary>
+  using Int32ToInt24Fixture = SampleConversionFixture<std::int32_t, 32, std::int32_t, 24>;
+
+  /// <summary>Conversion from 32-bit std::int32_t to 32-bit float samples</summary>
+  using Int32ToFloatFixture = SampleConversionFixture<std::int32_t, 32, float, 32>;
+
+  /// <summary>Conversion from 32-bit std::int32_t to 64-bit double samples</summary>
+  using Int32ToDoubleFixture = SampleConversionFixture<std::int32_t, 32, double, 64>;
+
+  /// <summary>Conversion from 32-bit float to 8-bit std::uint8_t samples</summary>
+  using FloatToUInt8Fixture = SampleConversionFixture<float, 32, std::uint8_t, 8>;
+
+  /// <summary>Conversion from 32-bit float to 16-bit std::int16_t samples</summary>
+  using FloatToInt16Fixture = SampleConversionFixture<float, 32, std::int16_t, 16>;
+
+  /// <summary>Conversion from 32-bit float to 24-bit std::int32_t samples</summary>
+  using FloatToInt24Fixture = SampleConversionFixture<float, 32, std::int32_t, 24>;
+
+  /// <summary>Conversion from 32-bit float to 32-bit std::int32_t samples</summary>
+  using FloatToInt32Fixture = SampleConversionFixture<float, 32, std::int32_t, 32>;
+
+  /// <summary>Conversion from 32-bit float to 64-bit double samples</summary>
+  using FloatToDoubleFixture = SampleConversionFixture<float, 32, double, 64>;
+
+  /// <summary>Conversion from 64-bit double to 8-bit std::uint8_t samples</summary>
+  using DoubleToUInt8Fixture = SampleConversionFixture<double, 64, std::uint8_t, 8>;
+
+  /// <summary>Conversion from 64-bit double to 16-bit std::int16_t samples</summary>
+  using DoubleToInt16Fixture = SampleConversionFixture<double, 64, std::int16_t, 16>;
+
+  /// <summary>Conversion from 64-bit double to 24-bit std::int32_t samples</summary>
+  using DoubleToInt24Fixture = SampleConversionFixture<double, 64, std::int32_t, 24>;
+
+  /// <summary>Conversion from 64-bit double to 32-bit std::int32_t samples</summary>
+  using DoubleToInt32Fixture = SampleConversionFixture<double, 64, std::int32_t, 32>;
+
+  /// <summary>Conversion from 64-bit double to 32-bit float samples</summary>
+  using DoubleToFloatFixture = SampleConversionFixture<double, 64, float, 32>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+/// <summary>Emits the benchmarks comparing all conversion paths for one format pair</summary>
+/// <remarks>
+///   The baseline converts naively, one sample at a time through a double. The library's
+///   conversions run with whichever kernel set (scalar, SSE2, AVX2, AVX-512 or NEON) was
+///   selected for the executing processor, see ConversionKernels.h.
+/// </remarks>
+#define NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, NaiveScalar, Fixture, 10, 100) { \
+    convertNaively( \
+      this->Source.data(), Fixture::SourceBits, \
+      this->Target.data(), Fixture::TargetBits, \
+      this->Source.size() \
+    ); \
+    celero::DoNotOptimizeAway(this->Target.data()); \
+  } \
+  BENCHMARK_F(Group, SampleConverter, Fixture, 10, 100) { \
+    Nuclex::Audio::Processing::SampleConverter::Convert( \
+      this->Source.data(), Fixture::SourceBits, \
+      this->Target.data(), Fixture::TargetBits, \
+      this->Source.size() \
+    ); \
+    celero::DoNotOptimizeAway(this->Target.data()); \
+  } \
+  BENCHMARK_F(Group, FixedBitCount, Fixture, 10, 100) { \
+    using Nuclex::Audio::Processing::SampleConverter; \
+    SampleConverter::Convert<Fixture::SourceBits, Fixture::TargetBits>( \
+      this->Source.data(), this->Target.data(), this->Source.size() \
+    ); \
+    celero::DoNotOptimizeAway(this->Target.data()); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(UInt8ToInt16, UInt8ToInt16Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(UInt8ToInt24, UInt8ToInt24Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(UInt8ToInt32, UInt8ToInt32Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(UInt8ToFloat, UInt8ToFloatFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(UInt8ToDouble, UInt8ToDoubleFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int16ToUInt8, Int16ToUInt8Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int16ToInt24, Int16ToInt24Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int16ToInt32, Int16ToInt32Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int16ToFloat, Int16ToFloatFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int16ToDouble, Int16ToDoubleFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int24ToUInt8, Int24ToUInt8Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int24ToInt16, Int24ToInt16Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int24ToInt32, Int24ToInt32Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int24ToFloat, Int24ToFloatFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int24ToDouble, Int24ToDoubleFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int32ToUInt8, Int32ToUInt8Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int32ToInt16, Int32ToInt16Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int32ToInt24, Int32ToInt24Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int32ToFloat, Int32ToFloatFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(Int32ToDouble, Int32ToDoubleFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(FloatToUInt8, FloatToUInt8Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(FloatToInt16, FloatToInt16Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(FloatToInt24, FloatToInt24Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(FloatToInt32, FloatToInt32Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(FloatToDouble, FloatToDoubleFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(DoubleToUInt8, DoubleToUInt8Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(DoubleToInt16, DoubleToInt16Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(DoubleToInt24, DoubleToInt24Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(DoubleToInt32, DoubleToInt32Fixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONVERSION_BENCHMARKS(DoubleToFloat, DoubleToFloatFixture)
+
+// ------------------------------------------------------------------------------------------- //
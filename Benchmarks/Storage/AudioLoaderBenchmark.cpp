@@ -0,0 +1,113 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioCodec.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <celero/Celero.h>
+
+#include <memory> // for std::make_unique()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Codec that does nothing, used to measure the cost of more codecs</summary>
+  /// <typeparam name="Index">Distinguishes the types so each can be registered</typeparam>
+  template<int Index>
+  class DummyAudioCodec : public Nuclex::Audio::Storage::AudioCodec {
+
+    /// <summary>Gives the name of the file format implemented by this codec</summary>
+    /// <returns>The name of the file format this codec implements</returns>
+    public: const std::string &GetName() const override {
+      const static std::string codecName(u8"Dummy", 5);
+      return codecName;
+    }
+
+    /// <summary>Provides commonly used file extensions for this codec</summary>
+    /// <returns>The commonly used file extensions in order of preference</returns>
+    public: const std::vector<std::string> &GetFileExtensions() const override {
+      const static std::vector<std::string> extensions {
+        std::string(u8"dummy") + std::to_string(Index)
+      };
+      return extensions;
+    }
+
+    /// <summary>Tries to read informations for an audio container</summary>
+    /// <returns>Nothing, the dummy codec can't read any files</returns>
+    public: std::optional<Nuclex::Audio::ContainerInfo> TryReadInfo(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &,
+      const std::string & = std::string()
+    ) const override {
+      return std::optional<Nuclex::Audio::ContainerInfo>();
+    }
+
+    /// <summary>Opens a new decoder for the specified audio file</summary>
+    /// <returns>Nothing, the dummy codec can't decode any files</returns>
+    public: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> TryOpenDecoder(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &,
+      const std::string & = std::string(),
+      std::size_t = 0
+    ) const override {
+      return std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder>();
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Registers eight additional dummy codecs with an audio loader</summary>
+  /// <param name="loader">Audio loader the dummy codecs will be registered with</param>
+  void registerDummyCodecs(Nuclex::Audio::Storage::AudioLoader &loader) {
+    loader.RegisterCodec<DummyAudioCodec<0>>();
+    loader.RegisterCodec<DummyAudioCodec<1>>();
+    loader.RegisterCodec<DummyAudioCodec<2>>();
+    loader.RegisterCodec<DummyAudioCodec<3>>();
+    loader.RegisterCodec<DummyAudioCodec<4>>();
+    loader.RegisterCodec<DummyAudioCodec<5>>();
+    loader.RegisterCodec<DummyAudioCodec<6>>();
+    loader.RegisterCodec<DummyAudioCodec<7>>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// --------------------------------------------------------------------------------------------- //
+
+BASELINE(AudioLoaderStartup, ConstructWithBuiltInCodecs, 30, 10000) {
+  Nuclex::Audio::Storage::AudioLoader loader;
+  celero::DoNotOptimizeAway(&loader);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+BENCHMARK(AudioLoaderStartup, ConstructWithEightMoreCodecs, 30, 10000) {
+  Nuclex::Audio::Storage::AudioLoader loader;
+  registerDummyCodecs(loader);
+  celero::DoNotOptimizeAway(&loader);
+}
+
+// --------------------------------------------------------------------------------------------- //
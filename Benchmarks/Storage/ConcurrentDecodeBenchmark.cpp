@@ -0,0 +1,375 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::max()
+#include <chrono> // for std::chrono::steady_clock
+#include <cstdint> // for std::int64_t, std::uint64_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of channels in the decoded test signals</summary>
+  const std::size_t ChannelCount = 2;
+
+  /// <summary>Number of frames each thread decodes per call</summary>
+  const std::size_t ChunkFrameCount = 4096;
+
+  /// <summary>Number of frames each thread decodes per iteration</summary>
+  const std::size_t FramesPerThread = ChunkFrameCount * 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the concurrently decoding threads obtain their decoders</summary>
+  enum class DecoderSharing {
+
+    /// <summary>Each thread opens its own decoder on its own copy of the file</summary>
+    SeparateFiles,
+    /// <summary>One decoder is opened, each thread gets a clone of it</summary>
+    Clones,
+    /// <summary>All threads decode through the very same decoder</summary>
+    SharedDecoder
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records how close the threads came to a linear speedup</summary>
+  class ScalingEfficiencyMeasurement :
+    public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return u8"efficiency %"; }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a file into a separate memory buffer</summary>
+  /// <param name="file">File that will be copied</param>
+  /// <returns>A new file holding the same contents in its own memory</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> copyIntoMemory(
+    const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file
+  ) {
+    std::size_t length = static_cast<std::size_t>(file->GetSize());
+    std::shared_ptr<std::byte[]> memory(new std::byte[length]);
+    file->ReadAt(0, length, memory.get());
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes on a varying number of threads at the same time</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <typeparam name="Sharing">How the threads obtain their decoders</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Each iteration starts one thread per decoder, lets every thread decode the same
+  ///     number of frames at a different position and waits for all of them to finish.
+  ///     Celero's throughput figure is scaled to the seconds of audio decoded by all
+  ///     threads together, so it reads as the aggregate realtime factor.
+  ///   </para>
+  ///   <para>
+  ///     Before each experiment, a single thread does the same work once to provide
+  ///     the reference for the scaling efficiency, 100% meaning that N threads finished
+  ///     in the time one thread needed for its share.
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec, DecoderSharing Sharing>
+  class ConcurrentDecodeFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new concurrent decoding fixture</summary>
+    public: ConcurrentDecodeFixture() :
+      efficiency(std::make_shared<ScalingEfficiencyMeasurement>()),
+      threadCount(0),
+      singleThreadTime(0),
+      elapsedTime(0),
+      iterationCount(0) {}
+
+    /// <summary>Lists the thread counts the decoders will be run with</summary>
+    /// <returns>Powers of two up to the number of hardware threads, plus that number</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::int64_t hardwareThreadCount = std::max<std::int64_t>(
+        std::thread::hardware_concurrency(), 1
+      );
+
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t count = 1; count < hardwareThreadCount; count *= 2) {
+        experimentValues.emplace_back(count);
+      }
+      experimentValues.emplace_back(hardwareThreadCount);
+
+      return experimentValues;
+    }
+
+    /// <summary>Scales the results so Celero reports the aggregate realtime factor</summary>
+    /// <returns>The seconds of audio decoded by all threads in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return (
+        static_cast<double>(this->threadCount * FramesPerThread) /
+        static_cast<double>(Nuclex::Audio::Storage::TestSignalSampleRate)
+      );
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurement recording the scaling efficiency</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->efficiency };
+    }
+
+    /// <summary>Opens the decoders and measures the single-threaded reference</summary>
+    /// <param name="experimentValue">Number of threads that will decode concurrently</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      this->threadCount = static_cast<std::size_t>(experimentValue.Value);
+
+      Nuclex::Audio::Storage::AudioLoader loader;
+      std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), ChannelCount)
+      );
+
+      this->decoders.clear();
+      if constexpr(Sharing == DecoderSharing::SeparateFiles) {
+        for(std::size_t index = 0; index < this->threadCount; ++index) {
+          this->decoders.push_back(loader.OpenDecoder(copyIntoMemory(file)));
+        }
+      } else {
+        std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+          loader.OpenDecoder(file)
+        );
+        for(std::size_t index = 0; index < this->threadCount; ++index) {
+          if constexpr(Sharing == DecoderSharing::Clones) {
+            this->decoders.push_back(decoder->Clone());
+          } else {
+            this->decoders.push_back(decoder);
+          }
+        }
+      }
+
+      // Decode each thread's share once on this thread alone as the scaling reference.
+      // This also warms up the decoders so lazily built state doesn't skew the first run.
+      std::vector<float> samples(ChunkFrameCount * ChannelCount);
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      decodeShare(*this->decoders[0], 0, samples.data());
+      this->singleThreadTime = std::chrono::steady_clock::now() - startTime;
+      for(std::size_t index = 1; index < this->threadCount; ++index) {
+        decodeShare(*this->decoders[index], index, samples.data());
+      }
+
+      this->elapsedTime = std::chrono::steady_clock::duration(0);
+      this->iterationCount = 0;
+    }
+
+    /// <summary>Records the scaling efficiency of the finished experiment</summary>
+    public: void tearDown() override {
+      if(0 < this->iterationCount) {
+        double averageTime = (
+          std::chrono::duration<double>(this->elapsedTime).count() /
+          static_cast<double>(this->iterationCount)
+        );
+        double referenceTime = std::chrono::duration<double>(this->singleThreadTime).count();
+        this->efficiency->addValue(referenceTime / averageTime * 100.0);
+      }
+
+      this->decoders.clear();
+    }
+
+    /// <summary>Lets all threads decode their share at the same time</summary>
+    protected: void DecodeConcurrently() {
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+      std::vector<std::thread> threads;
+      threads.reserve(this->threadCount);
+      for(std::size_t index = 0; index < this->threadCount; ++index) {
+        threads.emplace_back(
+          [this, index]() {
+            std::vector<float> samples(ChunkFrameCount * ChannelCount);
+            decodeShare(*this->decoders[index], index, samples.data());
+          }
+        );
+      }
+      for(std::thread &thread : threads) {
+        thread.join();
+      }
+
+      this->elapsedTime += std::chrono::steady_clock::now() - startTime;
+      ++this->iterationCount;
+    }
+
+    /// <summary>Decodes the frames one thread is responsible for</summary>
+    /// <param name="decoder">Decoder the thread will use</param>
+    /// <param name="threadIndex">Index of the thread, selects the decoded region</param>
+    /// <param name="samples">Buffer receiving the decoded samples</param>
+    private: static void decodeShare(
+      const Nuclex::Audio::Storage::AudioTrackDecoder &decoder, std::size_t threadIndex,
+      float *samples
+    ) {
+      std::uint64_t frameCount = decoder.CountFrames();
+      std::uint64_t position = (threadIndex * FramesPerThread) % (frameCount - FramesPerThread);
+      for(std::size_t decoded = 0; decoded < FramesPerThread; decoded += ChunkFrameCount) {
+        decoder.DecodeInterleaved<float>(samples, position + decoded, ChunkFrameCount);
+      }
+    }
+
+    /// <summary>Collects the scaling efficiency in percent</summary>
+    private: std::shared_ptr<ScalingEfficiencyMeasurement> efficiency;
+    /// <summary>Decoders the threads will use, one per thread</summary>
+    private: std::vector<std::shared_ptr<const Nuclex::Audio::Storage::AudioTrackDecoder>> decoders;
+    /// <summary>Number of threads decoding concurrently in this experiment</summary>
+    private: std::size_t threadCount;
+    /// <summary>Time a single thread needed to decode its share</summary>
+    private: std::chrono::steady_clock::duration singleThreadTime;
+    /// <summary>Time spent decoding concurrently during the experiment</summary>
+    private: std::chrono::steady_clock::duration elapsedTime;
+    /// <summary>Number of concurrent decoding rounds during the experiment</summary>
+    private: std::size_t iterationCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a Waveform test signal concurrently, each from its own copy</summary>
+  using WaveformSeparateFilesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, DecoderSharing::SeparateFiles
+  >;
+  /// <summary>Decodes a Waveform test signal concurrently through clones of one decoder</summary>
+  using WaveformClonesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, DecoderSharing::Clones
+  >;
+  /// <summary>Decodes a Waveform test signal concurrently through one shared decoder</summary>
+  using WaveformSharedDecoderFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, DecoderSharing::SharedDecoder
+  >;
+  /// <summary>Decodes a Flac test signal concurrently, each from its own copy</summary>
+  using FlacSeparateFilesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, DecoderSharing::SeparateFiles
+  >;
+  /// <summary>Decodes a Flac test signal concurrently through clones of one decoder</summary>
+  using FlacClonesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, DecoderSharing::Clones
+  >;
+  /// <summary>Decodes a Flac test signal concurrently through one shared decoder</summary>
+  using FlacSharedDecoderFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, DecoderSharing::SharedDecoder
+  >;
+  /// <summary>Decodes a Vorbis test signal concurrently, each from its own copy</summary>
+  using VorbisSeparateFilesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, DecoderSharing::SeparateFiles
+  >;
+  /// <summary>Decodes a Vorbis test signal concurrently through clones of one decoder</summary>
+  using VorbisClonesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, DecoderSharing::Clones
+  >;
+  /// <summary>Decodes a Vorbis test signal concurrently through one shared decoder</summary>
+  using VorbisSharedDecoderFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, DecoderSharing::SharedDecoder
+  >;
+  /// <summary>Decodes a Opus test signal concurrently, each from its own copy</summary>
+  using OpusSeparateFilesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, DecoderSharing::SeparateFiles
+  >;
+  /// <summary>Decodes a Opus test signal concurrently through clones of one decoder</summary>
+  using OpusClonesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, DecoderSharing::Clones
+  >;
+  /// <summary>Decodes a Opus test signal concurrently through one shared decoder</summary>
+  using OpusSharedDecoderFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, DecoderSharing::SharedDecoder
+  >;
+  /// <summary>Decodes a WavPack test signal concurrently, each from its own copy</summary>
+  using WavPackSeparateFilesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, DecoderSharing::SeparateFiles
+  >;
+  /// <summary>Decodes a WavPack test signal concurrently through clones of one decoder</summary>
+  using WavPackClonesFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, DecoderSharing::Clones
+  >;
+  /// <summary>Decodes a WavPack test signal concurrently through one shared decoder</summary>
+  using WavPackSharedDecoderFixture = ConcurrentDecodeFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, DecoderSharing::SharedDecoder
+  >;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+/// <summary>Emits the benchmarks decoding one codec concurrently in all sharing modes</summary>
+/// <remarks>
+///   Separate files are the baseline since they share nothing but the process. Clones
+///   show what sharing the file and parsed metadata costs, the shared decoder shows how
+///   badly the threads contend for its decoding mutex.
+/// </remarks>
+#define NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(Group, Codec) \
+  BASELINE_F(Group, SeparateFiles, Codec##SeparateFilesFixture, 5, 4) { \
+    this->DecodeConcurrently(); \
+  } \
+  BENCHMARK_F(Group, Clones, Codec##ClonesFixture, 5, 4) { \
+    this->DecodeConcurrently(); \
+  } \
+  BENCHMARK_F(Group, SharedDecoder, Codec##SharedDecoderFixture, 5, 4) { \
+    this->DecodeConcurrently(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(WaveformConcurrentDecode, Waveform)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(FlacConcurrentDecode, Flac)
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(VorbisConcurrentDecode, Vorbis)
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(OpusConcurrentDecode, Opus)
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+NUCLEX_AUDIO_CONCURRENT_DECODE_BENCHMARKS(WavPackConcurrentDecode, WavPack)
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,227 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "../../Tests/AllocationCounter.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <cstdint> // for std::int64_t, std::uint64_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Chunk sizes, in frames, with which the decoders will be called</summary>
+  const std::int64_t ChunkFrameCounts[] = { 64, 1024, 16384, 65536 };
+
+  /// <summary>Number of channels in the decoded test signals</summary>
+  const std::size_t ChannelCount = 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records a per-call allocation figure of the decoder</summary>
+  class PerCallMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new per-call measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: PerCallMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a test signal while counting the heap allocations per call</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <remarks>
+  ///   The first chunk of each experiment is decoded in setUp() so buffers that are
+  ///   sized lazily don't show up. The remaining figures are what a real-time thread
+  ///   would pay, ideally both measurements read zero.
+  /// </remarks>
+  template<typename TCodec>
+  class AllocationFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new allocation counting fixture</summary>
+    public: AllocationFixture() :
+      allocations(std::make_shared<PerCallMeasurement>(u8"allocs/call")),
+      allocatedBytes(std::make_shared<PerCallMeasurement>(u8"bytes/call")),
+      chunkFrameCount(0),
+      position(0),
+      callCount(0),
+      allocationCount(0),
+      allocatedByteCount(0) {}
+
+    /// <summary>Lists the chunk sizes the decoder will be measured with</summary>
+    /// <returns>The number of frames decoded in each call</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t chunkFrameCount : ChunkFrameCounts) {
+        experimentValues.emplace_back(chunkFrameCount);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording allocations and bytes per call</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->allocations, this->allocatedBytes };
+    }
+
+    /// <summary>Opens a decoder on the test signal and decodes the first chunk</summary>
+    /// <param name="experimentValue">Number of frames to decode in each call</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      this->decoder = Nuclex::Audio::Storage::AudioLoader().OpenDecoder(
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), ChannelCount)
+      );
+
+      this->chunkFrameCount = static_cast<std::size_t>(experimentValue.Value);
+      this->samples.resize(this->chunkFrameCount * ChannelCount);
+
+      this->decoder->DecodeInterleaved<float>(this->samples.data(), 0, this->chunkFrameCount);
+      this->position = this->chunkFrameCount;
+
+      this->callCount = 0;
+      this->allocationCount = 0;
+      this->allocatedByteCount = 0;
+    }
+
+    /// <summary>Records the allocations per call of the finished experiment</summary>
+    public: void tearDown() override {
+      if(0 < this->callCount) {
+        double callCount = static_cast<double>(this->callCount);
+        this->allocations->addValue(static_cast<double>(this->allocationCount) / callCount);
+        this->allocatedBytes->addValue(static_cast<double>(this->allocatedByteCount) / callCount);
+      }
+
+      this->decoder.reset();
+    }
+
+    /// <summary>Decodes the next chunk and counts the allocations it made</summary>
+    protected: void DecodeNextChunk() {
+      if(this->position + this->chunkFrameCount > this->decoder->CountFrames()) {
+        this->position = 0;
+      }
+
+      Nuclex::Audio::AllocationCounter counter;
+      this->decoder->DecodeInterleaved<float>(
+        this->samples.data(), this->position, this->chunkFrameCount
+      );
+      this->allocationCount += counter.CountAllocations();
+      this->allocatedByteCount += counter.CountAllocatedBytes();
+
+      this->position += this->chunkFrameCount;
+      ++this->callCount;
+    }
+
+    /// <summary>Collects the allocations per decode call</summary>
+    private: std::shared_ptr<PerCallMeasurement> allocations;
+    /// <summary>Collects the allocated bytes per decode call</summary>
+    private: std::shared_ptr<PerCallMeasurement> allocatedBytes;
+    /// <summary>Decoder reading the encoded test signal</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder;
+    /// <summary>Buffer receiving the decoded samples</summary>
+    private: std::vector<float> samples;
+    /// <summary>Number of frames decoded in each call</summary>
+    private: std::size_t chunkFrameCount;
+    /// <summary>Index of the frame at which the next chunk begins</summary>
+    private: std::uint64_t position;
+    /// <summary>Number of decode calls made during the experiment</summary>
+    private: std::size_t callCount;
+    /// <summary>Number of allocations made by the decode calls</summary>
+    private: std::size_t allocationCount;
+    /// <summary>Number of bytes allocated by the decode calls</summary>
+    private: std::size_t allocatedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts allocations decoding a Waveform test signal</summary>
+  using WaveformAllocationFixture = AllocationFixture<Nuclex::Audio::Storage::WaveformTestCodec>;
+  /// <summary>Counts allocations decoding a Flac test signal</summary>
+  using FlacAllocationFixture = AllocationFixture<Nuclex::Audio::Storage::FlacTestCodec>;
+  /// <summary>Counts allocations decoding a Vorbis test signal</summary>
+  using VorbisAllocationFixture = AllocationFixture<Nuclex::Audio::Storage::VorbisTestCodec>;
+  /// <summary>Counts allocations decoding a Opus test signal</summary>
+  using OpusAllocationFixture = AllocationFixture<Nuclex::Audio::Storage::OpusTestCodec>;
+  /// <summary>Counts allocations decoding a WavPack test signal</summary>
+  using WavPackAllocationFixture = AllocationFixture<Nuclex::Audio::Storage::WavPackTestCodec>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+BASELINE_F(DecodeAllocations, Waveform, WaveformAllocationFixture, 5, 100) {
+  this->DecodeNextChunk();
+}
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+BENCHMARK_F(DecodeAllocations, Flac, FlacAllocationFixture, 5, 100) {
+  this->DecodeNextChunk();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+BENCHMARK_F(DecodeAllocations, Vorbis, VorbisAllocationFixture, 5, 100) {
+  this->DecodeNextChunk();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+BENCHMARK_F(DecodeAllocations, Opus, OpusAllocationFixture, 5, 100) {
+  this->DecodeNextChunk();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+BENCHMARK_F(DecodeAllocations, WavPack, WavPackAllocationFixture, 5, 100) {
+  this->DecodeNextChunk();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,362 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "../HardwareCounters.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <chrono> // for std::chrono::steady_clock
+#include <cstdint> // for std::int16_t, std::int32_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <type_traits> // for std::is_same<>
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Chunk sizes, in frames, with which the decoders will be called</summary>
+  const std::int64_t ChunkFrameCounts[] = { 64, 256, 1024, 4096, 16384, 65536 };
+
+  /// <summary>Number of frames decoded per sample, spread over as many calls as needed</summary>
+  const std::int64_t FramesPerSample = 262144;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the compressed bytes a decoder works through per second</summary>
+  class MegabytesPerSecondMeasurement :
+    public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return u8"MB/s"; }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a generated test signal in chunks of varying size</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in the test signal</typeparam>
+  /// <remarks>
+  ///   Celero's throughput figure is scaled to seconds of audio per second, so it reads
+  ///   directly as the realtime factor. The compressed bytes consumed per second are
+  ///   reported as an additional measurement.
+  /// </remarks>
+  template<typename TCodec, std::size_t ChannelCount>
+  class DecodeFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new decoding fixture</summary>
+    public: DecodeFixture() :
+      throughput(std::make_shared<MegabytesPerSecondMeasurement>()),
+      chunkFrameCount(0),
+      position(0),
+      decodedFrameCount(0),
+      elapsedTime(0) {}
+
+    /// <summary>Lists the chunk sizes the decoder will be measured with</summary>
+    /// <returns>The number of frames decoded in each call, plus iterations</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t chunkFrameCount : ChunkFrameCounts) {
+        experimentValues.emplace_back(chunkFrameCount, FramesPerSample / chunkFrameCount);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Scales the results so Celero reports the realtime factor</summary>
+    /// <returns>The seconds of audio decoded in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return (
+        static_cast<double>(this->chunkFrameCount) /
+        static_cast<double>(Nuclex::Audio::Storage::TestSignalSampleRate)
+      );
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurement recording compressed megabytes per second</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      std::vector<std::shared_ptr<celero::UserDefinedMeasurement>> measurements(
+        this->counters.Get()
+      );
+      measurements.insert(measurements.begin(), this->throughput);
+      return measurements;
+    }
+
+    /// <summary>Opens a decoder on the test signal for the next experiment</summary>
+    /// <param name="experimentValue">Number of frames to decode in each call</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      this->file = Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), ChannelCount);
+      this->decoder = Nuclex::Audio::Storage::AudioLoader().OpenDecoder(this->file);
+
+      this->chunkFrameCount = static_cast<std::size_t>(experimentValue.Value);
+      this->floatSamples.resize(this->chunkFrameCount * ChannelCount);
+      this->int16Samples.resize(this->chunkFrameCount * ChannelCount);
+      this->int32Samples.resize(this->chunkFrameCount * ChannelCount);
+
+      this->position = 0;
+      this->decodedFrameCount = 0;
+      this->elapsedTime = std::chrono::steady_clock::duration(0);
+
+      this->counters.Start();
+    }
+
+    /// <summary>Records the compressed bytes per second of the finished experiment</summary>
+    public: void tearDown() override {
+      this->counters.Stop(this->decodedFrameCount * ChannelCount);
+
+      double seconds = std::chrono::duration<double>(this->elapsedTime).count();
+      if(0.0 < seconds) {
+        double bytesPerFrame = (
+          static_cast<double>(this->file->GetSize()) /
+          static_cast<double>(this->decoder->CountFrames())
+        );
+        this->throughput->addValue(
+          static_cast<double>(this->decodedFrameCount) * bytesPerFrame / seconds / 1000000.0
+        );
+      }
+
+      this->decoder.reset();
+    }
+
+    /// <summary>Decodes the next chunk into an interleaved buffer</summary>
+    /// <typeparam name="TSample">Type of samples the decoder will produce</typeparam>
+    protected: template<typename TSample>
+    void DecodeInterleavedChunk() {
+      std::uint64_t startFrame = advance();
+
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      this->decoder->DecodeInterleaved<TSample>(
+        getSamples<TSample>(), startFrame, this->chunkFrameCount
+      );
+      this->elapsedTime += std::chrono::steady_clock::now() - startTime;
+    }
+
+    /// <summary>Decodes the next chunk into separate buffers for each channel</summary>
+    /// <typeparam name="TSample">Type of samples the decoder will produce</typeparam>
+    protected: template<typename TSample>
+    void DecodeSeparatedChunk() {
+      std::uint64_t startFrame = advance();
+
+      TSample *channels[ChannelCount];
+      for(std::size_t index = 0; index < ChannelCount; ++index) {
+        channels[index] = getSamples<TSample>() + (index * this->chunkFrameCount);
+      }
+
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      this->decoder->DecodeSeparated<TSample>(channels, startFrame, this->chunkFrameCount);
+      this->elapsedTime += std::chrono::steady_clock::now() - startTime;
+    }
+
+    /// <summary>Moves on to the next chunk, wrapping around at the end</summary>
+    /// <returns>The index of the first frame in the next chunk</returns>
+    private: std::uint64_t advance() {
+      if(this->position + this->chunkFrameCount > this->decoder->CountFrames()) {
+        this->position = 0;
+      }
+
+      std::uint64_t startFrame = this->position;
+      this->position += this->chunkFrameCount;
+      this->decodedFrameCount += this->chunkFrameCount;
+      return startFrame;
+    }
+
+    /// <summary>Looks up the buffer holding samples of the specified type</summary>
+    /// <typeparam name="TSample">Type of samples the buffer should hold</typeparam>
+    /// <returns>The buffer for samples of the specified type</returns>
+    private: template<typename TSample>
+    TSample *getSamples() {
+      if constexpr(std::is_same<TSample, std::int16_t>::value) {
+        return this->int16Samples.data();
+      } else if constexpr(std::is_same<TSample, std::int32_t>::value) {
+        return this->int32Samples.data();
+      } else {
+        return this->floatSamples.data();
+      }
+    }
+
+    /// <summary>Collects the compressed megabytes per second</summary>
+    private: std::shared_ptr<MegabytesPerSecondMeasurement> throughput;
+    /// <summary>Counts cache misses and such if hardware counters are enabled</summary>
+    private: Nuclex::Audio::HardwareCounterMeasurements counters;
+    /// <summary>Memory file holding the encoded test signal</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+    /// <summary>Decoder reading the encoded test signal</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder;
+    /// <summary>Buffer receiving samples decoded as floats</summary>
+    private: std::vector<float> floatSamples;
+    /// <summary>Buffer receiving samples decoded as 16-bit integers</summary>
+    private: std::vector<std::int16_t> int16Samples;
+    /// <summary>Buffer receiving samples decoded as 32-bit integers</summary>
+    private: std::vector<std::int32_t> int32Samples;
+    /// <summary>Number of frames decoded in each call</summary>
+    private: std::size_t chunkFrameCount;
+    /// <summary>Index of the frame at which the next chunk begins</summary>
+    private: std::uint64_t position;
+    /// <summary>Total number of frames decoded during the experiment</summary>
+    private: std::uint64_t decodedFrameCount;
+    /// <summary>Time spent inside the decoder during the experiment</summary>
+    private: std::chrono::steady_clock::duration elapsedTime;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a mono test signal encoded with the Waveform codec</summary>
+  using WaveformMonoFixture = DecodeFixture<Nuclex::Audio::Storage::WaveformTestCodec, 1>;
+  /// <summary>Decodes a stereo test signal encoded with the Waveform codec</summary>
+  using WaveformStereoFixture = DecodeFixture<Nuclex::Audio::Storage::WaveformTestCodec, 2>;
+  /// <summary>Decodes a 5.1 surround test signal encoded with the Waveform codec</summary>
+  using WaveformSurroundFixture = DecodeFixture<Nuclex::Audio::Storage::WaveformTestCodec, 6>;
+  /// <summary>Decodes a mono test signal encoded with the Flac codec</summary>
+  using FlacMonoFixture = DecodeFixture<Nuclex::Audio::Storage::FlacTestCodec, 1>;
+  /// <summary>Decodes a stereo test signal encoded with the Flac codec</summary>
+  using FlacStereoFixture = DecodeFixture<Nuclex::Audio::Storage::FlacTestCodec, 2>;
+  /// <summary>Decodes a 5.1 surround test signal encoded with the Flac codec</summary>
+  using FlacSurroundFixture = DecodeFixture<Nuclex::Audio::Storage::FlacTestCodec, 6>;
+  /// <summary>Decodes a mono test signal encoded with the Vorbis codec</summary>
+  using VorbisMonoFixture = DecodeFixture<Nuclex::Audio::Storage::VorbisTestCodec, 1>;
+  /// <summary>Decodes a stereo test signal encoded with the Vorbis codec</summary>
+  using VorbisStereoFixture = DecodeFixture<Nuclex::Audio::Storage::VorbisTestCodec, 2>;
+  /// <summary>Decodes a 5.1 surround test signal encoded with the Vorbis codec</summary>
+  using VorbisSurroundFixture = DecodeFixture<Nuclex::Audio::Storage::VorbisTestCodec, 6>;
+  /// <summary>Decodes a mono test signal encoded with the Opus codec</summary>
+  using OpusMonoFixture = DecodeFixture<Nuclex::Audio::Storage::OpusTestCodec, 1>;
+  /// <summary>Decodes a stereo test signal encoded with the Opus codec</summary>
+  using OpusStereoFixture = DecodeFixture<Nuclex::Audio::Storage::OpusTestCodec, 2>;
+  /// <summary>Decodes a 5.1 surround test signal encoded with the Opus codec</summary>
+  using OpusSurroundFixture = DecodeFixture<Nuclex::Audio::Storage::OpusTestCodec, 6>;
+  /// <summary>Decodes a mono test signal encoded with the WavPack codec</summary>
+  using WavPackMonoFixture = DecodeFixture<Nuclex::Audio::Storage::WavPackTestCodec, 1>;
+  /// <summary>Decodes a stereo test signal encoded with the WavPack codec</summary>
+  using WavPackStereoFixture = DecodeFixture<Nuclex::Audio::Storage::WavPackTestCodec, 2>;
+  /// <summary>Decodes a 5.1 surround test signal encoded with the WavPack codec</summary>
+  using WavPackSurroundFixture = DecodeFixture<Nuclex::Audio::Storage::WavPackTestCodec, 6>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+/// <summary>Emits the benchmarks decoding one test signal as all sample types</summary>
+/// <remarks>
+///   Decoding to interleaved floats is the baseline since it's what a mixer usually wants.
+///   Integer decodes show the cost of quantization, separated decodes that of interleaving.
+/// </remarks>
+#define NUCLEX_AUDIO_DECODE_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, InterleavedFloat, Fixture, 10, 1) { \
+    this->template DecodeInterleavedChunk<float>(); \
+  } \
+  BENCHMARK_F(Group, InterleavedInt16, Fixture, 10, 1) { \
+    this->template DecodeInterleavedChunk<std::int16_t>(); \
+  } \
+  BENCHMARK_F(Group, InterleavedInt32, Fixture, 10, 1) { \
+    this->template DecodeInterleavedChunk<std::int32_t>(); \
+  } \
+  BENCHMARK_F(Group, SeparatedFloat, Fixture, 10, 1) { \
+    this->template DecodeSeparatedChunk<float>(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WaveformMonoDecode, WaveformMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WaveformStereoDecode, WaveformStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WaveformSurroundDecode, WaveformSurroundFixture)
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(FlacMonoDecode, FlacMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(FlacStereoDecode, FlacStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(FlacSurroundDecode, FlacSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(VorbisMonoDecode, VorbisMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(VorbisStereoDecode, VorbisStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(VorbisSurroundDecode, VorbisSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(OpusMonoDecode, OpusMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(OpusStereoDecode, OpusStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(OpusSurroundDecode, OpusSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WavPackMonoDecode, WavPackMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WavPackStereoDecode, WavPackStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_DECODE_BENCHMARKS(WavPackSurroundDecode, WavPackSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,256 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "../HeapUsage.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <cstdint> // for std::int64_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Channel counts of the test signals the decoders will be opened on</summary>
+  const std::int64_t ChannelCounts[] = { 1, 2, 6 };
+
+  /// <summary>Number of frames decoded to bring a decoder to its working size</summary>
+  const std::size_t ChunkFrameCount = 4096;
+
+  /// <summary>Number of decoders that are kept open at the same time</summary>
+  /// <remarks>
+  ///   The C runtime keeps a few recently freed blocks of each size around for reuse,
+  ///   these still count as in use. Opening a few more decoders than it would keep
+  ///   means the figures, which are averages per decoder, can't drop to zero.
+  /// </remarks>
+  const std::size_t StreamCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records one memory figure of the decoder in KiB</summary>
+  class FootprintMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new footprint measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: FootprintMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Records the heap growth between two points in time</summary>
+    /// <param name="before">Bytes that were in use on the heap before</param>
+    /// <param name="after">Bytes that were in use on the heap after</param>
+    public: void AddGrowth(std::size_t before, std::size_t after) {
+      double growth = static_cast<double>(after) - static_cast<double>(before);
+      addValue(growth / static_cast<double>(StreamCount) / 1024.0);
+    }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the heap memory a decoder holds over its lifetime</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Each iteration opens 16 decoders on the in-memory test signal, decodes a chunk
+  ///     from each, clones them all and decodes a chunk from each clone, taking note of
+  ///     how much the heap grew per decoder at each step. The encoded file itself is
+  ///     shared and doesn't count, so the figures are what each additional stream costs:
+  ///     the codec library's context, plus the buffers the library's decoder keeps.
+  ///   </para>
+  ///   <para>
+  ///     "opened KiB" is the decoder right after it was opened, "decoding KiB" is the same
+  ///     decoder once it has decoded a chunk and grown its buffers and "clone KiB" is what
+  ///     a clone adds after it, too, has decoded a chunk. The number of simultaneous
+  ///     streams a platform can afford is its audio budget divided by "decoding KiB".
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec>
+  class FootprintFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new decoder footprint fixture</summary>
+    public: FootprintFixture() :
+      openedFootprint(std::make_shared<FootprintMeasurement>(u8"opened KiB")),
+      decodingFootprint(std::make_shared<FootprintMeasurement>(u8"decoding KiB")),
+      cloneFootprint(std::make_shared<FootprintMeasurement>(u8"clone KiB")) {}
+
+    /// <summary>Lists the channel counts the decoders will be measured with</summary>
+    /// <returns>The number of channels in the test signals</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t channelCount : ChannelCounts) {
+        experimentValues.emplace_back(channelCount);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording the decoder's memory at each step</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->openedFootprint, this->decodingFootprint, this->cloneFootprint };
+    }
+
+    /// <summary>Encodes the test signal and opens a decoder once to warm up</summary>
+    /// <param name="experimentValue">Number of channels in the test signal</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      std::size_t channelCount = static_cast<std::size_t>(experimentValue.Value);
+      this->file = Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), channelCount);
+      this->samples.resize(ChunkFrameCount * channelCount);
+
+      // Codec libraries may set up global tables the first time they're used,
+      // those are paid once per process and would otherwise land on the first stream.
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+        this->loader.OpenDecoder(this->file)
+      );
+      decoder->DecodeInterleaved<float>(this->samples.data(), 0, ChunkFrameCount);
+      decoder->Clone()->DecodeInterleaved<float>(this->samples.data(), 0, ChunkFrameCount);
+    }
+
+    /// <summary>Releases the test signal</summary>
+    public: void tearDown() override {
+      this->file.reset();
+    }
+
+    /// <summary>Opens, decodes and clones decoders, measuring the heap at each step</summary>
+    protected: void MeasureFootprint() {
+      this->decoders.reserve(StreamCount);
+      this->clones.reserve(StreamCount);
+
+      std::size_t initialBytes = Nuclex::Audio::CountHeapBytesInUse();
+      for(std::size_t index = 0; index < StreamCount; ++index) {
+        this->decoders.push_back(this->loader.OpenDecoder(this->file));
+      }
+      std::size_t openedBytes = Nuclex::Audio::CountHeapBytesInUse();
+
+      for(std::size_t index = 0; index < StreamCount; ++index) {
+        this->decoders[index]->DecodeInterleaved<float>(
+          this->samples.data(), 0, ChunkFrameCount
+        );
+      }
+      std::size_t decodingBytes = Nuclex::Audio::CountHeapBytesInUse();
+
+      for(std::size_t index = 0; index < StreamCount; ++index) {
+        this->clones.push_back(this->decoders[index]->Clone());
+        this->clones.back()->DecodeInterleaved<float>(
+          this->samples.data(), ChunkFrameCount, ChunkFrameCount
+        );
+      }
+      std::size_t clonedBytes = Nuclex::Audio::CountHeapBytesInUse();
+
+      this->openedFootprint->AddGrowth(initialBytes, openedBytes);
+      this->decodingFootprint->AddGrowth(initialBytes, decodingBytes);
+      this->cloneFootprint->AddGrowth(decodingBytes, clonedBytes);
+
+      this->clones.clear();
+      this->decoders.clear();
+    }
+
+    /// <summary>Collects the memory held by a freshly opened decoder</summary>
+    private: std::shared_ptr<FootprintMeasurement> openedFootprint;
+    /// <summary>Collects the memory held by a decoder that has decoded a chunk</summary>
+    private: std::shared_ptr<FootprintMeasurement> decodingFootprint;
+    /// <summary>Collects the memory added by a clone that has decoded a chunk</summary>
+    private: std::shared_ptr<FootprintMeasurement> cloneFootprint;
+    /// <summary>Audio loader through which the decoders are opened</summary>
+    private: Nuclex::Audio::Storage::AudioLoader loader;
+    /// <summary>Encoded test signal the decoders are opened on</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+    /// <summary>Decoders that are open during the measurement</summary>
+    private: std::vector<std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder>> decoders;
+    /// <summary>Clones of the decoders that are open during the measurement</summary>
+    private: std::vector<std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder>> clones;
+    /// <summary>Buffer receiving the decoded samples</summary>
+    private: std::vector<float> samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the memory held by Waveform decoders</summary>
+  using WaveformFootprintFixture = FootprintFixture<Nuclex::Audio::Storage::WaveformTestCodec>;
+  /// <summary>Measures the memory held by Flac decoders</summary>
+  using FlacFootprintFixture = FootprintFixture<Nuclex::Audio::Storage::FlacTestCodec>;
+  /// <summary>Measures the memory held by Vorbis decoders</summary>
+  using VorbisFootprintFixture = FootprintFixture<Nuclex::Audio::Storage::VorbisTestCodec>;
+  /// <summary>Measures the memory held by Opus decoders</summary>
+  using OpusFootprintFixture = FootprintFixture<Nuclex::Audio::Storage::OpusTestCodec>;
+  /// <summary>Measures the memory held by WavPack decoders</summary>
+  using WavPackFootprintFixture = FootprintFixture<Nuclex::Audio::Storage::WavPackTestCodec>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+BASELINE_F(DecoderFootprint, Waveform, WaveformFootprintFixture, 5, 20) {
+  this->MeasureFootprint();
+}
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+BENCHMARK_F(DecoderFootprint, Flac, FlacFootprintFixture, 5, 20) {
+  this->MeasureFootprint();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+BENCHMARK_F(DecoderFootprint, Vorbis, VorbisFootprintFixture, 5, 20) {
+  this->MeasureFootprint();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+BENCHMARK_F(DecoderFootprint, Opus, OpusFootprintFixture, 5, 20) {
+  this->MeasureFootprint();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+BENCHMARK_F(DecoderFootprint, WavPack, WavPackFootprintFixture, 5, 20) {
+  this->MeasureFootprint();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
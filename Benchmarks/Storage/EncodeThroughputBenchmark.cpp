@@ -0,0 +1,454 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioSaver.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <celero/Celero.h>
+
+#include <cstdint> // for std::int16_t, std::int32_t, std::int64_t, std::uint32_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <type_traits> // for std::is_same<>
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compression effort levels, in percent, the encoders will be measured at</summary>
+  const std::int64_t EffortPercentages[] = { 0, 25, 50, 75, 100 };
+
+  /// <summary>Target bitrates per channel, in kilobits, for the lossy encoders</summary>
+  const std::int64_t KilobitsPerChannel[] = { 24, 48, 64, 96, 128 };
+
+  /// <summary>Number of frames handed to the encoder in each call</summary>
+  const std::size_t ChunkFrameCount = 4096;
+
+  /// <summary>Number of frames in the generated signal that is fed to the encoders</summary>
+  const std::size_t SignalFrameCount = ChunkFrameCount * 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Which encoder setting the experiment values of a fixture control</summary>
+  enum class EncoderSetting {
+
+    /// <summary>Experiment values are the compression effort in percent</summary>
+    CompressionEffort,
+    /// <summary>Experiment values are the target bitrate per channel in kilobits</summary>
+    TargetBitrate
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the bitrate the encoder actually produced</summary>
+  class BitrateMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return u8"kbit/s"; }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Configures an encoder builder for the specified number of channels</summary>
+  /// <param name="builder">Builder whose channel layout will be configured</param>
+  /// <param name="channelCount">Number of channels, either 1, 2 or 6</param>
+  void setChannelLayout(
+    Nuclex::Audio::Storage::AudioTrackEncoderBuilder &builder, std::size_t channelCount
+  ) {
+    if(channelCount == 1) {
+      builder.SetChannels({ Nuclex::Audio::ChannelPlacement::FrontCenter });
+    } else if(channelCount == 2) {
+      builder.SetStereoChannels();
+    } else {
+      builder.SetFiveDotOneChannels();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a generated test signal in chunks</summary>
+  /// <typeparam name="TCodec">Codec that will encode the test signal</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in the test signal</typeparam>
+  /// <typeparam name="Setting">Encoder setting the experiment values control</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Each experiment builds a fresh encoder with the setting under test, then every
+  ///     iteration hands it one chunk of the test signal. Celero's throughput figure is
+  ///     scaled to seconds of audio per second, so it reads directly as the realtime factor.
+  ///   </para>
+  ///   <para>
+  ///     The encoder is flushed after the experiment and the bitrate it produced is
+  ///     reported so the speed of an effort level or target bitrate can be weighed
+  ///     against the size of the output.
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec, std::size_t ChannelCount, EncoderSetting Setting>
+  class EncodeFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new encoding fixture</summary>
+    public: EncodeFixture() :
+      bitrate(std::make_shared<BitrateMeasurement>()),
+      position(0),
+      encodedFrameCount(0) {}
+
+    /// <summary>Lists the effort levels or bitrates the encoder will be measured with</summary>
+    /// <returns>The values of the encoder setting under test</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      if constexpr(Setting == EncoderSetting::CompressionEffort) {
+        for(std::int64_t effortPercentage : EffortPercentages) {
+          experimentValues.emplace_back(effortPercentage);
+        }
+      } else {
+        for(std::int64_t kilobits : KilobitsPerChannel) {
+          experimentValues.emplace_back(kilobits);
+        }
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Scales the results so Celero reports the realtime factor</summary>
+    /// <returns>The seconds of audio encoded in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return (
+        static_cast<double>(ChunkFrameCount) /
+        static_cast<double>(Nuclex::Audio::Storage::TestSignalSampleRate)
+      );
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurement recording the produced bitrate</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->bitrate };
+    }
+
+    /// <summary>Builds an encoder with the setting under test</summary>
+    /// <param name="experimentValue">Effort in percent or bitrate per channel</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      using Nuclex::Audio::Storage::AudioTrackEncoderBuilder;
+
+      if(this->floatSamples.empty()) {
+        generateSignal();
+      }
+
+      std::shared_ptr<AudioTrackEncoderBuilder> builder = (
+        Nuclex::Audio::Storage::AudioSaver().ProvideBuilder(TCodec::GetName())
+      );
+      builder->SetSampleRate(Nuclex::Audio::Storage::TestSignalSampleRate);
+      setChannelLayout(*builder, ChannelCount);
+      if constexpr(Setting == EncoderSetting::CompressionEffort) {
+        builder->SetCompressionEffort(static_cast<float>(experimentValue.Value) / 100.0f);
+      } else {
+        builder->SetTargetBitrate(static_cast<float>(experimentValue.Value * ChannelCount));
+      }
+
+      this->file = std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>();
+      this->encoder = builder->Build(this->file);
+
+      this->position = 0;
+      this->encodedFrameCount = 0;
+    }
+
+    /// <summary>Flushes the encoder and records the bitrate it produced</summary>
+    public: void tearDown() override {
+      this->encoder->Flush();
+
+      if(0 < this->encodedFrameCount) {
+        double seconds = (
+          static_cast<double>(this->encodedFrameCount) /
+          static_cast<double>(Nuclex::Audio::Storage::TestSignalSampleRate)
+        );
+        this->bitrate->addValue(
+          static_cast<double>(this->encoder->CountWrittenBytes()) * 8.0 / seconds / 1000.0
+        );
+      }
+
+      this->encoder.reset();
+      this->file.reset();
+    }
+
+    /// <summary>Encodes the next chunk from an interleaved buffer</summary>
+    /// <typeparam name="TSample">Type of samples that will be fed to the encoder</typeparam>
+    protected: template<typename TSample>
+    void EncodeInterleavedChunk() {
+      const TSample *samples = getInterleavedSamples<TSample>();
+      this->encoder->EncodeInterleaved<TSample>(
+        samples + (advance() * ChannelCount), ChunkFrameCount
+      );
+    }
+
+    /// <summary>Encodes the next chunk from separate buffers for each channel</summary>
+    protected: void EncodeSeparatedChunk() {
+      std::size_t startFrame = advance();
+
+      const float *channels[ChannelCount];
+      for(std::size_t index = 0; index < ChannelCount; ++index) {
+        channels[index] = this->separatedSamples.data() + (index * SignalFrameCount) + startFrame;
+      }
+
+      this->encoder->EncodeSeparated<float>(channels, ChunkFrameCount);
+    }
+
+    /// <summary>Moves on to the next chunk, wrapping around at the end</summary>
+    /// <returns>The index of the first frame in the next chunk</returns>
+    private: std::size_t advance() {
+      if(this->position + ChunkFrameCount > SignalFrameCount) {
+        this->position = 0;
+      }
+
+      std::size_t startFrame = this->position;
+      this->position += ChunkFrameCount;
+      this->encodedFrameCount += ChunkFrameCount;
+      return startFrame;
+    }
+
+    /// <summary>Generates the test signal in all the layouts the encoder is fed</summary>
+    private: void generateSignal() {
+      std::size_t sampleCount = SignalFrameCount * ChannelCount;
+
+      this->floatSamples.resize(sampleCount);
+      std::uint32_t noiseState = 12345u;
+      Nuclex::Audio::Storage::GenerateTestSignal(
+        this->floatSamples.data(), 0, SignalFrameCount, ChannelCount, noiseState
+      );
+
+      this->int16Samples.resize(sampleCount);
+      this->int32Samples.resize(sampleCount);
+      this->separatedSamples.resize(sampleCount);
+      for(std::size_t index = 0; index < sampleCount; ++index) {
+        float sample = this->floatSamples[index];
+        this->int16Samples[index] = static_cast<std::int16_t>(sample * 32767.0f);
+        this->int32Samples[index] = static_cast<std::int32_t>(
+          static_cast<double>(sample) * 2147483647.0
+        );
+
+        std::size_t frame = index / ChannelCount;
+        std::size_t channel = index % ChannelCount;
+        this->separatedSamples[channel * SignalFrameCount + frame] = sample;
+      }
+    }
+
+    /// <summary>Looks up the interleaved buffer holding samples of the specified type</summary>
+    /// <typeparam name="TSample">Type of samples the buffer should hold</typeparam>
+    /// <returns>The buffer for samples of the specified type</returns>
+    private: template<typename TSample>
+    const TSample *getInterleavedSamples() const {
+      if constexpr(std::is_same<TSample, std::int16_t>::value) {
+        return this->int16Samples.data();
+      } else if constexpr(std::is_same<TSample, std::int32_t>::value) {
+        return this->int32Samples.data();
+      } else {
+        return this->floatSamples.data();
+      }
+    }
+
+    /// <summary>Collects the bitrate the encoder produced</summary>
+    private: std::shared_ptr<BitrateMeasurement> bitrate;
+    /// <summary>Memory file receiving the encoded audio data</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file;
+    /// <summary>Encoder configured with the setting under test</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> encoder;
+    /// <summary>Test signal as interleaved floats</summary>
+    private: std::vector<float> floatSamples;
+    /// <summary>Test signal as interleaved 16-bit integers</summary>
+    private: std::vector<std::int16_t> int16Samples;
+    /// <summary>Test signal as interleaved 32-bit integers</summary>
+    private: std::vector<std::int32_t> int32Samples;
+    /// <summary>Test signal as floats with the channels stored one after another</summary>
+    private: std::vector<float> separatedSamples;
+    /// <summary>Index of the frame at which the next chunk begins</summary>
+    private: std::size_t position;
+    /// <summary>Total number of frames encoded during the experiment</summary>
+    private: std::uint64_t encodedFrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shorthand for a fixture that varies the compression effort</summary>
+  template<typename TCodec, std::size_t ChannelCount>
+  using EffortFixture = EncodeFixture<TCodec, ChannelCount, EncoderSetting::CompressionEffort>;
+
+  /// <summary>Shorthand for a fixture that varies the target bitrate</summary>
+  template<typename TCodec, std::size_t ChannelCount>
+  using BitrateFixture = EncodeFixture<TCodec, ChannelCount, EncoderSetting::TargetBitrate>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a mono test signal with the Waveform codec</summary>
+  using WaveformMonoFixture = EffortFixture<Nuclex::Audio::Storage::WaveformTestCodec, 1>;
+  /// <summary>Encodes a stereo test signal with the Waveform codec</summary>
+  using WaveformStereoFixture = EffortFixture<Nuclex::Audio::Storage::WaveformTestCodec, 2>;
+  /// <summary>Encodes a 5.1 surround test signal with the Waveform codec</summary>
+  using WaveformSurroundFixture = EffortFixture<Nuclex::Audio::Storage::WaveformTestCodec, 6>;
+  /// <summary>Encodes a mono test signal with the Flac codec</summary>
+  using FlacMonoFixture = EffortFixture<Nuclex::Audio::Storage::FlacTestCodec, 1>;
+  /// <summary>Encodes a stereo test signal with the Flac codec</summary>
+  using FlacStereoFixture = EffortFixture<Nuclex::Audio::Storage::FlacTestCodec, 2>;
+  /// <summary>Encodes a 5.1 surround test signal with the Flac codec</summary>
+  using FlacSurroundFixture = EffortFixture<Nuclex::Audio::Storage::FlacTestCodec, 6>;
+  /// <summary>Encodes a mono test signal with the WavPack codec</summary>
+  using WavPackMonoFixture = EffortFixture<Nuclex::Audio::Storage::WavPackTestCodec, 1>;
+  /// <summary>Encodes a stereo test signal with the WavPack codec</summary>
+  using WavPackStereoFixture = EffortFixture<Nuclex::Audio::Storage::WavPackTestCodec, 2>;
+  /// <summary>Encodes a 5.1 surround test signal with the WavPack codec</summary>
+  using WavPackSurroundFixture = EffortFixture<Nuclex::Audio::Storage::WavPackTestCodec, 6>;
+  /// <summary>Encodes a mono test signal with the Vorbis codec</summary>
+  using VorbisMonoFixture = EffortFixture<Nuclex::Audio::Storage::VorbisTestCodec, 1>;
+  /// <summary>Encodes a stereo test signal with the Vorbis codec</summary>
+  using VorbisStereoFixture = EffortFixture<Nuclex::Audio::Storage::VorbisTestCodec, 2>;
+  /// <summary>Encodes a 5.1 surround test signal with the Vorbis codec</summary>
+  using VorbisSurroundFixture = EffortFixture<Nuclex::Audio::Storage::VorbisTestCodec, 6>;
+  /// <summary>Encodes a stereo test signal with the Vorbis codec at varying bitrates</summary>
+  using VorbisBitrateFixture = BitrateFixture<Nuclex::Audio::Storage::VorbisTestCodec, 2>;
+  /// <summary>Encodes a mono test signal with the Opus codec</summary>
+  using OpusMonoFixture = EffortFixture<Nuclex::Audio::Storage::OpusTestCodec, 1>;
+  /// <summary>Encodes a stereo test signal with the Opus codec</summary>
+  using OpusStereoFixture = EffortFixture<Nuclex::Audio::Storage::OpusTestCodec, 2>;
+  /// <summary>Encodes a 5.1 surround test signal with the Opus codec</summary>
+  using OpusSurroundFixture = EffortFixture<Nuclex::Audio::Storage::OpusTestCodec, 6>;
+  /// <summary>Encodes a stereo test signal with the Opus codec at varying bitrates</summary>
+  using OpusBitrateFixture = BitrateFixture<Nuclex::Audio::Storage::OpusTestCodec, 2>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+/// <summary>Emits the encoding benchmarks for one codec and channel count</summary>
+/// <param name="Group">Name of the benchmark group the results are listed under</param>
+/// <param name="Fixture">Encoding fixture for the codec and channel count</param>
+/// <remarks>
+///   Encoding from interleaved floats is the baseline since it's what a mixer produces.
+///   Integer input shows the cost of converting, separated input that of interleaving.
+/// </remarks>
+#define NUCLEX_AUDIO_ENCODE_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, InterleavedFloat, Fixture, 10, 50) { \
+    this->template EncodeInterleavedChunk<float>(); \
+  } \
+  BENCHMARK_F(Group, InterleavedInt16, Fixture, 10, 50) { \
+    this->template EncodeInterleavedChunk<std::int16_t>(); \
+  } \
+  BENCHMARK_F(Group, InterleavedInt32, Fixture, 10, 50) { \
+    this->template EncodeInterleavedChunk<std::int32_t>(); \
+  } \
+  BENCHMARK_F(Group, SeparatedFloat, Fixture, 10, 50) { \
+    this->EncodeSeparatedChunk(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WaveformMonoEncode, WaveformMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WaveformStereoEncode, WaveformStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WaveformSurroundEncode, WaveformSurroundFixture)
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(FlacMonoEncode, FlacMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(FlacStereoEncode, FlacStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(FlacSurroundEncode, FlacSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WavPackMonoEncode, WavPackMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WavPackStereoEncode, WavPackStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(WavPackSurroundEncode, WavPackSurroundFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(VorbisMonoEncode, VorbisMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(VorbisStereoEncode, VorbisStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(VorbisSurroundEncode, VorbisSurroundFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(VorbisBitrateEncode, VorbisBitrateFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(OpusMonoEncode, OpusMonoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(OpusStereoEncode, OpusStereoFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(OpusSurroundEncode, OpusSurroundFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_ENCODE_BENCHMARKS(OpusBitrateEncode, OpusBitrateFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
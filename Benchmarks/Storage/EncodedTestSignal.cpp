@@ -0,0 +1,169 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioSaver.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::sin()
+#include <cstdint> // for std::uint32_t, std::int32_t
+#include <map> // for std::map
+#include <mutex> // for std::mutex, std::lock_guard
+#include <stdexcept> // for std::invalid_argument
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames handed to the encoder in each call</summary>
+  const std::size_t EncodeChunkFrameCount = 4096;
+
+  /// <summary>Size of the blocks in which a test signal is copied into a real file</summary>
+  const std::size_t CopyChunkSize = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a freshly generated test signal with the specified codec</summary>
+  /// <param name="codecName">Name of the codec that will encode the test signal</param>
+  /// <param name="channelCount">Number of channels, either 1, 2 or 6</param>
+  /// <returns>A memory file holding the encoded test signal</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> encodeTestSignal(
+    const std::string &codecName, std::size_t channelCount
+  ) {
+    using Nuclex::Audio::Storage::AudioTrackEncoderBuilder;
+    using Nuclex::Audio::Storage::TestSignalFrameCount;
+
+    Nuclex::Audio::Storage::AudioSaver saver;
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = saver.ProvideBuilder(codecName);
+    builder->SetSampleRate(Nuclex::Audio::Storage::TestSignalSampleRate);
+    if(channelCount == 1) {
+      builder->SetChannels({ Nuclex::Audio::ChannelPlacement::FrontCenter });
+    } else if(channelCount == 2) {
+      builder->SetStereoChannels();
+    } else if(channelCount == 6) {
+      builder->SetFiveDotOneChannels();
+    } else {
+      throw std::invalid_argument(u8"Test signals can only have 1, 2 or 6 channels");
+    }
+
+    std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file = (
+      std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>()
+    );
+    {
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> encoder = builder->Build(file);
+
+      std::vector<float> samples(EncodeChunkFrameCount * channelCount);
+      std::uint32_t noiseState = 12345u;
+      for(std::size_t frame = 0; frame < TestSignalFrameCount; frame += EncodeChunkFrameCount) {
+        std::size_t chunkFrameCount = std::min(EncodeChunkFrameCount, TestSignalFrameCount - frame);
+        Nuclex::Audio::Storage::GenerateTestSignal(
+          samples.data(), frame, chunkFrameCount, channelCount, noiseState
+        );
+        encoder->EncodeInterleaved(samples.data(), chunkFrameCount);
+      }
+
+      encoder->Flush();
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void GenerateTestSignal(
+    float *samples, std::size_t startFrame, std::size_t frameCount, std::size_t channelCount,
+    std::uint32_t &noiseState
+  ) {
+    const float twoPi = 6.28318530717958647692f;
+    const float sampleRate = static_cast<float>(TestSignalSampleRate);
+
+    for(std::size_t frame = 0; frame < frameCount; ++frame) {
+      float time = static_cast<float>(startFrame + frame) / sampleRate;
+      for(std::size_t channel = 0; channel < channelCount; ++channel) {
+        float baseFrequency = 110.0f * static_cast<float>(channel + 1);
+        float sample = (
+          0.4f * std::sin(twoPi * baseFrequency * time) +
+          0.2f * std::sin(twoPi * baseFrequency * 3.01f * time) +
+          0.1f * std::sin(twoPi * 4321.0f * time)
+        );
+
+        // Linear congruential generator, enough to keep lossless codecs honest
+        noiseState = noiseState * 1664525u + 1013904223u;
+        sample += static_cast<float>(static_cast<std::int32_t>(noiseState)) / 4294967296.0f * 0.01f;
+
+        samples[frame * channelCount + channel] = sample;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> EncodeTestSignal(
+    const std::string &codecName, std::size_t channelCount
+  ) {
+    typedef std::pair<std::string, std::size_t> SignalKey;
+    static std::mutex cacheMutex;
+    static std::map<SignalKey, std::shared_ptr<const VirtualFile>> cache;
+
+    std::lock_guard<std::mutex> cacheLock(cacheMutex);
+
+    std::shared_ptr<const VirtualFile> &file = cache[SignalKey(codecName, channelCount)];
+    if(!file) {
+      file = encodeTestSignal(codecName, channelCount);
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteToRealFile(const std::shared_ptr<const VirtualFile> &signal, const std::string &path) {
+    std::shared_ptr<VirtualFile> file = VirtualFile::OpenRealFileForWriting(path, true);
+
+    std::vector<std::byte> buffer(CopyChunkSize);
+    std::uint64_t length = signal->GetSize();
+    for(std::uint64_t start = 0; start < length; start += CopyChunkSize) {
+      std::size_t byteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(CopyChunkSize, length - start)
+      );
+      signal->ReadAt(start, byteCount, buffer.data());
+      file->WriteAt(start, byteCount, buffer.data());
+    }
+
+    file->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,121 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ENCODEDTESTSIGNAL_H
+#define NUCLEX_AUDIO_STORAGE_ENCODEDTESTSIGNAL_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample rate at which all test signals are generated</summary>
+  const std::size_t TestSignalSampleRate = 48000;
+
+  /// <summary>Length of the generated test signals in frames</summary>
+  const std::size_t TestSignalFrameCount = TestSignalSampleRate * 10;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Selects the Microsoft Waveform codec for the benchmarks</summary>
+  struct WaveformTestCodec {
+    static const char *GetName() { return u8"Microsoft Waveform"; }
+    static const char *GetExtension() { return u8"wav"; }
+  };
+  /// <summary>Selects the FLAC codec for the benchmarks</summary>
+  struct FlacTestCodec {
+    static const char *GetName() { return u8"FLAC"; }
+    static const char *GetExtension() { return u8"flac"; }
+  };
+  /// <summary>Selects the Vorbis codec for the benchmarks</summary>
+  struct VorbisTestCodec {
+    static const char *GetName() { return u8"Vorbis"; }
+    static const char *GetExtension() { return u8"ogg"; }
+  };
+  /// <summary>Selects the Opus codec for the benchmarks</summary>
+  struct OpusTestCodec {
+    static const char *GetName() { return u8"Opus"; }
+    static const char *GetExtension() { return u8"opus"; }
+  };
+  /// <summary>Selects the WavPack codec for the benchmarks</summary>
+  struct WavPackTestCodec {
+    static const char *GetName() { return u8"WavPack"; }
+    static const char *GetExtension() { return u8"wv"; }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a chunk of the multi-channel test signal</summary>
+  /// <param name="samples">Buffer that will receive the interleaved samples</param>
+  /// <param name="startFrame">Index of the first frame that will be generated</param>
+  /// <param name="frameCount">Number of frames that will be generated</param>
+  /// <param name="channelCount">Number of channels in the test signal</param>
+  /// <param name="noiseState">State of the noise generator, updated as it runs</param>
+  /// <remarks>
+  ///   This is the signal <see cref="EncodeTestSignal" /> encodes when started with
+  ///   a noise state of 12345. Benchmarks of the encoders feed it in directly.
+  /// </remarks>
+  void GenerateTestSignal(
+    float *samples, std::size_t startFrame, std::size_t frameCount, std::size_t channelCount,
+    std::uint32_t &noiseState
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a test signal and encodes it into an in-memory audio file</summary>
+  /// <param name="codecName">Name of the codec that will encode the test signal</param>
+  /// <param name="channelCount">Number of channels, either 1, 2 or 6</param>
+  /// <returns>A virtual file holding the encoded test signal</returns>
+  /// <remarks>
+  ///   <para>
+  ///     The signal is a mix of a few sine waves with a low, deterministic noise floor,
+  ///     different in each channel, so lossless codecs can't collapse it into nearly
+  ///     nothing and every run of the benchmarks decodes exactly the same data.
+  ///   </para>
+  ///   <para>
+  ///     Encoding takes a while for the lossy codecs, so each combination of codec and
+  ///     channel count is encoded once and the same file is handed out on later calls.
+  ///   </para>
+  /// </remarks>
+  std::shared_ptr<const VirtualFile> EncodeTestSignal(
+    const std::string &codecName, std::size_t channelCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies an encoded test signal into a real file</summary>
+  /// <param name="signal">Virtual file holding the encoded test signal</param>
+  /// <param name="path">Path of the real file that will be written</param>
+  void WriteToRealFile(const std::shared_ptr<const VirtualFile> &signal, const std::string &path);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ENCODEDTESTSIGNAL_H
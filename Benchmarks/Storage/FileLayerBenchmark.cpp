@@ -0,0 +1,439 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::max(), std::min()
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::make_shared(), std::unique_ptr
+#include <stdexcept> // for std::logic_error
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded per call while the access pattern is recorded</summary>
+  const std::size_t RecordingChunkFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>I/O layer through which a recorded access pattern is replayed</summary>
+  enum class FileLayer {
+
+    /// <summary>Immutable buffer in memory, as used for preloaded sound banks</summary>
+    MemoryFile,
+    /// <summary>Real file accessed via read() and pread() (or ReadFile() on Windows)</summary>
+    RealFile,
+    /// <summary>Real file mapped into the process' address space</summary>
+    MappedFile,
+    /// <summary>Real file accessed through a read-ahead buffer</summary>
+    ReadAheadFile
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Single read a codec performed on its input file</summary>
+  struct RecordedRead {
+
+    /// <summary>Offset in the file at which the read began</summary>
+    public: std::uint64_t Start;
+    /// <summary>Number of bytes that were read</summary>
+    public: std::size_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the reads a codec performs so they can be replayed later</summary>
+  /// <remarks>
+  ///   Does not lend out memory via TryBorrowAt(), so codecs that would otherwise work
+  ///   on borrowed memory fall back to the reads they'd perform on a real file.
+  /// </remarks>
+  class RecordingVirtualFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new recording virtual file wrapper</summary>
+    /// <param name="file">File to which all reads will be forwarded</param>
+    /// <param name="reads">List into which the reads will be recorded</param>
+    public: RecordingVirtualFile(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file,
+      std::vector<RecordedRead> &reads
+    ) :
+      file(file),
+      reads(reads) {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~RecordingVirtualFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->file->GetSize(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      this->reads.push_back(RecordedRead { start, byteCount });
+      this->file->ReadAt(start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    public: void WriteAt(std::uint64_t, std::size_t, const std::byte *) override {
+      throw std::logic_error(u8"Recorded files are read-only");
+    }
+
+    /// <summary>File to which all reads are forwarded</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+    /// <summary>List into which the reads are recorded</summary>
+    private: std::vector<RecordedRead> &reads;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the reads a codec performs to probe and fully decode a file</summary>
+  /// <param name="codecName">Name of the codec whose access pattern will be recorded</param>
+  /// <returns>The reads the codec performed, in the order it performed them</returns>
+  std::vector<RecordedRead> recordAccessPattern(const std::string &codecName) {
+    std::vector<RecordedRead> reads;
+    std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+      std::make_shared<RecordingVirtualFile>(
+        Nuclex::Audio::Storage::EncodeTestSignal(codecName, 2), reads
+      )
+    );
+
+    Nuclex::Audio::Storage::AudioLoader loader;
+    loader.TryReadInfo(file);
+
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+      loader.OpenDecoder(file)
+    );
+    std::vector<float> samples(RecordingChunkFrameCount * decoder->CountChannels());
+
+    std::uint64_t frameCount = decoder->CountFrames();
+    for(std::uint64_t start = 0; start < frameCount; start += RecordingChunkFrameCount) {
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(RecordingChunkFrameCount, frameCount - start)
+      );
+      decoder->DecodeInterleaved<float>(samples.data(), start, chunkFrameCount);
+    }
+
+    return reads;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a file into a separate memory buffer</summary>
+  /// <param name="file">File that will be copied</param>
+  /// <returns>A new file holding the same contents in its own memory</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> copyIntoMemory(
+    const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file
+  ) {
+    std::size_t length = static_cast<std::size_t>(file->GetSize());
+    std::shared_ptr<std::byte[]> memory(new std::byte[length]);
+    file->ReadAt(0, length, memory.get());
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the share of reads that continue where the previous one ended</summary>
+  class SequentialReadsMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return u8"sequential %"; }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Replays the reads a codec performed through one of the I/O layers</summary>
+  /// <typeparam name="TCodec">Codec whose access pattern will be replayed</typeparam>
+  /// <typeparam name="Layer">I/O layer through which the reads will be replayed</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     The access pattern is recorded once by letting the codec probe the test signal
+  ///     and decode it from start to end. Each iteration then replays all of these reads,
+  ///     so only the cost of the I/O layer is measured, not that of the codec. Celero's
+  ///     throughput figure is scaled to the bytes read, so it reads as megabytes per second.
+  ///   </para>
+  ///   <para>
+  ///     The real file is read from the OS' file cache after the first iteration, so
+  ///     the figures compare the per-call overhead of the layers rather than disk speed.
+  ///     The share of sequential reads tells how often the real file takes its read()
+  ///     path instead of the pread() path.
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec, FileLayer Layer>
+  class ReplayFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new replay fixture</summary>
+    public: ReplayFixture() :
+      sequentialReads(std::make_shared<SequentialReadsMeasurement>()),
+      readByteCount(0) {}
+
+    /// <summary>Scales the results so Celero reports megabytes per second</summary>
+    /// <returns>The megabytes read in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return static_cast<double>(this->readByteCount) / 1000000.0;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurement recording the share of sequential reads</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->sequentialReads };
+    }
+
+    /// <summary>Records the access pattern and opens the file through the I/O layer</summary>
+    public: void setUp(const celero::TestFixture::ExperimentValue &) override {
+      using Nuclex::Audio::Storage::VirtualFile;
+
+      if(this->reads.empty()) {
+        this->reads = recordAccessPattern(TCodec::GetName());
+
+        std::size_t largestByteCount = 0;
+        this->readByteCount = 0;
+        for(const RecordedRead &read : this->reads) {
+          largestByteCount = std::max(largestByteCount, read.ByteCount);
+          this->readByteCount += read.ByteCount;
+        }
+        this->buffer.resize(largestByteCount);
+      }
+
+      std::shared_ptr<const VirtualFile> signal = (
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), 2)
+      );
+      if constexpr(Layer == FileLayer::MemoryFile) {
+        this->file = copyIntoMemory(signal);
+      } else {
+        if(!this->directory) {
+          this->directory = std::make_unique<Nuclex::Support::TemporaryDirectoryScope>(
+            u8"nuclex-audio-io"
+          );
+          this->path = this->directory->GetPath(u8"test-signal");
+          Nuclex::Audio::Storage::WriteToRealFile(signal, this->path);
+        }
+
+        if constexpr(Layer == FileLayer::MappedFile) {
+          this->file = VirtualFile::OpenRealFileForReading(this->path, false, true);
+        } else if constexpr(Layer == FileLayer::ReadAheadFile) {
+          this->file = VirtualFile::WrapInReadAheadBuffer(
+            VirtualFile::OpenRealFileForReading(this->path)
+          );
+        } else {
+          this->file = VirtualFile::OpenRealFileForReading(this->path);
+        }
+      }
+    }
+
+    /// <summary>Records the share of sequential reads of the finished experiment</summary>
+    public: void tearDown() override {
+      if(!this->reads.empty()) {
+        std::size_t sequentialReadCount = 0;
+        std::uint64_t position = 0;
+        for(const RecordedRead &read : this->reads) {
+          if(read.Start == position) {
+            ++sequentialReadCount;
+          }
+          position = read.Start + read.ByteCount;
+        }
+
+        this->sequentialReads->addValue(
+          static_cast<double>(sequentialReadCount) * 100.0 /
+          static_cast<double>(this->reads.size())
+        );
+      }
+
+      this->file.reset();
+    }
+
+    /// <summary>Performs all recorded reads on the file</summary>
+    protected: void ReplayAccessPattern() {
+      for(const RecordedRead &read : this->reads) {
+        this->file->ReadAt(read.Start, read.ByteCount, this->buffer.data());
+      }
+      celero::DoNotOptimizeAway(this->buffer[0]);
+    }
+
+    /// <summary>Collects the share of sequential reads</summary>
+    private: std::shared_ptr<SequentialReadsMeasurement> sequentialReads;
+    /// <summary>Reads the codec performed to probe and decode the test signal</summary>
+    private: std::vector<RecordedRead> reads;
+    /// <summary>Total number of bytes read in one replay of the access pattern</summary>
+    private: std::uint64_t readByteCount;
+    /// <summary>Buffer receiving the data of the replayed reads</summary>
+    private: std::vector<std::byte> buffer;
+    /// <summary>Temporary directory holding the real file</summary>
+    private: std::unique_ptr<Nuclex::Support::TemporaryDirectoryScope> directory;
+    /// <summary>Path of the real file holding the test signal</summary>
+    private: std::string path;
+    /// <summary>File accessed through the I/O layer under test</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Replays Waveform reads on a memory file</summary>
+  using WaveformMemoryFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, FileLayer::MemoryFile
+  >;
+  /// <summary>Replays Waveform reads on a real file</summary>
+  using WaveformRealFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, FileLayer::RealFile
+  >;
+  /// <summary>Replays Waveform reads on a memory-mapped file</summary>
+  using WaveformMappedFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, FileLayer::MappedFile
+  >;
+  /// <summary>Replays Waveform reads on a real file behind a read-ahead buffer</summary>
+  using WaveformReadAheadFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec, FileLayer::ReadAheadFile
+  >;
+  /// <summary>Replays Flac reads on a memory file</summary>
+  using FlacMemoryFixture = ReplayFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, FileLayer::MemoryFile
+  >;
+  /// <summary>Replays Flac reads on a real file</summary>
+  using FlacRealFixture = ReplayFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, FileLayer::RealFile
+  >;
+  /// <summary>Replays Flac reads on a memory-mapped file</summary>
+  using FlacMappedFixture = ReplayFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, FileLayer::MappedFile
+  >;
+  /// <summary>Replays Flac reads on a real file behind a read-ahead buffer</summary>
+  using FlacReadAheadFixture = ReplayFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, FileLayer::ReadAheadFile
+  >;
+  /// <summary>Replays Vorbis reads on a memory file</summary>
+  using VorbisMemoryFixture = ReplayFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, FileLayer::MemoryFile
+  >;
+  /// <summary>Replays Vorbis reads on a real file</summary>
+  using VorbisRealFixture = ReplayFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, FileLayer::RealFile
+  >;
+  /// <summary>Replays Vorbis reads on a memory-mapped file</summary>
+  using VorbisMappedFixture = ReplayFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, FileLayer::MappedFile
+  >;
+  /// <summary>Replays Vorbis reads on a real file behind a read-ahead buffer</summary>
+  using VorbisReadAheadFixture = ReplayFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, FileLayer::ReadAheadFile
+  >;
+  /// <summary>Replays Opus reads on a memory file</summary>
+  using OpusMemoryFixture = ReplayFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, FileLayer::MemoryFile
+  >;
+  /// <summary>Replays Opus reads on a real file</summary>
+  using OpusRealFixture = ReplayFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, FileLayer::RealFile
+  >;
+  /// <summary>Replays Opus reads on a memory-mapped file</summary>
+  using OpusMappedFixture = ReplayFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, FileLayer::MappedFile
+  >;
+  /// <summary>Replays Opus reads on a real file behind a read-ahead buffer</summary>
+  using OpusReadAheadFixture = ReplayFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, FileLayer::ReadAheadFile
+  >;
+  /// <summary>Replays WavPack reads on a memory file</summary>
+  using WavPackMemoryFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, FileLayer::MemoryFile
+  >;
+  /// <summary>Replays WavPack reads on a real file</summary>
+  using WavPackRealFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, FileLayer::RealFile
+  >;
+  /// <summary>Replays WavPack reads on a memory-mapped file</summary>
+  using WavPackMappedFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, FileLayer::MappedFile
+  >;
+  /// <summary>Replays WavPack reads on a real file behind a read-ahead buffer</summary>
+  using WavPackReadAheadFixture = ReplayFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, FileLayer::ReadAheadFile
+  >;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+/// <summary>Emits the I/O layer benchmarks for one codec's access pattern</summary>
+/// <param name="Group">Name of the benchmark group the results are listed under</param>
+/// <param name="Codec">Prefix of the codec's replay fixtures</param>
+/// <remarks>
+///   The memory file is the baseline since it has no I/O overhead beyond the copy.
+/// </remarks>
+#define NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(Group, Codec) \
+  BASELINE_F(Group, MemoryFile, Codec##MemoryFixture, 10, 10) { \
+    this->ReplayAccessPattern(); \
+  } \
+  BENCHMARK_F(Group, RealFile, Codec##RealFixture, 10, 10) { \
+    this->ReplayAccessPattern(); \
+  } \
+  BENCHMARK_F(Group, MappedFile, Codec##MappedFixture, 10, 10) { \
+    this->ReplayAccessPattern(); \
+  } \
+  BENCHMARK_F(Group, ReadAheadFile, Codec##ReadAheadFixture, 10, 10) { \
+    this->ReplayAccessPattern(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(WaveformFileLayers, Waveform)
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(FlacFileLayers, Flac)
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(VorbisFileLayers, Vorbis)
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(OpusFileLayers, Opus)
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+NUCLEX_AUDIO_FILE_LAYER_BENCHMARKS(WavPackFileLayers, WavPack)
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,419 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/StreamingManager.h"
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+#include "Nuclex/Audio/TrackInfo.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::sort(), std::max()
+#include <chrono> // for std::chrono::steady_clock
+#include <cstdint> // for std::uint32_t, std::uint64_t, std::int64_t
+#include <memory> // for std::shared_ptr, std::make_shared(), std::unique_ptr
+#include <string> // for std::string
+#include <thread> // for std::this_thread, std::thread::hardware_concurrency()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Numbers of voices the scenario will be run with</summary>
+  const std::int64_t VoiceCounts[] = { 32, 64, 128 };
+
+  /// <summary>Number of frames the mixer pulls from each voice per tick</summary>
+  const std::size_t TickFrameCount = 256;
+
+  /// <summary>Number of channels in every voice and in the mixing bus</summary>
+  const std::size_t ChannelCount = 2;
+
+  /// <summary>Time the mixer has to deliver one tick, 256 frames at 48 KHz</summary>
+  const std::chrono::microseconds TickDeadline(5333);
+
+  /// <summary>Number of frames each streamed voice decodes ahead</summary>
+  const std::size_t BufferedFrameCount = 16384;
+
+  /// <summary>Number of ticks after which the game opens a new voice</summary>
+  const std::size_t TicksBetweenOpens = 32;
+
+  /// <summary>Volume each voice is mixed at so the bus doesn't clip wildly</summary>
+  const float VoiceGain = 1.0f / 32.0f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records one figure of the tick statistics</summary>
+  class TickMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new tick measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: TickMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lists the codecs the voices of the scenario are encoded with</summary>
+  /// <returns>The names of all codecs the benchmarks were compiled with</returns>
+  std::vector<std::string> getVoiceCodecs() {
+    std::vector<std::string> codecs;
+    codecs.emplace_back(Nuclex::Audio::Storage::WaveformTestCodec::GetName());
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    codecs.emplace_back(Nuclex::Audio::Storage::FlacTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    codecs.emplace_back(Nuclex::Audio::Storage::VorbisTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    codecs.emplace_back(Nuclex::Audio::Storage::OpusTestCodec::GetName());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    codecs.emplace_back(Nuclex::Audio::Storage::WavPackTestCodec::GetName());
+#endif
+    return codecs;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Simulates the audio side of a game's frame loop</summary>
+  /// <typeparam name="Streamed">
+  ///   Whether voices are decoded ahead by the streaming manager's threads rather than
+  ///   by the mixer itself when it pulls their samples
+  /// </typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Each iteration is one tick of a mixer running at 48 KHz with 256-frame buffers:
+  ///     it pulls 256 frames from every voice, mixes them into a stereo bus and then
+  ///     sleeps until the next tick is due, 5.33 ms after the previous one. The voices use
+  ///     all codecs in turn, start at random positions and half of them loop a random
+  ///     section forever. Every 32 ticks, and whenever a one-shot voice ends, the game
+  ///     replaces a one-shot voice by opening a file, between ticks as a game thread would.
+  ///   </para>
+  ///   <para>
+  ///     Because of the pacing, Celero's own figure only shows whether the loop kept up.
+  ///     The numbers to track are the median, 99th percentile and worst time the mixer
+  ///     spent on a tick, how many ticks missed their deadline and, for streamed voices,
+  ///     how often a voice couldn't deliver its frames in time.
+  ///   </para>
+  /// </remarks>
+  template<bool Streamed>
+  class GameFrameFixture : public celero::TestFixture {
+
+    /// <summary>Single voice the mixer pulls samples from</summary>
+    private: struct Voice {
+
+      /// <summary>Reader the voice is streamed through, if it is streamed</summary>
+      public: std::shared_ptr<Nuclex::Audio::Storage::StreamingTrackReader> Reader;
+      /// <summary>Decoder the mixer decodes from, if the voice is not streamed</summary>
+      public: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> Decoder;
+      /// <summary>Frame the mixer will decode next if the voice is not streamed</summary>
+      public: std::uint64_t Position;
+      /// <summary>Whether the voice loops forever</summary>
+      public: bool IsLooping;
+
+    };
+
+    /// <summary>Initializes a new game frame fixture</summary>
+    public: GameFrameFixture() :
+      medianTickTime(std::make_shared<TickMeasurement>(u8"p50 tick (us)")),
+      tailTickTime(std::make_shared<TickMeasurement>(u8"p99 tick (us)")),
+      worstTickTime(std::make_shared<TickMeasurement>(u8"max tick (us)")),
+      deadlineMisses(std::make_shared<TickMeasurement>(u8"deadline misses")),
+      underruns(std::make_shared<TickMeasurement>(u8"underruns")),
+      codecs(getVoiceCodecs()),
+      samples(TickFrameCount * ChannelCount),
+      bus(TickFrameCount * ChannelCount),
+      tickIndex(0),
+      randomState(0),
+      underrunCount(0) {}
+
+    /// <summary>Lists the numbers of voices the scenario will be run with</summary>
+    /// <returns>The number of voices playing at the same time</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t voiceCount : VoiceCounts) {
+        experimentValues.emplace_back(voiceCount);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording tick times, misses and underruns</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return {
+        this->medianTickTime, this->tailTickTime, this->worstTickTime,
+        this->deadlineMisses, this->underruns
+      };
+    }
+
+    /// <summary>Writes the test files and starts all voices</summary>
+    /// <param name="experimentValue">Number of voices that will be playing</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      if(!this->directory) {
+        this->directory = std::make_unique<Nuclex::Support::TemporaryDirectoryScope>(
+          u8"nuclex-audio-game"
+        );
+        for(std::size_t index = 0; index < this->codecs.size(); ++index) {
+          this->paths.push_back(
+            this->directory->GetPath(u8"voice-" + std::to_string(index))
+          );
+          Nuclex::Audio::Storage::WriteToRealFile(
+            Nuclex::Audio::Storage::EncodeTestSignal(this->codecs[index], ChannelCount),
+            this->paths.back()
+          );
+        }
+      }
+
+      if constexpr(Streamed) {
+        std::size_t threadCount = std::max<std::size_t>(
+          std::thread::hardware_concurrency(), 2
+        ) - 1;
+        this->manager = std::make_unique<Nuclex::Audio::Storage::StreamingManager>(
+          this->loader, threadCount
+        );
+      }
+
+      this->randomState = 12345u;
+      this->voices.resize(static_cast<std::size_t>(experimentValue.Value));
+      for(std::size_t index = 0; index < this->voices.size(); ++index) {
+        startVoice(this->voices[index], index, (index % 2) == 0);
+      }
+
+      // Give the streaming threads a head start as a game would during a loading screen
+      if constexpr(Streamed) {
+        while(0 < this->manager->CountQueuedRefills()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+
+      this->tickTimes.clear();
+      this->tickIndex = 0;
+      this->underrunCount = 0;
+      this->nextTickTime = std::chrono::steady_clock::now();
+    }
+
+    /// <summary>Records the tick statistics of the finished experiment</summary>
+    public: void tearDown() override {
+      if(!this->tickTimes.empty()) {
+        std::sort(this->tickTimes.begin(), this->tickTimes.end());
+
+        std::size_t missCount = 0;
+        for(const std::chrono::steady_clock::duration &tickTime : this->tickTimes) {
+          if(tickTime > TickDeadline) {
+            ++missCount;
+          }
+        }
+
+        std::size_t count = this->tickTimes.size();
+        this->medianTickTime->addValue(toMicroseconds(this->tickTimes[count / 2]));
+        this->tailTickTime->addValue(toMicroseconds(this->tickTimes[(count - 1) * 99 / 100]));
+        this->worstTickTime->addValue(toMicroseconds(this->tickTimes[count - 1]));
+        this->deadlineMisses->addValue(static_cast<double>(missCount));
+        this->underruns->addValue(static_cast<double>(this->underrunCount));
+      }
+
+      this->voices.clear();
+      this->manager.reset();
+    }
+
+    /// <summary>Runs one tick of the mixer and waits until the next one is due</summary>
+    protected: void RunTick() {
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      mixVoices();
+      this->tickTimes.push_back(std::chrono::steady_clock::now() - startTime);
+
+      ++this->tickIndex;
+      if((this->tickIndex % TicksBetweenOpens) == 0) {
+        std::size_t index = (nextRandom() % (this->voices.size() / 2)) * 2 + 1;
+        startVoice(this->voices[index], index, false);
+      }
+
+      // Wait for the next tick. If the loop fell behind, don't try to catch up.
+      this->nextTickTime += TickDeadline;
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if(this->nextTickTime < now) {
+        this->nextTickTime = now;
+      } else {
+        std::this_thread::sleep_until(this->nextTickTime);
+      }
+    }
+
+    /// <summary>Pulls one tick's worth of samples from all voices and mixes them</summary>
+    private: void mixVoices() {
+      std::fill(this->bus.begin(), this->bus.end(), 0.0f);
+
+      for(std::size_t index = 0; index < this->voices.size(); ++index) {
+        Voice &voice = this->voices[index];
+
+        std::size_t frameCount;
+        if constexpr(Streamed) {
+          frameCount = voice.Reader->Read(this->samples.data(), TickFrameCount);
+          if(frameCount < TickFrameCount) {
+            if(voice.Reader->IsAtEnd()) {
+              startVoice(voice, index, false);
+            } else {
+              ++this->underrunCount;
+            }
+          }
+        } else {
+          frameCount = static_cast<std::size_t>(
+            std::min<std::uint64_t>(TickFrameCount, voice.Decoder->CountFrames() - voice.Position)
+          );
+          voice.Decoder->template DecodeInterleaved<float>(
+            this->samples.data(), voice.Position, frameCount
+          );
+          voice.Position += frameCount;
+          if(voice.Position >= voice.Decoder->CountFrames()) {
+            startVoice(voice, index, false);
+          }
+        }
+
+        for(std::size_t sample = 0; sample < frameCount * ChannelCount; ++sample) {
+          this->bus[sample] += this->samples[sample] * VoiceGain;
+        }
+      }
+
+      celero::DoNotOptimizeAway(this->bus[0]);
+    }
+
+    /// <summary>Opens a file and starts playing it at a random position</summary>
+    /// <param name="voice">Voice that will play the file</param>
+    /// <param name="index">Index of the voice, selects the codec</param>
+    /// <param name="looping">Whether the voice will loop a section of the file</param>
+    private: void startVoice(Voice &voice, std::size_t index, bool looping) {
+      const std::string &path = this->paths[index % this->paths.size()];
+      std::uint64_t frameCount = Nuclex::Audio::Storage::TestSignalFrameCount;
+
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+        this->loader.OpenDecoder(path)
+      );
+      std::uint64_t startFrame = nextRandom() % (frameCount / 2);
+      if(looping) {
+        Nuclex::Audio::LoopRegion loop;
+        loop.StartFrame = startFrame;
+        loop.EndFrame = startFrame + Nuclex::Audio::Storage::TestSignalSampleRate * 2;
+        loop.PlayCount = 0;
+        decoder = Nuclex::Audio::Storage::AudioTrackDecoder::CreateLooping(decoder, loop);
+      }
+
+      voice.IsLooping = looping;
+      if constexpr(Streamed) {
+        voice.Reader.reset(); // Stop the old stream before the new one starts
+        voice.Reader = this->manager->AddVoice(decoder, BufferedFrameCount, startFrame);
+      } else {
+        voice.Decoder = decoder;
+        voice.Position = startFrame;
+      }
+    }
+
+    /// <summary>Advances the random number generator used for positions</summary>
+    /// <returns>The next pseudo-random number</returns>
+    private: std::uint32_t nextRandom() {
+      this->randomState = this->randomState * 1664525u + 1013904223u;
+      return this->randomState >> 8;
+    }
+
+    /// <summary>Converts a duration into microseconds</summary>
+    /// <param name="duration">Duration that will be converted</param>
+    /// <returns>The number of microseconds in the duration</returns>
+    private: static double toMicroseconds(const std::chrono::steady_clock::duration &duration) {
+      return std::chrono::duration<double, std::micro>(duration).count();
+    }
+
+    /// <summary>Collects the median time the mixer spent on a tick</summary>
+    private: std::shared_ptr<TickMeasurement> medianTickTime;
+    /// <summary>Collects the 99th percentile of the time spent on a tick</summary>
+    private: std::shared_ptr<TickMeasurement> tailTickTime;
+    /// <summary>Collects the longest time spent on a tick</summary>
+    private: std::shared_ptr<TickMeasurement> worstTickTime;
+    /// <summary>Collects the number of ticks that took longer than their deadline</summary>
+    private: std::shared_ptr<TickMeasurement> deadlineMisses;
+    /// <summary>Collects the number of short reads from streamed voices</summary>
+    private: std::shared_ptr<TickMeasurement> underruns;
+    /// <summary>Names of the codecs the voices are encoded with</summary>
+    private: std::vector<std::string> codecs;
+    /// <summary>Temporary directory holding the voices' files</summary>
+    private: std::unique_ptr<Nuclex::Support::TemporaryDirectoryScope> directory;
+    /// <summary>Path of the file holding the test signal for each codec</summary>
+    private: std::vector<std::string> paths;
+    /// <summary>Audio loader through which the voices' files are opened</summary>
+    private: Nuclex::Audio::Storage::AudioLoader loader;
+    /// <summary>Streaming manager decoding ahead for the voices, if they're streamed</summary>
+    private: std::unique_ptr<Nuclex::Audio::Storage::StreamingManager> manager;
+    /// <summary>Voices that are currently playing</summary>
+    private: std::vector<Voice> voices;
+    /// <summary>Buffer receiving the samples pulled from a voice</summary>
+    private: std::vector<float> samples;
+    /// <summary>Stereo bus all voices are mixed into</summary>
+    private: std::vector<float> bus;
+    /// <summary>Time the mixer spent on each tick of the experiment</summary>
+    private: std::vector<std::chrono::steady_clock::duration> tickTimes;
+    /// <summary>Point in time at which the next tick is due</summary>
+    private: std::chrono::steady_clock::time_point nextTickTime;
+    /// <summary>Number of ticks run since the experiment began</summary>
+    private: std::size_t tickIndex;
+    /// <summary>State of the random number generator used for positions</summary>
+    private: std::uint32_t randomState;
+    /// <summary>Number of short reads from streamed voices</summary>
+    private: std::size_t underrunCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs the frame loop with voices streamed by the streaming manager</summary>
+  using StreamedGameFrameFixture = GameFrameFixture<true>;
+  /// <summary>Runs the frame loop with the mixer decoding every voice itself</summary>
+  using DirectGameFrameFixture = GameFrameFixture<false>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+BASELINE_F(GameAudioFrameLoop, StreamedVoices, StreamedGameFrameFixture, 3, 1000) {
+  this->RunTick();
+}
+
+// ------------------------------------------------------------------------------------------- //
+
+BENCHMARK_F(GameAudioFrameLoop, DecodedInMixer, DirectGameFrameFixture, 3, 1000) {
+  this->RunTick();
+}
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,378 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "../../Source/Storage/Waveform/WaveformAudioCodec.h"
+#include "../../Source/Storage/Waveform/WaveformDetection.h"
+#include "../../Source/Storage/Flac/FlacAudioCodec.h"
+#include "../../Source/Storage/Flac/FlacDetection.h"
+#include "../../Source/Storage/Vorbis/VorbisAudioCodec.h"
+#include "../../Source/Storage/Vorbis/VorbisDetection.h"
+#include "../../Source/Storage/Opus/OpusAudioCodec.h"
+#include "../../Source/Storage/Opus/OpusDetection.h"
+#include "../../Source/Storage/WavPack/WavPackAudioCodec.h"
+#include "../../Source/Storage/WavPack/WavPackDetection.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <cstdint> // for std::uint32_t, std::uint64_t
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <stdexcept> // for std::logic_error
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the non-audio file the probes are also run on</summary>
+  /// <remarks>
+  ///   Large enough that a codec scanning for a sync word would have to work for it
+  ///   rather than giving up at the end of the file after a few bytes.
+  /// </remarks>
+  const std::size_t NonAudioFileSize = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a file filled with deterministic noise that no codec can read</summary>
+  /// <returns>A virtual file holding bytes that do not form any audio format</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> createNonAudioFile() {
+    std::shared_ptr<std::byte[]> contents(new std::byte[NonAudioFileSize]);
+
+    std::uint32_t state = 0x12345678;
+    for(std::size_t index = 0; index < NonAudioFileSize; ++index) {
+      state = state * 1664525U + 1013904223U;
+      contents[index] = static_cast<std::byte>(state >> 24);
+    }
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(contents, NonAudioFileSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the reads a probe performs on a file</summary>
+  /// <remarks>
+  ///   Does not lend out memory via TryBorrowAt(), so every access a codec makes
+  ///   to the file shows up in the tally, even when the wrapped file is in memory.
+  /// </remarks>
+  class CountingVirtualFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new counting virtual file wrapper</summary>
+    /// <param name="file">File to which all reads will be forwarded</param>
+    public: CountingVirtualFile(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file
+    ) :
+      file(file),
+      readCount(0),
+      readByteCount(0) {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~CountingVirtualFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->file->GetSize(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      ++this->readCount;
+      this->readByteCount += byteCount;
+      this->file->ReadAt(start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    public: void WriteAt(std::uint64_t, std::size_t, const std::byte *) override {
+      throw std::logic_error(u8"Probed files are read-only");
+    }
+
+    /// <summary>Number of ReadAt() calls made since the last reset</summary>
+    /// <returns>The number of reads performed on the file</returns>
+    public: std::size_t CountReads() const { return this->readCount; }
+
+    /// <summary>Number of bytes read since the last reset</summary>
+    /// <returns>The number of bytes read from the file</returns>
+    public: std::uint64_t CountReadBytes() const { return this->readByteCount; }
+
+    /// <summary>Resets the read tallies to zero</summary>
+    public: void ResetCounters() {
+      this->readCount = 0;
+      this->readByteCount = 0;
+    }
+
+    /// <summary>File to which all reads are forwarded</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+    /// <summary>Number of ReadAt() calls made since the last reset</summary>
+    private: mutable std::size_t readCount;
+    /// <summary>Number of bytes read since the last reset</summary>
+    private: mutable std::uint64_t readByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records a per-probe read figure</summary>
+  class PerProbeMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new per-probe measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: PerProbeMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Probes test files for their format and metadata while counting reads</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <typeparam name="TAudioCodec">Codec implementation that is probed directly</typeparam>
+  /// <typeparam name="Detect">Header check the codec performs before reading</typeparam>
+  /// <remarks>
+  ///   Besides time, the figures that matter for probing are how often and how much
+  ///   the probe reads because on network shares and spinning disks, each read can
+  ///   cost far more than everything the probe computes.
+  /// </remarks>
+  template<
+    typename TCodec,
+    typename TAudioCodec,
+    bool (*Detect)(const Nuclex::Audio::Storage::VirtualFile &)
+  >
+  class ProbeFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new metadata probing fixture</summary>
+    public: ProbeFixture() :
+      reads(std::make_shared<PerProbeMeasurement>(u8"ReadAt/call")),
+      readBytes(std::make_shared<PerProbeMeasurement>(u8"bytes/call")),
+      loader(),
+      codec(),
+      probeCount(0) {}
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording reads and bytes read per probe</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->reads, this->readBytes };
+    }
+
+    /// <summary>Wraps the encoded test signal and the non-audio file for counting</summary>
+    public: void setUp(const celero::TestFixture::ExperimentValue &) override {
+      this->encodedFile = std::make_shared<CountingVirtualFile>(
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), 2)
+      );
+      this->nonAudioFile = std::make_shared<CountingVirtualFile>(createNonAudioFile());
+      this->probeCount = 0;
+    }
+
+    /// <summary>Records the reads per probe of the finished experiment</summary>
+    public: void tearDown() override {
+      if(0 < this->probeCount) {
+        double probeCount = static_cast<double>(this->probeCount);
+        this->reads->addValue(
+          static_cast<double>(
+            this->encodedFile->CountReads() + this->nonAudioFile->CountReads()
+          ) / probeCount
+        );
+        this->readBytes->addValue(
+          static_cast<double>(
+            this->encodedFile->CountReadBytes() + this->nonAudioFile->CountReadBytes()
+          ) / probeCount
+        );
+      }
+
+      this->encodedFile.reset();
+      this->nonAudioFile.reset();
+    }
+
+    /// <summary>Probes the encoded test signal through the audio loader</summary>
+    /// <param name="extensionHint">File extension that will be passed to the loader</param>
+    protected: void ProbeWithLoader(const std::string &extensionHint) {
+      celero::DoNotOptimizeAway(this->loader.TryReadInfo(this->encodedFile, extensionHint));
+      ++this->probeCount;
+    }
+
+    /// <summary>Probes the non-audio file through the audio loader</summary>
+    /// <param name="extensionHint">File extension that will be passed to the loader</param>
+    protected: void ProbeNonAudioWithLoader(const std::string &extensionHint) {
+      celero::DoNotOptimizeAway(this->loader.TryReadInfo(this->nonAudioFile, extensionHint));
+      ++this->probeCount;
+    }
+
+    /// <summary>Probes the encoded test signal directly through its codec</summary>
+    protected: void ProbeWithCodec() {
+      celero::DoNotOptimizeAway(
+        this->codec.TryReadInfo(this->encodedFile, TCodec::GetExtension())
+      );
+      ++this->probeCount;
+    }
+
+    /// <summary>Runs the codec's header check on the encoded test signal</summary>
+    protected: void DetectInEncodedFile() {
+      celero::DoNotOptimizeAway(Detect(*this->encodedFile));
+      ++this->probeCount;
+    }
+
+    /// <summary>Runs the codec's header check on the non-audio file</summary>
+    protected: void DetectInNonAudioFile() {
+      celero::DoNotOptimizeAway(Detect(*this->nonAudioFile));
+      ++this->probeCount;
+    }
+
+    /// <summary>Provides the extension hint matching the probed codec</summary>
+    /// <returns>The extension files of the probed codec usually have</returns>
+    protected: static std::string GetCorrectExtension() {
+      return std::string(TCodec::GetExtension());
+    }
+
+    /// <summary>Provides an extension hint belonging to a different codec</summary>
+    /// <returns>The extension of a codec that is not the one being probed</returns>
+    protected: static std::string GetWrongExtension() {
+      if(std::string(TCodec::GetExtension()) == u8"wav") {
+        return std::string(u8"flac", 4);
+      } else {
+        return std::string(u8"wav", 3);
+      }
+    }
+
+    /// <summary>Collects the reads per probe</summary>
+    private: std::shared_ptr<PerProbeMeasurement> reads;
+    /// <summary>Collects the bytes read per probe</summary>
+    private: std::shared_ptr<PerProbeMeasurement> readBytes;
+    /// <summary>Audio loader with all built-in codecs registered</summary>
+    private: Nuclex::Audio::Storage::AudioLoader loader;
+    /// <summary>Codec that is probed without going through the audio loader</summary>
+    private: TAudioCodec codec;
+    /// <summary>Encoded test signal with a read counter</summary>
+    private: std::shared_ptr<CountingVirtualFile> encodedFile;
+    /// <summary>File filled with noise with a read counter</summary>
+    private: std::shared_ptr<CountingVirtualFile> nonAudioFile;
+    /// <summary>Number of probes performed during the experiment</summary>
+    private: std::size_t probeCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Probes a Waveform test signal and a non-audio file</summary>
+  using WaveformProbeFixture = ProbeFixture<
+    Nuclex::Audio::Storage::WaveformTestCodec,
+    Nuclex::Audio::Storage::Waveform::WaveformAudioCodec,
+    &Nuclex::Audio::Storage::Waveform::Detection::CheckIfWaveformHeaderPresent
+  >;
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+  /// <summary>Probes a FLAC test signal and a non-audio file</summary>
+  using FlacProbeFixture = ProbeFixture<
+    Nuclex::Audio::Storage::FlacTestCodec,
+    Nuclex::Audio::Storage::Flac::FlacAudioCodec,
+    &Nuclex::Audio::Storage::Flac::Detection::CheckIfFlacHeaderPresent
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+  /// <summary>Probes a Vorbis test signal and a non-audio file</summary>
+  using VorbisProbeFixture = ProbeFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec,
+    Nuclex::Audio::Storage::Vorbis::VorbisAudioCodec,
+    &Nuclex::Audio::Storage::Vorbis::Detection::CheckIfVorbisHeaderPresentLite
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+  /// <summary>Probes an Opus test signal and a non-audio file</summary>
+  using OpusProbeFixture = ProbeFixture<
+    Nuclex::Audio::Storage::OpusTestCodec,
+    Nuclex::Audio::Storage::Opus::OpusAudioCodec,
+    &Nuclex::Audio::Storage::Opus::Detection::CheckIfOpusHeaderPresent
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+  /// <summary>Probes a WavPack test signal and a non-audio file</summary>
+  using WavPackProbeFixture = ProbeFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec,
+    Nuclex::Audio::Storage::WavPack::WavPackAudioCodec,
+    &Nuclex::Audio::Storage::WavPack::Detection::CheckIfWavPackHeaderPresent
+  >;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------- //
+
+/// <summary>Emits the metadata probing benchmarks for one codec</summary>
+/// <param name="Group">Name of the benchmark group the results are listed under</param>
+/// <param name="Fixture">Probing fixture for the codec</param>
+#define NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, LoaderWithCorrectHint, Fixture, 10, 1000) { \
+    this->ProbeWithLoader(Fixture::GetCorrectExtension()); \
+  } \
+  BENCHMARK_F(Group, LoaderWithWrongHint, Fixture, 10, 1000) { \
+    this->ProbeWithLoader(Fixture::GetWrongExtension()); \
+  } \
+  BENCHMARK_F(Group, LoaderWithoutHint, Fixture, 10, 1000) { \
+    this->ProbeWithLoader(std::string()); \
+  } \
+  BENCHMARK_F(Group, LoaderOnNonAudio, Fixture, 10, 1000) { \
+    this->ProbeNonAudioWithLoader(Fixture::GetCorrectExtension()); \
+  } \
+  BENCHMARK_F(Group, CodecDirectly, Fixture, 10, 1000) { \
+    this->ProbeWithCodec(); \
+  } \
+  BENCHMARK_F(Group, HeaderCheck, Fixture, 10, 1000) { \
+    this->DetectInEncodedFile(); \
+  } \
+  BENCHMARK_F(Group, HeaderCheckOnNonAudio, Fixture, 10, 1000) { \
+    this->DetectInNonAudioFile(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(WaveformProbe, WaveformProbeFixture)
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(FlacProbe, FlacProbeFixture)
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(VorbisProbe, VorbisProbeFixture)
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(OpusProbe, OpusProbeFixture)
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+NUCLEX_AUDIO_METADATA_PROBE_BENCHMARKS(WavPackProbe, WavPackProbeFixture)
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,814 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::min()
+#include <cstdint> // for std::int32_t, std::int64_t, std::uint64_t
+#include <cstring> // for std::memcpy()
+#include <cstdio> // for SEEK_SET, SEEK_CUR, SEEK_END
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+#include <FLAC/stream_decoder.h> // for the plain C FLAC decoder
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+#include <vorbis/vorbisfile.h> // for Vorbis (or rather, the vorbisfile wrapper library)
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+#include <opusfile.h> // for Opus (or rather, the opusfile wrapper library)
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+#include <wavpack.h> // for all wavpack functions
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Chunk sizes, in frames, in which the test signals will be decoded</summary>
+  const std::int64_t ChunkFrameCounts[] = { 256, 4096, 16384 };
+
+  /// <summary>Number of frames decoded per sample, spread over as many calls as needed</summary>
+  const std::int64_t FramesPerSample = 262144;
+
+  /// <summary>Number of channels in the decoded test signals</summary>
+  const std::size_t ChannelCount = 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encoded file in memory that the reference decoders read from</summary>
+  struct MemoryStream {
+
+    /// <summary>Contents of the encoded file</summary>
+    public: std::vector<std::byte> Contents;
+    /// <summary>Offset from which the next read will take place</summary>
+    public: std::size_t Position;
+
+    /// <summary>Copies bytes from the current position, advancing it</summary>
+    /// <param name="buffer">Buffer that will receive the bytes</param>
+    /// <param name="byteCount">Number of bytes that should be read</param>
+    /// <returns>The number of bytes actually read, less at the end of the file</returns>
+    public: std::size_t Read(void *buffer, std::size_t byteCount) {
+      byteCount = std::min(byteCount, this->Contents.size() - this->Position);
+      std::memcpy(buffer, this->Contents.data() + this->Position, byteCount);
+      this->Position += byteCount;
+      return byteCount;
+    }
+
+    /// <summary>Moves the current position like fseek() does</summary>
+    /// <param name="offset">Offset relative to what is indicated by whence</param>
+    /// <param name="whence">SEEK_SET, SEEK_CUR or SEEK_END</param>
+    /// <returns>True if the position was valid and was moved, false otherwise</returns>
+    public: bool Seek(std::int64_t offset, int whence) {
+      std::int64_t position = offset;
+      if(whence == SEEK_CUR) {
+        position += static_cast<std::int64_t>(this->Position);
+      } else if(whence == SEEK_END) {
+        position += static_cast<std::int64_t>(this->Contents.size());
+      }
+      if((position < 0) || (position > static_cast<std::int64_t>(this->Contents.size()))) {
+        return false;
+      }
+
+      this->Position = static_cast<std::size_t>(position);
+      return true;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts interleaved integer samples to floats the simplest possible way</summary>
+  /// <param name="source">Integer samples, right-aligned with the specified bit count</param>
+  /// <param name="target">Buffer that receives the floating point samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  /// <param name="bitsPerSample">Number of valid bits in each integer sample</param>
+  void convertToFloat(
+    const std::int32_t *source, float *target, std::size_t sampleCount, int bitsPerSample
+  ) {
+    float scale = 1.0f / static_cast<float>(std::int64_t(1) << (bitsPerSample - 1));
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      target[index] = static_cast<float>(source[index]) * scale;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+  /// <summary>Decodes a FLAC file by calling libFLAC directly</summary>
+  class FlacReference {
+
+    /// <summary>Opens a libFLAC stream decoder on the specified file contents</summary>
+    /// <param name="contents">Contents of the FLAC file that will be decoded</param>
+    public: FlacReference(const std::vector<std::byte> &contents) :
+      stream { contents, 0 },
+      decoder(::FLAC__stream_decoder_new()),
+      bufferedFrameCount(0),
+      bufferedFrameIndex(0),
+      bitsPerSample(16) {
+      ::FLAC__StreamDecoderInitStatus status = ::FLAC__stream_decoder_init_stream(
+        this->decoder,
+        &FlacReference::read, &FlacReference::seek, &FlacReference::tell,
+        &FlacReference::length, &FlacReference::eof, &FlacReference::write,
+        nullptr, &FlacReference::error, this
+      );
+      if(status != FLAC__STREAM_DECODER_INIT_STATUS_OK) {
+        ::FLAC__stream_decoder_delete(this->decoder);
+        throw std::runtime_error(u8"Could not initialize libFLAC stream decoder");
+      }
+    }
+
+    /// <summary>Finishes decoding and frees the stream decoder</summary>
+    public: ~FlacReference() {
+      ::FLAC__stream_decoder_finish(this->decoder);
+      ::FLAC__stream_decoder_delete(this->decoder);
+    }
+
+    /// <summary>Decodes frames in whatever format libFLAC delivers them</summary>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadNative(std::size_t frameCount) {
+      return read(nullptr, frameCount);
+    }
+
+    /// <summary>Decodes frames into an interleaved float buffer</summary>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadFloat(float *samples, std::size_t frameCount) {
+      return read(samples, frameCount);
+    }
+
+    /// <summary>Moves back to the beginning of the file</summary>
+    public: void Rewind() {
+      ::FLAC__stream_decoder_seek_absolute(this->decoder, 0);
+    }
+
+    /// <summary>Takes frames from decoded FLAC frames, decoding new ones as needed</summary>
+    /// <param name="samples">Buffer receiving interleaved floats or nullptr</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    private: std::size_t read(float *samples, std::size_t frameCount) {
+      std::size_t readFrameCount = 0;
+      while(readFrameCount < frameCount) {
+        if(this->bufferedFrameIndex >= this->bufferedFrameCount) {
+          this->bufferedFrameCount = this->bufferedFrameIndex = 0;
+          if(!::FLAC__stream_decoder_process_single(this->decoder)) {
+            break;
+          }
+          if(this->bufferedFrameCount == 0) { // Metadata or end of stream
+            if(
+              ::FLAC__stream_decoder_get_state(this->decoder) ==
+              FLAC__STREAM_DECODER_END_OF_STREAM
+            ) {
+              break;
+            }
+            continue;
+          }
+        }
+
+        std::size_t copyFrameCount = std::min(
+          frameCount - readFrameCount, this->bufferedFrameCount - this->bufferedFrameIndex
+        );
+        if(samples != nullptr) {
+          convertToFloat(
+            this->buffer.data() + (this->bufferedFrameIndex * ChannelCount),
+            samples + (readFrameCount * ChannelCount),
+            copyFrameCount * ChannelCount,
+            this->bitsPerSample
+          );
+        }
+
+        this->bufferedFrameIndex += copyFrameCount;
+        readFrameCount += copyFrameCount;
+      }
+
+      return readFrameCount;
+    }
+
+    /// <summary>Called by libFLAC to read from the file</summary>
+    private: static ::FLAC__StreamDecoderReadStatus read(
+      const ::FLAC__StreamDecoder *, ::FLAC__byte buffer[], std::size_t *bytes, void *self
+    ) {
+      *bytes = reinterpret_cast<FlacReference *>(self)->stream.Read(buffer, *bytes);
+      if(*bytes == 0) {
+        return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+      } else {
+        return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+      }
+    }
+
+    /// <summary>Called by libFLAC to move to another position in the file</summary>
+    private: static ::FLAC__StreamDecoderSeekStatus seek(
+      const ::FLAC__StreamDecoder *, ::FLAC__uint64 offset, void *self
+    ) {
+      if(reinterpret_cast<FlacReference *>(self)->stream.Seek(offset, SEEK_SET)) {
+        return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+      } else {
+        return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
+      }
+    }
+
+    /// <summary>Called by libFLAC to query the current position in the file</summary>
+    private: static ::FLAC__StreamDecoderTellStatus tell(
+      const ::FLAC__StreamDecoder *, ::FLAC__uint64 *offset, void *self
+    ) {
+      *offset = reinterpret_cast<FlacReference *>(self)->stream.Position;
+      return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+    }
+
+    /// <summary>Called by libFLAC to query the length of the file</summary>
+    private: static ::FLAC__StreamDecoderLengthStatus length(
+      const ::FLAC__StreamDecoder *, ::FLAC__uint64 *length, void *self
+    ) {
+      *length = reinterpret_cast<FlacReference *>(self)->stream.Contents.size();
+      return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+    }
+
+    /// <summary>Called by libFLAC to check whether the end of the file was reached</summary>
+    private: static ::FLAC__bool eof(const ::FLAC__StreamDecoder *, void *self) {
+      const MemoryStream &stream = reinterpret_cast<FlacReference *>(self)->stream;
+      return (stream.Position >= stream.Contents.size());
+    }
+
+    /// <summary>Called by libFLAC to deliver a decoded FLAC frame</summary>
+    private: static ::FLAC__StreamDecoderWriteStatus write(
+      const ::FLAC__StreamDecoder *, const ::FLAC__Frame *frame,
+      const ::FLAC__int32 *const channels[], void *self
+    ) {
+      FlacReference &reference = *reinterpret_cast<FlacReference *>(self);
+
+      // libFLAC delivers separate channels, this is the interleave any client has to do
+      std::size_t frameCount = frame->header.blocksize;
+      reference.buffer.resize(frameCount * ChannelCount);
+      for(std::size_t index = 0; index < frameCount; ++index) {
+        for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+          reference.buffer[index * ChannelCount + channel] = channels[channel][index];
+        }
+      }
+
+      reference.bufferedFrameCount = frameCount;
+      reference.bitsPerSample = static_cast<int>(frame->header.bits_per_sample);
+
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
+
+    /// <summary>Called by libFLAC to report an error in the stream</summary>
+    private: static void error(
+      const ::FLAC__StreamDecoder *, ::FLAC__StreamDecoderErrorStatus, void *
+    ) {}
+
+    /// <summary>Encoded file the decoder is reading from</summary>
+    private: MemoryStream stream;
+    /// <summary>libFLAC stream decoder decoding the file</summary>
+    private: ::FLAC__StreamDecoder *decoder;
+    /// <summary>Interleaved samples of the most recently decoded FLAC frame</summary>
+    private: std::vector<std::int32_t> buffer;
+    /// <summary>Number of frames in the most recently decoded FLAC frame</summary>
+    private: std::size_t bufferedFrameCount;
+    /// <summary>Index of the next frame that will be taken from the buffer</summary>
+    private: std::size_t bufferedFrameIndex;
+    /// <summary>Number of valid bits in the decoded samples</summary>
+    private: int bitsPerSample;
+
+  };
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+  /// <summary>Decodes a Vorbis file by calling libvorbisfile directly</summary>
+  class VorbisReference {
+
+    /// <summary>Opens a libvorbisfile decoder on the specified file contents</summary>
+    /// <param name="contents">Contents of the Vorbis file that will be decoded</param>
+    public: VorbisReference(const std::vector<std::byte> &contents) :
+      stream { contents, 0 } {
+      ::ov_callbacks callbacks;
+      callbacks.read_func = &VorbisReference::read;
+      callbacks.seek_func = &VorbisReference::seek;
+      callbacks.close_func = nullptr;
+      callbacks.tell_func = &VorbisReference::tell;
+      if(::ov_open_callbacks(&this->stream, &this->file, nullptr, 0, callbacks) != 0) {
+        throw std::runtime_error(u8"Could not open Vorbis file via libvorbisfile");
+      }
+    }
+
+    /// <summary>Closes the Vorbis file</summary>
+    public: ~VorbisReference() {
+      ::ov_clear(&this->file);
+    }
+
+    /// <summary>Decodes frames in whatever format libvorbisfile delivers them</summary>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadNative(std::size_t frameCount) {
+      return read(nullptr, frameCount);
+    }
+
+    /// <summary>Decodes frames into an interleaved float buffer</summary>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadFloat(float *samples, std::size_t frameCount) {
+      return read(samples, frameCount);
+    }
+
+    /// <summary>Moves back to the beginning of the file</summary>
+    public: void Rewind() {
+      ::ov_pcm_seek(&this->file, 0);
+    }
+
+    /// <summary>Decodes frames, interleaving them if a buffer is provided</summary>
+    /// <param name="samples">Buffer receiving interleaved floats or nullptr</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    private: std::size_t read(float *samples, std::size_t frameCount) {
+      std::size_t readFrameCount = 0;
+      while(readFrameCount < frameCount) {
+        float **channels = nullptr;
+        int bitstream = 0;
+        long decodedFrameCount = ::ov_read_float(
+          &this->file, &channels, static_cast<int>(frameCount - readFrameCount), &bitstream
+        );
+        if(decodedFrameCount <= 0) {
+          break;
+        }
+
+        // libvorbisfile delivers separate channels, this is the interleave any client has to do
+        if(samples != nullptr) {
+          float *target = samples + (readFrameCount * ChannelCount);
+          for(long index = 0; index < decodedFrameCount; ++index) {
+            for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+              *target++ = channels[channel][index];
+            }
+          }
+        }
+
+        readFrameCount += static_cast<std::size_t>(decodedFrameCount);
+      }
+
+      return readFrameCount;
+    }
+
+    /// <summary>Called by libvorbisfile to read from the file</summary>
+    private: static std::size_t read(
+      void *buffer, std::size_t size, std::size_t count, void *self
+    ) {
+      return reinterpret_cast<MemoryStream *>(self)->Read(buffer, size * count) / size;
+    }
+
+    /// <summary>Called by libvorbisfile to move to another position in the file</summary>
+    private: static int seek(void *self, ::ogg_int64_t offset, int whence) {
+      return reinterpret_cast<MemoryStream *>(self)->Seek(offset, whence) ? 0 : -1;
+    }
+
+    /// <summary>Called by libvorbisfile to query the current position in the file</summary>
+    private: static long tell(void *self) {
+      return static_cast<long>(reinterpret_cast<MemoryStream *>(self)->Position);
+    }
+
+    /// <summary>Encoded file the decoder is reading from</summary>
+    private: MemoryStream stream;
+    /// <summary>State of libvorbisfile for the opened file</summary>
+    private: ::OggVorbis_File file;
+
+  };
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+  /// <summary>Decodes an Opus file by calling libopusfile directly</summary>
+  class OpusReference {
+
+    /// <summary>Opens a libopusfile decoder on the specified file contents</summary>
+    /// <param name="contents">Contents of the Opus file that will be decoded</param>
+    public: OpusReference(const std::vector<std::byte> &contents) :
+      contents(contents),
+      file(nullptr) {
+      int error = 0;
+      this->file = ::op_open_memory(
+        reinterpret_cast<const unsigned char *>(this->contents.data()),
+        this->contents.size(),
+        &error
+      );
+      if(this->file == nullptr) {
+        throw std::runtime_error(u8"Could not open Opus file via libopusfile");
+      }
+    }
+
+    /// <summary>Closes the Opus file</summary>
+    public: ~OpusReference() {
+      ::op_free(this->file);
+    }
+
+    /// <summary>Decodes frames in whatever format libopusfile delivers them</summary>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    /// <remarks>
+    ///   libopusfile already delivers interleaved floats, so there is no work a client
+    ///   could skip and this is the same as <see cref="ReadFloat" /> into a scratch buffer.
+    /// </remarks>
+    public: std::size_t ReadNative(std::size_t frameCount) {
+      this->scratch.resize(frameCount * ChannelCount);
+      return ReadFloat(this->scratch.data(), frameCount);
+    }
+
+    /// <summary>Decodes frames into an interleaved float buffer</summary>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadFloat(float *samples, std::size_t frameCount) {
+      std::size_t readFrameCount = 0;
+      while(readFrameCount < frameCount) {
+        int decodedFrameCount = ::op_read_float(
+          this->file,
+          samples + (readFrameCount * ChannelCount),
+          static_cast<int>((frameCount - readFrameCount) * ChannelCount),
+          nullptr
+        );
+        if(decodedFrameCount <= 0) {
+          break;
+        }
+
+        readFrameCount += static_cast<std::size_t>(decodedFrameCount);
+      }
+
+      return readFrameCount;
+    }
+
+    /// <summary>Moves back to the beginning of the file</summary>
+    public: void Rewind() {
+      ::op_pcm_seek(this->file, 0);
+    }
+
+    /// <summary>Contents of the encoded file the decoder is reading from</summary>
+    private: std::vector<std::byte> contents;
+    /// <summary>State of libopusfile for the opened file</summary>
+    private: ::OggOpusFile *file;
+    /// <summary>Buffer receiving the samples when only decoding natively</summary>
+    private: std::vector<float> scratch;
+
+  };
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+  /// <summary>Decodes a WavPack file by calling libwavpack directly</summary>
+  class WavPackReference {
+
+    /// <summary>Opens a libwavpack context on the specified file contents</summary>
+    /// <param name="contents">Contents of the WavPack file that will be decoded</param>
+    public: WavPackReference(const std::vector<std::byte> &contents) :
+      stream { contents, 0 },
+      streamReader(),
+      context(nullptr),
+      bitsPerSample(16),
+      isFloat(false) {
+      this->streamReader.read_bytes = &WavPackReference::readBytes;
+      this->streamReader.get_pos = &WavPackReference::getPosition;
+      this->streamReader.set_pos_abs = &WavPackReference::setPositionAbsolute;
+      this->streamReader.set_pos_rel = &WavPackReference::setPositionRelative;
+      this->streamReader.push_back_byte = &WavPackReference::pushBackByte;
+      this->streamReader.get_length = &WavPackReference::getLength;
+      this->streamReader.can_seek = &WavPackReference::canSeek;
+
+      char errorMessage[81] = {};
+      this->context = ::WavpackOpenFileInputEx64(
+        &this->streamReader, &this->stream, nullptr, errorMessage, OPEN_NORMALIZE, 0
+      );
+      if(this->context == nullptr) {
+        throw std::runtime_error(
+          std::string(u8"Could not open WavPack file via libwavpack: ") + errorMessage
+        );
+      }
+
+      this->bitsPerSample = ::WavpackGetBitsPerSample(this->context);
+      this->isFloat = ((::WavpackGetMode(this->context) & MODE_FLOAT) != 0);
+    }
+
+    /// <summary>Closes the WavPack file</summary>
+    public: ~WavPackReference() {
+      ::WavpackCloseFile(this->context);
+    }
+
+    /// <summary>Decodes frames in whatever format libwavpack delivers them</summary>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadNative(std::size_t frameCount) {
+      this->buffer.resize(frameCount * ChannelCount);
+      return ::WavpackUnpackSamples(
+        this->context, this->buffer.data(), static_cast<std::uint32_t>(frameCount)
+      );
+    }
+
+    /// <summary>Decodes frames into an interleaved float buffer</summary>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    /// <returns>The number of frames decoded, less if the end was reached</returns>
+    public: std::size_t ReadFloat(float *samples, std::size_t frameCount) {
+      std::size_t decodedFrameCount = ReadNative(frameCount);
+      if(this->isFloat) { // libwavpack stores the float's bit pattern in the integers
+        std::memcpy(samples, this->buffer.data(), decodedFrameCount * ChannelCount * 4);
+      } else {
+        convertToFloat(
+          this->buffer.data(), samples, decodedFrameCount * ChannelCount, this->bitsPerSample
+        );
+      }
+
+      return decodedFrameCount;
+    }
+
+    /// <summary>Moves back to the beginning of the file</summary>
+    public: void Rewind() {
+      ::WavpackSeekSample64(this->context, 0);
+    }
+
+    /// <summary>Called by libwavpack to read from the file</summary>
+    private: static std::int32_t readBytes(void *self, void *buffer, std::int32_t byteCount) {
+      return static_cast<std::int32_t>(
+        reinterpret_cast<MemoryStream *>(self)->Read(buffer, static_cast<std::size_t>(byteCount))
+      );
+    }
+
+    /// <summary>Called by libwavpack to query the current position in the file</summary>
+    private: static std::int64_t getPosition(void *self) {
+      return static_cast<std::int64_t>(reinterpret_cast<MemoryStream *>(self)->Position);
+    }
+
+    /// <summary>Called by libwavpack to move to an absolute position in the file</summary>
+    private: static int setPositionAbsolute(void *self, std::int64_t position) {
+      return reinterpret_cast<MemoryStream *>(self)->Seek(position, SEEK_SET) ? 0 : -1;
+    }
+
+    /// <summary>Called by libwavpack to move to a relative position in the file</summary>
+    private: static int setPositionRelative(void *self, std::int64_t delta, int mode) {
+      return reinterpret_cast<MemoryStream *>(self)->Seek(delta, mode) ? 0 : -1;
+    }
+
+    /// <summary>Called by libwavpack to un-read the byte it just read</summary>
+    private: static int pushBackByte(void *self, int value) {
+      MemoryStream &stream = *reinterpret_cast<MemoryStream *>(self);
+      if(stream.Position == 0) {
+        return EOF;
+      }
+
+      --stream.Position;
+      return value;
+    }
+
+    /// <summary>Called by libwavpack to query the length of the file</summary>
+    private: static std::int64_t getLength(void *self) {
+      return static_cast<std::int64_t>(reinterpret_cast<MemoryStream *>(self)->Contents.size());
+    }
+
+    /// <summary>Called by libwavpack to check whether the file supports seeking</summary>
+    private: static int canSeek(void *) {
+      return 1;
+    }
+
+    /// <summary>Encoded file the decoder is reading from</summary>
+    private: MemoryStream stream;
+    /// <summary>Callbacks through which libwavpack accesses the file</summary>
+    private: ::WavpackStreamReader64 streamReader;
+    /// <summary>State of libwavpack for the opened file</summary>
+    private: ::WavpackContext *context;
+    /// <summary>Interleaved integer samples as delivered by libwavpack</summary>
+    private: std::vector<std::int32_t> buffer;
+    /// <summary>Number of valid bits in the decoded samples</summary>
+    private: int bitsPerSample;
+    /// <summary>Whether the samples are floating point values</summary>
+    private: bool isFloat;
+
+  };
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a test signal through the library and through the codec library</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <typeparam name="TReference">Decoder calling the codec library directly</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     The reference decoders are what a minimal integration of the codec library would
+  ///     look like: read callbacks on a memory buffer and, where needed, the simplest loop
+  ///     interleaving or converting the samples to floats. They only decode front to back.
+  ///   </para>
+  ///   <para>
+  ///     Decoding to interleaved floats through the reference decoder is the baseline,
+  ///     so Celero's baseline column reads as the overhead of the library, including its
+  ///     virtual file adapters and conversion passes, as a factor. Decoding through the
+  ///     reference decoder without any conversion shows how much of the time is the codec
+  ///     itself. Results are scaled to seconds of audio per second, like the other
+  ///     decode benchmarks.
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec, typename TReference>
+  class ReferenceFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new reference decoder fixture</summary>
+    public: ReferenceFixture() :
+      chunkFrameCount(0),
+      position(0) {}
+
+    /// <summary>Lists the chunk sizes the decoders will be measured with</summary>
+    /// <returns>The number of frames decoded in each call, plus iterations</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      for(std::int64_t chunkFrameCount : ChunkFrameCounts) {
+        experimentValues.emplace_back(chunkFrameCount, FramesPerSample / chunkFrameCount);
+      }
+      return experimentValues;
+    }
+
+    /// <summary>Scales the results so Celero reports the realtime factor</summary>
+    /// <returns>The seconds of audio decoded in each iteration</returns>
+    public: double getExperimentValueResultScale() const override {
+      return (
+        static_cast<double>(this->chunkFrameCount) /
+        static_cast<double>(Nuclex::Audio::Storage::TestSignalSampleRate)
+      );
+    }
+
+    /// <summary>Opens both decoders on the test signal for the next experiment</summary>
+    /// <param name="experimentValue">Number of frames to decode in each call</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), ChannelCount)
+      );
+
+      std::vector<std::byte> contents(static_cast<std::size_t>(file->GetSize()));
+      file->ReadAt(0, contents.size(), contents.data());
+
+      this->decoder = Nuclex::Audio::Storage::AudioLoader().OpenDecoder(file);
+      this->reference = std::make_unique<TReference>(contents);
+
+      this->chunkFrameCount = static_cast<std::size_t>(experimentValue.Value);
+      this->samples.resize(this->chunkFrameCount * ChannelCount);
+      this->position = 0;
+    }
+
+    /// <summary>Closes both decoders</summary>
+    public: void tearDown() override {
+      this->reference.reset();
+      this->decoder.reset();
+    }
+
+    /// <summary>Decodes the next chunk through the library's decoder</summary>
+    protected: void DecodeThroughLibrary() {
+      if(this->position + this->chunkFrameCount > this->decoder->CountFrames()) {
+        this->position = 0;
+      }
+
+      this->decoder->DecodeInterleaved<float>(
+        this->samples.data(), this->position, this->chunkFrameCount
+      );
+      this->position += this->chunkFrameCount;
+    }
+
+    /// <summary>Decodes the next chunk to interleaved floats through the reference</summary>
+    protected: void DecodeThroughReference() {
+      std::size_t frameCount = this->reference->ReadFloat(
+        this->samples.data(), this->chunkFrameCount
+      );
+      if(frameCount < this->chunkFrameCount) {
+        this->reference->Rewind();
+      }
+    }
+
+    /// <summary>Decodes the next chunk through the reference without converting it</summary>
+    protected: void DecodeNativeThroughReference() {
+      std::size_t frameCount = this->reference->ReadNative(this->chunkFrameCount);
+      if(frameCount < this->chunkFrameCount) {
+        this->reference->Rewind();
+      }
+    }
+
+    /// <summary>Decoder of the library reading the encoded test signal</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder;
+    /// <summary>Decoder calling the codec library directly</summary>
+    private: std::unique_ptr<TReference> reference;
+    /// <summary>Buffer receiving the decoded samples</summary>
+    private: std::vector<float> samples;
+    /// <summary>Number of frames decoded in each call</summary>
+    private: std::size_t chunkFrameCount;
+    /// <summary>Index of the frame at which the library's next chunk begins</summary>
+    private: std::uint64_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+  /// <summary>Compares the library's FLAC decoder against libFLAC</summary>
+  using FlacReferenceFixture = ReferenceFixture<
+    Nuclex::Audio::Storage::FlacTestCodec, FlacReference
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+  /// <summary>Compares the library's Vorbis decoder against libvorbisfile</summary>
+  using VorbisReferenceFixture = ReferenceFixture<
+    Nuclex::Audio::Storage::VorbisTestCodec, VorbisReference
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+  /// <summary>Compares the library's Opus decoder against libopusfile</summary>
+  using OpusReferenceFixture = ReferenceFixture<
+    Nuclex::Audio::Storage::OpusTestCodec, OpusReference
+  >;
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+  /// <summary>Compares the library's WavPack decoder against libwavpack</summary>
+  using WavPackReferenceFixture = ReferenceFixture<
+    Nuclex::Audio::Storage::WavPackTestCodec, WavPackReference
+  >;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+/// <summary>Emits the benchmarks comparing a codec's decoder against its reference</summary>
+#define NUCLEX_AUDIO_REFERENCE_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, ReferenceFloat, Fixture, 10, 1) { \
+    this->DecodeThroughReference(); \
+  } \
+  BENCHMARK_F(Group, ReferenceNative, Fixture, 10, 1) { \
+    this->DecodeNativeThroughReference(); \
+  } \
+  BENCHMARK_F(Group, Library, Fixture, 10, 1) { \
+    this->DecodeThroughLibrary(); \
+  }
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_REFERENCE_BENCHMARKS(FlacVersusReference, FlacReferenceFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_REFERENCE_BENCHMARKS(VorbisVersusReference, VorbisReferenceFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_REFERENCE_BENCHMARKS(OpusVersusReference, OpusReferenceFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_REFERENCE_BENCHMARKS(WavPackVersusReference, WavPackReferenceFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
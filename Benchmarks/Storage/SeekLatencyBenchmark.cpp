@@ -0,0 +1,300 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/FileAccessPattern.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::sort()
+#include <chrono> // for std::chrono::steady_clock
+#include <cstdint> // for std::uint64_t, std::uint32_t
+#include <memory> // for std::shared_ptr, std::make_shared(), std::unique_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded after each seek</summary>
+  const std::size_t DecodeFrameCount = 256;
+
+  /// <summary>Distance the short hop pattern skips ahead after each decode</summary>
+  const std::size_t HopFrameCount = 4800;
+
+  /// <summary>Frame at which the looping pattern's loop begins</summary>
+  const std::uint64_t LoopStartFrame = 96000;
+
+  /// <summary>Frame at which the looping pattern's loop ends (exclusive)</summary>
+  const std::uint64_t LoopEndFrame = 384000;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records one percentile of the seek latencies in microseconds</summary>
+  class LatencyPercentileMeasurement :
+    public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new latency percentile measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: LatencyPercentileMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Seeks around in a generated test signal and records the latencies</summary>
+  /// <typeparam name="TCodec">Codec with which the test signal will be encoded</typeparam>
+  /// <typeparam name="UseRealFile">
+  ///   Whether to decode from a real file on disk rather than from memory
+  /// </typeparam>
+  /// <remarks>
+  ///   Each iteration jumps to a new position following one of the access patterns and
+  ///   decodes a short chunk from there. Only that decode call is timed, Celero's figure
+  ///   also includes moving on to the next position. At the end of each sample, the median
+  ///   and 99th percentile of the timed calls are reported as additional measurements.
+  /// </remarks>
+  template<typename TCodec, bool UseRealFile>
+  class SeekFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new seek fixture</summary>
+    public: SeekFixture() :
+      medianLatency(std::make_shared<LatencyPercentileMeasurement>(u8"p50 (us)")),
+      tailLatency(std::make_shared<LatencyPercentileMeasurement>(u8"p99 (us)")),
+      samples(DecodeFrameCount * 2),
+      position(0),
+      randomState(0) {}
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording the median and tail latencies</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->medianLatency, this->tailLatency };
+    }
+
+    /// <summary>Opens a decoder on the test signal for the next experiment</summary>
+    public: void setUp(const celero::TestFixture::ExperimentValue &) override {
+      std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+        Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), 2)
+      );
+      if constexpr(UseRealFile) {
+        if(!this->directory) {
+          this->directory = std::make_unique<Nuclex::Support::TemporaryDirectoryScope>(
+            u8"nuclex-audio-seek"
+          );
+          this->path = this->directory->GetPath(u8"test-signal");
+          Nuclex::Audio::Storage::WriteToRealFile(file, this->path);
+        }
+        file = Nuclex::Audio::Storage::VirtualFile::OpenRealFileForReading(
+          this->path, Nuclex::Audio::Storage::FileAccessPattern::Random
+        );
+      }
+
+      this->decoder = Nuclex::Audio::Storage::AudioLoader().OpenDecoder(file);
+      this->position = LoopStartFrame;
+      this->randomState = 12345u;
+      this->latencies.clear();
+    }
+
+    /// <summary>Records the latency percentiles of the finished experiment</summary>
+    public: void tearDown() override {
+      if(!this->latencies.empty()) {
+        std::sort(this->latencies.begin(), this->latencies.end());
+        std::size_t lastIndex = this->latencies.size() - 1;
+        this->medianLatency->addValue(this->latencies[lastIndex / 2]);
+        this->tailLatency->addValue(this->latencies[lastIndex * 99 / 100]);
+      }
+
+      this->decoder.reset();
+    }
+
+    /// <summary>Seeks to a random position and decodes a chunk from there</summary>
+    protected: void SeekRandomly() {
+      this->randomState = this->randomState * 1664525u + 1013904223u;
+      std::uint64_t range = this->decoder->CountFrames() - DecodeFrameCount;
+      timeDecode(static_cast<std::uint64_t>(this->randomState) % range);
+    }
+
+    /// <summary>Plays up to the end of the loop and decodes from its start again</summary>
+    protected: void SeekToLoopStart() {
+      this->decoder->DecodeInterleaved<float>(
+        this->samples.data(), LoopEndFrame - DecodeFrameCount, DecodeFrameCount
+      );
+      timeDecode(LoopStartFrame);
+    }
+
+    /// <summary>Skips a short distance ahead and decodes a chunk from there</summary>
+    protected: void SeekShortHop() {
+      this->position += DecodeFrameCount + HopFrameCount;
+      if(this->position + DecodeFrameCount > this->decoder->CountFrames()) {
+        this->position = 0;
+      }
+      timeDecode(this->position);
+    }
+
+    /// <summary>Decodes a chunk at the specified position and records the latency</summary>
+    /// <param name="startFrame">Frame at which the decoder will begin decoding</param>
+    private: void timeDecode(std::uint64_t startFrame) {
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      this->decoder->DecodeInterleaved<float>(this->samples.data(), startFrame, DecodeFrameCount);
+      this->latencies.push_back(
+        std::chrono::duration<double, std::micro>(
+          std::chrono::steady_clock::now() - startTime
+        ).count()
+      );
+    }
+
+    /// <summary>Collects the median latencies in microseconds</summary>
+    private: std::shared_ptr<LatencyPercentileMeasurement> medianLatency;
+    /// <summary>Collects the 99th percentile latencies in microseconds</summary>
+    private: std::shared_ptr<LatencyPercentileMeasurement> tailLatency;
+    /// <summary>Temporary directory holding the real file, if one is used</summary>
+    private: std::unique_ptr<Nuclex::Support::TemporaryDirectoryScope> directory;
+    /// <summary>Path of the real file holding the test signal</summary>
+    private: std::string path;
+    /// <summary>Decoder reading the encoded test signal</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder;
+    /// <summary>Buffer receiving the decoded samples</summary>
+    private: std::vector<float> samples;
+    /// <summary>Latencies of the timed decode calls in microseconds</summary>
+    private: std::vector<double> latencies;
+    /// <summary>Frame the short hop pattern decoded from last</summary>
+    private: std::uint64_t position;
+    /// <summary>State of the generator picking random positions</summary>
+    private: std::uint32_t randomState;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Seeks in a Waveform test signal read from memory</summary>
+  using WaveformMemoryFixture = SeekFixture<Nuclex::Audio::Storage::WaveformTestCodec, false>;
+  /// <summary>Seeks in a Waveform test signal read from a real file</summary>
+  using WaveformRealFileFixture = SeekFixture<Nuclex::Audio::Storage::WaveformTestCodec, true>;
+  /// <summary>Seeks in a Flac test signal read from memory</summary>
+  using FlacMemoryFixture = SeekFixture<Nuclex::Audio::Storage::FlacTestCodec, false>;
+  /// <summary>Seeks in a Flac test signal read from a real file</summary>
+  using FlacRealFileFixture = SeekFixture<Nuclex::Audio::Storage::FlacTestCodec, true>;
+  /// <summary>Seeks in a Vorbis test signal read from memory</summary>
+  using VorbisMemoryFixture = SeekFixture<Nuclex::Audio::Storage::VorbisTestCodec, false>;
+  /// <summary>Seeks in a Vorbis test signal read from a real file</summary>
+  using VorbisRealFileFixture = SeekFixture<Nuclex::Audio::Storage::VorbisTestCodec, true>;
+  /// <summary>Seeks in a Opus test signal read from memory</summary>
+  using OpusMemoryFixture = SeekFixture<Nuclex::Audio::Storage::OpusTestCodec, false>;
+  /// <summary>Seeks in a Opus test signal read from a real file</summary>
+  using OpusRealFileFixture = SeekFixture<Nuclex::Audio::Storage::OpusTestCodec, true>;
+  /// <summary>Seeks in a WavPack test signal read from memory</summary>
+  using WavPackMemoryFixture = SeekFixture<Nuclex::Audio::Storage::WavPackTestCodec, false>;
+  /// <summary>Seeks in a WavPack test signal read from a real file</summary>
+  using WavPackRealFileFixture = SeekFixture<Nuclex::Audio::Storage::WavPackTestCodec, true>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+/// <summary>Emits the benchmarks running all seek patterns on one decoder</summary>
+/// <remarks>
+///   Random access is the baseline since it's the worst case for every codec. Looping
+///   benefits from checkpoints near the loop start, short hops from decoders that can
+///   skip ahead without seeking at all.
+/// </remarks>
+#define NUCLEX_AUDIO_SEEK_BENCHMARKS(Group, Fixture) \
+  BASELINE_F(Group, RandomAccess, Fixture, 10, 200) { \
+    this->SeekRandomly(); \
+  } \
+  BENCHMARK_F(Group, Looping, Fixture, 10, 200) { \
+    this->SeekToLoopStart(); \
+  } \
+  BENCHMARK_F(Group, ShortHop, Fixture, 10, 200) { \
+    this->SeekShortHop(); \
+  }
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(WaveformMemorySeek, WaveformMemoryFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(WaveformRealFileSeek, WaveformRealFileFixture)
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(FlacMemorySeek, FlacMemoryFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(FlacRealFileSeek, FlacRealFileFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(VorbisMemorySeek, VorbisMemoryFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(VorbisRealFileSeek, VorbisRealFileFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(OpusMemorySeek, OpusMemoryFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(OpusRealFileSeek, OpusRealFileFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(WavPackMemorySeek, WavPackMemoryFixture)
+
+// ------------------------------------------------------------------------------------------- //
+
+NUCLEX_AUDIO_SEEK_BENCHMARKS(WavPackRealFileSeek, WavPackRealFileFixture)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,251 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioSaver.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <celero/Celero.h>
+
+#include <chrono> // for std::chrono::steady_clock
+#include <memory> // for std::shared_ptr, std::make_shared(), std::unique_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of channels in the test signals that will be opened</summary>
+  const std::size_t ChannelCount = 2;
+
+  /// <summary>Number of frames decoded by the first decode call</summary>
+  const std::size_t ChunkFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records one latency figure of the first use of a codec</summary>
+  class LatencyMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new latency measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: LatencyMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Records the time elapsed between two points in time</summary>
+    /// <param name="start">Point in time at which the timed step began</param>
+    /// <param name="end">Point in time at which the timed step ended</param>
+    public: void AddElapsed(
+      std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end
+    ) {
+      addValue(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures how long a tool waits until it has decoded its first samples</summary>
+  /// <typeparam name="TCodec">Codec with which the test file will be encoded</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Each iteration does what a command-line tool does when it starts: construct an
+  ///     audio loader, open a file from disk and decode the first chunk. Celero's figure is
+  ///     the whole sequence, "open (us)" and "first decode (us)" split it into the loader
+  ///     detecting the format and opening the decoder and the first decode call.
+  ///   </para>
+  ///   <para>
+  ///     "first in process (us)" is the same sequence timed once, the first time the codec
+  ///     is used by the process, which includes initializing the codec library and faulting
+  ///     in its code. It only means what it says when the group is run by itself
+  ///     (<c>-g FirstFileOpen</c>), otherwise other benchmarks will have used the codec
+  ///     already. The file was written just before, so it comes from the OS cache, and the
+  ///     codec's encoder was used to write it, which may warm tables the decoder shares.
+  ///   </para>
+  /// </remarks>
+  template<typename TCodec>
+  class FirstOpenFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new first open fixture</summary>
+    public: FirstOpenFixture() :
+      openLatency(std::make_shared<LatencyMeasurement>(u8"open (us)")),
+      decodeLatency(std::make_shared<LatencyMeasurement>(u8"first decode (us)")),
+      firstInProcessLatency(std::make_shared<LatencyMeasurement>(u8"first in process (us)")),
+      samples(ChunkFrameCount * ChannelCount) {}
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording the latencies of the individual steps</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->openLatency, this->decodeLatency, this->firstInProcessLatency };
+    }
+
+    /// <summary>Writes the test file and times the first use of the codec</summary>
+    public: void setUp(const celero::TestFixture::ExperimentValue &) override {
+      if(!this->directory) {
+        this->directory = std::make_unique<Nuclex::Support::TemporaryDirectoryScope>(
+          u8"nuclex-audio-startup"
+        );
+        this->path = this->directory->GetPath(
+          std::string(u8"first-open.") + TCodec::GetExtension()
+        );
+        Nuclex::Audio::Storage::WriteToRealFile(
+          Nuclex::Audio::Storage::EncodeTestSignal(TCodec::GetName(), ChannelCount), this->path
+        );
+      }
+
+      static bool isFirstUse = true;
+      if(isFirstUse) {
+        isFirstUse = false;
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        openAndDecode();
+        this->firstInProcessLatency->AddElapsed(startTime, std::chrono::steady_clock::now());
+      }
+    }
+
+    /// <summary>Constructs a loader, opens the test file and decodes its first chunk</summary>
+    protected: void OpenAndDecode() {
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+        Nuclex::Audio::Storage::AudioLoader().OpenDecoder(this->path)
+      );
+      std::chrono::steady_clock::time_point openedTime = std::chrono::steady_clock::now();
+      decoder->DecodeInterleaved<float>(this->samples.data(), 0, ChunkFrameCount);
+      std::chrono::steady_clock::time_point decodedTime = std::chrono::steady_clock::now();
+
+      this->openLatency->AddElapsed(startTime, openedTime);
+      this->decodeLatency->AddElapsed(openedTime, decodedTime);
+    }
+
+    /// <summary>Constructs a loader, opens the test file and decodes its first chunk</summary>
+    private: void openAndDecode() {
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+        Nuclex::Audio::Storage::AudioLoader().OpenDecoder(this->path)
+      );
+      decoder->DecodeInterleaved<float>(this->samples.data(), 0, ChunkFrameCount);
+    }
+
+    /// <summary>Collects the time taken to construct the loader and open the file</summary>
+    private: std::shared_ptr<LatencyMeasurement> openLatency;
+    /// <summary>Collects the time taken by the first decode call</summary>
+    private: std::shared_ptr<LatencyMeasurement> decodeLatency;
+    /// <summary>Collects the time taken when the codec was used for the first time</summary>
+    private: std::shared_ptr<LatencyMeasurement> firstInProcessLatency;
+    /// <summary>Temporary directory holding the test file</summary>
+    private: std::unique_ptr<Nuclex::Support::TemporaryDirectoryScope> directory;
+    /// <summary>Path of the test file on disk</summary>
+    private: std::string path;
+    /// <summary>Buffer receiving the decoded samples</summary>
+    private: std::vector<float> samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the first open of a Waveform file</summary>
+  using WaveformFirstOpenFixture = FirstOpenFixture<Nuclex::Audio::Storage::WaveformTestCodec>;
+  /// <summary>Measures the first open of a Flac file</summary>
+  using FlacFirstOpenFixture = FirstOpenFixture<Nuclex::Audio::Storage::FlacTestCodec>;
+  /// <summary>Measures the first open of a Vorbis file</summary>
+  using VorbisFirstOpenFixture = FirstOpenFixture<Nuclex::Audio::Storage::VorbisTestCodec>;
+  /// <summary>Measures the first open of a Opus file</summary>
+  using OpusFirstOpenFixture = FirstOpenFixture<Nuclex::Audio::Storage::OpusTestCodec>;
+  /// <summary>Measures the first open of a WavPack file</summary>
+  using WavPackFirstOpenFixture = FirstOpenFixture<Nuclex::Audio::Storage::WavPackTestCodec>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// --------------------------------------------------------------------------------------------- //
+
+BASELINE(StartupCost, ConstructLoader, 30, 10000) {
+  Nuclex::Audio::Storage::AudioLoader loader;
+  celero::DoNotOptimizeAway(&loader);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+BENCHMARK(StartupCost, ConstructSaver, 30, 10000) {
+  Nuclex::Audio::Storage::AudioSaver saver;
+  celero::DoNotOptimizeAway(&saver);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+BENCHMARK(StartupCost, ConstructLoaderAndSaver, 30, 10000) {
+  Nuclex::Audio::Storage::AudioLoader loader;
+  Nuclex::Audio::Storage::AudioSaver saver;
+  celero::DoNotOptimizeAway(&loader);
+  celero::DoNotOptimizeAway(&saver);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+BASELINE_F(FirstFileOpen, Waveform, WaveformFirstOpenFixture, 10, 100) {
+  this->OpenAndDecode();
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+BENCHMARK_F(FirstFileOpen, Flac, FlacFirstOpenFixture, 10, 100) {
+  this->OpenAndDecode();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+// --------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+BENCHMARK_F(FirstFileOpen, Vorbis, VorbisFirstOpenFixture, 10, 100) {
+  this->OpenAndDecode();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+// --------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+BENCHMARK_F(FirstFileOpen, Opus, OpusFirstOpenFixture, 10, 100) {
+  this->OpenAndDecode();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+// --------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+BENCHMARK_F(FirstFileOpen, WavPack, WavPackFirstOpenFixture, 10, 100) {
+  this->OpenAndDecode();
+}
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+// --------------------------------------------------------------------------------------------- //
@@ -0,0 +1,184 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncodedTestSignal.h"
+#include "../DecodeCostFuzzer.h"
+#include "../../Tests/Storage/ResourceDirectoryLocator.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <celero/Celero.h>
+
+#include <algorithm> // for std::max()
+#include <chrono> // for std::chrono::seconds
+#include <cstdint> // for std::int64_t
+#include <fstream> // for std::ifstream
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Time after which decoding an input is cut off</summary>
+  const std::chrono::seconds InputTimeLimit(2);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records one figure of what decoding an input cost</summary>
+  class CostMeasurement : public celero::UserDefinedMeasurementTemplate<double> {
+
+    /// <summary>Initializes a new cost measurement</summary>
+    /// <param name="name">Name under which the measurement will be shown</param>
+    public: CostMeasurement(const std::string &name) : name(name) {}
+
+    /// <summary>Provides the name shown in the result table</summary>
+    /// <returns>The name of the measurement</returns>
+    public: std::string getName() const override { return this->name; }
+
+    /// <summary>Name under which the measurement will be shown</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a worst case input into memory</summary>
+  /// <param name="path">Path of the file holding the worst case input</param>
+  /// <returns>A virtual file reading from a copy of the input in memory</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> loadInput(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::size_t length = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+
+    std::shared_ptr<std::byte[]> memory(new std::byte[std::max<std::size_t>(length, 1)]);
+    file.read(reinterpret_cast<char *>(memory.get()), length);
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the worst inputs the decode cost fuzzer has found</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Experiment 0 is the unmodified Waveform test signal to have a reference point,
+  ///     experiments 1 and up are the worst case inputs recorded in the resources
+  ///     directory by running the benchmark executable with --fuzz, worst first. If the
+  ///     fuzzer hasn't been run, only the reference is decoded.
+  ///   </para>
+  ///   <para>
+  ///     Each iteration opens the input and decodes it the same way the fuzzer does,
+  ///     front to back followed by a few seeks. Celero's figure tracks whether the slow paths
+  ///     get faster, "ms per decoded s" and "peak heap KiB" are what the fuzzer's budget
+  ///     is checked against.
+  ///   </para>
+  /// </remarks>
+  class WorstCaseFixture : public celero::TestFixture {
+
+    /// <summary>Initializes a new worst case decode fixture</summary>
+    public: WorstCaseFixture() :
+      timePerSecond(std::make_shared<CostMeasurement>(u8"ms per decoded s")),
+      peakHeap(std::make_shared<CostMeasurement>(u8"peak heap KiB")) {}
+
+    /// <summary>Lists the inputs that will be decoded</summary>
+    /// <returns>Zero for the reference signal, then one number per worst case input</returns>
+    public: std::vector<celero::TestFixture::ExperimentValue> getExperimentValues(
+    ) const override {
+      std::string directory = Nuclex::Audio::GetResourcesDirectory();
+
+      std::vector<celero::TestFixture::ExperimentValue> experimentValues;
+      experimentValues.emplace_back(0);
+      for(std::size_t index = 0; index < Nuclex::Audio::WorstCaseInputCount; ++index) {
+        std::ifstream file(Nuclex::Audio::GetWorstCaseInputPath(directory, index));
+        if(file.good()) {
+          experimentValues.emplace_back(static_cast<std::int64_t>(index + 1));
+        }
+      }
+
+      return experimentValues;
+    }
+
+    /// <summary>Provides the additional measurements taken by the fixture</summary>
+    /// <returns>The measurements recording the decode time and memory</returns>
+    public: std::vector<
+      std::shared_ptr<celero::UserDefinedMeasurement>
+    > getUserDefinedMeasurements() const override {
+      return { this->timePerSecond, this->peakHeap };
+    }
+
+    /// <summary>Loads the input of the experiment into memory</summary>
+    /// <param name="experimentValue">Zero for the reference, else the worst case input</param>
+    public: void setUp(const celero::TestFixture::ExperimentValue &experimentValue) override {
+      if(experimentValue.Value == 0) {
+        this->input = Nuclex::Audio::Storage::EncodeTestSignal(
+          Nuclex::Audio::Storage::WaveformTestCodec::GetName(), 2
+        );
+      } else {
+        this->input = loadInput(
+          Nuclex::Audio::GetWorstCaseInputPath(
+            Nuclex::Audio::GetResourcesDirectory(),
+            static_cast<std::size_t>(experimentValue.Value - 1)
+          )
+        );
+      }
+    }
+
+    /// <summary>Releases the input of the experiment</summary>
+    public: void tearDown() override {
+      this->input.reset();
+    }
+
+    /// <summary>Opens and decodes the input, recording what it cost</summary>
+    protected: void DecodeInput() {
+      Nuclex::Audio::DecodeCost cost = Nuclex::Audio::MeasureDecodeCost(
+        this->input, InputTimeLimit
+      );
+
+      // Rejected inputs are charged for a tenth of a second, like the fuzzer does
+      double elapsedMilliseconds = static_cast<double>(cost.ElapsedTime.count()) / 1000.0;
+      this->timePerSecond->addValue(
+        elapsedMilliseconds / std::max(cost.DecodedSeconds, 0.1)
+      );
+      this->peakHeap->addValue(static_cast<double>(cost.PeakHeapBytes) / 1024.0);
+    }
+
+    /// <summary>Collects the time spent per second of decoded audio</summary>
+    private: std::shared_ptr<CostMeasurement> timePerSecond;
+    /// <summary>Collects the most memory the decoder held on the heap</summary>
+    private: std::shared_ptr<CostMeasurement> peakHeap;
+    /// <summary>Input that is decoded in the current experiment</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> input;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// --------------------------------------------------------------------------------------------- //
+
+BASELINE_F(WorstCaseDecode, FuzzedInputs, WorstCaseFixture, 3, 5) {
+  this->DecodeInput();
+}
+
+// --------------------------------------------------------------------------------------------- //
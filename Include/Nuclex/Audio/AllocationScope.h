@@ -0,0 +1,92 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_ALLOCATIONSCOPE_H
+#define NUCLEX_AUDIO_ALLOCATIONSCOPE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AllocationTag.h"
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tags all allocations a thread makes while the scope exists</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The library opens these scopes around everything that allocates: opening
+  ///     and decoding with a codec library, growing reader scratch buffers, collecting
+  ///     track metadata and building channel orders. A memory profiler that hooks the
+  ///     C runtime's allocation functions or installs its own <see cref="SampleAllocator" />
+  ///     can call <see cref="GetCurrent" /> on each allocation to attribute it.
+  ///   </para>
+  ///   <para>
+  ///     Scopes nest and the innermost one wins, so a reader growing its scratch buffer
+  ///     in the middle of a decoding call reports reader scratch rather than codec library
+  ///     memory. The tag lives in a thread-local variable, so opening a scope costs two
+  ///     stores and nothing is shared between threads.
+  ///   </para>
+  ///   <para>
+  ///     Memory is tagged where it is allocated. A string copied out of a track's
+  ///     information by the caller, for example, is the caller's allocation.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AllocationScope {
+
+    /// <summary>Looks up the tag allocations on the calling thread are made under</summary>
+    /// <returns>The tag of the innermost scope open on the calling thread</returns>
+    /// <remarks>
+    ///   Outside of any scope, this returns an unattributed allocation for no codec.
+    ///   The method neither allocates nor locks, so it is safe to call from a hooked
+    ///   malloc() or operator new.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static AllocationTag GetCurrent() noexcept;
+
+    /// <summary>Opens a scope tagging allocations with a subsystem and codec</summary>
+    /// <param name="subsystem">Part of the library allocations are made for</param>
+    /// <param name="codec">Codec on whose behalf allocations are made</param>
+    public: NUCLEX_AUDIO_API AllocationScope(
+      AllocationSubsystem subsystem, AllocationCodec codec
+    ) noexcept;
+
+    /// <summary>Opens a scope tagging allocations with a subsystem</summary>
+    /// <param name="subsystem">Part of the library allocations are made for</param>
+    /// <remarks>
+    ///   Keeps the codec of the enclosing scope, for shared code that codecs call into.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API explicit AllocationScope(AllocationSubsystem subsystem) noexcept;
+
+    /// <summary>Restores the tag that was active before the scope was opened</summary>
+    public: NUCLEX_AUDIO_API ~AllocationScope();
+
+    /// <summary>Scopes restore the tag they replaced and can't be copied</summary>
+    private: AllocationScope(const AllocationScope &other) = delete;
+    /// <summary>Scopes restore the tag they replaced and can't be copied</summary>
+    private: AllocationScope &operator =(const AllocationScope &other) = delete;
+
+    /// <summary>Tag that was active before the scope was opened</summary>
+    private: AllocationTag previousTag;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_ALLOCATIONSCOPE_H
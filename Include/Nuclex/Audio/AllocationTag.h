@@ -0,0 +1,88 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_ALLOCATIONTAG_H
+#define NUCLEX_AUDIO_ALLOCATIONTAG_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Part of the library an allocation was made for</summary>
+  enum class AllocationSubsystem {
+
+    /// <summary>Allocation made outside of any tagged part of the library</summary>
+    Unattributed,
+    /// <summary>Buffers a reader or decoder keeps to hold samples between steps</summary>
+    ReaderScratch,
+    /// <summary>Memory the codec library allocates for its own state and buffers</summary>
+    CodecLibrary,
+    /// <summary>Strings and other metadata collected into a track's information</summary>
+    TrackMetadata,
+    /// <summary>Lists describing the order of a track's channels</summary>
+    ChannelOrder,
+    /// <summary>Buffers an encoder keeps to convert samples before encoding them</summary>
+    EncoderScratch
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Codec on whose behalf an allocation was made</summary>
+  enum class AllocationCodec {
+
+    /// <summary>Allocation not made on behalf of any particular codec</summary>
+    None,
+    /// <summary>Free Lossless Audio Codec via libFLAC</summary>
+    Flac,
+    /// <summary>Opus via libopus and opusfile</summary>
+    Opus,
+    /// <summary>Vorbis via libvorbis and vorbisfile</summary>
+    Vorbis,
+    /// <summary>WavPack via libwavpack</summary>
+    WavPack,
+    /// <summary>Uncompressed waveform audio, handled by the library itself</summary>
+    Waveform
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Origin of an allocation for attributing memory in a profiler</summary>
+  /// <remarks>
+  ///   Obtained via <see cref="AllocationScope.GetCurrent" /> from within an allocator
+  ///   or a hooked malloc(). Codec libraries allocate from the C runtime directly, so
+  ///   attributing their memory requires hooking the C runtime's allocation functions.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE AllocationTag {
+
+    /// <summary>Part of the library the allocation was made for</summary>
+    public: AllocationSubsystem Subsystem;
+    /// <summary>Codec on whose behalf the allocation was made</summary>
+    public: AllocationCodec Codec;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_ALLOCATIONTAG_H
@@ -24,6 +24,10 @@ limitations under the License.
 #include "Nuclex/Audio/ChannelPlacement.h"
 #include "Nuclex/Audio/AudioSampleFormat.h"
 
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::int16_t, std::int32_t
+#include <type_traits> // for std::is_same, std::remove_const
+
 namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
@@ -39,7 +43,17 @@ namespace Nuclex { namespace Audio {
 
     /// <summary>Initializes a new audio channel</summary>
     public: NUCLEX_AUDIO_API ChannelBase() :
-      placement() {}
+      placement(),
+      sampleFormat(AudioSampleFormat::Unknown) {}
+
+    /// <summary>Initializes a new audio channel with the specified attributes</summary>
+    /// <param name="placement">Placement of the channel relative to the listener</param>
+    /// <param name="sampleFormat">Format in which the samples are stored</param>
+    protected: NUCLEX_AUDIO_API ChannelBase(
+      ChannelPlacement placement, AudioSampleFormat sampleFormat
+    ) :
+      placement(placement),
+      sampleFormat(sampleFormat) {}
 
     /// <summary>Frees all memory directly owned by the audio channel</summary>
     public: NUCLEX_AUDIO_API ~ChannelBase() = default;
@@ -60,15 +74,6 @@ namespace Nuclex { namespace Audio {
       return this->sampleFormat;
     }
 
-    /*
-    public: template<typename TOtherSample>
-    std::shared_ptr<const Channel<TOtherSample>> As() const;
-
-    public: template<typename TOtherSample>
-    std::shared_ptr<Channel<TOtherSample>> Convert() const;
-
-    */
-
     /// <summary>Where the audio channel should be played relative to the listener</summary>
     private: ChannelPlacement placement;
     /// <summary>The format in which audio samples are natively stored</summary>
@@ -78,6 +83,86 @@ namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TSample> class ChannelBuffer;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides access to the samples of one audio channel in memory</summary>
+  /// <typeparam name="TSample">Type of the samples, may be const for read-only access</typeparam>
+  /// <remarks>
+  ///   A channel does not own its samples, it merely points into the memory of the audio
+  ///   track it was obtained from and becomes invalid if the track is destroyed. Samples
+  ///   follow each other at a fixed stride, so the same type can look into tracks with
+  ///   separated channels (stride 1) and tracks with interleaved channels. Use
+  ///   a <see cref="ChannelBuffer" /> if the channel should own its samples.
+  /// </remarks>
+  template<typename TSample>
+  class Channel : public ChannelBase {
+
+    template<typename TOtherSample> friend class ChannelBuffer;
+
+    /// <summary>Initializes a new audio channel looking at the specified samples</summary>
+    /// <param name="samples">Address of the channel's first sample</param>
+    /// <param name="frameCount">Number of samples in the channel</param>
+    /// <param name="stride">Distance between two consecutive samples of the channel</param>
+    /// <param name="placement">Placement of the channel relative to the listener</param>
+    public: Channel(
+      TSample *samples, std::size_t frameCount, std::size_t stride, ChannelPlacement placement
+    ) :
+      ChannelBase(placement, getSampleFormat()),
+      samples(samples),
+      frameCount(frameCount),
+      stride(stride) {}
+
+    /// <summary>Counts the number of samples in the channel</summary>
+    /// <returns>The number of samples stored in the channel</returns>
+    public: std::size_t CountFrames() const { return this->frameCount; }
+
+    /// <summary>Retrieves the distance between two consecutive samples</summary>
+    /// <returns>The number of samples from one sample of the channel to the next</returns>
+    public: std::size_t GetStride() const { return this->stride; }
+
+    /// <summary>Returns the address of the channel's first sample</summary>
+    /// <returns>The address at which the channel's samples begin</returns>
+    public: TSample *GetSamples() const { return this->samples; }
+
+    /// <summary>Accesses the sample at the specified frame</summary>
+    /// <param name="frameIndex">Index of the frame whose sample will be accessed</param>
+    /// <returns>The sample at the specified frame</returns>
+    public: TSample &operator [](std::size_t frameIndex) const {
+      return this->samples[frameIndex * this->stride];
+    }
+
+    /// <summary>Looks up the sample format matching the channel's sample type</summary>
+    /// <returns>The sample format described by the sample type</returns>
+    private: static constexpr AudioSampleFormat getSampleFormat() {
+      typedef typename std::remove_const<TSample>::type SampleType;
+      if constexpr(std::is_same<SampleType, std::uint8_t>::value) {
+        return AudioSampleFormat::UnsignedInteger_8;
+      } else if constexpr(std::is_same<SampleType, std::int16_t>::value) {
+        return AudioSampleFormat::SignedInteger_16;
+      } else if constexpr(std::is_same<SampleType, std::int32_t>::value) {
+        return AudioSampleFormat::SignedInteger_32;
+      } else if constexpr(std::is_same<SampleType, float>::value) {
+        return AudioSampleFormat::Float_32;
+      } else if constexpr(std::is_same<SampleType, double>::value) {
+        return AudioSampleFormat::Float_64;
+      } else {
+        return AudioSampleFormat::Unknown;
+      }
+    }
+
+    /// <summary>Address of the channel's first sample</summary>
+    private: TSample *samples;
+    /// <summary>Number of samples in the channel</summary>
+    private: std::size_t frameCount;
+    /// <summary>Distance between two consecutive samples of the channel</summary>
+    private: std::size_t stride;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Audio
 
 #endif // NUCLEX_AUDIO_CHANNEL_H
@@ -0,0 +1,151 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_CHANNELBUFFER_H
+#define NUCLEX_AUDIO_CHANNELBUFFER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Channel.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Processing/SampleConverter.h" // for SampleConverter
+
+#include <cstddef> // for std::size_t
+#include <algorithm> // for std::copy()
+#include <type_traits> // for std::is_same
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio channel that stores its samples in its own contiguous array</summary>
+  /// <typeparam name="TSample">Type of the samples stored in the channel</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     The samples of a channel buffer follow each other without gaps and begin on
+  ///     a <see cref="SampleAllocator.Alignment" /> boundary, so processing code can run
+  ///     over them with aligned SIMD loads. Keeping one buffer per channel gives you
+  ///     a struct-of-arrays layout in which each channel can be processed on its own.
+  ///   </para>
+  ///   <para>
+  ///     Processing code should take a <see cref="Channel" /> view, which is obtained
+  ///     through <see cref="GetView" /> and costs no more than copying a few pointers.
+  ///     Samples are never converted behind the scenes. If another sample type is needed,
+  ///     call <see cref="ConvertTo" /> once and work with the converted buffer.
+  ///   </para>
+  /// </remarks>
+  template<typename TSample>
+  class ChannelBuffer : public ChannelBase {
+
+    /// <summary>Initializes a new channel buffer holding silence</summary>
+    /// <param name="frameCount">Number of samples the channel will store</param>
+    /// <param name="placement">Placement of the channel relative to the listener</param>
+    public: ChannelBuffer(std::size_t frameCount, ChannelPlacement placement) :
+      ChannelBase(placement, Channel<TSample>::getSampleFormat()),
+      samples(frameCount, silence()) {}
+
+    /// <summary>Counts the number of samples in the channel</summary>
+    /// <returns>The number of samples stored in the channel</returns>
+    public: std::size_t CountFrames() const { return this->samples.size(); }
+
+    /// <summary>Returns the address of the channel's first sample</summary>
+    /// <returns>The address at which the channel's samples begin</returns>
+    public: TSample *GetSamples() { return this->samples.data(); }
+
+    /// <summary>Returns the address of the channel's first sample</summary>
+    /// <returns>The address at which the channel's samples begin</returns>
+    public: const TSample *GetSamples() const { return this->samples.data(); }
+
+    /// <summary>Accesses the sample at the specified frame</summary>
+    /// <param name="frameIndex">Index of the frame whose sample will be accessed</param>
+    /// <returns>The sample at the specified frame</returns>
+    public: TSample &operator [](std::size_t frameIndex) {
+      return this->samples[frameIndex];
+    }
+
+    /// <summary>Accesses the sample at the specified frame</summary>
+    /// <param name="frameIndex">Index of the frame whose sample will be accessed</param>
+    /// <returns>The sample at the specified frame</returns>
+    public: const TSample &operator [](std::size_t frameIndex) const {
+      return this->samples[frameIndex];
+    }
+
+    /// <summary>Provides a view through which the channel's samples can be modified</summary>
+    /// <returns>A view on the samples, valid for as long as the channel buffer lives</returns>
+    public: Channel<TSample> GetView() {
+      return Channel<TSample>(this->samples.data(), this->samples.size(), 1, GetPlacement());
+    }
+
+    /// <summary>Provides a view through which the channel's samples can be read</summary>
+    /// <returns>A view on the samples, valid for as long as the channel buffer lives</returns>
+    public: Channel<const TSample> GetView() const {
+      return Channel<const TSample>(
+        this->samples.data(), this->samples.size(), 1, GetPlacement()
+      );
+    }
+
+    /// <summary>Creates a copy of the channel with its samples in another format</summary>
+    /// <typeparam name="TOtherSample">Type the samples will be converted to</typeparam>
+    /// <returns>A new channel buffer holding the converted samples</returns>
+    /// <remarks>
+    ///   The whole channel is converted in one go by the SIMD-enabled
+    ///   <see cref="Processing::SampleConverter" />, using the full bit depth of
+    ///   both sample types.
+    /// </remarks>
+    public: template<typename TOtherSample>
+    ChannelBuffer<TOtherSample> ConvertTo() const;
+
+    /// <summary>Returns the value of a silent sample for the channel's sample type</summary>
+    /// <returns>The sample value that represents silence</returns>
+    private: static constexpr TSample silence() {
+      if constexpr(std::is_same<TSample, std::uint8_t>::value) {
+        return TSample(128);
+      } else {
+        return TSample(0);
+      }
+    }
+
+    /// <summary>Samples stored in the channel</summary>
+    private: SampleVector<TSample> samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  template<typename TOtherSample>
+  inline ChannelBuffer<TOtherSample> ChannelBuffer<TSample>::ConvertTo() const {
+    ChannelBuffer<TOtherSample> converted(this->samples.size(), GetPlacement());
+    if constexpr(std::is_same<TSample, TOtherSample>::value) {
+      std::copy(this->samples.begin(), this->samples.end(), converted.GetSamples());
+    } else {
+      Processing::SampleConverter::Convert(
+        this->samples.data(), sizeof(TSample) * 8,
+        converted.GetSamples(), sizeof(TOtherSample) * 8,
+        this->samples.size()
+      );
+    }
+
+    return converted;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_CHANNELBUFFER_H
@@ -0,0 +1,130 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_EXECUTOR_H
+#define NUCLEX_AUDIO_EXECUTOR_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <functional> // for std::function
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How urgently a task submitted to an executor should run</summary>
+  enum class TaskPriority {
+
+    /// <summary>Work that something is waiting for, such as streams running dry</summary>
+    High = 0,
+    /// <summary>Typical work, such as decoding a track in parallel</summary>
+    Normal = 1,
+    /// <summary>Work that can wait, such as batch metadata scans and transcoding</summary>
+    Low = 2,
+    /// <summary>Work that only runs when nothing else is queued, such as indexing</summary>
+    Idle = 3
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs the library's background and parallel work on worker threads</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Parallel decoding, batch metadata scans, batch transcoding, decoding sound banks
+  ///     and the streaming manager all run on the installed executor instead of creating
+  ///     threads of their own. Unless another executor is installed, that is a
+  ///     <see cref="WorkStealingExecutor" /> with one thread per CPU core.
+  ///   </para>
+  ///   <para>
+  ///     Engines that have a job system of their own can implement this interface and
+  ///     install it, so the library's work is scheduled together with the engine's
+  ///     and cores aren't oversubscribed by a second, hidden thread pool.
+  ///   </para>
+  ///   <para>
+  ///     Features that wait for their tasks always run unclaimed tasks on the waiting
+  ///     thread themselves, so an executor with a single worker, or with all of its
+  ///     workers busy, only makes them slower and never deadlocks them.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Executor {
+
+    /// <summary>Installs the executor the library will run its work on</summary>
+    /// <param name="executor">Executor that will be used, null for the default one</param>
+    /// <remarks>
+    ///   Objects that were already created keep running on the executor that was
+    ///   installed when they were created.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Install(const std::shared_ptr<Executor> &executor);
+
+    /// <summary>Retrieves the executor the library runs its work on</summary>
+    /// <returns>The installed executor or the default one if none was installed</returns>
+    /// <remarks>
+    ///   The default executor is created when it is first needed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<Executor> GetInstalled();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~Executor() = default;
+
+    /// <summary>Counts the worker threads that are running tasks</summary>
+    /// <returns>The number of tasks the executor can run at the same time</returns>
+    public: virtual std::size_t CountWorkers() const = 0;
+
+    /// <summary>Schedules a task to run on one of the worker threads</summary>
+    /// <param name="task">Task that will be run</param>
+    /// <param name="priority">How urgently the task should be run</param>
+    /// <remarks>
+    ///   Tasks must not throw. Tasks with a higher priority are taken before those
+    ///   with a lower one, but tasks that are already running are not interrupted.
+    /// </remarks>
+    public: virtual void Submit(
+      std::function<void()> task, TaskPriority priority = TaskPriority::Normal
+    ) = 0;
+
+    /// <summary>Runs a task for each index in a range and waits until all are done</summary>
+    /// <param name="count">Number of indices the task will be run for</param>
+    /// <param name="body">Task that will be called for each index</param>
+    /// <param name="priority">How urgently the task should be run</param>
+    /// <remarks>
+    ///   <para>
+    ///     The calling thread takes part in the work and runs all indices that no worker
+    ///     has claimed yet, so at most one more than <see cref="CountWorkers" /> indices
+    ///     run at the same time.
+    ///   </para>
+    ///   <para>
+    ///     If the task throws, indices that haven't started yet are skipped and the first
+    ///     exception is rethrown once all indices that did start have finished.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void ParallelFor(
+      std::size_t count,
+      const std::function<void(std::size_t)> &body,
+      TaskPriority priority = TaskPriority::Normal
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_EXECUTOR_H
@@ -0,0 +1,78 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_FLOAT16_H
+#define NUCLEX_AUDIO_FLOAT16_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint16_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample stored as an IEEE 754 half precision floating point value</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Half precision floats have a 10 bit mantissa, which is roughly as precise as
+  ///     11-bit integer samples but keeps its relative precision at low volumes, and
+  ///     they take up half the memory of 32-bit floats. GPUs can read them natively.
+  ///   </para>
+  ///   <para>
+  ///     This is only a container for the bits, arithmetic should be done after
+  ///     converting to float. Conversion in bulk is provided by the
+  ///     <see cref="Processing.ConversionKernels" />, which use the F16C instructions
+  ///     on x86 processors and the NEON conversion instructions on ARM.
+  ///   </para>
+  /// </remarks>
+  struct Float16 {
+
+    /// <summary>Sign bit, 5 exponent bits and 10 mantissa bits of the value</summary>
+    public: std::uint16_t Bits;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample stored as a brain floating point value</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Brain floats are the upper half of a 32-bit float, keeping its 8 exponent bits
+  ///     but only 7 bits of the mantissa. They cover the whole range of 32-bit floats,
+  ///     so clipped or very quiet samples survive, at a coarser precision than half
+  ///     precision floats. Machine learning hardware commonly works with them.
+  ///   </para>
+  ///   <para>
+  ///     This is only a container for the bits, arithmetic should be done after
+  ///     converting to float via the <see cref="Processing.ConversionKernels" />.
+  ///   </para>
+  /// </remarks>
+  struct BFloat16 {
+
+    /// <summary>Sign bit, 8 exponent bits and 7 mantissa bits of the value</summary>
+    public: std::uint16_t Bits;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_FLOAT16_H
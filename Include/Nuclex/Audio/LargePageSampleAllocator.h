@@ -0,0 +1,160 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_LARGEPAGESAMPLEALLOCATOR_H
+#define NUCLEX_AUDIO_LARGEPAGESAMPLEALLOCATOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/SampleAllocator.h"
+
+#include <cstddef> // for std::size_t
+#include <mutex> // for std::mutex
+#include <unordered_map> // for std::unordered_map
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Kind of memory pages backing a block of sample memory</summary>
+  enum class LargePageKind {
+
+    /// <summary>Regular pages, usually 4 KiB in size</summary>
+    None,
+    /// <summary>Pages the kernel may merge into huge pages (Linux madvise())</summary>
+    Transparent,
+    /// <summary>Huge pages set aside by the operating system (hugetlbfs, large pages)</summary>
+    Explicit
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes a large page allocator has mapped in each page kind</summary>
+  struct LargePageUsage {
+
+    /// <summary>Bytes in mapped blocks that ended up with regular pages</summary>
+    public: std::size_t RegularByteCount;
+    /// <summary>Bytes in blocks the kernel has been asked to back with huge pages</summary>
+    public: std::size_t TransparentByteCount;
+    /// <summary>Bytes in blocks backed by explicitly reserved huge pages</summary>
+    public: std::size_t ExplicitByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample allocator that backs large blocks with huge pages</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Fully loaded tracks and decoded sound banks can occupy hundreds of megabytes.
+  ///     When a mixer reads from many of them at scattered positions, each 4 KiB page
+  ///     needs its own TLB entry and the misses add up. Backing these blocks with 2 MiB
+  ///     pages cuts the number of TLB entries needed by a factor of 512.
+  ///   </para>
+  ///   <para>
+  ///     Blocks of at least the minimum size are mapped directly from the operating
+  ///     system. On Linux, explicit huge pages (MAP_HUGETLB) are tried first if enabled,
+  ///     otherwise the mapping is aligned to 2 MiB and the kernel is asked to use
+  ///     transparent huge pages for it. On Windows, large pages (MEM_LARGE_PAGES) require
+  ///     the 'Lock pages in memory' privilege and are only tried if enabled. Whenever
+  ///     a kind of page can't be obtained, the allocator quietly falls back to the next
+  ///     one, so it can be installed unconditionally.
+  ///   </para>
+  ///   <para>
+  ///     Smaller blocks, such as the decoders' scratch buffers, come from the aligned
+  ///     operator new like with the default allocator. Install the allocator via
+  ///     <see cref="SampleAllocator.SetGlobal" /> before loading the tracks or banks
+  ///     it should provide memory for.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LargePageSampleAllocator : public SampleAllocator {
+
+    /// <summary>Size of the huge pages the allocator aligns its blocks to</summary>
+    public: static constexpr std::size_t HugePageSize = 2097152;
+
+    /// <summary>Initializes a new large page sample allocator</summary>
+    /// <param name="minimumByteCount">
+    ///   Smallest block that will be mapped directly from the operating system
+    /// </param>
+    /// <param name="useExplicitLargePages">
+    ///   Whether to try huge pages reserved by the operating system first
+    /// </param>
+    public: NUCLEX_AUDIO_API LargePageSampleAllocator(
+      std::size_t minimumByteCount = HugePageSize / 2, bool useExplicitLargePages = false
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    /// <remarks>
+    ///   All memory obtained from the allocator must have been freed at this point.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~LargePageSampleAllocator() override;
+
+    /// <summary>Allocates a block of memory aligned to <see cref="Alignment" /> bytes</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The address of the allocated memory</returns>
+    public: NUCLEX_AUDIO_API void *Allocate(std::size_t byteCount) override;
+
+    /// <summary>Frees a block of memory that was obtained through Allocate()</summary>
+    /// <param name="memory">Address of the memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: NUCLEX_AUDIO_API void Free(void *memory, std::size_t byteCount) noexcept override;
+
+    /// <summary>Reports the kind of pages backing a block of memory</summary>
+    /// <param name="memory">Address returned by <see cref="Allocate" /></param>
+    /// <returns>The kind of pages that were obtained for the block</returns>
+    public: NUCLEX_AUDIO_API LargePageKind GetPageKind(const void *memory) const;
+
+    /// <summary>Reports how many bytes the allocator has mapped in each page kind</summary>
+    /// <returns>The number of bytes currently mapped in each page kind</returns>
+    /// <remarks>
+    ///   Blocks below the minimum size come from the operator new and aren't included.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API LargePageUsage GetUsage() const;
+
+    /// <summary>A block of memory mapped directly from the operating system</summary>
+    private: struct MappedBlock {
+
+      /// <summary>Number of bytes that were mapped, a multiple of the page size</summary>
+      public: std::size_t MappedByteCount;
+      /// <summary>Kind of pages that were obtained for the block</summary>
+      public: LargePageKind PageKind;
+
+    };
+
+    /// <summary>Looks up mapped blocks by their addresses</summary>
+    private: typedef std::unordered_map<const void *, MappedBlock> MappedBlockMap;
+
+    /// <summary>Smallest block that will be mapped from the operating system</summary>
+    private: std::size_t minimumByteCount;
+    /// <summary>Whether huge pages reserved by the operating system will be tried</summary>
+    private: bool useExplicitLargePages;
+    /// <summary>Must be held while accessing the mapped blocks and the usage</summary>
+    private: mutable std::mutex mappedBlocksMutex;
+    /// <summary>Blocks that have been mapped directly from the operating system</summary>
+    private: MappedBlockMap mappedBlocks;
+    /// <summary>Number of bytes currently allocated in each page kind</summary>
+    private: LargePageUsage usage;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_LARGEPAGESAMPLEALLOCATOR_H
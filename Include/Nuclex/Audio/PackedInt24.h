@@ -0,0 +1,55 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PACKEDINT24_H
+#define NUCLEX_AUDIO_PACKEDINT24_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample stored as a 24-bit signed integer in 3 bytes</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Audio interfaces and many audio editors consume 24-bit samples without padding,
+  ///     so each sample takes 3 bytes and no alignment. Holding lossless audio like this
+  ///     needs 25% less memory than holding it as 32-bit integers.
+  ///   </para>
+  ///   <para>
+  ///     The bytes are little endian. This is only a container for the bits, conversion in
+  ///     bulk is provided by <see cref="Processing.Int24Packing" />, which packs and unpacks
+  ///     several samples per instruction using SSSE3, AVX2 or NEON.
+  ///   </para>
+  /// </remarks>
+  struct PackedInt24 {
+
+    /// <summary>Sample bits, starting with the least significant byte</summary>
+    public: std::byte Bytes[3];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_PACKEDINT24_H
@@ -22,14 +22,17 @@ limitations under the License.
 
 #include "Nuclex/Audio/Config.h"
 
+#include <cstddef> // for std::size_t
 #include <cstdint> // for std::int32_t
 #include <cmath> // for std::sgn
 
 #if defined(_MSC_VER)
 #include <intrin.h>
 #elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+#if defined(__i386__) || defined(__x86_64__)
 #include <x86intrin.h>
 #endif
+#endif
 
 // Whether the SSE2 SIMD instructions are supported by the targeted architecture
 #if defined(_MSC_VER)
@@ -48,8 +51,16 @@ limitations under the License.
 
 //#undef NUCLEX_AUDIO_HAVE_SSE2
 
-// TODO: ARM support?
-//#include <arm_neon.h>
+// Whether the ARM NEON SIMD instructions are supported by the targeted architecture.
+// Only AArch64 is considered because 32-bit ARM lacks the rounding conversions
+// and double precision lanes these methods rely on.
+#if defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_NEON))
+  #define NUCLEX_AUDIO_HAVE_NEON 1
+#endif
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Nuclex { namespace Audio { namespace Processing {
 
@@ -63,8 +74,44 @@ namespace Nuclex { namespace Audio { namespace Processing {
   ///     the value fills the entire range evenly, exactly like it would if it had been
   ///     converted to floating point and back to the higher-range integer.
   ///   </para>
+  ///   <para>
+  ///     The batch methods widen entire buffers to 32-bit integers. They pick SSE2, AVX2
+  ///     or NEON kernels at runtime, depending on what the CPU supports.
+  ///   </para>
   /// </remarks>
-  class BitExtension {
+  class NUCLEX_AUDIO_TYPE BitExtension {
+
+    /// <summary>Widens 16-bit integers to 32 bits, repeating their bit patterns</summary>
+    /// <param name="values">Integers that will be widened</param>
+    /// <param name="valueBitCount">Number of valid bits in the 16-bit integers</param>
+    /// <param name="results">Receives the 32-bit integers</param>
+    /// <param name="resultBitCount">
+    ///   Number of valid bits in the 32-bit integers, at least the value bit count
+    /// </param>
+    /// <param name="count">Number of integers that will be widened</param>
+    /// <remarks>
+    ///   This produces exactly the same results as <see cref="SampleConverter.ExtendBits" />
+    ///   would when it is asked to extend 16-bit integers to 32-bit integers.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void ExtendToInt32(
+      const std::int16_t *values, std::size_t valueBitCount,
+      std::int32_t *results, std::size_t resultBitCount,
+      std::size_t count
+    );
+
+    /// <summary>Extends 32-bit integers to more valid bits, repeating their bit patterns</summary>
+    /// <param name="values">Integers that will be extended</param>
+    /// <param name="valueBitCount">Number of valid bits in the input integers</param>
+    /// <param name="results">Receives the extended integers, can be the input</param>
+    /// <param name="resultBitCount">
+    ///   Number of valid bits in the extended integers, at least the value bit count
+    /// </param>
+    /// <param name="count">Number of integers that will be extended</param>
+    public: NUCLEX_AUDIO_API static void ExtendToInt32(
+      const std::int32_t *values, std::size_t valueBitCount,
+      std::int32_t *results, std::size_t resultBitCount,
+      std::size_t count
+    );
 
     /// <summary>Repeats the specified number of bits in a signed integer</summary>
     /// <param name="value">Integer in which bits will be repeated</param>
@@ -171,7 +218,6 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
 #else
     return value | ((value >> shift) & mask);
 #endif
@@ -194,7 +240,6 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
 #else
     value <<= preShift;
     return value | ((value >> shift) & mask);
@@ -222,7 +267,6 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
 #else
     std::int32_t shifted = (value >> shift) & mask;
     return value | shifted | (shifted >> shift);
@@ -250,7 +294,6 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
 #else
     value <<= preShift;
     std::int32_t shifted = (value >> shift) & mask;
@@ -278,7 +321,13 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t input = vld1q_s32(values);
+
+    vst1q_s32(
+      results,
+      vorrq_s32(input, vandq_s32(vshlq_s32(input, vdupq_n_s32(-shift)), vdupq_n_s32(mask)))
+    );
 #else
     results[0] = values[0] | ((values[0] >> shift) & mask);
     results[1] = values[1] | ((values[1] >> shift) & mask);
@@ -310,7 +359,13 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t input = vshlq_s32(vld1q_s32(values), vdupq_n_s32(preShift));
+
+    vst1q_s32(
+      results,
+      vorrq_s32(input, vandq_s32(vshlq_s32(input, vdupq_n_s32(-shift)), vdupq_n_s32(mask)))
+    );
 #else
     {
       std::int32_t shifted0 = values[0] << preShift;
@@ -355,7 +410,15 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t input = vld1q_s32(values);
+    int32x4_t negativeShift = vdupq_n_s32(-shift);
+    int32x4_t shifted = vandq_s32(vshlq_s32(input, negativeShift), vdupq_n_s32(mask));
+
+    vst1q_s32(
+      results,
+      vorrq_s32(input, vorrq_s32(shifted, vshlq_s32(shifted, negativeShift)))
+    );
 #else
     {
       std::int32_t shifted0 = (values[0] >> shift) & mask;
@@ -403,7 +466,15 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t input = vshlq_s32(vld1q_s32(values), vdupq_n_s32(preShift));
+    int32x4_t negativeShift = vdupq_n_s32(-shift);
+    int32x4_t shifted = vandq_s32(vshlq_s32(input, negativeShift), vdupq_n_s32(mask));
+
+    vst1q_s32(
+      results,
+      vorrq_s32(input, vorrq_s32(shifted, vshlq_s32(shifted, negativeShift)))
+    );
 #else
     {
       std::int32_t input0 = values[0] << preShift;
@@ -0,0 +1,90 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_BYTESWAPPING_H
+#define NUCLEX_AUDIO_PROCESSING_BYTESWAPPING_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t, std::byte
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of samples between big and little endian</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Waveform files with a RIFX header and AIFF files store their samples in big
+  ///     endian byte order. Rather than assembling each sample from its bytes, these
+  ///     methods reverse the bytes of 8 to 32 samples at once with a byte shuffle
+  ///     (SSSE3, AVX2) or byte reversal instruction (NEON), also for 24-bit samples.
+  ///   </para>
+  ///   <para>
+  ///     Source and target may be the same buffer to swap in place. Readers should swap
+  ///     small batches right before converting them so the samples are still in the cache
+  ///     when they're converted. The instruction set is chosen once at runtime, the same
+  ///     way <see cref="ConversionKernels" /> does it.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ByteSwapping {
+
+    /// <summary>Reverses the byte order of 16-bit samples</summary>
+    /// <param name="source">Samples whose byte order will be reversed</param>
+    /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+    /// <param name="count">Number of samples that will be byte-swapped</param>
+    public: NUCLEX_AUDIO_API static void Swap16(
+      const std::byte *source, std::byte *target, std::size_t count
+    );
+
+    /// <summary>Reverses the byte order of packed 24-bit samples</summary>
+    /// <param name="source">Samples whose byte order will be reversed</param>
+    /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+    /// <param name="count">Number of samples that will be byte-swapped</param>
+    /// <remarks>
+    ///   If the samples are going to be unpacked anyway, the big endian methods in
+    ///   <see cref="Int24Packing" /> do the swap as part of unpacking.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Swap24(
+      const std::byte *source, std::byte *target, std::size_t count
+    );
+
+    /// <summary>Reverses the byte order of 32-bit samples</summary>
+    /// <param name="source">Samples whose byte order will be reversed</param>
+    /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+    /// <param name="count">Number of samples that will be byte-swapped</param>
+    public: NUCLEX_AUDIO_API static void Swap32(
+      const std::byte *source, std::byte *target, std::size_t count
+    );
+
+    /// <summary>Reverses the byte order of 64-bit samples</summary>
+    /// <param name="source">Samples whose byte order will be reversed</param>
+    /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+    /// <param name="count">Number of samples that will be byte-swapped</param>
+    public: NUCLEX_AUDIO_API static void Swap64(
+      const std::byte *source, std::byte *target, std::size_t count
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_BYTESWAPPING_H
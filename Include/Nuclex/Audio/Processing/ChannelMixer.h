@@ -0,0 +1,190 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_CHANNELMIXER_H
+#define NUCLEX_AUDIO_PROCESSING_CHANNELMIXER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Routes and mixes any number of input channels into any number of outputs</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The mixer takes a matrix of coefficients (one row of input channel weights for
+  ///     each output channel, like the <see cref="DownmixMatrix" />) and inspects it once
+  ///     when it is constructed. Matrices that only reorder or drop channels are reduced to
+  ///     plain copies, matrices with few non-zero weights to a list of multiply-adds and
+  ///     everything else runs through a dense kernel that uses FMA where the CPU has it.
+  ///   </para>
+  ///   <para>
+  ///     Mixing works on separated or interleaved float buffers, either standalone or via
+  ///     <see cref="Storage::AudioTrackDecoder::CreateMixer" /> to mix while decoding.
+  ///     Mixing methods are const and keep no state, so a mixer can be shared by threads.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ChannelMixer {
+
+    /// <summary>Kernel the mixer has selected for its matrix</summary>
+    public: enum class Strategy {
+
+      /// <summary>Each output is a copy of one input or silent</summary>
+      Routing,
+      /// <summary>Outputs are sums of a few weighted inputs</summary>
+      Sparse,
+      /// <summary>Most inputs contribute to most outputs</summary>
+      Dense
+
+    };
+
+    /// <summary>Lists the channels of a channel layout in their interleaving order</summary>
+    /// <param name="layout">
+    ///   Combination of channel placements, such as those in
+    ///   <see cref="KnownChannelLayouts" />.
+    /// </param>
+    /// <returns>The channels in the order in which Waveform files would interleave them</returns>
+    public: NUCLEX_AUDIO_API static std::vector<ChannelPlacement> GetChannelOrder(
+      ChannelPlacement layout
+    );
+
+    /// <summary>Creates a mixer that routes channels to the same placement</summary>
+    /// <param name="inputChannelOrder">Channels that will be mixed, in order</param>
+    /// <param name="outputChannelOrder">Channels that will be produced, in order</param>
+    /// <returns>A mixer that copies each input to the output with the same placement</returns>
+    /// <remarks>
+    ///   Input channels without a matching output are dropped, outputs without a matching
+    ///   input stay silent. Use this to go between the channel orders of different APIs.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static ChannelMixer CreateRouting(
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      const std::vector<ChannelPlacement> &outputChannelOrder
+    );
+
+    /// <summary>Creates a mixer that spreads channels onto a larger speaker layout</summary>
+    /// <param name="inputChannelOrder">Channels that will be mixed, in order</param>
+    /// <param name="outputChannelOrder">Channels that will be produced, in order</param>
+    /// <returns>A mixer that fills the additional speakers from the existing channels</returns>
+    /// <remarks>
+    ///   Channels present on both sides are routed at full volume. A missing center is
+    ///   fed from the front left and right channels at -6 dB each, missing side or back
+    ///   channels from their front side at -3 dB and a mono input goes to the center or,
+    ///   if there is none, to the front left and right at -3 dB. The LFE channel is never
+    ///   synthesized. This is a simple passive upmix for stereo game audio, not a decoder
+    ///   for matrix encoded surround.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static ChannelMixer CreateUpmix(
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      const std::vector<ChannelPlacement> &outputChannelOrder
+    );
+
+    /// <summary>Initializes a new channel mixer for the specified matrix</summary>
+    /// <param name="matrix">Matrix of weights by which the channels will be mixed</param>
+    public: NUCLEX_AUDIO_API explicit ChannelMixer(const DownmixMatrix &matrix);
+
+    /// <summary>Counts the number of channels the mixer takes</summary>
+    /// <returns>The number of input channels</returns>
+    public: std::size_t CountInputChannels() const { return this->matrix.CountInputChannels(); }
+
+    /// <summary>Counts the number of channels the mixer produces</summary>
+    /// <returns>The number of output channels</returns>
+    public: std::size_t CountOutputChannels() const {
+      return this->matrix.CountOutputChannels();
+    }
+
+    /// <summary>Retrieves the order of the channels the mixer takes</summary>
+    /// <returns>A list of input channels in the order they're expected</returns>
+    public: const std::vector<ChannelPlacement> &GetInputChannelOrder() const {
+      return this->matrix.GetInputChannelOrder();
+    }
+
+    /// <summary>Retrieves the order of the channels the mixer produces</summary>
+    /// <returns>A list of output channels in the order they're produced</returns>
+    public: const std::vector<ChannelPlacement> &GetOutputChannelOrder() const {
+      return this->matrix.GetOutputChannelOrder();
+    }
+
+    /// <summary>Retrieves the matrix the mixer has been built for</summary>
+    /// <returns>The matrix of weights by which the channels are mixed</returns>
+    public: const DownmixMatrix &GetMatrix() const { return this->matrix; }
+
+    /// <summary>Tells which kernel the mixer selected for its matrix</summary>
+    /// <returns>The strategy by which the mixer produces its outputs</returns>
+    public: Strategy GetStrategy() const { return this->strategy; }
+
+    /// <summary>Mixes separated input channels into separated output channels</summary>
+    /// <param name="inputs">Buffers holding the samples of each input channel</param>
+    /// <param name="outputs">Buffers that will receive the samples of each output channel</param>
+    /// <param name="frameCount">Number of samples in each channel</param>
+    /// <remarks>
+    ///   Output buffers may be null pointers if the caller isn't interested in
+    ///   the respective channels. The output buffers must not overlap the inputs.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void MixSeparated(
+      const float *const inputs[], float *const outputs[], std::size_t frameCount
+    ) const;
+
+    /// <summary>Mixes interleaved input frames into interleaved output frames</summary>
+    /// <param name="input">Buffer holding the interleaved input frames</param>
+    /// <param name="output">Buffer that will receive the interleaved output frames</param>
+    /// <param name="frameCount">Number of frames that will be mixed</param>
+    /// <remarks>
+    ///   The output buffer must not overlap the input buffer.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void MixInterleaved(
+      const float *input, float *output, std::size_t frameCount
+    ) const;
+
+    /// <summary>Input channel and weight contributing to an output channel</summary>
+    private: struct Term {
+
+      /// <summary>Index of the input channel that contributes</summary>
+      public: std::size_t InputIndex;
+      /// <summary>Weight by which the input channel goes into the output channel</summary>
+      public: float Coefficient;
+
+    };
+
+    /// <summary>Matrix of weights by which the channels are mixed</summary>
+    private: DownmixMatrix matrix;
+    /// <summary>Kernel that has been selected for the matrix</summary>
+    private: Strategy strategy;
+    /// <summary>Non-zero terms of all output channels, one output after another</summary>
+    private: std::vector<Term> terms;
+    /// <summary>Index of the first term of each output, plus one past the last term</summary>
+    private: std::vector<std::size_t> termStarts;
+    /// <summary>
+    ///   Weights of each input channel in all outputs, one input after another and padded
+    ///   to a multiple of 8 outputs. Only used for interleaved dense mixing.
+    /// </summary>
+    private: std::vector<float> columns;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_CHANNELMIXER_H
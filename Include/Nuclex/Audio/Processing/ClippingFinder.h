@@ -0,0 +1,190 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_CLIPPINGFINDER_H
+#define NUCLEX_AUDIO_PROCESSING_CLIPPINGFINDER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int16_t, std::int32_t, std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stretch of consecutive clipped samples in one channel</summary>
+  struct NUCLEX_AUDIO_TYPE ClippedInterval {
+
+    /// <summary>Index of the channel in which the samples are clipped</summary>
+    public: std::size_t ChannelIndex;
+    /// <summary>Index of the first frame with a clipped sample in the channel</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of consecutive frames in which the channel is clipped</summary>
+    public: std::uint64_t FrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates runs of samples at or near full scale</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A single sample at full scale is normal for loud, well-mastered audio, but several
+  ///     consecutive samples at full scale mean the waveform was cut off. The finder reports
+  ///     each such run that is at least a minimum number of frames long.
+  ///   </para>
+  ///   <para>
+  ///     Samples are compared against the threshold 4 (or 8, for 16-bit integers) at a time
+  ///     with SSE2 or NEON and the results are packed into a bit mask covering 64 samples.
+  ///     Since clipping is rare, most masks are zero and the whole group is skipped. Only
+  ///     groups with clipped samples or a run still open are walked sample by sample.
+  ///   </para>
+  ///   <para>
+  ///     The finder keeps track of open runs between calls, so it can be fed a track
+  ///     block by block. Call <see cref="Finish" /> after the last block to close runs
+  ///     that reach the end of the track.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ClippingFinder {
+
+    /// <summary>Finds all clipped intervals in an audio track</summary>
+    /// <param name="decoder">Decoder for the audio track that will be scanned</param>
+    /// <param name="threshold">
+    ///   Level relative to full scale from which on samples count as clipped
+    /// </param>
+    /// <param name="minimumFrameCount">
+    ///   Number of consecutive clipped frames in a channel that make up a clipped interval
+    /// </param>
+    /// <returns>All clipped intervals, sorted by the frame they end at</returns>
+    /// <remarks>
+    ///   The track is decoded in large blocks through a fixed-size buffer, using the integer
+    ///   type closest to the track's native sample format, so memory use does not depend
+    ///   on the length of the track.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::vector<ClippedInterval> FindClippedIntervals(
+      const Storage::AudioTrackDecoder &decoder,
+      float threshold = 0.999f,
+      std::size_t minimumFrameCount = 3
+    );
+
+    /// <summary>Initializes a new clipping finder</summary>
+    /// <param name="channelCount">Number of channels in the audio that will be scanned</param>
+    /// <param name="threshold">
+    ///   Level relative to full scale from which on samples count as clipped
+    /// </param>
+    /// <param name="minimumFrameCount">
+    ///   Number of consecutive clipped frames in a channel that make up a clipped interval
+    /// </param>
+    public: NUCLEX_AUDIO_API ClippingFinder(
+      std::size_t channelCount, float threshold = 0.999f, std::size_t minimumFrameCount = 3
+    );
+
+    /// <summary>Counts the number of channels the finder scans</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Forgets all clipped intervals and open runs so a new track can be scanned</summary>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Scans a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to scan</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Scans a block of interleaved 16-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be scanned</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to scan</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int16_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Scans a block of interleaved 32-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be scanned</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to scan</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int32_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Closes any runs that are still open at the end of the track</summary>
+    public: NUCLEX_AUDIO_API void Finish();
+
+    /// <summary>Returns the clipped intervals found so far</summary>
+    /// <returns>All completed clipped intervals, sorted by the frame they end at</returns>
+    public: const std::vector<ClippedInterval> &GetClippedIntervals() const {
+      return this->intervals;
+    }
+
+    /// <summary>Scans interleaved samples of any type in groups of 64</summary>
+    /// <typeparam name="TSample">Type of the samples that will be scanned</typeparam>
+    /// <param name="samples">Interleaved samples that will be scanned</param>
+    /// <param name="frameCount">Number of frames to scan</param>
+    /// <param name="threshold">Magnitude from which on samples count as clipped</param>
+    private: template<typename TSample>
+    void processInterleaved(const TSample *samples, std::size_t frameCount, TSample threshold);
+
+    /// <summary>Walks through a group of samples, opening and closing runs</summary>
+    /// <param name="mask">Bit mask with one bit set for each clipped sample</param>
+    /// <param name="sampleCount">Number of samples in the group</param>
+    private: void scanMask(std::uint64_t mask, std::size_t sampleCount);
+
+    /// <summary>Closes the open run in a channel and records it if it is long enough</summary>
+    /// <param name="channelIndex">Index of the channel whose run will be closed</param>
+    /// <param name="endFrame">Index of the first frame that is not clipped anymore</param>
+    private: void closeRun(std::size_t channelIndex, std::uint64_t endFrame);
+
+    /// <summary>Number of channels in the scanned audio</summary>
+    private: std::size_t channelCount;
+    /// <summary>Magnitude from which on floating point samples are clipped</summary>
+    private: float floatThreshold;
+    /// <summary>Magnitude from which on 16-bit integer samples are clipped</summary>
+    private: std::int16_t int16Threshold;
+    /// <summary>Magnitude from which on 32-bit integer samples are clipped</summary>
+    private: std::int32_t int32Threshold;
+    /// <summary>Shortest run of clipped frames that will be reported</summary>
+    private: std::size_t minimumFrameCount;
+    /// <summary>Number of samples (not frames) scanned so far</summary>
+    private: std::uint64_t processedSampleCount;
+    /// <summary>Frame at which the open run in each channel began</summary>
+    private: std::vector<std::uint64_t> runStartFrames;
+    /// <summary>Number of channels that currently have an open run</summary>
+    private: std::size_t openRunCount;
+    /// <summary>Clipped intervals that have been found so far</summary>
+    private: std::vector<ClippedInterval> intervals;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_CLIPPINGFINDER_H
@@ -0,0 +1,195 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_CONTENTHASHER_H
+#define NUCLEX_AUDIO_PROCESSING_CONTENTHASHER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>128-bit hash identifying decoded audio samples</summary>
+  struct NUCLEX_AUDIO_TYPE ContentHash {
+
+    /// <summary>Lower 64 bits of the hash</summary>
+    public: std::uint64_t Low;
+    /// <summary>Upper 64 bits of the hash</summary>
+    public: std::uint64_t High;
+
+    /// <summary>Checks whether two content hashes are identical</summary>
+    /// <param name="other">Other content hash that will be compared</param>
+    /// <returns>True if both hashes are identical</returns>
+    public: bool operator ==(const ContentHash &other) const {
+      return (this->Low == other.Low) && (this->High == other.High);
+    }
+
+    /// <summary>Checks whether two content hashes are different</summary>
+    /// <param name="other">Other content hash that will be compared</param>
+    /// <returns>True if the hashes are different</returns>
+    public: bool operator !=(const ContentHash &other) const {
+      return (this->Low != other.Low) || (this->High != other.High);
+    }
+
+    /// <summary>Orders content hashes so they can be used as keys in sorted containers</summary>
+    /// <param name="other">Other content hash that will be compared</param>
+    /// <returns>True if this hash sorts before the other hash</returns>
+    public: bool operator <(const ContentHash &other) const {
+      return (
+        (this->High < other.High) ||
+        ((this->High == other.High) && (this->Low < other.Low))
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates hashes over decoded audio samples</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Files can differ in their bytes (tags, container, compression settings) and still
+  ///     hold exactly the same audio. Hashing the decoded samples instead of the file
+  ///     identifies such duplicates, so sound banks can store them once and caches of
+  ///     decoded audio can be keyed by what they contain rather than by path.
+  ///   </para>
+  ///   <para>
+  ///     Samples are hashed in a canonical format: the bit patterns of 32-bit floats,
+  ///     interleaved, which is what all decoders deliver for integer audio of up to 24 bits
+  ///     without any rounding. The hash also covers the channel count and the number
+  ///     of frames, but not the sample rate, so callers that want to tell apart identical
+  ///     samples played at different rates should keep the sample rate alongside it.
+  ///   </para>
+  ///   <para>
+  ///     Each sample is mixed with a key derived from its position in the track and the
+  ///     results are summed up, two samples per 128-bit register with SSE2 or NEON. Because
+  ///     the sum doesn't depend on the order of additions, ranges of a track can be hashed
+  ///     independently (on different threads, for example) and merged afterwards. This is
+  ///     a fast fingerprint, not a cryptographic hash, it does not withstand deliberately
+  ///     constructed collisions.
+  ///   </para>
+  ///   <para>
+  ///     Optionally, a hash is also kept for each block of a fixed number of frames, so
+  ///     tracks that share only a part of their audio can be compared block by block.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ContentHasher {
+
+    /// <summary>Calculates the content hash of a whole audio track</summary>
+    /// <param name="decoder">Decoder for the audio track that will be hashed</param>
+    /// <returns>The content hash of the track's samples</returns>
+    /// <remarks>
+    ///   The track is decoded in blocks through a fixed-size buffer, so memory use
+    ///   does not depend on the length of the track.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static ContentHash HashTrack(
+      const Storage::AudioTrackDecoder &decoder
+    );
+
+    /// <summary>Initializes a new content hasher</summary>
+    /// <param name="channelCount">Number of channels in the audio that will be hashed</param>
+    /// <param name="blockFrameCount">
+    ///   Number of frames covered by each block hash, 0 to only calculate the hash
+    ///   of the whole track
+    /// </param>
+    /// <param name="startFrame">Index of the first frame that will be hashed</param>
+    public: NUCLEX_AUDIO_API ContentHasher(
+      std::size_t channelCount, std::size_t blockFrameCount = 0, std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Counts the number of channels the hasher processes</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Forgets all samples hashed so far so a new track can be hashed</summary>
+    /// <param name="startFrame">Index of the first frame that will be hashed</param>
+    public: NUCLEX_AUDIO_API void Reset(std::uint64_t startFrame = 0);
+
+    /// <summary>Hashes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to hash</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Adds the samples another hasher has seen to this hasher</summary>
+    /// <param name="other">
+    ///   Hasher with the same channel count and block size that hashed another range
+    ///   of the same track
+    /// </param>
+    public: NUCLEX_AUDIO_API void Merge(const ContentHasher &other);
+
+    /// <summary>Returns the hash of all samples seen so far</summary>
+    /// <returns>The hash of the samples</returns>
+    public: NUCLEX_AUDIO_API ContentHash GetHash() const;
+
+    /// <summary>Counts the blocks for which individual hashes are available</summary>
+    /// <returns>The number of blocks, counting from the beginning of the track</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountBlocks() const;
+
+    /// <summary>Returns the hash of the samples in one block</summary>
+    /// <param name="blockIndex">Index of the block whose hash will be returned</param>
+    /// <returns>The hash of the samples in the specified block</returns>
+    public: NUCLEX_AUDIO_API ContentHash GetBlockHash(std::size_t blockIndex) const;
+
+    /// <summary>Running sums of the mixed samples for both halves of a hash</summary>
+    private: struct Sums {
+
+      /// <summary>Sum from which the lower 64 bits of the hash are formed</summary>
+      public: std::uint64_t Low;
+      /// <summary>Sum from which the upper 64 bits of the hash are formed</summary>
+      public: std::uint64_t High;
+      /// <summary>Number of frames that went into the sums</summary>
+      public: std::uint64_t FrameCount;
+
+    };
+
+    /// <summary>Number of channels in the audio being hashed</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames covered by each block hash, 0 for no block hashes</summary>
+    private: std::size_t blockFrameCount;
+    /// <summary>Index of the frame the next processed samples belong to</summary>
+    private: std::uint64_t nextFrame;
+    /// <summary>Sums over all samples seen so far</summary>
+    private: Sums totalSums;
+    /// <summary>Sums over the samples in each block, counting from the track's start</summary>
+    private: std::vector<Sums> blockSums;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_CONTENTHASHER_H
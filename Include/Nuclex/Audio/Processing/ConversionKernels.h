@@ -0,0 +1,182 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_CONVERSIONKERNELS_H
+#define NUCLEX_AUDIO_PROCESSING_CONVERSIONKERNELS_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Float16.h" // for Float16, BFloat16
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int32_t
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Instruction set used by the bulk sample conversion kernels</summary>
+  enum class ConversionKernelSet {
+
+    /// <summary>Plain C++ without any SIMD instructions</summary>
+    Scalar = 0,
+
+    /// <summary>SSE2 instructions, 4 samples at a time</summary>
+    Sse2 = 1,
+
+    /// <summary>AVX2 instructions, 8 samples at a time</summary>
+    Avx2 = 2,
+
+    /// <summary>AVX-512 foundation instructions, 16 samples at a time</summary>
+    Avx512 = 3,
+
+    /// <summary>ARM NEON instructions on AArch64, 4 samples at a time</summary>
+    Neon = 4
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts whole arrays of samples using the best instructions the CPU has</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The inline methods in <see cref="Quantization" /> and <see cref="Reconstruction" />
+  ///     are limited to the instruction set the library was compiled for. These methods
+  ///     instead pick their implementation when first used, based on what the CPU reports
+  ///     it supports. That way, a single binary uses AVX2 or AVX-512 where they exist and
+  ///     still runs on CPUs that only have SSE2.
+  ///   </para>
+  ///   <para>
+  ///     If the CPU offers nothing better than what the library was compiled for, the
+  ///     inline methods are used. All kernel sets round and divide the same way,
+  ///     so their results are identical.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ConversionKernels {
+
+    /// <summary>Returns the instruction set the conversion kernels are using</summary>
+    /// <returns>The instruction set chosen for the CPU this is running on</returns>
+    public: NUCLEX_AUDIO_API static ConversionKernelSet GetActiveKernelSet();
+
+    /// <summary>Returns the name of the instruction set the kernels are using</summary>
+    /// <returns>A short name such as &quot;AVX2&quot;, suitable for logging</returns>
+    public: NUCLEX_AUDIO_API static const char *GetActiveKernelSetName();
+
+    /// <summary>Multiplies and rounds floating point values to the nearest integers</summary>
+    /// <param name="values">Floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the integers nearest to the float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void MultiplyToNearestInt32(
+      const float *values, float factor, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Multiplies and rounds floating point values to the nearest integers</summary>
+    /// <param name="values">Floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the integers nearest to the float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void MultiplyToNearestInt32(
+      const float *values, double factor, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Multiplies and rounds floating point values to the nearest integers</summary>
+    /// <param name="values">Floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the integers nearest to the float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void MultiplyToNearestInt32(
+      const double *values, double factor, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Shifts integers to the right and normalizes them by dividing them</summary>
+    /// <param name="values">Integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Receives the normalized float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void ShiftAndDivideInt32ToFloat(
+      const std::int32_t *values, int shift, float quotient, float *results, std::size_t count
+    );
+
+    /// <summary>Shifts integers to the right and normalizes them by dividing them</summary>
+    /// <param name="values">Integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Receives the normalized float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void ShiftAndDivideInt32ToFloat(
+      const std::int32_t *values, int shift, double quotient, float *results, std::size_t count
+    );
+
+    /// <summary>Shifts integers to the right and normalizes them by dividing them</summary>
+    /// <param name="values">Integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Receives the normalized float values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void ShiftAndDivideInt32ToFloat(
+      const std::int32_t *values, int shift, double quotient, double *results, std::size_t count
+    );
+
+    /// <summary>Rounds floats to the nearest half precision floats</summary>
+    /// <param name="values">Floating point values that will be converted</param>
+    /// <param name="results">Receives the half precision floats</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   Values beyond the range of half precision floats become infinity, values too
+    ///   small for it become denormals or zero. Rounding is to the nearest even value.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void ConvertToFloat16(
+      const float *values, Float16 *results, std::size_t count
+    );
+
+    /// <summary>Widens half precision floats to floats</summary>
+    /// <param name="values">Half precision floats that will be converted</param>
+    /// <param name="results">Receives the floating point values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void ConvertFromFloat16(
+      const Float16 *values, float *results, std::size_t count
+    );
+
+    /// <summary>Rounds floats to the nearest brain floats</summary>
+    /// <param name="values">Floating point values that will be converted</param>
+    /// <param name="results">Receives the brain floats</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   Rounding is to the nearest even value. NaNs stay NaNs (but become quiet NaNs).
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void ConvertToBFloat16(
+      const float *values, BFloat16 *results, std::size_t count
+    );
+
+    /// <summary>Widens brain floats to floats</summary>
+    /// <param name="values">Brain floats that will be converted</param>
+    /// <param name="results">Receives the floating point values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API static void ConvertFromBFloat16(
+      const BFloat16 *values, float *results, std::size_t count
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_CONVERSIONKERNELS_H
@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "Nuclex/Audio/Config.h"
 
+#include <cstddef> // for std::size_t
 #include <limits> // for std::numeric_limits
 #include <cmath> // for std::sgn
 
@@ -31,7 +32,13 @@ namespace Nuclex { namespace Audio { namespace Processing {
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Provides helper methods to calculate decibels from amplitude</summary>
-  class DecibelConverter {
+  /// <remarks>
+  ///   The single value methods use the C++ standard library and are exact. The batch
+  ///   methods process 4 values at a time with SSE2 or NEON, using a polynomial
+  ///   approximation of the logarithm and exponential function instead. They are meant
+  ///   for meters and waveform displays that convert millions of values per second.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE DecibelConverter {
 
     /// <summary>Converts a linear amplitude value into decibel</summary>
     /// <param name="amplitude">Linear amplitude that will be converted</param>
@@ -59,6 +66,46 @@ namespace Nuclex { namespace Audio { namespace Processing {
     /// </remarks>
     public: static inline double FromLinearAmplitude(double amplitude);
 
+    /// <summary>Converts decibels into a linear amplitude value</summary>
+    /// <param name="decibels">Decibels relative to a normalized amplitude range</param>
+    /// <returns>The linear amplitude, with 0.0 decibels being an amplitude of 1.0</returns>
+    public: static inline float ToLinearAmplitude(float decibels);
+
+    /// <summary>Converts decibels into a linear amplitude value</summary>
+    /// <param name="decibels">Decibels relative to a normalized amplitude range</param>
+    /// <returns>The linear amplitude, with 0.0 decibels being an amplitude of 1.0</returns>
+    public: static inline double ToLinearAmplitude(double decibels);
+
+    /// <summary>Converts a batch of linear amplitude values into decibels</summary>
+    /// <param name="amplitudes">Linear amplitude values that will be converted</param>
+    /// <param name="decibels">Receives the decibels of each amplitude value</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   <para>
+    ///     The results differ from the single value method by no more than 0.0001 dB for
+    ///     finite amplitudes. Like in the single value method, amplitudes below the float
+    ///     epsilon produce infinity. The input and output may be the same buffer.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void FromLinearAmplitude(
+      const float *amplitudes, float *decibels, std::size_t count
+    );
+
+    /// <summary>Converts a batch of decibel values into linear amplitudes</summary>
+    /// <param name="decibels">Decibel values that will be converted</param>
+    /// <param name="amplitudes">Receives the linear amplitude of each decibel value</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   Within +/- 140 dB, which covers anything a 24-bit signal can express, the results
+    ///   differ from the single value method by less than 0.0002%. Beyond that, the error
+    ///   grows with the magnitude of the decibels because a float can hold them with less
+    ///   and less precision. Decibels are clamped to the range of normal floats, which is
+    ///   about -758 dB to +764 dB. The input and output may be the same buffer.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void ToLinearAmplitude(
+      const float *decibels, float *amplitudes, std::size_t count
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -85,6 +132,18 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline float DecibelConverter::ToLinearAmplitude(float decibels) {
+    return std::pow(10.0f, decibels / 20.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline double DecibelConverter::ToLinearAmplitude(double decibels) {
+    return std::pow(10.0, decibels / 20.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
 
 #endif // NUCLEX_AUDIO_PROCESSING_DECIBELCONVERTER_H
@@ -0,0 +1,160 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_DITHERER_H
+#define NUCLEX_AUDIO_PROCESSING_DITHERER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int32_t, std::uint32_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the quantization error is pushed around in the spectrum</summary>
+  enum class NoiseShaping {
+
+    /// <summary>Plain TPDF dither, the noise is spread evenly over all frequencies</summary>
+    None = 0,
+
+    /// <summary>Feeds back the previous error, moving noise towards high frequencies</summary>
+    FirstOrder = 1,
+
+    /// <summary>Feeds back the last two errors for a steeper high frequency tilt</summary>
+    SecondOrder = 2
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quantizes samples with triangular dither and optional noise shaping</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Rounding floating point samples to the nearest integer produces distortion that
+  ///     is correlated with the signal, audible as grit in quiet passages and fade-outs
+  ///     when exporting to 16 bits. Adding triangular (TPDF) noise of +/- 1 LSB before
+  ///     rounding turns that distortion into a constant, signal-independent noise floor.
+  ///   </para>
+  ///   <para>
+  ///     The noise comes from one xorshift generator per SIMD lane, so random numbers for
+  ///     4 samples are produced with a handful of integer instructions. Results do not
+  ///     depend on the instruction set, the scalar fallback runs the same 4 generators.
+  ///   </para>
+  ///   <para>
+  ///     The ditherer keeps the generator and noise shaping state between calls and
+  ///     tracks which channel the next interleaved sample belongs to, so a stream can
+  ///     be quantized in chunks of any size. Use one ditherer per stream. Dithered
+  ///     samples are clamped to the target range since the noise could push full-scale
+  ///     samples over.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Ditherer {
+
+    /// <summary>Initializes a new ditherer</summary>
+    /// <param name="channelCount">Number of interleaved channels in the samples</param>
+    /// <param name="shaping">Noise shaping that will be applied</param>
+    /// <param name="seed">Seed from which the random number generators start</param>
+    public: NUCLEX_AUDIO_API Ditherer(
+      std::size_t channelCount = 1,
+      NoiseShaping shaping = NoiseShaping::None,
+      std::uint32_t seed = 0x9E3779B9U
+    );
+
+    /// <summary>Returns the noise shaping the ditherer is applying</summary>
+    /// <returns>The noise shaping applied by the ditherer</returns>
+    public: NoiseShaping GetNoiseShaping() const { return this->shaping; }
+
+    /// <summary>Restarts the noise and forgets the noise shaping history</summary>
+    /// <remarks>
+    ///   Call this when jumping to another position in the stream.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Multiplies, dithers and rounds floating point values to integers</summary>
+    /// <param name="values">Floating point values that will be quantized</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="limit">Largest magnitude the integers may have after dithering</param>
+    /// <param name="results">Receives the dithered integers</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API void MultiplyToDitheredInt32(
+      const float *values, float factor, float limit, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Multiplies, dithers and rounds floating point values to integers</summary>
+    /// <param name="values">Floating point values that will be quantized</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="limit">Largest magnitude the integers may have after dithering</param>
+    /// <param name="results">Receives the dithered integers</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API void MultiplyToDitheredInt32(
+      const float *values, double factor, double limit, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Multiplies, dithers and rounds floating point values to integers</summary>
+    /// <param name="values">Floating point values that will be quantized</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="limit">Largest magnitude the integers may have after dithering</param>
+    /// <param name="results">Receives the dithered integers</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_AUDIO_API void MultiplyToDitheredInt32(
+      const double *values, double factor, double limit, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Fills a buffer with triangular noise from -1.0 to +1.0</summary>
+    /// <param name="noise">Buffer that will receive the noise</param>
+    /// <param name="count">Number of noise values that will be generated</param>
+    private: void generateNoise(float *noise, std::size_t count);
+
+    /// <summary>Dithers and rounds values, applying noise shaping per channel</summary>
+    /// <typeparam name="TValue">Type of the floating point values</typeparam>
+    /// <typeparam name="TFactor">Type in which the quantization is calculated</typeparam>
+    /// <param name="values">Floating point values that will be quantized</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="limit">Largest magnitude the integers may have after dithering</param>
+    /// <param name="results">Receives the dithered integers</param>
+    /// <param name="count">Number of values that will be converted</param>
+    private: template<typename TValue, typename TFactor>
+    void quantize(
+      const TValue *values, TFactor factor, TFactor limit,
+      std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Number of interleaved channels the samples have</summary>
+    private: std::size_t channelCount;
+    /// <summary>Noise shaping the ditherer is applying</summary>
+    private: NoiseShaping shaping;
+    /// <summary>Seed the random number generators started from</summary>
+    private: std::uint32_t seed;
+    /// <summary>State of the 4 xorshift random number generators, one per lane</summary>
+    private: std::uint32_t randomStates[4];
+    /// <summary>Channel the next interleaved sample belongs to</summary>
+    private: std::size_t channelIndex;
+    /// <summary>Last two quantization errors of each channel, for noise shaping</summary>
+    private: std::vector<double> errors;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_DITHERER_H
@@ -0,0 +1,137 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_DOWNMIXMATRIX_H
+#define NUCLEX_AUDIO_PROCESSING_DOWNMIXMATRIX_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes how to mix a set of input channels into fewer output channels</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each output channel is the weighted sum of all input channels. The weights
+  ///     (coefficients) are stored row by row, one row per output channel, with one column
+  ///     for each input channel.
+  ///   </para>
+  ///   <para>
+  ///     The presets follow ITU-R BS.775: front channels go to their side at full volume,
+  ///     center and surround channels are attenuated by 3 dB and the LFE channel is dropped.
+  ///     Like in the standard, the coefficients are not normalized, so loud passages in
+  ///     all channels can exceed full scale after mixing.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE DownmixMatrix {
+
+    /// <summary>Creates a matrix that mixes the specified channels down to stereo</summary>
+    /// <param name="inputChannelOrder">Channels that will be mixed, in order</param>
+    /// <returns>A downmix matrix producing a front left and a front right channel</returns>
+    public: NUCLEX_AUDIO_API static DownmixMatrix CreateItuStereo(
+      const std::vector<ChannelPlacement> &inputChannelOrder
+    );
+
+    /// <summary>Creates a matrix that mixes the specified channels down to mono</summary>
+    /// <param name="inputChannelOrder">Channels that will be mixed, in order</param>
+    /// <returns>A downmix matrix producing a front center channel</returns>
+    /// <remarks>
+    ///   This mixes down to stereo according to the ITU preset and then sums
+    ///   both stereo channels at -3 dB.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static DownmixMatrix CreateItuMono(
+      const std::vector<ChannelPlacement> &inputChannelOrder
+    );
+
+    /// <summary>Initializes a new downmix matrix with the specified coefficients</summary>
+    /// <param name="inputChannelOrder">Channels that will be mixed, in order</param>
+    /// <param name="outputChannelOrder">Channels that will be produced, in order</param>
+    /// <param name="coefficients">
+    ///   Weight of each input channel in each output channel, one row of input channel
+    ///   weights for each output channel
+    /// </param>
+    public: NUCLEX_AUDIO_API DownmixMatrix(
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      const std::vector<ChannelPlacement> &outputChannelOrder,
+      const std::vector<float> &coefficients
+    );
+
+    /// <summary>Counts the number of channels the matrix mixes</summary>
+    /// <returns>The number of input channels</returns>
+    public: std::size_t CountInputChannels() const { return this->inputChannelOrder.size(); }
+
+    /// <summary>Counts the number of channels the matrix produces</summary>
+    /// <returns>The number of output channels</returns>
+    public: std::size_t CountOutputChannels() const { return this->outputChannelOrder.size(); }
+
+    /// <summary>Retrieves the order of the channels the matrix mixes</summary>
+    /// <returns>A list of input channels in the order they're expected</returns>
+    public: const std::vector<ChannelPlacement> &GetInputChannelOrder() const {
+      return this->inputChannelOrder;
+    }
+
+    /// <summary>Retrieves the order of the channels the matrix produces</summary>
+    /// <returns>A list of output channels in the order they're produced</returns>
+    public: const std::vector<ChannelPlacement> &GetOutputChannelOrder() const {
+      return this->outputChannelOrder;
+    }
+
+    /// <summary>Looks up how much of an input channel goes into an output channel</summary>
+    /// <param name="outputChannelIndex">Index of the output channel</param>
+    /// <param name="inputChannelIndex">Index of the input channel</param>
+    /// <returns>The weight of the input channel in the output channel</returns>
+    public: float GetCoefficient(
+      std::size_t outputChannelIndex, std::size_t inputChannelIndex
+    ) const {
+      return this->coefficients[
+        outputChannelIndex * this->inputChannelOrder.size() + inputChannelIndex
+      ];
+    }
+
+    /// <summary>Mixes separated input channels into separated output channels</summary>
+    /// <param name="inputs">Buffers holding the samples of each input channel</param>
+    /// <param name="outputs">Buffers that will receive the samples of each output channel</param>
+    /// <param name="frameCount">Number of samples in each channel</param>
+    /// <remarks>
+    ///   Output buffers may be null pointers if the caller isn't interested in
+    ///   the respective channels. The output buffers must not overlap the inputs.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void MixSeparated(
+      const float *const inputs[], float *const outputs[], std::size_t frameCount
+    ) const;
+
+    /// <summary>Channels that will be mixed, in the order they're expected</summary>
+    private: std::vector<ChannelPlacement> inputChannelOrder;
+    /// <summary>Channels that will be produced, in the order they're produced</summary>
+    private: std::vector<ChannelPlacement> outputChannelOrder;
+    /// <summary>Weight of each input channel in each output channel, row by row</summary>
+    private: std::vector<float> coefficients;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_DOWNMIXMATRIX_H
@@ -0,0 +1,125 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_FFTPLAN_H
+#define NUCLEX_AUDIO_PROCESSING_FFTPLAN_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Precomputed tables for the fast fourier transform of real signals</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A real signal of N samples is transformed by treating it as N/2 complex
+  ///     samples, running a radix-2 complex FFT on those and untangling the result
+  ///     into the N/2 + 1 bins of the real signal's spectrum. The bit reversal order
+  ///     and all twiddle factors are computed once, when the plan is created.
+  ///   </para>
+  ///   <para>
+  ///     The complex FFT works on separate arrays of real and imaginary parts, so its
+  ///     butterflies process 4 values at a time with SSE2 or NEON in all but the first
+  ///     two stages. Plans are immutable and all working memory is provided by the caller,
+  ///     so a single plan can be used by any number of threads at once.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE FftPlan {
+
+    /// <summary>Returns a plan for the specified size, sharing identical ones</summary>
+    /// <param name="size">Number of real samples that will be transformed</param>
+    /// <returns>The plan for transforming signals of the specified size</returns>
+    /// <remarks>
+    ///   Plans are cached per size for as long as at least one user is holding them.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const FftPlan> GetShared(
+      std::size_t size
+    );
+
+    /// <summary>Builds a new plan for transforming signals of the specified size</summary>
+    /// <param name="size">
+    ///   Number of real samples that will be transformed, a power of two no less than 8
+    /// </param>
+    public: NUCLEX_AUDIO_API explicit FftPlan(std::size_t size);
+
+    /// <summary>Returns the number of real samples the plan transforms</summary>
+    /// <returns>The number of samples in the transformed signal</returns>
+    public: std::size_t GetSize() const { return this->size; }
+
+    /// <summary>Counts the number of frequency bins the transform produces</summary>
+    /// <returns>The number of bins from DC up to and including the Nyquist frequency</returns>
+    public: std::size_t CountBins() const { return this->size / 2 + 1; }
+
+    /// <summary>Counts the number of floats of working memory a transform needs</summary>
+    /// <returns>The required length of the scratch buffer</returns>
+    public: std::size_t CountScratchSamples() const { return this->size * 2 + 2; }
+
+    /// <summary>Transforms a real signal into its complex spectrum</summary>
+    /// <param name="samples">Signal of <see cref="GetSize" /> samples</param>
+    /// <param name="real">Receives the real parts of <see cref="CountBins" /> bins</param>
+    /// <param name="imaginary">Receives the imaginary parts of all bins</param>
+    /// <param name="scratch">Working memory of <see cref="CountScratchSamples" /> floats</param>
+    /// <remarks>
+    ///   The spectrum is not normalized, a constant signal of 1.0 ends up as a DC bin
+    ///   holding the number of samples.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Transform(
+      const float *samples, float *real, float *imaginary, float *scratch
+    ) const;
+
+    /// <summary>Transforms a real signal into the power of each frequency bin</summary>
+    /// <param name="samples">Signal of <see cref="GetSize" /> samples</param>
+    /// <param name="powers">Receives the squared magnitudes of all bins</param>
+    /// <param name="scale">Factor by which the magnitudes are multiplied before squaring</param>
+    /// <param name="scratch">Working memory of <see cref="CountScratchSamples" /> floats</param>
+    public: NUCLEX_AUDIO_API void ComputePowers(
+      const float *samples, float *powers, float scale, float *scratch
+    ) const;
+
+    /// <summary>Runs the complex FFT on the signal, leaving the result in scratch</summary>
+    /// <param name="samples">Signal of <see cref="GetSize" /> samples</param>
+    /// <param name="scratch">Receives the real parts, then the imaginary parts</param>
+    private: void transformComplex(const float *samples, float *scratch) const;
+
+    /// <summary>Number of real samples the plan transforms</summary>
+    private: std::size_t size;
+    /// <summary>Index of the complex sample that goes into each position</summary>
+    private: std::vector<std::uint32_t> bitReversal;
+    /// <summary>Real parts of the twiddle factors of all stages, one after another</summary>
+    private: std::vector<float> twiddleReal;
+    /// <summary>Imaginary parts of the twiddle factors of all stages</summary>
+    private: std::vector<float> twiddleImaginary;
+    /// <summary>Real parts of the factors that untangle the real spectrum</summary>
+    private: std::vector<float> splitReal;
+    /// <summary>Imaginary parts of the factors that untangle the real spectrum</summary>
+    private: std::vector<float> splitImaginary;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_FFTPLAN_H
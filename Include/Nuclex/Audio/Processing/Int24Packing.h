@@ -0,0 +1,158 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_INT24PACKING_H
+#define NUCLEX_AUDIO_PROCESSING_INT24PACKING_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::int32_t
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts between packed 24-bit samples and 32-bit integers</summary>
+  /// <remarks>
+  ///   <para>
+  ///     24-bit audio is usually stored with 3 bytes per sample and no padding, so every
+  ///     sample straddles a different byte boundary. Unpacking them one at a time with
+  ///     shifts is slow. These methods instead shuffle 4 (SSSE3), 8 (AVX2) or 16 (NEON)
+  ///     samples at once into 32-bit lanes and sign-extend them there.
+  ///   </para>
+  ///   <para>
+  ///     The packed samples are little endian, as in Waveform files, unless the method
+  ///     says otherwise. Big endian samples (RIFX or AIFF files) are byte-swapped by
+  ///     the same shuffle that unpacks them, so they cost nothing extra. The instruction
+  ///     set is chosen once at runtime, the same way <see cref="ConversionKernels" /> does it.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Int24Packing {
+
+    /// <summary>Unpacks 24-bit samples into sign-extended 32-bit integers</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, little endian</param>
+    /// <param name="results">Receives the unpacked samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    /// <remarks>
+    ///   The results range from -8388608 to +8388607, the sample bits are not moved.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void UnpackToInt32(
+      const std::byte *packed, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Unpacks 24-bit samples into the upper 24 bits of 32-bit integers</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, little endian</param>
+    /// <param name="results">Receives the unpacked samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    /// <remarks>
+    ///   The results use the full range of a 32-bit integer with the lowest 8 bits zeroed,
+    ///   which is how decoders and encoders exchange 32-bit integer samples.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void UnpackToHighInt32(
+      const std::byte *packed, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Unpacks 24-bit samples and normalizes them to floating point</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, little endian</param>
+    /// <param name="shift">
+    ///   Number of bits to shift each sample to the right, for formats that only use
+    ///   the upper bits of the 24 bits
+    /// </param>
+    /// <param name="quotient">Quotient by which the shifted samples will be divided</param>
+    /// <param name="results">Receives the normalized samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    public: NUCLEX_AUDIO_API static void UnpackToFloat(
+      const std::byte *packed, int shift, double quotient, float *results, std::size_t count
+    );
+
+    /// <summary>Unpacks 24-bit samples and normalizes them to floating point</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, little endian</param>
+    /// <param name="shift">
+    ///   Number of bits to shift each sample to the right, for formats that only use
+    ///   the upper bits of the 24 bits
+    /// </param>
+    /// <param name="quotient">Quotient by which the shifted samples will be divided</param>
+    /// <param name="results">Receives the normalized samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    public: NUCLEX_AUDIO_API static void UnpackToFloat(
+      const std::byte *packed, int shift, double quotient, double *results, std::size_t count
+    );
+
+    /// <summary>Unpacks big endian 24-bit samples into sign-extended 32-bit integers</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, big endian</param>
+    /// <param name="results">Receives the unpacked samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    public: NUCLEX_AUDIO_API static void UnpackBigEndianToInt32(
+      const std::byte *packed, std::int32_t *results, std::size_t count
+    );
+
+    /// <summary>Unpacks big endian 24-bit samples and normalizes them to floating point</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, big endian</param>
+    /// <param name="shift">
+    ///   Number of bits to shift each sample to the right, for formats that only use
+    ///   the upper bits of the 24 bits
+    /// </param>
+    /// <param name="quotient">Quotient by which the shifted samples will be divided</param>
+    /// <param name="results">Receives the normalized samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    public: NUCLEX_AUDIO_API static void UnpackBigEndianToFloat(
+      const std::byte *packed, int shift, double quotient, float *results, std::size_t count
+    );
+
+    /// <summary>Unpacks big endian 24-bit samples and normalizes them to floating point</summary>
+    /// <param name="packed">Packed samples, 3 bytes each, big endian</param>
+    /// <param name="shift">
+    ///   Number of bits to shift each sample to the right, for formats that only use
+    ///   the upper bits of the 24 bits
+    /// </param>
+    /// <param name="quotient">Quotient by which the shifted samples will be divided</param>
+    /// <param name="results">Receives the normalized samples</param>
+    /// <param name="count">Number of samples that will be unpacked</param>
+    public: NUCLEX_AUDIO_API static void UnpackBigEndianToFloat(
+      const std::byte *packed, int shift, double quotient, double *results, std::size_t count
+    );
+
+    /// <summary>Packs the lower 24 bits of 32-bit integers into 3 bytes each</summary>
+    /// <param name="values">Samples that will be packed, -8388608 to +8388607</param>
+    /// <param name="packed">Receives the packed samples, little endian</param>
+    /// <param name="count">Number of samples that will be packed</param>
+    public: NUCLEX_AUDIO_API static void PackFromInt32(
+      const std::int32_t *values, std::byte *packed, std::size_t count
+    );
+
+    /// <summary>Packs the upper 24 bits of 32-bit integers into 3 bytes each</summary>
+    /// <param name="values">Samples that will be packed, using the full 32-bit range</param>
+    /// <param name="packed">Receives the packed samples, little endian</param>
+    /// <param name="count">Number of samples that will be packed</param>
+    /// <remarks>
+    ///   The lowest 8 bits are dropped by the same shuffle that packs the samples, so
+    ///   this costs exactly as much as <see cref="PackFromInt32" />.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void PackHighFromInt32(
+      const std::int32_t *values, std::byte *packed, std::size_t count
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_INT24PACKING_H
@@ -0,0 +1,169 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_INTERLEAVER_H
+#define NUCLEX_AUDIO_PROCESSING_INTERLEAVER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int32_t, std::int16_t, std::uint8_t
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts between interleaved and separated channels</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Decoders either deliver one buffer per channel (FLAC, Vorbis) or interleaved
+  ///     frames (Opus, Waveform), but callers can ask for either layout. Writing one
+  ///     sample at a time with a stride of the channel count is slow because every store
+  ///     lands in a different place. These methods move samples in blocks instead.
+  ///   </para>
+  ///   <para>
+  ///     For 32-bit samples with 2, 4, 6 or 8 channels, SSE2 or NEON shuffles transpose
+  ///     four frames at a time. Other channel counts up to 8 use loops specialized for
+  ///     the channel count, and anything beyond that falls back to a generic loop.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Interleaver {
+
+    /// <summary>Interleaves separate channels into a single buffer</summary>
+    /// <param name="sources">Buffers holding the samples of each channel</param>
+    /// <param name="target">Buffer that receives the interleaved samples</param>
+    /// <param name="channelCount">Number of channels that will be interleaved</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to interleave</param>
+    public: NUCLEX_AUDIO_API static void Interleave(
+      const std::uint8_t *const sources[], std::uint8_t *target,
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Interleaves separate channels into a single buffer</summary>
+    /// <param name="sources">Buffers holding the samples of each channel</param>
+    /// <param name="target">Buffer that receives the interleaved samples</param>
+    /// <param name="channelCount">Number of channels that will be interleaved</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to interleave</param>
+    public: NUCLEX_AUDIO_API static void Interleave(
+      const std::int16_t *const sources[], std::int16_t *target,
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Interleaves separate channels into a single buffer</summary>
+    /// <param name="sources">Buffers holding the samples of each channel</param>
+    /// <param name="target">Buffer that receives the interleaved samples</param>
+    /// <param name="channelCount">Number of channels that will be interleaved</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to interleave</param>
+    public: NUCLEX_AUDIO_API static void Interleave(
+      const std::int32_t *const sources[], std::int32_t *target,
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Interleaves separate channels into a single buffer</summary>
+    /// <param name="sources">Buffers holding the samples of each channel</param>
+    /// <param name="target">Buffer that receives the interleaved samples</param>
+    /// <param name="channelCount">Number of channels that will be interleaved</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to interleave</param>
+    public: NUCLEX_AUDIO_API static void Interleave(
+      const float *const sources[], float *target,
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Interleaves separate channels into a single buffer</summary>
+    /// <param name="sources">Buffers holding the samples of each channel</param>
+    /// <param name="target">Buffer that receives the interleaved samples</param>
+    /// <param name="channelCount">Number of channels that will be interleaved</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to interleave</param>
+    public: NUCLEX_AUDIO_API static void Interleave(
+      const double *const sources[], double *target,
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Separates interleaved samples into one buffer per channel</summary>
+    /// <param name="source">Buffer holding the interleaved samples</param>
+    /// <param name="targets">
+    ///   Buffers that receive the samples of each channel. Channels whose buffer is
+    ///   a null pointer are skipped.
+    /// </param>
+    /// <param name="channelCount">Number of channels in the interleaved samples</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to separate</param>
+    public: NUCLEX_AUDIO_API static void Deinterleave(
+      const std::uint8_t *source, std::uint8_t *const targets[],
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Separates interleaved samples into one buffer per channel</summary>
+    /// <param name="source">Buffer holding the interleaved samples</param>
+    /// <param name="targets">
+    ///   Buffers that receive the samples of each channel. Channels whose buffer is
+    ///   a null pointer are skipped.
+    /// </param>
+    /// <param name="channelCount">Number of channels in the interleaved samples</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to separate</param>
+    public: NUCLEX_AUDIO_API static void Deinterleave(
+      const std::int16_t *source, std::int16_t *const targets[],
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Separates interleaved samples into one buffer per channel</summary>
+    /// <param name="source">Buffer holding the interleaved samples</param>
+    /// <param name="targets">
+    ///   Buffers that receive the samples of each channel. Channels whose buffer is
+    ///   a null pointer are skipped.
+    /// </param>
+    /// <param name="channelCount">Number of channels in the interleaved samples</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to separate</param>
+    public: NUCLEX_AUDIO_API static void Deinterleave(
+      const std::int32_t *source, std::int32_t *const targets[],
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Separates interleaved samples into one buffer per channel</summary>
+    /// <param name="source">Buffer holding the interleaved samples</param>
+    /// <param name="targets">
+    ///   Buffers that receive the samples of each channel. Channels whose buffer is
+    ///   a null pointer are skipped.
+    /// </param>
+    /// <param name="channelCount">Number of channels in the interleaved samples</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to separate</param>
+    public: NUCLEX_AUDIO_API static void Deinterleave(
+      const float *source, float *const targets[],
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+    /// <summary>Separates interleaved samples into one buffer per channel</summary>
+    /// <param name="source">Buffer holding the interleaved samples</param>
+    /// <param name="targets">
+    ///   Buffers that receive the samples of each channel. Channels whose buffer is
+    ///   a null pointer are skipped.
+    /// </param>
+    /// <param name="channelCount">Number of channels in the interleaved samples</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to separate</param>
+    public: NUCLEX_AUDIO_API static void Deinterleave(
+      const double *source, double *const targets[],
+      std::size_t channelCount, std::size_t frameCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_INTERLEAVER_H
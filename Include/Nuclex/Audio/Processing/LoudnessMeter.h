@@ -0,0 +1,187 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_LOUDNESSMETER_H
+#define NUCLEX_AUDIO_PROCESSING_LOUDNESSMETER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int16_t, std::int32_t, std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures loudness according to ITU-R BS.1770-4 and EBU R128</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each channel is K-weighted (a high shelf for the head's acoustic effect followed by
+  ///     a high-pass filter) and its power is summed with the weight the standard assigns
+  ///     to the channel's placement: surround channels count 1.5 dB more, the LFE channel
+  ///     is ignored. Momentary loudness covers the last 400 ms, short-term loudness the
+  ///     last 3 seconds and integrated loudness the whole program with the absolute
+  ///     (-70 LUFS) and relative (-10 LU) gates applied.
+  ///   </para>
+  ///   <para>
+  ///     The meter is fed blocks of interleaved samples straight from a decoder. The filters
+  ///     run in double precision with two channels per SSE2 or NEON register. True peak is
+  ///     measured by oversampling 4x with a polyphase filter whose 4 phases are computed
+  ///     in one single precision register.
+  ///   </para>
+  ///   <para>
+  ///     Integrated loudness needs to remember the power of every 400 ms block above the
+  ///     absolute gate, which is 10 values per second of audio, or about 280 KiB per hour.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LoudnessMeter {
+
+    /// <summary>Initializes a new loudness meter</summary>
+    /// <param name="sampleRate">Sample rate of the audio that will be measured</param>
+    /// <param name="channelOrder">Placement of each channel, in interleaved order</param>
+    public: NUCLEX_AUDIO_API LoudnessMeter(
+      std::size_t sampleRate, const std::vector<ChannelPlacement> &channelOrder
+    );
+
+    /// <summary>Counts the number of channels the meter measures</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Forgets everything measured so far so a new program can be measured</summary>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Measures a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to measure</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Measures a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to measure</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const double *samples, std::size_t frameCount
+    );
+
+    /// <summary>Measures a block of interleaved 16-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be measured</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to measure</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int16_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Measures a block of interleaved 32-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be measured</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to measure</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int32_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Returns the loudness of the last 400 milliseconds</summary>
+    /// <returns>The momentary loudness in LUFS, negative infinity if not available yet</returns>
+    public: NUCLEX_AUDIO_API double GetMomentaryLoudness() const;
+
+    /// <summary>Returns the loudness of the last 3 seconds</summary>
+    /// <returns>The short-term loudness in LUFS, negative infinity if not available yet</returns>
+    public: NUCLEX_AUDIO_API double GetShortTermLoudness() const;
+
+    /// <summary>Returns the gated loudness of everything measured so far</summary>
+    /// <returns>The integrated loudness in LUFS, negative infinity for silence</returns>
+    public: NUCLEX_AUDIO_API double GetIntegratedLoudness() const;
+
+    /// <summary>Returns the highest true peak level across all channels</summary>
+    /// <returns>The true peak level relative to full scale</returns>
+    public: NUCLEX_AUDIO_API double GetTruePeak() const;
+
+    /// <summary>Returns the highest true peak level of a single channel</summary>
+    /// <param name="channelIndex">Index of the channel whose true peak will be returned</param>
+    /// <returns>The true peak level of the channel relative to full scale</returns>
+    public: NUCLEX_AUDIO_API double GetTruePeak(std::size_t channelIndex) const;
+
+    /// <summary>Returns the highest true peak level across all channels in decibels</summary>
+    /// <returns>The true peak level in dBTP, negative infinity for silence</returns>
+    public: NUCLEX_AUDIO_API double GetTruePeakDecibels() const;
+
+    /// <summary>Measures interleaved samples of any type</summary>
+    /// <typeparam name="TSample">Type of the samples that will be measured</typeparam>
+    /// <param name="samples">Interleaved samples that will be measured</param>
+    /// <param name="frameCount">Number of frames to measure</param>
+    /// <param name="scale">Factor that turns a sample into a full scale relative value</param>
+    private: template<typename TSample>
+    void processInterleaved(const TSample *samples, std::size_t frameCount, double scale);
+
+    /// <summary>Runs the K-weighting filters over the current frame</summary>
+    private: void filterFrame();
+
+    /// <summary>Oversamples the current frame and updates the true peaks</summary>
+    private: void detectTruePeaks();
+
+    /// <summary>Records the power of a completed 100 millisecond step</summary>
+    private: void completeStep();
+
+    /// <summary>Calculates the mean power over the most recent steps</summary>
+    /// <param name="stepCount">Number of 100 millisecond steps to average</param>
+    /// <returns>The channel weighted mean power over the steps</returns>
+    private: double getRecentPower(std::size_t stepCount) const;
+
+    /// <summary>Number of channels in the measured audio</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of channels rounded up to fill whole SIMD registers</summary>
+    private: std::size_t paddedChannelCount;
+    /// <summary>Number of frames in each 100 millisecond step</summary>
+    private: std::size_t stepFrameCount;
+    /// <summary>Weight of each channel's power in the overall loudness</summary>
+    private: std::vector<double> channelWeights;
+    /// <summary>Coefficients b0, b1, b2, a1, a2 of the shelf and high-pass filters</summary>
+    private: double filterCoefficients[10];
+    /// <summary>Two state variables per filter and channel, stored channel pair by pair</summary>
+    private: std::vector<double> filterStates;
+    /// <summary>Samples of the frame that is being processed</summary>
+    private: std::vector<double> frame;
+    /// <summary>Sum of the squared, K-weighted samples of each channel in this step</summary>
+    private: std::vector<double> stepEnergies;
+    /// <summary>Number of frames that have been added to the current step</summary>
+    private: std::size_t stepFrameIndex;
+
+    /// <summary>Channel weighted energy of the last 30 steps (3 seconds)</summary>
+    private: double recentStepEnergies[30];
+    /// <summary>Number of steps that have been completed so far</summary>
+    private: std::uint64_t completedStepCount;
+    /// <summary>Mean power of each 400 millisecond block above the absolute gate</summary>
+    private: std::vector<double> gatedBlockPowers;
+
+    /// <summary>Polyphase coefficients for oversampling, one set of 4 phases per tap</summary>
+    private: float oversamplingCoefficients[48];
+    /// <summary>Recent samples of each channel, stored twice to avoid wrapping</summary>
+    private: std::vector<float> oversamplingHistory;
+    /// <summary>Index in the history at which the newest sample is stored</summary>
+    private: std::size_t historyIndex;
+    /// <summary>Highest oversampled magnitude of each channel in each phase</summary>
+    private: std::vector<float> truePeaks;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_LOUDNESSMETER_H
@@ -0,0 +1,248 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_PEAKPYRAMID_H
+#define NUCLEX_AUDIO_PROCESSING_PEAKPYRAMID_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::uint64_t
+#include <future> // for std::future
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Levels of one channel over a range of frames</summary>
+  struct NUCLEX_AUDIO_TYPE PeakBucket {
+
+    /// <summary>Lowest sample value in the range</summary>
+    public: float Minimum;
+    /// <summary>Highest sample value in the range</summary>
+    public: float Maximum;
+    /// <summary>Root mean square of all samples in the range</summary>
+    public: float Rms;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multi-resolution overview of a track's levels for drawing waveforms</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Drawing the waveform of an hour-long recording straight from its samples would
+  ///     mean decoding all of them whenever the view changes. The pyramid reduces the track
+  ///     to buckets holding the minimum, maximum and RMS level of a fixed number of frames,
+  ///     at several resolutions. A view picks the level whose buckets are closest
+  ///     to its frames per pixel via <see cref="SelectLevel" /> and looks buckets up
+  ///     directly by index.
+  ///   </para>
+  ///   <para>
+  ///     Only the finest level is computed from samples, with SSE2 or NEON doing the
+  ///     reductions 4 samples at a time. Coarser levels are aggregated from it, so their
+  ///     bucket sizes must be multiples of the finest bucket size.
+  ///   </para>
+  ///   <para>
+  ///     The serialized form stores levels as 16-bit fixed point values relative to full
+  ///     scale, 6 bytes per bucket and channel, so it can be cached next to the asset.
+  ///     Values beyond full scale are clamped when serializing.
+  ///   </para>
+  ///   <para>
+  ///     For thumbnails of long tracks, <see cref="Skim" /> produces an approximate
+  ///     pyramid from a fraction of the track's blocks, which can be shown right away
+  ///     while <see cref="BuildAsync" /> computes the exact one in the background.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE PeakPyramid {
+
+    /// <summary>Builds the pyramid for a whole track</summary>
+    /// <param name="decoder">Decoder of the track that will be scanned</param>
+    /// <param name="bucketFrameCounts">Number of frames per bucket in each level</param>
+    /// <returns>The complete pyramid for the track</returns>
+    /// <remarks>
+    ///   The track is decoded once, in chunks, as separated floating point channels.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static PeakPyramid Build(
+      const Storage::AudioTrackDecoder &decoder,
+      const std::vector<std::size_t> &bucketFrameCounts = { 256, 4096, 65536 }
+    );
+
+    /// <summary>Builds the pyramid for a whole track on the installed executor</summary>
+    /// <param name="decoder">Decoder of the track that will be scanned</param>
+    /// <param name="bucketFrameCounts">Number of frames per bucket in each level</param>
+    /// <returns>A future that provides the complete pyramid for the track</returns>
+    /// <remarks>
+    ///   This is meant as the refinement pass after <see cref="Skim" />. The track is
+    ///   decoded by a clone of the decoder, so the caller can keep using the decoder,
+    ///   and runs with <see cref="TaskPriority::Low" /> so it doesn't hold up playback.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::future<PeakPyramid> BuildAsync(
+      const Storage::AudioTrackDecoder &decoder,
+      const std::vector<std::size_t> &bucketFrameCounts = { 256, 4096, 65536 }
+    );
+
+    /// <summary>Quickly builds an approximate pyramid from a sample of the track</summary>
+    /// <param name="decoder">Decoder of the track that will be skimmed</param>
+    /// <param name="blockStride">
+    ///   Decode one native block out of this many, must be at least 1
+    /// </param>
+    /// <param name="bucketFrameCounts">Number of frames per bucket in each level</param>
+    /// <returns>An approximate pyramid covering the whole track</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The track is split into groups of <paramref name="blockStride" /> native blocks
+    ///     (as reported by the decoder's block API) and only the first block of each group
+    ///     is decoded. Its levels stand in for all buckets of the group. Seeking to the
+    ///     groups makes use of the decoder's seek index, and the groups are decoded
+    ///     by clones of the decoder in parallel on the installed executor.
+    ///   </para>
+    ///   <para>
+    ///     Short transients in skipped blocks are missed, so the pyramid is good for
+    ///     thumbnails but not for finding peaks. It reports itself as approximate via
+    ///     <see cref="IsApproximate" /> until replaced by an exact one.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static PeakPyramid Skim(
+      const Storage::AudioTrackDecoder &decoder,
+      std::size_t blockStride = 16,
+      const std::vector<std::size_t> &bucketFrameCounts = { 256, 4096, 65536 }
+    );
+
+    /// <summary>Restores a pyramid previously serialized via <see cref="Serialize" /></summary>
+    /// <param name="serializedPyramid">Pyramid returned by <see cref="Serialize" /></param>
+    /// <returns>The restored pyramid</returns>
+    public: NUCLEX_AUDIO_API static PeakPyramid Deserialize(
+      const std::vector<std::byte> &serializedPyramid
+    );
+
+    /// <summary>Initializes a new, empty pyramid that can be fed samples</summary>
+    /// <param name="channelCount">Number of channels in the audio</param>
+    /// <param name="bucketFrameCounts">
+    ///   Number of frames per bucket in each level, from the finest to the coarsest
+    /// </param>
+    public: NUCLEX_AUDIO_API PeakPyramid(
+      std::size_t channelCount,
+      const std::vector<std::size_t> &bucketFrameCounts = { 256, 4096, 65536 }
+    );
+
+    /// <summary>Counts the number of channels the pyramid covers</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Counts the number of frames the pyramid covers</summary>
+    /// <returns>The number of frames that have been processed</returns>
+    public: std::uint64_t CountFrames() const { return this->frameCount; }
+
+    /// <summary>Whether the pyramid was estimated from only a part of the track</summary>
+    /// <returns>True if the pyramid was created via <see cref="Skim" /></returns>
+    /// <remarks>
+    ///   The flag is not serialized. Approximate pyramids are meant to be replaced by
+    ///   an exact one rather than cached.
+    /// </remarks>
+    public: bool IsApproximate() const { return this->approximate; }
+
+    /// <summary>Counts the number of resolutions in the pyramid</summary>
+    /// <returns>The number of levels, the finest one being at index 0</returns>
+    public: std::size_t CountLevels() const { return this->bucketFrameCounts.size(); }
+
+    /// <summary>Retrieves the number of frames summarized by each bucket of a level</summary>
+    /// <param name="levelIndex">Level whose bucket size will be returned</param>
+    /// <returns>The number of frames per bucket</returns>
+    public: std::size_t GetBucketFrameCount(std::size_t levelIndex) const {
+      return this->bucketFrameCounts[levelIndex];
+    }
+
+    /// <summary>Counts the number of buckets in a level</summary>
+    /// <param name="levelIndex">Level whose buckets will be counted</param>
+    /// <returns>The number of buckets, the last one of which may be partial</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountBuckets(std::size_t levelIndex) const;
+
+    /// <summary>Picks the coarsest level that still resolves the requested detail</summary>
+    /// <param name="framesPerPixel">Number of frames that are drawn in a single pixel</param>
+    /// <returns>The index of the level best suited for drawing</returns>
+    public: NUCLEX_AUDIO_API std::size_t SelectLevel(std::size_t framesPerPixel) const;
+
+    /// <summary>Looks up a bucket in one of the levels</summary>
+    /// <param name="levelIndex">Level from which the bucket will be taken</param>
+    /// <param name="channelIndex">Channel whose levels will be returned</param>
+    /// <param name="bucketIndex">Index of the bucket within the level</param>
+    /// <returns>The minimum, maximum and RMS level of the bucket</returns>
+    public: const PeakBucket &GetBucket(
+      std::size_t levelIndex, std::size_t channelIndex, std::size_t bucketIndex
+    ) const {
+      return this->levels[levelIndex * this->channelCount + channelIndex][bucketIndex];
+    }
+
+    /// <summary>Adds the next block of separated samples to the pyramid</summary>
+    /// <param name="channels">One buffer of samples for each channel</param>
+    /// <param name="frameCount">Number of samples in each channel to process</param>
+    public: NUCLEX_AUDIO_API void ProcessSeparated(
+      const float *const channels[], std::size_t frameCount
+    );
+
+    /// <summary>Completes the last bucket and builds the coarser levels</summary>
+    /// <remarks>
+    ///   Needs to be called once after the last samples have been processed.
+    ///   No more samples can be processed afterwards.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Finish();
+
+    /// <summary>Stores the pyramid in a compact form that can be saved by the caller</summary>
+    /// <returns>The serialized pyramid</returns>
+    public: NUCLEX_AUDIO_API std::vector<std::byte> Serialize() const;
+
+    /// <summary>Closes the bucket currently being accumulated in the finest level</summary>
+    private: void closeBucket();
+
+    /// <summary>Number of channels the pyramid covers</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames that have been processed</summary>
+    private: std::uint64_t frameCount;
+    /// <summary>Number of frames per bucket in each level</summary>
+    private: std::vector<std::size_t> bucketFrameCounts;
+    /// <summary>Buckets of each level and channel, all channels of a level in a row</summary>
+    private: std::vector<std::vector<PeakBucket>> levels;
+    /// <summary>Minimum, maximum and square sum of each channel in the open bucket</summary>
+    private: std::vector<double> openBucket;
+    /// <summary>Number of frames that have gone into the open bucket so far</summary>
+    private: std::size_t openFrameCount;
+    /// <summary>Whether the pyramid has been completed</summary>
+    private: bool finished;
+    /// <summary>Whether the pyramid was estimated from a sample of the track</summary>
+    private: bool approximate;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_PEAKPYRAMID_H
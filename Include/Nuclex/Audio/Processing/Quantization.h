@@ -28,8 +28,10 @@ limitations under the License.
 #if defined(_MSC_VER)
 #include <intrin.h>
 #elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+#if defined(__i386__) || defined(__x86_64__)
 #include <x86intrin.h>
 #endif
+#endif
 
 // Whether the SSE2 SIMD instructions are supported by the targeted architecture
 #if defined(_MSC_VER)
@@ -46,10 +48,29 @@ limitations under the License.
   #endif
 #endif
 
+
+// Whether the AVX2 and AVX-512 instructions are supported by the targeted architecture.
+// Unlike SSE2, no architecture implies these, so they're only used when the compiler
+// has been told to target them (/arch:AVX2, /arch:AVX512, -mavx2, -mavx512f and such).
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) && defined(__AVX2__)
+  #define NUCLEX_AUDIO_HAVE_AVX2 1
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_AVX2) && defined(__AVX512F__)
+  #define NUCLEX_AUDIO_HAVE_AVX512 1
+#endif
+
 //#undef NUCLEX_AUDIO_HAVE_SSE2
 
-// TODO: ARM support?
-//#include <arm_neon.h>
+// Whether the ARM NEON SIMD instructions are supported by the targeted architecture.
+// Only AArch64 is considered because 32-bit ARM lacks the rounding conversions
+// and double precision lanes these methods rely on.
+#if defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_NEON))
+  #define NUCLEX_AUDIO_HAVE_NEON 1
+#endif
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Nuclex { namespace Audio { namespace Processing {
 
@@ -62,6 +83,11 @@ namespace Nuclex { namespace Audio { namespace Processing {
   ///     When quantizing signals, multiplying them by a factor before converting to
   ///     integers is also pretty common, so this class offers a variant that does that.
   ///   </para>
+  ///   <para>
+  ///     The 8-wide and 16-wide variants use AVX2 and AVX-512 if the compiler targets
+  ///     them. Otherwise, they are split into calls to the next narrower variant. All
+  ///     widths round the same way, so they produce identical results.
+  ///   </para>
   /// </remarks>
   class Quantization {
 
@@ -125,6 +151,54 @@ namespace Nuclex { namespace Audio { namespace Processing {
       const double *values/*[4]*/, double factor, std::int32_t *results/*[4]*/
     );
 
+    /// <summary>Multiplies and rounds 8 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 8 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 8 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x8(
+      const float *values/*[8]*/, float factor, std::int32_t *results/*[8]*/
+    );
+
+    /// <summary>Multiplies and rounds 8 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 8 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 8 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x8(
+      const float *values/*[8]*/, double factor, std::int32_t *results/*[8]*/
+    );
+
+    /// <summary>Multiplies and rounds 8 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 8 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 8 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x8(
+      const double *values/*[8]*/, double factor, std::int32_t *results/*[8]*/
+    );
+
+    /// <summary>Multiplies and rounds 16 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 16 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 16 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x16(
+      const float *values/*[16]*/, float factor, std::int32_t *results/*[16]*/
+    );
+
+    /// <summary>Multiplies and rounds 16 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 16 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 16 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x16(
+      const float *values/*[16]*/, double factor, std::int32_t *results/*[16]*/
+    );
+
+    /// <summary>Multiplies and rounds 16 floating point values to the nearest integers</summary>
+    /// <param name="values">Array of 16 floating point values that will be rounded</param>
+    /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+    /// <param name="results">Receives the 16 integers nearest to the float values</param>
+    public: static inline void MultiplyToNearestInt32x16(
+      const double *values/*[16]*/, double factor, std::int32_t *results/*[16]*/
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -132,8 +206,8 @@ namespace Nuclex { namespace Audio { namespace Processing {
   inline std::int32_t Quantization::NearestInt32(float value) {
 #if defined(NUCLEX_AUDIO_HAVE_SSE2)
     return _mm_cvtss_si32(_mm_set_ss(value));
-//#elif defined(__ARM_NEON)
-//    return vgetq_lane_s32(vcvtq_s32_f32(vdupq_n_f32(value)), 0);
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    return vgetq_lane_s32(vcvtnq_s32_f32(vdupq_n_f32(value)), 0);
 #else
     return static_cast<std::int32_t>(value + std::copysign(0.5f, value));
 #endif
@@ -144,8 +218,8 @@ namespace Nuclex { namespace Audio { namespace Processing {
   inline std::int32_t Quantization::NearestInt32(double value) {
 #if defined(NUCLEX_AUDIO_HAVE_SSE2)
     return _mm_cvtsd_si32(_mm_set_sd(value));
-//#elif defined(__ARM_NEON)
-//    return vgetq_lane_s32(vcvtq_s32_f64(vdupq_n_f64(value)), 0);
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    return static_cast<std::int32_t>(vcvtnd_s64_f64(value));
 #else
     return static_cast<std::int32_t>(value + std::copysign(0.5, value));
 #endif
@@ -161,10 +235,8 @@ namespace Nuclex { namespace Audio { namespace Processing {
       reinterpret_cast<__m128i *>(results),
       _mm_cvtps_epi32(_mm_loadu_ps(values))
     );
-//#elif defined(__ARM_NEON)
-//    float32x4_t v = vld1q_f32(values);
-//    int32x4_t r = vcvtq_s32_f32(v);
-//    vst1q_s32(results, r);
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    vst1q_s32(results, vcvtnq_s32_f32(vld1q_f32(values)));
 #else
     results[0] = static_cast<std::int32_t>(values[0] + std::copysign(0.5f, values[0]));
     results[1] = static_cast<std::int32_t>(values[1] + std::copysign(0.5f, values[1]));
@@ -186,11 +258,14 @@ namespace Nuclex { namespace Audio { namespace Processing {
         _mm_cvtpd_epi32(_mm_loadu_pd(values + 2))
       )
     );
-//#elif defined(__ARM_NEON)
-//    float64x2_t v_low = vld1q_f64(&values[0]);
-//    float64x2_t v_high = vld1q_f64(&values[2]);
-//    int32x4_t r = vcombine_s32(vcvtq_s32_f64(v_low), vcvtq_s32_f64(v_high));
-//    vst1q_s32(results, r);
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    vst1q_s32(
+      results,
+      vcombine_s32(
+        vqmovn_s64(vcvtnq_s64_f64(vld1q_f64(values))),
+        vqmovn_s64(vcvtnq_s64_f64(vld1q_f64(values + 2)))
+      )
+    );
 #else
     results[0] = static_cast<std::int32_t>(values[0] + std::copysign(0.5, values[0]));
     results[1] = static_cast<std::int32_t>(values[1] + std::copysign(0.5, values[1]));
@@ -214,7 +289,8 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    vst1q_s32(results, vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(values), factor)));
 #else
     //assert(factor >= 0.0f);
     results[0] = static_cast<std::int32_t>(values[0] * factor + std::copysign(0.5f, values[0]));
@@ -250,7 +326,19 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    float32x4_t valuesVector = vld1q_f32(values);
+    float64x2_t lowerValues = vcvt_f64_f32(vget_low_f32(valuesVector));
+    float64x2_t upperValues = vcvt_high_f64_f32(valuesVector);
+    float64x2_t factorVector = vdupq_n_f64(factor);
+
+    vst1q_s32(
+      results,
+      vcombine_s32(
+        vqmovn_s64(vcvtnq_s64_f64(vmulq_f64(lowerValues, factorVector))),
+        vqmovn_s64(vcvtnq_s64_f64(vmulq_f64(upperValues, factorVector)))
+      )
+    );
 #else
     //assert(factor >= 0.0f);
     results[0] = static_cast<std::int32_t>(
@@ -293,7 +381,16 @@ namespace Nuclex { namespace Audio { namespace Processing {
         )
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    float64x2_t factorVector = vdupq_n_f64(factor);
+
+    vst1q_s32(
+      results,
+      vcombine_s32(
+        vqmovn_s64(vcvtnq_s64_f64(vmulq_f64(vld1q_f64(values), factorVector))),
+        vqmovn_s64(vcvtnq_s64_f64(vmulq_f64(vld1q_f64(values + 2), factorVector)))
+      )
+    );
 #else
     //assert(factor >= 0.0f);
     results[0] = static_cast<std::int32_t>(values[0] * factor + std::copysign(0.5, values[0]));
@@ -305,6 +402,138 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline void Quantization::MultiplyToNearestInt32x8(
+    const float *values/*[8]*/, float factor, std::int32_t *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(results),
+      _mm256_cvtps_epi32(
+        _mm256_mul_ps(
+          _mm256_loadu_ps(values),
+          _mm256_set1_ps(factor)
+        )
+      )
+    );
+#else
+    MultiplyToNearestInt32x4(values, factor, results);
+    MultiplyToNearestInt32x4(values + 4, factor, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Quantization::MultiplyToNearestInt32x8(
+    const float *values/*[8]*/, double factor, std::int32_t *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m256d factorVector = _mm256_set1_pd(factor);
+
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(results),
+      _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(values)), factorVector))
+    );
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(results + 4),
+      _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(values + 4)), factorVector))
+    );
+#else
+    MultiplyToNearestInt32x4(values, factor, results);
+    MultiplyToNearestInt32x4(values + 4, factor, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Quantization::MultiplyToNearestInt32x8(
+    const double *values/*[8]*/, double factor, std::int32_t *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m256d factorVector = _mm256_set1_pd(factor);
+
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(results),
+      _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(values), factorVector))
+    );
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(results + 4),
+      _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(values + 4), factorVector))
+    );
+#else
+    MultiplyToNearestInt32x4(values, factor, results);
+    MultiplyToNearestInt32x4(values + 4, factor, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Quantization::MultiplyToNearestInt32x16(
+    const float *values/*[16]*/, float factor, std::int32_t *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    _mm512_storeu_si512(
+      results,
+      _mm512_cvtps_epi32(
+        _mm512_mul_ps(
+          _mm512_loadu_ps(values),
+          _mm512_set1_ps(factor)
+        )
+      )
+    );
+#else
+    MultiplyToNearestInt32x8(values, factor, results);
+    MultiplyToNearestInt32x8(values + 8, factor, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Quantization::MultiplyToNearestInt32x16(
+    const float *values/*[16]*/, double factor, std::int32_t *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m512d factorVector = _mm512_set1_pd(factor);
+
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(results),
+      _mm512_cvtpd_epi32(_mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(values)), factorVector))
+    );
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(results + 8),
+      _mm512_cvtpd_epi32(
+        _mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(values + 8)), factorVector)
+      )
+    );
+#else
+    MultiplyToNearestInt32x8(values, factor, results);
+    MultiplyToNearestInt32x8(values + 8, factor, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Quantization::MultiplyToNearestInt32x16(
+    const double *values/*[16]*/, double factor, std::int32_t *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m512d factorVector = _mm512_set1_pd(factor);
+
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(results),
+      _mm512_cvtpd_epi32(_mm512_mul_pd(_mm512_loadu_pd(values), factorVector))
+    );
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(results + 8),
+      _mm512_cvtpd_epi32(_mm512_mul_pd(_mm512_loadu_pd(values + 8), factorVector))
+    );
+#else
+    MultiplyToNearestInt32x8(values, factor, results);
+    MultiplyToNearestInt32x8(values + 8, factor, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
 
 #endif // NUCLEX_AUDIO_PROCESSING_QUANTIZATION_H
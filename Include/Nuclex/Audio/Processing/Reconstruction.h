@@ -28,8 +28,10 @@ limitations under the License.
 #if defined(_MSC_VER)
 #include <intrin.h>
 #elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+#if defined(__i386__) || defined(__x86_64__)
 #include <x86intrin.h>
 #endif
+#endif
 
 // Whether the SSE2 SIMD instructions are supported by the targeted architecture
 #if defined(_MSC_VER)
@@ -46,10 +48,29 @@ limitations under the License.
   #endif
 #endif
 
+
+// Whether the AVX2 and AVX-512 instructions are supported by the targeted architecture.
+// Unlike SSE2, no architecture implies these, so they're only used when the compiler
+// has been told to target them (/arch:AVX2, /arch:AVX512, -mavx2, -mavx512f and such).
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) && defined(__AVX2__)
+  #define NUCLEX_AUDIO_HAVE_AVX2 1
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_AVX2) && defined(__AVX512F__)
+  #define NUCLEX_AUDIO_HAVE_AVX512 1
+#endif
+
 //#undef NUCLEX_AUDIO_HAVE_SSE2
 
-// TODO: ARM support?
-//#include <arm_neon.h>
+// Whether the ARM NEON SIMD instructions are supported by the targeted architecture.
+// Only AArch64 is considered because 32-bit ARM lacks the rounding conversions
+// and double precision lanes these methods rely on.
+#if defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_NEON))
+  #define NUCLEX_AUDIO_HAVE_NEON 1
+#endif
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Nuclex { namespace Audio { namespace Processing {
 
@@ -64,6 +85,11 @@ namespace Nuclex { namespace Audio { namespace Processing {
   ///     a variant that does that.
   ///   </para>
   ///   <para>
+  ///     The 8-wide and 16-wide variants use AVX2 and AVX-512 if the compiler targets
+  ///     them. Otherwise, they are split into calls to the next narrower variant. All
+  ///     widths round the same way, so they produce identical results.
+  ///   </para>
+  ///   <para>
   ///     The term &quot;reconstruction&quot; isn't a perfect match for what this class
   ///     does, but there seems to be no well-established term for "de-quantization" or
   ///     undoing quantization, so we'll go with it.
@@ -138,6 +164,108 @@ namespace Nuclex { namespace Audio { namespace Processing {
       const std::int32_t *values/*[4]*/, int shift, double quotient, double *results/*[4]*/
     );
 
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, float quotient, float *results/*[8]*/
+    );
+
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, double quotient, float *results/*[8]*/
+    );
+
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, double quotient, double *results/*[8]*/
+    );
+
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, int shift, float quotient, float *results/*[8]*/
+    );
+
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, int shift, double quotient, float *results/*[8]*/
+    );
+
+    /// <summary>Converts 8 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 8 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx8(
+      const std::int32_t *values/*[8]*/, int shift, double quotient, double *results/*[8]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, float quotient, float *results/*[16]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, double quotient, float *results/*[16]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void DivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, double quotient, double *results/*[16]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, int shift, float quotient, float *results/*[16]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, int shift, double quotient, float *results/*[16]*/
+    );
+
+    /// <summary>Converts 16 integers into normalized floats by dividing them</summary>
+    /// <param name="values">Array of 16 integer values that will be normalized</param>
+    /// <param name="shift">Number of bits by which the integers will be shifted</param>
+    /// <param name="quotient">Quotient by which the float values will be divided</param>
+    /// <param name="results">Array that will receive the normalized float values</param>
+    public: static inline void ShiftAndDivideInt32ToFloatx16(
+      const std::int32_t *values/*[16]*/, int shift, double quotient, double *results/*[16]*/
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -149,7 +277,6 @@ namespace Nuclex { namespace Audio { namespace Processing {
     return _mm_cvtss_f32(
       _mm_div_ps(_mm_set_ss(static_cast<float>(value)), _mm_set_ss(quotient))
     );
-//#elif defined(__ARM_NEON)
 #else
     return static_cast<float>(value) / quotient;
 #endif
@@ -162,11 +289,10 @@ namespace Nuclex { namespace Audio { namespace Processing {
   ) {
 #if defined(NUCLEX_AUDIO_HAVE_SSE2)
     return _mm_cvtsd_f64(
-      _mm_div_pd(_mm_set_sd(static_cast<float>(value)), _mm_set_sd(quotient))
+      _mm_div_pd(_mm_set_sd(static_cast<double>(value)), _mm_set_sd(quotient))
     );
-//#elif defined(__ARM_NEON)
 #else
-    return static_cast<float>(value) / quotient;
+    return static_cast<double>(value) / quotient;
 #endif
   }
 
@@ -185,7 +311,8 @@ namespace Nuclex { namespace Audio { namespace Processing {
         _mm_set1_ps(quotient)
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    vst1q_f32(results, vdivq_f32(vcvtq_f32_s32(vld1q_s32(values)), vdupq_n_f32(quotient)));
 #else
     results[0] = static_cast<float>(values[0]) / quotient;
     results[1] = static_cast<float>(values[1]) / quotient;
@@ -221,7 +348,19 @@ namespace Nuclex { namespace Audio { namespace Processing {
         resultVector
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t valuesVector = vld1q_s32(values);
+    float64x2_t lowerValues = vcvtq_f64_s64(vmovl_s32(vget_low_s32(valuesVector)));
+    float64x2_t upperValues = vcvtq_f64_s64(vmovl_high_s32(valuesVector));
+    float64x2_t quotientVector = vdupq_n_f64(quotient);
+
+    vst1q_f32(
+      results,
+      vcvt_high_f32_f64(
+        vcvt_f32_f64(vdivq_f64(lowerValues, quotientVector)),
+        vdivq_f64(upperValues, quotientVector)
+      )
+    );
 #else
     //assert(quotient >= 0.0f);
     results[0] = static_cast<float>(static_cast<double>(values[0]) / quotient);
@@ -254,7 +393,16 @@ namespace Nuclex { namespace Audio { namespace Processing {
         quotientVector
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t valuesVector = vld1q_s32(values);
+    float64x2_t quotientVector = vdupq_n_f64(quotient);
+
+    vst1q_f64(
+      results, vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(valuesVector))), quotientVector)
+    );
+    vst1q_f64(
+      results + 2, vdivq_f64(vcvtq_f64_s64(vmovl_high_s32(valuesVector)), quotientVector)
+    );
 #else
     //assert(quotient >= 0.0f);
     results[0] = static_cast<double>(values[0]) / quotient;
@@ -282,7 +430,10 @@ namespace Nuclex { namespace Audio { namespace Processing {
         _mm_set1_ps(quotient)
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t valuesVector = vshlq_s32(vld1q_s32(values), vdupq_n_s32(-shift));
+
+    vst1q_f32(results, vdivq_f32(vcvtq_f32_s32(valuesVector), vdupq_n_f32(quotient)));
 #else
     results[0] = static_cast<float>(values[0] >> shift) / quotient;
     results[1] = static_cast<float>(values[1] >> shift) / quotient;
@@ -321,7 +472,19 @@ namespace Nuclex { namespace Audio { namespace Processing {
         resultVector
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t valuesVector = vshlq_s32(vld1q_s32(values), vdupq_n_s32(-shift));
+    float64x2_t lowerValues = vcvtq_f64_s64(vmovl_s32(vget_low_s32(valuesVector)));
+    float64x2_t upperValues = vcvtq_f64_s64(vmovl_high_s32(valuesVector));
+    float64x2_t quotientVector = vdupq_n_f64(quotient);
+
+    vst1q_f32(
+      results,
+      vcvt_high_f32_f64(
+        vcvt_f32_f64(vdivq_f64(lowerValues, quotientVector)),
+        vdivq_f64(upperValues, quotientVector)
+      )
+    );
 #else
     results[0] = static_cast<float>(static_cast<double>(values[0] >> shift) / quotient);
     results[1] = static_cast<float>(static_cast<double>(values[1] >> shift) / quotient);
@@ -356,7 +519,16 @@ namespace Nuclex { namespace Audio { namespace Processing {
         quotientVector
       )
     );
-//#elif defined(__ARM_NEON)
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    int32x4_t valuesVector = vshlq_s32(vld1q_s32(values), vdupq_n_s32(-shift));
+    float64x2_t quotientVector = vdupq_n_f64(quotient);
+
+    vst1q_f64(
+      results, vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(valuesVector))), quotientVector)
+    );
+    vst1q_f64(
+      results + 2, vdivq_f64(vcvtq_f64_s64(vmovl_high_s32(valuesVector)), quotientVector)
+    );
 #else
     results[0] = static_cast<double>(values[0] >> shift) / quotient;
     results[1] = static_cast<double>(values[1] >> shift) / quotient;
@@ -367,6 +539,324 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline void Reconstruction::DivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, float quotient, float *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m256i valuesVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+
+    _mm256_storeu_ps(
+      results,
+      _mm256_div_ps(
+        _mm256_cvtepi32_ps(valuesVector),
+        _mm256_set1_ps(quotient)
+      )
+    );
+#else
+    DivideInt32ToFloatx4(values, quotient, results);
+    DivideInt32ToFloatx4(values + 4, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::DivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, double quotient, float *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m128i lowerValues = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i upperValues = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 4));
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+
+    _mm_storeu_ps(
+      results,
+      _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtepi32_pd(lowerValues), quotientVector)
+      )
+    );
+    _mm_storeu_ps(
+      results + 4,
+      _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtepi32_pd(upperValues), quotientVector)
+      )
+    );
+#else
+    DivideInt32ToFloatx4(values, quotient, results);
+    DivideInt32ToFloatx4(values + 4, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::DivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, double quotient, double *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m128i lowerValues = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i upperValues = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 4));
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+
+    _mm256_storeu_pd(
+      results,
+      _mm256_div_pd(_mm256_cvtepi32_pd(lowerValues), quotientVector)
+    );
+    _mm256_storeu_pd(
+      results + 4,
+      _mm256_div_pd(_mm256_cvtepi32_pd(upperValues), quotientVector)
+    );
+#else
+    DivideInt32ToFloatx4(values, quotient, results);
+    DivideInt32ToFloatx4(values + 4, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, int shift, float quotient, float *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m256i valuesVector = _mm256_sra_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)),
+      _mm_cvtsi32_si128(shift)
+    );
+
+    _mm256_storeu_ps(
+      results,
+      _mm256_div_ps(
+        _mm256_cvtepi32_ps(valuesVector),
+        _mm256_set1_ps(quotient)
+      )
+    );
+#else
+    ShiftAndDivideInt32ToFloatx4(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx4(values + 4, shift, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, int shift, double quotient, float *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m128i lowerValues = _mm_sra_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)), shiftCount
+    );
+    __m128i upperValues = _mm_sra_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 4)), shiftCount
+    );
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+
+    _mm_storeu_ps(
+      results,
+      _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtepi32_pd(lowerValues), quotientVector)
+      )
+    );
+    _mm_storeu_ps(
+      results + 4,
+      _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtepi32_pd(upperValues), quotientVector)
+      )
+    );
+#else
+    ShiftAndDivideInt32ToFloatx4(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx4(values + 4, shift, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx8(
+    const std::int32_t *values/*[8]*/, int shift, double quotient, double *results/*[8]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX2)
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m128i lowerValues = _mm_sra_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)), shiftCount
+    );
+    __m128i upperValues = _mm_sra_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 4)), shiftCount
+    );
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+
+    _mm256_storeu_pd(
+      results,
+      _mm256_div_pd(_mm256_cvtepi32_pd(lowerValues), quotientVector)
+    );
+    _mm256_storeu_pd(
+      results + 4,
+      _mm256_div_pd(_mm256_cvtepi32_pd(upperValues), quotientVector)
+    );
+#else
+    ShiftAndDivideInt32ToFloatx4(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx4(values + 4, shift, quotient, results + 4);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::DivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, float quotient, float *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m512i valuesVector = _mm512_loadu_si512(reinterpret_cast<const __m512i *>(values));
+
+    _mm512_storeu_ps(
+      results,
+      _mm512_div_ps(
+        _mm512_cvtepi32_ps(valuesVector),
+        _mm512_set1_ps(quotient)
+      )
+    );
+#else
+    DivideInt32ToFloatx8(values, quotient, results);
+    DivideInt32ToFloatx8(values + 8, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::DivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, double quotient, float *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m256i lowerValues = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i upperValues = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 8));
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+
+    _mm256_storeu_ps(
+      results,
+      _mm512_cvtpd_ps(
+        _mm512_div_pd(_mm512_cvtepi32_pd(lowerValues), quotientVector)
+      )
+    );
+    _mm256_storeu_ps(
+      results + 8,
+      _mm512_cvtpd_ps(
+        _mm512_div_pd(_mm512_cvtepi32_pd(upperValues), quotientVector)
+      )
+    );
+#else
+    DivideInt32ToFloatx8(values, quotient, results);
+    DivideInt32ToFloatx8(values + 8, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::DivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, double quotient, double *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m256i lowerValues = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i upperValues = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 8));
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+
+    _mm512_storeu_pd(
+      results,
+      _mm512_div_pd(_mm512_cvtepi32_pd(lowerValues), quotientVector)
+    );
+    _mm512_storeu_pd(
+      results + 8,
+      _mm512_div_pd(_mm512_cvtepi32_pd(upperValues), quotientVector)
+    );
+#else
+    DivideInt32ToFloatx8(values, quotient, results);
+    DivideInt32ToFloatx8(values + 8, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, int shift, float quotient, float *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m512i valuesVector = _mm512_sra_epi32(
+      _mm512_loadu_si512(reinterpret_cast<const __m512i *>(values)),
+      _mm_cvtsi32_si128(shift)
+    );
+
+    _mm512_storeu_ps(
+      results,
+      _mm512_div_ps(
+        _mm512_cvtepi32_ps(valuesVector),
+        _mm512_set1_ps(quotient)
+      )
+    );
+#else
+    ShiftAndDivideInt32ToFloatx8(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx8(values + 8, shift, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, int shift, double quotient, float *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m256i lowerValues = _mm256_sra_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), shiftCount
+    );
+    __m256i upperValues = _mm256_sra_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 8)), shiftCount
+    );
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+
+    _mm256_storeu_ps(
+      results,
+      _mm512_cvtpd_ps(
+        _mm512_div_pd(_mm512_cvtepi32_pd(lowerValues), quotientVector)
+      )
+    );
+    _mm256_storeu_ps(
+      results + 8,
+      _mm512_cvtpd_ps(
+        _mm512_div_pd(_mm512_cvtepi32_pd(upperValues), quotientVector)
+      )
+    );
+#else
+    ShiftAndDivideInt32ToFloatx8(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx8(values + 8, shift, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline void Reconstruction::ShiftAndDivideInt32ToFloatx16(
+    const std::int32_t *values/*[16]*/, int shift, double quotient, double *results/*[16]*/
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m256i lowerValues = _mm256_sra_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), shiftCount
+    );
+    __m256i upperValues = _mm256_sra_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 8)), shiftCount
+    );
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+
+    _mm512_storeu_pd(
+      results,
+      _mm512_div_pd(_mm512_cvtepi32_pd(lowerValues), quotientVector)
+    );
+    _mm512_storeu_pd(
+      results + 8,
+      _mm512_div_pd(_mm512_cvtepi32_pd(upperValues), quotientVector)
+    );
+#else
+    ShiftAndDivideInt32ToFloatx8(values, shift, quotient, results);
+    ShiftAndDivideInt32ToFloatx8(values + 8, shift, quotient, results + 8);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
 
 #endif // NUCLEX_AUDIO_PROCESSING_RECONSTRUCTION_H
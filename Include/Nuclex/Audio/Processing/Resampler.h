@@ -0,0 +1,164 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_RESAMPLER_H
+#define NUCLEX_AUDIO_PROCESSING_RESAMPLER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class PolyphaseFilter;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How much work the resampler puts into suppressing aliasing</summary>
+  enum class ResamplerQuality {
+
+    /// <summary>Short filter with about 60 dB of attenuation, for many voices at once</summary>
+    Fast = 0,
+
+    /// <summary>Filter with over 90 dB of attenuation, used by the decoder wrapper</summary>
+    Balanced = 1,
+
+    /// <summary>Long filter with over 110 dB of attenuation for mastering and export</summary>
+    Best = 2
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts streamed audio between sample rates</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This is the same polyphase windowed-sinc resampler that
+  ///     <see cref="Storage::AudioTrackDecoder::CreateResampler" /> uses, but fed by
+  ///     the caller rather than by a decoder. Each call takes any number of input frames
+  ///     and produces as many output frames as the input allows. The samples that
+  ///     the filter still needs for upcoming output frames are kept between calls.
+  ///   </para>
+  ///   <para>
+  ///     Filter banks are shared by all resamplers using the same ratio and quality,
+  ///     so once a bank exists, constructing another resampler only allocates its small
+  ///     history buffers. To reuse a resampler for a different voice, call
+  ///     <see cref="Reset" /> instead of constructing a new one.
+  ///   </para>
+  ///   <para>
+  ///     Output frames are aligned with the input, but each one can only be produced once
+  ///     the filter has seen the input frames following it (<see cref="CountLookaheadFrames" />).
+  ///     Feed that many frames of silence at the end of a stream to get all of it out.
+  ///     Channels are processed in separated form with the same timing for all of them.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Resampler {
+
+    /// <summary>Initializes a new resampler for the specified sample rates</summary>
+    /// <param name="inputSampleRate">Sample rate of the audio that will be fed in</param>
+    /// <param name="outputSampleRate">Sample rate at which audio will be produced</param>
+    /// <param name="channelCount">Number of channels that will be resampled</param>
+    /// <param name="quality">Quality preset that decides the filter's length</param>
+    /// <remarks>
+    ///   The ratio between both sample rates is reduced to its smallest terms, which
+    ///   may have a numerator of at most 1024. Any ratio between common sample rates
+    ///   (such as 44100 to 48000, which is 160/147) fits easily.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API Resampler(
+      std::size_t inputSampleRate, std::size_t outputSampleRate,
+      std::size_t channelCount = 1,
+      ResamplerQuality quality = ResamplerQuality::Balanced
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~Resampler();
+
+    /// <summary>Counts the number of channels the resampler processes</summary>
+    /// <returns>The number of channels processed by each call</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Tells how many input frames the filter reaches past an output frame</summary>
+    /// <returns>The number of input frames needed after an output frame's position</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountLookaheadFrames() const;
+
+    /// <summary>Calculates how many output frames a call can produce at most</summary>
+    /// <param name="inputFrameCount">Number of input frames that will be fed in</param>
+    /// <returns>The largest number of output frames the call can produce</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountMaximumOutputFrames(
+      std::size_t inputFrameCount
+    ) const;
+
+    /// <summary>Forgets the history so the resampler can begin a new stream</summary>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Resamples the next input frames of the stream</summary>
+    /// <param name="inputs">Buffers holding the input samples of each channel</param>
+    /// <param name="inputFrameCount">Number of frames in each input buffer</param>
+    /// <param name="outputs">Buffers that will receive the resampled channels</param>
+    /// <returns>The number of frames that have been written to each output buffer</returns>
+    /// <remarks>
+    ///   All input frames are consumed. The output buffers need to be large enough
+    ///   for <see cref="CountMaximumOutputFrames" /> frames.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Process(
+      const float *const inputs[], std::size_t inputFrameCount, float *const outputs[]
+    );
+
+    /// <summary>Filters the history buffers into the output buffers</summary>
+    /// <param name="outputs">Buffers that will receive the resampled channels</param>
+    /// <param name="outputOffset">Index of the first frame written to the outputs</param>
+    /// <returns>The number of frames that have been written to each output buffer</returns>
+    private: std::size_t filterHistory(float *const outputs[], std::size_t outputOffset);
+
+    /// <summary>Filter bank that is shared with other resamplers</summary>
+    private: std::shared_ptr<const Storage::Shared::PolyphaseFilter> filter;
+    /// <summary>Number of channels that are being resampled</summary>
+    private: std::size_t channelCount;
+    /// <summary>Factor by which the sample rate is raised (L)</summary>
+    private: std::size_t upFactor;
+    /// <summary>Factor by which the raised sample rate is lowered (M)</summary>
+    private: std::size_t downFactor;
+    /// <summary>Samples of each channel the filter is running over</summary>
+    private: std::vector<float> history;
+    /// <summary>Number of samples that can be held in each channel's history</summary>
+    private: std::size_t historyCapacity;
+    /// <summary>Number of samples currently held in each channel's history</summary>
+    private: std::size_t historyLength;
+    /// <summary>Index in the history where the next output frame's first tap applies</summary>
+    private: std::size_t cursor;
+    /// <summary>Fractional position of the next output frame, in 1/L units</summary>
+    private: std::size_t phase;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_RESAMPLER_H
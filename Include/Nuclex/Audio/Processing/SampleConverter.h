@@ -24,7 +24,11 @@ limitations under the License.
 
 #include "Nuclex/Audio/Processing/Quantization.h"
 #include "Nuclex/Audio/Processing/Reconstruction.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Processing/Ditherer.h"
+#include "Nuclex/Audio/Processing/BitExtension.h"
 
+#include <algorithm> // for std::min()
 #include <cstddef> // for std::size_t
 #include <stdexcept> // for std::runtime_error
 #include <type_traits> // for std::is_same<>
@@ -69,6 +73,13 @@ namespace Nuclex { namespace Audio { namespace Processing {
   ///     For float-to-float or integer-to-integer conversions between different sizes,
   ///     the operations are called truncate and extend and do exactly what they sound like.
   ///   </para>
+  ///   <para>
+  ///     Conversions can also happen in place, as long as the target type is not larger
+  ///     than the source type (i.e. int32 to float, double to int16 or int32 to int16).
+  ///     Use <see cref="ConvertInPlace" /> for those, it takes care of the aliasing and
+  ///     returns a pointer to the converted samples, which occupy the start of the buffer.
+  ///     The other methods expect the source and target buffers not to overlap.
+  ///   </para>
   /// </remarks>
   class NUCLEX_AUDIO_TYPE SampleConverter {
 
@@ -87,6 +98,48 @@ namespace Nuclex { namespace Audio { namespace Processing {
       std::size_t sampleCount
     );
 
+    /// <summary>Converts samples with bit counts that are known at compile time</summary>
+    /// <typeparam name="SourceBitCount">Number of valid bits in the source samples</typeparam>
+    /// <typeparam name="TargetBitCount">Number of valid bits in the target samples</typeparam>
+    /// <typeparam name="TSourceSample">Type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <remarks>
+    ///   Produces the same results as the other <see cref="Convert" /> overload, but
+    ///   all limits, masks and shift amounts become constants, so the compiler can drop
+    ///   the branches and unroll the inner loops. Use it like <code>Convert&lt;16, 24&gt;(
+    ///   source, target, sampleCount)</code> when a reader has already picked its formats.
+    /// </remarks>
+    public: template<
+      std::size_t SourceBitCount, std::size_t TargetBitCount,
+      typename TSourceSample, typename TTargetSample
+    >
+    inline static void Convert(
+      const TSourceSample *source, TTargetSample *target, std::size_t sampleCount
+    );
+
+    /// <summary>Converts samples into another format within the same buffer</summary>
+    /// <typeparam name="TSourceSample">Type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Type of the target samples, no larger</typeparam>
+    /// <param name="samples">Buffer holding the samples that will be converted</param>
+    /// <param name="sourceBitCount">Number of valid bits in the source samples</param>
+    /// <param name="targetBitCount">Number of valid bits in the target samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <returns>The converted samples, which begin at the start of the buffer</returns>
+    /// <remarks>
+    ///   This lets decoders that produce 32-bit integers reconstruct them to floats
+    ///   without a second buffer. Same-sized samples are converted directly, narrowing
+    ///   conversions go through a small stack buffer so no sample is overwritten before
+    ///   it has been read.
+    /// </remarks>
+    public: template<typename TTargetSample, typename TSourceSample>
+    inline static TTargetSample *ConvertInPlace(
+      TSourceSample *samples, std::size_t sourceBitCount, std::size_t targetBitCount,
+      std::size_t sampleCount
+    );
+
     /// <summary>Converts floating point samples into quantized integer samples</summary>
     /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
     /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
@@ -115,6 +168,173 @@ namespace Nuclex { namespace Audio { namespace Processing {
       std::size_t sampleCount
     );
 
+    /// <summary>Quantizes floating point samples while applying a constant gain</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="targetBitCount">Number of valid bits in the target samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="gain">Factor by which the samples will be scaled</param>
+    /// <remarks>
+    ///   The gain is folded into the scale factor of the quantization, so it costs nothing.
+    ///   Samples are not clamped, a gain above 1.0 can therefore overflow the target range.
+    /// </remarks>
+    public: template<typename TFloatSourceSample, typename TTargetSample>
+    inline static void Quantize(
+      const TFloatSourceSample *source,
+      TTargetSample *target, std::size_t targetBitCount,
+      std::size_t sampleCount,
+      float gain
+    );
+
+    /// <summary>Number of samples converted at once by the conversion kernels</summary>
+    /// <remarks>
+    ///   Samples that need to be offset, shifted or narrowed after quantization (or widened
+    ///   before reconstruction) go through a stack buffer of this many samples.
+    /// </remarks>
+    private: static constexpr std::size_t KernelChunkSampleCount = 256;
+
+    /// <summary>Quantizes floating point samples through the conversion kernels</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <typeparam name="TLimit">Type in which the quantization is calculated</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="limit">Integer value that corresponds to full scale, including gain</param>
+    /// <param name="offset">Value added to the quantized samples (for unsigned types)</param>
+    /// <param name="shift">Number of bits by which quantized samples are shifted left</param>
+    private: template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+    inline static void quantizeViaKernels(
+      const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+      TLimit limit, std::int32_t offset, std::size_t shift
+    );
+
+    /// <summary>Quantizes floating point samples with dither through a ditherer</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <typeparam name="TLimit">Type in which the quantization is calculated</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="factor">Factor by which samples are scaled, including gain</param>
+    /// <param name="limit">Largest magnitude quantized samples will be clamped to</param>
+    /// <param name="offset">Value added to the quantized samples (for unsigned types)</param>
+    /// <param name="shift">Number of bits by which quantized samples are shifted left</param>
+    /// <param name="ditherer">Ditherer that provides the noise</param>
+    private: template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+    inline static void quantizeDitheredViaKernels(
+      const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+      TLimit factor, TLimit limit, std::int32_t offset, std::size_t shift,
+      Ditherer &ditherer
+    );
+
+    /// <summary>Reconstructs floating point samples through the conversion kernels</summary>
+    /// <typeparam name="TSourceSample">Signed integer type of the source samples</typeparam>
+    /// <typeparam name="TFloatTargetSample">Floating point type of the target samples</typeparam>
+    /// <typeparam name="TLimit">Type in which the reconstruction is calculated</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="limit">Integer value that corresponds to full scale, including gain</param>
+    /// <param name="shift">Number of bits by which samples are shifted right</param>
+    private: template<typename TSourceSample, typename TFloatTargetSample, typename TLimit>
+    inline static void reconstructViaKernels(
+      const TSourceSample *source, TFloatTargetSample *target, std::size_t sampleCount,
+      TLimit limit, std::size_t shift
+    );
+
+    /// <summary>Quantizes floating point samples while applying a linear gain ramp</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="targetBitCount">Number of valid bits in the target samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="startGain">Factor by which the first sample will be scaled</param>
+    /// <param name="endGain">
+    ///   Factor by which the sample after the last one would be scaled. Passing this as
+    ///   the start gain of the next call continues the ramp without a step.
+    /// </param>
+    /// <remarks>
+    ///   The gain advances with every sample. For interleaved channels, this means
+    ///   the channels of one frame differ by a tiny fraction of the ramp, far below
+    ///   anything that can be heard.
+    /// </remarks>
+    public: template<typename TFloatSourceSample, typename TTargetSample>
+    inline static void Quantize(
+      const TFloatSourceSample *source,
+      TTargetSample *target, std::size_t targetBitCount,
+      std::size_t sampleCount,
+      float startGain, float endGain
+    );
+
+    /// <summary>Quantizes floating point samples with dither and optional noise shaping</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="targetBitCount">Number of valid bits in the target samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="ditherer">
+    ///   Ditherer that provides the noise and keeps the noise shaping state. Samples are
+    ///   expected to be interleaved in the channel count the ditherer was created with.
+    /// </param>
+    /// <param name="gain">Factor by which the samples will be scaled</param>
+    /// <remarks>
+    ///   The dither is applied at the target's least significant valid bit, so for 12-bit
+    ///   audio in 16-bit integers, the noise is 16 times as large as for 16-bit audio.
+    ///   Unlike plain quantization, samples are clamped to the target range.
+    /// </remarks>
+    public: template<typename TFloatSourceSample, typename TTargetSample>
+    inline static void QuantizeDithered(
+      const TFloatSourceSample *source,
+      TTargetSample *target, std::size_t targetBitCount,
+      std::size_t sampleCount,
+      Ditherer &ditherer,
+      float gain = 1.0f
+    );
+
+    /// <summary>Reconstructs floating point samples while applying a constant gain</summary>
+    /// <typeparam name="TSourceSample">Integer type of the source samples</typeparam>
+    /// <typeparam name="TFloatTargetSample">Floating point type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="sourceBitCount">Number of valid bits in the source samples</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="gain">Factor by which the samples will be scaled</param>
+    /// <remarks>
+    ///   The gain is folded into the divisor of the reconstruction, so it costs nothing.
+    /// </remarks>
+    public: template<typename TSourceSample, typename TFloatTargetSample>
+    inline static void Reconstruct(
+      const TSourceSample *source, std::size_t sourceBitCount,
+      TFloatTargetSample *target,
+      std::size_t sampleCount,
+      float gain
+    );
+
+    /// <summary>Reconstructs floating point samples while applying a linear gain ramp</summary>
+    /// <typeparam name="TSourceSample">Integer type of the source samples</typeparam>
+    /// <typeparam name="TFloatTargetSample">Floating point type of the target samples</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="sourceBitCount">Number of valid bits in the source samples</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="startGain">Factor by which the first sample will be scaled</param>
+    /// <param name="endGain">
+    ///   Factor by which the sample after the last one would be scaled. Passing this as
+    ///   the start gain of the next call continues the ramp without a step.
+    /// </param>
+    public: template<typename TSourceSample, typename TFloatTargetSample>
+    inline static void Reconstruct(
+      const TSourceSample *source, std::size_t sourceBitCount,
+      TFloatTargetSample *target,
+      std::size_t sampleCount,
+      float startGain, float endGain
+    );
+
     /// <summary>Truncates samples to fewer bits</summary>
     /// <typeparam name="TSourceSample">Type of the source samples</typeparam>
     /// <typeparam name="TTargetSample">Type of the target samples</typeparam>
@@ -145,6 +365,44 @@ namespace Nuclex { namespace Audio { namespace Processing {
       std::size_t sampleCount
     );
 
+    /// <summary>Quantizes floating point samples while applying a linear gain ramp</summary>
+    /// <typeparam name="TFloatSourceSample">Floating point type of the source samples</typeparam>
+    /// <typeparam name="TTargetSample">Integer type of the target samples</typeparam>
+    /// <typeparam name="TLimit">Type in which the quantization is calculated</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="limit">Integer value that corresponds to full scale</param>
+    /// <param name="offset">Value added to the quantized samples (for unsigned types)</param>
+    /// <param name="shift">Number of bits by which quantized samples are shifted left</param>
+    /// <param name="startGain">Factor by which the first sample will be scaled</param>
+    /// <param name="endGain">Factor by which the sample after the last would be scaled</param>
+    private: template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+    inline static void quantizeRamped(
+      const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+      TLimit limit, std::int32_t offset, std::size_t shift,
+      float startGain, float endGain
+    );
+
+    /// <summary>Reconstructs floating point samples while applying a linear gain ramp</summary>
+    /// <typeparam name="TSourceSample">Integer type of the source samples</typeparam>
+    /// <typeparam name="TFloatTargetSample">Floating point type of the target samples</typeparam>
+    /// <typeparam name="TLimit">Type in which the reconstruction is calculated</typeparam>
+    /// <param name="source">Pointer to the first source sample</param>
+    /// <param name="target">Pointer to which the converted samples will be written</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    /// <param name="limit">Integer value that corresponds to full scale</param>
+    /// <param name="offset">Value subtracted from the samples (for unsigned types)</param>
+    /// <param name="shift">Number of bits by which samples are shifted right</param>
+    /// <param name="startGain">Factor by which the first sample will be scaled</param>
+    /// <param name="endGain">Factor by which the sample after the last would be scaled</param>
+    private: template<typename TSourceSample, typename TFloatTargetSample, typename TLimit>
+    inline static void reconstructRamped(
+      const TSourceSample *source, TFloatTargetSample *target, std::size_t sampleCount,
+      TLimit limit, std::int32_t offset, std::size_t shift,
+      float startGain, float endGain
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -178,11 +436,209 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TTargetSample, typename TSourceSample>
+  inline TTargetSample *SampleConverter::ConvertInPlace(
+    TSourceSample *samples, std::size_t sourceBitCount, std::size_t targetBitCount,
+    std::size_t sampleCount
+  ) {
+    static_assert(
+      sizeof(TTargetSample) <= sizeof(TSourceSample),
+      u8"In-place conversion requires the target samples to be no larger than the source"
+    );
+
+    TTargetSample *converted = reinterpret_cast<TTargetSample *>(samples);
+    TTargetSample *target = converted;
+
+    // With samples of equal size, each kernel reads a sample before it writes
+    // the converted sample into the same spot, never touching any other samples
+    if constexpr(sizeof(TTargetSample) == sizeof(TSourceSample)) {
+      Convert(samples, sourceBitCount, target, targetBitCount, sampleCount);
+    } else { // samples of equal size / narrowing conversion
+      TSourceSample chunk[KernelChunkSampleCount];
+      while(0 < sampleCount) {
+        std::size_t chunkSampleCount = std::min(sampleCount, KernelChunkSampleCount);
+        std::copy_n(samples, chunkSampleCount, chunk);
+        Convert(chunk, sourceBitCount, target, targetBitCount, chunkSampleCount);
+
+        samples += chunkSampleCount;
+        target += chunkSampleCount;
+        sampleCount -= chunkSampleCount;
+      }
+    }
+
+    return converted;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<
+    std::size_t SourceBitCount, std::size_t TargetBitCount,
+    typename TSourceSample, typename TTargetSample
+  >
+  inline void SampleConverter::Convert(
+    const TSourceSample *source, TTargetSample *target, std::size_t sampleCount
+  ) {
+    constexpr std::size_t SourceTypeBitCount = sizeof(TSourceSample) * 8;
+    constexpr std::size_t TargetTypeBitCount = sizeof(TTargetSample) * 8;
+    static_assert(
+      (SourceBitCount >= 1) && (SourceBitCount <= SourceTypeBitCount) &&
+      (TargetBitCount >= 1) && (TargetBitCount <= TargetTypeBitCount),
+      u8"Bit counts must be between 1 and the number of bits in the sample type"
+    );
+
+    // From floating point to floating point
+    // -------------------------------------
+    //
+    if constexpr(std::is_floating_point<TSourceSample>::value) {
+      if constexpr(std::is_floating_point<TTargetSample>::value) {
+        static_assert(
+          (SourceBitCount == SourceTypeBitCount) && (TargetBitCount == TargetTypeBitCount),
+          u8"Floating point samples always use all bits of their type"
+        );
+        for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+          target[sampleIndex] = static_cast<TTargetSample>(source[sampleIndex]);
+        }
+
+      // From floating point to integer
+      // ------------------------------
+      //
+      } else if constexpr(std::is_same<TTargetSample, std::uint8_t>::value) {
+        constexpr std::int32_t Midpoint = (1 << TargetBitCount) / 2;
+        constexpr TSourceSample Limit = static_cast<TSourceSample>(
+          (Midpoint - 1) << (8 - TargetBitCount)
+        );
+        quantizeViaKernels(
+          source, target, sampleCount, Limit, Midpoint << (8 - TargetBitCount), 0
+        );
+      } else if constexpr(TargetBitCount < 17) {
+        constexpr TSourceSample Limit = static_cast<TSourceSample>(
+          (1 << (TargetBitCount - 1)) - 1
+        );
+        quantizeViaKernels(
+          source, target, sampleCount, Limit, 0, TargetTypeBitCount - TargetBitCount
+        );
+      } else { // target bit count 16 or less / 17 or more
+        constexpr double Limit = static_cast<double>(
+          (std::int64_t(1) << (TargetBitCount - 1)) - 1
+        );
+        quantizeViaKernels(
+          source, target, sampleCount, Limit, 0, TargetTypeBitCount - TargetBitCount
+        );
+      }
+
+    // From integer to floating point
+    // ------------------------------
+    //
+    } else if constexpr(std::is_floating_point<TTargetSample>::value) {
+      if constexpr(std::is_same<TSourceSample, std::uint8_t>::value) {
+        Reconstruct(source, SourceBitCount, target, sampleCount); // rare, not worth it
+      } else if constexpr(SourceBitCount < 17) {
+        constexpr TTargetSample Limit = static_cast<TTargetSample>(
+          (1 << (SourceBitCount - 1)) - 1
+        );
+        reconstructViaKernels(
+          source, target, sampleCount, Limit, SourceTypeBitCount - SourceBitCount
+        );
+      } else { // source bit count 16 or less / 17 or more
+        constexpr double Limit = static_cast<double>(
+          (std::int64_t(1) << (SourceBitCount - 1)) - 1
+        );
+        reconstructViaKernels(
+          source, target, sampleCount, Limit, SourceTypeBitCount - SourceBitCount
+        );
+      }
+
+    // Between integers with unsigned involved
+    // ---------------------------------------
+    //
+    } else if constexpr(
+      std::is_same<TSourceSample, std::uint8_t>::value ||
+      std::is_same<TTargetSample, std::uint8_t>::value
+    ) {
+      Convert(source, SourceBitCount, target, TargetBitCount, sampleCount);
+
+    // Between signed integers
+    // -----------------------
+    //
+    } else { // unsigned involved / both are signed
+      constexpr TTargetSample TargetMask = static_cast<TTargetSample>(
+        ((std::uint64_t(1) << TargetBitCount) - 1) << (TargetTypeBitCount - TargetBitCount)
+      );
+
+      if constexpr(TargetTypeBitCount < SourceTypeBitCount) {
+        constexpr std::size_t Shift = SourceTypeBitCount - TargetTypeBitCount;
+        if constexpr(TargetBitCount < SourceBitCount) {
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            target[sampleIndex] = static_cast<TTargetSample>(
+              (source[sampleIndex] >> Shift) & TargetMask
+            );
+          }
+        } else if constexpr(TargetBitCount == SourceBitCount) {
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            target[sampleIndex] = static_cast<TTargetSample>(source[sampleIndex] >> Shift);
+          }
+        } else { // shorter type with more bits, same fallback as ExtendBits() uses
+          ExtendBits(source, SourceBitCount, target, TargetBitCount, sampleCount);
+        }
+      } else { // target type shorter / longer or equal
+        constexpr std::size_t Shift = TargetTypeBitCount - SourceTypeBitCount;
+        if constexpr(TargetBitCount < SourceBitCount) {
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            target[sampleIndex] = (
+              (static_cast<TTargetSample>(source[sampleIndex]) << Shift) & TargetMask
+            );
+          }
+        } else if constexpr(TargetBitCount == SourceBitCount) {
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            target[sampleIndex] = static_cast<TTargetSample>(source[sampleIndex]) << Shift;
+          }
+        } else if constexpr(SourceBitCount * 2 >= TargetBitCount + 1) { // repeat once
+          constexpr TTargetSample OnceMask = static_cast<TTargetSample>(
+            (
+              ((std::uint64_t(1) << (SourceBitCount - 1)) - 1) <<
+              (TargetTypeBitCount - SourceBitCount)
+            ) >> (SourceBitCount - 1)
+          );
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            TTargetSample value = static_cast<TTargetSample>(source[sampleIndex]) << Shift;
+            TTargetSample once = (value >> (SourceBitCount - 1)) & OnceMask;
+            target[sampleIndex] = TargetMask & (value | once);
+          }
+        } else { // repeat bit pattern once / twice
+          constexpr TTargetSample OnceMask = static_cast<TTargetSample>(
+            ((std::uint64_t(1) << (SourceBitCount - 1)) - 1) <<
+            (TargetTypeBitCount - SourceBitCount - (SourceBitCount - 1))
+          );
+          for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+            TTargetSample value = static_cast<TTargetSample>(source[sampleIndex]) << Shift;
+            TTargetSample once = (value >> (SourceBitCount - 1)) & OnceMask;
+            TTargetSample twice = (once >> (SourceBitCount - 1));
+            target[sampleIndex] = TargetMask & (value | once | twice);
+          }
+        } // if truncating, same bit count, repeating once or twice
+      } // if target type shorter or longer
+    } // if float or integer on either side
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TFloatSourceSample, typename TTargetSample>
   inline void SampleConverter::Quantize(
     const TFloatSourceSample *source,
     TTargetSample *target, std::size_t targetBitCount,
     std::size_t sampleCount
+  ) {
+    Quantize(source, target, targetBitCount, sampleCount, 1.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloatSourceSample, typename TTargetSample>
+  inline void SampleConverter::Quantize(
+    const TFloatSourceSample *source,
+    TTargetSample *target, std::size_t targetBitCount,
+    std::size_t sampleCount,
+    float gain
   ) {
     static_assert(
       (
@@ -204,87 +660,26 @@ namespace Nuclex { namespace Audio { namespace Processing {
       std::int16_t midpoint = (1 << targetBitCount) / 2;
       TFloatSourceSample limit = static_cast<TFloatSourceSample>(
         (midpoint - 1) << (8 - targetBitCount)
-      );
+      ) * static_cast<TFloatSourceSample>(gain);
       midpoint <<= (8 - targetBitCount);
-      while(3 < sampleCount) {
-        std::int32_t scaled[4];
-        Quantization::MultiplyToNearestInt32x4(source, limit, scaled);
-        target[0] = static_cast<TTargetSample>(scaled[0] + midpoint);
-        target[1] = static_cast<TTargetSample>(scaled[1] + midpoint);
-        target[2] = static_cast<TTargetSample>(scaled[2] + midpoint);
-        target[3] = static_cast<TTargetSample>(scaled[3] + midpoint);
-        source += 4;
-        target += 4;
-        sampleCount -= 4;
-      }
-      while(0 < sampleCount) {
-        target[0] = static_cast<TTargetSample>(
-          Quantization::NearestInt32(source[0] * limit) + midpoint
-        );
-        ++source;
-        ++target;
-        --sampleCount;
-      }
+      quantizeViaKernels(source, target, sampleCount, limit, midpoint, 0);
 
     } else { // float -> int16 and int32
 
       // Floating point to signed integer
       // --------------------------------
       //
-      if(targetBitCount < 17) {
-
-        // From floating point to 16-bits or less
-        // --------------------------------------
-        //
+      std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
+      if(targetBitCount < 17) { // From floating point to 16-bits or less
         TFloatSourceSample limit = static_cast<TFloatSourceSample>(
           (1 << (targetBitCount - 1)) - 1
+        ) * static_cast<TFloatSourceSample>(gain);
+        quantizeViaKernels(source, target, sampleCount, limit, 0, shift);
+      } else { // From floating point to 17-bits or more
+        double limit = (
+          static_cast<double>((1 << (targetBitCount - 1)) - 1) * static_cast<double>(gain)
         );
-        std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
-        while(3 < sampleCount) {
-          std::int32_t scaled[4];
-          Quantization::MultiplyToNearestInt32x4(source, limit, scaled);
-          target[0] = static_cast<TTargetSample>(scaled[0]) << shift;
-          target[1] = static_cast<TTargetSample>(scaled[1]) << shift;
-          target[2] = static_cast<TTargetSample>(scaled[2]) << shift;
-          target[3] = static_cast<TTargetSample>(scaled[3]) << shift;
-          source += 4;
-          target += 4;
-          sampleCount -= 4;
-        }
-        while(0 < sampleCount) {
-          target[0] = static_cast<TTargetSample>(
-            Quantization::NearestInt32(source[0] * limit)
-          ) << shift;
-          ++source;
-          ++target;
-          --sampleCount;
-        }
-
-      // From floating point to 17-bits or more
-      // --------------------------------------
-      //
-      } else {
-        double limit = static_cast<double>((1 << (targetBitCount - 1)) - 1);
-        std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
-        while(3 < sampleCount) {
-          std::int32_t scaled[4];
-          Quantization::MultiplyToNearestInt32x4(source, limit, scaled);
-          target[0] = static_cast<TTargetSample>(scaled[0]) << shift;
-          target[1] = static_cast<TTargetSample>(scaled[1]) << shift;
-          target[2] = static_cast<TTargetSample>(scaled[2]) << shift;
-          target[3] = static_cast<TTargetSample>(scaled[3]) << shift;
-          source += 4;
-          target += 4;
-          sampleCount -= 4;
-        }
-        while(0 < sampleCount) {
-          target[0] = static_cast<TTargetSample>(
-            Quantization::NearestInt32(source[0] * limit)
-          ) << shift;
-          ++source;
-          ++target;
-          --sampleCount;
-        }
+        quantizeViaKernels(source, target, sampleCount, limit, 0, shift);
       }
     }
   }
@@ -296,6 +691,18 @@ namespace Nuclex { namespace Audio { namespace Processing {
     const TSourceSample *source, std::size_t sourceBitCount,
     TFloatTargetSample *target,
     std::size_t sampleCount
+  ) {
+    Reconstruct(source, sourceBitCount, target, sampleCount, 1.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSourceSample, typename TFloatTargetSample>
+  inline void SampleConverter::Reconstruct(
+    const TSourceSample *source, std::size_t sourceBitCount,
+    TFloatTargetSample *target,
+    std::size_t sampleCount,
+    float gain
   ) {
     static_assert(
       (
@@ -316,7 +723,7 @@ namespace Nuclex { namespace Audio { namespace Processing {
       std::int16_t midpoint = (1 << sourceBitCount) / 2;
       TFloatTargetSample limit = static_cast<TFloatTargetSample>(
         (midpoint - 1) << (8 - sourceBitCount)
-      );
+      ) / static_cast<TFloatTargetSample>(gain);
       midpoint <<= (8 - sourceBitCount);
       for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
         target[sampleIndex] = (
@@ -330,66 +737,320 @@ namespace Nuclex { namespace Audio { namespace Processing {
     // -------------------------------------
     //
     } else { // int16 or int32 -> float
-
-      // From 16-bits or less to floating point
-      // --------------------------------------
-      //
-      if(sourceBitCount < 17) {
-        std::size_t shift = sizeof(TSourceSample) * 8 - sourceBitCount;
+      std::size_t shift = sizeof(TSourceSample) * 8 - sourceBitCount;
+      if(sourceBitCount < 17) { // From 16-bits or less to floating point
         TFloatTargetSample limit = static_cast<TFloatTargetSample>(
           (1 << (sourceBitCount - 1)) - 1
-        );
-        while(3 < sampleCount) {
-          std::int32_t shifted[4];
-          shifted[0] = source[0] >> shift;
-          shifted[1] = source[1] >> shift;
-          shifted[2] = source[2] >> shift;
-          shifted[3] = source[3] >> shift;
-          Reconstruction::DivideInt32ToFloatx4(shifted, limit, target);
-          source += 4;
-          target += 4;
-          sampleCount -= 4;
-        }
-        while(0 < sampleCount) {
-          target[0] = Reconstruction::DivideInt32ToFloat(source[0] >> shift, limit);
-          ++source;
-          ++target;
-          --sampleCount;
-        }
-
-      // From 17-bits or more to floating point
-      // --------------------------------------
-      //
+        ) / static_cast<TFloatTargetSample>(gain);
+        reconstructViaKernels(source, target, sampleCount, limit, shift);
       } else { // for values longer than 16 bits, we force calculations to use doubles
-        std::size_t shift = sizeof(TSourceSample) * 8 - sourceBitCount;
         double limit = static_cast<double>(
           (1 << (sourceBitCount - 1)) - 1
+        ) / static_cast<double>(gain);
+        reconstructViaKernels(source, target, sampleCount, limit, shift);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloatSourceSample, typename TTargetSample>
+  inline void SampleConverter::Quantize(
+    const TFloatSourceSample *source,
+    TTargetSample *target, std::size_t targetBitCount,
+    std::size_t sampleCount,
+    float startGain, float endGain
+  ) {
+    if(startGain == endGain) {
+      Quantize(source, target, targetBitCount, sampleCount, startGain);
+      return;
+    }
+
+    // The limits used here must match the ones in the constant gain variant
+    if constexpr(std::is_same<TTargetSample, std::uint8_t>::value) { // float -> uint8
+      std::int16_t midpoint = (1 << targetBitCount) / 2;
+      TFloatSourceSample limit = static_cast<TFloatSourceSample>(
+        (midpoint - 1) << (8 - targetBitCount)
+      );
+      midpoint <<= (8 - targetBitCount);
+      quantizeRamped(source, target, sampleCount, limit, midpoint, 0, startGain, endGain);
+    } else if(targetBitCount < 17) { // float -> int16 and int32 of 16 bits or less
+      TFloatSourceSample limit = static_cast<TFloatSourceSample>(
+        (1 << (targetBitCount - 1)) - 1
+      );
+      std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
+      quantizeRamped(source, target, sampleCount, limit, 0, shift, startGain, endGain);
+    } else { // float -> int32 of 17 bits or more
+      double limit = static_cast<double>((1 << (targetBitCount - 1)) - 1);
+      std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
+      quantizeRamped(source, target, sampleCount, limit, 0, shift, startGain, endGain);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSourceSample, typename TFloatTargetSample>
+  inline void SampleConverter::Reconstruct(
+    const TSourceSample *source, std::size_t sourceBitCount,
+    TFloatTargetSample *target,
+    std::size_t sampleCount,
+    float startGain, float endGain
+  ) {
+    if(startGain == endGain) {
+      Reconstruct(source, sourceBitCount, target, sampleCount, startGain);
+      return;
+    }
+
+    // The limits used here must match the ones in the constant gain variant
+    if constexpr(std::is_same<TSourceSample, std::uint8_t>::value) { // uint8 -> float
+      std::int16_t midpoint = (1 << sourceBitCount) / 2;
+      TFloatTargetSample limit = static_cast<TFloatTargetSample>(
+        (midpoint - 1) << (8 - sourceBitCount)
+      );
+      midpoint <<= (8 - sourceBitCount);
+      reconstructRamped(source, target, sampleCount, limit, midpoint, 0, startGain, endGain);
+    } else if(sourceBitCount < 17) { // int16 and int32 of 16 bits or less -> float
+      TFloatTargetSample limit = static_cast<TFloatTargetSample>(
+        (1 << (sourceBitCount - 1)) - 1
+      );
+      std::size_t shift = sizeof(TSourceSample) * 8 - sourceBitCount;
+      reconstructRamped(source, target, sampleCount, limit, 0, shift, startGain, endGain);
+    } else { // int32 of 17 bits or more -> float
+      double limit = static_cast<double>((1 << (sourceBitCount - 1)) - 1);
+      std::size_t shift = sizeof(TSourceSample) * 8 - sourceBitCount;
+      reconstructRamped(source, target, sampleCount, limit, 0, shift, startGain, endGain);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+  inline void SampleConverter::quantizeViaKernels(
+    const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+    TLimit limit, std::int32_t offset, std::size_t shift
+  ) {
+
+    // Full-range 32-bit integers need no adjustment, so they can be written directly
+    if constexpr(std::is_same<TTargetSample, std::int32_t>::value) {
+      if((offset == 0) && (shift == 0)) {
+        ConversionKernels::MultiplyToNearestInt32(source, limit, target, sampleCount);
+        return;
+      }
+    }
+
+    std::int32_t scaled[KernelChunkSampleCount];
+    while(0 < sampleCount) {
+      std::size_t chunkSampleCount = std::min(sampleCount, KernelChunkSampleCount);
+      ConversionKernels::MultiplyToNearestInt32(source, limit, scaled, chunkSampleCount);
+      for(std::size_t index = 0; index < chunkSampleCount; ++index) {
+        target[index] = static_cast<TTargetSample>(scaled[index] + offset) << shift;
+      }
+
+      source += chunkSampleCount;
+      target += chunkSampleCount;
+      sampleCount -= chunkSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloatSourceSample, typename TTargetSample>
+  inline void SampleConverter::QuantizeDithered(
+    const TFloatSourceSample *source,
+    TTargetSample *target, std::size_t targetBitCount,
+    std::size_t sampleCount,
+    Ditherer &ditherer,
+    float gain /* = 1.0f */
+  ) {
+    static_assert(
+      (
+        std::is_same<TFloatSourceSample, float>::value ||
+        std::is_same<TFloatSourceSample, double>::value
+      ) && (
+        std::is_same<TTargetSample, std::uint8_t>::value ||
+        std::is_same<TTargetSample, std::int16_t>::value ||
+        std::is_same<TTargetSample, std::int32_t>::value
+      ),
+      u8"This method only converts from float samples to quantized integer samples"
+    );
+
+    // Unlike Quantize(), the valid bits are quantized first and shifted into place
+    // afterwards, so that the dither has the magnitude of the target's real LSB
+    if constexpr(std::is_same<TTargetSample, std::uint8_t>::value) { // float -> uint8
+      std::int16_t midpoint = (1 << targetBitCount) / 2;
+      TFloatSourceSample limit = static_cast<TFloatSourceSample>(midpoint - 1);
+      quantizeDitheredViaKernels(
+        source, target, sampleCount,
+        limit * static_cast<TFloatSourceSample>(gain), limit,
+        midpoint, 8 - targetBitCount, ditherer
+      );
+    } else { // float -> int16 and int32
+      std::size_t shift = sizeof(TTargetSample) * 8 - targetBitCount;
+      if(targetBitCount < 17) { // From floating point to 16-bits or less
+        TFloatSourceSample limit = static_cast<TFloatSourceSample>(
+          (1 << (targetBitCount - 1)) - 1
         );
-        while(3 < sampleCount) {
-          std::int32_t shifted[4];
-          shifted[0] = source[0] >> shift;
-          shifted[1] = source[1] >> shift;
-          shifted[2] = source[2] >> shift;
-          shifted[3] = source[3] >> shift;
-          Reconstruction::DivideInt32ToFloatx4(shifted, limit, target);
-          source += 4;
-          target += 4;
-          sampleCount -= 4;
-        }
-        while(0 < sampleCount) {
-          target[0] = static_cast<TFloatTargetSample>(
-            Reconstruction::DivideInt32ToFloat(source[0] >> shift, limit)
-          );
-          ++source;
-          ++target;
-          --sampleCount;
+        quantizeDitheredViaKernels(
+          source, target, sampleCount,
+          limit * static_cast<TFloatSourceSample>(gain), limit, 0, shift, ditherer
+        );
+      } else { // From floating point to 17-bits or more
+        double limit = static_cast<double>((1 << (targetBitCount - 1)) - 1);
+        quantizeDitheredViaKernels(
+          source, target, sampleCount,
+          limit * static_cast<double>(gain), limit, 0, shift, ditherer
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+  inline void SampleConverter::quantizeDitheredViaKernels(
+    const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+    TLimit factor, TLimit limit, std::int32_t offset, std::size_t shift,
+    Ditherer &ditherer
+  ) {
+
+    // Full-range 32-bit integers need no adjustment, so they can be written directly
+    if constexpr(std::is_same<TTargetSample, std::int32_t>::value) {
+      if((offset == 0) && (shift == 0)) {
+        ditherer.MultiplyToDitheredInt32(source, factor, limit, target, sampleCount);
+        return;
+      }
+    }
+
+    std::int32_t scaled[KernelChunkSampleCount];
+    while(0 < sampleCount) {
+      std::size_t chunkSampleCount = std::min(sampleCount, KernelChunkSampleCount);
+      ditherer.MultiplyToDitheredInt32(source, factor, limit, scaled, chunkSampleCount);
+      for(std::size_t index = 0; index < chunkSampleCount; ++index) {
+        target[index] = static_cast<TTargetSample>((scaled[index] + offset) << shift);
+      }
+
+      source += chunkSampleCount;
+      target += chunkSampleCount;
+      sampleCount -= chunkSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSourceSample, typename TFloatTargetSample, typename TLimit>
+  inline void SampleConverter::reconstructViaKernels(
+    const TSourceSample *source, TFloatTargetSample *target, std::size_t sampleCount,
+    TLimit limit, std::size_t shift
+  ) {
+    if constexpr(std::is_same<TSourceSample, std::int32_t>::value) {
+      ConversionKernels::ShiftAndDivideInt32ToFloat(
+        source, static_cast<int>(shift), limit, target, sampleCount
+      );
+    } else { // 16-bit integers need to be widened for the kernels first
+      std::int32_t widened[KernelChunkSampleCount];
+      while(0 < sampleCount) {
+        std::size_t chunkSampleCount = std::min(sampleCount, KernelChunkSampleCount);
+        for(std::size_t index = 0; index < chunkSampleCount; ++index) {
+          widened[index] = source[index];
         }
+        ConversionKernels::ShiftAndDivideInt32ToFloat(
+          widened, static_cast<int>(shift), limit, target, chunkSampleCount
+        );
+
+        source += chunkSampleCount;
+        target += chunkSampleCount;
+        sampleCount -= chunkSampleCount;
       }
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TFloatSourceSample, typename TTargetSample, typename TLimit>
+  inline void SampleConverter::quantizeRamped(
+    const TFloatSourceSample *source, TTargetSample *target, std::size_t sampleCount,
+    TLimit limit, std::int32_t offset, std::size_t shift,
+    float startGain, float endGain
+  ) {
+    TFloatSourceSample gain = static_cast<TFloatSourceSample>(startGain);
+    TFloatSourceSample gainStep = (
+      (static_cast<TFloatSourceSample>(endGain) - gain) /
+      static_cast<TFloatSourceSample>(sampleCount)
+    );
+
+    // The gain of each sample is calculated from its index rather than accumulated,
+    // so that rounding errors don't add up over long ramps
+    std::size_t sampleIndex = 0;
+    while(sampleIndex + 15 < sampleCount) {
+      TFloatSourceSample gained[16];
+      for(std::size_t lane = 0; lane < 16; ++lane) {
+        gained[lane] = source[sampleIndex + lane] * (
+          gain + gainStep * static_cast<TFloatSourceSample>(sampleIndex + lane)
+        );
+      }
+
+      std::int32_t scaled[16];
+      Quantization::MultiplyToNearestInt32x16(gained, limit, scaled);
+      for(std::size_t lane = 0; lane < 16; ++lane) {
+        target[sampleIndex + lane] = static_cast<TTargetSample>(scaled[lane] + offset) << shift;
+      }
+
+      sampleIndex += 16;
+    }
+    while(sampleIndex < sampleCount) {
+      TFloatSourceSample gained = source[sampleIndex] * (
+        gain + gainStep * static_cast<TFloatSourceSample>(sampleIndex)
+      );
+      target[sampleIndex] = static_cast<TTargetSample>(
+        Quantization::NearestInt32(gained * limit) + offset
+      ) << shift;
+      ++sampleIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSourceSample, typename TFloatTargetSample, typename TLimit>
+  inline void SampleConverter::reconstructRamped(
+    const TSourceSample *source, TFloatTargetSample *target, std::size_t sampleCount,
+    TLimit limit, std::int32_t offset, std::size_t shift,
+    float startGain, float endGain
+  ) {
+    TFloatTargetSample gain = static_cast<TFloatTargetSample>(startGain);
+    TFloatTargetSample gainStep = (
+      (static_cast<TFloatTargetSample>(endGain) - gain) /
+      static_cast<TFloatTargetSample>(sampleCount)
+    );
+
+    // The gain is applied to the reconstructed samples while they're still
+    // in the CPU's registers, so this remains a single pass over the samples
+    std::size_t sampleIndex = 0;
+    while(sampleIndex + 15 < sampleCount) {
+      std::int32_t shifted[16];
+      for(std::size_t lane = 0; lane < 16; ++lane) {
+        shifted[lane] = (static_cast<std::int32_t>(source[sampleIndex + lane]) >> shift) - offset;
+      }
+
+      Reconstruction::DivideInt32ToFloatx16(shifted, limit, target + sampleIndex);
+      for(std::size_t lane = 0; lane < 16; ++lane) {
+        target[sampleIndex + lane] *= (
+          gain + gainStep * static_cast<TFloatTargetSample>(sampleIndex + lane)
+        );
+      }
+
+      sampleIndex += 16;
+    }
+    while(sampleIndex < sampleCount) {
+      std::int32_t shifted = (static_cast<std::int32_t>(source[sampleIndex]) >> shift) - offset;
+      target[sampleIndex] = static_cast<TFloatTargetSample>(
+        Reconstruction::DivideInt32ToFloat(shifted, limit)
+      ) * (gain + gainStep * static_cast<TFloatTargetSample>(sampleIndex));
+      ++sampleIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TSourceSample, typename TTargetSample>
   inline void SampleConverter::TruncateBits(
     const TSourceSample *source, std::size_t sourceBitCount,
@@ -562,7 +1223,13 @@ namespace Nuclex { namespace Audio { namespace Processing {
             Quantize(doubles.data(), target, targetBitCount, sampleCount);          
 
           }
-        } else { // target type shorter / longer or equal
+        } else if constexpr(std::is_same<TTargetSample, std::int32_t>::value) {
+          // Widening to 32-bit integers is what decoders and mixing buses do all the time,
+          // so it goes through the vectorized kernels (which produce the same results)
+          BitExtension::ExtendToInt32(
+            source, sourceBitCount, target, targetBitCount, sampleCount
+          );
+        } else { // target type shorter / 32-bit target / 16-bit target
           std::size_t shift = (sizeof(TTargetSample) - sizeof(TSourceSample)) * 8;
 
           if(sourceBitCount == targetBitCount) { // conversion between containing types only
@@ -0,0 +1,191 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_SILENCEDETECTOR_H
+#define NUCLEX_AUDIO_PROCESSING_SILENCEDETECTOR_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stretch of frames in which all channels are silent</summary>
+  struct NUCLEX_AUDIO_TYPE SilentInterval {
+
+    /// <summary>Index of the first silent frame</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of consecutive silent frames</summary>
+    public: std::uint64_t FrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Range of frames between the first and the last audible sample</summary>
+  struct NUCLEX_AUDIO_TYPE AudibleRange {
+
+    /// <summary>Index of the first frame with an audible sample</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Index one past the last frame with an audible sample</summary>
+    public: std::uint64_t EndFrame;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates silent stretches and trims silence off the ends of tracks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The detector looks at the peak of all channels in short windows. A silent stretch
+  ///     begins with a window whose peak is at or below the threshold and lasts until
+  ///     a window's peak exceeds the threshold plus the hysteresis, so noise hovering
+  ///     around the threshold does not chop a pause into pieces. Stretches shorter than
+  ///     the minimum duration are ignored. Boundaries fall on window boundaries.
+  ///   </para>
+  ///   <para>
+  ///     Peaks are found with SSE2 or NEON, 4 samples at a time, and interleaved channels
+  ///     are simply scanned as one long run since the peak of any channel counts.
+  ///   </para>
+  ///   <para>
+  ///     For trimming, <see cref="FindAudibleRange" /> finds the first and last sample above
+  ///     the threshold exactly. It searches the end of the track by decoding blocks
+  ///     backwards from the last frame, so only the silent tail and the silent head are
+  ///     decoded, no matter how long the track is. Blocks the codec itself flags as silent
+  ///     (see <see cref="Storage.AudioTrackDecoder.DescribeBlock" />) are not decoded at all.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SilenceDetector {
+
+    /// <summary>Finds all silent intervals in an audio track</summary>
+    /// <param name="decoder">Decoder for the audio track that will be scanned</param>
+    /// <param name="thresholdDecibels">Level in dBFS at or below which audio is silent</param>
+    /// <param name="hysteresisDecibels">
+    ///   Amount in dB by which the level needs to rise above the threshold to end silence
+    /// </param>
+    /// <param name="minimumFrameCount">Shortest silent interval that will be reported</param>
+    /// <returns>All silent intervals in the order they appear in the track</returns>
+    public: NUCLEX_AUDIO_API static std::vector<SilentInterval> FindSilentIntervals(
+      const Storage::AudioTrackDecoder &decoder,
+      float thresholdDecibels = -60.0f,
+      float hysteresisDecibels = 6.0f,
+      std::size_t minimumFrameCount = 4800
+    );
+
+    /// <summary>Finds the range of a track that remains after trimming silence</summary>
+    /// <param name="decoder">Decoder for the audio track that will be scanned</param>
+    /// <param name="thresholdDecibels">Level in dBFS at or below which audio is silent</param>
+    /// <returns>
+    ///   The range from the first to the last audible frame. If the whole track is silent,
+    ///   an empty range at the end of the track is returned.
+    /// </returns>
+    public: NUCLEX_AUDIO_API static AudibleRange FindAudibleRange(
+      const Storage::AudioTrackDecoder &decoder, float thresholdDecibels = -60.0f
+    );
+
+    /// <summary>Initializes a new silence detector</summary>
+    /// <param name="channelCount">Number of channels in the audio that will be scanned</param>
+    /// <param name="thresholdDecibels">Level in dBFS at or below which audio is silent</param>
+    /// <param name="hysteresisDecibels">
+    ///   Amount in dB by which the level needs to rise above the threshold to end silence
+    /// </param>
+    /// <param name="minimumFrameCount">Shortest silent interval that will be reported</param>
+    /// <param name="windowFrameCount">Number of frames whose peak is judged at once</param>
+    public: NUCLEX_AUDIO_API SilenceDetector(
+      std::size_t channelCount,
+      float thresholdDecibels = -60.0f,
+      float hysteresisDecibels = 6.0f,
+      std::size_t minimumFrameCount = 4800,
+      std::size_t windowFrameCount = 256
+    );
+
+    /// <summary>Counts the number of channels the detector scans</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Forgets all silent intervals so a new track can be scanned</summary>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Scans a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to scan</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Judges the last, partial window and closes a silence reaching the end</summary>
+    public: NUCLEX_AUDIO_API void Finish();
+
+    /// <summary>Returns the silent intervals found so far</summary>
+    /// <returns>All completed silent intervals in the order they appear</returns>
+    public: const std::vector<SilentInterval> &GetSilentIntervals() const {
+      return this->intervals;
+    }
+
+    /// <summary>Judges the window that has been accumulated and starts the next one</summary>
+    private: void closeWindow();
+
+    /// <summary>Ends the current silent stretch and records it if it is long enough</summary>
+    /// <param name="endFrame">Index of the first frame that is no longer silent</param>
+    private: void closeSilence(std::uint64_t endFrame);
+
+    /// <summary>Number of channels in the scanned audio</summary>
+    private: std::size_t channelCount;
+    /// <summary>Peak at or below which a window begins a silent stretch</summary>
+    private: float enterThreshold;
+    /// <summary>Peak above which a window ends a silent stretch</summary>
+    private: float exitThreshold;
+    /// <summary>Shortest silent stretch that will be reported</summary>
+    private: std::size_t minimumFrameCount;
+    /// <summary>Number of frames whose peak is judged at once</summary>
+    private: std::size_t windowFrameCount;
+    /// <summary>Number of frames scanned so far, including the current window</summary>
+    private: std::uint64_t processedFrameCount;
+    /// <summary>Number of frames accumulated in the current window</summary>
+    private: std::size_t windowFillCount;
+    /// <summary>Highest magnitude seen in the current window</summary>
+    private: float windowPeak;
+    /// <summary>Whether the audio is currently in a silent stretch</summary>
+    private: bool isSilent;
+    /// <summary>Frame at which the current silent stretch began</summary>
+    private: std::uint64_t silenceStartFrame;
+    /// <summary>Silent intervals that have been found so far</summary>
+    private: std::vector<SilentInterval> intervals;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_SILENCEDETECTOR_H
@@ -0,0 +1,241 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_SPECTRUMANALYZER_H
+#define NUCLEX_AUDIO_PROCESSING_SPECTRUMANALYZER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class FftPlan;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Window functions that can be applied before each transform</summary>
+  enum class WindowFunction {
+
+    /// <summary>No window, samples are transformed as they are</summary>
+    Rectangular = 0,
+    /// <summary>Raised cosine, a good all-round choice with quick sidelobe falloff</summary>
+    Hann = 1,
+    /// <summary>Raised cosine with a lower first sidelobe but slower falloff</summary>
+    Hamming = 2,
+    /// <summary>Four-term window with over 90 dB sidelobe suppression but wide peaks</summary>
+    BlackmanHarris = 3
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives the spectra computed by a spectrum analyzer</summary>
+  class NUCLEX_AUDIO_TYPE SpectrumSink {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~SpectrumSink() = default;
+
+    /// <summary>Processes the spectrum of one analysis window</summary>
+    /// <param name="startFrame">Index of the first frame in the analysis window</param>
+    /// <param name="powers">Power of each frequency bin, from DC up to Nyquist</param>
+    /// <param name="binCount">Number of frequency bins</param>
+    /// <remarks>
+    ///   The powers are only valid until the sink returns.
+    /// </remarks>
+    public: virtual void ProcessSpectrum(
+      std::uint64_t startFrame, const float *powers, std::size_t binCount
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Computes the power spectra of overlapping windows of a signal</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All channels are averaged into one and every time a full window's worth of
+  ///     frames has been gathered, the window is weighted, transformed and its spectrum
+  ///     handed to the sink. Windows begin every hop size frames. Powers are scaled so
+  ///     that a sine wave of amplitude A that is centered on a bin shows up with a power
+  ///     of about A² in that bin, no matter which window function is used.
+  ///   </para>
+  ///   <para>
+  ///     As a decoded sample sink, the analyzer can be handed to
+  ///     <see cref="Storage::AudioTrackDecoder.DecodeRange" /> and takes the samples
+  ///     right out of the codec's buffers. Converting them to floats and averaging
+  ///     the channels happens in the same pass that fills the analysis window, so
+  ///     the audio is never copied into an intermediate float buffer.
+  ///   </para>
+  ///   <para>
+  ///     The FFT plan is shared between all analyzers of the same size and the window
+  ///     and working buffers are allocated once, so analyzing does not allocate.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SpectrumAnalyzer : public Storage::DecodedSampleSink {
+
+    /// <summary>Computes the spectra of a whole audio track</summary>
+    /// <param name="decoder">Decoder for the track that will be analyzed</param>
+    /// <param name="sink">Sink that will receive the spectra</param>
+    /// <param name="fftSize">Number of frames in each analysis window</param>
+    /// <param name="hopSize">Number of frames between the starts of two windows</param>
+    /// <param name="window">Window function that will be applied to each window</param>
+    public: NUCLEX_AUDIO_API static void Analyze(
+      const Storage::AudioTrackDecoder &decoder,
+      SpectrumSink &sink,
+      std::size_t fftSize = 2048,
+      std::size_t hopSize = 512,
+      WindowFunction window = WindowFunction::Hann
+    );
+
+    /// <summary>Adds up the powers of all bins within frequency bands</summary>
+    /// <param name="powers">Powers of the frequency bins</param>
+    /// <param name="binCount">Number of frequency bins</param>
+    /// <param name="sampleRate">Sample rate of the analyzed signal in hertz</param>
+    /// <param name="bandEdges">
+    ///   Frequencies in hertz at which the bands begin and end, ascending. Band i covers
+    ///   the bins from band edge i up to, but not including, band edge i + 1.
+    /// </param>
+    /// <param name="bandCount">Number of bands, one less than the number of band edges</param>
+    /// <param name="energies">Receives the summed up power of each band</param>
+    public: NUCLEX_AUDIO_API static void SumBands(
+      const float *powers, std::size_t binCount, double sampleRate,
+      const double *bandEdges, std::size_t bandCount, float *energies
+    );
+
+    /// <summary>Initializes a new spectrum analyzer</summary>
+    /// <param name="sink">Sink that will receive the spectra</param>
+    /// <param name="channelCount">Number of channels in the analyzed signal</param>
+    /// <param name="fftSize">
+    ///   Number of frames in each analysis window, a power of two no less than 8
+    /// </param>
+    /// <param name="hopSize">
+    ///   Number of frames between the starts of two windows, at most the FFT size
+    /// </param>
+    /// <param name="window">Window function that will be applied to each window</param>
+    public: NUCLEX_AUDIO_API SpectrumAnalyzer(
+      SpectrumSink &sink,
+      std::size_t channelCount,
+      std::size_t fftSize = 2048,
+      std::size_t hopSize = 512,
+      WindowFunction window = WindowFunction::Hann
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~SpectrumAnalyzer() override;
+
+    /// <summary>Returns the number of frames in each analysis window</summary>
+    /// <returns>The size of the FFT the analyzer runs</returns>
+    public: std::size_t GetFftSize() const { return this->fftSize; }
+
+    /// <summary>Returns the number of frames between the starts of two windows</summary>
+    /// <returns>The distance between two analysis windows</returns>
+    public: std::size_t GetHopSize() const { return this->hopSize; }
+
+    /// <summary>Counts the number of frequency bins in each spectrum</summary>
+    /// <returns>The number of bins from DC up to and including the Nyquist frequency</returns>
+    public: std::size_t CountBins() const { return this->fftSize / 2 + 1; }
+
+    /// <summary>Discards all gathered frames and restarts at the specified frame</summary>
+    /// <param name="startFrame">Index the next frame passed to the analyzer will have</param>
+    public: NUCLEX_AUDIO_API void Reset(std::uint64_t startFrame = 0);
+
+    /// <summary>Analyzes interleaved floating point samples</summary>
+    /// <param name="samples">Samples of all channels, interleaved</param>
+    /// <param name="frameCount">Number of frames that will be analyzed</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of samples as the codec decoded them</summary>
+    /// <param name="samples">Block of decoded samples in the codec's native format</param>
+    /// <remarks>
+    ///   If the block does not continue where the previous one ended, the analyzer
+    ///   discards what it gathered and restarts at the block's first frame.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void ProcessSamples(
+      const Storage::DecodedSamples &samples
+    ) override;
+
+    /// <summary>Averages the channels of samples into the analysis window</summary>
+    /// <typeparam name="TSample">Type of the samples that will be gathered</typeparam>
+    /// <param name="buffers">Buffer for each channel or a single interleaved one</param>
+    /// <param name="isInterleaved">Whether the channels are interleaved</param>
+    /// <param name="frameCount">Number of frames that will be gathered</param>
+    /// <param name="scale">Factor that brings the samples into the -1.0 to 1.0 range</param>
+    /// <param name="offset">Value that will be subtracted from the samples first</param>
+    private: template<typename TSample>
+    void gather(
+      const void *const *buffers, bool isInterleaved, std::size_t frameCount,
+      float scale, float offset
+    );
+
+    /// <summary>Transforms the full analysis window and advances it by one hop</summary>
+    private: void emitSpectrum();
+
+    /// <summary>Sink that receives the computed spectra</summary>
+    private: SpectrumSink &sink;
+    /// <summary>Number of channels in the analyzed signal</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames in each analysis window</summary>
+    private: std::size_t fftSize;
+    /// <summary>Number of frames between the starts of two windows</summary>
+    private: std::size_t hopSize;
+    /// <summary>Shared tables for running the FFT</summary>
+    private: std::shared_ptr<const FftPlan> plan;
+    /// <summary>Weight of each sample in the analysis window</summary>
+    private: SampleVector<float> weights;
+    /// <summary>Factor by which bin magnitudes are scaled before squaring</summary>
+    private: float powerScale;
+    /// <summary>Mono samples gathered for the current analysis window</summary>
+    private: SampleVector<float> history;
+    /// <summary>Number of samples in the history</summary>
+    private: std::size_t historyLength;
+    /// <summary>Index of the frame the first sample in the history belongs to</summary>
+    private: std::uint64_t historyStartFrame;
+    /// <summary>Weighted samples of the analysis window that is being transformed</summary>
+    private: SampleVector<float> windowed;
+    /// <summary>Working memory for the FFT</summary>
+    private: SampleVector<float> scratch;
+    /// <summary>Powers of the most recently computed spectrum</summary>
+    private: SampleVector<float> powers;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_SPECTRUMANALYZER_H
@@ -0,0 +1,198 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_VOICEMIXER_H
+#define NUCLEX_AUDIO_PROCESSING_VOICEMIXER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Processing/Resampler.h" // for ResamplerQuality
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+  class StreamingTrackReader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes any number of playing voices into a stereo output bus</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each voice pulls its audio straight from its source: a
+  ///     <see cref="Storage::StreamingTrackReader" />, a block of decoded samples in memory
+  ///     (such as a clip in a <see cref="Storage::DecodedSoundBank" />) or an audio track
+  ///     decoder. Voices with a different sample rate than the output bus run through their
+  ///     own <see cref="Resampler" />, then their gain and panning are applied while they
+  ///     are accumulated into the interleaved stereo output.
+  ///   </para>
+  ///   <para>
+  ///     All buffers a voice needs are allocated when it is added, so <see cref="Mix" />
+  ///     never allocates, takes no locks and can run on an audio callback thread. Streaming
+  ///     readers and memory clips are wait-free sources. Decoders are only as real-time
+  ///     safe as the decoder itself, for most codecs they should be put behind
+  ///     a streaming reader instead.
+  ///   </para>
+  ///   <para>
+  ///     The mixer is not thread-safe. Adding and removing voices may allocate, so these
+  ///     should happen from the mixing thread between calls to <see cref="Mix" />.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE VoiceMixer {
+
+    /// <summary>Initializes a new voice mixer</summary>
+    /// <param name="outputSampleRate">Sample rate of the output bus</param>
+    /// <param name="maximumFrameCount">Number of frames mixed at once internally</param>
+    /// <param name="quality">Quality of the resamplers used for voices</param>
+    /// <remarks>
+    ///   Calls to <see cref="Mix" /> may ask for any number of frames, larger requests
+    ///   are mixed in chunks of <paramref name="maximumFrameCount" /> frames.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API VoiceMixer(
+      std::size_t outputSampleRate,
+      std::size_t maximumFrameCount = 1024,
+      ResamplerQuality quality = ResamplerQuality::Fast
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~VoiceMixer();
+
+    /// <summary>Retrieves the sample rate of the output bus</summary>
+    /// <returns>The number of frames the output bus plays back per second</returns>
+    public: std::size_t GetOutputSampleRate() const { return this->outputSampleRate; }
+
+    /// <summary>Counts the voices that have been added to the mixer</summary>
+    /// <returns>The number of voices, including those that have finished playing</returns>
+    public: std::size_t CountVoices() const { return this->voices.size(); }
+
+    /// <summary>Adds a voice that plays the audio delivered by a streaming reader</summary>
+    /// <param name="reader">Streaming reader the voice will read from</param>
+    /// <param name="sampleRate">Sample rate of the audio delivered by the reader</param>
+    /// <returns>An identifier through which the voice can be controlled</returns>
+    public: NUCLEX_AUDIO_API std::size_t AddVoice(
+      const std::shared_ptr<Storage::StreamingTrackReader> &reader, std::size_t sampleRate
+    );
+
+    /// <summary>Adds a voice that plays interleaved samples held in memory</summary>
+    /// <param name="samples">Interleaved samples the voice will play</param>
+    /// <param name="frameCount">Number of frames in the sample buffer</param>
+    /// <param name="channelCount">Number of channels interleaved in the sample buffer</param>
+    /// <param name="sampleRate">Sample rate of the samples</param>
+    /// <returns>An identifier through which the voice can be controlled</returns>
+    /// <remarks>
+    ///   The samples are not copied, they need to stay alive until the voice is removed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t AddVoice(
+      const float *samples, std::uint64_t frameCount,
+      std::size_t channelCount, std::size_t sampleRate
+    );
+
+    /// <summary>Adds a voice that plays the output of an audio track decoder</summary>
+    /// <param name="decoder">Decoder the voice will decode from</param>
+    /// <param name="sampleRate">Sample rate of the audio delivered by the decoder</param>
+    /// <returns>An identifier through which the voice can be controlled</returns>
+    /// <remarks>
+    ///   The decoder is called from <see cref="Mix" />, so this is only real-time safe
+    ///   if decoding is (such as for Waveform files cached in memory).
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t AddVoice(
+      const std::shared_ptr<const Storage::AudioTrackDecoder> &decoder, std::size_t sampleRate
+    );
+
+    /// <summary>Removes a voice from the mixer</summary>
+    /// <param name="voiceId">Identifier of the voice that will be removed</param>
+    /// <returns>True if the voice existed and has been removed</returns>
+    public: NUCLEX_AUDIO_API bool RemoveVoice(std::size_t voiceId);
+
+    /// <summary>Changes the volume at which a voice is mixed</summary>
+    /// <param name="voiceId">Identifier of the voice whose gain will be changed</param>
+    /// <param name="gain">Linear factor by which the voice's samples are multiplied</param>
+    public: NUCLEX_AUDIO_API void SetGain(std::size_t voiceId, float gain);
+
+    /// <summary>Changes where the voice is placed in the stereo panorama</summary>
+    /// <param name="voiceId">Identifier of the voice whose panning will be changed</param>
+    /// <param name="pan">Position from -1.0 (left) via 0.0 (center) to 1.0 (right)</param>
+    /// <remarks>
+    ///   Mono voices use a constant-power pan law, stereo voices are balanced by
+    ///   turning down the channel on the opposite side.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetPan(std::size_t voiceId, float pan);
+
+    /// <summary>Checks whether a voice has played all of its audio</summary>
+    /// <param name="voiceId">Identifier of the voice that will be checked</param>
+    /// <returns>True if the voice reached the end of its source</returns>
+    public: NUCLEX_AUDIO_API bool IsVoiceFinished(std::size_t voiceId) const;
+
+    /// <summary>Mixes all voices into the output bus</summary>
+    /// <param name="output">Buffer that receives the interleaved stereo output</param>
+    /// <param name="frameCount">Number of frames that will be mixed</param>
+    /// <remarks>
+    ///   The output buffer is overwritten. Never allocates memory and never blocks
+    ///   unless one of the voices is fed by a decoder that does.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Mix(float *output, std::size_t frameCount);
+
+    /// <summary>State and buffers of a single voice</summary>
+    private: struct Voice;
+
+    /// <summary>Prepares the buffers and resampler of a newly added voice</summary>
+    /// <param name="voice">Voice whose source has been set up already</param>
+    /// <returns>The identifier assigned to the voice</returns>
+    private: std::size_t addVoice(std::unique_ptr<Voice> voice);
+
+    /// <summary>Looks up the voice with the specified identifier</summary>
+    /// <param name="voiceId">Identifier of the voice that will be looked up</param>
+    /// <returns>The voice or a null pointer if no such voice exists</returns>
+    private: Voice *findVoice(std::size_t voiceId) const;
+
+    /// <summary>Mixes a chunk of frames from a single voice into the output</summary>
+    /// <param name="voice">Voice that will be mixed</param>
+    /// <param name="output">Interleaved stereo buffer the voice is added to</param>
+    /// <param name="frameCount">Number of frames that will be mixed</param>
+    private: void mixVoice(Voice &voice, float *output, std::size_t frameCount);
+
+    /// <summary>Sample rate of the output bus</summary>
+    private: std::size_t outputSampleRate;
+    /// <summary>Largest number of frames mixed in one go</summary>
+    private: std::size_t maximumFrameCount;
+    /// <summary>Quality of the resamplers created for voices</summary>
+    private: ResamplerQuality quality;
+    /// <summary>Identifier that will be assigned to the next voice</summary>
+    private: std::size_t nextVoiceId;
+    /// <summary>Voices that are currently being mixed</summary>
+    private: std::vector<std::unique_ptr<Voice>> voices;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_VOICEMIXER_H
@@ -17,18 +17,165 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #pragma endregion // Apache License 2.0
-
 #ifndef NUCLEX_AUDIO_PROCESSING_VOLUMEDETECTOR_H
 #define NUCLEX_AUDIO_PROCESSING_VOLUMEDETECTOR_H
 
 #include "Nuclex/Audio/Config.h"
 
-#include <cstdint> // for std::int32_t
-#include <cmath> // for std::sgn
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int16_t, std::int32_t, std::uint64_t
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Volume statistics of a single audio channel</summary>
+  /// <remarks>
+  ///   All values are relative to full scale, so a full scale square wave has a peak
+  ///   and an RMS level of 1.0. Use the <see cref="DecibelConverter" /> to turn them
+  ///   into dBFS values.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE ChannelVolume {
+
+    /// <summary>Largest absolute sample value that has been seen</summary>
+    public: float Peak;
+    /// <summary>Root mean square of all samples, the channel's average power</summary>
+    public: float Rms;
+    /// <summary>Average of all samples, which should be close to zero</summary>
+    public: float DcOffset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the peak, RMS and DC offset of audio channels</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The detector accumulates statistics over all samples it is fed, so it can be
+  ///     attached behind a decoder and called for each block the decoder produces.
+  ///     Blocks can have any length and may mix sample types, the results always
+  ///     cover everything processed since construction or the last reset.
+  ///   </para>
+  ///   <para>
+  ///     Integer samples are analyzed as they are and scaled to full scale only when
+  ///     the block's sums are accumulated, so there is no need to reconstruct them to
+  ///     floating point first. As everywhere else in this library, integer samples are
+  ///     expected to occupy the most significant bits, so 24-bit audio in 32-bit integers
+  ///     needs no extra parameter.
+  ///   </para>
+  ///   <para>
+  ///     Interleaved samples are processed 4 at a time with SSE2 or NEON. Lanes are
+  ///     assigned to channels by their position in the interleaved stream, so this works
+  ///     for any channel count up to 8 without deinterleaving anything. Sums are kept in
+  ///     single precision over short stretches and then added up in double precision,
+  ///     so hours of audio can be analyzed without the results drifting.
+  ///   </para>
+  ///   <para>
+  ///     Processing does not allocate memory. Create one detector per track you analyze.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE VolumeDetector {
+
+    /// <summary>Initializes a new volume detector</summary>
+    /// <param name="channelCount">Number of channels in the audio that will be analyzed</param>
+    public: NUCLEX_AUDIO_API VolumeDetector(std::size_t channelCount);
+
+    /// <summary>Counts the number of channels the detector analyzes</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Counts the number of frames that have been processed so far</summary>
+    /// <returns>The number of frames the results are based on</returns>
+    public: std::uint64_t CountProcessedFrames() const { return this->processedFrameCount; }
+
+    /// <summary>Forgets all processed samples so a new track can be analyzed</summary>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Analyzes a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to process</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const float *samples, std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of interleaved floating point samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to process</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const double *samples, std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of interleaved 16-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be analyzed</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to process</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int16_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of interleaved 32-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples that will be analyzed</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to process</param>
+    public: NUCLEX_AUDIO_API void ProcessInterleaved(
+      const std::int32_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of separated floating point samples</summary>
+    /// <param name="channels">One buffer of samples for each channel</param>
+    /// <param name="frameCount">Number of samples in each channel to process</param>
+    public: NUCLEX_AUDIO_API void ProcessSeparated(
+      const float *const channels[], std::size_t frameCount
+    );
+
+    /// <summary>Analyzes a block of separated 16-bit integer samples</summary>
+    /// <param name="channels">One buffer of samples for each channel</param>
+    /// <param name="frameCount">Number of samples in each channel to process</param>
+    public: NUCLEX_AUDIO_API void ProcessSeparated(
+      const std::int16_t *const channels[], std::size_t frameCount
+    );
+
+    /// <summary>Looks up the volume statistics of a single channel</summary>
+    /// <param name="channelIndex">Index of the channel whose statistics will be returned</param>
+    /// <returns>The peak, RMS level and DC offset of the channel</returns>
+    public: NUCLEX_AUDIO_API ChannelVolume GetChannelVolume(std::size_t channelIndex) const;
+
+    /// <summary>Retrieves the volume statistics of all channels</summary>
+    /// <returns>The peak, RMS level and DC offset of each channel, in order</returns>
+    public: NUCLEX_AUDIO_API std::vector<ChannelVolume> GetChannelVolumes() const;
+
+    /// <summary>Analyzes interleaved samples of any type, block by block</summary>
+    /// <typeparam name="TSample">Type of the samples that will be analyzed</typeparam>
+    /// <param name="samples">Interleaved samples that will be analyzed</param>
+    /// <param name="frameCount">Number of frames to process</param>
+    /// <param name="scale">Factor that turns a sample into a full scale relative value</param>
+    private: template<typename TSample>
+    void processInterleaved(const TSample *samples, std::size_t frameCount, double scale);
+
+    /// <summary>Analyzes separated samples of any type, block by block</summary>
+    /// <typeparam name="TSample">Type of the samples that will be analyzed</typeparam>
+    /// <param name="channels">One buffer of samples for each channel</param>
+    /// <param name="frameCount">Number of samples in each channel to process</param>
+    /// <param name="scale">Factor that turns a sample into a full scale relative value</param>
+    private: template<typename TSample>
+    void processSeparated(
+      const TSample *const channels[], std::size_t frameCount, double scale
+    );
+
+    /// <summary>Adds the single precision block sums to the running totals</summary>
+    /// <param name="scale">Factor that turns a sample into a full scale relative value</param>
+    private: void accumulateBlock(double scale);
+
+    /// <summary>Number of channels in the analyzed audio</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames that have been processed so far</summary>
+    private: std::uint64_t processedFrameCount;
+    /// <summary>Peak, sum and square sum of each channel over the current block</summary>
+    private: std::vector<float> blockSums;
+    /// <summary>Peak, sum and square sum of each channel over all processed samples</summary>
+    private: std::vector<double> totals;
+
+  };
+
   // ------------------------------------------------------------------------------------------- //
 
 }}} // namespace Nuclex::Audio::Processing
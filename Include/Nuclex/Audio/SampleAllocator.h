@@ -0,0 +1,170 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_SAMPLEALLOCATOR_H
+#define NUCLEX_AUDIO_SAMPLEALLOCATOR_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <limits> // for std::numeric_limits
+#include <new> // for std::bad_array_new_length
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the memory for the library's internal sample buffers</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Decoders, converters and analyzers keep their intermediate samples in buffers
+  ///     obtained through the global sample allocator. By default, these come from
+  ///     the aligned operator new, but an application can route them into its own
+  ///     arena or pool by installing a different allocator via <see cref="SetGlobal" />.
+  ///   </para>
+  ///   <para>
+  ///     All memory handed out must be aligned to <see cref="Alignment" /> bytes, which
+  ///     covers the widest vector registers (AVX-512) and keeps buffers from sharing
+  ///     cache lines. Allocations may happen from any thread at any time, so custom
+  ///     allocators need to be thread-safe.
+  ///   </para>
+  ///   <para>
+  ///     Each buffer remembers the allocator it was created with and returns its memory
+  ///     there, so a new global allocator only affects buffers created afterwards. It is
+  ///     best installed once at startup, and the old allocator must stay alive until all
+  ///     decoders and other objects created while it was active have been destroyed.
+  ///   </para>
+  ///   <para>
+  ///     To attribute memory to the part of the library and the codec it is used for,
+  ///     an allocator can call <see cref="AllocationScope.GetCurrent" /> from within
+  ///     <see cref="Allocate" />.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SampleAllocator {
+
+    /// <summary>Alignment, in bytes, that all allocated memory must have</summary>
+    public: static constexpr std::size_t Alignment = 64;
+
+    /// <summary>Returns the allocator that new sample buffers will use</summary>
+    /// <returns>The currently active global sample allocator</returns>
+    public: NUCLEX_AUDIO_API static SampleAllocator &GetGlobal();
+
+    /// <summary>Changes the allocator that new sample buffers will use</summary>
+    /// <param name="allocator">
+    ///   Allocator that will be used from now on or nullptr to restore the default one.
+    ///   The caller retains ownership and must keep it alive while it is in use.
+    /// </param>
+    public: NUCLEX_AUDIO_API static void SetGlobal(SampleAllocator *allocator);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~SampleAllocator() = default;
+
+    /// <summary>Allocates a block of memory aligned to <see cref="Alignment" /> bytes</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The address of the allocated memory</returns>
+    /// <remarks>
+    ///   If the memory cannot be provided, std::bad_alloc should be thrown.
+    /// </remarks>
+    public: virtual void *Allocate(std::size_t byteCount) = 0;
+
+    /// <summary>Frees a block of memory that was obtained through Allocate()</summary>
+    /// <param name="memory">Address of the memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: virtual void Free(void *memory, std::size_t byteCount) noexcept = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Standard library allocator that obtains memory from a sample allocator</summary>
+  /// <typeparam name="TElement">Type of elements that will be allocated</typeparam>
+  template<typename TElement>
+  class AlignedSampleAllocator {
+
+    template<typename TOther> friend class AlignedSampleAllocator;
+
+    /// <summary>Type of the elements the allocator hands out memory for</summary>
+    public: typedef TElement value_type;
+
+    /// <summary>Initializes a new allocator using the current global sample allocator</summary>
+    public: AlignedSampleAllocator() noexcept :
+      allocator(&SampleAllocator::GetGlobal()) {}
+
+    /// <summary>Initializes a new allocator using the specified sample allocator</summary>
+    /// <param name="allocator">Sample allocator that will provide the memory</param>
+    public: explicit AlignedSampleAllocator(SampleAllocator &allocator) noexcept :
+      allocator(&allocator) {}
+
+    /// <summary>Initializes a new allocator sharing another one's sample allocator</summary>
+    /// <param name="other">Allocator whose sample allocator will be used</param>
+    public: template<typename TOther>
+    AlignedSampleAllocator(const AlignedSampleAllocator<TOther> &other) noexcept :
+      allocator(other.allocator) {}
+
+    /// <summary>Allocates memory for the specified number of elements</summary>
+    /// <param name="count">Number of elements to allocate memory for</param>
+    /// <returns>The address of the first element</returns>
+    public: TElement *allocate(std::size_t count) {
+      if(unlikely(count > std::numeric_limits<std::size_t>::max() / sizeof(TElement))) {
+        throw std::bad_array_new_length();
+      }
+      return static_cast<TElement *>(this->allocator->Allocate(count * sizeof(TElement)));
+    }
+
+    /// <summary>Frees memory that was obtained through allocate()</summary>
+    /// <param name="memory">Address of the first element</param>
+    /// <param name="count">Number of elements memory was allocated for</param>
+    public: void deallocate(TElement *memory, std::size_t count) noexcept {
+      this->allocator->Free(memory, count * sizeof(TElement));
+    }
+
+    /// <summary>Checks whether two allocators can free each other's memory</summary>
+    /// <param name="other">Allocator that will be compared against this one</param>
+    /// <returns>True if memory from either allocator can be freed by the other</returns>
+    public: template<typename TOther>
+    bool operator ==(const AlignedSampleAllocator<TOther> &other) const noexcept {
+      return (this->allocator == other.allocator);
+    }
+
+    /// <summary>Checks whether two allocators can not free each other's memory</summary>
+    /// <param name="other">Allocator that will be compared against this one</param>
+    /// <returns>True if memory from one allocator can not be freed by the other</returns>
+    public: template<typename TOther>
+    bool operator !=(const AlignedSampleAllocator<TOther> &other) const noexcept {
+      return (this->allocator != other.allocator);
+    }
+
+    /// <summary>Sample allocator that provides the memory</summary>
+    private: SampleAllocator *allocator;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Vector whose memory is aligned and comes from the sample allocator</summary>
+  /// <typeparam name="TElement">Type of elements the vector will store</typeparam>
+  template<typename TElement>
+  using SampleVector = std::vector<TElement, AlignedSampleAllocator<TElement>>;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_SAMPLEALLOCATOR_H
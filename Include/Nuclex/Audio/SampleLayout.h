@@ -0,0 +1,53 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_SAMPLELAYOUT_H
+#define NUCLEX_AUDIO_SAMPLELAYOUT_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the samples of multiple audio channels are arranged in memory</summary>
+  enum class SampleLayout {
+
+    /// <summary>One sample of each channel after another, frame by frame</summary>
+    /// <remarks>
+    ///   This is how most audio files and audio APIs store samples. A stereo track
+    ///   would look like this in memory: L R L R L R L R.
+    /// </remarks>
+    Interleaved,
+
+    /// <summary>All samples of one channel after another, channel by channel</summary>
+    /// <remarks>
+    ///   This layout is preferrable for audio processing because each channel can be
+    ///   worked on in one sweep with SIMD instructions. A stereo track would look like
+    ///   this in memory: L L L L R R R R.
+    /// </remarks>
+    Separated
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_SAMPLELAYOUT_H
@@ -0,0 +1,329 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ANALYSISSTAGE_H
+#define NUCLEX_AUDIO_STORAGE_ANALYSISSTAGE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::unique_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct TrackInfo;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class LoudnessMeter;
+  class ContentHasher;
+  struct ContentHash;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures something about audio tracks for a library analysis pass</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Stages added to a <see cref="LibraryAnalyzer" /> act as prototypes. For each range
+  ///     of frames the analyzer decodes, it asks the prototype to <see cref="Start" /> a new
+  ///     instance, feeds it the range's samples and, once all ranges of a file are done,
+  ///     merges the instances in order. The merged instance holds the file's results.
+  ///   </para>
+  ///   <para>
+  ///     Stages whose measurement can't be pieced together from ranges, such as gated
+  ///     loudness, report so via <see cref="RequiresWholeTrack" />. Files are not split
+  ///     if any stage requires the whole track.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AnalysisStage {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~AnalysisStage() = default;
+
+    /// <summary>Creates an instance of the stage that will analyze a range of a track</summary>
+    /// <param name="track">Informations about the track that will be analyzed</param>
+    /// <param name="decoder">Decoder through which the range will be decoded</param>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <returns>A new instance of the stage that has not seen any samples yet</returns>
+    public: virtual std::unique_ptr<AnalysisStage> Start(
+      const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+    ) const = 0;
+
+    /// <summary>Whether the stage has to see all of a track in a single instance</summary>
+    /// <returns>True if the stage's results can't be merged from ranges</returns>
+    public: NUCLEX_AUDIO_API virtual bool RequiresWholeTrack() const;
+
+    /// <summary>Analyzes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) in the block</param>
+    public: virtual void Process(const float *samples, std::size_t frameCount) = 0;
+
+    /// <summary>Adds the results of the range following this one</summary>
+    /// <param name="following">
+    ///   Instance of the same stage that analyzed the range directly after this one's
+    /// </param>
+    public: virtual void Merge(const AnalysisStage &following) = 0;
+
+    /// <summary>Completes the results after the last range has been merged</summary>
+    public: NUCLEX_AUDIO_API virtual void Finish();
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the highest sample magnitude in each channel</summary>
+  class NUCLEX_AUDIO_TYPE PeakAnalysisStage : public AnalysisStage {
+
+    /// <summary>Initializes a new peak analysis stage</summary>
+    public: NUCLEX_AUDIO_API PeakAnalysisStage();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~PeakAnalysisStage() override;
+
+    /// <summary>Creates an instance of the stage that will analyze a range of a track</summary>
+    /// <param name="track">Informations about the track that will be analyzed</param>
+    /// <param name="decoder">Decoder through which the range will be decoded</param>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <returns>A new instance of the stage that has not seen any samples yet</returns>
+    public: NUCLEX_AUDIO_API std::unique_ptr<AnalysisStage> Start(
+      const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+    ) const override;
+
+    /// <summary>Analyzes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) in the block</param>
+    public: NUCLEX_AUDIO_API void Process(
+      const float *samples, std::size_t frameCount
+    ) override;
+
+    /// <summary>Adds the results of the range following this one</summary>
+    /// <param name="following">Instance that analyzed the range after this one's</param>
+    public: NUCLEX_AUDIO_API void Merge(const AnalysisStage &following) override;
+
+    /// <summary>Returns the highest sample magnitude in any channel</summary>
+    /// <returns>The peak of the loudest channel, with full scale being 1.0</returns>
+    public: NUCLEX_AUDIO_API float GetPeak() const;
+
+    /// <summary>Returns the highest sample magnitude in a channel</summary>
+    /// <param name="channelIndex">Index of the channel whose peak will be returned</param>
+    /// <returns>The peak of the channel, with full scale being 1.0</returns>
+    public: float GetPeak(std::size_t channelIndex) const { return this->peaks[channelIndex]; }
+
+    /// <summary>Highest sample magnitude seen in each channel</summary>
+    private: std::vector<float> peaks;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the samples at or near full scale in each channel</summary>
+  class NUCLEX_AUDIO_TYPE ClippingAnalysisStage : public AnalysisStage {
+
+    /// <summary>Initializes a new clipping analysis stage</summary>
+    /// <param name="threshold">
+    ///   Level relative to full scale from which on samples count as clipped
+    /// </param>
+    public: NUCLEX_AUDIO_API ClippingAnalysisStage(float threshold = 0.999f);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~ClippingAnalysisStage() override;
+
+    /// <summary>Creates an instance of the stage that will analyze a range of a track</summary>
+    /// <param name="track">Informations about the track that will be analyzed</param>
+    /// <param name="decoder">Decoder through which the range will be decoded</param>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <returns>A new instance of the stage that has not seen any samples yet</returns>
+    public: NUCLEX_AUDIO_API std::unique_ptr<AnalysisStage> Start(
+      const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+    ) const override;
+
+    /// <summary>Analyzes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) in the block</param>
+    public: NUCLEX_AUDIO_API void Process(
+      const float *samples, std::size_t frameCount
+    ) override;
+
+    /// <summary>Adds the results of the range following this one</summary>
+    /// <param name="following">Instance that analyzed the range after this one's</param>
+    public: NUCLEX_AUDIO_API void Merge(const AnalysisStage &following) override;
+
+    /// <summary>Counts the clipped samples in all channels</summary>
+    /// <returns>The total number of samples at or above the threshold</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountClippedSamples() const;
+
+    /// <summary>Counts the clipped samples in a channel</summary>
+    /// <param name="channelIndex">Index of the channel whose samples will be counted</param>
+    /// <returns>The number of samples in the channel at or above the threshold</returns>
+    public: std::uint64_t CountClippedSamples(std::size_t channelIndex) const {
+      return this->clippedSampleCounts[channelIndex];
+    }
+
+    /// <summary>Level from which on samples count as clipped</summary>
+    private: float threshold;
+    /// <summary>Number of clipped samples seen in each channel</summary>
+    private: std::vector<std::uint64_t> clippedSampleCounts;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashes the decoded samples of tracks to identify duplicate audio</summary>
+  /// <remarks>
+  ///   See <see cref="Processing::ContentHasher" /> for what goes into the hash. Block
+  ///   hashes are only complete once all ranges of a file have been merged.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ContentHashAnalysisStage : public AnalysisStage {
+
+    /// <summary>Initializes a new content hash analysis stage</summary>
+    /// <param name="blockFrameCount">
+    ///   Number of frames covered by each block hash, 0 to only hash whole tracks
+    /// </param>
+    public: NUCLEX_AUDIO_API ContentHashAnalysisStage(std::size_t blockFrameCount = 0);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~ContentHashAnalysisStage() override;
+
+    /// <summary>Creates an instance of the stage that will analyze a range of a track</summary>
+    /// <param name="track">Informations about the track that will be analyzed</param>
+    /// <param name="decoder">Decoder through which the range will be decoded</param>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <returns>A new instance of the stage that has not seen any samples yet</returns>
+    public: NUCLEX_AUDIO_API std::unique_ptr<AnalysisStage> Start(
+      const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+    ) const override;
+
+    /// <summary>Analyzes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) in the block</param>
+    public: NUCLEX_AUDIO_API void Process(
+      const float *samples, std::size_t frameCount
+    ) override;
+
+    /// <summary>Adds the results of the range following this one</summary>
+    /// <param name="following">Instance that analyzed the range after this one's</param>
+    public: NUCLEX_AUDIO_API void Merge(const AnalysisStage &following) override;
+
+    /// <summary>Returns the hash over all samples of the track</summary>
+    /// <returns>The content hash of the track</returns>
+    public: NUCLEX_AUDIO_API Processing::ContentHash GetHash() const;
+
+    /// <summary>Counts the blocks for which individual hashes are available</summary>
+    /// <returns>The number of block hashes</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountBlocks() const;
+
+    /// <summary>Returns the hash of the samples in one block</summary>
+    /// <param name="blockIndex">Index of the block whose hash will be returned</param>
+    /// <returns>The content hash of the block</returns>
+    public: NUCLEX_AUDIO_API Processing::ContentHash GetBlockHash(std::size_t blockIndex) const;
+
+    /// <summary>Number of frames covered by each block hash</summary>
+    private: std::size_t blockFrameCount;
+    /// <summary>Hasher that processes the samples, only present in started instances</summary>
+    private: std::unique_ptr<Processing::ContentHasher> hasher;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the integrated loudness and true peak of tracks</summary>
+  /// <remarks>
+  ///   Integrated loudness is gated relative to the loudness of the whole track, so this
+  ///   stage requires the whole track and files will not be split while it is used.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LoudnessAnalysisStage : public AnalysisStage {
+
+    /// <summary>Initializes a new loudness analysis stage</summary>
+    public: NUCLEX_AUDIO_API LoudnessAnalysisStage();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~LoudnessAnalysisStage() override;
+
+    /// <summary>Creates an instance of the stage that will analyze a range of a track</summary>
+    /// <param name="track">Informations about the track that will be analyzed</param>
+    /// <param name="decoder">Decoder through which the range will be decoded</param>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <returns>A new instance of the stage that has not seen any samples yet</returns>
+    public: NUCLEX_AUDIO_API std::unique_ptr<AnalysisStage> Start(
+      const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+    ) const override;
+
+    /// <summary>Whether the stage has to see all of a track in a single instance</summary>
+    /// <returns>Always true, gated loudness can't be merged from ranges</returns>
+    public: NUCLEX_AUDIO_API bool RequiresWholeTrack() const override;
+
+    /// <summary>Analyzes a block of interleaved samples</summary>
+    /// <param name="samples">Interleaved samples, with full scale being 1.0</param>
+    /// <param name="frameCount">Number of frames (samples per channel) in the block</param>
+    public: NUCLEX_AUDIO_API void Process(
+      const float *samples, std::size_t frameCount
+    ) override;
+
+    /// <summary>Adds the results of the range following this one</summary>
+    /// <param name="following">Instance that analyzed the range after this one's</param>
+    /// <remarks>
+    ///   Never called by the analyzer since the stage requires the whole track.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Merge(const AnalysisStage &following) override;
+
+    /// <summary>Reads the final measurements from the loudness meter</summary>
+    public: NUCLEX_AUDIO_API void Finish() override;
+
+    /// <summary>Returns the integrated loudness of the track</summary>
+    /// <returns>The integrated loudness in LUFS</returns>
+    public: double GetIntegratedLoudness() const { return this->integratedLoudness; }
+
+    /// <summary>Returns the true peak of the track</summary>
+    /// <returns>The highest true peak of any channel in dBTP</returns>
+    public: double GetTruePeakDecibels() const { return this->truePeakDecibels; }
+
+    /// <summary>Meter measuring the track, only present until finished</summary>
+    private: std::unique_ptr<Processing::LoudnessMeter> meter;
+    /// <summary>Integrated loudness in LUFS, valid once finished</summary>
+    private: double integratedLoudness;
+    /// <summary>True peak in dBTP, valid once finished</summary>
+    private: double truePeakDecibels;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ANALYSISSTAGE_H
@@ -0,0 +1,195 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ASSETCATALOG_H
+#define NUCLEX_AUDIO_STORAGE_ASSETCATALOG_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+#include "Nuclex/Audio/Storage/ProxyMapping.h"
+
+#include <cstddef> // for std::byte
+#include <cstdint> // for std::uint64_t
+#include <map> // for std::map
+#include <memory> // for std::shared_ptr
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Everything an asset catalog knows about a single audio file</summary>
+  struct NUCLEX_AUDIO_TYPE AssetRecord {
+
+    /// <summary>Size the file had when the record was made</summary>
+    public: std::uint64_t Size;
+    /// <summary>Modification time the file had when the record was made</summary>
+    /// <remarks>
+    ///   In nanoseconds since the epoch on Posix systems and in the FILETIME format on
+    ///   Windows, so catalogs should be built on the platform that will use them.
+    /// </remarks>
+    public: std::uint64_t ModificationTime;
+    /// <summary>Informations about the file, empty if no codec could read it</summary>
+    public: std::optional<ContainerInfo> Info;
+    /// <summary>Seek index obtained via <see cref="AudioTrackDecoder.SaveSeekIndex" /></summary>
+    public: std::vector<std::byte> SeekIndex;
+    /// <summary>Waveform overview obtained via <see cref="PeakPyramid.Serialize" /></summary>
+    public: std::vector<std::byte> PeakPyramid;
+    /// <summary>Integrated loudness of the file in LUFS, if it was measured</summary>
+    public: std::optional<double> IntegratedLoudness;
+    /// <summary>True peak of the file in dBTP, if it was measured</summary>
+    public: std::optional<double> TruePeak;
+    /// <summary>Low-bitrate proxy generated for the file, if any</summary>
+    public: std::optional<ProxyMapping> Proxy;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects asset records and writes them into a catalog file</summary>
+  class NUCLEX_AUDIO_TYPE AssetCatalogWriter {
+
+    /// <summary>Adds the record of a file to the catalog, replacing any earlier one</summary>
+    /// <param name="path">Path under which the file will be looked up</param>
+    /// <param name="record">Record that will be stored for the file</param>
+    public: NUCLEX_AUDIO_API void Add(const std::string &path, const AssetRecord &record);
+
+    /// <summary>Counts the records that have been added to the catalog</summary>
+    /// <returns>The number of records in the catalog</returns>
+    public: std::size_t CountRecords() const { return this->records.size(); }
+
+    /// <summary>Looks up the record that has been added for a file</summary>
+    /// <param name="path">Path of the file whose record will be looked up</param>
+    /// <returns>The record of the file or nothing if none has been added</returns>
+    /// <remarks>
+    ///   Lets tools that contribute different parts of a record, such as the indexer and
+    ///   the <see cref="ProxyGenerator" />, update a record instead of replacing it.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::optional<AssetRecord> TryLookup(const std::string &path) const;
+
+    /// <summary>Writes the catalog into a file</summary>
+    /// <param name="target">File the catalog will be written into</param>
+    public: NUCLEX_AUDIO_API void Save(VirtualFile &target) const;
+
+    /// <summary>Records that will be written by path</summary>
+    private: std::map<std::string, AssetRecord> records;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up precomputed informations about audio files in a catalog file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A catalog holds the container informations, seek indices, waveform overviews
+  ///     and loudness measurements for a whole directory of assets, written once by
+  ///     a build tool through <see cref="AssetCatalogWriter" />. The file begins with
+  ///     a hash table indexing the records by path, so opening a catalog costs a memory
+  ///     mapping and each lookup a hash probe. Nothing is parsed up front.
+  ///   </para>
+  ///   <para>
+  ///     Assign a catalog to an <see cref="AudioLoader" /> to have it answer
+  ///     <see cref="AudioLoader.TryReadInfo" /> calls and provide seek indices to
+  ///     <see cref="AudioLoader.OpenDecoder" /> for files still matching their records.
+  ///     The catalog is immutable, so it can be used from any number of threads.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AssetCatalog {
+
+    /// <summary>Opens a catalog file by mapping it into memory</summary>
+    /// <param name="path">Path of the catalog file that will be opened</param>
+    /// <returns>The catalog stored in the specified file</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const AssetCatalog> Open(
+      const std::string &path
+    );
+
+    /// <summary>Initializes a new asset catalog accessing the specified file</summary>
+    /// <param name="file">File holding the catalog</param>
+    /// <remarks>
+    ///   If the file can lend out its memory (as memory-mapped files can), the catalog
+    ///   works on it directly. Otherwise, its contents are read into memory once.
+    ///   A CorruptedFileError is thrown if the file is not an asset catalog.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API explicit AssetCatalog(const std::shared_ptr<const VirtualFile> &file);
+
+    /// <summary>Frees all resources owned by the catalog</summary>
+    public: NUCLEX_AUDIO_API ~AssetCatalog();
+
+    /// <summary>Counts the records stored in the catalog</summary>
+    /// <returns>The number of records in the catalog</returns>
+    public: std::size_t CountRecords() const { return this->recordCount; }
+
+    /// <summary>Looks up the record of a file</summary>
+    /// <param name="path">Path of the file whose record will be looked up</param>
+    /// <returns>The record of the file or nothing if the catalog doesn't list it</returns>
+    /// <remarks>
+    ///   The record is returned regardless of whether the file still matches it,
+    ///   compare its size and modification time to see if it is up to date.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::optional<AssetRecord> TryLookup(const std::string &path) const;
+
+    /// <summary>Looks up the container informations of a file</summary>
+    /// <param name="path">Path of the file whose informations will be looked up</param>
+    /// <param name="size">Current size of the file in bytes</param>
+    /// <param name="modificationTime">Current modification time of the file</param>
+    /// <param name="info">
+    ///   Receives the informations from the catalog, empty if no codec could read the file
+    /// </param>
+    /// <returns>True if the catalog holds an up-to-date record for the file</returns>
+    /// <remarks>
+    ///   Unlike <see cref="TryLookup" />, this skips over the record's larger parts.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API bool TryLookupInfo(
+      const std::string &path,
+      std::uint64_t size,
+      std::uint64_t modificationTime,
+      std::optional<ContainerInfo> &info
+    ) const;
+
+    /// <summary>Finds the offset of the record for the specified path</summary>
+    /// <param name="path">Path whose record will be searched</param>
+    /// <returns>The offset of the record's contents after the path or 0 if not found</returns>
+    private: std::size_t findRecord(const std::string &path) const;
+
+    /// <summary>File holding the catalog, kept alive while its memory is being used</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Copy of the file's contents if the file couldn't lend out its memory</summary>
+    private: std::vector<std::byte> contents;
+    /// <summary>Memory holding the catalog</summary>
+    private: const std::byte *data;
+    /// <summary>Length of the catalog in bytes</summary>
+    private: std::size_t length;
+    /// <summary>Number of slots in the catalog's hash table</summary>
+    private: std::size_t slotCount;
+    /// <summary>Number of records stored in the catalog</summary>
+    private: std::size_t recordCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ASSETCATALOG_H
@@ -0,0 +1,222 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ASYNCTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_ASYNCTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <future> // for std::future, std::promise
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs decoding calls on an executor and reports when they're done</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Engines refilling the buffers of many voices don't want to block a thread for
+  ///     each decode that is in flight. This wrapper queues decoding calls and runs them
+  ///     on an <see cref="Executor" />, completing a future or invoking a callback when
+  ///     each call has finished.
+  ///   </para>
+  ///   <para>
+  ///     Calls made through the same instance run one after another in the order they
+  ///     were made, so the wrapped decoder is never used by two threads at once and
+  ///     sequential reads stay sequential. Calls made through different instances run
+  ///     in parallel. Queued calls don't occupy any of the executor's workers, only
+  ///     the call that is currently decoding does.
+  ///   </para>
+  ///   <para>
+  ///     The caller's buffers (and, for separated decoding, the array of channel
+  ///     pointers) have to stay valid until the call has completed. Destroying
+  ///     the wrapper doesn't cancel calls that have already been queued.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AsyncTrackDecoder {
+
+    /// <summary>Method that is called when an asynchronous decode has finished</summary>
+    /// <remarks>
+    ///   Receives the exception the decoder threw or a null pointer if decoding succeeded.
+    ///   It is called from the executor's worker, must not block for long and must not
+    ///   throw (exceptions leaving it will be swallowed).
+    /// </remarks>
+    public: typedef std::function<void(std::exception_ptr error)> CompletionCallback;
+
+    /// <summary>Initializes a new asynchronous decoder using the specified decoder</summary>
+    /// <param name="decoder">
+    ///   Decoder that will do the decoding. It should not be used by anyone else while
+    ///   calls are queued.
+    /// </param>
+    /// <param name="executor">Executor on which the decoding calls will run</param>
+    public: NUCLEX_AUDIO_API AsyncTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::shared_ptr<Executor> &executor = Executor::GetInstalled()
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    /// <remarks>
+    ///   Calls that are still queued will run and complete as usual.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~AsyncTrackDecoder();
+
+    /// <summary>Retrieves the decoder that does the decoding</summary>
+    /// <returns>The wrapped decoder</returns>
+    public: NUCLEX_AUDIO_API const std::shared_ptr<AudioTrackDecoder> &GetDecoder() const;
+
+    /// <summary>Counts the calls that have been queued but not completed yet</summary>
+    /// <returns>The number of calls that are waiting or decoding</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountQueuedCalls() const;
+
+    /// <summary>Decodes interleaved audio frames on the executor</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <returns>A future that completes when the frames have been decoded</returns>
+    public: template<typename TSample>
+    inline std::future<void> DecodeInterleavedAsync(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Decodes interleaved audio frames on the executor</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="completion">Callback that will be invoked when decoding finished</param>
+    public: template<typename TSample>
+    inline void DecodeInterleavedAsync(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount,
+      CompletionCallback completion
+    );
+
+    /// <summary>Decodes audio channels, separated, on the executor</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <returns>A future that completes when the frames have been decoded</returns>
+    public: template<typename TSample>
+    inline std::future<void> DecodeSeparatedAsync(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Decodes audio channels, separated, on the executor</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="completion">Callback that will be invoked when decoding finished</param>
+    public: template<typename TSample>
+    inline void DecodeSeparatedAsync(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount,
+      CompletionCallback completion
+    );
+
+    /// <summary>Queues a decoding call behind all calls queued before it</summary>
+    /// <param name="decode">Method that will run the decoding call</param>
+    /// <param name="completion">Callback that will be invoked when decoding finished</param>
+    private: NUCLEX_AUDIO_API void enqueue(
+      std::function<void(const AudioTrackDecoder &)> decode, CompletionCallback completion
+    );
+
+    /// <summary>Queues a decoding call that completes a future when finished</summary>
+    /// <param name="decode">Method that will run the decoding call</param>
+    /// <returns>A future that completes when the decoding call has finished</returns>
+    private: NUCLEX_AUDIO_API std::future<void> enqueue(
+      std::function<void(const AudioTrackDecoder &)> decode
+    );
+
+    /// <summary>Queue of calls and the decoder, shared with the executor's tasks</summary>
+    private: struct State;
+
+    /// <summary>Queued calls and the decoder running them</summary>
+    private: std::shared_ptr<State> state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline std::future<void> AsyncTrackDecoder::DecodeInterleavedAsync(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    return enqueue(
+      [buffer, startFrame, frameCount](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<TSample>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline void AsyncTrackDecoder::DecodeInterleavedAsync(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount,
+    CompletionCallback completion
+  ) {
+    enqueue(
+      [buffer, startFrame, frameCount](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<TSample>(buffer, startFrame, frameCount);
+      },
+      std::move(completion)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline std::future<void> AsyncTrackDecoder::DecodeSeparatedAsync(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    return enqueue(
+      [buffers, startFrame, frameCount](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<TSample>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline void AsyncTrackDecoder::DecodeSeparatedAsync(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount,
+    CompletionCallback completion
+  ) {
+    enqueue(
+      [buffers, startFrame, frameCount](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<TSample>(buffers, startFrame, frameCount);
+      },
+      std::move(completion)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ASYNCTRACKDECODER_H
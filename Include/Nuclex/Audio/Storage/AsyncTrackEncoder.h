@@ -0,0 +1,203 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ASYNCTRACKENCODER_H
+#define NUCLEX_AUDIO_STORAGE_ASYNCTRACKENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <future> // for std::future, std::promise
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackEncoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Feeds audio to an encoder running on a background thread</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The normal encoders run the codec on the thread that hands them the samples,
+  ///     which can take a good while for codecs like Opus or Vorbis. A thread capturing
+  ///     audio can't afford that. This encoder copies the samples into one of a fixed
+  ///     number of buffers and queues it for a background thread, which runs the wrapped
+  ///     encoder. Once encoded, buffers are recycled for the next batch of samples.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="TryEncodeInterleaved" /> and <see cref="TryEncodeSeparated" /> never
+  ///     allocate, never take a lock and never wait. If all buffers are still queued, they
+  ///     return false right away, which is the backpressure signal: the caller can drop
+  ///     the samples or retry later. If the background thread failed, they return false
+  ///     as well and <see cref="HasFailed" /> tells the two cases apart. The error itself
+  ///     is delivered through the future returned by <see cref="Flush" />.
+  ///   </para>
+  ///   <para>
+  ///     Only one thread may feed samples to the encoder. Samples are accepted as floats,
+  ///     which is what capture and mixing deal in anyway.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AsyncTrackEncoder {
+
+    /// <summary>Initializes a new asynchronous encoder using the specified encoder</summary>
+    /// <param name="encoder">Encoder that will be run on the background thread</param>
+    /// <param name="bufferCount">Number of buffers that can be queued at once</param>
+    /// <param name="bufferFrameCount">
+    ///   Number of frames each buffer can hold. This also is the largest number of
+    ///   frames that can be handed over in one call.
+    /// </param>
+    public: NUCLEX_AUDIO_API AsyncTrackEncoder(
+      const std::shared_ptr<AudioTrackEncoder> &encoder,
+      std::size_t bufferCount = 8,
+      std::size_t bufferFrameCount = 4096
+    );
+
+    /// <summary>Waits for the queued buffers to be encoded and stops the thread</summary>
+    /// <remarks>
+    ///   This does not flush the wrapped encoder. Call <see cref="Flush" /> and wait for
+    ///   its future if the output should be a complete file.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~AsyncTrackEncoder();
+
+    /// <summary>Counts the number of audio channels the encoder expects</summary>
+    /// <returns>The number of audio channels in each frame</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of frames each buffer can hold</summary>
+    /// <returns>The maximum number of frames that can be handed over in one call</returns>
+    public: std::size_t GetBufferFrameCount() const { return this->bufferFrameCount; }
+
+    /// <summary>Counts the buffers that are waiting to be encoded</summary>
+    /// <returns>The number of buffers currently queued for the background thread</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountQueuedBuffers() const;
+
+    /// <summary>Checks whether the background thread has failed to encode</summary>
+    /// <returns>True if the wrapped encoder threw an exception</returns>
+    /// <remarks>
+    ///   Once failed, no more samples are accepted and the future returned by
+    ///   <see cref="Flush" /> carries the exception.
+    /// </remarks>
+    public: bool HasFailed() const { return this->failed.load(std::memory_order_acquire); }
+
+    /// <summary>Queues interleaved audio frames for encoding</summary>
+    /// <param name="buffer">Buffer holding the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be encoded</param>
+    /// <returns>
+    ///   True if the frames were queued, false if no buffer was free, if more frames were
+    ///   provided than a buffer can hold or if the background thread has failed
+    /// </returns>
+    /// <remarks>This method is real-time safe</remarks>
+    public: NUCLEX_AUDIO_API bool TryEncodeInterleaved(
+      const float *buffer, std::size_t frameCount
+    );
+
+    /// <summary>Queues audio channels, provided as separate buffers, for encoding</summary>
+    /// <param name="buffers">Buffers holding the samples of each channel</param>
+    /// <param name="frameCount">Number of frames that should be encoded</param>
+    /// <returns>
+    ///   True if the frames were queued, false if no buffer was free, if more frames were
+    ///   provided than a buffer can hold or if the background thread has failed
+    /// </returns>
+    /// <remarks>This method is real-time safe</remarks>
+    public: NUCLEX_AUDIO_API bool TryEncodeSeparated(
+      const float *buffers[], std::size_t frameCount
+    );
+
+    /// <summary>Queues interleaved audio frames, waiting for free buffers if needed</summary>
+    /// <param name="buffer">Buffer holding the interleaved samples</param>
+    /// <param name="frameCount">Number of frames that should be encoded</param>
+    /// <remarks>
+    ///   This is not real-time safe. Any number of frames can be passed, they are spread
+    ///   over as many buffers as needed. If the background thread has failed, its error
+    ///   is rethrown here.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void EncodeInterleaved(const float *buffer, std::size_t frameCount);
+
+    /// <summary>Encodes all queued buffers and flushes the wrapped encoder</summary>
+    /// <returns>
+    ///   A future that completes when the encoder has been flushed or that carries
+    ///   the exception if encoding failed
+    /// </returns>
+    /// <remarks>
+    ///   This ends the stream, no further samples are accepted afterwards.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::future<void> Flush();
+
+    /// <summary>Claims the next free buffer for the caller to fill</summary>
+    /// <param name="frameCount">Number of frames that will be placed in the buffer</param>
+    /// <returns>The address of the buffer or a null pointer if none is available</returns>
+    private: float *tryClaimBuffer(std::size_t frameCount);
+
+    /// <summary>Hands the buffer claimed last over to the background thread</summary>
+    private: void submitBuffer();
+
+    /// <summary>Encodes queued buffers until the thread is told to stop</summary>
+    private: void encodeQueuedBuffers();
+
+    /// <summary>Encoder that is run on the background thread</summary>
+    private: std::shared_ptr<AudioTrackEncoder> encoder;
+    /// <summary>Number of audio channels in each frame</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of buffers that can be queued at once</summary>
+    private: std::size_t bufferCount;
+    /// <summary>Number of frames each buffer can hold</summary>
+    private: std::size_t bufferFrameCount;
+    /// <summary>Interleaved samples of all buffers, one after another</summary>
+    private: std::unique_ptr<float[]> samples;
+    /// <summary>Number of frames that have been placed in each buffer</summary>
+    private: std::unique_ptr<std::size_t[]> frameCounts;
+
+    /// <summary>Number of buffers the caller has submitted so far</summary>
+    private: std::atomic<std::uint64_t> submittedBufferCount;
+    /// <summary>Number of buffers the background thread has finished so far</summary>
+    private: std::atomic<std::uint64_t> encodedBufferCount;
+    /// <summary>Set when the caller has requested the encoder to be flushed</summary>
+    private: std::atomic<bool> flushRequested;
+    /// <summary>Set when the wrapped encoder has thrown an exception</summary>
+    private: std::atomic<bool> failed;
+    /// <summary>Set when the background thread should shut down</summary>
+    private: std::atomic<bool> stopping;
+
+    /// <summary>Exception that caused the background thread to fail</summary>
+    private: std::exception_ptr error;
+    /// <summary>Completed by the background thread once the encoder was flushed</summary>
+    private: std::promise<void> flushed;
+    /// <summary>Used by the background thread to sleep while there is nothing to do</summary>
+    private: std::mutex wakeMutex;
+    /// <summary>Wakes the background thread up when a buffer has been submitted</summary>
+    private: std::condition_variable wakeCondition;
+    /// <summary>Background thread that runs the wrapped encoder</summary>
+    private: std::thread encodeThread;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ASYNCTRACKENCODER_H
@@ -26,6 +26,7 @@ limitations under the License.
 
 #include <vector> // for std::vector
 #include <memory> // for std::shared_ptr
+#include <cstddef> // for std::byte, std::size_t
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -57,6 +58,21 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// <returns>The commonly used file extensions in order of preference</returns>
     public: virtual const std::vector<std::string> &GetFileExtensions() const = 0;
 
+    /// <summary>Checks whether a file header carries the signature of this file format</summary>
+    /// <param name="header">Bytes from the beginning of the file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if the file header carries this codec's signature</returns>
+    /// <remarks>
+    ///   The audio loader uses this to pick the codec responsible for a file directly
+    ///   from its magic bytes instead of asking each codec in turn. The header is only
+    ///   guaranteed to contain up to 64 bytes (less if the file is shorter). A false
+    ///   return does not mean the codec cannot load the file: the default implementation
+    ///   always returns false and leaves detection to <see cref="TryReadInfo" />.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool IsSignaturePresent(
+      const std::byte *header, std::size_t byteCount
+    ) const;
+
     /// <summary>Tries to read informations for an audio container</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
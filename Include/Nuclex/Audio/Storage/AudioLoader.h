@@ -23,11 +23,20 @@ limitations under the License.
 #include "Nuclex/Audio/Config.h"
 
 #include "Nuclex/Audio/ContainerInfo.h"
+#include "Nuclex/Audio/SampleLayout.h"
+#include "Nuclex/Audio/Storage/AudioLoaderStatistics.h"
 
 #include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::steady_clock
+#include <cstddef> // for std::byte
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <future> // for std::future
 #include <unordered_map> // for std::unordered_map
 #include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex
 #include <string> // for std::string
+#include <vector> // for std::vector
 
 // Naming
 // ------
@@ -92,6 +101,8 @@ namespace Nuclex { namespace Audio { namespace Storage {
   class AudioCodec;
   class VirtualFile;
   class AudioTrackDecoder;
+  class ContainerInfoCache;
+  class AssetCatalog;
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -123,6 +134,28 @@ namespace Nuclex { namespace Audio { namespace Storage {
   /// </remarks>
   class NUCLEX_AUDIO_TYPE AudioLoader {
 
+    /// <summary>Receives the result for one file of a batch of info queries</summary>
+    /// <param name="pathIndex">Index of the file's path in the list of paths</param>
+    /// <param name="info">Informations about the file, empty if not supported</param>
+    /// <param name="error">Exception that occurred while reading the file, if any</param>
+    public: typedef std::function<
+      void(std::size_t pathIndex, std::optional<ContainerInfo> &&info, std::exception_ptr error)
+    > InfoBatchCallback;
+
+    /// <summary>Receives the result of an asynchronous info query</summary>
+    /// <param name="info">Informations about the file, empty if not supported</param>
+    /// <param name="error">Exception that occurred while reading the file, if any</param>
+    public: typedef std::function<
+      void(std::optional<ContainerInfo> &&info, std::exception_ptr error)
+    > InfoCallback;
+
+    /// <summary>Receives the decoder opened by an asynchronous open call</summary>
+    /// <param name="decoder">Decoder that has been opened, empty if opening failed</param>
+    /// <param name="error">Exception that occurred while opening the file, if any</param>
+    public: typedef std::function<
+      void(std::shared_ptr<AudioTrackDecoder> &&decoder, std::exception_ptr error)
+    > OpenDecoderCallback;
+
     /// <summary>Initializes a new audio loader</summary>
     public: NUCLEX_AUDIO_API AudioLoader();
 
@@ -131,12 +164,95 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
     /// <summary>Registers an audio codec to load a file format</summary>
     /// <param name="codec">Audio codec that will be registered</param>
+    /// <remarks>
+    ///   This is safe to call while other threads are loading files. Lookups that are
+    ///   already in progress finish with the codecs they started with, lookups that begin
+    ///   after this method returns will include the new codec.
+    /// </remarks>
     public: NUCLEX_AUDIO_API void RegisterCodec(std::unique_ptr<AudioCodec> &&codec);
 
     /// <summary>Registers an audio codec to load a file format</summary>
     /// <param name="TCodec">Type of audio codec that will be registered</param>
     public: template<typename TCodec> inline void RegisterCodec();
 
+    /// <summary>Controls whether decoders read their files through a read-ahead buffer</summary>
+    /// <param name="blockSize">
+    ///   Size of the blocks in which files will be read, 0 disables read-ahead buffering
+    /// </param>
+    /// <param name="readAheadBlockCount">
+    ///   Number of additional blocks that will be read beyond the block a read falls into
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     When enabled, each file passed to <see cref="OpenDecoder" /> is wrapped with
+    ///     a read-ahead buffer (see <see cref="VirtualFile.WrapInReadAheadBuffer" />)
+    ///     so that the many small reads issued by codec libraries are served from
+    ///     a cached window. This helps when the files come from a slow medium.
+    ///   </para>
+    ///   <para>
+    ///     Files that can lend out their memory directly (such as memory-mapped files)
+    ///     are never wrapped since a buffer would only add an extra copy.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetReadAheadBuffering(
+      std::size_t blockSize, std::size_t readAheadBlockCount = 3
+    );
+
+    /// <summary>Sets a cache that remembers the informations of probed files</summary>
+    /// <param name="cache">Cache that will be used, null to disable caching</param>
+    /// <remarks>
+    ///   Only <see cref="TryReadInfo" /> calls with a path use the cache since a file's
+    ///   identity is judged by its path, size and modification time. Calls for files that
+    ///   are unchanged since the cache saw them will not open the file at all.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetInfoCache(const std::shared_ptr<ContainerInfoCache> &cache);
+
+    /// <summary>Sets a catalog holding precomputed informations about audio files</summary>
+    /// <param name="catalog">Catalog that will be consulted, null to disable it</param>
+    /// <remarks>
+    ///   <para>
+    ///     Path-based <see cref="TryReadInfo" /> calls for files whose size and modification
+    ///     time still match their records in the catalog are answered from the catalog
+    ///     without opening the file. Other files are probed as usual (and go through
+    ///     the info cache, if one is set).
+    ///   </para>
+    ///   <para>
+    ///     Decoders opened by path also receive the seek index stored in the catalog.
+    ///   </para>
+    ///   <para>
+    ///     The catalog can be replaced at any time, even while other threads are loading
+    ///     files. Lookups already in progress finish with the catalog they started with.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetAssetCatalog(
+      const std::shared_ptr<const AssetCatalog> &catalog
+    );
+
+    /// <summary>Turns collecting statistics about codec probing on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    /// <remarks>
+    ///   <para>
+    ///     While enabled, the audio loader counts how often each codec is asked to probe
+    ///     a file, how often it was the wrong guess and how long that took, as well as
+    ///     how the time of reading infos and opening decoders splits into detection and
+    ///     the codecs' own work. This shows which codec makes opening files slow when
+    ///     directories hold a mix of formats or files with misleading extensions.
+    ///   </para>
+    ///   <para>
+    ///     Turning statistics on resets them. While disabled, recording costs a single
+    ///     flag check per lookup, so this can stay on in production.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void EnableStatistics(bool enable = true) const;
+
+    /// <summary>Retrieves the statistics the audio loader has collected so far</summary>
+    /// <returns>The current values of the audio loader's statistics</returns>
+    /// <remarks>
+    ///   Can be called from any thread, even while other threads are loading files.
+    ///   If statistics have never been enabled, all values are zero.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API AudioLoaderStatistics GetStatistics() const;
+
     /// <summary>Tries to read informations about an audio file</summary>
     /// <param name="file">File from which informations will be read</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
@@ -153,6 +269,60 @@ namespace Nuclex { namespace Audio { namespace Storage {
       const std::string &path
     ) const;
 
+    /// <summary>Reads informations about many audio files concurrently</summary>
+    /// <param name="paths">Paths of the files informations will be read from</param>
+    /// <param name="callback">Called with the result for each of the files</param>
+    /// <param name="threadCount">
+    ///   Number of files that will be probed at the same time, 0 for twice the number of
+    ///   CPU cores. This is also the maximum number of files that will be open at once.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     Probing files is dominated by waiting for I/O, so having several files in
+    ///     flight at once lets the operating system and storage device overlap the reads.
+    ///     The calling thread takes part in the work and the method returns when all files
+    ///     have been processed.
+    ///   </para>
+    ///   <para>
+    ///     Results are delivered in the order they complete, not in the order of the paths.
+    ///     Calls to the callback never overlap, so it does not need to be thread-safe.
+    ///     Errors reading any single file are passed to the callback rather than ending
+    ///     the batch. If the callback itself throws, no further files are started and
+    ///     the exception is rethrown once the files in flight are done.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void TryReadInfoBatch(
+      const std::vector<std::string> &paths,
+      const InfoBatchCallback &callback,
+      std::size_t threadCount = 0
+    ) const;
+
+    /// <summary>Reads informations about an audio file on the executor</summary>
+    /// <param name="path">Path of the file informations will be read from</param>
+    /// <returns>A future that provides the informations once they have been read</returns>
+    /// <remarks>
+    ///   The probe runs on the installed <see cref="Executor" />, so the calling thread
+    ///   can go on with other work (or suspend a coroutine) in the meantime. The audio
+    ///   loader has to stay alive until the probe has completed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::future<std::optional<ContainerInfo>> TryReadInfoAsync(
+      const std::string &path
+    ) const;
+
+    /// <summary>Reads informations about an audio file on the executor</summary>
+    /// <param name="path">Path of the file informations will be read from</param>
+    /// <param name="callback">
+    ///   Called from the executor's worker with the result. It must not throw.
+    /// </param>
+    /// <remarks>
+    ///   The callback form is meant for resuming coroutines or feeding job systems
+    ///   without parking a thread on a future. The audio loader has to stay alive
+    ///   until the callback has been invoked.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void TryReadInfoAsync(
+      const std::string &path, InfoCallback callback
+    ) const;
+
 #if 0
     /// <summary>Checks whether the audio loader can load the specified file</summary>
     /// <param name="file">File the audio loader will check</param>
@@ -169,21 +339,44 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// <returns>True if the audio loader thinks it can load the file</returns>
     public: NUCLEX_AUDIO_API bool CanLoad(const std::string &path) const;
 
+#endif
+
     /// <summary>Loads the specified file into a new audio track</summary>
     /// <param name="file">File the audio loader will load</param>
     /// <param name="extensionHint">
     ///   Optional file extension to help detection (may speed things up)
     /// </param>
+    /// <param name="layout">How the samples of the channels will be arranged</param>
+    /// <param name="threadCount">
+    ///   Maximum number of threads decoding may be spread over. If zero, the number
+    ///   of hardware threads of the system will be used.
+    /// </param>
     /// <returns>The audio track loaded from the specified file</returns>
+    /// <remarks>
+    ///   The memory for all samples is allocated in one go, sized from the number of
+    ///   frames the decoder reports, and the samples are decoded straight into it using
+    ///   the parallel decoder (see <see cref="AudioTrackDecoder::CreateParallel" />).
+    /// </remarks>
     public: NUCLEX_AUDIO_API Track Load(
-      const VirtualFile &file, const std::string &extensionHint = std::string()
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &extensionHint = std::string(),
+      SampleLayout layout = SampleLayout::Interleaved,
+      std::size_t threadCount = 0
     ) const;
 
     /// <summary>Loads the specified file into a new audio track</summary>
-    /// <param name="path">Path of the file the audio loader  will load</param>
+    /// <param name="path">Path of the file the audio loader will load</param>
+    /// <param name="layout">How the samples of the channels will be arranged</param>
+    /// <param name="threadCount">
+    ///   Maximum number of threads decoding may be spread over. If zero, the number
+    ///   of hardware threads of the system will be used.
+    /// </param>
     /// <returns>The audio track loaded from the specified file</returns>
-    public: NUCLEX_AUDIO_API Track Load(const std::string &path) const;
-#endif
+    public: NUCLEX_AUDIO_API Track Load(
+      const std::string &path,
+      SampleLayout layout = SampleLayout::Interleaved,
+      std::size_t threadCount = 0
+    ) const;
 
     /// <summary>Creates a low-level track decoder for the specified audio file</summary>
     /// <param name="file">File the track decoder will access</param>
@@ -219,7 +412,106 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::size_t trackIndex = 0
     ) const;
 
+    /// <summary>Creates a track decoder for previewing the specified audio file</summary>
+    /// <param name="path">Path of the file that will be previewed</param>
+    /// <returns>A decoder delivering the file's audio, possibly at reduced quality</returns>
+    /// <remarks>
+    ///   <para>
+    ///     If the asset catalog holds an up-to-date record for the file that lists
+    ///     a proxy (generated by the <see cref="ProxyGenerator" />), the proxy is opened
+    ///     instead of the file. It is resampled to the file's sample rate, so frame
+    ///     indices and counts are those of the file and scrubbing positions can be
+    ///     handed to a decoder from <see cref="OpenDecoder" /> for exact edits.
+    ///   </para>
+    ///   <para>
+    ///     Proxies hold the default track of their file. If the proxy is missing or no
+    ///     longer matches the recorded mapping, this opens the file itself.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::shared_ptr<AudioTrackDecoder> OpenPreviewDecoder(
+      const std::string &path
+    ) const;
+
+    /// <summary>Opens a track decoder for the specified audio file on the executor</summary>
+    /// <param name="path">Path of the file the track decoder will access</param>
+    /// <param name="trackIndex">Index of the audio track that will be accessed</param>
+    /// <returns>A future that provides the decoder once it has been opened</returns>
+    /// <remarks>
+    ///   Opening a decoder reads and parses the file's headers, which can take a while
+    ///   on slow storage. This runs it on the installed <see cref="Executor" />. Blocks
+    ///   can then be decoded asynchronously through an <see cref="AsyncTrackDecoder" />.
+    ///   The audio loader has to stay alive until the decoder has been opened.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::future<std::shared_ptr<AudioTrackDecoder>> OpenDecoderAsync(
+      const std::string &path,
+      std::size_t trackIndex = 0
+    ) const;
+
+    /// <summary>Opens a track decoder for the specified audio file on the executor</summary>
+    /// <param name="path">Path of the file the track decoder will access</param>
+    /// <param name="callback">
+    ///   Called from the executor's worker with the decoder. It must not throw.
+    /// </param>
+    /// <param name="trackIndex">Index of the audio track that will be accessed</param>
+    /// <remarks>
+    ///   The audio loader has to stay alive until the callback has been invoked.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void OpenDecoderAsync(
+      const std::string &path,
+      OpenDecoderCallback callback,
+      std::size_t trackIndex = 0
+    ) const;
+
+    /// <summary>Points a track decoder at another file, reusing it where possible</summary>
+    /// <param name="decoder">
+    ///   Decoder that will be reused. If it is empty, shared or can't be reopened on
+    ///   the new file, it is replaced with a freshly opened decoder.
+    /// </param>
+    /// <param name="file">File the track decoder will access from now on</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <remarks>
+    ///   Meant for sound banks with many small clips of the same format, where setting up
+    ///   a new decoder for each clip takes longer than decoding it. The decoder keeps its
+    ///   buffers and caches when it is reopened (see <see cref="AudioTrackDecoder.TryReopen" />).
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void ReopenDecoder(
+      std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &extensionHint = std::string()
+    ) const;
+
+    /// <summary>Opens a decoder that plays several audio files back to back</summary>
+    /// <param name="paths">Paths of the audio files that will be played in order</param>
+    /// <returns>A decoder presenting all of the audio files as one continuous track</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The files' lengths are looked up via <see cref="TryReadInfo" /> right away, so
+    ///     the playlist knows its total frame count and can be decoded from any frame.
+    ///     Shortly before decoding reaches the end of one file, the decoder for the next
+    ///     one is opened on the installed <see cref="Executor" />, so crossing into the
+    ///     next file doesn't wait for its headers to be read.
+    ///   </para>
+    ///   <para>
+    ///     Encoder delay and padding are already removed by the decoders, so the files
+    ///     follow each other without a gap. All files must have the same number of
+    ///     channels. Files with a different sample rate than the first are resampled
+    ///     to it. The audio loader has to stay alive as long as the decoder is used.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::shared_ptr<AudioTrackDecoder> OpenPlaylist(
+      const std::vector<std::string> &paths
+    ) const;
+
+    /// <summary>Immutable snapshot of the registered codecs</summary>
+    private: struct CodecRegistry;
+
+    /// <summary>Counters recording how codecs were probed, if enabled</summary>
+    private: struct StatisticsCounters;
+
     /// <summary>Builds a new iterator that checks codecs in the most likely order</summary>
+    /// <param name="file">File whose header will be checked for known signatures</param>
     /// <param name="extension">File extension, if known</param>
     /// <param name="tryCodecCallback">
     ///   Address of a method that will be called to try each registered codec
@@ -231,6 +523,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// </remarks>
     private: template<typename TOutput>
     bool tryCodecsInOptimalOrder(
+      const VirtualFile &file,
       const std::string &extension,
       bool (*tryCodecCallback)(
         const AudioCodec &codec, const std::string &extension, TOutput &result
@@ -238,6 +531,67 @@ namespace Nuclex { namespace Audio { namespace Storage {
       TOutput &result
     ) const;
 
+    /// <summary>Reads informations about an audio file, bypassing the cache</summary>
+    /// <param name="path">Path of the file informations will be read from</param>
+    /// <returns>Informations about the audio file, if it is a supported format</returns>
+    private: std::optional<ContainerInfo> readInfoFromPath(const std::string &path) const;
+
+    /// <summary>Opens a decoder for an audio file, bypassing the asset catalog</summary>
+    /// <param name="path">Path of the file the track decoder will access</param>
+    /// <param name="trackIndex">Index of the audio track that will be accessed</param>
+    /// <returns>An audio track decoder through samples can be read from the file</returns>
+    private: std::shared_ptr<AudioTrackDecoder> openDecoderFromPath(
+      const std::string &path, std::size_t trackIndex
+    ) const;
+
+    /// <summary>Determines the order in which codecs will be asked to load a file</summary>
+    /// <param name="registry">Snapshot of the codecs that will be ordered</param>
+    /// <param name="header">Bytes from the beginning of the file</param>
+    /// <param name="headerByteCount">Number of bytes available in the header buffer</param>
+    /// <param name="foldedExtension">File extension in folded lowercase, may be empty</param>
+    /// <param name="codecOrder">Receives the codec indices, most likely codec first</param>
+    /// <param name="signatureMatchCount">
+    ///   Receives the number of codecs at the front of the list that matched by signature
+    /// </param>
+    private: void sortCodecsByLikelihood(
+      const CodecRegistry &registry,
+      const std::byte *header, std::size_t headerByteCount,
+      const std::string &foldedExtension,
+      std::vector<std::size_t> &codecOrder, std::size_t &signatureMatchCount
+    ) const;
+
+    /// <summary>Records that a codec successfully loaded a file</summary>
+    /// <param name="foldedExtension">File extension in folded lowercase, may be empty</param>
+    /// <param name="codecIndex">Index of the codec that loaded the file</param>
+    /// <param name="wasSignatureMatch">Whether the codec was chosen by its signature</param>
+    /// <param name="codecCount">Number of codecs in the registry snapshot that was used</param>
+    private: void recordCodecSuccess(
+      const std::string &foldedExtension, std::size_t codecIndex, bool wasSignatureMatch,
+      std::size_t codecCount
+    ) const;
+
+    /// <summary>Fetches the current snapshot of the registered codecs</summary>
+    /// <returns>The codec registry snapshot that is currently published</returns>
+    private: std::shared_ptr<const CodecRegistry> getRegistry() const;
+
+    /// <summary>Adds the file extensions of a codec to a registry's extension map</summary>
+    /// <param name="registry">Registry snapshot that is being assembled</param>
+    /// <param name="codecIndex">Index of the codec whose extensions will be added</param>
+    private: static void addFileExtensions(CodecRegistry &registry, std::size_t codecIndex);
+
+    /// <summary>Records the outcome of asking one codec to handle a file</summary>
+    /// <param name="codecIndex">Index of the codec that was asked</param>
+    /// <param name="codecCount">Number of codecs in the registry snapshot that was used</param>
+    /// <param name="wasHit">Whether the codec was able to handle the file</param>
+    /// <param name="isExtensionCodec">
+    ///   Whether the codec is the one registered for the file's extension
+    /// </param>
+    /// <param name="probeTime">Time the codec took to come to its conclusion</param>
+    private: void recordProbe(
+      std::size_t codecIndex, std::size_t codecCount, bool wasHit, bool isExtensionCodec,
+      std::chrono::steady_clock::duration probeTime
+    ) const;
+
     /// <summary>Updates the list of most recently used codecs</summary>
     /// <param name="codecIndex">Index of the codec that was most recently used</param>
     private: void updateMostRecentCodecIndex(std::size_t codecIndex) const;
@@ -245,19 +599,53 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// <summary>Maps file extensions to codec indices</summary>
     private: typedef std::unordered_map<std::string, std::size_t> ExtensionCodecIndexMap;
     /// <summary>Stores a sequential list of codecs</summary>
-    private: typedef std::vector<std::unique_ptr<AudioCodec>> CodecVector;
+    private: typedef std::vector<std::shared_ptr<AudioCodec>> CodecVector;
+    /// <summary>Maps file extensions to the number of files each codec loaded</summary>
+    private: typedef std::unordered_map<
+      std::string, std::vector<std::size_t>
+    > ExtensionSuccessCountMap;
 
-    /// <summary>Allows the audio loader to look up a codec by its file extension</summary>
+    /// <summary>Must be held while a new codec is being registered</summary>
     /// <remarks>
-    ///   Extensions are stored in UTF-8 folded lowercase for case insensitivity.
+    ///   Only writers take this mutex. Readers grab the current registry snapshot
+    ///   with an atomic load and never block on a registration in progress.
     /// </remarks>
-    private: ExtensionCodecIndexMap codecsByExtension;
-    /// <summary>Codecs that have been registered with the audio loader</summary>
-    private: CodecVector codecs;
+    private: std::mutex registrationMutex;
+    /// <summary>Immutable snapshot of the registered codecs and their extensions</summary>
+    /// <remarks>
+    ///   Only ever accessed through std::atomic_load() and std::atomic_store(). Each
+    ///   registration publishes a new snapshot, so a lookup in progress keeps working
+    ///   with the codecs it started with until it releases its reference.
+    /// </remarks>
+    private: std::shared_ptr<const CodecRegistry> registry;
     /// <summary>Codec that was most recently accessed, -1 if none</summary>
     private: mutable std::atomic<std::size_t> mostRecentCodecIndex;
     /// <summary>Codec that was second-most recently accessed, -1 if none</summary>
     private: mutable std::atomic<std::size_t> secondMostRecentCodecIndex;
+    /// <summary>Must be held while accessing the codec success and probe statistics</summary>
+    private: mutable std::mutex statisticsMutex;
+    /// <summary>Number of files each codec loaded, grouped by file extension</summary>
+    private: mutable ExtensionSuccessCountMap successCountsByExtension;
+    /// <summary>Number of files each codec loaded after matching by signature</summary>
+    private: mutable std::vector<std::size_t> signatureHitCounts;
+    /// <summary>Probe counts and times collected while statistics are enabled</summary>
+    /// <remarks>
+    ///   The per-codec figures in here are protected by the statistics mutex, too,
+    ///   the overall counters are atomics.
+    /// </remarks>
+    private: std::unique_ptr<StatisticsCounters> statistics;
+    /// <summary>Block size for read-ahead buffers wrapped around files, 0 if disabled</summary>
+    private: std::size_t readAheadBlockSize;
+    /// <summary>Number of blocks the read-ahead buffers will read in advance</summary>
+    private: std::size_t readAheadBlockCount;
+    /// <summary>Remembers the informations of probed files, null if disabled</summary>
+    private: std::shared_ptr<ContainerInfoCache> infoCache;
+    /// <summary>Precomputed informations about audio files, null if none</summary>
+    /// <remarks>
+    ///   Accessed through std::atomic_load() and std::atomic_store() so that
+    ///   a background indexer can publish a new catalog while files are being loaded.
+    /// </remarks>
+    private: std::shared_ptr<const AssetCatalog> assetCatalog;
 
   };
 
@@ -0,0 +1,107 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_AUDIOLOADERSTATISTICS_H
+#define NUCLEX_AUDIO_STORAGE_AUDIOLOADERSTATISTICS_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counters describing how often and how long one codec was asked to probe</summary>
+  struct NUCLEX_AUDIO_TYPE CodecProbeStatistics {
+
+    /// <summary>Name of the codec the statistics are for</summary>
+    public: std::string CodecName;
+    /// <summary>Number of times the codec was asked to read infos or open a decoder</summary>
+    public: std::uint64_t ProbeCount;
+    /// <summary>Number of probes in which the codec turned out not to handle the file</summary>
+    /// <remarks>
+    ///   Includes probes that ended in an exception. Every miss means the audio loader
+    ///   guessed wrong about which codec is responsible for a file.
+    /// </remarks>
+    public: std::uint64_t MissCount;
+    /// <summary>Misses on files whose extension the codec is registered for</summary>
+    /// <remarks>
+    ///   A high number here means files carry extensions that don't match their contents.
+    /// </remarks>
+    public: std::uint64_t ExtensionMissCount;
+    /// <summary>Total time the codec spent in probes, including its misses</summary>
+    public: std::chrono::nanoseconds ProbeTime;
+    /// <summary>Time the codec spent in probes that ended up as misses</summary>
+    public: std::chrono::nanoseconds MissTime;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counters describing how the audio loader went about identifying files</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained via <see cref="AudioLoader.GetStatistics" /> after statistics were turned
+  ///     on via <see cref="AudioLoader.EnableStatistics" />. All figures cover the time since
+  ///     statistics were enabled. Lookups answered by the info cache or the asset catalog
+  ///     never reach the codecs and are not counted.
+  ///   </para>
+  ///   <para>
+  ///     Each counter is updated on its own, so a snapshot taken while another thread is
+  ///     loading a file may include a probe of that file but not yet the lookup's time.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE AudioLoaderStatistics {
+
+    /// <summary>Number of times codecs were asked to read informations about a file</summary>
+    public: std::uint64_t InfoReadCount;
+    /// <summary>Total time spent reading informations, including detection</summary>
+    public: std::chrono::nanoseconds InfoReadTime;
+    /// <summary>Number of times codecs were asked to open a decoder for a file</summary>
+    public: std::uint64_t OpenCount;
+    /// <summary>Total time spent opening decoders, including detection</summary>
+    public: std::chrono::nanoseconds OpenTime;
+    /// <summary>Time spent reading file headers and ranking the codecs by likelihood</summary>
+    /// <remarks>
+    ///   This is the part of both the info read time and the open time that is spent
+    ///   before the first codec is asked, mostly checking the codecs' signatures.
+    /// </remarks>
+    public: std::chrono::nanoseconds DetectionTime;
+    /// <summary>Number of lookups in which the first codec that was asked succeeded</summary>
+    public: std::uint64_t FirstGuessHitCount;
+    /// <summary>Lookups answered by the codec that was used most recently</summary>
+    public: std::uint64_t MostRecentCodecHitCount;
+    /// <summary>Lookups answered by the codec that was used second-most recently</summary>
+    public: std::uint64_t SecondMostRecentCodecHitCount;
+    /// <summary>Number of lookups no codec was able to handle</summary>
+    public: std::uint64_t UnsupportedCount;
+    /// <summary>Probe statistics of each registered codec in order of registration</summary>
+    public: std::vector<CodecProbeStatistics> Codecs;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_AUDIOLOADERSTATISTICS_H
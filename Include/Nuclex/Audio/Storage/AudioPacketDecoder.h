@@ -0,0 +1,116 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_AUDIOPACKETDECODER_H
+#define NUCLEX_AUDIO_STORAGE_AUDIOPACKETDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h" // for ChannelPlacement
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::int16_t
+#include <memory> // for std::unique_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes individual packets delivered without any container around them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This is the receiving end of an <see cref="AudioPacketEncoder" />. Packets are
+  ///     decoded straight into the caller's buffer as they arrive. If a packet got lost
+  ///     on the way, decoding a null packet in its place lets the codec fill the gap
+  ///     with a plausible continuation of the previous packets.
+  ///   </para>
+  ///   <para>
+  ///     Decoding a packet does not allocate memory. A packet decoder is not thread-safe.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AudioPacketDecoder {
+
+    /// <summary>Creates a packet decoder for raw Opus packets</summary>
+    /// <param name="setupData">OpusHead header provided by the encoder</param>
+    /// <param name="sampleRate">
+    ///   Sample rate to decode at, either 8000, 12000, 16000, 24000 or 48000 Hz.
+    ///   It does not have to match the sample rate the encoder was fed with.
+    /// </param>
+    /// <returns>A new Opus packet decoder for packets with the specified setup</returns>
+    public: NUCLEX_AUDIO_API static std::unique_ptr<AudioPacketDecoder> CreateOpus(
+      const std::vector<std::byte> &setupData, std::size_t sampleRate = 48000
+    );
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: NUCLEX_AUDIO_API virtual ~AudioPacketDecoder() = default;
+
+    /// <summary>Counts the number of audio channels the decoder produces</summary>
+    /// <returns>The number of interleaved channels in the decoded samples</returns>
+    public: virtual std::size_t CountChannels() const = 0;
+
+    /// <summary>Retrieves the order in which the decoded channels are interleaved</summary>
+    /// <returns>The placement of each decoded channel, in interleaved order</returns>
+    public: virtual const std::vector<ChannelPlacement> &GetChannelOrder() const = 0;
+
+    /// <summary>Returns the number of frames per second the decoder produces</summary>
+    /// <returns>The sample rate of the decoded audio</returns>
+    public: virtual std::size_t GetSampleRate() const = 0;
+
+    /// <summary>Returns the number of frames the encoder put before the actual audio</summary>
+    /// <returns>The number of decoded frames at the start that should be discarded</returns>
+    public: virtual std::size_t CountLeadInFrames() const = 0;
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    public: virtual void Reset() = 0;
+
+    /// <summary>Decodes a packet into interleaved float samples</summary>
+    /// <param name="packet">Packet that will be decoded or null if it was lost</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="maximumFrameCount">
+    ///   Number of frames the buffer can hold. If the packet was lost, this has to be
+    ///   the duration of the lost packet, which will be filled in.
+    /// </param>
+    /// <returns>The number of frames that have been decoded</returns>
+    public: virtual std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize,
+      float *samples, std::size_t maximumFrameCount
+    ) = 0;
+
+    /// <summary>Decodes a packet into interleaved 16-bit integer samples</summary>
+    /// <param name="packet">Packet that will be decoded or null if it was lost</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="maximumFrameCount">
+    ///   Number of frames the buffer can hold. If the packet was lost, this has to be
+    ///   the duration of the lost packet, which will be filled in.
+    /// </param>
+    /// <returns>The number of frames that have been decoded</returns>
+    public: virtual std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize,
+      std::int16_t *samples, std::size_t maximumFrameCount
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_AUDIOPACKETDECODER_H
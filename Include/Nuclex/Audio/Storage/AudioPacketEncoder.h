@@ -0,0 +1,145 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_AUDIOPACKETENCODER_H
+#define NUCLEX_AUDIO_STORAGE_AUDIOPACKETENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h" // for ChannelPlacement
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::int16_t
+#include <memory> // for std::unique_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes audio into individual packets without any container around them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The <see cref="AudioTrackEncoder" /> writes complete files, which for Opus means
+  ///     collecting packets into Ogg pages before anything is written. Real-time uses such
+  ///     as voice chat send each packet on its own as soon as it has been encoded, so
+  ///     this encoder takes exactly one packet's worth of samples and hands back the
+  ///     compressed packet, which can be decoded by an <see cref="AudioPacketDecoder" />.
+  ///   </para>
+  ///   <para>
+  ///     Encoding a packet does not allocate memory. A packet encoder is not thread-safe.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE AudioPacketEncoder {
+
+    /// <summary>Creates a packet encoder producing raw Opus packets</summary>
+    /// <param name="channelOrder">Order in which the channels will be interleaved</param>
+    /// <param name="sampleRate">
+    ///   Sample rate of the audio that will be encoded, either 8000, 12000, 16000,
+    ///   24000 or 48000 Hz
+    /// </param>
+    /// <param name="packetMicroseconds">
+    ///   Duration of each packet in microseconds, either 2500, 5000, 10000, 20000,
+    ///   40000 or 60000. Shorter packets lower the latency but cost more bandwidth.
+    /// </param>
+    /// <returns>A new Opus packet encoder with the specified settings</returns>
+    /// <remarks>
+    ///   The encoder is tuned for speech. If the channels are placed differently from what
+    ///   Opus stores, they're reordered while encoding.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::unique_ptr<AudioPacketEncoder> CreateOpus(
+      const std::vector<ChannelPlacement> &channelOrder,
+      std::size_t sampleRate = 48000,
+      std::size_t packetMicroseconds = 20000
+    );
+
+    /// <summary>Frees all resources owned by the encoder</summary>
+    public: NUCLEX_AUDIO_API virtual ~AudioPacketEncoder() = default;
+
+    /// <summary>Counts the number of audio channels the encoder takes</summary>
+    /// <returns>The number of interleaved channels in each packet's samples</returns>
+    public: virtual std::size_t CountChannels() const = 0;
+
+    /// <summary>Retrieves the order in which the channels have to be interleaved</summary>
+    /// <returns>The placement of each channel, in interleaved order</returns>
+    public: virtual const std::vector<ChannelPlacement> &GetChannelOrder() const = 0;
+
+    /// <summary>Returns the sample rate of the audio the encoder takes</summary>
+    /// <returns>The number of frames per second in the encoded audio</returns>
+    public: virtual std::size_t GetSampleRate() const = 0;
+
+    /// <summary>Returns the number of frames that go into each packet</summary>
+    /// <returns>The number of frames each call to EncodePacket() consumes</returns>
+    public: virtual std::size_t CountFramesPerPacket() const = 0;
+
+    /// <summary>Returns the number of bytes that are enough for any single packet</summary>
+    /// <returns>The size a packet buffer needs to hold any packet the encoder produces</returns>
+    public: virtual std::size_t CountMaximumPacketBytes() const = 0;
+
+    /// <summary>Provides the codec setup data a decoder needs to decode the packets</summary>
+    /// <returns>The setup data that has to be passed to the packet decoder</returns>
+    /// <remarks>
+    ///   For Opus, this is the OpusHead identification header (RFC 7845, section 5.1).
+    ///   It has to reach the receiving end once, before any of the packets.
+    /// </remarks>
+    public: virtual const std::vector<std::byte> &GetSetupData() const = 0;
+
+    /// <summary>Changes the bit rate the encoder targets</summary>
+    /// <param name="kilobitsPerSecond">Bit rate in kilobits per second</param>
+    /// <remarks>
+    ///   This can be changed between any two packets, for example to react to
+    ///   changing network conditions.
+    /// </remarks>
+    public: virtual void SetBitrate(float kilobitsPerSecond) = 0;
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    /// <remarks>
+    ///   Call this when a new transmission starts so it doesn't begin with the tail
+    ///   end of the previous one.
+    /// </remarks>
+    public: virtual void Reset() = 0;
+
+    /// <summary>Encodes one packet's worth of interleaved float samples</summary>
+    /// <param name="samples">
+    ///   Interleaved samples, exactly <see cref="CountFramesPerPacket" /> frames
+    /// </param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The size of the encoded packet in bytes</returns>
+    public: virtual std::size_t EncodePacket(
+      const float *samples, std::byte *packet, std::size_t packetCapacity
+    ) = 0;
+
+    /// <summary>Encodes one packet's worth of interleaved 16-bit integer samples</summary>
+    /// <param name="samples">
+    ///   Interleaved samples, exactly <see cref="CountFramesPerPacket" /> frames
+    /// </param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The size of the encoded packet in bytes</returns>
+    public: virtual std::size_t EncodePacket(
+      const std::int16_t *samples, std::byte *packet, std::size_t packetCapacity
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_AUDIOPACKETENCODER_H
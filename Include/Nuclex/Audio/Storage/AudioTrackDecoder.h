@@ -23,17 +23,54 @@ limitations under the License.
 #include "Nuclex/Audio/Config.h"
 #include "Nuclex/Audio/ChannelPlacement.h"
 #include "Nuclex/Audio/AudioSampleFormat.h"
+#include "Nuclex/Audio/Float16.h"
+#include "Nuclex/Audio/PackedInt24.h"
 
 #include "Nuclex/Audio/Storage/AudioTrackDecoderInternal.h"
+#include "Nuclex/Audio/Storage/DecoderStatistics.h"
+#include "Nuclex/Audio/Storage/LatencyHistogram.h"
+#include "Nuclex/Audio/Storage/DecodePath.h"
+#include "Nuclex/Audio/Storage/OutputFormat.h"
+#include "Nuclex/Audio/Storage/SeekCost.h"
+#include "Nuclex/Audio/Storage/BlockContent.h"
+#include "Nuclex/Audio/Storage/DecodeFidelity.h"
+#include "Nuclex/Audio/Storage/ReplayGainMode.h"
+#include "Nuclex/Audio/Storage/IntegrityVerification.h"
 
 #include <vector> // for std::vector
 #include <memory> // for std::shared_ptr
+#include <cstddef> // for std::byte
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class DownmixMatrix;
+  class ChannelMixer;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct LoopRegion;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
   class VirtualFile;
+  class DecodedSampleSink;
+  class SharedSampleCache;
+  struct RawPcmLayout;
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -67,6 +104,235 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// </remarks>
     public: virtual std::shared_ptr<AudioTrackDecoder> Clone() const = 0;
 
+    /// <summary>Opens a decoder for headerless PCM samples in a caller-described layout</summary>
+    /// <param name="file">File holding the interleaved samples</param>
+    /// <param name="layout">Describes the sample format and location of the samples</param>
+    /// <returns>A decoder that reads and converts the samples</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The samples are read through the same conversion paths as Waveform files, so
+    ///     they get the byte-swapping and conversion kernels as well as channel remapping.
+    ///     If the file lends out its memory (for example a memory-mapped file), samples are
+    ///     converted straight from there without going through an intermediate buffer.
+    ///   </para>
+    ///   <para>
+    ///     If no frame count is given, the samples run to the end of the file. A frame
+    ///     count reaching past the file's end is clipped to the frames that are present.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> OpenRawPcm(
+      const std::shared_ptr<const VirtualFile> &file, const RawPcmLayout &layout
+    );
+
+    /// <summary>Wraps a decoder so that several threads can decode from it at once</summary>
+    /// <param name="decoder">Decoder that will be wrapped</param>
+    /// <param name="maximumDecoderCount">
+    ///   Maximum number of decoders the pool may create. If zero, the number of
+    ///   hardware threads of the system will be used.
+    /// </param>
+    /// <returns>A decoder that hands each decoding call to an idle decoder</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Decoders serialize all decoding calls, so if many threads decode from the same
+    ///     audio track, they will wait for each other. The decoder pool creates additional
+    ///     clones of the decoder (via <see cref="Clone" />) as needed and uses whichever
+    ///     one is idle and was last used closest to the requested start frame.
+    ///   </para>
+    ///   <para>
+    ///     Each clone keeps its own codec state, so only use this when you actually decode
+    ///     from multiple threads concurrently.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreatePool(
+      const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t maximumDecoderCount = 0
+    );
+
+    /// <summary>Wraps a decoder so that large decoding calls use several cores</summary>
+    /// <param name="decoder">Decoder that will be wrapped</param>
+    /// <param name="threadCount">
+    ///   Maximum number of threads a decoding call may be spread over. If zero, the number
+    ///   of hardware threads of the system will be used.
+    /// </param>
+    /// <returns>A decoder that splits large decoding calls into concurrent slices</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Decoding calls covering many seconds of audio (such as decoding a whole track
+    ///     into memory) are split into slices that begin on the codec's block boundaries.
+    ///     Each slice is decoded by its own clone of the decoder (via <see cref="Clone" />)
+    ///     directly into the caller's buffer. Small decoding calls are simply forwarded.
+    ///   </para>
+    ///   <para>
+    ///     This works best for FLAC and WavPack, whose blocks can be decoded independently.
+    ///     For FLAC files without a SEEKTABLE block and for Ogg files, call
+    ///     <see cref="BuildSeekIndex" /> first so that each clone can jump to its slice.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateParallel(
+      const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t threadCount = 0
+    );
+
+    /// <summary>Wraps a decoder so that its channels are mixed down while decoding</summary>
+    /// <param name="decoder">Decoder that will be wrapped</param>
+    /// <param name="matrix">
+    ///   Matrix describing how the channels are mixed down. It has to be built for the
+    ///   channel order of the decoder. Presets can be created via
+    ///   <see cref="Processing::DownmixMatrix::CreateItuStereo" />.
+    /// </param>
+    /// <returns>A decoder delivering the mixed down channels</returns>
+    /// <remarks>
+    ///   The wrapped decoder's channels are decoded in small chunks that stay in the CPU
+    ///   cache, so the caller never needs a buffer holding all of the original channels.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateDownmix(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const Processing::DownmixMatrix &matrix
+    );
+
+    /// <summary>Wraps a decoder so that its channels are remixed while decoding</summary>
+    /// <param name="decoder">Decoder that will be wrapped</param>
+    /// <param name="mixer">
+    ///   Mixer that produces the delivered channels. It has to be built for the channel
+    ///   order of the decoder. Upmixes can be created via
+    ///   <see cref="Processing::ChannelMixer::CreateUpmix" />.
+    /// </param>
+    /// <returns>A decoder delivering the mixed channels</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateMixer(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const Processing::ChannelMixer &mixer
+    );
+
+    /// <summary>Wraps a decoder so that its audio is resampled while decoding</summary>
+    /// <param name="decoder">Decoder that will be wrapped</param>
+    /// <param name="inputSampleRate">Sample rate of the wrapped decoder's audio</param>
+    /// <param name="outputSampleRate">Sample rate at which audio will be delivered</param>
+    /// <returns>A decoder delivering the audio at the requested sample rate</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The audio is resampled by a polyphase filter whose taps are precomputed for
+    ///     the ratio between both sample rates. Filter banks are shared between all
+    ///     resamplers using the same ratio, including clones.
+    ///   </para>
+    ///   <para>
+    ///     Frame indices and counts of the returned decoder are in the output sample rate.
+    ///     Reading consecutive ranges decodes each input frame only once, other reads
+    ///     are translated into seeks in the wrapped decoder.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateResampler(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t inputSampleRate,
+      std::size_t outputSampleRate
+    );
+
+    /// <summary>Wraps a decoder so that decoded samples are cached on disk</summary>
+    /// <param name="decoder">Decoder whose output will be cached</param>
+    /// <param name="cacheDirectory">Existing directory in which cache files are stored</param>
+    /// <param name="identity">
+    ///   Unique identity of the decoded file's contents, such as its absolute path plus
+    ///   its modification time. Decoders with the same identity share their cache files.
+    /// </param>
+    /// <param name="cacheBlockFrameCount">Number of frames stored in each cache file</param>
+    /// <returns>A decoder that reads cached frames from disk instead of decoding them</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Tools that scrub through the same Opus or Vorbis files again and again spend
+    ///     most of their time in the codec. This decorator stores each block of frames it
+    ///     decodes as raw float samples in a file of its own. Later requests for the same
+    ///     frames memory-map that file instead of decoding them again, even in later runs.
+    ///   </para>
+    ///   <para>
+    ///     Cache files hold native-endian samples without any header, so they can't be
+    ///     moved to other platforms. If writing a cache file fails, decoding still works,
+    ///     the frames simply aren't cached. Delete the directory's contents to clear
+    ///     the cache.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateDiskCached(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::string &cacheDirectory,
+      const std::string &identity,
+      std::size_t cacheBlockFrameCount = 65536
+    );
+
+    /// <summary>Wraps a decoder so that decoded samples are shared between processes</summary>
+    /// <param name="decoder">Decoder whose output will be cached</param>
+    /// <param name="cache">Shared sample cache the decoded samples will be stored in</param>
+    /// <param name="identity">
+    ///   Unique identity of the decoded file's contents, such as a hash of the file or
+    ///   its absolute path plus its modification time. All processes have to derive it
+    ///   the same way for them to find each other's blocks.
+    /// </param>
+    /// <returns>A decoder that takes blocks other processes decoded from shared memory</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Each block of frames the decoder delivers is first looked up in the shared
+    ///     sample cache. If any process on the machine decoded it before, the samples are
+    ///     converted straight from shared memory, otherwise the block is decoded and put
+    ///     into the cache for everyone else.
+    ///   </para>
+    ///   <para>
+    ///     Blocks hold as many frames as fit into one slot of the cache. Cached samples
+    ///     are native-endian floats, so all processes sharing a cache have to agree on
+    ///     the decoder settings (channel order, sample rate) for the same identity.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateSharedCached(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::shared_ptr<SharedSampleCache> &cache,
+      const std::string &identity
+    );
+
+    /// <summary>Wraps a decoder so that a region of the track repeats seamlessly</summary>
+    /// <param name="decoder">Decoder whose track contains the loop</param>
+    /// <param name="loop">
+    ///   Region that will be repeated, usually the <see cref="TrackInfo::Loop" /> of the track
+    /// </param>
+    /// <returns>A decoder that plays the intro, the repeated loop and the remaining tail</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The returned decoder presents the unrolled track: the frames before the loop,
+    ///     the loop played <see cref="LoopRegion::PlayCount" /> times and then whatever
+    ///     follows the loop. Decoding calls crossing the loop's end are split where it
+    ///     wraps, so no frame is decoded twice and no silence ends up in between.
+    ///     Loops that repeat indefinitely report the largest possible frame count.
+    ///   </para>
+    ///   <para>
+    ///     Each wrap seeks the wrapped decoder back to the loop's start. The Opus, Vorbis
+    ///     and FLAC decoders notice the repeated seek target and keep a checkpoint for it,
+    ///     so from the second wrap on, the seek is a direct jump.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<AudioTrackDecoder> CreateLooping(
+      const std::shared_ptr<AudioTrackDecoder> &decoder, const LoopRegion &loop
+    );
+
+    /// <summary>Decodes a whole audio track into memory using several cores</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="decoder">Decoder of the audio track that will be decoded</param>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="threadCount">
+    ///   Maximum number of threads the track may be spread over. If zero, the number
+    ///   of hardware threads of the system will be used.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     This is meant for loading long, high resolution tracks such as WavPack or
+    ///     FLAC masters in one go. It does the same as wrapping the decoder via
+    ///     <see cref="CreateParallel" /> and decoding all of its frames. The buffer
+    ///     needs to fit <see cref="CountFrames" /> x <see cref="CountChannels" /> samples.
+    ///   </para>
+    ///   <para>
+    ///     All slices are decoded by clones of the decoder which are destroyed again
+    ///     when the call returns, so the decoder's own file cursor stays where it was.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TSample>
+    static inline void DecodeAllParallel(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      TSample *buffer,
+      std::size_t threadCount = 0
+    );
+
     /// <summary>Counts the number of audio channels in the track</summary>
     /// <returns>The number of audio channels in the audio track</returns>
     public: virtual std::size_t CountChannels() const = 0;
@@ -93,10 +359,148 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// </remarks>
     public: virtual const std::vector<ChannelPlacement> &GetChannelOrder() const = 0;
 
+    /// <summary>Attempts to have the decoder deliver channels in a different order</summary>
+    /// <param name="channelOrder">
+    ///   Order in which the decoder should deliver the channels. It must contain the same
+    ///   channels as the order reported by <see cref="GetChannelOrder" />.
+    /// </param>
+    /// <returns>
+    ///   True if the decoder will deliver the channels in the requested order from now on,
+    ///   false if it can't and the caller has to reorder the channels by itself
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Formats such as Vorbis use a channel order that differs from what most audio
+    ///     APIs expect. Decoders that have to convert or interleave samples anyway can
+    ///     reorder the channels in the same pass, which saves another pass over all
+    ///     decoded samples. Clones inherit the channel order of the decoder.
+    ///   </para>
+    ///   <para>
+    ///     By default, this only succeeds if the channel order already matches. Set the
+    ///     channel order before wrapping the decoder in a pool or a parallel decoder.
+    ///     If the requested order contains different channels, std::invalid_argument
+    ///     is thrown by decoders that support reordering.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TrySetChannelOrder(
+      const std::vector<ChannelPlacement> &channelOrder
+    );
+
+    /// <summary>Attempts to have the decoder deliver audio at a lower sample rate</summary>
+    /// <param name="sampleRate">Sample rate at which the decoder should deliver audio</param>
+    /// <returns>
+    ///   True if the decoder will deliver audio at the requested rate from now on,
+    ///   false if it can't and the caller has to resample the audio by itself
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Some codecs can decode directly to a lower sample rate and do less work for it.
+    ///     Opus, for example, can decode at 8, 12, 16 or 24 kHz instead of 48 kHz, which is
+    ///     good enough for waveform previews or speech. After a successful call, all frame
+    ///     counts and frame indices are at the new sample rate. Clones inherit it.
+    ///   </para>
+    ///   <para>
+    ///     By default, this always fails. Set the sample rate before wrapping the decoder
+    ///     in a pool, a looping decoder or a parallel decoder.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TrySetDecodeSampleRate(std::size_t sampleRate);
+
+    /// <summary>Attempts to trade decoding fidelity against CPU time</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <returns>True if the decoder will decode with the requested fidelity</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Only lossy codecs with optional processing steps support levels other than
+    ///     <see cref="DecodeFidelity::Standard" />, which is what all decoders start with.
+    ///     The setting applies to this decoder only, so a mobile build can decode
+    ///     background streams at reduced fidelity and the foreground music at standard
+    ///     fidelity. Clones inherit it.
+    ///   </para>
+    ///   <para>
+    ///     By default, this only succeeds for the standard fidelity.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TrySetDecodeFidelity(DecodeFidelity fidelity);
+
+    /// <summary>Attempts to apply the ReplayGain stored in the file while decoding</summary>
+    /// <param name="mode">Whether to apply the track gain, the album gain or neither</param>
+    /// <returns>True if the decoder will apply the requested gain</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The gain is taken from the <see cref="TrackInfo::ReplayGain" /> the decoder
+    ///     found in the file and is folded into the decoder's own sample scaling, so it
+    ///     costs no extra pass over the samples. It never amplifies the track further
+    ///     than its stored peak allows. Files without gain tags decode unchanged.
+    ///   </para>
+    ///   <para>
+    ///     The setting affects the interleaved and separated decoding methods. Codecs
+    ///     that hand their own sample buffers to <see cref="DecodeRange" /> may deliver
+    ///     those unscaled. By default, this only succeeds for
+    ///     <see cref="ReplayGainMode::Off" />. Clones inherit the setting.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TrySetReplayGain(ReplayGainMode mode);
+
+    /// <summary>Attempts to make the decoder verify the checksums stored in its file</summary>
+    /// <param name="policy">Whether to verify and whether to do it in the background</param>
+    /// <returns>True if the decoder will verify its file as requested</returns>
+    /// <remarks>
+    ///   <para>
+    ///     FLAC decoders check the MD5 hash of the decoded audio and Ogg Vorbis and
+    ///     Ogg Opus decoders check the CRC of every Ogg page. Verification reads the whole
+    ///     file independently of decoding, so the decoder can be used normally meanwhile.
+    ///     Clones share the verification result of the decoder they were cloned from.
+    ///   </para>
+    ///   <para>
+    ///     By default, this only succeeds for <see cref="VerificationPolicy::Off" />.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TrySetVerificationPolicy(VerificationPolicy policy);
+
+    /// <summary>Reports the outcome of the checksum verification</summary>
+    /// <returns>The current state of the verification</returns>
+    /// <remarks>
+    ///   With a background verification policy, this returns
+    ///   <see cref="VerificationResult::Pending" /> until the whole file has been checked.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual VerificationResult GetVerificationResult() const;
+
     /// <summary>Returns the number of frames (sample count in any one channel)</summary>
     /// <returns>The number of frames the audio file is long</returns>
+    /// <remarks>
+    ///   Some formats don't state their length up front. Ogg Vorbis and Ogg Opus decoders
+    ///   only look for the end of the stream when this is first called, which can take
+    ///   a few reads on slow storage. Use <see cref="EstimateFrameCount" /> if a close
+    ///   guess is good enough, for example to lay out a progress bar.
+    /// </remarks>
     public: virtual std::uint64_t CountFrames() const = 0;
 
+    /// <summary>Guesses the number of frames without reading more of the file</summary>
+    /// <returns>The exact number of frames if known, otherwise an estimate</returns>
+    /// <remarks>
+    ///   Decoders that know their length, which is almost all of them, simply return
+    ///   the same as <see cref="CountFrames" />. The others estimate from the file size
+    ///   and the bit rate and become more precise the farther decoding has progressed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::uint64_t EstimateFrameCount() const;
+
+    /// <summary>Tells the decoder the number of frames if it was determined before</summary>
+    /// <param name="frameCount">Number of frames in the decoded track</param>
+    /// <remarks>
+    ///   <para>
+    ///     Decoders that would have to search for the end of the stream to count their
+    ///     frames take this number instead, so playing a file from its beginning never
+    ///     reads anything past what is being decoded. The <see cref="AudioLoader" /> does
+    ///     this by itself with the lengths recorded in its asset catalog.
+    ///   </para>
+    ///   <para>
+    ///     The number has to be exact. It only takes effect if the decoder doesn't know
+    ///     its length yet, all other decoders ignore the call.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void ProvideFrameCount(std::uint64_t frameCount) const;
+
     /// <summary>Returns the format in which samples are obtained from the codec</summary>
     /// <returns>The format in which the audio samples are delivered by the codec</returns>
     /// <remarks>
@@ -133,6 +537,246 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// </remarks>
     public: virtual bool IsNativelyInterleaved() const = 0;
 
+    /// <summary>Determines where the native block containing a frame begins</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The index of the first frame in the block containing the frame</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Codecs compress audio in blocks (FLAC frames, Vorbis and Opus packets, WavPack
+    ///     blocks). A decoding request that begins or ends in the middle of a block forces
+    ///     the codec to decode the whole block and throw away the part that wasn't asked
+    ///     for. If you stream audio in chunks, requesting whole blocks avoids that waste.
+    ///   </para>
+    ///   <para>
+    ///     For formats with variable block sizes (Vorbis and Opus), this is based on
+    ///     the nominal block size of the stream. Formats that are not compressed in
+    ///     blocks (Waveform) report a synthetic block size that is efficient to read.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::uint64_t GetBlockStart(std::uint64_t frameIndex) const;
+
+    /// <summary>Determines the length of the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>
+    ///   The number of frames in the block containing the frame, zero if the frame lies
+    ///   beyond the end of the audio track
+    /// </returns>
+    /// <remarks>
+    ///   The block begins at the frame returned by <see cref="GetBlockStart" />. The last
+    ///   block of an audio track is usually shorter than the others.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::size_t GetBlockSize(std::uint64_t frameIndex) const;
+
+    /// <summary>Reports what is stored in the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be described</param>
+    /// <returns>The extent of the block and whether it is constant or silent</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Only the block's encoded data is looked at, its samples are not reconstructed.
+    ///     The FLAC decoder reads the subframe headers and flags blocks whose channels
+    ///     are all stored as CONSTANT (or as VERBATIM samples that happen to be equal).
+    ///   </para>
+    ///   <para>
+    ///     Decoders that can't look into their blocks report the block's extent as given
+    ///     by <see cref="GetBlockStart" /> and <see cref="GetBlockSize" /> and clear the
+    ///     <see cref="BlockContent.IsKnown" /> flag. Throws an std::out_of_range exception
+    ///     if the frame lies beyond the end of the audio track.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual BlockContent DescribeBlock(std::uint64_t frameIndex) const;
+
+    /// <summary>Describes all native blocks overlapping a range of frames</summary>
+    /// <param name="startFrame">Index of the first frame whose block will be described</param>
+    /// <param name="frameCount">Number of frames whose blocks will be described</param>
+    /// <returns>The descriptions of the blocks in the order they appear</returns>
+    /// <remarks>
+    ///   This is the cheap way to find the silent stretches of a whole audio track.
+    ///   Decoders that can look into their blocks walk over them sequentially without
+    ///   decoding them, which is bound by I/O rather than by the codec. It does not
+    ///   move the decoding position and can run while another thread is decoding.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::vector<BlockContent> ScanBlocks(
+      std::uint64_t startFrame, std::uint64_t frameCount
+    ) const;
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    /// <remarks>
+    ///   <para>
+    ///     Ogg files (Vorbis and Opus) have no index, so each seek normally turns into
+    ///     a bisection search that reads pages from all over the file. The decoders for
+    ///     these formats keep a seek index they extend while decoding sequentially.
+    ///     Calling this method scans the page headers of the whole file right away, so
+    ///     that all later seeks can go straight to the closest page.
+    ///   </para>
+    ///   <para>
+    ///     FLAC files often lack a SEEKTABLE block, so the FLAC decoder keeps a seek
+    ///     table of its own that works the same way. Building it up front requires
+    ///     decoding the whole file once. Formats that can calculate the position of
+    ///     any frame do not need a seek index and will do nothing here.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void BuildSeekIndex() const;
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>
+    ///   The serialized seek index or an empty vector if the format uses no seek index
+    /// </returns>
+    /// <remarks>
+    ///   If you open the same files repeatedly, you can store the seek index next to your
+    ///   other metadata and hand it to <see cref="LoadSeekIndex" /> later instead of
+    ///   rebuilding it each time.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::vector<std::byte> SaveSeekIndex() const;
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    /// <remarks>
+    ///   If the seek index is damaged or was saved for a file of different length,
+    ///   a <see cref="Errors::CorruptedFileError" /> is thrown. Formats that use no
+    ///   seek index ignore the call.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const;
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    /// <remarks>
+    ///   <para>
+    ///     Opus has to decode 80 ms of audio before a seek target for its output to
+    ///     converge. If you jump around a long track every few seconds, that pre-roll
+    ///     takes up most of the decoding time. With fast seeking, the decoder resumes
+    ///     at the closest known page before the target instead, which means the first
+    ///     few milliseconds after a seek may sound slightly off.
+    ///   </para>
+    ///   <para>
+    ///     Clones share this setting with the decoder they were cloned from. Formats
+    ///     that do not need a pre-roll ignore the call.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void AllowFastSeeking(bool allow) const;
+
+    /// <summary>Tries to point the decoder at another file of the same format</summary>
+    /// <param name="file">File the decoder should decode from now on</param>
+    /// <returns>
+    ///   True if the decoder now decodes the new file, false if it doesn't support
+    ///   being reopened or the new file is in another format, in which case it still
+    ///   decodes the file it had before
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Sound banks with thousands of tiny clips spend more time setting up decoders
+    ///     than decoding them. Reopening keeps the decoder's buffers and caches instead
+    ///     of allocating new ones for each clip.
+    ///   </para>
+    ///   <para>
+    ///     The decoder must not be in use by any other thread while it is reopened.
+    ///     Clones made before the call keep decoding the old file.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual bool TryReopen(const std::shared_ptr<const VirtualFile> &file);
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    /// <remarks>
+    ///   <para>
+    ///     While enabled, the decoder counts the frames it delivers, the seeks it performs,
+    ///     the bytes it reads from its file and the time it spends decoding and waiting
+    ///     for other threads. The counters are lock-free and while disabled, recording
+    ///     costs a single flag check per decoding call, so this can stay on in production.
+    ///   </para>
+    ///   <para>
+    ///     Turning statistics on resets them. Clones inherit whether statistics are
+    ///     enabled, but start counting from zero. Decoders that wrap another decoder
+    ///     report the statistics of the decoder they wrap. Decoders that don't support
+    ///     statistics ignore the call.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void EnableStatistics(bool enable = true) const;
+
+    /// <summary>Retrieves the statistics the decoder has collected so far</summary>
+    /// <returns>The current values of the decoder's statistics</returns>
+    /// <remarks>
+    ///   Can be called from any thread, even while another thread is decoding.
+    ///   If statistics have never been enabled, all values are zero.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual DecoderStatistics GetStatistics() const;
+
+    /// <summary>Retrieves the distribution of the decoder's decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each decoding call took</returns>
+    /// <remarks>
+    ///   Recorded together with the other statistics, so this stays empty unless
+    ///   <see cref="EnableStatistics" /> was called. Times include waiting for other
+    ///   threads using the decoder. Polling this with reset enabled once per second
+    ///   yields the distribution of each second.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual LatencyHistogram GetDecodeLatencies(
+      bool reset = false
+    ) const;
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Nothing is decoded, the decoder only reports which of its code paths it would
+    ///     take. 24-bit samples are delivered in 32-bit integers and take the same path
+    ///     as <see cref="AudioSampleFormat.SignedInteger_32" />. Requesting samples in
+    ///     the decoder's native format and layout usually is the fastest path.
+    ///   </para>
+    ///   <para>
+    ///     Decoders that wrap another decoder report the path of the wrapped decoder
+    ///     followed by their own steps. Decoders that don't describe their path report
+    ///     an estimate based on their native sample format and channel layout.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const;
+
+    /// <summary>Picks the output format the decoder can deliver with the least work</summary>
+    /// <param name="acceptableFormats">
+    ///   Formats and channel layouts the caller can consume, most preferred first
+    /// </param>
+    /// <returns>The acceptable format that takes the fewest passes over the samples</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Each format is rated via <see cref="ExplainDecodePath" />, so nothing is
+    ///     decoded. The format with the fewest passes wins, then the one needing the
+    ///     fewest scratch buffers, then the one closest to the decoder's native sample
+    ///     format and channel layout. If formats are still tied, the one listed first
+    ///     wins.
+    ///   </para>
+    ///   <para>
+    ///     A mixer that can take floats or 16-bit integers, interleaved or separated,
+    ///     would end up with floats from Vorbis and Opus, 32-bit integers from WavPack
+    ///     if it lists them and the stored format from Waveform files.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API OutputFormat NegotiateOutputFormat(
+      const std::vector<OutputFormat> &acceptableFormats
+    ) const;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Nothing is read or decoded, the decoder mirrors the choices its seek method
+    ///     would make, using its seek table or seek index, checkpoints, pre-roll and
+    ///     block boundaries. If the decoder is already positioned at the target frame,
+    ///     the cost is zero, so this waits for decoding calls from other threads.
+    ///   </para>
+    ///   <para>
+    ///     Decoders that wrap another decoder report the cost of the wrapped decoder
+    ///     at the frame they would request from it. Decoders that don't know their
+    ///     seeking behavior report the frames up to the target within its block.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual SeekCost EstimateSeekCost(std::uint64_t targetFrame) const;
+
     /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
     /// <typeparam name="TSample">Type of samples to decode as</typeparam>
     /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
@@ -173,6 +817,11 @@ namespace Nuclex { namespace Audio { namespace Storage {
     ///     <code>eachBufferSize = frameCount x sizeof(TSample)</code>
     ///   </para>
     ///   <para>
+    ///     If you only need some of the channels, you can pass a null pointer for the ones
+    ///     you're not interested in. The decoder will then skip converting and copying
+    ///     those channels. The codec may still have to decode them internally, though.
+    ///   </para>
+    ///   <para>
     ///     To achieve best performance, decode the file sequentially by requesting
     ///     consecutive sample ranges until the end of the file.
     ///   </para>
@@ -182,22 +831,222 @@ namespace Nuclex { namespace Audio { namespace Storage {
       TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
     ) const;
 
-#if defined(CONSIDERED_FEATURES)
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">
+    ///   Whether to add the samples to what's already in the buffer instead of
+    ///   overwriting it. Integer samples are clipped when they overflow.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     This lets a track be decoded straight into its place on a mixing bus. For example,
+    ///     a stereo track can go into channels 2 and 3 of an 8 channel bus with
+    ///     a <paramref name="frameStride" /> of 8 and a <paramref name="channelOffset" />
+    ///     of 2. The other channels of the buffer are left untouched.
+    ///   </para>
+    ///   <para>
+    ///     <code>bufferSize = frameCount x frameStride x sizeof(TSample)</code>
+    ///   </para>
+    ///   <para>
+    ///     Only 8 bit unsigned, 16/32 bit signed, float and double samples are supported.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TSample>
+    inline void DecodeInterleaved(
+      TSample *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate = false
+    ) const;
+
+    /// <summary>Hands decoded audio frames to a sink without copying them</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="sink">Sink that receives views of the decoded samples</param>
+    /// <remarks>
+    ///   <para>
+    ///     Instead of converting samples into a caller-provided buffer, this lets the sink
+    ///     look at the codec's own buffers, in the codec's native sample format and channel
+    ///     layout. The sink decides whether and how to convert the samples.
+    ///   </para>
+    ///   <para>
+    ///     FLAC and Vorbis hand out their decoding buffers directly. For other formats,
+    ///     the samples are decoded in chunks into a temporary buffer in their native
+    ///     format, which still avoids a conversion but costs one copy.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual void DecodeRange(
+      std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+    ) const;
+
+    /// <summary>Returns the number of frames in a typical block of the codec</summary>
+    /// <returns>The nominal number of frames in one of the codec's blocks</returns>
+    /// <remarks>
+    ///   By default, <see cref="GetBlockStart" /> and <see cref="GetBlockSize" /> assume
+    ///   the audio track is divided into blocks of this size. Decoders only need to
+    ///   override those two methods if their blocks don't follow a fixed grid.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual std::size_t GetNominalBlockSize() const;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as floats and narrows them while they're
+    ///   still in the cache. Decoders can override it to narrow straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedFloat16(
+      Float16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as floats and narrows them while they're
+    ///   still in the cache. Decoders can override it to narrow straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedBFloat16(
+      BFloat16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as floats and narrows them while they're
+    ///   still in the cache. Decoders can override it to narrow straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeSeparatedFloat16(
+      Float16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as floats and narrows them while they're
+    ///   still in the cache. Decoders can override it to narrow straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeSeparatedBFloat16(
+      BFloat16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as 32-bit integers and packs them while
+    ///   they're still in the cache. Decoders can override it to pack straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedPackedInt24(
+      PackedInt24 *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks as 32-bit integers and packs them while
+    ///   they're still in the cache. Decoders can override it to pack straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeSeparatedPackedInt24(
+      PackedInt24 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
 
-    // Decode separated channels. More efficient for, i.e. FLAC
-    //
-    // Perhaps individual pointers in the buffers list can be nullptr if only
-    // specific channels are needed to skip copying/converting those?
-    //
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks and scatters them into the buffer while
+    ///   they're still in the cache. Decoders can override it to write into the buffer
+    ///   straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedStridedUint8(
+      std::uint8_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+    ) const;
 
-    // Allow user to start decoding at block boundaries
-    //
-    // This is probably the interface that makes the most sense.
-    //
-    std::size-t GetBlockSize(std::uint64_t sampleIndex);
-    std::size_t GetBlockStart(std::uint64_t sampleIndex);
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks and scatters them into the buffer while
+    ///   they're still in the cache. Decoders can override it to write into the buffer
+    ///   straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedStridedInt16(
+      std::int16_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+    ) const;
 
-#endif // defined(CONSIDERED_FEATURES)
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks and scatters them into the buffer while
+    ///   they're still in the cache. Decoders can override it to write into the buffer
+    ///   straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedStridedInt32(
+      std::int32_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+    ) const;
+
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks and scatters them into the buffer while
+    ///   they're still in the cache. Decoders can override it to write into the buffer
+    ///   straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedStridedFloat(
+      float *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+    ) const;
+
+    /// <summary>Decodes audio frames into a slice of a wider interleaved buffer</summary>
+    /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+    /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+    /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+    /// <remarks>
+    ///   By default, this decodes small chunks and scatters them into the buffer while
+    ///   they're still in the cache. Decoders can override it to write into the buffer
+    ///   straight from the codec.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void DecodeInterleavedStridedDouble(
+      double *buffer, std::size_t frameStride, std::size_t channelOffset,
+      std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+    ) const;
 
   };
 
@@ -212,8 +1061,12 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::is_same<TSample, std::int16_t>::value ||
       std::is_same<TSample, std::int32_t>::value ||
       std::is_same<TSample, float>::value ||
-      std::is_same<TSample, double>::value,
-      u8"Only 8 but unsigned, 16/32 bit signed, float or double samples are supported"
+      std::is_same<TSample, double>::value ||
+      std::is_same<TSample, Float16>::value ||
+      std::is_same<TSample, BFloat16>::value ||
+      std::is_same<TSample, PackedInt24>::value,
+      u8"Only 8 bit unsigned, 16/24/32 bit signed, float, double, "
+      u8"half precision float or brain float samples are supported"
     );
   }
 
@@ -264,6 +1117,110 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    Float16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeInterleavedFloat16(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    BFloat16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeInterleavedBFloat16(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    PackedInt24 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeInterleavedPackedInt24(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    TSample *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    static_assert(
+      std::is_same<TSample, std::uint8_t>::value ||
+      std::is_same<TSample, std::int16_t>::value ||
+      std::is_same<TSample, std::int32_t>::value ||
+      std::is_same<TSample, float>::value ||
+      std::is_same<TSample, double>::value,
+      u8"Only 8 bit unsigned, 16/32 bit signed, float or double samples are supported"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    std::uint8_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    DecodeInterleavedStridedUint8(
+      buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    std::int16_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    DecodeInterleavedStridedInt16(
+      buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    std::int32_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    DecodeInterleavedStridedInt32(
+      buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    float *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    DecodeInterleavedStridedFloat(
+      buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeInterleaved(
+    double *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate /* = false */
+  ) const {
+    DecodeInterleavedStridedDouble(
+      buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TSample>
   inline void AudioTrackDecoder::DecodeSeparated(
     TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
@@ -273,8 +1230,12 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::is_same<TSample, std::int16_t>::value ||
       std::is_same<TSample, std::int32_t>::value ||
       std::is_same<TSample, float>::value ||
-      std::is_same<TSample, double>::value,
-      u8"Only 8 but unsigned, 16/32 bit signed, float or double samples are supported"
+      std::is_same<TSample, double>::value ||
+      std::is_same<TSample, Float16>::value ||
+      std::is_same<TSample, BFloat16>::value ||
+      std::is_same<TSample, PackedInt24>::value,
+      u8"Only 8 bit unsigned, 16/24/32 bit signed, float, double, "
+      u8"half precision float or brain float samples are supported"
     );
   }
 
@@ -325,6 +1286,47 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<>
+  inline void AudioTrackDecoder::DecodeSeparated(
+    Float16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeSeparatedFloat16(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeSeparated(
+    BFloat16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeSeparatedBFloat16(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackDecoder::DecodeSeparated(
+    PackedInt24 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    DecodeSeparatedPackedInt24(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline void AudioTrackDecoder::DecodeAllParallel(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    TSample *buffer,
+    std::size_t threadCount /* = 0 */
+  ) {
+    std::shared_ptr<AudioTrackDecoder> parallelDecoder = CreateParallel(decoder, threadCount);
+    parallelDecoder->DecodeInterleaved<TSample>(
+      buffer, 0, static_cast<std::size_t>(parallelDecoder->CountFrames())
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Storage
 
 #endif // NUCLEX_AUDIO_STORAGE_AUDIOTRACKDECODER_H
@@ -23,12 +23,17 @@ limitations under the License.
 #include "Nuclex/Audio/Config.h"
 #include "Nuclex/Audio/ChannelPlacement.h"
 #include "Nuclex/Audio/AudioSampleFormat.h"
+#include "Nuclex/Audio/PackedInt24.h"
 
 #include "Nuclex/Audio/Storage/AudioTrackEncoderInternal.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+#include "Nuclex/Audio/Storage/EncoderCpuBudget.h"
+#include "Nuclex/Audio/Storage/EncodingProgressListener.h"
 
 #include <vector> // for std::vector
 #include <memory> // for std::shared_ptr
 #include <cstdint> // for std::uint8_t, std::int16_t, std::int32_t
+#include <optional> // for std::optional
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -92,10 +97,213 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// </remarks>
     public: virtual void Flush() = 0;
 
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: NUCLEX_AUDIO_API virtual std::uint64_t CountWrittenBytes() const = 0;
+
+    /// <summary>Counts the frames that have been fed to the encoder so far</summary>
+    /// <returns>The number of frames the encoder has consumed</returns>
+    public: std::uint64_t CountConsumedFrames() const { return this->consumedFrameCount; }
+
+    /// <summary>Tries to point the encoder at a new output file with the same settings</summary>
+    /// <param name="target">File into which the encoder will write from now on</param>
+    /// <returns>
+    ///   True if the encoder now writes into the new file, false if it doesn't support
+    ///   being reopened, in which case it is left as it was
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     When encoding thousands of short clips, setting up a new encoder for each clip
+    ///     takes longer than encoding it. Reopening keeps the encoder's settings, buffers
+    ///     and as much of the codec library's state as the codec allows and starts a fresh
+    ///     stream in the new file. The count of consumed frames starts over at zero.
+    ///   </para>
+    ///   <para>
+    ///     <see cref="Flush" /> should be called before reopening the encoder, otherwise
+    ///     the stream in the previous file is left incomplete.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API bool TryReopen(const std::shared_ptr<VirtualFile> &target);
+
+    /// <summary>Reports the settings and cost of an encoder running on a CPU budget</summary>
+    /// <returns>
+    ///   The current settings and measured cost or nothing if the encoder was built
+    ///   without a CPU budget or its codec doesn't support one
+    /// </returns>
+    public: NUCLEX_AUDIO_API virtual std::optional<EncoderCpuMetrics> GetCpuMetrics() const;
+
+    /// <summary>Installs a listener that will be notified as encoding progresses</summary>
+    /// <param name="listener">Listener that will receive progress notifications</param>
+    /// <remarks>
+    ///   While a listener or cancellation token is set, the encode methods split their
+    ///   input into blocks and report progress after each block.
+    /// </remarks>
+    public: void SetProgressListener(const std::shared_ptr<EncodingProgressListener> &listener) {
+      this->progressListener = listener;
+    }
+
+    /// <summary>Sets a token through which encoding can be cancelled</summary>
+    /// <param name="token">Token that will be checked between encoded blocks</param>
+    /// <remarks>
+    ///   <para>
+    ///     Once cancellation has been requested, the encode methods throw a
+    ///     <see cref="Errors::CancelledError" /> before the next block. The output file
+    ///     is left incomplete, so the encoder should be destroyed rather than flushed,
+    ///     which also releases the codec's resources.
+    ///   </para>
+    ///   <para>
+    ///     Blocks are <see cref="MonitoredBlockFrameCount" /> frames long, so a very large
+    ///     encode call will notice cancellation long before it has consumed all samples.
+    ///   </para>
+    /// </remarks>
+    public: void SetCancellationToken(const std::shared_ptr<const CancellationToken> &token) {
+      this->cancellationToken = token;
+    }
+
+    /// <summary>Points the encoder at a new output file with the same settings</summary>
+    /// <param name="target">File into which the encoder will write from now on</param>
+    /// <returns>True if the encoder was reopened, false if it doesn't support it</returns>
+    /// <remarks>
+    ///   The default implementation returns false. Encoders that can start a new stream
+    ///   without being rebuilt override this.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual bool Reopen(const std::shared_ptr<VirtualFile> &target);
+
+    /// <summary>Number of frames encoded between progress and cancellation checks</summary>
+    protected: static constexpr std::size_t MonitoredBlockFrameCount = 16384;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    /// <remarks>
+    ///   By default, this unpacks small chunks to 32-bit integers and encodes them while
+    ///   they're still in the cache. Encoders can override it to take the packed samples.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void EncodeInterleavedPackedInt24(
+      const PackedInt24 *buffer, std::size_t frameCount
+    );
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    /// <remarks>
+    ///   By default, this unpacks small chunks to 32-bit integers and encodes them while
+    ///   they're still in the cache. Encoders can override it to take the packed samples.
+    /// </remarks>
+    protected: NUCLEX_AUDIO_API virtual void EncodeSeparatedPackedInt24(
+      const PackedInt24 *buffers[], std::size_t frameCount
+    );
+
+    /// <summary>Feeds interleaved samples to the encoder, in blocks if monitored</summary>
+    /// <typeparam name="TSample">Type as which the samples will be fed</typeparam>
+    /// <typeparam name="TEncoder">Class that declares the encoder method</typeparam>
+    /// <param name="buffer">Buffer in which the samples to encode are stored</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to encode</param>
+    /// <param name="encode">Encoder method that will receive the samples</param>
+    private: template<typename TSample, typename TEncoder>
+    inline void encodeInterleavedInBlocks(
+      const TSample *buffer, std::size_t frameCount,
+      void (TEncoder::*encode)(const TSample *, std::size_t)
+    );
+
+    /// <summary>Feeds separated channels to the encoder, in blocks if monitored</summary>
+    /// <typeparam name="TSample">Type as which the samples will be fed</typeparam>
+    /// <typeparam name="TEncoder">Class that declares the encoder method</typeparam>
+    /// <param name="buffers">Buffers storing the channels to encode</param>
+    /// <param name="frameCount">Number of frames (samples per channel) to encode</param>
+    /// <param name="encode">Encoder method that will receive the samples</param>
+    private: template<typename TSample, typename TEncoder>
+    inline void encodeSeparatedInBlocks(
+      const TSample *buffers[], std::size_t frameCount,
+      void (TEncoder::*encode)(const TSample *[], std::size_t)
+    );
+
+    /// <summary>Receives progress notifications, if set</summary>
+    private: std::shared_ptr<EncodingProgressListener> progressListener;
+    /// <summary>Checked between encoded blocks to cancel encoding, if set</summary>
+    private: std::shared_ptr<const CancellationToken> cancellationToken;
+    /// <summary>Number of frames that have been fed to the encoder</summary>
+    private: std::uint64_t consumedFrameCount = 0;
+
   };
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TSample, typename TEncoder>
+  inline void AudioTrackEncoder::encodeInterleavedInBlocks(
+    const TSample *buffer, std::size_t frameCount,
+    void (TEncoder::*encode)(const TSample *, std::size_t)
+  ) {
+
+    // Without a listener or token, the samples go to the encoder in one piece
+    if(likely(!this->progressListener && !this->cancellationToken)) {
+      (this->*encode)(buffer, frameCount);
+      this->consumedFrameCount += frameCount;
+      return;
+    }
+
+    std::size_t channelCount = GetChannelOrder().size();
+    while(frameCount > 0) {
+      if(this->cancellationToken) {
+        this->cancellationToken->ThrowIfCancellationRequested();
+      }
+
+      std::size_t blockFrameCount = (
+        (frameCount < MonitoredBlockFrameCount) ? frameCount : MonitoredBlockFrameCount
+      );
+      (this->*encode)(buffer, blockFrameCount);
+      this->consumedFrameCount += blockFrameCount;
+
+      buffer += blockFrameCount * channelCount;
+      frameCount -= blockFrameCount;
+
+      if(this->progressListener) {
+        this->progressListener->ReportProgress(this->consumedFrameCount, CountWrittenBytes());
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample, typename TEncoder>
+  inline void AudioTrackEncoder::encodeSeparatedInBlocks(
+    const TSample *buffers[], std::size_t frameCount,
+    void (TEncoder::*encode)(const TSample *[], std::size_t)
+  ) {
+
+    // Without a listener or token, the samples go to the encoder in one piece
+    if(likely(!this->progressListener && !this->cancellationToken)) {
+      (this->*encode)(buffers, frameCount);
+      this->consumedFrameCount += frameCount;
+      return;
+    }
+
+    // The caller's pointer array must not be modified, so advance a copy of it
+    std::vector<const TSample *> blockBuffers(buffers, buffers + GetChannelOrder().size());
+    while(frameCount > 0) {
+      if(this->cancellationToken) {
+        this->cancellationToken->ThrowIfCancellationRequested();
+      }
+
+      std::size_t blockFrameCount = (
+        (frameCount < MonitoredBlockFrameCount) ? frameCount : MonitoredBlockFrameCount
+      );
+      (this->*encode)(blockBuffers.data(), blockFrameCount);
+      this->consumedFrameCount += blockFrameCount;
+
+      for(const TSample *&blockBuffer : blockBuffers) {
+        blockBuffer += blockFrameCount;
+      }
+      frameCount -= blockFrameCount;
+
+      if(this->progressListener) {
+        this->progressListener->ReportProgress(this->consumedFrameCount, CountWrittenBytes());
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TSample>
   inline void AudioTrackEncoder::EncodeInterleaved(
     const TSample *buffer, std::size_t frameCount
@@ -105,8 +313,9 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::is_same<TSample, std::int16_t>::value ||
       std::is_same<TSample, std::int32_t>::value ||
       std::is_same<TSample, float>::value ||
-      std::is_same<TSample, double>::value,
-      u8"Only 8 but unsigned, 16/32 bit signed, float or double samples are supported"
+      std::is_same<TSample, double>::value ||
+      std::is_same<TSample, PackedInt24>::value,
+      u8"Only 8 bit unsigned, 16/24/32 bit signed, float or double samples are supported"
     );
   }
 
@@ -116,7 +325,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeInterleaved(
     const std::uint8_t *buffer, std::size_t frameCount
   ) {
-    EncodeInterleavedUint8(buffer, frameCount);
+    encodeInterleavedInBlocks(buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedUint8);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -125,7 +334,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeInterleaved(
     const std::int16_t *buffer, std::size_t frameCount
   ) {
-    EncodeInterleavedInt16(buffer, frameCount);
+    encodeInterleavedInBlocks(buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedInt16);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -134,7 +343,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeInterleaved(
     const std::int32_t *buffer, std::size_t frameCount
   ) {
-    EncodeInterleavedInt32(buffer, frameCount);
+    encodeInterleavedInBlocks(buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedInt32);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -143,7 +352,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeInterleaved(
     const float *buffer, std::size_t frameCount
   ) {
-    EncodeInterleavedFloat(buffer, frameCount);
+    encodeInterleavedInBlocks(buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedFloat);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -152,7 +361,18 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeInterleaved(
     const double *buffer, std::size_t frameCount
   ) {
-    EncodeInterleavedDouble(buffer, frameCount);
+    encodeInterleavedInBlocks(buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedDouble);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackEncoder::EncodeInterleaved(
+    const PackedInt24 *buffer, std::size_t frameCount
+  ) {
+    encodeInterleavedInBlocks(
+      buffer, frameCount, &AudioTrackEncoder::EncodeInterleavedPackedInt24
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -166,8 +386,9 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::is_same<TSample, std::int16_t>::value ||
       std::is_same<TSample, std::int32_t>::value ||
       std::is_same<TSample, float>::value ||
-      std::is_same<TSample, double>::value,
-      u8"Only 8 but unsigned, 16/32 bit signed, float or double samples are supported"
+      std::is_same<TSample, double>::value ||
+      std::is_same<TSample, PackedInt24>::value,
+      u8"Only 8 bit unsigned, 16/24/32 bit signed, float or double samples are supported"
     );
   }
 
@@ -177,7 +398,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeSeparated(
     const std::uint8_t *buffers[], std::size_t frameCount
   ) {
-    EncodeSeparatedUint8(buffers, frameCount);
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedUint8);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -186,7 +407,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeSeparated(
     const std::int16_t *buffers[], std::size_t frameCount
   ) {
-    EncodeSeparatedInt16(buffers, frameCount);
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedInt16);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -195,7 +416,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeSeparated(
     const std::int32_t *buffers[], std::size_t frameCount
   ) {
-    EncodeSeparatedInt32(buffers, frameCount);
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedInt32);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -204,7 +425,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeSeparated(
     const float *buffers[], std::size_t frameCount
   ) {
-    EncodeSeparatedFloat(buffers, frameCount);
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedFloat);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -213,7 +434,16 @@ namespace Nuclex { namespace Audio { namespace Storage {
   inline void AudioTrackEncoder::EncodeSeparated(
     const double *buffers[], std::size_t frameCount
   ) {
-    EncodeSeparatedDouble(buffers, frameCount);
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedDouble);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  inline void AudioTrackEncoder::EncodeSeparated(
+    const PackedInt24 *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparatedInBlocks(buffers, frameCount, &AudioTrackEncoder::EncodeSeparatedPackedInt24);
   }
 
   // ------------------------------------------------------------------------------------------- //
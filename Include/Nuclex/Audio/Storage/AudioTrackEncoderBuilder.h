@@ -23,7 +23,9 @@ limitations under the License.
 #include "Nuclex/Audio/Config.h"
 #include "Nuclex/Audio/ChannelPlacement.h"
 #include "Nuclex/Audio/AudioSampleFormat.h"
+#include "Nuclex/Audio/Storage/EncoderCpuBudget.h"
 
+#include <cstdint> // for std::uint64_t
 #include <vector> // for std::vector
 #include <memory> // for std::shared_ptr
 
@@ -312,6 +314,44 @@ namespace Nuclex { namespace Audio { namespace Storage {
       float effort = 1.0f
     ) = 0;
 
+    /// <summary>Sets the number of threads the encoder may use</summary>
+    /// <param name="threadCount">Number of threads, 0 to use one per CPU core</param>
+    /// <returns>The encoder builder such that additional calls can be chained</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Codecs whose frames can be compressed independently of each other (FLAC being
+    ///     the prime example) can encode several sections of the audio track at once and
+    ///     write them out in order. This makes long archival encodes scale with the number
+    ///     of CPU cores, at the cost of holding a few seconds of audio per thread in memory.
+    ///   </para>
+    ///   <para>
+    ///     The default is a single thread. Codecs that can not encode in parallel
+    ///     ignore this setting.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual AudioTrackEncoderBuilder &SetThreadCount(
+      std::size_t threadCount = 0
+    );
+
+    /// <summary>Limits the processor time the encoder may spend per second of audio</summary>
+    /// <param name="budget">Budget and the settings the encoder may give up to meet it</param>
+    /// <returns>The encoder builder such that additional calls can be chained</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Intended for encoding live audio alongside other time-critical work. Instead of
+    ///     staying at the configured effort, the encoder lowers its effort whenever encoding
+    ///     takes longer than the budget allows and raises it again when there is headroom.
+    ///     The configured effort and bitrate are the upper limits.
+    ///   </para>
+    ///   <para>
+    ///     Codecs that can not change their settings while encoding ignore this setting.
+    ///     <see cref="AudioTrackEncoder.GetCpuMetrics" /> tells whether a budget is in use.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual AudioTrackEncoderBuilder &SetCpuBudget(
+      const EncoderCpuBudget &budget
+    );
+
 #if 0
     /// <summary>Sets the title of the audio track</summary>
     /// <param name="title">Human-readable title of the audio track</param>
@@ -325,9 +365,26 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
     /// <summary>Builds an audio track encoder that writes into a file</summary>
     /// <param name="outputFilePath">File into which the new encoder will write</param>
+    /// <param name="expectedByteCount">
+    ///   Size the encoded file is expected to reach, 0 if unknown
+    /// </param>
     /// <returns>The new encoder, set up to write into a file in the specified path</returns>
+    /// <remarks>
+    ///   <para>
+    ///     When many encoders write at the same time, their output files end up
+    ///     interleaved on disk in small fragments. Passing the expected size lets
+    ///     the file system reserve the space in one go. Space that isn't used is released
+    ///     again when the encoder is flushed.
+    ///   </para>
+    ///   <para>
+    ///     For uncompressed formats, the size is the frame count times the channel count
+    ///     times the bytes per sample plus a small header. For lossy codecs, the duration
+    ///     in seconds times the target bitrate divided by eight is a good estimate. For
+    ///     lossless codecs, roughly 60% of the uncompressed size is typical.
+    ///   </para>
+    /// </remarks>
     public: NUCLEX_AUDIO_API virtual std::shared_ptr<AudioTrackEncoder> Build(
-      const std::string &outputFilePath
+      const std::string &outputFilePath, std::uint64_t expectedByteCount = 0
     );
 
     /// <summary>Builds an audio track encoder that writes into a virtual file</summary>
@@ -0,0 +1,166 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_BACKGROUNDINDEXER_H
+#define NUCLEX_AUDIO_STORAGE_BACKGROUNDINDEXER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+  class AssetCatalog;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How far a background indexer has gotten through its files</summary>
+  struct NUCLEX_AUDIO_TYPE BackgroundIndexProgress {
+
+    /// <summary>Number of files that have been added to the indexer</summary>
+    public: std::size_t FileCount;
+    /// <summary>Number of files that were decoded and indexed</summary>
+    public: std::size_t IndexedFileCount;
+    /// <summary>Number of files whose records in the existing catalog were still current</summary>
+    public: std::size_t UpToDateFileCount;
+    /// <summary>Number of files that could not be indexed because of an error</summary>
+    public: std::size_t FailedFileCount;
+    /// <summary>Number of bytes the indexer has read from the files so far</summary>
+    public: std::uint64_t ReadByteCount;
+    /// <summary>Number of times a new catalog has been published</summary>
+    public: std::size_t PublishCount;
+    /// <summary>Error that occurred while last writing the catalog file, if any</summary>
+    public: std::exception_ptr PublishError;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an asset catalog in the background while the application runs</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for end-user machines where seek indices, waveform overviews and loudness
+  ///     measurements should be prepared ahead of time without hurting the frame rate.
+  ///     Each file is decoded in small steps that are submitted one at a time to the
+  ///     installed <see cref="Executor" /> with <see cref="TaskPriority.Idle" />, so any
+  ///     other work queued on the executor always goes first and the indexer never
+  ///     occupies more than a single worker.
+  ///   </para>
+  ///   <para>
+  ///     Reads can be limited to a number of bytes per second so that streaming audio
+  ///     and other assets don't compete with the indexer for the disk. When the indexer
+  ///     is ahead of its budget, the step waits for a few milliseconds and hands
+  ///     the worker back to the executor.
+  ///   </para>
+  ///   <para>
+  ///     Every few files, the records collected so far are published as a new catalog.
+  ///     The catalog file is written under a temporary name and then moved over the old
+  ///     one, so a crash or power loss leaves either the old or the new catalog, never a
+  ///     damaged one. The new catalog is also handed to the audio loader, if any, which
+  ///     starts using it right away. When an indexer is created for an existing catalog,
+  ///     files whose records still match their size and modification time are taken over
+  ///     without decoding them again, so indexing resumes where it left off.
+  ///   </para>
+  ///   <para>
+  ///     The published catalog holds the files added to the indexer. Records of other
+  ///     files in the existing catalog are dropped when the first new catalog is published.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE BackgroundIndexer {
+
+    /// <summary>Initializes a new background indexer</summary>
+    /// <param name="catalogPath">Path of the catalog file that will be written</param>
+    /// <param name="loader">
+    ///   Audio loader that is used to open the files and that will receive each newly
+    ///   published catalog. If null, the indexer uses a private audio loader.
+    /// </param>
+    public: NUCLEX_AUDIO_API BackgroundIndexer(
+      const std::string &catalogPath,
+      const std::shared_ptr<AudioLoader> &loader = std::shared_ptr<AudioLoader>()
+    );
+
+    /// <summary>Stops indexing and frees all resources owned by the instance</summary>
+    /// <remarks>
+    ///   Records collected since the last publication are not written. Call
+    ///   <see cref="Stop" /> with publishing enabled first if they should be kept.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~BackgroundIndexer();
+
+    /// <summary>Adds a file that should be indexed</summary>
+    /// <param name="path">Path of the audio file</param>
+    /// <remarks>
+    ///   Files can be added at any time, even while the indexer is running.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void AddFile(const std::string &path);
+
+    /// <summary>Limits how many bytes per second the indexer reads from the files</summary>
+    /// <param name="bytesPerSecond">Maximum average read rate, 0 for no limit</param>
+    public: NUCLEX_AUDIO_API void SetReadBudget(std::size_t bytesPerSecond);
+
+    /// <summary>Selects after how many files a new catalog is published</summary>
+    /// <param name="fileCount">Number of newly indexed files that trigger a publication</param>
+    /// <remarks>
+    ///   Each publication writes the whole catalog, so publishing after every single
+    ///   file gets expensive for large libraries. A catalog is always published when
+    ///   the indexer runs out of files.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetPublishInterval(std::size_t fileCount);
+
+    /// <summary>Starts or resumes indexing on the executor</summary>
+    /// <remarks>
+    ///   Does nothing if the indexer is already running. A file that was halfway
+    ///   decoded when the indexer was stopped continues where it was interrupted.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Start();
+
+    /// <summary>Stops indexing and waits for the step in progress to finish</summary>
+    /// <param name="publish">Whether to publish the records collected since the last time</param>
+    public: NUCLEX_AUDIO_API void Stop(bool publish = true);
+
+    /// <summary>Waits until the indexer has run out of files or has been stopped</summary>
+    public: NUCLEX_AUDIO_API void Wait() const;
+
+    /// <summary>Reports how far the indexer has gotten</summary>
+    /// <returns>The current progress of the indexer</returns>
+    public: NUCLEX_AUDIO_API BackgroundIndexProgress GetProgress() const;
+
+    /// <summary>Returns the catalog that was most recently published</summary>
+    /// <returns>The latest catalog or the existing one if none was published yet</returns>
+    public: NUCLEX_AUDIO_API std::shared_ptr<const AssetCatalog> GetCatalog() const;
+
+    /// <summary>Bookkeeping shared between the indexer and its scheduled steps</summary>
+    private: struct State;
+
+    /// <summary>State that remains alive as long as any step still references it</summary>
+    private: std::shared_ptr<State> state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_BACKGROUNDINDEXER_H
@@ -0,0 +1,215 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_BATCHTRANSCODER_H
+#define NUCLEX_AUDIO_STORAGE_BATCHTRANSCODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::shared_ptr
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class AudioLoader;
+  class AudioTrackEncoderBuilder;
+  class CancellationToken;
+  class EncodingProgressListener;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes how one audio file should be transcoded</summary>
+  struct NUCLEX_AUDIO_TYPE TranscodeJob {
+
+    /// <summary>File holding the audio track that will be transcoded</summary>
+    public: std::shared_ptr<const VirtualFile> Source;
+
+    /// <summary>File extension of the source file to speed up format detection</summary>
+    public: std::string SourceExtensionHint;
+
+    /// <summary>Encoder builder, already configured for the target format</summary>
+    /// <remarks>
+    ///   The transcoder sets the channels and the sample rate on the builder before it
+    ///   builds the encoder. Builders can be shared by any number of jobs, they are
+    ///   only used by one thread at a time.
+    /// </remarks>
+    public: std::shared_ptr<AudioTrackEncoderBuilder> TargetBuilder;
+
+    /// <summary>File into which the encoded audio will be written</summary>
+    public: std::shared_ptr<VirtualFile> Target;
+
+    /// <summary>Sample rate to convert to, if it should be changed</summary>
+    public: std::optional<std::size_t> TargetSampleRate;
+
+    /// <summary>Channels to mix to, empty to keep the channels of the source</summary>
+    /// <remarks>
+    ///   Mono and stereo targets are mixed down using the ITU-R BS.775 presets,
+    ///   larger layouts are filled via a simple upmix and layouts of the same size
+    ///   are routed by their placements.
+    /// </remarks>
+    public: std::vector<ChannelPlacement> TargetChannels;
+
+    /// <summary>Integrated loudness in LUFS to normalize to, if any</summary>
+    /// <remarks>
+    ///   Normalization has to know the loudness of the whole track before the first
+    ///   sample is encoded, so this adds a measurement pass over the source.
+    /// </remarks>
+    public: std::optional<double> TargetLoudness;
+
+    /// <summary>Token through which the job can be cancelled, if any</summary>
+    /// <remarks>
+    ///   The token is checked between chunks while decoding and between blocks while
+    ///   encoding. A cancelled job drops its decoded chunks and releases its decoder and
+    ///   encoder right away, its target file is left incomplete.
+    /// </remarks>
+    public: std::shared_ptr<const CancellationToken> Cancellation;
+
+    /// <summary>Listener that will be notified as the target file is encoded, if any</summary>
+    /// <remarks>
+    ///   The listener is called from whichever thread is encoding the file at the time,
+    ///   but never from two threads at once.
+    /// </remarks>
+    public: std::shared_ptr<EncodingProgressListener> Progress;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Results and throughput figures of a batch transcoding run</summary>
+  struct NUCLEX_AUDIO_TYPE TranscodeStatistics {
+
+    /// <summary>Number of jobs that completed successfully</summary>
+    public: std::size_t SucceededJobCount;
+
+    /// <summary>Number of jobs that failed</summary>
+    public: std::size_t FailedJobCount;
+
+    /// <summary>Number of jobs that were cancelled (also counted as failed)</summary>
+    public: std::size_t CancelledJobCount;
+
+    /// <summary>Total number of audio frames that were encoded</summary>
+    public: std::uint64_t EncodedFrameCount;
+
+    /// <summary>Total playback duration, in seconds, of all encoded audio</summary>
+    public: double EncodedSeconds;
+
+    /// <summary>Total number of bytes in the written target files</summary>
+    public: std::uint64_t WrittenByteCount;
+
+    /// <summary>Wall clock time, in seconds, the whole batch took</summary>
+    public: double ElapsedSeconds;
+
+    /// <summary>Largest number of bytes held by decoded chunks at any one time</summary>
+    public: std::size_t PeakInFlightByteCount;
+
+    /// <summary>Number of tasks that threads took from other threads' queues</summary>
+    public: std::size_t StolenTaskCount;
+
+    /// <summary>Errors of the jobs, in the order jobs were added, empty on success</summary>
+    public: std::vector<std::exception_ptr> Errors;
+
+    /// <summary>Calculates how many seconds of audio were transcoded per second</summary>
+    /// <returns>The number of times faster than real time the batch ran</returns>
+    public: double GetRealtimeFactor() const {
+      return (this->ElapsedSeconds > 0.0) ? (this->EncodedSeconds / this->ElapsedSeconds) : 0.0;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transcodes many audio files at once, using all CPU cores</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each file runs through a pipeline of stages: decoding, processing (resampling,
+  ///     remixing and normalization) and encoding. Decoding and processing hand their
+  ///     output to the encoding stage in chunks, so while one thread decodes the next
+  ///     chunk of a file, another thread can already be encoding the previous one.
+  ///   </para>
+  ///   <para>
+  ///     Stages are tasks in a work-stealing thread pool. Each thread has its own queue
+  ///     which it works through front to back, idle threads steal from the back of
+  ///     other threads' queues. The jobs are spread over the queues up front and the
+  ///     encoding stage of a file is queued at the front, so threads finish the files
+  ///     they started before they begin new ones.
+  ///   </para>
+  ///   <para>
+  ///     Decoded chunks that wait to be encoded count against a memory budget. When it is
+  ///     exhausted, decoding threads help encode waiting chunks instead of decoding more,
+  ///     so memory use stays bounded no matter how many files are in the batch.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE BatchTranscoder {
+
+    /// <summary>Initializes a new batch transcoder</summary>
+    /// <param name="threadCount">
+    ///   Number of threads that will transcode, zero to use one for each CPU core
+    /// </param>
+    /// <param name="maximumInFlightByteCount">
+    ///   Most memory, in bytes, that decoded chunks waiting to be encoded may occupy
+    /// </param>
+    public: NUCLEX_AUDIO_API BatchTranscoder(
+      std::size_t threadCount = 0,
+      std::size_t maximumInFlightByteCount = 64 * 1024 * 1024
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~BatchTranscoder();
+
+    /// <summary>Counts the jobs that have been added to the batch</summary>
+    /// <returns>The number of jobs that will be run</returns>
+    public: std::size_t CountJobs() const { return this->jobs.size(); }
+
+    /// <summary>Adds a file that should be transcoded to the batch</summary>
+    /// <param name="job">Description of the source, target and processing</param>
+    public: NUCLEX_AUDIO_API void AddJob(const TranscodeJob &job);
+
+    /// <summary>Transcodes all files in the batch and waits until they're done</summary>
+    /// <returns>The throughput statistics and errors of the batch</returns>
+    /// <remarks>
+    ///   Failing jobs don't stop the batch, their errors are reported in the returned
+    ///   statistics. The list of jobs is cleared afterwards.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API TranscodeStatistics Run();
+
+    /// <summary>Number of threads that will be transcoding</summary>
+    private: std::size_t threadCount;
+    /// <summary>Memory budget for decoded chunks waiting to be encoded</summary>
+    private: std::size_t maximumInFlightByteCount;
+    /// <summary>Loader used to open the decoders for the source files</summary>
+    private: std::shared_ptr<AudioLoader> loader;
+    /// <summary>Jobs that will be run by the next call to <see cref="Run" /></summary>
+    private: std::vector<TranscodeJob> jobs;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_BATCHTRANSCODER_H
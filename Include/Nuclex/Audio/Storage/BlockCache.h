@@ -0,0 +1,248 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_BLOCKCACHE_H
+#define NUCLEX_AUDIO_STORAGE_BLOCKCACHE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t
+#include <list> // for std::list
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class CachedFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size-bounded cache of file blocks that can be shared by many files</summary>
+  /// <remarks>
+  ///   <para>
+  ///     If the same audio file is opened multiple times (for example, to crossfade
+  ///     a music track into itself or to generate a waveform preview while it is playing),
+  ///     each decoder would normally read the same bytes from the file again. By wrapping
+  ///     the files with a block cache, all decoders of the same file share their reads.
+  ///   </para>
+  ///   <para>
+  ///     Files are identified by a string you provide (typically the path of the file)
+  ///     and their contents are cached in fixed-size blocks. When the memory limit is
+  ///     exceeded, the least recently used blocks are evicted. The cache assumes files
+  ///     do not change while they are cached - if a file is modified, call
+  ///     <see cref="Evict" /> with its identity.
+  ///   </para>
+  ///   <para>
+  ///     All methods are thread-safe. Blocks that are missing from the cache are read
+  ///     without holding the cache's lock, so two threads missing the same block at
+  ///     the same time may both read it.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE BlockCache {
+
+    /// <summary>Cached files need to access the cache's internal methods</summary>
+    friend class CachedFile;
+
+    /// <summary>Initializes a new block cache</summary>
+    /// <param name="memoryLimit">Maximum number of bytes the cached blocks may use</param>
+    /// <param name="blockSize">Size of the blocks in which files will be cached</param>
+    public: NUCLEX_AUDIO_API BlockCache(
+      std::size_t memoryLimit = 33554432, std::size_t blockSize = 65536
+    );
+
+    /// <summary>Frees all memory used by the block cache</summary>
+    public: NUCLEX_AUDIO_API ~BlockCache();
+
+    /// <summary>Returns the block cache instance shared by the whole process</summary>
+    /// <returns>The process-wide block cache</returns>
+    /// <remarks>
+    ///   The process-wide block cache starts out with the default memory limit and
+    ///   block size. Use <see cref="SetMemoryLimit" /> to size it for your platform.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static const std::shared_ptr<BlockCache> &GetProcessWideCache();
+
+    /// <summary>Wraps a file so that its reads go through a block cache</summary>
+    /// <param name="cache">Block cache through which reads will go</param>
+    /// <param name="file">File whose reads will be cached</param>
+    /// <param name="identity">
+    ///   Unique identity of the file's contents, such as its absolute path. Files with
+    ///   the same identity share their cached blocks.
+    /// </param>
+    /// <returns>A read-only file reading through the block cache</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> Wrap(
+      const std::shared_ptr<BlockCache> &cache,
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &identity
+    );
+
+    /// <summary>Returns the size of the blocks files are cached in</summary>
+    /// <returns>The size of a single cached block in bytes</returns>
+    public: std::size_t GetBlockSize() const { return this->blockSize; }
+
+    /// <summary>Returns the maximum number of bytes the cache may use</summary>
+    /// <returns>The cache's memory limit in bytes</returns>
+    public: std::size_t GetMemoryLimit() const {
+      return this->memoryLimit.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Changes the maximum number of bytes the cache may use</summary>
+    /// <param name="newMemoryLimit">New memory limit in bytes</param>
+    /// <remarks>
+    ///   If the cache currently uses more memory than the new limit allows,
+    ///   the least recently used blocks are evicted immediately.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetMemoryLimit(std::size_t newMemoryLimit);
+
+    /// <summary>Returns the number of bytes the cached blocks currently use</summary>
+    /// <returns>The memory currently used by cached blocks in bytes</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetMemoryUsage() const;
+
+    /// <summary>Counts the number of block reads that were served from the cache</summary>
+    /// <returns>The number of cache hits since the cache was created</returns>
+    public: std::uint64_t CountHits() const {
+      return this->hitCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts the number of block reads that had to go to the file</summary>
+    /// <returns>The number of cache misses since the cache was created</returns>
+    public: std::uint64_t CountMisses() const {
+      return this->missCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Removes all cached blocks belonging to the specified file</summary>
+    /// <param name="identity">Identity of the file whose blocks will be removed</param>
+    public: NUCLEX_AUDIO_API void Evict(const std::string &identity);
+
+    /// <summary>Removes all cached blocks</summary>
+    public: NUCLEX_AUDIO_API void Clear();
+
+    /// <summary>Looks up the numeric identifier assigned to a file identity</summary>
+    /// <param name="identity">Identity for which the identifier will be looked up</param>
+    /// <returns>The numeric identifier for the file identity</returns>
+    private: std::uint64_t getFileId(const std::string &identity);
+
+    /// <summary>Copies data from a cached block if it is present</summary>
+    /// <param name="fileId">Numeric identifier of the file the block belongs to</param>
+    /// <param name="blockIndex">Index of the block the data will be copied from</param>
+    /// <param name="offset">Offset within the block at which copying begins</param>
+    /// <param name="byteCount">Number of bytes that will be copied</param>
+    /// <param name="buffer">Buffer that will receive the copied data</param>
+    /// <returns>True if the block was cached and has been copied, false otherwise</returns>
+    private: bool tryCopyFromBlock(
+      std::uint64_t fileId, std::uint64_t blockIndex,
+      std::size_t offset, std::size_t byteCount, std::byte *buffer
+    );
+
+    /// <summary>Stores a freshly read block in the cache</summary>
+    /// <param name="fileId">Numeric identifier of the file the block belongs to</param>
+    /// <param name="blockIndex">Index of the block within the file</param>
+    /// <param name="contents">Contents of the block</param>
+    private: void storeBlock(
+      std::uint64_t fileId, std::uint64_t blockIndex, std::vector<std::byte> &&contents
+    );
+
+    /// <summary>Uniquely identifies a cached block</summary>
+    private: struct BlockKey {
+
+      /// <summary>Checks whether this key is identical to another key</summary>
+      /// <param name="other">Other key that will be compared against this one</param>
+      /// <returns>True if both keys are identical</returns>
+      public: bool operator ==(const BlockKey &other) const {
+        return (this->FileId == other.FileId) && (this->BlockIndex == other.BlockIndex);
+      }
+
+      /// <summary>Numeric identifier of the file the block belongs to</summary>
+      public: std::uint64_t FileId;
+      /// <summary>Index of the block within the file</summary>
+      public: std::uint64_t BlockIndex;
+
+    };
+
+    /// <summary>Calculates hash values for block keys</summary>
+    private: struct BlockKeyHash {
+
+      /// <summary>Calculates the hash value of a block key</summary>
+      /// <param name="key">Block key whose hash value will be calculated</param>
+      /// <returns>The hash value of the specified block key</returns>
+      public: std::size_t operator()(const BlockKey &key) const {
+        return std::hash<std::uint64_t>()(
+          (key.FileId * 0x9E3779B97F4A7C15ULL) ^ key.BlockIndex
+        );
+      }
+
+    };
+
+    /// <summary>Block that is being kept in the cache</summary>
+    private: struct CachedBlock {
+
+      /// <summary>Key under which the block is stored</summary>
+      public: BlockKey Key;
+      /// <summary>Contents of the cached block</summary>
+      public: std::vector<std::byte> Contents;
+
+    };
+
+    /// <summary>Evicts least recently used blocks until the memory limit is met</summary>
+    /// <param name="limit">Memory limit that should be met</param>
+    /// <remarks>The cache mutex must be held by the caller</remarks>
+    private: void evictUntilBelow(std::size_t limit);
+
+    /// <summary>List of cached blocks, the most recently used one at the front</summary>
+    private: typedef std::list<CachedBlock> CachedBlockList;
+    /// <summary>Allows cached blocks to be quickly looked up by their key</summary>
+    private: typedef std::unordered_map<
+      BlockKey, CachedBlockList::iterator, BlockKeyHash
+    > BlockMap;
+    /// <summary>Maps file identities to numeric file identifiers</summary>
+    private: typedef std::unordered_map<std::string, std::uint64_t> FileIdMap;
+
+    /// <summary>Size of the blocks in which files are cached</summary>
+    private: std::size_t blockSize;
+    /// <summary>Maximum number of bytes the cached blocks may use</summary>
+    private: std::atomic<std::size_t> memoryLimit;
+    /// <summary>Number of bytes the cached blocks currently use</summary>
+    private: std::size_t memoryUsage;
+    /// <summary>Number of reads that were served from the cache</summary>
+    private: std::atomic<std::uint64_t> hitCount;
+    /// <summary>Number of reads that had to go to the file</summary>
+    private: std::atomic<std::uint64_t> missCount;
+    /// <summary>Cached blocks ordered by how recently they were used</summary>
+    private: CachedBlockList blocks;
+    /// <summary>Index for quickly finding cached blocks</summary>
+    private: BlockMap blockMap;
+    /// <summary>Numeric identifiers that have been assigned to file identities</summary>
+    private: FileIdMap fileIds;
+    /// <summary>Mutex that must be held while accessing the cached blocks</summary>
+    private: mutable std::mutex cacheMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_BLOCKCACHE_H
@@ -0,0 +1,74 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_BLOCKCONTENT_H
+#define NUCLEX_AUDIO_STORAGE_BLOCKCONTENT_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>What a decoder can tell about a block without reconstructing its samples</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained via <see cref="AudioTrackDecoder.DescribeBlock" /> and
+  ///     <see cref="AudioTrackDecoder.ScanBlocks" />. Some codecs store blocks in which
+  ///     a channel holds the same value throughout in a special form. FLAC, for example,
+  ///     uses CONSTANT subframes for these, which usually means digital silence.
+  ///   </para>
+  ///   <para>
+  ///     A mixer can skip blocks flagged as silent and analysis stages can treat them as
+  ///     zeros without decoding them. Silence trimming only needs to decode the blocks
+  ///     at the edges of the audio track that are not flagged as silent.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE BlockContent {
+
+    /// <summary>Index of the first frame in the block</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of frames in the block</summary>
+    public: std::size_t FrameCount;
+    /// <summary>Whether the decoder looked at the block's encoded data</summary>
+    /// <remarks>
+    ///   If this is false, the other flags are false, too, but say nothing about
+    ///   the block. Decoders for codecs that don't flag constant blocks only report
+    ///   where their blocks begin and end.
+    /// </remarks>
+    public: bool IsKnown;
+    /// <summary>Whether each channel holds a single value throughout the block</summary>
+    /// <remarks>
+    ///   The value can differ between channels. A block that is not flagged as constant
+    ///   can still be constant if the codec chose not to encode it that way.
+    /// </remarks>
+    public: bool IsConstant;
+    /// <summary>Whether all samples in the block are zero</summary>
+    public: bool IsSilent;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_BLOCKCONTENT_H
@@ -0,0 +1,71 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_CANCELLATIONTOKEN_H
+#define NUCLEX_AUDIO_STORAGE_CANCELLATIONTOKEN_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Errors/CancelledError.h"
+
+#include <atomic> // for std::atomic
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lets long-running work be told to stop early</summary>
+  /// <remarks>
+  ///   The party that wants to be able to abort some work keeps the token and hands it to
+  ///   the worker, which checks it at convenient points (an encoder, for example, checks it
+  ///   between blocks). Cancelling is a request, not a forced stop, and can't be undone.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE CancellationToken {
+
+    /// <summary>Initializes a new cancellation token</summary>
+    public: CancellationToken() : isCancellationRequested(false) {}
+
+    /// <summary>Requests all work watching the token to stop</summary>
+    /// <remarks>Can be called from any thread</remarks>
+    public: void Cancel() noexcept {
+      this->isCancellationRequested.store(true, std::memory_order_release);
+    }
+
+    /// <summary>Checks whether cancellation has been requested</summary>
+    /// <returns>True if the work watching the token should stop</returns>
+    public: bool IsCancellationRequested() const noexcept {
+      return this->isCancellationRequested.load(std::memory_order_acquire);
+    }
+
+    /// <summary>Throws a cancelled error if cancellation has been requested</summary>
+    public: void ThrowIfCancellationRequested() const {
+      if(unlikely(IsCancellationRequested())) {
+        throw Errors::CancelledError(u8"The operation has been cancelled");
+      }
+    }
+
+    /// <summary>Whether cancellation has been requested</summary>
+    private: std::atomic<bool> isCancellationRequested;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_CANCELLATIONTOKEN_H
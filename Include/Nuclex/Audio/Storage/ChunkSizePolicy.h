@@ -0,0 +1,108 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_CHUNKSIZEPOLICY_H
+#define NUCLEX_AUDIO_STORAGE_CHUNKSIZEPOLICY_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decides how many frames the readers process per step</summary>
+  /// <remarks>
+  ///   <para>
+  ///     When decoding into a caller's buffer, the readers read or decode a chunk of
+  ///     frames into a scratch buffer, then convert, interleave and reorder it into
+  ///     the target. If the scratch buffer and the part of the target being written
+  ///     fit into the processor's cache together, each step finds its input still
+  ///     cached from the step before it. If the chunk is too small, the per-chunk
+  ///     overhead of the file and codec calls starts to dominate instead.
+  ///   </para>
+  ///   <para>
+  ///     The default policy budgets half of the L2 cache (but no less than the L1 cache)
+  ///     for a chunk and derives the frame count from the bytes each frame occupies.
+  ///     The budget can be set explicitly or the policy replaced entirely via
+  ///     <see cref="SetGlobal" /> to tune it for a platform. Readers look the policy
+  ///     up when they are created or when they decode, so it is best installed once
+  ///     at startup and must stay alive as long as it is installed.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ChunkSizePolicy {
+
+    /// <summary>Smallest number of frames a chunk will be reduced to</summary>
+    public: static constexpr std::size_t MinimumFrameCount = 64;
+
+    /// <summary>Returns the policy that the readers currently use</summary>
+    /// <returns>The currently active chunk size policy</returns>
+    public: NUCLEX_AUDIO_API static const ChunkSizePolicy &GetGlobal();
+
+    /// <summary>Changes the policy that the readers will use</summary>
+    /// <param name="policy">
+    ///   Policy that will be used from now on or nullptr to restore the default one.
+    ///   The caller retains ownership and must keep it alive while it is in use.
+    /// </param>
+    public: NUCLEX_AUDIO_API static void SetGlobal(const ChunkSizePolicy *policy);
+
+    /// <summary>Initializes a new chunk size policy</summary>
+    /// <param name="cacheBudget">
+    ///   Number of bytes a chunk's scratch and output memory may occupy together,
+    ///   zero to derive the budget from the processor's cache sizes
+    /// </param>
+    public: NUCLEX_AUDIO_API explicit ChunkSizePolicy(std::size_t cacheBudget = 0);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~ChunkSizePolicy() = default;
+
+    /// <summary>Returns the number of bytes a chunk may occupy in total</summary>
+    /// <returns>The cache budget for one chunk in bytes</returns>
+    public: std::size_t GetCacheBudget() const { return this->cacheBudget; }
+
+    /// <summary>Calculates the number of frames that should be processed per step</summary>
+    /// <param name="channelCount">Number of channels in each frame</param>
+    /// <param name="bytesPerScratchSample">
+    ///   Bytes each sample occupies in the reader's scratch buffer
+    /// </param>
+    /// <param name="bytesPerOutputSample">
+    ///   Bytes each sample occupies in the caller's target buffer
+    /// </param>
+    /// <returns>The number of frames to read, decode and convert in one step</returns>
+    /// <remarks>
+    ///   The result is a multiple of <see cref="MinimumFrameCount" />, which keeps
+    ///   the vectorized conversion loops from ending on partial batches.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API virtual std::size_t GetChunkFrameCount(
+      std::size_t channelCount,
+      std::size_t bytesPerScratchSample,
+      std::size_t bytesPerOutputSample
+    ) const;
+
+    /// <summary>Number of bytes a chunk's scratch and output memory may occupy</summary>
+    private: std::size_t cacheBudget;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_CHUNKSIZEPOLICY_H
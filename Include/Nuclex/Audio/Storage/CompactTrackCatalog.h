@@ -0,0 +1,207 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_COMPACTTRACKCATALOG_H
+#define NUCLEX_AUDIO_STORAGE_COMPACTTRACKCATALOG_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/TrackInfo.h"
+
+#include <chrono> // for std::chrono::microseconds
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs the informations of many audio tracks into a compact catalog file</summary>
+  /// <remarks>
+  ///   Each track is stored as a fixed 48 byte record. Codec names are replaced by
+  ///   a one-byte index into a table of distinct codec names and all other strings are
+  ///   interned into a shared string pool, so a catalog of millions of tracks stores
+  ///   'FLAC' once instead of millions of times.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE CompactTrackCatalogWriter {
+
+    /// <summary>Size of the fixed record each track is stored in</summary>
+    public: static constexpr std::size_t RecordByteCount = 48;
+
+    /// <summary>Initializes a new compact track catalog writer</summary>
+    public: NUCLEX_AUDIO_API CompactTrackCatalogWriter();
+
+    /// <summary>Frees all resources owned by the writer</summary>
+    public: NUCLEX_AUDIO_API ~CompactTrackCatalogWriter();
+
+    /// <summary>Adds the informations of an audio track to the catalog</summary>
+    /// <param name="track">Informations about the track that will be added</param>
+    /// <returns>The index under which the track can be looked up in the catalog</returns>
+    /// <remarks>
+    ///   Throws std::out_of_range if the track doesn't fit into the compact form, which
+    ///   would take more than 65535 channels, 256 distinct codec names or a sample rate,
+    ///   encoder delay or string pool beyond 4 GiB.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Add(const TrackInfo &track);
+
+    /// <summary>Counts the tracks that have been added to the catalog</summary>
+    /// <returns>The number of tracks in the catalog</returns>
+    public: std::size_t CountTracks() const {
+      return this->records.size() / RecordByteCount;
+    }
+
+    /// <summary>Writes the catalog into a file</summary>
+    /// <param name="target">File the catalog will be written into</param>
+    public: NUCLEX_AUDIO_API void Save(VirtualFile &target) const;
+
+    /// <summary>Stores a string in the string pool unless it is there already</summary>
+    /// <param name="value">String that will be stored in the pool</param>
+    /// <returns>The offset of the string within the pool</returns>
+    private: std::uint32_t intern(const std::string &value);
+
+    /// <summary>Looks up strings already stored in the pool by their contents</summary>
+    private: typedef std::unordered_map<std::string, std::uint32_t> StringOffsetMap;
+
+    /// <summary>Fixed-size records of all tracks that have been added</summary>
+    private: std::vector<std::byte> records;
+    /// <summary>Strings and variable-length data referenced by the records</summary>
+    private: std::vector<std::byte> pool;
+    /// <summary>Offsets of the distinct codec names in the string pool</summary>
+    private: std::vector<std::uint32_t> codecNameOffsets;
+    /// <summary>Offsets of the strings that have been interned so far</summary>
+    private: StringOffsetMap internedStrings;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accesses the track informations stored in a compact catalog file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The catalog works directly on the file's memory when the file can lend it out,
+  ///     as memory-mapped files can, so opening even a catalog of millions of tracks
+  ///     costs only the mapping and nothing is parsed up front. The catalog is
+  ///     immutable and can be used from any number of threads.
+  ///   </para>
+  ///   <para>
+  ///     The accessors for the fixed fields read straight from a track's record.
+  ///     <see cref="GetTrackInfo" /> rebuilds the complete <see cref="TrackInfo" />,
+  ///     which only allocates for the strings and markers the track actually has.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE CompactTrackCatalog {
+
+    /// <summary>Opens a compact track catalog by mapping it into memory</summary>
+    /// <param name="path">Path of the catalog file that will be opened</param>
+    /// <returns>The catalog stored in the specified file</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const CompactTrackCatalog> Open(
+      const std::string &path
+    );
+
+    /// <summary>Initializes a new compact track catalog accessing the specified file</summary>
+    /// <param name="file">File holding the catalog</param>
+    /// <remarks>
+    ///   A CorruptedFileError is thrown if the file is not a compact track catalog.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API explicit CompactTrackCatalog(
+      const std::shared_ptr<const VirtualFile> &file
+    );
+
+    /// <summary>Frees all resources owned by the catalog</summary>
+    public: NUCLEX_AUDIO_API ~CompactTrackCatalog();
+
+    /// <summary>Counts the tracks stored in the catalog</summary>
+    /// <returns>The number of tracks in the catalog</returns>
+    public: std::size_t CountTracks() const { return this->trackCount; }
+
+    /// <summary>Rebuilds the complete informations of a track</summary>
+    /// <param name="trackIndex">Index of the track whose informations will be returned</param>
+    /// <returns>The informations about the track as they were added to the catalog</returns>
+    public: NUCLEX_AUDIO_API TrackInfo GetTrackInfo(std::size_t trackIndex) const;
+
+    /// <summary>Looks up the name of the codec that stores a track</summary>
+    /// <param name="trackIndex">Index of the track whose codec name will be returned</param>
+    /// <returns>The name of the codec the track is stored with</returns>
+    public: NUCLEX_AUDIO_API const std::string &GetCodecName(std::size_t trackIndex) const;
+
+    /// <summary>Looks up the number of channels in a track</summary>
+    /// <param name="trackIndex">Index of the track whose channel count will be returned</param>
+    /// <returns>The number of audio channels in the track</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetChannelCount(std::size_t trackIndex) const;
+
+    /// <summary>Looks up the sample rate of a track</summary>
+    /// <param name="trackIndex">Index of the track whose sample rate will be returned</param>
+    /// <returns>The number of frames per second in the track</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetSampleRate(std::size_t trackIndex) const;
+
+    /// <summary>Looks up the exact number of frames in a track</summary>
+    /// <param name="trackIndex">Index of the track whose frame count will be returned</param>
+    /// <returns>The number of frames the track's decoder will deliver</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t GetFrameCount(std::size_t trackIndex) const;
+
+    /// <summary>Looks up the duration of a track</summary>
+    /// <param name="trackIndex">Index of the track whose duration will be returned</param>
+    /// <returns>The playback duration of the track</returns>
+    public: NUCLEX_AUDIO_API std::chrono::microseconds GetDuration(
+      std::size_t trackIndex
+    ) const;
+
+    /// <summary>Returns the fixed-size record of a track</summary>
+    /// <param name="trackIndex">Index of the track whose record will be returned</param>
+    /// <returns>The address of the track's record</returns>
+    private: const std::byte *getRecord(std::size_t trackIndex) const;
+
+    /// <summary>Reads a string from the string pool</summary>
+    /// <param name="offset">Offset of the string within the pool</param>
+    /// <returns>The string stored at the specified offset</returns>
+    private: std::string readString(std::uint32_t offset) const;
+
+    /// <summary>File holding the catalog, kept alive while its memory is being used</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Copy of the file's contents if the file couldn't lend out its memory</summary>
+    private: std::vector<std::byte> contents;
+    /// <summary>Memory holding the catalog</summary>
+    private: const std::byte *data;
+    /// <summary>Length of the catalog in bytes</summary>
+    private: std::size_t length;
+    /// <summary>Number of tracks stored in the catalog</summary>
+    private: std::size_t trackCount;
+    /// <summary>Offset of the first track record in the catalog</summary>
+    private: std::size_t recordsOffset;
+    /// <summary>Offset of the string pool in the catalog</summary>
+    private: std::size_t poolOffset;
+    /// <summary>Length of the string pool in bytes</summary>
+    private: std::size_t poolLength;
+    /// <summary>Distinct codec names, decoded once when the catalog is opened</summary>
+    private: std::vector<std::string> codecNames;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_COMPACTTRACKCATALOG_H
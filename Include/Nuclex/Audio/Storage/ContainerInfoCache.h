@@ -0,0 +1,167 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_CONTAINERINFOCACHE_H
+#define NUCLEX_AUDIO_STORAGE_CONTAINERINFOCACHE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+
+#include <atomic> // for std::atomic
+#include <cstdint> // for std::uint64_t
+#include <mutex> // for std::mutex
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Remembers the container informations of files that have been probed</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Reading the informations of an audio file means opening it and letting codecs
+  ///     parse its headers, which adds up for tools that list thousands of files each
+  ///     time they start. Assign this cache to an <see cref="AudioLoader" /> and
+  ///     <see cref="AudioLoader.TryReadInfo" /> will answer from the cache for any
+  ///     file whose path, size and modification time are unchanged.
+  ///   </para>
+  ///   <para>
+  ///     Files no codec could read are remembered as well, so unsupported files in
+  ///     a directory do not get probed by every codec again. The cache can be saved
+  ///     to and loaded from a file to keep it across application runs.
+  ///   </para>
+  ///   <para>
+  ///     All methods are thread-safe, so one cache can be shared by several audio loaders.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ContainerInfoCache {
+
+    /// <summary>Initializes a new, empty container info cache</summary>
+    public: NUCLEX_AUDIO_API ContainerInfoCache();
+
+    /// <summary>Frees all resources owned by the cache</summary>
+    public: NUCLEX_AUDIO_API ~ContainerInfoCache();
+
+    /// <summary>Looks up the cached informations for a file</summary>
+    /// <param name="path">Path of the file whose informations will be looked up</param>
+    /// <param name="size">Current size of the file in bytes</param>
+    /// <param name="modificationTime">Current modification time of the file</param>
+    /// <param name="info">
+    ///   Receives the cached informations, empty if no codec could read the file
+    /// </param>
+    /// <returns>True if the cache held up-to-date informations for the file</returns>
+    public: NUCLEX_AUDIO_API bool TryLookup(
+      const std::string &path,
+      std::uint64_t size,
+      std::uint64_t modificationTime,
+      std::optional<ContainerInfo> &info
+    ) const;
+
+    /// <summary>Stores the informations for a file in the cache</summary>
+    /// <param name="path">Path of the file the informations were read from</param>
+    /// <param name="size">Size of the file in bytes</param>
+    /// <param name="modificationTime">Modification time of the file</param>
+    /// <param name="info">Informations read from the file, empty if unsupported</param>
+    public: NUCLEX_AUDIO_API void Store(
+      const std::string &path,
+      std::uint64_t size,
+      std::uint64_t modificationTime,
+      const std::optional<ContainerInfo> &info
+    );
+
+    /// <summary>Removes the cached informations for a file</summary>
+    /// <param name="path">Path of the file whose informations will be removed</param>
+    /// <returns>True if the cache had held informations for the file</returns>
+    /// <remarks>
+    ///   Changed files are detected by their size and modification time, so this is only
+    ///   needed when a file was replaced in a way that kept both the same.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API bool Invalidate(const std::string &path);
+
+    /// <summary>Removes all cached informations</summary>
+    public: NUCLEX_AUDIO_API void Clear();
+
+    /// <summary>Counts the number of files the cache holds informations for</summary>
+    /// <returns>The number of cached files</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountEntries() const;
+
+    /// <summary>Counts the lookups that were answered from the cache</summary>
+    /// <returns>The number of successful lookups</returns>
+    public: std::uint64_t CountHits() const {
+      return this->hitCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts the lookups that found no up-to-date informations</summary>
+    /// <returns>The number of failed lookups</returns>
+    public: std::uint64_t CountMisses() const {
+      return this->missCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Resets the hit and miss counters to zero</summary>
+    public: NUCLEX_AUDIO_API void ResetStatistics();
+
+    /// <summary>Writes the cached informations into a file</summary>
+    /// <param name="target">File the cache will be written into</param>
+    public: NUCLEX_AUDIO_API void Save(VirtualFile &target) const;
+
+    /// <summary>Adds the informations from a previously saved cache</summary>
+    /// <param name="source">File that was written by <see cref="Save" /></param>
+    /// <remarks>
+    ///   Entries already in the cache are replaced by those loaded from the file.
+    ///   A file that is not a saved cache causes a CorruptedFileError.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Load(const VirtualFile &source);
+
+    /// <summary>Cached informations about a single file</summary>
+    private: struct Entry {
+
+      /// <summary>Size the file had when its informations were read</summary>
+      public: std::uint64_t Size;
+      /// <summary>Modification time the file had when its informations were read</summary>
+      public: std::uint64_t ModificationTime;
+      /// <summary>Informations read from the file, empty if no codec could read it</summary>
+      public: std::optional<ContainerInfo> Info;
+
+    };
+
+    /// <summary>Maps file paths to the cached informations about each file</summary>
+    private: typedef std::unordered_map<std::string, Entry> EntryMap;
+
+    /// <summary>Must be held while accessing the entries</summary>
+    private: mutable std::mutex entryMutex;
+    /// <summary>Cached informations about files by their paths</summary>
+    private: EntryMap entries;
+    /// <summary>Number of lookups answered from the cache</summary>
+    private: mutable std::atomic<std::uint64_t> hitCount;
+    /// <summary>Number of lookups that found no up-to-date informations</summary>
+    private: mutable std::atomic<std::uint64_t> missCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_CONTAINERINFOCACHE_H
@@ -0,0 +1,56 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODEFIDELITY_H
+#define NUCLEX_AUDIO_STORAGE_DECODEFIDELITY_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How much work a lossy decoder should put into the sound of its output</summary>
+  /// <remarks>
+  ///   Some codecs have optional processing that slightly improves the decoded audio but
+  ///   costs CPU time. A decoder set to a lower fidelity skips it, so more streams can be
+  ///   decoded under the same CPU budget. Lossless decoders always produce exact output.
+  /// </remarks>
+  enum class DecodeFidelity {
+
+    /// <summary>Skip all optional processing, for as many streams as possible</summary>
+    Reduced = -1,
+
+    /// <summary>Decode the way the codec library does by default</summary>
+    Standard = 0,
+
+    /// <summary>Use every enhancement the codec library offers, whatever the cost</summary>
+    /// <remarks>
+    ///   For Opus, this enables the neural packet loss concealment and speech
+    ///   enhancement of libopus 1.5 and later if libopus was built with them.
+    /// </remarks>
+    Enhanced = 1
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODEFIDELITY_H
@@ -0,0 +1,95 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODELATENCYTRACKER_H
+#define NUCLEX_AUDIO_STORAGE_DECODELATENCYTRACKER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/LatencyHistogram.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decoding times of one codec for calls of a certain size</summary>
+  struct NUCLEX_AUDIO_TYPE DecodeLatencyGroup {
+
+    /// <summary>Name of the codec whose decoders made the calls</summary>
+    public: std::string CodecName;
+    /// <summary>Fewest frames requested by a call in this group</summary>
+    public: std::size_t MinimumFrameCount;
+    /// <summary>Most frames requested by a call in this group</summary>
+    /// <remarks>
+    ///   For the group collecting the largest calls, this is the highest value
+    ///   a std::size_t can hold.
+    /// </remarks>
+    public: std::size_t MaximumFrameCount;
+    /// <summary>Distribution of the wall time the calls took</summary>
+    public: LatencyHistogram Latencies;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the wall time of decoding calls made by all decoders</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for the audio thread of a game or player: turn it on, then poll
+  ///     <see cref="TakeSnapshot" /> with reset enabled once per second to see how long
+  ///     decoding calls took in that second, grouped by codec and by the number of frames
+  ///     each call requested. Times include waiting for other threads using the same
+  ///     decoder, since that is what the calling thread experiences.
+  ///   </para>
+  ///   <para>
+  ///     While disabled, each decoding call pays for one relaxed atomic load. For the
+  ///     times of a single decoder instead, see
+  ///     <see cref="AudioTrackDecoder.GetDecodeLatencies" />.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE DecodeLatencyTracker {
+
+    /// <summary>Starts or stops recording decoding times</summary>
+    /// <param name="enable">True to start recording, false to stop</param>
+    /// <remarks>
+    ///   Turning recording on while it was off empties all histograms.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Enable(bool enable = true);
+
+    /// <summary>Checks whether decoding times are currently being recorded</summary>
+    /// <returns>True if decoding times are being recorded</returns>
+    public: NUCLEX_AUDIO_API static bool IsEnabled();
+
+    /// <summary>Copies the decoding times recorded so far</summary>
+    /// <param name="reset">Whether to empty the histograms while copying them</param>
+    /// <returns>One group for each codec and call size that has recorded any calls</returns>
+    public: NUCLEX_AUDIO_API static std::vector<DecodeLatencyGroup> TakeSnapshot(
+      bool reset = false
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODELATENCYTRACKER_H
@@ -0,0 +1,90 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODEPATH_H
+#define NUCLEX_AUDIO_STORAGE_DECODEPATH_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the work a decoder does to deliver samples in a specific format</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained via <see cref="AudioTrackDecoder.ExplainDecodePath" />. Meant to answer
+  ///     the question why one output format decodes faster than another, for example
+  ///     that WavPack delivers its native format straight into the caller's buffer while
+  ///     any other format goes through a scratch buffer and a conversion pass.
+  ///   </para>
+  ///   <para>
+  ///     The description is derived from the same properties the decoder uses to pick
+  ///     its code path, but nothing is decoded to produce it. Whether a file can lend
+  ///     its memory is checked at the start of the audio data only.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE DecodePath {
+
+    /// <summary>Summarizes the decode path in a single line</summary>
+    /// <returns>
+    ///   A line such as &quot;WavPack int32 native -&gt; Reconstruct SSE2 -&gt; separate,
+    ///   3 passes, 1 scratch buffer&quot;, suitable for logging
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::string ToString() const;
+
+    /// <summary>Where the samples come from before any of the steps run</summary>
+    /// <remarks>
+    ///   Names the codec and the format in which it produces samples,
+    ///   i.e. &quot;FLAC int32 separated&quot; or &quot;Waveform float32 memory&quot;.
+    /// </remarks>
+    public: std::string Origin;
+    /// <summary>Operations applied to the samples, in the order they run</summary>
+    /// <remarks>
+    ///   Steps that use SIMD instructions name the instruction set,
+    ///   i.e. &quot;Quantize AVX2&quot;. Empty if the samples are delivered as-is.
+    /// </remarks>
+    public: std::vector<std::string> Steps;
+    /// <summary>Number of times the samples are walked through on their way out</summary>
+    /// <remarks>
+    ///   Steps that are fused into one loop count as a single pass. A codec library
+    ///   decoding into a buffer and uncompressed data being read into a buffer count
+    ///   as passes, too, while a codec library decoding into its own memory does not.
+    /// </remarks>
+    public: std::size_t PassCount;
+    /// <summary>Number of intermediate buffers the samples are stored in</summary>
+    public: std::size_t ScratchBufferCount;
+    /// <summary>Whether the encoded data is accessed in the file's own memory</summary>
+    /// <remarks>
+    ///   True when the file lends its memory (memory-mapped or in-memory files), so
+    ///   the encoded data doesn't need to be read into a buffer before it's decoded.
+    /// </remarks>
+    public: bool IsZeroCopy;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODEPATH_H
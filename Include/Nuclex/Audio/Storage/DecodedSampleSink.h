@@ -0,0 +1,118 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODEDSAMPLESINK_H
+#define NUCLEX_AUDIO_STORAGE_DECODEDSAMPLESINK_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Read-only view of a block of samples as the codec decoded them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The samples stay in whatever buffer the codec decoded them into, so they're only
+  ///     valid until the sink returns. The format states how the samples are stored:
+  ///     unsigned 8-bit samples are std::uint8_t centered on 128, 16-bit samples are
+  ///     std::int16_t, 32-bit samples std::int32_t, 32-bit floats are float and 64-bit
+  ///     floats are double. There is no packed 24-bit format.
+  ///   </para>
+  ///   <para>
+  ///     Signed integer samples are right-aligned with <see cref="BitsPerSample" /> valid
+  ///     bits, so 24-bit audio in std::int32_t samples ranges from -8388608 to +8388607.
+  ///     That is how FLAC delivers its samples (in std::int32_t, whatever the bit depth)
+  ///     and saves the caller from undoing a shift to get the original values.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE DecodedSamples {
+
+    /// <summary>Format the samples are stored in</summary>
+    public: AudioSampleFormat Format;
+    /// <summary>Number of valid bits in each sample</summary>
+    public: std::size_t BitsPerSample;
+    /// <summary>Index of the first frame in the block</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of frames in the block</summary>
+    public: std::size_t FrameCount;
+    /// <summary>Number of channels in the block</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Whether the channels are interleaved into a single buffer</summary>
+    public: bool IsInterleaved;
+    /// <summary>Buffers holding the samples</summary>
+    /// <remarks>
+    ///   If the channels are interleaved, only the first buffer is used and holds
+    ///   <see cref="FrameCount" /> x <see cref="ChannelCount" /> samples. Otherwise,
+    ///   there is one buffer holding <see cref="FrameCount" /> samples for each channel.
+    /// </remarks>
+    public: const void *const *Buffers;
+
+    /// <summary>Returns a buffer holding samples as the specified type</summary>
+    /// <typeparam name="TSample">Type the samples are stored as</typeparam>
+    /// <param name="index">Index of the channel or 0 for interleaved samples</param>
+    /// <returns>The address of the buffer's first sample</returns>
+    public: template<typename TSample>
+    const TSample *GetBuffer(std::size_t index = 0) const {
+      return static_cast<const TSample *>(this->Buffers[index]);
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives decoded samples straight from the codec's buffers</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Decoding into a caller-provided buffer means the samples get copied at least
+  ///     once, usually while they're converted to the requested sample type. Tools that
+  ///     analyze samples as soon as they're decoded don't need that copy. Implement
+  ///     this interface and pass it to <see cref="AudioTrackDecoder.DecodeRange" /> to be
+  ///     handed the codec's own buffers in its native format.
+  ///   </para>
+  ///   <para>
+  ///     The sink is called while the decoder is busy, so it must not call back into
+  ///     the same decoder. Exceptions thrown by the sink abort decoding and are passed
+  ///     on to the caller of DecodeRange().
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE DecodedSampleSink {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~DecodedSampleSink() = default;
+
+    /// <summary>Processes a block of decoded samples</summary>
+    /// <param name="samples">View of the decoded samples, valid until this returns</param>
+    /// <remarks>
+    ///   Blocks arrive in order and cover the requested range without gaps. Their size
+    ///   depends on the codec, FLAC delivers one FLAC frame per call, for example.
+    /// </remarks>
+    public: virtual void ProcessSamples(const DecodedSamples &samples) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODEDSAMPLESINK_H
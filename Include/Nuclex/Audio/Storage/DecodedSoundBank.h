@@ -0,0 +1,145 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODEDSOUNDBANK_H
+#define NUCLEX_AUDIO_STORAGE_DECODEDSOUNDBANK_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class SoundBank;
+  class AudioLoader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Location of a fully decoded clip within a decoded sound bank</summary>
+  struct NUCLEX_AUDIO_TYPE DecodedClip {
+
+    /// <summary>Index of the clip's first sample in the bank's sample arena</summary>
+    public: std::size_t Offset;
+    /// <summary>Number of frames the clip consists of</summary>
+    public: std::size_t FrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sound bank whose clips are fully decoded in the mixer's format</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for the hottest tiny sound effects (footsteps, UI clicks) where any work
+  ///     at playback time is too much. All clips of a <see cref="SoundBank" /> are decoded,
+  ///     resampled and remixed at load time, spread over several threads, into one large
+  ///     arena of interleaved float samples in the target sample rate and channel order.
+  ///   </para>
+  ///   <para>
+  ///     Each clip then is just an offset and length within the arena. Clips begin on
+  ///     64 byte boundaries, keep the indices they had in the sound bank (so names can be
+  ///     looked up via <see cref="SoundBank.TryFindClip" />) and don't depend on the sound
+  ///     bank anymore once decoding has finished. The decoded bank is immutable and can be
+  ///     read from any number of threads.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE DecodedSoundBank {
+
+    /// <summary>Decodes all clips of a sound bank into memory</summary>
+    /// <param name="bank">Sound bank whose clips will be decoded</param>
+    /// <param name="loader">Audio loader providing the codecs</param>
+    /// <param name="sampleRate">Sample rate the mixer will play back at</param>
+    /// <param name="channelOrder">Channels the mixer expects, in interleaving order</param>
+    /// <param name="threadCount">
+    ///   Number of threads decoding clips concurrently, 0 to use one per CPU core
+    /// </param>
+    /// <remarks>
+    ///   Clips with more channels than the mixer's are mixed down (using the ITU presets
+    ///   for stereo and mono targets), clips with fewer channels are upmixed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API DecodedSoundBank(
+      const SoundBank &bank,
+      const AudioLoader &loader,
+      std::size_t sampleRate = 48000,
+      const std::vector<ChannelPlacement> &channelOrder = {
+        ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight
+      },
+      std::size_t threadCount = 0
+    );
+
+    /// <summary>Frees the memory holding the decoded clips</summary>
+    public: NUCLEX_AUDIO_API ~DecodedSoundBank();
+
+    /// <summary>Counts the clips in the decoded sound bank</summary>
+    /// <returns>The number of decoded clips</returns>
+    public: std::size_t CountClips() const { return this->clips.size(); }
+
+    /// <summary>Counts the channels all clips have been mixed to</summary>
+    /// <returns>The number of interleaved channels in each clip</returns>
+    public: std::size_t CountChannels() const { return this->channelOrder.size(); }
+
+    /// <summary>Retrieves the sample rate all clips have been resampled to</summary>
+    /// <returns>The number of frames played back per second</returns>
+    public: std::size_t GetSampleRate() const { return this->sampleRate; }
+
+    /// <summary>Retrieves the channels all clips have been mixed to</summary>
+    /// <returns>The placement of each channel, in interleaving order</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const {
+      return this->channelOrder;
+    }
+
+    /// <summary>Looks up where a clip is stored in the sample arena</summary>
+    /// <param name="clipIndex">Index of the clip that will be looked up</param>
+    /// <returns>The offset and length of the clip</returns>
+    public: const DecodedClip &GetClip(std::size_t clipIndex) const {
+      return this->clips.at(clipIndex);
+    }
+
+    /// <summary>Returns the interleaved samples of a clip</summary>
+    /// <param name="clipIndex">Index of the clip whose samples will be returned</param>
+    /// <returns>The address of the clip's first sample</returns>
+    public: const float *GetSamples(std::size_t clipIndex) const {
+      return this->arena.data() + this->clips.at(clipIndex).Offset;
+    }
+
+    /// <summary>Returns the memory holding the samples of all clips</summary>
+    /// <returns>The sample arena holding all decoded clips</returns>
+    public: const SampleVector<float> &GetArena() const { return this->arena; }
+
+    /// <summary>Sample rate the clips have been resampled to</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Channels the clips have been mixed to</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Location of each clip within the sample arena</summary>
+    private: std::vector<DecodedClip> clips;
+    /// <summary>Memory holding the samples of all clips</summary>
+    private: SampleVector<float> arena;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODEDSOUNDBANK_H
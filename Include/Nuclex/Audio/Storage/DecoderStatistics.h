@@ -0,0 +1,69 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DECODERSTATISTICS_H
+#define NUCLEX_AUDIO_STORAGE_DECODERSTATISTICS_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counters describing the work a decoder has done so far</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained via <see cref="AudioTrackDecoder.GetStatistics" /> after statistics were
+  ///     turned on via <see cref="AudioTrackDecoder.EnableStatistics" />. All figures cover
+  ///     the time since statistics were enabled.
+  ///   </para>
+  ///   <para>
+  ///     Each counter is updated on its own, so a snapshot taken while another thread is
+  ///     decoding may include the frames of a decoding call but not yet its time.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE DecoderStatistics {
+
+    /// <summary>Number of frames handed out to callers</summary>
+    public: std::uint64_t DecodedFrameCount;
+    /// <summary>Number of times the decoder had to jump to another position</summary>
+    public: std::uint64_t SeekCount;
+    /// <summary>Frames the codec decoded and threw away to land on a seek target</summary>
+    /// <remarks>
+    ///   Only counts frames the library discards itself. WavPack skips within a block
+    ///   inside the codec library, where this is not visible.
+    /// </remarks>
+    public: std::uint64_t DiscardedFrameCount;
+    /// <summary>Number of bytes read from the decoder's virtual file</summary>
+    public: std::uint64_t ReadByteCount;
+    /// <summary>Total time spent inside decoding calls, excluding lock wait time</summary>
+    public: std::chrono::nanoseconds DecodeTime;
+    /// <summary>Total time decoding calls waited for other threads using the decoder</summary>
+    public: std::chrono::nanoseconds LockWaitTime;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DECODERSTATISTICS_H
@@ -0,0 +1,128 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_EFFORTCALIBRATOR_H
+#define NUCLEX_AUDIO_STORAGE_EFFORTCALIBRATOR_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t
+#include <map> // for std::map
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+  class AudioTrackEncoderBuilder;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encoding speed and output size measured at one compression effort</summary>
+  struct NUCLEX_AUDIO_TYPE EffortMeasurement {
+
+    /// <summary>Compression effort the sample was encoded with</summary>
+    public: float Effort;
+    /// <summary>Number of bytes the encoder produced</summary>
+    public: std::uint64_t EncodedByteCount;
+    /// <summary>Time the encoder took in seconds</summary>
+    public: double EncodingSeconds;
+    /// <summary>Playback duration encoded per second of encoding time</summary>
+    public: double RealtimeFactor;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the compression efforts of an encoder to pick a good compromise</summary>
+  /// <remarks>
+  ///   <para>
+  ///     <see cref="AudioTrackEncoderBuilder.SetCompressionEffort" /> is an abstract knob that
+  ///     maps differently onto each codec. For batch encoding, the interesting question is
+  ///     how many bytes a higher effort saves for the CPU time it costs. This encodes
+  ///     a representative sample at several effort levels and recommends the one that saves
+  ///     the most bytes per second spent encoding.
+  ///   </para>
+  ///   <para>
+  ///     The recommendations can be stored per codec in a small text file and loaded again
+  ///     by the encoding tool, so builders are configured from measured data instead of
+  ///     guesses. Measurements are only meaningful on the machine they were taken on.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE EffortCalibrator {
+
+    /// <summary>Encodes a sample at different compression efforts</summary>
+    /// <param name="sample">Decoder providing the representative sample</param>
+    /// <param name="sampleRate">Sample rate of the sample in samples per second</param>
+    /// <param name="builder">
+    ///   Builder of the encoder being calibrated. Sample rate, channels and thread count
+    ///   will be overwritten, any other settings (such as the bitrate) are kept.
+    /// </param>
+    /// <param name="efforts">Compression efforts that will be measured</param>
+    /// <returns>A measurement for each of the specified compression efforts</returns>
+    /// <remarks>
+    ///   The sample is decoded into memory once and encoded into memory so that only
+    ///   the encoder itself is timed. The encoder runs on a single thread to make the
+    ///   measured time equal the CPU time it consumed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::vector<EffortMeasurement> Measure(
+      const AudioTrackDecoder &sample,
+      std::size_t sampleRate,
+      AudioTrackEncoderBuilder &builder,
+      const std::vector<float> &efforts = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f }
+    );
+
+    /// <summary>Picks the effort that saves the most bytes per second of encoding</summary>
+    /// <param name="measurements">Measurements taken at different efforts</param>
+    /// <returns>The recommended compression effort</returns>
+    /// <remarks>
+    ///   Savings are counted against the largest output among the measurements. If no
+    ///   effort saves anything (as with uncompressed formats), the fastest one is picked.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static float RecommendEffort(
+      const std::vector<EffortMeasurement> &measurements
+    );
+
+    /// <summary>Writes recommended compression efforts into a file</summary>
+    /// <param name="recommendations">Recommended compression effort for each codec</param>
+    /// <param name="target">File the recommendations will be written into</param>
+    /// <remarks>
+    ///   The file contains one line per codec in the form <c>name=effort</c>.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void SaveRecommendations(
+      const std::map<std::string, float> &recommendations, VirtualFile &target
+    );
+
+    /// <summary>Reads recommended compression efforts from a file</summary>
+    /// <param name="source">File that was written by <see cref="SaveRecommendations" /></param>
+    /// <returns>The recommended compression effort for each codec</returns>
+    public: NUCLEX_AUDIO_API static std::map<std::string, float> LoadRecommendations(
+      const VirtualFile &source
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_EFFORTCALIBRATOR_H
@@ -0,0 +1,119 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_EMBEDDEDSTREAMSCANNER_H
+#define NUCLEX_AUDIO_STORAGE_EMBEDDEDSTREAMSCANNER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class CancellationToken;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio file formats the embedded stream scanner can recognize</summary>
+  enum class EmbeddedStreamFormat {
+
+    /// <summary>Microsoft Waveform file (RIFF, RIFX, RF64 or BW64)</summary>
+    Waveform = 0,
+
+    /// <summary>Native FLAC stream starting with the 'fLaC' signature</summary>
+    Flac = 1,
+
+    /// <summary>Ogg container whose first logical stream holds Opus audio</summary>
+    Opus = 2,
+
+    /// <summary>Ogg container whose first logical stream holds Vorbis audio</summary>
+    Vorbis = 3,
+
+    /// <summary>WavPack stream made up of 'wvpk' blocks</summary>
+    WavPack = 4
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio file found inside a larger blob</summary>
+  struct EmbeddedStream {
+
+    /// <summary>Offset of the audio file's first byte within the blob</summary>
+    public: std::uint64_t Start;
+    /// <summary>Length of the audio file in bytes</summary>
+    public: std::uint64_t Length;
+    /// <summary>Format of the audio file</summary>
+    public: EmbeddedStreamFormat Format;
+    /// <summary>Whether the length was taken from the file's own framing</summary>
+    /// <remarks>
+    ///   FLAC streams do not record their length anywhere, so they are assumed to extend
+    ///   up to the next audio file found or the end of the blob. Decoders stop at the last
+    ///   valid frame, so trailing data is harmless unless it's another FLAC stream.
+    /// </remarks>
+    public: bool IsLengthExact;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates audio files stored inside game archives and other opaque blobs</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Pack files from old games or proprietary engines often just concatenate the files
+  ///     they contain, possibly with their own headers in between. The scanner reads
+  ///     through such a blob in large windows, uses SIMD comparisons to find the magic
+  ///     bytes that start Waveform, FLAC, Ogg and WavPack files, then runs each candidate
+  ///     through the same header checks the codecs use for file type detection.
+  ///   </para>
+  ///   <para>
+  ///     For confirmed candidates, the length is determined from the file's own framing:
+  ///     the RIFF chunk size, the chain of Ogg pages up to the end-of-stream page or
+  ///     the chain of WavPack blocks. Scanning resumes behind each audio file found, so
+  ///     signatures that happen to appear within audio data are not reported.
+  ///   </para>
+  ///   <para>
+  ///     Formats whose codec was not compiled into the library are not reported.
+  ///     The results can be passed directly to <see cref="VirtualFile.CreateSubRangeView" />
+  ///     and the resulting views opened through the <see cref="AudioLoader" />.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE EmbeddedStreamScanner {
+
+    /// <summary>Finds all audio files stored inside a blob</summary>
+    /// <param name="blob">Archive or other file that will be searched for audio files</param>
+    /// <param name="cancellationToken">Optional token through which to stop the scan</param>
+    /// <returns>The audio files found, ordered by their offset within the blob</returns>
+    public: NUCLEX_AUDIO_API static std::vector<EmbeddedStream> Scan(
+      const VirtualFile &blob,
+      const std::shared_ptr<const CancellationToken> &cancellationToken = {}
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_EMBEDDEDSTREAMSCANNER_H
@@ -0,0 +1,87 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ENCODERCPUBUDGET_H
+#define NUCLEX_AUDIO_STORAGE_ENCODERCPUBUDGET_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits how much processor time a realtime encoder may use</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for encoding audio while it is being captured, for example gameplay audio
+  ///     that is recorded while the game is rendering. The encoder measures how long each
+  ///     block takes to encode and lowers its complexity when it uses more than its budget,
+  ///     raising it again once there is enough headroom.
+  ///   </para>
+  ///   <para>
+  ///     Complexity is always the first thing to give. Lowering the bitrate or moving to
+  ///     longer frames saves a little more time but is audible or adds latency, so each
+  ///     has to be allowed explicitly and is only used once complexity is at its minimum.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE EncoderCpuBudget {
+
+    /// <summary>Fraction of one CPU core that may be spent per second of audio</summary>
+    /// <remarks>
+    ///   A value of 0.05 lets the encoder spend 50 milliseconds on each second of audio.
+    /// </remarks>
+    public: float CpuFraction;
+    /// <summary>Whether the encoder may go below the target bitrate to save time</summary>
+    /// <remarks>
+    ///   Only has an effect if a target bitrate was set on the encoder builder.
+    /// </remarks>
+    public: bool MayLowerBitrate;
+    /// <summary>Whether the encoder may switch to longer frames to save time</summary>
+    public: bool MayEnlargeFrames;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Current settings and measured cost of an encoder with a CPU budget</summary>
+  struct NUCLEX_AUDIO_TYPE EncoderCpuMetrics {
+
+    /// <summary>Complexity the encoder currently uses, from 0.0 to 1.0</summary>
+    public: float Effort;
+    /// <summary>Bitrate the encoder currently targets, 0 if left to the codec</summary>
+    public: float KilobitsPerSecond;
+    /// <summary>Length of the frames the encoder currently produces</summary>
+    public: float FrameMilliseconds;
+    /// <summary>Smoothed fraction of a CPU core spent per second of audio</summary>
+    public: float MeasuredCpuFraction;
+    /// <summary>Highest fraction measured over a single measurement window</summary>
+    public: float PeakCpuFraction;
+    /// <summary>Number of times the governor has changed the encoder's settings</summary>
+    public: std::uint64_t AdjustmentCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ENCODERCPUBUDGET_H
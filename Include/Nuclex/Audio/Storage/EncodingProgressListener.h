@@ -0,0 +1,59 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_ENCODINGPROGRESSLISTENER_H
+#define NUCLEX_AUDIO_STORAGE_ENCODINGPROGRESSLISTENER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives progress notifications from an audio track encoder</summary>
+  /// <remarks>
+  ///   The listener is called on the thread feeding the encoder, after each block of
+  ///   samples has been encoded. It must not call back into the encoder. Exceptions
+  ///   thrown by the listener are passed on to the caller of the encode method.
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE EncodingProgressListener {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~EncodingProgressListener() = default;
+
+    /// <summary>Called when the encoder has finished another block of samples</summary>
+    /// <param name="consumedFrameCount">Number of frames the encoder was fed so far</param>
+    /// <param name="writtenByteCount">Number of bytes written to the output so far</param>
+    /// <remarks>
+    ///   Encoders may hold samples back until they have enough for a whole block, so
+    ///   the number of bytes written can lag behind the number of frames consumed.
+    /// </remarks>
+    public: virtual void ReportProgress(
+      std::uint64_t consumedFrameCount, std::uint64_t writtenByteCount
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_ENCODINGPROGRESSLISTENER_H
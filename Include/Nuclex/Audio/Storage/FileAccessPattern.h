@@ -0,0 +1,80 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FILEACCESSPATTERN_H
+#define NUCLEX_AUDIO_STORAGE_FILEACCESSPATTERN_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How a file is expected to be accessed</summary>
+  /// <remarks>
+  ///   This is passed on to the operating system as a hint so it can adjust its caching
+  ///   behavior. It never changes which operations are allowed on a file.
+  ///   The only exception is <see cref="Unbuffered" />, which selects a different way
+  ///   of accessing the file altogether.
+  /// </remarks>
+  enum class FileAccessPattern {
+
+    /// <summary>No particular access pattern, use the operating system's defaults</summary>
+    Normal = 0,
+
+    /// <summary>The file will be read or written from start to end</summary>
+    /// <remarks>
+    ///   The operating system will read ahead more aggressively and may drop pages
+    ///   that have already been read sooner. Ideal for transcoding whole files.
+    /// </remarks>
+    Sequential = 1,
+
+    /// <summary>The file will be accessed at unpredictable offsets</summary>
+    /// <remarks>
+    ///   The operating system will read ahead less (or not at all), avoiding wasted I/O
+    ///   in decoders that seek around a lot, for example to scrub through a track.
+    /// </remarks>
+    Random = 2,
+
+    /// <summary>The file will be streamed through once, bypassing the OS file cache</summary>
+    /// <remarks>
+    ///   <para>
+    ///     Bulk transcoding reads and writes gigabytes that will never be looked at again.
+    ///     Going through the file cache evicts everything else the machine had cached
+    ///     (including the files of the application doing the transcoding) for no gain.
+    ///     This opens the file with O_DIRECT on Linux and FILE_FLAG_NO_BUFFERING on
+    ///     Windows and moves data in large aligned blocks, reading the next block in
+    ///     the background while the current one is being consumed.
+    ///   </para>
+    ///   <para>
+    ///     Small reads at scattered offsets become much more expensive in this mode,
+    ///     so only use it for files that are processed from start to end. On file systems
+    ///     and platforms that don't support direct I/O, this acts like
+    ///     <see cref="Sequential" />. Memory mapping is never used in this mode.
+    ///   </para>
+    /// </remarks>
+    Unbuffered = 3
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_FILEACCESSPATTERN_H
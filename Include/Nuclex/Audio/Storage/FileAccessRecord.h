@@ -0,0 +1,80 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FILEACCESSRECORD_H
+#define NUCLEX_AUDIO_STORAGE_FILEACCESSRECORD_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Kinds of accesses an instrumented file records</summary>
+  enum class FileAccessKind {
+
+    /// <summary>Single read via ReadAt()</summary>
+    Read = 0,
+
+    /// <summary>Read that was part of a batch submitted via ReadManyAt()</summary>
+    BatchRead = 1,
+
+    /// <summary>Range that was successfully borrowed via TryBorrowAt()</summary>
+    Borrow = 2,
+
+    /// <summary>Range announced to be read soon via Prefetch()</summary>
+    Prefetch = 3,
+
+    /// <summary>Write via WriteAt()</summary>
+    Write = 4
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a single access to an instrumented file</summary>
+  struct NUCLEX_AUDIO_TYPE FileAccessRecord {
+
+    /// <summary>What kind of access this was</summary>
+    public: FileAccessKind Kind;
+    /// <summary>Offset in the file at which the access began</summary>
+    public: std::uint64_t Start;
+    /// <summary>Number of bytes that were accessed</summary>
+    public: std::size_t ByteCount;
+    /// <summary>Time since the file was wrapped at which the access began</summary>
+    public: std::chrono::nanoseconds Time;
+    /// <summary>Time the wrapped file took to carry out the access</summary>
+    /// <remarks>
+    ///   Reads from a batch all report the time the whole batch took.
+    /// </remarks>
+    public: std::chrono::nanoseconds Latency;
+    /// <summary>Index of the calling thread, in the order threads first accessed the file</summary>
+    public: std::size_t ThreadIndex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_FILEACCESSRECORD_H
@@ -0,0 +1,87 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FILEACCESSSUMMARY_H
+#define NUCLEX_AUDIO_STORAGE_FILEACCESSSUMMARY_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Totals of all accesses an instrumented file has seen</summary>
+  /// <remarks>
+  ///   Reads include those submitted in batches, so <see cref="ReadCount" /> can be
+  ///   larger than the number of ReadAt() calls. The read time counts each batch once.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE FileAccessSummary {
+
+    /// <summary>Number of reads that were carried out</summary>
+    public: std::uint64_t ReadCount;
+    /// <summary>Number of reads that began where the previous read ended</summary>
+    /// <remarks>
+    ///   A first read at the beginning of the file counts as sequential, too.
+    /// </remarks>
+    public: std::uint64_t SequentialReadCount;
+    /// <summary>Number of batches submitted via ReadManyAt()</summary>
+    public: std::uint64_t BatchCount;
+    /// <summary>Total number of bytes that were read</summary>
+    public: std::uint64_t ReadByteCount;
+    /// <summary>Size of the smallest read, zero if there were no reads</summary>
+    public: std::size_t SmallestReadByteCount;
+    /// <summary>Size of the largest read</summary>
+    public: std::size_t LargestReadByteCount;
+    /// <summary>Time spent in reads, including batches</summary>
+    public: std::chrono::nanoseconds ReadTime;
+    /// <summary>Time taken by the slowest read or batch</summary>
+    public: std::chrono::nanoseconds LongestReadTime;
+
+    /// <summary>Number of ranges that were successfully borrowed</summary>
+    public: std::uint64_t BorrowCount;
+    /// <summary>Total number of bytes in all borrowed ranges</summary>
+    public: std::uint64_t BorrowedByteCount;
+    /// <summary>Number of prefetch hints that were given</summary>
+    public: std::uint64_t PrefetchCount;
+    /// <summary>Total number of bytes covered by prefetch hints</summary>
+    public: std::uint64_t PrefetchedByteCount;
+
+    /// <summary>Number of writes that were carried out</summary>
+    public: std::uint64_t WriteCount;
+    /// <summary>Total number of bytes that were written</summary>
+    public: std::uint64_t WrittenByteCount;
+    /// <summary>Time spent in writes</summary>
+    public: std::chrono::nanoseconds WriteTime;
+    /// <summary>Time taken by the slowest write</summary>
+    public: std::chrono::nanoseconds LongestWriteTime;
+
+    /// <summary>Number of different threads that accessed the file</summary>
+    public: std::size_t ThreadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_FILEACCESSSUMMARY_H
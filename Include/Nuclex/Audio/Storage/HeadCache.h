@@ -0,0 +1,162 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_HEADCACHE_H
+#define NUCLEX_AUDIO_STORAGE_HEADCACHE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decoded beginning of an audio file kept in memory</summary>
+  struct NUCLEX_AUDIO_TYPE CachedHead {
+
+    /// <summary>Number of interleaved channels in the samples</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Total number of frames in the whole audio file</summary>
+    public: std::uint64_t TotalFrameCount;
+    /// <summary>Number of frames at the beginning of the file that have been decoded</summary>
+    public: std::size_t FrameCount;
+    /// <summary>Interleaved samples of the decoded frames</summary>
+    public: std::vector<float> Samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps the first few hundred milliseconds of streamed assets decoded</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Before a streamed voice can play its first sample, its file has to be opened,
+  ///     its headers parsed and its first block decoded, which for music and dialogue
+  ///     on slow storage is noticeable. The head cache decodes the beginning of each
+  ///     registered asset at load time, in parallel on the installed
+  ///     <see cref="Executor" />, and keeps it in memory.
+  ///   </para>
+  ///   <para>
+  ///     A <see cref="StreamingManager" /> that has been given a head cache starts voices
+  ///     of cached assets right away from the cached samples, while one of its threads
+  ///     opens the file and decodes from the end of the head onwards. The voice switches
+  ///     over to the decoded samples at the cached boundary without a gap.
+  ///   </para>
+  ///   <para>
+  ///     Heads are immutable once cached and can be shared by any number of voices.
+  ///     All methods are thread-safe.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE HeadCache {
+
+    /// <summary>Initializes a new head cache</summary>
+    /// <param name="headMilliseconds">Length of audio that will be cached per asset</param>
+    /// <remarks>
+    ///   The head should cover at least the time it takes to open an asset and decode
+    ///   its first block, the default leaves room for slow storage.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API HeadCache(std::size_t headMilliseconds = 250);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~HeadCache();
+
+    /// <summary>Returns the length of audio that is cached per asset</summary>
+    /// <returns>The length of the cached heads in milliseconds</returns>
+    public: std::size_t GetHeadMilliseconds() const { return this->headMilliseconds; }
+
+    /// <summary>Decodes and caches the heads of many assets in parallel</summary>
+    /// <param name="loader">Audio loader that will be used to open the assets</param>
+    /// <param name="paths">Paths of the assets whose heads will be cached</param>
+    /// <returns>The number of assets whose heads have been cached</returns>
+    /// <remarks>
+    ///   Assets that can't be opened or decoded are skipped, voices playing them will
+    ///   open them normally and report the error then. Assets that are already cached
+    ///   are decoded again, so this can also be used to refresh modified assets.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Preload(
+      const AudioLoader &loader, const std::vector<std::string> &paths
+    );
+
+    /// <summary>Decodes and caches the head of an asset from an existing decoder</summary>
+    /// <param name="path">Path under which the head will be looked up</param>
+    /// <param name="decoder">Decoder from which the head will be decoded</param>
+    /// <param name="sampleRate">Sample rate of the audio the decoder delivers</param>
+    public: NUCLEX_AUDIO_API void Add(
+      const std::string &path, const AudioTrackDecoder &decoder, std::size_t sampleRate
+    );
+
+    /// <summary>Looks up the cached head of an asset</summary>
+    /// <param name="path">Path of the asset whose head will be looked up</param>
+    /// <returns>The cached head or an empty pointer if the asset isn't cached</returns>
+    public: NUCLEX_AUDIO_API std::shared_ptr<const CachedHead> TryGetHead(
+      const std::string &path
+    ) const;
+
+    /// <summary>Drops the cached head of an asset</summary>
+    /// <param name="path">Path of the asset whose head will be dropped</param>
+    /// <remarks>
+    ///   Voices already playing from the head keep it alive until they're done.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Remove(const std::string &path);
+
+    /// <summary>Drops the cached heads of all assets</summary>
+    public: NUCLEX_AUDIO_API void Clear();
+
+    /// <summary>Counts the assets whose heads are cached</summary>
+    /// <returns>The number of cached heads</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountHeads() const;
+
+    /// <summary>Calculates the memory used by the cached samples</summary>
+    /// <returns>The number of bytes taken up by the samples of all cached heads</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetMemoryUsage() const;
+
+    /// <summary>Decodes the head of an asset</summary>
+    /// <param name="decoder">Decoder from which the head will be decoded</param>
+    /// <param name="sampleRate">Sample rate of the audio the decoder delivers</param>
+    /// <returns>The decoded head</returns>
+    private: std::shared_ptr<const CachedHead> decodeHead(
+      const AudioTrackDecoder &decoder, std::size_t sampleRate
+    ) const;
+
+    /// <summary>Length of audio that is cached per asset</summary>
+    private: std::size_t headMilliseconds;
+    /// <summary>Heads that have been cached, by the paths of their assets</summary>
+    private: std::unordered_map<std::string, std::shared_ptr<const CachedHead>> heads;
+    /// <summary>Must be held while accessing the cached heads</summary>
+    private: mutable std::mutex headsMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_HEADCACHE_H
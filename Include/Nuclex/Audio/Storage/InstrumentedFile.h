@@ -0,0 +1,199 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_INSTRUMENTEDFILE_H
+#define NUCLEX_AUDIO_STORAGE_INSTRUMENTEDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/FileAccessRecord.h"
+#include "Nuclex/Audio/Storage/FileAccessSummary.h"
+
+#include <chrono> // for std::chrono::steady_clock
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <thread> // for std::thread::id
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps another file and keeps track of how it is being accessed</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Put this between a codec and its file to see how the codec library really reads:
+  ///     how large its reads are, how often it jumps around and how long the wrapped file
+  ///     took to respond. The totals are always collected. Optionally, each access can be
+  ///     recorded as well, to dump a trace or to replay the accesses in a benchmark.
+  ///   </para>
+  ///   <para>
+  ///     Bookkeeping is protected by a mutex, so the same instance can be shared by
+  ///     several decoders, but it adds a little overhead to each access. Recorded accesses
+  ///     are kept in memory until <see cref="Reset" /> is called.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE InstrumentedFile : public VirtualFile {
+
+    /// <summary>Initializes a new instrumented file that can only be read</summary>
+    /// <param name="file">File whose accesses will be tracked</param>
+    /// <param name="recordAccesses">Whether to record each individual access</param>
+    public: NUCLEX_AUDIO_API InstrumentedFile(
+      const std::shared_ptr<const VirtualFile> &file, bool recordAccesses = false
+    );
+
+    /// <summary>Initializes a new instrumented file that can be read and written</summary>
+    /// <param name="file">File whose accesses will be tracked</param>
+    /// <param name="recordAccesses">Whether to record each individual access</param>
+    /// <remarks>
+    ///   Pointers to derived file classes match both constructors. Convert them to
+    ///   a std::shared_ptr&lt;VirtualFile&gt; first to pick this one.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API InstrumentedFile(
+      const std::shared_ptr<VirtualFile> &file, bool recordAccesses = false
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: NUCLEX_AUDIO_API ~InstrumentedFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t GetSize() const override;
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: NUCLEX_AUDIO_API void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    public: NUCLEX_AUDIO_API void ReadManyAt(
+      const ReadRequest *requests, std::size_t requestCount
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: NUCLEX_AUDIO_API void Prefetch(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the file contents at the requested offset or a null pointer if
+    ///   the wrapped file cannot provide the requested range as contiguous memory
+    /// </returns>
+    /// <remarks>
+    ///   Only successful borrows are tracked. Failed ones are followed by a read.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Throws if the instrumented file was created for a read-only file.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Writes any data that is being held in buffers to the file</summary>
+    public: NUCLEX_AUDIO_API void Flush() override;
+
+    /// <summary>Retrieves the totals of all accesses since the file was wrapped or reset</summary>
+    /// <returns>The totals of all accesses to the file</returns>
+    public: NUCLEX_AUDIO_API FileAccessSummary GetSummary() const;
+
+    /// <summary>Retrieves the individually recorded accesses</summary>
+    /// <returns>A copy of all accesses recorded so far, in the order they began</returns>
+    /// <remarks>
+    ///   Empty unless the file was created with recording enabled.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::vector<FileAccessRecord> GetRecords() const;
+
+    /// <summary>Formats the recorded accesses as comma-separated values</summary>
+    /// <returns>A text with a header line and one line per recorded access</returns>
+    /// <remarks>
+    ///   The columns are the kind of access, start offset, byte count, time and latency
+    ///   in nanoseconds and the thread index, suitable for loading into a spreadsheet.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::string DumpTrace() const;
+
+    /// <summary>Clears the totals and all recorded accesses</summary>
+    /// <remarks>
+    ///   Times in records made afterwards count from the moment of the reset.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void Reset();
+
+    /// <summary>Adds an access to the totals and, if enabled, records it</summary>
+    /// <param name="kind">What kind of access is to be added</param>
+    /// <param name="start">Offset in the file at which the access began</param>
+    /// <param name="byteCount">Number of bytes that were accessed</param>
+    /// <param name="beginTime">Time at which the access began</param>
+    /// <param name="latency">Time the wrapped file took to carry out the access</param>
+    /// <remarks>
+    ///   The mutex has to be held by the caller.
+    /// </remarks>
+    private: void addAccess(
+      FileAccessKind kind, std::uint64_t start, std::size_t byteCount,
+      std::chrono::steady_clock::time_point beginTime,
+      std::chrono::steady_clock::duration latency
+    ) const;
+
+    /// <summary>Looks up the index of the calling thread, assigning it if new</summary>
+    /// <returns>The index of the calling thread</returns>
+    private: std::size_t getThreadIndex() const;
+
+    /// <summary>File whose accesses are being tracked</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>The same file if it can be written, otherwise null</summary>
+    private: std::shared_ptr<VirtualFile> writableFile;
+    /// <summary>Whether individual accesses are recorded</summary>
+    private: bool recordAccesses;
+    /// <summary>Protects the totals and records from concurrent updates</summary>
+    private: mutable std::mutex accessMutex;
+    /// <summary>Time from which the recorded times are counted</summary>
+    private: std::chrono::steady_clock::time_point startTime;
+    /// <summary>Totals of all accesses so far</summary>
+    private: mutable FileAccessSummary summary;
+    /// <summary>Offset in the file at which the most recent read ended</summary>
+    private: mutable std::uint64_t lastReadEnd;
+    /// <summary>Individually recorded accesses, if enabled</summary>
+    private: mutable std::vector<FileAccessRecord> records;
+    /// <summary>Threads that have accessed the file, in order of their first access</summary>
+    private: mutable std::vector<std::thread::id> threads;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_INSTRUMENTEDFILE_H
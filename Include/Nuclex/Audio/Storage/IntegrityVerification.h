@@ -0,0 +1,74 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_INTEGRITYVERIFICATION_H
+#define NUCLEX_AUDIO_STORAGE_INTEGRITYVERIFICATION_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether and how a decoder checks the checksums stored in its file</summary>
+  /// <remarks>
+  ///   FLAC files carry an MD5 hash of the whole decoded audio stream and Ogg files carry
+  ///   a CRC for every page. Checking them means reading the entire file once, which is
+  ///   useful for asset validation but wasted effort during playback of trusted files.
+  /// </remarks>
+  enum class VerificationPolicy {
+
+    /// <summary>Do not run any verification pass beyond what the codec library does</summary>
+    Off = 0,
+
+    /// <summary>Verify the file right away, before the policy change returns</summary>
+    Immediate = 1,
+
+    /// <summary>Verify the file on a background thread while the decoder is used</summary>
+    Background = 2
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Outcome of the checksum verification of an audio file</summary>
+  enum class VerificationResult {
+
+    /// <summary>No verification was requested or it was cancelled</summary>
+    NotChecked = 0,
+
+    /// <summary>Verification is still running on a background thread</summary>
+    Pending = 1,
+
+    /// <summary>All checksums in the file matched the data</summary>
+    Passed = 2,
+
+    /// <summary>At least one checksum did not match or the file could not be read</summary>
+    Failed = 3,
+
+    /// <summary>The file stores no checksum that could be verified</summary>
+    NoChecksum = 4
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_INTEGRITYVERIFICATION_H
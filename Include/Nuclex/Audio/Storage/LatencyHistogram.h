@@ -0,0 +1,90 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_LATENCYHISTOGRAM_H
+#define NUCLEX_AUDIO_STORAGE_LATENCYHISTOGRAM_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Distribution of the wall time taken by decoding calls</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Buckets are laid out like in an HDR histogram: each power of two from 1 µs to
+  ///     roughly 34 seconds is split into 8 linear sub-buckets, so every bucket is at most
+  ///     12.5% wider than the times it holds. Everything below 1 µs lands in the first
+  ///     bucket and everything beyond the last power of two in the final one.
+  ///   </para>
+  ///   <para>
+  ///     Histograms are snapshots. The counters behind them are recorded without locks,
+  ///     so a snapshot taken while another thread is decoding may be one call behind.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE LatencyHistogram {
+
+    /// <summary>Number of buckets in a histogram that has recorded anything</summary>
+    public: static constexpr std::size_t BucketCount = 209;
+
+    /// <summary>Looks up the bucket a decoding time would be counted in</summary>
+    /// <param name="latency">Wall time of a decoding call</param>
+    /// <returns>The index of the bucket counting the specified time</returns>
+    public: NUCLEX_AUDIO_API static std::size_t GetBucketIndex(std::chrono::nanoseconds latency);
+
+    /// <summary>Determines the longest time counted by a bucket</summary>
+    /// <param name="bucketIndex">Index of the bucket whose upper bound will be returned</param>
+    /// <returns>The exclusive upper bound of times counted in the bucket</returns>
+    public: NUCLEX_AUDIO_API static std::chrono::nanoseconds GetBucketUpperBound(
+      std::size_t bucketIndex
+    );
+
+    /// <summary>Estimates the time below which a fraction of the decoding calls finished</summary>
+    /// <param name="percentile">Fraction of calls, 0.99 for the 99th percentile</param>
+    /// <returns>
+    ///   The upper bound of the bucket holding the percentile, but never more than the
+    ///   longest time recorded. Zero if no calls have been recorded.
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::chrono::nanoseconds GetPercentile(double percentile) const;
+
+    /// <summary>Number of calls counted in each bucket</summary>
+    /// <remarks>
+    ///   Either empty or <see cref="BucketCount" /> entries long.
+    /// </remarks>
+    public: std::vector<std::uint64_t> BucketCounts;
+    /// <summary>Number of decoding calls recorded in the histogram</summary>
+    public: std::uint64_t CallCount;
+    /// <summary>Combined wall time of all recorded calls</summary>
+    public: std::chrono::nanoseconds TotalTime;
+    /// <summary>Wall time of the slowest recorded call</summary>
+    public: std::chrono::nanoseconds LongestTime;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_LATENCYHISTOGRAM_H
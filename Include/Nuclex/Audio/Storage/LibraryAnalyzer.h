@@ -0,0 +1,168 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_LIBRARYANALYZER_H
+#define NUCLEX_AUDIO_STORAGE_LIBRARYANALYZER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AnalysisStage.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Results of analyzing one file</summary>
+  struct NUCLEX_AUDIO_TYPE FileAnalysis {
+
+    /// <summary>Path of the file that was analyzed</summary>
+    public: std::string Path;
+
+    /// <summary>Exception that stopped the file from being analyzed, empty on success</summary>
+    public: std::exception_ptr Error;
+
+    /// <summary>Number of audio frames that were analyzed</summary>
+    public: std::uint64_t FrameCount;
+
+    /// <summary>Number of ranges the file was split into</summary>
+    public: std::size_t RangeCount;
+
+    /// <summary>Merged results of each stage, in the order the stages were added</summary>
+    /// <remarks>
+    ///   Each entry is an instance of the same class as the stage it was started from,
+    ///   so it can be cast back to read its results. Empty if the file failed.
+    /// </remarks>
+    public: std::vector<std::unique_ptr<AnalysisStage>> Stages;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Results and throughput figures of a library analysis pass</summary>
+  struct NUCLEX_AUDIO_TYPE LibraryAnalysis {
+
+    /// <summary>Results for each file, in the order the files were added</summary>
+    public: std::vector<FileAnalysis> Files;
+
+    /// <summary>Number of files that could not be analyzed</summary>
+    public: std::size_t FailedFileCount;
+
+    /// <summary>Number of ranges all files were split into</summary>
+    public: std::size_t RangeCount;
+
+    /// <summary>Total number of audio frames that were analyzed</summary>
+    public: std::uint64_t AnalyzedFrameCount;
+
+    /// <summary>Total playback duration, in seconds, of all analyzed audio</summary>
+    public: double AnalyzedSeconds;
+
+    /// <summary>Wall clock time, in seconds, the whole pass took</summary>
+    public: double ElapsedSeconds;
+
+    /// <summary>Calculates how many seconds of audio were analyzed per second</summary>
+    /// <returns>The number of times faster than real time the pass ran</returns>
+    public: double GetRealtimeFactor() const {
+      return (this->ElapsedSeconds > 0.0) ? (this->AnalyzedSeconds / this->ElapsedSeconds) : 0.0;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs analysis stages over many audio files, using all CPU cores</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for offline passes over a whole asset library, such as measuring the
+  ///     loudness of every file or finding clipped assets. The files are probed first,
+  ///     then each file is split into ranges of roughly equal length. Each range is
+  ///     decoded by its own decoder, which seeks to the range's start, and fed to its
+  ///     own instances of the stages. Splitting keeps a single huge file from becoming
+  ///     the straggler that all other cores wait for at the end of the pass.
+  ///   </para>
+  ///   <para>
+  ///     Ranges are run on the installed <see cref="Executor" />, with idle workers
+  ///     claiming the next range whenever they finish one. Once all ranges of a file
+  ///     are done, the stage instances are merged in order and finished.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LibraryAnalyzer {
+
+    /// <summary>Initializes a new library analyzer</summary>
+    /// <param name="threadCount">
+    ///   Number of ranges that will be analyzed at once, zero for one per CPU core
+    /// </param>
+    /// <param name="rangeFrameCount">
+    ///   Number of frames after which files will be split into another range
+    /// </param>
+    public: NUCLEX_AUDIO_API LibraryAnalyzer(
+      std::size_t threadCount = 0,
+      std::uint64_t rangeFrameCount = 4194304
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~LibraryAnalyzer();
+
+    /// <summary>Counts the files that have been added to the pass</summary>
+    /// <returns>The number of files that will be analyzed</returns>
+    public: std::size_t CountFiles() const { return this->paths.size(); }
+
+    /// <summary>Adds a file that should be analyzed</summary>
+    /// <param name="path">Path of the audio file</param>
+    public: NUCLEX_AUDIO_API void AddFile(const std::string &path);
+
+    /// <summary>Adds a stage that will be run on all files</summary>
+    /// <param name="stage">Prototype of the stage, it is only used to start instances</param>
+    public: NUCLEX_AUDIO_API void AddStage(const std::shared_ptr<const AnalysisStage> &stage);
+
+    /// <summary>Analyzes all files and waits until they're done</summary>
+    /// <returns>The results of each file and the throughput of the pass</returns>
+    /// <remarks>
+    ///   Failing files don't stop the pass, their errors are reported in the returned
+    ///   results. The list of files is cleared afterwards, the stages are kept.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API LibraryAnalysis Run();
+
+    /// <summary>Number of ranges that will be analyzed at once</summary>
+    private: std::size_t threadCount;
+    /// <summary>Number of frames after which files will be split into another range</summary>
+    private: std::uint64_t rangeFrameCount;
+    /// <summary>Loader used to open the decoders for the files</summary>
+    private: std::shared_ptr<AudioLoader> loader;
+    /// <summary>Paths of the files that will be analyzed by the next run</summary>
+    private: std::vector<std::string> paths;
+    /// <summary>Prototypes of the stages that will be run on each file</summary>
+    private: std::vector<std::shared_ptr<const AnalysisStage>> stages;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_LIBRARYANALYZER_H
@@ -0,0 +1,100 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_LOSSLESSREMUXER_H
+#define NUCLEX_AUDIO_STORAGE_LOSSLESSREMUXER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cuts and joins FLAC and WavPack files without re-encoding them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Both formats store their audio in frames (FLAC) or blocks (WavPack) that can be
+  ///     decoded independently of each other. Cutting a clip out of a long recording
+  ///     therefore only requires copying the frames inside the clip and rewriting their
+  ///     headers so they number their samples from the start of the new file. The stream
+  ///     headers receive the new total length.
+  ///   </para>
+  ///   <para>
+  ///     Only the partial frames at the start and end of a cut are decoded and encoded
+  ///     again. Both formats are lossless, so the clip contains exactly the same samples
+  ///     as the range in the source file did.
+  ///   </para>
+  ///   <para>
+  ///     Cut FLAC files use the variable block size strategy because the re-encoded edge
+  ///     frames have different lengths than the copied ones. Their MD5 signature is
+  ///     cleared (which the FLAC specification permits) and seek tables and cue sheets
+  ///     are dropped. For WavPack files, the wrapped .wav headers and the MD5 sum are
+  ///     dropped, and correction files (.wvc) are not cut along with the main file.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LosslessRemuxer {
+
+    /// <summary>Copies a range of frames from a FLAC or WavPack file into a new file</summary>
+    /// <param name="source">FLAC or WavPack file the clip will be taken from</param>
+    /// <param name="startFrame">Index of the first frame the clip will contain</param>
+    /// <param name="frameCount">
+    ///   Number of frames the clip will contain. If the source ends earlier, the clip
+    ///   will end with the source.
+    /// </param>
+    /// <param name="target">File the clip will be written into, in the source's format</param>
+    /// <returns>The number of frames in the clip that was written</returns>
+    /// <remarks>
+    ///   Throws an <see cref="Errors::UnsupportedFormatError" /> for other formats and
+    ///   an std::out_of_range exception if the start frame lies beyond the end of
+    ///   the source file.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::uint64_t Trim(
+      const std::shared_ptr<const VirtualFile> &source,
+      std::uint64_t startFrame, std::uint64_t frameCount,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+    /// <summary>Joins several FLAC files or several WavPack files into a single file</summary>
+    /// <param name="sources">Files that will be joined in the order given</param>
+    /// <param name="target">File the joined audio stream will be written into</param>
+    /// <remarks>
+    ///   All sources need to use the same format, channel layout, sample width and sample
+    ///   rate, otherwise an <see cref="Errors::UnsupportedFormatError" /> is thrown.
+    ///   Metadata such as tags is taken from the first source.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Concatenate(
+      const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_LOSSLESSREMUXER_H
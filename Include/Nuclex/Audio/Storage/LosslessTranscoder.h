@@ -0,0 +1,92 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_LOSSLESSTRANSCODER_H
+#define NUCLEX_AUDIO_STORAGE_LOSSLESSTRANSCODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+  class AudioTrackEncoderBuilder;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves samples between lossless formats without changing a single bit</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Going through floating point to get from, say, a .wav file to a .flac file
+  ///     reconstructs every sample as a float and quantizes it again, which costs two
+  ///     conversion passes and is only exact as long as the float's mantissa can hold
+  ///     the sample. This helper picks a sample format both sides can represent exactly,
+  ///     decodes integer audio as 32-bit integers (and floating point audio as floats)
+  ///     and hands the blocks straight to the encoder.
+  ///   </para>
+  ///   <para>
+  ///     Integer samples are passed left-aligned in 32-bit integers, so widening, say,
+  ///     16-bit samples to 24-bit is exact as well. Narrowing never is, so the target
+  ///     needs to support a format with at least as many bits as the source.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE LosslessTranscoder {
+
+    /// <summary>Picks the stored sample format that keeps the source's samples intact</summary>
+    /// <param name="decoder">Decoder that will deliver the source samples</param>
+    /// <param name="builder">Builder for the encoder that will store the samples</param>
+    /// <returns>
+    ///   The smallest format supported by the encoder that holds the decoder's native
+    ///   samples exactly, or <see cref="AudioSampleFormat::Unknown" /> if there is none
+    /// </returns>
+    public: NUCLEX_AUDIO_API static AudioSampleFormat NegotiateSampleFormat(
+      const AudioTrackDecoder &decoder, const AudioTrackEncoderBuilder &builder
+    );
+
+    /// <summary>Transcodes an audio track, keeping every sample bit-exact</summary>
+    /// <param name="decoder">Decoder that will deliver the source samples</param>
+    /// <param name="builder">
+    ///   Builder for the encoder that will store the samples. Its sample rate needs to be
+    ///   set up front, the sample format and channels will be set by this method.
+    /// </param>
+    /// <param name="target">File the encoded audio track will be written into</param>
+    /// <returns>The number of frames that have been transcoded</returns>
+    /// <remarks>
+    ///   Throws an <see cref="Errors::UnsupportedFormatError" /> if the target can't store
+    ///   the samples without loss.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::uint64_t Transcode(
+      const AudioTrackDecoder &decoder,
+      AudioTrackEncoderBuilder &builder,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_LOSSLESSTRANSCODER_H
@@ -0,0 +1,109 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OGGREMUXER_H
+#define NUCLEX_AUDIO_STORAGE_OGGREMUXER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cuts and joins Ogg Opus and Ogg Vorbis streams without re-encoding them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Cutting a clip out of a long recording by decoding and encoding it again takes
+  ///     as long as encoding the clip and loses quality a second time. This helper copies
+  ///     the compressed packets instead and only rewrites the granule positions and the
+  ///     headers, so the work is limited to reading and writing the packets.
+  ///   </para>
+  ///   <para>
+  ///     Cuts are sample-accurate: Opus streams receive enough extra packets in front of
+  ///     the cut for the decoder to settle and a pre-skip that discards them again, Vorbis
+  ///     streams keep the one packet the decoder needs to overlap with and drop the extra
+  ///     samples via the granule position of the first page. The end of the clip is cut
+  ///     via the granule position of the last page for both codecs.
+  ///   </para>
+  ///   <para>
+  ///     Joins produce a chained Ogg stream in which each source is a link of its own.
+  ///     Packets from different encoder runs can't be spliced into one logical stream
+  ///     without an audible glitch at the seam, but Ogg players play chained links
+  ///     back-to-back without a gap. When opened through this library, each link becomes
+  ///     a track of its own.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE OggRemuxer {
+
+    /// <summary>Copies a range of frames from an Ogg stream into a new Ogg stream</summary>
+    /// <param name="source">Ogg Opus or Ogg Vorbis file the clip will be taken from</param>
+    /// <param name="startFrame">Index of the first frame the clip will contain</param>
+    /// <param name="frameCount">
+    ///   Number of frames the clip will contain. If the source ends earlier, the clip
+    ///   will end with the source.
+    /// </param>
+    /// <param name="target">File the clip will be written into</param>
+    /// <returns>The number of frames in the clip that was written</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Frames are counted in the codec's granule rate, which is always 48000 per
+    ///     second for Opus and the sample rate of the stream for Vorbis. Frame 0 is the
+    ///     first frame after the Opus pre-skip, matching what the decoders report.
+    ///   </para>
+    ///   <para>
+    ///     Only the first logical stream of the first link is copied. Throws
+    ///     an <see cref="Errors::UnsupportedFormatError" /> for other codecs and
+    ///     an std::out_of_range exception if the start frame lies beyond the end of
+    ///     the stream.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::uint64_t Trim(
+      const std::shared_ptr<const VirtualFile> &source,
+      std::uint64_t startFrame, std::uint64_t frameCount,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+    /// <summary>Joins several Ogg streams into a single chained Ogg stream</summary>
+    /// <param name="sources">Ogg files that will be joined in the order given</param>
+    /// <param name="target">File the chained Ogg stream will be written into</param>
+    /// <remarks>
+    ///   The pages are copied as they are, only the serial numbers of the logical streams
+    ///   are renumbered so that no two links share one. Sources can use different codecs,
+    ///   channel counts and sample rates and can themselves be chained already.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Concatenate(
+      const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_OGGREMUXER_H
@@ -0,0 +1,49 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OUTPUTFORMAT_H
+#define NUCLEX_AUDIO_STORAGE_OUTPUTFORMAT_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample format and channel layout in which samples can be requested</summary>
+  /// <remarks>
+  ///   Consumers that can take samples in several formats list the ones they accept
+  ///   and let <see cref="AudioTrackDecoder.NegotiateOutputFormat" /> pick the one
+  ///   the decoder can deliver with the least work.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE OutputFormat {
+
+    /// <summary>Format of the individual samples</summary>
+    public: AudioSampleFormat SampleFormat;
+    /// <summary>Whether the channels are interleaved or in separate buffers</summary>
+    public: bool Interleaved;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_OUTPUTFORMAT_H
@@ -0,0 +1,205 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_PAGEDTRACK_H
+#define NUCLEX_AUDIO_STORAGE_PAGEDTRACK_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <list> // for std::list
+#include <memory> // for std::shared_ptr
+#include <unordered_map> // for std::unordered_map
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio track that keeps only the parts of a long audio file decoded in use</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Decoding a multi-hour ambience or music track into memory would take hundreds of
+  ///     megabytes. A paged track keeps the decoder connected instead and decodes the track
+  ///     in pages of a fixed number of frames whenever they are needed. Pages begin on
+  ///     the codec's block boundaries (see <see cref="AudioTrackDecoder.GetBlockStart" />),
+  ///     so no page forces the codec to decode a block twice.
+  ///   </para>
+  ///   <para>
+  ///     Call <see cref="EnsureDecodedRangeAvailable" /> with the frames you are about to
+  ///     use, then access them via <see cref="GetSamples" /> or <see cref="CopyInterleaved" />.
+  ///     When the decoded pages take up more memory than the budget allows, the least
+  ///     recently used pages are evicted and their memory is reused for the next page.
+  ///     The pages of the most recently ensured range are never evicted, so a range larger
+  ///     than the budget is still made available, exceeding the budget until the next call.
+  ///   </para>
+  ///   <para>
+  ///     This class is not thread-safe. Each thread accessing a track should have its own
+  ///     paged track or you need to synchronize access yourself.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE PagedTrack {
+
+    /// <summary>Initializes a new paged track reading from the specified decoder</summary>
+    /// <param name="decoder">Decoder through which pages will be decoded</param>
+    /// <param name="memoryBudget">
+    ///   Number of bytes decoded pages may occupy before the least recently used
+    ///   pages are evicted
+    /// </param>
+    /// <param name="pageFrameCount">Nominal number of frames in each page</param>
+    public: NUCLEX_AUDIO_API PagedTrack(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t memoryBudget = 16777216,
+      std::size_t pageFrameCount = 32768
+    );
+
+    /// <summary>Frees all decoded pages</summary>
+    public: NUCLEX_AUDIO_API ~PagedTrack();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountChannels() const;
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio track consists of</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountFrames() const;
+
+    /// <summary>Returns the number of bytes decoded pages may occupy</summary>
+    /// <returns>The memory budget of the paged track in bytes</returns>
+    public: std::size_t GetMemoryBudget() const { return this->memoryBudget; }
+
+    /// <summary>Returns the number of bytes the decoded pages currently occupy</summary>
+    /// <returns>The memory currently used by decoded pages in bytes</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetMemoryUsage() const;
+
+    /// <summary>Counts the number of decoded pages currently kept in memory</summary>
+    /// <returns>The number of decoded pages</returns>
+    public: std::size_t CountResidentPages() const { return this->pagesByIndex.size(); }
+
+    /// <summary>Makes sure that the specified range of frames is decoded</summary>
+    /// <param name="begin">Index of the first frame that needs to be available</param>
+    /// <param name="end">Index one past the last frame that needs to be available</param>
+    /// <remarks>
+    ///   Pages that already are decoded are only marked as recently used. This is
+    ///   the only method that decodes or evicts pages.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void EnsureDecodedRangeAvailable(
+      std::uint64_t begin, std::uint64_t end
+    );
+
+    /// <summary>Checks whether the specified range of frames is decoded</summary>
+    /// <param name="begin">Index of the first frame that will be checked</param>
+    /// <param name="end">Index one past the last frame that will be checked</param>
+    /// <returns>True if all frames in the range are decoded</returns>
+    public: NUCLEX_AUDIO_API bool IsDecodedRangeAvailable(
+      std::uint64_t begin, std::uint64_t end
+    ) const;
+
+    /// <summary>Looks up the decoded samples beginning at the specified frame</summary>
+    /// <param name="frameIndex">Index of the frame whose samples will be looked up</param>
+    /// <param name="frameCount">
+    ///   Receives the number of frames that follow contiguously in memory
+    /// </param>
+    /// <returns>
+    ///   The interleaved samples beginning at the frame or a null pointer if the frame
+    ///   has not been decoded. The pointer stays valid until the next call to
+    ///   <see cref="EnsureDecodedRangeAvailable" />.
+    /// </returns>
+    public: NUCLEX_AUDIO_API const float *GetSamples(
+      std::uint64_t frameIndex, std::size_t &frameCount
+    ) const;
+
+    /// <summary>Copies decoded frames, interleaved, into the target buffer</summary>
+    /// <param name="target">Buffer that will receive the interleaved samples</param>
+    /// <param name="startFrame">Index of the first frame that will be copied</param>
+    /// <param name="frameCount">Number of frames that will be copied</param>
+    /// <remarks>
+    ///   The frames are made available via <see cref="EnsureDecodedRangeAvailable" />
+    ///   first, so this may decode pages and evict others.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void CopyInterleaved(
+      float *target, std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Decoded section of the audio track</summary>
+    private: struct Page {
+
+      /// <summary>Index of the page within the audio track</summary>
+      public: std::uint64_t Index;
+      /// <summary>Index of the first frame stored in the page</summary>
+      public: std::uint64_t StartFrame;
+      /// <summary>Number of frames stored in the page</summary>
+      public: std::size_t FrameCount;
+      /// <summary>Interleaved samples of all frames in the page</summary>
+      public: SampleVector<float> Samples;
+
+    };
+
+    /// <summary>List of pages ordered from most recently to least recently used</summary>
+    private: typedef std::list<Page> PageList;
+
+    /// <summary>Looks up the index of the page containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose page will be looked up</param>
+    /// <returns>The index of the page holding the frame</returns>
+    private: std::uint64_t getPageIndex(std::uint64_t frameIndex) const;
+
+    /// <summary>Determines the index of the first frame in a page</summary>
+    /// <param name="pageIndex">Index of the page whose start will be determined</param>
+    /// <returns>The index of the first frame in the page</returns>
+    private: std::uint64_t getPageStart(std::uint64_t pageIndex) const;
+
+    /// <summary>Evicts least recently used pages until another page fits the budget</summary>
+    /// <param name="requiredByteCount">Number of bytes the next page will occupy</param>
+    /// <param name="pinnedPageCount">
+    ///   Number of most recently used pages that may not be evicted
+    /// </param>
+    /// <param name="reusablePages">Receives the evicted pages for their memory</param>
+    private: void evictPages(
+      std::size_t requiredByteCount, std::size_t pinnedPageCount, PageList &reusablePages
+    );
+
+    /// <summary>Decoder through which pages are decoded</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Number of channels in the audio track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames in the audio track</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Number of bytes decoded pages may occupy</summary>
+    private: std::size_t memoryBudget;
+    /// <summary>Nominal number of frames in each page</summary>
+    private: std::size_t pageFrameCount;
+    /// <summary>Number of bytes the decoded pages currently occupy</summary>
+    private: std::size_t memoryUsage;
+    /// <summary>Decoded pages, most recently used first</summary>
+    private: PageList pages;
+    /// <summary>Decoded pages indexed by their page indices</summary>
+    private: std::unordered_map<std::uint64_t, PageList::iterator> pagesByIndex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_PAGEDTRACK_H
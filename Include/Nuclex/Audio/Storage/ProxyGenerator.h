@@ -0,0 +1,154 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_PROXYGENERATOR_H
+#define NUCLEX_AUDIO_STORAGE_PROXYGENERATOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/BatchTranscoder.h"
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+  class AudioTrackEncoderBuilder;
+  class AssetCatalogWriter;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates low-bitrate proxies of master files for scrubbing in editors</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Scrubbing through uncompressed or lossless masters over the network reads
+  ///     megabytes for every second of audio. A proxy is a copy of the master encoded
+  ///     at a low sample rate and bitrate (by default, Opus at 24 kHz and 48 kbps) that
+  ///     is stored next to it and takes a small fraction of the bandwidth to preview.
+  ///   </para>
+  ///   <para>
+  ///     The proxies are encoded by a <see cref="BatchTranscoder" /> and recorded in an
+  ///     asset catalog together with the <see cref="ProxyMapping" /> that lines up their
+  ///     frames with the master. An <see cref="AudioLoader" /> using that catalog opens
+  ///     the proxy through <see cref="AudioLoader.OpenPreviewDecoder" /> while
+  ///     <see cref="AudioLoader.OpenDecoder" /> keeps opening the master for exact edits.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ProxyGenerator {
+
+    /// <summary>Initializes a new proxy generator producing Opus proxies</summary>
+    /// <param name="sampleRate">Sample rate of the proxies</param>
+    /// <param name="kilobitsPerSecond">Bitrate at which the proxies will be encoded</param>
+    /// <param name="threadCount">
+    ///   Number of threads that will transcode, zero to use one for each CPU core
+    /// </param>
+    /// <remarks>
+    ///   Throws an std::runtime_error if the library was built without Opus support.
+    ///   Opus decoders can deliver audio at 8, 12, 16, 24 or 48 kHz directly, so
+    ///   proxies at one of these rates are also cheaper to decode.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ProxyGenerator(
+      std::size_t sampleRate = 24000,
+      float kilobitsPerSecond = 48.0f,
+      std::size_t threadCount = 0
+    );
+
+    /// <summary>Initializes a new proxy generator producing proxies in another format</summary>
+    /// <param name="proxyBuilder">Encoder builder, configured for the proxy format</param>
+    /// <param name="proxyExtension">File extension for proxies, without the dot</param>
+    /// <param name="sampleRate">Sample rate of the proxies</param>
+    /// <param name="threadCount">
+    ///   Number of threads that will transcode, zero to use one for each CPU core
+    /// </param>
+    public: NUCLEX_AUDIO_API ProxyGenerator(
+      const std::shared_ptr<AudioTrackEncoderBuilder> &proxyBuilder,
+      const std::string &proxyExtension,
+      std::size_t sampleRate,
+      std::size_t threadCount = 0
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API ~ProxyGenerator();
+
+    /// <summary>Determines the path a master's proxy is stored under by default</summary>
+    /// <param name="masterPath">Path of the master file</param>
+    /// <returns>The path of the proxy file next to the master</returns>
+    /// <remarks>
+    ///   The proxy keeps the master's name and extension and adds its own,
+    ///   so "drums.wav" gets the proxy "drums.wav.proxy.opus".
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::string GetDefaultProxyPath(const std::string &masterPath) const;
+
+    /// <summary>Counts the master files that have been added</summary>
+    /// <returns>The number of proxies that will be generated</returns>
+    public: std::size_t CountMasters() const { return this->masterPaths.size(); }
+
+    /// <summary>Adds a master file whose proxy should be generated</summary>
+    /// <param name="masterPath">Path of the master file</param>
+    /// <param name="proxyPath">
+    ///   Path the proxy will be written to, empty to store it next to the master
+    /// </param>
+    public: NUCLEX_AUDIO_API void AddMaster(
+      const std::string &masterPath, const std::string &proxyPath = std::string()
+    );
+
+    /// <summary>Generates the proxies of all added masters and records them</summary>
+    /// <param name="catalogWriter">Catalog writer the proxies will be recorded in</param>
+    /// <returns>The throughput statistics and errors of the transcoding run</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Masters the catalog writer already holds a record for get the proxy added to
+    ///     their record, so this can run before or after the catalog's other contents
+    ///     are collected. Other masters get a new record holding their identity and
+    ///     container informations along with the proxy.
+    ///   </para>
+    ///   <para>
+    ///     Failing masters don't stop the run, their errors are reported in the returned
+    ///     statistics and they don't get a proxy recorded. The list of masters is
+    ///     cleared afterwards.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API TranscodeStatistics Run(AssetCatalogWriter &catalogWriter);
+
+    /// <summary>Encoder builder configured for the proxy format</summary>
+    private: std::shared_ptr<AudioTrackEncoderBuilder> proxyBuilder;
+    /// <summary>File extension appended to the default proxy paths</summary>
+    private: std::string proxyExtension;
+    /// <summary>Sample rate of the proxies</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Number of threads that will be transcoding</summary>
+    private: std::size_t threadCount;
+    /// <summary>Loader used to inspect the masters and the generated proxies</summary>
+    private: std::shared_ptr<AudioLoader> loader;
+    /// <summary>Master files whose proxies will be generated</summary>
+    private: std::vector<std::string> masterPaths;
+    /// <summary>Paths the proxies will be written to, by the index of their master</summary>
+    private: std::vector<std::string> proxyPaths;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_PROXYGENERATOR_H
@@ -0,0 +1,85 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_PROXYMAPPING_H
+#define NUCLEX_AUDIO_STORAGE_PROXYMAPPING_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <algorithm> // for std::min()
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates the low-bitrate proxy of a master file and lines up their frames</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Proxies are generated by the <see cref="ProxyGenerator" /> and recorded in the
+  ///     asset catalog of their master. They hold the same audio at a lower sample rate,
+  ///     so frame positions convert by the ratio of the sample rates. The codec's own
+  ///     delay (such as the pre-skip of Opus) is already removed by the proxy's decoder.
+  ///   </para>
+  ///   <para>
+  ///     The frame counts are those of the decoders, with the proxy's decoder delivering
+  ///     audio at <see cref="ProxySampleRate" />. If the proxy's decoder reports a different
+  ///     length, the proxy doesn't belong to the master anymore.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE ProxyMapping {
+
+    /// <summary>Path of the proxy file, as it was passed to the generator</summary>
+    public: std::string ProxyPath;
+    /// <summary>Sample rate at which the proxy is decoded</summary>
+    public: std::size_t ProxySampleRate;
+    /// <summary>Number of frames in the proxy at its sample rate</summary>
+    public: std::uint64_t ProxyFrameCount;
+    /// <summary>Sample rate of the master file</summary>
+    public: std::size_t MasterSampleRate;
+    /// <summary>Number of frames in the master file</summary>
+    public: std::uint64_t MasterFrameCount;
+
+    /// <summary>Converts a frame position in the proxy to one in the master</summary>
+    /// <param name="proxyFrame">Frame index in the proxy that will be converted</param>
+    /// <returns>The index of the master's frame at the same point in time</returns>
+    public: std::uint64_t ToMasterFrame(std::uint64_t proxyFrame) const {
+      return std::min(
+        proxyFrame * this->MasterSampleRate / this->ProxySampleRate, this->MasterFrameCount
+      );
+    }
+
+    /// <summary>Converts a frame position in the master to one in the proxy</summary>
+    /// <param name="masterFrame">Frame index in the master that will be converted</param>
+    /// <returns>The index of the proxy's frame at the same point in time</returns>
+    public: std::uint64_t ToProxyFrame(std::uint64_t masterFrame) const {
+      return std::min(
+        masterFrame * this->ProxySampleRate / this->MasterSampleRate, this->ProxyFrameCount
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_PROXYMAPPING_H
@@ -0,0 +1,83 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_RAWPCMLAYOUT_H
+#define NUCLEX_AUDIO_STORAGE_RAWPCMLAYOUT_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <optional> // for std::optional
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes how the samples in a headerless PCM stream are stored</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Passed to <see cref="AudioTrackDecoder.OpenRawPcm" /> for streams that carry
+  ///     nothing but interleaved samples, such as an engine's internal audio blobs or
+  ///     a dump of a mixer's output. Since there is no header to read the format from,
+  ///     the caller has to provide it.
+  ///   </para>
+  ///   <para>
+  ///     Samples are stored in the smallest container of their format: one byte for
+  ///     unsigned 8-bit samples, three bytes for packed 24-bit samples and so on. Like
+  ///     in Waveform files, samples with fewer valid bits than their container occupy
+  ///     the most significant bits.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE RawPcmLayout {
+
+    /// <summary>Number of interleaved channels in each frame</summary>
+    public: std::size_t ChannelCount = 0;
+    /// <summary>Speakers the channels are intended for, in Waveform channel order</summary>
+    /// <remarks>
+    ///   If left at <see cref="ChannelPlacement.Unknown" />, the same placement a Waveform
+    ///   file without a channel mask would get is assumed for the channel count.
+    /// </remarks>
+    public: ChannelPlacement ChannelPlacements = ChannelPlacement::Unknown;
+    /// <summary>Samples per second in each channel</summary>
+    public: std::size_t SampleRate = 0;
+    /// <summary>Format in which the samples are stored</summary>
+    /// <remarks>
+    ///   8-bit samples are unsigned and offset by 128, all other integer formats are
+    ///   signed.
+    /// </remarks>
+    public: AudioSampleFormat SampleFormat = AudioSampleFormat::Unknown;
+    /// <summary>Number of valid bits in each sample, 0 to use the whole container</summary>
+    public: std::size_t BitsPerSample = 0;
+    /// <summary>Whether the samples are stored in little endian byte order</summary>
+    public: bool IsLittleEndian = true;
+    /// <summary>Offset of the first sample in the file, in bytes</summary>
+    public: std::uint64_t ByteOffset = 0;
+    /// <summary>Number of frames in the stream, if empty, all frames to the file's end</summary>
+    public: std::optional<std::uint64_t> FrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_RAWPCMLAYOUT_H
@@ -0,0 +1,48 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_READREQUEST_H
+#define NUCLEX_AUDIO_STORAGE_READREQUEST_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a single read that is part of a batch of reads</summary>
+  struct NUCLEX_AUDIO_TYPE ReadRequest {
+
+    /// <summary>Offset in the file at which to begin reading</summary>
+    public: std::uint64_t Start;
+    /// <summary>Number of bytes that will be read</summary>
+    public: std::size_t ByteCount;
+    /// <summary>Buffer into which the data will be read</summary>
+    public: std::byte *Buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_READREQUEST_H
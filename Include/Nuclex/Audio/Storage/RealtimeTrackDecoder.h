@@ -0,0 +1,193 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_REALTIMETRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_REALTIMETRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Delivers decoded audio to a real-time thread without ever blocking it</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The normal decoders can allocate memory, wait on a mutex and read from the file
+  ///     during any decoding call. That is fine for loading, but an audio callback that
+  ///     does either risks a dropout. This decoder runs the wrapped decoder on a background
+  ///     thread of its own, which decodes ahead into a fixed-size ring buffer. The audio
+  ///     thread only ever copies out of that ring buffer.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="TryDecodeInterleaved" /> and <see cref="TryDecodeSeparated" /> never
+  ///     allocate, never take a lock and never touch the file. If the requested frames are
+  ///     not resident yet, they return false right away (&quot;not ready&quot;) and ask the
+  ///     background thread to decode from that position. Reading consecutive ranges keeps
+  ///     the background thread ahead of the reader, any other request is a reposition.
+  ///   </para>
+  ///   <para>
+  ///     Only one thread may call the real-time methods. Samples are delivered as floats,
+  ///     which is what mixers work with anyway. For the file reads of the background thread
+  ///     to stay short, open the file through a read-ahead or block cache.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE RealtimeTrackDecoder {
+
+    /// <summary>Initializes a new real-time decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder that will be run on the background thread</param>
+    /// <param name="bufferedFrameCount">
+    ///   Number of frames the ring buffer can hold. This also is the largest number of
+    ///   frames that can be requested in one call.
+    /// </param>
+    /// <param name="startFrame">Frame from which the background thread begins decoding</param>
+    public: NUCLEX_AUDIO_API RealtimeTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t bufferedFrameCount = 16384,
+      std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Stops the background thread and frees all resources</summary>
+    public: NUCLEX_AUDIO_API ~RealtimeTrackDecoder();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const { return this->totalFrameCount; }
+
+    /// <summary>Returns the number of frames the ring buffer can hold</summary>
+    /// <returns>The maximum number of frames that can be requested in one call</returns>
+    public: std::size_t GetBufferedFrameCount() const { return this->capacity; }
+
+    /// <summary>Waits until the specified range of frames is resident</summary>
+    /// <param name="startFrame">Index of the first frame that should be resident</param>
+    /// <param name="frameCount">Number of frames that should be resident</param>
+    /// <remarks>
+    ///   This is not real-time safe. Use it to prime the decoder before playback starts.
+    ///   If the background thread failed to decode, the error is rethrown here.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void WaitUntilReady(
+      std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Copies decoded audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to deliver</param>
+    /// <param name="frameCount">Number of audio frames that will be delivered</param>
+    /// <returns>
+    ///   True if the frames were delivered, false if they were not resident yet
+    /// </returns>
+    /// <remarks>
+    ///   This method is real-time safe. If the frames were not ready, nothing is written
+    ///   to the buffer and the background thread is asked to decode them.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API bool TryDecodeInterleaved(
+      float *buffer, std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Copies decoded audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to deliver</param>
+    /// <param name="frameCount">Number of audio frames that will be delivered</param>
+    /// <returns>
+    ///   True if the frames were delivered, false if they were not resident yet
+    /// </returns>
+    /// <remarks>
+    ///   This method is real-time safe. You can pass a null pointer for channels you
+    ///   are not interested in.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API bool TryDecodeSeparated(
+      float *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    );
+
+    /// <summary>Checks whether a range of frames can be delivered right now</summary>
+    /// <param name="startFrame">Index of the first frame that should be delivered</param>
+    /// <param name="frameCount">Number of frames that should be delivered</param>
+    /// <returns>The ring buffer index of the first frame or -1 if it is not ready</returns>
+    private: std::ptrdiff_t tryAcquire(std::uint64_t startFrame, std::size_t frameCount);
+
+    /// <summary>Marks the frames up to the specified one as consumed</summary>
+    /// <param name="endFrame">Frame up to which the reader is done with the data</param>
+    private: void release(std::uint64_t endFrame);
+
+    /// <summary>Asks the background thread to begin decoding from another frame</summary>
+    /// <param name="startFrame">Frame from which the background thread should decode</param>
+    private: void requestReposition(std::uint64_t startFrame);
+
+    /// <summary>Decodes ahead into the ring buffer until the decoder is destroyed</summary>
+    private: void decodeAhead();
+
+    /// <summary>Decoder that is run on the background thread</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Number of audio channels in the decoded track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Total number of frames in the decoded track</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Number of frames the ring buffer can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Interleaved decoded samples, indexed by frame modulo the capacity</summary>
+    private: std::unique_ptr<float[]> ring;
+
+    /// <summary>Incremented by the reader each time it requests a reposition</summary>
+    private: std::atomic<std::uint32_t> requestedEpoch;
+    /// <summary>Frame the reader wants the background thread to decode from</summary>
+    private: std::atomic<std::uint64_t> requestedStartFrame;
+    /// <summary>Repositioning request the ring buffer contents currently belong to</summary>
+    private: std::atomic<std::uint32_t> residentEpoch;
+    /// <summary>Frame at which the resident frames end</summary>
+    private: std::atomic<std::uint64_t> residentEndFrame;
+    /// <summary>Frame before which the reader no longer needs any data</summary>
+    private: std::atomic<std::uint64_t> consumedFrame;
+    /// <summary>Set when the background thread failed to decode</summary>
+    private: std::atomic<bool> failed;
+    /// <summary>Set when the background thread should shut down</summary>
+    private: std::atomic<bool> stopping;
+
+    /// <summary>Exception that caused the background thread to fail</summary>
+    private: std::exception_ptr error;
+    /// <summary>Used by the background thread to sleep while there is nothing to do</summary>
+    private: std::mutex wakeMutex;
+    /// <summary>Wakes the background thread up when the reader has made room</summary>
+    private: std::condition_variable wakeCondition;
+    /// <summary>Background thread that decodes ahead of the reader</summary>
+    private: std::thread decodeThread;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_REALTIMETRACKDECODER_H
@@ -0,0 +1,85 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_REMOTEREADPOLICY_H
+#define NUCLEX_AUDIO_STORAGE_REMOTEREADPOLICY_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How reads from a file on high-latency storage are hedged and retried</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Used with <see cref="VirtualFile.WrapForRemoteAccess" /> for files living on
+  ///     object storage or similar backends where most reads are quick, but some take
+  ///     many times longer and a few fail for no lasting reason.
+  ///   </para>
+  ///   <para>
+  ///     A read that hasn't finished after the hedge delay is issued a second time and
+  ///     whichever request finishes first is used. Once enough reads have been observed,
+  ///     the hedge delay follows <see cref="HedgePercentile" /> of their latencies, so
+  ///     only the slowest few percent of reads are duplicated. Reads that fail with
+  ///     a runtime error are retried with exponentially growing pauses. Errors such as
+  ///     reading beyond the end of the file are reported right away.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE RemoteReadPolicy {
+
+    /// <summary>Time after which a read is hedged until latencies have been observed</summary>
+    /// <remarks>
+    ///   Zero turns hedging off.
+    /// </remarks>
+    public: std::chrono::nanoseconds InitialHedgeDelay = std::chrono::milliseconds(100);
+    /// <summary>Shortest time after which a read is hedged</summary>
+    /// <remarks>
+    ///   Keeps a backend with very consistent latency from getting every read twice.
+    /// </remarks>
+    public: std::chrono::nanoseconds MinimumHedgeDelay = std::chrono::milliseconds(5);
+    /// <summary>Fraction of reads that should finish before a read is hedged</summary>
+    public: double HedgePercentile = 0.95;
+    /// <summary>Number of times a failed read is retried before its error is reported</summary>
+    public: std::size_t MaximumRetryCount = 3;
+    /// <summary>Pause before the first retry, doubled for each one after it</summary>
+    public: std::chrono::nanoseconds InitialRetryDelay = std::chrono::milliseconds(50);
+    /// <summary>Smallest number of bytes fetched when a read misses the read-ahead</summary>
+    /// <remarks>
+    ///   Zero turns read-ahead off. Reads are aligned to this size.
+    /// </remarks>
+    public: std::size_t MinimumReadAheadByteCount = 65536;
+    /// <summary>Largest number of bytes fetched when a read misses the read-ahead</summary>
+    /// <remarks>
+    ///   The read-ahead grows from the minimum to the product of the observed latency
+    ///   and bandwidth, so that the time spent transferring data is about as long as
+    ///   the time spent waiting for the backend to respond, but never beyond this.
+    /// </remarks>
+    public: std::size_t MaximumReadAheadByteCount = 4 * 1024 * 1024;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_REMOTEREADPOLICY_H
@@ -0,0 +1,53 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_REPLAYGAINMODE_H
+#define NUCLEX_AUDIO_STORAGE_REPLAYGAINMODE_H
+
+#include "Nuclex/Audio/Config.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Which of the loudness normalization gains in a file a decoder applies</summary>
+  /// <remarks>
+  ///   Track gain makes all tracks play equally loud. Album gain keeps the loudness
+  ///   differences between the tracks of an album intact. If the file has no album gain,
+  ///   the track gain is used instead. Gains are limited so that the peak stored
+  ///   with them doesn't clip.
+  /// </remarks>
+  enum class ReplayGainMode {
+
+    /// <summary>Deliver the samples as they were encoded</summary>
+    Off = 0,
+
+    /// <summary>Apply the track gain</summary>
+    Track = 1,
+
+    /// <summary>Apply the album gain, falling back to the track gain</summary>
+    Album = 2
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_REPLAYGAINMODE_H
@@ -0,0 +1,174 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_RESIDENTCOMPRESSEDTRACK_H
+#define NUCLEX_AUDIO_STORAGE_RESIDENTCOMPRESSEDTRACK_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <list> // for std::list
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+  class AudioTrackDecoder;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio track kept in memory in its compressed form</summary>
+  /// <remarks>
+  ///   <para>
+  ///     FLAC and Opus files are often 4 to 10 times smaller than the PCM samples they
+  ///     decode to. On memory-constrained platforms, keeping the encoded file in memory
+  ///     and decoding just the blocks that are played can be the difference between
+  ///     fitting all sound effects into RAM or streaming them from disk.
+  ///   </para>
+  ///   <para>
+  ///     The whole file is loaded into memory and its seek index is built up front, so
+  ///     any codec block can be reached directly. Decoded blocks are kept in a small
+  ///     cache of least recently used blocks. Reads of frames that are cached merely copy
+  ///     samples, reads of other frames decode the blocks touched.
+  ///   </para>
+  ///   <para>
+  ///     All methods are thread-safe. Each thread decoding concurrently gets its own
+  ///     clone of the decoder (see <see cref="AudioTrackDecoder.CreatePool" />), so threads
+  ///     only wait for each other when they access the block cache.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE ResidentCompressedTrack {
+
+    /// <summary>Loads an audio file into memory and prepares it for decoding</summary>
+    /// <param name="loader">Audio loader that will open the decoder for the file</param>
+    /// <param name="file">File that will be loaded into memory</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="cacheMemoryLimit">
+    ///   Maximum number of bytes the decoded block cache may use
+    /// </param>
+    public: NUCLEX_AUDIO_API ResidentCompressedTrack(
+      const AudioLoader &loader,
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &extensionHint = std::string(),
+      std::size_t cacheMemoryLimit = 1048576
+    );
+
+    /// <summary>Frees the compressed file and all cached blocks</summary>
+    public: NUCLEX_AUDIO_API ~ResidentCompressedTrack();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountChannels() const;
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio track consists of</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountFrames() const;
+
+    /// <summary>Gets the order in which channels are interleaved</summary>
+    /// <returns>A list of channels in the order they are interleaved</returns>
+    public: NUCLEX_AUDIO_API const std::vector<ChannelPlacement> &GetChannelOrder() const;
+
+    /// <summary>Returns the number of bytes the compressed file occupies</summary>
+    /// <returns>The size of the compressed file in bytes</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t GetCompressedByteCount() const;
+
+    /// <summary>Returns the number of bytes the cached decoded blocks occupy</summary>
+    /// <returns>The memory currently used by the block cache in bytes</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetCacheMemoryUsage() const;
+
+    /// <summary>Counts the number of blocks that were served from the cache</summary>
+    /// <returns>The number of cache hits since the track was created</returns>
+    public: std::uint64_t CountHits() const {
+      return this->hitCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts the number of blocks that had to be decoded</summary>
+    /// <returns>The number of cache misses since the track was created</returns>
+    public: std::uint64_t CountMisses() const {
+      return this->missCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="target">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame that will be decoded</param>
+    /// <param name="frameCount">Number of frames that will be decoded</param>
+    public: NUCLEX_AUDIO_API void DecodeInterleaved(
+      float *target, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decoded codec block kept in the cache</summary>
+    private: struct CachedBlock {
+
+      /// <summary>Index of the first frame stored in the block</summary>
+      public: std::uint64_t StartFrame;
+      /// <summary>Interleaved samples of all frames in the block</summary>
+      public: std::shared_ptr<const SampleVector<float>> Samples;
+
+    };
+
+    /// <summary>List of blocks ordered from most recently to least recently used</summary>
+    private: typedef std::list<CachedBlock> BlockList;
+
+    /// <summary>Fetches the decoded samples of a codec block</summary>
+    /// <param name="blockStart">Index of the first frame in the block</param>
+    /// <param name="frameCount">Number of frames in the block</param>
+    /// <returns>The interleaved samples of the block</returns>
+    private: std::shared_ptr<const SampleVector<float>> getBlock(
+      std::uint64_t blockStart, std::size_t frameCount
+    ) const;
+
+    /// <summary>The compressed file, held in memory</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Pool of decoders handing each thread a clone of its own</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Maximum number of bytes the decoded blocks may occupy</summary>
+    private: std::size_t cacheMemoryLimit;
+    /// <summary>Must be held while accessing the block cache</summary>
+    private: mutable std::mutex cacheMutex;
+    /// <summary>Number of bytes the decoded blocks currently occupy</summary>
+    private: mutable std::size_t cacheMemoryUsage;
+    /// <summary>Decoded blocks, most recently used first</summary>
+    private: mutable BlockList blocks;
+    /// <summary>Decoded blocks indexed by the first frame they contain</summary>
+    private: mutable std::unordered_map<std::uint64_t, BlockList::iterator> blocksByStart;
+    /// <summary>Number of blocks that were served from the cache</summary>
+    private: mutable std::atomic<std::uint64_t> hitCount;
+    /// <summary>Number of blocks that had to be decoded</summary>
+    private: mutable std::atomic<std::uint64_t> missCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_RESIDENTCOMPRESSEDTRACK_H
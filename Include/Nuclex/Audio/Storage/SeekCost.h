@@ -0,0 +1,81 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SEEKCOST_H
+#define NUCLEX_AUDIO_STORAGE_SEEKCOST_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Estimated work a decoder has to do before it can deliver a specific frame</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained via <see cref="AudioTrackDecoder.EstimateSeekCost" />. Meant for schedulers
+  ///     that have several decoding requests queued up and want to serve the cheap ones
+  ///     first or that want to move an idle decoder to where it will be needed next.
+  ///   </para>
+  ///   <para>
+  ///     Compressed formats can only begin decoding at certain points in the file, so
+  ///     seeking means jumping to such a point, then decoding and throwing away audio
+  ///     until the requested frame is reached. Without a seek index, the codec library
+  ///     has to search the file for that point first, which takes several jumps.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE SeekCost {
+
+    /// <summary>Number of bytes that are read before the requested frame is decoded</summary>
+    /// <remarks>
+    ///   Includes the data read while searching the file and the data of the frames
+    ///   that are decoded and thrown away. Unless <see cref="IsPrecise" /> is set, this
+    ///   is extrapolated from the file's average bitrate.
+    /// </remarks>
+    public: std::uint64_t ByteCount;
+    /// <summary>Number of frames that are decoded and thrown away</summary>
+    /// <remarks>
+    ///   Includes the pre-roll formats such as Opus need to decode before a seek
+    ///   target for their output to be accurate.
+    /// </remarks>
+    public: std::uint64_t DiscardedFrameCount;
+    /// <summary>Number of times the decoder jumps to a different place in the file</summary>
+    /// <remarks>
+    ///   Zero if the decoder is already positioned at the requested frame, one if it
+    ///   knows where to jump and more if it has to search the file. Each of these is
+    ///   a disk seek for mechanical drives and a round trip for network streams.
+    /// </remarks>
+    public: std::size_t RandomAccessCount;
+    /// <summary>Whether the decoder knows exactly where it would resume decoding</summary>
+    /// <remarks>
+    ///   True when the jump target comes from a seek table, seek index or checkpoint
+    ///   or from the file format itself, as is the case for uncompressed audio.
+    /// </remarks>
+    public: bool IsPrecise;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SEEKCOST_H
@@ -0,0 +1,138 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SEQUENTIALDECODESESSION_H
+#define NUCLEX_AUDIO_STORAGE_SEQUENTIALDECODESESSION_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::unique_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes an audio track from front to back in small chunks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each call to the decoder verifies the requested range, takes the decoding mutex
+  ///     and checks whether it needs to seek. That is negligible for large reads, but
+  ///     when an audio callback asks for 64 frames at a time, it adds up. This session
+  ///     asks the decoder for a large chunk at once and hands out small pieces of it,
+  ///     so the per-call cost is little more than a copy.
+  ///   </para>
+  ///   <para>
+  ///     The session only moves forward. It remembers where it is in the track, so
+  ///     the caller just asks for the next frames until <see cref="IsAtEnd" /> returns
+  ///     true. Requests that are at least as large as a chunk skip the session's buffer
+  ///     and decode directly into the caller's buffer. Samples are delivered as floats.
+  ///   </para>
+  ///   <para>
+  ///     A session is not thread-safe. The decoder it runs on can still be used
+  ///     by other code, though that will make the decoder seek back and forth.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SequentialDecodeSession {
+
+    /// <summary>Initializes a new sequential decode session on the specified decoder</summary>
+    /// <param name="decoder">Decoder from which the session will decode</param>
+    /// <param name="startFrame">Frame at which the session will begin decoding</param>
+    /// <param name="chunkFrameCount">
+    ///   Number of frames the session requests from the decoder at once
+    /// </param>
+    public: NUCLEX_AUDIO_API SequentialDecodeSession(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::uint64_t startFrame = 0,
+      std::size_t chunkFrameCount = 4096
+    );
+
+    /// <summary>Frees all resources owned by the session</summary>
+    public: NUCLEX_AUDIO_API ~SequentialDecodeSession();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const { return this->totalFrameCount; }
+
+    /// <summary>Returns the index of the frame that will be delivered next</summary>
+    /// <returns>The index of the next frame the session will deliver</returns>
+    public: std::uint64_t GetFrameCursorPosition() const { return this->cursor; }
+
+    /// <summary>Checks whether the session has delivered all frames of the track</summary>
+    /// <returns>True if there are no more frames to deliver</returns>
+    public: bool IsAtEnd() const { return (this->cursor >= this->totalFrameCount); }
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Number of audio frames that should be delivered</param>
+    /// <returns>
+    ///   The number of frames that were delivered, which is less than requested only
+    ///   when the end of the track is reached
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::size_t DecodeInterleaved(
+      float *buffer, std::size_t frameCount
+    );
+
+    /// <summary>Delivers the next audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="frameCount">Number of audio frames that should be delivered</param>
+    /// <returns>
+    ///   The number of frames that were delivered, which is less than requested only
+    ///   when the end of the track is reached
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::size_t DecodeSeparated(
+      float *buffers[], std::size_t frameCount
+    );
+
+    /// <summary>Refills the chunk buffer with the frames following the cursor</summary>
+    private: void refill();
+
+    /// <summary>Decoder the session is decoding from</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Number of audio channels in the decoded track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Total number of frames in the decoded track</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Number of frames the chunk buffer can hold</summary>
+    private: std::size_t chunkFrameCount;
+    /// <summary>Interleaved samples of the most recently decoded chunk</summary>
+    private: std::unique_ptr<float[]> chunk;
+    /// <summary>Index of the next frame in the chunk buffer to deliver</summary>
+    private: std::size_t chunkPosition;
+    /// <summary>Number of frames currently stored in the chunk buffer</summary>
+    private: std::size_t chunkLength;
+    /// <summary>Index of the frame that will be delivered next</summary>
+    private: std::uint64_t cursor;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SEQUENTIALDECODESESSION_H
@@ -0,0 +1,93 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SEQUENTIALSOURCE_H
+#define NUCLEX_AUDIO_STORAGE_SEQUENTIALSOURCE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t, std::byte
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Delivers data front to back from a source that can't seek</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A <see cref="VirtualFile" /> needs to know its size and be able to read from any
+  ///     offset. Pipes, sockets, standard input or an upload that is still in progress
+  ///     can do neither. This interface only asks for the next bytes, so it can be
+  ///     implemented on top of anything that produces data in order.
+  ///   </para>
+  ///   <para>
+  ///     Use it with the <see cref="SequentialTrackDecoder" />, which decodes audio data
+  ///     as it arrives without ever going back, instead of spooling it to disk first.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SequentialSource {
+
+    /// <summary>Creates a sequential source that reads from the process' standard input</summary>
+    /// <returns>A sequential source delivering the data piped into the process</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<SequentialSource> OpenStandardInput();
+
+    /// <summary>Creates a sequential source that reads a virtual file front to back</summary>
+    /// <param name="file">File whose contents the source will deliver</param>
+    /// <returns>A sequential source delivering the contents of the file</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<SequentialSource> FromVirtualFile(
+      const std::shared_ptr<const VirtualFile> &file
+    );
+
+    /// <summary>Frees all resources owned by the sequential source</summary>
+    public: NUCLEX_AUDIO_API virtual ~SequentialSource() = default;
+
+    /// <summary>Reads the next bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Maximum number of bytes that will be read</param>
+    /// <returns>
+    ///   The number of bytes that were read, which can be fewer than requested.
+    ///   Zero is only returned once the end of the data has been reached.
+    /// </returns>
+    /// <remarks>
+    ///   If no data is available yet, this should block until at least one byte
+    ///   has arrived or the end of the data is reached.
+    /// </remarks>
+    public: virtual std::size_t ReadSome(std::byte *buffer, std::size_t byteCount) = 0;
+
+    /// <summary>Reads the next bytes from the source until the buffer is full</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <returns>
+    ///   The number of bytes that were read, which is less than requested only
+    ///   when the end of the data has been reached
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::size_t ReadFully(std::byte *buffer, std::size_t byteCount);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SEQUENTIALSOURCE_H
@@ -0,0 +1,109 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SEQUENTIALTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_SEQUENTIALTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h" // for ChannelPlacement
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <optional> // for std::optional
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class SequentialSource;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes an audio track from a source that can only be read front to back</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The <see cref="AudioTrackDecoder" /> can jump to any frame, which requires random
+  ///     access to the file and knowing its length up front. This decoder never seeks and
+  ///     never asks for the length, so it can decode audio data as it arrives through
+  ///     a pipe, a socket or an upload in progress.
+  ///   </para>
+  ///   <para>
+  ///     Waveform files (including ones written with a streaming header that leaves
+  ///     the data chunk length open), FLAC files and Ogg Vorbis or Ogg Opus streams
+  ///     are supported. The total number of frames is only known if the file
+  ///     header records it, so <see cref="TryCountFrames" /> may well be empty.
+  ///   </para>
+  ///   <para>
+  ///     A sequential decoder is not thread-safe. Samples are delivered as floats.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SequentialTrackDecoder {
+
+    /// <summary>Reads the beginning of a stream and opens a fitting decoder for it</summary>
+    /// <param name="source">Source from which the encoded audio data will be read</param>
+    /// <returns>A sequential decoder for the audio track in the stream</returns>
+    /// <remarks>
+    ///   This blocks until the source has delivered enough data to identify the codec
+    ///   and parse the audio format from the stream's headers.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::unique_ptr<SequentialTrackDecoder> Open(
+      const std::shared_ptr<SequentialSource> &source
+    );
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: NUCLEX_AUDIO_API virtual ~SequentialTrackDecoder() = default;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: virtual std::size_t CountChannels() const = 0;
+
+    /// <summary>Produces the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: virtual const std::vector<ChannelPlacement> &GetChannelOrder() const = 0;
+
+    /// <summary>Returns the number of samples per second in each channel</summary>
+    /// <returns>The sample rate of the audio track</returns>
+    public: virtual std::size_t GetSampleRate() const = 0;
+
+    /// <summary>Returns the number of frames in the track if it is known</summary>
+    /// <returns>The number of frames in the track or nothing if it isn't recorded</returns>
+    public: virtual std::optional<std::uint64_t> TryCountFrames() const = 0;
+
+    /// <summary>Returns the number of frames that have been delivered so far</summary>
+    /// <returns>The index of the frame that will be delivered next</returns>
+    public: virtual std::uint64_t GetFrameCursorPosition() const = 0;
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of audio frames that should be delivered</param>
+    /// <returns>
+    ///   The number of frames that were delivered, which can be fewer than requested.
+    ///   Zero is only returned once the end of the track has been reached.
+    /// </returns>
+    public: virtual std::size_t DecodeInterleaved(float *buffer, std::size_t frameCount) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SEQUENTIALTRACKDECODER_H
@@ -0,0 +1,162 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHAREDSAMPLECACHE_H
+#define NUCLEX_AUDIO_STORAGE_SHAREDSAMPLECACHE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class SharedMemoryRegion;
+  class SharedCachedTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cache of decoded samples that all processes on a machine can share</summary>
+  /// <remarks>
+  ///   <para>
+  ///     When an editor, a previewer and build tools run side by side, each of them
+  ///     would normally decode the same assets on its own. This cache lives in a named
+  ///     shared memory region, so a block decoded by one process is picked up by all
+  ///     others opening the cache under the same name. Decoders are wrapped via
+  ///     <see cref="AudioTrackDecoder::CreateSharedCached" /> to go through it.
+  ///   </para>
+  ///   <para>
+  ///     The region is divided into fixed-size slots, each holding one block of decoded
+  ///     samples. Its directory is only ever changed via atomic operations, so processes
+  ///     never wait on a lock held by another process. A slot that is being read can't be
+  ///     evicted. When a slot is needed, the least recently used free slot among a few
+  ///     candidates is replaced.
+  ///   </para>
+  ///   <para>
+  ///     The cache is only an accelerator: if another process is writing the slot a block
+  ///     would go into, the block simply isn't cached. If a process dies while reading
+  ///     or writing a slot, that slot stays out of use until the region is recreated.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SharedSampleCache {
+
+    /// <summary>Decoders going through the cache need to access its slots</summary>
+    friend class SharedCachedTrackDecoder;
+
+    /// <summary>Opens the named cache or creates it if no process has done so yet</summary>
+    /// <param name="name">Name under which processes find the cache, without slashes</param>
+    /// <param name="capacity">Number of bytes the cache will hold if it is created</param>
+    /// <param name="slotSize">
+    ///   Number of bytes each slot can hold if the cache is created. Blocks of decoded
+    ///   samples are sized to fit into one slot.
+    /// </param>
+    /// <returns>The opened cache</returns>
+    /// <remarks>
+    ///   The process creating the cache decides its capacity and slot size, all other
+    ///   processes use the cache as it was created. Caches with different names are
+    ///   completely independent.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<SharedSampleCache> Open(
+      const std::string &name,
+      std::size_t capacity = 67108864,
+      std::size_t slotSize = 262144
+    );
+
+    /// <summary>Removes the named cache so that it will be recreated on the next open</summary>
+    /// <param name="name">Name of the cache that will be removed</param>
+    /// <remarks>
+    ///   Processes that have the cache open keep using the old one. On Windows, the cache
+    ///   disappears by itself when the last process closes it and this does nothing.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Remove(const std::string &name);
+
+    /// <summary>Closes the cache, leaving it to the other processes using it</summary>
+    public: NUCLEX_AUDIO_API ~SharedSampleCache();
+
+    /// <summary>Returns the number of bytes each slot can hold</summary>
+    /// <returns>The maximum size of a cached block in bytes</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetSlotSize() const;
+
+    /// <summary>Counts the slots the cache has been divided into</summary>
+    /// <returns>The number of blocks the cache can hold at once</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountSlots() const;
+
+    /// <summary>Counts the blocks this process found in the cache</summary>
+    /// <returns>The number of cache hits in this process</returns>
+    public: std::uint64_t CountHits() const {
+      return this->hitCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts the blocks this process had to decode by itself</summary>
+    /// <returns>The number of cache misses in this process</returns>
+    public: std::uint64_t CountMisses() const {
+      return this->missCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Initializes a new shared sample cache on a mapped region</summary>
+    /// <param name="region">Shared memory region holding the cache</param>
+    private: SharedSampleCache(std::unique_ptr<SharedMemoryRegion> &&region);
+
+    /// <summary>Checks whether a block is in the cache without pinning it</summary>
+    /// <param name="key">Key of the block that will be looked up</param>
+    /// <param name="byteCount">Number of bytes the block must have</param>
+    /// <returns>True if the block was in the cache at the time of the call</returns>
+    private: bool contains(std::uint64_t key, std::size_t byteCount) const;
+
+    /// <summary>Looks up a block and pins its slot so it can't be evicted</summary>
+    /// <param name="key">Key of the block that will be looked up</param>
+    /// <param name="byteCount">Number of bytes the block must have</param>
+    /// <param name="slotIndex">Receives the index of the pinned slot</param>
+    /// <returns>The block's contents or a null pointer if it isn't cached</returns>
+    /// <remarks>
+    ///   The slot has to be unpinned via <see cref="release" /> when done with it.
+    /// </remarks>
+    private: const std::byte *tryAcquire(
+      std::uint64_t key, std::size_t byteCount, std::size_t &slotIndex
+    );
+
+    /// <summary>Unpins a slot pinned by <see cref="tryAcquire" /></summary>
+    /// <param name="slotIndex">Index of the slot that will be unpinned</param>
+    private: void release(std::size_t slotIndex);
+
+    /// <summary>Stores a block in the cache if a slot can be claimed for it</summary>
+    /// <param name="key">Key under which the block will be stored</param>
+    /// <param name="data">Contents of the block</param>
+    /// <param name="byteCount">Number of bytes in the block</param>
+    private: void tryStore(std::uint64_t key, const std::byte *data, std::size_t byteCount);
+
+    /// <summary>Shared memory region holding the cache's directory and slots</summary>
+    private: std::unique_ptr<SharedMemoryRegion> region;
+    /// <summary>Number of blocks this process found in the cache</summary>
+    private: std::atomic<std::uint64_t> hitCount;
+    /// <summary>Number of blocks this process had to decode by itself</summary>
+    private: std::atomic<std::uint64_t> missCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SHAREDSAMPLECACHE_H
@@ -0,0 +1,262 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SOUNDBANK_H
+#define NUCLEX_AUDIO_STORAGE_SOUNDBANK_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+
+#include <cstddef> // for std::byte
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class AudioLoader;
+  class AudioTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a single clip stored in a sound bank</summary>
+  struct NUCLEX_AUDIO_TYPE SoundBankClip {
+
+    /// <summary>Name by which the clip can be looked up</summary>
+    public: std::string Name;
+    /// <summary>File extension of the encoded clip, used as a hint to pick the codec</summary>
+    public: std::string Extension;
+    /// <summary>Informations about the audio track the clip holds</summary>
+    public: TrackInfo Info;
+    /// <summary>Sample format the clip should preferrably be decoded to</summary>
+    /// <remarks>
+    ///   Chosen by the build tool writing the bank, for example to let clips that will
+    ///   be mixed be decoded to floats while others stay in their native format.
+    ///   <see cref="AudioSampleFormat::Unknown" /> leaves the choice to the caller.
+    /// </remarks>
+    public: AudioSampleFormat PreferredFormat;
+    /// <summary>Seek index obtained via <see cref="AudioTrackDecoder.SaveSeekIndex" /></summary>
+    public: std::vector<std::byte> SeekIndex;
+    /// <summary>Size of the encoded clip in bytes</summary>
+    public: std::uint64_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects encoded clips and packs them into a sound bank file</summary>
+  class NUCLEX_AUDIO_TYPE SoundBankWriter {
+
+    /// <summary>Adds an encoded clip whose informations are already known</summary>
+    /// <param name="clip">Description of the clip, its byte count is filled in</param>
+    /// <param name="encodedFile">Complete audio file holding the clip</param>
+    /// <returns>The index by which the clip can be accessed in the bank</returns>
+    /// <remarks>
+    ///   Names must be unique within a bank. If a clip with the same name has been
+    ///   added before, an std::invalid_argument exception is thrown.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Add(
+      const SoundBankClip &clip, const std::vector<std::byte> &encodedFile
+    );
+
+    /// <summary>Adds an encoded audio file, reading its informations via a loader</summary>
+    /// <param name="loader">Audio loader that will be used to inspect the file</param>
+    /// <param name="name">Name by which the clip can be looked up</param>
+    /// <param name="file">Audio file that will be packed into the bank</param>
+    /// <param name="extension">File extension of the audio file, if known</param>
+    /// <param name="preferredFormat">Sample format the clip should be decoded to</param>
+    /// <returns>The index by which the clip can be accessed in the bank</returns>
+    /// <remarks>
+    ///   The file is opened once to record its track informations and seek index, so
+    ///   that the bank's reader doesn't need to do either later.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Add(
+      const AudioLoader &loader,
+      const std::string &name,
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &extension = std::string(),
+      AudioSampleFormat preferredFormat = AudioSampleFormat::Unknown
+    );
+
+    /// <summary>Counts the clips that have been added to the bank</summary>
+    /// <returns>The number of clips in the bank</returns>
+    public: std::size_t CountClips() const { return this->clips.size(); }
+
+    /// <summary>Writes the sound bank into a file</summary>
+    /// <param name="target">File the sound bank will be written into</param>
+    public: NUCLEX_AUDIO_API void Save(VirtualFile &target) const;
+
+    /// <summary>Descriptions of the clips in the order they were added</summary>
+    private: std::vector<SoundBankClip> clips;
+    /// <summary>Encoded audio files holding the clips</summary>
+    private: std::vector<std::vector<std::byte>> encodedFiles;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides access to many small audio clips packed into a single file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Opening thousands of tiny clips one by one costs a file open, format detection
+  ///     and codec setup each. A sound bank packs the encoded clips together with their
+  ///     track informations and seek indices into one file, written by a build tool
+  ///     through <see cref="SoundBankWriter" />.
+  ///   </para>
+  ///   <para>
+  ///     The bank is opened once (memory-mapped if possible) and nothing is parsed up
+  ///     front. Clips are located by index or through a hash table by name. Decoders
+  ///     for a clip read straight from the bank's memory through a sub-range view, are
+  ///     handed the codec's file extension to skip detection and receive the stored seek
+  ///     index. The bank is immutable, so it can be used from any number of threads.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE SoundBank {
+
+    /// <summary>Opens a sound bank file by mapping it into memory</summary>
+    /// <param name="path">Path of the sound bank file that will be opened</param>
+    /// <returns>The sound bank stored in the specified file</returns>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const SoundBank> Open(
+      const std::string &path
+    );
+
+    /// <summary>Initializes a new sound bank accessing the specified file</summary>
+    /// <param name="file">File holding the sound bank</param>
+    /// <remarks>
+    ///   If the file can lend out its memory (as memory-mapped files can), the bank
+    ///   works on it directly. Otherwise, its table of contents is read into memory once.
+    ///   A CorruptedFileError is thrown if the file is not a sound bank.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API explicit SoundBank(const std::shared_ptr<const VirtualFile> &file);
+
+    /// <summary>Frees all resources owned by the sound bank</summary>
+    public: NUCLEX_AUDIO_API ~SoundBank();
+
+    /// <summary>Counts the clips stored in the sound bank</summary>
+    /// <returns>The number of clips in the sound bank</returns>
+    public: std::size_t CountClips() const { return this->clipCount; }
+
+    /// <summary>Looks up the index of a clip by its name</summary>
+    /// <param name="name">Name of the clip that will be looked up</param>
+    /// <returns>The index of the clip or nothing if the bank has no such clip</returns>
+    public: NUCLEX_AUDIO_API std::optional<std::size_t> TryFindClip(
+      const std::string &name
+    ) const;
+
+    /// <summary>Retrieves the description of a clip</summary>
+    /// <param name="clipIndex">Index of the clip whose description will be returned</param>
+    /// <returns>The description of the clip</returns>
+    public: NUCLEX_AUDIO_API SoundBankClip GetClip(std::size_t clipIndex) const;
+
+    /// <summary>Provides the encoded audio file of a clip</summary>
+    /// <param name="clipIndex">Index of the clip whose audio file will be returned</param>
+    /// <returns>A read-only view of the clip's audio file within the bank</returns>
+    public: NUCLEX_AUDIO_API std::shared_ptr<const VirtualFile> OpenClipFile(
+      std::size_t clipIndex
+    ) const;
+
+    /// <summary>Creates a track decoder for a clip</summary>
+    /// <param name="loader">Audio loader providing the codecs</param>
+    /// <param name="clipIndex">Index of the clip that will be decoded</param>
+    /// <returns>A decoder through which the clip's samples can be read</returns>
+    public: NUCLEX_AUDIO_API std::shared_ptr<AudioTrackDecoder> OpenDecoder(
+      const AudioLoader &loader, std::size_t clipIndex
+    ) const;
+
+    /// <summary>Creates a track decoder for a clip</summary>
+    /// <param name="loader">Audio loader providing the codecs</param>
+    /// <param name="name">Name of the clip that will be decoded</param>
+    /// <returns>A decoder through which the clip's samples can be read</returns>
+    /// <remarks>
+    ///   An std::out_of_range exception is thrown if the bank has no clip of that name.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::shared_ptr<AudioTrackDecoder> OpenDecoder(
+      const AudioLoader &loader, const std::string &name
+    ) const;
+
+    /// <summary>Points an existing track decoder at a clip, reusing it where possible</summary>
+    /// <param name="loader">Audio loader providing the codecs</param>
+    /// <param name="decoder">
+    ///   Decoder that will be reused. If it is empty or can't be reopened, it is replaced.
+    /// </param>
+    /// <param name="clipIndex">Index of the clip that will be decoded</param>
+    /// <remarks>
+    ///   When playing many clips of the same format one after another, this saves
+    ///   the codec setup (see <see cref="AudioLoader.ReopenDecoder" />).
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void ReopenDecoder(
+      const AudioLoader &loader,
+      std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t clipIndex
+    ) const;
+
+    /// <summary>Sound banks may point into their own memory and can't be copied</summary>
+    private: SoundBank(const SoundBank &other) = delete;
+    /// <summary>Sound banks may point into their own memory and can't be copied</summary>
+    private: SoundBank &operator =(const SoundBank &other) = delete;
+
+    /// <summary>Finds the offset of the record describing a clip</summary>
+    /// <param name="clipIndex">Index of the clip whose record will be located</param>
+    /// <returns>The offset of the clip's record within the table of contents</returns>
+    private: std::size_t getRecordOffset(std::size_t clipIndex) const;
+
+    /// <summary>Reads the location of a clip's encoded audio file</summary>
+    /// <param name="clipIndex">Index of the clip whose location will be read</param>
+    /// <param name="start">Receives the offset of the clip's file within the bank</param>
+    /// <param name="byteCount">Receives the size of the clip's file in bytes</param>
+    /// <param name="extension">Receives the file extension of the clip's file</param>
+    private: void readClipLocation(
+      std::size_t clipIndex,
+      std::uint64_t &start, std::uint64_t &byteCount,
+      std::string &extension
+    ) const;
+
+    /// <summary>Hands the stored seek index of a clip to its decoder</summary>
+    /// <param name="decoder">Decoder that will receive the seek index</param>
+    /// <param name="clipIndex">Index of the clip the decoder is accessing</param>
+    private: void loadSeekIndex(AudioTrackDecoder &decoder, std::size_t clipIndex) const;
+
+    /// <summary>File holding the sound bank, kept alive while its memory is being used</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Copy of the table of contents if the file couldn't lend out its memory</summary>
+    private: std::vector<std::byte> contents;
+    /// <summary>Memory holding the table of contents</summary>
+    private: const std::byte *data;
+    /// <summary>Length of the table of contents in bytes</summary>
+    private: std::size_t length;
+    /// <summary>Size of the whole sound bank file in bytes</summary>
+    private: std::uint64_t fileSize;
+    /// <summary>Number of slots in the bank's hash table</summary>
+    private: std::size_t slotCount;
+    /// <summary>Number of clips stored in the bank</summary>
+    private: std::size_t clipCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SOUNDBANK_H
@@ -0,0 +1,195 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_STREAMINGMANAGER_H
+#define NUCLEX_AUDIO_STORAGE_STREAMINGMANAGER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr, std::weak_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Executor;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+  class AudioTrackDecoder;
+  class BlockCache;
+  class HeadCache;
+  class StreamingThreadPool;
+  class StreamingTrackReader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Streams many voices at once from a shared pool of decoding threads</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Games stream dozens of music, ambience and dialogue voices at the same time.
+  ///     The manager hands out a <see cref="StreamingTrackReader" /> for each voice,
+  ///     all of them decoded ahead by one <see cref="StreamingThreadPool" /> that
+  ///     services the voice closest to running dry first.
+  ///   </para>
+  ///   <para>
+  ///     Voices opened by path read through a <see cref="BlockCache" /> owned by the
+  ///     manager, keyed by the path, so voices playing the same file (crossfades, layered
+  ///     ambience, overlapping one-shots) share their file reads instead of each going to
+  ///     the disk. The manager also collects statistics for tuning buffer sizes and
+  ///     thread counts. All methods are thread-safe.
+  ///   </para>
+  ///   <para>
+  ///     Optionally, a <see cref="HeadCache" /> lets voices of preloaded assets start
+  ///     playing immediately while their files are still being opened.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE StreamingManager {
+
+    /// <summary>Initializes a new streaming manager</summary>
+    /// <param name="loader">
+    ///   Audio loader used to open voices by path. It has to stay alive for as long
+    ///   as the streaming manager is used.
+    /// </param>
+    /// <param name="threadCount">Number of threads that will decode for the voices</param>
+    /// <param name="cacheMemoryLimit">
+    ///   Maximum number of bytes the cache shared by voices reading the same file may use
+    /// </param>
+    public: NUCLEX_AUDIO_API StreamingManager(
+      const AudioLoader &loader,
+      std::size_t threadCount = 1,
+      std::size_t cacheMemoryLimit = 8388608
+    );
+
+    /// <summary>Initializes a new streaming manager that decodes on an executor</summary>
+    /// <param name="loader">
+    ///   Audio loader used to open voices by path. It has to stay alive for as long
+    ///   as the streaming manager is used.
+    /// </param>
+    /// <param name="executor">Executor on which the voices will be decoded</param>
+    /// <param name="cacheMemoryLimit">
+    ///   Maximum number of bytes the cache shared by voices reading the same file may use
+    /// </param>
+    public: NUCLEX_AUDIO_API StreamingManager(
+      const AudioLoader &loader,
+      const std::shared_ptr<Executor> &executor,
+      std::size_t cacheMemoryLimit = 8388608
+    );
+
+    /// <summary>Frees all resources owned by the streaming manager</summary>
+    /// <remarks>
+    ///   Readers handed out by the manager keep its thread pool alive, so they continue
+    ///   to work after the manager has been destroyed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~StreamingManager();
+
+    /// <summary>Starts streaming a voice from an audio file</summary>
+    /// <param name="path">Path of the audio file that will be streamed</param>
+    /// <param name="bufferedFrameCount">Number of frames that will be decoded ahead</param>
+    /// <param name="startFrame">Frame from which streaming will begin</param>
+    /// <returns>A reader through which the voice's samples can be read</returns>
+    /// <remarks>
+    ///   The voice stops streaming when the last reference to the reader is dropped.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::shared_ptr<StreamingTrackReader> OpenVoice(
+      const std::string &path,
+      std::size_t bufferedFrameCount = 16384,
+      std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Starts streaming a voice from an existing decoder</summary>
+    /// <param name="decoder">Decoder that will be used exclusively by the voice</param>
+    /// <param name="bufferedFrameCount">Number of frames that will be decoded ahead</param>
+    /// <param name="startFrame">Frame from which streaming will begin</param>
+    /// <returns>A reader through which the voice's samples can be read</returns>
+    public: NUCLEX_AUDIO_API std::shared_ptr<StreamingTrackReader> AddVoice(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t bufferedFrameCount = 16384,
+      std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Lets voices of assets with cached heads start without waiting</summary>
+    /// <param name="headCache">Head cache that will be consulted, null to use none</param>
+    /// <remarks>
+    ///   Voices opened by path whose start frame lies within the asset's cached head
+    ///   deliver the head's samples right away and open their file on one of the
+    ///   decoding threads. If the file can't be opened, the voice ends after the head
+    ///   and reports the error through its reader. The audio loader then has to stay
+    ///   alive until all voices have been closed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void SetHeadCache(const std::shared_ptr<const HeadCache> &headCache);
+
+    /// <summary>Counts the voices that are currently streaming</summary>
+    /// <returns>The number of readers handed out that are still alive</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountVoices() const;
+
+    /// <summary>Counts the voices that are waiting for their buffers to be refilled</summary>
+    /// <returns>The depth of the decoding threads' work queue</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountQueuedRefills() const;
+
+    /// <summary>Counts how often any voice couldn't deliver the requested frames</summary>
+    /// <returns>The total number of underruns of all voices, including closed ones</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountUnderruns() const;
+
+    /// <summary>Counts the file reads that were shared between voices</summary>
+    /// <returns>The number of block reads that were served from the shared cache</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountCoalescedReads() const;
+
+    /// <summary>Counts the file reads that had to go to the disk</summary>
+    /// <returns>The number of block reads that missed the shared cache</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountFileReads() const;
+
+    /// <summary>Remembers a reader so that it can be counted as a voice</summary>
+    /// <param name="reader">Reader that has been handed out</param>
+    private: void trackVoice(const std::shared_ptr<StreamingTrackReader> &reader);
+
+    /// <summary>Audio loader used to open voices by path</summary>
+    private: const AudioLoader &loader;
+    /// <summary>Threads decoding ahead for all voices</summary>
+    private: std::shared_ptr<StreamingThreadPool> threadPool;
+    /// <summary>Cache through which voices reading the same file share their reads</summary>
+    private: std::shared_ptr<BlockCache> cache;
+    /// <summary>Head cache from which voices of preloaded assets start, if any</summary>
+    private: std::shared_ptr<const HeadCache> headCache;
+    /// <summary>Must be held while accessing the head cache</summary>
+    private: mutable std::mutex headCacheMutex;
+    /// <summary>Readers that have been handed out, expired ones are pruned lazily</summary>
+    private: std::vector<std::weak_ptr<StreamingTrackReader>> voices;
+    /// <summary>Must be held while accessing the list of voices</summary>
+    private: mutable std::mutex voicesMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_STREAMINGMANAGER_H
@@ -0,0 +1,167 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_STREAMINGTHREADPOOL_H
+#define NUCLEX_AUDIO_STORAGE_STREAMINGTHREADPOOL_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class StreamingTrackState;
+  class StreamingTrackReader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Threads that decode ahead for any number of streaming track readers</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each <see cref="StreamingTrackReader" /> registers itself with a thread pool.
+  ///     The pool's threads keep walking over all registered streams and decode a chunk
+  ///     into each stream whose ring buffer has room for one. A chunk is a quarter
+  ///     of the stream's ring buffer, so a single thread can keep hundreds of streams
+  ///     topped up as long as it decodes faster than the streams are played back.
+  ///   </para>
+  ///   <para>
+  ///     Streams are serviced by deadline: in each pass, the stream with the fewest
+  ///     decoded frames left to play, and thus the closest to running dry, goes first.
+  ///   </para>
+  ///   <para>
+  ///     When no stream needs any decoding, the threads sleep for a short interval.
+  ///     The readers never wake them up, so reading from a stream stays wait-free.
+  ///   </para>
+  ///   <para>
+  ///     Instead of using threads of its own, the pool can also run its passes as high
+  ///     priority tasks on an <see cref="Executor" />. That shares the cores with the
+  ///     library's other work, but streams will run dry if all of the executor's workers
+  ///     stay busy with long tasks, so the executor should have a worker to spare.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE StreamingThreadPool {
+
+    /// <summary>Streaming readers register themselves with the thread pool</summary>
+    friend class StreamingTrackReader;
+
+    /// <summary>Initializes a new thread pool for streaming readers</summary>
+    /// <param name="threadCount">Number of threads that will decode ahead</param>
+    public: NUCLEX_AUDIO_API StreamingThreadPool(std::size_t threadCount = 1);
+
+    /// <summary>Initializes a new thread pool that decodes on an executor</summary>
+    /// <param name="executor">Executor on which the streams will be decoded</param>
+    /// <remarks>
+    ///   A single, mostly sleeping thread is kept to submit a pass whenever the previous
+    ///   one has finished. When a pass found nothing to decode, the next one is
+    ///   submitted after the idle interval.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API StreamingThreadPool(const std::shared_ptr<Executor> &executor);
+
+    /// <summary>Stops all threads and frees all resources</summary>
+    /// <remarks>
+    ///   Streaming readers keep their thread pool alive, so this only happens once
+    ///   all readers using the pool have been destroyed.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API ~StreamingThreadPool();
+
+    /// <summary>Counts the threads that are decoding for the streams</summary>
+    /// <returns>The number of threads in the thread pool</returns>
+    /// <remarks>
+    ///   If the pool decodes on an executor, only one pass runs at a time, so this is 1.
+    /// </remarks>
+    public: std::size_t CountThreads() const { return this->threads.size(); }
+
+    /// <summary>Counts the streams that are currently registered with the pool</summary>
+    /// <returns>The number of streams the thread pool is servicing</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountStreams() const;
+
+    /// <summary>Counts the streams that were waiting for a chunk in the latest pass</summary>
+    /// <returns>The number of streams whose ring buffers had room for another chunk</returns>
+    /// <remarks>
+    ///   This is the depth of the pool's work queue. If it stays high, the threads are
+    ///   not keeping up and streams are about to run dry.
+    /// </remarks>
+    public: std::size_t CountPendingStreams() const {
+      return this->pendingStreamCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts how often any stream of the pool couldn't deliver enough frames</summary>
+    /// <returns>The total number of underruns, including those of closed streams</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountUnderruns() const;
+
+    /// <summary>Adds a stream that the pool's threads will decode ahead for</summary>
+    /// <param name="stream">Stream that will be serviced by the pool</param>
+    private: void addStream(const std::shared_ptr<StreamingTrackState> &stream);
+
+    /// <summary>Services the registered streams until the pool is destroyed</summary>
+    private: void serviceStreams();
+
+    /// <summary>Submits passes to the executor until the pool is destroyed</summary>
+    private: void submitPasses();
+
+    /// <summary>Decodes one chunk into each stream that has room for one</summary>
+    /// <param name="snapshot">Scratch list that receives a copy of the streams</param>
+    /// <param name="queue">Scratch list of the streams that need decoding</param>
+    /// <returns>True if any stream was decoded into, false if none needed it</returns>
+    private: bool servicePass(
+      std::vector<std::shared_ptr<StreamingTrackState>> &snapshot,
+      std::vector<std::pair<std::size_t, StreamingTrackState *>> &queue
+    );
+
+    /// <summary>Executor the passes are run on, null if the pool has own threads</summary>
+    private: std::shared_ptr<Executor> executor;
+    /// <summary>Threads that decode ahead or, with an executor, submit the passes</summary>
+    private: std::vector<std::thread> threads;
+    /// <summary>Streams that are registered with the thread pool</summary>
+    private: std::vector<std::shared_ptr<StreamingTrackState>> streams;
+    /// <summary>Must be held while accessing the list of streams</summary>
+    private: mutable std::mutex streamsMutex;
+    /// <summary>Wakes sleeping threads up when a stream is added or the pool stops</summary>
+    private: std::condition_variable wakeCondition;
+    /// <summary>Underruns of streams that have been dropped from the list</summary>
+    private: std::uint64_t droppedUnderrunCount;
+    /// <summary>Number of streams that were waiting for a chunk in the latest pass</summary>
+    private: std::atomic<std::size_t> pendingStreamCount;
+    /// <summary>Set when the threads should shut down</summary>
+    private: std::atomic<bool> stopping;
+    /// <summary>Signaled when a pass submitted to the executor has finished</summary>
+    private: std::condition_variable passFinishedCondition;
+    /// <summary>Whether a pass submitted to the executor is running or queued</summary>
+    private: bool isPassPending;
+    /// <summary>Whether the latest pass submitted to the executor decoded anything</summary>
+    private: bool didPassDecode;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_STREAMINGTHREADPOOL_H
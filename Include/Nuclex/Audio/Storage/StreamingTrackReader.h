@@ -0,0 +1,165 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_STREAMINGTRACKREADER_H
+#define NUCLEX_AUDIO_STORAGE_STREAMINGTRACKREADER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <functional> // for std::function
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+  class StreamingThreadPool;
+  class StreamingTrackState;
+  struct CachedHead;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Streams an audio track that is decoded ahead on a shared thread pool</summary>
+  /// <remarks>
+  ///   <para>
+  ///     For playback, audio is consumed sequentially and in small pieces, but decoding
+  ///     in the audio thread risks dropouts. This reader owns a decoder and a ring buffer
+  ///     that the threads of a <see cref="StreamingThreadPool" /> keep filling. The ring
+  ///     buffer's size is the latency target: the larger it is, the longer the stream can
+  ///     keep playing when the pool's threads fall behind.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="Read" /> is wait-free. It copies whatever has been decoded so far and
+  ///     returns how many frames it delivered. Only one thread may read from a stream.
+  ///     Samples are delivered as interleaved floats.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE StreamingTrackReader {
+
+    /// <summary>Initializes a new streaming reader for the specified decoder</summary>
+    /// <param name="decoder">Decoder that will be used to decode ahead</param>
+    /// <param name="threadPool">Thread pool that will run the decoder</param>
+    /// <param name="bufferedFrameCount">
+    ///   Number of frames that will be decoded ahead. At 48 KHz, the default keeps
+    ///   about a third of a second buffered.
+    /// </param>
+    /// <param name="startFrame">Frame from which streaming will begin</param>
+    /// <remarks>
+    ///   The decoder is used exclusively by the stream from now on, so if you want to
+    ///   keep using it elsewhere, hand a <see cref="AudioTrackDecoder.Clone" /> of it
+    ///   to the streaming reader instead.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API StreamingTrackReader(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::shared_ptr<StreamingThreadPool> &threadPool,
+      std::size_t bufferedFrameCount = 16384,
+      std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Initializes a new streaming reader that starts from a cached head</summary>
+    /// <param name="head">Decoded beginning of the track, see <see cref="HeadCache" /></param>
+    /// <param name="openDecoder">
+    ///   Opens the decoder that will continue after the head. It is called once on one of
+    ///   the thread pool's threads and any exception it throws stops the stream at the
+    ///   end of the head, to be reported by <see cref="RethrowPotentialException" />.
+    /// </param>
+    /// <param name="threadPool">Thread pool that will run the decoder</param>
+    /// <param name="bufferedFrameCount">Number of frames that will be decoded ahead</param>
+    /// <param name="startFrame">
+    ///   Frame from which streaming will begin, must lie within the cached head
+    /// </param>
+    /// <remarks>
+    ///   The reader can deliver the head's frames immediately, without waiting for
+    ///   the file to be opened. Reading continues seamlessly with the frames decoded
+    ///   from the end of the head onwards.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API StreamingTrackReader(
+      const std::shared_ptr<const CachedHead> &head,
+      const std::function<std::shared_ptr<AudioTrackDecoder>()> &openDecoder,
+      const std::shared_ptr<StreamingThreadPool> &threadPool,
+      std::size_t bufferedFrameCount = 16384,
+      std::uint64_t startFrame = 0
+    );
+
+    /// <summary>Stops streaming and frees all resources</summary>
+    public: NUCLEX_AUDIO_API ~StreamingTrackReader();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountChannels() const;
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountFrames() const;
+
+    /// <summary>Returns the number of frames the stream decodes ahead</summary>
+    /// <returns>The capacity of the stream's ring buffer in frames</returns>
+    public: NUCLEX_AUDIO_API std::size_t GetBufferedFrameCount() const;
+
+    /// <summary>Counts the frames that can be read right now</summary>
+    /// <returns>The number of frames that have been decoded but not read yet</returns>
+    public: NUCLEX_AUDIO_API std::size_t CountReadableFrames() const;
+
+    /// <summary>Returns the index of the frame that will be read next</summary>
+    /// <returns>The index of the next frame that will be delivered</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t GetReadPosition() const;
+
+    /// <summary>Whether all frames of the audio track have been read</summary>
+    /// <returns>True if the end of the audio track has been reached</returns>
+    public: NUCLEX_AUDIO_API bool IsAtEnd() const;
+
+    /// <summary>Counts how often a read couldn't deliver the requested frames</summary>
+    /// <returns>The number of reads that came up short before the end of the track</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountUnderruns() const;
+
+    /// <summary>Reads decoded audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of frames that will be read</param>
+    /// <returns>
+    ///   The number of frames that have actually been read. If this is less than
+    ///   requested, the thread pool is falling behind (or the end has been reached).
+    /// </returns>
+    /// <remarks>
+    ///   This method is wait-free, it never takes a lock, never allocates memory
+    ///   and never looks at the file.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::size_t Read(float *buffer, std::size_t frameCount);
+
+    /// <summary>Rethrows the error that stopped decoding, if any</summary>
+    /// <remarks>
+    ///   If the decoder throws an exception, the stream simply stops delivering audio.
+    ///   Call this from a non-real-time thread to find out what went wrong.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void RethrowPotentialException() const;
+
+    /// <summary>Thread pool that is decoding ahead for this stream</summary>
+    private: std::shared_ptr<StreamingThreadPool> threadPool;
+    /// <summary>Ring buffer and decoder shared with the thread pool</summary>
+    private: std::shared_ptr<StreamingTrackState> state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_STREAMINGTRACKREADER_H
@@ -21,11 +21,15 @@ limitations under the License.
 #define NUCLEX_AUDIO_STORAGE_VIRTUALFILE_H
 
 #include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/FileAccessPattern.h"
+#include "Nuclex/Audio/Storage/ReadRequest.h"
+#include "Nuclex/Audio/Storage/RemoteReadPolicy.h"
 
 #include <cstddef> // for std::byte
 #include <cstdint> // for std::uint64_t
 #include <string> // for std::string
 #include <memory> // for std::unique_ptr
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -56,6 +60,9 @@ namespace Nuclex { namespace Audio { namespace Storage {
     /// <param name="promiseSequentialAccess">
     ///   Whether you promise to read from the file sequentially only
     /// </param>
+    /// <param name="useMemoryMapping">
+    ///   Whether to map the file into memory instead of issuing a system call per read
+    /// </param>
     /// <returns>The file at the specified path, opened in read-only mode</returns>
     /// <remarks>
     ///   <para>
@@ -63,6 +70,12 @@ namespace Nuclex { namespace Audio { namespace Storage {
     ///     provided by the current OS.
     ///   </para>
     ///   <para>
+    ///     Memory mapping turns each read into a plain memory copy and is recommended
+    ///     when many small files are loaded. If the file cannot be mapped (because it is
+    ///     empty, a pipe or the platform doesn't support it), normal file access is used.
+    ///     Do not use memory mapping on files that may be truncated while you read them.
+    ///   </para>
+    ///   <para>
     ///     The returned file is *not* thread-safe. This means if
     ///     <see cref="VirtualFile.ReadAt" /> and <see cref="VirtualFile.WriteAt" />
     ///     calls happen from different threads, mixed-up data, spurious exceptions and
@@ -71,7 +84,30 @@ namespace Nuclex { namespace Audio { namespace Storage {
     ///   </para>
     /// </remarks>
     public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> OpenRealFileForReading(
-      const std::string &path, bool promiseSequentialAccess = false
+      const std::string &path,
+      bool promiseSequentialAccess = false,
+      bool useMemoryMapping = false
+    );
+
+    /// <summary>Opens a real file stored in the OS' file system for reading</summary>
+    /// <param name="path">
+    ///   Path of the file that will be opened for reading as UTF-8 string
+    /// </param>
+    /// <param name="accessPattern">
+    ///   How the file will be accessed, passed to the OS as a caching hint
+    /// </param>
+    /// <param name="useMemoryMapping">
+    ///   Whether to map the file into memory instead of issuing a system call per read
+    /// </param>
+    /// <returns>The file at the specified path, opened in read-only mode</returns>
+    /// <remarks>
+    ///   Works just like the other overload, but also lets you announce random access
+    ///   which makes the OS hold back on reading ahead for seek-heavy decoders.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> OpenRealFileForReading(
+      const std::string &path,
+      FileAccessPattern accessPattern,
+      bool useMemoryMapping = false
     );
 
     /// <summary>Opens a real file stored in the OS' file system for writing</summary>
@@ -95,11 +131,150 @@ namespace Nuclex { namespace Audio { namespace Storage {
     ///     all kinds of wrong behavior will ensue. If you want to access the same file
     ///     from multiple threads, each should call this method to get its own instance.
     ///   </para>
+    ///   <para>
+    ///     Writes are collected in a write-behind buffer and passed to the OS in large
+    ///     blocks. Call <see cref="VirtualFile.Flush" /> when you're done writing -
+    ///     the buffer is also flushed when the file is destroyed, but errors that happen
+    ///     at that point can no longer be reported.
+    ///   </para>
     /// </remarks>
     public: NUCLEX_AUDIO_API static std::shared_ptr<VirtualFile> OpenRealFileForWriting(
       const std::string &path, bool promiseSequentialAccess = false
     );
 
+    /// <summary>Creates or opens a file in the OS' file system for writing</summary>
+    /// <param name="path">
+    ///   Path of the file that will be opened for writing as UTF-8 string
+    /// </param>
+    /// <param name="accessPattern">
+    ///   How the file will be accessed, passed to the OS as a caching hint
+    /// </param>
+    /// <param name="expectedByteCount">
+    ///   Size the file is expected to reach, 0 if unknown
+    /// </param>
+    /// <returns>The file at the specified path, opened in write-only mode</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Works just like the other overload, but also lets you pick
+    ///     <see cref="FileAccessPattern.Unbuffered" /> for transcoder output that should
+    ///     not push everything else out of the OS file cache. Unbuffered files collect
+    ///     writes in their own aligned blocks and are not wrapped in a write-behind buffer.
+    ///   </para>
+    ///   <para>
+    ///     If an expected size is provided, the disk space is reserved up front
+    ///     (fallocate() on Linux, the allocation size on Windows) without changing
+    ///     the file's length. When many files are written at once, this keeps each file
+    ///     in few large extents which makes reading them back later faster. Space that
+    ///     ends up not being used is released by <see cref="VirtualFile.Flush" /> and
+    ///     when the file is closed. The estimate doesn't have to be exact, but guessing
+    ///     far too high temporarily takes away disk space from other files.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<VirtualFile> OpenRealFileForWriting(
+      const std::string &path,
+      FileAccessPattern accessPattern,
+      std::uint64_t expectedByteCount = 0
+    );
+
+    /// <summary>Wraps a file so that small reads are served from a read-ahead buffer</summary>
+    /// <param name="file">File whose reads will be buffered</param>
+    /// <param name="blockSize">Size of the blocks in which the file will be read</param>
+    /// <param name="readAheadBlockCount">
+    ///   Number of additional blocks that will be read beyond the block a read falls into
+    /// </param>
+    /// <returns>A read-only file that buffers reads from the specified file</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Codec libraries tend to issue many small reads. If your virtual file goes
+    ///     through a network share, an archive or another medium where individual reads
+    ///     are expensive, wrapping it with this buffer turns these into a few large reads.
+    ///   </para>
+    ///   <para>
+    ///     The buffer caches only a single window of the file, so if you create
+    ///     several decoders for the same file, give each its own buffer.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> WrapInReadAheadBuffer(
+      const std::shared_ptr<const VirtualFile> &file,
+      std::size_t blockSize = 16384,
+      std::size_t readAheadBlockCount = 3
+    );
+
+    /// <summary>Wraps a file on high-latency storage to hedge, retry and read ahead</summary>
+    /// <param name="file">File whose reads will be made resilient</param>
+    /// <param name="policy">When to hedge and retry reads and how far to read ahead</param>
+    /// <returns>A read-only file that reads from the specified file</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Meant for files served by object storage or other backends where a read
+    ///     occasionally takes seconds. Codec libraries read synchronously, so without
+    ///     this, a single slow request stalls the decoder (and possibly playback).
+    ///     Slow reads are issued a second time on the installed <see cref="Executor" />,
+    ///     failed reads are retried and misses are fetched in chunks sized after the
+    ///     observed latency and bandwidth. See <see cref="RemoteReadPolicy" />.
+    ///   </para>
+    ///   <para>
+    ///     The wrapped file must allow concurrent reads, since a hedged read can run
+    ///     while the original is still in progress. To share reads between decoders,
+    ///     put a <see cref="BlockCache" /> on top of the returned file.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> WrapForRemoteAccess(
+      const std::shared_ptr<const VirtualFile> &file,
+      const RemoteReadPolicy &policy = RemoteReadPolicy()
+    );
+
+    /// <summary>Wraps a file so that small writes are collected into large blocks</summary>
+    /// <param name="file">File whose writes will be buffered</param>
+    /// <param name="bufferSize">Size of the blocks in which the file will be written</param>
+    /// <returns>A file that buffers writes to the specified file</returns>
+    /// <remarks>
+    ///   Writes that continue where the previous write ended (or that overwrite data still
+    ///   in the buffer) are merged. Any other write flushes the buffer first.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<VirtualFile> WrapInWriteBuffer(
+      const std::shared_ptr<VirtualFile> &file, std::size_t bufferSize = 65536
+    );
+
+    /// <summary>Provides read-only access to an immutable buffer in memory</summary>
+    /// <param name="memory">Buffer holding the file's contents</param>
+    /// <param name="length">Length of the buffer in bytes</param>
+    /// <returns>A read-only file that serves the contents of the buffer</returns>
+    /// <remarks>
+    ///   The buffer is not copied, the file only shares ownership of it. Reads never
+    ///   allocate and <see cref="TryBorrowAt" /> hands out the buffer directly, so
+    ///   decoders can work on preloaded sound banks without going through any I/O layer.
+    ///   The buffer must not be modified while the file (or a decoder using it) exists.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> FromMemory(
+      const std::shared_ptr<const std::byte[]> &memory, std::size_t length
+    );
+
+    /// <summary>Exposes a range of bytes within another file as a file of its own</summary>
+    /// <param name="file">File a range of which will be exposed</param>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="length">Length of the range in bytes</param>
+    /// <returns>A read-only file that provides access to the specified range</returns>
+    /// <remarks>
+    ///   This lets you decode audio files stored inside archives or sound banks
+    ///   without copying them out first. Nothing is copied, reads are simply offset
+    ///   and passed on to the wrapped file (and so is zero-copy borrowing).
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> CreateSubRangeView(
+      const std::shared_ptr<const VirtualFile> &file, std::uint64_t start, std::uint64_t length
+    );
+
+    /// <summary>Splices several files together so they appear as a single file</summary>
+    /// <param name="parts">Files that will be spliced together, in order</param>
+    /// <returns>A read-only file that provides access to all parts in sequence</returns>
+    /// <remarks>
+    ///   The sizes of the parts are queried once when the view is created. Reads that
+    ///   cross the boundary between two parts are split and passed on to both parts.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::shared_ptr<const VirtualFile> CreateConcatenatedView(
+      const std::vector<std::shared_ptr<const VirtualFile>> &parts
+    );
+
     /// <summary>Frees all memory used by the instance</summary>
     public: NUCLEX_AUDIO_API virtual ~VirtualFile() = default;
 
@@ -121,6 +296,75 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::uint64_t start, std::size_t byteCount, std::byte *buffer
     ) const = 0;
 
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    /// <remarks>
+    ///   <para>
+    ///     The default implementation simply performs the reads one after another.
+    ///     Files backed by an OS file may submit all reads to the kernel at once
+    ///     (via io_uring on Linux), letting the storage device work on them in parallel
+    ///     and saving the per-read system call overhead.
+    ///   </para>
+    ///   <para>
+    ///     The method returns when all reads have completed. If any read fails,
+    ///     an exception is thrown and the contents of all buffers are undefined.
+    ///   </para>
+    /// </remarks>
+    public: virtual void ReadManyAt(
+      const ReadRequest *requests, std::size_t requestCount
+    ) const {
+      for(std::size_t index = 0; index < requestCount; ++index) {
+        const ReadRequest &request = requests[index];
+        this->ReadAt(request.Start, request.ByteCount, request.Buffer);
+      }
+    }
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    /// <remarks>
+    ///   <para>
+    ///     Decoders can call this ahead of a seek or while they are busy converting
+    ///     one chunk of data, so the OS can start fetching the next chunk in
+    ///     the background. This is purely a hint - it never blocks, never fails and
+    ///     implementations that can't make use of it simply ignore it.
+    ///   </para>
+    /// </remarks>
+    public: virtual void Prefetch(std::uint64_t start, std::size_t byteCount) const {
+      (void)start;
+      (void)byteCount;
+    }
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the file contents at the requested offset or a null pointer if
+    ///   the file cannot provide the requested range as contiguous memory
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Files that keep their contents in memory (such as memory-mapped files) can
+    ///     hand out their memory directly, allowing readers to process the data without
+    ///     allocating an intermediate buffer and copying the data into it. All other
+    ///     implementations simply return a null pointer and callers are expected to
+    ///     fall back to <see cref="ReadAt" /> in that case.
+    ///   </para>
+    ///   <para>
+    ///     The returned memory remains valid for as long as the file instance exists.
+    ///     A null pointer is also returned if the range exceeds the file's size, so
+    ///     the fallback to <see cref="ReadAt" /> generates the appropriate error.
+    ///   </para>
+    /// </remarks>
+    public: virtual const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const {
+      (void)start;
+      (void)byteCount;
+      return nullptr;
+    }
+
     /// <summary>Writes data into the file</summary>
     /// <param name="start">Offset at which writing will begin in the file</param>
     /// <param name="byteCount">Number of bytes that should be written</param>
@@ -134,6 +378,14 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::uint64_t start, std::size_t byteCount, const std::byte *buffer
     ) = 0;
 
+    /// <summary>Writes any data that is being held in buffers to the file</summary>
+    /// <remarks>
+    ///   Files that write directly to their storage don't need to do anything here.
+    ///   This does not force the OS to write its caches to disk (like fsync() would),
+    ///   it only makes sure the data has been handed to the OS.
+    /// </remarks>
+    public: virtual void Flush() {}
+
   };
 
   // ------------------------------------------------------------------------------------------- //
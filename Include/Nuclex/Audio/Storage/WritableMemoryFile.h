@@ -0,0 +1,139 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WRITABLEMEMORYFILE_H
+#define NUCLEX_AUDIO_STORAGE_WRITABLEMEMORYFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <memory> // for std::unique_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects written data in a growing buffer in memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Use this as the target of an encoder to produce an audio file in memory, for
+  ///     example to place it in a sound bank afterwards. The buffer grows geometrically,
+  ///     so an encoder appending small pages causes only a handful of reallocations.
+  ///     If the rough size of the result is known, reserving it up front (see
+  ///     <see cref="EstimateByteCount" />) avoids reallocations altogether.
+  ///   </para>
+  ///   <para>
+  ///     When done, <see cref="TakeContents" /> hands the buffer over to the caller
+  ///     without copying it. Like the other files, this one is not thread-safe.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE WritableMemoryFile : public VirtualFile {
+
+    /// <summary>Estimates the size of an encoded file from its bitrate and duration</summary>
+    /// <param name="bitsPerSecond">Average bitrate of the encoded audio</param>
+    /// <param name="seconds">Playback duration of the encoded audio in seconds</param>
+    /// <returns>A capacity that will usually hold the whole encoded file</returns>
+    /// <remarks>
+    ///   The estimate adds some headroom for headers and for the bitrate of variable
+    ///   bitrate codecs straying above the average.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static std::size_t EstimateByteCount(
+      std::size_t bitsPerSecond, double seconds
+    );
+
+    /// <summary>Initializes a new, empty memory file</summary>
+    /// <param name="capacity">Number of bytes to reserve up front</param>
+    public: NUCLEX_AUDIO_API explicit WritableMemoryFile(std::size_t capacity = 0);
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: NUCLEX_AUDIO_API ~WritableMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Returns the number of bytes the file can hold before it reallocates</summary>
+    /// <returns>The capacity of the file's buffer in bytes</returns>
+    public: std::size_t GetCapacity() const { return this->capacity; }
+
+    /// <summary>Makes sure the file can grow to the specified size without reallocating</summary>
+    /// <param name="byteCount">Number of bytes the buffer should be able to hold</param>
+    public: NUCLEX_AUDIO_API void Reserve(std::size_t byteCount);
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: NUCLEX_AUDIO_API void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Provides direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer into the buffer at the requested offset or a null pointer if
+    ///   the requested range exceeds the file's size
+    /// </returns>
+    /// <remarks>
+    ///   The pointer becomes invalid when the file is written to and has to grow.
+    /// </remarks>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+        return nullptr;
+      }
+      return this->memory.get() + start;
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Writing beyond the end of the file fills the gap with zero bytes.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Hands the file's buffer over to the caller</summary>
+    /// <param name="length">Receives the number of bytes in the buffer</param>
+    /// <returns>The buffer holding the contents of the file</returns>
+    /// <remarks>
+    ///   The buffer is not copied or shrunk, so it may be larger than the file's length.
+    ///   Afterwards, the file is empty again.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API std::unique_ptr<std::byte[]> TakeContents(std::size_t &length);
+
+    /// <summary>Buffer holding the file's contents</summary>
+    private: std::unique_ptr<std::byte[]> memory;
+    /// <summary>Number of bytes the buffer can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Number of bytes that have been written to the file</summary>
+    private: std::size_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_WRITABLEMEMORYFILE_H
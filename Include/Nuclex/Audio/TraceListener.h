@@ -0,0 +1,110 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_TRACELISTENER_H
+#define NUCLEX_AUDIO_TRACELISTENER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uintptr_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives zones and markers from the library for display in a profiler</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant to be the glue to a frame profiler such as Tracy or Perfetto. The library
+  ///     opens a zone around each decoding call, seek, file read, bulk sample conversion
+  ///     and encoder write, so when audio hitches, the profiler shows whether the time
+  ///     went into I/O, the codec or converting samples.
+  ///   </para>
+  ///   <para>
+  ///     Zone and marker names are string literals, so they can be passed on to profilers
+  ///     that only store the pointer. The file and track ids are the addresses of the
+  ///     virtual file and of the decoder or encoder involved, or zero where there is none.
+  ///     They are only useful to tell files and tracks apart.
+  ///   </para>
+  ///   <para>
+  ///     Tracing is compiled out unless the library was built with the WANT_TRACING
+  ///     option. Without it, <see cref="IsSupported" /> returns false and installed
+  ///     listeners are never called.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE TraceListener {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_AUDIO_API virtual ~TraceListener() = default;
+
+    /// <summary>Checks whether the library was built with tracing support</summary>
+    /// <returns>True if installed listeners will be called</returns>
+    public: NUCLEX_AUDIO_API static bool IsSupported();
+
+    /// <summary>Installs the listener that will receive all zones and markers</summary>
+    /// <param name="listener">Listener that will be installed, null to uninstall</param>
+    /// <remarks>
+    ///   The library does not take ownership of the listener. Zones that are open when
+    ///   the listener is replaced still end on the listener they began on, so it has to
+    ///   stay alive until any decoding, reading or encoding in progress has finished.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API static void Install(TraceListener *listener);
+
+    /// <summary>Retrieves the listener that is currently installed</summary>
+    /// <returns>The installed listener or null if none is installed</returns>
+    public: NUCLEX_AUDIO_API static TraceListener *GetInstalled();
+
+    /// <summary>Called when the library begins a zone of work</summary>
+    /// <param name="name">Static name describing the kind of work</param>
+    /// <param name="fileId">Id of the file the work concerns, zero if none</param>
+    /// <param name="trackId">Id of the decoder or encoder doing the work, zero if none</param>
+    /// <remarks>
+    ///   Called on the thread doing the work. Zones on a thread always end in the
+    ///   reverse order they began. The listener must not throw and should return quickly.
+    /// </remarks>
+    public: virtual void BeginZone(
+      const char *name, std::uintptr_t fileId, std::uintptr_t trackId
+    ) = 0;
+
+    /// <summary>Called when the library has finished a zone of work</summary>
+    /// <param name="name">Static name the zone was begun with</param>
+    /// <param name="fileId">Id of the file the work concerned, zero if none</param>
+    /// <param name="trackId">Id of the decoder or encoder that did the work, zero if none</param>
+    /// <remarks>
+    ///   This is called even if the work ended with an exception.
+    /// </remarks>
+    public: virtual void EndZone(
+      const char *name, std::uintptr_t fileId, std::uintptr_t trackId
+    ) = 0;
+
+    /// <summary>Called when something noteworthy happened that took no time itself</summary>
+    /// <param name="name">Static name describing the event</param>
+    /// <param name="fileId">Id of the file the event concerns, zero if none</param>
+    /// <param name="trackId">Id of the decoder or encoder involved, zero if none</param>
+    public: virtual void Mark(
+      const char *name, std::uintptr_t fileId, std::uintptr_t trackId
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_TRACELISTENER_H
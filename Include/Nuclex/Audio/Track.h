@@ -21,9 +21,15 @@ limitations under the License.
 #define NUCLEX_AUDIO_TRACK_H
 
 #include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Channel.h"
+#include "Nuclex/Audio/SampleLayout.h"
 
 #include <optional>
 #include <string>
+#include <memory> // for std::shared_ptr
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio {
 
@@ -128,6 +134,165 @@ namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Audio track that holds all of its samples in memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All samples live in a single block of memory obtained from the global
+  ///     <see cref="SampleAllocator" />, so the track is aligned to 64 bytes and costs
+  ///     exactly one allocation regardless of its number of channels. With separated
+  ///     channels, each channel begins on a 64 byte boundary as well.
+  ///   </para>
+  ///   <para>
+  ///     Tracks are usually created by loading an audio file via the audio loader, which
+  ///     decodes straight into the track's memory. The channels returned by
+  ///     <see cref="GetChannel" /> look directly at that memory, too.
+  ///   </para>
+  ///   <para>
+  ///     The memory is reference-counted and copied on write: <see cref="Clone" /> hands
+  ///     out another track looking at the same samples without copying anything, and
+  ///     only the first non-const access to the samples of a track that still shares its
+  ///     memory gives that track a private copy. Read-only access never copies.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE Track : public TrackBase {
+
+    /// <summary>Initializes a new audio track without any samples</summary>
+    public: NUCLEX_AUDIO_API Track();
+
+    /// <summary>Initializes a new audio track with memory for the specified samples</summary>
+    /// <param name="channelCount">Number of audio channels in the track</param>
+    /// <param name="frameCount">Number of samples each channel will hold</param>
+    /// <param name="sampleRate">Number of frames played back per second</param>
+    /// <param name="layout">How the samples of the channels will be arranged</param>
+    /// <param name="channelOrder">
+    ///   Placement of each channel. If empty, all channels will be unplaced.
+    /// </param>
+    /// <remarks>
+    ///   The samples are not initialized, the track is meant to be filled afterwards.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API Track(
+      std::size_t channelCount,
+      std::uint64_t frameCount,
+      std::size_t sampleRate,
+      SampleLayout layout = SampleLayout::Interleaved,
+      const std::vector<ChannelPlacement> &channelOrder = std::vector<ChannelPlacement>()
+    );
+
+    /// <summary>Takes over the samples of another audio track</summary>
+    /// <param name="other">Audio track whose samples will be taken over</param>
+    public: NUCLEX_AUDIO_API Track(Track &&other) noexcept;
+
+    /// <summary>Frees the memory holding the track's samples</summary>
+    public: NUCLEX_AUDIO_API ~Track();
+
+    /// <summary>Takes over the samples of another audio track</summary>
+    /// <param name="other">Audio track whose samples will be taken over</param>
+    /// <returns>This audio track</returns>
+    public: NUCLEX_AUDIO_API Track &operator =(Track &&other) noexcept;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels the track contains</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Counts the number of frames in the track</summary>
+    /// <returns>The number of samples each channel of the track holds</returns>
+    public: std::size_t CountFrames() const { return this->frameCount; }
+
+    /// <summary>Retrieves the rate at which the track's frames are played back</summary>
+    /// <returns>The number of frames played back per second</returns>
+    public: std::size_t GetSampleRate() const { return this->sampleRate; }
+
+    /// <summary>Retrieves how the samples of the channels are arranged in memory</summary>
+    /// <returns>The arrangement of samples in the track's memory</returns>
+    public: SampleLayout GetLayout() const { return this->layout; }
+
+    /// <summary>Retrieves the placement of each channel in the track</summary>
+    /// <returns>A list with the placement of each channel, in channel order</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the address at which the track's samples begin</summary>
+    /// <returns>The address of memory holding all of the track's samples</returns>
+    /// <remarks>
+    ///   With interleaved samples, this can be handed directly to audio APIs. With
+    ///   separated samples, each channel begins <see cref="GetChannelSpacing" /> samples
+    ///   after the previous one. If the track's memory is shared with a clone, this
+    ///   makes a private copy first.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API float *GetSamples();
+
+    /// <summary>Returns the address at which the track's samples begin</summary>
+    /// <returns>The address of memory holding all of the track's samples</returns>
+    public: const float *GetSamples() const { return this->samples; }
+
+    /// <summary>Retrieves the distance between the beginnings of two channels</summary>
+    /// <returns>The number of samples from the first sample of a channel to the next</returns>
+    /// <remarks>
+    ///   This is 1 for interleaved tracks. For separated tracks, it is the frame count
+    ///   rounded up so that each channel begins on a 64 byte boundary.
+    /// </remarks>
+    public: std::size_t GetChannelSpacing() const { return this->channelSpacing; }
+
+    /// <summary>Provides access to the samples of one channel</summary>
+    /// <param name="channelIndex">Index of the channel that will be accessed</param>
+    /// <returns>A channel looking at the samples within the track's memory</returns>
+    /// <remarks>
+    ///   If the track's memory is shared with a clone, this makes a private copy first.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API Channel<float> GetChannel(std::size_t channelIndex);
+
+    /// <summary>Provides read-only access to the samples of one channel</summary>
+    /// <param name="channelIndex">Index of the channel that will be accessed</param>
+    /// <returns>A channel looking at the samples within the track's memory</returns>
+    public: NUCLEX_AUDIO_API Channel<const float> GetChannel(std::size_t channelIndex) const;
+
+    /// <summary>Creates another track that shares this track's samples</summary>
+    /// <returns>A track with the same properties looking at the same samples</returns>
+    /// <remarks>
+    ///   No samples are copied. Whichever of the tracks is modified first through
+    ///   <see cref="GetSamples" /> or <see cref="GetChannel" /> receives its own copy.
+    ///   Clones can be used from different threads, but each individual track is still
+    ///   only safe to use from one thread at a time.
+    /// </remarks>
+    public: NUCLEX_AUDIO_API Track Clone() const;
+
+    /// <summary>Checks whether the track's samples are shared with a clone</summary>
+    /// <returns>True if another track is looking at the same samples</returns>
+    public: NUCLEX_AUDIO_API bool IsShared() const;
+
+    /// <summary>Audio tracks can be large and are not meant to be copied by accident</summary>
+    private: Track(const Track &other) = delete;
+    /// <summary>Audio tracks can be large and are not meant to be copied by accident</summary>
+    private: Track &operator =(const Track &other) = delete;
+
+    /// <summary>Gives the track a private copy of its samples if they are shared</summary>
+    private: void makeSamplesUnique();
+
+    /// <summary>Reference-counted block of memory holding a track's samples</summary>
+    private: struct SampleStorage;
+
+    /// <summary>Number of audio channels in the track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of samples each channel holds</summary>
+    private: std::size_t frameCount;
+    /// <summary>Number of frames played back per second</summary>
+    private: std::size_t sampleRate;
+    /// <summary>How the samples of the channels are arranged in memory</summary>
+    private: SampleLayout layout;
+    /// <summary>Placement of each channel in the track</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Number of samples from the beginning of one channel to the next</summary>
+    private: std::size_t channelSpacing;
+    /// <summary>Memory holding the samples, possibly shared with clones</summary>
+    private: std::shared_ptr<SampleStorage> storage;
+    /// <summary>Address of the first sample within the storage</summary>
+    private: float *samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Audio
 
 #endif // NUCLEX_AUDIO_TRACK_H
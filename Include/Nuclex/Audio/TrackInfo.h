@@ -25,14 +25,87 @@ limitations under the License.
 #include "Nuclex/Audio/ChannelPlacement.h"
 
 #include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
 #include <optional> // for std::optional
 #include <string> // for std::string
+#include <vector> // for std::vector
+#include <utility> // for std::pair
+#include <algorithm> // for std::lower_bound()
 #include <chrono> // for std::chrono::microseconds
 
 namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Section of an audio track that repeats for seamless looping</summary>
+  /// <remarks>
+  ///   Frame indices are in the track as delivered by its decoder, so they already
+  ///   account for any encoder delay the decoder trims away.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE LoopRegion {
+
+    /// <summary>Index of the first frame that is part of the loop</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Index one past the last frame that is part of the loop</summary>
+    public: std::uint64_t EndFrame;
+    /// <summary>How often the loop plays in total, 0 to repeat it indefinitely</summary>
+    public: std::size_t PlayCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Labeled position or region inside an audio track</summary>
+  /// <remarks>
+  ///   Sound editors let users place cue points, for example to synchronize lip movement
+  ///   or to mark the sections of a music track. Regions are cue points with a length.
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE Marker {
+
+    /// <summary>Identifier the file assigned to the marker</summary>
+    /// <remarks>
+    ///   The cue point id in Waveform files and the track number in FLAC cue sheets
+    /// </remarks>
+    public: std::uint32_t Id;
+    /// <summary>Index of the frame the marker is placed at</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of frames the region covers, 0 for a simple cue point</summary>
+    public: std::uint64_t FrameCount;
+    /// <summary>Text the author attached to the marker, if any</summary>
+    public: std::optional<std::string> Label;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loudness normalization gains stored in the tags of an audio track</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Read from the REPLAYGAIN_* tags and from the R128_TRACK_GAIN and R128_ALBUM_GAIN
+  ///     tags Opus files use. All gains are in decibels relative to the ReplayGain 2.0
+  ///     reference loudness of -18 LUFS. R128 gains target -23 LUFS, so they have 5 dB
+  ///     added to make tracks tagged either way play equally loud.
+  ///   </para>
+  ///   <para>
+  ///     The output gain in an Opus header is not reported here because the decoder
+  ///     always applies it. R128 tags are relative to the output with that gain applied.
+  ///   </para>
+  /// </remarks>
+  struct NUCLEX_AUDIO_TYPE ReplayGainInfo {
+
+    /// <summary>Gain in dB that normalizes the loudness of this track</summary>
+    public: std::optional<float> TrackGain;
+    /// <summary>Highest sample magnitude in the track, with full scale being 1.0</summary>
+    public: std::optional<float> TrackPeak;
+    /// <summary>Gain in dB that normalizes the loudness of the whole album</summary>
+    public: std::optional<float> AlbumGain;
+    /// <summary>Highest sample magnitude in the whole album, with full scale being 1.0</summary>
+    public: std::optional<float> AlbumPeak;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Informations about an audio track (containing one or more channels)</summary>
   /// <remarks>
   ///   This structure is returned if you ask a codec to provide informations about
@@ -112,6 +185,46 @@ namespace Nuclex { namespace Audio {
     /// </remarks>
     public: std::size_t BitsPerSample;
 
+    /// <summary>Exact number of frames in the track after gapless trimming</summary>
+    /// <remarks>
+    ///   Unlike <see cref="Duration" />, this is not rounded and matches the number of
+    ///   frames the track's decoder will deliver (encoder delay and padding removed).
+    /// </remarks>
+    public: std::uint64_t FrameCount = 0;
+
+    /// <summary>Frames of encoder delay that are skipped at the start of the track</summary>
+    /// <remarks>
+    ///   Lossy codecs such as Opus prepend a few milliseconds of filter warm-up to
+    ///   the audio (the Opus pre-skip). Decoders drop these, they're only reported here
+    ///   so that tools can account for them, for example when correlating raw packets.
+    /// </remarks>
+    public: std::size_t LeadingPaddingFrameCount = 0;
+
+    /// <summary>Region that should repeat during playback, if the file defines one</summary>
+    /// <remarks>
+    ///   Read from the 'smpl' chunk in Waveform files and from the widely used
+    ///   LOOPSTART / LOOPLENGTH (or LOOPEND) tags in Vorbis comments. Use
+    ///   <see cref="Storage::AudioTrackDecoder::CreateLooping" /> to play it seamlessly.
+    /// </remarks>
+    public: std::optional<LoopRegion> Loop;
+
+    /// <summary>Cue points and regions stored in the file, sorted by their start</summary>
+    /// <remarks>
+    ///   Read from the 'cue ' chunk and the labels and region lengths in the 'adtl' list of
+    ///   Waveform files and from the CUESHEET block of FLAC files. Because the list is
+    ///   sorted, <see cref="FindMarkers" /> can look up the markers in a range of frames
+    ///   without visiting all of them.
+    /// </remarks>
+    public: std::vector<Marker> Markers;
+
+    /// <summary>Loudness normalization gains, if the file is tagged with them</summary>
+    /// <remarks>
+    ///   Read from the Vorbis comments of FLAC, Ogg Vorbis and Opus files. Decoders can
+    ///   apply these while converting samples, see
+    ///   <see cref="Storage::AudioTrackDecoder::TrySetReplayGain" />.
+    /// </remarks>
+    public: std::optional<ReplayGainInfo> ReplayGain;
+
     // ----------------------------------------------------------------------------------------- //
 
     // Helpers
@@ -166,6 +279,18 @@ namespace Nuclex { namespace Audio {
     /// </remarks>
     public: NUCLEX_AUDIO_API bool IsSevenDotOne() const;
 
+    /// <summary>Looks up the markers that start within a range of frames</summary>
+    /// <param name="startFrame">Index of the first frame in the range</param>
+    /// <param name="endFrame">Index one past the last frame in the range</param>
+    /// <returns>
+    ///   The index of the first marker starting in the range and the index one past
+    ///   the last such marker in <see cref="Markers" />. Both are equal if no marker
+    ///   starts in the range.
+    /// </returns>
+    public: NUCLEX_AUDIO_API std::pair<std::size_t, std::size_t> FindMarkers(
+      std::uint64_t startFrame, std::uint64_t endFrame
+    ) const;
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -237,6 +362,29 @@ namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline std::pair<std::size_t, std::size_t> TrackInfo::FindMarkers(
+    std::uint64_t startFrame, std::uint64_t endFrame
+  ) const {
+    auto isBefore = [](const Marker &marker, std::uint64_t frame) {
+      return marker.StartFrame < frame;
+    };
+
+    std::vector<Marker>::const_iterator first = std::lower_bound(
+      this->Markers.begin(), this->Markers.end(), startFrame, isBefore
+    );
+    std::vector<Marker>::const_iterator last = first;
+    if(startFrame < endFrame) {
+      last = std::lower_bound(first, this->Markers.end(), endFrame, isBefore);
+    }
+
+    return std::pair<std::size_t, std::size_t>(
+      static_cast<std::size_t>(first - this->Markers.begin()),
+      static_cast<std::size_t>(last - this->Markers.begin())
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Audio
 
 #endif // NUCLEX_AUDIO_TRACKINFO_H
@@ -0,0 +1,155 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_WORKSTEALINGEXECUTOR_H
+#define NUCLEX_AUDIO_WORKSTEALINGEXECUTOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the worker threads of an executor are placed on the processors</summary>
+  /// <remarks>
+  ///   Pinned workers allocate the buffers of decoders and converters they create on the
+  ///   memory of their own NUMA node (Linux and Windows both place memory on the node of
+  ///   the thread that first touches it), so memory-bound work such as sample conversion
+  ///   doesn't have to cross the interconnect between sockets.
+  /// </remarks>
+  enum class WorkerPlacement {
+
+    /// <summary>Workers are left to the operating system's scheduler</summary>
+    Unpinned = 0,
+    /// <summary>Workers are pinned to processors, filling up one node after another</summary>
+    /// <remarks>
+    ///   Keeps small pools on a single socket where they share the caches.
+    /// </remarks>
+    Compact = 1,
+    /// <summary>Workers are pinned to processors, spread round-robin over all nodes</summary>
+    /// <remarks>
+    ///   Makes use of the memory bandwidth of all sockets at once.
+    /// </remarks>
+    Spread = 2
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Thread pool whose workers take tasks from each other when they run out</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each worker has its own task queue. Tasks submitted from a worker go into that
+  ///     worker's queue, other tasks are spread over the queues round-robin. A worker
+  ///     takes tasks from the front of its own queue and, once that is empty, steals
+  ///     from the back of the other workers' queues. High priority tasks are taken from
+  ///     all queues before any normal priority task is taken and so on.
+  ///   </para>
+  ///   <para>
+  ///     Workers can be pinned to processors (see <see cref="WorkerPlacement" />). Pinned
+  ///     workers steal from workers on their own NUMA node before they turn to other nodes.
+  ///   </para>
+  ///   <para>
+  ///     Workers sleep while there are no tasks. Destroying the executor runs the tasks
+  ///     that are still queued, then stops the workers.
+  ///   </para>
+  /// </remarks>
+  class NUCLEX_AUDIO_TYPE WorkStealingExecutor : public Executor {
+
+    /// <summary>Initializes a new work-stealing executor</summary>
+    /// <param name="threadCount">
+    ///   Number of worker threads that will run tasks, zero for one per CPU core
+    /// </param>
+    /// <param name="placement">How the worker threads are placed on the processors</param>
+    public: NUCLEX_AUDIO_API WorkStealingExecutor(
+      std::size_t threadCount = 0, WorkerPlacement placement = WorkerPlacement::Unpinned
+    );
+
+    /// <summary>Runs all queued tasks, then stops the worker threads</summary>
+    public: NUCLEX_AUDIO_API ~WorkStealingExecutor() override;
+
+    /// <summary>Counts the worker threads that are running tasks</summary>
+    /// <returns>The number of tasks the executor can run at the same time</returns>
+    public: std::size_t CountWorkers() const override { return this->threads.size(); }
+
+    /// <summary>Schedules a task to run on one of the worker threads</summary>
+    /// <param name="task">Task that will be run</param>
+    /// <param name="priority">How urgently the task should be run</param>
+    public: NUCLEX_AUDIO_API void Submit(
+      std::function<void()> task, TaskPriority priority = TaskPriority::Normal
+    ) override;
+
+    /// <summary>Counts the tasks that were stolen from another worker's queue</summary>
+    /// <returns>The number of tasks that ran on a worker other than the one queued on</returns>
+    public: NUCLEX_AUDIO_API std::uint64_t CountStolenTasks() const;
+
+    /// <summary>Returns how the worker threads are placed on the processors</summary>
+    /// <returns>The placement policy the executor was created with</returns>
+    public: WorkerPlacement GetPlacement() const { return this->placement; }
+
+    /// <summary>Looks up the NUMA node a worker has been placed on</summary>
+    /// <param name="workerIndex">Index of the worker whose node will be returned</param>
+    /// <returns>The index of the node the worker is pinned to, 0 if unpinned</returns>
+    public: std::size_t GetWorkerNode(std::size_t workerIndex) const {
+      return this->workerNodes[workerIndex];
+    }
+
+    /// <summary>Task queues and wake-up signal shared by all workers</summary>
+    /// <remarks>
+    ///   Workers keep this alive on their own. If the last reference to the executor is
+    ///   dropped by one of its tasks, the executor is destroyed on one of its own workers
+    ///   and that worker has to finish up without touching the executor again.
+    /// </remarks>
+    private: struct SharedState;
+
+    /// <summary>Takes and runs tasks until the executor is destroyed</summary>
+    /// <param name="state">Task queues and wake-up signal shared by all workers</param>
+    /// <param name="workerIndex">Index of the worker running the method</param>
+    /// <param name="processorIndex">
+    ///   Processor the worker will pin itself to, the highest size_t value for none
+    /// </param>
+    private: static void runWorker(
+      const std::shared_ptr<SharedState> &state,
+      std::size_t workerIndex,
+      std::size_t processorIndex
+    );
+
+    /// <summary>Task queues and wake-up signal shared by all workers</summary>
+    private: std::shared_ptr<SharedState> state;
+    /// <summary>Worker threads that are running the tasks</summary>
+    private: std::vector<std::thread> threads;
+    /// <summary>How the worker threads are placed on the processors</summary>
+    private: WorkerPlacement placement;
+    /// <summary>NUMA node each worker has been placed on</summary>
+    private: std::vector<std::size_t> workerNodes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_WORKSTEALINGEXECUTOR_H
@@ -0,0 +1,72 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/AllocationScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tag of the innermost allocation scope open on the current thread</summary>
+  thread_local Nuclex::Audio::AllocationTag currentTag = {
+    Nuclex::Audio::AllocationSubsystem::Unattributed,
+    Nuclex::Audio::AllocationCodec::None
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationTag AllocationScope::GetCurrent() noexcept {
+    return currentTag;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationScope::AllocationScope(
+    AllocationSubsystem subsystem, AllocationCodec codec
+  ) noexcept :
+    previousTag(currentTag) {
+    currentTag.Subsystem = subsystem;
+    currentTag.Codec = codec;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationScope::AllocationScope(AllocationSubsystem subsystem) noexcept :
+    previousTag(currentTag) {
+    currentTag.Subsystem = subsystem;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationScope::~AllocationScope() {
+    currentTag = this->previousTag;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
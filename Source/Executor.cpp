@@ -0,0 +1,191 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/WorkStealingExecutor.h"
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <exception> // for std::exception_ptr
+#include <mutex> // for std::mutex
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Must be held while accessing the installed executor</summary>
+  std::mutex installedExecutorMutex;
+
+  /// <summary>Executor that is currently installed, null if none</summary>
+  std::shared_ptr<Nuclex::Audio::Executor> installedExecutor;
+
+  /// <summary>Executor that is used if none is installed, created on demand</summary>
+  std::shared_ptr<Nuclex::Audio::Executor> defaultExecutor;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Progress of a parallel for loop shared by all threads taking part</summary>
+  struct ParallelForState {
+
+    /// <summary>Initializes a new parallel for loop state</summary>
+    /// <param name="count">Number of indices the task will be run for</param>
+    /// <param name="body">Task that will be called for each index</param>
+    public: ParallelForState(
+      std::size_t count, const std::function<void(std::size_t)> &body
+    ) :
+      Count(count),
+      Body(&body),
+      NextIndex(0),
+      IsAborted(false),
+      FinishedCount(0),
+      Error() {}
+
+    /// <summary>Number of indices the task will be run for</summary>
+    public: std::size_t Count;
+    /// <summary>Task that will be called for each index</summary>
+    /// <remarks>
+    ///   Only valid while indices remain, workers that start late will find that all
+    ///   indices have been claimed and never touch this.
+    /// </remarks>
+    public: const std::function<void(std::size_t)> *Body;
+    /// <summary>Index that will be claimed next</summary>
+    public: std::atomic<std::size_t> NextIndex;
+    /// <summary>Set when the task has thrown so remaining indices will be skipped</summary>
+    public: std::atomic<bool> IsAborted;
+    /// <summary>Must be held while updating the finished count or error</summary>
+    public: std::mutex Mutex;
+    /// <summary>Signaled when the last index has finished</summary>
+    public: std::condition_variable FinishedCondition;
+    /// <summary>Number of indices that have been run or skipped</summary>
+    public: std::size_t FinishedCount;
+    /// <summary>First exception thrown by the task</summary>
+    public: std::exception_ptr Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Claims and runs indices of a parallel for loop until none are left</summary>
+  /// <param name="state">Parallel for loop whose indices will be run</param>
+  void runIndices(ParallelForState &state) {
+    for(;;) {
+      std::size_t index = state.NextIndex.fetch_add(1, std::memory_order_relaxed);
+      if(index >= state.Count) {
+        return;
+      }
+
+      std::exception_ptr error;
+      if(!state.IsAborted.load(std::memory_order_relaxed)) {
+        try {
+          (*state.Body)(index);
+        }
+        catch(...) {
+          error = std::current_exception();
+          state.IsAborted.store(true, std::memory_order_relaxed);
+        }
+      }
+
+      std::lock_guard<std::mutex> stateMutexScope(state.Mutex);
+      if(static_cast<bool>(error) && !static_cast<bool>(state.Error)) {
+        state.Error = error;
+      }
+      ++state.FinishedCount;
+      if(state.FinishedCount == state.Count) {
+        state.FinishedCondition.notify_all();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Executor::Install(const std::shared_ptr<Executor> &executor) {
+    std::lock_guard<std::mutex> installedExecutorMutexScope(installedExecutorMutex);
+    installedExecutor = executor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<Executor> Executor::GetInstalled() {
+    std::lock_guard<std::mutex> installedExecutorMutexScope(installedExecutorMutex);
+    if(static_cast<bool>(installedExecutor)) {
+      return installedExecutor;
+    }
+
+    if(!static_cast<bool>(defaultExecutor)) {
+      defaultExecutor = std::make_shared<WorkStealingExecutor>();
+    }
+    return defaultExecutor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Executor::ParallelFor(
+    std::size_t count,
+    const std::function<void(std::size_t)> &body,
+    TaskPriority priority /* = TaskPriority::Normal */
+  ) {
+    if(count < 2) {
+      if(count == 1) {
+        body(0);
+      }
+      return;
+    }
+
+    // Workers only get a shared reference to the loop's state, so those that start
+    // after the loop has finished find no indices left and simply return
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(count, body);
+
+    // If the executor refuses to take another task, we'll run the indices here
+    std::size_t helperCount = std::min(count - 1, CountWorkers());
+    for(std::size_t index = 0; index < helperCount; ++index) {
+      try {
+        Submit([state]() { runIndices(*state); }, priority);
+      }
+      catch(...) {
+        break;
+      }
+    }
+
+    runIndices(*state);
+
+    {
+      std::unique_lock<std::mutex> stateMutexScope(state->Mutex);
+      state->FinishedCondition.wait(
+        stateMutexScope, [&state]() { return state->FinishedCount == state->Count; }
+      );
+    }
+
+    if(static_cast<bool>(state->Error)) {
+      std::rethrow_exception(state->Error);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
@@ -0,0 +1,283 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/LargePageSampleAllocator.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "./Platform/WindowsApi.h"
+#elif defined(NUCLEX_AUDIO_LINUX)
+#include <sys/mman.h> // for ::mmap(), ::munmap(), ::madvise()
+#endif
+
+#include <cassert> // for assert()
+#include <cstdint> // for std::uintptr_t
+#include <new> // for std::bad_alloc, std::align_val_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a byte count up to a multiple of the specified page size</summary>
+  /// <param name="byteCount">Byte count that will be rounded up</param>
+  /// <param name="pageSize">Page size the byte count will be rounded to</param>
+  /// <returns>The smallest multiple of the page size holding the byte count</returns>
+  std::size_t roundUpToPageSize(std::size_t byteCount, std::size_t pageSize) {
+    std::size_t remainder = byteCount % pageSize;
+    if(remainder == 0) {
+      return byteCount;
+    } else {
+      return byteCount + (pageSize - remainder);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_LINUX)
+  /// <summary>Maps memory that the kernel is asked to back with transparent huge pages</summary>
+  /// <param name="byteCount">Number of bytes to map, a multiple of the huge page size</param>
+  /// <param name="pageKind">Receives the kind of pages that were obtained</param>
+  /// <returns>The address of the mapped memory or nullptr if mapping failed</returns>
+  void *mapTransparentHugePages(std::size_t byteCount, Nuclex::Audio::LargePageKind &pageKind) {
+    using Nuclex::Audio::LargePageSampleAllocator;
+
+    // The kernel can only use a huge page for a 2 MiB range starting at a 2 MiB boundary,
+    // so map one huge page more than needed and trim the misaligned head and tail.
+    std::size_t paddedByteCount = byteCount + LargePageSampleAllocator::HugePageSize;
+    void *padded = ::mmap(
+      nullptr, paddedByteCount, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if(padded == MAP_FAILED) {
+      return nullptr;
+    }
+
+    std::uintptr_t paddedAddress = reinterpret_cast<std::uintptr_t>(padded);
+    std::uintptr_t alignedAddress = static_cast<std::uintptr_t>(
+      roundUpToPageSize(paddedAddress, LargePageSampleAllocator::HugePageSize)
+    );
+    std::size_t headByteCount = static_cast<std::size_t>(alignedAddress - paddedAddress);
+    if(headByteCount > 0) {
+      ::munmap(padded, headByteCount);
+    }
+    std::size_t tailByteCount = LargePageSampleAllocator::HugePageSize - headByteCount;
+    if(tailByteCount > 0) {
+      ::munmap(reinterpret_cast<void *>(alignedAddress + byteCount), tailByteCount);
+    }
+
+    // Without transparent huge page support in the kernel, madvise() fails with EINVAL.
+    // The memory is perfectly usable either way, we just report what we got.
+    void *aligned = reinterpret_cast<void *>(alignedAddress);
+    if(::madvise(aligned, byteCount, MADV_HUGEPAGE) == 0) {
+      pageKind = Nuclex::Audio::LargePageKind::Transparent;
+    } else {
+      pageKind = Nuclex::Audio::LargePageKind::None;
+    }
+
+    return aligned;
+  }
+#endif // defined(NUCLEX_AUDIO_LINUX)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Maps a block of memory directly from the operating system</summary>
+  /// <param name="byteCount">Number of bytes that need to be mapped</param>
+  /// <param name="useExplicitLargePages">Whether to try reserved huge pages first</param>
+  /// <param name="mappedByteCount">Receives the number of bytes actually mapped</param>
+  /// <param name="pageKind">Receives the kind of pages that were obtained</param>
+  /// <returns>The address of the mapped memory or nullptr if mapping failed</returns>
+  void *mapBlock(
+    std::size_t byteCount, bool useExplicitLargePages,
+    std::size_t &mappedByteCount, Nuclex::Audio::LargePageKind &pageKind
+  ) {
+    using Nuclex::Audio::LargePageKind;
+    using Nuclex::Audio::LargePageSampleAllocator;
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    // Large pages only work if the process holds the 'Lock pages in memory' privilege,
+    // otherwise VirtualAlloc() fails and we continue with regular pages.
+    if(useExplicitLargePages) {
+      std::size_t largePageSize = static_cast<std::size_t>(::GetLargePageMinimum());
+      if(largePageSize > 0) {
+        mappedByteCount = roundUpToPageSize(byteCount, largePageSize);
+        void *memory = ::VirtualAlloc(
+          nullptr, mappedByteCount, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE
+        );
+        if(memory != nullptr) {
+          pageKind = LargePageKind::Explicit;
+          return memory;
+        }
+      }
+    }
+
+    // Windows has no transparent huge pages, so all that's left are regular pages
+    mappedByteCount = roundUpToPageSize(byteCount, LargePageSampleAllocator::HugePageSize);
+    pageKind = LargePageKind::None;
+    return ::VirtualAlloc(nullptr, mappedByteCount, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(NUCLEX_AUDIO_LINUX)
+    mappedByteCount = roundUpToPageSize(byteCount, LargePageSampleAllocator::HugePageSize);
+
+    // Explicit huge pages only exist if the administrator reserved some
+    // (via /proc/sys/vm/nr_hugepages), otherwise mmap() fails with ENOMEM.
+    if(useExplicitLargePages) {
+      void *memory = ::mmap(
+        nullptr, mappedByteCount,
+        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0
+      );
+      if(memory != MAP_FAILED) {
+        pageKind = LargePageKind::Explicit;
+        return memory;
+      }
+    }
+
+    return mapTransparentHugePages(mappedByteCount, pageKind);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns a block of memory mapped via mapBlock() to the operating system</summary>
+  /// <param name="memory">Address of the mapped memory</param>
+  /// <param name="mappedByteCount">Number of bytes that were mapped</param>
+  void unmapBlock(void *memory, std::size_t mappedByteCount) noexcept {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    (void)mappedByteCount;
+    ::VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(NUCLEX_AUDIO_LINUX)
+    ::munmap(memory, mappedByteCount);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the usage counter responsible for a kind of pages</summary>
+  /// <param name="usage">Usage statistics containing the counter</param>
+  /// <param name="pageKind">Kind of pages whose counter will be returned</param>
+  /// <returns>The counter tracking the number of bytes in the kind of pages</returns>
+  std::size_t &getUsageCounter(
+    Nuclex::Audio::LargePageUsage &usage, Nuclex::Audio::LargePageKind pageKind
+  ) {
+    switch(pageKind) {
+      case Nuclex::Audio::LargePageKind::Transparent: { return usage.TransparentByteCount; }
+      case Nuclex::Audio::LargePageKind::Explicit: { return usage.ExplicitByteCount; }
+      default: { return usage.RegularByteCount; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LargePageSampleAllocator::LargePageSampleAllocator(
+    std::size_t minimumByteCount /* = HugePageSize / 2 */,
+    bool useExplicitLargePages /* = false */
+  ) :
+    minimumByteCount(minimumByteCount),
+    useExplicitLargePages(useExplicitLargePages),
+    mappedBlocksMutex(),
+    mappedBlocks(),
+    usage() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LargePageSampleAllocator::~LargePageSampleAllocator() {
+    assert(this->mappedBlocks.empty() && u8"All memory has been returned to the allocator");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *LargePageSampleAllocator::Allocate(std::size_t byteCount) {
+    if(byteCount < this->minimumByteCount) {
+      return ::operator new(byteCount, std::align_val_t(Alignment));
+    }
+
+    std::size_t mappedByteCount;
+    LargePageKind pageKind;
+    void *memory = mapBlock(byteCount, this->useExplicitLargePages, mappedByteCount, pageKind);
+    if(unlikely(memory == nullptr)) {
+      throw std::bad_alloc();
+    }
+
+    try {
+      std::lock_guard<std::mutex> mappedBlocksScope(this->mappedBlocksMutex);
+      this->mappedBlocks.emplace(memory, MappedBlock { mappedByteCount, pageKind });
+      getUsageCounter(this->usage, pageKind) += mappedByteCount;
+    }
+    catch(...) {
+      unmapBlock(memory, mappedByteCount);
+      throw;
+    }
+
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LargePageSampleAllocator::Free(void *memory, std::size_t byteCount) noexcept {
+    if(byteCount < this->minimumByteCount) {
+      ::operator delete(memory, std::align_val_t(Alignment));
+      return;
+    }
+
+    std::size_t mappedByteCount;
+    {
+      std::lock_guard<std::mutex> mappedBlocksScope(this->mappedBlocksMutex);
+
+      MappedBlockMap::iterator iterator = this->mappedBlocks.find(memory);
+      assert((iterator != this->mappedBlocks.end()) && u8"Memory was mapped by the allocator");
+      if(unlikely(iterator == this->mappedBlocks.end())) {
+        return;
+      }
+
+      mappedByteCount = iterator->second.MappedByteCount;
+      getUsageCounter(this->usage, iterator->second.PageKind) -= mappedByteCount;
+      this->mappedBlocks.erase(iterator);
+    }
+
+    unmapBlock(memory, mappedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LargePageKind LargePageSampleAllocator::GetPageKind(const void *memory) const {
+    std::lock_guard<std::mutex> mappedBlocksScope(this->mappedBlocksMutex);
+
+    MappedBlockMap::const_iterator iterator = this->mappedBlocks.find(memory);
+    if(iterator == this->mappedBlocks.end()) {
+      return LargePageKind::None;
+    } else {
+      return iterator->second.PageKind;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LargePageUsage LargePageSampleAllocator::GetUsage() const {
+    std::lock_guard<std::mutex> mappedBlocksScope(this->mappedBlocksMutex);
+    return this->usage;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
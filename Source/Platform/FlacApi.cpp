@@ -136,6 +136,15 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool FlacApi::FinishAndCheckMd5(const std::shared_ptr<::FLAC__StreamDecoder> &decoder) {
+    // libflac only returns false from this when MD5 checking was enabled and the hash
+    // didn't match. Last checked in libflac, stream_decoder.c in 2024
+    ::FLAC__bool result = ::FLAC__stream_decoder_finish(decoder.get());
+    return (result != 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void FlacApi::SetRespondMetadata(
     const std::shared_ptr<::FLAC__StreamDecoder> &decoder,
     ::FLAC__MetadataType metadataType
@@ -183,6 +192,29 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void FlacApi::Flush(const std::shared_ptr<::FLAC__StreamDecoder> &decoder) {
+    FLAC__bool result = ::FLAC__stream_decoder_flush(decoder.get());
+    if(unlikely(result == 0)) {
+      throw std::runtime_error(u8"FLAC stream decoder failed to flush its input buffer");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<std::uint64_t> FlacApi::TryGetDecodePosition(
+    const std::shared_ptr<::FLAC__StreamDecoder> &decoder
+  ) {
+    FLAC__uint64 position = 0;
+    FLAC__bool result = ::FLAC__stream_decoder_get_decode_position(decoder.get(), &position);
+    if(result == 0) {
+      return std::optional<std::uint64_t>();
+    }
+
+    return static_cast<std::uint64_t>(position);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Platform
 
 #endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -26,6 +26,7 @@ limitations under the License.
 
 #include <memory> // for std::shared_ptr
 #include <cstdint> // for std::int32_t, std::uint64_t
+#include <optional> // for std::optional
 
 #include <FLAC/stream_decoder.h> // for the plain C FLAC decoder
 
@@ -100,6 +101,14 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// </remarks>
     public: static void Finish(const std::shared_ptr<::FLAC__StreamDecoder> &decoder);
 
+    /// <summary>Shuts a stream decoder down and reports whether the MD5 hash matched</summary>
+    /// <param name="decoder">Stream decoder that will be shut down</param>
+    /// <returns>
+    ///   False if MD5 checking was enabled and the decoded audio did not match the hash
+    ///   stored in the file, true otherwise
+    /// </returns>
+    public: static bool FinishAndCheckMd5(const std::shared_ptr<::FLAC__StreamDecoder> &decoder);
+
     /// <summary>Enables the metadata callback for the specified metadata block type</summary>
     /// <param name="deocder">Decoder for which a metadata callback will be enabled</param>
     /// <param name="metadataType">Metadata block type for which to enable the callback</param>
@@ -130,6 +139,24 @@ namespace Nuclex { namespace Audio { namespace Platform {
       std::uint64_t frameIndex
     );
 
+    /// <summary>Discards buffered data and lets the decoder look for the next frame</summary>
+    /// <param name="decoder">Decoder whose input buffer will be flushed</param>
+    /// <remarks>
+    ///   After flushing, the decoder continues at the next frame sync code it finds
+    ///   from the current position of the file cursor on.
+    /// </remarks>
+    public: static void Flush(const std::shared_ptr<::FLAC__StreamDecoder> &decoder);
+
+    /// <summary>Determines the byte offset up to which the decoder has decoded</summary>
+    /// <param name="decoder">Decoder whose decoding position will be determined</param>
+    /// <returns>
+    ///   The offset of the first byte not yet decoded or nothing if the decoder
+    ///   is unable to tell (for example while it is still reading metadata)
+    /// </returns>
+    public: static std::optional<std::uint64_t> TryGetDecodePosition(
+      const std::shared_ptr<::FLAC__StreamDecoder> &decoder
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,207 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "FlacEncoderApi.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception describing the state a stream encoder has failed in</summary>
+  /// <param name="rootCauseException">
+  ///   Exception that happened in the virtual file, will be thrown instead if set
+  /// </param>
+  /// <param name="encoder">Stream encoder that has failed</param>
+  /// <param name="message">Message that will be prepended to the encoder's state</param>
+  [[noreturn]] void throwEncoderError(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+    const char *message
+  ) {
+
+    // If something happened writing to the virtual file, that is the root cause
+    // exception and will be reported above whatever error it caused in libflac.
+    if(unlikely(static_cast<bool>(rootCauseException))) {
+      std::rethrow_exception(rootCauseException);
+    }
+
+    std::string combinedMessage(message);
+    combinedMessage.append(
+      ::FLAC__stream_encoder_get_resolved_state_string(encoder.get())
+    );
+    throw std::runtime_error(combinedMessage);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks the result of a setter call on the stream encoder</summary>
+  /// <param name="result">Result returned by the setter</param>
+  void requireUninitialized(::FLAC__bool result) {
+    if(unlikely(result == 0)) {
+      throw std::logic_error(
+        u8"Unable to change libflac encoder settings, encoder already initialized?"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::FLAC__StreamEncoder> FlacEncoderApi::NewStreamEncoder() {
+    ::FLAC__StreamEncoder *encoder = ::FLAC__stream_encoder_new();
+    if(encoder == nullptr) {
+      throw std::runtime_error(u8"Unable to allocate new FLAC stream encoder");
+    }
+
+    return std::shared_ptr<::FLAC__StreamEncoder>(
+      encoder, &::FLAC__stream_encoder_delete
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::SetFormat(
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+    std::size_t channelCount, std::size_t bitsPerSample, std::size_t sampleRate
+  ) {
+    requireUninitialized(
+      ::FLAC__stream_encoder_set_channels(encoder.get(), static_cast<unsigned>(channelCount))
+    );
+    requireUninitialized(
+      ::FLAC__stream_encoder_set_bits_per_sample(
+        encoder.get(), static_cast<unsigned>(bitsPerSample)
+      )
+    );
+    requireUninitialized(
+      ::FLAC__stream_encoder_set_sample_rate(encoder.get(), static_cast<unsigned>(sampleRate))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::SetCompressionLevel(
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder, unsigned level
+  ) {
+    requireUninitialized(::FLAC__stream_encoder_set_compression_level(encoder.get(), level));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::SetBlockSize(
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder, std::size_t blockSize
+  ) {
+    requireUninitialized(
+      ::FLAC__stream_encoder_set_blocksize(encoder.get(), static_cast<unsigned>(blockSize))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::EnableMd5Calculation(
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder, bool enable /* = true */
+  ) {
+    requireUninitialized(
+      ::FLAC__stream_encoder_set_do_md5(encoder.get(), enable ? 1 : 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::InitStream(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+    ::FLAC__StreamEncoderWriteCallback writeCallback,
+    ::FLAC__StreamEncoderSeekCallback seekCallback,
+    ::FLAC__StreamEncoderTellCallback tellCallback,
+    void *clientData
+  ) {
+    ::FLAC__StreamEncoderInitStatus result = ::FLAC__stream_encoder_init_stream(
+      encoder.get(),
+      writeCallback,
+      seekCallback,
+      tellCallback,
+      nullptr, // metadata callback, only needed without seek callback
+      clientData
+    );
+    if(unlikely(result != FLAC__STREAM_ENCODER_INIT_STATUS_OK)) {
+      if(result == FLAC__STREAM_ENCODER_INIT_STATUS_ENCODER_ERROR) {
+        throwEncoderError(
+          rootCauseException, encoder, u8"Error setting up the libflac encoder: "
+        );
+      }
+
+      if(unlikely(static_cast<bool>(rootCauseException))) {
+        std::rethrow_exception(rootCauseException);
+      }
+
+      std::string message(u8"Error setting up the libflac encoder: ", 38);
+      message.append(::FLAC__StreamEncoderInitStatusString[result]);
+      throw std::runtime_error(message);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::ProcessInterleaved(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+    const std::int32_t *samples, std::size_t frameCount
+  ) {
+    ::FLAC__bool result = ::FLAC__stream_encoder_process_interleaved(
+      encoder.get(), samples, static_cast<unsigned>(frameCount)
+    );
+    if(unlikely(result == 0)) {
+      throwEncoderError(
+        rootCauseException, encoder, u8"Error encoding audio samples via libflac: "
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacEncoderApi::Finish(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder
+  ) {
+    ::FLAC__bool result = ::FLAC__stream_encoder_finish(encoder.get());
+    if(unlikely(result == 0)) {
+      throwEncoderError(
+        rootCauseException, encoder, u8"Error finishing the FLAC stream via libflac: "
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,135 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PLATFORM_FLACENCODERAPI_H
+#define NUCLEX_AUDIO_PLATFORM_FLACENCODERAPI_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <memory> // for std::shared_ptr
+#include <cstdint> // for std::int32_t, std::uint64_t
+#include <exception> // for std::exception_ptr
+
+#include <FLAC/stream_encoder.h> // for the plain C FLAC encoder
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps the FLAC encoder API with error checking</summary>
+  class FlacEncoderApi {
+
+    /// <summary>Creates a new FLAC stream encoder</summary>
+    /// <returns>The new FLAC stream encoder</returns>
+    public: static std::shared_ptr<::FLAC__StreamEncoder> NewStreamEncoder();
+
+    /// <summary>Sets the format of the samples the encoder will be fed</summary>
+    /// <param name="encoder">Encoder whose input format will be set</param>
+    /// <param name="channelCount">Number of interleaved channels in each frame</param>
+    /// <param name="bitsPerSample">Number of valid bits in each sample</param>
+    /// <param name="sampleRate">Playback rate in samples per second</param>
+    public: static void SetFormat(
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+      std::size_t channelCount, std::size_t bitsPerSample, std::size_t sampleRate
+    );
+
+    /// <summary>Selects one of the preset compression levels of libFLAC</summary>
+    /// <param name="encoder">Encoder whose compression level will be set</param>
+    /// <param name="level">Compression level from 0 (fastest) to 8 (smallest)</param>
+    /// <remarks>
+    ///   The compression level changes several encoder settings at once, including
+    ///   the block size, so any custom block size needs to be set afterwards.
+    /// </remarks>
+    public: static void SetCompressionLevel(
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder, unsigned level
+    );
+
+    /// <summary>Sets the number of frames the encoder will put in each FLAC frame</summary>
+    /// <param name="encoder">Encoder whose block size will be set</param>
+    /// <param name="blockSize">Number of audio frames in each FLAC frame</param>
+    public: static void SetBlockSize(
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder, std::size_t blockSize
+    );
+
+    /// <summary>Enables or disables the MD5 signature of the unencoded audio data</summary>
+    /// <param name="encoder">Encoder on which MD5 calculation will be enabled or disabled</param>
+    /// <param name="enable">True to calculate the MD5 signature, false to skip it</param>
+    public: static void EnableMd5Calculation(
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder, bool enable = true
+    );
+
+    /// <summary>Sets up a stream encoder to write via callbacks</summary>
+    /// <param name="rootCauseException">
+    ///   Should receive any exception that happened in the virtual file and will be thrown
+    ///   instead of a generic FLAC error if it becomes filled during the FLAC API call
+    /// </param>
+    /// <param name="encoder">Encoder that will be set up</param>
+    /// <param name="writeCallback">Callback that receives the encoded data</param>
+    /// <param name="seekCallback">Callback to move the file cursor, can be null</param>
+    /// <param name="tellCallback">Callback to query the file cursor, can be null</param>
+    /// <param name="clientData">Pointer that will be passed unchaged to callbacks</param>
+    /// <remarks>
+    ///   Without seek and tell callbacks, the encoder can not go back and update
+    ///   the stream info block with the total length and MD5 signature when it finishes.
+    /// </remarks>
+    public: static void InitStream(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+      ::FLAC__StreamEncoderWriteCallback writeCallback,
+      ::FLAC__StreamEncoderSeekCallback seekCallback,
+      ::FLAC__StreamEncoderTellCallback tellCallback,
+      void *clientData
+    );
+
+    /// <summary>Feeds interleaved samples to the encoder</summary>
+    /// <param name="rootCauseException">
+    ///   Should receive any exception that happened in the virtual file and will be thrown
+    ///   instead of a generic FLAC error if it becomes filled during the FLAC API call
+    /// </param>
+    /// <param name="encoder">Encoder that will be fed the samples</param>
+    /// <param name="samples">Interleaved, right-aligned samples</param>
+    /// <param name="frameCount">Number of audio frames in the sample buffer</param>
+    public: static void ProcessInterleaved(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder,
+      const std::int32_t *samples, std::size_t frameCount
+    );
+
+    /// <summary>Encodes any buffered samples and completes the stream</summary>
+    /// <param name="rootCauseException">
+    ///   Should receive any exception that happened in the virtual file and will be thrown
+    ///   instead of a generic FLAC error if it becomes filled during the FLAC API call
+    /// </param>
+    /// <param name="encoder">Encoder that will be finished</param>
+    public: static void Finish(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_PLATFORM_FLACENCODERAPI_H
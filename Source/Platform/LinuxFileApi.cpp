@@ -28,8 +28,9 @@ limitations under the License.
 #include "PosixFileApi.h" // for ThrowExceptionForFileAccessError()
 
 #include <linux/limits.h> // for PATH_MAX
-#include <fcntl.h> // ::open() and flags
+#include <fcntl.h> // ::open(), ::fallocate() and flags
 #include <unistd.h> // ::read(), ::write(), ::close(), etc.
+#include <sys/mman.h> // ::mmap(), ::munmap()
 
 #include <cerrno> // To access ::errno directly
 #include <vector> // std::vector
@@ -83,6 +84,35 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  int LinuxFileApi::TryOpenFileDirect(const std::string &path, bool forWriting) {
+    int fileDescriptor;
+    if(forWriting) {
+      fileDescriptor = ::open(
+        path.c_str(),
+        O_RDWR | O_CREAT | O_LARGEFILE | O_DIRECT,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH
+      );
+    } else {
+      fileDescriptor = ::open(path.c_str(), O_RDONLY | O_LARGEFILE | O_DIRECT);
+    }
+    if(unlikely(fileDescriptor < 0)) {
+      int errorNumber = errno;
+      if(errorNumber == EINVAL) {
+        return -1; // File system doesn't do O_DIRECT
+      }
+
+      std::string errorMessage(u8"Could not open file '");
+      errorMessage.append(path);
+      errorMessage.append(forWriting ? u8"' for writing" : u8"' for reading");
+
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(errorMessage, errorNumber);
+    }
+
+    return fileDescriptor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t LinuxFileApi::Seek(int fileDescriptor, ::off_t offset, int anchor) {
     ::off_t absolutePosition = ::lseek(fileDescriptor, offset, anchor);
     if(absolutePosition == -1) {
@@ -129,6 +159,22 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t LinuxFileApi::PositionalReadVector(
+    int fileDescriptor, const ::iovec *ioVectors, int ioVectorCount, std::uint64_t offset
+  ) {
+    ssize_t result = ::preadv(fileDescriptor, ioVectors, ioVectorCount, offset);
+    if(unlikely(result == static_cast<ssize_t>(-1))) {
+      int errorNumber = errno;
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+        u8"Could not read data from file", errorNumber
+      );
+    }
+
+    return static_cast<std::size_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t LinuxFileApi::Write(
     int fileDescriptor, const std::byte *buffer, std::size_t count
   ) {
@@ -177,6 +223,63 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void LinuxFileApi::Truncate(int fileDescriptor, std::uint64_t length) {
+    int result = ::ftruncate(fileDescriptor, static_cast<::off_t>(length));
+    if(unlikely(result == -1)) {
+      int errorNumber = errno;
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+        u8"Could not change the length of a file", errorNumber
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool LinuxFileApi::TryPreallocate(int fileDescriptor, std::uint64_t byteCount) {
+    int result = ::fallocate(
+      fileDescriptor, FALLOC_FL_KEEP_SIZE, 0, static_cast<::off_t>(byteCount)
+    );
+    return (result == 0); // It's only an optimization, if it doesn't work, so be it
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LinuxFileApi::AdviseAccessPattern(
+    int fileDescriptor, std::uint64_t offset, std::uint64_t length, int advice
+  ) {
+    int result = ::posix_fadvise(
+      fileDescriptor, static_cast<::off_t>(offset), static_cast<::off_t>(length), advice
+    );
+    (void)result; // It's only a hint, if the kernel doesn't want it, so be it
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *LinuxFileApi::TryMapFileForReading(int fileDescriptor, std::size_t length) {
+    void *memory = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if(unlikely(memory == MAP_FAILED)) {
+      return nullptr;
+    }
+
+    return reinterpret_cast<const std::byte *>(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LinuxFileApi::UnmapFile(
+    const std::byte *memory, std::size_t length, bool throwOnError /* = true */
+  ) {
+    int result = ::munmap(const_cast<std::byte *>(memory), length);
+    if(throwOnError && unlikely(result == -1)) {
+      int errorNumber = errno;
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+        u8"Could not unmap file from memory", errorNumber
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void LinuxFileApi::Close(int fileDescriptor, bool throwOnError /* = true */) {
     int result = ::close(fileDescriptor);
     if(throwOnError && unlikely(result == -1)) {
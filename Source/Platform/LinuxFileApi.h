@@ -30,6 +30,7 @@ limitations under the License.
 
 #include <sys/stat.h> // ::fstat() and permission flags
 #include <dirent.h> // struct ::dirent
+#include <sys/uio.h> // struct ::iovec
 
 namespace Nuclex { namespace Audio { namespace Platform {
 
@@ -60,6 +61,19 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <returns>The descriptor (numeric handle) of the opened file</returns>
     public: static int OpenFileForWriting(const std::string &path);
 
+    /// <summary>Opens the specified file for I/O that bypasses the page cache</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="forWriting">Whether to create or open the file for writing</param>
+    /// <returns>
+    ///   The descriptor of the opened file or -1 if the file system does not support
+    ///   direct I/O (tmpfs, some FUSE and network file systems)
+    /// </returns>
+    /// <remarks>
+    ///   All reads and writes through the returned descriptor must use buffers, offsets
+    ///   and lengths aligned to the device's logical block size.
+    /// </remarks>
+    public: static int TryOpenFileDirect(const std::string &path, bool forWriting);
+
     /// <summary>Changes the position of the file cursor</summary>
     /// <param name="fileDescriptor">File handle whose file cursor will be moved</param>
     /// <param name="offset">Relative position, in bytes, to move the file cursor to</param>
@@ -86,6 +100,16 @@ namespace Nuclex { namespace Audio { namespace Platform {
       int fileDescriptor, std::byte *buffer, std::size_t count, std::uint64_t offset
     );
 
+    /// <summary>Reads data from the specified file into several buffers</summary>
+    /// <param name="fileDescriptor">Handle of the file from which data will be read</param>
+    /// <param name="ioVectors">Buffers that will be filled one after another</param>
+    /// <param name="ioVectorCount">Number of buffers in the I/O vector array</param>
+    /// <param name="offset">Absolute file offset at which the read will take place</param>
+    /// <returns>The number of bytes that were actually read</returns>
+    public: static std::size_t PositionalReadVector(
+      int fileDescriptor, const ::iovec *ioVectors, int ioVectorCount, std::uint64_t offset
+    );
+
     /// <summary>Writes data into the specified file</summary>
     /// <param name="fileDescriptor">Handle of the file into which data will be written</param>
     /// <param name="buffer">Buffer containing the data that will be written</param>
@@ -112,6 +136,58 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <returns>The size of the specified file</returns>
     public: static std::uint64_t StatFileSize(int fileDescriptor);
 
+    /// <summary>Cuts off or extends a file to the specified length</summary>
+    /// <param name="fileDescriptor">File descriptor of the file that will be resized</param>
+    /// <param name="length">New length of the file in bytes</param>
+    public: static void Truncate(int fileDescriptor, std::uint64_t length);
+
+    /// <summary>Reserves disk space for a file without changing its length</summary>
+    /// <param name="fileDescriptor">File descriptor of the file to reserve space for</param>
+    /// <param name="byteCount">Number of bytes the file is expected to grow to</param>
+    /// <returns>True if the space was reserved, false if the file system can't do it</returns>
+    /// <remarks>
+    ///   Reserved space beyond the end of the file stays allocated until the file is
+    ///   truncated, so it should be cut back once the final length is known.
+    /// </remarks>
+    public: static bool TryPreallocate(int fileDescriptor, std::uint64_t byteCount);
+
+    /// <summary>Tells the kernel how a range of the file is going to be accessed</summary>
+    /// <param name="fileDescriptor">File descriptor of the file the hint is about</param>
+    /// <param name="offset">Offset at which the range the hint is about begins</param>
+    /// <param name="length">Length of the range, 0 covers everything to the file's end</param>
+    /// <param name="advice">One of the POSIX_FADV_* constants from fcntl.h</param>
+    /// <remarks>
+    ///   This is only a hint, so failures (i.e. on pipes) are silently ignored.
+    /// </remarks>
+    public: static void AdviseAccessPattern(
+      int fileDescriptor, std::uint64_t offset, std::uint64_t length, int advice
+    );
+
+    /// <summary>Maps the contents of a file into the process' address space</summary>
+    /// <param name="fileDescriptor">File descriptor of the file that will be mapped</param>
+    /// <param name="length">Number of bytes from the file start that will be mapped</param>
+    /// <returns>
+    ///   The address at which the file contents are accessible or a null pointer if
+    ///   the file could not be mapped (for example because it is a pipe)
+    /// </returns>
+    /// <remarks>
+    ///   The mapping stays valid after the file descriptor has been closed and has to be
+    ///   released separately via <see cref="UnmapFile" />.
+    /// </remarks>
+    public: static const std::byte *TryMapFileForReading(
+      int fileDescriptor, std::size_t length
+    );
+
+    /// <summary>Releases a file mapping that was created previously</summary>
+    /// <param name="memory">Address at which the file contents have been mapped</param>
+    /// <param name="length">Number of bytes that have been mapped</param>
+    /// <param name="throwOnError">
+    ///   Whether to throw an exception if the file mapping cannot be released
+    /// </param>
+    public: static void UnmapFile(
+      const std::byte *memory, std::size_t length, bool throwOnError = true
+    );
+
     /// <summary>Closes the specified file</summary>
     /// <param name="fileDescriptor">Handle of the file that will be closed</param>
     /// <param name="throwOnError">
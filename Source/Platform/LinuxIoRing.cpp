@@ -0,0 +1,321 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "LinuxIoRing.h"
+
+#if defined(NUCLEX_AUDIO_LINUX)
+
+#include "LinuxFileApi.h" // for LinuxFileApi::PositionalRead()
+#include "PosixFileApi.h" // for ThrowExceptionForFileAccessError()
+
+#include <linux/io_uring.h> // for the io_uring structures and constants
+#include <sys/mman.h> // for ::mmap(), ::munmap()
+#include <sys/syscall.h> // for __NR_io_uring_setup, __NR_io_uring_enter
+#include <unistd.h> // for ::syscall(), ::close()
+
+#include <algorithm> // for std::min(), std::max()
+#include <cassert> // for assert()
+#include <cerrno> // To access ::errno directly
+#include <cstring> // for std::memset()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets up a new io_uring instance</summary>
+  /// <param name="entryCount">Number of entries in the submission queue</param>
+  /// <param name="parameters">Receives the layout of the ring buffers</param>
+  /// <returns>The file descriptor of the new io_uring or -1 on error</returns>
+  int ioUringSetup(std::uint32_t entryCount, ::io_uring_params &parameters) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entryCount, &parameters));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Submits queued entries and optionally waits for completions</summary>
+  /// <param name="ringFileDescriptor">File descriptor of the io_uring</param>
+  /// <param name="submitCount">Number of queued entries that will be submitted</param>
+  /// <param name="minimumCompletionCount">Number of completions to wait for</param>
+  /// <returns>The number of entries submitted or -1 on error</returns>
+  int ioUringEnter(
+    int ringFileDescriptor, std::uint32_t submitCount, std::uint32_t minimumCompletionCount
+  ) {
+    return static_cast<int>(
+      ::syscall(
+        __NR_io_uring_enter,
+        ringFileDescriptor, submitCount, minimumCompletionCount,
+        IORING_ENTER_GETEVENTS, nullptr, 0
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the address of a field within a mapped ring buffer</summary>
+  /// <typeparam name="TField">Type of the field whose address will be calculated</typeparam>
+  /// <param name="ring">Address at which the ring buffer has been mapped</param>
+  /// <param name="offset">Offset of the field reported by the kernel</param>
+  /// <returns>The address of the field</returns>
+  template<typename TField>
+  TField *ringField(void *ring, std::uint32_t offset) {
+    return reinterpret_cast<TField *>(reinterpret_cast<std::byte *>(ring) + offset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LinuxIoRing::LinuxIoRing() :
+    ringFileDescriptor(-1),
+    submissionRing(MAP_FAILED),
+    submissionRingSize(0),
+    completionRing(MAP_FAILED),
+    completionRingSize(0),
+    submissionEntries(nullptr),
+    submissionEntriesSize(0),
+    queueDepth(0),
+    submissionTail(nullptr),
+    submissionMask(0),
+    submissionArray(nullptr),
+    completionHead(nullptr),
+    completionTail(nullptr),
+    completionMask(0),
+    completionEntries(nullptr),
+    ioVectors(),
+    results() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LinuxIoRing::~LinuxIoRing() {
+    if(this->submissionEntries != nullptr) {
+      ::munmap(this->submissionEntries, this->submissionEntriesSize);
+    }
+    if((this->completionRing != MAP_FAILED) && (this->completionRing != this->submissionRing)) {
+      ::munmap(this->completionRing, this->completionRingSize);
+    }
+    if(this->submissionRing != MAP_FAILED) {
+      ::munmap(this->submissionRing, this->submissionRingSize);
+    }
+    if(this->ringFileDescriptor != -1) {
+      int result = ::close(this->ringFileDescriptor);
+      NUCLEX_AUDIO_NDEBUG_UNUSED(result);
+      assert((result != -1) && u8"io_uring file descriptor is closed successfully");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<LinuxIoRing> LinuxIoRing::TryCreate(std::uint32_t queueDepth) {
+    std::unique_ptr<LinuxIoRing> ring(new LinuxIoRing());
+
+    ::io_uring_params parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    ring->ringFileDescriptor = ioUringSetup(queueDepth, parameters);
+    if(ring->ringFileDescriptor == -1) {
+      return std::unique_ptr<LinuxIoRing>(); // ENOSYS, EPERM (disabled) and so on
+    }
+
+    // Map the submission and completion queue rings. Since Linux 5.4, both live
+    // in the same mapping, which the kernel indicates with IORING_FEAT_SINGLE_MMAP.
+    ring->submissionRingSize = (
+      parameters.sq_off.array + parameters.sq_entries * sizeof(std::uint32_t)
+    );
+    ring->completionRingSize = (
+      parameters.cq_off.cqes + parameters.cq_entries * sizeof(::io_uring_cqe)
+    );
+    bool isSingleMapping = ((parameters.features & IORING_FEAT_SINGLE_MMAP) != 0);
+    if(isSingleMapping) {
+      ring->submissionRingSize = std::max(ring->submissionRingSize, ring->completionRingSize);
+      ring->completionRingSize = ring->submissionRingSize;
+    }
+
+    ring->submissionRing = ::mmap(
+      nullptr, ring->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring->ringFileDescriptor, IORING_OFF_SQ_RING
+    );
+    if(ring->submissionRing == MAP_FAILED) {
+      return std::unique_ptr<LinuxIoRing>();
+    }
+    if(isSingleMapping) {
+      ring->completionRing = ring->submissionRing;
+    } else {
+      ring->completionRing = ::mmap(
+        nullptr, ring->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring->ringFileDescriptor, IORING_OFF_CQ_RING
+      );
+      if(ring->completionRing == MAP_FAILED) {
+        return std::unique_ptr<LinuxIoRing>();
+      }
+    }
+
+    ring->submissionEntriesSize = parameters.sq_entries * sizeof(::io_uring_sqe);
+    void *submissionEntries = ::mmap(
+      nullptr, ring->submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring->ringFileDescriptor, IORING_OFF_SQES
+    );
+    if(submissionEntries == MAP_FAILED) {
+      return std::unique_ptr<LinuxIoRing>();
+    }
+    ring->submissionEntries = reinterpret_cast<::io_uring_sqe *>(submissionEntries);
+
+    // Look up the addresses of the ring buffer fields we need to access
+    ring->queueDepth = parameters.sq_entries;
+    ring->submissionTail = ringField<std::uint32_t>(
+      ring->submissionRing, parameters.sq_off.tail
+    );
+    ring->submissionMask = *ringField<std::uint32_t>(
+      ring->submissionRing, parameters.sq_off.ring_mask
+    );
+    ring->submissionArray = ringField<std::uint32_t>(
+      ring->submissionRing, parameters.sq_off.array
+    );
+    ring->completionHead = ringField<std::uint32_t>(
+      ring->completionRing, parameters.cq_off.head
+    );
+    ring->completionTail = ringField<std::uint32_t>(
+      ring->completionRing, parameters.cq_off.tail
+    );
+    ring->completionMask = *ringField<std::uint32_t>(
+      ring->completionRing, parameters.cq_off.ring_mask
+    );
+    ring->completionEntries = ringField<::io_uring_cqe>(
+      ring->completionRing, parameters.cq_off.cqes
+    );
+
+    ring->ioVectors.resize(ring->queueDepth);
+    ring->results.resize(ring->queueDepth);
+
+    return ring;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LinuxIoRing::ReadMany(
+    int fileDescriptor, const Storage::ReadRequest *requests, std::size_t requestCount
+  ) {
+    while(requestCount > 0) {
+      std::size_t batchSize = std::min<std::size_t>(requestCount, this->queueDepth);
+
+      // Queue one IORING_OP_READV per request. We use READV rather than READ because
+      // it has been available since the very first io_uring kernel (5.1).
+      std::uint32_t tail = *this->submissionTail; // We're the only writer, no barrier
+      for(std::size_t index = 0; index < batchSize; ++index) {
+        std::uint32_t slot = (tail + static_cast<std::uint32_t>(index)) & this->submissionMask;
+
+        this->ioVectors[index].iov_base = requests[index].Buffer;
+        this->ioVectors[index].iov_len = requests[index].ByteCount;
+
+        ::io_uring_sqe &entry = this->submissionEntries[slot];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_READV;
+        entry.fd = fileDescriptor;
+        entry.off = requests[index].Start;
+        entry.addr = reinterpret_cast<std::uintptr_t>(&this->ioVectors[index]);
+        entry.len = 1;
+        entry.user_data = index;
+
+        this->submissionArray[slot] = slot;
+      }
+      __atomic_store_n(
+        this->submissionTail, tail + static_cast<std::uint32_t>(batchSize), __ATOMIC_RELEASE
+      );
+
+      this->submitAndWait(batchSize);
+
+      // Check the results. Failed reads throw, reads that came up short (which can
+      // happen when a read crosses the end of the file or is interrupted) are finished
+      // with plain pread() calls, just like RealFile::ReadAt() would do.
+      for(std::size_t index = 0; index < batchSize; ++index) {
+        int result = this->results[index];
+        if(unlikely(result < 0)) {
+          Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+            u8"Could not read data from file", -result
+          );
+        }
+
+        std::size_t transferredByteCount = static_cast<std::size_t>(result);
+        while(unlikely(transferredByteCount < requests[index].ByteCount)) {
+          std::size_t readByteCount = Platform::LinuxFileApi::PositionalRead(
+            fileDescriptor,
+            requests[index].Buffer + transferredByteCount,
+            requests[index].ByteCount - transferredByteCount,
+            requests[index].Start + transferredByteCount
+          );
+          if(unlikely(readByteCount == 0)) {
+            Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+              u8"Encountered unexpected end of file", EIO
+            );
+          }
+          transferredByteCount += readByteCount;
+        }
+      }
+
+      requests += batchSize;
+      requestCount -= batchSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LinuxIoRing::submitAndWait(std::size_t entryCount) {
+    std::size_t submittedCount = 0;
+    std::size_t completedCount = 0;
+    while(completedCount < entryCount) {
+      int result = ioUringEnter(
+        this->ringFileDescriptor,
+        static_cast<std::uint32_t>(entryCount - submittedCount),
+        1 // wait for at least one completion
+      );
+      if(unlikely(result == -1)) {
+        int errorNumber = errno;
+        if((errorNumber == EINTR) || (errorNumber == EAGAIN) || (errorNumber == EBUSY)) {
+          continue; // Interrupted or out of resources, completions will still arrive
+        }
+        Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+          u8"Could not submit reads to io_uring", errorNumber
+        );
+      }
+      submittedCount += static_cast<std::size_t>(result);
+
+      // Reap all completions the kernel has delivered so far
+      std::uint32_t head = *this->completionHead; // We're the only writer, no barrier
+      std::uint32_t tail = __atomic_load_n(this->completionTail, __ATOMIC_ACQUIRE);
+      while(head != tail) {
+        const ::io_uring_cqe &completion = this->completionEntries[head & this->completionMask];
+        assert((completion.user_data < entryCount) && u8"Completion belongs to this batch");
+        this->results[static_cast<std::size_t>(completion.user_data)] = completion.res;
+        ++head;
+        ++completedCount;
+      }
+      __atomic_store_n(this->completionHead, head, __ATOMIC_RELEASE);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_LINUX)
@@ -0,0 +1,134 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PLATFORM_LINUXIORING_H
+#define NUCLEX_AUDIO_PLATFORM_LINUXIORING_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_LINUX)
+
+#include "Nuclex/Audio/Storage/ReadRequest.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+#include <memory> // for std::unique_ptr
+#include <vector> // for std::vector
+
+#include <sys/uio.h> // for struct ::iovec
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Submits batches of reads to the Linux kernel through io_uring</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This talks to the kernel's io_uring interface directly via system calls, so
+  ///     there's no dependency on liburing. Kernels that are too old (io_uring appeared
+  ///     in Linux 5.1) or that have io_uring disabled via sysctl or seccomp are detected
+  ///     by <see cref="TryCreate" /> returning a null pointer.
+  ///   </para>
+  ///   <para>
+  ///     Instances are not thread-safe, the caller needs to make sure only one thread
+  ///     at a time submits reads through a ring.
+  ///   </para>
+  /// </remarks>
+  class LinuxIoRing {
+
+    /// <summary>Attempts to set up a new io_uring instance</summary>
+    /// <param name="queueDepth">Maximum number of reads that can be in flight at once</param>
+    /// <returns>The new io_uring or a null pointer if io_uring is unavailable</returns>
+    public: static std::unique_ptr<LinuxIoRing> TryCreate(std::uint32_t queueDepth);
+
+    /// <summary>Shuts down the io_uring and frees all its resources</summary>
+    public: ~LinuxIoRing();
+
+    /// <summary>Reads several ranges from a file and waits for all of them</summary>
+    /// <param name="fileDescriptor">File descriptor of the file that will be read</param>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests</param>
+    /// <remarks>
+    ///   If this throws because the kernel rejected a submission, the ring should be
+    ///   discarded since it may still have submissions pointing to the caller's buffers.
+    /// </remarks>
+    public: void ReadMany(
+      int fileDescriptor, const Storage::ReadRequest *requests, std::size_t requestCount
+    );
+
+    /// <summary>Initializes a new, not yet set up io_uring wrapper</summary>
+    private: LinuxIoRing();
+
+    /// <summary>Submits the queued entries and waits for all of their completions</summary>
+    /// <param name="entryCount">Number of entries that have been queued</param>
+    /// <remarks>
+    ///   The result of each entry is stored in the <see cref="results" /> member at
+    ///   the index that was assigned to the entry as its user data.
+    /// </remarks>
+    private: void submitAndWait(std::size_t entryCount);
+
+    /// <summary>File descriptor of the io_uring instance</summary>
+    private: int ringFileDescriptor;
+    /// <summary>Memory of the submission queue ring</summary>
+    private: void *submissionRing;
+    /// <summary>Size of the submission queue ring in bytes</summary>
+    private: std::size_t submissionRingSize;
+    /// <summary>Memory of the completion queue ring</summary>
+    private: void *completionRing;
+    /// <summary>Size of the completion queue ring in bytes</summary>
+    private: std::size_t completionRingSize;
+    /// <summary>Array of submission queue entries</summary>
+    private: ::io_uring_sqe *submissionEntries;
+    /// <summary>Size of the submission queue entry array in bytes</summary>
+    private: std::size_t submissionEntriesSize;
+    /// <summary>Number of entries the submission queue can hold</summary>
+    private: std::uint32_t queueDepth;
+
+    /// <summary>Index at which the next submission will be queued</summary>
+    private: std::uint32_t *submissionTail;
+    /// <summary>Mask that turns a submission index into an array index</summary>
+    private: std::uint32_t submissionMask;
+    /// <summary>Indirection array mapping ring slots to submission entries</summary>
+    private: std::uint32_t *submissionArray;
+    /// <summary>Index of the next completion the kernel has delivered</summary>
+    private: std::uint32_t *completionHead;
+    /// <summary>Index after the last completion the kernel has delivered</summary>
+    private: std::uint32_t *completionTail;
+    /// <summary>Mask that turns a completion index into an array index</summary>
+    private: std::uint32_t completionMask;
+    /// <summary>Array of completion queue entries</summary>
+    private: ::io_uring_cqe *completionEntries;
+
+    /// <summary>I/O vectors referenced by the submitted reads</summary>
+    private: std::vector<::iovec> ioVectors;
+    /// <summary>Results of the reads in the current batch</summary>
+    private: std::vector<int> results;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_LINUX)
+
+#endif // NUCLEX_AUDIO_PLATFORM_LINUXIORING_H
@@ -110,6 +110,16 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  const OpusTags &OpusApi::GetTags(
+    const std::shared_ptr<::OggOpusFile> &opusFile, int linkIndex /* = -1 */
+  ) {
+    // Same as op_head(), op_tags() looks up an array with a clamped link index.
+    // Files without comments still have an (empty) OpusTags packet, it's mandatory.
+    return *::op_tags(opusFile.get(), linkIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t OpusApi::CountLinks(const std::shared_ptr<::OggOpusFile> &opusFile) {
     // Can't fail either, directly returns a structure member in the OggOpusfile struct.
     //
@@ -158,6 +168,21 @@ namespace Nuclex { namespace Audio { namespace Platform {
 #endif
   // ------------------------------------------------------------------------------------------- //
 
+  void OpusApi::SetGainOffset(
+    const std::shared_ptr<::OggOpusFile> &opusFile, int gainOffset
+  ) {
+    // libopusfile adds the offset to the header's output gain and clamps the sum
+    // to the range libopus accepts, so only an invalid gain type could fail here
+    int result = ::op_set_gain_offset(opusFile.get(), OP_HEADER_GAIN, gainOffset);
+    if(unlikely(result != 0)) {
+      std::string message(u8"Error setting the output gain of an Opus audio file: ", 53);
+      message.append(stringFromOpusFileErrorCode(result));
+      throw std::runtime_error(message);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void OpusApi::PcmSeek(
     const std::shared_ptr<::OggOpusFile> &opusFile,
     std::int64_t pcmOffset // This is a signed integer in in the opusfile API...
@@ -172,6 +197,57 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void OpusApi::RawSeek(
+    const std::shared_ptr<::OggOpusFile> &opusFile, std::uint64_t byteOffset
+  ) {
+    int result = ::op_raw_seek(opusFile.get(), static_cast<::opus_int64>(byteOffset));
+    if(unlikely(result != 0)) {
+      std::string message(u8"Error seeking to page within the Opus audio file: ", 50);
+      message.append(stringFromOpusFileErrorCode(result));
+      throw std::runtime_error(message);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OpusApi::TellPcm(const std::shared_ptr<::OggOpusFile> &opusFile) {
+    ::ogg_int64_t result = ::op_pcm_tell(opusFile.get());
+    if(unlikely(result < 0)) {
+      std::string message(u8"Error querying frame position within the Opus audio file: ", 58);
+      message.append(stringFromOpusFileErrorCode(static_cast<int>(result)));
+      throw std::runtime_error(message);
+    }
+
+    return static_cast<std::uint64_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OpusApi::TellRaw(const std::shared_ptr<::OggOpusFile> &opusFile) {
+    ::opus_int64 result = ::op_raw_tell(opusFile.get());
+    if(unlikely(result < 0)) {
+      std::string message(u8"Error querying file position within the Opus audio file: ", 57);
+      message.append(stringFromOpusFileErrorCode(static_cast<int>(result)));
+      throw std::runtime_error(message);
+    }
+
+    return static_cast<std::uint64_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusApi::SetDecodeCallback(
+    const std::shared_ptr<::OggOpusFile> &opusFile,
+    ::op_decode_cb_func callback, void *context
+  ) {
+    // Can't fail, only stores the function pointer and the context in the OggOpusFile.
+    //
+    // Last checked in libopusfile, opusfile.c in 2024
+    ::op_set_decode_callback(opusFile.get(), callback, context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t OpusApi::Read(
     const std::shared_ptr<::OggOpusFile> &opusFile,
     std::int16_t *buffer, int bufferSize,
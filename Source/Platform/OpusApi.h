@@ -82,6 +82,18 @@ namespace Nuclex { namespace Audio { namespace Platform {
       const std::shared_ptr<::OggOpusFile> &opusFile, int linkIndex = -1
     );
 
+    /// <summary>Retrieves the comment tags stored for an audio track</summary>
+    /// <param name="opusFile">Opened Opus audio file to retrieve the tags for</param>
+    /// <param name="linkIndex">Index of the link whose tags to retrieve, -1 for the current</param>
+    /// <returns>An OpusTags structure holding the Vorbis-style comments of the link</returns>
+    /// <remarks>
+    ///   Like the header, the OpusTags structure belongs to libopusfile and stays
+    ///   valid until other libopusfile operations are performed.
+    /// </remarks>
+    public: static const OpusTags &GetTags(
+      const std::shared_ptr<::OggOpusFile> &opusFile, int linkIndex = -1
+    );
+
     /// <summary>Counts the number of links in the OGG contianer</summary>
     /// <param name="opusFile">Opened Opus audio file to count the links in</param>
     /// <returns>The number of links on the OGG container</returns>
@@ -125,6 +137,13 @@ namespace Nuclex { namespace Audio { namespace Platform {
     );
     #endif
 
+    /// <summary>Sets a gain libopus applies on top of the output gain in the header</summary>
+    /// <param name="opusFile">Opened Opus audio file whose output gain will be adjusted</param>
+    /// <param name="gainOffset">Additional gain in 1/256 dB (Q7.8 format)</param>
+    public: static void SetGainOffset(
+      const std::shared_ptr<::OggOpusFile> &opusFile, int gainOffset
+    );
+
     /// <summary>Moves the file cursor to the specified frame location</summary>
     /// <param name="opusFile">Opened Opus audio file to perform the seek in</param>
     /// <param name="pcmOffset">Absolute offset of the frame to decode next</param>
@@ -133,6 +152,32 @@ namespace Nuclex { namespace Audio { namespace Platform {
       std::int64_t pcmOffset // This is a signed integer in in the opusfile API...
     );
 
+    /// <summary>Moves the file cursor to the Ogg page at the specified byte offset</summary>
+    /// <param name="opusFile">Opened Opus audio file to perform the seek in</param>
+    /// <param name="byteOffset">Offset of the page in the file</param>
+    public: static void RawSeek(
+      const std::shared_ptr<::OggOpusFile> &opusFile, std::uint64_t byteOffset
+    );
+
+    /// <summary>Determines the offset of the frame that will be decoded next</summary>
+    /// <param name="opusFile">Opened Opus audio file whose position will be queried</param>
+    /// <returns>The absolute offset of the frame that will be decoded next</returns>
+    public: static std::uint64_t TellPcm(const std::shared_ptr<::OggOpusFile> &opusFile);
+
+    /// <summary>Determines how far into the file libopusfile has read</summary>
+    /// <param name="opusFile">Opened Opus audio file whose position will be queried</param>
+    /// <returns>The byte offset up to which libopusfile has consumed the file</returns>
+    public: static std::uint64_t TellRaw(const std::shared_ptr<::OggOpusFile> &opusFile);
+
+    /// <summary>Lets the caller decode the Opus packets in place of libopusfile</summary>
+    /// <param name="opusFile">Opened Opus audio file whose packets will be handed out</param>
+    /// <param name="callback">Function that will be called to decode each packet</param>
+    /// <param name="context">Pointer that will be passed through to the callback</param>
+    public: static void SetDecodeCallback(
+      const std::shared_ptr<::OggOpusFile> &opusFile,
+      ::op_decode_cb_func callback, void *context
+    );
+
     /// <summary>Reads audio samples as 16-bit integers from an Opus file</summary>
     /// <param name="opusFile">Opened Opus audio file to read audio data from</param>
     /// <param name="buffer">Buffer that will receive the decoded audio samples</param>
@@ -54,6 +54,17 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Throws an exception for an error code returned by libopus</summary>
+  /// <param name="prefix">Description of what was attempted when the error happened</param>
+  /// <param name="errorCode">Error code libopus has returned</param>
+  [[noreturn]] void throwOpusError(const std::string &prefix, int errorCode) {
+    std::string message(prefix);
+    message.append(::opus_strerror(errorCode));
+    throw std::runtime_error(message);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Platform {
@@ -76,9 +87,9 @@ namespace Nuclex { namespace Audio { namespace Platform {
     const ::OpusEncCallbacks *callbacks,
     std::size_t sampleRate,
     std::size_t channelCount,
+    int mappingFamily,
     const std::shared_ptr<::OggOpusComments> comments /* = CreateComments() */
   ) {
-    int family = (channelCount < 3) ? 0 : 1; // 0 = stereo, 1 = surround
     int errorCode = 0;
 
     ::OggOpusEnc *opusEncoder = ::ope_encoder_create_callbacks(
@@ -87,7 +98,7 @@ namespace Nuclex { namespace Audio { namespace Platform {
       comments.get(),
       static_cast<::opus_int32>(sampleRate),
       static_cast<int>(channelCount),
-      family,
+      mappingFamily,
       &errorCode
     );
     if(unlikely(opusEncoder == nullptr)) {
@@ -129,6 +140,23 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void OpusEncoderApi::WriteIntegers(
+    const std::shared_ptr<::OggOpusEnc> &encoder,
+    const std::int16_t *samples,
+    std::size_t frameCount
+  ) {
+    int result = ::ope_encoder_write(
+      encoder.get(), reinterpret_cast<const ::opus_int16 *>(samples), static_cast<int>(frameCount)
+    );
+    if(unlikely(result != OPE_OK)) {
+      std::string message(u8"Error feeding audio samples to the Opus encoder: ", 49);
+      message.append(stringFromOpusEncErrorCode(result));
+      throw std::runtime_error(message);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void OpusEncoderApi::Drain(
     const std::shared_ptr<::OggOpusEnc> &encoder
   ) {
@@ -142,6 +170,114 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::shared_ptr<::OpusMSEncoder> OpusEncoderApi::CreatePacketEncoder(
+    std::size_t sampleRate,
+    std::size_t channelCount,
+    int mappingFamily,
+    int application,
+    int &streamCount,
+    int &coupledStreamCount,
+    unsigned char *mapping
+  ) {
+    int errorCode = OPUS_OK;
+
+    // The surround variant picks the stream layout for the mapping family by itself,
+    // which is exactly what libopusenc does for Ogg Opus files, too
+    ::OpusMSEncoder *opusEncoder = ::opus_multistream_surround_encoder_create(
+      static_cast<::opus_int32>(sampleRate),
+      static_cast<int>(channelCount),
+      mappingFamily,
+      &streamCount,
+      &coupledStreamCount,
+      mapping,
+      application,
+      &errorCode
+    );
+    if(unlikely((opusEncoder == nullptr) || (errorCode != OPUS_OK))) {
+      throwOpusError(u8"Error creating a new Opus packet encoder: ", errorCode);
+    }
+
+    return std::shared_ptr<::OpusMSEncoder>(opusEncoder, &::opus_multistream_encoder_destroy);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusEncoderApi::ControlPacketEncoder(
+    const std::shared_ptr<::OpusMSEncoder> &encoder, int request, int value
+  ) {
+    int result = ::opus_multistream_encoder_ctl(encoder.get(), request, value);
+    if(unlikely(result != OPUS_OK)) {
+      throwOpusError(u8"Error sending Opus packet encoder control message: ", result);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusEncoderApi::ResetPacketEncoder(const std::shared_ptr<::OpusMSEncoder> &encoder) {
+    int result = ::opus_multistream_encoder_ctl(encoder.get(), OPUS_RESET_STATE);
+    if(unlikely(result != OPUS_OK)) {
+      throwOpusError(u8"Error resetting the Opus packet encoder: ", result);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusEncoderApi::GetPacketEncoderLookahead(
+    const std::shared_ptr<::OpusMSEncoder> &encoder
+  ) {
+    ::opus_int32 lookahead = 0;
+    int result = ::opus_multistream_encoder_ctl(encoder.get(), OPUS_GET_LOOKAHEAD(&lookahead));
+    if(unlikely(result != OPUS_OK)) {
+      throwOpusError(u8"Error querying the lookahead of the Opus packet encoder: ", result);
+    }
+
+    return static_cast<std::size_t>(lookahead);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusEncoderApi::EncodePacketFloats(
+    const std::shared_ptr<::OpusMSEncoder> &encoder,
+    const float *samples, std::size_t frameCount,
+    std::byte *packet, std::size_t packetCapacity
+  ) {
+    ::opus_int32 result = ::opus_multistream_encode_float(
+      encoder.get(),
+      samples,
+      static_cast<int>(frameCount),
+      reinterpret_cast<unsigned char *>(packet),
+      static_cast<::opus_int32>(packetCapacity)
+    );
+    if(unlikely(result < 0)) {
+      throwOpusError(u8"Error encoding an Opus packet: ", static_cast<int>(result));
+    }
+
+    return static_cast<std::size_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusEncoderApi::EncodePacketIntegers(
+    const std::shared_ptr<::OpusMSEncoder> &encoder,
+    const std::int16_t *samples, std::size_t frameCount,
+    std::byte *packet, std::size_t packetCapacity
+  ) {
+    ::opus_int32 result = ::opus_multistream_encode(
+      encoder.get(),
+      reinterpret_cast<const ::opus_int16 *>(samples),
+      static_cast<int>(frameCount),
+      reinterpret_cast<unsigned char *>(packet),
+      static_cast<::opus_int32>(packetCapacity)
+    );
+    if(unlikely(result < 0)) {
+      throwOpusError(u8"Error encoding an Opus packet: ", static_cast<int>(result));
+    }
+
+    return static_cast<std::size_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Platform
 
 #endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
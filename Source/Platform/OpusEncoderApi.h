@@ -27,9 +27,11 @@ limitations under the License.
 #include <string> // for std::string
 #include <memory> // for std::shared_ptr
 #include <vector> // for std::vector
-#include <cstdint> // for std::uint32_t
+#include <cstdint> // for std::uint32_t, std::int16_t
+#include <cstddef> // for std::byte
 
 #include <opusenc.h> // for Opus (or rather, the opusenc wrapper library)
+#include <opus_multistream.h> // for the raw multistream encoder from libopus
 
 namespace Nuclex { namespace Audio { namespace Platform {
 
@@ -47,6 +49,7 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <param name="callbacks">Callbacks through which file accesses will happen</param>
     /// <param name="sampleRate">Intended playback speed in samples per second</param>
     /// <param name="channelCount">Number of channels to be encoded</param>
+    /// <param name="mappingFamily">Opus channel mapping family the channels use</param>
     /// <param name="comments">An Ogg/Opus comment block with metadata to write</param>
     /// <returns>
     ///   A shared pointer to the Opus encoder which can be fed with audio data that
@@ -61,6 +64,7 @@ namespace Nuclex { namespace Audio { namespace Platform {
       const ::OpusEncCallbacks *callbacks,
       std::size_t sampleRate,
       std::size_t channelCount,
+      int mappingFamily,
       const std::shared_ptr<::OggOpusComments> comments = CreateComments()
     );
 
@@ -80,10 +84,90 @@ namespace Nuclex { namespace Audio { namespace Platform {
       const std::shared_ptr<::OggOpusEnc> &encoder, const float *samples, std::size_t frameCount
     );
 
+    /// <summary>Feeds the encoder raw 16-bit integer audio samples to encode</summary>
+    /// <param name="encoder">Encoder that will be fed the audio samples</param>
+    /// <param name="samples">Buffer holding the samples to be fed</param>
+    /// <param name="frameCount">Number of frames stored in the buffer</param>
+    public: static void WriteIntegers(
+      const std::shared_ptr<::OggOpusEnc> &encoder,
+      const std::int16_t *samples,
+      std::size_t frameCount
+    );
+
     /// <summary>Processes any remaining samples lingering in the encoders buffers</summary>
     /// <param name="encoder">Encoder whose buffered samples should be processed</param>
     public: static void Drain(const std::shared_ptr<::OggOpusEnc> &encoder);
 
+    /// <summary>Creates a libopus encoder that produces raw Opus packets</summary>
+    /// <param name="sampleRate">Sample rate of the audio that will be encoded</param>
+    /// <param name="channelCount">Number of channels that will be encoded</param>
+    /// <param name="mappingFamily">Opus channel mapping family the channels use</param>
+    /// <param name="application">Intended application, i.e. OPUS_APPLICATION_VOIP</param>
+    /// <param name="streamCount">Receives the number of Opus streams in each packet</param>
+    /// <param name="coupledStreamCount">Receives the number of stereo streams</param>
+    /// <param name="mapping">
+    ///   Receives the stream channel each output channel is taken from, must have room
+    ///   for one byte per channel
+    /// </param>
+    /// <returns>
+    ///   A shared pointer to the Opus encoder which has a custom deleter set up that
+    ///   destroys the encoder when the pointer goes out of scope
+    /// </returns>
+    public: static std::shared_ptr<::OpusMSEncoder> CreatePacketEncoder(
+      std::size_t sampleRate,
+      std::size_t channelCount,
+      int mappingFamily,
+      int application,
+      int &streamCount,
+      int &coupledStreamCount,
+      unsigned char *mapping
+    );
+
+    /// <summary>Sends a control message with an integer argument to a packet encoder</summary>
+    /// <param name="encoder">Encoder to which the control message is being sent</param>
+    /// <param name="request">Identifier of the control message</param>
+    /// <param name="value">Integer value to pass along with the control message</param>
+    public: static void ControlPacketEncoder(
+      const std::shared_ptr<::OpusMSEncoder> &encoder, int request, int value
+    );
+
+    /// <summary>Makes a packet encoder forget everything from earlier packets</summary>
+    /// <param name="encoder">Encoder that will be reset</param>
+    public: static void ResetPacketEncoder(const std::shared_ptr<::OpusMSEncoder> &encoder);
+
+    /// <summary>Queries the number of frames a packet encoder delays its input by</summary>
+    /// <param name="encoder">Encoder whose lookahead will be queried</param>
+    /// <returns>The encoder's lookahead in frames at the encoder's sample rate</returns>
+    public: static std::size_t GetPacketEncoderLookahead(
+      const std::shared_ptr<::OpusMSEncoder> &encoder
+    );
+
+    /// <summary>Encodes interleaved floating point samples into a single Opus packet</summary>
+    /// <param name="encoder">Encoder that will encode the samples</param>
+    /// <param name="samples">Buffer holding the samples of the packet</param>
+    /// <param name="frameCount">Number of frames in the packet, a valid Opus duration</param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The length of the encoded packet in bytes</returns>
+    public: static std::size_t EncodePacketFloats(
+      const std::shared_ptr<::OpusMSEncoder> &encoder,
+      const float *samples, std::size_t frameCount,
+      std::byte *packet, std::size_t packetCapacity
+    );
+
+    /// <summary>Encodes interleaved 16-bit integer samples into a single Opus packet</summary>
+    /// <param name="encoder">Encoder that will encode the samples</param>
+    /// <param name="samples">Buffer holding the samples of the packet</param>
+    /// <param name="frameCount">Number of frames in the packet, a valid Opus duration</param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The length of the encoded packet in bytes</returns>
+    public: static std::size_t EncodePacketIntegers(
+      const std::shared_ptr<::OpusMSEncoder> &encoder,
+      const std::int16_t *samples, std::size_t frameCount,
+      std::byte *packet, std::size_t packetCapacity
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -27,7 +27,8 @@ limitations under the License.
 #include "PosixApi.h"
 #include <Nuclex/Support/Errors/FileAccessError.h> // for FileAccessError
 
-#include <cstdio> // for fopen() and fclose()
+#include <cstdio> // for fopen(), fclose() and rename()
+#include <sys/stat.h> // for ::stat()
 #include <cerrno> // To access ::errno directly
 #include <cassert> // for assert()
 
@@ -158,6 +159,48 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool PosixFileApi::TryStatFile(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+    struct stat fileStatus;
+
+    int failed = ::stat(path.c_str(), &fileStatus);
+    if(unlikely(failed)) {
+      return false;
+    }
+
+    size = static_cast<std::uint64_t>(fileStatus.st_size);
+#if defined(NUCLEX_AUDIO_LINUX)
+    modificationTime = (
+      static_cast<std::uint64_t>(fileStatus.st_mtim.tv_sec) * 1000000000ULL +
+      static_cast<std::uint64_t>(fileStatus.st_mtim.tv_nsec)
+    );
+#else
+    modificationTime = static_cast<std::uint64_t>(fileStatus.st_mtime) * 1000000000ULL;
+#endif
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PosixFileApi::ReplaceFile(const std::string &sourcePath, const std::string &targetPath) {
+    int result = ::rename(sourcePath.c_str(), targetPath.c_str());
+    if(unlikely(result != 0)) {
+      int errorNumber = errno;
+
+      std::string errorMessage(u8"Could not move file '");
+      errorMessage.append(sourcePath);
+      errorMessage.append(u8"' over '");
+      errorMessage.append(targetPath);
+      errorMessage.append(u8"'");
+
+      ThrowExceptionForFileAccessError(errorMessage, errorNumber);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void PosixFileApi::ThrowExceptionForFileAccessError(
     const std::string &errorMessage, int errorNumber
   ) {
@@ -90,6 +90,26 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <returns>The current position of the file cursor in bytes from the beginning</returns>
     public: static std::uint64_t Tell(FILE *file);
 
+    /// <summary>Looks up the size and last modification time of a file</summary>
+    /// <param name="path">Path of the file whose status will be looked up</param>
+    /// <param name="size">Receives the size of the file in bytes</param>
+    /// <param name="modificationTime">
+    ///   Receives the time of the last modification in nanoseconds since the epoch
+    /// </param>
+    /// <returns>True if the file exists and its status could be looked up</returns>
+    public: static bool TryStatFile(
+      const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+    );
+
+    /// <summary>Moves a file over another one, replacing it in a single step</summary>
+    /// <param name="sourcePath">Path of the file that will be moved</param>
+    /// <param name="targetPath">Path the file will be moved to</param>
+    /// <remarks>
+    ///   Both paths must be on the same file system. Readers that open the target
+    ///   see either the old or the new file, never a partially written one.
+    /// </remarks>
+    public: static void ReplaceFile(const std::string &sourcePath, const std::string &targetPath);
+
     /// <summary>Throws the appropriate exception for an error reported by the OS</summary>
     /// <param name="errorMessage">
     ///   Error message that should be included in the exception, will be prefixed to
@@ -0,0 +1,267 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "ProcessorTopology.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "WindowsApi.h"
+#elif defined(NUCLEX_AUDIO_LINUX)
+#include <sched.h> // for sched_setaffinity(), cpu_set_t
+#include <fstream> // for std::ifstream
+#include <string> // for std::string
+#endif
+
+#include <algorithm> // for std::max()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <thread> // for std::thread
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reports all processors as belonging to one node</summary>
+  /// <returns>A single node holding one processor per hardware thread</returns>
+  std::vector<std::vector<std::size_t>> getSingleNode() {
+    std::size_t processorCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::vector<std::vector<std::size_t>> nodes(1);
+    nodes[0].reserve(processorCount);
+    for(std::size_t index = 0; index < processorCount; ++index) {
+      nodes[0].push_back(index);
+    }
+
+    return nodes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_LINUX)
+  /// <summary>Parses a Linux CPU list such as '0-3,8-11' into processor indices</summary>
+  /// <param name="cpuList">CPU list as found in the sysfs node directories</param>
+  /// <returns>The indices of all processors in the list</returns>
+  std::vector<std::size_t> parseCpuList(const std::string &cpuList) {
+    std::vector<std::size_t> processors;
+
+    std::string::size_type start = 0;
+    while(start < cpuList.length()) {
+      std::string::size_type end = cpuList.find(',', start);
+      if(end == std::string::npos) {
+        end = cpuList.length();
+      }
+
+      std::string range = cpuList.substr(start, end - start);
+      std::string::size_type dashIndex = range.find('-');
+      try {
+        if(dashIndex == std::string::npos) {
+          processors.push_back(static_cast<std::size_t>(std::stoul(range)));
+        } else {
+          std::size_t first = static_cast<std::size_t>(std::stoul(range.substr(0, dashIndex)));
+          std::size_t last = static_cast<std::size_t>(std::stoul(range.substr(dashIndex + 1)));
+          for(std::size_t index = first; index <= last; ++index) {
+            processors.push_back(index);
+          }
+        }
+      }
+      catch(const std::logic_error &) {} // Malformed entry, ignore it
+
+      start = end + 1;
+    }
+
+    return processors;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a Linux cache size such as '48K' into a byte count</summary>
+  /// <param name="cacheSize">Cache size as found in the sysfs cache directories</param>
+  /// <returns>The number of bytes or zero if the size could not be parsed</returns>
+  std::size_t parseCacheSize(const std::string &cacheSize) {
+    std::size_t unitIndex = 0;
+    std::size_t byteCount;
+    try {
+      byteCount = static_cast<std::size_t>(std::stoul(cacheSize, &unitIndex));
+    }
+    catch(const std::logic_error &) {
+      return 0;
+    }
+
+    if(unitIndex < cacheSize.length()) {
+      if(cacheSize[unitIndex] == 'K') {
+        byteCount *= 1024;
+      } else if(cacheSize[unitIndex] == 'M') {
+        byteCount *= 1024 * 1024;
+      }
+    }
+
+    return byteCount;
+  }
+#endif // defined(NUCLEX_AUDIO_LINUX)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ProcessorTopology::GetDataCacheSize(std::size_t level) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    DWORD byteCount = 0;
+    ::GetLogicalProcessorInformation(nullptr, &byteCount);
+    if(byteCount == 0) {
+      return 0;
+    }
+
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> informations(
+      byteCount / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)
+    );
+    if(::GetLogicalProcessorInformation(informations.data(), &byteCount) == FALSE) {
+      return 0;
+    }
+
+    for(const SYSTEM_LOGICAL_PROCESSOR_INFORMATION &information : informations) {
+      bool isMatchingCache = (
+        (information.Relationship == RelationCache) &&
+        (information.Cache.Level == level) &&
+        (information.Cache.Type != CacheInstruction)
+      );
+      if(isMatchingCache) {
+        return static_cast<std::size_t>(information.Cache.Size);
+      }
+    }
+#elif defined(NUCLEX_AUDIO_LINUX)
+    // Each cache the processor sees has its own index directory that states
+    // the cache's level and type. The L1 cache usually has separate entries for
+    // instructions and data, so the instruction cache must be skipped.
+    for(std::size_t index = 0; index < 16; ++index) {
+      std::string cacheDirectory = (
+        u8"/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + u8"/"
+      );
+
+      std::ifstream levelFile(cacheDirectory + u8"level");
+      if(!levelFile.is_open()) {
+        break;
+      }
+      std::size_t cacheLevel = 0;
+      levelFile >> cacheLevel;
+      if(cacheLevel != level) {
+        continue;
+      }
+
+      std::string cacheType;
+      std::ifstream typeFile(cacheDirectory + u8"type");
+      std::getline(typeFile, cacheType);
+      if(cacheType == u8"Instruction") {
+        continue;
+      }
+
+      std::string cacheSize;
+      std::ifstream sizeFile(cacheDirectory + u8"size");
+      std::getline(sizeFile, cacheSize);
+      return parseCacheSize(cacheSize);
+    }
+#else
+    (void)level;
+#endif
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::vector<std::size_t>> ProcessorTopology::GetProcessorsByNode() {
+    std::vector<std::vector<std::size_t>> nodes;
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    ULONG highestNodeNumber = 0;
+    if(::GetNumaHighestNodeNumber(&highestNodeNumber) != FALSE) {
+      for(ULONG nodeIndex = 0; nodeIndex <= highestNodeNumber; ++nodeIndex) {
+        GROUP_AFFINITY affinity;
+        if(::GetNumaNodeProcessorMaskEx(static_cast<USHORT>(nodeIndex), &affinity) == FALSE) {
+          continue;
+        }
+
+        std::vector<std::size_t> processors;
+        for(std::size_t bitIndex = 0; bitIndex < sizeof(KAFFINITY) * 8; ++bitIndex) {
+          if((affinity.Mask & (static_cast<KAFFINITY>(1) << bitIndex)) != 0) {
+            processors.push_back(affinity.Group * sizeof(KAFFINITY) * 8 + bitIndex);
+          }
+        }
+        if(!processors.empty()) {
+          nodes.push_back(std::move(processors));
+        }
+      }
+    }
+#elif defined(NUCLEX_AUDIO_LINUX)
+    // Node numbers can have gaps (nodes without memory or processors are hidden),
+    // but are small, so just probe a generous range of them
+    for(std::size_t nodeIndex = 0; nodeIndex < 1024; ++nodeIndex) {
+      std::ifstream cpuListFile(
+        u8"/sys/devices/system/node/node" + std::to_string(nodeIndex) + u8"/cpulist"
+      );
+      if(!cpuListFile.is_open()) {
+        continue;
+      }
+
+      std::string cpuList;
+      std::getline(cpuListFile, cpuList);
+      std::vector<std::size_t> processors = parseCpuList(cpuList);
+      if(!processors.empty()) {
+        nodes.push_back(std::move(processors));
+      }
+    }
+#endif
+
+    if(nodes.empty()) {
+      return getSingleNode();
+    } else {
+      return nodes;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ProcessorTopology::TryPinCurrentThread(std::size_t processorIndex) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    GROUP_AFFINITY affinity = GROUP_AFFINITY();
+    affinity.Group = static_cast<WORD>(processorIndex / (sizeof(KAFFINITY) * 8));
+    affinity.Mask = static_cast<KAFFINITY>(1) << (processorIndex % (sizeof(KAFFINITY) * 8));
+    return (::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr) != FALSE);
+#elif defined(NUCLEX_AUDIO_LINUX)
+    if(processorIndex >= CPU_SETSIZE) {
+      return false;
+    }
+
+    cpu_set_t processorSet;
+    CPU_ZERO(&processorSet);
+    CPU_SET(processorIndex, &processorSet);
+    return (::sched_setaffinity(0, sizeof(processorSet), &processorSet) == 0);
+#else
+    (void)processorIndex;
+    return false; // macOS and others only offer affinity hints, not pinning
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
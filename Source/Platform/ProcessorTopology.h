@@ -0,0 +1,65 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PLATFORM_PROCESSORTOPOLOGY_H
+#define NUCLEX_AUDIO_PLATFORM_PROCESSORTOPOLOGY_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up which processors belong to which NUMA node and pins threads</summary>
+  class ProcessorTopology {
+
+    /// <summary>Looks up the size of the data cache at the specified level</summary>
+    /// <param name="level">Cache level, 1 for the L1 data cache, 2 for the L2 cache</param>
+    /// <returns>
+    ///   The size of the cache in bytes, as seen by the first processor, or zero if
+    ///   the cache doesn't exist or its size can't be determined
+    /// </returns>
+    public: static std::size_t GetDataCacheSize(std::size_t level);
+
+    /// <summary>Lists the logical processors of each NUMA node</summary>
+    /// <returns>
+    ///   One list of processor indices per node that has processors. Systems without NUMA,
+    ///   or where the topology can't be determined, are reported as a single node.
+    /// </returns>
+    public: static std::vector<std::vector<std::size_t>> GetProcessorsByNode();
+
+    /// <summary>Restricts the calling thread to run on a single logical processor</summary>
+    /// <param name="processorIndex">Index of the processor the thread will run on</param>
+    /// <returns>True if the thread was pinned, false if the system doesn't allow it</returns>
+    /// <remarks>
+    ///   Memory the thread touches first after being pinned will be allocated on the
+    ///   processor's node by Linux and Windows, both of which use first-touch placement.
+    /// </remarks>
+    public: static bool TryPinCurrentThread(std::size_t processorIndex);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // NUCLEX_AUDIO_PLATFORM_PROCESSORTOPOLOGY_H
@@ -117,6 +117,25 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t VorbisApi::GetLongBlockSize(
+    const std::shared_ptr<::OggVorbis_File> &vorbisFile,
+    int streamIndex /* = -1 */
+  ) {
+    ::vorbis_info *info = ::ov_info(vorbisFile.get(), streamIndex);
+    if(unlikely(info == nullptr)) {
+      throw std::runtime_error(u8"Could not obtain Vorbis information read from audio file");
+    }
+
+    int blockSize = ::vorbis_info_blocksize(info, 1);
+    if(unlikely(blockSize <= 0)) {
+      throw std::runtime_error(u8"Could not determine block size of Vorbis stream");
+    }
+
+    return static_cast<std::size_t>(blockSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   const ::vorbis_comment &VorbisApi::GetComments(
     const std::shared_ptr<::OggVorbis_File> &vorbisFile,
     int streamIndex /* = -1 */
@@ -163,6 +182,55 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisApi::RawSeek(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::OggVorbis_File> &vorbisFile,
+    std::uint64_t byteOffset
+  ) {
+    int result = ::ov_raw_seek(vorbisFile.get(), static_cast<::ogg_int64_t>(byteOffset));
+    if(unlikely(result != 0)) {
+
+      // If something happened reading from the virtual file, that is the root cause
+      // exception and will be reported above whatever error it caused in libvorbisfile.
+      if(unlikely(static_cast<bool>(rootCauseException))) {
+        std::rethrow_exception(rootCauseException);
+      }
+
+      std::string message(u8"Error seeking to page in virtual file via libvorbisfile: ", 57);
+      message.append(stringFromVorbisFileErrorCode(result));
+      throw std::runtime_error(message);
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t VorbisApi::TellPcm(const std::shared_ptr<::OggVorbis_File> &vorbisFile) {
+    ::ogg_int64_t result = ::ov_pcm_tell(vorbisFile.get());
+    if(unlikely(result < 0)) {
+      std::string message(u8"Error querying sample position via libvorbisfile: ", 50);
+      message.append(stringFromVorbisFileErrorCode(static_cast<int>(result)));
+      throw std::runtime_error(message);
+    }
+
+    return static_cast<std::uint64_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t VorbisApi::TellRaw(const std::shared_ptr<::OggVorbis_File> &vorbisFile) {
+    ::ogg_int64_t result = ::ov_raw_tell(vorbisFile.get());
+    if(unlikely(result < 0)) {
+      std::string message(u8"Error querying file position via libvorbisfile: ", 48);
+      message.append(stringFromVorbisFileErrorCode(static_cast<int>(result)));
+      throw std::runtime_error(message);
+    }
+
+    return static_cast<std::uint64_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t VorbisApi::ReadFloat(
     const std::exception_ptr &rootCauseException,
     const std::shared_ptr<::OggVorbis_File> &vorbisFile,
@@ -81,6 +81,15 @@ namespace Nuclex { namespace Audio { namespace Platform {
       int streamIndex = -1
     );
 
+    /// <summary>Looks up the size of the long blocks a Vorbis stream is encoded in</summary>
+    /// <param name="vorbisFile">Opened Vorbis file to retrieve the block size from</param>
+    /// <param name="streamIndex">Index of the stream whose block size to retrieve</param>
+    /// <returns>The number of samples covered by a long block in the stream</returns>
+    public: static std::size_t GetLongBlockSize(
+      const std::shared_ptr<::OggVorbis_File> &vorbisFile,
+      int streamIndex = -1
+    );
+
     /// <summary>Looks up the comment structure in a Vorbis file</summary>
     /// <param name="vorbisFile">Opened Vorbis file to retrieve the comments from</param>
     /// <param name="streamIndex">Index of the stream whose comments to retrieve</param>
@@ -114,6 +123,30 @@ namespace Nuclex { namespace Audio { namespace Platform {
       ::ogg_int64_t sampleIndex
     );
 
+    /// <summary>Seeks to the Ogg page at the specified byte offset</summary>
+    /// <param name="rootCauseException">
+    ///   Captured exception pointer that will be rethrown in place of the libvorbisfile error
+    ///   if something goes wrong. This allows proper error reporting if a fault occurrs
+    ///   in a callback that is invoked by libvorbisfile.
+    /// </param>
+    /// <param name="vorbisFile">Opened Vorbis file in which to seek</param>
+    /// <param name="byteOffset">Offset of the page in the file</param>
+    public: static void RawSeek(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::OggVorbis_File> &vorbisFile,
+      std::uint64_t byteOffset
+    );
+
+    /// <summary>Determines the index of the sample that will be decoded next</summary>
+    /// <param name="vorbisFile">Opened Vorbis file whose position will be queried</param>
+    /// <returns>The index of the sample that will be decoded next</returns>
+    public: static std::uint64_t TellPcm(const std::shared_ptr<::OggVorbis_File> &vorbisFile);
+
+    /// <summary>Determines how far into the file libvorbisfile has read</summary>
+    /// <param name="vorbisFile">Opened Vorbis file whose position will be queried</param>
+    /// <returns>The byte offset up to which libvorbisfile has consumed the file</returns>
+    public: static std::uint64_t TellRaw(const std::shared_ptr<::OggVorbis_File> &vorbisFile);
+
     /// <summary>Decodes a block of samples from the Vorbis audio file</summary>
     /// <param name="rootCauseException">
     ///   Captured exception pointer that will be rethrown in place of the libvorbisfile error
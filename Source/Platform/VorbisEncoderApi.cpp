@@ -0,0 +1,262 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "VorbisEncoderApi.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns an error message matching the specified libvorbis error code</summary>
+  /// <param name="errorCode">Error code for which an error message will be returned</param>
+  /// <returns>A string stating the error indicated by the error code</returns>
+  std::string stringFromVorbisErrorCode(int errorCode) {
+    switch(errorCode) {
+      case OV_EFAULT: { return u8"Internal library error, out of memory or null pointer"; }
+      case OV_EIMPL: { return u8"Requested mode is not supported by the encoder"; }
+      case OV_EINVAL: { return u8"Function called with invalid parameters"; }
+      default: { return u8"An unspecified error occurred"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a libvorbis call has reported an error</summary>
+  /// <param name="errorCode">Result returned by the libvorbis function</param>
+  /// <param name="message">Message that will be prepended to the error description</param>
+  void requireSuccess(int errorCode, const char *message) {
+    if(unlikely(errorCode < 0)) {
+      std::string combinedMessage(message);
+      combinedMessage.append(stringFromVorbisErrorCode(errorCode));
+      throw std::runtime_error(combinedMessage);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::vorbis_info> VorbisEncoderApi::CreateInfoForVariableBitrate(
+    std::size_t channelCount, std::size_t sampleRate, float quality
+  ) {
+    std::shared_ptr<::vorbis_info> info(
+      new ::vorbis_info(),
+      [](::vorbis_info *info) { ::vorbis_info_clear(info); delete info; }
+    );
+    ::vorbis_info_init(info.get());
+
+    int result = ::vorbis_encode_init_vbr(
+      info.get(), static_cast<long>(channelCount), static_cast<long>(sampleRate), quality
+    );
+    requireSuccess(result, u8"Error setting up libvorbisenc for variable bitrate: ");
+
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::vorbis_comment> VorbisEncoderApi::CreateComment() {
+    std::shared_ptr<::vorbis_comment> comment(
+      new ::vorbis_comment(),
+      [](::vorbis_comment *comment) { ::vorbis_comment_clear(comment); delete comment; }
+    );
+
+    // No error return (confirmed via info.c in 2024)
+    ::vorbis_comment_init(comment.get());
+
+    return comment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::vorbis_dsp_state> VorbisEncoderApi::CreateAnalysisState(
+    const std::shared_ptr<::vorbis_info> &info
+  ) {
+    std::unique_ptr<::vorbis_dsp_state> analysisState = std::make_unique<::vorbis_dsp_state>();
+
+    int result = ::vorbis_analysis_init(analysisState.get(), info.get());
+    if(unlikely(result != 0)) {
+      throw std::runtime_error(u8"Error setting up the libvorbis analysis state");
+    }
+
+    // The analysis state refers to the stream settings, the deleter keeps them alive
+    return std::shared_ptr<::vorbis_dsp_state>(
+      analysisState.release(),
+      [info](::vorbis_dsp_state *analysisState) {
+        ::vorbis_dsp_clear(analysisState);
+        delete analysisState;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::vorbis_block> VorbisEncoderApi::CreateBlock(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState
+  ) {
+    std::unique_ptr<::vorbis_block> block = std::make_unique<::vorbis_block>();
+
+    int result = ::vorbis_block_init(analysisState.get(), block.get());
+    if(unlikely(result != 0)) {
+      throw std::runtime_error(u8"Error setting up a libvorbis analysis block");
+    }
+
+    // The block refers to the analysis state, the deleter keeps it alive
+    return std::shared_ptr<::vorbis_block>(
+      block.release(),
+      [analysisState](::vorbis_block *block) {
+        ::vorbis_block_clear(block);
+        delete block;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisEncoderApi::CreateHeaders(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState,
+    const std::shared_ptr<::vorbis_comment> &comment,
+    ::ogg_packet &identification, ::ogg_packet &comments, ::ogg_packet &codebooks
+  ) {
+    int result = ::vorbis_analysis_headerout(
+      analysisState.get(), comment.get(), &identification, &comments, &codebooks
+    );
+    requireSuccess(result, u8"Error generating Vorbis stream headers: ");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float **VorbisEncoderApi::GetAnalysisBuffer(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState, std::size_t frameCount
+  ) {
+    float **buffers = ::vorbis_analysis_buffer(
+      analysisState.get(), static_cast<int>(frameCount)
+    );
+    if(unlikely(buffers == nullptr)) {
+      throw std::runtime_error(u8"Could not obtain analysis buffers from libvorbis");
+    }
+
+    return buffers;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisEncoderApi::SubmitAnalysisBuffer(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState, std::size_t frameCount
+  ) {
+    int result = ::vorbis_analysis_wrote(analysisState.get(), static_cast<int>(frameCount));
+    requireSuccess(result, u8"Error submitting samples to libvorbis: ");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VorbisEncoderApi::TakeBlock(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState,
+    const std::shared_ptr<::vorbis_block> &block
+  ) {
+    int result = ::vorbis_analysis_blockout(analysisState.get(), block.get());
+    requireSuccess(result, u8"Error taking an analysis block from libvorbis: ");
+
+    return (result == 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisEncoderApi::AnalyzeBlock(const std::shared_ptr<::vorbis_block> &block) {
+
+    // Passing no packet makes libvorbis hand the result to the bitrate manager,
+    // where it can be picked up via vorbis_bitrate_flushpacket()
+    int result = ::vorbis_analysis(block.get(), nullptr);
+    requireSuccess(result, u8"Error encoding audio block via libvorbis: ");
+
+    result = ::vorbis_bitrate_addblock(block.get());
+    requireSuccess(result, u8"Error handing encoded block to the libvorbis bitrate manager: ");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VorbisEncoderApi::TakePacket(
+    const std::shared_ptr<::vorbis_dsp_state> &analysisState, ::ogg_packet &packet
+  ) {
+    int result = ::vorbis_bitrate_flushpacket(analysisState.get(), &packet);
+    requireSuccess(result, u8"Error taking an encoded packet from libvorbis: ");
+
+    return (result == 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::ogg_stream_state> VorbisEncoderApi::CreateOggStream(int serialNumber) {
+    std::unique_ptr<::ogg_stream_state> oggStream = std::make_unique<::ogg_stream_state>();
+
+    int result = ::ogg_stream_init(oggStream.get(), serialNumber);
+    if(unlikely(result != 0)) {
+      throw std::runtime_error(u8"Error setting up an Ogg stream via libogg");
+    }
+
+    return std::shared_ptr<::ogg_stream_state>(
+      oggStream.release(),
+      [](::ogg_stream_state *oggStream) {
+        ::ogg_stream_clear(oggStream);
+        delete oggStream;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisEncoderApi::SubmitPacket(
+    const std::shared_ptr<::ogg_stream_state> &oggStream, ::ogg_packet &packet
+  ) {
+    int result = ::ogg_stream_packetin(oggStream.get(), &packet);
+    if(unlikely(result != 0)) {
+      throw std::runtime_error(u8"Error adding a packet to the Ogg stream via libogg");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VorbisEncoderApi::TakePage(
+    const std::shared_ptr<::ogg_stream_state> &oggStream, ::ogg_page &page, bool force
+  ) {
+    // No error return, zero means no page is ready (confirmed via framing.c in 2024)
+    if(force) {
+      return (::ogg_stream_flush(oggStream.get(), &page) != 0);
+    } else {
+      return (::ogg_stream_pageout(oggStream.get(), &page) != 0);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
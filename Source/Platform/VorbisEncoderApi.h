@@ -0,0 +1,154 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PLATFORM_VORBISENCODERAPI_H
+#define NUCLEX_AUDIO_PLATFORM_VORBISENCODERAPI_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include <memory> // for std::shared_ptr
+#include <cstddef> // for std::size_t
+
+#include <vorbis/vorbisenc.h> // for the Vorbis encoder
+#include <ogg/ogg.h> // for the Ogg stream packer
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps the libvorbisenc and libogg packing APIs with error checking</summary>
+  /// <remarks>
+  ///   All the create methods return shared pointers with custom deleters that clear
+  ///   and free the respective libvorbis or libogg structure. Structures depending on
+  ///   other structures keep those alive through their deleters.
+  /// </remarks>
+  class VorbisEncoderApi {
+
+    /// <summary>Sets up the stream settings for variable bitrate encoding</summary>
+    /// <param name="channelCount">Number of audio channels that will be encoded</param>
+    /// <param name="sampleRate">Playback rate in samples per second</param>
+    /// <param name="quality">Quality level from -0.1 (lowest) to 1.0 (highest)</param>
+    /// <returns>The initialized stream settings</returns>
+    public: static std::shared_ptr<::vorbis_info> CreateInfoForVariableBitrate(
+      std::size_t channelCount, std::size_t sampleRate, float quality
+    );
+
+    /// <summary>Creates an empty set of comments (metadata tags)</summary>
+    /// <returns>The new, empty set of comments</returns>
+    public: static std::shared_ptr<::vorbis_comment> CreateComment();
+
+    /// <summary>Creates the analysis state that does the actual encoding work</summary>
+    /// <param name="info">Stream settings the encoder will use</param>
+    /// <returns>The new analysis state</returns>
+    public: static std::shared_ptr<::vorbis_dsp_state> CreateAnalysisState(
+      const std::shared_ptr<::vorbis_info> &info
+    );
+
+    /// <summary>Creates a block that the analysis state can hand out audio data in</summary>
+    /// <param name="analysisState">Analysis state the block will be used with</param>
+    /// <returns>The new block</returns>
+    public: static std::shared_ptr<::vorbis_block> CreateBlock(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState
+    );
+
+    /// <summary>Generates the three header packets every Vorbis stream begins with</summary>
+    /// <param name="analysisState">Analysis state for which headers will be generated</param>
+    /// <param name="comment">Comments that will be stored in the comment header</param>
+    /// <param name="identification">Receives the identification header packet</param>
+    /// <param name="comments">Receives the comment header packet</param>
+    /// <param name="codebooks">Receives the codebook (setup) header packet</param>
+    public: static void CreateHeaders(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState,
+      const std::shared_ptr<::vorbis_comment> &comment,
+      ::ogg_packet &identification, ::ogg_packet &comments, ::ogg_packet &codebooks
+    );
+
+    /// <summary>Requests buffers into which the analysis state can be fed samples</summary>
+    /// <param name="analysisState">Analysis state that will provide the buffers</param>
+    /// <param name="frameCount">Number of frames that will be written at most</param>
+    /// <returns>One buffer of floating point samples for each channel</returns>
+    public: static float **GetAnalysisBuffer(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState, std::size_t frameCount
+    );
+
+    /// <summary>Tells the analysis state how many frames were written to its buffers</summary>
+    /// <param name="analysisState">Analysis state whose buffers have been filled</param>
+    /// <param name="frameCount">
+    ///   Number of frames written into the buffers, zero to signal the end of the stream
+    /// </param>
+    public: static void SubmitAnalysisBuffer(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState, std::size_t frameCount
+    );
+
+    /// <summary>Takes the next block of audio data ready for analysis</summary>
+    /// <param name="analysisState">Analysis state that collected the audio data</param>
+    /// <param name="block">Block that will receive the audio data</param>
+    /// <returns>True if a block was provided, false if more audio data is needed</returns>
+    public: static bool TakeBlock(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState,
+      const std::shared_ptr<::vorbis_block> &block
+    );
+
+    /// <summary>Analyzes (encodes) a block and hands it to the bitrate manager</summary>
+    /// <param name="block">Block that will be analyzed</param>
+    public: static void AnalyzeBlock(const std::shared_ptr<::vorbis_block> &block);
+
+    /// <summary>Takes the next packet of encoded data from the bitrate manager</summary>
+    /// <param name="analysisState">Analysis state the encoded blocks belong to</param>
+    /// <param name="packet">Receives the encoded packet</param>
+    /// <returns>True if a packet was provided, false if none is waiting</returns>
+    public: static bool TakePacket(
+      const std::shared_ptr<::vorbis_dsp_state> &analysisState, ::ogg_packet &packet
+    );
+
+    /// <summary>Creates an Ogg stream that packs packets into pages</summary>
+    /// <param name="serialNumber">Serial number that identifies the logical stream</param>
+    /// <returns>The new Ogg stream</returns>
+    public: static std::shared_ptr<::ogg_stream_state> CreateOggStream(int serialNumber);
+
+    /// <summary>Adds a packet to an Ogg stream</summary>
+    /// <param name="oggStream">Ogg stream the packet will be added to</param>
+    /// <param name="packet">Packet that will be added to the stream</param>
+    public: static void SubmitPacket(
+      const std::shared_ptr<::ogg_stream_state> &oggStream, ::ogg_packet &packet
+    );
+
+    /// <summary>Takes the next page from an Ogg stream</summary>
+    /// <param name="oggStream">Ogg stream from which a page will be taken</param>
+    /// <param name="page">Receives the page</param>
+    /// <param name="force">
+    ///   Whether to also return an unfinished page, needed after the header packets and
+    ///   at the end of the stream
+    /// </param>
+    /// <returns>True if a page was provided, false if there is no page ready</returns>
+    public: static bool TakePage(
+      const std::shared_ptr<::ogg_stream_state> &oggStream, ::ogg_page &page, bool force
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_PLATFORM_VORBISENCODERAPI_H
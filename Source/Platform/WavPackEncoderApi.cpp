@@ -0,0 +1,159 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "WavPackEncoderApi.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception describing the error a WavPack context ran into</summary>
+  /// <param name="rootCauseException">
+  ///   Exception that happened in the virtual file, will be thrown instead if set
+  /// </param>
+  /// <param name="context">WavPack context that has failed</param>
+  /// <param name="message">Message that will be prepended to WavPack's error message</param>
+  [[noreturn]] void throwEncoderError(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::WavpackContext> &context,
+    const char *message
+  ) {
+
+    // If something happened writing to the virtual file, that is the root cause
+    // exception and will be reported above whatever error it caused in libwavpack.
+    if(unlikely(static_cast<bool>(rootCauseException))) {
+      std::rethrow_exception(rootCauseException);
+    }
+
+    std::string combinedMessage(message);
+
+    const char *errorMessage = ::WavpackGetErrorMessage(context.get());
+    if(likely(errorMessage != nullptr)) {
+      if(likely(errorMessage[0] != 0)) {
+        combinedMessage.append(u8": ", 2);
+        combinedMessage.append(errorMessage);
+      }
+    }
+
+    throw std::runtime_error(combinedMessage);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::WavpackContext> WavPackEncoderApi::OpenFileOutput(
+    ::WavpackBlockOutput blockOutput,
+    void *mainFileContext,
+    void *correctionFileContext /* = nullptr */
+  ) {
+    ::WavpackContext *context = ::WavpackOpenFileOutput(
+      blockOutput, mainFileContext, correctionFileContext
+    );
+    if(unlikely(context == nullptr)) {
+      throw std::runtime_error(u8"Unable to allocate new WavPack encoding context");
+    }
+
+    return std::shared_ptr<::WavpackContext>(context, &::WavpackCloseFile);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackEncoderApi::SetConfiguration64(
+    const std::shared_ptr<::WavpackContext> &context,
+    ::WavpackConfig &configuration,
+    std::int64_t totalSampleCount /* = -1 */
+  ) {
+    int result = ::WavpackSetConfiguration64(
+      context.get(), &configuration, totalSampleCount, nullptr
+    );
+    if(unlikely(result == 0)) { // wavpack_local.h defines FALSE as 0
+      throwEncoderError(
+        std::exception_ptr(), context, u8"Error configuring the libwavpack encoder"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackEncoderApi::PackInit(const std::shared_ptr<::WavpackContext> &context) {
+    int result = ::WavpackPackInit(context.get());
+    if(unlikely(result == 0)) { // wavpack_local.h defines FALSE as 0
+      throwEncoderError(
+        std::exception_ptr(), context, u8"Error setting up the libwavpack encoder"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackEncoderApi::PackSamples(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::WavpackContext> &context,
+    std::int32_t *samples,
+    std::uint32_t sampleCount
+  ) {
+    int result = ::WavpackPackSamples(context.get(), samples, sampleCount);
+    if(unlikely(result == 0)) { // wavpack_local.h defines FALSE as 0
+      throwEncoderError(
+        rootCauseException, context, u8"Error packing audio samples via libwavpack"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackEncoderApi::FlushSamples(
+    const std::exception_ptr &rootCauseException,
+    const std::shared_ptr<::WavpackContext> &context
+  ) {
+    int result = ::WavpackFlushSamples(context.get());
+    if(unlikely(result == 0)) { // wavpack_local.h defines FALSE as 0
+      throwEncoderError(
+        rootCauseException, context, u8"Error flushing audio samples via libwavpack"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackEncoderApi::UpdateNumSamples(
+    const std::shared_ptr<::WavpackContext> &context, void *firstBlock
+  ) {
+    // No error return (as of libwavpack 5.x it merely patches the block header)
+    ::WavpackUpdateNumSamples(context.get(), firstBlock);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
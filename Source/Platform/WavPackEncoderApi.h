@@ -0,0 +1,136 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PLATFORM_WAVPACKENCODERAPI_H
+#define NUCLEX_AUDIO_PLATFORM_WAVPACKENCODERAPI_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include <memory> // for std::shared_ptr
+#include <cstdint> // for std::int32_t, std::int64_t
+#include <exception> // for std::exception_ptr
+
+#include <wavpack.h> // for WavPack
+
+namespace Nuclex { namespace Audio { namespace Platform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps the encoding part of the WavPack API with error checking</summary>
+  class WavPackEncoderApi {
+
+    /// <summary>Creates a new WavPack context that emits encoded blocks</summary>
+    /// <param name="blockOutput">Callback that will receive each completed block</param>
+    /// <param name="mainFileContext">
+    ///   User-provided pointer that will be passed to the block output callback when
+    ///   a block for the main WavPack file has been completed
+    /// </param>
+    /// <param name="correctionFileContext">
+    ///   User-provided pointer that will be passed to the block output callback when
+    ///   a block for the correction file has been completed. Can be null.
+    /// </param>
+    /// <returns>
+    ///   A shared pointer to a WavPack context that can be used with other functions
+    ///   in the WavPack API
+    /// </returns>
+    /// <remarks>
+    ///   The returned shared pointer has a custom deleter set up, so this is fully RAII
+    ///   compatible and once the pointer goes out of scope, the WavPack context is
+    ///   closed again.
+    /// </remarks>
+    public: static std::shared_ptr<::WavpackContext> OpenFileOutput(
+      ::WavpackBlockOutput blockOutput,
+      void *mainFileContext,
+      void *correctionFileContext = nullptr
+    );
+
+    /// <summary>Configures the format and compression settings of the encoder</summary>
+    /// <param name="context">WavPack context that will be configured</param>
+    /// <param name="configuration">Format, channel and compression settings</param>
+    /// <param name="totalSampleCount">
+    ///   Number of samples (per channel) that will be encoded or -1 if unknown
+    /// </param>
+    public: static void SetConfiguration64(
+      const std::shared_ptr<::WavpackContext> &context,
+      ::WavpackConfig &configuration,
+      std::int64_t totalSampleCount = -1
+    );
+
+    /// <summary>Prepares the encoder for packing samples after configuring it</summary>
+    /// <param name="context">WavPack context that will be prepared</param>
+    public: static void PackInit(const std::shared_ptr<::WavpackContext> &context);
+
+    /// <summary>Feeds interleaved samples to the encoder</summary>
+    /// <param name="rootCauseException">
+    ///   Should receive any exception that happened in the virtual file and will be thrown
+    ///   instead of a generic WavPack error if it becomes filled during the WavPack API call
+    /// </param>
+    /// <param name="context">WavPack context the samples will be packed in</param>
+    /// <param name="samples">Interleaved, right-aligned samples</param>
+    /// <param name="sampleCount">
+    ///   Number of &quot;complete&quot; samples in the buffer, meaning the number of
+    ///   values in the buffer divided by the number of channels.
+    /// </param>
+    /// <remarks>
+    ///   libwavpack collects the samples until a block is full, so only some calls
+    ///   will actually end up invoking the block output callback.
+    /// </remarks>
+    public: static void PackSamples(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::WavpackContext> &context,
+      std::int32_t *samples,
+      std::uint32_t sampleCount
+    );
+
+    /// <summary>Encodes any samples libwavpack is still holding on to</summary>
+    /// <param name="rootCauseException">
+    ///   Should receive any exception that happened in the virtual file and will be thrown
+    ///   instead of a generic WavPack error if it becomes filled during the WavPack API call
+    /// </param>
+    /// <param name="context">WavPack context that will be flushed</param>
+    public: static void FlushSamples(
+      const std::exception_ptr &rootCauseException,
+      const std::shared_ptr<::WavpackContext> &context
+    );
+
+    /// <summary>Writes the final number of samples into the first block</summary>
+    /// <param name="context">WavPack context that produced the first block</param>
+    /// <param name="firstBlock">
+    ///   Copy of the first block the encoder emitted, will be modified in place
+    /// </param>
+    /// <remarks>
+    ///   If the total number of samples was not known when the encoder was configured,
+    ///   the first block needs to be updated and written again after encoding completes.
+    ///   The size of the block does not change.
+    /// </remarks>
+    public: static void UpdateNumSamples(
+      const std::shared_ptr<::WavpackContext> &context, void *firstBlock
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Platform
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#endif // NUCLEX_AUDIO_PLATFORM_WAVPACKENCODERAPI_H
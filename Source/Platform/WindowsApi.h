@@ -38,6 +38,7 @@ limitations under the License.
 #undef CreateFile
 #undef DeleteFile
 #undef MoveFile
+#undef ReplaceFile
 #undef CreateDirectory
 #undef RemoveDirectory
 #undef GetFileAttributes
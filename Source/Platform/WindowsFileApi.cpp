@@ -28,6 +28,8 @@ limitations under the License.
 
 #include "Nuclex/Support/Text/UnicodeHelper.h" // for UTF-16 <-> UTF-8 conversion
 
+#include <cassert> // for assert()
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -115,16 +117,25 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
-  HANDLE WindowsFileApi::OpenFileForReading(const std::string &path, bool sequentialAccess) {
+  HANDLE WindowsFileApi::OpenFileForReading(
+    const std::string &path, bool sequentialAccess, bool randomAccess /* = false */
+  ) {
     std::wstring utf16Path = utf16FromUtf8Path(path);
 
+    DWORD flagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+    if(sequentialAccess) {
+      flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if(randomAccess) {
+      flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
     HANDLE fileHandle = ::CreateFileW(
       utf16Path.c_str(),
       GENERIC_READ, // desired access
       FILE_SHARE_READ, // share mode,
       nullptr,
       OPEN_EXISTING, // creation disposition
-      FILE_ATTRIBUTE_NORMAL | (sequentialAccess ? FILE_FLAG_SEQUENTIAL_SCAN : 0),
+      flagsAndAttributes,
       nullptr
     );
     if(unlikely(fileHandle == INVALID_HANDLE_VALUE)) {
@@ -169,6 +180,33 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  HANDLE WindowsFileApi::OpenFileUnbuffered(const std::string &path, bool forWriting) {
+    std::wstring utf16Path = utf16FromUtf8Path(path);
+
+    HANDLE fileHandle = ::CreateFileW(
+      utf16Path.c_str(),
+      forWriting ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, // desired access
+      forWriting ? 0 : FILE_SHARE_READ, // share mode
+      nullptr,
+      forWriting ? OPEN_ALWAYS : OPEN_EXISTING, // creation disposition
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr
+    );
+    if(unlikely(fileHandle == INVALID_HANDLE_VALUE)) {
+      DWORD errorCode = ::GetLastError();
+
+      std::string errorMessage(u8"Could not open file '");
+      errorMessage.append(path);
+      errorMessage.append(forWriting ? u8"' for writing" : u8"' for reading");
+
+      ThrowExceptionForFileAccessError(errorMessage, errorCode);
+    }
+
+    return fileHandle;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t WindowsFileApi::GetFileSize(::HANDLE fileHandle) {
     LARGE_INTEGER fileSize;
 
@@ -185,6 +223,89 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void WindowsFileApi::SetFileLength(::HANDLE fileHandle, std::uint64_t length) {
+    FILE_END_OF_FILE_INFO endOfFileInfo;
+    endOfFileInfo.EndOfFile.QuadPart = static_cast<LONGLONG>(length);
+
+    // Unlike SetEndOfFile(), this doesn't need the file cursor and works on handles
+    // opened with FILE_FLAG_NO_BUFFERING for lengths that aren't sector-aligned
+    BOOL succeeded = ::SetFileInformationByHandle(
+      fileHandle, FileEndOfFileInfo, &endOfFileInfo, sizeof(endOfFileInfo)
+    );
+    if(unlikely(succeeded == FALSE)) {
+      DWORD lastErrorCode = ::GetLastError();
+      ThrowExceptionForFileAccessError(
+        u8"Could not change the length of a file", lastErrorCode
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WindowsFileApi::TryPreallocate(::HANDLE fileHandle, std::uint64_t byteCount) {
+    FILE_ALLOCATION_INFO allocationInfo;
+    allocationInfo.AllocationSize.QuadPart = static_cast<LONGLONG>(byteCount);
+
+    BOOL succeeded = ::SetFileInformationByHandle(
+      fileHandle, FileAllocationInfo, &allocationInfo, sizeof(allocationInfo)
+    );
+    return (succeeded != FALSE); // It's only an optimization, if it doesn't work, so be it
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WindowsFileApi::TryGetFileAttributes(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+    std::wstring utf16Path = utf16FromUtf8Path(path);
+
+    ::WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+    BOOL succeeded = ::GetFileAttributesExW(
+      utf16Path.c_str(), ::GetFileExInfoStandard, &fileAttributes
+    );
+    if(unlikely(succeeded == FALSE)) {
+      return false;
+    }
+
+    size = (
+      (static_cast<std::uint64_t>(fileAttributes.nFileSizeHigh) << 32) |
+      static_cast<std::uint64_t>(fileAttributes.nFileSizeLow)
+    );
+    modificationTime = (
+      (static_cast<std::uint64_t>(fileAttributes.ftLastWriteTime.dwHighDateTime) << 32) |
+      static_cast<std::uint64_t>(fileAttributes.ftLastWriteTime.dwLowDateTime)
+    );
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WindowsFileApi::ReplaceFile(
+    const std::string &sourcePath, const std::string &targetPath
+  ) {
+    std::wstring utf16SourcePath = utf16FromUtf8Path(sourcePath);
+    std::wstring utf16TargetPath = utf16FromUtf8Path(targetPath);
+
+    BOOL succeeded = ::MoveFileExW(
+      utf16SourcePath.c_str(), utf16TargetPath.c_str(),
+      MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+    );
+    if(unlikely(succeeded == FALSE)) {
+      DWORD errorCode = ::GetLastError();
+
+      std::string errorMessage(u8"Could not move file '");
+      errorMessage.append(sourcePath);
+      errorMessage.append(u8"' over '");
+      errorMessage.append(targetPath);
+      errorMessage.append(u8"'");
+
+      ThrowExceptionForFileAccessError(errorMessage, errorCode);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::size_t WindowsFileApi::Seek(HANDLE fileHandle, std::ptrdiff_t offset, DWORD anchor) {
     LARGE_INTEGER distanceToMove;
     distanceToMove.QuadPart = offset;
@@ -238,6 +359,54 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t WindowsFileApi::PositionalRead(
+    HANDLE fileHandle, std::byte *buffer, std::size_t count, std::uint64_t offset
+  ) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD desiredCount = static_cast<DWORD>(count);
+    DWORD actualCount = 0;
+
+    BOOL result = ::ReadFile(fileHandle, buffer, desiredCount, &actualCount, &overlapped);
+    if(unlikely(result == FALSE)) {
+      DWORD errorCode = ::GetLastError();
+      if(errorCode == ERROR_HANDLE_EOF) {
+        return 0;
+      }
+
+      std::string errorMessage(u8"Could not read data from file via positional read");
+      ThrowExceptionForFileAccessError(errorMessage, errorCode);
+    }
+
+    return static_cast<std::size_t>(actualCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WindowsFileApi::PositionalWrite(
+    HANDLE fileHandle, const std::byte *buffer, std::size_t count, std::uint64_t offset
+  ) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD desiredCount = static_cast<DWORD>(count);
+    DWORD actualCount = 0;
+
+    BOOL result = ::WriteFile(fileHandle, buffer, desiredCount, &actualCount, &overlapped);
+    if(unlikely(result == FALSE)) {
+      DWORD errorCode = ::GetLastError();
+      std::string errorMessage(u8"Could not write data to file via positional write");
+      ThrowExceptionForFileAccessError(errorMessage, errorCode);
+    }
+
+    return static_cast<std::size_t>(actualCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WindowsFileApi::CloseFile(HANDLE fileHandle, bool throwOnError /* = true */) {
     BOOL result = ::CloseHandle(fileHandle);
     if(throwOnError && (result == FALSE)) {
@@ -249,6 +418,39 @@ namespace Nuclex { namespace Audio { namespace Platform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  const std::byte *WindowsFileApi::TryMapFileForReading(
+    HANDLE fileHandle, std::size_t length
+  ) {
+    HANDLE mappingHandle = ::CreateFileMappingW(
+      fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr
+    );
+    if(unlikely(mappingHandle == nullptr)) {
+      return nullptr;
+    }
+
+    // The view holds a reference to the mapping object, so we can close our handle
+    // right away and only need to keep track of the view's address.
+    LPVOID memory = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, length);
+    BOOL result = ::CloseHandle(mappingHandle);
+    NUCLEX_AUDIO_NDEBUG_UNUSED(result);
+    assert((result != FALSE) && u8"File mapping handle is closed successfully");
+
+    return reinterpret_cast<const std::byte *>(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WindowsFileApi::UnmapFile(const std::byte *memory, bool throwOnError /* = true */) {
+    BOOL result = ::UnmapViewOfFile(memory);
+    if(throwOnError && (result == FALSE)) {
+      DWORD errorCode = ::GetLastError();
+      std::string errorMessage(u8"Could not unmap file from memory");
+      ThrowExceptionForFileAccessError(errorMessage, errorCode);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WindowsFileApi::ThrowExceptionForFileAccessError(
     const std::string &errorMessage, DWORD errorCode
   ) {
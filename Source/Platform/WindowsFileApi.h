@@ -49,8 +49,11 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <summary>Opens the specified file for shared reading</summary>
     /// <param name="path">Path of the file that will be opened</param>
     /// <param name="sequentialAccess">Whether the file will be read sequentially</param>
+    /// <param name="randomAccess">Whether the file will be read at random offsets</param>
     /// <returns>The handle of the opened file</returns>
-    public: static HANDLE OpenFileForReading(const std::string &path, bool sequentialAccess);
+    public: static HANDLE OpenFileForReading(
+      const std::string &path, bool sequentialAccess, bool randomAccess = false
+    );
 
     /// <summary>Creates or opens the specified file for exclusive writing</summary>
     /// <param name="path">Path of the file that will be opened</param>
@@ -58,11 +61,57 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// <returns>The handle of the opened file</returns>
     public: static HANDLE OpenFileForWriting(const std::string &path, bool sequentialAccess);
 
+    /// <summary>Opens the specified file for I/O that bypasses the system cache</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="forWriting">Whether to create or open the file for writing</param>
+    /// <returns>The handle of the opened file</returns>
+    /// <remarks>
+    ///   All reads and writes through the returned handle must use buffers, offsets
+    ///   and lengths aligned to the volume's sector size.
+    /// </remarks>
+    public: static HANDLE OpenFileUnbuffered(const std::string &path, bool forWriting);
+
     /// <summary>Returns the total size of the file in bytes</summary>
     /// <param name="fileHandle">Handle of the file whose size will be reported</param>
     /// <returns>The size of the file with the specified handle in bytes</returns>
     public: static std::uint64_t GetFileSize(::HANDLE fileHandle);
 
+    /// <summary>Cuts off or extends a file to the specified length</summary>
+    /// <param name="fileHandle">Handle of the file that will be resized</param>
+    /// <param name="length">New length of the file in bytes</param>
+    public: static void SetFileLength(::HANDLE fileHandle, std::uint64_t length);
+
+    /// <summary>Reserves disk space for a file without changing its length</summary>
+    /// <param name="fileHandle">Handle of the file to reserve space for</param>
+    /// <param name="byteCount">Number of bytes the file is expected to grow to</param>
+    /// <returns>True if the space was reserved, false if the file system can't do it</returns>
+    /// <remarks>
+    ///   Unlike SetFileValidData(), this needs no special privileges and never exposes
+    ///   stale data from the disk. Reserved space beyond the end of the file is released
+    ///   when the file's length is set again or the last handle to it is closed.
+    /// </remarks>
+    public: static bool TryPreallocate(::HANDLE fileHandle, std::uint64_t byteCount);
+
+    /// <summary>Looks up the size and last modification time of a file</summary>
+    /// <param name="path">Path of the file whose attributes will be looked up</param>
+    /// <param name="size">Receives the size of the file in bytes</param>
+    /// <param name="modificationTime">
+    ///   Receives the time of the last modification in the FILETIME format
+    /// </param>
+    /// <returns>True if the file exists and its attributes could be looked up</returns>
+    public: static bool TryGetFileAttributes(
+      const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+    );
+
+    /// <summary>Moves a file over another one, replacing it in a single step</summary>
+    /// <param name="sourcePath">Path of the file that will be moved</param>
+    /// <param name="targetPath">Path the file will be moved to</param>
+    /// <remarks>
+    ///   Both paths must be on the same volume. Fails if the target is still open
+    ///   without FILE_SHARE_DELETE, which includes files that are memory-mapped.
+    /// </remarks>
+    public: static void ReplaceFile(const std::string &sourcePath, const std::string &targetPath);
+
     /// <summary>Moves the file cursor to a different position</summary>
     /// <param name="fileHandle">Handle of the file whose file cursor to move</param>
     /// <param name="offset">Offset to move the file cursor relative to the anchor</param>
@@ -88,6 +137,26 @@ namespace Nuclex { namespace Audio { namespace Platform {
       HANDLE fileHandle, const std::byte *buffer, std::size_t count
     );
 
+    /// <summary>Reads data from the specified file at an absolute position</summary>
+    /// <param name="fileHandle">Handle of the file from which data will be read</param>
+    /// <param name="buffer">Buffer into which the data will be put</param>
+    /// <param name="count">Number of bytes that will be read from the file</param>
+    /// <param name="offset">Absolute file offset at which the read will take place</param>
+    /// <returns>The number of bytes that were actually read</returns>
+    public: static std::size_t PositionalRead(
+      HANDLE fileHandle, std::byte *buffer, std::size_t count, std::uint64_t offset
+    );
+
+    /// <summary>Writes data into the specified file at an absolute position</summary>
+    /// <param name="fileHandle">Handle of the file into which data will be written</param>
+    /// <param name="buffer">Buffer containing the data that will be written</param>
+    /// <param name="count">Number of bytes that will be written into the file</param>
+    /// <param name="offset">Absolute file offset at which the write will take place</param>
+    /// <returns>The number of bytes that were actually written</returns>
+    public: static std::size_t PositionalWrite(
+      HANDLE fileHandle, const std::byte *buffer, std::size_t count, std::uint64_t offset
+    );
+
     /// <summary>Closes the specified file</summary>
     /// <param name="fileHandle">Handle of the file that will be closed</param>
     /// <param name="throwOnError">
@@ -95,6 +164,28 @@ namespace Nuclex { namespace Audio { namespace Platform {
     /// </param>
     public: static void CloseFile(HANDLE fileHandle, bool throwOnError = true);
 
+    /// <summary>Maps the contents of a file into the process' address space</summary>
+    /// <param name="fileHandle">Handle of the file that will be mapped</param>
+    /// <param name="length">Number of bytes from the file start that will be mapped</param>
+    /// <returns>
+    ///   The address at which the file contents are accessible or a null pointer if
+    ///   the file could not be mapped
+    /// </returns>
+    /// <remarks>
+    ///   The mapped view keeps the file alive, so the file handle can be closed right
+    ///   after this call. The view has to be released via <see cref="UnmapFile" />.
+    /// </remarks>
+    public: static const std::byte *TryMapFileForReading(
+      HANDLE fileHandle, std::size_t length
+    );
+
+    /// <summary>Releases a file mapping that was created previously</summary>
+    /// <param name="memory">Address at which the file contents have been mapped</param>
+    /// <param name="throwOnError">
+    ///   Whether to throw an exception if the file mapping cannot be released
+    /// </param>
+    public: static void UnmapFile(const std::byte *memory, bool throwOnError = true);
+
     /// <summary>Throws the appropriate exception for an error reported by the OS</summary>
     /// <param name="errorMessage">
     ///   Error message that should be included in the exception, will be prefixed to
@@ -22,9 +22,482 @@ limitations under the License.
 
 #include "Nuclex/Audio/Processing/BitExtension.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include "./CpuFeatures.h" // for CpuFeatures, NUCLEX_AUDIO_TARGET_AVX2
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+#include <cassert> // for assert()
 
-// --------------------------------------------------------------------------------------------- //
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shift and masks that describe how bit patterns are repeated</summary>
+  struct ExtensionMasks {
+
+    /// <summary>Number of bits by which the widened value is shifted right</summary>
+    public: int Shift;
+    /// <summary>Mask of the bits to keep after shifting right once</summary>
+    public: std::int32_t OnceMask;
+    /// <summary>Mask of the valid bits in the extended results</summary>
+    public: std::int32_t TargetMask;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of bit extension kernels for one instruction set</summary>
+  struct ExtensionKernelTable {
+
+    /// <summary>Widens 16-bit integers and repeats their bit pattern once</summary>
+    public: void (*RepeatInt16)(
+      const std::int16_t *, std::int32_t *, std::size_t, const ExtensionMasks &
+    );
+    /// <summary>Widens 16-bit integers and repeats their bit pattern twice</summary>
+    public: void (*TripleInt16)(
+      const std::int16_t *, std::int32_t *, std::size_t, const ExtensionMasks &
+    );
+    /// <summary>Repeats the bit pattern of 32-bit integers once</summary>
+    public: void (*RepeatInt32)(
+      const std::int32_t *, std::int32_t *, std::size_t, const ExtensionMasks &
+    );
+    /// <summary>Repeats the bit pattern of 32-bit integers twice</summary>
+    public: void (*TripleInt32)(
+      const std::int32_t *, std::int32_t *, std::size_t, const ExtensionMasks &
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the shift and masks for extending integers to 32 bits</summary>
+  /// <param name="valueBitCount">Number of valid bits in the input integers</param>
+  /// <param name="resultBitCount">Number of valid bits in the extended integers</param>
+  /// <param name="triple">Receives whether the bit pattern needs to be repeated twice</param>
+  /// <returns>The shift and masks that produce the extended integers</returns>
+  ExtensionMasks calculateMasks(
+    std::size_t valueBitCount, std::size_t resultBitCount, bool &triple
+  ) {
+    assert(
+      (valueBitCount >= 1) && (valueBitCount <= resultBitCount) && (resultBitCount <= 32) &&
+      u8"Bit counts must be valid for extending integers to 32 bits"
+    );
+
+    ExtensionMasks masks;
+    masks.Shift = static_cast<int>(valueBitCount - 1);
+    triple = false;
+
+    // If only the containing type changes, no bit patterns are repeated and the result
+    // is not masked, either, exactly as SampleConverter::ExtendBits() does it
+    if(valueBitCount == resultBitCount) {
+      masks.OnceMask = 0;
+      masks.TargetMask = -1;
+      return masks;
+    }
+
+    std::uint32_t bitsBelowSign = (std::uint32_t(1) << (valueBitCount - 1)) - 1;
+    if(valueBitCount * 2 >= resultBitCount + 1) { // repeat bit pattern once
+      masks.OnceMask = static_cast<std::int32_t>(
+        (bitsBelowSign << (32 - valueBitCount)) >> (valueBitCount - 1)
+      );
+    } else { // repeat bit pattern once / twice
+      masks.OnceMask = static_cast<std::int32_t>(
+        bitsBelowSign << (32 - valueBitCount - (valueBitCount - 1))
+      );
+      triple = true;
+    }
+    masks.TargetMask = static_cast<std::int32_t>(
+      ((std::uint64_t(1) << resultBitCount) - 1) << (32 - resultBitCount)
+    );
+
+    return masks;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extends integers to 32 bits one by one</summary>
+  /// <typeparam name="TValue">Type of the input integers</typeparam>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<typename TValue, bool Triple>
+  void extendScalar(
+    const TValue *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    constexpr int PreShift = static_cast<int>(32 - sizeof(TValue) * 8);
+    while(0 < count) {
+      std::int32_t value = static_cast<std::int32_t>(values[0]) << PreShift;
+      std::int32_t once = (value >> masks.Shift) & masks.OnceMask;
+      if constexpr(Triple) {
+        results[0] = masks.TargetMask & (value | once | (once >> masks.Shift));
+      } else {
+        results[0] = masks.TargetMask & (value | once);
+      }
+
+      ++values;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Repeats the bit patterns of 4 widened integers using SSE2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="value">Widened integers whose bit patterns will be repeated</param>
+  /// <param name="shift">Shift count register for the right shifts</param>
+  /// <param name="onceMask">Mask of the bits to keep after shifting right once</param>
+  /// <param name="targetMask">Mask of the valid bits in the extended results</param>
+  /// <returns>The integers with their bit patterns repeated</returns>
+  template<bool Triple>
+  inline __m128i repeatSse2(
+    __m128i value, __m128i shift, __m128i onceMask, __m128i targetMask
+  ) {
+    __m128i once = _mm_and_si128(_mm_sra_epi32(value, shift), onceMask);
+    if constexpr(Triple) {
+      value = _mm_or_si128(value, _mm_sra_epi32(once, shift));
+    }
+    return _mm_and_si128(targetMask, _mm_or_si128(value, once));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens 16-bit integers to 32 bits, 8 at a time, using SSE2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  void extendInt16Sse2(
+    const std::int16_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shift = _mm_cvtsi32_si128(masks.Shift);
+    const __m128i onceMask = _mm_set1_epi32(masks.OnceMask);
+    const __m128i targetMask = _mm_set1_epi32(masks.TargetMask);
+
+    // Interleaving zeros below the 16-bit integers widens them and shifts them
+    // into the upper half of each lane in a single instruction
+    while(7 < count) {
+      __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results),
+        repeatSse2<Triple>(_mm_unpacklo_epi16(zero, input), shift, onceMask, targetMask)
+      );
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results + 4),
+        repeatSse2<Triple>(_mm_unpackhi_epi16(zero, input), shift, onceMask, targetMask)
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    extendScalar<std::int16_t, Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extends 32-bit integers, 4 at a time, using SSE2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  void extendInt32Sse2(
+    const std::int32_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const __m128i shift = _mm_cvtsi32_si128(masks.Shift);
+    const __m128i onceMask = _mm_set1_epi32(masks.OnceMask);
+    const __m128i targetMask = _mm_set1_epi32(masks.TargetMask);
+
+    while(3 < count) {
+      __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results),
+        repeatSse2<Triple>(input, shift, onceMask, targetMask)
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    extendScalar<std::int32_t, Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Repeats the bit patterns of 8 widened integers using AVX2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="value">Widened integers whose bit patterns will be repeated</param>
+  /// <param name="shift">Shift count register for the right shifts</param>
+  /// <param name="onceMask">Mask of the bits to keep after shifting right once</param>
+  /// <param name="targetMask">Mask of the valid bits in the extended results</param>
+  /// <returns>The integers with their bit patterns repeated</returns>
+  template<bool Triple>
+  NUCLEX_AUDIO_TARGET_AVX2 inline __m256i repeatAvx2(
+    __m256i value, __m128i shift, __m256i onceMask, __m256i targetMask
+  ) {
+    __m256i once = _mm256_and_si256(_mm256_sra_epi32(value, shift), onceMask);
+    if constexpr(Triple) {
+      value = _mm256_or_si256(value, _mm256_sra_epi32(once, shift));
+    }
+    return _mm256_and_si256(targetMask, _mm256_or_si256(value, once));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens 16-bit integers to 32 bits, 8 at a time, using AVX2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  NUCLEX_AUDIO_TARGET_AVX2 void extendInt16Avx2(
+    const std::int16_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const __m128i shift = _mm_cvtsi32_si128(masks.Shift);
+    const __m256i onceMask = _mm256_set1_epi32(masks.OnceMask);
+    const __m256i targetMask = _mm256_set1_epi32(masks.TargetMask);
+
+    // The AVX2 unpack instructions work within 128-bit halves and would scramble
+    // the order, so the integers are sign-extended across lanes and shifted instead
+    while(7 < count) {
+      __m256i input = _mm256_slli_epi32(
+        _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values))), 16
+      );
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(results),
+        repeatAvx2<Triple>(input, shift, onceMask, targetMask)
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    extendInt16Sse2<Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extends 32-bit integers, 8 at a time, using AVX2</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  NUCLEX_AUDIO_TARGET_AVX2 void extendInt32Avx2(
+    const std::int32_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const __m128i shift = _mm_cvtsi32_si128(masks.Shift);
+    const __m256i onceMask = _mm256_set1_epi32(masks.OnceMask);
+    const __m256i targetMask = _mm256_set1_epi32(masks.TargetMask);
+
+    while(7 < count) {
+      __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(results),
+        repeatAvx2<Triple>(input, shift, onceMask, targetMask)
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    extendInt32Sse2<Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Repeats the bit patterns of 4 widened integers using NEON</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="value">Widened integers whose bit patterns will be repeated</param>
+  /// <param name="negativeShift">Negated shift count, NEON shifts right by shifting left</param>
+  /// <param name="onceMask">Mask of the bits to keep after shifting right once</param>
+  /// <param name="targetMask">Mask of the valid bits in the extended results</param>
+  /// <returns>The integers with their bit patterns repeated</returns>
+  template<bool Triple>
+  inline int32x4_t repeatNeon(
+    int32x4_t value, int32x4_t negativeShift, int32x4_t onceMask, int32x4_t targetMask
+  ) {
+    int32x4_t once = vandq_s32(vshlq_s32(value, negativeShift), onceMask);
+    if constexpr(Triple) {
+      value = vorrq_s32(value, vshlq_s32(once, negativeShift));
+    }
+    return vandq_s32(targetMask, vorrq_s32(value, once));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens 16-bit integers to 32 bits, 8 at a time, using NEON</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  void extendInt16Neon(
+    const std::int16_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const int32x4_t negativeShift = vdupq_n_s32(-masks.Shift);
+    const int32x4_t onceMask = vdupq_n_s32(masks.OnceMask);
+    const int32x4_t targetMask = vdupq_n_s32(masks.TargetMask);
+
+    // The long shift widens the 16-bit integers and moves them into the upper half
+    // of each lane in a single instruction
+    while(7 < count) {
+      int16x8_t input = vld1q_s16(values);
+      vst1q_s32(
+        results,
+        repeatNeon<Triple>(
+          vshll_n_s16(vget_low_s16(input), 16), negativeShift, onceMask, targetMask
+        )
+      );
+      vst1q_s32(
+        results + 4,
+        repeatNeon<Triple>(vshll_high_n_s16(input, 16), negativeShift, onceMask, targetMask)
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    extendScalar<std::int16_t, Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extends 32-bit integers, 4 at a time, using NEON</summary>
+  /// <typeparam name="Triple">Whether the bit pattern is repeated twice</typeparam>
+  /// <param name="values">Integers that will be extended</param>
+  /// <param name="results">Receives the extended integers</param>
+  /// <param name="count">Number of integers that will be extended</param>
+  /// <param name="masks">Shift and masks that produce the extended integers</param>
+  template<bool Triple>
+  void extendInt32Neon(
+    const std::int32_t *values, std::int32_t *results, std::size_t count,
+    const ExtensionMasks &masks
+  ) {
+    const int32x4_t negativeShift = vdupq_n_s32(-masks.Shift);
+    const int32x4_t onceMask = vdupq_n_s32(masks.OnceMask);
+    const int32x4_t targetMask = vdupq_n_s32(masks.TargetMask);
+
+    while(3 < count) {
+      vst1q_s32(
+        results,
+        repeatNeon<Triple>(vld1q_s32(values), negativeShift, onceMask, targetMask)
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    extendScalar<std::int32_t, Triple>(values, results, count, masks);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Selects the fastest extension kernels the CPU this is running on supports</summary>
+  /// <returns>A table with the fastest extension kernels for the CPU</returns>
+  ExtensionKernelTable selectKernels() {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    ExtensionKernelTable table = {
+      &extendInt16Sse2<false>, &extendInt16Sse2<true>,
+      &extendInt32Sse2<false>, &extendInt32Sse2<true>
+    };
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    ExtensionKernelTable table = {
+      &extendInt16Neon<false>, &extendInt16Neon<true>,
+      &extendInt32Neon<false>, &extendInt32Neon<true>
+    };
+#else
+    ExtensionKernelTable table = {
+      &extendScalar<std::int16_t, false>, &extendScalar<std::int16_t, true>,
+      &extendScalar<std::int32_t, false>, &extendScalar<std::int32_t, true>
+    };
+#endif
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    if(Nuclex::Audio::Processing::CpuFeatures::Get().HasAvx2) {
+      table = ExtensionKernelTable {
+        &extendInt16Avx2<false>, &extendInt16Avx2<true>,
+        &extendInt32Avx2<false>, &extendInt32Avx2<true>
+      };
+    }
+#endif
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the extension kernel table, selecting the kernels on first use</summary>
+  /// <returns>The kernel table with the fastest extension kernels for the CPU</returns>
+  const ExtensionKernelTable &getKernels() {
+    static const ExtensionKernelTable kernels = selectKernels();
+    return kernels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitExtension::ExtendToInt32(
+    const std::int16_t *values, std::size_t valueBitCount,
+    std::int32_t *results, std::size_t resultBitCount,
+    std::size_t count
+  ) {
+    bool triple;
+    ExtensionMasks masks = calculateMasks(valueBitCount, resultBitCount, triple);
+    if(triple) {
+      getKernels().TripleInt16(values, results, count, masks);
+    } else {
+      getKernels().RepeatInt16(values, results, count, masks);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitExtension::ExtendToInt32(
+    const std::int32_t *values, std::size_t valueBitCount,
+    std::int32_t *results, std::size_t resultBitCount,
+    std::size_t count
+  ) {
+    bool triple;
+    ExtensionMasks masks = calculateMasks(valueBitCount, resultBitCount, triple);
+    if(triple) {
+      getKernels().TripleInt32(values, results, count, masks);
+    } else {
+      getKernels().RepeatInt32(values, results, count, masks);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
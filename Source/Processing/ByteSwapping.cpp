@@ -0,0 +1,343 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ByteSwapping.h"
+
+#include "./CpuFeatures.h" // for CpuFeatures, NUCLEX_AUDIO_TARGET_SSSE3
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of byte swapping kernels for one instruction set</summary>
+  struct SwappingKernelTable {
+
+    /// <summary>Reverses the byte order of 16-bit samples</summary>
+    public: void (*Swap16)(const std::byte *, std::byte *, std::size_t);
+    /// <summary>Reverses the byte order of packed 24-bit samples</summary>
+    public: void (*Swap24)(const std::byte *, std::byte *, std::size_t);
+    /// <summary>Reverses the byte order of 32-bit samples</summary>
+    public: void (*Swap32)(const std::byte *, std::byte *, std::size_t);
+    /// <summary>Reverses the byte order of 64-bit samples</summary>
+    public: void (*Swap64)(const std::byte *, std::byte *, std::size_t);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of samples one by one</summary>
+  /// <typeparam name="ByteCount">Number of bytes in each sample</typeparam>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  template<std::size_t ByteCount>
+  void swapScalar(const std::byte *source, std::byte *target, std::size_t count) {
+    while(0 < count) {
+
+      // Take a copy of the sample first, otherwise swapping in place would
+      // overwrite bytes before they have been read
+      std::byte sample[ByteCount];
+      for(std::size_t index = 0; index < ByteCount; ++index) {
+        sample[index] = source[index];
+      }
+      for(std::size_t index = 0; index < ByteCount; ++index) {
+        target[index] = sample[ByteCount - 1 - index];
+      }
+
+      source += ByteCount;
+      target += ByteCount;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Reverses the byte order of 16 bytes worth of samples using NEON</summary>
+  /// <typeparam name="ByteCount">Number of bytes in each sample</typeparam>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  template<std::size_t ByteCount>
+  void swapNeon(const std::byte *source, std::byte *target, std::size_t count) {
+    constexpr std::size_t samplesPerVector = 16 / ByteCount;
+    while(samplesPerVector <= count) {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const std::uint8_t *>(source));
+      if constexpr(ByteCount == 2) {
+        bytes = vrev16q_u8(bytes);
+      } else if constexpr(ByteCount == 4) {
+        bytes = vrev32q_u8(bytes);
+      } else {
+        bytes = vrev64q_u8(bytes);
+      }
+      vst1q_u8(reinterpret_cast<std::uint8_t *>(target), bytes);
+
+      source += 16;
+      target += 16;
+      count -= samplesPerVector;
+    }
+
+    swapScalar<ByteCount>(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of packed 24-bit samples 16 at a time using NEON</summary>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  void swap24Neon(const std::byte *source, std::byte *target, std::size_t count) {
+    while(15 < count) {
+
+      // The structured load puts each byte position into its own vector,
+      // so swapping the first and last vectors reverses the bytes of all samples
+      uint8x16x3_t bytes = vld3q_u8(reinterpret_cast<const std::uint8_t *>(source));
+      uint8x16_t lowBytes = bytes.val[0];
+      bytes.val[0] = bytes.val[2];
+      bytes.val[2] = lowBytes;
+      vst3q_u8(reinterpret_cast<std::uint8_t *>(target), bytes);
+
+      source += 48;
+      target += 48;
+      count -= 16;
+    }
+
+    swapScalar<3>(source, target, count);
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Reverses the byte order of 16-bit samples 8 at a time using SSE2</summary>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  /// <remarks>
+  ///   16-bit samples don't need a byte shuffle, two shifts do the job, so this works
+  ///   on any CPU with SSE2, which is a requirement of the library on x86 anyway.
+  /// </remarks>
+  void swap16Sse2(const std::byte *source, std::byte *target, std::size_t count) {
+    while(7 < count) {
+      __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target),
+        _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8))
+      );
+
+      source += 16;
+      target += 16;
+      count -= 8;
+    }
+
+    swapScalar<2>(source, target, count);
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Builds a byte shuffle mask reversing the bytes of each sample</summary>
+  /// <typeparam name="ByteCount">Number of bytes in each sample</typeparam>
+  /// <returns>A shuffle mask for pshufb that reverses the bytes of each sample</returns>
+  template<std::size_t ByteCount>
+  NUCLEX_AUDIO_TARGET_SSSE3 __m128i getSwapMask() {
+    if constexpr(ByteCount == 2) {
+      return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    } else if constexpr(ByteCount == 4) {
+      return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    } else {
+      return _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of 16 bytes worth of samples using SSSE3</summary>
+  /// <typeparam name="ByteCount">Number of bytes in each sample</typeparam>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  template<std::size_t ByteCount>
+  NUCLEX_AUDIO_TARGET_SSSE3 void swapSsse3(
+    const std::byte *source, std::byte *target, std::size_t count
+  ) {
+    constexpr std::size_t samplesPerVector = 16 / ByteCount;
+    const __m128i swapMask = getSwapMask<ByteCount>();
+
+    while(samplesPerVector <= count) {
+      __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_shuffle_epi8(samples, swapMask));
+
+      source += 16;
+      target += 16;
+      count -= samplesPerVector;
+    }
+
+    swapScalar<ByteCount>(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of packed 24-bit samples 5 at a time using SSSE3</summary>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  NUCLEX_AUDIO_TARGET_SSSE3 void swap24Ssse3(
+    const std::byte *source, std::byte *target, std::size_t count
+  ) {
+
+    // 5 samples fill 15 bytes of a vector. The 16th byte is passed through unchanged,
+    // which is harmless when swapping in place and gets overwritten by the next step
+    // otherwise. Going by the load, 6 samples need to remain to stay inside the buffer.
+    const __m128i swapMask = _mm_setr_epi8(
+      2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15
+    );
+    while(5 < count) {
+      __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_shuffle_epi8(samples, swapMask));
+
+      source += 15;
+      target += 15;
+      count -= 5;
+    }
+
+    swapScalar<3>(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of 32 bytes worth of samples using AVX2</summary>
+  /// <typeparam name="ByteCount">Number of bytes in each sample</typeparam>
+  /// <param name="source">Samples whose byte order will be reversed</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  template<std::size_t ByteCount>
+  NUCLEX_AUDIO_TARGET_AVX2 void swapAvx2(
+    const std::byte *source, std::byte *target, std::size_t count
+  ) {
+    constexpr std::size_t samplesPerVector = 32 / ByteCount;
+
+    // The AVX2 byte shuffle works within each 128-bit half, which is all we need
+    // since samples never cross from one half into the other
+    const __m256i swapMask = _mm256_broadcastsi128_si256(getSwapMask<ByteCount>());
+
+    while(samplesPerVector <= count) {
+      __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(target), _mm256_shuffle_epi8(samples, swapMask)
+      );
+
+      source += 32;
+      target += 32;
+      count -= samplesPerVector;
+    }
+
+    swapSsse3<ByteCount>(source, target, count);
+  }
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Selects the fastest byte swapping kernels the CPU supports</summary>
+  /// <returns>A table with the fastest byte swapping kernels for the CPU</returns>
+  SwappingKernelTable selectKernels() {
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+    SwappingKernelTable table = {
+      &swapNeon<2>, &swap24Neon, &swapNeon<4>, &swapNeon<8>
+    };
+#elif defined(NUCLEX_AUDIO_HAVE_SSE2)
+    SwappingKernelTable table = {
+      &swap16Sse2, &swapScalar<3>, &swapScalar<4>, &swapScalar<8>
+    };
+#else
+    SwappingKernelTable table = {
+      &swapScalar<2>, &swapScalar<3>, &swapScalar<4>, &swapScalar<8>
+    };
+#endif
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    const Nuclex::Audio::Processing::CpuFeatures &features = (
+      Nuclex::Audio::Processing::CpuFeatures::Get()
+    );
+    if(features.HasAvx2) {
+      table = SwappingKernelTable {
+        &swapAvx2<2>, &swap24Ssse3, &swapAvx2<4>, &swapAvx2<8>
+      };
+    } else if(features.HasSsse3) {
+      table = SwappingKernelTable {
+        &swapSsse3<2>, &swap24Ssse3, &swapSsse3<4>, &swapSsse3<8>
+      };
+    }
+#endif
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the byte swapping kernel table, selecting them on first use</summary>
+  /// <returns>The kernel table with the fastest byte swapping kernels for the CPU</returns>
+  const SwappingKernelTable &getKernels() {
+    static const SwappingKernelTable kernels = selectKernels();
+    return kernels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ByteSwapping::Swap16(const std::byte *source, std::byte *target, std::size_t count) {
+    getKernels().Swap16(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ByteSwapping::Swap24(const std::byte *source, std::byte *target, std::size_t count) {
+    getKernels().Swap24(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ByteSwapping::Swap32(const std::byte *source, std::byte *target, std::size_t count) {
+    getKernels().Swap32(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ByteSwapping::Swap64(const std::byte *source, std::byte *target, std::size_t count) {
+    getKernels().Swap64(source, target, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
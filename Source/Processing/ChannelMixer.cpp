@@ -0,0 +1,705 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+
+#include "./CpuFeatures.h" // for CpuFeatures, NUCLEX_AUDIO_TARGET_AVX2_FMA
+
+#include <algorithm> // for std::copy_n(), std::fill_n(), std::find()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Factor by which a channel is attenuated by 3 dB</summary>
+  const float MinusThreeDecibels = 0.70710678f;
+
+  /// <summary>Factor by which a channel is attenuated by 6 dB</summary>
+  const float MinusSixDecibels = 0.5f;
+
+  /// <summary>Number of outputs the columns for dense interleaved mixing are padded to</summary>
+  const std::size_t ColumnAlignment = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of mixing kernels for one instruction set</summary>
+  struct MixingKernelTable {
+
+    /// <summary>Writes a channel multiplied by a weight into the output</summary>
+    public: void (*Scale)(const float *, float, float *, std::size_t);
+    /// <summary>Adds a channel multiplied by a weight to the output</summary>
+    public: void (*ScaleAdd)(const float *, float, float *, std::size_t);
+    /// <summary>Mixes interleaved frames through a dense matrix</summary>
+    public: void (*MixDense)(
+      const float *, std::size_t, const float *, std::size_t, float *, std::size_t
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the samples of a channel multiplied by a weight into the output</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Receives the weighted samples</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleScalar(const float *input, float coefficient, float *output, std::size_t count) {
+    for(std::size_t index = 0; index < count; ++index) {
+      output[index] = input[index] * coefficient;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds the samples of a channel multiplied by a weight to the output</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Samples to which the weighted samples will be added</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleAddScalar(const float *input, float coefficient, float *output, std::size_t count) {
+    for(std::size_t index = 0; index < count; ++index) {
+      output[index] += input[index] * coefficient;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_AUDIO_HAVE_SSE2) && !defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Mixes interleaved frames through a dense matrix one sample at a time</summary>
+  /// <param name="input">Interleaved input frames</param>
+  /// <param name="inputChannelCount">Number of channels in each input frame</param>
+  /// <param name="columns">Weights of each input in all outputs, padded per input</param>
+  /// <param name="outputChannelCount">Number of channels in each output frame</param>
+  /// <param name="output">Receives the interleaved output frames</param>
+  /// <param name="frameCount">Number of frames that will be mixed</param>
+  void mixDenseScalar(
+    const float *input, std::size_t inputChannelCount,
+    const float *columns, std::size_t outputChannelCount,
+    float *output, std::size_t frameCount
+  ) {
+    std::size_t stride = (outputChannelCount + ColumnAlignment - 1) / ColumnAlignment;
+    stride *= ColumnAlignment;
+
+    while(0 < frameCount) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+        float sum = 0.0f;
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          sum += input[inputIndex] * columns[inputIndex * stride + outputIndex];
+        }
+        output[outputIndex] = sum;
+      }
+
+      input += inputChannelCount;
+      output += outputChannelCount;
+      --frameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // !defined(NUCLEX_AUDIO_HAVE_SSE2) && !defined(NUCLEX_AUDIO_HAVE_NEON)
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Writes a weighted channel into the output, 4 samples at a time, using SSE2</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Receives the weighted samples</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleSse2(const float *input, float coefficient, float *output, std::size_t count) {
+    __m128 coefficientVector = _mm_set1_ps(coefficient);
+    while(3 < count) {
+      _mm_storeu_ps(output, _mm_mul_ps(_mm_loadu_ps(input), coefficientVector));
+      input += 4;
+      output += 4;
+      count -= 4;
+    }
+
+    scaleScalar(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a weighted channel to the output, 4 samples at a time, using SSE2</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Samples to which the weighted samples will be added</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleAddSse2(const float *input, float coefficient, float *output, std::size_t count) {
+    __m128 coefficientVector = _mm_set1_ps(coefficient);
+    while(3 < count) {
+      _mm_storeu_ps(
+        output,
+        _mm_add_ps(_mm_loadu_ps(output), _mm_mul_ps(_mm_loadu_ps(input), coefficientVector))
+      );
+      input += 4;
+      output += 4;
+      count -= 4;
+    }
+
+    scaleAddScalar(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes interleaved frames through a dense matrix using SSE2</summary>
+  /// <param name="input">Interleaved input frames</param>
+  /// <param name="inputChannelCount">Number of channels in each input frame</param>
+  /// <param name="columns">Weights of each input in all outputs, padded per input</param>
+  /// <param name="outputChannelCount">Number of channels in each output frame</param>
+  /// <param name="output">Receives the interleaved output frames</param>
+  /// <param name="frameCount">Number of frames that will be mixed</param>
+  void mixDenseSse2(
+    const float *input, std::size_t inputChannelCount,
+    const float *columns, std::size_t outputChannelCount,
+    float *output, std::size_t frameCount
+  ) {
+    std::size_t stride = (outputChannelCount + ColumnAlignment - 1) / ColumnAlignment;
+    stride *= ColumnAlignment;
+
+    // Each input sample is broadcast and multiplied with the weights it has in all
+    // outputs, so one frame is a handful of multiply-adds of whole vectors. Outputs
+    // beyond a multiple of 4 are computed in full and only partially stored.
+    while(0 < frameCount) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; outputIndex += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          sum = _mm_add_ps(
+            sum,
+            _mm_mul_ps(
+              _mm_set1_ps(input[inputIndex]),
+              _mm_loadu_ps(columns + (inputIndex * stride + outputIndex))
+            )
+          );
+        }
+
+        std::size_t remaining = outputChannelCount - outputIndex;
+        if(remaining >= 4) {
+          _mm_storeu_ps(output + outputIndex, sum);
+        } else {
+          float sums[4];
+          _mm_storeu_ps(sums, sum);
+          std::copy_n(sums, remaining, output + outputIndex);
+        }
+      }
+
+      input += inputChannelCount;
+      output += outputChannelCount;
+      --frameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Writes a weighted channel into the output, 8 samples at a time, using AVX2</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Receives the weighted samples</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  NUCLEX_AUDIO_TARGET_AVX2_FMA void scaleAvx2(
+    const float *input, float coefficient, float *output, std::size_t count
+  ) {
+    __m256 coefficientVector = _mm256_set1_ps(coefficient);
+    while(7 < count) {
+      _mm256_storeu_ps(output, _mm256_mul_ps(_mm256_loadu_ps(input), coefficientVector));
+      input += 8;
+      output += 8;
+      count -= 8;
+    }
+
+    scaleSse2(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a weighted channel to the output, 8 samples at a time, using FMA</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Samples to which the weighted samples will be added</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  NUCLEX_AUDIO_TARGET_AVX2_FMA void scaleAddAvx2(
+    const float *input, float coefficient, float *output, std::size_t count
+  ) {
+    __m256 coefficientVector = _mm256_set1_ps(coefficient);
+    while(7 < count) {
+      _mm256_storeu_ps(
+        output,
+        _mm256_fmadd_ps(_mm256_loadu_ps(input), coefficientVector, _mm256_loadu_ps(output))
+      );
+      input += 8;
+      output += 8;
+      count -= 8;
+    }
+
+    scaleAddSse2(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes interleaved frames through a dense matrix using FMA</summary>
+  /// <param name="input">Interleaved input frames</param>
+  /// <param name="inputChannelCount">Number of channels in each input frame</param>
+  /// <param name="columns">Weights of each input in all outputs, padded per input</param>
+  /// <param name="outputChannelCount">Number of channels in each output frame</param>
+  /// <param name="output">Receives the interleaved output frames</param>
+  /// <param name="frameCount">Number of frames that will be mixed</param>
+  NUCLEX_AUDIO_TARGET_AVX2_FMA void mixDenseAvx2(
+    const float *input, std::size_t inputChannelCount,
+    const float *columns, std::size_t outputChannelCount,
+    float *output, std::size_t frameCount
+  ) {
+    std::size_t stride = (outputChannelCount + ColumnAlignment - 1) / ColumnAlignment;
+    stride *= ColumnAlignment;
+
+    while(0 < frameCount) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; outputIndex += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          sum = _mm256_fmadd_ps(
+            _mm256_set1_ps(input[inputIndex]),
+            _mm256_loadu_ps(columns + (inputIndex * stride + outputIndex)),
+            sum
+          );
+        }
+
+        std::size_t remaining = outputChannelCount - outputIndex;
+        if(remaining >= 8) {
+          _mm256_storeu_ps(output + outputIndex, sum);
+        } else {
+          float sums[8];
+          _mm256_storeu_ps(sums, sum);
+          std::copy_n(sums, remaining, output + outputIndex);
+        }
+      }
+
+      input += inputChannelCount;
+      output += outputChannelCount;
+      --frameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Writes a weighted channel into the output, 4 samples at a time, using NEON</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Receives the weighted samples</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleNeon(const float *input, float coefficient, float *output, std::size_t count) {
+    while(3 < count) {
+      vst1q_f32(output, vmulq_n_f32(vld1q_f32(input), coefficient));
+      input += 4;
+      output += 4;
+      count -= 4;
+    }
+
+    scaleScalar(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a weighted channel to the output, 4 samples at a time, using NEON</summary>
+  /// <param name="input">Samples of the input channel</param>
+  /// <param name="coefficient">Weight by which the samples will be multiplied</param>
+  /// <param name="output">Samples to which the weighted samples will be added</param>
+  /// <param name="count">Number of samples that will be processed</param>
+  void scaleAddNeon(const float *input, float coefficient, float *output, std::size_t count) {
+    float32x4_t coefficientVector = vdupq_n_f32(coefficient);
+    while(3 < count) {
+      vst1q_f32(output, vfmaq_f32(vld1q_f32(output), vld1q_f32(input), coefficientVector));
+      input += 4;
+      output += 4;
+      count -= 4;
+    }
+
+    scaleAddScalar(input, coefficient, output, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes interleaved frames through a dense matrix using NEON</summary>
+  /// <param name="input">Interleaved input frames</param>
+  /// <param name="inputChannelCount">Number of channels in each input frame</param>
+  /// <param name="columns">Weights of each input in all outputs, padded per input</param>
+  /// <param name="outputChannelCount">Number of channels in each output frame</param>
+  /// <param name="output">Receives the interleaved output frames</param>
+  /// <param name="frameCount">Number of frames that will be mixed</param>
+  void mixDenseNeon(
+    const float *input, std::size_t inputChannelCount,
+    const float *columns, std::size_t outputChannelCount,
+    float *output, std::size_t frameCount
+  ) {
+    std::size_t stride = (outputChannelCount + ColumnAlignment - 1) / ColumnAlignment;
+    stride *= ColumnAlignment;
+
+    while(0 < frameCount) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; outputIndex += 4) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          sum = vfmaq_n_f32(
+            sum, vld1q_f32(columns + (inputIndex * stride + outputIndex)), input[inputIndex]
+          );
+        }
+
+        std::size_t remaining = outputChannelCount - outputIndex;
+        if(remaining >= 4) {
+          vst1q_f32(output + outputIndex, sum);
+        } else {
+          float sums[4];
+          vst1q_f32(sums, sum);
+          std::copy_n(sums, remaining, output + outputIndex);
+        }
+      }
+
+      input += inputChannelCount;
+      output += outputChannelCount;
+      --frameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Selects the fastest mixing kernels the CPU this is running on supports</summary>
+  /// <returns>A table with the fastest mixing kernels for the CPU</returns>
+  MixingKernelTable selectKernels() {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    MixingKernelTable table = { &scaleSse2, &scaleAddSse2, &mixDenseSse2 };
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    MixingKernelTable table = { &scaleNeon, &scaleAddNeon, &mixDenseNeon };
+#else
+    MixingKernelTable table = { &scaleScalar, &scaleAddScalar, &mixDenseScalar };
+#endif
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    if(Nuclex::Audio::Processing::CpuFeatures::Get().HasFma) {
+      table = MixingKernelTable { &scaleAvx2, &scaleAddAvx2, &mixDenseAvx2 };
+    }
+#endif
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the mixing kernel table, selecting the kernels on first use</summary>
+  /// <returns>The kernel table with the fastest mixing kernels for the CPU</returns>
+  const MixingKernelTable &getKernels() {
+    static const MixingKernelTable kernels = selectKernels();
+    return kernels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the index of a channel in a channel order</summary>
+  /// <param name="channelOrder">Channel order that will be searched</param>
+  /// <param name="placement">Placement of the channel that will be looked for</param>
+  /// <returns>The index of the channel or the channel count if it isn't present</returns>
+  std::size_t findChannel(
+    const std::vector<Nuclex::Audio::ChannelPlacement> &channelOrder,
+    Nuclex::Audio::ChannelPlacement placement
+  ) {
+    return static_cast<std::size_t>(
+      std::find(channelOrder.begin(), channelOrder.end(), placement) - channelOrder.begin()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> ChannelMixer::GetChannelOrder(ChannelPlacement layout) {
+    std::vector<ChannelPlacement> channelOrder;
+
+    std::size_t remaining = static_cast<std::size_t>(layout);
+    for(std::size_t bit = 1; remaining != 0; bit <<= 1) {
+      if((remaining & bit) != 0) {
+        channelOrder.push_back(static_cast<ChannelPlacement>(bit));
+        remaining &= ~bit;
+      }
+    }
+
+    return channelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelMixer ChannelMixer::CreateRouting(
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    const std::vector<ChannelPlacement> &outputChannelOrder
+  ) {
+    std::size_t inputChannelCount = inputChannelOrder.size();
+    std::size_t outputChannelCount = outputChannelOrder.size();
+
+    std::vector<float> coefficients(inputChannelCount * outputChannelCount, 0.0f);
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      std::size_t inputIndex = findChannel(inputChannelOrder, outputChannelOrder[outputIndex]);
+      if(inputIndex < inputChannelCount) {
+        coefficients[outputIndex * inputChannelCount + inputIndex] = 1.0f;
+      }
+    }
+
+    return ChannelMixer(DownmixMatrix(inputChannelOrder, outputChannelOrder, coefficients));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelMixer ChannelMixer::CreateUpmix(
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    const std::vector<ChannelPlacement> &outputChannelOrder
+  ) {
+    std::size_t inputChannelCount = inputChannelOrder.size();
+    std::size_t outputChannelCount = outputChannelOrder.size();
+
+    std::size_t frontLeft = findChannel(inputChannelOrder, ChannelPlacement::FrontLeft);
+    std::size_t frontRight = findChannel(inputChannelOrder, ChannelPlacement::FrontRight);
+    std::size_t frontCenter = findChannel(inputChannelOrder, ChannelPlacement::FrontCenter);
+    bool hasFrontPair = (frontLeft < inputChannelCount) && (frontRight < inputChannelCount);
+    bool isMono = (
+      (frontCenter < inputChannelCount) &&
+      (frontLeft == inputChannelCount) && (frontRight == inputChannelCount)
+    );
+
+    std::vector<float> coefficients(inputChannelCount * outputChannelCount, 0.0f);
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      float *row = coefficients.data() + (outputIndex * inputChannelCount);
+      ChannelPlacement placement = outputChannelOrder[outputIndex];
+
+      // Channels the input already has are taken over as they are
+      std::size_t inputIndex = findChannel(inputChannelOrder, placement);
+      if(inputIndex < inputChannelCount) {
+        row[inputIndex] = 1.0f;
+        continue;
+      }
+
+      // Other channels are synthesized from their neighbours, if there are any
+      switch(placement) {
+        case ChannelPlacement::FrontCenter: {
+          if(hasFrontPair) {
+            row[frontLeft] = MinusSixDecibels;
+            row[frontRight] = MinusSixDecibels;
+          }
+          break;
+        }
+        case ChannelPlacement::FrontLeft:
+        case ChannelPlacement::FrontRight: {
+          if(isMono) {
+            row[frontCenter] = MinusThreeDecibels;
+          }
+          break;
+        }
+        case ChannelPlacement::BackLeft:
+        case ChannelPlacement::SideLeft: {
+          ChannelPlacement counterpart = (
+            (placement == ChannelPlacement::BackLeft) ?
+            ChannelPlacement::SideLeft : ChannelPlacement::BackLeft
+          );
+          std::size_t counterpartIndex = findChannel(inputChannelOrder, counterpart);
+          if(counterpartIndex < inputChannelCount) {
+            row[counterpartIndex] = 1.0f;
+          } else if(frontLeft < inputChannelCount) {
+            row[frontLeft] = MinusThreeDecibels;
+          }
+          break;
+        }
+        case ChannelPlacement::BackRight:
+        case ChannelPlacement::SideRight: {
+          ChannelPlacement counterpart = (
+            (placement == ChannelPlacement::BackRight) ?
+            ChannelPlacement::SideRight : ChannelPlacement::BackRight
+          );
+          std::size_t counterpartIndex = findChannel(inputChannelOrder, counterpart);
+          if(counterpartIndex < inputChannelCount) {
+            row[counterpartIndex] = 1.0f;
+          } else if(frontRight < inputChannelCount) {
+            row[frontRight] = MinusThreeDecibels;
+          }
+          break;
+        }
+        default: { break; } // LFE and height channels are left silent
+      }
+    }
+
+    return ChannelMixer(DownmixMatrix(inputChannelOrder, outputChannelOrder, coefficients));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelMixer::ChannelMixer(const DownmixMatrix &matrix) :
+    matrix(matrix),
+    strategy(Strategy::Routing),
+    terms(),
+    termStarts(),
+    columns() {
+
+    std::size_t inputChannelCount = matrix.CountInputChannels();
+    std::size_t outputChannelCount = matrix.CountOutputChannels();
+
+    // Collect the non-zero weights of each output. If every output has at most
+    // a single weight of exactly 1, the matrix only reorders or drops channels.
+    this->termStarts.reserve(outputChannelCount + 1);
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      this->termStarts.push_back(this->terms.size());
+      for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+        float coefficient = matrix.GetCoefficient(outputIndex, inputIndex);
+        if(coefficient != 0.0f) {
+          this->terms.push_back(Term { inputIndex, coefficient });
+        }
+      }
+
+      std::size_t termCount = this->terms.size() - this->termStarts.back();
+      bool isRouted = (
+        (termCount == 0) || ((termCount == 1) && (this->terms.back().Coefficient == 1.0f))
+      );
+      if(!isRouted) {
+        this->strategy = Strategy::Sparse;
+      }
+    }
+    this->termStarts.push_back(this->terms.size());
+
+    // When more than half the weights are used, multiplying by the zeros is cheaper
+    // than skipping them for interleaved frames, so lay out the weights for that
+    if(this->strategy == Strategy::Sparse) {
+      if(this->terms.size() * 2 > inputChannelCount * outputChannelCount) {
+        this->strategy = Strategy::Dense;
+
+        std::size_t stride = (outputChannelCount + ColumnAlignment - 1) / ColumnAlignment;
+        stride *= ColumnAlignment;
+
+        this->columns.resize(inputChannelCount * stride, 0.0f);
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+            this->columns[inputIndex * stride + outputIndex] = (
+              matrix.GetCoefficient(outputIndex, inputIndex)
+            );
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChannelMixer::MixSeparated(
+    const float *const inputs[], float *const outputs[], std::size_t frameCount
+  ) const {
+    const MixingKernelTable &kernels = getKernels();
+
+    // Separated channels are contiguous, so each output is accumulated from its
+    // non-zero terms in long vector runs, no matter how dense the matrix is
+    std::size_t outputChannelCount = this->matrix.CountOutputChannels();
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      float *output = outputs[outputIndex];
+      if(output == nullptr) {
+        continue; // Caller is not interested in this channel
+      }
+
+      std::size_t termIndex = this->termStarts[outputIndex];
+      std::size_t termEnd = this->termStarts[outputIndex + 1];
+      if(termIndex == termEnd) {
+        std::fill_n(output, frameCount, 0.0f);
+        continue;
+      }
+
+      const Term &first = this->terms[termIndex];
+      if(first.Coefficient == 1.0f) {
+        std::copy_n(inputs[first.InputIndex], frameCount, output);
+      } else {
+        kernels.Scale(inputs[first.InputIndex], first.Coefficient, output, frameCount);
+      }
+
+      for(++termIndex; termIndex < termEnd; ++termIndex) {
+        const Term &term = this->terms[termIndex];
+        kernels.ScaleAdd(inputs[term.InputIndex], term.Coefficient, output, frameCount);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChannelMixer::MixInterleaved(
+    const float *input, float *output, std::size_t frameCount
+  ) const {
+    std::size_t inputChannelCount = this->matrix.CountInputChannels();
+    std::size_t outputChannelCount = this->matrix.CountOutputChannels();
+
+    if(this->strategy == Strategy::Dense) {
+      getKernels().MixDense(
+        input, inputChannelCount,
+        this->columns.data(), outputChannelCount,
+        output, frameCount
+      );
+      return;
+    }
+
+    if(this->strategy == Strategy::Routing) {
+      while(0 < frameCount) {
+        for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+          std::size_t termIndex = this->termStarts[outputIndex];
+          if(termIndex == this->termStarts[outputIndex + 1]) {
+            output[outputIndex] = 0.0f;
+          } else {
+            output[outputIndex] = input[this->terms[termIndex].InputIndex];
+          }
+        }
+
+        input += inputChannelCount;
+        output += outputChannelCount;
+        --frameCount;
+      }
+    } else { // sparse
+      while(0 < frameCount) {
+        for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+          float sum = 0.0f;
+          std::size_t termIndex = this->termStarts[outputIndex];
+          std::size_t termEnd = this->termStarts[outputIndex + 1];
+          for(; termIndex < termEnd; ++termIndex) {
+            const Term &term = this->terms[termIndex];
+            sum += input[term.InputIndex] * term.Coefficient;
+          }
+          output[outputIndex] = sum;
+        }
+
+        input += inputChannelCount;
+        output += outputChannelCount;
+        --frameCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,405 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ClippingFinder.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::max(), std::fill()
+#include <cmath> // for std::ceil(), std::abs()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of samples whose clipping state is packed into one bit mask</summary>
+  const std::size_t MaskSampleCount = 64;
+
+  /// <summary>Number of frames decoded at once when scanning an audio track</summary>
+  const std::size_t DecodingBlockFrameCount = 65536;
+
+  /// <summary>Run start frame that indicates a channel currently has no open run</summary>
+  const std::uint64_t NoOpenRun = std::numeric_limits<std::uint64_t>::max();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a full scale relative threshold into an integer magnitude</summary>
+  /// <param name="threshold">Threshold relative to full scale</param>
+  /// <param name="fullScale">Largest positive value of the integer type</param>
+  /// <returns>The smallest integer magnitude that counts as clipped</returns>
+  std::int64_t getIntegerThreshold(float threshold, std::int64_t fullScale) {
+    double scaled = std::ceil(static_cast<double>(threshold) * static_cast<double>(fullScale));
+    return static_cast<std::int64_t>(
+      std::max(1.0, std::min(scaled, static_cast<double>(fullScale)))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+  /// <summary>Packs the lanes of a NEON comparison result into a 4 bit mask</summary>
+  /// <param name="comparison">Comparison result with all bits set in matching lanes</param>
+  /// <returns>A bit mask with one bit for each lane</returns>
+  inline std::uint64_t packLanes(uint32x4_t comparison) {
+    const std::uint32_t laneBits[] = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(comparison, vld1q_u32(laneBits)));
+  }
+
+  /// <summary>Packs the lanes of a NEON comparison result into an 8 bit mask</summary>
+  /// <param name="comparison">Comparison result with all bits set in matching lanes</param>
+  /// <returns>A bit mask with one bit for each lane</returns>
+  inline std::uint64_t packLanes(uint16x8_t comparison) {
+    const std::uint16_t laneBits[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    return vaddvq_u16(vandq_u16(comparison, vld1q_u16(laneBits)));
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a bit mask flagging the clipped samples in a group</summary>
+  /// <param name="samples">Samples that will be compared against the threshold</param>
+  /// <param name="sampleCount">Number of samples in the group, up to 64</param>
+  /// <param name="threshold">Magnitude from which on samples count as clipped</param>
+  /// <returns>A bit mask with one bit set for each clipped sample</returns>
+  std::uint64_t buildClippingMask(
+    const float *samples, std::size_t sampleCount, float threshold
+  ) {
+    std::uint64_t mask = 0;
+    std::size_t index = 0;
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128 signBits = _mm_set1_ps(-0.0f);
+    const __m128 thresholds = _mm_set1_ps(threshold);
+    for(; index + 3 < sampleCount; index += 4) {
+      __m128 magnitudes = _mm_andnot_ps(signBits, _mm_loadu_ps(samples + index));
+      std::uint64_t bits = static_cast<std::uint64_t>(
+        _mm_movemask_ps(_mm_cmpge_ps(magnitudes, thresholds))
+      );
+      mask |= bits << index;
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const float32x4_t thresholds = vdupq_n_f32(threshold);
+    for(; index + 3 < sampleCount; index += 4) {
+      mask |= packLanes(vcageq_f32(vld1q_f32(samples + index), thresholds)) << index;
+    }
+#endif
+    for(; index < sampleCount; ++index) {
+      if(std::abs(samples[index]) >= threshold) {
+        mask |= std::uint64_t(1) << index;
+      }
+    }
+
+    return mask;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a bit mask flagging the clipped samples in a group</summary>
+  /// <param name="samples">Samples that will be compared against the threshold</param>
+  /// <param name="sampleCount">Number of samples in the group, up to 64</param>
+  /// <param name="threshold">Magnitude from which on samples count as clipped</param>
+  /// <returns>A bit mask with one bit set for each clipped sample</returns>
+  std::uint64_t buildClippingMask(
+    const std::int16_t *samples, std::size_t sampleCount, std::int16_t threshold
+  ) {
+    std::uint64_t mask = 0;
+    std::size_t index = 0;
+
+    // Magnitudes can't be formed without overflowing at -32768, so both signs are
+    // compared separately: x >= threshold or x <= -threshold
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128i upperBounds = _mm_set1_epi16(static_cast<std::int16_t>(threshold - 1));
+    const __m128i lowerBounds = _mm_set1_epi16(static_cast<std::int16_t>(1 - threshold));
+    for(; index + 7 < sampleCount; index += 8) {
+      __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + index));
+      __m128i clipped = _mm_or_si128(
+        _mm_cmpgt_epi16(values, upperBounds), _mm_cmplt_epi16(values, lowerBounds)
+      );
+      std::uint64_t bits = static_cast<std::uint64_t>(
+        _mm_movemask_epi8(_mm_packs_epi16(clipped, clipped)) & 0xFF
+      );
+      mask |= bits << index;
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const int16x8_t upperBounds = vdupq_n_s16(threshold);
+    const int16x8_t lowerBounds = vdupq_n_s16(static_cast<std::int16_t>(-threshold));
+    for(; index + 7 < sampleCount; index += 8) {
+      int16x8_t values = vld1q_s16(samples + index);
+      uint16x8_t clipped = vorrq_u16(
+        vcgeq_s16(values, upperBounds), vcleq_s16(values, lowerBounds)
+      );
+      mask |= packLanes(clipped) << index;
+    }
+#endif
+    for(; index < sampleCount; ++index) {
+      if((samples[index] >= threshold) || (samples[index] <= -threshold)) {
+        mask |= std::uint64_t(1) << index;
+      }
+    }
+
+    return mask;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a bit mask flagging the clipped samples in a group</summary>
+  /// <param name="samples">Samples that will be compared against the threshold</param>
+  /// <param name="sampleCount">Number of samples in the group, up to 64</param>
+  /// <param name="threshold">Magnitude from which on samples count as clipped</param>
+  /// <returns>A bit mask with one bit set for each clipped sample</returns>
+  std::uint64_t buildClippingMask(
+    const std::int32_t *samples, std::size_t sampleCount, std::int32_t threshold
+  ) {
+    std::uint64_t mask = 0;
+    std::size_t index = 0;
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128i upperBounds = _mm_set1_epi32(threshold - 1);
+    const __m128i lowerBounds = _mm_set1_epi32(1 - threshold);
+    for(; index + 3 < sampleCount; index += 4) {
+      __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + index));
+      __m128i clipped = _mm_or_si128(
+        _mm_cmpgt_epi32(values, upperBounds), _mm_cmplt_epi32(values, lowerBounds)
+      );
+      std::uint64_t bits = static_cast<std::uint64_t>(
+        _mm_movemask_ps(_mm_castsi128_ps(clipped))
+      );
+      mask |= bits << index;
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const int32x4_t upperBounds = vdupq_n_s32(threshold);
+    const int32x4_t lowerBounds = vdupq_n_s32(-threshold);
+    for(; index + 3 < sampleCount; index += 4) {
+      int32x4_t values = vld1q_s32(samples + index);
+      uint32x4_t clipped = vorrq_u32(
+        vcgeq_s32(values, upperBounds), vcleq_s32(values, lowerBounds)
+      );
+      mask |= packLanes(clipped) << index;
+    }
+#endif
+    for(; index < sampleCount; ++index) {
+      if((samples[index] >= threshold) || (samples[index] <= -threshold)) {
+        mask |= std::uint64_t(1) << index;
+      }
+    }
+
+    return mask;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes an audio track block by block and feeds it to a clipping finder</summary>
+  /// <typeparam name="TSample">Type of samples the track will be decoded as</typeparam>
+  /// <param name="decoder">Decoder for the audio track that will be scanned</param>
+  /// <param name="finder">Clipping finder that will scan the decoded samples</param>
+  template<typename TSample>
+  void scanTrack(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    Nuclex::Audio::Processing::ClippingFinder &finder
+  ) {
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    std::size_t blockFrameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(totalFrameCount, DecodingBlockFrameCount)
+    );
+
+    std::vector<TSample> buffer(blockFrameCount * decoder.CountChannels());
+    for(std::uint64_t start = 0; start < totalFrameCount; start += blockFrameCount) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(blockFrameCount, totalFrameCount - start)
+      );
+      decoder.DecodeInterleaved(buffer.data(), start, frameCount);
+      finder.ProcessInterleaved(buffer.data(), frameCount);
+    }
+
+    finder.Finish();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ClippedInterval> ClippingFinder::FindClippedIntervals(
+    const Storage::AudioTrackDecoder &decoder,
+    float threshold /* = 0.999f */,
+    std::size_t minimumFrameCount /* = 3 */
+  ) {
+    ClippingFinder finder(decoder.CountChannels(), threshold, minimumFrameCount);
+
+    // Integer formats are scanned as integers so that no precision is lost and
+    // there is no reconstruction to floating point that needs to be paid for
+    switch(decoder.GetNativeSampleFormat()) {
+      case AudioSampleFormat::UnsignedInteger_8:
+      case AudioSampleFormat::SignedInteger_16: {
+        scanTrack<std::int16_t>(decoder, finder);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_24:
+      case AudioSampleFormat::SignedInteger_32: {
+        scanTrack<std::int32_t>(decoder, finder);
+        break;
+      }
+      default: {
+        scanTrack<float>(decoder, finder);
+        break;
+      }
+    }
+
+    return finder.intervals;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ClippingFinder::ClippingFinder(
+    std::size_t channelCount,
+    float threshold /* = 0.999f */,
+    std::size_t minimumFrameCount /* = 3 */
+  ) :
+    channelCount(channelCount),
+    floatThreshold(threshold),
+    int16Threshold(static_cast<std::int16_t>(getIntegerThreshold(threshold, 32767))),
+    int32Threshold(static_cast<std::int32_t>(getIntegerThreshold(threshold, 2147483647))),
+    minimumFrameCount(std::max<std::size_t>(minimumFrameCount, 1)),
+    processedSampleCount(0),
+    runStartFrames(channelCount, NoOpenRun),
+    openRunCount(0),
+    intervals() {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Clipping finder needs at least one channel");
+    }
+    if(unlikely(!(threshold > 0.0f))) {
+      throw std::invalid_argument(u8"Clipping threshold must be a positive level");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::Reset() {
+    this->processedSampleCount = 0;
+    std::fill(this->runStartFrames.begin(), this->runStartFrames.end(), NoOpenRun);
+    this->openRunCount = 0;
+    this->intervals.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, this->floatThreshold);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::ProcessInterleaved(const std::int16_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, this->int16Threshold);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::ProcessInterleaved(const std::int32_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, this->int32Threshold);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::Finish() {
+    if(this->openRunCount > 0) {
+      std::uint64_t endFrame = this->processedSampleCount / this->channelCount;
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        if(this->runStartFrames[index] != NoOpenRun) {
+          closeRun(index, endFrame);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void ClippingFinder::processInterleaved(
+    const TSample *samples, std::size_t frameCount, TSample threshold
+  ) {
+    std::size_t sampleCount = frameCount * this->channelCount;
+    while(0 < sampleCount) {
+      std::size_t groupSampleCount = std::min(sampleCount, MaskSampleCount);
+
+      // Most groups have neither clipped samples nor runs that need closing,
+      // so after the vectorized comparison, there's nothing to do for them
+      std::uint64_t mask = buildClippingMask(samples, groupSampleCount, threshold);
+      if(unlikely((mask != 0) || (this->openRunCount > 0))) {
+        scanMask(mask, groupSampleCount);
+      }
+
+      this->processedSampleCount += groupSampleCount;
+      samples += groupSampleCount;
+      sampleCount -= groupSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::scanMask(std::uint64_t mask, std::size_t sampleCount) {
+    std::size_t channelIndex = static_cast<std::size_t>(
+      this->processedSampleCount % this->channelCount
+    );
+    std::uint64_t frameIndex = this->processedSampleCount / this->channelCount;
+
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      bool isClipped = (((mask >> index) & 1) != 0);
+      bool hasOpenRun = (this->runStartFrames[channelIndex] != NoOpenRun);
+      if(isClipped && !hasOpenRun) {
+        this->runStartFrames[channelIndex] = frameIndex;
+        ++this->openRunCount;
+      } else if(!isClipped && hasOpenRun) {
+        closeRun(channelIndex, frameIndex);
+      }
+
+      ++channelIndex;
+      if(channelIndex == this->channelCount) {
+        channelIndex = 0;
+        ++frameIndex;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingFinder::closeRun(std::size_t channelIndex, std::uint64_t endFrame) {
+    std::uint64_t startFrame = this->runStartFrames[channelIndex];
+    if(endFrame - startFrame >= this->minimumFrameCount) {
+      ClippedInterval interval;
+      interval.ChannelIndex = channelIndex;
+      interval.StartFrame = startFrame;
+      interval.FrameCount = endFrame - startFrame;
+      this->intervals.push_back(interval);
+    }
+
+    this->runStartFrames[channelIndex] = NoOpenRun;
+    --this->openRunCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,398 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ContentHasher.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded at once when hashing an audio track</summary>
+  const std::size_t DecodingBlockFrameCount = 65536;
+
+  /// <summary>Key of the first sample for the lower half of the hash</summary>
+  const std::uint64_t LowSeed = 0x243F6A8885A308D3ULL;
+  /// <summary>Amount by which the key for the lower half advances per sample</summary>
+  const std::uint64_t LowStep = 0x9E3779B97F4A7C15ULL;
+  /// <summary>Key of the first sample for the upper half of the hash</summary>
+  const std::uint64_t HighSeed = 0x13198A2E03707344ULL;
+  /// <summary>Amount by which the key for the upper half advances per sample</summary>
+  const std::uint64_t HighStep = 0xC2B2AE3D27D4EB4FULL;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rotates the bits of a 64 bit integer to the left</summary>
+  /// <param name="value">Value whose bits will be rotated</param>
+  /// <param name="shift">Number of bits by which the value will be rotated</param>
+  /// <returns>The value with its bits rotated to the left</returns>
+  inline std::uint64_t rotateLeft(std::uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes the bits of a 64 bit integer so each input bit affects all others</summary>
+  /// <param name="value">Value whose bits will be mixed</param>
+  /// <returns>The mixed value</returns>
+  inline std::uint64_t mix(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes a sample with its positional key into a value that can be summed</summary>
+  /// <param name="bits">Bit pattern of the 32 bit float sample</param>
+  /// <param name="key">Key derived from the position of the sample in the track</param>
+  /// <returns>The value the sample contributes to the sum</returns>
+  /// <remarks>
+  ///   The SIMD paths in <see cref="accumulateSamples" /> compute exactly the same as this.
+  /// </remarks>
+  inline std::uint64_t mixSample(std::uint32_t bits, std::uint64_t key) {
+    std::uint32_t rotated = (bits << 16) | (bits >> 16);
+    std::uint64_t mixed = (
+      (static_cast<std::uint64_t>(bits) | (static_cast<std::uint64_t>(rotated) << 32)) ^ key
+    );
+    return (
+      static_cast<std::uint64_t>(static_cast<std::uint32_t>(mixed)) * (mixed >> 32) +
+      rotateLeft(mixed, 32)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds the mixed samples of a contiguous run of samples to the sums</summary>
+  /// <param name="samples">Samples that will be added to the sums</param>
+  /// <param name="sampleCount">Number of samples to add</param>
+  /// <param name="firstIndex">Index of the first sample within the whole track</param>
+  /// <param name="lowSum">Sum for the lower half of the hash</param>
+  /// <param name="highSum">Sum for the upper half of the hash</param>
+  void accumulateSamples(
+    const float *samples, std::size_t sampleCount, std::uint64_t firstIndex,
+    std::uint64_t &lowSum, std::uint64_t &highSum
+  ) {
+    std::size_t index = 0;
+    std::uint64_t lowKey = LowSeed + firstIndex * LowStep;
+    std::uint64_t highKey = HighSeed + firstIndex * HighStep;
+
+    // Each sample is widened into a 64 bit lane, so a 128 bit register handles two of them.
+    // The keys of four consecutive samples are kept in two registers per half and advance
+    // by four steps per iteration, thus the loop does not depend on anything but additions.
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    if(sampleCount >= 4) {
+      __m128i lowKeys[2], highKeys[2];
+      for(std::size_t pair = 0; pair < 2; ++pair) {
+        std::uint64_t first = pair * 2;
+        lowKeys[pair] = _mm_set_epi64x(
+          static_cast<std::int64_t>(lowKey + (first + 1) * LowStep),
+          static_cast<std::int64_t>(lowKey + first * LowStep)
+        );
+        highKeys[pair] = _mm_set_epi64x(
+          static_cast<std::int64_t>(highKey + (first + 1) * HighStep),
+          static_cast<std::int64_t>(highKey + first * HighStep)
+        );
+      }
+      const __m128i lowAdvance = _mm_set1_epi64x(static_cast<std::int64_t>(LowStep * 4));
+      const __m128i highAdvance = _mm_set1_epi64x(static_cast<std::int64_t>(HighStep * 4));
+
+      __m128i lowSums = _mm_setzero_si128();
+      __m128i highSums = _mm_setzero_si128();
+      for(; index + 3 < sampleCount; index += 4) {
+        __m128i bits = _mm_castps_si128(_mm_loadu_ps(samples + index));
+        __m128i rotated = _mm_or_si128(_mm_slli_epi32(bits, 16), _mm_srli_epi32(bits, 16));
+        __m128i widened[2] = {
+          _mm_unpacklo_epi32(bits, rotated), _mm_unpackhi_epi32(bits, rotated)
+        };
+        for(std::size_t pair = 0; pair < 2; ++pair) {
+          __m128i mixed = _mm_xor_si128(widened[pair], lowKeys[pair]);
+          lowSums = _mm_add_epi64(
+            lowSums, _mm_add_epi64(
+              _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32)), _mm_shuffle_epi32(mixed, 0xB1)
+            )
+          );
+          mixed = _mm_xor_si128(widened[pair], highKeys[pair]);
+          highSums = _mm_add_epi64(
+            highSums, _mm_add_epi64(
+              _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32)), _mm_shuffle_epi32(mixed, 0xB1)
+            )
+          );
+          lowKeys[pair] = _mm_add_epi64(lowKeys[pair], lowAdvance);
+          highKeys[pair] = _mm_add_epi64(highKeys[pair], highAdvance);
+        }
+      }
+
+      std::uint64_t lanes[2];
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), lowSums);
+      lowSum += lanes[0] + lanes[1];
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), highSums);
+      highSum += lanes[0] + lanes[1];
+
+      lowKey += index * LowStep;
+      highKey += index * HighStep;
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    if(sampleCount >= 4) {
+      uint64x2_t lowKeys[2], highKeys[2];
+      for(std::size_t pair = 0; pair < 2; ++pair) {
+        std::uint64_t first = pair * 2;
+        const std::uint64_t lowLanes[] = {
+          lowKey + first * LowStep, lowKey + (first + 1) * LowStep
+        };
+        const std::uint64_t highLanes[] = {
+          highKey + first * HighStep, highKey + (first + 1) * HighStep
+        };
+        lowKeys[pair] = vld1q_u64(lowLanes);
+        highKeys[pair] = vld1q_u64(highLanes);
+      }
+      const uint64x2_t lowAdvance = vdupq_n_u64(LowStep * 4);
+      const uint64x2_t highAdvance = vdupq_n_u64(HighStep * 4);
+
+      uint64x2_t lowSums = vdupq_n_u64(0);
+      uint64x2_t highSums = vdupq_n_u64(0);
+      for(; index + 3 < sampleCount; index += 4) {
+        uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(samples + index));
+        uint32x4_t rotated = vorrq_u32(vshlq_n_u32(bits, 16), vshrq_n_u32(bits, 16));
+        uint32x4x2_t widened = vzipq_u32(bits, rotated);
+        for(std::size_t pair = 0; pair < 2; ++pair) {
+          uint64x2_t mixed = veorq_u64(vreinterpretq_u64_u32(widened.val[pair]), lowKeys[pair]);
+          lowSums = vaddq_u64(
+            lowSums, vaddq_u64(
+              vmull_u32(vmovn_u64(mixed), vshrn_n_u64(mixed, 32)),
+              vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(mixed)))
+            )
+          );
+          mixed = veorq_u64(vreinterpretq_u64_u32(widened.val[pair]), highKeys[pair]);
+          highSums = vaddq_u64(
+            highSums, vaddq_u64(
+              vmull_u32(vmovn_u64(mixed), vshrn_n_u64(mixed, 32)),
+              vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(mixed)))
+            )
+          );
+          lowKeys[pair] = vaddq_u64(lowKeys[pair], lowAdvance);
+          highKeys[pair] = vaddq_u64(highKeys[pair], highAdvance);
+        }
+      }
+
+      lowSum += vgetq_lane_u64(lowSums, 0) + vgetq_lane_u64(lowSums, 1);
+      highSum += vgetq_lane_u64(highSums, 0) + vgetq_lane_u64(highSums, 1);
+
+      lowKey += index * LowStep;
+      highKey += index * HighStep;
+    }
+#endif
+    for(; index < sampleCount; ++index) {
+      std::uint32_t bits;
+      std::memcpy(&bits, samples + index, sizeof(bits));
+      lowSum += mixSample(bits, lowKey);
+      highSum += mixSample(bits, highKey);
+      lowKey += LowStep;
+      highKey += HighStep;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Forms the final hash from the sums over a range of samples</summary>
+  /// <param name="lowSum">Sum for the lower half of the hash</param>
+  /// <param name="highSum">Sum for the upper half of the hash</param>
+  /// <param name="frameCount">Number of frames that went into the sums</param>
+  /// <param name="channelCount">Number of channels in each frame</param>
+  /// <returns>The hash over the range of samples</returns>
+  Nuclex::Audio::Processing::ContentHash finalizeHash(
+    std::uint64_t lowSum, std::uint64_t highSum,
+    std::uint64_t frameCount, std::size_t channelCount
+  ) {
+    std::uint64_t shape = mix(
+      (frameCount * 0x9FB21C651E98DF25ULL) ^ static_cast<std::uint64_t>(channelCount)
+    );
+    std::uint64_t low = mix(lowSum ^ shape);
+    std::uint64_t high = mix(highSum + shape);
+
+    Nuclex::Audio::Processing::ContentHash hash;
+    hash.Low = low + high;
+    hash.High = high ^ rotateLeft(low, 29);
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHash ContentHasher::HashTrack(const Storage::AudioTrackDecoder &decoder) {
+    ContentHasher hasher(decoder.CountChannels());
+
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    std::size_t blockFrameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(totalFrameCount, DecodingBlockFrameCount)
+    );
+
+    std::vector<float> buffer(blockFrameCount * decoder.CountChannels());
+    for(std::uint64_t start = 0; start < totalFrameCount; start += blockFrameCount) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(blockFrameCount, totalFrameCount - start)
+      );
+      decoder.DecodeInterleaved(buffer.data(), start, frameCount);
+      hasher.ProcessInterleaved(buffer.data(), frameCount);
+    }
+
+    return hasher.GetHash();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHasher::ContentHasher(
+    std::size_t channelCount,
+    std::size_t blockFrameCount /* = 0 */,
+    std::uint64_t startFrame /* = 0 */
+  ) :
+    channelCount(channelCount),
+    blockFrameCount(blockFrameCount),
+    nextFrame(startFrame),
+    totalSums(),
+    blockSums() {
+    if(channelCount == 0) {
+      throw std::invalid_argument(u8"Content hasher needs at least one channel");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContentHasher::Reset(std::uint64_t startFrame /* = 0 */) {
+    this->nextFrame = startFrame;
+    this->totalSums = Sums();
+    this->blockSums.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContentHasher::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    while(frameCount > 0) {
+
+      // If block hashes are kept, stop each run at the next block boundary so its
+      // samples can be added to the block's sums as well as to the total
+      std::size_t runFrameCount = frameCount;
+      Sums *block = nullptr;
+      if(this->blockFrameCount > 0) {
+        std::size_t blockIndex = static_cast<std::size_t>(
+          this->nextFrame / this->blockFrameCount
+        );
+        std::size_t offset = static_cast<std::size_t>(this->nextFrame % this->blockFrameCount);
+        runFrameCount = std::min(runFrameCount, this->blockFrameCount - offset);
+        if(blockIndex >= this->blockSums.size()) {
+          this->blockSums.resize(blockIndex + 1, Sums());
+        }
+        block = &this->blockSums[blockIndex];
+      }
+
+      Sums run = Sums();
+      std::size_t runSampleCount = runFrameCount * this->channelCount;
+      accumulateSamples(
+        samples, runSampleCount, this->nextFrame * this->channelCount, run.Low, run.High
+      );
+      run.FrameCount = runFrameCount;
+
+      this->totalSums.Low += run.Low;
+      this->totalSums.High += run.High;
+      this->totalSums.FrameCount += run.FrameCount;
+      if(block != nullptr) {
+        block->Low += run.Low;
+        block->High += run.High;
+        block->FrameCount += run.FrameCount;
+      }
+
+      samples += runSampleCount;
+      frameCount -= runFrameCount;
+      this->nextFrame += runFrameCount;
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContentHasher::Merge(const ContentHasher &other) {
+    if(
+      (other.channelCount != this->channelCount) ||
+      (other.blockFrameCount != this->blockFrameCount)
+    ) {
+      throw std::invalid_argument(
+        u8"Merged content hasher must use the same channel count and block size"
+      );
+    }
+
+    this->totalSums.Low += other.totalSums.Low;
+    this->totalSums.High += other.totalSums.High;
+    this->totalSums.FrameCount += other.totalSums.FrameCount;
+
+    if(other.blockSums.size() > this->blockSums.size()) {
+      this->blockSums.resize(other.blockSums.size(), Sums());
+    }
+    for(std::size_t index = 0; index < other.blockSums.size(); ++index) {
+      this->blockSums[index].Low += other.blockSums[index].Low;
+      this->blockSums[index].High += other.blockSums[index].High;
+      this->blockSums[index].FrameCount += other.blockSums[index].FrameCount;
+    }
+
+    this->nextFrame = std::max(this->nextFrame, other.nextFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHash ContentHasher::GetHash() const {
+    return finalizeHash(
+      this->totalSums.Low, this->totalSums.High, this->totalSums.FrameCount, this->channelCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ContentHasher::CountBlocks() const {
+    return this->blockSums.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHash ContentHasher::GetBlockHash(std::size_t blockIndex) const {
+    if(blockIndex >= this->blockSums.size()) {
+      throw std::out_of_range(u8"Block index is out of range");
+    }
+
+    const Sums &block = this->blockSums[blockIndex];
+    return finalizeHash(block.Low, block.High, block.FrameCount, this->channelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
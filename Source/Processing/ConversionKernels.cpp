@@ -0,0 +1,869 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Processing/Quantization.h"
+#include "Nuclex/Audio/Processing/Reconstruction.h"
+
+#include "./CpuFeatures.h" // for CpuFeatures, NUCLEX_AUDIO_TARGET_AVX2
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <cstring> // for std::memcpy()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of conversion kernels for one instruction set</summary>
+  struct KernelTable {
+
+    /// <summary>Instruction set the kernels in the table are using</summary>
+    public: Nuclex::Audio::Processing::ConversionKernelSet KernelSet;
+    /// <summary>Multiplies and rounds floats to integers</summary>
+    public: void (*QuantizeFloat)(const float *, float, std::int32_t *, std::size_t);
+    /// <summary>Multiplies and rounds floats to integers with double precision</summary>
+    public: void (*QuantizeFloatAsDouble)(const float *, double, std::int32_t *, std::size_t);
+    /// <summary>Multiplies and rounds doubles to integers</summary>
+    public: void (*QuantizeDouble)(const double *, double, std::int32_t *, std::size_t);
+    /// <summary>Shifts and divides integers to floats</summary>
+    public: void (*ReconstructFloat)(const std::int32_t *, int, float, float *, std::size_t);
+    /// <summary>Shifts and divides integers to floats with double precision</summary>
+    public: void (*ReconstructFloatAsDouble)(
+      const std::int32_t *, int, double, float *, std::size_t
+    );
+    /// <summary>Shifts and divides integers to doubles</summary>
+    public: void (*ReconstructDouble)(const std::int32_t *, int, double, double *, std::size_t);
+    /// <summary>Rounds floats to half precision floats</summary>
+    public: void (*NarrowToFloat16)(const float *, Nuclex::Audio::Float16 *, std::size_t);
+    /// <summary>Widens half precision floats to floats</summary>
+    public: void (*WidenFromFloat16)(const Nuclex::Audio::Float16 *, float *, std::size_t);
+    /// <summary>Rounds floats to brain floats</summary>
+    public: void (*NarrowToBFloat16)(const float *, Nuclex::Audio::BFloat16 *, std::size_t);
+    /// <summary>Widens brain floats to floats</summary>
+    public: void (*WidenFromBFloat16)(const Nuclex::Audio::BFloat16 *, float *, std::size_t);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds values via the inline quantization methods</summary>
+  /// <typeparam name="TValue">Type of the floating point values</typeparam>
+  /// <typeparam name="TFactor">Type of the factor, decides the precision</typeparam>
+  /// <param name="values">Floating point values that will be rounded</param>
+  /// <param name="factor">Factor by which the floating point values will be multiplied</param>
+  /// <param name="results">Receives the integers nearest to the float values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  template<typename TValue, typename TFactor>
+  void multiplyToNearestInt32Inline(
+    const TValue *values, TFactor factor, std::int32_t *results, std::size_t count
+  ) {
+    using Nuclex::Audio::Processing::Quantization;
+
+    while(15 < count) {
+      Quantization::MultiplyToNearestInt32x16(values, factor, results);
+      values += 16;
+      results += 16;
+      count -= 16;
+    }
+    while(3 < count) {
+      Quantization::MultiplyToNearestInt32x4(values, factor, results);
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+    while(0 < count) {
+      results[0] = Quantization::NearestInt32(values[0] * factor);
+      ++values;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers via the inline reconstruction methods</summary>
+  /// <typeparam name="TQuotient">Type of the quotient, decides the precision</typeparam>
+  /// <typeparam name="TResult">Type of the floating point results</typeparam>
+  /// <param name="values">Integer values that will be normalized</param>
+  /// <param name="shift">Number of bits by which the integers will be shifted</param>
+  /// <param name="quotient">Quotient by which the float values will be divided</param>
+  /// <param name="results">Receives the normalized float values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  template<typename TQuotient, typename TResult>
+  void shiftAndDivideInt32ToFloatInline(
+    const std::int32_t *values, int shift, TQuotient quotient, TResult *results,
+    std::size_t count
+  ) {
+    using Nuclex::Audio::Processing::Reconstruction;
+
+    while(15 < count) {
+      Reconstruction::ShiftAndDivideInt32ToFloatx16(values, shift, quotient, results);
+      values += 16;
+      results += 16;
+      count -= 16;
+    }
+    while(3 < count) {
+      Reconstruction::ShiftAndDivideInt32ToFloatx4(values, shift, quotient, results);
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+    while(0 < count) {
+      results[0] = static_cast<TResult>(
+        Reconstruction::DivideInt32ToFloat(values[0] >> shift, quotient)
+      );
+      ++values;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a float to the nearest half precision float</summary>
+  /// <param name="value">Floating point value that will be rounded</param>
+  /// <returns>The bits of the half precision float nearest to the value</returns>
+  std::uint16_t narrowToFloat16(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    std::uint32_t sign = bits & 0x80000000U;
+    bits ^= sign;
+
+    std::uint16_t result;
+    if(unlikely(bits >= 0x47800000U)) { // 65536 and beyond, infinity or NaN
+      result = (bits > 0x7F800000U) ? 0x7E00U : 0x7C00U;
+    } else if(bits < 0x38800000U) { // smaller than 2^-14, denormal or zero
+      // Adding 0.5 shifts the mantissa so its lowest 10 bits hold the denormal,
+      // with the FPU doing the round-to-nearest-even for us
+      const std::uint32_t denormalMagicBits = 0x3F000000U;
+      float denormalMagic;
+      std::memcpy(&denormalMagic, &denormalMagicBits, sizeof(denormalMagic));
+
+      float magnitude;
+      std::memcpy(&magnitude, &bits, sizeof(magnitude));
+      magnitude += denormalMagic;
+      std::memcpy(&bits, &magnitude, sizeof(bits));
+      result = static_cast<std::uint16_t>(bits - denormalMagicBits);
+    } else {
+      std::uint32_t isMantissaOdd = (bits >> 13) & 1;
+      bits += 0xC8000FFFU; // rebias exponent from 127 to 15, round down at the halfway point
+      bits += isMantissaOdd; // ...unless the mantissa is odd, making it round to even
+      result = static_cast<std::uint16_t>(bits >> 13);
+    }
+
+    return static_cast<std::uint16_t>(result | (sign >> 16));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens a half precision float to a float</summary>
+  /// <param name="bits">Bits of the half precision float</param>
+  /// <returns>The float holding the same value as the half precision float</returns>
+  float widenFromFloat16(std::uint16_t bits) {
+    std::uint32_t result = static_cast<std::uint32_t>(bits & 0x7FFFU) << 13;
+    std::uint32_t exponent = result & 0x0F800000U;
+    result += 0x38000000U; // rebias exponent from 15 to 127
+
+    if(unlikely(exponent == 0x0F800000U)) { // infinity or NaN
+      result += 0x38000000U;
+    } else if(exponent == 0) { // denormal or zero, let the FPU normalize it
+      const std::uint32_t normalizeMagicBits = 0x38800000U;
+      float normalizeMagic;
+      std::memcpy(&normalizeMagic, &normalizeMagicBits, sizeof(normalizeMagic));
+
+      result += 0x00800000U;
+      float value;
+      std::memcpy(&value, &result, sizeof(value));
+      value -= normalizeMagic;
+      std::memcpy(&result, &value, sizeof(result));
+    }
+
+    result |= static_cast<std::uint32_t>(bits & 0x8000U) << 16;
+
+    float value;
+    std::memcpy(&value, &result, sizeof(value));
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a float to the nearest brain float</summary>
+  /// <param name="value">Floating point value that will be rounded</param>
+  /// <returns>The bits of the brain float nearest to the value</returns>
+  std::uint16_t narrowToBFloat16(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    // NaNs would carry into the exponent or sign when rounded, so keep them quiet NaNs
+    if(unlikely((bits & 0x7FFFFFFFU) > 0x7F800000U)) {
+      return static_cast<std::uint16_t>((bits >> 16) | 0x0040U);
+    }
+
+    bits += 0x7FFFU + ((bits >> 16) & 1);
+    return static_cast<std::uint16_t>(bits >> 16);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens a brain float to a float</summary>
+  /// <param name="bits">Bits of the brain float</param>
+  /// <returns>The float holding the same value as the brain float</returns>
+  float widenFromBFloat16(std::uint16_t bits) {
+    std::uint32_t result = static_cast<std::uint32_t>(bits) << 16;
+
+    float value;
+    std::memcpy(&value, &result, sizeof(value));
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds floats to half precision floats one by one or via NEON</summary>
+  /// <param name="values">Floating point values that will be converted</param>
+  /// <param name="results">Receives the half precision floats</param>
+  /// <param name="count">Number of values that will be converted</param>
+  void narrowToFloat16Inline(
+    const float *values, Nuclex::Audio::Float16 *results, std::size_t count
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+    while(3 < count) {
+      vst1_u16(
+        reinterpret_cast<std::uint16_t *>(results),
+        vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(values)))
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+#endif
+    while(0 < count) {
+      results[0].Bits = narrowToFloat16(values[0]);
+      ++values;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens half precision floats to floats one by one or via NEON</summary>
+  /// <param name="values">Half precision floats that will be converted</param>
+  /// <param name="results">Receives the floating point values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  void widenFromFloat16Inline(
+    const Nuclex::Audio::Float16 *values, float *results, std::size_t count
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+    while(3 < count) {
+      float16x4_t halves = vreinterpret_f16_u16(
+        vld1_u16(reinterpret_cast<const std::uint16_t *>(values))
+      );
+      vst1q_f32(results, vcvt_f32_f16(halves));
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+#endif
+    while(0 < count) {
+      results[0] = widenFromFloat16(values[0].Bits);
+      ++values;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds floats to brain floats one by one</summary>
+  /// <param name="values">Floating point values that will be converted</param>
+  /// <param name="results">Receives the brain floats</param>
+  /// <param name="count">Number of values that will be converted</param>
+  void narrowToBFloat16Inline(
+    const float *values, Nuclex::Audio::BFloat16 *results, std::size_t count
+  ) {
+    for(std::size_t index = 0; index < count; ++index) {
+      results[index].Bits = narrowToBFloat16(values[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens brain floats to floats one by one</summary>
+  /// <param name="values">Brain floats that will be converted</param>
+  /// <param name="results">Receives the floating point values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  void widenFromBFloat16Inline(
+    const Nuclex::Audio::BFloat16 *values, float *results, std::size_t count
+  ) {
+    for(std::size_t index = 0; index < count; ++index) {
+      results[index] = widenFromBFloat16(values[index].Bits);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds floats to integers using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void quantizeFloatAvx2(
+    const float *values, float factor, std::int32_t *results, std::size_t count
+  ) {
+    __m256 factorVector = _mm256_set1_ps(factor);
+    while(7 < count) {
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(results),
+        _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(values), factorVector))
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds floats to integers with double precision using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void quantizeFloatAsDoubleAvx2(
+    const float *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    __m256d factorVector = _mm256_set1_pd(factor);
+    while(3 < count) {
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results),
+        _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(values)), factorVector))
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds doubles to integers using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void quantizeDoubleAvx2(
+    const double *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    __m256d factorVector = _mm256_set1_pd(factor);
+    while(3 < count) {
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results),
+        _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(values), factorVector))
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to floats using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void reconstructFloatAvx2(
+    const std::int32_t *values, int shift, float quotient, float *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m256 quotientVector = _mm256_set1_ps(quotient);
+    while(7 < count) {
+      __m256i valuesVector = _mm256_sra_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), shiftCount
+      );
+      _mm256_storeu_ps(results, _mm256_div_ps(_mm256_cvtepi32_ps(valuesVector), quotientVector));
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to floats with double precision using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void reconstructFloatAsDoubleAvx2(
+    const std::int32_t *values, int shift, double quotient, float *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+    while(3 < count) {
+      __m128i valuesVector = _mm_sra_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)), shiftCount
+      );
+      _mm_storeu_ps(
+        results,
+        _mm256_cvtpd_ps(_mm256_div_pd(_mm256_cvtepi32_pd(valuesVector), quotientVector))
+      );
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to doubles using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void reconstructDoubleAvx2(
+    const std::int32_t *values, int shift, double quotient, double *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m256d quotientVector = _mm256_set1_pd(quotient);
+    while(3 < count) {
+      __m128i valuesVector = _mm_sra_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)), shiftCount
+      );
+      _mm256_storeu_pd(results, _mm256_div_pd(_mm256_cvtepi32_pd(valuesVector), quotientVector));
+      values += 4;
+      results += 4;
+      count -= 4;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds floats to integers using AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void quantizeFloatAvx512(
+    const float *values, float factor, std::int32_t *results, std::size_t count
+  ) {
+    __m512 factorVector = _mm512_set1_ps(factor);
+    while(15 < count) {
+      _mm512_storeu_si512(
+        results, _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(values), factorVector))
+      );
+      values += 16;
+      results += 16;
+      count -= 16;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds floats to integers in double precision via AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void quantizeFloatAsDoubleAvx512(
+    const float *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    __m512d factorVector = _mm512_set1_pd(factor);
+    while(7 < count) {
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(results),
+        _mm512_cvtpd_epi32(_mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(values)), factorVector))
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies and rounds doubles to integers using AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void quantizeDoubleAvx512(
+    const double *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    __m512d factorVector = _mm512_set1_pd(factor);
+    while(7 < count) {
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(results),
+        _mm512_cvtpd_epi32(_mm512_mul_pd(_mm512_loadu_pd(values), factorVector))
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    multiplyToNearestInt32Inline(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to floats using AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void reconstructFloatAvx512(
+    const std::int32_t *values, int shift, float quotient, float *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m512 quotientVector = _mm512_set1_ps(quotient);
+    while(15 < count) {
+      __m512i valuesVector = _mm512_sra_epi32(_mm512_loadu_si512(values), shiftCount);
+      _mm512_storeu_ps(results, _mm512_div_ps(_mm512_cvtepi32_ps(valuesVector), quotientVector));
+      values += 16;
+      results += 16;
+      count -= 16;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to floats with double precision using AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void reconstructFloatAsDoubleAvx512(
+    const std::int32_t *values, int shift, double quotient, float *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+    while(7 < count) {
+      __m256i valuesVector = _mm256_sra_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), shiftCount
+      );
+      _mm256_storeu_ps(
+        results,
+        _mm512_cvtpd_ps(_mm512_div_pd(_mm512_cvtepi32_pd(valuesVector), quotientVector))
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shifts and divides integers to doubles using AVX-512</summary>
+  NUCLEX_AUDIO_TARGET_AVX512 void reconstructDoubleAvx512(
+    const std::int32_t *values, int shift, double quotient, double *results, std::size_t count
+  ) {
+    __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    __m512d quotientVector = _mm512_set1_pd(quotient);
+    while(7 < count) {
+      __m256i valuesVector = _mm256_sra_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), shiftCount
+      );
+      _mm512_storeu_pd(results, _mm512_div_pd(_mm512_cvtepi32_pd(valuesVector), quotientVector));
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    shiftAndDivideInt32ToFloatInline(values, shift, quotient, results, count);
+  }
+
+  /// <summary>Rounds floats to half precision floats using F16C</summary>
+  NUCLEX_AUDIO_TARGET_AVX2_F16C void narrowToFloat16F16c(
+    const float *values, Nuclex::Audio::Float16 *results, std::size_t count
+  ) {
+    while(7 < count) {
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(results),
+        _mm256_cvtps_ph(_mm256_loadu_ps(values), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    narrowToFloat16Inline(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens half precision floats to floats using F16C</summary>
+  NUCLEX_AUDIO_TARGET_AVX2_F16C void widenFromFloat16F16c(
+    const Nuclex::Audio::Float16 *values, float *results, std::size_t count
+  ) {
+    while(7 < count) {
+      _mm256_storeu_ps(
+        results, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)))
+      );
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    widenFromFloat16Inline(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds floats to brain floats using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void narrowToBFloat16Avx2(
+    const float *values, Nuclex::Audio::BFloat16 *results, std::size_t count
+  ) {
+    const __m256i roundingBias = _mm256_set1_epi32(0x7FFF);
+    const __m256i lowestBit = _mm256_set1_epi32(1);
+    const __m256i quietBit = _mm256_set1_epi32(0x0040);
+
+    while(7 < count) {
+      __m256 floats = _mm256_loadu_ps(values);
+      __m256i bits = _mm256_castps_si256(floats);
+      __m256i upperBits = _mm256_srli_epi32(bits, 16);
+
+      // Round to nearest even like the scalar version, but keep NaNs from rounding
+      __m256i rounded = _mm256_srli_epi32(
+        _mm256_add_epi32(
+          bits, _mm256_add_epi32(roundingBias, _mm256_and_si256(upperBits, lowestBit))
+        ),
+        16
+      );
+      __m256i nanMask = _mm256_castps_si256(_mm256_cmp_ps(floats, floats, _CMP_UNORD_Q));
+      rounded = _mm256_blendv_epi8(rounded, _mm256_or_si256(upperBits, quietBit), nanMask);
+
+      // Packing works within each 128 bit lane, so the middle quarters need to be swapped
+      __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0x08);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(results), _mm256_castsi256_si128(packed));
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    narrowToBFloat16Inline(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Widens brain floats to floats using AVX2</summary>
+  NUCLEX_AUDIO_TARGET_AVX2 void widenFromBFloat16Avx2(
+    const Nuclex::Audio::BFloat16 *values, float *results, std::size_t count
+  ) {
+    while(7 < count) {
+      __m256i bits = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(values))
+      );
+      _mm256_storeu_ps(results, _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16)));
+      values += 8;
+      results += 8;
+      count -= 8;
+    }
+
+    widenFromBFloat16Inline(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Selects the fastest kernels the CPU this is running on supports</summary>
+  /// <returns>A table with the fastest kernels for the CPU</returns>
+  KernelTable selectKernels() {
+    using Nuclex::Audio::Processing::ConversionKernelSet;
+
+    // The inline methods use whatever the library has been compiled for
+    KernelTable table = {
+#if defined(NUCLEX_AUDIO_HAVE_AVX512)
+      ConversionKernelSet::Avx512,
+#elif defined(NUCLEX_AUDIO_HAVE_AVX2)
+      ConversionKernelSet::Avx2,
+#elif defined(NUCLEX_AUDIO_HAVE_SSE2)
+      ConversionKernelSet::Sse2,
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+      ConversionKernelSet::Neon,
+#else
+      ConversionKernelSet::Scalar,
+#endif
+      &multiplyToNearestInt32Inline<float, float>,
+      &multiplyToNearestInt32Inline<float, double>,
+      &multiplyToNearestInt32Inline<double, double>,
+      &shiftAndDivideInt32ToFloatInline<float, float>,
+      &shiftAndDivideInt32ToFloatInline<double, float>,
+      &shiftAndDivideInt32ToFloatInline<double, double>,
+      &narrowToFloat16Inline,
+      &widenFromFloat16Inline,
+      &narrowToBFloat16Inline,
+      &widenFromBFloat16Inline
+    };
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    const Nuclex::Audio::Processing::CpuFeatures &features = (
+      Nuclex::Audio::Processing::CpuFeatures::Get()
+    );
+    if(features.HasAvx512 && (table.KernelSet < ConversionKernelSet::Avx512)) {
+      table = KernelTable {
+        ConversionKernelSet::Avx512,
+        &quantizeFloatAvx512,
+        &quantizeFloatAsDoubleAvx512,
+        &quantizeDoubleAvx512,
+        &reconstructFloatAvx512,
+        &reconstructFloatAsDoubleAvx512,
+        &reconstructDoubleAvx512,
+        &narrowToFloat16Inline,
+        &widenFromFloat16Inline,
+        &narrowToBFloat16Avx2,
+        &widenFromBFloat16Avx2
+      };
+    } else if(features.HasAvx2 && (table.KernelSet < ConversionKernelSet::Avx2)) {
+      table = KernelTable {
+        ConversionKernelSet::Avx2,
+        &quantizeFloatAvx2,
+        &quantizeFloatAsDoubleAvx2,
+        &quantizeDoubleAvx2,
+        &reconstructFloatAvx2,
+        &reconstructFloatAsDoubleAvx2,
+        &reconstructDoubleAvx2,
+        &narrowToFloat16Inline,
+        &widenFromFloat16Inline,
+        &narrowToBFloat16Avx2,
+        &widenFromBFloat16Avx2
+      };
+    }
+
+    // F16C came along with AVX2 on all x86 processors so far, but is its own extension
+    if(features.HasF16c) {
+      table.NarrowToFloat16 = &narrowToFloat16F16c;
+      table.WidenFromFloat16 = &widenFromFloat16F16c;
+    }
+#endif
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the kernel table, selecting the kernels on first use</summary>
+  /// <returns>The kernel table with the fastest kernels for the CPU</returns>
+  const KernelTable &getKernels() {
+    static const KernelTable kernels = selectKernels();
+    return kernels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ConversionKernelSet ConversionKernels::GetActiveKernelSet() {
+    return getKernels().KernelSet;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *ConversionKernels::GetActiveKernelSetName() {
+    switch(getKernels().KernelSet) {
+      case ConversionKernelSet::Sse2: { return u8"SSE2"; }
+      case ConversionKernelSet::Avx2: { return u8"AVX2"; }
+      case ConversionKernelSet::Avx512: { return u8"AVX-512"; }
+      case ConversionKernelSet::Neon: { return u8"NEON"; }
+      default: { return u8"Scalar"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::MultiplyToNearestInt32(
+    const float *values, float factor, std::int32_t *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().QuantizeFloat(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::MultiplyToNearestInt32(
+    const float *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().QuantizeFloatAsDouble(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::MultiplyToNearestInt32(
+    const double *values, double factor, std::int32_t *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().QuantizeDouble(values, factor, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ShiftAndDivideInt32ToFloat(
+    const std::int32_t *values, int shift, float quotient, float *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().ReconstructFloat(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ShiftAndDivideInt32ToFloat(
+    const std::int32_t *values, int shift, double quotient, float *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().ReconstructFloatAsDouble(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ShiftAndDivideInt32ToFloat(
+    const std::int32_t *values, int shift, double quotient, double *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().ReconstructDouble(values, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ConvertToFloat16(
+    const float *values, Float16 *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().NarrowToFloat16(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ConvertFromFloat16(
+    const Float16 *values, float *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().WidenFromFloat16(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ConvertToBFloat16(
+    const float *values, BFloat16 *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().NarrowToBFloat16(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConversionKernels::ConvertFromBFloat16(
+    const BFloat16 *values, float *results, std::size_t count
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Convert samples", nullptr, nullptr);
+    getKernels().WidenFromBFloat16(values, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,93 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./CpuFeatures.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Asks the CPU and operating system which instruction sets are usable</summary>
+  /// <returns>The instruction sets the kernels are allowed to use</returns>
+  Nuclex::Audio::Processing::CpuFeatures detectCpuFeatures() {
+    Nuclex::Audio::Processing::CpuFeatures features = { false, false, false, false, false };
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4]; // EAX, EBX, ECX, EDX
+    __cpuid(registers, 0);
+    int highestLeaf = registers[0];
+    if(highestLeaf < 1) {
+      return features;
+    }
+
+    __cpuid(registers, 1);
+    features.HasSsse3 = ((registers[2] & (1 << 9)) != 0);
+    bool hasFma = ((registers[2] & (1 << 12)) != 0);
+    bool hasF16c = ((registers[2] & (1 << 29)) != 0);
+
+    // The CPU having the instructions is not enough, the operating system also needs
+    // to save the wider registers on context switches, which it reports via XCR0
+    bool hasOsXSave = ((registers[2] & (1 << 27)) != 0);
+    bool hasAvx = ((registers[2] & (1 << 28)) != 0);
+    if((highestLeaf < 7) || !hasOsXSave || !hasAvx) {
+      return features;
+    }
+
+    unsigned long long enabledStates = _xgetbv(0);
+    __cpuidex(registers, 7, 0);
+    features.HasAvx2 = ((registers[1] & (1 << 5)) != 0) && ((enabledStates & 0x06) == 0x06);
+    features.HasFma = features.HasAvx2 && hasFma;
+    features.HasF16c = features.HasAvx2 && hasF16c;
+    features.HasAvx512 = features.HasAvx2 && ((registers[1] & (1 << 16)) != 0) && (
+      (enabledStates & 0xE6) == 0xE6
+    );
+#else
+    // GCC and clang check the operating system's support for the registers as well
+    __builtin_cpu_init();
+    features.HasSsse3 = (__builtin_cpu_supports("ssse3") != 0);
+    features.HasAvx2 = (__builtin_cpu_supports("avx2") != 0);
+    features.HasFma = features.HasAvx2 && (__builtin_cpu_supports("fma") != 0);
+    features.HasF16c = features.HasAvx2 && (__builtin_cpu_supports("f16c") != 0);
+    features.HasAvx512 = features.HasAvx2 && (__builtin_cpu_supports("avx512f") != 0);
+#endif
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+    return features;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const CpuFeatures &CpuFeatures::Get() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,78 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_PROCESSING_CPUFEATURES_H
+#define NUCLEX_AUDIO_PROCESSING_CPUFEATURES_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for NUCLEX_AUDIO_HAVE_SSE2 and intrinsics
+
+// Whether kernels for newer instruction sets than the targeted one can be compiled.
+// MSVC lets any function use any intrinsic, GCC and clang need to be told per function.
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #define NUCLEX_AUDIO_TARGET_SSSE3
+    #define NUCLEX_AUDIO_TARGET_AVX2
+    #define NUCLEX_AUDIO_TARGET_AVX2_FMA
+    #define NUCLEX_AUDIO_TARGET_AVX2_F16C
+    #define NUCLEX_AUDIO_TARGET_AVX512
+    #define NUCLEX_AUDIO_CAN_DISPATCH_AVX 1
+  #elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+    #define NUCLEX_AUDIO_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define NUCLEX_AUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+    #define NUCLEX_AUDIO_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+    #define NUCLEX_AUDIO_TARGET_AVX2_F16C __attribute__((target("avx2,f16c")))
+    #define NUCLEX_AUDIO_TARGET_AVX512 __attribute__((target("avx512f")))
+    #define NUCLEX_AUDIO_CAN_DISPATCH_AVX 1
+  #endif
+#endif
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Instruction set extensions the CPU and operating system support</summary>
+  /// <remarks>
+  ///   Only the extensions the runtime-dispatched kernels care about are listed. Without
+  ///   NUCLEX_AUDIO_CAN_DISPATCH_AVX, all of them are reported as unavailable.
+  /// </remarks>
+  struct CpuFeatures {
+
+    /// <summary>Detects the features of the CPU this is running on once</summary>
+    /// <returns>The features of the CPU this is running on</returns>
+    public: static const CpuFeatures &Get();
+
+    /// <summary>Whether SSSE3 instructions (pshufb) can be used</summary>
+    public: bool HasSsse3;
+    /// <summary>Whether AVX2 instructions can be used</summary>
+    public: bool HasAvx2;
+    /// <summary>Whether AVX-512 foundation instructions can be used</summary>
+    public: bool HasAvx512;
+    /// <summary>Whether fused multiply-add instructions can be used along with AVX2</summary>
+    public: bool HasFma;
+    /// <summary>Whether half precision float conversions can be used along with AVX2</summary>
+    public: bool HasF16c;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
+
+#endif // NUCLEX_AUDIO_PROCESSING_CPUFEATURES_H
@@ -21,10 +21,277 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Processing/DecibelConverter.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
 
-// --------------------------------------------------------------------------------------------- //
+#include <algorithm> // for std::copy_n()
+#include <limits> // for std::numeric_limits
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decibels per doubling of the amplitude, 20 * log10(2)</summary>
+  const float DecibelsPerOctave = 6.020599913279624f;
+
+  /// <summary>Decibels per natural logarithm unit, 20 / ln(10)</summary>
+  const float DecibelsPerNaturalLog = 8.685889638065037f;
+
+  /// <summary>Octaves per decibel, the inverse of the above</summary>
+  const float OctavesPerDecibel = 0.16609640474436813f;
+
+  /// <summary>Natural logarithm of 2</summary>
+  const float NaturalLogOfTwo = 0.6931471805599453f;
+
+  /// <summary>Square root of 2, the upper end of the mantissa range</summary>
+  const float SquareRootOfTwo = 1.4142135623730951f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Converts 4 linear amplitude values into decibels</summary>
+  /// <param name="amplitudes">Linear amplitude values that will be converted</param>
+  /// <returns>The decibels of the amplitude values</returns>
+  inline __m128 fromLinearAmplitudeSse2(__m128 amplitudes) {
+    __m128 magnitudes = _mm_andnot_ps(_mm_set1_ps(-0.0f), amplitudes);
+    __m128 isTiny = _mm_cmplt_ps(
+      magnitudes, _mm_set1_ps(std::numeric_limits<float>::epsilon())
+    );
+
+    // Split the float into its exponent and a mantissa in the range of 1.0 to 2.0,
+    // then shift the mantissa to sqrt(0.5) .. sqrt(2) so the series converges quickly
+    __m128i bits = _mm_castps_si128(magnitudes);
+    __m128i exponents = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    __m128 mantissas = _mm_castsi128_ps(
+      _mm_or_si128(
+        _mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)
+      )
+    );
+    __m128 isLarge = _mm_cmpgt_ps(mantissas, _mm_set1_ps(SquareRootOfTwo));
+    mantissas = _mm_sub_ps(
+      mantissas, _mm_and_ps(isLarge, _mm_mul_ps(mantissas, _mm_set1_ps(0.5f)))
+    );
+    __m128 octaves = _mm_add_ps(
+      _mm_cvtepi32_ps(exponents), _mm_and_ps(isLarge, _mm_set1_ps(1.0f))
+    );
+
+    // ln(m) = 2 * atanh((m - 1) / (m + 1)), the series' error is below 3e-8 at the ends
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 t = _mm_div_ps(_mm_sub_ps(mantissas, one), _mm_add_ps(mantissas, one));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 series = _mm_add_ps(
+      _mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(t2, _mm_set1_ps(1.0f / 7.0f))
+    );
+    series = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(t2, series));
+    series = _mm_add_ps(one, _mm_mul_ps(t2, series));
+    __m128 logarithm = _mm_mul_ps(_mm_add_ps(t, t), series);
+
+    __m128 decibels = _mm_add_ps(
+      _mm_mul_ps(octaves, _mm_set1_ps(DecibelsPerOctave)),
+      _mm_mul_ps(logarithm, _mm_set1_ps(DecibelsPerNaturalLog))
+    );
+    return _mm_or_ps(
+      _mm_and_ps(isTiny, _mm_set1_ps(std::numeric_limits<float>::infinity())),
+      _mm_andnot_ps(isTiny, decibels)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts 4 decibel values into linear amplitudes</summary>
+  /// <param name="decibels">Decibel values that will be converted</param>
+  /// <returns>The linear amplitudes of the decibel values</returns>
+  inline __m128 toLinearAmplitudeSse2(__m128 decibels) {
+    __m128 octaves = _mm_mul_ps(decibels, _mm_set1_ps(OctavesPerDecibel));
+    octaves = _mm_max_ps(_mm_min_ps(octaves, _mm_set1_ps(127.0f)), _mm_set1_ps(-126.0f));
+
+    // 2^x = 2^n * e^(f * ln(2)) with n being x rounded and f within -0.5 .. +0.5
+    __m128i wholeOctaves = _mm_cvtps_epi32(octaves);
+    __m128 z = _mm_mul_ps(
+      _mm_sub_ps(octaves, _mm_cvtepi32_ps(wholeOctaves)), _mm_set1_ps(NaturalLogOfTwo)
+    );
+
+    // Taylor series of e^z, the error is below 2e-7 for |z| up to ln(2) / 2
+    __m128 series = _mm_add_ps(
+      _mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(z, _mm_set1_ps(1.0f / 720.0f))
+    );
+    series = _mm_add_ps(_mm_set1_ps(1.0f / 24.0f), _mm_mul_ps(z, series));
+    series = _mm_add_ps(_mm_set1_ps(1.0f / 6.0f), _mm_mul_ps(z, series));
+    series = _mm_add_ps(_mm_set1_ps(1.0f / 2.0f), _mm_mul_ps(z, series));
+    series = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, series));
+    series = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, series));
+
+    __m128 scale = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_add_epi32(wholeOctaves, _mm_set1_epi32(127)), 23)
+    );
+    return _mm_mul_ps(series, scale);
+  }
+
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Converts 4 linear amplitude values into decibels</summary>
+  /// <param name="amplitudes">Linear amplitude values that will be converted</param>
+  /// <returns>The decibels of the amplitude values</returns>
+  inline float32x4_t fromLinearAmplitudeNeon(float32x4_t amplitudes) {
+    float32x4_t magnitudes = vabsq_f32(amplitudes);
+    uint32x4_t isTiny = vcltq_f32(
+      magnitudes, vdupq_n_f32(std::numeric_limits<float>::epsilon())
+    );
+
+    // Split the float into its exponent and a mantissa in the range of 1.0 to 2.0,
+    // then shift the mantissa to sqrt(0.5) .. sqrt(2) so the series converges quickly
+    uint32x4_t bits = vreinterpretq_u32_f32(magnitudes);
+    int32x4_t exponents = vsubq_s32(
+      vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)
+    );
+    float32x4_t mantissas = vreinterpretq_f32_u32(
+      vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000))
+    );
+    uint32x4_t isLarge = vcgtq_f32(mantissas, vdupq_n_f32(SquareRootOfTwo));
+    mantissas = vbslq_f32(isLarge, vmulq_n_f32(mantissas, 0.5f), mantissas);
+    float32x4_t octaves = vaddq_f32(
+      vcvtq_f32_s32(exponents),
+      vreinterpretq_f32_u32(vandq_u32(isLarge, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))
+    );
+
+    // ln(m) = 2 * atanh((m - 1) / (m + 1)), the series' error is below 3e-8 at the ends
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t t = vdivq_f32(vsubq_f32(mantissas, one), vaddq_f32(mantissas, one));
+    float32x4_t t2 = vmulq_f32(t, t);
+    float32x4_t series = vfmaq_n_f32(vdupq_n_f32(1.0f / 5.0f), t2, 1.0f / 7.0f);
+    series = vfmaq_f32(vdupq_n_f32(1.0f / 3.0f), t2, series);
+    series = vfmaq_f32(one, t2, series);
+    float32x4_t logarithm = vmulq_f32(vaddq_f32(t, t), series);
+
+    float32x4_t decibels = vfmaq_n_f32(
+      vmulq_n_f32(octaves, DecibelsPerOctave), logarithm, DecibelsPerNaturalLog
+    );
+    return vbslq_f32(
+      isTiny, vdupq_n_f32(std::numeric_limits<float>::infinity()), decibels
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts 4 decibel values into linear amplitudes</summary>
+  /// <param name="decibels">Decibel values that will be converted</param>
+  /// <returns>The linear amplitudes of the decibel values</returns>
+  inline float32x4_t toLinearAmplitudeNeon(float32x4_t decibels) {
+    float32x4_t octaves = vmulq_n_f32(decibels, OctavesPerDecibel);
+    octaves = vmaxq_f32(vminq_f32(octaves, vdupq_n_f32(127.0f)), vdupq_n_f32(-126.0f));
+
+    // 2^x = 2^n * e^(f * ln(2)) with n being x rounded and f within -0.5 .. +0.5
+    int32x4_t wholeOctaves = vcvtnq_s32_f32(octaves);
+    float32x4_t z = vmulq_n_f32(
+      vsubq_f32(octaves, vcvtq_f32_s32(wholeOctaves)), NaturalLogOfTwo
+    );
+
+    // Taylor series of e^z, the error is below 2e-7 for |z| up to ln(2) / 2
+    float32x4_t series = vfmaq_n_f32(vdupq_n_f32(1.0f / 120.0f), z, 1.0f / 720.0f);
+    series = vfmaq_f32(vdupq_n_f32(1.0f / 24.0f), z, series);
+    series = vfmaq_f32(vdupq_n_f32(1.0f / 6.0f), z, series);
+    series = vfmaq_f32(vdupq_n_f32(1.0f / 2.0f), z, series);
+    series = vfmaq_f32(vdupq_n_f32(1.0f), z, series);
+    series = vfmaq_f32(vdupq_n_f32(1.0f), z, series);
+
+    float32x4_t scale = vreinterpretq_f32_s32(
+      vshlq_n_s32(vaddq_s32(wholeOctaves, vdupq_n_s32(127)), 23)
+    );
+    return vmulq_f32(series, scale);
+  }
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecibelConverter::FromLinearAmplitude(
+    const float *amplitudes, float *decibels, std::size_t count
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    while(count >= 4) {
+      _mm_storeu_ps(decibels, fromLinearAmplitudeSse2(_mm_loadu_ps(amplitudes)));
+      amplitudes += 4;
+      decibels += 4;
+      count -= 4;
+    }
+
+    // The remaining values go through the same approximation, so that a value's
+    // result does not depend on where in the buffer it is
+    if(count > 0) {
+      float remaining[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+      std::copy_n(amplitudes, count, remaining);
+      _mm_storeu_ps(remaining, fromLinearAmplitudeSse2(_mm_loadu_ps(remaining)));
+      std::copy_n(remaining, count, decibels);
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    while(count >= 4) {
+      vst1q_f32(decibels, fromLinearAmplitudeNeon(vld1q_f32(amplitudes)));
+      amplitudes += 4;
+      decibels += 4;
+      count -= 4;
+    }
+
+    // The remaining values go through the same approximation, so that a value's
+    // result does not depend on where in the buffer it is
+    if(count > 0) {
+      float remaining[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+      std::copy_n(amplitudes, count, remaining);
+      vst1q_f32(remaining, fromLinearAmplitudeNeon(vld1q_f32(remaining)));
+      std::copy_n(remaining, count, decibels);
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index) {
+      decibels[index] = FromLinearAmplitude(amplitudes[index]);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecibelConverter::ToLinearAmplitude(
+    const float *decibels, float *amplitudes, std::size_t count
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    while(count >= 4) {
+      _mm_storeu_ps(amplitudes, toLinearAmplitudeSse2(_mm_loadu_ps(decibels)));
+      decibels += 4;
+      amplitudes += 4;
+      count -= 4;
+    }
+
+    if(count > 0) {
+      float remaining[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      std::copy_n(decibels, count, remaining);
+      _mm_storeu_ps(remaining, toLinearAmplitudeSse2(_mm_loadu_ps(remaining)));
+      std::copy_n(remaining, count, amplitudes);
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    while(count >= 4) {
+      vst1q_f32(amplitudes, toLinearAmplitudeNeon(vld1q_f32(decibels)));
+      decibels += 4;
+      amplitudes += 4;
+      count -= 4;
+    }
+
+    if(count > 0) {
+      float remaining[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      std::copy_n(decibels, count, remaining);
+      vst1q_f32(remaining, toLinearAmplitudeNeon(vld1q_f32(remaining)));
+      std::copy_n(remaining, count, amplitudes);
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index) {
+      amplitudes[index] = ToLinearAmplitude(decibels[index]);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,301 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Ditherer.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for Quantization, SIMD intrinsics
+
+#include <algorithm> // for std::min(), std::max()
+#include <stdexcept> // for std::invalid_argument
+#include <type_traits> // for std::is_same<>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of noise values generated ahead of quantizing a chunk</summary>
+  const std::size_t NoiseChunkSampleCount = 256;
+
+  /// <summary>Largest error (in LSB) fed back by the noise shaping filter</summary>
+  /// <remarks>
+  ///   When samples clip, the quantization error becomes arbitrarily large. Feeding
+  ///   that back would make the filter run away, so the error is limited to what
+  ///   the dither and rounding can produce on their own, with some headroom.
+  /// </remarks>
+  const double MaximumShapedError = 4.0;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Derives the starting state of one random number generator</summary>
+  /// <param name="seed">Seed the user has provided</param>
+  /// <param name="lane">Index of the lane the generator is used for</param>
+  /// <returns>The starting state for the lane's xorshift generator</returns>
+  std::uint32_t deriveRandomState(std::uint32_t seed, std::uint32_t lane) {
+
+    // Mix the bits well so neighbouring lanes don't start out correlated.
+    // The constants are from MurmurHash3's finalizer.
+    std::uint32_t state = seed + (lane + 1) * 0x9E3779B9U;
+    state ^= state >> 16;
+    state *= 0x85EBCA6BU;
+    state ^= state >> 13;
+    state *= 0xC2B2AE35U;
+    state ^= state >> 16;
+
+    // Xorshift never leaves the all-zero state, so that one is not allowed
+    return (state == 0) ? 0x6D2B79F5U : state;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Ditherer::Ditherer(
+    std::size_t channelCount /* = 1 */,
+    NoiseShaping shaping /* = NoiseShaping::None */,
+    std::uint32_t seed /* = 0x9E3779B9U */
+  ) :
+    channelCount(channelCount),
+    shaping(shaping),
+    seed(seed),
+    randomStates(),
+    channelIndex(0),
+    errors(channelCount * 2, 0.0) {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Ditherer needs at least one channel");
+    }
+
+    Reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ditherer::Reset() {
+    for(std::uint32_t lane = 0; lane < 4; ++lane) {
+      this->randomStates[lane] = deriveRandomState(this->seed, lane);
+    }
+    this->channelIndex = 0;
+    std::fill(this->errors.begin(), this->errors.end(), 0.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ditherer::MultiplyToDitheredInt32(
+    const float *values, float factor, float limit, std::int32_t *results, std::size_t count
+  ) {
+    quantize(values, factor, limit, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ditherer::MultiplyToDitheredInt32(
+    const float *values, double factor, double limit, std::int32_t *results, std::size_t count
+  ) {
+    quantize(values, factor, limit, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ditherer::MultiplyToDitheredInt32(
+    const double *values, double factor, double limit, std::int32_t *results, std::size_t count
+  ) {
+    quantize(values, factor, limit, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ditherer::generateNoise(float *noise, std::size_t count) {
+
+    // Each generator step yields 32 random bits per lane. The lower and upper 16 bits
+    // are two independent uniform values and their sum has a triangular distribution.
+    // Subtracting the mean leaves -65535 to +65535, which is scaled to -1.0 to +1.0.
+    const float scale = 1.0f / 65536.0f;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    __m128i states = _mm_loadu_si128(reinterpret_cast<const __m128i *>(this->randomStates));
+    const __m128i lowMask = _mm_set1_epi32(0xFFFF);
+    const __m128i mean = _mm_set1_epi32(0xFFFF);
+    const __m128 scaleVector = _mm_set1_ps(scale);
+    while(0 < count) {
+      states = _mm_xor_si128(states, _mm_slli_epi32(states, 13));
+      states = _mm_xor_si128(states, _mm_srli_epi32(states, 17));
+      states = _mm_xor_si128(states, _mm_slli_epi32(states, 5));
+
+      __m128i sums = _mm_sub_epi32(
+        _mm_add_epi32(_mm_and_si128(states, lowMask), _mm_srli_epi32(states, 16)), mean
+      );
+      __m128 noiseVector = _mm_mul_ps(_mm_cvtepi32_ps(sums), scaleVector);
+
+      if(likely(3 < count)) {
+        _mm_storeu_ps(noise, noiseVector);
+        noise += 4;
+        count -= 4;
+      } else {
+        float lastNoise[4];
+        _mm_storeu_ps(lastNoise, noiseVector);
+        std::copy_n(lastNoise, count, noise);
+        count = 0;
+      }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(this->randomStates), states);
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    uint32x4_t states = vld1q_u32(this->randomStates);
+    const uint32x4_t lowMask = vdupq_n_u32(0xFFFF);
+    const int32x4_t mean = vdupq_n_s32(0xFFFF);
+    while(0 < count) {
+      states = veorq_u32(states, vshlq_n_u32(states, 13));
+      states = veorq_u32(states, vshrq_n_u32(states, 17));
+      states = veorq_u32(states, vshlq_n_u32(states, 5));
+
+      int32x4_t sums = vsubq_s32(
+        vreinterpretq_s32_u32(vaddq_u32(vandq_u32(states, lowMask), vshrq_n_u32(states, 16))),
+        mean
+      );
+      float32x4_t noiseVector = vmulq_n_f32(vcvtq_f32_s32(sums), scale);
+
+      if(likely(3 < count)) {
+        vst1q_f32(noise, noiseVector);
+        noise += 4;
+        count -= 4;
+      } else {
+        float lastNoise[4];
+        vst1q_f32(lastNoise, noiseVector);
+        std::copy_n(lastNoise, count, noise);
+        count = 0;
+      }
+    }
+    vst1q_u32(this->randomStates, states);
+#else
+    while(0 < count) {
+      float laneNoise[4];
+      for(std::size_t lane = 0; lane < 4; ++lane) {
+        std::uint32_t state = this->randomStates[lane];
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        this->randomStates[lane] = state;
+
+        std::int32_t sum = static_cast<std::int32_t>((state & 0xFFFF) + (state >> 16));
+        laneNoise[lane] = static_cast<float>(sum - 0xFFFF) * scale;
+      }
+
+      std::size_t usedCount = std::min<std::size_t>(count, 4);
+      std::copy_n(laneNoise, usedCount, noise);
+      noise += usedCount;
+      count -= usedCount;
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TValue, typename TFactor>
+  void Ditherer::quantize(
+    const TValue *values, TFactor factor, TFactor limit,
+    std::int32_t *results, std::size_t count
+  ) {
+    float noise[NoiseChunkSampleCount];
+
+    while(0 < count) {
+      std::size_t chunkSampleCount = std::min(count, NoiseChunkSampleCount);
+      generateNoise(noise, chunkSampleCount);
+
+      if(this->shaping == NoiseShaping::None) {
+        std::size_t index = 0;
+
+        // Without noise shaping, samples don't depend on each other, so the common
+        // float-to-16-bit case can be dithered, clamped and rounded 4 at a time
+        if constexpr(std::is_same<TValue, float>::value && std::is_same<TFactor, float>::value) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+          const __m128 factorVector = _mm_set1_ps(factor);
+          const __m128 upperLimit = _mm_set1_ps(limit);
+          const __m128 lowerLimit = _mm_set1_ps(-limit);
+          for(; index + 3 < chunkSampleCount; index += 4) {
+            __m128 dithered = _mm_add_ps(
+              _mm_mul_ps(_mm_loadu_ps(values + index), factorVector),
+              _mm_loadu_ps(noise + index)
+            );
+            dithered = _mm_max_ps(_mm_min_ps(dithered, upperLimit), lowerLimit);
+            _mm_storeu_si128(
+              reinterpret_cast<__m128i *>(results + index), _mm_cvtps_epi32(dithered)
+            );
+          }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+          const float32x4_t upperLimit = vdupq_n_f32(limit);
+          const float32x4_t lowerLimit = vdupq_n_f32(-limit);
+          for(; index + 3 < chunkSampleCount; index += 4) {
+            float32x4_t dithered = vmlaq_n_f32(
+              vld1q_f32(noise + index), vld1q_f32(values + index), factor
+            );
+            dithered = vmaxq_f32(vminq_f32(dithered, upperLimit), lowerLimit);
+            vst1q_s32(results + index, vcvtnq_s32_f32(dithered));
+          }
+#endif
+        }
+
+        for(; index < chunkSampleCount; ++index) {
+          TFactor dithered = static_cast<TFactor>(values[index]) * factor + noise[index];
+          results[index] = Quantization::NearestInt32(std::max(std::min(dithered, limit), -limit));
+        }
+
+        this->channelIndex = (this->channelIndex + chunkSampleCount) % this->channelCount;
+
+      } else { // if no noise shaping ^^ / vv noise shaping vv
+
+        // Each sample depends on the errors made on the previous samples of its channel,
+        // so this has to go sample by sample. The feedback filter is (1 - z^-1) for first
+        // order shaping and (1 - z^-1)^2 for second order shaping.
+        double secondOrderWeight = (this->shaping == NoiseShaping::SecondOrder) ? 1.0 : 0.0;
+        double firstOrderWeight = 1.0 + secondOrderWeight;
+
+        for(std::size_t index = 0; index < chunkSampleCount; ++index) {
+          double *channelErrors = this->errors.data() + (this->channelIndex * 2);
+
+          TFactor wanted = static_cast<TFactor>(values[index]) * factor - static_cast<TFactor>(
+            channelErrors[0] * firstOrderWeight - channelErrors[1] * secondOrderWeight
+          );
+          TFactor dithered = std::max(std::min(wanted + noise[index], limit), -limit);
+          std::int32_t quantized = Quantization::NearestInt32(dithered);
+          results[index] = quantized;
+
+          double error = static_cast<double>(quantized) - static_cast<double>(wanted);
+          channelErrors[1] = channelErrors[0];
+          channelErrors[0] = std::max(std::min(error, MaximumShapedError), -MaximumShapedError);
+
+          ++this->channelIndex;
+          this->channelIndex = (this->channelIndex == this->channelCount) ? 0 : this->channelIndex;
+        }
+
+      } // if no noise shaping / noise shaping
+
+      values += chunkSampleCount;
+      results += chunkSampleCount;
+      count -= chunkSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,206 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for NUCLEX_AUDIO_HAVE_SSE2
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Factor by which a channel is attenuated by 3 dB</summary>
+  const float MinusThreeDecibels = 0.70710678f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines how much of a channel goes into the left and the right channel</summary>
+  /// <param name="placement">Placement of the channel that will be looked up</param>
+  /// <param name="left">Receives the weight of the channel in the left channel</param>
+  /// <param name="right">Receives the weight of the channel in the right channel</param>
+  void getItuStereoCoefficients(
+    Nuclex::Audio::ChannelPlacement placement, float &left, float &right
+  ) {
+    using Nuclex::Audio::ChannelPlacement;
+
+    switch(placement) {
+      case ChannelPlacement::FrontLeft: { left = 1.0f; right = 0.0f; break; }
+      case ChannelPlacement::FrontRight: { left = 0.0f; right = 1.0f; break; }
+      case ChannelPlacement::LowFrequencyEffects: { left = 0.0f; right = 0.0f; break; }
+      case ChannelPlacement::FrontCenter:
+      case ChannelPlacement::BackCenter:
+      case ChannelPlacement::TopCenter:
+      case ChannelPlacement::TopFrontCenter:
+      case ChannelPlacement::TopBackCenter: {
+        left = MinusThreeDecibels;
+        right = MinusThreeDecibels;
+        break;
+      }
+      case ChannelPlacement::FrontCenterLeft:
+      case ChannelPlacement::BackLeft:
+      case ChannelPlacement::SideLeft:
+      case ChannelPlacement::TopFrontLeft:
+      case ChannelPlacement::TopBackLeft: {
+        left = MinusThreeDecibels;
+        right = 0.0f;
+        break;
+      }
+      case ChannelPlacement::FrontCenterRight:
+      case ChannelPlacement::BackRight:
+      case ChannelPlacement::SideRight:
+      case ChannelPlacement::TopFrontRight:
+      case ChannelPlacement::TopBackRight: {
+        left = 0.0f;
+        right = MinusThreeDecibels;
+        break;
+      }
+      default: {
+        throw std::invalid_argument(
+          u8"Downmix presets can only be created for channels with a known placement"
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixMatrix DownmixMatrix::CreateItuStereo(
+    const std::vector<ChannelPlacement> &inputChannelOrder
+  ) {
+    std::size_t inputChannelCount = inputChannelOrder.size();
+
+    std::vector<float> coefficients(inputChannelCount * 2);
+    for(std::size_t index = 0; index < inputChannelCount; ++index) {
+      getItuStereoCoefficients(
+        inputChannelOrder[index],
+        coefficients[index],
+        coefficients[inputChannelCount + index]
+      );
+    }
+
+    return DownmixMatrix(
+      inputChannelOrder,
+      { ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight },
+      coefficients
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixMatrix DownmixMatrix::CreateItuMono(
+    const std::vector<ChannelPlacement> &inputChannelOrder
+  ) {
+    std::size_t inputChannelCount = inputChannelOrder.size();
+
+    std::vector<float> coefficients(inputChannelCount);
+    for(std::size_t index = 0; index < inputChannelCount; ++index) {
+      float left, right;
+      getItuStereoCoefficients(inputChannelOrder[index], left, right);
+      coefficients[index] = (left + right) * MinusThreeDecibels;
+    }
+
+    return DownmixMatrix(
+      inputChannelOrder, { ChannelPlacement::FrontCenter }, coefficients
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixMatrix::DownmixMatrix(
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    const std::vector<ChannelPlacement> &outputChannelOrder,
+    const std::vector<float> &coefficients
+  ) :
+    inputChannelOrder(inputChannelOrder),
+    outputChannelOrder(outputChannelOrder),
+    coefficients(coefficients) {
+
+    if(unlikely(inputChannelOrder.empty() || outputChannelOrder.empty())) {
+      throw std::invalid_argument(u8"Downmix matrix needs at least one input and output");
+    }
+    if(unlikely(coefficients.size() != inputChannelOrder.size() * outputChannelOrder.size())) {
+      throw std::invalid_argument(
+        u8"Downmix matrix needs one coefficient per input channel for each output channel"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixMatrix::MixSeparated(
+    const float *const inputs[], float *const outputs[], std::size_t frameCount
+  ) const {
+    std::size_t inputChannelCount = this->inputChannelOrder.size();
+    std::size_t outputChannelCount = this->outputChannelOrder.size();
+
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      float *output = outputs[outputIndex];
+      if(output == nullptr) {
+        continue; // Caller is not interested in this channel
+      }
+
+      const float *row = this->coefficients.data() + (outputIndex * inputChannelCount);
+      std::size_t frameIndex = 0;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+      // Sum up 4 frames at a time. The input channels are each contiguous, so this is
+      // just a multiply-add of whole vectors for each input that contributes.
+      while(frameIndex + 3 < frameCount) {
+        __m128 sum = _mm_setzero_ps();
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          if(row[inputIndex] != 0.0f) {
+            sum = _mm_add_ps(
+              sum,
+              _mm_mul_ps(
+                _mm_loadu_ps(inputs[inputIndex] + frameIndex), _mm_set1_ps(row[inputIndex])
+              )
+            );
+          }
+        }
+        _mm_storeu_ps(output + frameIndex, sum);
+        frameIndex += 4;
+      }
+#endif
+
+      while(frameIndex < frameCount) {
+        float sum = 0.0f;
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          if(row[inputIndex] != 0.0f) {
+            sum += inputs[inputIndex][frameIndex] * row[inputIndex];
+          }
+        }
+        output[frameIndex] = sum;
+        ++frameIndex;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,380 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/FftPlan.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+
+#include <cmath> // for std::cos(), std::sin()
+#include <map> // for std::map
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Smallest signal length a plan can be created for</summary>
+  const std::size_t MinimumSize = 8;
+
+  /// <summary>Largest signal length a plan can be created for</summary>
+  /// <remarks>
+  ///   Beyond this, single precision twiddle factors lose too much accuracy and
+  ///   the bit reversal table would no longer fit its 32-bit entries anyway.
+  /// </remarks>
+  const std::size_t MaximumSize = std::size_t(1) << 24;
+
+  /// <summary>The number pi with enough digits for double precision</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps track of all plans that are currently in use</summary>
+  struct PlanCache {
+
+    /// <summary>Must be held while accessing the plans</summary>
+    public: std::mutex Mutex;
+    /// <summary>Plans that have been created, by signal length</summary>
+    public: std::map<std::size_t, std::weak_ptr<const Nuclex::Audio::Processing::FftPlan>> Plans;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the cache holding all plans that are currently in use</summary>
+  /// <returns>The plan cache</returns>
+  PlanCache &getPlanCache() {
+    static PlanCache cache;
+    return cache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs the butterflies of one FFT stage on split complex values</summary>
+  /// <param name="real">Real parts of the values being transformed</param>
+  /// <param name="imaginary">Imaginary parts of the values being transformed</param>
+  /// <param name="count">Total number of complex values</param>
+  /// <param name="half">Distance between the two inputs of each butterfly</param>
+  /// <param name="twiddleReal">Real parts of the stage's twiddle factors</param>
+  /// <param name="twiddleImaginary">Imaginary parts of the stage's twiddle factors</param>
+  void runStageScalar(
+    float *real, float *imaginary, std::size_t count, std::size_t half,
+    const float *twiddleReal, const float *twiddleImaginary
+  ) {
+    for(std::size_t block = 0; block < count; block += half * 2) {
+      float *lowerReal = real + block;
+      float *lowerImaginary = imaginary + block;
+      float *upperReal = lowerReal + half;
+      float *upperImaginary = lowerImaginary + half;
+
+      for(std::size_t index = 0; index < half; ++index) {
+        float productReal = (
+          upperReal[index] * twiddleReal[index] - upperImaginary[index] * twiddleImaginary[index]
+        );
+        float productImaginary = (
+          upperReal[index] * twiddleImaginary[index] + upperImaginary[index] * twiddleReal[index]
+        );
+
+        upperReal[index] = lowerReal[index] - productReal;
+        upperImaginary[index] = lowerImaginary[index] - productImaginary;
+        lowerReal[index] += productReal;
+        lowerImaginary[index] += productImaginary;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Runs the butterflies of one FFT stage, 4 at a time, using SSE2</summary>
+  /// <param name="real">Real parts of the values being transformed</param>
+  /// <param name="imaginary">Imaginary parts of the values being transformed</param>
+  /// <param name="count">Total number of complex values</param>
+  /// <param name="half">Distance between the two inputs of each butterfly, 4 or more</param>
+  /// <param name="twiddleReal">Real parts of the stage's twiddle factors</param>
+  /// <param name="twiddleImaginary">Imaginary parts of the stage's twiddle factors</param>
+  void runStageSse2(
+    float *real, float *imaginary, std::size_t count, std::size_t half,
+    const float *twiddleReal, const float *twiddleImaginary
+  ) {
+    for(std::size_t block = 0; block < count; block += half * 2) {
+      float *lowerReal = real + block;
+      float *lowerImaginary = imaginary + block;
+      float *upperReal = lowerReal + half;
+      float *upperImaginary = lowerImaginary + half;
+
+      for(std::size_t index = 0; index < half; index += 4) {
+        __m128 wr = _mm_loadu_ps(twiddleReal + index);
+        __m128 wi = _mm_loadu_ps(twiddleImaginary + index);
+        __m128 ur = _mm_loadu_ps(upperReal + index);
+        __m128 ui = _mm_loadu_ps(upperImaginary + index);
+        __m128 lr = _mm_loadu_ps(lowerReal + index);
+        __m128 li = _mm_loadu_ps(lowerImaginary + index);
+
+        __m128 pr = _mm_sub_ps(_mm_mul_ps(ur, wr), _mm_mul_ps(ui, wi));
+        __m128 pi = _mm_add_ps(_mm_mul_ps(ur, wi), _mm_mul_ps(ui, wr));
+
+        _mm_storeu_ps(upperReal + index, _mm_sub_ps(lr, pr));
+        _mm_storeu_ps(upperImaginary + index, _mm_sub_ps(li, pi));
+        _mm_storeu_ps(lowerReal + index, _mm_add_ps(lr, pr));
+        _mm_storeu_ps(lowerImaginary + index, _mm_add_ps(li, pi));
+      }
+    }
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Runs the butterflies of one FFT stage, 4 at a time, using NEON</summary>
+  /// <param name="real">Real parts of the values being transformed</param>
+  /// <param name="imaginary">Imaginary parts of the values being transformed</param>
+  /// <param name="count">Total number of complex values</param>
+  /// <param name="half">Distance between the two inputs of each butterfly, 4 or more</param>
+  /// <param name="twiddleReal">Real parts of the stage's twiddle factors</param>
+  /// <param name="twiddleImaginary">Imaginary parts of the stage's twiddle factors</param>
+  void runStageNeon(
+    float *real, float *imaginary, std::size_t count, std::size_t half,
+    const float *twiddleReal, const float *twiddleImaginary
+  ) {
+    for(std::size_t block = 0; block < count; block += half * 2) {
+      float *lowerReal = real + block;
+      float *lowerImaginary = imaginary + block;
+      float *upperReal = lowerReal + half;
+      float *upperImaginary = lowerImaginary + half;
+
+      for(std::size_t index = 0; index < half; index += 4) {
+        float32x4_t wr = vld1q_f32(twiddleReal + index);
+        float32x4_t wi = vld1q_f32(twiddleImaginary + index);
+        float32x4_t ur = vld1q_f32(upperReal + index);
+        float32x4_t ui = vld1q_f32(upperImaginary + index);
+        float32x4_t lr = vld1q_f32(lowerReal + index);
+        float32x4_t li = vld1q_f32(lowerImaginary + index);
+
+        float32x4_t pr = vmlsq_f32(vmulq_f32(ur, wr), ui, wi);
+        float32x4_t pi = vmlaq_f32(vmulq_f32(ur, wi), ui, wr);
+
+        vst1q_f32(upperReal + index, vsubq_f32(lr, pr));
+        vst1q_f32(upperImaginary + index, vsubq_f32(li, pi));
+        vst1q_f32(lowerReal + index, vaddq_f32(lr, pr));
+        vst1q_f32(lowerImaginary + index, vaddq_f32(li, pi));
+      }
+    }
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const FftPlan> FftPlan::GetShared(std::size_t size) {
+    PlanCache &cache = getPlanCache();
+
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      auto iterator = cache.Plans.find(size);
+      if(iterator != cache.Plans.end()) {
+        std::shared_ptr<const FftPlan> plan = iterator->second.lock();
+        if(static_cast<bool>(plan)) {
+          return plan;
+        }
+      }
+    }
+
+    // Build the plan outside of the lock. If another thread built the same plan
+    // in the meantime, one of them just ends up being used a little shorter.
+    std::shared_ptr<const FftPlan> plan = std::make_shared<FftPlan>(size);
+
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      // Drop cache entries whose plans are no longer used by anyone
+      for(auto iterator = cache.Plans.begin(); iterator != cache.Plans.end();) {
+        if(iterator->second.expired()) {
+          iterator = cache.Plans.erase(iterator);
+        } else {
+          ++iterator;
+        }
+      }
+
+      cache.Plans[size] = plan;
+    }
+
+    return plan;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FftPlan::FftPlan(std::size_t size) :
+    size(size),
+    bitReversal(),
+    twiddleReal(),
+    twiddleImaginary(),
+    splitReal(),
+    splitImaginary() {
+
+    if(unlikely((size < MinimumSize) || (size > MaximumSize))) {
+      throw std::invalid_argument(u8"FFT size must be between 8 and 16777216 samples");
+    }
+    if(unlikely((size & (size - 1)) != 0)) {
+      throw std::invalid_argument(u8"FFT size must be a power of two");
+    }
+
+    std::size_t count = size / 2;
+
+    // Position each complex input value ends up at after the stages have been run
+    std::size_t bitCount = 0;
+    while((std::size_t(1) << bitCount) < count) {
+      ++bitCount;
+    }
+    this->bitReversal.resize(count);
+    for(std::size_t index = 0; index < count; ++index) {
+      std::size_t reversed = 0;
+      for(std::size_t bit = 0; bit < bitCount; ++bit) {
+        if((index & (std::size_t(1) << bit)) != 0) {
+          reversed |= std::size_t(1) << (bitCount - bit - 1);
+        }
+      }
+      this->bitReversal[index] = static_cast<std::uint32_t>(reversed);
+    }
+
+    // Each stage gets its own contiguous twiddle factors, so the butterflies can
+    // load them linearly. The stage with half-width h starts at index h - 1.
+    this->twiddleReal.resize(count);
+    this->twiddleImaginary.resize(count);
+    for(std::size_t half = 1; half < count; half *= 2) {
+      for(std::size_t index = 0; index < half; ++index) {
+        double angle = -Pi * static_cast<double>(index) / static_cast<double>(half);
+        this->twiddleReal[half - 1 + index] = static_cast<float>(std::cos(angle));
+        this->twiddleImaginary[half - 1 + index] = static_cast<float>(std::sin(angle));
+      }
+    }
+
+    // Factors to combine the spectra of the even and odd samples into the real spectrum
+    this->splitReal.resize(count + 1);
+    this->splitImaginary.resize(count + 1);
+    for(std::size_t index = 0; index <= count; ++index) {
+      double angle = -2.0 * Pi * static_cast<double>(index) / static_cast<double>(size);
+      this->splitReal[index] = static_cast<float>(std::cos(angle));
+      this->splitImaginary[index] = static_cast<float>(std::sin(angle));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FftPlan::Transform(
+    const float *samples, float *real, float *imaginary, float *scratch
+  ) const {
+    transformComplex(samples, scratch);
+
+    std::size_t count = this->size / 2;
+    const float *zReal = scratch;
+    const float *zImaginary = scratch + count;
+
+    // The complex FFT interpreted even samples as real and odd samples as imaginary
+    // parts. Z[k] and the conjugate of Z[N/2 - k] separate them into the spectrum
+    // of the even samples E[k] and odd samples O[k], then X[k] = E[k] + W^k O[k].
+    for(std::size_t index = 0; index <= count; ++index) {
+      std::size_t forward = (index == count) ? 0 : index;
+      std::size_t mirrored = (index == 0) ? 0 : (count - index);
+
+      float a = zReal[forward], b = zImaginary[forward];
+      float c = zReal[mirrored], d = zImaginary[mirrored];
+
+      float evenReal = (a + c) * 0.5f;
+      float evenImaginary = (b - d) * 0.5f;
+      float oddReal = (b + d) * 0.5f;
+      float oddImaginary = (c - a) * 0.5f;
+
+      float wr = this->splitReal[index];
+      float wi = this->splitImaginary[index];
+      real[index] = evenReal + wr * oddReal - wi * oddImaginary;
+      imaginary[index] = evenImaginary + wr * oddImaginary + wi * oddReal;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FftPlan::ComputePowers(
+    const float *samples, float *powers, float scale, float *scratch
+  ) const {
+    std::size_t binCount = CountBins();
+
+    // The complex FFT needs the first N floats of the scratch buffer,
+    // the bins' imaginary parts go behind that
+    float *imaginary = scratch + this->size;
+    Transform(samples, powers, imaginary, scratch);
+
+    float squaredScale = scale * scale;
+    for(std::size_t index = 0; index < binCount; ++index) {
+      float real = powers[index];
+      powers[index] = (real * real + imaginary[index] * imaginary[index]) * squaredScale;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FftPlan::transformComplex(const float *samples, float *scratch) const {
+    std::size_t count = this->size / 2;
+    float *real = scratch;
+    float *imaginary = scratch + count;
+
+    // Pair up the real samples into complex values, in bit reversed order
+    for(std::size_t index = 0; index < count; ++index) {
+      std::size_t source = this->bitReversal[index] * 2;
+      real[index] = samples[source];
+      imaginary[index] = samples[source + 1];
+    }
+
+    // The first two stages have fewer butterflies per block than a vector has lanes
+    std::size_t half = 1;
+    for(; (half < count) && (half < 4); half *= 2) {
+      runStageScalar(
+        real, imaginary, count, half,
+        this->twiddleReal.data() + (half - 1), this->twiddleImaginary.data() + (half - 1)
+      );
+    }
+    for(; half < count; half *= 2) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+      runStageSse2(
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+      runStageNeon(
+#else
+      runStageScalar(
+#endif
+        real, imaginary, count, half,
+        this->twiddleReal.data() + (half - 1), this->twiddleImaginary.data() + (half - 1)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,533 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Int24Packing.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+
+#include "./CpuFeatures.h" // for CpuFeatures, NUCLEX_AUDIO_TARGET_SSSE3
+
+#include <algorithm> // for std::min()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of samples unpacked per batch before they are normalized</summary>
+  const std::size_t NormalizationBatchSampleCount = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of packing kernels for one instruction set</summary>
+  struct PackingKernelTable {
+
+    /// <summary>Unpacks 24-bit samples into 32-bit integers</summary>
+    public: void (*Unpack)(const std::byte *, std::int32_t *, std::size_t);
+    /// <summary>Unpacks big endian 24-bit samples into 32-bit integers</summary>
+    public: void (*UnpackBigEndian)(const std::byte *, std::int32_t *, std::size_t);
+    /// <summary>Unpacks 24-bit samples into the upper 24 bits of 32-bit integers</summary>
+    public: void (*UnpackHigh)(const std::byte *, std::int32_t *, std::size_t);
+    /// <summary>Packs 32-bit integers into 24-bit samples</summary>
+    public: void (*Pack)(const std::int32_t *, std::byte *, std::size_t);
+    /// <summary>Packs the upper 24 bits of 32-bit integers into 24-bit samples</summary>
+    public: void (*PackHigh)(const std::int32_t *, std::byte *, std::size_t);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks 24-bit samples one by one</summary>
+  /// <typeparam name="BigEndian">Whether the packed samples are big endian</typeparam>
+  /// <typeparam name="ToHigh">Whether to leave the samples in the upper 24 bits</typeparam>
+  /// <param name="packed">Packed samples, 3 bytes each</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  template<bool BigEndian, bool ToHigh = false>
+  void unpackScalar(const std::byte *packed, std::int32_t *results, std::size_t count) {
+    constexpr std::size_t lowIndex = BigEndian ? 2 : 0;
+    constexpr std::size_t highIndex = BigEndian ? 0 : 2;
+
+    while(0 < count) {
+
+      // Assemble the sample in the upper 24 bits, then let the arithmetic shift
+      // carry the sign bit down
+      std::uint32_t bits = (
+        (static_cast<std::uint32_t>(packed[lowIndex]) << 8) |
+        (static_cast<std::uint32_t>(packed[1]) << 16) |
+        (static_cast<std::uint32_t>(packed[highIndex]) << 24)
+      );
+      if constexpr(ToHigh) {
+        results[0] = static_cast<std::int32_t>(bits);
+      } else {
+        results[0] = static_cast<std::int32_t>(bits) >> 8;
+      }
+
+      packed += 3;
+      ++results;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs 24-bit samples one by one</summary>
+  /// <typeparam name="FromHigh">Whether to pack the upper 24 bits of each value</typeparam>
+  /// <param name="values">Samples that will be packed</param>
+  /// <param name="packed">Receives the packed samples, little endian</param>
+  /// <param name="count">Number of samples that will be packed</param>
+  template<bool FromHigh = false>
+  void packScalar(const std::int32_t *values, std::byte *packed, std::size_t count) {
+    constexpr int shift = FromHigh ? 8 : 0;
+
+    while(0 < count) {
+      std::uint32_t bits = static_cast<std::uint32_t>(values[0]) >> shift;
+      packed[0] = static_cast<std::byte>(bits);
+      packed[1] = static_cast<std::byte>(bits >> 8);
+      packed[2] = static_cast<std::byte>(bits >> 16);
+
+      ++values;
+      packed += 3;
+      --count;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Unpacks 24-bit samples 16 at a time using NEON</summary>
+  /// <typeparam name="BigEndian">Whether the packed samples are big endian</typeparam>
+  /// <typeparam name="ToHigh">Whether to leave the samples in the upper 24 bits</typeparam>
+  /// <param name="packed">Packed samples, 3 bytes each</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  template<bool BigEndian, bool ToHigh = false>
+  void unpackNeon(const std::byte *packed, std::int32_t *results, std::size_t count) {
+    uint8x16_t zero = vdupq_n_u8(0);
+    while(15 < count) {
+
+      // The structured load sorts the bytes of 16 samples into one vector per byte
+      // position, zipping them back together with a zero byte below yields the
+      // sample in the upper 24 bits of each lane
+      uint8x16x3_t bytes = vld3q_u8(reinterpret_cast<const std::uint8_t *>(packed));
+      if constexpr(BigEndian) {
+        uint8x16_t highBytes = bytes.val[0];
+        bytes.val[0] = bytes.val[2];
+        bytes.val[2] = highBytes;
+      }
+      uint16x8_t lowBytes0 = vreinterpretq_u16_u8(vzip1q_u8(zero, bytes.val[0]));
+      uint16x8_t lowBytes1 = vreinterpretq_u16_u8(vzip2q_u8(zero, bytes.val[0]));
+      uint16x8_t highBytes0 = vreinterpretq_u16_u8(vzip1q_u8(bytes.val[1], bytes.val[2]));
+      uint16x8_t highBytes1 = vreinterpretq_u16_u8(vzip2q_u8(bytes.val[1], bytes.val[2]));
+
+      int32x4_t unpacked[4] = {
+        vreinterpretq_s32_u16(vzip1q_u16(lowBytes0, highBytes0)),
+        vreinterpretq_s32_u16(vzip2q_u16(lowBytes0, highBytes0)),
+        vreinterpretq_s32_u16(vzip1q_u16(lowBytes1, highBytes1)),
+        vreinterpretq_s32_u16(vzip2q_u16(lowBytes1, highBytes1))
+      };
+      for(std::size_t index = 0; index < 4; ++index) {
+        if constexpr(ToHigh) {
+          vst1q_s32(results + index * 4, unpacked[index]);
+        } else {
+          vst1q_s32(results + index * 4, vshrq_n_s32(unpacked[index], 8));
+        }
+      }
+
+      packed += 48;
+      results += 16;
+      count -= 16;
+    }
+
+    unpackScalar<BigEndian, ToHigh>(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs 24-bit samples 16 at a time using NEON</summary>
+  /// <typeparam name="FromHigh">Whether to pack the upper 24 bits of each value</typeparam>
+  /// <param name="values">Samples that will be packed</param>
+  /// <param name="packed">Receives the packed samples, little endian</param>
+  /// <param name="count">Number of samples that will be packed</param>
+  template<bool FromHigh = false>
+  void packNeon(const std::int32_t *values, std::byte *packed, std::size_t count) {
+    while(15 < count) {
+      uint32x4_t values0 = vreinterpretq_u32_s32(vld1q_s32(values));
+      uint32x4_t values1 = vreinterpretq_u32_s32(vld1q_s32(values + 4));
+      uint32x4_t values2 = vreinterpretq_u32_s32(vld1q_s32(values + 8));
+      uint32x4_t values3 = vreinterpretq_u32_s32(vld1q_s32(values + 12));
+
+      if constexpr(FromHigh) {
+        values0 = vshrq_n_u32(values0, 8);
+        values1 = vshrq_n_u32(values1, 8);
+        values2 = vshrq_n_u32(values2, 8);
+        values3 = vshrq_n_u32(values3, 8);
+      }
+
+      // Narrow each byte position into its own vector, then let the structured
+      // store interleave them into 3 bytes per sample
+      uint8x16x3_t bytes;
+      bytes.val[0] = vcombine_u8(
+        vmovn_u16(vcombine_u16(vmovn_u32(values0), vmovn_u32(values1))),
+        vmovn_u16(vcombine_u16(vmovn_u32(values2), vmovn_u32(values3)))
+      );
+      bytes.val[1] = vcombine_u8(
+        vmovn_u16(vcombine_u16(vshrn_n_u32(values0, 8), vshrn_n_u32(values1, 8))),
+        vmovn_u16(vcombine_u16(vshrn_n_u32(values2, 8), vshrn_n_u32(values3, 8)))
+      );
+      bytes.val[2] = vcombine_u8(
+        vmovn_u16(vcombine_u16(vshrn_n_u32(values0, 16), vshrn_n_u32(values1, 16))),
+        vmovn_u16(vcombine_u16(vshrn_n_u32(values2, 16), vshrn_n_u32(values3, 16)))
+      );
+      vst3q_u8(reinterpret_cast<std::uint8_t *>(packed), bytes);
+
+      values += 16;
+      packed += 48;
+      count -= 16;
+    }
+
+    packScalar<FromHigh>(values, packed, count);
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Unpacks 24-bit samples 4 at a time using SSSE3</summary>
+  /// <typeparam name="BigEndian">Whether the packed samples are big endian</typeparam>
+  /// <typeparam name="ToHigh">Whether to leave the samples in the upper 24 bits</typeparam>
+  /// <param name="packed">Packed samples, 3 bytes each</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  template<bool BigEndian, bool ToHigh = false>
+  NUCLEX_AUDIO_TARGET_SSSE3 void unpackSsse3(
+    const std::byte *packed, std::int32_t *results, std::size_t count
+  ) {
+
+    // Moves the 3 bytes of each sample into the upper 24 bits of a lane, the lowest byte
+    // is zeroed (-1 in the shuffle mask) and disappears in the arithmetic shift. For big
+    // endian samples, the same shuffle simply picks the bytes in reverse order.
+    const __m128i shuffleMask = BigEndian ? (
+      _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+    ) : (
+      _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)
+    );
+
+    // Each load covers 16 bytes but only consumes 12, so keep enough samples in reserve
+    // to never read past the end of the packed samples
+    while(5 < count) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed));
+      __m128i unpacked = _mm_shuffle_epi8(bytes, shuffleMask);
+      if constexpr(!ToHigh) {
+        unpacked = _mm_srai_epi32(unpacked, 8);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(results), unpacked);
+      packed += 12;
+      results += 4;
+      count -= 4;
+    }
+
+    unpackScalar<BigEndian, ToHigh>(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs 24-bit samples 4 at a time using SSSE3</summary>
+  /// <typeparam name="FromHigh">Whether to pack the upper 24 bits of each value</typeparam>
+  /// <param name="values">Samples that will be packed</param>
+  /// <param name="packed">Receives the packed samples, little endian</param>
+  /// <param name="count">Number of samples that will be packed</param>
+  template<bool FromHigh = false>
+  NUCLEX_AUDIO_TARGET_SSSE3 void packSsse3(
+    const std::int32_t *values, std::byte *packed, std::size_t count
+  ) {
+
+    // Packing the upper 24 bits only means picking a different 3 bytes from each lane
+    const __m128i shuffleMask = FromHigh ? (
+      _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1)
+    ) : (
+      _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)
+    );
+
+    // Each store writes 16 bytes of which only 12 are samples. The 4 bytes of junk
+    // are overwritten by the next store, so there always must be a next store.
+    while(5 < count) {
+      __m128i valuesVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(packed), _mm_shuffle_epi8(valuesVector, shuffleMask)
+      );
+      values += 4;
+      packed += 12;
+      count -= 4;
+    }
+
+    packScalar<FromHigh>(values, packed, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks 24-bit samples 8 at a time using AVX2</summary>
+  /// <typeparam name="BigEndian">Whether the packed samples are big endian</typeparam>
+  /// <typeparam name="ToHigh">Whether to leave the samples in the upper 24 bits</typeparam>
+  /// <param name="packed">Packed samples, 3 bytes each</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  template<bool BigEndian, bool ToHigh = false>
+  NUCLEX_AUDIO_TARGET_AVX2 void unpackAvx2(
+    const std::byte *packed, std::int32_t *results, std::size_t count
+  ) {
+    const __m256i shuffleMask = BigEndian ? (
+      _mm256_setr_epi8(
+        -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9,
+        -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9
+      )
+    ) : (
+      _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11
+      )
+    );
+
+    // The AVX2 byte shuffle can't cross between the two 128-bit halves, so each
+    // half is loaded with the 4 samples it is going to unpack. The upper load reaches
+    // 28 bytes in, which is why 2 samples are kept in reserve.
+    while(9 < count) {
+      __m256i bytes = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(packed))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed + 12)),
+        1
+      );
+      __m256i unpacked = _mm256_shuffle_epi8(bytes, shuffleMask);
+      if constexpr(!ToHigh) {
+        unpacked = _mm256_srai_epi32(unpacked, 8);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(results), unpacked);
+      packed += 24;
+      results += 8;
+      count -= 8;
+    }
+
+    unpackSsse3<BigEndian, ToHigh>(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs 24-bit samples 8 at a time using AVX2</summary>
+  /// <typeparam name="FromHigh">Whether to pack the upper 24 bits of each value</typeparam>
+  /// <param name="values">Samples that will be packed</param>
+  /// <param name="packed">Receives the packed samples, little endian</param>
+  /// <param name="count">Number of samples that will be packed</param>
+  template<bool FromHigh = false>
+  NUCLEX_AUDIO_TARGET_AVX2 void packAvx2(
+    const std::int32_t *values, std::byte *packed, std::size_t count
+  ) {
+    const __m256i shuffleMask = FromHigh ? (
+      _mm256_setr_epi8(
+        1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1,
+        1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1
+      )
+    ) : (
+      _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+      )
+    );
+
+    // Pulls the 3 used dwords of the upper half down so all 24 bytes are consecutive
+    const __m256i compactOrder = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+    // Each store writes 32 bytes of which only 24 are samples, like in the SSSE3
+    // variant, the junk is overwritten by whatever comes next
+    while(10 < count) {
+      __m256i valuesVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(packed),
+        _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(valuesVector, shuffleMask), compactOrder)
+      );
+      values += 8;
+      packed += 24;
+      count -= 8;
+    }
+
+    packSsse3<FromHigh>(values, packed, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Selects the fastest packing kernels the CPU this is running on supports</summary>
+  /// <returns>A table with the fastest packing kernels for the CPU</returns>
+  PackingKernelTable selectKernels() {
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+    PackingKernelTable table = {
+      &unpackNeon<false>, &unpackNeon<true>, &unpackNeon<false, true>,
+      &packNeon<false>, &packNeon<true>
+    };
+#else
+    PackingKernelTable table = {
+      &unpackScalar<false>, &unpackScalar<true>, &unpackScalar<false, true>,
+      &packScalar<false>, &packScalar<true>
+    };
+#endif
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    const Nuclex::Audio::Processing::CpuFeatures &features = (
+      Nuclex::Audio::Processing::CpuFeatures::Get()
+    );
+    if(features.HasAvx2) {
+      table = PackingKernelTable {
+        &unpackAvx2<false>, &unpackAvx2<true>, &unpackAvx2<false, true>,
+        &packAvx2<false>, &packAvx2<true>
+      };
+    } else if(features.HasSsse3) {
+      table = PackingKernelTable {
+        &unpackSsse3<false>, &unpackSsse3<true>, &unpackSsse3<false, true>,
+        &packSsse3<false>, &packSsse3<true>
+      };
+    }
+#endif
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the packing kernel table, selecting the kernels on first use</summary>
+  /// <returns>The kernel table with the fastest packing kernels for the CPU</returns>
+  const PackingKernelTable &getKernels() {
+    static const PackingKernelTable kernels = selectKernels();
+    return kernels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks and normalizes 24-bit samples in batches</summary>
+  /// <typeparam name="TResult">Type of the floating point results</typeparam>
+  /// <param name="unpack">Kernel that will be used to unpack the samples</param>
+  /// <param name="packed">Packed samples, 3 bytes each</param>
+  /// <param name="shift">Number of bits to shift each sample to the right</param>
+  /// <param name="quotient">Quotient by which the shifted samples will be divided</param>
+  /// <param name="results">Receives the normalized samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  template<typename TResult>
+  void unpackAndNormalize(
+    void (*unpack)(const std::byte *, std::int32_t *, std::size_t),
+    const std::byte *packed, int shift, double quotient, TResult *results, std::size_t count
+  ) {
+    std::int32_t unpacked[NormalizationBatchSampleCount];
+
+    while(0 < count) {
+      std::size_t batchSampleCount = std::min(count, NormalizationBatchSampleCount);
+      unpack(packed, unpacked, batchSampleCount);
+      Nuclex::Audio::Processing::ConversionKernels::ShiftAndDivideInt32ToFloat(
+        unpacked, shift, quotient, results, batchSampleCount
+      );
+
+      packed += batchSampleCount * 3;
+      results += batchSampleCount;
+      count -= batchSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackToInt32(
+    const std::byte *packed, std::int32_t *results, std::size_t count
+  ) {
+    getKernels().Unpack(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackToFloat(
+    const std::byte *packed, int shift, double quotient, float *results, std::size_t count
+  ) {
+    unpackAndNormalize(getKernels().Unpack, packed, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackToFloat(
+    const std::byte *packed, int shift, double quotient, double *results, std::size_t count
+  ) {
+    unpackAndNormalize(getKernels().Unpack, packed, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackToHighInt32(
+    const std::byte *packed, std::int32_t *results, std::size_t count
+  ) {
+    getKernels().UnpackHigh(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackBigEndianToInt32(
+    const std::byte *packed, std::int32_t *results, std::size_t count
+  ) {
+    getKernels().UnpackBigEndian(packed, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackBigEndianToFloat(
+    const std::byte *packed, int shift, double quotient, float *results, std::size_t count
+  ) {
+    unpackAndNormalize(getKernels().UnpackBigEndian, packed, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::UnpackBigEndianToFloat(
+    const std::byte *packed, int shift, double quotient, double *results, std::size_t count
+  ) {
+    unpackAndNormalize(getKernels().UnpackBigEndian, packed, shift, quotient, results, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::PackFromInt32(
+    const std::int32_t *values, std::byte *packed, std::size_t count
+  ) {
+    getKernels().Pack(values, packed, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Int24Packing::PackHighFromInt32(
+    const std::int32_t *values, std::byte *packed, std::size_t count
+  ) {
+    getKernels().PackHigh(values, packed, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
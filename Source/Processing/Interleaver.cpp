@@ -0,0 +1,658 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Interleaver.h"
+
+#include <algorithm> // for std::copy_n(), std::find()
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Whether the SSE2 SIMD instructions are supported by the targeted architecture
+#if defined(_MSC_VER)
+  #if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define NUCLEX_AUDIO_HAVE_SSE2 1
+  #endif
+#elif defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
+  #if defined(__SSE2__) || defined(__SSE2_MATH__)
+    #define NUCLEX_AUDIO_HAVE_SSE2 1
+  #endif
+#endif
+
+// Whether the ARM NEON SIMD instructions are supported by the targeted architecture
+#if defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_NEON))
+  #define NUCLEX_AUDIO_HAVE_NEON 1
+#endif
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interleaves channels for a channel count known at compile time</summary>
+  /// <typeparam name="TSample">Type of the samples that will be interleaved</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels that will be interleaved</typeparam>
+  /// <param name="sources">Buffers holding the samples of each channel</param>
+  /// <param name="target">Buffer that receives the interleaved samples</param>
+  /// <param name="frameCount">Number of frames that will be interleaved</param>
+  template<typename TSample, std::size_t ChannelCount>
+  void interleaveFixed(
+    const TSample *const sources[], TSample *target, std::size_t frameCount
+  ) {
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < ChannelCount; ++channelIndex) {
+        target[channelIndex] = sources[channelIndex][frameIndex];
+      }
+      target += ChannelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Separates channels for a channel count known at compile time</summary>
+  /// <typeparam name="TSample">Type of the samples that will be separated</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels that will be separated</typeparam>
+  /// <param name="source">Buffer holding the interleaved samples</param>
+  /// <param name="targets">Buffers that receive the samples of each channel</param>
+  /// <param name="frameCount">Number of frames that will be separated</param>
+  template<typename TSample, std::size_t ChannelCount>
+  void deinterleaveFixed(
+    const TSample *source, TSample *const targets[], std::size_t frameCount
+  ) {
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < ChannelCount; ++channelIndex) {
+        targets[channelIndex][frameIndex] = source[channelIndex];
+      }
+      source += ChannelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interleaves any number of channels one channel at a time</summary>
+  /// <typeparam name="TSample">Type of the samples that will be interleaved</typeparam>
+  /// <param name="sources">Buffers holding the samples of each channel</param>
+  /// <param name="target">Buffer that receives the interleaved samples</param>
+  /// <param name="channelCount">Number of channels that will be interleaved</param>
+  /// <param name="frameCount">Number of frames that will be interleaved</param>
+  template<typename TSample>
+  void interleaveGeneric(
+    const TSample *const sources[], TSample *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      const TSample *source = sources[channelIndex];
+      TSample *channelTarget = target + channelIndex;
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        *channelTarget = source[frameIndex];
+        channelTarget += channelCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Separates any number of channels one channel at a time</summary>
+  /// <typeparam name="TSample">Type of the samples that will be separated</typeparam>
+  /// <param name="source">Buffer holding the interleaved samples</param>
+  /// <param name="targets">Buffers that receive the samples of each channel or null</param>
+  /// <param name="channelCount">Number of channels that will be separated</param>
+  /// <param name="frameCount">Number of frames that will be separated</param>
+  template<typename TSample>
+  void deinterleaveGeneric(
+    const TSample *source, TSample *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      TSample *target = targets[channelIndex];
+      if(target == nullptr) {
+        continue; // Caller is not interested in this channel
+      }
+
+      const TSample *channelSource = source + channelIndex;
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        target[frameIndex] = *channelSource;
+        channelSource += channelCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) || defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  // The kernels below are written against a handful of 4-lane vector operations so that
+  // the same code serves SSE2 and NEON. Integers are moved through float registers,
+  // which is fine because the shuffles never look at the bits they are moving.
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Vector register holding 4 samples of 32 bits each</summary>
+  typedef __m128 Vector4;
+
+  /// <summary>Loads 4 consecutive samples into a vector</summary>
+  /// <param name="source">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding the 4 samples</returns>
+  inline Vector4 load4(const float *source) { return _mm_loadu_ps(source); }
+
+  /// <summary>Loads 4 consecutive samples into a vector</summary>
+  /// <param name="source">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding the 4 samples</returns>
+  inline Vector4 load4(const std::int32_t *source) {
+    return _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)));
+  }
+
+  /// <summary>Stores the 4 samples in a vector at consecutive addresses</summary>
+  /// <param name="target">Address at which the first sample will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store4(float *target, Vector4 vector) { _mm_storeu_ps(target, vector); }
+
+  /// <summary>Stores the 4 samples in a vector at consecutive addresses</summary>
+  /// <param name="target">Address at which the first sample will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store4(std::int32_t *target, Vector4 vector) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_castps_si128(vector));
+  }
+
+  /// <summary>Loads two pairs of consecutive samples into a vector</summary>
+  /// <param name="lower">Address of the pair that goes into the lower half</param>
+  /// <param name="upper">Address of the pair that goes into the upper half</param>
+  /// <returns>A vector holding both pairs of samples</returns>
+  template<typename TSample>
+  inline Vector4 load2x2(const TSample *lower, const TSample *upper) {
+    return _mm_loadh_pi(
+      _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(lower)),
+      reinterpret_cast<const __m64 *>(upper)
+    );
+  }
+
+  /// <summary>Stores the lower and upper halves of a vector at separate addresses</summary>
+  /// <param name="lower">Address at which the lower pair of samples will be stored</param>
+  /// <param name="upper">Address at which the upper pair of samples will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  template<typename TSample>
+  inline void store2x2(TSample *lower, TSample *upper, Vector4 vector) {
+    _mm_storel_pi(reinterpret_cast<__m64 *>(lower), vector);
+    _mm_storeh_pi(reinterpret_cast<__m64 *>(upper), vector);
+  }
+
+  /// <summary>Interleaves the lanes of two vectors (a0 b0 a1 b1, a2 b2 a3 b3)</summary>
+  /// <param name="first">First vector, receives the lower interleaved half</param>
+  /// <param name="second">Second vector, receives the upper interleaved half</param>
+  inline void zip(Vector4 &first, Vector4 &second) {
+    Vector4 lower = _mm_unpacklo_ps(first, second);
+    second = _mm_unpackhi_ps(first, second);
+    first = lower;
+  }
+
+  /// <summary>Separates the even and odd lanes of two vectors</summary>
+  /// <param name="first">First vector, receives the even lanes of both vectors</param>
+  /// <param name="second">Second vector, receives the odd lanes of both vectors</param>
+  inline void unzip(Vector4 &first, Vector4 &second) {
+    Vector4 evens = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    second = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+    first = evens;
+  }
+
+  /// <summary>Transposes a 4x4 matrix held in four vectors</summary>
+  /// <param name="row0">First row of the matrix, receives the first column</param>
+  /// <param name="row1">Second row of the matrix, receives the second column</param>
+  /// <param name="row2">Third row of the matrix, receives the third column</param>
+  /// <param name="row3">Fourth row of the matrix, receives the fourth column</param>
+  inline void transpose(Vector4 &row0, Vector4 &row1, Vector4 &row2, Vector4 &row3) {
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+  }
+
+#else // NUCLEX_AUDIO_HAVE_NEON
+
+  /// <summary>Vector register holding 4 samples of 32 bits each</summary>
+  typedef float32x4_t Vector4;
+
+  /// <summary>Loads 4 consecutive samples into a vector</summary>
+  /// <param name="source">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding the 4 samples</returns>
+  inline Vector4 load4(const float *source) { return vld1q_f32(source); }
+
+  /// <summary>Loads 4 consecutive samples into a vector</summary>
+  /// <param name="source">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding the 4 samples</returns>
+  inline Vector4 load4(const std::int32_t *source) {
+    return vreinterpretq_f32_s32(vld1q_s32(source));
+  }
+
+  /// <summary>Stores the 4 samples in a vector at consecutive addresses</summary>
+  /// <param name="target">Address at which the first sample will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store4(float *target, Vector4 vector) { vst1q_f32(target, vector); }
+
+  /// <summary>Stores the 4 samples in a vector at consecutive addresses</summary>
+  /// <param name="target">Address at which the first sample will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store4(std::int32_t *target, Vector4 vector) {
+    vst1q_s32(target, vreinterpretq_s32_f32(vector));
+  }
+
+  /// <summary>Loads two pairs of consecutive samples into a vector</summary>
+  /// <param name="lower">Address of the pair that goes into the lower half</param>
+  /// <param name="upper">Address of the pair that goes into the upper half</param>
+  /// <returns>A vector holding both pairs of samples</returns>
+  inline Vector4 load2x2(const float *lower, const float *upper) {
+    return vcombine_f32(vld1_f32(lower), vld1_f32(upper));
+  }
+
+  /// <summary>Loads two pairs of consecutive samples into a vector</summary>
+  /// <param name="lower">Address of the pair that goes into the lower half</param>
+  /// <param name="upper">Address of the pair that goes into the upper half</param>
+  /// <returns>A vector holding both pairs of samples</returns>
+  inline Vector4 load2x2(const std::int32_t *lower, const std::int32_t *upper) {
+    return vreinterpretq_f32_s32(vcombine_s32(vld1_s32(lower), vld1_s32(upper)));
+  }
+
+  /// <summary>Stores the lower and upper halves of a vector at separate addresses</summary>
+  /// <param name="lower">Address at which the lower pair of samples will be stored</param>
+  /// <param name="upper">Address at which the upper pair of samples will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store2x2(float *lower, float *upper, Vector4 vector) {
+    vst1_f32(lower, vget_low_f32(vector));
+    vst1_f32(upper, vget_high_f32(vector));
+  }
+
+  /// <summary>Stores the lower and upper halves of a vector at separate addresses</summary>
+  /// <param name="lower">Address at which the lower pair of samples will be stored</param>
+  /// <param name="upper">Address at which the upper pair of samples will be stored</param>
+  /// <param name="vector">Vector holding the samples that will be stored</param>
+  inline void store2x2(std::int32_t *lower, std::int32_t *upper, Vector4 vector) {
+    int32x4_t integers = vreinterpretq_s32_f32(vector);
+    vst1_s32(lower, vget_low_s32(integers));
+    vst1_s32(upper, vget_high_s32(integers));
+  }
+
+  /// <summary>Interleaves the lanes of two vectors (a0 b0 a1 b1, a2 b2 a3 b3)</summary>
+  /// <param name="first">First vector, receives the lower interleaved half</param>
+  /// <param name="second">Second vector, receives the upper interleaved half</param>
+  inline void zip(Vector4 &first, Vector4 &second) {
+    Vector4 lower = vzip1q_f32(first, second);
+    second = vzip2q_f32(first, second);
+    first = lower;
+  }
+
+  /// <summary>Separates the even and odd lanes of two vectors</summary>
+  /// <param name="first">First vector, receives the even lanes of both vectors</param>
+  /// <param name="second">Second vector, receives the odd lanes of both vectors</param>
+  inline void unzip(Vector4 &first, Vector4 &second) {
+    Vector4 evens = vuzp1q_f32(first, second);
+    second = vuzp2q_f32(first, second);
+    first = evens;
+  }
+
+  /// <summary>Transposes a 4x4 matrix held in four vectors</summary>
+  /// <param name="row0">First row of the matrix, receives the first column</param>
+  /// <param name="row1">Second row of the matrix, receives the second column</param>
+  /// <param name="row2">Third row of the matrix, receives the third column</param>
+  /// <param name="row3">Fourth row of the matrix, receives the fourth column</param>
+  inline void transpose(Vector4 &row0, Vector4 &row1, Vector4 &row2, Vector4 &row3) {
+    float64x2_t evens01 = vreinterpretq_f64_f32(vtrn1q_f32(row0, row1));
+    float64x2_t odds01 = vreinterpretq_f64_f32(vtrn2q_f32(row0, row1));
+    float64x2_t evens23 = vreinterpretq_f64_f32(vtrn1q_f32(row2, row3));
+    float64x2_t odds23 = vreinterpretq_f64_f32(vtrn2q_f32(row2, row3));
+
+    row0 = vreinterpretq_f32_f64(vtrn1q_f64(evens01, evens23));
+    row1 = vreinterpretq_f32_f64(vtrn1q_f64(odds01, odds23));
+    row2 = vreinterpretq_f32_f64(vtrn2q_f64(evens01, evens23));
+    row3 = vreinterpretq_f32_f64(vtrn2q_f64(odds01, odds23));
+  }
+
+#endif // NUCLEX_AUDIO_HAVE_SSE2 / NUCLEX_AUDIO_HAVE_NEON
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interleaves 32-bit samples of 2, 4, 6 or 8 channels using SIMD shuffles</summary>
+  /// <typeparam name="TSample">Type of the samples, either float or std::int32_t</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels that will be interleaved</typeparam>
+  /// <param name="sources">Buffers holding the samples of each channel</param>
+  /// <param name="target">Buffer that receives the interleaved samples</param>
+  /// <param name="frameCount">Number of frames that will be interleaved</param>
+  template<typename TSample, std::size_t ChannelCount>
+  void interleaveVectorized(
+    const TSample *const sources[], TSample *target, std::size_t frameCount
+  ) {
+    static_assert(
+      (ChannelCount == 2) || (ChannelCount == 4) || (ChannelCount == 6) || (ChannelCount == 8)
+    );
+
+    const TSample *channels[ChannelCount];
+    std::copy_n(sources, ChannelCount, channels);
+
+    while(3 < frameCount) {
+      if constexpr(ChannelCount == 2) {
+        Vector4 left = load4(channels[0]), right = load4(channels[1]);
+        zip(left, right);
+        store4(target, left);
+        store4(target + 4, right);
+      } else {
+        Vector4 frame0 = load4(channels[0]), frame1 = load4(channels[1]);
+        Vector4 frame2 = load4(channels[2]), frame3 = load4(channels[3]);
+        transpose(frame0, frame1, frame2, frame3);
+
+        if constexpr(ChannelCount == 4) {
+          store4(target, frame0);
+          store4(target + 4, frame1);
+          store4(target + 8, frame2);
+          store4(target + 12, frame3);
+        } else if constexpr(ChannelCount == 6) {
+          Vector4 lowerPairs = load4(channels[4]), upperPairs = load4(channels[5]);
+          zip(lowerPairs, upperPairs);
+          store4(target, frame0);
+          store4(target + 6, frame1);
+          store4(target + 12, frame2);
+          store4(target + 18, frame3);
+          store2x2(target + 4, target + 10, lowerPairs);
+          store2x2(target + 16, target + 22, upperPairs);
+        } else { // ChannelCount == 8
+          Vector4 upper0 = load4(channels[4]), upper1 = load4(channels[5]);
+          Vector4 upper2 = load4(channels[6]), upper3 = load4(channels[7]);
+          transpose(upper0, upper1, upper2, upper3);
+          store4(target, frame0);
+          store4(target + 4, upper0);
+          store4(target + 8, frame1);
+          store4(target + 12, upper1);
+          store4(target + 16, frame2);
+          store4(target + 20, upper2);
+          store4(target + 24, frame3);
+          store4(target + 28, upper3);
+        }
+      }
+
+      for(std::size_t channelIndex = 0; channelIndex < ChannelCount; ++channelIndex) {
+        channels[channelIndex] += 4;
+      }
+      target += ChannelCount * 4;
+      frameCount -= 4;
+    }
+
+    interleaveFixed<TSample, ChannelCount>(channels, target, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Separates 32-bit samples of 2, 4, 6 or 8 channels using SIMD shuffles</summary>
+  /// <typeparam name="TSample">Type of the samples, either float or std::int32_t</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels that will be separated</typeparam>
+  /// <param name="source">Buffer holding the interleaved samples</param>
+  /// <param name="targets">Buffers that receive the samples of each channel</param>
+  /// <param name="frameCount">Number of frames that will be separated</param>
+  template<typename TSample, std::size_t ChannelCount>
+  void deinterleaveVectorized(
+    const TSample *source, TSample *const targets[], std::size_t frameCount
+  ) {
+    static_assert(
+      (ChannelCount == 2) || (ChannelCount == 4) || (ChannelCount == 6) || (ChannelCount == 8)
+    );
+
+    TSample *channels[ChannelCount];
+    std::copy_n(targets, ChannelCount, channels);
+
+    while(3 < frameCount) {
+      if constexpr(ChannelCount == 2) {
+        Vector4 left = load4(source), right = load4(source + 4);
+        unzip(left, right);
+        store4(channels[0], left);
+        store4(channels[1], right);
+      } else if constexpr(ChannelCount == 4) {
+        Vector4 channel0 = load4(source), channel1 = load4(source + 4);
+        Vector4 channel2 = load4(source + 8), channel3 = load4(source + 12);
+        transpose(channel0, channel1, channel2, channel3);
+        store4(channels[0], channel0);
+        store4(channels[1], channel1);
+        store4(channels[2], channel2);
+        store4(channels[3], channel3);
+      } else if constexpr(ChannelCount == 6) {
+        Vector4 channel0 = load4(source), channel1 = load4(source + 6);
+        Vector4 channel2 = load4(source + 12), channel3 = load4(source + 18);
+        Vector4 channel4 = load2x2(source + 4, source + 10);
+        Vector4 channel5 = load2x2(source + 16, source + 22);
+        transpose(channel0, channel1, channel2, channel3);
+        unzip(channel4, channel5);
+        store4(channels[0], channel0);
+        store4(channels[1], channel1);
+        store4(channels[2], channel2);
+        store4(channels[3], channel3);
+        store4(channels[4], channel4);
+        store4(channels[5], channel5);
+      } else { // ChannelCount == 8
+        Vector4 channel0 = load4(source), channel4 = load4(source + 4);
+        Vector4 channel1 = load4(source + 8), channel5 = load4(source + 12);
+        Vector4 channel2 = load4(source + 16), channel6 = load4(source + 20);
+        Vector4 channel3 = load4(source + 24), channel7 = load4(source + 28);
+        transpose(channel0, channel1, channel2, channel3);
+        transpose(channel4, channel5, channel6, channel7);
+        store4(channels[0], channel0);
+        store4(channels[1], channel1);
+        store4(channels[2], channel2);
+        store4(channels[3], channel3);
+        store4(channels[4], channel4);
+        store4(channels[5], channel5);
+        store4(channels[6], channel6);
+        store4(channels[7], channel7);
+      }
+
+      for(std::size_t channelIndex = 0; channelIndex < ChannelCount; ++channelIndex) {
+        channels[channelIndex] += 4;
+      }
+      source += ChannelCount * 4;
+      frameCount -= 4;
+    }
+
+    deinterleaveFixed<TSample, ChannelCount>(source, channels, frameCount);
+  }
+
+#endif // NUCLEX_AUDIO_HAVE_SSE2 || NUCLEX_AUDIO_HAVE_NEON
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the fastest way to interleave the specified number of channels</summary>
+  /// <typeparam name="TSample">Type of the samples that will be interleaved</typeparam>
+  /// <param name="sources">Buffers holding the samples of each channel</param>
+  /// <param name="target">Buffer that receives the interleaved samples</param>
+  /// <param name="channelCount">Number of channels that will be interleaved</param>
+  /// <param name="frameCount">Number of frames that will be interleaved</param>
+  template<typename TSample>
+  void interleave(
+    const TSample *const sources[], TSample *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) || defined(NUCLEX_AUDIO_HAVE_NEON)
+    if constexpr(sizeof(TSample) == 4) {
+      switch(channelCount) {
+        case 2: { interleaveVectorized<TSample, 2>(sources, target, frameCount); return; }
+        case 4: { interleaveVectorized<TSample, 4>(sources, target, frameCount); return; }
+        case 6: { interleaveVectorized<TSample, 6>(sources, target, frameCount); return; }
+        case 8: { interleaveVectorized<TSample, 8>(sources, target, frameCount); return; }
+        default: { break; }
+      }
+    }
+#endif
+    switch(channelCount) {
+      case 1: { std::copy_n(sources[0], frameCount, target); break; }
+      case 2: { interleaveFixed<TSample, 2>(sources, target, frameCount); break; }
+      case 3: { interleaveFixed<TSample, 3>(sources, target, frameCount); break; }
+      case 4: { interleaveFixed<TSample, 4>(sources, target, frameCount); break; }
+      case 5: { interleaveFixed<TSample, 5>(sources, target, frameCount); break; }
+      case 6: { interleaveFixed<TSample, 6>(sources, target, frameCount); break; }
+      case 7: { interleaveFixed<TSample, 7>(sources, target, frameCount); break; }
+      case 8: { interleaveFixed<TSample, 8>(sources, target, frameCount); break; }
+      default: { interleaveGeneric(sources, target, channelCount, frameCount); break; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the fastest way to separate the specified number of channels</summary>
+  /// <typeparam name="TSample">Type of the samples that will be separated</typeparam>
+  /// <param name="source">Buffer holding the interleaved samples</param>
+  /// <param name="targets">Buffers that receive the samples of each channel or null</param>
+  /// <param name="channelCount">Number of channels that will be separated</param>
+  /// <param name="frameCount">Number of frames that will be separated</param>
+  template<typename TSample>
+  void deinterleave(
+    const TSample *source, TSample *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+
+    // The specialized variants write every channel, so if the caller skips any,
+    // the generic variant has to do the job
+    if(std::find(targets, targets + channelCount, nullptr) != targets + channelCount) {
+      deinterleaveGeneric(source, targets, channelCount, frameCount);
+      return;
+    }
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) || defined(NUCLEX_AUDIO_HAVE_NEON)
+    if constexpr(sizeof(TSample) == 4) {
+      switch(channelCount) {
+        case 2: { deinterleaveVectorized<TSample, 2>(source, targets, frameCount); return; }
+        case 4: { deinterleaveVectorized<TSample, 4>(source, targets, frameCount); return; }
+        case 6: { deinterleaveVectorized<TSample, 6>(source, targets, frameCount); return; }
+        case 8: { deinterleaveVectorized<TSample, 8>(source, targets, frameCount); return; }
+        default: { break; }
+      }
+    }
+#endif
+    switch(channelCount) {
+      case 1: { std::copy_n(source, frameCount, targets[0]); break; }
+      case 2: { deinterleaveFixed<TSample, 2>(source, targets, frameCount); break; }
+      case 3: { deinterleaveFixed<TSample, 3>(source, targets, frameCount); break; }
+      case 4: { deinterleaveFixed<TSample, 4>(source, targets, frameCount); break; }
+      case 5: { deinterleaveFixed<TSample, 5>(source, targets, frameCount); break; }
+      case 6: { deinterleaveFixed<TSample, 6>(source, targets, frameCount); break; }
+      case 7: { deinterleaveFixed<TSample, 7>(source, targets, frameCount); break; }
+      case 8: { deinterleaveFixed<TSample, 8>(source, targets, frameCount); break; }
+      default: { deinterleaveGeneric(source, targets, channelCount, frameCount); break; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Interleave(
+    const std::uint8_t *const sources[], std::uint8_t *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    interleave(sources, target, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Interleave(
+    const std::int16_t *const sources[], std::int16_t *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    interleave(sources, target, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Interleave(
+    const std::int32_t *const sources[], std::int32_t *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    interleave(sources, target, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Interleave(
+    const float *const sources[], float *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    interleave(sources, target, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Interleave(
+    const double *const sources[], double *target,
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    interleave(sources, target, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Deinterleave(
+    const std::uint8_t *source, std::uint8_t *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    deinterleave(source, targets, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Deinterleave(
+    const std::int16_t *source, std::int16_t *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    deinterleave(source, targets, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Deinterleave(
+    const std::int32_t *source, std::int32_t *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    deinterleave(source, targets, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Deinterleave(
+    const float *source, float *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    deinterleave(source, targets, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Interleaver::Deinterleave(
+    const double *source, double *const targets[],
+    std::size_t channelCount, std::size_t frameCount
+  ) {
+    deinterleave(source, targets, channelCount, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
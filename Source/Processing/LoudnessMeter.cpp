@@ -0,0 +1,527 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/LoudnessMeter.h"
+#include "Nuclex/Audio/Processing/DecibelConverter.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+
+#include <algorithm> // for std::max(), std::fill(), std::copy_n()
+#include <cassert> // for assert()
+#include <cmath> // for std::tan(), std::pow(), std::log10(), std::sin(), std::cos()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>The number pi, for calculating the filter coefficients</summary>
+  const double Pi = 3.14159265358979323846;
+
+  /// <summary>Weight of surround channels, which BS.1770 boosts by about 1.5 dB</summary>
+  const double SurroundChannelWeight = 1.41;
+
+  /// <summary>Number of 100 millisecond steps in the momentary loudness window</summary>
+  const std::size_t MomentaryStepCount = 4;
+
+  /// <summary>Number of 100 millisecond steps in the short-term loudness window</summary>
+  const std::size_t ShortTermStepCount = 30;
+
+  /// <summary>Number of input samples each phase of the oversampling filter looks at</summary>
+  const std::size_t OversamplingTapCount = 12;
+
+  /// <summary>Power of a block at the absolute gate of -70 LUFS</summary>
+  const double AbsoluteGatePower = 1.1724653045822963e-7; // 10^((-70 + 0.691) / 10)
+
+  /// <summary>Factor between the ungated mean power and the relative gate (-10 LU)</summary>
+  const double RelativeGateFactor = 0.1;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a channel weighted mean power into loudness units</summary>
+  /// <param name="power">Mean power that will be converted</param>
+  /// <returns>The loudness in LUFS</returns>
+  double loudnessFromPower(double power) {
+    if(power > 0.0) {
+      return -0.691 + 10.0 * std::log10(power);
+    } else {
+      return -std::numeric_limits<double>::infinity();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the weight BS.1770 assigns to a channel</summary>
+  /// <param name="placement">Placement of the channel</param>
+  /// <returns>The weight of the channel's power in the overall loudness</returns>
+  double getChannelWeight(Nuclex::Audio::ChannelPlacement placement) {
+    using Nuclex::Audio::ChannelPlacement;
+
+    switch(placement) {
+      case ChannelPlacement::LowFrequencyEffects: {
+        return 0.0;
+      }
+      case ChannelPlacement::BackLeft:
+      case ChannelPlacement::BackRight:
+      case ChannelPlacement::SideLeft:
+      case ChannelPlacement::SideRight: {
+        return SurroundChannelWeight;
+      }
+      default: {
+        return 1.0;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoudnessMeter::LoudnessMeter(
+    std::size_t sampleRate, const std::vector<ChannelPlacement> &channelOrder
+  ) :
+    channelCount(channelOrder.size()),
+    paddedChannelCount((channelOrder.size() + 1) & ~std::size_t(1)),
+    stepFrameCount(std::max<std::size_t>((sampleRate + 5) / 10, 1)),
+    channelWeights(),
+    filterCoefficients(),
+    filterStates(),
+    frame(),
+    stepEnergies(),
+    stepFrameIndex(0),
+    recentStepEnergies(),
+    completedStepCount(0),
+    gatedBlockPowers(),
+    oversamplingCoefficients(),
+    oversamplingHistory(),
+    historyIndex(0),
+    truePeaks() {
+
+    if(unlikely(sampleRate == 0)) {
+      throw std::invalid_argument(u8"Loudness meter requires a valid sample rate");
+    }
+    if(unlikely(channelOrder.empty())) {
+      throw std::invalid_argument(u8"Loudness meter needs at least one channel");
+    }
+
+    this->channelWeights.reserve(this->channelCount);
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      this->channelWeights.push_back(getChannelWeight(channelOrder[index]));
+    }
+
+    // K-weighting stage 1: high shelf modelling the acoustic effect of the head.
+    // The analog prototype is from BS.1770, mapped to the sample rate through
+    // the bilinear transform so that the filter works at any sample rate.
+    {
+      double gain = std::pow(10.0, 3.999843853973347 / 20.0);
+      double q = 0.7071752369554196;
+      double k = std::tan(Pi * 1681.974450955533 / static_cast<double>(sampleRate));
+      double bandGain = std::pow(gain, 0.4996667741545416);
+      double a0 = 1.0 + k / q + k * k;
+      this->filterCoefficients[0] = (gain + bandGain * k / q + k * k) / a0;
+      this->filterCoefficients[1] = 2.0 * (k * k - gain) / a0;
+      this->filterCoefficients[2] = (gain - bandGain * k / q + k * k) / a0;
+      this->filterCoefficients[3] = 2.0 * (k * k - 1.0) / a0;
+      this->filterCoefficients[4] = (1.0 - k / q + k * k) / a0;
+    }
+
+    // K-weighting stage 2: the RLB high-pass filter
+    {
+      double q = 0.5003270373238773;
+      double k = std::tan(Pi * 38.13547087602444 / static_cast<double>(sampleRate));
+      double a0 = 1.0 + k / q + k * k;
+      this->filterCoefficients[5] = 1.0;
+      this->filterCoefficients[6] = -2.0;
+      this->filterCoefficients[7] = 1.0;
+      this->filterCoefficients[8] = 2.0 * (k * k - 1.0) / a0;
+      this->filterCoefficients[9] = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Oversampling filter: a Hann windowed sinc with its cutoff at the original
+    // Nyquist frequency, split into 4 phases of 12 taps each. Each phase is normalized
+    // to unity gain so a full scale DC signal stays at exactly full scale.
+    {
+      const std::size_t totalTapCount = OversamplingTapCount * 4;
+      double taps[totalTapCount];
+      for(std::size_t index = 0; index < totalTapCount; ++index) {
+        double time = (static_cast<double>(index) - (totalTapCount - 1) / 2.0) / 4.0;
+        double sinc = std::sin(Pi * time) / (Pi * time);
+        double window = 0.5 - 0.5 * std::cos(
+          2.0 * Pi * (static_cast<double>(index) + 0.5) / static_cast<double>(totalTapCount)
+        );
+        taps[index] = sinc * window;
+      }
+      for(std::size_t phase = 0; phase < 4; ++phase) {
+        double sum = 0.0;
+        for(std::size_t tap = 0; tap < OversamplingTapCount; ++tap) {
+          sum += taps[phase + tap * 4];
+        }
+        for(std::size_t tap = 0; tap < OversamplingTapCount; ++tap) {
+          this->oversamplingCoefficients[tap * 4 + phase] = static_cast<float>(
+            taps[phase + tap * 4] / sum
+          );
+        }
+      }
+    }
+
+    this->filterStates.resize(this->paddedChannelCount * 4);
+    this->frame.resize(this->paddedChannelCount);
+    this->stepEnergies.resize(this->paddedChannelCount);
+    this->oversamplingHistory.resize(this->channelCount * OversamplingTapCount * 2);
+    this->truePeaks.resize(this->channelCount * 4);
+    Reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::Reset() {
+    std::fill(this->filterStates.begin(), this->filterStates.end(), 0.0);
+    std::fill(this->frame.begin(), this->frame.end(), 0.0);
+    std::fill(this->stepEnergies.begin(), this->stepEnergies.end(), 0.0);
+    this->stepFrameIndex = 0;
+
+    std::fill(std::begin(this->recentStepEnergies), std::end(this->recentStepEnergies), 0.0);
+    this->completedStepCount = 0;
+    this->gatedBlockPowers.clear();
+
+    std::fill(this->oversamplingHistory.begin(), this->oversamplingHistory.end(), 0.0f);
+    this->historyIndex = 0;
+    std::fill(this->truePeaks.begin(), this->truePeaks.end(), 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::ProcessInterleaved(const double *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::ProcessInterleaved(const std::int16_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0 / 32767.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::ProcessInterleaved(const std::int32_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0 / 2147483647.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetMomentaryLoudness() const {
+    if(this->completedStepCount < MomentaryStepCount) {
+      return -std::numeric_limits<double>::infinity();
+    } else {
+      return loudnessFromPower(getRecentPower(MomentaryStepCount));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetShortTermLoudness() const {
+    if(this->completedStepCount < ShortTermStepCount) {
+      return -std::numeric_limits<double>::infinity();
+    } else {
+      return loudnessFromPower(getRecentPower(ShortTermStepCount));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetIntegratedLoudness() const {
+    std::size_t blockCount = this->gatedBlockPowers.size();
+    if(blockCount == 0) {
+      return -std::numeric_limits<double>::infinity();
+    }
+
+    // The blocks stored already passed the absolute gate. Their mean determines
+    // the relative gate, which sits 10 LU below it.
+    double sum = 0.0;
+    for(std::size_t index = 0; index < blockCount; ++index) {
+      sum += this->gatedBlockPowers[index];
+    }
+    double relativeGatePower = sum / static_cast<double>(blockCount) * RelativeGateFactor;
+
+    sum = 0.0;
+    std::size_t includedBlockCount = 0;
+    for(std::size_t index = 0; index < blockCount; ++index) {
+      if(this->gatedBlockPowers[index] > relativeGatePower) {
+        sum += this->gatedBlockPowers[index];
+        ++includedBlockCount;
+      }
+    }
+    if(includedBlockCount == 0) {
+      return -std::numeric_limits<double>::infinity();
+    }
+
+    return loudnessFromPower(sum / static_cast<double>(includedBlockCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetTruePeak() const {
+    double peak = 0.0;
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      peak = std::max(peak, GetTruePeak(index));
+    }
+
+    return peak;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetTruePeak(std::size_t channelIndex) const {
+    assert((channelIndex < this->channelCount) && u8"Channel index must be valid");
+
+    const float *phasePeaks = this->truePeaks.data() + channelIndex * 4;
+    return std::max(
+      std::max(phasePeaks[0], phasePeaks[1]), std::max(phasePeaks[2], phasePeaks[3])
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::GetTruePeakDecibels() const {
+    double peak = GetTruePeak();
+    if(peak > 0.0) {
+      return DecibelConverter::FromLinearAmplitude(peak);
+    } else {
+      return -std::numeric_limits<double>::infinity();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void LoudnessMeter::processInterleaved(
+    const TSample *samples, std::size_t frameCount, double scale
+  ) {
+    double *frameSamples = this->frame.data();
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        frameSamples[index] = static_cast<double>(samples[index]) * scale;
+      }
+      samples += this->channelCount;
+
+      filterFrame();
+      detectTruePeaks();
+
+      ++this->stepFrameIndex;
+      if(this->stepFrameIndex == this->stepFrameCount) {
+        completeStep();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::filterFrame() {
+    const double *coefficients = this->filterCoefficients;
+
+    // Channels are filtered in pairs. The states of each pair are stored as four
+    // consecutive lane pairs: shelf s1, shelf s2, high-pass s1 and high-pass s2.
+    for(std::size_t index = 0; index < this->paddedChannelCount; index += 2) {
+      double *states = this->filterStates.data() + index * 4;
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+      __m128d input = _mm_loadu_pd(this->frame.data() + index);
+
+      __m128d shelfState1 = _mm_loadu_pd(states);
+      __m128d shelfState2 = _mm_loadu_pd(states + 2);
+      __m128d shelved = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(coefficients[0]), input), shelfState1);
+      _mm_storeu_pd(
+        states,
+        _mm_sub_pd(
+          _mm_add_pd(_mm_mul_pd(_mm_set1_pd(coefficients[1]), input), shelfState2),
+          _mm_mul_pd(_mm_set1_pd(coefficients[3]), shelved)
+        )
+      );
+      _mm_storeu_pd(
+        states + 2,
+        _mm_sub_pd(
+          _mm_mul_pd(_mm_set1_pd(coefficients[2]), input),
+          _mm_mul_pd(_mm_set1_pd(coefficients[4]), shelved)
+        )
+      );
+
+      __m128d passState1 = _mm_loadu_pd(states + 4);
+      __m128d passState2 = _mm_loadu_pd(states + 6);
+      __m128d weighted = _mm_add_pd(shelved, passState1); // b0 is 1.0
+      _mm_storeu_pd(
+        states + 4,
+        _mm_sub_pd(
+          _mm_sub_pd(passState2, _mm_add_pd(shelved, shelved)), // b1 is -2.0
+          _mm_mul_pd(_mm_set1_pd(coefficients[8]), weighted)
+        )
+      );
+      _mm_storeu_pd(
+        states + 6,
+        _mm_sub_pd(shelved, _mm_mul_pd(_mm_set1_pd(coefficients[9]), weighted)) // b2 is 1.0
+      );
+
+      double *energies = this->stepEnergies.data() + index;
+      _mm_storeu_pd(
+        energies, _mm_add_pd(_mm_loadu_pd(energies), _mm_mul_pd(weighted, weighted))
+      );
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+      float64x2_t input = vld1q_f64(this->frame.data() + index);
+
+      float64x2_t shelfState1 = vld1q_f64(states);
+      float64x2_t shelfState2 = vld1q_f64(states + 2);
+      float64x2_t shelved = vfmaq_n_f64(shelfState1, input, coefficients[0]);
+      vst1q_f64(
+        states,
+        vfmsq_n_f64(vfmaq_n_f64(shelfState2, input, coefficients[1]), shelved, coefficients[3])
+      );
+      vst1q_f64(
+        states + 2,
+        vfmsq_n_f64(vmulq_n_f64(input, coefficients[2]), shelved, coefficients[4])
+      );
+
+      float64x2_t passState1 = vld1q_f64(states + 4);
+      float64x2_t passState2 = vld1q_f64(states + 6);
+      float64x2_t weighted = vaddq_f64(shelved, passState1); // b0 is 1.0
+      vst1q_f64(
+        states + 4,
+        vfmsq_n_f64(
+          vsubq_f64(passState2, vaddq_f64(shelved, shelved)), // b1 is -2.0
+          weighted, coefficients[8]
+        )
+      );
+      vst1q_f64(states + 6, vfmsq_n_f64(shelved, weighted, coefficients[9])); // b2 is 1.0
+
+      double *energies = this->stepEnergies.data() + index;
+      vst1q_f64(energies, vfmaq_f64(vld1q_f64(energies), weighted, weighted));
+#else
+      for(std::size_t lane = 0; lane < 2; ++lane) {
+        double input = this->frame[index + lane];
+
+        double shelved = coefficients[0] * input + states[lane];
+        states[lane] = coefficients[1] * input + states[2 + lane] - coefficients[3] * shelved;
+        states[2 + lane] = coefficients[2] * input - coefficients[4] * shelved;
+
+        double weighted = shelved + states[4 + lane];
+        states[4 + lane] = states[6 + lane] - 2.0 * shelved - coefficients[8] * weighted;
+        states[6 + lane] = shelved - coefficients[9] * weighted;
+
+        this->stepEnergies[index + lane] += weighted * weighted;
+      }
+#endif
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::detectTruePeaks() {
+
+    // The history holds each sample twice, 12 samples apart, so the 12 most recent
+    // samples can always be read in one go, newest first, starting at the history index
+    this->historyIndex = (
+      (this->historyIndex == 0) ? (OversamplingTapCount - 1) : (this->historyIndex - 1)
+    );
+
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      float *history = this->oversamplingHistory.data() + index * OversamplingTapCount * 2;
+      float sample = static_cast<float>(this->frame[index]);
+      history[this->historyIndex] = sample;
+      history[this->historyIndex + OversamplingTapCount] = sample;
+
+      const float *recent = history + this->historyIndex;
+      const float *coefficients = this->oversamplingCoefficients;
+      float *phasePeaks = this->truePeaks.data() + index * 4;
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+      __m128 phases = _mm_setzero_ps();
+      for(std::size_t tap = 0; tap < OversamplingTapCount; ++tap) {
+        phases = _mm_add_ps(
+          phases,
+          _mm_mul_ps(_mm_set1_ps(recent[tap]), _mm_loadu_ps(coefficients + tap * 4))
+        );
+      }
+      phases = _mm_andnot_ps(_mm_set1_ps(-0.0f), phases);
+      _mm_storeu_ps(phasePeaks, _mm_max_ps(_mm_loadu_ps(phasePeaks), phases));
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+      float32x4_t phases = vdupq_n_f32(0.0f);
+      for(std::size_t tap = 0; tap < OversamplingTapCount; ++tap) {
+        phases = vfmaq_n_f32(phases, vld1q_f32(coefficients + tap * 4), recent[tap]);
+      }
+      vst1q_f32(phasePeaks, vmaxq_f32(vld1q_f32(phasePeaks), vabsq_f32(phases)));
+#else
+      for(std::size_t phase = 0; phase < 4; ++phase) {
+        float value = 0.0f;
+        for(std::size_t tap = 0; tap < OversamplingTapCount; ++tap) {
+          value += recent[tap] * coefficients[tap * 4 + phase];
+        }
+        phasePeaks[phase] = std::max(phasePeaks[phase], std::abs(value));
+      }
+#endif
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessMeter::completeStep() {
+    double energy = 0.0;
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      energy += this->channelWeights[index] * this->stepEnergies[index];
+    }
+    std::fill(this->stepEnergies.begin(), this->stepEnergies.end(), 0.0);
+    this->stepFrameIndex = 0;
+
+    this->recentStepEnergies[this->completedStepCount % ShortTermStepCount] = energy;
+    ++this->completedStepCount;
+
+    // Gating blocks are 400 ms long and overlap by 75%, so each completed step
+    // also completes a gating block, as soon as there are enough steps for one
+    if(this->completedStepCount >= MomentaryStepCount) {
+      double power = getRecentPower(MomentaryStepCount);
+      if(power > AbsoluteGatePower) {
+        this->gatedBlockPowers.push_back(power);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double LoudnessMeter::getRecentPower(std::size_t stepCount) const {
+    double energy = 0.0;
+    for(std::size_t index = 1; index <= stepCount; ++index) {
+      energy += this->recentStepEnergies[
+        (this->completedStepCount - index) % ShortTermStepCount
+      ];
+    }
+
+    return energy / static_cast<double>(stepCount * this->stepFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
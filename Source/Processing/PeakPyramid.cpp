@@ -0,0 +1,636 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/PeakPyramid.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include "../Storage/EndianReader.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cmath> // for std::sqrt(), std::lround()
+#include <cstring> // for std::memcmp()
+#include <exception> // for std::exception_ptr
+#include <limits> // for std::numeric_limits
+#include <memory> // for std::shared_ptr
+#include <stdexcept> // for std::invalid_argument, std::logic_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames that are decoded at once while building a pyramid</summary>
+  const std::size_t DecodeChunkFrameCount = 65536;
+
+  /// <summary>Identifies serialized peak pyramids</summary>
+  const char SerializedPyramidMagic[4] = { 'P', 'e', 'a', 'k' };
+
+  /// <summary>Version of the serialized pyramid format</summary>
+  const std::uint32_t SerializedPyramidVersion = 1;
+
+  /// <summary>Size of the serialized pyramid's header, up to the first level's size</summary>
+  const std::size_t SerializedHeaderSize = 4 + 4 + 4 + 8 + 4;
+
+  /// <summary>Size of a single serialized bucket</summary>
+  const std::size_t SerializedBucketSize = 2 + 2 + 2;
+
+  /// <summary>Factor by which levels are scaled to 16-bit fixed point</summary>
+  const float FixedPointScale = 32767.0f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer to a buffer in little endian format</summary>
+  /// <typeparam name="TInteger">Type of integer that will be appended</typeparam>
+  /// <param name="buffer">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  template<typename TInteger>
+  void appendLittleEndian(std::vector<std::byte> &buffer, TInteger value) {
+    for(std::size_t index = 0; index < sizeof(TInteger); ++index) {
+      buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a level to 16-bit fixed point, clamping it to full scale</summary>
+  /// <param name="level">Level that will be converted</param>
+  /// <returns>The level as a 16-bit fixed point value</returns>
+  std::uint16_t toFixedPoint(float level) {
+    level = std::max(-1.0f, std::min(level, 1.0f));
+    return static_cast<std::uint16_t>(
+      static_cast<std::int16_t>(std::lround(level * FixedPointScale))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a 16-bit fixed point value back into a level</summary>
+  /// <param name="value">Value that will be converted</param>
+  /// <returns>The level the value represents</returns>
+  float fromFixedPoint(std::uint16_t value) {
+    return static_cast<float>(static_cast<std::int16_t>(value)) / FixedPointScale;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the extremes and the square sum of a run of samples</summary>
+  /// <param name="samples">Samples that will be scanned</param>
+  /// <param name="count">Number of samples to scan</param>
+  /// <param name="minimum">Lowest sample seen so far, updated by the call</param>
+  /// <param name="maximum">Highest sample seen so far, updated by the call</param>
+  /// <param name="squareSum">Sum of all squared samples, updated by the call</param>
+  void reduceSamples(
+    const float *samples, std::size_t count, double &minimum, double &maximum, double &squareSum
+  ) {
+    float lowest = static_cast<float>(minimum);
+    float highest = static_cast<float>(maximum);
+    float squares = 0.0f;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    if(count >= 4) {
+      __m128 lowestVector = _mm_set1_ps(lowest);
+      __m128 highestVector = _mm_set1_ps(highest);
+      __m128 squaresVector = _mm_setzero_ps();
+      while(count >= 4) {
+        __m128 values = _mm_loadu_ps(samples);
+        lowestVector = _mm_min_ps(lowestVector, values);
+        highestVector = _mm_max_ps(highestVector, values);
+        squaresVector = _mm_add_ps(squaresVector, _mm_mul_ps(values, values));
+        samples += 4;
+        count -= 4;
+      }
+
+      float lanes[4];
+      _mm_storeu_ps(lanes, lowestVector);
+      lowest = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+      _mm_storeu_ps(lanes, highestVector);
+      highest = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+      _mm_storeu_ps(lanes, squaresVector);
+      squares = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    if(count >= 4) {
+      float32x4_t lowestVector = vdupq_n_f32(lowest);
+      float32x4_t highestVector = vdupq_n_f32(highest);
+      float32x4_t squaresVector = vdupq_n_f32(0.0f);
+      while(count >= 4) {
+        float32x4_t values = vld1q_f32(samples);
+        lowestVector = vminq_f32(lowestVector, values);
+        highestVector = vmaxq_f32(highestVector, values);
+        squaresVector = vfmaq_f32(squaresVector, values, values);
+        samples += 4;
+        count -= 4;
+      }
+
+      lowest = vminvq_f32(lowestVector);
+      highest = vmaxvq_f32(highestVector);
+      squares = vaddvq_f32(squaresVector);
+    }
+#endif
+
+    for(std::size_t index = 0; index < count; ++index) {
+      lowest = std::min(lowest, samples[index]);
+      highest = std::max(highest, samples[index]);
+      squares += samples[index] * samples[index];
+    }
+
+    minimum = lowest;
+    maximum = highest;
+    squareSum += squares;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the specified bucket sizes can form a pyramid</summary>
+  /// <param name="bucketFrameCounts">Bucket sizes of each level, finest first</param>
+  /// <returns>True if the bucket sizes are usable</returns>
+  bool areValidBucketSizes(const std::vector<std::size_t> &bucketFrameCounts) {
+    if(bucketFrameCounts.empty() || (bucketFrameCounts[0] == 0)) {
+      return false;
+    }
+
+    for(std::size_t index = 1; index < bucketFrameCounts.size(); ++index) {
+      if(bucketFrameCounts[index] <= bucketFrameCounts[index - 1]) {
+        return false;
+      }
+      if((bucketFrameCounts[index] % bucketFrameCounts[0]) != 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakPyramid PeakPyramid::Build(
+    const Storage::AudioTrackDecoder &decoder,
+    const std::vector<std::size_t> &bucketFrameCounts /* = { 256, 4096, 65536 } */
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    PeakPyramid pyramid(channelCount, bucketFrameCounts);
+
+    std::vector<float> scratch(channelCount * DecodeChunkFrameCount);
+    std::vector<float *> buffers(channelCount);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      buffers[channelIndex] = scratch.data() + (channelIndex * DecodeChunkFrameCount);
+    }
+
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    for(std::uint64_t startFrame = 0; startFrame < totalFrameCount;) {
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(DecodeChunkFrameCount, totalFrameCount - startFrame)
+      );
+      decoder.DecodeSeparated<float>(buffers.data(), startFrame, chunkFrameCount);
+      pyramid.ProcessSeparated(buffers.data(), chunkFrameCount);
+
+      startFrame += chunkFrameCount;
+    }
+
+    pyramid.Finish();
+    return pyramid;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<PeakPyramid> PeakPyramid::BuildAsync(
+    const Storage::AudioTrackDecoder &decoder,
+    const std::vector<std::size_t> &bucketFrameCounts /* = { 256, 4096, 65536 } */
+  ) {
+    std::shared_ptr<std::promise<PeakPyramid>> promise = (
+      std::make_shared<std::promise<PeakPyramid>>()
+    );
+    std::future<PeakPyramid> future = promise->get_future();
+
+    Executor::GetInstalled()->Submit(
+      [clone = decoder.Clone(), bucketFrameCounts, promise]() {
+        try {
+          promise->set_value(Build(*clone, bucketFrameCounts));
+        }
+        catch(...) {
+          promise->set_exception(std::current_exception());
+        }
+      },
+      TaskPriority::Low
+    );
+
+    return future;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakPyramid PeakPyramid::Skim(
+    const Storage::AudioTrackDecoder &decoder,
+    std::size_t blockStride /* = 16 */,
+    const std::vector<std::size_t> &bucketFrameCounts /* = { 256, 4096, 65536 } */
+  ) {
+    if(unlikely(blockStride == 0)) {
+      throw std::invalid_argument(u8"Block stride must be at least 1");
+    }
+
+    std::size_t channelCount = decoder.CountChannels();
+    PeakPyramid pyramid(channelCount, bucketFrameCounts);
+    pyramid.approximate = true;
+
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    if(totalFrameCount == 0) {
+      pyramid.Finish();
+      return pyramid;
+    }
+
+    // Groups are laid out using the size of the first block. For formats with variable
+    // block sizes, the block decoded for a group is the one its first frame falls into.
+    std::uint64_t groupFrameCount = (
+      static_cast<std::uint64_t>(decoder.GetBlockSize(0)) * blockStride
+    );
+    std::size_t groupCount = static_cast<std::size_t>(
+      (totalFrameCount + groupFrameCount - 1) / groupFrameCount
+    );
+    std::vector<PeakBucket> groupLevels(groupCount * channelCount);
+
+    // Each slice covers a contiguous run of groups so its decoder only seeks forward.
+    // The first slice uses the caller's decoder, which is idle during ParallelFor().
+    std::shared_ptr<Executor> executor = Executor::GetInstalled();
+    std::size_t sliceCount = std::min(groupCount, executor->CountWorkers() + 1);
+    std::vector<std::exception_ptr> errors(sliceCount);
+    auto skimSlice = [&](std::size_t sliceIndex) {
+      try {
+        std::shared_ptr<Storage::AudioTrackDecoder> clone;
+        const Storage::AudioTrackDecoder *sliceDecoder = &decoder;
+        if(sliceIndex > 0) {
+          clone = decoder.Clone();
+          sliceDecoder = clone.get();
+        }
+
+        std::vector<float> scratch;
+        std::vector<float *> buffers(channelCount);
+
+        std::size_t endGroupIndex = (sliceIndex + 1) * groupCount / sliceCount;
+        for(
+          std::size_t groupIndex = sliceIndex * groupCount / sliceCount;
+          groupIndex < endGroupIndex;
+          ++groupIndex
+        ) {
+          std::uint64_t groupStart = groupIndex * groupFrameCount;
+          std::uint64_t blockStart = sliceDecoder->GetBlockStart(groupStart);
+          std::size_t blockSize = sliceDecoder->GetBlockSize(groupStart);
+
+          scratch.resize(blockSize * channelCount);
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            buffers[channelIndex] = scratch.data() + (channelIndex * blockSize);
+          }
+          sliceDecoder->DecodeSeparated<float>(buffers.data(), blockStart, blockSize);
+
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            double minimum = std::numeric_limits<float>::max();
+            double maximum = std::numeric_limits<float>::lowest();
+            double squareSum = 0.0;
+            reduceSamples(buffers[channelIndex], blockSize, minimum, maximum, squareSum);
+
+            PeakBucket &bucket = groupLevels[groupIndex * channelCount + channelIndex];
+            bucket.Minimum = static_cast<float>(minimum);
+            bucket.Maximum = static_cast<float>(maximum);
+            bucket.Rms = static_cast<float>(
+              std::sqrt(squareSum / static_cast<double>(blockSize))
+            );
+          }
+        }
+      }
+      catch(...) {
+        errors[sliceIndex] = std::current_exception();
+      }
+    };
+    executor->ParallelFor(sliceCount, skimSlice);
+
+    for(std::size_t sliceIndex = 0; sliceIndex < sliceCount; ++sliceIndex) {
+      if(errors[sliceIndex]) {
+        std::rethrow_exception(errors[sliceIndex]);
+      }
+    }
+
+    // Fill the finest level from the groups, Finish() aggregates the coarser ones
+    std::size_t baseFrameCount = bucketFrameCounts[0];
+    std::size_t baseBucketCount = static_cast<std::size_t>(
+      (totalFrameCount + baseFrameCount - 1) / baseFrameCount
+    );
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      std::vector<PeakBucket> &buckets = pyramid.levels[channelIndex];
+      buckets.resize(baseBucketCount);
+      for(std::size_t bucketIndex = 0; bucketIndex < baseBucketCount; ++bucketIndex) {
+        std::size_t groupIndex = static_cast<std::size_t>(
+          static_cast<std::uint64_t>(bucketIndex) * baseFrameCount / groupFrameCount
+        );
+        buckets[bucketIndex] = groupLevels[groupIndex * channelCount + channelIndex];
+      }
+    }
+
+    pyramid.frameCount = totalFrameCount;
+    pyramid.Finish();
+    return pyramid;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakPyramid PeakPyramid::Deserialize(const std::vector<std::byte> &serializedPyramid) {
+    const std::byte *data = serializedPyramid.data();
+    if(serializedPyramid.size() < SerializedHeaderSize) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid is truncated");
+    }
+    if(std::memcmp(data, SerializedPyramidMagic, sizeof(SerializedPyramidMagic)) != 0) {
+      throw Errors::CorruptedFileError(u8"Data is not a serialized peak pyramid");
+    }
+    if(Storage::LittleEndianReader::ReadUInt32(data + 4) != SerializedPyramidVersion) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid has unsupported version");
+    }
+
+    std::size_t channelCount = Storage::LittleEndianReader::ReadUInt32(data + 8);
+    std::uint64_t frameCount = Storage::LittleEndianReader::ReadUInt64(data + 12);
+    std::size_t levelCount = Storage::LittleEndianReader::ReadUInt32(data + 20);
+    if((channelCount == 0) || (levelCount == 0)) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid has no channels or levels");
+    }
+
+    std::size_t remainingByteCount = serializedPyramid.size() - SerializedHeaderSize;
+    if(remainingByteCount / 8 < levelCount) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid is truncated");
+    }
+
+    std::vector<std::size_t> bucketFrameCounts(levelCount);
+    std::uint64_t bucketCount = 0;
+    const std::byte *levelData = data + SerializedHeaderSize;
+    for(std::size_t levelIndex = 0; levelIndex < levelCount; ++levelIndex) {
+      std::uint64_t levelFrameCount = Storage::LittleEndianReader::ReadUInt64(levelData);
+      if((levelFrameCount == 0) || (levelFrameCount > std::numeric_limits<std::uint32_t>::max())) {
+        throw Errors::CorruptedFileError(u8"Serialized peak pyramid has invalid bucket size");
+      }
+
+      bucketFrameCounts[levelIndex] = static_cast<std::size_t>(levelFrameCount);
+      bucketCount += (frameCount + levelFrameCount - 1) / levelFrameCount;
+      levelData += 8;
+    }
+    if(!areValidBucketSizes(bucketFrameCounts)) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid has invalid bucket sizes");
+    }
+
+    remainingByteCount -= levelCount * 8;
+    if(bucketCount * channelCount != remainingByteCount / SerializedBucketSize) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid has wrong length");
+    }
+    if((remainingByteCount % SerializedBucketSize) != 0) {
+      throw Errors::CorruptedFileError(u8"Serialized peak pyramid has wrong length");
+    }
+
+    PeakPyramid pyramid(channelCount, bucketFrameCounts);
+    pyramid.frameCount = frameCount;
+    pyramid.finished = true;
+
+    for(std::size_t levelIndex = 0; levelIndex < levelCount; ++levelIndex) {
+      std::size_t levelBucketCount = static_cast<std::size_t>(
+        (frameCount + bucketFrameCounts[levelIndex] - 1) / bucketFrameCounts[levelIndex]
+      );
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        std::vector<PeakBucket> &buckets = pyramid.levels[levelIndex * channelCount + channelIndex];
+        buckets.resize(levelBucketCount);
+        for(std::size_t bucketIndex = 0; bucketIndex < levelBucketCount; ++bucketIndex) {
+          PeakBucket &bucket = buckets[bucketIndex];
+          bucket.Minimum = fromFixedPoint(Storage::LittleEndianReader::ReadUInt16(levelData));
+          bucket.Maximum = fromFixedPoint(Storage::LittleEndianReader::ReadUInt16(levelData + 2));
+          bucket.Rms = fromFixedPoint(Storage::LittleEndianReader::ReadUInt16(levelData + 4));
+          levelData += SerializedBucketSize;
+        }
+      }
+    }
+
+    return pyramid;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakPyramid::PeakPyramid(
+    std::size_t channelCount,
+    const std::vector<std::size_t> &bucketFrameCounts /* = { 256, 4096, 65536 } */
+  ) :
+    channelCount(channelCount),
+    frameCount(0),
+    bucketFrameCounts(bucketFrameCounts),
+    levels(),
+    openBucket(),
+    openFrameCount(0),
+    finished(false),
+    approximate(false) {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Peak pyramid needs to cover at least one channel");
+    }
+    if(unlikely(!areValidBucketSizes(bucketFrameCounts))) {
+      throw std::invalid_argument(
+        u8"Bucket sizes must be ascending multiples of the finest bucket size"
+      );
+    }
+
+    this->levels.resize(bucketFrameCounts.size() * channelCount);
+    this->openBucket.resize(channelCount * 3);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      this->openBucket[channelIndex * 3] = std::numeric_limits<float>::max();
+      this->openBucket[channelIndex * 3 + 1] = std::numeric_limits<float>::lowest();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PeakPyramid::CountBuckets(std::size_t levelIndex) const {
+    return this->levels[levelIndex * this->channelCount].size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PeakPyramid::SelectLevel(std::size_t framesPerPixel) const {
+    std::size_t levelIndex = 0;
+    while(levelIndex + 1 < this->bucketFrameCounts.size()) {
+      if(this->bucketFrameCounts[levelIndex + 1] > framesPerPixel) {
+        break;
+      }
+      ++levelIndex;
+    }
+
+    return levelIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PeakPyramid::ProcessSeparated(const float *const channels[], std::size_t frameCount) {
+    if(unlikely(this->finished)) {
+      throw std::logic_error(u8"Peak pyramid has already been finished");
+    }
+
+    std::size_t bucketFrameCount = this->bucketFrameCounts[0];
+
+    std::size_t offset = 0;
+    while(offset < frameCount) {
+      std::size_t runFrameCount = std::min(
+        frameCount - offset, bucketFrameCount - this->openFrameCount
+      );
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        double *sums = this->openBucket.data() + (channelIndex * 3);
+        reduceSamples(channels[channelIndex] + offset, runFrameCount, sums[0], sums[1], sums[2]);
+      }
+
+      offset += runFrameCount;
+      this->openFrameCount += runFrameCount;
+      if(this->openFrameCount == bucketFrameCount) {
+        closeBucket();
+      }
+    }
+
+    this->frameCount += frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PeakPyramid::Finish() {
+    if(unlikely(this->finished)) {
+      throw std::logic_error(u8"Peak pyramid has already been finished");
+    }
+    if(this->openFrameCount > 0) {
+      closeBucket();
+    }
+    this->finished = true;
+
+    // Aggregate the coarser levels from the finest one. All of its buckets are
+    // full except for the last one, which needs to be weighted accordingly for RMS.
+    std::size_t baseFrameCount = this->bucketFrameCounts[0];
+    std::size_t baseBucketCount = CountBuckets(0);
+    std::size_t lastFrameCount = static_cast<std::size_t>(
+      this->frameCount - (static_cast<std::uint64_t>(baseBucketCount) - 1) * baseFrameCount
+    );
+
+    for(std::size_t levelIndex = 1; levelIndex < this->bucketFrameCounts.size(); ++levelIndex) {
+      std::size_t groupSize = this->bucketFrameCounts[levelIndex] / baseFrameCount;
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        const std::vector<PeakBucket> &base = this->levels[channelIndex];
+        std::vector<PeakBucket> &target = this->levels[
+          levelIndex * this->channelCount + channelIndex
+        ];
+        target.reserve((baseBucketCount + groupSize - 1) / groupSize);
+
+        for(std::size_t start = 0; start < baseBucketCount; start += groupSize) {
+          std::size_t end = std::min(start + groupSize, baseBucketCount);
+
+          PeakBucket bucket = base[start];
+          double squareSum = 0.0;
+          std::size_t groupFrameCount = 0;
+          for(std::size_t index = start; index < end; ++index) {
+            bucket.Minimum = std::min(bucket.Minimum, base[index].Minimum);
+            bucket.Maximum = std::max(bucket.Maximum, base[index].Maximum);
+
+            std::size_t bucketFrameCount = (
+              (index + 1 == baseBucketCount) ? lastFrameCount : baseFrameCount
+            );
+            double rms = base[index].Rms;
+            squareSum += rms * rms * static_cast<double>(bucketFrameCount);
+            groupFrameCount += bucketFrameCount;
+          }
+          bucket.Rms = static_cast<float>(
+            std::sqrt(squareSum / static_cast<double>(groupFrameCount))
+          );
+
+          target.push_back(bucket);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> PeakPyramid::Serialize() const {
+    if(unlikely(!this->finished)) {
+      throw std::logic_error(u8"Peak pyramid must be finished before it can be serialized");
+    }
+
+    std::size_t bucketCount = 0;
+    for(const std::vector<PeakBucket> &buckets : this->levels) {
+      bucketCount += buckets.size();
+    }
+
+    std::vector<std::byte> serializedPyramid;
+    serializedPyramid.reserve(
+      SerializedHeaderSize + this->bucketFrameCounts.size() * 8 +
+      bucketCount * SerializedBucketSize
+    );
+
+    for(std::size_t index = 0; index < sizeof(SerializedPyramidMagic); ++index) {
+      serializedPyramid.push_back(static_cast<std::byte>(SerializedPyramidMagic[index]));
+    }
+    appendLittleEndian(serializedPyramid, SerializedPyramidVersion);
+    appendLittleEndian(serializedPyramid, static_cast<std::uint32_t>(this->channelCount));
+    appendLittleEndian(serializedPyramid, this->frameCount);
+    appendLittleEndian(
+      serializedPyramid, static_cast<std::uint32_t>(this->bucketFrameCounts.size())
+    );
+    for(std::size_t bucketFrameCount : this->bucketFrameCounts) {
+      appendLittleEndian(serializedPyramid, static_cast<std::uint64_t>(bucketFrameCount));
+    }
+
+    for(const std::vector<PeakBucket> &buckets : this->levels) {
+      for(const PeakBucket &bucket : buckets) {
+        appendLittleEndian(serializedPyramid, toFixedPoint(bucket.Minimum));
+        appendLittleEndian(serializedPyramid, toFixedPoint(bucket.Maximum));
+        appendLittleEndian(serializedPyramid, toFixedPoint(bucket.Rms));
+      }
+    }
+
+    return serializedPyramid;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PeakPyramid::closeBucket() {
+    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+      double *sums = this->openBucket.data() + (channelIndex * 3);
+
+      PeakBucket bucket;
+      bucket.Minimum = static_cast<float>(sums[0]);
+      bucket.Maximum = static_cast<float>(sums[1]);
+      bucket.Rms = static_cast<float>(
+        std::sqrt(sums[2] / static_cast<double>(this->openFrameCount))
+      );
+      this->levels[channelIndex].push_back(bucket);
+
+      sums[0] = std::numeric_limits<float>::max();
+      sums[1] = std::numeric_limits<float>::lowest();
+      sums[2] = 0.0;
+    }
+
+    this->openFrameCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,204 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Resampler.h"
+
+#include "../Storage/Shared/PolyphaseFilter.h" // for PolyphaseFilter
+
+#include <algorithm> // for std::copy_n(), std::fill_n(), std::min()
+#include <numeric> // for std::gcd()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of input frames that are taken into the history at once</summary>
+  /// <remarks>
+  ///   Longer streams are processed piecewise so the history stays small enough
+  ///   to remain in the CPU cache together with the filter bank.
+  /// </remarks>
+  const std::size_t ChunkFrameCount = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Resampler::Resampler(
+    std::size_t inputSampleRate, std::size_t outputSampleRate,
+    std::size_t channelCount /* = 1 */,
+    ResamplerQuality quality /* = ResamplerQuality::Balanced */
+  ) :
+    filter(),
+    channelCount(channelCount),
+    upFactor(0),
+    downFactor(0),
+    history(),
+    historyCapacity(0),
+    historyLength(0),
+    cursor(0),
+    phase(0) {
+
+    if(unlikely((inputSampleRate == 0) || (outputSampleRate == 0))) {
+      throw std::invalid_argument(u8"Sample rates must not be zero");
+    }
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Resampler needs to process at least one channel");
+    }
+
+    std::size_t divisor = std::gcd(inputSampleRate, outputSampleRate);
+    this->upFactor = outputSampleRate / divisor;
+    this->downFactor = inputSampleRate / divisor;
+    this->filter = Storage::Shared::PolyphaseFilter::GetShared(
+      this->upFactor, this->downFactor, quality
+    );
+
+    // Between chunks, the history holds less than one filter length. Each chunk is
+    // appended behind it, so this is enough room for the history plus a full chunk.
+    this->historyCapacity = this->filter->CountTaps() + ChunkFrameCount;
+    this->history.resize(this->historyCapacity * channelCount);
+
+    Reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Resampler::~Resampler() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Resampler::CountLookaheadFrames() const {
+    return this->filter->CountTaps() - this->filter->GetLeadingTapCount();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Resampler::CountMaximumOutputFrames(std::size_t inputFrameCount) const {
+    return (inputFrameCount * this->upFactor + this->downFactor - 1) / this->downFactor + 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Resampler::Reset() {
+
+    // The first output frame lands on the first input frame, so the taps reaching
+    // into the past need silence in front of the stream to work on
+    this->historyLength = this->filter->GetLeadingTapCount() - 1;
+    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+      std::fill_n(
+        this->history.data() + (channelIndex * this->historyCapacity),
+        this->historyLength,
+        0.0f
+      );
+    }
+
+    this->cursor = 0;
+    this->phase = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Resampler::Process(
+    const float *const inputs[], std::size_t inputFrameCount, float *const outputs[]
+  ) {
+    std::size_t consumedFrameCount = 0;
+    std::size_t producedFrameCount = 0;
+
+    while(consumedFrameCount < inputFrameCount) {
+      std::size_t chunkFrameCount = std::min(
+        inputFrameCount - consumedFrameCount, this->historyCapacity - this->historyLength
+      );
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        std::copy_n(
+          inputs[channelIndex] + consumedFrameCount,
+          chunkFrameCount,
+          this->history.data() + (channelIndex * this->historyCapacity + this->historyLength)
+        );
+      }
+      this->historyLength += chunkFrameCount;
+      consumedFrameCount += chunkFrameCount;
+
+      producedFrameCount += filterHistory(outputs, producedFrameCount);
+
+      // Drop the samples no upcoming output frame reaches back to. When the sample rate
+      // is lowered a lot, the cursor can even point beyond the history's end, in which
+      // case the gap is skipped as soon as the next samples come in.
+      std::size_t discardedFrameCount = std::min(this->cursor, this->historyLength);
+      std::size_t keptFrameCount = this->historyLength - discardedFrameCount;
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        float *channelHistory = this->history.data() + (channelIndex * this->historyCapacity);
+        std::copy_n(channelHistory + discardedFrameCount, keptFrameCount, channelHistory);
+      }
+      this->historyLength = keptFrameCount;
+      this->cursor -= discardedFrameCount;
+    }
+
+    return producedFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Resampler::filterHistory(float *const outputs[], std::size_t outputOffset) {
+    std::size_t tapCount = this->filter->CountTaps();
+    std::size_t inputStep = this->downFactor / this->upFactor;
+    std::size_t phaseStep = this->downFactor % this->upFactor;
+
+    // All channels advance in lockstep, so the same walk is repeated for each of them
+    std::size_t frameCount = 0;
+    std::size_t endCursor = this->cursor;
+    std::size_t endPhase = this->phase;
+    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+      const float *channelHistory = this->history.data() + (channelIndex * this->historyCapacity);
+      float *output = outputs[channelIndex] + outputOffset;
+
+      std::size_t index = this->cursor;
+      std::size_t currentPhase = this->phase;
+      frameCount = 0;
+      while(index + tapCount <= this->historyLength) {
+        output[frameCount] = this->filter->Apply(channelHistory + index, currentPhase);
+        ++frameCount;
+
+        index += inputStep;
+        currentPhase += phaseStep;
+        if(currentPhase >= this->upFactor) {
+          currentPhase -= this->upFactor;
+          ++index;
+        }
+      }
+
+      endCursor = index;
+      endPhase = currentPhase;
+    }
+
+    this->cursor = endCursor;
+    this->phase = endPhase;
+
+    return frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
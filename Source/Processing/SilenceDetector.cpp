@@ -0,0 +1,378 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/SilenceDetector.h"
+#include "Nuclex/Audio/Processing/DecibelConverter.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cmath> // for std::abs()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded at once when scanning a whole audio track</summary>
+  const std::size_t DecodingBlockFrameCount = 65536;
+
+  /// <summary>Number of frames decoded at once when searching for audio to trim</summary>
+  /// <remarks>
+  ///   Silence at the ends of voice clips is usually well under a second long, so this
+  ///   is kept small to avoid decoding much more than the silence itself.
+  /// </remarks>
+  const std::size_t TrimmingBlockFrameCount = 8192;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the highest magnitude in a run of samples</summary>
+  /// <param name="samples">Samples that will be scanned</param>
+  /// <param name="count">Number of samples to scan</param>
+  /// <returns>The highest absolute value among the samples</returns>
+  float findPeak(const float *samples, std::size_t count) {
+    float peak = 0.0f;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    if(count >= 4) {
+      const __m128 signMask = _mm_set1_ps(-0.0f);
+      __m128 peakVector = _mm_setzero_ps();
+      while(count >= 4) {
+        peakVector = _mm_max_ps(peakVector, _mm_andnot_ps(signMask, _mm_loadu_ps(samples)));
+        samples += 4;
+        count -= 4;
+      }
+
+      float lanes[4];
+      _mm_storeu_ps(lanes, peakVector);
+      peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    if(count >= 4) {
+      float32x4_t peakVector = vdupq_n_f32(0.0f);
+      while(count >= 4) {
+        peakVector = vmaxq_f32(peakVector, vabsq_f32(vld1q_f32(samples)));
+        samples += 4;
+        count -= 4;
+      }
+
+      peak = vmaxvq_f32(peakVector);
+    }
+#endif
+
+    for(std::size_t index = 0; index < count; ++index) {
+      peak = std::max(peak, std::abs(samples[index]));
+    }
+
+    return peak;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the first sample whose magnitude exceeds a threshold</summary>
+  /// <param name="samples">Samples that will be searched</param>
+  /// <param name="count">Number of samples to search</param>
+  /// <param name="threshold">Magnitude the sample needs to exceed</param>
+  /// <returns>The index of the first such sample or the sample count if there is none</returns>
+  std::size_t findFirstAbove(const float *samples, std::size_t count, float threshold) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 thresholdVector = _mm_set1_ps(threshold);
+    for(; index + 4 <= count; index += 4) {
+      __m128 magnitudes = _mm_andnot_ps(signMask, _mm_loadu_ps(samples + index));
+      if(_mm_movemask_ps(_mm_cmpgt_ps(magnitudes, thresholdVector)) != 0) {
+        break; // The scalar loop below finds the exact sample within the group
+      }
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const float32x4_t thresholdVector = vdupq_n_f32(threshold);
+    for(; index + 4 <= count; index += 4) {
+      uint32x4_t above = vcagtq_f32(vld1q_f32(samples + index), thresholdVector);
+      if(vmaxvq_u32(above) != 0) {
+        break; // The scalar loop below finds the exact sample within the group
+      }
+    }
+#endif
+
+    for(; index < count; ++index) {
+      if(std::abs(samples[index]) > threshold) {
+        return index;
+      }
+    }
+
+    return count;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the last sample whose magnitude exceeds a threshold</summary>
+  /// <param name="samples">Samples that will be searched</param>
+  /// <param name="count">Number of samples to search</param>
+  /// <param name="threshold">Magnitude the sample needs to exceed</param>
+  /// <returns>The index one past the last such sample or zero if there is none</returns>
+  std::size_t findLastAbove(const float *samples, std::size_t count, float threshold) {
+    std::size_t end = count;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 thresholdVector = _mm_set1_ps(threshold);
+    for(; end >= 4; end -= 4) {
+      __m128 magnitudes = _mm_andnot_ps(signMask, _mm_loadu_ps(samples + (end - 4)));
+      if(_mm_movemask_ps(_mm_cmpgt_ps(magnitudes, thresholdVector)) != 0) {
+        break; // The scalar loop below finds the exact sample within the group
+      }
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const float32x4_t thresholdVector = vdupq_n_f32(threshold);
+    for(; end >= 4; end -= 4) {
+      uint32x4_t above = vcagtq_f32(vld1q_f32(samples + (end - 4)), thresholdVector);
+      if(vmaxvq_u32(above) != 0) {
+        break; // The scalar loop below finds the exact sample within the group
+      }
+    }
+#endif
+
+    for(; end > 0; --end) {
+      if(std::abs(samples[end - 1]) > threshold) {
+        return end;
+      }
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<SilentInterval> SilenceDetector::FindSilentIntervals(
+    const Storage::AudioTrackDecoder &decoder,
+    float thresholdDecibels /* = -60.0f */,
+    float hysteresisDecibels /* = 6.0f */,
+    std::size_t minimumFrameCount /* = 4800 */
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    SilenceDetector detector(
+      channelCount, thresholdDecibels, hysteresisDecibels, minimumFrameCount
+    );
+
+    std::vector<float> samples(DecodingBlockFrameCount * channelCount);
+
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    for(std::uint64_t startFrame = 0; startFrame < totalFrameCount;) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(DecodingBlockFrameCount, totalFrameCount - startFrame)
+      );
+      decoder.DecodeInterleaved<float>(samples.data(), startFrame, frameCount);
+      detector.ProcessInterleaved(samples.data(), frameCount);
+
+      startFrame += frameCount;
+    }
+
+    detector.Finish();
+    return detector.intervals;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudibleRange SilenceDetector::FindAudibleRange(
+    const Storage::AudioTrackDecoder &decoder, float thresholdDecibels /* = -60.0f */
+  ) {
+    float threshold = DecibelConverter::ToLinearAmplitude(thresholdDecibels);
+    std::size_t channelCount = decoder.CountChannels();
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+
+    std::vector<float> samples(TrimmingBlockFrameCount * channelCount);
+
+    // Search forward for the first audible sample. Interleaved channels don't need
+    // to be told apart, the frame is simply the sample index divided by the channels.
+    AudibleRange range = { totalFrameCount, totalFrameCount };
+    std::uint64_t firstFrame = 0;
+    while(firstFrame < totalFrameCount) {
+      Storage::BlockContent block = decoder.DescribeBlock(firstFrame);
+      if(!block.IsSilent) {
+        break;
+      }
+      firstFrame = block.StartFrame + block.FrameCount; // Flagged by codec, skip decoding
+    }
+    for(std::uint64_t startFrame = firstFrame; startFrame < totalFrameCount;) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(TrimmingBlockFrameCount, totalFrameCount - startFrame)
+      );
+      decoder.DecodeInterleaved<float>(samples.data(), startFrame, frameCount);
+
+      std::size_t sampleCount = frameCount * channelCount;
+      std::size_t index = findFirstAbove(samples.data(), sampleCount, threshold);
+      if(index < sampleCount) {
+        range.StartFrame = startFrame + (index / channelCount);
+        break;
+      }
+
+      startFrame += frameCount;
+    }
+    if(range.StartFrame == totalFrameCount) {
+      return range; // The whole track is silent
+    }
+
+    // Search backward for the last audible sample, decoding blocks from the end of
+    // the track towards the start. The search above guarantees one will be found.
+    std::uint64_t lastFrame = totalFrameCount;
+    while(lastFrame > range.StartFrame) {
+      Storage::BlockContent block = decoder.DescribeBlock(lastFrame - 1);
+      if(!block.IsSilent || (block.StartFrame <= range.StartFrame)) {
+        break;
+      }
+      lastFrame = block.StartFrame;
+    }
+    for(std::uint64_t endFrame = lastFrame; endFrame > range.StartFrame;) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(TrimmingBlockFrameCount, endFrame - range.StartFrame)
+      );
+      std::uint64_t startFrame = endFrame - frameCount;
+      decoder.DecodeInterleaved<float>(samples.data(), startFrame, frameCount);
+
+      std::size_t end = findLastAbove(samples.data(), frameCount * channelCount, threshold);
+      if(end > 0) {
+        range.EndFrame = startFrame + ((end - 1) / channelCount) + 1;
+        break;
+      }
+
+      endFrame = startFrame;
+    }
+
+    return range;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SilenceDetector::SilenceDetector(
+    std::size_t channelCount,
+    float thresholdDecibels /* = -60.0f */,
+    float hysteresisDecibels /* = 6.0f */,
+    std::size_t minimumFrameCount /* = 4800 */,
+    std::size_t windowFrameCount /* = 256 */
+  ) :
+    channelCount(channelCount),
+    enterThreshold(DecibelConverter::ToLinearAmplitude(thresholdDecibels)),
+    exitThreshold(DecibelConverter::ToLinearAmplitude(thresholdDecibels + hysteresisDecibels)),
+    minimumFrameCount(minimumFrameCount),
+    windowFrameCount(windowFrameCount),
+    processedFrameCount(0),
+    windowFillCount(0),
+    windowPeak(0.0f),
+    isSilent(false),
+    silenceStartFrame(0),
+    intervals() {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Silence detector needs to scan at least one channel");
+    }
+    if(unlikely(windowFrameCount == 0)) {
+      throw std::invalid_argument(u8"Silence detector windows must span at least one frame");
+    }
+    if(unlikely(hysteresisDecibels < 0.0f)) {
+      throw std::invalid_argument(u8"Hysteresis must not be negative");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SilenceDetector::Reset() {
+    this->processedFrameCount = 0;
+    this->windowFillCount = 0;
+    this->windowPeak = 0.0f;
+    this->isSilent = false;
+    this->silenceStartFrame = 0;
+    this->intervals.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SilenceDetector::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    while(frameCount > 0) {
+      std::size_t runFrameCount = std::min(
+        frameCount, this->windowFrameCount - this->windowFillCount
+      );
+      this->windowPeak = std::max(
+        this->windowPeak, findPeak(samples, runFrameCount * this->channelCount)
+      );
+
+      samples += runFrameCount * this->channelCount;
+      frameCount -= runFrameCount;
+      this->processedFrameCount += runFrameCount;
+      this->windowFillCount += runFrameCount;
+
+      if(this->windowFillCount == this->windowFrameCount) {
+        closeWindow();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SilenceDetector::Finish() {
+    if(this->windowFillCount > 0) {
+      closeWindow();
+    }
+    if(this->isSilent) {
+      closeSilence(this->processedFrameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SilenceDetector::closeWindow() {
+    std::uint64_t windowStartFrame = this->processedFrameCount - this->windowFillCount;
+
+    if(this->isSilent) {
+      if(this->windowPeak > this->exitThreshold) {
+        closeSilence(windowStartFrame);
+      }
+    } else if(this->windowPeak <= this->enterThreshold) {
+      this->isSilent = true;
+      this->silenceStartFrame = windowStartFrame;
+    }
+
+    this->windowFillCount = 0;
+    this->windowPeak = 0.0f;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SilenceDetector::closeSilence(std::uint64_t endFrame) {
+    std::uint64_t frameCount = endFrame - this->silenceStartFrame;
+    if(frameCount >= this->minimumFrameCount) {
+      this->intervals.push_back(SilentInterval { this->silenceStartFrame, frameCount });
+    }
+
+    this->isSilent = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,390 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/SpectrumAnalyzer.h"
+#include "Nuclex/Audio/Processing/FftPlan.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::copy()
+#include <cmath> // for std::cos(), std::ceil()
+#include <cstdint> // for std::int16_t, std::int32_t, std::uint8_t
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of frames that are requested from the decoder at once</summary>
+  /// <remarks>
+  ///   The decoder delivers its samples in codec blocks anyway, this only keeps
+  ///   the frame count of a single call within std::size_t on 32-bit systems.
+  /// </remarks>
+  const std::uint64_t AnalysisChunkFrameCount = 1048576;
+
+  /// <summary>The number pi with enough digits for double precision</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the weight of one sample in an analysis window</summary>
+  /// <param name="window">Window function whose weight will be calculated</param>
+  /// <param name="index">Index of the sample within the analysis window</param>
+  /// <param name="size">Number of samples in the analysis window</param>
+  /// <returns>The weight the sample will be multiplied with</returns>
+  /// <remarks>
+  ///   These are the periodic forms of the windows (divided by N rather than N - 1),
+  ///   which is what spectral analysis with overlapping windows wants.
+  /// </remarks>
+  double calculateWeight(
+    Nuclex::Audio::Processing::WindowFunction window, std::size_t index, std::size_t size
+  ) {
+    double phase = 2.0 * Pi * static_cast<double>(index) / static_cast<double>(size);
+    switch(window) {
+      case Nuclex::Audio::Processing::WindowFunction::Hann: {
+        return 0.5 - 0.5 * std::cos(phase);
+      }
+      case Nuclex::Audio::Processing::WindowFunction::Hamming: {
+        return 0.54 - 0.46 * std::cos(phase);
+      }
+      case Nuclex::Audio::Processing::WindowFunction::BlackmanHarris: {
+        return (
+          0.35875 -
+          0.48829 * std::cos(phase) +
+          0.14128 * std::cos(phase * 2.0) -
+          0.01168 * std::cos(phase * 3.0)
+        );
+      }
+      default: {
+        return 1.0;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies the samples of an analysis window with their weights</summary>
+  /// <param name="samples">Samples that will be weighted</param>
+  /// <param name="weights">Weight of each sample</param>
+  /// <param name="results">Receives the weighted samples</param>
+  /// <param name="count">Number of samples, always a multiple of 4</param>
+  void applyWeights(
+    const float *samples, const float *weights, float *results, std::size_t count
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    for(std::size_t index = 0; index < count; index += 4) {
+      _mm_storeu_ps(
+        results + index,
+        _mm_mul_ps(_mm_loadu_ps(samples + index), _mm_loadu_ps(weights + index))
+      );
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    for(std::size_t index = 0; index < count; index += 4) {
+      vst1q_f32(
+        results + index,
+        vmulq_f32(vld1q_f32(samples + index), vld1q_f32(weights + index))
+      );
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index) {
+      results[index] = samples[index] * weights[index];
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the factor that brings signed integer samples into range</summary>
+  /// <param name="bitsPerSample">Number of valid bits in each sample</param>
+  /// <param name="maximumBits">Number of bits the sample type can hold</param>
+  /// <returns>The factor by which the samples need to be multiplied</returns>
+  float getIntegerScale(std::size_t bitsPerSample, std::size_t maximumBits) {
+    if((bitsPerSample == 0) || (bitsPerSample > maximumBits)) {
+      bitsPerSample = maximumBits;
+    }
+    return static_cast<float>(1.0 / static_cast<double>(std::uint64_t(1) << (bitsPerSample - 1)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::Analyze(
+    const Storage::AudioTrackDecoder &decoder,
+    SpectrumSink &sink,
+    std::size_t fftSize /* = 2048 */,
+    std::size_t hopSize /* = 512 */,
+    WindowFunction window /* = WindowFunction::Hann */
+  ) {
+    SpectrumAnalyzer analyzer(sink, decoder.CountChannels(), fftSize, hopSize, window);
+
+    std::uint64_t totalFrameCount = decoder.CountFrames();
+    for(std::uint64_t start = 0; start < totalFrameCount; start += AnalysisChunkFrameCount) {
+      std::size_t frameCount = static_cast<std::size_t>(
+        std::min(AnalysisChunkFrameCount, totalFrameCount - start)
+      );
+      decoder.DecodeRange(start, frameCount, analyzer);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::SumBands(
+    const float *powers, std::size_t binCount, double sampleRate,
+    const double *bandEdges, std::size_t bandCount, float *energies
+  ) {
+    if(unlikely(binCount < 2)) {
+      throw std::invalid_argument(u8"Spectrum needs to have at least two bins");
+    }
+    if(unlikely(sampleRate <= 0.0)) {
+      throw std::invalid_argument(u8"Sample rate must be positive");
+    }
+
+    // Bin i is centered on the frequency i * sampleRate / fftSize. Each bin goes to
+    // the band its center frequency lies in, so no bin is counted twice.
+    double binsPerHertz = static_cast<double>((binCount - 1) * 2) / sampleRate;
+    for(std::size_t bandIndex = 0; bandIndex < bandCount; ++bandIndex) {
+      if(unlikely(bandEdges[bandIndex + 1] < bandEdges[bandIndex])) {
+        throw std::invalid_argument(u8"Band edges must be in ascending order");
+      }
+
+      double firstBin = std::ceil(std::max(bandEdges[bandIndex], 0.0) * binsPerHertz);
+      double endBin = std::ceil(std::max(bandEdges[bandIndex + 1], 0.0) * binsPerHertz);
+      std::size_t first = static_cast<std::size_t>(
+        std::min(firstBin, static_cast<double>(binCount))
+      );
+      std::size_t end = static_cast<std::size_t>(
+        std::min(endBin, static_cast<double>(binCount))
+      );
+
+      float energy = 0.0f;
+      for(std::size_t binIndex = first; binIndex < end; ++binIndex) {
+        energy += powers[binIndex];
+      }
+      energies[bandIndex] = energy;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SpectrumAnalyzer::SpectrumAnalyzer(
+    SpectrumSink &sink,
+    std::size_t channelCount,
+    std::size_t fftSize /* = 2048 */,
+    std::size_t hopSize /* = 512 */,
+    WindowFunction window /* = WindowFunction::Hann */
+  ) :
+    sink(sink),
+    channelCount(channelCount),
+    fftSize(fftSize),
+    hopSize(hopSize),
+    plan(),
+    weights(),
+    powerScale(1.0f),
+    history(),
+    historyLength(0),
+    historyStartFrame(0),
+    windowed(),
+    scratch(),
+    powers() {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Spectrum analyzer requires at least one channel");
+    }
+    if(unlikely((hopSize == 0) || (hopSize > fftSize))) {
+      throw std::invalid_argument(u8"Hop size must be between 1 and the FFT size");
+    }
+
+    // Checks the FFT size for us, too
+    this->plan = FftPlan::GetShared(fftSize);
+
+    double weightSum = 0.0;
+    this->weights.resize(fftSize);
+    for(std::size_t index = 0; index < fftSize; ++index) {
+      double weight = calculateWeight(window, index, fftSize);
+      this->weights[index] = static_cast<float>(weight);
+      weightSum += weight;
+    }
+
+    // A sine of amplitude A puts A/2 times the sum of all weights into its bin,
+    // so this normalizes the magnitude to A and thus the power to A²
+    this->powerScale = static_cast<float>(2.0 / weightSum);
+
+    this->history.resize(fftSize);
+    this->windowed.resize(fftSize);
+    this->scratch.resize(this->plan->CountScratchSamples());
+    this->powers.resize(this->plan->CountBins());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SpectrumAnalyzer::~SpectrumAnalyzer() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::Reset(std::uint64_t startFrame /* = 0 */) {
+    this->historyLength = 0;
+    this->historyStartFrame = startFrame;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    const void *buffers[] = { samples };
+    gather<float>(buffers, true, frameCount, 1.0f, 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::ProcessSamples(const Storage::DecodedSamples &samples) {
+    if(unlikely(samples.ChannelCount != this->channelCount)) {
+      throw std::invalid_argument(u8"Decoded samples have a different number of channels");
+    }
+
+    // A gap or a jump back means the gathered frames do not belong to this block
+    std::uint64_t expectedFrame = this->historyStartFrame + this->historyLength;
+    if(samples.StartFrame != expectedFrame) {
+      Reset(samples.StartFrame);
+    }
+
+    switch(samples.Format) {
+      case AudioSampleFormat::UnsignedInteger_8: {
+        gather<std::uint8_t>(
+          samples.Buffers, samples.IsInterleaved, samples.FrameCount, 1.0f / 128.0f, 128.0f
+        );
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_16: {
+        gather<std::int16_t>(
+          samples.Buffers, samples.IsInterleaved, samples.FrameCount,
+          getIntegerScale(samples.BitsPerSample, 16), 0.0f
+        );
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_24:
+      case AudioSampleFormat::SignedInteger_32: {
+        gather<std::int32_t>(
+          samples.Buffers, samples.IsInterleaved, samples.FrameCount,
+          getIntegerScale(samples.BitsPerSample, 32), 0.0f
+        );
+        break;
+      }
+      case AudioSampleFormat::Float_32: {
+        gather<float>(samples.Buffers, samples.IsInterleaved, samples.FrameCount, 1.0f, 0.0f);
+        break;
+      }
+      case AudioSampleFormat::Float_64: {
+        gather<double>(
+          samples.Buffers, samples.IsInterleaved, samples.FrameCount, 1.0f, 0.0f
+        );
+        break;
+      }
+      default: {
+        throw std::invalid_argument(u8"Decoded samples are in an unsupported format");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void SpectrumAnalyzer::gather(
+    const void *const *buffers, bool isInterleaved, std::size_t frameCount,
+    float scale, float offset
+  ) {
+    std::size_t channelCount = this->channelCount;
+    float frameScale = scale / static_cast<float>(channelCount);
+    float frameOffset = offset * static_cast<float>(channelCount);
+
+    std::size_t frameIndex = 0;
+    while(frameIndex < frameCount) {
+      std::size_t gatheredFrameCount = std::min(
+        frameCount - frameIndex, this->fftSize - this->historyLength
+      );
+      float *target = this->history.data() + this->historyLength;
+
+      // Convert and average the channels straight into the analysis window
+      if(isInterleaved) {
+        const TSample *source = (
+          static_cast<const TSample *>(buffers[0]) + (frameIndex * channelCount)
+        );
+        for(std::size_t index = 0; index < gatheredFrameCount; ++index) {
+          float sum = 0.0f;
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            sum += static_cast<float>(source[channelIndex]);
+          }
+          target[index] = (sum - frameOffset) * frameScale;
+          source += channelCount;
+        }
+      } else {
+        const TSample *source = static_cast<const TSample *>(buffers[0]) + frameIndex;
+        for(std::size_t index = 0; index < gatheredFrameCount; ++index) {
+          target[index] = static_cast<float>(source[index]);
+        }
+        for(std::size_t channelIndex = 1; channelIndex < channelCount; ++channelIndex) {
+          source = static_cast<const TSample *>(buffers[channelIndex]) + frameIndex;
+          for(std::size_t index = 0; index < gatheredFrameCount; ++index) {
+            target[index] += static_cast<float>(source[index]);
+          }
+        }
+        for(std::size_t index = 0; index < gatheredFrameCount; ++index) {
+          target[index] = (target[index] - frameOffset) * frameScale;
+        }
+      }
+
+      this->historyLength += gatheredFrameCount;
+      frameIndex += gatheredFrameCount;
+
+      if(this->historyLength == this->fftSize) {
+        emitSpectrum();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SpectrumAnalyzer::emitSpectrum() {
+    applyWeights(
+      this->history.data(), this->weights.data(), this->windowed.data(), this->fftSize
+    );
+    this->plan->ComputePowers(
+      this->windowed.data(), this->powers.data(), this->powerScale, this->scratch.data()
+    );
+    this->sink.ProcessSpectrum(
+      this->historyStartFrame, this->powers.data(), this->powers.size()
+    );
+
+    // Keep the overlapping part of the window, the next window begins one hop later
+    std::copy(
+      this->history.begin() + this->hopSize, this->history.end(), this->history.begin()
+    );
+    this->historyLength -= this->hopSize;
+    this->historyStartFrame += this->hopSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,533 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/VoiceMixer.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+
+#include <algorithm> // for std::min(), std::max(), std::fill(), std::copy()
+#include <cmath> // for std::cos(), std::sin()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>A quarter turn, the range a mono voice is panned over</summary>
+  const float QuarterPi = 0.785398163397448309616f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds interleaved stereo samples to an interleaved stereo bus</summary>
+  /// <param name="output">Interleaved stereo bus the samples will be added to</param>
+  /// <param name="input">Interleaved stereo samples that will be added</param>
+  /// <param name="frameCount">Number of frames that will be added</param>
+  /// <param name="leftGain">Factor applied to the left channel</param>
+  /// <param name="rightGain">Factor applied to the right channel</param>
+  void accumulateInterleaved(
+    float *output, const float *input, std::size_t frameCount,
+    float leftGain, float rightGain
+  ) {
+    std::size_t sampleCount = frameCount * 2;
+    std::size_t index = 0;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for(; index + 4 <= sampleCount; index += 4) {
+      _mm_storeu_ps(
+        output + index, _mm_add_ps(
+          _mm_loadu_ps(output + index), _mm_mul_ps(_mm_loadu_ps(input + index), gains)
+        )
+      );
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const float gainLanes[4] = { leftGain, rightGain, leftGain, rightGain };
+    const float32x4_t gains = vld1q_f32(gainLanes);
+    for(; index + 4 <= sampleCount; index += 4) {
+      vst1q_f32(
+        output + index, vmlaq_f32(vld1q_f32(output + index), vld1q_f32(input + index), gains)
+      );
+    }
+#endif
+
+    for(; index < sampleCount; index += 2) {
+      output[index] += input[index] * leftGain;
+      output[index + 1] += input[index + 1] * rightGain;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds two separate channels to an interleaved stereo bus</summary>
+  /// <param name="output">Interleaved stereo bus the samples will be added to</param>
+  /// <param name="left">Samples that will be added to the left channel</param>
+  /// <param name="right">Samples that will be added to the right channel</param>
+  /// <param name="frameCount">Number of frames that will be added</param>
+  /// <param name="leftGain">Factor applied to the left channel</param>
+  /// <param name="rightGain">Factor applied to the right channel</param>
+  /// <remarks>
+  ///   Mono voices pass the same buffer for both channels.
+  /// </remarks>
+  void accumulateSeparated(
+    float *output, const float *left, const float *right, std::size_t frameCount,
+    float leftGain, float rightGain
+  ) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for(; index + 4 <= frameCount; index += 4) {
+      __m128 lefts = _mm_loadu_ps(left + index);
+      __m128 rights = _mm_loadu_ps(right + index);
+      float *target = output + (index * 2);
+      _mm_storeu_ps(
+        target, _mm_add_ps(
+          _mm_loadu_ps(target), _mm_mul_ps(_mm_unpacklo_ps(lefts, rights), gains)
+        )
+      );
+      _mm_storeu_ps(
+        target + 4, _mm_add_ps(
+          _mm_loadu_ps(target + 4), _mm_mul_ps(_mm_unpackhi_ps(lefts, rights), gains)
+        )
+      );
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const float gainLanes[4] = { leftGain, rightGain, leftGain, rightGain };
+    const float32x4_t gains = vld1q_f32(gainLanes);
+    for(; index + 4 <= frameCount; index += 4) {
+      float32x4x2_t pairs = vzipq_f32(vld1q_f32(left + index), vld1q_f32(right + index));
+      float *target = output + (index * 2);
+      vst1q_f32(target, vmlaq_f32(vld1q_f32(target), pairs.val[0], gains));
+      vst1q_f32(target + 4, vmlaq_f32(vld1q_f32(target + 4), pairs.val[1], gains));
+    }
+#endif
+
+    for(; index < frameCount; ++index) {
+      output[index * 2] += left[index] * leftGain;
+      output[index * 2 + 1] += right[index] * rightGain;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct VoiceMixer::Voice {
+
+    /// <summary>Identifier through which the voice is controlled</summary>
+    public: std::size_t Id;
+    /// <summary>Streaming reader the voice reads from, if any</summary>
+    public: std::shared_ptr<Storage::StreamingTrackReader> Reader;
+    /// <summary>Decoder the voice decodes from, if any</summary>
+    public: std::shared_ptr<const Storage::AudioTrackDecoder> Decoder;
+    /// <summary>Interleaved samples in memory the voice plays, if any</summary>
+    public: const float *Samples;
+    /// <summary>Number of frames the memory clip or decoder provides</summary>
+    public: std::uint64_t FrameCount;
+    /// <summary>Index of the next frame that will be taken from the clip or decoder</summary>
+    public: std::uint64_t Position;
+    /// <summary>Number of channels delivered by the source, either 1 or 2</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Sample rate of the audio delivered by the source</summary>
+    public: std::size_t SampleRate;
+    /// <summary>Linear volume of the voice</summary>
+    public: float Gain;
+    /// <summary>Position in the stereo panorama from -1.0 to 1.0</summary>
+    public: float Pan;
+    /// <summary>Factor applied to the samples that end up in the left channel</summary>
+    public: float LeftGain;
+    /// <summary>Factor applied to the samples that end up in the right channel</summary>
+    public: float RightGain;
+    /// <summary>Whether the voice has played all of its audio</summary>
+    public: bool IsFinished;
+
+    /// <summary>Converts the sample rate if it differs from the output bus</summary>
+    public: std::unique_ptr<Resampler> Converter;
+    /// <summary>Interleaved samples read from a streaming reader or decoder</summary>
+    public: std::vector<float> Input;
+    /// <summary>Separated input samples that are fed to the resampler</summary>
+    public: std::vector<float> Separated;
+    /// <summary>Separated samples the resampler produced that await mixing</summary>
+    public: std::vector<float> Resampled;
+    /// <summary>Number of frames each channel's resampled buffer can hold</summary>
+    public: std::size_t ResampledCapacity;
+    /// <summary>Number of resampled frames waiting to be mixed</summary>
+    public: std::size_t ResampledFrameCount;
+    /// <summary>Largest number of frames read from the source in one go</summary>
+    public: std::size_t MaximumInputFrameCount;
+    /// <summary>Whether the resampler's lookahead has been flushed with silence</summary>
+    public: bool IsFlushed;
+
+    /// <summary>Calculates the channel gains from the voice's gain and panning</summary>
+    public: void UpdateGains() {
+      if(this->ChannelCount == 1) {
+        float angle = (this->Pan + 1.0f) * QuarterPi;
+        this->LeftGain = this->Gain * std::cos(angle);
+        this->RightGain = this->Gain * std::sin(angle);
+      } else {
+        this->LeftGain = this->Gain * std::min(1.0f, 1.0f - this->Pan);
+        this->RightGain = this->Gain * std::min(1.0f, 1.0f + this->Pan);
+      }
+    }
+
+    /// <summary>Checks whether the source has no more frames to deliver</summary>
+    /// <returns>True if the end of the source has been reached</returns>
+    public: bool IsSourceAtEnd() const {
+      if(static_cast<bool>(this->Reader)) {
+        return this->Reader->IsAtEnd();
+      } else {
+        return (this->Position >= this->FrameCount);
+      }
+    }
+
+    /// <summary>Reads the next interleaved frames from the source</summary>
+    /// <param name="frameCount">Number of frames that should be read</param>
+    /// <param name="frames">Receives the address of the interleaved frames</param>
+    /// <returns>The number of frames that could be read</returns>
+    public: std::size_t Read(std::size_t frameCount, const float *&frames) {
+      if(static_cast<bool>(this->Reader)) {
+        frames = this->Input.data();
+        return this->Reader->Read(this->Input.data(), frameCount);
+      }
+
+      frameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount, this->FrameCount - this->Position)
+      );
+      if(this->Samples != nullptr) {
+        frames = this->Samples + (this->Position * this->ChannelCount);
+      } else {
+        frames = this->Input.data();
+        if(frameCount > 0) {
+          this->Decoder->DecodeInterleaved<float>(this->Input.data(), this->Position, frameCount);
+        }
+      }
+      this->Position += frameCount;
+
+      return frameCount;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VoiceMixer::VoiceMixer(
+    std::size_t outputSampleRate,
+    std::size_t maximumFrameCount /* = 1024 */,
+    ResamplerQuality quality /* = ResamplerQuality::Fast */
+  ) :
+    outputSampleRate(outputSampleRate),
+    maximumFrameCount(maximumFrameCount),
+    quality(quality),
+    nextVoiceId(1),
+    voices() {
+    if(outputSampleRate == 0) {
+      throw std::invalid_argument(u8"Output sample rate must not be zero");
+    }
+    if(maximumFrameCount == 0) {
+      throw std::invalid_argument(u8"Maximum frame count must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VoiceMixer::~VoiceMixer() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VoiceMixer::AddVoice(
+    const std::shared_ptr<Storage::StreamingTrackReader> &reader, std::size_t sampleRate
+  ) {
+    if(!static_cast<bool>(reader)) {
+      throw std::invalid_argument(u8"Streaming reader must not be empty");
+    }
+
+    std::unique_ptr<Voice> voice = std::make_unique<Voice>();
+    voice->Reader = reader;
+    voice->Samples = nullptr;
+    voice->FrameCount = reader->CountFrames();
+    voice->ChannelCount = reader->CountChannels();
+    voice->SampleRate = sampleRate;
+
+    return addVoice(std::move(voice));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VoiceMixer::AddVoice(
+    const float *samples, std::uint64_t frameCount,
+    std::size_t channelCount, std::size_t sampleRate
+  ) {
+    if((samples == nullptr) && (frameCount > 0)) {
+      throw std::invalid_argument(u8"Sample buffer must not be a null pointer");
+    }
+
+    std::unique_ptr<Voice> voice = std::make_unique<Voice>();
+    voice->Samples = samples;
+    voice->FrameCount = frameCount;
+    voice->ChannelCount = channelCount;
+    voice->SampleRate = sampleRate;
+
+    return addVoice(std::move(voice));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VoiceMixer::AddVoice(
+    const std::shared_ptr<const Storage::AudioTrackDecoder> &decoder, std::size_t sampleRate
+  ) {
+    if(!static_cast<bool>(decoder)) {
+      throw std::invalid_argument(u8"Decoder must not be empty");
+    }
+
+    std::unique_ptr<Voice> voice = std::make_unique<Voice>();
+    voice->Decoder = decoder;
+    voice->Samples = nullptr;
+    voice->FrameCount = decoder->CountFrames();
+    voice->ChannelCount = decoder->CountChannels();
+    voice->SampleRate = sampleRate;
+
+    return addVoice(std::move(voice));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VoiceMixer::RemoveVoice(std::size_t voiceId) {
+    for(std::size_t index = 0; index < this->voices.size(); ++index) {
+      if(this->voices[index]->Id == voiceId) {
+        this->voices.erase(this->voices.begin() + index);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VoiceMixer::SetGain(std::size_t voiceId, float gain) {
+    Voice *voice = findVoice(voiceId);
+    if(voice == nullptr) {
+      throw std::invalid_argument(u8"No voice with the specified identifier exists");
+    }
+
+    voice->Gain = gain;
+    voice->UpdateGains();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VoiceMixer::SetPan(std::size_t voiceId, float pan) {
+    Voice *voice = findVoice(voiceId);
+    if(voice == nullptr) {
+      throw std::invalid_argument(u8"No voice with the specified identifier exists");
+    }
+
+    voice->Pan = std::max(-1.0f, std::min(pan, 1.0f));
+    voice->UpdateGains();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VoiceMixer::IsVoiceFinished(std::size_t voiceId) const {
+    Voice *voice = findVoice(voiceId);
+    if(voice == nullptr) {
+      throw std::invalid_argument(u8"No voice with the specified identifier exists");
+    }
+
+    return voice->IsFinished;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VoiceMixer::Mix(float *output, std::size_t frameCount) {
+    std::fill(output, output + (frameCount * 2), 0.0f);
+
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, this->maximumFrameCount);
+      for(std::size_t index = 0; index < this->voices.size(); ++index) {
+        Voice &voice = *this->voices[index];
+        if(!voice.IsFinished) {
+          mixVoice(voice, output, chunkFrameCount);
+        }
+      }
+
+      output += chunkFrameCount * 2;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VoiceMixer::addVoice(std::unique_ptr<Voice> voice) {
+    if((voice->ChannelCount < 1) || (voice->ChannelCount > 2)) {
+      throw std::invalid_argument(u8"Voices need to have either one or two channels");
+    }
+    if(voice->SampleRate == 0) {
+      throw std::invalid_argument(u8"Voice sample rate must not be zero");
+    }
+
+    voice->Position = 0;
+    voice->Gain = 1.0f;
+    voice->Pan = 0.0f;
+    voice->IsFinished = false;
+    voice->IsFlushed = false;
+    voice->ResampledFrameCount = 0;
+    voice->UpdateGains();
+
+    // Work out how many source frames the largest chunk can need. One extra frame
+    // covers the rounding, the resampler keeps whatever isn't used for the next call.
+    std::size_t channelCount = voice->ChannelCount;
+    if(voice->SampleRate == this->outputSampleRate) {
+      voice->MaximumInputFrameCount = this->maximumFrameCount;
+      voice->ResampledCapacity = 0;
+    } else {
+      voice->Converter = std::make_unique<Resampler>(
+        voice->SampleRate, this->outputSampleRate, channelCount, this->quality
+      );
+      voice->MaximumInputFrameCount = std::max(
+        (
+          (this->maximumFrameCount * voice->SampleRate + this->outputSampleRate - 1) /
+          this->outputSampleRate + 1
+        ),
+        voice->Converter->CountLookaheadFrames()
+      );
+      voice->ResampledCapacity = (
+        this->maximumFrameCount +
+        voice->Converter->CountMaximumOutputFrames(voice->MaximumInputFrameCount)
+      );
+      voice->Separated.resize(voice->MaximumInputFrameCount * channelCount);
+      voice->Resampled.resize(voice->ResampledCapacity * channelCount);
+    }
+    if(voice->Samples == nullptr) {
+      voice->Input.resize(voice->MaximumInputFrameCount * channelCount);
+    }
+
+    voice->Id = this->nextVoiceId++;
+    this->voices.push_back(std::move(voice));
+
+    return this->voices.back()->Id;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VoiceMixer::Voice *VoiceMixer::findVoice(std::size_t voiceId) const {
+    for(std::size_t index = 0; index < this->voices.size(); ++index) {
+      if(this->voices[index]->Id == voiceId) {
+        return this->voices[index].get();
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VoiceMixer::mixVoice(Voice &voice, float *output, std::size_t frameCount) {
+    std::size_t channelCount = voice.ChannelCount;
+    const float *frames;
+
+    // Voices at the output sample rate are mixed straight from their source
+    if(!static_cast<bool>(voice.Converter)) {
+      std::size_t readFrameCount = voice.Read(frameCount, frames);
+      if(channelCount == 1) {
+        accumulateSeparated(
+          output, frames, frames, readFrameCount, voice.LeftGain, voice.RightGain
+        );
+      } else {
+        accumulateInterleaved(output, frames, readFrameCount, voice.LeftGain, voice.RightGain);
+      }
+      if((readFrameCount < frameCount) && voice.IsSourceAtEnd()) {
+        voice.IsFinished = true;
+      }
+      return;
+    }
+
+    float *separated[2] = {
+      voice.Separated.data(), voice.Separated.data() + voice.MaximumInputFrameCount
+    };
+    float *resampled[2] = {
+      voice.Resampled.data(), voice.Resampled.data() + voice.ResampledCapacity
+    };
+
+    // Keep resampling until enough frames are queued up. The resampled buffer has room
+    // for one more call's output past the chunk size, so this never overflows.
+    while((voice.ResampledFrameCount < frameCount) && !voice.IsFlushed) {
+      std::size_t missingFrameCount = frameCount - voice.ResampledFrameCount;
+      std::size_t wantedFrameCount = std::min(
+        (missingFrameCount * voice.SampleRate + this->outputSampleRate - 1) /
+        this->outputSampleRate + 1,
+        voice.MaximumInputFrameCount
+      );
+
+      std::size_t readFrameCount = voice.Read(wantedFrameCount, frames);
+      if(readFrameCount == 0) {
+        if(!voice.IsSourceAtEnd()) {
+          break; // Streaming reader fell behind, mix what we have
+        }
+
+        // Push the last frames out of the filter by feeding it silence
+        readFrameCount = voice.Converter->CountLookaheadFrames();
+        std::fill(voice.Separated.begin(), voice.Separated.end(), 0.0f);
+        voice.IsFlushed = true;
+      } else if(channelCount == 1) {
+        std::copy(frames, frames + readFrameCount, separated[0]);
+      } else {
+        Interleaver::Deinterleave(frames, separated, channelCount, readFrameCount);
+      }
+
+      float *targets[2] = {
+        resampled[0] + voice.ResampledFrameCount, resampled[1] + voice.ResampledFrameCount
+      };
+      voice.ResampledFrameCount += voice.Converter->Process(separated, readFrameCount, targets);
+    }
+
+    std::size_t mixedFrameCount = std::min(frameCount, voice.ResampledFrameCount);
+    accumulateSeparated(
+      output, resampled[0], resampled[channelCount - 1], mixedFrameCount,
+      voice.LeftGain, voice.RightGain
+    );
+
+    // Move the leftover frames to the front for the next chunk
+    std::size_t remainingFrameCount = voice.ResampledFrameCount - mixedFrameCount;
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      std::copy(
+        resampled[channelIndex] + mixedFrameCount,
+        resampled[channelIndex] + voice.ResampledFrameCount,
+        resampled[channelIndex]
+      );
+    }
+    voice.ResampledFrameCount = remainingFrameCount;
+
+    if(voice.IsFlushed && (remainingFrameCount == 0)) {
+      voice.IsFinished = true;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -21,10 +21,375 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Processing/VolumeDetector.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for SIMD intrinsics
 
-// --------------------------------------------------------------------------------------------- //
+#include <algorithm> // for std::min(), std::max(), std::fill()
+#include <cassert> // for assert()
+#include <cmath> // for std::sqrt(), std::abs()
+#include <stdexcept> // for std::invalid_argument
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames summed in single precision before totals are updated</summary>
+  /// <remarks>
+  ///   Each SIMD lane adds up at most a quarter of this many samples times the channel
+  ///   count, which is far too few for single precision rounding to matter.
+  /// </remarks>
+  const std::size_t BlockFrameCount = 1024;
+
+  /// <summary>Highest number of interleaved channels processed with SIMD instructions</summary>
+  const std::size_t MaximumVectorizedChannelCount = 8;
+
+  /// <summary>Factor that turns 16-bit integer samples into full scale relative values</summary>
+  const double Int16Scale = 1.0 / 32767.0;
+
+  /// <summary>Factor that turns 32-bit integer samples into full scale relative values</summary>
+  const double Int32Scale = 1.0 / 2147483647.0;
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Vector type holding 4 single precision lanes</summary>
+  typedef __m128 FloatVector;
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const float *samples) {
+    return _mm_loadu_ps(samples);
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const double *samples) {
+    return _mm_movelh_ps(
+      _mm_cvtpd_ps(_mm_loadu_pd(samples)), _mm_cvtpd_ps(_mm_loadu_pd(samples + 2))
+    );
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const std::int16_t *samples) {
+    __m128i words = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(samples));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16));
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const std::int32_t *samples) {
+    return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(samples)));
+  }
+
+  /// <summary>Updates the peak, sum and square sum lanes with another vector</summary>
+  /// <param name="peaks">Largest absolute values seen in each lane</param>
+  /// <param name="sums">Sums of the values in each lane</param>
+  /// <param name="squareSums">Sums of the squared values in each lane</param>
+  /// <param name="values">Values that will be added to the statistics</param>
+  inline void accumulateVector(
+    FloatVector &peaks, FloatVector &sums, FloatVector &squareSums, FloatVector values
+  ) {
+    peaks = _mm_max_ps(peaks, _mm_andnot_ps(_mm_set1_ps(-0.0f), values));
+    sums = _mm_add_ps(sums, values);
+    squareSums = _mm_add_ps(squareSums, _mm_mul_ps(values, values));
+  }
+
+  /// <summary>Returns a vector with all lanes set to zero</summary>
+  /// <returns>A vector with all lanes set to zero</returns>
+  inline FloatVector zeroVector() {
+    return _mm_setzero_ps();
+  }
+
+  /// <summary>Stores the lanes of a vector in memory</summary>
+  /// <param name="target">Address at which the 4 lanes will be stored</param>
+  /// <param name="vector">Vector whose lanes will be stored</param>
+  inline void storeVector(float *target, FloatVector vector) {
+    _mm_storeu_ps(target, vector);
+  }
+
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Vector type holding 4 single precision lanes</summary>
+  typedef float32x4_t FloatVector;
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const float *samples) {
+    return vld1q_f32(samples);
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const double *samples) {
+    return vcombine_f32(
+      vcvt_f32_f64(vld1q_f64(samples)), vcvt_f32_f64(vld1q_f64(samples + 2))
+    );
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const std::int16_t *samples) {
+    return vcvtq_f32_s32(vmovl_s16(vld1_s16(samples)));
+  }
+
+  /// <summary>Loads 4 samples as floats into a vector register</summary>
+  /// <param name="samples">Address of the first sample that will be loaded</param>
+  /// <returns>A vector holding all 4 samples as floats</returns>
+  inline FloatVector loadVector(const std::int32_t *samples) {
+    return vcvtq_f32_s32(vld1q_s32(samples));
+  }
+
+  /// <summary>Updates the peak, sum and square sum lanes with another vector</summary>
+  /// <param name="peaks">Largest absolute values seen in each lane</param>
+  /// <param name="sums">Sums of the values in each lane</param>
+  /// <param name="squareSums">Sums of the squared values in each lane</param>
+  /// <param name="values">Values that will be added to the statistics</param>
+  inline void accumulateVector(
+    FloatVector &peaks, FloatVector &sums, FloatVector &squareSums, FloatVector values
+  ) {
+    peaks = vmaxq_f32(peaks, vabsq_f32(values));
+    sums = vaddq_f32(sums, values);
+    squareSums = vmlaq_f32(squareSums, values, values);
+  }
+
+  /// <summary>Returns a vector with all lanes set to zero</summary>
+  /// <returns>A vector with all lanes set to zero</returns>
+  inline FloatVector zeroVector() {
+    return vdupq_n_f32(0.0f);
+  }
+
+  /// <summary>Stores the lanes of a vector in memory</summary>
+  /// <param name="target">Address at which the 4 lanes will be stored</param>
+  /// <param name="vector">Vector whose lanes will be stored</param>
+  inline void storeVector(float *target, FloatVector vector) {
+    vst1q_f32(target, vector);
+  }
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds interleaved samples to the single precision block sums</summary>
+  /// <typeparam name="TSample">Type of the samples that will be analyzed</typeparam>
+  /// <param name="samples">Interleaved samples that will be analyzed</param>
+  /// <param name="channelCount">Number of interleaved channels</param>
+  /// <param name="frameCount">Number of frames that will be analyzed</param>
+  /// <param name="blockSums">Peak, sum and square sum of each channel</param>
+  template<typename TSample>
+  void accumulateInterleaved(
+    const TSample *samples, std::size_t channelCount, std::size_t frameCount, float *blockSums
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2) || defined(NUCLEX_AUDIO_HAVE_NEON)
+
+    // Four frames are exactly channelCount vectors. Lane 'l' of vector 'v' always holds
+    // the same channel, (v * 4 + l) modulo the channel count, so each vector gets its own
+    // accumulators and the lanes are sorted into their channels once at the end.
+    if(channelCount <= MaximumVectorizedChannelCount) {
+      FloatVector peaks[MaximumVectorizedChannelCount];
+      FloatVector sums[MaximumVectorizedChannelCount];
+      FloatVector squareSums[MaximumVectorizedChannelCount];
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        peaks[index] = sums[index] = squareSums[index] = zeroVector();
+      }
+
+      std::size_t vectorizedFrameCount = frameCount & ~std::size_t(3);
+      const TSample *end = samples + (vectorizedFrameCount * channelCount);
+      while(samples < end) {
+        for(std::size_t index = 0; index < channelCount; ++index) {
+          accumulateVector(peaks[index], sums[index], squareSums[index], loadVector(samples));
+          samples += 4;
+        }
+      }
+
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        float lanePeaks[4], laneSums[4], laneSquareSums[4];
+        storeVector(lanePeaks, peaks[index]);
+        storeVector(laneSums, sums[index]);
+        storeVector(laneSquareSums, squareSums[index]);
+        for(std::size_t lane = 0; lane < 4; ++lane) {
+          float *channelSums = blockSums + ((index * 4 + lane) % channelCount) * 3;
+          channelSums[0] = std::max(channelSums[0], lanePeaks[lane]);
+          channelSums[1] += laneSums[lane];
+          channelSums[2] += laneSquareSums[lane];
+        }
+      }
+
+      frameCount -= vectorizedFrameCount;
+    }
+
+#endif
+
+    // Leftover frames and unusual channel counts are handled one sample at a time
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        float value = static_cast<float>(*samples);
+        ++samples;
+
+        float *channelSums = blockSums + channelIndex * 3;
+        channelSums[0] = std::max(channelSums[0], std::abs(value));
+        channelSums[1] += value;
+        channelSums[2] += value * value;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VolumeDetector::VolumeDetector(std::size_t channelCount) :
+    channelCount(channelCount),
+    processedFrameCount(0),
+    blockSums(channelCount * 3, 0.0f),
+    totals(channelCount * 3, 0.0) {
+
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Volume detector needs at least one channel");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::Reset() {
+    this->processedFrameCount = 0;
+    std::fill(this->totals.begin(), this->totals.end(), 0.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessInterleaved(const float *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessInterleaved(const double *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessInterleaved(const std::int16_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, Int16Scale);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessInterleaved(const std::int32_t *samples, std::size_t frameCount) {
+    processInterleaved(samples, frameCount, Int32Scale);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessSeparated(
+    const float *const channels[], std::size_t frameCount
+  ) {
+    processSeparated(channels, frameCount, 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::ProcessSeparated(
+    const std::int16_t *const channels[], std::size_t frameCount
+  ) {
+    processSeparated(channels, frameCount, Int16Scale);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelVolume VolumeDetector::GetChannelVolume(std::size_t channelIndex) const {
+    assert((channelIndex < this->channelCount) && u8"Channel index must be valid");
+
+    ChannelVolume volume = { 0.0f, 0.0f, 0.0f };
+    if(this->processedFrameCount > 0) {
+      const double *channelTotals = this->totals.data() + channelIndex * 3;
+      double frameCount = static_cast<double>(this->processedFrameCount);
+      volume.Peak = static_cast<float>(channelTotals[0]);
+      volume.Rms = static_cast<float>(std::sqrt(channelTotals[2] / frameCount));
+      volume.DcOffset = static_cast<float>(channelTotals[1] / frameCount);
+    }
+
+    return volume;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelVolume> VolumeDetector::GetChannelVolumes() const {
+    std::vector<ChannelVolume> volumes;
+    volumes.reserve(this->channelCount);
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      volumes.push_back(GetChannelVolume(index));
+    }
+
+    return volumes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void VolumeDetector::processInterleaved(
+    const TSample *samples, std::size_t frameCount, double scale
+  ) {
+    while(0 < frameCount) {
+      std::size_t blockFrameCount = std::min(frameCount, BlockFrameCount);
+
+      std::fill(this->blockSums.begin(), this->blockSums.end(), 0.0f);
+      accumulateInterleaved(samples, this->channelCount, blockFrameCount, this->blockSums.data());
+      accumulateBlock(scale);
+
+      samples += blockFrameCount * this->channelCount;
+      frameCount -= blockFrameCount;
+      this->processedFrameCount += blockFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void VolumeDetector::processSeparated(
+    const TSample *const channels[], std::size_t frameCount, double scale
+  ) {
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; frameIndex += BlockFrameCount) {
+      std::size_t blockFrameCount = std::min(frameCount - frameIndex, BlockFrameCount);
+
+      // A single channel is just interleaved audio with one channel
+      std::fill(this->blockSums.begin(), this->blockSums.end(), 0.0f);
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        accumulateInterleaved(
+          channels[index] + frameIndex, 1, blockFrameCount, this->blockSums.data() + index * 3
+        );
+      }
+      accumulateBlock(scale);
+
+      this->processedFrameCount += blockFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VolumeDetector::accumulateBlock(double scale) {
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      const float *channelSums = this->blockSums.data() + index * 3;
+      double *channelTotals = this->totals.data() + index * 3;
+
+      channelTotals[0] = std::max(channelTotals[0], static_cast<double>(channelSums[0]) * scale);
+      channelTotals[1] += static_cast<double>(channelSums[1]) * scale;
+      channelTotals[2] += static_cast<double>(channelSums[2]) * (scale * scale);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,94 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/SampleAllocator.h"
+
+#include <atomic> // for std::atomic
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample allocator that uses the aligned operator new</summary>
+  class DefaultSampleAllocator : public Nuclex::Audio::SampleAllocator {
+
+    /// <summary>Allocates a block of memory aligned to 64 bytes</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The address of the allocated memory</returns>
+    public: void *Allocate(std::size_t byteCount) override {
+      return ::operator new(byteCount, std::align_val_t(Alignment));
+    }
+
+    /// <summary>Frees a block of memory that was obtained through Allocate()</summary>
+    /// <param name="memory">Address of the memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: void Free(void *memory, std::size_t byteCount) noexcept override {
+      (void)byteCount;
+      ::operator delete(memory, std::align_val_t(Alignment));
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the sample allocator that is used unless another one is set</summary>
+  /// <returns>The default sample allocator</returns>
+  /// <remarks>
+  ///   This is a function-local static so it is available even to buffers that are
+  ///   created during static initialization of other translation units.
+  /// </remarks>
+  Nuclex::Audio::SampleAllocator &getDefaultAllocator() {
+    static DefaultSampleAllocator allocator;
+    return allocator;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocator installed by the application, nullptr if none</summary>
+  std::atomic<Nuclex::Audio::SampleAllocator *> globalAllocator(nullptr);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SampleAllocator &SampleAllocator::GetGlobal() {
+    SampleAllocator *allocator = globalAllocator.load(std::memory_order_acquire);
+    if(likely(allocator == nullptr)) {
+      return getDefaultAllocator();
+    } else {
+      return *allocator;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SampleAllocator::SetGlobal(SampleAllocator *allocator) {
+    globalAllocator.store(allocator, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
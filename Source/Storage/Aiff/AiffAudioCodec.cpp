@@ -0,0 +1,118 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./AiffAudioCodec.h"
+#include "./AiffDetection.h"
+#include "./AiffReader.h"
+
+#include "../Waveform/WaveformTrackDecoder.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &AiffAudioCodec::GetName() const {
+    const static std::string codecName(u8"Audio Interchange File Format", 29);
+    return codecName;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::string> &AiffAudioCodec::GetFileExtensions() const  {
+    const static std::vector<std::string> extensions {
+      std::string(u8"aiff", 4),
+      std::string(u8"aif", 3),
+      std::string(u8"aifc", 4)
+    };
+    return extensions;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AiffAudioCodec::IsSignaturePresent(
+    const std::byte *header, std::size_t byteCount
+  ) const {
+    return Detection::CheckIfAiffHeaderPresent(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<ContainerInfo> AiffAudioCodec::TryReadInfo(
+    const std::shared_ptr<const VirtualFile> &source,
+    const std::string &extensionHint /* = std::string() */
+  ) const {
+    (void)extensionHint;
+
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata, AllocationCodec::Waveform);
+
+    std::optional<Waveform::StoredSampleLayout> layout = AiffReader::TryReadLayout(source);
+    if(!layout.has_value()) {
+      return std::optional<ContainerInfo>();
+    }
+
+    ContainerInfo containerInfo;
+    containerInfo.DefaultTrackIndex = 0;
+    containerInfo.Tracks.push_back(std::move(layout.value().Track));
+
+    return containerInfo;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AiffAudioCodec::TryOpenDecoder(
+    const std::shared_ptr<const VirtualFile> &source,
+    const std::string &extensionHint /* = std::string() */,
+    std::size_t trackIndex /* = 0 */
+  ) const {
+    (void)extensionHint;
+
+    // As the AudioCodec interface promises, if the file is not an AIFF audio file,
+    // we'll return an empty result to indicate that we couldn't read it.
+    if(!Detection::CheckIfAiffHeaderPresent(*source)) {
+      return std::shared_ptr<AudioTrackDecoder>();
+    }
+
+    // AIFF files only ever contain a single track
+    if(trackIndex != 0) {
+      throw std::runtime_error(
+        u8"Alternate track decoding is not implemented yet, track index must be 0"
+      );
+    }
+
+    AllocationScope readerScope(AllocationSubsystem::ReaderScratch, AllocationCodec::Waveform);
+
+    // The samples in AIFF files are stored just like in Waveform files, only with
+    // different headers, so the Waveform decoder can read them straight from the file.
+    return std::make_shared<Waveform::WaveformTrackDecoder>(
+      source, AiffReader::ReadLayout(source), Shared::TrackedCodec::Aiff
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
@@ -0,0 +1,89 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./AiffDetection.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../EndianReader.h" // for BigEndianReader
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfAiffHeaderPresent(const VirtualFile &source) {
+    if(source.GetSize() < SmallestPossibleAiffSize) {
+      return false; // File is too small to be an AIFF file
+    }
+
+    std::byte fileHeader[16];
+    source.ReadAt(0, 16, fileHeader);
+
+    return CheckIfAiffHeaderPresent(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfAiffHeaderPresent(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 16) {
+      return false; // Not enough header bytes to check for a valid AIFF header
+    }
+
+    // AIFF is an IFF file (like RIFF, but always big endian) with its own form type.
+    // 'AIFC' is the later revision which adds a compression type to the 'COMM' chunk,
+    // which is mostly used to store uncompressed samples in other formats.
+    bool isAiff = (
+      (fileHeader[0] == std::byte(0x46)) &&   //  1 F | FORM (FourCC; chunk descriptor)
+      (fileHeader[1] == std::byte(0x4f)) &&   //  2 O |
+      (fileHeader[2] == std::byte(0x52)) &&   //  3 R | IFF container holding a form
+      (fileHeader[3] == std::byte(0x4d)) &&   //  4 M |
+      (fileHeader[8] == std::byte(0x41)) &&   //  1 A | AIFF or AIFC (form type)
+      (fileHeader[9] == std::byte(0x49)) &&   //  2 I |
+      (fileHeader[10] == std::byte(0x46)) &&  //  3 F | The form type tells audio apart
+      (                                       //  4 F | from the other IFF formats,
+        (fileHeader[11] == std::byte(0x46)) ||  //    | such as images (ILBM).
+        (fileHeader[11] == std::byte(0x43))     //  C |
+      )
+    );
+    if(!isAiff) {
+      return false;
+    }
+
+    // IFF chunk ids consist of printable ASCII characters, so if whatever follows
+    // the form type isn't made of those, there's no chunk following the header.
+    for(std::size_t index = 12; index < 16; ++index) {
+      if((fileHeader[index] < std::byte(0x20)) || (fileHeader[index] > std::byte(0x7e))) {
+        return false;
+      }
+    }
+
+    std::uint32_t formSize = BigEndianReader::ReadUInt32(fileHeader + 4);
+    return (
+      (formSize >= SmallestPossibleAiffSize - 8) && // Big enough to hold the mandatory chunks
+      (formSize < 0x80000000)                       // Sizes are signed in the IFF specification
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
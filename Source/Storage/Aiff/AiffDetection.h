@@ -0,0 +1,72 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_AIFF_AIFFDETECTION_H
+#define NUCLEX_AUDIO_STORAGE_AIFF_AIFFDETECTION_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the smallest valid AIFF file possible</summary>
+  /// <remarks>
+  ///   That is the 'FORM' header, a 'COMM' chunk with its 18 bytes of format informations
+  ///   and an empty 'SSND' chunk with just its offset and block size fields.
+  /// </remarks>
+  constexpr const std::size_t SmallestPossibleAiffSize = 12 + 26 + 16; // bytes
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper class for detecting AIFF and AIFF-C files</summary>
+  class Detection {
+
+    /// <summary>Checks if the specified file starts with a valid AIFF header</summary>
+    /// <param name="source">File that will be checked for a valid AIFF header</param>
+    /// <returns>True if a valid AIFF or AIFF-C header was found, false otherwise</returns>
+    public: static bool CheckIfAiffHeaderPresent(const VirtualFile &source);
+
+    /// <summary>Checks if the file header starts with a valid AIFF header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid AIFF or AIFF-C header was found, false otherwise</returns>
+    public: static bool CheckIfAiffHeaderPresent(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
+
+#endif // NUCLEX_AUDIO_STORAGE_AIFF_AIFFDETECTION_H
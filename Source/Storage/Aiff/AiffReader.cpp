@@ -0,0 +1,333 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./AiffReader.h"
+#include "./AiffDetection.h"
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../EndianReader.h" // for BigEndianReader
+#include "../Waveform/WaveformParser.h" // for WaveformParser::GuessChannelPlacement()
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::ldexp()
+#include <cstring> // for std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Length of the 'COMM' chunk in plain AIFF files</summary>
+  constexpr std::size_t CommonChunkLength = 18;
+
+  /// <summary>Length of the 'COMM' chunk in AIFF-C files up to the compression type</summary>
+  /// <remarks>
+  ///   The compression type is followed by a human-readable compression name, which
+  ///   we have no use for and don't read.
+  /// </remarks>
+  constexpr std::size_t ExtendedCommonChunkLength = 22;
+
+  /// <summary>Length of the fixed fields at the beginning of the 'SSND' chunk</summary>
+  constexpr std::size_t SoundDataHeaderLength = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts an 80-bit IEEE 754 extended precision float into a double</summary>
+  /// <param name="data">Big endian extended precision float that will be converted</param>
+  /// <returns>The value of the extended precision float</returns>
+  /// <remarks>
+  ///   AIFF stores its sample rate in this format, a holdover from the 68881 FPU.
+  ///   Unlike the other IEEE 754 formats, it stores the mantissa's integer bit.
+  /// </remarks>
+  double readExtendedFloat(const std::byte *data) {
+    using Nuclex::Audio::Storage::BigEndianReader;
+
+    std::uint16_t signAndExponent = BigEndianReader::ReadUInt16(data);
+    std::uint64_t mantissa = BigEndianReader::ReadUInt64(data + 2);
+
+    int exponent = static_cast<int>(signAndExponent & 0x7FFF);
+    if((exponent == 0) && (mantissa == 0)) {
+      return 0.0;
+    }
+
+    double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    if((signAndExponent & 0x8000) != 0) {
+      return -value;
+    } else {
+      return value;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a FourCC in a buffer matches the specified characters</summary>
+  /// <param name="buffer">Buffer containing the FourCC that will be checked</param>
+  /// <param name="fourCC">Characters the FourCC will be compared with</param>
+  /// <returns>True if the FourCC matches the specified characters</returns>
+  bool isFourCC(const std::byte *buffer, const char *fourCC) {
+    return std::memcmp(buffer, fourCC, 4) == 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills the stored sample layout from the AIFF-C compression type</summary>
+  /// <param name="compressionType">FourCC of the compression type from the 'COMM' chunk</param>
+  /// <param name="sampleSize">Bits per sample recorded in the 'COMM' chunk</param>
+  /// <param name="layout">Layout that will receive the sample format</param>
+  /// <remarks>
+  ///   Only the compression types that actually store plain, uncompressed samples are
+  ///   supported. The sample size field is ignored for those types that define a fixed
+  ///   sample size, some writers leave it at whatever they happened to put there.
+  /// </remarks>
+  void applyCompressionType(
+    const std::byte *compressionType, std::size_t sampleSize,
+    Nuclex::Audio::Storage::Waveform::StoredSampleLayout &layout
+  ) {
+    if(isFourCC(compressionType, "NONE") || isFourCC(compressionType, "twos")) {
+      layout.Track.BitsPerSample = sampleSize; // Same as in plain AIFF files
+    } else if(isFourCC(compressionType, "sowt")) {
+      layout.Track.BitsPerSample = sampleSize;
+      layout.IsLittleEndian = true;
+    } else if(isFourCC(compressionType, "raw ")) {
+      layout.Track.BitsPerSample = 8;
+      layout.AreBytesSigned = false; // Offset-binary, just like 8-bit Waveform samples
+    } else if(isFourCC(compressionType, "in24")) {
+      layout.Track.BitsPerSample = 24;
+    } else if(isFourCC(compressionType, "23ni")) {
+      layout.Track.BitsPerSample = 24;
+      layout.IsLittleEndian = true;
+    } else if(isFourCC(compressionType, "in32")) {
+      layout.Track.BitsPerSample = 32;
+    } else if(isFourCC(compressionType, "42ni")) {
+      layout.Track.BitsPerSample = 32;
+      layout.IsLittleEndian = true;
+    } else if(isFourCC(compressionType, "fl32") || isFourCC(compressionType, "FL32")) {
+      layout.Track.BitsPerSample = 32;
+      layout.Track.SampleFormat = Nuclex::Audio::AudioSampleFormat::Float_32;
+      return;
+    } else if(isFourCC(compressionType, "fl64") || isFourCC(compressionType, "FL64")) {
+      layout.Track.BitsPerSample = 64;
+      layout.Track.SampleFormat = Nuclex::Audio::AudioSampleFormat::Float_64;
+      return;
+    } else {
+      throw Nuclex::Audio::Errors::UnsupportedFormatError(
+        u8"AIFF-C file uses a compression type that is not supported"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the sample format that can hold integer samples of a bit depth</summary>
+  /// <param name="bitsPerSample">Number of valid bits in each sample</param>
+  /// <returns>The smallest sample format that can hold the samples</returns>
+  Nuclex::Audio::AudioSampleFormat sampleFormatFromBitsPerSample(std::size_t bitsPerSample) {
+    using Nuclex::Audio::AudioSampleFormat;
+
+    if(bitsPerSample >= 25) {
+      return AudioSampleFormat::SignedInteger_32;
+    } else if(bitsPerSample >= 17) {
+      return AudioSampleFormat::SignedInteger_24;
+    } else if(bitsPerSample >= 9) {
+      return AudioSampleFormat::SignedInteger_16;
+    } else {
+      return AudioSampleFormat::UnsignedInteger_8;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<Waveform::StoredSampleLayout> AiffReader::TryReadLayout(
+    const std::shared_ptr<const VirtualFile> &source
+  ) {
+    if(!Detection::CheckIfAiffHeaderPresent(*source)) {
+      return std::optional<Waveform::StoredSampleLayout>();
+    }
+
+    return ReadLayout(source);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Waveform::StoredSampleLayout AiffReader::ReadLayout(
+    const std::shared_ptr<const VirtualFile> &source
+  ) {
+    std::uint64_t fileSize = source->GetSize();
+    if(fileSize < SmallestPossibleAiffSize) {
+      throw Errors::UnsupportedFormatError(u8"File too small to be an AIFF audio file");
+    }
+
+    std::byte header[12];
+    source->ReadAt(0, 12, header);
+    if(!isFourCC(header, "FORM")) {
+      throw Errors::UnsupportedFormatError(u8"File is not an AIFF audio file");
+    }
+
+    bool isAiffC;
+    if(isFourCC(header + 8, "AIFC")) {
+      isAiffC = true;
+    } else if(isFourCC(header + 8, "AIFF")) {
+      isAiffC = false;
+    } else {
+      throw Errors::UnsupportedFormatError(u8"File is not an AIFF audio file");
+    }
+
+    // Like with RIFF, the form size lets us ignore anything appended to the file, but
+    // we don't require it to match since the file might be truncated.
+    {
+      std::uint64_t expectedFileSize = static_cast<std::uint64_t>(
+        BigEndianReader::ReadUInt32(header + 4)
+      ) + 8;
+      if(expectedFileSize < fileSize) {
+        fileSize = expectedFileSize;
+      }
+    }
+
+    Waveform::StoredSampleLayout layout;
+    layout.FormatName = u8"AIFF";
+    layout.IsLittleEndian = false;
+    layout.AreBytesSigned = true;
+    layout.FirstSampleOffset = 0;
+    layout.FrameCount = 0;
+    layout.BytesPerFrame = 0;
+    layout.Track.SampleFormat = AudioSampleFormat::Unknown;
+
+    bool commonChunkFound = false;
+    bool soundDataChunkFound = false;
+    std::uint64_t recordedFrameCount = 0;
+    std::uint64_t soundDataLength = 0;
+
+    // Walk the chunks. The 'COMM' chunk usually comes first, but the specification
+    // allows any order, so the 'SSND' chunk may come before it, too.
+    std::uint64_t readOffset = 12;
+    while(readOffset + 8 <= fileSize) {
+      std::byte chunk[8 + ExtendedCommonChunkLength];
+
+      std::size_t readByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(sizeof(chunk), fileSize - readOffset)
+      );
+      source->ReadAt(readOffset, readByteCount, chunk);
+
+      std::uint64_t chunkLength = BigEndianReader::ReadUInt32(chunk + 4);
+      if(isFourCC(chunk, "COMM")) {
+        std::size_t requiredLength = isAiffC ? ExtendedCommonChunkLength : CommonChunkLength;
+        if(chunkLength < requiredLength) {
+          throw Errors::CorruptedFileError(u8"AIFF audio file contains too short 'COMM' chunk");
+        }
+        if(readByteCount < requiredLength + 8) {
+          throw Errors::CorruptedFileError(u8"AIFF audio file truncated in 'COMM' chunk");
+        }
+
+        layout.Track.ChannelCount = BigEndianReader::ReadUInt16(chunk + 8);
+        recordedFrameCount = BigEndianReader::ReadUInt32(chunk + 10);
+        std::size_t sampleSize = BigEndianReader::ReadUInt16(chunk + 14);
+        double sampleRate = readExtendedFloat(chunk + 16);
+        if((layout.Track.ChannelCount == 0) || !(sampleRate >= 1.0) || (sampleSize == 0)) {
+          throw Errors::CorruptedFileError(
+            u8"AIFF audio file specifies an invalid channel count, sample rate or sample size"
+          );
+        }
+        layout.Track.SampleRate = static_cast<std::size_t>(sampleRate + 0.5);
+
+        layout.Track.SampleFormat = AudioSampleFormat::Unknown;
+        if(isAiffC) {
+          applyCompressionType(chunk + 26, sampleSize, layout);
+        } else {
+          layout.Track.BitsPerSample = sampleSize;
+        }
+        if(layout.Track.SampleFormat == AudioSampleFormat::Unknown) {
+          if(layout.Track.BitsPerSample > 32) {
+            throw Errors::UnsupportedFormatError(
+              u8"AIFF audio file stores integer samples with more than 32 bits"
+            );
+          }
+          layout.Track.SampleFormat = sampleFormatFromBitsPerSample(layout.Track.BitsPerSample);
+        }
+
+        // Samples are stored in the smallest number of bytes that can hold them,
+        // left-justified with the unused low bits set to zero
+        layout.BytesPerFrame = (
+          (layout.Track.BitsPerSample + 7) / 8 * layout.Track.ChannelCount
+        );
+        commonChunkFound = true;
+      } else if(isFourCC(chunk, "SSND")) {
+        if((chunkLength < SoundDataHeaderLength) || (readByteCount < 8 + SoundDataHeaderLength)) {
+          throw Errors::CorruptedFileError(u8"AIFF audio file contains too short 'SSND' chunk");
+        }
+
+        // The offset lets writers align the samples to blocks, which nobody does,
+        // but it has to be honored for the files that do
+        std::uint64_t dataOffset = BigEndianReader::ReadUInt32(chunk + 8);
+        if(chunkLength < SoundDataHeaderLength + dataOffset) {
+          throw Errors::CorruptedFileError(
+            u8"AIFF audio file's sound data offset is outside its 'SSND' chunk"
+          );
+        }
+
+        layout.FirstSampleOffset = readOffset + 8 + SoundDataHeaderLength + dataOffset;
+        soundDataLength = chunkLength - SoundDataHeaderLength - dataOffset;
+        if(layout.FirstSampleOffset > fileSize) {
+          soundDataLength = 0;
+        } else if(fileSize - layout.FirstSampleOffset < soundDataLength) {
+          soundDataLength = fileSize - layout.FirstSampleOffset; // truncated file
+        }
+        soundDataChunkFound = true;
+      }
+
+      // IFF chunks are 16-bit aligned, odd-sized chunks are followed by a padding byte
+      readOffset += 8 + chunkLength + (chunkLength & 1);
+    }
+
+    if(!commonChunkFound || !soundDataChunkFound) {
+      throw Errors::CorruptedFileError(
+        u8"AIFF audio file was missing its 'COMM' or 'SSND' chunk"
+      );
+    }
+
+    // If the file was truncated, only the frames that are actually there can be decoded
+    layout.FrameCount = std::min<std::uint64_t>(
+      recordedFrameCount, soundDataLength / layout.BytesPerFrame
+    );
+
+    layout.Track.CodecName = std::string(u8"AIFF", 4);
+    layout.Track.ChannelPlacements = (
+      Waveform::WaveformParser::GuessChannelPlacement(layout.Track.ChannelCount)
+    );
+    layout.Track.FrameCount = layout.FrameCount;
+    layout.Track.Duration = std::chrono::microseconds(
+      layout.FrameCount * 1'000'000 / layout.Track.SampleRate
+    );
+
+    return layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
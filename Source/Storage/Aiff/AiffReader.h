@@ -0,0 +1,84 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_AIFF_AIFFREADER_H
+#define NUCLEX_AUDIO_STORAGE_AIFF_AIFFREADER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include "../Waveform/WaveformReader.h" // for StoredSampleLayout
+
+#include <optional> // for std::optional
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Utility to read the data structures found in AIFF and AIFF-C files</summary>
+  /// <remarks>
+  ///   <para>
+  ///     AIFF stores uncompressed, interleaved samples just like Waveform files do, only
+  ///     in big endian byte order and with different headers. AIFF-C adds a compression
+  ///     type which most files use to store floating point or little endian samples.
+  ///   </para>
+  ///   <para>
+  ///     This reader only parses the headers. The samples are then read through
+  ///     the <see cref="Waveform.WaveformReader" />, so AIFF files go through the same
+  ///     zero-copy and byte-swapping code paths as big endian Waveform files.
+  ///   </para>
+  /// </remarks>
+  class AiffReader {
+
+    /// <summary>Reads the sample layout from a suspected AIFF file</summary>
+    /// <param name="source">File from which the layout will be read if possible</param>
+    /// <returns>The sample layout if the virtual file was indeed an AIFF file</returns>
+    /// <remarks>
+    ///   If the file does not look like an AIFF file, an empty result is returned.
+    ///   If it is an AIFF file with structural errors or an unsupported compression
+    ///   type, an exception will be thrown still.
+    /// </remarks>
+    public: static std::optional<Waveform::StoredSampleLayout> TryReadLayout(
+      const std::shared_ptr<const VirtualFile> &source
+    );
+
+    /// <summary>Reads the sample layout from an AIFF file</summary>
+    /// <param name="source">File from which the layout will be read</param>
+    /// <returns>The sample layout of the AIFF file</returns>
+    public: static Waveform::StoredSampleLayout ReadLayout(
+      const std::shared_ptr<const VirtualFile> &source
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
+
+#endif // NUCLEX_AUDIO_STORAGE_AIFF_AIFFREADER_H
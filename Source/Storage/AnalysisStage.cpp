@@ -0,0 +1,273 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AnalysisStage.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Processing/LoudnessMeter.h"
+#include "Nuclex/Audio/Processing/ContentHasher.h"
+#include "Nuclex/Audio/TrackInfo.h"
+
+#include <algorithm> // for std::max()
+#include <cmath> // for std::fabs()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::logic_error, std::out_of_range
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AnalysisStage::RequiresWholeTrack() const {
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AnalysisStage::Finish() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakAnalysisStage::PeakAnalysisStage() :
+    peaks() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PeakAnalysisStage::~PeakAnalysisStage() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnalysisStage> PeakAnalysisStage::Start(
+    const TrackInfo &, const AudioTrackDecoder &decoder, std::uint64_t
+  ) const {
+    std::unique_ptr<PeakAnalysisStage> instance = std::make_unique<PeakAnalysisStage>();
+    instance->peaks.resize(decoder.CountChannels(), 0.0f);
+    return instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PeakAnalysisStage::Process(const float *samples, std::size_t frameCount) {
+    std::size_t channelCount = this->peaks.size();
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        float magnitude = std::fabs(*samples);
+        if(magnitude > this->peaks[channelIndex]) {
+          this->peaks[channelIndex] = magnitude;
+        }
+        ++samples;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PeakAnalysisStage::Merge(const AnalysisStage &following) {
+    const PeakAnalysisStage &other = static_cast<const PeakAnalysisStage &>(following);
+    for(std::size_t channelIndex = 0; channelIndex < this->peaks.size(); ++channelIndex) {
+      this->peaks[channelIndex] = std::max(this->peaks[channelIndex], other.peaks[channelIndex]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float PeakAnalysisStage::GetPeak() const {
+    float peak = 0.0f;
+    for(std::size_t channelIndex = 0; channelIndex < this->peaks.size(); ++channelIndex) {
+      peak = std::max(peak, this->peaks[channelIndex]);
+    }
+    return peak;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ClippingAnalysisStage::ClippingAnalysisStage(float threshold /* = 0.999f */) :
+    threshold(threshold),
+    clippedSampleCounts() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ClippingAnalysisStage::~ClippingAnalysisStage() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnalysisStage> ClippingAnalysisStage::Start(
+    const TrackInfo &, const AudioTrackDecoder &decoder, std::uint64_t
+  ) const {
+    std::unique_ptr<ClippingAnalysisStage> instance = (
+      std::make_unique<ClippingAnalysisStage>(this->threshold)
+    );
+    instance->clippedSampleCounts.resize(decoder.CountChannels(), 0);
+    return instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingAnalysisStage::Process(const float *samples, std::size_t frameCount) {
+    std::size_t channelCount = this->clippedSampleCounts.size();
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        if(std::fabs(*samples) >= this->threshold) {
+          ++this->clippedSampleCounts[channelIndex];
+        }
+        ++samples;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ClippingAnalysisStage::Merge(const AnalysisStage &following) {
+    const ClippingAnalysisStage &other = static_cast<const ClippingAnalysisStage &>(following);
+    for(std::size_t index = 0; index < this->clippedSampleCounts.size(); ++index) {
+      this->clippedSampleCounts[index] += other.clippedSampleCounts[index];
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t ClippingAnalysisStage::CountClippedSamples() const {
+    std::uint64_t clippedSampleCount = 0;
+    for(std::size_t index = 0; index < this->clippedSampleCounts.size(); ++index) {
+      clippedSampleCount += this->clippedSampleCounts[index];
+    }
+    return clippedSampleCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHashAnalysisStage::ContentHashAnalysisStage(std::size_t blockFrameCount /* = 0 */) :
+    blockFrameCount(blockFrameCount),
+    hasher() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContentHashAnalysisStage::~ContentHashAnalysisStage() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnalysisStage> ContentHashAnalysisStage::Start(
+    const TrackInfo &, const AudioTrackDecoder &decoder, std::uint64_t startFrame
+  ) const {
+    std::unique_ptr<ContentHashAnalysisStage> instance = (
+      std::make_unique<ContentHashAnalysisStage>(this->blockFrameCount)
+    );
+    instance->hasher = std::make_unique<Processing::ContentHasher>(
+      decoder.CountChannels(), this->blockFrameCount, startFrame
+    );
+    return instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContentHashAnalysisStage::Process(const float *samples, std::size_t frameCount) {
+    this->hasher->ProcessInterleaved(samples, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContentHashAnalysisStage::Merge(const AnalysisStage &following) {
+    const ContentHashAnalysisStage &other = (
+      static_cast<const ContentHashAnalysisStage &>(following)
+    );
+    this->hasher->Merge(*other.hasher);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Processing::ContentHash ContentHashAnalysisStage::GetHash() const {
+    if(!static_cast<bool>(this->hasher)) {
+      return Processing::ContentHasher(1).GetHash();
+    }
+    return this->hasher->GetHash();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ContentHashAnalysisStage::CountBlocks() const {
+    if(!static_cast<bool>(this->hasher)) {
+      return 0;
+    }
+    return this->hasher->CountBlocks();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Processing::ContentHash ContentHashAnalysisStage::GetBlockHash(std::size_t blockIndex) const {
+    if(!static_cast<bool>(this->hasher)) {
+      throw std::out_of_range(u8"Block index is out of range");
+    }
+    return this->hasher->GetBlockHash(blockIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoudnessAnalysisStage::LoudnessAnalysisStage() :
+    meter(),
+    integratedLoudness(-std::numeric_limits<double>::infinity()),
+    truePeakDecibels(-std::numeric_limits<double>::infinity()) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoudnessAnalysisStage::~LoudnessAnalysisStage() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnalysisStage> LoudnessAnalysisStage::Start(
+    const TrackInfo &track, const AudioTrackDecoder &decoder, std::uint64_t
+  ) const {
+    std::unique_ptr<LoudnessAnalysisStage> instance = std::make_unique<LoudnessAnalysisStage>();
+    instance->meter = std::make_unique<Processing::LoudnessMeter>(
+      track.SampleRate, decoder.GetChannelOrder()
+    );
+    return instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool LoudnessAnalysisStage::RequiresWholeTrack() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessAnalysisStage::Process(const float *samples, std::size_t frameCount) {
+    this->meter->ProcessInterleaved(samples, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessAnalysisStage::Merge(const AnalysisStage &) {
+    throw std::logic_error(u8"Loudness analysis requires the whole track in one range");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoudnessAnalysisStage::Finish() {
+    if(static_cast<bool>(this->meter)) {
+      this->integratedLoudness = this->meter->GetIntegratedLoudness();
+      this->truePeakDecibels = this->meter->GetTruePeakDecibels();
+      this->meter.reset();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
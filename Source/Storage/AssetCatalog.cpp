@@ -0,0 +1,376 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "BinarySerialization.h" // for BinaryWriter, BinaryReader
+#include "./EndianReader.h" // for LittleEndianReader
+
+#include <algorithm> // for std::equal()
+#include <cstring> // for std::memcmp()
+#include <iterator> // for std::begin(), std::end()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a file as an asset catalog</summary>
+  const std::byte FileSignature[] = {
+    std::byte(u8'N'), std::byte(u8'A'), std::byte(u8'C'), std::byte(u8'T')
+  };
+
+  /// <summary>Version of the catalog's layout, bumped whenever it changes</summary>
+  const std::uint32_t FileVersion = 4;
+
+  /// <summary>Size of the header preceding the hash table</summary>
+  /// <remarks>
+  ///   Signature, version, number of hash table slots and number of records.
+  /// </remarks>
+  const std::size_t HeaderByteCount = 4 + 4 + 8 + 8;
+
+  /// <summary>Size of a single slot in the hash table</summary>
+  /// <remarks>
+  ///   Each slot holds the hash of a path and the offset of its record, 0 if empty.
+  /// </remarks>
+  const std::size_t SlotByteCount = 8 + 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the hash by which a path is looked up in the catalog</summary>
+  /// <param name="path">Path whose hash will be calculated</param>
+  /// <returns>The 64-bit FNV-1a hash of the path</returns>
+  /// <remarks>
+  ///   The hash is part of the file format, so it must never depend on the platform
+  ///   (which rules out std::hash).
+  /// </remarks>
+  std::uint64_t hashPath(const std::string &path) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for(char character : path) {
+      hash ^= static_cast<std::uint8_t>(character);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an optional floating point value</summary>
+  /// <param name="writer">Writer that collects the catalog</param>
+  /// <param name="value">Optional value that will be written</param>
+  void writeOptionalDouble(
+    Nuclex::Audio::Storage::BinaryWriter &writer, const std::optional<double> &value
+  ) {
+    writer.WriteUInt8(value.has_value() ? 1 : 0);
+    writer.WriteDouble(value.value_or(0.0));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads an optional floating point value</summary>
+  /// <param name="reader">Reader that is going through the catalog</param>
+  /// <returns>The optional value that was read</returns>
+  std::optional<double> readOptionalDouble(Nuclex::Audio::Storage::BinaryReader &reader) {
+    bool hasValue = (reader.ReadUInt8() != 0);
+    double value = reader.ReadDouble();
+    if(hasValue) {
+      return value;
+    } else {
+      return std::optional<double>();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the optional proxy of a file</summary>
+  /// <param name="writer">Writer that collects the catalog</param>
+  /// <param name="proxy">Optional proxy that will be written</param>
+  void writeOptionalProxy(
+    Nuclex::Audio::Storage::BinaryWriter &writer,
+    const std::optional<Nuclex::Audio::Storage::ProxyMapping> &proxy
+  ) {
+    writer.WriteUInt8(proxy.has_value() ? 1 : 0);
+    if(proxy.has_value()) {
+      writer.WriteString(proxy.value().ProxyPath);
+      writer.WriteUInt64(proxy.value().ProxySampleRate);
+      writer.WriteUInt64(proxy.value().ProxyFrameCount);
+      writer.WriteUInt64(proxy.value().MasterSampleRate);
+      writer.WriteUInt64(proxy.value().MasterFrameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the optional proxy of a file</summary>
+  /// <param name="reader">Reader that is going through the catalog</param>
+  /// <returns>The optional proxy that was read</returns>
+  std::optional<Nuclex::Audio::Storage::ProxyMapping> readOptionalProxy(
+    Nuclex::Audio::Storage::BinaryReader &reader
+  ) {
+    if(reader.ReadUInt8() == 0) {
+      return std::optional<Nuclex::Audio::Storage::ProxyMapping>();
+    }
+
+    Nuclex::Audio::Storage::ProxyMapping proxy;
+    proxy.ProxyPath = reader.ReadString();
+    proxy.ProxySampleRate = static_cast<std::size_t>(reader.ReadUInt64());
+    proxy.ProxyFrameCount = reader.ReadUInt64();
+    proxy.MasterSampleRate = static_cast<std::size_t>(reader.ReadUInt64());
+    proxy.MasterFrameCount = reader.ReadUInt64();
+    if(unlikely((proxy.ProxySampleRate == 0) || (proxy.MasterSampleRate == 0))) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(u8"Asset catalog has a damaged proxy");
+    }
+
+    return proxy;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AssetCatalogWriter::Add(const std::string &path, const AssetRecord &record) {
+    this->records[path] = record;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<AssetRecord> AssetCatalogWriter::TryLookup(const std::string &path) const {
+    std::map<std::string, AssetRecord>::const_iterator iterator = this->records.find(path);
+    if(iterator == this->records.end()) {
+      return std::optional<AssetRecord>();
+    } else {
+      return iterator->second;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AssetCatalogWriter::Save(VirtualFile &target) const {
+
+    // Keep the hash table at most half full so probe sequences stay short
+    std::size_t slotCount = 1;
+    while(slotCount < this->records.size() * 2) {
+      slotCount *= 2;
+    }
+
+    BinaryWriter writer;
+    writer.WriteBytes(FileSignature, sizeof(FileSignature));
+    writer.WriteUInt32(FileVersion);
+    writer.WriteUInt64(slotCount);
+    writer.WriteUInt64(this->records.size());
+    writer.Buffer.resize(HeaderByteCount + slotCount * SlotByteCount, std::byte(0));
+
+    // Records follow the hash table. Each one is entered into the table with the offset
+    // at which it begins, resolving collisions by linear probing.
+    for(const std::pair<const std::string, AssetRecord> &pathAndRecord : this->records) {
+      std::uint64_t hash = hashPath(pathAndRecord.first);
+      std::size_t slotIndex = static_cast<std::size_t>(hash) & (slotCount - 1);
+      for(;;) {
+        std::size_t slotOffset = HeaderByteCount + slotIndex * SlotByteCount;
+        if(LittleEndianReader::ReadUInt64(writer.Buffer.data() + slotOffset + 8) == 0) {
+          writer.PatchUInt64(slotOffset, hash);
+          writer.PatchUInt64(slotOffset + 8, writer.Buffer.size());
+          break;
+        }
+        slotIndex = (slotIndex + 1) & (slotCount - 1);
+      }
+
+      // The parts needed for info lookups come first, then the large blobs
+      const AssetRecord &record = pathAndRecord.second;
+      writer.WriteString(pathAndRecord.first);
+      writer.WriteUInt64(record.Size);
+      writer.WriteUInt64(record.ModificationTime);
+      writer.WriteUInt8(record.Info.has_value() ? 1 : 0);
+      if(record.Info.has_value()) {
+        writer.WriteContainerInfo(record.Info.value());
+      }
+      writeOptionalDouble(writer, record.IntegratedLoudness);
+      writeOptionalDouble(writer, record.TruePeak);
+      writeOptionalProxy(writer, record.Proxy);
+      writer.WriteBlob(record.SeekIndex);
+      writer.WriteBlob(record.PeakPyramid);
+    }
+
+    target.WriteAt(0, writer.Buffer.size(), writer.Buffer.data());
+    target.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const AssetCatalog> AssetCatalog::Open(const std::string &path) {
+    return std::make_shared<AssetCatalog>(
+      VirtualFile::OpenRealFileForReading(path, FileAccessPattern::Random, true)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AssetCatalog::AssetCatalog(const std::shared_ptr<const VirtualFile> &file) :
+    file(file),
+    contents(),
+    data(nullptr),
+    length(static_cast<std::size_t>(file->GetSize())),
+    slotCount(0),
+    recordCount(0) {
+
+    this->data = file->TryBorrowAt(0, this->length);
+    if(this->data == nullptr) {
+      this->contents.resize(this->length);
+      file->ReadAt(0, this->length, this->contents.data());
+      this->data = this->contents.data();
+    }
+
+    bool hasSignature = (
+      (this->length >= HeaderByteCount) &&
+      std::equal(std::begin(FileSignature), std::end(FileSignature), this->data)
+    );
+    if(unlikely(!hasSignature)) {
+      throw Errors::CorruptedFileError(u8"File is not an asset catalog");
+    }
+
+    BinaryReader reader(this->data, this->length, sizeof(FileSignature));
+    if(unlikely(reader.ReadUInt32() != FileVersion)) {
+      throw Errors::CorruptedFileError(u8"Asset catalog has unknown version");
+    }
+
+    std::uint64_t slotCount = reader.ReadUInt64();
+    std::uint64_t recordCount = reader.ReadUInt64();
+    bool isValidTable = (
+      (slotCount > 0) &&
+      ((slotCount & (slotCount - 1)) == 0) &&
+      (slotCount <= (this->length - HeaderByteCount) / SlotByteCount)
+    );
+    if(unlikely(!isValidTable)) {
+      throw Errors::CorruptedFileError(u8"Asset catalog has a damaged hash table");
+    }
+
+    this->slotCount = static_cast<std::size_t>(slotCount);
+    this->recordCount = static_cast<std::size_t>(recordCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AssetCatalog::~AssetCatalog() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<AssetRecord> AssetCatalog::TryLookup(const std::string &path) const {
+    std::size_t recordOffset = findRecord(path);
+    if(recordOffset == 0) {
+      return std::optional<AssetRecord>();
+    }
+
+    BinaryReader reader(this->data, this->length, recordOffset);
+
+    AssetRecord record;
+    record.Size = reader.ReadUInt64();
+    record.ModificationTime = reader.ReadUInt64();
+    if(reader.ReadUInt8() != 0) {
+      record.Info = reader.ReadContainerInfo();
+    }
+    record.IntegratedLoudness = readOptionalDouble(reader);
+    record.TruePeak = readOptionalDouble(reader);
+    record.Proxy = readOptionalProxy(reader);
+    record.SeekIndex = reader.ReadBlob();
+    record.PeakPyramid = reader.ReadBlob();
+
+    return record;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AssetCatalog::TryLookupInfo(
+    const std::string &path,
+    std::uint64_t size,
+    std::uint64_t modificationTime,
+    std::optional<ContainerInfo> &info
+  ) const {
+    std::size_t recordOffset = findRecord(path);
+    if(recordOffset == 0) {
+      return false;
+    }
+
+    BinaryReader reader(this->data, this->length, recordOffset);
+    if(reader.ReadUInt64() != size) {
+      return false;
+    }
+    if(reader.ReadUInt64() != modificationTime) {
+      return false;
+    }
+
+    if(reader.ReadUInt8() != 0) {
+      info = reader.ReadContainerInfo();
+    } else {
+      info.reset();
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AssetCatalog::findRecord(const std::string &path) const {
+    std::uint64_t hash = hashPath(path);
+
+    // The writer keeps the table at most half full, but a damaged file might not,
+    // so give up after visiting each slot once
+    std::size_t slotIndex = static_cast<std::size_t>(hash) & (this->slotCount - 1);
+    for(std::size_t probeCount = 0; probeCount < this->slotCount; ++probeCount) {
+      const std::byte *slot = this->data + HeaderByteCount + slotIndex * SlotByteCount;
+      std::uint64_t recordOffset = LittleEndianReader::ReadUInt64(slot + 8);
+      if(recordOffset == 0) {
+        return 0;
+      }
+
+      if(LittleEndianReader::ReadUInt64(slot) == hash) {
+        if(unlikely(recordOffset >= this->length)) {
+          throw Errors::CorruptedFileError(u8"Asset catalog has a damaged hash table");
+        }
+
+        BinaryReader reader(this->data, this->length, static_cast<std::size_t>(recordOffset));
+        std::size_t pathLength = reader.ReadUInt32();
+        std::size_t pathOffset = static_cast<std::size_t>(recordOffset) + 4;
+        reader.Skip(pathLength);
+
+        bool isMatch = (
+          (pathLength == path.length()) &&
+          (std::memcmp(this->data + pathOffset, path.data(), pathLength) == 0)
+        );
+        if(isMatch) {
+          return pathOffset + pathLength;
+        }
+      }
+
+      slotIndex = (slotIndex + 1) & (this->slotCount - 1);
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
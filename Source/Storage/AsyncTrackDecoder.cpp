@@ -0,0 +1,199 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AsyncTrackDecoder.h"
+
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct AsyncTrackDecoder::State {
+
+    /// <summary>Decoding call waiting in the queue</summary>
+    public: struct Call {
+
+      /// <summary>Method that runs the decoding call</summary>
+      public: std::function<void(const AudioTrackDecoder &)> Decode;
+      /// <summary>Callback that will be invoked when decoding finished</summary>
+      public: CompletionCallback Completion;
+
+    };
+
+    /// <summary>Runs the oldest queued call and schedules the next one</summary>
+    /// <param name="self">Shared pointer to the state, kept alive by the task</param>
+    /// <remarks>
+    ///   Only one call runs per task so that decoders with long queues don't keep
+    ///   a worker to themselves while other decoders are waiting.
+    /// </remarks>
+    public: static void RunNextCall(const std::shared_ptr<State> &self);
+
+    /// <summary>Schedules a task on the executor that will run the next queued call</summary>
+    /// <param name="self">Shared pointer to the state, kept alive by the task</param>
+    public: static void SubmitNextCall(const std::shared_ptr<State> &self) {
+      self->Executor->Submit([self]() { RunNextCall(self); });
+    }
+
+    /// <summary>Decoder that is running the calls</summary>
+    public: std::shared_ptr<AudioTrackDecoder> Decoder;
+    /// <summary>Executor on which the calls run</summary>
+    public: std::shared_ptr<Audio::Executor> Executor;
+    /// <summary>Must be held while accessing the queue</summary>
+    public: std::mutex QueueMutex;
+    /// <summary>Calls that haven't completed yet, the first one may be running</summary>
+    public: std::deque<Call> Queue;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncTrackDecoder::State::RunNextCall(const std::shared_ptr<State> &self) {
+    for(;;) {
+      Call call;
+      {
+        std::lock_guard<std::mutex> queueMutexScope(self->QueueMutex);
+        call = std::move(self->Queue.front());
+      }
+
+      std::exception_ptr error;
+      try {
+        call.Decode(*self->Decoder);
+      }
+      catch(...) {
+        error = std::current_exception();
+      }
+      if(static_cast<bool>(call.Completion)) {
+        try {
+          call.Completion(error);
+        }
+        catch(...) {} // Documented, the executor's worker must not be taken down
+      }
+
+      // The call stays in the queue until it has completed so that new calls can
+      // tell whether a task is already taking care of the queue
+      {
+        std::lock_guard<std::mutex> queueMutexScope(self->QueueMutex);
+        self->Queue.pop_front();
+        if(self->Queue.empty()) {
+          return;
+        }
+      }
+
+      // More calls are queued, give other tasks a chance before running them. If the
+      // executor refuses the task, the calls are run right here instead.
+      try {
+        SubmitNextCall(self);
+        return;
+      }
+      catch(...) {}
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncTrackDecoder::AsyncTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::shared_ptr<Executor> &executor /* = Executor::GetInstalled() */
+  ) :
+    state(std::make_shared<State>()) {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Asynchronous decoder requires a decoder to run");
+    }
+    if(unlikely(!static_cast<bool>(executor))) {
+      throw std::invalid_argument(u8"Asynchronous decoder requires an executor");
+    }
+
+    this->state->Decoder = decoder;
+    this->state->Executor = executor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncTrackDecoder::~AsyncTrackDecoder() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::shared_ptr<AudioTrackDecoder> &AsyncTrackDecoder::GetDecoder() const {
+    return this->state->Decoder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AsyncTrackDecoder::CountQueuedCalls() const {
+    std::lock_guard<std::mutex> queueMutexScope(this->state->QueueMutex);
+    return this->state->Queue.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncTrackDecoder::enqueue(
+    std::function<void(const AudioTrackDecoder &)> decode, CompletionCallback completion
+  ) {
+    {
+      std::lock_guard<std::mutex> queueMutexScope(this->state->QueueMutex);
+      this->state->Queue.push_back(State::Call { std::move(decode), std::move(completion) });
+
+      // If calls were already queued, the task running them will get to this one, too
+      if(this->state->Queue.size() >= 2) {
+        return;
+      }
+    }
+
+    // If the executor refuses the task, the call is run on the calling thread. Other
+    // threads may have queued calls behind it already, so it can't just be dropped.
+    try {
+      State::SubmitNextCall(this->state);
+    }
+    catch(...) {
+      State::RunNextCall(this->state);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> AsyncTrackDecoder::enqueue(
+    std::function<void(const AudioTrackDecoder &)> decode
+  ) {
+    std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+
+    enqueue(
+      std::move(decode),
+      [promise](std::exception_ptr error) {
+        if(static_cast<bool>(error)) {
+          promise->set_exception(error);
+        } else {
+          promise->set_value();
+        }
+      }
+    );
+
+    return future;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
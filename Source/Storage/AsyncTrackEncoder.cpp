@@ -0,0 +1,279 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AsyncTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <chrono> // for std::chrono::milliseconds
+#include <stdexcept> // for std::invalid_argument, std::logic_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How long the background thread sleeps when it has nothing to do</summary>
+  /// <remarks>
+  ///   The caller wakes the background thread up when it submits a buffer, but it does
+  ///   so without taking the mutex, so a wake-up can be missed. The timeout makes sure
+  ///   the background thread notices anyway.
+  /// </remarks>
+  const std::chrono::milliseconds IdleTimeout(5);
+
+  /// <summary>How long EncodeInterleaved() sleeps while waiting for a free buffer</summary>
+  const std::chrono::milliseconds FreeBufferPollInterval(1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncTrackEncoder::AsyncTrackEncoder(
+    const std::shared_ptr<AudioTrackEncoder> &encoder,
+    std::size_t bufferCount /* = 8 */,
+    std::size_t bufferFrameCount /* = 4096 */
+  ) :
+    encoder(encoder),
+    channelCount(0),
+    bufferCount(bufferCount),
+    bufferFrameCount(bufferFrameCount),
+    samples(),
+    frameCounts(),
+    submittedBufferCount(0),
+    encodedBufferCount(0),
+    flushRequested(false),
+    failed(false),
+    stopping(false),
+    error(),
+    flushed(),
+    wakeMutex(),
+    wakeCondition(),
+    encodeThread() {
+
+    if(unlikely(!static_cast<bool>(encoder))) {
+      throw std::invalid_argument(u8"Asynchronous encoder requires an encoder to run");
+    }
+    if(unlikely((bufferCount == 0) || (bufferFrameCount == 0))) {
+      throw std::invalid_argument(u8"Asynchronous encoder needs at least one buffer frame");
+    }
+
+    this->channelCount = encoder->GetChannelOrder().size();
+    this->samples.reset(new float[bufferCount * bufferFrameCount * this->channelCount]);
+    this->frameCounts.reset(new std::size_t[bufferCount]);
+
+    this->encodeThread = std::thread(&AsyncTrackEncoder::encodeQueuedBuffers, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncTrackEncoder::~AsyncTrackEncoder() {
+    {
+      std::lock_guard<std::mutex> wakeMutexScope(this->wakeMutex);
+      this->stopping.store(true, std::memory_order_relaxed);
+    }
+    this->wakeCondition.notify_one();
+    this->encodeThread.join();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AsyncTrackEncoder::CountQueuedBuffers() const {
+    std::uint64_t encoded = this->encodedBufferCount.load(std::memory_order_acquire);
+    std::uint64_t submitted = this->submittedBufferCount.load(std::memory_order_relaxed);
+    return static_cast<std::size_t>(submitted - encoded);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AsyncTrackEncoder::TryEncodeInterleaved(const float *buffer, std::size_t frameCount) {
+    float *target = tryClaimBuffer(frameCount);
+    if(target == nullptr) {
+      return false;
+    }
+
+    std::copy_n(buffer, frameCount * this->channelCount, target);
+    submitBuffer();
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AsyncTrackEncoder::TryEncodeSeparated(const float *buffers[], std::size_t frameCount) {
+    float *target = tryClaimBuffer(frameCount);
+    if(target == nullptr) {
+      return false;
+    }
+
+    Processing::Interleaver::Interleave(buffers, target, this->channelCount, frameCount);
+    submitBuffer();
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncTrackEncoder::EncodeInterleaved(const float *buffer, std::size_t frameCount) {
+    if(unlikely(this->flushRequested.load(std::memory_order_relaxed))) {
+      throw std::logic_error(u8"Samples can not be encoded after flushing the encoder");
+    }
+
+    while(frameCount > 0) {
+      if(unlikely(this->failed.load(std::memory_order_acquire))) {
+        std::rethrow_exception(this->error);
+      }
+
+      std::size_t chunkFrameCount = std::min(frameCount, this->bufferFrameCount);
+      float *target = tryClaimBuffer(chunkFrameCount);
+      if(target == nullptr) {
+        std::this_thread::sleep_for(FreeBufferPollInterval);
+        continue;
+      }
+
+      std::copy_n(buffer, chunkFrameCount * this->channelCount, target);
+      submitBuffer();
+
+      buffer += chunkFrameCount * this->channelCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> AsyncTrackEncoder::Flush() {
+    if(unlikely(this->flushRequested.load(std::memory_order_relaxed))) {
+      throw std::logic_error(u8"The encoder has already been flushed");
+    }
+
+    std::future<void> result = this->flushed.get_future();
+    this->flushRequested.store(true, std::memory_order_release);
+    this->wakeCondition.notify_one();
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float *AsyncTrackEncoder::tryClaimBuffer(std::size_t frameCount) {
+
+    // None of these is worth an exception, because exceptions would allocate and
+    // the caller is likely on a thread that must not stall
+    if(unlikely(frameCount > this->bufferFrameCount)) {
+      return nullptr;
+    }
+    if(unlikely(this->flushRequested.load(std::memory_order_relaxed))) {
+      return nullptr;
+    }
+    if(unlikely(this->failed.load(std::memory_order_relaxed))) {
+      return nullptr;
+    }
+
+    // The buffers are used round-robin, a buffer is free again once the background
+    // thread has encoded it, so all we need are the two counters
+    std::uint64_t submitted = this->submittedBufferCount.load(std::memory_order_relaxed);
+    std::uint64_t encoded = this->encodedBufferCount.load(std::memory_order_acquire);
+    if(submitted - encoded >= this->bufferCount) {
+      return nullptr;
+    }
+
+    std::size_t bufferIndex = static_cast<std::size_t>(submitted % this->bufferCount);
+    this->frameCounts[bufferIndex] = frameCount;
+    return this->samples.get() + (bufferIndex * this->bufferFrameCount * this->channelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncTrackEncoder::submitBuffer() {
+    this->submittedBufferCount.fetch_add(1, std::memory_order_release);
+    this->wakeCondition.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncTrackEncoder::encodeQueuedBuffers() {
+    std::uint64_t encoded = 0;
+
+    for(;;) {
+
+      // Check the flush flag before the submission counter. The caller submits its last
+      // buffer before it requests the flush, so if we see the request, we also see
+      // all buffers that were submitted ahead of it.
+      bool isFlushRequested = this->flushRequested.load(std::memory_order_acquire);
+      std::uint64_t submitted = this->submittedBufferCount.load(std::memory_order_acquire);
+
+      if(encoded < submitted) {
+        std::size_t bufferIndex = static_cast<std::size_t>(encoded % this->bufferCount);
+
+        // After a failure, buffers are only skipped so the queue doesn't block
+        if(!this->failed.load(std::memory_order_relaxed)) {
+          try {
+            this->encoder->EncodeInterleaved(
+              this->samples.get() + (bufferIndex * this->bufferFrameCount * this->channelCount),
+              this->frameCounts[bufferIndex]
+            );
+          }
+          catch(...) {
+            this->error = std::current_exception();
+            this->failed.store(true, std::memory_order_release);
+          }
+        }
+
+        ++encoded;
+        this->encodedBufferCount.store(encoded, std::memory_order_release);
+        continue;
+      }
+
+      if(isFlushRequested) {
+        if(!this->failed.load(std::memory_order_relaxed)) {
+          try {
+            this->encoder->Flush();
+          }
+          catch(...) {
+            this->error = std::current_exception();
+            this->failed.store(true, std::memory_order_release);
+          }
+        }
+
+        if(this->failed.load(std::memory_order_relaxed)) {
+          this->flushed.set_exception(this->error);
+        } else {
+          this->flushed.set_value();
+        }
+
+        return; // The stream has ended, nothing will be submitted anymore
+      }
+
+      // Nothing to do? Then sleep until the caller submits a buffer or we're stopped
+      std::unique_lock<std::mutex> wakeMutexScope(this->wakeMutex);
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        return;
+      }
+      this->wakeCondition.wait_for(wakeMutexScope, IdleTimeout);
+
+    } // for ever
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
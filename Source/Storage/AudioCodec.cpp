@@ -29,6 +29,12 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool AudioCodec::IsSignaturePresent(const std::byte *, std::size_t) const {
+    return false; // Default, codecs can override this to allow detection by signature
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   bool AudioCodec::CanEncode() const {
     return false; // Default, implementation needs to override if it supports encoding
   }
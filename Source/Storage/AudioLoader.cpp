@@ -22,10 +22,19 @@ License along with this library
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/Track.h"
 #include "Nuclex/Audio/Storage/VirtualFile.h"
 #include "Nuclex/Audio/Storage/AudioCodec.h"
+#include "Nuclex/Audio/Storage/ContainerInfoCache.h"
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 
+#include "HeaderBufferedFile.h"
+#include "PlaylistTrackDecoder.h"
+
 // Also include the headers for the build-in audio codecs.
 //
 // This library is designed such that a new instance of the AudioLoader class will have
@@ -45,12 +54,28 @@ License along with this library
 #if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
 #include "WavPack/WavPackAudioCodec.h"
 #endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+#include "Matroska/MatroskaAudioCodec.h"
+#endif
 // Always present, needs no toggleable third-party library
 #include "Waveform/WaveformAudioCodec.h"
+#include "Aiff/AiffAudioCodec.h"
 
 #include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
 
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsFileApi.h" // for WindowsFileApi
+#else
+#include "../Platform/PosixFileApi.h" // for PosixFileApi
+#endif
+
+#include <algorithm> // for std::min(), std::max()
+#include <chrono> // for std::chrono::steady_clock
+#include <future> // for std::promise
+#include <mutex> // for std::mutex
 #include <stdexcept> // for std::runtime_error
+#include <thread> // for std::thread
+#include <vector> // for std::vector
 
 namespace {
 
@@ -59,6 +84,59 @@ namespace {
   /// <summary>Invalid size marker for the most recent codec indices</summary>
   constexpr std::size_t InvalidIndex = std::size_t(-1);
 
+  /// <summary>Number of bytes from the file's beginning codecs check signatures in</summary>
+  constexpr std::size_t SignatureByteCount = 64;
+
+  /// <summary>Number of distinct file extensions success statistics are kept for</summary>
+  /// <remarks>
+  ///   This merely prevents the statistics from growing without bounds when an application
+  ///   throws files with lots of random or made-up extensions at the audio loader.
+  /// </remarks>
+  constexpr std::size_t MaximumTrackedExtensionCount = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Everything known about how likely a codec is able to load a file</summary>
+  struct CodecLikelihood {
+
+    /// <summary>Index of the codec in the audio loader's codec list</summary>
+    public: std::size_t CodecIndex;
+    /// <summary>Whether the codec recognized its signature in the file header</summary>
+    public: bool IsSignatureMatch;
+    /// <summary>Number of files the codec loaded after recognizing its signature</summary>
+    public: std::size_t SignatureHitCount;
+    /// <summary>Number of files with the same extension the codec loaded</summary>
+    public: std::size_t ExtensionSuccessCount;
+    /// <summary>Whether the codec registered itself for the file's extension</summary>
+    public: bool IsRegisteredForExtension;
+    /// <summary>0 for the most recently used codec, 1 for the one before, else 2</summary>
+    public: std::size_t RecencyRank;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether one codec is more likely to load a file than another</summary>
+  /// <param name="left">Likelihood of the first codec that will be compared</param>
+  /// <param name="right">Likelihood of the second codec that will be compared</param>
+  /// <returns>True if the first codec should be tried before the second one</returns>
+  bool isMoreLikely(const CodecLikelihood &left, const CodecLikelihood &right) {
+    if(left.IsSignatureMatch != right.IsSignatureMatch) {
+      return left.IsSignatureMatch;
+    }
+    if(left.IsSignatureMatch && (left.SignatureHitCount != right.SignatureHitCount)) {
+      return (left.SignatureHitCount > right.SignatureHitCount);
+    }
+    if(left.ExtensionSuccessCount != right.ExtensionSuccessCount) {
+      return (left.ExtensionSuccessCount > right.ExtensionSuccessCount);
+    }
+    if(left.IsRegisteredForExtension != right.IsRegisteredForExtension) {
+      return left.IsRegisteredForExtension;
+    }
+
+    return (left.RecencyRank < right.RecencyRank);
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Helper used to pass information through lambda methods</summary>
@@ -89,30 +167,252 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Decodes all samples of an audio track into a new in-memory track</summary>
+  /// <param name="decoder">Decoder through which the samples will be read</param>
+  /// <param name="info">Informations about the audio file the decoder is reading</param>
+  /// <param name="layout">How the samples of the channels will be arranged</param>
+  /// <param name="threadCount">Maximum number of threads decoding may use</param>
+  /// <returns>An audio track holding all samples the decoder delivered</returns>
+  Nuclex::Audio::Track decodeIntoTrack(
+    const std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> &decoder,
+    const std::optional<Nuclex::Audio::ContainerInfo> &info,
+    Nuclex::Audio::SampleLayout layout,
+    std::size_t threadCount
+  ) {
+    using Nuclex::Audio::Storage::AudioTrackDecoder;
+
+    std::size_t sampleRate = 0;
+    if(info.has_value() && (info.value().DefaultTrackIndex < info.value().Tracks.size())) {
+      sampleRate = info.value().Tracks[info.value().DefaultTrackIndex].SampleRate;
+    }
+
+    // The track allocates exactly the memory the decoder's frame count calls for,
+    // so all that's left is for the decoder to fill it without any intermediate copies
+    std::size_t channelCount = decoder->CountChannels();
+    Nuclex::Audio::Track track(
+      channelCount, decoder->CountFrames(), sampleRate, layout, decoder->GetChannelOrder()
+    );
+
+    std::size_t frameCount = track.CountFrames();
+    if(frameCount > 0) {
+      if(layout == Nuclex::Audio::SampleLayout::Separated) {
+        std::vector<float *> channelStarts(channelCount);
+        for(std::size_t index = 0; index < channelCount; ++index) {
+          channelStarts[index] = track.GetSamples() + index * track.GetChannelSpacing();
+        }
+
+        std::shared_ptr<AudioTrackDecoder> parallelDecoder = (
+          AudioTrackDecoder::CreateParallel(decoder, threadCount)
+        );
+        parallelDecoder->DecodeSeparated<float>(channelStarts.data(), 0, frameCount);
+      } else {
+        AudioTrackDecoder::DecodeAllParallel<float>(decoder, track.GetSamples(), threadCount);
+      }
+    }
+
+    return track;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a number of steady clock ticks into nanoseconds</summary>
+  /// <param name="ticks">Number of steady clock ticks that will be converted</param>
+  /// <returns>The equivalent number of nanoseconds</returns>
+  std::chrono::nanoseconds nanosecondsFromTicks(std::uint64_t ticks) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::duration(static_cast<std::chrono::steady_clock::rep>(ticks))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts a lookup and the time it took when the scope is left</summary>
+  /// <remarks>
+  ///   Lookups that end in an exception are counted, too, since a codec choking on
+  ///   a damaged file is just the kind of slow open statistics should reveal.
+  /// </remarks>
+  class LookupStopwatch {
+
+    /// <summary>Initializes a new stopwatch, starting it if enabled</summary>
+    /// <param name="isEnabled">Whether anything should be recorded at all</param>
+    /// <param name="count">Counter that will be incremented when the scope ends</param>
+    /// <param name="ticks">Receives the elapsed steady clock ticks when the scope ends</param>
+    public: LookupStopwatch(
+      bool isEnabled, std::atomic<std::uint64_t> &count, std::atomic<std::uint64_t> &ticks
+    ) :
+      isEnabled(isEnabled),
+      count(count),
+      ticks(ticks),
+      startTime() {
+      if(isEnabled) {
+        this->startTime = std::chrono::steady_clock::now();
+      }
+    }
+
+    /// <summary>Records the lookup if the stopwatch is enabled</summary>
+    public: ~LookupStopwatch() {
+      if(this->isEnabled) {
+        std::chrono::steady_clock::duration elapsed = (
+          std::chrono::steady_clock::now() - this->startTime
+        );
+        this->count.fetch_add(1, std::memory_order_relaxed);
+        this->ticks.fetch_add(
+          static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed
+        );
+      }
+    }
+
+    /// <summary>Whether the stopwatch records anything</summary>
+    private: bool isEnabled;
+    /// <summary>Counter that will be incremented when the scope ends</summary>
+    private: std::atomic<std::uint64_t> &count;
+    /// <summary>Receives the elapsed steady clock ticks when the scope ends</summary>
+    private: std::atomic<std::uint64_t> &ticks;
+    /// <summary>Time at which the lookup began</summary>
+    private: std::chrono::steady_clock::time_point startTime;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size and modification time identifying a file's contents</summary>
+  /// <param name="path">Path of the file whose identity will be looked up</param>
+  /// <param name="size">Receives the size of the file in bytes</param>
+  /// <param name="modificationTime">Receives the file's last modification time</param>
+  /// <returns>True if the file exists and could be looked up</returns>
+  bool tryGetFileIdentity(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    return Nuclex::Audio::Platform::WindowsFileApi::TryGetFileAttributes(
+      path, size, modificationTime
+    );
+#else
+    return Nuclex::Audio::Platform::PosixFileApi::TryStatFile(path, size, modificationTime);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Immutable snapshot of the registered codecs</summary>
+  /// <remarks>
+  ///   A snapshot is never modified after it has been published. Registering a codec
+  ///   copies the current snapshot, appends the codec and publishes the copy, so codec
+  ///   indices remain stable across snapshots and the statistics keep lining up.
+  /// </remarks>
+  struct AudioLoader::CodecRegistry {
+
+    /// <summary>Codecs in the order they were registered</summary>
+    public: CodecVector Codecs;
+    /// <summary>Allows the audio loader to look up a codec by its file extension</summary>
+    /// <remarks>
+    ///   Extensions are stored in UTF-8 folded lowercase for case insensitivity.
+    /// </remarks>
+    public: ExtensionCodecIndexMap CodecsByExtension;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counters recording how codecs were probed, if enabled</summary>
+  struct AudioLoader::StatisticsCounters {
+
+    /// <summary>Initializes all counters to zero with recording disabled</summary>
+    public: StatisticsCounters() :
+      IsEnabled(false),
+      InfoReadCount(0),
+      InfoReadTicks(0),
+      OpenCount(0),
+      OpenTicks(0),
+      DetectionTicks(0),
+      FirstGuessHitCount(0),
+      MostRecentCodecHitCount(0),
+      SecondMostRecentCodecHitCount(0),
+      UnsupportedCount(0),
+      Codecs() {}
+
+    /// <summary>Whether statistics are currently being recorded</summary>
+    public: std::atomic<bool> IsEnabled;
+    /// <summary>Number of times codecs were asked to read informations</summary>
+    public: std::atomic<std::uint64_t> InfoReadCount;
+    /// <summary>Time spent reading informations, in ticks of the steady clock</summary>
+    public: std::atomic<std::uint64_t> InfoReadTicks;
+    /// <summary>Number of times codecs were asked to open a decoder</summary>
+    public: std::atomic<std::uint64_t> OpenCount;
+    /// <summary>Time spent opening decoders, in ticks of the steady clock</summary>
+    public: std::atomic<std::uint64_t> OpenTicks;
+    /// <summary>Time spent ranking the codecs, in ticks of the steady clock</summary>
+    public: std::atomic<std::uint64_t> DetectionTicks;
+    /// <summary>Number of lookups in which the first codec asked succeeded</summary>
+    public: std::atomic<std::uint64_t> FirstGuessHitCount;
+    /// <summary>Lookups answered by the most recently used codec</summary>
+    public: std::atomic<std::uint64_t> MostRecentCodecHitCount;
+    /// <summary>Lookups answered by the second-most recently used codec</summary>
+    public: std::atomic<std::uint64_t> SecondMostRecentCodecHitCount;
+    /// <summary>Number of lookups no codec was able to handle</summary>
+    public: std::atomic<std::uint64_t> UnsupportedCount;
+    /// <summary>Probe statistics of each codec, protected by the statistics mutex</summary>
+    /// <remarks>
+    ///   The codec names are left empty in here and filled in when a snapshot is taken.
+    /// </remarks>
+    public: std::vector<CodecProbeStatistics> Codecs;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   AudioLoader::AudioLoader() :
-    codecsByExtension(),
-    codecs(),
+    registrationMutex(),
+    registry(),
     mostRecentCodecIndex(InvalidIndex),
-    secondMostRecentCodecIndex(InvalidIndex) {
+    secondMostRecentCodecIndex(InvalidIndex),
+    statisticsMutex(),
+    successCountsByExtension(),
+    signatureHitCounts(),
+    statistics(std::make_unique<StatisticsCounters>()),
+    readAheadBlockSize(0),
+    readAheadBlockCount(0),
+    infoCache(),
+    assetCatalog() {
+    std::shared_ptr<CodecRegistry> initialRegistry = std::make_shared<CodecRegistry>();
+    CodecVector &codecs = initialRegistry->Codecs;
+
+    // Audio loaders are created at startup by every tool using this library, so this
+    // should be as cheap as possible. The codecs do not touch their third-party libraries
+    // until they're asked to open a file and their extension lists are static strings.
+    // The built-in codecs are all distinct types, too, so they do not need to be checked
+    // against each other like in RegisterCodec().
 #if defined(NUCLEX_AUDIO_HAVE_FLAC)
-    RegisterCodec(std::make_unique<Flac::FlacAudioCodec>());
+    codecs.push_back(std::make_shared<Flac::FlacAudioCodec>());
 #endif
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
-    RegisterCodec(std::make_unique<Opus::OpusAudioCodec>());
+    codecs.push_back(std::make_shared<Opus::OpusAudioCodec>());
 #endif
 #if defined(NUCLEX_AUDIO_HAVE_VORBIS)
-    RegisterCodec(std::make_unique<Vorbis::VorbisAudioCodec>());
+    codecs.push_back(std::make_shared<Vorbis::VorbisAudioCodec>());
 #endif
 #if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
-    RegisterCodec(std::make_unique<WavPack::WavPackAudioCodec>());
+    codecs.push_back(std::make_shared<WavPack::WavPackAudioCodec>());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    codecs.push_back(std::make_shared<Matroska::MatroskaAudioCodec>());
 #endif
-    RegisterCodec(std::make_unique<Waveform::WaveformAudioCodec>());
+    codecs.push_back(std::make_shared<Waveform::WaveformAudioCodec>());
+    codecs.push_back(std::make_shared<Aiff::AiffAudioCodec>());
+
+    std::size_t codecCount = codecs.size();
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      addFileExtensions(*initialRegistry, index);
+    }
+
+    // No other thread can see the audio loader yet, so a plain assignment is fine here
+    this->registry = std::move(initialRegistry);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -122,26 +422,50 @@ namespace Nuclex { namespace Audio { namespace Storage {
   // ------------------------------------------------------------------------------------------- //
 
   void AudioLoader::RegisterCodec(std::unique_ptr<AudioCodec> &&codec) {
-    std::size_t codecCount = this->codecs.size();
 
     // This should be a one-liner, but clang has a nonsensical warning then typeid()
     // is called with an expression that needs to be evaluated at runtime :-(
     const AudioCodec &newCodec = *codec.get();
     const std::type_info &newType = typeid(newCodec);
 
+    // Registrations are serialized among each other, but lookups on other threads carry
+    // on with the snapshot they already hold while the new snapshot is being assembled.
+    std::lock_guard<std::mutex> registrationScope(this->registrationMutex);
+    std::shared_ptr<const CodecRegistry> currentRegistry = getRegistry();
+
     // Make sure this exact type isn't registered yet
+    std::size_t codecCount = currentRegistry->Codecs.size();
     for(std::size_t index = 0; index < codecCount; ++index) {
-      const AudioCodec &checkedCodec = *this->codecs[index].get();
+      const AudioCodec &checkedCodec = *currentRegistry->Codecs[index].get();
       const std::type_info &existingType = typeid(checkedCodec);
       if(newType == existingType) {
         throw std::runtime_error(u8"Codec already registered");
       }
     }
 
-    const std::vector<std::string> &extensions = codec->GetFileExtensions();
+    // Copy the current snapshot and append the new codec. The codecs themselves are
+    // shared between the snapshots, only the vector and the extension map are copied.
+    std::shared_ptr<CodecRegistry> newRegistry = std::make_shared<CodecRegistry>(
+      *currentRegistry
+    );
+    newRegistry->Codecs.push_back(std::shared_ptr<AudioCodec>(std::move(codec)));
+    addFileExtensions(*newRegistry, codecCount);
+
+    std::atomic_store(
+      &this->registry, std::shared_ptr<const CodecRegistry>(std::move(newRegistry))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    // Register the new codec into our list
-    this->codecs.push_back(std::move(codec));
+  std::shared_ptr<const AudioLoader::CodecRegistry> AudioLoader::getRegistry() const {
+    return std::atomic_load(&this->registry);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::addFileExtensions(CodecRegistry &registry, std::size_t codecIndex) {
+    const std::vector<std::string> &extensions = registry.Codecs[codecIndex]->GetFileExtensions();
 
     // Update the extension lookup map for quick codec finding
     std::size_t extensionCount = extensions.size();
@@ -156,14 +480,14 @@ namespace Nuclex { namespace Audio { namespace Storage {
             std::string lowerExtension = StringConverter::FoldedLowercaseFromUtf8(
               extension.substr(1)
             );
-            this->codecsByExtension.insert(
-              ExtensionCodecIndexMap::value_type(lowerExtension, codecCount)
+            registry.CodecsByExtension.insert(
+              ExtensionCodecIndexMap::value_type(lowerExtension, codecIndex)
             );
           }
         } else { // If extension ^^ includes dot ^^ / vv lacks dot vv
           std::string lowerExtension = StringConverter::FoldedLowercaseFromUtf8(extension);
-          this->codecsByExtension.insert(
-            ExtensionCodecIndexMap::value_type(lowerExtension, codecCount)
+          registry.CodecsByExtension.insert(
+            ExtensionCodecIndexMap::value_type(lowerExtension, codecIndex)
           );
         } // if extension includes dot / lacks dot
       } // If extension has non-zero length
@@ -172,14 +496,101 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void AudioLoader::SetReadAheadBuffering(
+    std::size_t blockSize, std::size_t readAheadBlockCount /* = 3 */
+  ) {
+    this->readAheadBlockSize = blockSize;
+    this->readAheadBlockCount = readAheadBlockCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::EnableStatistics(bool enable /* = true */) const {
+    bool wasEnabled = this->statistics->IsEnabled.load(std::memory_order_relaxed);
+    if(enable && !wasEnabled) {
+      this->statistics->InfoReadCount.store(0, std::memory_order_relaxed);
+      this->statistics->InfoReadTicks.store(0, std::memory_order_relaxed);
+      this->statistics->OpenCount.store(0, std::memory_order_relaxed);
+      this->statistics->OpenTicks.store(0, std::memory_order_relaxed);
+      this->statistics->DetectionTicks.store(0, std::memory_order_relaxed);
+      this->statistics->FirstGuessHitCount.store(0, std::memory_order_relaxed);
+      this->statistics->MostRecentCodecHitCount.store(0, std::memory_order_relaxed);
+      this->statistics->SecondMostRecentCodecHitCount.store(0, std::memory_order_relaxed);
+      this->statistics->UnsupportedCount.store(0, std::memory_order_relaxed);
+      {
+        std::lock_guard<std::mutex> statisticsScope(this->statisticsMutex);
+        this->statistics->Codecs.clear();
+      }
+    }
+
+    this->statistics->IsEnabled.store(enable, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioLoaderStatistics AudioLoader::GetStatistics() const {
+    const StatisticsCounters &counters = *this->statistics.get();
+
+    AudioLoaderStatistics result;
+    result.InfoReadCount = counters.InfoReadCount.load(std::memory_order_relaxed);
+    result.InfoReadTime = nanosecondsFromTicks(
+      counters.InfoReadTicks.load(std::memory_order_relaxed)
+    );
+    result.OpenCount = counters.OpenCount.load(std::memory_order_relaxed);
+    result.OpenTime = nanosecondsFromTicks(counters.OpenTicks.load(std::memory_order_relaxed));
+    result.DetectionTime = nanosecondsFromTicks(
+      counters.DetectionTicks.load(std::memory_order_relaxed)
+    );
+    result.FirstGuessHitCount = counters.FirstGuessHitCount.load(std::memory_order_relaxed);
+    result.MostRecentCodecHitCount = counters.MostRecentCodecHitCount.load(
+      std::memory_order_relaxed
+    );
+    result.SecondMostRecentCodecHitCount = counters.SecondMostRecentCodecHitCount.load(
+      std::memory_order_relaxed
+    );
+    result.UnsupportedCount = counters.UnsupportedCount.load(std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> statisticsScope(this->statisticsMutex);
+      result.Codecs = counters.Codecs;
+    }
+
+    // Codecs that were never asked still get an entry, so the list always lines up
+    // with the registered codecs
+    std::shared_ptr<const CodecRegistry> currentRegistry = getRegistry();
+    std::size_t codecCount = currentRegistry->Codecs.size();
+    if(result.Codecs.size() < codecCount) {
+      result.Codecs.resize(codecCount, CodecProbeStatistics());
+    }
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      result.Codecs[index].CodecName = currentRegistry->Codecs[index]->GetName();
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> AudioLoader::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &file,
     const std::string &extensionHint /* = std::string() */
   ) const {
+    LookupStopwatch stopwatch(
+      this->statistics->IsEnabled.load(std::memory_order_relaxed),
+      this->statistics->InfoReadCount,
+      this->statistics->InfoReadTicks
+    );
+
+    // Each codec reads the file header to check whether it is responsible for the file,
+    // so unless the file is in memory already, read the header once for all of them
     FileAndContainerInfo fileProvider;
-    fileProvider.File = file;
+    if(file->TryBorrowAt(0, 0) == nullptr) {
+      fileProvider.File = std::make_shared<HeaderBufferedFile>(file);
+    } else {
+      fileProvider.File = file;
+    }
 
     bool wasLoaded = tryCodecsInOptimalOrder<FileAndContainerInfo>(
+      *fileProvider.File,
       extensionHint,
       [](
         const AudioCodec &codec,
@@ -202,9 +613,55 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void AudioLoader::SetInfoCache(const std::shared_ptr<ContainerInfoCache> &cache) {
+    this->infoCache = cache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::SetAssetCatalog(const std::shared_ptr<const AssetCatalog> &catalog) {
+    std::atomic_store(&this->assetCatalog, catalog);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> AudioLoader::TryReadInfo(
     const std::string &path
   ) const {
+    std::shared_ptr<const AssetCatalog> catalog = std::atomic_load(&this->assetCatalog);
+    if(!this->infoCache && !catalog) {
+      return readInfoFromPath(path);
+    }
+
+    // If the file can't be looked up, let the codecs report the error as usual
+    std::uint64_t size, modificationTime;
+    if(unlikely(!tryGetFileIdentity(path, size, modificationTime))) {
+      return readInfoFromPath(path);
+    }
+
+    // The catalog was prepared ahead of time, so it's the first place to look
+    std::optional<ContainerInfo> info;
+    if(catalog) {
+      if(catalog->TryLookupInfo(path, size, modificationTime, info)) {
+        return info;
+      }
+    }
+    if(this->infoCache) {
+      if(this->infoCache->TryLookup(path, size, modificationTime, info)) {
+        return info;
+      }
+    }
+
+    info = readInfoFromPath(path);
+    if(this->infoCache) {
+      this->infoCache->Store(path, size, modificationTime, info);
+    }
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<ContainerInfo> AudioLoader::readInfoFromPath(const std::string &path) const {
     std::string::size_type extensionDotIndex = path.find_last_of('.');
 #if defined(NUCLEX_AUDIO_WINDOWS)
     std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
@@ -233,16 +690,171 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void AudioLoader::TryReadInfoBatch(
+    const std::vector<std::string> &paths,
+    const InfoBatchCallback &callback,
+    std::size_t threadCount /* = 0 */
+  ) const {
+    if(threadCount == 0) {
+      threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1) * 2;
+    }
+    threadCount = std::min(threadCount, std::max<std::size_t>(paths.size(), 1));
+
+    std::atomic<std::size_t> nextPathIndex(0);
+    std::atomic<bool> isAborted(false);
+    std::mutex callbackMutex;
+    std::exception_ptr callbackError;
+
+    // Each worker probes one file at a time, so the thread count also limits how many
+    // file handles are open at once. Probing is already thread-safe, only the callback
+    // needs to be serialized.
+    auto probeFiles = [&]() {
+      for(;;) {
+        std::size_t pathIndex = nextPathIndex.fetch_add(1, std::memory_order_relaxed);
+        if((pathIndex >= paths.size()) || isAborted.load(std::memory_order_relaxed)) {
+          return;
+        }
+
+        std::optional<ContainerInfo> info;
+        std::exception_ptr error;
+        try {
+          info = TryReadInfo(paths[pathIndex]);
+        }
+        catch(...) {
+          error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> callbackScope(callbackMutex);
+        if(isAborted.load(std::memory_order_relaxed)) {
+          return;
+        }
+        try {
+          callback(pathIndex, std::move(info), error);
+        }
+        catch(...) {
+          callbackError = std::current_exception();
+          isAborted.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    };
+
+    // The calling thread acts as a worker, too, so the batch finishes even if all of
+    // the executor's workers are busy
+    Executor::GetInstalled()->ParallelFor(
+      threadCount, [&](std::size_t) { probeFiles(); }, TaskPriority::Low
+    );
+
+    if(static_cast<bool>(callbackError)) {
+      std::rethrow_exception(callbackError);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<std::optional<ContainerInfo>> AudioLoader::TryReadInfoAsync(
+    const std::string &path
+  ) const {
+    typedef std::promise<std::optional<ContainerInfo>> InfoPromise;
+    std::shared_ptr<InfoPromise> promise = std::make_shared<InfoPromise>();
+    std::future<std::optional<ContainerInfo>> future = promise->get_future();
+
+    TryReadInfoAsync(
+      path,
+      [promise](std::optional<ContainerInfo> &&info, std::exception_ptr error) {
+        if(static_cast<bool>(error)) {
+          promise->set_exception(error);
+        } else {
+          promise->set_value(std::move(info));
+        }
+      }
+    );
+
+    return future;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::TryReadInfoAsync(const std::string &path, InfoCallback callback) const {
+    Executor::GetInstalled()->Submit(
+      [this, path, callback = std::move(callback)]() {
+        std::optional<ContainerInfo> info;
+        std::exception_ptr error;
+        try {
+          info = TryReadInfo(path);
+        }
+        catch(...) {
+          error = std::current_exception();
+        }
+
+        try {
+          callback(std::move(info), error);
+        }
+        catch(...) {} // Documented, the executor's worker must not be taken down
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track AudioLoader::Load(
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &extensionHint /* = std::string() */,
+    SampleLayout layout /* = SampleLayout::Interleaved */,
+    std::size_t threadCount /* = 0 */
+  ) const {
+    std::shared_ptr<AudioTrackDecoder> decoder = OpenDecoder(file, extensionHint);
+    return decodeIntoTrack(decoder, TryReadInfo(file, extensionHint), layout, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track AudioLoader::Load(
+    const std::string &path,
+    SampleLayout layout /* = SampleLayout::Interleaved */,
+    std::size_t threadCount /* = 0 */
+  ) const {
+    // Going through the path-based methods lets the asset catalog provide the seek index
+    // (so the parallel decoder can spread out right away) and the cached file infos
+    std::shared_ptr<AudioTrackDecoder> decoder = OpenDecoder(path);
+    return decodeIntoTrack(decoder, TryReadInfo(path), layout, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::shared_ptr<AudioTrackDecoder> AudioLoader::OpenDecoder(
     const std::shared_ptr<const VirtualFile> &file,
     const std::string &extensionHint /* = std::string() */,
     std::size_t trackIndex /* = 0 */
   ) const {
+    LookupStopwatch stopwatch(
+      this->statistics->IsEnabled.load(std::memory_order_relaxed),
+      this->statistics->OpenCount,
+      this->statistics->OpenTicks
+    );
+
     FileAndTrackDecoder fileProvider;
-    fileProvider.File = file;
     fileProvider.TrackIndex = trackIndex;
 
+    // Wrap the file in a read-ahead buffer if enabled. Files that can hand out their
+    // memory directly are already as fast as it gets, so those are left alone.
+    bool useReadAheadBuffer = (
+      (this->readAheadBlockSize > 0) && (file->TryBorrowAt(0, 0) == nullptr)
+    );
+    // Without read-ahead, at least read the header once so that the detection code
+    // of each codec that is asked in turn doesn't hit the disk again
+    if(useReadAheadBuffer) {
+      fileProvider.File = VirtualFile::WrapInReadAheadBuffer(
+        file, this->readAheadBlockSize, this->readAheadBlockCount
+      );
+    } else if(file->TryBorrowAt(0, 0) == nullptr) {
+      fileProvider.File = std::make_shared<HeaderBufferedFile>(file);
+    } else {
+      fileProvider.File = file;
+    }
+
     bool wasLoaded = tryCodecsInOptimalOrder<FileAndTrackDecoder>(
+      *fileProvider.File,
       extensionHint,
       [](
         const AudioCodec &codec,
@@ -267,9 +879,183 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void AudioLoader::ReopenDecoder(
+    std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &extensionHint /* = std::string() */
+  ) const {
+
+    // A decoder someone else holds on to might be in use, so only reuse it if we
+    // are its sole owner. Reopening also has to honor the read-ahead settings.
+    if(decoder && (decoder.use_count() == 1)) {
+      bool useReadAheadBuffer = (
+        (this->readAheadBlockSize > 0) && (file->TryBorrowAt(0, 0) == nullptr)
+      );
+      bool wasReopened;
+      if(useReadAheadBuffer) {
+        wasReopened = decoder->TryReopen(
+          VirtualFile::WrapInReadAheadBuffer(
+            file, this->readAheadBlockSize, this->readAheadBlockCount
+          )
+        );
+      } else {
+        wasReopened = decoder->TryReopen(file);
+      }
+      if(wasReopened) {
+        return;
+      }
+    }
+
+    decoder = OpenDecoder(file, extensionHint);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioLoader::OpenPlaylist(
+    const std::vector<std::string> &paths
+  ) const {
+    return std::make_shared<PlaylistTrackDecoder>(*this, paths);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::shared_ptr<AudioTrackDecoder> AudioLoader::OpenDecoder(
     const std::string &path,
     std::size_t trackIndex /* = 0 */
+  ) const {
+    std::shared_ptr<AudioTrackDecoder> decoder = openDecoderFromPath(path, trackIndex);
+
+    // If the catalog has a seek index for the file, spare the decoder from building one.
+    // An index that doesn't fit anymore is no reason to fail, the decoder can do without.
+    // The recorded length spares decoders that don't know theirs from looking it up.
+    std::shared_ptr<const AssetCatalog> catalog = std::atomic_load(&this->assetCatalog);
+    if(catalog) {
+      std::uint64_t size, modificationTime;
+      if(tryGetFileIdentity(path, size, modificationTime)) {
+        std::optional<AssetRecord> record = catalog->TryLookup(path);
+        bool isUpToDate = (
+          record.has_value() &&
+          (record.value().Size == size) &&
+          (record.value().ModificationTime == modificationTime)
+        );
+        if(isUpToDate && !record.value().SeekIndex.empty()) {
+          try {
+            decoder->LoadSeekIndex(record.value().SeekIndex);
+          }
+          catch(const Errors::CorruptedFileError &) {}
+        }
+        if(isUpToDate && record.value().Info.has_value()) {
+          const std::vector<TrackInfo> &tracks = record.value().Info.value().Tracks;
+          if(trackIndex < tracks.size()) {
+            decoder->ProvideFrameCount(tracks[trackIndex].FrameCount);
+          }
+        }
+      }
+    }
+
+    return decoder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioLoader::OpenPreviewDecoder(
+    const std::string &path
+  ) const {
+    std::shared_ptr<const AssetCatalog> catalog = std::atomic_load(&this->assetCatalog);
+    if(catalog) {
+      std::uint64_t size, modificationTime;
+      if(tryGetFileIdentity(path, size, modificationTime)) {
+        std::optional<AssetRecord> record = catalog->TryLookup(path);
+        bool isUpToDate = (
+          record.has_value() &&
+          (record.value().Size == size) &&
+          (record.value().ModificationTime == modificationTime)
+        );
+        if(isUpToDate && record.value().Proxy.has_value()) {
+          const ProxyMapping &mapping = record.value().Proxy.value();
+
+          // A proxy that went missing or was replaced only costs the preview its speed
+          std::shared_ptr<AudioTrackDecoder> proxy;
+          try {
+            proxy = OpenDecoder(mapping.ProxyPath);
+          }
+          catch(const std::exception &) {}
+
+          // The generator recorded the proxy's native rate if it can't decode at another
+          if(static_cast<bool>(proxy)) {
+            proxy->TrySetDecodeSampleRate(mapping.ProxySampleRate);
+            if(proxy->CountFrames() == mapping.ProxyFrameCount) {
+              if(mapping.ProxySampleRate == mapping.MasterSampleRate) {
+                return proxy;
+              } else {
+                return AudioTrackDecoder::CreateResampler(
+                  proxy, mapping.ProxySampleRate, mapping.MasterSampleRate
+                );
+              }
+            }
+          }
+        }
+      }
+    }
+
+    return OpenDecoder(path);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<std::shared_ptr<AudioTrackDecoder>> AudioLoader::OpenDecoderAsync(
+    const std::string &path,
+    std::size_t trackIndex /* = 0 */
+  ) const {
+    typedef std::promise<std::shared_ptr<AudioTrackDecoder>> DecoderPromise;
+    std::shared_ptr<DecoderPromise> promise = std::make_shared<DecoderPromise>();
+    std::future<std::shared_ptr<AudioTrackDecoder>> future = promise->get_future();
+
+    OpenDecoderAsync(
+      path,
+      [promise](std::shared_ptr<AudioTrackDecoder> &&decoder, std::exception_ptr error) {
+        if(static_cast<bool>(error)) {
+          promise->set_exception(error);
+        } else {
+          promise->set_value(std::move(decoder));
+        }
+      },
+      trackIndex
+    );
+
+    return future;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::OpenDecoderAsync(
+    const std::string &path,
+    OpenDecoderCallback callback,
+    std::size_t trackIndex /* = 0 */
+  ) const {
+    Executor::GetInstalled()->Submit(
+      [this, path, callback = std::move(callback), trackIndex]() {
+        std::shared_ptr<AudioTrackDecoder> decoder;
+        std::exception_ptr error;
+        try {
+          decoder = OpenDecoder(path, trackIndex);
+        }
+        catch(...) {
+          error = std::current_exception();
+        }
+
+        try {
+          callback(std::move(decoder), error);
+        }
+        catch(...) {} // Documented, the executor's worker must not be taken down
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioLoader::openDecoderFromPath(
+    const std::string &path, std::size_t trackIndex
   ) const {
     std::string::size_type extensionDotIndex = path.find_last_of('.');
 #if defined(NUCLEX_AUDIO_WINDOWS)
@@ -304,78 +1090,275 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   template<typename TOutput>
   bool AudioLoader::tryCodecsInOptimalOrder(
+    const VirtualFile &file,
     const std::string &extension,
     bool (*tryCodecCallback)(
       const AudioCodec &codec, const std::string &extension, TOutput &result
     ),
     TOutput &result
   ) const {
-    std::size_t hintCodecIndex;
+    bool recordStatistics = this->statistics->IsEnabled.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point startTime;
+    if(unlikely(recordStatistics)) {
+      startTime = std::chrono::steady_clock::now();
+    }
 
-    // If an extension hint was provided, try the codec registered for the extension first
-    if(extension.empty()) {
-      hintCodecIndex = InvalidIndex;
-    } else {
+    std::string foldedExtension;
+    if(!extension.empty()) {
       using Nuclex::Support::Text::StringConverter;
-      std::string foldedLowercaseExtension = StringConverter::FoldedLowercaseFromUtf8(extension);
-      ExtensionCodecIndexMap::const_iterator iterator = (
-        this->codecsByExtension.find(foldedLowercaseExtension)
+      foldedExtension = StringConverter::FoldedLowercaseFromUtf8(extension);
+    }
+
+    // Fetch the first few bytes of the file so the codecs can look for their signatures.
+    // Our callers wrap the file in a header buffer, so this doesn't cause another read.
+    std::byte header[SignatureByteCount];
+    std::size_t headerByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(file.GetSize(), SignatureByteCount)
+    );
+    if(headerByteCount > 0) {
+      file.ReadAt(0, headerByteCount, header);
+    }
+
+    // Take one snapshot of the registry and stick with it for the whole lookup, so the
+    // codec indices stay valid even if another thread registers a codec in the meantime.
+    std::shared_ptr<const CodecRegistry> currentRegistry = getRegistry();
+
+    std::vector<std::size_t> codecOrder;
+    std::size_t signatureMatchCount;
+    sortCodecsByLikelihood(
+      *currentRegistry,
+      header, headerByteCount, foldedExtension, codecOrder, signatureMatchCount
+    );
+
+    std::size_t codecCount = codecOrder.size();
+    if(unlikely(recordStatistics)) {
+      this->statistics->DetectionTicks.fetch_add(
+        static_cast<std::uint64_t>((std::chrono::steady_clock::now() - startTime).count()),
+        std::memory_order_relaxed
       );
-      if(iterator == this->codecsByExtension.end()) {
-        hintCodecIndex = InvalidIndex;
+    }
+
+    // For any well-formed file with a signature, the first codec we try will succeed.
+    // Only if no codec recognized the file or the file was damaged do we fall back
+    // to trying the remaining codecs in order of their observed success rates.
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      std::size_t codecIndex = codecOrder[index];
+      const AudioCodec &codec = *currentRegistry->Codecs[codecIndex].get();
+
+      bool wasLoaded;
+      if(likely(!recordStatistics)) {
+        wasLoaded = tryCodecCallback(codec, extension, result);
       } else {
-        hintCodecIndex = iterator->second;
-        if(tryCodecCallback(*this->codecs[hintCodecIndex].get(), extension, result)) {
-          updateMostRecentCodecIndex(hintCodecIndex);
-          return true;
+        ExtensionCodecIndexMap::const_iterator iterator = (
+          currentRegistry->CodecsByExtension.find(foldedExtension)
+        );
+        bool isExtensionCodec = (
+          (iterator != currentRegistry->CodecsByExtension.end()) &&
+          (iterator->second == codecIndex)
+        );
+
+        std::chrono::steady_clock::time_point probeStartTime = std::chrono::steady_clock::now();
+        try {
+          wasLoaded = tryCodecCallback(codec, extension, result);
+        }
+        catch(...) {
+          recordProbe(
+            codecIndex, codecCount, false, isExtensionCodec,
+            std::chrono::steady_clock::now() - probeStartTime
+          );
+          throw;
+        }
+        recordProbe(
+          codecIndex, codecCount, wasLoaded, isExtensionCodec,
+          std::chrono::steady_clock::now() - probeStartTime
+        );
+
+        // Check whether the most recently used codecs were good guesses before
+        // the success below makes this codec the most recently used one
+        if(wasLoaded) {
+          if(index == 0) {
+            this->statistics->FirstGuessHitCount.fetch_add(1, std::memory_order_relaxed);
+          }
+          if(codecIndex == this->mostRecentCodecIndex.load(std::memory_order_relaxed)) {
+            this->statistics->MostRecentCodecHitCount.fetch_add(1, std::memory_order_relaxed);
+          } else if(
+            codecIndex == this->secondMostRecentCodecIndex.load(std::memory_order_relaxed)
+          ) {
+            this->statistics->SecondMostRecentCodecHitCount.fetch_add(
+              1, std::memory_order_relaxed
+            );
+          }
         }
       }
+
+      if(wasLoaded) {
+        recordCodecSuccess(
+          foldedExtension, codecIndex, (index < signatureMatchCount), codecCount
+        );
+        return true;
+      }
     }
 
-    // Look up the two most recently used codecs (we don't care about race conditions here,
-    // in the rare case of one occurring, we'll simple be a little less efficient and not
-    // have the right codec in the MRU list...
-    std::size_t mostRecent = this->mostRecentCodecIndex;
-    std::size_t secondMostRecent = this->secondMostRecentCodecIndex;
+    // No codec can load the file, we give up
+    if(unlikely(recordStatistics)) {
+      this->statistics->UnsupportedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+  }
 
-    // Try the most recently used codec. It may be set to 'InvalidIndex' if this
-    // is the first call to Load(). Don't try if it's the same as the extension hint.
-    if((mostRecent != InvalidIndex) && (mostRecent != hintCodecIndex)) {
-      if(tryCodecCallback(*this->codecs[mostRecentCodecIndex].get(), extension, result)) {
-        updateMostRecentCodecIndex(mostRecent);
-        return true;
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::sortCodecsByLikelihood(
+    const CodecRegistry &registry,
+    const std::byte *header, std::size_t headerByteCount,
+    const std::string &foldedExtension,
+    std::vector<std::size_t> &codecOrder, std::size_t &signatureMatchCount
+  ) const {
+    std::size_t codecCount = registry.Codecs.size();
+
+    std::size_t hintCodecIndex = InvalidIndex;
+    if(!foldedExtension.empty()) {
+      ExtensionCodecIndexMap::const_iterator iterator = (
+        registry.CodecsByExtension.find(foldedExtension)
+      );
+      if(iterator != registry.CodecsByExtension.end()) {
+        hintCodecIndex = iterator->second;
       }
     }
 
-    // Try the second most recently used codec. It, too, may be set to 'InvalidIndex'.
-    // Also avoid retrying codecs we already tried.
-    if(
-      (secondMostRecent != InvalidIndex) &&
-      (secondMostRecent != mostRecent) &&
-      (secondMostRecent != hintCodecIndex)
-    ) {
-      if(tryCodecCallback(*this->codecs[secondMostRecent].get(), extension, result)) {
-        updateMostRecentCodecIndex(secondMostRecent);
-        return true;
+    // We don't care about race conditions here, in the rare case of one occurring,
+    // we'll simply be a little less efficient and try the codecs in a worse order.
+    std::size_t mostRecent = this->mostRecentCodecIndex.load(
+      std::memory_order::memory_order_relaxed
+    );
+    std::size_t secondMostRecent = this->secondMostRecentCodecIndex.load(
+      std::memory_order::memory_order_relaxed
+    );
+
+    // Collect everything we know about each codec. Checking the signatures is cheap
+    // since it only looks at a few bytes already in memory.
+    std::vector<CodecLikelihood> likelihoods(codecCount);
+    signatureMatchCount = 0;
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      CodecLikelihood &likelihood = likelihoods[index];
+      likelihood.CodecIndex = index;
+      likelihood.IsSignatureMatch = (
+        (headerByteCount > 0) &&
+        registry.Codecs[index]->IsSignaturePresent(header, headerByteCount)
+      );
+      likelihood.SignatureHitCount = 0;
+      likelihood.ExtensionSuccessCount = 0;
+      likelihood.IsRegisteredForExtension = (index == hintCodecIndex);
+      if(index == mostRecent) {
+        likelihood.RecencyRank = 0;
+      } else if(index == secondMostRecent) {
+        likelihood.RecencyRank = 1;
+      } else {
+        likelihood.RecencyRank = 2;
+      }
+
+      if(likelihood.IsSignatureMatch) {
+        ++signatureMatchCount;
       }
     }
 
-    // Hint was not provided or wrong, most recently used codecs didn't work,
-    // so go through all remaining codecs.
-    std::size_t codecCount = this->codecs.size();
+    // Add the statistics about which codecs actually loaded which files
+    {
+      std::lock_guard<std::mutex> statisticsScope(this->statisticsMutex);
+
+      std::size_t signatureCodecCount = std::min(codecCount, this->signatureHitCounts.size());
+      for(std::size_t index = 0; index < signatureCodecCount; ++index) {
+        likelihoods[index].SignatureHitCount = this->signatureHitCounts[index];
+      }
+
+      if(!foldedExtension.empty()) {
+        ExtensionSuccessCountMap::const_iterator iterator = (
+          this->successCountsByExtension.find(foldedExtension)
+        );
+        if(iterator != this->successCountsByExtension.end()) {
+          std::size_t extensionCodecCount = std::min(codecCount, iterator->second.size());
+          for(std::size_t index = 0; index < extensionCodecCount; ++index) {
+            likelihoods[index].ExtensionSuccessCount = iterator->second[index];
+          }
+        }
+      }
+    }
+
+    // A stable sort keeps the codecs in order of registration where we know nothing else
+    std::stable_sort(likelihoods.begin(), likelihoods.end(), &isMoreLikely);
+
+    codecOrder.resize(codecCount);
     for(std::size_t index = 0; index < codecCount; ++index) {
-      if((index == mostRecent) || (index == secondMostRecent) || (index == hintCodecIndex)) {
-        continue;
+      codecOrder[index] = likelihoods[index].CodecIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::recordCodecSuccess(
+    const std::string &foldedExtension, std::size_t codecIndex, bool wasSignatureMatch,
+    std::size_t codecCount
+  ) const {
+    {
+      std::lock_guard<std::mutex> statisticsScope(this->statisticsMutex);
+
+      if(!foldedExtension.empty()) {
+        ExtensionSuccessCountMap::iterator iterator = (
+          this->successCountsByExtension.find(foldedExtension)
+        );
+        if(iterator == this->successCountsByExtension.end()) {
+          if(this->successCountsByExtension.size() < MaximumTrackedExtensionCount) {
+            iterator = this->successCountsByExtension.emplace(
+              foldedExtension, std::vector<std::size_t>(codecCount, 0)
+            ).first;
+          }
+        }
+        if(iterator != this->successCountsByExtension.end()) {
+          if(iterator->second.size() < codecCount) {
+            iterator->second.resize(codecCount, 0);
+          }
+          ++iterator->second[codecIndex];
+        }
       }
 
-      if(tryCodecCallback(*this->codecs[index].get(), extension, result)) {
-        updateMostRecentCodecIndex(secondMostRecent);
-        return true;
+      if(wasSignatureMatch) {
+        if(this->signatureHitCounts.size() < codecCount) {
+          this->signatureHitCounts.resize(codecCount, 0);
+        }
+        ++this->signatureHitCounts[codecIndex];
       }
     }
 
-    // No codec can load the file, we give up
-    return false;
+    updateMostRecentCodecIndex(codecIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioLoader::recordProbe(
+    std::size_t codecIndex, std::size_t codecCount, bool wasHit, bool isExtensionCodec,
+    std::chrono::steady_clock::duration probeTime
+  ) const {
+    std::chrono::nanoseconds probeNanoseconds = (
+      std::chrono::duration_cast<std::chrono::nanoseconds>(probeTime)
+    );
+
+    std::lock_guard<std::mutex> statisticsScope(this->statisticsMutex);
+
+    std::vector<CodecProbeStatistics> &codecs = this->statistics->Codecs;
+    if(codecs.size() < codecCount) {
+      codecs.resize(codecCount, CodecProbeStatistics());
+    }
+
+    CodecProbeStatistics &codec = codecs[codecIndex];
+    ++codec.ProbeCount;
+    codec.ProbeTime += probeNanoseconds;
+    if(!wasHit) {
+      ++codec.MissCount;
+      codec.MissTime += probeNanoseconds;
+      if(isExtensionCodec) {
+        ++codec.ExtensionMissCount;
+      }
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
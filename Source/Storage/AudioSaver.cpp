@@ -23,9 +23,20 @@ License along with this library
 
 #include "Nuclex/Audio/Storage/AudioSaver.h"
 
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+#include "Flac/FlacAudioCodec.h"
+#endif
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 #include "Opus/OpusAudioCodec.h"
 #endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+#include "Vorbis/VorbisAudioCodec.h"
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+#include "WavPack/WavPackAudioCodec.h"
+#endif
+
+#include "Waveform/WaveformAudioCodec.h"
 
 #include <Nuclex/Support/Text/StringMatcher.h> // for StringMatcher
 
@@ -44,9 +55,19 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   AudioSaver::AudioSaver() :
     codecs() {
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    RegisterCodec(std::make_unique<Flac::FlacAudioCodec>());
+#endif
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
     RegisterCodec(std::make_unique<Opus::OpusAudioCodec>());
 #endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    RegisterCodec(std::make_unique<Vorbis::VorbisAudioCodec>());
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    RegisterCodec(std::make_unique<WavPack::WavPackAudioCodec>());
+#endif
+    RegisterCodec(std::make_unique<Waveform::WaveformAudioCodec>());
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -21,10 +21,834 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
+#include "Nuclex/Audio/Storage/RawPcmLayout.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Processing/Int24Packing.h"
+#include "PooledTrackDecoder.h"
+#include "ParallelTrackDecoder.h"
+#include "DownmixingTrackDecoder.h"
+#include "ResamplingTrackDecoder.h"
+#include "DiskCachedTrackDecoder.h"
+#include "LoopingTrackDecoder.h"
+#include "SharedCachedTrackDecoder.h"
+#include "RawPcm/RawPcmReader.h"
+#include "Waveform/WaveformTrackDecoder.h"
+#include "Shared/DecodePathBuilder.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <algorithm> // for std::max(), std::min(), std::clamp(), std::copy_n()
+#include <stdexcept> // for std::invalid_argument
+#include <limits> // for std::numeric_limits
+#include <thread> // for std::thread::hardware_concurrency()
+#include <type_traits> // for std::is_same<>
+#include <vector> // for std::vector
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Block size reported by decoders for formats that are not block-based</summary>
+  /// <remarks>
+  ///   Large enough that the per-call overhead of decoding is insignificant, small enough
+  ///   that a block of 8 channels of 64-bit samples still fits into a 256 KiB cache.
+  /// </remarks>
+  const std::size_t SyntheticBlockSize = 4096;
+
+  /// <summary>Number of samples decoded at a time before they're narrowed or scattered</summary>
+  /// <remarks>
+  ///   These are kept on the stack as floats or 32-bit integers. Together with the narrowed
+  ///   output, they take up at most 28 KiB, which stays in the L1 cache between decoding
+  ///   and narrowing on most processors.
+  /// </remarks>
+  const std::size_t NarrowingSampleCount = 4096;
+
+  /// <summary>Number of channels whose chunk pointers are kept on the stack</summary>
+  const std::size_t InlineChannelCount = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs full-range 32-bit integer samples into 24-bit samples</summary>
+  /// <param name="values">Samples that will be packed</param>
+  /// <param name="packed">Receives the packed samples</param>
+  /// <param name="count">Number of samples that will be packed</param>
+  void packInt24(
+    const std::int32_t *values, Nuclex::Audio::PackedInt24 *packed, std::size_t count
+  ) {
+    Nuclex::Audio::Processing::Int24Packing::PackHighFromInt32(
+      values, reinterpret_cast<std::byte *>(packed), count
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes frames in small chunks and narrows them to a compact type</summary>
+  /// <typeparam name="TWideSample">Type as which the samples will be decoded</typeparam>
+  /// <typeparam name="TNarrowSample">Type the samples are narrowed to</typeparam>
+  /// <param name="decoder">Decoder that will decode the frames</param>
+  /// <param name="buffer">Buffer that receives the narrowed, interleaved samples</param>
+  /// <param name="startFrame">Index of the first frame to decode</param>
+  /// <param name="frameCount">Number of audio frames that will be decoded</param>
+  /// <param name="narrow">Conversion kernel that narrows the decoded samples</param>
+  template<typename TWideSample, typename TNarrowSample>
+  void decodeInterleavedNarrowed(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    TNarrowSample *buffer, std::uint64_t startFrame, std::size_t frameCount,
+    void (*narrow)(const TWideSample *, TNarrowSample *, std::size_t)
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    std::size_t chunkFrameCount = std::max<std::size_t>(NarrowingSampleCount / channelCount, 1);
+
+    // Tracks with more channels than fit into the stack buffer get a heap buffer
+    TWideSample stackSamples[NarrowingSampleCount];
+    std::vector<TWideSample> heapSamples;
+    TWideSample *samples = stackSamples;
+    if(unlikely(channelCount > NarrowingSampleCount)) {
+      heapSamples.resize(channelCount);
+      samples = heapSamples.data();
+    }
+
+    while(0 < frameCount) {
+      std::size_t decodeFrameCount = std::min(frameCount, chunkFrameCount);
+      std::size_t sampleCount = decodeFrameCount * channelCount;
+
+      decoder.DecodeInterleaved<TWideSample>(samples, startFrame, decodeFrameCount);
+      narrow(samples, buffer, sampleCount);
+
+      buffer += sampleCount;
+      startFrame += decodeFrameCount;
+      frameCount -= decodeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes channels in small chunks and narrows them to a compact type</summary>
+  /// <typeparam name="TWideSample">Type as which the samples will be decoded</typeparam>
+  /// <typeparam name="TNarrowSample">Type the samples are narrowed to</typeparam>
+  /// <param name="decoder">Decoder that will decode the frames</param>
+  /// <param name="buffers">Buffers that receive the narrowed channels, can contain nulls</param>
+  /// <param name="startFrame">Index of the first frame to decode</param>
+  /// <param name="frameCount">Number of audio frames that will be decoded</param>
+  /// <param name="narrow">Conversion kernel that narrows the decoded samples</param>
+  template<typename TWideSample, typename TNarrowSample>
+  void decodeSeparatedNarrowed(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    TNarrowSample *buffers[], std::uint64_t startFrame, std::size_t frameCount,
+    void (*narrow)(const TWideSample *, TNarrowSample *, std::size_t)
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    std::size_t chunkFrameCount = std::max<std::size_t>(NarrowingSampleCount / channelCount, 1);
+
+    TWideSample stackSamples[NarrowingSampleCount];
+    TWideSample *stackChannels[InlineChannelCount];
+    std::vector<TWideSample> heapSamples;
+    std::vector<TWideSample *> heapChannels;
+    TWideSample *samples = stackSamples;
+    TWideSample **channels = stackChannels;
+    if(unlikely(channelCount > InlineChannelCount)) {
+      heapChannels.resize(channelCount);
+      channels = heapChannels.data();
+      if(channelCount > NarrowingSampleCount) {
+        heapSamples.resize(channelCount);
+        samples = heapSamples.data();
+      }
+    }
+
+    // Channels the caller isn't interested in stay null so the decoder can skip them
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      if(buffers[index] == nullptr) {
+        channels[index] = nullptr;
+      } else {
+        channels[index] = samples + (index * chunkFrameCount);
+      }
+    }
+
+    std::size_t writtenFrameCount = 0;
+    while(writtenFrameCount < frameCount) {
+      std::size_t decodeFrameCount = std::min(frameCount - writtenFrameCount, chunkFrameCount);
+
+      decoder.DecodeSeparated<TWideSample>(channels, startFrame, decodeFrameCount);
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        if(channels[index] != nullptr) {
+          narrow(channels[index], buffers[index] + writtenFrameCount, decodeFrameCount);
+        }
+      }
+
+      startFrame += decodeFrameCount;
+      writtenFrameCount += decodeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a sample to another one, clipping it if it overflows</summary>
+  /// <param name="target">Sample to which the other sample will be added</param>
+  /// <param name="value">Sample that will be added to the target</param>
+  inline void accumulateSample(std::uint8_t &target, std::uint8_t value) {
+    int sum = static_cast<int>(target) + static_cast<int>(value) - 128; // both biased by 128
+    target = static_cast<std::uint8_t>(std::clamp(sum, 0, 255));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a sample to another one, clipping it if it overflows</summary>
+  /// <param name="target">Sample to which the other sample will be added</param>
+  /// <param name="value">Sample that will be added to the target</param>
+  inline void accumulateSample(std::int16_t &target, std::int16_t value) {
+    int sum = static_cast<int>(target) + static_cast<int>(value);
+    target = static_cast<std::int16_t>(std::clamp(sum, -32768, 32767));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a sample to another one, clipping it if it overflows</summary>
+  /// <param name="target">Sample to which the other sample will be added</param>
+  /// <param name="value">Sample that will be added to the target</param>
+  inline void accumulateSample(std::int32_t &target, std::int32_t value) {
+    std::int64_t sum = static_cast<std::int64_t>(target) + static_cast<std::int64_t>(value);
+    target = static_cast<std::int32_t>(
+      std::clamp<std::int64_t>(
+        sum, std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max()
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a sample to another one</summary>
+  /// <param name="target">Sample to which the other sample will be added</param>
+  /// <param name="value">Sample that will be added to the target</param>
+  inline void accumulateSample(float &target, float value) {
+    target += value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a sample to another one</summary>
+  /// <param name="target">Sample to which the other sample will be added</param>
+  /// <param name="value">Sample that will be added to the target</param>
+  inline void accumulateSample(double &target, double value) {
+    target += value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes frames in small chunks and scatters them into a wider buffer</summary>
+  /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+  /// <param name="decoder">Decoder that will decode the frames</param>
+  /// <param name="buffer">Interleaved buffer into which the samples will be written</param>
+  /// <param name="frameStride">Number of samples in each frame of the buffer</param>
+  /// <param name="channelOffset">Buffer channel that receives the first channel</param>
+  /// <param name="startFrame">Index of the first frame to decode</param>
+  /// <param name="frameCount">Number of audio frames that will be decoded</param>
+  /// <param name="accumulate">Whether to add the samples to the buffer's contents</param>
+  template<typename TSample>
+  void decodeInterleavedStrided(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    TSample *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    if(unlikely(channelOffset + channelCount > frameStride)) {
+      throw std::invalid_argument(u8"Decoded channels would extend beyond the buffer's frames");
+    }
+
+    buffer += channelOffset;
+
+    // If the track fills the whole buffer, there's nothing to scatter
+    if((frameStride == channelCount) && !accumulate) {
+      decoder.DecodeInterleaved<TSample>(buffer, startFrame, frameCount);
+      return;
+    }
+
+    std::size_t chunkFrameCount = std::max<std::size_t>(NarrowingSampleCount / channelCount, 1);
+
+    // Tracks with more channels than fit into the stack buffer get a heap buffer
+    TSample stackSamples[NarrowingSampleCount];
+    std::vector<TSample> heapSamples;
+    TSample *samples = stackSamples;
+    if(unlikely(channelCount > NarrowingSampleCount)) {
+      heapSamples.resize(channelCount);
+      samples = heapSamples.data();
+    }
+
+    while(0 < frameCount) {
+      std::size_t decodeFrameCount = std::min(frameCount, chunkFrameCount);
+      decoder.DecodeInterleaved<TSample>(samples, startFrame, decodeFrameCount);
+
+      const TSample *source = samples;
+      for(std::size_t frameIndex = 0; frameIndex < decodeFrameCount; ++frameIndex) {
+        if(accumulate) {
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            accumulateSample(buffer[channelIndex], source[channelIndex]);
+          }
+        } else {
+          std::copy_n(source, channelCount, buffer);
+        }
+        source += channelCount;
+        buffer += frameStride;
+      }
+
+      startFrame += decodeFrameCount;
+      frameCount -= decodeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes frames in chunks and hands them to a sink</summary>
+  /// <typeparam name="TSample">Type of samples the frames will be decoded as</typeparam>
+  /// <param name="decoder">Decoder that will decode the frames</param>
+  /// <param name="format">Sample format that will be reported to the sink</param>
+  /// <param name="bitsPerSample">Number of valid bits that will be reported to the sink</param>
+  /// <param name="startFrame">Index of the first frame to decode</param>
+  /// <param name="frameCount">Number of audio frames that will be decoded</param>
+  /// <param name="sink">Sink that receives the decoded samples</param>
+  template<typename TSample>
+  void decodeIntoSink(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    Nuclex::Audio::AudioSampleFormat format, std::size_t bitsPerSample,
+    std::uint64_t startFrame, std::size_t frameCount,
+    Nuclex::Audio::Storage::DecodedSampleSink &sink
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    std::size_t chunkFrameCount = std::min(frameCount, SyntheticBlockSize);
+
+    // Decode in the layout the codec produces so the decoder does as little work as possible
+    Nuclex::Audio::SampleVector<TSample> samples(chunkFrameCount * channelCount);
+    std::vector<TSample *> channels(channelCount);
+    std::vector<const void *> buffers(channelCount);
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      channels[index] = samples.data() + (index * chunkFrameCount);
+      buffers[index] = channels[index];
+    }
+
+    Nuclex::Audio::Storage::DecodedSamples block;
+    block.Format = format;
+    block.BitsPerSample = bitsPerSample;
+    block.ChannelCount = channelCount;
+    block.IsInterleaved = decoder.IsNativelyInterleaved();
+    block.Buffers = buffers.data();
+
+    while(0 < frameCount) {
+      std::size_t blockFrameCount = std::min(frameCount, chunkFrameCount);
+      if(block.IsInterleaved) {
+        decoder.DecodeInterleaved<TSample>(samples.data(), startFrame, blockFrameCount);
+      } else {
+        decoder.DecodeSeparated<TSample>(channels.data(), startFrame, blockFrameCount);
+      }
+
+      // Decoders deliver integer samples left-aligned, but the sink expects them
+      // right-aligned. This only affects formats with less than 32 valid bits.
+      if constexpr(std::is_same<TSample, std::int32_t>::value) {
+        if(bitsPerSample < 32) {
+          std::size_t shift = 32 - bitsPerSample;
+          for(std::size_t index = 0; index < samples.size(); ++index) {
+            samples[index] >>= shift;
+          }
+        }
+      }
+
+      block.StartFrame = startFrame;
+      block.FrameCount = blockFrameCount;
+      sink.ProcessSamples(block);
+
+      startFrame += blockFrameCount;
+      frameCount -= blockFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::OpenRawPcm(
+    const std::shared_ptr<const VirtualFile> &file, const RawPcmLayout &layout
+  ) {
+    AllocationScope readerScope(AllocationSubsystem::ReaderScratch, AllocationCodec::Waveform);
+
+    return std::make_shared<Waveform::WaveformTrackDecoder>(
+      file, RawPcm::RawPcmReader::ReadLayout(file, layout), Shared::TrackedCodec::RawPcm
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreatePool(
+    const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t maximumDecoderCount
+  ) {
+    if(maximumDecoderCount == 0) {
+      maximumDecoderCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    return std::make_shared<PooledTrackDecoder>(decoder, maximumDecoderCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateParallel(
+    const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t threadCount
+  ) {
+    if(threadCount == 0) {
+      threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    return std::make_shared<ParallelTrackDecoder>(decoder, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateDownmix(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const Processing::DownmixMatrix &matrix
+  ) {
+    return std::make_shared<DownmixingTrackDecoder>(decoder, matrix);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateMixer(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const Processing::ChannelMixer &mixer
+  ) {
+    return std::make_shared<DownmixingTrackDecoder>(decoder, mixer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateResampler(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t inputSampleRate,
+    std::size_t outputSampleRate
+  ) {
+    return std::make_shared<ResamplingTrackDecoder>(decoder, inputSampleRate, outputSampleRate);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateDiskCached(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::string &cacheDirectory,
+    const std::string &identity,
+    std::size_t cacheBlockFrameCount /* = 65536 */
+  ) {
+    return std::make_shared<DiskCachedTrackDecoder>(
+      decoder, cacheDirectory, identity, cacheBlockFrameCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateSharedCached(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::shared_ptr<SharedSampleCache> &cache,
+    const std::string &identity
+  ) {
+    return std::make_shared<SharedCachedTrackDecoder>(decoder, cache, identity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> AudioTrackDecoder::CreateLooping(
+    const std::shared_ptr<AudioTrackDecoder> &decoder, const LoopRegion &loop
+  ) {
+    return std::make_shared<LoopingTrackDecoder>(decoder, loop);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TrySetChannelOrder(
+    const std::vector<ChannelPlacement> &channelOrder
+  ) {
+    return (channelOrder == GetChannelOrder());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TrySetDecodeSampleRate(std::size_t) {
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TrySetDecodeFidelity(DecodeFidelity fidelity) {
+    return (fidelity == DecodeFidelity::Standard);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TrySetReplayGain(ReplayGainMode mode) {
+    return (mode == ReplayGainMode::Off);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TrySetVerificationPolicy(VerificationPolicy policy) {
+    return (policy == VerificationPolicy::Off);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult AudioTrackDecoder::GetVerificationResult() const {
+    return VerificationResult::NotChecked;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeRange(
+    std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+  ) const {
+    switch(GetNativeSampleFormat()) {
+      case AudioSampleFormat::UnsignedInteger_8: {
+        decodeIntoSink<std::uint8_t>(
+          *this, AudioSampleFormat::UnsignedInteger_8, 8, startFrame, frameCount, sink
+        );
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_16: {
+        decodeIntoSink<std::int16_t>(
+          *this, AudioSampleFormat::SignedInteger_16, 16, startFrame, frameCount, sink
+        );
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_24: {
+        decodeIntoSink<std::int32_t>(
+          *this, AudioSampleFormat::SignedInteger_32, 24, startFrame, frameCount, sink
+        );
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_32: {
+        decodeIntoSink<std::int32_t>(
+          *this, AudioSampleFormat::SignedInteger_32, 32, startFrame, frameCount, sink
+        );
+        break;
+      }
+      case AudioSampleFormat::Float_64: {
+        decodeIntoSink<double>(
+          *this, AudioSampleFormat::Float_64, 64, startFrame, frameCount, sink
+        );
+        break;
+      }
+      default: {
+        decodeIntoSink<float>(
+          *this, AudioSampleFormat::Float_32, 32, startFrame, frameCount, sink
+        );
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t AudioTrackDecoder::GetBlockStart(std::uint64_t frameIndex) const {
+    std::size_t blockSize = GetNominalBlockSize();
+    return frameIndex - (frameIndex % blockSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AudioTrackDecoder::GetBlockSize(std::uint64_t frameIndex) const {
+    std::uint64_t frameCount = CountFrames();
+    if(frameIndex >= frameCount) {
+      return 0;
+    }
+
+    std::size_t blockSize = GetNominalBlockSize();
+    std::uint64_t blockStart = frameIndex - (frameIndex % blockSize);
+    return static_cast<std::size_t>(
+      std::min<std::uint64_t>(blockSize, frameCount - blockStart)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockContent AudioTrackDecoder::DescribeBlock(std::uint64_t frameIndex) const {
+    std::size_t blockSize = GetBlockSize(frameIndex);
+    if(unlikely(blockSize == 0)) {
+      throw std::out_of_range(u8"Frame index lies beyond the end of the audio track");
+    }
+
+    return BlockContent { GetBlockStart(frameIndex), blockSize, false, false, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<BlockContent> AudioTrackDecoder::ScanBlocks(
+    std::uint64_t startFrame, std::uint64_t frameCount
+  ) const {
+    std::vector<BlockContent> blocks;
+
+    std::uint64_t endFrame = startFrame + frameCount;
+    std::uint64_t frameIndex = startFrame;
+    while(frameIndex < endFrame) {
+      std::size_t blockSize = GetBlockSize(frameIndex);
+      if(blockSize == 0) {
+        break; // Range extends beyond the end of the audio track
+      }
+
+      BlockContent &block = blocks.emplace_back(DescribeBlock(frameIndex));
+      frameIndex = block.StartFrame + block.FrameCount;
+    }
+
+    return blocks;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AudioTrackDecoder::GetNominalBlockSize() const {
+    return SyntheticBlockSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedFloat16(
+    Float16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeInterleavedNarrowed(
+      *this, buffer, startFrame, frameCount, &Processing::ConversionKernels::ConvertToFloat16
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedBFloat16(
+    BFloat16 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeInterleavedNarrowed(
+      *this, buffer, startFrame, frameCount, &Processing::ConversionKernels::ConvertToBFloat16
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeSeparatedFloat16(
+    Float16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeSeparatedNarrowed(
+      *this, buffers, startFrame, frameCount, &Processing::ConversionKernels::ConvertToFloat16
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeSeparatedBFloat16(
+    BFloat16 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeSeparatedNarrowed(
+      *this, buffers, startFrame, frameCount, &Processing::ConversionKernels::ConvertToBFloat16
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedPackedInt24(
+    PackedInt24 *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeInterleavedNarrowed(*this, buffer, startFrame, frameCount, &packInt24);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeSeparatedPackedInt24(
+    PackedInt24 *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    decodeSeparatedNarrowed(*this, buffers, startFrame, frameCount, &packInt24);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedStridedUint8(
+    std::uint8_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) const {
+    decodeInterleavedStrided(
+      *this, buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedStridedInt16(
+    std::int16_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) const {
+    decodeInterleavedStrided(
+      *this, buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedStridedInt32(
+    std::int32_t *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) const {
+    decodeInterleavedStrided(
+      *this, buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedStridedFloat(
+    float *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) const {
+    decodeInterleavedStrided(
+      *this, buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::DecodeInterleavedStridedDouble(
+    double *buffer, std::size_t frameStride, std::size_t channelOffset,
+    std::uint64_t startFrame, std::size_t frameCount, bool accumulate
+  ) const {
+    decodeInterleavedStrided(
+      *this, buffer, frameStride, channelOffset, startFrame, frameCount, accumulate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::BuildSeekIndex() const {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> AudioTrackDecoder::SaveSeekIndex() const {
+    return std::vector<std::byte>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::LoadSeekIndex(const std::vector<std::byte> &) const {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::AllowFastSeeking(bool) const {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t AudioTrackDecoder::EstimateFrameCount() const {
+    return CountFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::ProvideFrameCount(std::uint64_t) const {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackDecoder::TryReopen(const std::shared_ptr<const VirtualFile> &) {
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackDecoder::EnableStatistics(bool) const {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics AudioTrackDecoder::GetStatistics() const {
+    return DecoderStatistics();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram AudioTrackDecoder::GetDecodeLatencies(bool) const {
+    return LatencyHistogram();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath AudioTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    AudioSampleFormat nativeFormat = GetNativeSampleFormat();
+    bool nativelyInterleaved = IsNativelyInterleaved();
+
+    Shared::DecodePathBuilder builder(
+      u8"Decoder", nativeFormat, nativelyInterleaved ? u8"interleaved" : u8"separated"
+    );
+    builder.AddPass(u8"decode");
+
+    // Without knowing the decoder's internals, assume that a different format or
+    // channel layout costs one conversion pass through an intermediate buffer
+    sampleFormat = Shared::DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    if(nativeFormat == AudioSampleFormat::SignedInteger_24) {
+      nativeFormat = AudioSampleFormat::SignedInteger_32;
+    }
+    bool needsConversion = (
+      (sampleFormat != nativeFormat) ||
+      (interleaved != nativelyInterleaved)
+    );
+    if(needsConversion) {
+      builder.AddScratchBuffer();
+      builder.AddPass(u8"convert");
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OutputFormat AudioTrackDecoder::NegotiateOutputFormat(
+    const std::vector<OutputFormat> &acceptableFormats
+  ) const {
+    if(unlikely(acceptableFormats.empty())) {
+      throw std::invalid_argument(u8"At least one acceptable output format must be provided");
+    }
+
+    AudioSampleFormat nativeFormat = Shared::DecodePathBuilder::GetDeliveredFormat(
+      GetNativeSampleFormat()
+    );
+    bool nativelyInterleaved = IsNativelyInterleaved();
+
+    // Conversions are often fused into a pass that happens anyway, so formats can tie
+    // on passes and scratch buffers. Those are ranked by how far they are from the native
+    // format. Only a strictly cheaper format replaces the best one, that way the caller's
+    // order decides between formats that take the same effort.
+    std::size_t bestIndex = 0;
+    std::size_t bestCost[3] = { 0, 0, 0 };
+    for(std::size_t index = 0; index < acceptableFormats.size(); ++index) {
+      const OutputFormat &format = acceptableFormats[index];
+      DecodePath path = ExplainDecodePath(format.SampleFormat, format.Interleaved);
+
+      std::size_t cost[3] = {
+        path.PassCount,
+        path.ScratchBufferCount,
+        (
+          std::size_t(
+            Shared::DecodePathBuilder::GetDeliveredFormat(format.SampleFormat) != nativeFormat
+          ) +
+          std::size_t(format.Interleaved != nativelyInterleaved)
+        )
+      };
+      if((index == 0) || std::lexicographical_compare(cost, cost + 3, bestCost, bestCost + 3)) {
+        std::copy_n(cost, 3, bestCost);
+        bestIndex = index;
+      }
+    }
+
+    return acceptableFormats[bestIndex];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost AudioTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+
+    // Without knowing the file size or how the decoder seeks, all that can be said is
+    // that decoding will resume at the start of the block the target frame is in
+    return SeekCost { 0, targetFrame - GetBlockStart(targetFrame), 1, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
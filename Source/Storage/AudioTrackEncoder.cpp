@@ -21,10 +21,138 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Processing/Int24Packing.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <algorithm> // for std::min(), std::max()
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of packed samples unpacked at a time before they're encoded</summary>
+  /// <remarks>
+  ///   These are kept on the stack as 32-bit integers. Together with the packed input,
+  ///   they take up 28 KiB, which stays in the L1 cache between unpacking and encoding
+  ///   on most processors.
+  /// </remarks>
+  const std::size_t UnpackingSampleCount = 4096;
+
+  /// <summary>Number of channels whose chunk pointers are kept on the stack</summary>
+  const std::size_t InlineChannelCount = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks 24-bit samples into full-range 32-bit integer samples</summary>
+  /// <param name="packed">Samples that will be unpacked</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  void unpackInt24(
+    const Nuclex::Audio::PackedInt24 *packed, std::int32_t *results, std::size_t count
+  ) {
+    Nuclex::Audio::Processing::Int24Packing::UnpackToHighInt32(
+      reinterpret_cast<const std::byte *>(packed), results, count
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<EncoderCpuMetrics> AudioTrackEncoder::GetCpuMetrics() const {
+    return std::optional<EncoderCpuMetrics>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackEncoder::TryReopen(const std::shared_ptr<VirtualFile> &target) {
+    if(Reopen(target)) {
+      this->consumedFrameCount = 0;
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AudioTrackEncoder::Reopen(const std::shared_ptr<VirtualFile> &) {
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackEncoder::EncodeInterleavedPackedInt24(
+    const PackedInt24 *buffer, std::size_t frameCount
+  ) {
+    std::size_t channelCount = GetChannelOrder().size();
+    std::size_t chunkFrameCount = std::max<std::size_t>(UnpackingSampleCount / channelCount, 1);
+
+    // Tracks with more channels than fit into the stack buffer get a heap buffer
+    std::int32_t stackSamples[UnpackingSampleCount];
+    std::vector<std::int32_t> heapSamples;
+    std::int32_t *samples = stackSamples;
+    if(unlikely(channelCount > UnpackingSampleCount)) {
+      heapSamples.resize(channelCount);
+      samples = heapSamples.data();
+    }
+
+    while(0 < frameCount) {
+      std::size_t encodeFrameCount = std::min(frameCount, chunkFrameCount);
+      std::size_t sampleCount = encodeFrameCount * channelCount;
+
+      unpackInt24(buffer, samples, sampleCount);
+      EncodeInterleavedInt32(samples, encodeFrameCount);
+
+      buffer += sampleCount;
+      frameCount -= encodeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AudioTrackEncoder::EncodeSeparatedPackedInt24(
+    const PackedInt24 *buffers[], std::size_t frameCount
+  ) {
+    std::size_t channelCount = GetChannelOrder().size();
+    std::size_t chunkFrameCount = std::max<std::size_t>(UnpackingSampleCount / channelCount, 1);
+
+    std::int32_t stackSamples[UnpackingSampleCount];
+    const std::int32_t *stackChannels[InlineChannelCount];
+    std::vector<std::int32_t> heapSamples;
+    std::vector<const std::int32_t *> heapChannels;
+    std::int32_t *samples = stackSamples;
+    const std::int32_t **channels = stackChannels;
+    if(unlikely(channelCount > InlineChannelCount)) {
+      heapChannels.resize(channelCount);
+      channels = heapChannels.data();
+      if(channelCount > UnpackingSampleCount) {
+        heapSamples.resize(channelCount);
+        samples = heapSamples.data();
+      }
+    }
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      channels[index] = samples + (index * chunkFrameCount);
+    }
+
+    std::size_t readFrameCount = 0;
+    while(readFrameCount < frameCount) {
+      std::size_t encodeFrameCount = std::min(frameCount - readFrameCount, chunkFrameCount);
+
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        unpackInt24(
+          buffers[index] + readFrameCount, samples + (index * chunkFrameCount), encodeFrameCount
+        );
+      }
+      EncodeSeparatedInt32(channels, encodeFrameCount);
+
+      readFrameCount += encodeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -75,10 +75,32 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  AudioTrackEncoderBuilder &AudioTrackEncoderBuilder::SetThreadCount(
+    std::size_t threadCount /* = 0 */
+  ) {
+    (void)threadCount;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &AudioTrackEncoderBuilder::SetCpuBudget(
+    const EncoderCpuBudget &budget
+  ) {
+    (void)budget;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::shared_ptr<AudioTrackEncoder> AudioTrackEncoderBuilder::Build(
-    const std::string &outputFilePath
+    const std::string &outputFilePath, std::uint64_t expectedByteCount /* = 0 */
   ) {
-    return Build(VirtualFile::OpenRealFileForWriting(outputFilePath));
+    return Build(
+      VirtualFile::OpenRealFileForWriting(
+        outputFilePath, FileAccessPattern::Normal, expectedByteCount
+      )
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
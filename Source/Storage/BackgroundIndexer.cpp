@@ -0,0 +1,689 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BackgroundIndexer.h"
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/InstrumentedFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Processing/LoudnessMeter.h"
+#include "Nuclex/Audio/Processing/PeakPyramid.h"
+#include "Nuclex/Audio/Executor.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsFileApi.h" // for WindowsFileApi
+#else
+#include "../Platform/PosixFileApi.h" // for PosixFileApi
+#endif
+
+#include <algorithm> // for std::min(), std::max()
+#include <chrono> // for std::chrono::steady_clock
+#include <condition_variable> // for std::condition_variable
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex
+#include <thread> // for std::this_thread::sleep_for()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded by a single step of the indexer</summary>
+  /// <remarks>
+  ///   Small enough that a step finishes within a few milliseconds, so a worker that
+  ///   picks up a step is quickly available again when more urgent work arrives.
+  /// </remarks>
+  const std::size_t StepFrameCount = 16384;
+
+  /// <summary>Longest time a step waits when the indexer is ahead of its read budget</summary>
+  const std::chrono::milliseconds MaximumThrottleDelay(50);
+
+  /// <summary>Number of new records after which a catalog is published by default</summary>
+  const std::size_t DefaultPublishInterval = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>File that is currently being decoded by the indexer</summary>
+  struct FileIndexingJob {
+
+    /// <summary>Path of the file being indexed</summary>
+    public: std::string Path;
+    /// <summary>Record that will be added to the catalog when the file is done</summary>
+    public: Nuclex::Audio::Storage::AssetRecord Record;
+    /// <summary>Wrapper around the file that counts the bytes read from it</summary>
+    public: std::shared_ptr<Nuclex::Audio::Storage::InstrumentedFile> File;
+    /// <summary>Decoder for the file's default track</summary>
+    public: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> Decoder;
+    /// <summary>Measures the loudness of the track as it is being decoded</summary>
+    public: std::unique_ptr<Nuclex::Audio::Processing::LoudnessMeter> Meter;
+    /// <summary>Collects the waveform overview of the track</summary>
+    public: std::unique_ptr<Nuclex::Audio::Processing::PeakPyramid> Pyramid;
+    /// <summary>Index of the next frame that will be decoded</summary>
+    public: std::uint64_t NextFrame;
+    /// <summary>Interleaved samples of the current step</summary>
+    public: std::vector<float> Interleaved;
+    /// <summary>Samples of the current step separated by channel</summary>
+    public: std::vector<std::vector<float>> Separated;
+    /// <summary>Number of bytes read from the file that were already accounted for</summary>
+    public: std::uint64_t CountedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size and last modification time of a file</summary>
+  /// <param name="path">Path of the file that will be looked up</param>
+  /// <param name="size">Receives the size of the file in bytes</param>
+  /// <param name="modificationTime">Receives the file's last modification time</param>
+  /// <returns>True if the file exists and its attributes could be read</returns>
+  bool tryGetFileIdentity(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    return Nuclex::Audio::Platform::WindowsFileApi::TryGetFileAttributes(
+      path, size, modificationTime
+    );
+#else
+    return Nuclex::Audio::Platform::PosixFileApi::TryStatFile(path, size, modificationTime);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves a file over another one, replacing it in a single step</summary>
+  /// <param name="sourcePath">Path of the file that will be moved</param>
+  /// <param name="targetPath">Path the file will be moved to</param>
+  void replaceFile(const std::string &sourcePath, const std::string &targetPath) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    Nuclex::Audio::Platform::WindowsFileApi::ReplaceFile(sourcePath, targetPath);
+#else
+    Nuclex::Audio::Platform::PosixFileApi::ReplaceFile(sourcePath, targetPath);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads an existing catalog into memory</summary>
+  /// <param name="path">Path of the catalog file</param>
+  /// <returns>The catalog or a null pointer if it didn't exist or couldn't be read</returns>
+  /// <remarks>
+  ///   The catalog is copied instead of mapped so that the file can be replaced
+  ///   while the catalog is in use, which Windows would not allow otherwise.
+  /// </remarks>
+  std::shared_ptr<const Nuclex::Audio::Storage::AssetCatalog> tryReadCatalog(
+    const std::string &path
+  ) {
+    using Nuclex::Audio::Storage::AssetCatalog;
+    using Nuclex::Audio::Storage::VirtualFile;
+    using Nuclex::Audio::Storage::WritableMemoryFile;
+
+    std::uint64_t size, modificationTime;
+    if(!tryGetFileIdentity(path, size, modificationTime)) {
+      return std::shared_ptr<const AssetCatalog>();
+    }
+
+    // A damaged or outdated catalog is no reason to fail, the files just get indexed again
+    try {
+      std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path);
+      std::size_t byteCount = static_cast<std::size_t>(file->GetSize());
+
+      std::vector<std::byte> contents(byteCount);
+      file->ReadAt(0, byteCount, contents.data());
+
+      std::shared_ptr<WritableMemoryFile> copy = std::make_shared<WritableMemoryFile>(byteCount);
+      copy->WriteAt(0, byteCount, contents.data());
+
+      return std::make_shared<AssetCatalog>(std::shared_ptr<const VirtualFile>(copy));
+    }
+    catch(const std::exception &) {
+      return std::shared_ptr<const AssetCatalog>();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the extension from a path for use as a codec hint</summary>
+  /// <param name="path">Path whose file extension will be returned</param>
+  /// <returns>The extension without the dot, or an empty string if there is none</returns>
+  std::string getExtension(const std::string &path) {
+    std::string::size_type dotIndex = path.find_last_of('.');
+    if(dotIndex == std::string::npos) {
+      return std::string();
+    }
+
+    std::string::size_type separatorIndex = path.find_last_of(u8"/\\");
+    if((separatorIndex != std::string::npos) && (separatorIndex > dotIndex)) {
+      return std::string();
+    }
+
+    return path.substr(dotIndex + 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct BackgroundIndexer::State {
+
+    /// <summary>Initializes the state of a new background indexer</summary>
+    /// <param name="catalogPath">Path of the catalog file that will be written</param>
+    /// <param name="loader">Audio loader that will receive new catalogs, can be null</param>
+    public: State(const std::string &catalogPath, const std::shared_ptr<AudioLoader> &loader);
+
+    /// <summary>Submits the next step of the indexer to the executor</summary>
+    /// <param name="self">Shared pointer to the state that the step will keep alive</param>
+    public: static void ScheduleStep(const std::shared_ptr<State> &self);
+
+    /// <summary>Performs a single step of indexing</summary>
+    /// <param name="self">Shared pointer to the state the step works on</param>
+    public: static void RunStep(const std::shared_ptr<State> &self);
+
+    /// <summary>Picks the next file from the queue and prepares it for decoding</summary>
+    /// <returns>True if a file was taken from the queue, false if the queue was empty</returns>
+    public: bool BeginNextFile();
+
+    /// <summary>Decodes the next chunk of the current file</summary>
+    /// <returns>True if the file has been decoded completely</returns>
+    public: bool DecodeStep();
+
+    /// <summary>Adds the record of the current file to the writer</summary>
+    public: void FinishFile();
+
+    /// <summary>Accounts for bytes the current file has read since the last check</summary>
+    public: void CountReadBytes();
+
+    /// <summary>Calculates how long the indexer has to wait to stay within its budget</summary>
+    /// <returns>The time to wait before the next step may read from disk</returns>
+    /// <remarks>Must be called with the mutex held</remarks>
+    public: std::chrono::steady_clock::duration GetThrottleDelay() const;
+
+    /// <summary>Writes the collected records as a new catalog and hands it out</summary>
+    public: void Publish();
+
+    /// <summary>Path of the catalog file that will be written</summary>
+    public: std::string CatalogPath;
+    /// <summary>Audio loader used to open the files</summary>
+    public: std::shared_ptr<AudioLoader> Loader;
+    /// <summary>Whether new catalogs will be handed to the audio loader</summary>
+    public: bool PublishToLoader;
+    /// <summary>Executor the steps are submitted to</summary>
+    public: std::shared_ptr<Executor> TargetExecutor;
+
+    /// <summary>Protects all fields below from concurrent access</summary>
+    public: mutable std::mutex Mutex;
+    /// <summary>Signalled when the indexer stops running</summary>
+    public: mutable std::condition_variable Stopped;
+    /// <summary>Paths of the files that still have to be indexed</summary>
+    public: std::deque<std::string> PendingPaths;
+    /// <summary>File that is being decoded, kept when the indexer is stopped</summary>
+    public: std::unique_ptr<FileIndexingJob> CurrentJob;
+    /// <summary>Collects the records of the catalog that will be published next</summary>
+    public: AssetCatalogWriter Writer;
+    /// <summary>Catalog that existed when the indexer was created</summary>
+    public: std::shared_ptr<const AssetCatalog> PreviousCatalog;
+    /// <summary>Catalog that was most recently published</summary>
+    public: std::shared_ptr<const AssetCatalog> PublishedCatalog;
+    /// <summary>Maximum number of bytes per second the indexer may read</summary>
+    public: std::size_t ReadBudget;
+    /// <summary>Number of new records after which a catalog is published</summary>
+    public: std::size_t PublishInterval;
+    /// <summary>Number of records added since the last catalog was published</summary>
+    public: std::size_t UnpublishedRecordCount;
+    /// <summary>Time from which the read budget is being measured</summary>
+    public: std::chrono::steady_clock::time_point BudgetStartTime;
+    /// <summary>Number of bytes read since the read budget started being measured</summary>
+    public: std::uint64_t BudgetByteCount;
+    /// <summary>Whether a step is currently scheduled or executing</summary>
+    public: bool IsRunning;
+    /// <summary>Whether the indexer has been asked to stop</summary>
+    public: bool IsStopRequested;
+    /// <summary>Progress reported to the user</summary>
+    public: BackgroundIndexProgress Progress;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BackgroundIndexer::State::State(
+    const std::string &catalogPath, const std::shared_ptr<AudioLoader> &loader
+  ) :
+    CatalogPath(catalogPath),
+    Loader(loader),
+    PublishToLoader(static_cast<bool>(loader)),
+    TargetExecutor(Executor::GetInstalled()),
+    Mutex(),
+    Stopped(),
+    PendingPaths(),
+    CurrentJob(),
+    Writer(),
+    PreviousCatalog(tryReadCatalog(catalogPath)),
+    PublishedCatalog(PreviousCatalog),
+    ReadBudget(0),
+    PublishInterval(DefaultPublishInterval),
+    UnpublishedRecordCount(0),
+    BudgetStartTime(),
+    BudgetByteCount(0),
+    IsRunning(false),
+    IsStopRequested(false),
+    Progress() {
+    if(!this->PublishToLoader) {
+      this->Loader = std::make_shared<AudioLoader>();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::State::ScheduleStep(const std::shared_ptr<State> &self) {
+    self->TargetExecutor->Submit(
+      [self]() { RunStep(self); }, TaskPriority::Idle
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::State::RunStep(const std::shared_ptr<State> &self) {
+    std::chrono::steady_clock::duration delay;
+    {
+      std::lock_guard<std::mutex> stateLock(self->Mutex);
+      if(self->IsStopRequested) {
+        self->IsRunning = false;
+        self->Stopped.notify_all();
+        return;
+      }
+      delay = self->GetThrottleDelay();
+    }
+
+    // When ahead of the budget, give the worker back after a short pause. The pause
+    // is capped so that Stop() never has to wait long for the step to notice.
+    if(delay > std::chrono::steady_clock::duration::zero()) {
+      std::this_thread::sleep_for(
+        std::min<std::chrono::steady_clock::duration>(delay, MaximumThrottleDelay)
+      );
+      ScheduleStep(self);
+      return;
+    }
+
+    bool isOutOfFiles = false;
+    if(!static_cast<bool>(self->CurrentJob)) {
+      isOutOfFiles = !self->BeginNextFile();
+    } else {
+      bool isFileComplete;
+      try {
+        isFileComplete = self->DecodeStep();
+        if(isFileComplete) {
+          self->FinishFile();
+        }
+      }
+      catch(const std::exception &) {
+        isFileComplete = true;
+        std::lock_guard<std::mutex> stateLock(self->Mutex);
+        ++self->Progress.FailedFileCount;
+      }
+      self->CountReadBytes();
+      if(isFileComplete) {
+        self->CurrentJob.reset();
+      }
+    }
+
+    bool shouldPublish;
+    {
+      std::lock_guard<std::mutex> stateLock(self->Mutex);
+      shouldPublish = (self->UnpublishedRecordCount > 0) && (
+        isOutOfFiles || (self->UnpublishedRecordCount >= self->PublishInterval)
+      );
+    }
+    if(shouldPublish) {
+      self->Publish();
+    }
+
+    if(isOutOfFiles) {
+      std::lock_guard<std::mutex> stateLock(self->Mutex);
+      self->IsRunning = false;
+      self->Stopped.notify_all();
+    } else {
+      ScheduleStep(self);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BackgroundIndexer::State::BeginNextFile() {
+    std::string path;
+    {
+      std::lock_guard<std::mutex> stateLock(this->Mutex);
+      if(this->PendingPaths.empty()) {
+        return false;
+      }
+      path = std::move(this->PendingPaths.front());
+      this->PendingPaths.pop_front();
+    }
+
+    std::unique_ptr<FileIndexingJob> job = std::make_unique<FileIndexingJob>();
+    job->Path = path;
+    job->NextFrame = 0;
+    job->CountedByteCount = 0;
+    if(!tryGetFileIdentity(path, job->Record.Size, job->Record.ModificationTime)) {
+      std::lock_guard<std::mutex> stateLock(this->Mutex);
+      ++this->Progress.FailedFileCount;
+      return true;
+    }
+
+    // If the existing catalog already knows the file in its current state, take it over
+    if(static_cast<bool>(this->PreviousCatalog)) {
+      std::optional<AssetRecord> previous = this->PreviousCatalog->TryLookup(path);
+      if(previous.has_value()) {
+        bool isUpToDate = (
+          (previous.value().Size == job->Record.Size) &&
+          (previous.value().ModificationTime == job->Record.ModificationTime)
+        );
+        if(isUpToDate) {
+          std::lock_guard<std::mutex> stateLock(this->Mutex);
+          this->Writer.Add(path, previous.value());
+          ++this->Progress.UpToDateFileCount;
+          return true;
+        }
+      }
+    }
+
+    try {
+      job->File = std::make_shared<InstrumentedFile>(VirtualFile::OpenRealFileForReading(path));
+      this->CurrentJob = std::move(job);
+
+      std::shared_ptr<const VirtualFile> file = this->CurrentJob->File;
+      std::string extension = getExtension(path);
+      this->CurrentJob->Record.Info = this->Loader->TryReadInfo(file, extension);
+
+      // Files the loader can't read still get a record so they're not probed again
+      const std::optional<ContainerInfo> &info = this->CurrentJob->Record.Info;
+      if(info.has_value() && !info.value().Tracks.empty()) {
+        this->CurrentJob->Decoder = this->Loader->OpenDecoder(
+          file, extension, info.value().DefaultTrackIndex
+        );
+
+        const AudioTrackDecoder &decoder = *this->CurrentJob->Decoder;
+        std::size_t channelCount = decoder.CountChannels();
+        this->CurrentJob->Meter = std::make_unique<Processing::LoudnessMeter>(
+          info.value().Tracks[info.value().DefaultTrackIndex].SampleRate,
+          decoder.GetChannelOrder()
+        );
+        this->CurrentJob->Pyramid = std::make_unique<Processing::PeakPyramid>(channelCount);
+        this->CurrentJob->Interleaved.resize(StepFrameCount * channelCount);
+        this->CurrentJob->Separated.resize(channelCount, std::vector<float>(StepFrameCount));
+      }
+    }
+    catch(const std::exception &) {
+      this->CountReadBytes();
+      this->CurrentJob.reset();
+
+      std::lock_guard<std::mutex> stateLock(this->Mutex);
+      ++this->Progress.FailedFileCount;
+      return true;
+    }
+
+    this->CountReadBytes();
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BackgroundIndexer::State::DecodeStep() {
+    FileIndexingJob &job = *this->CurrentJob;
+    if(!static_cast<bool>(job.Decoder)) {
+      return true;
+    }
+
+    std::uint64_t frameCount = job.Decoder->CountFrames();
+    if(job.NextFrame >= frameCount) {
+      return true;
+    }
+
+    std::size_t stepFrameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(frameCount - job.NextFrame, StepFrameCount)
+    );
+    job.Decoder->DecodeInterleaved<float>(job.Interleaved.data(), job.NextFrame, stepFrameCount);
+    job.Meter->ProcessInterleaved(job.Interleaved.data(), stepFrameCount);
+
+    std::size_t channelCount = job.Separated.size();
+    std::vector<const float *> channels(channelCount);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      float *channel = job.Separated[channelIndex].data();
+      const float *sample = job.Interleaved.data() + channelIndex;
+      for(std::size_t frameIndex = 0; frameIndex < stepFrameCount; ++frameIndex) {
+        channel[frameIndex] = *sample;
+        sample += channelCount;
+      }
+      channels[channelIndex] = channel;
+    }
+    job.Pyramid->ProcessSeparated(channels.data(), stepFrameCount);
+
+    job.NextFrame += stepFrameCount;
+    return (job.NextFrame >= frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::State::FinishFile() {
+    FileIndexingJob &job = *this->CurrentJob;
+    if(static_cast<bool>(job.Decoder)) {
+      job.Pyramid->Finish();
+      job.Record.PeakPyramid = job.Pyramid->Serialize();
+      job.Record.IntegratedLoudness = job.Meter->GetIntegratedLoudness();
+      job.Record.TruePeak = job.Meter->GetTruePeak();
+
+      job.Decoder->BuildSeekIndex();
+      job.Record.SeekIndex = job.Decoder->SaveSeekIndex();
+    }
+
+    std::lock_guard<std::mutex> stateLock(this->Mutex);
+    this->Writer.Add(job.Path, job.Record);
+    ++this->UnpublishedRecordCount;
+    ++this->Progress.IndexedFileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::State::CountReadBytes() {
+    if(!static_cast<bool>(this->CurrentJob) || !static_cast<bool>(this->CurrentJob->File)) {
+      return;
+    }
+
+    std::uint64_t byteCount = this->CurrentJob->File->GetSummary().ReadByteCount;
+    std::uint64_t newByteCount = byteCount - this->CurrentJob->CountedByteCount;
+    this->CurrentJob->CountedByteCount = byteCount;
+
+    std::lock_guard<std::mutex> stateLock(this->Mutex);
+    this->Progress.ReadByteCount += newByteCount;
+    this->BudgetByteCount += newByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::chrono::steady_clock::duration BackgroundIndexer::State::GetThrottleDelay() const {
+    if(this->ReadBudget == 0) {
+      return std::chrono::steady_clock::duration::zero();
+    }
+
+    // The time at which the bytes read so far would have been within budget
+    std::chrono::steady_clock::time_point allowedTime = (
+      this->BudgetStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(
+          static_cast<double>(this->BudgetByteCount) / static_cast<double>(this->ReadBudget)
+        )
+      )
+    );
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(allowedTime <= now) {
+      return std::chrono::steady_clock::duration::zero();
+    } else {
+      return allowedTime - now;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::State::Publish() {
+    std::shared_ptr<WritableMemoryFile> memory = std::make_shared<WritableMemoryFile>();
+    {
+      std::lock_guard<std::mutex> stateLock(this->Mutex);
+      this->Writer.Save(*memory);
+      this->UnpublishedRecordCount = 0;
+    }
+
+    std::shared_ptr<const AssetCatalog> catalog = std::make_shared<AssetCatalog>(
+      std::shared_ptr<const VirtualFile>(memory)
+    );
+
+    // Write under a temporary name first so the old catalog stays intact until
+    // the new one is complete, then replace it in a single step
+    std::exception_ptr error;
+    try {
+      std::string partialPath = this->CatalogPath + u8".partial";
+      {
+        std::size_t byteCount = static_cast<std::size_t>(memory->GetSize());
+        std::shared_ptr<VirtualFile> target = VirtualFile::OpenRealFileForWriting(
+          partialPath, true
+        );
+        target->WriteAt(0, byteCount, memory->TryBorrowAt(0, byteCount));
+        target->Flush();
+      }
+      replaceFile(partialPath, this->CatalogPath);
+    }
+    catch(const std::exception &) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> stateLock(this->Mutex);
+      this->PublishedCatalog = catalog;
+      this->Progress.PublishError = error;
+      ++this->Progress.PublishCount;
+    }
+
+    if(this->PublishToLoader) {
+      this->Loader->SetAssetCatalog(catalog);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BackgroundIndexer::BackgroundIndexer(
+    const std::string &catalogPath,
+    const std::shared_ptr<AudioLoader> &loader /* = std::shared_ptr<AudioLoader>() */
+  ) :
+    state(std::make_shared<State>(catalogPath, loader)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BackgroundIndexer::~BackgroundIndexer() {
+    Stop(false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::AddFile(const std::string &path) {
+    std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+    this->state->PendingPaths.push_back(path);
+    ++this->state->Progress.FileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::SetReadBudget(std::size_t bytesPerSecond) {
+    std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+    this->state->ReadBudget = bytesPerSecond;
+    this->state->BudgetStartTime = std::chrono::steady_clock::now();
+    this->state->BudgetByteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::SetPublishInterval(std::size_t fileCount) {
+    std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+    this->state->PublishInterval = std::max<std::size_t>(fileCount, 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::Start() {
+    {
+      std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+      if(this->state->IsRunning) {
+        this->state->IsStopRequested = false;
+        return;
+      }
+
+      this->state->IsRunning = true;
+      this->state->IsStopRequested = false;
+      this->state->BudgetStartTime = std::chrono::steady_clock::now();
+      this->state->BudgetByteCount = 0;
+    }
+
+    State::ScheduleStep(this->state);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::Stop(bool publish /* = true */) {
+    {
+      std::unique_lock<std::mutex> stateLock(this->state->Mutex);
+      this->state->IsStopRequested = true;
+      this->state->Stopped.wait(stateLock, [this]() { return !this->state->IsRunning; });
+      this->state->IsStopRequested = false;
+
+      publish &= (this->state->UnpublishedRecordCount > 0);
+    }
+
+    if(publish) {
+      this->state->Publish();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BackgroundIndexer::Wait() const {
+    std::unique_lock<std::mutex> stateLock(this->state->Mutex);
+    this->state->Stopped.wait(stateLock, [this]() { return !this->state->IsRunning; });
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BackgroundIndexProgress BackgroundIndexer::GetProgress() const {
+    std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+    return this->state->Progress;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const AssetCatalog> BackgroundIndexer::GetCatalog() const {
+    std::lock_guard<std::mutex> stateLock(this->state->Mutex);
+    return this->state->PublishedCatalog;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,835 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BatchTranscoder.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+#include "Nuclex/Audio/Storage/EncodingProgressListener.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Errors/CancelledError.h"
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+#include "Nuclex/Audio/Processing/LoudnessMeter.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Executor.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::steady_clock
+#include <cmath> // for std::pow(), std::isfinite()
+#include <condition_variable> // for std::condition_variable
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames decoded and handed to the encoder at once</summary>
+  const std::size_t ChunkFrameCount = 16384;
+
+  /// <summary>How long a thread waits before it looks for work again</summary>
+  const std::chrono::milliseconds IdleInterval(1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class FilePipeline;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unit of work for the thread pool, one stage of a file's pipeline</summary>
+  struct Task {
+
+    /// <summary>Pipeline of the file the stage belongs to</summary>
+    public: FilePipeline *Pipeline;
+    /// <summary>True for the encoding stage, false for decoding and processing</summary>
+    public: bool IsEncodingStage;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits the amount of memory held by decoded chunks</summary>
+  class InFlightBudget {
+
+    /// <summary>Initializes a new budget with the specified limit</summary>
+    /// <param name="maximumByteCount">Number of bytes that can be in flight at most</param>
+    public: explicit InFlightBudget(std::size_t maximumByteCount) :
+      mutex(),
+      released(),
+      maximumByteCount(maximumByteCount),
+      usedByteCount(0),
+      peakByteCount(0) {}
+
+    /// <summary>Tries to reserve memory for a chunk</summary>
+    /// <param name="byteCount">Number of bytes that should be reserved</param>
+    /// <returns>True if the memory was reserved, false if the budget is exhausted</returns>
+    /// <remarks>
+    ///   A chunk is always granted if nothing else is in flight, so chunks larger than
+    ///   the whole budget can't bring the batch to a halt.
+    /// </remarks>
+    public: bool TryAcquire(std::size_t byteCount) {
+      std::unique_lock<std::mutex> budgetLock(this->mutex);
+      if(
+        (this->usedByteCount > 0) &&
+        (this->usedByteCount + byteCount > this->maximumByteCount)
+      ) {
+        return false;
+      }
+
+      this->usedByteCount += byteCount;
+      this->peakByteCount = std::max(this->peakByteCount, this->usedByteCount);
+      return true;
+    }
+
+    /// <summary>Returns memory that was reserved for a chunk</summary>
+    /// <param name="byteCount">Number of bytes that are no longer in use</param>
+    public: void Release(std::size_t byteCount) {
+      {
+        std::unique_lock<std::mutex> budgetLock(this->mutex);
+        this->usedByteCount -= byteCount;
+      }
+      this->released.notify_all();
+    }
+
+    /// <summary>Waits a short time for memory to be released</summary>
+    public: void WaitForRelease() {
+      std::unique_lock<std::mutex> budgetLock(this->mutex);
+      this->released.wait_for(budgetLock, IdleInterval);
+    }
+
+    /// <summary>Returns the largest number of bytes that were in flight at once</summary>
+    /// <returns>The peak memory use of the decoded chunks</returns>
+    public: std::size_t GetPeakByteCount() {
+      std::unique_lock<std::mutex> budgetLock(this->mutex);
+      return this->peakByteCount;
+    }
+
+    /// <summary>Must be held while accessing the byte counts</summary>
+    private: std::mutex mutex;
+    /// <summary>Signalled when memory has been returned to the budget</summary>
+    private: std::condition_variable released;
+    /// <summary>Number of bytes that can be in flight at most</summary>
+    private: std::size_t maximumByteCount;
+    /// <summary>Number of bytes that are currently in flight</summary>
+    private: std::size_t usedByteCount;
+    /// <summary>Largest number of bytes that were in flight at once</summary>
+    private: std::size_t peakByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Distributes pipeline stages over threads that steal work from each other</summary>
+  class WorkStealingScheduler {
+
+    /// <summary>Initializes a new scheduler for the specified number of threads</summary>
+    /// <param name="threadCount">Number of threads that will be taking tasks</param>
+    /// <param name="jobCount">Number of jobs that have to complete</param>
+    public: WorkStealingScheduler(std::size_t threadCount, std::size_t jobCount) :
+      queues(threadCount),
+      remainingJobCount(jobCount),
+      stolenTaskCount(0) {}
+
+    /// <summary>Queues a task at the back of a thread's queue</summary>
+    /// <param name="threadIndex">Index of the thread whose queue will receive the task</param>
+    /// <param name="task">Task that will be queued</param>
+    public: void Append(std::size_t threadIndex, const Task &task) {
+      WorkerQueue &queue = this->queues[threadIndex];
+      std::unique_lock<std::mutex> queueLock(queue.Mutex);
+      queue.Tasks.push_back(task);
+    }
+
+    /// <summary>Queues a task at the front of a thread's queue</summary>
+    /// <param name="threadIndex">Index of the thread whose queue will receive the task</param>
+    /// <param name="task">Task that will be queued</param>
+    public: void Prepend(std::size_t threadIndex, const Task &task) {
+      WorkerQueue &queue = this->queues[threadIndex];
+      std::unique_lock<std::mutex> queueLock(queue.Mutex);
+      queue.Tasks.push_front(task);
+    }
+
+    /// <summary>Takes the next task, either from the thread's queue or another one's</summary>
+    /// <param name="threadIndex">Index of the thread that is looking for work</param>
+    /// <param name="task">Receives the task that was taken</param>
+    /// <returns>True if a task was taken, false if all queues are empty</returns>
+    public: bool TryTake(std::size_t threadIndex, Task &task) {
+      {
+        WorkerQueue &ownQueue = this->queues[threadIndex];
+        std::unique_lock<std::mutex> queueLock(ownQueue.Mutex);
+        if(!ownQueue.Tasks.empty()) {
+          task = ownQueue.Tasks.front();
+          ownQueue.Tasks.pop_front();
+          return true;
+        }
+      }
+
+      // Our own queue is empty, steal from the back of the other threads' queues,
+      // which is where the files nobody has started on yet are waiting
+      std::size_t queueCount = this->queues.size();
+      for(std::size_t offset = 1; offset < queueCount; ++offset) {
+        WorkerQueue &victimQueue = this->queues[(threadIndex + offset) % queueCount];
+        std::unique_lock<std::mutex> queueLock(victimQueue.Mutex);
+        if(!victimQueue.Tasks.empty()) {
+          task = victimQueue.Tasks.back();
+          victimQueue.Tasks.pop_back();
+          this->stolenTaskCount.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /// <summary>Takes a waiting encoding stage from any of the queues</summary>
+    /// <param name="threadIndex">Index of the thread that is looking for work</param>
+    /// <param name="task">Receives the task that was taken</param>
+    /// <returns>True if an encoding stage was taken, false if there was none</returns>
+    /// <remarks>
+    ///   Used by decoding threads waiting for memory. Encoding stages never wait for
+    ///   anything, so running one in the middle of a decoding stage can't deadlock.
+    /// </remarks>
+    public: bool TryTakeEncodingStage(std::size_t threadIndex, Task &task) {
+      std::size_t queueCount = this->queues.size();
+      for(std::size_t offset = 0; offset < queueCount; ++offset) {
+        WorkerQueue &queue = this->queues[(threadIndex + offset) % queueCount];
+        std::unique_lock<std::mutex> queueLock(queue.Mutex);
+
+        // Encoding stages are queued at the front, so they'll be found quickly
+        for(auto iterator = queue.Tasks.begin(); iterator != queue.Tasks.end(); ++iterator) {
+          if(iterator->IsEncodingStage) {
+            task = *iterator;
+            queue.Tasks.erase(iterator);
+            return true;
+          }
+        }
+      }
+
+      return false;
+    }
+
+    /// <summary>Reports that a job has been completed (or has failed)</summary>
+    public: void CompleteJob() {
+      this->remainingJobCount.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// <summary>Checks whether all jobs have been completed</summary>
+    /// <returns>True if there is nothing left to do</returns>
+    public: bool IsFinished() const {
+      return (this->remainingJobCount.load(std::memory_order_acquire) == 0);
+    }
+
+    /// <summary>Counts the tasks that were stolen from another thread's queue</summary>
+    /// <returns>The number of tasks that have been stolen</returns>
+    public: std::size_t CountStolenTasks() const {
+      return this->stolenTaskCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Queue of tasks belonging to one thread</summary>
+    private: struct WorkerQueue {
+
+      /// <summary>Must be held while accessing the tasks</summary>
+      public: std::mutex Mutex;
+      /// <summary>Tasks waiting to be taken</summary>
+      public: std::deque<Task> Tasks;
+
+    };
+
+    /// <summary>Task queues of all threads</summary>
+    private: std::vector<WorkerQueue> queues;
+    /// <summary>Number of jobs that have not completed yet</summary>
+    private: std::atomic<std::size_t> remainingJobCount;
+    /// <summary>Number of tasks that were stolen from another thread's queue</summary>
+    private: std::atomic<std::size_t> stolenTaskCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>State shared by all pipelines of a batch</summary>
+  struct BatchState {
+
+    /// <summary>Loader that opens decoders for the source files</summary>
+    public: const Nuclex::Audio::Storage::AudioLoader *Loader;
+    /// <summary>Hands out the pipeline stages to the threads</summary>
+    public: WorkStealingScheduler *Scheduler;
+    /// <summary>Keeps the decoded chunks within the memory budget</summary>
+    public: InFlightBudget *Budget;
+    /// <summary>Must be held while configuring an encoder builder</summary>
+    public: std::mutex BuilderMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes, processes and encodes a single file</summary>
+  class FilePipeline {
+
+    /// <summary>Initializes a new pipeline for the specified job</summary>
+    /// <param name="batch">State shared by all pipelines of the batch</param>
+    /// <param name="job">Job the pipeline will run</param>
+    public: FilePipeline(BatchState &batch, const Nuclex::Audio::Storage::TranscodeJob &job) :
+      batch(batch),
+      job(job),
+      decoder(),
+      encoder(),
+      channelCount(0),
+      sampleRate(0),
+      gain(1.0f),
+      mutex(),
+      pendingChunks(),
+      recycledChunks(),
+      isEncoding(false),
+      isDecodingFinished(false),
+      isCompleted(false),
+      error(),
+      encodedFrameCount(0),
+      writtenByteCount(0) {}
+
+    /// <summary>Decodes and processes the file, queueing chunks for the encoder</summary>
+    /// <param name="threadIndex">Index of the thread running the stage</param>
+    public: void RunDecodingStage(std::size_t threadIndex) {
+      try {
+        open();
+
+        std::uint64_t frameCount = this->decoder->CountFrames();
+        std::uint64_t cursor = 0;
+        while(cursor < frameCount) {
+          throwIfCancelled();
+          if(hasFailed()) {
+            break; // The encoder failed, no point in decoding any further
+          }
+
+          std::size_t chunkFrameCount = static_cast<std::size_t>(
+            std::min<std::uint64_t>(frameCount - cursor, ChunkFrameCount)
+          );
+          acquireBudget(threadIndex);
+
+          Chunk chunk = takeRecycledChunk();
+          chunk.FrameCount = chunkFrameCount;
+
+          std::vector<float *> channels(this->channelCount);
+          for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+            channels[channelIndex] = chunk.Samples.data() + (channelIndex * ChunkFrameCount);
+          }
+          try {
+            this->decoder->DecodeSeparated(channels.data(), cursor, chunkFrameCount);
+          }
+          catch(...) {
+            this->batch.Budget->Release(getChunkByteCount());
+            throw;
+          }
+
+          cursor += chunkFrameCount;
+          queueChunk(threadIndex, std::move(chunk));
+        }
+      }
+      catch(...) {
+        fail(std::current_exception());
+      }
+
+      // Make sure the encoding stage runs once more to flush the encoder
+      // (or to clean up if decoding failed)
+      bool mustScheduleEncoding;
+      {
+        std::unique_lock<std::mutex> pipelineLock(this->mutex);
+        this->isDecodingFinished = true;
+        mustScheduleEncoding = !this->isEncoding;
+        this->isEncoding = true;
+      }
+      if(mustScheduleEncoding) {
+        this->batch.Scheduler->Prepend(threadIndex, Task { this, true });
+      }
+    }
+
+    /// <summary>Encodes the queued chunks and completes the job once all are done</summary>
+    public: void RunEncodingStage() {
+      for(;;) {
+        Chunk chunk;
+        bool hasFailed;
+        {
+          std::unique_lock<std::mutex> pipelineLock(this->mutex);
+          if(this->pendingChunks.empty()) {
+            if(this->isDecodingFinished && !this->isCompleted) {
+              this->isCompleted = true;
+              pipelineLock.unlock();
+              complete();
+            } else {
+              this->isEncoding = false;
+            }
+            return;
+          }
+
+          chunk = std::move(this->pendingChunks.front());
+          this->pendingChunks.pop_front();
+          hasFailed = static_cast<bool>(this->error);
+        }
+
+        // If an error occurred, chunks are only dropped so their memory is released
+        if(!hasFailed) {
+          try {
+            encodeChunk(chunk);
+          }
+          catch(...) {
+            fail(std::current_exception());
+
+            // Nothing more will be encoded, so let go of the codec's resources now
+            // rather than when the decoding stage has noticed the failure
+            this->encoder.reset();
+          }
+        }
+
+        this->batch.Budget->Release(getChunkByteCount());
+        {
+          std::unique_lock<std::mutex> pipelineLock(this->mutex);
+          this->recycledChunks.push_back(std::move(chunk.Samples));
+        }
+      }
+    }
+
+    /// <summary>Returns the error that made the job fail, if any</summary>
+    /// <returns>The error that occurred or an empty exception pointer</returns>
+    public: std::exception_ptr GetError() const { return this->error; }
+
+    /// <summary>Counts the audio frames that have been encoded</summary>
+    /// <returns>The number of encoded audio frames</returns>
+    public: std::uint64_t CountEncodedFrames() const { return this->encodedFrameCount; }
+
+    /// <summary>Returns the sample rate at which audio was encoded</summary>
+    /// <returns>The sample rate of the encoded audio</returns>
+    public: std::size_t GetSampleRate() const { return this->sampleRate; }
+
+    /// <summary>Counts the bytes that were written into the target file</summary>
+    /// <returns>The size of the target file</returns>
+    public: std::uint64_t CountWrittenBytes() const { return this->writtenByteCount; }
+
+    /// <summary>Decoded audio frames waiting to be encoded</summary>
+    private: struct Chunk {
+
+      /// <summary>Channels of the decoded audio, one after another</summary>
+      public: Nuclex::Audio::SampleVector<float> Samples;
+      /// <summary>Number of audio frames in each channel</summary>
+      public: std::size_t FrameCount;
+
+    };
+
+    /// <summary>Opens the source, sets up processing and builds the encoder</summary>
+    private: void open() {
+      using Nuclex::Audio::ChannelPlacement;
+      using Nuclex::Audio::Storage::AudioTrackDecoder;
+      using Nuclex::Audio::Processing::ChannelMixer;
+      using Nuclex::Audio::Processing::DownmixMatrix;
+
+      std::optional<Nuclex::Audio::ContainerInfo> info = this->batch.Loader->TryReadInfo(
+        this->job.Source, this->job.SourceExtensionHint
+      );
+      if(!info.has_value() || info.value().Tracks.empty()) {
+        throw Nuclex::Audio::Errors::UnsupportedFormatError(
+          u8"Not an audio file or file format not supported"
+        );
+      }
+      this->sampleRate = info.value().Tracks[info.value().DefaultTrackIndex].SampleRate;
+      this->decoder = this->batch.Loader->OpenDecoder(
+        this->job.Source, this->job.SourceExtensionHint, info.value().DefaultTrackIndex
+      );
+
+      // Remix the channels if the job asks for a different layout
+      const std::vector<ChannelPlacement> &targetChannels = this->job.TargetChannels;
+      if(!targetChannels.empty() && (targetChannels != this->decoder->GetChannelOrder())) {
+        const std::vector<ChannelPlacement> &sourceChannels = this->decoder->GetChannelOrder();
+        bool isStereoTarget = (
+          (targetChannels.size() == 2) &&
+          (targetChannels[0] == ChannelPlacement::FrontLeft) &&
+          (targetChannels[1] == ChannelPlacement::FrontRight)
+        );
+        bool isMonoTarget = (
+          (targetChannels.size() == 1) && (targetChannels[0] == ChannelPlacement::FrontCenter)
+        );
+
+        if(sourceChannels.size() > targetChannels.size() && isStereoTarget) {
+          this->decoder = AudioTrackDecoder::CreateDownmix(
+            this->decoder, DownmixMatrix::CreateItuStereo(sourceChannels)
+          );
+        } else if(sourceChannels.size() > targetChannels.size() && isMonoTarget) {
+          this->decoder = AudioTrackDecoder::CreateDownmix(
+            this->decoder, DownmixMatrix::CreateItuMono(sourceChannels)
+          );
+        } else if(sourceChannels.size() < targetChannels.size()) {
+          this->decoder = AudioTrackDecoder::CreateMixer(
+            this->decoder, ChannelMixer::CreateUpmix(sourceChannels, targetChannels)
+          );
+        } else {
+          this->decoder = AudioTrackDecoder::CreateMixer(
+            this->decoder, ChannelMixer::CreateRouting(sourceChannels, targetChannels)
+          );
+        }
+      }
+
+      // Resample if the job asks for a different sample rate
+      if(this->job.TargetSampleRate.has_value()) {
+        std::size_t targetSampleRate = this->job.TargetSampleRate.value();
+        if(targetSampleRate != this->sampleRate) {
+          this->decoder = AudioTrackDecoder::CreateResampler(
+            this->decoder, this->sampleRate, targetSampleRate
+          );
+          this->sampleRate = targetSampleRate;
+        }
+      }
+
+      throwIfCancelled();
+
+      this->channelCount = this->decoder->CountChannels();
+      if(this->job.TargetLoudness.has_value()) {
+        this->gain = measureNormalizationGain(this->job.TargetLoudness.value());
+      }
+
+      // Builders may be shared between jobs, so configuring the builder and
+      // building the encoder has to happen in one go
+      {
+        std::unique_lock<std::mutex> builderLock(this->batch.BuilderMutex);
+        this->encoder = this->job.TargetBuilder->
+          SetChannels(this->decoder->GetChannelOrder()).
+          SetSampleRate(this->sampleRate).
+          Build(this->job.Target);
+      }
+      this->encoder->SetProgressListener(this->job.Progress);
+      this->encoder->SetCancellationToken(this->job.Cancellation);
+    }
+
+    /// <summary>Measures the loudness of the processed audio to normalize it</summary>
+    /// <param name="targetLoudness">Integrated loudness the audio should end up at</param>
+    /// <returns>The factor by which the samples need to be multiplied</returns>
+    private: float measureNormalizationGain(double targetLoudness) {
+      Nuclex::Audio::Processing::LoudnessMeter meter(
+        this->sampleRate, this->decoder->GetChannelOrder()
+      );
+
+      std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> measuringDecoder = (
+        this->decoder->Clone()
+      );
+      Nuclex::Audio::SampleVector<float> samples(ChunkFrameCount * this->channelCount);
+
+      std::uint64_t frameCount = measuringDecoder->CountFrames();
+      for(std::uint64_t cursor = 0; cursor < frameCount; cursor += ChunkFrameCount) {
+        std::size_t chunkFrameCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(frameCount - cursor, ChunkFrameCount)
+        );
+        throwIfCancelled();
+        measuringDecoder->DecodeInterleaved(samples.data(), cursor, chunkFrameCount);
+        meter.ProcessInterleaved(samples.data(), chunkFrameCount);
+      }
+
+      // Silent files have no integrated loudness, there's nothing to normalize
+      double loudness = meter.GetIntegratedLoudness();
+      if(!std::isfinite(loudness)) {
+        return 1.0f;
+      }
+
+      return static_cast<float>(std::pow(10.0, (targetLoudness - loudness) / 20.0));
+    }
+
+    /// <summary>Checks whether an error has made the job fail</summary>
+    /// <returns>True if the job has failed</returns>
+    private: bool hasFailed() {
+      std::unique_lock<std::mutex> pipelineLock(this->mutex);
+      return static_cast<bool>(this->error);
+    }
+
+    /// <summary>Records the error that made the job fail</summary>
+    /// <param name="failure">Error that occurred</param>
+    /// <remarks>Only the first error is kept, later ones are usually a consequence</remarks>
+    private: void fail(const std::exception_ptr &failure) {
+      std::unique_lock<std::mutex> pipelineLock(this->mutex);
+      if(!static_cast<bool>(this->error)) {
+        this->error = failure;
+      }
+    }
+
+    /// <summary>Throws a cancelled error if the job has been cancelled</summary>
+    private: void throwIfCancelled() const {
+      if(static_cast<bool>(this->job.Cancellation)) {
+        this->job.Cancellation->ThrowIfCancellationRequested();
+      }
+    }
+
+    /// <summary>Reserves memory for a chunk, helping the encoders while there is none</summary>
+    /// <param name="threadIndex">Index of the thread running the decoding stage</param>
+    private: void acquireBudget(std::size_t threadIndex) {
+      std::size_t byteCount = getChunkByteCount();
+      while(!this->batch.Budget->TryAcquire(byteCount)) {
+        Task task;
+        if(this->batch.Scheduler->TryTakeEncodingStage(threadIndex, task)) {
+          task.Pipeline->RunEncodingStage();
+        } else {
+          this->batch.Budget->WaitForRelease();
+        }
+      }
+    }
+
+    /// <summary>Hands a decoded chunk to the encoding stage</summary>
+    /// <param name="threadIndex">Index of the thread running the decoding stage</param>
+    /// <param name="chunk">Chunk that will be encoded</param>
+    private: void queueChunk(std::size_t threadIndex, Chunk &&chunk) {
+      bool mustScheduleEncoding;
+      {
+        std::unique_lock<std::mutex> pipelineLock(this->mutex);
+        this->pendingChunks.push_back(std::move(chunk));
+        mustScheduleEncoding = !this->isEncoding;
+        this->isEncoding = true;
+      }
+
+      // Queue the encoding stage at the front so this thread picks it up next
+      // and any idle thread stealing from us does so, too
+      if(mustScheduleEncoding) {
+        this->batch.Scheduler->Prepend(threadIndex, Task { this, true });
+      }
+    }
+
+    /// <summary>Provides a buffer for a chunk, reusing an encoded one if possible</summary>
+    /// <returns>An empty chunk with room for the maximum number of frames</returns>
+    private: Chunk takeRecycledChunk() {
+      Chunk chunk;
+      {
+        std::unique_lock<std::mutex> pipelineLock(this->mutex);
+        if(!this->recycledChunks.empty()) {
+          chunk.Samples = std::move(this->recycledChunks.back());
+          this->recycledChunks.pop_back();
+        }
+      }
+      if(chunk.Samples.empty()) {
+        chunk.Samples.resize(ChunkFrameCount * this->channelCount);
+      }
+
+      return chunk;
+    }
+
+    /// <summary>Applies the normalization gain and encodes a chunk</summary>
+    /// <param name="chunk">Chunk that will be encoded</param>
+    private: void encodeChunk(Chunk &chunk) {
+      std::vector<const float *> channels(this->channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        float *samples = chunk.Samples.data() + (channelIndex * ChunkFrameCount);
+        if(this->gain != 1.0f) {
+          for(std::size_t index = 0; index < chunk.FrameCount; ++index) {
+            samples[index] *= this->gain;
+          }
+        }
+        channels[channelIndex] = samples;
+      }
+
+      this->encoder->EncodeSeparated(channels.data(), chunk.FrameCount);
+      this->encodedFrameCount += chunk.FrameCount;
+    }
+
+    /// <summary>Flushes the encoder and releases the codecs</summary>
+    private: void complete() {
+      if(!static_cast<bool>(this->error)) {
+        try {
+          this->encoder->Flush();
+          this->writtenByteCount = this->job.Target->GetSize();
+        }
+        catch(...) {
+          this->error = std::current_exception();
+        }
+      }
+
+      this->encoder.reset();
+      this->decoder.reset();
+      this->recycledChunks.clear();
+
+      this->batch.Scheduler->CompleteJob();
+    }
+
+    /// <summary>Calculates the number of bytes a chunk of the file occupies</summary>
+    /// <returns>The size of a chunk in bytes</returns>
+    private: std::size_t getChunkByteCount() const {
+      return ChunkFrameCount * this->channelCount * sizeof(float);
+    }
+
+    /// <summary>State shared by all pipelines of the batch</summary>
+    private: BatchState &batch;
+    /// <summary>Job the pipeline is running</summary>
+    private: const Nuclex::Audio::Storage::TranscodeJob &job;
+    /// <summary>Decoder delivering the processed audio of the source file</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder;
+    /// <summary>Encoder writing the target file</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> encoder;
+    /// <summary>Number of channels after processing</summary>
+    private: std::size_t channelCount;
+    /// <summary>Sample rate after processing</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Factor the samples are multiplied by to normalize the loudness</summary>
+    private: float gain;
+    /// <summary>Must be held while accessing the chunk queues and stage flags</summary>
+    private: std::mutex mutex;
+    /// <summary>Decoded chunks waiting for the encoder</summary>
+    private: std::deque<Chunk> pendingChunks;
+    /// <summary>Buffers of chunks that have been encoded, for reuse</summary>
+    private: std::vector<Nuclex::Audio::SampleVector<float>> recycledChunks;
+    /// <summary>Whether the encoding stage is running or queued</summary>
+    private: bool isEncoding;
+    /// <summary>Whether the decoding stage has delivered its last chunk</summary>
+    private: bool isDecodingFinished;
+    /// <summary>Whether the job has been completed</summary>
+    private: bool isCompleted;
+    /// <summary>Error that made the job fail</summary>
+    private: std::exception_ptr error;
+    /// <summary>Number of audio frames that have been encoded</summary>
+    private: std::uint64_t encodedFrameCount;
+    /// <summary>Size of the target file after the encoder was flushed</summary>
+    private: std::uint64_t writtenByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Takes and runs pipeline stages until all jobs are completed</summary>
+  /// <param name="scheduler">Scheduler handing out the pipeline stages</param>
+  /// <param name="threadIndex">Index of the thread running the method</param>
+  void runWorker(WorkStealingScheduler &scheduler, std::size_t threadIndex) {
+    while(!scheduler.IsFinished()) {
+      Task task;
+      if(scheduler.TryTake(threadIndex, task)) {
+        if(task.IsEncodingStage) {
+          task.Pipeline->RunEncodingStage();
+        } else {
+          task.Pipeline->RunDecodingStage(threadIndex);
+        }
+      } else {
+        std::this_thread::sleep_for(IdleInterval);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BatchTranscoder::BatchTranscoder(
+    std::size_t threadCount /* = 0 */,
+    std::size_t maximumInFlightByteCount /* = 64 * 1024 * 1024 */
+  ) :
+    threadCount(threadCount),
+    maximumInFlightByteCount(maximumInFlightByteCount),
+    loader(std::make_shared<AudioLoader>()),
+    jobs() {
+    if(this->threadCount == 0) {
+      this->threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BatchTranscoder::~BatchTranscoder() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BatchTranscoder::AddJob(const TranscodeJob &job) {
+    if(!static_cast<bool>(job.Source) || !static_cast<bool>(job.Target)) {
+      throw std::invalid_argument(u8"Transcode jobs need a source and a target file");
+    }
+    if(!static_cast<bool>(job.TargetBuilder)) {
+      throw std::invalid_argument(u8"Transcode jobs need an encoder builder");
+    }
+
+    this->jobs.push_back(job);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TranscodeStatistics BatchTranscoder::Run() {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    std::size_t jobCount = this->jobs.size();
+    WorkStealingScheduler scheduler(this->threadCount, jobCount);
+    InFlightBudget budget(this->maximumInFlightByteCount);
+
+    BatchState batch;
+    batch.Loader = this->loader.get();
+    batch.Scheduler = &scheduler;
+    batch.Budget = &budget;
+
+    // Spread the jobs over the threads' queues round-robin
+    std::vector<std::unique_ptr<FilePipeline>> pipelines;
+    pipelines.reserve(jobCount);
+    for(std::size_t index = 0; index < jobCount; ++index) {
+      pipelines.push_back(std::make_unique<FilePipeline>(batch, this->jobs[index]));
+      scheduler.Append(index % this->threadCount, Task { pipelines.back().get(), false });
+    }
+
+    // The calling thread acts as a worker, too. Workers steal from each other's queues,
+    // so the batch finishes even if the executor can't spare any of its threads.
+    Executor::GetInstalled()->ParallelFor(
+      this->threadCount,
+      [&scheduler](std::size_t threadIndex) { runWorker(scheduler, threadIndex); },
+      TaskPriority::Low
+    );
+
+    TranscodeStatistics statistics = TranscodeStatistics();
+    statistics.Errors.reserve(jobCount);
+    for(const std::unique_ptr<FilePipeline> &pipeline : pipelines) {
+      std::exception_ptr error = pipeline->GetError();
+      if(static_cast<bool>(error)) {
+        ++statistics.FailedJobCount;
+        try {
+          std::rethrow_exception(error);
+        }
+        catch(const Errors::CancelledError &) {
+          ++statistics.CancelledJobCount;
+        }
+        catch(...) {} // Any other error, the caller can inspect it via the error list
+      } else {
+        ++statistics.SucceededJobCount;
+        statistics.WrittenByteCount += pipeline->CountWrittenBytes();
+      }
+      statistics.Errors.push_back(error);
+
+      statistics.EncodedFrameCount += pipeline->CountEncodedFrames();
+      if(pipeline->GetSampleRate() > 0) {
+        statistics.EncodedSeconds += (
+          static_cast<double>(pipeline->CountEncodedFrames()) /
+          static_cast<double>(pipeline->GetSampleRate())
+        );
+      }
+    }
+    statistics.PeakInFlightByteCount = budget.GetPeakByteCount();
+    statistics.StolenTaskCount = scheduler.CountStolenTasks();
+    statistics.ElapsedSeconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime
+    ).count();
+
+    this->jobs.clear();
+    return statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,257 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "BinarySerialization.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "./EndianReader.h" // for LittleEndianReader
+
+#include <cstring> // for std::memcpy()
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteUInt32(std::uint32_t value) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      this->Buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteUInt64(std::uint64_t value) {
+    for(std::size_t index = 0; index < 8; ++index) {
+      this->Buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::PatchUInt64(std::size_t position, std::uint64_t value) {
+    for(std::size_t index = 0; index < 8; ++index) {
+      this->Buffer.at(position + index) = static_cast<std::byte>(value >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteDouble(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteUInt64(bits);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteString(const std::string &value) {
+    WriteUInt32(static_cast<std::uint32_t>(value.length()));
+    WriteBytes(reinterpret_cast<const std::byte *>(value.data()), value.length());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteOptionalString(const std::optional<std::string> &value) {
+    WriteUInt8(value.has_value() ? 1 : 0);
+    if(value.has_value()) {
+      WriteString(value.value());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteBlob(const std::vector<std::byte> &value) {
+    WriteUInt64(value.size());
+    WriteBytes(value.data(), value.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteTrackInfo(const TrackInfo &track) {
+    WriteString(track.CodecName);
+    WriteOptionalString(track.Name);
+    WriteOptionalString(track.LanguageCode);
+    WriteUInt64(track.ChannelCount);
+    WriteUInt64(static_cast<std::uint64_t>(track.ChannelPlacements));
+    WriteUInt64(static_cast<std::uint64_t>(track.Duration.count()));
+    WriteUInt64(track.SampleRate);
+    WriteUInt32(static_cast<std::uint32_t>(track.SampleFormat));
+    WriteUInt64(track.BitsPerSample);
+    WriteUInt64(track.FrameCount);
+    WriteUInt64(track.LeadingPaddingFrameCount);
+    WriteUInt8(track.Loop.has_value() ? 1 : 0);
+    if(track.Loop.has_value()) {
+      WriteUInt64(track.Loop->StartFrame);
+      WriteUInt64(track.Loop->EndFrame);
+      WriteUInt64(track.Loop->PlayCount);
+    }
+    WriteUInt32(static_cast<std::uint32_t>(track.Markers.size()));
+    for(const Marker &marker : track.Markers) {
+      WriteUInt32(marker.Id);
+      WriteUInt64(marker.StartFrame);
+      WriteUInt64(marker.FrameCount);
+      WriteOptionalString(marker.Label);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteContainerInfo(const ContainerInfo &info) {
+    WriteUInt64(info.DefaultTrackIndex);
+    WriteUInt32(static_cast<std::uint32_t>(info.Tracks.size()));
+    for(const TrackInfo &track : info.Tracks) {
+      WriteTrackInfo(track);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryReader::BinaryReader(
+    const std::byte *data, std::size_t length, std::size_t position /* = 0 */
+  ) :
+    data(data),
+    length(length),
+    position(position) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint8_t BinaryReader::ReadUInt8() {
+    return LittleEndianReader::ReadUInt8(advance(1));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint32_t BinaryReader::ReadUInt32() {
+    return LittleEndianReader::ReadUInt32(advance(4));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BinaryReader::ReadUInt64() {
+    return LittleEndianReader::ReadUInt64(advance(8));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double BinaryReader::ReadDouble() {
+    std::uint64_t bits = ReadUInt64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string BinaryReader::ReadString() {
+    std::size_t stringLength = ReadUInt32();
+    const char *characters = reinterpret_cast<const char *>(advance(stringLength));
+    return std::string(characters, stringLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<std::string> BinaryReader::ReadOptionalString() {
+    if(ReadUInt8() == 0) {
+      return std::optional<std::string>();
+    } else {
+      return ReadString();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> BinaryReader::ReadBlob() {
+    std::uint64_t blobLength = ReadUInt64();
+    if(unlikely(blobLength > this->length - this->position)) {
+      throw Errors::CorruptedFileError(u8"Serialized data is truncated");
+    }
+
+    const std::byte *blob = advance(static_cast<std::size_t>(blobLength));
+    return std::vector<std::byte>(blob, blob + blobLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TrackInfo BinaryReader::ReadTrackInfo() {
+    TrackInfo track;
+    track.CodecName = ReadString();
+    track.Name = ReadOptionalString();
+    track.LanguageCode = ReadOptionalString();
+    track.ChannelCount = static_cast<std::size_t>(ReadUInt64());
+    track.ChannelPlacements = static_cast<ChannelPlacement>(ReadUInt64());
+    track.Duration = std::chrono::microseconds(
+      static_cast<std::chrono::microseconds::rep>(ReadUInt64())
+    );
+    track.SampleRate = static_cast<std::size_t>(ReadUInt64());
+    track.SampleFormat = static_cast<AudioSampleFormat>(ReadUInt32());
+    track.BitsPerSample = static_cast<std::size_t>(ReadUInt64());
+    track.FrameCount = ReadUInt64();
+    track.LeadingPaddingFrameCount = static_cast<std::size_t>(ReadUInt64());
+    if(ReadUInt8() != 0) {
+      LoopRegion loop;
+      loop.StartFrame = ReadUInt64();
+      loop.EndFrame = ReadUInt64();
+      loop.PlayCount = static_cast<std::size_t>(ReadUInt64());
+      track.Loop = loop;
+    }
+
+    std::size_t markerCount = ReadUInt32();
+    for(std::size_t markerIndex = 0; markerIndex < markerCount; ++markerIndex) {
+      Marker &marker = track.Markers.emplace_back();
+      marker.Id = ReadUInt32();
+      marker.StartFrame = ReadUInt64();
+      marker.FrameCount = ReadUInt64();
+      marker.Label = ReadOptionalString();
+    }
+
+    return track;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContainerInfo BinaryReader::ReadContainerInfo() {
+    ContainerInfo info;
+    info.DefaultTrackIndex = static_cast<std::size_t>(ReadUInt64());
+
+    std::size_t trackCount = ReadUInt32();
+    for(std::size_t trackIndex = 0; trackIndex < trackCount; ++trackIndex) {
+      info.Tracks.push_back(ReadTrackInfo());
+    }
+
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *BinaryReader::advance(std::size_t byteCount) {
+    if(unlikely((this->position > this->length) || (this->length - this->position < byteCount))) {
+      throw Errors::CorruptedFileError(u8"Serialized data is truncated");
+    }
+
+    const std::byte *current = this->data + this->position;
+    this->position += byteCount;
+    return current;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
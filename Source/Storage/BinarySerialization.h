@@ -0,0 +1,170 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_BINARYSERIALIZATION_H
+#define NUCLEX_AUDIO_STORAGE_BINARYSERIALIZATION_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+
+#include <cstddef> // for std::byte
+#include <cstdint> // for std::uint64_t
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends little endian numbers, strings and track infos to a byte buffer</summary>
+  /// <remarks>
+  ///   Used by the container info cache, asset catalog and sound banks to save their contents.
+  /// </remarks>
+  class BinaryWriter {
+
+    /// <summary>Appends raw bytes to the buffer</summary>
+    /// <param name="data">Bytes that will be appended</param>
+    /// <param name="byteCount">Number of bytes that will be appended</param>
+    public: void WriteBytes(const std::byte *data, std::size_t byteCount) {
+      this->Buffer.insert(this->Buffer.end(), data, data + byteCount);
+    }
+
+    /// <summary>Appends an 8-bit integer to the buffer</summary>
+    /// <param name="value">Value that will be appended</param>
+    public: void WriteUInt8(std::uint8_t value) {
+      this->Buffer.push_back(static_cast<std::byte>(value));
+    }
+
+    /// <summary>Appends a 32-bit integer to the buffer</summary>
+    /// <param name="value">Value that will be appended</param>
+    public: void WriteUInt32(std::uint32_t value);
+
+    /// <summary>Appends a 64-bit integer to the buffer</summary>
+    /// <param name="value">Value that will be appended</param>
+    public: void WriteUInt64(std::uint64_t value);
+
+    /// <summary>Overwrites a 64-bit integer at an earlier position in the buffer</summary>
+    /// <param name="position">Offset in the buffer at which the integer is stored</param>
+    /// <param name="value">Value that will be stored</param>
+    public: void PatchUInt64(std::size_t position, std::uint64_t value);
+
+    /// <summary>Appends a double precision floating point value to the buffer</summary>
+    /// <param name="value">Value that will be appended</param>
+    public: void WriteDouble(double value);
+
+    /// <summary>Appends a length-prefixed string to the buffer</summary>
+    /// <param name="value">String that will be appended</param>
+    public: void WriteString(const std::string &value);
+
+    /// <summary>Appends an optional string to the buffer</summary>
+    /// <param name="value">Optional string that will be appended</param>
+    public: void WriteOptionalString(const std::optional<std::string> &value);
+
+    /// <summary>Appends a length-prefixed block of bytes to the buffer</summary>
+    /// <param name="value">Bytes that will be appended</param>
+    public: void WriteBlob(const std::vector<std::byte> &value);
+
+    /// <summary>Appends informations about an audio track to the buffer</summary>
+    /// <param name="track">Track informations that will be appended</param>
+    public: void WriteTrackInfo(const TrackInfo &track);
+
+    /// <summary>Appends informations about a media container to the buffer</summary>
+    /// <param name="info">Container informations that will be appended</param>
+    public: void WriteContainerInfo(const ContainerInfo &info);
+
+    /// <summary>Bytes that have been written so far</summary>
+    public: std::vector<std::byte> Buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads data written by a <see cref="BinaryWriter" /> back from memory</summary>
+  /// <remarks>
+  ///   All reads are bounds-checked and throw a CorruptedFileError if they would leave
+  ///   the memory block, so truncated or damaged files can't cause invalid accesses.
+  /// </remarks>
+  class BinaryReader {
+
+    /// <summary>Initializes a new reader for the specified memory block</summary>
+    /// <param name="data">Memory block holding the serialized data</param>
+    /// <param name="length">Length of the memory block in bytes</param>
+    /// <param name="position">Offset at which reading will begin</param>
+    public: BinaryReader(const std::byte *data, std::size_t length, std::size_t position = 0);
+
+    /// <summary>Skips over bytes that have already been checked</summary>
+    /// <param name="byteCount">Number of bytes that will be skipped</param>
+    public: void Skip(std::size_t byteCount) { advance(byteCount); }
+
+    /// <summary>Reads an 8-bit integer</summary>
+    /// <returns>The value that was read</returns>
+    public: std::uint8_t ReadUInt8();
+
+    /// <summary>Reads a 32-bit integer</summary>
+    /// <returns>The value that was read</returns>
+    public: std::uint32_t ReadUInt32();
+
+    /// <summary>Reads a 64-bit integer</summary>
+    /// <returns>The value that was read</returns>
+    public: std::uint64_t ReadUInt64();
+
+    /// <summary>Reads a double precision floating point value</summary>
+    /// <returns>The value that was read</returns>
+    public: double ReadDouble();
+
+    /// <summary>Reads a length-prefixed string</summary>
+    /// <returns>The string that was read</returns>
+    public: std::string ReadString();
+
+    /// <summary>Reads an optional string</summary>
+    /// <returns>The optional string that was read</returns>
+    public: std::optional<std::string> ReadOptionalString();
+
+    /// <summary>Reads a length-prefixed block of bytes</summary>
+    /// <returns>The bytes that were read</returns>
+    public: std::vector<std::byte> ReadBlob();
+
+    /// <summary>Reads informations about an audio track</summary>
+    /// <returns>The track informations that were read</returns>
+    public: TrackInfo ReadTrackInfo();
+
+    /// <summary>Reads informations about a media container</summary>
+    /// <returns>The container informations that were read</returns>
+    public: ContainerInfo ReadContainerInfo();
+
+    /// <summary>Moves the read position and checks that it stays within the block</summary>
+    /// <param name="byteCount">Number of bytes that are being read</param>
+    /// <returns>The address of the first byte being read</returns>
+    private: const std::byte *advance(std::size_t byteCount);
+
+    /// <summary>Memory block holding the serialized data</summary>
+    private: const std::byte *data;
+    /// <summary>Length of the memory block in bytes</summary>
+    private: std::size_t length;
+    /// <summary>Offset of the next byte that will be read</summary>
+    private: std::size_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_BINARYSERIALIZATION_H
@@ -0,0 +1,194 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BlockCache.h"
+#include "CachedFile.h"
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockCache::BlockCache(
+    std::size_t memoryLimit /* = 33554432 */, std::size_t blockSize /* = 65536 */
+  ) :
+    blockSize(blockSize),
+    memoryLimit(memoryLimit),
+    memoryUsage(0),
+    hitCount(0),
+    missCount(0),
+    blocks(),
+    blockMap(),
+    fileIds(),
+    cacheMutex() {
+    if(blockSize == 0) {
+      throw std::invalid_argument(u8"Block size must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockCache::~BlockCache() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::shared_ptr<BlockCache> &BlockCache::GetProcessWideCache() {
+    static const std::shared_ptr<BlockCache> processWideCache = std::make_shared<BlockCache>();
+    return processWideCache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> BlockCache::Wrap(
+    const std::shared_ptr<BlockCache> &cache,
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &identity
+  ) {
+    return std::make_shared<const CachedFile>(cache, file, identity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCache::SetMemoryLimit(std::size_t newMemoryLimit) {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    this->memoryLimit.store(newMemoryLimit, std::memory_order_relaxed);
+    evictUntilBelow(newMemoryLimit);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BlockCache::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    return this->memoryUsage;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCache::Evict(const std::string &identity) {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+
+    FileIdMap::const_iterator fileIdIterator = this->fileIds.find(identity);
+    if(fileIdIterator == this->fileIds.end()) {
+      return;
+    }
+
+    std::uint64_t fileId = fileIdIterator->second;
+    CachedBlockList::iterator iterator = this->blocks.begin();
+    while(iterator != this->blocks.end()) {
+      if(iterator->Key.FileId == fileId) {
+        this->memoryUsage -= iterator->Contents.size();
+        this->blockMap.erase(iterator->Key);
+        iterator = this->blocks.erase(iterator);
+      } else {
+        ++iterator;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCache::Clear() {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    this->blockMap.clear();
+    this->blocks.clear();
+    this->memoryUsage = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BlockCache::getFileId(const std::string &identity) {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+
+    FileIdMap::const_iterator iterator = this->fileIds.find(identity);
+    if(iterator != this->fileIds.end()) {
+      return iterator->second;
+    }
+
+    std::uint64_t newFileId = static_cast<std::uint64_t>(this->fileIds.size());
+    this->fileIds.insert(FileIdMap::value_type(identity, newFileId));
+    return newFileId;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlockCache::tryCopyFromBlock(
+    std::uint64_t fileId, std::uint64_t blockIndex,
+    std::size_t offset, std::size_t byteCount, std::byte *buffer
+  ) {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+
+    BlockMap::const_iterator iterator = this->blockMap.find(BlockKey { fileId, blockIndex });
+    if(iterator == this->blockMap.end()) {
+      this->missCount.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    // Move the block to the front of the list, making it the most recently used one
+    this->blocks.splice(this->blocks.begin(), this->blocks, iterator->second);
+    std::copy_n(iterator->second->Contents.data() + offset, byteCount, buffer);
+
+    this->hitCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCache::storeBlock(
+    std::uint64_t fileId, std::uint64_t blockIndex, std::vector<std::byte> &&contents
+  ) {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+
+    // If another thread read the same block in the meantime, keep the existing one
+    BlockKey key { fileId, blockIndex };
+    if(this->blockMap.find(key) != this->blockMap.end()) {
+      return;
+    }
+
+    // Blocks that would never fit under the memory limit are not cached at all
+    std::size_t limit = this->memoryLimit.load(std::memory_order_relaxed);
+    if(contents.size() > limit) {
+      return;
+    }
+
+    evictUntilBelow(limit - contents.size());
+
+    this->memoryUsage += contents.size();
+    this->blocks.push_front(CachedBlock { key, std::move(contents) });
+    this->blockMap.insert(BlockMap::value_type(key, this->blocks.begin()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCache::evictUntilBelow(std::size_t limit) {
+    while((this->memoryUsage > limit) && !this->blocks.empty()) {
+      CachedBlock &leastRecentlyUsed = this->blocks.back();
+      this->memoryUsage -= leastRecentlyUsed.Contents.size();
+      this->blockMap.erase(leastRecentlyUsed.Key);
+      this->blocks.pop_back();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
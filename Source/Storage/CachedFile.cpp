@@ -0,0 +1,92 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "CachedFile.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CachedFile::CachedFile(
+    const std::shared_ptr<BlockCache> &cache,
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &identity
+  ) :
+    cache(cache),
+    file(file),
+    fileId(cache->getFileId(identity)),
+    length(file->GetSize()) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CachedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+
+    // Let the wrapped file deal with reads past the end so it can throw its usual error
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      this->file->ReadAt(start, byteCount, buffer);
+      return;
+    }
+
+    std::size_t blockSize = this->cache->GetBlockSize();
+    while(byteCount > 0) {
+      std::uint64_t blockIndex = start / blockSize;
+      std::size_t offset = static_cast<std::size_t>(start % blockSize);
+      std::size_t copyByteCount = std::min(byteCount, blockSize - offset);
+
+      bool wasCached = this->cache->tryCopyFromBlock(
+        this->fileId, blockIndex, offset, copyByteCount, buffer
+      );
+      if(!wasCached) {
+        std::uint64_t blockStart = blockIndex * blockSize;
+        std::vector<std::byte> contents(
+          static_cast<std::size_t>(std::min<std::uint64_t>(blockSize, this->length - blockStart))
+        );
+        this->file->ReadAt(blockStart, contents.size(), contents.data());
+        std::copy_n(contents.data() + offset, copyByteCount, buffer);
+        this->cache->storeBlock(this->fileId, blockIndex, std::move(contents));
+      }
+
+      start += copyByteCount;
+      buffer += copyByteCount;
+      byteCount -= copyByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CachedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Files read through a block cache are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,105 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_CACHEDFILE_H
+#define NUCLEX_AUDIO_STORAGE_CACHEDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/BlockCache.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads from a virtual file through a shared block cache</summary>
+  class CachedFile : public VirtualFile {
+
+    /// <summary>Initializes a new cached file</summary>
+    /// <param name="cache">Block cache through which reads will go</param>
+    /// <param name="file">File whose reads will be cached</param>
+    /// <param name="identity">Unique identity of the file's contents</param>
+    public: CachedFile(
+      const std::shared_ptr<BlockCache> &cache,
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::string &identity
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~CachedFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the wrapped file's memory if it supports borrowing,
+    ///   otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      return this->file->TryBorrowAt(start, byteCount);
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Cached files are always read-only, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Block cache the file's reads are going through</summary>
+    private: std::shared_ptr<BlockCache> cache;
+    /// <summary>File whose reads are being cached</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Numeric identifier the block cache assigned to the file</summary>
+    private: std::uint64_t fileId;
+    /// <summary>Length of the wrapped file in bytes</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_CACHEDFILE_H
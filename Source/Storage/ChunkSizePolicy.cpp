@@ -0,0 +1,129 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ChunkSizePolicy.h"
+#include "../Platform/ProcessorTopology.h"
+
+#include <algorithm> // for std::max(), std::min()
+#include <atomic> // for std::atomic
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Budget used if the processor's cache sizes can't be determined</summary>
+  const std::size_t FallbackCacheBudget = 128 * 1024;
+
+  /// <summary>Smallest budget the cache sizes will be translated into</summary>
+  const std::size_t MinimumCacheBudget = 16 * 1024;
+
+  /// <summary>Largest budget the cache sizes will be translated into</summary>
+  /// <remarks>
+  ///   Some server processors report L2 caches of several megabytes that are shared
+  ///   between cores. Beyond this, larger chunks no longer reduce the call overhead
+  ///   in any noticeable way.
+  /// </remarks>
+  const std::size_t MaximumCacheBudget = 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Derives a cache budget for one chunk from the processor's caches</summary>
+  /// <returns>The number of bytes a chunk's working set should stay within</returns>
+  std::size_t detectCacheBudget() {
+    using Nuclex::Audio::Platform::ProcessorTopology;
+
+    std::size_t levelOneSize = ProcessorTopology::GetDataCacheSize(1);
+    std::size_t levelTwoSize = ProcessorTopology::GetDataCacheSize(2);
+    if((levelOneSize == 0) && (levelTwoSize == 0)) {
+      return FallbackCacheBudget;
+    }
+
+    // Leave half of the L2 cache for the codec's own state, tables and the file's
+    // cached pages. The L1 cache is the floor since the L2 is never smaller.
+    std::size_t budget = std::max(levelOneSize, levelTwoSize / 2);
+    return std::min(std::max(budget, MinimumCacheBudget), MaximumCacheBudget);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the policy that is used unless another one is set</summary>
+  /// <returns>The default chunk size policy</returns>
+  const Nuclex::Audio::Storage::ChunkSizePolicy &getDefaultPolicy() {
+    static const Nuclex::Audio::Storage::ChunkSizePolicy policy;
+    return policy;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Policy installed by the application, nullptr if none</summary>
+  std::atomic<const Nuclex::Audio::Storage::ChunkSizePolicy *> globalPolicy(nullptr);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const ChunkSizePolicy &ChunkSizePolicy::GetGlobal() {
+    const ChunkSizePolicy *policy = globalPolicy.load(std::memory_order_acquire);
+    if(likely(policy == nullptr)) {
+      return getDefaultPolicy();
+    } else {
+      return *policy;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChunkSizePolicy::SetGlobal(const ChunkSizePolicy *policy) {
+    globalPolicy.store(policy, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkSizePolicy::ChunkSizePolicy(std::size_t cacheBudget /* = 0 */) :
+    cacheBudget((cacheBudget == 0) ? detectCacheBudget() : cacheBudget) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ChunkSizePolicy::GetChunkFrameCount(
+    std::size_t channelCount,
+    std::size_t bytesPerScratchSample,
+    std::size_t bytesPerOutputSample
+  ) const {
+    std::size_t bytesPerFrame = (
+      std::max<std::size_t>(channelCount, 1) * (bytesPerScratchSample + bytesPerOutputSample)
+    );
+    if(bytesPerFrame == 0) {
+      return MinimumFrameCount;
+    }
+
+    std::size_t frameCount = this->cacheBudget / bytesPerFrame;
+    frameCount -= frameCount % MinimumFrameCount;
+    return std::max(frameCount, MinimumFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,527 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/CompactTrackCatalog.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "BinarySerialization.h" // for BinaryWriter, BinaryReader
+#include "./EndianReader.h" // for LittleEndianReader
+
+#include <algorithm> // for std::equal()
+#include <cstring> // for std::memcpy()
+#include <iterator> // for std::begin(), std::end()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a file as a compact track catalog</summary>
+  const std::byte FileSignature[] = {
+    std::byte(u8'N'), std::byte(u8'T'), std::byte(u8'C'), std::byte(u8'T')
+  };
+
+  /// <summary>Version of the catalog's layout, bumped whenever it changes</summary>
+  const std::uint32_t FileVersion = 1;
+
+  /// <summary>Size of the header preceding the codec name table</summary>
+  /// <remarks>
+  ///   Signature, version, number of tracks, number of codec names (padded to 8 bytes)
+  ///   and length of the string pool.
+  /// </remarks>
+  const std::size_t HeaderByteCount = 4 + 4 + 8 + 8 + 8;
+
+  /// <summary>Offset marking a string or extra data block as not present</summary>
+  const std::uint32_t NoOffset = std::numeric_limits<std::uint32_t>::max();
+
+  /// <summary>Flag in the extra data indicating that a loop region follows</summary>
+  const std::uint8_t HasLoopFlag = 1;
+
+  /// <summary>Flag in the extra data indicating that replay gain values follow</summary>
+  const std::uint8_t HasReplayGainFlag = 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  // Layout of a track record. Integers are little endian and the 64-bit fields come
+  // first so that they're naturally aligned when the records are memory-mapped.
+
+  /// <summary>Offset of the exact frame count in a track record</summary>
+  const std::size_t FrameCountOffset = 0;
+  /// <summary>Offset of the duration in microseconds in a track record</summary>
+  const std::size_t DurationOffset = 8;
+  /// <summary>Offset of the sample rate in a track record</summary>
+  const std::size_t SampleRateOffset = 16;
+  /// <summary>Offset of the channel placement flags in a track record</summary>
+  const std::size_t ChannelPlacementsOffset = 20;
+  /// <summary>Offset of the track name's string pool offset in a track record</summary>
+  const std::size_t NameOffset = 24;
+  /// <summary>Offset of the language code's string pool offset in a track record</summary>
+  const std::size_t LanguageCodeOffset = 28;
+  /// <summary>Offset of the extra data's string pool offset in a track record</summary>
+  const std::size_t ExtrasOffset = 32;
+  /// <summary>Offset of the encoder delay in a track record</summary>
+  const std::size_t LeadingPaddingOffset = 36;
+  /// <summary>Offset of the channel count in a track record</summary>
+  const std::size_t ChannelCountOffset = 40;
+  /// <summary>Offset of the codec name index in a track record</summary>
+  const std::size_t CodecIndexOffset = 42;
+  /// <summary>Offset of the sample format in a track record</summary>
+  const std::size_t SampleFormatOffset = 43;
+  /// <summary>Offset of the bits per sample in a track record</summary>
+  const std::size_t BitsPerSampleOffset = 44;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Narrows an integer into a record field, refusing values that don't fit</summary>
+  /// <typeparam name="TField">Type of the field in the track record</typeparam>
+  /// <param name="value">Value that will be narrowed</param>
+  /// <param name="fieldName">Name of the field for the error message</param>
+  /// <returns>The value as the record field's type</returns>
+  template<typename TField>
+  TField narrow(std::uint64_t value, const char *fieldName) {
+    if(unlikely(value > std::numeric_limits<TField>::max())) {
+      throw std::out_of_range(
+        std::string(fieldName) + u8" is too large for the compact track catalog"
+      );
+    }
+    return static_cast<TField>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an optional gain or peak value into the extra data</summary>
+  /// <param name="writer">Writer that collects the extra data</param>
+  /// <param name="value">Value that will be written</param>
+  void writeOptionalFloat(
+    Nuclex::Audio::Storage::BinaryWriter &writer, const std::optional<float> &value
+  ) {
+    std::uint32_t bits = 0;
+    if(value.has_value()) {
+      std::memcpy(&bits, &value.value(), sizeof(bits));
+    }
+
+    writer.WriteUInt8(value.has_value() ? 1 : 0);
+    writer.WriteUInt32(bits);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads an optional gain or peak value from the extra data</summary>
+  /// <param name="reader">Reader positioned at the value</param>
+  /// <returns>The value that was read</returns>
+  std::optional<float> readOptionalFloat(Nuclex::Audio::Storage::BinaryReader &reader) {
+    bool hasValue = (reader.ReadUInt8() != 0);
+    std::uint32_t bits = reader.ReadUInt32();
+    if(!hasValue) {
+      return std::optional<float>();
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompactTrackCatalogWriter::CompactTrackCatalogWriter() :
+    records(),
+    pool(),
+    codecNameOffsets(),
+    internedStrings() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompactTrackCatalogWriter::~CompactTrackCatalogWriter() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CompactTrackCatalogWriter::Add(const TrackInfo &track) {
+    std::size_t trackIndex = CountTracks();
+
+    // Codec names are few, so they get a table of their own and each record only
+    // needs a single byte to identify its codec
+    std::uint32_t codecNameOffset = intern(track.CodecName);
+    std::size_t codecIndex = 0;
+    std::size_t codecCount = this->codecNameOffsets.size();
+    while((codecIndex < codecCount) && (this->codecNameOffsets[codecIndex] != codecNameOffset)) {
+      ++codecIndex;
+    }
+    if(codecIndex == codecCount) {
+      narrow<std::uint8_t>(codecCount, u8"Number of distinct codec names");
+      this->codecNameOffsets.push_back(codecNameOffset);
+    }
+
+    std::uint32_t nameOffset = NoOffset;
+    if(track.Name.has_value()) {
+      nameOffset = intern(track.Name.value());
+    }
+    std::uint32_t languageCodeOffset = NoOffset;
+    if(track.LanguageCode.has_value()) {
+      languageCodeOffset = intern(track.LanguageCode.value());
+    }
+
+    // Loops, markers and gains are rare, so they're stored in the pool and only
+    // cost the record an offset
+    std::uint32_t extrasOffset = NoOffset;
+    if(track.Loop.has_value() || track.ReplayGain.has_value() || !track.Markers.empty()) {
+      BinaryWriter extras;
+
+      std::uint8_t flags = 0;
+      if(track.Loop.has_value()) {
+        flags |= HasLoopFlag;
+      }
+      if(track.ReplayGain.has_value()) {
+        flags |= HasReplayGainFlag;
+      }
+      extras.WriteUInt8(flags);
+
+      if(track.Loop.has_value()) {
+        extras.WriteUInt64(track.Loop.value().StartFrame);
+        extras.WriteUInt64(track.Loop.value().EndFrame);
+        extras.WriteUInt64(track.Loop.value().PlayCount);
+      }
+      if(track.ReplayGain.has_value()) {
+        writeOptionalFloat(extras, track.ReplayGain.value().TrackGain);
+        writeOptionalFloat(extras, track.ReplayGain.value().TrackPeak);
+        writeOptionalFloat(extras, track.ReplayGain.value().AlbumGain);
+        writeOptionalFloat(extras, track.ReplayGain.value().AlbumPeak);
+      }
+
+      extras.WriteUInt32(narrow<std::uint32_t>(track.Markers.size(), u8"Number of markers"));
+      for(const Marker &marker : track.Markers) {
+        extras.WriteUInt32(marker.Id);
+        extras.WriteUInt64(marker.StartFrame);
+        extras.WriteUInt64(marker.FrameCount);
+        extras.WriteUInt32(marker.Label.has_value() ? intern(marker.Label.value()) : NoOffset);
+      }
+
+      extrasOffset = narrow<std::uint32_t>(this->pool.size(), u8"String pool");
+      this->pool.insert(this->pool.end(), extras.Buffer.begin(), extras.Buffer.end());
+    }
+
+    BinaryWriter record;
+    record.Buffer.reserve(RecordByteCount);
+    record.WriteUInt64(track.FrameCount);
+    record.WriteUInt64(static_cast<std::uint64_t>(track.Duration.count()));
+    record.WriteUInt32(narrow<std::uint32_t>(track.SampleRate, u8"Sample rate"));
+    record.WriteUInt32(
+      narrow<std::uint32_t>(static_cast<std::uint64_t>(track.ChannelPlacements), u8"Placements")
+    );
+    record.WriteUInt32(nameOffset);
+    record.WriteUInt32(languageCodeOffset);
+    record.WriteUInt32(extrasOffset);
+    record.WriteUInt32(
+      narrow<std::uint32_t>(track.LeadingPaddingFrameCount, u8"Encoder delay")
+    );
+    std::uint16_t channelCount = narrow<std::uint16_t>(track.ChannelCount, u8"Channel count");
+    record.WriteUInt8(static_cast<std::uint8_t>(channelCount));
+    record.WriteUInt8(static_cast<std::uint8_t>(channelCount >> 8));
+    record.WriteUInt8(static_cast<std::uint8_t>(codecIndex));
+    record.WriteUInt8(
+      narrow<std::uint8_t>(static_cast<std::uint64_t>(track.SampleFormat), u8"Sample format")
+    );
+    record.WriteUInt8(narrow<std::uint8_t>(track.BitsPerSample, u8"Bits per sample"));
+    record.Buffer.resize(RecordByteCount, std::byte(0));
+
+    this->records.insert(this->records.end(), record.Buffer.begin(), record.Buffer.end());
+    return trackIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CompactTrackCatalogWriter::Save(VirtualFile &target) const {
+    std::size_t codecCount = this->codecNameOffsets.size();
+    std::size_t codecTableByteCount = (codecCount * 4 + 7) / 8 * 8;
+
+    BinaryWriter writer;
+    writer.Buffer.reserve(
+      HeaderByteCount + codecTableByteCount + this->records.size() + this->pool.size()
+    );
+    writer.WriteBytes(FileSignature, sizeof(FileSignature));
+    writer.WriteUInt32(FileVersion);
+    writer.WriteUInt64(CountTracks());
+    writer.WriteUInt64(codecCount);
+    writer.WriteUInt64(this->pool.size());
+
+    // The codec name table is padded so the records start at an 8 byte boundary
+    for(std::uint32_t codecNameOffset : this->codecNameOffsets) {
+      writer.WriteUInt32(codecNameOffset);
+    }
+    writer.Buffer.resize(HeaderByteCount + codecTableByteCount, std::byte(0));
+
+    writer.WriteBytes(this->records.data(), this->records.size());
+    writer.WriteBytes(this->pool.data(), this->pool.size());
+
+    target.WriteAt(0, writer.Buffer.size(), writer.Buffer.data());
+    target.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint32_t CompactTrackCatalogWriter::intern(const std::string &value) {
+    StringOffsetMap::const_iterator iterator = this->internedStrings.find(value);
+    if(iterator != this->internedStrings.end()) {
+      return iterator->second;
+    }
+
+    std::uint32_t offset = narrow<std::uint32_t>(this->pool.size(), u8"String pool");
+
+    BinaryWriter writer;
+    writer.WriteString(value);
+    this->pool.insert(this->pool.end(), writer.Buffer.begin(), writer.Buffer.end());
+
+    this->internedStrings.emplace(value, offset);
+    return offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CompactTrackCatalog> CompactTrackCatalog::Open(const std::string &path) {
+    return std::make_shared<CompactTrackCatalog>(
+      VirtualFile::OpenRealFileForReading(path, FileAccessPattern::Random, true)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompactTrackCatalog::CompactTrackCatalog(const std::shared_ptr<const VirtualFile> &file) :
+    file(file),
+    contents(),
+    data(nullptr),
+    length(static_cast<std::size_t>(file->GetSize())),
+    trackCount(0),
+    recordsOffset(0),
+    poolOffset(0),
+    poolLength(0),
+    codecNames() {
+
+    this->data = file->TryBorrowAt(0, this->length);
+    if(this->data == nullptr) {
+      this->contents.resize(this->length);
+      file->ReadAt(0, this->length, this->contents.data());
+      this->data = this->contents.data();
+    }
+
+    bool hasSignature = (
+      (this->length >= HeaderByteCount) &&
+      std::equal(std::begin(FileSignature), std::end(FileSignature), this->data)
+    );
+    if(unlikely(!hasSignature)) {
+      throw Errors::CorruptedFileError(u8"File is not a compact track catalog");
+    }
+
+    BinaryReader reader(this->data, this->length, sizeof(FileSignature));
+    if(unlikely(reader.ReadUInt32() != FileVersion)) {
+      throw Errors::CorruptedFileError(u8"Compact track catalog has unknown version");
+    }
+
+    std::uint64_t trackCount = reader.ReadUInt64();
+    std::uint64_t codecCount = reader.ReadUInt64();
+    std::uint64_t poolLength = reader.ReadUInt64();
+
+    // Check the sizes one by one against what's left of the file so that none
+    // of the multiplications can overflow, even with a maliciously crafted header
+    std::uint64_t remainingByteCount = this->length - HeaderByteCount;
+    bool isValidLayout = (codecCount <= 256) && (poolLength <= remainingByteCount);
+    std::uint64_t codecTableByteCount = (codecCount * 4 + 7) / 8 * 8;
+    if(isValidLayout) {
+      remainingByteCount -= poolLength;
+      isValidLayout = (codecTableByteCount <= remainingByteCount);
+    }
+    if(isValidLayout) {
+      remainingByteCount -= codecTableByteCount;
+      isValidLayout = (
+        trackCount <= remainingByteCount / CompactTrackCatalogWriter::RecordByteCount
+      );
+    }
+    if(unlikely(!isValidLayout)) {
+      throw Errors::CorruptedFileError(u8"Compact track catalog is truncated");
+    }
+
+    this->trackCount = static_cast<std::size_t>(trackCount);
+    this->recordsOffset = HeaderByteCount + static_cast<std::size_t>(codecTableByteCount);
+    this->poolOffset = (
+      this->recordsOffset + this->trackCount * CompactTrackCatalogWriter::RecordByteCount
+    );
+    this->poolLength = static_cast<std::size_t>(poolLength);
+
+    // Codec names are handed out by reference, so they're decoded once up front
+    std::size_t codecNameCount = static_cast<std::size_t>(codecCount);
+    this->codecNames.reserve(codecNameCount);
+    for(std::size_t index = 0; index < codecNameCount; ++index) {
+      this->codecNames.push_back(
+        readString(LittleEndianReader::ReadUInt32(this->data + HeaderByteCount + index * 4))
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompactTrackCatalog::~CompactTrackCatalog() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TrackInfo CompactTrackCatalog::GetTrackInfo(std::size_t trackIndex) const {
+    const std::byte *record = getRecord(trackIndex);
+
+    TrackInfo track = TrackInfo();
+    track.CodecName = GetCodecName(trackIndex);
+
+    std::uint32_t nameOffset = LittleEndianReader::ReadUInt32(record + NameOffset);
+    if(nameOffset != NoOffset) {
+      track.Name = readString(nameOffset);
+    }
+    std::uint32_t languageCodeOffset = LittleEndianReader::ReadUInt32(
+      record + LanguageCodeOffset
+    );
+    if(languageCodeOffset != NoOffset) {
+      track.LanguageCode = readString(languageCodeOffset);
+    }
+
+    track.ChannelCount = LittleEndianReader::ReadUInt16(record + ChannelCountOffset);
+    track.ChannelPlacements = static_cast<ChannelPlacement>(
+      LittleEndianReader::ReadUInt32(record + ChannelPlacementsOffset)
+    );
+    track.Duration = GetDuration(trackIndex);
+    track.SampleRate = LittleEndianReader::ReadUInt32(record + SampleRateOffset);
+    track.SampleFormat = static_cast<AudioSampleFormat>(
+      LittleEndianReader::ReadUInt8(record + SampleFormatOffset)
+    );
+    track.BitsPerSample = LittleEndianReader::ReadUInt8(record + BitsPerSampleOffset);
+    track.FrameCount = LittleEndianReader::ReadUInt64(record + FrameCountOffset);
+    track.LeadingPaddingFrameCount = LittleEndianReader::ReadUInt32(
+      record + LeadingPaddingOffset
+    );
+
+    std::uint32_t extrasOffset = LittleEndianReader::ReadUInt32(record + ExtrasOffset);
+    if(extrasOffset != NoOffset) {
+      BinaryReader reader(
+        this->data + this->poolOffset, this->poolLength, static_cast<std::size_t>(extrasOffset)
+      );
+
+      std::uint8_t flags = reader.ReadUInt8();
+      if((flags & HasLoopFlag) != 0) {
+        LoopRegion loop;
+        loop.StartFrame = reader.ReadUInt64();
+        loop.EndFrame = reader.ReadUInt64();
+        loop.PlayCount = static_cast<std::size_t>(reader.ReadUInt64());
+        track.Loop = loop;
+      }
+      if((flags & HasReplayGainFlag) != 0) {
+        ReplayGainInfo replayGain;
+        replayGain.TrackGain = readOptionalFloat(reader);
+        replayGain.TrackPeak = readOptionalFloat(reader);
+        replayGain.AlbumGain = readOptionalFloat(reader);
+        replayGain.AlbumPeak = readOptionalFloat(reader);
+        track.ReplayGain = replayGain;
+      }
+
+      std::size_t markerCount = reader.ReadUInt32();
+      for(std::size_t markerIndex = 0; markerIndex < markerCount; ++markerIndex) {
+        Marker &marker = track.Markers.emplace_back();
+        marker.Id = reader.ReadUInt32();
+        marker.StartFrame = reader.ReadUInt64();
+        marker.FrameCount = reader.ReadUInt64();
+
+        std::uint32_t labelOffset = reader.ReadUInt32();
+        if(labelOffset != NoOffset) {
+          marker.Label = readString(labelOffset);
+        }
+      }
+    }
+
+    return track;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &CompactTrackCatalog::GetCodecName(std::size_t trackIndex) const {
+    std::size_t codecIndex = LittleEndianReader::ReadUInt8(
+      getRecord(trackIndex) + CodecIndexOffset
+    );
+    if(unlikely(codecIndex >= this->codecNames.size())) {
+      throw Errors::CorruptedFileError(u8"Compact track catalog has an invalid codec index");
+    }
+
+    return this->codecNames[codecIndex];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CompactTrackCatalog::GetChannelCount(std::size_t trackIndex) const {
+    return LittleEndianReader::ReadUInt16(getRecord(trackIndex) + ChannelCountOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CompactTrackCatalog::GetSampleRate(std::size_t trackIndex) const {
+    return LittleEndianReader::ReadUInt32(getRecord(trackIndex) + SampleRateOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t CompactTrackCatalog::GetFrameCount(std::size_t trackIndex) const {
+    return LittleEndianReader::ReadUInt64(getRecord(trackIndex) + FrameCountOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::chrono::microseconds CompactTrackCatalog::GetDuration(std::size_t trackIndex) const {
+    return std::chrono::microseconds(
+      static_cast<std::chrono::microseconds::rep>(
+        LittleEndianReader::ReadUInt64(getRecord(trackIndex) + DurationOffset)
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *CompactTrackCatalog::getRecord(std::size_t trackIndex) const {
+    if(unlikely(trackIndex >= this->trackCount)) {
+      throw std::out_of_range(u8"Track index is out of range");
+    }
+
+    return (
+      this->data + this->recordsOffset + trackIndex * CompactTrackCatalogWriter::RecordByteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string CompactTrackCatalog::readString(std::uint32_t offset) const {
+    BinaryReader reader(
+      this->data + this->poolOffset, this->poolLength, static_cast<std::size_t>(offset)
+    );
+    return reader.ReadString();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,142 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "ConcatenatedFile.h"
+
+#include <algorithm> // for std::upper_bound(), std::min()
+#include <cassert> // for assert()
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ConcatenatedFile::ConcatenatedFile(
+    const std::vector<std::shared_ptr<const VirtualFile>> &parts
+  ) :
+    parts(parts),
+    partStarts() {
+    this->partStarts.reserve(parts.size() + 1);
+
+    std::uint64_t offset = 0;
+    for(const std::shared_ptr<const VirtualFile> &part : parts) {
+      this->partStarts.push_back(offset);
+      offset += part->GetSize();
+    }
+    this->partStarts.push_back(offset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConcatenatedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::uint64_t length = this->partStarts.back();
+    if(unlikely((start > length) || (length - start < byteCount))) {
+      throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+    }
+    if(byteCount == 0) {
+      return;
+    }
+
+    std::size_t partIndex = this->findPart(start);
+    while(byteCount > 0) {
+      std::uint64_t partOffset = start - this->partStarts[partIndex];
+      std::size_t partByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(byteCount, this->partStarts[partIndex + 1] - start)
+      );
+      if(partByteCount > 0) { // Skip empty parts
+        this->parts[partIndex]->ReadAt(partOffset, partByteCount, buffer);
+      }
+
+      start += partByteCount;
+      buffer += partByteCount;
+      byteCount -= partByteCount;
+      ++partIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConcatenatedFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    std::uint64_t length = this->partStarts.back();
+    if(unlikely(start >= length)) {
+      return;
+    }
+
+    std::uint64_t end = start + std::min<std::uint64_t>(byteCount, length - start);
+    for(std::size_t partIndex = this->findPart(start); start < end; ++partIndex) {
+      std::uint64_t partEnd = std::min(this->partStarts[partIndex + 1], end);
+      if(partEnd > start) {
+        this->parts[partIndex]->Prefetch(
+          start - this->partStarts[partIndex], static_cast<std::size_t>(partEnd - start)
+        );
+      }
+      start = partEnd;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *ConcatenatedFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    std::uint64_t length = this->partStarts.back();
+    if(unlikely((start >= length) || (length - start < byteCount))) {
+      return nullptr;
+    }
+
+    std::size_t partIndex = this->findPart(start);
+    if(this->partStarts[partIndex + 1] - start < byteCount) {
+      return nullptr; // Range crosses into the next part, can't hand out contiguous memory
+    }
+
+    return this->parts[partIndex]->TryBorrowAt(start - this->partStarts[partIndex], byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ConcatenatedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Concatenated views of files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ConcatenatedFile::findPart(std::uint64_t offset) const {
+    assert((offset < this->partStarts.back()) && u8"Offset lies within the file");
+
+    // Find the first part beginning after the offset, the one before it holds the offset.
+    // Empty parts share their start offset with the next part, upper_bound() skips them.
+    std::vector<std::uint64_t>::const_iterator nextPart = std::upper_bound(
+      this->partStarts.begin(), this->partStarts.end(), offset
+    );
+    return static_cast<std::size_t>(nextPart - this->partStarts.begin()) - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
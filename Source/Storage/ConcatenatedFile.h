@@ -0,0 +1,102 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_CONCATENATEDFILE_H
+#define NUCLEX_AUDIO_STORAGE_CONCATENATEDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splices several files together so they appear as a single file</summary>
+  /// <remarks>
+  ///   Useful if an audio file has been split into multiple parts (for example,
+  ///   to fit into size-limited archive chunks). Reads crossing the boundary between
+  ///   two parts are split up and passed on to both parts.
+  /// </remarks>
+  class ConcatenatedFile : public VirtualFile {
+
+    /// <summary>Initializes a new concatenated view of the specified files</summary>
+    /// <param name="parts">Files that will be spliced together, in order</param>
+    public: ConcatenatedFile(const std::vector<std::shared_ptr<const VirtualFile>> &parts);
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~ConcatenatedFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->partStarts.back(); }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override;
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the memory of the part holding the range if the range does not
+    ///   cross into another part and the part supports borrowing, otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Concatenated views are always read-only, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Looks up the index of the part containing the specified offset</summary>
+    /// <param name="offset">Offset for which the part index will be looked up</param>
+    /// <returns>The index of the part holding the byte at the specified offset</returns>
+    private: std::size_t findPart(std::uint64_t offset) const;
+
+    /// <summary>Files that are spliced together</summary>
+    private: std::vector<std::shared_ptr<const VirtualFile>> parts;
+    /// <summary>Offset at which each part begins, plus the total length at the end</summary>
+    private: std::vector<std::uint64_t> partStarts;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_CONCATENATEDFILE_H
@@ -0,0 +1,204 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ContainerInfoCache.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "BinarySerialization.h" // for BinaryWriter, BinaryReader
+
+#include <algorithm> // for std::equal()
+#include <iterator> // for std::begin(), std::end()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a file as a saved container info cache</summary>
+  const std::byte FileSignature[] = {
+    std::byte(u8'N'), std::byte(u8'A'), std::byte(u8'I'), std::byte(u8'C')
+  };
+
+  /// <summary>Version of the saved cache's layout, bumped whenever it changes</summary>
+  const std::uint32_t FileVersion = 3;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContainerInfoCache::ContainerInfoCache() :
+    entryMutex(),
+    entries(),
+    hitCount(0),
+    missCount(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ContainerInfoCache::~ContainerInfoCache() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ContainerInfoCache::TryLookup(
+    const std::string &path,
+    std::uint64_t size,
+    std::uint64_t modificationTime,
+    std::optional<ContainerInfo> &info
+  ) const {
+    {
+      std::lock_guard<std::mutex> entryScope(this->entryMutex);
+
+      EntryMap::const_iterator iterator = this->entries.find(path);
+      if(iterator != this->entries.end()) {
+        const Entry &entry = iterator->second;
+        if((entry.Size == size) && (entry.ModificationTime == modificationTime)) {
+          info = entry.Info;
+          this->hitCount.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+    }
+
+    this->missCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContainerInfoCache::Store(
+    const std::string &path,
+    std::uint64_t size,
+    std::uint64_t modificationTime,
+    const std::optional<ContainerInfo> &info
+  ) {
+    Entry entry;
+    entry.Size = size;
+    entry.ModificationTime = modificationTime;
+    entry.Info = info;
+
+    std::lock_guard<std::mutex> entryScope(this->entryMutex);
+    this->entries[path] = std::move(entry);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ContainerInfoCache::Invalidate(const std::string &path) {
+    std::lock_guard<std::mutex> entryScope(this->entryMutex);
+    return (this->entries.erase(path) > 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContainerInfoCache::Clear() {
+    std::lock_guard<std::mutex> entryScope(this->entryMutex);
+    this->entries.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ContainerInfoCache::CountEntries() const {
+    std::lock_guard<std::mutex> entryScope(this->entryMutex);
+    return this->entries.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContainerInfoCache::ResetStatistics() {
+    this->hitCount.store(0, std::memory_order_relaxed);
+    this->missCount.store(0, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContainerInfoCache::Save(VirtualFile &target) const {
+    BinaryWriter writer;
+    writer.WriteBytes(FileSignature, sizeof(FileSignature));
+    writer.WriteUInt32(FileVersion);
+    {
+      std::lock_guard<std::mutex> entryScope(this->entryMutex);
+
+      writer.WriteUInt64(this->entries.size());
+      for(const EntryMap::value_type &pathAndEntry : this->entries) {
+        const Entry &entry = pathAndEntry.second;
+        writer.WriteString(pathAndEntry.first);
+        writer.WriteUInt64(entry.Size);
+        writer.WriteUInt64(entry.ModificationTime);
+        writer.WriteUInt8(entry.Info.has_value() ? 1 : 0);
+        if(entry.Info.has_value()) {
+          writer.WriteContainerInfo(entry.Info.value());
+        }
+      }
+    }
+
+    target.WriteAt(0, writer.Buffer.size(), writer.Buffer.data());
+    target.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ContainerInfoCache::Load(const VirtualFile &source) {
+    std::vector<std::byte> buffer(static_cast<std::size_t>(source.GetSize()));
+    source.ReadAt(0, buffer.size(), buffer.data());
+
+    bool hasSignature = (
+      (buffer.size() >= sizeof(FileSignature)) &&
+      std::equal(std::begin(FileSignature), std::end(FileSignature), buffer.begin())
+    );
+    if(unlikely(!hasSignature)) {
+      throw Errors::CorruptedFileError(u8"File is not a saved container info cache");
+    }
+
+    BinaryReader reader(buffer.data(), buffer.size());
+    reader.Skip(sizeof(FileSignature));
+    if(unlikely(reader.ReadUInt32() != FileVersion)) {
+      throw Errors::CorruptedFileError(u8"Saved container info cache has unknown version");
+    }
+
+    // Parse everything before touching the cache so a truncated file changes nothing
+    EntryMap loadedEntries;
+    std::uint64_t entryCount = reader.ReadUInt64();
+    for(std::uint64_t entryIndex = 0; entryIndex < entryCount; ++entryIndex) {
+      std::string path = reader.ReadString();
+
+      Entry entry;
+      entry.Size = reader.ReadUInt64();
+      entry.ModificationTime = reader.ReadUInt64();
+      if(reader.ReadUInt8() != 0) {
+        entry.Info = reader.ReadContainerInfo();
+      }
+
+      loadedEntries[std::move(path)] = std::move(entry);
+    }
+
+    std::lock_guard<std::mutex> entryScope(this->entryMutex);
+    for(EntryMap::value_type &pathAndEntry : loadedEntries) {
+      this->entries[pathAndEntry.first] = std::move(pathAndEntry.second);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
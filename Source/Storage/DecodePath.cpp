@@ -0,0 +1,73 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/DecodePath.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a count with a singular or plural noun to a string</summary>
+  /// <param name="target">String to which the count will be appended</param>
+  /// <param name="count">Count that will be appended</param>
+  /// <param name="noun">Noun that will follow the count, in its singular form</param>
+  /// <param name="pluralNoun">Noun that will follow the count, in its plural form</param>
+  void appendCount(
+    std::string &target, std::size_t count, const char *noun, const char *pluralNoun
+  ) {
+    target.append(u8", ");
+    target.append(std::to_string(count));
+    target.push_back(u8' ');
+    target.append((count == 1) ? noun : pluralNoun);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string DecodePath::ToString() const {
+    std::string result = this->Origin;
+    for(const std::string &step : this->Steps) {
+      result.append(u8" -> ");
+      result.append(step);
+    }
+
+    appendCount(result, this->PassCount, u8"pass", u8"passes");
+    if(this->ScratchBufferCount == 0) {
+      result.append(u8", no scratch buffers");
+    } else {
+      appendCount(result, this->ScratchBufferCount, u8"scratch buffer", u8"scratch buffers");
+    }
+    if(this->IsZeroCopy) {
+      result.append(u8", zero-copy");
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,252 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/DecodedSoundBank.h"
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/Storage/SoundBank.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <atomic> // for std::atomic
+#include <exception> // for std::exception_ptr
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <new> // for std::bad_array_new_length
+#include <stdexcept> // for std::invalid_argument
+#include <thread> // for std::thread
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of samples that fit into one aligned block of memory</summary>
+  constexpr std::size_t SamplesPerAlignment = (
+    Nuclex::Audio::SampleAllocator::Alignment / sizeof(float)
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps a decoder so it delivers the specified channels</summary>
+  /// <param name="decoder">Decoder whose channels will be remixed</param>
+  /// <param name="channelOrder">Channels the wrapped decoder should deliver</param>
+  /// <returns>A decoder delivering the requested channels</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> mixTo(
+    const std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> &decoder,
+    const std::vector<Nuclex::Audio::ChannelPlacement> &channelOrder
+  ) {
+    using Nuclex::Audio::ChannelPlacement;
+    using Nuclex::Audio::Processing::ChannelMixer;
+    using Nuclex::Audio::Processing::DownmixMatrix;
+    using Nuclex::Audio::Storage::AudioTrackDecoder;
+
+    const std::vector<ChannelPlacement> &inputChannelOrder = decoder->GetChannelOrder();
+    if(inputChannelOrder == channelOrder) {
+      return decoder;
+    }
+
+    if(channelOrder.size() >= inputChannelOrder.size()) {
+      return AudioTrackDecoder::CreateMixer(
+        decoder, ChannelMixer::CreateUpmix(inputChannelOrder, channelOrder)
+      );
+    }
+
+    // Mixing down to stereo or mono is common enough to deserve the proper presets,
+    // everything else just keeps the channels both sides have in common
+    bool isStereo = (
+      (channelOrder.size() == 2) &&
+      (channelOrder[0] == ChannelPlacement::FrontLeft) &&
+      (channelOrder[1] == ChannelPlacement::FrontRight)
+    );
+    if(isStereo) {
+      return AudioTrackDecoder::CreateDownmix(
+        decoder, DownmixMatrix::CreateItuStereo(inputChannelOrder)
+      );
+    }
+
+    bool isMono = (
+      (channelOrder.size() == 1) && (channelOrder[0] == ChannelPlacement::FrontCenter)
+    );
+    if(isMono) {
+      return AudioTrackDecoder::CreateDownmix(
+        decoder, DownmixMatrix::CreateItuMono(inputChannelOrder)
+      );
+    }
+
+    return AudioTrackDecoder::CreateMixer(
+      decoder, ChannelMixer::CreateRouting(inputChannelOrder, channelOrder)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a task for each clip, spreading the clips over several threads</summary>
+  /// <typeparam name="TTask">Type of the task that will be run</typeparam>
+  /// <param name="clipCount">Number of clips the task will be run for</param>
+  /// <param name="threadCount">Number of threads that will run the task</param>
+  /// <param name="task">Task that will be run with the index of each clip</param>
+  /// <remarks>
+  ///   If the task throws for any clip, the remaining clips are skipped and
+  ///   the first exception is rethrown once all threads have finished.
+  /// </remarks>
+  template<typename TTask>
+  void forEachClip(std::size_t clipCount, std::size_t threadCount, const TTask &task) {
+    std::atomic<std::size_t> nextClipIndex(0);
+    std::atomic<bool> isAborted(false);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto processClips = [&]() {
+      for(;;) {
+        std::size_t clipIndex = nextClipIndex.fetch_add(1, std::memory_order_relaxed);
+        if((clipIndex >= clipCount) || isAborted.load(std::memory_order_relaxed)) {
+          return;
+        }
+
+        try {
+          task(clipIndex);
+        }
+        catch(...) {
+          std::lock_guard<std::mutex> errorScope(errorMutex);
+          if(!static_cast<bool>(error)) {
+            error = std::current_exception();
+          }
+          isAborted.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    };
+
+    // The calling thread acts as a worker, too, so the clips get processed even if
+    // all of the executor's workers are busy
+    Nuclex::Audio::Executor::GetInstalled()->ParallelFor(
+      threadCount, [&](std::size_t) { processClips(); }
+    );
+
+    if(static_cast<bool>(error)) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodedSoundBank::DecodedSoundBank(
+    const SoundBank &bank,
+    const AudioLoader &loader,
+    std::size_t sampleRate /* = 48000 */,
+    const std::vector<ChannelPlacement> &channelOrder /* = { FrontLeft, FrontRight } */,
+    std::size_t threadCount /* = 0 */
+  ) :
+    sampleRate(sampleRate),
+    channelOrder(channelOrder),
+    clips(bank.CountClips()),
+    arena() {
+    if(unlikely(channelOrder.empty())) {
+      throw std::invalid_argument(u8"Decoded sound banks need at least one channel");
+    }
+    if(unlikely(sampleRate == 0)) {
+      throw std::invalid_argument(u8"Sample rate must not be zero");
+    }
+
+    std::size_t clipCount = this->clips.size();
+    if(threadCount == 0) {
+      threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threadCount = std::min(threadCount, std::max<std::size_t>(clipCount, 1));
+
+    // First open all decoders in parallel. Their frame counts are only known after
+    // resampling is set up, and the arena has to be sized before any clip is decoded.
+    std::vector<std::shared_ptr<AudioTrackDecoder>> decoders(clipCount);
+    forEachClip(
+      clipCount, threadCount,
+      [&](std::size_t clipIndex) {
+        std::shared_ptr<AudioTrackDecoder> decoder = bank.OpenDecoder(loader, clipIndex);
+        std::size_t clipSampleRate = bank.GetClip(clipIndex).Info.SampleRate;
+
+        // Resample whichever side has fewer channels so the resampler does less work
+        bool isMixedDown = (channelOrder.size() < decoder->CountChannels());
+        if(isMixedDown) {
+          decoder = mixTo(decoder, channelOrder);
+        }
+        if(clipSampleRate != sampleRate) {
+          decoder = AudioTrackDecoder::CreateResampler(decoder, clipSampleRate, sampleRate);
+        }
+        if(!isMixedDown) {
+          decoder = mixTo(decoder, channelOrder);
+        }
+
+        decoders[clipIndex] = std::move(decoder);
+      }
+    );
+
+    // Lay out the clips back to back, each one beginning on an aligned boundary
+    std::size_t channelCount = channelOrder.size();
+    std::size_t sampleCount = 0;
+    for(std::size_t clipIndex = 0; clipIndex < clipCount; ++clipIndex) {
+      std::uint64_t frameCount = decoders[clipIndex]->CountFrames();
+      std::size_t remainingSampleCount = (
+        std::numeric_limits<std::size_t>::max() / sizeof(float) - sampleCount
+      );
+      if(unlikely(frameCount > (remainingSampleCount - SamplesPerAlignment) / channelCount)) {
+        throw std::bad_array_new_length();
+      }
+
+      this->clips[clipIndex].Offset = sampleCount;
+      this->clips[clipIndex].FrameCount = static_cast<std::size_t>(frameCount);
+
+      sampleCount += static_cast<std::size_t>(frameCount) * channelCount;
+      sampleCount = (
+        (sampleCount + SamplesPerAlignment - 1) / SamplesPerAlignment * SamplesPerAlignment
+      );
+    }
+    this->arena.resize(sampleCount);
+
+    // Then decode each clip straight to its place in the arena
+    forEachClip(
+      clipCount, threadCount,
+      [&](std::size_t clipIndex) {
+        const DecodedClip &clip = this->clips[clipIndex];
+        if(clip.FrameCount > 0) {
+          decoders[clipIndex]->DecodeInterleaved<float>(
+            this->arena.data() + clip.Offset, 0, clip.FrameCount
+          );
+        }
+        decoders[clipIndex].reset();
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodedSoundBank::~DecodedSoundBank() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,477 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "DiskCachedTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Shared/DecodePathBuilder.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsFileApi.h" // for WindowsFileApi
+#else
+#include "../Platform/PosixFileApi.h" // for PosixFileApi
+#endif
+
+#include <algorithm> // for std::min(), std::min_element(), std::copy_n()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <string> // for std::to_string()
+#include <type_traits> // for std::is_same<>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Maximum number of cache files that are kept memory-mapped</summary>
+  const std::size_t MaximumMappedBlockCount = 16;
+
+  /// <summary>Changes whenever the layout of the cache files changes</summary>
+  const std::uint64_t CacheFormatVersion = 1;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes a value into a 64 bit FNV-1a hash</summary>
+  /// <param name="hash">Hash the value will be mixed into</param>
+  /// <param name="value">Value that will be mixed into the hash</param>
+  /// <returns>The updated hash</returns>
+  std::uint64_t hashValue(std::uint64_t hash, std::uint64_t value) {
+    for(std::size_t index = 0; index < 8; ++index) {
+      hash ^= (value & 0xFF);
+      hash *= 0x100000001B3ULL;
+      value >>= 8;
+    }
+
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Derives the name prefix for cache files from the decoder's attributes</summary>
+  /// <param name="identity">Identity of the decoded file's contents</param>
+  /// <param name="channelCount">Number of channels in the decoded track</param>
+  /// <param name="frameCount">Number of frames in the decoded track</param>
+  /// <param name="cacheBlockFrameCount">Number of frames stored in each cache file</param>
+  /// <returns>A string of hexadecimal digits that names the decoder's cache files</returns>
+  std::string buildCacheKey(
+    const std::string &identity,
+    std::size_t channelCount, std::uint64_t frameCount, std::size_t cacheBlockFrameCount
+  ) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for(char character : identity) {
+      hash ^= static_cast<unsigned char>(character);
+      hash *= 0x100000001B3ULL;
+    }
+    hash = hashValue(hash, CacheFormatVersion);
+    hash = hashValue(hash, channelCount);
+    hash = hashValue(hash, frameCount);
+    hash = hashValue(hash, cacheBlockFrameCount);
+
+    const char hexDigits[] = u8"0123456789abcdef";
+    std::string key(16, '0');
+    for(std::size_t index = 0; index < 16; ++index) {
+      key[15 - index] = hexDigits[hash & 0xF];
+      hash >>= 4;
+    }
+
+    return key;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size of a file if it exists</summary>
+  /// <param name="path">Path of the file whose size will be looked up</param>
+  /// <param name="size">Receives the size of the file in bytes</param>
+  /// <returns>True if the file exists, false otherwise</returns>
+  bool tryGetFileSize(const std::string &path, std::uint64_t &size) {
+    std::uint64_t modificationTime;
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    return Nuclex::Audio::Platform::WindowsFileApi::TryGetFileAttributes(
+      path, size, modificationTime
+    );
+#else
+    return Nuclex::Audio::Platform::PosixFileApi::TryStatFile(path, size, modificationTime);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DiskCachedTrackDecoder::DiskCachedTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::string &cacheDirectory,
+    const std::string &identity,
+    std::size_t cacheBlockFrameCount
+  ) :
+    decoder(decoder),
+    cacheDirectory(cacheDirectory),
+    identity(identity),
+    cacheKey(),
+    cacheBlockFrameCount(cacheBlockFrameCount),
+    cacheMutex(),
+    blockScratch(),
+    mappedBlocks(),
+    useCounter(0) {
+    if(!decoder) {
+      throw std::invalid_argument(u8"Disk-cached decoder requires a decoder to wrap");
+    }
+    if(cacheBlockFrameCount == 0) {
+      throw std::invalid_argument(u8"Cache blocks need to hold at least one frame");
+    }
+
+    bool needsSeparator = (
+      !this->cacheDirectory.empty() &&
+      (this->cacheDirectory.back() != '/') &&
+      (this->cacheDirectory.back() != '\\')
+    );
+    if(needsSeparator) {
+      this->cacheDirectory.push_back('/');
+    }
+
+    this->cacheKey = buildCacheKey(
+      identity, decoder->CountChannels(), decoder->CountFrames(), cacheBlockFrameCount
+    );
+    this->blockScratch.resize(cacheBlockFrameCount * decoder->CountChannels());
+    this->mappedBlocks.reserve(MaximumMappedBlockCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DiskCachedTrackDecoder::~DiskCachedTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> DiskCachedTrackDecoder::Clone() const {
+    return std::make_shared<DiskCachedTrackDecoder>(
+      this->decoder->Clone(), this->cacheDirectory, this->identity, this->cacheBlockFrameCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath DiskCachedTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    sampleFormat = Shared::DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+
+    // This describes reading a block that is already in the cache. Blocks that aren't
+    // are first decoded by the wrapped decoder, which is a one-time cost per block.
+    Shared::DecodePathBuilder builder(u8"Disk cache", AudioSampleFormat::Float_32, u8"mapped");
+    builder.SetZeroCopy();
+
+    bool isFloat = (sampleFormat == AudioSampleFormat::Float_32);
+    if(interleaved) {
+      builder.AddPass(isFloat ? u8"copy" : u8"convert");
+    } else if(isFloat) {
+      builder.AddPass(u8"separate");
+    } else {
+      builder.AddScratchBuffer().AddPass(u8"separate").AddPass(u8"convert");
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost DiskCachedTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::uint64_t blockIndex = targetFrame / this->cacheBlockFrameCount;
+
+    // Blocks that are in the cache are read directly from their cache file
+    std::size_t byteCount = (
+      countBlockFrames(blockIndex) * this->decoder->CountChannels() * sizeof(float)
+    );
+    std::uint64_t fileSize;
+    if(tryGetFileSize(getBlockPath(blockIndex), fileSize) && (fileSize == byteCount)) {
+      return SeekCost { 0, 0, 1, true };
+    }
+
+    // Other blocks are decoded as a whole by the wrapped decoder before they're delivered
+    std::uint64_t blockStart = blockIndex * this->cacheBlockFrameCount;
+    SeekCost cost = this->decoder->EstimateSeekCost(blockStart);
+    cost.DiscardedFrameCount += targetFrame - blockStart;
+
+    return cost;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int16_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int32_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<float>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<double>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::uint8_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int16_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int32_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<float>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DiskCachedTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<double>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DiskCachedTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t totalFrameCount = this->decoder->CountFrames();
+    if((startFrame > totalFrameCount) || (frameCount > totalFrameCount - startFrame)) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    while(frameCount > 0) {
+      std::uint64_t blockIndex = startFrame / this->cacheBlockFrameCount;
+      std::size_t offset = static_cast<std::size_t>(
+        startFrame - (blockIndex * this->cacheBlockFrameCount)
+      );
+      std::size_t chunkFrameCount = std::min(countBlockFrames(blockIndex) - offset, frameCount);
+
+      const float *samples = acquireBlock(blockIndex) + (offset * channelCount);
+      if constexpr(std::is_same<TSample, float>::value) {
+        std::copy_n(samples, chunkFrameCount * channelCount, buffer);
+      } else {
+        Processing::SampleConverter::Convert(
+          samples, 32, buffer, sizeof(TSample) * 8, chunkFrameCount * channelCount
+        );
+      }
+
+      buffer += chunkFrameCount * channelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DiskCachedTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t totalFrameCount = this->decoder->CountFrames();
+    if((startFrame > totalFrameCount) || (frameCount > totalFrameCount - startFrame)) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+
+    // Channels that need to be converted are gathered into a scratch buffer first,
+    // so that the converter can work on contiguous samples
+    std::vector<float> channelScratch;
+    if constexpr(!std::is_same<TSample, float>::value) {
+      channelScratch.resize(std::min<std::size_t>(frameCount, this->cacheBlockFrameCount));
+    }
+
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    std::size_t targetOffset = 0;
+    while(targetOffset < frameCount) {
+      std::uint64_t blockIndex = startFrame / this->cacheBlockFrameCount;
+      std::size_t offset = static_cast<std::size_t>(
+        startFrame - (blockIndex * this->cacheBlockFrameCount)
+      );
+      std::size_t chunkFrameCount = std::min(
+        countBlockFrames(blockIndex) - offset, frameCount - targetOffset
+      );
+
+      const float *samples = acquireBlock(blockIndex) + (offset * channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        if(buffers[channelIndex] == nullptr) {
+          continue;
+        }
+
+        float *gathered;
+        if constexpr(std::is_same<TSample, float>::value) {
+          gathered = buffers[channelIndex] + targetOffset;
+        } else {
+          gathered = channelScratch.data();
+        }
+        for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+          gathered[frameIndex] = samples[frameIndex * channelCount + channelIndex];
+        }
+        if constexpr(!std::is_same<TSample, float>::value) {
+          Processing::SampleConverter::Convert(
+            gathered, 32, buffers[channelIndex] + targetOffset, sizeof(TSample) * 8,
+            chunkFrameCount
+          );
+        }
+      }
+
+      startFrame += chunkFrameCount;
+      targetOffset += chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const float *DiskCachedTrackDecoder::acquireBlock(std::uint64_t blockIndex) const {
+    ++this->useCounter;
+
+    // Most accesses while scrubbing hit a block that is already mapped
+    for(MappedBlock &mappedBlock : this->mappedBlocks) {
+      if(mappedBlock.BlockIndex == blockIndex) {
+        mappedBlock.LastUse = this->useCounter;
+        return reinterpret_cast<const float *>(
+          mappedBlock.File->TryBorrowAt(0, mappedBlock.File->GetSize())
+        );
+      }
+    }
+
+    std::size_t frameCount = countBlockFrames(blockIndex);
+    std::size_t byteCount = frameCount * this->decoder->CountChannels() * sizeof(float);
+
+    // If a complete cache file exists, map it. If the OS won't let us map it,
+    // the normal file access path will still be faster than decoding the block.
+    std::string path = getBlockPath(blockIndex);
+    std::uint64_t fileSize;
+    if(tryGetFileSize(path, fileSize) && (fileSize == byteCount)) {
+      std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+        path, FileAccessPattern::Random, true
+      );
+      const std::byte *memory = file->TryBorrowAt(0, byteCount);
+      if(memory == nullptr) {
+        file->ReadAt(0, byteCount, reinterpret_cast<std::byte *>(this->blockScratch.data()));
+        return this->blockScratch.data();
+      }
+
+      if(this->mappedBlocks.size() >= MaximumMappedBlockCount) {
+        std::vector<MappedBlock>::iterator leastRecentlyUsed = std::min_element(
+          this->mappedBlocks.begin(), this->mappedBlocks.end(),
+          [](const MappedBlock &left, const MappedBlock &right) {
+            return left.LastUse < right.LastUse;
+          }
+        );
+        this->mappedBlocks.erase(leastRecentlyUsed);
+      }
+      this->mappedBlocks.push_back(MappedBlock { blockIndex, this->useCounter, file });
+
+      return reinterpret_cast<const float *>(memory);
+    }
+
+    // The block isn't cached yet, so decode it and write it to the cache
+    this->decoder->DecodeInterleaved(
+      this->blockScratch.data(), blockIndex * this->cacheBlockFrameCount, frameCount
+    );
+    try {
+      std::shared_ptr<VirtualFile> file = VirtualFile::OpenRealFileForWriting(path, true);
+      file->WriteAt(
+        0, byteCount, reinterpret_cast<const std::byte *>(this->blockScratch.data())
+      );
+      file->Flush();
+    }
+    catch(const std::exception &) {
+      // The cache only speeds things up. If the disk is full or the directory
+      // is read-only, the caller still gets the decoded samples.
+    }
+
+    return this->blockScratch.data();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string DiskCachedTrackDecoder::getBlockPath(std::uint64_t blockIndex) const {
+    return this->cacheDirectory + this->cacheKey + u8"-" + std::to_string(blockIndex) + u8".pcm";
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t DiskCachedTrackDecoder::countBlockFrames(std::uint64_t blockIndex) const {
+    std::uint64_t blockStart = blockIndex * this->cacheBlockFrameCount;
+    return static_cast<std::size_t>(
+      std::min<std::uint64_t>(
+        this->cacheBlockFrameCount, this->decoder->CountFrames() - blockStart
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
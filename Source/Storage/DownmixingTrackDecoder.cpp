@@ -0,0 +1,300 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "DownmixingTrackDecoder.h"
+
+#include "Shared/ClampingSampleConverter.h"
+#include "Shared/DecodePathBuilder.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+#include <type_traits> // for std::is_same<>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded and mixed in one go</summary>
+  /// <remarks>
+  ///   Small enough that the scratch buffers for 8 input channels stay in a 256 KiB cache,
+  ///   large enough that the per-call overhead of the wrapped decoder doesn't matter.
+  /// </remarks>
+  const std::size_t MixChunkFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixingTrackDecoder::DownmixingTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const Processing::DownmixMatrix &matrix
+  ) :
+    DownmixingTrackDecoder(decoder, Processing::ChannelMixer(matrix)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixingTrackDecoder::DownmixingTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const Processing::ChannelMixer &mixer
+  ) :
+    decoder(decoder),
+    mixer(mixer),
+    scratchMutex(),
+    inputScratch(),
+    outputScratch() {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Downmixing decoder requires a decoder to mix down");
+    }
+    if(unlikely(decoder->GetChannelOrder() != mixer.GetInputChannelOrder())) {
+      throw std::invalid_argument(
+        u8"Downmix matrix must be built for the channel order of the decoder"
+      );
+    }
+
+    this->inputScratch.resize(mixer.CountInputChannels() * MixChunkFrameCount);
+    this->outputScratch.resize(mixer.CountOutputChannels() * MixChunkFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DownmixingTrackDecoder::~DownmixingTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> DownmixingTrackDecoder::Clone() const {
+    return std::make_shared<DownmixingTrackDecoder>(this->decoder->Clone(), this->mixer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath DownmixingTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    sampleFormat = Shared::DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+
+    // The wrapped decoder always delivers separated floats into the input scratch buffer
+    Shared::DecodePathBuilder builder(
+      this->decoder->ExplainDecodePath(AudioSampleFormat::Float_32, false)
+    );
+    builder.AddScratchBuffer();
+
+    // Separated floats are mixed straight into the caller's buffers
+    if(!interleaved && (sampleFormat == AudioSampleFormat::Float_32)) {
+      builder.AddPass(u8"mix");
+    } else {
+      builder.AddScratchBuffer().AddPass(u8"mix").AddPass(u8"convert");
+      if(interleaved) {
+        builder.AddFusedStep(u8"interleave");
+      }
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int16_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int32_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<float>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<double>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::uint8_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int16_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int32_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<float>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<double>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DownmixingTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t outputChannelCount = this->mixer.CountOutputChannels();
+
+    std::vector<const float *> inputs(this->mixer.CountInputChannels());
+    std::vector<float *> outputs(outputChannelCount);
+
+    std::lock_guard<std::mutex> scratchMutexScope(this->scratchMutex);
+    for(std::size_t index = 0; index < inputs.size(); ++index) {
+      inputs[index] = this->inputScratch.data() + (index * MixChunkFrameCount);
+    }
+    for(std::size_t index = 0; index < outputChannelCount; ++index) {
+      outputs[index] = this->outputScratch.data() + (index * MixChunkFrameCount);
+    }
+
+    while(0 < frameCount) {
+      std::size_t chunkFrameCount = std::min(frameCount, MixChunkFrameCount);
+      decodeChunk(startFrame, chunkFrameCount);
+      this->mixer.MixSeparated(inputs.data(), outputs.data(), chunkFrameCount);
+
+      for(std::size_t index = 0; index < outputChannelCount; ++index) {
+        Shared::ClampingSampleConverter::Convert(
+          outputs[index], buffer + index, outputChannelCount, chunkFrameCount
+        );
+      }
+
+      buffer += chunkFrameCount * outputChannelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DownmixingTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t outputChannelCount = this->mixer.CountOutputChannels();
+
+    std::vector<const float *> inputs(this->mixer.CountInputChannels());
+    std::vector<float *> outputs(outputChannelCount);
+
+    std::lock_guard<std::mutex> scratchMutexScope(this->scratchMutex);
+    for(std::size_t index = 0; index < inputs.size(); ++index) {
+      inputs[index] = this->inputScratch.data() + (index * MixChunkFrameCount);
+    }
+
+    std::size_t offset = 0;
+    while(offset < frameCount) {
+      std::size_t chunkFrameCount = std::min(frameCount - offset, MixChunkFrameCount);
+      decodeChunk(startFrame + offset, chunkFrameCount);
+
+      // Float samples can be mixed straight into the caller's buffers,
+      // other sample types need to go through the output scratch buffer
+      for(std::size_t index = 0; index < outputChannelCount; ++index) {
+        if(buffers[index] == nullptr) {
+          outputs[index] = nullptr;
+        } else if constexpr(std::is_same<TSample, float>::value) {
+          outputs[index] = buffers[index] + offset;
+        } else {
+          outputs[index] = this->outputScratch.data() + (index * MixChunkFrameCount);
+        }
+      }
+
+      this->mixer.MixSeparated(inputs.data(), outputs.data(), chunkFrameCount);
+
+      if constexpr(!std::is_same<TSample, float>::value) {
+        for(std::size_t index = 0; index < outputChannelCount; ++index) {
+          if(outputs[index] != nullptr) {
+            Shared::ClampingSampleConverter::Convert(
+              outputs[index], buffers[index] + offset, 1, chunkFrameCount
+            );
+          }
+        }
+      }
+
+      offset += chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DownmixingTrackDecoder::decodeChunk(
+    std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t inputChannelCount = this->mixer.CountInputChannels();
+
+    std::vector<float *> inputs(inputChannelCount);
+    for(std::size_t index = 0; index < inputChannelCount; ++index) {
+      inputs[index] = this->inputScratch.data() + (index * MixChunkFrameCount);
+    }
+
+    this->decoder->DecodeSeparated<float>(inputs.data(), startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,304 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_DOWNMIXINGTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_DOWNMIXINGTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes the channels of another decoder down while they're being decoded</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Surround tracks played on stereo devices would otherwise have to be decoded
+  ///     into a buffer holding all channels, only to be mixed down into another buffer
+  ///     right after. This decorator decodes small chunks of the wrapped decoder's
+  ///     channels into a scratch buffer that stays in the CPU cache, mixes them via
+  ///     a <see cref="Processing::ChannelMixer" /> and converts the mixed channels
+  ///     straight into the caller's buffer. Upmixing and routing work the same way.
+  ///   </para>
+  ///   <para>
+  ///     Mixed samples are clamped to full scale when they're converted to integers.
+  ///     Floating point results are delivered as they are.
+  ///   </para>
+  /// </remarks>
+  class DownmixingTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new downmixing decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder whose channels will be mixed down</param>
+    /// <param name="matrix">Matrix that describes how to mix the channels</param>
+    public: DownmixingTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const Processing::DownmixMatrix &matrix
+    );
+
+    /// <summary>Initializes a new mixing decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder whose channels will be mixed</param>
+    /// <param name="mixer">Mixer that will produce the delivered channels</param>
+    public: DownmixingTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const Processing::ChannelMixer &mixer
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~DownmixingTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of channels produced by the downmix</returns>
+    public: std::size_t CountChannels() const override {
+      return this->mixer.CountOutputChannels();
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->mixer.GetOutputChannelOrder();
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const override {
+      return this->decoder->CountFrames();
+    }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->decoder->GetNativeSampleFormat();
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>Always false, mixing works on separated channels</returns>
+    public: bool IsNativelyInterleaved() const override { return false; }
+
+    /// <summary>Determines where the native block containing a frame begins</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The index of the first frame in the block containing the frame</returns>
+    public: std::uint64_t GetBlockStart(std::uint64_t frameIndex) const override {
+      return this->decoder->GetBlockStart(frameIndex);
+    }
+
+    /// <summary>Determines the length of the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The number of frames in the block containing the frame</returns>
+    public: std::size_t GetBlockSize(std::uint64_t frameIndex) const override {
+      return this->decoder->GetBlockSize(frameIndex);
+    }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    public: void BuildSeekIndex() const override {
+      this->decoder->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->decoder->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->decoder->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->decoder->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override {
+      this->decoder->EnableStatistics(enable);
+    }
+
+    /// <summary>Retrieves the statistics the wrapped decoder has collected so far</summary>
+    /// <returns>The current values of the wrapped decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override {
+      return this->decoder->GetStatistics();
+    }
+
+    /// <summary>Retrieves the wrapped decoder's distribution of decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each of the wrapped decoder's calls took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override {
+      return this->decoder->GetDecodeLatencies(reset);
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override {
+      return this->decoder->EstimateSeekCost(targetFrame);
+    }
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes, mixes and interleaves audio frames into the target buffer</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes and mixes audio channels into the target buffers</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes one chunk of the wrapped decoder's channels</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of frames to decode, at most one chunk</param>
+    /// <remarks>
+    ///   The decoded channels are stored in the input scratch buffer. The scratch mutex
+    ///   must be held by the caller.
+    /// </remarks>
+    private: void decodeChunk(std::uint64_t startFrame, std::size_t frameCount) const;
+
+    /// <summary>Decoder whose channels are mixed down</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Mixes the channels via the kernels selected for the matrix</summary>
+    private: Processing::ChannelMixer mixer;
+    /// <summary>Must be held while the scratch buffers are in use</summary>
+    private: mutable std::mutex scratchMutex;
+    /// <summary>Holds one chunk of each channel decoded by the wrapped decoder</summary>
+    private: mutable SampleVector<float> inputScratch;
+    /// <summary>Holds one chunk of each channel produced by the downmix</summary>
+    private: mutable SampleVector<float> outputScratch;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_DOWNMIXINGTRACKDECODER_H
@@ -0,0 +1,245 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/EffortCalibrator.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+
+#include <algorithm> // for std::min()
+#include <charconv> // for std::to_chars(), std::from_chars()
+#include <chrono> // for std::chrono::steady_clock
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames handed to the encoder per call</summary>
+  const std::size_t EncodedFrameCount = 16384;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes interleaved samples into memory and times the encoder</summary>
+  /// <param name="builder">Fully configured builder for the encoder</param>
+  /// <param name="samples">Interleaved samples that will be encoded</param>
+  /// <param name="channelCount">Number of channels in the samples</param>
+  /// <param name="capacity">Bytes to reserve for the encoded output</param>
+  /// <param name="encodedByteCount">Receives the size of the encoder's output</param>
+  /// <returns>The number of seconds the encoder took</returns>
+  double timeEncoding(
+    Nuclex::Audio::Storage::AudioTrackEncoderBuilder &builder,
+    const std::vector<float> &samples,
+    std::size_t channelCount,
+    std::size_t capacity,
+    std::uint64_t &encodedByteCount
+  ) {
+    using Nuclex::Audio::Storage::WritableMemoryFile;
+
+    // The target is reserved up front so that reallocations don't end up in the timing
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>(capacity);
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> encoder = builder.Build(target);
+
+    std::size_t frameCount = samples.size() / channelCount;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for(std::size_t start = 0; start < frameCount; start += EncodedFrameCount) {
+      std::size_t count = std::min(EncodedFrameCount, frameCount - start);
+      encoder->EncodeInterleaved(samples.data() + start * channelCount, count);
+    }
+    encoder->Flush();
+    std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+    encodedByteCount = target->GetSize();
+    return std::chrono::duration<double>(endTime - startTime).count();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<EffortMeasurement> EffortCalibrator::Measure(
+    const AudioTrackDecoder &sample,
+    std::size_t sampleRate,
+    AudioTrackEncoderBuilder &builder,
+    const std::vector<float> &efforts /* = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f } */
+  ) {
+    if(unlikely(sampleRate == 0)) {
+      throw std::invalid_argument(u8"Sample rate must not be zero");
+    }
+
+    std::size_t channelCount = sample.CountChannels();
+    std::size_t frameCount = static_cast<std::size_t>(sample.CountFrames());
+    if(unlikely(frameCount == 0)) {
+      throw std::invalid_argument(u8"Calibration sample must not be empty");
+    }
+
+    // Decode the sample only once, decoding time is not what's being measured
+    std::vector<float> samples(frameCount * channelCount);
+    sample.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    builder.SetSampleRate(sampleRate);
+    builder.SetChannels(sample.GetChannelOrder());
+    builder.SetThreadCount(1);
+
+    double durationSeconds = static_cast<double>(frameCount) / static_cast<double>(sampleRate);
+    std::size_t capacity = samples.size() * sizeof(float) + 4096;
+
+    std::vector<EffortMeasurement> measurements;
+    measurements.reserve(efforts.size());
+    for(float effort : efforts) {
+      builder.SetCompressionEffort(effort);
+
+      EffortMeasurement measurement;
+      measurement.Effort = effort;
+      measurement.EncodingSeconds = timeEncoding(
+        builder, samples, channelCount, capacity, measurement.EncodedByteCount
+      );
+      if(measurement.EncodingSeconds > 0.0) {
+        measurement.RealtimeFactor = durationSeconds / measurement.EncodingSeconds;
+      } else {
+        measurement.RealtimeFactor = 0.0;
+      }
+
+      measurements.push_back(measurement);
+    }
+
+    return measurements;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float EffortCalibrator::RecommendEffort(const std::vector<EffortMeasurement> &measurements) {
+    if(unlikely(measurements.empty())) {
+      throw std::invalid_argument(u8"At least one measurement is required");
+    }
+
+    std::uint64_t largestByteCount = 0;
+    std::size_t fastestIndex = 0;
+    for(std::size_t index = 0; index < measurements.size(); ++index) {
+      if(measurements[index].EncodedByteCount > largestByteCount) {
+        largestByteCount = measurements[index].EncodedByteCount;
+      }
+      if(measurements[index].EncodingSeconds < measurements[fastestIndex].EncodingSeconds) {
+        fastestIndex = index;
+      }
+    }
+
+    // Score each effort by the bytes it saves per second spent encoding
+    std::size_t bestIndex = fastestIndex;
+    double bestSavingsPerSecond = 0.0;
+    for(std::size_t index = 0; index < measurements.size(); ++index) {
+      const EffortMeasurement &measurement = measurements[index];
+      if(measurement.EncodedByteCount >= largestByteCount) {
+        continue; // Saves nothing, can't beat the fastest effort
+      }
+
+      double savedByteCount = static_cast<double>(
+        largestByteCount - measurement.EncodedByteCount
+      );
+      double seconds = std::max(measurement.EncodingSeconds, 1e-9);
+      double savingsPerSecond = savedByteCount / seconds;
+      if(savingsPerSecond > bestSavingsPerSecond) {
+        bestSavingsPerSecond = savingsPerSecond;
+        bestIndex = index;
+      }
+    }
+
+    return measurements[bestIndex].Effort;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void EffortCalibrator::SaveRecommendations(
+    const std::map<std::string, float> &recommendations, VirtualFile &target
+  ) {
+    std::string contents;
+    for(const std::pair<const std::string, float> &recommendation : recommendations) {
+      if(unlikely(recommendation.first.find_first_of(u8"=\r\n") != std::string::npos)) {
+        throw std::invalid_argument(u8"Codec names must not contain '=' or line breaks");
+      }
+
+      // std::to_chars() is locale-independent, so files can be moved between machines
+      char effort[32];
+      std::to_chars_result result = std::to_chars(
+        effort, effort + sizeof(effort), recommendation.second
+      );
+
+      contents.append(recommendation.first);
+      contents.push_back(u8'=');
+      contents.append(effort, result.ptr);
+      contents.push_back(u8'\n');
+    }
+
+    target.WriteAt(0, contents.size(), reinterpret_cast<const std::byte *>(contents.data()));
+    target.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::map<std::string, float> EffortCalibrator::LoadRecommendations(const VirtualFile &source) {
+    std::string contents(static_cast<std::size_t>(source.GetSize()), '\0');
+    source.ReadAt(0, contents.size(), reinterpret_cast<std::byte *>(contents.data()));
+
+    std::map<std::string, float> recommendations;
+
+    std::string::size_type lineStart = 0;
+    while(lineStart < contents.size()) {
+      std::string::size_type lineEnd = contents.find(u8'\n', lineStart);
+      if(lineEnd == std::string::npos) {
+        lineEnd = contents.size();
+      }
+
+      // Tolerate files that passed through an editor and picked up CR-LF line breaks
+      std::string::size_type valueEnd = lineEnd;
+      if((valueEnd > lineStart) && (contents[valueEnd - 1] == u8'\r')) {
+        --valueEnd;
+      }
+
+      std::string::size_type separator = contents.find(u8'=', lineStart);
+      if((separator != std::string::npos) && (separator < valueEnd)) {
+        float effort = 0.0f;
+        std::from_chars_result result = std::from_chars(
+          contents.data() + separator + 1, contents.data() + valueEnd, effort
+        );
+        if(unlikely((result.ec != std::errc()) || (result.ptr != contents.data() + valueEnd))) {
+          throw std::invalid_argument(u8"Compression effort recommendation is malformed");
+        }
+
+        recommendations[contents.substr(lineStart, separator - lineStart)] = effort;
+      } else if(unlikely(valueEnd > lineStart)) {
+        throw std::invalid_argument(u8"Compression effort recommendation is malformed");
+      }
+
+      lineStart = lineEnd + 1;
+    }
+
+    return recommendations;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
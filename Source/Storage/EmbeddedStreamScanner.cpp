@@ -0,0 +1,571 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/EmbeddedStreamScanner.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for NUCLEX_AUDIO_HAVE_SSE2 and intrinsics
+
+#include "./Waveform/WaveformDetection.h"
+#include "./Flac/FlacDetection.h"
+#include "./Opus/OpusDetection.h"
+#include "./Vorbis/VorbisDetection.h"
+#include "./WavPack/WavPackDetection.h"
+
+#include <algorithm> // for std::min()
+#include <optional> // for std::optional
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes read from the blob at once while searching</summary>
+  constexpr std::size_t WindowSize = 1048576;
+
+  /// <summary>Number of bytes handed to the header checks for each candidate</summary>
+  /// <remarks>
+  ///   The Ogg checks need the most, 48 bytes to see into the first packet.
+  /// </remarks>
+  constexpr std::size_t HeaderCheckLength = 64;
+
+  /// <summary>Upper limit for the number of Ogg pages or WavPack blocks walked</summary>
+  /// <remarks>
+  ///   Only a safeguard against pathological data. At 64 KiB per page, this still
+  ///   covers 4 TiB per stream.
+  /// </remarks>
+  constexpr std::size_t MaximumFrameCount = 64 * 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Kinds of signatures the scanner looks for</summary>
+  enum class SignatureKind { None, Riff, Flac, Ogg, WavPack };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether four bytes match the specified characters</summary>
+  /// <param name="bytes">Bytes that will be compared</param>
+  /// <param name="fourCC">Characters the bytes will be compared against</param>
+  /// <returns>True if the bytes match the characters</returns>
+  bool isFourCC(const std::byte *bytes, const char (&fourCC)[5]) {
+    return (
+      (bytes[0] == static_cast<std::byte>(fourCC[0])) &&
+      (bytes[1] == static_cast<std::byte>(fourCC[1])) &&
+      (bytes[2] == static_cast<std::byte>(fourCC[2])) &&
+      (bytes[3] == static_cast<std::byte>(fourCC[3]))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines which file signature, if any, starts at the specified bytes</summary>
+  /// <param name="bytes">Four bytes that will be checked</param>
+  /// <returns>The kind of signature that was found</returns>
+  SignatureKind getSignatureKind(const std::byte *bytes) {
+    if(
+      isFourCC(bytes, "RIFF") || isFourCC(bytes, "RIFX") || isFourCC(bytes, "RF64") ||
+      isFourCC(bytes, "BW64") || isFourCC(bytes, "XFIR") || isFourCC(bytes, "FFIR")
+    ) {
+      return SignatureKind::Riff;
+    } else if(isFourCC(bytes, "fLaC")) {
+      return SignatureKind::Flac;
+    } else if(isFourCC(bytes, "OggS")) {
+      return SignatureKind::Ogg;
+    } else if(isFourCC(bytes, "wvpk")) {
+      return SignatureKind::WavPack;
+    } else {
+      return SignatureKind::None;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the next offset in a buffer at which a file signature begins</summary>
+  /// <param name="buffer">Buffer that will be searched</param>
+  /// <param name="start">Offset in the buffer at which the search begins</param>
+  /// <param name="length">Total number of bytes in the buffer</param>
+  /// <returns>The offset of the signature or the buffer length if none was found</returns>
+  /// <remarks>
+  ///   Sixteen offsets are checked at once by comparing the first and the fourth byte
+  ///   of every signature. Only offsets passing that test are looked at in full.
+  /// </remarks>
+  std::size_t findNextSignature(
+    const std::byte *buffer, std::size_t start, std::size_t length
+  ) {
+    std::size_t index = start;
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    const __m128i r = _mm_set1_epi8('R'), b = _mm_set1_epi8('B'), x = _mm_set1_epi8('X');
+    const __m128i f = _mm_set1_epi8('F'), l = _mm_set1_epi8('f'), o = _mm_set1_epi8('O');
+    const __m128i w = _mm_set1_epi8('w'), four = _mm_set1_epi8('4');
+    const __m128i c = _mm_set1_epi8('C'), s = _mm_set1_epi8('S'), k = _mm_set1_epi8('k');
+    for(; index + 19 <= length; index += 16) {
+      __m128i heads = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + index));
+      __m128i tails = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + index + 3));
+
+      // RIFF, RIFX and RF64 share their first letter, the others are all unique pairs
+      __m128i riffTails = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(tails, f), _mm_cmpeq_epi8(tails, x)),
+        _mm_cmpeq_epi8(tails, four)
+      );
+      __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(heads, r), riffTails);
+      hits = _mm_or_si128(
+        hits, _mm_and_si128(_mm_cmpeq_epi8(heads, b), _mm_cmpeq_epi8(tails, four))
+      );
+      hits = _mm_or_si128(
+        hits, _mm_and_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(heads, x), _mm_cmpeq_epi8(heads, f)),
+          _mm_cmpeq_epi8(tails, r)
+        )
+      );
+      hits = _mm_or_si128(
+        hits, _mm_and_si128(_mm_cmpeq_epi8(heads, l), _mm_cmpeq_epi8(tails, c))
+      );
+      hits = _mm_or_si128(
+        hits, _mm_and_si128(_mm_cmpeq_epi8(heads, o), _mm_cmpeq_epi8(tails, s))
+      );
+      hits = _mm_or_si128(
+        hits, _mm_and_si128(_mm_cmpeq_epi8(heads, w), _mm_cmpeq_epi8(tails, k))
+      );
+
+      int mask = _mm_movemask_epi8(hits);
+      for(std::size_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if((mask & 1) != 0) {
+          if(getSignatureKind(buffer + index + lane) != SignatureKind::None) {
+            return index + lane;
+          }
+        }
+      }
+    }
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(buffer);
+    for(; index + 19 <= length; index += 16) {
+      uint8x16_t heads = vld1q_u8(bytes + index);
+      uint8x16_t tails = vld1q_u8(bytes + index + 3);
+
+      uint8x16_t riffTails = vorrq_u8(
+        vorrq_u8(vceqq_u8(tails, vdupq_n_u8('F')), vceqq_u8(tails, vdupq_n_u8('X'))),
+        vceqq_u8(tails, vdupq_n_u8('4'))
+      );
+      uint8x16_t hits = vandq_u8(vceqq_u8(heads, vdupq_n_u8('R')), riffTails);
+      hits = vorrq_u8(
+        hits, vandq_u8(vceqq_u8(heads, vdupq_n_u8('B')), vceqq_u8(tails, vdupq_n_u8('4')))
+      );
+      hits = vorrq_u8(
+        hits, vandq_u8(
+          vorrq_u8(vceqq_u8(heads, vdupq_n_u8('X')), vceqq_u8(heads, vdupq_n_u8('F'))),
+          vceqq_u8(tails, vdupq_n_u8('R'))
+        )
+      );
+      hits = vorrq_u8(
+        hits, vandq_u8(vceqq_u8(heads, vdupq_n_u8('f')), vceqq_u8(tails, vdupq_n_u8('C')))
+      );
+      hits = vorrq_u8(
+        hits, vandq_u8(vceqq_u8(heads, vdupq_n_u8('O')), vceqq_u8(tails, vdupq_n_u8('S')))
+      );
+      hits = vorrq_u8(
+        hits, vandq_u8(vceqq_u8(heads, vdupq_n_u8('w')), vceqq_u8(tails, vdupq_n_u8('k')))
+      );
+
+      if(vmaxvq_u8(hits) != 0) {
+        for(std::size_t lane = 0; lane < 16; ++lane) {
+          if(getSignatureKind(buffer + index + lane) != SignatureKind::None) {
+            return index + lane;
+          }
+        }
+      }
+    }
+#endif
+    for(; index + 4 <= length; ++index) {
+      if(getSignatureKind(buffer + index) != SignatureKind::None) {
+        return index;
+      }
+    }
+
+    return length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit little endian integer from a buffer</summary>
+  /// <param name="bytes">Buffer holding the integer</param>
+  /// <returns>The integer read from the buffer</returns>
+  std::uint32_t readUInt32LittleEndian(const std::byte *bytes) {
+    return (
+      (static_cast<std::uint32_t>(bytes[0])) |
+      (static_cast<std::uint32_t>(bytes[1]) << 8) |
+      (static_cast<std::uint32_t>(bytes[2]) << 16) |
+      (static_cast<std::uint32_t>(bytes[3]) << 24)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit big endian integer from a buffer</summary>
+  /// <param name="bytes">Buffer holding the integer</param>
+  /// <returns>The integer read from the buffer</returns>
+  std::uint32_t readUInt32BigEndian(const std::byte *bytes) {
+    return (
+      (static_cast<std::uint32_t>(bytes[0]) << 24) |
+      (static_cast<std::uint32_t>(bytes[1]) << 16) |
+      (static_cast<std::uint32_t>(bytes[2]) << 8) |
+      (static_cast<std::uint32_t>(bytes[3]))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a stream description, cutting it off at the end of the blob</summary>
+  /// <param name="start">Offset of the stream within the blob</param>
+  /// <param name="end">Offset one past the stream's last byte according to its framing</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <param name="format">Format of the stream</param>
+  /// <returns>The description of the stream</returns>
+  Nuclex::Audio::Storage::EmbeddedStream makeStream(
+    std::uint64_t start, std::uint64_t end, std::uint64_t blobLength,
+    Nuclex::Audio::Storage::EmbeddedStreamFormat format
+  ) {
+    bool isTruncated = (end > blobLength);
+    if(isTruncated) {
+      end = blobLength;
+    }
+
+    return Nuclex::Audio::Storage::EmbeddedStream { start, end - start, format, !isTruncated };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the extent of a RIFF file from its chunk size</summary>
+  /// <param name="header">Header bytes at the start of the Waveform file</param>
+  /// <param name="start">Offset of the Waveform file within the blob</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <returns>The description of the Waveform file</returns>
+  Nuclex::Audio::Storage::EmbeddedStream measureWaveform(
+    const std::byte *header, std::uint64_t start, std::uint64_t blobLength
+  ) {
+    std::uint64_t riffSize;
+    if(isFourCC(header, "RF64") || isFourCC(header, "BW64")) {
+      riffSize = ( // 64 bit RIFF size at the beginning of the 'ds64' chunk's data
+        static_cast<std::uint64_t>(readUInt32LittleEndian(header + 20)) |
+        (static_cast<std::uint64_t>(readUInt32LittleEndian(header + 24)) << 32)
+      );
+    } else if(isFourCC(header, "RIFX") || isFourCC(header, "FFIR")) {
+      riffSize = readUInt32BigEndian(header + 4);
+    } else {
+      riffSize = readUInt32LittleEndian(header + 4);
+    }
+
+    // Odd-sized chunks are padded, but writers don't always add the pad byte
+    // at the end of the file, so the RIFF size is taken as-is
+    return makeStream(
+      start, start + 8 + riffSize, blobLength,
+      Nuclex::Audio::Storage::EmbeddedStreamFormat::Waveform
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+  /// <summary>Determines where the metadata blocks of a FLAC stream end</summary>
+  /// <param name="blob">Blob containing the FLAC stream</param>
+  /// <param name="start">Offset of the FLAC stream within the blob</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <returns>The description of the FLAC stream's metadata</returns>
+  /// <remarks>
+  ///   FLAC doesn't store the length of its audio frames anywhere, so the length is only
+  ///   a preliminary one and extended to the next stream once the scan is complete.
+  /// </remarks>
+  Nuclex::Audio::Storage::EmbeddedStream measureFlac(
+    const Nuclex::Audio::Storage::VirtualFile &blob,
+    std::uint64_t start,
+    std::uint64_t blobLength
+  ) {
+    std::uint64_t position = start + 4;
+    for(;;) {
+      if(position + 4 > blobLength) {
+        position = blobLength;
+        break;
+      }
+
+      std::byte blockHeader[4];
+      blob.ReadAt(position, 4, blockHeader);
+      position += 4 + (readUInt32BigEndian(blockHeader) & 0x00FFFFFF);
+
+      bool isLastMetadataBlock = ((blockHeader[0] & std::byte(0x80)) != std::byte(0));
+      if(isLastMetadataBlock) {
+        break;
+      }
+    }
+
+    Nuclex::Audio::Storage::EmbeddedStream stream = makeStream(
+      start, position, blobLength, Nuclex::Audio::Storage::EmbeddedStreamFormat::Flac
+    );
+    stream.IsLengthExact = false;
+    return stream;
+  }
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+  /// <summary>Determines the extent of an Ogg file by walking its pages</summary>
+  /// <param name="blob">Blob containing the Ogg file</param>
+  /// <param name="start">Offset of the Ogg file within the blob</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <param name="format">Format of the first logical stream in the Ogg file</param>
+  /// <returns>The description of the Ogg file</returns>
+  Nuclex::Audio::Storage::EmbeddedStream measureOgg(
+    const Nuclex::Audio::Storage::VirtualFile &blob,
+    std::uint64_t start,
+    std::uint64_t blobLength,
+    Nuclex::Audio::Storage::EmbeddedStreamFormat format
+  ) {
+    std::byte pageHeader[27 + 255];
+    blob.ReadAt(start, 27, pageHeader);
+    std::uint32_t serialNumber = readUInt32LittleEndian(pageHeader + 14);
+
+    // Pages of other logical streams may be interleaved, so keep going until
+    // the page that ends our logical stream or until the pages stop
+    std::uint64_t position = start;
+    for(std::size_t pageIndex = 0; pageIndex < MaximumFrameCount; ++pageIndex) {
+      if(position + 27 > blobLength) {
+        break;
+      }
+      blob.ReadAt(position, 27, pageHeader);
+      if(!isFourCC(pageHeader, "OggS")) {
+        break;
+      }
+
+      std::size_t segmentCount = static_cast<std::size_t>(pageHeader[26]);
+      if(position + 27 + segmentCount > blobLength) {
+        return makeStream(start, blobLength + 1, blobLength, format);
+      }
+      blob.ReadAt(position + 27, segmentCount, pageHeader + 27);
+
+      std::uint64_t pageLength = 27 + segmentCount;
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        pageLength += static_cast<std::uint64_t>(pageHeader[27 + index]);
+      }
+      position += pageLength;
+
+      bool isEndOfStream = ((pageHeader[5] & std::byte(0x04)) != std::byte(0));
+      if(isEndOfStream && (readUInt32LittleEndian(pageHeader + 14) == serialNumber)) {
+        return makeStream(start, position, blobLength, format);
+      }
+    }
+
+    // The pages stopped without an end-of-stream page, so the file was cut off
+    Nuclex::Audio::Storage::EmbeddedStream stream = makeStream(
+      start, position, blobLength, format
+    );
+    stream.IsLengthExact = false;
+    return stream;
+  }
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+  /// <summary>Determines the extent of a WavPack file by walking its blocks</summary>
+  /// <param name="blob">Blob containing the WavPack file</param>
+  /// <param name="start">Offset of the WavPack file within the blob</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <returns>The description of the WavPack file</returns>
+  Nuclex::Audio::Storage::EmbeddedStream measureWavPack(
+    const Nuclex::Audio::Storage::VirtualFile &blob,
+    std::uint64_t start,
+    std::uint64_t blobLength
+  ) {
+    std::uint64_t position = start;
+    std::uint32_t previousBlockIndex = 0;
+    for(std::size_t blockIndex = 0; blockIndex < MaximumFrameCount; ++blockIndex) {
+      if(position + 20 > blobLength) {
+        break;
+      }
+
+      std::byte blockHeader[20];
+      blob.ReadAt(position, 20, blockHeader);
+      if(!isFourCC(blockHeader, "wvpk")) {
+        break;
+      }
+
+      // A block that starts counting samples from zero again after the sample index
+      // has already advanced is the first block of another WavPack file
+      std::uint32_t sampleIndex = readUInt32LittleEndian(blockHeader + 16);
+      if((sampleIndex == 0) && (previousBlockIndex != 0)) {
+        break;
+      }
+      previousBlockIndex = sampleIndex;
+
+      position += 8 + static_cast<std::uint64_t>(readUInt32LittleEndian(blockHeader + 4));
+    }
+
+    return makeStream(
+      start, position, blobLength, Nuclex::Audio::Storage::EmbeddedStreamFormat::WavPack
+    );
+  }
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a signature found in the blob starts a valid audio file</summary>
+  /// <param name="blob">Blob in which the signature was found</param>
+  /// <param name="start">Offset of the signature within the blob</param>
+  /// <param name="blobLength">Total length of the blob in bytes</param>
+  /// <returns>The audio file starting at the signature or nothing if it isn't valid</returns>
+  std::optional<Nuclex::Audio::Storage::EmbeddedStream> tryIdentifyStream(
+    const Nuclex::Audio::Storage::VirtualFile &blob,
+    std::uint64_t start,
+    std::uint64_t blobLength
+  ) {
+    using Nuclex::Audio::Storage::EmbeddedStreamFormat;
+    namespace Storage = Nuclex::Audio::Storage;
+
+    std::byte header[HeaderCheckLength];
+    std::size_t headerLength = static_cast<std::size_t>(
+      std::min<std::uint64_t>(HeaderCheckLength, blobLength - start)
+    );
+    blob.ReadAt(start, headerLength, header);
+
+    switch(getSignatureKind(header)) {
+      case SignatureKind::Riff: {
+        if(Storage::Waveform::Detection::CheckIfWaveformHeaderPresent(header, headerLength)) {
+          return measureWaveform(header, start, blobLength);
+        }
+        break;
+      }
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+      case SignatureKind::Flac: {
+        if(Storage::Flac::Detection::CheckIfFlacHeaderPresent(header, headerLength)) {
+          return measureFlac(blob, start, blobLength);
+        }
+        break;
+      }
+#endif
+      case SignatureKind::Ogg: {
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+        if(Storage::Opus::Detection::CheckIfOpusHeaderPresentLite(header, headerLength)) {
+          return measureOgg(blob, start, blobLength, EmbeddedStreamFormat::Opus);
+        }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+        if(Storage::Vorbis::Detection::CheckIfVorbisHeaderPresentLite(header, headerLength)) {
+          return measureOgg(blob, start, blobLength, EmbeddedStreamFormat::Vorbis);
+        }
+#endif
+        break;
+      }
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+      case SignatureKind::WavPack: {
+        if(Storage::WavPack::Detection::CheckIfWavPackHeaderPresent(header, headerLength)) {
+          return measureWavPack(blob, start, blobLength);
+        }
+        break;
+      }
+#endif
+      default: {
+        break;
+      }
+    }
+
+    return std::optional<Nuclex::Audio::Storage::EmbeddedStream>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<EmbeddedStream> EmbeddedStreamScanner::Scan(
+    const VirtualFile &blob,
+    const std::shared_ptr<const CancellationToken> &cancellationToken /* = {} */
+  ) {
+    std::vector<EmbeddedStream> streams;
+
+    std::uint64_t blobLength = blob.GetSize();
+    std::vector<std::byte> window(
+      static_cast<std::size_t>(std::min<std::uint64_t>(WindowSize, blobLength))
+    );
+
+    std::uint64_t windowStart = 0;
+    while(windowStart + 4 <= blobLength) {
+      if(static_cast<bool>(cancellationToken)) {
+        cancellationToken->ThrowIfCancellationRequested();
+      }
+
+      std::size_t windowLength = static_cast<std::size_t>(
+        std::min<std::uint64_t>(WindowSize, blobLength - windowStart)
+      );
+      blob.ReadAt(windowStart, windowLength, window.data());
+
+      // Look at each signature in the window. When a valid audio file is found,
+      // skip over it so its contents aren't mistaken for more audio files.
+      std::uint64_t nextWindowStart = windowStart + windowLength - 3;
+      std::size_t index = 0;
+      for(;;) {
+        index = findNextSignature(window.data(), index, windowLength);
+        if(index >= windowLength) {
+          break;
+        }
+
+        std::optional<EmbeddedStream> stream = tryIdentifyStream(
+          blob, windowStart + index, blobLength
+        );
+        if(!stream.has_value()) {
+          ++index;
+          continue;
+        }
+
+        streams.push_back(stream.value());
+
+        std::uint64_t streamEnd = stream->Start + stream->Length;
+        if(streamEnd >= windowStart + windowLength) {
+          nextWindowStart = streamEnd;
+          break;
+        }
+        index = static_cast<std::size_t>(streamEnd - windowStart);
+      }
+
+      if(windowStart + windowLength >= blobLength) {
+        break; // The last window either ended with the blob or skipped past it
+      }
+      windowStart = nextWindowStart;
+    }
+
+    // FLAC streams are assumed to go on until the next audio file or the end of the blob
+    for(std::size_t index = 0; index < streams.size(); ++index) {
+      if(streams[index].Format == EmbeddedStreamFormat::Flac) {
+        std::uint64_t end = blobLength;
+        if(index + 1 < streams.size()) {
+          end = streams[index + 1].Start;
+        }
+        streams[index].Length = end - streams[index].Start;
+      }
+    }
+
+    return streams;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
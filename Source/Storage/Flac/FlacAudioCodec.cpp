@@ -26,12 +26,15 @@ limitations under the License.
 
 #include <stdexcept>
 
+#include "Nuclex/Audio/AllocationScope.h"
+
 #include <Nuclex/Support/Text/UnicodeHelper.h>
 #include <Nuclex/Support/Text/StringHelper.h>
 
 #include "./FlacVirtualFileAdapter.h"
 #include "./FlacDetection.h"
 #include "./FlacTrackDecoder.h"
+#include "./FlacTrackEncoderBuilder.h"
 #include "./FlacReader.h"
 #include "../../Platform/FlacApi.h"
 
@@ -64,6 +67,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool FlacAudioCodec::IsSignaturePresent(const std::byte *header, std::size_t byteCount) const {
+    return Detection::CheckIfFlacHeaderPresent(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> FlacAudioCodec::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &source,
     const std::string &extensionHint /* = std::string() */
@@ -76,8 +85,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       return std::optional<ContainerInfo>();
     }
 
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
     FlacReader reader(source);
 
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
     ContainerInfo containerInfo;
     containerInfo.DefaultTrackIndex = 0;
 
@@ -109,11 +120,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       );
     }
 
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
     return std::make_shared<FlacTrackDecoder>(source);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::shared_ptr<AudioTrackEncoderBuilder> FlacAudioCodec::ProvideBuilder() const {
+    return std::make_shared<FlacTrackEncoderBuilder>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Flac
 
 #endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
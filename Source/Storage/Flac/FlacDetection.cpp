@@ -77,6 +77,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     std::byte fileHeader[16];
     source.ReadAt(0, 16, fileHeader);
 
+    return CheckIfFlacHeaderPresent(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfFlacHeaderPresent(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 16) {
+      return false; // Not enough header bytes to check for a valid FLAC header
+    }
+
     // FLAC specification:
     //   "At the start of a FLAC file or stream, following the fLaC ASCII file signature,
     //   one or more metadata blocks MUST be present before any audio frames appear.
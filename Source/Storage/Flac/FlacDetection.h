@@ -26,7 +26,7 @@ limitations under the License.
 
 #include <string> // for std::string
 #include <memory> // for std::unique_ptr
-#include <cstddef> // for std::size_t
+#include <cstddef> // for std::size_t, std::byte
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -64,6 +64,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     /// <returns>True if a valid FLAC header was found, false otherwise</returns>
     public: static bool CheckIfFlacHeaderPresent(const VirtualFile &source);
 
+    /// <summary>Checks if the file header starts with a valid FLAC header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid FLAC header was found, false otherwise</returns>
+    public: static bool CheckIfFlacHeaderPresent(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
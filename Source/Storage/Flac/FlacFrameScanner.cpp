@@ -0,0 +1,820 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacFrameScanner.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../EndianReader.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcmp()
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Longest possible FLAC frame header, including its CRC-8</summary>
+  const std::size_t MaximumFrameHeaderLength = 16;
+
+  /// <summary>Number of bytes read from the file at once when scanning frames</summary>
+  const std::size_t ScanChunkSize = 65536;
+
+  /// <summary>Size of the range below which bisection switches to walking frames</summary>
+  const std::uint64_t BisectionCutoff = 262144;
+
+  /// <summary>Length of an ID3v1 tag some taggers append to FLAC files</summary>
+  const std::uint64_t Id3v1TagLength = 128;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lookup tables for the CRC-8 and CRC-16 used by FLAC frames</summary>
+  struct FrameCrcTables {
+
+    /// <summary>CRC-8 (polynomial 0x07) of each possible byte value</summary>
+    public: std::uint8_t Crc8[256];
+    /// <summary>CRC-16 (polynomial 0x8005) of each possible byte value</summary>
+    public: std::uint16_t Crc16[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the lookup tables for the FLAC frame checksums</summary>
+  /// <returns>The lookup tables for the FLAC frame checksums</returns>
+  constexpr FrameCrcTables makeFrameCrcTables() {
+    FrameCrcTables tables = {};
+    for(std::uint32_t index = 0; index < 256; ++index) {
+      std::uint32_t crc8 = index;
+      std::uint32_t crc16 = index << 8;
+      for(unsigned bit = 0; bit < 8; ++bit) {
+        crc8 = ((crc8 << 1) ^ (((crc8 & 0x80U) != 0) ? 0x07U : 0U)) & 0xFFU;
+        crc16 = ((crc16 << 1) ^ (((crc16 & 0x8000U) != 0) ? 0x8005U : 0U)) & 0xFFFFU;
+      }
+      tables.Crc8[index] = static_cast<std::uint8_t>(crc8);
+      tables.Crc16[index] = static_cast<std::uint16_t>(crc16);
+    }
+    return tables;
+  }
+
+  /// <summary>Lookup tables for the FLAC frame checksums</summary>
+  constexpr FrameCrcTables frameCrcTables = makeFrameCrcTables();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the CRC-8 of a FLAC frame header</summary>
+  /// <param name="data">Bytes of the frame header up to its CRC-8</param>
+  /// <param name="length">Number of bytes to calculate the CRC-8 for</param>
+  /// <returns>The CRC-8 of the specified bytes</returns>
+  std::uint8_t calculateCrc8(const std::byte *data, std::size_t length) {
+    std::uint8_t crc = 0;
+    for(std::size_t index = 0; index < length; ++index) {
+      crc = frameCrcTables.Crc8[crc ^ static_cast<std::uint8_t>(data[index])];
+    }
+    return crc;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a byte to a running CRC-16 of a FLAC frame</summary>
+  /// <param name="crc">CRC-16 of the bytes before the new one</param>
+  /// <param name="value">Byte that will be added to the CRC-16</param>
+  /// <returns>The CRC-16 including the new byte</returns>
+  inline std::uint16_t updateCrc16(std::uint16_t crc, std::byte value) {
+    return static_cast<std::uint16_t>(
+      (crc << 8) ^ frameCrcTables.Crc16[(crc >> 8) ^ static_cast<std::uint8_t>(value)]
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the CRC-16 of a range of bytes in a FLAC frame</summary>
+  /// <param name="data">Bytes the CRC-16 will be calculated for</param>
+  /// <param name="length">Number of bytes to calculate the CRC-16 for</param>
+  /// <returns>The CRC-16 of the specified bytes</returns>
+  std::uint16_t calculateCrc16(const std::byte *data, std::size_t length) {
+    std::uint16_t crc = 0;
+    for(std::size_t index = 0; index < length; ++index) {
+      crc = updateCrc16(crc, data[index]);
+    }
+    return crc;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a number in FLAC's extended UTF-8 coding to a buffer</summary>
+  /// <param name="value">Number that will be appended, up to 36 bits</param>
+  /// <param name="target">Buffer the coded number will be appended to</param>
+  void appendUtf8Number(std::uint64_t value, std::vector<std::byte> &target) {
+    if(value < 0x80) {
+      target.push_back(static_cast<std::byte>(value));
+      return;
+    }
+
+    std::size_t byteCount;
+    std::uint8_t prefix;
+    if(value < 0x800) {
+      byteCount = 2;
+      prefix = 0xC0;
+    } else if(value < 0x10000) {
+      byteCount = 3;
+      prefix = 0xE0;
+    } else if(value < 0x200000) {
+      byteCount = 4;
+      prefix = 0xF0;
+    } else if(value < 0x4000000) {
+      byteCount = 5;
+      prefix = 0xF8;
+    } else if(value < 0x80000000) {
+      byteCount = 6;
+      prefix = 0xFC;
+    } else {
+      byteCount = 7;
+      prefix = 0xFE;
+    }
+
+    target.push_back(static_cast<std::byte>(prefix | (value >> (6 * (byteCount - 1)))));
+    for(std::size_t index = byteCount - 1; index > 0; --index) {
+      target.push_back(static_cast<std::byte>(0x80 | ((value >> (6 * (index - 1))) & 0x3F)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the big endian bit fields of the subframes in a FLAC frame</summary>
+  class SubframeBitReader {
+
+    /// <summary>Initializes a new bit reader for the subframes of a FLAC frame</summary>
+    /// <param name="data">Bytes of the FLAC frame</param>
+    /// <param name="length">Number of bytes up to the frame's CRC-16</param>
+    /// <param name="start">Offset of the first subframe, behind the frame header</param>
+    public: SubframeBitReader(const std::byte *data, std::size_t length, std::size_t start) :
+      data(reinterpret_cast<const std::uint8_t *>(data)),
+      bitCount(length * 8),
+      bitPosition(start * 8) {}
+
+    /// <summary>Reads an unsigned bit field</summary>
+    /// <param name="count">Number of bits in the field, up to 64</param>
+    /// <param name="value">Receives the value of the field</param>
+    /// <returns>True if the field was read, false if the frame ended before it</returns>
+    public: bool TryRead(std::size_t count, std::uint64_t &value) {
+      if(this->bitPosition + count > this->bitCount) {
+        return false;
+      }
+
+      value = 0;
+      while(count > 0) {
+        std::size_t availableBitCount = 8 - (this->bitPosition % 8);
+        std::size_t takenBitCount = std::min(availableBitCount, count);
+        std::uint32_t bits = (
+          (this->data[this->bitPosition / 8] >> (availableBitCount - takenBitCount)) &
+          ((1U << takenBitCount) - 1)
+        );
+        value = (value << takenBitCount) | bits;
+
+        this->bitPosition += takenBitCount;
+        count -= takenBitCount;
+      }
+
+      return true;
+    }
+
+    /// <summary>Reads a signed, two's complement bit field</summary>
+    /// <param name="count">Number of bits in the field, up to 63</param>
+    /// <param name="value">Receives the value of the field</param>
+    /// <returns>True if the field was read, false if the frame ended before it</returns>
+    public: bool TryReadSigned(std::size_t count, std::int64_t &value) {
+      std::uint64_t bits;
+      if(!TryRead(count, bits)) {
+        return false;
+      }
+
+      value = static_cast<std::int64_t>(bits);
+      if((count > 0) && ((bits >> (count - 1)) != 0)) {
+        value -= static_cast<std::int64_t>(std::uint64_t(1) << count);
+      }
+
+      return true;
+    }
+
+    /// <summary>Reads a unary coded number (zero bits terminated by a one bit)</summary>
+    /// <param name="limit">Largest number that can be valid at this point</param>
+    /// <param name="value">Receives the number of zero bits</param>
+    /// <returns>True if the number was read, false if it was invalid</returns>
+    public: bool TryReadUnary(std::size_t limit, std::size_t &value) {
+      value = 0;
+      for(;;) {
+        std::uint64_t bit;
+        if(!TryRead(1, bit)) {
+          return false;
+        }
+        if(bit != 0) {
+          return true;
+        }
+        if(value == limit) {
+          return false;
+        }
+        ++value;
+      }
+    }
+
+    /// <summary>Bytes of the FLAC frame</summary>
+    private: const std::uint8_t *data;
+    /// <summary>Number of bits that can be read</summary>
+    private: std::size_t bitCount;
+    /// <summary>Index of the next bit that will be read</summary>
+    private: std::size_t bitPosition;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Skips an ID3v2 tag some taggers put in front of FLAC files</summary>
+  /// <param name="file">File that may begin with an ID3v2 tag</param>
+  /// <returns>The offset at which the FLAC stream begins</returns>
+  std::uint64_t skipId3v2Tag(const Nuclex::Audio::Storage::VirtualFile &file) {
+    if(file.GetSize() < 10) {
+      return 0;
+    }
+
+    std::byte header[10];
+    file.ReadAt(0, 10, header);
+    if(std::memcmp(header, "ID3", 3) != 0) {
+      return 0;
+    }
+
+    // The tag size is stored as a 28 bit integer spread over 4 bytes of 7 bits each
+    std::uint64_t tagSize = 0;
+    for(std::size_t index = 6; index < 10; ++index) {
+      tagSize = (tagSize << 7) | (static_cast<std::uint8_t>(header[index]) & 0x7F);
+    }
+    tagSize += 10; // header
+    if((static_cast<std::uint8_t>(header[5]) & 0x10) != 0) {
+      tagSize += 10; // footer present
+    }
+
+    return tagSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacFrameScanner::FlacFrameScanner(const VirtualFile &file) :
+    file(file),
+    metadataBlocks(),
+    firstFrameOffset(0),
+    channelCount(0),
+    bitsPerSample(0),
+    sampleRate(0),
+    nominalBlockSize(0),
+    totalSampleCount(0),
+    isVariableBlockSize(false) {
+    std::uint64_t fileSize = file.GetSize();
+    std::uint64_t offset = skipId3v2Tag(file);
+
+    std::byte header[4];
+    if(offset + 4 > fileSize) {
+      throw Errors::CorruptedFileError(u8"File is too short to be a FLAC file");
+    }
+    file.ReadAt(offset, 4, header);
+    if(std::memcmp(header, "fLaC", 4) != 0) {
+      throw Errors::CorruptedFileError(u8"File is not a FLAC file");
+    }
+    offset += 4;
+
+    // Collect the metadata blocks up to the one flagged as the last
+    for(;;) {
+      if(offset + 4 > fileSize) {
+        throw Errors::CorruptedFileError(u8"FLAC file ends in the middle of its metadata");
+      }
+      file.ReadAt(offset, 4, header);
+
+      bool isLastBlock = ((static_cast<std::uint8_t>(header[0]) & 0x80) != 0);
+      std::size_t blockLength = static_cast<std::size_t>(
+        (static_cast<std::uint32_t>(header[1]) << 16) |
+        (static_cast<std::uint32_t>(header[2]) << 8) |
+        static_cast<std::uint32_t>(header[3])
+      );
+      if(offset + 4 + blockLength > fileSize) {
+        throw Errors::CorruptedFileError(u8"FLAC file ends in the middle of its metadata");
+      }
+
+      MetadataBlock &block = this->metadataBlocks.emplace_back();
+      block.Type = static_cast<std::uint8_t>(header[0]) & 0x7F;
+      block.Data.resize(blockLength);
+      if(blockLength > 0) {
+        file.ReadAt(offset + 4, blockLength, block.Data.data());
+      }
+
+      offset += 4 + blockLength;
+      if(isLastBlock) {
+        break;
+      }
+    }
+    this->firstFrameOffset = offset;
+
+    // STREAMINFO is a sequence of big endian bit fields: block sizes (16 + 16 bits),
+    // frame sizes (24 + 24 bits), sample rate (20 bits), channels - 1 (3 bits),
+    // bits per sample - 1 (5 bits), total samples (36 bits) and the MD5 sum
+    const MetadataBlock &streamInfo = this->metadataBlocks.front();
+    if((streamInfo.Type != 0) || (streamInfo.Data.size() < 34)) {
+      throw Errors::CorruptedFileError(u8"FLAC file doesn't begin with a STREAMINFO block");
+    }
+    const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(streamInfo.Data.data());
+    this->nominalBlockSize = (static_cast<std::size_t>(bytes[2]) << 8) | bytes[3];
+    this->sampleRate = (
+      (static_cast<std::size_t>(bytes[10]) << 12) |
+      (static_cast<std::size_t>(bytes[11]) << 4) |
+      (static_cast<std::size_t>(bytes[12]) >> 4)
+    );
+    this->channelCount = ((bytes[12] >> 1) & 0x07) + 1;
+    this->bitsPerSample = (((bytes[12] & 0x01) << 4) | (bytes[13] >> 4)) + 1;
+    this->totalSampleCount = (
+      (static_cast<std::uint64_t>(bytes[13] & 0x0F) << 32) |
+      BigEndianReader::ReadUInt32(streamInfo.Data.data() + 14)
+    );
+
+    // Whether frames are numbered by frame or by sample is decided by the encoder
+    // for the whole stream, so the first frame tells it for all of them
+    std::size_t headerLength = static_cast<std::size_t>(
+      std::min<std::uint64_t>(fileSize - offset, MaximumFrameHeaderLength)
+    );
+    if(headerLength > 0) {
+      std::byte frameHeaderBytes[MaximumFrameHeaderLength];
+      file.ReadAt(offset, headerLength, frameHeaderBytes);
+
+      FrameHeader frameHeader;
+      if(tryParseHeader(frameHeaderBytes, headerLength, frameHeader)) {
+        this->isVariableBlockSize = frameHeader.IsVariableBlockSize;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacFrameScanner::TryReadFrame(
+    std::uint64_t offset, Frame &frame, std::vector<std::byte> *data /* = nullptr */
+  ) const {
+    std::uint64_t fileSize = this->file.GetSize();
+    if(offset >= fileSize) {
+      return false;
+    }
+
+    std::vector<std::byte> localBuffer;
+    std::vector<std::byte> &buffer = (data != nullptr) ? *data : localBuffer;
+    buffer.clear();
+
+    // Reads more of the file into the buffer until it holds the requested number
+    // of bytes or the end of the file is reached
+    auto ensureAvailable = [&](std::size_t byteCount) {
+      std::uint64_t bufferEnd = offset + buffer.size();
+      if((buffer.size() < byteCount) && (bufferEnd < fileSize)) {
+        std::size_t chunkSize = static_cast<std::size_t>(
+          std::min<std::uint64_t>(fileSize - bufferEnd, ScanChunkSize)
+        );
+        std::size_t previousSize = buffer.size();
+        buffer.resize(previousSize + chunkSize);
+        this->file.ReadAt(bufferEnd, chunkSize, buffer.data() + previousSize);
+      }
+    };
+
+    ensureAvailable(MaximumFrameHeaderLength);
+
+    FrameHeader header;
+    if(!tryParseStreamHeader(buffer.data(), buffer.size(), header)) {
+      return false;
+    }
+
+    // Walk over the frame's bytes until the CRC-16 of everything so far matches
+    // the next two bytes and these are followed by the next frame or the end of the file
+    std::uint16_t crc = calculateCrc16(buffer.data(), header.Length);
+    std::size_t position = header.Length;
+    for(;;) {
+      ensureAvailable(position + 2 + MaximumFrameHeaderLength);
+      if(position + 2 > buffer.size()) {
+        return false; // Truncated frame
+      }
+
+      std::uint16_t storedCrc = BigEndianReader::ReadUInt16(buffer.data() + position);
+      if(storedCrc == crc) {
+        std::size_t frameLength = position + 2;
+        std::uint64_t frameEnd = offset + frameLength;
+
+        bool isFrameEnd = (frameEnd == fileSize);
+        if(!isFrameEnd) {
+          FrameHeader nextHeader;
+          isFrameEnd = tryParseStreamHeader(
+            buffer.data() + frameLength, buffer.size() - frameLength, nextHeader
+          );
+        }
+        if(!isFrameEnd && (fileSize - frameEnd == Id3v1TagLength)) {
+          std::byte tag[3];
+          this->file.ReadAt(frameEnd, 3, tag);
+          isFrameEnd = (std::memcmp(tag, "TAG", 3) == 0);
+        }
+
+        if(isFrameEnd) {
+          frame.Offset = offset;
+          frame.Length = frameLength;
+          frame.SampleCount = header.SampleCount;
+          if(header.IsVariableBlockSize) {
+            frame.FirstSample = header.Number;
+          } else {
+            frame.FirstSample = header.Number * this->nominalBlockSize;
+          }
+
+          buffer.resize(frameLength);
+          return true;
+        }
+      }
+
+      crc = updateCrc16(crc, buffer[position]);
+      ++position;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacFrameScanner::Frame FlacFrameScanner::FindFrame(std::uint64_t sampleIndex) const {
+    if((this->totalSampleCount != 0) && (sampleIndex >= this->totalSampleCount)) {
+      throw std::out_of_range(u8"Sample index lies beyond the end of the FLAC stream");
+    }
+
+    Frame frame;
+    if(!TryReadFrame(this->firstFrameOffset, frame)) {
+      throw std::out_of_range(u8"FLAC file contains no frames");
+    }
+
+    // Narrow down the range in which the frame lies by looking at frame headers
+    // in the middle of it. The lower end always stays on a frame before the sample.
+    if(sampleIndex >= frame.FirstSample + frame.SampleCount) {
+      std::uint64_t low = frame.Offset;
+      std::uint64_t high = this->file.GetSize();
+      while(high - low > BisectionCutoff) {
+        std::uint64_t middle = low + (high - low) / 2;
+
+        Frame candidate;
+        bool isBeforeSample = (
+          tryFindFrameAfter(middle, high, candidate) &&
+          (candidate.FirstSample <= sampleIndex)
+        );
+        if(isBeforeSample) {
+          low = candidate.Offset;
+          frame = candidate;
+        } else {
+          high = middle;
+        }
+      }
+    }
+
+    // Walk the remaining frames up to the one holding the sample
+    while(sampleIndex >= frame.FirstSample + frame.SampleCount) {
+      if(!TryReadFrame(frame.Offset + frame.Length, frame)) {
+        throw std::out_of_range(u8"Sample index lies beyond the end of the FLAC stream");
+      }
+    }
+
+    return frame;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockContent FlacFrameScanner::DescribeFrame(
+    const Frame &frame, const std::vector<std::byte> &data
+  ) const {
+    BlockContent content = { frame.FirstSample, frame.SampleCount, false, false, false };
+
+    FrameHeader header;
+    if(!tryParseHeader(data.data(), data.size(), header) || (data.size() < header.Length + 2)) {
+      return content;
+    }
+
+    std::size_t bitsPerSample = header.BitsPerSample;
+    if(bitsPerSample == 0) {
+      bitsPerSample = this->bitsPerSample;
+    }
+
+    // Stereo frames can store a side channel (left minus right) with one extra bit.
+    // Both channels are zero exactly when both decorrelated channels are zero, so
+    // silence can be judged from the stored values without undoing the decorrelation.
+    std::uint8_t channelAssignment = static_cast<std::uint8_t>(data[3]) >> 4;
+    std::size_t sideChannelIndex = header.ChannelCount;
+    if(channelAssignment == 9) {
+      sideChannelIndex = 0; // side/right
+    } else if(channelAssignment > 7) {
+      sideChannelIndex = 1; // left/side or mid/side
+    }
+
+    SubframeBitReader reader(data.data(), data.size() - 2, header.Length);
+    bool isSilent = true;
+    for(std::size_t channelIndex = 0; channelIndex < header.ChannelCount; ++channelIndex) {
+      std::size_t channelBitCount = bitsPerSample;
+      if(channelIndex == sideChannelIndex) {
+        ++channelBitCount;
+      }
+
+      // Subframe header: zero bit, 6 bit type and the wasted bits flag. Wasted bits
+      // only shift the stored values, so they don't change whether these are constant.
+      std::uint64_t subframeHeader;
+      if(!reader.TryRead(8, subframeHeader) || ((subframeHeader & 0x80) != 0)) {
+        return content;
+      }
+      if((subframeHeader & 0x01) != 0) {
+        std::size_t wastedBitCount;
+        if(!reader.TryReadUnary(channelBitCount - 2, wastedBitCount)) {
+          return content;
+        }
+        channelBitCount -= wastedBitCount + 1;
+      }
+
+      std::uint64_t subframeType = (subframeHeader >> 1) & 0x3F;
+      std::int64_t value;
+      if(subframeType == 0) { // CONSTANT
+        if(!reader.TryReadSigned(channelBitCount, value)) {
+          return content;
+        }
+      } else if(subframeType == 1) { // VERBATIM
+        if(!reader.TryReadSigned(channelBitCount, value)) {
+          return content;
+        }
+        for(std::size_t index = 1; index < frame.SampleCount; ++index) {
+          std::int64_t sample;
+          if(!reader.TryReadSigned(channelBitCount, sample)) {
+            return content;
+          }
+          if(sample != value) {
+            content.IsKnown = true;
+            return content;
+          }
+        }
+      } else { // FIXED or LPC, which would have to be decoded
+        content.IsKnown = true;
+        return content;
+      }
+
+      if(value != 0) {
+        isSilent = false;
+      }
+    }
+
+    content.IsKnown = true;
+    content.IsConstant = true;
+    content.IsSilent = isSilent;
+    return content;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacFrameScanner::RenumberFrame(
+    const std::byte *frame, std::size_t length, std::uint64_t firstSample,
+    std::vector<std::byte> &result
+  ) {
+    FrameHeader header;
+    if(!tryParseHeader(frame, length, header) || (length < header.Length + 2)) {
+      throw Errors::CorruptedFileError(u8"FLAC frame has an invalid header");
+    }
+
+    result.clear();
+    result.reserve(length + MaximumFrameHeaderLength);
+
+    // Sync code with the variable blocksize bit set, followed by the unchanged
+    // block size, sample rate, channel assignment and sample size fields
+    result.push_back(std::byte(0xFF));
+    result.push_back(std::byte(0xF9));
+    result.push_back(frame[2]);
+    result.push_back(frame[3]);
+    appendUtf8Number(firstSample, result);
+
+    // Explicit block size and sample rate fields that follow the number
+    std::size_t tailStart = 4 + header.NumberLength;
+    result.insert(result.end(), frame + tailStart, frame + header.Length - 1);
+    result.push_back(static_cast<std::byte>(calculateCrc8(result.data(), result.size())));
+
+    // The subframes remain as they are, only the CRC-16 needs to cover the new header
+    result.insert(result.end(), frame + header.Length, frame + length - 2);
+    std::uint16_t crc = calculateCrc16(result.data(), result.size());
+    result.push_back(static_cast<std::byte>(crc >> 8));
+    result.push_back(static_cast<std::byte>(crc & 0xFF));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacFrameScanner::tryParseHeader(
+    const std::byte *data, std::size_t availableByteCount, FrameHeader &header
+  ) {
+    if(availableByteCount < 6) {
+      return false;
+    }
+
+    const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    if((bytes[0] != 0xFF) || ((bytes[1] & 0xFE) != 0xF8)) {
+      return false; // No sync code
+    }
+
+    std::uint8_t blockSizeCode = bytes[2] >> 4;
+    std::uint8_t sampleRateCode = bytes[2] & 0x0F;
+    std::uint8_t channelAssignment = bytes[3] >> 4;
+    std::uint8_t sampleSizeCode = (bytes[3] >> 1) & 0x07;
+    if((blockSizeCode == 0) || (sampleRateCode == 15) || (channelAssignment > 10)) {
+      return false; // Reserved or invalid values
+    }
+    if((sampleSizeCode == 3) || ((bytes[3] & 0x01) != 0)) {
+      return false; // Reserved values
+    }
+
+    header.IsVariableBlockSize = ((bytes[1] & 0x01) != 0);
+    header.ChannelCount = (channelAssignment < 8) ? (channelAssignment + 1) : 2;
+
+    static const std::size_t sampleSizes[] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+    header.BitsPerSample = sampleSizes[sampleSizeCode];
+
+    // Frame or sample number, coded like UTF-8 but extended to 36 bits
+    std::size_t position = 4;
+    std::uint8_t leadByte = bytes[position];
+    std::size_t numberLength;
+    std::uint64_t number;
+    if(leadByte < 0x80) {
+      numberLength = 1;
+      number = leadByte;
+    } else if((leadByte & 0xE0) == 0xC0) {
+      numberLength = 2;
+      number = leadByte & 0x1F;
+    } else if((leadByte & 0xF0) == 0xE0) {
+      numberLength = 3;
+      number = leadByte & 0x0F;
+    } else if((leadByte & 0xF8) == 0xF0) {
+      numberLength = 4;
+      number = leadByte & 0x07;
+    } else if((leadByte & 0xFC) == 0xF8) {
+      numberLength = 5;
+      number = leadByte & 0x03;
+    } else if((leadByte & 0xFE) == 0xFC) {
+      numberLength = 6;
+      number = leadByte & 0x01;
+    } else if(leadByte == 0xFE) {
+      numberLength = 7;
+      number = 0;
+    } else {
+      return false;
+    }
+    if(!header.IsVariableBlockSize && (numberLength > 6)) {
+      return false; // Frame numbers are limited to 31 bits
+    }
+    if(position + numberLength > availableByteCount) {
+      return false;
+    }
+    for(std::size_t index = 1; index < numberLength; ++index) {
+      std::uint8_t continuation = bytes[position + index];
+      if((continuation & 0xC0) != 0x80) {
+        return false;
+      }
+      number = (number << 6) | (continuation & 0x3F);
+    }
+    header.Number = number;
+    header.NumberLength = numberLength;
+    position += numberLength;
+
+    // Block size, either from a table or stored behind the number
+    if(blockSizeCode == 1) {
+      header.SampleCount = 192;
+    } else if(blockSizeCode < 6) {
+      header.SampleCount = std::size_t(576) << (blockSizeCode - 2);
+    } else if(blockSizeCode == 6) {
+      if(position + 1 > availableByteCount) {
+        return false;
+      }
+      header.SampleCount = std::size_t(bytes[position]) + 1;
+      position += 1;
+    } else if(blockSizeCode == 7) {
+      if(position + 2 > availableByteCount) {
+        return false;
+      }
+      header.SampleCount = BigEndianReader::ReadUInt16(data + position) + std::size_t(1);
+      position += 2;
+    } else {
+      header.SampleCount = std::size_t(256) << (blockSizeCode - 8);
+    }
+
+    // Sample rate, either from a table or stored behind the block size
+    static const std::size_t sampleRates[] = {
+      0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000
+    };
+    if(sampleRateCode < 12) {
+      header.SampleRate = sampleRates[sampleRateCode];
+    } else if(sampleRateCode == 12) {
+      if(position + 1 > availableByteCount) {
+        return false;
+      }
+      header.SampleRate = std::size_t(bytes[position]) * 1000;
+      position += 1;
+    } else {
+      if(position + 2 > availableByteCount) {
+        return false;
+      }
+      header.SampleRate = BigEndianReader::ReadUInt16(data + position);
+      if(sampleRateCode == 14) {
+        header.SampleRate *= 10;
+      }
+      position += 2;
+    }
+
+    if(position + 1 > availableByteCount) {
+      return false;
+    }
+    if(calculateCrc8(data, position) != bytes[position]) {
+      return false;
+    }
+
+    header.Length = position + 1;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacFrameScanner::tryParseStreamHeader(
+    const std::byte *data, std::size_t availableByteCount, FrameHeader &header
+  ) const {
+    if(!tryParseHeader(data, availableByteCount, header)) {
+      return false;
+    }
+
+    return (
+      (header.IsVariableBlockSize == this->isVariableBlockSize) &&
+      (header.ChannelCount == this->channelCount) &&
+      ((header.BitsPerSample == 0) || (header.BitsPerSample == this->bitsPerSample)) &&
+      ((header.SampleRate == 0) || (header.SampleRate == this->sampleRate))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacFrameScanner::tryFindFrameAfter(
+    std::uint64_t offset, std::uint64_t limit, Frame &frame
+  ) const {
+    limit = std::min(limit, this->file.GetSize());
+
+    std::vector<std::byte> buffer;
+    while(offset < limit) {
+      std::size_t chunkSize = static_cast<std::size_t>(
+        std::min<std::uint64_t>(limit - offset, ScanChunkSize)
+      );
+      std::size_t readSize = static_cast<std::size_t>(
+        std::min<std::uint64_t>(
+          this->file.GetSize() - offset, chunkSize + MaximumFrameHeaderLength
+        )
+      );
+      buffer.resize(readSize);
+      this->file.ReadAt(offset, readSize, buffer.data());
+
+      for(std::size_t index = 0; index < chunkSize; ++index) {
+        if(static_cast<std::uint8_t>(buffer[index]) != 0xFF) {
+          continue;
+        }
+
+        FrameHeader header;
+        if(tryParseStreamHeader(buffer.data() + index, readSize - index, header)) {
+          if(TryReadFrame(offset + index, frame)) {
+            return true;
+          }
+        }
+      }
+
+      offset += chunkSize;
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
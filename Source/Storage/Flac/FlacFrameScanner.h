@@ -0,0 +1,242 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACFRAMESCANNER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACFRAMESCANNER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/BlockContent.h"
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates the frames in a FLAC file without decoding them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     FLAC frames don't store their length. A frame ends where the next frame's sync
+  ///     code appears and the CRC-16 of the bytes up to it matches the two bytes in front
+  ///     of it. This is the same method libflac uses when it bisects a file for seeking,
+  ///     but without decoding the subframes, so walking over frames is bound by I/O.
+  ///   </para>
+  ///   <para>
+  ///     Frames can also be renumbered, which is all that's needed to move a frame into
+  ///     a different stream, since every FLAC frame can be decoded on its own.
+  ///   </para>
+  /// </remarks>
+  class FlacFrameScanner {
+
+    /// <summary>Metadata block stored in front of the FLAC frames</summary>
+    public: struct MetadataBlock {
+
+      /// <summary>Type of the metadata block, 0 for STREAMINFO, 3 for SEEKTABLE</summary>
+      public: std::uint8_t Type;
+      /// <summary>Contents of the metadata block without its 4 byte header</summary>
+      public: std::vector<std::byte> Data;
+
+    };
+
+    /// <summary>Position and extent of a FLAC frame</summary>
+    public: struct Frame {
+
+      /// <summary>Offset of the frame's first byte in the file</summary>
+      public: std::uint64_t Offset;
+      /// <summary>Length of the frame in bytes, including its header and CRC-16</summary>
+      public: std::size_t Length;
+      /// <summary>Index of the first sample (in each channel) in the frame</summary>
+      public: std::uint64_t FirstSample;
+      /// <summary>Number of samples (in each channel) the frame decodes to</summary>
+      public: std::size_t SampleCount;
+
+    };
+
+    /// <summary>Initializes a new frame scanner and reads the file's metadata</summary>
+    /// <param name="file">FLAC file whose frames will be located</param>
+    public: FlacFrameScanner(const VirtualFile &file);
+
+    /// <summary>Returns the metadata blocks stored in front of the frames</summary>
+    /// <returns>All metadata blocks in the order they are stored</returns>
+    /// <remarks>
+    ///   The first block is always the STREAMINFO block.
+    /// </remarks>
+    public: const std::vector<MetadataBlock> &GetMetadataBlocks() const {
+      return this->metadataBlocks;
+    }
+
+    /// <summary>Returns the number of audio channels in the FLAC file</summary>
+    /// <returns>The number of audio channels</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of valid bits in each sample</summary>
+    /// <returns>The bits per sample as stated in the STREAMINFO block</returns>
+    public: std::size_t GetBitsPerSample() const { return this->bitsPerSample; }
+
+    /// <summary>Returns the sample rate of the FLAC file</summary>
+    /// <returns>The sample rate as stated in the STREAMINFO block</returns>
+    public: std::size_t GetSampleRate() const { return this->sampleRate; }
+
+    /// <summary>Returns the total number of samples (in each channel)</summary>
+    /// <returns>The total number of samples or 0 if the encoder didn't record it</returns>
+    public: std::uint64_t CountTotalSamples() const { return this->totalSampleCount; }
+
+    /// <summary>Returns the offset at which the first frame begins</summary>
+    /// <returns>The offset of the first frame in the file</returns>
+    public: std::uint64_t GetFirstFrameOffset() const { return this->firstFrameOffset; }
+
+    /// <summary>Reads the frame starting at the specified offset</summary>
+    /// <param name="offset">Offset at which the frame starts</param>
+    /// <param name="frame">Receives the position and extent of the frame</param>
+    /// <param name="data">Receives the frame's bytes if not null</param>
+    /// <returns>True if a valid frame was found, false if the frames have ended</returns>
+    public: bool TryReadFrame(
+      std::uint64_t offset, Frame &frame, std::vector<std::byte> *data = nullptr
+    ) const;
+
+    /// <summary>Locates the frame that holds the specified sample</summary>
+    /// <param name="sampleIndex">Index of the sample whose frame will be located</param>
+    /// <returns>The frame holding the specified sample</returns>
+    /// <remarks>
+    ///   Bisects the file by looking for frame headers, so finding a frame in a huge
+    ///   file only needs to read a few hundred kilobytes. Throws an std::out_of_range
+    ///   exception if the sample lies beyond the last frame.
+    /// </remarks>
+    public: Frame FindFrame(std::uint64_t sampleIndex) const;
+
+    /// <summary>Checks whether a frame's channels are constant or silent</summary>
+    /// <param name="frame">Position and extent of the frame</param>
+    /// <param name="data">Bytes of the frame as delivered by TryReadFrame()</param>
+    /// <returns>A description of the frame's contents</returns>
+    /// <remarks>
+    ///   Only the subframe headers are parsed. CONSTANT subframes store a single value
+    ///   and VERBATIM subframes store plain samples, so both can be checked without
+    ///   predicting anything. The first subframe of another type ends the check, since
+    ///   finding where it ends would mean decoding its residual.
+    /// </remarks>
+    public: BlockContent DescribeFrame(
+      const Frame &frame, const std::vector<std::byte> &data
+    ) const;
+
+    /// <summary>Rewrites a frame's header to begin at a different sample</summary>
+    /// <param name="frame">Complete frame, including its header and CRC-16</param>
+    /// <param name="length">Length of the frame in bytes</param>
+    /// <param name="firstSample">Sample number the frame will be labeled with</param>
+    /// <param name="result">Receives the renumbered frame</param>
+    /// <remarks>
+    ///   The frame is converted to the variable blocksize strategy, where frames are
+    ///   numbered by their first sample rather than by their ordinal. That allows frames
+    ///   of any size to follow each other, including the re-encoded partial frames at
+    ///   the edges of a cut.
+    /// </remarks>
+    public: static void RenumberFrame(
+      const std::byte *frame, std::size_t length, std::uint64_t firstSample,
+      std::vector<std::byte> &result
+    );
+
+    /// <summary>Information extracted from a frame header</summary>
+    private: struct FrameHeader {
+
+      /// <summary>Length of the frame header in bytes, including its CRC-8</summary>
+      public: std::size_t Length;
+      /// <summary>Whether the frame is numbered by sample instead of by frame</summary>
+      public: bool IsVariableBlockSize;
+      /// <summary>Frame number or sample number stored in the header</summary>
+      public: std::uint64_t Number;
+      /// <summary>Number of samples (in each channel) in the frame</summary>
+      public: std::size_t SampleCount;
+      /// <summary>Number of audio channels stored in the frame</summary>
+      public: std::size_t ChannelCount;
+      /// <summary>Bits per sample stated in the header, 0 to use the STREAMINFO's</summary>
+      public: std::size_t BitsPerSample;
+      /// <summary>Sample rate stated in the header, 0 to use the STREAMINFO's</summary>
+      public: std::size_t SampleRate;
+      /// <summary>Number of bytes taken by the UTF-8 coded frame or sample number</summary>
+      public: std::size_t NumberLength;
+
+    };
+
+    /// <summary>Parses a frame header and checks its CRC-8</summary>
+    /// <param name="data">Bytes that may hold a frame header</param>
+    /// <param name="availableByteCount">Number of bytes that can be looked at</param>
+    /// <param name="header">Receives the information stored in the header</param>
+    /// <returns>True if the bytes hold a valid frame header</returns>
+    private: static bool tryParseHeader(
+      const std::byte *data, std::size_t availableByteCount, FrameHeader &header
+    );
+
+    /// <summary>Checks whether a frame header fits the stream that is being scanned</summary>
+    /// <param name="data">Bytes that may hold a frame header</param>
+    /// <param name="availableByteCount">Number of bytes that can be looked at</param>
+    /// <param name="header">Receives the information stored in the header</param>
+    /// <returns>True if the bytes hold a valid frame header belonging to the stream</returns>
+    private: bool tryParseStreamHeader(
+      const std::byte *data, std::size_t availableByteCount, FrameHeader &header
+    ) const;
+
+    /// <summary>Looks for the first valid frame at or after the specified offset</summary>
+    /// <param name="offset">Offset at which the search begins</param>
+    /// <param name="limit">Offset at which the search gives up</param>
+    /// <param name="frame">Receives the frame that was found</param>
+    /// <returns>True if a frame was found, false otherwise</returns>
+    private: bool tryFindFrameAfter(std::uint64_t offset, std::uint64_t limit, Frame &frame) const;
+
+    /// <summary>FLAC file whose frames are being located</summary>
+    private: const VirtualFile &file;
+    /// <summary>Metadata blocks stored in front of the frames</summary>
+    private: std::vector<MetadataBlock> metadataBlocks;
+    /// <summary>Offset at which the first frame begins</summary>
+    private: std::uint64_t firstFrameOffset;
+    /// <summary>Number of audio channels stated in the STREAMINFO block</summary>
+    private: std::size_t channelCount;
+    /// <summary>Bits per sample stated in the STREAMINFO block</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Sample rate stated in the STREAMINFO block</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Number of samples used by each frame of a fixed blocksize stream</summary>
+    private: std::size_t nominalBlockSize;
+    /// <summary>Total number of samples stated in the STREAMINFO block</summary>
+    private: std::uint64_t totalSampleCount;
+    /// <summary>Whether the frames are numbered by sample instead of by frame</summary>
+    private: bool isVariableBlockSize;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACFRAMESCANNER_H
@@ -0,0 +1,107 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacMd5Verifier.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include "../../Platform/FlacApi.h" // for the wrapped FLAC API methods
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult FlacMd5Verifier::Verify(
+    const std::shared_ptr<const VirtualFile> &file, const CancellationToken &cancellation
+  ) {
+    FlacMd5Verifier verifier(cancellation);
+
+    std::shared_ptr<::FLAC__StreamDecoder> streamDecoder = (
+      Platform::FlacApi::NewStreamDecoder()
+    );
+    Platform::FlacApi::EnableMd5Checking(streamDecoder, true);
+
+    std::unique_ptr<ReadOnlyFileAdapterState> state = (
+      FileAdapterFactory::InitStreamDecoderForReading(file, streamDecoder, &verifier)
+    );
+    bool reachedEnd = Platform::FlacApi::ProcessUntilEndOfStream(streamDecoder);
+    bool md5Matched = Platform::FlacApi::FinishAndCheckMd5(streamDecoder);
+    FileAdapterState::RethrowPotentialException(*state);
+
+    if(cancellation.IsCancellationRequested()) {
+      return VerificationResult::NotChecked;
+    }
+    if(!reachedEnd || verifier.hadError || !md5Matched) {
+      return VerificationResult::Failed;
+    }
+
+    // libflac silently skips the comparison when the hash is all zeros, which is what
+    // encoders write when they didn't calculate it, so there's nothing to vouch for
+    if(!verifier.hasChecksum) {
+      return VerificationResult::NoChecksum;
+    }
+
+    return VerificationResult::Passed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacMd5Verifier::FlacMd5Verifier(const CancellationToken &cancellation) :
+    cancellation(cancellation),
+    hasChecksum(false),
+    hadError(false) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacMd5Verifier::ProcessAudioFrame(
+    const ::FLAC__Frame &, const ::FLAC__int32 *const []
+  ) {
+    return !this->cancellation.IsCancellationRequested();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacMd5Verifier::ProcessMetadata(const ::FLAC__StreamMetadata &metadata) noexcept {
+    if(metadata.type == FLAC__METADATA_TYPE_STREAMINFO) {
+      const ::FLAC__StreamMetadata_StreamInfo &streamInfo = metadata.data.stream_info;
+      for(std::size_t index = 0; index < 16; ++index) {
+        if(streamInfo.md5sum[index] != 0) {
+          this->hasChecksum = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacMd5Verifier::HandleError(::FLAC__StreamDecoderErrorStatus) noexcept {
+    this->hadError = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
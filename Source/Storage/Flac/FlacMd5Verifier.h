@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACMD5VERIFIER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACMD5VERIFIER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/IntegrityVerification.h"
+#include "./FlacVirtualFileAdapter.h" // for the FlacDecodeProcessor interface
+
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class CancellationToken;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a whole FLAC file to check it against its stored MD5 hash</summary>
+  /// <remarks>
+  ///   The decoded samples are thrown away, libflac hashes them while decoding and
+  ///   compares the hash when the decoder is finished. Frames failing their CRC-16 check
+  ///   are reported through the error callback and also count as a failure.
+  /// </remarks>
+  class FlacMd5Verifier : private FlacDecodeProcessor {
+
+    /// <summary>Decodes a FLAC file and compares the MD5 hash of its audio data</summary>
+    /// <param name="file">FLAC file that will be verified</param>
+    /// <param name="cancellation">Token by which the verification can be cancelled</param>
+    /// <returns>The outcome of the verification</returns>
+    public: static VerificationResult Verify(
+      const std::shared_ptr<const VirtualFile> &file, const CancellationToken &cancellation
+    );
+
+    /// <summary>Initializes a new MD5 verifier</summary>
+    /// <param name="cancellation">Token that is checked after each decoded frame</param>
+    private: FlacMd5Verifier(const CancellationToken &cancellation);
+
+    /// <summary>Called to process an audio frame after it has been decoded</summary>
+    /// <param name="frame">Informations about the decoded audio frame</param>
+    /// <param name="buffer">Stores the decoded audio samples</param>
+    /// <returns>True to continue decoding, false to stop at this point</returns>
+    private: bool ProcessAudioFrame(
+      const ::FLAC__Frame &frame,
+      const ::FLAC__int32 *const buffer[]
+    ) override;
+
+    /// <summary>Called to process any metadata encountered in the FLAC file</summary>
+    /// <param name="metadata">Metadata the FLAC stream decoder has encountered</param>
+    private: void ProcessMetadata(const ::FLAC__StreamMetadata &metadata) noexcept override;
+
+    /// <summary>Called to provide a detailed status when a decoding error occurs</summary>
+    /// <param name="status">Error status of the stream decoder</param>
+    private: void HandleError(::FLAC__StreamDecoderErrorStatus status) noexcept override;
+
+    /// <summary>Token by which the caller can stop the verification early</summary>
+    private: const CancellationToken &cancellation;
+    /// <summary>Whether the STREAMINFO block contained an MD5 hash</summary>
+    private: bool hasChecksum;
+    /// <summary>Whether libflac reported any error while decoding</summary>
+    private: bool hadError;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACMD5VERIFIER_H
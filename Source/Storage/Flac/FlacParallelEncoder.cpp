@@ -0,0 +1,582 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacParallelEncoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Storage/VirtualFile.h" // for VirtualFile
+#include "../../Platform/FlacEncoderApi.h" // for FlacEncoderApi
+
+#include <algorithm> // for std::min(), std::max(), std::copy_n()
+#include <exception> // for std::exception_ptr
+#include <stdexcept> // for std::logic_error, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames in each FLAC frame the parallel encoder produces</summary>
+  /// <remarks>
+  ///   This is the block size libFLAC uses from compression level 3 upwards and
+  ///   stays within the streamable subset for sample rates up to 48 kHz.
+  /// </remarks>
+  const std::size_t BlockSize = 4096;
+
+  /// <summary>Number of FLAC frames each worker thread encodes in one go</summary>
+  /// <remarks>
+  ///   Large enough that setting up a libFLAC encoder per chunk is negligible,
+  ///   small enough that a few chunks per thread can be held in memory.
+  /// </remarks>
+  const std::size_t BlocksPerChunk = 64;
+
+  /// <summary>Size of the stream marker, metadata block header and stream info</summary>
+  const std::size_t StreamHeaderSize = 4 + 4 + 34;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lookup tables for the two checksums in a FLAC frame</summary>
+  struct FrameCrcTables {
+
+    /// <summary>CRC-8 (polynomial 0x07) protecting the frame header</summary>
+    public: std::uint8_t Crc8[256];
+    /// <summary>CRC-16 (polynomial 0x8005) protecting the whole frame</summary>
+    public: std::uint16_t Crc16[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the lookup tables for the FLAC frame checksums</summary>
+  /// <returns>The lookup tables for the FLAC frame checksums</returns>
+  constexpr FrameCrcTables makeFrameCrcTables() {
+    FrameCrcTables tables = {};
+    for(unsigned index = 0; index < 256; ++index) {
+      unsigned crc8 = index;
+      unsigned crc16 = index << 8;
+      for(unsigned bit = 0; bit < 8; ++bit) {
+        crc8 = ((crc8 << 1) ^ (((crc8 & 0x80) != 0) ? 0x07 : 0x00)) & 0xFF;
+        crc16 = ((crc16 << 1) ^ (((crc16 & 0x8000) != 0) ? 0x8005 : 0x0000)) & 0xFFFF;
+      }
+      tables.Crc8[index] = static_cast<std::uint8_t>(crc8);
+      tables.Crc16[index] = static_cast<std::uint16_t>(crc16);
+    }
+    return tables;
+  }
+
+  /// <summary>Lookup tables for the two checksums in a FLAC frame</summary>
+  constexpr FrameCrcTables frameCrcTables = makeFrameCrcTables();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the CRC-8 checksum FLAC uses for frame headers</summary>
+  /// <param name="data">Data the checksum will be calculated over</param>
+  /// <param name="byteCount">Number of bytes to calculate the checksum over</param>
+  /// <returns>The CRC-8 checksum of the data</returns>
+  std::uint8_t calculateCrc8(const std::byte *data, std::size_t byteCount) {
+    std::uint8_t crc = 0;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      crc = frameCrcTables.Crc8[crc ^ static_cast<std::uint8_t>(data[index])];
+    }
+    return crc;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the CRC-16 checksum FLAC uses for whole frames</summary>
+  /// <param name="data">Data the checksum will be calculated over</param>
+  /// <param name="byteCount">Number of bytes to calculate the checksum over</param>
+  /// <returns>The CRC-16 checksum of the data</returns>
+  std::uint16_t calculateCrc16(const std::byte *data, std::size_t byteCount) {
+    std::uint16_t crc = 0;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      std::uint8_t tableIndex = static_cast<std::uint8_t>(
+        (crc >> 8) ^ static_cast<std::uint8_t>(data[index])
+      );
+      crc = static_cast<std::uint16_t>((crc << 8) ^ frameCrcTables.Crc16[tableIndex]);
+    }
+    return crc;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the length of a UTF-8 style coded number in a frame header</summary>
+  /// <param name="leadingByte">First byte of the coded number</param>
+  /// <returns>The total number of bytes in the coded number</returns>
+  std::size_t getCodedNumberLength(std::byte leadingByte) {
+    std::uint8_t value = static_cast<std::uint8_t>(leadingByte);
+    std::size_t length = 1;
+    if((value & 0x80) != 0) {
+      while((length < 7) && ((value & (0x80 >> length)) != 0)) {
+        ++length;
+      }
+    }
+    return length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a number in the UTF-8 style coding of FLAC frame headers</summary>
+  /// <param name="output">Buffer to which the coded number will be appended</param>
+  /// <param name="number">Number that will be coded and appended</param>
+  void appendCodedNumber(std::vector<std::byte> &output, std::uint64_t number) {
+    if(number < 0x80) {
+      output.push_back(static_cast<std::byte>(number));
+      return;
+    }
+
+    // Each continuation byte carries 6 bits, the leading byte carries what's left
+    // after its length prefix (5 bits for two bytes, 4 for three and so on)
+    std::size_t continuationCount = 1;
+    while(continuationCount < 6) {
+      if((number >> (continuationCount * 6)) < (0x40U >> continuationCount)) {
+        break;
+      }
+      ++continuationCount;
+    }
+
+    std::uint8_t prefix = static_cast<std::uint8_t>(0xFF00 >> (continuationCount + 1));
+    std::uint8_t leadingBits = static_cast<std::uint8_t>(number >> (continuationCount * 6));
+    output.push_back(static_cast<std::byte>(prefix | leadingBits));
+    while(continuationCount > 0) {
+      --continuationCount;
+      output.push_back(
+        static_cast<std::byte>(0x80 | ((number >> (continuationCount * 6)) & 0x3F))
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a FLAC frame with a different frame number in its header</summary>
+  /// <param name="output">Buffer that will receive the renumbered frame</param>
+  /// <param name="frame">FLAC frame that will be renumbered</param>
+  /// <param name="frameLength">Length of the FLAC frame in bytes</param>
+  /// <param name="frameNumber">Frame number the copied frame will carry</param>
+  void renumberFrame(
+    std::vector<std::byte> &output,
+    const std::byte *frame, std::size_t frameLength, std::uint64_t frameNumber
+  ) {
+    if(unlikely(frameLength < 8)) {
+      throw std::runtime_error(u8"libflac produced a FLAC frame too short to be valid");
+    }
+
+    // The frame header begins with the sync code, block size and sample rate codes and
+    // the channel assignment and sample size codes, followed by the frame number
+    std::size_t numberLength = getCodedNumberLength(frame[4]);
+    std::size_t headerEnd = 4 + numberLength;
+
+    // Depending on the block size and sample rate codes, they're followed by
+    // additional bytes holding the actual block size and sample rate
+    std::uint8_t blockSizeCode = static_cast<std::uint8_t>(frame[2]) >> 4;
+    if(blockSizeCode == 6) {
+      headerEnd += 1;
+    } else if(blockSizeCode == 7) {
+      headerEnd += 2;
+    }
+    std::uint8_t sampleRateCode = static_cast<std::uint8_t>(frame[2]) & 0x0F;
+    if(sampleRateCode == 12) {
+      headerEnd += 1;
+    } else if((sampleRateCode == 13) || (sampleRateCode == 14)) {
+      headerEnd += 2;
+    }
+    if(unlikely(headerEnd + 1 + 2 > frameLength)) {
+      throw std::runtime_error(u8"libflac produced a FLAC frame with a truncated header");
+    }
+
+    output.clear();
+    output.insert(output.end(), frame, frame + 4);
+    appendCodedNumber(output, frameNumber);
+    output.insert(output.end(), frame + 4 + numberLength, frame + headerEnd);
+    output.push_back(static_cast<std::byte>(calculateCrc8(output.data(), output.size())));
+
+    // Subframes are copied unchanged (the old header CRC-8 at headerEnd is skipped),
+    // but the CRC-16 at the end of the frame covers the header, so it has to be redone
+    output.insert(output.end(), frame + headerEnd + 1, frame + frameLength - 2);
+    std::uint16_t crc16 = calculateCrc16(output.data(), output.size());
+    output.push_back(static_cast<std::byte>(crc16 >> 8));
+    output.push_back(static_cast<std::byte>(crc16 & 0xFF));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct FlacParallelEncoder::Chunk {
+
+    /// <summary>Interleaved audio frames the chunk will encode</summary>
+    public: SampleVector<std::int32_t> Samples;
+    /// <summary>Number of audio frames that have been placed in the chunk</summary>
+    public: std::size_t FrameCount;
+    /// <summary>FLAC frames the chunk has been encoded to, back to back</summary>
+    public: std::vector<std::byte> EncodedData;
+    /// <summary>Length of each FLAC frame in the encoded data</summary>
+    public: std::vector<std::size_t> FrameLengths;
+    /// <summary>Error that happened while the worker thread encoded the chunk</summary>
+    public: std::exception_ptr Error;
+    /// <summary>Whether a worker thread has finished encoding the chunk</summary>
+    public: bool IsEncoded;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacParallelEncoder::FlacParallelEncoder(
+    const std::shared_ptr<VirtualFile> &target,
+    std::size_t channelCount,
+    std::size_t bitsPerSample,
+    std::size_t sampleRate,
+    unsigned compressionLevel,
+    std::size_t threadCount
+  ) :
+    target(target),
+    channelCount(channelCount),
+    bitsPerSample(bitsPerSample),
+    sampleRate(sampleRate),
+    compressionLevel(compressionLevel),
+    maximumChunksInFlight(std::max<std::size_t>(threadCount, 1) * 2),
+    fillingChunk(),
+    spareChunks(),
+    submittedChunks(),
+    waitingChunks(),
+    fileCursor(0),
+    nextFrameNumber(0),
+    writtenFrameCount(0),
+    minimumFrameSize(0),
+    maximumFrameSize(0),
+    renumberedFrame(),
+    isFinished(false),
+    queueMutex(),
+    chunkSubmitted(),
+    chunkEncoded(),
+    stopping(false),
+    workers() {
+
+    // Reserve room for the stream info block. It can only be filled out once all
+    // frames have been written, so Finish() will overwrite it with the final one.
+    writeStreamHeader();
+    this->fileCursor = StreamHeaderSize;
+
+    try {
+      for(std::size_t index = 0; index < std::max<std::size_t>(threadCount, 1); ++index) {
+        this->workers.emplace_back(&FlacParallelEncoder::encodeChunks, this);
+      }
+    }
+    catch(...) {
+      stopWorkers();
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacParallelEncoder::~FlacParallelEncoder() {
+    stopWorkers();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::Encode(const std::int32_t *samples, std::size_t frameCount) {
+    if(unlikely(this->isFinished)) {
+      throw std::logic_error(u8"Samples can not be encoded after the stream has been flushed");
+    }
+
+    const std::size_t chunkFrameCount = BlockSize * BlocksPerChunk;
+    while(frameCount > 0) {
+      if(!static_cast<bool>(this->fillingChunk)) {
+        if(this->spareChunks.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->fillingChunk = std::make_shared<Chunk>();
+          this->fillingChunk->Samples.resize(chunkFrameCount * this->channelCount);
+        } else {
+          this->fillingChunk = std::move(this->spareChunks.back());
+          this->spareChunks.pop_back();
+        }
+        this->fillingChunk->FrameCount = 0;
+        this->fillingChunk->EncodedData.clear();
+        this->fillingChunk->FrameLengths.clear();
+        this->fillingChunk->Error = std::exception_ptr();
+        this->fillingChunk->IsEncoded = false;
+      }
+
+      std::size_t copiedFrameCount = std::min(
+        frameCount, chunkFrameCount - this->fillingChunk->FrameCount
+      );
+      std::copy_n(
+        samples,
+        copiedFrameCount * this->channelCount,
+        this->fillingChunk->Samples.data() + (this->fillingChunk->FrameCount * this->channelCount)
+      );
+      this->fillingChunk->FrameCount += copiedFrameCount;
+      samples += copiedFrameCount * this->channelCount;
+      frameCount -= copiedFrameCount;
+
+      // Only completely filled chunks are submitted before the stream ends, so every
+      // FLAC frame except for the very last one will have the full block size.
+      if(this->fillingChunk->FrameCount == chunkFrameCount) {
+        submitFillingChunk();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::Finish() {
+    if(this->isFinished) {
+      return;
+    }
+
+    if(static_cast<bool>(this->fillingChunk) && (this->fillingChunk->FrameCount > 0)) {
+      submitFillingChunk();
+    }
+    while(!this->submittedChunks.empty()) {
+      writeOldestChunk();
+    }
+
+    writeStreamHeader();
+    this->isFinished = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::submitFillingChunk() {
+
+    // Keep the number of chunks in memory bounded. If the caller produces samples
+    // faster than the threads can encode them, this is where the caller waits.
+    while(this->submittedChunks.size() >= this->maximumChunksInFlight) {
+      writeOldestChunk();
+    }
+
+    {
+      std::lock_guard<std::mutex> queueMutexScope(this->queueMutex);
+      this->submittedChunks.push_back(this->fillingChunk);
+      this->waitingChunks.push_back(std::move(this->fillingChunk));
+    }
+    this->chunkSubmitted.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::writeOldestChunk() {
+    std::shared_ptr<Chunk> chunk;
+    {
+      std::unique_lock<std::mutex> queueMutexScope(this->queueMutex);
+      this->chunkEncoded.wait(
+        queueMutexScope, [this] { return this->submittedChunks.front()->IsEncoded; }
+      );
+      chunk = std::move(this->submittedChunks.front());
+      this->submittedChunks.pop_front();
+    }
+
+    if(unlikely(static_cast<bool>(chunk->Error))) {
+      std::rethrow_exception(chunk->Error);
+    }
+
+    // Each chunk was encoded by its own libFLAC instance, so its frames are numbered
+    // from zero. Give them the numbers they have in the complete stream.
+    const std::byte *frame = chunk->EncodedData.data();
+    for(std::size_t frameLength : chunk->FrameLengths) {
+      renumberFrame(this->renumberedFrame, frame, frameLength, this->nextFrameNumber);
+      this->target->WriteAt(
+        this->fileCursor, this->renumberedFrame.size(), this->renumberedFrame.data()
+      );
+
+      std::size_t frameSize = this->renumberedFrame.size();
+      if((this->minimumFrameSize == 0) || (frameSize < this->minimumFrameSize)) {
+        this->minimumFrameSize = frameSize;
+      }
+      this->maximumFrameSize = std::max(this->maximumFrameSize, frameSize);
+
+      this->fileCursor += this->renumberedFrame.size();
+      ++this->nextFrameNumber;
+      frame += frameLength;
+    }
+    this->writtenFrameCount += chunk->FrameCount;
+
+    this->spareChunks.push_back(std::move(chunk));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::writeStreamHeader() {
+    std::byte header[StreamHeaderSize] = {};
+
+    header[0] = std::byte(u8'f');
+    header[1] = std::byte(u8'L');
+    header[2] = std::byte(u8'a');
+    header[3] = std::byte(u8'C');
+
+    // Metadata block header: last block flag with type 0 (stream info), 34 bytes long
+    header[4] = std::byte(0x80);
+    header[7] = std::byte(34);
+
+    // Minimum and maximum block size (the last frame may be shorter, which is allowed)
+    header[8] = static_cast<std::byte>(BlockSize >> 8);
+    header[9] = static_cast<std::byte>(BlockSize & 0xFF);
+    header[10] = header[8];
+    header[11] = header[9];
+
+    // Minimum and maximum frame size, 24 bits each, zero if unknown
+    header[12] = static_cast<std::byte>((this->minimumFrameSize >> 16) & 0xFF);
+    header[13] = static_cast<std::byte>((this->minimumFrameSize >> 8) & 0xFF);
+    header[14] = static_cast<std::byte>(this->minimumFrameSize & 0xFF);
+    header[15] = static_cast<std::byte>((this->maximumFrameSize >> 16) & 0xFF);
+    header[16] = static_cast<std::byte>((this->maximumFrameSize >> 8) & 0xFF);
+    header[17] = static_cast<std::byte>(this->maximumFrameSize & 0xFF);
+
+    // Sample rate (20 bits), channel count - 1 (3 bits), bits per sample - 1 (5 bits)
+    // and total number of audio frames (36 bits, zero if unknown) packed into 64 bits
+    std::uint64_t totalFrameCount = this->writtenFrameCount;
+    if(totalFrameCount >= (std::uint64_t(1) << 36)) {
+      totalFrameCount = 0;
+    }
+    std::uint64_t packed = (
+      (static_cast<std::uint64_t>(this->sampleRate) << 44) |
+      (static_cast<std::uint64_t>(this->channelCount - 1) << 41) |
+      (static_cast<std::uint64_t>(this->bitsPerSample - 1) << 36) |
+      totalFrameCount
+    );
+    for(std::size_t index = 0; index < 8; ++index) {
+      header[18 + index] = static_cast<std::byte>((packed >> (56 - index * 8)) & 0xFF);
+    }
+
+    // The remaining 16 bytes are the MD5 signature, all zero meaning it was not calculated
+    this->target->WriteAt(0, StreamHeaderSize, header);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::encodeChunks() {
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    for(;;) {
+      std::shared_ptr<Chunk> chunk;
+      {
+        std::unique_lock<std::mutex> queueMutexScope(this->queueMutex);
+        this->chunkSubmitted.wait(
+          queueMutexScope, [this] { return this->stopping || !this->waitingChunks.empty(); }
+        );
+        if(this->stopping) {
+          return;
+        }
+
+        chunk = std::move(this->waitingChunks.front());
+        this->waitingChunks.pop_front();
+      }
+
+      try {
+        encodeChunk(*chunk);
+      }
+      catch(...) {
+        chunk->Error = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> queueMutexScope(this->queueMutex);
+        chunk->IsEncoded = true;
+      }
+      this->chunkEncoded.notify_all();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::encodeChunk(Chunk &chunk) const {
+    std::shared_ptr<::FLAC__StreamEncoder> encoder = (
+      Platform::FlacEncoderApi::NewStreamEncoder()
+    );
+
+    Platform::FlacEncoderApi::SetFormat(
+      encoder, this->channelCount, this->bitsPerSample, this->sampleRate
+    );
+    Platform::FlacEncoderApi::SetCompressionLevel(encoder, this->compressionLevel);
+    Platform::FlacEncoderApi::SetBlockSize(encoder, BlockSize);
+    Platform::FlacEncoderApi::EnableMd5Calculation(encoder, false);
+
+    // Without seek and tell callbacks, libFLAC writes the stream header once and
+    // then only frames, which is all we need from it
+    Platform::FlacEncoderApi::InitStream(
+      chunk.Error, encoder, &FlacParallelEncoder::collectEncodedFrame, nullptr, nullptr, &chunk
+    );
+    Platform::FlacEncoderApi::ProcessInterleaved(
+      chunk.Error, encoder, chunk.Samples.data(), chunk.FrameCount
+    );
+    Platform::FlacEncoderApi::Finish(chunk.Error, encoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacParallelEncoder::stopWorkers() {
+    {
+      std::lock_guard<std::mutex> queueMutexScope(this->queueMutex);
+      this->stopping = true;
+    }
+    this->chunkSubmitted.notify_all();
+
+    for(std::thread &worker : this->workers) {
+      worker.join();
+    }
+    this->workers.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ::FLAC__StreamEncoderWriteStatus FlacParallelEncoder::collectEncodedFrame(
+    const ::FLAC__StreamEncoder *encoder,
+    const ::FLAC__byte buffer[], size_t bytes,
+    std::uint32_t samples, std::uint32_t currentFrame,
+    void *chunkAsVoid
+  ) {
+    (void)encoder;
+    (void)currentFrame;
+
+    // The stream marker and metadata blocks are delivered with a sample count of zero.
+    // The chunk only needs the frames, the stream header is written by the main thread.
+    if(samples == 0) {
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+    }
+
+    Chunk &chunk = *reinterpret_cast<Chunk *>(chunkAsVoid);
+    try {
+      const std::byte *data = reinterpret_cast<const std::byte *>(buffer);
+      chunk.EncodedData.insert(chunk.EncodedData.end(), data, data + bytes);
+      chunk.FrameLengths.push_back(bytes);
+    }
+    catch(const std::exception &) {
+      chunk.Error = std::current_exception();
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+    }
+
+    return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,190 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACPARALLELENCODER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACPARALLELENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <FLAC/stream_encoder.h> // for the encoder callback signatures
+
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::byte
+#include <cstdint> // for std::int32_t, std::uint64_t
+#include <deque> // for std::deque
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a FLAC stream by compressing chunks of it on several threads</summary>
+  /// <remarks>
+  ///   <para>
+  ///     FLAC frames do not depend on each other, so a long recording can be cut into
+  ///     chunks of whole frames that are handed to independent instances of libFLAC.
+  ///     The encoded frames are then written in their original order, with their frame
+  ///     numbers (and the checksums covering them) patched to continue from the frames
+  ///     of the previous chunk.
+  ///   </para>
+  ///   <para>
+  ///     The stream uses a fixed block size regardless of compression level so that every
+  ///     chunk can be encoded without knowing the others. The MD5 signature of the audio
+  ///     data is left unset (which the FLAC specification allows) because it would have
+  ///     to be computed serially over the whole stream.
+  ///   </para>
+  /// </remarks>
+  class FlacParallelEncoder {
+
+    /// <summary>Initializes a new parallel FLAC encoder</summary>
+    /// <param name="target">File into which the encoded FLAC stream will be written</param>
+    /// <param name="channelCount">Number of interleaved channels in each frame</param>
+    /// <param name="bitsPerSample">Number of valid bits in each sample</param>
+    /// <param name="sampleRate">Playback rate in samples per second</param>
+    /// <param name="compressionLevel">libFLAC compression level from 0 to 8</param>
+    /// <param name="threadCount">Number of threads that will encode chunks</param>
+    public: FlacParallelEncoder(
+      const std::shared_ptr<VirtualFile> &target,
+      std::size_t channelCount,
+      std::size_t bitsPerSample,
+      std::size_t sampleRate,
+      unsigned compressionLevel,
+      std::size_t threadCount
+    );
+
+    /// <summary>Stops the encoding threads and frees all resources</summary>
+    public: ~FlacParallelEncoder();
+
+    /// <summary>Queues interleaved samples for encoding</summary>
+    /// <param name="samples">Interleaved, right-aligned samples in FLAC channel order</param>
+    /// <param name="frameCount">Number of audio frames in the sample buffer</param>
+    public: void Encode(const std::int32_t *samples, std::size_t frameCount);
+
+    /// <summary>Encodes all queued samples and completes the stream info block</summary>
+    public: void Finish();
+
+    /// <summary>Audio frames and encoded FLAC frames for one section of the stream</summary>
+    private: struct Chunk;
+
+    /// <summary>Hands the partially or fully filled chunk to the encoding threads</summary>
+    private: void submitFillingChunk();
+
+    /// <summary>Waits for the oldest submitted chunk and writes its FLAC frames</summary>
+    private: void writeOldestChunk();
+
+    /// <summary>Writes the stream marker and stream info block at the file's start</summary>
+    private: void writeStreamHeader();
+
+    /// <summary>Picks up submitted chunks and encodes them, run by the worker threads</summary>
+    private: void encodeChunks();
+
+    /// <summary>Encodes the audio frames in a chunk with a new libFLAC encoder</summary>
+    /// <param name="chunk">Chunk whose audio frames will be encoded</param>
+    private: void encodeChunk(Chunk &chunk) const;
+
+    /// <summary>Asks the worker threads to end and waits until they have</summary>
+    private: void stopWorkers();
+
+    /// <summary>Collects the FLAC frames produced by a libFLAC encoder</summary>
+    /// <param name="encoder">FLAC stream encoder that is delivering the data</param>
+    /// <param name="buffer">Buffer holding the encoded data</param>
+    /// <param name="bytes">Number of bytes that have been produced</param>
+    /// <param name="samples">Number of samples in the data or 0 for metadata</param>
+    /// <param name="currentFrame">Index of the FLAC frame within the chunk</param>
+    /// <param name="chunkAsVoid">Chunk the FLAC frame will be stored in</param>
+    /// <returns>Always OK, storing the frames in memory does not fail</returns>
+    private: static ::FLAC__StreamEncoderWriteStatus collectEncodedFrame(
+      const ::FLAC__StreamEncoder *encoder,
+      const ::FLAC__byte buffer[], size_t bytes,
+      std::uint32_t samples, std::uint32_t currentFrame,
+      void *chunkAsVoid
+    );
+
+    /// <summary>File the encoded FLAC stream is written into</summary>
+    private: std::shared_ptr<VirtualFile> target;
+    /// <summary>Number of interleaved channels in each frame</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of valid bits in each sample</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Playback rate in samples per second</summary>
+    private: std::size_t sampleRate;
+    /// <summary>libFLAC compression level the chunks are encoded with</summary>
+    private: unsigned compressionLevel;
+    /// <summary>Largest number of chunks that may be submitted but not written</summary>
+    private: std::size_t maximumChunksInFlight;
+
+    /// <summary>Chunk that is currently being filled with audio frames</summary>
+    private: std::shared_ptr<Chunk> fillingChunk;
+    /// <summary>Chunks that have been written and can be filled again</summary>
+    private: std::vector<std::shared_ptr<Chunk>> spareChunks;
+    /// <summary>Submitted chunks in stream order, encoded or not</summary>
+    private: std::deque<std::shared_ptr<Chunk>> submittedChunks;
+    /// <summary>Submitted chunks no worker thread has picked up yet</summary>
+    private: std::deque<std::shared_ptr<Chunk>> waitingChunks;
+
+    /// <summary>Position in the file at which the next FLAC frame will be written</summary>
+    private: std::uint64_t fileCursor;
+    /// <summary>Number the next FLAC frame written will be given</summary>
+    private: std::uint64_t nextFrameNumber;
+    /// <summary>Total number of audio frames that have been written</summary>
+    private: std::uint64_t writtenFrameCount;
+    /// <summary>Size of the smallest FLAC frame written so far</summary>
+    private: std::size_t minimumFrameSize;
+    /// <summary>Size of the largest FLAC frame written so far</summary>
+    private: std::size_t maximumFrameSize;
+    /// <summary>Holds a FLAC frame while its header is rewritten</summary>
+    private: std::vector<std::byte> renumberedFrame;
+    /// <summary>Whether the stream has been finished</summary>
+    private: bool isFinished;
+
+    /// <summary>Must be held when accessing the chunk queues or the stop flag</summary>
+    private: std::mutex queueMutex;
+    /// <summary>Signalled when a chunk is submitted or the workers should stop</summary>
+    private: std::condition_variable chunkSubmitted;
+    /// <summary>Signalled when a worker has finished encoding a chunk</summary>
+    private: std::condition_variable chunkEncoded;
+    /// <summary>Set when the worker threads should end</summary>
+    private: bool stopping;
+    /// <summary>Threads encoding the submitted chunks</summary>
+    private: std::vector<std::thread> workers;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACPARALLELENCODER_H
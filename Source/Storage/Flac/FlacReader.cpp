@@ -25,13 +25,19 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_FLAC)
 
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h"
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
 
 #include <Nuclex/Support/ScopeGuard.h> // for ON_SCOPE_EXIT
 
 #include "../../Platform/FlacApi.h" // for the wrapped FLAC API functions
+#include "./FlacSeekTable.h" // for FlacSeekTable
+#include "../Shared/DecoderStatisticsCollector.h" // for DecoderStatisticsCollector
+#include "../Shared/LoopTagParser.h" // for LoopTagParser
+#include "../Shared/GainTagParser.h" // for GainTagParser
 
 #include <Nuclex/Support/Text/StringHelper.h> // for StringHelper::GetTrimmed()
+#include <algorithm> // for std::min()
 #include <cassert> // for assert()
 
 namespace {
@@ -202,9 +208,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     obtainedChannelMask(false),
     channelAssignment(),
     totalFrameCount(std::uint64_t(-1)),
+    blockSize(0),
+    hasFixedBlockSize(false),
     trackInfo(nullptr),
+    includeTags(true),
     frameCursor(0),
     scheduledSeekPosition(),
+    scheduledCheckpoint(),
+    discardFrameCount(0),
+    seekTable(),
+    statistics(),
     userPointerForCallback(nullptr),
     processDecodedSamplesCallback(nullptr) {
 
@@ -214,6 +227,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     Platform::FlacApi::SetRespondMetadata(
       streamDecoder, FLAC__METADATA_TYPE_VORBIS_COMMENT
     );
+    Platform::FlacApi::SetRespondMetadata(
+      streamDecoder, FLAC__METADATA_TYPE_CUESHEET
+    );
 
     // Open the FLAC file. The stream decoder is created as a blank objects and
     // then initialized via a set of I/O callbacks to access our virtual file.
@@ -236,7 +252,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void FlacReader::ReadMetadata(TrackInfo &target) {
+  void FlacReader::ReadMetadata(TrackInfo &target, bool includeTags /* = true */) {
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+
     this->processDecodedSamplesCallback = nullptr;
 
     // Let the stream decoder process FLAC data blocks. They will be delivered via
@@ -244,6 +262,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     // is like that), and with the 'isReadingMetadata' property set, the callbacks will
     // trigger an early stop right after the first audio frame has been decoded.
     this->trackInfo = &target;
+    this->includeTags = includeTags;
     while(!this->obtainedMetadata || !this->channelAssignment.has_value()) {
       bool wasProcessed = Platform::FlacApi::ProcessSingle(this->streamDecoder);
       if(!wasProcessed) {
@@ -279,6 +298,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t FlacReader::GetBlockSize() const {
+    assert(this->obtainedMetadata && u8"Block size must be queried after reading metadata");
+    return this->blockSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t FlacReader::GetFrameCursorPosition() const {
     return this->scheduledSeekPosition.value_or(this->frameCursor);
   }
@@ -296,12 +322,85 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     // the next Decode() request in lieu of calling DecodeSingle()...
     //
     this->scheduledSeekPosition = frameIndex;
+    this->scheduledCheckpoint.reset();
     // Do not update frameCursor here until we're actually done seeking!
 
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  Shared::DecoderCheckpoint FlacReader::Checkpoint(std::uint64_t frameIndex) {
+    Seek(frameIndex);
+
+    if(static_cast<bool>(this->seekTable)) {
+      std::optional<FlacSeekTable::Entry> seekPoint = this->seekTable->TryFindSeekPoint(
+        frameIndex
+      );
+      if(seekPoint.has_value()) {
+        return Shared::DecoderCheckpoint {
+          frameIndex, seekPoint->SampleNumber, seekPoint->ByteOffset, true
+        };
+      }
+    }
+
+    return Shared::DecoderCheckpoint { frameIndex, frameIndex, 0, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::Restore(const Shared::DecoderCheckpoint &checkpoint) {
+    Seek(checkpoint.FrameIndex);
+    if(checkpoint.IsDirect) {
+      this->scheduledCheckpoint = checkpoint;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::UseSeekTable(const std::shared_ptr<FlacSeekTable> &seekTable) {
+    this->seekTable = seekTable;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::UseStatistics(
+    const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+  ) {
+    this->statistics = statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::BuildSeekTable() {
+    assert(this->obtainedMetadata && u8"Seek table is built after reading metadata");
+    assert(static_cast<bool>(this->seekTable) && u8"Reader has a seek table to build");
+
+    this->processDecodedSamplesCallback = nullptr;
+    this->trackInfo = nullptr;
+
+    while(this->frameCursor < this->totalFrameCount) {
+      addSeekPoint();
+
+      std::uint64_t previousFrameCursor = this->frameCursor;
+      bool wasProcessed = Platform::FlacApi::ProcessSingle(this->streamDecoder);
+
+      FileAdapterState::RethrowPotentialException(*state);
+      if(static_cast<bool>(this->error)) {
+        std::rethrow_exception(this->error);
+      }
+
+      if(!wasProcessed || (this->frameCursor == previousFrameCursor)) {
+        throw Errors::CorruptedFileError(
+          u8"FLAC audio file did not provide all announced samples. File truncated?"
+        );
+      }
+    }
+
+    this->seekTable->MarkComplete();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void FlacReader::DecodeSeparated(
     void *userPointer,
     ProcessDecodedSamplesFunction *processDecodedSamples,
@@ -325,16 +424,29 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     // will invoke the audio decode callback as if ProcessSingle() was called (which it is
     // internally!) and that will be the only chance to grab the first audio block.
     if(this->scheduledSeekPosition.has_value()) {
-      this->frameCursor = this->scheduledSeekPosition.value();
+      if(this->scheduledCheckpoint.has_value()) {
+        Platform::FlacApi::Flush(this->streamDecoder);
+        this->state->FileCursor = this->scheduledCheckpoint->ByteOffset;
+        this->frameCursor = this->scheduledCheckpoint->ResumeFrameIndex;
+        this->discardFrameCount = (
+          this->scheduledCheckpoint->FrameIndex - this->scheduledCheckpoint->ResumeFrameIndex
+        );
+        this->scheduledCheckpoint.reset();
+      } else if(!trySeekViaSeekTable(this->scheduledSeekPosition.value())) {
+        this->frameCursor = this->scheduledSeekPosition.value();
+        this->discardFrameCount = 0;
 
-      // !! This includes an automatic call to Platform::FlacApi::ProcessSingle() !!
-      Platform::FlacApi::SeekAbsolute(this->streamDecoder, this->frameCursor);
+        // !! This includes an automatic call to Platform::FlacApi::ProcessSingle() !!
+        Platform::FlacApi::SeekAbsolute(this->streamDecoder, this->frameCursor);
 
-      // Because the above seek attempt will have invoked the decoder callback
-      // and potentially read from the virtual file, check for errors.
-      FileAdapterState::RethrowPotentialException(*state);
-      if(static_cast<bool>(this->error)) {
-        std::rethrow_exception(this->error);
+        // Because the above seek attempt will have invoked the decoder callback
+        // and potentially read from the virtual file, check for errors.
+        FileAdapterState::RethrowPotentialException(*state);
+        if(static_cast<bool>(this->error)) {
+          std::rethrow_exception(this->error);
+        }
+
+        addSeekPoint();
       }
 
       // If we want to make the current seek-calls-process_single behavior of libflac
@@ -370,6 +482,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
           u8"FLAC audio file did not provide all requested samples. File truncated?"
         );
       }
+
+      addSeekPoint();
     }
   }
 
@@ -382,6 +496,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       processStreamInfo(metadata.data.stream_info);
     } else if(metadata.type == FLAC__METADATA_TYPE_VORBIS_COMMENT) {
       processVorbisComment(metadata.data.vorbis_comment);
+    } else if(metadata.type == FLAC__METADATA_TYPE_CUESHEET) {
+      processCueSheet(metadata.data.cue_sheet);
     }
   }
 
@@ -414,6 +530,39 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     );
     this->frameCursor += deliveredFrameCount;
 
+    // If we jumped to a FLAC frame before the seek target via the seek table, the frames
+    // up to the seek target need to be dropped. This can span several FLAC frames.
+    if(unlikely(this->discardFrameCount > 0)) {
+      std::size_t discardedFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(this->discardFrameCount, deliveredFrameCount)
+      );
+      this->discardFrameCount -= discardedFrameCount;
+      if(static_cast<bool>(this->statistics)) {
+        this->statistics->AddDiscardedFrames(discardedFrameCount);
+      }
+      if(discardedFrameCount == deliveredFrameCount) {
+        return true;
+      }
+
+      const ::FLAC__int32 *remainingBuffers[FLAC__MAX_CHANNELS];
+      std::size_t channelCount = std::min<std::size_t>(
+        frame.header.channels, FLAC__MAX_CHANNELS
+      );
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        remainingBuffers[channelIndex] = buffers[channelIndex] + discardedFrameCount;
+      }
+
+      if(this->processDecodedSamplesCallback != nullptr) {
+        this->processDecodedSamplesCallback(
+          this->userPointerForCallback,
+          remainingBuffers,
+          deliveredFrameCount - discardedFrameCount
+        );
+      }
+
+      return true;
+    }
+
     // If we're decoding (rather than just snatching the channel assignment for our metadata),
     // deliver the decoded samples to the callback.
     if(this->processDecodedSamplesCallback != nullptr) {
@@ -469,9 +618,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       this->trackInfo->Duration = std::chrono::microseconds(
         streamInfo.total_samples * MicrosecondsPerSecond / streamInfo.sample_rate
       );
+      this->trackInfo->FrameCount = streamInfo.total_samples;
     }
 
     this->totalFrameCount = streamInfo.total_samples;
+    this->blockSize = static_cast<std::size_t>(streamInfo.max_blocksize);
+    this->hasFixedBlockSize = (
+      (streamInfo.min_blocksize == streamInfo.max_blocksize) && (this->blockSize > 0)
+    );
     this->obtainedMetadata = true;
   }
 
@@ -490,11 +644,19 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     // Iterate over all Vorbis comment tags. These generally are just a string each,
     // but by convention that string is in the format 'key=value' for named properties,
     // such as the file's title or the all-important custom channel mask.
+    Shared::LoopTagParser loopTags;
+    Shared::GainTagParser gainTags;
     for(std::size_t index = 0; index < vorbisComment.num_comments; ++index) {
       std::string_view comment(
         reinterpret_cast<char *>(vorbisComment.comments[index].entry),
         vorbisComment.comments[index].length
       );
+      if(this->includeTags) {
+        loopTags.ProcessComment(comment);
+      }
+
+      // Gains are collected even without tags because the decoder can apply them
+      gainTags.ProcessComment(comment);
 
       // Does this comment look like a 'key=value' assignment?
       std::string_view::size_type assignmentIndex = comment.find(u8'=');
@@ -517,6 +679,106 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
         }
       }
     }
+
+    this->trackInfo->ReplayGain = gainTags.GetReplayGain();
+
+    // STREAMINFO is always the first metadata block, so the frame count is known here
+    if(this->includeTags) {
+      this->trackInfo->Loop = loopTags.GetLoop(this->totalFrameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::processCueSheet(const ::FLAC__StreamMetadata_CueSheet &cueSheet) noexcept {
+    if((this->trackInfo == nullptr) || !this->includeTags || (cueSheet.num_tracks == 0)) {
+      return;
+    }
+
+    // The last track is the lead-out, it has no indices and only marks where the audio
+    // of the track before it ends. All other tracks become markers, tracks are required
+    // to be in ascending order, so the markers come out sorted.
+    std::size_t trackCount = cueSheet.num_tracks - 1;
+    for(std::size_t index = 0; index < trackCount; ++index) {
+      const ::FLAC__StreamMetadata_CueSheet_Track &track = cueSheet.tracks[index];
+      if(track.num_indices == 0) {
+        continue;
+      }
+
+      // INDEX 00 is the pre-gap, INDEX 01 is where the track actually begins
+      std::uint64_t startOffset = track.indices[0].offset;
+      for(std::size_t indexIndex = 0; indexIndex < track.num_indices; ++indexIndex) {
+        if(track.indices[indexIndex].number == 1) {
+          startOffset = track.indices[indexIndex].offset;
+          break;
+        }
+      }
+
+      Marker &marker = this->trackInfo->Markers.emplace_back();
+      marker.Id = track.number;
+      marker.StartFrame = track.offset + startOffset;
+
+      std::uint64_t endFrame = cueSheet.tracks[index + 1].offset;
+      if(endFrame > marker.StartFrame) {
+        marker.FrameCount = endFrame - marker.StartFrame;
+      } else {
+        marker.FrameCount = 0;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacReader::trySeekViaSeekTable(std::uint64_t frameIndex) {
+    if(!static_cast<bool>(this->seekTable)) {
+      return false;
+    }
+
+    std::optional<FlacSeekTable::Entry> seekPoint = this->seekTable->TryFindSeekPoint(
+      frameIndex
+    );
+    if(!seekPoint.has_value()) {
+      return false;
+    }
+
+    // If the decoder already is between the seek point and the target, it is faster
+    // to just keep decoding from where it is.
+    bool isAlreadyCloser = (
+      (this->frameCursor >= seekPoint->SampleNumber) && (this->frameCursor <= frameIndex)
+    );
+    if(!isAlreadyCloser) {
+
+      // Flushing makes libflac throw away its buffered input and search for the next
+      // frame sync code. Moving our emulated file cursor means it will find the sync code
+      // of the FLAC frame the seek point describes right at the start of its next read.
+      Platform::FlacApi::Flush(this->streamDecoder);
+      this->state->FileCursor = seekPoint->ByteOffset;
+      this->frameCursor = seekPoint->SampleNumber;
+
+    }
+
+    this->discardFrameCount = frameIndex - this->frameCursor;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacReader::addSeekPoint() {
+    if(!static_cast<bool>(this->seekTable) || (this->frameCursor >= this->totalFrameCount)) {
+      return;
+    }
+
+    // After libflac returns from decoding, its decode position is the end of the FLAC frame
+    // it just decoded, which is where the FLAC frame holding the frame cursor begins.
+    std::optional<std::uint64_t> byteOffset = (
+      Platform::FlacApi::TryGetDecodePosition(this->streamDecoder)
+    );
+    if(byteOffset.has_value()) {
+      std::uint64_t frameNumber = this->hasFixedBlockSize ? (
+        this->frameCursor / this->blockSize
+      ) : this->frameCursor;
+      this->seekTable->AddSeekPoint(frameNumber, this->frameCursor, byteOffset.value());
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
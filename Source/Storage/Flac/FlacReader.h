@@ -28,6 +28,7 @@ limitations under the License.
 #include "Nuclex/Audio/ChannelPlacement.h"
 
 #include "./FlacVirtualFileAdapter.h" // for the FlacDecodeProcessor interface
+#include "../Shared/DecoderCheckpoint.h" // for DecoderCheckpoint
 
 #include <optional> // for std::optional
 
@@ -41,11 +42,22 @@ namespace Nuclex { namespace Audio {
 
 }} // namespace Nuclex::Audio
 
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class DecoderStatisticsCollector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
 namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
   struct ReadOnlyFileAdapterState;
+  class FlacSeekTable;
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -127,12 +139,25 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
     /// <summary>Reads the FLAC file's metadata</summary>
     /// <param name="target">Track informatio container that will receive the metadata</param>
-    public: void ReadMetadata(TrackInfo &target);
+    /// <param name="includeTags">
+    ///   Whether to collect loop points and cue sheet markers. Decoders don't expose
+    ///   the track information and pass false to skip that work when opening.
+    /// </param>
+    public: void ReadMetadata(TrackInfo &target, bool includeTags = true);
 
     /// <summary>Counts the total number of frames (= samples in each channel)</summary>
     /// <returns>The total number of frames in the audio file</returns>
     public: std::uint64_t CountTotalFrames() const;
 
+    /// <summary>Returns the number of frames stored in each FLAC frame</summary>
+    /// <returns>The largest number of frames any FLAC frame in the file holds</returns>
+    /// <remarks>
+    ///   Nearly all FLAC files use a fixed block size, in which case every FLAC frame
+    ///   except the last one holds exactly this many frames. Files with variable block
+    ///   sizes are allowed by the format, but rarely produced by any encoder.
+    /// </remarks>
+    public: std::size_t GetBlockSize() const;
+
     /// <summary>Retrieves the current position of the frame cursor</summary>
     /// <returns>The frame cursor, pointing at the frame that will be decoded next</returns>
     public: std::uint64_t GetFrameCursorPosition() const;
@@ -141,6 +166,41 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     /// <param name="frameIndex">Index of the frame (= sample index on all channels)</param>
     public: void Seek(std::uint64_t frameIndex);
 
+    /// <summary>Moves the frame cursor to a frame and records how to return there</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <returns>A checkpoint through which the reader can quickly return to the frame</returns>
+    /// <remarks>
+    ///   The checkpoint is taken from the seek table. Without a seek point in front of
+    ///   the frame, the checkpoint is indirect and restoring it does a normal seek.
+    /// </remarks>
+    public: Shared::DecoderCheckpoint Checkpoint(std::uint64_t frameIndex);
+
+    /// <summary>Moves the frame cursor back to a checkpoint's frame</summary>
+    /// <param name="checkpoint">Checkpoint previously returned by Checkpoint()</param>
+    public: void Restore(const Shared::DecoderCheckpoint &checkpoint);
+
+    /// <summary>Lets the reader use and extend a seek table for the file</summary>
+    /// <param name="seekTable">Seek table the reader will use when seeking</param>
+    /// <remarks>
+    ///   The seek table may be shared between multiple readers on the same file.
+    ///   Readers will add a seek point to it for each FLAC frame they decode.
+    /// </remarks>
+    public: void UseSeekTable(const std::shared_ptr<FlacSeekTable> &seekTable);
+
+    /// <summary>Lets the reader report discarded frames to a statistics collector</summary>
+    /// <param name="statistics">Collector that will track the discarded frames</param>
+    public: void UseStatistics(
+      const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+    );
+
+    /// <summary>Decodes the rest of the file to complete the seek table</summary>
+    /// <remarks>
+    ///   This is intended for a reader that has been opened specifically to build
+    ///   the seek table. It decodes all remaining FLAC frames without delivering
+    ///   their samples anywhere and marks the seek table as complete afterwards.
+    /// </remarks>
+    public: void BuildSeekTable();
+
     /// <summary>Decodes the requested number of samples</summary>
     /// <param name="buffers">Buffers into which the samples will be decoded</param>
     /// <param name="processDecodedSamples">
@@ -186,6 +246,29 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       const ::FLAC__StreamMetadata_VorbisComment &vorbisComment
     ) noexcept;
 
+    /// <summary>Processes a cue sheet block encountered in the FLAC file</summary>
+    /// <param name="cueSheet">Cue sheet block listing the tracks and their indices</param>
+    /// <remarks>
+    ///   Each track of the cue sheet becomes a region marker starting at its INDEX 01
+    ///   (or its first index if there is none) and extending to the next track.
+    /// </remarks>
+    private: void processCueSheet(
+      const ::FLAC__StreamMetadata_CueSheet &cueSheet
+    ) noexcept;
+
+    /// <summary>Tries to jump close to the specified frame via the seek table</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <returns>True if the seek table had a seek point close enough to jump to</returns>
+    /// <remarks>
+    ///   Unlike libflac's seek, this will not decode anything right away. Instead, it
+    ///   places the stream decoder before the closest FLAC frame and sets up the reader
+    ///   to discard the frames that lie between that FLAC frame and the target.
+    /// </remarks>
+    private: bool trySeekViaSeekTable(std::uint64_t frameIndex);
+
+    /// <summary>Records the FLAC frame that will be decoded next in the seek table</summary>
+    private: void addSeekPoint();
+
     /// <summary>File the reader is accessing</summary>
     private: std::shared_ptr<const VirtualFile> file;
     /// <summary>State (emulated file cursor, errors) of the virtual file adapter</summary>
@@ -203,13 +286,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     private: std::optional<::FLAC__ChannelAssignment> channelAssignment;
     /// <summary>Total number of frames (= samples in each channel) in the file</summary>
     private: std::uint64_t totalFrameCount;
+    /// <summary>Maximum number of frames in a FLAC frame as stated by the stream info</summary>
+    private: std::size_t blockSize;
+    /// <summary>Whether all FLAC frames, except the last, hold the same number of frames</summary>
+    private: bool hasFixedBlockSize;
 
     /// <summary>Target track information container for meta data</summary>
     private: Nuclex::Audio::TrackInfo *trackInfo;
+    /// <summary>Whether loop points and markers should be collected for the metadata</summary>
+    private: bool includeTags;
     /// <summary>Current assumed position of the stream decoder's cursor</summary>
     private: std::uint64_t frameCursor;
     /// <summary>Absolute frame index from which the next decode should start</summary>
     private: std::optional<std::uint64_t> scheduledSeekPosition;
+    /// <summary>Checkpoint through which the scheduled seek should be done, if any</summary>
+    private: std::optional<Shared::DecoderCheckpoint> scheduledCheckpoint;
+    /// <summary>Number of decoded frames to drop before delivering any to the callback</summary>
+    private: std::uint64_t discardFrameCount;
+    /// <summary>Seek table used to jump close to a frame, may be empty</summary>
+    private: std::shared_ptr<FlacSeekTable> seekTable;
+    /// <summary>Collects statistics about the reader's work, may be empty</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
     /// <summary>User pointer that will be delivered to the callback</summary>
     private: void *userPointerForCallback;
     /// <summary>Callback that should be invoked to handle the decoded samples</summary>
@@ -0,0 +1,479 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacRemuxer.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./FlacFrameScanner.h"
+#include "./FlacTrackDecoder.h"
+#include "../../Platform/FlacEncoderApi.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <exception> // for std::exception_ptr
+#include <limits> // for std::numeric_limits
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the STREAMINFO metadata block, without its 4 byte header</summary>
+  const std::size_t StreamInfoSize = 34;
+
+  /// <summary>Metadata block type of the seek table</summary>
+  const std::uint8_t SeekTableBlockType = 3;
+
+  /// <summary>Metadata block type of the cue sheet</summary>
+  const std::uint8_t CueSheetBlockType = 5;
+
+  /// <summary>Smallest number of samples FLAC allows in any frame but the last</summary>
+  const std::size_t MinimumBlockSize = 16;
+
+  /// <summary>Largest number of samples a frame may have in the streamable subset</summary>
+  const std::size_t MaximumSubsetBlockSize = 4608;
+
+  /// <summary>Compression level at which the partial edge frames are encoded again</summary>
+  /// <remarks>
+  ///   Only a few thousand samples are ever encoded, so the slowest setting costs nothing
+  ///   noticeable and keeps the re-encoded frames as small as possible.
+  /// </remarks>
+  const unsigned EdgeCompressionLevel = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frames produced by libFLAC when encoding the samples of an edge frame</summary>
+  struct EncodedFrames {
+
+    /// <summary>Encoded frames, one after another</summary>
+    public: std::vector<std::byte> Data;
+    /// <summary>Length and sample count of each frame in the data</summary>
+    public: std::vector<std::pair<std::size_t, std::size_t>> Frames;
+    /// <summary>Exception that occurred inside the write callback, if any</summary>
+    public: std::exception_ptr Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects the frames libFLAC produces when encoding edge samples</summary>
+  /// <param name="encoder">Encoder that produced the data</param>
+  /// <param name="buffer">Encoded data, either a frame or the stream header</param>
+  /// <param name="bytes">Number of bytes in the buffer</param>
+  /// <param name="samples">Number of samples in the frame, 0 for stream headers</param>
+  /// <param name="currentFrame">Index of the frame (unused)</param>
+  /// <param name="framesAsVoid">EncodedFrames instance receiving the frame</param>
+  /// <returns>Whether the data could be stored</returns>
+  ::FLAC__StreamEncoderWriteStatus collectEncodedFrame(
+    const ::FLAC__StreamEncoder *encoder,
+    const ::FLAC__byte buffer[], size_t bytes,
+    std::uint32_t samples, std::uint32_t currentFrame,
+    void *framesAsVoid
+  ) {
+    (void)encoder;
+    (void)currentFrame;
+
+    // The stream header is only needed by the remuxer when writing its own
+    if(samples == 0) {
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+    }
+
+    EncodedFrames &frames = *reinterpret_cast<EncodedFrames *>(framesAsVoid);
+    try {
+      const std::byte *data = reinterpret_cast<const std::byte *>(buffer);
+      frames.Data.insert(frames.Data.end(), data, data + bytes);
+      frames.Frames.emplace_back(bytes, samples);
+    }
+    catch(const std::exception &) {
+      frames.Error = std::current_exception();
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+    }
+
+    return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a FLAC stream from frames taken out of other FLAC streams</summary>
+  class FlacStreamWriter {
+
+    /// <summary>Initializes a new FLAC stream writer and writes the metadata blocks</summary>
+    /// <param name="target">File the FLAC stream will be written into</param>
+    /// <param name="format">Scanner for the FLAC stream providing format and metadata</param>
+    public: FlacStreamWriter(
+      Nuclex::Audio::Storage::VirtualFile &target,
+      const Nuclex::Audio::Storage::Flac::FlacFrameScanner &format
+    );
+
+    /// <summary>Returns the number of samples (per channel) written so far</summary>
+    /// <returns>The number of samples in the frames written so far</returns>
+    public: std::uint64_t CountWrittenSamples() const { return this->writtenSampleCount; }
+
+    /// <summary>Returns the number of channels in the stream being written</summary>
+    /// <returns>The number of channels in the stream</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of valid bits in each sample</summary>
+    /// <returns>The number of valid bits per sample</returns>
+    public: std::size_t GetBitsPerSample() const { return this->bitsPerSample; }
+
+    /// <summary>Returns the playback rate of the stream being written</summary>
+    /// <returns>The playback rate in samples per second</returns>
+    public: std::size_t GetSampleRate() const { return this->sampleRate; }
+
+    /// <summary>Appends a frame taken from another FLAC stream</summary>
+    /// <param name="frame">Frame that will be appended</param>
+    /// <param name="length">Length of the frame in bytes</param>
+    /// <param name="sampleCount">Number of samples (per channel) in the frame</param>
+    public: void AppendFrame(const std::byte *frame, std::size_t length, std::size_t sampleCount);
+
+    /// <summary>Encodes and appends samples that didn't fill a whole source frame</summary>
+    /// <param name="samples">Interleaved, left-aligned samples</param>
+    /// <param name="sampleCount">Number of samples (per channel) that will be encoded</param>
+    public: void AppendSamples(std::vector<std::int32_t> &samples, std::size_t sampleCount);
+
+    /// <summary>Rewrites the STREAMINFO block with the final sizes and sample count</summary>
+    public: void Finish();
+
+    /// <summary>File the FLAC stream is being written into</summary>
+    private: Nuclex::Audio::Storage::VirtualFile &target;
+    /// <summary>Offset at which the next frame will be written</summary>
+    private: std::uint64_t fileCursor;
+    /// <summary>Contents of the STREAMINFO block copied from the source</summary>
+    private: std::vector<std::byte> streamInfo;
+    /// <summary>Number of channels in the stream</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of valid bits in each sample</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Playback rate in samples per second</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Number of samples (per channel) written so far</summary>
+    private: std::uint64_t writtenSampleCount;
+    /// <summary>Smallest block size of all frames except the last one</summary>
+    private: std::size_t minimumBlockSize;
+    /// <summary>Largest block size of all frames</summary>
+    private: std::size_t maximumBlockSize;
+    /// <summary>Block size of the frame written last</summary>
+    private: std::size_t lastBlockSize;
+    /// <summary>Length of the shortest frame in bytes</summary>
+    private: std::size_t minimumFrameSize;
+    /// <summary>Length of the longest frame in bytes</summary>
+    private: std::size_t maximumFrameSize;
+    /// <summary>Buffer holding the renumbered frame before it is written</summary>
+    private: std::vector<std::byte> renumberedFrame;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacStreamWriter::FlacStreamWriter(
+    Nuclex::Audio::Storage::VirtualFile &target,
+    const Nuclex::Audio::Storage::Flac::FlacFrameScanner &format
+  ) :
+    target(target),
+    fileCursor(0),
+    streamInfo(format.GetMetadataBlocks().front().Data),
+    channelCount(format.CountChannels()),
+    bitsPerSample(format.GetBitsPerSample()),
+    sampleRate(format.GetSampleRate()),
+    writtenSampleCount(0),
+    minimumBlockSize(std::numeric_limits<std::size_t>::max()),
+    maximumBlockSize(0),
+    lastBlockSize(0),
+    minimumFrameSize(std::numeric_limits<std::size_t>::max()),
+    maximumFrameSize(0),
+    renumberedFrame() {
+    using Nuclex::Audio::Storage::Flac::FlacFrameScanner;
+
+    // Seek points and cue sheet track offsets would point into the wrong places,
+    // everything else (tags, pictures, padding and application data) can stay
+    std::vector<const FlacFrameScanner::MetadataBlock *> keptBlocks;
+    for(const FlacFrameScanner::MetadataBlock &block : format.GetMetadataBlocks()) {
+      bool isKept = (
+        (block.Type != SeekTableBlockType) &&
+        (block.Type != CueSheetBlockType)
+      );
+      if(isKept) {
+        keptBlocks.push_back(&block);
+      }
+    }
+
+    std::vector<std::byte> header;
+    header.push_back(std::byte(u8'f'));
+    header.push_back(std::byte(u8'L'));
+    header.push_back(std::byte(u8'a'));
+    header.push_back(std::byte(u8'C'));
+    for(std::size_t index = 0; index < keptBlocks.size(); ++index) {
+      std::size_t blockLength = keptBlocks[index]->Data.size();
+      bool isLast = (index + 1 == keptBlocks.size());
+
+      header.push_back(static_cast<std::byte>(keptBlocks[index]->Type | (isLast ? 0x80 : 0x00)));
+      header.push_back(static_cast<std::byte>((blockLength >> 16) & 0xFF));
+      header.push_back(static_cast<std::byte>((blockLength >> 8) & 0xFF));
+      header.push_back(static_cast<std::byte>(blockLength & 0xFF));
+      header.insert(header.end(), keptBlocks[index]->Data.begin(), keptBlocks[index]->Data.end());
+    }
+
+    this->target.WriteAt(0, header.size(), header.data());
+    this->fileCursor = header.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacStreamWriter::AppendFrame(
+    const std::byte *frame, std::size_t length, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Storage::Flac::FlacFrameScanner;
+
+    FlacFrameScanner::RenumberFrame(
+      frame, length, this->writtenSampleCount, this->renumberedFrame
+    );
+    this->target.WriteAt(
+      this->fileCursor, this->renumberedFrame.size(), this->renumberedFrame.data()
+    );
+    this->fileCursor += this->renumberedFrame.size();
+    this->writtenSampleCount += sampleCount;
+
+    // The minimum block size excludes the last frame, which is allowed to be shorter.
+    // Only when a frame follows is it certain that the previous one was not the last.
+    if(this->lastBlockSize != 0) {
+      this->minimumBlockSize = std::min(this->minimumBlockSize, this->lastBlockSize);
+    }
+    this->lastBlockSize = sampleCount;
+    this->maximumBlockSize = std::max(this->maximumBlockSize, sampleCount);
+
+    this->minimumFrameSize = std::min(this->minimumFrameSize, this->renumberedFrame.size());
+    this->maximumFrameSize = std::max(this->maximumFrameSize, this->renumberedFrame.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacStreamWriter::AppendSamples(
+    std::vector<std::int32_t> &samples, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Platform::FlacEncoderApi;
+
+    // Decoded samples are left-aligned, libFLAC wants them in the lower end
+    std::size_t shift = 32 - this->bitsPerSample;
+    for(std::int32_t &sample : samples) {
+      sample >>= shift;
+    }
+
+    // Spread the samples evenly so that no frame falls below the minimum block size
+    std::size_t frameCount = (sampleCount + MaximumSubsetBlockSize - 1) / MaximumSubsetBlockSize;
+    std::size_t blockSize = (sampleCount + frameCount - 1) / frameCount;
+
+    EncodedFrames frames;
+    {
+      std::shared_ptr<::FLAC__StreamEncoder> encoder = FlacEncoderApi::NewStreamEncoder();
+      FlacEncoderApi::SetFormat(
+        encoder, this->channelCount, this->bitsPerSample, this->sampleRate
+      );
+      FlacEncoderApi::SetCompressionLevel(encoder, EdgeCompressionLevel);
+      FlacEncoderApi::SetBlockSize(encoder, std::max(blockSize, MinimumBlockSize));
+      FlacEncoderApi::EnableMd5Calculation(encoder, false);
+
+      FlacEncoderApi::InitStream(
+        frames.Error, encoder, &collectEncodedFrame, nullptr, nullptr, &frames
+      );
+      FlacEncoderApi::ProcessInterleaved(frames.Error, encoder, samples.data(), sampleCount);
+      FlacEncoderApi::Finish(frames.Error, encoder);
+    }
+
+    const std::byte *frame = frames.Data.data();
+    for(const std::pair<std::size_t, std::size_t> &lengthAndSampleCount : frames.Frames) {
+      AppendFrame(frame, lengthAndSampleCount.first, lengthAndSampleCount.second);
+      frame += lengthAndSampleCount.first;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacStreamWriter::Finish() {
+    if(this->minimumBlockSize == std::numeric_limits<std::size_t>::max()) {
+      this->minimumBlockSize = this->lastBlockSize;
+    }
+    if(this->minimumFrameSize == std::numeric_limits<std::size_t>::max()) {
+      this->minimumFrameSize = 0;
+    }
+
+    // Minimum and maximum block size, 16 bits each
+    std::byte *info = this->streamInfo.data();
+    info[0] = static_cast<std::byte>((this->minimumBlockSize >> 8) & 0xFF);
+    info[1] = static_cast<std::byte>(this->minimumBlockSize & 0xFF);
+    info[2] = static_cast<std::byte>((this->maximumBlockSize >> 8) & 0xFF);
+    info[3] = static_cast<std::byte>(this->maximumBlockSize & 0xFF);
+
+    // Minimum and maximum frame size, 24 bits each
+    info[4] = static_cast<std::byte>((this->minimumFrameSize >> 16) & 0xFF);
+    info[5] = static_cast<std::byte>((this->minimumFrameSize >> 8) & 0xFF);
+    info[6] = static_cast<std::byte>(this->minimumFrameSize & 0xFF);
+    info[7] = static_cast<std::byte>((this->maximumFrameSize >> 16) & 0xFF);
+    info[8] = static_cast<std::byte>((this->maximumFrameSize >> 8) & 0xFF);
+    info[9] = static_cast<std::byte>(this->maximumFrameSize & 0xFF);
+
+    // The lower 4 bits of byte 13 and the following 4 bytes hold the 36 bit total
+    std::uint64_t totalSampleCount = this->writtenSampleCount;
+    if(totalSampleCount >= (std::uint64_t(1) << 36)) {
+      totalSampleCount = 0;
+    }
+    info[13] = static_cast<std::byte>(
+      (static_cast<std::uint8_t>(info[13]) & 0xF0) | (totalSampleCount >> 32)
+    );
+    info[14] = static_cast<std::byte>((totalSampleCount >> 24) & 0xFF);
+    info[15] = static_cast<std::byte>((totalSampleCount >> 16) & 0xFF);
+    info[16] = static_cast<std::byte>((totalSampleCount >> 8) & 0xFF);
+    info[17] = static_cast<std::byte>(totalSampleCount & 0xFF);
+
+    // The MD5 signature of the source doesn't match, all zero means 'not calculated'
+    for(std::size_t index = 18; index < StreamInfoSize; ++index) {
+      info[index] = std::byte(0);
+    }
+
+    // STREAMINFO is always the first block, right after the 4 byte marker and its header
+    this->target.WriteAt(8, StreamInfoSize, info);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t FlacRemuxer::Trim(
+    const std::shared_ptr<const VirtualFile> &source,
+    std::uint64_t startFrame, std::uint64_t frameCount,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    FlacFrameScanner scanner(*source);
+
+    std::uint64_t endSample = startFrame + frameCount;
+    if(scanner.CountTotalSamples() != 0) {
+      endSample = std::min(endSample, scanner.CountTotalSamples());
+    }
+
+    FlacFrameScanner::Frame frame = scanner.FindFrame(startFrame);
+
+    FlacStreamWriter writer(*target, scanner);
+    std::shared_ptr<FlacTrackDecoder> decoder;
+    std::vector<std::byte> frameData;
+    std::vector<std::int32_t> samples;
+
+    std::uint64_t position = startFrame;
+    while(position < endSample) {
+      std::uint64_t frameEnd = frame.FirstSample + frame.SampleCount;
+
+      // Frames completely inside the clip are copied, only their header changes
+      bool isWholeFrame = (position == frame.FirstSample) && (frameEnd <= endSample);
+      if(isWholeFrame) {
+        frameData.resize(frame.Length);
+        source->ReadAt(frame.Offset, frame.Length, frameData.data());
+        writer.AppendFrame(frameData.data(), frame.Length, frame.SampleCount);
+        position = frameEnd;
+      } else {
+        std::uint64_t pieceEnd = std::min(frameEnd, endSample);
+
+        // Only the last frame may be shorter than 16 samples, so if the clip starts
+        // near the end of a frame, the next frame is encoded together with it
+        while((pieceEnd - position < MinimumBlockSize) && (pieceEnd < endSample)) {
+          if(!scanner.TryReadFrame(frame.Offset + frame.Length, frame)) {
+            break;
+          }
+          pieceEnd = std::min(frame.FirstSample + frame.SampleCount, endSample);
+        }
+
+        if(!decoder) {
+          decoder = std::make_shared<FlacTrackDecoder>(source);
+        }
+
+        std::size_t pieceLength = static_cast<std::size_t>(pieceEnd - position);
+        samples.resize(pieceLength * scanner.CountChannels());
+        decoder->DecodeInterleaved<std::int32_t>(samples.data(), position, pieceLength);
+        writer.AppendSamples(samples, pieceLength);
+        position = pieceEnd;
+      }
+
+      if(position < endSample) {
+        if(!scanner.TryReadFrame(frame.Offset + frame.Length, frame)) {
+          break; // Stream ended before the stated total sample count
+        }
+      }
+    }
+
+    writer.Finish();
+    return writer.CountWrittenSamples();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacRemuxer::Concatenate(
+    const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(sources.empty()) {
+      throw std::invalid_argument(u8"At least one FLAC file needs to be specified for joining");
+    }
+
+    std::unique_ptr<FlacStreamWriter> writer;
+    std::vector<std::byte> frameData;
+    for(const std::shared_ptr<const VirtualFile> &source : sources) {
+      FlacFrameScanner scanner(*source);
+
+      // Frames carry their format in their headers, but the stream info block
+      // can only describe a single one and decoders will reject frames that differ
+      if(!writer) {
+        writer = std::make_unique<FlacStreamWriter>(*target, scanner);
+      } else {
+        bool isSameFormat = (
+          (scanner.CountChannels() == writer->CountChannels()) &&
+          (scanner.GetBitsPerSample() == writer->GetBitsPerSample()) &&
+          (scanner.GetSampleRate() == writer->GetSampleRate())
+        );
+        if(!isSameFormat) {
+          throw Errors::UnsupportedFormatError(
+            u8"FLAC files to be joined need the same channels, bit depth and sample rate"
+          );
+        }
+      }
+
+      FlacFrameScanner::Frame frame;
+      std::uint64_t offset = scanner.GetFirstFrameOffset();
+      while(scanner.TryReadFrame(offset, frame, &frameData)) {
+        writer->AppendFrame(frameData.data(), frame.Length, frame.SampleCount);
+        offset = frame.Offset + frame.Length;
+      }
+    }
+
+    writer->Finish();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,94 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACREMUXER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACREMUXER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cuts and joins FLAC streams by copying their frames</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Frames that lie completely inside the requested range are copied with only their
+  ///     frame header rewritten. Because the first frame of a cut rarely begins at a frame
+  ///     boundary of the source, the output always uses FLAC's variable block size
+  ///     strategy, in which each frame header states the index of its first sample.
+  ///   </para>
+  ///   <para>
+  ///     Only the partial frames at either end of a cut are decoded and encoded again.
+  ///     Since FLAC is lossless, this yields exactly the same samples.
+  ///   </para>
+  ///   <para>
+  ///     The metadata blocks of the (first) source are carried over, except for the seek
+  ///     table and cue sheet which would point to the wrong places. The MD5 signature in
+  ///     the stream info block is cleared because computing it would require decoding
+  ///     the whole stream.
+  ///   </para>
+  /// </remarks>
+  class FlacRemuxer {
+
+    /// <summary>Copies a range of samples from a FLAC file into a new FLAC file</summary>
+    /// <param name="source">FLAC file the clip will be taken from</param>
+    /// <param name="startFrame">Index of the first audio frame the clip will contain</param>
+    /// <param name="frameCount">Number of audio frames the clip will contain</param>
+    /// <param name="target">File the clip will be written into</param>
+    /// <returns>The number of audio frames in the clip that was written</returns>
+    public: static std::uint64_t Trim(
+      const std::shared_ptr<const VirtualFile> &source,
+      std::uint64_t startFrame, std::uint64_t frameCount,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+    /// <summary>Joins several FLAC files into a single FLAC file</summary>
+    /// <param name="sources">FLAC files that will be joined in the order given</param>
+    /// <param name="target">File the joined FLAC stream will be written into</param>
+    public: static void Concatenate(
+      const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACREMUXER_H
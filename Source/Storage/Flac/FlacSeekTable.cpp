@@ -0,0 +1,262 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacSeekTable.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../EndianReader.h"
+
+#include <algorithm> // for std::upper_bound()
+#include <cstring> // for std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How many sample intervals a seek point may lie before the target</summary>
+  /// <remarks>
+  ///   A seek table that is filled while decoding can have gaps wherever the user
+  ///   skipped over parts of the file. If the closest seek point is further away than
+  ///   this, the table doesn't cover the target and libflac's own search is used.
+  /// </remarks>
+  const std::uint64_t MaximumSeekPointDistanceInIntervals = 2;
+
+  /// <summary>Identifies serialized seek tables</summary>
+  const char SerializedTableMagic[4] = { 'F', 'l', 'a', 'X' };
+
+  /// <summary>Version of the serialized seek table format</summary>
+  const std::uint32_t SerializedTableVersion = 1;
+
+  /// <summary>Size of the serialized seek table's header, up to the first entry</summary>
+  const std::size_t SerializedHeaderSize = 4 + 4 + 8 + 8 + 1 + 8;
+
+  /// <summary>Size of a single serialized seek point</summary>
+  const std::size_t SerializedEntrySize = 8 + 8 + 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer to a buffer in little endian format</summary>
+  /// <typeparam name="TInteger">Type of integer that will be appended</typeparam>
+  /// <param name="buffer">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  template<typename TInteger>
+  void appendLittleEndian(std::vector<std::byte> &buffer, TInteger value) {
+    for(std::size_t index = 0; index < sizeof(TInteger); ++index) {
+      buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacSeekTable::FlacSeekTable(std::uint64_t fileSize, std::uint64_t sampleInterval) :
+    sampleInterval(sampleInterval),
+    fileSize(fileSize),
+    complete(false),
+    entries(),
+    tableMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacSeekTable::IsComplete() const {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+    return this->complete;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacSeekTable::MarkComplete() {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+    this->complete = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacSeekTable::AddSeekPoint(
+    std::uint64_t frameNumber, std::uint64_t sampleNumber, std::uint64_t byteOffset
+  ) {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+
+    std::vector<Entry>::iterator next = std::upper_bound(
+      this->entries.begin(), this->entries.end(), sampleNumber,
+      [](std::uint64_t sampleNumber, const Entry &entry) {
+        return sampleNumber < entry.SampleNumber;
+      }
+    );
+
+    // Only add the seek point if it isn't too close to its neighbours. This keeps
+    // the table from growing with each decoded frame and the seek points evenly spaced.
+    if(next != this->entries.end()) {
+      if(next->SampleNumber - sampleNumber < this->sampleInterval) {
+        return;
+      }
+    }
+    if(next != this->entries.begin()) {
+      std::vector<Entry>::iterator previous = next - 1;
+      if(sampleNumber - previous->SampleNumber < this->sampleInterval) {
+        return;
+      }
+    }
+
+    this->entries.insert(next, Entry { frameNumber, sampleNumber, byteOffset });
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<FlacSeekTable::Entry> FlacSeekTable::TryFindSeekPoint(
+    std::uint64_t sampleNumber
+  ) const {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+
+    std::vector<Entry>::const_iterator entry = std::upper_bound(
+      this->entries.begin(), this->entries.end(), sampleNumber,
+      [](std::uint64_t sampleNumber, const Entry &entry) {
+        return sampleNumber < entry.SampleNumber;
+      }
+    );
+    if(entry == this->entries.begin()) {
+      return std::optional<Entry>();
+    }
+
+    --entry;
+
+    std::uint64_t distance = sampleNumber - entry->SampleNumber;
+    if(distance > this->sampleInterval * MaximumSeekPointDistanceInIntervals) {
+      return std::optional<Entry>();
+    }
+
+    return *entry;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t FlacSeekTable::CountSeekPoints() const {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+    return this->entries.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> FlacSeekTable::Serialize() const {
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+
+    std::vector<std::byte> serializedTable;
+    serializedTable.reserve(SerializedHeaderSize + this->entries.size() * SerializedEntrySize);
+
+    for(std::size_t index = 0; index < sizeof(SerializedTableMagic); ++index) {
+      serializedTable.push_back(static_cast<std::byte>(SerializedTableMagic[index]));
+    }
+    appendLittleEndian(serializedTable, SerializedTableVersion);
+    appendLittleEndian(serializedTable, this->sampleInterval);
+    appendLittleEndian(serializedTable, this->fileSize);
+    appendLittleEndian(serializedTable, std::uint8_t(this->complete));
+    appendLittleEndian(serializedTable, static_cast<std::uint64_t>(this->entries.size()));
+
+    for(const Entry &entry : this->entries) {
+      appendLittleEndian(serializedTable, entry.FrameNumber);
+      appendLittleEndian(serializedTable, entry.SampleNumber);
+      appendLittleEndian(serializedTable, entry.ByteOffset);
+    }
+
+    return serializedTable;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacSeekTable::Deserialize(const std::vector<std::byte> &serializedTable) {
+    const std::byte *data = serializedTable.data();
+    if(serializedTable.size() < SerializedHeaderSize) {
+      throw Errors::CorruptedFileError(u8"Serialized FLAC seek table is truncated");
+    }
+    if(std::memcmp(data, SerializedTableMagic, sizeof(SerializedTableMagic)) != 0) {
+      throw Errors::CorruptedFileError(u8"Data is not a serialized FLAC seek table");
+    }
+    if(LittleEndianReader::ReadUInt32(data + 4) != SerializedTableVersion) {
+      throw Errors::CorruptedFileError(u8"Serialized FLAC seek table has unsupported version");
+    }
+
+    std::uint64_t loadedSampleInterval = LittleEndianReader::ReadUInt64(data + 8);
+    if(loadedSampleInterval == 0) {
+      throw Errors::CorruptedFileError(u8"Serialized FLAC seek table has no sample interval");
+    }
+
+    // The file size never changes after construction, so it's safe to read unlocked
+    std::uint64_t serializedFileSize = LittleEndianReader::ReadUInt64(data + 16);
+    if(serializedFileSize != this->fileSize) {
+      throw Errors::CorruptedFileError(u8"Serialized FLAC seek table is for a different file");
+    }
+
+    std::uint64_t entryCount = LittleEndianReader::ReadUInt64(data + 25);
+    std::uint64_t maximumEntryCount = (
+      (serializedTable.size() - SerializedHeaderSize) / SerializedEntrySize
+    );
+    if(entryCount != maximumEntryCount) {
+      throw Errors::CorruptedFileError(u8"Serialized FLAC seek table has wrong length");
+    }
+
+    std::vector<Entry> loadedEntries;
+    loadedEntries.reserve(static_cast<std::size_t>(entryCount));
+    const std::byte *entryData = data + SerializedHeaderSize;
+    for(std::uint64_t index = 0; index < entryCount; ++index) {
+      Entry entry;
+      entry.FrameNumber = LittleEndianReader::ReadUInt64(entryData);
+      entry.SampleNumber = LittleEndianReader::ReadUInt64(entryData + 8);
+      entry.ByteOffset = LittleEndianReader::ReadUInt64(entryData + 16);
+      if(!loadedEntries.empty()) {
+        const Entry &previous = loadedEntries.back();
+        bool isOrdered = (
+          (entry.SampleNumber > previous.SampleNumber) &&
+          (entry.ByteOffset > previous.ByteOffset)
+        );
+        if(!isOrdered) {
+          throw Errors::CorruptedFileError(u8"Serialized FLAC seek table is not ordered");
+        }
+      }
+      if(entry.ByteOffset >= serializedFileSize) {
+        throw Errors::CorruptedFileError(u8"Serialized FLAC seek table points beyond the file");
+      }
+
+      loadedEntries.push_back(entry);
+      entryData += SerializedEntrySize;
+    }
+
+    // Everything checks out, replace the current seek table with the loaded one
+    std::lock_guard<std::mutex> tableMutexScope(this->tableMutex);
+
+    this->sampleInterval = loadedSampleInterval;
+    this->complete = (LittleEndianReader::ReadUInt8(data + 24) != 0);
+    this->entries.swap(loadedEntries);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
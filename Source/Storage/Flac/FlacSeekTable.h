@@ -0,0 +1,147 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACSEEKTABLE_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACSEEKTABLE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::uint64_t
+#include <mutex> // for std::mutex
+#include <optional> // for std::optional
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Remembers where FLAC frames begin in a FLAC file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     FLAC files can contain a SEEKTABLE metadata block, but many encoders leave
+  ///     it out. libflac then finds the frame holding a sample by bisecting the file.
+  ///     This table records the byte offset of a FLAC frame every so often, so a seek
+  ///     can go straight to the closest frame before the target and decode from there.
+  ///   </para>
+  ///   <para>
+  ///     Seek points are added by the reader whenever it decodes a frame, so the table
+  ///     fills up as the file is played, and can be completed by decoding the whole file
+  ///     in one go. It can be serialized and loaded again to avoid building it each time
+  ///     the file is opened.
+  ///   </para>
+  ///   <para>
+  ///     All methods are thread-safe so the table can be shared by several readers
+  ///     decoding the same file.
+  ///   </para>
+  /// </remarks>
+  class FlacSeekTable {
+
+    /// <summary>FLAC frame at which decoding can begin</summary>
+    public: struct Entry {
+
+      /// <summary>Number of the FLAC frame as stored in its header</summary>
+      /// <remarks>
+      ///   For fixed-blocksize streams, this is the frame's ordinal number. Variable
+      ///   blocksize streams number their frames by sample, so there it equals
+      ///   the sample number.
+      /// </remarks>
+      public: std::uint64_t FrameNumber;
+      /// <summary>Index of the first sample (in each channel) in the FLAC frame</summary>
+      public: std::uint64_t SampleNumber;
+      /// <summary>Offset of the FLAC frame's first byte in the file</summary>
+      public: std::uint64_t ByteOffset;
+
+    };
+
+    /// <summary>Initializes a new, empty seek table</summary>
+    /// <param name="fileSize">Size of the FLAC file that will be indexed</param>
+    /// <param name="sampleInterval">
+    ///   Minimum distance between two consecutive seek points in samples
+    /// </param>
+    public: FlacSeekTable(std::uint64_t fileSize, std::uint64_t sampleInterval);
+
+    /// <summary>Frees all memory used by the seek table</summary>
+    public: ~FlacSeekTable() = default;
+
+    /// <summary>Checks whether seek points for the whole file have been recorded</summary>
+    /// <returns>True if the seek table covers the whole file</returns>
+    public: bool IsComplete() const;
+
+    /// <summary>Marks the seek table as covering the whole file</summary>
+    public: void MarkComplete();
+
+    /// <summary>Records the position of a FLAC frame in the file</summary>
+    /// <param name="frameNumber">Number of the FLAC frame as stored in its header</param>
+    /// <param name="sampleNumber">Index of the first sample in the FLAC frame</param>
+    /// <param name="byteOffset">Offset of the FLAC frame's first byte in the file</param>
+    /// <remarks>
+    ///   Seek points closer than the sample interval to an existing seek point are
+    ///   ignored, so this can be called for every decoded frame.
+    /// </remarks>
+    public: void AddSeekPoint(
+      std::uint64_t frameNumber, std::uint64_t sampleNumber, std::uint64_t byteOffset
+    );
+
+    /// <summary>Looks up the closest seek point before the specified sample</summary>
+    /// <param name="sampleNumber">Sample that should be reached</param>
+    /// <returns>
+    ///   The closest seek point not after the specified sample or nothing if there is
+    ///   no seek point close enough to be faster than letting libflac search
+    /// </returns>
+    public: std::optional<Entry> TryFindSeekPoint(std::uint64_t sampleNumber) const;
+
+    /// <summary>Counts the number of seek points in the table</summary>
+    /// <returns>The number of seek points currently stored in the table</returns>
+    public: std::size_t CountSeekPoints() const;
+
+    /// <summary>Stores the seek table in a compact binary format</summary>
+    /// <returns>A buffer holding the serialized seek table</returns>
+    public: std::vector<std::byte> Serialize() const;
+
+    /// <summary>Replaces the seek table with one that was serialized earlier</summary>
+    /// <param name="serializedTable">Buffer holding the serialized seek table</param>
+    /// <remarks>
+    ///   If the serialized seek table is malformed or was built for a file of different
+    ///   size, an exception is thrown and the current seek table is left untouched.
+    /// </remarks>
+    public: void Deserialize(const std::vector<std::byte> &serializedTable);
+
+    /// <summary>Minimum distance between two seek points in samples</summary>
+    private: std::uint64_t sampleInterval;
+    /// <summary>Size of the file that is being indexed</summary>
+    private: std::uint64_t fileSize;
+    /// <summary>Whether seek points for the whole file have been recorded</summary>
+    private: bool complete;
+    /// <summary>Seek points sorted by their sample number</summary>
+    private: std::vector<Entry> entries;
+    /// <summary>Must be held while accessing the seek table</summary>
+    private: mutable std::mutex tableMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACSEEKTABLE_H
@@ -0,0 +1,242 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacSequentialDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include <Nuclex/Support/Text/StringHelper.h> // for StringHelper
+
+#include "../../Platform/FlacApi.h" // for the wrapped FLAC API methods
+#include "../Shared/ChannelOrderFactory.h"
+#include "./FlacReader.h" // for FlacReader's channel placement helpers
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <string_view> // for std::string_view
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacSequentialDecoder::FlacSequentialDecoder(
+    const std::shared_ptr<SequentialSource> &source
+  ) :
+    streamDecoder(Platform::FlacApi::NewStreamDecoder()),
+    state(),
+    error(),
+    obtainedStreamInfo(false),
+    obtainedChannelMask(false),
+    channelCount(0),
+    sampleRate(0),
+    bitsPerSample(0),
+    channelPlacements(ChannelPlacement::Unknown),
+    channelOrder(),
+    totalFrameCount(),
+    cursor(0),
+    pendingSamples(),
+    pendingOffset(0) {
+    Platform::FlacApi::SetRespondMetadata(
+      this->streamDecoder, FLAC__METADATA_TYPE_VORBIS_COMMENT
+    );
+    this->state = FileAdapterFactory::InitStreamDecoderForSequentialReading(
+      source, this->streamDecoder, this
+    );
+
+    // All metadata blocks come before the first FLAC frame, so once a frame has been
+    // decoded, we know about any Vorbis comment overriding the standard channel layout.
+    while(this->pendingSamples.empty()) {
+      if(!processNext()) {
+        break;
+      }
+    }
+    if(!this->obtainedStreamInfo) {
+      throw Errors::CorruptedFileError(u8"FLAC audio stream is missing the metadata block");
+    }
+
+    this->channelOrder = Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
+      this->channelCount, this->channelPlacements
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacSequentialDecoder::~FlacSequentialDecoder() {
+    Platform::FlacApi::Finish(this->streamDecoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t FlacSequentialDecoder::DecodeInterleaved(float *buffer, std::size_t frameCount) {
+    if(frameCount == 0) {
+      return 0;
+    }
+
+    std::size_t pendingFrameCount = (
+      this->pendingSamples.size() / this->channelCount - this->pendingOffset
+    );
+    while(pendingFrameCount == 0) {
+      this->pendingSamples.clear();
+      this->pendingOffset = 0;
+      if(!processNext()) {
+        return 0;
+      }
+      pendingFrameCount = this->pendingSamples.size() / this->channelCount;
+    }
+
+    std::size_t deliveredFrameCount = std::min(frameCount, pendingFrameCount);
+    std::copy_n(
+      this->pendingSamples.data() + this->pendingOffset * this->channelCount,
+      deliveredFrameCount * this->channelCount,
+      buffer
+    );
+    this->pendingOffset += deliveredFrameCount;
+    this->cursor += deliveredFrameCount;
+
+    return deliveredFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacSequentialDecoder::ProcessAudioFrame(
+    const ::FLAC__Frame &frame,
+    const ::FLAC__int32 *const buffer[]
+  ) {
+    if(!this->obtainedChannelMask && (this->cursor == 0) && this->pendingSamples.empty()) {
+      this->channelPlacements = FlacReader::ChannelPlacementFromChannelCountAndAssignment(
+        this->channelCount, frame.header.channel_assignment
+      );
+    }
+
+    // libflac delivers its samples right-aligned, so sample values range from
+    // -2^(bitsPerSample - 1) to +2^(bitsPerSample - 1) - 1 and only need to be divided.
+    std::size_t deliveredFrameCount = frame.header.blocksize;
+    double limit = static_cast<double>((std::int64_t(1) << (this->bitsPerSample - 1)) - 1);
+
+    std::size_t previousSampleCount = this->pendingSamples.size();
+    this->pendingSamples.resize(previousSampleCount + deliveredFrameCount * this->channelCount);
+
+    float *target = this->pendingSamples.data() + previousSampleCount;
+    for(std::size_t frameIndex = 0; frameIndex < deliveredFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        *target = static_cast<float>(
+          static_cast<double>(buffer[channelIndex][frameIndex]) / limit
+        );
+        ++target;
+      }
+    }
+
+    return true; // Always return true, otherwise the decoder enters the 'aborted' state
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacSequentialDecoder::ProcessMetadata(const ::FLAC__StreamMetadata &metadata) noexcept {
+    using Nuclex::Support::Text::StringHelper;
+
+    if(metadata.type == FLAC__METADATA_TYPE_STREAMINFO) {
+      const ::FLAC__StreamMetadata_StreamInfo &streamInfo = metadata.data.stream_info;
+
+      this->channelCount = static_cast<std::size_t>(streamInfo.channels);
+      this->sampleRate = static_cast<std::size_t>(streamInfo.sample_rate);
+      this->bitsPerSample = static_cast<std::size_t>(streamInfo.bits_per_sample);
+      if(!this->obtainedChannelMask) {
+        this->channelPlacements = FlacReader::ChannelPlacementFromChannelCountAndAssignment(
+          this->channelCount, FLAC__CHANNEL_ASSIGNMENT_INDEPENDENT
+        );
+      }
+
+      // Encoders writing to a pipe can't go back to fill in the sample count
+      if(streamInfo.total_samples > 0) {
+        this->totalFrameCount = streamInfo.total_samples;
+      }
+      this->obtainedStreamInfo = true;
+    } else if(metadata.type == FLAC__METADATA_TYPE_VORBIS_COMMENT) {
+      const ::FLAC__StreamMetadata_VorbisComment &vorbisComment = metadata.data.vorbis_comment;
+      for(std::size_t index = 0; index < vorbisComment.num_comments; ++index) {
+        std::string_view comment(
+          reinterpret_cast<char *>(vorbisComment.comments[index].entry),
+          vorbisComment.comments[index].length
+        );
+
+        std::string_view::size_type assignmentIndex = comment.find(u8'=');
+        if(assignmentIndex != std::string_view::npos) {
+          std::string_view name = StringHelper::GetTrimmed(comment.substr(0, assignmentIndex));
+          if(name == std::string_view(u8"WAVEFORMATEXTENSIBLE_CHANNEL_MASK")) {
+            ChannelPlacement placements = (
+              FlacReader::ChannelPlacementFromWaveFormatExtensibleTag(
+                StringHelper::GetTrimmed(comment.substr(assignmentIndex + 1))
+              )
+            );
+            if(placements != ChannelPlacement::Unknown) {
+              this->channelPlacements = placements;
+              this->obtainedChannelMask = true;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacSequentialDecoder::HandleError(::FLAC__StreamDecoderErrorStatus status) noexcept {
+    if(!static_cast<bool>(this->error)) {
+      std::string message(u8"Error decoding FLAC audio stream: ", 34);
+      message.append(FLAC__StreamDecoderErrorStatusString[status]);
+      this->error = std::make_exception_ptr(Errors::CorruptedFileError(message));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacSequentialDecoder::processNext() {
+    for(;;) {
+      std::size_t previousSampleCount = this->pendingSamples.size();
+      bool wasProcessed = Platform::FlacApi::ProcessSingle(this->streamDecoder);
+
+      // Errors in the source are the root cause, libflac's own errors come second
+      FileAdapterState::RethrowPotentialException(*this->state);
+      if(static_cast<bool>(this->error)) {
+        std::rethrow_exception(this->error);
+      }
+      if(!wasProcessed) {
+        throw Errors::CorruptedFileError(u8"FLAC stream decoder failed to process the stream");
+      }
+
+      // libflac reports success when it hits the end of the stream, too. If it decoded
+      // nothing and the source ran dry, that's the end, otherwise it was a metadata block.
+      if(this->pendingSamples.size() > previousSampleCount) {
+        return true;
+      }
+      if(this->state->IsAtEnd) {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,142 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACSEQUENTIALDECODER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACSEQUENTIALDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "./FlacVirtualFileAdapter.h" // for the FlacDecodeProcessor interface
+
+#include <exception> // for std::exception_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a FLAC file front to back from a sequential source</summary>
+  /// <remarks>
+  ///   libflac itself is perfectly happy to decode without seeking, it only needs
+  ///   the seek, tell and length callbacks for random access. This decoder leaves them
+  ///   out and collects the samples of each decoded FLAC frame until they're picked up.
+  ///   Streaming encoders put zero into the STREAMINFO sample count, in which case
+  ///   no frame count is reported.
+  /// </remarks>
+  class FlacSequentialDecoder : public SequentialTrackDecoder, private FlacDecodeProcessor {
+
+    /// <summary>Initializes a new sequential FLAC decoder reading from a source</summary>
+    /// <param name="source">Source from which the FLAC file will be read</param>
+    public: FlacSequentialDecoder(const std::shared_ptr<SequentialSource> &source);
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~FlacSequentialDecoder() override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override { return this->channelCount; }
+
+    /// <summary>Produces the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the number of samples per second in each channel</summary>
+    /// <returns>The sample rate of the audio track</returns>
+    public: std::size_t GetSampleRate() const override { return this->sampleRate; }
+
+    /// <summary>Returns the number of frames in the track if it is known</summary>
+    /// <returns>The number of frames in the track or nothing if it isn't recorded</returns>
+    public: std::optional<std::uint64_t> TryCountFrames() const override {
+      return this->totalFrameCount;
+    }
+
+    /// <summary>Returns the number of frames that have been delivered so far</summary>
+    /// <returns>The index of the frame that will be delivered next</returns>
+    public: std::uint64_t GetFrameCursorPosition() const override { return this->cursor; }
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of audio frames that should be delivered</param>
+    /// <returns>The number of frames delivered, zero at the end of the track</returns>
+    public: std::size_t DecodeInterleaved(float *buffer, std::size_t frameCount) override;
+
+    /// <summary>Called to process an audio frame after it has been decoded</summary>
+    /// <param name="frame">Informations about the decoded audio frame</param>
+    /// <param name="buffer">Stores the decoded audio samples</param>
+    /// <returns>True to continue decoding, false to stop at this point</returns>
+    private: bool ProcessAudioFrame(
+      const ::FLAC__Frame &frame,
+      const ::FLAC__int32 *const buffer[]
+    ) override;
+
+    /// <summary>Called to process any metadata encountered in the FLAC file</summary>
+    /// <param name="metadata">Metadata the FLAC stream decoder has encountered</param>
+    private: void ProcessMetadata(const ::FLAC__StreamMetadata &metadata) noexcept override;
+
+    /// <summary>Called to provide a detailed status when a decoding error occurs</summary>
+    /// <param name="status">Error status of the stream decoder</param>
+    private: void HandleError(::FLAC__StreamDecoderErrorStatus status) noexcept override;
+
+    /// <summary>Lets libflac process the next metadata block or FLAC frame</summary>
+    /// <returns>False if the stream ended, true otherwise</returns>
+    private: bool processNext();
+
+    /// <summary>FLAC stream decoder reading from the sequential source</summary>
+    private: std::shared_ptr<::FLAC__StreamDecoder> streamDecoder;
+    /// <summary>Adapter through which libflac reads from the sequential source</summary>
+    private: std::unique_ptr<SequentialSourceAdapterState> state;
+    /// <summary>Error reported by libflac during the last processing call</summary>
+    private: std::exception_ptr error;
+    /// <summary>Whether the STREAMINFO metadata block has been processed</summary>
+    private: bool obtainedStreamInfo;
+    /// <summary>Whether a Vorbis comment recorded the placement of the channels</summary>
+    private: bool obtainedChannelMask;
+    /// <summary>Number of audio channels in the track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of samples per second in each channel</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Number of valid bits in each of libflac's samples</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Placement of the channels, as recorded in the file or by standard</summary>
+    private: ChannelPlacement channelPlacements;
+    /// <summary>Order in which the channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Number of frames in the track if the STREAMINFO block records it</summary>
+    private: std::optional<std::uint64_t> totalFrameCount;
+    /// <summary>Index of the next frame that will be delivered</summary>
+    private: std::uint64_t cursor;
+    /// <summary>Interleaved samples of the most recently decoded FLAC frame</summary>
+    private: std::vector<float> pendingSamples;
+    /// <summary>Number of frames in the pending samples that have been delivered</summary>
+    private: std::size_t pendingOffset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACSEQUENTIALDECODER_H
@@ -24,34 +24,298 @@ limitations under the License.
 
 #if defined(NUCLEX_AUDIO_HAVE_FLAC)
 
-#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Processing/BitExtension.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+#include "Nuclex/Audio/Processing/Reconstruction.h"
+#include "Nuclex/Audio/Processing/DecibelConverter.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
 
 #include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/DecodePathBuilder.h"
+#include "../Shared/SeekCostEstimator.h"
+#include "../Shared/GainTagParser.h"
 #include "./FlacReader.h"
+#include "./FlacFrameScanner.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+#include "./FlacSeekTable.h" // for FlacSeekTable
+#include "./StrippedFlacFile.h" // for StrippedFlacFile
+#include "./FlacMd5Verifier.h" // for FlacMd5Verifier
 
+#include <algorithm> // for std::min(), std::max()
 #include <cassert> // for assert()
+#include <cmath> // for std::lrint()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range, std::logic_error
+#include <type_traits> // for std::is_same, std::is_floating_point
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Helper that copies and interleaves samples returne by libflac</summary>
-  template<typename TTargetSample = float>
-  class InterleavingSampleForwarder {
+  /// <summary>Maximum number of channels the FLAC format supports</summary>
+  constexpr std::size_t MaximumChannelCount = 8;
 
-    /// <summary>Initializes a new interleaving sample forward</summary>
-    /// <param name="target">Buffer into which to write the interleaved samples</param>
+  /// <summary>Number of samples converted per batch when interleaving samples</summary>
+  constexpr std::size_t ScratchSampleCount = 4096;
+
+  /// <summary>Number of samples amplified per batch before integer conversion</summary>
+  constexpr std::size_t AmplifiedSampleCount = 256;
+
+  /// <summary>Distance, in milliseconds, between seek points in the seek table</summary>
+  /// <remarks>
+  ///   FLAC decodes quickly, so decoding forward through up to a second of audio
+  ///   after a jump is still much cheaper than libflac's bisection search.
+  /// </remarks>
+  constexpr std::uint64_t SeekPointIntervalMilliseconds = 500;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts libflac's integer samples into floating point samples</summary>
+  /// <typeparam name="TSample">Floating point type the samples will be converted to</typeparam>
+  /// <typeparam name="TLimit">Type in which the divisions will be performed</typeparam>
+  /// <param name="source">Samples as delivered by libflac</param>
+  /// <param name="limit">Largest positive value a sample can have</param>
+  /// <param name="target">Buffer that will receive the converted samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSample, typename TLimit>
+  void divideSamples(
+    const std::int32_t *source, TLimit limit, TSample *target, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Processing::Reconstruction;
+
+    while(3 < sampleCount) {
+      Reconstruction::DivideInt32ToFloatx4(source, limit, target);
+      source += 4;
+      target += 4;
+      sampleCount -= 4;
+    }
+    while(0 < sampleCount) {
+      target[0] = static_cast<TSample>(Reconstruction::DivideInt32ToFloat(source[0], limit));
+      ++source;
+      ++target;
+      --sampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts libflac's integer samples into floating point samples</summary>
+  /// <typeparam name="TSample">Floating point type the samples will be converted to</typeparam>
+  /// <param name="source">Samples as delivered by libflac</param>
+  /// <param name="bitsPerSample">Number of valid bits in each of libflac's samples</param>
+  /// <param name="gainFactor">Factor by which the samples will be amplified</param>
+  /// <param name="target">Buffer that will receive the converted samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSample>
+  void reconstructSamples(
+    const std::int32_t *source, std::size_t bitsPerSample, float gainFactor,
+    TSample *target, std::size_t sampleCount
+  ) {
+
+    // libflac delivers its samples right-aligned, so sample values range from
+    // -2^(bitsPerSample - 1) to +2^(bitsPerSample - 1) - 1 and only need to be divided.
+    // Floats have enough precision for samples of up to 16 bits, beyond that we
+    // let the division happen in doubles. Any gain is folded into the divisor.
+    if constexpr(std::is_same<TSample, float>::value) {
+      if(bitsPerSample < 17) {
+        float limit = static_cast<float>((std::int32_t(1) << (bitsPerSample - 1)) - 1);
+        divideSamples(source, limit / gainFactor, target, sampleCount);
+        return;
+      }
+    }
+
+    double limit = static_cast<double>((std::int64_t(1) << (bitsPerSample - 1)) - 1);
+    divideSamples(source, limit / static_cast<double>(gainFactor), target, sampleCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts libflac's integer samples into another integer sample format</summary>
+  /// <typeparam name="TSample">Integer type the samples will be converted to</typeparam>
+  /// <param name="source">Samples as delivered by libflac</param>
+  /// <param name="bitsPerSample">Number of valid bits in each of libflac's samples</param>
+  /// <param name="target">Address at which the first converted sample will be stored</param>
+  /// <param name="targetStride">Distance between two target samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSample>
+  void convertIntegerSamples(
+    const std::int32_t *source, std::size_t bitsPerSample,
+    TSample *target, std::size_t targetStride, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Processing::BitExtension;
+
+    constexpr int targetBitCount = static_cast<int>(sizeof(TSample) * 8);
+    constexpr std::int32_t bias = std::is_same<TSample, std::uint8_t>::value ? 128 : 0;
+
+    int sourceBitCount = static_cast<int>(bitsPerSample);
+
+    // If the target has fewer or as many bits as the samples from libflac, we just
+    // cut off the least significant bits (if any) and are done.
+    if(targetBitCount <= sourceBitCount) {
+      int shift = sourceBitCount - targetBitCount;
+      for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+        *target = static_cast<TSample>((source[sampleIndex] >> shift) + bias);
+        target += targetStride;
+      }
+      return;
+    }
+
+    // The target has more bits, so move the sample bits to the top of an int32 and
+    // repeat their bit pattern below (like the WavPack reader does) so the sample
+    // covers the whole range of the target type. Finally, shift it down to the size
+    // of the target type (which is a no-op for int32 targets).
+    int topShift = 32 - sourceBitCount;
+    int repeatShift = sourceBitCount - 1;
+    int downShift = 32 - targetBitCount;
+
+    std::int32_t mask = (std::int32_t(1) << (sourceBitCount - 1)) - 1;
+    if(repeatShift > topShift) {
+      mask >>= (repeatShift - topShift);
+    } else {
+      mask <<= (topShift - repeatShift);
+    }
+
+    if(sourceBitCount * 2 - 1 >= targetBitCount) {
+      for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+        std::int32_t extended = BitExtension::ShiftAndRepeatSigned(
+          topShift, source[sampleIndex], repeatShift, mask
+        );
+        *target = static_cast<TSample>((extended >> downShift) + bias);
+        target += targetStride;
+      }
+    } else {
+      for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+        std::int32_t extended = BitExtension::ShiftAndTripleSigned(
+          topShift, source[sampleIndex], repeatShift, mask
+        );
+        *target = static_cast<TSample>((extended >> downShift) + bias);
+        target += targetStride;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Amplifies libflac's samples and converts them into another integer format</summary>
+  /// <typeparam name="TSample">Integer type the samples will be converted to</typeparam>
+  /// <param name="source">Samples as delivered by libflac</param>
+  /// <param name="bitsPerSample">Number of valid bits in each of libflac's samples</param>
+  /// <param name="gainFactor">Factor by which the samples will be amplified</param>
+  /// <param name="target">Address at which the first converted sample will be stored</param>
+  /// <param name="targetStride">Distance between two target samples</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSample>
+  void convertAmplifiedIntegerSamples(
+    const std::int32_t *source, std::size_t bitsPerSample, float gainFactor,
+    TSample *target, std::size_t targetStride, std::size_t sampleCount
+  ) {
+    const double highest = static_cast<double>((std::int64_t(1) << (bitsPerSample - 1)) - 1);
+    const double lowest = -highest - 1.0;
+    const double gain = static_cast<double>(gainFactor);
+
+    // Amplify a small batch on the stack, staying within the source's bit depth,
+    // then let the normal conversion take it to the target's bit depth
+    std::int32_t amplified[AmplifiedSampleCount];
+    while(0 < sampleCount) {
+      std::size_t batchSampleCount = std::min(sampleCount, AmplifiedSampleCount);
+      for(std::size_t sampleIndex = 0; sampleIndex < batchSampleCount; ++sampleIndex) {
+        double sample = static_cast<double>(source[sampleIndex]) * gain;
+        amplified[sampleIndex] = static_cast<std::int32_t>(
+          std::lrint(std::clamp(sample, lowest, highest))
+        );
+      }
+      convertIntegerSamples(amplified, bitsPerSample, target, targetStride, batchSampleCount);
+
+      source += batchSampleCount;
+      target += batchSampleCount * targetStride;
+      sampleCount -= batchSampleCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps the samples of a FLAC frame that go beyond the requested range</summary>
+  /// <param name="buffers">Buffers containing the separated audio channels</param>
+  /// <param name="channelCount">Number of channels in the buffers</param>
+  /// <param name="usedFrameCount">Number of frames that have been delivered</param>
+  /// <param name="frameCount">Total number of frames in the buffers</param>
+  /// <param name="leftoverSamples">Receives the samples that have not been delivered</param>
+  /// <param name="leftoverFrameCount">Receives the number of leftover frames</param>
+  void stashLeftoverSamples(
+    const std::int32_t *const buffers[], std::size_t channelCount,
+    std::size_t usedFrameCount, std::size_t frameCount,
+    Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples,
+    std::size_t &leftoverFrameCount
+  ) {
+    std::size_t extraFrameCount = frameCount - usedFrameCount;
+    if(extraFrameCount > 0) {
+      if(leftoverSamples.size() < extraFrameCount * channelCount) {
+        Nuclex::Audio::AllocationScope scratchScope(
+          Nuclex::Audio::AllocationSubsystem::ReaderScratch
+        );
+        leftoverSamples.resize(extraFrameCount * channelCount);
+      }
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        std::copy_n(
+          buffers[channelIndex] + usedFrameCount,
+          extraFrameCount,
+          leftoverSamples.data() + (channelIndex * extraFrameCount)
+        );
+      }
+    }
+    leftoverFrameCount = extraFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper that converts samples returned by libflac into the caller's buffers</summary>
+  /// <typeparam name="TSample">Type of samples the caller wants to receive</typeparam>
+  /// <remarks>
+  ///   libflac only delivers whole FLAC frames, so the last frame will usually contain
+  ///   more samples than the caller asked for. These are stashed in the leftover buffer
+  ///   so the next decoding call can pick them up without seeking back.
+  /// </remarks>
+  template<typename TSample>
+  class DecodedSampleForwarder {
+
+    /// <summary>Initializes a new decoded sample forwarder</summary>
+    /// <param name="buffer">
+    ///   Buffer that receives interleaved samples or null if decoding separated
+    /// </param>
+    /// <param name="buffers">
+    ///   Buffers that receive the separated channels or null if decoding interleaved
+    /// </param>
     /// <param name="channelCount">Number of channels that are being decoded</param>
     /// <param name="bitsPerSample">Number of bits per audio sample</param>
-    public: InterleavingSampleForwarder(
-      TTargetSample *target, std::size_t channelCount, std::size_t bitsPerSample
+    /// <param name="gainFactor">Factor by which the samples will be amplified</param>
+    /// <param name="frameCount">Number of frames that should be written</param>
+    /// <param name="scratchBuffer">Persistent buffer for the interleaving conversions</param>
+    /// <param name="leftoverSamples">Receives samples decoded past the requested frames</param>
+    /// <param name="leftoverFrameCount">Receives the number of leftover frames</param>
+    public: DecodedSampleForwarder(
+      TSample *buffer, TSample *const buffers[],
+      std::size_t channelCount, std::size_t bitsPerSample, float gainFactor,
+      std::size_t frameCount,
+      Nuclex::Audio::SampleVector<std::byte> &scratchBuffer,
+      Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples,
+      std::size_t &leftoverFrameCount
+    );
+
+    /// <summary>Writes samples into the caller-provided buffers</summary>
+    /// <param name="buffers">Buffers containing the separated audio channels</param>
+    /// <param name="offset">Index of the first frame in the buffers that will be written</param>
+    /// <param name="frameCount">Number of frames that will be written</param>
+    public: void WriteFrames(
+      const std::int32_t *const buffers[], std::size_t offset, std::size_t frameCount
     );
 
-    /// <summary>Writes the decoded samples into the user-provided buffer</summary>
+    /// <summary>Processes a FLAC frame worth of decoded samples from libflac</summary>
     /// <param name="buffers">
     ///   Buffers (allocated and provided by libflac) containing the separated audio channels
-    /// </parma>
+    /// </param>
     /// <param name="frameCount">
     ///   Total number of frames (= samples in each channel) delivered
     /// </param>
@@ -65,7 +329,7 @@ namespace {
     /// <param name="userPointer">The instance of this class to forward to</param>
     /// <param name="buffers">
     ///   Buffers (allocated and provided by libflac) containing the separated audio channels
-    /// </parma>
+    /// </param>
     /// <param name="frameCount">
     ///   Total number of frames (= samples in each channel) delivered
     /// </param>
@@ -73,61 +337,318 @@ namespace {
       void *userPointer, const std::int32_t *const buffers[], std::size_t frameCount
     );
 
-    /// <summary>Target buffer that receives the interleaved samples</summary>
-    private: TTargetSample *target;
+    /// <summary>Number of frames that still need to be written</summary>
+    /// <returns>The number of frames missing to complete the decoding call</returns>
+    public: std::size_t CountRemainingFrames() const { return this->remainingFrameCount; }
+
+    /// <summary>Writes all channels into the interleaved target buffer</summary>
+    /// <param name="buffers">Buffers containing the separated audio channels</param>
+    /// <param name="offset">Index of the first frame in the buffers that will be written</param>
+    /// <param name="frameCount">Number of frames that will be written</param>
+    private: void interleaveFrames(
+      const std::int32_t *const buffers[], std::size_t offset, std::size_t frameCount
+    );
+
+    /// <summary>Converts and amplifies the samples of a single channel</summary>
+    /// <param name="source">Samples as delivered by libflac</param>
+    /// <param name="target">Buffer that will receive the converted samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    private: void convertSamples(
+      const std::int32_t *source, TSample *target, std::size_t sampleCount
+    ) const;
+
+    /// <summary>Target buffer that receives interleaved samples</summary>
+    private: TSample *buffer;
+    /// <summary>Target buffers that receive the separated channels</summary>
+    private: TSample *const *buffers;
     /// <summary>Number of audio channels libflac is decoding for us</summary>
     private: std::size_t channelCount;
-    /// <summary>Number of bits per sample in the source data</summary>>
+    /// <summary>Number of bits per sample in the source data</summary>
     private: std::size_t bitsPerSample;
+    /// <summary>Factor by which samples are amplified, 1.0 unless ReplayGain is on</summary>
+    private: float gainFactor;
+    /// <summary>Number of frames that have been written to the target so far</summary>
+    private: std::size_t writtenFrameCount;
+    /// <summary>Number of frames that still need to be written to the target</summary>
+    private: std::size_t remainingFrameCount;
+    /// <summary>Persistent buffer used to convert samples before interleaving them</summary>
+    private: Nuclex::Audio::SampleVector<std::byte> &scratchBuffer;
+    /// <summary>Persistent buffer that receives samples beyond the requested ones</summary>
+    private: Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples;
+    /// <summary>Receives the number of frames stored in the leftover buffer</summary>
+    private: std::size_t &leftoverFrameCount;
 
   };
 
   // ------------------------------------------------------------------------------------------- //
 
-  template<typename TTargetSample>
-  InterleavingSampleForwarder<TTargetSample>::InterleavingSampleForwarder(
-    TTargetSample *target, std::size_t channelCount, std::size_t bitsPerSample
+  template<typename TSample>
+  DecodedSampleForwarder<TSample>::DecodedSampleForwarder(
+    TSample *buffer, TSample *const buffers[],
+    std::size_t channelCount, std::size_t bitsPerSample, float gainFactor,
+    std::size_t frameCount,
+    Nuclex::Audio::SampleVector<std::byte> &scratchBuffer,
+    Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples,
+    std::size_t &leftoverFrameCount
   ) :
-    target(target),
+    buffer(buffer),
+    buffers(buffers),
     channelCount(channelCount),
-    bitsPerSample(bitsPerSample) {}
+    bitsPerSample(bitsPerSample),
+    gainFactor(gainFactor),
+    writtenFrameCount(0),
+    remainingFrameCount(frameCount),
+    scratchBuffer(scratchBuffer),
+    leftoverSamples(leftoverSamples),
+    leftoverFrameCount(leftoverFrameCount) {}
 
   // ------------------------------------------------------------------------------------------- //
 
-  template<typename TTargetSample>
-  void InterleavingSampleForwarder<TTargetSample>::WriteDecodedSamples(
-    const std::int32_t *const buffers[], std::size_t frameCount
+  template<typename TSample>
+  void DecodedSampleForwarder<TSample>::WriteFrames(
+    const std::int32_t *const buffers[], std::size_t offset, std::size_t frameCount
   ) {
-    std::vector<TTargetSample> temp;
-    temp.resize(frameCount);
+    assert(
+      (frameCount <= this->remainingFrameCount) &&
+      u8"Forwarder is not asked to write more frames than the caller requested"
+    );
 
-    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
-      Nuclex::Audio::Processing::SampleConverter::Convert(
-        buffers[channelIndex], this->bitsPerSample,
-        temp.data(), sizeof(TTargetSample) * 8,
-        frameCount
-      );
-      TTargetSample *targetChannel = this->target + channelIndex;
-      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
-        *targetChannel = temp[frameIndex];
-        targetChannel += this->channelCount;
+    if(this->buffer == nullptr) { // Decoding into separated channels?
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        if(this->buffers[channelIndex] == nullptr) {
+          continue; // Caller is not interested in this channel
+        }
+
+        const std::int32_t *source = buffers[channelIndex] + offset;
+        TSample *target = this->buffers[channelIndex] + this->writtenFrameCount;
+        convertSamples(source, target, frameCount);
       }
+    } else { // Decoding into interleaved channels
+      this->interleaveFrames(buffers, offset, frameCount);
+    }
+
+    this->writtenFrameCount += frameCount;
+    this->remainingFrameCount -= frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DecodedSampleForwarder<TSample>::WriteDecodedSamples(
+    const std::int32_t *const buffers[], std::size_t frameCount
+  ) {
+    std::size_t usedFrameCount = std::min(frameCount, this->remainingFrameCount);
+    if(usedFrameCount > 0) {
+      this->WriteFrames(buffers, 0, usedFrameCount);
     }
+
+    // Keep whatever we didn't need for the next decoding call
+    stashLeftoverSamples(
+      buffers, this->channelCount, usedFrameCount, frameCount,
+      this->leftoverSamples, this->leftoverFrameCount
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  template<typename TTargetSample>
-  void InterleavingSampleForwarder<TTargetSample>::ProcessDecodedSamplesFunction(
+  template<typename TSample>
+  void DecodedSampleForwarder<TSample>::ProcessDecodedSamplesFunction(
     void *userPointer, const std::int32_t *const buffers[], std::size_t frameCount
   ) {
-    reinterpret_cast<InterleavingSampleForwarder *>(userPointer)->WriteDecodedSamples(
+    reinterpret_cast<DecodedSampleForwarder *>(userPointer)->WriteDecodedSamples(
       buffers, frameCount
     );
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TSample>
+  void DecodedSampleForwarder<TSample>::interleaveFrames(
+    const std::int32_t *const buffers[], std::size_t offset, std::size_t frameCount
+  ) {
+    assert(
+      (this->channelCount <= MaximumChannelCount) &&
+      u8"Channel count is within the limits of the FLAC format"
+    );
+
+    // The conversion and interleaving helpers both work best on consecutive samples,
+    // so convert a batch of each channel into the scratch buffer, then interleave
+    // the whole batch into the target buffer in one go.
+    if(this->scratchBuffer.size() < ScratchSampleCount * sizeof(TSample)) {
+      Nuclex::Audio::AllocationScope scratchScope(
+        Nuclex::Audio::AllocationSubsystem::ReaderScratch
+      );
+      this->scratchBuffer.resize(ScratchSampleCount * sizeof(TSample));
+    }
+    TSample *scratch = reinterpret_cast<TSample *>(this->scratchBuffer.data());
+    std::size_t batchFrameCount = ScratchSampleCount / this->channelCount;
+
+    const TSample *convertedChannels[MaximumChannelCount];
+    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+      convertedChannels[channelIndex] = scratch + (channelIndex * batchFrameCount);
+    }
+
+    TSample *target = this->buffer + (this->writtenFrameCount * this->channelCount);
+    while(0 < frameCount) {
+      std::size_t convertedFrameCount = std::min(frameCount, batchFrameCount);
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        const std::int32_t *source = buffers[channelIndex] + offset;
+        TSample *channelScratch = scratch + (channelIndex * batchFrameCount);
+        convertSamples(source, channelScratch, convertedFrameCount);
+      }
+
+      Nuclex::Audio::Processing::Interleaver::Interleave(
+        convertedChannels, target, this->channelCount, convertedFrameCount
+      );
+
+      offset += convertedFrameCount;
+      target += convertedFrameCount * this->channelCount;
+      frameCount -= convertedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void DecodedSampleForwarder<TSample>::convertSamples(
+    const std::int32_t *source, TSample *target, std::size_t sampleCount
+  ) const {
+    if constexpr(std::is_floating_point<TSample>::value) {
+      reconstructSamples(source, this->bitsPerSample, this->gainFactor, target, sampleCount);
+    } else if(this->gainFactor == 1.0f) {
+      convertIntegerSamples(source, this->bitsPerSample, target, 1, sampleCount);
+    } else {
+      convertAmplifiedIntegerSamples(
+        source, this->bitsPerSample, this->gainFactor, target, 1, sampleCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper that hands the samples returned by libflac to a sink</summary>
+  /// <remarks>
+  ///   Works like the decoded sample forwarder, but passes libflac's own buffers on
+  ///   instead of converting them.
+  /// </remarks>
+  class NativeSampleForwarder {
+
+    /// <summary>Initializes a new native sample forwarder</summary>
+    /// <param name="sink">Sink that will receive the decoded samples</param>
+    /// <param name="channelCount">Number of channels that are being decoded</param>
+    /// <param name="bitsPerSample">Number of bits per audio sample</param>
+    /// <param name="startFrame">Index of the first frame that will be delivered</param>
+    /// <param name="frameCount">Number of frames that should be delivered</param>
+    /// <param name="leftoverSamples">Receives samples decoded past the requested frames</param>
+    /// <param name="leftoverFrameCount">Receives the number of leftover frames</param>
+    public: NativeSampleForwarder(
+      Nuclex::Audio::Storage::DecodedSampleSink &sink,
+      std::size_t channelCount, std::size_t bitsPerSample,
+      std::uint64_t startFrame, std::size_t frameCount,
+      Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples,
+      std::size_t &leftoverFrameCount
+    ) :
+      sink(sink),
+      channelCount(channelCount),
+      bitsPerSample(bitsPerSample),
+      nextFrame(startFrame),
+      remainingFrameCount(frameCount),
+      leftoverSamples(leftoverSamples),
+      leftoverFrameCount(leftoverFrameCount) {}
+
+    /// <summary>Hands samples to the sink</summary>
+    /// <param name="buffers">Buffers containing the separated audio channels</param>
+    /// <param name="offset">Index of the first frame in the buffers that will be handed</param>
+    /// <param name="frameCount">Number of frames that will be handed to the sink</param>
+    public: void WriteFrames(
+      const std::int32_t *const buffers[], std::size_t offset, std::size_t frameCount
+    ) {
+      assert(
+        (frameCount <= this->remainingFrameCount) &&
+        u8"Forwarder is not asked to deliver more frames than the caller requested"
+      );
+
+      const void *channels[MaximumChannelCount];
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        channels[channelIndex] = buffers[channelIndex] + offset;
+      }
+
+      Nuclex::Audio::Storage::DecodedSamples samples;
+      samples.Format = Nuclex::Audio::AudioSampleFormat::SignedInteger_32;
+      samples.BitsPerSample = this->bitsPerSample;
+      samples.StartFrame = this->nextFrame;
+      samples.FrameCount = frameCount;
+      samples.ChannelCount = this->channelCount;
+      samples.IsInterleaved = false;
+      samples.Buffers = channels;
+      this->sink.ProcessSamples(samples);
+
+      this->nextFrame += frameCount;
+      this->remainingFrameCount -= frameCount;
+    }
+
+    /// <summary>Processes a FLAC frame worth of decoded samples from libflac</summary>
+    /// <param name="buffers">
+    ///   Buffers (allocated and provided by libflac) containing the separated audio channels
+    /// </param>
+    /// <param name="frameCount">
+    ///   Total number of frames (= samples in each channel) delivered
+    /// </param>
+    public: void WriteDecodedSamples(
+      const std::int32_t *const buffers[], std::size_t frameCount
+    ) {
+      std::size_t usedFrameCount = std::min(frameCount, this->remainingFrameCount);
+      if(usedFrameCount > 0) {
+        WriteFrames(buffers, 0, usedFrameCount);
+      }
+
+      stashLeftoverSamples(
+        buffers, this->channelCount, usedFrameCount, frameCount,
+        this->leftoverSamples, this->leftoverFrameCount
+      );
+    }
+
+    /// <summary>
+    ///   Static callback sink that forwards to the WriteDecodedSamples() method
+    /// </summary>
+    /// <param name="userPointer">The instance of this class to forward to</param>
+    /// <param name="buffers">
+    ///   Buffers (allocated and provided by libflac) containing the separated audio channels
+    /// </param>
+    /// <param name="frameCount">
+    ///   Total number of frames (= samples in each channel) delivered
+    /// </param>
+    public: static void ProcessDecodedSamplesFunction(
+      void *userPointer, const std::int32_t *const buffers[], std::size_t frameCount
+    ) {
+      reinterpret_cast<NativeSampleForwarder *>(userPointer)->WriteDecodedSamples(
+        buffers, frameCount
+      );
+    }
+
+    /// <summary>Number of frames that still need to be delivered</summary>
+    /// <returns>The number of frames missing to complete the decoding call</returns>
+    public: std::size_t CountRemainingFrames() const { return this->remainingFrameCount; }
+
+    /// <summary>Sink that receives the decoded samples</summary>
+    private: Nuclex::Audio::Storage::DecodedSampleSink &sink;
+    /// <summary>Number of audio channels libflac is decoding for us</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of bits per sample in the source data</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Index of the frame that will be delivered next</summary>
+    private: std::uint64_t nextFrame;
+    /// <summary>Number of frames that still need to be delivered</summary>
+    private: std::size_t remainingFrameCount;
+    /// <summary>Persistent buffer that receives samples beyond the requested ones</summary>
+    private: Nuclex::Audio::SampleVector<std::int32_t> &leftoverSamples;
+    /// <summary>Receives the number of frames stored in the leftover buffer</summary>
+    private: std::size_t &leftoverFrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
@@ -135,13 +656,26 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   // ------------------------------------------------------------------------------------------- //
 
   FlacTrackDecoder::FlacTrackDecoder(const std::shared_ptr<const VirtualFile> &file) :
-    reader(file),
+    file(StrippedFlacFile::TryWrap(file)),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(Shared::TrackedCodec::Flac)
+    ),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, this->file)),
     trackInfo(),
     channelOrder(),
     totalFrameCount(std::uint64_t(-1)),
+    blockSize(0),
+    seekTable(),
+    scratchBuffer(),
+    leftoverSamples(),
+    leftoverStartFrame(0),
+    leftoverFrameCount(0),
+    checkpoints(),
+    verifier(),
+    gainFactor(1.0f),
     decodingMutex() {
 
-    this->reader.ReadMetadata(this->trackInfo);
+    this->reader.ReadMetadata(this->trackInfo, false);
 
     // FLAC uses a channel mask matching the Waveform file format, as well as the same
     // channel order which can be deduced from the channel count this way.
@@ -151,6 +685,46 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     );
 
     this->totalFrameCount = this->reader.CountTotalFrames();
+    this->blockSize = std::max<std::size_t>(this->reader.GetBlockSize(), 1);
+
+    // Many FLAC files have no SEEKTABLE block and even if they do, it only narrows down
+    // libflac's search. Our own seek table gets filled as frames are decoded.
+    this->seekTable = std::make_shared<FlacSeekTable>(
+      this->file->GetSize(),
+      std::max<std::uint64_t>(this->trackInfo.SampleRate * SeekPointIntervalMilliseconds / 1000, 1)
+    );
+    this->reader.UseSeekTable(this->seekTable);
+    this->reader.UseStatistics(this->statistics);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacTrackDecoder::FlacTrackDecoder(const FlacTrackDecoder &other) :
+    file(other.file),
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(
+      Shared::TrackedCodec::Flac, other.statistics->IsEnabled()
+    )),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, other.file)),
+    trackInfo(other.trackInfo),
+    channelOrder(other.channelOrder),
+    totalFrameCount(other.totalFrameCount),
+    blockSize(other.blockSize),
+    seekTable(other.seekTable),
+    scratchBuffer(),
+    leftoverSamples(),
+    leftoverStartFrame(0),
+    leftoverFrameCount(0),
+    checkpoints(),
+    verifier(other.verifier),
+    gainFactor(other.gainFactor),
+    decodingMutex() {
+
+    // libflac only knows where the audio data begins after it has seen the metadata
+    // blocks, so let it run through them. We already have everything we took from them.
+    TrackInfo unusedTrackInfo;
+    this->reader.ReadMetadata(unusedTrackInfo, false);
+    this->reader.UseSeekTable(this->seekTable);
+    this->reader.UseStatistics(this->statistics);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -160,7 +734,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<AudioTrackDecoder> FlacTrackDecoder::Clone() const {
-    throw std::runtime_error(u8"Not implemented yet");
+    AllocationScope cloneScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+    return std::shared_ptr<AudioTrackDecoder>(new FlacTrackDecoder(*this));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -177,6 +752,44 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool FlacTrackDecoder::TrySetVerificationPolicy(VerificationPolicy policy) {
+    if(policy == VerificationPolicy::Off) {
+      this->verifier.reset();
+    } else {
+      std::shared_ptr<const VirtualFile> verifiedFile = this->file;
+      this->verifier = std::make_shared<Shared::IntegrityVerifier>(
+        policy,
+        [verifiedFile](const CancellationToken &cancellation) {
+          return FlacMd5Verifier::Verify(verifiedFile, cancellation);
+        }
+      );
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacTrackDecoder::TrySetReplayGain(ReplayGainMode mode) {
+    float gainDecibels = Shared::GainTagParser::GetGainDecibels(this->trackInfo.ReplayGain, mode);
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    this->gainFactor = Processing::DecibelConverter::ToLinearAmplitude(gainDecibels);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult FlacTrackDecoder::GetVerificationResult() const {
+    if(static_cast<bool>(this->verifier)) {
+      return this->verifier->GetResult();
+    } else {
+      return VerificationResult::NotChecked;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t FlacTrackDecoder::CountFrames() const {
     return this->totalFrameCount;
   }
@@ -187,7 +800,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     return this->trackInfo.SampleFormat;
   }
 
-  // ------------------------std::------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
 
   bool FlacTrackDecoder::IsNativelyInterleaved() const {
     return false; // FLAC actually separates the audio channels
@@ -195,71 +808,321 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void FlacTrackDecoder::DecodeInterleavedUint8(
-    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  void FlacTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics FlacTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram FlacTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath FlacTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    using Shared::DecodePathBuilder;
+
+    sampleFormat = DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    std::string inlineKernelSet = DecodePathBuilder::GetInlineKernelSetName();
+
+    // libflac hands out its own buffers, the samples are converted from there
+    // directly into separated channels or, in batches, into the scratch buffer
+    DecodePathBuilder builder(u8"FLAC", AudioSampleFormat::SignedInteger_32, u8"separated");
+    if(interleaved) {
+      builder.AddScratchBuffer();
+    }
+
+    std::size_t targetBitCount = static_cast<std::size_t>(sampleFormat); // for integers
+    if(DecodePathBuilder::IsFloatingPoint(sampleFormat)) {
+      builder.AddPass(u8"Reconstruct " + inlineKernelSet);
+    } else if(targetBitCount > this->trackInfo.BitsPerSample) {
+      builder.AddPass(u8"Extend bits");
+    } else if(targetBitCount < this->trackInfo.BitsPerSample) {
+      builder.AddPass(u8"Truncate bits");
+    } else {
+      builder.AddPass(u8"copy");
+    }
+
+    if(interleaved) {
+      builder.AddPass(u8"Interleave " + inlineKernelSet);
+    }
+
+    return builder.GetPath();
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void FlacTrackDecoder::DecodeInterleavedInt16(
-    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  SeekCost FlacTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+    Shared::SeekCostEstimator estimator(
+      this->file->GetSize(), this->totalFrameCount, this->blockSize
+    );
+
+    // Mirror decodeVia(): leftovers from the last FLAC frame or a reader that is already
+    // at the target frame mean decoding simply continues
+    std::uint64_t leftoverEndFrame = this->leftoverStartFrame + this->leftoverFrameCount;
+    bool isInLeftovers = (
+      (targetFrame >= this->leftoverStartFrame) && (targetFrame < leftoverEndFrame)
+    );
+    if(isInLeftovers || (this->reader.GetFrameCursorPosition() == targetFrame)) {
+      return estimator.Continue();
+    }
+
+    // Mirror seekTo() and the seek the reader would carry out
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(targetFrame);
+    if((checkpoint != nullptr) && checkpoint->IsDirect) {
+      return estimator.Jump(checkpoint->ResumeFrameIndex, targetFrame);
+    }
+
+    std::optional<FlacSeekTable::Entry> seekPoint = this->seekTable->TryFindSeekPoint(
+      targetFrame
+    );
+    if(seekPoint.has_value()) {
+      return estimator.Jump(seekPoint->SampleNumber, targetFrame);
+    }
+
+    // libflac bisects the file and resumes at the start of the FLAC frame that
+    // contains the target frame
+    return estimator.Bisect(GetBlockStart(targetFrame), targetFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t FlacTrackDecoder::GetNominalBlockSize() const {
+    return this->blockSize; // Only exact for fixed-blocksize streams, but those are the norm
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockContent FlacTrackDecoder::DescribeBlock(std::uint64_t frameIndex) const {
+    if(unlikely(frameIndex >= this->totalFrameCount)) {
+      throw std::out_of_range(u8"Frame index lies beyond the end of the audio track");
+    }
+
+    // The frame scanner reads the file on its own, so this doesn't need the decoding mutex
+    // and doesn't disturb the position of the reader
+    FlacFrameScanner scanner(*this->file);
+    FlacFrameScanner::Frame frame = scanner.FindFrame(frameIndex);
+
+    std::vector<std::byte> data;
+    if(!scanner.TryReadFrame(frame.Offset, frame, &data)) {
+      return AudioTrackDecoder::DescribeBlock(frameIndex);
+    }
+
+    return scanner.DescribeFrame(frame, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<BlockContent> FlacTrackDecoder::ScanBlocks(
+    std::uint64_t startFrame, std::uint64_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    std::vector<BlockContent> blocks;
+
+    std::uint64_t endFrame = std::min(startFrame + frameCount, this->totalFrameCount);
+    if(startFrame >= endFrame) {
+      return blocks;
+    }
+
+    // Locate the first FLAC frame once, then walk over the following frames. Each frame
+    // is read in full to find where it ends, but none of them is decoded.
+    FlacFrameScanner scanner(*this->file);
+    FlacFrameScanner::Frame frame = scanner.FindFrame(startFrame);
+
+    std::vector<std::byte> data;
+    std::uint64_t offset = frame.Offset;
+    while(scanner.TryReadFrame(offset, frame, &data)) {
+      if(frame.FirstSample >= endFrame) {
+        break;
+      }
+
+      blocks.push_back(scanner.DescribeFrame(frame, data));
+      offset = frame.Offset + frame.Length;
+    }
+
+    return blocks;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void FlacTrackDecoder::DecodeInterleavedInt32(
-    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  void FlacTrackDecoder::BuildSeekIndex() const {
+    if(this->seekTable->IsComplete()) {
+      return;
+    }
+
+    // Use a separate reader so that decoding calls don't have to wait while we
+    // run through the whole file. The seek table itself is thread-safe.
+    FlacReader scanningReader(this->file);
+    TrackInfo unusedTrackInfo;
+    scanningReader.ReadMetadata(unusedTrackInfo, false);
+    scanningReader.UseSeekTable(this->seekTable);
+    scanningReader.BuildSeekTable();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> FlacTrackDecoder::SaveSeekIndex() const {
+    return this->seekTable->Serialize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::LoadSeekIndex(
+    const std::vector<std::byte> &serializedSeekIndex
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    this->seekTable->Deserialize(serializedSeekIndex);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void FlacTrackDecoder::DecodeInterleavedFloat(
-    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  template<typename TSample>
+  void FlacTrackDecoder::decodeAndConvert(
+    TSample *buffer, TSample *const buffers[],
+    const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
-      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    std::size_t channelCount = this->channelOrder.size();
+    if(MaximumChannelCount < channelCount) {
+      throw std::logic_error(u8"FLAC audio track has more channels than FLAC allows");
     }
-    if(startFrame >= this->totalFrameCount) {
-      throw std::out_of_range(u8"Start sample index is out of bounds");
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode FLAC", this->file.get(), this);
+
+    Shared::DecodeStatisticsScope decodingMutexScope(
+      this->decodingMutex, *this->statistics, frameCount
+    );
+
+    DecodedSampleForwarder<TSample> forwarder(
+      buffer, buffers,
+      channelCount, this->trackInfo.BitsPerSample, this->gainFactor, frameCount,
+      this->scratchBuffer, this->leftoverSamples, this->leftoverFrameCount
+    );
+    decodeVia(forwarder, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::DecodeRange(
+    std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+
+    std::size_t channelCount = this->channelOrder.size();
+    if(MaximumChannelCount < channelCount) {
+      throw std::logic_error(u8"FLAC audio track has more channels than FLAC allows");
     }
-    if(this->totalFrameCount < startFrame + frameCount) {
-      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode FLAC", this->file.get(), this);
+
+    Shared::DecodeStatisticsScope decodingMutexScope(
+      this->decodingMutex, *this->statistics, frameCount
+    );
+
+    NativeSampleForwarder forwarder(
+      sink, channelCount, this->trackInfo.BitsPerSample, startFrame, frameCount,
+      this->leftoverSamples, this->leftoverFrameCount
+    );
+    decodeVia(forwarder, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TForwarder>
+  void FlacTrackDecoder::decodeVia(
+    TForwarder &forwarder, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->channelOrder.size();
+
+    // If the previous decoding call left us samples from the last FLAC frame and
+    // the caller resumes within them, use them before asking libflac for more.
+    std::uint64_t leftoverEndFrame = this->leftoverStartFrame + this->leftoverFrameCount;
+    if((startFrame >= this->leftoverStartFrame) && (startFrame < leftoverEndFrame)) {
+      const std::int32_t *leftoverChannels[MaximumChannelCount];
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        leftoverChannels[channelIndex] = (
+          this->leftoverSamples.data() + (channelIndex * this->leftoverFrameCount)
+        );
+      }
+
+      std::size_t offset = static_cast<std::size_t>(startFrame - this->leftoverStartFrame);
+      forwarder.WriteFrames(
+        leftoverChannels, offset, std::min(frameCount, this->leftoverFrameCount - offset)
+      );
     }
 
-    {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    std::size_t remainingFrameCount = forwarder.CountRemainingFrames();
+    if(remainingFrameCount > 0) {
+      std::uint64_t nextFrame = startFrame + (frameCount - remainingFrameCount);
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
-      if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+      if(this->reader.GetFrameCursorPosition() != nextFrame) {
+        seekTo(nextFrame);
       }
 
-      InterleavingSampleForwarder<float> forwarder(
-        buffer, this->channelOrder.size(), this->trackInfo.BitsPerSample
+      // The forwarder will replace the leftover samples with the part of the final
+      // FLAC frame that goes beyond the requested range.
+      this->leftoverFrameCount = 0;
+      try {
+        this->reader.DecodeSeparated(
+          &forwarder,
+          &TForwarder::ProcessDecodedSamplesFunction,
+          remainingFrameCount
+        );
+      }
+      catch(...) {
+        this->leftoverFrameCount = 0;
+        throw;
+      }
+      this->leftoverStartFrame = (
+        this->reader.GetFrameCursorPosition() - this->leftoverFrameCount
       );
+    }
+  }
 
-      this->reader.DecodeSeparated(
-        &forwarder,
-        &InterleavingSampleForwarder<float>::ProcessDecodedSamplesFunction,
-        frameCount
-      );
-    } // mutex lock scope
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::uint8_t>(buffer, nullptr, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::int16_t>(buffer, nullptr, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::int32_t>(buffer, nullptr, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<float>(buffer, nullptr, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -267,10 +1130,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeInterleavedDouble(
     double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<double>(buffer, nullptr, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -278,10 +1139,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeSeparatedUint8(
     std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::uint8_t>(nullptr, buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -289,10 +1148,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeSeparatedInt16(
     std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::int16_t>(nullptr, buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -300,10 +1157,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeSeparatedInt32(
     std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<std::int32_t>(nullptr, buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -311,10 +1166,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeSeparatedFloat(
     float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<float>(nullptr, buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -322,10 +1175,41 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
   void FlacTrackDecoder::DecodeSeparatedDouble(
     double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    verifyDecodeRange(startFrame, frameCount);
+    this->decodeAndConvert<double>(nullptr, buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::seekTo(std::uint64_t startFrame) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Seek FLAC", this->file.get(), this);
+    this->statistics->AddSeek();
+
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(startFrame);
+    if(checkpoint != nullptr) {
+      NUCLEX_AUDIO_TRACE_MARK(u8"Restore FLAC checkpoint", this->file.get(), this);
+      this->reader.Restore(*checkpoint);
+    } else if(this->checkpoints.NoteSeek(startFrame)) {
+      this->checkpoints.AddCheckpoint(this->reader.Checkpoint(startFrame));
+    } else {
+      this->reader.Seek(startFrame);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackDecoder::verifyDecodeRange(
+    const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -26,9 +26,13 @@ limitations under the License.
 
 #include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
 #include "./FlacReader.h"
+#include "../Shared/DecoderStatisticsCollector.h"
+#include "../Shared/IntegrityVerifier.h"
 
 #include <mutex> // for std::mutex
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
@@ -43,6 +47,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     /// <summary>Frees all resources owned by the instance</summary>
     public: ~FlacTrackDecoder() override;
 
+    /// <summary>Initializes a new track decoder as a clone of another</summary>
+    /// <param name="other">Track decoder that will be cloned</param>
+    /// <remarks>
+    ///   The clone shares the file and the metadata already extracted from it with
+    ///   the original track decoder, but has its own reader and codec state.
+    /// </remarks>
+    private: FlacTrackDecoder(const FlacTrackDecoder &other);
+
     /// <summary>Creates a clone of the audio track decoder</summary>
     /// <returns>A clone of the audio track decoder that can be used independently</returns>
     public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
@@ -55,6 +67,24 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     /// <returns>A list of single channels in the order they're interleaved</returns>
     public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
 
+    /// <summary>Attempts to make the decoder verify the checksums stored in its file</summary>
+    /// <param name="policy">Whether to verify and whether to do it in the background</param>
+    /// <returns>True if the decoder will verify its file as requested</returns>
+    public: bool TrySetVerificationPolicy(VerificationPolicy policy) override;
+
+    /// <summary>Folds the file's ReplayGain into the sample conversion</summary>
+    /// <param name="mode">Whether to apply the track gain, the album gain or neither</param>
+    /// <returns>Always true, files without gain tags simply decode unchanged</returns>
+    /// <remarks>
+    ///   The samples <see cref="DecodeRange" /> hands out are libflac's own buffers
+    ///   and stay unscaled.
+    /// </remarks>
+    public: bool TrySetReplayGain(ReplayGainMode mode) override;
+
+    /// <summary>Reports the outcome of the checksum verification</summary>
+    /// <returns>The current state of the verification</returns>
+    public: VerificationResult GetVerificationResult() const override;
+
     /// <summary>Returns the number of frames (sample count in any one channel)</summary>
     /// <returns>The number of frames the audio file is long</returns>
     public: std::uint64_t CountFrames() const override;
@@ -67,6 +97,70 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     /// <returns>True if the codec decodes straight to interleaved channels</summary>
     public: bool IsNativelyInterleaved() const override;
 
+    /// <summary>Returns the number of frames in a typical block of the codec</summary>
+    /// <returns>The nominal number of frames in one of the codec's blocks</returns>
+    protected: std::size_t GetNominalBlockSize() const override;
+
+    /// <summary>Reports whether the FLAC frame containing a frame is constant or silent</summary>
+    /// <param name="frameIndex">Index of the frame whose FLAC frame will be described</param>
+    /// <returns>The extent of the FLAC frame and whether it is constant or silent</returns>
+    public: BlockContent DescribeBlock(std::uint64_t frameIndex) const override;
+
+    /// <summary>Describes all FLAC frames overlapping a range of frames</summary>
+    /// <param name="startFrame">Index of the first frame whose block will be described</param>
+    /// <param name="frameCount">Number of frames whose blocks will be described</param>
+    /// <returns>The descriptions of the FLAC frames in the order they appear</returns>
+    public: std::vector<BlockContent> ScanBlocks(
+      std::uint64_t startFrame, std::uint64_t frameCount
+    ) const override;
+
+    /// <summary>Builds the complete seek table by decoding the whole file</summary>
+    public: void BuildSeekIndex() const override;
+
+    /// <summary>Stores the seek table in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek table</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override;
+
+    /// <summary>Restores a seek table previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek table returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override;
+
+    /// <summary>Hands decoded audio frames to a sink without copying them</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="sink">Sink that receives libflac's decoding buffers</param>
+    public: void DecodeRange(
+      std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+    ) const override;
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override;
+
+    /// <summary>Retrieves the statistics the decoder has collected so far</summary>
+    /// <returns>The current values of the decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override;
+
+    /// <summary>Retrieves the distribution of the decoder's decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each decoding call took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override;
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
     // The public variant of the DecoeInterleaved() method delegates to our implementations
     public: using AudioTrackDecoder::DecodeInterleaved;
 
@@ -155,6 +249,55 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
     ) const override;
 
+    /// <summary>Moves the reader's frame cursor to the specified frame</summary>
+    /// <param name="startFrame">Frame the reader should decode next</param>
+    /// <remarks>
+    ///   Frames that are sought to repeatedly, such as loop points, get a checkpoint
+    ///   that lets the reader return to them without searching through the file.
+    /// </remarks>
+    private: void seekTo(std::uint64_t startFrame) const;
+
+    /// <summary>Throws an exception if the decoding range is out of bounds</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: void verifyDecodeRange(
+      const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio frames and converts them to the requested sample type</summary>
+    /// <typeparam name="TSample">Type of samples to decode as</typeparam>
+    /// <param name="buffer">
+    ///   Buffer in which the interleaved samples will be stored, null if decoding separated
+    /// </param>
+    /// <param name="buffers">
+    ///   Buffers in which the channels will be stored, null if decoding interleaved
+    /// </param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeAndConvert(
+      TSample *buffer, TSample *const buffers[],
+      const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio frames and hands them to the specified forwarder</summary>
+    /// <typeparam name="TForwarder">Type of forwarder that will receive the frames</typeparam>
+    /// <param name="forwarder">Forwarder that will receive the decoded frames</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <remarks>
+    ///   Takes care of picking up leftover samples from the previous call and of
+    ///   seeking if needed. The decoding mutex must be held by the caller.
+    /// </remarks>
+    private: template<typename TForwarder>
+    void decodeVia(
+      TForwarder &forwarder, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>File the audio track is being decoded from</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Counts frames, seeks, bytes read and decoding time if enabled</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
     /// <summary>Reader through which the audio file will be decoded</summary>
     private: mutable FlacReader reader;
     /// <summary>Informations about the audio track being decoded</summary>
@@ -168,6 +311,30 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
     ///   and complete Flac files, at most wrapped in a media container or archive.
     /// </remarks>
     private: std::uint64_t totalFrameCount;
+    /// <summary>Number of frames in a typical block of the Flac stream</summary>
+    private: std::size_t blockSize;
+    /// <summary>Positions of FLAC frames, shared with all clones of the decoder</summary>
+    private: std::shared_ptr<FlacSeekTable> seekTable;
+    /// <summary>Intermediate buffer used to convert samples before interleaving them</summary>
+    private: mutable SampleVector<std::byte> scratchBuffer;
+    /// <summary>Samples libflac decoded beyond the end of the previous decoding call</summary>
+    /// <remarks>
+    ///   libflac always delivers whole FLAC frames (typically 4096 samples per channel),
+    ///   so the last frame of a decoding call usually overshoots. Keeping the extra samples
+    ///   lets the next sequential decoding call use them instead of seeking back and
+    ///   decoding the same FLAC frame again. Channels are stored one after another.
+    /// </remarks>
+    private: mutable SampleVector<std::int32_t> leftoverSamples;
+    /// <summary>Index of the first frame stored in the leftover samples</summary>
+    private: mutable std::uint64_t leftoverStartFrame;
+    /// <summary>Number of frames stored for each channel in the leftover samples</summary>
+    private: mutable std::size_t leftoverFrameCount;
+    /// <summary>Checkpoints for frames the decoder keeps seeking back to</summary>
+    private: mutable Shared::DecoderCheckpointCache checkpoints;
+    /// <summary>Verifies the file's checksums if a verification policy is set</summary>
+    private: std::shared_ptr<const Shared::IntegrityVerifier> verifier;
+    /// <summary>Factor by which decoded samples are amplified, clones inherit it</summary>
+    private: float gainFactor;
     /// <summary>Must be held while decoding</summary>
     private: mutable std::mutex decodingMutex;
 
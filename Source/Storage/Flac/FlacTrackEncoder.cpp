@@ -0,0 +1,375 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacTrackEncoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Shared/ChannelOrderFactory.h"
+#include "../../Platform/FlacEncoderApi.h"
+#include "./FlacParallelEncoder.h"
+#include "./FlacReader.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <algorithm> // for std::min(), std::find()
+#include <cassert> // for assert()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames that are converted for the encoder in one go</summary>
+  const std::size_t ConversionFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacTrackEncoder::FlacTrackEncoder(
+    const std::shared_ptr<VirtualFile> &target,
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    std::size_t sampleRate,
+    std::size_t bitsPerSample,
+    unsigned compressionLevel,
+    std::size_t threadCount
+  ) :
+    target(target),
+    inputChannelOrder(inputChannelOrder),
+    inputChannelIndices(),
+    bitsPerSample(bitsPerSample),
+    sampleRate(sampleRate),
+    compressionLevel(compressionLevel),
+    convertedSamples(),
+    flacSamples(),
+    state(),
+    flacEncoder(),
+    parallelEncoder(),
+    isFinished(false) {
+
+    // FLAC has a fixed channel order for each channel count. Figure out where each
+    // of the channels in FLAC order can be found in the order the user feeds them.
+    std::size_t channelCount = this->inputChannelOrder.size();
+    std::vector<ChannelPlacement> flacChannelOrder = (
+      Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
+        channelCount,
+        FlacReader::ChannelPlacementFromChannelCountAndAssignment(
+          channelCount, FLAC__CHANNEL_ASSIGNMENT_INDEPENDENT
+        )
+      )
+    );
+    for(ChannelPlacement channel : flacChannelOrder) {
+      std::vector<ChannelPlacement>::const_iterator inputChannel = std::find(
+        this->inputChannelOrder.begin(), this->inputChannelOrder.end(), channel
+      );
+      if(unlikely(inputChannel == this->inputChannelOrder.end())) {
+        throw std::invalid_argument(
+          u8"Channel layout cannot be represented in FLAC without a channel mask tag"
+        );
+      }
+      this->inputChannelIndices.push_back(
+        static_cast<std::size_t>(inputChannel - this->inputChannelOrder.begin())
+      );
+    }
+
+    AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+    this->convertedSamples.resize(ConversionFrameCount * channelCount);
+    this->flacSamples.resize(ConversionFrameCount * channelCount);
+
+    if(threadCount >= 2) {
+      this->parallelEncoder = std::make_unique<FlacParallelEncoder>(
+        target, channelCount, bitsPerSample, sampleRate, compressionLevel, threadCount
+      );
+    } else {
+      this->flacEncoder = Platform::FlacEncoderApi::NewStreamEncoder();
+      configureStreamEncoder();
+
+      this->state = FileAdapterFactory::InitStreamEncoderForWriting(target, this->flacEncoder);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacTrackEncoder::~FlacTrackEncoder() {
+
+    // Deleting an unfinished libFLAC encoder finishes it, which writes through
+    // the adapter, so the encoder has to go before the adapter state does.
+    this->flacEncoder.reset();
+    this->state.reset();
+    this->parallelEncoder.reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &FlacTrackEncoder::GetChannelOrder() const {
+    return this->inputChannelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t FlacTrackEncoder::CountWrittenBytes() const {
+    return this->target->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::Flush() {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Flush FLAC", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    if(static_cast<bool>(this->parallelEncoder)) {
+      this->parallelEncoder->Finish();
+    } else {
+      this->isFinished = true;
+      Platform::FlacEncoderApi::Finish(this->state->Error, this->flacEncoder);
+      FileAdapterState::RethrowPotentialException(*this->state);
+    }
+
+    // The virtual file may be collecting writes in a buffer, make sure they get written
+    this->target->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlacTrackEncoder::Reopen(const std::shared_ptr<VirtualFile> &target) {
+
+    // The parallel encoder's chunk encoders and writer are tied to their file
+    if(static_cast<bool>(this->parallelEncoder)) {
+      return false;
+    }
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    // libFLAC can only be initialized again once the stream has been finished. If the user
+    // didn't flush, the old stream is finished here, but it's abandoned, so errors don't count.
+    if(!this->isFinished) {
+      try {
+        Platform::FlacEncoderApi::Finish(this->state->Error, this->flacEncoder);
+      }
+      catch(const std::exception &) {}
+    }
+
+    configureStreamEncoder();
+    this->state = FileAdapterFactory::InitStreamEncoderForWriting(target, this->flacEncoder);
+    this->target = target;
+    this->isFinished = false;
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeInterleavedUint8(
+    const std::uint8_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeInterleavedInt16(
+    const std::int16_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeInterleavedInt32(
+    const std::int32_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeInterleavedFloat(
+    const float *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeInterleavedDouble(
+    const double *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeSeparatedUint8(
+    const std::uint8_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeSeparatedInt16(
+    const std::int16_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeSeparatedInt32(
+    const std::int32_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeSeparatedFloat(
+    const float *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::EncodeSeparatedDouble(
+    const double *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void FlacTrackEncoder::encodeInterleaved(
+    const TSample *buffer, std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode FLAC", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+
+    // The sample converter leaves the valid bits in the upper end of the integer,
+    // libFLAC wants them in the lower end, so they'll be shifted down when reweaving
+    std::size_t shift = 32 - this->bitsPerSample;
+
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      Processing::SampleConverter::Convert(
+        buffer, sizeof(TSample) * 8,
+        this->convertedSamples.data(), this->bitsPerSample,
+        chunkFrameCount * channelCount
+      );
+
+      const std::int32_t *source = this->convertedSamples.data();
+      std::int32_t *target = this->flacSamples.data();
+      for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          target[channelIndex] = source[this->inputChannelIndices[channelIndex]] >> shift;
+        }
+        source += channelCount;
+        target += channelCount;
+      }
+
+      encodeFlacSamples(chunkFrameCount);
+
+      buffer += chunkFrameCount * channelCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void FlacTrackEncoder::encodeSeparated(
+    const TSample *buffers[], std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode FLAC", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+    std::size_t shift = 32 - this->bitsPerSample;
+
+    std::size_t offset = 0;
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        Processing::SampleConverter::Convert(
+          buffers[channelIndex] + offset, sizeof(TSample) * 8,
+          this->convertedSamples.data() + (channelIndex * ConversionFrameCount),
+          this->bitsPerSample,
+          chunkFrameCount
+        );
+      }
+
+      std::int32_t *target = this->flacSamples.data();
+      for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          std::size_t inputChannelIndex = this->inputChannelIndices[channelIndex];
+          target[channelIndex] = this->convertedSamples[
+            inputChannelIndex * ConversionFrameCount + frameIndex
+          ] >> shift;
+        }
+        target += channelCount;
+      }
+
+      encodeFlacSamples(chunkFrameCount);
+
+      offset += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::encodeFlacSamples(std::size_t frameCount) {
+    if(static_cast<bool>(this->parallelEncoder)) {
+      this->parallelEncoder->Encode(this->flacSamples.data(), frameCount);
+    } else {
+      Platform::FlacEncoderApi::ProcessInterleaved(
+        this->state->Error, this->flacEncoder, this->flacSamples.data(), frameCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlacTrackEncoder::configureStreamEncoder() {
+    Platform::FlacEncoderApi::SetFormat(
+      this->flacEncoder, this->inputChannelOrder.size(), this->bitsPerSample, this->sampleRate
+    );
+    Platform::FlacEncoderApi::SetCompressionLevel(this->flacEncoder, this->compressionLevel);
+    Platform::FlacEncoderApi::EnableMd5Calculation(this->flacEncoder, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,218 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_FLACTRACKENCODER_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_FLACTRACKENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include "./FlacVirtualFileAdapter.h"
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class FlacParallelEncoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes audio channels to a FLAC audio stream</summary>
+  /// <remarks>
+  ///   With a single thread, the encoder feeds one libFLAC stream encoder, which also
+  ///   records the MD5 signature of the audio data. With more threads, the stream is cut
+  ///   into chunks of independent FLAC frames that are encoded concurrently and written
+  ///   in order by the <see cref="FlacParallelEncoder" />.
+  /// </remarks>
+  class FlacTrackEncoder : public AudioTrackEncoder {
+
+    /// <summary>Initializes a new FLAC audio track encoder</summary>
+    /// <param name="target">File into which the encoded audio stream will be written</param>
+    /// <param name="inputChannelOrder">Order in which the channels will be fed in</param>
+    /// <param name="sampleRate">Intended playback rate in samples per second</param>
+    /// <param name="bitsPerSample">Number of bits each sample is stored with</param>
+    /// <param name="compressionLevel">libFLAC compression level from 0 to 8</param>
+    /// <param name="threadCount">Number of threads that will encode concurrently</param>
+    public: FlacTrackEncoder(
+      const std::shared_ptr<VirtualFile> &target,
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      std::size_t sampleRate,
+      std::size_t bitsPerSample,
+      unsigned compressionLevel,
+      std::size_t threadCount
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~FlacTrackEncoder() override;
+
+    /// <summary>Retrieves the channel order the encoder expects its samples in</summary>
+    /// <returns>A list of channels in the order the encoder expects them</returns>
+    /// <remarks>
+    ///   This order is configured in the encode builder and applied to both the interleaved
+    ///   ingestion methods and the separated ingestion methods.
+    /// </remarks>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
+
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: std::uint64_t CountWrittenBytes() const override;
+
+    /// <summary>Encodes any remaining samples and completes the FLAC stream</summary>
+    public: void Flush() override;
+
+    /// <summary>Starts a new FLAC stream in another output file</summary>
+    /// <param name="target">File into which the encoder will write from now on</param>
+    /// <returns>
+    ///   True if the encoder was reopened, false if it encodes with multiple threads
+    /// </returns>
+    /// <remarks>
+    ///   Finishing a libFLAC stream encoder resets its settings, but keeps its buffers,
+    ///   so the same stream encoder is configured and initialized again on the new file.
+    /// </remarks>
+    protected: bool Reopen(const std::shared_ptr<VirtualFile> &target) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedUint8(
+      const std::uint8_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt16(
+      const std::int16_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt32(
+      const std::int32_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedFloat(
+      const float *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedDouble(
+      const double *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedUint8(
+      const std::uint8_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt16(
+      const std::int16_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt32(
+      const std::int32_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedFloat(
+      const float *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedDouble(
+      const double *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeInterleaved(const TSample *buffer, std::size_t frameCount);
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeSeparated(const TSample *buffers[], std::size_t frameCount);
+
+    /// <summary>Hands the samples in the FLAC sample buffer to the encoder</summary>
+    /// <param name="frameCount">Number of audio frames in the FLAC sample buffer</param>
+    private: void encodeFlacSamples(std::size_t frameCount);
+
+    /// <summary>Applies the encoder's settings to the libFLAC stream encoder</summary>
+    private: void configureStreamEncoder();
+
+    /// <summary>File the encoded FLAC stream is written into</summary>
+    private: std::shared_ptr<VirtualFile> target;
+    /// <summary>Order in which the channels will be fed to the encoder</summary>
+    private: std::vector<ChannelPlacement> inputChannelOrder;
+    /// <summary>Index of the input channel for each channel in FLAC order</summary>
+    private: std::vector<std::size_t> inputChannelIndices;
+    /// <summary>Number of bits each sample is stored with</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Intended playback rate in samples per second</summary>
+    private: std::size_t sampleRate;
+    /// <summary>libFLAC compression level from 0 to 8</summary>
+    private: unsigned compressionLevel;
+    /// <summary>Input samples after conversion, still in the input channel order</summary>
+    private: SampleVector<std::int32_t> convertedSamples;
+    /// <summary>Right-aligned samples interleaved in FLAC channel order</summary>
+    private: SampleVector<std::int32_t> flacSamples;
+    /// <summary>State (emulated file cursor, errors) of the virtual file adapter</summary>
+    private: std::unique_ptr<WritableFileAdapterState> state;
+    /// <summary>Encoder that turns raw audio data into a FLAC stream</summary>
+    private: std::shared_ptr<::FLAC__StreamEncoder> flacEncoder;
+    /// <summary>Encodes chunks of the stream on several threads if requested</summary>
+    private: std::unique_ptr<FlacParallelEncoder> parallelEncoder;
+    /// <summary>Whether the stream encoder has been finished by a flush</summary>
+    private: bool isFinished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_FLACTRACKENCODER_H
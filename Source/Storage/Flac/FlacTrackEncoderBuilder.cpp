@@ -0,0 +1,259 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./FlacTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "./FlacTrackEncoder.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "./FlacReader.h" // for FlacReader
+#include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
+
+#include <algorithm> // for std::min(), std::max()
+#include <set> // for std::set
+#include <stdexcept> // for std::runtime_error
+#include <thread> // for std::thread::hardware_concurrency()
+
+#include <Nuclex/Support/BitTricks.h> // for BitTricks
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Highest compression level libFLAC offers</summary>
+  const int MaximumCompressionLevel = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Verifies that a set of channels matches the FLAC channel layout</summary>
+  /// <param name="channels">Channels the user wants to encode</param>
+  /// <param name="flacChannelOrder">Channels FLAC assumes for the channel count</param>
+  void requireFlacChannelLayout(
+    const std::set<Nuclex::Audio::ChannelPlacement> &channels,
+    const std::vector<Nuclex::Audio::ChannelPlacement> &flacChannelOrder
+  ) {
+    bool isFlacLayout = (channels.size() == flacChannelOrder.size());
+    for(Nuclex::Audio::ChannelPlacement channel : flacChannelOrder) {
+      isFlacLayout &= (channels.find(channel) != channels.end());
+    }
+
+    if(!isFlacLayout) {
+      throw std::runtime_error(
+        u8"Channel layout cannot be represented in FLAC. The set of channels you provided "
+        u8"does not fit the default channel assignment FLAC defines for the channel count "
+        u8"(writing a WAVEFORMATEXTENSIBLE_CHANNEL_MASK tag is not supported)."
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlacTrackEncoderBuilder::FlacTrackEncoderBuilder() :
+    inputChannelOrder(),
+    sampleRate(),
+    bitsPerSample(16),
+    effort(1.0f),
+    threadCount(1) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<
+    AudioSampleFormat
+  > &FlacTrackEncoderBuilder::GetSupportedSampleFormats() const {
+    static const std::vector<AudioSampleFormat> supportedFormats = {
+      AudioSampleFormat::UnsignedInteger_8,
+      AudioSampleFormat::SignedInteger_16,
+      AudioSampleFormat::SignedInteger_24
+    };
+    return supportedFormats;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &FlacTrackEncoderBuilder::GetSupportedSampleRates() const {
+    static const std::vector<std::size_t> supportedSampleRates; // empty vector = any
+    return supportedSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &FlacTrackEncoderBuilder::GetPreferredSampleRates() const {
+    static const std::vector<std::size_t> preferredSampleRates; // empty vector = neutral
+    return preferredSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> FlacTrackEncoderBuilder::GetPreferredChannelOrder(
+    ChannelPlacement channels
+  ) const {
+    std::size_t channelCount = Nuclex::Support::BitTricks::CountBits(
+      static_cast<std::size_t>(channels)
+    );
+    std::vector<ChannelPlacement> flacChannelOrder = getFlacChannelOrder(channelCount);
+
+    // Verify that this channel set is representable in a FLAC audio file
+    {
+      std::set<ChannelPlacement> presentChannels;
+      for(std::size_t index = 0; index < 17; ++index) {
+        ChannelPlacement channel = static_cast<ChannelPlacement>(1 << index);
+        if((channels & channel) != ChannelPlacement::Unknown) {
+          presentChannels.insert(channel);
+        }
+      }
+      requireFlacChannelLayout(presentChannels, flacChannelOrder);
+    }
+
+    return flacChannelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetSampleFormat(
+    AudioSampleFormat format /* = AudioSampleFormat::SignedInteger_16 */
+  ) {
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8: { this->bitsPerSample = 8; break; }
+      case AudioSampleFormat::SignedInteger_16: { this->bitsPerSample = 16; break; }
+      case AudioSampleFormat::SignedInteger_24: { this->bitsPerSample = 24; break; }
+      default: {
+        throw std::invalid_argument(
+          u8"FLAC encoder can only store 8-bit, 16-bit or 24-bit integer samples"
+        );
+      }
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetSampleRate(
+    std::size_t samplesPerSecond /* = 48000 */
+  ) {
+    this->sampleRate = samplesPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetChannels(
+    const std::vector<ChannelPlacement> &orderedChannels
+  ) {
+    std::set<ChannelPlacement> presentChannels(orderedChannels.begin(), orderedChannels.end());
+    if(presentChannels.size() != orderedChannels.size()) {
+      throw std::invalid_argument(u8"Each channel may only appear once in the channel order");
+    }
+    requireFlacChannelLayout(presentChannels, getFlacChannelOrder(orderedChannels.size()));
+
+    this->inputChannelOrder = orderedChannels;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetTargetBitrate(
+    float kilobitsPerSecond
+  ) {
+    (void)kilobitsPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetCompressionEffort(
+    float newEffort /* = 1.0f */
+  ) {
+    this->effort = newEffort;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &FlacTrackEncoderBuilder::SetThreadCount(
+    std::size_t newThreadCount /* = 0 */
+  ) {
+    this->threadCount = newThreadCount;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackEncoder> FlacTrackEncoderBuilder::Build(
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(this->inputChannelOrder.empty()) {
+      throw std::runtime_error(
+        u8"Input channels and channel order for the encoder have not been set"
+      );
+    }
+    if(!this->sampleRate.has_value()) {
+      throw std::runtime_error(u8"Input sample rate for the encoder has not been set");
+    }
+
+    int compressionLevel = static_cast<int>(
+      this->effort * static_cast<float>(MaximumCompressionLevel) + 0.5f
+    );
+    compressionLevel = std::min(std::max(compressionLevel, 0), MaximumCompressionLevel);
+
+    std::size_t actualThreadCount = this->threadCount;
+    if(actualThreadCount == 0) {
+      actualThreadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Flac);
+
+    return std::make_shared<FlacTrackEncoder>(
+      target,
+      this->inputChannelOrder,
+      this->sampleRate.value(),
+      this->bitsPerSample,
+      static_cast<unsigned>(compressionLevel),
+      actualThreadCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> FlacTrackEncoderBuilder::getFlacChannelOrder(
+    std::size_t channelCount
+  ) {
+    return Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
+      channelCount,
+      FlacReader::ChannelPlacementFromChannelCountAndAssignment(
+        channelCount, FLAC__CHANNEL_ASSIGNMENT_INDEPENDENT
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -31,8 +31,10 @@ limitations under the License.
 #include <Nuclex/Support/ScopeGuard.h> // for ScopeGuard
 
 #include "Nuclex/Audio/Storage/VirtualFile.h" // for VitualFile
+#include "Nuclex/Audio/Storage/SequentialSource.h" // for SequentialSource
 
 #include "../../Platform/FlacApi.h" // for the wrapped FLAC API methods
+#include "../../Platform/FlacEncoderApi.h" // for the wrapped FLAC encoder API methods
 
 namespace {
 
@@ -187,6 +189,60 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Reads up to <see cref="bytes" /> of data from a sequential source</summary>
+  /// <param name="decoder">FLAC stream decoder that is requesting the bytes</param>
+  /// <param name="buffer">Buffer to store the data</param>
+  /// <param name="bytes">Maximum number of bytes to read, receives actual bytes read</param>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <returns>Whether the bytes were read successfully, failed or data ran out</returns>
+  ::FLAC__StreamDecoderReadStatus flacReadSequential(
+    const ::FLAC__StreamDecoder *decoder,
+    ::FLAC__byte buffer[], size_t *bytes,
+    void *stateAsVoid
+  ) {
+    (void)decoder;
+    Nuclex::Audio::Storage::Flac::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Flac::SequentialSourceAdapterState *
+    >(stateAsVoid);
+
+    std::size_t readByteCount;
+    try {
+      readByteCount = state.Source->ReadSome(reinterpret_cast<std::byte *>(buffer), *bytes);
+    }
+    catch(const std::exception &) {
+      state.Error = std::current_exception();
+      return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+    }
+
+    *bytes = readByteCount;
+    state.FileCursor += readByteCount;
+    if(readByteCount == 0) {
+      state.IsAtEnd = true;
+      return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+    }
+
+    return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks if the sequential source has run out of data</summary>
+  /// <param name="decoder">FLAC stream decoder that wants to know if it's at the end</param>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <returns>True if the sequential source has reported the end of its data</returns>
+  ::FLAC__bool flacEofSequential(
+    const ::FLAC__StreamDecoder *decoder,
+    void *stateAsVoid
+  ) {
+    (void)decoder;
+    Nuclex::Audio::Storage::Flac::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Flac::SequentialSourceAdapterState *
+    >(stateAsVoid);
+    return state.IsAtEnd ? 1 : 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Forwards the sample processing callback to the decode processor</summary>
   /// <param name="decoder">FLAC stream decoder that has decoded audio samples</param>
   /// <param name="frame">Informations about the decoded audio frame</param>
@@ -267,6 +323,90 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Writes encoded data produced by a FLAC stream encoder to a virtual file</summary>
+  /// <param name="encoder">FLAC stream encoder that is delivering the data</param>
+  /// <param name="buffer">Buffer holding the encoded data</param>
+  /// <param name="bytes">Number of bytes that should be written</param>
+  /// <param name="samples">Number of samples in the data or 0 for metadata</param>
+  /// <param name="currentFrame">Index of the FLAC frame the data belongs to</param>
+  /// <param name="stateAsVoid">State of the virtual file adapter class</param>
+  /// <returns>Whether the data was written or the encoder should give up</returns>
+  ::FLAC__StreamEncoderWriteStatus flacWrite(
+    const ::FLAC__StreamEncoder *encoder,
+    const ::FLAC__byte buffer[], size_t bytes,
+    std::uint32_t samples, std::uint32_t currentFrame,
+    void *stateAsVoid
+  ) {
+    (void)encoder;
+    (void)samples;
+    (void)currentFrame;
+    Nuclex::Audio::Storage::Flac::WritableFileAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Flac::WritableFileAdapterState *
+    >(stateAsVoid);
+
+    try {
+      state.File->WriteAt(state.FileCursor, bytes, reinterpret_cast<const std::byte *>(buffer));
+    }
+    catch(const std::exception &) {
+      state.Error = std::current_exception();
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+    }
+
+    state.FileCursor += bytes;
+
+    return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves the file cursor of the encoder to a different position</summary>
+  /// <param name="encoder">FLAC stream encoder that is requesting the seek</param>
+  /// <param name="newPosition">Absolute file offset to seek to</param>
+  /// <param name="stateAsVoid">State of the virtual file adapter class</param>
+  /// <returns>Whether the seek was performed or failed</returns>
+  /// <remarks>
+  ///   The encoder only seeks back to rewrite the stream info block when it finishes,
+  ///   so unlike the decoder's seek, the position is always within the written data.
+  /// </remarks>
+  ::FLAC__StreamEncoderSeekStatus flacEncoderSeek(
+    const ::FLAC__StreamEncoder *encoder,
+    ::FLAC__uint64 newPosition,
+    void *stateAsVoid
+  ) {
+    (void)encoder;
+    Nuclex::Audio::Storage::Flac::FileAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Flac::FileAdapterState *
+    >(stateAsVoid);
+
+    state.FileCursor = newPosition;
+
+    return FLAC__STREAM_ENCODER_SEEK_STATUS_OK;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the current position of the encoder's file cursor</summary>
+  /// <param name="encoder">FLAC stream encoder that is requesting the file position</param>
+  /// <param name="currentPosition">Receives the current position of the file cursor</param>
+  /// <param name="stateAsVoid">State of the virtual file adapter class</param>
+  /// <returns>Whether the file cursor was retrieved successfully</returns>
+  ::FLAC__StreamEncoderTellStatus flacEncoderTell(
+    const ::FLAC__StreamEncoder *encoder,
+    ::FLAC__uint64 *currentPosition,
+    void *stateAsVoid
+  ) {
+    (void)encoder;
+    Nuclex::Audio::Storage::Flac::FileAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Flac::FileAdapterState *
+    >(stateAsVoid);
+
+    *currentPosition = state.FileCursor;
+
+    return FLAC__STREAM_ENCODER_TELL_STATUS_OK;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
@@ -307,37 +447,31 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
-  std::unique_ptr<WritableFileAdapterState> FileAdapterFactory::InitStreamDecoderForWriting(
-    const std::shared_ptr<VirtualFile> &writableFile,
+  std::unique_ptr<SequentialSourceAdapterState>
+  FileAdapterFactory::InitStreamDecoderForSequentialReading(
+    const std::shared_ptr<SequentialSource> &source,
     const std::shared_ptr<::FLAC__StreamDecoder> &decoder,
     FlacDecodeProcessor *decodeProcessor
   ) {
-    std::unique_ptr<WritableFileAdapterState> adapter = (
-      std::make_unique<WritableFileAdapterState>()
+    std::unique_ptr<SequentialSourceAdapterState> adapter = (
+      std::make_unique<SequentialSourceAdapterState>()
     );
 
-    // This method doesn't make much sense as it is.
-    //
-    // For consistency and easy-of-understand, I'm implementing it to follow the other
-    // codec implementations. Howver, for FLAC, the decoder and encoder are split into
-    // two unrealted classes (and the decoder has, in fact, no write callbacks it could
-    // invoke), so once I implement encoding, this will need several other callbacks and
-    // a FLAC__StreamEncoder or similar to open a stream on.
-
     adapter->IsReadOnly = true;
     adapter->FileCursor = 0;
     adapter->DecodeProcessor = decodeProcessor;
     adapter->Error = std::exception_ptr();
-    adapter->File = writableFile;
+    adapter->Source = source;
+    adapter->IsAtEnd = false;
 
     Platform::FlacApi::InitStream(
       adapter->Error,
       decoder,
-      &flacRead<WritableFileAdapterState>,
-      &flacSeek<WritableFileAdapterState>,
-      &flacTell,
-      &flacLength<WritableFileAdapterState>,
-      &flacEof<WritableFileAdapterState>,
+      &flacReadSequential,
+      nullptr, // no seeking
+      nullptr, // no file cursor
+      nullptr, // no known length
+      &flacEofSequential,
       &flacProcessSamples,
       &flacProcessMetadata,
       &flacHandleError,
@@ -349,6 +483,34 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::unique_ptr<WritableFileAdapterState> FileAdapterFactory::InitStreamEncoderForWriting(
+    const std::shared_ptr<VirtualFile> &writableFile,
+    const std::shared_ptr<::FLAC__StreamEncoder> &encoder
+  ) {
+    std::unique_ptr<WritableFileAdapterState> adapter = (
+      std::make_unique<WritableFileAdapterState>()
+    );
+
+    adapter->IsReadOnly = false;
+    adapter->FileCursor = 0;
+    adapter->DecodeProcessor = nullptr;
+    adapter->Error = std::exception_ptr();
+    adapter->File = writableFile;
+
+    Platform::FlacEncoderApi::InitStream(
+      adapter->Error,
+      encoder,
+      &flacWrite,
+      &flacEncoderSeek,
+      &flacEncoderTell,
+      adapter.get()
+    );
+
+    return adapter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Flac
 
 #endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
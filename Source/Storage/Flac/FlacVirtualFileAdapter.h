@@ -27,6 +27,7 @@ limitations under the License.
 #include "../Shared/VirtualFileAdapterState.h"
 
 #include <FLAC/stream_decoder.h> // for the callback signatures
+#include <FLAC/stream_encoder.h> // for the encoder callback signatures
 
 #include <memory> // for std::unique_ptr
 
@@ -85,6 +86,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Stores informations processed by the FLAC sequential source adapter</summary>
+  struct SequentialSourceAdapterState : public FileAdapterState {
+
+    /// <summary>Sequential source this adapter is forwarding calls to</summary>
+    public: std::shared_ptr<SequentialSource> Source;
+    /// <summary>Whether the sequential source has reported the end of its data</summary>
+    public: bool IsAtEnd;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Stores informations processed by the FLAC stream writer adapter</summary>
   struct WritableFileAdapterState : public FileAdapterState {
 
@@ -95,7 +108,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Initializes FLAC stream decoders with virtual file callbacks</summary>
+  /// <summary>Initializes FLAC stream decoders and encoders with virtual file callbacks</summary>
   class FileAdapterFactory {
 
     /// <summayr>Initialies a FLAC stream deocder with callbacks for a read-only file</summary>
@@ -113,21 +126,39 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
       FlacDecodeProcessor *decodeProcessor
     );
 
-    /// <summayr>Initialies a FLAC stream deocder with callbacks for a writable file</summary>
-    /// <param name="writableFile">Virtual file the adapter will write to</param>
-    /// <param name="fileCallbacks">
+    /// <summary>Initializes a FLAC stream decoder with callbacks for a sequential source</summary>
+    /// <param name="source">Sequential source the adapter will read from</param>
+    /// <param name="decoder">
     ///   FLAC stream decoder that will set up to use the adapter
     /// </param>
     /// <param name="decodeProcessor">Interface to deliver decoded data to</param>
     /// <returns>
     ///   A state that needs to be kept alive for as long as the stream decoder exists
     /// </returns>
-    public: static std::unique_ptr<WritableFileAdapterState> InitStreamDecoderForWriting(
-      const std::shared_ptr<VirtualFile> &writableFile,
+    /// <remarks>
+    ///   The decoder is set up without seek, tell and length callbacks, so libFLAC
+    ///   will read the stream front to back and never try to jump around in it.
+    /// </remarks>
+    public: static std::unique_ptr<SequentialSourceAdapterState>
+    InitStreamDecoderForSequentialReading(
+      const std::shared_ptr<SequentialSource> &source,
       const std::shared_ptr<::FLAC__StreamDecoder> &decoder,
       FlacDecodeProcessor *decodeProcessor
     );
 
+    /// <summary>Initializes a FLAC stream encoder with callbacks for a writable file</summary>
+    /// <param name="writableFile">Virtual file the adapter will write to</param>
+    /// <param name="encoder">
+    ///   FLAC stream encoder that will set up to use the adapter
+    /// </param>
+    /// <returns>
+    ///   A state that needs to be kept alive for as long as the stream encoder exists
+    /// </returns>
+    public: static std::unique_ptr<WritableFileAdapterState> InitStreamEncoderForWriting(
+      const std::shared_ptr<VirtualFile> &writableFile,
+      const std::shared_ptr<::FLAC__StreamEncoder> &encoder
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
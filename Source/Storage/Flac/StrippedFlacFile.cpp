@@ -0,0 +1,224 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./StrippedFlacFile.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Type of the metadata block holding the stream's format</summary>
+  const std::uint8_t StreamInfoBlockType = 0;
+  /// <summary>Type of the metadata block holding the seek table</summary>
+  const std::uint8_t SeekTableBlockType = 3;
+  /// <summary>Type of the metadata block holding the Vorbis comments</summary>
+  const std::uint8_t VorbisCommentBlockType = 4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a decoder needs a metadata block of the specified type</summary>
+  /// <param name="blockType">Type of metadata block that will be checked</param>
+  /// <returns>True if the block has to be kept for decoding</returns>
+  bool isNeededForDecoding(std::uint8_t blockType) {
+    return (
+      (blockType == StreamInfoBlockType) ||
+      (blockType == SeekTableBlockType) ||
+      (blockType == VorbisCommentBlockType)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> StrippedFlacFile::TryWrap(
+    const std::shared_ptr<const VirtualFile> &file
+  ) {
+    std::uint64_t fileLength = file->GetSize();
+    if(fileLength < 8) {
+      return file;
+    }
+
+    // Only plain FLAC files are handled. Files with an ID3v2 tag in front or anything
+    // else unusual are handed to libflac unchanged.
+    std::byte blockHeader[4];
+    file->ReadAt(0, 4, blockHeader);
+    bool isPlainFlac = (
+      (blockHeader[0] == std::byte(0x66)) && //  1 f | "fLaC" (stream marker)
+      (blockHeader[1] == std::byte(0x4c)) && //  2 L |
+      (blockHeader[2] == std::byte(0x61)) && //  3 a | Begins every native FLAC stream,
+      (blockHeader[3] == std::byte(0x43))    //  4 C | the metadata blocks follow.
+    );
+    if(!isPlainFlac) {
+      return file;
+    }
+
+    // Walk the metadata block headers, only remembering where the blocks we keep are.
+    // Each header has the last-block flag, the block type and a 24-bit length.
+    std::vector<std::pair<std::uint64_t, std::size_t>> keptBlocks;
+    std::uint64_t strippedByteCount = 0;
+    std::uint64_t offset = 4;
+    for(;;) {
+      if(fileLength - offset < 4) {
+        return file; // Metadata runs past the end of the file
+      }
+      file->ReadAt(offset, 4, blockHeader);
+
+      std::uint8_t blockType = static_cast<std::uint8_t>(blockHeader[0]) & 0x7F;
+      std::size_t blockLength = (
+        (static_cast<std::size_t>(blockHeader[1]) << 16) |
+        (static_cast<std::size_t>(blockHeader[2]) << 8) |
+        static_cast<std::size_t>(blockHeader[3])
+      );
+      if(fileLength - offset - 4 < blockLength) {
+        return file;
+      }
+
+      if(isNeededForDecoding(blockType)) {
+        keptBlocks.emplace_back(offset, blockLength + 4);
+      } else {
+        strippedByteCount += blockLength + 4;
+      }
+
+      offset += blockLength + 4;
+      if((static_cast<std::uint8_t>(blockHeader[0]) & 0x80) != 0) {
+        break; // This was the last metadata block
+      }
+    }
+
+    if((strippedByteCount < MinimumStrippedByteCount) || keptBlocks.empty()) {
+      return file;
+    }
+
+    // Copy the kept blocks behind the stream marker and move the last-block flag
+    // to whichever of them now is the final one
+    std::vector<std::byte> header(4);
+    std::copy_n(u8"fLaC", 4, reinterpret_cast<char *>(header.data()));
+    for(const std::pair<std::uint64_t, std::size_t> &block : keptBlocks) {
+      std::size_t blockStart = header.size();
+      header.resize(blockStart + block.second);
+      file->ReadAt(block.first, block.second, header.data() + blockStart);
+      header[blockStart] &= std::byte(0x7F);
+    }
+    header[header.size() - keptBlocks.back().second] |= std::byte(0x80);
+
+    return std::make_shared<StrippedFlacFile>(file, std::move(header), offset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StrippedFlacFile::StrippedFlacFile(
+    const std::shared_ptr<const VirtualFile> &file,
+    std::vector<std::byte> &&header,
+    std::uint64_t audioOffset
+  ) :
+    file(file),
+    header(std::move(header)),
+    audioOffset(audioOffset),
+    length(this->header.size() + (file->GetSize() - audioOffset)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StrippedFlacFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::size_t headerLength = this->header.size();
+    if(start < headerLength) {
+      std::size_t headerByteCount = std::min<std::size_t>(
+        byteCount, headerLength - static_cast<std::size_t>(start)
+      );
+      std::copy_n(this->header.data() + start, headerByteCount, buffer);
+
+      start += headerByteCount;
+      byteCount -= headerByteCount;
+      buffer += headerByteCount;
+    }
+
+    if(byteCount > 0) {
+      this->file->ReadAt(start - headerLength + this->audioOffset, byteCount, buffer);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StrippedFlacFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    std::size_t headerLength = this->header.size();
+    if(start < headerLength) {
+      std::size_t headerByteCount = static_cast<std::size_t>(headerLength - start);
+      if(byteCount <= headerByteCount) {
+        return; // Entirely in memory, nothing to fetch
+      }
+
+      start = headerLength;
+      byteCount -= headerByteCount;
+    }
+
+    this->file->Prefetch(start - headerLength + this->audioOffset, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *StrippedFlacFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+
+    // Zero-byte borrows are how callers check whether a file is memory-backed.
+    // Even if the wrapped file is, the stripped view isn't one contiguous block.
+    if(byteCount == 0) {
+      return nullptr;
+    }
+
+    std::size_t headerLength = this->header.size();
+    if(start >= headerLength) {
+      return this->file->TryBorrowAt(start - headerLength + this->audioOffset, byteCount);
+    } else if(headerLength - start >= byteCount) {
+      return this->header.data() + start;
+    } else {
+      return nullptr; // Range straddles the kept metadata and the audio frames
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StrippedFlacFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Stripped FLAC files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,141 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_FLAC_STRIPPEDFLACFILE_H
+#define NUCLEX_AUDIO_STORAGE_FLAC_STRIPPEDFLACFILE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Presents a FLAC file with only the metadata blocks a decoder needs</summary>
+  /// <remarks>
+  ///   <para>
+  ///     libflac reads through every metadata block it encounters, even those it was
+  ///     told to ignore. Files with embedded cover art can carry megabytes of PICTURE
+  ///     blocks before the first audio frame, all of which would be read each time
+  ///     a decoder is opened.
+  ///   </para>
+  ///   <para>
+  ///     This wrapper keeps the STREAMINFO, SEEKTABLE and VORBIS_COMMENT blocks (the
+  ///     latter carries the channel mask) in memory and appends the audio frames of
+  ///     the wrapped file behind them. Pictures, padding, application data and cue
+  ///     sheets disappear from the decoder's view. Seek table offsets are relative to
+  ///     the first audio frame, so they remain valid.
+  ///   </para>
+  /// </remarks>
+  class StrippedFlacFile : public VirtualFile {
+
+    /// <summary>Number of skippable bytes that make stripping worthwhile</summary>
+    /// <remarks>
+    ///   Most FLAC files have a few kilobytes of padding after their metadata. Reading
+    ///   through that costs less than redirecting every read, so such files are used
+    ///   as they are.
+    /// </remarks>
+    public: static const std::size_t MinimumStrippedByteCount = 65536;
+
+    /// <summary>Wraps a FLAC file if it has enough metadata to strip</summary>
+    /// <param name="file">FLAC file that will be wrapped</param>
+    /// <returns>
+    ///   A stripped view of the file or the file itself if it has little to strip or
+    ///   doesn't look like a plain FLAC file (in which case libflac will report on it)
+    /// </returns>
+    public: static std::shared_ptr<const VirtualFile> TryWrap(
+      const std::shared_ptr<const VirtualFile> &file
+    );
+
+    /// <summary>Initializes a new stripped view of a FLAC file</summary>
+    /// <param name="file">FLAC file the audio frames will be read from</param>
+    /// <param name="header">Signature and metadata blocks that will be kept</param>
+    /// <param name="audioOffset">Offset of the first audio frame in the file</param>
+    public: StrippedFlacFile(
+      const std::shared_ptr<const VirtualFile> &file,
+      std::vector<std::byte> &&header,
+      std::uint64_t audioOffset
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~StrippedFlacFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override;
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer into the kept metadata or into the wrapped file's memory if the range
+    ///   lies entirely in either, otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Stripped FLAC files are always read-only, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>File the audio frames are read from</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>FLAC signature and the metadata blocks that were kept</summary>
+    private: std::vector<std::byte> header;
+    /// <summary>Offset of the first audio frame in the wrapped file</summary>
+    private: std::uint64_t audioOffset;
+    /// <summary>Length of the stripped view in bytes</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#endif // NUCLEX_AUDIO_STORAGE_FLAC_STRIPPEDFLACFILE_H
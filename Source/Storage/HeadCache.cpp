@@ -0,0 +1,212 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include <algorithm> // for std::min()
+#include <optional> // for std::optional
+#include <stdexcept> // for std::exception
+#include <utility> // for std::move()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the file extension from a path</summary>
+  /// <param name="path">Path whose file extension will be extracted</param>
+  /// <returns>The file extension without the dot or an empty string if there is none</returns>
+  std::string getExtension(const std::string &path) {
+    std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of("\\/");
+#else
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+    bool dotBelongsToFilename = (
+      (extensionDotIndex != std::string::npos) &&
+      (
+        (lastPathSeparatorIndex == std::string::npos) ||
+        (extensionDotIndex > lastPathSeparatorIndex)
+      )
+    );
+    if(dotBelongsToFilename) {
+      return path.substr(extensionDotIndex + 1);
+    } else {
+      return std::string();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HeadCache::HeadCache(std::size_t headMilliseconds /* = 250 */) :
+    headMilliseconds(headMilliseconds),
+    heads(),
+    headsMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HeadCache::~HeadCache() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t HeadCache::Preload(
+    const AudioLoader &loader, const std::vector<std::string> &paths
+  ) {
+    std::vector<std::shared_ptr<const CachedHead>> loadedHeads(paths.size());
+
+    // Each asset is opened and decoded independently. The calling thread helps out,
+    // so this finishes even if all of the executor's workers are busy.
+    Executor::GetInstalled()->ParallelFor(
+      paths.size(),
+      [&](std::size_t index) {
+        try {
+          std::string extension = getExtension(paths[index]);
+          std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+            paths[index], true
+          );
+
+          std::optional<ContainerInfo> info = loader.TryReadInfo(file, extension);
+          if(!info.has_value() || info->Tracks.empty()) {
+            return;
+          }
+
+          std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(file, extension);
+          loadedHeads[index] = decodeHead(*decoder, info->Tracks[0].SampleRate);
+        }
+        catch(const std::exception &) {
+          // Skip the asset, voices playing it will open it normally and fail there
+        }
+      }
+    );
+
+    std::size_t loadedHeadCount = 0;
+    {
+      std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+      for(std::size_t index = 0; index < paths.size(); ++index) {
+        if(static_cast<bool>(loadedHeads[index])) {
+          this->heads[paths[index]] = std::move(loadedHeads[index]);
+          ++loadedHeadCount;
+        }
+      }
+    }
+
+    return loadedHeadCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HeadCache::Add(
+    const std::string &path, const AudioTrackDecoder &decoder, std::size_t sampleRate
+  ) {
+    std::shared_ptr<const CachedHead> head = decodeHead(decoder, sampleRate);
+
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+    this->heads[path] = std::move(head);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CachedHead> HeadCache::TryGetHead(const std::string &path) const {
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+
+    auto iterator = this->heads.find(path);
+    if(iterator == this->heads.end()) {
+      return std::shared_ptr<const CachedHead>();
+    } else {
+      return iterator->second;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HeadCache::Remove(const std::string &path) {
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+    this->heads.erase(path);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HeadCache::Clear() {
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+    this->heads.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t HeadCache::CountHeads() const {
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+    return this->heads.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t HeadCache::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> headsMutexScope(this->headsMutex);
+
+    std::size_t byteCount = 0;
+    for(auto iterator = this->heads.begin(); iterator != this->heads.end(); ++iterator) {
+      byteCount += iterator->second->Samples.size() * sizeof(float);
+    }
+
+    return byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CachedHead> HeadCache::decodeHead(
+    const AudioTrackDecoder &decoder, std::size_t sampleRate
+  ) const {
+    std::shared_ptr<CachedHead> head = std::make_shared<CachedHead>();
+    head->ChannelCount = decoder.CountChannels();
+    head->TotalFrameCount = decoder.CountFrames();
+
+    // Round up so that a head never ends a fraction of a frame too early
+    std::uint64_t wantedFrameCount = (
+      (static_cast<std::uint64_t>(sampleRate) * this->headMilliseconds + 999) / 1000
+    );
+    head->FrameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(wantedFrameCount, head->TotalFrameCount)
+    );
+
+    head->Samples.resize(head->FrameCount * head->ChannelCount);
+    if(head->FrameCount > 0) {
+      decoder.DecodeInterleaved<float>(head->Samples.data(), 0, head->FrameCount);
+    }
+
+    return head;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,87 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "HeaderBufferedFile.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  HeaderBufferedFile::HeaderBufferedFile(const std::shared_ptr<const VirtualFile> &file) :
+    file(file),
+    length(file->GetSize()),
+    header(static_cast<std::size_t>(std::min<std::uint64_t>(this->length, HeaderByteCount))) {
+    if(!this->header.empty()) {
+      this->file->ReadAt(0, this->header.size(), this->header.data());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HeaderBufferedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::size_t headerLength = this->header.size();
+    if((start <= headerLength) && (headerLength - start >= byteCount)) {
+      std::copy_n(this->header.data() + start, byteCount, buffer);
+    } else {
+      this->file->ReadAt(start, byteCount, buffer);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *HeaderBufferedFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    const std::byte *borrowed = this->file->TryBorrowAt(start, byteCount);
+    if(borrowed != nullptr) {
+      return borrowed;
+    }
+
+    // Zero-byte borrows are how callers check whether a file is memory-backed,
+    // which this wrapper is not, so those are always refused
+    std::size_t headerLength = this->header.size();
+    if((start <= headerLength) && (headerLength - start >= byteCount) && (byteCount > 0)) {
+      return this->header.data() + start;
+    } else {
+      return nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void HeaderBufferedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Header-buffered files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
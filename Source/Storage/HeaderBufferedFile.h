@@ -0,0 +1,127 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_HEADERBUFFEREDFILE_H
+#define NUCLEX_AUDIO_STORAGE_HEADERBUFFEREDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the beginning of another file once and serves header reads from it</summary>
+  /// <remarks>
+  ///   <para>
+  ///     When the audio loader looks for a codec that can handle a file, each codec's
+  ///     detection reads the file header on its own. On a file whose extension doesn't
+  ///     match, that amounts to up to one read per registered codec, each a round trip
+  ///     to the disk (or the network). This wrapper reads the first few kilobytes in
+  ///     a single call when it is created and answers any read falling entirely inside
+  ///     of them from memory.
+  ///   </para>
+  ///   <para>
+  ///     Reads extending beyond the buffered header are passed on to the wrapped file
+  ///     unchanged. The buffer is never modified after construction, so the wrapper is
+  ///     exactly as thread-safe as the file it wraps.
+  ///   </para>
+  /// </remarks>
+  class HeaderBufferedFile : public VirtualFile {
+
+    /// <summary>Number of bytes from the beginning of the file that are buffered</summary>
+    /// <remarks>
+    ///   Covers the detection headers of all built-in codecs with plenty of room for
+    ///   the first metadata blocks codecs read while parsing their stream informations.
+    /// </remarks>
+    public: static constexpr std::size_t HeaderByteCount = 4096;
+
+    /// <summary>Initializes a new header-buffering wrapper around the specified file</summary>
+    /// <param name="file">File whose header will be buffered</param>
+    public: HeaderBufferedFile(const std::shared_ptr<const VirtualFile> &file);
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~HeaderBufferedFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    public: void ReadManyAt(
+      const ReadRequest *requests, std::size_t requestCount
+    ) const override {
+      this->file->ReadManyAt(requests, requestCount);
+    }
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the wrapped file's memory if it supports borrowing, a pointer into
+    ///   the buffered header if the range lies within it, otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Header-buffered files are always read-only, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>File whose header is being buffered</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Length of the wrapped file in bytes</summary>
+    private: std::uint64_t length;
+    /// <summary>Contents of the wrapped file's first bytes</summary>
+    private: std::vector<std::byte> header;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_HEADERBUFFEREDFILE_H
@@ -0,0 +1,326 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/InstrumentedFile.h"
+
+#include <algorithm> // for std::min(), std::max(), std::find()
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the name under which a kind of access appears in traces</summary>
+  /// <param name="kind">Kind of access whose name will be returned</param>
+  /// <returns>The name of the specified kind of access</returns>
+  const char *getKindName(Nuclex::Audio::Storage::FileAccessKind kind) {
+    switch(kind) {
+      case Nuclex::Audio::Storage::FileAccessKind::Read: { return u8"read"; }
+      case Nuclex::Audio::Storage::FileAccessKind::BatchRead: { return u8"batch-read"; }
+      case Nuclex::Audio::Storage::FileAccessKind::Borrow: { return u8"borrow"; }
+      case Nuclex::Audio::Storage::FileAccessKind::Prefetch: { return u8"prefetch"; }
+      case Nuclex::Audio::Storage::FileAccessKind::Write: { return u8"write"; }
+      default: { return u8"unknown"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InstrumentedFile::InstrumentedFile(
+    const std::shared_ptr<const VirtualFile> &file, bool recordAccesses /* = false */
+  ) :
+    file(file),
+    writableFile(),
+    recordAccesses(recordAccesses),
+    accessMutex(),
+    startTime(std::chrono::steady_clock::now()),
+    summary(),
+    lastReadEnd(0),
+    records(),
+    threads() {
+    if(!static_cast<bool>(file)) {
+      throw std::invalid_argument(u8"File to instrument must not be null");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InstrumentedFile::InstrumentedFile(
+    const std::shared_ptr<VirtualFile> &file, bool recordAccesses /* = false */
+  ) :
+    InstrumentedFile(std::shared_ptr<const VirtualFile>(file), recordAccesses) {
+    this->writableFile = file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t InstrumentedFile::GetSize() const {
+    return this->file->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+    this->file->ReadAt(start, byteCount, buffer);
+    std::chrono::steady_clock::duration latency = std::chrono::steady_clock::now() - beginTime;
+
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    addAccess(FileAccessKind::Read, start, byteCount, beginTime, latency);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::ReadManyAt(
+    const ReadRequest *requests, std::size_t requestCount
+  ) const {
+    std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+    this->file->ReadManyAt(requests, requestCount);
+    std::chrono::steady_clock::duration latency = std::chrono::steady_clock::now() - beginTime;
+
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      addAccess(
+        FileAccessKind::BatchRead,
+        requests[index].Start, requests[index].ByteCount,
+        beginTime, latency
+      );
+    }
+
+    // The reads of a batch all report the batch's latency, but its time is only counted once
+    std::chrono::nanoseconds batchTime = (
+      std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+    );
+    ++this->summary.BatchCount;
+    this->summary.ReadTime += batchTime;
+    this->summary.LongestReadTime = std::max(this->summary.LongestReadTime, batchTime);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+    this->file->Prefetch(start, byteCount);
+    std::chrono::steady_clock::duration latency = std::chrono::steady_clock::now() - beginTime;
+
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    addAccess(FileAccessKind::Prefetch, start, byteCount, beginTime, latency);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *InstrumentedFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+    const std::byte *borrowed = this->file->TryBorrowAt(start, byteCount);
+    if(borrowed != nullptr) {
+      std::chrono::steady_clock::duration latency = (
+        std::chrono::steady_clock::now() - beginTime
+      );
+
+      std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+      addAccess(FileAccessKind::Borrow, start, byteCount, beginTime, latency);
+    }
+
+    return borrowed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    if(!static_cast<bool>(this->writableFile)) {
+      throw std::runtime_error(u8"Instrumented file wraps a read-only file");
+    }
+
+    std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+    this->writableFile->WriteAt(start, byteCount, buffer);
+    std::chrono::steady_clock::duration latency = std::chrono::steady_clock::now() - beginTime;
+
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    addAccess(FileAccessKind::Write, start, byteCount, beginTime, latency);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::Flush() {
+    if(static_cast<bool>(this->writableFile)) {
+      this->writableFile->Flush();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FileAccessSummary InstrumentedFile::GetSummary() const {
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    return this->summary;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<FileAccessRecord> InstrumentedFile::GetRecords() const {
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+    return this->records;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string InstrumentedFile::DumpTrace() const {
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+
+    std::string trace(u8"kind,start,bytes,time_ns,latency_ns,thread\n");
+    for(const FileAccessRecord &record : this->records) {
+      trace.append(getKindName(record.Kind));
+      trace.push_back(',');
+      trace.append(std::to_string(record.Start));
+      trace.push_back(',');
+      trace.append(std::to_string(record.ByteCount));
+      trace.push_back(',');
+      trace.append(std::to_string(record.Time.count()));
+      trace.push_back(',');
+      trace.append(std::to_string(record.Latency.count()));
+      trace.push_back(',');
+      trace.append(std::to_string(record.ThreadIndex));
+      trace.push_back('\n');
+    }
+
+    return trace;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::Reset() {
+    std::lock_guard<std::mutex> accessMutexScope(this->accessMutex);
+
+    this->startTime = std::chrono::steady_clock::now();
+    this->summary = FileAccessSummary();
+    this->lastReadEnd = 0;
+    this->records.clear();
+    this->threads.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentedFile::addAccess(
+    FileAccessKind kind, std::uint64_t start, std::size_t byteCount,
+    std::chrono::steady_clock::time_point beginTime,
+    std::chrono::steady_clock::duration latency
+  ) const {
+    std::chrono::nanoseconds latencyNanoseconds = (
+      std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+    );
+    std::size_t threadIndex = getThreadIndex();
+
+    switch(kind) {
+      case FileAccessKind::Read:
+      case FileAccessKind::BatchRead: {
+        if(start == this->lastReadEnd) {
+          ++this->summary.SequentialReadCount;
+        }
+        if(this->summary.ReadCount == 0) {
+          this->summary.SmallestReadByteCount = byteCount;
+        } else {
+          this->summary.SmallestReadByteCount = std::min(
+            this->summary.SmallestReadByteCount, byteCount
+          );
+        }
+        this->summary.LargestReadByteCount = std::max(
+          this->summary.LargestReadByteCount, byteCount
+        );
+        ++this->summary.ReadCount;
+        this->summary.ReadByteCount += byteCount;
+        this->lastReadEnd = start + byteCount;
+
+        // Batches add their time once, in ReadManyAt(), rather than once per read
+        if(kind == FileAccessKind::Read) {
+          this->summary.ReadTime += latencyNanoseconds;
+          this->summary.LongestReadTime = std::max(
+            this->summary.LongestReadTime, latencyNanoseconds
+          );
+        }
+        break;
+      }
+      case FileAccessKind::Borrow: {
+        ++this->summary.BorrowCount;
+        this->summary.BorrowedByteCount += byteCount;
+        break;
+      }
+      case FileAccessKind::Prefetch: {
+        ++this->summary.PrefetchCount;
+        this->summary.PrefetchedByteCount += byteCount;
+        break;
+      }
+      case FileAccessKind::Write: {
+        ++this->summary.WriteCount;
+        this->summary.WrittenByteCount += byteCount;
+        this->summary.WriteTime += latencyNanoseconds;
+        this->summary.LongestWriteTime = std::max(
+          this->summary.LongestWriteTime, latencyNanoseconds
+        );
+        break;
+      }
+    }
+
+    if(this->recordAccesses) {
+      FileAccessRecord record;
+      record.Kind = kind;
+      record.Start = start;
+      record.ByteCount = byteCount;
+      record.Time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        beginTime - this->startTime
+      );
+      record.Latency = latencyNanoseconds;
+      record.ThreadIndex = threadIndex;
+      this->records.push_back(record);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t InstrumentedFile::getThreadIndex() const {
+    std::thread::id threadId = std::this_thread::get_id();
+
+    std::vector<std::thread::id>::const_iterator iterator = std::find(
+      this->threads.begin(), this->threads.end(), threadId
+    );
+    if(iterator != this->threads.end()) {
+      return static_cast<std::size_t>(iterator - this->threads.begin());
+    }
+
+    this->threads.push_back(threadId);
+    this->summary.ThreadCount = this->threads.size();
+    return this->threads.size() - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,142 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LatencyHistogram.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cmath> // for std::ceil()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Power of two, in nanoseconds, at which the first logarithmic bucket begins</summary>
+  const std::size_t SmallestExponent = 10;
+
+  /// <summary>Power of two, in nanoseconds, at which the last logarithmic bucket ends</summary>
+  const std::size_t LargestExponent = 36;
+
+  /// <summary>Number of bits used to pick a sub-bucket within a power of two</summary>
+  const std::size_t SubBucketBits = 3;
+
+  /// <summary>Number of linear sub-buckets each power of two is split into</summary>
+  const std::size_t SubBucketCount = std::size_t(1) << SubBucketBits;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the index of the highest bit set in a number</summary>
+  /// <param name="value">Number whose highest set bit will be determined</param>
+  /// <returns>The index of the highest set bit, 0 for the lowest bit</returns>
+  std::size_t getHighestBitIndex(std::uint64_t value) {
+    std::size_t index = 0;
+    while(value >= 256) {
+      value >>= 8;
+      index += 8;
+    }
+    while(value > 1) {
+      value >>= 1;
+      ++index;
+    }
+    return index;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  static_assert(
+    LatencyHistogram::BucketCount ==
+    (1 + (LargestExponent - SmallestExponent) * SubBucketCount),
+    u8"Bucket count matches the bucket layout"
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t LatencyHistogram::GetBucketIndex(std::chrono::nanoseconds latency) {
+    if(latency.count() < (std::int64_t(1) << SmallestExponent)) {
+      return 0;
+    }
+
+    std::uint64_t value = static_cast<std::uint64_t>(latency.count());
+    std::size_t exponent = getHighestBitIndex(value);
+    if(exponent >= LargestExponent) {
+      return BucketCount - 1;
+    }
+
+    std::size_t subBucket = static_cast<std::size_t>(
+      (value >> (exponent - SubBucketBits)) & (SubBucketCount - 1)
+    );
+    return 1 + (exponent - SmallestExponent) * SubBucketCount + subBucket;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::chrono::nanoseconds LatencyHistogram::GetBucketUpperBound(std::size_t bucketIndex) {
+    if(bucketIndex == 0) {
+      return std::chrono::nanoseconds(std::int64_t(1) << SmallestExponent);
+    }
+    if(bucketIndex >= BucketCount - 1) {
+      return std::chrono::nanoseconds::max();
+    }
+
+    std::size_t exponent = SmallestExponent + (bucketIndex - 1) / SubBucketCount;
+    std::size_t subBucket = (bucketIndex - 1) % SubBucketCount;
+    return std::chrono::nanoseconds(
+      static_cast<std::int64_t>(SubBucketCount + subBucket + 1) << (exponent - SubBucketBits)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::chrono::nanoseconds LatencyHistogram::GetPercentile(double percentile) const {
+    if(this->CallCount == 0) {
+      return std::chrono::nanoseconds(0);
+    }
+
+    // Rank of the call the percentile falls on, counting from 1
+    double clampedPercentile = std::min(std::max(percentile, 0.0), 1.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(
+      std::ceil(clampedPercentile * static_cast<double>(this->CallCount))
+    );
+    if(rank == 0) {
+      rank = 1;
+    }
+
+    std::uint64_t countedCallCount = 0;
+    for(std::size_t index = 0; index < this->BucketCounts.size(); ++index) {
+      countedCallCount += this->BucketCounts[index];
+      if(countedCallCount >= rank) {
+        return std::min(GetBucketUpperBound(index), this->LongestTime);
+      }
+    }
+
+    // A snapshot taken mid-call may count a call before its bucket
+    return this->LongestTime;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
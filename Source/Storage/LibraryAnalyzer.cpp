@@ -0,0 +1,275 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LibraryAnalyzer.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::steady_clock
+#include <optional> // for std::optional
+#include <stdexcept> // for std::invalid_argument
+#include <thread> // for std::thread
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames decoded per call while analyzing a range</summary>
+  const std::size_t ChunkFrameCount = 16384;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stretch of a file that is decoded and analyzed by one task</summary>
+  struct AnalysisRange {
+
+    /// <summary>Index of the file the range belongs to</summary>
+    public: std::size_t FileIndex;
+    /// <summary>Index of the first frame in the range</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Index one past the last frame, zero to decode to the end of the track</summary>
+    public: std::uint64_t EndFrame;
+    /// <summary>Number of frames that were actually analyzed</summary>
+    public: std::uint64_t AnalyzedFrameCount;
+    /// <summary>Instances of the stages that analyzed this range</summary>
+    public: std::vector<std::unique_ptr<Nuclex::Audio::Storage::AnalysisStage>> Stages;
+    /// <summary>Exception that occurred while analyzing the range, if any</summary>
+    public: std::exception_ptr Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LibraryAnalyzer::LibraryAnalyzer(
+    std::size_t threadCount /* = 0 */,
+    std::uint64_t rangeFrameCount /* = 4194304 */
+  ) :
+    threadCount(threadCount),
+    rangeFrameCount(std::max<std::uint64_t>(rangeFrameCount, ChunkFrameCount)),
+    loader(std::make_shared<AudioLoader>()),
+    paths(),
+    stages() {
+    if(this->threadCount == 0) {
+      this->threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LibraryAnalyzer::~LibraryAnalyzer() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LibraryAnalyzer::AddFile(const std::string &path) {
+    this->paths.push_back(path);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LibraryAnalyzer::AddStage(const std::shared_ptr<const AnalysisStage> &stage) {
+    if(!static_cast<bool>(stage)) {
+      throw std::invalid_argument(u8"Analysis stage must not be empty");
+    }
+
+    this->stages.push_back(stage);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LibraryAnalysis LibraryAnalyzer::Run() {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    std::size_t fileCount = this->paths.size();
+    std::vector<std::optional<ContainerInfo>> infos(fileCount);
+    std::vector<std::exception_ptr> probeErrors(fileCount);
+
+    // Probing is cheap but waits for the disk a lot, so it gets more files in flight
+    this->loader->TryReadInfoBatch(
+      this->paths,
+      [&infos, &probeErrors](
+        std::size_t pathIndex, std::optional<ContainerInfo> &&info, std::exception_ptr error
+      ) {
+        infos[pathIndex] = std::move(info);
+        probeErrors[pathIndex] = error;
+      },
+      this->threadCount * 2
+    );
+
+    bool canSplit = true;
+    for(const std::shared_ptr<const AnalysisStage> &stage : this->stages) {
+      canSplit &= !stage->RequiresWholeTrack();
+    }
+
+    // Split the files into ranges. If the probe couldn't tell the length of a track,
+    // it is analyzed in one range that ends wherever the decoder says it does.
+    std::vector<AnalysisRange> ranges;
+    for(std::size_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+      if(static_cast<bool>(probeErrors[fileIndex])) {
+        continue;
+      }
+      if(!infos[fileIndex].has_value() || infos[fileIndex].value().Tracks.empty()) {
+        probeErrors[fileIndex] = std::make_exception_ptr(
+          Errors::UnsupportedFormatError(u8"Not an audio file or file format not supported")
+        );
+        continue;
+      }
+
+      std::uint64_t frameCount = infos[fileIndex].value().Tracks[0].FrameCount;
+      std::uint64_t rangeCount = 1;
+      if(canSplit && (frameCount > 0)) {
+        rangeCount = (frameCount + this->rangeFrameCount - 1) / this->rangeFrameCount;
+      }
+      for(std::uint64_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex) {
+        AnalysisRange range = AnalysisRange();
+        range.FileIndex = fileIndex;
+        range.StartFrame = frameCount * rangeIndex / rangeCount;
+        range.EndFrame = frameCount * (rangeIndex + 1) / rangeCount;
+        ranges.push_back(std::move(range));
+      }
+    }
+
+    // Each range opens its own decoder, so ranges of the same file run in parallel
+    // just like ranges of different files. Workers claim the next range when they're
+    // done with one, so whoever is idle picks up the remaining work.
+    std::atomic<std::size_t> nextRangeIndex(0);
+    auto analyzeRanges = [&]() {
+      std::vector<float> buffer;
+      for(;;) {
+        std::size_t rangeIndex = nextRangeIndex.fetch_add(1, std::memory_order_relaxed);
+        if(rangeIndex >= ranges.size()) {
+          return;
+        }
+
+        AnalysisRange &range = ranges[rangeIndex];
+        const TrackInfo &track = infos[range.FileIndex].value().Tracks[0];
+        try {
+          std::shared_ptr<AudioTrackDecoder> decoder = (
+            this->loader->OpenDecoder(this->paths[range.FileIndex])
+          );
+          std::uint64_t endFrame = decoder->CountFrames();
+          if(range.EndFrame > 0) {
+            endFrame = std::min(endFrame, range.EndFrame);
+          }
+
+          range.Stages.reserve(this->stages.size());
+          for(const std::shared_ptr<const AnalysisStage> &stage : this->stages) {
+            range.Stages.push_back(stage->Start(track, *decoder, range.StartFrame));
+          }
+
+          std::size_t channelCount = decoder->CountChannels();
+          buffer.resize(ChunkFrameCount * channelCount);
+          for(std::uint64_t frame = range.StartFrame; frame < endFrame;) {
+            std::size_t frameCount = static_cast<std::size_t>(
+              std::min<std::uint64_t>(endFrame - frame, ChunkFrameCount)
+            );
+            decoder->DecodeInterleaved<float>(buffer.data(), frame, frameCount);
+            for(std::unique_ptr<AnalysisStage> &stage : range.Stages) {
+              stage->Process(buffer.data(), frameCount);
+            }
+            frame += frameCount;
+            range.AnalyzedFrameCount += frameCount;
+          }
+        }
+        catch(...) {
+          range.Error = std::current_exception();
+        }
+      }
+    };
+    Executor::GetInstalled()->ParallelFor(
+      std::min(this->threadCount, std::max<std::size_t>(ranges.size(), 1)),
+      [&analyzeRanges](std::size_t) { analyzeRanges(); },
+      TaskPriority::Low
+    );
+
+    // Merge the ranges of each file in order. Ranges were created in file order,
+    // so all ranges of a file are next to each other.
+    LibraryAnalysis analysis = LibraryAnalysis();
+    analysis.Files.resize(fileCount);
+    analysis.RangeCount = ranges.size();
+    for(std::size_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+      analysis.Files[fileIndex].Path = this->paths[fileIndex];
+      analysis.Files[fileIndex].Error = probeErrors[fileIndex];
+    }
+    for(std::size_t rangeIndex = 0; rangeIndex < ranges.size(); ++rangeIndex) {
+      AnalysisRange &range = ranges[rangeIndex];
+      FileAnalysis &file = analysis.Files[range.FileIndex];
+      ++file.RangeCount;
+      file.FrameCount += range.AnalyzedFrameCount;
+
+      if(static_cast<bool>(file.Error)) {
+        continue;
+      }
+      if(static_cast<bool>(range.Error)) {
+        file.Error = range.Error;
+        file.Stages.clear();
+        continue;
+      }
+
+      if(file.Stages.empty()) {
+        file.Stages = std::move(range.Stages);
+      } else {
+        for(std::size_t stageIndex = 0; stageIndex < file.Stages.size(); ++stageIndex) {
+          file.Stages[stageIndex]->Merge(*range.Stages[stageIndex]);
+        }
+      }
+    }
+
+    for(std::size_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+      FileAnalysis &file = analysis.Files[fileIndex];
+      if(static_cast<bool>(file.Error)) {
+        ++analysis.FailedFileCount;
+        continue;
+      }
+
+      for(std::unique_ptr<AnalysisStage> &stage : file.Stages) {
+        stage->Finish();
+      }
+
+      analysis.AnalyzedFrameCount += file.FrameCount;
+      std::size_t sampleRate = infos[fileIndex].value().Tracks[0].SampleRate;
+      if(sampleRate > 0) {
+        analysis.AnalyzedSeconds += (
+          static_cast<double>(file.FrameCount) / static_cast<double>(sampleRate)
+        );
+      }
+    }
+
+    analysis.ElapsedSeconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime
+    ).count();
+
+    this->paths.clear();
+    return analysis;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
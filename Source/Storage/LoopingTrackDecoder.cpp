@@ -0,0 +1,287 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "LoopingTrackDecoder.h"
+
+#include <algorithm> // for std::min()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frame count reported for loops that repeat indefinitely</summary>
+  const std::uint64_t EndlessFrameCount = std::numeric_limits<std::uint64_t>::max();
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoopingTrackDecoder::LoopingTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder, const LoopRegion &loop
+  ) :
+    decoder(decoder),
+    loop(loop),
+    repeatedFrameCount(0),
+    frameCount(0) {
+    if(!static_cast<bool>(decoder)) {
+      throw std::invalid_argument(u8"Decoder must not be empty");
+    }
+
+    std::uint64_t trackFrameCount = decoder->CountFrames();
+    if((loop.StartFrame >= loop.EndFrame) || (loop.EndFrame > trackFrameCount)) {
+      throw std::invalid_argument(u8"Loop region must be a non-empty part of the track");
+    }
+
+    std::uint64_t loopLength = loop.EndFrame - loop.StartFrame;
+    if(loop.PlayCount == 0) {
+      this->repeatedFrameCount = EndlessFrameCount;
+      this->frameCount = EndlessFrameCount;
+    } else {
+      this->repeatedFrameCount = loopLength * (loop.PlayCount - 1);
+      this->frameCount = trackFrameCount + this->repeatedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoopingTrackDecoder::~LoopingTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> LoopingTrackDecoder::Clone() const {
+    return std::make_shared<LoopingTrackDecoder>(this->decoder->Clone(), this->loop);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool LoopingTrackDecoder::TryReopen(const std::shared_ptr<const VirtualFile> &file) {
+    if(!this->decoder->TryReopen(file)) {
+      return false;
+    }
+
+    std::uint64_t trackFrameCount = this->decoder->CountFrames();
+    if(this->loop.EndFrame > trackFrameCount) {
+      throw std::invalid_argument(u8"Reopened track is too short for the loop region");
+    }
+    if(this->frameCount != EndlessFrameCount) {
+      this->frameCount = trackFrameCount + this->repeatedFrameCount;
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopingTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost LoopingTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::uint64_t contiguousFrameCount;
+    return this->decoder->EstimateSeekCost(mapFrame(targetFrame, contiguousFrameCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t LoopingTrackDecoder::mapFrame(
+    std::uint64_t frameIndex, std::uint64_t &contiguousFrameCount
+  ) const {
+    std::uint64_t trackFrameCount = this->decoder->CountFrames();
+
+    // The intro and the first pass through the loop are played as they are. If the loop
+    // only plays once, there is no jump at all and the tail follows right away.
+    if(frameIndex < this->loop.EndFrame) {
+      if(this->repeatedFrameCount == 0) {
+        contiguousFrameCount = trackFrameCount - frameIndex;
+      } else {
+        contiguousFrameCount = this->loop.EndFrame - frameIndex;
+      }
+      return frameIndex;
+    }
+
+    // Each extra pass through the loop starts over at the loop's start frame
+    std::uint64_t passFrameIndex = frameIndex - this->loop.EndFrame;
+    if(passFrameIndex < this->repeatedFrameCount) {
+      std::uint64_t loopLength = this->loop.EndFrame - this->loop.StartFrame;
+      std::uint64_t loopFrameIndex = passFrameIndex % loopLength;
+      contiguousFrameCount = loopLength - loopFrameIndex;
+      return this->loop.StartFrame + loopFrameIndex;
+    }
+
+    // After the last pass, the remainder of the track is played once
+    std::uint64_t tailFrameIndex = (
+      this->loop.EndFrame + (passFrameIndex - this->repeatedFrameCount)
+    );
+    contiguousFrameCount = trackFrameCount - tailFrameIndex;
+    return tailFrameIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void LoopingTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->decoder->CountChannels();
+
+    while(frameCount > 0) {
+      std::uint64_t contiguousFrameCount;
+      std::uint64_t sourceFrame = mapFrame(startFrame, contiguousFrameCount);
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount, contiguousFrameCount)
+      );
+      if(chunkFrameCount == 0) {
+        throw std::out_of_range(u8"Decoding range reaches past the end of the track");
+      }
+
+      this->decoder->DecodeInterleaved<TSample>(buffer, sourceFrame, chunkFrameCount);
+
+      buffer += chunkFrameCount * channelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void LoopingTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t contiguousFrameCount;
+    std::uint64_t sourceFrame = mapFrame(startFrame, contiguousFrameCount);
+
+    // Most calls stay within one run, these can use the caller's buffers directly
+    if(frameCount <= contiguousFrameCount) {
+      this->decoder->DecodeSeparated<TSample>(buffers, sourceFrame, frameCount);
+      return;
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+    std::vector<TSample *> targets(buffers, buffers + channelCount);
+    std::size_t decodedFrameCount = 0;
+    while(decodedFrameCount < frameCount) {
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount - decodedFrameCount, contiguousFrameCount)
+      );
+      if(chunkFrameCount == 0) {
+        throw std::out_of_range(u8"Decoding range reaches past the end of the track");
+      }
+
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        targets[index] = buffers[index] + decodedFrameCount;
+      }
+      this->decoder->DecodeSeparated<TSample>(targets.data(), sourceFrame, chunkFrameCount);
+
+      decodedFrameCount += chunkFrameCount;
+      if(decodedFrameCount < frameCount) {
+        sourceFrame = mapFrame(startFrame + decodedFrameCount, contiguousFrameCount);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
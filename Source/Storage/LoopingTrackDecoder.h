@@ -0,0 +1,292 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_LOOPINGTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_LOOPINGTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/TrackInfo.h" // for LoopRegion
+
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Presents an audio track with a region repeated as one long track</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The frames of the unrolled track map to the wrapped decoder's frames in three
+  ///     runs: the intro up to the end of the first pass through the loop, the extra
+  ///     passes through the loop and the tail after the loop. Decoding calls are split
+  ///     wherever the mapping jumps, everything in between is decoded in one go.
+  ///   </para>
+  ///   <para>
+  ///     Stitching happens at frame level with no crossfade, so the loop has to be
+  ///     sample-accurate, which is what the loop points stored by audio tools are.
+  ///   </para>
+  /// </remarks>
+  class LoopingTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new looping decoder</summary>
+    /// <param name="decoder">Decoder whose track contains the loop</param>
+    /// <param name="loop">Region of the track that will be repeated</param>
+    public: LoopingTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder, const LoopRegion &loop
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~LoopingTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override {
+      return this->decoder->CountChannels();
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->decoder->GetChannelOrder();
+    }
+
+    /// <summary>Changes the order in which channels are delivered</summary>
+    /// <param name="channelOrder">Order in which the channels should be delivered</param>
+    /// <returns>True if the wrapped decoder accepted the new channel order</returns>
+    public: bool TrySetChannelOrder(
+      const std::vector<ChannelPlacement> &channelOrder
+    ) override {
+      return this->decoder->TrySetChannelOrder(channelOrder);
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames in the unrolled track</returns>
+    public: std::uint64_t CountFrames() const override { return this->frameCount; }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->decoder->GetNativeSampleFormat();
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>True if the codec decodes straight to interleaved channels</returns>
+    public: bool IsNativelyInterleaved() const override {
+      return this->decoder->IsNativelyInterleaved();
+    }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    public: void BuildSeekIndex() const override {
+      this->decoder->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->decoder->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->decoder->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->decoder->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override {
+      this->decoder->EnableStatistics(enable);
+    }
+
+    /// <summary>Retrieves the statistics the wrapped decoder has collected so far</summary>
+    /// <returns>The current values of the wrapped decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override {
+      return this->decoder->GetStatistics();
+    }
+
+    /// <summary>Retrieves the wrapped decoder's distribution of decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each of the wrapped decoder's calls took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override {
+      return this->decoder->GetDecodeLatencies(reset);
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override {
+      return this->decoder->ExplainDecodePath(sampleFormat, interleaved);
+    }
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
+    /// <summary>Points the wrapped decoder at a different file of the same format</summary>
+    /// <param name="file">File the wrapped decoder will decode from</param>
+    /// <returns>True if the wrapped decoder could switch to the new file</returns>
+    /// <remarks>
+    ///   The loop region stays the same, so this only makes sense for files with
+    ///   the same loop, such as alternate takes of a piece of music.
+    /// </remarks>
+    public: bool TryReopen(const std::shared_ptr<const VirtualFile> &file) override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Looks up the wrapped decoder's frame for a frame of the unrolled track</summary>
+    /// <param name="frameIndex">Frame in the unrolled track that will be looked up</param>
+    /// <param name="contiguousFrameCount">
+    ///   Receives the number of frames that follow without the mapping jumping
+    /// </param>
+    /// <returns>The index of the frame in the wrapped decoder's track</returns>
+    private: std::uint64_t mapFrame(
+      std::uint64_t frameIndex, std::uint64_t &contiguousFrameCount
+    ) const;
+
+    /// <summary>Decodes frames of the unrolled track in interleaved format</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes frames of the unrolled track in separated format</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decoder for the track containing the loop</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Region of the track that is repeated</summary>
+    private: LoopRegion loop;
+    /// <summary>Number of frames the extra passes through the loop add</summary>
+    private: std::uint64_t repeatedFrameCount;
+    /// <summary>Number of frames in the unrolled track</summary>
+    private: std::uint64_t frameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_LOOPINGTRACKDECODER_H
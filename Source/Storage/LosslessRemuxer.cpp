@@ -0,0 +1,144 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LosslessRemuxer.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./Flac/FlacDetection.h"
+#include "./Flac/FlacRemuxer.h"
+#include "./WavPack/WavPackDetection.h"
+#include "./WavPack/WavPackRemuxer.h"
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Formats the lossless remuxer can cut and join</summary>
+  enum class LosslessFormat {
+    /// <summary>File is in neither of the supported formats</summary>
+    Unknown,
+    /// <summary>Free Lossless Audio Codec</summary>
+    Flac,
+    /// <summary>WavPack, lossless or hybrid</summary>
+    WavPack
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines which supported format a file is stored in</summary>
+  /// <param name="file">File whose format will be determined</param>
+  /// <returns>The format of the file</returns>
+  LosslessFormat detectFormat(const Nuclex::Audio::Storage::VirtualFile &file) {
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    if(Nuclex::Audio::Storage::Flac::Detection::CheckIfFlacHeaderPresent(file)) {
+      return LosslessFormat::Flac;
+    }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    if(Nuclex::Audio::Storage::WavPack::Detection::CheckIfWavPackHeaderPresent(file)) {
+      return LosslessFormat::WavPack;
+    }
+#endif
+    (void)file;
+    return LosslessFormat::Unknown;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t LosslessRemuxer::Trim(
+    const std::shared_ptr<const VirtualFile> &source,
+    std::uint64_t startFrame, std::uint64_t frameCount,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    switch(detectFormat(*source)) {
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+      case LosslessFormat::Flac: {
+        return Flac::FlacRemuxer::Trim(source, startFrame, frameCount, target);
+      }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+      case LosslessFormat::WavPack: {
+        return WavPack::WavPackRemuxer::Trim(source, startFrame, frameCount, target);
+      }
+#endif
+      default: {
+        (void)startFrame;
+        (void)frameCount;
+        (void)target;
+        throw Errors::UnsupportedFormatError(
+          u8"File to be cut is not a FLAC or WavPack file (or support was not compiled in)"
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LosslessRemuxer::Concatenate(
+    const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(sources.empty()) {
+      throw std::invalid_argument(u8"At least one file needs to be specified for joining");
+    }
+
+    LosslessFormat format = detectFormat(*sources.front());
+    for(const std::shared_ptr<const VirtualFile> &source : sources) {
+      if(detectFormat(*source) != format) {
+        throw Errors::UnsupportedFormatError(u8"Files to be joined need to use the same format");
+      }
+    }
+
+    switch(format) {
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+      case LosslessFormat::Flac: {
+        Flac::FlacRemuxer::Concatenate(sources, target);
+        break;
+      }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+      case LosslessFormat::WavPack: {
+        WavPack::WavPackRemuxer::Concatenate(sources, target);
+        break;
+      }
+#endif
+      default: {
+        (void)target;
+        throw Errors::UnsupportedFormatError(
+          u8"Files to be joined are not FLAC or WavPack files (or support was not compiled in)"
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
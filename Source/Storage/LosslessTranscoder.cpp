@@ -0,0 +1,177 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LosslessTranscoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <algorithm> // for std::min(), std::find()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames that are moved from the decoder to the encoder at once</summary>
+  const std::size_t TransferFrameCount = 16384;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a sample format stores integer samples</summary>
+  /// <param name="format">Sample format that will be checked</param>
+  /// <returns>True if the sample format stores integers</returns>
+  bool isIntegerFormat(Nuclex::Audio::AudioSampleFormat format) {
+    using Nuclex::Audio::AudioSampleFormat;
+    return (
+      (format == AudioSampleFormat::UnsignedInteger_8) ||
+      (format == AudioSampleFormat::SignedInteger_16) ||
+      (format == AudioSampleFormat::SignedInteger_24) ||
+      (format == AudioSampleFormat::SignedInteger_32)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves all frames from a decoder to an encoder as the specified type</summary>
+  /// <typeparam name="TSample">Type of samples that will be moved</typeparam>
+  /// <param name="decoder">Decoder delivering the samples</param>
+  /// <param name="encoder">Encoder that will receive the samples</param>
+  /// <returns>The number of frames that have been moved</returns>
+  template<typename TSample>
+  std::uint64_t transferFrames(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    Nuclex::Audio::Storage::AudioTrackEncoder &encoder
+  ) {
+    std::size_t channelCount = decoder.CountChannels();
+    std::uint64_t frameCount = decoder.CountFrames();
+    Nuclex::Audio::SampleVector<TSample> samples(TransferFrameCount * channelCount);
+
+    // Go with whichever layout the codec decodes to, so the decoder doesn't have
+    // to interleave or separate the channels only for the encoder to undo it
+    if(decoder.IsNativelyInterleaved()) {
+      for(std::uint64_t cursor = 0; cursor < frameCount; cursor += TransferFrameCount) {
+        std::size_t chunkFrameCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(frameCount - cursor, TransferFrameCount)
+        );
+        decoder.DecodeInterleaved(samples.data(), cursor, chunkFrameCount);
+        encoder.EncodeInterleaved(samples.data(), chunkFrameCount);
+      }
+    } else {
+      std::vector<TSample *> channels(channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        channels[channelIndex] = samples.data() + (channelIndex * TransferFrameCount);
+      }
+      std::vector<const TSample *> constChannels(channels.begin(), channels.end());
+
+      for(std::uint64_t cursor = 0; cursor < frameCount; cursor += TransferFrameCount) {
+        std::size_t chunkFrameCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(frameCount - cursor, TransferFrameCount)
+        );
+        decoder.DecodeSeparated(channels.data(), cursor, chunkFrameCount);
+        encoder.EncodeSeparated(constChannels.data(), chunkFrameCount);
+      }
+    }
+
+    encoder.Flush();
+    return frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioSampleFormat LosslessTranscoder::NegotiateSampleFormat(
+    const AudioTrackDecoder &decoder, const AudioTrackEncoderBuilder &builder
+  ) {
+    if(!builder.IsLossless()) {
+      return AudioSampleFormat::Unknown;
+    }
+
+    AudioSampleFormat nativeFormat = decoder.GetNativeSampleFormat();
+    const std::vector<AudioSampleFormat> &supportedFormats = builder.GetSupportedSampleFormats();
+
+    // Floating point samples can only be kept exact by storing them as they are
+    if(!isIntegerFormat(nativeFormat)) {
+      bool isSupported = (
+        std::find(supportedFormats.begin(), supportedFormats.end(), nativeFormat) !=
+        supportedFormats.end()
+      );
+      return isSupported ? nativeFormat : AudioSampleFormat::Unknown;
+    }
+
+    // Integer formats are numbered by their bit count, so the smallest format that
+    // is at least as wide as the native one can hold all of its samples
+    AudioSampleFormat bestFormat = AudioSampleFormat::Unknown;
+    for(AudioSampleFormat format : supportedFormats) {
+      if(!isIntegerFormat(format)) {
+        continue;
+      }
+      if(static_cast<int>(format) < static_cast<int>(nativeFormat)) {
+        continue;
+      }
+      if(
+        (bestFormat == AudioSampleFormat::Unknown) ||
+        (static_cast<int>(format) < static_cast<int>(bestFormat))
+      ) {
+        bestFormat = format;
+      }
+    }
+
+    return bestFormat;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t LosslessTranscoder::Transcode(
+    const AudioTrackDecoder &decoder,
+    AudioTrackEncoderBuilder &builder,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    AudioSampleFormat format = NegotiateSampleFormat(decoder, builder);
+    if(format == AudioSampleFormat::Unknown) {
+      throw Errors::UnsupportedFormatError(
+        u8"Target format can not store the source's samples without loss"
+      );
+    }
+
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetSampleFormat(format).
+      SetChannels(decoder.GetChannelOrder()).
+      Build(target);
+
+    switch(format) {
+      case AudioSampleFormat::Float_32: { return transferFrames<float>(decoder, *encoder); }
+      case AudioSampleFormat::Float_64: { return transferFrames<double>(decoder, *encoder); }
+      default: { return transferFrames<std::int32_t>(decoder, *encoder); }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
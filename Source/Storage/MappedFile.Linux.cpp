@@ -0,0 +1,154 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "MappedFile.h"
+
+#if defined(NUCLEX_AUDIO_LINUX)
+
+#include "../Platform/LinuxFileApi.h" // for OpenFileForReading(), TryMapFileForReading()
+#include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError(), etc.
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <sys/mman.h> // for ::madvise()
+#include <unistd.h> // for ::sysconf()
+
+#include <cassert> // for assert()
+#include <cerrno> // for EIO, EBADF
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> MappedFile::TryOpenForReading(
+    const std::string &path, FileAccessPattern accessPattern
+  ) {
+    int fileDescriptor = Platform::LinuxFileApi::OpenFileForReading(path);
+
+    const std::byte *memory = nullptr;
+    std::uint64_t length;
+    try {
+      length = Platform::LinuxFileApi::StatFileSize(fileDescriptor);
+
+      // Zero-length files can't be mapped and files that don't fit into the address
+      // space (only possible on 32-bit systems) have to use the normal file access path.
+      bool isMappable = (
+        (length > 0) && (length <= std::numeric_limits<std::size_t>::max())
+      );
+      if(isMappable) {
+        memory = Platform::LinuxFileApi::TryMapFileForReading(
+          fileDescriptor, static_cast<std::size_t>(length)
+        );
+      }
+    }
+    catch(...) {
+      Platform::LinuxFileApi::Close(fileDescriptor, false);
+      throw;
+    }
+
+    // The mapping holds its own reference to the file, we don't need the descriptor anymore
+    Platform::LinuxFileApi::Close(fileDescriptor, false);
+    if(memory == nullptr) {
+      return std::shared_ptr<const VirtualFile>();
+    }
+
+    // This is only a hint, so if the kernel doesn't like it, we'll just carry on
+    if(accessPattern == FileAccessPattern::Sequential) {
+      ::madvise(
+        const_cast<std::byte *>(memory), static_cast<std::size_t>(length), MADV_SEQUENTIAL
+      );
+    } else if(accessPattern == FileAccessPattern::Random) {
+      ::madvise(
+        const_cast<std::byte *>(memory), static_cast<std::size_t>(length), MADV_RANDOM
+      );
+    }
+
+    return std::make_shared<const MappedFile>(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::MappedFile(const std::byte *memory, std::uint64_t length) :
+    memory(memory),
+    length(length) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::~MappedFile() {
+    Platform::LinuxFileApi::UnmapFile(
+      this->memory, static_cast<std::size_t>(this->length), false
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+        u8"Encountered unexpected end of file", EIO
+      );
+    }
+
+    std::memcpy(buffer, this->memory + start, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      return;
+    }
+
+    // madvise() requires a page-aligned start address
+    static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t leadingByteCount = static_cast<std::size_t>(start % pageSize);
+    ::madvise(
+      const_cast<std::byte *>(this->memory + start - leadingByteCount),
+      byteCount + leadingByteCount,
+      MADV_WILLNEED
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+    Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+      u8"Memory-mapped files are opened in read-only mode", EBADF
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_LINUX)
@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "MappedFile.h"
+
+#if !defined(NUCLEX_AUDIO_LINUX) && !defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError(), etc.
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <cerrno> // for EIO, EBADF
+#include <cstring> // for std::memcpy()
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> MappedFile::TryOpenForReading(
+    const std::string &path, FileAccessPattern accessPattern
+  ) {
+    (void)path;
+    (void)accessPattern;
+
+    // The generic Posix path works with FILE pointers only, so we don't attempt
+    // to map anything and let the caller fall back to the normal file access path.
+    return std::shared_ptr<const VirtualFile>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::MappedFile(const std::byte *memory, std::uint64_t length) :
+    memory(memory),
+    length(length) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::~MappedFile() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+        u8"Encountered unexpected end of file", EIO
+      );
+    }
+
+    std::memcpy(buffer, this->memory + start, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    (void)start;
+    (void)byteCount; // Not supported here.
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+    Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+      u8"Memory-mapped files are opened in read-only mode", EBADF
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // !defined(NUCLEX_AUDIO_LINUX) && !defined(NUCLEX_AUDIO_WINDOWS)
@@ -0,0 +1,131 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "MappedFile.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "../Platform/WindowsFileApi.h" // for OpenFileForReading(), TryMapFileForReading()
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> MappedFile::TryOpenForReading(
+    const std::string &path, FileAccessPattern accessPattern
+  ) {
+    HANDLE fileHandle = Platform::WindowsFileApi::OpenFileForReading(
+      path,
+      (accessPattern == FileAccessPattern::Sequential),
+      (accessPattern == FileAccessPattern::Random)
+    );
+
+    const std::byte *memory = nullptr;
+    std::uint64_t length;
+    try {
+      length = Platform::WindowsFileApi::GetFileSize(fileHandle);
+
+      // Zero-length files can't be mapped and files that don't fit into the address
+      // space (only possible on 32-bit systems) have to use the normal file access path.
+      bool isMappable = (
+        (length > 0) && (length <= std::numeric_limits<std::size_t>::max())
+      );
+      if(isMappable) {
+        memory = Platform::WindowsFileApi::TryMapFileForReading(
+          fileHandle, static_cast<std::size_t>(length)
+        );
+      }
+    }
+    catch(...) {
+      Platform::WindowsFileApi::CloseFile(fileHandle, false);
+      throw;
+    }
+
+    // The mapped view holds its own reference to the file, we don't need the handle anymore
+    Platform::WindowsFileApi::CloseFile(fileHandle, false);
+    if(memory == nullptr) {
+      return std::shared_ptr<const VirtualFile>();
+    }
+
+    return std::make_shared<const MappedFile>(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::MappedFile(const std::byte *memory, std::uint64_t length) :
+    memory(memory),
+    length(length) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::~MappedFile() {
+    Platform::WindowsFileApi::UnmapFile(this->memory, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      Platform::WindowsFileApi::ThrowExceptionForFileAccessError(
+        u8"Encountered unexpected end of file", ERROR_HANDLE_EOF
+      );
+    }
+
+    std::memcpy(buffer, this->memory + start, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    (void)start;
+    (void)byteCount;
+    // PrefetchVirtualMemory() would do this, but it needs Windows 8 and we don't want
+    // to raise the minimum system requirements for a hint. Page faults will do the job.
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+    Platform::WindowsFileApi::ThrowExceptionForFileAccessError(
+      u8"Memory-mapped files are opened in read-only mode", ERROR_ACCESS_DENIED
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_WINDOWS)
@@ -0,0 +1,129 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MAPPEDFILE_H
+#define NUCLEX_AUDIO_STORAGE_MAPPEDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides read-only access to a file that is mapped into memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Instead of issuing a system call for each read, the whole file is mapped into
+  ///     the process' address space and reads turn into plain memory copies. The OS
+  ///     pages in the file contents on demand. This is a big win when lots of small
+  ///     files are loaded or when codec libraries issue many tiny reads.
+  ///   </para>
+  ///   <para>
+  ///     If the file is truncated by another process while it is mapped, accessing
+  ///     the missing pages will raise a SIGBUS (or an in-page error on Windows),
+  ///     so only use this for files that are not modified while being read.
+  ///   </para>
+  /// </remarks>
+  class MappedFile : public VirtualFile {
+
+    /// <summary>Attempts to open the specified file via a memory mapping</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="accessPattern">
+    ///   How the file will be accessed, passed to the OS as a caching hint
+    /// </param>
+    /// <returns>
+    ///   The memory-mapped file or a null pointer if the file exists but could not
+    ///   be mapped (empty files, pipes and devices, files too large for the address space)
+    /// </returns>
+    /// <remarks>
+    ///   If the file itself cannot be opened, an exception is thrown just like with
+    ///   the normal <see cref="RealFile" />, so only the mapping step falls back.
+    /// </remarks>
+    public: static std::shared_ptr<const VirtualFile> TryOpenForReading(
+      const std::string &path, FileAccessPattern accessPattern
+    );
+
+    /// <summary>Initializes a new mapped file from an existing mapping</summary>
+    /// <param name="memory">Address at which the file's contents have been mapped</param>
+    /// <param name="length">Length of the mapped file in bytes</param>
+    /// <remarks>
+    ///   The instance takes ownership of the mapping and will unmap it when destroyed.
+    /// </remarks>
+    public: MappedFile(const std::byte *memory, std::uint64_t length);
+
+    /// <summary>Unmaps the file and frees all memory used by the instance</summary>
+    public: ~MappedFile() override;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override;
+
+    /// <summary>Provides direct access to a range of the mapped file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the mapped memory at the requested offset or a null pointer if
+    ///   the requested range exceeds the file's size
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+        return nullptr;
+      }
+      return this->memory + start;
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Mapped files are always read-only, so this will always throw an exception.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Address at which the file contents have been mapped</summary>
+    private: const std::byte *memory;
+    /// <summary>Length of the file in bytes</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_MAPPEDFILE_H
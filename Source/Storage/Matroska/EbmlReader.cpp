@@ -0,0 +1,178 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EbmlReader.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the length of a variable-length integer from its first byte</summary>
+  /// <param name="firstByte">First byte of the variable-length integer</param>
+  /// <returns>The length of the integer in bytes or 0 if the first byte is zero</returns>
+  std::size_t getVariableIntegerLength(std::byte firstByte) {
+    std::uint8_t bits = static_cast<std::uint8_t>(firstByte);
+    for(std::size_t length = 1; length <= 8; ++length) {
+      if((bits & (0x80 >> (length - 1))) != 0) {
+        return length;
+      }
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool EbmlReader::TryReadElementHeader(
+    const std::byte *data, std::size_t availableByteCount, EbmlElement &element
+  ) {
+    if(availableByteCount < 2) {
+      return false;
+    }
+
+    // Element ids are at most 4 bytes long and, unlike sizes, keep their marker bits
+    std::size_t idLength = getVariableIntegerLength(data[0]);
+    if((idLength == 0) || (idLength > 4) || (idLength >= availableByteCount)) {
+      return false;
+    }
+    element.Id = 0;
+    for(std::size_t index = 0; index < idLength; ++index) {
+      element.Id = (element.Id << 8) | static_cast<std::uint32_t>(data[index]);
+    }
+
+    std::uint64_t size;
+    std::size_t sizeLength = ReadVariableInteger(
+      data + idLength, availableByteCount - idLength, size
+    );
+    if(sizeLength == 0) {
+      return false;
+    }
+
+    // A size with all value bits set is reserved to indicate an unknown size
+    std::uint64_t unknownSize = (std::uint64_t(1) << (sizeLength * 7)) - 1;
+    element.IsSizeUnknown = (size == unknownSize);
+    element.Size = element.IsSizeUnknown ? 0 : size;
+    element.DataOffset = idLength + sizeLength;
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool EbmlReader::TryReadElementHeader(
+    const VirtualFile &file, std::uint64_t offset, std::uint64_t end, EbmlElement &element
+  ) {
+    if(offset >= end) {
+      return false;
+    }
+
+    std::byte header[MaximumHeaderLength];
+    std::size_t headerLength = static_cast<std::size_t>(
+      std::min<std::uint64_t>(MaximumHeaderLength, end - offset)
+    );
+    file.ReadAt(offset, headerLength, header);
+
+    if(!TryReadElementHeader(header, headerLength, element)) {
+      return false;
+    }
+
+    element.DataOffset += offset;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t EbmlReader::ReadVariableInteger(
+    const std::byte *data, std::size_t availableByteCount, std::uint64_t &value
+  ) {
+    if(availableByteCount == 0) {
+      return 0;
+    }
+
+    std::size_t length = getVariableIntegerLength(data[0]);
+    if((length == 0) || (length > availableByteCount)) {
+      return 0;
+    }
+
+    // Strip the length marker from the first byte, the remaining bytes are plain
+    value = static_cast<std::uint64_t>(data[0]) & ((0x100 >> length) - 1);
+    for(std::size_t index = 1; index < length; ++index) {
+      value = (value << 8) | static_cast<std::uint64_t>(data[index]);
+    }
+
+    return length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t EbmlReader::ReadUnsigned(const std::byte *data, std::size_t size) {
+    std::uint64_t value = 0;
+    for(std::size_t index = 0; index < std::min<std::size_t>(size, 8); ++index) {
+      value = (value << 8) | static_cast<std::uint64_t>(data[index]);
+    }
+
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  double EbmlReader::ReadFloat(const std::byte *data, std::size_t size) {
+    if(size == 4) {
+      std::uint32_t bits = static_cast<std::uint32_t>(ReadUnsigned(data, 4));
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return static_cast<double>(value);
+    } else if(size == 8) {
+      std::uint64_t bits = ReadUnsigned(data, 8);
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    } else {
+      return 0.0; // Zero-length floats are defined as 0.0, other sizes are invalid
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string EbmlReader::ReadString(const std::byte *data, std::size_t size) {
+    std::size_t length = 0;
+    while((length < size) && (data[length] != std::byte(0))) {
+      ++length;
+    }
+
+    return std::string(reinterpret_cast<const char *>(data), length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
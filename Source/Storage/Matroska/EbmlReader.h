@@ -0,0 +1,127 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MATROSKA_EBMLREADER_H
+#define NUCLEX_AUDIO_STORAGE_MATROSKA_EBMLREADER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Header of an element in an EBML document</summary>
+  struct EbmlElement {
+
+    /// <summary>Element id, including the length marker bits as is customary</summary>
+    public: std::uint32_t Id;
+    /// <summary>Offset at which the element's data begins</summary>
+    public: std::uint64_t DataOffset;
+    /// <summary>Length of the element's data in bytes</summary>
+    /// <remarks>
+    ///   Live streams may write elements without knowing their size. In that case
+    ///   <see cref="IsSizeUnknown" /> is set and the element extends until an element
+    ///   is encountered that can't be its child.
+    /// </remarks>
+    public: std::uint64_t Size;
+    /// <summary>Whether the element's size was left open by the writer</summary>
+    public: bool IsSizeUnknown;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the variable-length integers and elements EBML documents consist of</summary>
+  /// <remarks>
+  ///   EBML is the binary, XML-like format Matroska and WebM files are built from. Each
+  ///   element starts with an id and a size, both stored as big endian integers whose
+  ///   length is given by the number of leading zero bits in their first byte.
+  /// </remarks>
+  class EbmlReader {
+
+    /// <summary>Maximum number of bytes an element header can occupy</summary>
+    public: static constexpr std::size_t MaximumHeaderLength = 12;
+
+    /// <summary>Tries to read an element header from a memory buffer</summary>
+    /// <param name="data">Buffer holding the element header</param>
+    /// <param name="availableByteCount">Number of bytes available in the buffer</param>
+    /// <param name="element">Receives the element header, data offset relative to the buffer</param>
+    /// <returns>True if a valid element header was read</returns>
+    public: static bool TryReadElementHeader(
+      const std::byte *data, std::size_t availableByteCount, EbmlElement &element
+    );
+
+    /// <summary>Tries to read an element header from a file</summary>
+    /// <param name="file">File from which the element header will be read</param>
+    /// <param name="offset">Offset at which the element header begins</param>
+    /// <param name="end">Offset up to which the header may extend</param>
+    /// <param name="element">Receives the element header</param>
+    /// <returns>True if a valid element header was read</returns>
+    public: static bool TryReadElementHeader(
+      const VirtualFile &file, std::uint64_t offset, std::uint64_t end, EbmlElement &element
+    );
+
+    /// <summary>Reads a variable-length integer as used for sizes and lacing</summary>
+    /// <param name="data">Buffer holding the variable-length integer</param>
+    /// <param name="availableByteCount">Number of bytes available in the buffer</param>
+    /// <param name="value">Receives the value with the length marker removed</param>
+    /// <returns>The length of the integer in bytes or 0 if it was invalid</returns>
+    public: static std::size_t ReadVariableInteger(
+      const std::byte *data, std::size_t availableByteCount, std::uint64_t &value
+    );
+
+    /// <summary>Reads the contents of an unsigned integer element</summary>
+    /// <param name="data">Element data holding the integer</param>
+    /// <param name="size">Size of the element data, 0 to 8 bytes</param>
+    /// <returns>The value of the unsigned integer</returns>
+    public: static std::uint64_t ReadUnsigned(const std::byte *data, std::size_t size);
+
+    /// <summary>Reads the contents of a floating point element</summary>
+    /// <param name="data">Element data holding the floating point value</param>
+    /// <param name="size">Size of the element data, 0, 4 or 8 bytes</param>
+    /// <returns>The value of the floating point element</returns>
+    public: static double ReadFloat(const std::byte *data, std::size_t size);
+
+    /// <summary>Reads the contents of a string element</summary>
+    /// <param name="data">Element data holding the string</param>
+    /// <param name="size">Size of the element data in bytes</param>
+    /// <returns>The string with any zero padding removed</returns>
+    public: static std::string ReadString(const std::byte *data, std::size_t size);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // NUCLEX_AUDIO_STORAGE_MATROSKA_EBMLREADER_H
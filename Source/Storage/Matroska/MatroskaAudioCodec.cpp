@@ -0,0 +1,195 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./MatroskaAudioCodec.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "./MatroskaDetection.h"
+#include "./MatroskaReader.h"
+#include "./MatroskaTrackDecoder.h"
+
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the audio tracks in a Matroska segment that can be decoded</summary>
+  /// <param name="segment">Segment whose audio tracks will be checked</param>
+  /// <returns>The indices of all decodable tracks within the segment's audio tracks</returns>
+  std::vector<std::size_t> findDecodableTracks(
+    const Nuclex::Audio::Storage::Matroska::MatroskaSegment &segment
+  ) {
+    std::vector<std::size_t> indices;
+    for(std::size_t index = 0; index < segment.AudioTracks.size(); ++index) {
+      const std::string &codecId = segment.AudioTracks[index].CodecId;
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+      if(codecId == u8"A_OPUS") {
+        indices.push_back(index);
+      }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+      if(codecId == u8"A_VORBIS") {
+        indices.push_back(index);
+      }
+#endif
+    }
+
+    if(indices.empty()) {
+      throw Nuclex::Audio::Errors::UnsupportedFormatError(
+        u8"Matroska file contains no audio track in a codec this library can decode"
+      );
+    }
+
+    return indices;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &MatroskaAudioCodec::GetName() const {
+    const static std::string codecName(u8"Matroska", 8);
+    return codecName;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::string> &MatroskaAudioCodec::GetFileExtensions() const  {
+    const static std::vector<std::string> extensions {
+      std::string(u8"mka", 3),
+      std::string(u8"webm", 4),
+      std::string(u8"mkv", 3)
+    };
+
+    return extensions;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MatroskaAudioCodec::IsSignaturePresent(
+    const std::byte *header, std::size_t byteCount
+  ) const {
+    return Detection::CheckIfMatroskaHeaderPresent(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<ContainerInfo> MatroskaAudioCodec::TryReadInfo(
+    const std::shared_ptr<const VirtualFile> &source,
+    const std::string &extensionHint /* = std::string() */
+  ) const {
+    (void)extensionHint;
+
+    // As the AudioCodec interface promises, if the file is not a Matroska file,
+    // we'll return an empty result to indicate that we couldn't read it.
+    if(!Detection::CheckIfMatroskaHeaderPresent(*source)) {
+      return std::optional<ContainerInfo>();
+    }
+
+    std::shared_ptr<const MatroskaSegment> segment = MatroskaReader::ReadSegment(source);
+    std::vector<std::size_t> trackIndices = findDecodableTracks(*segment);
+
+    ContainerInfo containerInfo;
+    containerInfo.DefaultTrackIndex = 0;
+
+    bool hasDefaultTrack = false;
+    for(std::size_t index = 0; index < trackIndices.size(); ++index) {
+      const MatroskaTrack &track = segment->AudioTracks[trackIndices[index]];
+
+      // The codec headers have to be parsed for the channel layout and sample rate,
+      // the container's own values are only hints and Opus ignores them entirely
+      std::unique_ptr<Shared::PacketDecoder> packetDecoder = (
+        MatroskaTrackDecoder::TryCreatePacketDecoder(track)
+      );
+      std::uint64_t frameCount = MatroskaTrackDecoder::CountFrames(
+        source, segment, track, *packetDecoder
+      );
+
+      AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+      TrackInfo &trackInfo = containerInfo.Tracks.emplace_back();
+      trackInfo.CodecName = (track.CodecId == u8"A_VORBIS") ? u8"Vorbis" : u8"Opus";
+      trackInfo.Name = track.Name;
+      trackInfo.LanguageCode = track.Language;
+      trackInfo.ChannelCount = packetDecoder->CountChannels();
+      trackInfo.ChannelPlacements = ChannelPlacement::Unknown;
+      for(ChannelPlacement placement : packetDecoder->GetChannelOrder()) {
+        trackInfo.ChannelPlacements = trackInfo.ChannelPlacements | placement;
+      }
+      trackInfo.SampleRate = packetDecoder->GetSampleRate();
+      trackInfo.SampleFormat = AudioSampleFormat::Float_32;
+      trackInfo.BitsPerSample = 16; // Lossy codecs have no real bit depth, report CD quality
+      trackInfo.FrameCount = frameCount;
+      trackInfo.Duration = std::chrono::microseconds(
+        frameCount * 1'000'000 / trackInfo.SampleRate
+      );
+      trackInfo.LeadingPaddingFrameCount = MatroskaTrackDecoder::GetCodecDelayFrameCount(
+        track, *packetDecoder
+      );
+
+      // The first track flagged as default wins, otherwise the first track is used
+      if(track.IsDefault && !hasDefaultTrack) {
+        containerInfo.DefaultTrackIndex = index;
+        hasDefaultTrack = true;
+      }
+    }
+
+    return containerInfo;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> MatroskaAudioCodec::TryOpenDecoder(
+    const std::shared_ptr<const VirtualFile> &source,
+    const std::string &extensionHint /* = std::string() */,
+    std::size_t trackIndex /* = 0 */
+  ) const {
+    (void)extensionHint;
+
+    // As the AudioCodec interface promises, if the file is not a Matroska file,
+    // we'll return an empty result to indicate that we couldn't read it.
+    if(!Detection::CheckIfMatroskaHeaderPresent(*source)) {
+      return std::shared_ptr<AudioTrackDecoder>();
+    }
+
+    std::shared_ptr<const MatroskaSegment> segment = MatroskaReader::ReadSegment(source);
+    std::vector<std::size_t> trackIndices = findDecodableTracks(*segment);
+    if(trackIndex >= trackIndices.size()) {
+      throw std::out_of_range(u8"Track index is beyond the number of decodable audio tracks");
+    }
+
+    return std::make_shared<MatroskaTrackDecoder>(source, segment, trackIndices[trackIndex]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./MatroskaDetection.h"
+#include "./EbmlReader.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::min()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Id of the EBML header element every EBML document starts with</summary>
+  const std::uint32_t EbmlHeaderId = 0x1A45DFA3;
+
+  /// <summary>Id of the element stating the kind of EBML document</summary>
+  const std::uint32_t DocTypeId = 0x4282;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfMatroskaHeaderPresent(const VirtualFile &source) {
+    std::uint64_t fileSize = source.GetSize();
+    if(fileSize < 16) {
+      return false; // File is too small to hold even the EBML header
+    }
+
+    std::byte fileHeader[MatroskaHeaderCheckLength];
+    std::size_t headerLength = static_cast<std::size_t>(
+      std::min<std::uint64_t>(fileSize, MatroskaHeaderCheckLength)
+    );
+    source.ReadAt(0, headerLength, fileHeader);
+
+    return CheckIfMatroskaHeaderPresent(fileHeader, headerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfMatroskaHeaderPresent(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    EbmlElement header;
+    if(!EbmlReader::TryReadElementHeader(fileHeader, byteCount, header)) {
+      return false;
+    }
+    if((header.Id != EbmlHeaderId) || header.IsSizeUnknown) {
+      return false;
+    }
+
+    // EBML is used by other formats, too, so look for the document type. If the header
+    // is longer than the bytes we got, we'll check the elements that are there.
+    std::size_t offset = static_cast<std::size_t>(header.DataOffset);
+    std::size_t end = static_cast<std::size_t>(
+      std::min<std::uint64_t>(byteCount, header.DataOffset + header.Size)
+    );
+    while(offset < end) {
+      EbmlElement child;
+      if(!EbmlReader::TryReadElementHeader(fileHeader + offset, end - offset, child)) {
+        return false;
+      }
+
+      std::size_t dataOffset = offset + static_cast<std::size_t>(child.DataOffset);
+      if(child.Id == DocTypeId) {
+        if(child.IsSizeUnknown || (child.Size > end - dataOffset)) {
+          return false;
+        }
+
+        std::string docType = EbmlReader::ReadString(
+          fileHeader + dataOffset, static_cast<std::size_t>(child.Size)
+        );
+        return (docType == u8"matroska") || (docType == u8"webm");
+      }
+
+      if(child.IsSizeUnknown || (child.Size > end - dataOffset)) {
+        return false;
+      }
+      offset = dataOffset + static_cast<std::size_t>(child.Size);
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
@@ -0,0 +1,401 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./MatroskaPacketSource.h"
+#include "./EbmlReader.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include <algorithm> // for std::min()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Id of the cluster elements that hold the actual blocks</summary>
+  const std::uint32_t ClusterId = 0x1F43B675;
+  /// <summary>Id of the element holding a cluster's timestamp</summary>
+  const std::uint32_t ClusterTimestampId = 0xE7;
+  /// <summary>Id of a block that carries its flags and no additional elements</summary>
+  const std::uint32_t SimpleBlockId = 0xA3;
+  /// <summary>Id of a group wrapping a block together with additional elements</summary>
+  const std::uint32_t BlockGroupId = 0xA0;
+  /// <summary>Id of the block inside a block group</summary>
+  const std::uint32_t BlockId = 0xA1;
+
+  /// <summary>Lacing bits in a block's flags indicating Xiph-style lacing</summary>
+  const std::uint8_t XiphLacing = 0x02;
+  /// <summary>Lacing bits in a block's flags indicating fixed-size lacing</summary>
+  const std::uint8_t FixedSizeLacing = 0x04;
+  /// <summary>Lacing bits in a block's flags indicating EBML lacing</summary>
+  const std::uint8_t EbmlLacing = 0x06;
+
+  /// <summary>Largest block that will be loaded into memory</summary>
+  const std::uint64_t MaximumBlockSize = 16 * 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception reporting a malformed laced block</summary>
+  [[noreturn]] void throwInvalidLacing() {
+    throw Nuclex::Audio::Errors::CorruptedFileError(
+      u8"Matroska block contains invalid lacing information"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MatroskaPacketSource::MatroskaPacketSource(
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::shared_ptr<const MatroskaSegment> &segment,
+    std::uint64_t trackNumber
+  ) :
+    file(file),
+    segment(segment),
+    trackNumber(trackNumber),
+    offset(segment->FirstClusterOffset),
+    isInCluster(false),
+    isClusterSizeUnknown(false),
+    clusterEnd(0),
+    clusterTimestamp(0),
+    queuedFrames(),
+    queuedFrameIndex(0),
+    queuedTimestamp(0),
+    pendingPacket(),
+    pendingTimestamp(0),
+    hasPendingPacket(false),
+    blockBuffer() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::int64_t MatroskaPacketSource::Seek(std::int64_t timestamp) {
+    const std::vector<MatroskaCuePoint> &cuePoints = this->segment->CuePoints;
+
+    // Find the last cue point at or before the target. Cue points are sorted
+    // by timestamp, so the search can stop at the first one that's too late.
+    std::size_t cueCount = 0;
+    while((cueCount < cuePoints.size()) && (cuePoints[cueCount].Timestamp <= timestamp)) {
+      ++cueCount;
+    }
+
+    // The cue may have been written for a video track whose keyframe comes after
+    // the first audio block in the cluster, or the other way around. Back up until
+    // the first packet delivered doesn't lie beyond the target anymore.
+    while(0 < cueCount) {
+      --cueCount;
+
+      moveToCluster(cuePoints[cueCount].ClusterOffset);
+      this->hasPendingPacket = readNextPacket(this->pendingPacket, this->pendingTimestamp);
+      if(this->hasPendingPacket && (this->pendingTimestamp <= timestamp)) {
+        return this->pendingTimestamp;
+      }
+    }
+
+    // No usable cue point, start from the very beginning
+    moveToCluster(this->segment->FirstClusterOffset);
+    this->hasPendingPacket = readNextPacket(this->pendingPacket, this->pendingTimestamp);
+    if(this->hasPendingPacket) {
+      return this->pendingTimestamp;
+    } else {
+      return timestamp;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MatroskaPacketSource::ReadPacket(std::vector<std::byte> &packet, std::int64_t &timestamp) {
+    if(this->hasPendingPacket) {
+      packet.swap(this->pendingPacket);
+      timestamp = this->pendingTimestamp;
+      this->hasPendingPacket = false;
+      return true;
+    }
+
+    return readNextPacket(packet, timestamp);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaPacketSource::moveToCluster(std::uint64_t clusterOffset) {
+    this->offset = clusterOffset;
+    this->isInCluster = false;
+    this->queuedFrames.clear();
+    this->queuedFrameIndex = 0;
+    this->hasPendingPacket = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MatroskaPacketSource::readNextPacket(
+    std::vector<std::byte> &packet, std::int64_t &timestamp
+  ) {
+    for(;;) {
+
+      // If the last block had several frames laced into it, deliver those first
+      if(this->queuedFrameIndex < this->queuedFrames.size()) {
+        packet.swap(this->queuedFrames[this->queuedFrameIndex]);
+        timestamp = this->queuedTimestamp;
+        ++this->queuedFrameIndex;
+        return true;
+      }
+
+      EbmlElement element;
+
+      // Outside of a cluster, look for the next cluster among the segment's children
+      if(!this->isInCluster) {
+        bool isValid = EbmlReader::TryReadElementHeader(
+          *this->file, this->offset, this->segment->DataEnd, element
+        );
+        if(!isValid) {
+          return false;
+        }
+
+        if(element.Id == ClusterId) {
+          this->isInCluster = true;
+          this->isClusterSizeUnknown = element.IsSizeUnknown;
+          this->clusterTimestamp = 0;
+          if(element.IsSizeUnknown) {
+            this->clusterEnd = this->segment->DataEnd;
+          } else {
+            this->clusterEnd = std::min(
+              element.DataOffset + element.Size, this->segment->DataEnd
+            );
+          }
+          this->offset = element.DataOffset;
+        } else if(element.IsSizeUnknown) {
+          return false; // Unknown element of unknown size, nothing we can skip
+        } else {
+          this->offset = element.DataOffset + element.Size; // Cues, tags, void, ...
+        }
+
+        continue;
+      }
+
+      // Inside a cluster, read the cluster's timestamp and blocks
+      bool isValid = EbmlReader::TryReadElementHeader(
+        *this->file, this->offset, this->clusterEnd, element
+      );
+      if(!isValid) {
+        this->offset = this->clusterEnd;
+        this->isInCluster = false;
+        continue;
+      }
+
+      // A cluster of unknown size ends where the next cluster begins
+      if(this->isClusterSizeUnknown && (element.Id == ClusterId)) {
+        this->isInCluster = false;
+        continue;
+      }
+      if(element.IsSizeUnknown || (element.Size > this->clusterEnd - element.DataOffset)) {
+        return false; // Truncated file, deliver what could be read
+      }
+
+      if(element.Id == ClusterTimestampId) {
+        std::byte value[8];
+        std::size_t valueSize = static_cast<std::size_t>(std::min<std::uint64_t>(element.Size, 8));
+        this->file->ReadAt(element.DataOffset, valueSize, value);
+        this->clusterTimestamp = EbmlReader::ReadUnsigned(value, valueSize);
+      } else if(element.Id == SimpleBlockId) {
+        readBlock(element.DataOffset, element.Size);
+      } else if(element.Id == BlockGroupId) {
+        readBlockGroup(element.DataOffset, element.Size);
+      }
+
+      this->offset = element.DataOffset + element.Size;
+
+    } // for(;;)
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaPacketSource::readBlockGroup(std::uint64_t dataOffset, std::uint64_t size) {
+    std::uint64_t end = dataOffset + size;
+    EbmlElement element;
+    while(EbmlReader::TryReadElementHeader(*this->file, dataOffset, end, element)) {
+      if(element.IsSizeUnknown || (element.Size > end - element.DataOffset)) {
+        return;
+      }
+      if(element.Id == BlockId) {
+        readBlock(element.DataOffset, element.Size);
+        return;
+      }
+
+      dataOffset = element.DataOffset + element.Size;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaPacketSource::readBlock(std::uint64_t dataOffset, std::uint64_t size) {
+
+    // Peek at the track number first so blocks of other tracks can be skipped
+    // without reading them. The header is the track number, a 16-bit relative
+    // timestamp and one byte of flags.
+    std::byte header[11];
+    std::size_t headerSize = static_cast<std::size_t>(std::min<std::uint64_t>(size, 11));
+    this->file->ReadAt(dataOffset, headerSize, header);
+
+    std::uint64_t blockTrackNumber;
+    std::size_t trackNumberLength = EbmlReader::ReadVariableInteger(
+      header, headerSize, blockTrackNumber
+    );
+    if((trackNumberLength == 0) || (blockTrackNumber != this->trackNumber)) {
+      return;
+    }
+    if(headerSize < trackNumberLength + 3) {
+      throw Errors::CorruptedFileError(u8"Matroska block is too short to hold its header");
+    }
+    if(size > MaximumBlockSize) {
+      throw Errors::CorruptedFileError(u8"Matroska block has an implausible size");
+    }
+
+    std::int16_t relativeTimestamp = static_cast<std::int16_t>(
+      (static_cast<std::uint16_t>(header[trackNumberLength]) << 8) |
+      static_cast<std::uint16_t>(header[trackNumberLength + 1])
+    );
+    std::uint8_t flags = static_cast<std::uint8_t>(header[trackNumberLength + 2]);
+
+    this->queuedTimestamp = (
+      (static_cast<std::int64_t>(this->clusterTimestamp) + relativeTimestamp) *
+      static_cast<std::int64_t>(this->segment->TimestampScale)
+    );
+
+    std::size_t blockHeaderSize = trackNumberLength + 3;
+    std::size_t blockDataSize = static_cast<std::size_t>(size) - blockHeaderSize;
+    this->blockBuffer.resize(blockDataSize);
+    if(blockDataSize > 0) {
+      this->file->ReadAt(dataOffset + blockHeaderSize, blockDataSize, this->blockBuffer.data());
+    }
+
+    unlace(this->blockBuffer.data(), blockDataSize, flags & 0x06);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaPacketSource::unlace(
+    const std::byte *blockData, std::size_t size, std::uint8_t lacing
+  ) {
+    this->queuedFrameIndex = 0;
+
+    if(lacing == 0) {
+      this->queuedFrames.resize(1);
+      this->queuedFrames[0].assign(blockData, blockData + size);
+      return;
+    }
+
+    // Laced blocks start with the number of frames minus one
+    if(size < 1) {
+      throwInvalidLacing();
+    }
+    std::size_t frameCount = static_cast<std::size_t>(blockData[0]) + 1;
+    std::size_t position = 1;
+
+    std::vector<std::size_t> frameSizes(frameCount);
+    if(lacing == XiphLacing) {
+
+      // Each size is a run of 255 bytes terminated by a smaller byte
+      for(std::size_t index = 0; index < frameCount - 1; ++index) {
+        std::size_t frameSize = 0;
+        for(;;) {
+          if(position >= size) {
+            throwInvalidLacing();
+          }
+          std::uint8_t lacingByte = static_cast<std::uint8_t>(blockData[position++]);
+          frameSize += lacingByte;
+          if(lacingByte != 255) {
+            break;
+          }
+        }
+        frameSizes[index] = frameSize;
+      }
+
+    } else if(lacing == EbmlLacing) {
+
+      // The first size is stored as is, the others as signed differences to their
+      // predecessor, using the variable integer format with a bias.
+      std::uint64_t value;
+      std::size_t length = EbmlReader::ReadVariableInteger(
+        blockData + position, size - position, value
+      );
+      if(length == 0) {
+        throwInvalidLacing();
+      }
+      position += length;
+
+      std::int64_t frameSize = static_cast<std::int64_t>(value);
+      if(frameCount > 1) {
+        frameSizes[0] = static_cast<std::size_t>(frameSize);
+      }
+      for(std::size_t index = 1; index < frameCount - 1; ++index) {
+        length = EbmlReader::ReadVariableInteger(blockData + position, size - position, value);
+        if(length == 0) {
+          throwInvalidLacing();
+        }
+        position += length;
+
+        std::int64_t bias = (std::int64_t(1) << (length * 7 - 1)) - 1;
+        frameSize += static_cast<std::int64_t>(value) - bias;
+        if(frameSize < 0) {
+          throwInvalidLacing();
+        }
+        frameSizes[index] = static_cast<std::size_t>(frameSize);
+      }
+
+    } else if(lacing == FixedSizeLacing) {
+
+      if(((size - position) % frameCount) != 0) {
+        throwInvalidLacing();
+      }
+      for(std::size_t index = 0; index < frameCount - 1; ++index) {
+        frameSizes[index] = (size - position) / frameCount;
+      }
+
+    }
+
+    // The last frame takes up whatever remains of the block
+    std::size_t remaining = size - position;
+    for(std::size_t index = 0; index < frameCount - 1; ++index) {
+      if(frameSizes[index] > remaining) {
+        throwInvalidLacing();
+      }
+      remaining -= frameSizes[index];
+    }
+    frameSizes[frameCount - 1] = remaining;
+
+    this->queuedFrames.resize(frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      this->queuedFrames[index].assign(
+        blockData + position, blockData + position + frameSizes[index]
+      );
+      position += frameSizes[index];
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
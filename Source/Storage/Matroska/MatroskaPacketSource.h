@@ -0,0 +1,141 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAPACKETSOURCE_H
+#define NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAPACKETSOURCE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "../Shared/PacketSource.h"
+#include "./MatroskaReader.h"
+
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pulls the packets of a single audio track out of a Matroska file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Clusters are walked element by element. Only the track number at the start
+  ///     of each block is read before deciding whether the block belongs to the track,
+  ///     so video blocks and the blocks of other audio tracks are skipped without
+  ///     ever being loaded.
+  ///   </para>
+  ///   <para>
+  ///     Seeking uses the cue points, regardless of which track they were written for,
+  ///     since they all point at the start of a cluster and clusters hold the blocks
+  ///     of all tracks. Files without cues are read from the first cluster on.
+  ///   </para>
+  ///   <para>
+  ///     When several frames are laced into one block, only the block's timestamp is
+  ///     stored, so all of them are reported with it.
+  ///   </para>
+  /// </remarks>
+  class MatroskaPacketSource : public Shared::PacketSource {
+
+    /// <summary>Initializes a new packet source for a track in a Matroska file</summary>
+    /// <param name="file">File holding the Matroska segment</param>
+    /// <param name="segment">Segment headers previously read from the file</param>
+    /// <param name="trackNumber">Number of the track whose packets will be delivered</param>
+    public: MatroskaPacketSource(
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::shared_ptr<const MatroskaSegment> &segment,
+      std::uint64_t trackNumber
+    );
+
+    /// <summary>Frees all resources owned by the packet source</summary>
+    public: ~MatroskaPacketSource() override = default;
+
+    /// <summary>Moves the packet cursor to a point at or before a timestamp</summary>
+    /// <param name="timestamp">Timestamp, in nanoseconds, that should be reached</param>
+    /// <returns>The timestamp of the packet that will be delivered next</returns>
+    public: std::int64_t Seek(std::int64_t timestamp) override;
+
+    /// <summary>Reads the next packet of the track</summary>
+    /// <param name="packet">Receives the packet's contents</param>
+    /// <param name="timestamp">Receives the packet's timestamp in nanoseconds</param>
+    /// <returns>True if a packet was read, false if the end of the track was reached</returns>
+    public: bool ReadPacket(std::vector<std::byte> &packet, std::int64_t &timestamp) override;
+
+    /// <summary>Moves the read position to the start of a cluster</summary>
+    /// <param name="clusterOffset">Absolute offset of the cluster's element header</param>
+    private: void moveToCluster(std::uint64_t clusterOffset);
+
+    /// <summary>Reads the next packet from the file, bypassing the pending packet</summary>
+    /// <param name="packet">Receives the packet's contents</param>
+    /// <param name="timestamp">Receives the packet's timestamp in nanoseconds</param>
+    /// <returns>True if a packet was read, false if the end of the track was reached</returns>
+    private: bool readNextPacket(std::vector<std::byte> &packet, std::int64_t &timestamp);
+
+    /// <summary>Reads a block and queues its frames if it belongs to the track</summary>
+    /// <param name="dataOffset">Absolute offset of the block's data</param>
+    /// <param name="size">Size of the block's data in bytes</param>
+    private: void readBlock(std::uint64_t dataOffset, std::uint64_t size);
+
+    /// <summary>Looks for the block inside a block group and reads it</summary>
+    /// <param name="dataOffset">Absolute offset of the block group's data</param>
+    /// <param name="size">Size of the block group's data in bytes</param>
+    private: void readBlockGroup(std::uint64_t dataOffset, std::uint64_t size);
+
+    /// <summary>Splits laced block data into individual frames</summary>
+    /// <param name="blockData">Block data following the block header</param>
+    /// <param name="size">Number of bytes of block data</param>
+    /// <param name="lacing">Lacing bits from the block's flags</param>
+    private: void unlace(const std::byte *blockData, std::size_t size, std::uint8_t lacing);
+
+    /// <summary>File from which the Matroska segment is read</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Segment headers with the timestamp scale and cue points</summary>
+    private: std::shared_ptr<const MatroskaSegment> segment;
+    /// <summary>Number of the track whose packets are delivered</summary>
+    private: std::uint64_t trackNumber;
+    /// <summary>Absolute offset of the next element that will be read</summary>
+    private: std::uint64_t offset;
+    /// <summary>Whether the read position is inside a cluster</summary>
+    private: bool isInCluster;
+    /// <summary>Whether the current cluster's size was left open by the writer</summary>
+    private: bool isClusterSizeUnknown;
+    /// <summary>Absolute offset at which the current cluster ends</summary>
+    private: std::uint64_t clusterEnd;
+    /// <summary>Timestamp of the current cluster in timestamp units</summary>
+    private: std::uint64_t clusterTimestamp;
+    /// <summary>Frames of the last block that haven't been delivered yet</summary>
+    private: std::vector<std::vector<std::byte>> queuedFrames;
+    /// <summary>Index of the next queued frame that will be delivered</summary>
+    private: std::size_t queuedFrameIndex;
+    /// <summary>Timestamp of the block the queued frames came from</summary>
+    private: std::int64_t queuedTimestamp;
+    /// <summary>Packet that was read ahead while seeking</summary>
+    private: std::vector<std::byte> pendingPacket;
+    /// <summary>Timestamp of the packet that was read ahead while seeking</summary>
+    private: std::int64_t pendingTimestamp;
+    /// <summary>Whether a packet was read ahead and still needs to be delivered</summary>
+    private: bool hasPendingPacket;
+    /// <summary>Buffer blocks are loaded into before they're split into frames</summary>
+    private: std::vector<std::byte> blockBuffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAPACKETSOURCE_H
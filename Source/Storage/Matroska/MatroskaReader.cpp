@@ -0,0 +1,544 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./MatroskaReader.h"
+#include "./EbmlReader.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include <algorithm> // for std::sort(), std::min()
+#include <cmath> // for std::llround()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Id of the EBML header element every EBML document starts with</summary>
+  const std::uint32_t EbmlHeaderId = 0x1A45DFA3;
+  /// <summary>Id of the segment element that holds everything else</summary>
+  const std::uint32_t SegmentId = 0x18538067;
+  /// <summary>Id of the seek head that lists the positions of top-level elements</summary>
+  const std::uint32_t SeekHeadId = 0x114D9B74;
+  /// <summary>Id of a single entry in the seek head</summary>
+  const std::uint32_t SeekId = 0x4DBB;
+  /// <summary>Id of the element holding the id a seek head entry points to</summary>
+  const std::uint32_t SeekIdId = 0x53AB;
+  /// <summary>Id of the element holding the position a seek head entry points to</summary>
+  const std::uint32_t SeekPositionId = 0x53AC;
+  /// <summary>Id of the segment info element</summary>
+  const std::uint32_t InfoId = 0x1549A966;
+  /// <summary>Id of the element stating the nanoseconds per timestamp unit</summary>
+  const std::uint32_t TimestampScaleId = 0x2AD7B1;
+  /// <summary>Id of the element stating the segment's duration in timestamp units</summary>
+  const std::uint32_t DurationId = 0x4489;
+  /// <summary>Id of the element listing all tracks in the segment</summary>
+  const std::uint32_t TracksId = 0x1654AE6B;
+  /// <summary>Id of the element describing a single track</summary>
+  const std::uint32_t TrackEntryId = 0xAE;
+  /// <summary>Id of the element holding a track's number</summary>
+  const std::uint32_t TrackNumberId = 0xD7;
+  /// <summary>Id of the element holding a track's type</summary>
+  const std::uint32_t TrackTypeId = 0x83;
+  /// <summary>Id of the element holding a track's codec id</summary>
+  const std::uint32_t CodecIdId = 0x86;
+  /// <summary>Id of the element holding a track's codec setup data</summary>
+  const std::uint32_t CodecPrivateId = 0x63A2;
+  /// <summary>Id of the element holding a track's codec delay</summary>
+  const std::uint32_t CodecDelayId = 0x56AA;
+  /// <summary>Id of the element holding a track's seek pre-roll</summary>
+  const std::uint32_t SeekPreRollId = 0x56BB;
+  /// <summary>Id of the element holding a track's human-readable name</summary>
+  const std::uint32_t NameId = 0x536E;
+  /// <summary>Id of the element holding a track's ISO 639-2 language</summary>
+  const std::uint32_t LanguageId = 0x22B59C;
+  /// <summary>Id of the element holding a track's BCP 47 language</summary>
+  const std::uint32_t LanguageBcp47Id = 0x22B59D;
+  /// <summary>Id of the element flagging a track as the default of its type</summary>
+  const std::uint32_t FlagDefaultId = 0x88;
+  /// <summary>Id of the element holding the audio settings of a track</summary>
+  const std::uint32_t AudioId = 0xE1;
+  /// <summary>Id of the element holding an audio track's sample rate</summary>
+  const std::uint32_t SamplingFrequencyId = 0xB5;
+  /// <summary>Id of the element holding an audio track's channel count</summary>
+  const std::uint32_t ChannelsId = 0x9F;
+  /// <summary>Id of the cues element that indexes the clusters</summary>
+  const std::uint32_t CuesId = 0x1C53BB6B;
+  /// <summary>Id of a single cue point</summary>
+  const std::uint32_t CuePointId = 0xBB;
+  /// <summary>Id of the element holding a cue point's timestamp</summary>
+  const std::uint32_t CueTimeId = 0xB3;
+  /// <summary>Id of the element pointing a cue point at a track's cluster</summary>
+  const std::uint32_t CueTrackPositionsId = 0xB7;
+  /// <summary>Id of the element holding the track a cue position is for</summary>
+  const std::uint32_t CueTrackId = 0xF7;
+  /// <summary>Id of the element holding the segment-relative cluster position</summary>
+  const std::uint32_t CueClusterPositionId = 0xF1;
+  /// <summary>Id of the cluster elements that hold the actual blocks</summary>
+  const std::uint32_t ClusterId = 0x1F43B675;
+
+  /// <summary>Track type Matroska uses for audio tracks</summary>
+  const std::uint64_t AudioTrackType = 2;
+
+  /// <summary>Largest header element that will be loaded into memory</summary>
+  /// <remarks>
+  ///   The cues of a file several hours long stay well below this. Anything larger
+  ///   is much more likely to be a corrupted size than a legitimate element.
+  /// </remarks>
+  const std::uint64_t MaximumHeaderElementSize = 64 * 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Invokes a callback for each child element in a master element's data</summary>
+  /// <typeparam name="TCallback">Callback receiving the id, data and size of each child</typeparam>
+  /// <param name="data">Data of the master element</param>
+  /// <param name="size">Size of the master element's data</param>
+  /// <param name="callback">Callback that will be invoked for each child element</param>
+  template<typename TCallback>
+  void forEachChild(const std::byte *data, std::size_t size, TCallback &&callback) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+    using Nuclex::Audio::Storage::Matroska::EbmlElement;
+
+    std::size_t offset = 0;
+    while(offset < size) {
+      EbmlElement child;
+      bool isValid = EbmlReader::TryReadElementHeader(data + offset, size - offset, child);
+      if(!isValid || child.IsSizeUnknown || (child.Size > size - offset - child.DataOffset)) {
+        throw Nuclex::Audio::Errors::CorruptedFileError(
+          u8"Matroska header element contains a malformed child element"
+        );
+      }
+
+      const std::byte *childData = data + offset + child.DataOffset;
+      std::size_t childSize = static_cast<std::size_t>(child.Size);
+      callback(child.Id, childData, childSize);
+
+      offset += static_cast<std::size_t>(child.DataOffset) + childSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads the data of a header element into memory</summary>
+  /// <param name="file">File from which the element will be loaded</param>
+  /// <param name="element">Header of the element that will be loaded</param>
+  /// <param name="end">Offset the element's data may not extend beyond</param>
+  /// <returns>A buffer holding the element's data</returns>
+  std::vector<std::byte> loadElementData(
+    const Nuclex::Audio::Storage::VirtualFile &file,
+    const Nuclex::Audio::Storage::Matroska::EbmlElement &element,
+    std::uint64_t end
+  ) {
+    if(
+      element.IsSizeUnknown ||
+      (element.Size > MaximumHeaderElementSize) ||
+      (element.DataOffset > end) ||
+      (element.Size > end - element.DataOffset)
+    ) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(
+        u8"Matroska header element has an invalid size. File truncated?"
+      );
+    }
+
+    std::vector<std::byte> data(static_cast<std::size_t>(element.Size));
+    if(!data.empty()) {
+      file.ReadAt(element.DataOffset, data.size(), data.data());
+    }
+
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the timestamp scale and duration from the segment info</summary>
+  /// <param name="data">Data of the segment info element</param>
+  /// <param name="segment">Segment that will receive the timestamp scale and duration</param>
+  void parseInfo(
+    const std::vector<std::byte> &data, Nuclex::Audio::Storage::Matroska::MatroskaSegment &segment
+  ) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+
+    std::optional<double> duration;
+    forEachChild(
+      data.data(), data.size(),
+      [&](std::uint32_t id, const std::byte *childData, std::size_t childSize) {
+        if(id == TimestampScaleId) {
+          segment.TimestampScale = EbmlReader::ReadUnsigned(childData, childSize);
+        } else if(id == DurationId) {
+          duration = EbmlReader::ReadFloat(childData, childSize);
+        }
+      }
+    );
+    if(segment.TimestampScale == 0) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(
+        u8"Matroska segment info states a timestamp scale of zero"
+      );
+    }
+
+    // The duration is stored in timestamp units, so it can only be converted once
+    // the timestamp scale is known, which may be stored after it.
+    if(duration.has_value() && (duration.value() > 0.0)) {
+      segment.Duration = static_cast<std::int64_t>(
+        std::llround(duration.value() * static_cast<double>(segment.TimestampScale))
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the audio settings of a track entry</summary>
+  /// <param name="data">Data of the audio element</param>
+  /// <param name="size">Size of the audio element's data</param>
+  /// <param name="track">Track that will receive the audio settings</param>
+  void parseAudioSettings(
+    const std::byte *data, std::size_t size,
+    Nuclex::Audio::Storage::Matroska::MatroskaTrack &track
+  ) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+
+    forEachChild(
+      data, size,
+      [&](std::uint32_t id, const std::byte *childData, std::size_t childSize) {
+        if(id == SamplingFrequencyId) {
+          track.SamplingFrequency = EbmlReader::ReadFloat(childData, childSize);
+        } else if(id == ChannelsId) {
+          track.ChannelCount = static_cast<std::size_t>(
+            EbmlReader::ReadUnsigned(childData, childSize)
+          );
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the audio tracks from the track list</summary>
+  /// <param name="data">Data of the tracks element</param>
+  /// <param name="segment">Segment that will receive the audio tracks</param>
+  void parseTracks(
+    const std::vector<std::byte> &data, Nuclex::Audio::Storage::Matroska::MatroskaSegment &segment
+  ) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+    using Nuclex::Audio::Storage::Matroska::MatroskaTrack;
+
+    forEachChild(
+      data.data(), data.size(),
+      [&](std::uint32_t id, const std::byte *entryData, std::size_t entrySize) {
+        if(id != TrackEntryId) {
+          return;
+        }
+
+        // Start out with the defaults the Matroska specification defines
+        MatroskaTrack track;
+        track.Number = 0;
+        track.CodecDelay = 0;
+        track.SeekPreRoll = 0;
+        track.SamplingFrequency = 8000.0;
+        track.ChannelCount = 1;
+        track.IsDefault = true;
+
+        std::uint64_t trackType = 0;
+        std::optional<std::string> bcp47Language;
+        forEachChild(
+          entryData, entrySize,
+          [&](std::uint32_t id, const std::byte *childData, std::size_t childSize) {
+            switch(id) {
+              case TrackNumberId: {
+                track.Number = EbmlReader::ReadUnsigned(childData, childSize); break;
+              }
+              case TrackTypeId: {
+                trackType = EbmlReader::ReadUnsigned(childData, childSize); break;
+              }
+              case CodecIdId: {
+                track.CodecId = EbmlReader::ReadString(childData, childSize); break;
+              }
+              case CodecPrivateId: {
+                track.CodecPrivate.assign(childData, childData + childSize); break;
+              }
+              case CodecDelayId: {
+                track.CodecDelay = EbmlReader::ReadUnsigned(childData, childSize); break;
+              }
+              case SeekPreRollId: {
+                track.SeekPreRoll = EbmlReader::ReadUnsigned(childData, childSize); break;
+              }
+              case NameId: {
+                track.Name = EbmlReader::ReadString(childData, childSize); break;
+              }
+              case LanguageId: {
+                track.Language = EbmlReader::ReadString(childData, childSize); break;
+              }
+              case LanguageBcp47Id: {
+                bcp47Language = EbmlReader::ReadString(childData, childSize); break;
+              }
+              case FlagDefaultId: {
+                track.IsDefault = (EbmlReader::ReadUnsigned(childData, childSize) != 0); break;
+              }
+              case AudioId: {
+                parseAudioSettings(childData, childSize, track); break;
+              }
+              default: { break; }
+            }
+          }
+        );
+
+        // The BCP 47 language, if present, takes precedence over the ISO 639-2 one
+        if(bcp47Language.has_value()) {
+          track.Language = std::move(bcp47Language);
+        }
+        if((trackType == AudioTrackType) && (track.Number != 0)) {
+          segment.AudioTracks.push_back(std::move(track));
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the cue points from the cues element</summary>
+  /// <param name="data">Data of the cues element</param>
+  /// <param name="segment">Segment that will receive the cue points</param>
+  void parseCues(
+    const std::vector<std::byte> &data, Nuclex::Audio::Storage::Matroska::MatroskaSegment &segment
+  ) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+    using Nuclex::Audio::Storage::Matroska::MatroskaCuePoint;
+
+    forEachChild(
+      data.data(), data.size(),
+      [&](std::uint32_t id, const std::byte *pointData, std::size_t pointSize) {
+        if(id != CuePointId) {
+          return;
+        }
+
+        // A cue point has one timestamp but can point into clusters for several tracks
+        std::uint64_t cueTime = 0;
+        std::vector<MatroskaCuePoint> positions;
+        forEachChild(
+          pointData, pointSize,
+          [&](std::uint32_t id, const std::byte *childData, std::size_t childSize) {
+            if(id == CueTimeId) {
+              cueTime = EbmlReader::ReadUnsigned(childData, childSize);
+            } else if(id == CueTrackPositionsId) {
+              MatroskaCuePoint position = { 0, 0, 0 };
+              forEachChild(
+                childData, childSize,
+                [&](std::uint32_t id, const std::byte *valueData, std::size_t valueSize) {
+                  if(id == CueTrackId) {
+                    position.TrackNumber = EbmlReader::ReadUnsigned(valueData, valueSize);
+                  } else if(id == CueClusterPositionId) {
+                    position.ClusterOffset = EbmlReader::ReadUnsigned(valueData, valueSize);
+                  }
+                }
+              );
+              positions.push_back(position);
+            }
+          }
+        );
+
+        // Cluster positions are relative to the segment's data, drop any that point
+        // outside of the segment rather than letting a seek read garbage later.
+        for(MatroskaCuePoint &position : positions) {
+          std::uint64_t segmentLength = segment.DataEnd - segment.DataOffset;
+          if(position.ClusterOffset < segmentLength) {
+            position.Timestamp = static_cast<std::int64_t>(cueTime * segment.TimestampScale);
+            position.ClusterOffset += segment.DataOffset;
+            segment.CuePoints.push_back(position);
+          }
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the positions of top-level elements from the seek head</summary>
+  /// <param name="data">Data of the seek head element</param>
+  /// <param name="segment">Segment the seek head belongs to</param>
+  /// <param name="seekTargets">Receives the element ids and their absolute offsets</param>
+  void parseSeekHead(
+    const std::vector<std::byte> &data,
+    const Nuclex::Audio::Storage::Matroska::MatroskaSegment &segment,
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> &seekTargets
+  ) {
+    using Nuclex::Audio::Storage::Matroska::EbmlReader;
+
+    forEachChild(
+      data.data(), data.size(),
+      [&](std::uint32_t id, const std::byte *seekData, std::size_t seekSize) {
+        if(id != SeekId) {
+          return;
+        }
+
+        std::uint32_t targetId = 0;
+        std::uint64_t targetPosition = 0;
+        forEachChild(
+          seekData, seekSize,
+          [&](std::uint32_t id, const std::byte *childData, std::size_t childSize) {
+            if(id == SeekIdId) {
+              targetId = static_cast<std::uint32_t>(EbmlReader::ReadUnsigned(childData, childSize));
+            } else if(id == SeekPositionId) {
+              targetPosition = EbmlReader::ReadUnsigned(childData, childSize);
+            }
+          }
+        );
+
+        if(targetPosition < segment.DataEnd - segment.DataOffset) {
+          seekTargets.emplace_back(targetId, segment.DataOffset + targetPosition);
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const MatroskaSegment> MatroskaReader::ReadSegment(
+    const std::shared_ptr<const VirtualFile> &source
+  ) {
+    std::uint64_t fileSize = source->GetSize();
+
+    // Skip the EBML header and anything else that precedes the first segment
+    EbmlElement element;
+    std::uint64_t offset = 0;
+    for(;;) {
+      if(!EbmlReader::TryReadElementHeader(*source, offset, fileSize, element)) {
+        throw Errors::CorruptedFileError(u8"Matroska file does not contain a segment");
+      }
+      if(element.Id == SegmentId) {
+        break;
+      }
+      if(element.IsSizeUnknown) {
+        throw Errors::CorruptedFileError(
+          u8"Matroska top-level element before the segment has an unknown size"
+        );
+      }
+      if((offset == 0) && (element.Id != EbmlHeaderId)) {
+        throw Errors::CorruptedFileError(u8"File does not start with an EBML header");
+      }
+      offset = element.DataOffset + element.Size;
+    }
+
+    std::shared_ptr<MatroskaSegment> segment = std::make_shared<MatroskaSegment>();
+    segment->DataOffset = element.DataOffset;
+    if(element.IsSizeUnknown || (element.Size > fileSize - element.DataOffset)) {
+      segment->DataEnd = fileSize; // Live recording or truncated file
+    } else {
+      segment->DataEnd = element.DataOffset + element.Size;
+    }
+    segment->FirstClusterOffset = segment->DataEnd;
+    segment->TimestampScale = 1000000;
+
+    // Walk the segment's children up to the first cluster. Muxers put the headers
+    // in front of the clusters, but the cues are usually appended at the end once
+    // the cluster positions are known and need to be found via the seek head.
+    bool isInfoRead = false, areTracksRead = false, areCuesRead = false;
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> seekTargets;
+    offset = segment->DataOffset;
+    while(EbmlReader::TryReadElementHeader(*source, offset, segment->DataEnd, element)) {
+      if(element.Id == ClusterId) {
+        segment->FirstClusterOffset = offset;
+        break;
+      }
+
+      if(element.Id == InfoId) {
+        parseInfo(loadElementData(*source, element, segment->DataEnd), *segment);
+        isInfoRead = true;
+      } else if(element.Id == TracksId) {
+        parseTracks(loadElementData(*source, element, segment->DataEnd), *segment);
+        areTracksRead = true;
+      } else if(element.Id == SeekHeadId) {
+        parseSeekHead(loadElementData(*source, element, segment->DataEnd), *segment, seekTargets);
+      } else if(element.Id == CuesId) {
+        // Cues are parsed at the end since their timestamps depend on the scale
+        seekTargets.emplace_back(CuesId, offset);
+      } else if(element.IsSizeUnknown) {
+        break; // Can't skip this, so the remaining elements have to come from the seek head
+      }
+
+      offset = element.DataOffset + element.Size;
+    }
+
+    // Pick up the elements stored after the clusters through the seek head
+    for(const std::pair<std::uint32_t, std::uint64_t> &seekTarget : seekTargets) {
+      bool isWanted = (
+        ((seekTarget.first == InfoId) && !isInfoRead) ||
+        ((seekTarget.first == TracksId) && !areTracksRead) ||
+        ((seekTarget.first == CuesId) && !areCuesRead)
+      );
+      if(!isWanted) {
+        continue;
+      }
+
+      bool isValid = EbmlReader::TryReadElementHeader(
+        *source, seekTarget.second, segment->DataEnd, element
+      );
+      if(!isValid || (element.Id != seekTarget.first)) {
+        continue; // Stale seek head entry, not fatal but the element stays missing
+      }
+
+      std::vector<std::byte> data = loadElementData(*source, element, segment->DataEnd);
+      if(element.Id == InfoId) {
+        parseInfo(data, *segment);
+        isInfoRead = true;
+      } else if(element.Id == TracksId) {
+        parseTracks(data, *segment);
+        areTracksRead = true;
+      }
+    }
+
+    // Cues go last because their timestamps need the timestamp scale from the info
+    for(const std::pair<std::uint32_t, std::uint64_t> &seekTarget : seekTargets) {
+      if((seekTarget.first != CuesId) || areCuesRead) {
+        continue;
+      }
+
+      bool isValid = EbmlReader::TryReadElementHeader(
+        *source, seekTarget.second, segment->DataEnd, element
+      );
+      if(isValid && (element.Id == CuesId)) {
+        parseCues(loadElementData(*source, element, segment->DataEnd), *segment);
+        areCuesRead = true;
+      }
+    }
+
+    if(!areTracksRead) {
+      throw Errors::CorruptedFileError(u8"Matroska segment does not contain a track list");
+    }
+
+    std::sort(
+      segment->CuePoints.begin(), segment->CuePoints.end(),
+      [](const MatroskaCuePoint &left, const MatroskaCuePoint &right) {
+        return left.Timestamp < right.Timestamp;
+      }
+    );
+
+    return segment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
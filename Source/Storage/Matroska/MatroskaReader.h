@@ -0,0 +1,136 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAREADER_H
+#define NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAREADER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t, std::int64_t
+#include <memory> // for std::shared_ptr
+#include <optional> // for std::optional
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio track declared in the 'Tracks' element of a Matroska file</summary>
+  struct MatroskaTrack {
+
+    /// <summary>Number by which the track's blocks refer to it</summary>
+    public: std::uint64_t Number;
+    /// <summary>Matroska codec id, such as A_OPUS or A_VORBIS</summary>
+    public: std::string CodecId;
+    /// <summary>Codec setup data, the Opus header or the three Vorbis headers</summary>
+    public: std::vector<std::byte> CodecPrivate;
+    /// <summary>Delay built into the codec, in nanoseconds</summary>
+    /// <remarks>
+    ///   Has to be subtracted from the block timestamps to get presentation times.
+    ///   Set to the Opus pre-skip by encoders that follow the Matroska Opus mapping.
+    /// </remarks>
+    public: std::uint64_t CodecDelay;
+    /// <summary>Nanoseconds that need to be decoded before a seek target</summary>
+    public: std::uint64_t SeekPreRoll;
+    /// <summary>Sample rate stated by the container</summary>
+    public: double SamplingFrequency;
+    /// <summary>Number of channels stated by the container</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Human-readable name of the track, if any</summary>
+    public: std::optional<std::string> Name;
+    /// <summary>Language of the track, BCP 47 if provided, otherwise ISO 639-2</summary>
+    public: std::optional<std::string> Language;
+    /// <summary>Whether the track is marked as the default track of its type</summary>
+    public: bool IsDefault;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Entry in the 'Cues' element that points at a cluster</summary>
+  struct MatroskaCuePoint {
+
+    /// <summary>Timestamp of the cue in nanoseconds</summary>
+    public: std::int64_t Timestamp;
+    /// <summary>Number of the track the cue has been written for</summary>
+    public: std::uint64_t TrackNumber;
+    /// <summary>Absolute offset of the cluster containing the cued block</summary>
+    public: std::uint64_t ClusterOffset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Structural informations read from the headers of a Matroska segment</summary>
+  struct MatroskaSegment {
+
+    /// <summary>Absolute offset at which the segment's data begins</summary>
+    public: std::uint64_t DataOffset;
+    /// <summary>Absolute offset at which the segment's data ends</summary>
+    public: std::uint64_t DataEnd;
+    /// <summary>Absolute offset of the first cluster, equal to the end if none</summary>
+    public: std::uint64_t FirstClusterOffset;
+    /// <summary>Nanoseconds per timestamp unit used by blocks and clusters</summary>
+    public: std::uint64_t TimestampScale;
+    /// <summary>Duration of the segment in nanoseconds, if stated</summary>
+    public: std::optional<std::int64_t> Duration;
+    /// <summary>All audio tracks declared in the segment</summary>
+    public: std::vector<MatroskaTrack> AudioTracks;
+    /// <summary>Cue points of all tracks, sorted by timestamp</summary>
+    public: std::vector<MatroskaCuePoint> CuePoints;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the headers of Matroska and WebM files</summary>
+  /// <remarks>
+  ///   Only the elements needed to find and decode audio are read: the segment info,
+  ///   the track list and the cues, which are often stored at the end of the file and
+  ///   located through the seek head. Clusters are not touched here, they're read by
+  ///   the <see cref="MatroskaPacketSource" /> as decoding progresses.
+  /// </remarks>
+  class MatroskaReader {
+
+    /// <summary>Reads the segment headers from a Matroska file</summary>
+    /// <param name="source">File from which the segment headers will be read</param>
+    /// <returns>The structural informations of the file's first segment</returns>
+    public: static std::shared_ptr<const MatroskaSegment> ReadSegment(
+      const std::shared_ptr<const VirtualFile> &source
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKAREADER_H
@@ -0,0 +1,638 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./MatroskaTrackDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+#include "../Shared/ClampingSampleConverter.h"
+#include "../Opus/OpusPacketDecoder.h"
+#include "../Vorbis/VorbisPacketDecoder.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range, std::logic_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of nanoseconds in one second</summary>
+  const std::int64_t NanosecondsPerSecond = 1000000000;
+
+  /// <summary>Shortest time decoded ahead of a seek target before delivering frames</summary>
+  /// <remarks>
+  ///   Opus tracks state an 80 ms seek pre-roll, Vorbis tracks usually state none but
+  ///   still need a packet or two to prime the overlap. 80 ms covers both.
+  /// </remarks>
+  const std::int64_t MinimumSeekPreRoll = 80000000;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a time in nanoseconds into a frame index</summary>
+  /// <param name="nanoseconds">Time that will be converted</param>
+  /// <param name="sampleRate">Number of frames per second</param>
+  /// <returns>The index of the frame at the specified time</returns>
+  std::int64_t nanosecondsToFrames(std::int64_t nanoseconds, std::size_t sampleRate) {
+    std::int64_t rate = static_cast<std::int64_t>(sampleRate);
+
+    // Split into seconds and the remainder so long tracks at high sample rates
+    // can't overflow the 64-bit intermediate result
+    return (
+      (nanoseconds / NanosecondsPerSecond) * rate +
+      ((nanoseconds % NanosecondsPerSecond) * rate + NanosecondsPerSecond / 2) /
+      NanosecondsPerSecond
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a frame index into a time in nanoseconds</summary>
+  /// <param name="frameIndex">Frame index that will be converted</param>
+  /// <param name="sampleRate">Number of frames per second</param>
+  /// <returns>The time at which the frame begins in nanoseconds</returns>
+  std::int64_t framesToNanoseconds(std::uint64_t frameIndex, std::size_t sampleRate) {
+    return static_cast<std::int64_t>(
+      (frameIndex / sampleRate) * NanosecondsPerSecond +
+      (frameIndex % sampleRate) * NanosecondsPerSecond / sampleRate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines which codec decoding statistics are recorded for</summary>
+  /// <param name="track">Track that is being decoded</param>
+  /// <returns>The codec the track's statistics will be attributed to</returns>
+  Nuclex::Audio::Storage::Shared::TrackedCodec getTrackedCodec(
+    const Nuclex::Audio::Storage::Matroska::MatroskaTrack &track
+  ) {
+    if(track.CodecId == u8"A_VORBIS") {
+      return Nuclex::Audio::Storage::Shared::TrackedCodec::Vorbis;
+    } else {
+      return Nuclex::Audio::Storage::Shared::TrackedCodec::Opus;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MatroskaTrackDecoder::MatroskaTrackDecoder(
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::shared_ptr<const MatroskaSegment> &segment,
+    std::size_t audioTrackIndex
+  ) :
+    file(),
+    segment(segment),
+    audioTrackIndex(audioTrackIndex),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(
+        getTrackedCodec(segment->AudioTracks.at(audioTrackIndex))
+      )
+    ),
+    packetSource(),
+    packetDecoder(),
+    fidelity(DecodeFidelity::Standard),
+    codecDelayFrameCount(0),
+    totalFrameCount(0),
+    decodedSamples(),
+    decodedStartFrame(0),
+    isPositionKnown(false),
+    frameCursor(0),
+    packet(),
+    channelSamples(),
+    decodingMutex() {
+
+    const MatroskaTrack &track = segment->AudioTracks[audioTrackIndex];
+
+    this->packetDecoder = TryCreatePacketDecoder(track);
+    if(!this->packetDecoder) {
+      throw Errors::UnsupportedFormatError(
+        u8"Matroska audio track uses a codec this library can't decode"
+      );
+    }
+
+    this->codecDelayFrameCount = GetCodecDelayFrameCount(track, *this->packetDecoder);
+    this->totalFrameCount = CountFrames(file, segment, track, *this->packetDecoder);
+
+    this->file = Shared::DecoderStatisticsCollector::CountReads(this->statistics, file);
+    this->packetSource = std::make_unique<MatroskaPacketSource>(
+      this->file, segment, track.Number
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MatroskaTrackDecoder::MatroskaTrackDecoder(const MatroskaTrackDecoder &other) :
+    file(),
+    segment(other.segment),
+    audioTrackIndex(other.audioTrackIndex),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(
+        other.statistics->GetCodec(), other.statistics->IsEnabled()
+      )
+    ),
+    packetSource(),
+    packetDecoder(TryCreatePacketDecoder(other.segment->AudioTracks[other.audioTrackIndex])),
+    fidelity(other.fidelity),
+    codecDelayFrameCount(other.codecDelayFrameCount),
+    totalFrameCount(other.totalFrameCount),
+    decodedSamples(),
+    decodedStartFrame(0),
+    isPositionKnown(false),
+    frameCursor(0),
+    packet(),
+    channelSamples(),
+    decodingMutex() {
+
+    if(this->fidelity != DecodeFidelity::Standard) {
+      this->packetDecoder->TrySetFidelity(this->fidelity);
+    }
+
+    // Clones get their own packet source and codec state, but keep the segment
+    // headers, including the cue points, shared with the original decoder.
+    std::shared_ptr<const VirtualFile> unwrappedFile;
+    {
+      std::lock_guard<std::mutex> otherDecodingMutexScope(other.decodingMutex);
+      unwrappedFile = other.file;
+    }
+    this->file = Shared::DecoderStatisticsCollector::CountReads(this->statistics, unwrappedFile);
+    this->packetSource = std::make_unique<MatroskaPacketSource>(
+      this->file, this->segment, this->segment->AudioTracks[this->audioTrackIndex].Number
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Shared::PacketDecoder> MatroskaTrackDecoder::TryCreatePacketDecoder(
+    const MatroskaTrack &track
+  ) {
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    if(track.CodecId == u8"A_OPUS") {
+      AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+      return std::make_unique<Opus::OpusPacketDecoder>(
+        track.CodecPrivate.data(), track.CodecPrivate.size()
+      );
+    }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    if(track.CodecId == u8"A_VORBIS") {
+      AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+      return std::make_unique<Vorbis::VorbisPacketDecoder>(
+        track.CodecPrivate.data(), track.CodecPrivate.size()
+      );
+    }
+#endif
+
+    return std::unique_ptr<Shared::PacketDecoder>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MatroskaTrackDecoder::GetCodecDelayFrameCount(
+    const MatroskaTrack &track, const Shared::PacketDecoder &packetDecoder
+  ) {
+    if(track.CodecDelay > 0) {
+      return static_cast<std::size_t>(
+        nanosecondsToFrames(
+          static_cast<std::int64_t>(track.CodecDelay), packetDecoder.GetSampleRate()
+        )
+      );
+    }
+
+    // Older muxers didn't write the codec delay, but the Opus header still has it
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    const Opus::OpusPacketDecoder *opusDecoder = (
+      dynamic_cast<const Opus::OpusPacketDecoder *>(&packetDecoder)
+    );
+    if(opusDecoder != nullptr) {
+      return opusDecoder->GetPreSkip();
+    }
+#endif
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t MatroskaTrackDecoder::CountFrames(
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::shared_ptr<const MatroskaSegment> &segment,
+    const MatroskaTrack &track,
+    const Shared::PacketDecoder &packetDecoder
+  ) {
+    std::size_t sampleRate = packetDecoder.GetSampleRate();
+    std::int64_t codecDelayFrameCount = static_cast<std::int64_t>(
+      GetCodecDelayFrameCount(track, packetDecoder)
+    );
+
+    // The duration covers the block timestamps, which still include the codec delay
+    std::int64_t endFrame;
+    if(segment->Duration.has_value()) {
+      endFrame = nanosecondsToFrames(segment->Duration.value(), sampleRate);
+    } else {
+
+      // Without a duration, walk the track's blocks. The last packet is assumed
+      // to be as long as the one before it, which is exact for constant frame sizes
+      // and at worst adds a few milliseconds of silence at the end otherwise.
+      MatroskaPacketSource scanner(file, segment, track.Number);
+      std::vector<std::byte> packet;
+      std::int64_t timestamp;
+      std::int64_t lastTimestamp = 0, packetDuration = 0;
+      bool hasPackets = false;
+      while(scanner.ReadPacket(packet, timestamp)) {
+        if(hasPackets && (timestamp > lastTimestamp)) {
+          packetDuration = timestamp - lastTimestamp;
+        }
+        lastTimestamp = timestamp;
+        hasPackets = true;
+      }
+      if(!hasPackets) {
+        return 0;
+      }
+
+      endFrame = nanosecondsToFrames(lastTimestamp + packetDuration, sampleRate);
+    }
+
+    if(endFrame <= codecDelayFrameCount) {
+      return 0;
+    } else {
+      return static_cast<std::uint64_t>(endFrame - codecDelayFrameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> MatroskaTrackDecoder::Clone() const {
+    return std::shared_ptr<AudioTrackDecoder>(new MatroskaTrackDecoder(*this));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MatroskaTrackDecoder::CountChannels() const {
+    return this->packetDecoder->CountChannels();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &MatroskaTrackDecoder::GetChannelOrder() const {
+    return this->packetDecoder->GetChannelOrder();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MatroskaTrackDecoder::TrySetDecodeFidelity(DecodeFidelity fidelity) {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    if(!this->packetDecoder->TrySetFidelity(fidelity)) {
+      return false;
+    }
+
+    this->fidelity = fidelity;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t MatroskaTrackDecoder::CountFrames() const {
+    return this->totalFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioSampleFormat MatroskaTrackDecoder::GetNativeSampleFormat() const {
+    return AudioSampleFormat::Float_32;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MatroskaTrackDecoder::IsNativelyInterleaved() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics MatroskaTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram MatroskaTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void MatroskaTrackDecoder::decodeInterleaved(
+    TSample *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+
+    {
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Matroska", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
+
+      if(this->frameCursor != startFrame) {
+        seekTo(startFrame);
+      }
+
+      std::size_t channelCount = this->packetDecoder->CountChannels();
+      std::size_t remainingFrameCount = frameCount;
+      while(0 < remainingFrameCount) {
+        std::size_t availableFrameCount = fillBuffer();
+
+        // The container may promise a few frames more than the codec delivers,
+        // the missing frames at the end of the track are filled with silence
+        if(availableFrameCount == 0) {
+          this->channelSamples.assign(remainingFrameCount * channelCount, 0.0f);
+          Shared::ClampingSampleConverter::Convert(
+            this->channelSamples.data(), buffer, 1, remainingFrameCount * channelCount
+          );
+          this->frameCursor += remainingFrameCount;
+          break;
+        }
+
+        std::size_t chunkFrameCount = std::min(availableFrameCount, remainingFrameCount);
+        std::size_t offset = static_cast<std::size_t>(
+          static_cast<std::int64_t>(this->frameCursor) - this->decodedStartFrame
+        );
+        Shared::ClampingSampleConverter::Convert(
+          this->decodedSamples.data() + offset * channelCount,
+          buffer, 1, chunkFrameCount * channelCount
+        );
+
+        buffer += chunkFrameCount * channelCount;
+        this->frameCursor += chunkFrameCount;
+        remainingFrameCount -= chunkFrameCount;
+      }
+    } // mutex lock scope
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void MatroskaTrackDecoder::decodeSeparated(
+    TSample *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+
+    {
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Matroska", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
+
+      if(this->frameCursor != startFrame) {
+        seekTo(startFrame);
+      }
+
+      std::size_t channelCount = this->packetDecoder->CountChannels();
+      std::size_t writtenFrameCount = 0;
+      while(writtenFrameCount < frameCount) {
+        std::size_t availableFrameCount = fillBuffer();
+        std::size_t remainingFrameCount = frameCount - writtenFrameCount;
+
+        if(availableFrameCount == 0) {
+          this->channelSamples.assign(remainingFrameCount, 0.0f);
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            Shared::ClampingSampleConverter::Convert(
+              this->channelSamples.data(), buffers[channelIndex] + writtenFrameCount,
+              1, remainingFrameCount
+            );
+          }
+          this->frameCursor += remainingFrameCount;
+          break;
+        }
+
+        // The codec delivers interleaved samples, gather each channel before converting
+        std::size_t chunkFrameCount = std::min(availableFrameCount, remainingFrameCount);
+        std::size_t offset = static_cast<std::size_t>(
+          static_cast<std::int64_t>(this->frameCursor) - this->decodedStartFrame
+        );
+        this->channelSamples.resize(chunkFrameCount);
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          const float *source = this->decodedSamples.data() + offset * channelCount + channelIndex;
+          for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+            this->channelSamples[frameIndex] = source[frameIndex * channelCount];
+          }
+          Shared::ClampingSampleConverter::Convert(
+            this->channelSamples.data(), buffers[channelIndex] + writtenFrameCount,
+            1, chunkFrameCount
+          );
+        }
+
+        this->frameCursor += chunkFrameCount;
+        writtenFrameCount += chunkFrameCount;
+      }
+    } // mutex lock scope
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MatroskaTrackDecoder::fillBuffer() const {
+    std::size_t channelCount = this->packetDecoder->CountChannels();
+    std::int64_t cursor = static_cast<std::int64_t>(this->frameCursor);
+
+    for(;;) {
+      std::int64_t decodedFrameCount = static_cast<std::int64_t>(
+        this->decodedSamples.size() / channelCount
+      );
+
+      if(this->isPositionKnown) {
+        std::int64_t decodedEndFrame = this->decodedStartFrame + decodedFrameCount;
+
+        // If the cue point led to a packet after the target, the frames in between
+        // can't be recovered. Deliver from where decoding resumed instead.
+        if((cursor < this->decodedStartFrame) && (decodedFrameCount > 0)) {
+          this->decodedStartFrame = cursor;
+          return static_cast<std::size_t>(decodedFrameCount);
+        }
+        if((cursor >= this->decodedStartFrame) && (cursor < decodedEndFrame)) {
+          return static_cast<std::size_t>(decodedEndFrame - cursor);
+        }
+
+        this->decodedStartFrame = decodedEndFrame;
+      }
+
+      std::int64_t timestamp;
+      if(!this->packetSource->ReadPacket(this->packet, timestamp)) {
+        this->decodedSamples.clear();
+        return 0;
+      }
+
+      this->decodedSamples.clear();
+      std::size_t producedFrameCount = this->packetDecoder->DecodePacket(
+        this->packet.data(), this->packet.size(), this->decodedSamples
+      );
+
+      // After a seek, the first packet producing output anchors the frame positions,
+      // from then on frames are counted so sequential decoding stays sample-exact
+      if(!this->isPositionKnown && (producedFrameCount > 0)) {
+        this->decodedStartFrame = (
+          nanosecondsToFrames(timestamp, this->packetDecoder->GetSampleRate()) -
+          static_cast<std::int64_t>(this->codecDelayFrameCount)
+        );
+        this->isPositionKnown = true;
+      }
+    } // for(;;)
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::seekTo(std::uint64_t startFrame) const {
+    const MatroskaTrack &track = this->segment->AudioTracks[this->audioTrackIndex];
+    this->statistics->AddSeek();
+
+    // Aim a pre-roll ahead of the target so the codec has settled when it's reached
+    std::int64_t preRoll = std::max<std::int64_t>(
+      static_cast<std::int64_t>(track.SeekPreRoll), MinimumSeekPreRoll
+    );
+    std::int64_t targetTimestamp = framesToNanoseconds(
+      startFrame + this->codecDelayFrameCount, this->packetDecoder->GetSampleRate()
+    ) - preRoll;
+
+    this->packetSource->Seek(std::max<std::int64_t>(targetTimestamp, 0));
+    this->packetDecoder->Reset();
+
+    this->decodedSamples.clear();
+    this->isPositionKnown = false;
+    this->frameCursor = startFrame;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MatroskaTrackDecoder::verifyDecodeRange(
+    const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
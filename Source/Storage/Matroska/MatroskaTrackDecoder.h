@@ -0,0 +1,305 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKATRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKATRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "./MatroskaReader.h"
+#include "./MatroskaPacketSource.h"
+#include "../Shared/PacketDecoder.h"
+#include "../Shared/DecoderStatisticsCollector.h"
+
+#include <mutex> // for std::mutex
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes Opus or Vorbis audio tracks stored in Matroska files</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The track's packets are pulled out of the clusters by a packet source and
+  ///     handed to a packet decoder for the track's codec, so no Ogg stream has to
+  ///     be remuxed and no intermediate file is written.
+  ///   </para>
+  ///   <para>
+  ///     Decoding front to back is sample-exact. Seeks jump to the closest cue point,
+  ///     decode the codec's pre-roll and then locate the target frame using the block
+  ///     timestamps, so their accuracy is limited by the segment's timestamp scale,
+  ///     one millisecond by default.
+  ///   </para>
+  /// </remarks>
+  class MatroskaTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new Matroska track decoder for an audio track</summary>
+    /// <param name="file">File that holds the Matroska segment</param>
+    /// <param name="segment">Segment headers previously read from the file</param>
+    /// <param name="audioTrackIndex">Index of the track in the segment's audio tracks</param>
+    public: MatroskaTrackDecoder(
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::shared_ptr<const MatroskaSegment> &segment,
+      std::size_t audioTrackIndex
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~MatroskaTrackDecoder() override = default;
+
+    /// <summary>Creates a packet decoder for a Matroska audio track</summary>
+    /// <param name="track">Track for which a packet decoder will be created</param>
+    /// <returns>The new packet decoder or an empty pointer if the codec is unsupported</returns>
+    public: static std::unique_ptr<Shared::PacketDecoder> TryCreatePacketDecoder(
+      const MatroskaTrack &track
+    );
+
+    /// <summary>Calculates how many frames of codec delay precede the audio</summary>
+    /// <param name="track">Track whose codec delay will be calculated</param>
+    /// <param name="packetDecoder">Packet decoder set up for the track</param>
+    /// <returns>The number of frames of codec delay</returns>
+    public: static std::size_t GetCodecDelayFrameCount(
+      const MatroskaTrack &track, const Shared::PacketDecoder &packetDecoder
+    );
+
+    /// <summary>Calculates the number of frames in a Matroska audio track</summary>
+    /// <param name="file">File that holds the Matroska segment</param>
+    /// <param name="segment">Segment headers previously read from the file</param>
+    /// <param name="track">Track whose frames will be counted</param>
+    /// <param name="packetDecoder">Packet decoder set up for the track</param>
+    /// <returns>The number of frames in the track after the codec delay</returns>
+    /// <remarks>
+    ///   Uses the segment's duration if present. Live recordings often lack it,
+    ///   in which case the track's block timestamps are scanned instead.
+    /// </remarks>
+    public: static std::uint64_t CountFrames(
+      const std::shared_ptr<const VirtualFile> &file,
+      const std::shared_ptr<const MatroskaSegment> &segment,
+      const MatroskaTrack &track,
+      const Shared::PacketDecoder &packetDecoder
+    );
+
+    /// <summary>Initializes a new track decoder as a clone of another</summary>
+    /// <param name="other">Track decoder that will be cloned</param>
+    private: MatroskaTrackDecoder(const MatroskaTrackDecoder &other);
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override;
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
+
+    /// <summary>Attempts to trade decoding fidelity against CPU time</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <returns>True if the codec will decode with the requested fidelity</returns>
+    public: bool TrySetDecodeFidelity(DecodeFidelity fidelity) override;
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio track is long</returns>
+    public: std::uint64_t CountFrames() const override;
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override;
+
+    /// <summary>Checks whether the codec natively uses interleaved samples</summary>
+    /// <returns>True if the codec natively uses interleaved samples</returns>
+    public: bool IsNativelyInterleaved() const override;
+
+    /// <summary>Enables or disables the recording of decoder statistics</summary>
+    /// <param name="enable">True to start recording statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override;
+
+    /// <summary>Retrieves the statistics recorded so far</summary>
+    /// <returns>The statistics recorded since statistics were enabled</returns>
+    public: DecoderStatistics GetStatistics() const override;
+
+    /// <summary>Retrieves the distribution of decoding call durations</summary>
+    /// <param name="reset">Whether to clear the histogram after retrieving it</param>
+    /// <returns>The histogram of decoding call durations</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override;
+
+    // The public variant of the DecoeInterleaved() method delegates to our implementations
+    public: using AudioTrackDecoder::DecodeInterleaved;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames and delivers them interleaved</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes audio frames and delivers them in separate channels</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>Makes sure decoded frames are available at the frame cursor</summary>
+    /// <returns>The number of decoded frames available, 0 past the end of the track</returns>
+    private: std::size_t fillBuffer() const;
+
+    /// <summary>Moves the frame cursor to the specified frame</summary>
+    /// <param name="startFrame">Frame that should be delivered next</param>
+    private: void seekTo(std::uint64_t startFrame) const;
+
+    /// <summary>Throws an exception if the decoding range is out of bounds</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: void verifyDecodeRange(
+      const std::uint64_t startFrame, const std::size_t frameCount
+    ) const;
+
+    /// <summary>File the audio track is being decoded from</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Segment headers, shared with all clones of the decoder</summary>
+    private: std::shared_ptr<const MatroskaSegment> segment;
+    /// <summary>Index of the decoded track in the segment's audio tracks</summary>
+    private: std::size_t audioTrackIndex;
+    /// <summary>Counts frames, seeks, bytes read and decoding time if enabled</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
+    /// <summary>Delivers the compressed packets of the track</summary>
+    private: std::unique_ptr<MatroskaPacketSource> packetSource;
+    /// <summary>Decodes the compressed packets into float samples</summary>
+    private: std::unique_ptr<Shared::PacketDecoder> packetDecoder;
+    /// <summary>Fidelity the packet decoder was set to, clones inherit it</summary>
+    private: DecodeFidelity fidelity;
+    /// <summary>Number of frames of codec delay preceding the audio</summary>
+    private: std::size_t codecDelayFrameCount;
+    /// <summary>Total number of frames in the track after the codec delay</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Interleaved samples of the most recently decoded packet</summary>
+    private: mutable std::vector<float> decodedSamples;
+    /// <summary>Track frame index of the first frame in the decoded samples</summary>
+    private: mutable std::int64_t decodedStartFrame;
+    /// <summary>Whether the decoded frame positions are known since the last seek</summary>
+    private: mutable bool isPositionKnown;
+    /// <summary>Index of the frame that will be delivered next</summary>
+    private: mutable std::uint64_t frameCursor;
+    /// <summary>Buffer packets are read into before they're decoded</summary>
+    private: mutable std::vector<std::byte> packet;
+    /// <summary>Buffer the samples of a single channel are gathered in</summary>
+    private: mutable std::vector<float> channelSamples;
+    /// <summary>Must be held while decoding</summary>
+    private: mutable std::mutex decodingMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS) || defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_STORAGE_MATROSKA_MATROSKATRACKDECODER_H
@@ -0,0 +1,67 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "MemoryFile.h"
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range, std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MemoryFile::MemoryFile(
+    const std::shared_ptr<const std::byte[]> &memory, std::size_t length
+  ) :
+    memory(memory),
+    length(length) {
+    if(!memory && (length > 0)) {
+      throw std::invalid_argument(u8"Memory buffer must not be null");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+    }
+
+    std::copy_n(this->memory.get() + start, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Memory files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
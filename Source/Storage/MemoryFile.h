@@ -0,0 +1,96 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_MEMORYFILE_H
+#define NUCLEX_AUDIO_STORAGE_MEMORYFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides read-only access to an immutable buffer in memory</summary>
+  /// <remarks>
+  ///   The file shares ownership of the buffer, so many decoders can read the same
+  ///   preloaded sound bank without it being copied. Since all data is already in memory,
+  ///   reads never allocate and decoders can borrow the buffer directly.
+  /// </remarks>
+  class MemoryFile : public VirtualFile {
+
+    /// <summary>Initializes a new memory file serving the specified buffer</summary>
+    /// <param name="memory">Buffer holding the file's contents</param>
+    /// <param name="length">Length of the buffer in bytes</param>
+    public: MemoryFile(const std::shared_ptr<const std::byte[]> &memory, std::size_t length);
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~MemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Provides direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer into the buffer at the requested offset or a null pointer if
+    ///   the requested range exceeds the file's size
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+        return nullptr;
+      }
+      return this->memory.get() + start;
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Memory files serve immutable buffers, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Buffer holding the file's contents</summary>
+    private: std::shared_ptr<const std::byte[]> memory;
+    /// <summary>Length of the buffer in bytes</summary>
+    private: std::size_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_MEMORYFILE_H
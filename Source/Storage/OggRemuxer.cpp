@@ -0,0 +1,716 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/OggRemuxer.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./Shared/OggPacketReader.h"
+#include "./Shared/OggPageWriter.h"
+#include "./Shared/OggPageVerifier.h"
+#include "./EndianReader.h"
+
+#include <algorithm> // for std::min(), std::max(), std::find_if()
+#include <cstring> // for std::memcmp()
+#include <deque> // for std::deque
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range
+#include <utility> // for std::pair
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Size of an Ogg page header with the largest possible segment table</summary>
+  const std::size_t MaximumPageHeaderSize = PageHeaderSize + 255;
+
+  /// <summary>Header type flag indicating the first page of a logical stream</summary>
+  const std::uint8_t BeginningOfStreamFlag = 0x02;
+
+  /// <summary>Number of samples an Opus decoder needs to converge after a cut</summary>
+  /// <remarks>
+  ///   The Ogg Opus specification (RFC 7845, section 4.6) recommends decoding at least
+  ///   80 ms of audio before the point that is to be played back.
+  /// </remarks>
+  const std::int64_t OpusPreRollSampleCount = 3840;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Codecs whose Ogg streams can be cut</summary>
+  enum class OggCodec {
+    /// <summary>Opus audio as described in RFC 7845</summary>
+    Opus,
+    /// <summary>Vorbis I audio</summary>
+    Vorbis
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio packet along with its position in the stream</summary>
+  struct TimedPacket {
+
+    /// <summary>Bytes of the packet as they were stored in the Ogg pages</summary>
+    public: std::vector<std::byte> Data;
+    /// <summary>Granule position at which the packet's decoded samples begin</summary>
+    public: std::int64_t Start;
+    /// <summary>Granule position at which the packet's decoded samples end</summary>
+    public: std::int64_t End;
+    /// <summary>Granule position at which the source stream ends the packet</summary>
+    /// <remarks>
+    ///   Differs from the end only for the last packet if the encoder trimmed it.
+    /// </remarks>
+    public: std::int64_t SourceEnd;
+    /// <summary>Whether this is the last packet of the source stream</summary>
+    public: bool IsLast;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads bits backwards from the end of a Vorbis packet</summary>
+  /// <remarks>
+  ///   Vorbis packs its bits starting at the least significant bit of each byte. Reading
+  ///   backwards therefore starts at the most significant bit of the last byte.
+  /// </remarks>
+  class BackwardBitReader {
+
+    /// <summary>Initializes a new bit reader at the end of the specified packet</summary>
+    /// <param name="data">Packet from which bits will be read</param>
+    public: BackwardBitReader(const std::vector<std::byte> &data) :
+      data(data),
+      position(data.size() * 8) {}
+
+    /// <summary>Returns the number of bits left in front of the read position</summary>
+    /// <returns>The number of bits that can still be read</returns>
+    public: std::size_t CountRemainingBits() const { return this->position; }
+
+    /// <summary>Reads a single bit</summary>
+    /// <returns>The bit that has been read</returns>
+    public: bool ReadBit() {
+      --this->position;
+      std::uint8_t byte = static_cast<std::uint8_t>(this->data[this->position / 8]);
+      return ((byte >> (this->position % 8)) & 1) != 0;
+    }
+
+    /// <summary>Reads a value stored in the specified number of bits</summary>
+    /// <param name="bitCount">Number of bits the value occupies</param>
+    /// <returns>The value that has been read</returns>
+    public: std::uint32_t ReadBits(std::size_t bitCount) {
+      std::uint32_t value = 0;
+      for(std::size_t index = 0; index < bitCount; ++index) {
+        value = (value << 1) | (ReadBit() ? 1 : 0);
+      }
+      return value;
+    }
+
+    /// <summary>Packet from which bits are being read</summary>
+    private: const std::vector<std::byte> &data;
+    /// <summary>Index of the bit that was read last</summary>
+    private: std::size_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Block sizes and modes of a Vorbis stream</summary>
+  struct VorbisModes {
+
+    /// <summary>Number of samples in a short block</summary>
+    public: std::int64_t ShortBlockSize;
+    /// <summary>Number of samples in a long block</summary>
+    public: std::int64_t LongBlockSize;
+    /// <summary>Whether each mode uses long blocks</summary>
+    public: std::vector<bool> LongBlockFlags;
+    /// <summary>Number of bits in which audio packets store their mode number</summary>
+    public: std::size_t ModeBitCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the block sizes and modes from the headers of a Vorbis stream</summary>
+  /// <param name="identification">Identification header of the Vorbis stream</param>
+  /// <param name="setup">Setup header of the Vorbis stream</param>
+  /// <returns>The block sizes and modes used by the Vorbis stream</returns>
+  /// <remarks>
+  ///   The modes are the last thing in the setup header, but decoding everything in front
+  ///   of them would mean implementing half of a Vorbis decoder. Since each mode is
+  ///   41 bits with a fixed pattern of zeros and the mode count precedes them, they can
+  ///   be found by scanning backwards from the framing bit, which is what other
+  ///   demuxers (such as FFmpeg's) do as well.
+  /// </remarks>
+  VorbisModes parseVorbisModes(
+    const std::vector<std::byte> &identification, const std::vector<std::byte> &setup
+  ) {
+    using Nuclex::Audio::Errors::CorruptedFileError;
+
+    if(identification.size() < 30) {
+      throw CorruptedFileError(u8"Vorbis identification header is truncated");
+    }
+
+    VorbisModes modes;
+    std::uint8_t blockSizes = static_cast<std::uint8_t>(identification[28]);
+    modes.ShortBlockSize = std::int64_t(1) << (blockSizes & 0x0F);
+    modes.LongBlockSize = std::int64_t(1) << (blockSizes >> 4);
+
+    // Skip any padding behind the framing bit, which is the last bit set in the packet
+    BackwardBitReader reader(setup);
+    for(;;) {
+      if(reader.CountRemainingBits() < 97) {
+        throw CorruptedFileError(u8"Vorbis setup header has no framing bit");
+      }
+      if(reader.ReadBit()) {
+        break;
+      }
+    }
+    std::size_t modesEnd = reader.CountRemainingBits();
+
+    // Walk backwards over anything that looks like a mode. Each time the six bits
+    // in front of the modes seen so far match their count, that's a candidate for
+    // the mode count. The last match wins since it covers the most modes.
+    std::size_t modeCount = 0;
+    std::size_t candidateModeCount = 0;
+    while(reader.CountRemainingBits() >= 97) {
+      std::uint32_t mapping = reader.ReadBits(8);
+      std::uint32_t transformType = reader.ReadBits(16);
+      std::uint32_t windowType = reader.ReadBits(16);
+      if((mapping > 63) || (transformType != 0) || (windowType != 0)) {
+        break;
+      }
+      reader.ReadBit(); // block flag
+
+      ++modeCount;
+      if(modeCount > 64) {
+        break;
+      }
+
+      BackwardBitReader countReader = reader;
+      if(countReader.ReadBits(6) + 1 == modeCount) {
+        candidateModeCount = modeCount;
+      }
+    }
+    if(candidateModeCount == 0) {
+      throw CorruptedFileError(u8"Could not locate the modes in the Vorbis setup header");
+    }
+
+    // Now that the number of modes is known, read their block flags
+    BackwardBitReader flagReader(setup);
+    while(flagReader.CountRemainingBits() > modesEnd) {
+      flagReader.ReadBit();
+    }
+    modes.LongBlockFlags.resize(candidateModeCount);
+    for(std::size_t index = candidateModeCount; index > 0; --index) {
+      flagReader.ReadBits(40);
+      modes.LongBlockFlags[index - 1] = flagReader.ReadBit();
+    }
+
+    modes.ModeBitCount = 0;
+    while((std::size_t(1) << modes.ModeBitCount) < candidateModeCount) {
+      ++modes.ModeBitCount;
+    }
+
+    return modes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the block size of a Vorbis audio packet</summary>
+  /// <param name="modes">Block sizes and modes of the Vorbis stream</param>
+  /// <param name="packet">Audio packet whose block size will be determined</param>
+  /// <returns>The block size of the packet or 0 if it produces no audio</returns>
+  std::int64_t getVorbisBlockSize(const VorbisModes &modes, const std::vector<std::byte> &packet) {
+    if(packet.empty()) {
+      return 0;
+    }
+
+    std::uint8_t firstByte = static_cast<std::uint8_t>(packet[0]);
+    if((firstByte & 1) != 0) {
+      return 0; // Not an audio packet
+    }
+
+    std::size_t mode = (firstByte >> 1) & ((1U << modes.ModeBitCount) - 1);
+    if(mode >= modes.LongBlockFlags.size()) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(
+        u8"Vorbis audio packet refers to a mode that doesn't exist"
+      );
+    }
+
+    return modes.LongBlockFlags[mode] ? modes.LongBlockSize : modes.ShortBlockSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the number of samples an Opus packet decodes to</summary>
+  /// <param name="packet">Opus packet whose duration will be determined</param>
+  /// <returns>The number of samples at 48 kHz the packet decodes to</returns>
+  /// <remarks>
+  ///   The TOC byte at the start of each packet (RFC 6716, section 3.1) tells the frame
+  ///   duration and how many frames the packet holds. In multistream packets, all
+  ///   streams have the same duration, so the first stream's TOC byte suffices.
+  /// </remarks>
+  std::int64_t countOpusPacketSamples(const std::vector<std::byte> &packet) {
+    if(packet.empty()) {
+      return 0;
+    }
+
+    std::uint8_t toc = static_cast<std::uint8_t>(packet[0]);
+    std::uint8_t configuration = toc >> 3;
+
+    std::int64_t frameSampleCount;
+    if(configuration < 12) { // SILK-only, 10, 20, 40 or 60 ms
+      static const std::int64_t silkFrameSizes[] = { 480, 960, 1920, 2880 };
+      frameSampleCount = silkFrameSizes[configuration & 3];
+    } else if(configuration < 16) { // Hybrid, 10 or 20 ms
+      frameSampleCount = (configuration & 1) ? 960 : 480;
+    } else { // CELT-only, 2.5, 5, 10 or 20 ms
+      frameSampleCount = std::int64_t(120) << (configuration & 3);
+    }
+
+    std::int64_t frameCount;
+    switch(toc & 3) {
+      case 0: { frameCount = 1; break; }
+      case 1:
+      case 2: { frameCount = 2; break; }
+      default: {
+        if(packet.size() < 2) {
+          throw Nuclex::Audio::Errors::CorruptedFileError(
+            u8"Opus packet is missing its frame count"
+          );
+        }
+        frameCount = static_cast<std::uint8_t>(packet[1]) & 0x3F;
+        break;
+      }
+    }
+
+    return frameSampleCount * frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tracks the positions of audio packets in an Ogg Opus or Vorbis stream</summary>
+  class PacketTimeline {
+
+    /// <summary>Initializes a new packet timeline for the specified codec</summary>
+    /// <param name="codec">Codec whose packets will be timed</param>
+    /// <param name="headers">Header packets of the stream</param>
+    public: PacketTimeline(OggCodec codec, const std::vector<std::vector<std::byte>> &headers) :
+      codec(codec),
+      modes(),
+      previousBlockSize(0) {
+      if(codec == OggCodec::Vorbis) {
+        this->modes = parseVorbisModes(headers[0], headers[2]);
+      }
+    }
+
+    /// <summary>Determines how many samples the next audio packet decodes to</summary>
+    /// <param name="packet">Next audio packet in the stream</param>
+    /// <returns>The number of samples the decoder will output for the packet</returns>
+    public: std::int64_t CountSamples(const std::vector<std::byte> &packet) {
+      if(this->codec == OggCodec::Opus) {
+        return countOpusPacketSamples(packet);
+      }
+
+      // Vorbis outputs the overlapping halves of two consecutive blocks, so the very
+      // first block only primes the decoder and produces nothing
+      std::int64_t blockSize = getVorbisBlockSize(this->modes, packet);
+      if(blockSize == 0) {
+        return 0;
+      }
+
+      std::int64_t sampleCount = 0;
+      if(this->previousBlockSize != 0) {
+        sampleCount = this->previousBlockSize / 4 + blockSize / 4;
+      }
+      this->previousBlockSize = blockSize;
+      return sampleCount;
+    }
+
+    /// <summary>Codec whose packets are being timed</summary>
+    private: OggCodec codec;
+    /// <summary>Block sizes and modes if the codec is Vorbis</summary>
+    private: VorbisModes modes;
+    /// <summary>Block size of the previous Vorbis packet</summary>
+    private: std::int64_t previousBlockSize;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies the codec of an Ogg stream by its first packet</summary>
+  /// <param name="firstPacket">First packet of the logical stream</param>
+  /// <returns>The codec the logical stream uses</returns>
+  OggCodec identifyCodec(const std::vector<std::byte> &firstPacket) {
+    if(firstPacket.size() >= 19) {
+      if(std::memcmp(firstPacket.data(), "OpusHead", 8) == 0) {
+        return OggCodec::Opus;
+      }
+    }
+    if(firstPacket.size() >= 7) {
+      if(std::memcmp(firstPacket.data(), "\x01vorbis", 7) == 0) {
+        return OggCodec::Vorbis;
+      }
+    }
+
+    throw Nuclex::Audio::Errors::UnsupportedFormatError(
+      u8"Only Ogg Opus and Ogg Vorbis streams can be trimmed without re-encoding"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OggRemuxer::Trim(
+    const std::shared_ptr<const VirtualFile> &source,
+    std::uint64_t startFrame, std::uint64_t frameCount,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    Shared::OggPacketReader reader(*source);
+    Shared::OggPacketReader::Packet packet;
+
+    // Collect the header packets, Opus has two of them, Vorbis three
+    if(!reader.ReadPacket(packet)) {
+      throw Errors::CorruptedFileError(u8"Ogg stream contains no packets");
+    }
+    OggCodec codec = identifyCodec(packet.Data);
+    std::size_t headerCount = (codec == OggCodec::Opus) ? 2 : 3;
+
+    std::vector<std::vector<std::byte>> headers;
+    headers.push_back(std::move(packet.Data));
+    while(headers.size() < headerCount) {
+      if(!reader.ReadPacket(packet)) {
+        throw Errors::CorruptedFileError(u8"Ogg stream ends in the middle of its headers");
+      }
+      headers.push_back(std::move(packet.Data));
+    }
+
+    std::int64_t preSkip = 0;
+    if(codec == OggCodec::Opus) {
+      preSkip = LittleEndianReader::ReadUInt16(headers[0].data() + 10);
+    }
+
+    PacketTimeline timeline(codec, headers);
+
+    // The granule position of the first audio page tells where the stream begins.
+    // Since it is stored at the end of the page, all packets on the page need to be
+    // read before the positions of the packets can be determined.
+    std::deque<TimedPacket> packets;
+    std::int64_t firstPageSampleCount = 0;
+    std::int64_t firstPageGranulePosition = Shared::OggPacketReader::NoGranulePosition;
+    for(;;) {
+      if(!reader.ReadPacket(packet)) {
+        break;
+      }
+
+      std::int64_t sampleCount = timeline.CountSamples(packet.Data);
+      firstPageSampleCount += sampleCount;
+      packets.push_back(TimedPacket { std::move(packet.Data), 0, sampleCount, 0, packet.IsLast });
+      if(packet.GranulePosition != Shared::OggPacketReader::NoGranulePosition) {
+        firstPageGranulePosition = packet.GranulePosition;
+        break;
+      }
+    }
+    if(packets.empty()) {
+      throw std::out_of_range(u8"Start frame lies beyond the end of the audio stream");
+    }
+
+    // A first page whose granule position is lower than the number of samples on it
+    // has samples trimmed from its beginning, unless it is also the last page, in which
+    // case the end is trimmed (Vorbis I specification, section A.2)
+    std::int64_t streamStart = 0;
+    if(firstPageGranulePosition != Shared::OggPacketReader::NoGranulePosition) {
+      streamStart = firstPageGranulePosition - firstPageSampleCount;
+      if(packets.back().IsLast && (streamStart < 0)) {
+        streamStart = 0;
+      }
+    }
+
+    {
+      std::int64_t position = streamStart;
+      for(TimedPacket &timedPacket : packets) {
+        timedPacket.Start = position;
+        position += timedPacket.End; // still holds the packet's sample count
+        timedPacket.End = position;
+        timedPacket.SourceEnd = position;
+      }
+      if(packets.back().IsLast && (firstPageGranulePosition >= 0)) {
+        packets.back().SourceEnd = std::min(position, firstPageGranulePosition);
+      }
+    }
+
+    // Fetches the next audio packet, first from those already read, then from the file
+    std::int64_t nextStart = packets.back().End;
+    bool isSourceExhausted = packets.back().IsLast;
+    auto fetchPacket = [&](TimedPacket &timedPacket) -> bool {
+      if(!packets.empty()) {
+        timedPacket = std::move(packets.front());
+        packets.pop_front();
+        return true;
+      }
+      if(isSourceExhausted || !reader.ReadPacket(packet)) {
+        isSourceExhausted = true;
+        return false;
+      }
+
+      std::int64_t sampleCount = timeline.CountSamples(packet.Data);
+      timedPacket.Data.swap(packet.Data);
+      timedPacket.Start = nextStart;
+      timedPacket.End = nextStart + sampleCount;
+      timedPacket.SourceEnd = timedPacket.End;
+      timedPacket.IsLast = packet.IsLast;
+      if(packet.IsLast && (packet.GranulePosition >= 0)) {
+        timedPacket.SourceEnd = std::min(timedPacket.End, packet.GranulePosition);
+      }
+      isSourceExhausted = packet.IsLast;
+      nextStart = timedPacket.End;
+      return true;
+    };
+
+    // Convert the requested range into granule positions in the source stream
+    const std::int64_t maximumPosition = std::numeric_limits<std::int64_t>::max() / 2;
+    std::int64_t firstFramePosition = std::max<std::int64_t>(streamStart, 0) + preSkip;
+    if(startFrame >= static_cast<std::uint64_t>(maximumPosition - firstFramePosition)) {
+      throw std::out_of_range(u8"Start frame lies beyond the end of the audio stream");
+    }
+    std::int64_t cutPosition = firstFramePosition + static_cast<std::int64_t>(startFrame);
+    std::int64_t endPosition = maximumPosition;
+    if(frameCount < static_cast<std::uint64_t>(maximumPosition - cutPosition)) {
+      endPosition = cutPosition + static_cast<std::int64_t>(frameCount);
+    }
+
+    // Opus needs to decode some audio in front of the cut to converge, Vorbis only
+    // needs the one packet its first output block overlaps with
+    std::int64_t rollPosition = cutPosition;
+    if(codec == OggCodec::Opus) {
+      rollPosition = std::max(streamStart, cutPosition - OpusPreRollSampleCount);
+    }
+    auto canStartAt = [&](const TimedPacket &timedPacket) -> bool {
+      if(codec == OggCodec::Opus) {
+        return (timedPacket.Start <= rollPosition);
+      } else {
+        return (timedPacket.End <= cutPosition);
+      }
+    };
+
+    // Skip over packets until the one the clip needs to start with is reached and
+    // the packets up to the cut have been collected
+    std::deque<TimedPacket> window;
+    {
+      TimedPacket timedPacket;
+      for(;;) {
+        if(!fetchPacket(timedPacket)) {
+          throw std::out_of_range(u8"Start frame lies beyond the end of the audio stream");
+        }
+        if(canStartAt(timedPacket)) {
+          window.clear();
+        }
+
+        bool reachesCut = (timedPacket.SourceEnd > cutPosition);
+        window.push_back(std::move(timedPacket));
+        if(reachesCut) {
+          break;
+        }
+      }
+    }
+
+    // Opus states the number of samples to discard in its header, Vorbis discards
+    // the samples in front of the cut by the first page's granule position
+    std::int64_t origin = cutPosition;
+    if(codec == OggCodec::Opus) {
+      origin = window.front().Start;
+      std::int64_t newPreSkip = cutPosition - origin;
+      if(newPreSkip > 65535) {
+        throw Errors::UnsupportedFormatError(
+          u8"Pre-skip of the trimmed Opus stream would exceed the maximum"
+        );
+      }
+      headers[0][10] = static_cast<std::byte>(newPreSkip);
+      headers[0][11] = static_cast<std::byte>(newPreSkip >> 8);
+    }
+
+    Shared::OggPageWriter writer(*target, 0, reader.GetSerialNumber());
+
+    // The identification header always gets a page of its own and the audio data
+    // has to begin on a fresh page after the remaining headers
+    writer.WritePacket(headers[0].data(), headers[0].size(), 0);
+    writer.FlushPage();
+    for(std::size_t index = 1; index < headerCount; ++index) {
+      writer.WritePacket(headers[index].data(), headers[index].size(), 0);
+    }
+    writer.FlushPage();
+
+    // Copy the packets, holding each back until it is known whether it is the last
+    // one so that the end-of-stream page can receive the trimmed granule position
+    std::size_t writtenPacketCount = 0;
+    TimedPacket pending = std::move(window.front());
+    window.pop_front();
+    for(;;) {
+      if(pending.IsLast) {
+        break;
+      }
+
+      // Vorbis decoders trim the beginning only if the first page with a granule
+      // position isn't also the last page, so in Vorbis clips, the first page ends
+      // after the second packet and there's at least a third one
+      bool hasEnoughPackets = (codec == OggCodec::Opus) || (writtenPacketCount >= 2);
+      if(hasEnoughPackets && (pending.End >= endPosition)) {
+        break;
+      }
+
+      TimedPacket next;
+      if(!window.empty()) {
+        next = std::move(window.front());
+        window.pop_front();
+      } else if(!fetchPacket(next)) {
+        break;
+      }
+
+      writer.WritePacket(pending.Data.data(), pending.Data.size(), pending.End - origin);
+      ++writtenPacketCount;
+      if((codec == OggCodec::Vorbis) && (writtenPacketCount == 2)) {
+        writer.FlushPage();
+      }
+
+      pending = std::move(next);
+    }
+
+    std::int64_t clipEnd = std::min(endPosition, pending.SourceEnd);
+    writer.WritePacket(pending.Data.data(), pending.Data.size(), clipEnd - origin, true);
+    target->Flush();
+
+    return static_cast<std::uint64_t>(clipEnd - cutPosition);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggRemuxer::Concatenate(
+    const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    std::uint64_t targetOffset = 0;
+
+    // Serial numbers only need to be unique within a link, but players may get confused
+    // if two links use the same one, so each logical stream receives a fresh one
+    std::uint32_t nextSerialNumber = 0;
+    bool hasSerialNumber = false;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> serialNumberMap;
+
+    std::vector<std::byte> page;
+    std::byte header[MaximumPageHeaderSize];
+    for(const std::shared_ptr<const VirtualFile> &source : sources) {
+      std::uint64_t fileSize = source->GetSize();
+      std::uint64_t offset = 0;
+      bool isInBeginningOfStreamGroup = false;
+
+      for(;;) {
+        std::uint64_t remainingByteCount = fileSize - offset;
+        if(remainingByteCount < PageHeaderSize) {
+          break; // End of file or trailing garbage
+        }
+
+        std::size_t headerLength = static_cast<std::size_t>(
+          std::min<std::uint64_t>(remainingByteCount, MaximumPageHeaderSize)
+        );
+        source->ReadAt(offset, headerLength, header);
+        if(std::memcmp(header, "OggS", 4) != 0) {
+          if(offset == 0) {
+            throw Errors::UnsupportedFormatError(u8"File to be joined is not an Ogg stream");
+          }
+          throw Errors::CorruptedFileError(u8"Lost synchronization with the Ogg page structure");
+        }
+
+        std::size_t segmentCount = static_cast<std::size_t>(header[26]);
+        if(PageHeaderSize + segmentCount > headerLength) {
+          break; // Truncated page header
+        }
+
+        std::size_t pageLength = PageHeaderSize + segmentCount;
+        for(std::size_t index = 0; index < segmentCount; ++index) {
+          pageLength += static_cast<std::size_t>(header[PageHeaderSize + index]);
+        }
+        if(pageLength > remainingByteCount) {
+          break; // Truncated page body
+        }
+
+        page.resize(pageLength);
+        source->ReadAt(offset, pageLength, page.data());
+        offset += pageLength;
+
+        // A group of beginning-of-stream pages starts a new link. Its logical streams
+        // receive new serial numbers, which are then used for the rest of the link.
+        std::uint8_t headerType = LittleEndianReader::ReadUInt8(header + 5);
+        std::uint32_t serialNumber = LittleEndianReader::ReadUInt32(header + 14);
+        if((headerType & BeginningOfStreamFlag) != 0) {
+          if(!isInBeginningOfStreamGroup) {
+            serialNumberMap.clear();
+            isInBeginningOfStreamGroup = true;
+          }
+        } else {
+          isInBeginningOfStreamGroup = false;
+        }
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>>::iterator mapping = (
+          std::find_if(
+            serialNumberMap.begin(), serialNumberMap.end(),
+            [serialNumber](const std::pair<std::uint32_t, std::uint32_t> &entry) {
+              return entry.first == serialNumber;
+            }
+          )
+        );
+        if(mapping == serialNumberMap.end()) {
+          if(!hasSerialNumber) {
+            nextSerialNumber = serialNumber; // keep the first stream's serial number
+            hasSerialNumber = true;
+          }
+          serialNumberMap.emplace_back(serialNumber, nextSerialNumber);
+          ++nextSerialNumber;
+          mapping = serialNumberMap.end() - 1;
+        }
+
+        std::uint32_t newSerialNumber = mapping->second;
+        for(std::size_t index = 0; index < 4; ++index) {
+          page[14 + index] = static_cast<std::byte>(newSerialNumber >> (index * 8));
+        }
+        std::uint32_t crc = Shared::OggPageVerifier::CalculatePageCrc(page.data(), pageLength);
+        for(std::size_t index = 0; index < 4; ++index) {
+          page[22 + index] = static_cast<std::byte>(crc >> (index * 8));
+        }
+
+        target->WriteAt(targetOffset, pageLength, page.data());
+        targetOffset += pageLength;
+      }
+    }
+
+    target->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
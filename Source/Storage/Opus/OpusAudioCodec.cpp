@@ -25,18 +25,51 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
 #include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
 #include "./OpusDetection.h"
 #include "./OpusVirtualFileAdapter.h"
 #include "./OpusTrackDecoder.h"
 #include "./OpusReader.h"
 #include "./OpusTrackEncoderBuilder.h"
+#include "../Shared/OggLinkScanner.h"
 #include "../../Platform/OpusApi.h"
 
-#include <stdexcept> // for std::runtime_error
+#include <algorithm> // for std::remove_if()
+#include <stdexcept> // for std::out_of_range
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Exposes the links of a chained Ogg file that hold Opus audio</summary>
+  /// <param name="source">Ogg file whose links will be exposed</param>
+  /// <returns>One file per Opus link, in the order in which they appear in the file</returns>
+  /// <remarks>
+  ///   Links using a different codec are left out, so the track indices reported by
+  ///   the codec's container informations always match the ones its decoders accept.
+  /// </remarks>
+  std::vector<std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile>> openOpusLinks(
+    const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &source
+  ) {
+    using Nuclex::Audio::Storage::VirtualFile;
+    using Nuclex::Audio::Storage::Opus::Detection;
+
+    std::vector<std::shared_ptr<const VirtualFile>> links = (
+      Nuclex::Audio::Storage::Shared::OggLinkScanner::OpenLinks(source)
+    );
+    links.erase(
+      std::remove_if(
+        links.begin(), links.end(),
+        [](const std::shared_ptr<const VirtualFile> &link) {
+          return !Detection::CheckIfOpusHeaderPresentLite(*link);
+        }
+      ),
+      links.end()
+    );
+
+    return links;
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -63,6 +96,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool OpusAudioCodec::IsSignaturePresent(const std::byte *header, std::size_t byteCount) const {
+    return Detection::CheckIfOpusHeaderPresentLite(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> OpusAudioCodec::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &source,
     const std::string &extensionHint /* = std::string() */
@@ -75,16 +114,22 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       return std::optional<ContainerInfo>();
     }
 
-    OpusReader reader(source);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+    std::vector<std::shared_ptr<const VirtualFile>> links = openOpusLinks(source);
 
-    // Opus file is now opened, extract the informations the caller requested.
     ContainerInfo containerInfo;
     containerInfo.DefaultTrackIndex = 0;
 
-    // Standalone .wv files only have a single track, always.
-    TrackInfo &trackInfo = containerInfo.Tracks.emplace_back();
-    reader.ReadMetadata(trackInfo);
-    trackInfo.CodecName = GetName();
+    // Each link of a chained Ogg stream is reported as a track of its own. The links
+    // are complete Ogg streams, so the reader can open them like standalone files.
+    for(const std::shared_ptr<const VirtualFile> &link : links) {
+      OpusReader reader(link);
+
+      AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+      TrackInfo &trackInfo = containerInfo.Tracks.emplace_back();
+      reader.ReadMetadata(trackInfo);
+      trackInfo.CodecName = GetName();
+    }
 
     return containerInfo;
   }
@@ -104,13 +149,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       return std::shared_ptr<AudioTrackDecoder>();
     }
 
-    if(trackIndex != 0) {
-      throw std::runtime_error(
-        u8"Alternate track decoding is not implemented yet, track index must be 0"
-      );
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+    std::vector<std::shared_ptr<const VirtualFile>> links = openOpusLinks(source);
+    if(links.empty()) {
+      return std::shared_ptr<AudioTrackDecoder>();
+    }
+    if(trackIndex >= links.size()) {
+      throw std::out_of_range(u8"Track index is beyond the number of links in the Ogg stream");
     }
 
-    return std::make_shared<OpusTrackDecoder>(source);
+    return std::make_shared<OpusTrackDecoder>(links[trackIndex]);
   }
 
   // ------------------------------------------------------------------------------------------- //
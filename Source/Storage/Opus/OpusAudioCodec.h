@@ -61,6 +61,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <returns>The commonly used file extensions in order of preference</returns>
     public: const std::vector<std::string> &GetFileExtensions() const override;
 
+    /// <summary>Checks whether a file header carries the signature of this file format</summary>
+    /// <param name="header">Bytes from the beginning of the file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if the file header carries this codec's signature</returns>
+    public: bool IsSignaturePresent(
+      const std::byte *header, std::size_t byteCount
+    ) const override;
+
     /// <summary>Tries to read informations for an audio container</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
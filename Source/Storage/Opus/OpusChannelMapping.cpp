@@ -0,0 +1,104 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OpusChannelMapping.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "../Shared/ChannelOrderFactory.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Highest ambisonic order Opus can store (RFC 8486, section 3.1)</summary>
+  const int MaximumAmbisonicOrder = 14;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusChannelMapping::IsAmbisonicChannelCount(std::size_t channelCount) {
+    return (GetAmbisonicOrder(channelCount) >= 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  int OpusChannelMapping::GetAmbisonicOrder(std::size_t channelCount) {
+    for(int order = 0; order <= MaximumAmbisonicOrder; ++order) {
+      std::size_t ambisonicChannelCount = static_cast<std::size_t>((order + 1) * (order + 1));
+      if(channelCount < ambisonicChannelCount) {
+        break;
+      }
+
+      // The sound field may be followed by a stereo pair of non-diegetic channels
+      if((channelCount == ambisonicChannelCount) || (channelCount == ambisonicChannelCount + 2)) {
+        return order;
+      }
+    }
+
+    return -1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  int OpusChannelMapping::SelectMappingFamily(
+    const std::vector<ChannelPlacement> &channelOrder
+  ) {
+    bool hasPlacements = false;
+    for(ChannelPlacement channel : channelOrder) {
+      if(channel != ChannelPlacement::Unknown) {
+        hasPlacements = true;
+        break;
+      }
+    }
+
+    if(hasPlacements) {
+      return (channelOrder.size() < 3) ? 0 : 1; // 0 = mono/stereo, 1 = surround
+    } else if(IsAmbisonicChannelCount(channelOrder.size())) {
+      return 2;
+    } else {
+      return 255;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> OpusChannelMapping::GetChannelOrder(
+    int mappingFamily, std::size_t channelCount
+  ) {
+    if((mappingFamily == 0) || (mappingFamily == 1)) {
+      return Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(mappingFamily, channelCount);
+    } else {
+      return std::vector<ChannelPlacement>(channelCount, ChannelPlacement::Unknown);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -0,0 +1,91 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OPUS_OPUSCHANNELMAPPING_H
+#define NUCLEX_AUDIO_STORAGE_OPUS_OPUSCHANNELMAPPING_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/ChannelPlacement.h"
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Chooses and describes the channel mapping families of Opus streams</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Families 0 and 1 use the Vorbis speaker layouts for up to 8 channels. Family 2
+  ///     carries ambisonics in ACN order with SN3D normalization, optionally followed by
+  ///     a stereo pair for non-diegetic audio, family 3 stores the same ambisonic
+  ///     channels with a demixing matrix and family 255 is a number of discrete channels
+  ///     without any speaker assignment (RFC 7845, section 5.1.1 and RFC 8486).
+  ///   </para>
+  ///   <para>
+  ///     None of the latter families have speaker positions, so the channels are
+  ///     reported as <see cref="ChannelPlacement.Unknown" /> in stream order.
+  ///   </para>
+  /// </remarks>
+  class OpusChannelMapping {
+
+    /// <summary>Checks whether a channel count can be stored as ambisonics</summary>
+    /// <param name="channelCount">Number of channels that will be checked</param>
+    /// <returns>
+    ///   True if the channel count is (n + 1)^2 or (n + 1)^2 + 2 for an ambisonic
+    ///   order n between 0 and 14
+    /// </returns>
+    public: static bool IsAmbisonicChannelCount(std::size_t channelCount);
+
+    /// <summary>Determines the ambisonic order of a channel count</summary>
+    /// <param name="channelCount">Number of channels carrying the ambisonic sound field</param>
+    /// <returns>The ambisonic order or -1 if the channel count is not ambisonic</returns>
+    public: static int GetAmbisonicOrder(std::size_t channelCount);
+
+    /// <summary>Selects the mapping family an encoder should use for a channel order</summary>
+    /// <param name="channelOrder">Order of the channels that will be encoded</param>
+    /// <returns>The channel mapping family the channels can be stored in</returns>
+    /// <remarks>
+    ///   Channels with speaker placements are stored in family 0 or 1. Channels without
+    ///   any placement are stored as ambisonics (family 2) if their count fits and as
+    ///   discrete channels (family 255) otherwise.
+    /// </remarks>
+    public: static int SelectMappingFamily(const std::vector<ChannelPlacement> &channelOrder);
+
+    /// <summary>Provides the order in which a mapping family interleaves the channels</summary>
+    /// <param name="mappingFamily">Channel mapping family of the Opus stream</param>
+    /// <param name="channelCount">Number of channels in the Opus stream</param>
+    /// <returns>The placement of each channel in interleaved order</returns>
+    public: static std::vector<ChannelPlacement> GetChannelOrder(
+      int mappingFamily, std::size_t channelCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#endif // NUCLEX_AUDIO_STORAGE_OPUS_OPUSCHANNELMAPPING_H
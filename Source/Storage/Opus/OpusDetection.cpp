@@ -114,6 +114,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     std::byte fileHeader[48];
     source.ReadAt(0, 48, fileHeader);
 
+    return CheckIfOpusHeaderPresentLite(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfOpusHeaderPresentLite(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 48) {
+      return false; // Not enough header bytes to check for a valid Opus header
+    }
+
     // OPUS files, even those produced by the standalone opusenc executable,
     // are .ogg files with an OPUS stream inside.
     //
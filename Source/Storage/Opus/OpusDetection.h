@@ -25,7 +25,7 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
 #include <string> // for std::string
-#include <cstddef> // for std::size_t
+#include <cstddef> // for std::size_t, std::byte
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -75,6 +75,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <returns>True if a valid OPUS header was found, false otherwise</returns>
     public: static bool CheckIfOpusHeaderPresentLite(const VirtualFile &source);
 
+    /// <summary>Checks if the file header starts with a valid OPUS header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid OPUS header was found, false otherwise</returns>
+    public: static bool CheckIfOpusHeaderPresentLite(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
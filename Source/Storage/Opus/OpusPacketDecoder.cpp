@@ -0,0 +1,349 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OpusPacketDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "./OpusChannelMapping.h"
+
+#include <cstring> // for std::memcmp(), std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <type_traits> // for std::is_same
+
+#include <opus_multistream.h> // for the multistream decoder from libopus
+#include <opus_projection.h> // for the ambisonic projection decoder from libopus
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decoder complexity libopus uses unless told otherwise</summary>
+  /// <remarks>
+  ///   Since libopus 1.5, the decoder complexity controls the neural packet loss
+  ///   concealment (5 and up) and speech enhancement (6 and up). It starts at 0 with
+  ///   all of these off, which is as cheap as the decoder gets.
+  /// </remarks>
+  const int DefaultDecoderComplexity = 0;
+
+  /// <summary>Decoder complexity that enables all enhancements of libopus</summary>
+  const int HighestDecoderComplexity = 10;
+
+  /// <summary>Largest number of frames a single Opus packet can decode to</summary>
+  /// <remarks>120 milliseconds at 48 kHz, the longest packet duration Opus allows</remarks>
+  const int MaximumPacketFrameCount = 5760;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 16-bit little endian integer from a buffer</summary>
+  /// <param name="data">Buffer holding the integer</param>
+  /// <returns>The integer that was read</returns>
+  std::uint16_t readUInt16Le(const std::byte *data) {
+    return static_cast<std::uint16_t>(
+      static_cast<std::uint16_t>(data[0]) | (static_cast<std::uint16_t>(data[1]) << 8)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception reporting an invalid OpusHead header</summary>
+  [[noreturn]] void throwInvalidHeader() {
+    throw Nuclex::Audio::Errors::CorruptedFileError(
+      u8"Opus codec setup data does not contain a valid OpusHead header"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OpusPacketDecoder::OpusPacketDecoder(
+    const std::byte *header, std::size_t headerSize, std::size_t sampleRate /* = 48000 */
+  ) :
+    decoder(),
+    projectionDecoder(),
+    channelOrder(),
+    preSkip(0),
+    sampleRate(sampleRate) {
+
+    bool isSupportedSampleRate = (
+      (sampleRate == 8000) || (sampleRate == 12000) || (sampleRate == 16000) ||
+      (sampleRate == 24000) || (sampleRate == 48000)
+    );
+    if(!isSupportedSampleRate) {
+      throw std::invalid_argument(
+        u8"Opus can only decode at 8000, 12000, 16000, 24000 or 48000 Hz"
+      );
+    }
+
+    // The OpusHead is 19 bytes for mapping family 0 and carries a channel mapping
+    // table for all other families (RFC 7845, section 5.1)
+    if((headerSize < 19) || (std::memcmp(header, u8"OpusHead", 8) != 0)) {
+      throwInvalidHeader();
+    }
+    if((static_cast<std::uint8_t>(header[8]) & 0xF0) != 0) {
+      throw Errors::UnsupportedFormatError(u8"Opus header uses an unsupported major version");
+    }
+
+    int channelCount = static_cast<int>(header[9]);
+    this->preSkip = readUInt16Le(header + 10);
+    int outputGain = static_cast<std::int16_t>(readUInt16Le(header + 16));
+    int mappingFamily = static_cast<int>(header[18]);
+    if(channelCount == 0) {
+      throwInvalidHeader();
+    }
+
+    int streamCount, coupledStreamCount;
+    if(mappingFamily == 0) {
+      if(channelCount > 2) {
+        throwInvalidHeader();
+      }
+      streamCount = 1;
+      coupledStreamCount = channelCount - 1;
+    } else {
+      if(headerSize < 21) {
+        throwInvalidHeader();
+      }
+      streamCount = static_cast<int>(header[19]);
+      coupledStreamCount = static_cast<int>(header[20]);
+    }
+
+    if(mappingFamily == 3) {
+      createProjectionDecoder(
+        header + 21, headerSize - 21, channelCount, streamCount, coupledStreamCount
+      );
+    } else {
+      unsigned char mapping[255];
+      if(mappingFamily == 0) {
+        mapping[0] = 0;
+        mapping[1] = 1;
+      } else {
+        if(headerSize < 21 + static_cast<std::size_t>(channelCount)) {
+          throwInvalidHeader();
+        }
+        for(int index = 0; index < channelCount; ++index) {
+          mapping[index] = static_cast<unsigned char>(header[21 + index]);
+        }
+      }
+
+      int errorCode = OPUS_OK;
+      ::OpusMSDecoder *rawDecoder = ::opus_multistream_decoder_create(
+        static_cast<::opus_int32>(this->sampleRate),
+        channelCount, streamCount, coupledStreamCount, mapping, &errorCode
+      );
+      if((rawDecoder == nullptr) || (errorCode != OPUS_OK)) {
+        throw Errors::UnsupportedFormatError(
+          u8"Opus channel mapping could not be set up by libopus"
+        );
+      }
+      this->decoder.reset(rawDecoder, &::opus_multistream_decoder_destroy);
+    }
+
+    if(outputGain != 0) {
+      if(this->projectionDecoder) {
+        ::opus_projection_decoder_ctl(this->projectionDecoder.get(), OPUS_SET_GAIN(outputGain));
+      } else {
+        ::opus_multistream_decoder_ctl(this->decoder.get(), OPUS_SET_GAIN(outputGain));
+      }
+    }
+
+    this->channelOrder = OpusChannelMapping::GetChannelOrder(
+      mappingFamily, static_cast<std::size_t>(channelCount)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusPacketDecoder::createProjectionDecoder(
+    const std::byte *demixingMatrix, std::size_t availableByteCount,
+    int channelCount, int streamCount, int coupledStreamCount
+  ) {
+
+    // Family 3 stores a demixing matrix of 16-bit coefficients, one row per output
+    // channel and one column per decoded stream channel (RFC 8486, section 3.2)
+    std::size_t demixingMatrixSize = (
+      2 * static_cast<std::size_t>(channelCount) *
+      static_cast<std::size_t>(streamCount + coupledStreamCount)
+    );
+    if(availableByteCount < demixingMatrixSize) {
+      throwInvalidHeader();
+    }
+
+    // libopus wants the matrix as a mutable byte array, so hand it a copy
+    std::vector<unsigned char> matrix(demixingMatrixSize);
+    std::memcpy(matrix.data(), demixingMatrix, demixingMatrixSize);
+
+    int errorCode = OPUS_OK;
+    ::OpusProjectionDecoder *rawDecoder = ::opus_projection_decoder_create(
+      static_cast<::opus_int32>(this->sampleRate), channelCount, streamCount, coupledStreamCount,
+      matrix.data(), static_cast<::opus_int32>(demixingMatrixSize), &errorCode
+    );
+    if((rawDecoder == nullptr) || (errorCode != OPUS_OK)) {
+      throw Errors::UnsupportedFormatError(
+        u8"Opus ambisonic projection could not be set up by libopus"
+      );
+    }
+    this->projectionDecoder.reset(rawDecoder, &::opus_projection_decoder_destroy);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  int OpusPacketDecoder::GetDecoderComplexity(DecodeFidelity fidelity) {
+    if(fidelity == DecodeFidelity::Enhanced) {
+      return HighestDecoderComplexity;
+    } else {
+      return DefaultDecoderComplexity;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusPacketDecoder::TrySetFidelity(DecodeFidelity fidelity) {
+    int complexity = GetDecoderComplexity(fidelity);
+
+    // libopus before 1.5 answers with OPUS_UNIMPLEMENTED, it has nothing to switch anyway
+    if(this->projectionDecoder) {
+      ::opus_projection_decoder_ctl(
+        this->projectionDecoder.get(), OPUS_SET_COMPLEXITY(complexity)
+      );
+    } else {
+      ::opus_multistream_decoder_ctl(this->decoder.get(), OPUS_SET_COMPLEXITY(complexity));
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusPacketDecoder::Reset() {
+    if(this->projectionDecoder) {
+      ::opus_projection_decoder_ctl(this->projectionDecoder.get(), OPUS_RESET_STATE);
+    } else {
+      ::opus_multistream_decoder_ctl(this->decoder.get(), OPUS_RESET_STATE);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketDecoder::CountLeadInFrames() const {
+    return this->preSkip * this->sampleRate / 48000;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketDecoder::DecodePacket(
+    const std::byte *packet, std::size_t packetSize, std::vector<float> &samples
+  ) {
+    std::size_t channelCount = this->channelOrder.size();
+    std::size_t maximumFrameCount = MaximumPacketFrameCount * this->sampleRate / 48000;
+
+    std::size_t startIndex = samples.size();
+    samples.resize(startIndex + maximumFrameCount * channelCount);
+
+    std::size_t frameCount;
+    try {
+      frameCount = decodeInto(packet, packetSize, samples.data() + startIndex, maximumFrameCount);
+    }
+    catch(const std::exception &) {
+      samples.resize(startIndex);
+      throw;
+    }
+
+    samples.resize(startIndex + frameCount * channelCount);
+    return frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketDecoder::DecodePacket(
+    const std::byte *packet, std::size_t packetSize,
+    float *samples, std::size_t maximumFrameCount
+  ) {
+    return decodeInto(packet, packetSize, samples, maximumFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketDecoder::DecodePacket(
+    const std::byte *packet, std::size_t packetSize,
+    std::int16_t *samples, std::size_t maximumFrameCount
+  ) {
+    return decodeInto(packet, packetSize, samples, maximumFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  std::size_t OpusPacketDecoder::decodeInto(
+    const std::byte *packet, std::size_t packetSize,
+    TSample *samples, std::size_t maximumFrameCount
+  ) {
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(packet);
+    ::opus_int32 length = static_cast<::opus_int32>(packetSize);
+    if(packet == nullptr) {
+      length = 0; // libopus conceals a lost packet when handed a null packet
+    }
+
+    int result;
+    if(this->projectionDecoder) {
+      if constexpr(std::is_same<TSample, float>::value) {
+        result = ::opus_projection_decode_float(
+          this->projectionDecoder.get(), data, length,
+          samples, static_cast<int>(maximumFrameCount), 0
+        );
+      } else {
+        result = ::opus_projection_decode(
+          this->projectionDecoder.get(), data, length,
+          reinterpret_cast<::opus_int16 *>(samples), static_cast<int>(maximumFrameCount), 0
+        );
+      }
+    } else {
+      if constexpr(std::is_same<TSample, float>::value) {
+        result = ::opus_multistream_decode_float(
+          this->decoder.get(), data, length,
+          samples, static_cast<int>(maximumFrameCount), 0
+        );
+      } else {
+        result = ::opus_multistream_decode(
+          this->decoder.get(), data, length,
+          reinterpret_cast<::opus_int16 *>(samples), static_cast<int>(maximumFrameCount), 0
+        );
+      }
+    }
+    if(result < 0) {
+      throw Errors::CorruptedFileError(u8"Opus packet could not be decoded");
+    }
+
+    return static_cast<std::size_t>(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -0,0 +1,172 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETDECODER_H
+#define NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/Storage/AudioPacketDecoder.h"
+#include "../Shared/PacketDecoder.h"
+
+#include <memory> // for std::shared_ptr
+
+struct OpusMSDecoder;
+struct OpusProjectionDecoder;
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes raw Opus packets delivered by a non-Ogg container</summary>
+  /// <remarks>
+  ///   Containers such as Matroska store the OpusHead identification header as
+  ///   codec setup data and each Opus packet as a block. This sets up libopus'
+  ///   multistream decoder from the OpusHead and feeds it the packets directly.
+  ///   Like libopusfile, it decodes at 48 kHz unless told otherwise and applies
+  ///   the output gain. Ambisonics stored with a demixing matrix (mapping family 3)
+  ///   go through libopus' projection decoder instead.
+  ///   It also serves as the public packet decoder for raw Opus packets that were
+  ///   produced by an <see cref="AudioPacketEncoder" />.
+  /// </remarks>
+  class OpusPacketDecoder : public Shared::PacketDecoder, public AudioPacketDecoder {
+
+    /// <summary>Initializes a new Opus packet decoder from an OpusHead header</summary>
+    /// <param name="header">Contents of the OpusHead identification header</param>
+    /// <param name="headerSize">Size of the identification header in bytes</param>
+    /// <param name="sampleRate">Sample rate at which libopus will decode</param>
+    public: OpusPacketDecoder(
+      const std::byte *header, std::size_t headerSize, std::size_t sampleRate = 48000
+    );
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~OpusPacketDecoder() override = default;
+
+    /// <summary>Counts the number of audio channels the decoder produces</summary>
+    /// <returns>The number of interleaved channels in the decoded samples</returns>
+    public: std::size_t CountChannels() const override { return this->channelOrder.size(); }
+
+    /// <summary>Returns the number of frames per second the decoder produces</summary>
+    /// <returns>The sample rate of the decoded audio, 48000 unless chosen otherwise</returns>
+    public: std::size_t GetSampleRate() const override { return this->sampleRate; }
+
+    /// <summary>Retrieves the order in which the decoded channels are interleaved</summary>
+    /// <returns>The placement of each decoded channel, in interleaved order</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Looks up the libopus decoder complexity for a fidelity level</summary>
+    /// <param name="fidelity">Fidelity level the decoder should run at</param>
+    /// <returns>The value to pass to libopus' OPUS_SET_COMPLEXITY request</returns>
+    public: static int GetDecoderComplexity(DecodeFidelity fidelity);
+
+    /// <summary>Returns the number of frames the encoder prepended to the audio</summary>
+    /// <returns>The pre-skip stated in the OpusHead header</returns>
+    public: std::size_t GetPreSkip() const { return this->preSkip; }
+
+    /// <summary>Returns the number of frames the encoder put before the actual audio</summary>
+    /// <returns>The pre-skip converted to the sample rate the decoder runs at</returns>
+    public: std::size_t CountLeadInFrames() const override;
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    public: void Reset() override;
+
+    /// <summary>Sets the libopus decoder complexity matching a fidelity level</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <returns>Always true, libopus versions before 1.5 simply ignore it</returns>
+    public: bool TrySetFidelity(DecodeFidelity fidelity) override;
+
+    /// <summary>Decodes a packet and appends its samples to a buffer</summary>
+    /// <param name="packet">Packet that will be decoded</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer the interleaved float samples will be appended to</param>
+    /// <returns>The number of frames that have been appended</returns>
+    public: std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize, std::vector<float> &samples
+    ) override;
+
+    /// <summary>Decodes a packet into interleaved float samples</summary>
+    /// <param name="packet">Packet that will be decoded or null if it was lost</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="maximumFrameCount">Number of frames the buffer can hold</param>
+    /// <returns>The number of frames that have been decoded</returns>
+    public: std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize,
+      float *samples, std::size_t maximumFrameCount
+    ) override;
+
+    /// <summary>Decodes a packet into interleaved 16-bit integer samples</summary>
+    /// <param name="packet">Packet that will be decoded or null if it was lost</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="maximumFrameCount">Number of frames the buffer can hold</param>
+    /// <returns>The number of frames that have been decoded</returns>
+    public: std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize,
+      std::int16_t *samples, std::size_t maximumFrameCount
+    ) override;
+
+    /// <summary>Sets up the projection decoder for ambisonics in mapping family 3</summary>
+    /// <param name="demixingMatrix">Demixing matrix stored in the OpusHead header</param>
+    /// <param name="availableByteCount">Number of header bytes left for the matrix</param>
+    /// <param name="channelCount">Number of output channels</param>
+    /// <param name="streamCount">Number of Opus streams in each packet</param>
+    /// <param name="coupledStreamCount">Number of those streams that are stereo</param>
+    private: void createProjectionDecoder(
+      const std::byte *demixingMatrix, std::size_t availableByteCount,
+      int channelCount, int streamCount, int coupledStreamCount
+    );
+
+    /// <summary>Decodes a packet or conceals a lost one into a sample buffer</summary>
+    /// <typeparam name="TSample">Type of samples that will be produced</typeparam>
+    /// <param name="packet">Packet that will be decoded or null if it was lost</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer that will receive the interleaved samples</param>
+    /// <param name="maximumFrameCount">Number of frames the buffer can hold</param>
+    /// <returns>The number of frames that have been decoded</returns>
+    private: template<typename TSample>
+    std::size_t decodeInto(
+      const std::byte *packet, std::size_t packetSize,
+      TSample *samples, std::size_t maximumFrameCount
+    );
+
+    /// <summary>libopus multistream decoder the packets are fed to</summary>
+    private: std::shared_ptr<::OpusMSDecoder> decoder;
+    /// <summary>libopus projection decoder used for mapping family 3 instead</summary>
+    private: std::shared_ptr<::OpusProjectionDecoder> projectionDecoder;
+    /// <summary>Order in which the decoded channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Number of frames the encoder prepended to the audio</summary>
+    private: std::size_t preSkip;
+    /// <summary>Sample rate at which libopus decodes the packets</summary>
+    private: std::size_t sampleRate;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#endif // NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETDECODER_H
@@ -0,0 +1,247 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OpusPacketEncoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "./OpusChannelMapping.h"
+#include "../Shared/ChannelOrderTransformer.h"
+#include "../../Platform/OpusEncoderApi.h"
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample rate Opus always uses internally and in its headers</summary>
+  const std::size_t FullSampleRate = 48000;
+
+  /// <summary>Largest number of bytes a single-stream Opus packet can take up</summary>
+  /// <remarks>
+  ///   A packet holds at most 3 frames of 1275 bytes each at the longest duration we
+  ///   allow (RFC 6716, section 3.2.5), plus up to 7 bytes for the frame lengths and
+  ///   2 bytes for the self-delimiting length multistream packets add.
+  /// </remarks>
+  const std::size_t MaximumStreamPacketSize = 1275 * 3 + 7 + 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether libopus can encode audio with the specified sample rate</summary>
+  /// <param name="sampleRate">Sample rate that will be checked</param>
+  /// <returns>True if the sample rate is one of the rates libopus supports</returns>
+  bool isSupportedSampleRate(std::size_t sampleRate) {
+    return (
+      (sampleRate == 8000) || (sampleRate == 12000) || (sampleRate == 16000) ||
+      (sampleRate == 24000) || (sampleRate == 48000)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether an Opus packet can have the specified duration</summary>
+  /// <param name="packetMicroseconds">Packet duration that will be checked</param>
+  /// <returns>True if the duration is one of the frame sizes Opus supports</returns>
+  bool isSupportedPacketDuration(std::size_t packetMicroseconds) {
+    return (
+      (packetMicroseconds == 2500) || (packetMicroseconds == 5000) ||
+      (packetMicroseconds == 10000) || (packetMicroseconds == 20000) ||
+      (packetMicroseconds == 40000) || (packetMicroseconds == 60000)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OpusPacketEncoder::OpusPacketEncoder(
+    const std::vector<ChannelPlacement> &channelOrder,
+    std::size_t sampleRate,
+    std::size_t packetMicroseconds
+  ) :
+    channelOrder(channelOrder),
+    sampleRate(sampleRate),
+    packetFrameCount(sampleRate * packetMicroseconds / 1000000),
+    streamCount(0),
+    isEncoderChannelOrder(false),
+    channelRemapper(),
+    floatPacket(),
+    integerPacket(),
+    setupData(),
+    encoder() {
+
+    std::size_t channelCount = channelOrder.size();
+    if((channelCount == 0) || (channelCount > 255)) {
+      throw std::invalid_argument(u8"Opus packets can carry between 1 and 255 channels");
+    }
+    if(!isSupportedSampleRate(sampleRate)) {
+      throw std::invalid_argument(
+        u8"Opus can only encode at 8000, 12000, 16000, 24000 or 48000 Hz"
+      );
+    }
+    if(!isSupportedPacketDuration(packetMicroseconds)) {
+      throw std::invalid_argument(
+        u8"Opus packets can only be 2.5, 5, 10, 20, 40 or 60 milliseconds long"
+      );
+    }
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
+    int mappingFamily = OpusChannelMapping::SelectMappingFamily(this->channelOrder);
+    int streamCount = 0, coupledStreamCount = 0;
+    unsigned char mapping[255];
+    this->encoder = Platform::OpusEncoderApi::CreatePacketEncoder(
+      sampleRate, channelCount, mappingFamily, OPUS_APPLICATION_VOIP,
+      streamCount, coupledStreamCount, mapping
+    );
+    this->streamCount = static_cast<std::size_t>(streamCount);
+
+    buildSetupData(mappingFamily, streamCount, coupledStreamCount, mapping);
+
+    // Same as in the track encoder: if the caller interleaves the channels the way
+    // the mapping family does, samples can go to libopus as they are. Otherwise,
+    // set up the remapping table and the buffers now so encoding won't allocate.
+    std::vector<ChannelPlacement> encoderChannelOrder = (
+      OpusChannelMapping::GetChannelOrder(mappingFamily, channelCount)
+    );
+    this->isEncoderChannelOrder = (this->channelOrder == encoderChannelOrder);
+    if(!this->isEncoderChannelOrder) {
+      AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+      this->channelRemapper = Shared::ChannelRemapper(
+        Shared::ChannelOrderTransformer::CreateRemappingTable(
+          this->channelOrder, encoderChannelOrder
+        )
+      );
+      this->floatPacket.resize(this->packetFrameCount * channelCount);
+      this->integerPacket.resize(this->packetFrameCount * channelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketEncoder::CountMaximumPacketBytes() const {
+    return this->streamCount * MaximumStreamPacketSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusPacketEncoder::SetBitrate(float kilobitsPerSecond) {
+    Platform::OpusEncoderApi::ControlPacketEncoder(
+      this->encoder, OPUS_SET_BITRATE_REQUEST, static_cast<int>(kilobitsPerSecond * 1000.0f)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusPacketEncoder::Reset() {
+    Platform::OpusEncoderApi::ResetPacketEncoder(this->encoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketEncoder::EncodePacket(
+    const float *samples, std::byte *packet, std::size_t packetCapacity
+  ) {
+    if(!this->isEncoderChannelOrder) {
+      remapInterleaved(samples, this->floatPacket.data());
+      samples = this->floatPacket.data();
+    }
+
+    return Platform::OpusEncoderApi::EncodePacketFloats(
+      this->encoder, samples, this->packetFrameCount, packet, packetCapacity
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusPacketEncoder::EncodePacket(
+    const std::int16_t *samples, std::byte *packet, std::size_t packetCapacity
+  ) {
+    if(!this->isEncoderChannelOrder) {
+      remapInterleaved(samples, this->integerPacket.data());
+      samples = this->integerPacket.data();
+    }
+
+    return Platform::OpusEncoderApi::EncodePacketIntegers(
+      this->encoder, samples, this->packetFrameCount, packet, packetCapacity
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void OpusPacketEncoder::remapInterleaved(const TSample *source, TSample *target) const {
+    this->channelRemapper.RemapInterleaved(source, target, this->packetFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusPacketEncoder::buildSetupData(
+    int mappingFamily, int streamCount, int coupledStreamCount,
+    const unsigned char *mapping
+  ) {
+    std::size_t channelCount = this->channelOrder.size();
+
+    // The pre-skip is always stated at 48 kHz, whatever rate the encoder runs at
+    std::size_t preSkip = (
+      Platform::OpusEncoderApi::GetPacketEncoderLookahead(this->encoder) *
+      FullSampleRate / this->sampleRate
+    );
+
+    // Layout of the OpusHead identification header, RFC 7845, section 5.1
+    this->setupData.reserve(21 + channelCount);
+    const char magic[] = { 'O', 'p', 'u', 's', 'H', 'e', 'a', 'd' };
+    for(char character : magic) {
+      this->setupData.push_back(static_cast<std::byte>(character));
+    }
+    this->setupData.push_back(std::byte(1)); // version
+    this->setupData.push_back(static_cast<std::byte>(channelCount));
+    this->setupData.push_back(static_cast<std::byte>(preSkip));
+    this->setupData.push_back(static_cast<std::byte>(preSkip >> 8));
+    for(std::size_t index = 0; index < 4; ++index) {
+      this->setupData.push_back(static_cast<std::byte>(this->sampleRate >> (index * 8)));
+    }
+    this->setupData.push_back(std::byte(0)); // output gain, low byte
+    this->setupData.push_back(std::byte(0)); // output gain, high byte
+    this->setupData.push_back(static_cast<std::byte>(mappingFamily));
+
+    if(mappingFamily != 0) {
+      this->setupData.push_back(static_cast<std::byte>(streamCount));
+      this->setupData.push_back(static_cast<std::byte>(coupledStreamCount));
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        this->setupData.push_back(static_cast<std::byte>(mapping[index]));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -0,0 +1,160 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETENCODER_H
+#define NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/Storage/AudioPacketEncoder.h"
+
+#include "../Shared/ChannelRemapper.h"
+
+#include <memory> // for std::shared_ptr
+
+struct OpusMSEncoder;
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes audio into raw Opus packets for real-time transmission</summary>
+  /// <remarks>
+  ///   This skips libopusenc and talks to libopus' multistream encoder directly, so
+  ///   each packet is available the moment its samples have been encoded, without
+  ///   waiting for an Ogg page to fill up. The channel layout is chosen the same way
+  ///   the <see cref="OpusTrackEncoder" /> does it.
+  /// </remarks>
+  class OpusPacketEncoder : public AudioPacketEncoder {
+
+    /// <summary>Initializes a new Opus packet encoder</summary>
+    /// <param name="channelOrder">Order in which the channels will be interleaved</param>
+    /// <param name="sampleRate">Sample rate of the audio that will be encoded</param>
+    /// <param name="packetMicroseconds">Duration of each packet in microseconds</param>
+    public: OpusPacketEncoder(
+      const std::vector<ChannelPlacement> &channelOrder,
+      std::size_t sampleRate,
+      std::size_t packetMicroseconds
+    );
+
+    /// <summary>Frees all resources owned by the encoder</summary>
+    public: ~OpusPacketEncoder() override = default;
+
+    /// <summary>Counts the number of audio channels the encoder takes</summary>
+    /// <returns>The number of interleaved channels in each packet's samples</returns>
+    public: std::size_t CountChannels() const override { return this->channelOrder.size(); }
+
+    /// <summary>Retrieves the order in which the channels have to be interleaved</summary>
+    /// <returns>The placement of each channel, in interleaved order</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the sample rate of the audio the encoder takes</summary>
+    /// <returns>The number of frames per second in the encoded audio</returns>
+    public: std::size_t GetSampleRate() const override { return this->sampleRate; }
+
+    /// <summary>Returns the number of frames that go into each packet</summary>
+    /// <returns>The number of frames each call to EncodePacket() consumes</returns>
+    public: std::size_t CountFramesPerPacket() const override { return this->packetFrameCount; }
+
+    /// <summary>Returns the number of bytes that are enough for any single packet</summary>
+    /// <returns>The size a packet buffer needs to hold any packet the encoder produces</returns>
+    public: std::size_t CountMaximumPacketBytes() const override;
+
+    /// <summary>Provides the codec setup data a decoder needs to decode the packets</summary>
+    /// <returns>The OpusHead identification header describing the packets</returns>
+    public: const std::vector<std::byte> &GetSetupData() const override {
+      return this->setupData;
+    }
+
+    /// <summary>Changes the bit rate the encoder targets</summary>
+    /// <param name="kilobitsPerSecond">Bit rate in kilobits per second</param>
+    public: void SetBitrate(float kilobitsPerSecond) override;
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    public: void Reset() override;
+
+    /// <summary>Encodes one packet's worth of interleaved float samples</summary>
+    /// <param name="samples">Interleaved samples of a single packet</param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The size of the encoded packet in bytes</returns>
+    public: std::size_t EncodePacket(
+      const float *samples, std::byte *packet, std::size_t packetCapacity
+    ) override;
+
+    /// <summary>Encodes one packet's worth of interleaved 16-bit integer samples</summary>
+    /// <param name="samples">Interleaved samples of a single packet</param>
+    /// <param name="packet">Buffer that will receive the encoded packet</param>
+    /// <param name="packetCapacity">Number of bytes available in the packet buffer</param>
+    /// <returns>The size of the encoded packet in bytes</returns>
+    public: std::size_t EncodePacket(
+      const std::int16_t *samples, std::byte *packet, std::size_t packetCapacity
+    ) override;
+
+    /// <summary>Copies the samples of a packet into the channel order of the encoder</summary>
+    /// <typeparam name="TSample">Type of the samples that will be reordered</typeparam>
+    /// <param name="source">Samples in the caller's channel order</param>
+    /// <param name="target">Receives the samples in the encoder's channel order</param>
+    private: template<typename TSample>
+    void remapInterleaved(const TSample *source, TSample *target) const;
+
+    /// <summary>Writes the OpusHead header the decoder will be set up from</summary>
+    /// <param name="mappingFamily">Channel mapping family used by the encoder</param>
+    /// <param name="streamCount">Number of Opus streams in each packet</param>
+    /// <param name="coupledStreamCount">Number of those streams that are stereo</param>
+    /// <param name="mapping">Stream channel each output channel is taken from</param>
+    private: void buildSetupData(
+      int mappingFamily, int streamCount, int coupledStreamCount,
+      const unsigned char *mapping
+    );
+
+    /// <summary>Order in which the caller interleaves the channels</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Sample rate of the audio that is being encoded</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Number of frames in each packet</summary>
+    private: std::size_t packetFrameCount;
+    /// <summary>Number of Opus streams each packet holds</summary>
+    private: std::size_t streamCount;
+    /// <summary>Whether the caller's channel order matches the encoder's</summary>
+    private: bool isEncoderChannelOrder;
+    /// <summary>Takes the caller's channels into encoder channel order</summary>
+    private: Shared::ChannelRemapper channelRemapper;
+    /// <summary>Holds reordered float samples if the channel orders differ</summary>
+    private: std::vector<float> floatPacket;
+    /// <summary>Holds reordered integer samples if the channel orders differ</summary>
+    private: std::vector<std::int16_t> integerPacket;
+    /// <summary>OpusHead header describing the encoded packets</summary>
+    private: std::vector<std::byte> setupData;
+    /// <summary>libopus multistream encoder producing the packets</summary>
+    private: std::shared_ptr<::OpusMSEncoder> encoder;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#endif // NUCLEX_AUDIO_STORAGE_OPUS_OPUSPACKETENCODER_H
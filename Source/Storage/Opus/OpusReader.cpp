@@ -25,19 +25,126 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
 #include "./OpusVirtualFileAdapter.h" // for FileAdapterFactory
+#include "./OpusPacketDecoder.h" // for OpusPacketDecoder::GetDecoderComplexity()
 #include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/OggSeekIndex.h" // for OggSeekIndex
+#include "../Shared/DecoderStatisticsCollector.h" // for DecoderStatisticsCollector
+#include "../Shared/LoopTagParser.h" // for LoopTagParser
+#include "../Shared/GainTagParser.h" // for GainTagParser
 #include "../../Platform/OpusApi.h" // for OpusApi
 
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/ChunkSizePolicy.h"
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
 #include "Nuclex/Audio/Processing/Quantization.h"
 
+#include <algorithm> // for std::min(), std::copy_n()
 #include <numeric> // for std::gcd()
+#include <optional> // for std::optional
 #include <cassert> // for assert()
 
+#include <opus_multistream.h> // for the reduced rate decoder from libopus
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample rate at which Opus streams are encoded and libopusfile decodes</summary>
+  const std::size_t FullSampleRate = 48000;
+
+  /// <summary>Number of frames Opus needs to decode before its output converges</summary>
+  /// <remarks>
+  ///   The Opus specification recommends starting to decode at least 80 ms before
+  ///   a seek target, otherwise the first frames after the seek will be audibly off.
+  /// </remarks>
+  const std::uint64_t PreRollFrameCount = 3840;
+
+  /// <summary>Highest channel count for which separated targets are kept on the stack</summary>
+  /// <remarks>
+  ///   Opus supports up to 255 channels, but the interleaver only has specialized
+  ///   kernels up to 8 channels. Beyond that, the samples are sorted one by one.
+  /// </remarks>
+  const std::size_t MaximumDeinterleavedChannelCount = 8;
+
+  /// <summary>Number of seek checkpoints each reader remembers</summary>
+  /// <remarks>
+  ///   With one checkpoint recorded every quarter second, this covers the last
+  ///   16 seconds of audio the reader has decoded outside of the seek index.
+  /// </remarks>
+  const std::size_t CheckpointCapacity = 64;
+
+  /// <summary>Minimum number of frames between two recorded checkpoints</summary>
+  const std::uint64_t CheckpointIntervalFrameCount = 12000;
+
+  /// <summary>Farthest a checkpoint may lie before a seek target to be used</summary>
+  /// <remarks>
+  ///   Decoding forward through more than this takes longer than letting libopusfile
+  ///   bisect the file, so more distant checkpoints are ignored.
+  /// </remarks>
+  const std::uint64_t MaximumCheckpointDistance = 96000;
+
+  /// <summary>Number of frames a checkpoint tries to resume before its pre-roll</summary>
+  /// <remarks>
+  ///   Jumping to a byte offset lands on the next page after it, so the search
+  ///   for a checkpoint backs off by roughly this many frames' worth of bytes.
+  /// </remarks>
+  const std::uint64_t CheckpointBackoffFrameCount = 9600;
+
+  /// <summary>Bit rate assumed for length estimates before any audio was decoded</summary>
+  /// <remarks>
+  ///   Opus headers state no bit rate. This is on the high side for music, so
+  ///   the estimate errs towards being too short.
+  /// </remarks>
+  const std::uint64_t FallbackBitRate = 192000;
+
+  /// <summary>Bytes per second a single channel can take up at most</summary>
+  /// <remarks>
+  ///   libopus caps each stream at 256 kbit/s per channel.
+  /// </remarks>
+  const std::uint64_t MaximumBytesPerChannelSecond = 32000;
+
+  /// <summary>Bytes that libopusfile may read ahead beyond the decoded frames</summary>
+  /// <remarks>
+  ///   libopusfile has to read a whole page before it can decode its first packet
+  ///   and a page can be almost 64 KiB long.
+  /// </remarks>
+  const std::uint64_t ReadAheadByteCount = 131072;
+
+  /// <summary>Longest duration of an Opus packet in frames</summary>
+  const std::uint64_t MaximumPacketFrameCount = 5760;
+
+  /// <summary>Number of times the checkpoint search backs off further</summary>
+  const std::size_t CheckpointAttemptCount = 4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a frame count at 48 kHz into one at the decode rate</summary>
+  /// <param name="frameCount">Number of frames at 48 kHz</param>
+  /// <param name="decimationFactor">Number of 48 kHz frames per decoded frame</param>
+  /// <returns>The number of frames at the decode rate that cover the 48 kHz frames</returns>
+  std::uint64_t toDecodeRate(std::uint64_t frameCount, std::size_t decimationFactor) {
+    return (frameCount + decimationFactor - 1) / decimationFactor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Asks the chunk size policy how many frames to decode per call</summary>
+  /// <param name="channelCount">Number of channels in the Opus file</param>
+  /// <returns>The number of frames to decode into the scratch buffer per call</returns>
+  /// <remarks>
+  ///   libopusfile always decodes to floats here and the target type isn't known yet,
+  ///   so the output is budgeted as floats, too, which also covers the other types
+  ///   except for doubles.
+  /// </remarks>
+  std::size_t getDecodeChunkFrameCount(std::size_t channelCount) {
+    return Nuclex::Audio::Storage::ChunkSizePolicy::GetGlobal().GetChunkFrameCount(
+      channelCount, sizeof(float), sizeof(float)
+    );
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -46,18 +153,34 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
-  OpusReader::OpusReader(const std::shared_ptr<const VirtualFile> &file) :
+  OpusReader::OpusReader(
+    const std::shared_ptr<const VirtualFile> &file, bool deferLengthScan /* = false */
+  ) :
     file(file),
     fileCallbacks(),
     state(),
     opusFile(),
+    defersLengthScan(deferLengthScan),
+    isSeekable(!deferLengthScan),
     channelCount(0),
-    frameCursor(0) {
+    decimationFactor(1),
+    reducedRateDecoder(),
+    decoderComplexity(),
+    gainOffset(0),
+    configuredDecoder(nullptr),
+    frameCursor(0),
+    seekIndex(),
+    statistics(),
+    checkpoints(CheckpointCapacity),
+    lastCheckpointFrame(0),
+    decodeChunkFrameCount(0),
+    decodeBuffer(),
+    wantedChannelIndices() {
 
     // Set up the libopusfile callbacks with adapter methods that will perform all reads
     // on the user-provided virtual file.
     this->state = (
-      FileAdapterFactory::CreateAdapterForReading(file, this->fileCallbacks)
+      FileAdapterFactory::CreateAdapterForReading(file, this->fileCallbacks, this->isSeekable)
     );
 
     // Open the Opus file, obtaining a OggOpusFile instance. Everything inside
@@ -84,6 +207,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     //   automate things - if it just switches to the next link, what if the channel count
     //   suddenly changes? Will libopusfile upmix and downmix? Leave it all to us?
     //
+    // Without seeking, libopusfile can't know about later links until it reaches them,
+    // that is checked again when the file is reopened for seeking.
+    //
     std::size_t linkCount = Platform::OpusApi::CountLinks(this->opusFile);
     if(linkCount != 1) {
       throw std::runtime_error(u8"Multi-link Opus files are not supported");
@@ -95,6 +221,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       this->channelCount = header.channel_count;
     }
 
+    // Allocate the scratch memory for the decoding methods here, so that decoding
+    // calls (which may happen very frequently with small chunks) never allocate
+    AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+    this->decodeChunkFrameCount = getDecodeChunkFrameCount(this->channelCount);
+    this->decodeBuffer.resize(this->decodeChunkFrameCount * this->channelCount * sizeof(float));
+    this->wantedChannelIndices.reserve(this->channelCount);
+
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -103,7 +236,68 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void OpusReader::ReadMetadata(TrackInfo &target) {
+  void OpusReader::Reopen(const std::shared_ptr<const VirtualFile> &file) {
+
+    // Closing an OggOpusFile resets the file in its adapter state, so the new file
+    // needs its own adapter state until the previous OggOpusFile has been released.
+    std::unique_ptr<ReadOnlyFileAdapterState> newState = (
+      FileAdapterFactory::CreateAdapterForReading(
+        file, this->fileCallbacks, !this->defersLengthScan
+      )
+    );
+    std::shared_ptr<::OggOpusFile> newOpusFile = Platform::OpusApi::OpenFromCallbacks(
+      newState->Error,
+      newState.get(),
+      &fileCallbacks
+    );
+    FileAdapterState::RethrowPotentialException(*newState);
+
+    std::size_t linkCount = Platform::OpusApi::CountLinks(newOpusFile);
+    if(linkCount != 1) {
+      throw std::runtime_error(u8"Multi-link Opus files are not supported");
+    }
+
+    // Nothing can fail anymore, so switch the reader over to the new file. The order
+    // matters, the old OggOpusFile still calls back into the old adapter state.
+    this->opusFile = std::move(newOpusFile);
+    this->state = std::move(newState);
+    this->file = file;
+    this->isSeekable = !this->defersLengthScan;
+    if(this->gainOffset != 0) {
+      Platform::OpusApi::SetGainOffset(this->opusFile, this->gainOffset);
+    }
+    {
+      const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
+      this->channelCount = header.channel_count;
+    }
+
+    this->decimationFactor = 1;
+    this->reducedRateDecoder.reset();
+    this->configuredDecoder = nullptr;
+    updateDecodeCallback();
+    this->frameCursor = 0;
+    this->seekIndex.reset();
+    this->checkpoints.Clear();
+    this->lastCheckpointFrame = 0;
+
+    // The scratch memory only needs to grow if the new file has more channels
+    AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+    this->decodeChunkFrameCount = getDecodeChunkFrameCount(this->channelCount);
+    std::size_t requiredByteCount = (
+      this->decodeChunkFrameCount * this->channelCount * sizeof(float)
+    );
+    if(this->decodeBuffer.size() < requiredByteCount) {
+      this->decodeBuffer.resize(requiredByteCount);
+    }
+    this->wantedChannelIndices.reserve(this->channelCount);
+
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::ReadMetadata(TrackInfo &target, bool includeTags /* = true */) {
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+
     const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
 
     target.ChannelCount = static_cast<std::size_t>(header.channel_count);
@@ -118,10 +312,60 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     // input sample rate had been. The .input_sample_rate field merely states what
     // the original sample rate had been, but is not useful for playback of the Opus file.
     //trackInfo.SampleRate = static_cast<std::size_t>(header.input_sample_rate)
-    target.SampleRate = 48000;
+    //
+    // If a lower decode rate was chosen, everything is reported at that rate instead.
+    target.SampleRate = FullSampleRate / this->decimationFactor;
+
+    // libopusfile already drops the pre-skip and trims the end to the final granule
+    // position, so the decoded track is gapless. Report the pre-skip for completeness.
+    target.LeadingPaddingFrameCount = static_cast<std::size_t>(
+      toDecodeRate(header.pre_skip, this->decimationFactor)
+    );
+
+    // Opus decodes to float, so this is the native format. However, libopus can decode
+    // to 16-bit integers and there even is the possibility to compile libopus without
+    // floating point code for embedded systems, so... maybe dig deeper?
+    target.SampleFormat = Nuclex::Audio::AudioSampleFormat::Float_32;
+
+    // The header's output gain is always applied by libopus, the R128 tags are relative
+    // to the output with that gain applied and only applied if the decoder is asked to
+    {
+      const ::OpusTags &tags = Platform::OpusApi::GetTags(this->opusFile);
+
+      Shared::GainTagParser gainTags;
+      for(int index = 0; index < tags.comments; ++index) {
+        gainTags.ProcessComment(
+          std::string_view(tags.user_comments[index], tags.comment_lengths[index])
+        );
+      }
+      target.ReplayGain = gainTags.GetReplayGain();
+    }
+
+    // If the file was opened without seeking, the length isn't known and finding it would
+    // mean the very scan through the file end that deferring it was supposed to avoid
+    if(!this->isSeekable) {
+      return;
+    }
 
     std::uint64_t totalSampleCount = Platform::OpusApi::CountSamples(opusFile);
     target.Duration = std::chrono::microseconds(totalSampleCount * 1'000 / 48);
+    target.FrameCount = toDecodeRate(totalSampleCount, this->decimationFactor);
+
+    if(includeTags) {
+      const ::OpusTags &tags = Platform::OpusApi::GetTags(this->opusFile);
+
+      Shared::LoopTagParser loopTags;
+      for(int index = 0; index < tags.comments; ++index) {
+        loopTags.ProcessComment(
+          std::string_view(tags.user_comments[index], tags.comment_lengths[index])
+        );
+      }
+      target.Loop = loopTags.GetLoop(totalSampleCount);
+      if(target.Loop.has_value()) {
+        target.Loop->StartFrame = toDecodeRate(target.Loop->StartFrame, this->decimationFactor);
+        target.Loop->EndFrame = toDecodeRate(target.Loop->EndFrame, this->decimationFactor);
+      }
+    }
 
     {
       // Completely unfounded, arbitrary value to estimate the precision (which may or may
@@ -140,18 +384,159 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
         decodedByteCount
       );
     }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusReader::TrySetDecodeSampleRate(std::size_t sampleRate) {
+    bool isSupportedRate = (
+      (sampleRate == 8000) || (sampleRate == 12000) || (sampleRate == 16000) ||
+      (sampleRate == 24000) || (sampleRate == FullSampleRate)
+    );
+    if(!isSupportedRate) {
+      return false;
+    }
 
-    // Opus decodes to float, so this is the native format. However, libopus can decode
-    // to 16-bit integers and there even is the possibility to compile libopus without
-    // floating point code for embedded systems, so... maybe dig deeper?
-    target.SampleFormat = Nuclex::Audio::AudioSampleFormat::Float_32;
+    std::size_t decimationFactor = FullSampleRate / sampleRate;
+    if(decimationFactor == this->decimationFactor) {
+      return true;
+    }
+
+    // libopusfile only has its own decoder at 48 kHz, so for lower rates, the reader
+    // sets up a second decoder from the same header and decodes the packets itself
+    std::shared_ptr<::OpusMSDecoder> reducedRateDecoder;
+    if(decimationFactor > 1) {
+      const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
+
+      // Ambisonics (mapping family 2 and 3) would need the projection decoder
+      bool isPlainMapping = (
+        (header.mapping_family == 0) ||
+        (header.mapping_family == 1) ||
+        (header.mapping_family == 255)
+      );
+      if(!isPlainMapping) {
+        return false;
+      }
+
+      int errorCode = OPUS_OK;
+      ::OpusMSDecoder *rawDecoder = ::opus_multistream_decoder_create(
+        static_cast<::opus_int32>(sampleRate), header.channel_count,
+        header.stream_count, header.coupled_count, header.mapping, &errorCode
+      );
+      if((rawDecoder == nullptr) || (errorCode != OPUS_OK)) {
+        return false;
+      }
+      reducedRateDecoder.reset(rawDecoder, &::opus_multistream_decoder_destroy);
+
+      int outputGain = getOutputGain();
+      if(outputGain != 0) {
+        ::opus_multistream_decoder_ctl(rawDecoder, OPUS_SET_GAIN(outputGain));
+      }
+      if(this->decoderComplexity.has_value()) {
+        ::opus_multistream_decoder_ctl(
+          rawDecoder, OPUS_SET_COMPLEXITY(this->decoderComplexity.value())
+        );
+      }
+    }
+
+    this->reducedRateDecoder = std::move(reducedRateDecoder);
+    this->decimationFactor = decimationFactor;
+    updateDecodeCallback();
+
+    // Packets libopusfile already decoded stay at the old rate and the new decoder
+    // has no history yet, so decode the pre-roll up to the next frame at the new rate.
+    if(this->frameCursor > 0) {
+      seekFullRate(toDecodeRate(this->frameCursor, decimationFactor) * decimationFactor);
+    }
 
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  std::uint64_t OpusReader::CountTotalFrames() const {
-    return Platform::OpusApi::CountSamples(opusFile);
+  void OpusReader::SetDecodeFidelity(DecodeFidelity fidelity) {
+
+    // As long as nobody asked for anything else, libopus keeps its own default
+    if(!this->decoderComplexity.has_value() && (fidelity == DecodeFidelity::Standard)) {
+      return;
+    }
+
+    int complexity = OpusPacketDecoder::GetDecoderComplexity(fidelity);
+    this->decoderComplexity = complexity;
+    this->configuredDecoder = nullptr;
+    if(static_cast<bool>(this->reducedRateDecoder)) {
+      ::opus_multistream_decoder_ctl(
+        this->reducedRateDecoder.get(), OPUS_SET_COMPLEXITY(complexity)
+      );
+    }
+
+    updateDecodeCallback();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::SetGainOffset(int gainOffset) {
+    Platform::OpusApi::SetGainOffset(this->opusFile, gainOffset);
+    this->gainOffset = gainOffset;
+
+    if(static_cast<bool>(this->reducedRateDecoder)) {
+      ::opus_multistream_decoder_ctl(
+        this->reducedRateDecoder.get(), OPUS_SET_GAIN(getOutputGain())
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OpusReader::CountTotalFrames() {
+    requireSeekable();
+    return toDecodeRate(Platform::OpusApi::CountSamples(opusFile), this->decimationFactor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OpusReader::EstimateTotalFrames() const {
+    if(this->isSeekable) {
+      return toDecodeRate(Platform::OpusApi::CountSamples(opusFile), this->decimationFactor);
+    }
+
+    double fileSize = static_cast<double>(this->file->GetSize());
+
+    // After a second of audio has been decoded, extrapolate from the bytes it took
+    std::uint64_t byteOffset = Platform::OpusApi::TellRaw(this->opusFile);
+    if((this->frameCursor >= FullSampleRate) && (byteOffset > 0)) {
+      return toDecodeRate(
+        static_cast<std::uint64_t>(
+          fileSize * static_cast<double>(this->frameCursor) / static_cast<double>(byteOffset)
+        ),
+        this->decimationFactor
+      );
+    }
+
+    return toDecodeRate(
+      static_cast<std::uint64_t>(
+        fileSize * 8.0 * static_cast<double>(FullSampleRate) /
+        static_cast<double>(FallbackBitRate)
+      ),
+      this->decimationFactor
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusReader::IsFarFromEnd(std::size_t frameCount) const {
+    std::uint64_t fileSize = this->file->GetSize();
+    std::uint64_t byteOffset = Platform::OpusApi::TellRaw(this->opusFile);
+    if(byteOffset >= fileSize) {
+      return false;
+    }
+
+    std::uint64_t maximumByteCount = (
+      (frameCount * this->decimationFactor + MaximumPacketFrameCount) *
+      this->channelCount * MaximumBytesPerChannelSecond / FullSampleRate
+    );
+
+    return (fileSize - byteOffset) > (maximumByteCount + ReadAheadByteCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -167,17 +552,219 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   // ------------------------------------------------------------------------------------------- //
 
   std::uint64_t OpusReader::GetFrameCursorPosition() const {
-    return this->frameCursor;
+    return toDecodeRate(this->frameCursor, this->decimationFactor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::Seek(std::uint64_t frameIndex, bool skipPreRoll /* = false */) {
+    seekFullRate(frameIndex * this->decimationFactor, skipPreRoll);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void OpusReader::Seek(std::uint64_t frameIndex) {
+  void OpusReader::seekFullRate(std::uint64_t frameIndex, bool skipPreRoll /* = false */) {
+    requireSeekable();
+
+    std::uint64_t preRollFrameCount = skipPreRoll ? 0 : PreRollFrameCount;
+
+    // If we have a seek index, jump to the closest indexed page that lies at least
+    // the pre-roll before the target frame and decode forward from there. Granule positions
+    // in Opus include the pre-skip, PCM offsets in libopusfile do not.
+    if(static_cast<bool>(this->seekIndex)) {
+      std::uint64_t granulePosition = (
+        frameIndex + Platform::OpusApi::GetHeader(this->opusFile).pre_skip
+      );
+      if(granulePosition >= preRollFrameCount) {
+        std::optional<Shared::OggSeekIndex::Entry> entry = this->seekIndex->TryFindEntry(
+          granulePosition - preRollFrameCount
+        );
+        if(entry.has_value()) {
+          if(!trySeekVia(entry->ByteOffset, frameIndex, 0).has_value()) {
+            return;
+          }
+        }
+      }
+    }
+
+    // The seek index only covers what has been decoded in order from the beginning.
+    // If we previously decoded near the target, one of our checkpoints will be close.
+    if(frameIndex >= preRollFrameCount) {
+      std::optional<Shared::SeekCheckpointCache::Checkpoint> checkpoint = (
+        this->checkpoints.TryFindCheckpoint(frameIndex - preRollFrameCount)
+      );
+      bool isCloseEnough = (
+        checkpoint.has_value() &&
+        ((frameIndex - checkpoint->FrameIndex) <= MaximumCheckpointDistance)
+      );
+      if(isCloseEnough) {
+        std::optional<std::uint64_t> lateFrameIndex = trySeekVia(
+          checkpoint->ByteOffset, frameIndex, preRollFrameCount
+        );
+        if(!lateFrameIndex.has_value()) {
+          return;
+        }
+
+        // The checkpoint's frame was only a lower bound. Now we know where it
+        // really leads, so correct it for next time.
+        this->checkpoints.Remember(lateFrameIndex.value(), checkpoint->ByteOffset);
+      }
+    }
 
     // CHECK: Could PCM offset mean interleaved sample index or is it a frame index?
+    resetReducedRateDecoder();
     Platform::OpusApi::PcmSeek(this->opusFile, frameIndex);
     this->frameCursor = frameIndex;
+    this->lastCheckpointFrame = frameIndex;
+
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost OpusReader::EstimateSeekCost(
+    std::uint64_t frameIndex, bool skipPreRoll, const Shared::SeekCostEstimator &estimator
+  ) const {
+    std::uint64_t preRollFrameCount = skipPreRoll ? 0 : PreRollFrameCount;
+
+    // The estimator works at the decode rate, the seek index and checkpoints at 48 kHz
+    std::size_t decimationFactor = this->decimationFactor;
+    std::uint64_t targetFrame = frameIndex;
+    frameIndex *= decimationFactor;
+
+    // This follows the same order as Seek(), seek index first, then checkpoints
+    if(static_cast<bool>(this->seekIndex)) {
+      std::uint64_t preSkip = Platform::OpusApi::GetHeader(this->opusFile).pre_skip;
+      std::uint64_t granulePosition = frameIndex + preSkip;
+      if(granulePosition >= preRollFrameCount) {
+        std::optional<Shared::OggSeekIndex::Entry> entry = this->seekIndex->TryFindEntry(
+          granulePosition - preRollFrameCount
+        );
+        if(entry.has_value()) {
+          std::uint64_t landingFrame = (
+            (entry->GranulePosition > preSkip) ? (entry->GranulePosition - preSkip) : 0
+          );
+          return estimator.Jump(landingFrame / decimationFactor, targetFrame);
+        }
+      }
+    }
+
+    if(frameIndex >= preRollFrameCount) {
+      std::optional<Shared::SeekCheckpointCache::Checkpoint> checkpoint = (
+        this->checkpoints.TryFindCheckpoint(frameIndex - preRollFrameCount)
+      );
+      bool isCloseEnough = (
+        checkpoint.has_value() &&
+        ((frameIndex - checkpoint->FrameIndex) <= MaximumCheckpointDistance)
+      );
+      if(isCloseEnough) {
+        return estimator.Jump(checkpoint->FrameIndex / decimationFactor, targetFrame);
+      }
+    }
+
+    // libopusfile bisects the file and always decodes its own 80 ms pre-roll
+    return estimator.Bisect(
+      (frameIndex - std::min(frameIndex, PreRollFrameCount)) / decimationFactor, targetFrame
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
+  Shared::DecoderCheckpoint OpusReader::Checkpoint(std::uint64_t frameIndex) {
+    std::size_t decimationFactor = this->decimationFactor;
+    std::uint64_t targetFrame = frameIndex;
+    frameIndex *= decimationFactor;
+
+    seekFullRate(frameIndex); // also reopens the file for seeking if needed
+
+    // After the seek, libopusfile has read the file about up to the target frame.
+    // Back off from there by the pre-roll plus a few pages' worth of bytes, guessing
+    // from the average bitrate, until we land early enough to decode the pre-roll.
+    std::uint64_t preRollFrameCount = std::min(frameIndex, PreRollFrameCount);
+    std::uint64_t totalFrameCount = Platform::OpusApi::CountSamples(this->opusFile);
+    std::uint64_t bytesPerFrame = (totalFrameCount == 0) ? 1 : (
+      this->file->GetSize() / totalFrameCount + 1
+    );
+    std::uint64_t seekedByteOffset = Platform::OpusApi::TellRaw(this->opusFile);
+    std::uint64_t backoffByteCount = (
+      (preRollFrameCount + CheckpointBackoffFrameCount) * bytesPerFrame
+    );
+    for(std::size_t attempt = 0; attempt < CheckpointAttemptCount; ++attempt) {
+      std::uint64_t byteOffset = (
+        (seekedByteOffset > backoffByteCount) ? (seekedByteOffset - backoffByteCount) : 0
+      );
+      resetReducedRateDecoder();
+      Platform::OpusApi::RawSeek(this->opusFile, byteOffset);
+      std::uint64_t landedFrameIndex = Platform::OpusApi::TellPcm(this->opusFile);
+      if(landedFrameIndex + preRollFrameCount <= frameIndex) {
+        this->frameCursor = landedFrameIndex;
+        this->lastCheckpointFrame = landedFrameIndex;
+        skipFrames(frameIndex - landedFrameIndex);
+        return Shared::DecoderCheckpoint {
+          targetFrame, landedFrameIndex / decimationFactor, byteOffset, true
+        };
+      }
+
+      backoffByteCount *= 4;
+    }
+
+    seekFullRate(frameIndex);
+    return Shared::DecoderCheckpoint { targetFrame, targetFrame, 0, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::Restore(const Shared::DecoderCheckpoint &checkpoint) {
+    requireSeekable();
+
+    // Checkpoints are handed out at the decode rate, the resume frame rounded down
+    if(checkpoint.IsDirect) {
+      std::size_t decimationFactor = this->decimationFactor;
+      resetReducedRateDecoder();
+      Platform::OpusApi::RawSeek(this->opusFile, checkpoint.ByteOffset);
+      std::uint64_t landedFrameIndex = Platform::OpusApi::TellPcm(this->opusFile);
+      if(likely(landedFrameIndex / decimationFactor == checkpoint.ResumeFrameIndex)) {
+        this->frameCursor = landedFrameIndex;
+        this->lastCheckpointFrame = landedFrameIndex;
+        skipFrames(checkpoint.FrameIndex * decimationFactor - landedFrameIndex);
+        return;
+      }
+    }
+
+    Seek(checkpoint.FrameIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<std::uint64_t> OpusReader::trySeekVia(
+    std::uint64_t byteOffset, std::uint64_t frameIndex, std::uint64_t preRollFrameCount
+  ) {
+    resetReducedRateDecoder();
+    Platform::OpusApi::RawSeek(this->opusFile, byteOffset);
+
+    std::uint64_t landedFrameIndex = Platform::OpusApi::TellPcm(this->opusFile);
+    if(unlikely(landedFrameIndex + preRollFrameCount > frameIndex)) {
+      return landedFrameIndex;
+    }
+
+    this->frameCursor = landedFrameIndex;
+    this->lastCheckpointFrame = landedFrameIndex;
+    skipFrames(frameIndex - landedFrameIndex);
+
+    return std::optional<std::uint64_t>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::UseSeekIndex(const std::shared_ptr<Shared::OggSeekIndex> &seekIndex) {
+    this->seekIndex = seekIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::UseStatistics(
+    const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+  ) {
+    this->statistics = statistics;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -213,17 +800,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
       // Decode the audio samples directly into the caller-provided buffer,
       // since we have a perfect match of the audio sample format.
-      std::size_t decodedFrameCount = Platform::OpusApi::ReadFloat(
-        this->opusFile, target, static_cast<int>(frameCount * this->channelCount)
-      );
+      std::size_t decodedFrameCount = readFloat(target, frameCount);
       if(decodedFrameCount == 0) {
         throw Errors::CorruptedFileError(
           u8"Unexpected end of audio stream decoding Opus file. File truncated?"
         );
       }
 
-      this->frameCursor += decodedFrameCount;
-
       target += decodedFrameCount * this->channelCount;
       if(decodedFrameCount > frameCount) {
         assert((frameCount >= decodedFrameCount) && u8"Read stays within buffer bounds");
@@ -232,6 +815,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
       frameCount -= decodedFrameCount;
     }
+
+    extendSeekIndex();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -286,7 +871,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   template<typename TSample>
   void OpusReader::decodeInterleavedAndConvert(TSample *target, std::size_t frameCount) {
-    std::vector<float> decodeBuffer(1020 * this->channelCount);
+    float *decodeBuffer = reinterpret_cast<float *>(this->decodeBuffer.data());
 
     // Keep going until we delivered all requested frames
     while(0 < frameCount) {
@@ -296,10 +881,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       // decoding method in libopusfile does dithering. That's nice for playback,
       // but for this library's output, we don't want one audio format to dither and
       // another to not dither.
-      std::size_t decodedFrameCount = Nuclex::Audio::Platform::OpusApi::ReadFloat(
-        opusFile,
-        decodeBuffer.data(),
-        static_cast<int>(decodeBuffer.size() * this->channelCount)
+      std::size_t decodedFrameCount = readFloat(
+        decodeBuffer, std::min(frameCount, this->decodeChunkFrameCount)
       );
       if(decodedFrameCount == 0) {
         throw Nuclex::Audio::Errors::CorruptedFileError(
@@ -307,12 +890,6 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
         );
       }
 
-      // Decoding was done, the frame cursor inside libopusfile has moved, so update
-      // our frame cursor as well. Even if something goes wrong while handling the samples,
-      // it's important we track where libopusfile currently is so we don't decode
-      // the wrong samples next.
-      this->frameCursor += decodedFrameCount;
-
       // Either convert the decoded floats to doubles or quantize them into integers,
       // depending on the target type. We could just leave it up to SampleConverter::Convert(),
       // but at this point, we know the correct operation at compile time.
@@ -327,7 +904,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
           sizeof(TSample) < 17, float, double
         >::type LimitType;
 
-        const float *source = decodeBuffer.data();
+        const float *source = decodeBuffer;
         LimitType limit = static_cast<LimitType>(
           (std::uint32_t(1) << (sizeof(TSample) * 8 - 1)) - 1
         );
@@ -366,6 +943,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       frameCount -= decodedFrameCount;
 
     } // while frames left to decode
+
+    extendSeekIndex();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -379,17 +958,22 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       std::is_same<TSample, double>::value
     );
 
-    // The channel pointers are in a caller-provided array, if we changed them,
-    // we'd trash the caller's own pointers, so we have to take a copy.
-    std::vector<TSample *> mutableTargets(this->channelCount);
+    // Channels for which the caller passed a null pointer are left out entirely.
+    // The caller's pointers are left untouched, we track how far we've written instead.
+    std::vector<std::size_t> &wantedChannelIndices = this->wantedChannelIndices;
+    wantedChannelIndices.clear();
     for(std::size_t index = 0; index < this->channelCount; ++index) {
-      mutableTargets[index] = targets[index];
+      if(targets[index] != nullptr) {
+        wantedChannelIndices.push_back(index);
+      }
     }
+    const std::size_t wantedChannelCount = wantedChannelIndices.size();
+    std::size_t writtenFrameCount = 0;
 
-    // Allocate an intermedia buffer. In this variant, we use std::byte because
-    // we're going to be decoding into it as float, then quantizing to std::int32_t
-    // in-place and we don't want to break any C++ aliasing rules.
-    std::vector<std::byte> decodeBuffer(1020 * this->channelCount * sizeof(float));
+    // The intermediate buffer is kept as std::byte because we're going to be decoding
+    // into it as float, then quantizing to std::int32_t in-place and we don't want to
+    // break any C++ aliasing rules.
+    std::byte *decodeBuffer = this->decodeBuffer.data();
 
     while(0 < frameCount) {
 
@@ -398,10 +982,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       // decoding method in libopusfile does dithering. That's nice for playback,
       // but for this library's output, we don't want one audio format to dither and
       // another to not dither.
-      std::size_t decodedFrameCount = Nuclex::Audio::Platform::OpusApi::ReadFloat(
-        opusFile,
-        reinterpret_cast<float *>(decodeBuffer.data()),
-        static_cast<int>(decodeBuffer.size() * this->channelCount)
+      std::size_t decodedFrameCount = readFloat(
+        reinterpret_cast<float *>(decodeBuffer), std::min(frameCount, this->decodeChunkFrameCount)
       );
       if(decodedFrameCount == 0) {
         throw Nuclex::Audio::Errors::CorruptedFileError(
@@ -409,11 +991,20 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
         );
       }
 
-      // Decoding was done, the frame cursor inside libopusfile has moved, so update
-      // our frame cursor as well. Even if something goes wrong while handling the samples,
-      // it's important we track where libopusfile currently is so we don't decode
-      // the wrong samples next.
-      frameCursor += decodedFrameCount;
+      // libopusfile always decodes all channels. If the caller skips some of them,
+      // compact the decoded samples to the wanted channels so the conversion below
+      // only touches those. Reading always stays ahead of writing, so this is in-place.
+      if(wantedChannelCount < this->channelCount) {
+        float *decoded = reinterpret_cast<float *>(decodeBuffer);
+        std::size_t writeIndex = 0;
+        for(std::size_t frameIndex = 0; frameIndex < decodedFrameCount; ++frameIndex) {
+          const float *frame = decoded + (frameIndex * this->channelCount);
+          for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+            decoded[writeIndex] = frame[wantedChannelIndices[wantedIndex]];
+            ++writeIndex;
+          }
+        }
+      }
 
       // If the target type is not a floating point type, we need to quantize the values
       // to the range of the integer we're decoding into first
@@ -425,10 +1016,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
         LimitType limit = static_cast<LimitType>(
           (std::uint32_t(1) << (sizeof(TSample) * 8 - 1)) - 1
         );
-        const float *decoded = reinterpret_cast<float *>(decodeBuffer.data());
-        std::int32_t *target = reinterpret_cast<std::int32_t *>(decodeBuffer.data());
+        const float *decoded = reinterpret_cast<float *>(decodeBuffer);
+        std::int32_t *target = reinterpret_cast<std::int32_t *>(decodeBuffer);
 
-        std::size_t sampleCount = decodedFrameCount * this->channelCount;
+        std::size_t sampleCount = decodedFrameCount * wantedChannelCount;
         while(3 < sampleCount) {
           Nuclex::Audio::Processing::Quantization::MultiplyToNearestInt32x4(
             decoded, limit, target
@@ -451,38 +1042,265 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
       // Sort the interleaved samples into each channel buffer. We know that a multiple
       // of the channel count was decoded (since op_read_float() returns the number of
-      // frames), so we can simply run a nested loop to sort this out.
-      {
-        typedef typename std::conditional<
-          targetTypeIsFloat, float, std::int32_t
-        >::type DecodedType;
-        DecodedType *decoded = reinterpret_cast<DecodedType *>(decodeBuffer.data());
-
+      // frames), so there are no partial frames to worry about.
+      typedef typename std::conditional<
+        targetTypeIsFloat, float, std::int32_t
+      >::type DecodedType;
+      DecodedType *decoded = reinterpret_cast<DecodedType *>(decodeBuffer);
+
+      // If the decoded samples already are in the target format, the interleaver
+      // can separate them with its SIMD shuffles
+      constexpr bool decodedIsTargetType = std::is_same<TSample, DecodedType>::value;
+      if(decodedIsTargetType && (wantedChannelCount <= MaximumDeinterleavedChannelCount)) {
+        if constexpr(decodedIsTargetType) {
+          TSample *channelTargets[MaximumDeinterleavedChannelCount];
+          for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+            channelTargets[wantedIndex] = (
+              targets[wantedChannelIndices[wantedIndex]] + writtenFrameCount
+            );
+          }
+          Nuclex::Audio::Processing::Interleaver::Deinterleave(
+            decoded, channelTargets, wantedChannelCount, decodedFrameCount
+          );
+        }
+      } else { // Conversion or too many channels, run a simple nested loop
         std::size_t sampleIndex = 0;
         for(std::size_t frameIndex = 0; frameIndex < decodedFrameCount; ++frameIndex) {
-          for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+          std::size_t targetIndex = writtenFrameCount + frameIndex;
+          for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+            TSample *channelTarget = targets[wantedChannelIndices[wantedIndex]];
             if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-              mutableTargets[channelIndex][frameIndex] = static_cast<TSample>(
-                decoded[sampleIndex] + 128
-              );
+              channelTarget[targetIndex] = static_cast<TSample>(decoded[sampleIndex] + 128);
             } else {
-              mutableTargets[channelIndex][frameIndex] = static_cast<TSample>(
-                decoded[sampleIndex]
-              );
+              channelTarget[targetIndex] = static_cast<TSample>(decoded[sampleIndex]);
             }
             ++sampleIndex;
-          } // for each channel
+          } // for each wanted channel
         } // for each frame
-      } // beauty scope
+      } // if interleaver can be used / samples need to be sorted one by one
 
-      // Advance the target buffer pointers
-      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
-        mutableTargets[channelIndex] += decodedFrameCount;
-      }
+      writtenFrameCount += decodedFrameCount;
 
       frameCount -= decodedFrameCount;
 
     } // while frames left to decode
+
+    extendSeekIndex();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusReader::readFloat(float *target, std::size_t frameCount) {
+    std::size_t decimationFactor = this->decimationFactor;
+    for(;;) {
+      std::size_t decodedFrameCount = Platform::OpusApi::ReadFloat(
+        this->opusFile, target, static_cast<int>(frameCount * this->channelCount)
+      );
+
+      // Decoding was done, the frame cursor inside libopusfile has moved, so update
+      // our frame cursor as well. Even if something goes wrong while handling the samples,
+      // it's important we track where libopusfile currently is so we don't decode
+      // the wrong samples next.
+      std::uint64_t firstFrameIndex = this->frameCursor;
+      this->frameCursor += decodedFrameCount;
+      if(likely(decimationFactor == 1) || (decodedFrameCount == 0)) {
+        return decodedFrameCount;
+      }
+
+      // Keep every frame that sits on the reduced rate's grid. The frames kept so far
+      // never reach the frame being read, so the buffer is compacted in-place.
+      std::size_t remainder = static_cast<std::size_t>(firstFrameIndex % decimationFactor);
+      std::size_t frameIndex = (remainder == 0) ? 0 : (decimationFactor - remainder);
+      std::size_t keptFrameCount = 0;
+      while(frameIndex < decodedFrameCount) {
+        if(keptFrameCount != frameIndex) {
+          std::copy_n(
+            target + frameIndex * this->channelCount,
+            this->channelCount,
+            target + keptFrameCount * this->channelCount
+          );
+        }
+        ++keptFrameCount;
+        frameIndex += decimationFactor;
+      }
+
+      // A short read may not have touched any frame on the grid, just read more then
+      if(keptFrameCount > 0) {
+        return keptFrameCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  int OpusReader::decodePacket(
+    void *context, ::OpusMSDecoder *decoder, void *pcm, const ::ogg_packet *packet,
+    int sampleCount, int channelCount, int format, int
+  ) {
+    OpusReader &reader = *static_cast<OpusReader *>(context);
+
+    // libopusfile creates its decoder when it opens the stream, so the complexity
+    // can only be applied here. Our pointer is cleared whenever the file is swapped.
+    if(reader.decoderComplexity.has_value() && (decoder != reader.configuredDecoder)) {
+      ::opus_multistream_decoder_ctl(
+        decoder, OPUS_SET_COMPLEXITY(reader.decoderComplexity.value())
+      );
+      reader.configuredDecoder = decoder;
+    }
+
+    // The reader always decodes to floats, anything else is left to libopusfile
+    if((format != OP_DEC_FORMAT_FLOAT) || (reader.decimationFactor == 1)) {
+      return OP_DEC_USE_DEFAULT;
+    }
+
+    // Decode the packet into the end of the buffer, then repeat each decoded frame
+    // for as many 48 kHz frames as it stands for. Writing starts at the front and never
+    // overtakes reading, so the frames can be spread out in-place.
+    int decimationFactor = static_cast<int>(reader.decimationFactor);
+    int reducedSampleCount = sampleCount / decimationFactor;
+    float *samples = static_cast<float *>(pcm);
+    float *reducedSamples = samples + (
+      static_cast<std::size_t>(sampleCount - reducedSampleCount) * channelCount
+    );
+
+    int decodedSampleCount = ::opus_multistream_decode_float(
+      reader.reducedRateDecoder.get(),
+      packet->packet, static_cast<::opus_int32>(packet->bytes),
+      reducedSamples, reducedSampleCount, 0
+    );
+    if(unlikely(decodedSampleCount < 0)) {
+      return decodedSampleCount;
+    }
+    if(unlikely(decodedSampleCount != reducedSampleCount)) {
+      return OPUS_INVALID_PACKET;
+    }
+
+    for(int frameIndex = 0; frameIndex < sampleCount; ++frameIndex) {
+      const float *source = reducedSamples + (
+        static_cast<std::size_t>(frameIndex / decimationFactor) * channelCount
+      );
+      float *target = samples + static_cast<std::size_t>(frameIndex) * channelCount;
+      if(target != source) {
+        std::copy_n(source, channelCount, target);
+      }
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  int OpusReader::getOutputGain() const {
+    const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
+
+    // Same limits libopusfile applies, libopus rejects gains outside of 16 bits
+    return std::clamp(header.output_gain + this->gainOffset, -32768, 32767);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::updateDecodeCallback() {
+    bool needsCallback = (
+      static_cast<bool>(this->reducedRateDecoder) || this->decoderComplexity.has_value()
+    );
+    if(needsCallback) {
+      Platform::OpusApi::SetDecodeCallback(this->opusFile, &decodePacket, this);
+    } else {
+      Platform::OpusApi::SetDecodeCallback(this->opusFile, nullptr, nullptr);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::resetReducedRateDecoder() {
+    if(static_cast<bool>(this->reducedRateDecoder)) {
+      ::opus_multistream_decoder_ctl(this->reducedRateDecoder.get(), OPUS_RESET_STATE);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::skipFrames(std::uint64_t frameCount) {
+    if(static_cast<bool>(this->statistics)) {
+      this->statistics->AddDiscardedFrames(frameCount / this->decimationFactor);
+    }
+
+    float *decodeBuffer = reinterpret_cast<float *>(this->decodeBuffer.data());
+
+    while(0 < frameCount) {
+      std::size_t decodedFrameCount = Platform::OpusApi::ReadFloat(
+        this->opusFile,
+        decodeBuffer,
+        static_cast<int>(
+          std::min<std::uint64_t>(frameCount, this->decodeChunkFrameCount) * this->channelCount
+        )
+      );
+      if(decodedFrameCount == 0) {
+        throw Errors::CorruptedFileError(
+          u8"Unexpected end of audio stream skipping to seek target in Opus file."
+        );
+      }
+
+      this->frameCursor += decodedFrameCount;
+      frameCount -= decodedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::extendSeekIndex() {
+    std::uint64_t byteOffset = Platform::OpusApi::TellRaw(this->opusFile);
+    if(static_cast<bool>(this->seekIndex)) {
+      this->seekIndex->ScanBehindDecoder(*this->file, byteOffset);
+    }
+
+    // libopusfile has read everything up to this offset, so when we jump here later,
+    // the first page it finds begins at the current frame or a bit after it.
+    if(this->frameCursor >= this->lastCheckpointFrame + CheckpointIntervalFrameCount) {
+      this->checkpoints.Remember(this->frameCursor, byteOffset);
+      this->lastCheckpointFrame = this->frameCursor;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusReader::requireSeekable() {
+    if(likely(this->isSeekable)) {
+      return;
+    }
+
+    // Closing an OggOpusFile resets the file in its adapter state, so the seekable
+    // one needs its own adapter state until the previous OggOpusFile has been released.
+    std::unique_ptr<ReadOnlyFileAdapterState> newState = (
+      FileAdapterFactory::CreateAdapterForReading(this->file, this->fileCallbacks, true)
+    );
+    std::shared_ptr<::OggOpusFile> newOpusFile = Platform::OpusApi::OpenFromCallbacks(
+      newState->Error,
+      newState.get(),
+      &fileCallbacks
+    );
+    FileAdapterState::RethrowPotentialException(*newState);
+
+    std::size_t linkCount = Platform::OpusApi::CountLinks(newOpusFile);
+    if(linkCount != 1) {
+      throw std::runtime_error(u8"Multi-link Opus files are not supported");
+    }
+
+    this->opusFile = std::move(newOpusFile);
+    this->state = std::move(newState);
+    this->isSeekable = true;
+    this->configuredDecoder = nullptr;
+    if(this->gainOffset != 0) {
+      Platform::OpusApi::SetGainOffset(this->opusFile, this->gainOffset);
+    }
+    updateDecodeCallback();
+
+    // The seekable file starts at the beginning again, return to where we were
+    if(this->frameCursor > 0) {
+      seekFullRate(this->frameCursor);
+    } else {
+      resetReducedRateDecoder();
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -25,10 +25,16 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
 #include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Storage/DecodeFidelity.h" // for DecodeFidelity
+#include "../Shared/SeekCheckpointCache.h" // for SeekCheckpointCache
+#include "../Shared/DecoderCheckpoint.h" // for DecoderCheckpoint
+#include "../Shared/SeekCostEstimator.h" // for SeekCostEstimator
 
 #include <cstddef> // for std::size_t
 #include <cstdint> // for std::uint64_t
 #include <memory> // for std::unique_ptr
+#include <optional> // for std::optional
 #include <vector> // for std::vector
 
 #include <opusfile.h>
@@ -53,6 +59,23 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
 }}} // namespace Nuclex::Audio::Storage
 
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class OggSeekIndex;
+  class DecoderStatisticsCollector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
 namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
@@ -72,18 +95,89 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
     /// <summary>Initializes a new Opus reader on the specified file</summary>
     /// <param name="file">File the reader will access</param>
-    public: OpusReader(const std::shared_ptr<const VirtualFile> &file);
+    /// <param name="deferLengthScan">
+    ///   Whether to open the file without letting libopusfile seek. It then only reads
+    ///   the headers, skipping the look at the end of the file that determines its length.
+    ///   The file is reopened for seeking once a seek or the exact length is requested.
+    /// </param>
+    public: OpusReader(
+      const std::shared_ptr<const VirtualFile> &file, bool deferLengthScan = false
+    );
 
     /// <summary>Frees all resources owned by the Opus reader</summary>
     public: ~OpusReader();
 
+    /// <summary>Switches the reader over to another Opus file</summary>
+    /// <param name="file">File the reader will access from now on</param>
+    /// <remarks>
+    ///   libopusfile has no way to reuse an opened stream, so a new one is opened, but
+    ///   the reader's scratch buffers and checkpoint cache are kept. If the new file
+    ///   can't be opened, the reader stays on the previous file. Seek indices are
+    ///   dropped and need to be provided again via <see cref="UseSeekIndex" />.
+    ///   If the reader was told to defer the length scan, it does so for the new file, too.
+    ///   The decode rate goes back to 48 kHz.
+    /// </remarks>
+    public: void Reopen(const std::shared_ptr<const VirtualFile> &file);
+
     /// <summary>Reads the metadata from an Opus audi ofile</summary>
     /// <param name="target">Track information container that will receive the metadata</param>
-    public: void ReadMetadata(TrackInfo &target);
+    /// <param name="includeTags">
+    ///   Whether to look through the comments for loop points. Decoders don't expose
+    ///   the track information and pass false to skip that work when opening.
+    /// </param>
+    public: void ReadMetadata(TrackInfo &target, bool includeTags = true);
+
+    /// <summary>Lets libopus decode at a lower internal sample rate</summary>
+    /// <param name="sampleRate">
+    ///   Rate at which audio should be decoded, 8000, 12000, 16000, 24000 or 48000
+    /// </param>
+    /// <returns>True if the reader will decode at the requested rate from now on</returns>
+    /// <remarks>
+    ///   libopus can skip the upper frequency bands when decoding at a lower rate, which
+    ///   makes decoding cheaper. All frame counts and positions the reader takes and reports
+    ///   are at the chosen rate afterwards. Ambisonic streams always decode at 48 kHz.
+    /// </remarks>
+    public: bool TrySetDecodeSampleRate(std::size_t sampleRate);
+
+    /// <summary>Sets the libopus decoder complexity matching a fidelity level</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <remarks>
+    ///   libopusfile doesn't expose its decoder, so the complexity is applied from
+    ///   the decode callback the first time libopusfile hands out a new decoder.
+    /// </remarks>
+    public: void SetDecodeFidelity(DecodeFidelity fidelity);
+
+    /// <summary>Sets a gain that is applied on top of the header's output gain</summary>
+    /// <param name="gainOffset">Additional gain in 1/256 dB (Q7.8 format)</param>
+    /// <remarks>
+    ///   libopus scales its output by the combined gain while it synthesizes samples,
+    ///   so this costs nothing during decoding. The gain stays set if the reader is
+    ///   reopened or switches to a lower decode rate.
+    /// </remarks>
+    public: void SetGainOffset(int gainOffset);
 
     /// <summary>Counts the total number of frames (= samples in each channel)</summary>
     /// <returns>The total number of frames in the audio file</returns>
-    public: std::uint64_t CountTotalFrames() const;
+    /// <remarks>
+    ///   If the reader was opened without seeking, this reopens the file for seeking.
+    /// </remarks>
+    public: std::uint64_t CountTotalFrames();
+
+    /// <summary>Checks whether the exact number of frames is known already</summary>
+    /// <returns>True if <see cref="CountTotalFrames" /> would not touch the file</returns>
+    public: bool IsTotalFrameCountKnown() const { return this->isSeekable; }
+
+    /// <summary>Guesses the total number of frames without reading more of the file</summary>
+    /// <returns>The exact number of frames if known, otherwise an estimate</returns>
+    public: std::uint64_t EstimateTotalFrames() const;
+
+    /// <summary>Checks whether decoding can surely go on without reaching the end</summary>
+    /// <param name="frameCount">Number of frames that would be decoded</param>
+    /// <returns>
+    ///   True if more of the file remains than the frames could take up at the highest
+    ///   bit rate Opus supports, false if they might reach the end of the stream
+    /// </returns>
+    public: bool IsFarFromEnd(std::size_t frameCount) const;
 
     /// <summary>Gets the order in which interlaved samples are decoded</summary>
     /// <returns>A list of channels in the order they are interleaved</returns>
@@ -95,7 +189,48 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
     /// <summary>Moves the frame cursor to the specified location</summary>
     /// <param name="frameIndex">Index of the frame that should be decoded next</param>
-    public: void Seek(std::uint64_t frameIndex);
+    /// <param name="skipPreRoll">
+    ///   Whether to resume decoding right at the closest known page before the frame
+    ///   instead of 80 ms earlier. This saves decoding the pre-roll, but the first few
+    ///   milliseconds after the seek may be slightly off.
+    /// </param>
+    public: void Seek(std::uint64_t frameIndex, bool skipPreRoll = false);
+
+    /// <summary>Estimates how much work moving the frame cursor would be</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <param name="skipPreRoll">Whether the seek would skip the pre-roll</param>
+    /// <param name="estimator">Estimator that turns the chosen strategy into a cost</param>
+    /// <returns>The estimated cost of a call to <see cref="Seek" /></returns>
+    public: SeekCost EstimateSeekCost(
+      std::uint64_t frameIndex, bool skipPreRoll, const Shared::SeekCostEstimator &estimator
+    ) const;
+
+    /// <summary>Moves the frame cursor to a frame and records how to return there</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <returns>A checkpoint through which the reader can quickly return to the frame</returns>
+    /// <remarks>
+    ///   The checkpoint always includes the full pre-roll, so restoring it produces
+    ///   exactly the same output as decoding through to the frame.
+    /// </remarks>
+    public: Shared::DecoderCheckpoint Checkpoint(std::uint64_t frameIndex);
+
+    /// <summary>Moves the frame cursor back to a checkpoint's frame</summary>
+    /// <param name="checkpoint">Checkpoint previously returned by Checkpoint()</param>
+    public: void Restore(const Shared::DecoderCheckpoint &checkpoint);
+
+    /// <summary>Lets the reader use and extend a seek index for the file</summary>
+    /// <param name="seekIndex">Seek index the reader will use when seeking</param>
+    /// <remarks>
+    ///   The seek index may be shared between multiple readers on the same file.
+    ///   Readers will extend it while they decode sequentially through the file.
+    /// </remarks>
+    public: void UseSeekIndex(const std::shared_ptr<Shared::OggSeekIndex> &seekIndex);
+
+    /// <summary>Lets the reader report discarded frames to a statistics collector</summary>
+    /// <param name="statistics">Collector that will track the discarded frames</param>
+    public: void UseStatistics(
+      const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+    );
 
     /// <summary>Decodes samples from the audio file in interleaved format</summary>
     /// <typename name="TSample">Type of samples that will be decoded</typename>
@@ -135,6 +270,80 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     private: template<typename TSample>
     void decodeInterleavedConvertAndSeparate(TSample *targets[], std::size_t frameCount);
 
+    /// <summary>Decodes frames at the chosen decode rate into a buffer</summary>
+    /// <param name="target">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Number of frames at 48 kHz the buffer can hold</param>
+    /// <returns>The number of frames that were written into the buffer</returns>
+    /// <remarks>
+    ///   At reduced decode rates, libopusfile still hands out frames at 48 kHz with each
+    ///   decoded frame repeated. This keeps only the frames that fall on the reduced rate.
+    /// </remarks>
+    private: std::size_t readFloat(float *target, std::size_t frameCount);
+
+    /// <summary>Moves the frame cursor to the specified location at 48 kHz</summary>
+    /// <param name="frameIndex">Index of the 48 kHz frame that should be decoded next</param>
+    /// <param name="skipPreRoll">Whether to resume decoding without the pre-roll</param>
+    private: void seekFullRate(std::uint64_t frameIndex, bool skipPreRoll = false);
+
+    /// <summary>Configures and possibly replaces libopusfile's packet decoding</summary>
+    /// <param name="context">Opus reader that installed the callback</param>
+    /// <param name="decoder">libopusfile's own decoder</param>
+    /// <param name="pcm">Buffer that receives the decoded samples at 48 kHz</param>
+    /// <param name="packet">Opus packet that should be decoded</param>
+    /// <param name="sampleCount">Number of 48 kHz frames the packet decodes to</param>
+    /// <param name="channelCount">Number of channels to decode</param>
+    /// <param name="format">Sample format libopusfile wants the samples in</param>
+    /// <param name="linkIndex">Index of the link the packet belongs to</param>
+    /// <returns>
+    ///   0 on success, a negative libopus error code or OP_DEC_USE_DEFAULT to let
+    ///   libopusfile decode the packet itself
+    /// </returns>
+    private: static int decodePacket(
+      void *context, ::OpusMSDecoder *decoder, void *pcm, const ::ogg_packet *packet,
+      int sampleCount, int channelCount, int format, int linkIndex
+    );
+
+    /// <summary>Installs or removes the decode callback as the settings require</summary>
+    private: void updateDecodeCallback();
+
+    /// <summary>Calculates the gain the reduced rate decoder has to apply</summary>
+    /// <returns>The header's output gain plus the gain offset, in 1/256 dB</returns>
+    private: int getOutputGain() const;
+
+    /// <summary>Clears the history of the reduced rate decoder before a jump</summary>
+    private: void resetReducedRateDecoder();
+
+    /// <summary>Decodes and discards the specified number of frames</summary>
+    /// <param name="frameCount">Number of frames that will be skipped</param>
+    private: void skipFrames(std::uint64_t frameCount);
+
+    /// <summary>Jumps to a file offset and decodes forward up to the specified frame</summary>
+    /// <param name="byteOffset">Offset in the file at which decoding will resume</param>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <param name="preRollFrameCount">
+    ///   Number of frames that should be decoded before the target frame at least
+    /// </param>
+    /// <returns>
+    ///   The frame the reader landed on if it was too late to reach the target with
+    ///   the required pre-roll, in which case the reader's position is undefined
+    /// </returns>
+    private: std::optional<std::uint64_t> trySeekVia(
+      std::uint64_t byteOffset, std::uint64_t frameIndex, std::uint64_t preRollFrameCount
+    );
+
+    /// <summary>Extends the seek index up to the decoder's current read position</summary>
+    /// <remarks>
+    ///   This also records a seek checkpoint every now and then, which helps when
+    ///   decoding through regions the seek index doesn't cover.
+    /// </remarks>
+    private: void extendSeekIndex();
+
+    /// <summary>Reopens the file with seeking enabled if it was opened without</summary>
+    /// <remarks>
+    ///   The reader's frame cursor, checkpoints and seek index are kept.
+    /// </remarks>
+    private: void requireSeekable();
+
     /// <summary>File the reader is accessing</summary>
     private: std::shared_ptr<const VirtualFile> file; // TOOD: Can this be removed?
     /// <summary>Holds the function pointers to the file I/O functions</summary>
@@ -147,11 +356,48 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     private: std::unique_ptr<ReadOnlyFileAdapterState> state;
     /// <summary>Manages the decoder state of the opened Opus file</summary>
     private: std::shared_ptr<::OggOpusFile> opusFile;
+    /// <summary>Whether files are first opened without seeking</summary>
+    private: bool defersLengthScan;
+    /// <summary>Whether libopusfile was allowed to seek when the file was opened</summary>
+    private: bool isSeekable;
 
     /// <summary>Number of channels in the Opus file</summary>
     private: std::size_t channelCount;
-    /// <summary>Index of the audio frame that will be decoded next</summary>
+    /// <summary>Number of 48 kHz frames per frame at the chosen decode rate</summary>
+    private: std::size_t decimationFactor;
+    /// <summary>Decoder running at the reduced rate, empty when decoding at 48 kHz</summary>
+    private: std::shared_ptr<::OpusMSDecoder> reducedRateDecoder;
+    /// <summary>Complexity libopus should decode at, empty to leave it alone</summary>
+    private: std::optional<int> decoderComplexity;
+    /// <summary>Gain in 1/256 dB applied on top of the header's output gain</summary>
+    private: int gainOffset;
+    /// <summary>libopusfile decoder the complexity was last applied to</summary>
+    private: ::OpusMSDecoder *configuredDecoder;
+    /// <summary>Index of the audio frame at 48 kHz that will be decoded next</summary>
     private: std::uint64_t frameCursor;
+    /// <summary>Seek index used to jump close to a frame, may be empty</summary>
+    private: std::shared_ptr<Shared::OggSeekIndex> seekIndex;
+    /// <summary>Collects statistics about the reader's work, may be empty</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
+    /// <summary>Recently visited points at which decoding can resume</summary>
+    private: Shared::SeekCheckpointCache checkpoints;
+    /// <summary>Frame cursor position at which the last checkpoint was recorded</summary>
+    private: std::uint64_t lastCheckpointFrame;
+    /// <summary>Number of frames that are decoded per call into libopusfile</summary>
+    /// <remarks>
+    ///   libopusfile buffers whole packets internally and hands them out in pieces if
+    ///   the buffer is smaller than a packet, so this only affects the call granularity
+    ///   and how much of the decoded audio stays in the cache for conversion.
+    /// </remarks>
+    private: std::size_t decodeChunkFrameCount;
+    /// <summary>Scratch memory libopusfile decodes into before samples are converted</summary>
+    /// <remarks>
+    ///   Allocated once when the file is opened so decoding calls never allocate.
+    ///   Kept as std::byte because samples get quantized to integers in-place.
+    /// </remarks>
+    private: SampleVector<std::byte> decodeBuffer;
+    /// <summary>Indices of the channels the caller wants in a separated decode</summary>
+    private: std::vector<std::size_t> wantedChannelIndices;
 
   };
 
@@ -0,0 +1,102 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OpusSequentialDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "../../Platform/OpusApi.h" // for the wrapped Opus API methods
+#include "../Shared/ChannelOrderFactory.h"
+
+#include <algorithm> // for std::min()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OpusSequentialDecoder::OpusSequentialDecoder(
+    const std::shared_ptr<SequentialSource> &source
+  ) :
+    state(),
+    fileCallbacks(),
+    opusFile(),
+    channelCount(0),
+    channelOrder(),
+    cursor(0) {
+    this->state = FileAdapterFactory::CreateAdapterForSequentialReading(
+      source, this->fileCallbacks
+    );
+    this->opusFile = Platform::OpusApi::OpenFromCallbacks(
+      this->state->Error, this->state.get(), &this->fileCallbacks
+    );
+    FileAdapterState::RethrowPotentialException(*this->state);
+
+    const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
+    this->channelCount = static_cast<std::size_t>(header.channel_count);
+    this->channelOrder = Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(
+      header.mapping_family, this->channelCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OpusSequentialDecoder::~OpusSequentialDecoder() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusSequentialDecoder::DecodeInterleaved(float *buffer, std::size_t frameCount) {
+    if(frameCount == 0) {
+      return 0;
+    }
+
+    // libopusfile delivers interleaved floats into our buffer, it only needs to know
+    // how many samples fit. It returns the number of frames it decoded.
+    std::size_t sampleCount = std::min<std::size_t>(
+      frameCount * this->channelCount, std::numeric_limits<int>::max()
+    );
+    int linkIndex = -1;
+    std::size_t decodedFrameCount = Platform::OpusApi::ReadFloat(
+      this->opusFile, buffer, static_cast<int>(sampleCount), linkIndex
+    );
+    FileAdapterState::RethrowPotentialException(*this->state);
+    if(decodedFrameCount == 0) {
+      return 0;
+    }
+
+    // A chained stream may continue with a link that has a different channel count,
+    // libopusfile would then deliver its samples with a different interleaving.
+    const ::OpusHead &header = Platform::OpusApi::GetHeader(this->opusFile);
+    if(static_cast<std::size_t>(header.channel_count) != this->channelCount) {
+      throw std::runtime_error(u8"Chained Opus stream changed its channel count");
+    }
+    this->cursor += decodedFrameCount;
+
+    return decodedFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -0,0 +1,103 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_OPUS_OPUSSEQUENTIALDECODER_H
+#define NUCLEX_AUDIO_STORAGE_OPUS_OPUSSEQUENTIALDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "./OpusVirtualFileAdapter.h" // for SequentialSourceAdapterState
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes an Ogg Opus stream front to back from a sequential source</summary>
+  /// <remarks>
+  ///   libopusfile treats a stream without seek and tell callbacks as unseekable and
+  ///   decodes pages as they arrive, still trimming the pre-skip at the start. Opus
+  ///   always decodes at 48 kHz. The number of frames is never known up front and
+  ///   chained streams are decoded as long as the channel count stays the same.
+  /// </remarks>
+  class OpusSequentialDecoder : public SequentialTrackDecoder {
+
+    /// <summary>Initializes a new sequential Opus decoder reading from a source</summary>
+    /// <param name="source">Source from which the Ogg Opus stream will be read</param>
+    public: OpusSequentialDecoder(const std::shared_ptr<SequentialSource> &source);
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~OpusSequentialDecoder() override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override { return this->channelCount; }
+
+    /// <summary>Produces the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the number of samples per second in each channel</summary>
+    /// <returns>The sample rate of the audio track, always 48000 for Opus</returns>
+    public: std::size_t GetSampleRate() const override { return 48000; }
+
+    /// <summary>Returns the number of frames in the track if it is known</summary>
+    /// <returns>Nothing, unseekable Opus streams don't reveal their length</returns>
+    public: std::optional<std::uint64_t> TryCountFrames() const override {
+      return std::optional<std::uint64_t>();
+    }
+
+    /// <summary>Returns the number of frames that have been delivered so far</summary>
+    /// <returns>The index of the frame that will be delivered next</returns>
+    public: std::uint64_t GetFrameCursorPosition() const override { return this->cursor; }
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of audio frames that should be delivered</param>
+    /// <returns>The number of frames delivered, zero at the end of the track</returns>
+    public: std::size_t DecodeInterleaved(float *buffer, std::size_t frameCount) override;
+
+    /// <summary>Adapter through which libopusfile reads from the sequential source</summary>
+    private: std::unique_ptr<SequentialSourceAdapterState> state;
+    /// <summary>Callbacks libopusfile uses to read from the adapter</summary>
+    private: ::OpusFileCallbacks fileCallbacks;
+    /// <summary>Opus stream opened by libopusfile</summary>
+    private: std::shared_ptr<::OggOpusFile> opusFile;
+    /// <summary>Number of audio channels in the track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Order in which the channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Index of the next frame that will be delivered</summary>
+    private: std::uint64_t cursor;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#endif // NUCLEX_AUDIO_STORAGE_OPUS_OPUSSEQUENTIALDECODER_H
@@ -26,14 +26,65 @@ limitations under the License.
 
 #include "Nuclex/Audio/Processing/SampleConverter.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Storage/VirtualFile.h"
 
 #include "./OpusReader.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+#include "./OpusDetection.h" // for Detection
+#include "../Shared/OggSeekIndex.h" // for OggSeekIndex
+#include "../Shared/DecodePathBuilder.h"
+#include "../Shared/SeekCostEstimator.h"
+#include "../Shared/OggPageVerifier.h" // for OggPageVerifier
+#include "../Shared/GainTagParser.h" // for GainTagParser
 
 #include <cassert> // for assert()
+#include <cmath> // for std::lround()
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames in an Opus packet encoded with the default settings</summary>
+  /// <remarks>
+  ///   Opus decodes at 48 kHz by default and the reference encoder produces 20 ms packets.
+  ///   Packets of other durations are allowed, but the file does not tell.
+  /// </remarks>
+  const std::size_t NominalPacketFrameCount = 960;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rate at which Opus granule positions count, regardless of input rate</summary>
+  const std::uint64_t GranuleRate = 48000;
+
+  /// <summary>Value the total frame count has while it hasn't been looked up</summary>
+  const std::uint64_t UnknownFrameCount = std::uint64_t(-1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the gain libopus should apply on top of the header gain</summary>
+  /// <param name="replayGain">ReplayGain informations found in the file, if any</param>
+  /// <param name="mode">Which of the stored gains should be applied</param>
+  /// <returns>The gain in 1/256 dB, the unit libopus uses</returns>
+  int getGainOffset(
+    const std::optional<Nuclex::Audio::ReplayGainInfo> &replayGain,
+    Nuclex::Audio::Storage::ReplayGainMode mode
+  ) {
+    using Nuclex::Audio::Storage::Shared::GainTagParser;
+    return static_cast<int>(
+      std::lround(GainTagParser::GetGainDecibels(replayGain, mode) * 256.0f)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Distance, in milliseconds, between entries in the seek index</summary>
+  /// <remarks>
+  ///   With one entry every half second, the index stays around 110 KiB per hour of
+  ///   audio and a seek never has to decode forward through more than a few pages.
+  /// </remarks>
+  const std::uint64_t SeekIndexIntervalMilliseconds = 500;
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -43,19 +94,77 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   // ------------------------------------------------------------------------------------------- //
 
   OpusTrackDecoder::OpusTrackDecoder(const std::shared_ptr<const VirtualFile> &file) :
-    reader(file),
+    file(file),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(Shared::TrackedCodec::Opus)
+    ),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, file), true),
     trackInfo(),
     channelOrder(),
-    totalFrameCount(std::uint64_t(-1)),
+    fidelity(DecodeFidelity::Standard),
+    replayGainMode(ReplayGainMode::Off),
+    totalFrameCount(UnknownFrameCount),
+    blockSize(0),
+    seekIndex(),
+    fastSeeking(std::make_shared<std::atomic<bool>>(false)),
+    checkpoints(),
+    verifier(),
     decodingMutex() {
 
-    this->reader.ReadMetadata(this->trackInfo);
+    this->reader.ReadMetadata(this->trackInfo, false);
 
     // Opus uses the same custom channel order as Vorbis, which the OpusReader will
     // correctly determine for us here
     this->channelOrder = this->reader.GetChannelOrder();
 
-    this->totalFrameCount = this->reader.CountTotalFrames();
+    // The total frame count is looked up only when needed. The reader was opened without
+    // seeking, so libopusfile hasn't gone to the end of the file to find it either.
+    this->blockSize = NominalPacketFrameCount;
+
+    // Ogg has no index, so set up our own. It starts out empty and is filled while
+    // decoding sequentially or when the user asks for it to be built.
+    this->seekIndex = std::make_shared<Shared::OggSeekIndex>(
+      file->GetSize(), GranuleRate * SeekIndexIntervalMilliseconds / 1000
+    );
+    this->reader.UseSeekIndex(this->seekIndex);
+    this->reader.UseStatistics(this->statistics);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OpusTrackDecoder::OpusTrackDecoder(const OpusTrackDecoder &other) :
+    file(other.file),
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(
+      Shared::TrackedCodec::Opus, other.statistics->IsEnabled()
+    )),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, other.file)),
+    trackInfo(other.trackInfo),
+    channelOrder(other.channelOrder),
+    fidelity(other.fidelity),
+    replayGainMode(other.replayGainMode),
+    totalFrameCount(other.totalFrameCount.load(std::memory_order_acquire)),
+    blockSize(other.blockSize),
+    seekIndex(other.seekIndex),
+    fastSeeking(other.fastSeeking),
+    checkpoints(),
+    verifier(other.verifier),
+    decodingMutex() {
+
+    this->reader.UseSeekIndex(this->seekIndex);
+    this->reader.UseStatistics(this->statistics);
+    if(this->trackInfo.SampleRate != GranuleRate) {
+      this->reader.TrySetDecodeSampleRate(this->trackInfo.SampleRate);
+    }
+    this->reader.SetDecodeFidelity(this->fidelity);
+    if(this->replayGainMode != ReplayGainMode::Off) {
+      this->reader.SetGainOffset(getGainOffset(this->trackInfo.ReplayGain, this->replayGainMode));
+    }
+
+    // Clones are made to decode in parallel, so they seek anyway. Their reader opened
+    // the file for seeking and found the length for free.
+    if(this->totalFrameCount.load(std::memory_order_relaxed) == UnknownFrameCount) {
+      this->totalFrameCount.store(this->reader.CountTotalFrames(), std::memory_order_release);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -65,7 +174,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<AudioTrackDecoder> OpusTrackDecoder::Clone() const {
-    throw std::runtime_error(u8"Not implemented yet");
+    AllocationScope cloneScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+    return std::shared_ptr<AudioTrackDecoder>(new OpusTrackDecoder(*this));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -82,8 +192,104 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool OpusTrackDecoder::TrySetDecodeSampleRate(std::size_t sampleRate) {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    if(!this->reader.TrySetDecodeSampleRate(sampleRate)) {
+      return false;
+    }
+
+    // All frame counts and positions are at the new rate from here on. A frame count
+    // provided by the caller was for the old rate, so only keep one the reader knows.
+    this->trackInfo = TrackInfo();
+    this->reader.ReadMetadata(this->trackInfo, false);
+    this->blockSize = NominalPacketFrameCount * sampleRate / GranuleRate;
+    if(this->reader.IsTotalFrameCountKnown()) {
+      this->totalFrameCount.store(this->reader.CountTotalFrames(), std::memory_order_release);
+    } else {
+      this->totalFrameCount.store(UnknownFrameCount, std::memory_order_release);
+    }
+    this->checkpoints.Clear();
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusTrackDecoder::TrySetDecodeFidelity(DecodeFidelity fidelity) {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    this->reader.SetDecodeFidelity(fidelity);
+    this->fidelity = fidelity;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusTrackDecoder::TrySetReplayGain(ReplayGainMode mode) {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    this->reader.SetGainOffset(getGainOffset(this->trackInfo.ReplayGain, mode));
+    this->replayGainMode = mode;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusTrackDecoder::TrySetVerificationPolicy(VerificationPolicy policy) {
+    if(policy == VerificationPolicy::Off) {
+      this->verifier.reset();
+    } else {
+      std::shared_ptr<const VirtualFile> verifiedFile = this->file;
+      this->verifier = std::make_shared<Shared::IntegrityVerifier>(
+        policy,
+        [verifiedFile](const CancellationToken &cancellation) {
+          return Shared::OggPageVerifier::VerifyPages(*verifiedFile, cancellation);
+        }
+      );
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult OpusTrackDecoder::GetVerificationResult() const {
+    if(static_cast<bool>(this->verifier)) {
+      return this->verifier->GetResult();
+    } else {
+      return VerificationResult::NotChecked;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t OpusTrackDecoder::CountFrames() const {
-    return this->totalFrameCount;
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(likely(totalFrameCount != UnknownFrameCount)) {
+      return totalFrameCount;
+    }
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    return resolveTotalFrameCount();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t OpusTrackDecoder::EstimateFrameCount() const {
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(likely(totalFrameCount != UnknownFrameCount)) {
+      return totalFrameCount;
+    }
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    return this->reader.EstimateTotalFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackDecoder::ProvideFrameCount(std::uint64_t frameCount) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    if(this->totalFrameCount.load(std::memory_order_relaxed) == UnknownFrameCount) {
+      this->totalFrameCount.store(frameCount, std::memory_order_release);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -100,18 +306,199 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void OpusTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics OpusTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram OpusTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath OpusTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    using Shared::DecodePathBuilder;
+
+    sampleFormat = DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    std::string inlineKernelSet = DecodePathBuilder::GetInlineKernelSetName();
+
+    DecodePathBuilder builder(u8"Opus", AudioSampleFormat::Float_32, u8"interleaved");
+
+    // Interleaved floats are decoded by libopusfile straight into the caller's buffer,
+    // everything else is decoded into the decode buffer and converted from there
+    if(interleaved && (sampleFormat == AudioSampleFormat::Float_32)) {
+      builder.AddPass(u8"decode");
+      return builder.GetPath();
+    }
+    builder.AddScratchBuffer().AddPass(u8"decode");
+
+    bool targetTypeIsFloat = DecodePathBuilder::IsFloatingPoint(sampleFormat);
+    if(interleaved) {
+      if(targetTypeIsFloat) {
+        builder.AddPass(u8"cast");
+      } else {
+        builder.AddPass(u8"Quantize " + inlineKernelSet);
+      }
+      return builder.GetPath();
+    }
+
+    // Separated integers are quantized in-place, then sorted into the channels.
+    // The interleaver can only do the sorting if no further conversion is needed.
+    if(!targetTypeIsFloat) {
+      builder.AddPass(u8"Quantize " + inlineKernelSet);
+    }
+    bool canDeinterleave = (
+      (this->trackInfo.ChannelCount <= 8) && ( // same limit as in the reader
+        (sampleFormat == AudioSampleFormat::Float_32) ||
+        (sampleFormat == AudioSampleFormat::SignedInteger_32)
+      )
+    );
+    if(canDeinterleave) {
+      builder.AddPass(u8"Deinterleave " + inlineKernelSet);
+    } else {
+      builder.AddPass(u8"separate");
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost OpusTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_relaxed);
+    if(totalFrameCount == UnknownFrameCount) {
+      totalFrameCount = this->reader.EstimateTotalFrames();
+    }
+
+    Shared::SeekCostEstimator estimator(
+      this->file->GetSize(), totalFrameCount, this->blockSize
+    );
+    if(this->reader.GetFrameCursorPosition() == targetFrame) {
+      return estimator.Continue();
+    }
+
+    // Mirror seekTo(), the reader knows which of its own seek strategies it would use
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(targetFrame);
+    if((checkpoint != nullptr) && checkpoint->IsDirect) {
+      return estimator.Jump(checkpoint->ResumeFrameIndex, targetFrame);
+    }
+
+    return this->reader.EstimateSeekCost(
+      targetFrame, this->fastSeeking->load(std::memory_order_relaxed), estimator
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OpusTrackDecoder::GetNominalBlockSize() const {
+    return this->blockSize; // Packet durations can vary, but libopus defaults to 20 ms
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackDecoder::BuildSeekIndex() const {
+    this->seekIndex->ScanUntil(*this->file, this->file->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> OpusTrackDecoder::SaveSeekIndex() const {
+    return this->seekIndex->Serialize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackDecoder::LoadSeekIndex(
+    const std::vector<std::byte> &serializedSeekIndex
+  ) const {
+    this->seekIndex->Deserialize(serializedSeekIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackDecoder::AllowFastSeeking(bool allow) const {
+    this->fastSeeking->store(allow, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusTrackDecoder::TryReopen(const std::shared_ptr<const VirtualFile> &file) {
+    if(!Detection::CheckIfOpusHeaderPresentLite(*file)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    AllocationScope reopenScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
+    // If this throws, the reader still has the previous file open and
+    // none of the decoder's own fields have been touched yet either
+    this->reader.Reopen(Shared::DecoderStatisticsCollector::CountReads(this->statistics, file));
+    this->file = file;
+
+    // The reader goes back to 48 kHz, ask it to keep decoding at the chosen rate
+    if(this->trackInfo.SampleRate != GranuleRate) {
+      this->reader.TrySetDecodeSampleRate(this->trackInfo.SampleRate);
+    }
+
+    this->trackInfo = TrackInfo();
+    this->reader.ReadMetadata(this->trackInfo, false);
+    this->blockSize = NominalPacketFrameCount * this->trackInfo.SampleRate / GranuleRate;
+    this->channelOrder = this->reader.GetChannelOrder();
+
+    // The reader kept the old file's gain, the new file may store a different one
+    if(this->replayGainMode != ReplayGainMode::Off) {
+      this->reader.SetGainOffset(getGainOffset(this->trackInfo.ReplayGain, this->replayGainMode));
+    }
+    this->totalFrameCount.store(UnknownFrameCount, std::memory_order_release);
+
+    // Clones made earlier share the seek index and fast seeking flag with us
+    // and still decode the old file, so these have to be replaced, not reset
+    this->seekIndex = std::make_shared<Shared::OggSeekIndex>(
+      file->GetSize(), GranuleRate * SeekIndexIntervalMilliseconds / 1000
+    );
+    this->reader.UseSeekIndex(this->seekIndex);
+    this->fastSeeking = std::make_shared<std::atomic<bool>>(
+      this->fastSeeking->load(std::memory_order_relaxed)
+    );
+    this->checkpoints.Clear();
+
+    // Verification results of the old file stay with the clones still reading it
+    if(static_cast<bool>(this->verifier)) {
+      TrySetVerificationPolicy(this->verifier->GetPolicy());
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void OpusTrackDecoder::DecodeInterleavedUint8(
     std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -127,12 +514,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -148,12 +538,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -169,12 +562,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -190,12 +586,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -211,12 +610,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -232,12 +634,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -253,12 +658,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -274,12 +682,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -295,12 +706,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Opus", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -310,22 +724,71 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void OpusTrackDecoder::seekTo(std::uint64_t startFrame) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Seek Opus", this->file.get(), this);
+    this->statistics->AddSeek();
+
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(startFrame);
+    if(checkpoint != nullptr) {
+      NUCLEX_AUDIO_TRACE_MARK(u8"Restore Opus checkpoint", this->file.get(), this);
+      this->reader.Restore(*checkpoint);
+    } else if(this->checkpoints.NoteSeek(startFrame)) {
+      this->checkpoints.AddCheckpoint(this->reader.Checkpoint(startFrame));
+    } else {
+      this->reader.Seek(startFrame, this->fastSeeking->load(std::memory_order_relaxed));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void OpusTrackDecoder::verifyDecodeRange(
     const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
     if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
       throw std::logic_error(u8"Unable to decode this many samples in one call");
     }
-    if(startFrame >= this->totalFrameCount) {
+
+    // Until the length has been looked up, sequential decoding that can't possibly reach
+    // the end of the stream goes ahead unchecked. That way, playing from the start only
+    // makes the reader look at the end of the file when it's about to get there anyway.
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(unlikely(totalFrameCount == UnknownFrameCount)) {
+      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+      bool canSkipCheck = (
+        !this->reader.IsTotalFrameCountKnown() &&
+        (this->reader.GetFrameCursorPosition() == startFrame) &&
+        this->reader.IsFarFromEnd(frameCount)
+      );
+      if(canSkipCheck) {
+        return;
+      }
+
+      totalFrameCount = resolveTotalFrameCount();
+    }
+
+    if(startFrame >= totalFrameCount) {
       throw std::out_of_range(u8"Start sample index is out of bounds");
     }
-    if(this->totalFrameCount < startFrame + frameCount) {
+    if(totalFrameCount < startFrame + frameCount) {
       throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::uint64_t OpusTrackDecoder::resolveTotalFrameCount() const {
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_relaxed);
+    if(totalFrameCount == UnknownFrameCount) {
+      totalFrameCount = this->reader.CountTotalFrames();
+      this->totalFrameCount.store(totalFrameCount, std::memory_order_release);
+    }
+
+    return totalFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Opus
 
 #endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -27,7 +27,10 @@ limitations under the License.
 #include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
 #include "Nuclex/Audio/TrackInfo.h"
 #include "./OpusReader.h"
+#include "../Shared/DecoderStatisticsCollector.h"
+#include "../Shared/IntegrityVerifier.h"
 
+#include <atomic> // for std::atomic
 #include <mutex> // for std::mutex
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
@@ -43,6 +46,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <summary>Frees all resources owned by the instance</summary>
     public: ~OpusTrackDecoder() override;
 
+    /// <summary>Initializes a new track decoder as a clone of another</summary>
+    /// <param name="other">Track decoder that will be cloned</param>
+    /// <remarks>
+    ///   The clone shares the file and the metadata already extracted from it with
+    ///   the original track decoder, but has its own reader and codec state.
+    /// </remarks>
+    private: OpusTrackDecoder(const OpusTrackDecoder &other);
+
     /// <summary>Creates a clone of the audio track decoder</summary>
     /// <returns>A clone of the audio track decoder that can be used independently</returns>
     public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
@@ -55,10 +66,42 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <returns>A list of single channels in the order they're interleaved</returns>
     public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
 
+    /// <summary>Lets libopus decode at a lower internal sample rate</summary>
+    /// <param name="sampleRate">8000, 12000, 16000, 24000 or 48000 samples per second</param>
+    /// <returns>True if the decoder will deliver audio at the requested rate</returns>
+    public: bool TrySetDecodeSampleRate(std::size_t sampleRate) override;
+
+    /// <summary>Sets the libopus decoder complexity matching a fidelity level</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <returns>Always true, libopus versions before 1.5 simply ignore it</returns>
+    public: bool TrySetDecodeFidelity(DecodeFidelity fidelity) override;
+
+    /// <summary>Folds the file's ReplayGain into the libopus output gain</summary>
+    /// <param name="mode">Whether to apply the track gain, the album gain or neither</param>
+    /// <returns>Always true, files without gain tags simply decode unchanged</returns>
+    public: bool TrySetReplayGain(ReplayGainMode mode) override;
+
+    /// <summary>Attempts to make the decoder verify the checksums stored in its file</summary>
+    /// <param name="policy">Whether to verify and whether to do it in the background</param>
+    /// <returns>True if the decoder will verify its file as requested</returns>
+    public: bool TrySetVerificationPolicy(VerificationPolicy policy) override;
+
+    /// <summary>Reports the outcome of the checksum verification</summary>
+    /// <returns>The current state of the verification</returns>
+    public: VerificationResult GetVerificationResult() const override;
+
     /// <summary>Returns the number of frames (sample count in any one channel)</summary>
     /// <returns>The number of frames the audio file is long</returns>
     public: std::uint64_t CountFrames() const override;
 
+    /// <summary>Guesses the number of frames without reading more of the file</summary>
+    /// <returns>The exact number of frames if known, otherwise an estimate</returns>
+    public: std::uint64_t EstimateFrameCount() const override;
+
+    /// <summary>Tells the decoder the number of frames if it was determined before</summary>
+    /// <param name="frameCount">Number of frames in the decoded track</param>
+    public: void ProvideFrameCount(std::uint64_t frameCount) const override;
+
     /// <summary>Returns the format in which samples are obtained from the codec</summary>
     /// <returns>The format in which the audio samples are delivered by the codec</returns>
     public: AudioSampleFormat GetNativeSampleFormat() const override;
@@ -67,6 +110,58 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <returns>True if the codec decodes straight to interleaved channels</summary>
     public: bool IsNativelyInterleaved() const override;
 
+    /// <summary>Returns the number of frames in a typical block of the codec</summary>
+    /// <returns>The nominal number of frames in one of the codec's blocks</returns>
+    protected: std::size_t GetNominalBlockSize() const override;
+
+    /// <summary>Builds the complete seek index by scanning the whole file</summary>
+    public: void BuildSeekIndex() const override;
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override;
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override;
+
+    /// <summary>Lets seeks skip the 80 ms pre-roll Opus needs for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override;
+
+    /// <summary>Switches the decoder over to another Opus file</summary>
+    /// <param name="file">File the decoder should decode from now on</param>
+    /// <returns>True if the decoder now decodes the new file</returns>
+    public: bool TryReopen(const std::shared_ptr<const VirtualFile> &file) override;
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override;
+
+    /// <summary>Retrieves the statistics the decoder has collected so far</summary>
+    /// <returns>The current values of the decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override;
+
+    /// <summary>Retrieves the distribution of the decoder's decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each decoding call took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override;
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
     // The public variant of the DecoeInterleaved() method delegates to our implementations
     public: using AudioTrackDecoder::DecodeInterleaved;
 
@@ -155,6 +250,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
     ) const override;
 
+    /// <summary>Moves the reader's frame cursor to the specified frame</summary>
+    /// <param name="startFrame">Frame the reader should decode next</param>
+    /// <remarks>
+    ///   Frames that are sought to repeatedly, such as loop points, get a checkpoint
+    ///   that lets the reader return to them without searching through the file.
+    /// </remarks>
+    private: void seekTo(std::uint64_t startFrame) const;
+
     /// <summary>Throws an exception if the decoding range is out of bounds</summary>
     /// <param name="startFrame">Index of the first frame to decode</param>
     /// <param name="frameCount">Number of audio frames that will be decoded</param>
@@ -162,19 +265,44 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       const std::uint64_t startFrame, const std::size_t frameCount
     ) const;
 
+    /// <summary>Looks up the exact number of frames if it isn't known yet</summary>
+    /// <returns>The total number of frames in the Opus stream</returns>
+    /// <remarks>
+    ///   The decoding mutex must be held by the caller.
+    /// </remarks>
+    private: std::uint64_t resolveTotalFrameCount() const;
+
+    /// <summary>File the audio track is being decoded from</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Counts frames, seeks, bytes read and decoding time if enabled</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
     /// <summary>Reader through which the audio file will be decoded</summary>
     private: mutable OpusReader reader;
     /// <summary>Informations about the audio track being decoded</summary>
     private: TrackInfo trackInfo;
     /// <summary>Order in which audio channels appear</summary>
     private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Fidelity the reader was set to, clones inherit it</summary>
+    private: DecodeFidelity fidelity;
+    /// <summary>ReplayGain mode the reader was set to, clones inherit it</summary>
+    private: ReplayGainMode replayGainMode;
     /// <summary>Total number of frames in the Opus file</summary>
     /// <remarks>
-    ///   This can be unknown if the Opus file is being streamed, was truncated and
-    ///   perhaps some other cases, but this library is designed for usage with plain
-    ///   and complete Opus files, at most wrapped in a media container or archive.
+    ///   Stays at std::uint64_t(-1) until someone asks for it or it is provided, because
+    ///   finding it means reading the end of the file. Only written with the decoding
+    ///   mutex held, but read without it.
     /// </remarks>
-    private: std::uint64_t totalFrameCount;
+    private: mutable std::atomic<std::uint64_t> totalFrameCount;
+    /// <summary>Number of frames in a typical block of the Opus stream</summary>
+    private: std::size_t blockSize;
+    /// <summary>Index of Ogg pages, shared with all clones of the decoder</summary>
+    private: std::shared_ptr<Shared::OggSeekIndex> seekIndex;
+    /// <summary>Whether seeks may skip the pre-roll, shared with all clones</summary>
+    private: std::shared_ptr<std::atomic<bool>> fastSeeking;
+    /// <summary>Checkpoints for frames the decoder keeps seeking back to</summary>
+    private: mutable Shared::DecoderCheckpointCache checkpoints;
+    /// <summary>Verifies the file's checksums if a verification policy is set</summary>
+    private: std::shared_ptr<const Shared::IntegrityVerifier> verifier;
     /// <summary>Must be held while decoding</summary>
     private: mutable std::mutex decodingMutex;
 
@@ -24,15 +24,34 @@ limitations under the License.
 
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
 #include "Nuclex/Audio/Processing/SampleConverter.h"
-#include "../Shared/ChannelOrderFactory.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "./OpusChannelMapping.h"
+#include "../Shared/ChannelOrderTransformer.h"
 #include "../../Platform/OpusEncoderApi.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
 
+#include <algorithm> // for std::min(), std::max()
 #include <cassert> // for assert()
+#include <chrono> // for std::chrono::steady_clock
+#include <type_traits> // for std::is_same
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames that are converted for the encoder in one go</summary>
+  const std::size_t ConversionFrameCount = 4096;
+
+  /// <summary>Frame durations in milliseconds a CPU budget may switch between</summary>
+  const std::vector<float> GovernedFrameDurations = { 20.0f, 40.0f, 60.0f };
+
+  /// <summary>Opus frame size constants matching the governed frame durations</summary>
+  const int GovernedFrameSizes[] = {
+    OPUS_FRAMESIZE_20_MS, OPUS_FRAMESIZE_40_MS, OPUS_FRAMESIZE_60_MS
+  };
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -47,56 +66,53 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     std::size_t sampleRate
   ) :
     inputChannelOrder(inputChannelOrder),
-    isVorbisChannelOrder(false),
+    isEncoderChannelOrder(false),
+    channelRemapper(),
+    convertedSamples(),
+    floatChunk(),
+    integerChunk(),
     encoderCallbacks(),
     state(),
     opusComments(),
-    opusEncoder() {
+    opusEncoder(),
+    sampleRate(sampleRate),
+    kilobitsPerSecond(0.0f),
+    complexity(Shared::EncoderCpuGovernor::MaximumComplexity),
+    governor() {
 
     this->state = FileAdapterFactory::CreateAdapterForWriting(
       target, this->encoderCallbacks
     );
 
     this->opusComments = Platform::OpusEncoderApi::CreateComments();
+    createOpusEncoder();
 
-    this->opusEncoder = Platform::OpusEncoderApi::CreateFromCallbacks(
-      this->state.get(),
-      &this->encoderCallbacks,
-      sampleRate,
-      this->inputChannelOrder.size(),
-      this->opusComments
-    );
-
-    // This decides the latency and complexity the encoder uses. Since this library
-    // doesn't care about streaming, we pick 'Audio' for best quality.
-    Platform::OpusEncoderApi::ControlEncoder(
-      this->opusEncoder, OPUS_SET_APPLICATION_REQUEST, OPUS_APPLICATION_AUDIO
-    );
-
-    // Use 48000 Hz, maximum bandwidth for Opus. 
-    Platform::OpusEncoderApi::ControlEncoder(
-      this->opusEncoder, OPUS_SET_BANDWIDTH_REQUEST, OPUS_BANDWIDTH_FULLBAND
-    );
+    // Speaker layouts go into the Vorbis families, channels without placements are
+    // stored either as an ambisonic sound field or as discrete channels
+    int mappingFamily = OpusChannelMapping::SelectMappingFamily(this->inputChannelOrder);
 
-    #if 0
-    // I assume this always picks CELT (Opus is a hybrid encoder combining SILK for
-    // speech and CELT for more coplex audio). The encoder should be able to detect
-    // the correct type from packet to packet, but there are some reports of sudden
-    // audible quality changes when it switches, so for high-bandwidth, high-quality
-    // encoding, forcing CELT only might be sensible? Unclear.
-    Platform::OpusEncoderApi::ControlEncoder(
-      this->opusEncoder, OPUS_SET_SIGNAL_REQUEST, OPUS_SIGNAL_MUSIC
-    );
-    #endif
-
-    // Finally, check if the channel order matches the Vorbis channel order.
+    // Finally, check if the channel order matches the order of the mapping family.
     // If it's identical, it means we can feed interleaved float samples directly
-    // to the Opus encoder without having to re-weave the channels.
+    // to the Opus encoder without having to re-weave the channels. Ambisonic and
+    // discrete channels have no placements and are always taken in input order.
     std::size_t channelCount = this->inputChannelOrder.size();
-    std::vector<ChannelPlacement> vorbisChannelOrder = (
-      Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(1, channelCount)
+    std::vector<ChannelPlacement> encoderChannelOrder = (
+      OpusChannelMapping::GetChannelOrder(mappingFamily, channelCount)
     );
-    this->isVorbisChannelOrder = (this->inputChannelOrder == vorbisChannelOrder);
+    this->isEncoderChannelOrder = (this->inputChannelOrder == encoderChannelOrder);
+    if(this->isEncoderChannelOrder) {
+      std::vector<std::size_t> inputChannelIndices(channelCount);
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        inputChannelIndices[index] = index;
+      }
+      this->channelRemapper = Shared::ChannelRemapper(inputChannelIndices);
+    } else {
+      this->channelRemapper = Shared::ChannelRemapper(
+        Shared::ChannelOrderTransformer::CreateRemappingTable(
+          this->inputChannelOrder, encoderChannelOrder
+        )
+      );
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -114,6 +130,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       this->opusEncoder,
       OPUS_SET_BITRATE_REQUEST, static_cast<int>(kilobitsPerSecond * 1000.0f)
     );
+    this->kilobitsPerSecond = kilobitsPerSecond;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -126,6 +143,26 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       this->opusEncoder,
       OPUS_SET_COMPLEXITY_REQUEST, effortInt
     );
+    this->complexity = static_cast<std::size_t>(effortInt);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackEncoder::SetCpuBudget(const EncoderCpuBudget &budget) {
+    this->governor.emplace(
+      budget, this->sampleRate, this->complexity, this->kilobitsPerSecond,
+      GovernedFrameDurations
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<EncoderCpuMetrics> OpusTrackEncoder::GetCpuMetrics() const {
+    if(this->governor.has_value()) {
+      return this->governor.value().GetMetrics();
+    } else {
+      return std::optional<EncoderCpuMetrics>();
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -136,9 +173,57 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::uint64_t OpusTrackEncoder::CountWrittenBytes() const {
+    return this->state->File->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void OpusTrackEncoder::Flush() {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Flush Opus", this->state->File.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
     Platform::OpusEncoderApi::Drain(this->opusEncoder);
     FileAdapterState::RethrowPotentialException(*state);
+
+    // The virtual file may be collecting writes in a buffer, make sure they get written
+    if(static_cast<bool>(this->state->File)) {
+      this->state->File->Flush();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OpusTrackEncoder::Reopen(const std::shared_ptr<VirtualFile> &target) {
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
+    // Chaining a new stream via libopusenc would still be writing the final pages
+    // of the old stream into the old file while the new one is being encoded, so
+    // the old encoder is destroyed and a new one writes through the same adapter.
+    this->opusEncoder.reset();
+
+    this->state->FileCursor = 0;
+    this->state->Error = std::exception_ptr();
+    this->state->File = target;
+
+    createOpusEncoder();
+
+    // A governed encoder continues with the settings the governor arrived at, so
+    // a batch of short clips doesn't start over at full effort with each clip
+    if(this->governor.has_value()) {
+      applyGovernedSettings();
+    } else {
+      Platform::OpusEncoderApi::ControlEncoder(
+        this->opusEncoder,
+        OPUS_SET_BITRATE_REQUEST, static_cast<int>(this->kilobitsPerSecond * 1000.0f)
+      );
+      Platform::OpusEncoderApi::ControlEncoder(
+        this->opusEncoder,
+        OPUS_SET_COMPLEXITY_REQUEST, static_cast<int>(this->complexity)
+      );
+    }
+
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -170,14 +255,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   void OpusTrackEncoder::EncodeInterleavedFloat(
     const float *buffer, std::size_t frameCount
   ) {
-    if(this->isVorbisChannelOrder) {
-      Platform::OpusEncoderApi::WriteFloats(
-        this->opusEncoder, buffer, frameCount
-      );
-      FileAdapterState::RethrowPotentialException(*state);
-    } else {
-      encodeInterleaved(buffer, frameCount);
-    }
+    encodeInterleaved(buffer, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -234,16 +312,94 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   void OpusTrackEncoder::encodeInterleaved(
     const TSample *buffer, std::size_t frameCount
   ) {
-    constexpr bool samplesAreFloatingPoint = (
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Opus", this->state->File.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
+    std::chrono::steady_clock::time_point startTime;
+    if(this->governor.has_value()) {
+      startTime = std::chrono::steady_clock::now();
+    }
+    std::size_t totalFrameCount = frameCount;
+
+    constexpr bool isNativeSampleType = (
       std::is_same<TSample, float>::value ||
-      std::is_same<TSample, double>::value
+      std::is_same<TSample, std::int16_t>::value
     );
-    if constexpr(samplesAreFloatingPoint) {
-      //std::vector<float> convertedSamples(frameCount * this->inputChannelOrder.size()) {
-      //}
+
+    // libopusenc accepts interleaved floats and 16-bit integers directly, so if
+    // the channels need no reordering, there's nothing to do on our side
+    if constexpr(isNativeSampleType) {
+      if(this->isEncoderChannelOrder) {
+        if constexpr(std::is_same<TSample, float>::value) {
+          Platform::OpusEncoderApi::WriteFloats(this->opusEncoder, buffer, frameCount);
+        } else {
+          Platform::OpusEncoderApi::WriteIntegers(this->opusEncoder, buffer, frameCount);
+        }
+        FileAdapterState::RethrowPotentialException(*state);
+        if(this->governor.has_value()) {
+          governEncodeTime(startTime, totalFrameCount);
+        }
+        return;
+      }
+    }
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+
+      if constexpr(std::is_same<TSample, std::int16_t>::value) {
+        if(this->integerChunk.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->integerChunk.resize(ConversionFrameCount * channelCount);
+        }
+        remapInterleaved(buffer, this->integerChunk.data(), chunkFrameCount);
+        Platform::OpusEncoderApi::WriteIntegers(
+          this->opusEncoder, this->integerChunk.data(), chunkFrameCount
+        );
+      } else {
+        if(this->floatChunk.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->floatChunk.resize(ConversionFrameCount * channelCount);
+        }
+
+        // Floats only need to be reordered. Other formats are converted first,
+        // straight into the chunk if their channel order already fits.
+        if constexpr(std::is_same<TSample, float>::value) {
+          remapInterleaved(buffer, this->floatChunk.data(), chunkFrameCount);
+        } else if(this->isEncoderChannelOrder) {
+          Processing::SampleConverter::Convert(
+            buffer, sizeof(TSample) * 8,
+            this->floatChunk.data(), 32,
+            chunkFrameCount * channelCount
+          );
+        } else {
+          if(this->convertedSamples.empty()) {
+            AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+            this->convertedSamples.resize(ConversionFrameCount * channelCount);
+          }
+          Processing::SampleConverter::Convert(
+            buffer, sizeof(TSample) * 8,
+            this->convertedSamples.data(), 32,
+            chunkFrameCount * channelCount
+          );
+          remapInterleaved(
+            this->convertedSamples.data(), this->floatChunk.data(), chunkFrameCount
+          );
+        }
+
+        Platform::OpusEncoderApi::WriteFloats(
+          this->opusEncoder, this->floatChunk.data(), chunkFrameCount
+        );
+      }
+      FileAdapterState::RethrowPotentialException(*state);
+
+      buffer += chunkFrameCount * channelCount;
+      frameCount -= chunkFrameCount;
     }
 
-    throw std::runtime_error(u8"Not implemented yet");
+    if(this->governor.has_value()) {
+      governEncodeTime(startTime, totalFrameCount);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -252,7 +408,184 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   void OpusTrackEncoder::encodeSeparated(
     const TSample *buffers[], std::size_t frameCount
   ) {
-    throw std::runtime_error(u8"Not implemented yet");
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Opus", this->state->File.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
+    std::chrono::steady_clock::time_point startTime;
+    if(this->governor.has_value()) {
+      startTime = std::chrono::steady_clock::now();
+    }
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+
+    std::size_t offset = 0;
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+
+      // Floats and 16-bit integers are interleaved straight into the chunk buffer,
+      // other formats are converted channel by channel first
+      if constexpr(std::is_same<TSample, std::int16_t>::value) {
+        if(this->integerChunk.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->integerChunk.resize(ConversionFrameCount * channelCount);
+        }
+        remapSeparated(buffers, offset, this->integerChunk.data(), chunkFrameCount);
+        Platform::OpusEncoderApi::WriteIntegers(
+          this->opusEncoder, this->integerChunk.data(), chunkFrameCount
+        );
+      } else {
+        if(this->floatChunk.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->floatChunk.resize(ConversionFrameCount * channelCount);
+        }
+
+        if constexpr(std::is_same<TSample, float>::value) {
+          remapSeparated(buffers, offset, this->floatChunk.data(), chunkFrameCount);
+        } else {
+          if(this->convertedSamples.empty()) {
+            AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+            this->convertedSamples.resize(ConversionFrameCount * channelCount);
+          }
+
+          // Convert each channel into its own section of the conversion buffer,
+          // then interleave those sections like any other separated channels.
+          // Opus streams can't hold more than 255 channels, so this array will do.
+          assert((channelCount <= 255) && u8"Opus streams have at most 255 channels");
+          float *channels[255];
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            channels[channelIndex] = (
+              this->convertedSamples.data() + (channelIndex * ConversionFrameCount)
+            );
+            Processing::SampleConverter::Convert(
+              buffers[channelIndex] + offset, sizeof(TSample) * 8,
+              channels[channelIndex], 32,
+              chunkFrameCount
+            );
+          }
+          remapSeparated(channels, 0, this->floatChunk.data(), chunkFrameCount);
+        }
+
+        Platform::OpusEncoderApi::WriteFloats(
+          this->opusEncoder, this->floatChunk.data(), chunkFrameCount
+        );
+      }
+      FileAdapterState::RethrowPotentialException(*state);
+
+      offset += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+
+    if(this->governor.has_value()) {
+      governEncodeTime(startTime, offset);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackEncoder::governEncodeTime(
+    std::chrono::steady_clock::time_point startTime, std::size_t frameCount
+  ) {
+    std::chrono::nanoseconds encodeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - startTime
+    );
+
+    if(this->governor.value().Record(encodeTime, frameCount)) {
+      applyGovernedSettings();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackEncoder::createOpusEncoder() {
+
+    // Speaker layouts go into the Vorbis families, channels without placements are
+    // stored either as an ambisonic sound field or as discrete channels
+    int mappingFamily = OpusChannelMapping::SelectMappingFamily(this->inputChannelOrder);
+
+    this->opusEncoder = Platform::OpusEncoderApi::CreateFromCallbacks(
+      this->state.get(),
+      &this->encoderCallbacks,
+      this->sampleRate,
+      this->inputChannelOrder.size(),
+      mappingFamily,
+      this->opusComments
+    );
+
+    // This decides the latency and complexity the encoder uses. Since this library
+    // doesn't care about streaming, we pick 'Audio' for best quality.
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder, OPUS_SET_APPLICATION_REQUEST, OPUS_APPLICATION_AUDIO
+    );
+
+    // Use 48000 Hz, maximum bandwidth for Opus. 
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder, OPUS_SET_BANDWIDTH_REQUEST, OPUS_BANDWIDTH_FULLBAND
+    );
+
+    #if 0
+    // I assume this always picks CELT (Opus is a hybrid encoder combining SILK for
+    // speech and CELT for more coplex audio). The encoder should be able to detect
+    // the correct type from packet to packet, but there are some reports of sudden
+    // audible quality changes when it switches, so for high-bandwidth, high-quality
+    // encoding, forcing CELT only might be sensible? Unclear.
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder, OPUS_SET_SIGNAL_REQUEST, OPUS_SIGNAL_MUSIC
+    );
+    #endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OpusTrackEncoder::applyGovernedSettings() {
+    const Shared::EncoderCpuGovernor &cpuGovernor = this->governor.value();
+
+    // The Opus encoder picks up all of these between two frames, so they can
+    // be changed in the middle of a stream without any seams in the audio
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder,
+      OPUS_SET_COMPLEXITY_REQUEST, static_cast<int>(cpuGovernor.GetComplexity())
+    );
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder,
+      OPUS_SET_BITRATE_REQUEST, static_cast<int>(cpuGovernor.GetKilobitsPerSecond() * 1000.0f)
+    );
+    Platform::OpusEncoderApi::ControlEncoder(
+      this->opusEncoder,
+      OPUS_SET_EXPERT_FRAME_DURATION_REQUEST,
+      GovernedFrameSizes[cpuGovernor.GetFrameDurationIndex()]
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void OpusTrackEncoder::remapInterleaved(
+    const TSample *source, TSample *target, std::size_t frameCount
+  ) {
+    // The remapper copies if the orders match and has specialized kernels for
+    // the usual WaveformatExtensible to Vorbis reorderings
+    this->channelRemapper.RemapInterleaved(source, target, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void OpusTrackEncoder::remapSeparated(
+    const TSample *const sources[], std::size_t offset,
+    TSample *target, std::size_t frameCount
+  ) {
+    std::size_t channelCount = this->inputChannelOrder.size();
+    const std::vector<std::size_t> &inputChannelIndices = (
+      this->channelRemapper.GetInputChannelLookup()
+    );
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      const TSample *source = sources[inputChannelIndices[channelIndex]] + offset;
+      TSample *channelTarget = target + channelIndex;
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        *channelTarget = source[frameIndex];
+        channelTarget += channelCount;
+      }
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
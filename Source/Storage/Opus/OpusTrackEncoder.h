@@ -22,8 +22,14 @@ limitations under the License.
 
 #include "Nuclex/Audio/Config.h"
 #include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
 
 #include "./OpusVirtualFileAdapter.h"
+#include "../Shared/ChannelRemapper.h"
+#include "../Shared/EncoderCpuGovernor.h"
+
+#include <chrono> // for std::chrono::steady_clock
+#include <optional> // for std::optional
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
@@ -73,9 +79,35 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// </remarks>
     public: void SetEffort(float effort);
 
+    /// <summary>Lets the encoder adjust its settings to stay within a CPU budget</summary>
+    /// <param name="budget">Budget and the settings the encoder may give up to meet it</param>
+    /// <remarks>
+    ///   Must be called after <see cref="SetBitrate" /> and <see cref="SetEffort" />,
+    ///   their values are the highest settings the encoder will use.
+    /// </remarks>
+    public: void SetCpuBudget(const EncoderCpuBudget &budget);
+
+    /// <summary>Reports the settings and cost of an encoder running on a CPU budget</summary>
+    /// <returns>The current settings and measured cost, if the encoder has a budget</returns>
+    public: std::optional<EncoderCpuMetrics> GetCpuMetrics() const override;
+
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: std::uint64_t CountWrittenBytes() const override;
+
     /// <summary>Flushes any audio samples remaining in the buffer</summary>
     public: void Flush() override;
 
+    /// <summary>Starts a new Opus stream in another output file</summary>
+    /// <param name="target">File into which the encoder will write from now on</param>
+    /// <returns>Always true, the encoder can always start a new stream</returns>
+    /// <remarks>
+    ///   A drained libopusenc encoder can't be started over, so it is the one thing that
+    ///   is rebuilt. The adapter state, comments, channel mapping and conversion buffers
+    ///   are all kept, as are the settings a CPU budget has settled on.
+    /// </remarks>
+    protected: bool Reopen(const std::shared_ptr<VirtualFile> &target) override;
+
     /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
     /// <param name="buffer">Buffer holding the samples that will be encoded</param>
     /// <param name="frameCount">Number of audio frames that will be encoded</param>
@@ -160,13 +192,59 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     template<typename TSample>
     void encodeSeparated(const TSample *buffers[], std::size_t frameCount);
 
+    /// <summary>Creates the libopusenc encoder writing through the adapter state</summary>
+    private: void createOpusEncoder();
+
+    /// <summary>Applies the settings the CPU governor decided on to the encoder</summary>
+    private: void applyGovernedSettings();
+
+    /// <summary>Tells the governor how long encoding took and applies its decisions</summary>
+    /// <param name="startTime">Time at which encoding of the block began</param>
+    /// <param name="frameCount">Number of frames that were encoded</param>
+    private: void governEncodeTime(
+      std::chrono::steady_clock::time_point startTime, std::size_t frameCount
+    );
+
+    /// <summary>Reorders interleaved samples from the input into the encoder's order</summary>
+    /// <typeparam name="TSample">Type of samples that will be reordered</typeparam>
+    /// <param name="source">Interleaved samples in the input channel order</param>
+    /// <param name="target">Receives the interleaved samples in encoder channel order</param>
+    /// <param name="frameCount">Number of audio frames that will be reordered</param>
+    private: template<typename TSample>
+    void remapInterleaved(const TSample *source, TSample *target, std::size_t frameCount);
+
+    /// <summary>Interleaves separated channels from the input in encoder channel order</summary>
+    /// <typeparam name="TSample">Type of samples that will be interleaved</typeparam>
+    /// <param name="sources">Channels in the input channel order</param>
+    /// <param name="offset">Index of the first frame to take from each channel</param>
+    /// <param name="target">Receives the interleaved samples in encoder channel order</param>
+    /// <param name="frameCount">Number of audio frames that will be interleaved</param>
+    private: template<typename TSample>
+    void remapSeparated(
+      const TSample *const sources[], std::size_t offset,
+      TSample *target, std::size_t frameCount
+    );
+
     /// <summary>Order in which the channels will be fed to the encoder</summary>
     private: std::vector<ChannelPlacement> inputChannelOrder;
-    /// <summary>Whether the channel order matches the Vorbis ordering</summary>
+    /// <summary>Whether the channel order matches the mapping family's ordering</summary>
+    /// <remarks>
+    ///   If this is true, interleaved floating point and 16-bit integer samples can be fed as-is.
+    /// </remarks>
+    private: bool isEncoderChannelOrder;
+    /// <summary>Takes the input channels into encoder channel order</summary>
+    private: Shared::ChannelRemapper channelRemapper;
+    /// <summary>Input samples converted to floating point, still in the input order</summary>
     /// <remarks>
-    ///   If this is true, interleaved floating point sampels can be fed as-is.
+    ///   Only used for input that is neither 16-bit integer nor 32-bit float and has to be
+    ///   converted before it can be reordered. Separated input is stored one channel after
+    ///   another, each taking up a full chunk's worth of samples.
     /// </remarks>
-    private: bool isVorbisChannelOrder;
+    private: SampleVector<float> convertedSamples;
+    /// <summary>Interleaved floating point samples in the encoder order for libopusenc</summary>
+    private: SampleVector<float> floatChunk;
+    /// <summary>Interleaved 16-bit integer samples in the encoder order for libopusenc</summary>
+    private: SampleVector<std::int16_t> integerChunk;
     /// <summary>Holds the function pointers to the file I/O functions</summary>
     /// <remarks>
     ///   libopusenc takes a pointer to these, so we try to err on the side of caution
@@ -179,6 +257,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     private: std::shared_ptr<::OggOpusComments> opusComments;
     /// <summary>Encoder that turns raw audio data into an Opus stream</summary>
     private: std::shared_ptr<::OggOpusEnc> opusEncoder;
+    /// <summary>Sample rate the encoder was created for</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Bitrate configured via <see cref="SetBitrate" /></summary>
+    private: float kilobitsPerSecond;
+    /// <summary>Complexity level configured via <see cref="SetEffort" /></summary>
+    private: std::size_t complexity;
+    /// <summary>Adjusts the encoder's settings to stay within a CPU budget, if enabled</summary>
+    private: std::optional<Shared::EncoderCpuGovernor> governor;
 
   };
 
@@ -25,9 +25,11 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
 #include "./OpusTrackEncoder.h"
+#include "./OpusChannelMapping.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
 #include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
 
-#include <stdexcept> // for std::runtime_error
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
 #include <cassert> // for assert()
 #include <set> // for std::set
 
@@ -48,7 +50,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     inputChannelOrder(),
     sampleRate(),
     targetBitrate(),
-    effort(1.0f) {}
+    effort(1.0f),
+    cpuBudget() {}
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -143,6 +146,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
   AudioTrackEncoderBuilder &OpusTrackEncoderBuilder::SetChannels(
     const std::vector<ChannelPlacement> &orderedChannels
   ) {
+
+    // Channels without any placement are encoded as an ambisonic sound field or
+    // as discrete channels, both of which Opus can store up to its channel limit
+    if(OpusChannelMapping::SelectMappingFamily(orderedChannels) >= 2) {
+      if(orderedChannels.size() > 255) {
+        throw std::runtime_error(u8"Opus can store at most 255 channels");
+      }
+
+      this->inputChannelOrder = orderedChannels;
+      return *this;
+    }
+
     std::vector<ChannelPlacement> vorbisChannelOrder = (
       Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(1, orderedChannels.size())
     );
@@ -189,6 +204,19 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  AudioTrackEncoderBuilder &OpusTrackEncoderBuilder::SetCpuBudget(
+    const EncoderCpuBudget &budget
+  ) {
+    if(unlikely(!(budget.CpuFraction > 0.0f))) {
+      throw std::invalid_argument(u8"CPU budget must be a positive fraction");
+    }
+
+    this->cpuBudget = budget;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::shared_ptr<AudioTrackEncoder> OpusTrackEncoderBuilder::Build(
     const std::shared_ptr<VirtualFile> &target
   ) {
@@ -204,11 +232,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       throw std::runtime_error(u8"Target birate for the encder has not been set");
     }
 
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+
     std::shared_ptr<OpusTrackEncoder> encoder = std::make_shared<OpusTrackEncoder>(
       target, this->inputChannelOrder, this->sampleRate.value()
     );
     encoder->SetBitrate(this->targetBitrate.value());
     encoder->SetEffort(this->effort);
+    if(this->cpuBudget.has_value()) {
+      encoder->SetCpuBudget(this->cpuBudget.value());
+    }
 
     return encoder;
   }
@@ -82,6 +82,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     ///   to the encoder.
     /// </param>
     /// <returns>The encoder builder such that additional calls can be chained</returns>
+    /// <remarks>
+    ///   Channels with speaker placements have to form one of the Vorbis layouts. If all
+    ///   channels are <see cref="ChannelPlacement.Unknown" />, they are stored as an
+    ///   ambisonic sound field (mapping family 2) when their count allows for it and as
+    ///   discrete channels (mapping family 255) otherwise.
+    /// </remarks>
     public: AudioTrackEncoderBuilder &SetChannels(
       const std::vector<ChannelPlacement> &orderedChannels
     ) override;
@@ -100,6 +106,11 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
       float effort = 1.0f
     ) override;
 
+    /// <summary>Limits the processor time the encoder may spend per second of audio</summary>
+    /// <param name="budget">Budget and the settings the encoder may give up to meet it</param>
+    /// <returns>The encoder builder such that additional calls can be chained</returns>
+    public: AudioTrackEncoderBuilder &SetCpuBudget(const EncoderCpuBudget &budget) override;
+
     /// <summary>Builds an audio track encoder that writes into a virtual file</summary>
     /// <param name="target">Virtual file that will receive the encoded audio data</param>
     /// <returns>The new encoder, set up to write into a file in the specified file</returns>
@@ -115,6 +126,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     private: std::optional<float> targetBitrate;
     /// <summary>Amount of effort (= CPU time and/or memory) to invest</summary>
     private: float effort;
+    /// <summary>Processor time budget the encoder should stay within, if any</summary>
+    private: std::optional<EncoderCpuBudget> cpuBudget;
 
   };
 
@@ -31,6 +31,7 @@ limitations under the License.
 #include <Nuclex/Support/ScopeGuard.h> // for ScopeGuard
 
 #include "Nuclex/Audio/Storage/VirtualFile.h" // for VitualFile
+#include "Nuclex/Audio/Storage/SequentialSource.h" // for SequentialSource
 
 namespace {
 
@@ -217,6 +218,48 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Reads up to <see cref="byteCount" /> of data from a sequential source</summary>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <param name="data">Buffer to store the data</param>
+  /// <param name="byteCount">Maximum number of bytes to read.</param>
+  /// <returns>The numberof bytes successfully read, or a negative value on error</returns>
+  int opusReadSequential(void *stateAsVoid, std::uint8_t *data, int byteCount) {
+    Nuclex::Audio::Storage::Opus::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Opus::SequentialSourceAdapterState *
+    >(stateAsVoid);
+
+    std::size_t readByteCount;
+    try {
+      readByteCount = state.Source->ReadSome(
+        reinterpret_cast<std::byte *>(data), static_cast<std::size_t>(byteCount)
+      );
+    }
+    catch(const std::exception &) {
+      state.Error = std::current_exception();
+      return -1;
+    }
+
+    state.FileCursor += readByteCount;
+
+    return static_cast<int>(readByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Releases the sequential source after the opusfile library is done with it</summary>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <returns>Always zero</returns>
+  int opusCloseSequential(void *stateAsVoid) {
+    Nuclex::Audio::Storage::Opus::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Opus::SequentialSourceAdapterState *
+    >(stateAsVoid);
+    state.Source.reset();
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
@@ -225,7 +268,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   std::unique_ptr<ReadOnlyFileAdapterState> FileAdapterFactory::CreateAdapterForReading(
     const std::shared_ptr<const VirtualFile> &readOnlyFile,
-    ::OpusFileCallbacks &fileCallbacks
+    ::OpusFileCallbacks &fileCallbacks,
+    bool isSeekable /* = true */
   ) {
     std::unique_ptr<ReadOnlyFileAdapterState> adapter = (
       std::make_unique<ReadOnlyFileAdapterState>()
@@ -237,8 +281,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     adapter->File = readOnlyFile;
 
     fileCallbacks.read = &opusReadBytes<ReadOnlyFileAdapterState>;
-    fileCallbacks.seek = &opusSeek<ReadOnlyFileAdapterState>;
-    fileCallbacks.tell = &opusTell;
+    if(isSeekable) {
+      fileCallbacks.seek = &opusSeek<ReadOnlyFileAdapterState>;
+      fileCallbacks.tell = &opusTell;
+    } else {
+      fileCallbacks.seek = nullptr;
+      fileCallbacks.tell = nullptr;
+    }
     fileCallbacks.close = &opusClose<ReadOnlyFileAdapterState>;
 
     return adapter;
@@ -246,6 +295,30 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::unique_ptr<SequentialSourceAdapterState>
+  FileAdapterFactory::CreateAdapterForSequentialReading(
+    const std::shared_ptr<SequentialSource> &source,
+    ::OpusFileCallbacks &fileCallbacks
+  ) {
+    std::unique_ptr<SequentialSourceAdapterState> adapter = (
+      std::make_unique<SequentialSourceAdapterState>()
+    );
+
+    adapter->IsReadOnly = true;
+    adapter->FileCursor = 0;
+    adapter->Error = std::exception_ptr();
+    adapter->Source = source;
+
+    fileCallbacks.read = &opusReadSequential;
+    fileCallbacks.seek = nullptr; // tells libopusfile the stream is not seekable
+    fileCallbacks.tell = nullptr;
+    fileCallbacks.close = &opusCloseSequential;
+
+    return adapter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::unique_ptr<WritableFileAdapterState> FileAdapterFactory::CreateAdapterForWriting(
     const std::shared_ptr<VirtualFile> &writableFile,
     ::OpusEncCallbacks &encoderCallbacks
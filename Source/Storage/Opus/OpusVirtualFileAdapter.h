@@ -50,6 +50,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Stores informations processed by the Opus sequential source adapter</summary>
+  struct SequentialSourceAdapterState : public FileAdapterState {
+
+    /// <summary>Sequential source this adapter is forwarding calls to</summary>
+    public: std::shared_ptr<SequentialSource> Source;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Stores informations processed by the Opus stream writer adapter</summary>
   struct WritableFileAdapterState : public FileAdapterState {
 
@@ -68,11 +78,34 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
     /// <param name="fileCallbacks">
     ///   Opus file callback set that will be set up to use the adapter
     /// </param>
+    /// <param name="isSeekable">
+    ///   Whether to let libopusfile seek. Without seeking, libopusfile only reads the headers
+    ///   when opening and doesn't look at the end of the file to determine its length.
+    /// </param>
     /// <returns>
     ///   A state that needs to be passed as the 'state' parameter though libopusfile
     /// </returns>
     public: static std::unique_ptr<ReadOnlyFileAdapterState> CreateAdapterForReading(
       const std::shared_ptr<const VirtualFile> &readOnlyFile,
+      ::OpusFileCallbacks &fileCallbacks,
+      bool isSeekable = true
+    );
+
+    /// <summayr>Constructs an adapter for a sequential source that can't seek</summary>
+    /// <param name="source">Sequential source the adapter will read from</param>
+    /// <param name="fileCallbacks">
+    ///   Opus file callback set that will be set up to use the adapter
+    /// </param>
+    /// <returns>
+    ///   A state that needs to be passed as the 'state' parameter though libopusfile
+    /// </returns>
+    /// <remarks>
+    ///   The seek and tell callbacks are left empty, which tells libopusfile that
+    ///   the stream is not seekable, so it only ever reads forward.
+    /// </remarks>
+    public: static std::unique_ptr<SequentialSourceAdapterState>
+    CreateAdapterForSequentialReading(
+      const std::shared_ptr<SequentialSource> &source,
       ::OpusFileCallbacks &fileCallbacks
     );
 
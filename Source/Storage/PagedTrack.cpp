@@ -0,0 +1,262 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/PagedTrack.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <iterator> // for std::prev()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PagedTrack::PagedTrack(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t memoryBudget /* = 16777216 */,
+    std::size_t pageFrameCount /* = 32768 */
+  ) :
+    decoder(decoder),
+    channelCount(0),
+    totalFrameCount(0),
+    memoryBudget(memoryBudget),
+    pageFrameCount(pageFrameCount),
+    memoryUsage(0),
+    pages(),
+    pagesByIndex() {
+    if(!decoder) {
+      throw std::invalid_argument(u8"Paged track requires a decoder");
+    }
+    if(pageFrameCount == 0) {
+      throw std::invalid_argument(u8"Pages need to hold at least one frame");
+    }
+
+    this->channelCount = decoder->CountChannels();
+    this->totalFrameCount = decoder->CountFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PagedTrack::~PagedTrack() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PagedTrack::CountChannels() const {
+    return this->channelCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t PagedTrack::CountFrames() const {
+    return this->totalFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PagedTrack::GetMemoryUsage() const {
+    return this->memoryUsage;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PagedTrack::EnsureDecodedRangeAvailable(std::uint64_t begin, std::uint64_t end) {
+    if((begin > end) || (end > this->totalFrameCount)) {
+      throw std::out_of_range(u8"Range lies outside of the audio track");
+    }
+    if(begin == end) {
+      return;
+    }
+
+    std::uint64_t firstPageIndex = getPageIndex(begin);
+    std::uint64_t lastPageIndex = getPageIndex(end - 1);
+
+    // Move the pages of the range that are already decoded to the front first, so that
+    // decoding the missing pages can't evict them. From here on, the first
+    // 'pinnedPageCount' pages in the list always belong to the range.
+    std::size_t pinnedPageCount = 0;
+    for(std::uint64_t index = firstPageIndex; index <= lastPageIndex; ++index) {
+      std::unordered_map<std::uint64_t, PageList::iterator>::iterator iterator = (
+        this->pagesByIndex.find(index)
+      );
+      if(iterator != this->pagesByIndex.end()) {
+        this->pages.splice(this->pages.begin(), this->pages, iterator->second);
+        ++pinnedPageCount;
+      }
+    }
+
+    PageList reusablePages;
+    for(std::uint64_t index = firstPageIndex; index <= lastPageIndex; ++index) {
+      if(this->pagesByIndex.find(index) != this->pagesByIndex.end()) {
+        continue;
+      }
+
+      std::uint64_t pageStart = getPageStart(index);
+      std::size_t frameCount = static_cast<std::size_t>(getPageStart(index + 1) - pageStart);
+      if(frameCount == 0) {
+        continue; // Can happen if codec blocks are larger than the nominal page size
+      }
+
+      std::size_t sampleCount = frameCount * this->channelCount;
+      evictPages(sampleCount * sizeof(float), pinnedPageCount, reusablePages);
+
+      // Decode the page before adding it to the list. If the decoder throws,
+      // the page is simply dropped and the list stays consistent.
+      PageList newPage;
+      if(reusablePages.empty()) {
+        newPage.emplace_back();
+      } else {
+        newPage.splice(newPage.begin(), reusablePages, reusablePages.begin());
+      }
+      {
+        Page &page = newPage.front();
+        page.Index = index;
+        page.StartFrame = pageStart;
+        page.FrameCount = frameCount;
+        page.Samples.resize(sampleCount);
+        this->decoder->DecodeInterleaved(page.Samples.data(), pageStart, frameCount);
+      }
+
+      this->pages.splice(this->pages.begin(), newPage);
+      this->pagesByIndex.emplace(index, this->pages.begin());
+      this->memoryUsage += this->pages.front().Samples.capacity() * sizeof(float);
+      ++pinnedPageCount;
+    }
+
+    // Pages outside of the range that are still over budget can go now
+    evictPages(0, pinnedPageCount, reusablePages);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PagedTrack::IsDecodedRangeAvailable(std::uint64_t begin, std::uint64_t end) const {
+    if((begin > end) || (end > this->totalFrameCount)) {
+      return false;
+    }
+    if(begin == end) {
+      return true;
+    }
+
+    std::uint64_t lastPageIndex = getPageIndex(end - 1);
+    for(std::uint64_t index = getPageIndex(begin); index <= lastPageIndex; ++index) {
+      if(this->pagesByIndex.find(index) == this->pagesByIndex.end()) {
+        if(getPageStart(index) != getPageStart(index + 1)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const float *PagedTrack::GetSamples(std::uint64_t frameIndex, std::size_t &frameCount) const {
+    frameCount = 0;
+    if(frameIndex >= this->totalFrameCount) {
+      return nullptr;
+    }
+
+    std::unordered_map<std::uint64_t, PageList::iterator>::const_iterator iterator = (
+      this->pagesByIndex.find(getPageIndex(frameIndex))
+    );
+    if(iterator == this->pagesByIndex.end()) {
+      return nullptr;
+    }
+
+    const Page &page = *iterator->second;
+    std::size_t offset = static_cast<std::size_t>(frameIndex - page.StartFrame);
+    frameCount = page.FrameCount - offset;
+    return page.Samples.data() + (offset * this->channelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PagedTrack::CopyInterleaved(
+    float *target, std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    EnsureDecodedRangeAvailable(startFrame, startFrame + frameCount);
+
+    while(frameCount > 0) {
+      std::size_t availableFrameCount;
+      const float *samples = GetSamples(startFrame, availableFrameCount);
+
+      std::size_t copiedFrameCount = std::min(availableFrameCount, frameCount);
+      std::copy_n(samples, copiedFrameCount * this->channelCount, target);
+
+      target += copiedFrameCount * this->channelCount;
+      startFrame += copiedFrameCount;
+      frameCount -= copiedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t PagedTrack::getPageIndex(std::uint64_t frameIndex) const {
+    std::uint64_t pageIndex = frameIndex / this->pageFrameCount;
+
+    // Pages begin on block boundaries, which may lie before the nominal page start,
+    // so the frame can belong to the page before or after its nominal page.
+    while((pageIndex > 0) && (frameIndex < getPageStart(pageIndex))) {
+      --pageIndex;
+    }
+    while(frameIndex >= getPageStart(pageIndex + 1)) {
+      ++pageIndex;
+    }
+
+    return pageIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t PagedTrack::getPageStart(std::uint64_t pageIndex) const {
+    if(pageIndex == 0) {
+      return 0;
+    }
+
+    std::uint64_t nominalStart = pageIndex * this->pageFrameCount;
+    if(nominalStart >= this->totalFrameCount) {
+      return this->totalFrameCount;
+    }
+
+    return this->decoder->GetBlockStart(nominalStart);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PagedTrack::evictPages(
+    std::size_t requiredByteCount, std::size_t pinnedPageCount, PageList &reusablePages
+  ) {
+    while(
+      (this->memoryUsage + requiredByteCount > this->memoryBudget) &&
+      (this->pages.size() > pinnedPageCount)
+    ) {
+      PageList::iterator leastRecentlyUsed = std::prev(this->pages.end());
+      this->pagesByIndex.erase(leastRecentlyUsed->Index);
+      this->memoryUsage -= leastRecentlyUsed->Samples.capacity() * sizeof(float);
+      reusablePages.splice(reusablePages.end(), this->pages, leastRecentlyUsed);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
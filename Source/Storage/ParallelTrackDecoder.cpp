@@ -0,0 +1,352 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "ParallelTrackDecoder.h"
+#include "PooledTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <exception> // for std::exception_ptr
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes one slice of a channel-separated decoding call</summary>
+  /// <typeparam name="TSample">Type of samples the channels are decoded as</typeparam>
+  /// <param name="decoder">Decoder that will decode the slice</param>
+  /// <param name="buffers">Caller-provided channel buffers for the whole call</param>
+  /// <param name="channelCount">Number of channels in the audio track</param>
+  /// <param name="sliceStartFrame">Index of the first frame in the slice</param>
+  /// <param name="sliceOffset">Offset of the slice from the start of the buffers</param>
+  /// <param name="sliceFrameCount">Number of frames in the slice</param>
+  template<typename TSample>
+  void decodeSeparatedSlice(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    TSample *buffers[], std::size_t channelCount,
+    std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+  ) {
+    std::vector<TSample *> sliceBuffers(channelCount);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      if(buffers[channelIndex] != nullptr) {
+        sliceBuffers[channelIndex] = buffers[channelIndex] + sliceOffset;
+      }
+    }
+
+    decoder.DecodeSeparated<TSample>(sliceBuffers.data(), sliceStartFrame, sliceFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ParallelTrackDecoder::ParallelTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t threadCount,
+    std::size_t minimumSliceFrameCount /* = 65536 */
+  ) :
+    prototype(decoder),
+    decoderPool(),
+    executor(Executor::GetInstalled()),
+    threadCount(threadCount),
+    minimumSliceFrameCount(std::max<std::size_t>(minimumSliceFrameCount, 1)) {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Parallel decoder requires a decoder to clone");
+    }
+    if(unlikely(threadCount == 0)) {
+      throw std::invalid_argument(u8"Parallel decoder needs to use at least one thread");
+    }
+
+    this->decoderPool = std::make_shared<PooledTrackDecoder>(decoder, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ParallelTrackDecoder::~ParallelTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> ParallelTrackDecoder::Clone() const {
+    return std::make_shared<ParallelTrackDecoder>(
+      this->prototype->Clone(), this->threadCount, this->minimumSliceFrameCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TDecodeMethod>
+  void ParallelTrackDecoder::decodeInSlices(
+    std::uint64_t startFrame, std::size_t frameCount, TDecodeMethod &&decode
+  ) const {
+    const AudioTrackDecoder &pool = *this->decoderPool;
+
+    // Small decoding calls are faster on a single thread
+    std::size_t sliceCount = std::min(
+      this->threadCount, frameCount / this->minimumSliceFrameCount
+    );
+    if(sliceCount < 2) {
+      decode(pool, startFrame, 0, frameCount);
+      return;
+    }
+
+    // Move the slice boundaries to the start of the codec's blocks, so that
+    // no block has to be decoded by two threads
+    std::vector<std::uint64_t> boundaries;
+    boundaries.reserve(sliceCount + 1);
+    boundaries.push_back(startFrame);
+    for(std::size_t sliceIndex = 1; sliceIndex < sliceCount; ++sliceIndex) {
+      std::uint64_t boundary = this->prototype->GetBlockStart(
+        startFrame + (static_cast<std::uint64_t>(frameCount) * sliceIndex / sliceCount)
+      );
+      if(boundary > boundaries.back()) {
+        boundaries.push_back(boundary);
+      }
+    }
+    boundaries.push_back(startFrame + frameCount);
+    sliceCount = boundaries.size() - 1;
+
+    // Exceptions can't cross threads by themselves, so each slice records its own
+    std::vector<std::exception_ptr> errors(sliceCount);
+    auto decodeSlice = [&](std::size_t sliceIndex) {
+      try {
+        decode(
+          pool,
+          boundaries[sliceIndex],
+          static_cast<std::size_t>(boundaries[sliceIndex] - startFrame),
+          static_cast<std::size_t>(boundaries[sliceIndex + 1] - boundaries[sliceIndex])
+        );
+      }
+      catch(...) {
+        errors[sliceIndex] = std::current_exception();
+      }
+    };
+
+    // The calling thread decodes slices, too, so this finishes even if all of
+    // the executor's workers are busy with other things
+    this->executor->ParallelFor(sliceCount, decodeSlice);
+
+    for(std::size_t sliceIndex = 0; sliceIndex < sliceCount; ++sliceIndex) {
+      if(errors[sliceIndex]) {
+        std::rethrow_exception(errors[sliceIndex]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decoder.DecodeInterleaved<std::uint8_t>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decoder.DecodeInterleaved<std::int16_t>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decoder.DecodeInterleaved<std::int32_t>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decoder.DecodeInterleaved<float>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decoder.DecodeInterleaved<double>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decodeSeparatedSlice<std::uint8_t>(
+          decoder, buffers, channelCount, sliceStartFrame, sliceOffset, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decodeSeparatedSlice<std::int16_t>(
+          decoder, buffers, channelCount, sliceStartFrame, sliceOffset, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decodeSeparatedSlice<std::int32_t>(
+          decoder, buffers, channelCount, sliceStartFrame, sliceOffset, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decodeSeparatedSlice<float>(
+          decoder, buffers, channelCount, sliceStartFrame, sliceOffset, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->prototype->CountChannels();
+    this->decodeInSlices(
+      startFrame, frameCount,
+      [=](
+        const AudioTrackDecoder &decoder,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        decodeSeparatedSlice<double>(
+          decoder, buffers, channelCount, sliceStartFrame, sliceOffset, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
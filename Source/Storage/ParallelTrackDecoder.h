@@ -0,0 +1,289 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_PARALLELTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_PARALLELTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class PooledTrackDecoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits large decoding calls into slices that are decoded concurrently</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Codecs such as FLAC and WavPack compress audio in blocks that can be decoded
+  ///     independently once the decoder has been positioned at the block's start. When
+  ///     a whole track is decoded (for example, to load a music track into memory or to
+  ///     transcode it), a single decoder only keeps one core busy.
+  ///   </para>
+  ///   <para>
+  ///     This decorator splits decoding calls that are large enough into slices that
+  ///     begin on block boundaries, decodes the slices on the installed
+  ///     <see cref="Executor" />, each with its own clone of the wrapped decoder and lets each clone write directly into the
+  ///     caller's buffer at the slice's offset. The clones are kept in a
+  ///     <see cref="PooledTrackDecoder" />, so they are only created once and later
+  ///     calls reuse whichever clone is closest to each slice's start.
+  ///   </para>
+  ///   <para>
+  ///     Clones share their seek index with the decoder they were cloned from, so if
+  ///     the format needs one (FLAC files without a SEEKTABLE block, Ogg files), calling
+  ///     <see cref="BuildSeekIndex" /> first lets each clone jump to its slice directly.
+  ///   </para>
+  /// </remarks>
+  class ParallelTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new parallel decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder that will be cloned for the additional threads</param>
+    /// <param name="threadCount">Maximum number of threads decoding at the same time</param>
+    /// <param name="minimumSliceFrameCount">
+    ///   Smallest number of frames worth decoding on a separate thread. Each slice costs
+    ///   a thread start and usually a seek, so slices should keep a thread busy for a while.
+    ///   The default is about 1.5 seconds of audio.
+    /// </param>
+    public: ParallelTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t threadCount,
+      std::size_t minimumSliceFrameCount = 65536
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~ParallelTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override {
+      return this->prototype->CountChannels();
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->prototype->GetChannelOrder();
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const override {
+      return this->prototype->CountFrames();
+    }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->prototype->GetNativeSampleFormat();
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>True if the codec decodes straight to interleaved channels</summary>
+    public: bool IsNativelyInterleaved() const override {
+      return this->prototype->IsNativelyInterleaved();
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override {
+      return this->prototype->ExplainDecodePath(sampleFormat, interleaved);
+    }
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    /// <remarks>
+    ///   Reports the cost for the slice decoder that would start at the target frame.
+    /// </remarks>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override {
+      return this->prototype->EstimateSeekCost(targetFrame);
+    }
+
+    /// <summary>Determines where the native block containing a frame begins</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The index of the first frame in the block containing the frame</returns>
+    public: std::uint64_t GetBlockStart(std::uint64_t frameIndex) const override {
+      return this->prototype->GetBlockStart(frameIndex);
+    }
+
+    /// <summary>Determines the length of the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The number of frames in the block containing the frame</returns>
+    public: std::size_t GetBlockSize(std::uint64_t frameIndex) const override {
+      return this->prototype->GetBlockSize(frameIndex);
+    }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    /// <remarks>
+    ///   Clones share their seek index with the decoder they were cloned from,
+    ///   so building it on the prototype makes it available to all slice decoders.
+    /// </remarks>
+    public: void BuildSeekIndex() const override {
+      this->prototype->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->prototype->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->prototype->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->prototype->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Returns the maximum number of threads that decode at the same time</summary>
+    /// <returns>The maximum number of slices a decoding call is split into</returns>
+    public: std::size_t CountThreads() const { return this->threadCount; }
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Splits a decoding call into slices and decodes them concurrently</summary>
+    /// <typeparam name="TDecodeMethod">Type of the method that will do the decoding</typeparam>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="decode">
+    ///   Method that decodes one slice, receiving the decoder, the slice's start frame,
+    ///   the slice's offset from the first frame and the slice's length
+    /// </param>
+    private: template<typename TDecodeMethod>
+    void decodeInSlices(
+      std::uint64_t startFrame, std::size_t frameCount, TDecodeMethod &&decode
+    ) const;
+
+    /// <summary>Decoder the parallel decoder was created from</summary>
+    private: std::shared_ptr<AudioTrackDecoder> prototype;
+    /// <summary>Pool of clones that decode the slices</summary>
+    private: std::shared_ptr<PooledTrackDecoder> decoderPool;
+    /// <summary>Executor on which the slices are decoded</summary>
+    private: std::shared_ptr<Executor> executor;
+    /// <summary>Maximum number of slices a decoding call is split into</summary>
+    private: std::size_t threadCount;
+    /// <summary>Smallest number of frames that will be decoded on a separate thread</summary>
+    private: std::size_t minimumSliceFrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_PARALLELTRACKDECODER_H
@@ -0,0 +1,442 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "PlaylistTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/ContainerInfo.h"
+#include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include <algorithm> // for std::min(), std::upper_bound()
+#include <chrono> // for std::chrono::seconds
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Marks the current or prefetched entry index as unused</summary>
+  const std::size_t NoEntry = std::numeric_limits<std::size_t>::max();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How long before an entry's end the next entry will be opened</summary>
+  /// <remarks>
+  ///   Opening a decoder reads and parses the file's headers, which on slow storage can
+  ///   take longer than a mixer's buffer lasts. A few seconds leave plenty of room.
+  /// </remarks>
+  constexpr std::chrono::seconds PrefetchLeadTime(5);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct PlaylistTrackDecoder::Entry {
+
+    /// <summary>Path of the audio file</summary>
+    public: std::string Path;
+    /// <summary>Index of the audio file's track that will be played</summary>
+    public: std::size_t TrackIndex;
+    /// <summary>Sample rate of the track as stored in the file</summary>
+    public: std::size_t SampleRate;
+    /// <summary>Number of frames in the track as stored in the file</summary>
+    public: std::uint64_t TrackFrameCount;
+    /// <summary>Frame of the playlist at which the entry begins</summary>
+    public: std::uint64_t StartFrame;
+    /// <summary>Number of frames the entry occupies in the playlist</summary>
+    public: std::uint64_t FrameCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlaylistTrackDecoder::PlaylistTrackDecoder(
+    const AudioLoader &loader, const std::vector<std::string> &paths
+  ) :
+    loader(loader),
+    entries(),
+    channelOrder(),
+    sampleRate(0),
+    nativeSampleFormat(AudioSampleFormat::Unknown),
+    isNativelyInterleaved(false),
+    mutex(),
+    currentEntryIndex(NoEntry),
+    currentDecoder(),
+    prefetchedEntryIndex(NoEntry),
+    prefetchedDecoder() {
+    if(paths.empty()) {
+      throw std::invalid_argument(u8"Playlist must contain at least one audio file");
+    }
+
+    // Look up the length of each entry up front, this is answered from the track
+    // informations (and the loader's caches) without setting up any decoders
+    std::shared_ptr<std::vector<Entry>> newEntries = std::make_shared<std::vector<Entry>>();
+    newEntries->reserve(paths.size());
+
+    std::size_t channelCount = 0;
+    std::uint64_t startFrame = 0;
+    for(const std::string &path : paths) {
+      std::optional<ContainerInfo> info = loader.TryReadInfo(path);
+      if(!info.has_value() || info.value().Tracks.empty()) {
+        throw Errors::UnsupportedFormatError(
+          u8"Playlist entry is not an audio file or its file format is not supported"
+        );
+      }
+
+      std::size_t trackIndex = info.value().DefaultTrackIndex;
+      if(trackIndex >= info.value().Tracks.size()) {
+        trackIndex = 0;
+      }
+      const TrackInfo &track = info.value().Tracks[trackIndex];
+      if(newEntries->empty()) {
+        this->sampleRate = track.SampleRate;
+        channelCount = track.ChannelCount;
+      } else if(track.ChannelCount != channelCount) {
+        throw std::invalid_argument(u8"All playlist entries must have the same channel count");
+      }
+      if(track.SampleRate == 0) {
+        throw Errors::UnsupportedFormatError(u8"Playlist entry has no valid sample rate");
+      }
+
+      // Entries with a different sample rate are resampled, which stretches them
+      // the same way the resampling decoder calculates its frame count
+      std::uint64_t frameCount = (
+        (track.FrameCount * this->sampleRate + track.SampleRate - 1) / track.SampleRate
+      );
+      newEntries->push_back(
+        Entry { path, trackIndex, track.SampleRate, track.FrameCount, startFrame, frameCount }
+      );
+      startFrame += frameCount;
+    }
+    this->entries = newEntries;
+
+    // The first entry decides the channel order and native format. It is opened
+    // right away since the first decoding call will almost certainly want it.
+    std::lock_guard<std::mutex> decoderScope(this->mutex);
+    activateEntry(0);
+    this->channelOrder = this->currentDecoder->GetChannelOrder();
+    this->nativeSampleFormat = this->currentDecoder->GetNativeSampleFormat();
+    this->isNativelyInterleaved = this->currentDecoder->IsNativelyInterleaved();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlaylistTrackDecoder::PlaylistTrackDecoder(const PlaylistTrackDecoder &other) :
+    loader(other.loader),
+    entries(other.entries),
+    channelOrder(other.channelOrder),
+    sampleRate(other.sampleRate),
+    nativeSampleFormat(other.nativeSampleFormat),
+    isNativelyInterleaved(other.isNativelyInterleaved),
+    mutex(),
+    currentEntryIndex(NoEntry),
+    currentDecoder(),
+    prefetchedEntryIndex(NoEntry),
+    prefetchedDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlaylistTrackDecoder::~PlaylistTrackDecoder() {
+    // If an entry is still being opened, wait for it, the loader's worker must not
+    // outlive the caller's guarantee that the audio loader stays alive
+    if(this->prefetchedDecoder.valid()) {
+      this->prefetchedDecoder.wait();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> PlaylistTrackDecoder::Clone() const {
+    return std::shared_ptr<AudioTrackDecoder>(new PlaylistTrackDecoder(*this));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t PlaylistTrackDecoder::CountFrames() const {
+    const Entry &lastEntry = this->entries->back();
+    return lastEntry.StartFrame + lastEntry.FrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PlaylistTrackDecoder::findEntry(std::uint64_t frameIndex) const {
+    const std::vector<Entry> &allEntries = *this->entries;
+
+    // Take the last entry starting at or before the frame, this skips over empty entries
+    std::vector<Entry>::const_iterator entry = std::upper_bound(
+      allEntries.begin(), allEntries.end(), frameIndex,
+      [](std::uint64_t frame, const Entry &other) { return frame < other.StartFrame; }
+    );
+    return static_cast<std::size_t>(entry - allEntries.begin()) - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::activateEntry(std::size_t entryIndex) const {
+    if(entryIndex == this->currentEntryIndex) {
+      return;
+    }
+
+    const Entry &entry = (*this->entries)[entryIndex];
+
+    std::shared_ptr<AudioTrackDecoder> decoder;
+    if((entryIndex == this->prefetchedEntryIndex) && this->prefetchedDecoder.valid()) {
+      this->prefetchedEntryIndex = NoEntry;
+      decoder = this->prefetchedDecoder.get();
+    } else {
+      decoder = this->loader.OpenDecoder(entry.Path, entry.TrackIndex);
+    }
+
+    // Drop the old decoder first, so at most two entries are open at any time
+    this->currentDecoder.reset();
+    this->currentEntryIndex = NoEntry;
+    this->currentDecoder = adaptDecoder(std::move(decoder), entry);
+    this->currentEntryIndex = entryIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlaylistTrackDecoder::prefetchIfNearBoundary(std::uint64_t frameIndex) const {
+    const std::vector<Entry> &allEntries = *this->entries;
+    if(this->currentEntryIndex == NoEntry) {
+      return;
+    }
+
+    const Entry &current = allEntries[this->currentEntryIndex];
+    std::uint64_t leadFrameCount = (
+      static_cast<std::uint64_t>(this->sampleRate) * PrefetchLeadTime.count()
+    );
+    if(frameIndex + leadFrameCount < current.StartFrame + current.FrameCount) {
+      return;
+    }
+
+    // Find the next entry that actually has frames, empty ones are never decoded
+    std::size_t nextEntryIndex = this->currentEntryIndex + 1;
+    while((nextEntryIndex < allEntries.size()) && (allEntries[nextEntryIndex].FrameCount == 0)) {
+      ++nextEntryIndex;
+    }
+    if((nextEntryIndex >= allEntries.size()) || (nextEntryIndex == this->prefetchedEntryIndex)) {
+      return;
+    }
+
+    // A decoder left over from an earlier prefetch (the caller jumped elsewhere)
+    // has to be finished before its future can be replaced
+    if(this->prefetchedDecoder.valid()) {
+      this->prefetchedDecoder.wait();
+    }
+
+    const Entry &next = allEntries[nextEntryIndex];
+    this->prefetchedDecoder = this->loader.OpenDecoderAsync(next.Path, next.TrackIndex);
+    this->prefetchedEntryIndex = nextEntryIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> PlaylistTrackDecoder::adaptDecoder(
+    std::shared_ptr<AudioTrackDecoder> decoder, const Entry &entry
+  ) const {
+    if(!this->channelOrder.empty() && (decoder->CountChannels() != this->channelOrder.size())) {
+      throw std::invalid_argument(u8"All playlist entries must have the same channel count");
+    }
+
+    // The length is already known from the track informations, this spares Ogg
+    // decoders from searching for the end of their stream
+    decoder->ProvideFrameCount(entry.TrackFrameCount);
+
+    // Deliver all entries in the first entry's channel order where possible. Entries
+    // with different speakers can't be reordered and are delivered as they are.
+    if(!this->channelOrder.empty() && (decoder->GetChannelOrder() != this->channelOrder)) {
+      try {
+        decoder->TrySetChannelOrder(this->channelOrder);
+      }
+      catch(const std::invalid_argument &) {}
+    }
+
+    if(entry.SampleRate != this->sampleRate) {
+      decoder = AudioTrackDecoder::CreateResampler(decoder, entry.SampleRate, this->sampleRate);
+    }
+
+    return decoder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void PlaylistTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    if(frameCount > CountFrames() - std::min(startFrame, CountFrames())) {
+      throw std::out_of_range(u8"Decoding range reaches past the end of the playlist");
+    }
+
+    std::size_t channelCount = this->channelOrder.size();
+
+    std::lock_guard<std::mutex> decoderScope(this->mutex);
+    while(frameCount > 0) {
+      std::size_t entryIndex = findEntry(startFrame);
+      const Entry &entry = (*this->entries)[entryIndex];
+      activateEntry(entryIndex);
+
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount, entry.StartFrame + entry.FrameCount - startFrame)
+      );
+      this->currentDecoder->DecodeInterleaved<TSample>(
+        buffer, startFrame - entry.StartFrame, chunkFrameCount
+      );
+
+      buffer += chunkFrameCount * channelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+
+    prefetchIfNearBoundary(startFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void PlaylistTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    if(frameCount > CountFrames() - std::min(startFrame, CountFrames())) {
+      throw std::out_of_range(u8"Decoding range reaches past the end of the playlist");
+    }
+
+    std::size_t channelCount = this->channelOrder.size();
+    std::vector<TSample *> targets(buffers, buffers + channelCount);
+
+    std::lock_guard<std::mutex> decoderScope(this->mutex);
+    std::size_t decodedFrameCount = 0;
+    while(decodedFrameCount < frameCount) {
+      std::uint64_t frameIndex = startFrame + decodedFrameCount;
+      std::size_t entryIndex = findEntry(frameIndex);
+      const Entry &entry = (*this->entries)[entryIndex];
+      activateEntry(entryIndex);
+
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(
+          frameCount - decodedFrameCount, entry.StartFrame + entry.FrameCount - frameIndex
+        )
+      );
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        if(buffers[index] != nullptr) {
+          targets[index] = buffers[index] + decodedFrameCount;
+        }
+      }
+      this->currentDecoder->DecodeSeparated<TSample>(
+        targets.data(), frameIndex - entry.StartFrame, chunkFrameCount
+      );
+
+      decodedFrameCount += chunkFrameCount;
+    }
+
+    prefetchIfNearBoundary(startFrame + frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
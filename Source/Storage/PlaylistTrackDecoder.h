@@ -0,0 +1,257 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_PLAYLISTTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_PLAYLISTTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <future> // for std::future
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioLoader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Presents the tracks of several audio files as one continuous track</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The lengths of all entries are looked up via the audio loader's track
+  ///     informations when the playlist is created, which places each entry in the frame
+  ///     space of the playlist. Only the entry being decoded has a decoder. When decoding
+  ///     gets close to the end of an entry, the next entry's decoder is opened on the
+  ///     installed executor, so that it is ready by the time the boundary is crossed.
+  ///   </para>
+  ///   <para>
+  ///     Decoders already remove the encoder delay and padding of their tracks, so
+  ///     the entries are stitched together at frame level with no gap in between.
+  ///   </para>
+  /// </remarks>
+  class PlaylistTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new playlist decoder</summary>
+    /// <param name="loader">Audio loader through which the entries will be opened</param>
+    /// <param name="paths">Paths of the audio files that will be played in order</param>
+    public: PlaylistTrackDecoder(
+      const AudioLoader &loader, const std::vector<std::string> &paths
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~PlaylistTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override { return this->channelOrder.size(); }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames in all entries of the playlist together</returns>
+    public: std::uint64_t CountFrames() const override;
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the first entry's samples are delivered</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->nativeSampleFormat;
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>True if the first entry's codec decodes straight to interleaved channels</returns>
+    public: bool IsNativelyInterleaved() const override { return this->isNativelyInterleaved; }
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Entry in the playlist and its place in the playlist's frame space</summary>
+    private: struct Entry;
+
+    /// <summary>Initializes a clone of a playlist decoder</summary>
+    /// <param name="other">Playlist decoder that will be cloned</param>
+    private: PlaylistTrackDecoder(const PlaylistTrackDecoder &other);
+
+    /// <summary>Finds the entry the specified frame of the playlist belongs to</summary>
+    /// <param name="frameIndex">Frame in the playlist whose entry will be looked up</param>
+    /// <returns>The index of the entry containing the frame</returns>
+    private: std::size_t findEntry(std::uint64_t frameIndex) const;
+
+    /// <summary>Makes sure the decoder for the specified entry is ready</summary>
+    /// <param name="entryIndex">Index of the entry whose decoder will be prepared</param>
+    /// <remarks>
+    ///   Must be called with the mutex held. If the entry's decoder was opened ahead of
+    ///   time, that one is taken, otherwise the entry is opened right here.
+    /// </remarks>
+    private: void activateEntry(std::size_t entryIndex) const;
+
+    /// <summary>Opens the next entry if decoding is about to reach its start</summary>
+    /// <param name="frameIndex">Frame of the playlist at which decoding will continue</param>
+    /// <remarks>Must be called with the mutex held</remarks>
+    private: void prefetchIfNearBoundary(std::uint64_t frameIndex) const;
+
+    /// <summary>Adapts a freshly opened decoder to the playlist's format</summary>
+    /// <param name="decoder">Decoder of the entry that will be adapted</param>
+    /// <param name="entry">Entry the decoder was opened for</param>
+    /// <returns>The decoder that delivers the entry in the playlist's format</returns>
+    private: std::shared_ptr<AudioTrackDecoder> adaptDecoder(
+      std::shared_ptr<AudioTrackDecoder> decoder, const Entry &entry
+    ) const;
+
+    /// <summary>Decodes frames of the playlist in interleaved format</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decodes frames of the playlist in separated format</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Audio loader through which the entries are opened</summary>
+    private: const AudioLoader &loader;
+    /// <summary>Entries of the playlist, shared with all clones</summary>
+    private: std::shared_ptr<const std::vector<Entry>> entries;
+    /// <summary>Order in which the channels are delivered</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Sample rate at which all entries are delivered</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Native sample format of the first entry</summary>
+    private: AudioSampleFormat nativeSampleFormat;
+    /// <summary>Whether the first entry's codec decodes to interleaved channels</summary>
+    private: bool isNativelyInterleaved;
+
+    /// <summary>Must be held while decoding or switching between entries</summary>
+    private: mutable std::mutex mutex;
+    /// <summary>Index of the entry the current decoder belongs to</summary>
+    private: mutable std::size_t currentEntryIndex;
+    /// <summary>Decoder of the entry currently being decoded</summary>
+    private: mutable std::shared_ptr<AudioTrackDecoder> currentDecoder;
+    /// <summary>Index of the entry that is being opened ahead of time</summary>
+    private: mutable std::size_t prefetchedEntryIndex;
+    /// <summary>Provides the decoder of the entry being opened ahead of time</summary>
+    private: mutable std::future<std::shared_ptr<AudioTrackDecoder>> prefetchedDecoder;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_PLAYLISTTRACKDECODER_H
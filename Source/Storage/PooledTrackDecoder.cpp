@@ -0,0 +1,391 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "PooledTrackDecoder.h"
+
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument
+#include <thread> // for std::this_thread::yield()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Slot does not hold a decoder yet</summary>
+  constexpr int EmptySlotState = 0;
+  /// <summary>Slot holds a decoder that is waiting to be used</summary>
+  constexpr int IdleSlotState = 1;
+  /// <summary>Slot has been claimed by a thread that is decoding or cloning</summary>
+  constexpr int BusySlotState = 2;
+
+  /// <summary>Cursor value used when a decoder's position is not known</summary>
+  constexpr std::uint64_t UnknownCursor = std::numeric_limits<std::uint64_t>::max();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates how far a decoder would have to seek to reach a frame</summary>
+  /// <param name="cursor">Frame at which the decoder last stopped decoding</param>
+  /// <param name="startFrame">Frame at which decoding should begin</param>
+  /// <returns>The distance between the decoder's cursor and the start frame</returns>
+  std::uint64_t getSeekDistance(std::uint64_t cursor, std::uint64_t startFrame) {
+    if(cursor == UnknownCursor) {
+      return UnknownCursor;
+    } else if(cursor < startFrame) {
+      return startFrame - cursor;
+    } else {
+      return cursor - startFrame;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct PooledTrackDecoder::Slot {
+
+    /// <summary>Initializes a new, empty slot</summary>
+    public: Slot() :
+      State(EmptySlotState),
+      Cursor(0),
+      Decoder() {}
+
+    /// <summary>Whether the slot is empty, idle or in use</summary>
+    public: std::atomic<int> State;
+    /// <summary>Frame at which the slot's decoder stopped decoding last time</summary>
+    public: std::atomic<std::uint64_t> Cursor;
+    /// <summary>Decoder held by the slot, only accessed while the slot is busy</summary>
+    public: std::shared_ptr<AudioTrackDecoder> Decoder;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PooledTrackDecoder::PooledTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t maximumDecoderCount
+  ) :
+    prototype(decoder),
+    slotCount(maximumDecoderCount),
+    slots() {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Decoder pool requires a decoder to clone");
+    }
+    if(unlikely(maximumDecoderCount == 0)) {
+      throw std::invalid_argument(u8"Decoder pool needs to hold at least one decoder");
+    }
+
+    this->slots.reset(new Slot[maximumDecoderCount]);
+
+    // The decoder we've been given can do the decoding work, too, so put it in
+    // the first slot. Clones will only be created once it is busy.
+    this->slots[0].Decoder = decoder;
+    this->slots[0].State.store(IdleSlotState, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PooledTrackDecoder::~PooledTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> PooledTrackDecoder::Clone() const {
+    return std::make_shared<PooledTrackDecoder>(this->prototype->Clone(), this->slotCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PooledTrackDecoder::CountDecoders() const {
+    std::size_t decoderCount = 0;
+    for(std::size_t index = 0; index < this->slotCount; ++index) {
+      int state = this->slots[index].State.load(std::memory_order_relaxed);
+      if(state != EmptySlotState) {
+        ++decoderCount;
+      }
+    }
+    return decoderCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost PooledTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+
+    // Mirror acquireSlot(), an idle decoder that stopped right at the target frame
+    // would be picked and simply continue decoding
+    for(std::size_t index = 0; index < this->slotCount; ++index) {
+      int state = this->slots[index].State.load(std::memory_order_acquire);
+      if(state == IdleSlotState) {
+        std::uint64_t cursor = this->slots[index].Cursor.load(std::memory_order_relaxed);
+        if(cursor == targetFrame) {
+          return SeekCost { 0, 0, 0, true };
+        }
+      }
+    }
+
+    // Otherwise, all decoders share the prototype's seek index, so it knows the cost
+    return this->prototype->EstimateSeekCost(targetFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PooledTrackDecoder::acquireSlot(std::uint64_t startFrame) const {
+    const std::size_t none = this->slotCount;
+
+    for(;;) {
+      std::size_t bestIdleIndex = none;
+      std::uint64_t bestIdleDistance = 0;
+      std::size_t firstEmptyIndex = none;
+
+      // Look for the idle decoder that would have to seek the least. A decoder that
+      // stopped exactly where we want to begin can't be beaten, so stop looking then.
+      for(std::size_t index = 0; index < this->slotCount; ++index) {
+        int state = this->slots[index].State.load(std::memory_order_acquire);
+        if(state == IdleSlotState) {
+          std::uint64_t distance = getSeekDistance(
+            this->slots[index].Cursor.load(std::memory_order_relaxed), startFrame
+          );
+          if((bestIdleIndex == none) || (distance < bestIdleDistance)) {
+            bestIdleIndex = index;
+            bestIdleDistance = distance;
+            if(distance == 0) {
+              break;
+            }
+          }
+        } else if((state == EmptySlotState) && (firstEmptyIndex == none)) {
+          firstEmptyIndex = index;
+        }
+      }
+
+      // If we found an idle decoder, try to claim it. Another thread may have been
+      // faster, in which case we simply look again.
+      if(bestIdleIndex != none) {
+        int expected = IdleSlotState;
+        bool claimed = this->slots[bestIdleIndex].State.compare_exchange_strong(
+          expected, BusySlotState, std::memory_order_acquire, std::memory_order_relaxed
+        );
+        if(claimed) {
+          return bestIdleIndex;
+        }
+        continue;
+      }
+
+      // All decoders are busy, so if there's room left in the pool, add another clone
+      if(firstEmptyIndex != none) {
+        Slot &slot = this->slots[firstEmptyIndex];
+
+        int expected = EmptySlotState;
+        bool claimed = slot.State.compare_exchange_strong(
+          expected, BusySlotState, std::memory_order_acquire, std::memory_order_relaxed
+        );
+        if(claimed) {
+          try {
+            slot.Decoder = this->prototype->Clone();
+          }
+          catch(...) {
+            slot.State.store(EmptySlotState, std::memory_order_release);
+            throw;
+          }
+          slot.Cursor.store(0, std::memory_order_relaxed);
+          return firstEmptyIndex;
+        }
+        continue;
+      }
+
+      // The pool is full and every decoder is busy. Let the other threads finish.
+      std::this_thread::yield();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::releaseSlot(std::size_t slotIndex, std::uint64_t cursor) const {
+    Slot &slot = this->slots[slotIndex];
+    slot.Cursor.store(cursor, std::memory_order_relaxed);
+    slot.State.store(IdleSlotState, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TDecodeMethod>
+  void PooledTrackDecoder::decodeWithPooledDecoder(
+    std::uint64_t startFrame, std::size_t frameCount, TDecodeMethod &&decode
+  ) const {
+    std::size_t slotIndex = this->acquireSlot(startFrame);
+    try {
+      decode(*this->slots[slotIndex].Decoder);
+    }
+    catch(...) {
+      this->releaseSlot(slotIndex, UnknownCursor); // Don't know where the decoder stopped
+      throw;
+    }
+    this->releaseSlot(slotIndex, startFrame + frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeRange(
+    std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=, &sink](const AudioTrackDecoder &decoder) {
+        decoder.DecodeRange(startFrame, frameCount, sink);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<std::int16_t>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<std::int32_t>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<float>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeInterleaved<double>(buffer, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<std::uint8_t>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<std::int16_t>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<std::int32_t>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<float>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    this->decodeWithPooledDecoder(
+      startFrame, frameCount,
+      [=](const AudioTrackDecoder &decoder) {
+        decoder.DecodeSeparated<double>(buffers, startFrame, frameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,284 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_POOLEDTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_POOLEDTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <atomic> // for std::atomic
+#include <memory> // for std::unique_ptr, std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Spreads decoding calls over a pool of cloned track decoders</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The track decoders of the codec libraries hold a cursor inside the file and can
+  ///     only decode one range at a time, so they serialize all calls through a mutex.
+  ///     When many threads read from the same audio track (for example, a sampler playing
+  ///     the same sound at several positions), they would all queue up on that mutex.
+  ///   </para>
+  ///   <para>
+  ///     This decorator keeps a fixed number of slots, each of which can hold a clone of
+  ///     the wrapped decoder. A decoding call claims an idle slot via an atomic exchange,
+  ///     preferring the slot whose decoder last stopped closest to the requested start
+  ///     frame, so that sequential readers keep hitting a decoder that needs no seek.
+  ///     Clones are created lazily, only when all existing decoders are busy. If every
+  ///     slot is taken, the calling thread yields and tries again.
+  ///   </para>
+  /// </remarks>
+  class PooledTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new decoder pool using the specified decoder</summary>
+    /// <param name="decoder">Decoder that will be cloned to fill the pool</param>
+    /// <param name="maximumDecoderCount">
+    ///   Maximum number of decoders the pool may hold, including the initial one
+    /// </param>
+    public: PooledTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder, std::size_t maximumDecoderCount
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~PooledTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override {
+      return this->prototype->CountChannels();
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->prototype->GetChannelOrder();
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const override {
+      return this->prototype->CountFrames();
+    }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->prototype->GetNativeSampleFormat();
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>True if the codec decodes straight to interleaved channels</summary>
+    public: bool IsNativelyInterleaved() const override {
+      return this->prototype->IsNativelyInterleaved();
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override {
+      return this->prototype->ExplainDecodePath(sampleFormat, interleaved);
+    }
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
+    /// <summary>Determines where the native block containing a frame begins</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The index of the first frame in the block containing the frame</returns>
+    public: std::uint64_t GetBlockStart(std::uint64_t frameIndex) const override {
+      return this->prototype->GetBlockStart(frameIndex);
+    }
+
+    /// <summary>Determines the length of the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The number of frames in the block containing the frame</returns>
+    public: std::size_t GetBlockSize(std::uint64_t frameIndex) const override {
+      return this->prototype->GetBlockSize(frameIndex);
+    }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    /// <remarks>
+    ///   Clones share their seek index with the decoder they were cloned from,
+    ///   so building it on the prototype makes it available to all pooled decoders.
+    /// </remarks>
+    public: void BuildSeekIndex() const override {
+      this->prototype->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->prototype->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->prototype->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->prototype->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Counts the number of decoders that have been created so far</summary>
+    /// <returns>The number of decoders currently held by the pool</returns>
+    public: std::size_t CountDecoders() const;
+
+    /// <summary>Hands decoded audio frames to a sink without copying them</summary>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="sink">Sink that receives views of the decoded samples</param>
+    public: void DecodeRange(
+      std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Claims an idle decoder, cloning a new one if all are busy</summary>
+    /// <param name="startFrame">Frame at which the caller wants to begin decoding</param>
+    /// <returns>The index of the slot that has been claimed</returns>
+    private: std::size_t acquireSlot(std::uint64_t startFrame) const;
+
+    /// <summary>Hands a previously claimed decoder back to the pool</summary>
+    /// <param name="slotIndex">Index of the slot that will be released</param>
+    /// <param name="cursor">Frame at which the slot's decoder stopped decoding</param>
+    private: void releaseSlot(std::size_t slotIndex, std::uint64_t cursor) const;
+
+    /// <summary>Runs a decoding call on an idle decoder from the pool</summary>
+    /// <typeparam name="TDecodeMethod">Type of the method that will do the decoding</typeparam>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    /// <param name="decode">Method that will do the decoding on the chosen decoder</param>
+    private: template<typename TDecodeMethod>
+    void decodeWithPooledDecoder(
+      std::uint64_t startFrame, std::size_t frameCount, TDecodeMethod &&decode
+    ) const;
+
+    /// <summary>Slot in the pool that can hold a decoder</summary>
+    private: struct Slot;
+
+    /// <summary>Decoder the pool was created from, answers all metadata queries</summary>
+    private: std::shared_ptr<AudioTrackDecoder> prototype;
+    /// <summary>Maximum number of decoders the pool may hold</summary>
+    private: std::size_t slotCount;
+    /// <summary>Slots that can each hold one decoder</summary>
+    private: std::unique_ptr<Slot[]> slots;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_POOLEDTRACKDECODER_H
@@ -0,0 +1,265 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ProxyGenerator.h"
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioSaver.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsFileApi.h" // for WindowsFileApi
+#else
+#include "../Platform/PosixFileApi.h" // for PosixFileApi
+#endif
+
+#include <exception> // for std::exception_ptr
+#include <optional> // for std::optional
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size and the last modification time of a file</summary>
+  /// <param name="path">Path of the file that will be looked up</param>
+  /// <param name="size">Receives the size of the file in bytes</param>
+  /// <param name="modificationTime">Receives the file's last modification time</param>
+  /// <returns>True if the file exists and its attributes could be read</returns>
+  bool tryGetFileIdentity(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    return Nuclex::Audio::Platform::WindowsFileApi::TryGetFileAttributes(
+      path, size, modificationTime
+    );
+#else
+    return Nuclex::Audio::Platform::PosixFileApi::TryStatFile(path, size, modificationTime);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the extension from a path for use as a codec hint</summary>
+  /// <param name="path">Path whose file extension will be returned</param>
+  /// <returns>The extension without the dot, or an empty string if there is none</returns>
+  std::string getExtension(const std::string &path) {
+    std::string::size_type dotIndex = path.find_last_of('.');
+    if(dotIndex == std::string::npos) {
+      return std::string();
+    }
+
+    std::string::size_type separatorIndex = path.find_last_of(u8"/\\");
+    if((separatorIndex != std::string::npos) && (separatorIndex > dotIndex)) {
+      return std::string();
+    }
+
+    return path.substr(dotIndex + 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the container informations of a file and checks it holds audio</summary>
+  /// <param name="loader">Loader through which the file will be inspected</param>
+  /// <param name="path">Path of the file that will be inspected</param>
+  /// <returns>The container informations of the file</returns>
+  Nuclex::Audio::ContainerInfo readAudioInfo(
+    const Nuclex::Audio::Storage::AudioLoader &loader, const std::string &path
+  ) {
+    std::optional<Nuclex::Audio::ContainerInfo> info = loader.TryReadInfo(path);
+    if(!info.has_value() || info.value().Tracks.empty()) {
+      throw Nuclex::Audio::Errors::UnsupportedFormatError(
+        u8"Not an audio file or file format not supported"
+      );
+    }
+
+    return info.value();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ProxyGenerator::ProxyGenerator(
+    std::size_t sampleRate /* = 24000 */,
+    float kilobitsPerSecond /* = 48.0f */,
+    std::size_t threadCount /* = 0 */
+  ) :
+    ProxyGenerator(AudioSaver().ProvideBuilder(u8"Opus"), u8"opus", sampleRate, threadCount) {
+    this->proxyBuilder->SetTargetBitrate(kilobitsPerSecond);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ProxyGenerator::ProxyGenerator(
+    const std::shared_ptr<AudioTrackEncoderBuilder> &proxyBuilder,
+    const std::string &proxyExtension,
+    std::size_t sampleRate,
+    std::size_t threadCount /* = 0 */
+  ) :
+    proxyBuilder(proxyBuilder),
+    proxyExtension(proxyExtension),
+    sampleRate(sampleRate),
+    threadCount(threadCount),
+    loader(std::make_shared<AudioLoader>()),
+    masterPaths(),
+    proxyPaths() {
+
+    if(unlikely(!static_cast<bool>(proxyBuilder))) {
+      throw std::invalid_argument(u8"Proxy generator needs an encoder builder");
+    }
+    if(unlikely(sampleRate == 0)) {
+      throw std::invalid_argument(u8"Proxy sample rate must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ProxyGenerator::~ProxyGenerator() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string ProxyGenerator::GetDefaultProxyPath(const std::string &masterPath) const {
+    std::string proxyPath = masterPath;
+    proxyPath.append(u8".proxy", 6);
+    if(!this->proxyExtension.empty()) {
+      proxyPath.push_back(u8'.');
+      proxyPath.append(this->proxyExtension);
+    }
+
+    return proxyPath;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ProxyGenerator::AddMaster(
+    const std::string &masterPath, const std::string &proxyPath /* = std::string() */
+  ) {
+    this->masterPaths.push_back(masterPath);
+    if(proxyPath.empty()) {
+      this->proxyPaths.push_back(GetDefaultProxyPath(masterPath));
+    } else {
+      this->proxyPaths.push_back(proxyPath);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TranscodeStatistics ProxyGenerator::Run(AssetCatalogWriter &catalogWriter) {
+    std::vector<std::string> masterPaths;
+    std::vector<std::string> proxyPaths;
+    masterPaths.swap(this->masterPaths);
+    proxyPaths.swap(this->proxyPaths);
+
+    // The proxies keep the channels of their masters and only drop the sample rate,
+    // so their frames line up with the master's by the ratio of the sample rates.
+    // Masters that can't even be opened are left out of the batch.
+    std::vector<std::exception_ptr> errors(masterPaths.size());
+    std::vector<std::size_t> jobMasterIndices;
+    TranscodeStatistics statistics;
+    {
+      BatchTranscoder transcoder(this->threadCount);
+      for(std::size_t index = 0; index < masterPaths.size(); ++index) {
+        try {
+          TranscodeJob job;
+          job.Source = VirtualFile::OpenRealFileForReading(masterPaths[index], true);
+          job.SourceExtensionHint = getExtension(masterPaths[index]);
+          job.TargetBuilder = this->proxyBuilder;
+          job.Target = VirtualFile::OpenRealFileForWriting(proxyPaths[index], true);
+          job.TargetSampleRate = this->sampleRate;
+          transcoder.AddJob(job);
+          jobMasterIndices.push_back(index);
+        }
+        catch(...) {
+          errors[index] = std::current_exception();
+        }
+      }
+
+      statistics = transcoder.Run();
+    }
+
+    for(std::size_t jobIndex = 0; jobIndex < jobMasterIndices.size(); ++jobIndex) {
+      errors[jobMasterIndices[jobIndex]] = statistics.Errors[jobIndex];
+    }
+    statistics.FailedJobCount += masterPaths.size() - jobMasterIndices.size();
+    statistics.Errors.swap(errors);
+
+    // Measure each proxy the way the audio loader will open it for previews and record
+    // the mapping. A proxy that can't be read back counts as a failed job.
+    for(std::size_t index = 0; index < masterPaths.size(); ++index) {
+      if(static_cast<bool>(statistics.Errors[index])) {
+        continue;
+      }
+
+      try {
+        const std::string &masterPath = masterPaths[index];
+        const std::string &proxyPath = proxyPaths[index];
+
+        ProxyMapping mapping;
+        mapping.ProxyPath = proxyPath;
+
+        ContainerInfo masterInfo = readAudioInfo(*this->loader, masterPath);
+        mapping.MasterSampleRate = masterInfo.Tracks[masterInfo.DefaultTrackIndex].SampleRate;
+        mapping.MasterFrameCount = this->loader->OpenDecoder(
+          masterPath, masterInfo.DefaultTrackIndex
+        )->CountFrames();
+
+        std::shared_ptr<AudioTrackDecoder> proxyDecoder = this->loader->OpenDecoder(proxyPath);
+        if(proxyDecoder->TrySetDecodeSampleRate(this->sampleRate)) {
+          mapping.ProxySampleRate = this->sampleRate;
+        } else {
+          ContainerInfo proxyInfo = readAudioInfo(*this->loader, proxyPath);
+          mapping.ProxySampleRate = proxyInfo.Tracks[proxyInfo.DefaultTrackIndex].SampleRate;
+        }
+        mapping.ProxyFrameCount = proxyDecoder->CountFrames();
+
+        std::optional<AssetRecord> record = catalogWriter.TryLookup(masterPath);
+        if(!record.has_value()) {
+          record.emplace();
+          if(!tryGetFileIdentity(masterPath, record->Size, record->ModificationTime)) {
+            throw std::runtime_error(u8"Could not look up the master file's attributes");
+          }
+          record->Info = masterInfo;
+        }
+        record->Proxy = mapping;
+        catalogWriter.Add(masterPath, record.value());
+      }
+      catch(...) {
+        statistics.Errors[index] = std::current_exception();
+        --statistics.SucceededJobCount;
+        ++statistics.FailedJobCount;
+      }
+    }
+
+    return statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
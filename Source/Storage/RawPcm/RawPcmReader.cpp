@@ -0,0 +1,126 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./RawPcmReader.h"
+
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Waveform/WaveformParser.h" // for WaveformParser::GuessChannelPlacement()
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the size of the container a sample format is stored in</summary>
+  /// <param name="sampleFormat">Sample format whose container size will be returned</param>
+  /// <returns>The number of bytes each sample of the format occupies</returns>
+  std::size_t getBytesPerSample(Nuclex::Audio::AudioSampleFormat sampleFormat) {
+    using Nuclex::Audio::AudioSampleFormat;
+
+    switch(sampleFormat) {
+      case AudioSampleFormat::UnsignedInteger_8: { return 1; }
+      case AudioSampleFormat::SignedInteger_16: { return 2; }
+      case AudioSampleFormat::SignedInteger_24: { return 3; }
+      case AudioSampleFormat::SignedInteger_32: { return 4; }
+      case AudioSampleFormat::Float_32: { return 4; }
+      case AudioSampleFormat::Float_64: { return 8; }
+      default: {
+        throw Nuclex::Audio::Errors::UnsupportedFormatError(
+          u8"Raw PCM sample format is not supported"
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace RawPcm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Waveform::StoredSampleLayout RawPcmReader::ReadLayout(
+    const std::shared_ptr<const VirtualFile> &source, const RawPcmLayout &rawLayout
+  ) {
+    if((rawLayout.ChannelCount == 0) || (rawLayout.SampleRate == 0)) {
+      throw std::invalid_argument(u8"Raw PCM layout needs a channel count and sample rate");
+    }
+
+    std::size_t bytesPerSample = getBytesPerSample(rawLayout.SampleFormat);
+    std::size_t bitsPerSample = rawLayout.BitsPerSample;
+    if(bitsPerSample == 0) {
+      bitsPerSample = bytesPerSample * 8;
+    } else if(bitsPerSample > bytesPerSample * 8) {
+      throw std::invalid_argument(
+        u8"Raw PCM layout specifies more bits per sample than the sample format can hold"
+      );
+    }
+
+    Waveform::StoredSampleLayout layout;
+    layout.FormatName = u8"Raw PCM";
+    layout.IsLittleEndian = rawLayout.IsLittleEndian;
+    layout.AreBytesSigned = false; // 8-bit samples are offset by 128, like in Waveform files
+    layout.FirstSampleOffset = rawLayout.ByteOffset;
+    layout.BytesPerFrame = bytesPerSample * rawLayout.ChannelCount;
+
+    // Without a header, the file's size is all there is to tell where the samples end.
+    // If the caller specified a frame count, only the frames that are actually there
+    // can be decoded should the file be shorter than that.
+    std::uint64_t fileSize = source->GetSize();
+    std::uint64_t availableFrameCount = 0;
+    if(rawLayout.ByteOffset < fileSize) {
+      availableFrameCount = (fileSize - rawLayout.ByteOffset) / layout.BytesPerFrame;
+    }
+    if(rawLayout.FrameCount.has_value()) {
+      layout.FrameCount = std::min(rawLayout.FrameCount.value(), availableFrameCount);
+    } else {
+      layout.FrameCount = availableFrameCount;
+    }
+
+    layout.Track.CodecName = std::string(u8"Raw PCM", 7);
+    layout.Track.ChannelCount = rawLayout.ChannelCount;
+    if(rawLayout.ChannelPlacements == ChannelPlacement::Unknown) {
+      layout.Track.ChannelPlacements = (
+        Waveform::WaveformParser::GuessChannelPlacement(rawLayout.ChannelCount)
+      );
+    } else {
+      layout.Track.ChannelPlacements = rawLayout.ChannelPlacements;
+    }
+    layout.Track.SampleRate = rawLayout.SampleRate;
+    layout.Track.SampleFormat = rawLayout.SampleFormat;
+    layout.Track.BitsPerSample = bitsPerSample;
+    layout.Track.FrameCount = layout.FrameCount;
+    layout.Track.Duration = std::chrono::microseconds(
+      layout.FrameCount * 1'000'000 / layout.Track.SampleRate
+    );
+
+    return layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::RawPcm
@@ -0,0 +1,66 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_RAWPCM_RAWPCMREADER_H
+#define NUCLEX_AUDIO_STORAGE_RAWPCM_RAWPCMREADER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/RawPcmLayout.h"
+
+#include "../Waveform/WaveformReader.h" // for StoredSampleLayout
+
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace RawPcm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a caller-provided raw PCM layout into a stored sample layout</summary>
+  /// <remarks>
+  ///   Headerless PCM is read through the <see cref="Waveform.WaveformReader" /> just like
+  ///   AIFF files are, so it gets the same zero-copy and SIMD conversion paths. All this
+  ///   reader does is check the layout the caller provided against the file.
+  /// </remarks>
+  class RawPcmReader {
+
+    /// <summary>Builds the stored sample layout for a headerless PCM file</summary>
+    /// <param name="source">File holding the samples</param>
+    /// <param name="rawLayout">Layout of the samples as described by the caller</param>
+    /// <returns>The sample layout the Waveform reader can use to read the file</returns>
+    public: static Waveform::StoredSampleLayout ReadLayout(
+      const std::shared_ptr<const VirtualFile> &source, const RawPcmLayout &rawLayout
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::RawPcm
+
+#endif // NUCLEX_AUDIO_STORAGE_RAWPCM_RAWPCMREADER_H
@@ -0,0 +1,107 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "ReadAheadFile.h"
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ReadAheadFile::ReadAheadFile(
+    const std::shared_ptr<const VirtualFile> &file,
+    std::size_t blockSize,
+    std::size_t readAheadBlockCount
+  ) :
+    file(file),
+    length(file->GetSize()),
+    blockSize(blockSize),
+    window(blockSize * (readAheadBlockCount + 1)),
+    windowStart(0),
+    windowLength(0),
+    windowMutex() {
+    if(blockSize == 0) {
+      throw std::invalid_argument(u8"Read-ahead block size must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ReadAheadFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::lock_guard<std::mutex> windowMutexScope(this->windowMutex);
+
+    // If the requested range is completely inside the cached window, serve it from there
+    bool isInWindow = (
+      (start >= this->windowStart) &&
+      (start - this->windowStart <= this->windowLength) &&
+      (this->windowLength - (start - this->windowStart) >= byteCount)
+    );
+    if(likely(isInWindow)) {
+      std::copy_n(this->window.data() + (start - this->windowStart), byteCount, buffer);
+      return;
+    }
+
+    // The window begins at the block the read falls into. If the read would not fit
+    // into the window from there (or goes past the end of the file, in which case we
+    // let the wrapped file generate the error), pass it through unbuffered.
+    std::uint64_t alignedStart = start - (start % this->blockSize);
+    std::size_t leadingByteCount = static_cast<std::size_t>(start - alignedStart);
+    bool fitsInWindow = (
+      (start <= this->length) &&
+      (this->length - start >= byteCount) &&
+      (this->window.size() - leadingByteCount >= byteCount)
+    );
+    if(!fitsInWindow) {
+      this->file->ReadAt(start, byteCount, buffer);
+      return;
+    }
+
+    // Refill the window with as many blocks as fit or remain in the file
+    std::size_t fillByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(this->window.size(), this->length - alignedStart)
+    );
+    this->windowLength = 0; // In case ReadAt() throws
+    this->file->ReadAt(alignedStart, fillByteCount, this->window.data());
+    this->windowStart = alignedStart;
+    this->windowLength = fillByteCount;
+
+    std::copy_n(this->window.data() + leadingByteCount, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ReadAheadFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Read-ahead buffered files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,128 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_READAHEADFILE_H
+#define NUCLEX_AUDIO_STORAGE_READAHEADFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Serves small reads from a cached window filled with large reads</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The codec libraries tend to issue lots of tiny reads (a few bytes for a header,
+  ///     a few kilobytes for a frame). For local files that's fine, but when the virtual
+  ///     file sits on top of a network share or an archive, each read can be expensive.
+  ///   </para>
+  ///   <para>
+  ///     This decorator keeps a window of several blocks. When a read misses the window,
+  ///     the window is refilled starting at the block containing the read's start offset
+  ///     and extending a configurable number of blocks beyond it. Reads that are larger
+  ///     than the window are passed through to the wrapped file directly.
+  ///   </para>
+  /// </remarks>
+  class ReadAheadFile : public VirtualFile {
+
+    /// <summary>Initializes a new read-ahead buffer around the specified file</summary>
+    /// <param name="file">File whose reads will be buffered</param>
+    /// <param name="blockSize">Size of the blocks the file will be read in</param>
+    /// <param name="readAheadBlockCount">
+    ///   Number of blocks that will be read beyond the block a read falls into
+    /// </param>
+    public: ReadAheadFile(
+      const std::shared_ptr<const VirtualFile> &file,
+      std::size_t blockSize,
+      std::size_t readAheadBlockCount
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~ReadAheadFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the wrapped file's memory if it supports borrowing,
+    ///   otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      return this->file->TryBorrowAt(start, byteCount);
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   The read-ahead buffer only wraps read-only files, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>File whose reads are being buffered</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Length of the wrapped file in bytes</summary>
+    private: std::uint64_t length;
+    /// <summary>Size of the blocks the window is aligned to</summary>
+    private: std::size_t blockSize;
+    /// <summary>Memory holding the currently cached window of the file</summary>
+    private: mutable std::vector<std::byte> window;
+    /// <summary>Absolute file offset at which the cached window begins</summary>
+    private: mutable std::uint64_t windowStart;
+    /// <summary>Number of valid bytes in the cached window</summary>
+    private: mutable std::size_t windowLength;
+    /// <summary>Mutex that must be held while accessing the window</summary>
+    private: mutable std::mutex windowMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_READAHEADFILE_H
@@ -27,32 +27,180 @@ License along with this library
 
 #include "../Platform/LinuxFileApi.h" // for open(), etc.
 #include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError(), etc.
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
 
 #include <unistd.h> // ::read(), ::write(), ::close(), etc.
+#include <fcntl.h> // for POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM, etc.
 
+#include <algorithm> // for std::stable_sort()
 #include <cassert> // for assert()
+#include <climits> // for IOV_MAX
+#include <exception> // for std::exception
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Maximum number of reads that will be in flight through the io_uring</summary>
+  constexpr std::uint32_t IoRingQueueDepth = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a list of buffers from a contiguous range of a file</summary>
+  /// <param name="fileDescriptor">File descriptor of the file that will be read</param>
+  /// <param name="ioVectors">Buffers that will be filled, will be modified</param>
+  /// <param name="start">Offset in the file at which the range begins</param>
+  void readVectorFully(
+    int fileDescriptor, std::vector<::iovec> &ioVectors, std::uint64_t start
+  ) {
+    std::size_t vectorIndex = 0;
+    while(vectorIndex < ioVectors.size()) {
+      std::size_t readByteCount = Nuclex::Audio::Platform::LinuxFileApi::PositionalReadVector(
+        fileDescriptor,
+        ioVectors.data() + vectorIndex,
+        static_cast<int>(ioVectors.size() - vectorIndex),
+        start
+      );
+      if(unlikely(readByteCount == 0)) {
+        bool onlyEmptyBuffersRemain = true;
+        for(std::size_t index = vectorIndex; index < ioVectors.size(); ++index) {
+          onlyEmptyBuffersRemain &= (ioVectors[index].iov_len == 0);
+        }
+        if(onlyEmptyBuffersRemain) {
+          return;
+        }
+        Nuclex::Audio::Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+          u8"Encountered unexpected end of file", EIO
+        );
+      }
+      start += readByteCount;
+
+      // Skip the buffers that have been filled completely and adjust the one
+      // that was filled only partially (if any) so the next read continues there
+      while((vectorIndex < ioVectors.size()) && (readByteCount >= ioVectors[vectorIndex].iov_len)) {
+        readByteCount -= ioVectors[vectorIndex].iov_len;
+        ++vectorIndex;
+      }
+      if(readByteCount > 0) {
+        ::iovec &partialVector = ioVectors[vectorIndex];
+        std::byte *partialBuffer = reinterpret_cast<std::byte *>(partialVector.iov_base);
+        partialVector.iov_base = partialBuffer + readByteCount;
+        partialVector.iov_len -= readByteCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Performs a batch of reads, merging adjacent ones into vectored reads</summary>
+  /// <param name="fileDescriptor">File descriptor of the file that will be read</param>
+  /// <param name="requests">Ranges that will be read and where to store them</param>
+  /// <param name="requestCount">Number of read requests in the batch</param>
+  void readCoalesced(
+    int fileDescriptor,
+    const Nuclex::Audio::Storage::ReadRequest *requests,
+    std::size_t requestCount
+  ) {
+    using Nuclex::Audio::Storage::ReadRequest;
+
+    // Sort the requests by their offset so that adjacent requests line up
+    std::vector<const ReadRequest *> sortedRequests(requestCount);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      sortedRequests[index] = requests + index;
+    }
+    std::stable_sort(
+      sortedRequests.begin(), sortedRequests.end(),
+      [](const ReadRequest *left, const ReadRequest *right) { return left->Start < right->Start; }
+    );
+
+    // Each run of requests where one begins exactly where the previous one ended
+    // becomes a single preadv() call filling all of their buffers
+    std::vector<::iovec> ioVectors;
+    std::size_t index = 0;
+    while(index < requestCount) {
+      std::uint64_t start = sortedRequests[index]->Start;
+      std::uint64_t end = start;
+
+      ioVectors.clear();
+      do {
+        ::iovec ioVector;
+        ioVector.iov_base = sortedRequests[index]->Buffer;
+        ioVector.iov_len = sortedRequests[index]->ByteCount;
+        ioVectors.push_back(ioVector);
+
+        end += sortedRequests[index]->ByteCount;
+        ++index;
+      } while(
+        (index < requestCount) &&
+        (sortedRequests[index]->Start == end) &&
+        (ioVectors.size() < IOV_MAX)
+      );
+
+      readVectorFully(fileDescriptor, ioVectors, start);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
   RealFile::RealFile(
-    const std::string &path, bool promiseSequentialAccess, bool readOnly
-  ) : position(0) {
-    (void)promiseSequentialAccess; // Not supported here.
-
+    const std::string &path,
+    FileAccessPattern accessPattern,
+    bool readOnly,
+    std::uint64_t expectedByteCount /* = 0 */
+  ) :
+    ioRing(),
+    ioRingUnavailable(false),
+    ioRingMutex(),
+    preallocated(false),
+    position(0) {
     if(readOnly) {
       this->fileDescriptor = Platform::LinuxFileApi::OpenFileForReading(path);
       this->length = Platform::LinuxFileApi::StatFileSize(this->fileDescriptor);
     } else {
       this->fileDescriptor = Platform::LinuxFileApi::OpenFileForWriting(path);
       this->length = 0;
+
+      // Reserving the space up front lets the file system hand out one contiguous
+      // extent instead of interleaving it with other files being written at the same time
+      if(expectedByteCount > 0) {
+        this->preallocated = Platform::LinuxFileApi::TryPreallocate(
+          this->fileDescriptor, expectedByteCount
+        );
+      }
+    }
+
+    // Let the kernel know how we're going to access the file. Sequential access doubles
+    // the read-ahead window, random access disables read-ahead entirely.
+    if(accessPattern == FileAccessPattern::Sequential) {
+      Platform::LinuxFileApi::AdviseAccessPattern(
+        this->fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL
+      );
+    } else if(accessPattern == FileAccessPattern::Random) {
+      Platform::LinuxFileApi::AdviseAccessPattern(
+        this->fileDescriptor, 0, 0, POSIX_FADV_RANDOM
+      );
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   RealFile::~RealFile() {
+    if(this->preallocated) {
+      try {
+        Flush();
+      }
+      catch(const std::exception &) {
+        assert(!u8"Reserved disk space is released when the file is destroyed");
+      }
+    }
+
     int result = ::close(this->fileDescriptor);
     NUCLEX_AUDIO_NDEBUG_UNUSED(result);
     assert((result != -1) && u8"File descriptor is closed successfully");
@@ -63,6 +211,8 @@ namespace Nuclex { namespace Audio { namespace Storage {
   void RealFile::ReadAt(
     std::uint64_t start, std::size_t byteCount, std::byte *buffer
   ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
     if(start == this->position) { // Prefer read() to support stdin etc.
       std::size_t remainingByteCount = byteCount;
       for(;;) {
@@ -86,7 +236,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::size_t remainingByteCount = byteCount;
       for(;;) {
         std::size_t readByteCount = Platform::LinuxFileApi::PositionalRead(
-          this->fileDescriptor, buffer, byteCount, start
+          this->fileDescriptor, buffer, remainingByteCount, start
         );
         if(likely(readByteCount == remainingByteCount)) {
           return;
@@ -105,6 +255,46 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void RealFile::ReadManyAt(
+    const ReadRequest *requests, std::size_t requestCount
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file batch", this, nullptr);
+
+    if(requestCount >= 2) {
+      std::lock_guard<std::mutex> ioRingMutexScope(this->ioRingMutex);
+
+      // Set up the io_uring on first use. If the kernel doesn't offer io_uring,
+      // remember that so we don't repeat the attempt for every batch.
+      if(!this->ioRing && !this->ioRingUnavailable) {
+        this->ioRing = Platform::LinuxIoRing::TryCreate(IoRingQueueDepth);
+        this->ioRingUnavailable = !this->ioRing;
+      }
+      if(this->ioRing) {
+        try {
+          this->ioRing->ReadMany(this->fileDescriptor, requests, requestCount);
+        }
+        catch(const std::exception &) {
+          this->ioRing.reset(); // Submissions may be left in the ring, start over next time
+          throw;
+        }
+        return;
+      }
+    }
+
+    // Without io_uring, we can at least merge adjacent reads into vectored reads
+    readCoalesced(this->fileDescriptor, requests, requestCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    Platform::LinuxFileApi::AdviseAccessPattern(
+      this->fileDescriptor, start, byteCount, POSIX_FADV_WILLNEED
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void RealFile::WriteAt(
     std::uint64_t start, std::size_t byteCount, const std::byte *buffer
   ) {
@@ -139,6 +329,14 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void RealFile::Flush() {
+    if(this->preallocated) {
+      Platform::LinuxFileApi::Truncate(this->fileDescriptor, this->length);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Storage
 
 #endif // defined(NUCLEX_AUDIO_LINUX)
@@ -26,17 +26,24 @@ License along with this library
 #if !defined(NUCLEX_AUDIO_LINUX) && !defined(NUCLEX_AUDIO_WINDOWS)
 
 #include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError(), etc.
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
 
+#include <algorithm> // for std::stable_sort()
 #include <cassert> // for assert()
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
   RealFile::RealFile(
-    const std::string &path, bool promiseSequentialAccess, bool readOnly
+    const std::string &path,
+    FileAccessPattern accessPattern,
+    bool readOnly,
+    std::uint64_t expectedByteCount /* = 0 */
   ) : position(0) {
-    (void)promiseSequentialAccess; // Not supported here.
+    (void)accessPattern; // Not supported here.
+    (void)expectedByteCount; // posix_fallocate() would change the file's length
     if(readOnly) {
       this->file = Platform::PosixFileApi::OpenFileForReading(path);
       Platform::PosixFileApi::Seek(this->file, 0, SEEK_END);
@@ -61,6 +68,8 @@ namespace Nuclex { namespace Audio { namespace Storage {
   void RealFile::ReadAt(
     std::uint64_t start, std::size_t byteCount, std::byte *buffer
   ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
     std::lock_guard<std::mutex> readMutexScope(this->readMutex);
 
     if(start != this->position) {
@@ -90,6 +99,36 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void RealFile::ReadManyAt(
+    const ReadRequest *requests, std::size_t requestCount
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file batch", this, nullptr);
+
+    // Visit the requests in the order of their offsets. Adjacent requests then
+    // follow each other without a seek and the stdio buffer serves nearby ones.
+    std::vector<const ReadRequest *> sortedRequests(requestCount);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      sortedRequests[index] = requests + index;
+    }
+    std::stable_sort(
+      sortedRequests.begin(), sortedRequests.end(),
+      [](const ReadRequest *left, const ReadRequest *right) { return left->Start < right->Start; }
+    );
+
+    for(const ReadRequest *request : sortedRequests) {
+      this->ReadAt(request->Start, request->ByteCount, request->Buffer);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    (void)start;
+    (void)byteCount; // Not supported here.
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void RealFile::WriteAt(
     std::uint64_t start, std::size_t byteCount, const std::byte *buffer
   ) {
@@ -26,32 +26,58 @@ License along with this library
 #if defined(NUCLEX_AUDIO_WINDOWS)
 
 #include "../Platform/WindowsFileApi.h"
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
 
 #include <cassert> // for assert()
+#include <exception> // for std::exception
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
   RealFile::RealFile(
-    const std::string &path, bool promiseSequentialAccess, bool readOnly
-  ) : position(0) {
+    const std::string &path,
+    FileAccessPattern accessPattern,
+    bool readOnly,
+    std::uint64_t expectedByteCount /* = 0 */
+  ) :
+    preallocated(false),
+    position(0) {
     if(readOnly) {
       this->fileHandle = Platform::WindowsFileApi::OpenFileForReading(
-        path, promiseSequentialAccess
+        path,
+        (accessPattern == FileAccessPattern::Sequential),
+        (accessPattern == FileAccessPattern::Random)
       );
       this->length = Platform::WindowsFileApi::GetFileSize(this->fileHandle);
     } else {
       this->fileHandle = Platform::WindowsFileApi::OpenFileForWriting(
-        path, promiseSequentialAccess
+        path, (accessPattern == FileAccessPattern::Sequential)
       );
       this->length = 0;
+
+      // Reserving the space up front lets the file system hand out one contiguous
+      // extent instead of interleaving it with other files being written at the same time
+      if(expectedByteCount > 0) {
+        this->preallocated = Platform::WindowsFileApi::TryPreallocate(
+          this->fileHandle, expectedByteCount
+        );
+      }
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   RealFile::~RealFile() {
+    if(this->preallocated) {
+      try {
+        Flush();
+      }
+      catch(const std::exception &) {
+        assert(!u8"Reserved disk space is released when the file is destroyed");
+      }
+    }
+
     BOOL result = ::CloseHandle(this->fileHandle);
     NUCLEX_AUDIO_NDEBUG_UNUSED(result);
     assert((result != FALSE) && u8"File handle is closed successfully");
@@ -62,6 +88,8 @@ namespace Nuclex { namespace Audio { namespace Storage {
   void RealFile::ReadAt(
     std::uint64_t start, std::size_t byteCount, std::byte *buffer
   ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file", this, nullptr);
+
     std::lock_guard<std::mutex> readMutexScope(this->readMutex);
 
     if(start != this->position) {
@@ -90,6 +118,15 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void RealFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    (void)start;
+    (void)byteCount;
+    // Windows has no equivalent to posix_fadvise(POSIX_FADV_WILLNEED) for file handles.
+    // The cache manager's read-ahead (boosted by FILE_FLAG_SEQUENTIAL_SCAN) is all we get.
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void RealFile::WriteAt(
     std::uint64_t start, std::size_t byteCount, const std::byte *buffer
   ) {
@@ -120,6 +157,14 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void RealFile::Flush() {
+    if(this->preallocated) {
+      Platform::WindowsFileApi::SetFileLength(this->fileHandle, this->length);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Storage
 
 #endif // defined(NUCLEX_AUDIO_WINDOWS)
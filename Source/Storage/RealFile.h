@@ -25,13 +25,14 @@ License along with this library
 #include "Nuclex/Audio/Storage/VirtualFile.h"
 
 #if defined(NUCLEX_AUDIO_LINUX)
-// File handles are ints, we don't need no headers!
+#include "../Platform/LinuxIoRing.h" // for LinuxIoRing
 #elif defined(NUCLEX_AUDIO_WINDOWS)
 #include "../Platform/WindowsApi.h" // for HANDLE, etc.
 #else // No Windows, no Linux -> use Posix!
 #include <cstdio> // for FILE, ::fopen(), etc.
 #endif
 
+#include <memory> // for std::unique_ptr
 #include <mutex> // for std::mutex
 
 namespace Nuclex { namespace Audio { namespace Storage {
@@ -43,12 +44,18 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
     /// <summary>Initializes a new instance accessing the file at the specified path</summary>
     /// <param name="path">Path of the file that will be accessed or created</param>
-    /// <param name="promiseSequentialAccess">
-    ///   Whether you promise to write to the file sequentially only
+    /// <param name="accessPattern">
+    ///   How the file will be accessed, passed to the OS as a caching hint
     /// </param>
     /// <param name="readOnly">Whether write accesses to the file will be denied</param>
+    /// <param name="expectedByteCount">
+    ///   Size the file is expected to reach when writing, 0 if unknown
+    /// </param>
     public: RealFile(
-      const std::string &path, bool promiseSequentialAccess, bool readOnly
+      const std::string &path,
+      FileAccessPattern accessPattern,
+      bool readOnly,
+      std::uint64_t expectedByteCount = 0
     );
 
     /// <summary>Closes the file and frees all memory used by the instance</summary>
@@ -66,6 +73,20 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::uint64_t, std::size_t byteCount, std::byte *buffer
     ) const override;
 
+#if !defined(NUCLEX_AUDIO_WINDOWS)
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    public: void ReadManyAt(
+      const ReadRequest *requests, std::size_t requestCount
+    ) const override;
+#endif
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override;
+
     /// <summary>Writes data into the file at an absolute position</summary>
     /// <param name="start">Offset at which writing will begin in the file</param>
     /// <param name="byteCount">Number of bytes that should be written</param>
@@ -74,15 +95,30 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::uint64_t start, std::size_t byteCount, const std::byte *buffer
     ) override;
 
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+    /// <summary>Releases disk space that was reserved beyond the written data</summary>
+    public: void Flush() override;
+#endif
+
 #if defined(NUCLEX_AUDIO_LINUX)
     /// <summary>File descriptor returned by ::open()</summary>
     private: int fileDescriptor;
+    /// <summary>io_uring through which batched reads are submitted</summary>
+    private: mutable std::unique_ptr<Platform::LinuxIoRing> ioRing;
+    /// <summary>Whether setting up an io_uring has been tried and failed</summary>
+    private: mutable bool ioRingUnavailable;
+    /// <summary>Mutex that must be held while using the io_uring</summary>
+    private: mutable std::mutex ioRingMutex;
 #elif defined(NUCLEX_AUDIO_WINDOWS)
     /// <summary>File handle returned by ::CreateFile() or ::OpenFile()</summary>
     private: ::HANDLE fileHandle;
 #else // Go with old-school Posix and hope for the best
     /// <summary>File pointer returned by ::fopen()</summary>
     private: ::FILE *file;
+#endif
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+    /// <summary>Whether disk space beyond the file's length has been reserved</summary>
+    private: bool preallocated;
 #endif
     /// <summary>Length of the file in bytes</summary>
     private: std::uint64_t length;
@@ -0,0 +1,319 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/RealtimeTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <chrono> // for std::chrono::milliseconds
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How long the background thread sleeps when it has nothing to do</summary>
+  /// <remarks>
+  ///   The reader wakes the background thread up when it consumes frames, but it does
+  ///   so without taking the mutex, so a wake-up can be missed. The timeout makes sure
+  ///   the background thread notices anyway.
+  /// </remarks>
+  const std::chrono::milliseconds IdleTimeout(5);
+
+  /// <summary>How long WaitUntilReady() sleeps between checks</summary>
+  const std::chrono::milliseconds ReadyPollInterval(1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  RealtimeTrackDecoder::RealtimeTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t bufferedFrameCount /* = 16384 */,
+    std::uint64_t startFrame /* = 0 */
+  ) :
+    decoder(decoder),
+    channelCount(0),
+    totalFrameCount(0),
+    capacity(bufferedFrameCount),
+    ring(),
+    requestedEpoch(1),
+    requestedStartFrame(startFrame),
+    residentEpoch(0),
+    residentEndFrame(startFrame),
+    consumedFrame(startFrame),
+    failed(false),
+    stopping(false),
+    error(),
+    wakeMutex(),
+    wakeCondition(),
+    decodeThread() {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Real-time decoder requires a decoder to run");
+    }
+    if(unlikely(bufferedFrameCount == 0)) {
+      throw std::invalid_argument(u8"Real-time decoder needs to buffer at least one frame");
+    }
+
+    this->channelCount = decoder->CountChannels();
+    this->totalFrameCount = decoder->CountFrames();
+    this->ring.reset(new float[bufferedFrameCount * this->channelCount]);
+
+    this->decodeThread = std::thread(&RealtimeTrackDecoder::decodeAhead, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  RealtimeTrackDecoder::~RealtimeTrackDecoder() {
+    {
+      std::lock_guard<std::mutex> wakeMutexScope(this->wakeMutex);
+      this->stopping.store(true, std::memory_order_relaxed);
+    }
+    this->wakeCondition.notify_one();
+    this->decodeThread.join();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealtimeTrackDecoder::WaitUntilReady(std::uint64_t startFrame, std::size_t frameCount) {
+    if(unlikely(frameCount > this->capacity)) {
+      throw std::invalid_argument(u8"Requested more frames than the ring buffer can hold");
+    }
+    if(unlikely(startFrame + frameCount > this->totalFrameCount)) {
+      throw std::invalid_argument(u8"Requested frames extend beyond the end of the track");
+    }
+
+    while(tryAcquire(startFrame, frameCount) < 0) {
+      std::uint32_t epoch = this->requestedEpoch.load(std::memory_order_relaxed);
+      bool isCurrent = (this->residentEpoch.load(std::memory_order_acquire) == epoch);
+      if(isCurrent && this->failed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> wakeMutexScope(this->wakeMutex);
+        std::rethrow_exception(this->error);
+      }
+
+      std::this_thread::sleep_for(ReadyPollInterval);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool RealtimeTrackDecoder::TryDecodeInterleaved(
+    float *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    std::ptrdiff_t ringIndex = tryAcquire(startFrame, frameCount);
+    if(ringIndex < 0) {
+      return false;
+    }
+
+    // The frames may wrap around the end of the ring buffer, in which case
+    // they need to be copied in two pieces
+    std::size_t firstFrameCount = std::min(
+      frameCount, this->capacity - static_cast<std::size_t>(ringIndex)
+    );
+    std::copy_n(
+      this->ring.get() + (static_cast<std::size_t>(ringIndex) * this->channelCount),
+      firstFrameCount * this->channelCount,
+      buffer
+    );
+    std::copy_n(
+      this->ring.get(),
+      (frameCount - firstFrameCount) * this->channelCount,
+      buffer + (firstFrameCount * this->channelCount)
+    );
+
+    release(startFrame + frameCount);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool RealtimeTrackDecoder::TryDecodeSeparated(
+    float *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    std::ptrdiff_t ringIndex = tryAcquire(startFrame, frameCount);
+    if(ringIndex < 0) {
+      return false;
+    }
+
+    std::size_t sourceFrameIndex = static_cast<std::size_t>(ringIndex);
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      const float *source = this->ring.get() + (sourceFrameIndex * this->channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        if(buffers[channelIndex] != nullptr) {
+          buffers[channelIndex][frameIndex] = source[channelIndex];
+        }
+      }
+
+      ++sourceFrameIndex;
+      if(sourceFrameIndex == this->capacity) {
+        sourceFrameIndex = 0;
+      }
+    }
+
+    release(startFrame + frameCount);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::ptrdiff_t RealtimeTrackDecoder::tryAcquire(
+    std::uint64_t startFrame, std::size_t frameCount
+  ) {
+
+    // Requests that can never be satisfied are not ready, ever. We don't throw here
+    // because exceptions would allocate and the reader is in a real-time thread.
+    if(unlikely(frameCount > this->capacity)) {
+      return -1;
+    }
+    if(unlikely(startFrame + frameCount > this->totalFrameCount)) {
+      return -1;
+    }
+
+    std::uint32_t epoch = this->requestedEpoch.load(std::memory_order_relaxed);
+    std::uint64_t consumed = this->consumedFrame.load(std::memory_order_relaxed);
+
+    // Frames before the consumed frame may already have been overwritten and frames
+    // more than a ring buffer ahead would take longer to reach by decoding than by seeking
+    if((startFrame < consumed) || (startFrame > consumed + this->capacity)) {
+      requestReposition(startFrame);
+      return -1;
+    }
+
+    // If the background thread is still busy repositioning, the ring buffer holds
+    // nothing we can use, but it'll get to the requested frames soon enough
+    if(this->residentEpoch.load(std::memory_order_acquire) != epoch) {
+      return -1;
+    }
+
+    // We'll never need the frames before the requested start again,
+    // so let the background thread know it can overwrite them
+    if(consumed < startFrame) {
+      release(startFrame);
+    }
+
+    std::uint64_t residentEnd = this->residentEndFrame.load(std::memory_order_acquire);
+    if(startFrame + frameCount > residentEnd) {
+      return -1;
+    }
+
+    return static_cast<std::ptrdiff_t>(startFrame % this->capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealtimeTrackDecoder::release(std::uint64_t endFrame) {
+    this->consumedFrame.store(endFrame, std::memory_order_release);
+    this->wakeCondition.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealtimeTrackDecoder::requestReposition(std::uint64_t startFrame) {
+    this->requestedStartFrame.store(startFrame, std::memory_order_relaxed);
+    this->consumedFrame.store(startFrame, std::memory_order_relaxed);
+    this->requestedEpoch.fetch_add(1, std::memory_order_release);
+    this->wakeCondition.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealtimeTrackDecoder::decodeAhead() {
+    std::uint32_t epoch = 0;
+    std::uint64_t cursor = 0;
+
+    // Decode in chunks of a quarter of the ring buffer. Larger chunks would make
+    // the background thread wait too long before it can start the next chunk,
+    // smaller chunks would waste time on per-call overhead.
+    std::size_t chunkFrameCount = std::max<std::size_t>(this->capacity / 4, 1);
+
+    while(!this->stopping.load(std::memory_order_relaxed)) {
+
+      // If the reader asked for a different position, discard the ring buffer's
+      // contents and continue from the requested frame
+      std::uint32_t newEpoch = this->requestedEpoch.load(std::memory_order_acquire);
+      if(newEpoch != epoch) {
+        epoch = newEpoch;
+        cursor = this->requestedStartFrame.load(std::memory_order_relaxed);
+        this->failed.store(false, std::memory_order_relaxed);
+        this->residentEndFrame.store(cursor, std::memory_order_relaxed);
+        this->residentEpoch.store(epoch, std::memory_order_release);
+      }
+
+      // Figure out how many frames we can decode without overwriting any the reader
+      // still needs. We go by ring buffer index to stay within its bounds.
+      std::size_t frameCount = 0;
+      if(!this->failed.load(std::memory_order_relaxed)) {
+        std::uint64_t consumed = this->consumedFrame.load(std::memory_order_acquire);
+        if(cursor < consumed + this->capacity) {
+          std::uint64_t remaining = (
+            (cursor < this->totalFrameCount) ? (this->totalFrameCount - cursor) : 0
+          );
+          std::uint64_t freeFrameCount = consumed + this->capacity - cursor;
+          std::size_t ringIndex = static_cast<std::size_t>(cursor % this->capacity);
+
+          std::uint64_t wanted = std::min<std::uint64_t>(chunkFrameCount, remaining);
+          if(freeFrameCount >= wanted) {
+            frameCount = static_cast<std::size_t>(
+              std::min<std::uint64_t>(wanted, this->capacity - ringIndex)
+            );
+          }
+        }
+      }
+
+      // Nothing to do? Then sleep until the reader consumes frames or repositions
+      if(frameCount == 0) {
+        std::unique_lock<std::mutex> wakeMutexScope(this->wakeMutex);
+        if(!this->stopping.load(std::memory_order_relaxed)) {
+          this->wakeCondition.wait_for(wakeMutexScope, IdleTimeout);
+        }
+        continue;
+      }
+
+      std::size_t ringIndex = static_cast<std::size_t>(cursor % this->capacity);
+      try {
+        this->decoder->DecodeInterleaved<float>(
+          this->ring.get() + (ringIndex * this->channelCount), cursor, frameCount
+        );
+      }
+      catch(...) {
+        {
+          std::lock_guard<std::mutex> wakeMutexScope(this->wakeMutex);
+          this->error = std::current_exception();
+        }
+        this->failed.store(true, std::memory_order_release);
+        continue;
+      }
+
+      cursor += frameCount;
+      this->residentEndFrame.store(cursor, std::memory_order_release);
+
+    } // while not stopping
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
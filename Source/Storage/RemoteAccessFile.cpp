@@ -0,0 +1,450 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "RemoteAccessFile.h"
+#include "Shared/LatencyRecorder.h"
+
+#include <algorithm> // for std::copy_n(), std::min(), std::max()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <exception> // for std::exception_ptr
+#include <stdexcept> // for std::runtime_error, std::logic_error
+#include <thread> // for std::this_thread::sleep_for()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of reads that need to be observed before hedging adapts</summary>
+  const std::uint64_t MinimumObservedReadCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Index that indicates that no attempt has succeeded yet</summary>
+  const std::size_t NoWinner = std::size_t(-1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}  // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class RemoteAccessFile::Estimates {
+
+    /// <summary>Initializes a new set of estimates with nothing observed yet</summary>
+    public: Estimates() :
+      latencies(),
+      mutex(),
+      minimumLatency(0.0),
+      bytesPerSecond(0.0) {}
+
+    /// <summary>Records a successful read from the wrapped file</summary>
+    /// <param name="byteCount">Number of bytes that have been read</param>
+    /// <param name="latency">Time it took until the read completed</param>
+    public: void Record(std::size_t byteCount, std::chrono::nanoseconds latency) {
+      this->latencies.Record(latency);
+
+      double seconds = std::chrono::duration<double>(latency).count();
+      std::lock_guard<std::mutex> estimateScope(this->mutex);
+
+      // The smallest latency seen is taken as the round trip time. It slowly drifts
+      // upwards so that a backend which became slower is eventually picked up.
+      if((this->minimumLatency == 0.0) || (seconds < this->minimumLatency)) {
+        this->minimumLatency = seconds;
+      } else {
+        this->minimumLatency += (seconds - this->minimumLatency) / 64.0;
+      }
+
+      // Whatever the read took beyond the round trip was spent transferring data. If that
+      // time is too short to measure, the bandwidth is at least high enough to hide it.
+      double transferSeconds = seconds - this->minimumLatency;
+      if(transferSeconds > this->minimumLatency / 8.0) {
+        double observed = static_cast<double>(byteCount) / transferSeconds;
+        if(this->bytesPerSecond == 0.0) {
+          this->bytesPerSecond = observed;
+        } else {
+          this->bytesPerSecond += (observed - this->bytesPerSecond) / 8.0;
+        }
+      } else if(this->minimumLatency > 0.0) {
+        this->bytesPerSecond = std::max(
+          this->bytesPerSecond, static_cast<double>(byteCount) * 8.0 / this->minimumLatency
+        );
+      }
+    }
+
+    /// <summary>Determines how long to wait before a read is issued again</summary>
+    /// <param name="policy">Policy that controls hedging</param>
+    /// <returns>The time after which a read should be hedged</returns>
+    public: std::chrono::nanoseconds GetHedgeDelay(const RemoteReadPolicy &policy) {
+      LatencyHistogram histogram = this->latencies.TakeSnapshot();
+      if(histogram.CallCount < MinimumObservedReadCount) {
+        return policy.InitialHedgeDelay;
+      }
+
+      return std::max(
+        policy.MinimumHedgeDelay, histogram.GetPercentile(policy.HedgePercentile)
+      );
+    }
+
+    /// <summary>Determines how many bytes to fetch when refilling the window</summary>
+    /// <param name="policy">Policy that controls the read-ahead</param>
+    /// <returns>The number of bytes the read-ahead window should cover</returns>
+    /// <remarks>
+    ///   To keep the backend busy, as many bytes as can be transferred during one round
+    ///   trip need to be requested at once (the bandwidth-delay product).
+    /// </remarks>
+    public: std::size_t GetReadAheadByteCount(const RemoteReadPolicy &policy) {
+      double byteCount;
+      {
+        std::lock_guard<std::mutex> estimateScope(this->mutex);
+        byteCount = this->minimumLatency * this->bytesPerSecond;
+      }
+
+      std::size_t granularity = policy.MinimumReadAheadByteCount;
+      if(byteCount >= static_cast<double>(policy.MaximumReadAheadByteCount)) {
+        return std::max(granularity, policy.MaximumReadAheadByteCount);
+      }
+
+      std::size_t blockCount = (
+        (static_cast<std::size_t>(byteCount) + granularity - 1) / granularity
+      );
+      return std::max(granularity, std::min(
+        blockCount * granularity, std::max(granularity, policy.MaximumReadAheadByteCount)
+      ));
+    }
+
+    /// <summary>Collects the latencies of all reads for the hedging percentile</summary>
+    private: Shared::LatencyRecorder latencies;
+    /// <summary>Must be held while accessing the latency and bandwidth estimates</summary>
+    private: std::mutex mutex;
+    /// <summary>Estimated round trip time of a read in seconds</summary>
+    private: double minimumLatency;
+    /// <summary>Estimated number of bytes the backend delivers per second</summary>
+    private: double bytesPerSecond;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads from a file and records how long the read took</summary>
+  /// <param name="file">File that will be read from</param>
+  /// <param name="estimates">Estimates that will be updated with the read's latency</param>
+  /// <param name="start">Offset in the file at which to begin reading</param>
+  /// <param name="byteCount">Number of bytes that will be read</param>
+  /// <parma name="buffer">Buffer into which the data will be read</param>
+  void timedRead(
+    const Nuclex::Audio::Storage::VirtualFile &file,
+    Nuclex::Audio::Storage::RemoteAccessFile::Estimates &estimates,
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    file.ReadAt(start, byteCount, buffer);
+    estimates.Record(byteCount, std::chrono::steady_clock::now() - startTime);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>State shared between the caller and the attempts of a hedged read</summary>
+  /// <remarks>
+  ///   The attempt that loses the race may still be running after the caller returned,
+  ///   which is why this is kept alive through a shared pointer and why each attempt
+  ///   reads into its own buffer.
+  /// </remarks>
+  struct HedgedRead {
+
+    /// <summary>Initializes the state for a new hedged read</summary>
+    /// <param name="file">File that will be read from</param>
+    /// <param name="estimates">Estimates that will be updated with the read's latency</param>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    public: HedgedRead(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file,
+      const std::shared_ptr<Nuclex::Audio::Storage::RemoteAccessFile::Estimates> &estimates,
+      std::uint64_t start, std::size_t byteCount
+    ) :
+      File(file),
+      Estimates(estimates),
+      Start(start),
+      ByteCount(byteCount),
+      Mutex(),
+      Finished(),
+      Buffers(),
+      Claimed { false, false },
+      Completed { false, false },
+      Errors(),
+      Winner(NoWinner) {}
+
+    /// <summary>Runs an attempt unless it has already been claimed by another thread</summary>
+    /// <param name="index">Index of the attempt that will be run</param>
+    public: void TryRun(std::size_t index) {
+      if(this->Claimed[index].exchange(true)) {
+        return;
+      }
+
+      std::exception_ptr error;
+      try {
+        timedRead(
+          *this->File, *this->Estimates, this->Start, this->ByteCount, this->Buffers[index].data()
+        );
+      }
+      catch(...) {
+        error = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> finishedScope(this->Mutex);
+        this->Completed[index] = true;
+        if(error) {
+          this->Errors[index] = error;
+        } else if(this->Winner == NoWinner) {
+          this->Winner = index;
+        }
+      }
+      this->Finished.notify_all();
+    }
+
+    /// <summary>File that is being read from</summary>
+    public: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> File;
+    /// <summary>Estimates that are updated with the latency of each attempt</summary>
+    public: std::shared_ptr<Nuclex::Audio::Storage::RemoteAccessFile::Estimates> Estimates;
+    /// <summary>Offset in the file at which the read begins</summary>
+    public: std::uint64_t Start;
+    /// <summary>Number of bytes being read</summary>
+    public: std::size_t ByteCount;
+    /// <summary>Must be held while accessing the completion state</summary>
+    public: std::mutex Mutex;
+    /// <summary>Signalled whenever one of the attempts has completed</summary>
+    public: std::condition_variable Finished;
+    /// <summary>Buffer into which each attempt reads</summary>
+    public: std::vector<std::byte> Buffers[2];
+    /// <summary>Whether a thread has begun running the attempt</summary>
+    public: std::atomic<bool> Claimed[2];
+    /// <summary>Whether the attempt has completed, successfully or not</summary>
+    public: bool Completed[2];
+    /// <summary>Error each failed attempt ended with</summary>
+    public: std::exception_ptr Errors[2];
+    /// <summary>Index of the first attempt that succeeded</summary>
+    public: std::size_t Winner;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}  // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  RemoteAccessFile::RemoteAccessFile(
+    const std::shared_ptr<const VirtualFile> &file, const RemoteReadPolicy &policy
+  ) :
+    file(file),
+    length(file->GetSize()),
+    policy(policy),
+    executor(Executor::GetInstalled()),
+    estimates(std::make_shared<Estimates>()),
+    window(),
+    windowStart(0),
+    windowLength(0),
+    windowMutex() {
+    if(policy.MinimumHedgeDelay.count() <= 0) {
+      throw std::invalid_argument(u8"Minimum hedge delay must be positive");
+    }
+    if((policy.HedgePercentile <= 0.0) || (policy.HedgePercentile > 1.0)) {
+      throw std::invalid_argument(u8"Hedge percentile must be between 0.0 and 1.0");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  RemoteAccessFile::~RemoteAccessFile() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RemoteAccessFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(this->policy.MinimumReadAheadByteCount == 0) {
+      readWithRetries(start, byteCount, buffer);
+      return;
+    }
+
+    std::lock_guard<std::mutex> windowMutexScope(this->windowMutex);
+
+    // If the requested range is completely inside the cached window, serve it from there
+    bool isInWindow = (
+      (start >= this->windowStart) &&
+      (start - this->windowStart <= this->windowLength) &&
+      (this->windowLength - (start - this->windowStart) >= byteCount)
+    );
+    if(isInWindow) {
+      std::copy_n(
+        this->window.data() + static_cast<std::size_t>(start - this->windowStart),
+        byteCount,
+        buffer
+      );
+      return;
+    }
+
+    // Otherwise fetch a window sized by the bandwidth-delay product, beginning at the
+    // granularity boundary the requested range starts in
+    std::size_t granularity = this->policy.MinimumReadAheadByteCount;
+    std::size_t windowByteCount = this->estimates->GetReadAheadByteCount(this->policy);
+    std::uint64_t alignedStart = start - (start % granularity);
+    std::size_t leadingByteCount = static_cast<std::size_t>(start - alignedStart);
+
+    // Reads that go past the end of the file or don't fit into the window are passed
+    // through directly. Out-of-range reads then fail in the wrapped file.
+    bool fitsWindow = (
+      (start < this->length) &&
+      (this->length - start >= byteCount) &&
+      (windowByteCount - leadingByteCount >= byteCount)
+    );
+    if(!fitsWindow) {
+      readWithRetries(start, byteCount, buffer);
+      return;
+    }
+
+    std::size_t fillByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(windowByteCount, this->length - alignedStart)
+    );
+    if(this->window.size() < fillByteCount) {
+      this->window.resize(fillByteCount);
+    }
+
+    this->windowLength = 0; // In case the read fails
+    readWithRetries(alignedStart, fillByteCount, this->window.data());
+    this->windowStart = alignedStart;
+    this->windowLength = fillByteCount;
+
+    std::copy_n(this->window.data() + leadingByteCount, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RemoteAccessFile::WriteAt(std::uint64_t, std::size_t, const std::byte *) {
+    throw std::runtime_error(u8"Files wrapped for remote access are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RemoteAccessFile::readWithRetries(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    std::chrono::nanoseconds retryDelay = this->policy.InitialRetryDelay;
+    for(std::size_t retryIndex = 0;; ++retryIndex) {
+      try {
+        readHedged(start, byteCount, buffer);
+        return;
+      }
+      catch(const std::logic_error &) {
+        throw; // Reading out of bounds or similar, trying again won't help
+      }
+      catch(const std::exception &) {
+        if(retryIndex >= this->policy.MaximumRetryCount) {
+          throw;
+        }
+      }
+
+      std::this_thread::sleep_for(retryDelay);
+      retryDelay *= 2;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RemoteAccessFile::readHedged(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(this->policy.InitialHedgeDelay.count() <= 0) {
+      timedRead(*this->file, *this->estimates, start, byteCount, buffer);
+      return;
+    }
+
+    std::chrono::nanoseconds hedgeDelay = this->estimates->GetHedgeDelay(this->policy);
+
+    std::shared_ptr<HedgedRead> read = std::make_shared<HedgedRead>(
+      this->file, this->estimates, start, byteCount
+    );
+    read->Buffers[0].resize(byteCount);
+    this->executor->Submit([read]() { read->TryRun(0); }, TaskPriority::High);
+
+    std::size_t attemptCount = 1;
+    bool hasDeadline = true;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + hedgeDelay;
+    {
+      std::unique_lock<std::mutex> finishedScope(read->Mutex);
+      auto isFinished = [&read, &attemptCount]() {
+        return (
+          (read->Winner != NoWinner) ||
+          (read->Completed[0] && ((attemptCount == 1) || read->Completed[1]))
+        );
+      };
+      for(;;) {
+        if(!hasDeadline) {
+          read->Finished.wait(finishedScope, isFinished);
+          break;
+        }
+        if(read->Finished.wait_until(finishedScope, deadline, isFinished)) {
+          break;
+        }
+
+        // The deadline passed. If no worker has picked up an attempt yet, the executor
+        // is saturated and the calling thread runs the attempt by itself.
+        std::size_t lastIndex = attemptCount - 1;
+        if(!read->Claimed[lastIndex].load()) {
+          finishedScope.unlock();
+          read->TryRun(lastIndex);
+          finishedScope.lock();
+          hasDeadline = false;
+        } else if(attemptCount == 1) {
+          read->Buffers[1].resize(byteCount);
+          ++attemptCount;
+          finishedScope.unlock();
+          this->executor->Submit([read]() { read->TryRun(1); }, TaskPriority::High);
+          finishedScope.lock();
+          deadline = std::chrono::steady_clock::now() + hedgeDelay;
+        } else {
+          hasDeadline = false;
+        }
+      }
+
+      if(unlikely(read->Winner == NoWinner)) {
+        std::rethrow_exception(read->Errors[0]);
+      }
+    }
+
+    std::copy_n(read->Buffers[read->Winner].data(), byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
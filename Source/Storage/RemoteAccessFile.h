@@ -0,0 +1,136 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_REMOTEACCESSFILE_H
+#define NUCLEX_AUDIO_STORAGE_REMOTEACCESSFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/RemoteReadPolicy.h"
+#include "Nuclex/Audio/Executor.h"
+
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hedges, retries and reads ahead on files behind high-latency backends</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Reads are layered: a read that misses the read-ahead window refills it, each
+  ///     refill is retried if it fails and each attempt is hedged if it is slow. Hedged
+  ///     requests run on the executor into buffers of their own, so a request that loses
+  ///     the race can finish in the background without touching the caller's buffer.
+  ///   </para>
+  ///   <para>
+  ///     If all of the executor's workers are busy, the calling thread runs requests
+  ///     that haven't been picked up yet by itself, so reads never wait for the executor.
+  ///   </para>
+  /// </remarks>
+  class RemoteAccessFile : public VirtualFile {
+
+    /// <summary>Latency and bandwidth observed on the wrapped file</summary>
+    /// <remarks>
+    ///   Shared with hedged requests that may still be running after the file is gone.
+    /// </remarks>
+    public: class Estimates;
+
+    /// <summary>Initializes a new resilient reader around the specified file</summary>
+    /// <param name="file">File whose reads will be hedged, retried and read ahead</param>
+    /// <param name="policy">When to hedge and retry reads and how far to read ahead</param>
+    public: RemoteAccessFile(
+      const std::shared_ptr<const VirtualFile> &file, const RemoteReadPolicy &policy
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~RemoteAccessFile() override;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Only read-only files are wrapped, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Reads from the wrapped file, retrying failed reads</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    private: void readWithRetries(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const;
+
+    /// <summary>Reads from the wrapped file, issuing the read again if it is slow</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    private: void readHedged(std::uint64_t start, std::size_t byteCount, std::byte *buffer) const;
+
+    /// <summary>File whose reads are being made resilient</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Length of the wrapped file in bytes</summary>
+    private: std::uint64_t length;
+    /// <summary>When to hedge and retry and how far to read ahead</summary>
+    private: RemoteReadPolicy policy;
+    /// <summary>Executor on which hedged requests are run</summary>
+    private: std::shared_ptr<Executor> executor;
+    /// <summary>Latency and bandwidth observed so far</summary>
+    private: std::shared_ptr<Estimates> estimates;
+    /// <summary>Memory holding the currently cached window of the file</summary>
+    private: mutable std::vector<std::byte> window;
+    /// <summary>Absolute file offset at which the cached window begins</summary>
+    private: mutable std::uint64_t windowStart;
+    /// <summary>Number of valid bytes in the cached window</summary>
+    private: mutable std::size_t windowLength;
+    /// <summary>Mutex that must be held while accessing the window</summary>
+    private: mutable std::mutex windowMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_REMOTEACCESSFILE_H
@@ -0,0 +1,498 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "ResamplingTrackDecoder.h"
+
+#include "Shared/ClampingSampleConverter.h"
+#include "Shared/DecodePathBuilder.h"
+#include "Shared/PolyphaseFilter.h"
+
+#include <algorithm> // for std::min(), std::max(), std::copy(), std::fill_n()
+#include <cassert> // for assert()
+#include <numeric> // for std::gcd()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <type_traits> // for std::is_same<>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of output frames resampled in one go</summary>
+  /// <remarks>
+  ///   Small enough that the input window and scratch buffer for 8 channels stay in
+  ///   a 256 KiB cache, large enough that the per-call overhead of the wrapped decoder
+  ///   doesn't matter.
+  /// </remarks>
+  const std::size_t ResampleChunkFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a range of frames lies within the track</summary>
+  /// <param name="totalFrameCount">Number of frames in the track</param>
+  /// <param name="startFrame">Index of the first frame in the range</param>
+  /// <param name="frameCount">Number of frames in the range</param>
+  void verifyDecodeRange(
+    std::uint64_t totalFrameCount, std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    if(unlikely(startFrame > totalFrameCount)) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(unlikely(totalFrameCount - startFrame < frameCount)) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ResamplingTrackDecoder::ResamplingTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t inputSampleRate,
+    std::size_t outputSampleRate
+  ) :
+    decoder(decoder),
+    inputSampleRate(inputSampleRate),
+    outputSampleRate(outputSampleRate),
+    upFactor(0),
+    downFactor(0),
+    channelCount(0),
+    inputFrameCount(0),
+    outputFrameCount(0),
+    filter(),
+    scratchMutex(),
+    windowCapacity(0),
+    windowStart(0),
+    windowLength(0),
+    window(),
+    outputScratch() {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Resampling decoder requires a decoder to resample");
+    }
+    if(unlikely((inputSampleRate == 0) || (outputSampleRate == 0))) {
+      throw std::invalid_argument(u8"Sample rates must not be zero");
+    }
+
+    // Resampling from 44100 to 48000 Hz, for example, means upsampling by 160
+    // and decimating by 147, which the filter does in a single step
+    std::size_t divisor = std::gcd(inputSampleRate, outputSampleRate);
+    this->upFactor = outputSampleRate / divisor;
+    this->downFactor = inputSampleRate / divisor;
+    this->filter = Shared::PolyphaseFilter::GetShared(this->upFactor, this->downFactor);
+
+    this->channelCount = decoder->CountChannels();
+    this->inputFrameCount = decoder->CountFrames();
+    this->outputFrameCount = (
+      (this->inputFrameCount * this->upFactor + this->downFactor - 1) / this->downFactor
+    );
+
+    // One chunk of output frames spans this many input frames, plus the taps
+    // extending to either side of the first and last output frame
+    this->windowCapacity = (
+      (ResampleChunkFrameCount * this->downFactor + this->upFactor - 1) / this->upFactor +
+      this->filter->CountTaps() + 1
+    );
+    this->window.resize(this->channelCount * this->windowCapacity);
+    this->outputScratch.resize(this->channelCount * ResampleChunkFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ResamplingTrackDecoder::~ResamplingTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> ResamplingTrackDecoder::Clone() const {
+    return std::make_shared<ResamplingTrackDecoder>(
+      this->decoder->Clone(), this->inputSampleRate, this->outputSampleRate
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath ResamplingTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    sampleFormat = Shared::DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+
+    // The wrapped decoder always delivers separated floats into the filter window
+    Shared::DecodePathBuilder builder(
+      this->decoder->ExplainDecodePath(AudioSampleFormat::Float_32, false)
+    );
+    builder.AddScratchBuffer();
+
+    // Separated floats are filtered straight into the caller's buffers
+    if(!interleaved && (sampleFormat == AudioSampleFormat::Float_32)) {
+      builder.AddPass(u8"resample");
+    } else {
+      builder.AddScratchBuffer().AddPass(u8"resample").AddPass(u8"convert");
+      if(interleaved) {
+        builder.AddFusedStep(u8"interleave");
+      }
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost ResamplingTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+
+    // Mirror resampleChunk(), the filter window begins a few input frames before
+    // the input position of the target frame
+    std::uint64_t firstInputFrame = targetFrame * this->downFactor / this->upFactor;
+    std::int64_t windowFrame = (
+      static_cast<std::int64_t>(firstInputFrame) + 1 -
+      static_cast<std::int64_t>(this->filter->GetLeadingTapCount())
+    );
+
+    // If the window already holds that frame, decoding picks up at the window's end
+    {
+      std::lock_guard<std::mutex> scratchMutexScope(this->scratchMutex);
+
+      std::int64_t windowEnd = (
+        this->windowStart + static_cast<std::int64_t>(this->windowLength)
+      );
+      bool isStartInWindow = (
+        (0 < this->windowLength) &&
+        (this->windowStart <= windowFrame) && (windowFrame < windowEnd)
+      );
+      if(isStartInWindow) {
+        windowFrame = windowEnd;
+      }
+    }
+
+    std::uint64_t inputFrame = static_cast<std::uint64_t>(std::max<std::int64_t>(windowFrame, 0));
+    if(inputFrame >= this->inputFrameCount) {
+      return SeekCost { 0, 0, 0, true }; // Everything that is needed is in the window
+    }
+
+    return this->decoder->EstimateSeekCost(inputFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int16_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int32_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<float>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<double>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::uint8_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int16_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int32_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<float>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<double>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void ResamplingTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    verifyDecodeRange(this->outputFrameCount, startFrame, frameCount);
+
+    std::vector<float *> outputs(this->channelCount);
+
+    std::lock_guard<std::mutex> scratchMutexScope(this->scratchMutex);
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      outputs[index] = this->outputScratch.data() + (index * ResampleChunkFrameCount);
+    }
+
+    while(0 < frameCount) {
+      std::size_t chunkFrameCount = std::min(frameCount, ResampleChunkFrameCount);
+      resampleChunk(outputs.data(), startFrame, chunkFrameCount);
+
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        Shared::ClampingSampleConverter::Convert(
+          outputs[index], buffer + index, this->channelCount, chunkFrameCount
+        );
+      }
+
+      buffer += chunkFrameCount * this->channelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void ResamplingTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    verifyDecodeRange(this->outputFrameCount, startFrame, frameCount);
+
+    std::vector<float *> outputs(this->channelCount);
+
+    std::lock_guard<std::mutex> scratchMutexScope(this->scratchMutex);
+
+    std::size_t offset = 0;
+    while(offset < frameCount) {
+      std::size_t chunkFrameCount = std::min(frameCount - offset, ResampleChunkFrameCount);
+
+      // Float samples can be filtered straight into the caller's buffers,
+      // other sample types need to go through the output scratch buffer
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        if(buffers[index] == nullptr) {
+          outputs[index] = nullptr;
+        } else if constexpr(std::is_same<TSample, float>::value) {
+          outputs[index] = buffers[index] + offset;
+        } else {
+          outputs[index] = this->outputScratch.data() + (index * ResampleChunkFrameCount);
+        }
+      }
+
+      resampleChunk(outputs.data(), startFrame + offset, chunkFrameCount);
+
+      if constexpr(!std::is_same<TSample, float>::value) {
+        for(std::size_t index = 0; index < this->channelCount; ++index) {
+          if(outputs[index] != nullptr) {
+            Shared::ClampingSampleConverter::Convert(
+              outputs[index], buffers[index] + offset, 1, chunkFrameCount
+            );
+          }
+        }
+      }
+
+      offset += chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::resampleChunk(
+    float *const outputs[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    if(frameCount == 0) {
+      return;
+    }
+
+    // Output frame n lies at input position n * M / L, its integer part selects
+    // the input frames and its fractional part (in 1/L units) the filter phase
+    std::uint64_t position = startFrame * this->downFactor;
+    std::uint64_t firstInputFrame = position / this->upFactor;
+    std::size_t firstPhase = static_cast<std::size_t>(position % this->upFactor);
+    std::uint64_t lastInputFrame = (
+      (startFrame + frameCount - 1) * this->downFactor / this->upFactor
+    );
+
+    std::int64_t windowFrame = (
+      static_cast<std::int64_t>(firstInputFrame) + 1 -
+      static_cast<std::int64_t>(this->filter->GetLeadingTapCount())
+    );
+    fillWindow(
+      windowFrame,
+      static_cast<std::size_t>(lastInputFrame - firstInputFrame) + this->filter->CountTaps()
+    );
+
+    std::size_t inputStep = this->downFactor / this->upFactor;
+    std::size_t phaseStep = this->downFactor % this->upFactor;
+
+    for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+      float *output = outputs[channelIndex];
+      if(output == nullptr) {
+        continue;
+      }
+
+      const float *input = (
+        this->window.data() +
+        (channelIndex * this->windowCapacity) +
+        static_cast<std::size_t>(windowFrame - this->windowStart)
+      );
+      std::size_t phase = firstPhase;
+      for(std::size_t index = 0; index < frameCount; ++index) {
+        output[index] = this->filter->Apply(input, phase);
+
+        input += inputStep;
+        phase += phaseStep;
+        if(phase >= this->upFactor) {
+          phase -= this->upFactor;
+          ++input;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::fillWindow(std::int64_t startFrame, std::size_t frameCount) const {
+    assert((frameCount <= this->windowCapacity) && u8"Input range fits into the window");
+
+    std::int64_t windowEnd = this->windowStart + static_cast<std::int64_t>(this->windowLength);
+    std::int64_t endFrame = startFrame + static_cast<std::int64_t>(frameCount);
+
+    // If the window already holds the whole range, there's nothing to do
+    bool isStartInWindow = (
+      (0 < this->windowLength) && (this->windowStart <= startFrame) && (startFrame < windowEnd)
+    );
+    if(isStartInWindow && (endFrame <= windowEnd)) {
+      return;
+    }
+
+    // Any part of the window that overlaps the range is moved to the window's beginning,
+    // this is the normal case for sequential reads and avoids decoding frames twice
+    std::size_t retainedFrameCount = 0;
+    if(isStartInWindow) {
+      retainedFrameCount = static_cast<std::size_t>(windowEnd - startFrame);
+      std::size_t shift = static_cast<std::size_t>(startFrame - this->windowStart);
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        float *channel = this->window.data() + (index * this->windowCapacity);
+        std::copy(channel + shift, channel + shift + retainedFrameCount, channel);
+      }
+    }
+
+    // If decoding fails, the window's contents are undefined
+    this->windowStart = startFrame;
+    this->windowLength = 0;
+
+    decodeIntoWindow(
+      retainedFrameCount,
+      startFrame + static_cast<std::int64_t>(retainedFrameCount),
+      frameCount - retainedFrameCount
+    );
+
+    this->windowLength = frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResamplingTrackDecoder::decodeIntoWindow(
+    std::size_t windowIndex, std::int64_t startFrame, std::size_t frameCount
+  ) const {
+
+    // The filter reaches before the first frame at the beginning of the track
+    if(startFrame < 0) {
+      std::size_t silentFrameCount = std::min(
+        frameCount, static_cast<std::size_t>(-startFrame)
+      );
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        std::fill_n(
+          this->window.data() + (index * this->windowCapacity) + windowIndex,
+          silentFrameCount,
+          0.0f
+        );
+      }
+
+      windowIndex += silentFrameCount;
+      startFrame += static_cast<std::int64_t>(silentFrameCount);
+      frameCount -= silentFrameCount;
+    }
+
+    std::uint64_t inputFrame = static_cast<std::uint64_t>(startFrame);
+    if((0 < frameCount) && (inputFrame < this->inputFrameCount)) {
+      std::size_t decodedFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount, this->inputFrameCount - inputFrame)
+      );
+
+      std::vector<float *> inputs(this->channelCount);
+      for(std::size_t index = 0; index < this->channelCount; ++index) {
+        inputs[index] = this->window.data() + (index * this->windowCapacity) + windowIndex;
+      }
+      this->decoder->DecodeSeparated<float>(inputs.data(), inputFrame, decodedFrameCount);
+
+      windowIndex += decodedFrameCount;
+      frameCount -= decodedFrameCount;
+    }
+
+    // ...and past the last frame at the end of the track
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      std::fill_n(
+        this->window.data() + (index * this->windowCapacity) + windowIndex, frameCount, 0.0f
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,330 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_RESAMPLINGTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_RESAMPLINGTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <cstdint> // for std::int64_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class PolyphaseFilter;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the sample rate of another decoder while it is being decoded</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The wrapped decoder's channels are decoded into a window of input frames that
+  ///     slides along as output frames are requested. Each output frame is computed from
+  ///     the input frames around its position via a <see cref="Shared::PolyphaseFilter" />
+  ///     and converted straight into the caller's buffer.
+  ///   </para>
+  ///   <para>
+  ///     Frame indices are in the output sample rate. When consecutive ranges are read,
+  ///     the part of the window still needed is kept and only the new input frames are
+  ///     decoded, so the wrapped decoder reads sequentially and never has to seek.
+  ///   </para>
+  /// </remarks>
+  class ResamplingTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new resampling decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder whose audio will be resampled</param>
+    /// <param name="inputSampleRate">Sample rate of the wrapped decoder's audio</param>
+    /// <param name="outputSampleRate">Sample rate at which audio will be delivered</param>
+    public: ResamplingTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t inputSampleRate,
+      std::size_t outputSampleRate
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~ResamplingTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override {
+      return this->channelCount;
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->decoder->GetChannelOrder();
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long at the output sample rate</returns>
+    public: std::uint64_t CountFrames() const override {
+      return this->outputFrameCount;
+    }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>Always 32-bit floats, which is what the filter produces</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return AudioSampleFormat::Float_32;
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>Always false, resampling works on separated channels</returns>
+    public: bool IsNativelyInterleaved() const override { return false; }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    public: void BuildSeekIndex() const override {
+      this->decoder->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->decoder->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->decoder->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->decoder->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override {
+      this->decoder->EnableStatistics(enable);
+    }
+
+    /// <summary>Retrieves the statistics the wrapped decoder has collected so far</summary>
+    /// <returns>The current values of the wrapped decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override {
+      return this->decoder->GetStatistics();
+    }
+
+    /// <summary>Retrieves the wrapped decoder's distribution of decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each of the wrapped decoder's calls took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override {
+      return this->decoder->GetDecodeLatencies(reset);
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Resamples and interleaves audio frames into the target buffer</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first output frame to deliver</param>
+    /// <param name="frameCount">Number of output frames that will be delivered</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Resamples audio channels into the target buffers</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first output frame to deliver</param>
+    /// <param name="frameCount">Number of output frames that will be delivered</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Computes one chunk of output frames into the specified buffers</summary>
+    /// <param name="outputs">Buffers receiving the channels, null to skip a channel</param>
+    /// <param name="startFrame">Index of the first output frame to compute</param>
+    /// <param name="frameCount">Number of output frames to compute, at most one chunk</param>
+    /// <remarks>
+    ///   The scratch mutex must be held by the caller.
+    /// </remarks>
+    private: void resampleChunk(
+      float *const outputs[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Makes the input window cover the specified range of input frames</summary>
+    /// <param name="startFrame">First input frame the window needs to hold</param>
+    /// <param name="frameCount">Number of input frames the window needs to hold</param>
+    /// <remarks>
+    ///   Input frames outside of the track are filled with silence. The scratch mutex
+    ///   must be held by the caller.
+    /// </remarks>
+    private: void fillWindow(std::int64_t startFrame, std::size_t frameCount) const;
+
+    /// <summary>Decodes input frames into the window or fills them with silence</summary>
+    /// <param name="windowIndex">Index within the window at which to store the frames</param>
+    /// <param name="startFrame">Index of the first input frame, may be negative</param>
+    /// <param name="frameCount">Number of input frames to store</param>
+    private: void decodeIntoWindow(
+      std::size_t windowIndex, std::int64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Decoder whose audio is resampled</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Sample rate of the wrapped decoder's audio</summary>
+    private: std::size_t inputSampleRate;
+    /// <summary>Sample rate at which audio is delivered</summary>
+    private: std::size_t outputSampleRate;
+    /// <summary>Factor by which the input is upsampled (L)</summary>
+    private: std::size_t upFactor;
+    /// <summary>Factor by which the upsampled input is decimated (M)</summary>
+    private: std::size_t downFactor;
+    /// <summary>Number of channels in the wrapped decoder's audio</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of frames in the wrapped decoder's audio</summary>
+    private: std::uint64_t inputFrameCount;
+    /// <summary>Number of frames delivered to the caller</summary>
+    private: std::uint64_t outputFrameCount;
+    /// <summary>Filter bank that computes output frames from input frames</summary>
+    private: std::shared_ptr<const Shared::PolyphaseFilter> filter;
+
+    /// <summary>Must be held while the input window and scratch buffer are in use</summary>
+    private: mutable std::mutex scratchMutex;
+    /// <summary>Number of input frames the window can hold per channel</summary>
+    private: std::size_t windowCapacity;
+    /// <summary>Input frame at which the window begins</summary>
+    private: mutable std::int64_t windowStart;
+    /// <summary>Number of input frames currently held in the window</summary>
+    private: mutable std::size_t windowLength;
+    /// <summary>Input frames around the current position, one channel after another</summary>
+    private: mutable SampleVector<float> window;
+    /// <summary>Holds one chunk of each resampled channel</summary>
+    private: mutable SampleVector<float> outputScratch;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_RESAMPLINGTRACKDECODER_H
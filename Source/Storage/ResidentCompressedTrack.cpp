@@ -0,0 +1,185 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ResidentCompressedTrack.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <stdexcept> // for std::out_of_range
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ResidentCompressedTrack::ResidentCompressedTrack(
+    const AudioLoader &loader,
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &extensionHint /* = std::string() */,
+    std::size_t cacheMemoryLimit /* = 1048576 */
+  ) :
+    file(),
+    decoder(),
+    cacheMemoryLimit(cacheMemoryLimit),
+    cacheMutex(),
+    cacheMemoryUsage(0),
+    blocks(),
+    blocksByStart(),
+    hitCount(0),
+    missCount(0) {
+
+    // Files that already live in memory can be used as they are, all others
+    // are copied into memory once so decoding never touches the disk again
+    std::size_t byteCount = static_cast<std::size_t>(file->GetSize());
+    if(file->TryBorrowAt(0, byteCount) != nullptr) {
+      this->file = file;
+    } else {
+      std::shared_ptr<std::byte[]> memory(new std::byte[byteCount]);
+      file->ReadAt(0, byteCount, memory.get());
+      this->file = VirtualFile::FromMemory(memory, byteCount);
+    }
+
+    // Build the seek index now, so that clones can jump straight to any block
+    // instead of each one having to find its way through the file
+    std::shared_ptr<AudioTrackDecoder> fileDecoder = loader.OpenDecoder(
+      this->file, extensionHint
+    );
+    fileDecoder->BuildSeekIndex();
+    this->decoder = AudioTrackDecoder::CreatePool(fileDecoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ResidentCompressedTrack::~ResidentCompressedTrack() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ResidentCompressedTrack::CountChannels() const {
+    return this->decoder->CountChannels();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t ResidentCompressedTrack::CountFrames() const {
+    return this->decoder->CountFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &ResidentCompressedTrack::GetChannelOrder() const {
+    return this->decoder->GetChannelOrder();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t ResidentCompressedTrack::GetCompressedByteCount() const {
+    return this->file->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ResidentCompressedTrack::GetCacheMemoryUsage() const {
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    return this->cacheMemoryUsage;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ResidentCompressedTrack::DecodeInterleaved(
+    float *target, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t totalFrameCount = this->decoder->CountFrames();
+    if((startFrame > totalFrameCount) || (frameCount > totalFrameCount - startFrame)) {
+      throw std::out_of_range(u8"Decoding range lies outside of the audio track");
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+    while(frameCount > 0) {
+      std::uint64_t blockStart = this->decoder->GetBlockStart(startFrame);
+      std::size_t blockSize = this->decoder->GetBlockSize(startFrame);
+      std::shared_ptr<const SampleVector<float>> block = getBlock(blockStart, blockSize);
+
+      std::size_t offset = static_cast<std::size_t>(startFrame - blockStart);
+      std::size_t copiedFrameCount = std::min(blockSize - offset, frameCount);
+      std::copy_n(
+        block->data() + (offset * channelCount), copiedFrameCount * channelCount, target
+      );
+
+      target += copiedFrameCount * channelCount;
+      startFrame += copiedFrameCount;
+      frameCount -= copiedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const SampleVector<float>> ResidentCompressedTrack::getBlock(
+    std::uint64_t blockStart, std::size_t frameCount
+  ) const {
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+      std::unordered_map<std::uint64_t, BlockList::iterator>::iterator iterator = (
+        this->blocksByStart.find(blockStart)
+      );
+      if(iterator != this->blocksByStart.end()) {
+        this->blocks.splice(this->blocks.begin(), this->blocks, iterator->second);
+        this->hitCount.fetch_add(1, std::memory_order_relaxed);
+        return iterator->second->Samples;
+      }
+    }
+
+    // Decode without holding the lock so other threads can keep using the cache.
+    // If two threads miss the same block, both decode it and the first one wins.
+    this->missCount.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<SampleVector<float>> samples = std::make_shared<SampleVector<float>>(
+      frameCount * this->decoder->CountChannels()
+    );
+    this->decoder->DecodeInterleaved(samples->data(), blockStart, frameCount);
+
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    std::unordered_map<std::uint64_t, BlockList::iterator>::iterator iterator = (
+      this->blocksByStart.find(blockStart)
+    );
+    if(iterator != this->blocksByStart.end()) {
+      return iterator->second->Samples;
+    }
+
+    this->blocks.push_front(CachedBlock { blockStart, samples });
+    this->blocksByStart.emplace(blockStart, this->blocks.begin());
+    this->cacheMemoryUsage += samples->size() * sizeof(float);
+
+    // Evict the least recently used blocks, but never the block just decoded.
+    // Blocks handed out earlier stay alive for as long as their readers need them.
+    while((this->cacheMemoryUsage > this->cacheMemoryLimit) && (this->blocks.size() > 1)) {
+      const CachedBlock &leastRecentlyUsed = this->blocks.back();
+      this->cacheMemoryUsage -= leastRecentlyUsed.Samples->size() * sizeof(float);
+      this->blocksByStart.erase(leastRecentlyUsed.StartFrame);
+      this->blocks.pop_back();
+    }
+
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,165 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SequentialDecodeSession.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SequentialDecodeSession::SequentialDecodeSession(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::uint64_t startFrame /* = 0 */,
+    std::size_t chunkFrameCount /* = 4096 */
+  ) :
+    decoder(decoder),
+    channelCount(0),
+    totalFrameCount(0),
+    chunkFrameCount(chunkFrameCount),
+    chunk(),
+    chunkPosition(0),
+    chunkLength(0),
+    cursor(startFrame) {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Sequential decode session requires a decoder to run");
+    }
+    if(unlikely(chunkFrameCount == 0)) {
+      throw std::invalid_argument(u8"Sequential decode session needs chunks of at least 1 frame");
+    }
+
+    this->channelCount = decoder->CountChannels();
+    this->totalFrameCount = decoder->CountFrames();
+    if(unlikely(startFrame > this->totalFrameCount)) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+
+    this->chunk.reset(new float[chunkFrameCount * this->channelCount]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SequentialDecodeSession::~SequentialDecodeSession() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SequentialDecodeSession::DecodeInterleaved(float *buffer, std::size_t frameCount) {
+    std::size_t deliveredFrameCount = 0;
+
+    while(deliveredFrameCount < frameCount) {
+      std::size_t bufferedFrameCount = this->chunkLength - this->chunkPosition;
+
+      // If the chunk is used up and the caller wants at least a chunk's worth of frames,
+      // there's no point in going through our buffer. Decode directly into the caller's.
+      if(bufferedFrameCount == 0) {
+        std::uint64_t remainingFrameCount = this->totalFrameCount - this->cursor;
+        if(remainingFrameCount == 0) {
+          break;
+        }
+
+        std::size_t missingFrameCount = frameCount - deliveredFrameCount;
+        if(missingFrameCount >= this->chunkFrameCount) {
+          std::size_t directFrameCount = static_cast<std::size_t>(
+            std::min<std::uint64_t>(missingFrameCount, remainingFrameCount)
+          );
+          this->decoder->DecodeInterleaved<float>(
+            buffer + (deliveredFrameCount * this->channelCount), this->cursor, directFrameCount
+          );
+          this->cursor += directFrameCount;
+          deliveredFrameCount += directFrameCount;
+          continue;
+        }
+
+        refill();
+        bufferedFrameCount = this->chunkLength;
+      }
+
+      std::size_t copiedFrameCount = std::min(bufferedFrameCount, frameCount - deliveredFrameCount);
+      std::copy_n(
+        this->chunk.get() + (this->chunkPosition * this->channelCount),
+        copiedFrameCount * this->channelCount,
+        buffer + (deliveredFrameCount * this->channelCount)
+      );
+      this->chunkPosition += copiedFrameCount;
+      this->cursor += copiedFrameCount;
+      deliveredFrameCount += copiedFrameCount;
+    }
+
+    return deliveredFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SequentialDecodeSession::DecodeSeparated(float *buffers[], std::size_t frameCount) {
+    std::size_t deliveredFrameCount = 0;
+
+    while(deliveredFrameCount < frameCount) {
+      std::size_t bufferedFrameCount = this->chunkLength - this->chunkPosition;
+      if(bufferedFrameCount == 0) {
+        if(this->cursor >= this->totalFrameCount) {
+          break;
+        }
+
+        refill();
+        bufferedFrameCount = this->chunkLength;
+      }
+
+      // The chunk buffer is interleaved, so this is a de-interleaving copy
+      std::size_t copiedFrameCount = std::min(bufferedFrameCount, frameCount - deliveredFrameCount);
+      const float *source = this->chunk.get() + (this->chunkPosition * this->channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        float *target = buffers[channelIndex] + deliveredFrameCount;
+        for(std::size_t frameIndex = 0; frameIndex < copiedFrameCount; ++frameIndex) {
+          target[frameIndex] = source[frameIndex * this->channelCount + channelIndex];
+        }
+      }
+
+      this->chunkPosition += copiedFrameCount;
+      this->cursor += copiedFrameCount;
+      deliveredFrameCount += copiedFrameCount;
+    }
+
+    return deliveredFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SequentialDecodeSession::refill() {
+    std::size_t frameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(this->chunkFrameCount, this->totalFrameCount - this->cursor)
+    );
+
+    // Reset first so that a failed decode leaves the session with an empty chunk
+    // rather than the previous chunk's frames labeled with the wrong positions.
+    this->chunkPosition = 0;
+    this->chunkLength = 0;
+    this->decoder->DecodeInterleaved<float>(this->chunk.get(), this->cursor, frameCount);
+    this->chunkLength = frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
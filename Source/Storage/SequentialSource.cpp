@@ -0,0 +1,180 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SequentialSource.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h" // for VirtualFile
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsFileApi.h" // for ThrowExceptionForFileAccessError()
+#else
+#include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError()
+#include <unistd.h> // for ::read(), STDIN_FILENO
+#include <cerrno> // for errno, EINTR
+#endif
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sequential source that reads from the standard input of the process</summary>
+  class StandardInputSource : public Nuclex::Audio::Storage::SequentialSource {
+
+    /// <summary>Frees all resources owned by the source</summary>
+    public: ~StandardInputSource() override = default;
+
+    /// <summary>Reads the next bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Maximum number of bytes that will be read</param>
+    /// <returns>The number of bytes that were read, zero at the end of the data</returns>
+    public: std::size_t ReadSome(std::byte *buffer, std::size_t byteCount) override;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StandardInputSource::ReadSome(std::byte *buffer, std::size_t byteCount) {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    using Nuclex::Audio::Platform::WindowsFileApi;
+
+    DWORD desiredCount = static_cast<DWORD>(std::min<std::size_t>(byteCount, 0x40000000));
+    DWORD actualCount = 0;
+
+    BOOL result = ::ReadFile(
+      ::GetStdHandle(STD_INPUT_HANDLE), buffer, desiredCount, &actualCount, nullptr
+    );
+    if(unlikely(result == FALSE)) {
+      DWORD errorCode = ::GetLastError();
+      if(errorCode == ERROR_BROKEN_PIPE) {
+        return 0; // Writing end of the pipe was closed, this is how pipes signal the end
+      }
+      WindowsFileApi::ThrowExceptionForFileAccessError(
+        u8"Could not read data from standard input", errorCode
+      );
+    }
+
+    return static_cast<std::size_t>(actualCount);
+#else
+    using Nuclex::Audio::Platform::PosixFileApi;
+
+    for(;;) {
+      ::ssize_t result = ::read(STDIN_FILENO, buffer, byteCount);
+      if(likely(result != static_cast<::ssize_t>(-1))) {
+        return static_cast<std::size_t>(result);
+      }
+
+      int errorNumber = errno;
+      if(errorNumber != EINTR) {
+        PosixFileApi::ThrowExceptionForFileAccessError(
+          u8"Could not read data from standard input", errorNumber
+        );
+      }
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sequential source that delivers the contents of a virtual file in order</summary>
+  class VirtualFileSource : public Nuclex::Audio::Storage::SequentialSource {
+
+    /// <summary>Initializes a new sequential source reading the specified file</summary>
+    /// <param name="file">File whose contents the source will deliver</param>
+    public: VirtualFileSource(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file
+    ) :
+      file(file),
+      length(file->GetSize()),
+      position(0) {}
+
+    /// <summary>Frees all resources owned by the source</summary>
+    public: ~VirtualFileSource() override = default;
+
+    /// <summary>Reads the next bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Maximum number of bytes that will be read</param>
+    /// <returns>The number of bytes that were read, zero at the end of the data</returns>
+    public: std::size_t ReadSome(std::byte *buffer, std::size_t byteCount) override {
+      std::size_t readByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(byteCount, this->length - this->position)
+      );
+      if(readByteCount > 0) {
+        this->file->ReadAt(this->position, readByteCount, buffer);
+        this->position += readByteCount;
+      }
+
+      return readByteCount;
+    }
+
+    /// <summary>File whose contents are being delivered</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+    /// <summary>Length of the file in bytes</summary>
+    private: std::uint64_t length;
+    /// <summary>Offset of the next byte that will be delivered</summary>
+    private: std::uint64_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<SequentialSource> SequentialSource::OpenStandardInput() {
+    return std::make_shared<StandardInputSource>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<SequentialSource> SequentialSource::FromVirtualFile(
+    const std::shared_ptr<const VirtualFile> &file
+  ) {
+    if(unlikely(!static_cast<bool>(file))) {
+      throw std::invalid_argument(u8"Sequential source needs a virtual file to read from");
+    }
+
+    return std::make_shared<VirtualFileSource>(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SequentialSource::ReadFully(std::byte *buffer, std::size_t byteCount) {
+    std::size_t totalByteCount = 0;
+    while(totalByteCount < byteCount) {
+      std::size_t readByteCount = ReadSome(buffer + totalByteCount, byteCount - totalByteCount);
+      if(readByteCount == 0) {
+        break;
+      }
+      totalByteCount += readByteCount;
+    }
+
+    return totalByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
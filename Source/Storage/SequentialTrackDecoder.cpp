@@ -0,0 +1,196 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "Nuclex/Audio/Storage/SequentialSource.h" // for SequentialSource
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./Waveform/WaveformDetection.h"
+#include "./Waveform/WaveformSequentialDecoder.h"
+#include "./Flac/FlacDetection.h"
+#include "./Flac/FlacSequentialDecoder.h"
+#include "./Vorbis/VorbisDetection.h"
+#include "./Vorbis/VorbisSequentialDecoder.h"
+#include "./Opus/OpusDetection.h"
+#include "./Opus/OpusSequentialDecoder.h"
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes read from the stream to identify its codec</summary>
+  /// <remarks>
+  ///   The Ogg checks need the first page header and the beginning of the first packet,
+  ///   which is the most any of the header checks looks at.
+  /// </remarks>
+  constexpr std::size_t SignatureByteCount = 48;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the header of a Waveform file being streamed is present</summary>
+  /// <param name="header">First bytes of the stream that will be checked</param>
+  /// <param name="byteCount">Number of bytes available in the header</param>
+  /// <returns>True if the header looks like a Waveform file of unknown length</returns>
+  /// <remarks>
+  ///   Recorders writing into a pipe can't go back to fill in the RIFF size, so they leave it
+  ///   at zero or 0xFFFFFFFF. The regular header check rejects these as implausible.
+  /// </remarks>
+  bool checkIfStreamedWaveformHeaderPresent(const std::byte *header, std::size_t byteCount) {
+    if(byteCount < 12) {
+      return false;
+    }
+
+    bool isRiff = (
+      (header[0] == std::byte(0x52)) &&   //  1 R | RIFF (FourCC; chunk descriptor)
+      (header[1] == std::byte(0x49)) &&   //  2 I |
+      (header[2] == std::byte(0x46)) &&   //  3 F |
+      (header[3] == std::byte(0x46))      //  4 F |
+    );
+    bool isWave = (
+      (header[8] == std::byte(0x57)) &&   //  1 W | WAVE (format id)
+      (header[9] == std::byte(0x41)) &&   //  2 A |
+      (header[10] == std::byte(0x56)) &&  //  3 V |
+      (header[11] == std::byte(0x45))     //  4 E |
+    );
+    bool isSizeUnknown = (
+      (
+        (header[4] == std::byte(0x00)) && (header[5] == std::byte(0x00)) &&
+        (header[6] == std::byte(0x00)) && (header[7] == std::byte(0x00))
+      ) || (
+        (header[4] == std::byte(0xFF)) && (header[5] == std::byte(0xFF)) &&
+        (header[6] == std::byte(0xFF)) && (header[7] == std::byte(0xFF))
+      )
+    );
+
+    return isRiff && isWave && isSizeUnknown;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sequential source that delivers already read bytes again before the rest</summary>
+  /// <remarks>
+  ///   The codec has to be identified from the first bytes of the stream, but those
+  ///   can't be read a second time from a pipe, so they're handed to the decoder from here.
+  /// </remarks>
+  class ReplayingSource : public Nuclex::Audio::Storage::SequentialSource {
+
+    /// <summary>Initializes a new replaying source</summary>
+    /// <param name="source">Source that delivers the data following the replayed bytes</param>
+    /// <param name="replayedBytes">Bytes that will be delivered first</param>
+    /// <param name="replayedByteCount">Number of bytes that will be delivered first</param>
+    public: ReplayingSource(
+      const std::shared_ptr<Nuclex::Audio::Storage::SequentialSource> &source,
+      const std::byte *replayedBytes, std::size_t replayedByteCount
+    ) :
+      source(source),
+      replayedBytes(),
+      replayedByteCount(replayedByteCount),
+      replayPosition(0) {
+      std::copy_n(replayedBytes, replayedByteCount, this->replayedBytes);
+    }
+
+    /// <summary>Frees all resources owned by the source</summary>
+    public: ~ReplayingSource() override = default;
+
+    /// <summary>Reads the next bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Maximum number of bytes that will be read</param>
+    /// <returns>The number of bytes that were read, zero at the end of the data</returns>
+    public: std::size_t ReadSome(std::byte *buffer, std::size_t byteCount) override {
+      if(this->replayPosition < this->replayedByteCount) {
+        std::size_t readByteCount = std::min(
+          byteCount, this->replayedByteCount - this->replayPosition
+        );
+        std::copy_n(this->replayedBytes + this->replayPosition, readByteCount, buffer);
+        this->replayPosition += readByteCount;
+        return readByteCount;
+      }
+
+      return this->source->ReadSome(buffer, byteCount);
+    }
+
+    /// <summary>Source that delivers the data following the replayed bytes</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::SequentialSource> source;
+    /// <summary>Bytes that are delivered before any data from the source</summary>
+    private: std::byte replayedBytes[SignatureByteCount];
+    /// <summary>Number of bytes that are delivered before any data from the source</summary>
+    private: std::size_t replayedByteCount;
+    /// <summary>Number of replayed bytes that have already been delivered</summary>
+    private: std::size_t replayPosition;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<SequentialTrackDecoder> SequentialTrackDecoder::Open(
+    const std::shared_ptr<SequentialSource> &source
+  ) {
+    if(unlikely(!static_cast<bool>(source))) {
+      throw std::invalid_argument(u8"Sequential decoder needs a source to read from");
+    }
+
+    std::byte signature[SignatureByteCount];
+    std::size_t signatureByteCount = source->ReadFully(signature, SignatureByteCount);
+    std::shared_ptr<SequentialSource> replayingSource = std::make_shared<ReplayingSource>(
+      source, signature, signatureByteCount
+    );
+
+    bool isWaveform = (
+      Waveform::Detection::CheckIfWaveformHeaderPresent(signature, signatureByteCount) ||
+      checkIfStreamedWaveformHeaderPresent(signature, signatureByteCount)
+    );
+    if(isWaveform) {
+      return std::make_unique<Waveform::WaveformSequentialDecoder>(replayingSource);
+    }
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+    if(Flac::Detection::CheckIfFlacHeaderPresent(signature, signatureByteCount)) {
+      return std::make_unique<Flac::FlacSequentialDecoder>(replayingSource);
+    }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    if(Vorbis::Detection::CheckIfVorbisHeaderPresentLite(signature, signatureByteCount)) {
+      return std::make_unique<Vorbis::VorbisSequentialDecoder>(replayingSource);
+    }
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    if(Opus::Detection::CheckIfOpusHeaderPresentLite(signature, signatureByteCount)) {
+      return std::make_unique<Opus::OpusSequentialDecoder>(replayingSource);
+    }
+#endif
+
+    throw Errors::UnsupportedFormatError(
+      u8"Stream is not in a format that can be decoded sequentially"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
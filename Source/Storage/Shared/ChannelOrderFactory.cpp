@@ -21,6 +21,7 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "./ChannelOrderFactory.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
 
 namespace {
 
@@ -36,6 +37,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
   std::vector<ChannelPlacement> ChannelOrderFactory::FromWaveformatExtensibleLayout(
     std::size_t channelCount, ChannelPlacement channelPlacements
   ) {
+    AllocationScope channelOrderScope(AllocationSubsystem::ChannelOrder);
+
     std::vector<ChannelPlacement> channelOrder;
     channelOrder.reserve(channelCount);
 
@@ -68,6 +71,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
   std::vector<ChannelPlacement> ChannelOrderFactory::FromVorbisFamilyAndCount(
     int mappingFamily, std::size_t channelCount
   ) {
+    AllocationScope channelOrderScope(AllocationSubsystem::ChannelOrder);
+
     std::vector<ChannelPlacement> channelOrder;
     channelOrder.reserve(channelCount);
 
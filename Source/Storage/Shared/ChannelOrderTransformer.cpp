@@ -143,7 +143,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
   ) {
     std::size_t inputChannelCount = inputChannelOrder.size();
     std::size_t targetChannelCount = targetChannelOrder.size();
-    if(inputChannelCount != inputChannelCount) {
+    if(inputChannelCount != targetChannelCount) {
       throw std::invalid_argument(
         u8"Channel order mapping tables can only be created between same-sized channel lists"
       );
@@ -177,13 +177,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
       }
       for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
         if(inputChannelOrder[inputIndex] == targetChannel) {
-          if(remappingIndices[inputIndex] != std::size_t(-1)) {
+          if(remappingIndices[targetIndex] != std::size_t(-1)) {
             throw std::invalid_argument(
               u8"Input channel order contains duplicate channels"
             );
           } // if remapping index already occupied
 
-          remappingIndices[inputIndex] = inputIndex;
+          remappingIndices[targetIndex] = inputIndex;
         } // if input channel matches target channel
       } // for each input channel
     } // for each target channel
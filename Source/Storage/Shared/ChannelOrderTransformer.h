@@ -79,7 +79,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
     ///       std::vector&lt;std::size_t&gt; inputChannelLookup = (
     ///         ChannelOrderTransformer::CreateRemappingTable(inputs, outputs)
     ///       );
-    ///       for(std::size_t channel = 0; channel < channelCount; ++index) {
+    ///       for(std::size_t channel = 0; channel < channelCount; ++channel) {
     ///         audioOut[channel] = audioIn[inputChannelLookup[channel]];
     ///       }
     ///     </code>
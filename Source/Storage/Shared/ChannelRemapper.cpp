@@ -0,0 +1,200 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./ChannelRemapper.h"
+
+#include <algorithm> // for std::copy_n(), std::equal()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reorders interleaved frames using a permutation known at compile time</summary>
+  /// <typeparam name="TSample">Type of the samples that will be reordered</typeparam>
+  /// <typeparam name="InputChannelIndices">Input channel for each output channel</typeparam>
+  /// <param name="source">Samples in the input channel order</param>
+  /// <param name="target">Receives the samples in the output channel order</param>
+  /// <param name="frameCount">Number of frames that will be reordered</param>
+  template<typename TSample, std::size_t... InputChannelIndices>
+  void remapFrames(const TSample *source, TSample *target, std::size_t frameCount) {
+    constexpr std::size_t ChannelCount = sizeof...(InputChannelIndices);
+
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      std::size_t channelIndex = 0;
+      ((target[channelIndex++] = source[InputChannelIndices]), ...);
+
+      source += ChannelCount;
+      target += ChannelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reorders interleaved frames by looking up each channel in a table</summary>
+  /// <typeparam name="TSample">Type of the samples that will be reordered</typeparam>
+  /// <param name="inputChannelLookup">Input channel for each output channel</param>
+  /// <param name="source">Samples in the input channel order</param>
+  /// <param name="target">Receives the samples in the output channel order</param>
+  /// <param name="frameCount">Number of frames that will be reordered</param>
+  template<typename TSample>
+  void gatherFrames(
+    const std::vector<std::size_t> &inputChannelLookup,
+    const TSample *source, TSample *target, std::size_t frameCount
+  ) {
+    std::size_t channelCount = inputChannelLookup.size();
+    const std::size_t *inputChannelIndices = inputChannelLookup.data();
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        target[channelIndex] = source[inputChannelIndices[channelIndex]];
+      }
+      source += channelCount;
+      target += channelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Permutation for which a specialized kernel has been compiled</summary>
+  struct RemapKernel {
+
+    /// <summary>Number of channels the kernel reorders</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Input channel the kernel takes for each output channel</summary>
+    public: std::size_t InputChannelIndices[8];
+    /// <summary>Kernel for 16-bit integer samples</summary>
+    public: void (*RemapInt16)(const std::int16_t *, std::int16_t *, std::size_t);
+    /// <summary>Kernel for floating point samples</summary>
+    public: void (*RemapFloat)(const float *, float *, std::size_t);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the specialized kernel for a permutation</summary>
+  /// <typeparam name="InputChannelIndices">Input channel for each output channel</typeparam>
+  /// <returns>A description of the kernel, including its instantiations</returns>
+  template<std::size_t... InputChannelIndices>
+  constexpr RemapKernel describeKernel() {
+    return RemapKernel {
+      sizeof...(InputChannelIndices),
+      { InputChannelIndices... },
+      &remapFrames<std::int16_t, InputChannelIndices...>,
+      &remapFrames<float, InputChannelIndices...>
+    };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Permutations between the WaveformatExtensible and the Vorbis order</summary>
+  /// <remarks>
+  ///   WaveformatExtensible sorts channels by their speaker bit (FL FR FC LFE BL BR SL SR)
+  ///   whereas Vorbis groups them by position (FL FC FR SL SR BL BR LFE). 5.1 with side
+  ///   speakers has the same indices as 5.1 with back speakers, just other placements.
+  /// </remarks>
+  const RemapKernel KnownKernels[] = {
+    describeKernel<1, 0>(), // Stereo with swapped sides
+    describeKernel<0, 2, 1>(), // 3.0 in either direction
+    describeKernel<0, 2, 1, 4, 5, 3>(), // 5.1 WaveformatExtensible to Vorbis
+    describeKernel<0, 2, 1, 5, 3, 4>(), // 5.1 Vorbis to WaveformatExtensible
+    describeKernel<0, 2, 1, 6, 7, 4, 5, 3>(), // 7.1 WaveformatExtensible to Vorbis
+    describeKernel<0, 2, 1, 7, 5, 6, 3, 4>() // 7.1 Vorbis to WaveformatExtensible
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelRemapper::ChannelRemapper() :
+    inputChannelLookup(),
+    isIdentity(true),
+    int16Kernel(nullptr),
+    floatKernel(nullptr) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChannelRemapper::ChannelRemapper(const std::vector<std::size_t> &inputChannelLookup) :
+    inputChannelLookup(inputChannelLookup),
+    isIdentity(true),
+    int16Kernel(nullptr),
+    floatKernel(nullptr) {
+
+    std::size_t channelCount = inputChannelLookup.size();
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      if(inputChannelLookup[index] != index) {
+        this->isIdentity = false;
+        break;
+      }
+    }
+    if(this->isIdentity) {
+      return;
+    }
+
+    for(const RemapKernel &kernel : KnownKernels) {
+      bool isMatch = (
+        (kernel.ChannelCount == channelCount) &&
+        std::equal(
+          inputChannelLookup.begin(), inputChannelLookup.end(), kernel.InputChannelIndices
+        )
+      );
+      if(isMatch) {
+        this->int16Kernel = kernel.RemapInt16;
+        this->floatKernel = kernel.RemapFloat;
+        return;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChannelRemapper::RemapInterleaved(
+    const std::int16_t *source, std::int16_t *target, std::size_t frameCount
+  ) const {
+    if(this->isIdentity) {
+      std::copy_n(source, frameCount * this->inputChannelLookup.size(), target);
+    } else if(this->int16Kernel != nullptr) {
+      this->int16Kernel(source, target, frameCount);
+    } else {
+      gatherFrames(this->inputChannelLookup, source, target, frameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChannelRemapper::RemapInterleaved(
+    const float *source, float *target, std::size_t frameCount
+  ) const {
+    if(this->isIdentity) {
+      std::copy_n(source, frameCount * this->inputChannelLookup.size(), target);
+    } else if(this->floatKernel != nullptr) {
+      this->floatKernel(source, target, frameCount);
+    } else {
+      gatherFrames(this->inputChannelLookup, source, target, frameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,112 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_CHANNELREMAPPER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_CHANNELREMAPPER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int16_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reorders the channels in interleaved audio according to a remapping table</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A remapping table from <see cref="ChannelOrderTransformer::CreateRemappingTable" />
+  ///     is only known at runtime, so applying it means a gather loop that looks up
+  ///     each channel's source index for every single sample.
+  ///   </para>
+  ///   <para>
+  ///     Almost all tables that occur in practice translate between the WaveformatExtensible
+  ///     and the Vorbis order for stereo, 3.0, 5.1 (with back or side speakers) and 7.1.
+  ///     For those, the remapper selects a kernel that has the permutation baked in as
+  ///     template parameters. With the channel count and source indices fixed, compilers
+  ///     unroll the frame loop and turn it into vector shuffles. Identity tables become
+  ///     plain copies, and any other table is handled by the generic gather loop.
+  ///   </para>
+  /// </remarks>
+  class ChannelRemapper {
+
+    /// <summary>Initializes a new channel remapper that has no channels</summary>
+    public: ChannelRemapper();
+
+    /// <summary>Initializes a new channel remapper using the specified table</summary>
+    /// <param name="inputChannelLookup">
+    ///   Index of the input channel for each output channel
+    /// </param>
+    public: explicit ChannelRemapper(const std::vector<std::size_t> &inputChannelLookup);
+
+    /// <summary>Returns the remapping table the remapper is applying</summary>
+    /// <returns>The index of the input channel for each output channel</returns>
+    public: const std::vector<std::size_t> &GetInputChannelLookup() const {
+      return this->inputChannelLookup;
+    }
+
+    /// <summary>Whether the remapper uses a kernel specialized for its table</summary>
+    /// <returns>True if a specialized kernel or a plain copy will be used</returns>
+    public: bool IsSpecialized() const {
+      return this->isIdentity || (this->floatKernel != nullptr);
+    }
+
+    /// <summary>Reorders the channels of interleaved 16-bit samples</summary>
+    /// <param name="source">Samples in the input channel order</param>
+    /// <param name="target">Receives the samples in the output channel order</param>
+    /// <param name="frameCount">Number of frames that will be reordered</param>
+    public: void RemapInterleaved(
+      const std::int16_t *source, std::int16_t *target, std::size_t frameCount
+    ) const;
+
+    /// <summary>Reorders the channels of interleaved floating point samples</summary>
+    /// <param name="source">Samples in the input channel order</param>
+    /// <param name="target">Receives the samples in the output channel order</param>
+    /// <param name="frameCount">Number of frames that will be reordered</param>
+    public: void RemapInterleaved(
+      const float *source, float *target, std::size_t frameCount
+    ) const;
+
+    /// <summary>Kernel that reorders 16-bit samples for one specific table</summary>
+    private: typedef void Int16KernelFunction(
+      const std::int16_t *source, std::int16_t *target, std::size_t frameCount
+    );
+    /// <summary>Kernel that reorders floating point samples for one specific table</summary>
+    private: typedef void FloatKernelFunction(
+      const float *source, float *target, std::size_t frameCount
+    );
+
+    /// <summary>Index of the input channel for each output channel</summary>
+    private: std::vector<std::size_t> inputChannelLookup;
+    /// <summary>Whether each output channel is taken from the same input channel</summary>
+    private: bool isIdentity;
+    /// <summary>Specialized kernel for 16-bit samples or null for the generic loop</summary>
+    private: Int16KernelFunction *int16Kernel;
+    /// <summary>Specialized kernel for float samples or null for the generic loop</summary>
+    private: FloatKernelFunction *floatKernel;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_CHANNELREMAPPER_H
@@ -0,0 +1,113 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_CLAMPINGSAMPLECONVERTER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_CLAMPINGSAMPLECONVERTER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Processing/Quantization.h"
+
+#include <algorithm> // for std::clamp()
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int32_t, std::uint32_t
+#include <type_traits> // for std::is_same<>, std::conditional<>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts processed float samples into the sample format of the caller</summary>
+  /// <remarks>
+  ///   Processing such as mixing or resampling can produce samples beyond full scale,
+  ///   so samples are clamped before they're quantized. Otherwise, they'd wrap around
+  ///   and produce loud clicks. Floating point samples are delivered as they are.
+  /// </remarks>
+  class ClampingSampleConverter {
+
+    /// <summary>Converts processed samples into the target format</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="source">Processed samples of a single channel</param>
+    /// <param name="target">Address at which the first converted sample will be stored</param>
+    /// <param name="stride">Distance between the converted samples in the target buffer</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    public: template<typename TSample>
+    inline static void Convert(
+      const float *source, TSample *target, std::size_t stride, std::size_t sampleCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  inline void ClampingSampleConverter::Convert(
+    const float *source, TSample *target, std::size_t stride, std::size_t sampleCount
+  ) {
+    if constexpr(std::is_same<TSample, float>::value || std::is_same<TSample, double>::value) {
+      for(std::size_t index = 0; index < sampleCount; ++index) {
+        *target = static_cast<TSample>(source[index]);
+        target += stride;
+      }
+    } else {
+      // A float can't represent 2^31 - 1 exactly, so 32 bit samples go through doubles
+      typedef typename std::conditional<
+        sizeof(TSample) < 3, float, double
+      >::type LimitType;
+      const LimitType limit = static_cast<LimitType>(
+        (std::uint32_t(1) << (sizeof(TSample) * 8 - 1)) - 1
+      );
+      const std::int32_t midpoint = std::is_same<TSample, std::uint8_t>::value ? 128 : 0;
+
+      while(3 < sampleCount) {
+        float clamped[4];
+        clamped[0] = std::clamp(source[0], -1.0f, 1.0f);
+        clamped[1] = std::clamp(source[1], -1.0f, 1.0f);
+        clamped[2] = std::clamp(source[2], -1.0f, 1.0f);
+        clamped[3] = std::clamp(source[3], -1.0f, 1.0f);
+
+        std::int32_t scaled[4];
+        Processing::Quantization::MultiplyToNearestInt32x4(clamped, limit, scaled);
+
+        target[0] = static_cast<TSample>(scaled[0] + midpoint);
+        target[stride] = static_cast<TSample>(scaled[1] + midpoint);
+        target[stride * 2] = static_cast<TSample>(scaled[2] + midpoint);
+        target[stride * 3] = static_cast<TSample>(scaled[3] + midpoint);
+
+        source += 4;
+        target += stride * 4;
+        sampleCount -= 4;
+      }
+      while(0 < sampleCount) {
+        LimitType clamped = static_cast<LimitType>(std::clamp(source[0], -1.0f, 1.0f));
+        *target = static_cast<TSample>(
+          Processing::Quantization::NearestInt32(clamped * limit) + midpoint
+        );
+
+        ++source;
+        target += stride;
+        --sampleCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_CLAMPINGSAMPLECONVERTER_H
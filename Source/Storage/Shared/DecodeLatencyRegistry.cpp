@@ -0,0 +1,140 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./DecodeLatencyRegistry.h"
+#include "./LatencyRecorder.h"
+
+#include <limits> // for std::numeric_limits
+#include <utility> // for std::move()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of codecs whose decoding times are grouped separately</summary>
+  const std::size_t CodecCount = 7;
+
+  /// <summary>Names reported for the codecs, in the order of the codec enumeration</summary>
+  const char *const CodecNames[CodecCount] = {
+    u8"FLAC", u8"Opus", u8"Vorbis", u8"WavPack", u8"Waveform", u8"AIFF", u8"Raw PCM"
+  };
+
+  /// <summary>Number of call size groups each codec's decoding times are split into</summary>
+  const std::size_t FrameCountGroupCount = 6;
+
+  /// <summary>Most frames a call may request to be counted in each call size group</summary>
+  /// <remarks>
+  ///   The groups cover the buffer sizes audio threads typically run with, each one four
+  ///   times the size of the previous, and a final group for all larger calls.
+  /// </remarks>
+  const std::size_t MaximumFrameCounts[FrameCountGroupCount] = {
+    64, 256, 1024, 4096, 16384, std::numeric_limits<std::size_t>::max()
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the call size group a decoding call is counted in</summary>
+  /// <param name="frameCount">Number of frames the call requested</param>
+  /// <returns>The index of the call size group for the call</returns>
+  std::size_t getFrameCountGroup(std::size_t frameCount) {
+    std::size_t group = 0;
+    while(frameCount > MaximumFrameCounts[group]) {
+      ++group;
+    }
+    return group;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the histograms for all codecs and call size groups</summary>
+  /// <returns>The histograms, with the call size groups of each codec next to each other</returns>
+  Nuclex::Audio::Storage::Shared::LatencyRecorder *getRecorders() {
+    static Nuclex::Audio::Storage::Shared::LatencyRecorder recorders[
+      CodecCount * FrameCountGroupCount
+    ];
+    return recorders;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::atomic<bool> DecodeLatencyRegistry::isEnabled(false);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecodeLatencyRegistry::Enable(bool enable) {
+    LatencyRecorder *recorders = getRecorders();
+    bool wasEnabled = isEnabled.load(std::memory_order_relaxed);
+    if(enable && !wasEnabled) {
+      for(std::size_t index = 0; index < CodecCount * FrameCountGroupCount; ++index) {
+        recorders[index].Reset();
+      }
+    }
+
+    isEnabled.store(enable, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecodeLatencyRegistry::Record(
+    TrackedCodec codec, std::size_t frameCount, std::chrono::nanoseconds latency
+  ) {
+    std::size_t index = (
+      static_cast<std::size_t>(codec) * FrameCountGroupCount + getFrameCountGroup(frameCount)
+    );
+    getRecorders()[index].Record(latency);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<DecodeLatencyGroup> DecodeLatencyRegistry::TakeSnapshot(bool reset) {
+    LatencyRecorder *recorders = getRecorders();
+
+    std::vector<DecodeLatencyGroup> groups;
+    for(std::size_t codec = 0; codec < CodecCount; ++codec) {
+      for(std::size_t group = 0; group < FrameCountGroupCount; ++group) {
+        LatencyHistogram latencies = recorders[codec * FrameCountGroupCount + group].TakeSnapshot(
+          reset
+        );
+        if(latencies.CallCount == 0) {
+          continue;
+        }
+
+        DecodeLatencyGroup &snapshot = groups.emplace_back();
+        snapshot.CodecName = CodecNames[codec];
+        snapshot.MinimumFrameCount = (group == 0) ? 0 : (MaximumFrameCounts[group - 1] + 1);
+        snapshot.MaximumFrameCount = MaximumFrameCounts[group];
+        snapshot.Latencies = std::move(latencies);
+      }
+    }
+
+    return groups;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,97 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_DECODELATENCYREGISTRY_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_DECODELATENCYREGISTRY_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/DecodeLatencyTracker.h"
+
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Codecs whose decoding times are grouped separately</summary>
+  enum class TrackedCodec {
+
+    /// <summary>Free Lossless Audio Codec</summary>
+    Flac,
+    /// <summary>Opus in an Ogg container</summary>
+    Opus,
+    /// <summary>Vorbis in an Ogg container</summary>
+    Vorbis,
+    /// <summary>WavPack, lossless or hybrid</summary>
+    WavPack,
+    /// <summary>Uncompressed waveform audio</summary>
+    Waveform,
+    /// <summary>Uncompressed audio interchange file format</summary>
+    Aiff,
+    /// <summary>Headerless PCM samples in a caller-described layout</summary>
+    RawPcm
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Holds the histograms behind the public decode latency tracker</summary>
+  /// <remarks>
+  ///   Decoders call <see cref="Record" /> from their decoding scope. There is one
+  ///   histogram for each codec and call size group, created the first time recording
+  ///   is turned on and kept until the process ends.
+  /// </remarks>
+  class DecodeLatencyRegistry {
+
+    /// <summary>Checks whether decoding times are currently being recorded</summary>
+    /// <returns>True if decoding times are being recorded</returns>
+    public: static bool IsEnabled() {
+      return isEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Starts or stops recording decoding times</summary>
+    /// <param name="enable">True to start recording, false to stop</param>
+    public: static void Enable(bool enable);
+
+    /// <summary>Records the wall time of a decoding call</summary>
+    /// <param name="codec">Codec of the decoder that made the call</param>
+    /// <param name="frameCount">Number of frames the call requested</param>
+    /// <param name="latency">Wall time the call took</param>
+    public: static void Record(
+      TrackedCodec codec, std::size_t frameCount, std::chrono::nanoseconds latency
+    );
+
+    /// <summary>Copies the decoding times recorded so far</summary>
+    /// <param name="reset">Whether to empty the histograms while copying them</param>
+    /// <returns>One group for each codec and call size that has recorded any calls</returns>
+    public: static std::vector<DecodeLatencyGroup> TakeSnapshot(bool reset);
+
+    /// <summary>Whether decoding times are being recorded</summary>
+    private: static std::atomic<bool> isEnabled;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_DECODELATENCYREGISTRY_H
@@ -0,0 +1,137 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./DecodePathBuilder.h"
+#include "Nuclex/Audio/Processing/Quantization.h" // for NUCLEX_AUDIO_HAVE_SSE2 etc.
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *DecodePathBuilder::GetSampleFormatName(AudioSampleFormat format) {
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8: { return u8"uint8"; }
+      case AudioSampleFormat::SignedInteger_16: { return u8"int16"; }
+      case AudioSampleFormat::SignedInteger_24: { return u8"int24"; }
+      case AudioSampleFormat::SignedInteger_32: { return u8"int32"; }
+      case AudioSampleFormat::Float_32: { return u8"float32"; }
+      case AudioSampleFormat::Float_64: { return u8"float64"; }
+      default: { return u8"unknown"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *DecodePathBuilder::GetInlineKernelSetName() {
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    return u8"SSE2";
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    return u8"NEON";
+#else
+    return u8"scalar";
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioSampleFormat DecodePathBuilder::GetDeliveredFormat(AudioSampleFormat format) {
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8:
+      case AudioSampleFormat::SignedInteger_16:
+      case AudioSampleFormat::SignedInteger_32:
+      case AudioSampleFormat::Float_32:
+      case AudioSampleFormat::Float_64: {
+        return format;
+      }
+      case AudioSampleFormat::SignedInteger_24: {
+        return AudioSampleFormat::SignedInteger_32;
+      }
+      default: {
+        throw std::invalid_argument(u8"Decoders can not deliver samples in an unknown format");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DecodePathBuilder::IsFloatingPoint(AudioSampleFormat format) {
+    return (
+      (format == AudioSampleFormat::Float_32) ||
+      (format == AudioSampleFormat::Float_64)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder::DecodePathBuilder(
+    const char *codecName, AudioSampleFormat format, const char *detail
+  ) :
+    path() {
+    this->path.Origin.append(codecName);
+    this->path.Origin.push_back(u8' ');
+    this->path.Origin.append(GetSampleFormatName(format));
+    this->path.Origin.push_back(u8' ');
+    this->path.Origin.append(detail);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder::DecodePathBuilder(const DecodePath &innerPath) :
+    path(innerPath) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder &DecodePathBuilder::AddPass(const std::string &step) {
+    this->path.Steps.push_back(step);
+    ++this->path.PassCount;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder &DecodePathBuilder::AddFusedStep(const std::string &step) {
+    this->path.Steps.push_back(step);
+    if(this->path.PassCount == 0) {
+      this->path.PassCount = 1;
+    }
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder &DecodePathBuilder::AddScratchBuffer() {
+    ++this->path.ScratchBufferCount;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePathBuilder &DecodePathBuilder::SetZeroCopy(bool zeroCopy /* = true */) {
+    this->path.IsZeroCopy = zeroCopy;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_DECODEPATHBUILDER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_DECODEPATHBUILDER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AudioSampleFormat.h"
+#include "Nuclex/Audio/Storage/DecodePath.h"
+
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Assembles the description of the path samples take through a decoder</summary>
+  /// <remarks>
+  ///   Decoders mirror the choices of their decoding methods with calls to this builder,
+  ///   so the names used for the steps stay the same across all codecs.
+  /// </remarks>
+  class DecodePathBuilder {
+
+    /// <summary>Returns the short name of a sample format, i.e. &quot;int16&quot;</summary>
+    /// <param name="format">Sample format whose name will be returned</param>
+    /// <returns>The short name of the specified sample format</returns>
+    public: static const char *GetSampleFormatName(AudioSampleFormat format);
+
+    /// <summary>Returns the instruction set the inline conversion helpers use</summary>
+    /// <returns>&quot;SSE2&quot;, &quot;NEON&quot; or &quot;scalar&quot;</returns>
+    /// <remarks>
+    ///   The helpers in <see cref="Processing.Quantization" /> and
+    ///   <see cref="Processing.Reconstruction" /> are fixed to the instruction set
+    ///   the library was compiled for, unlike the runtime-selected conversion kernels.
+    /// </remarks>
+    public: static const char *GetInlineKernelSetName();
+
+    /// <summary>Checks the format a caller requests and maps it to the delivered one</summary>
+    /// <param name="format">Sample format the caller wants to obtain</param>
+    /// <returns>The format the decoding methods will deliver samples in</returns>
+    /// <remarks>
+    ///   24-bit samples are delivered in 32-bit integers, so they take the same path.
+    /// </remarks>
+    public: static AudioSampleFormat GetDeliveredFormat(AudioSampleFormat format);
+
+    /// <summary>Checks whether a sample format is a floating point format</summary>
+    /// <param name="format">Sample format that will be checked</param>
+    /// <returns>True if the sample format stores floating point values</returns>
+    public: static bool IsFloatingPoint(AudioSampleFormat format);
+
+    /// <summary>Initializes a new decode path builder</summary>
+    /// <param name="codecName">Name of the codec the samples originate from</param>
+    /// <param name="format">Format in which the codec produces samples</param>
+    /// <param name="detail">How the codec produces them, i.e. &quot;separated&quot;</param>
+    public: DecodePathBuilder(
+      const char *codecName, AudioSampleFormat format, const char *detail
+    );
+
+    /// <summary>Initializes a new decode path builder that extends an existing path</summary>
+    /// <param name="innerPath">Path of a wrapped decoder that will be extended</param>
+    public: explicit DecodePathBuilder(const DecodePath &innerPath);
+
+    /// <summary>Adds a step that walks through the samples on its own</summary>
+    /// <param name="step">Name of the step, i.e. &quot;Interleave SSE2&quot;</param>
+    /// <returns>The builder itself so calls can be chained</returns>
+    public: DecodePathBuilder &AddPass(const std::string &step);
+
+    /// <summary>Adds a step that is fused into the loop of the previous pass</summary>
+    /// <param name="step">Name of the step, i.e. &quot;interleave&quot;</param>
+    /// <returns>The builder itself so calls can be chained</returns>
+    public: DecodePathBuilder &AddFusedStep(const std::string &step);
+
+    /// <summary>Records that the samples are stored in an intermediate buffer</summary>
+    /// <returns>The builder itself so calls can be chained</returns>
+    public: DecodePathBuilder &AddScratchBuffer();
+
+    /// <summary>Records whether the encoded data is accessed in the file's memory</summary>
+    /// <param name="zeroCopy">True if the file lends its memory to the decoder</param>
+    /// <returns>The builder itself so calls can be chained</returns>
+    public: DecodePathBuilder &SetZeroCopy(bool zeroCopy = true);
+
+    /// <summary>Returns the decode path assembled so far</summary>
+    /// <returns>The assembled decode path</returns>
+    public: const DecodePath &GetPath() const { return this->path; }
+
+    /// <summary>Decode path that is being assembled</summary>
+    private: DecodePath path;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_DECODEPATHBUILDER_H
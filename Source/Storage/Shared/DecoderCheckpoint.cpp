@@ -0,0 +1,113 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./DecoderCheckpoint.h"
+
+#include <cassert> // for assert()
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderCheckpointCache::DecoderCheckpointCache(std::size_t capacity /* = 8 */) :
+    capacity(capacity),
+    nextReplacementIndex(0),
+    entries() {
+    assert((capacity > 0) && u8"Checkpoint cache can track at least one frame");
+    this->entries.reserve(capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const DecoderCheckpoint *DecoderCheckpointCache::TryFindCheckpoint(
+    std::uint64_t frameIndex
+  ) const {
+    for(const Entry &entry : this->entries) {
+      if((entry.FrameIndex == frameIndex) && entry.HasCheckpoint) {
+        return &entry.Checkpoint;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DecoderCheckpointCache::NoteSeek(std::uint64_t frameIndex) {
+    if(findEntry(frameIndex) != nullptr) {
+      return true;
+    }
+
+    Entry &entry = addEntry();
+    entry.FrameIndex = frameIndex;
+    entry.HasCheckpoint = false;
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecoderCheckpointCache::AddCheckpoint(const DecoderCheckpoint &checkpoint) {
+    Entry *entry = findEntry(checkpoint.FrameIndex);
+    if(entry == nullptr) {
+      entry = &addEntry();
+      entry->FrameIndex = checkpoint.FrameIndex;
+    }
+
+    entry->HasCheckpoint = true;
+    entry->Checkpoint = checkpoint;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderCheckpointCache::Entry *DecoderCheckpointCache::findEntry(std::uint64_t frameIndex) {
+    for(Entry &entry : this->entries) {
+      if(entry.FrameIndex == frameIndex) {
+        return &entry;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderCheckpointCache::Entry &DecoderCheckpointCache::addEntry() {
+    if(this->entries.size() < this->capacity) {
+      this->entries.emplace_back();
+      return this->entries.back();
+    }
+
+    Entry &replaced = this->entries[this->nextReplacementIndex];
+    this->nextReplacementIndex = (this->nextReplacementIndex + 1) % this->capacity;
+    return replaced;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecoderCheckpointCache::Clear() {
+    this->nextReplacementIndex = 0;
+    this->entries.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,135 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_DECODERCHECKPOINT_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_DECODERCHECKPOINT_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lets a reader return to a frame without searching for it again</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A checkpoint records where in the file the reader can pick up decoding so
+  ///     that it reaches the checkpoint's frame cleanly. Restoring it is a single
+  ///     jump to that offset and a short decode forward, instead of a bisection search
+  ///     through the file followed by the codec's pre-roll.
+  ///   </para>
+  ///   <para>
+  ///     The codec libraries keep their decoder state in opaque structures, so the state
+  ///     itself can't be copied. If a reader finds no suitable offset, the checkpoint
+  ///     is marked as indirect and restoring it will do a normal seek.
+  ///   </para>
+  /// </remarks>
+  struct DecoderCheckpoint {
+
+    /// <summary>Frame the reader will be at after restoring the checkpoint</summary>
+    public: std::uint64_t FrameIndex;
+    /// <summary>Frame at which decoding resumes after jumping to the offset</summary>
+    public: std::uint64_t ResumeFrameIndex;
+    /// <summary>Offset in the file the reader jumps to</summary>
+    public: std::uint64_t ByteOffset;
+    /// <summary>Whether the reader can jump to the offset directly</summary>
+    public: bool IsDirect;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps checkpoints for frames that are sought to repeatedly</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Loop points in music make players seek back to the same frame over and over.
+  ///     Decoders note each seek target here. Once a frame has been sought to twice,
+  ///     the decoder creates a checkpoint for it and all later seeks to that frame
+  ///     restore the checkpoint.
+  ///   </para>
+  ///   <para>
+  ///     Only a few frames are tracked. New ones replace the oldest. The cache is owned
+  ///     by a single decoder and is not thread-safe.
+  ///   </para>
+  /// </remarks>
+  class DecoderCheckpointCache {
+
+    /// <summary>Initializes a new, empty checkpoint cache</summary>
+    /// <param name="capacity">Maximum number of frames the cache will track</param>
+    public: DecoderCheckpointCache(std::size_t capacity = 8);
+
+    /// <summary>Frees all memory used by the checkpoint cache</summary>
+    public: ~DecoderCheckpointCache() = default;
+
+    /// <summary>Looks up the checkpoint for the specified frame</summary>
+    /// <param name="frameIndex">Frame for which a checkpoint will be looked up</param>
+    /// <returns>The checkpoint for the frame or a null pointer if there is none</returns>
+    public: const DecoderCheckpoint *TryFindCheckpoint(std::uint64_t frameIndex) const;
+
+    /// <summary>Notes that the decoder is seeking to the specified frame</summary>
+    /// <param name="frameIndex">Frame the decoder is seeking to</param>
+    /// <returns>True if the decoder has sought to the frame before</returns>
+    public: bool NoteSeek(std::uint64_t frameIndex);
+
+    /// <summary>Stores a checkpoint, replacing the oldest entry if the cache is full</summary>
+    /// <param name="checkpoint">Checkpoint that will be stored</param>
+    public: void AddCheckpoint(const DecoderCheckpoint &checkpoint);
+
+    /// <summary>Forgets all tracked frames while keeping the memory allocated</summary>
+    public: void Clear();
+
+    /// <summary>Frame that has been sought to and its checkpoint, if created</summary>
+    private: struct Entry {
+
+      /// <summary>Frame that has been sought to</summary>
+      public: std::uint64_t FrameIndex;
+      /// <summary>Whether a checkpoint has been created for the frame</summary>
+      public: bool HasCheckpoint;
+      /// <summary>Checkpoint for the frame, only valid if the flag is set</summary>
+      public: DecoderCheckpoint Checkpoint;
+
+    };
+
+    /// <summary>Looks up the entry for the specified frame</summary>
+    /// <param name="frameIndex">Frame whose entry will be looked up</param>
+    /// <returns>The entry for the frame or a null pointer if there is none</returns>
+    private: Entry *findEntry(std::uint64_t frameIndex);
+
+    /// <summary>Adds a new entry, replacing the oldest one if the cache is full</summary>
+    /// <returns>The entry that has been added</returns>
+    private: Entry &addEntry();
+
+    /// <summary>Maximum number of frames the cache will track</summary>
+    private: std::size_t capacity;
+    /// <summary>Index of the entry that will be replaced next</summary>
+    private: std::size_t nextReplacementIndex;
+    /// <summary>Frames that have been sought to, in no particular order</summary>
+    private: std::vector<Entry> entries;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_DECODERCHECKPOINT_H
@@ -0,0 +1,200 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./DecoderStatisticsCollector.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/ReadRequest.h"
+
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Passes all reads on to another file, counting the bytes read</summary>
+  class ReadCountingFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new read counting file wrapping the specified file</summary>
+    /// <param name="statistics">Collector that will receive the number of bytes read</param>
+    /// <param name="file">File whose reads will be counted</param>
+    public: ReadCountingFile(
+      const std::shared_ptr<Nuclex::Audio::Storage::Shared::DecoderStatisticsCollector> &statistics,
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &file
+    ) :
+      statistics(statistics),
+      file(file) {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~ReadCountingFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->file->GetSize(); }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      this->file->ReadAt(start, byteCount, buffer);
+      this->statistics->AddReadBytes(byteCount);
+    }
+
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    public: void ReadManyAt(
+      const Nuclex::Audio::Storage::ReadRequest *requests, std::size_t requestCount
+    ) const override {
+      this->file->ReadManyAt(requests, requestCount);
+      if(this->statistics->IsEnabled()) {
+        std::uint64_t byteCount = 0;
+        for(std::size_t index = 0; index < requestCount; ++index) {
+          byteCount += requests[index].ByteCount;
+        }
+        this->statistics->AddReadBytes(byteCount);
+      }
+    }
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>A pointer to the wrapped file's memory or a null pointer</returns>
+    /// <remarks>
+    ///   Borrowed bytes are counted as read since the caller uses them in place of a read.
+    /// </remarks>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      const std::byte *borrowed = this->file->TryBorrowAt(start, byteCount);
+      if(borrowed != nullptr) {
+        this->statistics->AddReadBytes(byteCount);
+      }
+      return borrowed;
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Decoders only read, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      (void)start;
+      (void)byteCount;
+      (void)buffer;
+      throw std::runtime_error(u8"Files opened for decoding are read-only");
+    }
+
+    /// <summary>Collector that receives the number of bytes read</summary>
+    private: std::shared_ptr<Nuclex::Audio::Storage::Shared::DecoderStatisticsCollector> statistics;
+    /// <summary>File whose reads are being counted</summary>
+    private: std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatisticsCollector::DecoderStatisticsCollector(
+    TrackedCodec codec, bool enabled /* = false */
+  ) :
+    codec(codec),
+    isEnabled(enabled),
+    decodedFrameCount(0),
+    seekCount(0),
+    discardedFrameCount(0),
+    readByteCount(0),
+    decodeTicks(0),
+    lockWaitTicks(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> DecoderStatisticsCollector::CountReads(
+    const std::shared_ptr<DecoderStatisticsCollector> &statistics,
+    const std::shared_ptr<const VirtualFile> &file
+  ) {
+    return std::make_shared<ReadCountingFile>(statistics, file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecoderStatisticsCollector::Enable(bool enable) {
+    bool wasEnabled = this->isEnabled.load(std::memory_order_relaxed);
+    if(enable && !wasEnabled) {
+      this->decodedFrameCount.store(0, std::memory_order_relaxed);
+      this->seekCount.store(0, std::memory_order_relaxed);
+      this->discardedFrameCount.store(0, std::memory_order_relaxed);
+      this->readByteCount.store(0, std::memory_order_relaxed);
+      this->decodeTicks.store(0, std::memory_order_relaxed);
+      this->lockWaitTicks.store(0, std::memory_order_relaxed);
+      this->latencies.Reset();
+    }
+
+    this->isEnabled.store(enable, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics DecoderStatisticsCollector::GetSnapshot() const {
+    DecoderStatistics statistics;
+    statistics.DecodedFrameCount = this->decodedFrameCount.load(std::memory_order_relaxed);
+    statistics.SeekCount = this->seekCount.load(std::memory_order_relaxed);
+    statistics.DiscardedFrameCount = this->discardedFrameCount.load(std::memory_order_relaxed);
+    statistics.ReadByteCount = this->readByteCount.load(std::memory_order_relaxed);
+    statistics.DecodeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::duration(
+        static_cast<std::chrono::steady_clock::rep>(
+          this->decodeTicks.load(std::memory_order_relaxed)
+        )
+      )
+    );
+    statistics.LockWaitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::duration(
+        static_cast<std::chrono::steady_clock::rep>(
+          this->lockWaitTicks.load(std::memory_order_relaxed)
+        )
+      )
+    );
+    return statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,321 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_DECODERSTATISTICSCOLLECTOR_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_DECODERSTATISTICSCOLLECTOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/Storage/DecoderStatistics.h"
+#include "./DecodeLatencyRegistry.h"
+#include "./LatencyRecorder.h"
+
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::steady_clock
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::uncaught_exceptions()
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects the statistics of a single decoder</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All counters are atomics updated with relaxed ordering, so reading the statistics
+  ///     never blocks a decoding thread. While disabled, every recording method returns
+  ///     after a single relaxed load, which is why decoders keep this switched off until
+  ///     someone asks for statistics rather than compiling it out.
+  ///   </para>
+  ///   <para>
+  ///     Each decoder owns its collector. Clones get a collector of their own that starts
+  ///     at zero but inherits whether statistics are enabled.
+  ///   </para>
+  ///   <para>
+  ///     Besides the totals, the collector keeps a histogram of the wall time of each
+  ///     decoding call. The codec it is constructed for decides which group of the global
+  ///     decode latency tracker its decoding calls are counted in.
+  ///   </para>
+  /// </remarks>
+  class DecoderStatisticsCollector {
+
+    /// <summary>Initializes a new statistics collector with all counters at zero</summary>
+    /// <param name="codec">Codec of the decoder that owns the collector</param>
+    /// <param name="enabled">Whether the collector should begin recording right away</param>
+    public: DecoderStatisticsCollector(TrackedCodec codec, bool enabled = false);
+
+    /// <summary>Wraps a file so that all reads from it are counted</summary>
+    /// <param name="statistics">Collector that will receive the number of bytes read</param>
+    /// <param name="file">File whose reads will be counted</param>
+    /// <returns>A file that forwards to the specified file, counting the bytes read</returns>
+    public: static std::shared_ptr<const VirtualFile> CountReads(
+      const std::shared_ptr<DecoderStatisticsCollector> &statistics,
+      const std::shared_ptr<const VirtualFile> &file
+    );
+
+    /// <summary>Turns recording on or off</summary>
+    /// <param name="enable">True to start recording, false to stop</param>
+    /// <remarks>
+    ///   Turning recording on while it was off resets all counters to zero.
+    /// </remarks>
+    public: void Enable(bool enable);
+
+    /// <summary>Returns the codec of the decoder that owns the collector</summary>
+    /// <returns>The codec the collector was constructed for</returns>
+    public: TrackedCodec GetCodec() const { return this->codec; }
+
+    /// <summary>Checks whether the collector is currently recording</summary>
+    /// <returns>True if the collector is recording statistics</returns>
+    public: bool IsEnabled() const {
+      return this->isEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Records bytes that have been read from the decoder's file</summary>
+    /// <param name="byteCount">Number of bytes that have been read</param>
+    public: void AddReadBytes(std::uint64_t byteCount) {
+      if(IsEnabled()) {
+        this->readByteCount.fetch_add(byteCount, std::memory_order_relaxed);
+      }
+    }
+
+    /// <summary>Records a seek performed by the decoder</summary>
+    public: void AddSeek() {
+      if(IsEnabled()) {
+        this->seekCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    /// <summary>Records frames that were decoded and thrown away to reach a seek target</summary>
+    /// <param name="frameCount">Number of frames that were thrown away</param>
+    public: void AddDiscardedFrames(std::uint64_t frameCount) {
+      if(IsEnabled()) {
+        this->discardedFrameCount.fetch_add(frameCount, std::memory_order_relaxed);
+      }
+    }
+
+    /// <summary>Records a completed decoding call</summary>
+    /// <param name="frameCount">Number of frames the call handed out</param>
+    /// <param name="decodeTime">Time spent decoding after the lock was acquired</param>
+    /// <param name="lockWaitTime">Time spent waiting to acquire the lock</param>
+    public: void AddDecode(
+      std::uint64_t frameCount,
+      std::chrono::steady_clock::duration decodeTime,
+      std::chrono::steady_clock::duration lockWaitTime
+    ) {
+      this->latencies.Record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(decodeTime + lockWaitTime)
+      );
+      this->decodedFrameCount.fetch_add(frameCount, std::memory_order_relaxed);
+      this->decodeTicks.fetch_add(
+        static_cast<std::uint64_t>(decodeTime.count()), std::memory_order_relaxed
+      );
+      this->lockWaitTicks.fetch_add(
+        static_cast<std::uint64_t>(lockWaitTime.count()), std::memory_order_relaxed
+      );
+    }
+
+    /// <summary>Takes a snapshot of the current counter values</summary>
+    /// <returns>The statistics recorded so far</returns>
+    public: DecoderStatistics GetSnapshot() const;
+
+    /// <summary>Copies the histogram of decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while copying it</param>
+    /// <returns>The distribution of decoding call times recorded so far</returns>
+    public: LatencyHistogram GetLatencies(bool reset) {
+      return this->latencies.TakeSnapshot(reset);
+    }
+
+    /// <summary>Codec of the decoder that owns the collector</summary>
+    private: TrackedCodec codec;
+    /// <summary>Whether the collector is recording</summary>
+    private: std::atomic<bool> isEnabled;
+    /// <summary>Total number of frames handed out to callers</summary>
+    private: std::atomic<std::uint64_t> decodedFrameCount;
+    /// <summary>Number of seeks the decoder performed</summary>
+    private: std::atomic<std::uint64_t> seekCount;
+    /// <summary>Frames decoded and thrown away to land on seek targets</summary>
+    private: std::atomic<std::uint64_t> discardedFrameCount;
+    /// <summary>Number of bytes read from the decoder's file</summary>
+    private: std::atomic<std::uint64_t> readByteCount;
+    /// <summary>Time spent decoding, in ticks of the steady clock</summary>
+    private: std::atomic<std::uint64_t> decodeTicks;
+    /// <summary>Time spent waiting for the decoding mutex, in ticks of the steady clock</summary>
+    private: std::atomic<std::uint64_t> lockWaitTicks;
+    /// <summary>Wall time of each decoding call, including lock wait time</summary>
+    private: LatencyRecorder latencies;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Holds a decoder's mutex for one decoding call and records the call</summary>
+  /// <remarks>
+  ///   Replaces the std::lock_guard decoders would otherwise use. If statistics are off
+  ///   and the global decode latency tracker is, too, it just locks the mutex. Otherwise,
+  ///   it also measures how long acquiring the lock took and how long the decoding call
+  ///   held it, plus the frames it delivered unless the call ends with an exception.
+  ///   Allocations made during the call are tagged as the codec library's.
+  /// </remarks>
+  class DecodeStatisticsScope {
+
+    /// <summary>Locks the mutex, recording the call if statistics are enabled</summary>
+    /// <param name="mutex">Mutex that will be held until the scope ends</param>
+    /// <param name="statistics">Collector that will record the call</param>
+    /// <param name="frameCount">Number of frames the decoding call will deliver</param>
+    public: DecodeStatisticsScope(
+      std::mutex &mutex, DecoderStatisticsCollector &statistics, std::size_t frameCount
+    ) :
+      allocationScope(getAllocationSubsystem(statistics), getAllocationCodec(statistics)),
+      mutex(&mutex),
+      statistics(&statistics),
+      frameCount(frameCount),
+      isRecordingStatistics(statistics.IsEnabled()),
+      isTrackingLatency(DecodeLatencyRegistry::IsEnabled()) {
+      if(!this->isRecordingStatistics && !this->isTrackingLatency) {
+        mutex.lock();
+      } else {
+        std::chrono::steady_clock::time_point lockTime = std::chrono::steady_clock::now();
+        mutex.lock();
+        this->startTime = std::chrono::steady_clock::now();
+        this->lockWaitTime = this->startTime - lockTime;
+        this->exceptionCount = std::uncaught_exceptions();
+      }
+    }
+
+    /// <summary>Records a decoding call that doesn't need a lock</summary>
+    /// <param name="statistics">Collector that will record the call</param>
+    /// <param name="frameCount">Number of frames the decoding call will deliver</param>
+    public: DecodeStatisticsScope(
+      DecoderStatisticsCollector &statistics, std::size_t frameCount
+    ) :
+      allocationScope(getAllocationSubsystem(statistics), getAllocationCodec(statistics)),
+      mutex(nullptr),
+      statistics(&statistics),
+      frameCount(frameCount),
+      isRecordingStatistics(statistics.IsEnabled()),
+      isTrackingLatency(DecodeLatencyRegistry::IsEnabled()) {
+      if(this->isRecordingStatistics || this->isTrackingLatency) {
+        this->startTime = std::chrono::steady_clock::now();
+        this->lockWaitTime = std::chrono::steady_clock::duration(0);
+        this->exceptionCount = std::uncaught_exceptions();
+      }
+    }
+
+    /// <summary>Records the decoding call and releases the mutex</summary>
+    public: ~DecodeStatisticsScope() {
+      if(this->isRecordingStatistics || this->isTrackingLatency) {
+        std::chrono::steady_clock::duration decodeTime = (
+          std::chrono::steady_clock::now() - this->startTime
+        );
+        if(this->isRecordingStatistics) {
+          bool hasFailed = (std::uncaught_exceptions() > this->exceptionCount);
+          this->statistics->AddDecode(
+            hasFailed ? 0 : this->frameCount, decodeTime, this->lockWaitTime
+          );
+        }
+        if(this->isTrackingLatency) {
+          DecodeLatencyRegistry::Record(
+            this->statistics->GetCodec(),
+            this->frameCount,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+              decodeTime + this->lockWaitTime
+            )
+          );
+        }
+      }
+      if(this->mutex != nullptr) {
+        this->mutex->unlock();
+      }
+    }
+
+    /// <summary>Determines how allocations during a decoding call are tagged</summary>
+    /// <param name="statistics">Collector of the decoder making the call</param>
+    /// <returns>The subsystem allocations will be attributed to</returns>
+    private: static AllocationSubsystem getAllocationSubsystem(
+      const DecoderStatisticsCollector &statistics
+    ) {
+      bool isUncompressed = (
+        (statistics.GetCodec() == TrackedCodec::Waveform) ||
+        (statistics.GetCodec() == TrackedCodec::Aiff) ||
+        (statistics.GetCodec() == TrackedCodec::RawPcm)
+      );
+      if(isUncompressed) {
+        return AllocationSubsystem::ReaderScratch; // no codec library involved
+      } else {
+        return AllocationSubsystem::CodecLibrary;
+      }
+    }
+
+    /// <summary>Determines the codec allocations during a decoding call are made for</summary>
+    /// <param name="statistics">Collector of the decoder making the call</param>
+    /// <returns>The codec allocations will be attributed to</returns>
+    private: static AllocationCodec getAllocationCodec(
+      const DecoderStatisticsCollector &statistics
+    ) {
+      switch(statistics.GetCodec()) {
+        case TrackedCodec::Flac: { return AllocationCodec::Flac; }
+        case TrackedCodec::Opus: { return AllocationCodec::Opus; }
+        case TrackedCodec::Vorbis: { return AllocationCodec::Vorbis; }
+        case TrackedCodec::WavPack: { return AllocationCodec::WavPack; }
+        case TrackedCodec::Waveform: { return AllocationCodec::Waveform; }
+        case TrackedCodec::Aiff: { return AllocationCodec::Waveform; } // same reader
+        case TrackedCodec::RawPcm: { return AllocationCodec::Waveform; } // same reader
+        default: { return AllocationCodec::None; }
+      }
+    }
+
+    /// <summary>Tags allocations made while the decoding call runs</summary>
+    private: AllocationScope allocationScope;
+    /// <summary>Mutex that is being held, if any</summary>
+    private: std::mutex *mutex;
+    /// <summary>Collector of the decoder making the call</summary>
+    private: DecoderStatisticsCollector *statistics;
+    /// <summary>Number of frames the decoding call will deliver</summary>
+    private: std::size_t frameCount;
+    /// <summary>Whether the call is recorded in the decoder's statistics</summary>
+    private: bool isRecordingStatistics;
+    /// <summary>Whether the call is recorded by the global decode latency tracker</summary>
+    private: bool isTrackingLatency;
+    /// <summary>Time at which the decoding call acquired the lock</summary>
+    private: std::chrono::steady_clock::time_point startTime;
+    /// <summary>Time the decoding call spent waiting for the lock</summary>
+    private: std::chrono::steady_clock::duration lockWaitTime;
+    /// <summary>Number of exceptions in flight when the scope began</summary>
+    private: int exceptionCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_DECODERSTATISTICSCOLLECTOR_H
@@ -0,0 +1,224 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./EncoderCpuGovernor.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Length of audio in seconds over which the encoding cost is measured</summary>
+  const double MeasurementWindowSeconds = 0.5;
+
+  /// <summary>Weight of the newest window when smoothing the measured cost</summary>
+  const float SmoothingFactor = 0.5f;
+
+  /// <summary>Cost, relative to the budget, below which there is room to raise quality</summary>
+  /// <remarks>
+  ///   Kept well below 1.0 so that raising the complexity by one level, which costs
+  ///   roughly 10 to 20 percent more, doesn't immediately push the encoder over budget.
+  /// </remarks>
+  const float HeadroomRatio = 0.6f;
+
+  /// <summary>Cost, relative to the budget, above which two steps are given up at once</summary>
+  const float FarOverBudgetRatio = 1.5f;
+
+  /// <summary>Number of windows in a row with headroom before quality is raised</summary>
+  const std::size_t RaiseWindowCount = 4;
+
+  /// <summary>Factor by which the bitrate is lowered in each step</summary>
+  const float BitrateStepFactor = 0.85f;
+
+  /// <summary>Lowest bitrate relative to the configured one the governor goes to</summary>
+  const float MinimumBitrateRatio = 0.5f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  EncoderCpuGovernor::EncoderCpuGovernor(
+    const EncoderCpuBudget &budget,
+    std::size_t sampleRate,
+    std::size_t complexity,
+    float kilobitsPerSecond,
+    const std::vector<float> &frameDurations
+  ) :
+    budget(budget),
+    sampleRate(sampleRate),
+    configuredComplexity(std::min(complexity, MaximumComplexity)),
+    configuredKilobitsPerSecond(kilobitsPerSecond),
+    frameDurations(frameDurations),
+    complexity(configuredComplexity),
+    kilobitsPerSecond(kilobitsPerSecond),
+    frameDurationIndex(0),
+    windowEncodeTime(0),
+    windowFrameCount(0),
+    measuredCpuFraction(0.0f),
+    peakCpuFraction(0.0f),
+    hasMeasurement(false),
+    headroomWindowCount(0),
+    adjustmentCount(0) {
+    if(unlikely(!(budget.CpuFraction > 0.0f))) {
+      throw std::invalid_argument(u8"CPU budget must be a positive fraction");
+    }
+    if(unlikely(sampleRate == 0)) {
+      throw std::invalid_argument(u8"Sample rate must not be zero");
+    }
+    if(this->frameDurations.empty()) {
+      this->frameDurations.push_back(20.0f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool EncoderCpuGovernor::Record(std::chrono::nanoseconds encodeTime, std::size_t frameCount) {
+    this->windowEncodeTime += encodeTime;
+    this->windowFrameCount += frameCount;
+
+    double windowSeconds = (
+      static_cast<double>(this->windowFrameCount) / static_cast<double>(this->sampleRate)
+    );
+    if(windowSeconds < MeasurementWindowSeconds) {
+      return false;
+    }
+
+    float windowCpuFraction = static_cast<float>(
+      std::chrono::duration<double>(this->windowEncodeTime).count() / windowSeconds
+    );
+    this->windowEncodeTime = std::chrono::nanoseconds(0);
+    this->windowFrameCount = 0;
+
+    this->peakCpuFraction = std::max(this->peakCpuFraction, windowCpuFraction);
+    if(this->hasMeasurement) {
+      this->measuredCpuFraction = (
+        this->measuredCpuFraction * (1.0f - SmoothingFactor) +
+        windowCpuFraction * SmoothingFactor
+      );
+    } else {
+      this->measuredCpuFraction = windowCpuFraction;
+      this->hasMeasurement = true;
+    }
+
+    // Over budget, give something up right away. Raising quality again waits until
+    // there has been room for a while so that the settings don't flip back and forth.
+    bool isChanged = false;
+    if(this->measuredCpuFraction > this->budget.CpuFraction) {
+      this->headroomWindowCount = 0;
+      isChanged = lowerCost(
+        this->measuredCpuFraction > this->budget.CpuFraction * FarOverBudgetRatio
+      );
+    } else if(this->measuredCpuFraction < this->budget.CpuFraction * HeadroomRatio) {
+      ++this->headroomWindowCount;
+      if(this->headroomWindowCount >= RaiseWindowCount) {
+        this->headroomWindowCount = 0;
+        isChanged = raiseCost();
+      }
+    } else {
+      this->headroomWindowCount = 0;
+    }
+
+    // Measurements taken with the old settings say little about the new ones
+    if(isChanged) {
+      this->hasMeasurement = false;
+      ++this->adjustmentCount;
+    }
+
+    return isChanged;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  EncoderCpuMetrics EncoderCpuGovernor::GetMetrics() const {
+    EncoderCpuMetrics metrics;
+    metrics.Effort = (
+      static_cast<float>(this->complexity) / static_cast<float>(MaximumComplexity)
+    );
+    metrics.KilobitsPerSecond = this->kilobitsPerSecond;
+    metrics.FrameMilliseconds = this->frameDurations[this->frameDurationIndex];
+    metrics.MeasuredCpuFraction = this->measuredCpuFraction;
+    metrics.PeakCpuFraction = this->peakCpuFraction;
+    metrics.AdjustmentCount = this->adjustmentCount;
+    return metrics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool EncoderCpuGovernor::lowerCost(bool isFarOverBudget) {
+    if(this->complexity > 0) {
+      std::size_t stepCount = isFarOverBudget ? 2 : 1;
+      this->complexity -= std::min(this->complexity, stepCount);
+      return true;
+    }
+
+    if(this->budget.MayEnlargeFrames) {
+      if(this->frameDurationIndex + 1 < this->frameDurations.size()) {
+        ++this->frameDurationIndex;
+        return true;
+      }
+    }
+
+    if(this->budget.MayLowerBitrate && (this->configuredKilobitsPerSecond > 0.0f)) {
+      float minimumKilobitsPerSecond = this->configuredKilobitsPerSecond * MinimumBitrateRatio;
+      if(this->kilobitsPerSecond > minimumKilobitsPerSecond) {
+        this->kilobitsPerSecond = std::max(
+          this->kilobitsPerSecond * BitrateStepFactor, minimumKilobitsPerSecond
+        );
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool EncoderCpuGovernor::raiseCost() {
+    if(this->kilobitsPerSecond < this->configuredKilobitsPerSecond) {
+      this->kilobitsPerSecond = std::min(
+        this->kilobitsPerSecond / BitrateStepFactor, this->configuredKilobitsPerSecond
+      );
+      return true;
+    }
+
+    if(this->frameDurationIndex > 0) {
+      --this->frameDurationIndex;
+      return true;
+    }
+
+    if(this->complexity < this->configuredComplexity) {
+      ++this->complexity;
+      return true;
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
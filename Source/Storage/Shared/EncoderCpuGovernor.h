@@ -0,0 +1,139 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_ENCODERCPUGOVERNOR_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_ENCODERCPUGOVERNOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/EncoderCpuBudget.h"
+
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adjusts encoder settings to keep the encoding cost within a CPU budget</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The encoder reports how long each block took to encode. Once half a second of
+  ///     audio has been measured, the cost is smoothed and compared with the budget.
+  ///     Above budget, the governor gives up complexity first, then, if allowed, moves to
+  ///     longer frames and finally lowers the bitrate. When the cost has stayed well below
+  ///     the budget for a few windows, the settings are restored one step at a time in
+  ///     the opposite order.
+  ///   </para>
+  ///   <para>
+  ///     The governor only decides, it doesn't touch the codec. The encoder applies the
+  ///     new settings whenever <see cref="Record" /> reports a change.
+  ///   </para>
+  /// </remarks>
+  class EncoderCpuGovernor {
+
+    /// <summary>Highest complexity level the governor works with</summary>
+    public: static constexpr std::size_t MaximumComplexity = 10;
+
+    /// <summary>Initializes a new encoder CPU governor</summary>
+    /// <param name="budget">Budget the encoder should stay within</param>
+    /// <param name="sampleRate">Sample rate of the audio being encoded</param>
+    /// <param name="complexity">Complexity the encoder was configured with, 0 to 10</param>
+    /// <param name="kilobitsPerSecond">Configured bitrate, 0 if left to the codec</param>
+    /// <param name="frameDurations">
+    ///   Frame durations in milliseconds the encoder supports, shortest (default) first
+    /// </param>
+    public: EncoderCpuGovernor(
+      const EncoderCpuBudget &budget,
+      std::size_t sampleRate,
+      std::size_t complexity,
+      float kilobitsPerSecond,
+      const std::vector<float> &frameDurations
+    );
+
+    /// <summary>Records the time it took to encode a block of audio</summary>
+    /// <param name="encodeTime">Time spent encoding the block</param>
+    /// <param name="frameCount">Number of frames in the block</param>
+    /// <returns>True if the encoder's settings should be changed</returns>
+    public: bool Record(std::chrono::nanoseconds encodeTime, std::size_t frameCount);
+
+    /// <summary>Returns the complexity the encoder should use</summary>
+    /// <returns>The complexity level from 0 to 10</returns>
+    public: std::size_t GetComplexity() const { return this->complexity; }
+
+    /// <summary>Returns the bitrate the encoder should target</summary>
+    /// <returns>The bitrate in kilobits per second, 0 if left to the codec</returns>
+    public: float GetKilobitsPerSecond() const { return this->kilobitsPerSecond; }
+
+    /// <summary>Returns the index of the frame duration the encoder should use</summary>
+    /// <returns>The index in the list of frame durations given to the constructor</returns>
+    public: std::size_t GetFrameDurationIndex() const { return this->frameDurationIndex; }
+
+    /// <summary>Reports the current settings and the measured cost</summary>
+    /// <returns>The governor's current state</returns>
+    public: EncoderCpuMetrics GetMetrics() const;
+
+    /// <summary>Makes encoding cheaper by one step</summary>
+    /// <param name="isFarOverBudget">Whether the cost exceeds the budget by a lot</param>
+    /// <returns>True if a setting was changed, false if nothing was left to give</returns>
+    private: bool lowerCost(bool isFarOverBudget);
+
+    /// <summary>Restores one step of quality given up earlier</summary>
+    /// <returns>True if a setting was changed, false if all are at their configured level</returns>
+    private: bool raiseCost();
+
+    /// <summary>Budget the encoder should stay within</summary>
+    private: EncoderCpuBudget budget;
+    /// <summary>Sample rate of the audio being encoded</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Complexity the encoder was configured with</summary>
+    private: std::size_t configuredComplexity;
+    /// <summary>Bitrate the encoder was configured with, 0 if left to the codec</summary>
+    private: float configuredKilobitsPerSecond;
+    /// <summary>Frame durations the encoder supports in milliseconds</summary>
+    private: std::vector<float> frameDurations;
+    /// <summary>Complexity the encoder should currently use</summary>
+    private: std::size_t complexity;
+    /// <summary>Bitrate the encoder should currently target</summary>
+    private: float kilobitsPerSecond;
+    /// <summary>Index of the frame duration the encoder should currently use</summary>
+    private: std::size_t frameDurationIndex;
+    /// <summary>Time spent encoding in the current measurement window</summary>
+    private: std::chrono::nanoseconds windowEncodeTime;
+    /// <summary>Number of frames encoded in the current measurement window</summary>
+    private: std::size_t windowFrameCount;
+    /// <summary>Smoothed fraction of a CPU core used per second of audio</summary>
+    private: float measuredCpuFraction;
+    /// <summary>Highest fraction measured over a single window</summary>
+    private: float peakCpuFraction;
+    /// <summary>Whether the smoothed fraction holds a measurement of the current settings</summary>
+    private: bool hasMeasurement;
+    /// <summary>Number of windows in a row that had plenty of headroom</summary>
+    private: std::size_t headroomWindowCount;
+    /// <summary>Number of times the settings were changed</summary>
+    private: std::uint64_t adjustmentCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_ENCODERCPUGOVERNOR_H
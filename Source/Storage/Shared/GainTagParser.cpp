@@ -0,0 +1,249 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./GainTagParser.h"
+
+#include <algorithm> // for std::min()
+#include <charconv> // for std::from_chars()
+#include <cmath> // for std::log10()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Difference between the R128 and ReplayGain 2.0 reference loudness</summary>
+  const float R128ToReplayGainDecibels = 5.0f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts an ASCII character to upper case</summary>
+  /// <param name="character">Character that will be converted</param>
+  /// <returns>The upper case variant of the character</returns>
+  char toUpperCase(char character) {
+    if((character >= u8'a') && (character <= u8'z')) {
+      character -= (u8'a' - u8'A');
+    }
+    return character;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares a tag name against an upper case name, ignoring case</summary>
+  /// <param name="name">Tag name as it appears in the comment</param>
+  /// <param name="upperCaseName">Upper case name the tag name will be compared to</param>
+  /// <returns>True if both names are the same when case is ignored</returns>
+  bool isSameTagName(std::string_view name, std::string_view upperCaseName) {
+    if(name.length() != upperCaseName.length()) {
+      return false;
+    }
+
+    // Vorbis comment field names are restricted to ASCII, so this is all there is to it
+    for(std::size_t index = 0; index < name.length(); ++index) {
+      if(toUpperCase(name[index]) != upperCaseName[index]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Removes spaces and tabs from both ends of a tag value</summary>
+  /// <param name="value">Value that will be trimmed</param>
+  /// <returns>The value without leading and trailing whitespace</returns>
+  std::string_view trimValue(std::string_view value) {
+    while(!value.empty() && ((value.front() == u8' ') || (value.front() == u8'\t'))) {
+      value.remove_prefix(1);
+    }
+    while(!value.empty() && ((value.back() == u8' ') || (value.back() == u8'\t'))) {
+      value.remove_suffix(1);
+    }
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a ReplayGain value such as '-6.48 dB' or '0.988547'</summary>
+  /// <param name="value">Value that will be parsed</param>
+  /// <returns>The parsed number or nothing if the value is not a decimal number</returns>
+  /// <remarks>
+  ///   Parsed by hand because std::strtof() depends on the locale's decimal separator
+  ///   and std::from_chars() for floating point is missing from older standard libraries.
+  /// </remarks>
+  std::optional<float> parseDecimal(std::string_view value) {
+    value = trimValue(value);
+
+    // Strip the unit, ReplayGain taggers write it with varying case
+    if(value.length() >= 2) {
+      std::string_view unit = value.substr(value.length() - 2);
+      if((toUpperCase(unit[0]) == u8'D') && (toUpperCase(unit[1]) == u8'B')) {
+        value = trimValue(value.substr(0, value.length() - 2));
+      }
+    }
+
+    std::size_t index = 0;
+    bool isNegative = false;
+    if((index < value.length()) && ((value[index] == u8'+') || (value[index] == u8'-'))) {
+      isNegative = (value[index] == u8'-');
+      ++index;
+    }
+
+    double number = 0.0;
+    double fractionScale = 0.0;
+    std::size_t digitCount = 0;
+    for(; index < value.length(); ++index) {
+      char character = value[index];
+      if((character >= u8'0') && (character <= u8'9')) {
+        if(fractionScale == 0.0) {
+          number = number * 10.0 + static_cast<double>(character - u8'0');
+        } else {
+          number += static_cast<double>(character - u8'0') * fractionScale;
+          fractionScale /= 10.0;
+        }
+        ++digitCount;
+      } else if((character == u8'.') && (fractionScale == 0.0)) {
+        fractionScale = 0.1;
+      } else {
+        return std::optional<float>();
+      }
+    }
+    if(digitCount == 0) {
+      return std::optional<float>();
+    }
+
+    return static_cast<float>(isNegative ? -number : number);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses an R128 gain, an integer in 1/256 dB relative to -23 LUFS</summary>
+  /// <param name="value">Value that will be parsed</param>
+  /// <returns>The gain in dB relative to -18 LUFS or nothing if the value is invalid</returns>
+  std::optional<float> parseR128Gain(std::string_view value) {
+    value = trimValue(value);
+    if(!value.empty() && (value.front() == u8'+')) {
+      value.remove_prefix(1);
+    }
+
+    int gain;
+    std::from_chars_result result = std::from_chars(
+      value.data(), value.data() + value.length(), gain
+    );
+    if((result.ec != std::errc()) || (result.ptr != value.data() + value.length())) {
+      return std::optional<float>();
+    }
+    if((gain < -32768) || (gain > 32767)) {
+      return std::optional<float>();
+    }
+
+    return static_cast<float>(gain) / 256.0f + R128ToReplayGainDecibels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  GainTagParser::GainTagParser() :
+    replayGain(),
+    r128TrackGain(),
+    r128AlbumGain() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void GainTagParser::ProcessComment(std::string_view comment) noexcept {
+    std::string_view::size_type assignmentIndex = comment.find(u8'=');
+    if(assignmentIndex == std::string_view::npos) {
+      return;
+    }
+
+    std::string_view name = comment.substr(0, assignmentIndex);
+    std::string_view value = comment.substr(assignmentIndex + 1);
+    if(isSameTagName(name, std::string_view(u8"REPLAYGAIN_TRACK_GAIN", 21))) {
+      this->replayGain.TrackGain = parseDecimal(value);
+    } else if(isSameTagName(name, std::string_view(u8"REPLAYGAIN_TRACK_PEAK", 21))) {
+      this->replayGain.TrackPeak = parseDecimal(value);
+    } else if(isSameTagName(name, std::string_view(u8"REPLAYGAIN_ALBUM_GAIN", 21))) {
+      this->replayGain.AlbumGain = parseDecimal(value);
+    } else if(isSameTagName(name, std::string_view(u8"REPLAYGAIN_ALBUM_PEAK", 21))) {
+      this->replayGain.AlbumPeak = parseDecimal(value);
+    } else if(isSameTagName(name, std::string_view(u8"R128_TRACK_GAIN", 15))) {
+      this->r128TrackGain = parseR128Gain(value);
+    } else if(isSameTagName(name, std::string_view(u8"R128_ALBUM_GAIN", 15))) {
+      this->r128AlbumGain = parseR128Gain(value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<ReplayGainInfo> GainTagParser::GetReplayGain() const {
+    ReplayGainInfo result = this->replayGain;
+    if(this->r128TrackGain.has_value()) {
+      result.TrackGain = this->r128TrackGain;
+    }
+    if(this->r128AlbumGain.has_value()) {
+      result.AlbumGain = this->r128AlbumGain;
+    }
+
+    bool hasAnyGain = result.TrackGain.has_value() || result.AlbumGain.has_value();
+    if(!hasAnyGain) {
+      return std::optional<ReplayGainInfo>();
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float GainTagParser::GetGainDecibels(
+    const std::optional<ReplayGainInfo> &replayGain, ReplayGainMode mode
+  ) {
+    if(!replayGain.has_value() || (mode == ReplayGainMode::Off)) {
+      return 0.0f;
+    }
+
+    std::optional<float> gain = replayGain->TrackGain;
+    std::optional<float> peak = replayGain->TrackPeak;
+    if((mode == ReplayGainMode::Album) && replayGain->AlbumGain.has_value()) {
+      gain = replayGain->AlbumGain;
+      peak = replayGain->AlbumPeak;
+    }
+    if(!gain.has_value()) {
+      return 0.0f;
+    }
+
+    // Don't amplify the loudest sample beyond full scale
+    if(peak.has_value() && (peak.value() > 0.0f)) {
+      float headroom = -20.0f * std::log10(peak.value());
+      return std::min(gain.value(), headroom);
+    }
+
+    return gain.value();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
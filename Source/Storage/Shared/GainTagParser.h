@@ -0,0 +1,83 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_GAINTAGPARSER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_GAINTAGPARSER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/TrackInfo.h" // for ReplayGainInfo
+#include "Nuclex/Audio/Storage/ReplayGainMode.h"
+
+#include <optional> // for std::optional
+#include <string_view> // for std::string_view
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects loudness normalization gains from the Vorbis comments of a file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     ReplayGain taggers write REPLAYGAIN_TRACK_GAIN and REPLAYGAIN_ALBUM_GAIN as
+  ///     decimal numbers followed by 'dB' plus the matching peaks. Opus files use
+  ///     R128_TRACK_GAIN and R128_ALBUM_GAIN instead, which are integers in 1/256 dB
+  ///     relative to -23 LUFS. If a file has both, the R128 gains win, since they are
+  ///     the only ones defined for Opus and relative to the output with the header
+  ///     gain applied.
+  ///   </para>
+  ///   <para>
+  ///     Feed all comments of a file to the parser, then ask it for the gains.
+  ///     Tags with values that aren't plain numbers are ignored.
+  ///   </para>
+  /// </remarks>
+  class GainTagParser {
+
+    /// <summary>Initializes a new gain tag parser that hasn't seen any tags yet</summary>
+    public: GainTagParser();
+
+    /// <summary>Checks a single Vorbis comment for a gain tag</summary>
+    /// <param name="comment">Comment in the form 'key=value'</param>
+    public: void ProcessComment(std::string_view comment) noexcept;
+
+    /// <summary>Returns the gains collected from the tags that have been seen</summary>
+    /// <returns>The gains or nothing if there were no valid gain tags</returns>
+    public: std::optional<ReplayGainInfo> GetReplayGain() const;
+
+    /// <summary>Picks the gain a decoder should apply in the specified mode</summary>
+    /// <param name="replayGain">Gains stored in the file, if any</param>
+    /// <param name="mode">Which of the gains should be applied</param>
+    /// <returns>The gain in decibels, limited so the stored peak doesn't clip</returns>
+    public: static float GetGainDecibels(
+      const std::optional<ReplayGainInfo> &replayGain, ReplayGainMode mode
+    );
+
+    /// <summary>Gains and peaks from the REPLAYGAIN_* tags</summary>
+    private: ReplayGainInfo replayGain;
+    /// <summary>Track gain from the R128_TRACK_GAIN tag, converted to ReplayGain</summary>
+    private: std::optional<float> r128TrackGain;
+    /// <summary>Album gain from the R128_ALBUM_GAIN tag, converted to ReplayGain</summary>
+    private: std::optional<float> r128AlbumGain;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_GAINTAGPARSER_H
@@ -0,0 +1,81 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./IntegrityVerifier.h"
+
+#include <exception> // for std::exception
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  IntegrityVerifier::IntegrityVerifier(VerificationPolicy policy, const CheckFunction &check) :
+    policy(policy),
+    check(check),
+    cancellation(),
+    result(VerificationResult::Pending),
+    backgroundThread() {
+
+    switch(policy) {
+      case VerificationPolicy::Off: {
+        this->result.store(VerificationResult::NotChecked, std::memory_order_release);
+        break;
+      }
+      case VerificationPolicy::Immediate: {
+        runCheck();
+        break;
+      }
+      case VerificationPolicy::Background: {
+        this->backgroundThread = std::thread(&IntegrityVerifier::runCheck, this);
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  IntegrityVerifier::~IntegrityVerifier() {
+    if(this->backgroundThread.joinable()) {
+      this->cancellation.Cancel();
+      this->backgroundThread.join();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void IntegrityVerifier::runCheck() {
+    VerificationResult checkResult;
+    try {
+      checkResult = this->check(this->cancellation);
+    }
+    catch(const std::exception &) {
+      // A file that can't be read to the end can't be trusted either. In the background,
+      // there's nobody to deliver the exception to, so both cases end up as a failure.
+      checkResult = VerificationResult::Failed;
+    }
+
+    this->result.store(checkResult, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,90 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_INTEGRITYVERIFIER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_INTEGRITYVERIFIER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/IntegrityVerification.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include <atomic> // for std::atomic
+#include <functional> // for std::function
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Verifies the checksums of a file directly or in the background</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Decoders create one of these when a verification policy other than
+  ///     <see cref="VerificationPolicy::Off" /> is set and share it with their clones.
+  ///     The check itself is codec-specific and provided as a function that should
+  ///     poll the cancellation token every now and then.
+  ///   </para>
+  ///   <para>
+  ///     Destroying the verifier cancels a background check and waits for it to end.
+  ///   </para>
+  /// </remarks>
+  class IntegrityVerifier {
+
+    /// <summary>Function that verifies the checksums of a file</summary>
+    public: typedef std::function<VerificationResult(const CancellationToken &)> CheckFunction;
+
+    /// <summary>Initializes a new integrity verifier and starts its check</summary>
+    /// <param name="policy">Whether to verify directly or in a background thread</param>
+    /// <param name="check">Function that will verify the checksums of the file</param>
+    public: IntegrityVerifier(VerificationPolicy policy, const CheckFunction &check);
+
+    /// <summary>Cancels the background verification if it is still running</summary>
+    public: ~IntegrityVerifier();
+
+    /// <summary>Returns the policy the verifier was created with</summary>
+    /// <returns>The verification policy of the verifier</returns>
+    public: VerificationPolicy GetPolicy() const { return this->policy; }
+
+    /// <summary>Reports the current result of the verification</summary>
+    /// <returns>The result of the verification or pending if it is still running</returns>
+    public: VerificationResult GetResult() const {
+      return this->result.load(std::memory_order_acquire);
+    }
+
+    /// <summary>Runs the check and stores its result</summary>
+    private: void runCheck();
+
+    /// <summary>Whether the verifier is checking directly or in the background</summary>
+    private: VerificationPolicy policy;
+    /// <summary>Codec-specific function that verifies the file</summary>
+    private: CheckFunction check;
+    /// <summary>Used to stop the background check when the verifier is destroyed</summary>
+    private: CancellationToken cancellation;
+    /// <summary>Result of the verification, pending until the check has completed</summary>
+    private: std::atomic<VerificationResult> result;
+    /// <summary>Thread running the check if it is done in the background</summary>
+    private: std::thread backgroundThread;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_INTEGRITYVERIFIER_H
@@ -0,0 +1,119 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./LatencyRecorder.h"
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyRecorder::LatencyRecorder() :
+    callCount(0),
+    totalNanoseconds(0),
+    longestNanoseconds(0) {
+    for(std::size_t index = 0; index < LatencyHistogram::BucketCount; ++index) {
+      this->bucketCounts[index].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LatencyRecorder::Record(std::chrono::nanoseconds latency) {
+    if(latency.count() < 0) {
+      latency = std::chrono::nanoseconds(0);
+    }
+
+    std::uint64_t nanoseconds = static_cast<std::uint64_t>(latency.count());
+    this->bucketCounts[LatencyHistogram::GetBucketIndex(latency)].fetch_add(
+      1, std::memory_order_relaxed
+    );
+    this->callCount.fetch_add(1, std::memory_order_relaxed);
+    this->totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    std::uint64_t longest = this->longestNanoseconds.load(std::memory_order_relaxed);
+    while(longest < nanoseconds) {
+      bool exchanged = this->longestNanoseconds.compare_exchange_weak(
+        longest, nanoseconds, std::memory_order_relaxed
+      );
+      if(exchanged) {
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram LatencyRecorder::TakeSnapshot(bool reset /* = false */) {
+    LatencyHistogram histogram = LatencyHistogram();
+    if(reset) {
+      histogram.CallCount = this->callCount.exchange(0, std::memory_order_relaxed);
+      histogram.TotalTime = std::chrono::nanoseconds(
+        this->totalNanoseconds.exchange(0, std::memory_order_relaxed)
+      );
+      histogram.LongestTime = std::chrono::nanoseconds(
+        this->longestNanoseconds.exchange(0, std::memory_order_relaxed)
+      );
+    } else {
+      histogram.CallCount = this->callCount.load(std::memory_order_relaxed);
+      histogram.TotalTime = std::chrono::nanoseconds(
+        this->totalNanoseconds.load(std::memory_order_relaxed)
+      );
+      histogram.LongestTime = std::chrono::nanoseconds(
+        this->longestNanoseconds.load(std::memory_order_relaxed)
+      );
+    }
+
+    // Leave the buckets out entirely when nothing was recorded so idle snapshots are cheap
+    if(histogram.CallCount == 0) {
+      return histogram;
+    }
+
+    histogram.BucketCounts.resize(LatencyHistogram::BucketCount);
+    for(std::size_t index = 0; index < LatencyHistogram::BucketCount; ++index) {
+      if(reset) {
+        histogram.BucketCounts[index] = this->bucketCounts[index].exchange(
+          0, std::memory_order_relaxed
+        );
+      } else {
+        histogram.BucketCounts[index] = this->bucketCounts[index].load(
+          std::memory_order_relaxed
+        );
+      }
+    }
+
+    return histogram;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LatencyRecorder::Reset() {
+    this->callCount.store(0, std::memory_order_relaxed);
+    this->totalNanoseconds.store(0, std::memory_order_relaxed);
+    this->longestNanoseconds.store(0, std::memory_order_relaxed);
+    for(std::size_t index = 0; index < LatencyHistogram::BucketCount; ++index) {
+      this->bucketCounts[index].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
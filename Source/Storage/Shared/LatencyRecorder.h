@@ -0,0 +1,77 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_LATENCYRECORDER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_LATENCYRECORDER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/LatencyHistogram.h"
+
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::nanoseconds
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts decoding times into histogram buckets without taking locks</summary>
+  /// <remarks>
+  ///   Recording is a handful of relaxed atomic increments, cheap enough to do on the
+  ///   audio thread for every decoding call. Taking a snapshot copies the buckets and
+  ///   can reset them at the same time, so a monitor can poll the recorder once per
+  ///   second to get the distribution of the last second.
+  /// </remarks>
+  class LatencyRecorder {
+
+    /// <summary>Initializes a new latency recorder with all buckets empty</summary>
+    public: LatencyRecorder();
+
+    /// <summary>Counts the wall time of a decoding call</summary>
+    /// <param name="latency">Time the decoding call took</param>
+    public: void Record(std::chrono::nanoseconds latency);
+
+    /// <summary>Copies the recorded times into a histogram</summary>
+    /// <param name="reset">Whether to empty the buckets while copying them</param>
+    /// <returns>A histogram of the times recorded so far</returns>
+    /// <remarks>
+    ///   Buckets are reset one by one, so a call recorded during the snapshot ends up
+    ///   either in this snapshot or in the next, but is never lost.
+    /// </remarks>
+    public: LatencyHistogram TakeSnapshot(bool reset = false);
+
+    /// <summary>Empties all buckets</summary>
+    public: void Reset();
+
+    /// <summary>Number of calls counted in each bucket</summary>
+    private: std::atomic<std::uint64_t> bucketCounts[LatencyHistogram::BucketCount];
+    /// <summary>Number of calls recorded</summary>
+    private: std::atomic<std::uint64_t> callCount;
+    /// <summary>Combined time of all recorded calls in nanoseconds</summary>
+    private: std::atomic<std::uint64_t> totalNanoseconds;
+    /// <summary>Time of the slowest recorded call in nanoseconds</summary>
+    private: std::atomic<std::uint64_t> longestNanoseconds;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_LATENCYRECORDER_H
@@ -0,0 +1,140 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./LoopTagParser.h"
+
+#include <algorithm> // for std::min()
+#include <charconv> // for std::from_chars()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares a tag name against an upper case name, ignoring case</summary>
+  /// <param name="name">Tag name as it appears in the comment</param>
+  /// <param name="upperCaseName">Upper case name the tag name will be compared to</param>
+  /// <returns>True if both names are the same when case is ignored</returns>
+  bool isSameTagName(std::string_view name, std::string_view upperCaseName) {
+    if(name.length() != upperCaseName.length()) {
+      return false;
+    }
+
+    // Vorbis comment field names are restricted to ASCII, so this is all there is to it
+    for(std::size_t index = 0; index < name.length(); ++index) {
+      char character = name[index];
+      if((character >= u8'a') && (character <= u8'z')) {
+        character -= (u8'a' - u8'A');
+      }
+      if(character != upperCaseName[index]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses the value of a loop tag as a frame index</summary>
+  /// <param name="value">Value that will be parsed</param>
+  /// <returns>The frame index or nothing if the value is not a plain number</returns>
+  std::optional<std::uint64_t> parseFrameIndex(std::string_view value) {
+    while(!value.empty() && ((value.front() == u8' ') || (value.front() == u8'\t'))) {
+      value.remove_prefix(1);
+    }
+    while(!value.empty() && ((value.back() == u8' ') || (value.back() == u8'\t'))) {
+      value.remove_suffix(1);
+    }
+
+    std::uint64_t frameIndex;
+    std::from_chars_result result = std::from_chars(
+      value.data(), value.data() + value.length(), frameIndex
+    );
+    if((result.ec != std::errc()) || (result.ptr != value.data() + value.length())) {
+      return std::optional<std::uint64_t>();
+    }
+
+    return frameIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LoopTagParser::LoopTagParser() :
+    startFrame(),
+    length(),
+    endFrame() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LoopTagParser::ProcessComment(std::string_view comment) noexcept {
+    std::string_view::size_type assignmentIndex = comment.find(u8'=');
+    if(assignmentIndex == std::string_view::npos) {
+      return;
+    }
+
+    std::string_view name = comment.substr(0, assignmentIndex);
+    std::string_view value = comment.substr(assignmentIndex + 1);
+    if(isSameTagName(name, std::string_view(u8"LOOPSTART", 9))) {
+      this->startFrame = parseFrameIndex(value);
+    } else if(isSameTagName(name, std::string_view(u8"LOOPLENGTH", 10))) {
+      this->length = parseFrameIndex(value);
+    } else if(isSameTagName(name, std::string_view(u8"LOOPEND", 7))) {
+      this->endFrame = parseFrameIndex(value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<LoopRegion> LoopTagParser::GetLoop(std::uint64_t frameCount) const {
+    if(!this->startFrame.has_value() || (this->startFrame.value() >= frameCount)) {
+      return std::optional<LoopRegion>();
+    }
+
+    LoopRegion loop;
+    loop.StartFrame = this->startFrame.value();
+    if(this->length.has_value()) {
+      loop.EndFrame = loop.StartFrame + std::min(
+        this->length.value(), frameCount - loop.StartFrame
+      );
+    } else if(this->endFrame.has_value()) {
+      loop.EndFrame = std::min(this->endFrame.value(), frameCount);
+    } else {
+      loop.EndFrame = frameCount;
+    }
+    loop.PlayCount = 0;
+
+    if(loop.EndFrame <= loop.StartFrame) {
+      return std::optional<LoopRegion>();
+    }
+
+    return loop;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
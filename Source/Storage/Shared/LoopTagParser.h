@@ -0,0 +1,78 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_LOOPTAGPARSER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_LOOPTAGPARSER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/TrackInfo.h" // for LoopRegion
+
+#include <cstdint> // for std::uint64_t
+#include <optional> // for std::optional
+#include <string_view> // for std::string_view
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects loop points from the Vorbis comments of a file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     There is no standard for loop points in Vorbis comments, but many games and
+  ///     game engines (RPG Maker, Unity, Ren'Py and others) write a LOOPSTART tag with
+  ///     the first frame of the loop plus either LOOPLENGTH or LOOPEND. The same tags
+  ///     are used in Ogg Vorbis, Opus and FLAC files.
+  ///   </para>
+  ///   <para>
+  ///     Feed all comments of a file to the parser, then ask it for the loop region.
+  ///     Tags with values that aren't plain numbers are ignored.
+  ///   </para>
+  /// </remarks>
+  class LoopTagParser {
+
+    /// <summary>Initializes a new loop tag parser that hasn't seen any tags yet</summary>
+    public: LoopTagParser();
+
+    /// <summary>Checks a single Vorbis comment for a loop tag</summary>
+    /// <param name="comment">Comment in the form 'key=value'</param>
+    public: void ProcessComment(std::string_view comment) noexcept;
+
+    /// <summary>Builds the loop region from the tags that have been seen</summary>
+    /// <param name="frameCount">Number of frames in the audio track</param>
+    /// <returns>The loop region or nothing if there were no valid loop tags</returns>
+    /// <remarks>
+    ///   A loop without an end or length repeats up to the end of the track. Loops
+    ///   reaching past the end of the track are cut off there.
+    /// </remarks>
+    public: std::optional<LoopRegion> GetLoop(std::uint64_t frameCount) const;
+
+    /// <summary>First frame of the loop, if a LOOPSTART tag was seen</summary>
+    private: std::optional<std::uint64_t> startFrame;
+    /// <summary>Length of the loop, if a LOOPLENGTH tag was seen</summary>
+    private: std::optional<std::uint64_t> length;
+    /// <summary>Frame after the loop, if a LOOPEND tag was seen</summary>
+    private: std::optional<std::uint64_t> endFrame;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_LOOPTAGPARSER_H
@@ -0,0 +1,182 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OggLinkScanner.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../EndianReader.h"
+#include "../SubRangeFile.h"
+
+#include <algorithm> // for std::min(), std::find()
+#include <cstring> // for std::memcmp()
+#include <optional> // for std::optional
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Size of an Ogg page header with the largest possible segment table</summary>
+  const std::size_t MaximumPageHeaderSize = PageHeaderSize + 255;
+
+  /// <summary>Header type flag indicating the first page of a logical stream</summary>
+  const std::uint8_t BeginningOfStreamFlag = 0x02;
+
+  /// <summary>Header type flag indicating the last page of a logical stream</summary>
+  const std::uint8_t EndOfStreamFlag = 0x04;
+
+  /// <summary>Granule position used by pages on which no packet ends</summary>
+  const std::uint64_t NoGranulePosition = std::uint64_t(-1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<OggLinkScanner::Link> OggLinkScanner::ScanLinks(const VirtualFile &file) {
+    std::vector<Link> links;
+
+    std::uint64_t fileSize = file.GetSize();
+    std::uint64_t offset = 0;
+
+    // Each link starts with the beginning-of-stream pages of all its logical streams,
+    // which must all come before any other page. The link ends when every one of these
+    // logical streams has seen its end-of-stream page.
+    std::optional<Link> currentLink;
+    std::vector<std::uint32_t> openSerialNumbers;
+    bool isInBeginningOfStreamGroup = false;
+
+    std::byte header[MaximumPageHeaderSize];
+    for(;;) {
+      std::uint64_t remainingByteCount = fileSize - offset;
+      if(remainingByteCount < PageHeaderSize) {
+        break; // End of file or trailing garbage
+      }
+
+      // Read the page header along with as much of the segment table as could possibly
+      // exist. This gives us the whole header in a single read in nearly all cases.
+      std::size_t headerLength = static_cast<std::size_t>(
+        std::min<std::uint64_t>(remainingByteCount, MaximumPageHeaderSize)
+      );
+      file.ReadAt(offset, headerLength, header);
+      if(std::memcmp(header, "OggS", 4) != 0) {
+        break; // Lost sync with the page structure, stop with what we have
+      }
+
+      std::size_t segmentCount = static_cast<std::size_t>(header[26]);
+      if(PageHeaderSize + segmentCount > headerLength) {
+        break; // Truncated page header
+      }
+
+      std::uint64_t pageLength = PageHeaderSize + segmentCount;
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        pageLength += static_cast<std::uint64_t>(header[PageHeaderSize + index]);
+      }
+      if(pageLength > remainingByteCount) {
+        break; // Truncated page body
+      }
+
+      std::uint8_t headerType = LittleEndianReader::ReadUInt8(header + 5);
+      std::uint64_t granulePosition = LittleEndianReader::ReadUInt64(header + 6);
+      std::uint32_t serialNumber = LittleEndianReader::ReadUInt32(header + 14);
+      bool isBeginningOfStream = ((headerType & BeginningOfStreamFlag) != 0);
+
+      // A beginning-of-stream page after the link's header group means a new link
+      // begins, even if an encoder forgot to flag the end of the previous link's streams.
+      if(currentLink.has_value() && isBeginningOfStream && !isInBeginningOfStreamGroup) {
+        currentLink.value().Length = offset - currentLink.value().StartOffset;
+        links.push_back(currentLink.value());
+        currentLink.reset();
+        openSerialNumbers.clear();
+      }
+
+      if(!currentLink.has_value()) {
+        currentLink = Link { offset, 0, serialNumber, 0 };
+        isInBeginningOfStreamGroup = true;
+      }
+
+      if(isBeginningOfStream) {
+        openSerialNumbers.push_back(serialNumber);
+      } else {
+        isInBeginningOfStreamGroup = false;
+      }
+
+      bool isFirstStream = (serialNumber == currentLink.value().SerialNumber);
+      if(isFirstStream && (granulePosition != NoGranulePosition)) {
+        currentLink.value().LastGranulePosition = granulePosition;
+      }
+
+      offset += pageLength;
+
+      if((headerType & EndOfStreamFlag) != 0) {
+        std::vector<std::uint32_t>::iterator openStream = std::find(
+          openSerialNumbers.begin(), openSerialNumbers.end(), serialNumber
+        );
+        if(openStream != openSerialNumbers.end()) {
+          openSerialNumbers.erase(openStream);
+        }
+        if(openSerialNumbers.empty()) {
+          currentLink.value().Length = offset - currentLink.value().StartOffset;
+          links.push_back(currentLink.value());
+          currentLink.reset();
+        }
+      }
+    } // for each page
+
+    // If the file ended without the last link being closed, it still extends up to
+    // the last complete page so whatever audio data is there can be decoded.
+    if(currentLink.has_value()) {
+      currentLink.value().Length = offset - currentLink.value().StartOffset;
+      links.push_back(currentLink.value());
+    }
+
+    return links;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::shared_ptr<const VirtualFile>> OggLinkScanner::OpenLinks(
+    const std::shared_ptr<const VirtualFile> &file
+  ) {
+    std::vector<Link> links = ScanLinks(*file);
+    if(links.size() < 2) {
+      return std::vector<std::shared_ptr<const VirtualFile>> { file };
+    }
+
+    std::vector<std::shared_ptr<const VirtualFile>> linkFiles;
+    linkFiles.reserve(links.size());
+    for(const Link &link : links) {
+      linkFiles.push_back(std::make_shared<SubRangeFile>(file, link.StartOffset, link.Length));
+    }
+
+    return linkFiles;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_OGGLINKSCANNER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_OGGLINKSCANNER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstdint> // for std::uint64_t, std::uint32_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the links in a chained Ogg stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Ogg streams can be chained by simply appending one complete Ogg stream to another,
+  ///     which is how internet radio recordings and playlists often are stored. Each of
+  ///     these links has its own headers and may use a different channel count, sample
+  ///     rate or even codec than the links before it.
+  ///   </para>
+  ///   <para>
+  ///     The scanner walks over the Ogg page headers without looking at the packets.
+  ///     Because each link is a complete Ogg stream, it can be exposed as a file of its own
+  ///     and opened by the existing readers and decoders as if it was a standalone file.
+  ///   </para>
+  /// </remarks>
+  class OggLinkScanner {
+
+    /// <summary>Range of an Ogg file that holds one link of a chained stream</summary>
+    public: struct Link {
+
+      /// <summary>Offset of the link's first page in the file</summary>
+      public: std::uint64_t StartOffset;
+      /// <summary>Length of the link in bytes, including all its pages</summary>
+      public: std::uint64_t Length;
+      /// <summary>Serial number of the link's first logical stream</summary>
+      public: std::uint32_t SerialNumber;
+      /// <summary>Last granule position recorded for the link's first logical stream</summary>
+      public: std::uint64_t LastGranulePosition;
+
+    };
+
+    /// <summary>Locates all links in an Ogg file</summary>
+    /// <param name="file">Ogg file that will be scanned</param>
+    /// <returns>The links in the order in which they appear in the file</returns>
+    /// <remarks>
+    ///   Trailing garbage or a truncated final page end the scan. Everything up to that
+    ///   point is still reported, with the last link ending where the valid pages end.
+    /// </remarks>
+    public: static std::vector<Link> ScanLinks(const VirtualFile &file);
+
+    /// <summary>Exposes each link in an Ogg file as a standalone file</summary>
+    /// <param name="file">Ogg file whose links will be exposed</param>
+    /// <returns>One file per link, in the order in which they appear in the file</returns>
+    /// <remarks>
+    ///   If the file only has a single link, the file itself is returned so that
+    ///   ordinary Ogg files are read exactly as before.
+    /// </remarks>
+    public: static std::vector<std::shared_ptr<const VirtualFile>> OpenLinks(
+      const std::shared_ptr<const VirtualFile> &file
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_OGGLINKSCANNER_H
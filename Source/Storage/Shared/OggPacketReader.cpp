@@ -0,0 +1,201 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OggPacketReader.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../EndianReader.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Size of an Ogg page header with the largest possible segment table</summary>
+  const std::size_t MaximumPageHeaderSize = PageHeaderSize + 255;
+
+  /// <summary>Header type flag indicating a page that continues the previous packet</summary>
+  const std::uint8_t ContinuedPacketFlag = 0x01;
+
+  /// <summary>Header type flag indicating the last page of a logical stream</summary>
+  const std::uint8_t EndOfStreamFlag = 0x04;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OggPacketReader::OggPacketReader(
+    const VirtualFile &file, std::uint64_t startOffset /* = 0 */
+  ) :
+    file(file),
+    offset(startOffset),
+    serialNumber(0),
+    hasSerialNumber(false),
+    isStreamFinished(false),
+    segments(),
+    body(),
+    segmentIndex(0),
+    bodyOffset(0),
+    lastPacketSegmentIndex(0),
+    pageGranulePosition(NoGranulePosition),
+    isContinuedPage(false),
+    isEndOfStreamPage(false),
+    partialPacket() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OggPacketReader::ReadPacket(Packet &packet) {
+    for(;;) {
+      if(this->segmentIndex >= this->segments.size()) {
+        if(!readPage()) {
+          return false; // A packet left unfinished by a truncated stream is dropped
+        }
+
+        // If the page doesn't continue a packet but we were still assembling one,
+        // a page has gone missing. The incomplete packet is useless, so drop it.
+        if(!this->isContinuedPage) {
+          this->partialPacket.clear();
+        }
+        continue;
+      }
+
+      std::size_t segmentLength = this->segments[this->segmentIndex];
+      this->partialPacket.insert(
+        this->partialPacket.end(),
+        this->body.begin() + this->bodyOffset,
+        this->body.begin() + this->bodyOffset + segmentLength
+      );
+      this->bodyOffset += segmentLength;
+      ++this->segmentIndex;
+
+      // A lacing value below 255 ends the packet, otherwise it continues in the next
+      // segment, possibly on the next page
+      if(segmentLength < 255) {
+        bool isLastOnPage = (this->segmentIndex == this->lastPacketSegmentIndex + 1);
+
+        packet.Data.swap(this->partialPacket);
+        this->partialPacket.clear();
+        packet.GranulePosition = isLastOnPage ? this->pageGranulePosition : NoGranulePosition;
+        packet.IsLast = isLastOnPage && this->isEndOfStreamPage;
+        return true;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OggPacketReader::readPage() {
+    if(this->isStreamFinished) {
+      return false;
+    }
+
+    std::uint64_t fileSize = this->file.GetSize();
+    std::byte header[MaximumPageHeaderSize];
+    for(;;) {
+      std::uint64_t remainingByteCount = fileSize - this->offset;
+      if(remainingByteCount < PageHeaderSize) {
+        this->isStreamFinished = true;
+        return false; // End of file, the stream was not finished properly
+      }
+
+      std::size_t headerLength = static_cast<std::size_t>(
+        std::min<std::uint64_t>(remainingByteCount, MaximumPageHeaderSize)
+      );
+      this->file.ReadAt(this->offset, headerLength, header);
+      if(std::memcmp(header, "OggS", 4) != 0) {
+        throw Errors::CorruptedFileError(u8"Lost synchronization with the Ogg page structure");
+      }
+
+      std::size_t segmentCount = static_cast<std::size_t>(header[26]);
+      if(PageHeaderSize + segmentCount > headerLength) {
+        this->isStreamFinished = true;
+        return false; // Truncated page header
+      }
+
+      std::size_t bodyLength = 0;
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        bodyLength += static_cast<std::size_t>(header[PageHeaderSize + index]);
+      }
+      std::uint64_t pageLength = PageHeaderSize + segmentCount + bodyLength;
+      if(pageLength > remainingByteCount) {
+        this->isStreamFinished = true;
+        return false; // Truncated page body
+      }
+
+      std::uint32_t pageSerialNumber = LittleEndianReader::ReadUInt32(header + 14);
+      if(!this->hasSerialNumber) {
+        this->serialNumber = pageSerialNumber;
+        this->hasSerialNumber = true;
+      }
+
+      std::uint64_t pageOffset = this->offset;
+      this->offset += pageLength;
+
+      // Pages of other logical streams multiplexed into the file are skipped
+      if(pageSerialNumber != this->serialNumber) {
+        continue;
+      }
+
+      std::uint8_t headerType = LittleEndianReader::ReadUInt8(header + 5);
+      this->isContinuedPage = ((headerType & ContinuedPacketFlag) != 0);
+      this->isEndOfStreamPage = ((headerType & EndOfStreamFlag) != 0);
+      this->isStreamFinished = this->isEndOfStreamPage;
+      this->pageGranulePosition = static_cast<std::int64_t>(
+        LittleEndianReader::ReadUInt64(header + 6)
+      );
+
+      this->segments.resize(segmentCount);
+      this->lastPacketSegmentIndex = segmentCount; // no packet ends on the page
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        this->segments[index] = static_cast<std::uint8_t>(header[PageHeaderSize + index]);
+        if(this->segments[index] < 255) {
+          this->lastPacketSegmentIndex = index;
+        }
+      }
+
+      this->body.resize(bodyLength);
+      if(bodyLength > 0) {
+        this->file.ReadAt(
+          pageOffset + PageHeaderSize + segmentCount, bodyLength, this->body.data()
+        );
+      }
+
+      this->segmentIndex = 0;
+      this->bodyOffset = 0;
+      return true;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
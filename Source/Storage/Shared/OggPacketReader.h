@@ -0,0 +1,134 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_OGGPACKETREADER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_OGGPACKETREADER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t, std::uint32_t, std::int64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the packets of a logical stream straight out of Ogg pages</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This does the same job as libogg's ogg_sync and ogg_stream functions, but does
+  ///     not depend on libogg and hands out the packets exactly as they are stored, which
+  ///     is what remuxing needs. Only the first logical stream in the file is followed,
+  ///     pages of other multiplexed streams are skipped.
+  ///   </para>
+  ///   <para>
+  ///     Reading ends at the stream's end-of-stream page or, for unfinished recordings,
+  ///     at the end of the file or a truncated final page.
+  ///   </para>
+  /// </remarks>
+  class OggPacketReader {
+
+    /// <summary>Granule position reported for packets that don't end a page</summary>
+    public: static constexpr std::int64_t NoGranulePosition = -1;
+
+    /// <summary>Packet that has been read from an Ogg stream</summary>
+    public: struct Packet {
+
+      /// <summary>Bytes of the packet as they were stored in the Ogg pages</summary>
+      public: std::vector<std::byte> Data;
+      /// <summary>Granule position of the page, if the packet was the last to end on it</summary>
+      public: std::int64_t GranulePosition;
+      /// <summary>Whether this is the last packet of the logical stream</summary>
+      public: bool IsLast;
+
+    };
+
+    /// <summary>Initializes a new packet reader on the specified Ogg file</summary>
+    /// <param name="file">Ogg file from which packets will be read</param>
+    /// <param name="startOffset">Offset of the first page that will be read</param>
+    public: OggPacketReader(const VirtualFile &file, std::uint64_t startOffset = 0);
+
+    /// <summary>Returns the serial number of the logical stream being read</summary>
+    /// <returns>The serial number of the logical stream</returns>
+    /// <remarks>
+    ///   Only valid once the first packet has been read, until then zero is returned.
+    /// </remarks>
+    public: std::uint32_t GetSerialNumber() const { return this->serialNumber; }
+
+    /// <summary>Returns the offset just behind the last page that has been read</summary>
+    /// <returns>The offset at which the next page would be read</returns>
+    public: std::uint64_t GetOffset() const { return this->offset; }
+
+    /// <summary>Reads the next packet from the logical stream</summary>
+    /// <param name="packet">Packet that will receive the next packet's data</param>
+    /// <returns>True if a packet was read, false if the logical stream has ended</returns>
+    public: bool ReadPacket(Packet &packet);
+
+    /// <summary>Reads the next page of the followed logical stream</summary>
+    /// <returns>True if a page was read, false if the logical stream has ended</returns>
+    private: bool readPage();
+
+    /// <summary>File from which the Ogg pages are being read</summary>
+    private: const VirtualFile &file;
+    /// <summary>Offset in the file at which the next page will be read</summary>
+    private: std::uint64_t offset;
+    /// <summary>Serial number of the logical stream that is being followed</summary>
+    private: std::uint32_t serialNumber;
+    /// <summary>Whether the first page of the stream has been read already</summary>
+    private: bool hasSerialNumber;
+    /// <summary>Whether the end-of-stream page or the end of the file has been reached</summary>
+    private: bool isStreamFinished;
+
+    /// <summary>Lacing values of the current page</summary>
+    private: std::vector<std::uint8_t> segments;
+    /// <summary>Body of the current page</summary>
+    private: std::vector<std::byte> body;
+    /// <summary>Index of the next lacing value that will be processed</summary>
+    private: std::size_t segmentIndex;
+    /// <summary>Offset in the page body at which the next segment starts</summary>
+    private: std::size_t bodyOffset;
+    /// <summary>Index of the segment completing the last packet ending on the page</summary>
+    private: std::size_t lastPacketSegmentIndex;
+    /// <summary>Granule position stored in the current page</summary>
+    private: std::int64_t pageGranulePosition;
+    /// <summary>Whether the current page begins with the tail end of a packet</summary>
+    private: bool isContinuedPage;
+    /// <summary>Whether the current page is the stream's end-of-stream page</summary>
+    private: bool isEndOfStreamPage;
+    /// <summary>Data of the packet being assembled, can stretch over several pages</summary>
+    private: std::vector<std::byte> partialPacket;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_OGGPACKETREADER_H
@@ -0,0 +1,168 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OggPageVerifier.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include "../EndianReader.h"
+
+#include <cstring> // for std::memcmp()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Size of an Ogg page with the largest possible segment table and body</summary>
+  const std::size_t MaximumPageSize = PageHeaderSize + 255 + 255 * 255;
+
+  /// <summary>Offset of the CRC field within the Ogg page header</summary>
+  const std::size_t CrcOffset = 22;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lookup table for the CRC-32 (polynomial 0x04c11db7) used by Ogg pages</summary>
+  struct PageCrcTable {
+
+    /// <summary>CRC of each possible byte value when shifted into the register</summary>
+    public: std::uint32_t Entries[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the lookup table for the Ogg page checksum</summary>
+  /// <returns>The lookup table for the Ogg page checksum</returns>
+  constexpr PageCrcTable makePageCrcTable() {
+    PageCrcTable table = {};
+    for(std::uint32_t index = 0; index < 256; ++index) {
+      std::uint32_t crc = index << 24;
+      for(unsigned bit = 0; bit < 8; ++bit) {
+        crc = (crc << 1) ^ (((crc & 0x80000000U) != 0) ? 0x04c11db7U : 0U);
+      }
+      table.Entries[index] = crc;
+    }
+    return table;
+  }
+
+  /// <summary>Lookup table for the Ogg page checksum</summary>
+  constexpr PageCrcTable pageCrcTable = makePageCrcTable();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Feeds more bytes into a running Ogg page checksum</summary>
+  /// <param name="crc">Checksum of the bytes processed so far</param>
+  /// <param name="data">Bytes that will be added to the checksum</param>
+  /// <param name="byteCount">Number of bytes that will be added</param>
+  /// <returns>The checksum including the added bytes</returns>
+  std::uint32_t updateCrc(std::uint32_t crc, const std::byte *data, std::size_t byteCount) {
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      std::uint8_t tableIndex = static_cast<std::uint8_t>(
+        (crc >> 24) ^ static_cast<std::uint8_t>(data[index])
+      );
+      crc = (crc << 8) ^ pageCrcTable.Entries[tableIndex];
+    }
+    return crc;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult OggPageVerifier::VerifyPages(
+    const VirtualFile &file, const CancellationToken &cancellation
+  ) {
+    std::uint64_t fileSize = file.GetSize();
+    if(fileSize == 0) {
+      return VerificationResult::Failed;
+    }
+
+    std::vector<std::byte> page(MaximumPageSize);
+    std::uint64_t offset = 0;
+    while(offset < fileSize) {
+      if(cancellation.IsCancellationRequested()) {
+        return VerificationResult::NotChecked;
+      }
+
+      // Unlike the link scanner, we can't stop at trailing garbage or a truncated page
+      // here, since either would be exactly the kind of damage we're supposed to find.
+      std::uint64_t remainingByteCount = fileSize - offset;
+      if(remainingByteCount < PageHeaderSize) {
+        return VerificationResult::Failed;
+      }
+      file.ReadAt(offset, PageHeaderSize, page.data());
+      if(std::memcmp(page.data(), "OggS", 4) != 0) {
+        return VerificationResult::Failed;
+      }
+
+      std::size_t segmentCount = static_cast<std::size_t>(page[26]);
+      if(PageHeaderSize + segmentCount > remainingByteCount) {
+        return VerificationResult::Failed;
+      }
+      file.ReadAt(offset + PageHeaderSize, segmentCount, page.data() + PageHeaderSize);
+
+      std::size_t pageLength = PageHeaderSize + segmentCount;
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        pageLength += static_cast<std::size_t>(page[PageHeaderSize + index]);
+      }
+      if(pageLength > remainingByteCount) {
+        return VerificationResult::Failed;
+      }
+
+      std::size_t bodyOffset = PageHeaderSize + segmentCount;
+      file.ReadAt(offset + bodyOffset, pageLength - bodyOffset, page.data() + bodyOffset);
+
+      std::uint32_t storedCrc = LittleEndianReader::ReadUInt32(page.data() + CrcOffset);
+      if(CalculatePageCrc(page.data(), pageLength) != storedCrc) {
+        return VerificationResult::Failed;
+      }
+
+      offset += pageLength;
+    }
+
+    return VerificationResult::Passed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint32_t OggPageVerifier::CalculatePageCrc(
+    const std::byte *page, std::size_t pageLength
+  ) {
+    const std::byte zeroCrc[4] = { std::byte(0), std::byte(0), std::byte(0), std::byte(0) };
+
+    std::uint32_t crc = updateCrc(0, page, CrcOffset);
+    crc = updateCrc(crc, zeroCrc, 4);
+    return updateCrc(crc, page + CrcOffset + 4, pageLength - CrcOffset - 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,79 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEVERIFIER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEVERIFIER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/IntegrityVerification.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint32_t
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+  class CancellationToken;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks the CRC of every page in an Ogg file</summary>
+  /// <remarks>
+  ///   libogg already checks the CRC of every page it parses, but silently drops pages
+  ///   that don't match, so a damaged file simply plays with a gap. This walks over all
+  ///   pages of the file up front so that damage can be reported.
+  /// </remarks>
+  class OggPageVerifier {
+
+    /// <summary>Verifies the CRC of every page in an Ogg file</summary>
+    /// <param name="file">Ogg file whose pages will be verified</param>
+    /// <param name="cancellation">Token by which the verification can be cancelled</param>
+    /// <returns>
+    ///   Passed if every page matched its CRC, failed if a page did not match or the page
+    ///   structure is damaged and not checked if the verification was cancelled
+    /// </returns>
+    public: static VerificationResult VerifyPages(
+      const VirtualFile &file, const CancellationToken &cancellation
+    );
+
+    /// <summary>Calculates the CRC of an Ogg page</summary>
+    /// <param name="page">Complete Ogg page, including its header</param>
+    /// <param name="pageLength">Length of the page in bytes</param>
+    /// <returns>The CRC the page should have stored in its header</returns>
+    /// <remarks>
+    ///   The CRC field in the page header is treated as zero, as the Ogg specification
+    ///   demands, so this can be called on a page that already has its CRC filled in.
+    /// </remarks>
+    public: static std::uint32_t CalculatePageCrc(const std::byte *page, std::size_t pageLength);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEVERIFIER_H
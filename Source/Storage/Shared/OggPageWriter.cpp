@@ -0,0 +1,191 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OggPageWriter.h"
+#include "./OggPageVerifier.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::copy(), std::min()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Body size after which a page is written out, matching libogg</summary>
+  const std::size_t PreferredPageBodySize = 4096;
+
+  /// <summary>Header type flag indicating a page that continues the previous packet</summary>
+  const std::uint8_t ContinuedPacketFlag = 0x01;
+
+  /// <summary>Header type flag indicating the first page of a logical stream</summary>
+  const std::uint8_t BeginningOfStreamFlag = 0x02;
+
+  /// <summary>Header type flag indicating the last page of a logical stream</summary>
+  const std::uint8_t EndOfStreamFlag = 0x04;
+
+  /// <summary>Granule position used by pages on which no packet ends</summary>
+  const std::uint64_t NoGranulePosition = std::uint64_t(-1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an integer into a buffer in little endian format</summary>
+  /// <param name="target">Buffer the integer will be written into</param>
+  /// <param name="value">Value that will be written</param>
+  /// <param name="byteCount">Number of bytes the integer occupies</param>
+  void writeLittleEndian(std::byte *target, std::uint64_t value, std::size_t byteCount) {
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      target[index] = static_cast<std::byte>(value >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OggPageWriter::OggPageWriter(
+    VirtualFile &target, std::uint64_t startOffset, std::uint32_t serialNumber
+  ) :
+    target(target),
+    offset(startOffset),
+    serialNumber(serialNumber),
+    pageSequenceNumber(0),
+    segments(),
+    body(),
+    pageGranulePosition(-1),
+    isContinuedPage(false),
+    page() {
+    this->segments.reserve(255);
+    this->body.reserve(PreferredPageBodySize + 255 * 255);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggPageWriter::WritePacket(
+    const std::byte *data, std::size_t byteCount,
+    std::int64_t granulePosition, bool isLast /* = false */
+  ) {
+
+    // Packets are split into 255 byte segments with a final segment shorter than
+    // 255 bytes (possibly empty) marking the end of the packet
+    std::size_t remainingByteCount = byteCount;
+    bool isFirstSegment = true;
+    for(;;) {
+      if(this->segments.size() >= 255) {
+        writePage(false);
+        this->isContinuedPage = !isFirstSegment;
+      }
+      isFirstSegment = false;
+
+      std::size_t segmentLength = std::min<std::size_t>(remainingByteCount, 255);
+      this->segments.push_back(static_cast<std::uint8_t>(segmentLength));
+      this->body.insert(this->body.end(), data, data + segmentLength);
+      data += segmentLength;
+      remainingByteCount -= segmentLength;
+
+      if(segmentLength < 255) {
+        break;
+      }
+    }
+
+    if(granulePosition >= 0) {
+      this->pageGranulePosition = granulePosition;
+    }
+
+    if(isLast) {
+      writePage(true);
+    } else if(this->body.size() >= PreferredPageBodySize) {
+      writePage(false);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggPageWriter::FlushPage() {
+    if(!this->segments.empty()) {
+      writePage(false);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggPageWriter::writePage(bool isEndOfStream) {
+    std::size_t segmentCount = this->segments.size();
+    std::size_t pageLength = PageHeaderSize + segmentCount + this->body.size();
+    this->page.resize(pageLength);
+
+    std::uint8_t headerType = 0;
+    if(this->isContinuedPage) {
+      headerType |= ContinuedPacketFlag;
+    }
+    if(this->pageSequenceNumber == 0) {
+      headerType |= BeginningOfStreamFlag;
+    }
+    if(isEndOfStream) {
+      headerType |= EndOfStreamFlag;
+    }
+
+    std::uint64_t granulePosition = NoGranulePosition;
+    if(this->pageGranulePosition >= 0) {
+      granulePosition = static_cast<std::uint64_t>(this->pageGranulePosition);
+    }
+
+    std::byte *header = this->page.data();
+    header[0] = std::byte('O');
+    header[1] = std::byte('g');
+    header[2] = std::byte('g');
+    header[3] = std::byte('S');
+    header[4] = std::byte(0); // stream structure version
+    header[5] = static_cast<std::byte>(headerType);
+    writeLittleEndian(header + 6, granulePosition, 8);
+    writeLittleEndian(header + 14, this->serialNumber, 4);
+    writeLittleEndian(header + 18, this->pageSequenceNumber, 4);
+    writeLittleEndian(header + 22, 0, 4); // CRC, filled in below
+    header[26] = static_cast<std::byte>(segmentCount);
+    for(std::size_t index = 0; index < segmentCount; ++index) {
+      header[PageHeaderSize + index] = static_cast<std::byte>(this->segments[index]);
+    }
+    std::copy(this->body.begin(), this->body.end(), header + PageHeaderSize + segmentCount);
+
+    std::uint32_t crc = OggPageVerifier::CalculatePageCrc(header, pageLength);
+    writeLittleEndian(header + 22, crc, 4);
+
+    this->target.WriteAt(this->offset, pageLength, header);
+    this->offset += pageLength;
+
+    ++this->pageSequenceNumber;
+    this->segments.clear();
+    this->body.clear();
+    this->pageGranulePosition = -1;
+    this->isContinuedPage = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,115 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEWRITER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEWRITER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint> // for std::uint64_t, std::uint32_t, std::int64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs the packets of a logical stream into Ogg pages</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Packets are collected into pages of about 4 KiB, the same size libogg aims for.
+  ///     Each page records the granule position of the last packet that ends on it.
+  ///     Codecs that need their header packets on pages of their own can end the current
+  ///     page early via <see cref="FlushPage" />.
+  ///   </para>
+  ///   <para>
+  ///     The first page written is flagged as the beginning of the stream and the page
+  ///     holding the packet written with <paramref name="isLast" /> set as its end.
+  ///   </para>
+  /// </remarks>
+  class OggPageWriter {
+
+    /// <summary>Initializes a new page writer appending to the specified file</summary>
+    /// <param name="target">File the Ogg pages will be written into</param>
+    /// <param name="startOffset">Offset in the file at which the first page is written</param>
+    /// <param name="serialNumber">Serial number of the logical stream being written</param>
+    public: OggPageWriter(
+      VirtualFile &target, std::uint64_t startOffset, std::uint32_t serialNumber
+    );
+
+    /// <summary>Returns the offset just behind the last page that has been written</summary>
+    /// <returns>The offset at which the next page will be written</returns>
+    public: std::uint64_t GetOffset() const { return this->offset; }
+
+    /// <summary>Adds a packet to the logical stream</summary>
+    /// <param name="data">Bytes of the packet</param>
+    /// <param name="byteCount">Length of the packet in bytes</param>
+    /// <param name="granulePosition">
+    ///   Granule position at the end of the packet. Negative values are not recorded,
+    ///   so a page on which only such packets end stores no granule position.
+    /// </param>
+    /// <param name="isLast">Whether this is the last packet of the logical stream</param>
+    public: void WritePacket(
+      const std::byte *data, std::size_t byteCount,
+      std::int64_t granulePosition, bool isLast = false
+    );
+
+    /// <summary>Writes out the current page even if it has room for more packets</summary>
+    public: void FlushPage();
+
+    /// <summary>Writes the current page into the file and starts a new one</summary>
+    /// <param name="isEndOfStream">Whether to flag the page as the end of the stream</param>
+    private: void writePage(bool isEndOfStream);
+
+    /// <summary>File the Ogg pages are written into</summary>
+    private: VirtualFile &target;
+    /// <summary>Offset at which the next page will be written</summary>
+    private: std::uint64_t offset;
+    /// <summary>Serial number of the logical stream being written</summary>
+    private: std::uint32_t serialNumber;
+    /// <summary>Sequence number the next page will receive</summary>
+    private: std::uint32_t pageSequenceNumber;
+    /// <summary>Lacing values of the page being assembled</summary>
+    private: std::vector<std::uint8_t> segments;
+    /// <summary>Body of the page being assembled</summary>
+    private: std::vector<std::byte> body;
+    /// <summary>Granule position of the last packet ending on the current page</summary>
+    private: std::int64_t pageGranulePosition;
+    /// <summary>Whether the current page begins with the tail end of a packet</summary>
+    private: bool isContinuedPage;
+    /// <summary>Buffer in which the complete page is assembled for writing</summary>
+    private: std::vector<std::byte> page;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_OGGPAGEWRITER_H
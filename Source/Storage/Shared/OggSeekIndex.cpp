@@ -0,0 +1,348 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./OggSeekIndex.h"
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../EndianReader.h"
+
+#include <algorithm> // for std::min(), std::upper_bound()
+#include <cstring> // for std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of an Ogg page header without its segment table</summary>
+  const std::size_t PageHeaderSize = 27;
+
+  /// <summary>Size of an Ogg page header with the largest possible segment table</summary>
+  const std::size_t MaximumPageHeaderSize = PageHeaderSize + 255;
+
+  /// <summary>Header type flag indicating the page continues a packet</summary>
+  const std::uint8_t ContinuedPacketFlag = 0x01;
+
+  /// <summary>Header type flag indicating the last page of a logical stream</summary>
+  const std::uint8_t EndOfStreamFlag = 0x04;
+
+  /// <summary>Granule position used by pages on which no packet ends</summary>
+  const std::uint64_t NoGranulePosition = std::uint64_t(-1);
+
+  /// <summary>Maximum distance a decoder may be ahead of the index to have it follow</summary>
+  /// <remarks>
+  ///   Both libvorbisfile and libopusfile read the file in chunks of a few kilobytes,
+  ///   so a sequentially reading decoder will never be further ahead than this.
+  /// </remarks>
+  const std::uint64_t MaximumFollowDistance = 262144;
+
+  /// <summary>Identifies serialized seek indices</summary>
+  const char SerializedIndexMagic[4] = { 'O', 'g', 'g', 'X' };
+
+  /// <summary>Version of the serialized index format</summary>
+  const std::uint32_t SerializedIndexVersion = 1;
+
+  /// <summary>Size of the serialized index's header, up to the first entry</summary>
+  const std::size_t SerializedHeaderSize = 4 + 4 + 8 + 8 + 8 + 8 + 1 + 4 + 1 + 8;
+
+  /// <summary>Size of a single serialized index entry</summary>
+  const std::size_t SerializedEntrySize = 8 + 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer to a buffer in little endian format</summary>
+  /// <typeparam name="TInteger">Type of integer that will be appended</typeparam>
+  /// <param name="buffer">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  template<typename TInteger>
+  void appendLittleEndian(std::vector<std::byte> &buffer, TInteger value) {
+    for(std::size_t index = 0; index < sizeof(TInteger); ++index) {
+      buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OggSeekIndex::OggSeekIndex(std::uint64_t fileSize, std::uint64_t granuleInterval) :
+    granuleInterval(granuleInterval),
+    fileSize(fileSize),
+    scanOffset(0),
+    previousGranulePosition(0),
+    streamSerialNumber(),
+    complete(false),
+    entries(),
+    indexMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool OggSeekIndex::IsComplete() const {
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+    return this->complete;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggSeekIndex::ScanUntil(const VirtualFile &file, std::uint64_t endOffset) {
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+    if(this->complete || (this->scanOffset >= endOffset)) {
+      return;
+    }
+
+    if(endOffset > this->fileSize) {
+      endOffset = this->fileSize;
+    }
+
+    std::byte header[MaximumPageHeaderSize];
+    while(this->scanOffset < endOffset) {
+      std::uint64_t remainingByteCount = this->fileSize - this->scanOffset;
+      if(remainingByteCount < PageHeaderSize) {
+        break; // Trailing garbage, nothing more to index
+      }
+
+      // Read the page header along with as much of the segment table as could possibly
+      // exist. This gives us the whole header in a single read in nearly all cases.
+      std::size_t headerLength = static_cast<std::size_t>(
+        std::min<std::uint64_t>(remainingByteCount, MaximumPageHeaderSize)
+      );
+      file.ReadAt(this->scanOffset, headerLength, header);
+
+      // If we lose sync with the page structure, we stop indexing here. Everything
+      // recorded so far is still valid and seeks beyond it will bisect as usual.
+      if(std::memcmp(header, "OggS", 4) != 0) {
+        this->complete = true;
+        return;
+      }
+      std::size_t segmentCount = static_cast<std::size_t>(header[26]);
+      if(PageHeaderSize + segmentCount > headerLength) {
+        this->complete = true;
+        return;
+      }
+
+      std::size_t pageLength = PageHeaderSize + segmentCount;
+      for(std::size_t index = 0; index < segmentCount; ++index) {
+        pageLength += static_cast<std::size_t>(header[PageHeaderSize + index]);
+      }
+
+      std::uint32_t serialNumber = LittleEndianReader::ReadUInt32(header + 14);
+      if(!this->streamSerialNumber.has_value()) {
+        this->streamSerialNumber = serialNumber;
+      }
+
+      // Pages of other logical streams (i.e. video multiplexed with the audio) are skipped
+      if(serialNumber == this->streamSerialNumber.value()) {
+        std::uint8_t headerType = LittleEndianReader::ReadUInt8(header + 5);
+
+        // A page that begins with a fresh packet is a good place to resume decoding,
+        // its first sample directly follows the previous page's granule position.
+        // Header pages all have a granule position of zero, so they're never indexed.
+        bool isContinuation = ((headerType & ContinuedPacketFlag) != 0);
+        if((this->previousGranulePosition != 0) && !isContinuation) {
+          bool isFarEnough = (
+            this->entries.empty() ||
+            (
+              this->previousGranulePosition - this->entries.back().GranulePosition >=
+              this->granuleInterval
+            )
+          );
+          if(isFarEnough) {
+            this->entries.push_back(Entry { this->previousGranulePosition, this->scanOffset });
+          }
+        }
+
+        std::uint64_t granulePosition = LittleEndianReader::ReadUInt64(header + 6);
+        if(granulePosition != NoGranulePosition) {
+          this->previousGranulePosition = granulePosition;
+        }
+
+        // Links of chained streams are opened as files of their own, so stop here
+        if((headerType & EndOfStreamFlag) != 0) {
+          this->scanOffset += pageLength;
+          this->complete = true;
+          return;
+        }
+      }
+
+      this->scanOffset += pageLength;
+    } // while pages remain before the end offset
+
+    if(this->scanOffset >= this->fileSize) {
+      this->complete = true;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggSeekIndex::ScanBehindDecoder(const VirtualFile &file, std::uint64_t decoderOffset) {
+    {
+      std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+      if(this->complete || (decoderOffset <= this->scanOffset)) {
+        return;
+      }
+      if(decoderOffset - this->scanOffset > MaximumFollowDistance) {
+        return; // Decoder is somewhere else in the file, not following on from the index
+      }
+    }
+
+    ScanUntil(file, decoderOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<OggSeekIndex::Entry> OggSeekIndex::TryFindEntry(
+    std::uint64_t granulePosition
+  ) const {
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+
+    // If the index doesn't reach that far yet, the closest entry can be arbitrarily far
+    // before the target and decoding forward from there would take longer than bisecting
+    if(!this->complete && (granulePosition > this->previousGranulePosition)) {
+      return std::optional<Entry>();
+    }
+
+    std::vector<Entry>::const_iterator entry = std::upper_bound(
+      this->entries.begin(), this->entries.end(), granulePosition,
+      [](std::uint64_t granulePosition, const Entry &entry) {
+        return granulePosition < entry.GranulePosition;
+      }
+    );
+    if(entry == this->entries.begin()) {
+      return std::optional<Entry>();
+    }
+
+    --entry;
+    return *entry;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t OggSeekIndex::CountEntries() const {
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+    return this->entries.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> OggSeekIndex::Serialize() const {
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+
+    std::vector<std::byte> serializedIndex;
+    serializedIndex.reserve(SerializedHeaderSize + this->entries.size() * SerializedEntrySize);
+
+    for(std::size_t index = 0; index < sizeof(SerializedIndexMagic); ++index) {
+      serializedIndex.push_back(static_cast<std::byte>(SerializedIndexMagic[index]));
+    }
+    appendLittleEndian(serializedIndex, SerializedIndexVersion);
+    appendLittleEndian(serializedIndex, this->granuleInterval);
+    appendLittleEndian(serializedIndex, this->fileSize);
+    appendLittleEndian(serializedIndex, this->scanOffset);
+    appendLittleEndian(serializedIndex, this->previousGranulePosition);
+    appendLittleEndian(serializedIndex, std::uint8_t(this->streamSerialNumber.has_value()));
+    appendLittleEndian(serializedIndex, this->streamSerialNumber.value_or(0));
+    appendLittleEndian(serializedIndex, std::uint8_t(this->complete));
+    appendLittleEndian(serializedIndex, static_cast<std::uint64_t>(this->entries.size()));
+
+    for(const Entry &entry : this->entries) {
+      appendLittleEndian(serializedIndex, entry.GranulePosition);
+      appendLittleEndian(serializedIndex, entry.ByteOffset);
+    }
+
+    return serializedIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void OggSeekIndex::Deserialize(const std::vector<std::byte> &serializedIndex) {
+    const std::byte *data = serializedIndex.data();
+    if(serializedIndex.size() < SerializedHeaderSize) {
+      throw Errors::CorruptedFileError(u8"Serialized Ogg seek index is truncated");
+    }
+    if(std::memcmp(data, SerializedIndexMagic, sizeof(SerializedIndexMagic)) != 0) {
+      throw Errors::CorruptedFileError(u8"Data is not a serialized Ogg seek index");
+    }
+    if(LittleEndianReader::ReadUInt32(data + 4) != SerializedIndexVersion) {
+      throw Errors::CorruptedFileError(u8"Serialized Ogg seek index has unsupported version");
+    }
+
+    // The file size never changes after construction, so it's safe to read unlocked
+    std::uint64_t serializedFileSize = LittleEndianReader::ReadUInt64(data + 16);
+    if(serializedFileSize != this->fileSize) {
+      throw Errors::CorruptedFileError(u8"Serialized Ogg seek index is for a different file");
+    }
+
+    std::uint64_t entryCount = LittleEndianReader::ReadUInt64(data + 46);
+    std::uint64_t maximumEntryCount = (
+      (serializedIndex.size() - SerializedHeaderSize) / SerializedEntrySize
+    );
+    if(entryCount != maximumEntryCount) {
+      throw Errors::CorruptedFileError(u8"Serialized Ogg seek index has wrong length");
+    }
+
+    std::vector<Entry> loadedEntries;
+    loadedEntries.reserve(static_cast<std::size_t>(entryCount));
+    const std::byte *entryData = data + SerializedHeaderSize;
+    for(std::uint64_t index = 0; index < entryCount; ++index) {
+      Entry entry;
+      entry.GranulePosition = LittleEndianReader::ReadUInt64(entryData);
+      entry.ByteOffset = LittleEndianReader::ReadUInt64(entryData + 8);
+      if(!loadedEntries.empty()) {
+        const Entry &previous = loadedEntries.back();
+        bool isOrdered = (
+          (entry.GranulePosition > previous.GranulePosition) &&
+          (entry.ByteOffset > previous.ByteOffset)
+        );
+        if(!isOrdered) {
+          throw Errors::CorruptedFileError(u8"Serialized Ogg seek index is not ordered");
+        }
+      }
+      if(entry.ByteOffset >= serializedFileSize) {
+        throw Errors::CorruptedFileError(u8"Serialized Ogg seek index points beyond the file");
+      }
+
+      loadedEntries.push_back(entry);
+      entryData += SerializedEntrySize;
+    }
+
+    // Everything checks out, replace the current index with the loaded one
+    std::lock_guard<std::mutex> indexMutexScope(this->indexMutex);
+
+    this->granuleInterval = LittleEndianReader::ReadUInt64(data + 8);
+    this->scanOffset = LittleEndianReader::ReadUInt64(data + 24);
+    this->previousGranulePosition = LittleEndianReader::ReadUInt64(data + 32);
+    if(LittleEndianReader::ReadUInt8(data + 40) != 0) {
+      this->streamSerialNumber = LittleEndianReader::ReadUInt32(data + 41);
+    } else {
+      this->streamSerialNumber.reset();
+    }
+    this->complete = (LittleEndianReader::ReadUInt8(data + 45) != 0);
+    this->entries.swap(loadedEntries);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,157 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_OGGSEEKINDEX_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_OGGSEEKINDEX_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::uint64_t, std::uint32_t
+#include <mutex> // for std::mutex
+#include <optional> // for std::optional
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Remembers the byte offsets of pages in an Ogg stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Ogg files have no index, so libvorbisfile and libopusfile find the page for
+  ///     a given sample by bisecting the file, which takes many small reads scattered
+  ///     all over the file. This index records the byte offset of a page every so
+  ///     often, so a seek only needs to jump to the nearest page before the target
+  ///     and decode forward from there.
+  ///   </para>
+  ///   <para>
+  ///     The index is built by walking the Ogg page headers. It can either be built
+  ///     in one go or bit by bit while the stream is decoded sequentially, following
+  ///     behind the codec library's reads. It can be serialized and loaded again to
+  ///     avoid building it each time the file is opened.
+  ///   </para>
+  ///   <para>
+  ///     All methods are thread-safe so the index can be shared by several readers
+  ///     decoding the same file.
+  ///   </para>
+  /// </remarks>
+  class OggSeekIndex {
+
+    /// <summary>Point in the Ogg stream at which decoding can resume</summary>
+    public: struct Entry {
+
+      /// <summary>Granule position of the last sample before the page</summary>
+      public: std::uint64_t GranulePosition;
+      /// <summary>Offset of the page's first byte in the file</summary>
+      public: std::uint64_t ByteOffset;
+
+    };
+
+    /// <summary>Initializes a new, empty seek index</summary>
+    /// <param name="fileSize">Size of the Ogg file that will be indexed</param>
+    /// <param name="granuleInterval">
+    ///   Minimum distance between two consecutive index entries in granules
+    /// </param>
+    public: OggSeekIndex(std::uint64_t fileSize, std::uint64_t granuleInterval);
+
+    /// <summary>Frees all memory used by the seek index</summary>
+    public: ~OggSeekIndex() = default;
+
+    /// <summary>Checks whether the whole file has been scanned</summary>
+    /// <returns>True if the index covers the whole file</returns>
+    public: bool IsComplete() const;
+
+    /// <summary>Indexes the pages of an Ogg stream up to the specified offset</summary>
+    /// <param name="file">Ogg file that will be scanned</param>
+    /// <param name="endOffset">Offset up to which pages will be indexed</param>
+    /// <remarks>
+    ///   Scanning continues where the previous call left off. Passing the file's size
+    ///   completes the index. Only the first logical stream in the file is indexed.
+    /// </remarks>
+    public: void ScanUntil(const VirtualFile &file, std::uint64_t endOffset);
+
+    /// <summary>Extends the index up to where a decoder is currently reading</summary>
+    /// <param name="file">Ogg file that will be scanned</param>
+    /// <param name="decoderOffset">Offset up to which the decoder has read the file</param>
+    /// <remarks>
+    ///   This only scans if the decoder is reading right behind the indexed range, so
+    ///   the index grows for free while a file is decoded sequentially, but random
+    ///   seeks far ahead don't trigger long scans of the skipped-over part.
+    /// </remarks>
+    public: void ScanBehindDecoder(const VirtualFile &file, std::uint64_t decoderOffset);
+
+    /// <summary>Looks up the closest index entry before the specified granule</summary>
+    /// <param name="granulePosition">Granule position that should be reached</param>
+    /// <returns>
+    ///   The entry with the highest granule position not above the specified one or
+    ///   nothing if there is no such entry or the index does not reach that far yet
+    /// </returns>
+    public: std::optional<Entry> TryFindEntry(std::uint64_t granulePosition) const;
+
+    /// <summary>Counts the number of entries in the index</summary>
+    /// <returns>The number of entries currently stored in the index</returns>
+    public: std::size_t CountEntries() const;
+
+    /// <summary>Stores the index in a compact binary format</summary>
+    /// <returns>A buffer holding the serialized index</returns>
+    public: std::vector<std::byte> Serialize() const;
+
+    /// <summary>Replaces the index with one that was serialized earlier</summary>
+    /// <param name="serializedIndex">Buffer holding the serialized index</param>
+    /// <remarks>
+    ///   If the serialized index is malformed or was built for a file of different
+    ///   size, an exception is thrown and the current index is left untouched.
+    /// </remarks>
+    public: void Deserialize(const std::vector<std::byte> &serializedIndex);
+
+    /// <summary>Minimum distance between two index entries in granules</summary>
+    private: std::uint64_t granuleInterval;
+    /// <summary>Size of the file that is being indexed</summary>
+    private: std::uint64_t fileSize;
+    /// <summary>Offset of the next page header that will be scanned</summary>
+    private: std::uint64_t scanOffset;
+    /// <summary>Granule position of the most recently scanned audio page</summary>
+    private: std::uint64_t previousGranulePosition;
+    /// <summary>Serial number of the logical stream that is being indexed</summary>
+    private: std::optional<std::uint32_t> streamSerialNumber;
+    /// <summary>Whether the whole file has been scanned</summary>
+    private: bool complete;
+    /// <summary>Index entries sorted by their granule position</summary>
+    private: std::vector<Entry> entries;
+    /// <summary>Must be held while accessing the index</summary>
+    private: mutable std::mutex indexMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_OGGSEEKINDEX_H
@@ -0,0 +1,87 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_PACKETDECODER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_PACKETDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/Storage/DecodeFidelity.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes individual compressed packets of a lossy audio codec</summary>
+  /// <remarks>
+  ///   The Ogg-based decoders let libopusfile and libvorbisfile find the packets. When
+  ///   the packets come from another container through a <see cref="PacketSource" />,
+  ///   a packet decoder feeds them to the codec library directly.
+  /// </remarks>
+  class PacketDecoder {
+
+    /// <summary>Frees all resources owned by the packet decoder</summary>
+    public: virtual ~PacketDecoder() = default;
+
+    /// <summary>Counts the number of audio channels the decoder produces</summary>
+    /// <returns>The number of interleaved channels in the decoded samples</returns>
+    public: virtual std::size_t CountChannels() const = 0;
+
+    /// <summary>Returns the number of frames per second the decoder produces</summary>
+    /// <returns>The sample rate of the decoded audio</returns>
+    public: virtual std::size_t GetSampleRate() const = 0;
+
+    /// <summary>Retrieves the order in which the decoded channels are interleaved</summary>
+    /// <returns>The placement of each decoded channel, in interleaved order</returns>
+    public: virtual const std::vector<ChannelPlacement> &GetChannelOrder() const = 0;
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    /// <remarks>
+    ///   Called after the packet source jumped to another place in the stream.
+    ///   The output of the first packets after this is not exact until the codec's
+    ///   pre-roll has been decoded.
+    /// </remarks>
+    public: virtual void Reset() = 0;
+
+    /// <summary>Attempts to trade decoding fidelity against CPU time</summary>
+    /// <param name="fidelity">How much work the decoder should put into its output</param>
+    /// <returns>True if the decoder will decode with the requested fidelity</returns>
+    public: virtual bool TrySetFidelity(DecodeFidelity fidelity) {
+      return (fidelity == DecodeFidelity::Standard);
+    }
+
+    /// <summary>Decodes a packet and appends its samples to a buffer</summary>
+    /// <param name="packet">Packet that will be decoded</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer the interleaved float samples will be appended to</param>
+    /// <returns>The number of frames that have been appended</returns>
+    public: virtual std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize, std::vector<float> &samples
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_PACKETDECODER_H
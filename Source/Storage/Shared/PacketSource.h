@@ -0,0 +1,73 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_PACKETSOURCE_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_PACKETSOURCE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte
+#include <cstdint> // for std::int64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Delivers the compressed packets of one audio stream inside a container</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Media containers such as Matroska interleave the packets of several streams.
+  ///     A packet source pulls out the packets of a single audio stream so that they
+  ///     can be handed to a <see cref="PacketDecoder" /> without remuxing them into an
+  ///     Ogg stream first.
+  ///   </para>
+  ///   <para>
+  ///     Timestamps are in nanoseconds and are the container's presentation timestamps,
+  ///     so they still include any codec delay the container declares.
+  ///   </para>
+  /// </remarks>
+  class PacketSource {
+
+    /// <summary>Frees all resources owned by the packet source</summary>
+    public: virtual ~PacketSource() = default;
+
+    /// <summary>Moves the packet cursor to a point at or before a timestamp</summary>
+    /// <param name="timestamp">Timestamp, in nanoseconds, that should be reached</param>
+    /// <returns>The timestamp of the packet that will be delivered next</returns>
+    /// <remarks>
+    ///   Sources use whatever index their container offers to jump close to
+    ///   the timestamp. The caller has to decode and discard packets from there on
+    ///   until it reaches the exact position it wants.
+    /// </remarks>
+    public: virtual std::int64_t Seek(std::int64_t timestamp) = 0;
+
+    /// <summary>Reads the next packet of the stream</summary>
+    /// <param name="packet">Receives the packet's contents</param>
+    /// <param name="timestamp">Receives the packet's timestamp in nanoseconds</param>
+    /// <returns>True if a packet was read, false if the end of the stream was reached</returns>
+    public: virtual bool ReadPacket(std::vector<std::byte> &packet, std::int64_t &timestamp) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_PACKETSOURCE_H
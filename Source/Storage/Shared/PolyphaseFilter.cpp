@@ -0,0 +1,380 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "PolyphaseFilter.h"
+#include "../../Processing/CpuFeatures.h" // for CpuFeatures
+
+#include <cmath> // for std::sin(), std::sqrt()
+#include <map> // for std::map
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::invalid_argument
+#include <tuple> // for std::tuple
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Highest number of phases a filter bank may have</summary>
+  /// <remarks>
+  ///   Common ratios such as 44100 to 48000 (160/147) stay well below this. Larger
+  ///   numbers would make the filter bank bigger than the CPU cache.
+  /// </remarks>
+  const std::size_t MaximumPhaseCount = 1024;
+
+  /// <summary>Highest factor by which the sample rate may be lowered</summary>
+  const std::size_t MaximumDecimation = 16;
+
+  /// <summary>Design parameters of the filter for one quality preset</summary>
+  struct FilterDesign {
+
+    /// <summary>Number of taps per phase when the sample rate is increased</summary>
+    public: std::size_t BaseTapCount;
+    /// <summary>Fraction of the lower Nyquist frequency at which the filter cuts off</summary>
+    public: double CutoffFactor;
+    /// <summary>Shape parameter of the Kaiser window</summary>
+    public: double KaiserBeta;
+
+  };
+
+  /// <summary>Filter designs for the fast, balanced and best quality presets</summary>
+  /// <remarks>
+  ///   The balanced design has a transition band of about 9% of the Nyquist frequency
+  ///   and over 90 dB of stopband attenuation. The fast one halves the work at about
+  ///   60 dB, the best one doubles it for a narrower transition and over 110 dB.
+  /// </remarks>
+  const FilterDesign FilterDesigns[] = {
+    { 16, 0.85, 5.7 },
+    { 32, 0.91, 8.6 },
+    { 64, 0.95, 10.5 }
+  };
+
+  /// <summary>The number pi with enough digits for double precision</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the zeroth-order modified Bessel function of the first kind</summary>
+  /// <param name="x">Value for which the function will be calculated</param>
+  /// <returns>The value of the Bessel function at the specified point</returns>
+  double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+
+    // The series converges quickly for the small arguments a Kaiser window uses
+    for(std::size_t index = 1; index < 50; ++index) {
+      double factor = halfX / static_cast<double>(index);
+      term *= factor * factor;
+      sum += term;
+      if(term < sum * 1e-12) {
+        break;
+      }
+    }
+
+    return sum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_AUDIO_HAVE_SSE2) && !defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Multiplies input samples with filter taps and sums up the products</summary>
+  /// <param name="input">Input samples the taps will be applied to</param>
+  /// <param name="taps">Taps of the filter phase that will be applied</param>
+  /// <param name="tapCount">Number of taps, always a multiple of 4</param>
+  /// <returns>The sum of all input samples weighted by their taps</returns>
+  float dotProductScalar(const float *input, const float *taps, std::size_t tapCount) {
+    float sum = 0.0f;
+    for(std::size_t index = 0; index < tapCount; ++index) {
+      sum += input[index] * taps[index];
+    }
+    return sum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // !defined(NUCLEX_AUDIO_HAVE_SSE2) && !defined(NUCLEX_AUDIO_HAVE_NEON)
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+  /// <summary>Sums up the 4 lanes of an SSE register</summary>
+  /// <param name="sum">Register whose lanes will be summed up</param>
+  /// <returns>The sum of all 4 lanes</returns>
+  inline float sumLanesSse2(__m128 sum) {
+    __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+    sum = _mm_add_ps(sum, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sum);
+    sum = _mm_add_ss(sum, shuffled);
+    return _mm_cvtss_f32(sum);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Applies filter taps to input samples, 4 at a time, using SSE2</summary>
+  /// <param name="input">Input samples the taps will be applied to</param>
+  /// <param name="taps">Taps of the filter phase that will be applied</param>
+  /// <param name="tapCount">Number of taps, always a multiple of 4</param>
+  /// <returns>The sum of all input samples weighted by their taps</returns>
+  float dotProductSse2(const float *input, const float *taps, std::size_t tapCount) {
+    __m128 sum = _mm_setzero_ps();
+    for(std::size_t index = 0; index < tapCount; index += 4) {
+      sum = _mm_add_ps(
+        sum, _mm_mul_ps(_mm_loadu_ps(input + index), _mm_loadu_ps(taps + index))
+      );
+    }
+
+    return sumLanesSse2(sum);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_SSE2)
+
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+  /// <summary>Applies filter taps to input samples, 8 at a time, using FMA</summary>
+  /// <param name="input">Input samples the taps will be applied to</param>
+  /// <param name="taps">Taps of the filter phase that will be applied</param>
+  /// <param name="tapCount">Number of taps, always a multiple of 4</param>
+  /// <returns>The sum of all input samples weighted by their taps</returns>
+  NUCLEX_AUDIO_TARGET_AVX2_FMA float dotProductAvx2(
+    const float *input, const float *taps, std::size_t tapCount
+  ) {
+    __m256 sum = _mm256_setzero_ps();
+
+    std::size_t index = 0;
+    for(; index + 8 <= tapCount; index += 8) {
+      sum = _mm256_fmadd_ps(_mm256_loadu_ps(input + index), _mm256_loadu_ps(taps + index), sum);
+    }
+
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    if(index < tapCount) { // tap counts are multiples of 4, so at most one group remains
+      half = _mm_fmadd_ps(_mm_loadu_ps(input + index), _mm_loadu_ps(taps + index), half);
+    }
+
+    return sumLanesSse2(half);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+
+#if defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Applies filter taps to input samples, 4 at a time, using NEON</summary>
+  /// <param name="input">Input samples the taps will be applied to</param>
+  /// <param name="taps">Taps of the filter phase that will be applied</param>
+  /// <param name="tapCount">Number of taps, always a multiple of 4</param>
+  /// <returns>The sum of all input samples weighted by their taps</returns>
+  float dotProductNeon(const float *input, const float *taps, std::size_t tapCount) {
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    for(std::size_t index = 0; index < tapCount; index += 4) {
+      sum = vfmaq_f32(sum, vld1q_f32(input + index), vld1q_f32(taps + index));
+    }
+
+    return vaddvq_f32(sum);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // defined(NUCLEX_AUDIO_HAVE_NEON)
+
+  /// <summary>Selects the fastest dot product kernel the CPU supports</summary>
+  /// <returns>The dot product kernel the filter banks will use</returns>
+  float (*selectDotProduct())(const float *, const float *, std::size_t) {
+#if defined(NUCLEX_AUDIO_CAN_DISPATCH_AVX)
+    if(Nuclex::Audio::Processing::CpuFeatures::Get().HasFma) {
+      return &dotProductAvx2;
+    }
+#endif
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    return &dotProductSse2;
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    return &dotProductNeon;
+#else
+    return &dotProductScalar;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filter banks shared by all resamplers using the same ratio</summary>
+  struct FilterCache {
+
+    /// <summary>Must be held while the cached filter banks are accessed</summary>
+    public: std::mutex Mutex;
+    /// <summary>Filter banks indexed by their resampling factors and quality</summary>
+    public: std::map<
+      std::tuple<std::size_t, std::size_t, Nuclex::Audio::Processing::ResamplerQuality>,
+      std::weak_ptr<const Nuclex::Audio::Storage::Shared::PolyphaseFilter>
+    > Filters;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the process-wide cache of filter banks</summary>
+  /// <returns>The cache holding all filter banks currently in use</returns>
+  FilterCache &getFilterCache() {
+    static FilterCache cache;
+    return cache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const PolyphaseFilter> PolyphaseFilter::GetShared(
+    std::size_t upFactor, std::size_t downFactor,
+    Processing::ResamplerQuality quality /* = Processing::ResamplerQuality::Balanced */
+  ) {
+    FilterCache &cache = getFilterCache();
+    std::tuple<std::size_t, std::size_t, Processing::ResamplerQuality> key(
+      upFactor, downFactor, quality
+    );
+
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      auto iterator = cache.Filters.find(key);
+      if(iterator != cache.Filters.end()) {
+        std::shared_ptr<const PolyphaseFilter> filter = iterator->second.lock();
+        if(static_cast<bool>(filter)) {
+          return filter;
+        }
+      }
+    }
+
+    // Build the filter outside of the lock. If another thread built the same filter
+    // in the meantime, one of them just ends up being used a little shorter.
+    std::shared_ptr<const PolyphaseFilter> filter = (
+      std::make_shared<PolyphaseFilter>(upFactor, downFactor, quality)
+    );
+
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      // Drop cache entries whose filters are no longer used by anyone
+      for(auto iterator = cache.Filters.begin(); iterator != cache.Filters.end();) {
+        if(iterator->second.expired()) {
+          iterator = cache.Filters.erase(iterator);
+        } else {
+          ++iterator;
+        }
+      }
+
+      cache.Filters[key] = filter;
+    }
+
+    return filter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PolyphaseFilter::PolyphaseFilter(
+    std::size_t upFactor, std::size_t downFactor,
+    Processing::ResamplerQuality quality /* = Processing::ResamplerQuality::Balanced */
+  ) :
+    phaseCount(upFactor),
+    tapCount(0),
+    taps(),
+    dotProduct(selectDotProduct()) {
+
+    if(unlikely((upFactor == 0) || (downFactor == 0))) {
+      throw std::invalid_argument(u8"Resampling factors must not be zero");
+    }
+    if(unlikely(upFactor > MaximumPhaseCount)) {
+      throw std::invalid_argument(
+        u8"Resampling ratio is too fine, the filter bank would become too large"
+      );
+    }
+    if(unlikely(downFactor > upFactor * MaximumDecimation)) {
+      throw std::invalid_argument(u8"Resampling ratio lowers the sample rate too much");
+    }
+
+    std::size_t designIndex = static_cast<std::size_t>(quality);
+    if(unlikely(designIndex >= sizeof(FilterDesigns) / sizeof(FilterDesign))) {
+      throw std::invalid_argument(u8"Unknown resampler quality preset");
+    }
+
+    const FilterDesign &design = FilterDesigns[designIndex];
+    this->tapCount = design.BaseTapCount;
+
+    // When lowering the sample rate, the filter has to cut off below the output's
+    // Nyquist frequency, which takes proportionally more input samples
+    double bandwidth = 1.0;
+    if(downFactor > upFactor) {
+      bandwidth = static_cast<double>(upFactor) / static_cast<double>(downFactor);
+      this->tapCount = static_cast<std::size_t>(
+        std::ceil(static_cast<double>(design.BaseTapCount) / bandwidth)
+      );
+      this->tapCount = (this->tapCount + 3) & ~std::size_t(3);
+    }
+
+    // Cutoff frequency as a fraction of the input sample rate
+    double cutoff = 0.5 * bandwidth * design.CutoffFactor;
+    double halfLength = static_cast<double>(this->tapCount) / 2.0;
+    double leadingTapCount = static_cast<double>(GetLeadingTapCount());
+    double windowScale = 1.0 / besselI0(design.KaiserBeta);
+
+    this->taps.resize(this->phaseCount * this->tapCount);
+    for(std::size_t phase = 0; phase < this->phaseCount; ++phase) {
+      float *phaseTaps = this->taps.data() + (phase * this->tapCount);
+      double fraction = static_cast<double>(phase) / static_cast<double>(this->phaseCount);
+
+      double sum = 0.0;
+      for(std::size_t index = 0; index < this->tapCount; ++index) {
+        double time = static_cast<double>(index) + 1.0 - leadingTapCount - fraction;
+
+        double tap = 2.0 * cutoff;
+        if(time != 0.0) {
+          double angle = 2.0 * Pi * cutoff * time;
+          tap *= std::sin(angle) / angle;
+        }
+
+        double position = time / halfLength;
+        if((position <= -1.0) || (1.0 <= position)) {
+          tap = 0.0;
+        } else {
+          tap *= besselI0(design.KaiserBeta * std::sqrt(1.0 - position * position)) * windowScale;
+        }
+
+        phaseTaps[index] = static_cast<float>(tap);
+        sum += tap;
+      }
+
+      // Normalize each phase so a constant signal comes out at exactly the same level
+      // no matter what fractional position an output sample lands on
+      for(std::size_t index = 0; index < this->tapCount; ++index) {
+        phaseTaps[index] = static_cast<float>(static_cast<double>(phaseTaps[index]) / sum);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,118 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_POLYPHASEFILTER_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_POLYPHASEFILTER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Processing/Resampler.h" // for ResamplerQuality
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Low-pass filter bank for resampling by a rational factor</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Resampling by L/M conceptually inserts L - 1 zeros between input samples,
+  ///     low-pass filters the result and keeps every Mth sample. A polyphase filter skips
+  ///     the zeros: each output sample falls at one of L fractional positions (phases)
+  ///     between two input samples and is the dot product of the surrounding input samples
+  ///     with the windowed sinc taps precomputed for that phase.
+  ///   </para>
+  ///   <para>
+  ///     The taps are a Kaiser-windowed sinc with its cutoff just below the lower of both
+  ///     Nyquist frequencies. When downsampling, the filter gets proportionally longer
+  ///     to keep the same transition band in output terms. The quality preset decides
+  ///     the base number of taps, the window's shape and how close the cutoff gets.
+  ///   </para>
+  /// </remarks>
+  class PolyphaseFilter {
+
+    /// <summary>Returns a filter for the specified factors, sharing identical ones</summary>
+    /// <param name="upFactor">Factor by which the audio is upsampled (L)</param>
+    /// <param name="downFactor">Factor by which the upsampled audio is decimated (M)</param>
+    /// <param name="quality">Quality preset the filter bank will be designed for</param>
+    /// <returns>The filter bank for resampling by the specified factors</returns>
+    /// <remarks>
+    ///   Building a filter bank takes a while, so they are cached per ratio and quality
+    ///   for as long as at least one resampler is using them.
+    /// </remarks>
+    public: static std::shared_ptr<const PolyphaseFilter> GetShared(
+      std::size_t upFactor, std::size_t downFactor,
+      Processing::ResamplerQuality quality = Processing::ResamplerQuality::Balanced
+    );
+
+    /// <summary>Builds a new filter bank for resampling by the specified factors</summary>
+    /// <param name="upFactor">Factor by which the audio is upsampled (L)</param>
+    /// <param name="downFactor">Factor by which the upsampled audio is decimated (M)</param>
+    /// <param name="quality">Quality preset the filter bank will be designed for</param>
+    public: PolyphaseFilter(
+      std::size_t upFactor, std::size_t downFactor,
+      Processing::ResamplerQuality quality = Processing::ResamplerQuality::Balanced
+    );
+
+    /// <summary>Counts the number of fractional positions the filter has taps for</summary>
+    /// <returns>The number of phases in the filter bank</returns>
+    public: std::size_t CountPhases() const { return this->phaseCount; }
+
+    /// <summary>Counts the number of input samples each output sample is computed from</summary>
+    /// <returns>The number of taps in each phase, always a multiple of 4</returns>
+    public: std::size_t CountTaps() const { return this->tapCount; }
+
+    /// <summary>Counts the number of input samples before and including the center</summary>
+    /// <returns>The offset of the first tap relative to the input sample at the center</returns>
+    /// <remarks>
+    ///   For an output sample between the input samples i and i + 1, the first tap is
+    ///   multiplied with the input sample i + 1 - this value.
+    /// </remarks>
+    public: std::size_t GetLeadingTapCount() const { return this->tapCount / 2; }
+
+    /// <summary>Computes one output sample</summary>
+    /// <param name="input">Input sample at which the first tap is applied</param>
+    /// <param name="phase">Fractional position of the output sample, in 1/L units</param>
+    /// <returns>The filtered output sample</returns>
+    public: inline float Apply(const float *input, std::size_t phase) const;
+
+    /// <summary>Number of phases (L) in the filter bank</summary>
+    private: std::size_t phaseCount;
+    /// <summary>Number of taps in each phase</summary>
+    private: std::size_t tapCount;
+    /// <summary>Taps of all phases, one phase after another</summary>
+    private: std::vector<float> taps;
+    /// <summary>Multiplies input samples with taps and sums the products up</summary>
+    private: float (*dotProduct)(const float *, const float *, std::size_t);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline float PolyphaseFilter::Apply(const float *input, std::size_t phase) const {
+    return this->dotProduct(input, this->taps.data() + (phase * this->tapCount), this->tapCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_POLYPHASEFILTER_H
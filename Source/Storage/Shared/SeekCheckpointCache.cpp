@@ -0,0 +1,88 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./SeekCheckpointCache.h"
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCheckpointCache::SeekCheckpointCache(std::size_t capacity) :
+    capacity(capacity),
+    nextReplacementIndex(0),
+    checkpoints() {
+    this->checkpoints.reserve(capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SeekCheckpointCache::Remember(std::uint64_t frameIndex, std::uint64_t byteOffset) {
+    if(unlikely(this->capacity == 0)) {
+      return;
+    }
+
+    for(Checkpoint &checkpoint : this->checkpoints) {
+      if(checkpoint.ByteOffset == byteOffset) {
+        checkpoint.FrameIndex = frameIndex;
+        return;
+      }
+    }
+
+    if(this->checkpoints.size() < this->capacity) {
+      this->checkpoints.push_back(Checkpoint { frameIndex, byteOffset });
+    } else {
+      this->checkpoints[this->nextReplacementIndex] = Checkpoint { frameIndex, byteOffset };
+      this->nextReplacementIndex = (this->nextReplacementIndex + 1) % this->capacity;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<SeekCheckpointCache::Checkpoint> SeekCheckpointCache::TryFindCheckpoint(
+    std::uint64_t frameIndex
+  ) const {
+    const Checkpoint *closest = nullptr;
+    for(const Checkpoint &checkpoint : this->checkpoints) {
+      if(checkpoint.FrameIndex <= frameIndex) {
+        if((closest == nullptr) || (checkpoint.FrameIndex > closest->FrameIndex)) {
+          closest = &checkpoint;
+        }
+      }
+    }
+
+    if(closest == nullptr) {
+      return std::optional<Checkpoint>();
+    } else {
+      return *closest;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SeekCheckpointCache::Clear() {
+    this->nextReplacementIndex = 0;
+    this->checkpoints.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
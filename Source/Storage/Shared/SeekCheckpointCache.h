@@ -0,0 +1,105 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_SEEKCHECKPOINTCACHE_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_SEEKCHECKPOINTCACHE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <optional> // for std::optional
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Remembers a few recently visited points at which decoding can resume</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The Ogg seek index only grows while a file is decoded from the beginning, so
+  ///     it doesn't help if playback jumps ahead to a region the decoder hasn't visited
+  ///     in order. A reader records checkpoints (the file offset it read up to and the
+  ///     frame it reached there) while decoding. When it seeks close to one of these
+  ///     again, it can jump straight there instead of bisecting the file.
+  ///   </para>
+  ///   <para>
+  ///     The cache holds a fixed number of checkpoints. Once it is full, the oldest is
+  ///     replaced. It is owned by a single reader and is not thread-safe.
+  ///   </para>
+  /// </remarks>
+  class SeekCheckpointCache {
+
+    /// <summary>Point in the file at which decoding can resume</summary>
+    public: struct Checkpoint {
+
+      /// <summary>Frame the decoder resumes at, or a lower bound if not confirmed</summary>
+      public: std::uint64_t FrameIndex;
+      /// <summary>File offset the decoder should jump to</summary>
+      public: std::uint64_t ByteOffset;
+
+    };
+
+    /// <summary>Initializes a new, empty checkpoint cache</summary>
+    /// <param name="capacity">Maximum number of checkpoints the cache will hold</param>
+    public: SeekCheckpointCache(std::size_t capacity);
+
+    /// <summary>Frees all memory used by the checkpoint cache</summary>
+    public: ~SeekCheckpointCache() = default;
+
+    /// <summary>Records a checkpoint, replacing the oldest one if the cache is full</summary>
+    /// <param name="frameIndex">Frame at which decoding resumes from the offset</param>
+    /// <param name="byteOffset">File offset from which decoding can resume</param>
+    /// <remarks>
+    ///   If there already is a checkpoint for the same file offset, its frame index
+    ///   is updated instead. This is used to correct a lower bound once the reader
+    ///   has jumped to the offset and knows the exact frame it landed on.
+    /// </remarks>
+    public: void Remember(std::uint64_t frameIndex, std::uint64_t byteOffset);
+
+    /// <summary>Looks up the closest checkpoint before the specified frame</summary>
+    /// <param name="frameIndex">Frame that should be reached</param>
+    /// <returns>
+    ///   The checkpoint with the highest frame index not above the specified one or
+    ///   nothing if there is no such checkpoint
+    /// </returns>
+    public: std::optional<Checkpoint> TryFindCheckpoint(std::uint64_t frameIndex) const;
+
+    /// <summary>Forgets all checkpoints while keeping the memory allocated</summary>
+    public: void Clear();
+
+    /// <summary>Counts the number of checkpoints currently in the cache</summary>
+    /// <returns>The number of checkpoints stored in the cache</returns>
+    public: std::size_t CountCheckpoints() const { return this->checkpoints.size(); }
+
+    /// <summary>Maximum number of checkpoints the cache will hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Index of the checkpoint that will be replaced next</summary>
+    private: std::size_t nextReplacementIndex;
+    /// <summary>Checkpoints in no particular order</summary>
+    private: std::vector<Checkpoint> checkpoints;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_SEEKCHECKPOINTCACHE_H
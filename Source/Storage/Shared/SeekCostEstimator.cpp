@@ -0,0 +1,97 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./SeekCostEstimator.h"
+
+#include <algorithm> // for std::max()
+#include <cmath> // for std::ceil()
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCostEstimator::SeekCostEstimator(
+    std::uint64_t fileSize, std::uint64_t totalFrameCount, std::size_t blockSize
+  ) :
+    fileSize(fileSize),
+    totalFrameCount(totalFrameCount),
+    blockSize(std::max<std::size_t>(blockSize, 1)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost SeekCostEstimator::Continue() const {
+    return SeekCost { 0, 0, 0, true };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost SeekCostEstimator::Jump(
+    std::uint64_t landingFrame, std::uint64_t targetFrame, bool isPrecise /* = true */
+  ) const {
+    std::uint64_t discardedFrameCount = (
+      (landingFrame < targetFrame) ? (targetFrame - landingFrame) : 0
+    );
+    return SeekCost {
+      EstimateByteCount(discardedFrameCount), discardedFrameCount, 1, isPrecise
+    };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost SeekCostEstimator::Bisect(
+    std::uint64_t landingFrame, std::uint64_t targetFrame
+  ) const {
+
+    // Each step of the bisection halves the range of blocks that remain in question
+    // and the search ends when a single block is left
+    std::size_t stepCount = 1;
+    for(std::uint64_t blockCount = this->totalFrameCount / this->blockSize; blockCount > 1;) {
+      blockCount /= 2;
+      ++stepCount;
+    }
+
+    SeekCost cost = Jump(landingFrame, targetFrame, false);
+    cost.ByteCount += EstimateByteCount(this->blockSize) * stepCount;
+    cost.RandomAccessCount = stepCount;
+
+    return cost;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t SeekCostEstimator::EstimateByteCount(std::uint64_t frameCount) const {
+    if(this->totalFrameCount == 0) {
+      return 0;
+    }
+
+    // Calculated in floating point because frames times bytes can overflow 64 bits.
+    // Rounded up so that short distances in small files don't come out as free.
+    double byteCount = std::ceil(
+      static_cast<double>(frameCount) * static_cast<double>(this->fileSize) /
+      static_cast<double>(this->totalFrameCount)
+    );
+    return static_cast<std::uint64_t>(byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
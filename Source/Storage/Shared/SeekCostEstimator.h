@@ -0,0 +1,88 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHARED_SEEKCOSTESTIMATOR_H
+#define NUCLEX_AUDIO_STORAGE_SHARED_SEEKCOSTESTIMATOR_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/SeekCost.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns the seeking strategy a decoder would use into a cost estimate</summary>
+  /// <remarks>
+  ///   Decoders mirror the choices of their seek methods with calls to this estimator,
+  ///   so the costs reported by different codecs can be compared with each other.
+  /// </remarks>
+  class SeekCostEstimator {
+
+    /// <summary>Initializes a new seek cost estimator</summary>
+    /// <param name="fileSize">Size of the encoded file in bytes</param>
+    /// <param name="totalFrameCount">Number of frames in the whole track</param>
+    /// <param name="blockSize">Typical number of frames in one block of the codec</param>
+    public: SeekCostEstimator(
+      std::uint64_t fileSize, std::uint64_t totalFrameCount, std::size_t blockSize
+    );
+
+    /// <summary>Describes a decoder that is already positioned at the target frame</summary>
+    /// <returns>A seek cost of zero</returns>
+    public: SeekCost Continue() const;
+
+    /// <summary>Describes a jump to a known position followed by decoding forward</summary>
+    /// <param name="landingFrame">Index of the frame at which decoding resumes</param>
+    /// <param name="targetFrame">Index of the frame the caller wants to obtain</param>
+    /// <param name="isPrecise">Whether the landing frame is known exactly</param>
+    /// <returns>The estimated cost of the jump</returns>
+    public: SeekCost Jump(
+      std::uint64_t landingFrame, std::uint64_t targetFrame, bool isPrecise = true
+    ) const;
+
+    /// <summary>Describes a search of the file followed by decoding forward</summary>
+    /// <param name="landingFrame">Index of the frame at which decoding resumes</param>
+    /// <param name="targetFrame">Index of the frame the caller wants to obtain</param>
+    /// <returns>The estimated cost of the search</returns>
+    /// <remarks>
+    ///   Codec libraries search by bisection, reading about one block at each step.
+    /// </remarks>
+    public: SeekCost Bisect(std::uint64_t landingFrame, std::uint64_t targetFrame) const;
+
+    /// <summary>Estimates the number of bytes a range of frames occupies in the file</summary>
+    /// <param name="frameCount">Number of frames whose size will be estimated</param>
+    /// <returns>The estimated number of bytes, based on the average bitrate</returns>
+    public: std::uint64_t EstimateByteCount(std::uint64_t frameCount) const;
+
+    /// <summary>Size of the encoded file in bytes</summary>
+    private: std::uint64_t fileSize;
+    /// <summary>Number of frames in the whole track</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Typical number of frames in one block of the codec</summary>
+    private: std::size_t blockSize;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+#endif // NUCLEX_AUDIO_STORAGE_SHARED_SEEKCOSTESTIMATOR_H
@@ -29,6 +29,7 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  class SequentialSource;
   class VirtualFile;
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,394 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "SharedCachedTrackDecoder.h"
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Shared/DecodePathBuilder.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <type_traits> // for std::is_same<>
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Changes whenever the layout of the cached blocks changes</summary>
+  const std::uint64_t CacheFormatVersion = 1;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes a value into a 64 bit FNV-1a hash</summary>
+  /// <param name="hash">Hash the value will be mixed into</param>
+  /// <param name="value">Value that will be mixed into the hash</param>
+  /// <returns>The updated hash</returns>
+  std::uint64_t hashValue(std::uint64_t hash, std::uint64_t value) {
+    for(std::size_t index = 0; index < 8; ++index) {
+      hash ^= (value & 0xFF);
+      hash *= 0x100000001B3ULL;
+      value >>= 8;
+    }
+
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedCachedTrackDecoder::SharedCachedTrackDecoder(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::shared_ptr<SharedSampleCache> &cache,
+    const std::string &identity
+  ) :
+    decoder(decoder),
+    cache(cache),
+    identity(identity),
+    identityHash(0xCBF29CE484222325ULL),
+    cacheBlockFrameCount(0),
+    cacheMutex(),
+    blockScratch() {
+    if(!decoder) {
+      throw std::invalid_argument(u8"Shared-cached decoder requires a decoder to wrap");
+    }
+    if(!cache) {
+      throw std::invalid_argument(u8"Shared-cached decoder requires a shared sample cache");
+    }
+
+    // Blocks are sized to fill one slot of the cache
+    std::size_t channelCount = decoder->CountChannels();
+    this->cacheBlockFrameCount = cache->GetSlotSize() / (channelCount * sizeof(float));
+    if(this->cacheBlockFrameCount == 0) {
+      throw std::invalid_argument(u8"Slots of the shared sample cache can't hold a frame");
+    }
+
+    for(char character : identity) {
+      this->identityHash ^= static_cast<unsigned char>(character);
+      this->identityHash *= 0x100000001B3ULL;
+    }
+    this->identityHash = hashValue(this->identityHash, CacheFormatVersion);
+    this->identityHash = hashValue(this->identityHash, channelCount);
+    this->identityHash = hashValue(this->identityHash, decoder->CountFrames());
+    this->identityHash = hashValue(this->identityHash, this->cacheBlockFrameCount);
+
+    this->blockScratch.resize(this->cacheBlockFrameCount * channelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedCachedTrackDecoder::~SharedCachedTrackDecoder() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> SharedCachedTrackDecoder::Clone() const {
+    return std::make_shared<SharedCachedTrackDecoder>(
+      this->decoder->Clone(), this->cache, this->identity
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath SharedCachedTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    sampleFormat = Shared::DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+
+    // This describes reading a block that is already in the cache. Blocks that aren't
+    // are first decoded by the wrapped decoder, which is a one-time cost per block.
+    Shared::DecodePathBuilder builder(
+      u8"Shared memory cache", AudioSampleFormat::Float_32, u8"shared"
+    );
+    builder.SetZeroCopy();
+
+    bool isFloat = (sampleFormat == AudioSampleFormat::Float_32);
+    if(interleaved) {
+      builder.AddPass(isFloat ? u8"copy" : u8"convert");
+    } else if(isFloat) {
+      builder.AddPass(u8"separate");
+    } else {
+      builder.AddScratchBuffer().AddPass(u8"separate").AddPass(u8"convert");
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost SharedCachedTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::uint64_t blockIndex = targetFrame / this->cacheBlockFrameCount;
+
+    // Blocks that are in the cache are copied directly out of the shared memory
+    std::size_t byteCount = (
+      countBlockFrames(blockIndex) * this->decoder->CountChannels() * sizeof(float)
+    );
+    if(this->cache->contains(getBlockKey(blockIndex), byteCount)) {
+      return SeekCost { 0, 0, 0, true };
+    }
+
+    // Other blocks are decoded as a whole by the wrapped decoder before they're delivered
+    std::uint64_t blockStart = blockIndex * this->cacheBlockFrameCount;
+    SeekCost cost = this->decoder->EstimateSeekCost(blockStart);
+    cost.DiscardedFrameCount += targetFrame - blockStart;
+
+    return cost;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeInterleavedUint8(
+    std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeInterleavedInt16(
+    std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int16_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeInterleavedInt32(
+    std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<std::int32_t>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeInterleavedFloat(
+    float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<float>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeInterleavedDouble(
+    double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeInterleaved<double>(buffer, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeSeparatedUint8(
+    std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::uint8_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeSeparatedInt16(
+    std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int16_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeSeparatedInt32(
+    std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<std::int32_t>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeSeparatedFloat(
+    float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<float>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::DecodeSeparatedDouble(
+    double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+  ) const {
+    decodeSeparated<double>(buffers, startFrame, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void SharedCachedTrackDecoder::decodeInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t totalFrameCount = this->decoder->CountFrames();
+    if((startFrame > totalFrameCount) || (frameCount > totalFrameCount - startFrame)) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    while(frameCount > 0) {
+      std::uint64_t blockIndex = startFrame / this->cacheBlockFrameCount;
+      std::size_t offset = static_cast<std::size_t>(
+        startFrame - (blockIndex * this->cacheBlockFrameCount)
+      );
+      std::size_t chunkFrameCount = std::min(countBlockFrames(blockIndex) - offset, frameCount);
+
+      std::size_t slotIndex;
+      const float *samples = acquireBlock(blockIndex, slotIndex) + (offset * channelCount);
+      if constexpr(std::is_same<TSample, float>::value) {
+        std::copy_n(samples, chunkFrameCount * channelCount, buffer);
+      } else {
+        Processing::SampleConverter::Convert(
+          samples, 32, buffer, sizeof(TSample) * 8, chunkFrameCount * channelCount
+        );
+      }
+      releaseBlock(slotIndex);
+
+      buffer += chunkFrameCount * channelCount;
+      startFrame += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void SharedCachedTrackDecoder::decodeSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::uint64_t totalFrameCount = this->decoder->CountFrames();
+    if((startFrame > totalFrameCount) || (frameCount > totalFrameCount - startFrame)) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    std::size_t channelCount = this->decoder->CountChannels();
+
+    // Channels that need to be converted are gathered into a scratch buffer first,
+    // so that the converter can work on contiguous samples
+    std::vector<float> channelScratch;
+    if constexpr(!std::is_same<TSample, float>::value) {
+      channelScratch.resize(std::min<std::size_t>(frameCount, this->cacheBlockFrameCount));
+    }
+
+    std::lock_guard<std::mutex> cacheMutexScope(this->cacheMutex);
+    std::size_t targetOffset = 0;
+    while(targetOffset < frameCount) {
+      std::uint64_t blockIndex = startFrame / this->cacheBlockFrameCount;
+      std::size_t offset = static_cast<std::size_t>(
+        startFrame - (blockIndex * this->cacheBlockFrameCount)
+      );
+      std::size_t chunkFrameCount = std::min(
+        countBlockFrames(blockIndex) - offset, frameCount - targetOffset
+      );
+
+      std::size_t slotIndex;
+      const float *samples = acquireBlock(blockIndex, slotIndex) + (offset * channelCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        if(buffers[channelIndex] == nullptr) {
+          continue;
+        }
+
+        float *gathered;
+        if constexpr(std::is_same<TSample, float>::value) {
+          gathered = buffers[channelIndex] + targetOffset;
+        } else {
+          gathered = channelScratch.data();
+        }
+        for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+          gathered[frameIndex] = samples[frameIndex * channelCount + channelIndex];
+        }
+        if constexpr(!std::is_same<TSample, float>::value) {
+          Processing::SampleConverter::Convert(
+            gathered, 32, buffers[channelIndex] + targetOffset, sizeof(TSample) * 8,
+            chunkFrameCount
+          );
+        }
+      }
+      releaseBlock(slotIndex);
+
+      startFrame += chunkFrameCount;
+      targetOffset += chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const float *SharedCachedTrackDecoder::acquireBlock(
+    std::uint64_t blockIndex, std::size_t &slotIndex
+  ) const {
+    std::size_t frameCount = countBlockFrames(blockIndex);
+    std::size_t byteCount = frameCount * this->decoder->CountChannels() * sizeof(float);
+
+    // If this or another process decoded the block before, use it straight from the cache
+    std::uint64_t key = getBlockKey(blockIndex);
+    const std::byte *cached = this->cache->tryAcquire(key, byteCount, slotIndex);
+    if(cached != nullptr) {
+      return reinterpret_cast<const float *>(cached);
+    }
+
+    // The block isn't cached yet, so decode it and offer it to the cache
+    this->decoder->DecodeInterleaved(
+      this->blockScratch.data(), blockIndex * this->cacheBlockFrameCount, frameCount
+    );
+    this->cache->tryStore(
+      key, reinterpret_cast<const std::byte *>(this->blockScratch.data()), byteCount
+    );
+
+    slotIndex = NoSlot;
+    return this->blockScratch.data();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedCachedTrackDecoder::releaseBlock(std::size_t slotIndex) const {
+    if(slotIndex != NoSlot) {
+      this->cache->release(slotIndex);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t SharedCachedTrackDecoder::getBlockKey(std::uint64_t blockIndex) const {
+    std::uint64_t key = hashValue(this->identityHash, blockIndex);
+    return (key == 0) ? 1 : key; // Zero marks empty slots
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SharedCachedTrackDecoder::countBlockFrames(std::uint64_t blockIndex) const {
+    std::uint64_t blockStart = blockIndex * this->cacheBlockFrameCount;
+    return static_cast<std::size_t>(
+      std::min<std::uint64_t>(
+        this->cacheBlockFrameCount, this->decoder->CountFrames() - blockStart
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,319 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHAREDCACHEDTRACKDECODER_H
+#define NUCLEX_AUDIO_STORAGE_SHAREDCACHEDTRACKDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/SharedSampleCache.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Caches the decoded samples of another decoder in shared memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The track is split into cache blocks sized so that one block of interleaved
+  ///     float samples fills a slot of the shared sample cache. Each block is stored
+  ///     under a hash of the file identity, the track's shape and the block's index,
+  ///     so every process wrapping the same file finds the blocks the others decoded.
+  ///   </para>
+  ///   <para>
+  ///     Cached blocks are converted straight out of the shared memory while their
+  ///     slot is pinned, so looking up a block costs no more than a few atomic
+  ///     operations and the copy into the caller's buffer.
+  ///   </para>
+  /// </remarks>
+  class SharedCachedTrackDecoder : public AudioTrackDecoder {
+
+    /// <summary>Initializes a new shared-cached decoder using the specified decoder</summary>
+    /// <param name="decoder">Decoder whose output will be cached</param>
+    /// <param name="cache">Shared sample cache the decoded blocks will be stored in</param>
+    /// <param name="identity">Unique identity of the decoded file's contents</param>
+    public: SharedCachedTrackDecoder(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      const std::shared_ptr<SharedSampleCache> &cache,
+      const std::string &identity
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~SharedCachedTrackDecoder() override;
+
+    /// <summary>Creates a clone of the audio track decoder</summary>
+    /// <returns>A clone of the audio track decoder that can be used independently</returns>
+    public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override {
+      return this->decoder->CountChannels();
+    }
+
+    /// <summary>Retrieves the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->decoder->GetChannelOrder();
+    }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const override {
+      return this->decoder->CountFrames();
+    }
+
+    /// <summary>Returns the format in which samples are obtained from the codec</summary>
+    /// <returns>The format in which the audio samples are delivered by the codec</returns>
+    public: AudioSampleFormat GetNativeSampleFormat() const override {
+      return this->decoder->GetNativeSampleFormat();
+    }
+
+    /// <summary>Whether the audio codec directly decodes to interleaved channels</summary>
+    /// <returns>Always true, cache blocks store interleaved samples</returns>
+    public: bool IsNativelyInterleaved() const override { return true; }
+
+    /// <summary>Determines where the native block containing a frame begins</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The index of the first frame in the block containing the frame</returns>
+    public: std::uint64_t GetBlockStart(std::uint64_t frameIndex) const override {
+      return this->decoder->GetBlockStart(frameIndex);
+    }
+
+    /// <summary>Determines the length of the native block containing a frame</summary>
+    /// <param name="frameIndex">Index of the frame whose block will be looked up</param>
+    /// <returns>The number of frames in the block containing the frame</returns>
+    public: std::size_t GetBlockSize(std::uint64_t frameIndex) const override {
+      return this->decoder->GetBlockSize(frameIndex);
+    }
+
+    /// <summary>Builds the complete seek index for formats that need one</summary>
+    public: void BuildSeekIndex() const override {
+      this->decoder->BuildSeekIndex();
+    }
+
+    /// <summary>Stores the seek index in a form that can be saved by the caller</summary>
+    /// <returns>The serialized seek index or an empty vector if there is none</returns>
+    public: std::vector<std::byte> SaveSeekIndex() const override {
+      return this->decoder->SaveSeekIndex();
+    }
+
+    /// <summary>Restores a seek index previously obtained via SaveSeekIndex()</summary>
+    /// <param name="serializedSeekIndex">Seek index returned by SaveSeekIndex()</param>
+    public: void LoadSeekIndex(
+      const std::vector<std::byte> &serializedSeekIndex
+    ) const override {
+      this->decoder->LoadSeekIndex(serializedSeekIndex);
+    }
+
+    /// <summary>Lets seeks skip the pre-roll that some codecs need for exact output</summary>
+    /// <param name="allow">Whether the decoder may skip the pre-roll when seeking</param>
+    public: void AllowFastSeeking(bool allow) const override {
+      this->decoder->AllowFastSeeking(allow);
+    }
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override {
+      this->decoder->EnableStatistics(enable);
+    }
+
+    /// <summary>Retrieves the statistics the wrapped decoder has collected so far</summary>
+    /// <returns>The current values of the wrapped decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override {
+      return this->decoder->GetStatistics();
+    }
+
+    /// <summary>Retrieves the wrapped decoder's distribution of decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each of the wrapped decoder's calls took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override {
+      return this->decoder->GetDecodeLatencies(reset);
+    }
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedUint8(
+      std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt16(
+      std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedInt32(
+      std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedFloat(
+      float *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeInterleavedDouble(
+      double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedUint8(
+      std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt16(
+      std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedInt32(
+      std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedFloat(
+      float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Decodes audio channels, separated, into the target buffers</summary>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    protected: void DecodeSeparatedDouble(
+      double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
+    ) const override;
+
+    /// <summary>Delivers cached or freshly decoded frames, interleaved</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeInterleaved(
+      TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Delivers cached or freshly decoded channels, separated</summary>
+    /// <typeparam name="TSample">Type of samples that will be delivered</typeparam>
+    /// <param name="buffers">Buffers in which the channels will be stored</param>
+    /// <param name="startFrame">Index of the first frame to decode</param>
+    /// <param name="frameCount">Number of audio frames that will be decoded</param>
+    private: template<typename TSample>
+    void decodeSeparated(
+      TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+    ) const;
+
+    /// <summary>Provides the samples of a cache block, decoding it if necessary</summary>
+    /// <param name="blockIndex">Index of the cache block that will be provided</param>
+    /// <param name="slotIndex">
+    ///   Receives the index of the pinned cache slot holding the samples or
+    ///   <see cref="NoSlot" /> if the samples live in the block scratch buffer
+    /// </param>
+    /// <returns>The interleaved float samples of the whole cache block</returns>
+    /// <remarks>
+    ///   If a slot was pinned, it must be released via <see cref="releaseBlock" />.
+    ///   The cache mutex must be held by the caller.
+    /// </remarks>
+    private: const float *acquireBlock(std::uint64_t blockIndex, std::size_t &slotIndex) const;
+
+    /// <summary>Releases a cache slot pinned by <see cref="acquireBlock" /></summary>
+    /// <param name="slotIndex">Index of the pinned slot or NoSlot</param>
+    private: void releaseBlock(std::size_t slotIndex) const;
+
+    /// <summary>Calculates the key under which a cache block is stored</summary>
+    /// <param name="blockIndex">Index of the cache block whose key will be calculated</param>
+    /// <returns>The key of the cache block in the shared sample cache</returns>
+    private: std::uint64_t getBlockKey(std::uint64_t blockIndex) const;
+
+    /// <summary>Counts the frames in the specified cache block</summary>
+    /// <param name="blockIndex">Index of the cache block whose frames will be counted</param>
+    /// <returns>The number of frames in the cache block</returns>
+    private: std::size_t countBlockFrames(std::uint64_t blockIndex) const;
+
+    /// <summary>Slot index reported when a block wasn't taken from the cache</summary>
+    private: static constexpr std::size_t NoSlot = static_cast<std::size_t>(-1);
+
+    /// <summary>Decoder whose output is being cached</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Shared sample cache the decoded blocks are stored in</summary>
+    private: std::shared_ptr<SharedSampleCache> cache;
+    /// <summary>Identity of the decoded file's contents</summary>
+    private: std::string identity;
+    /// <summary>Hash of the identity and the track's shape, mixed into all block keys</summary>
+    private: std::uint64_t identityHash;
+    /// <summary>Number of frames stored in each cache block</summary>
+    private: std::size_t cacheBlockFrameCount;
+    /// <summary>Must be held while accessing the scratch buffer</summary>
+    private: mutable std::mutex cacheMutex;
+    /// <summary>Holds cache blocks that had to be decoded</summary>
+    private: mutable SampleVector<float> blockScratch;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SHAREDCACHEDTRACKDECODER_H
@@ -0,0 +1,176 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "SharedMemoryRegion.h"
+
+#if !defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "../Platform/PosixApi.h" // for PosixApi::ThrowExceptionForSystemError()
+
+#include <cerrno> // for errno, EEXIST
+#include <chrono> // for std::chrono::milliseconds
+#include <thread> // for std::this_thread::sleep_for()
+
+#include <fcntl.h> // for O_CREAT, O_EXCL, O_RDWR
+#include <sys/mman.h> // for ::shm_open(), ::mmap(), ::munmap()
+#include <sys/stat.h> // for ::fstat()
+#include <unistd.h> // for ::ftruncate(), ::close()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a region name into the name of a Posix shared memory object</summary>
+  /// <param name="name">Name of the region</param>
+  /// <returns>The name under which the shared memory object is opened</returns>
+  std::string getObjectName(const std::string &name) {
+    std::string objectName(u8"/");
+    objectName.append(name);
+    for(std::size_t index = 1; index < objectName.length(); ++index) {
+      if((objectName[index] == '/') || (objectName[index] == '\\')) {
+        objectName[index] = '_';
+      }
+    }
+
+    return objectName;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Waits for the creator of a shared memory object to give it its size</summary>
+  /// <param name="fileDescriptor">File descriptor of the shared memory object</param>
+  /// <returns>The size of the shared memory object</returns>
+  std::size_t waitForSize(int fileDescriptor) {
+    for(std::size_t attempt = 0; attempt < 1000; ++attempt) {
+      struct ::stat status;
+      int result = ::fstat(fileDescriptor, &status);
+      if(unlikely(result == -1)) {
+        int errorNumber = errno;
+        Nuclex::Audio::Platform::PosixApi::ThrowExceptionForSystemError(
+          u8"Could not query size of shared memory object", errorNumber
+        );
+      }
+      if(status.st_size > 0) {
+        return static_cast<std::size_t>(status.st_size);
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    Nuclex::Audio::Platform::PosixApi::ThrowExceptionForSystemError(
+      u8"Shared memory object was never given a size by its creator", ETIMEDOUT
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::OpenOrCreate(
+    const std::string &name, std::size_t size, bool &created
+  ) {
+    std::string objectName = getObjectName(name);
+
+    // Try to create the object first so that exactly one process gets to size it
+    int fileDescriptor = ::shm_open(objectName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    created = (fileDescriptor != -1);
+    if(created) {
+      int result = ::ftruncate(fileDescriptor, static_cast<::off_t>(size));
+      if(unlikely(result == -1)) {
+        int errorNumber = errno;
+        ::close(fileDescriptor);
+        ::shm_unlink(objectName.c_str());
+        Platform::PosixApi::ThrowExceptionForSystemError(
+          u8"Could not set size of shared memory object", errorNumber
+        );
+      }
+    } else {
+      int errorNumber = errno;
+      if(unlikely(errorNumber != EEXIST)) {
+        Platform::PosixApi::ThrowExceptionForSystemError(
+          u8"Could not create shared memory object", errorNumber
+        );
+      }
+
+      fileDescriptor = ::shm_open(objectName.c_str(), O_RDWR, 0600);
+      if(unlikely(fileDescriptor == -1)) {
+        errorNumber = errno;
+        Platform::PosixApi::ThrowExceptionForSystemError(
+          u8"Could not open shared memory object", errorNumber
+        );
+      }
+      try {
+        size = waitForSize(fileDescriptor);
+      }
+      catch(const std::exception &) {
+        ::close(fileDescriptor);
+        throw;
+      }
+    }
+
+    // The mapping keeps the object alive, so the descriptor isn't needed anymore
+    void *memory = ::mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0
+    );
+    int errorNumber = errno;
+    ::close(fileDescriptor);
+    if(unlikely(memory == MAP_FAILED)) {
+      Platform::PosixApi::ThrowExceptionForSystemError(
+        u8"Could not map shared memory object", errorNumber
+      );
+    }
+
+    return std::unique_ptr<SharedMemoryRegion>(
+      new SharedMemoryRegion(static_cast<std::byte *>(memory), size, nullptr)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedMemoryRegion::Remove(const std::string &name) {
+    ::shm_unlink(getObjectName(name).c_str());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedMemoryRegion::SharedMemoryRegion(
+    std::byte *memory, std::size_t size, void *mappingHandle
+  ) :
+    memory(memory),
+    size(size),
+    mappingHandle(mappingHandle) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedMemoryRegion::~SharedMemoryRegion() {
+    ::munmap(this->memory, this->size);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // !defined(NUCLEX_AUDIO_WINDOWS)
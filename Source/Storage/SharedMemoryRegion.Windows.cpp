@@ -0,0 +1,129 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "SharedMemoryRegion.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "../Platform/WindowsApi.h" // for WindowsApi::ThrowExceptionForSystemError()
+
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include <cassert> // for assert()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a region name into the name of a Windows file mapping</summary>
+  /// <param name="name">Name of the region</param>
+  /// <returns>The name under which the file mapping is opened</returns>
+  std::wstring getObjectName(const std::string &name) {
+    std::string objectName(u8"Local\\NuclexAudio-");
+    objectName.append(name);
+    for(std::size_t index = 6; index < objectName.length(); ++index) {
+      if((objectName[index] == '/') || (objectName[index] == '\\')) {
+        objectName[index] = '_';
+      }
+    }
+
+    return Nuclex::Support::Text::StringConverter::WideFromUtf8(objectName);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::OpenOrCreate(
+    const std::string &name, std::size_t size, bool &created
+  ) {
+    std::uint64_t size64 = static_cast<std::uint64_t>(size);
+    HANDLE mappingHandle = ::CreateFileMappingW(
+      INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64),
+      getObjectName(name).c_str()
+    );
+    if(unlikely(mappingHandle == nullptr)) {
+      DWORD errorCode = ::GetLastError();
+      Platform::WindowsApi::ThrowExceptionForSystemError(
+        u8"Could not create or open named file mapping", errorCode
+      );
+    }
+    created = (::GetLastError() != ERROR_ALREADY_EXISTS);
+
+    // An existing mapping keeps the size it was created with, mapping the whole
+    // section and asking for the size of the view is the only way to find it
+    LPVOID memory = ::MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if(unlikely(memory == nullptr)) {
+      DWORD errorCode = ::GetLastError();
+      ::CloseHandle(mappingHandle);
+      Platform::WindowsApi::ThrowExceptionForSystemError(
+        u8"Could not map named file mapping", errorCode
+      );
+    }
+    if(!created) {
+      MEMORY_BASIC_INFORMATION information;
+      ::VirtualQuery(memory, &information, sizeof(information));
+      size = static_cast<std::size_t>(information.RegionSize);
+    }
+
+    return std::unique_ptr<SharedMemoryRegion>(
+      new SharedMemoryRegion(static_cast<std::byte *>(memory), size, mappingHandle)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedMemoryRegion::Remove(const std::string &name) {
+    (void)name; // Named file mappings vanish with their last handle
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedMemoryRegion::SharedMemoryRegion(
+    std::byte *memory, std::size_t size, void *mappingHandle
+  ) :
+    memory(memory),
+    size(size),
+    mappingHandle(mappingHandle) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedMemoryRegion::~SharedMemoryRegion() {
+    BOOL result = ::UnmapViewOfFile(this->memory);
+    NUCLEX_AUDIO_NDEBUG_UNUSED(result);
+    assert((result != FALSE) && u8"Shared memory view is unmapped successfully");
+
+    result = ::CloseHandle(static_cast<HANDLE>(this->mappingHandle));
+    NUCLEX_AUDIO_NDEBUG_UNUSED(result);
+    assert((result != FALSE) && u8"File mapping handle is closed successfully");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_WINDOWS)
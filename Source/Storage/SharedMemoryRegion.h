@@ -0,0 +1,97 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SHAREDMEMORYREGION_H
+#define NUCLEX_AUDIO_STORAGE_SHAREDMEMORYREGION_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::byte, std::size_t
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Named block of memory that several processes can map at once</summary>
+  /// <remarks>
+  ///   <para>
+  ///     On Posix systems, this is a shared memory object created via shm_open(), on
+  ///     Windows it is a named file mapping backed by the page file. Either way, the
+  ///     memory starts out zeroed and lives on until the last process unmaps it (or, on
+  ///     Posix systems, until <see cref="Remove" /> is called and all mappings are gone).
+  ///   </para>
+  ///   <para>
+  ///     The first process to open a region decides its size. Processes opening the
+  ///     region afterwards get the size it was created with.
+  ///   </para>
+  /// </remarks>
+  class SharedMemoryRegion {
+
+    /// <summary>Opens the named region or creates it if it doesn't exist yet</summary>
+    /// <param name="name">Name of the region, no slashes or backslashes</param>
+    /// <param name="size">Size the region will have if it is created</param>
+    /// <param name="created">Receives whether the region was created by this call</param>
+    /// <returns>The mapped region</returns>
+    public: static std::unique_ptr<SharedMemoryRegion> OpenOrCreate(
+      const std::string &name, std::size_t size, bool &created
+    );
+
+    /// <summary>Removes the name of a region so that the next open creates a new one</summary>
+    /// <param name="name">Name of the region that will be removed</param>
+    /// <remarks>
+    ///   Processes that still have the region mapped keep using it. On Windows, where
+    ///   named mappings disappear with the last handle, this does nothing.
+    /// </remarks>
+    public: static void Remove(const std::string &name);
+
+    /// <summary>Unmaps the region from the process</summary>
+    public: ~SharedMemoryRegion();
+
+    /// <summary>Returns the address at which the region is mapped</summary>
+    /// <returns>The address of the region's first byte</returns>
+    public: std::byte *GetMemory() const { return this->memory; }
+
+    /// <summary>Returns the size of the region</summary>
+    /// <returns>The size of the region in bytes</returns>
+    public: std::size_t GetSize() const { return this->size; }
+
+    /// <summary>Initializes a new shared memory region from an existing mapping</summary>
+    /// <param name="memory">Address at which the region has been mapped</param>
+    /// <param name="size">Size of the mapped region in bytes</param>
+    /// <param name="mappingHandle">
+    ///   Handle of the named file mapping on Windows, unused on other systems
+    /// </param>
+    private: SharedMemoryRegion(std::byte *memory, std::size_t size, void *mappingHandle);
+
+    /// <summary>Address at which the region is mapped</summary>
+    private: std::byte *memory;
+    /// <summary>Size of the mapped region in bytes</summary>
+    private: std::size_t size;
+    /// <summary>Handle that keeps the name of a Windows file mapping alive</summary>
+    private: void *mappingHandle;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SHAREDMEMORYREGION_H
@@ -0,0 +1,399 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SharedSampleCache.h"
+
+#include "SharedMemoryRegion.h"
+
+#include <chrono> // for std::chrono::milliseconds
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+#include <thread> // for std::this_thread::sleep_for()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a shared memory region as a shared sample cache</summary>
+  const std::uint64_t CacheMagic = 0x4348534455415846ULL; // 'FXAUDSHC'
+
+  /// <summary>Changes whenever the layout of the shared memory region changes</summary>
+  const std::uint32_t CacheLayoutVersion = 1;
+
+  /// <summary>Value of the header's state once the creator has set up the region</summary>
+  const std::uint32_t ReadyState = 1;
+
+  /// <summary>Bit in a slot's control word that is set while the slot is written</summary>
+  const std::uint32_t WriterBit = 0x80000000U;
+
+  /// <summary>Number of consecutive slots a block may be stored in</summary>
+  /// <remarks>
+  ///   Each key maps to a home slot and may also go into the slots that follow it.
+  ///   This keeps lookups to a handful of cache lines while still giving eviction
+  ///   a choice between several slots.
+  /// </remarks>
+  const std::size_t ProbeCount = 8;
+
+  /// <summary>Alignment of the slots' data in the shared memory region</summary>
+  const std::size_t DataAlignment = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Header at the beginning of the shared memory region</summary>
+  struct RegionHeader {
+
+    /// <summary>Identifies the region as a shared sample cache</summary>
+    public: std::uint64_t Magic;
+    /// <summary>Set to the ready state when the creator has filled in the header</summary>
+    public: std::atomic<std::uint32_t> State;
+    /// <summary>Version of the region's layout</summary>
+    public: std::uint32_t Version;
+    /// <summary>Number of bytes each slot can hold</summary>
+    public: std::uint64_t SlotSize;
+    /// <summary>Number of slots in the region</summary>
+    public: std::uint64_t SlotCount;
+    /// <summary>Offset of the first slot's data from the start of the region</summary>
+    public: std::uint64_t DataOffset;
+    /// <summary>Advanced on every access, orders the slots by their last use</summary>
+    public: std::atomic<std::uint64_t> Clock;
+    /// <summary>Pads the header to a full cache line</summary>
+    public: std::uint64_t Reserved[2];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Directory entry describing one slot of the cache</summary>
+  struct SlotEntry {
+
+    /// <summary>Key of the block stored in the slot, zero if the slot is empty</summary>
+    public: std::atomic<std::uint64_t> Key;
+    /// <summary>Value of the clock when the slot was last used</summary>
+    public: std::atomic<std::uint64_t> LastUse;
+    /// <summary>Number of readers in the lower bits, the writer bit in the highest</summary>
+    public: std::atomic<std::uint32_t> Control;
+    /// <summary>Number of bytes stored in the slot</summary>
+    public: std::uint32_t ByteCount;
+    /// <summary>Pads the entry to a power of two</summary>
+    public: std::uint64_t Reserved;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  // Other processes may have been compiled with a different standard library, so the
+  // atomics in the shared region must work without any lock living in the process
+  static_assert(
+    std::atomic<std::uint64_t>::is_always_lock_free &&
+    std::atomic<std::uint32_t>::is_always_lock_free,
+    u8"Atomics in shared memory need to be lock-free"
+  );
+  static_assert(sizeof(RegionHeader) == 64, u8"Region header fills one cache line");
+  static_assert(sizeof(SlotEntry) == 32, u8"Slot entries are 32 bytes long");
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the header of a shared sample cache's region</summary>
+  /// <param name="memory">Start of the shared memory region</param>
+  /// <returns>The header of the shared sample cache</returns>
+  RegionHeader &getHeader(std::byte *memory) {
+    return *reinterpret_cast<RegionHeader *>(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns a directory entry of a shared sample cache's region</summary>
+  /// <param name="memory">Start of the shared memory region</param>
+  /// <param name="slotIndex">Index of the slot whose entry will be returned</param>
+  /// <returns>The directory entry for the slot</returns>
+  SlotEntry &getEntry(std::byte *memory, std::size_t slotIndex) {
+    return reinterpret_cast<SlotEntry *>(memory + sizeof(RegionHeader))[slotIndex];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the address of a slot's data in a shared sample cache's region</summary>
+  /// <param name="memory">Start of the shared memory region</param>
+  /// <param name="slotIndex">Index of the slot whose data will be returned</param>
+  /// <returns>The address of the slot's data</returns>
+  std::byte *getSlotData(std::byte *memory, std::size_t slotIndex) {
+    const RegionHeader &header = getHeader(memory);
+    return memory + header.DataOffset + (slotIndex * header.SlotSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the offset of the slot data behind the directory</summary>
+  /// <param name="slotCount">Number of slots the directory has entries for</param>
+  /// <returns>The offset of the first slot's data</returns>
+  std::size_t getDataOffset(std::size_t slotCount) {
+    std::size_t directoryEnd = sizeof(RegionHeader) + (slotCount * sizeof(SlotEntry));
+    return (directoryEnd + DataAlignment - 1) / DataAlignment * DataAlignment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<SharedSampleCache> SharedSampleCache::Open(
+    const std::string &name,
+    std::size_t capacity /* = 67108864 */,
+    std::size_t slotSize /* = 262144 */
+  ) {
+    if(name.empty()) {
+      throw std::invalid_argument(u8"Shared sample cache needs a name");
+    }
+
+    // Slots are padded to cache lines so no two slots share one
+    slotSize = (slotSize + 63) / 64 * 64;
+    if(slotSize == 0) {
+      throw std::invalid_argument(u8"Slots of the shared sample cache must not be empty");
+    }
+    std::size_t slotCount = capacity / (slotSize + sizeof(SlotEntry));
+    while((slotCount > 0) && (getDataOffset(slotCount) + (slotCount * slotSize) > capacity)) {
+      --slotCount;
+    }
+    if(slotCount == 0) {
+      throw std::invalid_argument(u8"Shared sample cache is too small for a single slot");
+    }
+
+    bool created;
+    std::unique_ptr<SharedMemoryRegion> region = SharedMemoryRegion::OpenOrCreate(
+      name, getDataOffset(slotCount) + (slotCount * slotSize), created
+    );
+
+    // The creator fills in the header, all others wait until it's done and then
+    // check whether the region really is a shared sample cache they understand
+    RegionHeader &header = getHeader(region->GetMemory());
+    if(created) {
+      header.Magic = CacheMagic;
+      header.Version = CacheLayoutVersion;
+      header.SlotSize = slotSize;
+      header.SlotCount = slotCount;
+      header.DataOffset = getDataOffset(slotCount);
+      header.Clock.store(0, std::memory_order_relaxed);
+      header.State.store(ReadyState, std::memory_order_release);
+    } else {
+      std::size_t attempt = 0;
+      while(header.State.load(std::memory_order_acquire) != ReadyState) {
+        if(++attempt >= 1000) {
+          throw std::runtime_error(u8"Shared sample cache was never set up by its creator");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      bool isCompatible = (
+        (header.Magic == CacheMagic) &&
+        (header.Version == CacheLayoutVersion) &&
+        (header.SlotCount > 0) &&
+        (header.DataOffset >= getDataOffset(static_cast<std::size_t>(header.SlotCount))) &&
+        (header.DataOffset + (header.SlotCount * header.SlotSize) <= region->GetSize())
+      );
+      if(!isCompatible) {
+        throw std::runtime_error(
+          u8"Shared memory region is not a shared sample cache of a compatible version"
+        );
+      }
+    }
+
+    return std::shared_ptr<SharedSampleCache>(new SharedSampleCache(std::move(region)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedSampleCache::Remove(const std::string &name) {
+    SharedMemoryRegion::Remove(name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedSampleCache::SharedSampleCache(std::unique_ptr<SharedMemoryRegion> &&region) :
+    region(std::move(region)),
+    hitCount(0),
+    missCount(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SharedSampleCache::~SharedSampleCache() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SharedSampleCache::GetSlotSize() const {
+    return static_cast<std::size_t>(getHeader(this->region->GetMemory()).SlotSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SharedSampleCache::CountSlots() const {
+    return static_cast<std::size_t>(getHeader(this->region->GetMemory()).SlotCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool SharedSampleCache::contains(std::uint64_t key, std::size_t byteCount) const {
+    std::byte *memory = this->region->GetMemory();
+    std::size_t slotCount = static_cast<std::size_t>(getHeader(memory).SlotCount);
+
+    std::size_t homeSlotIndex = static_cast<std::size_t>(key % slotCount);
+    for(std::size_t probe = 0; probe < ProbeCount; ++probe) {
+      SlotEntry &entry = getEntry(memory, (homeSlotIndex + probe) % slotCount);
+      bool isMatch = (
+        (entry.Key.load(std::memory_order_acquire) == key) &&
+        ((entry.Control.load(std::memory_order_relaxed) & WriterBit) == 0) &&
+        (entry.ByteCount == byteCount)
+      );
+      if(isMatch) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *SharedSampleCache::tryAcquire(
+    std::uint64_t key, std::size_t byteCount, std::size_t &slotIndex
+  ) {
+    std::byte *memory = this->region->GetMemory();
+    RegionHeader &header = getHeader(memory);
+    std::size_t slotCount = static_cast<std::size_t>(header.SlotCount);
+
+    std::size_t homeSlotIndex = static_cast<std::size_t>(key % slotCount);
+    for(std::size_t probe = 0; probe < ProbeCount; ++probe) {
+      std::size_t index = (homeSlotIndex + probe) % slotCount;
+      SlotEntry &entry = getEntry(memory, index);
+      if(entry.Key.load(std::memory_order_acquire) != key) {
+        continue;
+      }
+
+      // Register as a reader unless a writer is replacing the slot right now
+      std::uint32_t control = entry.Control.load(std::memory_order_relaxed);
+      bool isPinned = false;
+      while((control & WriterBit) == 0) {
+        isPinned = entry.Control.compare_exchange_weak(
+          control, control + 1, std::memory_order_acquire, std::memory_order_relaxed
+        );
+        if(isPinned) {
+          break;
+        }
+      }
+      if(!isPinned) {
+        continue;
+      }
+
+      // The slot may have been replaced between checking its key and pinning it
+      bool isMatch = (
+        (entry.Key.load(std::memory_order_relaxed) == key) &&
+        (entry.ByteCount == byteCount)
+      );
+      if(!isMatch) {
+        entry.Control.fetch_sub(1, std::memory_order_release);
+        continue;
+      }
+
+      entry.LastUse.store(
+        header.Clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed
+      );
+      this->hitCount.fetch_add(1, std::memory_order_relaxed);
+      slotIndex = index;
+      return getSlotData(memory, index);
+    }
+
+    this->missCount.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedSampleCache::release(std::size_t slotIndex) {
+    getEntry(this->region->GetMemory(), slotIndex).Control.fetch_sub(
+      1, std::memory_order_release
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SharedSampleCache::tryStore(
+    std::uint64_t key, const std::byte *data, std::size_t byteCount
+  ) {
+    std::byte *memory = this->region->GetMemory();
+    RegionHeader &header = getHeader(memory);
+    if(byteCount > header.SlotSize) {
+      return;
+    }
+
+    // Pick an empty slot if there is one, otherwise the least recently used slot
+    // that isn't being read. If another process stored the block meanwhile, we're done.
+    std::size_t slotCount = static_cast<std::size_t>(header.SlotCount);
+    std::size_t homeSlotIndex = static_cast<std::size_t>(key % slotCount);
+    std::size_t victimIndex = slotCount;
+    std::uint64_t victimLastUse = 0;
+    for(std::size_t probe = 0; probe < ProbeCount; ++probe) {
+      std::size_t index = (homeSlotIndex + probe) % slotCount;
+      SlotEntry &entry = getEntry(memory, index);
+
+      std::uint64_t slotKey = entry.Key.load(std::memory_order_relaxed);
+      if(slotKey == key) {
+        return;
+      }
+      if(entry.Control.load(std::memory_order_relaxed) != 0) {
+        continue;
+      }
+
+      std::uint64_t lastUse = (slotKey == 0) ? 0 : entry.LastUse.load(std::memory_order_relaxed);
+      if((victimIndex == slotCount) || (lastUse < victimLastUse)) {
+        victimIndex = index;
+        victimLastUse = lastUse;
+      }
+    }
+    if(victimIndex == slotCount) {
+      return; // All candidate slots are in use
+    }
+
+    // Claim the slot. This fails if a reader pinned it or a writer claimed it since.
+    SlotEntry &victim = getEntry(memory, victimIndex);
+    std::uint32_t expected = 0;
+    bool isClaimed = victim.Control.compare_exchange_strong(
+      expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed
+    );
+    if(!isClaimed) {
+      return;
+    }
+
+    victim.Key.store(0, std::memory_order_relaxed);
+    std::memcpy(getSlotData(memory, victimIndex), data, byteCount);
+    victim.ByteCount = static_cast<std::uint32_t>(byteCount);
+    victim.LastUse.store(
+      header.Clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed
+    );
+    victim.Key.store(key, std::memory_order_release);
+    victim.Control.store(0, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
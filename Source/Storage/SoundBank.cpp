@@ -0,0 +1,474 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SoundBank.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "BinarySerialization.h" // for BinaryWriter, BinaryReader
+#include "./EndianReader.h" // for LittleEndianReader
+
+#include <algorithm> // for std::equal()
+#include <cstring> // for std::memcmp()
+#include <iterator> // for std::begin(), std::end()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a file as a sound bank</summary>
+  const std::byte FileSignature[] = {
+    std::byte(u8'N'), std::byte(u8'S'), std::byte(u8'B'), std::byte(u8'K')
+  };
+
+  /// <summary>Version of the sound bank's layout, bumped whenever it changes</summary>
+  const std::uint32_t FileVersion = 3;
+
+  /// <summary>Size of the header preceding the clip directory</summary>
+  /// <remarks>
+  ///   Signature, version, number of hash table slots, number of clips and
+  ///   the length of the table of contents that ends where the clip data begins.
+  /// </remarks>
+  const std::size_t HeaderByteCount = 4 + 4 + 8 + 8 + 8;
+
+  /// <summary>Size of a single entry in the clip directory</summary>
+  /// <remarks>
+  ///   Each entry holds the offset of a clip's record, in the order the clips were added.
+  /// </remarks>
+  const std::size_t DirectoryEntryByteCount = 8;
+
+  /// <summary>Size of a single slot in the hash table</summary>
+  /// <remarks>
+  ///   Each slot holds the hash of a clip name and the clip's index plus one, 0 if empty.
+  /// </remarks>
+  const std::size_t SlotByteCount = 8 + 8;
+
+  /// <summary>Boundary the encoded clips are aligned to within the bank</summary>
+  const std::size_t ClipAlignment = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the hash by which a clip is looked up in the sound bank</summary>
+  /// <param name="name">Name whose hash will be calculated</param>
+  /// <returns>The 64-bit FNV-1a hash of the name</returns>
+  /// <remarks>
+  ///   The hash is part of the file format, so it must never depend on the platform
+  ///   (which rules out std::hash).
+  /// </remarks>
+  std::uint64_t hashName(const std::string &name) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for(char character : name) {
+      hash ^= static_cast<std::uint8_t>(character);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SoundBankWriter::Add(
+    const SoundBankClip &clip, const std::vector<std::byte> &encodedFile
+  ) {
+    for(const SoundBankClip &existingClip : this->clips) {
+      if(unlikely(existingClip.Name == clip.Name)) {
+        throw std::invalid_argument(u8"Sound bank already contains a clip with that name");
+      }
+    }
+
+    this->clips.push_back(clip);
+    this->clips.back().ByteCount = encodedFile.size();
+    this->encodedFiles.push_back(encodedFile);
+
+    return this->clips.size() - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SoundBankWriter::Add(
+    const AudioLoader &loader,
+    const std::string &name,
+    const std::shared_ptr<const VirtualFile> &file,
+    const std::string &extension /* = std::string() */,
+    AudioSampleFormat preferredFormat /* = AudioSampleFormat::Unknown */
+  ) {
+    std::optional<ContainerInfo> info = loader.TryReadInfo(file, extension);
+    if(unlikely(!info.has_value() || info.value().Tracks.empty())) {
+      throw Errors::UnsupportedFormatError(u8"Clip is not in a supported audio format");
+    }
+
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(file, extension);
+    decoder->BuildSeekIndex();
+
+    SoundBankClip clip;
+    clip.Name = name;
+    clip.Extension = extension;
+    clip.Info = info.value().Tracks[info.value().DefaultTrackIndex];
+    clip.PreferredFormat = preferredFormat;
+    clip.SeekIndex = decoder->SaveSeekIndex();
+    clip.ByteCount = 0;
+
+    std::vector<std::byte> encodedFile(static_cast<std::size_t>(file->GetSize()));
+    file->ReadAt(0, encodedFile.size(), encodedFile.data());
+
+    return Add(clip, encodedFile);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SoundBankWriter::Save(VirtualFile &target) const {
+    std::size_t clipCount = this->clips.size();
+
+    // Keep the hash table at most half full so probe sequences stay short
+    std::size_t slotCount = 1;
+    while(slotCount < clipCount * 2) {
+      slotCount *= 2;
+    }
+
+    std::size_t directoryOffset = HeaderByteCount;
+    std::size_t slotsOffset = directoryOffset + clipCount * DirectoryEntryByteCount;
+
+    BinaryWriter writer;
+    writer.WriteBytes(FileSignature, sizeof(FileSignature));
+    writer.WriteUInt32(FileVersion);
+    writer.WriteUInt64(slotCount);
+    writer.WriteUInt64(clipCount);
+    writer.WriteUInt64(0); // Length of the table of contents, patched in below
+    writer.Buffer.resize(slotsOffset + slotCount * SlotByteCount, std::byte(0));
+
+    // Records follow the hash table. The offsets at which the clips' encoded files
+    // will be stored are only known once all records are written, so remember where
+    // each record keeps its offset and patch them in afterwards.
+    std::vector<std::size_t> clipOffsetPositions(clipCount);
+    for(std::size_t clipIndex = 0; clipIndex < clipCount; ++clipIndex) {
+      const SoundBankClip &clip = this->clips[clipIndex];
+
+      std::uint64_t hash = hashName(clip.Name);
+      std::size_t slotIndex = static_cast<std::size_t>(hash) & (slotCount - 1);
+      for(;;) {
+        std::size_t slotOffset = slotsOffset + slotIndex * SlotByteCount;
+        if(LittleEndianReader::ReadUInt64(writer.Buffer.data() + slotOffset + 8) == 0) {
+          writer.PatchUInt64(slotOffset, hash);
+          writer.PatchUInt64(slotOffset + 8, clipIndex + 1);
+          break;
+        }
+        slotIndex = (slotIndex + 1) & (slotCount - 1);
+      }
+
+      std::size_t directoryEntryOffset = directoryOffset + clipIndex * DirectoryEntryByteCount;
+      writer.PatchUInt64(directoryEntryOffset, writer.Buffer.size());
+      writer.WriteString(clip.Name);
+      writer.WriteString(clip.Extension);
+      writer.WriteTrackInfo(clip.Info);
+      writer.WriteUInt32(static_cast<std::uint32_t>(clip.PreferredFormat));
+      clipOffsetPositions[clipIndex] = writer.Buffer.size();
+      writer.WriteUInt64(0); // Offset of the encoded file, patched in below
+      writer.WriteUInt64(clip.ByteCount);
+      writer.WriteBlob(clip.SeekIndex);
+    }
+
+    std::size_t tableOfContentsLength = writer.Buffer.size();
+    writer.PatchUInt64(HeaderByteCount - 8, tableOfContentsLength);
+
+    // The encoded files follow the table of contents, aligned so that codecs reading
+    // from a memory-mapped bank can do so with aligned loads where they care
+    for(std::size_t clipIndex = 0; clipIndex < clipCount; ++clipIndex) {
+      std::size_t padding = (ClipAlignment - writer.Buffer.size() % ClipAlignment) % ClipAlignment;
+      writer.Buffer.resize(writer.Buffer.size() + padding, std::byte(0));
+
+      writer.PatchUInt64(clipOffsetPositions[clipIndex], writer.Buffer.size());
+      const std::vector<std::byte> &encodedFile = this->encodedFiles[clipIndex];
+      writer.WriteBytes(encodedFile.data(), encodedFile.size());
+    }
+
+    target.WriteAt(0, writer.Buffer.size(), writer.Buffer.data());
+    target.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const SoundBank> SoundBank::Open(const std::string &path) {
+    return std::make_shared<SoundBank>(
+      VirtualFile::OpenRealFileForReading(path, FileAccessPattern::Random, true)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SoundBank::SoundBank(const std::shared_ptr<const VirtualFile> &file) :
+    file(file),
+    contents(),
+    data(nullptr),
+    length(0),
+    fileSize(file->GetSize()),
+    slotCount(0),
+    clipCount(0) {
+
+    // Read the fixed header first, it tells how much of the file is table of contents
+    std::byte header[HeaderByteCount];
+    if(unlikely(this->fileSize < HeaderByteCount)) {
+      throw Errors::CorruptedFileError(u8"File is not a sound bank");
+    }
+    file->ReadAt(0, HeaderByteCount, header);
+    if(unlikely(!std::equal(std::begin(FileSignature), std::end(FileSignature), header))) {
+      throw Errors::CorruptedFileError(u8"File is not a sound bank");
+    }
+
+    BinaryReader headerReader(header, HeaderByteCount, sizeof(FileSignature));
+    if(unlikely(headerReader.ReadUInt32() != FileVersion)) {
+      throw Errors::CorruptedFileError(u8"Sound bank has unknown version");
+    }
+
+    std::uint64_t slotCount = headerReader.ReadUInt64();
+    std::uint64_t clipCount = headerReader.ReadUInt64();
+    std::uint64_t tableOfContentsLength = headerReader.ReadUInt64();
+    if(unlikely(tableOfContentsLength > this->fileSize)) {
+      throw Errors::CorruptedFileError(u8"Sound bank is truncated");
+    }
+    if(unlikely(tableOfContentsLength < HeaderByteCount)) {
+      throw Errors::CorruptedFileError(u8"Sound bank has a damaged table of contents");
+    }
+    this->length = static_cast<std::size_t>(tableOfContentsLength);
+
+    std::size_t availableTableBytes = this->length - HeaderByteCount;
+    bool isValidTable = (
+      (slotCount > 0) &&
+      ((slotCount & (slotCount - 1)) == 0) &&
+      (clipCount <= availableTableBytes / DirectoryEntryByteCount) &&
+      (
+        slotCount <= (
+          (availableTableBytes - clipCount * DirectoryEntryByteCount) / SlotByteCount
+        )
+      )
+    );
+    if(unlikely(!isValidTable)) {
+      throw Errors::CorruptedFileError(u8"Sound bank has a damaged table of contents");
+    }
+
+    // Only the table of contents needs to be in memory, the clips are read through
+    // sub-range views of the file whether it can lend out its memory or not
+    this->data = file->TryBorrowAt(0, this->length);
+    if(this->data == nullptr) {
+      this->contents.resize(this->length);
+      file->ReadAt(0, this->length, this->contents.data());
+      this->data = this->contents.data();
+    }
+
+    this->slotCount = static_cast<std::size_t>(slotCount);
+    this->clipCount = static_cast<std::size_t>(clipCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SoundBank::~SoundBank() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::optional<std::size_t> SoundBank::TryFindClip(const std::string &name) const {
+    std::uint64_t hash = hashName(name);
+    std::size_t slotsOffset = HeaderByteCount + this->clipCount * DirectoryEntryByteCount;
+
+    // The writer keeps the table at most half full, but a damaged file might not,
+    // so give up after visiting each slot once
+    std::size_t slotIndex = static_cast<std::size_t>(hash) & (this->slotCount - 1);
+    for(std::size_t probeCount = 0; probeCount < this->slotCount; ++probeCount) {
+      const std::byte *slot = this->data + slotsOffset + slotIndex * SlotByteCount;
+      std::uint64_t clipNumber = LittleEndianReader::ReadUInt64(slot + 8);
+      if(clipNumber == 0) {
+        return std::optional<std::size_t>();
+      }
+
+      if(LittleEndianReader::ReadUInt64(slot) == hash) {
+        if(unlikely(clipNumber > this->clipCount)) {
+          throw Errors::CorruptedFileError(u8"Sound bank has a damaged hash table");
+        }
+
+        std::size_t clipIndex = static_cast<std::size_t>(clipNumber - 1);
+        std::size_t recordOffset = getRecordOffset(clipIndex);
+
+        BinaryReader reader(this->data, this->length, recordOffset);
+        std::size_t nameLength = reader.ReadUInt32();
+        reader.Skip(nameLength);
+
+        bool isMatch = (
+          (nameLength == name.length()) &&
+          (std::memcmp(this->data + recordOffset + 4, name.data(), nameLength) == 0)
+        );
+        if(isMatch) {
+          return clipIndex;
+        }
+      }
+
+      slotIndex = (slotIndex + 1) & (this->slotCount - 1);
+    }
+
+    return std::optional<std::size_t>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SoundBankClip SoundBank::GetClip(std::size_t clipIndex) const {
+    BinaryReader reader(this->data, this->length, getRecordOffset(clipIndex));
+
+    SoundBankClip clip;
+    clip.Name = reader.ReadString();
+    clip.Extension = reader.ReadString();
+    clip.Info = reader.ReadTrackInfo();
+    clip.PreferredFormat = static_cast<AudioSampleFormat>(reader.ReadUInt32());
+    reader.Skip(8); // Offset of the encoded file
+    clip.ByteCount = reader.ReadUInt64();
+    clip.SeekIndex = reader.ReadBlob();
+
+    return clip;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> SoundBank::OpenClipFile(std::size_t clipIndex) const {
+    std::uint64_t start, byteCount;
+    std::string extension;
+    readClipLocation(clipIndex, start, byteCount, extension);
+
+    return VirtualFile::CreateSubRangeView(this->file, start, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> SoundBank::OpenDecoder(
+    const AudioLoader &loader, std::size_t clipIndex
+  ) const {
+    std::uint64_t start, byteCount;
+    std::string extension;
+    readClipLocation(clipIndex, start, byteCount, extension);
+
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      VirtualFile::CreateSubRangeView(this->file, start, byteCount), extension
+    );
+    loadSeekIndex(*decoder, clipIndex);
+
+    return decoder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackDecoder> SoundBank::OpenDecoder(
+    const AudioLoader &loader, const std::string &name
+  ) const {
+    std::optional<std::size_t> clipIndex = TryFindClip(name);
+    if(unlikely(!clipIndex.has_value())) {
+      throw std::out_of_range(u8"Sound bank contains no clip with that name");
+    }
+
+    return OpenDecoder(loader, clipIndex.value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SoundBank::ReopenDecoder(
+    const AudioLoader &loader,
+    std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t clipIndex
+  ) const {
+    std::uint64_t start, byteCount;
+    std::string extension;
+    readClipLocation(clipIndex, start, byteCount, extension);
+
+    loader.ReopenDecoder(
+      decoder, VirtualFile::CreateSubRangeView(this->file, start, byteCount), extension
+    );
+    loadSeekIndex(*decoder, clipIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SoundBank::getRecordOffset(std::size_t clipIndex) const {
+    if(unlikely(clipIndex >= this->clipCount)) {
+      throw std::out_of_range(u8"Clip index out of range");
+    }
+
+    std::uint64_t recordOffset = LittleEndianReader::ReadUInt64(
+      this->data + HeaderByteCount + clipIndex * DirectoryEntryByteCount
+    );
+    if(unlikely(recordOffset >= this->length)) {
+      throw Errors::CorruptedFileError(u8"Sound bank has a damaged clip directory");
+    }
+
+    return static_cast<std::size_t>(recordOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SoundBank::readClipLocation(
+    std::size_t clipIndex,
+    std::uint64_t &start, std::uint64_t &byteCount,
+    std::string &extension
+  ) const {
+    BinaryReader reader(this->data, this->length, getRecordOffset(clipIndex));
+    reader.Skip(reader.ReadUInt32()); // Name
+    extension = reader.ReadString();
+    reader.ReadTrackInfo();
+    reader.Skip(4); // Preferred sample format
+    start = reader.ReadUInt64();
+    byteCount = reader.ReadUInt64();
+
+    bool isWithinBank = (
+      (start >= this->length) &&
+      (start <= this->fileSize) &&
+      (byteCount <= this->fileSize - start)
+    );
+    if(unlikely(!isWithinBank)) {
+      throw Errors::CorruptedFileError(u8"Sound bank clip lies outside of the file");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SoundBank::loadSeekIndex(AudioTrackDecoder &decoder, std::size_t clipIndex) const {
+    BinaryReader reader(this->data, this->length, getRecordOffset(clipIndex));
+    reader.Skip(reader.ReadUInt32()); // Name
+    reader.Skip(reader.ReadUInt32()); // Extension
+    reader.ReadTrackInfo();
+    reader.Skip(4 + 8 + 8); // Preferred sample format, offset and size of the encoded file
+
+    // The bank was written together with its seek indices, but a codec that changed
+    // its seek index layout since is no reason to fail, the decoder can do without
+    std::vector<std::byte> seekIndex = reader.ReadBlob();
+    if(!seekIndex.empty()) {
+      try {
+        decoder.LoadSeekIndex(seekIndex);
+      }
+      catch(const Errors::CorruptedFileError &) {}
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,231 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/StreamingManager.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/BlockCache.h"
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "Nuclex/Audio/Storage/StreamingThreadPool.h"
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <algorithm> // for std::remove_if()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the file extension from a path</summary>
+  /// <param name="path">Path whose file extension will be extracted</param>
+  /// <returns>The file extension without the dot or an empty string if there is none</returns>
+  std::string getExtension(const std::string &path) {
+    std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of("\\/");
+#else
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+    bool dotBelongsToFilename = (
+      (extensionDotIndex != std::string::npos) &&
+      (
+        (lastPathSeparatorIndex == std::string::npos) ||
+        (extensionDotIndex > lastPathSeparatorIndex)
+      )
+    );
+    if(dotBelongsToFilename) {
+      return path.substr(extensionDotIndex + 1);
+    } else {
+      return std::string();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingManager::StreamingManager(
+    const AudioLoader &loader,
+    std::size_t threadCount /* = 1 */,
+    std::size_t cacheMemoryLimit /* = 8388608 */
+  ) :
+    loader(loader),
+    threadPool(std::make_shared<StreamingThreadPool>(threadCount)),
+    cache(std::make_shared<BlockCache>(cacheMemoryLimit)),
+    headCache(),
+    headCacheMutex(),
+    voices(),
+    voicesMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingManager::StreamingManager(
+    const AudioLoader &loader,
+    const std::shared_ptr<Executor> &executor,
+    std::size_t cacheMemoryLimit /* = 8388608 */
+  ) :
+    loader(loader),
+    threadPool(std::make_shared<StreamingThreadPool>(executor)),
+    cache(std::make_shared<BlockCache>(cacheMemoryLimit)),
+    headCache(),
+    headCacheMutex(),
+    voices(),
+    voicesMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingManager::~StreamingManager() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<StreamingTrackReader> StreamingManager::OpenVoice(
+    const std::string &path,
+    std::size_t bufferedFrameCount /* = 16384 */,
+    std::uint64_t startFrame /* = 0 */
+  ) {
+    std::shared_ptr<const CachedHead> head;
+    {
+      std::lock_guard<std::mutex> headCacheMutexScope(this->headCacheMutex);
+      if(static_cast<bool>(this->headCache)) {
+        head = this->headCache->TryGetHead(path);
+      }
+    }
+
+    // If the asset's head is cached, the voice can start playing right away
+    // and the file is opened by the decoding thread that first services the voice
+    if(static_cast<bool>(head) && (startFrame < head->FrameCount)) {
+      const AudioLoader &loader = this->loader;
+      std::shared_ptr<BlockCache> cache = this->cache;
+      std::shared_ptr<StreamingTrackReader> reader = std::make_shared<StreamingTrackReader>(
+        head,
+        [&loader, cache, path]() {
+          std::shared_ptr<const VirtualFile> file = BlockCache::Wrap(
+            cache, VirtualFile::OpenRealFileForReading(path, true), path
+          );
+          return loader.OpenDecoder(file, getExtension(path));
+        },
+        this->threadPool, bufferedFrameCount, startFrame
+      );
+      trackVoice(reader);
+
+      return reader;
+    }
+
+    // Each voice gets its own file handle because files aren't thread-safe,
+    // but the block cache lets all handles of the same file share their reads
+    std::shared_ptr<const VirtualFile> file = BlockCache::Wrap(
+      this->cache, VirtualFile::OpenRealFileForReading(path, true), path
+    );
+
+    std::shared_ptr<StreamingTrackReader> reader = std::make_shared<StreamingTrackReader>(
+      this->loader.OpenDecoder(file, getExtension(path)),
+      this->threadPool, bufferedFrameCount, startFrame
+    );
+    trackVoice(reader);
+
+    return reader;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<StreamingTrackReader> StreamingManager::AddVoice(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t bufferedFrameCount /* = 16384 */,
+    std::uint64_t startFrame /* = 0 */
+  ) {
+    std::shared_ptr<StreamingTrackReader> reader = std::make_shared<StreamingTrackReader>(
+      decoder, this->threadPool, bufferedFrameCount, startFrame
+    );
+    trackVoice(reader);
+
+    return reader;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingManager::SetHeadCache(const std::shared_ptr<const HeadCache> &headCache) {
+    std::lock_guard<std::mutex> headCacheMutexScope(this->headCacheMutex);
+    this->headCache = headCache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingManager::CountVoices() const {
+    std::lock_guard<std::mutex> voicesMutexScope(this->voicesMutex);
+
+    std::size_t voiceCount = 0;
+    for(std::size_t index = 0; index < this->voices.size(); ++index) {
+      if(!this->voices[index].expired()) {
+        ++voiceCount;
+      }
+    }
+
+    return voiceCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingManager::CountQueuedRefills() const {
+    return this->threadPool->CountPendingStreams();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingManager::CountUnderruns() const {
+    return this->threadPool->CountUnderruns();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingManager::CountCoalescedReads() const {
+    return this->cache->CountHits();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingManager::CountFileReads() const {
+    return this->cache->CountMisses();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingManager::trackVoice(const std::shared_ptr<StreamingTrackReader> &reader) {
+    std::lock_guard<std::mutex> voicesMutexScope(this->voicesMutex);
+
+    this->voices.erase(
+      std::remove_if(
+        this->voices.begin(), this->voices.end(),
+        [](const std::weak_ptr<StreamingTrackReader> &voice) { return voice.expired(); }
+      ),
+      this->voices.end()
+    );
+    this->voices.push_back(reader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,285 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/StreamingThreadPool.h"
+#include "StreamingTrackState.h"
+
+#include <algorithm> // for std::remove_if(), std::sort()
+#include <chrono> // for std::chrono::milliseconds
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How long the threads sleep when no stream needed any decoding</summary>
+  /// <remarks>
+  ///   Streams only get serviced once their ring buffer has room for a quarter of its
+  ///   capacity, so as long as the ring buffers hold a few multiples of this interval,
+  ///   the threads will wake up in time to prevent any stream from running dry.
+  /// </remarks>
+  const std::chrono::milliseconds IdleInterval(2);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingThreadPool::StreamingThreadPool(std::size_t threadCount /* = 1 */) :
+    executor(),
+    threads(),
+    streams(),
+    streamsMutex(),
+    wakeCondition(),
+    droppedUnderrunCount(0),
+    pendingStreamCount(0),
+    stopping(false),
+    passFinishedCondition(),
+    isPassPending(false),
+    didPassDecode(false) {
+
+    if(unlikely(threadCount == 0)) {
+      throw std::invalid_argument(u8"Streaming thread pool needs at least one thread");
+    }
+
+    this->threads.reserve(threadCount);
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      this->threads.emplace_back(&StreamingThreadPool::serviceStreams, this);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingThreadPool::StreamingThreadPool(const std::shared_ptr<Executor> &executor) :
+    executor(executor),
+    threads(),
+    streams(),
+    streamsMutex(),
+    wakeCondition(),
+    droppedUnderrunCount(0),
+    pendingStreamCount(0),
+    stopping(false),
+    passFinishedCondition(),
+    isPassPending(false),
+    didPassDecode(false) {
+
+    if(unlikely(!static_cast<bool>(executor))) {
+      throw std::invalid_argument(u8"Streaming thread pool requires an executor");
+    }
+
+    this->threads.emplace_back(&StreamingThreadPool::submitPasses, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingThreadPool::~StreamingThreadPool() {
+    {
+      std::lock_guard<std::mutex> streamsMutexScope(this->streamsMutex);
+      this->stopping.store(true, std::memory_order_relaxed);
+    }
+    this->wakeCondition.notify_all();
+
+    for(std::size_t index = 0; index < this->threads.size(); ++index) {
+      this->threads[index].join();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingThreadPool::CountStreams() const {
+    std::lock_guard<std::mutex> streamsMutexScope(this->streamsMutex);
+
+    std::size_t streamCount = 0;
+    for(std::size_t index = 0; index < this->streams.size(); ++index) {
+      if(!this->streams[index]->IsClosed()) {
+        ++streamCount;
+      }
+    }
+
+    return streamCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingThreadPool::CountUnderruns() const {
+    std::lock_guard<std::mutex> streamsMutexScope(this->streamsMutex);
+
+    std::uint64_t underrunCount = this->droppedUnderrunCount;
+    for(std::size_t index = 0; index < this->streams.size(); ++index) {
+      underrunCount += this->streams[index]->CountUnderruns();
+    }
+
+    return underrunCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingThreadPool::addStream(const std::shared_ptr<StreamingTrackState> &stream) {
+    {
+      std::lock_guard<std::mutex> streamsMutexScope(this->streamsMutex);
+      this->streams.push_back(stream);
+    }
+    this->wakeCondition.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingThreadPool::serviceStreams() {
+    std::vector<std::shared_ptr<StreamingTrackState>> snapshot;
+    std::vector<std::pair<std::size_t, StreamingTrackState *>> queue;
+
+    for(;;) {
+      bool anyDecoded = servicePass(snapshot, queue);
+
+      // If none of the streams needed anything, sleep a little (or until a new
+      // stream is added) instead of spinning over the streams again
+      std::unique_lock<std::mutex> streamsMutexScope(this->streamsMutex);
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        return;
+      }
+      if(!anyDecoded) {
+        this->wakeCondition.wait_for(streamsMutexScope, IdleInterval);
+      }
+    } // for ever
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingThreadPool::submitPasses() {
+    std::vector<std::shared_ptr<StreamingTrackState>> snapshot;
+    std::vector<std::pair<std::size_t, StreamingTrackState *>> queue;
+
+    std::unique_lock<std::mutex> streamsMutexScope(this->streamsMutex);
+    for(;;) {
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        return;
+      }
+
+      // Only one pass is in flight at any time, so the scratch lists can be shared.
+      // This thread waits for the pass, so the destructor can't run while it's queued.
+      this->isPassPending = true;
+      streamsMutexScope.unlock();
+      try {
+        this->executor->Submit(
+          [this, &snapshot, &queue]() {
+            bool anyDecoded = servicePass(snapshot, queue);
+
+            // Notify while holding the mutex, once it is released, the pool may be gone
+            std::lock_guard<std::mutex> passScope(this->streamsMutex);
+            this->didPassDecode = anyDecoded;
+            this->isPassPending = false;
+            this->passFinishedCondition.notify_all();
+          },
+          TaskPriority::High
+        );
+      }
+      catch(...) {
+        // The executor couldn't take the pass, run it here so the streams don't run dry
+        bool anyDecoded = servicePass(snapshot, queue);
+        std::lock_guard<std::mutex> passScope(this->streamsMutex);
+        this->didPassDecode = anyDecoded;
+        this->isPassPending = false;
+      }
+      streamsMutexScope.lock();
+
+      this->passFinishedCondition.wait(
+        streamsMutexScope, [this]() { return !this->isPassPending; }
+      );
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        return;
+      }
+      if(!this->didPassDecode) {
+        this->wakeCondition.wait_for(streamsMutexScope, IdleInterval);
+      }
+    } // for ever
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool StreamingThreadPool::servicePass(
+    std::vector<std::shared_ptr<StreamingTrackState>> &snapshot,
+    std::vector<std::pair<std::size_t, StreamingTrackState *>> &queue
+  ) {
+
+    // Take a copy of the stream list so we don't hold the mutex while decoding.
+    // This is also where closed streams get dropped from the list.
+    {
+      std::lock_guard<std::mutex> streamsMutexScope(this->streamsMutex);
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        return false;
+      }
+
+      this->streams.erase(
+        std::remove_if(
+          this->streams.begin(), this->streams.end(),
+          [this](const std::shared_ptr<StreamingTrackState> &stream) {
+            if(stream->IsClosed()) {
+              this->droppedUnderrunCount += stream->CountUnderruns();
+              return true;
+            } else {
+              return false;
+            }
+          }
+        ),
+        this->streams.end()
+      );
+      snapshot.assign(this->streams.begin(), this->streams.end());
+    }
+
+    // Order the streams that have room for a chunk by how many frames they have
+    // left to play, so the one closest to running dry is serviced first
+    for(std::size_t index = 0; index < snapshot.size(); ++index) {
+      StreamingTrackState &stream = *snapshot[index];
+      if(!stream.IsClosed() && stream.NeedsDecoding()) {
+        queue.emplace_back(stream.CountReadableFrames(), &stream);
+      }
+    }
+    std::sort(
+      queue.begin(), queue.end(),
+      [](
+        const std::pair<std::size_t, StreamingTrackState *> &left,
+        const std::pair<std::size_t, StreamingTrackState *> &right
+      ) { return left.first < right.first; }
+    );
+    this->pendingStreamCount.store(queue.size(), std::memory_order_relaxed);
+
+    // Give each stream one chunk per pass, so that a stream whose ring buffer is
+    // nearly empty doesn't have to wait until all others have been filled up.
+    bool anyDecoded = false;
+    for(std::size_t index = 0; index < queue.size(); ++index) {
+      if(this->stopping.load(std::memory_order_relaxed)) {
+        break;
+      }
+      anyDecoded |= queue[index].second->DecodeAhead();
+    }
+    queue.clear();
+    snapshot.clear();
+
+    return anyDecoded;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
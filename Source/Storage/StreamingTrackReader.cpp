@@ -0,0 +1,152 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+#include "Nuclex/Audio/Storage/StreamingThreadPool.h"
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "StreamingTrackState.h"
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackReader::StreamingTrackReader(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    const std::shared_ptr<StreamingThreadPool> &threadPool,
+    std::size_t bufferedFrameCount /* = 16384 */,
+    std::uint64_t startFrame /* = 0 */
+  ) :
+    threadPool(threadPool),
+    state() {
+
+    if(unlikely(!static_cast<bool>(decoder))) {
+      throw std::invalid_argument(u8"Streaming reader requires a decoder to stream from");
+    }
+    if(unlikely(!static_cast<bool>(threadPool))) {
+      throw std::invalid_argument(u8"Streaming reader requires a thread pool to decode on");
+    }
+    if(unlikely(bufferedFrameCount == 0)) {
+      throw std::invalid_argument(u8"Streaming reader needs to buffer at least one frame");
+    }
+
+    this->state = std::make_shared<StreamingTrackState>(decoder, bufferedFrameCount, startFrame);
+    threadPool->addStream(this->state);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackReader::StreamingTrackReader(
+    const std::shared_ptr<const CachedHead> &head,
+    const std::function<std::shared_ptr<AudioTrackDecoder>()> &openDecoder,
+    const std::shared_ptr<StreamingThreadPool> &threadPool,
+    std::size_t bufferedFrameCount /* = 16384 */,
+    std::uint64_t startFrame /* = 0 */
+  ) :
+    threadPool(threadPool),
+    state() {
+
+    if(unlikely(!static_cast<bool>(head) || !static_cast<bool>(openDecoder))) {
+      throw std::invalid_argument(
+        u8"Streaming reader requires a head and a decoder to stream from"
+      );
+    }
+    if(unlikely(!static_cast<bool>(threadPool))) {
+      throw std::invalid_argument(u8"Streaming reader requires a thread pool to decode on");
+    }
+    if(unlikely(bufferedFrameCount == 0)) {
+      throw std::invalid_argument(u8"Streaming reader needs to buffer at least one frame");
+    }
+    if(unlikely(startFrame > head->FrameCount)) {
+      throw std::invalid_argument(u8"Start frame must lie within the cached head");
+    }
+
+    this->state = std::make_shared<StreamingTrackState>(
+      head, openDecoder, bufferedFrameCount, startFrame
+    );
+    threadPool->addStream(this->state);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackReader::~StreamingTrackReader() {
+    this->state->Close();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingTrackReader::CountChannels() const {
+    return this->state->CountChannels();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingTrackReader::CountFrames() const {
+    return this->state->CountFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingTrackReader::GetBufferedFrameCount() const {
+    return this->state->GetBufferedFrameCount();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingTrackReader::CountReadableFrames() const {
+    return this->state->CountReadableFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingTrackReader::GetReadPosition() const {
+    return this->state->GetReadPosition();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool StreamingTrackReader::IsAtEnd() const {
+    return (this->state->GetReadPosition() >= this->state->CountFrames());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingTrackReader::CountUnderruns() const {
+    return this->state->CountUnderruns();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingTrackReader::Read(float *buffer, std::size_t frameCount) {
+    return this->state->Read(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingTrackReader::RethrowPotentialException() const {
+    this->state->RethrowPotentialException();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,266 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "StreamingTrackState.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/HeadCache.h"
+
+#include <algorithm> // for std::min(), std::max(), std::copy_n()
+#include <stdexcept> // for std::runtime_error
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackState::StreamingTrackState(
+    const std::shared_ptr<AudioTrackDecoder> &decoder,
+    std::size_t bufferedFrameCount,
+    std::uint64_t startFrame
+  ) :
+    decoder(decoder),
+    openDecoder(),
+    head(),
+    headFrameCount(0),
+    channelCount(decoder->CountChannels()),
+    totalFrameCount(decoder->CountFrames()),
+    capacity(bufferedFrameCount),
+    chunkFrameCount(std::max<std::size_t>(bufferedFrameCount / 4, 1)),
+    ring(new float[bufferedFrameCount * decoder->CountChannels()]),
+    writtenFrame(std::min(startFrame, decoder->CountFrames())),
+    readFrame(std::min(startFrame, decoder->CountFrames())),
+    underrunCount(0),
+    busy(false),
+    closed(false),
+    failed(false),
+    error(),
+    errorMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackState::StreamingTrackState(
+    const std::shared_ptr<const CachedHead> &head,
+    const std::function<std::shared_ptr<AudioTrackDecoder>()> &openDecoder,
+    std::size_t bufferedFrameCount,
+    std::uint64_t startFrame
+  ) :
+    decoder(),
+    openDecoder(openDecoder),
+    head(head),
+    headFrameCount(head->FrameCount),
+    channelCount(head->ChannelCount),
+    totalFrameCount(head->TotalFrameCount),
+    capacity(bufferedFrameCount),
+    chunkFrameCount(std::max<std::size_t>(bufferedFrameCount / 4, 1)),
+    ring(new float[bufferedFrameCount * head->ChannelCount]),
+    writtenFrame(head->FrameCount),
+    readFrame(std::min<std::uint64_t>(startFrame, head->FrameCount)),
+    underrunCount(0),
+    busy(false),
+    closed(false),
+    failed(false),
+    error(),
+    errorMutex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StreamingTrackState::~StreamingTrackState() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool StreamingTrackState::NeedsDecoding() const {
+    if(this->failed.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    return countWantedFrames(
+      this->writtenFrame.load(std::memory_order_relaxed),
+      this->readFrame.load(std::memory_order_acquire)
+    ) > 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StreamingTrackState::Read(float *buffer, std::size_t frameCount) {
+    std::uint64_t read = this->readFrame.load(std::memory_order_relaxed);
+
+    // Frames within the cached head are always available. The head is immutable,
+    // so they can be copied without coordinating with the producer.
+    std::size_t headFrameCount = 0;
+    if(read < this->headFrameCount) {
+      headFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(frameCount, this->headFrameCount - read)
+      );
+      std::copy_n(
+        this->head->Samples.data() + (read * this->channelCount),
+        headFrameCount * this->channelCount,
+        buffer
+      );
+      buffer += headFrameCount * this->channelCount;
+      frameCount -= headFrameCount;
+      read += headFrameCount;
+      if(frameCount == 0) {
+        this->readFrame.store(read, std::memory_order_release);
+        return headFrameCount;
+      }
+    }
+
+    std::uint64_t written = this->writtenFrame.load(std::memory_order_acquire);
+
+    // Coming up short only counts as an underrun if the track isn't simply over
+    std::uint64_t available = written - read;
+    if(frameCount > available) {
+      std::uint64_t end = std::min<std::uint64_t>(read + frameCount, this->totalFrameCount);
+      if(unlikely(written < end)) {
+        this->underrunCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    frameCount = static_cast<std::size_t>(std::min<std::uint64_t>(frameCount, available));
+    if(frameCount == 0) {
+      if(headFrameCount > 0) {
+        this->readFrame.store(read, std::memory_order_release);
+      }
+      return headFrameCount;
+    }
+
+    // The frames may wrap around the end of the ring buffer, in which case
+    // they need to be copied in two pieces
+    std::size_t ringIndex = static_cast<std::size_t>(read % this->capacity);
+    std::size_t firstFrameCount = std::min(frameCount, this->capacity - ringIndex);
+    std::copy_n(
+      this->ring.get() + (ringIndex * this->channelCount),
+      firstFrameCount * this->channelCount,
+      buffer
+    );
+    std::copy_n(
+      this->ring.get(),
+      (frameCount - firstFrameCount) * this->channelCount,
+      buffer + (firstFrameCount * this->channelCount)
+    );
+
+    // Only now that we're done copying can the producer overwrite these frames
+    this->readFrame.store(read + frameCount, std::memory_order_release);
+
+    return headFrameCount + frameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool StreamingTrackState::DecodeAhead() {
+    if(this->failed.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    if(this->busy.exchange(true, std::memory_order_acquire)) {
+      return false; // Another thread of the pool is servicing this stream
+    }
+
+    std::uint64_t written = this->writtenFrame.load(std::memory_order_relaxed);
+    std::uint64_t read = this->readFrame.load(std::memory_order_acquire);
+
+    std::uint64_t wanted = countWantedFrames(written, read);
+    if(wanted == 0) {
+      this->busy.store(false, std::memory_order_release);
+      return false;
+    }
+
+    // Streams started from a cached head open their decoder only now, on the pool's
+    // thread, while the reader is already playing the head
+    if(!static_cast<bool>(this->decoder)) {
+      try {
+        std::shared_ptr<AudioTrackDecoder> openedDecoder = this->openDecoder();
+        if(openedDecoder->CountChannels() != this->channelCount) {
+          throw std::runtime_error(u8"Streamed file no longer matches its cached head");
+        }
+        this->decoder = std::move(openedDecoder);
+        this->openDecoder = nullptr;
+      }
+      catch(...) {
+        {
+          std::lock_guard<std::mutex> errorMutexScope(this->errorMutex);
+          this->error = std::current_exception();
+        }
+        this->failed.store(true, std::memory_order_release);
+        this->busy.store(false, std::memory_order_release);
+        return false;
+      }
+    }
+
+    // Decode straight into the ring buffer, stopping at its end if the chunk would
+    // wrap around. The next call will continue at the start of the ring buffer.
+    std::size_t ringIndex = static_cast<std::size_t>(written % this->capacity);
+    std::size_t frameCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(wanted, this->capacity - ringIndex)
+    );
+    try {
+      this->decoder->DecodeInterleaved<float>(
+        this->ring.get() + (ringIndex * this->channelCount), written, frameCount
+      );
+    }
+    catch(...) {
+      {
+        std::lock_guard<std::mutex> errorMutexScope(this->errorMutex);
+        this->error = std::current_exception();
+      }
+      this->failed.store(true, std::memory_order_release);
+      this->busy.store(false, std::memory_order_release);
+      return false;
+    }
+
+    this->writtenFrame.store(written + frameCount, std::memory_order_release);
+    this->busy.store(false, std::memory_order_release);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t StreamingTrackState::countWantedFrames(
+    std::uint64_t written, std::uint64_t read
+  ) const {
+
+    // Only decode once there's room for a whole chunk (or the rest of the track),
+    // otherwise a stream that's being read slowly would be serviced in tiny pieces.
+    // Frames still being read from the cached head take up no room in the ring buffer.
+    std::uint64_t remaining = this->totalFrameCount - written;
+    std::uint64_t freeFrameCount = this->capacity - (
+      written - std::max<std::uint64_t>(read, this->headFrameCount)
+    );
+    std::uint64_t wanted = std::min<std::uint64_t>(this->chunkFrameCount, remaining);
+    if(freeFrameCount < wanted) {
+      return 0;
+    } else {
+      return wanted;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamingTrackState::RethrowPotentialException() const {
+    if(this->failed.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> errorMutexScope(this->errorMutex);
+      std::rethrow_exception(this->error);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
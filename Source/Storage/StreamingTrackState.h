@@ -0,0 +1,202 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_STREAMINGTRACKSTATE_H
+#define NUCLEX_AUDIO_STORAGE_STREAMINGTRACKSTATE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <memory> // for std::shared_ptr, std::unique_ptr
+#include <mutex> // for std::mutex
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class AudioTrackDecoder;
+  struct CachedHead;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ring buffer and decoder shared by a streaming reader and its thread pool</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This is a single-producer, single-consumer ring buffer. The producer is whichever
+  ///     thread of the pool services the stream (only one at a time, guarded by an atomic
+  ///     flag), the consumer is the thread calling <see cref="Read" />. The producer only
+  ///     ever advances the write counter and the consumer only ever advances the read
+  ///     counter, so neither needs to wait for the other.
+  ///   </para>
+  ///   <para>
+  ///     The state is owned jointly by the reader and the thread pool, so when the reader
+  ///     is destroyed while a pool thread is decoding into the ring buffer, the ring buffer
+  ///     stays alive until the pool notices that the stream has been closed.
+  ///   </para>
+  ///   <para>
+  ///     A stream can also start from a cached head. Frames before the end of the head
+  ///     are read from the head's immutable samples, the ring buffer only ever holds
+  ///     frames after it. The decoder is opened by the first pool thread servicing
+  ///     the stream, which then fills the ring buffer from the head's end onwards.
+  ///   </para>
+  /// </remarks>
+  class StreamingTrackState {
+
+    /// <summary>Initializes a new ring buffer for the specified decoder</summary>
+    /// <param name="decoder">Decoder that will fill the ring buffer</param>
+    /// <param name="bufferedFrameCount">Number of frames the ring buffer can hold</param>
+    /// <param name="startFrame">Frame from which decoding will begin</param>
+    public: StreamingTrackState(
+      const std::shared_ptr<AudioTrackDecoder> &decoder,
+      std::size_t bufferedFrameCount,
+      std::uint64_t startFrame
+    );
+
+    /// <summary>Initializes a new ring buffer that starts playing from a cached head</summary>
+    /// <param name="head">Decoded beginning of the track</param>
+    /// <param name="openDecoder">Opens the decoder that will continue after the head</param>
+    /// <param name="bufferedFrameCount">Number of frames the ring buffer can hold</param>
+    /// <param name="startFrame">Frame from which reading will begin</param>
+    public: StreamingTrackState(
+      const std::shared_ptr<const CachedHead> &head,
+      const std::function<std::shared_ptr<AudioTrackDecoder>()> &openDecoder,
+      std::size_t bufferedFrameCount,
+      std::uint64_t startFrame
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~StreamingTrackState();
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const { return this->channelCount; }
+
+    /// <summary>Returns the number of frames (sample count in any one channel)</summary>
+    /// <returns>The number of frames the audio file is long</returns>
+    public: std::uint64_t CountFrames() const { return this->totalFrameCount; }
+
+    /// <summary>Returns the number of frames the ring buffer can hold</summary>
+    /// <returns>The capacity of the ring buffer in frames</returns>
+    public: std::size_t GetBufferedFrameCount() const { return this->capacity; }
+
+    /// <summary>Counts the frames that can be read right now</summary>
+    /// <returns>The number of frames that have been decoded but not read yet</returns>
+    public: std::size_t CountReadableFrames() const {
+      return static_cast<std::size_t>(
+        this->writtenFrame.load(std::memory_order_acquire) -
+        this->readFrame.load(std::memory_order_relaxed)
+      );
+    }
+
+    /// <summary>Returns the index of the frame that will be read next</summary>
+    /// <returns>The index of the next frame the consumer will receive</returns>
+    public: std::uint64_t GetReadPosition() const {
+      return this->readFrame.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Counts how often the consumer asked for more frames than were decoded</summary>
+    /// <returns>The number of reads that came up short before the end of the track</returns>
+    public: std::uint64_t CountUnderruns() const {
+      return this->underrunCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Checks whether the ring buffer has room for the next chunk</summary>
+    /// <returns>True if a call to <see cref="DecodeAhead" /> would decode something</returns>
+    public: bool NeedsDecoding() const;
+
+    /// <summary>Copies decoded frames out of the ring buffer</summary>
+    /// <param name="buffer">Buffer that will receive the interleaved samples</param>
+    /// <param name="frameCount">Maximum number of frames that will be copied</param>
+    /// <returns>The number of frames that have actually been copied</returns>
+    public: std::size_t Read(float *buffer, std::size_t frameCount);
+
+    /// <summary>Decodes one chunk into the ring buffer if it has enough room</summary>
+    /// <returns>True if any frames were decoded, false if there was nothing to do</returns>
+    /// <remarks>
+    ///   Called by the thread pool. If another thread is already servicing the stream,
+    ///   this returns false immediately.
+    /// </remarks>
+    public: bool DecodeAhead();
+
+    /// <summary>Whether the reader has been destroyed and the stream can be dropped</summary>
+    /// <returns>True if the stream has been closed by its reader</returns>
+    public: bool IsClosed() const { return this->closed.load(std::memory_order_acquire); }
+
+    /// <summary>Marks the stream as closed so the thread pool will drop it</summary>
+    public: void Close() { this->closed.store(true, std::memory_order_release); }
+
+    /// <summary>Whether decoding has failed and the stream will not progress</summary>
+    /// <returns>True if the decoder has thrown an exception</returns>
+    public: bool HasFailed() const { return this->failed.load(std::memory_order_acquire); }
+
+    /// <summary>Rethrows the exception the decoder failed with, if any</summary>
+    public: void RethrowPotentialException() const;
+
+    /// <summary>Determines how many frames the next chunk should decode</summary>
+    /// <param name="written">Absolute index of the next frame that will be decoded</param>
+    /// <param name="read">Absolute index of the next frame that will be read</param>
+    /// <returns>The number of frames to decode or 0 if the ring buffer lacks room</returns>
+    private: std::uint64_t countWantedFrames(std::uint64_t written, std::uint64_t read) const;
+
+    /// <summary>Decoder that fills the ring buffer, opened late when starting from a head</summary>
+    private: std::shared_ptr<AudioTrackDecoder> decoder;
+    /// <summary>Opens the decoder if the stream was started from a cached head</summary>
+    private: std::function<std::shared_ptr<AudioTrackDecoder>()> openDecoder;
+    /// <summary>Cached head the stream started from, if any</summary>
+    private: std::shared_ptr<const CachedHead> head;
+    /// <summary>Number of frames that are read from the cached head</summary>
+    private: std::uint64_t headFrameCount;
+    /// <summary>Number of audio channels in the decoded track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Total number of frames in the decoded track</summary>
+    private: std::uint64_t totalFrameCount;
+    /// <summary>Number of frames the ring buffer can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Number of frames the producer decodes at once</summary>
+    private: std::size_t chunkFrameCount;
+    /// <summary>Interleaved decoded samples, indexed by frame modulo the capacity</summary>
+    private: std::unique_ptr<float[]> ring;
+    /// <summary>Absolute index of the frame the producer will decode next</summary>
+    private: std::atomic<std::uint64_t> writtenFrame;
+    /// <summary>Absolute index of the frame the consumer will read next</summary>
+    private: std::atomic<std::uint64_t> readFrame;
+    /// <summary>Number of reads that delivered fewer frames than requested</summary>
+    private: std::atomic<std::uint64_t> underrunCount;
+    /// <summary>Set while a thread of the pool is decoding into the ring buffer</summary>
+    private: std::atomic<bool> busy;
+    /// <summary>Set when the reader has been destroyed</summary>
+    private: std::atomic<bool> closed;
+    /// <summary>Set when the decoder has thrown an exception</summary>
+    private: std::atomic<bool> failed;
+    /// <summary>Exception the decoder has thrown</summary>
+    private: std::exception_ptr error;
+    /// <summary>Must be held while accessing the exception</summary>
+    private: mutable std::mutex errorMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_STREAMINGTRACKSTATE_H
@@ -0,0 +1,112 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "SubRangeFile.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SubRangeFile::SubRangeFile(
+    const std::shared_ptr<const VirtualFile> &file, std::uint64_t start, std::uint64_t length
+  ) :
+    file(file),
+    start(start),
+    length(length) {
+    std::uint64_t fileLength = file->GetSize();
+    if((start > fileLength) || (fileLength - start < length)) {
+      throw std::out_of_range(u8"Sub-range must lie within the bounds of the wrapped file");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SubRangeFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+    }
+
+    this->file->ReadAt(this->start + start, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SubRangeFile::ReadManyAt(
+    const ReadRequest *requests, std::size_t requestCount
+  ) const {
+    std::vector<ReadRequest> offsetRequests(requests, requests + requestCount);
+    for(ReadRequest &request : offsetRequests) {
+      bool isInRange = (
+        (request.Start <= this->length) && (this->length - request.Start >= request.ByteCount)
+      );
+      if(unlikely(!isInRange)) {
+        throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+      }
+      request.Start += this->start;
+    }
+
+    this->file->ReadManyAt(offsetRequests.data(), requestCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SubRangeFile::Prefetch(std::uint64_t start, std::size_t byteCount) const {
+    if(likely(start < this->length)) {
+      this->file->Prefetch(
+        this->start + start,
+        static_cast<std::size_t>(std::min<std::uint64_t>(byteCount, this->length - start))
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::byte *SubRangeFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      return nullptr;
+    }
+
+    return this->file->TryBorrowAt(this->start + start, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SubRangeFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+    throw std::runtime_error(u8"Sub-range views of files are read-only");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,108 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_SUBRANGEFILE_H
+#define NUCLEX_AUDIO_STORAGE_SUBRANGEFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Exposes a range of bytes from another file as a file of its own</summary>
+  /// <remarks>
+  ///   This is useful to decode audio files stored in archives or sound banks in place,
+  ///   without having to copy them into a separate buffer first. No data is copied,
+  ///   the reads are simply offset and passed on to the wrapped file.
+  /// </remarks>
+  class SubRangeFile : public VirtualFile {
+
+    /// <summary>Initializes a new sub-range view of the specified file</summary>
+    /// <param name="file">File a range of which will be exposed</param>
+    /// <param name="start">Offset in the wrapped file at which the range begins</param>
+    /// <param name="length">Length of the range in bytes</param>
+    public: SubRangeFile(
+      const std::shared_ptr<const VirtualFile> &file, std::uint64_t start, std::uint64_t length
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~SubRangeFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Reads several ranges of the file in one batch</summary>
+    /// <param name="requests">Ranges that will be read and where to store them</param>
+    /// <param name="requestCount">Number of read requests in the batch</param>
+    public: void ReadManyAt(
+      const ReadRequest *requests, std::size_t requestCount
+    ) const override;
+
+    /// <summary>Announces that a range of the file will be read soon</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes in the range</param>
+    public: void Prefetch(std::uint64_t start, std::size_t byteCount) const override;
+
+    /// <summary>Attempts to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>
+    ///   A pointer to the wrapped file's memory if it supports borrowing and the range
+    ///   lies within the view, otherwise a null pointer
+    /// </returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Sub-range views are always read-only, so this always throws.
+    /// </remarks>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>File a range of which is being exposed</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Offset in the wrapped file at which the range begins</summary>
+    private: std::uint64_t start;
+    /// <summary>Length of the range in bytes</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_SUBRANGEFILE_H
@@ -0,0 +1,133 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "UnbufferedFile.h"
+
+#if defined(NUCLEX_AUDIO_LINUX)
+
+#include "../Platform/LinuxFileApi.h" // for open(), etc.
+#include "../Platform/PosixFileApi.h" // for ThrowExceptionForFileAccessError()
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <fcntl.h> // for POSIX_FADV_SEQUENTIAL, POSIX_FADV_NOREUSE
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::openFile(const std::string &path, bool readOnly) {
+    this->fileDescriptor = Platform::LinuxFileApi::TryOpenFileDirect(path, !readOnly);
+
+    // tmpfs and some FUSE file systems refuse O_DIRECT. The file is still going to be
+    // streamed through once, so at least tell the kernel not to hold on to its pages.
+    if(this->fileDescriptor == -1) {
+      if(readOnly) {
+        this->fileDescriptor = Platform::LinuxFileApi::OpenFileForReading(path);
+      } else {
+        this->fileDescriptor = Platform::LinuxFileApi::OpenFileForWriting(path);
+      }
+
+      Platform::LinuxFileApi::AdviseAccessPattern(
+        this->fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL
+      );
+      Platform::LinuxFileApi::AdviseAccessPattern(
+        this->fileDescriptor, 0, 0, POSIX_FADV_NOREUSE
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::closeFile() {
+    Platform::LinuxFileApi::Close(this->fileDescriptor, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t UnbufferedFile::querySize() const {
+    return Platform::LinuxFileApi::StatFileSize(this->fileDescriptor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t UnbufferedFile::readAligned(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file unbuffered", this, nullptr);
+
+    std::size_t totalByteCount = 0;
+    while(totalByteCount < byteCount) {
+      std::size_t readByteCount = Platform::LinuxFileApi::PositionalRead(
+        this->fileDescriptor, buffer, byteCount - totalByteCount, start
+      );
+      if(readByteCount == 0) {
+        break; // End of file reached
+      }
+
+      totalByteCount += readByteCount;
+      buffer += readByteCount;
+      start += readByteCount;
+    }
+
+    return totalByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::writeAligned(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Write file unbuffered", this, nullptr);
+
+    while(byteCount > 0) {
+      std::size_t writtenByteCount = Platform::LinuxFileApi::PositionalWrite(
+        this->fileDescriptor, buffer, byteCount, start
+      );
+      if(unlikely(writtenByteCount == 0)) {
+        Platform::PosixFileApi::ThrowExceptionForFileAccessError(
+          u8"Write finished without storing the entire buffer", EIO
+        );
+      }
+
+      byteCount -= writtenByteCount;
+      buffer += writtenByteCount;
+      start += writtenByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::truncate(std::uint64_t newLength) {
+    Platform::LinuxFileApi::Truncate(this->fileDescriptor, newLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::preallocate(std::uint64_t byteCount) {
+    Platform::LinuxFileApi::TryPreallocate(this->fileDescriptor, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_LINUX)
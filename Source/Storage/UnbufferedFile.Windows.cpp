@@ -0,0 +1,113 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "UnbufferedFile.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "../Platform/WindowsFileApi.h"
+#include "../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::openFile(const std::string &path, bool readOnly) {
+    this->fileHandle = Platform::WindowsFileApi::OpenFileUnbuffered(path, !readOnly);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::closeFile() {
+    Platform::WindowsFileApi::CloseFile(this->fileHandle, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t UnbufferedFile::querySize() const {
+    return Platform::WindowsFileApi::GetFileSize(this->fileHandle);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t UnbufferedFile::readAligned(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Read file unbuffered", this, nullptr);
+
+    std::size_t totalByteCount = 0;
+    while(totalByteCount < byteCount) {
+      std::size_t readByteCount = Platform::WindowsFileApi::PositionalRead(
+        this->fileHandle, buffer, byteCount - totalByteCount, start
+      );
+      if(readByteCount == 0) {
+        break; // End of file reached
+      }
+
+      totalByteCount += readByteCount;
+      buffer += readByteCount;
+      start += readByteCount;
+    }
+
+    return totalByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::writeAligned(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Write file unbuffered", this, nullptr);
+
+    while(byteCount > 0) {
+      std::size_t writtenByteCount = Platform::WindowsFileApi::PositionalWrite(
+        this->fileHandle, buffer, byteCount, start
+      );
+      if(unlikely(writtenByteCount == 0)) {
+        Platform::WindowsFileApi::ThrowExceptionForFileAccessError(
+          u8"Write finished without storing the entire buffer", ERROR_WRITE_FAULT
+        );
+      }
+
+      byteCount -= writtenByteCount;
+      buffer += writtenByteCount;
+      start += writtenByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::truncate(std::uint64_t newLength) {
+    Platform::WindowsFileApi::SetFileLength(this->fileHandle, newLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::preallocate(std::uint64_t byteCount) {
+    Platform::WindowsFileApi::TryPreallocate(this->fileHandle, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_WINDOWS)
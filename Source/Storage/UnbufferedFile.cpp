@@ -0,0 +1,406 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "UnbufferedFile.h"
+
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+
+#include "Nuclex/Audio/Executor.h"
+
+#include <algorithm> // for std::copy_n(), std::fill(), std::min(), std::swap()
+#include <atomic> // for std::atomic
+#include <cassert> // for assert()
+#include <exception> // for std::exception, std::current_exception()
+#include <future> // for std::promise, std::future
+#include <new> // for std::align_val_t
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates a block of memory suitable as a direct I/O buffer</summary>
+  /// <returns>The newly allocated, aligned block</returns>
+  std::byte *allocateBlock() {
+    return static_cast<std::byte *>(
+      ::operator new(
+        Nuclex::Audio::Storage::UnbufferedFile::BlockSize,
+        std::align_val_t(Nuclex::Audio::Storage::UnbufferedFile::Alignment)
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees a block of memory obtained from allocateBlock()</summary>
+  /// <param name="block">Block that will be freed, may be a null pointer</param>
+  void freeBlock(std::byte *block) {
+    if(block != nullptr) {
+      ::operator delete(
+        block, std::align_val_t(Nuclex::Audio::Storage::UnbufferedFile::Alignment)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a byte count up to the next multiple of the direct I/O alignment</summary>
+  /// <param name="byteCount">Byte count that will be rounded up</param>
+  /// <returns>The smallest aligned byte count that is at least as large</returns>
+  constexpr std::uint64_t alignUp(std::uint64_t byteCount) {
+    constexpr std::uint64_t alignment = Nuclex::Audio::Storage::UnbufferedFile::Alignment;
+    return (byteCount + alignment - 1) / alignment * alignment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct UnbufferedFile::PendingRead {
+
+    /// <summary>Initializes a new pending read of the specified block</summary>
+    /// <param name="start">Absolute file offset at which the block begins</param>
+    public: PendingRead(std::uint64_t start) :
+      Claimed(false),
+      Start(start),
+      Promise(),
+      Length(Promise.get_future()) {}
+
+    /// <summary>Set by whoever performs the read, the worker or the reading thread</summary>
+    /// <remarks>
+    ///   If all worker threads are busy (possibly with tasks waiting for this very read),
+    ///   the thread that needs the block claims the read and does it itself.
+    /// </remarks>
+    public: std::atomic<bool> Claimed;
+    /// <summary>Absolute file offset at which the block begins</summary>
+    public: std::uint64_t Start;
+    /// <summary>Receives the number of bytes read or the exception that occurred</summary>
+    public: std::promise<std::size_t> Promise;
+    /// <summary>Delivers the number of bytes read into the block</summary>
+    public: std::future<std::size_t> Length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  UnbufferedFile::UnbufferedFile(
+    const std::string &path, bool readOnly, std::uint64_t expectedByteCount /* = 0 */
+  ) :
+    readOnly(readOnly),
+    length(0),
+    currentBlock(nullptr),
+    currentBlockStart(0),
+    currentBlockLength(0),
+    nextBlock(nullptr),
+    nextBlockRead(),
+    lastReadEnd(0),
+    blockMutex(),
+    appendBlock(nullptr),
+    appendBlockStart(0) {
+    openFile(path, readOnly);
+    try {
+      if(readOnly) {
+        this->length = querySize();
+      } else {
+        truncate(0); // Like RealFile, writing starts over with an empty file
+        if(expectedByteCount > 0) {
+          preallocate(expectedByteCount); // Flush() truncates, releasing any excess
+        }
+      }
+
+      this->currentBlock = allocateBlock();
+      this->nextBlock = allocateBlock();
+      if(!readOnly) {
+        this->appendBlock = allocateBlock();
+      }
+    }
+    catch(const std::exception &) {
+      freeBlock(this->nextBlock);
+      freeBlock(this->currentBlock);
+      closeFile();
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  UnbufferedFile::~UnbufferedFile() {
+    try {
+      abandonNextBlock();
+      Flush();
+    }
+    catch(const std::exception &) {
+      assert(!u8"Pending data is written successfully when the file is destroyed");
+    }
+
+    closeFile();
+
+    freeBlock(this->appendBlock);
+    freeBlock(this->nextBlock);
+    freeBlock(this->currentBlock);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+    }
+
+    std::lock_guard<std::mutex> blockMutexScope(this->blockMutex);
+
+    // Anything that is still sitting in the append block hasn't reached the disk yet,
+    // so that part of the read has to be served from the append block
+    if(!this->readOnly && (start + byteCount > this->appendBlockStart)) {
+      std::uint64_t appendedStart = std::max(start, this->appendBlockStart);
+      std::size_t appendedByteCount = static_cast<std::size_t>(
+        start + byteCount - appendedStart
+      );
+      std::copy_n(
+        this->appendBlock + (appendedStart - this->appendBlockStart),
+        appendedByteCount,
+        buffer + (appendedStart - start)
+      );
+      byteCount -= appendedByteCount;
+    }
+
+    // Everything else is read from disk in whole blocks
+    while(byteCount > 0) {
+      loadBlockContaining(start);
+
+      std::size_t offset = static_cast<std::size_t>(start - this->currentBlockStart);
+      std::size_t chunkByteCount = std::min(byteCount, this->currentBlockLength - offset);
+      std::copy_n(this->currentBlock + offset, chunkByteCount, buffer);
+
+      start += chunkByteCount;
+      buffer += chunkByteCount;
+      byteCount -= chunkByteCount;
+
+      this->lastReadEnd = start;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    if(unlikely(this->readOnly)) {
+      throw std::runtime_error(u8"Attempted to write to a file opened for reading");
+    }
+    if(unlikely(start > this->length)) {
+      throw std::out_of_range(u8"Attempted write position would leave a gap in the file");
+    }
+
+    std::lock_guard<std::mutex> blockMutexScope(this->blockMutex);
+
+    // The blocks kept for reading may hold data that is about to change
+    abandonNextBlock();
+    this->currentBlockLength = 0;
+
+    // Data landing before the append block has already been written out to disk
+    if(start < this->appendBlockStart) {
+      std::size_t patchByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(byteCount, this->appendBlockStart - start)
+      );
+      patchWrittenRange(start, patchByteCount, buffer);
+
+      start += patchByteCount;
+      buffer += patchByteCount;
+      byteCount -= patchByteCount;
+    }
+
+    // Everything else goes into the append block which is written out when it's full
+    while(byteCount > 0) {
+      std::size_t offset = static_cast<std::size_t>(start - this->appendBlockStart);
+      std::size_t chunkByteCount = std::min(byteCount, BlockSize - offset);
+      std::copy_n(buffer, chunkByteCount, this->appendBlock + offset);
+
+      start += chunkByteCount;
+      buffer += chunkByteCount;
+      byteCount -= chunkByteCount;
+
+      if(start > this->length) {
+        this->length = start;
+      }
+      if(this->length == this->appendBlockStart + BlockSize) {
+        writeAligned(this->appendBlockStart, BlockSize, this->appendBlock);
+        this->appendBlockStart += BlockSize;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::Flush() {
+    if(this->readOnly) {
+      return;
+    }
+
+    // Direct I/O can only write whole sectors, so the final block is padded with zeros
+    // and the file is cut back to its actual length once the block has been written.
+    std::size_t appendedByteCount = static_cast<std::size_t>(
+      this->length - this->appendBlockStart
+    );
+    if(appendedByteCount > 0) {
+      std::size_t paddedByteCount = static_cast<std::size_t>(alignUp(appendedByteCount));
+      std::fill(
+        this->appendBlock + appendedByteCount,
+        this->appendBlock + paddedByteCount,
+        std::byte(0)
+      );
+      writeAligned(this->appendBlockStart, paddedByteCount, this->appendBlock);
+    }
+
+    truncate(this->length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::loadBlockContaining(std::uint64_t start) const {
+    if(
+      (start >= this->currentBlockStart) &&
+      (start - this->currentBlockStart < this->currentBlockLength)
+    ) {
+      return;
+    }
+
+    std::uint64_t blockStart = start - (start % BlockSize);
+    bool isSequential = (start == this->lastReadEnd);
+
+    // If the block was read ahead, take it over. If its read hasn't even been
+    // picked up by a worker yet, read it on this thread rather than waiting.
+    this->currentBlockLength = 0;
+    if(static_cast<bool>(this->nextBlockRead) && (this->nextBlockRead->Start == blockStart)) {
+      std::shared_ptr<PendingRead> pendingRead;
+      pendingRead.swap(this->nextBlockRead);
+
+      std::size_t readByteCount;
+      if(pendingRead->Claimed.exchange(true)) {
+        readByteCount = pendingRead->Length.get();
+      } else {
+        readByteCount = readAligned(blockStart, BlockSize, this->nextBlock);
+      }
+
+      std::swap(this->currentBlock, this->nextBlock);
+      this->currentBlockLength = readByteCount;
+      isSequential = true;
+    } else {
+      abandonNextBlock();
+      this->currentBlockLength = readAligned(blockStart, BlockSize, this->currentBlock);
+    }
+    this->currentBlockStart = blockStart;
+
+    if(unlikely(start - blockStart >= this->currentBlockLength)) {
+      this->currentBlockLength = 0;
+      throw std::runtime_error(u8"Encountered unexpected end of file");
+    }
+
+    // Only read ahead if the caller is going through the file in order,
+    // otherwise a decoder seeking around would pay for a second block each time
+    if(isSequential) {
+      beginReadingNextBlock();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::beginReadingNextBlock() const {
+    std::uint64_t nextStart = this->currentBlockStart + BlockSize;
+    std::uint64_t diskLength = this->readOnly ? this->length : this->appendBlockStart;
+    if(nextStart >= diskLength) {
+      return;
+    }
+
+    std::shared_ptr<PendingRead> pendingRead = std::make_shared<PendingRead>(nextStart);
+    this->nextBlockRead = pendingRead;
+
+    // The task only touches this instance after claiming the read, and the instance
+    // waits for claimed reads to finish before it lets go of the block or the file.
+    std::byte *block = this->nextBlock;
+    Executor::GetInstalled()->Submit(
+      [this, pendingRead, block]() {
+        if(pendingRead->Claimed.exchange(true)) {
+          return; // The reading thread got to it first or abandoned the read
+        }
+        try {
+          pendingRead->Promise.set_value(readAligned(pendingRead->Start, BlockSize, block));
+        }
+        catch(const std::exception &) {
+          pendingRead->Promise.set_exception(std::current_exception());
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::abandonNextBlock() const {
+    std::shared_ptr<PendingRead> pendingRead;
+    pendingRead.swap(this->nextBlockRead);
+
+    // If a worker is already reading into the block, we have to wait until it's done
+    if(static_cast<bool>(pendingRead) && pendingRead->Claimed.exchange(true)) {
+      pendingRead->Length.wait();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void UnbufferedFile::patchWrittenRange(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+
+    // The current block isn't holding anything valid at this point,
+    // so it is borrowed as the scratch buffer for the read-modify-write cycles
+    while(byteCount > 0) {
+      std::uint64_t alignedStart = start - (start % Alignment);
+      std::size_t offset = static_cast<std::size_t>(start - alignedStart);
+      std::size_t chunkByteCount = std::min(byteCount, BlockSize - offset);
+      std::size_t alignedByteCount = static_cast<std::size_t>(
+        alignUp(offset + chunkByteCount)
+      );
+
+      std::size_t readByteCount = readAligned(alignedStart, alignedByteCount, this->currentBlock);
+      if(unlikely(readByteCount < alignedByteCount)) {
+        throw std::runtime_error(u8"Encountered unexpected end of file");
+      }
+      std::copy_n(buffer, chunkByteCount, this->currentBlock + offset);
+      writeAligned(alignedStart, alignedByteCount, this->currentBlock);
+
+      start += chunkByteCount;
+      buffer += chunkByteCount;
+      byteCount -= chunkByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
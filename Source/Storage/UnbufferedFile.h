@@ -0,0 +1,210 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_UNBUFFEREDFILE_H
+#define NUCLEX_AUDIO_STORAGE_UNBUFFEREDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../Platform/WindowsApi.h" // for HANDLE, etc.
+#endif
+
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accesses a file in the OS' file system without going through its file cache</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Direct I/O requires every read and write to use aligned buffers, offsets and
+  ///     lengths. This class hides that by moving data in large aligned blocks: reads are
+  ///     served from one block while the following block is already being read by
+  ///     the installed <see cref="Executor" />, writes are collected in an aligned append
+  ///     block that is written out whenever it fills up.
+  ///   </para>
+  ///   <para>
+  ///     Writes into parts of the file that have already been written out (such as
+  ///     a container header patched after encoding) are done as aligned read-modify-write
+  ///     cycles. When flushing, the last partial block is written padded to the alignment
+  ///     and the file is truncated back to its logical length afterwards.
+  ///   </para>
+  ///   <para>
+  ///     If the file system doesn't support direct I/O (tmpfs, for example), the file is
+  ///     opened normally and everything else stays the same.
+  ///   </para>
+  /// </remarks>
+  class UnbufferedFile : public VirtualFile {
+
+    /// <summary>Alignment required for buffers, offsets and lengths of direct I/O</summary>
+    /// <remarks>
+    ///   This covers the logical block size of 512e and 4Kn drives alike.
+    /// </remarks>
+    public: static constexpr std::size_t Alignment = 4096;
+
+    /// <summary>Number of bytes transferred by each read or write of a block</summary>
+    public: static constexpr std::size_t BlockSize = 1048576;
+
+    /// <summary>Initializes a new instance accessing the file at the specified path</summary>
+    /// <param name="path">Path of the file that will be accessed or created</param>
+    /// <param name="readOnly">Whether write accesses to the file will be denied</param>
+    /// <param name="expectedByteCount">
+    ///   Size the file is expected to reach when writing, 0 if unknown
+    /// </param>
+    public: UnbufferedFile(
+      const std::string &path, bool readOnly, std::uint64_t expectedByteCount = 0
+    );
+
+    /// <summary>Flushes pending writes, closes the file and frees all memory</summary>
+    public: ~UnbufferedFile() override;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Writes the partially filled append block and trims the file</summary>
+    public: void Flush() override;
+
+    /// <summary>Opens the file using the current platform's direct I/O flags</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="readOnly">Whether the file will only be read</param>
+    private: void openFile(const std::string &path, bool readOnly);
+
+    /// <summary>Closes the file again</summary>
+    private: void closeFile();
+
+    /// <summary>Determines the size of the file on disk</summary>
+    /// <returns>The current size of the file in bytes</returns>
+    private: std::uint64_t querySize() const;
+
+    /// <summary>Reads an aligned range of the file</summary>
+    /// <param name="start">Aligned offset at which reading will begin</param>
+    /// <param name="byteCount">Aligned number of bytes that will be read</param>
+    /// <param name="buffer">Aligned buffer that will receive the data</param>
+    /// <returns>
+    ///   The number of bytes actually read, which is only less than requested when
+    ///   the end of the file has been reached
+    /// </returns>
+    private: std::size_t readAligned(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const;
+
+    /// <summary>Writes an aligned range of the file</summary>
+    /// <param name="start">Aligned offset at which writing will begin</param>
+    /// <param name="byteCount">Aligned number of bytes that will be written</param>
+    /// <param name="buffer">Aligned buffer holding the data that will be written</param>
+    private: void writeAligned(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    );
+
+    /// <summary>Sets the length of the file on disk</summary>
+    /// <param name="newLength">Length the file will be cut off or extended to</param>
+    private: void truncate(std::uint64_t newLength);
+
+    /// <summary>Reserves disk space for the file if the file system supports it</summary>
+    /// <param name="byteCount">Number of bytes the file is expected to grow to</param>
+    private: void preallocate(std::uint64_t byteCount);
+
+    /// <summary>Makes sure the block holding the specified offset is loaded</summary>
+    /// <param name="start">Offset that should be readable from the current block</param>
+    private: void loadBlockContaining(std::uint64_t start) const;
+
+    /// <summary>Starts reading the block following the current one in the background</summary>
+    private: void beginReadingNextBlock() const;
+
+    /// <summary>Waits for a background read, if any, and discards its results</summary>
+    private: void abandonNextBlock() const;
+
+    /// <summary>Writes the data that precedes the append block</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    /// <remarks>
+    ///   Each affected aligned range is read, patched and written back.
+    /// </remarks>
+    private: void patchWrittenRange(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    );
+
+    /// <summary>Read of the next block that has been handed to the executor</summary>
+    private: struct PendingRead;
+
+#if defined(NUCLEX_AUDIO_LINUX)
+    /// <summary>File descriptor returned by ::open()</summary>
+    private: int fileDescriptor;
+#elif defined(NUCLEX_AUDIO_WINDOWS)
+    /// <summary>File handle returned by ::CreateFile()</summary>
+    private: ::HANDLE fileHandle;
+#endif
+    /// <summary>Whether write accesses to the file will be denied</summary>
+    private: bool readOnly;
+    /// <summary>Logical length of the file in bytes</summary>
+    private: std::uint64_t length;
+
+    /// <summary>Aligned memory holding the block reads are currently served from</summary>
+    private: mutable std::byte *currentBlock;
+    /// <summary>Absolute file offset at which the current block begins</summary>
+    private: mutable std::uint64_t currentBlockStart;
+    /// <summary>Number of valid bytes in the current block</summary>
+    private: mutable std::size_t currentBlockLength;
+    /// <summary>Aligned memory into which the next block is being read</summary>
+    private: mutable std::byte *nextBlock;
+    /// <summary>Background read filling the next block, if one has been started</summary>
+    private: mutable std::shared_ptr<PendingRead> nextBlockRead;
+    /// <summary>Offset one past the end of the most recent read</summary>
+    private: mutable std::uint64_t lastReadEnd;
+    /// <summary>Mutex that must be held while accessing the blocks</summary>
+    private: mutable std::mutex blockMutex;
+
+    /// <summary>Aligned memory collecting data written at the end of the file</summary>
+    private: std::byte *appendBlock;
+    /// <summary>Aligned offset in the file at which the append block begins</summary>
+    private: std::uint64_t appendBlockStart;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+
+#endif // NUCLEX_AUDIO_STORAGE_UNBUFFEREDFILE_H
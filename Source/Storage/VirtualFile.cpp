@@ -23,15 +23,56 @@ License along with this library
 
 #include "Nuclex/Audio/Storage/VirtualFile.h"
 #include "RealFile.h"
+#include "UnbufferedFile.h"
+#include "MappedFile.h"
+#include "ReadAheadFile.h"
+#include "RemoteAccessFile.h"
+#include "WriteBehindFile.h"
+#include "SubRangeFile.h"
+#include "MemoryFile.h"
+#include "ConcatenatedFile.h"
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<const VirtualFile> VirtualFile::OpenRealFileForReading(
-    const std::string &path, bool promiseSequentialAccess /* = false */
+    const std::string &path,
+    bool promiseSequentialAccess /* = false */,
+    bool useMemoryMapping /* = false */
+  ) {
+    return OpenRealFileForReading(
+      path,
+      promiseSequentialAccess ? FileAccessPattern::Sequential : FileAccessPattern::Normal,
+      useMemoryMapping
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::OpenRealFileForReading(
+    const std::string &path,
+    FileAccessPattern accessPattern,
+    bool useMemoryMapping /* = false */
   ) {
-    return std::make_shared<const RealFile>(path, promiseSequentialAccess, true);
+    if(accessPattern == FileAccessPattern::Unbuffered) {
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+      return std::make_shared<const UnbufferedFile>(path, true);
+#else
+      accessPattern = FileAccessPattern::Sequential;
+#endif
+    }
+
+    if(useMemoryMapping) {
+      std::shared_ptr<const VirtualFile> mappedFile = MappedFile::TryOpenForReading(
+        path, accessPattern
+      );
+      if(static_cast<bool>(mappedFile)) {
+        return mappedFile;
+      }
+    }
+
+    return std::make_shared<const RealFile>(path, accessPattern, true);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -39,7 +80,81 @@ namespace Nuclex { namespace Audio { namespace Storage {
   std::shared_ptr<VirtualFile> VirtualFile::OpenRealFileForWriting(
     const std::string &path, bool promiseSequentialAccess /* = false */
   ) {
-    return std::make_shared<RealFile>(path, promiseSequentialAccess, false);
+    return OpenRealFileForWriting(
+      path,
+      promiseSequentialAccess ? FileAccessPattern::Sequential : FileAccessPattern::Normal
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<VirtualFile> VirtualFile::OpenRealFileForWriting(
+    const std::string &path,
+    FileAccessPattern accessPattern,
+    std::uint64_t expectedByteCount /* = 0 */
+  ) {
+    if(accessPattern == FileAccessPattern::Unbuffered) {
+#if defined(NUCLEX_AUDIO_LINUX) || defined(NUCLEX_AUDIO_WINDOWS)
+      return std::make_shared<UnbufferedFile>(path, false, expectedByteCount);
+#else
+      accessPattern = FileAccessPattern::Sequential;
+#endif
+    }
+
+    return WrapInWriteBuffer(
+      std::make_shared<RealFile>(path, accessPattern, false, expectedByteCount)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::WrapInReadAheadBuffer(
+    const std::shared_ptr<const VirtualFile> &file,
+    std::size_t blockSize /* = 16384 */,
+    std::size_t readAheadBlockCount /* = 3 */
+  ) {
+    return std::make_shared<const ReadAheadFile>(file, blockSize, readAheadBlockCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::WrapForRemoteAccess(
+    const std::shared_ptr<const VirtualFile> &file,
+    const RemoteReadPolicy &policy /* = RemoteReadPolicy() */
+  ) {
+    return std::make_shared<const RemoteAccessFile>(file, policy);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<VirtualFile> VirtualFile::WrapInWriteBuffer(
+    const std::shared_ptr<VirtualFile> &file, std::size_t bufferSize /* = 65536 */
+  ) {
+    return std::make_shared<WriteBehindFile>(file, bufferSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::FromMemory(
+    const std::shared_ptr<const std::byte[]> &memory, std::size_t length
+  ) {
+    return std::make_shared<const MemoryFile>(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::CreateSubRangeView(
+    const std::shared_ptr<const VirtualFile> &file, std::uint64_t start, std::uint64_t length
+  ) {
+    return std::make_shared<const SubRangeFile>(file, start, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const VirtualFile> VirtualFile::CreateConcatenatedView(
+    const std::vector<std::shared_ptr<const VirtualFile>> &parts
+  ) {
+    return std::make_shared<const ConcatenatedFile>(parts);
   }
 
   // ------------------------------------------------------------------------------------------- //
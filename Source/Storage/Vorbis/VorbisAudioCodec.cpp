@@ -25,17 +25,51 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_VORBIS)
 
 #include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
 #include "./VorbisDetection.h"
 #include "./VorbisVirtualFileAdapter.h"
 #include "./VorbisTrackDecoder.h"
+#include "./VorbisTrackEncoderBuilder.h"
 #include "./VorbisReader.h"
+#include "../Shared/OggLinkScanner.h"
 #include "../../Platform/VorbisApi.h"
 
-#include <stdexcept> // for std::runtime_error
+#include <algorithm> // for std::remove_if()
+#include <stdexcept> // for std::out_of_range
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Exposes the links of a chained Ogg file that hold Vorbis audio</summary>
+  /// <param name="source">Ogg file whose links will be exposed</param>
+  /// <returns>One file per Vorbis link, in the order in which they appear in the file</returns>
+  /// <remarks>
+  ///   Links using a different codec are left out, so the track indices reported by
+  ///   the codec's container informations always match the ones its decoders accept.
+  /// </remarks>
+  std::vector<std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile>> openVorbisLinks(
+    const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &source
+  ) {
+    using Nuclex::Audio::Storage::VirtualFile;
+    using Nuclex::Audio::Storage::Vorbis::Detection;
+
+    std::vector<std::shared_ptr<const VirtualFile>> links = (
+      Nuclex::Audio::Storage::Shared::OggLinkScanner::OpenLinks(source)
+    );
+    links.erase(
+      std::remove_if(
+        links.begin(), links.end(),
+        [](const std::shared_ptr<const VirtualFile> &link) {
+          return !Detection::CheckIfVorbisHeaderPresentLite(*link);
+        }
+      ),
+      links.end()
+    );
+
+    return links;
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -61,6 +95,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool VorbisAudioCodec::IsSignaturePresent(const std::byte *header, std::size_t byteCount) const {
+    return Detection::CheckIfVorbisHeaderPresentLite(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> VorbisAudioCodec::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &source,
     const std::string &extensionHint /* = std::string() */
@@ -73,17 +113,22 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
       return std::optional<ContainerInfo>();
     }
 
-    VorbisReader reader(source);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+    std::vector<std::shared_ptr<const VirtualFile>> links = openVorbisLinks(source);
 
-    // Ogg Vorbis file is now opened, extract the informations the caller requested.
     ContainerInfo containerInfo;
     containerInfo.DefaultTrackIndex = 0;
 
-    // For now, we just read the first track's metadata, assuming that we're
-    // dealing with a single audio track encoded to Ogg Vorbis
-    TrackInfo &trackInfo = containerInfo.Tracks.emplace_back();
-    reader.ReadMetadata(trackInfo);
-    trackInfo.CodecName = GetName();
+    // Each link of a chained Ogg stream is reported as a track of its own. The links
+    // are complete Ogg streams, so the reader can open them like standalone files.
+    for(const std::shared_ptr<const VirtualFile> &link : links) {
+      VorbisReader reader(link);
+
+      AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+      TrackInfo &trackInfo = containerInfo.Tracks.emplace_back();
+      reader.ReadMetadata(trackInfo);
+      trackInfo.CodecName = GetName();
+    }
 
     return containerInfo;
   }
@@ -96,13 +141,23 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     std::size_t trackIndex /* = 0 */
   ) const {
     (void)extensionHint;
-    if(trackIndex != 0) {
-      throw std::runtime_error(
-        u8"Alternate track decoding is not implemented yet, track index must be 0"
-      );
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+    std::vector<std::shared_ptr<const VirtualFile>> links = openVorbisLinks(source);
+    if(links.empty()) {
+      return std::shared_ptr<AudioTrackDecoder>();
     }
+    if(trackIndex >= links.size()) {
+      throw std::out_of_range(u8"Track index is beyond the number of links in the Ogg stream");
+    }
+
+    return std::make_shared<VorbisTrackDecoder>(links[trackIndex]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    return std::make_shared<VorbisTrackDecoder>(source);
+  std::shared_ptr<AudioTrackEncoderBuilder> VorbisAudioCodec::ProvideBuilder() const {
+    return std::make_shared<VorbisTrackEncoderBuilder>();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -61,6 +61,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     /// <returns>The commonly used file extensions in order of preference</returns>
     public: const std::vector<std::string> &GetFileExtensions() const override;
 
+    /// <summary>Checks whether a file header carries the signature of this file format</summary>
+    /// <param name="header">Bytes from the beginning of the file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if the file header carries this codec's signature</returns>
+    public: bool IsSignaturePresent(
+      const std::byte *header, std::size_t byteCount
+    ) const override;
+
     /// <summary>Tries to read informations for an audio container</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
@@ -81,6 +89,17 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
       std::size_t trackIndex = 0
     ) const override;
 
+    /// <summary>Reports whether this codec can be encoded to</summary>
+    /// <returns>True if the codec can provide encoders, false if it decodes only</returns>
+    public: bool CanEncode() const override { return true; }
+
+    /// <summary>
+    ///   Requests a builder through which encoders for this codec can be configured and
+    ///   then created
+    /// </summary>
+    /// <returns>The encoder builder for this codec</returns>
+    public: std::shared_ptr<AudioTrackEncoderBuilder> ProvideBuilder() const override;
+
   };
 
   // ------------------------------------------------------------------------------------------- //
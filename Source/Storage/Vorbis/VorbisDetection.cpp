@@ -116,6 +116,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     std::byte fileHeader[48];
     source.ReadAt(0, 48, fileHeader);
 
+    return CheckIfVorbisHeaderPresentLite(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfVorbisHeaderPresentLite(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 48) {
+      return false; // Not enough header bytes to check for a valid Ogg Vorbis header
+    }
+
     // Ogg containers can contain multiple streams, potentially mixing multiple audio
     // track and even video tracks. Theoretically, the packets identifying a Vorbis
     // stream could be buried later in the file.
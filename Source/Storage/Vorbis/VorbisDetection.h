@@ -25,7 +25,7 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_VORBIS)
 
 #include <string> // for std::string
-#include <cstddef> // for std::size_t
+#include <cstddef> // for std::size_t, std::byte
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -69,6 +69,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     /// <returns>True if a valid VORBIS header was found, false otherwise</returns>
     public: static bool CheckIfVorbisHeaderPresentLite(const VirtualFile &source);
 
+    /// <summary>Checks if the file header starts with a valid VORBIS header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid Ogg Vorbis header was found, false otherwise</returns>
+    public: static bool CheckIfVorbisHeaderPresentLite(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,180 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./VorbisPacketDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "../Shared/ChannelOrderFactory.h"
+#include "./VorbisSetupCache.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception reporting invalid Vorbis headers</summary>
+  [[noreturn]] void throwInvalidHeaders() {
+    throw Nuclex::Audio::Errors::CorruptedFileError(
+      u8"Vorbis codec setup data does not contain valid Vorbis headers"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps a buffer in an Ogg packet structure for libvorbis</summary>
+  /// <param name="data">Buffer holding the packet's contents</param>
+  /// <param name="size">Size of the packet in bytes</param>
+  /// <param name="packetNumber">Sequential number of the packet</param>
+  /// <returns>An Ogg packet structure referencing the buffer</returns>
+  ::ogg_packet makePacket(const std::byte *data, std::size_t size, ::ogg_int64_t packetNumber) {
+    ::ogg_packet packet;
+    packet.packet = const_cast<unsigned char *>(reinterpret_cast<const unsigned char *>(data));
+    packet.bytes = static_cast<long>(size);
+    packet.b_o_s = (packetNumber == 0) ? 1 : 0;
+    packet.e_o_s = 0;
+    packet.granulepos = -1;
+    packet.packetno = packetNumber;
+    return packet;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisPacketDecoder::VorbisPacketDecoder(
+    const std::byte *codecPrivate, std::size_t codecPrivateSize
+  ) :
+    setup(),
+    packetNumber(0),
+    channelOrder() {
+
+    // The codec private data is the number of headers minus one (always 2) followed
+    // by the Xiph-laced sizes of the first two headers. The third takes the rest.
+    if((codecPrivateSize < 3) || (static_cast<std::uint8_t>(codecPrivate[0]) != 2)) {
+      throwInvalidHeaders();
+    }
+    std::size_t position = 1;
+    std::size_t headerSizes[3];
+    for(std::size_t index = 0; index < 2; ++index) {
+      headerSizes[index] = 0;
+      for(;;) {
+        if(position >= codecPrivateSize) {
+          throwInvalidHeaders();
+        }
+        std::uint8_t lacingByte = static_cast<std::uint8_t>(codecPrivate[position++]);
+        headerSizes[index] += lacingByte;
+        if(lacingByte != 255) {
+          break;
+        }
+      }
+    }
+    if(headerSizes[0] + headerSizes[1] > codecPrivateSize - position) {
+      throwInvalidHeaders();
+    }
+    headerSizes[2] = codecPrivateSize - position - headerSizes[0] - headerSizes[1];
+
+    const std::byte *headers[3];
+    for(std::size_t index = 0; index < 3; ++index) {
+      headers[index] = codecPrivate + position;
+      position += headerSizes[index];
+    }
+    this->setup = VorbisSetupCache::Acquire(
+      headers[0], headerSizes[0], headers[1], headerSizes[1], headers[2], headerSizes[2]
+    );
+    if(!static_cast<bool>(this->setup)) {
+      throwInvalidHeaders();
+    }
+
+    if(::vorbis_synthesis_init(&this->dspState, this->setup.get()) != 0) {
+      throwInvalidHeaders();
+    }
+    ::vorbis_block_init(&this->dspState, &this->block);
+    this->packetNumber = 3;
+
+    this->channelOrder = Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(
+      0, static_cast<std::size_t>(this->setup->channels)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisPacketDecoder::~VorbisPacketDecoder() {
+    ::vorbis_block_clear(&this->block);
+    ::vorbis_dsp_clear(&this->dspState);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisPacketDecoder::Reset() {
+    ::vorbis_synthesis_restart(&this->dspState);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VorbisPacketDecoder::DecodePacket(
+    const std::byte *packet, std::size_t packetSize, std::vector<float> &samples
+  ) {
+    ::ogg_packet oggPacket = makePacket(packet, packetSize, this->packetNumber++);
+
+    // Vorbis is forgiving about damaged audio packets, the decoder simply produces
+    // nothing for them and picks up with the next packet
+    if(::vorbis_synthesis(&this->block, &oggPacket) == 0) {
+      ::vorbis_synthesis_blockin(&this->dspState, &this->block);
+    }
+
+    std::size_t channelCount = this->channelOrder.size();
+    std::size_t totalFrameCount = 0;
+    for(;;) {
+      float **pcm;
+      int frameCount = ::vorbis_synthesis_pcmout(&this->dspState, &pcm);
+      if(frameCount <= 0) {
+        break;
+      }
+
+      // libvorbis keeps channels separate, interleave them as they get appended
+      std::size_t startIndex = samples.size();
+      samples.resize(startIndex + static_cast<std::size_t>(frameCount) * channelCount);
+      float *target = samples.data() + startIndex;
+      for(int frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          *target = pcm[channelIndex][frameIndex];
+          ++target;
+        }
+      }
+
+      ::vorbis_synthesis_read(&this->dspState, frameCount);
+      totalFrameCount += static_cast<std::size_t>(frameCount);
+    }
+
+    return totalFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,103 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_VORBIS_VORBISPACKETDECODER_H
+#define NUCLEX_AUDIO_STORAGE_VORBIS_VORBISPACKETDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "../Shared/PacketDecoder.h"
+
+#include <vorbis/codec.h> // for the low-level Vorbis decoding API
+
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes raw Vorbis packets delivered by a non-Ogg container</summary>
+  /// <remarks>
+  ///   Containers such as Matroska store the three Vorbis headers (identification,
+  ///   comment and setup) Xiph-laced as codec setup data and each audio packet as
+  ///   a block. This feeds libvorbis' synthesis layer directly, bypassing vorbisfile
+  ///   which only understands Ogg streams. The parsed setup comes from the
+  ///   <see cref="VorbisSetupCache" />, so tracks encoded with the same settings
+  ///   share their codebooks.
+  /// </remarks>
+  class VorbisPacketDecoder : public Shared::PacketDecoder {
+
+    /// <summary>Initializes a new Vorbis packet decoder from the laced headers</summary>
+    /// <param name="codecPrivate">The three Xiph-laced Vorbis headers</param>
+    /// <param name="codecPrivateSize">Size of the laced headers in bytes</param>
+    public: VorbisPacketDecoder(const std::byte *codecPrivate, std::size_t codecPrivateSize);
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~VorbisPacketDecoder() override;
+
+    /// <summary>Counts the number of audio channels the decoder produces</summary>
+    /// <returns>The number of interleaved channels in the decoded samples</returns>
+    public: std::size_t CountChannels() const override { return this->channelOrder.size(); }
+
+    /// <summary>Returns the number of frames per second the decoder produces</summary>
+    /// <returns>The sample rate of the decoded audio</returns>
+    public: std::size_t GetSampleRate() const override {
+      return static_cast<std::size_t>(this->setup->rate);
+    }
+
+    /// <summary>Retrieves the order in which the decoded channels are interleaved</summary>
+    /// <returns>The placement of each decoded channel, in interleaved order</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Forgets all state carried over from previous packets</summary>
+    public: void Reset() override;
+
+    /// <summary>Decodes a packet and appends its samples to a buffer</summary>
+    /// <param name="packet">Packet that will be decoded</param>
+    /// <param name="packetSize">Size of the packet in bytes</param>
+    /// <param name="samples">Buffer the interleaved float samples will be appended to</param>
+    /// <returns>The number of frames that have been appended</returns>
+    public: std::size_t DecodePacket(
+      const std::byte *packet, std::size_t packetSize, std::vector<float> &samples
+    ) override;
+
+    /// <summary>Stream informations and codebooks, shared with identical streams</summary>
+    private: std::shared_ptr<::vorbis_info> setup;
+    /// <summary>Synthesis state the packets are decoded with</summary>
+    private: ::vorbis_dsp_state dspState;
+    /// <summary>Working memory for decoding a single packet</summary>
+    private: ::vorbis_block block;
+    /// <summary>Number of the next packet, libvorbis wants them numbered</summary>
+    private: ::ogg_int64_t packetNumber;
+    /// <summary>Order in which the decoded channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_STORAGE_VORBIS_VORBISPACKETDECODER_H
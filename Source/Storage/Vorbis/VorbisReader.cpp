@@ -26,20 +26,56 @@ limitations under the License.
 
 #include "./VorbisVirtualFileAdapter.h" // for FileAdapterFactory
 #include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/OggSeekIndex.h" // for OggSeekIndex
+#include "../Shared/DecoderStatisticsCollector.h" // for DecoderStatisticsCollector
+#include "../Shared/LoopTagParser.h" // for LoopTagParser
+#include "../Shared/GainTagParser.h" // for GainTagParser
 #include "../../Platform/VorbisApi.h" // for VorbisApi
 
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
 #include "Nuclex/Audio/Processing/Quantization.h"
 
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
 
 #include <stdexcept> // for std::runtime_error
-#include <algorithm> // for std::copy_n()
+#include <algorithm> // for std::copy_n(), std::min()
+#include <optional> // for std::optional
 #include <cassert> // for assert()
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames a checkpoint tries to resume before its target frame</summary>
+  /// <remarks>
+  ///   Jumping to a byte offset lands on the next page after it, so the search
+  ///   for a checkpoint backs off by roughly this many frames' worth of bytes.
+  /// </remarks>
+  const std::uint64_t CheckpointBackoffFrameCount = 8192;
+
+  /// <summary>Bit rate assumed for length estimates if the stream states none</summary>
+  const long FallbackBitRate = 160000;
+
+  /// <summary>Bytes per second a single channel is assumed to take up at most</summary>
+  /// <remarks>
+  ///   512 kbit/s per channel, more than twice what the highest quality setting of
+  ///   the reference encoder produces.
+  /// </remarks>
+  const std::uint64_t MaximumBytesPerChannelSecond = 64000;
+
+  /// <summary>Bytes that libvorbisfile may read ahead beyond the decoded frames</summary>
+  /// <remarks>
+  ///   libvorbisfile reads in chunks of 64 KiB and a page can be almost as long.
+  /// </remarks>
+  const std::uint64_t ReadAheadByteCount = 131072;
+
+  /// <summary>Number of times the checkpoint search backs off further</summary>
+  const std::size_t CheckpointAttemptCount = 4;
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -48,18 +84,26 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
-  VorbisReader::VorbisReader(const std::shared_ptr<const VirtualFile> &file) :
+  VorbisReader::VorbisReader(
+    const std::shared_ptr<const VirtualFile> &file, bool deferLengthScan /* = false */
+  ) :
     file(file),
     fileCallbacks(),
     state(),
     vorbisFile(),
+    isSeekable(!deferLengthScan),
     channelCount(0),
-    frameCursor(0) {
+    frameCursor(0),
+    inputChannelLookup(),
+    decodedChannels(),
+    sinkChannels(),
+    seekIndex(),
+    statistics() {
 
     // Set up the libvorbisfile callbacks with adapter methods that will perform all reads
     // on the user-provided virtual file.
     this->state = (
-      FileAdapterFactory::CreateAdapterForReading(file, this->fileCallbacks)
+      FileAdapterFactory::CreateAdapterForReading(file, this->fileCallbacks, this->isSeekable)
     );
 
     // Open the Vorbis file, obtaining a OggVorbisFile instance. Everything inside
@@ -79,7 +123,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     // Vorbis audio streams can be chained together (sequentially and not in the sense of
     // interleaving it as another stream in the OGG container). This would mean that
     // the audio stream properties (i.e. channel count, sample rate) might change while
-    // we are decoding...
+    // we are decoding... Without seeking, libvorbisfile can't know about later streams
+    // until it reaches them, that is checked again when the file is reopened for seeking.
     //
     std::size_t streamCount = Platform::VorbisApi::CountStreams(this->vorbisFile);
     if(streamCount != 1) {
@@ -89,6 +134,17 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
     this->channelCount = info.channels;
 
+    // Deliver the channels in their native order unless told otherwise
+    AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+    this->inputChannelLookup.resize(this->channelCount);
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      this->inputChannelLookup[index] = index;
+    }
+
+    // Channel pointer lists have a fixed size, set them up now so decoding won't allocate
+    this->decodedChannels.resize(this->channelCount);
+    this->sinkChannels.resize(this->channelCount);
+
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -97,7 +153,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void VorbisReader::ReadMetadata(TrackInfo &target) {
+  void VorbisReader::ReadMetadata(TrackInfo &target, bool includeTags /* = true */) {
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+
     const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
 
     // For Vorbis files, the mapping family is always 0 (says the Vorbis 1 specification)
@@ -110,11 +168,33 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
     target.SampleRate = info.rate;
 
-    ::ogg_int64_t totalSampleCount = Platform::VorbisApi::CountPcmSamples(this->vorbisFile);
+    // If the file was opened without seeking, the length isn't known and finding it would
+    // mean the very scan through the file end that deferring it was supposed to avoid
+    if(this->isSeekable) {
+      ::ogg_int64_t totalSampleCount = Platform::VorbisApi::CountPcmSamples(this->vorbisFile);
 
-    target.Duration = std::chrono::microseconds(
-      totalSampleCount * 1'000'000 / target.SampleRate
-    );
+      target.Duration = std::chrono::microseconds(
+        totalSampleCount * 1'000'000 / target.SampleRate
+      );
+      target.FrameCount = static_cast<std::uint64_t>(totalSampleCount);
+    }
+    {
+      const ::vorbis_comment &comments = Platform::VorbisApi::GetComments(this->vorbisFile);
+
+      Shared::LoopTagParser loopTags;
+      Shared::GainTagParser gainTags;
+      for(int index = 0; index < comments.comments; ++index) {
+        std::string_view comment(
+          comments.user_comments[index], comments.comment_lengths[index]
+        );
+        loopTags.ProcessComment(comment);
+        gainTags.ProcessComment(comment);
+      }
+      if(includeTags && this->isSeekable) {
+        target.Loop = loopTags.GetLoop(target.FrameCount);
+      }
+      target.ReplayGain = gainTags.GetReplayGain();
+    }
 
     target.BitsPerSample = 15; // come up with a silly, wrong approximation formula here
 
@@ -123,12 +203,52 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
-  std::uint64_t VorbisReader::CountTotalFrames() const {
+  std::uint64_t VorbisReader::CountTotalFrames() {
+    requireSeekable();
     return Platform::VorbisApi::CountPcmSamples(this->vorbisFile);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::uint64_t VorbisReader::EstimateTotalFrames() const {
+    if(this->isSeekable) {
+      return Platform::VorbisApi::CountPcmSamples(this->vorbisFile);
+    }
+
+    const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
+    double fileSize = static_cast<double>(this->file->GetSize());
+
+    // After a second of audio has been decoded, the bytes it took are a better guide
+    // than the nominal bit rate, which encoders in quality mode only loosely follow.
+    std::uint64_t byteOffset = Platform::VorbisApi::TellRaw(this->vorbisFile);
+    if((this->frameCursor >= static_cast<std::uint64_t>(info.rate)) && (byteOffset > 0)) {
+      return static_cast<std::uint64_t>(
+        fileSize * static_cast<double>(this->frameCursor) / static_cast<double>(byteOffset)
+      );
+    }
+
+    long bitRate = info.bitrate_nominal;
+    if(bitRate <= 0) {
+      if((info.bitrate_upper > 0) && (info.bitrate_lower > 0)) {
+        bitRate = (info.bitrate_upper + info.bitrate_lower) / 2;
+      } else {
+        bitRate = FallbackBitRate;
+      }
+    }
+
+    return static_cast<std::uint64_t>(
+      fileSize * 8.0 * static_cast<double>(info.rate) / static_cast<double>(bitRate)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VorbisReader::GetNominalPacketFrameCount() const {
+    return Platform::VorbisApi::GetLongBlockSize(this->vorbisFile) / 2;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::vector<ChannelPlacement> VorbisReader::GetChannelOrder() const {
     const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
 
@@ -142,18 +262,159 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisReader::RemapChannels(const std::vector<std::size_t> &inputChannelLookup) {
+    if(unlikely(inputChannelLookup.size() != this->channelCount)) {
+      throw std::invalid_argument(
+        u8"Channel remapping table must contain one entry for each channel"
+      );
+    }
+    for(std::size_t index = 0; index < this->channelCount; ++index) {
+      if(unlikely(inputChannelLookup[index] >= this->channelCount)) {
+        throw std::invalid_argument(u8"Channel remapping table refers to invalid channels");
+      }
+    }
+
+    this->inputChannelLookup = inputChannelLookup;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t VorbisReader::GetFrameCursorPosition() const {
     return this->frameCursor;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisReader::UseSeekIndex(const std::shared_ptr<Shared::OggSeekIndex> &seekIndex) {
+    this->seekIndex = seekIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisReader::UseStatistics(
+    const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+  ) {
+    this->statistics = statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VorbisReader::IsFarFromEnd(std::size_t frameCount) const {
+    std::uint64_t fileSize = this->file->GetSize();
+    std::uint64_t byteOffset = Platform::VorbisApi::TellRaw(this->vorbisFile);
+    if(byteOffset >= fileSize) {
+      return false;
+    }
+
+    // Add two long blocks because each block's output depends on the next one
+    const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
+    std::uint64_t maximumByteCount = (
+      (frameCount + Platform::VorbisApi::GetLongBlockSize(this->vorbisFile) * 2) *
+      this->channelCount * MaximumBytesPerChannelSecond /
+      std::max<std::uint64_t>(static_cast<std::uint64_t>(info.rate), 1)
+    );
+
+    return (fileSize - byteOffset) > (maximumByteCount + ReadAheadByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void VorbisReader::Seek(std::uint64_t frameIndex) {
+    requireSeekable();
+
+    // If we have a seek index, jump to the closest indexed page before the target frame
+    // and decode forward from there. This avoids the bisection search libvorbisfile does,
+    // which reads pages from all over the file.
+    if(static_cast<bool>(this->seekIndex)) {
+      std::optional<Shared::OggSeekIndex::Entry> entry = this->seekIndex->TryFindEntry(
+        frameIndex
+      );
+      if(entry.has_value()) {
+        Platform::VorbisApi::RawSeek(this->state->Error, this->vorbisFile, entry->ByteOffset);
+        std::uint64_t landedFrameIndex = Platform::VorbisApi::TellPcm(this->vorbisFile);
+        if(likely(landedFrameIndex <= frameIndex)) {
+          this->frameCursor = landedFrameIndex;
+          skipFrames(frameIndex - landedFrameIndex);
+          return;
+        }
+      }
+    }
+
     Platform::VorbisApi::Seek(
       this->state->Error,
       this->vorbisFile,
       frameIndex
     );
+    this->frameCursor = frameIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost VorbisReader::EstimateSeekCost(
+    std::uint64_t frameIndex, const Shared::SeekCostEstimator &estimator
+  ) const {
+    if(static_cast<bool>(this->seekIndex)) {
+      std::optional<Shared::OggSeekIndex::Entry> entry = this->seekIndex->TryFindEntry(
+        frameIndex
+      );
+      if(entry.has_value()) {
+        return estimator.Jump(std::min(entry->GranulePosition, frameIndex), frameIndex);
+      }
+    }
+
+    // libvorbisfile bisects the file and decodes forward from the page it lands on
+    return estimator.Bisect(frameIndex, frameIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Shared::DecoderCheckpoint VorbisReader::Checkpoint(std::uint64_t frameIndex) {
+    Seek(frameIndex); // also reopens the file for seeking if needed
+
+    // After the seek, libvorbisfile has read the file about up to the target frame.
+    // Jumping that far back lands us on a page before the target frame, so back off by
+    // a few pages' worth of bytes, guessing from the average bitrate, until we do.
+    std::uint64_t totalFrameCount = CountTotalFrames();
+    std::uint64_t bytesPerFrame = (totalFrameCount == 0) ? 1 : (
+      this->file->GetSize() / totalFrameCount + 1
+    );
+    std::uint64_t seekedByteOffset = Platform::VorbisApi::TellRaw(this->vorbisFile);
+    std::uint64_t backoffByteCount = CheckpointBackoffFrameCount * bytesPerFrame;
+    for(std::size_t attempt = 0; attempt < CheckpointAttemptCount; ++attempt) {
+      std::uint64_t byteOffset = (
+        (seekedByteOffset > backoffByteCount) ? (seekedByteOffset - backoffByteCount) : 0
+      );
+      Platform::VorbisApi::RawSeek(this->state->Error, this->vorbisFile, byteOffset);
+      std::uint64_t landedFrameIndex = Platform::VorbisApi::TellPcm(this->vorbisFile);
+      if(landedFrameIndex <= frameIndex) {
+        this->frameCursor = landedFrameIndex;
+        skipFrames(frameIndex - landedFrameIndex);
+        return Shared::DecoderCheckpoint { frameIndex, landedFrameIndex, byteOffset, true };
+      }
+
+      backoffByteCount *= 4;
+    }
+
+    Seek(frameIndex);
+    return Shared::DecoderCheckpoint { frameIndex, frameIndex, 0, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisReader::Restore(const Shared::DecoderCheckpoint &checkpoint) {
+    requireSeekable();
+
+    if(checkpoint.IsDirect) {
+      Platform::VorbisApi::RawSeek(this->state->Error, this->vorbisFile, checkpoint.ByteOffset);
+      std::uint64_t landedFrameIndex = Platform::VorbisApi::TellPcm(this->vorbisFile);
+      if(likely(landedFrameIndex == checkpoint.ResumeFrameIndex)) {
+        this->frameCursor = landedFrameIndex;
+        skipFrames(checkpoint.FrameIndex - landedFrameIndex);
+        return;
+      }
+    }
+
+    Seek(checkpoint.FrameIndex);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -238,10 +499,64 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisReader::DecodeNative(DecodedSampleSink &sink, std::size_t frameCount) {
+    std::vector<const void *> &channels = this->sinkChannels;
+
+    while(0 < frameCount) {
+
+      // libvorbisfile hands out its own buffers, which is just what we need here.
+      // We only need to put the channels into the order we promised.
+      float **samples = nullptr;
+      int streamIndex = -1;
+      std::size_t decodedFrameCount = Platform::VorbisApi::ReadFloat(
+        this->state->Error,
+        this->vorbisFile,
+        samples,
+        static_cast<int>(std::min<std::size_t>(frameCount, 8192)),
+        streamIndex
+      );
+      if(decodedFrameCount == 0) {
+        throw Errors::CorruptedFileError(
+          u8"Unexpected end of audio stream decoding Vorbis file. File truncated?"
+        );
+      }
+
+      std::uint64_t startFrame = this->frameCursor;
+      this->frameCursor += decodedFrameCount;
+
+      if(streamIndex != 0) {
+        throw std::runtime_error(
+          u8"Vorbis decoding reached another stream. Multi-stream files are not supported."
+        );
+      }
+
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        channels[channelIndex] = samples[this->inputChannelLookup[channelIndex]];
+      }
+
+      DecodedSamples decodedSamples;
+      decodedSamples.Format = AudioSampleFormat::Float_32;
+      decodedSamples.BitsPerSample = 32;
+      decodedSamples.StartFrame = startFrame;
+      decodedSamples.FrameCount = decodedFrameCount;
+      decodedSamples.ChannelCount = this->channelCount;
+      decodedSamples.IsInterleaved = false;
+      decodedSamples.Buffers = channels.data();
+      sink.ProcessSamples(decodedSamples);
+
+      frameCount -= decodedFrameCount;
+    }
+
+    extendSeekIndex();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TSample>
   void VorbisReader::decodeSeparatedConvertAndInterleave(
     TSample *target, std::size_t frameCount
   ) {
+    std::vector<const float *> &channels = this->decodedChannels;
 
     while(0 < frameCount) {
 
@@ -277,10 +592,17 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
         std::is_same<TSample, float>::value ||
         std::is_same<TSample, double>::value
       );
-      if constexpr(targetIsFloat) {
+      if constexpr(std::is_same<TSample, float>::value) {
+        for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+          channels[channelIndex] = samples[this->inputChannelLookup[channelIndex]];
+        }
+        Processing::Interleaver::Interleave(
+          channels.data(), target, this->channelCount, decodedFrameCount
+        );
+      } else if constexpr(targetIsFloat) {
         for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
           TSample *channelTarget = target + channelIndex;
-          float *source = samples[channelIndex];
+          float *source = samples[this->inputChannelLookup[channelIndex]];
           for(std::size_t sampleIndex = 0; sampleIndex < decodedFrameCount; ++sampleIndex) {
             *channelTarget = static_cast<TSample>(source[sampleIndex]);
             channelTarget += this->channelCount;
@@ -301,7 +623,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
         for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
           std::size_t sampleCount = decodedFrameCount;
           TSample *channelTarget = target + channelIndex;
-          float *source = samples[channelIndex];
+          float *source = samples[this->inputChannelLookup[channelIndex]];
 
           while(3 < sampleCount) {
             std::int32_t scaled[4];
@@ -352,6 +674,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
       frameCount -= decodedFrameCount;
     }
 
+    extendSeekIndex();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -361,12 +684,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     TSample *targets[], std::size_t frameCount
   ) {
 
-    // The channel pointers are in a caller-provided array, if we changed them,
-    // we'd trash the caller's own pointers, so we have to take a copy.
-    std::vector<TSample *> mutableTargets(this->channelCount);
-    for(std::size_t index = 0; index < this->channelCount; ++index) {
-      mutableTargets[index] = targets[index];
-    }
+    // The channel pointers are in a caller-provided array, so rather than advancing
+    // them, we keep track of how many frames have been written to each channel
+    std::size_t writtenFrameCount = 0;
 
     while(0 < frameCount) {
 
@@ -402,18 +722,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
       // Floating point can be memory-copied into the output buffers unchanged
       if constexpr(std::is_same<TSample, float>::value) {
         for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
-          std::copy_n(samples[channelIndex], decodedFrameCount, mutableTargets[channelIndex]);
-          mutableTargets[channelIndex] += decodedFrameCount;
+          if(targets[channelIndex] == nullptr) {
+            continue; // Caller is not interested in this channel
+          }
+
+          std::copy_n(
+            samples[this->inputChannelLookup[channelIndex]],
+            decodedFrameCount,
+            targets[channelIndex] + writtenFrameCount
+          );
         }
       } else if constexpr(std::is_same<TSample, double>::value) { // float -> double
         for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
-          double *target = mutableTargets[channelIndex];
-          float *source = samples[channelIndex];
+          if(targets[channelIndex] == nullptr) {
+            continue; // Caller is not interested in this channel
+          }
+
+          double *target = targets[channelIndex] + writtenFrameCount;
+          float *source = samples[this->inputChannelLookup[channelIndex]];
           for(std::size_t sampleIndex = 0; sampleIndex < decodedFrameCount; ++sampleIndex) {
             target[sampleIndex] = static_cast<double>(source[sampleIndex]);
           }
-
-          mutableTargets[channelIndex] += decodedFrameCount;
         }
       } else { // float -> integer
         typedef typename std::conditional<
@@ -424,9 +753,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
         );
 
         for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+          if(targets[channelIndex] == nullptr) {
+            continue; // Caller is not interested in this channel
+          }
+
           std::size_t sampleCount = decodedFrameCount;
-          TSample *target = mutableTargets[channelIndex];
-          float *source = samples[channelIndex];
+          TSample *target = targets[channelIndex] + writtenFrameCount;
+          float *source = samples[this->inputChannelLookup[channelIndex]];
 
           while(3 < sampleCount) {
             std::int32_t scaled[4];
@@ -469,14 +802,86 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
             ++target;
             --sampleCount;
           }
-
-          mutableTargets[channelIndex] += decodedFrameCount;
         }
       }
 
+      writtenFrameCount += decodedFrameCount;
       frameCount -= decodedFrameCount;
     }
 
+    extendSeekIndex();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisReader::skipFrames(std::uint64_t frameCount) {
+    if(static_cast<bool>(this->statistics)) {
+      this->statistics->AddDiscardedFrames(frameCount);
+    }
+
+    while(0 < frameCount) {
+      float **samples = nullptr;
+      int streamIndex = -1;
+      std::size_t decodedFrameCount = Platform::VorbisApi::ReadFloat(
+        this->state->Error,
+        this->vorbisFile,
+        samples,
+        static_cast<int>(std::min<std::uint64_t>(frameCount, 8192)),
+        streamIndex
+      );
+      if(decodedFrameCount == 0) {
+        throw Errors::CorruptedFileError(
+          u8"Unexpected end of audio stream skipping to seek target in Vorbis file."
+        );
+      }
+
+      this->frameCursor += decodedFrameCount;
+      frameCount -= decodedFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisReader::extendSeekIndex() {
+    if(static_cast<bool>(this->seekIndex)) {
+      this->seekIndex->ScanBehindDecoder(
+        *this->file, Platform::VorbisApi::TellRaw(this->vorbisFile)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisReader::requireSeekable() {
+    if(likely(this->isSeekable)) {
+      return;
+    }
+
+    // Closing an OggVorbis_File resets the file in its adapter state, so the seekable
+    // one needs its own adapter state until the previous OggVorbis_File has been released.
+    std::unique_ptr<ReadOnlyFileAdapterState> newState = (
+      FileAdapterFactory::CreateAdapterForReading(this->file, this->fileCallbacks, true)
+    );
+    std::shared_ptr<::OggVorbis_File> newVorbisFile = Platform::VorbisApi::OpenFromCallbacks(
+      newState->Error,
+      newState.get(),
+      this->fileCallbacks
+    );
+    FileAdapterState::RethrowPotentialException(*newState);
+
+    std::size_t streamCount = Platform::VorbisApi::CountStreams(newVorbisFile);
+    if(streamCount != 1) {
+      throw std::runtime_error(u8"Multi-stream Vorbis files are not supported");
+    }
+
+    this->vorbisFile = std::move(newVorbisFile);
+    this->state = std::move(newState);
+    this->isSeekable = true;
+
+    // The seekable file starts at the beginning again, return to where we were
+    if(this->frameCursor > 0) {
+      Seek(this->frameCursor);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -25,6 +25,8 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_VORBIS)
 
 #include "Nuclex/Audio/ChannelPlacement.h"
+#include "../Shared/DecoderCheckpoint.h" // for DecoderCheckpoint
+#include "../Shared/SeekCostEstimator.h" // for SeekCostEstimator
 
 #include <string> // for std::string
 #include <cstddef> // for std::size_t
@@ -49,6 +51,24 @@ namespace Nuclex { namespace Audio { namespace Storage {
   // ------------------------------------------------------------------------------------------- //
 
   class VirtualFile;
+  class DecodedSampleSink;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class OggSeekIndex;
+  class DecoderStatisticsCollector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
+
+namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -73,23 +93,77 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
     /// <summary>Initializes a new Vorbis reader on the specified file</summary>
     /// <param name="file">File the reader will access</param>
-    public: VorbisReader(const std::shared_ptr<const VirtualFile> &file);
+    /// <param name="deferLengthScan">
+    ///   Whether to open the file without letting libvorbisfile seek. It then only reads
+    ///   the headers, skipping the look at the end of the file that determines its length.
+    ///   The file is reopened for seeking once a seek or the exact length is requested.
+    /// </param>
+    public: VorbisReader(
+      const std::shared_ptr<const VirtualFile> &file, bool deferLengthScan = false
+    );
 
     /// <summary>Frees all resources owned by the Vorbis reader</summary>
     public: ~VorbisReader();
 
     /// <summary>Reads the metadata from an Vorbis audi ofile</summary>
     /// <param name="target">Track information container that will receive the metadata</param>
-    public: void ReadMetadata(TrackInfo &target);
+    /// <param name="includeTags">
+    ///   Whether to look through the comments for loop points. Decoders don't expose
+    ///   the track information and pass false to skip that work when opening.
+    /// </param>
+    public: void ReadMetadata(TrackInfo &target, bool includeTags = true);
 
     /// <summary>Counts the total number of frames (= samples in each channel)</summary>
     /// <returns>The total number of frames in the audio file</returns>
-    public: std::uint64_t CountTotalFrames() const;
+    /// <remarks>
+    ///   If the reader was opened without seeking, this reopens the file for seeking.
+    /// </remarks>
+    public: std::uint64_t CountTotalFrames();
+
+    /// <summary>Checks whether the exact number of frames is known already</summary>
+    /// <returns>True if <see cref="CountTotalFrames" /> would not touch the file</returns>
+    public: bool IsTotalFrameCountKnown() const { return this->isSeekable; }
+
+    /// <summary>Guesses the total number of frames without reading more of the file</summary>
+    /// <returns>The exact number of frames if known, otherwise an estimate</returns>
+    public: std::uint64_t EstimateTotalFrames() const;
+
+    /// <summary>Checks whether decoding can surely go on without reaching the end</summary>
+    /// <param name="frameCount">Number of frames that would be decoded</param>
+    /// <returns>
+    ///   True if more of the file remains than the frames could take up at the highest
+    ///   bit rate Vorbis is used with, false if they might reach the end of the stream
+    /// </returns>
+    public: bool IsFarFromEnd(std::size_t frameCount) const;
 
     /// <summary>Gets the order in which interlaved samples are decoded</summary>
     /// <returns>A list of channels in the order they are interleaved</returns>
+    /// <remarks>
+    ///   This is the native channel order of the Vorbis file and doesn't take into
+    ///   account any remapping set via <see cref="RemapChannels" />.
+    /// </remarks>
     public: std::vector<ChannelPlacement> GetChannelOrder() const;
 
+    /// <summary>Makes the reader deliver the channels in a different order</summary>
+    /// <param name="inputChannelLookup">
+    ///   Native channel index that should be delivered for each output channel, as
+    ///   produced by <see cref="Shared::ChannelOrderTransformer::CreateRemappingTable" />
+    /// </param>
+    /// <remarks>
+    ///   The channels are picked from libvorbisfile's buffers through this table while
+    ///   they are being converted and interleaved, so reordering costs nothing extra.
+    /// </remarks>
+    public: void RemapChannels(const std::vector<std::size_t> &inputChannelLookup);
+
+    /// <summary>Determines the number of frames a typical Vorbis packet decodes to</summary>
+    /// <returns>The number of frames produced by a packet using the long block size</returns>
+    /// <remarks>
+    ///   Vorbis blocks overlap by half, so each long block contributes half its size in
+    ///   new frames. Short blocks (used for transients) produce fewer frames, so this is
+    ///   a nominal value, not a guarantee for every packet.
+    /// </remarks>
+    public: std::size_t GetNominalPacketFrameCount() const;
+
     /// <summary>Retrieves the current position of the frame cursor</summary>
     /// <returns>The frame cursor, pointing at the frame that will be decoded next</returns>
     public: std::uint64_t GetFrameCursorPosition() const;
@@ -98,6 +172,37 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     /// <param name="frameIndex">Index of the frame that should be decoded next</param>
     public: void Seek(std::uint64_t frameIndex);
 
+    /// <summary>Estimates how much work moving the frame cursor would be</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <param name="estimator">Estimator that turns the chosen strategy into a cost</param>
+    /// <returns>The estimated cost of a call to <see cref="Seek" /></returns>
+    public: SeekCost EstimateSeekCost(
+      std::uint64_t frameIndex, const Shared::SeekCostEstimator &estimator
+    ) const;
+
+    /// <summary>Moves the frame cursor to a frame and records how to return there</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <returns>A checkpoint through which the reader can quickly return to the frame</returns>
+    public: Shared::DecoderCheckpoint Checkpoint(std::uint64_t frameIndex);
+
+    /// <summary>Moves the frame cursor back to a checkpoint's frame</summary>
+    /// <param name="checkpoint">Checkpoint previously returned by Checkpoint()</param>
+    public: void Restore(const Shared::DecoderCheckpoint &checkpoint);
+
+    /// <summary>Lets the reader use and extend a seek index for the file</summary>
+    /// <param name="seekIndex">Seek index the reader will use when seeking</param>
+    /// <remarks>
+    ///   The seek index may be shared between multiple readers on the same file.
+    ///   Readers will extend it while they decode sequentially through the file.
+    /// </remarks>
+    public: void UseSeekIndex(const std::shared_ptr<Shared::OggSeekIndex> &seekIndex);
+
+    /// <summary>Lets the reader report discarded frames to a statistics collector</summary>
+    /// <param name="statistics">Collector that will track the discarded frames</param>
+    public: void UseStatistics(
+      const std::shared_ptr<Shared::DecoderStatisticsCollector> &statistics
+    );
+
     /// <summary>Decodes samples from the audio file in interleaved format</summary>
     /// <typename name="TSample">Type of samples that will be decoded</typename>
     /// <param name="target">Buffer into which the samples will be written</param>
@@ -111,6 +216,11 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     public: template<typename TSample>
     void DecodeSeparated(TSample *targets[], std::size_t frameCount);
 
+    /// <summary>Decodes samples and hands libvorbisfile's own buffers to a sink</summary>
+    /// <param name="sink">Sink that will receive the decoded samples</param>
+    /// <param name="frameCount">Number of frame that should be decoded</param>
+    public: void DecodeNative(DecodedSampleSink &sink, std::size_t frameCount);
+
     /// <summary>Decodes samples from the audio file and converts them</summary>
     /// <typename name="TSample">Type of samples to convert to</typename>
     /// <param name="target">Buffer into which the samples will be written</param>
@@ -136,6 +246,19 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     private: template<typename TSample>
     void decodeSeparatedAndConvert(TSample *targets[], std::size_t frameCount);
 
+    /// <summary>Decodes and discards the specified number of frames</summary>
+    /// <param name="frameCount">Number of frames that will be skipped</param>
+    private: void skipFrames(std::uint64_t frameCount);
+
+    /// <summary>Extends the seek index up to the decoder's current read position</summary>
+    private: void extendSeekIndex();
+
+    /// <summary>Reopens the file with seeking enabled if it was opened without</summary>
+    /// <remarks>
+    ///   The reader's frame cursor, channel remapping and seek index are kept.
+    /// </remarks>
+    private: void requireSeekable();
+
     /// <summary>File the reader is accessing</summary>
     private: std::shared_ptr<const VirtualFile> file;
     /// <summary>Holds the function pointers to the file I/O functions</summary>
@@ -148,11 +271,23 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     private: std::unique_ptr<ReadOnlyFileAdapterState> state;
     /// <summary>Manages the state and decoder state of the opened Vorbis file</summary>
     private: std::shared_ptr<::OggVorbis_File> vorbisFile;
+    /// <summary>Whether libvorbisfile was allowed to seek when the file was opened</summary>
+    private: bool isSeekable;
 
     /// <summary>Number of channels in the Vorbis file</summary>
     private: std::size_t channelCount;
     /// <summary>Index of the audio frame that will be decoded next</summary>
     private: std::uint64_t frameCursor;
+    /// <summary>Native channel index to deliver for each output channel</summary>
+    private: std::vector<std::size_t> inputChannelLookup;
+    /// <summary>Channels handed out by libvorbisfile, in the delivered order</summary>
+    private: std::vector<const float *> decodedChannels;
+    /// <summary>Channels handed to a sample sink, in the delivered order</summary>
+    private: std::vector<const void *> sinkChannels;
+    /// <summary>Seek index used to jump close to a frame, may be empty</summary>
+    private: std::shared_ptr<Shared::OggSeekIndex> seekIndex;
+    /// <summary>Collects statistics about the reader's work, may be empty</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
 
   };
 
@@ -0,0 +1,117 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./VorbisSequentialDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "../../Platform/VorbisApi.h" // for the wrapped Vorbis API methods
+#include "../Shared/ChannelOrderFactory.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisSequentialDecoder::VorbisSequentialDecoder(
+    const std::shared_ptr<SequentialSource> &source
+  ) :
+    state(),
+    fileCallbacks(),
+    vorbisFile(),
+    channelCount(0),
+    sampleRate(0),
+    channelOrder(),
+    cursor(0) {
+    this->state = FileAdapterFactory::CreateAdapterForSequentialReading(
+      source, this->fileCallbacks
+    );
+    this->vorbisFile = Platform::VorbisApi::OpenFromCallbacks(
+      this->state->Error, this->state.get(), this->fileCallbacks
+    );
+    FileAdapterState::RethrowPotentialException(*this->state);
+
+    const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
+    this->channelCount = static_cast<std::size_t>(info.channels);
+    this->sampleRate = static_cast<std::size_t>(info.rate);
+    this->channelOrder = Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(
+      1, this->channelCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisSequentialDecoder::~VorbisSequentialDecoder() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VorbisSequentialDecoder::DecodeInterleaved(float *buffer, std::size_t frameCount) {
+    if(frameCount == 0) {
+      return 0;
+    }
+
+    // libvorbisfile hands out its own buffers, so we only need to interleave them
+    float **samples = nullptr;
+    int streamIndex = -1;
+    std::size_t decodedFrameCount = Platform::VorbisApi::ReadFloat(
+      this->state->Error,
+      this->vorbisFile,
+      samples,
+      static_cast<int>(std::min<std::size_t>(frameCount, 8192)),
+      streamIndex
+    );
+    FileAdapterState::RethrowPotentialException(*this->state);
+    if(decodedFrameCount == 0) {
+      return 0;
+    }
+
+    // A chained stream may continue with a link in a different format. Delivering
+    // those samples as if nothing happened would produce garbage, so stop here.
+    const ::vorbis_info &info = Platform::VorbisApi::GetStreamInformation(this->vorbisFile);
+    bool formatChanged = (
+      (static_cast<std::size_t>(info.channels) != this->channelCount) ||
+      (static_cast<std::size_t>(info.rate) != this->sampleRate)
+    );
+    if(formatChanged) {
+      throw std::runtime_error(
+        u8"Chained Vorbis stream changed its channel count or sample rate"
+      );
+    }
+
+    for(std::size_t frameIndex = 0; frameIndex < decodedFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+        *buffer = samples[channelIndex][frameIndex];
+        ++buffer;
+      }
+    }
+    this->cursor += decodedFrameCount;
+
+    return decodedFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
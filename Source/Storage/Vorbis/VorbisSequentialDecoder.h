@@ -0,0 +1,106 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSEQUENTIALDECODER_H
+#define NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSEQUENTIALDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "./VorbisVirtualFileAdapter.h" // for SequentialSourceAdapterState
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes an Ogg Vorbis stream front to back from a sequential source</summary>
+  /// <remarks>
+  ///   libvorbisfile treats a stream without seek and tell callbacks as unseekable and
+  ///   simply decodes pages as they arrive. Without seeking, the last granule position
+  ///   can't be looked up, so the number of frames is never known up front. Chained
+  ///   streams are decoded one link after another as long as the channel count
+  ///   and sample rate stay the same.
+  /// </remarks>
+  class VorbisSequentialDecoder : public SequentialTrackDecoder {
+
+    /// <summary>Initializes a new sequential Vorbis decoder reading from a source</summary>
+    /// <param name="source">Source from which the Ogg Vorbis stream will be read</param>
+    public: VorbisSequentialDecoder(const std::shared_ptr<SequentialSource> &source);
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~VorbisSequentialDecoder() override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override { return this->channelCount; }
+
+    /// <summary>Produces the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the number of samples per second in each channel</summary>
+    /// <returns>The sample rate of the audio track</returns>
+    public: std::size_t GetSampleRate() const override { return this->sampleRate; }
+
+    /// <summary>Returns the number of frames in the track if it is known</summary>
+    /// <returns>Nothing, unseekable Vorbis streams don't reveal their length</returns>
+    public: std::optional<std::uint64_t> TryCountFrames() const override {
+      return std::optional<std::uint64_t>();
+    }
+
+    /// <summary>Returns the number of frames that have been delivered so far</summary>
+    /// <returns>The index of the frame that will be delivered next</returns>
+    public: std::uint64_t GetFrameCursorPosition() const override { return this->cursor; }
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of audio frames that should be delivered</param>
+    /// <returns>The number of frames delivered, zero at the end of the track</returns>
+    public: std::size_t DecodeInterleaved(float *buffer, std::size_t frameCount) override;
+
+    /// <summary>Adapter through which libvorbisfile reads from the sequential source</summary>
+    private: std::unique_ptr<SequentialSourceAdapterState> state;
+    /// <summary>Callbacks libvorbisfile uses to read from the adapter</summary>
+    private: ::ov_callbacks fileCallbacks;
+    /// <summary>Vorbis stream opened by libvorbisfile</summary>
+    private: std::shared_ptr<::OggVorbis_File> vorbisFile;
+    /// <summary>Number of audio channels in the track</summary>
+    private: std::size_t channelCount;
+    /// <summary>Number of samples per second in each channel</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Order in which the channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Index of the next frame that will be delivered</summary>
+    private: std::uint64_t cursor;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSEQUENTIALDECODER_H
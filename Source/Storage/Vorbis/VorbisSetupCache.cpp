@@ -0,0 +1,270 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./VorbisSetupCache.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include <cstdint> // for std::uint64_t
+#include <cstring> // for std::memcmp()
+#include <map> // for std::map
+#include <mutex> // for std::mutex
+#include <utility> // for std::move()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Setup that has been parsed and handed out to streams</summary>
+  struct CachedSetup {
+
+    /// <summary>Identification and setup headers the setup was parsed from</summary>
+    public: std::vector<std::byte> Headers;
+    /// <summary>Size of the identification header at the start of the headers</summary>
+    public: std::size_t IdentificationSize;
+    /// <summary>Parsed setup, if any stream still uses it</summary>
+    public: std::weak_ptr<::vorbis_info> Info;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Setups that are currently in use, for lookup by their headers</summary>
+  struct SetupCache {
+
+    /// <summary>Must be held while accessing the setups</summary>
+    public: std::mutex Mutex;
+    /// <summary>Setups that have been parsed, by hash of their headers</summary>
+    public: std::multimap<std::uint64_t, CachedSetup> Setups;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the cache holding all setups that are currently in use</summary>
+  /// <returns>The setup cache</returns>
+  SetupCache &getSetupCache() {
+    static SetupCache cache;
+    return cache;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Continues calculating an FNV-1a hash over a range of bytes</summary>
+  /// <param name="hash">Hash calculated so far</param>
+  /// <param name="data">Bytes that will be added to the hash</param>
+  /// <param name="size">Number of bytes to add</param>
+  /// <returns>The updated hash</returns>
+  std::uint64_t hashBytes(std::uint64_t hash, const std::byte *data, std::size_t size) {
+    for(std::size_t index = 0; index < size; ++index) {
+      hash ^= static_cast<std::uint64_t>(data[index]);
+      hash *= 0x100000001B3ULL;
+    }
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a cached setup was parsed from the specified headers</summary>
+  /// <param name="cached">Cached setup that will be checked</param>
+  /// <param name="identification">Identification header of the new stream</param>
+  /// <param name="identificationSize">Size of the identification header in bytes</param>
+  /// <param name="setup">Setup header of the new stream</param>
+  /// <param name="setupSize">Size of the setup header in bytes</param>
+  /// <returns>True if the headers are identical to those of the cached setup</returns>
+  bool matchesHeaders(
+    const CachedSetup &cached,
+    const std::byte *identification, std::size_t identificationSize,
+    const std::byte *setup, std::size_t setupSize
+  ) {
+    return (
+      (cached.IdentificationSize == identificationSize) &&
+      (cached.Headers.size() == identificationSize + setupSize) &&
+      (std::memcmp(cached.Headers.data(), identification, identificationSize) == 0) &&
+      (std::memcmp(cached.Headers.data() + identificationSize, setup, setupSize) == 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wraps a buffer in an Ogg packet structure for libvorbis</summary>
+  /// <param name="data">Buffer holding the packet's contents</param>
+  /// <param name="size">Size of the packet in bytes</param>
+  /// <param name="packetNumber">Sequential number of the packet</param>
+  /// <returns>An Ogg packet structure referencing the buffer</returns>
+  ::ogg_packet makePacket(const std::byte *data, std::size_t size, ::ogg_int64_t packetNumber) {
+    ::ogg_packet packet;
+    packet.packet = const_cast<unsigned char *>(reinterpret_cast<const unsigned char *>(data));
+    packet.bytes = static_cast<long>(size);
+    packet.b_o_s = (packetNumber == 0) ? 1 : 0;
+    packet.e_o_s = 0;
+    packet.granulepos = -1;
+    packet.packetno = packetNumber;
+    return packet;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees a parsed setup when the last stream using it is done</summary>
+  /// <param name="info">Setup that will be freed</param>
+  void destroySetup(::vorbis_info *info) {
+    ::vorbis_info_clear(info);
+    delete info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses the Vorbis headers and builds the codebooks' decode tables</summary>
+  /// <param name="identification">Identification header of the stream</param>
+  /// <param name="identificationSize">Size of the identification header in bytes</param>
+  /// <param name="comment">Comment header of the stream</param>
+  /// <param name="commentSize">Size of the comment header in bytes</param>
+  /// <param name="setup">Setup header of the stream</param>
+  /// <param name="setupSize">Size of the setup header in bytes</param>
+  /// <returns>The parsed setup or an empty pointer if the headers are invalid</returns>
+  std::shared_ptr<::vorbis_info> parseSetup(
+    const std::byte *identification, std::size_t identificationSize,
+    const std::byte *comment, std::size_t commentSize,
+    const std::byte *setup, std::size_t setupSize
+  ) {
+    std::shared_ptr<::vorbis_info> info(new ::vorbis_info(), &destroySetup);
+    ::vorbis_info_init(info.get());
+
+    // libvorbis insists on seeing the comment header between the other two,
+    // but its contents end up in the comment structure which is dropped again
+    ::vorbis_comment comments;
+    ::vorbis_comment_init(&comments);
+    {
+      const std::byte *headers[] = { identification, comment, setup };
+      std::size_t headerSizes[] = { identificationSize, commentSize, setupSize };
+      for(std::size_t index = 0; index < 3; ++index) {
+        ::ogg_packet header = makePacket(
+          headers[index], headerSizes[index], static_cast<::ogg_int64_t>(index)
+        );
+        if(::vorbis_synthesis_headerin(info.get(), &comments, &header) != 0) {
+          ::vorbis_comment_clear(&comments);
+          return std::shared_ptr<::vorbis_info>();
+        }
+      }
+    }
+    ::vorbis_comment_clear(&comments);
+
+    // The decode tables of the codebooks are only built by the first synthesis state
+    // initialized from the setup. Doing it here means later users only read the setup.
+    ::vorbis_dsp_state primingState;
+    if(::vorbis_synthesis_init(&primingState, info.get()) != 0) {
+      return std::shared_ptr<::vorbis_info>();
+    }
+    ::vorbis_dsp_clear(&primingState);
+
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<::vorbis_info> VorbisSetupCache::Acquire(
+    const std::byte *identification, std::size_t identificationSize,
+    const std::byte *comment, std::size_t commentSize,
+    const std::byte *setup, std::size_t setupSize
+  ) {
+    std::uint64_t hash = hashBytes(
+      hashBytes(0xCBF29CE484222325ULL, identification, identificationSize),
+      setup, setupSize
+    );
+
+    SetupCache &cache = getSetupCache();
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      auto range = cache.Setups.equal_range(hash);
+      for(auto iterator = range.first; iterator != range.second; ++iterator) {
+        if(matchesHeaders(iterator->second, identification, identificationSize, setup, setupSize)) {
+          std::shared_ptr<::vorbis_info> info = iterator->second.Info.lock();
+          if(static_cast<bool>(info)) {
+            return info;
+          }
+        }
+      }
+    }
+
+    // Parse the setup outside of the lock. If another thread parsed the same setup
+    // in the meantime, both are used, they just won't share their codebooks.
+    std::shared_ptr<::vorbis_info> info = parseSetup(
+      identification, identificationSize, comment, commentSize, setup, setupSize
+    );
+    if(!static_cast<bool>(info)) {
+      return info;
+    }
+
+    CachedSetup cached;
+    cached.Headers.reserve(identificationSize + setupSize);
+    cached.Headers.assign(identification, identification + identificationSize);
+    cached.Headers.insert(cached.Headers.end(), setup, setup + setupSize);
+    cached.IdentificationSize = identificationSize;
+    cached.Info = info;
+
+    {
+      std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+      // Drop cache entries whose setups are no longer used by anyone
+      for(auto iterator = cache.Setups.begin(); iterator != cache.Setups.end();) {
+        if(iterator->second.Info.expired()) {
+          iterator = cache.Setups.erase(iterator);
+        } else {
+          ++iterator;
+        }
+      }
+
+      cache.Setups.emplace(hash, std::move(cached));
+    }
+
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VorbisSetupCache::CountCachedSetups() {
+    SetupCache &cache = getSetupCache();
+    std::lock_guard<std::mutex> cacheMutexScope(cache.Mutex);
+
+    std::size_t setupCount = 0;
+    for(auto iterator = cache.Setups.begin(); iterator != cache.Setups.end(); ++iterator) {
+      if(!iterator->second.Info.expired()) {
+        ++setupCount;
+      }
+    }
+
+    return setupCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,94 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSETUPCACHE_H
+#define NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSETUPCACHE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include <vorbis/codec.h> // for ::vorbis_info
+
+#include <cstddef> // for std::byte, std::size_t
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shares parsed Vorbis setups between streams using identical headers</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The setup header of a Vorbis stream carries the codebooks, floors and residues
+  ///     the encoder used. Parsing it and building the codebooks' decode tables is the bulk
+  ///     of the work (and memory) of opening a Vorbis stream, yet all clips produced by
+  ///     the same encoder version and quality setting have byte-identical setup headers.
+  ///   </para>
+  ///   <para>
+  ///     This cache keys parsed setups by a hash of the identification and setup headers
+  ///     (the comment header differs per clip and is not part of the setup) and hands
+  ///     out the same <see cref="::vorbis_info" /> to all streams that match. libvorbis
+  ///     builds the decode tables the first time a synthesis state is initialized from
+  ///     a <see cref="::vorbis_info" /> and only reads them afterwards, so the cache does
+  ///     that once before publishing a setup, after which any number of synthesis states
+  ///     can be initialized from it, concurrently, too.
+  ///   </para>
+  ///   <para>
+  ///     The cache only holds weak references, a setup is freed when the last stream
+  ///     using it is closed.
+  ///   </para>
+  /// </remarks>
+  class VorbisSetupCache {
+
+    /// <summary>Looks up or parses the setup described by a stream's headers</summary>
+    /// <param name="identification">Identification header of the stream</param>
+    /// <param name="identificationSize">Size of the identification header in bytes</param>
+    /// <param name="comment">Comment header of the stream</param>
+    /// <param name="commentSize">Size of the comment header in bytes</param>
+    /// <param name="setup">Setup header of the stream</param>
+    /// <param name="setupSize">Size of the setup header in bytes</param>
+    /// <returns>
+    ///   The parsed setup with its decode tables built, or an empty pointer if
+    ///   the headers are not valid Vorbis headers
+    /// </returns>
+    /// <remarks>
+    ///   The returned setup is shared and must not be modified. It can be passed to
+    ///   ::vorbis_synthesis_init() as often as needed and must outlive all synthesis
+    ///   states that have been initialized from it.
+    /// </remarks>
+    public: static std::shared_ptr<::vorbis_info> Acquire(
+      const std::byte *identification, std::size_t identificationSize,
+      const std::byte *comment, std::size_t commentSize,
+      const std::byte *setup, std::size_t setupSize
+    );
+
+    /// <summary>Counts the setups that are currently in use and cached</summary>
+    /// <returns>The number of distinct setups alive</returns>
+    public: static std::size_t CountCachedSetups();
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_STORAGE_VORBIS_VORBISSETUPCACHE_H
@@ -26,14 +26,33 @@ limitations under the License.
 
 #include "Nuclex/Audio/Processing/SampleConverter.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Storage/VirtualFile.h"
 
 #include "./VorbisReader.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+#include "../Shared/OggSeekIndex.h" // for OggSeekIndex
+#include "../Shared/DecodePathBuilder.h"
+#include "../Shared/SeekCostEstimator.h"
+#include "../Shared/ChannelOrderTransformer.h" // for ChannelOrderTransformer
+#include "../Shared/OggPageVerifier.h" // for OggPageVerifier
 
 #include <cassert> // for assert()
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Distance, in milliseconds, between entries in the seek index</summary>
+  /// <remarks>
+  ///   With one entry every half second, the index stays around 110 KiB per hour of
+  ///   audio and a seek never has to decode forward through more than a few pages.
+  /// </remarks>
+  const std::uint64_t SeekIndexIntervalMilliseconds = 500;
+
+  /// <summary>Value the total frame count has while it hasn't been looked up</summary>
+  const std::uint64_t UnknownFrameCount = std::uint64_t(-1);
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -43,18 +62,73 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
   // ------------------------------------------------------------------------------------------- //
 
   VorbisTrackDecoder::VorbisTrackDecoder(const std::shared_ptr<const VirtualFile> &file) :
-    reader(file),
+    file(file),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(Shared::TrackedCodec::Vorbis)
+    ),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, file), true),
     trackInfo(),
     channelOrder(),
-    totalFrameCount(std::uint64_t(-1)),
+    totalFrameCount(UnknownFrameCount),
+    blockSize(0),
+    seekIndex(),
+    checkpoints(),
+    verifier(),
     decodingMutex() {
 
-    this->reader.ReadMetadata(this->trackInfo);
+    this->reader.ReadMetadata(this->trackInfo, false);
 
     // Vorbis uses its own channel order that the reader will correctly determine for us
     this->channelOrder = this->reader.GetChannelOrder();
 
-    this->totalFrameCount = this->reader.CountTotalFrames();
+    // The total frame count is looked up only when needed. The reader was opened without
+    // seeking, so libvorbisfile hasn't gone to the end of the file to find it either.
+    this->blockSize = this->reader.GetNominalPacketFrameCount();
+
+    // Ogg has no index, so set up our own. It starts out empty and is filled while
+    // decoding sequentially or when the user asks for it to be built.
+    this->seekIndex = std::make_shared<Shared::OggSeekIndex>(
+      file->GetSize(), this->trackInfo.SampleRate * SeekIndexIntervalMilliseconds / 1000
+    );
+    this->reader.UseSeekIndex(this->seekIndex);
+    this->reader.UseStatistics(this->statistics);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisTrackDecoder::VorbisTrackDecoder(const VorbisTrackDecoder &other) :
+    file(other.file),
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(
+      Shared::TrackedCodec::Vorbis, other.statistics->IsEnabled()
+    )),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, other.file)),
+    trackInfo(other.trackInfo),
+    channelOrder(other.channelOrder),
+    totalFrameCount(other.totalFrameCount.load(std::memory_order_acquire)),
+    blockSize(other.blockSize),
+    seekIndex(other.seekIndex),
+    checkpoints(),
+    verifier(other.verifier),
+    decodingMutex() {
+
+    this->reader.UseSeekIndex(this->seekIndex);
+    this->reader.UseStatistics(this->statistics);
+
+    // Clones are made to decode in parallel, so they seek anyway. Their reader opened
+    // the file for seeking and found the length for free.
+    if(this->totalFrameCount.load(std::memory_order_relaxed) == UnknownFrameCount) {
+      this->totalFrameCount.store(this->reader.CountTotalFrames(), std::memory_order_release);
+    }
+
+    // If the other decoder was told to reorder channels, the clone needs to do the same
+    std::vector<ChannelPlacement> nativeChannelOrder = this->reader.GetChannelOrder();
+    if(this->channelOrder != nativeChannelOrder) {
+      this->reader.RemapChannels(
+        Shared::ChannelOrderTransformer::CreateRemappingTable(
+          nativeChannelOrder, this->channelOrder
+        )
+      );
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -64,7 +138,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<AudioTrackDecoder> VorbisTrackDecoder::Clone() const {
-    throw std::runtime_error(u8"Not implemented yet");
+    AllocationScope cloneScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+    return std::shared_ptr<AudioTrackDecoder>(new VorbisTrackDecoder(*this));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -81,8 +156,83 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool VorbisTrackDecoder::TrySetChannelOrder(
+    const std::vector<ChannelPlacement> &channelOrder
+  ) {
+    std::vector<std::size_t> inputChannelLookup = (
+      Shared::ChannelOrderTransformer::CreateRemappingTable(
+        this->reader.GetChannelOrder(), channelOrder
+      )
+    );
+
+    {
+      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      this->reader.RemapChannels(inputChannelLookup);
+      this->channelOrder = channelOrder;
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool VorbisTrackDecoder::TrySetVerificationPolicy(VerificationPolicy policy) {
+    if(policy == VerificationPolicy::Off) {
+      this->verifier.reset();
+    } else {
+      std::shared_ptr<const VirtualFile> verifiedFile = this->file;
+      this->verifier = std::make_shared<Shared::IntegrityVerifier>(
+        policy,
+        [verifiedFile](const CancellationToken &cancellation) {
+          return Shared::OggPageVerifier::VerifyPages(*verifiedFile, cancellation);
+        }
+      );
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VerificationResult VorbisTrackDecoder::GetVerificationResult() const {
+    if(static_cast<bool>(this->verifier)) {
+      return this->verifier->GetResult();
+    } else {
+      return VerificationResult::NotChecked;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint64_t VorbisTrackDecoder::CountFrames() const {
-    return this->totalFrameCount;
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(likely(totalFrameCount != UnknownFrameCount)) {
+      return totalFrameCount;
+    }
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    return resolveTotalFrameCount();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t VorbisTrackDecoder::EstimateFrameCount() const {
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(likely(totalFrameCount != UnknownFrameCount)) {
+      return totalFrameCount;
+    }
+
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    return this->reader.EstimateTotalFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackDecoder::ProvideFrameCount(std::uint64_t frameCount) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+    if(this->totalFrameCount.load(std::memory_order_relaxed) == UnknownFrameCount) {
+      this->totalFrameCount.store(frameCount, std::memory_order_release);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -99,18 +249,144 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics VorbisTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram VorbisTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath VorbisTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    using Shared::DecodePathBuilder;
+
+    sampleFormat = DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    std::string inlineKernelSet = DecodePathBuilder::GetInlineKernelSetName();
+
+    // libvorbisfile decodes into its own buffers, so the only pass over the samples
+    // is the one that carries them over into the caller's buffers
+    DecodePathBuilder builder(u8"Vorbis", AudioSampleFormat::Float_32, u8"separated");
+    if(sampleFormat == AudioSampleFormat::Float_32) {
+      builder.AddPass(interleaved ? (u8"Interleave " + inlineKernelSet) : u8"copy");
+    } else {
+      if(sampleFormat == AudioSampleFormat::Float_64) {
+        builder.AddPass(u8"cast");
+      } else {
+        builder.AddPass(u8"Quantize " + inlineKernelSet);
+      }
+      if(interleaved) {
+        builder.AddFusedStep(u8"interleave");
+      }
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost VorbisTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_relaxed);
+    if(totalFrameCount == UnknownFrameCount) {
+      totalFrameCount = this->reader.EstimateTotalFrames();
+    }
+
+    Shared::SeekCostEstimator estimator(
+      this->file->GetSize(), totalFrameCount, this->blockSize
+    );
+    if(this->reader.GetFrameCursorPosition() == targetFrame) {
+      return estimator.Continue();
+    }
+
+    // Mirror seekTo(), the reader knows which of its own seek strategies it would use
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(targetFrame);
+    if((checkpoint != nullptr) && checkpoint->IsDirect) {
+      return estimator.Jump(checkpoint->ResumeFrameIndex, targetFrame);
+    }
+
+    return this->reader.EstimateSeekCost(targetFrame, estimator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VorbisTrackDecoder::GetNominalBlockSize() const {
+    return this->blockSize; // Packets are either short or long blocks, this is the long one
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackDecoder::BuildSeekIndex() const {
+    this->seekIndex->ScanUntil(*this->file, this->file->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> VorbisTrackDecoder::SaveSeekIndex() const {
+    return this->seekIndex->Serialize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackDecoder::LoadSeekIndex(
+    const std::vector<std::byte> &serializedSeekIndex
+  ) const {
+    this->seekIndex->Deserialize(serializedSeekIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackDecoder::DecodeRange(
+    std::uint64_t startFrame, std::size_t frameCount, DecodedSampleSink &sink
+  ) const {
+    verifyDecodeRange(startFrame, frameCount);
+
+    {
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
+
+      // If the caller requests to read from a location that is not where the file cursor
+      // is currently at, we need to seek to that position first.
+      if(this->reader.GetFrameCursorPosition() != startFrame) {
+        seekTo(startFrame);
+      }
+
+      this->reader.DecodeNative(sink, frameCount);
+
+    } // mutex lock scope
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void VorbisTrackDecoder::DecodeInterleavedUint8(
     std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -126,12 +402,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -147,12 +426,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -168,12 +450,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -189,12 +474,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeInterleaved(buffer, frameCount);
@@ -210,12 +498,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -231,12 +522,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -252,12 +546,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -273,12 +570,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -294,12 +594,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Vorbis", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
-        this->reader.Seek(startFrame);
+        seekTo(startFrame);
       }
 
       this->reader.DecodeSeparated(buffers, frameCount);
@@ -309,22 +612,71 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void VorbisTrackDecoder::seekTo(std::uint64_t startFrame) const {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Seek Vorbis", this->file.get(), this);
+    this->statistics->AddSeek();
+
+    const Shared::DecoderCheckpoint *checkpoint = this->checkpoints.TryFindCheckpoint(startFrame);
+    if(checkpoint != nullptr) {
+      NUCLEX_AUDIO_TRACE_MARK(u8"Restore Vorbis checkpoint", this->file.get(), this);
+      this->reader.Restore(*checkpoint);
+    } else if(this->checkpoints.NoteSeek(startFrame)) {
+      this->checkpoints.AddCheckpoint(this->reader.Checkpoint(startFrame));
+    } else {
+      this->reader.Seek(startFrame);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void VorbisTrackDecoder::verifyDecodeRange(
     const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
     if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
       throw std::logic_error(u8"Unable to decode this many samples in one call");
     }
-    if(startFrame >= this->totalFrameCount) {
+
+    // Until the length has been looked up, sequential decoding that can't possibly reach
+    // the end of the stream goes ahead unchecked. That way, playing from the start only
+    // makes the reader look at the end of the file when it's about to get there anyway.
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_acquire);
+    if(unlikely(totalFrameCount == UnknownFrameCount)) {
+      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+      bool canSkipCheck = (
+        !this->reader.IsTotalFrameCountKnown() &&
+        (this->reader.GetFrameCursorPosition() == startFrame) &&
+        this->reader.IsFarFromEnd(frameCount)
+      );
+      if(canSkipCheck) {
+        return;
+      }
+
+      totalFrameCount = resolveTotalFrameCount();
+    }
+
+    if(startFrame >= totalFrameCount) {
       throw std::out_of_range(u8"Start sample index is out of bounds");
     }
-    if(this->totalFrameCount < startFrame + frameCount) {
+    if(totalFrameCount < startFrame + frameCount) {
       throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::uint64_t VorbisTrackDecoder::resolveTotalFrameCount() const {
+    std::uint64_t totalFrameCount = this->totalFrameCount.load(std::memory_order_relaxed);
+    if(totalFrameCount == UnknownFrameCount) {
+      totalFrameCount = this->reader.CountTotalFrames();
+      this->totalFrameCount.store(totalFrameCount, std::memory_order_release);
+    }
+
+    return totalFrameCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Vorbis
 
 #endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,366 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./VorbisTrackEncoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/ChannelOrderTransformer.h"
+#include "../../Platform/VorbisEncoderApi.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <random> // for std::random_device
+#include <type_traits> // for std::is_same
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames that are handed to the encoder in one go</summary>
+  const std::size_t ConversionFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisTrackEncoder::VorbisTrackEncoder(
+    const std::shared_ptr<VirtualFile> &target,
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    std::size_t sampleRate,
+    float quality
+  ) :
+    target(target),
+    writePosition(0),
+    inputChannelOrder(inputChannelOrder),
+    inputChannelIndices(),
+    inputOrderedBuffers(inputChannelOrder.size()),
+    convertedSamples(),
+    info(),
+    analysisState(),
+    block(),
+    oggStream() {
+
+    // Vorbis stores channels in the order given by the Vorbis I specification,
+    // look up which input channel has to go into each of the Vorbis channels.
+    std::size_t channelCount = this->inputChannelOrder.size();
+    this->inputChannelIndices = Shared::ChannelOrderTransformer::CreateRemappingTable(
+      this->inputChannelOrder,
+      Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(1, channelCount)
+    );
+
+    this->info = Platform::VorbisEncoderApi::CreateInfoForVariableBitrate(
+      channelCount, sampleRate, quality
+    );
+    this->analysisState = Platform::VorbisEncoderApi::CreateAnalysisState(this->info);
+    this->block = Platform::VorbisEncoderApi::CreateBlock(this->analysisState);
+
+    // Logical Ogg streams are identified by a serial number that should be random
+    // so that streams can be multiplexed or chained without clashing.
+    {
+      std::random_device randomDevice;
+      this->oggStream = Platform::VorbisEncoderApi::CreateOggStream(
+        static_cast<int>(randomDevice())
+      );
+    }
+
+    // Every Vorbis stream begins with the identification, comment and codebook headers.
+    // The specification requires the audio data to begin on a fresh page after them.
+    {
+      std::shared_ptr<::vorbis_comment> comment = (
+        Platform::VorbisEncoderApi::CreateComment()
+      );
+
+      ::ogg_packet identification, comments, codebooks;
+      Platform::VorbisEncoderApi::CreateHeaders(
+        this->analysisState, comment, identification, comments, codebooks
+      );
+      Platform::VorbisEncoderApi::SubmitPacket(this->oggStream, identification);
+      Platform::VorbisEncoderApi::SubmitPacket(this->oggStream, comments);
+      Platform::VorbisEncoderApi::SubmitPacket(this->oggStream, codebooks);
+    }
+    writePages(true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisTrackEncoder::~VorbisTrackEncoder() {
+    this->oggStream.reset();
+    this->block.reset();
+    this->analysisState.reset();
+    this->info.reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &VorbisTrackEncoder::GetChannelOrder() const {
+    return this->inputChannelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t VorbisTrackEncoder::CountWrittenBytes() const {
+    return this->writePosition;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::Flush() {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Flush Vorbis", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+
+    // Telling libvorbis that zero samples were written marks the end of the stream,
+    // after which it hands out the remaining blocks, the last one flagged as such
+    submitAndEncode(0);
+    writePages(true);
+
+    // The virtual file may be collecting writes in a buffer, make sure they get written
+    this->target->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeInterleavedUint8(
+    const std::uint8_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeInterleavedInt16(
+    const std::int16_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeInterleavedInt32(
+    const std::int32_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeInterleavedFloat(
+    const float *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeInterleavedDouble(
+    const double *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeSeparatedUint8(
+    const std::uint8_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeSeparatedInt16(
+    const std::int16_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeSeparatedInt32(
+    const std::int32_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeSeparatedFloat(
+    const float *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::EncodeSeparatedDouble(
+    const double *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void VorbisTrackEncoder::encodeInterleaved(
+    const TSample *buffer, std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Vorbis", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      float *const *targets = getAnalysisBuffersInInputOrder(chunkFrameCount);
+
+      // Floats can be deinterleaved straight into the analysis buffers. Other formats
+      // are converted in a reused buffer first because the interleaver can't convert.
+      if constexpr(std::is_same<TSample, float>::value) {
+        Processing::Interleaver::Deinterleave(buffer, targets, channelCount, chunkFrameCount);
+      } else {
+        if(this->convertedSamples.empty()) {
+          AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+          this->convertedSamples.resize(ConversionFrameCount * channelCount);
+        }
+        Processing::SampleConverter::Convert(
+          buffer, sizeof(TSample) * 8,
+          this->convertedSamples.data(), 32,
+          chunkFrameCount * channelCount
+        );
+        Processing::Interleaver::Deinterleave(
+          this->convertedSamples.data(), targets, channelCount, chunkFrameCount
+        );
+      }
+
+      submitAndEncode(chunkFrameCount);
+
+      buffer += chunkFrameCount * channelCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void VorbisTrackEncoder::encodeSeparated(
+    const TSample *buffers[], std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Vorbis", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+
+    std::size_t offset = 0;
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      float *const *targets = getAnalysisBuffersInInputOrder(chunkFrameCount);
+
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        if constexpr(std::is_same<TSample, float>::value) {
+          std::copy_n(buffers[channelIndex] + offset, chunkFrameCount, targets[channelIndex]);
+        } else {
+          Processing::SampleConverter::Convert(
+            buffers[channelIndex] + offset, sizeof(TSample) * 8,
+            targets[channelIndex], 32,
+            chunkFrameCount
+          );
+        }
+      }
+
+      submitAndEncode(chunkFrameCount);
+
+      offset += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float *const *VorbisTrackEncoder::getAnalysisBuffersInInputOrder(std::size_t frameCount) {
+    float **analysisBuffers = Platform::VorbisEncoderApi::GetAnalysisBuffer(
+      this->analysisState, frameCount
+    );
+
+    // libvorbis may move its buffers around when it grows them, so the permuted
+    // pointers need to be looked up again for each chunk
+    std::size_t channelCount = this->inputChannelOrder.size();
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      this->inputOrderedBuffers[this->inputChannelIndices[channelIndex]] = (
+        analysisBuffers[channelIndex]
+      );
+    }
+
+    return this->inputOrderedBuffers.data();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::submitAndEncode(std::size_t frameCount) {
+    Platform::VorbisEncoderApi::SubmitAnalysisBuffer(this->analysisState, frameCount);
+
+    while(Platform::VorbisEncoderApi::TakeBlock(this->analysisState, this->block)) {
+      Platform::VorbisEncoderApi::AnalyzeBlock(this->block);
+
+      ::ogg_packet packet;
+      while(Platform::VorbisEncoderApi::TakePacket(this->analysisState, packet)) {
+        Platform::VorbisEncoderApi::SubmitPacket(this->oggStream, packet);
+        writePages(false);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void VorbisTrackEncoder::writePages(bool force) {
+    ::ogg_page page;
+    while(Platform::VorbisEncoderApi::TakePage(this->oggStream, page, force)) {
+      this->target->WriteAt(
+        this->writePosition,
+        static_cast<std::size_t>(page.header_len),
+        reinterpret_cast<const std::byte *>(page.header)
+      );
+      this->writePosition += static_cast<std::uint64_t>(page.header_len);
+
+      this->target->WriteAt(
+        this->writePosition,
+        static_cast<std::size_t>(page.body_len),
+        reinterpret_cast<const std::byte *>(page.body)
+      );
+      this->writePosition += static_cast<std::uint64_t>(page.body_len);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
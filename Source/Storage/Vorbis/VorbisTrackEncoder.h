@@ -0,0 +1,216 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_VORBIS_VORBISTRACKENCODER_H
+#define NUCLEX_AUDIO_STORAGE_VORBIS_VORBISTRACKENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <vorbis/codec.h> // for ::vorbis_info, ::vorbis_dsp_state, ::vorbis_block
+#include <ogg/ogg.h> // for ::ogg_stream_state
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes audio channels to an Ogg Vorbis audio stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     libvorbisenc wants its input as separate channels of floating point samples in
+  ///     buffers it provides itself. Samples are converted and reordered straight into
+  ///     those buffers, so separated floating point input is copied exactly once (which
+  ///     is unavoidable) and other formats need no intermediate buffer either.
+  ///   </para>
+  ///   <para>
+  ///     Only interleaved input in formats other than 32-bit float goes through a small,
+  ///     reused conversion buffer before it is deinterleaved into the analysis buffers.
+  ///   </para>
+  /// </remarks>
+  class VorbisTrackEncoder : public AudioTrackEncoder {
+
+    /// <summary>Initializes a new Vorbis audio track encoder</summary>
+    /// <param name="target">File into which the encoded audio stream will be written</param>
+    /// <param name="inputChannelOrder">Order in which the channels will be fed in</param>
+    /// <param name="sampleRate">Intended playback rate in samples per second</param>
+    /// <param name="quality">
+    ///   Variable bitrate quality level from -0.1 (lowest) to 1.0 (highest), as used
+    ///   by libvorbisenc (the command line tool's -q switch divided by 10)
+    /// </param>
+    public: VorbisTrackEncoder(
+      const std::shared_ptr<VirtualFile> &target,
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      std::size_t sampleRate,
+      float quality
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~VorbisTrackEncoder() override;
+
+    /// <summary>Retrieves the channel order the encoder expects its samples in</summary>
+    /// <returns>A list of channels in the order the encoder expects them</returns>
+    /// <remarks>
+    ///   This order is configured in the encode builder and applied to both the interleaved
+    ///   ingestion methods and the separated ingestion methods.
+    /// </remarks>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
+
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: std::uint64_t CountWrittenBytes() const override;
+
+    /// <summary>Flushes any audio samples remaining in the buffer</summary>
+    /// <remarks>
+    ///   This ends the Vorbis stream, no more audio can be encoded afterwards.
+    /// </remarks>
+    public: void Flush() override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedUint8(
+      const std::uint8_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt16(
+      const std::int16_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt32(
+      const std::int32_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedFloat(
+      const float *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedDouble(
+      const double *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedUint8(
+      const std::uint8_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt16(
+      const std::int16_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt32(
+      const std::int32_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedFloat(
+      const float *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedDouble(
+      const double *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeInterleaved(const TSample *buffer, std::size_t frameCount);
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeSeparated(const TSample *buffers[], std::size_t frameCount);
+
+    /// <summary>Looks up the analysis buffers, permuted into the input channel order</summary>
+    /// <param name="frameCount">Number of frames that will be written at most</param>
+    /// <returns>The analysis buffer for each channel in the order of the input</returns>
+    private: float *const *getAnalysisBuffersInInputOrder(std::size_t frameCount);
+
+    /// <summary>Submits written samples and encodes all blocks that became ready</summary>
+    /// <param name="frameCount">
+    ///   Number of frames written into the analysis buffers, zero to end the stream
+    /// </param>
+    private: void submitAndEncode(std::size_t frameCount);
+
+    /// <summary>Writes all Ogg pages that are ready into the target file</summary>
+    /// <param name="force">Whether to also write the current, unfinished page</param>
+    private: void writePages(bool force);
+
+    /// <summary>File the encoded Ogg Vorbis stream is written into</summary>
+    private: std::shared_ptr<VirtualFile> target;
+    /// <summary>Position in the target file at which the next page will be written</summary>
+    private: std::uint64_t writePosition;
+    /// <summary>Order in which the channels will be fed to the encoder</summary>
+    private: std::vector<ChannelPlacement> inputChannelOrder;
+    /// <summary>Index of the input channel for each channel in Vorbis order</summary>
+    private: std::vector<std::size_t> inputChannelIndices;
+    /// <summary>Analysis buffer for each input channel, updated for each chunk</summary>
+    private: std::vector<float *> inputOrderedBuffers;
+    /// <summary>Interleaved input samples converted to floating point</summary>
+    private: SampleVector<float> convertedSamples;
+    /// <summary>Settings (channels, sample rate, quality) of the Vorbis stream</summary>
+    private: std::shared_ptr<::vorbis_info> info;
+    /// <summary>Analysis state that encodes the raw audio data</summary>
+    private: std::shared_ptr<::vorbis_dsp_state> analysisState;
+    /// <summary>Block through which the analysis state hands out audio to encode</summary>
+    private: std::shared_ptr<::vorbis_block> block;
+    /// <summary>Packs the encoded Vorbis packets into Ogg pages</summary>
+    private: std::shared_ptr<::ogg_stream_state> oggStream;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#endif // NUCLEX_AUDIO_STORAGE_VORBIS_VORBISTRACKENCODER_H
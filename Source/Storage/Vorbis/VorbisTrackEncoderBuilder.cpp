@@ -0,0 +1,264 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./VorbisTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "./VorbisTrackEncoder.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
+
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+#include <set> // for std::set
+
+#include <Nuclex/Support/BitTricks.h> // for BitTricks
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quality level used when no target bitrate has been set</summary>
+  /// <remarks>
+  ///   Equivalent to oggenc's -q5, which is commonly regarded as transparent.
+  /// </remarks>
+  const float DefaultQuality = 0.5f;
+
+  /// <summary>Nominal stereo bitrates, in kbps, for quality levels -1 through 10</summary>
+  /// <remarks>
+  ///   These are the approximate averages libvorbisenc produces for 44.1 kHz stereo
+  ///   at each integer quality level, as documented for oggenc.
+  /// </remarks>
+  const float NominalStereoBitrates[] = {
+    45.0f, 64.0f, 80.0f, 96.0f, 112.0f, 128.0f, 160.0f, 192.0f, 224.0f, 256.0f, 320.0f, 500.0f
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the libvorbisenc quality level that best matches a bitrate</summary>
+  /// <param name="kilobitsPerSecond">Average bitrate that should be matched</param>
+  /// <param name="channelCount">Number of channels that will be encoded</param>
+  /// <returns>The quality level from -0.1 to 1.0 for libvorbisenc</returns>
+  float qualityFromBitrate(float kilobitsPerSecond, std::size_t channelCount) {
+    const std::size_t levelCount = sizeof(NominalStereoBitrates) / sizeof(float);
+
+    // The table is for stereo, assume bitrate scales roughly linearly with channels
+    float stereoBitrate = kilobitsPerSecond * 2.0f / static_cast<float>(channelCount);
+    if(stereoBitrate <= NominalStereoBitrates[0]) {
+      return -0.1f;
+    }
+    if(stereoBitrate >= NominalStereoBitrates[levelCount - 1]) {
+      return 1.0f;
+    }
+
+    // Interpolate linearly between the two quality levels surrounding the bitrate
+    std::size_t index = 1;
+    while(stereoBitrate > NominalStereoBitrates[index]) {
+      ++index;
+    }
+    float lower = NominalStereoBitrates[index - 1];
+    float upper = NominalStereoBitrates[index];
+    float level = static_cast<float>(index) - 2.0f + (stereoBitrate - lower) / (upper - lower);
+
+    return level / 10.0f;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Verifies that a set of channels can be stored in a Vorbis stream</summary>
+  /// <param name="presentChannels">Channels that should be stored, will be consumed</param>
+  /// <param name="channelCount">Number of channels that should be stored</param>
+  void requireVorbisLayout(
+    std::set<Nuclex::Audio::ChannelPlacement> &presentChannels, std::size_t channelCount
+  ) {
+    using Nuclex::Audio::Storage::Shared::ChannelOrderFactory;
+
+    std::vector<Nuclex::Audio::ChannelPlacement> vorbisChannelOrder = (
+      ChannelOrderFactory::FromVorbisFamilyAndCount(1, channelCount)
+    );
+    for(Nuclex::Audio::ChannelPlacement channel : vorbisChannelOrder) {
+      bool wasPresent = presentChannels.erase(channel);
+      if(!wasPresent) {
+        throw std::runtime_error(
+          u8"Channel layout cannot be represented in Vorbis. The set of channels you provided "
+          u8"does not fit any of the channel sets defined in the Vorbis 1 Specification, "
+          u8"section 4.3.9, Output Channel Order."
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  VorbisTrackEncoderBuilder::VorbisTrackEncoderBuilder() :
+    inputChannelOrder(),
+    sampleRate(),
+    targetBitrate() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<
+    AudioSampleFormat
+  > &VorbisTrackEncoderBuilder::GetSupportedSampleFormats() const {
+    static const std::vector<AudioSampleFormat> supportedFormats = {
+      AudioSampleFormat::Float_32
+    };
+    return supportedFormats;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &VorbisTrackEncoderBuilder::GetSupportedSampleRates() const {
+    static const std::vector<std::size_t> supportedSampleRates; // empty vector = any
+    return supportedSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &VorbisTrackEncoderBuilder::GetPreferredSampleRates() const {
+    static const std::vector<std::size_t> preferredSampleRates = {
+      48000,
+      44100
+    };
+    return preferredSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> VorbisTrackEncoderBuilder::GetPreferredChannelOrder(
+    ChannelPlacement channels
+  ) const {
+    std::size_t channelCount = Nuclex::Support::BitTricks::CountBits(
+      static_cast<std::size_t>(channels)
+    );
+
+    std::set<ChannelPlacement> presentChannels;
+    for(std::size_t index = 0; index < 17; ++index) {
+      ChannelPlacement channel = static_cast<ChannelPlacement>(1 << index);
+      if((channels & channel) != ChannelPlacement::Unknown) {
+        presentChannels.insert(channel);
+      }
+    }
+    requireVorbisLayout(presentChannels, channelCount);
+
+    return Shared::ChannelOrderFactory::FromVorbisFamilyAndCount(1, channelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &VorbisTrackEncoderBuilder::SetSampleFormat(
+    AudioSampleFormat format /* = AudioSampleFormat::SignedInteger_16 */
+  ) {
+    if(format != AudioSampleFormat::Float_32) {
+      throw std::invalid_argument(u8"Vorbis can only store 32-bit floating point samples");
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &VorbisTrackEncoderBuilder::SetSampleRate(
+    std::size_t samplesPerSecond /* = 48000 */
+  ) {
+    this->sampleRate = samplesPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &VorbisTrackEncoderBuilder::SetChannels(
+    const std::vector<ChannelPlacement> &orderedChannels
+  ) {
+    std::set<ChannelPlacement> presentChannels(orderedChannels.begin(), orderedChannels.end());
+    if(presentChannels.size() != orderedChannels.size()) {
+      throw std::invalid_argument(u8"Each channel may only appear once in the channel order");
+    }
+    requireVorbisLayout(presentChannels, orderedChannels.size());
+
+    this->inputChannelOrder = orderedChannels;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &VorbisTrackEncoderBuilder::SetTargetBitrate(
+    float kilobitsPerSecond
+  ) {
+    if(kilobitsPerSecond == 0.0f) {
+      this->targetBitrate.reset();
+      return *this;
+    }
+    if(kilobitsPerSecond < 0.0f) {
+      throw std::invalid_argument(u8"Target bitrate must not be negative");
+    }
+
+    this->targetBitrate = kilobitsPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &VorbisTrackEncoderBuilder::SetCompressionEffort(
+    float effort /* = 1.0f */
+  ) {
+    (void)effort; // libvorbisenc offers no speed/size trade-off
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackEncoder> VorbisTrackEncoderBuilder::Build(
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(this->inputChannelOrder.empty()) {
+      throw std::runtime_error(
+        u8"Input channels and channel order for the encoder have not been set"
+      );
+    }
+    if(!this->sampleRate.has_value()) {
+      throw std::runtime_error(u8"Input sample rate for the encoder has not been set");
+    }
+
+    float quality = DefaultQuality;
+    if(this->targetBitrate.has_value()) {
+      quality = qualityFromBitrate(this->targetBitrate.value(), this->inputChannelOrder.size());
+    }
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Vorbis);
+
+    return std::make_shared<VorbisTrackEncoder>(
+      target, this->inputChannelOrder, this->sampleRate.value(), quality
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -31,6 +31,7 @@ limitations under the License.
 #include <Nuclex/Support/ScopeGuard.h> // for ScopeGuard
 
 #include "Nuclex/Audio/Storage/VirtualFile.h" // for VitualFile
+#include "Nuclex/Audio/Storage/SequentialSource.h" // for SequentialSource
 
 namespace {
 
@@ -190,6 +191,52 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Reads up to <see cref="membercount" /> records from a sequential source</summary>
+  /// <param name="target">Buffer that will receive the data read from the source</param>
+  /// <param name="size">Size of an data record</param>
+  /// <param name="membercount">Number of records that will be read</param>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <returns>The number of bytes successfully read, zero at the end of the stream</returns>
+  ::size_t vorbisReadSequential(
+    void *target, ::size_t size, ::size_t memberCount, void *stateAsVoid
+  ) {
+    Nuclex::Audio::Storage::Vorbis::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Vorbis::SequentialSourceAdapterState *
+    >(stateAsVoid);
+
+    std::size_t readByteCount;
+    try {
+      readByteCount = state.Source->ReadSome(
+        reinterpret_cast<std::byte *>(target), size * memberCount
+      );
+    }
+    catch(const std::exception &) {
+      state.Error = std::current_exception();
+      errno = EIO; // libvorbisfile checks errno to tell errors from the end of the stream
+      return 0;
+    }
+
+    state.FileCursor += readByteCount;
+
+    return readByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Releases the sequential source after libvorbisfile is done with it</summary>
+  /// <param name="stateAsVoid">State of the sequential source adapter</param>
+  /// <returns>Always zero</returns>
+  int vorbisCloseSequential(void *stateAsVoid) {
+    Nuclex::Audio::Storage::Vorbis::SequentialSourceAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::Vorbis::SequentialSourceAdapterState *
+    >(stateAsVoid);
+    state.Source.reset();
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
@@ -198,7 +245,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   std::unique_ptr<ReadOnlyFileAdapterState> FileAdapterFactory::CreateAdapterForReading(
     const std::shared_ptr<const VirtualFile> &readOnlyFile,
-    ::ov_callbacks &fileCallbacks
+    ::ov_callbacks &fileCallbacks,
+    bool isSeekable /* = true */
   ) {
     std::unique_ptr<ReadOnlyFileAdapterState> adapter = (
       std::make_unique<ReadOnlyFileAdapterState>()
@@ -210,8 +258,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     adapter->File = readOnlyFile;
 
     fileCallbacks.read_func = &vorbisReadBytes<ReadOnlyFileAdapterState>;
-    fileCallbacks.seek_func = &vorbisSeek<ReadOnlyFileAdapterState>;
-    fileCallbacks.tell_func = &vorbisTell;
+    if(isSeekable) {
+      fileCallbacks.seek_func = &vorbisSeek<ReadOnlyFileAdapterState>;
+      fileCallbacks.tell_func = &vorbisTell;
+    } else {
+      fileCallbacks.seek_func = nullptr;
+      fileCallbacks.tell_func = nullptr;
+    }
     fileCallbacks.close_func = &vorbisClose<ReadOnlyFileAdapterState>;
 
     return adapter;
@@ -219,6 +272,30 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::unique_ptr<SequentialSourceAdapterState>
+  FileAdapterFactory::CreateAdapterForSequentialReading(
+    const std::shared_ptr<SequentialSource> &source,
+    ::ov_callbacks &fileCallbacks
+  ) {
+    std::unique_ptr<SequentialSourceAdapterState> adapter = (
+      std::make_unique<SequentialSourceAdapterState>()
+    );
+
+    adapter->IsReadOnly = true;
+    adapter->FileCursor = 0;
+    adapter->Error = std::exception_ptr();
+    adapter->Source = source;
+
+    fileCallbacks.read_func = &vorbisReadSequential;
+    fileCallbacks.seek_func = nullptr; // tells libvorbisfile the stream is not seekable
+    fileCallbacks.tell_func = nullptr;
+    fileCallbacks.close_func = &vorbisCloseSequential;
+
+    return adapter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::unique_ptr<WritableFileAdapterState> FileAdapterFactory::CreateAdapterForWriting(
     const std::shared_ptr<VirtualFile> &writableFile,
     ::ov_callbacks &fileCallbacks
@@ -49,6 +49,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Stores informations processed by the Vorbis sequential source adapter</summary>
+  struct SequentialSourceAdapterState : public FileAdapterState {
+
+    /// <summary>Sequential source this adapter is forwarding calls to</summary>
+    public: std::shared_ptr<SequentialSource> Source;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Stores informations processed by the Vorbis stream writer adapter</summary>
   struct WritableFileAdapterState : public FileAdapterState {
 
@@ -67,11 +77,34 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
     /// <param name="fileCallbacks">
     ///   Vorbis file callback set that will be set up to use the adapter
     /// </param>
+    /// <param name="isSeekable">
+    ///   Whether to let libvorbisfile seek. Without seeking, libvorbisfile only reads the headers
+    ///   when opening and doesn't look at the end of the file to determine its length.
+    /// </param>
     /// <returns>
     ///   A state that needs to be passed as the 'state' parameter though libvorbisfile
     /// </returns>
     public: static std::unique_ptr<ReadOnlyFileAdapterState> CreateAdapterForReading(
       const std::shared_ptr<const VirtualFile> &readOnlyFile,
+      ::ov_callbacks &fileCallbacks,
+      bool isSeekable = true
+    );
+
+    /// <summayr>Constructs an adapter for a sequential source that can't seek</summary>
+    /// <param name="source">Sequential source the adapter will read from</param>
+    /// <param name="fileCallbacks">
+    ///   Vorbis file callback set that will be set up to use the adapter
+    /// </param>
+    /// <returns>
+    ///   A state that needs to be passed as the 'state' parameter though libvorbisfile
+    /// </returns>
+    /// <remarks>
+    ///   The seek and tell callbacks are left empty, which tells libvorbisfile that
+    ///   the stream is not seekable, so it only ever reads forward.
+    /// </remarks>
+    public: static std::unique_ptr<SequentialSourceAdapterState>
+    CreateAdapterForSequentialReading(
+      const std::shared_ptr<SequentialSource> &source,
       ::ov_callbacks &fileCallbacks
     );
 
@@ -25,10 +25,12 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
 
 #include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
 
 #include "./WavPackDetection.h"
 #include "./WavPackVirtualFileAdapter.h"
 #include "./WavPackTrackDecoder.h"
+#include "./WavPackTrackEncoderBuilder.h"
 #include "./WavPackReader.h"
 
 #include "../../Platform/WavPackApi.h" // for WavPackApi
@@ -58,6 +60,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool WavPackAudioCodec::IsSignaturePresent(const std::byte *header, std::size_t byteCount) const {
+    return Detection::CheckIfWavPackHeaderPresent(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> WavPackAudioCodec::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &source,
     const std::string &extensionHint /* = std::string() */
@@ -72,9 +80,11 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       return std::optional<ContainerInfo>();
     }
 
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
     WavPackReader reader(source);
 
     // WavPack file is now opened, extract the informations the caller requested.
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
     ContainerInfo containerInfo;
     containerInfo.DefaultTrackIndex = 0;
 
@@ -108,11 +118,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     }
 
     // The constructor will throw if the file cannot be opened by libwavpack.
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
     return std::make_shared<WavPackTrackDecoder>(source);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::shared_ptr<AudioTrackEncoderBuilder> WavPackAudioCodec::ProvideBuilder() const {
+    return std::make_shared<WavPackTrackEncoderBuilder>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::WavPack
 
 #endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -0,0 +1,488 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WavPackBlockScanner.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../EndianReader.h"
+
+#include <algorithm> // for std::min(), std::search()
+#include <cstring> // for std::memcmp()
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Length of the header at the start of each WavPack block</summary>
+  const std::size_t BlockHeaderLength = 32;
+
+  /// <summary>Largest block length WavPack allows in a block header</summary>
+  const std::uint32_t MaximumBlockLength = 0x1000000;
+
+  /// <summary>Number of bytes read from the file at once when searching for blocks</summary>
+  const std::size_t ScanChunkSize = 65536;
+
+  /// <summary>Size of the range below which bisection switches to walking blocks</summary>
+  const std::uint64_t BisectionCutoff = 262144;
+
+  /// <summary>Mask for the metadata id without its size and optional flags</summary>
+  const std::uint8_t UniqueIdMask = 0x3f;
+  /// <summary>Set in a metadata id if the decoder may ignore the sub-block</summary>
+  const std::uint8_t OptionalDataFlag = 0x20;
+  /// <summary>Set in a metadata id if the stored data has an odd length</summary>
+  const std::uint8_t OddSizeFlag = 0x40;
+  /// <summary>Set in a metadata id if its size is stored in 3 bytes instead of 1</summary>
+  const std::uint8_t LargeSizeFlag = 0x80;
+
+  /// <summary>Metadata id of the checksum protecting a whole block</summary>
+  const std::uint8_t BlockChecksumId = OptionalDataFlag | 0xf;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Position of a metadata sub-block inside a WavPack block</summary>
+  struct SubBlock {
+
+    /// <summary>Metadata id of the sub-block, including its flags</summary>
+    public: std::uint8_t Id;
+    /// <summary>Offset of the sub-block's id byte</summary>
+    public: std::size_t Offset;
+    /// <summary>Length of the whole sub-block, including id and size</summary>
+    public: std::size_t Length;
+    /// <summary>Number of data bytes stored in the sub-block (always even)</summary>
+    public: std::size_t DataLength;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lists the metadata sub-blocks stored in a section of memory</summary>
+  /// <param name="data">Memory holding the sub-blocks</param>
+  /// <param name="start">Offset of the first sub-block</param>
+  /// <param name="end">Offset one past the last sub-block's end</param>
+  /// <returns>The positions of all sub-blocks</returns>
+  std::vector<SubBlock> listSubBlocks(
+    const std::byte *data, std::size_t start, std::size_t end
+  ) {
+    using Nuclex::Audio::Errors::CorruptedFileError;
+
+    std::vector<SubBlock> subBlocks;
+    while(start < end) {
+      if(end - start < 2) {
+        throw CorruptedFileError(u8"WavPack block ends in a truncated metadata sub-block");
+      }
+
+      SubBlock subBlock;
+      subBlock.Id = static_cast<std::uint8_t>(data[start]);
+      subBlock.Offset = start;
+      subBlock.DataLength = static_cast<std::size_t>(data[start + 1]) * 2;
+      subBlock.Length = 2;
+      if((subBlock.Id & LargeSizeFlag) != 0) {
+        if(end - start < 4) {
+          throw CorruptedFileError(u8"WavPack block ends in a truncated metadata sub-block");
+        }
+        subBlock.DataLength += static_cast<std::size_t>(data[start + 2]) << 9;
+        subBlock.DataLength += static_cast<std::size_t>(data[start + 3]) << 17;
+        subBlock.Length = 4;
+      }
+      subBlock.Length += subBlock.DataLength;
+
+      if(end - start < subBlock.Length) {
+        throw CorruptedFileError(u8"WavPack metadata sub-block extends beyond its block");
+      }
+
+      subBlocks.push_back(subBlock);
+      start += subBlock.Length;
+    }
+
+    return subBlocks;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a metadata sub-block only applies to the original file</summary>
+  /// <param name="id">Metadata id that will be checked</param>
+  /// <returns>True if the sub-block describes the original file as a whole</returns>
+  bool isWholeFileMetadata(std::uint8_t id) {
+    switch(id & UniqueIdMask) {
+      case OptionalDataFlag | 0x1: // ID_RIFF_HEADER
+      case OptionalDataFlag | 0x2: // ID_RIFF_TRAILER
+      case OptionalDataFlag | 0x3: // ID_ALT_HEADER
+      case OptionalDataFlag | 0x4: // ID_ALT_TRAILER
+      case OptionalDataFlag | 0x6: // ID_MD5_CHECKSUM
+      case OptionalDataFlag | 0x8: // ID_ALT_EXTENSION
+      case OptionalDataFlag | 0x9: // ID_ALT_MD5_CHECKSUM
+      { return true; }
+      default: { return false; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a metadata sub-block is only written into the first block</summary>
+  /// <param name="id">Metadata id that will be checked</param>
+  /// <returns>True if the sub-block describes the format of the whole stream</returns>
+  bool isStreamMetadata(std::uint8_t id) {
+    switch(id & UniqueIdMask) {
+      case 0xd: // ID_CHANNEL_INFO
+      case OptionalDataFlag | 0x5: // ID_CONFIG_BLOCK
+      case OptionalDataFlag | 0x7: // ID_SAMPLE_RATE
+      case OptionalDataFlag | 0xa: // ID_NEW_CONFIG_BLOCK
+      case OptionalDataFlag | 0xb: // ID_CHANNEL_IDENTITIES
+      { return true; }
+      default: { return false; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 32-bit integer in little endian format</summary>
+  /// <param name="target">Memory the integer will be written to</param>
+  /// <param name="value">Value that will be written</param>
+  void writeUInt32(std::byte *target, std::uint32_t value) {
+    target[0] = static_cast<std::byte>(value & 0xFF);
+    target[1] = static_cast<std::byte>((value >> 8) & 0xFF);
+    target[2] = static_cast<std::byte>((value >> 16) & 0xFF);
+    target[3] = static_cast<std::byte>(value >> 24);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackBlockScanner::WavPackBlockScanner(const VirtualFile &file) :
+    file(file),
+    totalSampleCount(-1) {
+
+    std::byte header[BlockHeaderLength];
+    if(file.GetSize() < BlockHeaderLength) {
+      throw Errors::CorruptedFileError(u8"File is too small to be a WavPack file");
+    }
+    file.ReadAt(0, BlockHeaderLength, header);
+    if(std::memcmp(header, u8"wvpk", 4) != 0) {
+      throw Errors::CorruptedFileError(u8"File does not begin with a WavPack block");
+    }
+
+    // Files with more than 4 billion samples store the upper bits separately and skip
+    // one value in each 32-bit range so that 0xFFFFFFFF can mean 'unknown'
+    std::uint32_t lowerTotal = LittleEndianReader::ReadUInt32(header + 12);
+    if(lowerTotal != 0xFFFFFFFFU) {
+      std::uint64_t upperTotal = static_cast<std::uint8_t>(header[11]);
+      this->totalSampleCount = static_cast<std::int64_t>(
+        lowerTotal + (upperTotal << 32) - upperTotal
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WavPackBlockScanner::TryReadBlock(
+    std::uint64_t offset, Block &block, std::vector<std::byte> *data /* = nullptr */
+  ) const {
+    std::uint64_t fileSize = this->file.GetSize();
+
+    // Blocks without samples only carry trailing metadata (or, in older files,
+    // the leftover .wav headers), so they are skipped over when looking for audio
+    for(;;) {
+      if(fileSize - std::min(offset, fileSize) < BlockHeaderLength) {
+        return false;
+      }
+
+      std::byte header[BlockHeaderLength];
+      this->file.ReadAt(offset, BlockHeaderLength, header);
+      if(std::memcmp(header, u8"wvpk", 4) != 0) {
+        return false; // APEv2 or ID3v1 tag or garbage after the last block
+      }
+
+      std::uint32_t chunkSize = LittleEndianReader::ReadUInt32(header + 4);
+      std::uint16_t version = LittleEndianReader::ReadUInt16(header + 8);
+      bool isValid = (
+        (chunkSize >= BlockHeaderLength - 8) &&
+        (chunkSize < MaximumBlockLength) &&
+        (version >= 0x402) &&
+        (version <= 0x410) &&
+        (fileSize - offset >= chunkSize + 8U)
+      );
+      if(!isValid) {
+        return false;
+      }
+
+      block.Offset = offset;
+      block.Length = static_cast<std::size_t>(chunkSize) + 8;
+      block.FirstSample = (
+        LittleEndianReader::ReadUInt32(header + 16) +
+        (static_cast<std::uint64_t>(static_cast<std::uint8_t>(header[10])) << 32)
+      );
+      block.SampleCount = LittleEndianReader::ReadUInt32(header + 20);
+      block.Flags = LittleEndianReader::ReadUInt32(header + 24);
+
+      if(block.SampleCount != 0) {
+        break;
+      }
+
+      offset += block.Length;
+    }
+
+    if(data != nullptr) {
+      data->resize(block.Length);
+      this->file.ReadAt(block.Offset, block.Length, data->data());
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackBlockScanner::Block WavPackBlockScanner::FindBlock(std::uint64_t sampleIndex) const {
+    bool isBeyondEnd = (
+      (this->totalSampleCount >= 0) &&
+      (sampleIndex >= static_cast<std::uint64_t>(this->totalSampleCount))
+    );
+    if(isBeyondEnd) {
+      throw std::out_of_range(u8"Sample index lies beyond the end of the WavPack stream");
+    }
+
+    Block block;
+    if(!TryReadBlock(0, block)) {
+      throw std::out_of_range(u8"WavPack file contains no audio blocks");
+    }
+
+    // Narrow down the range in which the block lies by looking at block headers
+    // in the middle of it. The lower end always stays on a block before the sample.
+    if(sampleIndex >= block.FirstSample + block.SampleCount) {
+      std::uint64_t low = block.Offset;
+      std::uint64_t high = this->file.GetSize();
+      while(high - low > BisectionCutoff) {
+        std::uint64_t middle = low + (high - low) / 2;
+
+        Block candidate;
+        bool isBeforeSample = (
+          tryFindBlockAfter(middle, high, candidate) &&
+          (candidate.FirstSample <= sampleIndex)
+        );
+        if(isBeforeSample) {
+          low = candidate.Offset;
+          block = candidate;
+        } else {
+          high = middle;
+        }
+      }
+    }
+
+    // Walk the remaining blocks up to the group holding the sample. Only the first
+    // block in each group is looked at since all blocks of a group cover the same samples.
+    while(sampleIndex >= block.FirstSample + block.SampleCount) {
+      do {
+        if(!TryReadBlock(block.Offset + block.Length, block)) {
+          throw std::out_of_range(u8"Sample index lies beyond the end of the WavPack stream");
+        }
+      } while((block.Flags & InitialBlockFlag) == 0);
+    }
+
+    return block;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::byte> WavPackBlockScanner::ExtractStreamSubBlocks(
+    const std::vector<std::byte> &block
+  ) {
+    std::vector<std::byte> result;
+
+    std::vector<SubBlock> subBlocks = listSubBlocks(block.data(), BlockHeaderLength, block.size());
+    for(const SubBlock &subBlock : subBlocks) {
+      if(isStreamMetadata(subBlock.Id)) {
+        result.insert(
+          result.end(),
+          block.begin() + subBlock.Offset,
+          block.begin() + subBlock.Offset + subBlock.Length
+        );
+      }
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackBlockScanner::RewriteBlock(
+    const std::vector<std::byte> &block,
+    std::uint64_t blockIndex, std::uint64_t totalSampleCount,
+    const std::vector<std::byte> &prependedSubBlocks,
+    std::vector<std::byte> &result
+  ) {
+    if(block.size() < BlockHeaderLength) {
+      throw Errors::CorruptedFileError(u8"WavPack block is too short to hold its header");
+    }
+
+    std::vector<SubBlock> subBlocks = listSubBlocks(block.data(), BlockHeaderLength, block.size());
+    std::vector<SubBlock> prepended = listSubBlocks(
+      prependedSubBlocks.data(), 0, prependedSubBlocks.size()
+    );
+
+    result.clear();
+    result.reserve(block.size() + prependedSubBlocks.size());
+    result.insert(result.end(), block.begin(), block.begin() + BlockHeaderLength);
+
+    // Block index, stored as 40 bit integer with the upper 8 bits separate
+    result[10] = static_cast<std::byte>(blockIndex >> 32);
+    writeUInt32(result.data() + 16, static_cast<std::uint32_t>(blockIndex));
+
+    // Total samples, skipping one value per 32-bit range (see the constructor)
+    totalSampleCount += totalSampleCount / 0xFFFFFFFFU;
+    result[11] = static_cast<std::byte>(totalSampleCount >> 32);
+    writeUInt32(result.data() + 12, static_cast<std::uint32_t>(totalSampleCount));
+
+    // Stream metadata from the original file's first block goes in front unless
+    // the block already carries its own copy of it
+    for(const SubBlock &extra : prepended) {
+      bool isPresent = false;
+      for(const SubBlock &subBlock : subBlocks) {
+        if((subBlock.Id & UniqueIdMask) == (extra.Id & UniqueIdMask)) {
+          isPresent = true;
+          break;
+        }
+      }
+      if(!isPresent) {
+        result.insert(
+          result.end(),
+          prependedSubBlocks.begin() + extra.Offset,
+          prependedSubBlocks.begin() + extra.Offset + extra.Length
+        );
+      }
+    }
+
+    // Copy the sub-blocks, leaving out any that would be wrong in the new file.
+    // The block checksum always comes last and covers everything before it.
+    std::size_t checksumLength = 0;
+    for(const SubBlock &subBlock : subBlocks) {
+      if((subBlock.Id & UniqueIdMask) == BlockChecksumId) {
+        checksumLength = subBlock.DataLength;
+      } else if(!isWholeFileMetadata(subBlock.Id)) {
+        result.insert(
+          result.end(),
+          block.begin() + subBlock.Offset,
+          block.begin() + subBlock.Offset + subBlock.Length
+        );
+      }
+    }
+
+    if(checksumLength == 0) {
+      writeUInt32(result.data() + 4, static_cast<std::uint32_t>(result.size() - 8));
+      return;
+    }
+
+    if((checksumLength != 2) && (checksumLength != 4)) {
+      throw Errors::CorruptedFileError(u8"WavPack block checksum has an invalid length");
+    }
+
+    // The checksum covers the header, so its final chunk size needs to be in place first
+    writeUInt32(
+      result.data() + 4, static_cast<std::uint32_t>(result.size() + 2 + checksumLength - 8)
+    );
+
+    std::uint32_t checksum = 0xFFFFFFFFU;
+    for(std::size_t index = 0; index + 1 < result.size(); index += 2) {
+      checksum = (
+        checksum * 3 +
+        static_cast<std::uint8_t>(result[index]) +
+        (static_cast<std::uint32_t>(static_cast<std::uint8_t>(result[index + 1])) << 8)
+      );
+    }
+
+    result.push_back(static_cast<std::byte>(BlockChecksumId));
+    result.push_back(static_cast<std::byte>(checksumLength / 2));
+    if(checksumLength == 2) {
+      checksum ^= checksum >> 16;
+    }
+    for(std::size_t index = 0; index < checksumLength; ++index) {
+      result.push_back(static_cast<std::byte>((checksum >> (index * 8)) & 0xFF));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WavPackBlockScanner::tryFindBlockAfter(
+    std::uint64_t offset, std::uint64_t limit, Block &block
+  ) const {
+    static const std::byte signature[] = {
+      std::byte('w'), std::byte('v'), std::byte('p'), std::byte('k')
+    };
+
+    limit = std::min(limit, this->file.GetSize());
+
+    std::vector<std::byte> buffer;
+    while(offset < limit) {
+      std::size_t chunkSize = static_cast<std::size_t>(
+        std::min<std::uint64_t>(limit - offset, ScanChunkSize)
+      );
+      std::size_t readSize = static_cast<std::size_t>(
+        std::min<std::uint64_t>(this->file.GetSize() - offset, chunkSize + 3)
+      );
+      buffer.resize(readSize);
+      this->file.ReadAt(offset, readSize, buffer.data());
+
+      std::vector<std::byte>::const_iterator searchEnd = buffer.begin() + chunkSize;
+      std::vector<std::byte>::const_iterator candidate = buffer.begin();
+      for(;;) {
+        candidate = std::search(
+          candidate, static_cast<std::vector<std::byte>::const_iterator>(buffer.end()),
+          std::begin(signature), std::end(signature)
+        );
+        if((candidate == buffer.end()) || (candidate >= searchEnd)) {
+          break;
+        }
+
+        // The signature can appear inside compressed audio data, too, so only
+        // accept it if it is a complete, plausible block starting a group
+        std::uint64_t candidateOffset = offset + (candidate - buffer.cbegin());
+        bool isGroupStart = (
+          TryReadBlock(candidateOffset, block) &&
+          (block.Offset == candidateOffset) &&
+          ((block.Flags & InitialBlockFlag) != 0)
+        );
+        if(isGroupStart) {
+          return true;
+        }
+
+        ++candidate;
+      }
+
+      offset += chunkSize;
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -0,0 +1,151 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKBLOCKSCANNER_H
+#define NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKBLOCKSCANNER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include <cstddef> // for std::size_t, std::byte
+#include <cstdint> // for std::uint64_t, std::uint32_t, std::int64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Locates and rewrites the blocks in a WavPack file without decoding them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     WavPack files are a sequence of blocks that each begin with a 32 byte header
+  ///     stating the block's length, its first sample and its sample count. Each block
+  ///     can be decoded on its own, so blocks can be moved into another file by changing
+  ///     their block index and the total sample count in their headers.
+  ///   </para>
+  ///   <para>
+  ///     Files with more than two channels store several blocks per stretch of samples,
+  ///     one for each mono channel or stereo pair, all with the same block index.
+  ///   </para>
+  /// </remarks>
+  class WavPackBlockScanner {
+
+    /// <summary>Position and extent of a WavPack block</summary>
+    public: struct Block {
+
+      /// <summary>Offset of the block's first byte in the file</summary>
+      public: std::uint64_t Offset;
+      /// <summary>Length of the block in bytes, including its header</summary>
+      public: std::size_t Length;
+      /// <summary>Index of the first sample (in each channel) in the block</summary>
+      public: std::uint64_t FirstSample;
+      /// <summary>Number of samples (in each channel) the block decodes to</summary>
+      public: std::size_t SampleCount;
+      /// <summary>Flags describing the block's format and position in the group</summary>
+      public: std::uint32_t Flags;
+
+    };
+
+    /// <summary>Flag of the first block in a group of blocks for the same samples</summary>
+    public: static constexpr std::uint32_t InitialBlockFlag = 0x800;
+    /// <summary>Flags describing how samples are stored (width, type, sample rate)</summary>
+    public: static constexpr std::uint32_t StorageFormatFlags = 0x07800183;
+
+    /// <summary>Initializes a new block scanner for the specified WavPack file</summary>
+    /// <param name="file">WavPack file whose blocks will be located</param>
+    public: WavPackBlockScanner(const VirtualFile &file);
+
+    /// <summary>Returns the total number of samples (in each channel)</summary>
+    /// <returns>The total number of samples or -1 if the encoder didn't record it</returns>
+    public: std::int64_t CountTotalSamples() const { return this->totalSampleCount; }
+
+    /// <summary>Reads the block starting at the specified offset</summary>
+    /// <param name="offset">Offset at which the block starts</param>
+    /// <param name="block">Receives the position and extent of the block</param>
+    /// <param name="data">Receives the block's bytes if not null</param>
+    /// <returns>True if a valid block was found, false if the blocks have ended</returns>
+    public: bool TryReadBlock(
+      std::uint64_t offset, Block &block, std::vector<std::byte> *data = nullptr
+    ) const;
+
+    /// <summary>Locates the first block of the group that holds the specified sample</summary>
+    /// <param name="sampleIndex">Index of the sample whose block will be located</param>
+    /// <returns>The first block of the group holding the specified sample</returns>
+    /// <remarks>
+    ///   Throws an std::out_of_range exception if the sample lies beyond the last block.
+    /// </remarks>
+    public: Block FindBlock(std::uint64_t sampleIndex) const;
+
+    /// <summary>Copies the metadata that is only stored in a file's first block</summary>
+    /// <param name="block">First block of a WavPack file</param>
+    /// <returns>The channel layout, configuration and sample rate sub-blocks</returns>
+    public: static std::vector<std::byte> ExtractStreamSubBlocks(
+      const std::vector<std::byte> &block
+    );
+
+    /// <summary>Rewrites a block's header to place it into a different file</summary>
+    /// <param name="block">Complete block, including its header</param>
+    /// <param name="blockIndex">Index of the first sample the block will hold</param>
+    /// <param name="totalSampleCount">Total number of samples in the new file</param>
+    /// <param name="prependedSubBlocks">Additional metadata to put into the block</param>
+    /// <param name="result">Receives the rewritten block</param>
+    /// <remarks>
+    ///   Metadata describing the original file as a whole, such as the wrapped .wav
+    ///   headers and the MD5 sum of the audio data, is removed since it would no longer
+    ///   be correct. If the block has a block checksum, it is calculated anew.
+    /// </remarks>
+    public: static void RewriteBlock(
+      const std::vector<std::byte> &block,
+      std::uint64_t blockIndex, std::uint64_t totalSampleCount,
+      const std::vector<std::byte> &prependedSubBlocks,
+      std::vector<std::byte> &result
+    );
+
+    /// <summary>Looks for the first valid block at or after the specified offset</summary>
+    /// <param name="offset">Offset at which the search begins</param>
+    /// <param name="limit">Offset at which the search gives up</param>
+    /// <param name="block">Receives the block that was found</param>
+    /// <returns>True if a block was found, false otherwise</returns>
+    private: bool tryFindBlockAfter(std::uint64_t offset, std::uint64_t limit, Block &block) const;
+
+    /// <summary>WavPack file whose blocks are being located</summary>
+    private: const VirtualFile &file;
+    /// <summary>Total number of samples stated in the first block or -1</summary>
+    private: std::int64_t totalSampleCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#endif // NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKBLOCKSCANNER_H
@@ -74,6 +74,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     std::byte fileHeader[16];
     source.ReadAt(0, 16, fileHeader);
 
+    return CheckIfWavPackHeaderPresent(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfWavPackHeaderPresent(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 16) {
+      return false; // Not enough header bytes to check for a valid WavPack header
+    }
+
     // The WavPack block headers are entirely in little endian (see WavPack 4 and 5
     // file format specification, chapter "2.0 Block Header"), so put these integers
     // together by hand to aovid any endian mix-ups
@@ -27,6 +27,7 @@ limitations under the License.
 #include <string> // for std::string
 #include <memory> // for std::unique_ptr
 #include <cstdint> // for std::uint64_t
+#include <cstddef> // for std::byte
 #include <vector> // for std::vector
 
 #include <wavpack.h> // for all wavpack functions
@@ -66,6 +67,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     /// <returns>True if a valid WavPack header was found, false otherwise</returns>
     public: static bool CheckIfWavPackHeaderPresent(const VirtualFile &source);
 
+    /// <summary>Checks if the file header starts with a valid WavPack header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid WavPack header was found, false otherwise</returns>
+    public: static bool CheckIfWavPackHeaderPresent(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
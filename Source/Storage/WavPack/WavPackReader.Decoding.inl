@@ -25,6 +25,9 @@ limitations under the License.
 #include "Nuclex/Audio/Processing/Quantization.h"
 #include "Nuclex/Audio/Processing/Reconstruction.h"
 #include "Nuclex/Audio/Processing/BitExtension.h"
+#include "Nuclex/Audio/Storage/ChunkSizePolicy.h"
+
+#include <algorithm> // for std::min()
 
 // Oof.
 //
@@ -64,11 +67,25 @@ namespace {
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Comes up with a good number of frames to process per batch</summary>
+  /// <param name="context">libwavpack context whose current block will be checked</param>
   /// <param name="requestedFrameCount">Total number of frames that need to be decoded</param>
+  /// <param name="channelCount">Number of channels in each frame</param>
+  /// <param name="bytesPerOutputSample">Bytes each sample occupies in the target</param>
   std::size_t estimateDecodeChunkSize(
-    const std::shared_ptr<::WavpackContext> &context, std::size_t requestedFrameCount
+    const std::shared_ptr<::WavpackContext> &context,
+    std::size_t requestedFrameCount,
+    std::size_t channelCount,
+    std::size_t bytesPerOutputSample
   ) {
 
+    // No batch should be larger than what fits into the cache together with its
+    // converted output, otherwise conversion would fetch the decoded samples from memory
+    std::size_t cachedFrameCount = (
+      Nuclex::Audio::Storage::ChunkSizePolicy::GetGlobal().GetChunkFrameCount(
+        channelCount, sizeof(std::int32_t), bytesPerOutputSample
+      )
+    );
+
     // If we're allowed to access the internal data structure of libwavpack,
     // we'll check the current block being decoded to see how much data we
     // can decode in one go.
@@ -81,19 +98,14 @@ namespace {
         0 // context->streams[0]->sample_index // We might be reading more than this block only
       );
 #else
-      decodeChunkSize = this->sampleRate / 2;
+      (void)context;
+      decodeChunkSize = cachedFrameCount;
 #endif
-
-      // Don't decode an unlimited number of samples, we want t
-      while(12000 < decodeChunkSize) {
-        decodeChunkSize >>= 1;
-      }
+      decodeChunkSize = std::min(decodeChunkSize, cachedFrameCount);
     }
 
     // Also estimate a chunk size from the number of frames we should decode.
-    while(12000 < requestedFrameCount) {
-      requestedFrameCount >>= 2;
-    }
+    requestedFrameCount = std::min(requestedFrameCount, cachedFrameCount);
 
     // Use the larger of the two values and round it up to a multiple of 4,
     // which will help avoid single-value processing of SSE2 SIMD code is used.
@@ -127,10 +139,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       std::is_same<TSample, double>::value
     );
 
-    // Allocate an intermedia buffer. In this variant, we use std::byte because
+    // Obtain an intermediate buffer. In this variant, we use std::byte because
     // we're going to be decoding into it from libwavpack (either float or std::int32_t).
-    std::size_t decodeChunkSize = estimateDecodeChunkSize(this->context, frameCount);
-    std::vector<std::byte> decodeBuffer(
+    std::size_t decodeChunkSize = estimateDecodeChunkSize(
+      this->context, frameCount, this->channelCount, sizeof(TSample)
+    );
+    std::byte *decodeBuffer = this->getDecodeBuffer(
       decodeChunkSize * this->channelCount * sizeof(std::int32_t)
     );
 
@@ -148,7 +162,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       std::uint32_t unpackedFrameCount = Platform::WavPackApi::UnpackSamples(
         this->state->Error, // exception_ptr that will receive VirtualFile exceptions
         this->context,
-        reinterpret_cast<std::int32_t *>(decodeBuffer.data()),
+        reinterpret_cast<std::int32_t *>(decodeBuffer),
         static_cast<std::uint32_t>(decodeChunkSize)
       );
 
@@ -168,7 +182,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
       if constexpr(decodedSamplesAreFloat) {
 #pragma region Convert floats to doubles or integers
-        float *decodedFloats = reinterpret_cast<float *>(decodeBuffer.data());
+        float *decodedFloats = reinterpret_cast<float *>(decodeBuffer);
 
         // The target can only be a double or an integer type. If the target was float,
         // this method would never have been invoked and the decode would have happened
@@ -234,7 +248,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 #pragma endregion // Convert floats to doubles or integers
       } else { // if decoded data from libwavpack is ^^ float ^^ / vv int32 vv
 #pragma region Convert integers to floats, doubles or integers
-        std::int32_t *decodedInts = reinterpret_cast<std::int32_t *>(decodeBuffer.data());
+        std::int32_t *decodedInts = reinterpret_cast<std::int32_t *>(decodeBuffer);
 
         // How libwavpack aligns samples is a bit unique. Going by the docs:
         //
@@ -417,16 +431,23 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       std::is_same<TSample, double>::value
     );
 
-    // The channel pointers are in a caller-provided array, if we changed them,
-    // we'd trash the caller's own pointers, so we have to take a copy.
-    std::vector<TSample *> mutableTargets(this->channelCount);
+    // Channels for which the caller passed a null pointer are left out entirely.
+    // The caller's pointers are left untouched, we track how far we've written instead.
+    std::vector<std::size_t> &wantedChannelIndices = this->wantedChannelIndices;
+    wantedChannelIndices.clear();
     for(std::size_t index = 0; index < this->channelCount; ++index) {
-      mutableTargets[index] = targets[index];
+      if(targets[index] != nullptr) {
+        wantedChannelIndices.push_back(index);
+      }
     }
+    const std::size_t wantedChannelCount = wantedChannelIndices.size();
+    std::size_t writtenFrameCount = 0;
 
-    // Allocate an intermedia buffer. In this variant, we use std::byte because
+    // Obtain an intermediate buffer. In this variant, we use std::byte because
     // we're going to be decoding into it from libwavpack (either float or std::int32_t).
-    std::size_t decodeChunkSize = estimateDecodeChunkSize(this->context, frameCount);
+    std::size_t decodeChunkSize = estimateDecodeChunkSize(
+      this->context, frameCount, this->channelCount, sizeof(TSample)
+    );
 
     // In this channel-separating variant of the decode method, we first convert
     // the samples in-place in the decode buffer before sorting them by channel.
@@ -441,18 +462,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     // we can guarantee that converting in sequence will only have the write pointer
     // catch up with the read pointer at the very end, but never overtake it.
     //
-    std::vector<std::byte> decodeBuffer;
+    std::byte *decodeBuffer;
     std::byte *decodeBufferStart;
     {
       std::size_t chunkSampleCount = decodeChunkSize * this->channelCount;
 
       if constexpr(std::is_same<TSample, double>::value && !decodedSamplesAreFloat) {
         chunkSampleCount += 4; // So the second-to-last converted double doesn't overwrite
-        decodeBuffer.resize(chunkSampleCount * sizeof(double));
-        decodeBufferStart = decodeBuffer.data() + (chunkSampleCount * sizeof(std::int32_t));
+        decodeBuffer = this->getDecodeBuffer(chunkSampleCount * sizeof(double));
+        decodeBufferStart = decodeBuffer + (chunkSampleCount * sizeof(std::int32_t));
       } else {
-        decodeBuffer.resize(chunkSampleCount * sizeof(std::int32_t));
-        decodeBufferStart = decodeBuffer.data();
+        decodeBuffer = this->getDecodeBuffer(chunkSampleCount * sizeof(std::int32_t));
+        decodeBufferStart = decodeBuffer;
       }
     }
 
@@ -486,7 +507,23 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
         );
       }
 
-      std::size_t sampleCount = unpackedFrameCount * this->channelCount;
+      // libwavpack always unpacks all channels. If the caller skips some of them,
+      // compact the unpacked samples to the wanted channels so the conversion below
+      // only touches those. Reading always stays ahead of writing, so this can be
+      // done in-place and works for floats, too, since we're just moving 32-bit words.
+      if(wantedChannelCount < this->channelCount) {
+        std::int32_t *unpacked = reinterpret_cast<std::int32_t *>(decodeBufferStart);
+        std::size_t writeIndex = 0;
+        for(std::size_t frameIndex = 0; frameIndex < unpackedFrameCount; ++frameIndex) {
+          const std::int32_t *frame = unpacked + (frameIndex * this->channelCount);
+          for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+            unpacked[writeIndex] = frame[wantedChannelIndices[wantedIndex]];
+            ++writeIndex;
+          }
+        }
+      }
+
+      std::size_t sampleCount = unpackedFrameCount * wantedChannelCount;
 
       if constexpr(decodedSamplesAreFloat) {
 #pragma region Convert floats to integers
@@ -505,7 +542,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
             (std::uint32_t(1) << (sizeof(TSample) * 8 - 1)) - 1
           );
 
-          std::int32_t *convertedInts = reinterpret_cast<std::int32_t *>(decodeBuffer.data());
+          std::int32_t *convertedInts = reinterpret_cast<std::int32_t *>(decodeBuffer);
           while(3 < sampleCount) {
             Nuclex::Audio::Processing::Quantization::MultiplyToNearestInt32x4(
               decodedFloats, limit, convertedInts
@@ -557,7 +594,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
           // Now convert the samples. Negative numbers make it through this because C++ is
           // doing arithmetic shifts on the int32s and the signal reconstruction code casts
           // whole int32s to floats/doubles.
-          TSample *convertedFloats = reinterpret_cast<TSample *>(decodeBuffer.data());
+          TSample *convertedFloats = reinterpret_cast<TSample *>(decodeBuffer);
           while(3 < sampleCount) {
             Nuclex::Audio::Processing::Reconstruction::ShiftAndDivideInt32ToFloatx4(
               decodedInts, shift, limit, convertedFloats
@@ -579,7 +616,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
         } else { // if target type is ^^ float/double ^^ / vv integer vv
 
-          std::int32_t *convertedInts = reinterpret_cast<std::int32_t *>(decodeBuffer.data());
+          std::int32_t *convertedInts = reinterpret_cast<std::int32_t *>(decodeBuffer);
 
           // If the target data type has fewer bits, samples need to be truncated
           if constexpr(targetIntegerHasFewerBits) {
@@ -648,33 +685,29 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       // Sort the interleaved samples into each channel buffer. We know that a multiple
       // of the channel count was decoded (since we can only request full frames from
       // libwavpack), so we can simply run a nested loop to sort this out.
+      // Only the wanted channels remain in the decode buffer at this point.
       {
         typedef typename std::conditional<
           targetTypeIsFloat, TSample, std::int32_t
         >::type DecodedType;
-        DecodedType *decoded = reinterpret_cast<DecodedType *>(decodeBuffer.data());
+        DecodedType *decoded = reinterpret_cast<DecodedType *>(decodeBuffer);
 
         std::size_t sampleIndex = 0;
         for(std::size_t frameIndex = 0; frameIndex < unpackedFrameCount; ++frameIndex) {
-          for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
+          std::size_t targetIndex = writtenFrameCount + frameIndex;
+          for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+            TSample *channelTarget = targets[wantedChannelIndices[wantedIndex]];
             if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-              mutableTargets[channelIndex][frameIndex] = static_cast<TSample>(
-                decoded[sampleIndex] + 128
-              );
+              channelTarget[targetIndex] = static_cast<TSample>(decoded[sampleIndex] + 128);
             } else {
-              mutableTargets[channelIndex][frameIndex] = static_cast<TSample>(
-                decoded[sampleIndex]
-              );
+              channelTarget[targetIndex] = static_cast<TSample>(decoded[sampleIndex]);
             }
             ++sampleIndex;
-          } // for each channel
+          } // for each wanted channel
         } // for each frame
       } // beauty scope
 
-      // Advance the target buffer pointers
-      for(std::size_t channelIndex = 0; channelIndex < this->channelCount; ++channelIndex) {
-        mutableTargets[channelIndex] += unpackedFrameCount;
-      }
+      writtenFrameCount += unpackedFrameCount;
 
       frameCount -= unpackedFrameCount;
 
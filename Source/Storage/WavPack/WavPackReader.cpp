@@ -25,9 +25,11 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
 
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h"
 
 #include "./WavPackVirtualFileAdapter.h"
 #include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/DecodePathBuilder.h"
 #include "../../Platform/WavPackApi.h"
 
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
@@ -93,6 +95,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     channelCount(0),
     sampleRate(0),
     frameCursor(0),
+    decodeBuffer(),
+    wantedChannelIndices(),
     decodeInterleavedUint8(),
     decodeInterleavedInt16(),
     decodeInterleavedInt32(),
@@ -129,6 +133,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     this->bytesPerSample = Platform::WavPackApi::GetBytesPerSample(context);
     this->channelCount = Platform::WavPackApi::GetNumChannels(context);
     this->sampleRate = Platform::WavPackApi::GetSampleRate(context);
+
+    this->wantedChannelIndices.reserve(this->channelCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -138,6 +144,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
   // ------------------------------------------------------------------------------------------- //
 
   void WavPackReader::ReadMetadata(TrackInfo &target) {
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
+
     target.ChannelCount = this->channelCount;
 
     target.ChannelPlacements = static_cast<ChannelPlacement>(
@@ -153,6 +161,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     target.Duration = std::chrono::microseconds(
       totalSampleCount * 1'000'000 / target.SampleRate
     );
+    target.FrameCount = totalSampleCount;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -351,6 +360,67 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  DecodePath WavPackReader::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    using Shared::DecodePathBuilder;
+
+    sampleFormat = DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    bool decodedSamplesAreFloat = ((this->mode & MODE_FLOAT) != 0);
+    bool targetTypeIsFloat = DecodePathBuilder::IsFloatingPoint(sampleFormat);
+    std::size_t targetBitCount = static_cast<std::size_t>(sampleFormat); // for integers
+    std::size_t decodedBitCount = static_cast<std::size_t>(this->bitsPerSample);
+    std::string inlineKernelSet = DecodePathBuilder::GetInlineKernelSetName();
+
+    DecodePathBuilder builder(
+      u8"WavPack",
+      decodedSamplesAreFloat ? AudioSampleFormat::Float_32 : AudioSampleFormat::SignedInteger_32,
+      u8"interleaved"
+    );
+
+    // Floats and full 32-bit integers are unpacked straight into the caller's buffer
+    // if that's what the caller asked for
+    if(interleaved) {
+      bool isDirect = decodedSamplesAreFloat ? (
+        sampleFormat == AudioSampleFormat::Float_32
+      ) : (
+        (sampleFormat == AudioSampleFormat::SignedInteger_32) && (decodedBitCount == 32)
+      );
+      if(isDirect) {
+        builder.AddPass(u8"unpack");
+        return builder.GetPath();
+      }
+    }
+
+    builder.AddScratchBuffer().AddPass(u8"unpack");
+
+    // The separating variant converts in-place, then sorts the samples into the channels.
+    // Conversions that are a plain cast happen while sorting.
+    if(decodedSamplesAreFloat) {
+      if(!targetTypeIsFloat) {
+        builder.AddPass(u8"Quantize " + inlineKernelSet);
+      } else if(interleaved) {
+        builder.AddPass(u8"cast");
+      }
+    } else if(targetTypeIsFloat) {
+      builder.AddPass(u8"Reconstruct " + inlineKernelSet);
+    } else if(targetBitCount > decodedBitCount) {
+      builder.AddPass(u8"Extend bits " + inlineKernelSet);
+    } else if(targetBitCount < decodedBitCount) {
+      builder.AddPass(u8"Truncate bits");
+    } else if(interleaved) {
+      builder.AddPass(u8"copy");
+    }
+
+    if(!interleaved) {
+      builder.AddPass(u8"separate");
+    }
+
+    return builder.GetPath();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WavPackReader::Seek(std::uint64_t frameIndex) {
 
     // ISSUE: SeekSample64() is documented as bringing the context into an invalid state
@@ -365,6 +435,19 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  Shared::DecoderCheckpoint WavPackReader::Checkpoint(std::uint64_t frameIndex) {
+    Seek(frameIndex);
+    return Shared::DecoderCheckpoint { frameIndex, frameIndex, 0, false };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackReader::Restore(const Shared::DecoderCheckpoint &checkpoint) {
+    Seek(checkpoint.FrameIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<> void WavPackReader::DecodeInterleaved<std::uint8_t>(
     std::uint8_t *target, std::size_t frameCount
   ) {
@@ -488,6 +571,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::byte *WavPackReader::getDecodeBuffer(std::size_t byteCount) {
+    if(unlikely(this->decodeBuffer.size() < byteCount)) {
+      AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+      this->decodeBuffer.resize(byteCount);
+    }
+    return this->decodeBuffer.data();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::WavPack
 
 #include "./WavPackReader.Decoding.inl"
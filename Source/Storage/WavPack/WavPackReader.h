@@ -26,8 +26,12 @@ limitations under the License.
 
 #include "Nuclex/Audio/AudioSampleFormat.h"
 #include "Nuclex/Audio/ChannelPlacement.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Storage/DecodePath.h"
+#include "../Shared/DecoderCheckpoint.h" // for DecoderCheckpoint
 
 #include <memory> // for std::unique_ptr, std::shared_ptr
+#include <cstddef> // for std::byte
 #include <cstdint> // for std::uint64_t
 #include <vector> // for std::vector
 
@@ -129,10 +133,29 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     /// </remarks>
     public: void PrepareForDecoding();
 
+    /// <summary>Describes how samples would be decoded in the specified format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps the decoding methods would go through</returns>
+    public: DecodePath ExplainDecodePath(AudioSampleFormat sampleFormat, bool interleaved) const;
+
     /// <summary>Moves the frame cursor to the specified location</summary>
     /// <param name="frameIndex">Index of the frame that should be decoded next</param>
     public: void Seek(std::uint64_t frameIndex);
 
+    /// <summary>Moves the frame cursor to a frame and records how to return there</summary>
+    /// <param name="frameIndex">Index of the frame that should be decoded next</param>
+    /// <returns>A checkpoint through which the reader can return to the frame</returns>
+    /// <remarks>
+    ///   libwavpack only lets us seek by sample, so checkpoints are always indirect.
+    ///   WavPack blocks decode independently, so this seek is cheap already.
+    /// </remarks>
+    public: Shared::DecoderCheckpoint Checkpoint(std::uint64_t frameIndex);
+
+    /// <summary>Moves the frame cursor back to a checkpoint's frame</summary>
+    /// <param name="checkpoint">Checkpoint previously returned by Checkpoint()</param>
+    public: void Restore(const Shared::DecoderCheckpoint &checkpoint);
+
     /// <summary>Decodes samples from the audio file in interleaved format</summary>
     /// <typename name="TSample">Type of samples that will be decoded</typename>
     /// <param name="target">Buffer into which the samples will be written</param>
@@ -197,6 +220,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     >
     void decodeInterleavedConvertAndSeparate(TSample *targets[], std::size_t frameCount);
 
+    /// <summary>Provides scratch memory for the decoding methods</summary>
+    /// <param name="byteCount">Number of bytes the scratch memory needs to hold</param>
+    /// <returns>The start of the scratch memory</returns>
+    /// <remarks>
+    ///   The scratch memory only ever grows, so after the first few decoding calls,
+    ///   no further allocations will take place.
+    /// </remarks>
+    private: std::byte *getDecodeBuffer(std::size_t byteCount);
+
     /// <summary>File the reader is accessing</summary>
     private: std::shared_ptr<const VirtualFile> file;
     /// <summary>
@@ -233,6 +265,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     private: std::size_t sampleRate;
     /// <summary>Index of the frame that will be decoded next</summary>
     private: std::uint64_t frameCursor;
+    /// <summary>Scratch memory libwavpack decodes into before samples are converted</summary>
+    private: SampleVector<std::byte> decodeBuffer;
+    /// <summary>Indices of the channels the caller wants in a separated decode</summary>
+    private: std::vector<std::size_t> wantedChannelIndices;
 
     /// <summary>Signature for the interleaved decode method</summary>
     private: template<typename TSample>
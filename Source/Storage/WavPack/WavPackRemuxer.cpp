@@ -0,0 +1,426 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WavPackRemuxer.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Storage/LosslessTranscoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./WavPackBlockScanner.h"
+#include "./WavPackReader.h"
+#include "./WavPackTrackDecoder.h"
+#include "./WavPackTrackEncoderBuilder.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads all blocks that belong to the group starting at the specified offset</summary>
+  /// <param name="scanner">Scanner through which the blocks will be read</param>
+  /// <param name="offset">Offset at which the group's initial block begins</param>
+  /// <param name="blocks">Receives the blocks of the group</param>
+  /// <returns>True if a group was found, false if the blocks have ended</returns>
+  bool tryReadGroup(
+    const Nuclex::Audio::Storage::WavPack::WavPackBlockScanner &scanner,
+    std::uint64_t offset,
+    std::vector<Nuclex::Audio::Storage::WavPack::WavPackBlockScanner::Block> &blocks
+  ) {
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+
+    blocks.clear();
+
+    // Files with up to two channels have a single block per group, files with more
+    // channels have one block per mono channel or stereo pair, the first of which
+    // carries the initial block flag
+    WavPackBlockScanner::Block block;
+    while(scanner.TryReadBlock(offset, block)) {
+      bool isInitial = ((block.Flags & WavPackBlockScanner::InitialBlockFlag) != 0);
+      if(isInitial && !blocks.empty()) {
+        break;
+      }
+      blocks.push_back(block);
+      offset = block.Offset + block.Length;
+    }
+
+    return !blocks.empty();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a WavPack file from blocks taken out of other WavPack files</summary>
+  class WavPackStreamWriter {
+
+    /// <summary>Initializes a new WavPack stream writer</summary>
+    /// <param name="target">File the WavPack blocks will be written into</param>
+    /// <param name="firstSourceBlock">First block of the (first) source file</param>
+    /// <param name="announcedSampleCount">
+    ///   Total number of samples that is expected to be written. If it turns out
+    ///   to be different, the first block will be updated when finishing.
+    /// </param>
+    public: WavPackStreamWriter(
+      Nuclex::Audio::Storage::VirtualFile &target,
+      const std::vector<std::byte> &firstSourceBlock,
+      std::uint64_t announcedSampleCount
+    );
+
+    /// <summary>Returns the number of samples (per channel) written so far</summary>
+    /// <returns>The number of samples in the blocks written so far</returns>
+    public: std::uint64_t CountWrittenSamples() const { return this->writtenSampleCount; }
+
+    /// <summary>Appends a block taken from another WavPack file</summary>
+    /// <param name="block">Block that will be appended</param>
+    /// <param name="flags">Flags stored in the header of the block</param>
+    /// <param name="blockIndex">Index of the block's first sample in the new file</param>
+    /// <param name="sampleCount">Number of samples (per channel) in the block</param>
+    public: void AppendBlock(
+      const std::vector<std::byte> &block, std::uint32_t flags,
+      std::uint64_t blockIndex, std::size_t sampleCount
+    );
+
+    /// <summary>Updates the first block if the total sample count was different</summary>
+    public: void Finish();
+
+    /// <summary>File the WavPack blocks are being written into</summary>
+    private: Nuclex::Audio::Storage::VirtualFile &target;
+    /// <summary>Offset at which the next block will be written</summary>
+    private: std::uint64_t fileCursor;
+    /// <summary>Storage format flags all blocks need to agree on</summary>
+    private: std::uint32_t storageFormatFlags;
+    /// <summary>Metadata from the source's first block describing the stream</summary>
+    private: std::vector<std::byte> streamSubBlocks;
+    /// <summary>Total sample count stated in the blocks' headers</summary>
+    private: std::uint64_t announcedSampleCount;
+    /// <summary>Number of samples (per channel) written so far</summary>
+    private: std::uint64_t writtenSampleCount;
+    /// <summary>Unmodified copy of the first block written, for updating it</summary>
+    private: std::vector<std::byte> firstBlock;
+    /// <summary>Buffer holding the rewritten block before it is written</summary>
+    private: std::vector<std::byte> rewrittenBlock;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackStreamWriter::WavPackStreamWriter(
+    Nuclex::Audio::Storage::VirtualFile &target,
+    const std::vector<std::byte> &firstSourceBlock,
+    std::uint64_t announcedSampleCount
+  ) :
+    target(target),
+    fileCursor(0),
+    storageFormatFlags(
+      static_cast<std::uint32_t>(firstSourceBlock[24]) |
+      (static_cast<std::uint32_t>(firstSourceBlock[25]) << 8) |
+      (static_cast<std::uint32_t>(firstSourceBlock[26]) << 16) |
+      (static_cast<std::uint32_t>(firstSourceBlock[27]) << 24)
+    ),
+    streamSubBlocks(
+      Nuclex::Audio::Storage::WavPack::WavPackBlockScanner::ExtractStreamSubBlocks(
+        firstSourceBlock
+      )
+    ),
+    announcedSampleCount(announcedSampleCount),
+    writtenSampleCount(0),
+    firstBlock(),
+    rewrittenBlock() {
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+    this->storageFormatFlags &= WavPackBlockScanner::StorageFormatFlags;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackStreamWriter::AppendBlock(
+    const std::vector<std::byte> &block, std::uint32_t flags,
+    std::uint64_t blockIndex, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+
+    // Each block states its own format, but decoders set up their buffers and
+    // the sample rate once, from the first block
+    if((flags & WavPackBlockScanner::StorageFormatFlags) != this->storageFormatFlags) {
+      throw Nuclex::Audio::Errors::UnsupportedFormatError(
+        u8"WavPack blocks to be joined need the same sample width, type and sample rate"
+      );
+    }
+
+    // The first block of the new file is where decoders look for the channel layout
+    // and encoder settings, which the source only stored in its own first block
+    if(this->fileCursor == 0) {
+      this->firstBlock = block;
+      WavPackBlockScanner::RewriteBlock(
+        block, blockIndex, this->announcedSampleCount, this->streamSubBlocks,
+        this->rewrittenBlock
+      );
+    } else {
+      WavPackBlockScanner::RewriteBlock(
+        block, blockIndex, this->announcedSampleCount, std::vector<std::byte>(),
+        this->rewrittenBlock
+      );
+    }
+
+    this->target.WriteAt(
+      this->fileCursor, this->rewrittenBlock.size(), this->rewrittenBlock.data()
+    );
+    this->fileCursor += this->rewrittenBlock.size();
+    this->writtenSampleCount = std::max(this->writtenSampleCount, blockIndex + sampleCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackStreamWriter::Finish() {
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+
+    // Decoders only take the total sample count from the first block, so that is
+    // the only one that needs to be corrected. Its length doesn't change.
+    bool needsUpdate = (
+      !this->firstBlock.empty() &&
+      (this->writtenSampleCount != this->announcedSampleCount)
+    );
+    if(needsUpdate) {
+      WavPackBlockScanner::RewriteBlock(
+        this->firstBlock, 0, this->writtenSampleCount, this->streamSubBlocks,
+        this->rewrittenBlock
+      );
+      this->target.WriteAt(0, this->rewrittenBlock.size(), this->rewrittenBlock.data());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a range of samples again and appends the resulting blocks</summary>
+  /// <param name="writer">Writer that will receive the encoded blocks</param>
+  /// <param name="source">WavPack file the samples are taken from</param>
+  /// <param name="decoder">Decoder that will provide the samples</param>
+  /// <param name="sampleRate">Sample rate of the source file</param>
+  /// <param name="startSample">Index of the first sample that will be encoded</param>
+  /// <param name="sampleCount">Number of samples (per channel) that will be encoded</param>
+  /// <param name="blockIndex">Index the first encoded sample will have in the new file</param>
+  void appendEncodedSamples(
+    WavPackStreamWriter &writer,
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    std::size_t sampleRate,
+    std::uint64_t startSample, std::size_t sampleCount,
+    std::uint64_t blockIndex
+  ) {
+    using Nuclex::Audio::AudioSampleFormat;
+    using Nuclex::Audio::Storage::WritableMemoryFile;
+    using Nuclex::Audio::Storage::LosslessTranscoder;
+    using Nuclex::Audio::Storage::AudioTrackEncoder;
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+    using Nuclex::Audio::Storage::WavPack::WavPackTrackEncoderBuilder;
+
+    WavPackTrackEncoderBuilder builder;
+    AudioSampleFormat format = LosslessTranscoder::NegotiateSampleFormat(decoder, builder);
+    if(format == AudioSampleFormat::Unknown) {
+      throw Nuclex::Audio::Errors::UnsupportedFormatError(
+        u8"Samples of the WavPack file can not be encoded again without loss"
+      );
+    }
+
+    std::shared_ptr<WritableMemoryFile> encoded = std::make_shared<WritableMemoryFile>();
+    {
+      std::shared_ptr<AudioTrackEncoder> encoder = builder.
+        SetSampleFormat(format).
+        SetSampleRate(sampleRate).
+        SetChannels(decoder.GetChannelOrder()).
+        Build(encoded);
+
+      std::size_t channelCount = decoder.CountChannels();
+      if(format == AudioSampleFormat::Float_32) {
+        std::vector<float> samples(sampleCount * channelCount);
+        decoder.DecodeInterleaved<float>(samples.data(), startSample, sampleCount);
+        encoder->EncodeInterleaved<float>(samples.data(), sampleCount);
+      } else {
+        std::vector<std::int32_t> samples(sampleCount * channelCount);
+        decoder.DecodeInterleaved<std::int32_t>(samples.data(), startSample, sampleCount);
+        encoder->EncodeInterleaved<std::int32_t>(samples.data(), sampleCount);
+      }
+      encoder->Flush();
+    }
+
+    WavPackBlockScanner scanner(*encoded);
+
+    WavPackBlockScanner::Block block;
+    std::vector<std::byte> blockData;
+    std::uint64_t offset = 0;
+    while(scanner.TryReadBlock(offset, block, &blockData)) {
+      writer.AppendBlock(blockData, block.Flags, blockIndex + block.FirstSample, block.SampleCount);
+      offset = block.Offset + block.Length;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the first block of a WavPack file that contains audio</summary>
+  /// <param name="scanner">Scanner through which the block will be read</param>
+  /// <returns>The contents of the first audio block</returns>
+  std::vector<std::byte> readFirstBlock(
+    const Nuclex::Audio::Storage::WavPack::WavPackBlockScanner &scanner
+  ) {
+    using Nuclex::Audio::Storage::WavPack::WavPackBlockScanner;
+
+    WavPackBlockScanner::Block block;
+    std::vector<std::byte> blockData;
+    if(!scanner.TryReadBlock(0, block, &blockData)) {
+      throw std::out_of_range(u8"WavPack file contains no audio blocks");
+    }
+
+    return blockData;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WavPackRemuxer::Trim(
+    const std::shared_ptr<const VirtualFile> &source,
+    std::uint64_t startFrame, std::uint64_t frameCount,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    WavPackBlockScanner scanner(*source);
+
+    std::uint64_t endSample = startFrame + frameCount;
+    if(scanner.CountTotalSamples() >= 0) {
+      endSample = std::min(endSample, static_cast<std::uint64_t>(scanner.CountTotalSamples()));
+    }
+
+    WavPackBlockScanner::Block group = scanner.FindBlock(startFrame);
+
+    WavPackStreamWriter writer(*target, readFirstBlock(scanner), endSample - startFrame);
+    std::shared_ptr<WavPackTrackDecoder> decoder;
+    std::size_t sampleRate = 0;
+    std::vector<WavPackBlockScanner::Block> blocks;
+    std::vector<std::byte> blockData;
+
+    std::uint64_t position = startFrame;
+    std::uint64_t offset = group.Offset;
+    while((position < endSample) && tryReadGroup(scanner, offset, blocks)) {
+      std::uint64_t groupStart = blocks.front().FirstSample;
+      std::uint64_t groupEnd = groupStart + blocks.front().SampleCount;
+
+      // Groups completely inside the clip are copied, only their headers change
+      bool isWholeGroup = (position == groupStart) && (groupEnd <= endSample);
+      if(isWholeGroup) {
+        for(const WavPackBlockScanner::Block &block : blocks) {
+          blockData.resize(block.Length);
+          source->ReadAt(block.Offset, block.Length, blockData.data());
+          writer.AppendBlock(
+            blockData, block.Flags, block.FirstSample - startFrame, block.SampleCount
+          );
+        }
+        position = groupEnd;
+      } else {
+        if(!decoder) {
+          decoder = std::make_shared<WavPackTrackDecoder>(source);
+
+          TrackInfo trackInfo;
+          WavPackReader(source).ReadMetadata(trackInfo);
+          sampleRate = trackInfo.SampleRate;
+        }
+
+        std::uint64_t pieceEnd = std::min(groupEnd, endSample);
+        appendEncodedSamples(
+          writer, *decoder, sampleRate,
+          position, static_cast<std::size_t>(pieceEnd - position),
+          position - startFrame
+        );
+        position = pieceEnd;
+      }
+
+      offset = blocks.back().Offset + blocks.back().Length;
+    }
+
+    writer.Finish();
+    return writer.CountWrittenSamples();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackRemuxer::Concatenate(
+    const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(sources.empty()) {
+      throw std::invalid_argument(
+        u8"At least one WavPack file needs to be specified for joining"
+      );
+    }
+
+    // Add up the lengths so that the headers can state the right total right away.
+    // Channel layouts need to match since only the first file's layout is kept.
+    std::uint64_t totalSampleCount = 0;
+    std::vector<ChannelPlacement> channelOrder;
+    for(const std::shared_ptr<const VirtualFile> &source : sources) {
+      WavPackReader reader(source);
+      totalSampleCount += reader.CountTotalFrames();
+      if(channelOrder.empty()) {
+        channelOrder = reader.GetChannelOrder();
+      } else if(reader.GetChannelOrder() != channelOrder) {
+        throw Errors::UnsupportedFormatError(
+          u8"WavPack files to be joined need to have the same channel layout"
+        );
+      }
+    }
+
+    std::unique_ptr<WavPackStreamWriter> writer;
+    WavPackBlockScanner::Block block;
+    std::vector<std::byte> blockData;
+    for(const std::shared_ptr<const VirtualFile> &source : sources) {
+      WavPackBlockScanner scanner(*source);
+      if(!writer) {
+        writer = std::make_unique<WavPackStreamWriter>(
+          *target, readFirstBlock(scanner), totalSampleCount
+        );
+      }
+
+      std::uint64_t firstBlockIndex = writer->CountWrittenSamples();
+      std::uint64_t offset = 0;
+      while(scanner.TryReadBlock(offset, block, &blockData)) {
+        writer->AppendBlock(
+          blockData, block.Flags, firstBlockIndex + block.FirstSample, block.SampleCount
+        );
+        offset = block.Offset + block.Length;
+      }
+    }
+
+    writer->Finish();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -0,0 +1,89 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKREMUXER_H
+#define NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKREMUXER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cuts and joins WavPack files by copying their blocks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Blocks that lie completely inside the requested range are copied with only their
+  ///     block index and the total sample count in their headers rewritten. The blocks
+  ///     at either end of a cut are decoded and encoded again, which is exact for lossless
+  ///     WavPack files. Hybrid (lossy) files would lose quality in those two blocks, and
+  ///     correction files are not cut along with the main file.
+  ///   </para>
+  ///   <para>
+  ///     Metadata that describes the original file as a whole is dropped: the wrapped
+  ///     .wav headers and trailers as well as the MD5 sum of the audio data.
+  ///   </para>
+  /// </remarks>
+  class WavPackRemuxer {
+
+    /// <summary>Copies a range of samples from a WavPack file into a new WavPack file</summary>
+    /// <param name="source">WavPack file the clip will be taken from</param>
+    /// <param name="startFrame">Index of the first audio frame the clip will contain</param>
+    /// <param name="frameCount">Number of audio frames the clip will contain</param>
+    /// <param name="target">File the clip will be written into</param>
+    /// <returns>The number of audio frames in the clip that was written</returns>
+    public: static std::uint64_t Trim(
+      const std::shared_ptr<const VirtualFile> &source,
+      std::uint64_t startFrame, std::uint64_t frameCount,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+    /// <summary>Joins several WavPack files into a single WavPack file</summary>
+    /// <param name="sources">WavPack files that will be joined in the order given</param>
+    /// <param name="target">File the joined WavPack stream will be written into</param>
+    public: static void Concatenate(
+      const std::vector<std::shared_ptr<const VirtualFile>> &sources,
+      const std::shared_ptr<VirtualFile> &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#endif // NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKREMUXER_H
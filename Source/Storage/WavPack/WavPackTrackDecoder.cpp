@@ -25,8 +25,12 @@ limitations under the License.
 #if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
 
 #include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Storage/VirtualFile.h"
 
 #include "./WavPackReader.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+#include "../Shared/SeekCostEstimator.h"
 
 #include <cassert> // for assert()
 #include <limits> // for std::numeric_limits
@@ -43,9 +47,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
   // ------------------------------------------------------------------------------------------- //
 
   WavPackTrackDecoder::WavPackTrackDecoder(const std::shared_ptr<const VirtualFile> &file) :
-    reader(file),
+    file(file),
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(Shared::TrackedCodec::WavPack)
+    ),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, file)),
     channelOrder(),
     totalFrameCount(0),
+    blockSize(0),
     nativeSampleFormat(AudioSampleFormat::Unknown),
     decodingMutex() {
 
@@ -53,14 +62,32 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     this->channelOrder = this->reader.GetChannelOrder();
     this->nativeSampleFormat = this->reader.GetSampleFormat();
 
+    this->reader.PrepareForDecoding();
+    this->blockSize = this->reader.GetCurrentBlockSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackTrackDecoder::WavPackTrackDecoder(const WavPackTrackDecoder &other) :
+    file(other.file),
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(
+      Shared::TrackedCodec::WavPack, other.statistics->IsEnabled()
+    )),
+    reader(Shared::DecoderStatisticsCollector::CountReads(this->statistics, other.file)),
+    channelOrder(other.channelOrder),
+    totalFrameCount(other.totalFrameCount),
+    blockSize(other.blockSize),
+    nativeSampleFormat(other.nativeSampleFormat),
+    decodingMutex() {
+
     this->reader.PrepareForDecoding();
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<AudioTrackDecoder> WavPackTrackDecoder::Clone() const {
-    throw std::runtime_error(u8"Not implemented yet");
-    //return std::make_shared<WavPackTrackDecoder>(this->state->File);
+    AllocationScope cloneScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
+    return std::shared_ptr<AudioTrackDecoder>(new WavPackTrackDecoder(*this));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -95,17 +122,71 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void WavPackTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics WavPackTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram WavPackTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath WavPackTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    return this->reader.ExplainDecodePath(sampleFormat, interleaved);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost WavPackTrackDecoder::EstimateSeekCost(std::uint64_t targetFrame) const {
+    std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+
+    Shared::SeekCostEstimator estimator(
+      this->file->GetSize(), this->totalFrameCount, this->blockSize
+    );
+    if(this->reader.GetFrameCursorPosition() == targetFrame) {
+      return estimator.Continue();
+    }
+
+    // libwavpack has no seek index, it searches the file for the block containing
+    // the target frame and decodes that block from its start
+    return estimator.Bisect(GetBlockStart(targetFrame), targetFrame);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WavPackTrackDecoder::GetNominalBlockSize() const {
+    return this->blockSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WavPackTrackDecoder::DecodeInterleavedUint8(
     std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -122,11 +203,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -143,11 +229,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -164,11 +255,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -185,11 +281,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -206,11 +307,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -227,11 +333,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -248,11 +359,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -269,11 +385,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
@@ -290,11 +411,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     verifyDecodeRange(startFrame, frameCount);
 
     {
-      std::lock_guard<std::mutex> decodingMutexScope(this->decodingMutex);
+      NUCLEX_AUDIO_TRACE_ZONE(u8"Decode WavPack", this->file.get(), this);
+      Shared::DecodeStatisticsScope decodingMutexScope(
+        this->decodingMutex, *this->statistics, frameCount
+      );
 
       // If the caller requests to read from a location that is not where the file cursor
       // is currently at, we need to seek to that position first.
       if(this->reader.GetFrameCursorPosition() != startFrame) {
+        NUCLEX_AUDIO_TRACE_ZONE(u8"Seek WavPack", this->file.get(), this);
+        this->statistics->AddSeek();
         this->reader.Seek(startFrame);
       }
 
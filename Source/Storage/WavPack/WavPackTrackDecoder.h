@@ -26,6 +26,7 @@ limitations under the License.
 
 #include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
 #include "./WavPackReader.h"
+#include "../Shared/DecoderStatisticsCollector.h"
 
 #include <mutex> // for std::mutex
 
@@ -42,6 +43,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     /// <summary>Frees all resources owned by the instance</summary>
     public: ~WavPackTrackDecoder() override = default;
 
+    /// <summary>Initializes a new track decoder as a clone of another</summary>
+    /// <param name="other">Track decoder that will be cloned</param>
+    /// <remarks>
+    ///   The clone shares the file and the metadata already extracted from it with
+    ///   the original track decoder, but has its own reader and codec state.
+    /// </remarks>
+    private: WavPackTrackDecoder(const WavPackTrackDecoder &other);
+
     /// <summary>Creates a clone of the audio track decoder</summary>
     /// <returns>A clone of the audio track decoder that can be used independently</returns>
     public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
@@ -66,6 +75,36 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     /// <returns>True if the codec decodes straight to interleaved channels</summary>
     public: bool IsNativelyInterleaved() const override;
 
+    /// <summary>Returns the number of frames in a typical block of the codec</summary>
+    /// <returns>The nominal number of frames in one of the codec's blocks</returns>
+    protected: std::size_t GetNominalBlockSize() const override;
+
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override;
+
+    /// <summary>Retrieves the statistics the decoder has collected so far</summary>
+    /// <returns>The current values of the decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override;
+
+    /// <summary>Retrieves the distribution of the decoder's decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each decoding call took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override;
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
     // The public variant of the DecoeInterleaved() method delegates to our implementations
     public: using AudioTrackDecoder::DecodeInterleaved;
 
@@ -161,6 +200,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       const std::uint64_t startFrame, const std::size_t frameCount
     ) const;
 
+    /// <summary>File the audio track is being decoded from</summary>
+    private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Counts frames, seeks, bytes read and decoding time if enabled</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
     /// <summary>Reader that handles accessing the WavPack file via libwavpack</summary>
     private: mutable WavPackReader reader;
     /// <summary>Order in which audio channels appear</summary>
@@ -172,6 +215,8 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
     ///   and complete WavPack files, at most wrapped in a media container or archive.
     /// </remarks>
     private: std::uint64_t totalFrameCount;
+    /// <summary>Number of frames in a typical block of the WavPack stream</summary>
+    private: std::size_t blockSize;
     /// <summary>The native sample format in the audio file</summary>
     private: AudioSampleFormat nativeSampleFormat;
     /// <summary>Must be held while decoding</summary>
@@ -0,0 +1,437 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WavPackTrackEncoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Shared/ChannelOrderFactory.h"
+#include "../../Platform/WavPackEncoderApi.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <algorithm> // for std::min(), std::find()
+#include <cstring> // for std::memset()
+#include <stdexcept> // for std::invalid_argument, std::logic_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames that are converted for the encoder in one go</summary>
+  const std::size_t ConversionFrameCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the WavPack configuration flags for a compression level</summary>
+  /// <param name="compressionLevel">Compression level from 0 to 4</param>
+  /// <returns>The configuration flags that select the compression mode</returns>
+  int getCompressionFlags(int compressionLevel) {
+    switch(compressionLevel) {
+      case 0: { return CONFIG_FAST_FLAG; }
+      case 1: { return 0; }
+      case 2: { return CONFIG_HIGH_FLAG; }
+      case 3: { return CONFIG_VERY_HIGH_FLAG; }
+      default: { return CONFIG_VERY_HIGH_FLAG | CONFIG_EXTRA_MODE; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackTrackEncoder::WavPackTrackEncoder(
+    const std::shared_ptr<VirtualFile> &target,
+    const std::shared_ptr<VirtualFile> &correctionTarget,
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    std::size_t sampleRate,
+    AudioSampleFormat sampleFormat,
+    int compressionLevel,
+    float hybridBitrate
+  ) :
+    target(target),
+    correctionTarget(correctionTarget),
+    inputChannelOrder(inputChannelOrder),
+    inputChannelIndices(),
+    bitsPerSample(16),
+    isFloat(false),
+    convertedSamples(),
+    wavPackSamples(),
+    mainState(),
+    correctionState(),
+    context() {
+
+    switch(sampleFormat) {
+      case AudioSampleFormat::UnsignedInteger_8: { this->bitsPerSample = 8; break; }
+      case AudioSampleFormat::SignedInteger_16: { this->bitsPerSample = 16; break; }
+      case AudioSampleFormat::SignedInteger_24: { this->bitsPerSample = 24; break; }
+      case AudioSampleFormat::SignedInteger_32: { this->bitsPerSample = 32; break; }
+      case AudioSampleFormat::Float_32: { this->bitsPerSample = 32; this->isFloat = true; break; }
+      default: {
+        throw std::logic_error(u8"Encoder was set up with an unsupported sample format");
+      }
+    }
+
+    // WavPack interleaves channels in the order of their bits in the channel mask,
+    // just like WAVEFORMATEXTENSIBLE. Figure out where each of the channels in WavPack
+    // order can be found in the order the user feeds them.
+    std::size_t channelCount = this->inputChannelOrder.size();
+    ChannelPlacement channelMask = ChannelPlacement::Unknown;
+    for(ChannelPlacement channel : this->inputChannelOrder) {
+      channelMask = channelMask | channel;
+    }
+    std::vector<ChannelPlacement> wavPackChannelOrder = (
+      Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(channelCount, channelMask)
+    );
+    for(ChannelPlacement channel : wavPackChannelOrder) {
+      std::vector<ChannelPlacement>::const_iterator inputChannel = std::find(
+        this->inputChannelOrder.begin(), this->inputChannelOrder.end(), channel
+      );
+      if(unlikely(inputChannel == this->inputChannelOrder.end())) {
+        throw std::invalid_argument(u8"Channel layout cannot be represented in WavPack");
+      }
+      this->inputChannelIndices.push_back(
+        static_cast<std::size_t>(inputChannel - this->inputChannelOrder.begin())
+      );
+    }
+
+    AllocationScope scratchScope(AllocationSubsystem::EncoderScratch);
+    this->convertedSamples.resize(ConversionFrameCount * channelCount);
+    this->wavPackSamples.resize(ConversionFrameCount * channelCount);
+
+    // Set up the adapters that collect the encoded blocks and write them in large chunks
+    ::WavpackBlockOutput blockOutput = nullptr;
+    this->mainState = StreamAdapterFactory::CreateAdapterForBlockOutput(target, blockOutput);
+    if(static_cast<bool>(correctionTarget)) {
+      this->correctionState = StreamAdapterFactory::CreateAdapterForBlockOutput(
+        correctionTarget, blockOutput
+      );
+    }
+
+    this->context = Platform::WavPackEncoderApi::OpenFileOutput(
+      blockOutput, this->mainState.get(), this->correctionState.get()
+    );
+
+    ::WavpackConfig configuration;
+    std::memset(&configuration, 0, sizeof(configuration));
+    configuration.num_channels = static_cast<int>(channelCount);
+    configuration.channel_mask = static_cast<std::int32_t>(channelMask);
+    configuration.sample_rate = static_cast<std::int32_t>(sampleRate);
+    configuration.bits_per_sample = static_cast<int>(this->bitsPerSample);
+    configuration.bytes_per_sample = static_cast<int>((this->bitsPerSample + 7) / 8);
+    if(this->isFloat) {
+      configuration.float_norm_exp = 127; // floats normalized to -1.0 .. +1.0
+    }
+
+    configuration.flags = getCompressionFlags(compressionLevel);
+    if(compressionLevel >= MaximumCompressionLevel) {
+      configuration.xmode = 1; // same as the command line tool's plain '-x' switch
+    }
+    if(hybridBitrate > 0.0f) {
+      configuration.flags |= CONFIG_HYBRID_FLAG | CONFIG_BITRATE_KBPS;
+      configuration.bitrate = hybridBitrate;
+      if(static_cast<bool>(correctionTarget)) {
+        configuration.flags |= CONFIG_CREATE_WVC;
+      }
+    }
+
+    // The total sample count is unknown at this point, it will be filled in on Flush()
+    Platform::WavPackEncoderApi::SetConfiguration64(this->context, configuration, -1);
+    Platform::WavPackEncoderApi::PackInit(this->context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackTrackEncoder::~WavPackTrackEncoder() {
+
+    // The context refers to the adapter states, so it has to go before they do
+    this->context.reset();
+    this->correctionState.reset();
+    this->mainState.reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &WavPackTrackEncoder::GetChannelOrder() const {
+    return this->inputChannelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WavPackTrackEncoder::CountWrittenBytes() const {
+    std::uint64_t writtenByteCount = this->target->GetSize();
+    if(static_cast<bool>(this->correctionTarget)) {
+      writtenByteCount += this->correctionTarget->GetSize();
+    }
+
+    return writtenByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::Flush() {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Flush WavPack", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
+
+    try {
+      Platform::WavPackEncoderApi::FlushSamples(this->mainState->Error, this->context);
+    }
+    catch(...) {
+      if(static_cast<bool>(this->correctionState)) {
+        BlockOutputAdapterState::RethrowPotentialException(*this->correctionState);
+      }
+      throw;
+    }
+
+    completeFile(*this->mainState);
+    if(static_cast<bool>(this->correctionState)) {
+      completeFile(*this->correctionState);
+    }
+
+    // The virtual files may be collecting writes in a buffer, make sure they get written
+    this->target->Flush();
+    if(static_cast<bool>(this->correctionTarget)) {
+      this->correctionTarget->Flush();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeInterleavedUint8(
+    const std::uint8_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeInterleavedInt16(
+    const std::int16_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeInterleavedInt32(
+    const std::int32_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeInterleavedFloat(
+    const float *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeInterleavedDouble(
+    const double *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeSeparatedUint8(
+    const std::uint8_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeSeparatedInt16(
+    const std::int16_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeSeparatedInt32(
+    const std::int32_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeSeparatedFloat(
+    const float *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::EncodeSeparatedDouble(
+    const double *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WavPackTrackEncoder::encodeInterleaved(
+    const TSample *buffer, std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode WavPack", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+
+    // The sample converter leaves the valid bits in the upper end of the integer,
+    // libwavpack wants them in the lower end, so they'll be shifted down when reweaving.
+    // Floating point samples are passed through as their bit patterns.
+    std::size_t shift = this->isFloat ? 0 : (32 - this->bitsPerSample);
+
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      convertSamples(buffer, this->convertedSamples.data(), chunkFrameCount * channelCount);
+
+      const std::int32_t *source = this->convertedSamples.data();
+      std::int32_t *target = this->wavPackSamples.data();
+      for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          target[channelIndex] = source[this->inputChannelIndices[channelIndex]] >> shift;
+        }
+        source += channelCount;
+        target += channelCount;
+      }
+
+      packWavPackSamples(chunkFrameCount);
+
+      buffer += chunkFrameCount * channelCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WavPackTrackEncoder::encodeSeparated(
+    const TSample *buffers[], std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode WavPack", this->target.get(), this);
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+    std::size_t shift = this->isFloat ? 0 : (32 - this->bitsPerSample);
+
+    std::size_t offset = 0;
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        convertSamples(
+          buffers[channelIndex] + offset,
+          this->convertedSamples.data() + (channelIndex * ConversionFrameCount),
+          chunkFrameCount
+        );
+      }
+
+      std::int32_t *target = this->wavPackSamples.data();
+      for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          std::size_t inputChannelIndex = this->inputChannelIndices[channelIndex];
+          target[channelIndex] = this->convertedSamples[
+            inputChannelIndex * ConversionFrameCount + frameIndex
+          ] >> shift;
+        }
+        target += channelCount;
+      }
+
+      packWavPackSamples(chunkFrameCount);
+
+      offset += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WavPackTrackEncoder::convertSamples(
+    const TSample *source, std::int32_t *target, std::size_t sampleCount
+  ) {
+    if(this->isFloat) {
+      Processing::SampleConverter::Convert(
+        source, sizeof(TSample) * 8, reinterpret_cast<float *>(target), 32, sampleCount
+      );
+    } else {
+      Processing::SampleConverter::Convert(
+        source, sizeof(TSample) * 8, target, this->bitsPerSample, sampleCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::packWavPackSamples(std::size_t frameCount) {
+    try {
+      Platform::WavPackEncoderApi::PackSamples(
+        this->mainState->Error,
+        this->context,
+        this->wavPackSamples.data(),
+        static_cast<std::uint32_t>(frameCount)
+      );
+    }
+    catch(...) {
+
+      // If writing the correction file failed, that is the root cause. It can't be passed
+      // in as the root cause exception because libwavpack reports both files as one error.
+      if(static_cast<bool>(this->correctionState)) {
+        BlockOutputAdapterState::RethrowPotentialException(*this->correctionState);
+      }
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WavPackTrackEncoder::completeFile(BlockOutputAdapterState &state) {
+    StreamAdapterFactory::FlushBufferedBlocks(state);
+
+    // Now that the total number of samples is known, put it into the first block
+    if(!state.FirstBlock.empty()) {
+      Platform::WavPackEncoderApi::UpdateNumSamples(this->context, state.FirstBlock.data());
+      StreamAdapterFactory::RewriteFirstBlock(state);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -0,0 +1,231 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKTRACKENCODER_H
+#define NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKTRACKENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include "./WavPackVirtualFileAdapter.h"
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes audio channels to a WavPack audio stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The encoded blocks libwavpack emits are collected in large buffers and written
+  ///     to the virtual file in few, big writes, so encoding many channels at once is
+  ///     not slowed down by lots of small writes.
+  ///   </para>
+  ///   <para>
+  ///     The total number of samples is not known up front, so when the encoder is flushed,
+  ///     libwavpack updates its copy of the first block and that block is written again.
+  ///     In hybrid mode with a correction file, the same is done for the correction file.
+  ///   </para>
+  /// </remarks>
+  class WavPackTrackEncoder : public AudioTrackEncoder {
+
+    /// <summary>Highest compression level the encoder accepts</summary>
+    /// <remarks>
+    ///   Level 0 is WavPack's fast mode, 1 the normal mode, 2 the high mode, 3 the very
+    ///   high mode and 4 the very high mode with the extra filter search enabled.
+    /// </remarks>
+    public: static constexpr int MaximumCompressionLevel = 4;
+
+    /// <summary>Initializes a new WavPack audio track encoder</summary>
+    /// <param name="target">File into which the encoded audio stream will be written</param>
+    /// <param name="correctionTarget">
+    ///   File into which the correction stream will be written, can be empty
+    /// </param>
+    /// <param name="inputChannelOrder">Order in which the channels will be fed in</param>
+    /// <param name="sampleRate">Intended playback rate in samples per second</param>
+    /// <param name="sampleFormat">Format in which the samples will be stored</param>
+    /// <param name="compressionLevel">
+    ///   Compression level from 0 to <see cref="MaximumCompressionLevel" />
+    /// </param>
+    /// <param name="hybridBitrate">
+    ///   Bitrate in kilobits per second for hybrid mode, 0 to compress losslessly
+    /// </param>
+    public: WavPackTrackEncoder(
+      const std::shared_ptr<VirtualFile> &target,
+      const std::shared_ptr<VirtualFile> &correctionTarget,
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      std::size_t sampleRate,
+      AudioSampleFormat sampleFormat,
+      int compressionLevel,
+      float hybridBitrate
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~WavPackTrackEncoder() override;
+
+    /// <summary>Retrieves the channel order the encoder expects its samples in</summary>
+    /// <returns>A list of channels in the order the encoder expects them</returns>
+    /// <remarks>
+    ///   This order is configured in the encode builder and applied to both the interleaved
+    ///   ingestion methods and the separated ingestion methods.
+    /// </remarks>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
+
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: std::uint64_t CountWrittenBytes() const override;
+
+    /// <summary>Encodes any remaining samples and completes the WavPack stream</summary>
+    public: void Flush() override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedUint8(
+      const std::uint8_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt16(
+      const std::int16_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt32(
+      const std::int32_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedFloat(
+      const float *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedDouble(
+      const double *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedUint8(
+      const std::uint8_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt16(
+      const std::int16_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt32(
+      const std::int32_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedFloat(
+      const float *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedDouble(
+      const double *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeInterleaved(const TSample *buffer, std::size_t frameCount);
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeSeparated(const TSample *buffers[], std::size_t frameCount);
+
+    /// <summary>Converts samples into the format the WavPack encoder consumes</summary>
+    /// <typeparam name="TSample">Type of samples that will be converted</typeparam>
+    /// <param name="source">Samples that will be converted</param>
+    /// <param name="target">Buffer that will receive the converted samples</param>
+    /// <param name="sampleCount">Number of samples that will be converted</param>
+    private: template<typename TSample>
+    void convertSamples(const TSample *source, std::int32_t *target, std::size_t sampleCount);
+
+    /// <summary>Hands the samples in the WavPack sample buffer to the encoder</summary>
+    /// <param name="frameCount">Number of audio frames in the WavPack sample buffer</param>
+    private: void packWavPackSamples(std::size_t frameCount);
+
+    /// <summary>Writes out the buffered blocks and the updated first block of a file</summary>
+    /// <param name="state">Block output adapter state of the file being completed</param>
+    private: void completeFile(BlockOutputAdapterState &state);
+
+    /// <summary>File the encoded WavPack stream is written into</summary>
+    private: std::shared_ptr<VirtualFile> target;
+    /// <summary>File the correction stream is written into, empty if none</summary>
+    private: std::shared_ptr<VirtualFile> correctionTarget;
+    /// <summary>Order in which the channels will be fed to the encoder</summary>
+    private: std::vector<ChannelPlacement> inputChannelOrder;
+    /// <summary>Index of the input channel for each channel in WavPack order</summary>
+    private: std::vector<std::size_t> inputChannelIndices;
+    /// <summary>Number of bits each sample is stored with</summary>
+    private: std::size_t bitsPerSample;
+    /// <summary>Whether samples are stored as 32-bit floating point values</summary>
+    private: bool isFloat;
+    /// <summary>Input samples after conversion, still in the input channel order</summary>
+    private: SampleVector<std::int32_t> convertedSamples;
+    /// <summary>Right-aligned samples interleaved in WavPack channel order</summary>
+    private: SampleVector<std::int32_t> wavPackSamples;
+    /// <summary>Buffers and writes the blocks of the main WavPack file</summary>
+    private: std::unique_ptr<BlockOutputAdapterState> mainState;
+    /// <summary>Buffers and writes the blocks of the correction file</summary>
+    private: std::unique_ptr<BlockOutputAdapterState> correctionState;
+    /// <summary>WavPack context that turns raw audio data into WavPack blocks</summary>
+    private: std::shared_ptr<::WavpackContext> context;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#endif // NUCLEX_AUDIO_STORAGE_WAVPACK_WAVPACKTRACKENCODER_H
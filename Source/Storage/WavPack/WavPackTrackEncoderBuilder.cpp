@@ -0,0 +1,258 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WavPackTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "./WavPackTrackEncoder.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
+#include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
+
+#include <algorithm> // for std::min(), std::max()
+#include <limits> // for std::numeric_limits
+#include <set> // for std::set
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+
+#include <Nuclex/Support/BitTricks.h> // for BitTricks
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lowest bitrate libwavpack accepts for hybrid mode in kbps</summary>
+  const float MinimumHybridBitrate = 24.0f;
+
+  /// <summary>Highest bitrate libwavpack accepts for hybrid mode in kbps</summary>
+  const float MaximumHybridBitrate = 9600.0f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackTrackEncoderBuilder::WavPackTrackEncoderBuilder() :
+    inputChannelOrder(),
+    sampleRate(),
+    sampleFormat(AudioSampleFormat::SignedInteger_16),
+    effort(1.0f),
+    hybridBitrate(),
+    correctionFile() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<
+    AudioSampleFormat
+  > &WavPackTrackEncoderBuilder::GetSupportedSampleFormats() const {
+    static const std::vector<AudioSampleFormat> supportedFormats = {
+      AudioSampleFormat::UnsignedInteger_8,
+      AudioSampleFormat::SignedInteger_16,
+      AudioSampleFormat::SignedInteger_24,
+      AudioSampleFormat::SignedInteger_32,
+      AudioSampleFormat::Float_32
+    };
+    return supportedFormats;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &WavPackTrackEncoderBuilder::GetSupportedSampleRates() const {
+    static const std::vector<std::size_t> supportedSampleRates; // empty vector = any
+    return supportedSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &WavPackTrackEncoderBuilder::GetPreferredSampleRates() const {
+    static const std::vector<std::size_t> preferredSampleRates; // empty vector = neutral
+    return preferredSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> WavPackTrackEncoderBuilder::GetPreferredChannelOrder(
+    ChannelPlacement channels
+  ) const {
+    std::size_t channelCount = Nuclex::Support::BitTricks::CountBits(
+      static_cast<std::size_t>(channels)
+    );
+    return Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(channelCount, channels);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WavPackTrackEncoderBuilder::IsLossless() const {
+    return (!this->hybridBitrate.has_value() || static_cast<bool>(this->correctionFile));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetSampleFormat(
+    AudioSampleFormat format /* = AudioSampleFormat::SignedInteger_16 */
+  ) {
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8:
+      case AudioSampleFormat::SignedInteger_16:
+      case AudioSampleFormat::SignedInteger_24:
+      case AudioSampleFormat::SignedInteger_32:
+      case AudioSampleFormat::Float_32: {
+        this->sampleFormat = format;
+        break;
+      }
+      default: {
+        throw std::invalid_argument(
+          u8"WavPack encoder can only store 8, 16, 24 or 32 bit integer samples "
+          u8"or 32 bit floating point samples"
+        );
+      }
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetSampleRate(
+    std::size_t samplesPerSecond /* = 48000 */
+  ) {
+    if(samplesPerSecond > std::numeric_limits<std::int32_t>::max()) {
+      throw std::invalid_argument(u8"WavPack files store the sample rate as a 32-bit value");
+    }
+
+    this->sampleRate = samplesPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetChannels(
+    const std::vector<ChannelPlacement> &orderedChannels
+  ) {
+    std::set<ChannelPlacement> presentChannels(orderedChannels.begin(), orderedChannels.end());
+    if(presentChannels.size() != orderedChannels.size()) {
+      throw std::invalid_argument(u8"Each channel may only appear once in the channel order");
+    }
+
+    // WavPack uses the same channel mask as WAVEFORMATEXTENSIBLE, one bit per speaker,
+    // so each channel must be exactly one known speaker position
+    for(ChannelPlacement channel : orderedChannels) {
+      std::size_t channelBits = static_cast<std::size_t>(channel);
+      if((channelBits == 0) || (Nuclex::Support::BitTricks::CountBits(channelBits) != 1)) {
+        throw std::invalid_argument(
+          u8"Each channel needs to be a single speaker placement to be stored in a WavPack file"
+        );
+      }
+    }
+
+    this->inputChannelOrder = orderedChannels;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetTargetBitrate(
+    float kilobitsPerSecond
+  ) {
+    if(kilobitsPerSecond == 0.0f) {
+      this->hybridBitrate.reset();
+      return *this;
+    }
+
+    bool isWithinRange = (
+      (kilobitsPerSecond >= MinimumHybridBitrate) &&
+      (kilobitsPerSecond <= MaximumHybridBitrate)
+    );
+    if(!isWithinRange) {
+      throw std::invalid_argument(
+        u8"WavPack hybrid mode requires a bitrate between 24 and 9600 kbps"
+      );
+    }
+
+    this->hybridBitrate = kilobitsPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetCompressionEffort(
+    float newEffort /* = 1.0f */
+  ) {
+    this->effort = newEffort;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WavPackTrackEncoderBuilder &WavPackTrackEncoderBuilder::SetCorrectionFile(
+    const std::shared_ptr<VirtualFile> &newCorrectionFile
+  ) {
+    this->correctionFile = newCorrectionFile;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackEncoder> WavPackTrackEncoderBuilder::Build(
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(this->inputChannelOrder.empty()) {
+      throw std::runtime_error(
+        u8"Input channels and channel order for the encoder have not been set"
+      );
+    }
+    if(!this->sampleRate.has_value()) {
+      throw std::runtime_error(u8"Input sample rate for the encoder has not been set");
+    }
+    if(static_cast<bool>(this->correctionFile) && !this->hybridBitrate.has_value()) {
+      throw std::runtime_error(
+        u8"A correction file can only be written in hybrid mode, which needs a target bitrate"
+      );
+    }
+
+    int compressionLevel = static_cast<int>(
+      this->effort * static_cast<float>(WavPackTrackEncoder::MaximumCompressionLevel) + 0.5f
+    );
+    compressionLevel = std::min(
+      std::max(compressionLevel, 0), WavPackTrackEncoder::MaximumCompressionLevel
+    );
+
+    AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::WavPack);
+
+    return std::make_shared<WavPackTrackEncoder>(
+      target,
+      this->correctionFile,
+      this->inputChannelOrder,
+      this->sampleRate.value(),
+      this->sampleFormat,
+      compressionLevel,
+      this->hybridBitrate.value_or(0.0f)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
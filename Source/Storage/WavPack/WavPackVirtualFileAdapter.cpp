@@ -58,6 +58,11 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Number of bytes the block output adapter collects before writing</summary>
+  const std::size_t BlockOutputBufferByteCount = 4 * 1024 * 1024; // 4 MiB
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Reads up to specified number of bytes from the file</summary>
   /// <typeparam name="TAdapterState">
   ///   Type of state the read is done on (because we don't want to const_cast here)
@@ -389,6 +394,38 @@ namespace {
     return 0;
   }
 
+  /// <summary>Collects a block emitted by the WavPack encoder for writing</summary>
+  /// <param name="id">User-defined pointer that holds the block output adapter</param>
+  /// <param name="data">Pointer to a buffer containing the encoded block</param>
+  /// <param name="byteCount">Length of the encoded block in bytes</param>
+  /// <returns>Non-zero on success, zero in case of an error</returns>
+  int wavPackWriteBlock(void *id, void *data, std::int32_t byteCount) {
+    Nuclex::Audio::Storage::WavPack::BlockOutputAdapterState &state = *reinterpret_cast<
+      Nuclex::Audio::Storage::WavPack::BlockOutputAdapterState *
+    >(id);
+    assert(!state.IsReadOnly && u8"Block output is performed on write state");
+
+    const std::byte *dataAsBytes = reinterpret_cast<const std::byte *>(data);
+    try {
+      if(unlikely(state.FirstBlock.empty())) {
+        state.FirstBlock.assign(dataAsBytes, dataAsBytes + byteCount);
+      }
+
+      state.BufferedBytes.insert(
+        state.BufferedBytes.end(), dataAsBytes, dataAsBytes + byteCount
+      );
+      if(state.BufferedBytes.size() >= BlockOutputBufferByteCount) {
+        Nuclex::Audio::Storage::WavPack::StreamAdapterFactory::FlushBufferedBlocks(state);
+      }
+    }
+    catch(const std::exception &) {
+      state.Error = std::current_exception();
+      return 0; // wavpack_local.h defines FALSE as 0
+    }
+
+    return 1; // wavpack_local.h defines TRUE as 1
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -457,6 +494,50 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::unique_ptr<BlockOutputAdapterState> StreamAdapterFactory::CreateAdapterForBlockOutput(
+    const std::shared_ptr<VirtualFile> &writableFile,
+    ::WavpackBlockOutput &blockOutput
+  ) {
+    std::unique_ptr<BlockOutputAdapterState> adapter = (
+      std::make_unique<BlockOutputAdapterState>()
+    );
+
+    adapter->IsReadOnly = false;
+    adapter->FileCursor = 0;
+    adapter->Error = std::exception_ptr();
+    adapter->File = writableFile;
+    adapter->BufferedBytes.reserve(BlockOutputBufferByteCount);
+
+    blockOutput = &wavPackWriteBlock;
+
+    return adapter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamAdapterFactory::FlushBufferedBlocks(BlockOutputAdapterState &state) {
+    if(state.BufferedBytes.empty()) {
+      return;
+    }
+
+    state.File->WriteAt(state.FileCursor, state.BufferedBytes.size(), state.BufferedBytes.data());
+    state.FileCursor += state.BufferedBytes.size();
+    state.BufferedBytes.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StreamAdapterFactory::RewriteFirstBlock(BlockOutputAdapterState &state) {
+    assert(state.BufferedBytes.empty() && u8"Buffered blocks are flushed before rewriting");
+    if(state.FirstBlock.empty()) {
+      return;
+    }
+
+    state.File->WriteAt(0, state.FirstBlock.size(), state.FirstBlock.data());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::WavPack
 
 #endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -66,6 +66,25 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Stores informations processed by the WavPack block output adapter</summary>
+  struct BlockOutputAdapterState : public Shared::VirtualFileAdapterState {
+
+    /// <summary>Virtual file the encoded blocks are written into</summary>
+    public: std::shared_ptr<VirtualFile> File;
+    /// <summary>Encoded blocks that have not been written to the file yet</summary>
+    /// <remarks>
+    ///   libwavpack emits one block per second of audio or so, which would be a lot of
+    ///   small writes for a multichannel recording, so blocks are collected here until
+    ///   the buffer is full and then written in one go.
+    /// </remarks>
+    public: std::vector<std::byte> BufferedBytes;
+    /// <summary>Copy of the first block, which gets the final sample count later</summary>
+    public: std::vector<std::byte> FirstBlock;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Constructs WavPack StreamReader adapters and hooks up stream readers</summary>
   class StreamAdapterFactory {
 
@@ -95,6 +114,31 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
       ::WavpackStreamReader64 &streamReader
     );
 
+    /// <summary>Constructs a block output adapter for an encoder to write into</summary>
+    /// <param name="writableFile">Virtual file the adapter will write to</param>
+    /// <param name="blockOutput">
+    ///   Receives the block output callback that needs to be passed to WavPack
+    /// </param>
+    /// <returns>
+    ///   A state that needs to be passed as the 'wv_id' or 'wvc_id' parameter to WavPack
+    /// </returns>
+    public: static std::unique_ptr<BlockOutputAdapterState> CreateAdapterForBlockOutput(
+      const std::shared_ptr<VirtualFile> &writableFile,
+      ::WavpackBlockOutput &blockOutput
+    );
+
+    /// <summary>Writes any blocks still held in the adapter's buffer to the file</summary>
+    /// <param name="state">Block output adapter state whose buffer will be written</param>
+    public: static void FlushBufferedBlocks(BlockOutputAdapterState &state);
+
+    /// <summary>Overwrites the first block in the file with the adapter's copy</summary>
+    /// <param name="state">Block output adapter state holding the first block</param>
+    /// <remarks>
+    ///   Used after libwavpack has been asked to update the sample count in the first
+    ///   block. All buffered blocks must have been flushed before calling this.
+    /// </remarks>
+    public: static void RewriteFirstBlock(BlockOutputAdapterState &state);
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -23,8 +23,11 @@ limitations under the License.
 #include "./WaveformAudioCodec.h"
 #include "./WaveformDetection.h"
 #include "./WaveformReader.h"
+#include "./WaveformTrackDecoder.h"
+#include "./WaveformTrackEncoderBuilder.h"
 
 #include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/AllocationScope.h"
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 
@@ -59,12 +62,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool WaveformAudioCodec::IsSignaturePresent(
+    const std::byte *header, std::size_t byteCount
+  ) const {
+    return Detection::CheckIfWaveformHeaderPresent(header, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::optional<ContainerInfo> WaveformAudioCodec::TryReadInfo(
     const std::shared_ptr<const VirtualFile> &source,
     const std::string &extensionHint /* = std::string() */
   ) const {
     (void)extensionHint;
 
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata, AllocationCodec::Waveform);
     return WaveformReader::TryReadMetadata(source);
   }
 
@@ -77,15 +89,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   ) const {
     (void)extensionHint;
 
+    // As the AudioCodec interface promises, if the file is not a Waveform audio file,
+    // we'll return an empty result to indicate that we couldn't read it.
+    if(!Detection::CheckIfWaveformHeaderPresent(*source)) {
+      return std::shared_ptr<AudioTrackDecoder>();
+    }
+
+    // Waveform files only ever contain a single track
     if(trackIndex != 0) {
       throw std::runtime_error(
         u8"Alternate track decoding is not implemented yet, track index must be 0"
       );
     }
 
+    AllocationScope readerScope(AllocationSubsystem::ReaderScratch, AllocationCodec::Waveform);
+    return std::make_shared<WaveformTrackDecoder>(source);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    (void)source;
-    throw std::runtime_error(u8"Not implemented yet");
+  std::shared_ptr<AudioTrackEncoderBuilder> WaveformAudioCodec::ProvideBuilder() const {
+    return std::make_shared<WaveformTrackEncoderBuilder>();
   }
 
   // ------------------------------------------------------------------------------------------- //
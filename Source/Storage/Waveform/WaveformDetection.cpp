@@ -117,6 +117,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     std::byte fileHeader[24];
     source.ReadAt(0, 24, fileHeader);
 
+    return CheckIfWaveformHeaderPresent(fileHeader, sizeof(fileHeader));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Detection::CheckIfWaveformHeaderPresent(
+    const std::byte *fileHeader, std::size_t byteCount
+  ) {
+    if(byteCount < 24) {
+      return false; // Not enough header bytes to check for a valid Waveform header
+    }
+
     // Officially, there's only RIFF (little-endian) and RIFX (big-endian) with identical
     // structure except for the endianness of any integers / floats found in the file.
     // Some libraries I sampled also handle "FFIR" (RIFF backwards) files as big-endian,
@@ -146,6 +158,34 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       (fileHeader[3] == std::byte(0x52))      //  4 R | library saving a file on a big-endian system.
     );
 
+    // RF64 (EBU Tech 3306) and BW64 (ITU-R BS.2088) are little endian Waveform files
+    // that record sizes beyond 4 GiB in a 'ds64' chunk which has to be the first chunk.
+    bool isRf64 = (
+      (
+        (
+          (fileHeader[0] == std::byte(0x52)) && //  1 R | RF64 (FourCC; chunk descriptor)
+          (fileHeader[1] == std::byte(0x46))    //  2 F |
+        ) || (
+          (fileHeader[0] == std::byte(0x42)) && //  1 B | BW64 (FourCC; chunk descriptor)
+          (fileHeader[1] == std::byte(0x57))    //  2 W |
+        )
+      ) &&
+      (fileHeader[2] == std::byte(0x36)) &&     //  3 6 | Both use 0xFFFFFFFF as the RIFF size
+      (fileHeader[3] == std::byte(0x34)) &&     //  4 4 | and keep the real one in 'ds64'
+      (fileHeader[12] == std::byte(0x64)) &&    //  1 d |
+      (fileHeader[13] == std::byte(0x73)) &&    //  2 s | ds64 (FourCC; 64-bit sizes chunk)
+      (fileHeader[14] == std::byte(0x36)) &&    //  3 6 |
+      (fileHeader[15] == std::byte(0x34))       //  4 4 |
+    );
+    if(isRf64) {
+      return (
+        (fileHeader[8] == std::byte(0x57)) &&    //  1 W | WAVE (format id)
+        (fileHeader[9] == std::byte(0x41)) &&    //  2 A |
+        (fileHeader[10] == std::byte(0x56)) &&   //  3 V | RF64 is only used for Waveform
+        (fileHeader[11] == std::byte(0x45))      //  4 E | audio, but let's be thorough.
+      );
+    }
+
     std::uint32_t blockSize, firstChunkSize;
     if(isLittleEndian) {
       blockSize = (
@@ -25,6 +25,7 @@ limitations under the License.
 #include <string> // for std::string
 #include <memory> // for std::unique_ptr
 #include <cstdint> // for std::uint64_t
+#include <cstddef> // for std::byte
 
 namespace Nuclex { namespace Audio { namespace Storage {
 
@@ -61,6 +62,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// <returns>True if a valid Waveform header was found, false otherwise</returns>
     public: static bool CheckIfWaveformHeaderPresent(const VirtualFile &source);
 
+    /// <summary>Checks if the file header starts with a valid Waveform header</summary>
+    /// <param name="fileHeader">Bytes from the beginning of the checked file</param>
+    /// <param name="byteCount">Number of bytes available in the header buffer</param>
+    /// <returns>True if a valid Waveform header was found, false otherwise</returns>
+    public: static bool CheckIfWaveformHeaderPresent(
+      const std::byte *fileHeader, std::size_t byteCount
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
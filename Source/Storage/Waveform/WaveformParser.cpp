@@ -26,8 +26,10 @@ limitations under the License.
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 
 #include <array> // for std::array, used a 'Guid'
-#include <algorithm> // for std::copy_n()
+#include <algorithm> // for std::copy_n(), std::stable_sort()
 #include <cassert> // for assert()
+#include <cstring> // for std::memcmp()
+#include <unordered_map> // for std::unordered_map
 
 namespace {
 
@@ -65,6 +67,29 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Length of a single cue point in the 'cue ' chunk</summary>
+  constexpr std::size_t CuePointLength = 24;
+
+  /// <summary>Length of the fixed fields of an 'ltxt' entry in the 'adtl' list</summary>
+  constexpr std::size_t LabeledTextFieldsLength = 20;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a string that may or may not be zero-terminated</summary>
+  /// <param name="characters">Characters of the string</param>
+  /// <param name="maximumLength">Number of bytes the string can at most occupy</param>
+  /// <returns>The string up to its terminator or up to the maximum length</returns>
+  std::string readZeroTerminatedString(const std::byte *characters, std::size_t maximumLength) {
+    std::size_t length = 0;
+    while((length < maximumLength) && (characters[length] != std::byte(0))) {
+      ++length;
+    }
+
+    return std::string(reinterpret_cast<const char *>(characters), length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
@@ -118,6 +143,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     target(target),
     formatChunkParsed(false),
     factChunkParsed(false),
+    ds64ChunkParsed(false),
+    ds64RiffSize(0),
+    ds64DataChunkLength(0),
+    pendingMarkerDetails(),
     storedBitsPerSample(0),
     blockAlignment(0),
     firstSampleOffset(std::uint64_t(-1)),
@@ -157,6 +186,93 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<>
+  void WaveformParser::ParseSampleChunk<LittleEndianReader>(const std::byte *buffer) {
+    parseSampleChunkInternal<LittleEndianReader>(buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseSampleChunk<BigEndianReader>(const std::byte *buffer) {
+    parseSampleChunkInternal<BigEndianReader>(buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseCueChunk<LittleEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  ) {
+    parseCueChunkInternal<LittleEndianReader>(buffer, chunkLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseCueChunk<BigEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  ) {
+    parseCueChunkInternal<BigEndianReader>(buffer, chunkLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseAssociatedDataList<LittleEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  ) {
+    parseAssociatedDataListInternal<LittleEndianReader>(buffer, chunkLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseAssociatedDataList<BigEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  ) {
+    parseAssociatedDataListInternal<BigEndianReader>(buffer, chunkLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformParser::ParseDs64Chunk(const std::byte *buffer) {
+    if(this->ds64ChunkParsed) {
+      throw Errors::CorruptedFileError(
+        u8"Waveform audio file contains more than one 'ds64' (64-bit sizes) chunk"
+      );
+    }
+
+    // The chunk continues with the sample count and an optional table of sizes for
+    // other chunks beyond 4 GiB, but only the 'data' chunk will ever grow that large.
+    this->ds64RiffSize = LittleEndianReader::ReadUInt64(buffer + 8);
+    this->ds64DataChunkLength = LittleEndianReader::ReadUInt64(buffer + 16);
+
+    this->ds64ChunkParsed = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WaveformParser::ResolveRiffSize(std::uint32_t recordedRiffSize) const {
+    if(this->ds64ChunkParsed && (recordedRiffSize == 0xFFFFFFFFu)) {
+      return this->ds64RiffSize;
+    } else {
+      return recordedRiffSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WaveformParser::ResolveDataChunkLength(std::uint32_t recordedChunkLength) const {
+    if(this->ds64ChunkParsed && (recordedChunkLength == 0xFFFFFFFFu)) {
+      return this->ds64DataChunkLength;
+    } else {
+      return recordedChunkLength;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WaveformParser::SetDataChunkStart(
     std::uint64_t startOffset, std::uint64_t remainingByteCount
   ) {
@@ -286,6 +402,7 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       this->target.BitsPerSample = static_cast<std::size_t>(
         TReader::ReadUInt16(chunk + 22)
       );
+      this->storedBitsPerSample = this->target.BitsPerSample;
       if(this->target.BitsPerSample >= 33) {
         this->target.SampleFormat = Nuclex::Audio::AudioSampleFormat::Float_64;
       } else if(formatTag == WaveFormatFloatPcm) { // Float and not 64 bits? Must be 32.
@@ -378,6 +495,19 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       );
     }
 
+    // Without channels, samples or a sample rate, there is nothing to play and
+    // the frame count and duration calculations would divide by zero.
+    if((this->target.ChannelCount == 0) || (this->target.SampleRate == 0)) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(
+        u8"Waveform audio file claims to have zero channels or a sample rate of zero"
+      );
+    }
+    if((this->storedBitsPerSample == 0) && (this->blockAlignment == 0)) {
+      throw Nuclex::Audio::Errors::CorruptedFileError(
+        u8"Waveform audio file claims to store zero bits per sample"
+      );
+    }
+
     this->formatChunkParsed = true;
 
     if(this->firstSampleOffset != std::uint64_t(-1)) {
@@ -412,15 +542,192 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TReader>
+  void WaveformParser::parseSampleChunkInternal(const std::byte *chunk) {
+
+    // The chunk begins with the manufacturer, product, sample period, MIDI unity note,
+    // MIDI pitch fraction, SMPTE format and SMPTE offset (7 x 4 bytes), followed by
+    // the number of loops and the size of the trailing sampler-specific data.
+    std::uint32_t loopCount = TReader::ReadUInt32(chunk + 8 + 28);
+    if(loopCount == 0) {
+      return;
+    }
+
+    // Each loop has a cue point id, a type, start and end (both inclusive, in frames),
+    // a fraction for sub-sample precision and a play count where 0 means forever.
+    const std::byte *loop = chunk + 8 + 36;
+    std::uint32_t loopType = TReader::ReadUInt32(loop + 4);
+    if(loopType != 0) {
+      return; // Not a forward loop
+    }
+
+    std::uint32_t startFrame = TReader::ReadUInt32(loop + 8);
+    std::uint32_t lastFrame = TReader::ReadUInt32(loop + 12);
+    if(lastFrame < startFrame) {
+      return;
+    }
+
+    LoopRegion region;
+    region.StartFrame = startFrame;
+    region.EndFrame = static_cast<std::uint64_t>(lastFrame) + 1;
+    region.PlayCount = TReader::ReadUInt32(loop + 20);
+    this->target.Loop = region;
+
+    if(this->formatChunkParsed && (this->firstSampleOffset != std::uint64_t(-1))) {
+      clampLoopRegion();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TReader>
+  void WaveformParser::parseCueChunkInternal(const std::byte *chunk, std::size_t chunkLength) {
+    if(chunkLength < 4) {
+      return;
+    }
+
+    // The chunk holds a count followed by the cue points. Each has an id, a play order
+    // position, the FourCC of the chunk it refers to, the chunk and block start (only
+    // used with 'wavl' lists nobody writes) and the offset of the cue point in frames.
+    std::size_t cuePointCount = TReader::ReadUInt32(chunk + 8);
+    std::size_t availableCuePointCount = (chunkLength - 4) / CuePointLength;
+    if(availableCuePointCount < cuePointCount) {
+      cuePointCount = availableCuePointCount;
+    }
+
+    const std::byte *cuePoint = chunk + 12;
+    for(std::size_t index = 0; index < cuePointCount; ++index) {
+      Marker &marker = this->target.Markers.emplace_back();
+      marker.Id = TReader::ReadUInt32(cuePoint);
+      marker.StartFrame = TReader::ReadUInt32(cuePoint + 20);
+      marker.FrameCount = 0;
+
+      cuePoint += CuePointLength;
+    }
+
+    // Keep the markers sorted by their position so they can be looked up by range
+    std::stable_sort(
+      this->target.Markers.begin(), this->target.Markers.end(),
+      [](const Marker &left, const Marker &right) { return left.StartFrame < right.StartFrame; }
+    );
+
+    attachMarkerDetails();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TReader>
+  void WaveformParser::parseAssociatedDataListInternal(
+    const std::byte *list, std::size_t chunkLength
+  ) {
+    const std::byte *end = list + 8 + chunkLength;
+    const std::byte *subChunk = list + 12; // Skip the chunk header and the 'adtl' list type
+
+    // Walk the sub-chunks. 'note' entries hold comments and are of no interest to us,
+    // 'labl' entries name a cue point and 'ltxt' entries give a cue point a length.
+    while(static_cast<std::size_t>(end - subChunk) >= 12) {
+      std::size_t subChunkLength = TReader::ReadUInt32(subChunk + 4);
+      if(subChunkLength > static_cast<std::size_t>(end - subChunk) - 8) {
+        break; // Sub-chunk would extend beyond the list, file is probably truncated
+      }
+
+      if((std::memcmp(subChunk, u8"labl", 4) == 0) && (subChunkLength >= 4)) {
+        Marker &details = this->pendingMarkerDetails.emplace_back();
+        details.Id = TReader::ReadUInt32(subChunk + 8);
+        details.StartFrame = 0;
+        details.FrameCount = 0;
+        details.Label = readZeroTerminatedString(subChunk + 12, subChunkLength - 4);
+      } else if(std::memcmp(subChunk, u8"ltxt", 4) == 0) {
+        if(subChunkLength >= LabeledTextFieldsLength) {
+          Marker &details = this->pendingMarkerDetails.emplace_back();
+          details.Id = TReader::ReadUInt32(subChunk + 8);
+          details.StartFrame = 0;
+          details.FrameCount = TReader::ReadUInt32(subChunk + 12);
+        }
+      }
+
+      // Sub-chunks are padded to 16 bits just like the chunks around them
+      std::size_t skippedByteCount = subChunkLength + 8 + (subChunkLength & 1);
+      if(skippedByteCount >= static_cast<std::size_t>(end - subChunk)) {
+        break;
+      }
+      subChunk += skippedByteCount;
+    }
+
+    attachMarkerDetails();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformParser::attachMarkerDetails() {
+    if(this->pendingMarkerDetails.empty() || this->target.Markers.empty()) {
+      return;
+    }
+
+    std::unordered_map<std::uint32_t, std::size_t> markerIndices;
+    for(std::size_t index = 0; index < this->target.Markers.size(); ++index) {
+      markerIndices.emplace(this->target.Markers[index].Id, index);
+    }
+
+    // Move the details over to the markers they belong to. Details for cue points
+    // that haven't appeared (yet) stay pending in case another 'cue ' chunk follows.
+    std::size_t remainingCount = 0;
+    for(std::size_t index = 0; index < this->pendingMarkerDetails.size(); ++index) {
+      Marker &details = this->pendingMarkerDetails[index];
+
+      std::unordered_map<std::uint32_t, std::size_t>::const_iterator markerIndex = (
+        markerIndices.find(details.Id)
+      );
+      if(markerIndex == markerIndices.end()) {
+        if(remainingCount != index) {
+          this->pendingMarkerDetails[remainingCount] = std::move(details);
+        }
+        ++remainingCount;
+      } else {
+        Marker &marker = this->target.Markers[markerIndex->second];
+        if(details.Label.has_value()) {
+          marker.Label = std::move(details.Label);
+        }
+        if(details.FrameCount != 0) {
+          marker.FrameCount = details.FrameCount;
+        }
+      }
+    }
+
+    this->pendingMarkerDetails.resize(remainingCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformParser::clampLoopRegion() {
+    if(!this->target.Loop.has_value()) {
+      return;
+    }
+
+    std::uint64_t frameCount = CountFrames();
+    LoopRegion &loop = this->target.Loop.value();
+    if(loop.EndFrame > frameCount) {
+      loop.EndFrame = frameCount;
+    }
+    if(loop.EndFrame <= loop.StartFrame) {
+      this->target.Loop.reset(); // Loop lies outside of the audio data
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WaveformParser::calculateDuration() {
     assert(
       this->formatChunkParsed &&
       u8"calculateDuration() is called with the format chunk already parsed"
     );
 
+    this->target.FrameCount = CountFrames();
     this->target.Duration = std::chrono::microseconds(
-      CountFrames() * 1'000'000 / this->target.SampleRate
+      this->target.FrameCount * 1'000'000 / this->target.SampleRate
     );
+
+    clampLoopRegion();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -27,6 +27,7 @@ limitations under the License.
 
 #include <cstdint> // for std::uint8_t
 #include <type_traits> // for std::is_same
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
@@ -55,6 +56,26 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// <returns>True if the buffer contained the FourCC of the 'data' chunk</returns>
     public: static bool IsDataChunk(const std::byte *buffer);
 
+    /// <summary>Checks if the FourCC of a chunk indicates the RF64 'ds64' chunk</summary>
+    /// <param name="buffer">Buffer that will be checked for holding the 'ds64' chunk</param>
+    /// <returns>True if the buffer contained the FourCC of the 'ds64' chunk</returns>
+    public: static bool IsDs64Chunk(const std::byte *buffer);
+
+    /// <summary>Checks if the FourCC of a chunk indicates the sampler 'smpl' chunk</summary>
+    /// <param name="buffer">Buffer that will be checked for holding the 'smpl' chunk</param>
+    /// <returns>True if the buffer contained the FourCC of the 'smpl' chunk</returns>
+    public: static bool IsSampleChunk(const std::byte *buffer);
+
+    /// <summary>Checks if the FourCC of a chunk indicates the cue point 'cue ' chunk</summary>
+    /// <param name="buffer">Buffer that will be checked for holding the 'cue ' chunk</param>
+    /// <returns>True if the buffer contained the FourCC of the 'cue ' chunk</returns>
+    public: static bool IsCueChunk(const std::byte *buffer);
+
+    /// <summary>Checks if a chunk is the associated data list ('LIST' of type 'adtl')</summary>
+    /// <param name="buffer">Buffer holding at least the chunk header and list type</param>
+    /// <returns>True if the buffer contained an associated data list</returns>
+    public: static bool IsAssociatedDataList(const std::byte *buffer);
+
     /// <summary>Initializes a new Waveform audio reader</summary>
     /// <param name="target">TrackInfo structure metadata will be placed in</param>
     public: WaveformParser(Nuclex::Audio::TrackInfo &target);
@@ -92,6 +113,68 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     public: template<typename TReader = LittleEndianReader>
     void ParseFactChunk(const std::byte *buffer);
 
+    /// <summary>Parses the first loop stored in the sampler ('smpl') chunk</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">
+    ///   Buffer containing a sampler chunk with at least one loop, starting at its FourCC
+    /// </param>
+    /// <remarks>
+    ///   Samplers and game audio tools store loop points here. Only forward loops can
+    ///   be played seamlessly, ping-pong and backward loops are ignored.
+    /// </remarks>
+    public: template<typename TReader = LittleEndianReader>
+    void ParseSampleChunk(const std::byte *buffer);
+
+    /// <summary>Parses the cue points stored in the 'cue ' chunk</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">Buffer containing the whole cue chunk, starting at its FourCC</param>
+    /// <param name="chunkLength">Length of the chunk in bytes, minus 8 bytes</param>
+    public: template<typename TReader = LittleEndianReader>
+    void ParseCueChunk(const std::byte *buffer, std::size_t chunkLength);
+
+    /// <summary>Parses the labels and region lengths in the 'adtl' list</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">Buffer containing the whole list, starting at its FourCC</param>
+    /// <param name="chunkLength">Length of the list in bytes, minus 8 bytes</param>
+    /// <remarks>
+    ///   The list refers to cue points by their ids, so it may appear before or after
+    ///   the 'cue ' chunk. Its 'labl' entries name cue points and its 'ltxt' entries
+    ///   turn them into regions by giving them a length.
+    /// </remarks>
+    public: template<typename TReader = LittleEndianReader>
+    void ParseAssociatedDataList(const std::byte *buffer, std::size_t chunkLength);
+
+    /// <summary>Parses the 64-bit sizes stored in the RF64 / BW64 'ds64' chunk</summary>
+    /// <param name="buffer">
+    ///   Buffer containing a ds64 chunk, starting at its FourCC header
+    /// </param>
+    /// <remarks>
+    ///   RF64 (EBU Tech 3306) and BW64 (ITU-R BS.2088) files are always little endian.
+    ///   They set the 32-bit sizes of the RIFF and 'data' chunks to 0xFFFFFFFF and record
+    ///   the actual sizes in this chunk, which comes right after the RIFF header.
+    /// </remarks>
+    public: void ParseDs64Chunk(const std::byte *buffer);
+
+    /// <summary>Determines the actual size of the RIFF container</summary>
+    /// <param name="recordedRiffSize">Size recorded in the RIFF header</param>
+    /// <returns>
+    ///   The recorded size or, in RF64 files, the 64-bit size from the 'ds64' chunk
+    /// </returns>
+    public: std::uint64_t ResolveRiffSize(std::uint32_t recordedRiffSize) const;
+
+    /// <summary>Determines the actual length of the 'data' chunk</summary>
+    /// <param name="recordedChunkLength">Length recorded in the 'data' chunk's header</param>
+    /// <returns>
+    ///   The recorded length or, in RF64 files, the 64-bit length from the 'ds64' chunk
+    /// </returns>
+    public: std::uint64_t ResolveDataChunkLength(std::uint32_t recordedChunkLength) const;
+
     /// <summary>Records the offset of the 'data' chunk in the Waveform file</summary>
     /// <param name="startOffset">Absolute offset of the data chunk's header</param>
     /// <param name="remainingByteCount">Number of bytes that remain in the file</param>
@@ -135,6 +218,40 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     private: template<typename TReader>
     void parseFactChunkInternal(const std::byte *buffer);
 
+    /// <summary>Actual implementation of the ParseSampleChunk() method</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">
+    ///   Buffer containing a sampler chunk, starting at its FourCC header
+    /// </param>
+    private: template<typename TReader>
+    void parseSampleChunkInternal(const std::byte *buffer);
+
+    /// <summary>Actual implementation of the ParseCueChunk() method</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">Buffer containing the whole cue chunk, starting at its FourCC</param>
+    /// <param name="chunkLength">Length of the chunk in bytes, minus 8 bytes</param>
+    private: template<typename TReader>
+    void parseCueChunkInternal(const std::byte *buffer, std::size_t chunkLength);
+
+    /// <summary>Actual implementation of the ParseAssociatedDataList() method</summary>
+    /// <typeparam name="TReader">
+    ///   Reader used to read numeric values in the file as big or little endian
+    /// </typeparam>
+    /// <param name="buffer">Buffer containing the whole list, starting at its FourCC</param>
+    /// <param name="chunkLength">Length of the list in bytes, minus 8 bytes</param>
+    private: template<typename TReader>
+    void parseAssociatedDataListInternal(const std::byte *buffer, std::size_t chunkLength);
+
+    /// <summary>Hands labels and lengths from the 'adtl' list to their cue points</summary>
+    private: void attachMarkerDetails();
+
+    /// <summary>Cuts the loop region off at the end of the audio data</summary>
+    private: void clampLoopRegion();
+
     /// <summary>Calculates the playback duration of the audio data</summary>
     private: void calculateDuration();
 
@@ -144,6 +261,18 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     private: bool formatChunkParsed;
     /// <summary>Whether the extra metadata chunk has been parsed yet</summary>
     private: bool factChunkParsed;
+    /// <summary>Whether the RF64 64-bit size chunk has been parsed yet</summary>
+    private: bool ds64ChunkParsed;
+    /// <summary>Size of the RIFF container as recorded in the 'ds64' chunk</summary>
+    private: std::uint64_t ds64RiffSize;
+    /// <summary>Length of the 'data' chunk as recorded in the 'ds64' chunk</summary>
+    private: std::uint64_t ds64DataChunkLength;
+    /// <summary>Labels and region lengths not yet matched up with a cue point</summary>
+    /// <remarks>
+    ///   If the 'adtl' list comes before the 'cue ' chunk, its entries wait here until
+    ///   the cue points they refer to have been parsed.
+    /// </remarks>
+    private: std::vector<Marker> pendingMarkerDetails;
 
     /// <summaery>Number of bits used to store each audio sample in the file</summary>
     private: std::size_t storedBitsPerSample;
@@ -180,6 +309,43 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline bool WaveformParser::IsSampleChunk(const std::byte *buffer) {
+    return (
+      (buffer[0] == std::byte(0x73)) &&  //  1 s | "smpl" (sampler chunk)
+      (buffer[1] == std::byte(0x6d)) &&  //  2 m |
+      (buffer[2] == std::byte(0x70)) &&  //  3 p | Written by samplers and game audio tools,
+      (buffer[3] == std::byte(0x6c))     //  4 l | holds the MIDI note and loop points.
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline bool WaveformParser::IsCueChunk(const std::byte *buffer) {
+    return (
+      (buffer[0] == std::byte(0x63)) &&  //  1 c | "cue " (cue point chunk)
+      (buffer[1] == std::byte(0x75)) &&  //  2 u |
+      (buffer[2] == std::byte(0x65)) &&  //  3 e | Written by sound editors, holds the positions
+      (buffer[3] == std::byte(0x20))     //  4   | of markers the user placed in the audio.
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  inline bool WaveformParser::IsAssociatedDataList(const std::byte *buffer) {
+    return (
+      (buffer[0] == std::byte(0x4c)) &&  //  1 L | "LIST" (list chunk)
+      (buffer[1] == std::byte(0x49)) &&  //  2 I |
+      (buffer[2] == std::byte(0x53)) &&  //  3 S | Lists hold sub-chunks, the type following
+      (buffer[3] == std::byte(0x54)) &&  //  4 T | the length says what they're about.
+      (buffer[8] == std::byte(0x61)) &&  //  1 a | "adtl" (associated data list)
+      (buffer[9] == std::byte(0x64)) &&  //  2 d |
+      (buffer[10] == std::byte(0x74)) && //  3 t | Labels, notes and region lengths for
+      (buffer[11] == std::byte(0x6c))    //  4 l | the cue points in the 'cue ' chunk.
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   inline bool WaveformParser::IsDataChunk(const std::byte *buffer) {
     return (
       (buffer[0] == std::byte(0x64)) &&  //  1 d | "data" (audio data chunk)
@@ -191,6 +357,17 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  inline bool WaveformParser::IsDs64Chunk(const std::byte *buffer) {
+    return (
+      (buffer[0] == std::byte(0x64)) &&  //  1 d | "ds64" (64-bit sizes chunk)
+      (buffer[1] == std::byte(0x73)) &&  //  2 s |
+      (buffer[2] == std::byte(0x36)) &&  //  3 6 | Chunk that must come first in RF64 and BW64
+      (buffer[3] == std::byte(0x34))     //  4 4 | files, holding sizes beyond 4 GiB.
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   template<typename TReader>
   inline void WaveformParser::ParseFormatChunk(
     const std::byte *buffer, std::size_t chunkLength
@@ -239,6 +416,58 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<typename TReader>
+  inline void WaveformParser::ParseCueChunk(const std::byte *buffer, std::size_t chunkLength) {
+    static_assert(
+      std::is_same<TReader, LittleEndianReader>::value ||
+      std::is_same<TReader, BigEndianReader>::value,
+      u8"TReader must be either a LittleEndianReader or a BigEndianReader"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseCueChunk<LittleEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseCueChunk<BigEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TReader>
+  inline void WaveformParser::ParseAssociatedDataList(
+    const std::byte *buffer, std::size_t chunkLength
+  ) {
+    static_assert(
+      std::is_same<TReader, LittleEndianReader>::value ||
+      std::is_same<TReader, BigEndianReader>::value,
+      u8"TReader must be either a LittleEndianReader or a BigEndianReader"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseAssociatedDataList<LittleEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  void WaveformParser::ParseAssociatedDataList<BigEndianReader>(
+    const std::byte *buffer, std::size_t chunkLength
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Waveform
 
 #endif // NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMPARSER_H
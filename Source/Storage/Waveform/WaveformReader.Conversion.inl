@@ -25,10 +25,213 @@ limitations under the License.
 #include "Nuclex/Audio/Processing/Quantization.h"
 #include "Nuclex/Audio/Processing/Reconstruction.h"
 #include "Nuclex/Audio/Processing/BitExtension.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+#include "Nuclex/Audio/Processing/Int24Packing.h"
+#include "Nuclex/Audio/Processing/ByteSwapping.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Storage/ChunkSizePolicy.h"
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of integer samples that are unpacked per batch</summary>
+  /// <remarks>
+  ///   The unpacked samples are kept on the stack, this is small enough to not cause
+  ///   any trouble there and large enough to keep the per-batch overhead negligible.
+  /// </remarks>
+  const std::size_t UnpackedSampleCount = 1024;
+
+  /// <summary>Number of channels whose target pointers are tracked on the stack</summary>
+  /// <remarks>
+  ///   Files with more channels than this are rare enough that they can afford to put
+  ///   their channel pointers onto the heap in each call.
+  /// </remarks>
+  const std::size_t InlineChannelCount = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Asks the chunk size policy how many frames to process per step</summary>
+  /// <param name="channelCount">Number of channels in each frame</param>
+  /// <param name="bytesPerStoredFrame">Bytes each frame occupies in the file</param>
+  /// <param name="bytesPerScratchSample">
+  ///   Additional bytes each sample occupies in scratch buffers other than the read buffer
+  /// </param>
+  /// <param name="bytesPerOutputSample">Bytes each sample occupies in the target</param>
+  /// <returns>The number of frames to read and convert in one step</returns>
+  std::size_t getChunkFrameCount(
+    std::size_t channelCount,
+    std::size_t bytesPerStoredFrame,
+    std::size_t bytesPerScratchSample,
+    std::size_t bytesPerOutputSample
+  ) {
+    std::size_t bytesPerStoredSample = (bytesPerStoredFrame + channelCount - 1) / channelCount;
+    return Nuclex::Audio::Storage::ChunkSizePolicy::GetGlobal().GetChunkFrameCount(
+      channelCount, bytesPerStoredSample + bytesPerScratchSample, bytesPerOutputSample
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of stored floating point samples</summary>
+  /// <typeparam name="TStoredFloat">Floating point type the samples are stored as</typeparam>
+  /// <param name="source">Samples as they are stored in the Waveform file</param>
+  /// <param name="target">Receives the byte-swapped samples, can be the source</param>
+  /// <param name="count">Number of samples that will be byte-swapped</param>
+  template<typename TStoredFloat>
+  void swapStoredFloats(const std::byte *source, std::byte *target, std::size_t count) {
+    if constexpr(sizeof(TStoredFloat) == 8) {
+      Nuclex::Audio::Processing::ByteSwapping::Swap64(source, target, count);
+    } else {
+      Nuclex::Audio::Processing::ByteSwapping::Swap32(source, target, count);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks integer samples into sign-extended 32-bit integers</summary>
+  /// <param name="data">Samples as they are stored in the Waveform file</param>
+  /// <param name="bytesPerSample">Size of each stored sample's container in bytes</param>
+  /// <param name="isLittleEndian">Whether the samples are stored little endian</param>
+  /// <param name="areBytesSigned">Whether 8-bit samples are signed (AIFF)</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">
+  ///   Number of samples that will be unpacked, at most <see cref="UnpackedSampleCount" />
+  /// </param>
+  /// <remarks>
+  ///   The unpacked samples still have the unused bits of their container (if any)
+  ///   at the bottom, so a 20-bit sample will be unpacked into a 24-bit value.
+  /// </remarks>
+  void unpackIntegerSamples(
+    const std::byte *data, std::size_t bytesPerSample, bool isLittleEndian,
+    bool areBytesSigned, std::int32_t *results, std::size_t count
+  ) {
+    assert((count <= UnpackedSampleCount) && u8"Unpacked batch fits into the swap buffer");
+
+    // Big endian 24-bit samples are swapped by the unpacking shuffle itself. For 16-bit
+    // and 32-bit samples, the batch is swapped into a stack buffer that is still in
+    // the cache when the little endian code below picks it up.
+    std::byte swapped[UnpackedSampleCount * 4];
+    if(!isLittleEndian) {
+      if(bytesPerSample == 2) {
+        Nuclex::Audio::Processing::ByteSwapping::Swap16(data, swapped, count);
+        data = swapped;
+      } else if(bytesPerSample == 3) {
+        Nuclex::Audio::Processing::Int24Packing::UnpackBigEndianToInt32(data, results, count);
+        return;
+      } else if(bytesPerSample == 4) {
+        Nuclex::Audio::Processing::ByteSwapping::Swap32(data, swapped, count);
+        data = swapped;
+      }
+    }
+
+    switch(bytesPerSample) {
+      case 1: { // 8-bit Waveform samples are unsigned, AIFF stores them signed
+        if(areBytesSigned) {
+          for(std::size_t index = 0; index < count; ++index) {
+            results[index] = static_cast<std::int8_t>(data[index]);
+          }
+        } else {
+          for(std::size_t index = 0; index < count; ++index) {
+            results[index] = static_cast<std::int32_t>(data[index]) - 128;
+          }
+        }
+        break;
+      }
+      case 2: {
+        for(std::size_t index = 0; index < count; ++index) {
+          results[index] = static_cast<std::int16_t>(
+            static_cast<std::uint16_t>(data[0]) | (static_cast<std::uint16_t>(data[1]) << 8)
+          );
+          data += 2;
+        }
+        break;
+      }
+      case 3: {
+        Nuclex::Audio::Processing::Int24Packing::UnpackToInt32(data, results, count);
+        break;
+      }
+      default: {
+        assert((bytesPerSample == 4) && u8"Integer samples have at most 4 bytes");
+        for(std::size_t index = 0; index < count; ++index) {
+          results[index] = static_cast<std::int32_t>(
+            (static_cast<std::uint32_t>(data[0])) |
+            (static_cast<std::uint32_t>(data[1]) << 8) |
+            (static_cast<std::uint32_t>(data[2]) << 16) |
+            (static_cast<std::uint32_t>(data[3]) << 24)
+          );
+          data += 4;
+        }
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts unpacked integer samples into another integer sample format</summary>
+  /// <typeparam name="TSample">Integer type the samples will be converted to</typeparam>
+  /// <typeparam name="WidenFactor">
+  ///   0 or 1 if the target has fewer or as many bits as the samples, 2 if the bits
+  ///   need to be repeated once and 3 if they need to be repeated twice
+  /// </typeparam>
+  /// <param name="source">Sign-extended samples with the container's unused bits</param>
+  /// <param name="shift">Number of unused bits at the bottom of each sample</param>
+  /// <param name="bitsPerSample">Number of valid bits in each sample</param>
+  /// <param name="target">Address at which the first converted sample will be stored</param>
+  /// <param name="sampleCount">Number of samples that will be converted</param>
+  template<typename TSample, int WidenFactor>
+  void convertIntegerSamples(
+    const std::int32_t *source, int shift, std::size_t bitsPerSample,
+    TSample *target, std::size_t sampleCount
+  ) {
+    using Nuclex::Audio::Processing::BitExtension;
+
+    constexpr int targetBitCount = static_cast<int>(sizeof(TSample) * 8);
+    constexpr std::int32_t bias = std::is_same<TSample, std::uint8_t>::value ? 128 : 0;
+
+    int sourceBitCount = static_cast<int>(bitsPerSample);
+
+    // If the target has fewer or as many bits as the stored samples, we cut off
+    // the unused bits together with any bits the target has no room for
+    if constexpr(WidenFactor < 2) {
+      int truncateShift = shift + sourceBitCount - targetBitCount;
+      for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+        target[sampleIndex] = static_cast<TSample>((source[sampleIndex] >> truncateShift) + bias);
+      }
+      return;
+    }
+
+    // The target has more bits, so move the sample bits to the top of an int32 and
+    // repeat their bit pattern below so the sample covers the whole range of the target
+    // type. Finally, shift it down to the size of the target type.
+    int topShift = 32 - sourceBitCount;
+    int repeatShift = sourceBitCount - 1;
+    int downShift = 32 - targetBitCount;
+
+    std::int32_t mask = (std::int32_t(1) << (sourceBitCount - 1)) - 1;
+    if(repeatShift > topShift) {
+      mask >>= (repeatShift - topShift);
+    } else {
+      mask <<= (topShift - repeatShift);
+    }
+
+    for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+      std::int32_t extended;
+      if constexpr(WidenFactor == 2) {
+        extended = BitExtension::ShiftAndRepeatSigned(
+          topShift, source[sampleIndex] >> shift, repeatShift, mask
+        );
+      } else {
+        extended = BitExtension::ShiftAndTripleSigned(
+          topShift, source[sampleIndex] >> shift, repeatShift, mask
+        );
+      }
+      target[sampleIndex] = static_cast<TSample>((extended >> downShift) + bias);
+    }
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -53,17 +256,36 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       std::is_same<TSample, double>::value
     );
 
-    // TODO: This may need endian flipping
-    //   If have yet to obtain any big endian Waveform audio files. Or a big endian
-    //   test machine / VM on which I can check this.
+    // If the file can hand out its memory directly (i.e. memory-mapped or in-memory files),
+    // we can convert straight from the file's memory and skip the intermediate buffer.
+    // The stored samples are accessed by type, so the memory needs to be aligned for them.
+    constexpr std::size_t storedSampleAlignment = (
+      (WidenFactor == -2) ? alignof(double) : storedSamplesAreFloat ? alignof(float) : 1
+    );
+    const std::byte *borrowedData = this->file->TryBorrowAt(
+      startFrame * this->bytesPerFrame + this->firstSampleOffset,
+      frameCount * this->bytesPerFrame
+    );
+    if(reinterpret_cast<std::uintptr_t>(borrowedData) % storedSampleAlignment != 0) {
+      borrowedData = nullptr;
+    }
 
-    // Allocate an intermedia buffer. We use std::byte because we're going to be
-    // reading into it without knowing the actual data type in the file at compile time
+    // Size the intermediate buffer. We use std::byte because we're going to be
+    // reading into it without knowing the actual data type in the file at compile time.
+    // It's kept between calls, so once it has grown, decoding no longer allocates.
     std::size_t readChunkSize = frameCount;
-    while(readChunkSize >= 12000) {
-      readChunkSize >>= 1;
+    bool mustSwapFloats = (storedSamplesAreFloat && !this->isLittleEndian);
+    if((borrowedData == nullptr) || mustSwapFloats) {
+      readChunkSize = std::min(
+        frameCount,
+        getChunkFrameCount(this->trackInfo.ChannelCount, this->bytesPerFrame, 0, sizeof(TSample))
+      );
+      std::size_t requiredByteCount = readChunkSize * this->bytesPerFrame;
+      if(this->readBuffer.size() < requiredByteCount) {
+        AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+        this->readBuffer.resize(requiredByteCount);
+      }
     }
-    std::vector<std::byte> readBuffer(readChunkSize * this->bytesPerFrame);
 
     while(0 < frameCount) {
 
@@ -76,11 +298,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       } else {
         readFrameCount = readChunkSize;
       }
-      this->file->ReadAt(
-        startFrame * this->bytesPerFrame + this->firstSampleOffset,
-        readFrameCount * this->bytesPerFrame,
-        readBuffer.data()
-      );
+
+      const std::byte *readData;
+      if(borrowedData == nullptr) {
+        this->file->ReadAt(
+          startFrame * this->bytesPerFrame + this->firstSampleOffset,
+          readFrameCount * this->bytesPerFrame,
+          this->readBuffer.data()
+        );
+        readData = this->readBuffer.data();
+
+        // Let the OS fetch the next chunk while we're busy converting this one
+        if(readFrameCount < frameCount) {
+          this->file->Prefetch(
+            (startFrame + readFrameCount) * this->bytesPerFrame + this->firstSampleOffset,
+            std::min(frameCount - readFrameCount, readChunkSize) * this->bytesPerFrame
+          );
+        }
+      } else {
+        readData = borrowedData;
+        borrowedData += readFrameCount * this->bytesPerFrame;
+      }
       startFrame += readFrameCount;
 
       std::size_t readSampleCount = readFrameCount * this->trackInfo.ChannelCount;
@@ -89,7 +327,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
         typedef typename std::conditional<
           WidenFactor == -1, float, double // -1 indicates float, -2 indicates double
         >::type StoredFloatType;
-        StoredFloatType *decodedFloats = reinterpret_cast<StoredFloatType *>(readBuffer.data());
+
+        // Big endian floats are byte-swapped straight into the target if nothing else
+        // needs to be done to them, otherwise into the read buffer (in place if the data
+        // was read into it) right before they're converted.
+        if(mustSwapFloats) {
+          if constexpr(std::is_same<TSample, StoredFloatType>::value) {
+            swapStoredFloats<StoredFloatType>(
+              readData, reinterpret_cast<std::byte *>(target), readSampleCount
+            );
+            target += readSampleCount;
+            frameCount -= readFrameCount;
+            continue;
+          } else {
+            swapStoredFloats<StoredFloatType>(readData, this->readBuffer.data(), readSampleCount);
+            readData = this->readBuffer.data();
+          }
+        }
+
+        const StoredFloatType *decodedFloats = (
+          reinterpret_cast<const StoredFloatType *>(readData)
+        );
 
         if constexpr(targetTypeIsFloat) {
 
@@ -155,36 +413,15 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
       } else { // if stored samples are ^^ float ^^ / vv int vv
 
-        // Here it gets a bit troublesome. The entire RIFF file format normally uses
-        // 16-bit alignment (i.e. chunks with odd sizes are padded to the next 16-bit
-        // boundary). This behavior could be kept or lifted for audio data.
-        //
-        // We assume this 16-bit alignment does not apply to the audio data (if some
-        // writing application wanted to, it could set the 'bytesPerFrame' to include
-        // padding and we would respect that, though).
+        // The entire RIFF file format normally uses 16-bit alignment (i.e. chunks with odd
+        // sizes are padded to the next 16-bit boundary). We assume this does not apply to
+        // the samples themselves, a writer wanting to pad them would have to include the
+        // padding in the block alignment and that's where we take the container size from.
         //
-        // The next issue is audio samples with bit depths not dividable by 8. In this
-        // case, This
-        // is possible, but the specification doesn't state whether the occupied bits
-        // are the most significant 
-
-#if 0
-        std::int32_t *decodedInts = reinterpret_cast<std::int32_t *>(decodeBuffer.data());
-
-        // How libwavpack aligns samples is a bit unique. Going by the docs:
-        //
-        // - samples always fill complete bytes, leaving the high bytes empty
-        //   (so for 16-bit audio, the two high bytes will be zero and for 24-bit audio,
-        //   the highest byte will be zero)
-        //
-        // - if bits per sample is not a multiple of 8, the least significant bits will
-        //   remain unused. I don't know if libwavpack just leaves them zeroed (so naive
-        //   usage will loose a bit of amplitude range)
-        //
-        // This shift moves the sample bits to the right so the entire sample value is
-        // in the least significant bits and the limit calculated above fits.
-        //
-        int shift = static_cast<int>(this->bytesPerSample * 8 - this->bitsPerSample);
+        // Samples with bit depths not dividable by 8 occupy the most significant bits of
+        // their container, so after unpacking, the unused low bits need to be shifted away.
+        std::size_t bytesPerSample = this->bytesPerFrame / this->trackInfo.ChannelCount;
+        int shift = static_cast<int>(bytesPerSample * 8 - this->trackInfo.BitsPerSample);
 
         if constexpr(targetTypeIsFloat) {
 
@@ -194,140 +431,278 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
             std::is_same<TSample, double>::value || BitsPerSampleOver16, double, float
           >::type LimitType;
           LimitType limit = static_cast<LimitType>(
-            (std::uint32_t(1) << (this->bitsPerSample - 1)) - 1
+            (std::uint32_t(1) << (this->trackInfo.BitsPerSample - 1)) - 1
           );
 
-          // Now convert the samples. Negative numbers make it through this because C++ is
-          // doing arithmetic shifts on the int32s and the signal reconstruction code casts
-          // whole int32s to floats/doubles.
-          while(3 < sampleCount) {
-            Nuclex::Audio::Processing::Reconstruction::ShiftAndDivideInt32ToFloatx4(
-              decodedInts, shift, limit, target
-            );
-            decodedInts += 4;
-            target += 4;
-            sampleCount -= 4;
+          // Packed 24-bit samples are by far the most common high resolution format,
+          // they get unpacked and normalized in one go by the 24-bit unpacking kernels
+          if(bytesPerSample == 3) {
+            if(this->isLittleEndian) {
+              Processing::Int24Packing::UnpackToFloat(
+                readData, shift, static_cast<double>(limit), target, readSampleCount
+              );
+            } else {
+              Processing::Int24Packing::UnpackBigEndianToFloat(
+                readData, shift, static_cast<double>(limit), target, readSampleCount
+              );
+            }
+            target += readSampleCount;
+          } else {
+            std::int32_t unpacked[UnpackedSampleCount];
+            while(0 < readSampleCount) {
+              std::size_t batchSampleCount = std::min(readSampleCount, UnpackedSampleCount);
+              unpackIntegerSamples(
+                readData, bytesPerSample, this->isLittleEndian, this->areBytesSigned,
+                unpacked, batchSampleCount
+              );
+              Processing::ConversionKernels::ShiftAndDivideInt32ToFloat(
+                unpacked, shift, limit, target, batchSampleCount
+              );
+
+              readData += batchSampleCount * bytesPerSample;
+              target += batchSampleCount;
+              readSampleCount -= batchSampleCount;
+            }
           }
-          while(0 < sampleCount) {
-            target[0] = static_cast<TSample>(
-              Nuclex::Audio::Processing::Reconstruction::DivideInt32ToFloat(
-                decodedInts[0] >> shift, limit
-              )
+
+        } else { // if target type is ^^ floating point ^^ / vv integer vv
+
+          std::int32_t unpacked[UnpackedSampleCount];
+          while(0 < readSampleCount) {
+            std::size_t batchSampleCount = std::min(readSampleCount, UnpackedSampleCount);
+            unpackIntegerSamples(
+              readData, bytesPerSample, this->isLittleEndian, this->areBytesSigned,
+              unpacked, batchSampleCount
             );
-            ++decodedInts;
-            ++target;
-            --sampleCount;
+            convertIntegerSamples<TSample, WidenFactor>(
+              unpacked, shift, this->trackInfo.BitsPerSample, target, batchSampleCount
+            );
+
+            readData += batchSampleCount * bytesPerSample;
+            target += batchSampleCount;
+            readSampleCount -= batchSampleCount;
           }
 
-          target += sampleCount;
+        } // if target type is floating point / integer
+      } // if decoded data is float / int32
 
-        } else { // if target type is ^^ double ^^ / vv integer vv
+      frameCount -= readFrameCount;
 
-          // If the target data type has fewer bits, samples need to be truncated
-          if constexpr(targetIntegerHasFewerBits) {
+    }
+  }
 
-            int truncateShift = static_cast<int>(shift + this->bitsPerSample - 16);
-            for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
-              if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-                target[sampleIndex] = static_cast<TSample>(
-                  (decodedInts[sampleIndex] >> truncateShift) + 128
-                );
-              } else {
-                target[sampleIndex] = static_cast<TSample>(
-                  decodedInts[sampleIndex] >> truncateShift
-                );
-              }
-            }
-            target += sampleCount;
+  // ------------------------------------------------------------------------------------------- //
 
-          } else if constexpr(decodedIntegerMatchesTargetBits) { // Same number of bits
+  template<
+    typename TSample,
+    bool BitsPerSampleOver16 /* = false */,
+    int WidenFactor /* = 0 */
+  >
+  void WaveformReader::readInterleavedConvertAndSeparate(
+    TSample *targets[], std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    constexpr bool storedSamplesAreFloat = (WidenFactor < 0); // per convention
+    constexpr bool targetTypeIsFloat = (
+      std::is_same<TSample, float>::value ||
+      std::is_same<TSample, double>::value
+    );
 
-            // Reasoning: output types are 8, 16 or 32-bit (and 32-bit is handled separately),
-            // so if we reach a match, there is no shifting required at all (see note on
-            // the behavior of libwavpack a few screens up).
-            for(std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
-              if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-                target[sampleIndex] = static_cast<TSample>(decodedInts[sampleIndex] + 128);
-              } else {
-                target[sampleIndex] = static_cast<TSample>(decodedInts[sampleIndex]);
-              }
-            }
-            target += sampleCount;
+    // The channel pointers are in a caller-provided array, if we changed them,
+    // we'd trash the caller's own pointers, so we have to take a copy. Channels for
+    // which the caller passed a null pointer are left out entirely.
+    const std::size_t channelCount = this->trackInfo.ChannelCount;
+    TSample *inlineTargets[InlineChannelCount];
+    std::size_t inlineChannelIndices[InlineChannelCount];
+    std::vector<TSample *> heapTargets;
+    std::vector<std::size_t> heapChannelIndices;
+    TSample **mutableTargets = inlineTargets;
+    std::size_t *wantedChannelIndices = inlineChannelIndices;
+    if(unlikely(channelCount > InlineChannelCount)) {
+      heapTargets.resize(channelCount);
+      heapChannelIndices.resize(channelCount);
+      mutableTargets = heapTargets.data();
+      wantedChannelIndices = heapChannelIndices.data();
+    }
 
-          } else { // target integer is longer, bits need to be extended
+    std::size_t wantedChannelCount = 0;
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      if(targets[index] != nullptr) {
+        mutableTargets[wantedChannelCount] = targets[index];
+        wantedChannelIndices[wantedChannelCount] = index;
+        ++wantedChannelCount;
+      }
+    }
+    if(wantedChannelCount == 0) {
+      return; // Nothing is decoded ahead, so there's no state to update either
+    }
 
-            int topShift = static_cast<int>(32 - this->bitsPerSample - shift);
-            int repeatShift = static_cast<int>(this->bitsPerSample - 1);
+    // Integer samples need to be unpacked and converted first, which the interleaved
+    // reading method already does. We let it convert a batch of frames at a time and
+    // have the interleaver hand each channel to its target.
+    if constexpr(!storedSamplesAreFloat) {
+      TSample **channelTargets = mutableTargets; // the interleaver skips null pointers
+      std::copy_n(targets, channelCount, channelTargets);
+
+      // The interleaved batch is scratch memory on top of the read buffer, so the batch
+      // is sized to keep the read buffer, the batch and the channel targets in cache.
+      std::size_t separationBatchFrameCount = getChunkFrameCount(
+        channelCount, this->bytesPerFrame, sizeof(TSample), sizeof(TSample)
+      );
+      std::size_t requiredByteCount = (
+        std::min(frameCount, separationBatchFrameCount) * channelCount * sizeof(TSample)
+      );
+      if(this->separationBuffer.size() < requiredByteCount) {
+        AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+        this->separationBuffer.resize(requiredByteCount);
+      }
+      TSample *interleaved = reinterpret_cast<TSample *>(this->separationBuffer.data());
+      while(0 < frameCount) {
+        std::size_t batchFrameCount = std::min(frameCount, separationBatchFrameCount);
+        readInterleavedAndConvert<TSample, BitsPerSampleOver16, WidenFactor>(
+          interleaved, startFrame, batchFrameCount
+        );
+        Processing::Interleaver::Deinterleave(
+          interleaved, channelTargets, channelCount, batchFrameCount
+        );
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          if(channelTargets[channelIndex] != nullptr) {
+            channelTargets[channelIndex] += batchFrameCount;
+          }
+        }
 
-            // Build a mask that will cover the bits that should be occupied after
-            // the first "repeat shift" - this is needed to cut off the sign bit
-            // and (since C++ does arithmetic shifts on signed types) to remove
-            // the leading bits caused by sign-extending the integer.
-            std::int32_t mask = (1 << (this->bitsPerSample - 1)) - 1;
-            if(repeatShift > topShift) {
-              mask >>= (repeatShift - topShift);
-            } else {
-              mask <<= (topShift - repeatShift);
+        startFrame += batchFrameCount;
+        frameCount -= batchFrameCount;
+      }
+      return;
+    }
+
+    // If the file can hand out its memory directly (i.e. memory-mapped or in-memory files),
+    // we can convert straight from the file's memory and skip the intermediate buffer.
+    // The stored samples are accessed by type, so the memory needs to be aligned for them.
+    constexpr std::size_t storedSampleAlignment = (
+      (WidenFactor == -2) ? alignof(double) : storedSamplesAreFloat ? alignof(float) : 1
+    );
+    const std::byte *borrowedData = this->file->TryBorrowAt(
+      startFrame * this->bytesPerFrame + this->firstSampleOffset,
+      frameCount * this->bytesPerFrame
+    );
+    if(reinterpret_cast<std::uintptr_t>(borrowedData) % storedSampleAlignment != 0) {
+      borrowedData = nullptr;
+    }
+
+    std::size_t readChunkSize = frameCount;
+    bool mustSwapFloats = (storedSamplesAreFloat && !this->isLittleEndian);
+    if((borrowedData == nullptr) || mustSwapFloats) {
+      readChunkSize = std::min(
+        frameCount,
+        getChunkFrameCount(this->trackInfo.ChannelCount, this->bytesPerFrame, 0, sizeof(TSample))
+      );
+      std::size_t requiredByteCount = readChunkSize * this->bytesPerFrame;
+      if(this->readBuffer.size() < requiredByteCount) {
+        AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+        this->readBuffer.resize(requiredByteCount);
+      }
+    }
+
+    while(0 < frameCount) {
+      std::size_t readFrameCount;
+      if(frameCount < readChunkSize) {
+        readFrameCount = frameCount;
+      } else {
+        readFrameCount = readChunkSize;
+      }
+
+      const std::byte *readData;
+      if(borrowedData == nullptr) {
+        this->file->ReadAt(
+          startFrame * this->bytesPerFrame + this->firstSampleOffset,
+          readFrameCount * this->bytesPerFrame,
+          this->readBuffer.data()
+        );
+        readData = this->readBuffer.data();
+
+        // Let the OS fetch the next chunk while we're busy converting this one
+        if(readFrameCount < frameCount) {
+          this->file->Prefetch(
+            (startFrame + readFrameCount) * this->bytesPerFrame + this->firstSampleOffset,
+            std::min(frameCount - readFrameCount, readChunkSize) * this->bytesPerFrame
+          );
+        }
+      } else {
+        readData = borrowedData;
+        borrowedData += readFrameCount * this->bytesPerFrame;
+      }
+      startFrame += readFrameCount;
+
+      if constexpr(storedSamplesAreFloat) {
+        typedef typename std::conditional<
+          WidenFactor == -1, float, double // -1 indicates float, -2 indicates double
+        >::type StoredFloatType;
+
+        // Big endian floats are byte-swapped into the read buffer before anything else
+        if(mustSwapFloats) {
+          swapStoredFloats<StoredFloatType>(
+            readData, this->readBuffer.data(), readFrameCount * channelCount
+          );
+          readData = this->readBuffer.data();
+        }
+
+        // If the caller wants all channels in the stored format, this is a plain
+        // deinterleave that the interleaver can do with its SIMD shuffles
+        if constexpr(std::is_same<TSample, StoredFloatType>::value) {
+          if(wantedChannelCount == channelCount) {
+            Processing::Interleaver::Deinterleave(
+              reinterpret_cast<const TSample *>(readData),
+              mutableTargets, channelCount, readFrameCount
+            );
+            for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+              mutableTargets[channelIndex] += readFrameCount;
             }
 
-            // Note: instead of shifting to the top, then shifting to the repeat position,
-            // we could also calculate the shift to the top (and not do it if it is zero)
-            // and the shift to the repeat position from the original position.
-            // Might lead to a tiny performance gain.
-            while(3 < sampleCount) {
-              std::int32_t converted[4];
-              if constexpr(WidenFactor == 2) {
-                Processing::BitExtension::ShiftAndRepeatSignedx4(
-                  topShift, decodedInts, repeatShift, mask, converted
-                );
-              } else {
-                Processing::BitExtension::ShiftAndTripleSignedx4(
-                  topShift, decodedInts, repeatShift, mask, converted
-                );
-              }
+            frameCount -= readFrameCount;
+            continue;
+          }
+        }
+
+        // Walk through the interleaved samples once for each channel the caller wants.
+        // Channels the caller skipped are never touched.
+        for(std::size_t wantedIndex = 0; wantedIndex < wantedChannelCount; ++wantedIndex) {
+          const StoredFloatType *decodedFloats = (
+            reinterpret_cast<const StoredFloatType *>(readData) +
+            wantedChannelIndices[wantedIndex]
+          );
+          TSample *target = mutableTargets[wantedIndex];
 
-              if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-                target[0] = static_cast<TSample>(converted[0] + 128);
-                target[1] = static_cast<TSample>(converted[1] + 128);
-                target[2] = static_cast<TSample>(converted[2] + 128);
-                target[3] = static_cast<TSample>(converted[3] + 128);
-              } else {
-                target[0] = static_cast<TSample>(converted[0]);
-                target[1] = static_cast<TSample>(converted[1]);
-                target[2] = static_cast<TSample>(converted[2]);
-                target[3] = static_cast<TSample>(converted[3]);
-              }
-              decodedInts += 4;
-              target += 4;
-              sampleCount -= 4;
+          if constexpr(targetTypeIsFloat) {
+            for(std::size_t frameIndex = 0; frameIndex < readFrameCount; ++frameIndex) {
+              target[frameIndex] = static_cast<TSample>(*decodedFloats);
+              decodedFloats += channelCount;
             }
-            while(0 < sampleCount) {
-              std::int32_t converted;
-              if constexpr(WidenFactor == 2) {
-                converted = Processing::BitExtension::ShiftAndRepeatSigned(
-                  topShift, decodedInts[0], repeatShift, mask
-                );
-              } else {
-                converted = Processing::BitExtension::ShiftAndTripleSigned(
-                  topShift, decodedInts[0], repeatShift, mask
-                );
-              }
+          } else { // if target type is ^^ floating point ^^ / vv integer vv
+            typedef typename std::conditional<
+              sizeof(TSample) < 17, float, double
+            >::type LimitType;
+            constexpr LimitType limit = static_cast<LimitType>(
+              (std::uint32_t(1) << (sizeof(TSample) * 8 - 1)) - 1
+            );
 
+            for(std::size_t frameIndex = 0; frameIndex < readFrameCount; ++frameIndex) {
+              std::int32_t scaled = Nuclex::Audio::Processing::Quantization::NearestInt32(
+                static_cast<LimitType>(*decodedFloats) * limit
+              );
               if constexpr(std::is_same<TSample, std::uint8_t>::value) {
-                target[0] = static_cast<TSample>(converted + 128);
+                target[frameIndex] = static_cast<TSample>(scaled + 128);
               } else {
-                target[0] = static_cast<TSample>(converted);
+                target[frameIndex] = static_cast<TSample>(scaled);
               }
-              ++decodedInts;
-              ++target;
-              --sampleCount;
+              decodedFloats += channelCount;
             }
+          } // if target type is floating point / integer
 
-          } // if integer needs to be truncated / extended
+          mutableTargets[wantedIndex] += readFrameCount;
+        } // for each wanted channel
 
-        } // if target type is double / integer
-#endif
-      } // if decoded data is float / int32
+      } // if stored samples are float
 
       frameCount -= readFrameCount;
 
@@ -336,16 +711,4 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
-  template<
-    typename TSample,
-    bool BitsPerSampleOver16 /* = false */,
-    int WidenFactor /* = 0 */
-  >
-  void WaveformReader::readInterleavedConvertAndSeparate(
-    TSample *targets[], std::uint64_t startFrame, std::size_t frameCount
-  ) {
-  }
-
-  // ------------------------------------------------------------------------------------------- //
-
 }}}} // namespace Nuclex::Audio::Storage::Waveform
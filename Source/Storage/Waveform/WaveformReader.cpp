@@ -22,18 +22,21 @@ limitations under the License.
 
 #include "./WaveformReader.h"
 
+#include "Nuclex/Audio/AllocationScope.h"
 #include "Nuclex/Audio/Errors/CorruptedFileError.h"
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 #include "Nuclex/Audio/ContainerInfo.h"
 #include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h" // for ConversionKernels
 
 #include "../Shared/ChannelOrderFactory.h"
+#include "../Shared/DecodePathBuilder.h"
 
 #include "./WaveformParser.h"
 #include "./WaveformDetection.h"
 
 #include <array> // for std::array, used a 'Guid'
-#include <algorithm> // for std::copy_n()
+#include <algorithm> // for std::copy_n(), std::min()
 #include <cassert> // for assert()
 
 namespace {
@@ -52,6 +55,16 @@ namespace {
   /// </remarks>
   constexpr std::size_t OptimistcInitialByteCount = 60;
 
+  /// <summary>Length of a 'smpl' chunk's fixed fields and its first loop</summary>
+  constexpr std::size_t SampleChunkWithLoopLengthWithHeader = 68;
+
+  /// <summary>Largest 'cue ' chunk or 'adtl' list that will be read for markers</summary>
+  /// <remarks>
+  ///   Enough for tens of thousands of cue points. Anything bigger is more likely
+  ///   a corrupted length field than an actual marker list and will be skipped.
+  /// </remarks>
+  constexpr std::size_t MaximumMarkerChunkLength = 1048576;
+
   /// <summary>Length of the (ancient) legacy WAVEFORMAT chunk</summary>
   constexpr std::size_t WaveFormatChunkLengthWithHeader = 22;
 
@@ -65,6 +78,9 @@ namespace {
   /// </remarks>
   constexpr std::size_t WaveFormatExtensibleChunkLengthWithHeader = 48;
 
+  /// <summary>Length of the RF64 'ds64' chunk without its optional size table</summary>
+  constexpr std::size_t Ds64ChunkLengthWithHeader = 36;
+
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>FourCCs used in Waveform files</summary>
@@ -79,7 +95,9 @@ namespace {
     /// <summary>FFIR header, big endian Waveform file with identical structure</summary>
     Ffir = 3,
     /// <summary>XFIR header, little endian Waveform file with identical structure</summary>
-    Xfir = 4
+    Xfir = 4,
+    /// <summary>RF64 or BW64 header, little endian Waveform file with 64-bit sizes</summary>
+    Rf64 = 5
 
   };
 
@@ -113,6 +131,15 @@ namespace {
       (fileHeader[3] == std::byte(0x52))
     ) {
       return FourCC::Xfir;
+    } else if(
+      (
+        ((fileHeader[0] == std::byte(0x52)) && (fileHeader[1] == std::byte(0x46))) ||
+        ((fileHeader[0] == std::byte(0x42)) && (fileHeader[1] == std::byte(0x57)))
+      ) &&
+      (fileHeader[2] == std::byte(0x36)) &&
+      (fileHeader[3] == std::byte(0x34))
+    ) {
+      return FourCC::Rf64; // "RF64" from EBU Tech 3306 or "BW64" from ITU-R BS.2088
     }
 
     return FourCC::Other;
@@ -171,13 +198,15 @@ namespace {
     // and the length field itself). It's probably not a good idea to require it to match
     // the precise, actual file size because some tool might have appended tagging information
     // or the file could be truncated, so we just use it to ignore any data trailing the file.
+    // RF64 files put 0xFFFFFFFF here and store the actual size in their 'ds64' chunk.
+    std::uint32_t recordedRiffSize = TReader::ReadUInt32(buffer + 4);
     {
-      std::uint32_t expectedFileSize = TReader::ReadUInt32(buffer + 4);
       //if(expectedFileSize >= 0x8000000) { // Waveform files are limited to 2 GiB. Or not?
       //  return std::optional<Nuclex::Audio::ContainerInfo>();
       //}
-      if(static_cast<std::uint64_t>(expectedFileSize) + 8 < fileSize) {
-        fileSize = static_cast<std::uint64_t>(expectedFileSize) + 8;
+      std::uint64_t expectedFileSize = static_cast<std::uint64_t>(recordedRiffSize) + 8;
+      if((recordedRiffSize != 0xFFFFFFFFu) && (expectedFileSize < fileSize)) {
+        fileSize = expectedFileSize;
       }
     }
 
@@ -209,6 +238,7 @@ namespace {
     for(;;) {
       std::uint32_t chunkLength = TReader::ReadUInt32(buffer + 4);
       std::size_t chunkLengthWithHeader = chunkLength + 8;
+      std::uint64_t skippedByteCount = static_cast<std::uint64_t>(chunkLength) + 8;
 
       // For the 'fmt ' chunk, we require the entire chunk to be present, up to the length
       // of its WaveFormatExtensible variant (which is the maximum length we'll ever read)
@@ -229,16 +259,65 @@ namespace {
           std::string_view(u8"'fact' (extra meatdata) chunk", 29)
         );
         parser.ParseFactChunk<TReader>(buffer);
+      } else if(WaveformParser::IsSampleChunk(buffer)) {
+
+        // The loop we're after doesn't fit into the buffer, so fetch it separately.
+        // Sampler chunks without loops carry nothing of interest and are skipped.
+        bool hasLoop = (
+          (chunkLengthWithHeader >= SampleChunkWithLoopLengthWithHeader) &&
+          (readOffset + SampleChunkWithLoopLengthWithHeader <= fileSize)
+        );
+        if(hasLoop) {
+          std::byte sampleChunk[SampleChunkWithLoopLengthWithHeader];
+          source->ReadAt(readOffset, SampleChunkWithLoopLengthWithHeader, sampleChunk);
+          parser.ParseSampleChunk<TReader>(sampleChunk);
+        }
+      } else if(
+        WaveformParser::IsCueChunk(buffer) || WaveformParser::IsAssociatedDataList(buffer)
+      ) {
+
+        // Marker chunks vary in length, so they're fetched in one piece. Chunks that
+        // don't fit into the file or are implausibly long are skipped.
+        bool isReadable = (
+          (chunkLength <= MaximumMarkerChunkLength) &&
+          (readOffset + chunkLengthWithHeader <= fileSize)
+        );
+        if(isReadable) {
+          bool isCueChunk = WaveformParser::IsCueChunk(buffer);
+
+          std::vector<std::byte> markerChunk(chunkLengthWithHeader);
+          source->ReadAt(readOffset, chunkLengthWithHeader, markerChunk.data());
+          if(isCueChunk) {
+            parser.ParseCueChunk<TReader>(markerChunk.data(), chunkLength);
+          } else {
+            parser.ParseAssociatedDataList<TReader>(markerChunk.data(), chunkLength);
+          }
+        }
+      } else if(WaveformParser::IsDs64Chunk(buffer)) {
+        if(Ds64ChunkLengthWithHeader < chunkLengthWithHeader) {
+          chunkLengthWithHeader = Ds64ChunkLengthWithHeader; // ignore the size table
+        }
+        requireChunkLength(
+          chunkLengthWithHeader, Ds64ChunkLengthWithHeader, readByteCount,
+          std::string_view(u8"'ds64' (64-bit sizes) chunk", 27)
+        );
+        parser.ParseDs64Chunk(buffer);
+
+        std::uint64_t expectedFileSize = parser.ResolveRiffSize(recordedRiffSize) + 8;
+        if(expectedFileSize < fileSize) {
+          fileSize = expectedFileSize;
+        }
       } else if(WaveformParser::IsDataChunk(buffer)) {
+        skippedByteCount = parser.ResolveDataChunkLength(chunkLength) + 8;
         parser.SetDataChunkStart(
-          readOffset, std::min<std::uint64_t>(chunkLengthWithHeader, fileSize - readOffset)
+          readOffset, std::min<std::uint64_t>(skippedByteCount, fileSize - readOffset)
         );
       }
 
       // Skip to the next chunk. Chunks are 16-bit aligned, but this alignment is not recorded
       // in the chunk length field inside the chunk itself. Thus, if the chunk length is
       // an odd number of bytes, it will be padded with a zero byte, requiring adjustment.
-      readOffset += chunkLengthWithHeader + (chunkLength & 1);
+      readOffset += skippedByteCount + (skippedByteCount & 1);
       if(fileSize < readOffset + WaveFormatChunkLengthWithHeader) {
         break; // File would end before a (complete) 'fmt ' chunk can arrive
       }
@@ -258,6 +337,55 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Walks through the chunks of a Waveform file, parsing the relevant ones</summary>
+  /// <param name="parser">Parser used to decode the Waveform file structure</param>
+  /// <param name="source">File from which the data will be read</param>
+  /// <param name="fileSize">Size of the input file in bytes</param>
+  /// <param name="isLittleEndian">Receives whether the file is little endian</param>
+  /// <returns>True if the file was a Waveform file, false otherwise</returns>
+  /// <remarks>
+  ///   Only the RIFF header, the header of each chunk and the chunks that are parsed get
+  ///   read, everything else is skipped by offset. DAWs like to put multi-megabyte LIST,
+  ///   iXML or _PMX chunks into their files and opening those should not involve
+  ///   reading them. The header is read into a stack buffer that is reused for
+  ///   each chunk header, so a file with few chunks is opened with a few small reads.
+  /// </remarks>
+  bool walkChunks(
+    Nuclex::Audio::Storage::Waveform::WaveformParser &parser,
+    const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &source,
+    std::uint64_t fileSize,
+    bool &isLittleEndian
+  ) {
+    using Nuclex::Audio::Storage::LittleEndianReader;
+    using Nuclex::Audio::Storage::BigEndianReader;
+
+    // Calculate the number of bytes for the initial read in which we will check
+    // the FourCC and RIFF / Waveform header before going on the hunt for sub-chunks.
+    std::size_t readByteCount;
+    if(fileSize < OptimistcInitialByteCount) {
+      readByteCount = static_cast<std::size_t>(fileSize);
+    } else {
+      readByteCount = OptimistcInitialByteCount;
+    }
+
+    std::byte buffer[OptimistcInitialByteCount];
+    source->ReadAt(0, readByteCount, buffer);
+
+    // Figure out what kind of file we're dealing with
+    FourCC fourCC = checkFourCC(buffer);
+    if((fourCC == FourCC::Riff) || (fourCC == FourCC::Xfir) || (fourCC == FourCC::Rf64)) {
+      isLittleEndian = true;
+      return scanChunks<LittleEndianReader>(parser, source, fileSize, buffer, readByteCount);
+    } else if((fourCC == FourCC::Rifx) || (fourCC == FourCC::Ffir)) {
+      isLittleEndian = false;
+      return scanChunks<BigEndianReader>(parser, source, fileSize, buffer, readByteCount);
+    } else {
+      return false; // unknown FourCC tag means it's not a Waveform file
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
@@ -285,33 +413,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
           return std::optional<ContainerInfo>(); // This cannot be a Waveform file
         }
 
-        // Calculate the number of bytes for the initial read in which we will check
-        // the FourCC and RIFF / Waveform header before going on the hunt for sub-chunks.
-        std::size_t readByteCount;
-        if(fileSize < OptimistcInitialByteCount) {
-          readByteCount = static_cast<std::size_t>(fileSize);
-        } else {
-          readByteCount = OptimistcInitialByteCount;
-        }
-
-        std::vector<std::byte> buffer(readByteCount);
-        source->ReadAt(0, readByteCount, buffer.data());
-
-        // Figure out what kind of file we're dealing with
-        FourCC fourCC = checkFourCC(buffer.data());
-        if((fourCC == FourCC::Riff) || (fourCC == FourCC::Xfir)) {
-          isWaveform = scanChunks<LittleEndianReader>(
-            parser, source, fileSize, buffer.data(), readByteCount
-          );
-        } else if((fourCC == FourCC::Rifx) || (fourCC == FourCC::Ffir)) {
-          isWaveform = scanChunks<BigEndianReader>(
-            parser, source, fileSize, buffer.data(), readByteCount
-          );
-        } else {
-          isWaveform = false; // unknown FourCC tag means it's not a Waveform file
-        }
+        bool isLittleEndian;
+        isWaveform = walkChunks(parser, source, fileSize, isLittleEndian);
 
-      } // chunk buffer and virtual file access scope
+      } // virtual file access scope
 
       // If the file, upon reading, didn't look like a Waveform file after all,
       // just return an empty result (because this is not an error).
@@ -339,7 +444,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   WaveformReader::WaveformReader(const std::shared_ptr<const VirtualFile> &source) :
     file(source),
+    formatName(u8"Waveform"),
     isLittleEndian(true),
+    areBytesSigned(false),
     trackInfo(),
     firstSampleOffset(std::uint64_t(-1)),
     totalFrameCount(0),
@@ -370,35 +477,9 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
         throw Errors::UnsupportedFormatError(u8"File too small to be a Waveform audio file");
       }
 
-      // Calculate the number of bytes for the initial read in which we will check
-      // the FourCC and RIFF / Waveform header before going on the hunt for sub-chunks.
-      std::size_t readByteCount;
-      if(fileSize < OptimistcInitialByteCount) {
-        readByteCount = static_cast<std::size_t>(fileSize);
-      } else {
-        readByteCount = OptimistcInitialByteCount;
-      }
+      isWaveform = walkChunks(parser, source, fileSize, this->isLittleEndian);
 
-      std::vector<std::byte> buffer(readByteCount);
-      source->ReadAt(0, readByteCount, buffer.data());
-
-      // Figure out what kind of file we're dealing with
-      FourCC fourCC = checkFourCC(buffer.data());
-      if((fourCC == FourCC::Riff) || (fourCC == FourCC::Xfir)) {
-        this->isLittleEndian = true;
-        isWaveform = scanChunks<LittleEndianReader>(
-          parser, source, fileSize, buffer.data(), readByteCount
-        );
-      } else if((fourCC == FourCC::Rifx) || (fourCC == FourCC::Ffir)) {
-        this->isLittleEndian = false;
-        isWaveform = scanChunks<BigEndianReader>(
-          parser, source, fileSize, buffer.data(), readByteCount
-        );
-      } else {
-        isWaveform = false; // unknown FourCC tag means it's not a Waveform file
-      }
-
-    } // chunk buffer and virtual file access scope
+    } // virtual file access scope
 
     // If the FourCC didn't match or the internal headers weren't for a Waveform file
     // (after all 'RIFF' files are used for .avi and other formats, too), fail hard.
@@ -415,11 +496,36 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  WaveformReader::WaveformReader(
+    const std::shared_ptr<const VirtualFile> &source, const StoredSampleLayout &layout
+  ) :
+    file(source),
+    formatName(layout.FormatName),
+    isLittleEndian(layout.IsLittleEndian),
+    areBytesSigned(layout.AreBytesSigned),
+    trackInfo(layout.Track),
+    firstSampleOffset(layout.FirstSampleOffset),
+    totalFrameCount(layout.FrameCount),
+    bytesPerFrame(layout.BytesPerFrame),
+    readInterleavedUint8(),
+    readInterleavedInt16(),
+    readInterleavedInt32(),
+    readInterleavedFloat(),
+    readInterleavedDouble(),
+    readSeparatedUint8(),
+    readSeparatedInt16(),
+    readSeparatedInt32(),
+    readSeparatedFloat(),
+    readSeparatedDouble() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
   WaveformReader::~WaveformReader() {}
 
   // ------------------------------------------------------------------------------------------- //
 
   void WaveformReader::ReadMetadata(TrackInfo &target) {
+    AllocationScope metadataScope(AllocationSubsystem::TrackMetadata);
     target = this->trackInfo;
   }
 
@@ -431,6 +537,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t WaveformReader::CountBytesPerFrame() const {
+    return this->bytesPerFrame;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::vector<ChannelPlacement> WaveformReader::GetChannelOrder() const {
     return Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
       this->trackInfo.ChannelCount, this->trackInfo.ChannelPlacements
@@ -440,6 +552,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   // ------------------------------------------------------------------------------------------- //
 
   void WaveformReader::PrepareForReading() {
+    bool isFloatFormat = (
+      (this->trackInfo.SampleFormat == AudioSampleFormat::Float_32) ||
+      (this->trackInfo.SampleFormat == AudioSampleFormat::Float_64)
+    );
+
+    // Integer samples are unpacked from containers of 1 to 4 bytes which must have
+    // room for all bits of the sample. Anything else we wouldn't know how to read.
+    if(!isFloatFormat) {
+      std::size_t bytesPerSample = this->bytesPerFrame / this->trackInfo.ChannelCount;
+      bool isSupportedContainer = (
+        (bytesPerSample >= 1) && (bytesPerSample <= 4) &&
+        (this->trackInfo.BitsPerSample >= 1) &&
+        (this->trackInfo.BitsPerSample <= bytesPerSample * 8)
+      );
+      if(unlikely(!isSupportedContainer)) {
+        throw Errors::UnsupportedFormatError(
+          u8"Waveform audio file stores integer samples in an unsupported container size"
+        );
+      }
+    }
+
     if(this->trackInfo.SampleFormat == AudioSampleFormat::Float_64) {
       this->readInterleavedUint8 = (
         &WaveformReader::readInterleavedAndConvert<std::uint8_t, false, -2>
@@ -584,7 +717,131 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       this->readSeparatedDouble = (
         &WaveformReader::readInterleavedConvertAndSeparate<double, false, -1>
       );
+    } else if(this->trackInfo.BitsPerSample > 16) { // Floats can't hold these precisely
+      this->readInterleavedFloat = (
+        &WaveformReader::readInterleavedAndConvert<float, true, 0>
+      );
+      this->readSeparatedFloat = (
+        &WaveformReader::readInterleavedConvertAndSeparate<float, true, 0>
+      );
+      this->readInterleavedDouble = (
+        &WaveformReader::readInterleavedAndConvert<double, true, 0>
+      );
+      this->readSeparatedDouble = (
+        &WaveformReader::readInterleavedConvertAndSeparate<double, true, 0>
+      );
+    } else {
+      this->readInterleavedFloat = (
+        &WaveformReader::readInterleavedAndConvert<float, false, 0>
+      );
+      this->readSeparatedFloat = (
+        &WaveformReader::readInterleavedConvertAndSeparate<float, false, 0>
+      );
+      this->readInterleavedDouble = (
+        &WaveformReader::readInterleavedAndConvert<double, false, 0>
+      );
+      this->readSeparatedDouble = (
+        &WaveformReader::readInterleavedConvertAndSeparate<double, false, 0>
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath WaveformReader::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    using Shared::DecodePathBuilder;
+
+    sampleFormat = DecodePathBuilder::GetDeliveredFormat(sampleFormat);
+    AudioSampleFormat storedFormat = this->trackInfo.SampleFormat;
+    bool storedSamplesAreFloat = DecodePathBuilder::IsFloatingPoint(storedFormat);
+    bool targetTypeIsFloat = DecodePathBuilder::IsFloatingPoint(sampleFormat);
+    std::string inlineKernelSet = DecodePathBuilder::GetInlineKernelSetName();
+
+    DecodePathBuilder builder(
+      this->formatName, storedFormat, this->isLittleEndian ? u8"little-endian" : u8"big-endian"
+    );
+
+    // Same check as in the reading methods, only done for the first frame
+    std::size_t storedSampleAlignment = (
+      (storedFormat == AudioSampleFormat::Float_64) ? alignof(double) :
+      storedSamplesAreFloat ? alignof(float) : 1
+    );
+    const std::byte *borrowedData = this->file->TryBorrowAt(
+      this->firstSampleOffset, this->bytesPerFrame
+    );
+    bool isBorrowed = (
+      (borrowedData != nullptr) &&
+      (reinterpret_cast<std::uintptr_t>(borrowedData) % storedSampleAlignment == 0)
+    );
+
+    bool usesReadBuffer = !isBorrowed;
+    if(isBorrowed) {
+      builder.SetZeroCopy();
+    } else {
+      builder.AddScratchBuffer().AddPass(u8"read");
     }
+
+    if(storedSamplesAreFloat) {
+      bool isSameType = (sampleFormat == storedFormat);
+
+      // Interleaved floats in the stored format are swapped straight into the target,
+      // everything else is swapped into the read buffer and processed from there
+      if(!this->isLittleEndian) {
+        if(!usesReadBuffer && !(interleaved && isSameType)) {
+          builder.AddScratchBuffer();
+        }
+        builder.AddPass(u8"Byte swap");
+        if(interleaved && isSameType) {
+          return builder.GetPath();
+        }
+      }
+
+      if(interleaved) {
+        if(isSameType) {
+          builder.AddPass(u8"copy");
+        } else if(targetTypeIsFloat) {
+          builder.AddPass(u8"cast");
+        } else {
+          builder.AddPass(u8"Quantize " + inlineKernelSet);
+        }
+      } else if(isSameType) {
+        builder.AddPass(u8"Deinterleave " + inlineKernelSet);
+      } else if(targetTypeIsFloat) {
+        builder.AddPass(u8"cast").AddFusedStep(u8"separate");
+      } else {
+        builder.AddPass(u8"Quantize").AddFusedStep(u8"separate");
+      }
+    } else { // if stored samples are ^^ float ^^ / vv int vv
+      std::size_t bytesPerSample = this->bytesPerFrame / this->trackInfo.ChannelCount;
+      std::size_t targetBitCount = static_cast<std::size_t>(sampleFormat); // for integers
+
+      if(targetTypeIsFloat && (bytesPerSample == 3)) {
+        builder.AddPass(u8"Unpack int24 to float");
+      } else {
+        builder.AddScratchBuffer().AddPass(u8"unpack");
+        if(targetTypeIsFloat) {
+          builder.AddPass(
+            std::string(u8"Reconstruct ") +
+            Processing::ConversionKernels::GetActiveKernelSetName()
+          );
+        } else if(targetBitCount > this->trackInfo.BitsPerSample) {
+          builder.AddPass(u8"Extend bits");
+        } else if(targetBitCount < this->trackInfo.BitsPerSample) {
+          builder.AddPass(u8"Truncate bits");
+        } else {
+          builder.AddPass(u8"copy");
+        }
+      }
+
+      // Separated integer samples are converted interleaved, then separated in batches
+      if(!interleaved) {
+        builder.AddScratchBuffer().AddPass(u8"Deinterleave " + inlineKernelSet);
+      }
+    } // if stored samples are float / int
+
+    return builder.GetPath();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -22,6 +22,8 @@ limitations under the License.
 
 #include "Nuclex/Audio/Config.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+#include "Nuclex/Audio/Storage/DecodePath.h"
 
 #include "../EndianReader.h" // for LittleEndianReader / BigEndianReader
 
@@ -53,6 +55,33 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Describes where and how the samples of an uncompressed audio file are stored</summary>
+  /// <remarks>
+  ///   Other uncompressed formats such as AIFF only differ from Waveform files in their
+  ///   headers. Their readers parse the headers into this description and then let
+  ///   the <see cref="WaveformReader" /> read and convert the samples.
+  /// </remarks>
+  struct StoredSampleLayout {
+
+    /// <summary>Name of the file format reported in decode path explanations</summary>
+    public: const char *FormatName;
+    /// <summary>Metadata of the audio track, including the stored sample format</summary>
+    public: TrackInfo Track;
+    /// <summary>Whether integer and floating point samples are stored little endian</summary>
+    public: bool IsLittleEndian;
+    /// <summary>Whether 8-bit samples are signed instead of offset by 128</summary>
+    public: bool AreBytesSigned;
+    /// <summary>Offset of the first audio sample in the file</summary>
+    public: std::uint64_t FirstSampleOffset;
+    /// <summary>Total number of audio frames in the file</summary>
+    public: std::uint64_t FrameCount;
+    /// <summary>Number of bytes consumed per audio frame</summary>
+    public: std::size_t BytesPerFrame;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Utility to read the data structures found in Waveform files</summary>
   class WaveformReader {
 
@@ -74,6 +103,13 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// <param name="source">File the reader will access</param>
     public: WaveformReader(const std::shared_ptr<const VirtualFile> &source);
 
+    /// <summary>Initializes a new reader for samples whose layout is already known</summary>
+    /// <param name="source">File the reader will access</param>
+    /// <param name="layout">Description of the stored samples parsed from the headers</param>
+    public: WaveformReader(
+      const std::shared_ptr<const VirtualFile> &source, const StoredSampleLayout &layout
+    );
+
     /// <summary>Frees all resources owned by the Opus reader</summary>
     public: ~WaveformReader();
 
@@ -85,6 +121,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// <returns>The total number of frames in the audio file</returns>
     public: std::uint64_t CountTotalFrames() const;
 
+    /// <summary>Counts the number of bytes each frame occupies in the file</summary>
+    /// <returns>The size of a single audio frame in bytes</returns>
+    public: std::size_t CountBytesPerFrame() const;
+
     /// <summary>Gets the order in which interlaved samples are decoded</summary>
     /// <returns>A list of channels in the order they are interleaved</returns>
     public: std::vector<ChannelPlacement> GetChannelOrder() const;
@@ -98,6 +138,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// </remarks>
     public: void PrepareForReading();
 
+    /// <summary>Describes how samples would be read in the specified format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps the reading methods would go through</returns>
+    public: DecodePath ExplainDecodePath(AudioSampleFormat sampleFormat, bool interleaved) const;
+
     /// <summary>Reads samples from the audio file in interleaved format</summary>
     /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
     /// <param name="target">Buffer into which the samples will be written</param>
@@ -170,8 +216,12 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
     /// <summary>File the reader is accessing</summary>
     private: std::shared_ptr<const VirtualFile> file;
+    /// <summary>Name of the file format reported in decode path explanations</summary>
+    private: const char *formatName;
     /// <summary>Whether the file's data is in little endian format</summary>
     private: bool isLittleEndian;
+    /// <summary>Whether 8-bit samples are signed instead of offset by 128</summary>
+    private: bool areBytesSigned;
     /// <summary>Collected metadata on the opened audio file</summary>
     private: TrackInfo trackInfo;
     /// <summary>Offset of the first audio sample in the file</summary>
@@ -180,6 +230,10 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     private: std::uint64_t totalFrameCount;
     /// <summary>Number of bytes consumed per audio frame</summary>
     private: std::size_t bytesPerFrame;
+    /// <summary>Receives stored samples the file can't hand out directly</summary>
+    private: SampleVector<std::byte> readBuffer;
+    /// <summary>Holds converted frames while they are being separated into channels</summary>
+    private: SampleVector<std::byte> separationBuffer;
 
     /// <summary>Signature for the interleaved decode method</summary>
     private: template<typename TSample>
@@ -0,0 +1,380 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WaveformSequentialDecoder.h"
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Storage/SequentialSource.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h" // for ConversionKernels
+#include "Nuclex/Audio/Processing/Int24Packing.h" // for Int24Packing
+
+#include "../Shared/ChannelOrderFactory.h"
+#include "./WaveformParser.h"
+
+#include <algorithm> // for std::copy(), std::copy_n(), std::min()
+#include <cstring> // for std::memcpy()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of frames delivered by a single decode call</summary>
+  constexpr std::size_t ChunkFrameCount = 4096;
+
+  /// <summary>Number of integer samples that are unpacked in one batch</summary>
+  constexpr std::size_t UnpackedSampleCount = 256;
+
+  /// <summary>Length of the WAVEFORMATEXTENSIBLE chunk, the longest 'fmt ' chunk we read</summary>
+  constexpr std::size_t WaveFormatExtensibleChunkLength = 40;
+
+  /// <summary>Length of the plain WAVEFORMAT chunk, the shortest valid 'fmt ' chunk</summary>
+  constexpr std::size_t WaveFormatChunkLength = 14;
+
+  /// <summary>Length of the 'ds64' chunk without the size table that may follow</summary>
+  constexpr std::size_t Ds64ChunkLength = 28;
+
+  /// <summary>Size that streaming writers record for chunks of unknown length</summary>
+  constexpr std::uint32_t OpenChunkLength = 0xFFFFFFFFu;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a buffer begins with the specified FourCC</summary>
+  /// <param name="buffer">Buffer that will be checked</param>
+  /// <param name="fourCC">FourCC the buffer should begin with</param>
+  /// <returns>True if the buffer began with the FourCC</returns>
+  bool isFourCC(const std::byte *buffer, const char (&fourCC)[5]) {
+    return (
+      (buffer[0] == static_cast<std::byte>(fourCC[0])) &&
+      (buffer[1] == static_cast<std::byte>(fourCC[1])) &&
+      (buffer[2] == static_cast<std::byte>(fourCC[2])) &&
+      (buffer[3] == static_cast<std::byte>(fourCC[3]))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks little endian integer samples into 32-bit integers</summary>
+  /// <param name="data">Samples as they are stored in the file</param>
+  /// <param name="bytesPerSample">Number of bytes (1, 2 or 4) in each sample</param>
+  /// <param name="results">Receives the unpacked samples</param>
+  /// <param name="count">Number of samples that will be unpacked</param>
+  void unpackIntegerSamples(
+    const std::byte *data, std::size_t bytesPerSample, std::int32_t *results, std::size_t count
+  ) {
+    if(bytesPerSample == 1) { // 8-bit Waveform samples are unsigned
+      for(std::size_t index = 0; index < count; ++index) {
+        results[index] = static_cast<std::int32_t>(data[index]) - 128;
+      }
+    } else if(bytesPerSample == 2) {
+      for(std::size_t index = 0; index < count; ++index) {
+        results[index] = static_cast<std::int16_t>(
+          static_cast<std::uint16_t>(data[0]) | (static_cast<std::uint16_t>(data[1]) << 8)
+        );
+        data += 2;
+      }
+    } else {
+      for(std::size_t index = 0; index < count; ++index) {
+        results[index] = static_cast<std::int32_t>(
+          (static_cast<std::uint32_t>(data[0])) |
+          (static_cast<std::uint32_t>(data[1]) << 8) |
+          (static_cast<std::uint32_t>(data[2]) << 16) |
+          (static_cast<std::uint32_t>(data[3]) << 24)
+        );
+        data += 4;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WaveformSequentialDecoder::WaveformSequentialDecoder(
+    const std::shared_ptr<SequentialSource> &source
+  ) :
+    source(source),
+    trackInfo(),
+    channelOrder(),
+    totalFrameCount(),
+    bytesPerFrame(0),
+    bytesPerSample(0),
+    shift(0),
+    cursor(0),
+    position(0),
+    readBuffer(),
+    partialByteCount(0) {
+    parseHeaders();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WaveformSequentialDecoder::~WaveformSequentialDecoder() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WaveformSequentialDecoder::DecodeInterleaved(
+    float *buffer, std::size_t frameCount
+  ) {
+    if(this->totalFrameCount.has_value()) {
+      std::uint64_t remainingFrameCount = this->totalFrameCount.value() - this->cursor;
+      if(remainingFrameCount < frameCount) {
+        frameCount = static_cast<std::size_t>(remainingFrameCount);
+      }
+    }
+    if(frameCount == 0) {
+      return 0;
+    }
+    if(ChunkFrameCount < frameCount) {
+      frameCount = ChunkFrameCount;
+    }
+
+    // The read buffer may still hold the beginning of a frame from the previous call,
+    // it stays at the front and the source delivers the remaining bytes behind it.
+    std::size_t requiredByteCount = frameCount * this->bytesPerFrame;
+    if(this->readBuffer.size() < requiredByteCount) {
+      this->readBuffer.resize(requiredByteCount);
+    }
+
+    for(;;) {
+      std::size_t readByteCount = this->source->ReadSome(
+        this->readBuffer.data() + this->partialByteCount,
+        requiredByteCount - this->partialByteCount
+      );
+      if(readByteCount == 0) {
+        if(this->totalFrameCount.has_value()) {
+          throw Errors::CorruptedFileError(
+            u8"Waveform audio stream ended before all of its audio data was delivered"
+          );
+        }
+
+        this->partialByteCount = 0; // An incomplete last frame can't be played
+        return 0;
+      }
+
+      std::size_t availableByteCount = this->partialByteCount + readByteCount;
+      std::size_t completeFrameCount = availableByteCount / this->bytesPerFrame;
+      if(completeFrameCount == 0) {
+        this->partialByteCount = availableByteCount;
+        continue;
+      }
+
+      convert(this->readBuffer.data(), buffer, completeFrameCount);
+
+      std::size_t consumedByteCount = completeFrameCount * this->bytesPerFrame;
+      std::copy(
+        this->readBuffer.data() + consumedByteCount,
+        this->readBuffer.data() + availableByteCount,
+        this->readBuffer.data()
+      );
+      this->partialByteCount = availableByteCount - consumedByteCount;
+      this->cursor += completeFrameCount;
+
+      return completeFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformSequentialDecoder::parseHeaders() {
+    WaveformParser parser(this->trackInfo);
+
+    std::byte header[12];
+    readExactly(header, 12);
+
+    // Only little endian files can be parsed here, the rare big endian variants would need
+    // their samples byte-swapped and nobody streams those anyway.
+    bool isLittleEndian = (
+      isFourCC(header, "RIFF") || isFourCC(header, "RF64") || isFourCC(header, "BW64")
+    );
+    if(!isLittleEndian || !isFourCC(header + 8, "WAVE")) {
+      throw Errors::UnsupportedFormatError(
+        u8"Stream is not a little endian Waveform audio file"
+      );
+    }
+    std::uint32_t recordedRiffSize = LittleEndianReader::ReadUInt32(header + 4);
+
+    // Walk through the chunks in the order they arrive until the 'data' chunk begins.
+    // We can't go back, so the format has to be known by the time the audio data starts.
+    bool isFormatChunkParsed = false;
+    std::uint64_t dataChunkLength = 0;
+    bool isDataChunkOpen = false;
+    for(;;) {
+      std::uint64_t chunkStart = this->position;
+
+      std::byte chunk[8 + WaveFormatExtensibleChunkLength];
+      readExactly(chunk, 8);
+      std::uint32_t chunkLength = LittleEndianReader::ReadUInt32(chunk + 4);
+      std::uint64_t paddedChunkLength = (
+        static_cast<std::uint64_t>(chunkLength) + (chunkLength & 1)
+      );
+
+      if(WaveformParser::IsFormatChunk(chunk)) {
+        if(chunkLength < WaveFormatChunkLength) {
+          throw Errors::CorruptedFileError(
+            u8"Waveform audio file contains too short 'fmt ' (metadata) chunk"
+          );
+        }
+        std::size_t readByteCount = std::min<std::size_t>(
+          chunkLength, WaveFormatExtensibleChunkLength
+        );
+        readExactly(chunk + 8, readByteCount);
+        parser.ParseFormatChunk<LittleEndianReader>(chunk, chunkLength);
+        isFormatChunkParsed = true;
+        skip(paddedChunkLength - readByteCount);
+      } else if(WaveformParser::IsFactChunk(chunk) && (chunkLength >= 4)) {
+        readExactly(chunk + 8, 4);
+        parser.ParseFactChunk<LittleEndianReader>(chunk);
+        skip(paddedChunkLength - 4);
+      } else if(WaveformParser::IsDs64Chunk(chunk) && (chunkLength >= Ds64ChunkLength)) {
+        readExactly(chunk + 8, Ds64ChunkLength);
+        parser.ParseDs64Chunk(chunk);
+        skip(paddedChunkLength - Ds64ChunkLength);
+      } else if(WaveformParser::IsDataChunk(chunk)) {
+        if(!isFormatChunkParsed) {
+          throw Errors::CorruptedFileError(
+            u8"Waveform audio stream has its audio data before the 'fmt ' (metadata) chunk"
+          );
+        }
+
+        // Streaming writers can't go back to fill in the lengths, so they leave them open
+        // (0xFFFFFFFF) or, in some cases, put zero into both the RIFF and the data length.
+        dataChunkLength = parser.ResolveDataChunkLength(chunkLength);
+        bool isRiffOpen = (
+          (parser.ResolveRiffSize(recordedRiffSize) == 0) ||
+          (parser.ResolveRiffSize(recordedRiffSize) == OpenChunkLength)
+        );
+        isDataChunkOpen = (
+          (dataChunkLength == OpenChunkLength) || ((dataChunkLength == 0) && isRiffOpen)
+        );
+        parser.SetDataChunkStart(chunkStart, isDataChunkOpen ? 8 : dataChunkLength + 8);
+        break;
+      } else {
+        skip(paddedChunkLength);
+      }
+    }
+
+    this->channelOrder = Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
+      this->trackInfo.ChannelCount, this->trackInfo.ChannelPlacements
+    );
+    this->bytesPerFrame = parser.CountBytesPerFrame();
+    this->bytesPerSample = this->bytesPerFrame / this->trackInfo.ChannelCount;
+
+    bool isFloat = (
+      (this->trackInfo.SampleFormat == AudioSampleFormat::Float_32) ||
+      (this->trackInfo.SampleFormat == AudioSampleFormat::Float_64)
+    );
+    bool isSupportedSampleSize = isFloat ? (
+      (this->bytesPerSample == 4) || (this->bytesPerSample == 8)
+    ) : (
+      (this->bytesPerSample >= 1) && (this->bytesPerSample <= 4) &&
+      (this->trackInfo.BitsPerSample <= this->bytesPerSample * 8)
+    );
+    if(!isSupportedSampleSize) {
+      throw Errors::UnsupportedFormatError(
+        u8"Waveform audio stream uses an unsupported sample size"
+      );
+    }
+    this->shift = static_cast<int>(this->bytesPerSample * 8 - this->trackInfo.BitsPerSample);
+
+    if(!isDataChunkOpen) {
+      this->totalFrameCount = dataChunkLength / this->bytesPerFrame;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformSequentialDecoder::readExactly(std::byte *buffer, std::size_t byteCount) {
+    std::size_t readByteCount = this->source->ReadFully(buffer, byteCount);
+    this->position += readByteCount;
+
+    if(readByteCount < byteCount) {
+      throw Errors::CorruptedFileError(
+        u8"Waveform audio stream ended before its audio data began"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformSequentialDecoder::skip(std::uint64_t byteCount) {
+    std::byte discarded[256];
+    while(byteCount > 0) {
+      std::size_t skippedByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(byteCount, sizeof(discarded))
+      );
+      readExactly(discarded, skippedByteCount);
+      byteCount -= skippedByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformSequentialDecoder::convert(
+    const std::byte *source, float *target, std::size_t frameCount
+  ) {
+    std::size_t sampleCount = frameCount * this->trackInfo.ChannelCount;
+
+    if(this->trackInfo.SampleFormat == AudioSampleFormat::Float_32) {
+      std::memcpy(target, source, sampleCount * sizeof(float));
+    } else if(this->trackInfo.SampleFormat == AudioSampleFormat::Float_64) {
+      for(std::size_t index = 0; index < sampleCount; ++index) {
+        double sample;
+        std::memcpy(&sample, source + index * sizeof(double), sizeof(double));
+        target[index] = static_cast<float>(sample);
+      }
+    } else if(this->bytesPerSample == 3) {
+      double limit = static_cast<double>(
+        (std::uint32_t(1) << (this->trackInfo.BitsPerSample - 1)) - 1
+      );
+      Processing::Int24Packing::UnpackToFloat(source, this->shift, limit, target, sampleCount);
+    } else {
+      std::uint32_t limit = (std::uint32_t(1) << (this->trackInfo.BitsPerSample - 1)) - 1;
+
+      std::int32_t unpacked[UnpackedSampleCount];
+      while(0 < sampleCount) {
+        std::size_t batchSampleCount = std::min(sampleCount, UnpackedSampleCount);
+        unpackIntegerSamples(source, this->bytesPerSample, unpacked, batchSampleCount);
+        if(this->trackInfo.BitsPerSample > 16) {
+          Processing::ConversionKernels::ShiftAndDivideInt32ToFloat(
+            unpacked, this->shift, static_cast<double>(limit), target, batchSampleCount
+          );
+        } else {
+          Processing::ConversionKernels::ShiftAndDivideInt32ToFloat(
+            unpacked, this->shift, static_cast<float>(limit), target, batchSampleCount
+          );
+        }
+
+        source += batchSampleCount * this->bytesPerSample;
+        target += batchSampleCount;
+        sampleCount -= batchSampleCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
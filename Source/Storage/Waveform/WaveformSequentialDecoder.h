@@ -0,0 +1,132 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMSEQUENTIALDECODER_H
+#define NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMSEQUENTIALDECODER_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "Nuclex/Audio/TrackInfo.h" // for TrackInfo
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a Waveform audio file front to back from a sequential source</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The chunks are parsed in the order they arrive, so the 'fmt ' chunk has to come
+  ///     before the 'data' chunk (which every writer does anyway). Anything behind
+  ///     the 'data' chunk is never looked at.
+  ///   </para>
+  ///   <para>
+  ///     Writers that stream their output put 0 or 0xFFFFFFFF into the length of the
+  ///     'data' chunk because they don't know it yet. Such files are decoded until
+  ///     the source runs dry and report no frame count.
+  ///   </para>
+  /// </remarks>
+  class WaveformSequentialDecoder : public SequentialTrackDecoder {
+
+    /// <summary>Initializes a new sequential Waveform decoder reading from a source</summary>
+    /// <param name="source">Source from which the Waveform file will be read</param>
+    public: WaveformSequentialDecoder(const std::shared_ptr<SequentialSource> &source);
+
+    /// <summary>Frees all resources owned by the decoder</summary>
+    public: ~WaveformSequentialDecoder() override;
+
+    /// <summary>Counts the number of audio channels in the track</summary>
+    /// <returns>The number of audio channels in the audio track</returns>
+    public: std::size_t CountChannels() const override { return this->trackInfo.ChannelCount; }
+
+    /// <summary>Produces the order in which channels are interleaved</summary>
+    /// <returns>A list of single channels in the order they're interleaved</returns>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override {
+      return this->channelOrder;
+    }
+
+    /// <summary>Returns the number of samples per second in each channel</summary>
+    /// <returns>The sample rate of the audio track</returns>
+    public: std::size_t GetSampleRate() const override { return this->trackInfo.SampleRate; }
+
+    /// <summary>Returns the number of frames in the track if it is known</summary>
+    /// <returns>The number of frames in the track or nothing if it isn't recorded</returns>
+    public: std::optional<std::uint64_t> TryCountFrames() const override {
+      return this->totalFrameCount;
+    }
+
+    /// <summary>Returns the number of frames that have been delivered so far</summary>
+    /// <returns>The index of the frame that will be delivered next</returns>
+    public: std::uint64_t GetFrameCursorPosition() const override { return this->cursor; }
+
+    /// <summary>Delivers the next audio frames, interleaved, into the target buffer</summary>
+    /// <param name="buffer">Buffer in which the interleaved samples will be stored</param>
+    /// <param name="frameCount">Maximum number of audio frames that should be delivered</param>
+    /// <returns>The number of frames delivered, zero at the end of the track</returns>
+    public: std::size_t DecodeInterleaved(float *buffer, std::size_t frameCount) override;
+
+    /// <summary>Reads chunks from the source until the 'data' chunk begins</summary>
+    private: void parseHeaders();
+
+    /// <summary>Reads exactly the requested number of bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    private: void readExactly(std::byte *buffer, std::size_t byteCount);
+
+    /// <summary>Reads and discards the requested number of bytes from the source</summary>
+    /// <param name="byteCount">Number of bytes that will be skipped</param>
+    private: void skip(std::uint64_t byteCount);
+
+    /// <summary>Converts complete frames from the read buffer into floats</summary>
+    /// <param name="source">Data of the frames as stored in the file</param>
+    /// <param name="target">Buffer that will receive the converted samples</param>
+    /// <param name="frameCount">Number of frames that will be converted</param>
+    private: void convert(const std::byte *source, float *target, std::size_t frameCount);
+
+    /// <summary>Source from which the Waveform file is being read</summary>
+    private: std::shared_ptr<SequentialSource> source;
+    /// <summary>Audio format as recorded in the 'fmt ' chunk</summary>
+    private: TrackInfo trackInfo;
+    /// <summary>Order in which the channels are interleaved</summary>
+    private: std::vector<ChannelPlacement> channelOrder;
+    /// <summary>Number of frames in the 'data' chunk if it records its length</summary>
+    private: std::optional<std::uint64_t> totalFrameCount;
+    /// <summary>Number of bytes in one frame, including any padding</summary>
+    private: std::size_t bytesPerFrame;
+    /// <summary>Number of bytes in one sample</summary>
+    private: std::size_t bytesPerSample;
+    /// <summary>Number of unused low bits in each integer sample</summary>
+    private: int shift;
+    /// <summary>Index of the next frame that will be delivered</summary>
+    private: std::uint64_t cursor;
+    /// <summary>Number of bytes that have been read from the source so far</summary>
+    private: std::uint64_t position;
+    /// <summary>Holds the frames as they arrive from the source</summary>
+    private: std::vector<std::byte> readBuffer;
+    /// <summary>Number of bytes of an incomplete frame at the start of the read buffer</summary>
+    private: std::size_t partialByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
+
+#endif // NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMSEQUENTIALDECODER_H
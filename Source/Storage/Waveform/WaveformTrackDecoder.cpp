@@ -24,14 +24,25 @@ limitations under the License.
 
 #include "Nuclex/Audio/Processing/SampleConverter.h"
 #include "Nuclex/Audio/TrackInfo.h"
+#include "Nuclex/Audio/AllocationScope.h" // for AllocationScope
 
 #include "./WaveformReader.h"
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
 
+#include <algorithm> // for std::min()
 #include <cassert> // for assert()
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Smallest number of frames worth reading on a separate thread</summary>
+  /// <remarks>
+  ///   About six seconds of audio. Reading and converting is so cheap that smaller
+  ///   slices would spend more time waiting for a worker than they save.
+  /// </remarks>
+  constexpr std::size_t MinimumSliceFrameCount = 262144;
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -41,11 +52,16 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   // ------------------------------------------------------------------------------------------- //
 
   WaveformTrackDecoder::WaveformTrackDecoder(const std::shared_ptr<const VirtualFile> &file) :
+    statistics(
+      std::make_shared<Shared::DecoderStatisticsCollector>(Shared::TrackedCodec::Waveform)
+    ),
     reader(file),
     trackInfo(),
     channelOrder(),
     totalFrameCount(std::uint64_t(-1)),
-    decodingMutex() {
+    decodingMutex(),
+    executor(Executor::GetInstalled()),
+    sliceReaders() {
 
     this->reader.ReadMetadata(this->trackInfo);
 
@@ -60,12 +76,46 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  WaveformTrackDecoder::WaveformTrackDecoder(
+    const std::shared_ptr<const VirtualFile> &file,
+    const StoredSampleLayout &layout,
+    Shared::TrackedCodec codec
+  ) :
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(codec)),
+    reader(file, layout),
+    trackInfo(layout.Track),
+    channelOrder(),
+    totalFrameCount(layout.FrameCount),
+    decodingMutex(),
+    executor(Executor::GetInstalled()),
+    sliceReaders() {
+    this->channelOrder = this->reader.GetChannelOrder();
+    this->reader.PrepareForReading();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WaveformTrackDecoder::WaveformTrackDecoder(const WaveformTrackDecoder &other) :
+    statistics(std::make_shared<Shared::DecoderStatisticsCollector>(
+      other.statistics->GetCodec(), other.statistics->IsEnabled()
+    )),
+    reader(other.reader),
+    trackInfo(other.trackInfo),
+    channelOrder(other.channelOrder),
+    totalFrameCount(other.totalFrameCount),
+    decodingMutex(),
+    executor(other.executor),
+    sliceReaders() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
   WaveformTrackDecoder::~WaveformTrackDecoder() {}
 
   // ------------------------------------------------------------------------------------------- //
 
   std::shared_ptr<AudioTrackDecoder> WaveformTrackDecoder::Clone() const {
-    throw std::runtime_error(u8"Not implemented yet");
+    AllocationScope cloneScope(AllocationSubsystem::ReaderScratch, AllocationCodec::Waveform);
+    return std::shared_ptr<AudioTrackDecoder>(new WaveformTrackDecoder(*this));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -100,13 +150,147 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void WaveformTrackDecoder::EnableStatistics(bool enable /* = true */) const {
+    this->statistics->Enable(enable);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecoderStatistics WaveformTrackDecoder::GetStatistics() const {
+    return this->statistics->GetSnapshot();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LatencyHistogram WaveformTrackDecoder::GetDecodeLatencies(bool reset /* = false */) const {
+    return this->statistics->GetLatencies(reset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodePath WaveformTrackDecoder::ExplainDecodePath(
+    AudioSampleFormat sampleFormat, bool interleaved
+  ) const {
+    return this->reader.ExplainDecodePath(sampleFormat, interleaved);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeekCost WaveformTrackDecoder::EstimateSeekCost(std::uint64_t) const {
+
+    // Every frame sits at a known offset in the file and is read directly from there
+    return SeekCost { 0, 0, 1, true };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WaveformTrackDecoder::readInterleaved(
+    TSample *buffer, std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->channelOrder.size();
+    readInSlices(
+      startFrame, frameCount,
+      [=](
+        WaveformReader &reader,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        reader.ReadInterleaved<TSample>(
+          buffer + (sliceOffset * channelCount), sliceStartFrame, sliceFrameCount
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WaveformTrackDecoder::readSeparated(
+    TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount
+  ) const {
+    std::size_t channelCount = this->channelOrder.size();
+    readInSlices(
+      startFrame, frameCount,
+      [=](
+        WaveformReader &reader,
+        std::uint64_t sliceStartFrame, std::size_t sliceOffset, std::size_t sliceFrameCount
+      ) {
+        if(sliceOffset == 0) {
+          reader.ReadSeparated<TSample>(buffers, sliceStartFrame, sliceFrameCount);
+          return;
+        }
+
+        std::vector<TSample *> sliceBuffers(channelCount);
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          if(buffers[channelIndex] != nullptr) {
+            sliceBuffers[channelIndex] = buffers[channelIndex] + sliceOffset;
+          }
+        }
+        reader.ReadSeparated<TSample>(sliceBuffers.data(), sliceStartFrame, sliceFrameCount);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TReadMethod>
+  void WaveformTrackDecoder::readInSlices(
+    std::uint64_t startFrame, std::size_t frameCount, TReadMethod &&read
+  ) const {
+    std::size_t sliceCount = std::min(
+      this->executor->CountWorkers() + 1, frameCount / MinimumSliceFrameCount
+    );
+    if(sliceCount < 2) {
+      read(this->reader, startFrame, 0, frameCount);
+      return;
+    }
+
+    // The first slice is read through the decoder's own reader, all others
+    // get a copy that is kept around for later calls
+    while(this->sliceReaders.size() < sliceCount - 1) {
+      AllocationScope sliceScope(AllocationSubsystem::ReaderScratch, AllocationCodec::Waveform);
+      this->sliceReaders.push_back(std::make_unique<WaveformReader>(this->reader));
+    }
+
+    // Since frames sit at fixed offsets, the slices can be split anywhere. Each writes
+    // into its own part of the caller's buffer, so nothing needs to be synchronized.
+    this->executor->ParallelFor(
+      sliceCount,
+      [&](std::size_t sliceIndex) {
+        std::uint64_t sliceStart = static_cast<std::uint64_t>(frameCount) * sliceIndex / sliceCount;
+        std::uint64_t sliceEnd = (
+          static_cast<std::uint64_t>(frameCount) * (sliceIndex + 1) / sliceCount
+        );
+        read(
+          (sliceIndex == 0) ? this->reader : *this->sliceReaders[sliceIndex - 1],
+          startFrame + sliceStart,
+          static_cast<std::size_t>(sliceStart),
+          static_cast<std::size_t>(sliceEnd - sliceStart)
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void WaveformTrackDecoder::DecodeInterleavedUint8(
     std::uint8_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readInterleaved<std::uint8_t>(buffer, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -114,10 +298,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeInterleavedInt16(
     std::int16_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readInterleaved<std::int16_t>(buffer, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -125,10 +320,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeInterleavedInt32(
     std::int32_t *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readInterleaved<std::int32_t>(buffer, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -146,7 +352,11 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
     }
 
-    this->reader.ReadInterleaved<float>(buffer, startFrame, frameCount);
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readInterleaved<float>(buffer, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -154,10 +364,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeInterleavedDouble(
     double *buffer, const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffer;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readInterleaved<double>(buffer, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -165,10 +386,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeSeparatedUint8(
     std::uint8_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readSeparated<std::uint8_t>(buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -176,10 +408,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeSeparatedInt16(
     std::int16_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readSeparated<std::int16_t>(buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -187,10 +430,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeSeparatedInt32(
     std::int32_t *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readSeparated<std::int32_t>(buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -198,10 +452,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeSeparatedFloat(
     float *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readSeparated<float>(buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -209,10 +474,21 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   void WaveformTrackDecoder::DecodeSeparatedDouble(
     double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
   ) const {
-    (void)buffers;
-    (void)startFrame;
-    (void)frameCount;
-    throw std::runtime_error(u8"Not implemented yet");
+    if(std::numeric_limits<std::uint32_t>::max() < frameCount) {
+      throw std::logic_error(u8"Unable to decode this many samples in one call");
+    }
+    if(startFrame >= this->totalFrameCount) {
+      throw std::out_of_range(u8"Start sample index is out of bounds");
+    }
+    if(this->totalFrameCount < startFrame + frameCount) {
+      throw std::out_of_range(u8"Decode sample count goes beyond the end of audio data");
+    }
+
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Decode Waveform", nullptr, this);
+
+    Shared::DecodeStatisticsScope statisticsScope(*this->statistics, frameCount);
+    this->statistics->AddReadBytes(frameCount * this->reader.CountBytesPerFrame());
+    readSeparated<double>(buffers, startFrame, frameCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
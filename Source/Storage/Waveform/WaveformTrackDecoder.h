@@ -22,25 +22,57 @@ limitations under the License.
 
 #include "Nuclex/Audio/Config.h"
 
+#include "Nuclex/Audio/Executor.h"
 #include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
 #include "Nuclex/Audio/TrackInfo.h"
 #include "./WaveformReader.h"
+#include "../Shared/DecoderStatisticsCollector.h"
 
+#include <memory> // for std::unique_ptr
 #include <mutex> // for std::mutex
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Decodes Waveform audio tracks</summary>
+  /// <remarks>
+  ///   Every frame sits at a known offset in the file, so very large decoding calls
+  ///   (such as loading or converting a whole multi-gigabyte recording) are split into
+  ///   slices that are read and converted on the installed <see cref="Executor" />,
+  ///   each by its own reader directly into its part of the caller's buffer.
+  /// </remarks>
   class WaveformTrackDecoder : public AudioTrackDecoder {
 
     /// <summary>Initializes a new Opus track decoder on the specified file</summary>
     /// <param name="file">File that will be opened and decoded</param>
     public: WaveformTrackDecoder(const std::shared_ptr<const VirtualFile> &file);
+
+    /// <summary>Initializes a new track decoder for another uncompressed format</summary>
+    /// <param name="file">File that will be decoded</param>
+    /// <param name="layout">Description of the stored samples parsed from the headers</param>
+    /// <param name="codec">Codec the decoding statistics will be grouped under</param>
+    /// <remarks>
+    ///   This lets formats such as AIFF, which only differ in their headers, reuse the whole
+    ///   decoding path including zero-copy reads from memory and the byte-swap kernels.
+    /// </remarks>
+    public: WaveformTrackDecoder(
+      const std::shared_ptr<const VirtualFile> &file,
+      const StoredSampleLayout &layout,
+      Shared::TrackedCodec codec
+    );
     /// <summary>Frees all resources owned by the instance</summary>
     public: ~WaveformTrackDecoder() override;
 
+    /// <summary>Initializes a new track decoder as a clone of another</summary>
+    /// <param name="other">Track decoder that will be cloned</param>
+    /// <remarks>
+    ///   The Waveform reader holds no decoding state besides the file and the offsets
+    ///   it parsed from the headers, so the clone simply takes a copy of it.
+    /// </remarks>
+    private: WaveformTrackDecoder(const WaveformTrackDecoder &other);
+
     /// <summary>Creates a clone of the audio track decoder</summary>
     /// <returns>A clone of the audio track decoder that can be used independently</returns>
     public: std::shared_ptr<AudioTrackDecoder> Clone() const override;
@@ -65,6 +97,32 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     /// <returns>True if the codec decodes straight to interleaved channels</summary>
     public: bool IsNativelyInterleaved() const override;
 
+    /// <summary>Turns the collection of decoder statistics on or off</summary>
+    /// <param name="enable">True to begin collecting statistics, false to stop</param>
+    public: void EnableStatistics(bool enable = true) const override;
+
+    /// <summary>Retrieves the statistics the decoder has collected so far</summary>
+    /// <returns>The current values of the decoder's statistics</returns>
+    public: DecoderStatistics GetStatistics() const override;
+
+    /// <summary>Retrieves the distribution of the decoder's decoding call times</summary>
+    /// <param name="reset">Whether to empty the histogram while retrieving it</param>
+    /// <returns>A histogram of the wall time each decoding call took</returns>
+    public: LatencyHistogram GetDecodeLatencies(bool reset = false) const override;
+
+    /// <summary>Describes how the decoder would deliver samples in a specific format</summary>
+    /// <param name="sampleFormat">Format in which the samples would be requested</param>
+    /// <param name="interleaved">Whether the samples would be requested interleaved</param>
+    /// <returns>The steps, passes and scratch buffers the decoding methods would use</returns>
+    public: DecodePath ExplainDecodePath(
+      AudioSampleFormat sampleFormat, bool interleaved
+    ) const override;
+
+    /// <summary>Estimates how much work it would be to continue decoding at a frame</summary>
+    /// <param name="targetFrame">Frame the next decoding call would start at</param>
+    /// <returns>The bytes to read, frames to throw away and jumps to make</returns>
+    public: SeekCost EstimateSeekCost(std::uint64_t targetFrame) const override;
+
     // The public variant of the DecoeInterleaved() method delegates to our implementations
     public: using AudioTrackDecoder::DecodeInterleaved;
 
@@ -153,6 +211,37 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
       double *buffers[], const std::uint64_t startFrame, const std::size_t frameCount
     ) const override;
 
+    /// <summary>Reads interleaved samples, splitting large calls into parallel slices</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffer">Buffer into which the samples will be written</param>
+    /// <param name="startFrame">Frame from which on to read samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    private: template<typename TSample>
+    void readInterleaved(TSample *buffer, std::uint64_t startFrame, std::size_t frameCount) const;
+
+    /// <summary>Reads separated samples, splitting large calls into parallel slices</summary>
+    /// <typeparam name="TSample">Type of samples that will be decoded</typeparam>
+    /// <param name="buffers">Buffers into which the channels will be written</param>
+    /// <param name="startFrame">Frame from which on to read samples</param>
+    /// <param name="frameCount">Number of frames that should be decoded</param>
+    private: template<typename TSample>
+    void readSeparated(TSample *buffers[], std::uint64_t startFrame, std::size_t frameCount) const;
+
+    /// <summary>Splits a read into slices and runs them on the executor</summary>
+    /// <typeparam name="TReadMethod">Method that reads one slice</typeparam>
+    /// <param name="startFrame">Index of the first frame that will be read</param>
+    /// <param name="frameCount">Number of frames that will be read</param>
+    /// <param name="read">
+    ///   Method that will be called with the reader, the first frame, the offset in
+    ///   the caller's buffer and the number of frames of each slice
+    /// </param>
+    private: template<typename TReadMethod>
+    void readInSlices(
+      std::uint64_t startFrame, std::size_t frameCount, TReadMethod &&read
+    ) const;
+
+    /// <summary>Counts frames, seeks, bytes read and decoding time if enabled</summary>
+    private: std::shared_ptr<Shared::DecoderStatisticsCollector> statistics;
     /// <summary>Reader through which the audio file will be decoded</summary>
     private: mutable WaveformReader reader;
     /// <summary>Informations about the audio track being decoded</summary>
@@ -168,6 +257,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
     private: std::uint64_t totalFrameCount;
     /// <summary>Must be held while decoding</summary>
     private: mutable std::mutex decodingMutex;
+    /// <summary>Executor on which the slices of large decoding calls are read</summary>
+    private: std::shared_ptr<Executor> executor;
+    /// <summary>Additional readers for the slices beyond the first</summary>
+    /// <remarks>
+    ///   Each reader has its own read buffer, so they can convert at the same time.
+    ///   They're created when a call is first split and then kept for later calls.
+    /// </remarks>
+    private: mutable std::vector<std::unique_ptr<WaveformReader>> sliceReaders;
 
   };
 
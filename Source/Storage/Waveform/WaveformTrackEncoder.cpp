@@ -0,0 +1,671 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WaveformTrackEncoder.h"
+#include "./WaveformParser.h" // for WaveformParser::GuessChannelPlacement()
+
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Processing/Interleaver.h"
+#include "Nuclex/Audio/Processing/Int24Packing.h"
+#include "Nuclex/Audio/Processing/ByteSwapping.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
+#include "../../TraceZone.h" // for NUCLEX_AUDIO_TRACE_ZONE
+
+#include <algorithm> // for std::min(), std::find(), std::copy_n(), std::fill_n()
+#include <cassert> // for assert()
+#include <stdexcept> // for std::invalid_argument, std::logic_error
+#include <type_traits> // for std::is_same
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of audio frames that are converted in one go</summary>
+  const std::size_t ConversionFrameCount = 4096;
+
+  /// <summary>Largest size a RIFF file can record in its 32-bit size fields</summary>
+  const std::uint64_t MaximumRiffSize = 0xFFFFFFFFu;
+
+  /// <summary>Length of the 'ds64' chunk (and its 'JUNK' placeholder), minus 8 bytes</summary>
+  const std::size_t Ds64ChunkLength = 28;
+
+  /// <summary>Audio format that indicates uncompressed PCM audio</summary>
+  const std::uint16_t WaveFormatPcm = 1;
+  /// <summary>Audio format tag that indicates a WAVEFORMATEXTENSIBLE header</summary>
+  const std::uint16_t WaveFormatExtensible = 65534;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>GUID for the integer PCM audio subformat in WAVEFORMATEXTENSIBLE</summary>
+  const std::byte WaveFormatSubTypePcm[16] = {
+    std::byte(0x01), std::byte(0x00), std::byte(0x00), std::byte(0x00),
+    std::byte(0x00), std::byte(0x00), std::byte(0x10), std::byte(0x00),
+    std::byte(0x80), std::byte(0x00), std::byte(0x00), std::byte(0xaa),
+    std::byte(0x00), std::byte(0x38), std::byte(0x9b), std::byte(0x71)
+  };
+
+  /// <summary>GUID for the float PCM audio subformat in WAVEFORMATEXTENSIBLE</summary>
+  const std::byte WaveFormatSubTypeIeeeFloat[16] = {
+    std::byte(0x03), std::byte(0x00), std::byte(0x00), std::byte(0x00),
+    std::byte(0x00), std::byte(0x00), std::byte(0x10), std::byte(0x00),
+    std::byte(0x80), std::byte(0x00), std::byte(0x00), std::byte(0xaa),
+    std::byte(0x00), std::byte(0x38), std::byte(0x9b), std::byte(0x71)
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a four-character code into a buffer</summary>
+  /// <param name="target">Buffer the four-character code will be written to</param>
+  /// <param name="fourCC">Four-character code that will be written</param>
+  /// <returns>The address in the buffer behind the written four-character code</returns>
+  std::byte *writeFourCC(std::byte *target, const char (&fourCC)[5]) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      target[index] = static_cast<std::byte>(fourCC[index]);
+    }
+    return target + 4;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 16-bit unsigned integer into a buffer as little endian</summary>
+  /// <param name="target">Buffer the integer will be written to</param>
+  /// <param name="value">Value that will be written</param>
+  /// <returns>The address in the buffer behind the written integer</returns>
+  std::byte *writeUInt16(std::byte *target, std::uint16_t value) {
+    target[0] = static_cast<std::byte>(value);
+    target[1] = static_cast<std::byte>(value >> 8);
+    return target + 2;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 32-bit unsigned integer into a buffer as little endian</summary>
+  /// <param name="target">Buffer the integer will be written to</param>
+  /// <param name="value">Value that will be written</param>
+  /// <returns>The address in the buffer behind the written integer</returns>
+  std::byte *writeUInt32(std::byte *target, std::uint32_t value) {
+    target[0] = static_cast<std::byte>(value);
+    target[1] = static_cast<std::byte>(value >> 8);
+    target[2] = static_cast<std::byte>(value >> 16);
+    target[3] = static_cast<std::byte>(value >> 24);
+    return target + 4;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether samples of the specified type are stored verbatim</summary>
+  /// <typeparam name="TSample">Type of the samples that are fed to the encoder</typeparam>
+  /// <param name="format">Format in which the samples are stored in the file</param>
+  /// <returns>True if the file stores the samples exactly like the sample type</returns>
+  template<typename TSample>
+  bool isStoredAs(Nuclex::Audio::AudioSampleFormat format) {
+    using Nuclex::Audio::AudioSampleFormat;
+
+    if constexpr(std::is_same<TSample, std::uint8_t>::value) {
+      return (format == AudioSampleFormat::UnsignedInteger_8);
+    } else if constexpr(std::is_same<TSample, std::int16_t>::value) {
+      return (format == AudioSampleFormat::SignedInteger_16);
+    } else if constexpr(std::is_same<TSample, std::int32_t>::value) {
+      return (format == AudioSampleFormat::SignedInteger_32);
+    } else if constexpr(std::is_same<TSample, float>::value) {
+      return (format == AudioSampleFormat::Float_32);
+    } else {
+      return (format == AudioSampleFormat::Float_64);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the number of bytes a sample occupies in the file</summary>
+  /// <param name="format">Format in which the samples are stored in the file</param>
+  /// <returns>The number of bytes each sample occupies</returns>
+  std::size_t getBytesPerSample(Nuclex::Audio::AudioSampleFormat format) {
+    using Nuclex::Audio::AudioSampleFormat;
+
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8: { return 1; }
+      case AudioSampleFormat::SignedInteger_16: { return 2; }
+      case AudioSampleFormat::SignedInteger_24: { return 3; }
+      case AudioSampleFormat::SignedInteger_32: { return 4; }
+      case AudioSampleFormat::Float_32: { return 4; }
+      case AudioSampleFormat::Float_64: { return 8; }
+      default: {
+        throw std::invalid_argument(u8"Unsupported sample format for Waveform audio files");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WaveformTrackEncoder::WaveformTrackEncoder(
+    const std::shared_ptr<VirtualFile> &target,
+    const std::vector<ChannelPlacement> &inputChannelOrder,
+    std::size_t sampleRate,
+    AudioSampleFormat sampleFormat
+  ) :
+    target(target),
+    inputChannelOrder(inputChannelOrder),
+    inputChannelIndices(),
+    isInWaveformOrder(true),
+    channelPlacements(ChannelPlacement::Unknown),
+    sampleRate(sampleRate),
+    sampleFormat(sampleFormat),
+    bytesPerSample(getBytesPerSample(sampleFormat)),
+    isExtensible(false),
+    headerByteCount(0),
+    audioDataByteCount(0),
+    header(),
+    convertedSamples(),
+    orderedSamples(),
+    packedSamples() {
+
+    std::size_t channelCount = this->inputChannelOrder.size();
+    for(ChannelPlacement channel : this->inputChannelOrder) {
+      this->channelPlacements = this->channelPlacements | channel;
+    }
+
+    // Waveform files store their channels in the order of the bits in the channel mask.
+    // Figure out where each of the channels in that order can be found in the input.
+    std::vector<ChannelPlacement> waveformChannelOrder = (
+      Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(
+        channelCount, this->channelPlacements
+      )
+    );
+    for(ChannelPlacement channel : waveformChannelOrder) {
+      std::vector<ChannelPlacement>::const_iterator inputChannel = std::find(
+        this->inputChannelOrder.begin(), this->inputChannelOrder.end(), channel
+      );
+      if(unlikely(inputChannel == this->inputChannelOrder.end())) {
+        throw std::invalid_argument(
+          u8"Channel layout cannot be represented in a Waveform audio file"
+        );
+      }
+
+      std::size_t inputChannelIndex = static_cast<std::size_t>(
+        inputChannel - this->inputChannelOrder.begin()
+      );
+      this->isInWaveformOrder &= (inputChannelIndex == this->inputChannelIndices.size());
+      this->inputChannelIndices.push_back(inputChannelIndex);
+    }
+
+    // Plain PCMWAVEFORMAT headers have neither channel mask nor float samples and
+    // Microsoft asks for WAVEFORMATEXTENSIBLE beyond 2 channels or beyond 16 bits.
+    bool isFloat = (
+      (sampleFormat == AudioSampleFormat::Float_32) ||
+      (sampleFormat == AudioSampleFormat::Float_64)
+    );
+    this->isExtensible = (
+      isFloat ||
+      (channelCount > 2) ||
+      (this->bytesPerSample > 2) ||
+      (this->channelPlacements != WaveformParser::GuessChannelPlacement(channelCount))
+    );
+    if(this->isExtensible) {
+      this->headerByteCount = isFloat ? 116 : 104; // float gets a 'fact' chunk
+    } else {
+      this->headerByteCount = 80;
+    }
+
+    // 24-bit samples go through the sample converter as 32-bit integers
+    std::size_t bufferSize = ConversionFrameCount * channelCount * (
+      (this->bytesPerSample == 3) ? 4 : this->bytesPerSample
+    );
+    this->convertedSamples.resize(bufferSize);
+    this->orderedSamples.resize(bufferSize);
+    if(this->bytesPerSample == 3) {
+      this->packedSamples.resize(ConversionFrameCount * channelCount * 3);
+    }
+
+    // Write the header right away so the audio data can be appended behind it.
+    // It is rewritten with the actual sizes when the encoder is flushed.
+    buildHeader();
+    this->target->WriteAt(0, this->headerByteCount, this->header.data());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<ChannelPlacement> &WaveformTrackEncoder::GetChannelOrder() const {
+    return this->inputChannelOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WaveformTrackEncoder::CountWrittenBytes() const {
+    return this->target->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::Flush() {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Flush Waveform", this->target.get(), this);
+
+    // RIFF chunks are aligned to 2 bytes, an odd-sized 'data' chunk needs a pad byte.
+    // It is not counted in the chunk size, so any further samples simply overwrite it.
+    if((this->audioDataByteCount & 1) != 0) {
+      std::byte padding = std::byte(0);
+      this->target->WriteAt(this->headerByteCount + this->audioDataByteCount, 1, &padding);
+    }
+
+    buildHeader();
+    this->target->WriteAt(0, this->headerByteCount, this->header.data());
+
+    // The virtual file may be collecting writes in a buffer, make sure they get written
+    this->target->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WaveformTrackEncoder::Reopen(const std::shared_ptr<VirtualFile> &target) {
+    this->target = target;
+    this->audioDataByteCount = 0;
+
+    // Everything else depends only on the settings, so the new file just needs its header
+    buildHeader();
+    this->target->WriteAt(0, this->headerByteCount, this->header.data());
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeInterleavedUint8(
+    const std::uint8_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeInterleavedInt16(
+    const std::int16_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeInterleavedInt32(
+    const std::int32_t *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeInterleavedFloat(
+    const float *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeInterleavedDouble(
+    const double *buffer, std::size_t frameCount
+  ) {
+    encodeInterleaved(buffer, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeSeparatedUint8(
+    const std::uint8_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeSeparatedInt16(
+    const std::int16_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeSeparatedInt32(
+    const std::int32_t *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeSeparatedFloat(
+    const float *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::EncodeSeparatedDouble(
+    const double *buffers[], std::size_t frameCount
+  ) {
+    encodeSeparated(buffers, frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WaveformTrackEncoder::encodeInterleaved(
+    const TSample *buffer, std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Waveform", this->target.get(), this);
+
+#if defined(NUCLEX_AUDIO_LITTLE_ENDIAN)
+    // If the caller's samples are exactly what goes into the file, hand them
+    // to the virtual file as they are. This makes writing purely I/O bound.
+    if(this->isInWaveformOrder && isStoredAs<TSample>(this->sampleFormat)) {
+      appendAudioData(
+        reinterpret_cast<const std::byte *>(buffer),
+        frameCount * this->inputChannelOrder.size() * sizeof(TSample)
+      );
+      return;
+    }
+#endif
+
+    switch(this->sampleFormat) {
+      case AudioSampleFormat::UnsignedInteger_8: {
+        encodeInterleavedAs<TSample, std::uint8_t>(buffer, frameCount, 8);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_16: {
+        encodeInterleavedAs<TSample, std::int16_t>(buffer, frameCount, 16);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_24: {
+        encodeInterleavedAs<TSample, std::int32_t>(buffer, frameCount, 24);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_32: {
+        encodeInterleavedAs<TSample, std::int32_t>(buffer, frameCount, 32);
+        break;
+      }
+      case AudioSampleFormat::Float_32: {
+        encodeInterleavedAs<TSample, float>(buffer, frameCount, 32);
+        break;
+      }
+      case AudioSampleFormat::Float_64: {
+        encodeInterleavedAs<TSample, double>(buffer, frameCount, 64);
+        break;
+      }
+      default: {
+        throw std::logic_error(u8"Encoder was set up with an unsupported sample format");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample>
+  void WaveformTrackEncoder::encodeSeparated(
+    const TSample *buffers[], std::size_t frameCount
+  ) {
+    NUCLEX_AUDIO_TRACE_ZONE(u8"Encode Waveform", this->target.get(), this);
+
+    // A single channel is the same whether interleaved or separated
+    if(this->inputChannelOrder.size() == 1) {
+      encodeInterleaved(buffers[0], frameCount);
+      return;
+    }
+
+    switch(this->sampleFormat) {
+      case AudioSampleFormat::UnsignedInteger_8: {
+        encodeSeparatedAs<TSample, std::uint8_t>(buffers, frameCount, 8);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_16: {
+        encodeSeparatedAs<TSample, std::int16_t>(buffers, frameCount, 16);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_24: {
+        encodeSeparatedAs<TSample, std::int32_t>(buffers, frameCount, 24);
+        break;
+      }
+      case AudioSampleFormat::SignedInteger_32: {
+        encodeSeparatedAs<TSample, std::int32_t>(buffers, frameCount, 32);
+        break;
+      }
+      case AudioSampleFormat::Float_32: {
+        encodeSeparatedAs<TSample, float>(buffers, frameCount, 32);
+        break;
+      }
+      case AudioSampleFormat::Float_64: {
+        encodeSeparatedAs<TSample, double>(buffers, frameCount, 64);
+        break;
+      }
+      default: {
+        throw std::logic_error(u8"Encoder was set up with an unsupported sample format");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample, typename TStored>
+  void WaveformTrackEncoder::encodeInterleavedAs(
+    const TSample *buffer, std::size_t frameCount, std::size_t storedBitCount
+  ) {
+    std::size_t channelCount = this->inputChannelOrder.size();
+    TStored *converted = reinterpret_cast<TStored *>(this->convertedSamples.data());
+    TStored *ordered = reinterpret_cast<TStored *>(this->orderedSamples.data());
+
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      Processing::SampleConverter::Convert(
+        buffer, sizeof(TSample) * 8, converted, storedBitCount, chunkFrameCount * channelCount
+      );
+
+      if(this->isInWaveformOrder) {
+        writeSamples(converted, chunkFrameCount);
+      } else {
+        const TStored *source = converted;
+        TStored *target = ordered;
+        for(std::size_t frameIndex = 0; frameIndex < chunkFrameCount; ++frameIndex) {
+          for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            target[channelIndex] = source[this->inputChannelIndices[channelIndex]];
+          }
+          source += channelCount;
+          target += channelCount;
+        }
+        writeSamples(ordered, chunkFrameCount);
+      }
+
+      buffer += chunkFrameCount * channelCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TSample, typename TStored>
+  void WaveformTrackEncoder::encodeSeparatedAs(
+    const TSample *buffers[], std::size_t frameCount, std::size_t storedBitCount
+  ) {
+    std::size_t channelCount = this->inputChannelOrder.size();
+    TStored *converted = reinterpret_cast<TStored *>(this->convertedSamples.data());
+    TStored *ordered = reinterpret_cast<TStored *>(this->orderedSamples.data());
+
+    // The interleaver picks up the channels in Waveform order, so reordering
+    // the channels costs nothing beyond shuffling these pointers around
+    std::vector<const TStored *> sources(channelCount);
+
+    std::size_t offset = 0;
+    while(frameCount > 0) {
+      std::size_t chunkFrameCount = std::min(frameCount, ConversionFrameCount);
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        const TSample *channel = buffers[this->inputChannelIndices[channelIndex]] + offset;
+        if constexpr(std::is_same<TSample, TStored>::value) {
+          if(storedBitCount == sizeof(TStored) * 8) {
+            sources[channelIndex] = channel;
+            continue;
+          }
+        }
+
+        TStored *convertedChannel = converted + (channelIndex * ConversionFrameCount);
+        Processing::SampleConverter::Convert(
+          channel, sizeof(TSample) * 8, convertedChannel, storedBitCount, chunkFrameCount
+        );
+        sources[channelIndex] = convertedChannel;
+      }
+
+      Processing::Interleaver::Interleave(
+        sources.data(), ordered, channelCount, chunkFrameCount
+      );
+      writeSamples(ordered, chunkFrameCount);
+
+      offset += chunkFrameCount;
+      frameCount -= chunkFrameCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TStored>
+  void WaveformTrackEncoder::writeSamples(TStored *samples, std::size_t frameCount) {
+    std::size_t sampleCount = frameCount * this->inputChannelOrder.size();
+
+    // The sample converter leaves 24-bit samples in the upper end of a 32-bit integer,
+    // so they're shifted down and then packed into 3 bytes each
+    if constexpr(std::is_same<TStored, std::int32_t>::value) {
+      if(this->bytesPerSample == 3) {
+        for(std::size_t index = 0; index < sampleCount; ++index) {
+          samples[index] >>= 8;
+        }
+        Processing::Int24Packing::PackFromInt32(samples, this->packedSamples.data(), sampleCount);
+        appendAudioData(this->packedSamples.data(), sampleCount * 3);
+        return;
+      }
+    }
+
+    std::byte *data = reinterpret_cast<std::byte *>(samples);
+#if defined(NUCLEX_AUDIO_BIG_ENDIAN)
+    if constexpr(sizeof(TStored) == 2) {
+      Processing::ByteSwapping::Swap16(data, data, sampleCount);
+    } else if constexpr(sizeof(TStored) == 4) {
+      Processing::ByteSwapping::Swap32(data, data, sampleCount);
+    } else if constexpr(sizeof(TStored) == 8) {
+      Processing::ByteSwapping::Swap64(data, data, sampleCount);
+    }
+#endif
+    appendAudioData(data, sampleCount * sizeof(TStored));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::appendAudioData(const std::byte *data, std::size_t byteCount) {
+    this->target->WriteAt(this->headerByteCount + this->audioDataByteCount, byteCount, data);
+    this->audioDataByteCount += byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WaveformTrackEncoder::buildHeader() {
+    std::size_t channelCount = this->inputChannelOrder.size();
+    std::size_t bytesPerFrame = this->bytesPerSample * channelCount;
+    bool isFloat = (
+      (this->sampleFormat == AudioSampleFormat::Float_32) ||
+      (this->sampleFormat == AudioSampleFormat::Float_64)
+    );
+
+    std::uint64_t frameCount = this->audioDataByteCount / bytesPerFrame;
+    std::uint64_t paddedDataByteCount = this->audioDataByteCount + (this->audioDataByteCount & 1);
+    std::uint64_t riffSize = this->headerByteCount - 8 + paddedDataByteCount;
+    bool isRf64 = (riffSize > MaximumRiffSize);
+
+    std::byte *target = this->header.data();
+
+    // RF64 files record 0xFFFFFFFF in all 32-bit size fields that overflowed
+    // and store the actual values in the 'ds64' chunk that follows the header
+    if(isRf64) {
+      target = writeFourCC(target, "RF64");
+      target = writeUInt32(target, 0xFFFFFFFFu);
+      target = writeFourCC(target, "WAVE");
+      target = writeFourCC(target, "ds64");
+      target = writeUInt32(target, Ds64ChunkLength);
+      target = writeUInt32(target, static_cast<std::uint32_t>(riffSize));
+      target = writeUInt32(target, static_cast<std::uint32_t>(riffSize >> 32));
+      target = writeUInt32(target, static_cast<std::uint32_t>(this->audioDataByteCount));
+      target = writeUInt32(target, static_cast<std::uint32_t>(this->audioDataByteCount >> 32));
+      target = writeUInt32(target, static_cast<std::uint32_t>(frameCount));
+      target = writeUInt32(target, static_cast<std::uint32_t>(frameCount >> 32));
+      target = writeUInt32(target, 0); // no size table for other chunks
+    } else {
+      target = writeFourCC(target, "RIFF");
+      target = writeUInt32(target, static_cast<std::uint32_t>(riffSize));
+      target = writeFourCC(target, "WAVE");
+      target = writeFourCC(target, "JUNK");
+      target = writeUInt32(target, Ds64ChunkLength);
+      target = std::fill_n(target, Ds64ChunkLength, std::byte(0));
+    }
+
+    target = writeFourCC(target, "fmt ");
+    target = writeUInt32(target, this->isExtensible ? 40 : 16);
+    target = writeUInt16(target, this->isExtensible ? WaveFormatExtensible : WaveFormatPcm);
+    target = writeUInt16(target, static_cast<std::uint16_t>(channelCount));
+    target = writeUInt32(target, static_cast<std::uint32_t>(this->sampleRate));
+    target = writeUInt32(target, static_cast<std::uint32_t>(this->sampleRate * bytesPerFrame));
+    target = writeUInt16(target, static_cast<std::uint16_t>(bytesPerFrame));
+    target = writeUInt16(target, static_cast<std::uint16_t>(this->bytesPerSample * 8));
+    if(this->isExtensible) {
+      target = writeUInt16(target, 22); // size of the WAVEFORMATEXTENSIBLE fields
+      target = writeUInt16(target, static_cast<std::uint16_t>(this->bytesPerSample * 8));
+      target = writeUInt32(target, static_cast<std::uint32_t>(this->channelPlacements));
+      target = std::copy_n(
+        isFloat ? WaveFormatSubTypeIeeeFloat : WaveFormatSubTypePcm, 16, target
+      );
+    }
+
+    // Anything that isn't integer PCM is supposed to come with a 'fact' chunk
+    if(isFloat) {
+      target = writeFourCC(target, "fact");
+      target = writeUInt32(target, 4);
+      target = writeUInt32(
+        target, isRf64 ? 0xFFFFFFFFu : static_cast<std::uint32_t>(frameCount)
+      );
+    }
+
+    target = writeFourCC(target, "data");
+    target = writeUInt32(
+      target, isRf64 ? 0xFFFFFFFFu : static_cast<std::uint32_t>(this->audioDataByteCount)
+    );
+
+    assert(
+      (target == this->header.data() + this->headerByteCount) &&
+      u8"Header size calculated in the constructor matches the written header"
+    );
+    (void)target;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
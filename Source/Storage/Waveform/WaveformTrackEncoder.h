@@ -0,0 +1,256 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMTRACKENCODER_H
+#define NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMTRACKENCODER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/SampleAllocator.h" // for SampleVector
+
+#include <array> // for std::array
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes audio channels into an uncompressed Waveform audio file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The file header is written with empty sizes when the encoder is created and
+  ///     rewritten in a single write once <see cref="Flush" /> knows the final length.
+  ///     Mono and stereo files with 8 or 16 bits per sample get a plain PCM 'fmt ' chunk,
+  ///     everything else uses WAVEFORMATEXTENSIBLE and records the channel mask.
+  ///   </para>
+  ///   <para>
+  ///     A 'JUNK' chunk reserves room for an RF64 'ds64' chunk in front of the 'fmt '
+  ///     chunk. Files that remain below 4 GiB keep it as padding and stay plain RIFF
+  ///     files. Larger files are turned into RF64 files when the header is rewritten by
+  ///     replacing the 'JUNK' chunk with a 'ds64' chunk holding the 64-bit sizes.
+  ///   </para>
+  ///   <para>
+  ///     If the samples are fed interleaved, in the Waveform channel order and in
+  ///     the same type they are stored as, they're written straight from the caller's
+  ///     buffer without passing through any intermediate buffer.
+  ///   </para>
+  /// </remarks>
+  class WaveformTrackEncoder : public AudioTrackEncoder {
+
+    /// <summary>Initializes a new Waveform audio track encoder</summary>
+    /// <param name="target">File into which the Waveform audio file will be written</param>
+    /// <param name="inputChannelOrder">Order in which the channels will be fed in</param>
+    /// <param name="sampleRate">Intended playback rate in samples per second</param>
+    /// <param name="sampleFormat">Format in which the samples will be stored</param>
+    public: WaveformTrackEncoder(
+      const std::shared_ptr<VirtualFile> &target,
+      const std::vector<ChannelPlacement> &inputChannelOrder,
+      std::size_t sampleRate,
+      AudioSampleFormat sampleFormat
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~WaveformTrackEncoder() override = default;
+
+    /// <summary>Retrieves the channel order the encoder expects its samples in</summary>
+    /// <returns>A list of channels in the order the encoder expects them</returns>
+    /// <remarks>
+    ///   This order is configured in the encode builder and applied to both the interleaved
+    ///   ingestion methods and the separated ingestion methods.
+    /// </remarks>
+    public: const std::vector<ChannelPlacement> &GetChannelOrder() const override;
+
+    /// <summary>Counts the bytes the encoder has written to its output so far</summary>
+    /// <returns>The number of bytes that have been written</returns>
+    public: std::uint64_t CountWrittenBytes() const override;
+
+    /// <summary>Updates the chunk sizes in the file header to cover all samples</summary>
+    public: void Flush() override;
+
+    /// <summary>Starts a new Waveform file in another output file</summary>
+    /// <param name="target">File into which the encoder will write from now on</param>
+    /// <returns>Always true, Waveform files can always be started over</returns>
+    protected: bool Reopen(const std::shared_ptr<VirtualFile> &target) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedUint8(
+      const std::uint8_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt16(
+      const std::int16_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedInt32(
+      const std::int32_t *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedFloat(
+      const float *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeInterleavedDouble(
+      const double *buffer, std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedUint8(
+      const std::uint8_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt16(
+      const std::int16_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedInt32(
+      const std::int32_t *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedFloat(
+      const float *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    protected: void EncodeSeparatedDouble(
+      const double *buffers[], std::size_t frameCount
+    ) override;
+
+    /// <summary>Encodes audio frames, interleaved, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeInterleaved(const TSample *buffer, std::size_t frameCount);
+
+    /// <summary>Encodes audio frames, separated, into the virtual file</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    private: template<typename TSample>
+    void encodeSeparated(const TSample *buffers[], std::size_t frameCount);
+
+    /// <summary>Converts interleaved samples into the stored format and writes them</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <typeparam name="TStored">Type the samples are written as</typeparam>
+    /// <param name="buffer">Buffer holding the samples that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    /// <param name="storedBitCount">Number of valid bits in the written samples</param>
+    private: template<typename TSample, typename TStored>
+    void encodeInterleavedAs(
+      const TSample *buffer, std::size_t frameCount, std::size_t storedBitCount
+    );
+
+    /// <summary>Converts separated samples into the stored format and writes them</summary>
+    /// <typeparam name="TSample">Type of samples that will be encoded</typeparam>
+    /// <typeparam name="TStored">Type the samples are written as</typeparam>
+    /// <param name="buffers">Buffer holding the channels that will be encoded</param>
+    /// <param name="frameCount">Number of audio frames that will be encoded</param>
+    /// <param name="storedBitCount">Number of valid bits in the written samples</param>
+    private: template<typename TSample, typename TStored>
+    void encodeSeparatedAs(
+      const TSample *buffers[], std::size_t frameCount, std::size_t storedBitCount
+    );
+
+    /// <summary>Writes interleaved samples in Waveform channel order to the file</summary>
+    /// <typeparam name="TStored">Type the samples are written as</typeparam>
+    /// <param name="samples">Samples that will be written, may be modified</param>
+    /// <param name="frameCount">Number of audio frames that will be written</param>
+    private: template<typename TStored>
+    void writeSamples(TStored *samples, std::size_t frameCount);
+
+    /// <summary>Appends raw audio data to the file's 'data' chunk</summary>
+    /// <param name="data">Audio data, already in the format stored in the file</param>
+    /// <param name="byteCount">Number of bytes that will be appended</param>
+    private: void appendAudioData(const std::byte *data, std::size_t byteCount);
+
+    /// <summary>Fills the header buffer with the RIFF, 'fmt ' and 'data' headers</summary>
+    /// <remarks>
+    ///   If the audio data has grown too large for a RIFF file, this writes an RF64
+    ///   header with a 'ds64' chunk in place of the reserved 'JUNK' chunk.
+    /// </remarks>
+    private: void buildHeader();
+
+    /// <summary>Largest header the encoder will ever write, in bytes</summary>
+    private: static constexpr std::size_t MaximumHeaderByteCount = 116;
+
+    /// <summary>File the Waveform audio data is written into</summary>
+    private: std::shared_ptr<VirtualFile> target;
+    /// <summary>Order in which the channels will be fed to the encoder</summary>
+    private: std::vector<ChannelPlacement> inputChannelOrder;
+    /// <summary>Index of the input channel for each channel in Waveform order</summary>
+    private: std::vector<std::size_t> inputChannelIndices;
+    /// <summary>Whether the input channels already are in Waveform order</summary>
+    private: bool isInWaveformOrder;
+    /// <summary>Channel mask that will be recorded in WAVEFORMATEXTENSIBLE</summary>
+    private: ChannelPlacement channelPlacements;
+    /// <summary>Intended playback rate in samples per second</summary>
+    private: std::size_t sampleRate;
+    /// <summary>Format in which the samples are stored in the file</summary>
+    private: AudioSampleFormat sampleFormat;
+    /// <summary>Number of bytes each stored sample occupies</summary>
+    private: std::size_t bytesPerSample;
+    /// <summary>Whether the 'fmt ' chunk uses the WAVEFORMATEXTENSIBLE layout</summary>
+    private: bool isExtensible;
+    /// <summary>Number of bytes in front of the audio data</summary>
+    private: std::size_t headerByteCount;
+    /// <summary>Number of bytes of audio data written so far</summary>
+    private: std::uint64_t audioDataByteCount;
+    /// <summary>File header, rebuilt with the final sizes when flushing</summary>
+    private: std::array<std::byte, MaximumHeaderByteCount> header;
+    /// <summary>Input samples converted to the stored format</summary>
+    private: SampleVector<std::byte> convertedSamples;
+    /// <summary>Converted samples interleaved in Waveform channel order</summary>
+    private: SampleVector<std::byte> orderedSamples;
+    /// <summary>Samples packed into 3 bytes each for 24-bit files</summary>
+    private: SampleVector<std::byte> packedSamples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
+
+#endif // NUCLEX_AUDIO_STORAGE_WAVEFORM_WAVEFORMTRACKENCODER_H
@@ -0,0 +1,187 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./WaveformTrackEncoderBuilder.h"
+#include "./WaveformTrackEncoder.h"
+
+#include "../Shared/ChannelOrderFactory.h" // for ChannelOrderFactory
+
+#include <limits> // for std::numeric_limits
+#include <set> // for std::set
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+
+#include <Nuclex/Support/BitTricks.h> // for BitTricks
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WaveformTrackEncoderBuilder::WaveformTrackEncoderBuilder() :
+    inputChannelOrder(),
+    sampleRate(),
+    sampleFormat(AudioSampleFormat::SignedInteger_16) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<
+    AudioSampleFormat
+  > &WaveformTrackEncoderBuilder::GetSupportedSampleFormats() const {
+    static const std::vector<AudioSampleFormat> supportedFormats = {
+      AudioSampleFormat::UnsignedInteger_8,
+      AudioSampleFormat::SignedInteger_16,
+      AudioSampleFormat::SignedInteger_24,
+      AudioSampleFormat::SignedInteger_32,
+      AudioSampleFormat::Float_32,
+      AudioSampleFormat::Float_64
+    };
+    return supportedFormats;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &WaveformTrackEncoderBuilder::GetSupportedSampleRates() const {
+    static const std::vector<std::size_t> supportedSampleRates; // empty vector = any
+    return supportedSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::vector<std::size_t> &WaveformTrackEncoderBuilder::GetPreferredSampleRates() const {
+    static const std::vector<std::size_t> preferredSampleRates; // empty vector = neutral
+    return preferredSampleRates;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChannelPlacement> WaveformTrackEncoderBuilder::GetPreferredChannelOrder(
+    ChannelPlacement channels
+  ) const {
+    std::size_t channelCount = Nuclex::Support::BitTricks::CountBits(
+      static_cast<std::size_t>(channels)
+    );
+    return Shared::ChannelOrderFactory::FromWaveformatExtensibleLayout(channelCount, channels);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WaveformTrackEncoderBuilder::SetSampleFormat(
+    AudioSampleFormat format /* = AudioSampleFormat::SignedInteger_16 */
+  ) {
+    switch(format) {
+      case AudioSampleFormat::UnsignedInteger_8:
+      case AudioSampleFormat::SignedInteger_16:
+      case AudioSampleFormat::SignedInteger_24:
+      case AudioSampleFormat::SignedInteger_32:
+      case AudioSampleFormat::Float_32:
+      case AudioSampleFormat::Float_64: {
+        this->sampleFormat = format;
+        break;
+      }
+      default: {
+        throw std::invalid_argument(
+          u8"Waveform encoder can only store 8, 16, 24 or 32 bit integer samples "
+          u8"or 32 and 64 bit floating point samples"
+        );
+      }
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WaveformTrackEncoderBuilder::SetSampleRate(
+    std::size_t samplesPerSecond /* = 48000 */
+  ) {
+    if(samplesPerSecond > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::invalid_argument(u8"Waveform files store the sample rate as a 32-bit value");
+    }
+
+    this->sampleRate = samplesPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WaveformTrackEncoderBuilder::SetChannels(
+    const std::vector<ChannelPlacement> &orderedChannels
+  ) {
+    std::set<ChannelPlacement> presentChannels(orderedChannels.begin(), orderedChannels.end());
+    if(presentChannels.size() != orderedChannels.size()) {
+      throw std::invalid_argument(u8"Each channel may only appear once in the channel order");
+    }
+
+    // The channel mask in WAVEFORMATEXTENSIBLE has one bit per speaker, so each
+    // channel must be exactly one known speaker position
+    for(ChannelPlacement channel : orderedChannels) {
+      std::size_t channelBits = static_cast<std::size_t>(channel);
+      if((channelBits == 0) || (Nuclex::Support::BitTricks::CountBits(channelBits) != 1)) {
+        throw std::invalid_argument(
+          u8"Each channel needs to be a single speaker placement to be stored in a Waveform file"
+        );
+      }
+    }
+
+    this->inputChannelOrder = orderedChannels;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WaveformTrackEncoderBuilder::SetTargetBitrate(
+    float kilobitsPerSecond
+  ) {
+    (void)kilobitsPerSecond;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AudioTrackEncoderBuilder &WaveformTrackEncoderBuilder::SetCompressionEffort(
+    float newEffort /* = 1.0f */
+  ) {
+    (void)newEffort;
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<AudioTrackEncoder> WaveformTrackEncoderBuilder::Build(
+    const std::shared_ptr<VirtualFile> &target
+  ) {
+    if(this->inputChannelOrder.empty()) {
+      throw std::runtime_error(
+        u8"Input channels and channel order for the encoder have not been set"
+      );
+    }
+    if(!this->sampleRate.has_value()) {
+      throw std::runtime_error(u8"Input sample rate for the encoder has not been set");
+    }
+
+    return std::make_shared<WaveformTrackEncoder>(
+      target, this->inputChannelOrder, this->sampleRate.value(), this->sampleFormat
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
@@ -0,0 +1,144 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+
+#include <algorithm> // for std::copy_n(), std::fill_n(), std::max()
+#include <cmath> // for std::ceil()
+#include <stdexcept> // for std::out_of_range, std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Smallest capacity the buffer will grow to</summary>
+  /// <remarks>
+  ///   Encoders begin by writing a small header, growing from there in doubling steps
+  ///   would waste several reallocations on the first few pages.
+  /// </remarks>
+  const std::size_t MinimumCapacity = 4096;
+
+  /// <summary>Bytes added to estimates to make room for headers and metadata</summary>
+  const std::size_t EstimatedHeaderByteCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WritableMemoryFile::EstimateByteCount(std::size_t bitsPerSecond, double seconds) {
+    if(unlikely(seconds < 0.0)) {
+      throw std::invalid_argument(u8"Duration must not be negative");
+    }
+
+    // Variable bitrate encoders wander around their average, 1/8th extra covers
+    // what they typically exceed it by over a whole file
+    double payloadByteCount = static_cast<double>(bitsPerSecond) * seconds / 8.0;
+    payloadByteCount += payloadByteCount / 8.0;
+
+    return static_cast<std::size_t>(std::ceil(payloadByteCount)) + EstimatedHeaderByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WritableMemoryFile::WritableMemoryFile(std::size_t capacity /* = 0 */) :
+    memory(),
+    capacity(0),
+    length(0) {
+    if(capacity > 0) {
+      Reserve(capacity);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WritableMemoryFile::Reserve(std::size_t byteCount) {
+    if(byteCount <= this->capacity) {
+      return;
+    }
+
+    // Default-initialized, so the new capacity isn't zeroed just to be overwritten
+    std::unique_ptr<std::byte[]> newMemory(new std::byte[byteCount]);
+    std::copy_n(this->memory.get(), this->length, newMemory.get());
+
+    this->memory = std::move(newMemory);
+    this->capacity = byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WritableMemoryFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    if(unlikely((start > this->length) || (this->length - start < byteCount))) {
+      throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+    }
+
+    std::copy_n(this->memory.get() + start, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WritableMemoryFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+    std::uint64_t end = start + byteCount;
+    if(unlikely(end > static_cast<std::uint64_t>(static_cast<std::size_t>(-1)))) {
+      throw std::out_of_range(u8"Memory file can not grow beyond the address space");
+    }
+
+    // Grow geometrically so that appending costs amortized constant time
+    if(end > this->capacity) {
+      Reserve(
+        std::max(
+          std::max(static_cast<std::size_t>(end), this->capacity * 2), MinimumCapacity
+        )
+      );
+    }
+
+    std::size_t startIndex = static_cast<std::size_t>(start);
+    if(startIndex > this->length) {
+      std::fill_n(this->memory.get() + this->length, startIndex - this->length, std::byte(0));
+    }
+    std::copy_n(buffer, byteCount, this->memory.get() + startIndex);
+
+    if(static_cast<std::size_t>(end) > this->length) {
+      this->length = static_cast<std::size_t>(end);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<std::byte[]> WritableMemoryFile::TakeContents(std::size_t &length) {
+    length = this->length;
+
+    this->capacity = 0;
+    this->length = 0;
+    return std::move(this->memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,158 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "WriteBehindFile.h"
+
+#include <algorithm> // for std::copy_n(), std::min(), std::max()
+#include <cassert> // for assert()
+#include <exception> // for std::exception
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WriteBehindFile::WriteBehindFile(
+    const std::shared_ptr<VirtualFile> &file, std::size_t bufferSize
+  ) :
+    file(file),
+    buffer(bufferSize),
+    bufferStart(0),
+    bufferLength(0) {
+    if(bufferSize == 0) {
+      throw std::invalid_argument(u8"Write-behind buffer size must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WriteBehindFile::~WriteBehindFile() {
+    try {
+      this->flushBuffer();
+    }
+    catch(const std::exception &) {
+      assert(!u8"Buffered data is written successfully when the file is destroyed");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WriteBehindFile::GetSize() const {
+    return std::max<std::uint64_t>(
+      this->file->GetSize(), this->bufferStart + this->bufferLength
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBehindFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::byte *buffer
+  ) const {
+    bool overlapsBuffer = (
+      (this->bufferLength > 0) &&
+      (start < this->bufferStart + this->bufferLength) &&
+      (start + byteCount > this->bufferStart)
+    );
+    if(overlapsBuffer) {
+      this->flushBuffer();
+    }
+
+    this->file->ReadAt(start, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBehindFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+  ) {
+
+    // If the write neither continues nor overwrites the buffered data, flush the buffer
+    // and start a new one. Writes that would leave a gap are passed through right away
+    // so the wrapped file can report the error.
+    bool continuesBuffer = (
+      (start >= this->bufferStart) && (start - this->bufferStart <= this->bufferLength)
+    );
+    if(!continuesBuffer) {
+      this->flushBuffer();
+      if(start > this->file->GetSize()) {
+        this->file->WriteAt(start, byteCount, buffer);
+        return;
+      }
+      this->bufferStart = start;
+    }
+
+    std::size_t blockSize = this->buffer.size();
+    while(byteCount > 0) {
+
+      // The buffer always ends at the next multiple of the block size, so that
+      // the wrapped file only sees aligned writes after the first block.
+      std::size_t capacity = blockSize - static_cast<std::size_t>(this->bufferStart % blockSize);
+
+      // If the buffer is empty and the write covers at least the whole block,
+      // write as many complete blocks as possible directly, without copying
+      if((this->bufferLength == 0) && (byteCount >= capacity)) {
+        std::size_t directByteCount = capacity + (byteCount - capacity) / blockSize * blockSize;
+        this->file->WriteAt(start, directByteCount, buffer);
+
+        start += directByteCount;
+        buffer += directByteCount;
+        byteCount -= directByteCount;
+        this->bufferStart = start;
+        continue;
+      }
+
+      // Copy as much as fits into the current block and write the block when it's full
+      std::size_t offset = static_cast<std::size_t>(start - this->bufferStart);
+      std::size_t chunkByteCount = std::min(byteCount, capacity - offset);
+      std::copy_n(buffer, chunkByteCount, this->buffer.data() + offset);
+      this->bufferLength = std::max(this->bufferLength, offset + chunkByteCount);
+      if(this->bufferLength == capacity) {
+        this->flushBuffer();
+        this->bufferStart += capacity;
+      }
+
+      start += chunkByteCount;
+      buffer += chunkByteCount;
+      byteCount -= chunkByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBehindFile::Flush() {
+    this->flushBuffer();
+    this->file->Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBehindFile::flushBuffer() const {
+    if(this->bufferLength > 0) {
+      std::size_t byteCount = this->bufferLength;
+      this->bufferLength = 0; // Don't write the same data again if WriteAt() throws
+      this->file->WriteAt(this->bufferStart, byteCount, this->buffer.data());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
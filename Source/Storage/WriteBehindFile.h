@@ -0,0 +1,105 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_STORAGE_WRITEBEHINDFILE_H
+#define NUCLEX_AUDIO_STORAGE_WRITEBEHINDFILE_H
+
+#include "Nuclex/Audio/Config.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects small, contiguous writes and passes them on in large blocks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Encoder libraries tend to write their output in small pieces (one Ogg page or
+  ///     one frame at a time). When each of these writes turns into a system call,
+  ///     the syscall overhead becomes a noticeable part of the encoding time.
+  ///   </para>
+  ///   <para>
+  ///     This decorator gathers writes that continue where the previous one ended
+  ///     (or overwrite data still in the buffer) and passes them on when the buffer
+  ///     reaches the next block boundary, so the wrapped file sees aligned, block-sized
+  ///     writes. Writes that are larger than the buffer are passed through directly.
+  ///   </para>
+  ///   <para>
+  ///     Buffered data is written when <see cref="Flush" /> is called and when
+  ///     the instance is destroyed. Since a destructor can't report errors,
+  ///     call <see cref="Flush" /> if you need to know that all data has been stored.
+  ///   </para>
+  /// </remarks>
+  class WriteBehindFile : public VirtualFile {
+
+    /// <summary>Initializes a new write-behind buffer around the specified file</summary>
+    /// <param name="file">File whose writes will be buffered</param>
+    /// <param name="bufferSize">Size of the blocks that will be written to the file</param>
+    public: WriteBehindFile(const std::shared_ptr<VirtualFile> &file, std::size_t bufferSize);
+
+    /// <summary>Writes any buffered data and frees all memory used by the instance</summary>
+    public: ~WriteBehindFile() override;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override;
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override;
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override;
+
+    /// <summary>Writes all buffered data to the wrapped file</summary>
+    public: void Flush() override;
+
+    /// <summary>Writes the buffered data to the wrapped file</summary>
+    /// <remarks>
+    ///   This is const because reads that overlap the buffer need to flush it first.
+    /// </remarks>
+    private: void flushBuffer() const;
+
+    /// <summary>File whose writes are being buffered</summary>
+    private: std::shared_ptr<VirtualFile> file;
+    /// <summary>Memory holding the data that has not been written yet</summary>
+    private: mutable std::vector<std::byte> buffer;
+    /// <summary>Absolute file offset at which the buffered data begins</summary>
+    private: mutable std::uint64_t bufferStart;
+    /// <summary>Number of bytes currently being held in the buffer</summary>
+    private: mutable std::size_t bufferLength;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
+
+#endif // NUCLEX_AUDIO_STORAGE_WRITEBEHINDFILE_H
@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_TRACEZONE_H
+#define NUCLEX_AUDIO_TRACEZONE_H
+
+#include "Nuclex/Audio/Config.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_TRACING)
+
+#include "Nuclex/Audio/TraceListener.h"
+
+#include <cstdint> // for std::uintptr_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reports a zone of work to the installed trace listener</summary>
+  /// <remarks>
+  ///   Don't use this directly, use the <see cref="NUCLEX_AUDIO_TRACE_ZONE" /> macro so
+  ///   the zone disappears from builds without tracing support.
+  /// </remarks>
+  class TraceZone {
+
+    /// <summary>Begins a zone if a trace listener is installed</summary>
+    /// <param name="name">Static name describing the kind of work</param>
+    /// <param name="file">File the work concerns, may be null</param>
+    /// <param name="track">Decoder or encoder doing the work, may be null</param>
+    public: TraceZone(const char *name, const void *file, const void *track) :
+      listener(TraceListener::GetInstalled()),
+      name(name),
+      fileId(reinterpret_cast<std::uintptr_t>(file)),
+      trackId(reinterpret_cast<std::uintptr_t>(track)) {
+      if(this->listener != nullptr) {
+        this->listener->BeginZone(this->name, this->fileId, this->trackId);
+      }
+    }
+
+    /// <summary>Ends the zone on the listener it was begun on</summary>
+    public: ~TraceZone() {
+      if(this->listener != nullptr) {
+        this->listener->EndZone(this->name, this->fileId, this->trackId);
+      }
+    }
+
+    /// <summary>Reports a marker if a trace listener is installed</summary>
+    /// <param name="name">Static name describing the event</param>
+    /// <param name="file">File the event concerns, may be null</param>
+    /// <param name="track">Decoder or encoder involved, may be null</param>
+    public: static void Mark(const char *name, const void *file, const void *track) {
+      TraceListener *listener = TraceListener::GetInstalled();
+      if(listener != nullptr) {
+        listener->Mark(
+          name, reinterpret_cast<std::uintptr_t>(file), reinterpret_cast<std::uintptr_t>(track)
+        );
+      }
+    }
+
+    /// <summary>Listener the zone was begun on, null if there was none</summary>
+    private: TraceListener *listener;
+    /// <summary>Static name describing the kind of work</summary>
+    private: const char *name;
+    /// <summary>Id of the file the work concerns</summary>
+    private: std::uintptr_t fileId;
+    /// <summary>Id of the decoder or encoder doing the work</summary>
+    private: std::uintptr_t trackId;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+// Pastes two tokens together after expanding them, needed to build zone variable names
+#define NUCLEX_AUDIO_TRACE_CONCAT_INNER(left, right) left ## right
+#define NUCLEX_AUDIO_TRACE_CONCAT(left, right) NUCLEX_AUDIO_TRACE_CONCAT_INNER(left, right)
+
+// Opens a zone that lasts until the end of the enclosing scope
+#define NUCLEX_AUDIO_TRACE_ZONE(name, file, track) \
+  ::Nuclex::Audio::TraceZone NUCLEX_AUDIO_TRACE_CONCAT(traceZone, __LINE__)(name, file, track)
+
+// Reports a marker, an event that took no time in itself
+#define NUCLEX_AUDIO_TRACE_MARK(name, file, track) \
+  ::Nuclex::Audio::TraceZone::Mark(name, file, track)
+
+#else // !defined(NUCLEX_AUDIO_HAVE_TRACING)
+
+// Without tracing support, zones and markers vanish, including their arguments
+#define NUCLEX_AUDIO_TRACE_ZONE(name, file, track) static_cast<void>(0)
+#define NUCLEX_AUDIO_TRACE_MARK(name, file, track) static_cast<void>(0)
+
+#endif // defined(NUCLEX_AUDIO_HAVE_TRACING)
+
+#endif // NUCLEX_AUDIO_TRACEZONE_H
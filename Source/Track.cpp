@@ -22,11 +22,57 @@ License along with this library
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Track.h"
+#include "Nuclex/Audio/SampleAllocator.h"
+
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <new> // for std::bad_array_new_length
+#include <stdexcept> // for std::invalid_argument
+#include <utility> // for std::move()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of samples that fit into one aligned block of memory</summary>
+  constexpr std::size_t SamplesPerAlignment = (
+    Nuclex::Audio::SampleAllocator::Alignment / sizeof(float)
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
 
 namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Block of sample memory that is returned to its allocator when released</summary>
+  struct Track::SampleStorage {
+
+    /// <summary>Allocates a block of sample memory from the global allocator</summary>
+    /// <param name="byteCount">Size of the block in bytes</param>
+    public: SampleStorage(std::size_t byteCount) :
+      Allocator(&SampleAllocator::GetGlobal()),
+      Samples(static_cast<float *>(this->Allocator->Allocate(byteCount))),
+      ByteCount(byteCount) {}
+
+    /// <summary>Returns the block of memory to the allocator it came from</summary>
+    public: ~SampleStorage() {
+      this->Allocator->Free(this->Samples, this->ByteCount);
+    }
+
+    /// <summary>Allocator that provided the memory holding the samples</summary>
+    public: SampleAllocator *Allocator;
+    /// <summary>Memory holding all of a track's samples</summary>
+    public: float *Samples;
+    /// <summary>Size of the memory block holding the samples in bytes</summary>
+    public: std::size_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   void TrackBase::SetName(
     const std::optional<std::string> &newName /* = std::optional<std::string>() */
   ) {
@@ -43,4 +89,204 @@ namespace Nuclex { namespace Audio {
 
   // ------------------------------------------------------------------------------------------- //
 
+  Track::Track() :
+    channelCount(0),
+    frameCount(0),
+    sampleRate(0),
+    layout(SampleLayout::Interleaved),
+    channelOrder(),
+    channelSpacing(1),
+    storage(),
+    samples(nullptr) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track::Track(
+    std::size_t channelCount,
+    std::uint64_t frameCount,
+    std::size_t sampleRate,
+    SampleLayout layout /* = SampleLayout::Interleaved */,
+    const std::vector<ChannelPlacement> &channelOrder /* = std::vector<ChannelPlacement>() */
+  ) :
+    channelCount(channelCount),
+    frameCount(0),
+    sampleRate(sampleRate),
+    layout(layout),
+    channelOrder(channelOrder),
+    channelSpacing(1),
+    storage(),
+    samples(nullptr) {
+    if(unlikely(channelCount == 0)) {
+      throw std::invalid_argument(u8"Audio tracks need to have at least one channel");
+    }
+    if(this->channelOrder.empty()) {
+      this->channelOrder.resize(channelCount, ChannelPlacement::Unknown);
+    } else if(unlikely(this->channelOrder.size() != channelCount)) {
+      throw std::invalid_argument(u8"Channel order must list exactly one entry per channel");
+    }
+
+    // Work out how many samples the track will hold. Separated channels are padded
+    // so that each can be processed with aligned loads from its first sample on.
+    const std::size_t maximumSampleCount = (
+      std::numeric_limits<std::size_t>::max() / sizeof(float) - SamplesPerAlignment
+    );
+    if(unlikely(frameCount > maximumSampleCount / channelCount)) {
+      throw std::bad_array_new_length();
+    }
+    this->frameCount = static_cast<std::size_t>(frameCount);
+
+    std::size_t sampleCount;
+    if(layout == SampleLayout::Separated) {
+      this->channelSpacing = (
+        (this->frameCount + SamplesPerAlignment - 1) / SamplesPerAlignment * SamplesPerAlignment
+      );
+      if(unlikely(this->channelSpacing > maximumSampleCount / channelCount)) {
+        throw std::bad_array_new_length();
+      }
+      sampleCount = this->channelSpacing * channelCount;
+    } else {
+      sampleCount = this->frameCount * channelCount;
+    }
+
+    if(sampleCount > 0) {
+      this->storage = std::make_shared<SampleStorage>(sampleCount * sizeof(float));
+      this->samples = this->storage->Samples;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track::Track(Track &&other) noexcept :
+    TrackBase(std::move(other)),
+    channelCount(other.channelCount),
+    frameCount(other.frameCount),
+    sampleRate(other.sampleRate),
+    layout(other.layout),
+    channelOrder(std::move(other.channelOrder)),
+    channelSpacing(other.channelSpacing),
+    storage(std::move(other.storage)),
+    samples(other.samples) {
+    other.channelCount = 0;
+    other.frameCount = 0;
+    other.channelSpacing = 1;
+    other.storage.reset();
+    other.samples = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track::~Track() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track &Track::operator =(Track &&other) noexcept {
+    if(this != &other) {
+      TrackBase::operator =(std::move(other));
+      this->channelCount = other.channelCount;
+      this->frameCount = other.frameCount;
+      this->sampleRate = other.sampleRate;
+      this->layout = other.layout;
+      this->channelOrder = std::move(other.channelOrder);
+      this->channelSpacing = other.channelSpacing;
+      this->storage = std::move(other.storage);
+      this->samples = other.samples;
+
+      other.channelCount = 0;
+      other.frameCount = 0;
+      other.channelSpacing = 1;
+      other.storage.reset();
+      other.samples = nullptr;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float *Track::GetSamples() {
+    makeSamplesUnique();
+    return this->samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Channel<float> Track::GetChannel(std::size_t channelIndex) {
+    if(unlikely(channelIndex >= this->channelCount)) {
+      throw std::out_of_range(u8"Channel index out of range");
+    }
+
+    makeSamplesUnique();
+
+    if(this->layout == SampleLayout::Separated) {
+      return Channel<float>(
+        this->samples + channelIndex * this->channelSpacing, this->frameCount, 1,
+        this->channelOrder[channelIndex]
+      );
+    } else {
+      return Channel<float>(
+        this->samples + channelIndex, this->frameCount, this->channelCount,
+        this->channelOrder[channelIndex]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Channel<const float> Track::GetChannel(std::size_t channelIndex) const {
+    if(unlikely(channelIndex >= this->channelCount)) {
+      throw std::out_of_range(u8"Channel index out of range");
+    }
+
+    if(this->layout == SampleLayout::Separated) {
+      return Channel<const float>(
+        this->samples + channelIndex * this->channelSpacing, this->frameCount, 1,
+        this->channelOrder[channelIndex]
+      );
+    } else {
+      return Channel<const float>(
+        this->samples + channelIndex, this->frameCount, this->channelCount,
+        this->channelOrder[channelIndex]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Track Track::Clone() const {
+    Track clone;
+    static_cast<TrackBase &>(clone) = static_cast<const TrackBase &>(*this);
+    clone.channelCount = this->channelCount;
+    clone.frameCount = this->frameCount;
+    clone.sampleRate = this->sampleRate;
+    clone.layout = this->layout;
+    clone.channelOrder = this->channelOrder;
+    clone.channelSpacing = this->channelSpacing;
+    clone.storage = this->storage;
+    clone.samples = this->samples;
+
+    return clone;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Track::IsShared() const {
+    return static_cast<bool>(this->storage) && (this->storage.use_count() > 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Track::makeSamplesUnique() {
+    if(IsShared()) {
+      std::shared_ptr<SampleStorage> copy = std::make_shared<SampleStorage>(
+        this->storage->ByteCount
+      );
+      std::memcpy(copy->Samples, this->storage->Samples, this->storage->ByteCount);
+
+      this->storage = std::move(copy);
+      this->samples = this->storage->Samples;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Audio
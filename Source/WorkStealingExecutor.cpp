@@ -0,0 +1,327 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/WorkStealingExecutor.h"
+#include "Platform/ProcessorTopology.h"
+
+#include <algorithm> // for std::max()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <deque> // for std::deque
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <utility> // for std::pair
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of priority levels tasks can be submitted with</summary>
+  constexpr std::size_t PriorityCount = 4;
+
+  /// <summary>Processor index of workers that should not be pinned</summary>
+  constexpr std::size_t NoProcessor = std::numeric_limits<std::size_t>::max();
+
+  /// <summary>Task queues of a single worker, one per priority</summary>
+  struct WorkerQueue {
+
+    /// <summary>Must be held while accessing the queued tasks</summary>
+    public: std::mutex Mutex;
+    /// <summary>Queued tasks, indexed by their priority</summary>
+    public: std::deque<std::function<void()>> Tasks[PriorityCount];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shared state of the executor whose worker is running on this thread</summary>
+  thread_local const void *currentState = nullptr;
+
+  /// <summary>Index of the worker running on the current thread</summary>
+  thread_local std::size_t currentWorkerIndex = 0;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct WorkStealingExecutor::SharedState {
+
+    /// <summary>Initializes the shared state for the specified number of workers</summary>
+    /// <param name="queueCount">Number of workers that will each get a queue</param>
+    public: explicit SharedState(std::size_t queueCount) :
+      Queues(new WorkerQueue[queueCount]),
+      StealOrder(queueCount),
+      QueueCount(queueCount),
+      NextQueueIndex(0),
+      StolenTaskCount(0),
+      WakeMutex(),
+      WakeCondition(),
+      QueuedTaskCount(0),
+      Stopping(false) {}
+
+    /// <summary>Takes the next task, either from the worker's queue or another one's</summary>
+    /// <param name="workerIndex">Index of the worker that is looking for work</param>
+    /// <param name="task">Receives the task if one was found</param>
+    /// <returns>True if a task was taken, false if all queues were empty</returns>
+    public: bool TryTake(std::size_t workerIndex, std::function<void()> &task);
+
+    /// <summary>Task queues of all workers</summary>
+    public: std::unique_ptr<WorkerQueue[]> Queues;
+    /// <summary>Order in which each worker visits the other workers' queues to steal</summary>
+    public: std::vector<std::vector<std::size_t>> StealOrder;
+    /// <summary>Number of task queues, equal to the number of workers</summary>
+    public: std::size_t QueueCount;
+    /// <summary>Queue that will receive the next task submitted from outside</summary>
+    public: std::atomic<std::size_t> NextQueueIndex;
+    /// <summary>Number of tasks that were stolen from another worker's queue</summary>
+    public: std::atomic<std::uint64_t> StolenTaskCount;
+    /// <summary>Must be held while updating the queued task count or stopping flag</summary>
+    public: std::mutex WakeMutex;
+    /// <summary>Wakes sleeping workers up when a task is submitted or the pool stops</summary>
+    public: std::condition_variable WakeCondition;
+    /// <summary>Number of tasks in all queues that no worker has taken yet</summary>
+    public: std::size_t QueuedTaskCount;
+    /// <summary>Set when the workers should shut down once all queues are empty</summary>
+    public: bool Stopping;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WorkStealingExecutor::SharedState::TryTake(
+    std::size_t workerIndex, std::function<void()> &task
+  ) {
+    for(std::size_t priority = 0; priority < PriorityCount; ++priority) {
+      {
+        WorkerQueue &ownQueue = this->Queues[workerIndex];
+        std::lock_guard<std::mutex> queueMutexScope(ownQueue.Mutex);
+        std::deque<std::function<void()>> &tasks = ownQueue.Tasks[priority];
+        if(!tasks.empty()) {
+          task = std::move(tasks.front());
+          tasks.pop_front();
+          return true;
+        }
+      }
+
+      // Our own queue has nothing of this priority, steal from the back of the other
+      // workers' queues, where the tasks least likely to be needed soon by them are
+      const std::vector<std::size_t> &victims = this->StealOrder[workerIndex];
+      for(std::size_t victimIndex = 0; victimIndex < victims.size(); ++victimIndex) {
+        WorkerQueue &victimQueue = this->Queues[victims[victimIndex]];
+        std::lock_guard<std::mutex> queueMutexScope(victimQueue.Mutex);
+        std::deque<std::function<void()>> &tasks = victimQueue.Tasks[priority];
+        if(!tasks.empty()) {
+          task = std::move(tasks.back());
+          tasks.pop_back();
+          this->StolenTaskCount.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WorkStealingExecutor::WorkStealingExecutor(
+    std::size_t threadCount /* = 0 */,
+    WorkerPlacement placement /* = WorkerPlacement::Unpinned */
+  ) :
+    state(),
+    threads(),
+    placement(placement),
+    workerNodes() {
+
+    if(threadCount == 0) {
+      threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // Decide which processor each worker goes to. Compact placement walks the nodes
+    // one after another, spread placement takes turns between the nodes. If there are
+    // more workers than processors, the placement wraps around.
+    std::vector<std::size_t> processors(threadCount, NoProcessor);
+    this->workerNodes.resize(threadCount, 0);
+    if(placement != WorkerPlacement::Unpinned) {
+      std::vector<std::vector<std::size_t>> nodes = (
+        Platform::ProcessorTopology::GetProcessorsByNode()
+      );
+
+      std::vector<std::pair<std::size_t, std::size_t>> order; // node, processor
+      if(placement == WorkerPlacement::Compact) {
+        for(std::size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) {
+          for(std::size_t processor : nodes[nodeIndex]) {
+            order.emplace_back(nodeIndex, processor);
+          }
+        }
+      } else {
+        for(std::size_t round = 0; order.size() < threadCount; ++round) {
+          bool anyLeft = false;
+          for(std::size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) {
+            if(round < nodes[nodeIndex].size()) {
+              order.emplace_back(nodeIndex, nodes[nodeIndex][round]);
+              anyLeft = true;
+            }
+          }
+          if(!anyLeft) {
+            break;
+          }
+        }
+      }
+
+      for(std::size_t index = 0; index < threadCount; ++index) {
+        const std::pair<std::size_t, std::size_t> &slot = order[index % order.size()];
+        this->workerNodes[index] = slot.first;
+        processors[index] = slot.second;
+      }
+    }
+
+    // Workers steal from their own node first so tasks and their data stay local
+    this->state = std::make_shared<SharedState>(threadCount);
+    for(std::size_t workerIndex = 0; workerIndex < threadCount; ++workerIndex) {
+      std::vector<std::size_t> &victims = this->state->StealOrder[workerIndex];
+      victims.reserve(threadCount - 1);
+      for(int pass = 0; pass < 2; ++pass) {
+        for(std::size_t offset = 1; offset < threadCount; ++offset) {
+          std::size_t victimIndex = (workerIndex + offset) % threadCount;
+          bool isSameNode = (this->workerNodes[victimIndex] == this->workerNodes[workerIndex]);
+          if(isSameNode == (pass == 0)) {
+            victims.push_back(victimIndex);
+          }
+        }
+      }
+    }
+
+    this->threads.reserve(threadCount);
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      this->threads.emplace_back(
+        &WorkStealingExecutor::runWorker, this->state, index, processors[index]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+      std::lock_guard<std::mutex> wakeMutexScope(this->state->WakeMutex);
+      this->state->Stopping = true;
+    }
+    this->state->WakeCondition.notify_all();
+
+    // If a task dropped the last reference to the executor, we're running on one of
+    // its workers. That worker can't join itself, it will exit on its own once it
+    // returns from the task and finds the queues empty.
+    for(std::size_t index = 0; index < this->threads.size(); ++index) {
+      if(this->threads[index].get_id() == std::this_thread::get_id()) {
+        this->threads[index].detach();
+      } else {
+        this->threads[index].join();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WorkStealingExecutor::CountStolenTasks() const {
+    return this->state->StolenTaskCount.load(std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WorkStealingExecutor::Submit(
+    std::function<void()> task, TaskPriority priority /* = TaskPriority::Normal */
+  ) {
+    SharedState &shared = *this->state;
+
+    // Tasks submitted by our own workers stay with that worker, because they're
+    // usually part of the work it is doing and use the same data
+    std::size_t queueIndex;
+    if(currentState == &shared) {
+      queueIndex = currentWorkerIndex;
+    } else {
+      queueIndex = (
+        shared.NextQueueIndex.fetch_add(1, std::memory_order_relaxed) % shared.QueueCount
+      );
+    }
+
+    {
+      WorkerQueue &queue = shared.Queues[queueIndex];
+      std::lock_guard<std::mutex> queueMutexScope(queue.Mutex);
+      queue.Tasks[static_cast<std::size_t>(priority)].push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> wakeMutexScope(shared.WakeMutex);
+      ++shared.QueuedTaskCount;
+    }
+    shared.WakeCondition.notify_one();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WorkStealingExecutor::runWorker(
+    const std::shared_ptr<SharedState> &state,
+    std::size_t workerIndex,
+    std::size_t processorIndex
+  ) {
+    if(processorIndex != NoProcessor) {
+      Platform::ProcessorTopology::TryPinCurrentThread(processorIndex);
+    }
+
+    SharedState &shared = *state;
+    currentState = &shared;
+    currentWorkerIndex = workerIndex;
+
+    for(;;) {
+      {
+        std::function<void()> task;
+        if(shared.TryTake(workerIndex, task)) {
+          {
+            std::lock_guard<std::mutex> wakeMutexScope(shared.WakeMutex);
+            --shared.QueuedTaskCount;
+          }
+          task();
+          continue;
+        }
+      }
+
+      // Nothing to do, sleep until a task is submitted. When stopping, the workers
+      // keep going until all queues are empty.
+      std::unique_lock<std::mutex> wakeMutexScope(shared.WakeMutex);
+      if(shared.Stopping && (shared.QueuedTaskCount == 0)) {
+        currentState = nullptr;
+        return;
+      }
+      shared.WakeCondition.wait(
+        wakeMutexScope,
+        [&shared]() { return shared.Stopping || (shared.QueuedTaskCount > 0); }
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
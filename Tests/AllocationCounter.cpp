@@ -0,0 +1,171 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "./AllocationCounter.h"
+
+#include <cstdlib> // for std::malloc(), std::free(), std::aligned_alloc()
+#include <new> // for std::bad_alloc, std::align_val_t
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include <malloc.h> // for ::_aligned_malloc(), ::_aligned_free()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of allocations the current thread has made so far</summary>
+  thread_local std::size_t threadAllocationCount = 0;
+
+  /// <summary>Number of bytes the current thread has allocated so far</summary>
+  thread_local std::size_t threadAllocatedByteCount = 0;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records an allocation in the current thread's tally</summary>
+  /// <param name="byteCount">Number of bytes that have been requested</param>
+  void noteAllocation(std::size_t byteCount) noexcept {
+    ++threadAllocationCount;
+    threadAllocatedByteCount += byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates memory with the requested alignment from the C runtime</summary>
+  /// <param name="byteCount">Number of bytes that will be allocated</param>
+  /// <param name="alignment">Alignment the memory needs to have</param>
+  /// <returns>The allocated memory or a null pointer if none was available</returns>
+  void *allocateAligned(std::size_t byteCount, std::size_t alignment) noexcept {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    return ::_aligned_malloc((byteCount == 0) ? 1 : byteCount, alignment);
+#else
+    // aligned_alloc() requires the size to be a multiple of the alignment
+    std::size_t roundedByteCount = (byteCount + alignment - 1) / alignment * alignment;
+    if(roundedByteCount == 0) {
+      roundedByteCount = alignment;
+    }
+    return std::aligned_alloc(alignment, roundedByteCount);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees memory that was obtained through allocateAligned()</summary>
+  /// <param name="memory">Memory that will be freed</param>
+  void freeAligned(void *memory) noexcept {
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    ::_aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+// The default array and nothrow variants all forward to these, so replacing them is
+// enough to see every allocation made through operator new. The sized deletes are
+// replaced, too, because compilers warn when they don't match the unsized ones.
+
+// --------------------------------------------------------------------------------------------- //
+
+void *operator new(std::size_t byteCount) {
+  noteAllocation(byteCount);
+
+  void *memory = std::malloc((byteCount == 0) ? 1 : byteCount);
+  if(memory == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return memory;
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+void *operator new(std::size_t byteCount, std::align_val_t alignment) {
+  noteAllocation(byteCount);
+
+  void *memory = allocateAligned(byteCount, static_cast<std::size_t>(alignment));
+  if(memory == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return memory;
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+  freeAligned(memory);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+  freeAligned(memory);
+}
+
+// --------------------------------------------------------------------------------------------- //
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationCounter::AllocationCounter() :
+    startAllocationCount(threadAllocationCount),
+    startByteCount(threadAllocatedByteCount) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AllocationCounter::CountAllocations() const {
+    return threadAllocationCount - this->startAllocationCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AllocationCounter::CountAllocatedBytes() const {
+    return threadAllocatedByteCount - this->startByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationCounter::Reset() {
+    this->startAllocationCount = threadAllocationCount;
+    this->startByteCount = threadAllocatedByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
@@ -0,0 +1,80 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+#ifndef NUCLEX_AUDIO_ALLOCATIONCOUNTER_H
+#define NUCLEX_AUDIO_ALLOCATIONCOUNTER_H
+
+#include "Nuclex/Audio/Config.h"
+
+#include <cstddef> // for std::size_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the heap allocations the current thread makes while it exists</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The test executable replaces the global operator new and delete with versions
+  ///     that keep a per-thread tally of all allocations before forwarding to the C
+  ///     runtime. This counter takes a snapshot of the tally when it is created and
+  ///     reports everything that happened on the same thread since.
+  ///   </para>
+  ///   <para>
+  ///     Memory the codec libraries obtain via malloc() directly is not seen, only
+  ///     allocations through operator new (including the library's default sample
+  ///     allocator) are. That is precisely what's needed to check that the library's
+  ///     own decoding paths do not allocate once they have warmed up.
+  ///   </para>
+  ///   <para>
+  ///     <code>
+  ///       AllocationCounter counter;
+  ///       decoder->DecodeInterleaved(samples, 1024, 1024);
+  ///       EXPECT_EQ(counter.CountAllocations(), 0U);
+  ///     </code>
+  ///   </para>
+  /// </remarks>
+  class AllocationCounter {
+
+    /// <summary>Initializes a new allocation counter starting from zero</summary>
+    public: AllocationCounter();
+
+    /// <summary>Counts the allocations since the counter was created or reset</summary>
+    /// <returns>The number of allocations made by the current thread</returns>
+    public: std::size_t CountAllocations() const;
+
+    /// <summary>Counts the bytes allocated since the counter was created or reset</summary>
+    /// <returns>The number of bytes allocated by the current thread</returns>
+    public: std::size_t CountAllocatedBytes() const;
+
+    /// <summary>Starts counting from zero again</summary>
+    public: void Reset();
+
+    /// <summary>Number of allocations the thread had made when counting started</summary>
+    private: std::size_t startAllocationCount;
+    /// <summary>Number of bytes the thread had allocated when counting started</summary>
+    private: std::size_t startByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
+
+#endif // NUCLEX_AUDIO_ALLOCATIONCOUNTER_H
@@ -0,0 +1,120 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/AllocationScope.h"
+#include "Nuclex/Audio/SampleAllocator.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "./Storage/ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample allocator that records the allocation tag of each allocation</summary>
+  class TagRecordingSampleAllocator : public Nuclex::Audio::SampleAllocator {
+
+    /// <summary>Allocates a block of memory aligned to 64 bytes</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The address of the allocated memory</returns>
+    public: void *Allocate(std::size_t byteCount) override {
+      this->Tags.push_back(Nuclex::Audio::AllocationScope::GetCurrent());
+      return ::operator new(byteCount, std::align_val_t(Alignment));
+    }
+
+    /// <summary>Frees a block of memory that was obtained through Allocate()</summary>
+    /// <param name="memory">Address of the memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: void Free(void *memory, std::size_t byteCount) noexcept override {
+      (void)byteCount;
+      ::operator delete(memory, std::align_val_t(Alignment));
+    }
+
+    /// <summary>Tags that were active when each allocation was made</summary>
+    public: std::vector<Nuclex::Audio::AllocationTag> Tags;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationScopeTest, AllocationsOutsideOfScopesAreUnattributed) {
+    AllocationTag tag = AllocationScope::GetCurrent();
+    EXPECT_EQ(tag.Subsystem, AllocationSubsystem::Unattributed);
+    EXPECT_EQ(tag.Codec, AllocationCodec::None);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationScopeTest, InnermostScopeWins) {
+    {
+      AllocationScope libraryScope(AllocationSubsystem::CodecLibrary, AllocationCodec::Opus);
+      EXPECT_EQ(AllocationScope::GetCurrent().Subsystem, AllocationSubsystem::CodecLibrary);
+      {
+        AllocationScope scratchScope(AllocationSubsystem::ReaderScratch);
+        EXPECT_EQ(AllocationScope::GetCurrent().Subsystem, AllocationSubsystem::ReaderScratch);
+        EXPECT_EQ(AllocationScope::GetCurrent().Codec, AllocationCodec::Opus);
+      }
+      EXPECT_EQ(AllocationScope::GetCurrent().Subsystem, AllocationSubsystem::CodecLibrary);
+    }
+
+    EXPECT_EQ(AllocationScope::GetCurrent().Subsystem, AllocationSubsystem::Unattributed);
+    EXPECT_EQ(AllocationScope::GetCurrent().Codec, AllocationCodec::None);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationScopeTest, DecoderScratchBuffersAreTagged) {
+    TagRecordingSampleAllocator allocator;
+    SampleAllocator::SetGlobal(&allocator);
+    {
+      std::shared_ptr<const Storage::VirtualFile> file = (
+        Storage::VirtualFile::OpenRealFileForReading(
+          GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+        )
+      );
+
+      Storage::Waveform::WaveformTrackDecoder decoder(file);
+      std::vector<std::int16_t> samples(256 * decoder.CountChannels());
+      decoder.DecodeInterleaved(samples.data(), 0, 256);
+    }
+    SampleAllocator::SetGlobal(nullptr);
+
+    ASSERT_FALSE(allocator.Tags.empty());
+    for(const AllocationTag &tag : allocator.Tags) {
+      EXPECT_EQ(tag.Subsystem, AllocationSubsystem::ReaderScratch);
+      EXPECT_EQ(tag.Codec, AllocationCodec::Waveform);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
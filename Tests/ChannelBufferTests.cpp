@@ -0,0 +1,92 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/ChannelBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t, std::int16_t
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelBufferTest, StartsOutSilentAndAligned) {
+    ChannelBuffer<std::uint8_t> unsignedChannel(100, ChannelPlacement::FrontLeft);
+    ChannelBuffer<float> floatChannel(100, ChannelPlacement::FrontRight);
+
+    EXPECT_EQ(unsignedChannel.CountFrames(), 100U);
+    EXPECT_EQ(unsignedChannel.GetNativeSampleFormat(), AudioSampleFormat::UnsignedInteger_8);
+    EXPECT_EQ(floatChannel.GetNativeSampleFormat(), AudioSampleFormat::Float_32);
+    EXPECT_EQ(floatChannel.GetPlacement(), ChannelPlacement::FrontRight);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(floatChannel.GetSamples()) % 64, 0U);
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      EXPECT_EQ(unsignedChannel[index], 128U);
+      EXPECT_EQ(floatChannel[index], 0.0f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelBufferTest, ViewSharesSamplesWithBuffer) {
+    ChannelBuffer<float> channel(10, ChannelPlacement::FrontCenter);
+
+    Channel<float> view = channel.GetView();
+    EXPECT_EQ(view.GetSamples(), channel.GetSamples());
+    EXPECT_EQ(view.CountFrames(), 10U);
+    EXPECT_EQ(view.GetStride(), 1U);
+    EXPECT_EQ(view.GetPlacement(), ChannelPlacement::FrontCenter);
+
+    view[3] = 0.5f;
+    EXPECT_EQ(channel[3], 0.5f);
+
+    const ChannelBuffer<float> &constantChannel = channel;
+    Channel<const float> constantView = constantChannel.GetView();
+    EXPECT_EQ(constantView[3], 0.5f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelBufferTest, CanBeConvertedToOtherSampleType) {
+    ChannelBuffer<float> channel(3, ChannelPlacement::LowFrequencyEffects);
+    channel[0] = -1.0f;
+    channel[1] = 0.0f;
+    channel[2] = 1.0f;
+
+    ChannelBuffer<std::int16_t> converted = channel.ConvertTo<std::int16_t>();
+    EXPECT_EQ(converted.GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_16);
+    EXPECT_EQ(converted.GetPlacement(), ChannelPlacement::LowFrequencyEffects);
+    ASSERT_EQ(converted.CountFrames(), 3U);
+    EXPECT_EQ(converted[0], -32767);
+    EXPECT_EQ(converted[1], 0);
+    EXPECT_EQ(converted[2], 32767);
+
+    // Converting to the same type just makes a copy
+    ChannelBuffer<float> copy = channel.ConvertTo<float>();
+    EXPECT_NE(copy.GetSamples(), channel.GetSamples());
+    EXPECT_EQ(copy[2], 1.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
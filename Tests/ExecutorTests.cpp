@@ -0,0 +1,162 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Executor.h"
+#include "Nuclex/Audio/WorkStealingExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, DefaultExecutorIsCreatedOnDemand) {
+    std::shared_ptr<Executor> executor = Executor::GetInstalled();
+    ASSERT_TRUE(static_cast<bool>(executor));
+    EXPECT_GE(executor->CountWorkers(), 1U);
+    EXPECT_EQ(Executor::GetInstalled(), executor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, InstalledExecutorReplacesDefault) {
+    std::shared_ptr<Executor> executor = std::make_shared<WorkStealingExecutor>(2);
+
+    Executor::Install(executor);
+    EXPECT_EQ(Executor::GetInstalled(), executor);
+
+    Executor::Install(std::shared_ptr<Executor>());
+    EXPECT_NE(Executor::GetInstalled(), executor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, ParallelForRunsEveryIndexOnce) {
+    WorkStealingExecutor executor(4);
+
+    std::vector<std::atomic<int>> runCounts(1000);
+    executor.ParallelFor(
+      runCounts.size(),
+      [&runCounts](std::size_t index) { runCounts[index].fetch_add(1); }
+    );
+
+    for(std::size_t index = 0; index < runCounts.size(); ++index) {
+      EXPECT_EQ(runCounts[index].load(), 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, ParallelForRethrowsExceptions) {
+    WorkStealingExecutor executor(2);
+
+    EXPECT_THROW(
+      executor.ParallelFor(
+        100,
+        [](std::size_t index) {
+          if(index == 50) {
+            throw std::runtime_error(u8"Test exception");
+          }
+        }
+      ),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, NestedParallelForDoesNotDeadlock) {
+    WorkStealingExecutor executor(1);
+
+    std::atomic<std::size_t> innerRunCount(0);
+    executor.ParallelFor(
+      8,
+      [&executor, &innerRunCount](std::size_t) {
+        executor.ParallelFor(
+          8, [&innerRunCount](std::size_t) { innerRunCount.fetch_add(1); }
+        );
+      }
+    );
+
+    EXPECT_EQ(innerRunCount.load(), 64U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, PinnedWorkersRunTasks) {
+    WorkerPlacement placements[] = { WorkerPlacement::Compact, WorkerPlacement::Spread };
+    for(WorkerPlacement placement : placements) {
+      WorkStealingExecutor executor(3, placement);
+      EXPECT_EQ(executor.GetPlacement(), placement);
+      EXPECT_EQ(executor.CountWorkers(), 3U);
+
+      std::atomic<std::size_t> runCount(0);
+      executor.ParallelFor(100, [&runCount](std::size_t) { runCount.fetch_add(1); });
+      EXPECT_EQ(runCount.load(), 100U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ExecutorTest, HigherPriorityTasksRunFirst) {
+    std::vector<TaskPriority> order;
+    {
+      WorkStealingExecutor executor(1);
+
+      // Keep the only worker busy until all tasks have been queued
+      std::mutex gateMutex;
+      std::condition_variable gateCondition;
+      bool isGateOpen = false;
+      executor.Submit(
+        [&]() {
+          std::unique_lock<std::mutex> gateScope(gateMutex);
+          gateCondition.wait(gateScope, [&]() { return isGateOpen; });
+        }
+      );
+
+      TaskPriority priorities[] = { TaskPriority::Low, TaskPriority::Normal, TaskPriority::High };
+      for(TaskPriority priority : priorities) {
+        executor.Submit([&order, priority]() { order.push_back(priority); }, priority);
+      }
+
+      {
+        std::lock_guard<std::mutex> gateScope(gateMutex);
+        isGateOpen = true;
+      }
+      gateCondition.notify_one();
+    } // Destroying the executor runs all queued tasks
+
+    ASSERT_EQ(order.size(), 3U);
+    EXPECT_EQ(order[0], TaskPriority::High);
+    EXPECT_EQ(order[1], TaskPriority::Normal);
+    EXPECT_EQ(order[2], TaskPriority::Low);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
@@ -0,0 +1,116 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/LargePageSampleAllocator.h"
+#include "Nuclex/Audio/Track.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t
+#include <cstring> // for std::memset()
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LargePageSampleAllocatorTest, SmallBlocksComeFromOperatorNew) {
+    LargePageSampleAllocator allocator(1048576);
+
+    void *memory = allocator.Allocate(4096);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % SampleAllocator::Alignment, 0U);
+    EXPECT_EQ(allocator.GetPageKind(memory), LargePageKind::None);
+
+    LargePageUsage usage = allocator.GetUsage();
+    EXPECT_EQ(usage.RegularByteCount + usage.TransparentByteCount + usage.ExplicitByteCount, 0U);
+
+    allocator.Free(memory, 4096);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LargePageSampleAllocatorTest, LargeBlocksAreMappedAndReported) {
+    LargePageSampleAllocator allocator(1048576);
+
+    const std::size_t byteCount = 3 * LargePageSampleAllocator::HugePageSize + 12345;
+    void *memory = allocator.Allocate(byteCount);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % SampleAllocator::Alignment, 0U);
+    std::memset(memory, 0x5a, byteCount);
+
+    // Whatever kind of pages we got, the whole block must be accounted for exactly once
+    LargePageUsage usage = allocator.GetUsage();
+    std::size_t totalByteCount = (
+      usage.RegularByteCount + usage.TransparentByteCount + usage.ExplicitByteCount
+    );
+    EXPECT_EQ(totalByteCount, 4 * LargePageSampleAllocator::HugePageSize);
+
+    LargePageKind pageKind = allocator.GetPageKind(memory);
+    if(pageKind == LargePageKind::Transparent) {
+      EXPECT_EQ(usage.TransparentByteCount, totalByteCount);
+    } else if(pageKind == LargePageKind::Explicit) {
+      EXPECT_EQ(usage.ExplicitByteCount, totalByteCount);
+    } else {
+      EXPECT_EQ(usage.RegularByteCount, totalByteCount);
+    }
+
+    allocator.Free(memory, byteCount);
+
+    usage = allocator.GetUsage();
+    EXPECT_EQ(usage.RegularByteCount + usage.TransparentByteCount + usage.ExplicitByteCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LargePageSampleAllocatorTest, FallsBackWhenExplicitPagesAreUnavailable) {
+    LargePageSampleAllocator allocator(1048576, true);
+
+    // Most systems have no huge pages reserved, in which case this must still work
+    void *memory = allocator.Allocate(LargePageSampleAllocator::HugePageSize);
+    ASSERT_NE(memory, nullptr);
+    std::memset(memory, 0, LargePageSampleAllocator::HugePageSize);
+    allocator.Free(memory, LargePageSampleAllocator::HugePageSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LargePageSampleAllocatorTest, TracksCanLiveInLargePages) {
+    LargePageSampleAllocator allocator(1048576);
+    SampleAllocator::SetGlobal(&allocator);
+    {
+      Track track(2, 1048576, 48000);
+      EXPECT_NE(track.GetSamples(), nullptr);
+
+      LargePageUsage usage = allocator.GetUsage();
+      std::size_t totalByteCount = (
+        usage.RegularByteCount + usage.TransparentByteCount + usage.ExplicitByteCount
+      );
+      EXPECT_GE(totalByteCount, 2 * 1048576 * sizeof(float));
+    }
+    SampleAllocator::SetGlobal(nullptr);
+
+    LargePageUsage usage = allocator.GetUsage();
+    EXPECT_EQ(usage.RegularByteCount + usage.TransparentByteCount + usage.ExplicitByteCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
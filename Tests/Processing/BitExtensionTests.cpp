@@ -241,4 +241,61 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(BitExtensionTests, CanExtendBatchOf16BitIntegersTo24Bits) {
+    std::int16_t input[37];
+    for(std::size_t index = 0; index < 37; ++index) {
+      input[index] = static_cast<std::int16_t>(index * 1771 - 32768);
+    }
+    std::int32_t extended[37];
+
+    BitExtension::ExtendToInt32(input, 16, extended, 24, 37);
+
+    // Same result as widening and repeating the bit pattern one integer at a time
+    for(std::size_t index = 0; index < 37; ++index) {
+      std::int32_t expected = BitExtension::ShiftAndRepeatSigned(
+        16, input[index], 15, 0x0000FFFE
+      );
+      EXPECT_EQ(extended[index], expected & std::int32_t(0xFFFFFF00));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitExtensionTests, CanExtendBatchOf8BitIntegersTo32Bits) {
+    std::int16_t input[21];
+    for(std::size_t index = 0; index < 21; ++index) {
+      input[index] = static_cast<std::int16_t>((index * 12 - 128) << 8);
+    }
+    std::int32_t extended[21];
+
+    BitExtension::ExtendToInt32(input, 8, extended, 32, 21);
+
+    // Extending 8 bits to 32 bits needs the bit pattern tripled
+    for(std::size_t index = 0; index < 21; ++index) {
+      std::int32_t expected = BitExtension::ShiftAndTripleSigned(
+        16, input[index], 7, 0x00FE0000
+      );
+      EXPECT_EQ(extended[index], expected);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitExtensionTests, CanExtendBatchOf32BitIntegersInPlace) {
+    std::int32_t values[11];
+    std::int32_t input[11];
+    for(std::size_t index = 0; index < 11; ++index) {
+      values[index] = static_cast<std::int32_t>((index * 1500000 - 8000000) * 256);
+      input[index] = values[index];
+    }
+
+    BitExtension::ExtendToInt32(values, 24, values, 32, 11);
+
+    for(std::size_t index = 0; index < 11; ++index) {
+      EXPECT_EQ(values[index], BitExtension::RepeatSigned(input[index], 23, 0x000000FF));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,110 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ByteSwapping.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of samples the tests will byte-swap at once</summary>
+  /// <remarks>
+  ///   Every count up to this is tried so that all the kernels' tails are exercised
+  /// </remarks>
+  const std::size_t MaximumTestSampleCount = 40;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Signature of the byte swapping methods</summary>
+  typedef void SwapMethod(const std::byte *, std::byte *, std::size_t);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Swaps test samples out of place and in place and checks the results</summary>
+  /// <param name="swap">Byte swapping method that will be checked</param>
+  /// <param name="byteCount">Number of bytes per sample the method swaps</param>
+  void checkSwap(SwapMethod *swap, std::size_t byteCount) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::byte> original(count * byteCount);
+      for(std::size_t index = 0; index < original.size(); ++index) {
+        original[index] = static_cast<std::byte>(index * 7 + 1);
+      }
+
+      // One extra byte verifies the kernels stay within the target
+      std::vector<std::byte> swapped(original.size() + 1, std::byte(0xA5));
+      swap(original.data(), swapped.data(), count);
+
+      for(std::size_t sampleIndex = 0; sampleIndex < count; ++sampleIndex) {
+        for(std::size_t byteIndex = 0; byteIndex < byteCount; ++byteIndex) {
+          EXPECT_EQ(
+            swapped[sampleIndex * byteCount + byteIndex],
+            original[sampleIndex * byteCount + byteCount - 1 - byteIndex]
+          );
+        }
+      }
+      EXPECT_EQ(swapped[original.size()], std::byte(0xA5));
+
+      // Swapping again, in place, must restore the original byte order
+      swap(swapped.data(), swapped.data(), count);
+      for(std::size_t index = 0; index < original.size(); ++index) {
+        EXPECT_EQ(swapped[index], original[index]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ByteSwappingTests, CanSwap16BitSamples) {
+    checkSwap(&ByteSwapping::Swap16, 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ByteSwappingTests, CanSwap24BitSamples) {
+    checkSwap(&ByteSwapping::Swap24, 3);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ByteSwappingTests, CanSwap32BitSamples) {
+    checkSwap(&ByteSwapping::Swap32, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ByteSwappingTests, CanSwap64BitSamples) {
+    checkSwap(&ByteSwapping::Swap64, 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
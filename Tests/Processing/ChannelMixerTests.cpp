@@ -0,0 +1,227 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+#include "Nuclex/Audio/KnownChannelLayouts.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Channels of a stereo track</summary>
+  const std::vector<Nuclex::Audio::ChannelPlacement> StereoChannels = {
+    Nuclex::Audio::ChannelPlacement::FrontLeft,
+    Nuclex::Audio::ChannelPlacement::FrontRight
+  };
+
+  /// <summary>Channels of a 5.1 surround track in the WaveformatExtensible order</summary>
+  const std::vector<Nuclex::Audio::ChannelPlacement> FiveDotOneChannels = {
+    Nuclex::Audio::ChannelPlacement::FrontLeft,
+    Nuclex::Audio::ChannelPlacement::FrontRight,
+    Nuclex::Audio::ChannelPlacement::FrontCenter,
+    Nuclex::Audio::ChannelPlacement::LowFrequencyEffects,
+    Nuclex::Audio::ChannelPlacement::BackLeft,
+    Nuclex::Audio::ChannelPlacement::BackRight
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a buffer with deterministic samples in the range of -1 to 1</summary>
+  /// <param name="sampleCount">Number of samples to generate</param>
+  /// <returns>A buffer holding the generated samples</returns>
+  std::vector<float> generateSamples(std::size_t sampleCount) {
+    std::vector<float> samples(sampleCount);
+
+    std::uint32_t state = 12345;
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      state = state * 1664525U + 1013904223U;
+      samples[index] = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+    }
+
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Verifies the mixer's output in both buffer layouts against the matrix</summary>
+  /// <param name="mixer">Mixer that will be checked</param>
+  /// <param name="frameCount">Number of frames that will be mixed</param>
+  void expectMixerMatchesMatrix(
+    const Nuclex::Audio::Processing::ChannelMixer &mixer, std::size_t frameCount
+  ) {
+    std::size_t inputChannelCount = mixer.CountInputChannels();
+    std::size_t outputChannelCount = mixer.CountOutputChannels();
+    std::vector<float> interleavedInput = generateSamples(inputChannelCount * frameCount);
+
+    std::vector<float> expected(outputChannelCount * frameCount);
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+        double sum = 0.0;
+        for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+          sum += (
+            interleavedInput[frameIndex * inputChannelCount + inputIndex] *
+            mixer.GetMatrix().GetCoefficient(outputIndex, inputIndex)
+          );
+        }
+        expected[frameIndex * outputChannelCount + outputIndex] = static_cast<float>(sum);
+      }
+    }
+
+    std::vector<float> interleavedOutput(outputChannelCount * frameCount);
+    mixer.MixInterleaved(interleavedInput.data(), interleavedOutput.data(), frameCount);
+
+    std::vector<std::vector<float>> separatedInput(inputChannelCount);
+    std::vector<const float *> inputs(inputChannelCount);
+    for(std::size_t inputIndex = 0; inputIndex < inputChannelCount; ++inputIndex) {
+      separatedInput[inputIndex].resize(frameCount);
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        separatedInput[inputIndex][frameIndex] = (
+          interleavedInput[frameIndex * inputChannelCount + inputIndex]
+        );
+      }
+      inputs[inputIndex] = separatedInput[inputIndex].data();
+    }
+
+    std::vector<std::vector<float>> separatedOutput(outputChannelCount);
+    std::vector<float *> outputs(outputChannelCount);
+    for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+      separatedOutput[outputIndex].resize(frameCount);
+      outputs[outputIndex] = separatedOutput[outputIndex].data();
+    }
+    mixer.MixSeparated(inputs.data(), outputs.data(), frameCount);
+
+    // Kernels using fused multiply-add round differently, so allow a tiny error
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t outputIndex = 0; outputIndex < outputChannelCount; ++outputIndex) {
+        float expectedSample = expected[frameIndex * outputChannelCount + outputIndex];
+        EXPECT_NEAR(
+          interleavedOutput[frameIndex * outputChannelCount + outputIndex],
+          expectedSample, 0.00001f
+        );
+        EXPECT_NEAR(separatedOutput[outputIndex][frameIndex], expectedSample, 0.00001f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelMixerTests, CanListChannelsOfLayout) {
+    std::vector<ChannelPlacement> channelOrder = ChannelMixer::GetChannelOrder(
+      KnownChannelLayouts::FiveDotOneSurround
+    );
+    EXPECT_EQ(channelOrder, FiveDotOneChannels);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelMixerTests, RoutingReordersChannels) {
+    std::vector<ChannelPlacement> reversed(FiveDotOneChannels.rbegin(), FiveDotOneChannels.rend());
+    ChannelMixer mixer = ChannelMixer::CreateRouting(FiveDotOneChannels, reversed);
+    EXPECT_EQ(mixer.GetStrategy(), ChannelMixer::Strategy::Routing);
+
+    std::vector<float> input = generateSamples(6 * 3);
+    std::vector<float> output(6 * 3);
+    mixer.MixInterleaved(input.data(), output.data(), 3);
+
+    for(std::size_t frameIndex = 0; frameIndex < 3; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < 6; ++channelIndex) {
+        EXPECT_EQ(output[frameIndex * 6 + channelIndex], input[frameIndex * 6 + 5 - channelIndex]);
+      }
+    }
+
+    expectMixerMatchesMatrix(mixer, 37);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelMixerTests, RoutingSilencesMissingChannels) {
+    ChannelMixer mixer = ChannelMixer::CreateRouting(StereoChannels, FiveDotOneChannels);
+    EXPECT_EQ(mixer.GetStrategy(), ChannelMixer::Strategy::Routing);
+
+    std::vector<float> left = { 0.25f, 0.5f }, right = { -0.25f, -0.5f };
+    const float *inputs[] = { left.data(), right.data() };
+
+    std::vector<std::vector<float>> separated(6, std::vector<float>(2, 1.0f));
+    float *outputs[] = {
+      separated[0].data(), separated[1].data(), separated[2].data(),
+      nullptr, separated[4].data(), separated[5].data()
+    };
+    mixer.MixSeparated(inputs, outputs, 2);
+
+    EXPECT_EQ(separated[0], left);
+    EXPECT_EQ(separated[1], right);
+    EXPECT_EQ(separated[2], std::vector<float>(2, 0.0f));
+    EXPECT_EQ(separated[3], std::vector<float>(2, 1.0f)); // skipped, left as it was
+    EXPECT_EQ(separated[4], std::vector<float>(2, 0.0f));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelMixerTests, UpmixSpreadsStereoOntoSurround) {
+    ChannelMixer mixer = ChannelMixer::CreateUpmix(StereoChannels, FiveDotOneChannels);
+    EXPECT_EQ(mixer.GetStrategy(), ChannelMixer::Strategy::Sparse);
+
+    const DownmixMatrix &matrix = mixer.GetMatrix();
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 0), 1.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 1), 0.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(1, 1), 1.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(2, 0), 0.5f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(2, 1), 0.5f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(3, 0), 0.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(3, 1), 0.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(4, 0), 0.7071f, 0.0001f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(4, 1), 0.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(5, 0), 0.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(5, 1), 0.7071f, 0.0001f);
+
+    expectMixerMatchesMatrix(mixer, 1001);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelMixerTests, DenseMatrixUsesDenseKernel) {
+    std::vector<float> coefficients = generateSamples(6 * 11);
+    std::vector<ChannelPlacement> outputChannelOrder = ChannelMixer::GetChannelOrder(
+      KnownChannelLayouts::SevenDotOneSurround | ChannelPlacement::TopFrontLeft |
+      ChannelPlacement::TopFrontRight | ChannelPlacement::TopCenter
+    );
+    ASSERT_EQ(outputChannelOrder.size(), 11U);
+
+    ChannelMixer mixer(DownmixMatrix(FiveDotOneChannels, outputChannelOrder, coefficients));
+    EXPECT_EQ(mixer.GetStrategy(), ChannelMixer::Strategy::Dense);
+
+    expectMixerMatchesMatrix(mixer, 1001);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,167 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ClippingFinder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../Storage/ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ClippingFinderTests, RejectsInvalidArguments) {
+    EXPECT_THROW(ClippingFinder finder(0), std::invalid_argument);
+    EXPECT_THROW(ClippingFinder finder(2, 0.0f), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ClippingFinderTests, FindsClippedIntervalsPerChannel) {
+    std::vector<float> samples(200 * 3, 0.5f);
+
+    // Channel 0 clips for 5 frames at the positive end, channel 2 for 4 frames at
+    // the negative end and channel 1 only for 2 frames, which is too short to count
+    for(std::size_t frame = 10; frame < 15; ++frame) {
+      samples[frame * 3 + 0] = 1.0f;
+    }
+    for(std::size_t frame = 70; frame < 72; ++frame) {
+      samples[frame * 3 + 1] = 1.0f;
+    }
+    for(std::size_t frame = 100; frame < 104; ++frame) {
+      samples[frame * 3 + 2] = -1.0f;
+    }
+
+    ClippingFinder finder(3);
+    finder.ProcessInterleaved(samples.data(), 200);
+    finder.Finish();
+
+    const std::vector<ClippedInterval> &intervals = finder.GetClippedIntervals();
+    ASSERT_EQ(intervals.size(), 2U);
+    EXPECT_EQ(intervals[0].ChannelIndex, 0U);
+    EXPECT_EQ(intervals[0].StartFrame, 10U);
+    EXPECT_EQ(intervals[0].FrameCount, 5U);
+    EXPECT_EQ(intervals[1].ChannelIndex, 2U);
+    EXPECT_EQ(intervals[1].StartFrame, 100U);
+    EXPECT_EQ(intervals[1].FrameCount, 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ClippingFinderTests, TracksRunsAcrossBlocks) {
+    std::vector<std::int16_t> samples(1000 * 2, 1000);
+    for(std::size_t frame = 95; frame < 130; ++frame) {
+      samples[frame * 2 + 1] = -32768;
+    }
+    for(std::size_t frame = 990; frame < 1000; ++frame) {
+      samples[frame * 2] = 32767;
+    }
+
+    // Odd block sizes make the groups of 64 samples straddle frames and calls
+    ClippingFinder finder(2);
+    for(std::size_t frame = 0; frame < 1000; frame += 33) {
+      std::size_t frameCount = std::min<std::size_t>(33, 1000 - frame);
+      finder.ProcessInterleaved(samples.data() + frame * 2, frameCount);
+    }
+
+    // The run at the end stays open until the finder is told the track is over
+    ASSERT_EQ(finder.GetClippedIntervals().size(), 1U);
+    finder.Finish();
+
+    const std::vector<ClippedInterval> &intervals = finder.GetClippedIntervals();
+    ASSERT_EQ(intervals.size(), 2U);
+    EXPECT_EQ(intervals[0].ChannelIndex, 1U);
+    EXPECT_EQ(intervals[0].StartFrame, 95U);
+    EXPECT_EQ(intervals[0].FrameCount, 35U);
+    EXPECT_EQ(intervals[1].ChannelIndex, 0U);
+    EXPECT_EQ(intervals[1].StartFrame, 990U);
+    EXPECT_EQ(intervals[1].FrameCount, 10U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ClippingFinderTests, RespectsIntegerThresholds) {
+    std::vector<std::int32_t> samples(100, 0);
+    for(std::size_t index = 20; index < 30; ++index) {
+      samples[index] = 2147483392; // Full scale 24-bit sample in a 32-bit integer
+    }
+    for(std::size_t index = 60; index < 70; ++index) {
+      samples[index] = 2000000000; // Loud, but below the default threshold
+    }
+
+    ClippingFinder finder(1);
+    finder.ProcessInterleaved(samples.data(), 100);
+    finder.Finish();
+
+    ASSERT_EQ(finder.GetClippedIntervals().size(), 1U);
+    EXPECT_EQ(finder.GetClippedIntervals()[0].StartFrame, 20U);
+    EXPECT_EQ(finder.GetClippedIntervals()[0].FrameCount, 10U);
+
+    // With a lower threshold, the loud stretch counts, too
+    ClippingFinder sensitiveFinder(1, 0.9f);
+    sensitiveFinder.ProcessInterleaved(samples.data(), 100);
+    sensitiveFinder.Finish();
+    EXPECT_EQ(sensitiveFinder.GetClippedIntervals().size(), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ClippingFinderTests, ScansDecoderInBlocks) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder.CountFrames());
+    std::vector<std::int32_t> samples(frameCount * decoder.CountChannels());
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    // A low threshold guarantees there are intervals to compare
+    ClippingFinder finder(decoder.CountChannels(), 0.25f, 2);
+    finder.ProcessInterleaved(samples.data(), frameCount);
+    finder.Finish();
+    const std::vector<ClippedInterval> &expected = finder.GetClippedIntervals();
+    ASSERT_FALSE(expected.empty());
+
+    std::vector<ClippedInterval> actual = ClippingFinder::FindClippedIntervals(
+      decoder, 0.25f, 2
+    );
+    ASSERT_EQ(actual.size(), expected.size());
+    for(std::size_t index = 0; index < actual.size(); ++index) {
+      EXPECT_EQ(actual[index].ChannelIndex, expected[index].ChannelIndex);
+      EXPECT_EQ(actual[index].StartFrame, expected[index].StartFrame);
+      EXPECT_EQ(actual[index].FrameCount, expected[index].FrameCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,194 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ContentHasher.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uint32_t
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <utility> // for std::swap()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates reproducible noise to hash</summary>
+  /// <param name="sampleCount">Number of samples that will be generated</param>
+  /// <returns>A list of samples between -1.0 and +1.0</returns>
+  std::vector<float> makeNoise(std::size_t sampleCount) {
+    std::vector<float> samples(sampleCount);
+    std::uint32_t state = 12345;
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      state = state * 1664525U + 1013904223U;
+      samples[index] = static_cast<float>(static_cast<std::int32_t>(state >> 8) - 8388608) / (
+        8388608.0f
+      );
+    }
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, RejectsZeroChannels) {
+    EXPECT_THROW(ContentHasher hasher(0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, HashDoesNotDependOnHowSamplesAreFed) {
+    std::vector<float> samples = makeNoise(1001 * 2);
+
+    ContentHasher whole(2);
+    whole.ProcessInterleaved(samples.data(), 1001);
+
+    // Odd chunk sizes leave different remainders for the scalar tail each time
+    ContentHasher pieces(2);
+    std::size_t chunkSizes[] = { 1, 7, 333, 2, 658 };
+    const float *current = samples.data();
+    for(std::size_t chunkSize : chunkSizes) {
+      pieces.ProcessInterleaved(current, chunkSize);
+      current += chunkSize * 2;
+    }
+
+    EXPECT_TRUE(whole.GetHash() == pieces.GetHash());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, VectorAndScalarPathsAgree) {
+    std::vector<float> samples = makeNoise(515);
+
+    ContentHasher vectorized(1);
+    vectorized.ProcessInterleaved(samples.data(), samples.size());
+
+    // Mono frames fed one by one never fill a SIMD register
+    ContentHasher scalar(1);
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      scalar.ProcessInterleaved(samples.data() + index, 1);
+    }
+
+    EXPECT_TRUE(vectorized.GetHash() == scalar.GetHash());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, RangesCanBeMerged) {
+    std::vector<float> samples = makeNoise(1000 * 2);
+
+    ContentHasher whole(2);
+    whole.ProcessInterleaved(samples.data(), 1000);
+
+    ContentHasher first(2, 0, 0);
+    first.ProcessInterleaved(samples.data(), 613);
+    ContentHasher second(2, 0, 613);
+    second.ProcessInterleaved(samples.data() + 613 * 2, 387);
+
+    ContentHasher merged(2);
+    merged.Merge(first);
+    merged.Merge(second);
+    EXPECT_TRUE(merged.GetHash() == whole.GetHash());
+
+    // Merging in reverse order yields the same result
+    second.Merge(first);
+    EXPECT_TRUE(second.GetHash() == whole.GetHash());
+
+    ContentHasher mismatched(3);
+    EXPECT_THROW(merged.Merge(mismatched), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, DifferentAudioGivesDifferentHashes) {
+    std::vector<float> samples = makeNoise(400);
+
+    ContentHasher original(2);
+    original.ProcessInterleaved(samples.data(), 200);
+    ContentHash originalHash = original.GetHash();
+
+    // Exchanging two samples must change the hash since positions are mixed in
+    std::vector<float> swapped(samples);
+    std::swap(swapped[10], swapped[11]);
+    ContentHasher swappedHasher(2);
+    swappedHasher.ProcessInterleaved(swapped.data(), 200);
+    EXPECT_TRUE(swappedHasher.GetHash() != originalHash);
+
+    // Changing the sign of a single sample must change the hash
+    std::vector<float> negated(samples);
+    negated[123] = -negated[123];
+    ContentHasher negatedHasher(2);
+    negatedHasher.ProcessInterleaved(negated.data(), 200);
+    EXPECT_TRUE(negatedHasher.GetHash() != originalHash);
+
+    // The same samples interpreted as mono must not collide with the stereo hash
+    ContentHasher mono(1);
+    mono.ProcessInterleaved(samples.data(), 400);
+    EXPECT_TRUE(mono.GetHash() != originalHash);
+
+    // Trailing silence is part of the audio, too
+    std::vector<float> padded(samples);
+    padded.resize(402, 0.0f);
+    ContentHasher paddedHasher(2);
+    paddedHasher.ProcessInterleaved(padded.data(), 201);
+    EXPECT_TRUE(paddedHasher.GetHash() != originalHash);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContentHasherTests, BlockHashesFindSharedSections) {
+    std::vector<float> samples = makeNoise(250);
+    std::vector<float> altered(samples);
+    altered[180] = 0.0f;
+
+    ContentHasher first(1, 100);
+    first.ProcessInterleaved(samples.data(), 250);
+    ContentHasher second(1, 100);
+    second.ProcessInterleaved(altered.data(), 250);
+
+    ASSERT_EQ(first.CountBlocks(), 3U);
+    ASSERT_EQ(second.CountBlocks(), 3U);
+    EXPECT_TRUE(first.GetBlockHash(0) == second.GetBlockHash(0));
+    EXPECT_TRUE(first.GetBlockHash(1) != second.GetBlockHash(1));
+    EXPECT_TRUE(first.GetBlockHash(2) == second.GetBlockHash(2));
+    EXPECT_TRUE(first.GetHash() != second.GetHash());
+    EXPECT_THROW(first.GetBlockHash(3), std::out_of_range);
+
+    // A block hash is the hash of the block's samples on their own position
+    ContentHasher blockOnly(1, 0, 100);
+    blockOnly.ProcessInterleaved(samples.data() + 100, 100);
+    ContentHasher reset(1, 100);
+    reset.Reset(100);
+    reset.ProcessInterleaved(samples.data() + 100, 100);
+    EXPECT_TRUE(reset.GetBlockHash(1) == first.GetBlockHash(1));
+    EXPECT_TRUE(blockOnly.GetHash() == first.GetBlockHash(1));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,254 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Processing/Quantization.h"
+#include "Nuclex/Audio/Processing/Reconstruction.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::isnan(), std::isinf()
+#include <limits> // for std::numeric_limits
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Odd number of samples so that the kernels' tail handling is exercised</summary>
+  const std::size_t TestSampleCount = 1037;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, ReportsActiveKernelSet) {
+    ConversionKernelSet kernelSet = ConversionKernels::GetActiveKernelSet();
+    std::string name = ConversionKernels::GetActiveKernelSetName();
+
+    switch(kernelSet) {
+      case ConversionKernelSet::Scalar: { EXPECT_EQ(name, u8"Scalar"); break; }
+      case ConversionKernelSet::Sse2: { EXPECT_EQ(name, u8"SSE2"); break; }
+      case ConversionKernelSet::Avx2: { EXPECT_EQ(name, u8"AVX2"); break; }
+      case ConversionKernelSet::Avx512: { EXPECT_EQ(name, u8"AVX-512"); break; }
+      case ConversionKernelSet::Neon: { EXPECT_EQ(name, u8"NEON"); break; }
+      default: { FAIL() << u8"Kernel set is not one of the known values"; }
+    }
+
+#if defined(NUCLEX_AUDIO_HAVE_SSE2)
+    EXPECT_GE(static_cast<int>(kernelSet), static_cast<int>(ConversionKernelSet::Sse2));
+#elif defined(NUCLEX_AUDIO_HAVE_NEON)
+    EXPECT_EQ(kernelSet, ConversionKernelSet::Neon);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, QuantizationMatchesInlineMethods) {
+    std::vector<float> floats(TestSampleCount);
+    std::vector<double> doubles(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      floats[index] = static_cast<float>(index % 201) / 100.0f - 1.0f;
+      doubles[index] = static_cast<double>(floats[index]);
+    }
+
+    std::vector<std::int32_t> expected(TestSampleCount), actual(TestSampleCount);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expected[index] = Quantization::NearestInt32(floats[index] * 32767.0f);
+    }
+    ConversionKernels::MultiplyToNearestInt32(
+      floats.data(), 32767.0f, actual.data(), TestSampleCount
+    );
+    EXPECT_EQ(actual, expected);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expected[index] = Quantization::NearestInt32(floats[index] * 8388607.0);
+    }
+    ConversionKernels::MultiplyToNearestInt32(
+      floats.data(), 8388607.0, actual.data(), TestSampleCount
+    );
+    EXPECT_EQ(actual, expected);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expected[index] = Quantization::NearestInt32(doubles[index] * 2147483647.0);
+    }
+    ConversionKernels::MultiplyToNearestInt32(
+      doubles.data(), 2147483647.0, actual.data(), TestSampleCount
+    );
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, ReconstructionMatchesInlineMethods) {
+    std::vector<std::int32_t> integers(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      integers[index] = (static_cast<std::int32_t>(index) - 512) * 16;
+    }
+
+    std::vector<float> expectedFloats(TestSampleCount), actualFloats(TestSampleCount);
+    std::vector<double> expectedDoubles(TestSampleCount), actualDoubles(TestSampleCount);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expectedFloats[index] = Reconstruction::DivideInt32ToFloat(integers[index] >> 4, 511.0f);
+    }
+    ConversionKernels::ShiftAndDivideInt32ToFloat(
+      integers.data(), 4, 511.0f, actualFloats.data(), TestSampleCount
+    );
+    EXPECT_EQ(actualFloats, expectedFloats);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expectedFloats[index] = static_cast<float>(
+        Reconstruction::DivideInt32ToFloat(integers[index] >> 2, 2047.0)
+      );
+    }
+    ConversionKernels::ShiftAndDivideInt32ToFloat(
+      integers.data(), 2, 2047.0, actualFloats.data(), TestSampleCount
+    );
+    EXPECT_EQ(actualFloats, expectedFloats);
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      expectedDoubles[index] = Reconstruction::DivideInt32ToFloat(integers[index], 8191.0);
+    }
+    ConversionKernels::ShiftAndDivideInt32ToFloat(
+      integers.data(), 0, 8191.0, actualDoubles.data(), TestSampleCount
+    );
+    EXPECT_EQ(actualDoubles, expectedDoubles);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, DoubleReconstructionOfFullRangeIntegersIsExact) {
+    std::vector<std::int32_t> integers(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      integers[index] = static_cast<std::int32_t>(
+        static_cast<std::uint32_t>(index) * 2654435761U
+      );
+    }
+    integers[TestSampleCount - 1] = std::numeric_limits<std::int32_t>::max();
+    integers[TestSampleCount - 2] = std::numeric_limits<std::int32_t>::min() + 1;
+
+    // Values beyond 24 bits can't be represented by a float, so this would catch any
+    // path (including the tail after the last full vector) that converts through floats
+    const double quotient = 2147483647.0;
+
+    std::vector<double> actualDoubles(TestSampleCount);
+    ConversionKernels::ShiftAndDivideInt32ToFloat(
+      integers.data(), 0, quotient, actualDoubles.data(), TestSampleCount
+    );
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      EXPECT_EQ(actualDoubles[index], static_cast<double>(integers[index]) / quotient);
+    }
+
+    std::vector<float> actualFloats(TestSampleCount);
+    ConversionKernels::ShiftAndDivideInt32ToFloat(
+      integers.data(), 0, quotient, actualFloats.data(), TestSampleCount
+    );
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      EXPECT_EQ(
+        actualFloats[index], static_cast<float>(static_cast<double>(integers[index]) / quotient)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, Float16RoundTripIsExact) {
+    std::vector<Float16> halves(65536);
+    for(std::size_t index = 0; index < 65536; ++index) {
+      halves[index].Bits = static_cast<std::uint16_t>(index);
+    }
+
+    std::vector<float> floats(65536);
+    ConversionKernels::ConvertFromFloat16(halves.data(), floats.data(), 65536);
+    std::vector<Float16> roundTripped(65536);
+    ConversionKernels::ConvertToFloat16(floats.data(), roundTripped.data(), 65536);
+
+    for(std::size_t index = 0; index < 65536; ++index) {
+      if(std::isnan(floats[index])) {
+        EXPECT_EQ(roundTripped[index].Bits & 0x7C00U, 0x7C00U);
+        EXPECT_NE(roundTripped[index].Bits & 0x03FFU, 0U);
+      } else {
+        EXPECT_EQ(roundTripped[index].Bits, halves[index].Bits);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, Float16ConversionRoundsToNearestEven) {
+    std::vector<float> floats(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      floats[index] = static_cast<float>(index % 201) / 100.0f - 1.0f;
+    }
+    floats[1] = 1.0f + 1.0f / 2048.0f; // halfway between 1.0 and the next half, even is 1.0
+    floats[2] = 1.0f + 3.0f / 2048.0f; // halfway, even is the upper one
+    floats[3] = 70000.0f; // beyond the range of half precision floats
+    floats[4] = std::numeric_limits<float>::denorm_min(); // too small, becomes zero
+
+    std::vector<Float16> halves(TestSampleCount);
+    ConversionKernels::ConvertToFloat16(floats.data(), halves.data(), TestSampleCount);
+    std::vector<float> widened(TestSampleCount);
+    ConversionKernels::ConvertFromFloat16(halves.data(), widened.data(), TestSampleCount);
+
+    EXPECT_EQ(halves[1].Bits, 0x3C00U);
+    EXPECT_EQ(halves[2].Bits, 0x3C02U);
+    EXPECT_TRUE(std::isinf(widened[3]));
+    EXPECT_EQ(halves[4].Bits, 0U);
+    for(std::size_t index = 5; index < TestSampleCount; ++index) {
+      EXPECT_NEAR(widened[index], floats[index], 0.0005f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConversionKernelsTest, BFloat16ConversionRoundsToNearestEven) {
+    std::vector<float> floats(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      floats[index] = static_cast<float>(index % 201) / 100.0f - 1.0f;
+    }
+    floats[1] = 1.0f + 1.0f / 256.0f; // halfway between 1.0 and the next brain float
+    floats[2] = 1.0f + 3.0f / 256.0f; // halfway, even is the upper one
+    floats[3] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<BFloat16> brainFloats(TestSampleCount);
+    ConversionKernels::ConvertToBFloat16(floats.data(), brainFloats.data(), TestSampleCount);
+    std::vector<float> widened(TestSampleCount);
+    ConversionKernels::ConvertFromBFloat16(brainFloats.data(), widened.data(), TestSampleCount);
+
+    EXPECT_EQ(brainFloats[1].Bits, 0x3F80U);
+    EXPECT_EQ(brainFloats[2].Bits, 0x3F82U);
+    EXPECT_TRUE(std::isnan(widened[3]));
+    for(std::size_t index = 4; index < TestSampleCount; ++index) {
+      EXPECT_NEAR(widened[index], floats[index], 0.004f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,101 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/DecibelConverter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::log10(), std::pow(), std::isinf()
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecibelConverterTests, ScalarConversionsAreInverse) {
+    EXPECT_FLOAT_EQ(DecibelConverter::FromLinearAmplitude(1.0f), 0.0f);
+    EXPECT_NEAR(DecibelConverter::FromLinearAmplitude(0.5), -6.0206, 0.0001);
+    EXPECT_FLOAT_EQ(DecibelConverter::ToLinearAmplitude(0.0f), 1.0f);
+    EXPECT_NEAR(DecibelConverter::ToLinearAmplitude(-6.0206), 0.5, 0.0001);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecibelConverterTests, BatchFromLinearAmplitudeStaysWithinErrorBound) {
+
+    // Amplitudes from the float epsilon up to +20 dB, both signs, and an odd count
+    // so the leftover values after the last full vector are checked as well
+    std::vector<float> amplitudes;
+    for(double amplitude = 1.2e-7; amplitude < 10.0; amplitude *= 1.0137) {
+      amplitudes.push_back(static_cast<float>(amplitude));
+      amplitudes.push_back(static_cast<float>(-amplitude));
+    }
+    amplitudes.push_back(0.0f);
+
+    std::vector<float> decibels(amplitudes.size());
+    DecibelConverter::FromLinearAmplitude(amplitudes.data(), decibels.data(), amplitudes.size());
+
+    for(std::size_t index = 0; index < amplitudes.size(); ++index) {
+      float expected = DecibelConverter::FromLinearAmplitude(amplitudes[index]);
+      if(std::isinf(expected)) {
+        EXPECT_EQ(decibels[index], expected);
+      } else {
+        double exact = 20.0 * std::log10(std::abs(static_cast<double>(amplitudes[index])));
+        ASSERT_NEAR(decibels[index], exact, 0.0001);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecibelConverterTests, BatchToLinearAmplitudeStaysWithinErrorBound) {
+    std::vector<float> decibels;
+    for(float value = -140.0f; value <= 140.0f; value += 0.0173f) {
+      decibels.push_back(value);
+    }
+
+    std::vector<float> amplitudes(decibels.size());
+    DecibelConverter::ToLinearAmplitude(decibels.data(), amplitudes.data(), decibels.size());
+
+    for(std::size_t index = 0; index < decibels.size(); ++index) {
+      double exact = std::pow(10.0, static_cast<double>(decibels[index]) / 20.0);
+      ASSERT_NEAR(amplitudes[index] / exact, 1.0, 0.000002);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecibelConverterTests, BatchConversionsWorkInPlace) {
+    std::vector<float> values = { 1.0f, 0.5f, 0.25f, 2.0f, 0.1f };
+    DecibelConverter::FromLinearAmplitude(values.data(), values.data(), values.size());
+    DecibelConverter::ToLinearAmplitude(values.data(), values.data(), values.size());
+
+    EXPECT_NEAR(values[0], 1.0f, 0.00001f);
+    EXPECT_NEAR(values[1], 0.5f, 0.00001f);
+    EXPECT_NEAR(values[2], 0.25f, 0.00001f);
+    EXPECT_NEAR(values[3], 2.0f, 0.00001f);
+    EXPECT_NEAR(values[4], 0.1f, 0.00001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,229 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Ditherer.h"
+#include "Nuclex/Audio/Processing/SampleConverter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::sin(), std::abs()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of samples the statistical tests run through the ditherer</summary>
+  const std::size_t TestSampleCount = 10000;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a quiet sine wave that sits a few LSB above silence</summary>
+  /// <param name="amplitude">Amplitude of the sine wave relative to full scale</param>
+  /// <returns>The generated samples</returns>
+  std::vector<float> makeSineWave(float amplitude) {
+    std::vector<float> samples(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      samples[index] = amplitude * std::sin(static_cast<float>(index) * 0.05f);
+    }
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, RequiresAtLeastOneChannel) {
+    EXPECT_THROW(Ditherer ditherer(0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, SilenceDithersToSingleLsbNoise) {
+    Ditherer ditherer;
+
+    std::vector<float> silence(TestSampleCount, 0.0f);
+    std::vector<std::int32_t> results(TestSampleCount);
+    ditherer.MultiplyToDitheredInt32(
+      silence.data(), 32767.0f, 32767.0f, results.data(), TestSampleCount
+    );
+
+    double sum = 0.0;
+    std::size_t nonZeroCount = 0;
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      ASSERT_GE(results[index], -1);
+      ASSERT_LE(results[index], 1);
+      sum += results[index];
+      if(results[index] != 0) {
+        ++nonZeroCount;
+      }
+    }
+
+    // TPDF noise of +/- 1 LSB lands outside of +/- 0.5 in a quarter of all cases
+    EXPECT_LT(std::abs(sum / TestSampleCount), 0.05);
+    EXPECT_GT(nonZeroCount, TestSampleCount / 8);
+    EXPECT_LT(nonZeroCount, TestSampleCount / 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, SameSeedProducesSameResults) {
+    std::vector<float> samples = makeSineWave(0.001f);
+    std::vector<std::int32_t> first(TestSampleCount), second(TestSampleCount);
+
+    Ditherer ditherer(2, NoiseShaping::None, 1234);
+    ditherer.MultiplyToDitheredInt32(
+      samples.data(), 32767.0f, 32767.0f, first.data(), TestSampleCount
+    );
+    ditherer.Reset();
+    ditherer.MultiplyToDitheredInt32(
+      samples.data(), 32767.0f, 32767.0f, second.data(), TestSampleCount
+    );
+    EXPECT_EQ(first, second);
+
+    Ditherer other(2, NoiseShaping::None, 4321);
+    other.MultiplyToDitheredInt32(
+      samples.data(), 32767.0f, 32767.0f, second.data(), TestSampleCount
+    );
+    EXPECT_NE(first, second);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, FullScaleIsClampedToTargetRange) {
+    std::vector<float> samples(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      samples[index] = (index % 2 == 0) ? 1.5f : -1.5f;
+    }
+
+    for(NoiseShaping shaping : { NoiseShaping::None, NoiseShaping::SecondOrder }) {
+      Ditherer ditherer(1, shaping);
+      std::vector<std::int32_t> results(TestSampleCount);
+      ditherer.MultiplyToDitheredInt32(
+        samples.data(), 32767.0f, 32767.0f, results.data(), TestSampleCount
+      );
+      for(std::size_t index = 0; index < TestSampleCount; ++index) {
+        ASSERT_EQ(results[index], (index % 2 == 0) ? 32767 : -32767);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, NoiseShapedOutputTracksInput) {
+    std::vector<float> samples = makeSineWave(0.01f);
+
+    for(NoiseShaping shaping : { NoiseShaping::FirstOrder, NoiseShaping::SecondOrder }) {
+      Ditherer ditherer(1, shaping);
+      EXPECT_EQ(ditherer.GetNoiseShaping(), shaping);
+
+      std::vector<std::int32_t> results(TestSampleCount);
+      ditherer.MultiplyToDitheredInt32(
+        samples.data(), 32767.0f, 32767.0f, results.data(), TestSampleCount
+      );
+
+      // The shaped error can grow beyond 1 LSB but must stay bounded, and its
+      // running sum stays small because the filter pushes it to high frequencies
+      double errorSum = 0.0;
+      for(std::size_t index = 0; index < TestSampleCount; ++index) {
+        double error = results[index] - static_cast<double>(samples[index]) * 32767.0;
+        ASSERT_LT(std::abs(error), 6.0);
+        errorSum += error;
+      }
+      EXPECT_LT(std::abs(errorSum), 20.0);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, ChannelsAreShapedIndependently) {
+    std::vector<float> interleaved(TestSampleCount * 2);
+    std::vector<float> left(TestSampleCount);
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      left[index] = 0.001f * std::sin(static_cast<float>(index) * 0.05f);
+      interleaved[index * 2] = left[index];
+      interleaved[index * 2 + 1] = -0.5f;
+    }
+
+    // If the right channel's errors leaked into the left channel's feedback,
+    // the left channel's error would no longer average out
+    Ditherer stereo(2, NoiseShaping::FirstOrder);
+    std::vector<std::int32_t> stereoResults(TestSampleCount * 2);
+    stereo.MultiplyToDitheredInt32(
+      interleaved.data(), 32767.0f, 32767.0f, stereoResults.data(), TestSampleCount * 2
+    );
+
+    double errorSum = 0.0;
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      errorSum += stereoResults[index * 2] - static_cast<double>(left[index]) * 32767.0;
+    }
+    EXPECT_LT(std::abs(errorSum), 20.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, DitheredQuantizationStaysCloseToPlainQuantization) {
+    std::vector<float> samples = makeSineWave(0.8f);
+    std::vector<std::int16_t> plain(TestSampleCount), dithered(TestSampleCount);
+    std::vector<std::uint8_t> plainBytes(TestSampleCount), ditheredBytes(TestSampleCount);
+
+    Ditherer ditherer;
+    SampleConverter::Quantize(samples.data(), plain.data(), 16, TestSampleCount);
+    SampleConverter::QuantizeDithered(
+      samples.data(), dithered.data(), 16, TestSampleCount, ditherer
+    );
+    SampleConverter::Quantize(samples.data(), plainBytes.data(), 8, TestSampleCount);
+    SampleConverter::QuantizeDithered(
+      samples.data(), ditheredBytes.data(), 8, TestSampleCount, ditherer
+    );
+
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      ASSERT_LE(std::abs(plain[index] - dithered[index]), 1);
+      ASSERT_LE(std::abs(plainBytes[index] - ditheredBytes[index]), 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DithererTests, DitherIsAppliedAtValidBitCount) {
+    std::vector<float> silence(TestSampleCount, 0.0f);
+    std::vector<std::int32_t> results(TestSampleCount);
+
+    // 24-bit audio in 32-bit integers has its LSB at 256
+    Ditherer ditherer;
+    SampleConverter::QuantizeDithered(
+      silence.data(), results.data(), 24, TestSampleCount, ditherer
+    );
+    for(std::size_t index = 0; index < TestSampleCount; ++index) {
+      ASSERT_EQ(results[index] % 256, 0);
+      ASSERT_LE(std::abs(results[index]), 256);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,134 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/DownmixMatrix.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Channels of a 5.1 surround track in the WaveformatExtensible order</summary>
+  const std::vector<Nuclex::Audio::ChannelPlacement> FiveDotOneChannels = {
+    Nuclex::Audio::ChannelPlacement::FrontLeft,
+    Nuclex::Audio::ChannelPlacement::FrontRight,
+    Nuclex::Audio::ChannelPlacement::FrontCenter,
+    Nuclex::Audio::ChannelPlacement::LowFrequencyEffects,
+    Nuclex::Audio::ChannelPlacement::BackLeft,
+    Nuclex::Audio::ChannelPlacement::BackRight
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixMatrixTests, RequiresCoefficientForEachChannelPair) {
+    EXPECT_THROW(
+      DownmixMatrix(
+        FiveDotOneChannels, { ChannelPlacement::FrontCenter }, std::vector<float>(5)
+      ),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      DownmixMatrix(
+        std::vector<ChannelPlacement>(), { ChannelPlacement::FrontCenter }, std::vector<float>()
+      ),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixMatrixTests, ItuStereoPresetFollowsStandard) {
+    DownmixMatrix matrix = DownmixMatrix::CreateItuStereo(FiveDotOneChannels);
+
+    ASSERT_EQ(matrix.CountInputChannels(), 6U);
+    ASSERT_EQ(matrix.CountOutputChannels(), 2U);
+    EXPECT_EQ(matrix.GetOutputChannelOrder()[0], ChannelPlacement::FrontLeft);
+    EXPECT_EQ(matrix.GetOutputChannelOrder()[1], ChannelPlacement::FrontRight);
+
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 0), 1.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 1), 0.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(0, 2), 0.7071f, 0.0001f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 3), 0.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(0, 4), 0.7071f, 0.0001f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(0, 5), 0.0f);
+
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(1, 0), 0.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(1, 1), 1.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(1, 2), 0.7071f, 0.0001f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(1, 3), 0.0f);
+    EXPECT_FLOAT_EQ(matrix.GetCoefficient(1, 4), 0.0f);
+    EXPECT_NEAR(matrix.GetCoefficient(1, 5), 0.7071f, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixMatrixTests, PresetsRejectUnknownChannels) {
+    std::vector<ChannelPlacement> channels = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::Unknown
+    };
+    EXPECT_THROW(DownmixMatrix::CreateItuStereo(channels), std::invalid_argument);
+    EXPECT_THROW(DownmixMatrix::CreateItuMono(channels), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixMatrixTests, CanMixSeparatedChannels) {
+    DownmixMatrix matrix = DownmixMatrix::CreateItuMono(FiveDotOneChannels);
+
+    // Use an odd number of frames so both the vectorized and the scalar paths run
+    const std::size_t frameCount = 7;
+    std::vector<std::vector<float>> channels(6, std::vector<float>(frameCount));
+    const float *inputs[6];
+    for(std::size_t channelIndex = 0; channelIndex < 6; ++channelIndex) {
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        channels[channelIndex][frameIndex] = static_cast<float>(
+          (channelIndex + 1) * (frameIndex + 1)
+        ) / 100.0f;
+      }
+      inputs[channelIndex] = channels[channelIndex].data();
+    }
+
+    std::vector<float> mono(frameCount);
+    float *outputs[] = { mono.data() };
+    matrix.MixSeparated(inputs, outputs, frameCount);
+
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      float expected = 0.0f;
+      for(std::size_t channelIndex = 0; channelIndex < 6; ++channelIndex) {
+        expected += channels[channelIndex][frameIndex] * matrix.GetCoefficient(0, channelIndex);
+      }
+      EXPECT_NEAR(mono[frameIndex], expected, 0.00001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,126 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/FftPlan.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::cos(), std::sin()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>The number pi with enough digits for double precision</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a reproducible signal with energy in many bins</summary>
+  /// <param name="size">Number of samples that will be generated</param>
+  /// <returns>The generated signal</returns>
+  std::vector<float> makeSignal(std::size_t size) {
+    std::vector<float> signal(size);
+    std::uint32_t state = 12345;
+    for(std::size_t index = 0; index < size; ++index) {
+      state = state * 1664525U + 1013904223U;
+      signal[index] = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+    }
+    return signal;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FftPlanTests, RejectsInvalidSizes) {
+    EXPECT_THROW(FftPlan(0), std::invalid_argument);
+    EXPECT_THROW(FftPlan(4), std::invalid_argument);
+    EXPECT_THROW(FftPlan(1000), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FftPlanTests, SharesPlansOfSameSize) {
+    std::shared_ptr<const FftPlan> first = FftPlan::GetShared(1024);
+    std::shared_ptr<const FftPlan> second = FftPlan::GetShared(1024);
+    std::shared_ptr<const FftPlan> other = FftPlan::GetShared(512);
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), other.get());
+    EXPECT_EQ(first->CountBins(), 513U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FftPlanTests, MatchesDiscreteFourierTransform) {
+    for(std::size_t size : { 8, 16, 64, 512 }) {
+      FftPlan plan(size);
+      std::vector<float> signal = makeSignal(size);
+
+      std::vector<float> real(plan.CountBins()), imaginary(plan.CountBins());
+      std::vector<float> scratch(plan.CountScratchSamples());
+      plan.Transform(signal.data(), real.data(), imaginary.data(), scratch.data());
+
+      for(std::size_t bin = 0; bin < plan.CountBins(); ++bin) {
+        double expectedReal = 0.0, expectedImaginary = 0.0;
+        for(std::size_t index = 0; index < size; ++index) {
+          double angle = -2.0 * Pi * static_cast<double>(bin * index) / static_cast<double>(size);
+          expectedReal += signal[index] * std::cos(angle);
+          expectedImaginary += signal[index] * std::sin(angle);
+        }
+
+        double tolerance = 1e-5 * static_cast<double>(size);
+        EXPECT_NEAR(real[bin], expectedReal, tolerance) << "size " << size << ", bin " << bin;
+        EXPECT_NEAR(imaginary[bin], expectedImaginary, tolerance) << "size " << size;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FftPlanTests, ComputesScaledPowers) {
+    FftPlan plan(256);
+
+    std::vector<float> signal(256);
+    for(std::size_t index = 0; index < 256; ++index) {
+      signal[index] = static_cast<float>(std::cos(2.0 * Pi * 10.0 * index / 256.0));
+    }
+
+    std::vector<float> powers(plan.CountBins());
+    std::vector<float> scratch(plan.CountScratchSamples());
+    plan.ComputePowers(signal.data(), powers.data(), 2.0f / 256.0f, scratch.data());
+
+    EXPECT_NEAR(powers[10], 1.0f, 1e-4f);
+    EXPECT_NEAR(powers[0], 0.0f, 1e-6f);
+    EXPECT_NEAR(powers[11], 0.0f, 1e-6f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,202 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Int24Packing.h"
+
+#include <gtest/gtest.h>
+
+#include <utility> // for std::swap()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of samples the tests will pack and unpack at once</summary>
+  /// <remarks>
+  ///   Every count up to this is tried so that all the kernels' tails are exercised
+  /// </remarks>
+  const std::size_t MaximumTestSampleCount = 40;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates a 24-bit sample value covering positive and negative values</summary>
+  /// <param name="index">Index of the sample whose value will be calculated</param>
+  /// <returns>A 24-bit sample value that is different for each index</returns>
+  std::int32_t getTestSample(std::size_t index) {
+    switch(index % 4) {
+      case 0: { return -8388608 + static_cast<std::int32_t>(index); }
+      case 1: { return 8388607 - static_cast<std::int32_t>(index); }
+      case 2: { return static_cast<std::int32_t>(index * 70001) - 4194304; }
+      default: { return -static_cast<std::int32_t>(index); }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs 24-bit samples the obvious way so the kernels can be checked</summary>
+  /// <param name="values">Samples that will be packed</param>
+  /// <returns>The packed samples, 3 bytes each, little endian</returns>
+  std::vector<std::byte> packReference(const std::vector<std::int32_t> &values) {
+    std::vector<std::byte> packed;
+    for(std::int32_t value : values) {
+      packed.push_back(static_cast<std::byte>(value & 0xFF));
+      packed.push_back(static_cast<std::byte>((value >> 8) & 0xFF));
+      packed.push_back(static_cast<std::byte>((value >> 16) & 0xFF));
+    }
+    return packed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, UnpackingSignExtendsSamples) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::int32_t> expected;
+      for(std::size_t index = 0; index < count; ++index) {
+        expected.push_back(getTestSample(index));
+      }
+      std::vector<std::byte> packed = packReference(expected);
+
+      // Sentinel behind the last sample verifies the kernels stay within the target
+      std::vector<std::int32_t> unpacked(count + 1, 12345);
+      Int24Packing::UnpackToInt32(packed.data(), unpacked.data(), count);
+
+      for(std::size_t index = 0; index < count; ++index) {
+        EXPECT_EQ(unpacked[index], expected[index]);
+      }
+      EXPECT_EQ(unpacked[count], 12345);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, CanUnpackBigEndianSamples) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::int32_t> expected;
+      for(std::size_t index = 0; index < count; ++index) {
+        expected.push_back(getTestSample(index));
+      }
+      std::vector<std::byte> packed = packReference(expected);
+      for(std::size_t index = 0; index < count; ++index) {
+        std::swap(packed[index * 3], packed[index * 3 + 2]);
+      }
+
+      std::vector<std::int32_t> unpacked(count + 1, 12345);
+      Int24Packing::UnpackBigEndianToInt32(packed.data(), unpacked.data(), count);
+
+      for(std::size_t index = 0; index < count; ++index) {
+        EXPECT_EQ(unpacked[index], expected[index]);
+      }
+      EXPECT_EQ(unpacked[count], 12345);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, PackingWritesThreeBytesPerSample) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::int32_t> values;
+      for(std::size_t index = 0; index < count; ++index) {
+        values.push_back(getTestSample(index));
+      }
+      std::vector<std::byte> expected = packReference(values);
+
+      std::vector<std::byte> packed(count * 3 + 1, std::byte(0xA5));
+      Int24Packing::PackFromInt32(values.data(), packed.data(), count);
+
+      for(std::size_t index = 0; index < count * 3; ++index) {
+        EXPECT_EQ(packed[index], expected[index]);
+      }
+      EXPECT_EQ(packed[count * 3], std::byte(0xA5));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, CanUnpackToHighInt32) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::int32_t> values;
+      for(std::size_t index = 0; index < count; ++index) {
+        values.push_back(getTestSample(index));
+      }
+      std::vector<std::byte> packed = packReference(values);
+
+      std::vector<std::int32_t> results(count);
+      Int24Packing::UnpackToHighInt32(packed.data(), results.data(), count);
+
+      for(std::size_t index = 0; index < count; ++index) {
+        EXPECT_EQ(results[index], static_cast<std::int32_t>(std::uint32_t(values[index]) << 8));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, PackingHighBitsDropsLowestByte) {
+    for(std::size_t count = 0; count <= MaximumTestSampleCount; ++count) {
+      std::vector<std::int32_t> values, highValues;
+      for(std::size_t index = 0; index < count; ++index) {
+        values.push_back(getTestSample(index));
+        highValues.push_back(
+          static_cast<std::int32_t>(std::uint32_t(values.back()) << 8) |
+          static_cast<std::int32_t>(index & 0xFF)
+        );
+      }
+      std::vector<std::byte> expected = packReference(values);
+
+      std::vector<std::byte> packed(count * 3 + 1, std::byte(0xA5));
+      Int24Packing::PackHighFromInt32(highValues.data(), packed.data(), count);
+
+      for(std::size_t index = 0; index < count * 3; ++index) {
+        EXPECT_EQ(packed[index], expected[index]);
+      }
+      EXPECT_EQ(packed[count * 3], std::byte(0xA5));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Int24PackingTests, CanUnpackToFloat) {
+    std::vector<std::int32_t> values = { -8388608, -4194304, 0, 4194304, 8388607 };
+    std::vector<std::byte> packed = packReference(values);
+
+    std::vector<float> floats(values.size());
+    Int24Packing::UnpackToFloat(packed.data(), 0, 8388607.0, floats.data(), values.size());
+
+    std::vector<double> doubles(values.size());
+    Int24Packing::UnpackToFloat(packed.data(), 0, 8388607.0, doubles.data(), values.size());
+
+    for(std::size_t index = 0; index < values.size(); ++index) {
+      EXPECT_FLOAT_EQ(floats[index], static_cast<float>(values[index] / 8388607.0));
+      EXPECT_DOUBLE_EQ(doubles[index], values[index] / 8388607.0);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
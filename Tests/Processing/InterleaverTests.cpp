@@ -0,0 +1,161 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Interleaver.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Odd number of frames so that the kernels' tail handling is exercised</summary>
+  const std::size_t TestFrameCount = 27;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates a sample value that identifies its channel and frame</summary>
+  /// <param name="channelIndex">Index of the channel the sample belongs to</param>
+  /// <param name="frameIndex">Index of the frame the sample belongs to</param>
+  /// <returns>A sample value unique to the channel and frame</returns>
+  template<typename TSample>
+  TSample getTestSample(std::size_t channelIndex, std::size_t frameIndex) {
+    return static_cast<TSample>(channelIndex * 31 + frameIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interleaves test channels and checks every sample ends up in its place</summary>
+  /// <param name="channelCount">Number of channels that will be interleaved</param>
+  template<typename TSample>
+  void checkInterleave(std::size_t channelCount) {
+    std::vector<std::vector<TSample>> channels(channelCount);
+    std::vector<const TSample *> sources(channelCount);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+        channels[channelIndex].push_back(getTestSample<TSample>(channelIndex, frameIndex));
+      }
+      sources[channelIndex] = channels[channelIndex].data();
+    }
+
+    std::vector<TSample> interleaved(TestFrameCount * channelCount);
+    Nuclex::Audio::Processing::Interleaver::Interleave(
+      sources.data(), interleaved.data(), channelCount, TestFrameCount
+    );
+
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        EXPECT_EQ(
+          interleaved[frameIndex * channelCount + channelIndex],
+          getTestSample<TSample>(channelIndex, frameIndex)
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Separates test frames and checks every sample ends up in its place</summary>
+  /// <param name="channelCount">Number of channels that will be separated</param>
+  template<typename TSample>
+  void checkDeinterleave(std::size_t channelCount) {
+    std::vector<TSample> interleaved;
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        interleaved.push_back(getTestSample<TSample>(channelIndex, frameIndex));
+      }
+    }
+
+    std::vector<std::vector<TSample>> channels(
+      channelCount, std::vector<TSample>(TestFrameCount)
+    );
+    std::vector<TSample *> targets(channelCount);
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      targets[channelIndex] = channels[channelIndex].data();
+    }
+
+    Nuclex::Audio::Processing::Interleaver::Deinterleave(
+      interleaved.data(), targets.data(), channelCount, TestFrameCount
+    );
+
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+        EXPECT_EQ(
+          channels[channelIndex][frameIndex], getTestSample<TSample>(channelIndex, frameIndex)
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InterleaverTests, CanInterleaveAnyChannelCount) {
+    for(std::size_t channelCount = 1; channelCount <= 10; ++channelCount) {
+      checkInterleave<float>(channelCount);
+      checkInterleave<std::int32_t>(channelCount);
+      checkInterleave<std::int16_t>(channelCount);
+      checkInterleave<double>(channelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InterleaverTests, CanDeinterleaveAnyChannelCount) {
+    for(std::size_t channelCount = 1; channelCount <= 10; ++channelCount) {
+      checkDeinterleave<float>(channelCount);
+      checkDeinterleave<std::int32_t>(channelCount);
+      checkDeinterleave<std::uint8_t>(channelCount);
+      checkDeinterleave<double>(channelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InterleaverTests, DeinterleaveSkipsChannelsWithoutTarget) {
+    std::vector<float> interleaved;
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < 4; ++channelIndex) {
+        interleaved.push_back(getTestSample<float>(channelIndex, frameIndex));
+      }
+    }
+
+    std::vector<float> second(TestFrameCount), fourth(TestFrameCount);
+    float *targets[] = { nullptr, second.data(), nullptr, fourth.data() };
+    Interleaver::Deinterleave(interleaved.data(), targets, 4, TestFrameCount);
+
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      EXPECT_EQ(second[frameIndex], getTestSample<float>(1, frameIndex));
+      EXPECT_EQ(fourth[frameIndex], getTestSample<float>(3, frameIndex));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,216 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/LoudnessMeter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::sin(), std::pow(), std::isinf(), std::round()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample rate used by all the tests</summary>
+  const std::size_t TestSampleRate = 48000;
+
+  /// <summary>The number pi, for generating sine waves</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates interleaved samples with a sine wave in some of the channels</summary>
+  /// <param name="channelMask">Bit mask of the channels which should carry the sine</param>
+  /// <param name="channelCount">Number of interleaved channels</param>
+  /// <param name="frameCount">Number of frames that will be generated</param>
+  /// <param name="decibels">Peak level of the sine wave relative to full scale</param>
+  /// <param name="frequency">Frequency of the sine wave in Hz</param>
+  /// <returns>The interleaved samples</returns>
+  std::vector<float> makeSine(
+    std::size_t channelMask, std::size_t channelCount, std::size_t frameCount,
+    double decibels, double frequency = 997.0
+  ) {
+    double amplitude = std::pow(10.0, decibels / 20.0);
+
+    std::vector<float> samples(frameCount * channelCount, 0.0f);
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      double time = static_cast<double>(frameIndex) / static_cast<double>(TestSampleRate);
+      float value = static_cast<float>(amplitude * std::sin(2.0 * Pi * frequency * time));
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        if((channelMask & (std::size_t(1) << channelIndex)) != 0) {
+          samples[frameIndex * channelCount + channelIndex] = value;
+        }
+      }
+    }
+
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Channel order of a stereo track</summary>
+  const std::vector<Nuclex::Audio::ChannelPlacement> StereoChannels = {
+    Nuclex::Audio::ChannelPlacement::FrontLeft,
+    Nuclex::Audio::ChannelPlacement::FrontRight
+  };
+
+  /// <summary>Channel order of a 5.1 surround track in Waveform order</summary>
+  const std::vector<Nuclex::Audio::ChannelPlacement> SurroundChannels = {
+    Nuclex::Audio::ChannelPlacement::FrontLeft,
+    Nuclex::Audio::ChannelPlacement::FrontRight,
+    Nuclex::Audio::ChannelPlacement::FrontCenter,
+    Nuclex::Audio::ChannelPlacement::LowFrequencyEffects,
+    Nuclex::Audio::ChannelPlacement::SideLeft,
+    Nuclex::Audio::ChannelPlacement::SideRight
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, RejectsInvalidArguments) {
+    EXPECT_THROW(LoudnessMeter meter(0, StereoChannels), std::invalid_argument);
+    EXPECT_THROW(
+      LoudnessMeter meter(TestSampleRate, std::vector<ChannelPlacement>()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, SilenceHasNoLoudness) {
+    LoudnessMeter meter(TestSampleRate, StereoChannels);
+    EXPECT_TRUE(std::isinf(meter.GetMomentaryLoudness()));
+    EXPECT_TRUE(std::isinf(meter.GetIntegratedLoudness()));
+
+    std::vector<float> silence(TestSampleRate * 2 * 2, 0.0f);
+    meter.ProcessInterleaved(silence.data(), TestSampleRate * 2);
+    EXPECT_TRUE(std::isinf(meter.GetMomentaryLoudness()));
+    EXPECT_TRUE(std::isinf(meter.GetIntegratedLoudness()));
+    EXPECT_EQ(meter.GetTruePeak(), 0.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, StereoSineMeasuresAtItsLevel) {
+
+    // The reference from EBU Tech 3341: a 1 kHz sine at -23 dBFS in both stereo
+    // channels has a loudness of -23 LUFS
+    std::vector<float> samples = makeSine(3, 2, TestSampleRate * 5, -23.0);
+
+    LoudnessMeter meter(TestSampleRate, StereoChannels);
+    meter.ProcessInterleaved(samples.data(), TestSampleRate * 5);
+
+    EXPECT_NEAR(meter.GetMomentaryLoudness(), -23.0, 0.1);
+    EXPECT_NEAR(meter.GetShortTermLoudness(), -23.0, 0.1);
+    EXPECT_NEAR(meter.GetIntegratedLoudness(), -23.0, 0.1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, IntegerSamplesMeasureLikeFloats) {
+    std::vector<float> samples = makeSine(3, 2, TestSampleRate * 2, -10.0);
+    std::vector<std::int16_t> shorts(samples.size());
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      shorts[index] = static_cast<std::int16_t>(std::round(samples[index] * 32767.0f));
+    }
+
+    LoudnessMeter floatMeter(TestSampleRate, StereoChannels);
+    floatMeter.ProcessInterleaved(samples.data(), TestSampleRate * 2);
+    LoudnessMeter shortMeter(TestSampleRate, StereoChannels);
+    shortMeter.ProcessInterleaved(shorts.data(), TestSampleRate * 2);
+
+    EXPECT_NEAR(shortMeter.GetIntegratedLoudness(), floatMeter.GetIntegratedLoudness(), 0.01);
+    EXPECT_NEAR(shortMeter.GetTruePeak(), floatMeter.GetTruePeak(), 0.001);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, AppliesChannelWeights) {
+    std::vector<float> front = makeSine(1, 6, TestSampleRate * 2, -20.0);
+    std::vector<float> lfe = makeSine(8, 6, TestSampleRate * 2, -20.0);
+    std::vector<float> surround = makeSine(16, 6, TestSampleRate * 2, -20.0);
+
+    LoudnessMeter frontMeter(TestSampleRate, SurroundChannels);
+    frontMeter.ProcessInterleaved(front.data(), TestSampleRate * 2);
+    LoudnessMeter lfeMeter(TestSampleRate, SurroundChannels);
+    lfeMeter.ProcessInterleaved(lfe.data(), TestSampleRate * 2);
+    LoudnessMeter surroundMeter(TestSampleRate, SurroundChannels);
+    surroundMeter.ProcessInterleaved(surround.data(), TestSampleRate * 2);
+
+    // The LFE channel doesn't count and surround channels count 1.5 dB more
+    EXPECT_TRUE(std::isinf(lfeMeter.GetIntegratedLoudness()));
+    EXPECT_NEAR(
+      surroundMeter.GetIntegratedLoudness() - frontMeter.GetIntegratedLoudness(), 1.49, 0.01
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, RelativeGateIgnoresQuietPassages) {
+    std::vector<float> loud = makeSine(3, 2, TestSampleRate * 5, -20.0);
+    std::vector<float> quiet = makeSine(3, 2, TestSampleRate * 5, -45.0);
+
+    // Odd block sizes should make no difference
+    LoudnessMeter meter(TestSampleRate, StereoChannels);
+    for(std::size_t frame = 0; frame < TestSampleRate * 5; frame += 1234) {
+      std::size_t frameCount = std::min<std::size_t>(1234, TestSampleRate * 5 - frame);
+      meter.ProcessInterleaved(loud.data() + frame * 2, frameCount);
+    }
+    meter.ProcessInterleaved(quiet.data(), TestSampleRate * 5);
+
+    // The few blocks that straddle the transition still pass the relative gate,
+    // but the quiet passage itself must not pull the result down to -23 LUFS
+    EXPECT_NEAR(meter.GetIntegratedLoudness(), -20.0, 0.2);
+    EXPECT_NEAR(meter.GetMomentaryLoudness(), -45.0, 0.1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoudnessMeterTests, DetectsPeaksBetweenSamples) {
+
+    // A sine at a quarter of the sample rate, shifted by 45 degrees, never has
+    // a sample at its crest. The highest samples are only at 70% of the peak.
+    std::vector<float> samples(TestSampleRate);
+    for(std::size_t index = 0; index < TestSampleRate; ++index) {
+      samples[index] = static_cast<float>(
+        0.5 * std::sin(Pi / 2.0 * static_cast<double>(index) + Pi / 4.0)
+      );
+    }
+
+    LoudnessMeter meter(TestSampleRate, { ChannelPlacement::FrontCenter });
+    meter.ProcessInterleaved(samples.data(), TestSampleRate);
+
+    EXPECT_NEAR(meter.GetTruePeak(), 0.5, 0.01);
+    EXPECT_NEAR(meter.GetTruePeakDecibels(), -6.02, 0.2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,296 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/PeakPyramid.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../Storage/ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min(), std::max()
+#include <cmath> // for std::sqrt()
+#include <future> // for std::future
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a ramp of samples running from -1 towards 1</summary>
+  /// <param name="sampleCount">Number of samples that will be generated</param>
+  /// <returns>A buffer holding the ramp</returns>
+  std::vector<float> generateRamp(std::size_t sampleCount) {
+    std::vector<float> samples(sampleCount);
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      samples[index] = (
+        static_cast<float>(index) / static_cast<float>(sampleCount) * 2.0f - 1.0f
+      );
+    }
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, RequiresNestedBucketSizes) {
+    EXPECT_THROW(PeakPyramid(0), std::invalid_argument);
+    EXPECT_THROW(PeakPyramid(1, std::vector<std::size_t>()), std::invalid_argument);
+    EXPECT_THROW(PeakPyramid(1, { 256, 1000 }), std::invalid_argument);
+    EXPECT_THROW(PeakPyramid(1, { 4096, 256 }), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, BucketsMatchSamples) {
+    std::vector<float> ramp = generateRamp(10000);
+    std::vector<float> silence(10000, 0.0f);
+
+    PeakPyramid pyramid(2, { 100, 1000 });
+
+    // Feed in odd chunk sizes so buckets get completed halfway through calls
+    for(std::size_t start = 0; start < ramp.size(); start += 333) {
+      std::size_t count = std::min<std::size_t>(333, ramp.size() - start);
+      const float *channels[] = { ramp.data() + start, silence.data() + start };
+      pyramid.ProcessSeparated(channels, count);
+    }
+    pyramid.Finish();
+
+    EXPECT_EQ(pyramid.CountFrames(), 10000U);
+    ASSERT_EQ(pyramid.CountBuckets(0), 100U);
+    ASSERT_EQ(pyramid.CountBuckets(1), 10U);
+
+    for(std::size_t level = 0; level < 2; ++level) {
+      std::size_t bucketFrameCount = pyramid.GetBucketFrameCount(level);
+      for(std::size_t bucket = 0; bucket < pyramid.CountBuckets(level); ++bucket) {
+        const float *samples = ramp.data() + (bucket * bucketFrameCount);
+
+        double squareSum = 0.0;
+        for(std::size_t index = 0; index < bucketFrameCount; ++index) {
+          squareSum += static_cast<double>(samples[index]) * samples[index];
+        }
+
+        const PeakBucket &actual = pyramid.GetBucket(level, 0, bucket);
+        EXPECT_FLOAT_EQ(actual.Minimum, samples[0]);
+        EXPECT_FLOAT_EQ(actual.Maximum, samples[bucketFrameCount - 1]);
+        EXPECT_NEAR(actual.Rms, std::sqrt(squareSum / bucketFrameCount), 0.0001f);
+
+        const PeakBucket &silent = pyramid.GetBucket(level, 1, bucket);
+        EXPECT_EQ(silent.Minimum, 0.0f);
+        EXPECT_EQ(silent.Maximum, 0.0f);
+        EXPECT_EQ(silent.Rms, 0.0f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, LastBucketCanBePartial) {
+    std::vector<float> samples(1050, 0.5f);
+    samples[1049] = -1.0f;
+
+    PeakPyramid pyramid(1, { 100, 400 });
+    const float *channels[] = { samples.data() };
+    pyramid.ProcessSeparated(channels, samples.size());
+    pyramid.Finish();
+
+    ASSERT_EQ(pyramid.CountBuckets(0), 11U);
+    ASSERT_EQ(pyramid.CountBuckets(1), 3U);
+
+    // The last fine bucket holds 50 frames, 49 at 0.5 and one at -1.0
+    const PeakBucket &fine = pyramid.GetBucket(0, 0, 10);
+    EXPECT_FLOAT_EQ(fine.Minimum, -1.0f);
+    EXPECT_FLOAT_EQ(fine.Maximum, 0.5f);
+    EXPECT_NEAR(fine.Rms, std::sqrt((49.0 * 0.25 + 1.0) / 50.0), 0.0001f);
+
+    // The last coarse bucket holds 250 frames, 249 at 0.5 and one at -1.0
+    const PeakBucket &coarse = pyramid.GetBucket(1, 0, 2);
+    EXPECT_NEAR(coarse.Rms, std::sqrt((249.0 * 0.25 + 1.0) / 250.0), 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, SelectsCoarsestSufficientLevel) {
+    PeakPyramid pyramid(1);
+    EXPECT_EQ(pyramid.SelectLevel(1), 0U);
+    EXPECT_EQ(pyramid.SelectLevel(4095), 0U);
+    EXPECT_EQ(pyramid.SelectLevel(4096), 1U);
+    EXPECT_EQ(pyramid.SelectLevel(100000), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, CanBeSerializedAndRestored) {
+    std::vector<float> ramp = generateRamp(5000);
+
+    PeakPyramid pyramid(1, { 64, 256 });
+    const float *channels[] = { ramp.data() };
+    pyramid.ProcessSeparated(channels, ramp.size());
+
+    EXPECT_THROW(pyramid.Serialize(), std::logic_error);
+    pyramid.Finish();
+
+    std::vector<std::byte> serialized = pyramid.Serialize();
+    PeakPyramid restored = PeakPyramid::Deserialize(serialized);
+
+    ASSERT_EQ(restored.CountChannels(), 1U);
+    ASSERT_EQ(restored.CountFrames(), 5000U);
+    ASSERT_EQ(restored.CountLevels(), 2U);
+    for(std::size_t level = 0; level < 2; ++level) {
+      ASSERT_EQ(restored.CountBuckets(level), pyramid.CountBuckets(level));
+      for(std::size_t bucket = 0; bucket < pyramid.CountBuckets(level); ++bucket) {
+        const PeakBucket &expected = pyramid.GetBucket(level, 0, bucket);
+        const PeakBucket &actual = restored.GetBucket(level, 0, bucket);
+        EXPECT_NEAR(actual.Minimum, expected.Minimum, 0.0001f);
+        EXPECT_NEAR(actual.Maximum, expected.Maximum, 0.0001f);
+        EXPECT_NEAR(actual.Rms, expected.Rms, 0.0001f);
+      }
+    }
+
+    serialized.pop_back();
+    EXPECT_THROW(PeakPyramid::Deserialize(serialized), Errors::CorruptedFileError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, CanBuildFromDecoder) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder.CountFrames());
+    std::size_t channelCount = decoder.CountChannels();
+    std::vector<float> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    PeakPyramid pyramid = PeakPyramid::Build(decoder, { 256, 4096 });
+    ASSERT_EQ(pyramid.CountChannels(), channelCount);
+    ASSERT_EQ(pyramid.CountFrames(), frameCount);
+    ASSERT_EQ(pyramid.CountBuckets(0), (frameCount + 255) / 256);
+
+    for(std::size_t channel = 0; channel < channelCount; ++channel) {
+      float minimum = samples[channel], maximum = samples[channel];
+      for(std::size_t frame = 0; frame < std::min<std::size_t>(4096, frameCount); ++frame) {
+        minimum = std::min(minimum, samples[frame * channelCount + channel]);
+        maximum = std::max(maximum, samples[frame * channelCount + channel]);
+      }
+
+      EXPECT_EQ(pyramid.GetBucket(1, channel, 0).Minimum, minimum);
+      EXPECT_EQ(pyramid.GetBucket(1, channel, 0).Maximum, maximum);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, SkimWithoutStrideMatchesBlockLevels) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.GetBlockSize(0), 4096U);
+
+    PeakPyramid exact = PeakPyramid::Build(decoder, { 256, 4096 });
+    PeakPyramid skimmed = PeakPyramid::Skim(decoder, 1, { 256, 4096 });
+    EXPECT_FALSE(exact.IsApproximate());
+    EXPECT_TRUE(skimmed.IsApproximate());
+    ASSERT_EQ(skimmed.CountFrames(), exact.CountFrames());
+    ASSERT_EQ(skimmed.CountBuckets(0), exact.CountBuckets(0));
+    ASSERT_EQ(skimmed.CountBuckets(1), exact.CountBuckets(1));
+
+    // With every block decoded, the block-sized level is exact
+    for(std::size_t channel = 0; channel < exact.CountChannels(); ++channel) {
+      for(std::size_t bucket = 0; bucket < exact.CountBuckets(1); ++bucket) {
+        const PeakBucket &expected = exact.GetBucket(1, channel, bucket);
+        EXPECT_EQ(skimmed.GetBucket(1, channel, bucket).Minimum, expected.Minimum);
+        EXPECT_EQ(skimmed.GetBucket(1, channel, bucket).Maximum, expected.Maximum);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, SkimStaysWithinExactLevels) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+
+    EXPECT_THROW(PeakPyramid::Skim(decoder, 0), std::invalid_argument);
+
+    PeakPyramid exact = PeakPyramid::Build(decoder, { 256, 4096 });
+    PeakPyramid skimmed = PeakPyramid::Skim(decoder, 3, { 256, 4096 });
+    ASSERT_EQ(skimmed.CountFrames(), exact.CountFrames());
+    ASSERT_EQ(skimmed.CountBuckets(0), exact.CountBuckets(0));
+
+    for(std::size_t channel = 0; channel < exact.CountChannels(); ++channel) {
+      float minimum = exact.GetBucket(1, channel, 0).Minimum;
+      float maximum = exact.GetBucket(1, channel, 0).Maximum;
+      for(std::size_t bucket = 1; bucket < exact.CountBuckets(1); ++bucket) {
+        minimum = std::min(minimum, exact.GetBucket(1, channel, bucket).Minimum);
+        maximum = std::max(maximum, exact.GetBucket(1, channel, bucket).Maximum);
+      }
+
+      // Skimmed levels come from real blocks, so they can't exceed the track's extremes
+      EXPECT_EQ(skimmed.GetBucket(1, channel, 0).Minimum, exact.GetBucket(1, channel, 0).Minimum);
+      for(std::size_t bucket = 0; bucket < skimmed.CountBuckets(0); ++bucket) {
+        EXPECT_GE(skimmed.GetBucket(0, channel, bucket).Minimum, minimum);
+        EXPECT_LE(skimmed.GetBucket(0, channel, bucket).Maximum, maximum);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PeakPyramidTests, CanBuildInBackground) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+
+    std::future<PeakPyramid> refinement = PeakPyramid::BuildAsync(decoder, { 256, 4096 });
+    PeakPyramid exact = PeakPyramid::Build(decoder, { 256, 4096 });
+
+    PeakPyramid refined = refinement.get();
+    EXPECT_FALSE(refined.IsApproximate());
+    EXPECT_EQ(refined.Serialize(), exact.Serialize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -25,6 +25,8 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <algorithm> // for std::equal()
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -181,4 +183,42 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(QuantizationTests, WideVariantsMatchFourWideVariant) {
+    float floats[16];
+    double doubles[16];
+    for(std::size_t index = 0; index < 16; ++index) {
+      floats[index] = static_cast<float>(index) * 0.37f - 2.5f;
+      doubles[index] = static_cast<double>(floats[index]);
+    }
+
+    std::int32_t expected[16];
+    std::int32_t actual[16];
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Quantization::MultiplyToNearestInt32x4(floats + index, 1000.0f, expected + index);
+    }
+    Quantization::MultiplyToNearestInt32x8(floats, 1000.0f, actual);
+    Quantization::MultiplyToNearestInt32x8(floats + 8, 1000.0f, actual + 8);
+    EXPECT_TRUE(std::equal(expected, expected + 16, actual));
+    Quantization::MultiplyToNearestInt32x16(floats, 1000.0f, actual);
+    EXPECT_TRUE(std::equal(expected, expected + 16, actual));
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Quantization::MultiplyToNearestInt32x4(floats + index, 8388607.0, expected + index);
+    }
+    Quantization::MultiplyToNearestInt32x16(floats, 8388607.0, actual);
+    EXPECT_TRUE(std::equal(expected, expected + 16, actual));
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Quantization::MultiplyToNearestInt32x4(doubles + index, 8388607.0, expected + index);
+    }
+    Quantization::MultiplyToNearestInt32x8(doubles, 8388607.0, actual);
+    Quantization::MultiplyToNearestInt32x8(doubles + 8, 8388607.0, actual + 8);
+    EXPECT_TRUE(std::equal(expected, expected + 16, actual));
+    Quantization::MultiplyToNearestInt32x16(doubles, 8388607.0, actual);
+    EXPECT_TRUE(std::equal(expected, expected + 16, actual));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
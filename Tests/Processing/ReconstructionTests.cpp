@@ -25,6 +25,8 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <algorithm> // for std::equal()
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -206,4 +208,42 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(ReconstructionTests, WideVariantsMatchFourWideVariant) {
+    std::int32_t values[16];
+    for(std::size_t index = 0; index < 16; ++index) {
+      values[index] = (static_cast<std::int32_t>(index) - 8) * 1048573;
+    }
+
+    float expectedFloats[16], actualFloats[16];
+    double expectedDoubles[16], actualDoubles[16];
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Reconstruction::DivideInt32ToFloatx4(values + index, 32767.0f, expectedFloats + index);
+    }
+    Reconstruction::DivideInt32ToFloatx8(values, 32767.0f, actualFloats);
+    Reconstruction::DivideInt32ToFloatx8(values + 8, 32767.0f, actualFloats + 8);
+    EXPECT_TRUE(std::equal(expectedFloats, expectedFloats + 16, actualFloats));
+    Reconstruction::DivideInt32ToFloatx16(values, 32767.0f, actualFloats);
+    EXPECT_TRUE(std::equal(expectedFloats, expectedFloats + 16, actualFloats));
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Reconstruction::DivideInt32ToFloatx4(values + index, 8388607.0, expectedFloats + index);
+    }
+    Reconstruction::DivideInt32ToFloatx16(values, 8388607.0, actualFloats);
+    EXPECT_TRUE(std::equal(expectedFloats, expectedFloats + 16, actualFloats));
+
+    for(std::size_t index = 0; index < 16; index += 4) {
+      Reconstruction::ShiftAndDivideInt32ToFloatx4(
+        values + index, 4, 8388607.0, expectedDoubles + index
+      );
+    }
+    Reconstruction::ShiftAndDivideInt32ToFloatx8(values, 4, 8388607.0, actualDoubles);
+    Reconstruction::ShiftAndDivideInt32ToFloatx8(values + 8, 4, 8388607.0, actualDoubles + 8);
+    EXPECT_TRUE(std::equal(expectedDoubles, expectedDoubles + 16, actualDoubles));
+    Reconstruction::ShiftAndDivideInt32ToFloatx16(values, 4, 8388607.0, actualDoubles);
+    EXPECT_TRUE(std::equal(expectedDoubles, expectedDoubles + 16, actualDoubles));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,195 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/Resampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::sin()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a sine wave</summary>
+  /// <param name="frequency">Frequency of the sine wave relative to the sample rate</param>
+  /// <param name="sampleCount">Number of samples that will be generated</param>
+  /// <returns>A buffer holding the sine wave</returns>
+  std::vector<float> generateSine(double frequency, std::size_t sampleCount) {
+    std::vector<float> samples(sampleCount);
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      samples[index] = static_cast<float>(
+        std::sin(2.0 * 3.14159265358979323846 * frequency * static_cast<double>(index)) * 0.5
+      );
+    }
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Resamples a mono signal in chunks of the specified size</summary>
+  /// <param name="resampler">Resampler that will be used</param>
+  /// <param name="input">Samples that will be resampled</param>
+  /// <param name="chunkFrameCount">Number of frames fed into each call</param>
+  /// <returns>The resampled signal</returns>
+  std::vector<float> resampleInChunks(
+    Nuclex::Audio::Processing::Resampler &resampler,
+    const std::vector<float> &input, std::size_t chunkFrameCount
+  ) {
+    std::vector<float> output;
+    std::vector<float> chunkOutput;
+
+    for(std::size_t start = 0; start < input.size(); start += chunkFrameCount) {
+      std::size_t frameCount = std::min(chunkFrameCount, input.size() - start);
+      chunkOutput.resize(resampler.CountMaximumOutputFrames(frameCount));
+
+      const float *inputs[] = { input.data() + start };
+      float *outputs[] = { chunkOutput.data() };
+      std::size_t producedFrameCount = resampler.Process(inputs, frameCount, outputs);
+      EXPECT_LE(producedFrameCount, chunkOutput.size());
+
+      output.insert(output.end(), chunkOutput.begin(), chunkOutput.begin() + producedFrameCount);
+    }
+
+    return output;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, RejectsInvalidArguments) {
+    EXPECT_THROW(Resampler(0, 48000), std::invalid_argument);
+    EXPECT_THROW(Resampler(44100, 48000, 0), std::invalid_argument);
+    EXPECT_THROW(Resampler(48000, 1000), std::invalid_argument); // below 1/16th
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, KeepsConstantSignalLevel) {
+    const ResamplerQuality qualities[] = {
+      ResamplerQuality::Fast, ResamplerQuality::Balanced, ResamplerQuality::Best
+    };
+    for(ResamplerQuality quality : qualities) {
+      Resampler resampler(44100, 48000, 1, quality);
+
+      std::vector<float> input(4410, 0.5f);
+      std::vector<float> output = resampleInChunks(resampler, input, 4410);
+
+      // Frames from the start of the stream include the silence before it
+      std::size_t settledFrameCount = resampler.CountLookaheadFrames() * 2;
+      ASSERT_GT(output.size(), settledFrameCount);
+      for(std::size_t index = settledFrameCount; index < output.size(); ++index) {
+        EXPECT_NEAR(output[index], 0.5f, 0.001f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, ProducesOutputAtTargetRate) {
+    Resampler upsampler(44100, 48000);
+    std::vector<float> input(44100);
+    std::size_t upsampledFrameCount = resampleInChunks(upsampler, input, 1000).size();
+    EXPECT_EQ(upsampledFrameCount, 48000U - upsampler.CountLookaheadFrames() * 48000 / 44100);
+
+    Resampler downsampler(48000, 22050);
+    std::size_t downsampledFrameCount = resampleInChunks(downsampler, input, 1000).size();
+    EXPECT_NEAR(static_cast<double>(downsampledFrameCount), 44100.0 * 22050.0 / 48000.0, 20.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, StreamingMatchesSingleCall) {
+    std::vector<float> input = generateSine(1000.0 / 44100.0, 10000);
+
+    Resampler single(44100, 48000);
+    std::vector<float> expected = resampleInChunks(single, input, input.size());
+
+    Resampler streamed(44100, 48000);
+    std::vector<float> actual = resampleInChunks(streamed, input, 37);
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, PreservesSineWave) {
+    std::vector<float> input = generateSine(1000.0 / 48000.0, 9600);
+
+    Resampler resampler(48000, 32000, 1, ResamplerQuality::Best);
+    std::vector<float> output = resampleInChunks(resampler, input, 500);
+
+    // Output frames are aligned with the input, so they match the same sine
+    // sampled at the target rate once the filter has moved past the silence
+    std::vector<float> expected = generateSine(1000.0 / 32000.0, output.size());
+    for(std::size_t index = 100; index < output.size(); ++index) {
+      EXPECT_NEAR(output[index], expected[index], 0.001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, ResetStartsNewStream) {
+    std::vector<float> first = generateSine(440.0 / 44100.0, 2000);
+    std::vector<float> second = generateSine(880.0 / 44100.0, 2000);
+
+    Resampler fresh(44100, 48000, 1, ResamplerQuality::Fast);
+    std::vector<float> expected = resampleInChunks(fresh, second, 2000);
+
+    Resampler reused(44100, 48000, 1, ResamplerQuality::Fast);
+    resampleInChunks(reused, first, 300);
+    reused.Reset();
+    std::vector<float> actual = resampleInChunks(reused, second, 2000);
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplerTests, ChannelsAreResampledIndependently) {
+    std::vector<float> left = generateSine(440.0 / 44100.0, 1000);
+    std::vector<float> right = generateSine(1234.0 / 44100.0, 1000);
+
+    Resampler mono(44100, 48000);
+    std::vector<float> expectedRight = resampleInChunks(mono, right, 1000);
+
+    Resampler stereo(44100, 48000, 2);
+    std::vector<float> leftOutput(stereo.CountMaximumOutputFrames(1000));
+    std::vector<float> rightOutput(stereo.CountMaximumOutputFrames(1000));
+    const float *inputs[] = { left.data(), right.data() };
+    float *outputs[] = { leftOutput.data(), rightOutput.data() };
+    std::size_t frameCount = stereo.Process(inputs, 1000, outputs);
+
+    rightOutput.resize(frameCount);
+    EXPECT_EQ(rightOutput, expectedRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -25,6 +25,8 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <vector> // for std::vector
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 // Visual C++, up to Visual Studio 2022, wrongly warns that the lowest possible value
@@ -390,6 +392,207 @@ namespace Nuclex { namespace Audio { namespace Processing {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(SampleConverterTest, QuantizationCanApplyConstantGain) {
+    float inputSamples[5] = { -1.0f, -0.5f, 0.0f, 0.5f, 1.0f }; // 4 + 1 to hit both paths
+    std::int16_t outputSamples[5] = { 0, 0, 0, 0, 0 };
+
+    SampleConverter::Quantize(inputSamples, outputSamples, 16, 5, 0.5f);
+
+    EXPECT_EQ(outputSamples[0], -16384);
+    EXPECT_EQ(outputSamples[1], -8192);
+    EXPECT_EQ(outputSamples[2], 0);
+    EXPECT_EQ(outputSamples[3], 8192);
+    EXPECT_EQ(outputSamples[4], 16384);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, QuantizationCanApplyGainRamp) {
+    float inputSamples[6] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f };
+    std::int16_t outputSamples[6] = { 0, 0, 0, 0, 0, 0 };
+
+    // Ramp from 0.0 to 0.75, every sample advances the gain by 0.125
+    SampleConverter::Quantize(inputSamples, outputSamples, 16, 6, 0.0f, 0.75f);
+
+    EXPECT_EQ(outputSamples[0], 0);
+    EXPECT_EQ(outputSamples[1], 4096);
+    EXPECT_EQ(outputSamples[2], 8192);
+    EXPECT_EQ(outputSamples[3], 12288);
+    EXPECT_EQ(outputSamples[4], 16384);
+    EXPECT_EQ(outputSamples[5], -20479);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, ReconstructionCanApplyConstantGain) {
+    std::int16_t inputSamples[5] = { -32767, -16384, 0, 16384, 32767 };
+    float outputSamples[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    SampleConverter::Reconstruct(inputSamples, 16, outputSamples, 5, 0.5f);
+
+    EXPECT_FLOAT_EQ(outputSamples[0], -0.5f);
+    EXPECT_FLOAT_EQ(outputSamples[1], -16384.0f / 65534.0f);
+    EXPECT_FLOAT_EQ(outputSamples[2], 0.0f);
+    EXPECT_FLOAT_EQ(outputSamples[3], 16384.0f / 65534.0f);
+    EXPECT_FLOAT_EQ(outputSamples[4], 0.5f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, ReconstructionCanApplyGainRamp) {
+    std::int32_t inputSamples[5] = { 2147483392, 2147483392, 2147483392, 0, -2147483392 };
+    float outputSamples[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    // Ramp from 1.0 down to 0.0, every sample lowers the gain by 0.2
+    SampleConverter::Reconstruct(inputSamples, 24, outputSamples, 5, 1.0f, 0.0f);
+
+    EXPECT_FLOAT_EQ(outputSamples[0], 1.0f);
+    EXPECT_FLOAT_EQ(outputSamples[1], 0.8f);
+    EXPECT_FLOAT_EQ(outputSamples[2], 0.6f);
+    EXPECT_FLOAT_EQ(outputSamples[3], 0.0f);
+    EXPECT_FLOAT_EQ(outputSamples[4], -0.2f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CompileTimeIntegerConversionsMatchRuntimeOnes) {
+    std::int16_t shortSamples[5] = { -32768, -32752, -16400, 0, 32752 };
+    std::int32_t longSamples[5] = { -2147483648, -2147483392, -1073742080, 0, 2147483392 };
+
+    std::int32_t expected[5], actual[5];
+    SampleConverter::Convert(shortSamples, 12, expected, 32, 5);
+    SampleConverter::Convert<12, 32>(shortSamples, actual, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actual[index], expected[index]);
+    }
+
+    SampleConverter::Convert(shortSamples, 8, expected, 24, 5);
+    SampleConverter::Convert<8, 24>(shortSamples, actual, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actual[index], expected[index]);
+    }
+
+    SampleConverter::Convert(longSamples, 24, expected, 32, 5);
+    SampleConverter::Convert<24, 32>(longSamples, actual, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actual[index], expected[index]);
+    }
+
+    std::int16_t expectedShort[5], actualShort[5];
+    SampleConverter::Convert(longSamples, 24, expectedShort, 12, 5);
+    SampleConverter::Convert<24, 12>(longSamples, actualShort, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actualShort[index], expectedShort[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CompileTimeQuantizationMatchesRuntimeOne) {
+    float inputSamples[7] = { -1.0f, -0.75f, -0.1f, 0.0f, 0.3f, 0.9f, 1.0f };
+
+    std::int16_t expectedShort[7], actualShort[7];
+    SampleConverter::Convert(inputSamples, 32, expectedShort, 16, 7);
+    SampleConverter::Convert<32, 16>(inputSamples, actualShort, 7);
+    for(std::size_t index = 0; index < 7; ++index) {
+      EXPECT_EQ(actualShort[index], expectedShort[index]);
+    }
+
+    std::int32_t expected[7], actual[7];
+    SampleConverter::Convert(inputSamples, 32, expected, 24, 7);
+    SampleConverter::Convert<32, 24>(inputSamples, actual, 7);
+    for(std::size_t index = 0; index < 7; ++index) {
+      EXPECT_EQ(actual[index], expected[index]);
+    }
+
+    std::uint8_t expectedByte[7], actualByte[7];
+    SampleConverter::Convert(inputSamples, 32, expectedByte, 8, 7);
+    SampleConverter::Convert<32, 8>(inputSamples, actualByte, 7);
+    for(std::size_t index = 0; index < 7; ++index) {
+      EXPECT_EQ(actualByte[index], expectedByte[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CompileTimeReconstructionMatchesRuntimeOne) {
+    std::int16_t shortSamples[5] = { -32767, -16384, 0, 16384, 32767 };
+    std::int32_t longSamples[5] = { -2147483392, -1073742080, 0, 1073742080, 2147483392 };
+
+    float expected[5], actual[5];
+    SampleConverter::Convert(shortSamples, 16, expected, 32, 5);
+    SampleConverter::Convert<16, 32>(shortSamples, actual, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actual[index], expected[index]);
+    }
+
+    double expectedDouble[5], actualDouble[5];
+    SampleConverter::Convert(longSamples, 24, expectedDouble, 64, 5);
+    SampleConverter::Convert<24, 64>(longSamples, actualDouble, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(actualDouble[index], expectedDouble[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CanReconstructInPlace) {
+    std::vector<std::int32_t> samples(37);
+    for(std::size_t index = 0; index < 37; ++index) {
+      samples[index] = static_cast<std::int32_t>(index * 116000000) - 2147483392;
+    }
+
+    std::vector<float> expected(37);
+    SampleConverter::Convert(samples.data(), 24, expected.data(), 32, 37);
+
+    float *converted = SampleConverter::ConvertInPlace<float>(samples.data(), 24, 32, 37);
+    ASSERT_EQ(static_cast<void *>(converted), static_cast<void *>(samples.data()));
+    for(std::size_t index = 0; index < 37; ++index) {
+      EXPECT_EQ(converted[index], expected[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CanQuantizeInPlace) {
+    std::vector<float> samples(37);
+    for(std::size_t index = 0; index < 37; ++index) {
+      samples[index] = static_cast<float>(index) / 18.0f - 1.0f;
+    }
+
+    std::vector<std::int32_t> expected(37);
+    SampleConverter::Convert(samples.data(), 32, expected.data(), 24, 37);
+
+    std::int32_t *converted = SampleConverter::ConvertInPlace<std::int32_t>(
+      samples.data(), 32, 24, 37
+    );
+    for(std::size_t index = 0; index < 37; ++index) {
+      EXPECT_EQ(converted[index], expected[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleConverterTest, CanNarrowInPlace) {
+    const std::size_t sampleCount = 1000; // spans several chunks
+    std::vector<double> samples(sampleCount);
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      samples[index] = static_cast<double>(index) / 500.0 - 1.0;
+    }
+
+    std::vector<std::int16_t> expected(sampleCount);
+    SampleConverter::Convert(samples.data(), 64, expected.data(), 16, sampleCount);
+
+    std::int16_t *converted = SampleConverter::ConvertInPlace<std::int16_t>(
+      samples.data(), 64, 16, sampleCount
+    );
+    for(std::size_t index = 0; index < sampleCount; ++index) {
+      EXPECT_EQ(converted[index], expected[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Processing
 
 #if defined(_MSC_VER)
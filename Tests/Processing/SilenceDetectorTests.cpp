@@ -0,0 +1,185 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/SilenceDetector.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer to a buffer in little endian format</summary>
+  /// <param name="buffer">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  /// <param name="byteCount">Number of bytes the integer occupies</param>
+  void appendLittleEndian(std::vector<std::byte> &buffer, std::uint32_t value, int byteCount) {
+    for(int index = 0; index < byteCount; ++index) {
+      buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an in-memory 16-bit Waveform file holding the specified samples</summary>
+  /// <param name="samples">Interleaved samples the file will contain</param>
+  /// <param name="channelCount">Number of interleaved channels</param>
+  /// <returns>A virtual file serving the Waveform file</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> makeWaveformFile(
+    const std::vector<std::int16_t> &samples, std::uint32_t channelCount
+  ) {
+    std::uint32_t dataSize = static_cast<std::uint32_t>(samples.size() * 2);
+
+    std::vector<std::byte> contents;
+    for(char character : { 'R', 'I', 'F', 'F' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, 36 + dataSize, 4);
+    for(char character : { 'W', 'A', 'V', 'E' }) { contents.push_back(std::byte(character)); }
+    for(char character : { 'f', 'm', 't', ' ' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, 16, 4);
+    appendLittleEndian(contents, 1, 2); // WAVE_FORMAT_PCM
+    appendLittleEndian(contents, channelCount, 2);
+    appendLittleEndian(contents, 48000, 4);
+    appendLittleEndian(contents, 48000 * channelCount * 2, 4);
+    appendLittleEndian(contents, channelCount * 2, 2);
+    appendLittleEndian(contents, 16, 2);
+    for(char character : { 'd', 'a', 't', 'a' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, dataSize, 4);
+    for(std::int16_t sample : samples) {
+      appendLittleEndian(contents, static_cast<std::uint16_t>(sample), 2);
+    }
+
+    std::shared_ptr<std::byte[]> memory(new std::byte[contents.size()]);
+    std::memcpy(memory.get(), contents.data(), contents.size());
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, contents.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, RejectsInvalidArguments) {
+    EXPECT_THROW(SilenceDetector(0), std::invalid_argument);
+    EXPECT_THROW(SilenceDetector(1, -60.0f, -1.0f), std::invalid_argument);
+    EXPECT_THROW(SilenceDetector(1, -60.0f, 6.0f, 4800, 0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, FindsLongSilencesOnly) {
+    std::vector<float> samples(10000, 0.5f);
+    std::fill(samples.begin() + 1000, samples.begin() + 4000, 0.0f); // long pause
+    std::fill(samples.begin() + 6000, samples.begin() + 6400, 0.0f); // short pause
+
+    SilenceDetector detector(1, -60.0f, 6.0f, 1000, 100);
+    for(std::size_t start = 0; start < samples.size(); start += 777) {
+      std::size_t count = std::min<std::size_t>(777, samples.size() - start);
+      detector.ProcessInterleaved(samples.data() + start, count);
+    }
+    detector.Finish();
+
+    const std::vector<SilentInterval> &intervals = detector.GetSilentIntervals();
+    ASSERT_EQ(intervals.size(), 1U);
+    EXPECT_EQ(intervals[0].StartFrame, 1000U);
+    EXPECT_EQ(intervals[0].FrameCount, 3000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, HysteresisKeepsNoisySilenceTogether) {
+    std::vector<float> samples(8000, 0.5f);
+
+    // Silence whose noise floor rises slightly above the threshold halfway through
+    std::fill(samples.begin() + 1000, samples.begin() + 7000, 0.0005f);
+    std::fill(samples.begin() + 3000, samples.begin() + 3500, 0.0015f);
+
+    SilenceDetector tolerant(1, -60.0f, 6.0f, 1000, 100);
+    tolerant.ProcessInterleaved(samples.data(), samples.size());
+    tolerant.Finish();
+    ASSERT_EQ(tolerant.GetSilentIntervals().size(), 1U);
+    EXPECT_EQ(tolerant.GetSilentIntervals()[0].FrameCount, 6000U);
+
+    SilenceDetector strict(1, -60.0f, 0.0f, 1000, 100);
+    strict.ProcessInterleaved(samples.data(), samples.size());
+    strict.Finish();
+    EXPECT_EQ(strict.GetSilentIntervals().size(), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, SilenceCanReachEndOfTrack) {
+    std::vector<float> samples(4000, 0.0f);
+    samples[10] = 1.0f;
+
+    SilenceDetector detector(2, -60.0f, 6.0f, 100, 50);
+    detector.ProcessInterleaved(samples.data(), 2000);
+    detector.Finish();
+
+    ASSERT_EQ(detector.GetSilentIntervals().size(), 1U);
+    EXPECT_EQ(detector.GetSilentIntervals()[0].StartFrame, 50U);
+    EXPECT_EQ(detector.GetSilentIntervals()[0].FrameCount, 1950U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, FindsAudibleRangeOfTrack) {
+    std::vector<std::int16_t> samples(2 * 48000, 0);
+    samples[2 * 1234 + 1] = 1000; // right channel, frame 1234
+    samples[2 * 30000] = -20000; // left channel, frame 30000
+    samples[2 * 40000 + 1] = 5; // below -60 dB, doesn't count
+    Storage::Waveform::WaveformTrackDecoder decoder(makeWaveformFile(samples, 2));
+
+    AudibleRange range = SilenceDetector::FindAudibleRange(decoder);
+    EXPECT_EQ(range.StartFrame, 1234U);
+    EXPECT_EQ(range.EndFrame, 30001U);
+
+    // The silence before frame 1234 is too short to count, the one after it begins
+    // with the next 256 frame window
+    std::vector<SilentInterval> intervals = SilenceDetector::FindSilentIntervals(decoder);
+    ASSERT_EQ(intervals.size(), 2U);
+    EXPECT_EQ(intervals[0].StartFrame, 1280U);
+    EXPECT_EQ(intervals[1].StartFrame + intervals[1].FrameCount, 48000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SilenceDetectorTests, SilentTrackHasEmptyAudibleRange) {
+    std::vector<std::int16_t> samples(10000, 3);
+    Storage::Waveform::WaveformTrackDecoder decoder(makeWaveformFile(samples, 1));
+
+    AudibleRange range = SilenceDetector::FindAudibleRange(decoder);
+    EXPECT_EQ(range.StartFrame, 10000U);
+    EXPECT_EQ(range.EndFrame, 10000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
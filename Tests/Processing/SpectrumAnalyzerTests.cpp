@@ -0,0 +1,229 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/SpectrumAnalyzer.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::max_element()
+#include <cmath> // for std::sin()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>The number pi with enough digits for double precision</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records all spectra a spectrum analyzer produces</summary>
+  class RecordingSpectrumSink : public Nuclex::Audio::Processing::SpectrumSink {
+
+    /// <summary>Stores the spectrum of one analysis window</summary>
+    /// <param name="startFrame">Index of the first frame in the analysis window</param>
+    /// <param name="powers">Power of each frequency bin</param>
+    /// <param name="binCount">Number of frequency bins</param>
+    public: void ProcessSpectrum(
+      std::uint64_t startFrame, const float *powers, std::size_t binCount
+    ) override {
+      this->StartFrames.push_back(startFrame);
+      this->Spectra.emplace_back(powers, powers + binCount);
+    }
+
+    /// <summary>Index of the first frame of each recorded spectrum</summary>
+    public: std::vector<std::uint64_t> StartFrames;
+    /// <summary>Powers of each recorded spectrum</summary>
+    public: std::vector<std::vector<float>> Spectra;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer to a buffer in little endian format</summary>
+  /// <param name="buffer">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  /// <param name="byteCount">Number of bytes the integer occupies</param>
+  void appendLittleEndian(std::vector<std::byte> &buffer, std::uint32_t value, int byteCount) {
+    for(int index = 0; index < byteCount; ++index) {
+      buffer.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an in-memory 16-bit Waveform file holding the specified samples</summary>
+  /// <param name="samples">Interleaved samples the file will contain</param>
+  /// <param name="channelCount">Number of interleaved channels</param>
+  /// <returns>A virtual file serving the Waveform file</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> makeWaveformFile(
+    const std::vector<std::int16_t> &samples, std::uint32_t channelCount
+  ) {
+    std::uint32_t dataSize = static_cast<std::uint32_t>(samples.size() * 2);
+
+    std::vector<std::byte> contents;
+    for(char character : { 'R', 'I', 'F', 'F' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, 36 + dataSize, 4);
+    for(char character : { 'W', 'A', 'V', 'E' }) { contents.push_back(std::byte(character)); }
+    for(char character : { 'f', 'm', 't', ' ' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, 16, 4);
+    appendLittleEndian(contents, 1, 2); // WAVE_FORMAT_PCM
+    appendLittleEndian(contents, channelCount, 2);
+    appendLittleEndian(contents, 48000, 4);
+    appendLittleEndian(contents, 48000 * channelCount * 2, 4);
+    appendLittleEndian(contents, channelCount * 2, 2);
+    appendLittleEndian(contents, 16, 2);
+    for(char character : { 'd', 'a', 't', 'a' }) { contents.push_back(std::byte(character)); }
+    appendLittleEndian(contents, dataSize, 4);
+    for(std::int16_t sample : samples) {
+      appendLittleEndian(contents, static_cast<std::uint16_t>(sample), 2);
+    }
+
+    std::shared_ptr<std::byte[]> memory(new std::byte[contents.size()]);
+    std::memcpy(memory.get(), contents.data(), contents.size());
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, contents.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a stereo sine wave with the same signal in both channels</summary>
+  /// <param name="frameCount">Number of frames that will be generated</param>
+  /// <param name="cyclesPerFrame">Frequency of the sine wave relative to the sample rate</param>
+  /// <returns>The interleaved 16-bit samples of the sine wave</returns>
+  std::vector<std::int16_t> makeStereoSine(std::size_t frameCount, double cyclesPerFrame) {
+    std::vector<std::int16_t> samples(frameCount * 2);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      double value = std::sin(2.0 * Pi * cyclesPerFrame * static_cast<double>(index));
+      samples[index * 2] = static_cast<std::int16_t>(value * 16384.0);
+      samples[index * 2 + 1] = samples[index * 2];
+    }
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SpectrumAnalyzerTests, RejectsInvalidArguments) {
+    RecordingSpectrumSink sink;
+    EXPECT_THROW(SpectrumAnalyzer(sink, 0), std::invalid_argument);
+    EXPECT_THROW(SpectrumAnalyzer(sink, 1, 1000), std::invalid_argument);
+    EXPECT_THROW(SpectrumAnalyzer(sink, 1, 256, 0), std::invalid_argument);
+    EXPECT_THROW(SpectrumAnalyzer(sink, 1, 256, 512), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SpectrumAnalyzerTests, EmitsOverlappingWindows) {
+    RecordingSpectrumSink sink;
+    SpectrumAnalyzer analyzer(sink, 2, 256, 64);
+
+    // Feed the frames in odd pieces so windows complete in the middle of calls
+    std::vector<float> samples(1000 * 2, 0.25f);
+    for(std::size_t start = 0; start < 1000; start += 333) {
+      std::size_t count = std::min<std::size_t>(333, 1000 - start);
+      analyzer.ProcessInterleaved(samples.data() + start * 2, count);
+    }
+
+    // (1000 - 256) / 64 + 1 complete windows fit into 1000 frames
+    ASSERT_EQ(sink.StartFrames.size(), 12U);
+    for(std::size_t index = 0; index < sink.StartFrames.size(); ++index) {
+      EXPECT_EQ(sink.StartFrames[index], index * 64);
+      EXPECT_EQ(sink.Spectra[index].size(), 129U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SpectrumAnalyzerTests, FindsSineInCorrectBin) {
+    for(WindowFunction window : {
+      WindowFunction::Rectangular, WindowFunction::Hann,
+      WindowFunction::Hamming, WindowFunction::BlackmanHarris
+    }) {
+      RecordingSpectrumSink sink;
+      SpectrumAnalyzer analyzer(sink, 1, 1024, 1024, window);
+
+      // Bin 100 of a 1024 point FFT, at half amplitude
+      std::vector<float> samples(1024);
+      for(std::size_t index = 0; index < 1024; ++index) {
+        samples[index] = 0.5f * static_cast<float>(std::sin(2.0 * Pi * 100.0 * index / 1024.0));
+      }
+      analyzer.ProcessInterleaved(samples.data(), samples.size());
+
+      ASSERT_EQ(sink.Spectra.size(), 1U);
+      const std::vector<float> &powers = sink.Spectra[0];
+      std::size_t peakBin = static_cast<std::size_t>(
+        std::max_element(powers.begin(), powers.end()) - powers.begin()
+      );
+      EXPECT_EQ(peakBin, 100U);
+      EXPECT_NEAR(powers[100], 0.25f, 0.01f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SpectrumAnalyzerTests, AnalyzesDecoderBlocksDirectly) {
+    std::vector<std::int16_t> samples = makeStereoSine(10000, 0.05);
+    Storage::Waveform::WaveformTrackDecoder decoder(makeWaveformFile(samples, 2));
+
+    RecordingSpectrumSink decodedSink;
+    SpectrumAnalyzer::Analyze(decoder, decodedSink, 512, 256);
+
+    // The same samples as floats must give the same spectra
+    std::vector<float> floats(samples.size());
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      floats[index] = static_cast<float>(samples[index]) / 32768.0f;
+    }
+    RecordingSpectrumSink floatSink;
+    SpectrumAnalyzer analyzer(floatSink, 2, 512, 256);
+    analyzer.ProcessInterleaved(floats.data(), 10000);
+
+    ASSERT_EQ(decodedSink.StartFrames, floatSink.StartFrames);
+    ASSERT_EQ(decodedSink.StartFrames.size(), (10000U - 512U) / 256U + 1U);
+    for(std::size_t index = 0; index < decodedSink.Spectra.size(); ++index) {
+      for(std::size_t bin = 0; bin < 257; ++bin) {
+        EXPECT_NEAR(decodedSink.Spectra[index][bin], floatSink.Spectra[index][bin], 1e-6f);
+      }
+    }
+
+    // 0.05 cycles per frame is bin 25.6 of a 512 point FFT, at 48 kHz that's 2400 Hz
+    const double bandEdges[] = { 0.0, 2000.0, 3000.0, 24000.0 };
+    float energies[3];
+    SpectrumAnalyzer::SumBands(
+      decodedSink.Spectra[5].data(), 257, 48000.0, bandEdges, 3, energies
+    );
+    EXPECT_GT(energies[1], energies[0] * 100.0f);
+    EXPECT_GT(energies[1], energies[2] * 100.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
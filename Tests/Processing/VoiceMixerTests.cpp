@@ -0,0 +1,149 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/VoiceMixer.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+
+#include "../Storage/ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VoiceMixerTest, RejectsVoicesWithMoreThanTwoChannels) {
+    std::vector<float> samples(6 * 16);
+    VoiceMixer mixer(48000);
+    EXPECT_THROW(mixer.AddVoice(samples.data(), 16, 6, 48000), std::invalid_argument);
+    EXPECT_EQ(mixer.CountVoices(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VoiceMixerTest, StereoVoicesAreMixedWithGainAndBalance) {
+    std::vector<float> samples(2 * 100);
+    for(std::size_t index = 0; index < 100; ++index) {
+      samples[index * 2] = 0.5f;
+      samples[index * 2 + 1] = -0.25f;
+    }
+
+    VoiceMixer mixer(48000, 32);
+    std::size_t voiceId = mixer.AddVoice(samples.data(), 100, 2, 48000);
+    mixer.SetGain(voiceId, 0.5f);
+    mixer.SetPan(voiceId, 0.5f);
+
+    std::vector<float> output(2 * 150, 1.0f);
+    mixer.Mix(output.data(), 150);
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      EXPECT_FLOAT_EQ(output[index * 2], 0.125f);
+      EXPECT_FLOAT_EQ(output[index * 2 + 1], -0.125f);
+    }
+    for(std::size_t index = 100; index < 150; ++index) {
+      EXPECT_EQ(output[index * 2], 0.0f);
+      EXPECT_EQ(output[index * 2 + 1], 0.0f);
+    }
+    EXPECT_TRUE(mixer.IsVoiceFinished(voiceId));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VoiceMixerTest, MonoVoicesArePannedWithConstantPower) {
+    std::vector<float> samples(37, 1.0f);
+
+    VoiceMixer mixer(44100);
+    std::size_t centerId = mixer.AddVoice(samples.data(), 37, 1, 44100);
+    std::size_t leftId = mixer.AddVoice(samples.data(), 37, 1, 44100);
+    mixer.SetPan(leftId, -1.0f);
+
+    std::vector<float> output(2 * 37);
+    mixer.Mix(output.data(), 37);
+
+    for(std::size_t index = 0; index < 37; ++index) {
+      EXPECT_NEAR(output[index * 2], 1.7071068f, 0.0001f);
+      EXPECT_NEAR(output[index * 2 + 1], 0.7071068f, 0.0001f);
+    }
+
+    EXPECT_TRUE(mixer.RemoveVoice(centerId));
+    EXPECT_FALSE(mixer.RemoveVoice(centerId));
+    EXPECT_EQ(mixer.CountVoices(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VoiceMixerTest, VoicesAreResampledToTheOutputRate) {
+    const std::size_t inputFrameCount = 4410;
+    std::vector<float> samples(inputFrameCount * 2, 0.5f);
+
+    VoiceMixer mixer(48000, 256);
+    std::size_t voiceId = mixer.AddVoice(samples.data(), inputFrameCount, 2, 44100);
+
+    std::vector<float> output(2 * 6000);
+    mixer.Mix(output.data(), 6000);
+    EXPECT_TRUE(mixer.IsVoiceFinished(voiceId));
+
+    // The resampler's filter rings a little at both ends, but in between
+    // the signal has to come through unchanged
+    for(std::size_t index = 100; index < 4700; ++index) {
+      EXPECT_NEAR(output[index * 2], 0.5f, 0.01f);
+      EXPECT_NEAR(output[index * 2 + 1], 0.5f, 0.01f);
+    }
+    for(std::size_t index = 4900; index < 6000; ++index) {
+      EXPECT_EQ(output[index * 2], 0.0f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VoiceMixerTest, DecodersCanFeedVoices) {
+    Storage::AudioLoader loader;
+    std::shared_ptr<Storage::AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+
+    std::vector<float> expected(frameCount * 2);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    VoiceMixer mixer(48000, 64);
+    std::size_t voiceId = mixer.AddVoice(
+      std::shared_ptr<const Storage::AudioTrackDecoder>(decoder), 48000
+    );
+
+    std::vector<float> output(frameCount * 2);
+    mixer.Mix(output.data(), frameCount);
+
+    // Stereo voices at center pan with unit gain pass through bit-exact
+    EXPECT_EQ(output, expected);
+
+    EXPECT_TRUE(mixer.RemoveVoice(voiceId));
+    EXPECT_EQ(mixer.CountVoices(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
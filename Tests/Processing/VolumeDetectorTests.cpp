@@ -0,0 +1,214 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Processing/VolumeDetector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min(), std::max()
+#include <cmath> // for std::sin(), std::sqrt(), std::round()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of frames in the generated test signals</summary>
+  /// <remarks>
+  ///   Not a multiple of 4 or of the block size so that all the tails are exercised
+  /// </remarks>
+  const std::size_t TestFrameCount = 5003;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the value of the test signal in a specific channel</summary>
+  /// <param name="channelIndex">Channel for which the value will be calculated</param>
+  /// <param name="frameIndex">Frame for which the value will be calculated</param>
+  /// <returns>The value of the test signal, within -1.0 and +1.0</returns>
+  float getTestSignal(std::size_t channelIndex, std::size_t frameIndex) {
+    float amplitude = 0.9f / static_cast<float>(channelIndex + 1);
+    float offset = 0.01f * static_cast<float>(channelIndex);
+    return amplitude * std::sin(static_cast<float>(frameIndex) * 0.01f) + offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the expected statistics of a channel of the test signal</summary>
+  /// <param name="channelIndex">Channel whose statistics will be calculated</param>
+  /// <returns>The peak, RMS level and DC offset of the channel</returns>
+  Nuclex::Audio::Processing::ChannelVolume getExpectedVolume(std::size_t channelIndex) {
+    double peak = 0.0, sum = 0.0, squareSum = 0.0;
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      double value = getTestSignal(channelIndex, frameIndex);
+      peak = std::max(peak, std::abs(value));
+      sum += value;
+      squareSum += value * value;
+    }
+
+    Nuclex::Audio::Processing::ChannelVolume volume;
+    volume.Peak = static_cast<float>(peak);
+    volume.Rms = static_cast<float>(std::sqrt(squareSum / TestFrameCount));
+    volume.DcOffset = static_cast<float>(sum / TestFrameCount);
+    return volume;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks the results of a volume detector against the expected values</summary>
+  /// <param name="detector">Detector that has processed the test signal</param>
+  /// <param name="tolerance">Largest difference allowed from the expected values</param>
+  void checkVolumes(
+    const Nuclex::Audio::Processing::VolumeDetector &detector, float tolerance
+  ) {
+    std::vector<Nuclex::Audio::Processing::ChannelVolume> volumes = (
+      detector.GetChannelVolumes()
+    );
+    ASSERT_EQ(volumes.size(), detector.CountChannels());
+    for(std::size_t index = 0; index < volumes.size(); ++index) {
+      Nuclex::Audio::Processing::ChannelVolume expected = getExpectedVolume(index);
+      EXPECT_NEAR(volumes[index].Peak, expected.Peak, tolerance);
+      EXPECT_NEAR(volumes[index].Rms, expected.Rms, tolerance);
+      EXPECT_NEAR(volumes[index].DcOffset, expected.DcOffset, tolerance);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Processing {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, RequiresAtLeastOneChannel) {
+    EXPECT_THROW(VolumeDetector detector(0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, ReportsSilenceBeforeProcessing) {
+    VolumeDetector detector(2);
+    EXPECT_EQ(detector.CountProcessedFrames(), 0U);
+
+    ChannelVolume volume = detector.GetChannelVolume(1);
+    EXPECT_EQ(volume.Peak, 0.0f);
+    EXPECT_EQ(volume.Rms, 0.0f);
+    EXPECT_EQ(volume.DcOffset, 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, AnalyzesInterleavedFloatsPerChannel) {
+
+    // Every channel count up to past the vectorized ones, including the awkward ones
+    for(std::size_t channelCount = 1; channelCount <= 10; ++channelCount) {
+      std::vector<float> samples(TestFrameCount * channelCount);
+      for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+          samples[frameIndex * channelCount + channelIndex] = (
+            getTestSignal(channelIndex, frameIndex)
+          );
+        }
+      }
+
+      VolumeDetector detector(channelCount);
+      detector.ProcessInterleaved(samples.data(), TestFrameCount);
+      EXPECT_EQ(detector.CountProcessedFrames(), TestFrameCount);
+      checkVolumes(detector, 0.0001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, ResultsDoNotDependOnBlockSizes) {
+    std::vector<double> samples(TestFrameCount * 3);
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < 3; ++channelIndex) {
+        samples[frameIndex * 3 + channelIndex] = getTestSignal(channelIndex, frameIndex);
+      }
+    }
+
+    VolumeDetector detector(3);
+    std::size_t frameIndex = 0;
+    for(std::size_t blockFrameCount = 1; frameIndex < TestFrameCount; blockFrameCount += 7) {
+      std::size_t frameCount = std::min(blockFrameCount, TestFrameCount - frameIndex);
+      detector.ProcessInterleaved(samples.data() + frameIndex * 3, frameCount);
+      frameIndex += frameCount;
+    }
+
+    checkVolumes(detector, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, AnalyzesIntegersWithoutReconstruction) {
+    std::vector<std::int16_t> shorts(TestFrameCount * 2);
+    std::vector<std::int32_t> ints(TestFrameCount * 2);
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < 2; ++channelIndex) {
+        double value = getTestSignal(channelIndex, frameIndex);
+        shorts[frameIndex * 2 + channelIndex] = static_cast<std::int16_t>(
+          std::round(value * 32767.0)
+        );
+        ints[frameIndex * 2 + channelIndex] = static_cast<std::int32_t>(
+          std::round(value * 2147483647.0)
+        );
+      }
+    }
+
+    VolumeDetector shortDetector(2);
+    shortDetector.ProcessInterleaved(shorts.data(), TestFrameCount);
+    checkVolumes(shortDetector, 0.0001f);
+
+    VolumeDetector intDetector(2);
+    intDetector.ProcessInterleaved(ints.data(), TestFrameCount);
+    checkVolumes(intDetector, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VolumeDetectorTests, AnalyzesSeparatedChannels) {
+    std::vector<std::vector<float>> channels(4, std::vector<float>(TestFrameCount));
+    for(std::size_t channelIndex = 0; channelIndex < 4; ++channelIndex) {
+      for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+        channels[channelIndex][frameIndex] = getTestSignal(channelIndex, frameIndex);
+      }
+    }
+    const float *buffers[] = {
+      channels[0].data(), channels[1].data(), channels[2].data(), channels[3].data()
+    };
+
+    VolumeDetector detector(4);
+    detector.ProcessSeparated(buffers, TestFrameCount);
+    checkVolumes(detector, 0.0001f);
+
+    // After a reset, the detector should start over as if it was new
+    detector.Reset();
+    EXPECT_EQ(detector.CountProcessedFrames(), 0U);
+    detector.ProcessSeparated(buffers, TestFrameCount);
+    checkVolumes(detector, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Processing
@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/SampleAllocator.h"
+#include "Nuclex/Audio/Processing/SpectrumAnalyzer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sample allocator that counts the allocations going through it</summary>
+  class CountingSampleAllocator : public Nuclex::Audio::SampleAllocator {
+
+    /// <summary>Allocates a block of memory aligned to 64 bytes</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The address of the allocated memory</returns>
+    public: void *Allocate(std::size_t byteCount) override {
+      ++this->AllocationCount;
+      this->OutstandingByteCount += byteCount;
+      return ::operator new(byteCount, std::align_val_t(Alignment));
+    }
+
+    /// <summary>Frees a block of memory that was obtained through Allocate()</summary>
+    /// <param name="memory">Address of the memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: void Free(void *memory, std::size_t byteCount) noexcept override {
+      this->OutstandingByteCount -= byteCount;
+      ::operator delete(memory, std::align_val_t(Alignment));
+    }
+
+    /// <summary>Number of allocations that have been made</summary>
+    public: std::size_t AllocationCount = 0;
+    /// <summary>Number of bytes that have been allocated but not freed yet</summary>
+    public: std::size_t OutstandingByteCount = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Spectrum sink that ignores all spectra</summary>
+  class NullSpectrumSink : public Nuclex::Audio::Processing::SpectrumSink {
+
+    /// <summary>Does nothing with the spectrum of one analysis window</summary>
+    public: void ProcessSpectrum(std::uint64_t, const float *, std::size_t) override {}
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleAllocatorTest, DefaultAllocatorAlignsMemory) {
+    for(std::size_t count : { 1, 3, 17, 1000 }) {
+      SampleVector<float> samples(count);
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(samples.data());
+      EXPECT_EQ(address % SampleAllocator::Alignment, 0U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SampleAllocatorTest, InternalBuffersUseGlobalAllocator) {
+    CountingSampleAllocator allocator;
+    NullSpectrumSink sink;
+
+    SampleAllocator::SetGlobal(&allocator);
+    {
+      Processing::SpectrumAnalyzer analyzer(sink, 2, 1024, 256);
+
+      // Buffers created afterwards go back to the default allocator
+      SampleAllocator::SetGlobal(nullptr);
+      EXPECT_NE(&SampleAllocator::GetGlobal(), &allocator);
+
+      EXPECT_GT(allocator.AllocationCount, 0U);
+      EXPECT_GT(allocator.OutstandingByteCount, 0U);
+    }
+
+    // The analyzer must have returned its memory to the allocator it came from
+    EXPECT_EQ(allocator.OutstandingByteCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
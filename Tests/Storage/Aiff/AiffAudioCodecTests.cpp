@@ -0,0 +1,268 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Aiff/AiffAudioCodec.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "../ByteArrayAsFile.h"
+#include "../ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uint8_t
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a big endian integer of the specified size to a byte buffer</summary>
+  /// <param name="bytes">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  /// <param name="byteCount">Number of bytes the integer will be stored in</param>
+  void appendBigEndian(std::vector<std::byte> &bytes, std::uint64_t value, std::size_t byteCount) {
+    for(std::size_t index = byteCount; index > 0; --index) {
+      bytes.push_back(static_cast<std::byte>((value >> ((index - 1) * 8)) & 0xFF));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a FourCC to a byte buffer</summary>
+  /// <param name="bytes">Buffer the FourCC will be appended to</param>
+  /// <param name="fourCC">Four characters that will be appended</param>
+  void appendFourCC(std::vector<std::byte> &bytes, const char *fourCC) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      bytes.push_back(static_cast<std::byte>(fourCC[index]));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an AIFF or AIFF-C file holding the specified sample bytes</summary>
+  /// <param name="compressionType">AIFF-C compression type or NULL for plain AIFF</param>
+  /// <param name="channelCount">Number of channels stated in the 'COMM' chunk</param>
+  /// <param name="bitsPerSample">Sample size stated in the 'COMM' chunk</param>
+  /// <param name="frameCount">Number of frames stated in the 'COMM' chunk</param>
+  /// <param name="samples">Bytes that will be stored in the 'SSND' chunk</param>
+  /// <returns>The contents of the AIFF file</returns>
+  std::vector<std::byte> makeAiff(
+    const char *compressionType,
+    std::uint16_t channelCount, std::uint16_t bitsPerSample, std::uint32_t frameCount,
+    const std::vector<std::uint8_t> &samples
+  ) {
+    std::uint32_t commonLength = (compressionType == nullptr) ? 18 : 24;
+    std::uint32_t soundDataLength = static_cast<std::uint32_t>(8 + samples.size());
+
+    std::vector<std::byte> bytes;
+    appendFourCC(bytes, u8"FORM");
+    std::uint32_t paddingLength = static_cast<std::uint32_t>(samples.size() & 1);
+    appendBigEndian(bytes, 4 + (8 + commonLength) + (8 + soundDataLength + paddingLength), 4);
+    appendFourCC(bytes, (compressionType == nullptr) ? u8"AIFF" : u8"AIFC");
+
+    appendFourCC(bytes, u8"COMM");
+    appendBigEndian(bytes, commonLength, 4);
+    appendBigEndian(bytes, channelCount, 2);
+    appendBigEndian(bytes, frameCount, 4);
+    appendBigEndian(bytes, bitsPerSample, 2);
+    appendBigEndian(bytes, 0x400E, 2); // 44100 as 80-bit extended float: exponent
+    appendBigEndian(bytes, 0xAC44000000000000ULL, 8); // and mantissa
+    if(compressionType != nullptr) {
+      appendFourCC(bytes, compressionType);
+      appendBigEndian(bytes, 0, 2); // empty compression name plus padding
+    }
+
+    appendFourCC(bytes, u8"SSND");
+    appendBigEndian(bytes, soundDataLength, 4);
+    appendBigEndian(bytes, 0, 4); // offset
+    appendBigEndian(bytes, 0, 4); // block size
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      bytes.push_back(static_cast<std::byte>(samples[index]));
+    }
+    if((samples.size() & 1) != 0) {
+      bytes.push_back(std::byte(0));
+    }
+
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Aiff {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, DetectsAiffSignature) {
+    std::vector<std::byte> aiff = makeAiff(nullptr, 1, 16, 2, { 0, 1, 0, 2 });
+    std::vector<std::byte> aifc = makeAiff(u8"sowt", 1, 16, 2, { 1, 0, 2, 0 });
+
+    AiffAudioCodec codec;
+    EXPECT_TRUE(codec.IsSignaturePresent(aiff.data(), aiff.size()));
+    EXPECT_TRUE(codec.IsSignaturePresent(aifc.data(), aifc.size()));
+
+    aiff[8] = std::byte('W'); // Turn 'AIFF' into 'WIFF'
+    EXPECT_FALSE(codec.IsSignaturePresent(aiff.data(), aiff.size()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, IgnoresWaveformFiles) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    AiffAudioCodec codec;
+    EXPECT_FALSE(codec.TryReadInfo(file).has_value());
+    EXPECT_FALSE(static_cast<bool>(codec.TryOpenDecoder(file)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, CanReadInfoFromStereoFile) {
+    std::vector<std::byte> contents = makeAiff(
+      nullptr, 2, 16, 3, { 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6 }
+    );
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+    ASSERT_EQ(info.value().Tracks.size(), 1U);
+
+    const TrackInfo &track = info.value().Tracks.at(0);
+    EXPECT_EQ(track.ChannelCount, 2U);
+    EXPECT_EQ(track.SampleRate, 44100U);
+    EXPECT_EQ(track.BitsPerSample, 16U);
+    EXPECT_EQ(track.SampleFormat, AudioSampleFormat::SignedInteger_16);
+    EXPECT_EQ(track.FrameCount, 3U);
+    EXPECT_EQ(track.ChannelPlacements, ChannelPlacement::FrontLeft | ChannelPlacement::FrontRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, DecodesBigEndianSamples) {
+    std::vector<std::byte> contents = makeAiff(
+      nullptr, 2, 16, 2, { 0x40, 0x00, 0xC0, 0x00, 0x01, 0x02, 0xFF, 0xFE }
+    );
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    std::shared_ptr<AudioTrackDecoder> decoder = codec.TryOpenDecoder(file);
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->CountFrames(), 2U);
+    EXPECT_EQ(decoder->GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_16);
+
+    std::int16_t samples[4];
+    decoder->DecodeInterleaved(samples, 0, 2);
+    EXPECT_EQ(samples[0], 16384);
+    EXPECT_EQ(samples[1], -16384);
+    EXPECT_EQ(samples[2], 0x0102);
+    EXPECT_EQ(samples[3], -2);
+
+    float floats[4];
+    decoder->DecodeInterleaved(floats, 0, 2);
+    EXPECT_NEAR(floats[0], 0.5f, 0.0001f);
+    EXPECT_NEAR(floats[1], -0.5f, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, DecodesByteSwappedAiffCSamples) {
+    std::vector<std::byte> contents = makeAiff(
+      u8"sowt", 1, 16, 2, { 0x00, 0x40, 0xFE, 0xFF }
+    );
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    std::shared_ptr<AudioTrackDecoder> decoder = codec.TryOpenDecoder(file);
+    ASSERT_TRUE(static_cast<bool>(decoder));
+
+    std::int16_t samples[2];
+    decoder->DecodeInterleaved(samples, 0, 2);
+    EXPECT_EQ(samples[0], 16384);
+    EXPECT_EQ(samples[1], -2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, DecodesSignedEightBitSamples) {
+    std::vector<std::byte> contents = makeAiff(nullptr, 1, 8, 3, { 0x40, 0xC0, 0x00 });
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    std::shared_ptr<AudioTrackDecoder> decoder = codec.TryOpenDecoder(file);
+    ASSERT_TRUE(static_cast<bool>(decoder));
+
+    // Unlike Waveform, AIFF stores 8-bit samples as signed integers
+    float samples[3];
+    decoder->DecodeInterleaved(samples, 0, 3);
+    EXPECT_NEAR(samples[0], 0.5f, 0.01f);
+    EXPECT_NEAR(samples[1], -0.5f, 0.01f);
+    EXPECT_NEAR(samples[2], 0.0f, 0.01f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, DecodesFloatingPointAiffCSamples) {
+    std::vector<std::byte> contents = makeAiff(
+      u8"fl32", 1, 32, 2, { 0x3F, 0x00, 0x00, 0x00, 0xBE, 0x80, 0x00, 0x00 }
+    );
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    std::shared_ptr<AudioTrackDecoder> decoder = codec.TryOpenDecoder(file);
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->GetNativeSampleFormat(), AudioSampleFormat::Float_32);
+
+    float samples[2];
+    decoder->DecodeInterleaved(samples, 0, 2);
+    EXPECT_EQ(samples[0], 0.5f);
+    EXPECT_EQ(samples[1], -0.25f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AiffAudioCodecTest, RejectsCompressedAiffCFiles) {
+    std::vector<std::byte> contents = makeAiff(u8"ima4", 1, 16, 2, { 0, 0, 0, 0 });
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    AiffAudioCodec codec;
+    EXPECT_THROW(codec.TryOpenDecoder(file), Errors::UnsupportedFormatError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Aiff
@@ -0,0 +1,193 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#if defined(NUCLEX_AUDIO_WINDOWS)
+#include "../../Source/Platform/WindowsFileApi.h"
+#else
+#include "../../Source/Platform/PosixFileApi.h"
+#endif
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an asset record with a single track described by its codec name</summary>
+  /// <param name="codecName">Codec name that will be listed for the track</param>
+  /// <returns>The new asset record</returns>
+  Nuclex::Audio::Storage::AssetRecord makeRecord(const std::string &codecName) {
+    Nuclex::Audio::TrackInfo track = Nuclex::Audio::TrackInfo();
+    track.CodecName = codecName;
+    track.ChannelCount = 2;
+    track.SampleRate = 44100;
+
+    Nuclex::Audio::ContainerInfo info;
+    info.DefaultTrackIndex = 0;
+    info.Tracks.push_back(track);
+
+    Nuclex::Audio::Storage::AssetRecord record;
+    record.Size = 1000;
+    record.ModificationTime = 42;
+    record.Info = info;
+    return record;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AssetCatalogTest, RecordsCanBeLookedUpByPath) {
+    AssetCatalogWriter writer;
+    for(std::size_t index = 0; index < 100; ++index) {
+      writer.Add(u8"sounds/" + std::to_string(index) + u8".flac", makeRecord(u8"FLAC"));
+    }
+
+    AssetRecord detailed = makeRecord(u8"Opus");
+    detailed.SeekIndex = { std::byte(1), std::byte(2), std::byte(3) };
+    detailed.PeakPyramid = std::vector<std::byte>(1000, std::byte(9));
+    detailed.IntegratedLoudness = -23.0;
+    detailed.Proxy = ProxyMapping { u8"music/theme.proxy.opus", 24000, 1200, 48000, 2400 };
+    writer.Add(u8"music/theme.opus", detailed);
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    AssetCatalog catalog(file);
+    EXPECT_EQ(catalog.CountRecords(), 101U);
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      std::optional<AssetRecord> record = catalog.TryLookup(
+        u8"sounds/" + std::to_string(index) + u8".flac"
+      );
+      ASSERT_TRUE(record.has_value());
+      EXPECT_EQ(record.value().Info.value().Tracks.at(0).CodecName, u8"FLAC");
+    }
+
+    std::optional<AssetRecord> record = catalog.TryLookup(u8"music/theme.opus");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record.value().SeekIndex, detailed.SeekIndex);
+    EXPECT_EQ(record.value().PeakPyramid, detailed.PeakPyramid);
+    EXPECT_EQ(record.value().IntegratedLoudness, std::optional<double>(-23.0));
+    EXPECT_FALSE(record.value().TruePeak.has_value());
+    ASSERT_TRUE(record.value().Proxy.has_value());
+    EXPECT_EQ(record.value().Proxy.value().ProxyPath, u8"music/theme.proxy.opus");
+    EXPECT_EQ(record.value().Proxy.value().ToMasterFrame(600), 1200U);
+    EXPECT_FALSE(catalog.TryLookup(u8"sounds/0.flac").value().Proxy.has_value());
+
+    EXPECT_FALSE(catalog.TryLookup(u8"music/missing.opus").has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AssetCatalogTest, InfoLookupRequiresMatchingIdentity) {
+    AssetCatalogWriter writer;
+    writer.Add(u8"a.wav", makeRecord(u8"Waveform"));
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+    AssetCatalog catalog(file);
+
+    std::optional<ContainerInfo> info;
+    ASSERT_TRUE(catalog.TryLookupInfo(u8"a.wav", 1000, 42, info));
+    EXPECT_EQ(info.value().Tracks.at(0).SampleRate, 44100U);
+
+    EXPECT_FALSE(catalog.TryLookupInfo(u8"a.wav", 1000, 43, info));
+    EXPECT_FALSE(catalog.TryLookupInfo(u8"a.wav", 999, 42, info));
+    EXPECT_FALSE(catalog.TryLookupInfo(u8"b.wav", 1000, 42, info));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AssetCatalogTest, EmptyCatalogCanBeOpened) {
+    AssetCatalogWriter writer;
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    AssetCatalog catalog(file);
+    EXPECT_EQ(catalog.CountRecords(), 0U);
+    EXPECT_FALSE(catalog.TryLookup(u8"anything").has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AssetCatalogTest, RejectsOtherFiles) {
+    EXPECT_THROW(
+      AssetCatalog catalog(
+        VirtualFile::OpenRealFileForReading(
+          GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+        )
+      ),
+      Errors::CorruptedFileError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AssetCatalogTest, AudioLoaderAnswersFromCatalog) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    AssetRecord record = makeRecord(u8"FromCatalog");
+#if defined(NUCLEX_AUDIO_WINDOWS)
+    ASSERT_TRUE(
+      Platform::WindowsFileApi::TryGetFileAttributes(
+        path, record.Size, record.ModificationTime
+      )
+    );
+#else
+    ASSERT_TRUE(Platform::PosixFileApi::TryStatFile(path, record.Size, record.ModificationTime));
+#endif
+
+    AssetCatalogWriter writer;
+    writer.Add(path, record);
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    AudioLoader loader;
+    loader.SetAssetCatalog(std::make_shared<AssetCatalog>(file));
+
+    std::optional<ContainerInfo> info = loader.TryReadInfo(path);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info.value().Tracks.at(0).CodecName, u8"FromCatalog");
+
+    // Files not in the catalog are probed as usual
+    std::optional<ContainerInfo> probed = loader.TryReadInfo(
+      GetResourcesDirectory() + u8"waveform-mono-uint8-pcmwaveformat.wav"
+    );
+    ASSERT_TRUE(probed.has_value());
+    EXPECT_NE(probed.value().Tracks.at(0).CodecName, u8"FromCatalog");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
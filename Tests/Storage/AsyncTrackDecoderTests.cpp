@@ -0,0 +1,128 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AsyncTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/WorkStealingExecutor.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackDecoderTest, RequiresDecoderAndExecutor) {
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    EXPECT_THROW(
+      AsyncTrackDecoder(std::shared_ptr<AudioTrackDecoder>()), std::invalid_argument
+    );
+    EXPECT_THROW(
+      AsyncTrackDecoder(decoder, std::shared_ptr<Executor>()), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackDecoderTest, QueuedCallsMatchSynchronousDecoding) {
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Queue the whole track in small chunks, they have to run in order and not race
+    // each other on the shared decoder
+    std::vector<float> result(frameCount * channelCount);
+    std::vector<std::future<void>> futures;
+    {
+      AsyncTrackDecoder asyncDecoder(decoder->Clone(), std::make_shared<WorkStealingExecutor>(4));
+      for(std::size_t startFrame = 0; startFrame < frameCount; startFrame += 1000) {
+        std::size_t chunkFrameCount = std::min<std::size_t>(frameCount - startFrame, 1000);
+        futures.push_back(
+          asyncDecoder.DecodeInterleavedAsync(
+            result.data() + startFrame * channelCount, startFrame, chunkFrameCount
+          )
+        );
+      }
+    }
+
+    for(std::future<void> &future : futures) {
+      EXPECT_NO_THROW(future.get());
+    }
+    EXPECT_EQ(result, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackDecoderTest, CallbackReceivesDecodingErrors) {
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::uint64_t frameCount = decoder->CountFrames();
+
+    std::vector<float> left(16), right(16);
+    float *buffers[] = { left.data(), right.data() };
+
+    std::atomic<int> successCount(0), failureCount(0);
+    AsyncTrackDecoder asyncDecoder(decoder);
+    std::future<void> succeeded = asyncDecoder.DecodeSeparatedAsync<float>(buffers, 0, 16);
+    asyncDecoder.DecodeSeparatedAsync<float>(
+      buffers, frameCount + 100, 16,
+      [&](std::exception_ptr error) {
+        if(static_cast<bool>(error)) {
+          failureCount.fetch_add(1);
+        } else {
+          successCount.fetch_add(1);
+        }
+      }
+    );
+    std::future<void> failed = asyncDecoder.DecodeInterleavedAsync(
+      left.data(), frameCount + 100, 1
+    );
+
+    EXPECT_NO_THROW(succeeded.get());
+    EXPECT_ANY_THROW(failed.get());
+
+    // Calls complete in order, so the callback has run before the last future completed
+    EXPECT_EQ(successCount.load(), 0);
+    EXPECT_EQ(failureCount.load(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,196 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AsyncTrackEncoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that keeps its contents in memory and grows when written</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(this->IsFailingAudioWrites && (start > 0)) {
+        throw std::runtime_error(u8"Simulated write error");
+      }
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>If set, all writes except to the header will fail</summary>
+    public: bool IsFailingAudioWrites = false;
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a Waveform encoder for stereo floats writing into a file</summary>
+  /// <param name="file">File the encoder will write into</param>
+  /// <returns>The new encoder</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> buildStereoEncoder(
+    const std::shared_ptr<Nuclex::Audio::Storage::VirtualFile> &file
+  ) {
+    Nuclex::Audio::Storage::Waveform::WaveformTrackEncoderBuilder builder;
+    return builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(Nuclex::Audio::AudioSampleFormat::Float_32).
+      Build(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackEncoderTest, RequiresEncoderAndBuffers) {
+    std::shared_ptr<AudioTrackEncoder> encoder = buildStereoEncoder(
+      std::make_shared<GrowingMemoryFile>()
+    );
+
+    EXPECT_THROW(
+      AsyncTrackEncoder async(std::shared_ptr<AudioTrackEncoder>(), 4),
+      std::invalid_argument
+    );
+    EXPECT_THROW(AsyncTrackEncoder async(encoder, 0), std::invalid_argument);
+    EXPECT_THROW(AsyncTrackEncoder async(encoder, 4, 0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackEncoderTest, RejectsBlocksLargerThanBuffer) {
+    AsyncTrackEncoder async(buildStereoEncoder(std::make_shared<GrowingMemoryFile>()), 4, 256);
+
+    std::vector<float> samples(512 * 2);
+    EXPECT_FALSE(async.TryEncodeInterleaved(samples.data(), 512));
+    EXPECT_FALSE(async.HasFailed());
+    EXPECT_TRUE(async.TryEncodeInterleaved(samples.data(), 256));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackEncoderTest, EncodesAllQueuedSamples) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    std::vector<float> expected(10000 * 2);
+    for(std::size_t index = 0; index < expected.size(); ++index) {
+      expected[index] = static_cast<float>(index % 1000) / 1000.0f - 0.5f;
+    }
+
+    {
+      AsyncTrackEncoder async(buildStereoEncoder(file), 4, 1000);
+
+      // Hand over the first 1000 frames as separate channels, retrying while
+      // all buffers are busy, then the rest through the blocking method
+      std::vector<float> left(1000), right(1000);
+      for(std::size_t index = 0; index < 1000; ++index) {
+        left[index] = expected[index * 2];
+        right[index] = expected[index * 2 + 1];
+      }
+      const float *buffers[] = { left.data(), right.data() };
+      while(!async.TryEncodeSeparated(buffers, 1000)) {
+        ASSERT_FALSE(async.HasFailed());
+      }
+      async.EncodeInterleaved(expected.data() + 2000, 9000);
+
+      std::future<void> flushed = async.Flush();
+      flushed.get();
+      EXPECT_EQ(async.CountQueuedBuffers(), 0U);
+      EXPECT_FALSE(async.TryEncodeInterleaved(expected.data(), 1));
+      EXPECT_THROW(async.Flush(), std::logic_error);
+    }
+
+    Waveform::WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), 10000U);
+
+    std::vector<float> actual(10000 * 2);
+    decoder.DecodeInterleaved(actual.data(), 0, 10000);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AsyncTrackEncoderTest, DeliversEncoderErrorsThroughFlush) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+    std::shared_ptr<AudioTrackEncoder> encoder = buildStereoEncoder(file);
+    file->IsFailingAudioWrites = true;
+
+    AsyncTrackEncoder async(encoder, 2, 100);
+
+    std::vector<float> samples(100 * 2);
+    ASSERT_TRUE(async.TryEncodeInterleaved(samples.data(), 100));
+
+    std::future<void> flushed = async.Flush();
+    EXPECT_THROW(flushed.get(), std::runtime_error);
+    EXPECT_TRUE(async.HasFailed());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
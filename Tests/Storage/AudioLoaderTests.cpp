@@ -21,12 +21,101 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Track.h"
+#include "Nuclex/Audio/Storage/AudioCodec.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 
 #include "./ResourceDirectoryLocator.h"
 
 #include <gtest/gtest.h>
 
+#include <atomic> // for std::atomic
+#include <future> // for std::future, std::promise
+#include <memory> // for std::make_unique()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Dummy codec that counts how often it was asked to load a file</summary>
+  /// <typeparam name="AcceptsAnyFile">Whether the codec claims it can load any file</typeparam>
+  template<bool AcceptsAnyFile>
+  class CountingAudioCodec : public Nuclex::Audio::Storage::AudioCodec {
+
+    /// <summary>Initializes a new counting audio codec</summary>
+    /// <param name="extension">File extension the codec will register for</param>
+    /// <param name="tryCount">Will be incremented whenever the codec is asked</param>
+    public: CountingAudioCodec(const std::string &extension, std::size_t &tryCount) :
+      name(u8"Counting"),
+      extensions(),
+      tryCount(tryCount) {
+      if(!extension.empty()) {
+        this->extensions.push_back(extension);
+      }
+    }
+
+    /// <summary>Gives the name of the file format implemented by this codec</summary>
+    /// <returns>The name of the file format this codec implements</returns>
+    public: const std::string &GetName() const override { return this->name; }
+
+    /// <summary>Provides commonly used file extensions for this codec</summary>
+    /// <returns>The commonly used file extensions in order of preference</returns>
+    public: const std::vector<std::string> &GetFileExtensions() const override {
+      return this->extensions;
+    }
+
+    /// <summary>Tries to read informations for an audio container</summary>
+    /// <param name="source">Source data from which the informations should be extracted</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <returns>Informations about the audio container, if the codec can load it</returns>
+    public: std::optional<Nuclex::Audio::ContainerInfo> TryReadInfo(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &source,
+      const std::string &extensionHint = std::string()
+    ) const override {
+      (void)source;
+      (void)extensionHint;
+      ++this->tryCount;
+      if(AcceptsAnyFile) {
+        return Nuclex::Audio::ContainerInfo();
+      } else {
+        return std::optional<Nuclex::Audio::ContainerInfo>();
+      }
+    }
+
+    /// <summary>Opens a new decoder for the specified audio file</summary>
+    /// <param name="source">Source data that will be opened for audio decoding</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="trackIndex">Index of the audio track to create a decoder for</param>
+    /// <returns>A decoder that can be used to decode the audio track</returns>
+    public: std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> TryOpenDecoder(
+      const std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> &source,
+      const std::string &extensionHint = std::string(),
+      std::size_t trackIndex = 0
+    ) const override {
+      (void)source;
+      (void)extensionHint;
+      (void)trackIndex;
+      ++this->tryCount;
+      return std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder>();
+    }
+
+    /// <summary>Name of the codec</summary>
+    private: std::string name;
+    /// <summary>File extensions the codec registers for</summary>
+    private: std::vector<std::string> extensions;
+    /// <summary>Incremented whenever the codec is asked to load a file</summary>
+    private: std::size_t &tryCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
@@ -144,6 +233,97 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(AudioLoaderTest, CanGetMetadataForManyFilesConcurrently) {
+    AudioLoader loader;
+
+    std::vector<std::string> paths;
+    for(std::size_t repetition = 0; repetition < 8; ++repetition) {
+      paths.push_back(GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav");
+      paths.push_back(GetResourcesDirectory() + u8"waveform-mono-uint8-pcmwaveformat.wav");
+    }
+    paths.push_back(GetResourcesDirectory() + u8"this-file-does-not-exist.wav");
+
+    std::vector<std::size_t> callCounts(paths.size(), 0);
+    std::size_t supportedCount = 0, errorCount = 0;
+    loader.TryReadInfoBatch(
+      paths,
+      [&](std::size_t pathIndex, std::optional<ContainerInfo> &&info, std::exception_ptr error) {
+        ++callCounts.at(pathIndex);
+        if(static_cast<bool>(error)) {
+          ++errorCount;
+        } else if(info.has_value()) {
+          ++supportedCount;
+        }
+      },
+      4
+    );
+
+    EXPECT_EQ(callCounts, std::vector<std::size_t>(paths.size(), 1));
+    EXPECT_EQ(supportedCount, 16U);
+    EXPECT_EQ(errorCount, 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, CanOpenDecoderOnWaveform) {
+    AudioLoader loader;
+
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    EXPECT_TRUE(static_cast<bool>(decoder));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, ReopeningDecoderFallsBackToOpeningNewOne) {
+    AudioLoader loader;
+
+    std::shared_ptr<AudioTrackDecoder> decoder;
+    loader.ReopenDecoder(
+      decoder,
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+      )
+    );
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->CountChannels(), 2U);
+
+    loader.ReopenDecoder(
+      decoder,
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-5dot1-int16le-pcmwaveformat.wav"
+      )
+    );
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->CountChannels(), 6U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+  TEST(AudioLoaderTest, OpusDecoderCanBeReopened) {
+    AudioLoader loader;
+
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(
+      GetResourcesDirectory() + u8"opus-stereo-v152.opus"
+    );
+    const AudioTrackDecoder *originalDecoder = decoder.get();
+
+    loader.ReopenDecoder(
+      decoder,
+      VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + u8"opus-5dot1-v152.opus")
+    );
+    EXPECT_EQ(decoder.get(), originalDecoder);
+    EXPECT_EQ(decoder->CountChannels(), 6U);
+
+    std::vector<float> samples(256 * 6);
+    decoder->DecodeInterleaved(samples.data(), 0, 256);
+  }
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(AudioLoaderTest, CanGetMetadataFromWavPack) {
     AudioLoader loader;
 
@@ -182,4 +362,293 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(AudioLoaderTest, SignatureTakesPrecedenceOverExtension) {
+    AudioLoader loader;
+
+    // Register a codec for an extension the Waveform file is then given. Since
+    // the Waveform codec recognizes its signature, the other codec must not be asked.
+    std::size_t tryCount = 0;
+    loader.RegisterCodec(std::make_unique<CountingAudioCodec<false>>(u8"xyz", tryCount));
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::optional<ContainerInfo> info = loader.TryReadInfo(file, u8"xyz");
+    EXPECT_TRUE(info.has_value());
+    EXPECT_EQ(tryCount, 0U);
+
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(file, u8"xyz");
+    EXPECT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(tryCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, LearnsWhichCodecLoadsAnExtension) {
+    AudioLoader loader;
+
+    // The first codec is registered for the extension but rejects the file,
+    // the second codec isn't registered for any extension but accepts everything
+    std::size_t rejectingTryCount = 0, acceptingTryCount = 0;
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<false>>(u8"dat", rejectingTryCount)
+    );
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<true>>(std::string(), acceptingTryCount)
+    );
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin"
+    );
+
+    // Without any history, the codec registered for the extension is asked first
+    EXPECT_TRUE(loader.TryReadInfo(file, u8"dat").has_value());
+    EXPECT_EQ(rejectingTryCount, 1U);
+    EXPECT_EQ(acceptingTryCount, 1U);
+
+    // Now the audio loader knows which codec actually loads these files
+    for(std::size_t index = 0; index < 3; ++index) {
+      EXPECT_TRUE(loader.TryReadInfo(file, u8"DAT").has_value());
+    }
+    EXPECT_EQ(rejectingTryCount, 1U);
+    EXPECT_EQ(acceptingTryCount, 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, StatisticsAreOffByDefault) {
+    AudioLoader loader;
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    EXPECT_TRUE(loader.TryReadInfo(file).has_value());
+
+    AudioLoaderStatistics statistics = loader.GetStatistics();
+    EXPECT_EQ(statistics.InfoReadCount, 0U);
+    EXPECT_EQ(statistics.OpenCount, 0U);
+    ASSERT_GT(statistics.Codecs.size(), 0U);
+    for(const CodecProbeStatistics &codec : statistics.Codecs) {
+      EXPECT_FALSE(codec.CodecName.empty());
+      EXPECT_EQ(codec.ProbeCount, 0U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, StatisticsRecordProbesAndMisses) {
+    AudioLoader loader;
+
+    std::size_t rejectingTryCount = 0, acceptingTryCount = 0;
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<false>>(u8"dat", rejectingTryCount)
+    );
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<true>>(std::string(), acceptingTryCount)
+    );
+    loader.EnableStatistics();
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin"
+    );
+
+    // The first lookup guesses wrong by extension, the later ones learned better
+    for(std::size_t index = 0; index < 4; ++index) {
+      EXPECT_TRUE(loader.TryReadInfo(file, u8"dat").has_value());
+    }
+
+    AudioLoaderStatistics statistics = loader.GetStatistics();
+    EXPECT_EQ(statistics.InfoReadCount, 4U);
+    EXPECT_EQ(statistics.OpenCount, 0U);
+    EXPECT_EQ(statistics.FirstGuessHitCount, 3U);
+    EXPECT_EQ(statistics.MostRecentCodecHitCount, 3U);
+    EXPECT_EQ(statistics.UnsupportedCount, 0U);
+    EXPECT_GE(statistics.InfoReadTime, statistics.DetectionTime);
+
+    std::size_t codecCount = statistics.Codecs.size();
+    ASSERT_GE(codecCount, 2U);
+    const CodecProbeStatistics &rejecting = statistics.Codecs[codecCount - 2];
+    const CodecProbeStatistics &accepting = statistics.Codecs[codecCount - 1];
+    EXPECT_EQ(rejecting.ProbeCount, 1U);
+    EXPECT_EQ(rejecting.MissCount, 1U);
+    EXPECT_EQ(rejecting.ExtensionMissCount, 1U);
+    EXPECT_EQ(accepting.ProbeCount, 4U);
+    EXPECT_EQ(accepting.MissCount, 0U);
+    EXPECT_GE(accepting.ProbeTime, accepting.MissTime);
+
+    // Re-enabling statistics that are already on doesn't reset them,
+    // but turning them off and on again does
+    loader.EnableStatistics();
+    EXPECT_EQ(loader.GetStatistics().InfoReadCount, 4U);
+    loader.EnableStatistics(false);
+    EXPECT_TRUE(loader.TryReadInfo(file, u8"dat").has_value());
+    loader.EnableStatistics();
+    EXPECT_EQ(loader.GetStatistics().InfoReadCount, 0U);
+    EXPECT_EQ(loader.GetStatistics().Codecs[codecCount - 1].ProbeCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, StatisticsCountOpensAndUnsupportedFiles) {
+    AudioLoader loader;
+    loader.EnableStatistics();
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    EXPECT_TRUE(static_cast<bool>(loader.OpenDecoder(file, u8"wav")));
+
+    std::shared_ptr<const VirtualFile> garbage = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin"
+    );
+    EXPECT_THROW(loader.OpenDecoder(garbage), Errors::UnsupportedFormatError);
+
+    AudioLoaderStatistics statistics = loader.GetStatistics();
+    EXPECT_EQ(statistics.OpenCount, 2U);
+    EXPECT_EQ(statistics.InfoReadCount, 0U);
+    EXPECT_EQ(statistics.FirstGuessHitCount, 1U);
+    EXPECT_EQ(statistics.UnsupportedCount, 1U);
+
+    // Every codec was asked about the garbage file and missed
+    std::uint64_t totalMissCount = 0;
+    for(const CodecProbeStatistics &codec : statistics.Codecs) {
+      EXPECT_GE(codec.MissCount, 1U);
+      totalMissCount += codec.MissCount;
+    }
+    EXPECT_EQ(totalMissCount, statistics.Codecs.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, CodecsCanBeRegisteredWhileLoading) {
+    AudioLoader loader;
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    // Keep another thread busy probing the file while codecs are being registered.
+    // Each probe works on its own snapshot of the registered codecs, so it must never
+    // see a half-updated codec list or extension map.
+    std::atomic<bool> isDone(false);
+    std::future<std::size_t> probeCount = std::async(
+      std::launch::async,
+      [&loader, &file, &isDone]() {
+        std::size_t count = 0;
+        do {
+          if(loader.TryReadInfo(file, u8"xyz").has_value()) {
+            ++count;
+          }
+        } while(!isDone.load(std::memory_order_acquire) || (count == 0));
+        return count;
+      }
+    );
+
+    std::size_t rejectingTryCount = 0, acceptingTryCount = 0;
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<false>>(u8"xyz", rejectingTryCount)
+    );
+    loader.RegisterCodec(
+      std::make_unique<CountingAudioCodec<true>>(u8"xyz", acceptingTryCount)
+    );
+    isDone.store(true, std::memory_order_release);
+
+    EXPECT_GT(probeCount.get(), 0U);
+
+    // The Waveform codec recognizes its signature, so the new codecs are never asked
+    EXPECT_EQ(rejectingTryCount, 0U);
+    EXPECT_EQ(acceptingTryCount, 0U);
+
+    // Registering the same codec type twice is still refused
+    EXPECT_THROW(
+      loader.RegisterCodec(
+        std::make_unique<CountingAudioCodec<true>>(std::string(), acceptingTryCount)
+      ),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, CanLoadInterleavedTrack) {
+    AudioLoader loader;
+
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav";
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(path);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::vector<float> expected(frameCount * decoder->CountChannels());
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    Track track = loader.Load(path, SampleLayout::Interleaved, 4);
+    ASSERT_EQ(track.CountChannels(), decoder->CountChannels());
+    ASSERT_EQ(track.CountFrames(), frameCount);
+    EXPECT_EQ(track.GetSampleRate(), 44100U);
+    EXPECT_EQ(track.GetChannelOrder(), decoder->GetChannelOrder());
+
+    std::vector<float> actual(track.GetSamples(), track.GetSamples() + expected.size());
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, CanLoadSeparatedTrack) {
+    AudioLoader loader;
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(file);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    Track track = loader.Load(file, u8"wav", SampleLayout::Separated);
+    ASSERT_EQ(track.CountChannels(), channelCount);
+    ASSERT_EQ(track.CountFrames(), frameCount);
+
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      Channel<float> channel = track.GetChannel(channelIndex);
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        ASSERT_EQ(channel[frameIndex], expected[frameIndex * channelCount + channelIndex]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, CanOpenDecoderAsynchronously) {
+    AudioLoader loader;
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    std::future<std::optional<ContainerInfo>> info = loader.TryReadInfoAsync(path);
+    std::future<std::shared_ptr<AudioTrackDecoder>> decoder = loader.OpenDecoderAsync(path);
+
+    std::optional<ContainerInfo> actualInfo = info.get();
+    ASSERT_TRUE(actualInfo.has_value());
+    ASSERT_EQ(actualInfo.value().Tracks.size(), 1U);
+
+    std::shared_ptr<AudioTrackDecoder> actualDecoder = decoder.get();
+    ASSERT_TRUE(static_cast<bool>(actualDecoder));
+    EXPECT_EQ(actualDecoder->CountFrames(), actualInfo.value().Tracks[0].FrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioLoaderTest, AsynchronousOpenDeliversErrors) {
+    AudioLoader loader;
+
+    std::promise<bool> failed;
+    loader.OpenDecoderAsync(
+      GetResourcesDirectory() + u8"this-file-does-not-exist.wav",
+      [&failed](std::shared_ptr<AudioTrackDecoder> &&decoder, std::exception_ptr error) {
+        failed.set_value(static_cast<bool>(error) && !static_cast<bool>(decoder));
+      }
+    );
+
+    EXPECT_TRUE(failed.get_future().get());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Audio::Storage
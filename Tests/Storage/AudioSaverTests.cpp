@@ -21,6 +21,7 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "Nuclex/Audio/Storage/AudioSaver.h"
+#include "Nuclex/Audio/Storage/AudioTrackEncoderBuilder.h"
 #include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
 
 #include "./ResourceDirectoryLocator.h"
@@ -47,6 +48,28 @@ namespace Nuclex { namespace Audio { namespace Storage {
   }
 
   // ------------------------------------------------------------------------------------------- //
+
+  TEST(AudioSaverTest, CanObtainWaveformEncoderBuilder) {
+    AudioSaver saver;
+
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = saver.ProvideBuilder(
+      u8"Microsoft Waveform"
+    );
+    ASSERT_TRUE(static_cast<bool>(builder));
+    EXPECT_TRUE(builder->IsLossless());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+  TEST(AudioSaverTest, CanObtainFlacEncoderBuilder) {
+    AudioSaver saver;
+
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = saver.ProvideBuilder(u8"FLAC");
+    ASSERT_TRUE(static_cast<bool>(builder));
+    EXPECT_TRUE(builder->IsLossless());
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
   TEST(AudioSaverTest, CanObtainOpusEncoderBuilder) {
     AudioSaver saver;
@@ -59,5 +82,25 @@ namespace Nuclex { namespace Audio { namespace Storage {
   }
 #endif
   // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+  TEST(AudioSaverTest, CanObtainVorbisEncoderBuilder) {
+    AudioSaver saver;
+
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = saver.ProvideBuilder(u8"Vorbis");
+    ASSERT_TRUE(static_cast<bool>(builder));
+    EXPECT_FALSE(builder->IsLossless());
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+  TEST(AudioSaverTest, CanObtainWavPackEncoderBuilder) {
+    AudioSaver saver;
+
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = saver.ProvideBuilder(u8"WavPack");
+    ASSERT_TRUE(static_cast<bool>(builder));
+    EXPECT_TRUE(builder->IsLossless());
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
 
 }}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BackgroundIndexer.h"
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BackgroundIndexerTest, IndexesFilesIntoPublishedCatalog) {
+    Nuclex::Support::TemporaryDirectoryScope catalogDirectory(u8"nuclex-audio-index");
+    std::string catalogPath = catalogDirectory.GetPath(u8"assets.catalog");
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    std::shared_ptr<AudioLoader> loader = std::make_shared<AudioLoader>();
+    BackgroundIndexer indexer(catalogPath, loader);
+    indexer.AddFile(path);
+    indexer.AddFile(GetResourcesDirectory() + u8"this-file-does-not-exist.wav");
+    indexer.Start();
+    indexer.Wait();
+
+    BackgroundIndexProgress progress = indexer.GetProgress();
+    EXPECT_EQ(progress.FileCount, 2U);
+    EXPECT_EQ(progress.IndexedFileCount, 1U);
+    EXPECT_EQ(progress.FailedFileCount, 1U);
+    EXPECT_GT(progress.ReadByteCount, 0U);
+    EXPECT_EQ(progress.PublishCount, 1U);
+    EXPECT_FALSE(static_cast<bool>(progress.PublishError));
+
+    std::shared_ptr<const AssetCatalog> catalog = indexer.GetCatalog();
+    ASSERT_TRUE(static_cast<bool>(catalog));
+    std::optional<AssetRecord> record = catalog->TryLookup(path);
+    ASSERT_TRUE(record.has_value());
+    ASSERT_TRUE(record.value().Info.has_value());
+    EXPECT_FALSE(record.value().PeakPyramid.empty());
+    EXPECT_TRUE(record.value().IntegratedLoudness.has_value());
+
+    // The catalog was also written to disk where it can be opened again
+    std::shared_ptr<const AssetCatalog> reopened = AssetCatalog::Open(catalogPath);
+    EXPECT_TRUE(reopened->TryLookup(path).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BackgroundIndexerTest, UpToDateFilesAreTakenOverFromExistingCatalog) {
+    Nuclex::Support::TemporaryDirectoryScope catalogDirectory(u8"nuclex-audio-index");
+    std::string catalogPath = catalogDirectory.GetPath(u8"assets.catalog");
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    {
+      BackgroundIndexer indexer(catalogPath);
+      indexer.AddFile(path);
+      indexer.Start();
+      indexer.Wait();
+      ASSERT_EQ(indexer.GetProgress().IndexedFileCount, 1U);
+    }
+
+    BackgroundIndexer indexer(catalogPath);
+    indexer.AddFile(path);
+    indexer.Start();
+    indexer.Wait();
+
+    BackgroundIndexProgress progress = indexer.GetProgress();
+    EXPECT_EQ(progress.IndexedFileCount, 0U);
+    EXPECT_EQ(progress.UpToDateFileCount, 1U);
+    EXPECT_EQ(progress.ReadByteCount, 0U);
+    EXPECT_TRUE(indexer.GetCatalog()->TryLookup(path).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,256 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BatchTranscoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that keeps its contents in memory and grows when written</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens the stereo test file all transcoding tests work with</summary>
+  /// <returns>The stereo test file</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> openStereoFile() {
+    return Nuclex::Audio::Storage::VirtualFile::OpenRealFileForReading(
+      Nuclex::Audio::GetResourcesDirectory() +
+      u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a builder for Waveform files storing floating point samples</summary>
+  /// <returns>The new encoder builder</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoderBuilder> makeFloatBuilder() {
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoderBuilder> builder = (
+      std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackEncoderBuilder>()
+    );
+    builder->SetSampleFormat(Nuclex::Audio::AudioSampleFormat::Float_32);
+    return builder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BatchTranscoderTest, RejectsIncompleteJobs) {
+    BatchTranscoder transcoder(2);
+
+    TranscodeJob job;
+    job.Source = openStereoFile();
+    job.Target = std::make_shared<GrowingMemoryFile>();
+    EXPECT_THROW(transcoder.AddJob(job), std::invalid_argument);
+    EXPECT_EQ(transcoder.CountJobs(), 0U);
+
+    job.TargetBuilder = makeFloatBuilder();
+    transcoder.AddJob(job);
+    EXPECT_EQ(transcoder.CountJobs(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BatchTranscoderTest, TranscodesAllJobsWithinMemoryBudget) {
+    std::shared_ptr<const VirtualFile> source = openStereoFile();
+
+    std::vector<float> expected;
+    {
+      Waveform::WaveformTrackDecoder decoder(source);
+      expected.resize(static_cast<std::size_t>(decoder.CountFrames()) * 2);
+      decoder.DecodeInterleaved(expected.data(), 0, decoder.CountFrames());
+    }
+
+    // Use a tiny budget so decoders have to wait for (and help) the encoders
+    BatchTranscoder transcoder(4, 1);
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = makeFloatBuilder();
+
+    std::vector<std::shared_ptr<GrowingMemoryFile>> targets;
+    for(std::size_t index = 0; index < 8; ++index) {
+      targets.push_back(std::make_shared<GrowingMemoryFile>());
+
+      TranscodeJob job;
+      job.Source = source;
+      job.SourceExtensionHint = u8"wav";
+      job.TargetBuilder = builder;
+      job.Target = targets.back();
+      transcoder.AddJob(job);
+    }
+
+    TranscodeStatistics statistics = transcoder.Run();
+    EXPECT_EQ(transcoder.CountJobs(), 0U);
+    EXPECT_EQ(statistics.SucceededJobCount, 8U);
+    EXPECT_EQ(statistics.FailedJobCount, 0U);
+    EXPECT_EQ(statistics.EncodedFrameCount, (expected.size() / 2) * 8);
+    EXPECT_GT(statistics.EncodedSeconds, 0.0);
+    EXPECT_GT(statistics.WrittenByteCount, 0U);
+
+    // With a budget that small, only a single chunk can be in flight at any time
+    EXPECT_LE(statistics.PeakInFlightByteCount, 16384U * 2U * sizeof(float));
+
+    for(const std::shared_ptr<GrowingMemoryFile> &target : targets) {
+      Waveform::WaveformTrackDecoder decoder(target);
+      ASSERT_EQ(decoder.CountFrames() * 2, expected.size());
+
+      std::vector<float> actual(expected.size());
+      decoder.DecodeInterleaved(actual.data(), 0, decoder.CountFrames());
+      EXPECT_EQ(actual, expected);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BatchTranscoderTest, ReportsFailedJobsWithoutStoppingOthers) {
+    BatchTranscoder transcoder(2);
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = makeFloatBuilder();
+
+    TranscodeJob goodJob;
+    goodJob.Source = openStereoFile();
+    goodJob.TargetBuilder = builder;
+    goodJob.Target = std::make_shared<GrowingMemoryFile>();
+
+    // An empty file is not an audio file in any format
+    TranscodeJob badJob = goodJob;
+    badJob.Source = std::make_shared<GrowingMemoryFile>();
+    badJob.Target = std::make_shared<GrowingMemoryFile>();
+
+    transcoder.AddJob(goodJob);
+    transcoder.AddJob(badJob);
+
+    TranscodeStatistics statistics = transcoder.Run();
+    EXPECT_EQ(statistics.SucceededJobCount, 1U);
+    EXPECT_EQ(statistics.FailedJobCount, 1U);
+    ASSERT_EQ(statistics.Errors.size(), 2U);
+    EXPECT_FALSE(static_cast<bool>(statistics.Errors[0]));
+    EXPECT_TRUE(static_cast<bool>(statistics.Errors[1]));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BatchTranscoderTest, CanRemixAndResample) {
+    std::shared_ptr<GrowingMemoryFile> target = std::make_shared<GrowingMemoryFile>();
+
+    TranscodeJob job;
+    job.Source = openStereoFile();
+    job.TargetBuilder = makeFloatBuilder();
+    job.Target = target;
+    job.TargetChannels = { ChannelPlacement::FrontCenter };
+    job.TargetSampleRate = 22050;
+
+    BatchTranscoder transcoder(1);
+    transcoder.AddJob(job);
+
+    TranscodeStatistics statistics = transcoder.Run();
+    ASSERT_EQ(statistics.SucceededJobCount, 1U);
+
+    Waveform::WaveformTrackDecoder decoder(target);
+    EXPECT_EQ(decoder.CountChannels(), 1U);
+    EXPECT_EQ(decoder.CountFrames(), statistics.EncodedFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BatchTranscoderTest, CancelledJobsAreReportedAsSuch) {
+    std::shared_ptr<AudioTrackEncoderBuilder> builder = makeFloatBuilder();
+    std::shared_ptr<CancellationToken> token = std::make_shared<CancellationToken>();
+    token->Cancel();
+
+    TranscodeJob job;
+    job.Source = openStereoFile();
+    job.TargetBuilder = builder;
+    job.Target = std::make_shared<GrowingMemoryFile>();
+    job.Cancellation = token;
+
+    BatchTranscoder transcoder(2);
+    transcoder.AddJob(job);
+
+    job.Target = std::make_shared<GrowingMemoryFile>();
+    job.Cancellation.reset();
+    transcoder.AddJob(job);
+
+    TranscodeStatistics statistics = transcoder.Run();
+    EXPECT_EQ(statistics.SucceededJobCount, 1U);
+    EXPECT_EQ(statistics.FailedJobCount, 1U);
+    EXPECT_EQ(statistics.CancelledJobCount, 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
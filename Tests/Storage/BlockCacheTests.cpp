@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/BlockCache.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::equal()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a recognizable pattern of bytes</summary>
+  /// <param name="length">Number of bytes that will be generated</param>
+  /// <returns>A memory buffer filled with the byte pattern</returns>
+  std::vector<std::byte> makeBytePattern(std::size_t length) {
+    std::vector<std::byte> bytes(length);
+    for(std::size_t index = 0; index < length; ++index) {
+      bytes[index] = static_cast<std::byte>((index * 13 + index / 256) & 0xFF);
+    }
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCacheTest, HasDefaultConstructor) {
+    EXPECT_NO_THROW(
+      BlockCache cache;
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCacheTest, FilesWithSameIdentityShareBlocks) {
+    std::vector<std::byte> pattern = makeBytePattern(10000);
+    std::shared_ptr<BlockCache> cache = std::make_shared<BlockCache>(65536, 1024);
+
+    std::shared_ptr<const VirtualFile> first = BlockCache::Wrap(
+      cache, std::make_shared<ByteArrayAsFile>(pattern.data(), pattern.size()), u8"test"
+    );
+    std::shared_ptr<const VirtualFile> second = BlockCache::Wrap(
+      cache, std::make_shared<ByteArrayAsFile>(pattern.data(), pattern.size()), u8"test"
+    );
+
+    std::vector<std::byte> bytes(3000);
+    first->ReadAt(500, 3000, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 500));
+    EXPECT_EQ(cache->CountMisses(), 4U); // blocks 0, 1, 2 and 3
+    EXPECT_EQ(cache->CountHits(), 0U);
+
+    second->ReadAt(1100, 2000, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + 2000, pattern.begin() + 1100));
+    EXPECT_EQ(cache->CountMisses(), 4U);
+    EXPECT_EQ(cache->CountHits(), 3U); // blocks 1, 2 and 3
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCacheTest, MemoryLimitIsRespected) {
+    std::vector<std::byte> pattern = makeBytePattern(10000);
+    std::shared_ptr<BlockCache> cache = std::make_shared<BlockCache>(4096, 1024);
+
+    std::shared_ptr<const VirtualFile> file = BlockCache::Wrap(
+      cache, std::make_shared<ByteArrayAsFile>(pattern.data(), pattern.size()), u8"test"
+    );
+
+    std::vector<std::byte> bytes(10000);
+    file->ReadAt(0, 10000, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin()));
+    EXPECT_LE(cache->GetMemoryUsage(), 4096U);
+
+    cache->SetMemoryLimit(1024);
+    EXPECT_LE(cache->GetMemoryUsage(), 1024U);
+
+    cache->Clear();
+    EXPECT_EQ(cache->GetMemoryUsage(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -39,6 +39,17 @@ namespace Nuclex { namespace Audio { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  const std::byte *ByteArrayAsFile::TryBorrowAt(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    if((start > this->length) || (this->length - start < byteCount)) {
+      return nullptr;
+    }
+    return this->data + start;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void ByteArrayAsFile::WriteAt(
     std::uint64_t start, std::size_t byteCount, const std::byte *buffer
   ) {
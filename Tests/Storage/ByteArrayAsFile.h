@@ -56,6 +56,14 @@ namespace Nuclex { namespace Audio { namespace Storage {
       std::uint64_t start, std::size_t byteCount, std::byte *buffer
     ) const override;
 
+    /// <summary>Provides direct access to a range of the byte array</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>A pointer into the byte array at the requested offset</returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
     /// <summary>Writes data into the file</summary>
     /// <param name="start">Offset at which writing will begin in the file</param>
     /// <param name="byteCount">Number of bytes that should be written</param>
@@ -0,0 +1,70 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ChunkSizePolicy.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkSizePolicyTest, DetectsUsableCacheBudget) {
+    ChunkSizePolicy policy;
+    EXPECT_GE(policy.GetCacheBudget(), 16U * 1024U);
+    EXPECT_LE(policy.GetCacheBudget(), 1024U * 1024U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkSizePolicyTest, ChunkFitsIntoCacheBudget) {
+    ChunkSizePolicy policy(65536);
+
+    // Stereo, 16-bit scratch samples converted to floats need 12 bytes per frame
+    std::size_t frameCount = policy.GetChunkFrameCount(2, 2, 4);
+    EXPECT_LE(frameCount * 12, 65536U);
+    EXPECT_GT(frameCount * 12, 65536U - ChunkSizePolicy::MinimumFrameCount * 12);
+    EXPECT_EQ(frameCount % ChunkSizePolicy::MinimumFrameCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkSizePolicyTest, ChunkNeverFallsBelowMinimum) {
+    ChunkSizePolicy policy(1024);
+    EXPECT_EQ(policy.GetChunkFrameCount(255, 8, 8), ChunkSizePolicy::MinimumFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkSizePolicyTest, GlobalPolicyCanBeReplaced) {
+    ChunkSizePolicy policy(4096);
+
+    ChunkSizePolicy::SetGlobal(&policy);
+    EXPECT_EQ(&ChunkSizePolicy::GetGlobal(), &policy);
+
+    ChunkSizePolicy::SetGlobal(nullptr);
+    EXPECT_NE(&ChunkSizePolicy::GetGlobal(), &policy);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,167 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/CompactTrackCatalog.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds the informations of a plain stereo track</summary>
+  /// <param name="codecName">Codec name that will be listed for the track</param>
+  /// <param name="frameCount">Number of frames the track will report</param>
+  /// <returns>The new track informations</returns>
+  Nuclex::Audio::TrackInfo makeTrack(const std::string &codecName, std::uint64_t frameCount) {
+    Nuclex::Audio::TrackInfo track = Nuclex::Audio::TrackInfo();
+    track.CodecName = codecName;
+    track.ChannelCount = 2;
+    track.ChannelPlacements = (
+      Nuclex::Audio::ChannelPlacement::FrontLeft | Nuclex::Audio::ChannelPlacement::FrontRight
+    );
+    track.SampleRate = 48000;
+    track.SampleFormat = Nuclex::Audio::AudioSampleFormat::SignedInteger_16;
+    track.BitsPerSample = 16;
+    track.FrameCount = frameCount;
+    track.Duration = std::chrono::microseconds(frameCount * 1000000 / 48000);
+    return track;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompactTrackCatalogTest, PlainTracksRoundTrip) {
+    CompactTrackCatalogWriter writer;
+    for(std::size_t index = 0; index < 1000; ++index) {
+      EXPECT_EQ(writer.Add(makeTrack((index % 2 == 0) ? u8"FLAC" : u8"Opus", index)), index);
+    }
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    // Codec names are interned, so the file is barely larger than the fixed records
+    EXPECT_LT(file->GetSize(), 1000 * CompactTrackCatalogWriter::RecordByteCount + 128);
+
+    CompactTrackCatalog catalog(file);
+    ASSERT_EQ(catalog.CountTracks(), 1000U);
+    for(std::size_t index = 0; index < 1000; ++index) {
+      EXPECT_EQ(catalog.GetCodecName(index), (index % 2 == 0) ? u8"FLAC" : u8"Opus");
+      EXPECT_EQ(catalog.GetFrameCount(index), index);
+      EXPECT_EQ(catalog.GetSampleRate(index), 48000U);
+      EXPECT_EQ(catalog.GetChannelCount(index), 2U);
+    }
+
+    TrackInfo track = catalog.GetTrackInfo(999);
+    TrackInfo expected = makeTrack(u8"Opus", 999);
+    EXPECT_EQ(track.CodecName, expected.CodecName);
+    EXPECT_FALSE(track.Name.has_value());
+    EXPECT_FALSE(track.LanguageCode.has_value());
+    EXPECT_EQ(track.ChannelPlacements, expected.ChannelPlacements);
+    EXPECT_EQ(track.Duration, expected.Duration);
+    EXPECT_EQ(track.SampleFormat, expected.SampleFormat);
+    EXPECT_EQ(track.BitsPerSample, 16U);
+    EXPECT_FALSE(track.Loop.has_value());
+    EXPECT_TRUE(track.Markers.empty());
+
+    EXPECT_THROW(catalog.GetTrackInfo(1000), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompactTrackCatalogTest, OptionalPartsRoundTrip) {
+    TrackInfo detailed = makeTrack(u8"Vorbis", 123456);
+    detailed.Name = u8"Main Theme";
+    detailed.LanguageCode = u8"en-us";
+    detailed.LeadingPaddingFrameCount = 312;
+    detailed.Loop = LoopRegion { 1000, 100000, 0 };
+    detailed.Markers.push_back(Marker { 1, 500, 0, std::string(u8"Intro") });
+    detailed.Markers.push_back(Marker { 2, 9000, 200, std::optional<std::string>() });
+    ReplayGainInfo replayGain;
+    replayGain.TrackGain = -6.5f;
+    replayGain.AlbumPeak = 0.95f;
+    detailed.ReplayGain = replayGain;
+
+    CompactTrackCatalogWriter writer;
+    writer.Add(makeTrack(u8"FLAC", 10));
+    writer.Add(detailed);
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+    CompactTrackCatalog catalog(file);
+
+    TrackInfo track = catalog.GetTrackInfo(1);
+    EXPECT_EQ(track.CodecName, u8"Vorbis");
+    EXPECT_EQ(track.Name, detailed.Name);
+    EXPECT_EQ(track.LanguageCode, detailed.LanguageCode);
+    EXPECT_EQ(track.LeadingPaddingFrameCount, 312U);
+    ASSERT_TRUE(track.Loop.has_value());
+    EXPECT_EQ(track.Loop.value().StartFrame, 1000U);
+    EXPECT_EQ(track.Loop.value().EndFrame, 100000U);
+    ASSERT_EQ(track.Markers.size(), 2U);
+    EXPECT_EQ(track.Markers[0].Label, std::optional<std::string>(u8"Intro"));
+    EXPECT_EQ(track.Markers[1].StartFrame, 9000U);
+    EXPECT_EQ(track.Markers[1].FrameCount, 200U);
+    EXPECT_FALSE(track.Markers[1].Label.has_value());
+    ASSERT_TRUE(track.ReplayGain.has_value());
+    EXPECT_EQ(track.ReplayGain.value().TrackGain, std::optional<float>(-6.5f));
+    EXPECT_FALSE(track.ReplayGain.value().TrackPeak.has_value());
+    EXPECT_EQ(track.ReplayGain.value().AlbumPeak, std::optional<float>(0.95f));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompactTrackCatalogTest, OversizedFieldsAreRejected) {
+    CompactTrackCatalogWriter writer;
+
+    TrackInfo track = makeTrack(u8"Waveform", 1);
+    track.ChannelCount = 70000;
+    EXPECT_THROW(writer.Add(track), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompactTrackCatalogTest, TruncatedFileIsRejected) {
+    CompactTrackCatalogWriter writer;
+    writer.Add(makeTrack(u8"FLAC", 10));
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    std::vector<std::byte> contents(static_cast<std::size_t>(file->GetSize()) - 8);
+    file->ReadAt(0, contents.size(), contents.data());
+
+    std::shared_ptr<WritableMemoryFile> truncated = std::make_shared<WritableMemoryFile>();
+    truncated->WriteAt(0, contents.size(), contents.data());
+    EXPECT_THROW(CompactTrackCatalog catalog(truncated), Errors::CorruptedFileError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
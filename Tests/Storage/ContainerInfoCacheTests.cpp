@@ -0,0 +1,173 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ContainerInfoCache.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds container informations describing a single stereo track</summary>
+  /// <returns>The container informations</returns>
+  Nuclex::Audio::ContainerInfo makeStereoContainerInfo() {
+    Nuclex::Audio::TrackInfo track;
+    track.CodecName = u8"Test";
+    track.Name = u8"Title";
+    track.ChannelCount = 2;
+    track.ChannelPlacements = (
+      Nuclex::Audio::ChannelPlacement::FrontLeft | Nuclex::Audio::ChannelPlacement::FrontRight
+    );
+    track.Duration = std::chrono::microseconds(1234567);
+    track.SampleRate = 48000;
+    track.SampleFormat = Nuclex::Audio::AudioSampleFormat::SignedInteger_24;
+    track.BitsPerSample = 24;
+
+    Nuclex::Audio::ContainerInfo info;
+    info.DefaultTrackIndex = 0;
+    info.Tracks.push_back(track);
+    return info;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContainerInfoCacheTest, LookupRequiresMatchingSizeAndTime) {
+    ContainerInfoCache cache;
+    cache.Store(u8"music.flac", 1000, 42, makeStereoContainerInfo());
+    cache.Store(u8"readme.txt", 10, 42, std::optional<ContainerInfo>());
+
+    std::optional<ContainerInfo> info;
+    ASSERT_TRUE(cache.TryLookup(u8"music.flac", 1000, 42, info));
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info.value().Tracks.at(0).SampleRate, 48000U);
+
+    // Unsupported files are remembered as such
+    ASSERT_TRUE(cache.TryLookup(u8"readme.txt", 10, 42, info));
+    EXPECT_FALSE(info.has_value());
+
+    EXPECT_FALSE(cache.TryLookup(u8"music.flac", 1001, 42, info));
+    EXPECT_FALSE(cache.TryLookup(u8"music.flac", 1000, 43, info));
+    EXPECT_FALSE(cache.TryLookup(u8"other.flac", 1000, 42, info));
+
+    EXPECT_EQ(cache.CountHits(), 2U);
+    EXPECT_EQ(cache.CountMisses(), 3U);
+    cache.ResetStatistics();
+    EXPECT_EQ(cache.CountHits(), 0U);
+    EXPECT_EQ(cache.CountMisses(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContainerInfoCacheTest, EntriesCanBeInvalidated) {
+    ContainerInfoCache cache;
+    cache.Store(u8"a.wav", 1, 1, makeStereoContainerInfo());
+    cache.Store(u8"b.wav", 1, 1, makeStereoContainerInfo());
+    ASSERT_EQ(cache.CountEntries(), 2U);
+
+    EXPECT_TRUE(cache.Invalidate(u8"a.wav"));
+    EXPECT_FALSE(cache.Invalidate(u8"a.wav"));
+    EXPECT_EQ(cache.CountEntries(), 1U);
+
+    cache.Clear();
+    EXPECT_EQ(cache.CountEntries(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContainerInfoCacheTest, CanBeSavedAndLoaded) {
+    ContainerInfoCache original;
+    original.Store(u8"music.flac", 1000, 42, makeStereoContainerInfo());
+    original.Store(u8"readme.txt", 10, 42, std::optional<ContainerInfo>());
+
+    WritableMemoryFile file;
+    original.Save(file);
+
+    ContainerInfoCache loaded;
+    loaded.Load(file);
+    ASSERT_EQ(loaded.CountEntries(), 2U);
+
+    std::optional<ContainerInfo> info;
+    ASSERT_TRUE(loaded.TryLookup(u8"music.flac", 1000, 42, info));
+    ASSERT_TRUE(info.has_value());
+    ASSERT_EQ(info.value().Tracks.size(), 1U);
+
+    const TrackInfo &track = info.value().Tracks[0];
+    EXPECT_EQ(track.CodecName, u8"Test");
+    EXPECT_EQ(track.Name, std::optional<std::string>(u8"Title"));
+    EXPECT_FALSE(track.LanguageCode.has_value());
+    EXPECT_EQ(track.ChannelCount, 2U);
+    EXPECT_TRUE(track.IsStereo());
+    EXPECT_EQ(track.Duration, std::chrono::microseconds(1234567));
+    EXPECT_EQ(track.SampleFormat, AudioSampleFormat::SignedInteger_24);
+    EXPECT_EQ(track.BitsPerSample, 24U);
+
+    ASSERT_TRUE(loaded.TryLookup(u8"readme.txt", 10, 42, info));
+    EXPECT_FALSE(info.has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContainerInfoCacheTest, LoadingRejectsOtherFiles) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    ContainerInfoCache cache;
+    EXPECT_THROW(cache.Load(*file), Errors::CorruptedFileError);
+    EXPECT_EQ(cache.CountEntries(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ContainerInfoCacheTest, AudioLoaderAnswersRepeatedQueriesFromCache) {
+    std::shared_ptr<ContainerInfoCache> cache = std::make_shared<ContainerInfoCache>();
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    AudioLoader loader;
+    loader.SetInfoCache(cache);
+
+    std::optional<ContainerInfo> first = loader.TryReadInfo(path);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(cache->CountMisses(), 1U);
+    EXPECT_EQ(cache->CountHits(), 0U);
+
+    std::optional<ContainerInfo> second = loader.TryReadInfo(path);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(cache->CountHits(), 1U);
+    EXPECT_EQ(second.value().Tracks.at(0).SampleRate, first.value().Tracks.at(0).SampleRate);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
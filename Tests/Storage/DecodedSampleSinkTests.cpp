@@ -0,0 +1,182 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sink that collects all float samples it is handed, interleaved</summary>
+  class RecordingSink : public Nuclex::Audio::Storage::DecodedSampleSink {
+
+    /// <summary>Initializes a new recording sink</summary>
+    /// <param name="startFrame">Frame at which the first block should begin</param>
+    public: RecordingSink(std::uint64_t startFrame) :
+      NextFrame(startFrame),
+      BlockCount(0),
+      HadGap(false),
+      HadFormatMismatch(false),
+      Samples() {}
+
+    /// <summary>Processes a block of decoded samples</summary>
+    /// <param name="samples">View of the decoded samples</param>
+    public: void ProcessSamples(
+      const Nuclex::Audio::Storage::DecodedSamples &samples
+    ) override {
+      if(samples.StartFrame != this->NextFrame) {
+        this->HadGap = true;
+      }
+      if(samples.Format != Nuclex::Audio::AudioSampleFormat::Float_32) {
+        this->HadFormatMismatch = true;
+        return;
+      }
+
+      for(std::size_t frameIndex = 0; frameIndex < samples.FrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < samples.ChannelCount; ++channelIndex) {
+          if(samples.IsInterleaved) {
+            this->Samples.push_back(
+              samples.GetBuffer<float>()[frameIndex * samples.ChannelCount + channelIndex]
+            );
+          } else {
+            this->Samples.push_back(samples.GetBuffer<float>(channelIndex)[frameIndex]);
+          }
+        }
+      }
+
+      this->NextFrame += samples.FrameCount;
+      ++this->BlockCount;
+    }
+
+    /// <summary>Frame at which the next block should begin</summary>
+    public: std::uint64_t NextFrame;
+    /// <summary>Number of blocks the sink has been handed</summary>
+    public: std::size_t BlockCount;
+    /// <summary>Set if a block did not begin where the previous one ended</summary>
+    public: bool HadGap;
+    /// <summary>Set if a block was not in the expected sample format</summary>
+    public: bool HadFormatMismatch;
+    /// <summary>All samples the sink has been handed, interleaved</summary>
+    public: std::vector<float> Samples;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sink that throws as soon as it is handed any samples</summary>
+  class ThrowingSink : public Nuclex::Audio::Storage::DecodedSampleSink {
+
+    /// <summary>Processes a block of decoded samples</summary>
+    /// <param name="samples">View of the decoded samples</param>
+    public: void ProcessSamples(const Nuclex::Audio::Storage::DecodedSamples &) override {
+      throw std::runtime_error(u8"Simulated sink failure");
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSampleSinkTest, SinkReceivesSameSamplesAsBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    Waveform::WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder.CountFrames()) - 1000;
+    std::vector<float> expected(frameCount * decoder.CountChannels());
+    decoder.DecodeInterleaved(expected.data(), 1000, frameCount);
+
+    RecordingSink sink(1000);
+    decoder.DecodeRange(1000, frameCount, sink);
+
+    EXPECT_FALSE(sink.HadGap);
+    EXPECT_FALSE(sink.HadFormatMismatch);
+    EXPECT_GT(sink.BlockCount, 1U);
+    EXPECT_EQ(sink.Samples, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSampleSinkTest, PoolForwardsToSink) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> pool = AudioTrackDecoder::CreatePool(
+      std::make_shared<Waveform::WaveformTrackDecoder>(file), 2
+    );
+
+    std::vector<float> expected(500 * pool->CountChannels());
+    pool->DecodeInterleaved(expected.data(), 250, 500);
+
+    RecordingSink sink(250);
+    pool->DecodeRange(250, 500, sink);
+
+    EXPECT_FALSE(sink.HadGap);
+    EXPECT_EQ(sink.Samples, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSampleSinkTest, OutOfBoundsRangeIsRejected) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    Waveform::WaveformTrackDecoder decoder(file);
+
+    RecordingSink sink(0);
+    EXPECT_THROW(
+      decoder.DecodeRange(decoder.CountFrames(), 1, sink), std::out_of_range
+    );
+    EXPECT_EQ(sink.BlockCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSampleSinkTest, ExceptionsFromSinkResurface) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    Waveform::WaveformTrackDecoder decoder(file);
+
+    ThrowingSink sink;
+    EXPECT_THROW(decoder.DecodeRange(0, 100, sink), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
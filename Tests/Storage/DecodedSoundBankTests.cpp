@@ -0,0 +1,156 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/DecodedSoundBank.h"
+#include "Nuclex/Audio/Storage/SoundBank.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Processing/ChannelMixer.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio files from the test resources that will be packed into the bank</summary>
+  const char *const ClipFileNames[] = {
+    u8"waveform-stereo-int16le-pcmwaveformat.wav",
+    u8"waveform-mono-uint8-pcmwaveformat.wav",
+    u8"waveform-5dot1-int16le-waveformatextensible.wav"
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs the test clips into a sound bank</summary>
+  /// <param name="loader">Audio loader used to inspect the clips</param>
+  /// <returns>The sound bank holding the test clips</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::SoundBank> makeBank(
+    const Nuclex::Audio::Storage::AudioLoader &loader
+  ) {
+    using Nuclex::Audio::Storage::VirtualFile;
+
+    Nuclex::Audio::Storage::SoundBankWriter writer;
+    for(const char *fileName : ClipFileNames) {
+      writer.Add(
+        loader, fileName,
+        VirtualFile::OpenRealFileForReading(Nuclex::Audio::GetResourcesDirectory() + fileName)
+      );
+    }
+
+    std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file = (
+      std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>()
+    );
+    writer.Save(*file);
+
+    return std::make_shared<Nuclex::Audio::Storage::SoundBank>(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSoundBankTest, ClipsAreDecodedInMixerFormat) {
+    AudioLoader loader;
+    std::shared_ptr<const SoundBank> bank = makeBank(loader);
+
+    DecodedSoundBank decoded(
+      *bank, loader, 48000, { ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight }, 2
+    );
+    ASSERT_EQ(decoded.CountClips(), 3U);
+    EXPECT_EQ(decoded.CountChannels(), 2U);
+    EXPECT_EQ(decoded.GetSampleRate(), 48000U);
+
+    for(std::size_t index = 0; index < decoded.CountClips(); ++index) {
+      SoundBankClip clip = bank->GetClip(index);
+      std::uint64_t expectedFrameCount = (
+        loader.OpenDecoder(bank->OpenClipFile(index))->CountFrames() * 48000 /
+        clip.Info.SampleRate
+      );
+      EXPECT_NEAR(
+        static_cast<double>(decoded.GetClip(index).FrameCount),
+        static_cast<double>(expectedFrameCount),
+        1.0
+      );
+
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(decoded.GetSamples(index));
+      EXPECT_EQ(address % 64, 0U);
+    }
+
+    // The stereo clip only needs resampling (if that), so it can be compared directly
+    std::shared_ptr<AudioTrackDecoder> expected = bank->OpenDecoder(loader, 0);
+    if(bank->GetClip(0).Info.SampleRate != 48000) {
+      expected = AudioTrackDecoder::CreateResampler(
+        expected, bank->GetClip(0).Info.SampleRate, 48000
+      );
+    }
+    std::size_t frameCount = decoded.GetClip(0).FrameCount;
+    ASSERT_EQ(frameCount, expected->CountFrames());
+
+    std::vector<float> expectedSamples(frameCount * 2);
+    expected->DecodeInterleaved(expectedSamples.data(), 0, frameCount);
+    std::vector<float> actualSamples(
+      decoded.GetSamples(0), decoded.GetSamples(0) + frameCount * 2
+    );
+    EXPECT_EQ(actualSamples, expectedSamples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSoundBankTest, ClipsCanBeMixedToSurround) {
+    AudioLoader loader;
+    std::shared_ptr<const SoundBank> bank = makeBank(loader);
+
+    std::shared_ptr<AudioTrackDecoder> surround = bank->OpenDecoder(loader, 2);
+    DecodedSoundBank decoded(*bank, loader, 44100, surround->GetChannelOrder());
+    EXPECT_EQ(decoded.CountChannels(), surround->CountChannels());
+
+    const DecodedClip &last = decoded.GetClip(2);
+    EXPECT_LE(last.Offset + last.FrameCount * decoded.CountChannels(), decoded.GetArena().size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecodedSoundBankTest, RequiresChannels) {
+    AudioLoader loader;
+    std::shared_ptr<const SoundBank> bank = makeBank(loader);
+
+    EXPECT_THROW(
+      DecodedSoundBank decoded(*bank, loader, 48000, std::vector<ChannelPlacement>()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,134 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/DiskCachedTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::int16_t
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a decoder on the stereo float waveform file used by the tests</summary>
+  /// <returns>A decoder for the test file</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> openTestDecoder() {
+    using Nuclex::Audio::Storage::VirtualFile;
+    using Nuclex::Audio::GetResourcesDirectory;
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    return std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackDecoder>(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DiskCachedTrackDecoderTest, DeliversSameSamplesAsDecoder) {
+    Nuclex::Support::TemporaryDirectoryScope cacheDirectory(u8"nuclex-audio-cache");
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+
+    std::shared_ptr<AudioTrackDecoder> cached = AudioTrackDecoder::CreateDiskCached(
+      decoder, cacheDirectory.GetPath(), u8"test-track", 3000
+    );
+    ASSERT_EQ(cached->CountChannels(), decoder->CountChannels());
+    ASSERT_EQ(cached->CountFrames(), decoder->CountFrames());
+
+    std::size_t channelCount = decoder->CountChannels();
+    std::vector<float> expected(10000 * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 1234, 10000);
+
+    // The first pass decodes and writes the cache files, the second one reads them
+    for(std::size_t pass = 0; pass < 2; ++pass) {
+      std::vector<float> actual(10000 * channelCount);
+      cached->DecodeInterleaved(actual.data(), 1234, 10000);
+      EXPECT_EQ(actual, expected);
+    }
+
+    // A new decoder on the same identity finds the cache files of the first one
+    std::shared_ptr<AudioTrackDecoder> reopened = AudioTrackDecoder::CreateDiskCached(
+      openTestDecoder(), cacheDirectory.GetPath(), u8"test-track", 3000
+    );
+    std::vector<float> actual(10000 * channelCount);
+    reopened->DecodeInterleaved(actual.data(), 1234, 10000);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DiskCachedTrackDecoderTest, CanDeliverConvertedSeparatedChannels) {
+    Nuclex::Support::TemporaryDirectoryScope cacheDirectory(u8"nuclex-audio-cache");
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+
+    std::vector<std::int16_t> expectedLeft(5000), expectedRight(5000);
+    {
+      std::int16_t *buffers[] = { expectedLeft.data(), expectedRight.data() };
+      decoder->Clone()->DecodeSeparated(buffers, 2000, 5000);
+    }
+
+    std::shared_ptr<AudioTrackDecoder> cached = AudioTrackDecoder::CreateDiskCached(
+      decoder, cacheDirectory.GetPath(), u8"test-track", 4096
+    );
+
+    std::vector<std::int16_t> left(5000), right(5000);
+    std::int16_t *buffers[] = { left.data(), right.data() };
+    cached->DecodeSeparated(buffers, 2000, 5000);
+
+    EXPECT_EQ(left, expectedLeft);
+    EXPECT_EQ(right, expectedRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DiskCachedTrackDecoderTest, StillDecodesIfCacheCannotBeWritten) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+    std::shared_ptr<AudioTrackDecoder> cached = AudioTrackDecoder::CreateDiskCached(
+      decoder, GetResourcesDirectory() + u8"this-directory-does-not-exist", u8"test-track"
+    );
+
+    std::size_t channelCount = decoder->CountChannels();
+    std::vector<float> expected(1000 * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 0, 1000);
+
+    std::vector<float> actual(1000 * channelCount);
+    cached->DecodeInterleaved(actual.data(), 0, 1000);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,128 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/DownmixingTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min(), std::max()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixingTrackDecoderTest, RequiresMatchingChannelOrder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    Processing::DownmixMatrix matrix = Processing::DownmixMatrix::CreateItuMono(
+      { ChannelPlacement::FrontRight, ChannelPlacement::FrontLeft }
+    );
+    EXPECT_THROW(DownmixingTrackDecoder(decoder, matrix), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixingTrackDecoderTest, MixesChannelsWhileDecoding) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+
+    std::vector<float> stereo(frameCount * 2);
+    decoder->DecodeInterleaved(stereo.data(), 0, frameCount);
+
+    Processing::DownmixMatrix matrix = Processing::DownmixMatrix::CreateItuMono(
+      decoder->GetChannelOrder()
+    );
+    std::shared_ptr<AudioTrackDecoder> downmix = AudioTrackDecoder::CreateDownmix(
+      decoder, matrix
+    );
+    ASSERT_EQ(downmix->CountChannels(), 1U);
+    EXPECT_EQ(downmix->GetChannelOrder()[0], ChannelPlacement::FrontCenter);
+
+    // Interleaved and separated delivery should produce the same mix
+    std::vector<float> mono(frameCount);
+    downmix->DecodeInterleaved(mono.data(), 0, frameCount);
+
+    std::vector<std::int16_t> quantizedMono(frameCount);
+    std::int16_t *buffers[] = { quantizedMono.data() };
+    downmix->DecodeSeparated(buffers, 0, frameCount);
+
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      float expected = (
+        stereo[index * 2] * matrix.GetCoefficient(0, 0) +
+        stereo[index * 2 + 1] * matrix.GetCoefficient(0, 1)
+      );
+      ASSERT_NEAR(mono[index], expected, 0.00001f);
+      ASSERT_NEAR(static_cast<float>(quantizedMono[index]) / 32767.0f, expected, 0.0001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DownmixingTrackDecoderTest, ClampsMixedSamplesWhenQuantizing) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    // Amplify the left channel a lot so that the mix goes far beyond full scale
+    Processing::DownmixMatrix matrix(
+      decoder->GetChannelOrder(), { ChannelPlacement::FrontCenter }, { 100.0f, 0.0f }
+    );
+    DownmixingTrackDecoder downmix(decoder, matrix);
+
+    std::size_t frameCount = static_cast<std::size_t>(downmix.CountFrames());
+    std::vector<std::int16_t> samples(frameCount);
+    downmix.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    std::int16_t minimum = 0, maximum = 0;
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      minimum = std::min(minimum, samples[index]);
+      maximum = std::max(maximum, samples[index]);
+    }
+
+    EXPECT_EQ(minimum, -32767);
+    EXPECT_EQ(maximum, 32767);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,100 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/EffortCalibrator.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EffortCalibratorTest, MeasuresEachEffort) {
+    Waveform::WaveformTrackDecoder sample(
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+      )
+    );
+
+    Waveform::WaveformTrackEncoderBuilder builder;
+    builder.SetSampleFormat(AudioSampleFormat::SignedInteger_16);
+    std::vector<EffortMeasurement> measurements = EffortCalibrator::Measure(
+      sample, 44100, builder, { 0.0f, 1.0f }
+    );
+    ASSERT_EQ(measurements.size(), 2U);
+    EXPECT_EQ(measurements[0].Effort, 0.0f);
+    EXPECT_EQ(measurements[1].Effort, 1.0f);
+
+    // Waveforms are uncompressed, so the effort can't change the output size
+    std::uint64_t expectedByteCount = sample.CountFrames() * sample.CountChannels() * 2;
+    for(const EffortMeasurement &measurement : measurements) {
+      EXPECT_GT(measurement.EncodedByteCount, expectedByteCount);
+      EXPECT_EQ(measurement.EncodedByteCount, measurements[0].EncodedByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EffortCalibratorTest, RecommendsBestSavingsPerSecond) {
+    std::vector<EffortMeasurement> measurements = {
+      { 0.0f, 1000, 1.0, 10.0 },
+      { 0.5f, 800, 2.0, 5.0 },   // Saves 200 bytes in 2 seconds, 100 bytes per second
+      { 1.0f, 700, 10.0, 1.0 }   // Saves 300 bytes in 10 seconds, 30 bytes per second
+    };
+    EXPECT_EQ(EffortCalibrator::RecommendEffort(measurements), 0.5f);
+
+    // If no effort saves anything, the fastest effort wins
+    std::vector<EffortMeasurement> uncompressed = {
+      { 1.0f, 1000, 2.0, 5.0 },
+      { 0.0f, 1000, 1.0, 10.0 }
+    };
+    EXPECT_EQ(EffortCalibrator::RecommendEffort(uncompressed), 0.0f);
+
+    EXPECT_THROW(
+      EffortCalibrator::RecommendEffort(std::vector<EffortMeasurement>()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EffortCalibratorTest, RecommendationsCanBeSavedAndLoaded) {
+    std::map<std::string, float> recommendations = {
+      { u8"FLAC", 0.625f },
+      { u8"WavPack", 0.25f }
+    };
+
+    WritableMemoryFile file;
+    EffortCalibrator::SaveRecommendations(recommendations, file);
+    EXPECT_EQ(EffortCalibrator::LoadRecommendations(file), recommendations);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,206 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/EmbeddedStreamScanner.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring> // for std::memcpy()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a memory-backed file filled with bytes that aren't audio</summary>
+  /// <param name="length">Length of the file in bytes</param>
+  /// <returns>The new memory-backed file</returns>
+  /// <remarks>
+  ///   A few signatures are planted in the junk so the scanner has to reject them.
+  /// </remarks>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> makeJunk(std::size_t length) {
+    std::shared_ptr<std::byte[]> memory(new std::byte[length]);
+    for(std::size_t index = 0; index < length; ++index) {
+      memory[index] = static_cast<std::byte>((index * 7 + 3) & 0xFF);
+    }
+    if(length >= 64) {
+      std::memcpy(memory.get() + 5, "RIFF", 4);
+      std::memcpy(memory.get() + 21, "OggS", 4);
+      std::memcpy(memory.get() + 40, "wvpk", 4);
+    }
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EmbeddedStreamScannerTest, FindsNothingInJunk) {
+    std::shared_ptr<const VirtualFile> junk = makeJunk(100000);
+    EXPECT_TRUE(EmbeddedStreamScanner::Scan(*junk).empty());
+
+    std::shared_ptr<const VirtualFile> tiny = makeJunk(3);
+    EXPECT_TRUE(EmbeddedStreamScanner::Scan(*tiny).empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EmbeddedStreamScannerTest, LocatesWaveformFilesInBlob) {
+    std::shared_ptr<const VirtualFile> waveform = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    // The second copy straddles the boundary between two scanning windows
+    std::shared_ptr<const VirtualFile> blob = VirtualFile::CreateConcatenatedView(
+      { makeJunk(1234), waveform, makeJunk(1048576), waveform, makeJunk(77) }
+    );
+
+    std::vector<EmbeddedStream> streams = EmbeddedStreamScanner::Scan(*blob);
+    ASSERT_EQ(streams.size(), 2U);
+
+    std::uint64_t waveformLength = waveform->GetSize();
+    EXPECT_EQ(streams[0].Format, EmbeddedStreamFormat::Waveform);
+    EXPECT_EQ(streams[0].Start, 1234U);
+    EXPECT_EQ(streams[0].Length, waveformLength);
+    EXPECT_TRUE(streams[0].IsLengthExact);
+
+    EXPECT_EQ(streams[1].Format, EmbeddedStreamFormat::Waveform);
+    EXPECT_EQ(streams[1].Start, 1234U + waveformLength + 1048576U);
+    EXPECT_EQ(streams[1].Length, waveformLength);
+    EXPECT_TRUE(streams[1].IsLengthExact);
+
+    // The results can be handed directly to a sub-range view
+    std::shared_ptr<const VirtualFile> view = VirtualFile::CreateSubRangeView(
+      blob, streams[1].Start, streams[1].Length
+    );
+    std::vector<std::byte> expected(static_cast<std::size_t>(waveformLength));
+    std::vector<std::byte> actual(static_cast<std::size_t>(waveformLength));
+    waveform->ReadAt(0, expected.size(), expected.data());
+    view->ReadAt(0, actual.size(), actual.data());
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EmbeddedStreamScannerTest, TruncatedFilesAreMarkedInexact) {
+    std::shared_ptr<const VirtualFile> waveform = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<const VirtualFile> blob = VirtualFile::CreateConcatenatedView(
+      { makeJunk(100), VirtualFile::CreateSubRangeView(waveform, 0, 1000) }
+    );
+
+    std::vector<EmbeddedStream> streams = EmbeddedStreamScanner::Scan(*blob);
+    ASSERT_EQ(streams.size(), 1U);
+    EXPECT_EQ(streams[0].Start, 100U);
+    EXPECT_EQ(streams[0].Length, 1000U);
+    EXPECT_FALSE(streams[0].IsLengthExact);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EmbeddedStreamScannerTest, LocatesCompressedFilesInBlob) {
+    std::vector<std::shared_ptr<const VirtualFile>> parts;
+    std::vector<EmbeddedStreamFormat> formats;
+
+    parts.push_back(makeJunk(500));
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+    parts.push_back(
+      VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + u8"opus-stereo-v152.opus")
+    );
+    formats.push_back(EmbeddedStreamFormat::Opus);
+    parts.push_back(makeJunk(300));
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+    parts.push_back(
+      VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg")
+    );
+    formats.push_back(EmbeddedStreamFormat::Vorbis);
+    parts.push_back(makeJunk(300));
+#endif
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+    parts.push_back(
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"wavpack-stereo-int16-v416.wv"
+      )
+    );
+    formats.push_back(EmbeddedStreamFormat::WavPack);
+    parts.push_back(makeJunk(300));
+#endif
+
+    std::shared_ptr<const VirtualFile> blob = VirtualFile::CreateConcatenatedView(parts);
+    std::vector<EmbeddedStream> streams = EmbeddedStreamScanner::Scan(*blob);
+    ASSERT_EQ(streams.size(), formats.size());
+
+    std::uint64_t offset = parts[0]->GetSize();
+    for(std::size_t index = 0; index < formats.size(); ++index) {
+      EXPECT_EQ(streams[index].Format, formats[index]);
+      EXPECT_EQ(streams[index].Start, offset);
+      EXPECT_EQ(streams[index].Length, parts[index * 2 + 1]->GetSize());
+      EXPECT_TRUE(streams[index].IsLengthExact);
+      offset += parts[index * 2 + 1]->GetSize() + parts[index * 2 + 2]->GetSize();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+  TEST(EmbeddedStreamScannerTest, FlacStreamsExtendToNextFile) {
+    std::shared_ptr<const VirtualFile> flac = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    std::shared_ptr<const VirtualFile> waveform = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<const VirtualFile> blob = VirtualFile::CreateConcatenatedView(
+      { makeJunk(200), flac, waveform }
+    );
+
+    std::vector<EmbeddedStream> streams = EmbeddedStreamScanner::Scan(*blob);
+    ASSERT_EQ(streams.size(), 2U);
+    EXPECT_EQ(streams[0].Format, EmbeddedStreamFormat::Flac);
+    EXPECT_EQ(streams[0].Start, 200U);
+    EXPECT_EQ(streams[0].Length, flac->GetSize());
+    EXPECT_FALSE(streams[0].IsLengthExact);
+    EXPECT_EQ(streams[1].Format, EmbeddedStreamFormat::Waveform);
+  }
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EmbeddedStreamScannerTest, ScanCanBeCancelled) {
+    std::shared_ptr<CancellationToken> token = std::make_shared<CancellationToken>();
+    token->Cancel();
+
+    std::shared_ptr<const VirtualFile> junk = makeJunk(1000);
+    EXPECT_THROW(EmbeddedStreamScanner::Scan(*junk, token), Errors::CancelledError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
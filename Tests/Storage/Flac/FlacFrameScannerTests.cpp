@@ -0,0 +1,278 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Flac/FlacFrameScanner.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../ByteArrayAsFile.h"
+#include "../ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a 256 sample, 16 bit stereo FLAC frame from encoded subframes</summary>
+  /// <param name="subframes">Bytes of the subframes following the frame header</param>
+  /// <returns>The complete frame including its CRC-8 and CRC-16</returns>
+  std::vector<std::byte> makeStereoFrame(const std::vector<std::uint8_t> &subframes) {
+
+    // Fixed blocksize frame number 0, 256 samples, 44.1 kHz, 2 independent channels
+    std::vector<std::uint8_t> bytes = { 0xFF, 0xF8, 0x89, 0x18, 0x00 };
+
+    std::uint8_t crc8 = 0;
+    for(std::uint8_t value : bytes) {
+      crc8 ^= value;
+      for(int bit = 0; bit < 8; ++bit) {
+        crc8 = static_cast<std::uint8_t>((crc8 << 1) ^ (((crc8 & 0x80) != 0) ? 0x07 : 0x00));
+      }
+    }
+    bytes.push_back(crc8);
+    bytes.insert(bytes.end(), subframes.begin(), subframes.end());
+
+    std::uint16_t crc16 = 0;
+    for(std::uint8_t value : bytes) {
+      crc16 ^= static_cast<std::uint16_t>(value << 8);
+      for(int bit = 0; bit < 8; ++bit) {
+        crc16 = static_cast<std::uint16_t>(
+          (crc16 << 1) ^ (((crc16 & 0x8000) != 0) ? 0x8005 : 0x0000)
+        );
+      }
+    }
+    bytes.push_back(static_cast<std::uint8_t>(crc16 >> 8));
+    bytes.push_back(static_cast<std::uint8_t>(crc16 & 0xFF));
+
+    std::vector<std::byte> frame(bytes.size());
+    for(std::size_t index = 0; index < bytes.size(); ++index) {
+      frame[index] = static_cast<std::byte>(bytes[index]);
+    }
+    return frame;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a frame by placing it behind the header of a real FLAC file</summary>
+  /// <param name="frameData">Complete FLAC frame that will be described</param>
+  /// <returns>The description of the frame's contents</returns>
+  Nuclex::Audio::Storage::BlockContent describeStereoFrame(
+    const std::vector<std::byte> &frameData
+  ) {
+    using Nuclex::Audio::Storage::Flac::FlacFrameScanner;
+
+    std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+      Nuclex::Audio::Storage::VirtualFile::OpenRealFileForReading(
+        Nuclex::Audio::GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+      )
+    );
+    FlacFrameScanner originalScanner(*file);
+
+    std::vector<std::byte> contents(
+      static_cast<std::size_t>(originalScanner.GetFirstFrameOffset())
+    );
+    file->ReadAt(0, contents.size(), contents.data());
+    contents.insert(contents.end(), frameData.begin(), frameData.end());
+
+    Nuclex::Audio::Storage::ByteArrayAsFile craftedFile(contents.data(), contents.size());
+    FlacFrameScanner scanner(craftedFile);
+
+    FlacFrameScanner::Frame frame;
+    std::vector<std::byte> data;
+    EXPECT_TRUE(scanner.TryReadFrame(scanner.GetFirstFrameOffset(), frame, &data));
+    return scanner.DescribeFrame(frame, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, ReadsStreamInfo) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    FlacFrameScanner scanner(*file);
+
+    EXPECT_EQ(scanner.CountChannels(), 2U);
+    EXPECT_EQ(scanner.GetBitsPerSample(), 16U);
+    EXPECT_EQ(scanner.GetSampleRate(), 44100U);
+    EXPECT_EQ(scanner.CountTotalSamples(), 44100U);
+    ASSERT_FALSE(scanner.GetMetadataBlocks().empty());
+    EXPECT_EQ(scanner.GetMetadataBlocks().front().Type, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, CanWalkAllFrames) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    FlacFrameScanner scanner(*file);
+
+    std::uint64_t nextSample = 0;
+    std::size_t frameCount = 0;
+
+    FlacFrameScanner::Frame frame;
+    std::uint64_t offset = scanner.GetFirstFrameOffset();
+    while(scanner.TryReadFrame(offset, frame)) {
+      EXPECT_EQ(frame.Offset, offset);
+      EXPECT_EQ(frame.FirstSample, nextSample);
+      nextSample += frame.SampleCount;
+      offset += frame.Length;
+      ++frameCount;
+    }
+
+    EXPECT_EQ(nextSample, 44100U);
+    EXPECT_EQ(offset, file->GetSize());
+    EXPECT_EQ(frameCount, 11U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, FindsFrameHoldingSample) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    FlacFrameScanner scanner(*file);
+
+    FlacFrameScanner::Frame frame = scanner.FindFrame(30000);
+    EXPECT_LE(frame.FirstSample, 30000U);
+    EXPECT_GT(frame.FirstSample + frame.SampleCount, 30000U);
+
+    frame = scanner.FindFrame(0);
+    EXPECT_EQ(frame.Offset, scanner.GetFirstFrameOffset());
+
+    EXPECT_THROW(scanner.FindFrame(44100), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, RenumberedFramesRemainValid) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    FlacFrameScanner scanner(*file);
+
+    FlacFrameScanner::Frame frame;
+    std::vector<std::byte> frameData;
+    ASSERT_TRUE(scanner.TryReadFrame(scanner.GetFirstFrameOffset(), frame, &frameData));
+
+    // Put the renumbered frame behind the original stream header so the scanner
+    // can check the header and both checksums of the rewritten frame
+    std::vector<std::byte> renumbered;
+    FlacFrameScanner::RenumberFrame(frameData.data(), frameData.size(), 123456, renumbered);
+
+    std::vector<std::byte> contents(static_cast<std::size_t>(frame.Offset));
+    file->ReadAt(0, contents.size(), contents.data());
+    contents.insert(contents.end(), renumbered.begin(), renumbered.end());
+
+    ByteArrayAsFile renumberedFile(contents.data(), contents.size());
+    FlacFrameScanner renumberedScanner(renumberedFile);
+
+    FlacFrameScanner::Frame renumberedFrame;
+    ASSERT_TRUE(renumberedScanner.TryReadFrame(frame.Offset, renumberedFrame));
+    EXPECT_EQ(renumberedFrame.FirstSample, 123456U);
+    EXPECT_EQ(renumberedFrame.SampleCount, frame.SampleCount);
+    EXPECT_EQ(renumberedFrame.Length, renumbered.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, FlagsConstantZeroFramesAsSilent) {
+    std::vector<std::byte> frame = makeStereoFrame(
+      { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } // Two CONSTANT subframes storing 0
+    );
+
+    BlockContent content = describeStereoFrame(frame);
+    EXPECT_EQ(content.StartFrame, 0U);
+    EXPECT_EQ(content.FrameCount, 256U);
+    EXPECT_TRUE(content.IsKnown);
+    EXPECT_TRUE(content.IsConstant);
+    EXPECT_TRUE(content.IsSilent);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, ConstantFramesNeedNotBeSilent) {
+    std::vector<std::uint8_t> subframes = { 0x00, 0x00, 0x00 }; // CONSTANT 0
+
+    // VERBATIM subframe in which all 256 samples are -5
+    subframes.push_back(0x02);
+    for(std::size_t index = 0; index < 256; ++index) {
+      subframes.push_back(0xFF);
+      subframes.push_back(0xFB);
+    }
+
+    BlockContent content = describeStereoFrame(makeStereoFrame(subframes));
+    EXPECT_TRUE(content.IsKnown);
+    EXPECT_TRUE(content.IsConstant);
+    EXPECT_FALSE(content.IsSilent);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, VaryingVerbatimFramesAreNotConstant) {
+    std::vector<std::uint8_t> subframes = { 0x02 }; // VERBATIM
+    for(std::size_t index = 0; index < 256; ++index) {
+      subframes.push_back(0x00);
+      subframes.push_back(static_cast<std::uint8_t>(index));
+    }
+    subframes.insert(subframes.end(), { 0x00, 0x00, 0x00 }); // CONSTANT 0
+
+    BlockContent content = describeStereoFrame(makeStereoFrame(subframes));
+    EXPECT_TRUE(content.IsKnown);
+    EXPECT_FALSE(content.IsConstant);
+    EXPECT_FALSE(content.IsSilent);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacFrameScannerTest, MusicFramesAreNotFlaggedAsConstant) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    FlacFrameScanner scanner(*file);
+
+    FlacFrameScanner::Frame frame = scanner.FindFrame(22050);
+    std::vector<std::byte> data;
+    ASSERT_TRUE(scanner.TryReadFrame(frame.Offset, frame, &data));
+
+    BlockContent content = scanner.DescribeFrame(frame, data);
+    EXPECT_EQ(content.StartFrame, frame.FirstSample);
+    EXPECT_EQ(content.FrameCount, frame.SampleCount);
+    EXPECT_TRUE(content.IsKnown);
+    EXPECT_FALSE(content.IsSilent);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
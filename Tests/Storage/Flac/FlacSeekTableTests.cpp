@@ -0,0 +1,130 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Flac/FlacSeekTable.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records 100 FLAC frames of 4096 samples each in a seek table</summary>
+  /// <param name="seekTable">Seek table the FLAC frames will be recorded in</param>
+  void addFrames(Nuclex::Audio::Storage::Flac::FlacSeekTable &seekTable) {
+    for(std::uint64_t frameNumber = 0; frameNumber < 100; ++frameNumber) {
+      seekTable.AddSeekPoint(frameNumber, frameNumber * 4096, 8192 + frameNumber * 3000);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacSeekTableTest, KeepsSeekPointsApartByInterval) {
+    FlacSeekTable seekTable(1048576, 22050);
+    addFrames(seekTable);
+
+    // 22050 samples are 5.38 frames, so every sixth frame becomes a seek point
+    EXPECT_EQ(seekTable.CountSeekPoints(), 17U);
+
+    std::optional<FlacSeekTable::Entry> seekPoint = seekTable.TryFindSeekPoint(30000);
+    ASSERT_TRUE(seekPoint.has_value());
+    EXPECT_EQ(seekPoint.value().FrameNumber, 6U);
+    EXPECT_EQ(seekPoint.value().SampleNumber, 24576U);
+    EXPECT_EQ(seekPoint.value().ByteOffset, 8192U + 18000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacSeekTableTest, IgnoresSeekPointsFarBeforeTarget) {
+    FlacSeekTable seekTable(1048576, 22050);
+    seekTable.AddSeekPoint(0, 0, 8192);
+    seekTable.AddSeekPoint(100, 409600, 308192);
+
+    EXPECT_TRUE(seekTable.TryFindSeekPoint(40000).has_value());
+    EXPECT_FALSE(seekTable.TryFindSeekPoint(200000).has_value()); // gap in the table
+    EXPECT_TRUE(seekTable.TryFindSeekPoint(409700).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacSeekTableTest, SeekPointsCanBeAddedOutOfOrder) {
+    FlacSeekTable seekTable(1048576, 22050);
+    seekTable.AddSeekPoint(50, 204800, 158192);
+    addFrames(seekTable);
+
+    std::optional<FlacSeekTable::Entry> seekPoint = seekTable.TryFindSeekPoint(210000);
+    ASSERT_TRUE(seekPoint.has_value());
+    EXPECT_EQ(seekPoint.value().FrameNumber, 50U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacSeekTableTest, SurvivesSerializationRoundTrip) {
+    FlacSeekTable seekTable(1048576, 22050);
+    addFrames(seekTable);
+    seekTable.MarkComplete();
+    std::vector<std::byte> serializedTable = seekTable.Serialize();
+
+    FlacSeekTable loadedTable(1048576, 44100);
+    loadedTable.Deserialize(serializedTable);
+
+    EXPECT_TRUE(loadedTable.IsComplete());
+    EXPECT_EQ(loadedTable.CountSeekPoints(), seekTable.CountSeekPoints());
+
+    std::optional<FlacSeekTable::Entry> seekPoint = loadedTable.TryFindSeekPoint(30000);
+    ASSERT_TRUE(seekPoint.has_value());
+    EXPECT_EQ(seekPoint.value().SampleNumber, 24576U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacSeekTableTest, RejectsMismatchedOrDamagedSerializedTable) {
+    FlacSeekTable seekTable(1048576, 22050);
+    addFrames(seekTable);
+    std::vector<std::byte> serializedTable = seekTable.Serialize();
+
+    FlacSeekTable otherFileTable(1048577, 22050);
+    EXPECT_THROW(otherFileTable.Deserialize(serializedTable), Errors::CorruptedFileError);
+
+    serializedTable.pop_back();
+    FlacSeekTable sameFileTable(1048576, 22050);
+    EXPECT_THROW(sameFileTable.Deserialize(serializedTable), Errors::CorruptedFileError);
+    EXPECT_EQ(sameFileTable.CountSeekPoints(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
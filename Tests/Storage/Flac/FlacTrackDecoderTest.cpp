@@ -30,9 +30,52 @@ limitations under the License.
 #include "../../Processing/SineWaveDetector.h"
 #include "../../ExpectRange.h"
 
+#include "Nuclex/Audio/Storage/DecodedSampleSink.h"
+
+#include <stdexcept> // for std::out_of_range
+#include <thread> // for std::this_thread
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sink that collects the integer samples it is handed, interleaved</summary>
+  class NativeSampleRecorder : public Nuclex::Audio::Storage::DecodedSampleSink {
+
+    /// <summary>Processes a block of decoded samples</summary>
+    /// <param name="samples">View of the decoded samples</param>
+    public: void ProcessSamples(
+      const Nuclex::Audio::Storage::DecodedSamples &samples
+    ) override {
+      if(samples.StartFrame != this->FrameCount) {
+        this->HadGap = true;
+      }
+      this->Format = samples.Format;
+      this->BitsPerSample = samples.BitsPerSample;
+
+      for(std::size_t frameIndex = 0; frameIndex < samples.FrameCount; ++frameIndex) {
+        for(std::size_t channelIndex = 0; channelIndex < samples.ChannelCount; ++channelIndex) {
+          this->Samples.push_back(samples.GetBuffer<std::int32_t>(channelIndex)[frameIndex]);
+        }
+      }
+      this->FrameCount += samples.FrameCount;
+    }
+
+    /// <summary>Format of the most recently delivered block</summary>
+    public: Nuclex::Audio::AudioSampleFormat Format = (
+      Nuclex::Audio::AudioSampleFormat::Unknown
+    );
+    /// <summary>Number of valid bits in the most recently delivered block</summary>
+    public: std::size_t BitsPerSample = 0;
+    /// <summary>Total number of frames the recorder has been handed</summary>
+    public: std::uint64_t FrameCount = 0;
+    /// <summary>Set if a block did not begin where the previous one ended</summary>
+    public: bool HadGap = false;
+    /// <summary>All samples the recorder has been handed, interleaved</summary>
+    public: std::vector<std::int32_t> Samples;
+
+  };
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -177,6 +220,85 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(FlacTrackDecoderTest, HandsLibFlacBuffersToSink) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int24-v143.flac"
+    );
+
+    FlacTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    NativeSampleRecorder recorder;
+    decoder.DecodeRange(0, frameCount, recorder);
+
+    EXPECT_FALSE(recorder.HadGap);
+    EXPECT_EQ(recorder.FrameCount, frameCount);
+    EXPECT_EQ(recorder.Format, AudioSampleFormat::SignedInteger_32);
+    EXPECT_EQ(recorder.BitsPerSample, 24U);
+
+    ASSERT_EQ(recorder.Samples.size(), expected.size());
+    for(std::size_t index = 0; index < expected.size(); ++index) {
+      EXPECT_RANGE(
+        static_cast<float>(recorder.Samples[index]) / 8388607.0f,
+        expected[index] - 0.0001f, expected[index] + 0.0001f
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackDecoderTest, VerifiesMd5HashInBackground) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-exotic-int16-v143.flac"
+    );
+
+    FlacTrackDecoder decoder(file);
+    EXPECT_EQ(decoder.GetVerificationResult(), VerificationResult::NotChecked);
+
+    ASSERT_TRUE(decoder.TrySetVerificationPolicy(VerificationPolicy::Background));
+    std::shared_ptr<AudioTrackDecoder> clone = decoder.Clone();
+
+    VerificationResult result = decoder.GetVerificationResult();
+    while(result == VerificationResult::Pending) {
+      std::this_thread::yield();
+      result = decoder.GetVerificationResult();
+    }
+    EXPECT_EQ(result, VerificationResult::Passed);
+    EXPECT_EQ(clone->GetVerificationResult(), VerificationResult::Passed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackDecoderTest, ScansBlocksWithoutDecoding) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+
+    FlacTrackDecoder decoder(file);
+    std::vector<BlockContent> blocks = decoder.ScanBlocks(0, decoder.CountFrames());
+    ASSERT_EQ(blocks.size(), 11U);
+
+    std::uint64_t nextFrame = 0;
+    for(const BlockContent &block : blocks) {
+      EXPECT_EQ(block.StartFrame, nextFrame);
+      EXPECT_TRUE(block.IsKnown);
+      nextFrame += block.FrameCount;
+    }
+    EXPECT_EQ(nextFrame, decoder.CountFrames());
+
+    BlockContent block = decoder.DescribeBlock(30000);
+    EXPECT_LE(block.StartFrame, 30000U);
+    EXPECT_GT(block.StartFrame + block.FrameCount, 30000U);
+    EXPECT_THROW(decoder.DescribeBlock(decoder.CountFrames()), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Flac
 
 #endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
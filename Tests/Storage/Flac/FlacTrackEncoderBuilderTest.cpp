@@ -0,0 +1,225 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Flac/FlacTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../../../Source/Storage/Flac/FlacTrackDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that grows a memory buffer as it is written to</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a stereo test signal with the specified number of threads</summary>
+  /// <param name="samples">Interleaved stereo samples that will be encoded</param>
+  /// <param name="threadCount">Number of threads the encoder will use</param>
+  /// <returns>The file holding the encoded FLAC stream</returns>
+  std::shared_ptr<GrowingMemoryFile> encodeStereo(
+    const std::vector<std::int16_t> &samples, std::size_t threadCount
+  ) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    Nuclex::Audio::Storage::Flac::FlacTrackEncoderBuilder builder;
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(44100).
+      SetThreadCount(threadCount).
+      Build(file);
+
+    // Feed the samples in odd-sized pieces so they don't line up with any chunk
+    const std::size_t pieceFrameCount = 10007;
+    std::size_t frameCount = samples.size() / 2;
+    for(std::size_t start = 0; start < frameCount; start += pieceFrameCount) {
+      std::size_t count = std::min(pieceFrameCount, frameCount - start);
+      encoder->EncodeInterleaved(samples.data() + start * 2, count);
+    }
+    encoder->Flush();
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackEncoderBuilderTest, BuildThrowsExceptionWithoutInputChannels) {
+    std::shared_ptr<FlacTrackEncoderBuilder> builder = (
+      std::make_shared<FlacTrackEncoderBuilder>()
+    );
+
+    EXPECT_THROW(
+      builder->Build(std::shared_ptr<VirtualFile>()),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackEncoderBuilderTest, RejectsFloatingPointSampleFormat) {
+    FlacTrackEncoderBuilder builder;
+    EXPECT_THROW(builder.SetSampleFormat(AudioSampleFormat::Float_32), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackEncoderBuilderTest, ParallelEncodingRoundTripsLosslessly) {
+    std::vector<std::int16_t> samples(300000 * 2);
+    std::uint32_t noise = 12345;
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      noise = noise * 1664525U + 1013904223U;
+      samples[index] = static_cast<std::int16_t>(noise >> 20); // 12 bits of noise
+    }
+
+    std::shared_ptr<GrowingMemoryFile> serial = encodeStereo(samples, 1);
+    std::shared_ptr<GrowingMemoryFile> parallel = encodeStereo(samples, 4);
+
+    for(const std::shared_ptr<GrowingMemoryFile> &file : { serial, parallel }) {
+      std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<FlacTrackDecoder>(file);
+      ASSERT_EQ(decoder->CountChannels(), 2U);
+      ASSERT_EQ(decoder->CountFrames(), samples.size() / 2);
+
+      std::vector<std::int16_t> decoded(samples.size());
+      decoder->DecodeInterleaved(decoded.data(), 0, samples.size() / 2);
+      EXPECT_EQ(decoded, samples);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackEncoderBuilderTest, SerialEncoderCanBeReopenedOnAnotherFile) {
+    std::shared_ptr<GrowingMemoryFile> first = std::make_shared<GrowingMemoryFile>();
+    std::shared_ptr<GrowingMemoryFile> second = std::make_shared<GrowingMemoryFile>();
+
+    FlacTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(44100).
+      Build(first);
+
+    std::vector<std::int16_t> firstSamples(5000 * 2), secondSamples(3000 * 2);
+    for(std::size_t index = 0; index < firstSamples.size(); ++index) {
+      firstSamples[index] = static_cast<std::int16_t>(index * 7);
+    }
+    for(std::size_t index = 0; index < secondSamples.size(); ++index) {
+      secondSamples[index] = static_cast<std::int16_t>(index * -13);
+    }
+
+    encoder->EncodeInterleaved(firstSamples.data(), 5000);
+    encoder->Flush();
+    ASSERT_TRUE(encoder->TryReopen(second));
+    EXPECT_EQ(encoder->CountConsumedFrames(), 0U);
+    encoder->EncodeInterleaved(secondSamples.data(), 3000);
+    encoder->Flush();
+
+    // Both streams have to be complete, with the second one using the same settings
+    const std::vector<std::int16_t> *expectedSamples[] = { &firstSamples, &secondSamples };
+    const std::shared_ptr<GrowingMemoryFile> files[] = { first, second };
+    for(std::size_t index = 0; index < 2; ++index) {
+      std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<FlacTrackDecoder>(
+        files[index]
+      );
+      ASSERT_EQ(decoder->CountChannels(), 2U);
+      ASSERT_EQ(decoder->CountFrames(), expectedSamples[index]->size() / 2);
+
+      std::vector<std::int16_t> decoded(expectedSamples[index]->size());
+      decoder->DecodeInterleaved(decoded.data(), 0, decoded.size() / 2);
+      EXPECT_EQ(decoded, *expectedSamples[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlacTrackEncoderBuilderTest, ParallelEncoderRefusesToBeReopened) {
+    FlacTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(44100).
+      SetThreadCount(4).
+      Build(std::make_shared<GrowingMemoryFile>());
+
+    EXPECT_FALSE(encoder->TryReopen(std::make_shared<GrowingMemoryFile>()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
@@ -0,0 +1,126 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Flac/StrippedFlacFile.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+#include "../ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a FLAC metadata block filled with its type to a file</summary>
+  /// <param name="file">File contents the metadata block will be appended to</param>
+  /// <param name="blockType">Type of the metadata block</param>
+  /// <param name="length">Length of the metadata block's payload</param>
+  /// <param name="isLast">Whether this is the last metadata block in the file</param>
+  void appendBlock(
+    std::vector<std::byte> &file, std::uint8_t blockType, std::size_t length, bool isLast
+  ) {
+    file.push_back(std::byte(blockType | (isLast ? 0x80 : 0x00)));
+    file.push_back(std::byte(length >> 16));
+    file.push_back(std::byte(length >> 8));
+    file.push_back(std::byte(length));
+    file.insert(file.end(), length, std::byte(blockType));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a fake FLAC file with a large picture between its metadata</summary>
+  /// <param name="pictureLength">Number of bytes in the picture block</param>
+  /// <returns>The contents of the fake FLAC file</returns>
+  std::vector<std::byte> makeFlacWithPicture(std::size_t pictureLength) {
+    std::vector<std::byte> file = {
+      std::byte(0x66), std::byte(0x4c), std::byte(0x61), std::byte(0x43)
+    };
+    appendBlock(file, 0, 34, false); // STREAMINFO
+    appendBlock(file, 6, pictureLength, false); // PICTURE
+    appendBlock(file, 4, 20, true); // VORBIS_COMMENT
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      file.push_back(std::byte(0xF0 + (index & 0x0F))); // audio frames
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Flac {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StrippedFlacFileTest, SmallMetadataIsLeftAlone) {
+    std::vector<std::byte> contents = makeFlacWithPicture(1000);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    EXPECT_EQ(StrippedFlacFile::TryWrap(file), file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StrippedFlacFileTest, PicturesAreStripped) {
+    std::vector<std::byte> contents = makeFlacWithPicture(100000);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    std::shared_ptr<const VirtualFile> stripped = StrippedFlacFile::TryWrap(file);
+    ASSERT_NE(stripped, file);
+
+    // Signature, STREAMINFO and VORBIS_COMMENT blocks, then the 100 audio bytes
+    std::uint64_t expectedLength = 4 + (4 + 34) + (4 + 20) + 100;
+    ASSERT_EQ(stripped->GetSize(), expectedLength);
+
+    std::vector<std::byte> strippedContents(static_cast<std::size_t>(expectedLength));
+    stripped->ReadAt(0, strippedContents.size(), strippedContents.data());
+
+    // The comment block is now the last one, the stream info no longer claims to be
+    EXPECT_EQ(strippedContents[4], std::byte(0x00));
+    EXPECT_EQ(strippedContents[42], std::byte(0x84));
+    for(std::size_t index = 0; index < 100; ++index) {
+      EXPECT_EQ(strippedContents[66 + index], contents[contents.size() - 100 + index]);
+    }
+
+    // Reads straddling the kept metadata and the audio frames must be joined seamlessly
+    std::byte straddling[4];
+    stripped->ReadAt(64, 4, straddling);
+    EXPECT_EQ(straddling[0], std::byte(4));
+    EXPECT_EQ(straddling[2], std::byte(0xF0));
+    EXPECT_EQ(stripped->TryBorrowAt(64, 4), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Flac
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
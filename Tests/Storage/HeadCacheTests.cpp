@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HeadCacheTest, CachesBeginningOfAssets) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+    Waveform::WaveformTrackDecoder decoder(VirtualFile::OpenRealFileForReading(path));
+
+    HeadCache headCache(10);
+    EXPECT_EQ(headCache.GetHeadMilliseconds(), 10U);
+    EXPECT_FALSE(static_cast<bool>(headCache.TryGetHead(path)));
+
+    headCache.Add(path, decoder, 44100);
+    EXPECT_EQ(headCache.CountHeads(), 1U);
+
+    std::shared_ptr<const CachedHead> head = headCache.TryGetHead(path);
+    ASSERT_TRUE(static_cast<bool>(head));
+    EXPECT_EQ(head->ChannelCount, 2U);
+    EXPECT_EQ(head->TotalFrameCount, decoder.CountFrames());
+    EXPECT_EQ(head->FrameCount, 441U);
+    EXPECT_EQ(headCache.GetMemoryUsage(), 441U * 2U * sizeof(float));
+
+    std::vector<float> expected(441 * 2);
+    decoder.DecodeInterleaved(expected.data(), 0, 441);
+    EXPECT_EQ(head->Samples, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HeadCacheTest, HeadsOfShortAssetsCoverWholeAsset) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+    Waveform::WaveformTrackDecoder decoder(VirtualFile::OpenRealFileForReading(path));
+
+    HeadCache headCache(3600000);
+    headCache.Add(path, decoder, 48000);
+
+    std::shared_ptr<const CachedHead> head = headCache.TryGetHead(path);
+    ASSERT_TRUE(static_cast<bool>(head));
+    EXPECT_EQ(head->FrameCount, decoder.CountFrames());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HeadCacheTest, HeadsCanBeRemoved) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+    Waveform::WaveformTrackDecoder decoder(VirtualFile::OpenRealFileForReading(path));
+
+    HeadCache headCache;
+    headCache.Add(u8"first", decoder, 48000);
+    headCache.Add(u8"second", decoder, 48000);
+    EXPECT_EQ(headCache.CountHeads(), 2U);
+
+    // Heads that are still in use stay valid after being removed from the cache
+    std::shared_ptr<const CachedHead> head = headCache.TryGetHead(u8"first");
+    headCache.Remove(u8"first");
+    EXPECT_EQ(headCache.CountHeads(), 1U);
+    EXPECT_FALSE(static_cast<bool>(headCache.TryGetHead(u8"first")));
+    EXPECT_GT(head->Samples.size(), 0U);
+
+    headCache.Clear();
+    EXPECT_EQ(headCache.CountHeads(), 0U);
+    EXPECT_EQ(headCache.GetMemoryUsage(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
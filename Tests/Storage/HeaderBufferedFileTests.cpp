@@ -0,0 +1,128 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/HeaderBufferedFile.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that serves a pattern of bytes and counts reads</summary>
+  class CountingFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new counting file of the specified length</summary>
+    /// <param name="length">Length the file should have</param>
+    public: CountingFile(std::size_t length) :
+      contents(length),
+      ReadCount(0) {
+      for(std::size_t index = 0; index < length; ++index) {
+        this->contents[index] = static_cast<std::byte>(index * 7);
+      }
+    }
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~CountingFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      ++this->ReadCount;
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(std::uint64_t, std::size_t, const std::byte *) override {}
+
+    /// <summary>Bytes the file is serving</summary>
+    public: std::vector<std::byte> contents;
+    /// <summary>Number of reads that have been performed</summary>
+    public: mutable std::size_t ReadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HeaderBufferedFileTest, HeaderReadsAreServedFromMemory) {
+    std::shared_ptr<CountingFile> file = std::make_shared<CountingFile>(10000);
+    HeaderBufferedFile buffered(file);
+    ASSERT_EQ(file->ReadCount, 1U);
+    EXPECT_EQ(buffered.GetSize(), 10000U);
+
+    // Detection-style reads of the first few bytes shouldn't reach the file
+    std::byte header[48];
+    for(std::size_t repetition = 0; repetition < 5; ++repetition) {
+      buffered.ReadAt(0, sizeof(header), header);
+    }
+    buffered.ReadAt(HeaderBufferedFile::HeaderByteCount - 48, sizeof(header), header);
+    EXPECT_EQ(file->ReadCount, 1U);
+    EXPECT_EQ(header[0], file->contents[HeaderBufferedFile::HeaderByteCount - 48]);
+
+    // Reads leaving the header are forwarded
+    std::vector<std::byte> beyond(100);
+    buffered.ReadAt(HeaderBufferedFile::HeaderByteCount - 50, beyond.size(), beyond.data());
+    EXPECT_EQ(file->ReadCount, 2U);
+    EXPECT_EQ(beyond[99], file->contents[HeaderBufferedFile::HeaderByteCount + 49]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HeaderBufferedFileTest, HandlesFilesSmallerThanHeader) {
+    std::shared_ptr<CountingFile> file = std::make_shared<CountingFile>(20);
+    HeaderBufferedFile buffered(file);
+
+    std::byte contents[20];
+    buffered.ReadAt(0, sizeof(contents), contents);
+    EXPECT_EQ(file->ReadCount, 1U);
+    EXPECT_EQ(contents[19], file->contents[19]);
+
+    const std::byte *borrowed = buffered.TryBorrowAt(4, 16);
+    ASSERT_NE(borrowed, nullptr);
+    EXPECT_EQ(borrowed[0], file->contents[4]);
+    EXPECT_EQ(buffered.TryBorrowAt(0, 0), nullptr);
+    EXPECT_EQ(buffered.TryBorrowAt(4, 17), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,163 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/InstrumentedFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a read-only file holding the specified number of counting bytes</summary>
+  /// <param name="length">Number of bytes the file will hold</param>
+  /// <returns>A read-only file with the specified length</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> makeCountingFile(
+    std::size_t length
+  ) {
+    std::shared_ptr<std::byte[]> memory(new std::byte[length]);
+    for(std::size_t index = 0; index < length; ++index) {
+      memory[index] = static_cast<std::byte>(index);
+    }
+
+    return Nuclex::Audio::Storage::VirtualFile::FromMemory(memory, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentedFileTest, ForwardsReadsToWrappedFile) {
+    InstrumentedFile file(makeCountingFile(256));
+    EXPECT_EQ(file.GetSize(), 256U);
+
+    std::byte buffer[16];
+    file.ReadAt(100, 16, buffer);
+    for(std::size_t index = 0; index < 16; ++index) {
+      EXPECT_EQ(buffer[index], static_cast<std::byte>(100 + index));
+    }
+
+    EXPECT_THROW(file.ReadAt(250, 16, buffer), std::exception);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentedFileTest, SummarizesReads) {
+    InstrumentedFile file(makeCountingFile(1024));
+
+    std::byte buffer[64];
+    file.ReadAt(0, 64, buffer);
+    file.ReadAt(64, 32, buffer);
+    file.ReadAt(512, 16, buffer);
+
+    ReadRequest requests[2];
+    requests[0].Start = 528;
+    requests[0].ByteCount = 8;
+    requests[0].Buffer = buffer;
+    requests[1].Start = 900;
+    requests[1].ByteCount = 8;
+    requests[1].Buffer = buffer + 8;
+    file.ReadManyAt(requests, 2);
+
+    FileAccessSummary summary = file.GetSummary();
+    EXPECT_EQ(summary.ReadCount, 5U);
+    EXPECT_EQ(summary.SequentialReadCount, 3U);
+    EXPECT_EQ(summary.BatchCount, 1U);
+    EXPECT_EQ(summary.ReadByteCount, 128U);
+    EXPECT_EQ(summary.SmallestReadByteCount, 8U);
+    EXPECT_EQ(summary.LargestReadByteCount, 64U);
+    EXPECT_EQ(summary.WriteCount, 0U);
+    EXPECT_EQ(summary.ThreadCount, 1U);
+
+    // Only the totals are collected unless recording was requested
+    EXPECT_TRUE(file.GetRecords().empty());
+
+    file.Reset();
+    EXPECT_EQ(file.GetSummary().ReadCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentedFileTest, RecordsIndividualAccesses) {
+    InstrumentedFile file(makeCountingFile(1024), true);
+
+    std::byte buffer[32];
+    file.Prefetch(256, 512);
+    file.ReadAt(256, 32, buffer);
+    EXPECT_NE(file.TryBorrowAt(300, 16), nullptr);
+
+    std::vector<FileAccessRecord> records = file.GetRecords();
+    ASSERT_EQ(records.size(), 3U);
+    EXPECT_EQ(records[0].Kind, FileAccessKind::Prefetch);
+    EXPECT_EQ(records[1].Kind, FileAccessKind::Read);
+    EXPECT_EQ(records[1].Start, 256U);
+    EXPECT_EQ(records[1].ByteCount, 32U);
+    EXPECT_EQ(records[1].ThreadIndex, 0U);
+    EXPECT_EQ(records[2].Kind, FileAccessKind::Borrow);
+    EXPECT_LE(records[1].Time, records[2].Time);
+
+    std::string trace = file.DumpTrace();
+    EXPECT_EQ(trace.find(u8"kind,start,bytes,time_ns,latency_ns,thread\n"), 0U);
+    EXPECT_NE(trace.find(u8"\nprefetch,256,512,"), std::string::npos);
+    EXPECT_NE(trace.find(u8"\nread,256,32,"), std::string::npos);
+    EXPECT_NE(trace.find(u8"\nborrow,300,16,"), std::string::npos);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentedFileTest, SummarizesWrites) {
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+    std::shared_ptr<VirtualFile> writableTarget = target;
+    InstrumentedFile file(writableTarget);
+
+    std::vector<std::byte> data(100, std::byte(0x5a));
+    file.WriteAt(0, data.size(), data.data());
+    file.WriteAt(100, data.size(), data.data());
+    file.Flush();
+
+    FileAccessSummary summary = file.GetSummary();
+    EXPECT_EQ(summary.WriteCount, 2U);
+    EXPECT_EQ(summary.WrittenByteCount, 200U);
+    EXPECT_EQ(target->GetSize(), 200U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentedFileTest, ReadOnlyFilesRefuseWrites) {
+    InstrumentedFile file(makeCountingFile(16));
+
+    std::byte data[4] = {};
+    EXPECT_THROW(file.WriteAt(0, 4, data), std::runtime_error);
+    EXPECT_EQ(file.GetSummary().WriteCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,89 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LatencyHistogram.h"
+#include "../../Source/Storage/Shared/LatencyRecorder.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LatencyHistogramTest, BucketsContainTheirTimes) {
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::chrono::nanoseconds(0)), 0U);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::chrono::nanoseconds(1023)), 0U);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::chrono::nanoseconds(1024)), 1U);
+
+    for(std::int64_t time = 1; time < 50'000'000'000; time = time * 3 / 2 + 1) {
+      std::size_t index = LatencyHistogram::GetBucketIndex(std::chrono::nanoseconds(time));
+      ASSERT_LT(index, LatencyHistogram::BucketCount);
+      EXPECT_LT(time, LatencyHistogram::GetBucketUpperBound(index).count());
+      if(index > 0) {
+        EXPECT_GE(time, LatencyHistogram::GetBucketUpperBound(index - 1).count());
+      }
+    }
+
+    EXPECT_EQ(
+      LatencyHistogram::GetBucketIndex(std::chrono::hours(1)), LatencyHistogram::BucketCount - 1
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LatencyHistogramTest, PercentilesAreBoundedByBuckets) {
+    Shared::LatencyRecorder recorder;
+    for(std::size_t index = 0; index < 99; ++index) {
+      recorder.Record(std::chrono::microseconds(10));
+    }
+    recorder.Record(std::chrono::milliseconds(5));
+
+    LatencyHistogram histogram = recorder.TakeSnapshot();
+    EXPECT_EQ(histogram.CallCount, 100U);
+    EXPECT_EQ(histogram.LongestTime, std::chrono::milliseconds(5));
+    EXPECT_EQ(histogram.TotalTime, std::chrono::microseconds(99 * 10 + 5000));
+
+    // Buckets are at most 12.5% wider than the times they hold
+    std::chrono::nanoseconds median = histogram.GetPercentile(0.5);
+    EXPECT_GT(median, std::chrono::microseconds(10));
+    EXPECT_LE(median, std::chrono::nanoseconds(11250));
+    EXPECT_EQ(histogram.GetPercentile(0.99), median);
+    EXPECT_EQ(histogram.GetPercentile(1.0), std::chrono::milliseconds(5));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LatencyHistogramTest, SnapshotCanResetRecorder) {
+    Shared::LatencyRecorder recorder;
+    EXPECT_EQ(recorder.TakeSnapshot().GetPercentile(0.5).count(), 0);
+
+    recorder.Record(std::chrono::microseconds(100));
+    EXPECT_EQ(recorder.TakeSnapshot(true).CallCount, 1U);
+
+    LatencyHistogram histogram = recorder.TakeSnapshot();
+    EXPECT_EQ(histogram.CallCount, 0U);
+    EXPECT_TRUE(histogram.BucketCounts.empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
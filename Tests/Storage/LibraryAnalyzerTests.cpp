@@ -0,0 +1,147 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LibraryAnalyzer.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Processing/ContentHasher.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::max()
+#include <cmath> // for std::fabs()
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LibraryAnalyzerTest, SplitRangesMergeIntoWholeFileResults) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    // Work out the expected peak by decoding the file directly
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(path);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::vector<float> samples(frameCount * decoder->CountChannels());
+    decoder->DecodeInterleaved(samples.data(), 0, frameCount);
+    float expectedPeak = 0.0f;
+    for(float sample : samples) {
+      expectedPeak = std::max(expectedPeak, std::fabs(sample));
+    }
+
+    LibraryAnalyzer analyzer(4, 16384);
+    analyzer.AddStage(std::make_shared<PeakAnalysisStage>());
+    analyzer.AddStage(std::make_shared<ClippingAnalysisStage>(expectedPeak));
+    analyzer.AddFile(path);
+    analyzer.AddFile(GetResourcesDirectory() + u8"waveform-5dot1-int16le-pcmwaveformat.wav");
+
+    LibraryAnalysis analysis = analyzer.Run();
+    ASSERT_EQ(analysis.Files.size(), 2U);
+    EXPECT_EQ(analysis.FailedFileCount, 0U);
+    EXPECT_EQ(analyzer.CountFiles(), 0U);
+
+    const FileAnalysis &file = analysis.Files[0];
+    ASSERT_FALSE(static_cast<bool>(file.Error));
+    EXPECT_EQ(file.FrameCount, frameCount);
+    EXPECT_GT(file.RangeCount, 1U);
+    ASSERT_EQ(file.Stages.size(), 2U);
+
+    const PeakAnalysisStage &peaks = static_cast<const PeakAnalysisStage &>(*file.Stages[0]);
+    EXPECT_EQ(peaks.GetPeak(), expectedPeak);
+
+    const ClippingAnalysisStage &clipping = (
+      static_cast<const ClippingAnalysisStage &>(*file.Stages[1])
+    );
+    EXPECT_GE(clipping.CountClippedSamples(), 1U);
+
+    EXPECT_GE(analysis.RangeCount, 3U);
+    EXPECT_GT(analysis.AnalyzedSeconds, 0.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LibraryAnalyzerTest, ContentHashOfSplitRangesMatchesWholeTrack) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    AudioLoader loader;
+    Processing::ContentHash expectedHash = (
+      Processing::ContentHasher::HashTrack(*loader.OpenDecoder(path))
+    );
+
+    LibraryAnalyzer analyzer(4, 16384);
+    analyzer.AddStage(std::make_shared<ContentHashAnalysisStage>(4096));
+    analyzer.AddFile(path);
+
+    LibraryAnalysis analysis = analyzer.Run();
+    ASSERT_EQ(analysis.Files.size(), 1U);
+    ASSERT_FALSE(static_cast<bool>(analysis.Files[0].Error));
+    EXPECT_GT(analysis.Files[0].RangeCount, 1U);
+
+    const ContentHashAnalysisStage &hash = (
+      static_cast<const ContentHashAnalysisStage &>(*analysis.Files[0].Stages[0])
+    );
+    EXPECT_TRUE(hash.GetHash() == expectedHash);
+    EXPECT_EQ(
+      hash.CountBlocks(), static_cast<std::size_t>((analysis.Files[0].FrameCount + 4095) / 4096)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LibraryAnalyzerTest, WholeTrackStagesPreventSplitting) {
+    LibraryAnalyzer analyzer(2, 16384);
+    analyzer.AddStage(std::make_shared<LoudnessAnalysisStage>());
+    analyzer.AddFile(GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav");
+
+    LibraryAnalysis analysis = analyzer.Run();
+    ASSERT_EQ(analysis.Files.size(), 1U);
+    ASSERT_FALSE(static_cast<bool>(analysis.Files[0].Error));
+    EXPECT_EQ(analysis.Files[0].RangeCount, 1U);
+
+    const LoudnessAnalysisStage &loudness = (
+      static_cast<const LoudnessAnalysisStage &>(*analysis.Files[0].Stages[0])
+    );
+    EXPECT_LT(loudness.GetIntegratedLoudness(), 0.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LibraryAnalyzerTest, FailingFilesDontStopThePass) {
+    LibraryAnalyzer analyzer;
+    analyzer.AddStage(std::make_shared<PeakAnalysisStage>());
+    analyzer.AddFile(GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin");
+    analyzer.AddFile(GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav");
+
+    LibraryAnalysis analysis = analyzer.Run();
+    ASSERT_EQ(analysis.Files.size(), 2U);
+    EXPECT_EQ(analysis.FailedFileCount, 1U);
+    EXPECT_TRUE(static_cast<bool>(analysis.Files[0].Error));
+    EXPECT_FALSE(static_cast<bool>(analysis.Files[1].Error));
+    EXPECT_EQ(analysis.Files[1].Stages.size(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,149 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/LoopingTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a decoder for the stereo float test file</summary>
+  /// <returns>A decoder for the stereo float test file</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> openStereoDecoder() {
+    using Nuclex::Audio::Storage::VirtualFile;
+    return std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackDecoder>(
+      VirtualFile::OpenRealFileForReading(
+        Nuclex::Audio::GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unrolls a loop by copying frames of an interleaved track</summary>
+  /// <param name="samples">Interleaved samples of the whole track</param>
+  /// <param name="channelCount">Number of channels interleaved in the track</param>
+  /// <param name="loop">Loop region that will be unrolled</param>
+  /// <returns>The interleaved samples of the unrolled track</returns>
+  std::vector<float> unroll(
+    const std::vector<float> &samples, std::size_t channelCount,
+    const Nuclex::Audio::LoopRegion &loop
+  ) {
+    std::vector<float> unrolled(
+      samples.begin(), samples.begin() + loop.EndFrame * channelCount
+    );
+    for(std::size_t pass = 1; pass < loop.PlayCount; ++pass) {
+      unrolled.insert(
+        unrolled.end(),
+        samples.begin() + loop.StartFrame * channelCount,
+        samples.begin() + loop.EndFrame * channelCount
+      );
+    }
+    unrolled.insert(unrolled.end(), samples.begin() + loop.EndFrame * channelCount, samples.end());
+    return unrolled;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopingTrackDecoderTest, RejectsLoopsOutsideOfTheTrack) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openStereoDecoder();
+
+    LoopRegion emptyLoop { 1000, 1000, 0 };
+    EXPECT_THROW(LoopingTrackDecoder looping(decoder, emptyLoop), std::invalid_argument);
+
+    LoopRegion overlongLoop { 1000, decoder->CountFrames() + 1, 0 };
+    EXPECT_THROW(LoopingTrackDecoder looping(decoder, overlongLoop), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopingTrackDecoderTest, UnrollsFiniteLoops) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openStereoDecoder();
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+
+    std::vector<float> samples(frameCount * 2);
+    decoder->DecodeInterleaved<float>(samples.data(), 0, frameCount);
+
+    LoopRegion loop { 1000, 3000, 3 };
+    std::shared_ptr<AudioTrackDecoder> looping = AudioTrackDecoder::CreateLooping(decoder, loop);
+    ASSERT_EQ(looping->CountFrames(), frameCount + 4000U);
+
+    // Decode in odd chunks so that several of them straddle the loop boundaries
+    std::vector<float> decoded(static_cast<std::size_t>(looping->CountFrames()) * 2);
+    std::size_t decodedFrameCount = 0;
+    while(decodedFrameCount < looping->CountFrames()) {
+      std::size_t chunkFrameCount = std::min<std::size_t>(
+        777, static_cast<std::size_t>(looping->CountFrames()) - decodedFrameCount
+      );
+      looping->DecodeInterleaved<float>(
+        decoded.data() + decodedFrameCount * 2, decodedFrameCount, chunkFrameCount
+      );
+      decodedFrameCount += chunkFrameCount;
+    }
+
+    EXPECT_EQ(decoded, unroll(samples, 2, loop));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopingTrackDecoderTest, EndlessLoopsWrapInSeparatedDecoding) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openStereoDecoder();
+
+    LoopRegion loop { 100, 600, 0 };
+    LoopingTrackDecoder looping(decoder, loop);
+    EXPECT_EQ(looping.CountFrames(), std::numeric_limits<std::uint64_t>::max());
+
+    // Ten passes in, read across the wrap from the loop's end back to its start
+    std::uint64_t startFrame = 600 + 500 * 10 - 200;
+    std::vector<float> left(400), right(400);
+    float *buffers[] = { left.data(), right.data() };
+    looping.DecodeSeparated<float>(buffers, startFrame, 400);
+
+    std::vector<float> expectedLeft(400), expectedRight(400);
+    float *expectedBuffers[] = { expectedLeft.data(), expectedRight.data() };
+    decoder->DecodeSeparated<float>(expectedBuffers, 400, 200);
+    float *wrappedBuffers[] = { expectedLeft.data() + 200, expectedRight.data() + 200 };
+    decoder->DecodeSeparated<float>(wrappedBuffers, 100, 200);
+
+    EXPECT_EQ(left, expectedLeft);
+    EXPECT_EQ(right, expectedRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
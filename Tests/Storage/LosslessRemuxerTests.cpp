@@ -0,0 +1,177 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LosslessRemuxer.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "../../Source/Storage/Flac/FlacTrackDecoder.h"
+#include "../../Source/Storage/WavPack/WavPackTrackDecoder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC) || defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a range of frames as interleaved, left-aligned integers</summary>
+  /// <param name="decoder">Decoder that will deliver the samples</param>
+  /// <param name="startFrame">Index of the first frame that will be decoded</param>
+  /// <param name="frameCount">Number of frames that will be decoded</param>
+  /// <returns>The decoded samples</returns>
+  std::vector<std::int32_t> decodeFrames(
+    const Nuclex::Audio::Storage::AudioTrackDecoder &decoder,
+    std::uint64_t startFrame, std::size_t frameCount
+  ) {
+    std::vector<std::int32_t> samples(frameCount * decoder.CountChannels());
+    decoder.DecodeInterleaved<std::int32_t>(samples.data(), startFrame, frameCount);
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC) || defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessRemuxerTest, RejectsUnsupportedFormats) {
+    std::shared_ptr<WritableMemoryFile> source = std::make_shared<WritableMemoryFile>();
+    std::vector<std::byte> garbage(256, std::byte(0x55));
+    source->WriteAt(0, garbage.size(), garbage.data());
+
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+    EXPECT_THROW(
+      LosslessRemuxer::Trim(source, 0, 100, target), Errors::UnsupportedFormatError
+    );
+    EXPECT_THROW(
+      LosslessRemuxer::Concatenate({ source, source }, target), Errors::UnsupportedFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+  TEST(LosslessRemuxerTest, TrimmedFlacContainsExactSamples) {
+    std::shared_ptr<const VirtualFile> source = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    // Starts and ends in the middle of a frame, so both edges need to be encoded again
+    std::uint64_t writtenFrameCount = LosslessRemuxer::Trim(source, 1000, 30000, target);
+    ASSERT_EQ(writtenFrameCount, 30000U);
+
+    Flac::FlacTrackDecoder sourceDecoder(source);
+    Flac::FlacTrackDecoder clipDecoder(target);
+    ASSERT_EQ(clipDecoder.CountFrames(), 30000U);
+    EXPECT_EQ(decodeFrames(clipDecoder, 0, 30000), decodeFrames(sourceDecoder, 1000, 30000));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessRemuxerTest, TrimmingFlacToEndOfStreamStopsAtEnd) {
+    std::shared_ptr<const VirtualFile> source = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    std::uint64_t writtenFrameCount = LosslessRemuxer::Trim(source, 4096, 100000, target);
+    ASSERT_EQ(writtenFrameCount, 40004U);
+
+    Flac::FlacTrackDecoder sourceDecoder(source);
+    Flac::FlacTrackDecoder clipDecoder(target);
+    ASSERT_EQ(clipDecoder.CountFrames(), 40004U);
+    EXPECT_EQ(decodeFrames(clipDecoder, 0, 40004), decodeFrames(sourceDecoder, 4096, 40004));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessRemuxerTest, JoinedFlacContainsAllSources) {
+    std::shared_ptr<const VirtualFile> source = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"flac-stereo-int16-v143.flac"
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    LosslessRemuxer::Concatenate({ source, source }, target);
+
+    Flac::FlacTrackDecoder sourceDecoder(source);
+    Flac::FlacTrackDecoder joinedDecoder(target);
+    ASSERT_EQ(joinedDecoder.CountFrames(), 88200U);
+    EXPECT_EQ(decodeFrames(joinedDecoder, 44100, 44100), decodeFrames(sourceDecoder, 0, 44100));
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_FLAC)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+  TEST(LosslessRemuxerTest, TrimmedWavPackContainsExactSamples) {
+    std::shared_ptr<const VirtualFile> source = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"wavpack-5dot1-int16-v416.wv"
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    std::uint64_t writtenFrameCount = LosslessRemuxer::Trim(source, 1000, 30000, target);
+    ASSERT_EQ(writtenFrameCount, 30000U);
+
+    WavPack::WavPackTrackDecoder sourceDecoder(source);
+    WavPack::WavPackTrackDecoder clipDecoder(target);
+    ASSERT_EQ(clipDecoder.CountChannels(), sourceDecoder.CountChannels());
+    ASSERT_EQ(clipDecoder.CountFrames(), 30000U);
+    EXPECT_EQ(decodeFrames(clipDecoder, 0, 30000), decodeFrames(sourceDecoder, 1000, 30000));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessRemuxerTest, JoinedWavPackContainsAllSources) {
+    std::shared_ptr<const VirtualFile> source = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"wavpack-stereo-int16-v416.wv"
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    LosslessRemuxer::Concatenate({ source, source }, target);
+
+    WavPack::WavPackTrackDecoder sourceDecoder(source);
+    WavPack::WavPackTrackDecoder joinedDecoder(target);
+    ASSERT_EQ(joinedDecoder.CountFrames(), 88200U);
+    EXPECT_EQ(decodeFrames(joinedDecoder, 44100, 44100), decodeFrames(sourceDecoder, 0, 44100));
+  }
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
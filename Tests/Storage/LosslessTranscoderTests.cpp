@@ -0,0 +1,196 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/LosslessTranscoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that keeps its contents in memory and grows when written</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Waveform encoder builder that pretends to only support 16-bit integers</summary>
+  class SixteenBitOnlyBuilder :
+    public Nuclex::Audio::Storage::Waveform::WaveformTrackEncoderBuilder {
+
+    /// <summary>Retrieves a list of supported formats for the encoded samples</summary>
+    /// <returns>All supported formats in which samples can be stored</returns>
+    public: const std::vector<
+      Nuclex::Audio::AudioSampleFormat
+    > &GetSupportedSampleFormats() const override {
+      static const std::vector<Nuclex::Audio::AudioSampleFormat> supportedFormats = {
+        Nuclex::Audio::AudioSampleFormat::SignedInteger_16
+      };
+      return supportedFormats;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a test resource file for reading</summary>
+  /// <param name="name">Name of the resource file</param>
+  /// <returns>The test resource file</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> openResource(const char *name) {
+    return Nuclex::Audio::Storage::VirtualFile::OpenRealFileForReading(
+      Nuclex::Audio::GetResourcesDirectory() + name
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessTranscoderTest, NegotiatesSmallestExactFormat) {
+    Waveform::WaveformTrackEncoderBuilder builder;
+
+    Waveform::WaveformTrackDecoder integerDecoder(
+      openResource(u8"waveform-stereo-int24le-pcmwaveformat.wav")
+    );
+    EXPECT_EQ(
+      LosslessTranscoder::NegotiateSampleFormat(integerDecoder, builder),
+      AudioSampleFormat::SignedInteger_24
+    );
+
+    Waveform::WaveformTrackDecoder floatDecoder(
+      openResource(u8"waveform-stereo-float64le-pcmwaveformat.wav")
+    );
+    EXPECT_EQ(
+      LosslessTranscoder::NegotiateSampleFormat(floatDecoder, builder),
+      AudioSampleFormat::Float_64
+    );
+
+    Waveform::WaveformTrackDecoder byteDecoder(
+      openResource(u8"waveform-mono-uint8-pcmwaveformat.wav")
+    );
+    SixteenBitOnlyBuilder sixteenBitBuilder;
+    EXPECT_EQ(
+      LosslessTranscoder::NegotiateSampleFormat(byteDecoder, sixteenBitBuilder),
+      AudioSampleFormat::SignedInteger_16
+    );
+    EXPECT_EQ(
+      LosslessTranscoder::NegotiateSampleFormat(integerDecoder, sixteenBitBuilder),
+      AudioSampleFormat::Unknown
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessTranscoderTest, RefusesToNarrowSamples) {
+    Waveform::WaveformTrackDecoder decoder(
+      openResource(u8"waveform-stereo-int24le-pcmwaveformat.wav")
+    );
+
+    SixteenBitOnlyBuilder builder;
+    builder.SetSampleRate(44100);
+    EXPECT_THROW(
+      LosslessTranscoder::Transcode(decoder, builder, std::make_shared<GrowingMemoryFile>()),
+      Errors::UnsupportedFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LosslessTranscoderTest, TranscodesIntegerSamplesBitExact) {
+    Waveform::WaveformTrackDecoder source(
+      openResource(u8"waveform-stereo-int24le-pcmwaveformat.wav")
+    );
+    std::shared_ptr<GrowingMemoryFile> target = std::make_shared<GrowingMemoryFile>();
+
+    Waveform::WaveformTrackEncoderBuilder builder;
+    builder.SetSampleRate(44100);
+    std::uint64_t frameCount = LosslessTranscoder::Transcode(source, builder, target);
+    ASSERT_EQ(frameCount, source.CountFrames());
+
+    Waveform::WaveformTrackDecoder result(target);
+    ASSERT_EQ(result.CountFrames(), frameCount);
+    EXPECT_EQ(result.GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_24);
+
+    std::size_t sampleCount = static_cast<std::size_t>(frameCount) * source.CountChannels();
+    std::vector<std::int32_t> expected(sampleCount), actual(sampleCount);
+    source.DecodeInterleaved(expected.data(), 0, static_cast<std::size_t>(frameCount));
+    result.DecodeInterleaved(actual.data(), 0, static_cast<std::size_t>(frameCount));
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
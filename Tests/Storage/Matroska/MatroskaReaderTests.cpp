@@ -0,0 +1,398 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Matroska/MatroskaReader.h"
+#include "../../../Source/Storage/Matroska/MatroskaPacketSource.h"
+#include "../../../Source/Storage/Matroska/MatroskaDetection.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "../ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef> // for std::byte
+#include <cstring> // for std::memcpy()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Byte buffer holding an EBML document or a part of one</summary>
+  typedef std::vector<std::byte> Bytes;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an EBML element with the specified id and contents</summary>
+  /// <param name="id">Id of the element, including its length marker</param>
+  /// <param name="payload">Contents of the element</param>
+  /// <returns>The element with its header</returns>
+  /// <remarks>
+  ///   Sizes are always written as 8 byte variable integers, so the length of
+  ///   an element only depends on the length of its contents.
+  /// </remarks>
+  Bytes element(std::uint32_t id, const Bytes &payload) {
+    Bytes result;
+    for(int shift = 24; shift >= 0; shift -= 8) {
+      std::uint8_t idByte = static_cast<std::uint8_t>(id >> shift);
+      if((idByte != 0) || !result.empty()) {
+        result.push_back(std::byte(idByte));
+      }
+    }
+
+    result.push_back(std::byte(0x01));
+    for(int shift = 48; shift >= 0; shift -= 8) {
+      result.push_back(std::byte(static_cast<std::uint8_t>(payload.size() >> shift)));
+    }
+
+    result.insert(result.end(), payload.begin(), payload.end());
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes an unsigned integer as 8 big endian bytes</summary>
+  /// <param name="value">Value that will be encoded</param>
+  /// <returns>The encoded value</returns>
+  Bytes unsignedInteger(std::uint64_t value) {
+    Bytes result;
+    for(int shift = 56; shift >= 0; shift -= 8) {
+      result.push_back(std::byte(static_cast<std::uint8_t>(value >> shift)));
+    }
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a double precision float as 8 big endian bytes</summary>
+  /// <param name="value">Value that will be encoded</param>
+  /// <returns>The encoded value</returns>
+  Bytes floatingPoint(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return unsignedInteger(bits);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a string without terminator</summary>
+  /// <param name="text">String that will be encoded</param>
+  /// <returns>The encoded string</returns>
+  Bytes text(const std::string &text) {
+    Bytes result;
+    for(char character : text) {
+      result.push_back(std::byte(static_cast<std::uint8_t>(character)));
+    }
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Concatenates several byte buffers</summary>
+  /// <param name="parts">Byte buffers that will be concatenated</param>
+  /// <returns>A single buffer holding all parts in order</returns>
+  Bytes join(std::initializer_list<Bytes> parts) {
+    Bytes result;
+    for(const Bytes &part : parts) {
+      result.insert(result.end(), part.begin(), part.end());
+    }
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a SimpleBlock element</summary>
+  /// <param name="trackNumber">Number of the track the block belongs to, below 127</param>
+  /// <param name="relativeTimestamp">Timestamp relative to the cluster</param>
+  /// <param name="flags">Flags byte of the block, including the lacing bits</param>
+  /// <param name="data">Block data following the header</param>
+  /// <returns>The SimpleBlock element</returns>
+  Bytes simpleBlock(
+    std::uint8_t trackNumber, std::int16_t relativeTimestamp, std::uint8_t flags,
+    const Bytes &data
+  ) {
+    Bytes header = {
+      std::byte(0x80 | trackNumber),
+      std::byte(static_cast<std::uint8_t>(static_cast<std::uint16_t>(relativeTimestamp) >> 8)),
+      std::byte(static_cast<std::uint8_t>(relativeTimestamp)),
+      std::byte(flags)
+    };
+    return element(0xA3, join({ header, data }));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a Matroska file with an audio and a video track in two clusters</summary>
+  /// <param name="includeTracks">Whether the track list should be written</param>
+  /// <returns>The complete Matroska file</returns>
+  /// <remarks>
+  ///   The cues are placed behind the clusters like muxers usually do it, so they can
+  ///   only be found through the seek head.
+  /// </remarks>
+  Bytes buildMatroskaFile(bool includeTracks = true) {
+    Bytes ebmlHeader = element(0x1A45DFA3, element(0x4282, text(u8"webm")));
+
+    Bytes info = element(
+      0x1549A966, join({
+        element(0x2AD7B1, unsignedInteger(1000000)),
+        element(0x4489, floatingPoint(100.0))
+      })
+    );
+    Bytes tracks = element(
+      0x1654AE6B, join({
+        element(
+          0xAE, join({
+            element(0xD7, unsignedInteger(1)),
+            element(0x83, unsignedInteger(2)),
+            element(0x86, text(u8"A_OPUS")),
+            element(0x63A2, text(u8"OpusHead")),
+            element(0x56AA, unsignedInteger(6500000)),
+            element(0x536E, text(u8"Commentary")),
+            element(
+              0xE1, join({
+                element(0xB5, floatingPoint(48000.0)),
+                element(0x9F, unsignedInteger(2))
+              })
+            )
+          })
+        ),
+        element(
+          0xAE, join({
+            element(0xD7, unsignedInteger(2)),
+            element(0x83, unsignedInteger(1)),
+            element(0x86, text(u8"V_VP9"))
+          })
+        )
+      })
+    );
+
+    Bytes firstCluster = element(
+      0x1F43B675, join({
+        element(0xE7, unsignedInteger(0)),
+        simpleBlock(1, 0, 0x80, text(u8"A0")),
+        simpleBlock(2, 0, 0x80, text(u8"VIDEO")),
+        simpleBlock(1, 20, 0x80, text(u8"A1"))
+      })
+    );
+
+    // Three Xiph-laced frames of 2, 3 and 4 bytes, the last size being implied
+    Bytes lacedFrames = join({
+      Bytes { std::byte(2), std::byte(2), std::byte(3) },
+      text(u8"B0"), text(u8"B1x"), text(u8"B2yy")
+    });
+    Bytes secondCluster = element(
+      0x1F43B675, join({
+        element(0xE7, unsignedInteger(40)),
+        simpleBlock(2, 0, 0x80, text(u8"VIDEO")),
+        simpleBlock(1, 0, 0x82, lacedFrames),
+        simpleBlock(2, 5, 0x00, text(u8"VIDEO"))
+      })
+    );
+
+    // The seek head has a fixed length, so it can be built once to measure it
+    // and again once the position of the cues is known
+    auto buildSeekHead = [](std::uint64_t cuesPosition) {
+      return element(
+        0x114D9B74, element(
+          0x4DBB, join({
+            element(0x53AB, Bytes { std::byte(0x1C), std::byte(0x53), std::byte(0xBB), std::byte(0x6B) }),
+            element(0x53AC, unsignedInteger(cuesPosition))
+          })
+        )
+      );
+    };
+
+    std::uint64_t firstClusterPosition = (
+      buildSeekHead(0).size() + info.size() + (includeTracks ? tracks.size() : 0)
+    );
+    std::uint64_t secondClusterPosition = firstClusterPosition + firstCluster.size();
+    std::uint64_t cuesPosition = secondClusterPosition + secondCluster.size();
+
+    Bytes cues = element(
+      0x1C53BB6B, join({
+        element(
+          0xBB, join({
+            element(0xB3, unsignedInteger(0)),
+            element(
+              0xB7, join({
+                element(0xF7, unsignedInteger(2)),
+                element(0xF1, unsignedInteger(firstClusterPosition))
+              })
+            )
+          })
+        ),
+        element(
+          0xBB, join({
+            element(0xB3, unsignedInteger(40)),
+            element(
+              0xB7, join({
+                element(0xF7, unsignedInteger(2)),
+                element(0xF1, unsignedInteger(secondClusterPosition))
+              })
+            )
+          })
+        )
+      })
+    );
+
+    Bytes segmentData = join({
+      buildSeekHead(cuesPosition), info, (includeTracks ? tracks : Bytes()),
+      firstCluster, secondCluster, cues
+    });
+    return join({ ebmlHeader, element(0x18538067, segmentData) });
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a packet's contents into a string for easy comparison</summary>
+  /// <param name="packet">Packet that will be converted</param>
+  /// <returns>A string holding the packet's contents</returns>
+  std::string toString(const std::vector<std::byte> &packet) {
+    return std::string(reinterpret_cast<const char *>(packet.data()), packet.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Matroska {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaReaderTest, DetectsMatroskaHeader) {
+    Bytes matroskaFile = buildMatroskaFile();
+    EXPECT_TRUE(Detection::CheckIfMatroskaHeaderPresent(matroskaFile.data(), matroskaFile.size()));
+
+    Bytes otherFile = element(0x1A45DFA3, element(0x4282, text(u8"notmkv")));
+    EXPECT_FALSE(Detection::CheckIfMatroskaHeaderPresent(otherFile.data(), otherFile.size()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaReaderTest, ReadsAudioTracksOnly) {
+    Bytes matroskaFile = buildMatroskaFile();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      matroskaFile.data(), matroskaFile.size()
+    );
+
+    std::shared_ptr<const MatroskaSegment> segment = MatroskaReader::ReadSegment(file);
+    EXPECT_EQ(segment->TimestampScale, 1000000U);
+    ASSERT_TRUE(segment->Duration.has_value());
+    EXPECT_EQ(segment->Duration.value(), 100000000);
+
+    ASSERT_EQ(segment->AudioTracks.size(), 1U);
+    const MatroskaTrack &track = segment->AudioTracks[0];
+    EXPECT_EQ(track.Number, 1U);
+    EXPECT_EQ(track.CodecId, u8"A_OPUS");
+    EXPECT_EQ(track.CodecPrivate.size(), 8U);
+    EXPECT_EQ(track.CodecDelay, 6500000U);
+    EXPECT_EQ(track.ChannelCount, 2U);
+    EXPECT_EQ(track.SamplingFrequency, 48000.0);
+    ASSERT_TRUE(track.Name.has_value());
+    EXPECT_EQ(track.Name.value(), u8"Commentary");
+    EXPECT_TRUE(track.IsDefault);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaReaderTest, FindsCuesThroughSeekHead) {
+    Bytes matroskaFile = buildMatroskaFile();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      matroskaFile.data(), matroskaFile.size()
+    );
+
+    std::shared_ptr<const MatroskaSegment> segment = MatroskaReader::ReadSegment(file);
+    ASSERT_EQ(segment->CuePoints.size(), 2U);
+    EXPECT_EQ(segment->CuePoints[0].Timestamp, 0);
+    EXPECT_EQ(segment->CuePoints[0].ClusterOffset, segment->FirstClusterOffset);
+    EXPECT_EQ(segment->CuePoints[1].Timestamp, 40000000);
+    EXPECT_GT(segment->CuePoints[1].ClusterOffset, segment->FirstClusterOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaReaderTest, SegmentWithoutTracksIsRejected) {
+    Bytes matroskaFile = buildMatroskaFile(false);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      matroskaFile.data(), matroskaFile.size()
+    );
+
+    EXPECT_THROW(MatroskaReader::ReadSegment(file), Errors::CorruptedFileError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaPacketSourceTest, DeliversOnlyPacketsOfSelectedTrack) {
+    Bytes matroskaFile = buildMatroskaFile();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      matroskaFile.data(), matroskaFile.size()
+    );
+
+    MatroskaPacketSource source(file, MatroskaReader::ReadSegment(file), 1);
+
+    std::vector<std::byte> packet;
+    std::int64_t timestamp;
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"A0");
+    EXPECT_EQ(timestamp, 0);
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"A1");
+    EXPECT_EQ(timestamp, 20000000);
+
+    // The laced block in the second cluster is split into its three frames
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"B0");
+    EXPECT_EQ(timestamp, 40000000);
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"B1x");
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"B2yy");
+
+    EXPECT_FALSE(source.ReadPacket(packet, timestamp));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MatroskaPacketSourceTest, SeeksToClusterThroughCues) {
+    Bytes matroskaFile = buildMatroskaFile();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      matroskaFile.data(), matroskaFile.size()
+    );
+
+    MatroskaPacketSource source(file, MatroskaReader::ReadSegment(file), 1);
+
+    EXPECT_EQ(source.Seek(45000000), 40000000);
+
+    std::vector<std::byte> packet;
+    std::int64_t timestamp;
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"B0");
+    EXPECT_EQ(timestamp, 40000000);
+
+    EXPECT_EQ(source.Seek(10000000), 0);
+    ASSERT_TRUE(source.ReadPacket(packet, timestamp));
+    EXPECT_EQ(toString(packet), u8"A0");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Matroska
@@ -0,0 +1,306 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/OggRemuxer.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+
+#include "../../Source/Storage/Shared/OggPacketReader.h"
+#include "../../Source/Storage/Shared/OggPageWriter.h"
+#include "../../Source/Storage/Shared/OggPageVerifier.h"
+#include "../../Source/Storage/Shared/OggLinkScanner.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a fake Ogg Opus stream with numbered 20 ms packets</summary>
+  /// <param name="packetCount">Number of audio packets the stream will contain</param>
+  /// <param name="endTrim">Number of samples the final page trims off the end</param>
+  /// <returns>A memory file holding the fake Ogg Opus stream</returns>
+  /// <remarks>
+  ///   Each packet carries a CELT-only 20 ms TOC byte followed by its index, so tests
+  ///   can tell which packets ended up in the output.
+  /// </remarks>
+  std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> makeOpusStream(
+    std::size_t packetCount, std::int64_t endTrim = 0
+  ) {
+    using Nuclex::Audio::Storage::Shared::OggPageWriter;
+
+    std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file = (
+      std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>()
+    );
+    OggPageWriter writer(*file, 0, 1234);
+
+    std::vector<std::byte> head(19, std::byte(0));
+    const char magic[] = "OpusHead";
+    for(std::size_t index = 0; index < 8; ++index) {
+      head[index] = static_cast<std::byte>(magic[index]);
+    }
+    head[8] = std::byte(1); // version
+    head[9] = std::byte(1); // channel count
+    head[10] = std::byte(312 & 0xFF); // pre-skip
+    head[11] = std::byte(312 >> 8);
+    head[12] = std::byte(0x80); // 48000 Hz
+    head[13] = std::byte(0xBB);
+    writer.WritePacket(head.data(), head.size(), 0);
+    writer.FlushPage();
+
+    std::vector<std::byte> tags(16, std::byte(0));
+    const char tagMagic[] = "OpusTags";
+    for(std::size_t index = 0; index < 8; ++index) {
+      tags[index] = static_cast<std::byte>(tagMagic[index]);
+    }
+    writer.WritePacket(tags.data(), tags.size(), 0);
+    writer.FlushPage();
+
+    for(std::size_t index = 0; index < packetCount; ++index) {
+      std::vector<std::byte> packet(40, std::byte(0));
+      packet[0] = std::byte(31 << 3); // CELT-only fullband, 20 ms, one frame
+      packet[1] = static_cast<std::byte>(index);
+
+      bool isLast = (index + 1 == packetCount);
+      std::int64_t granulePosition = static_cast<std::int64_t>(index + 1) * 960;
+      if(isLast) {
+        granulePosition -= endTrim;
+      }
+      writer.WritePacket(packet.data(), packet.size(), granulePosition, isLast);
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a fake Ogg Vorbis stream with numbered packets</summary>
+  /// <param name="packetCount">Number of audio packets the stream will contain</param>
+  /// <returns>A memory file holding the fake Ogg Vorbis stream</returns>
+  /// <remarks>
+  ///   The stream has a short block size of 256 and a long block size of 2048 with two
+  ///   modes, the second of which uses long blocks. All audio packets use the long
+  ///   block mode, so each packet after the first decodes to 1024 samples.
+  /// </remarks>
+  std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> makeVorbisStream(
+    std::size_t packetCount
+  ) {
+    using Nuclex::Audio::Storage::Shared::OggPageWriter;
+
+    std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file = (
+      std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>()
+    );
+    OggPageWriter writer(*file, 0, 5678);
+
+    std::vector<std::byte> identification(30, std::byte(0));
+    const char magic[] = "\x01vorbis";
+    for(std::size_t index = 0; index < 7; ++index) {
+      identification[index] = static_cast<std::byte>(magic[index]);
+    }
+    identification[11] = std::byte(2); // channel count
+    identification[28] = std::byte(0xB8); // block sizes 2^8 and 2^11
+    identification[29] = std::byte(1); // framing bit
+    writer.WritePacket(identification.data(), identification.size(), 0);
+    writer.FlushPage();
+
+    std::vector<std::byte> comment = { std::byte(3), std::byte('v'), std::byte(1) };
+    writer.WritePacket(comment.data(), comment.size(), 0);
+
+    // Setup header: some filler standing in for codebooks, floors, residues and
+    // mappings, then the mode count and two modes, then the framing bit
+    std::vector<bool> bits;
+    for(std::size_t index = 0; index < 64; ++index) {
+      bits.push_back((index % 2) != 0);
+    }
+    for(std::size_t index = 0; index < 6; ++index) {
+      bits.push_back(((1U >> index) & 1) != 0); // mode count - 1
+    }
+    for(std::size_t mode = 0; mode < 2; ++mode) {
+      bits.push_back(mode == 1); // block flag
+      bits.insert(bits.end(), 40, false); // window type, transform type and mapping
+    }
+    bits.push_back(true); // framing bit
+
+    std::vector<std::byte> setup((bits.size() + 7) / 8, std::byte(0));
+    for(std::size_t index = 0; index < bits.size(); ++index) {
+      if(bits[index]) {
+        setup[index / 8] |= static_cast<std::byte>(1 << (index % 8));
+      }
+    }
+    writer.WritePacket(setup.data(), setup.size(), 0);
+    writer.FlushPage();
+
+    for(std::size_t index = 0; index < packetCount; ++index) {
+      std::vector<std::byte> packet(40, std::byte(0));
+      packet[0] = std::byte(2); // audio packet, mode 1
+      packet[1] = static_cast<std::byte>(index);
+
+      bool isLast = (index + 1 == packetCount);
+      std::int64_t granulePosition = static_cast<std::int64_t>(index) * 1024;
+      writer.WritePacket(packet.data(), packet.size(), granulePosition, isLast);
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads all packets from an Ogg stream</summary>
+  /// <param name="file">File containing the Ogg stream</param>
+  /// <returns>All packets of the first logical stream in the file</returns>
+  std::vector<Nuclex::Audio::Storage::Shared::OggPacketReader::Packet> readPackets(
+    const Nuclex::Audio::Storage::VirtualFile &file
+  ) {
+    using Nuclex::Audio::Storage::Shared::OggPacketReader;
+
+    std::vector<OggPacketReader::Packet> packets;
+    OggPacketReader reader(file);
+    OggPacketReader::Packet packet;
+    while(reader.ReadPacket(packet)) {
+      packets.push_back(packet);
+    }
+
+    return packets;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, TrimsOpusWithPreRollAndPreSkip) {
+    std::shared_ptr<const VirtualFile> source = makeOpusStream(50);
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    std::uint64_t frameCount = OggRemuxer::Trim(source, 10000, 5000, target);
+    EXPECT_EQ(frameCount, 5000U);
+
+    std::vector<Shared::OggPacketReader::Packet> packets = readPackets(*target);
+    ASSERT_EQ(packets.size(), 12U);
+
+    // The cut lies at 10312 including the pre-skip, 80 ms before that is in packet 6,
+    // which starts at 5760, so 4552 samples need to be skipped
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[0].Data[10]), 4552 & 0xFF);
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[0].Data[11]), 4552 >> 8);
+
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[2].Data[1]), 6U);
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[11].Data[1]), 15U);
+    EXPECT_TRUE(packets[11].IsLast);
+    EXPECT_EQ(packets[11].GranulePosition, 4552 + 5000);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, TrimmedClipEndsWithSource) {
+    std::shared_ptr<const VirtualFile> source = makeOpusStream(50, 500);
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    // The source holds 48000 - 500 - 312 frames
+    std::uint64_t frameCount = OggRemuxer::Trim(source, 40000, 100000, target);
+    EXPECT_EQ(frameCount, 47188U - 40000U);
+
+    std::vector<Shared::OggPacketReader::Packet> packets = readPackets(*target);
+    ASSERT_GE(packets.size(), 3U);
+    EXPECT_EQ(static_cast<std::uint8_t>(packets.back().Data[1]), 49U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, TrimsVorbisViaFirstPageGranule) {
+    std::shared_ptr<const VirtualFile> source = makeVorbisStream(20);
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    std::uint64_t frameCount = OggRemuxer::Trim(source, 3000, 2000, target);
+    EXPECT_EQ(frameCount, 2000U);
+
+    std::vector<Shared::OggPacketReader::Packet> packets = readPackets(*target);
+    ASSERT_EQ(packets.size(), 7U);
+
+    // Packet 2 ends at 2048 and is the one the decoder needs to overlap packet 3 with.
+    // Packet 3 ends at 3072, so the first page's granule position drops 3000 - 2048.
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[3].Data[1]), 2U);
+    EXPECT_EQ(packets[3].GranulePosition, Shared::OggPacketReader::NoGranulePosition);
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[4].Data[1]), 3U);
+    EXPECT_EQ(packets[4].GranulePosition, 72);
+
+    EXPECT_EQ(static_cast<std::uint8_t>(packets[6].Data[1]), 5U);
+    EXPECT_TRUE(packets[6].IsLast);
+    EXPECT_EQ(packets[6].GranulePosition, 2000);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, RejectsStartBeyondEnd) {
+    std::shared_ptr<const VirtualFile> source = makeOpusStream(10);
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    EXPECT_THROW(OggRemuxer::Trim(source, 20000, 100, target), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, RejectsUnknownCodecs) {
+    std::shared_ptr<WritableMemoryFile> source = std::make_shared<WritableMemoryFile>();
+    {
+      Shared::OggPageWriter writer(*source, 0, 1);
+      std::vector<std::byte> header(32, std::byte('x'));
+      writer.WritePacket(header.data(), header.size(), 0, true);
+    }
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    EXPECT_THROW(OggRemuxer::Trim(source, 0, 100, target), Errors::UnsupportedFormatError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggRemuxerTest, ConcatenatesIntoChainedStream) {
+    std::vector<std::shared_ptr<const VirtualFile>> sources;
+    sources.push_back(makeOpusStream(10));
+    sources.push_back(makeOpusStream(20));
+    sources.push_back(makeVorbisStream(5));
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>();
+
+    OggRemuxer::Concatenate(sources, target);
+
+    std::vector<Shared::OggLinkScanner::Link> links = Shared::OggLinkScanner::ScanLinks(*target);
+    ASSERT_EQ(links.size(), 3U);
+    EXPECT_NE(links[0].SerialNumber, links[1].SerialNumber);
+    EXPECT_NE(links[1].SerialNumber, links[2].SerialNumber);
+    EXPECT_NE(links[0].SerialNumber, links[2].SerialNumber);
+    EXPECT_EQ(links[1].LastGranulePosition, 20U * 960U);
+
+    CancellationToken cancellation;
+    EXPECT_EQ(
+      Shared::OggPageVerifier::VerifyPages(*target, cancellation), VerificationResult::Passed
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,87 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Opus/OpusChannelMapping.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusChannelMappingTest, RecognizesAmbisonicChannelCounts) {
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(1));
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(4));
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(6)); // 1st order + stereo
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(9));
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(225));
+    EXPECT_TRUE(OpusChannelMapping::IsAmbisonicChannelCount(227));
+
+    EXPECT_FALSE(OpusChannelMapping::IsAmbisonicChannelCount(0));
+    EXPECT_FALSE(OpusChannelMapping::IsAmbisonicChannelCount(2));
+    EXPECT_FALSE(OpusChannelMapping::IsAmbisonicChannelCount(5));
+    EXPECT_FALSE(OpusChannelMapping::IsAmbisonicChannelCount(7));
+    EXPECT_FALSE(OpusChannelMapping::IsAmbisonicChannelCount(256));
+
+    EXPECT_EQ(OpusChannelMapping::GetAmbisonicOrder(4), 1);
+    EXPECT_EQ(OpusChannelMapping::GetAmbisonicOrder(18), 3);
+    EXPECT_EQ(OpusChannelMapping::GetAmbisonicOrder(10), -1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusChannelMappingTest, SpeakerLayoutsUseVorbisFamilies) {
+    std::vector<ChannelPlacement> stereo = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight
+    };
+    EXPECT_EQ(OpusChannelMapping::SelectMappingFamily(stereo), 0);
+
+    std::vector<ChannelPlacement> quadraphonic = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight,
+      ChannelPlacement::BackLeft, ChannelPlacement::BackRight
+    };
+    EXPECT_EQ(OpusChannelMapping::SelectMappingFamily(quadraphonic), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusChannelMappingTest, UnplacedChannelsUseAmbisonicOrDiscreteFamilies) {
+    std::vector<ChannelPlacement> firstOrder(4, ChannelPlacement::Unknown);
+    EXPECT_EQ(OpusChannelMapping::SelectMappingFamily(firstOrder), 2);
+
+    std::vector<ChannelPlacement> discrete(12, ChannelPlacement::Unknown);
+    EXPECT_EQ(OpusChannelMapping::SelectMappingFamily(discrete), 255);
+
+    std::vector<ChannelPlacement> order = OpusChannelMapping::GetChannelOrder(255, 12);
+    ASSERT_EQ(order.size(), 12U);
+    for(ChannelPlacement channel : order) {
+      EXPECT_EQ(channel, ChannelPlacement::Unknown);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
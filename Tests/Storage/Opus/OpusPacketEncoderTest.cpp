@@ -0,0 +1,143 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/AudioPacketEncoder.h"
+#include "Nuclex/Audio/Storage/AudioPacketDecoder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_OPUS)
+
+#include "../../Processing/SineWaveDetector.h"
+#include "../../ExpectRange.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::sin()
+#include <cstring> // for std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a buffer with a mono sine wave</summary>
+  /// <param name="samples">Buffer that will be filled</param>
+  /// <param name="startFrame">Index of the first frame in the whole signal</param>
+  /// <param name="frameCount">Number of frames that will be generated</param>
+  void generateSine(float *samples, std::size_t startFrame, std::size_t frameCount) {
+    const float phaseStep = 2.0f * 3.14159265358979f * 440.0f / 48000.0f;
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      samples[index] = 0.5f * std::sin(static_cast<float>(startFrame + index) * phaseStep);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusPacketEncoderTest, ProducesOpusHeadSetupData) {
+    std::unique_ptr<AudioPacketEncoder> encoder = AudioPacketEncoder::CreateOpus(
+      { ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight }, 24000, 10000
+    );
+    EXPECT_EQ(encoder->CountChannels(), 2U);
+    EXPECT_EQ(encoder->GetSampleRate(), 24000U);
+    EXPECT_EQ(encoder->CountFramesPerPacket(), 240U);
+
+    const std::vector<std::byte> &setupData = encoder->GetSetupData();
+    ASSERT_EQ(setupData.size(), 19U); // mapping family 0 has no mapping table
+    EXPECT_EQ(std::memcmp(setupData.data(), u8"OpusHead", 8), 0);
+    EXPECT_EQ(static_cast<std::size_t>(setupData[9]), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusPacketEncoderTest, PacketsCanBeDecoded) {
+    std::unique_ptr<AudioPacketEncoder> encoder = AudioPacketEncoder::CreateOpus(
+      { ChannelPlacement::FrontCenter }, 48000, 20000
+    );
+    encoder->SetBitrate(64.0f);
+    std::unique_ptr<AudioPacketDecoder> decoder = AudioPacketDecoder::CreateOpus(
+      encoder->GetSetupData()
+    );
+    ASSERT_EQ(decoder->CountChannels(), 1U);
+
+    std::size_t packetFrameCount = encoder->CountFramesPerPacket();
+    std::vector<float> input(packetFrameCount);
+    std::vector<std::byte> packet(encoder->CountMaximumPacketBytes());
+    std::vector<float> output;
+
+    for(std::size_t packetIndex = 0; packetIndex < 50; ++packetIndex) {
+      generateSine(input.data(), packetIndex * packetFrameCount, packetFrameCount);
+      std::size_t packetSize = encoder->EncodePacket(input.data(), packet.data(), packet.size());
+      ASSERT_GT(packetSize, 0U);
+
+      std::size_t outputStart = output.size();
+      output.resize(outputStart + packetFrameCount);
+      std::size_t decodedFrameCount = decoder->DecodePacket(
+        packet.data(), packetSize, output.data() + outputStart, packetFrameCount
+      );
+      EXPECT_EQ(decodedFrameCount, packetFrameCount);
+    }
+
+    // Skip the encoder's lead-in and give the codec a few packets to settle
+    std::size_t skippedFrameCount = decoder->CountLeadInFrames() + packetFrameCount * 5;
+    Processing::SineWaveDetector detector;
+    detector.DetectAmplitude(
+      output.data() + skippedFrameCount, output.size() - skippedFrameCount
+    );
+    EXPECT_RANGE(detector.GetAmplitude(), 0.4f, 0.6f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusPacketEncoderTest, DecoderConcealsLostPackets) {
+    std::unique_ptr<AudioPacketEncoder> encoder = AudioPacketEncoder::CreateOpus(
+      { ChannelPlacement::FrontCenter }, 16000, 20000
+    );
+    std::unique_ptr<AudioPacketDecoder> decoder = AudioPacketDecoder::CreateOpus(
+      encoder->GetSetupData(), 16000
+    );
+
+    std::size_t packetFrameCount = encoder->CountFramesPerPacket();
+    std::vector<std::int16_t> input(packetFrameCount, 0);
+    std::vector<std::byte> packet(encoder->CountMaximumPacketBytes());
+    std::vector<std::int16_t> output(packetFrameCount);
+
+    std::size_t packetSize = encoder->EncodePacket(input.data(), packet.data(), packet.size());
+    EXPECT_EQ(
+      decoder->DecodePacket(packet.data(), packetSize, output.data(), packetFrameCount),
+      packetFrameCount
+    );
+
+    // A null packet stands for a lost one, the decoder fills in the requested duration
+    EXPECT_EQ(
+      decoder->DecodePacket(nullptr, 0, output.data(), packetFrameCount), packetFrameCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Opus
+
+#endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
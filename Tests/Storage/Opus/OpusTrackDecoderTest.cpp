@@ -183,6 +183,100 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(OpusTrackDecoderTest, FastSeekingConvergesAfterPreRoll) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"opus-stereo-v152.opus"
+    );
+
+    OpusTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Jump back into the middle without the pre-roll. Once 80 ms have been decoded,
+    // the output should have converged with that of the exact decode.
+    decoder.AllowFastSeeking(true);
+
+    std::size_t startFrame = frameCount / 2;
+    std::size_t checkedFrameCount = std::min<std::size_t>(9600, frameCount - startFrame);
+    std::vector<float> actual(checkedFrameCount * channelCount);
+    decoder.DecodeInterleaved(actual.data(), startFrame, checkedFrameCount);
+
+    for(std::size_t index = 3840 * channelCount; index < actual.size(); ++index) {
+      float expectedSample = expected[startFrame * channelCount + index];
+      EXPECT_RANGE(actual[index], expectedSample - 0.01f, expectedSample + 0.01f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusTrackDecoderTest, CanDecodeAtReducedSampleRate) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"opus-stereo-v152.opus"
+    );
+
+    OpusTrackDecoder decoder(file);
+    std::uint64_t fullRateFrameCount = decoder.CountFrames();
+
+    EXPECT_FALSE(decoder.TrySetDecodeSampleRate(22050));
+    ASSERT_TRUE(decoder.TrySetDecodeSampleRate(24000));
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+    EXPECT_EQ(frameCount, (fullRateFrameCount + 1) / 2);
+
+    std::vector<float> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    // The 25 Hz sine waves in both channels easily survive the lower sample rate
+    for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+      Processing::SineWaveDetector detector;
+      detector.DetectAmplitude(
+        samples.data() + channelIndex, samples.size() - channelIndex, channelCount
+      );
+      EXPECT_RANGE(detector.GetAmplitude(), 0.9f, 1.1f);
+    }
+
+    // Clones keep decoding at the reduced rate
+    std::shared_ptr<AudioTrackDecoder> clone = decoder.Clone();
+    EXPECT_EQ(clone->CountFrames(), frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusTrackDecoderTest, DecodesAtAnyFidelity) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"opus-stereo-v152.opus"
+    );
+
+    OpusTrackDecoder decoder(file);
+    ASSERT_TRUE(decoder.TrySetDecodeFidelity(DecodeFidelity::Reduced));
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<float> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    // Without packet loss, the enhancements libopus can skip change nothing audible
+    Processing::SineWaveDetector left;
+    left.DetectAmplitude(samples.data(), samples.size(), channelCount);
+    EXPECT_RANGE(left.GetAmplitude(), 0.9f, 1.1f);
+
+    ASSERT_TRUE(decoder.TrySetDecodeFidelity(DecodeFidelity::Enhanced));
+    std::shared_ptr<AudioTrackDecoder> clone = decoder.Clone();
+    clone->DecodeInterleaved(samples.data(), 0, frameCount);
+
+    Processing::SineWaveDetector enhancedLeft;
+    enhancedLeft.DetectAmplitude(samples.data(), samples.size(), channelCount);
+    EXPECT_RANGE(enhancedLeft.GetAmplitude(), 0.9f, 1.1f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Opus
 
 #endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -24,11 +24,14 @@ limitations under the License.
 
 #if defined(NUCLEX_AUDIO_HAVE_OPUS)
 
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
 #include "Nuclex/Audio/Storage/VirtualFile.h"
 #include "../../../Source/Storage/Opus/OpusTrackEncoderBuilder.h"
 
 #include <gtest/gtest.h>
 
+#include <vector> // for std::vector
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -103,6 +106,58 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Opus {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(OpusTrackEncoderBuilderTest, AcceptsIntegerAndSeparatedInput) {
+    std::shared_ptr<OpusTrackEncoderBuilder> builder = (
+      std::make_shared<OpusTrackEncoderBuilder>()
+    );
+
+    // Reversed stereo channels so the samples have to be reordered for libopusenc
+    std::shared_ptr<AudioTrackEncoder> encoder = builder->
+      SetChannels({ ChannelPlacement::FrontRight, ChannelPlacement::FrontLeft }).
+      SetSampleRate(48000).
+      SetTargetBitrate(128.0f).
+      Build(std::make_shared<DummyVirtualFile>());
+
+    // More than one conversion chunk's worth so that the chunk buffers get reused
+    std::vector<std::int16_t> interleaved(10000 * 2, 1234);
+    EXPECT_NO_THROW(encoder->EncodeInterleaved(interleaved.data(), 10000));
+
+    std::vector<double> left(10000, 0.25), right(10000, -0.25);
+    const double *separated[] = { right.data(), left.data() };
+    EXPECT_NO_THROW(encoder->EncodeSeparated(separated, 10000));
+
+    EXPECT_NO_THROW(encoder->Flush());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OpusTrackEncoderBuilderTest, EncoderCanBeReopenedOnAnotherFile) {
+    std::shared_ptr<OpusTrackEncoderBuilder> builder = (
+      std::make_shared<OpusTrackEncoderBuilder>()
+    );
+
+    std::shared_ptr<AudioTrackEncoder> encoder = builder->
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetTargetBitrate(96.0f).
+      Build(std::make_shared<DummyVirtualFile>());
+
+    std::vector<float> samples(4800 * 2, 0.125f);
+    EXPECT_NO_THROW(encoder->EncodeInterleaved(samples.data(), 4800));
+    EXPECT_NO_THROW(encoder->Flush());
+
+    // A batch of clips goes through the same encoder one after another
+    for(std::size_t clip = 0; clip < 3; ++clip) {
+      ASSERT_TRUE(encoder->TryReopen(std::make_shared<DummyVirtualFile>()));
+      EXPECT_EQ(encoder->CountConsumedFrames(), 0U);
+      EXPECT_NO_THROW(encoder->EncodeInterleaved(samples.data(), 4800));
+      EXPECT_NO_THROW(encoder->Flush());
+      EXPECT_EQ(encoder->CountConsumedFrames(), 4800U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Opus
 
 #endif // defined(NUCLEX_AUDIO_HAVE_OPUS)
@@ -0,0 +1,139 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/PagedTrack.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a decoder on the stereo float waveform file used by the tests</summary>
+  /// <returns>A decoder for the test file</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> openTestDecoder() {
+    using Nuclex::Audio::Storage::VirtualFile;
+    using Nuclex::Audio::GetResourcesDirectory;
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    return std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackDecoder>(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedTrackTest, RequiresDecoderAndPageSize) {
+    std::shared_ptr<AudioTrackDecoder> noDecoder;
+    EXPECT_THROW(PagedTrack track(noDecoder), std::invalid_argument);
+    EXPECT_THROW(
+      PagedTrack track(openTestDecoder(), 65536, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedTrackTest, DeliversSameSamplesAsDecoder) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Use a page size that isn't a multiple of the block size, so pages get aligned
+    PagedTrack track(decoder, 65536, 5000);
+    EXPECT_EQ(track.CountChannels(), channelCount);
+    EXPECT_EQ(track.CountFrames(), decoder->CountFrames());
+
+    std::vector<float> actual(frameCount * channelCount);
+    track.CopyInterleaved(actual.data(), 0, frameCount);
+
+    EXPECT_EQ(actual, expected);
+    EXPECT_THROW(track.CopyInterleaved(actual.data(), 1, frameCount), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedTrackTest, EvictsLeastRecentlyUsedPages) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+    ASSERT_GE(decoder->CountFrames(), 32768U);
+
+    // Budget for two pages of 4096 stereo frames
+    PagedTrack track(decoder, 4096 * 2 * sizeof(float) * 2, 4096);
+
+    track.EnsureDecodedRangeAvailable(0, 100);
+    EXPECT_TRUE(track.IsDecodedRangeAvailable(0, 100));
+    EXPECT_FALSE(track.IsDecodedRangeAvailable(0, 5000));
+
+    track.EnsureDecodedRangeAvailable(8192, 8300);
+    track.EnsureDecodedRangeAvailable(0, 100);
+    track.EnsureDecodedRangeAvailable(16384, 16500);
+
+    // The page at frame 8192 was used least recently and had to make room
+    EXPECT_TRUE(track.IsDecodedRangeAvailable(0, 100));
+    EXPECT_FALSE(track.IsDecodedRangeAvailable(8192, 8300));
+    EXPECT_TRUE(track.IsDecodedRangeAvailable(16384, 16500));
+    EXPECT_EQ(track.CountResidentPages(), 2U);
+    EXPECT_LE(track.GetMemoryUsage(), track.GetMemoryBudget());
+
+    std::size_t availableFrameCount;
+    EXPECT_EQ(track.GetSamples(8192, availableFrameCount), nullptr);
+    EXPECT_EQ(availableFrameCount, 0U);
+    EXPECT_NE(track.GetSamples(16400, availableFrameCount), nullptr);
+    EXPECT_EQ(availableFrameCount, 16384U + 4096U - 16400U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedTrackTest, EnsuredRangeMayExceedBudget) {
+    std::shared_ptr<AudioTrackDecoder> decoder = openTestDecoder();
+    ASSERT_GE(decoder->CountFrames(), 16384U);
+
+    PagedTrack track(decoder, 1, 4096);
+    track.EnsureDecodedRangeAvailable(100, 12400);
+
+    EXPECT_TRUE(track.IsDecodedRangeAvailable(0, 12400));
+    EXPECT_EQ(track.CountResidentPages(), 4U);
+
+    // The next range can evict everything that isn't part of it
+    track.EnsureDecodedRangeAvailable(0, 10);
+    EXPECT_EQ(track.CountResidentPages(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,154 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/ParallelTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::equal()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelTrackDecoderTest, RequiresDecoderAndThreads) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    EXPECT_THROW(
+      ParallelTrackDecoder parallel(std::shared_ptr<AudioTrackDecoder>(), 4),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      ParallelTrackDecoder parallel(decoder, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelTrackDecoderTest, ForwardsMetadataOfWrappedDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::shared_ptr<AudioTrackDecoder> parallel = AudioTrackDecoder::CreateParallel(decoder, 4);
+
+    EXPECT_EQ(parallel->CountChannels(), decoder->CountChannels());
+    EXPECT_EQ(parallel->CountFrames(), decoder->CountFrames());
+    EXPECT_EQ(parallel->GetChannelOrder(), decoder->GetChannelOrder());
+    EXPECT_EQ(parallel->GetNativeSampleFormat(), decoder->GetNativeSampleFormat());
+    EXPECT_EQ(parallel->IsNativelyInterleaved(), decoder->IsNativelyInterleaved());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelTrackDecoderTest, SlicedInterleavedDecodeMatchesDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Use a tiny slice size so the file gets split among all threads
+    ParallelTrackDecoder parallel(decoder, 4, 1000);
+
+    std::vector<float> actual(frameCount * channelCount);
+    parallel.DecodeInterleaved(actual.data(), 0, frameCount);
+    EXPECT_EQ(actual, expected);
+
+    // Decode it again with an odd start frame so the slices don't begin on the grid
+    std::vector<float> offsetActual((frameCount - 777) * channelCount);
+    parallel.DecodeInterleaved(offsetActual.data(), 777, frameCount - 777);
+    EXPECT_TRUE(std::equal(offsetActual.begin(), offsetActual.end(), expected.begin() + 1554));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelTrackDecoderTest, SlicedSeparatedDecodeMatchesDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+
+    std::vector<float> expected(frameCount * 2);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    ParallelTrackDecoder parallel(decoder, 3, 1000);
+
+    std::vector<float> left(frameCount);
+    float *buffers[] = { left.data(), nullptr };
+    parallel.DecodeSeparated(buffers, 0, frameCount);
+
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      ASSERT_EQ(left[index], expected[index * 2]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelTrackDecoderTest, CanDecodeWholeTrackInParallel) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    std::vector<float> actual(frameCount * channelCount);
+    AudioTrackDecoder::DecodeAllParallel(decoder, actual.data(), 2);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,163 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/PlaylistTrackDecoder.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a whole audio file as interleaved floats</summary>
+  /// <param name="loader">Audio loader through which the file will be opened</param>
+  /// <param name="path">Path of the audio file that will be decoded</param>
+  /// <returns>The interleaved samples of the whole audio file</returns>
+  std::vector<float> decodeAll(
+    const Nuclex::Audio::Storage::AudioLoader &loader, const std::string &path
+  ) {
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> decoder = (
+      loader.OpenDecoder(path)
+    );
+    std::vector<float> samples(decoder->CountFrames() * decoder->CountChannels());
+    decoder->DecodeInterleaved<float>(samples.data(), 0, decoder->CountFrames());
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, RequiresAtLeastOneEntry) {
+    AudioLoader loader;
+    EXPECT_THROW(loader.OpenPlaylist(std::vector<std::string>()), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, EntriesMustHaveSameChannelCount) {
+    AudioLoader loader;
+    std::vector<std::string> paths = {
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav",
+      GetResourcesDirectory() + u8"waveform-5dot1-int16le-pcmwaveformat.wav"
+    };
+    EXPECT_THROW(loader.OpenPlaylist(paths), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, EntriesFollowEachOtherWithoutGaps) {
+    AudioLoader loader;
+    std::vector<std::string> paths = {
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav",
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav",
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    };
+
+    std::vector<float> expected;
+    for(const std::string &path : paths) {
+      std::vector<float> samples = decodeAll(loader, path);
+      expected.insert(expected.end(), samples.begin(), samples.end());
+    }
+
+    std::shared_ptr<AudioTrackDecoder> playlist = loader.OpenPlaylist(paths);
+    ASSERT_EQ(playlist->CountChannels(), 2U);
+    ASSERT_EQ(playlist->CountFrames() * 2U, expected.size());
+
+    // Decode in odd-sized chunks so that several of them straddle entry boundaries
+    std::vector<float> actual(expected.size());
+    std::uint64_t frameCount = playlist->CountFrames();
+    for(std::uint64_t frame = 0; frame < frameCount; frame += 1000) {
+      std::size_t chunkFrameCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(1000, frameCount - frame)
+      );
+      playlist->DecodeInterleaved<float>(actual.data() + frame * 2, frame, chunkFrameCount);
+    }
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, CanDecodeSeparatedAcrossEntries) {
+    AudioLoader loader;
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav";
+    std::vector<float> single = decodeAll(loader, path);
+    std::size_t singleFrameCount = single.size() / 2;
+
+    std::shared_ptr<AudioTrackDecoder> playlist = loader.OpenPlaylist({ path, path });
+    ASSERT_EQ(playlist->CountFrames(), singleFrameCount * 2);
+
+    // Start a few frames before the boundary and end a few frames after it
+    std::vector<float> left(20), right(20);
+    float *buffers[] = { left.data(), right.data() };
+    playlist->DecodeSeparated<float>(buffers, singleFrameCount - 10, 20);
+
+    for(std::size_t index = 0; index < 20; ++index) {
+      std::size_t frame = (singleFrameCount - 10 + index) % singleFrameCount;
+      EXPECT_EQ(left[index], single[frame * 2]);
+      EXPECT_EQ(right[index], single[frame * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, ClonesDecodeIndependently) {
+    AudioLoader loader;
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+    std::shared_ptr<AudioTrackDecoder> playlist = loader.OpenPlaylist({ path, path });
+    std::shared_ptr<AudioTrackDecoder> clone = playlist->Clone();
+    ASSERT_EQ(clone->CountFrames(), playlist->CountFrames());
+
+    std::uint64_t lastFrame = playlist->CountFrames() - 100;
+    std::vector<float> expected(200), actual(200);
+    playlist->DecodeInterleaved<float>(expected.data(), lastFrame, 100);
+    clone->DecodeInterleaved<float>(actual.data(), lastFrame, 100);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlaylistTrackDecoderTest, DecodingPastEndThrows) {
+    AudioLoader loader;
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+    std::shared_ptr<AudioTrackDecoder> playlist = loader.OpenPlaylist({ path });
+
+    std::vector<float> samples(20);
+    EXPECT_THROW(
+      playlist->DecodeInterleaved<float>(samples.data(), playlist->CountFrames() - 5, 10),
+      std::out_of_range
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
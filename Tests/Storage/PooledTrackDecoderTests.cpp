@@ -0,0 +1,144 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/PooledTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledTrackDecoderTest, RequiresDecoderAndSlots) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    EXPECT_THROW(
+      PooledTrackDecoder pool(std::shared_ptr<AudioTrackDecoder>(), 4),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      PooledTrackDecoder pool(decoder, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledTrackDecoderTest, ForwardsMetadataOfWrappedDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::shared_ptr<AudioTrackDecoder> pool = AudioTrackDecoder::CreatePool(decoder, 4);
+
+    EXPECT_EQ(pool->CountChannels(), decoder->CountChannels());
+    EXPECT_EQ(pool->CountFrames(), decoder->CountFrames());
+    EXPECT_EQ(pool->GetChannelOrder(), decoder->GetChannelOrder());
+    EXPECT_EQ(pool->GetNativeSampleFormat(), decoder->GetNativeSampleFormat());
+    EXPECT_EQ(pool->IsNativelyInterleaved(), decoder->IsNativelyInterleaved());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledTrackDecoderTest, SingleThreadDoesNotCreateClones) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    PooledTrackDecoder pool(std::make_shared<Waveform::WaveformTrackDecoder>(file), 4);
+
+    std::size_t channelCount = pool.CountChannels();
+    std::vector<float> samples(256 * channelCount);
+    for(std::size_t index = 0; index < 8; ++index) {
+      pool.DecodeInterleaved(samples.data(), index * 256, 256);
+    }
+
+    EXPECT_EQ(pool.CountDecoders(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledTrackDecoderTest, ConcurrentDecodesDeliverSameSamples) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    PooledTrackDecoder pool(decoder, 3);
+
+    // Let several threads each decode the whole file in small chunks through the pool
+    const std::size_t threadCount = 6;
+    const std::size_t chunkFrameCount = 250;
+    std::vector<std::vector<float>> results(
+      threadCount, std::vector<float>(frameCount * channelCount)
+    );
+    {
+      std::vector<std::thread> threads;
+      for(std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        threads.emplace_back(
+          [&, threadIndex]() {
+            std::vector<float> &result = results[threadIndex];
+            for(std::size_t start = 0; start < frameCount; start += chunkFrameCount) {
+              std::size_t count = std::min(chunkFrameCount, frameCount - start);
+              pool.DecodeInterleaved(result.data() + start * channelCount, start, count);
+            }
+          }
+        );
+      }
+      for(std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        threads[threadIndex].join();
+      }
+    }
+
+    for(std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+      EXPECT_EQ(results[threadIndex], expected);
+    }
+    EXPECT_GE(pool.CountDecoders(), 1U);
+    EXPECT_LE(pool.CountDecoders(), 3U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,186 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ProxyGenerator.h"
+#include "Nuclex/Audio/Storage/AssetCatalog.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <gtest/gtest.h>
+
+#include <cstdio> // for std::remove()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a proxy generator writing Waveform files at 22.05 kHz</summary>
+  /// <returns>The new proxy generator</returns>
+  /// <remarks>
+  ///   The tests can't rely on Opus being compiled in, but the pipeline doesn't care
+  ///   which codec the proxies are stored in.
+  /// </remarks>
+  Nuclex::Audio::Storage::ProxyGenerator makeWaveformProxyGenerator() {
+    std::shared_ptr<Nuclex::Audio::Storage::AudioTrackEncoderBuilder> builder = (
+      std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackEncoderBuilder>()
+    );
+    builder->SetSampleFormat(Nuclex::Audio::AudioSampleFormat::Float_32);
+    return Nuclex::Audio::Storage::ProxyGenerator(builder, u8"wav", 22050, 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Saves the records collected by a catalog writer and opens them again</summary>
+  /// <param name="writer">Catalog writer whose records will be saved</param>
+  /// <returns>The asset catalog holding the records</returns>
+  std::shared_ptr<const Nuclex::Audio::Storage::AssetCatalog> saveCatalog(
+    const Nuclex::Audio::Storage::AssetCatalogWriter &writer
+  ) {
+    std::shared_ptr<Nuclex::Audio::Storage::WritableMemoryFile> file = (
+      std::make_shared<Nuclex::Audio::Storage::WritableMemoryFile>()
+    );
+    writer.Save(*file);
+    return std::make_shared<Nuclex::Audio::Storage::AssetCatalog>(file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ProxyGeneratorTest, ProxiesAreStoredNextToTheirMasters) {
+    ProxyGenerator generator = makeWaveformProxyGenerator();
+    EXPECT_EQ(generator.GetDefaultProxyPath(u8"music/drums.wav"), u8"music/drums.wav.proxy.wav");
+
+    generator.AddMaster(u8"music/drums.wav");
+    generator.AddMaster(u8"music/bass.wav", u8"proxies/bass.wav");
+    EXPECT_EQ(generator.CountMasters(), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ProxyMappingTest, FramesConvertByTheRatioOfSampleRates) {
+    ProxyMapping mapping { u8"proxy.opus", 24000, 12000, 96000, 48000 };
+    EXPECT_EQ(mapping.ToMasterFrame(0), 0U);
+    EXPECT_EQ(mapping.ToMasterFrame(1000), 4000U);
+    EXPECT_EQ(mapping.ToProxyFrame(4003), 1000U);
+    EXPECT_EQ(mapping.ToMasterFrame(20000), 48000U);
+    EXPECT_EQ(mapping.ToProxyFrame(100000), 12000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ProxyGeneratorTest, LoaderOpensProxyForPreviews) {
+    Nuclex::Support::TemporaryDirectoryScope proxyDirectory(u8"nuclex-audio-proxy");
+    std::string masterPath = (
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+    std::string proxyPath = proxyDirectory.GetPath(u8"stereo.proxy.wav");
+
+    ProxyGenerator generator = makeWaveformProxyGenerator();
+    generator.AddMaster(masterPath, proxyPath);
+    generator.AddMaster(GetResourcesDirectory() + u8"this-file-does-not-exist.wav");
+
+    AssetCatalogWriter writer;
+    TranscodeStatistics statistics = generator.Run(writer);
+    EXPECT_EQ(statistics.SucceededJobCount, 1U);
+    EXPECT_EQ(statistics.FailedJobCount, 1U);
+    EXPECT_EQ(generator.CountMasters(), 0U);
+    EXPECT_EQ(writer.CountRecords(), 1U);
+
+    std::optional<AssetRecord> record = writer.TryLookup(masterPath);
+    ASSERT_TRUE(record.has_value());
+    ASSERT_TRUE(record.value().Info.has_value());
+    ASSERT_TRUE(record.value().Proxy.has_value());
+
+    const ProxyMapping &mapping = record.value().Proxy.value();
+    EXPECT_EQ(mapping.ProxyPath, proxyPath);
+    EXPECT_EQ(mapping.ProxySampleRate, 22050U);
+    EXPECT_EQ(mapping.MasterSampleRate, 44100U);
+
+    AudioLoader loader;
+    std::uint64_t masterFrameCount = loader.OpenDecoder(masterPath)->CountFrames();
+    EXPECT_EQ(mapping.MasterFrameCount, masterFrameCount);
+    EXPECT_NEAR(
+      static_cast<double>(mapping.ProxyFrameCount),
+      static_cast<double>(masterFrameCount / 2),
+      1.0
+    );
+
+    // Previews come from the proxy, resampled to the master's rate and length
+    loader.SetAssetCatalog(saveCatalog(writer));
+    std::shared_ptr<AudioTrackDecoder> preview = loader.OpenPreviewDecoder(masterPath);
+    EXPECT_EQ(preview->GetNativeSampleFormat(), AudioSampleFormat::Float_32);
+    EXPECT_NEAR(
+      static_cast<double>(preview->CountFrames()), static_cast<double>(masterFrameCount), 2.0
+    );
+
+    // Exact edits still go to the master
+    std::shared_ptr<AudioTrackDecoder> master = loader.OpenDecoder(masterPath);
+    EXPECT_EQ(master->GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_16);
+
+    // Without its proxy, the preview falls back to the master
+    ASSERT_EQ(std::remove(proxyPath.c_str()), 0);
+    preview = loader.OpenPreviewDecoder(masterPath);
+    EXPECT_EQ(preview->GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_16);
+    EXPECT_EQ(preview->CountFrames(), masterFrameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ProxyGeneratorTest, ExistingRecordsAreUpdated) {
+    Nuclex::Support::TemporaryDirectoryScope proxyDirectory(u8"nuclex-audio-proxy");
+    std::string masterPath = (
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    AssetCatalogWriter writer;
+    {
+      AssetRecord indexed = AssetRecord();
+      indexed.PeakPyramid = std::vector<std::byte>(16, std::byte(1));
+      indexed.IntegratedLoudness = -20.0;
+      writer.Add(masterPath, indexed);
+    }
+
+    ProxyGenerator generator = makeWaveformProxyGenerator();
+    generator.AddMaster(masterPath, proxyDirectory.GetPath(u8"stereo.proxy.wav"));
+    generator.Run(writer);
+
+    std::optional<AssetRecord> record = writer.TryLookup(masterPath);
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record.value().PeakPyramid.size(), 16U);
+    EXPECT_EQ(record.value().IntegratedLoudness, std::optional<double>(-20.0));
+    EXPECT_TRUE(record.value().Proxy.has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,169 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/RawPcm/RawPcmReader.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "../ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef> // for std::byte
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ten bytes of junk followed by two stereo frames of little endian samples</summary>
+  const std::byte SamplesBehindHeader[] = {
+    std::byte(0xDE), std::byte(0xAD), std::byte(0xBE), std::byte(0xEF), std::byte(0x00),
+    std::byte(0x11), std::byte(0x22), std::byte(0x33), std::byte(0x44), std::byte(0x55),
+    std::byte(0x00), std::byte(0x40), std::byte(0x00), std::byte(0xC0),
+    std::byte(0x02), std::byte(0x01), std::byte(0xFE), std::byte(0xFF)
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a layout for 16-bit stereo samples behind a ten byte header</summary>
+  /// <returns>The layout describing the samples in the test data</returns>
+  Nuclex::Audio::Storage::RawPcmLayout makeStereoLayout() {
+    Nuclex::Audio::Storage::RawPcmLayout layout;
+    layout.ChannelCount = 2;
+    layout.SampleRate = 48000;
+    layout.SampleFormat = Nuclex::Audio::AudioSampleFormat::SignedInteger_16;
+    layout.ByteOffset = 10;
+    return layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace RawPcm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawPcmReaderTest, FrameCountExtendsToEndOfFile) {
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      SamplesBehindHeader, sizeof(SamplesBehindHeader)
+    );
+
+    Waveform::StoredSampleLayout layout = RawPcmReader::ReadLayout(file, makeStereoLayout());
+    EXPECT_EQ(layout.FrameCount, 2U);
+    EXPECT_EQ(layout.BytesPerFrame, 4U);
+    EXPECT_EQ(layout.FirstSampleOffset, 10U);
+    EXPECT_EQ(layout.Track.BitsPerSample, 16U);
+    EXPECT_EQ(
+      layout.Track.ChannelPlacements, ChannelPlacement::FrontLeft | ChannelPlacement::FrontRight
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawPcmReaderTest, FrameCountIsClippedToFileSize) {
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      SamplesBehindHeader, sizeof(SamplesBehindHeader)
+    );
+
+    RawPcmLayout rawLayout = makeStereoLayout();
+    rawLayout.FrameCount = 1;
+    EXPECT_EQ(RawPcmReader::ReadLayout(file, rawLayout).FrameCount, 1U);
+
+    rawLayout.FrameCount = 100;
+    EXPECT_EQ(RawPcmReader::ReadLayout(file, rawLayout).FrameCount, 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawPcmReaderTest, RejectsInvalidLayouts) {
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      SamplesBehindHeader, sizeof(SamplesBehindHeader)
+    );
+
+    RawPcmLayout rawLayout = makeStereoLayout();
+    rawLayout.BitsPerSample = 20;
+    EXPECT_THROW(RawPcmReader::ReadLayout(file, rawLayout), std::invalid_argument);
+
+    rawLayout = makeStereoLayout();
+    rawLayout.ChannelCount = 0;
+    EXPECT_THROW(RawPcmReader::ReadLayout(file, rawLayout), std::invalid_argument);
+
+    rawLayout = makeStereoLayout();
+    rawLayout.SampleFormat = AudioSampleFormat::Unknown;
+    EXPECT_THROW(RawPcmReader::ReadLayout(file, rawLayout), Errors::UnsupportedFormatError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawPcmReaderTest, DecoderConvertsSamples) {
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      SamplesBehindHeader, sizeof(SamplesBehindHeader)
+    );
+
+    std::shared_ptr<AudioTrackDecoder> decoder = AudioTrackDecoder::OpenRawPcm(
+      file, makeStereoLayout()
+    );
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->CountFrames(), 2U);
+    EXPECT_EQ(decoder->CountChannels(), 2U);
+
+    std::int16_t samples[4];
+    decoder->DecodeInterleaved(samples, 0, 2);
+    EXPECT_EQ(samples[0], 16384);
+    EXPECT_EQ(samples[1], -16384);
+    EXPECT_EQ(samples[2], 0x0102);
+    EXPECT_EQ(samples[3], -2);
+
+    float floats[4];
+    decoder->DecodeInterleaved(floats, 0, 2);
+    EXPECT_NEAR(floats[0], 0.5f, 0.0001f);
+    EXPECT_NEAR(floats[1], -0.5f, 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawPcmReaderTest, DecoderHandlesBigEndianSamples) {
+    const std::byte bigEndianSamples[] = {
+      std::byte(0x40), std::byte(0x00), std::byte(0xFF), std::byte(0xFE)
+    };
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      bigEndianSamples, sizeof(bigEndianSamples)
+    );
+
+    RawPcmLayout rawLayout;
+    rawLayout.ChannelCount = 1;
+    rawLayout.SampleRate = 22050;
+    rawLayout.SampleFormat = AudioSampleFormat::SignedInteger_16;
+    rawLayout.IsLittleEndian = false;
+
+    std::shared_ptr<AudioTrackDecoder> decoder = AudioTrackDecoder::OpenRawPcm(file, rawLayout);
+
+    std::int16_t samples[2];
+    decoder->DecodeInterleaved(samples, 0, 2);
+    EXPECT_EQ(samples[0], 16384);
+    EXPECT_EQ(samples[1], -2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::RawPcm
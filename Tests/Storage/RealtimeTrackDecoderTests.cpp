@@ -0,0 +1,193 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/RealtimeTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+#include "../AllocationCounter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, RequiresDecoderAndBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    EXPECT_THROW(
+      RealtimeTrackDecoder realtime(std::shared_ptr<AudioTrackDecoder>(), 256),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      RealtimeTrackDecoder realtime(decoder, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, RejectsRequestsLargerThanBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    RealtimeTrackDecoder realtime(std::make_shared<Waveform::WaveformTrackDecoder>(file), 256);
+
+    std::vector<float> samples(512 * realtime.CountChannels());
+    EXPECT_FALSE(realtime.TryDecodeInterleaved(samples.data(), 0, 512));
+    EXPECT_THROW(realtime.WaitUntilReady(0, 512), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, DeliversSameSamplesAsDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Use an odd buffer and chunk size so that reads wrap around the ring buffer's end
+    RealtimeTrackDecoder realtime(decoder, 1000);
+
+    const std::size_t chunkFrameCount = 300;
+    std::vector<float> actual(frameCount * channelCount);
+    for(std::size_t start = 0; start < frameCount; start += chunkFrameCount) {
+      std::size_t count = std::min(chunkFrameCount, frameCount - start);
+      realtime.WaitUntilReady(start, count);
+      ASSERT_TRUE(
+        realtime.TryDecodeInterleaved(actual.data() + start * channelCount, start, count)
+      );
+    }
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, CanDeliverSeparatedChannels) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+
+    std::vector<float> expected(512 * 2);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 1000, 512);
+
+    RealtimeTrackDecoder realtime(decoder, 4096, 1000);
+    realtime.WaitUntilReady(1000, 512);
+
+    std::vector<float> right(512);
+    float *buffers[] = { nullptr, right.data() };
+    ASSERT_TRUE(realtime.TryDecodeSeparated(buffers, 1000, 512));
+
+    for(std::size_t index = 0; index < 512; ++index) {
+      EXPECT_EQ(right[index], expected[index * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, RepositionsOnNonSequentialRequest) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(256 * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), 20000, 256);
+
+    RealtimeTrackDecoder realtime(decoder, 1024);
+    realtime.WaitUntilReady(0, 256);
+
+    // The ring buffer holds the beginning of the file, so jumping far ahead
+    // is not ready at first, but the background thread should get there
+    std::vector<float> actual(256 * channelCount);
+    EXPECT_FALSE(realtime.TryDecodeInterleaved(actual.data(), 20000, 256));
+    realtime.WaitUntilReady(20000, 256);
+    ASSERT_TRUE(realtime.TryDecodeInterleaved(actual.data(), 20000, 256));
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RealtimeTrackDecoderTest, DecodingCallsDoNotAllocate) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    RealtimeTrackDecoder realtime(std::make_shared<Waveform::WaveformTrackDecoder>(file));
+    std::size_t channelCount = realtime.CountChannels();
+
+    std::vector<float> interleaved(256 * channelCount);
+    std::vector<std::vector<float>> separated(channelCount, std::vector<float>(256));
+    std::vector<float *> buffers(channelCount);
+    for(std::size_t index = 0; index < channelCount; ++index) {
+      buffers[index] = separated[index].data();
+    }
+
+    realtime.WaitUntilReady(0, 512);
+
+    // Both the successful and the not-ready cases must stay away from the heap
+    bool wasInterleavedDelivered, wasSeparatedDelivered, wasFarAheadDelivered;
+    std::size_t allocationCount;
+    {
+      AllocationCounter allocationCounter;
+      wasInterleavedDelivered = realtime.TryDecodeInterleaved(interleaved.data(), 0, 256);
+      wasSeparatedDelivered = realtime.TryDecodeSeparated(buffers.data(), 256, 256);
+      wasFarAheadDelivered = realtime.TryDecodeInterleaved(interleaved.data(), 40000, 256);
+      allocationCount = allocationCounter.CountAllocations();
+    }
+
+    EXPECT_TRUE(wasInterleavedDelivered);
+    EXPECT_TRUE(wasSeparatedDelivered);
+    EXPECT_FALSE(wasFarAheadDelivered);
+    EXPECT_EQ(allocationCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,221 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono::steady_clock
+#include <stdexcept> // for std::runtime_error
+#include <thread> // for std::this_thread::sleep_for()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>File of counting bytes that simulates a slow and unreliable backend</summary>
+  class FlakyFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new flaky file</summary>
+    /// <param name="length">Number of bytes the file will hold</param>
+    public: FlakyFile(std::size_t length) :
+      length(length),
+      Latency(0),
+      StalledReadCount(0),
+      FailingReadCount(0),
+      ReadCount(0),
+      LargestRead(0) {}
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file at an absolute position</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      ++this->ReadCount;
+      std::size_t largest = this->LargestRead.load();
+      while(byteCount > largest) {
+        if(this->LargestRead.compare_exchange_weak(largest, byteCount)) {
+          break;
+        }
+      }
+
+      if(this->FailingReadCount.load() > 0) {
+        --this->FailingReadCount;
+        throw std::runtime_error(u8"Simulated backend failure");
+      }
+      if(this->StalledReadCount.load() > 0) {
+        --this->StalledReadCount;
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+      }
+      if((start > this->length) || (this->length - start < byteCount)) {
+        throw std::out_of_range(u8"Read past end of file");
+      }
+
+      std::this_thread::sleep_for(this->Latency);
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        buffer[index] = static_cast<std::byte>(start + index);
+      }
+    }
+
+    /// <summary>Writes data into the file at an absolute position</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(std::uint64_t, std::size_t, const std::byte *) override {
+      throw std::runtime_error(u8"Flaky file is read-only");
+    }
+
+    /// <summary>Length of the simulated file in bytes</summary>
+    private: std::size_t length;
+    /// <summary>Time each read takes</summary>
+    public: std::chrono::milliseconds Latency;
+    /// <summary>Number of upcoming reads that will stall for two seconds</summary>
+    public: mutable std::atomic<std::size_t> StalledReadCount;
+    /// <summary>Number of upcoming reads that will fail</summary>
+    public: mutable std::atomic<std::size_t> FailingReadCount;
+    /// <summary>Number of reads that have been attempted</summary>
+    public: mutable std::atomic<std::size_t> ReadCount;
+    /// <summary>Size of the largest read that has been attempted</summary>
+    public: mutable std::atomic<std::size_t> LargestRead;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks that a buffer holds the counting bytes of a flaky file</summary>
+  /// <param name="buffer">Buffer that will be checked</param>
+  /// <param name="start">File offset the buffer was read from</param>
+  /// <param name="byteCount">Number of bytes in the buffer</param>
+  void expectCountingBytes(const std::byte *buffer, std::uint64_t start, std::size_t byteCount) {
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      ASSERT_EQ(buffer[index], static_cast<std::byte>(start + index));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RemoteAccessFileTest, HedgesStalledReads) {
+    std::shared_ptr<FlakyFile> flaky = std::make_shared<FlakyFile>(4096);
+    flaky->StalledReadCount = 1;
+
+    RemoteReadPolicy policy;
+    policy.InitialHedgeDelay = std::chrono::milliseconds(20);
+    policy.MinimumReadAheadByteCount = 0;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::WrapForRemoteAccess(flaky, policy);
+
+    std::byte buffer[100];
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    file->ReadAt(1000, 100, buffer);
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    EXPECT_EQ(flaky->ReadCount.load(), 2U);
+    expectCountingBytes(buffer, 1000, 100);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RemoteAccessFileTest, RetriesFailedReads) {
+    std::shared_ptr<FlakyFile> flaky = std::make_shared<FlakyFile>(4096);
+    flaky->FailingReadCount = 2;
+
+    RemoteReadPolicy policy;
+    policy.InitialRetryDelay = std::chrono::milliseconds(1);
+    policy.MinimumReadAheadByteCount = 0;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::WrapForRemoteAccess(flaky, policy);
+
+    std::byte buffer[100];
+    file->ReadAt(200, 100, buffer);
+    EXPECT_EQ(flaky->ReadCount.load(), 3U);
+    expectCountingBytes(buffer, 200, 100);
+
+    flaky->FailingReadCount = 10;
+    EXPECT_THROW(file->ReadAt(200, 100, buffer), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RemoteAccessFileTest, DoesNotRetryOutOfRangeReads) {
+    std::shared_ptr<FlakyFile> flaky = std::make_shared<FlakyFile>(4096);
+    std::shared_ptr<const VirtualFile> file = VirtualFile::WrapForRemoteAccess(flaky);
+
+    std::byte buffer[100];
+    EXPECT_THROW(file->ReadAt(4050, 100, buffer), std::out_of_range);
+    EXPECT_EQ(flaky->ReadCount.load(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RemoteAccessFileTest, ServesSmallReadsFromReadAheadWindow) {
+    std::shared_ptr<FlakyFile> flaky = std::make_shared<FlakyFile>(65536);
+
+    RemoteReadPolicy policy;
+    policy.MinimumReadAheadByteCount = 4096;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::WrapForRemoteAccess(flaky, policy);
+
+    std::byte buffer[256];
+    for(std::uint64_t start = 0; start < 4096; start += 256) {
+      file->ReadAt(start, 256, buffer);
+      expectCountingBytes(buffer, start, 256);
+    }
+    EXPECT_EQ(flaky->ReadCount.load(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RemoteAccessFileTest, GrowsReadAheadWithLatency) {
+    std::shared_ptr<FlakyFile> flaky = std::make_shared<FlakyFile>(1024 * 1024);
+    flaky->Latency = std::chrono::milliseconds(10);
+
+    RemoteReadPolicy policy;
+    policy.MinimumReadAheadByteCount = 1024;
+    policy.MaximumReadAheadByteCount = 65536;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::WrapForRemoteAccess(flaky, policy);
+
+    std::byte buffer[512];
+    for(std::uint64_t start = 0; start < 256 * 1024; start += 512) {
+      file->ReadAt(start, 512, buffer);
+      expectCountingBytes(buffer, start, 512);
+    }
+
+    // The simulated backend transfers instantly, so with any latency at all, the window
+    // should grow to its maximum size
+    EXPECT_EQ(flaky->LargestRead.load(), 65536U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,182 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../Source/Storage/ResamplingTrackDecoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+#include "./TestAudioVerifier.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::abs()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, RequiresDecoderAndSampleRates) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    EXPECT_THROW(
+      ResamplingTrackDecoder(std::shared_ptr<AudioTrackDecoder>(), 44100, 48000),
+      std::invalid_argument
+    );
+    EXPECT_THROW(ResamplingTrackDecoder(decoder, 0, 48000), std::invalid_argument);
+    EXPECT_THROW(ResamplingTrackDecoder(decoder, 44100, 0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, TranslatesFrameCountToOutputSampleRate) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::uint64_t inputFrameCount = decoder->CountFrames();
+
+    std::shared_ptr<AudioTrackDecoder> resampler = AudioTrackDecoder::CreateResampler(
+      decoder, 44100, 48000
+    );
+    EXPECT_EQ(resampler->CountChannels(), decoder->CountChannels());
+    EXPECT_EQ(resampler->GetChannelOrder(), decoder->GetChannelOrder());
+    EXPECT_EQ(resampler->CountFrames(), (inputFrameCount * 160 + 146) / 147);
+
+    std::vector<float> samples(2 * 16);
+    EXPECT_THROW(
+      resampler->DecodeInterleaved(samples.data(), resampler->CountFrames() - 8, 16),
+      std::out_of_range
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, ResampledAudioKeepsFrequencyAndPhase) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> resampler = AudioTrackDecoder::CreateResampler(
+      std::make_shared<Waveform::WaveformTrackDecoder>(file), 44100, 48000
+    );
+
+    std::size_t channelCount = resampler->CountChannels();
+    std::size_t frameCount = static_cast<std::size_t>(resampler->CountFrames());
+
+    std::vector<float> samples(frameCount * channelCount);
+    resampler->DecodeInterleaved(samples.data(), 0, frameCount);
+
+    TestAudioVerifier::VerifyStereo(samples, channelCount, 48000);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, ChunkedDecodingMatchesSingleCall) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> resampler = AudioTrackDecoder::CreateResampler(
+      std::make_shared<Waveform::WaveformTrackDecoder>(file), 44100, 32000
+    );
+
+    std::size_t channelCount = resampler->CountChannels();
+    std::size_t frameCount = static_cast<std::size_t>(resampler->CountFrames());
+
+    std::vector<float> expected(frameCount * channelCount);
+    resampler->Clone()->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Odd chunk sizes make each chunk begin at a different filter phase
+    const std::size_t chunkFrameCount = 777;
+    std::vector<float> actual(frameCount * channelCount);
+    for(std::size_t start = 0; start < frameCount; start += chunkFrameCount) {
+      std::size_t count = std::min(chunkFrameCount, frameCount - start);
+      resampler->DecodeInterleaved(actual.data() + start * channelCount, start, count);
+    }
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, SeekingMatchesSequentialDecoding) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> resampler = AudioTrackDecoder::CreateResampler(
+      std::make_shared<Waveform::WaveformTrackDecoder>(file), 44100, 48000
+    );
+    ASSERT_EQ(resampler->CountChannels(), 2U);
+
+    std::size_t frameCount = static_cast<std::size_t>(resampler->CountFrames());
+
+    std::vector<float> expected(frameCount * 2);
+    resampler->Clone()->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Jump backwards and forwards, then compare separated delivery
+    std::vector<float> left(1000), right(1000);
+    float *buffers[] = { left.data(), right.data() };
+    resampler->DecodeSeparated(buffers, 30001, 1000);
+    resampler->DecodeSeparated(buffers, 1234, 1000);
+
+    for(std::size_t index = 0; index < 1000; ++index) {
+      EXPECT_EQ(left[index], expected[(1234 + index) * 2]);
+      EXPECT_EQ(right[index], expected[(1234 + index) * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResamplingTrackDecoderTest, IntegerSamplesAreQuantizedFilterOutput) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> resampler = AudioTrackDecoder::CreateResampler(
+      std::make_shared<Waveform::WaveformTrackDecoder>(file), 44100, 22050
+    );
+
+    std::size_t channelCount = resampler->CountChannels();
+    std::size_t frameCount = static_cast<std::size_t>(resampler->CountFrames());
+
+    std::vector<float> floats(frameCount * channelCount);
+    resampler->DecodeInterleaved(floats.data(), 0, frameCount);
+    std::vector<std::int16_t> integers(frameCount * channelCount);
+    resampler->DecodeInterleaved(integers.data(), 0, frameCount);
+
+    for(std::size_t index = 0; index < floats.size(); ++index) {
+      float clamped = std::min(std::max(floats[index], -1.0f), 1.0f);
+      EXPECT_LE(std::abs(clamped * 32767.0f - static_cast<float>(integers[index])), 1.0f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
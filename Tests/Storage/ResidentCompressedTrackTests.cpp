@@ -0,0 +1,146 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/ResidentCompressedTrack.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResidentCompressedTrackTest, DeliversSameSamplesAsDecoder) {
+    AudioLoader loader;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(file);
+
+    ResidentCompressedTrack track(loader, file);
+    ASSERT_EQ(track.CountChannels(), decoder->CountChannels());
+    ASSERT_EQ(track.CountFrames(), decoder->CountFrames());
+    EXPECT_EQ(track.GetChannelOrder(), decoder->GetChannelOrder());
+    EXPECT_EQ(track.GetCompressedByteCount(), file->GetSize());
+
+    // Read a range that starts and ends in the middle of blocks
+    std::size_t channelCount = decoder->CountChannels();
+    std::vector<float> expected(10000 * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 1234, 10000);
+
+    std::vector<float> actual(10000 * channelCount);
+    track.DecodeInterleaved(actual.data(), 1234, 10000);
+    EXPECT_EQ(actual, expected);
+
+    EXPECT_THROW(
+      track.DecodeInterleaved(actual.data(), track.CountFrames() - 10, 11),
+      std::out_of_range
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResidentCompressedTrackTest, ServesRepeatedReadsFromCache) {
+    AudioLoader loader;
+    ResidentCompressedTrack track(
+      loader,
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+
+    std::vector<float> samples(100 * track.CountChannels());
+    track.DecodeInterleaved(samples.data(), 500, 100);
+    EXPECT_EQ(track.CountMisses(), 1U);
+    EXPECT_EQ(track.CountHits(), 0U);
+    EXPECT_GT(track.GetCacheMemoryUsage(), 0U);
+
+    track.DecodeInterleaved(samples.data(), 550, 100);
+    EXPECT_EQ(track.CountMisses(), 1U);
+    EXPECT_EQ(track.CountHits(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResidentCompressedTrackTest, StaysWithinCacheMemoryLimit) {
+    AudioLoader loader;
+    ResidentCompressedTrack track(
+      loader,
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      ),
+      std::string(),
+      65536
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(track.CountFrames());
+    std::vector<float> samples(frameCount * track.CountChannels());
+    track.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    EXPECT_LE(track.GetCacheMemoryUsage(), 65536U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ResidentCompressedTrackTest, CanBeReadFromMultipleThreads) {
+    AudioLoader loader;
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    ResidentCompressedTrack track(loader, file, std::string(), 65536);
+
+    std::size_t frameCount = static_cast<std::size_t>(track.CountFrames());
+    std::size_t channelCount = track.CountChannels();
+    std::vector<float> expected(frameCount * channelCount);
+    loader.OpenDecoder(file)->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    const std::size_t threadCount = 4;
+    std::vector<std::vector<float>> results(threadCount);
+    std::vector<std::thread> threads;
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      threads.emplace_back(
+        [&track, &results, index, frameCount, channelCount]() {
+          results[index].resize(frameCount * channelCount);
+          track.DecodeInterleaved(results[index].data(), 0, frameCount);
+        }
+      );
+    }
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      threads[index].join();
+    }
+
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      EXPECT_EQ(results[index], expected);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
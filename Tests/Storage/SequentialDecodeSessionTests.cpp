@@ -0,0 +1,167 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SequentialDecodeSession.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialDecodeSessionTest, RequiresDecoderAndChunkSize) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::shared_ptr<AudioTrackDecoder> nullDecoder;
+    EXPECT_THROW(
+      SequentialDecodeSession session(nullDecoder),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      SequentialDecodeSession session(decoder, 0, 0),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      SequentialDecodeSession session(decoder, decoder->CountFrames() + 1),
+      std::out_of_range
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialDecodeSessionTest, SmallChunksDeliverSameSamplesAsDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Use a chunk size that isn't a multiple of the request size so requests straddle chunks
+    SequentialDecodeSession session(decoder, 0, 1000);
+
+    std::vector<float> actual(frameCount * channelCount);
+    std::size_t deliveredFrameCount = 0;
+    while(!session.IsAtEnd()) {
+      deliveredFrameCount += session.DecodeInterleaved(
+        actual.data() + (deliveredFrameCount * channelCount), 64
+      );
+    }
+
+    EXPECT_EQ(deliveredFrameCount, frameCount);
+    EXPECT_EQ(session.GetFrameCursorPosition(), decoder->CountFrames());
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialDecodeSessionTest, LargeRequestsBypassChunkBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(3000 * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 100, 3000);
+
+    SequentialDecodeSession session(decoder, 100, 256);
+
+    // Mix small requests served from the chunk with large ones decoded directly
+    std::vector<float> actual(3000 * channelCount);
+    EXPECT_EQ(session.DecodeInterleaved(actual.data(), 10), 10U);
+    EXPECT_EQ(session.DecodeInterleaved(actual.data() + 10 * channelCount, 2000), 2000U);
+    EXPECT_EQ(session.DecodeInterleaved(actual.data() + 2010 * channelCount, 990), 990U);
+
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialDecodeSessionTest, CanDeliverSeparatedChannels) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+
+    std::vector<float> expected(500 * 2);
+    decoder->DecodeInterleaved(expected.data(), 0, 500);
+
+    SequentialDecodeSession session(decoder, 0, 128);
+
+    std::vector<float> left(500), right(500);
+    for(std::size_t start = 0; start < 500; start += 100) {
+      float *buffers[] = { left.data() + start, right.data() + start };
+      ASSERT_EQ(session.DecodeSeparated(buffers, 100), 100U);
+    }
+
+    for(std::size_t index = 0; index < 500; ++index) {
+      EXPECT_EQ(left[index], expected[index * 2]);
+      EXPECT_EQ(right[index], expected[index * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialDecodeSessionTest, StopsAtEndOfTrack) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::uint64_t frameCount = decoder->CountFrames();
+
+    SequentialDecodeSession session(decoder, frameCount - 50, 64);
+
+    std::vector<float> samples(100 * decoder->CountChannels());
+    EXPECT_EQ(session.DecodeInterleaved(samples.data(), 100), 50U);
+    EXPECT_TRUE(session.IsAtEnd());
+    EXPECT_EQ(session.DecodeInterleaved(samples.data(), 100), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,264 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SequentialTrackDecoder.h"
+#include "Nuclex/Audio/Storage/SequentialSource.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Errors/UnsupportedFormatError.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Source that hands out a byte array in tiny pieces like a slow pipe</summary>
+  class TricklingSource : public Nuclex::Audio::Storage::SequentialSource {
+
+    /// <summary>Initializes a new trickling source</summary>
+    /// <param name="data">Data the source will deliver</param>
+    /// <param name="bytesPerRead">Maximum number of bytes delivered per read</param>
+    public: TricklingSource(const std::vector<std::byte> &data, std::size_t bytesPerRead) :
+      data(data),
+      bytesPerRead(bytesPerRead),
+      position(0) {}
+
+    /// <summary>Frees all resources owned by the source</summary>
+    public: ~TricklingSource() override = default;
+
+    /// <summary>Reads the next bytes from the source</summary>
+    /// <param name="buffer">Buffer that will receive the data</param>
+    /// <param name="byteCount">Maximum number of bytes that will be read</param>
+    /// <returns>The number of bytes that were read, zero at the end of the data</returns>
+    public: std::size_t ReadSome(std::byte *buffer, std::size_t byteCount) override {
+      std::size_t readByteCount = std::min(
+        std::min(byteCount, this->bytesPerRead), this->data.size() - this->position
+      );
+      if(readByteCount > 0) {
+        std::memcpy(buffer, this->data.data() + this->position, readByteCount);
+        this->position += readByteCount;
+      }
+      return readByteCount;
+    }
+
+    /// <summary>Data the source is delivering</summary>
+    private: std::vector<std::byte> data;
+    /// <summary>Maximum number of bytes delivered per read</summary>
+    private: std::size_t bytesPerRead;
+    /// <summary>Number of bytes that have already been delivered</summary>
+    private: std::size_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a four character code to a byte vector</summary>
+  /// <param name="bytes">Byte vector the four character code will be appended to</param>
+  /// <param name="fourCC">Four character code that will be appended</param>
+  void appendFourCC(std::vector<std::byte> &bytes, const char *fourCC) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      bytes.push_back(static_cast<std::byte>(fourCC[index]));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends an integer in little endian format to a byte vector</summary>
+  /// <param name="bytes">Byte vector the integer will be appended to</param>
+  /// <param name="value">Value that will be appended</param>
+  /// <param name="byteCount">Number of bytes the integer will occupy</param>
+  void appendLittleEndian(std::vector<std::byte> &bytes, std::uint32_t value, int byteCount) {
+    for(int index = 0; index < byteCount; ++index) {
+      bytes.push_back(static_cast<std::byte>(value >> (index * 8)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a 16 bit stereo waveform file as written by a streaming recorder</summary>
+  /// <param name="frameCount">Number of audio frames the file will contain</param>
+  /// <returns>The contents of the waveform file with unknown chunk lengths</returns>
+  std::vector<std::byte> buildStreamingWaveform(std::size_t frameCount) {
+    std::vector<std::byte> file;
+
+    appendFourCC(file, "RIFF");
+    appendLittleEndian(file, 0xFFFFFFFFU, 4);
+    appendFourCC(file, "WAVE");
+
+    appendFourCC(file, "fmt ");
+    appendLittleEndian(file, 16, 4);
+    appendLittleEndian(file, 1, 2); // PCM
+    appendLittleEndian(file, 2, 2); // channels
+    appendLittleEndian(file, 44100, 4);
+    appendLittleEndian(file, 44100 * 4, 4);
+    appendLittleEndian(file, 4, 2); // block alignment
+    appendLittleEndian(file, 16, 2); // bits per sample
+
+    appendFourCC(file, "data");
+    appendLittleEndian(file, 0xFFFFFFFFU, 4);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      appendLittleEndian(file, static_cast<std::uint16_t>(index * 16), 2);
+      appendLittleEndian(file, static_cast<std::uint16_t>(-static_cast<int>(index * 16)), 2);
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialTrackDecoderTest, RequiresSource) {
+    EXPECT_THROW(
+      SequentialTrackDecoder::Open(std::shared_ptr<SequentialSource>()),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      SequentialSource::FromVirtualFile(std::shared_ptr<const VirtualFile>()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialTrackDecoderTest, ReadFullyCollectsShortReads) {
+    std::vector<std::byte> data(100);
+    for(std::size_t index = 0; index < data.size(); ++index) {
+      data[index] = static_cast<std::byte>(index);
+    }
+
+    TricklingSource source(data, 7);
+
+    std::vector<std::byte> buffer(150);
+    EXPECT_EQ(source.ReadFully(buffer.data(), 40), 40U);
+    EXPECT_EQ(buffer[39], static_cast<std::byte>(39));
+    EXPECT_EQ(source.ReadFully(buffer.data(), 150), 60U);
+    EXPECT_EQ(buffer[59], static_cast<std::byte>(99));
+    EXPECT_EQ(source.ReadFully(buffer.data(), 150), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialTrackDecoderTest, RejectsUnknownFormat) {
+    std::vector<std::byte> garbage(256, static_cast<std::byte>(0x5A));
+    std::shared_ptr<SequentialSource> source = std::make_shared<TricklingSource>(garbage, 64);
+
+    EXPECT_THROW(
+      SequentialTrackDecoder::Open(source),
+      Errors::UnsupportedFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialTrackDecoderTest, DeliversSameSamplesAsSeekableDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    Waveform::WaveformTrackDecoder seekableDecoder(file);
+    std::size_t frameCount = static_cast<std::size_t>(seekableDecoder.CountFrames());
+    std::size_t channelCount = seekableDecoder.CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    seekableDecoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    std::unique_ptr<SequentialTrackDecoder> decoder = SequentialTrackDecoder::Open(
+      SequentialSource::FromVirtualFile(file)
+    );
+    ASSERT_EQ(decoder->CountChannels(), channelCount);
+    EXPECT_EQ(decoder->GetSampleRate(), 44100U);
+    ASSERT_TRUE(decoder->TryCountFrames().has_value());
+    EXPECT_EQ(decoder->TryCountFrames().value(), frameCount);
+
+    // Request odd amounts so the calls don't line up with any internal buffer size
+    std::vector<float> actual(frameCount * channelCount);
+    std::size_t decodedFrameCount = 0;
+    for(;;) {
+      std::size_t requestedFrameCount = std::min<std::size_t>(
+        777, frameCount - decodedFrameCount
+      );
+      std::size_t frames = decoder->DecodeInterleaved(
+        actual.data() + decodedFrameCount * channelCount, requestedFrameCount
+      );
+      if(frames == 0) {
+        break;
+      }
+      decodedFrameCount += frames;
+    }
+
+    EXPECT_EQ(decodedFrameCount, frameCount);
+    EXPECT_EQ(decoder->GetFrameCursorPosition(), frameCount);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SequentialTrackDecoderTest, DecodesWaveformWithUnknownLength) {
+    const std::size_t frameCount = 1000;
+    std::shared_ptr<SequentialSource> source = std::make_shared<TricklingSource>(
+      buildStreamingWaveform(frameCount), 7
+    );
+
+    std::unique_ptr<SequentialTrackDecoder> decoder = SequentialTrackDecoder::Open(source);
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+    EXPECT_EQ(decoder->GetSampleRate(), 44100U);
+    EXPECT_FALSE(decoder->TryCountFrames().has_value());
+
+    std::vector<float> samples(frameCount * 2 + 64);
+    std::size_t decodedFrameCount = 0;
+    for(;;) {
+      std::size_t frames = decoder->DecodeInterleaved(
+        samples.data() + decodedFrameCount * 2, 32
+      );
+      if(frames == 0) {
+        break;
+      }
+      decodedFrameCount += frames;
+    }
+
+    ASSERT_EQ(decodedFrameCount, frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      float left = static_cast<float>(static_cast<std::int16_t>(index * 16)) / 32768.0f;
+      float right = static_cast<float>(
+        static_cast<std::int16_t>(-static_cast<int>(index * 16))
+      ) / 32768.0f;
+      EXPECT_NEAR(samples[index * 2], left, 0.0001f);
+      EXPECT_NEAR(samples[index * 2 + 1], right, 0.0001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
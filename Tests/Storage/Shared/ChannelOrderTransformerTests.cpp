@@ -27,6 +27,7 @@ limitations under the License.
 #include <gtest/gtest.h>
 
 #include <cstdint> // for std::uint8_t
+#include <stdexcept> // for std::invalid_argument
 
 namespace {
 
@@ -192,5 +193,68 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(ChannelOrderTransformerTests, CanCreateRemappingTable) {
+    std::vector<ChannelPlacement> vorbisOrder = {
+      ChannelPlacement::FrontLeft,
+      ChannelPlacement::FrontCenter,
+      ChannelPlacement::FrontRight,
+      ChannelPlacement::BackLeft,
+      ChannelPlacement::BackRight,
+      ChannelPlacement::LowFrequencyEffects
+    };
+    std::vector<ChannelPlacement> waveformatExtensibleOrder = {
+      ChannelPlacement::FrontLeft,
+      ChannelPlacement::FrontRight,
+      ChannelPlacement::FrontCenter,
+      ChannelPlacement::LowFrequencyEffects,
+      ChannelPlacement::BackLeft,
+      ChannelPlacement::BackRight
+    };
+
+    std::vector<std::size_t> inputChannelLookup = (
+      ChannelOrderTransformer::CreateRemappingTable(vorbisOrder, waveformatExtensibleOrder)
+    );
+
+    ASSERT_EQ(inputChannelLookup.size(), 6U);
+    EXPECT_EQ(inputChannelLookup[0], 0U);
+    EXPECT_EQ(inputChannelLookup[1], 2U);
+    EXPECT_EQ(inputChannelLookup[2], 1U);
+    EXPECT_EQ(inputChannelLookup[3], 5U);
+    EXPECT_EQ(inputChannelLookup[4], 3U);
+    EXPECT_EQ(inputChannelLookup[5], 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelOrderTransformerTests, RemappingTableRequiresSameChannels) {
+    std::vector<ChannelPlacement> stereo = {
+      ChannelPlacement::FrontLeft,
+      ChannelPlacement::FrontRight
+    };
+    std::vector<ChannelPlacement> mono = {
+      ChannelPlacement::FrontCenter
+    };
+    std::vector<ChannelPlacement> sides = {
+      ChannelPlacement::SideLeft,
+      ChannelPlacement::SideRight
+    };
+    std::vector<ChannelPlacement> duplicated = {
+      ChannelPlacement::FrontLeft,
+      ChannelPlacement::FrontLeft
+    };
+
+    EXPECT_THROW(
+      ChannelOrderTransformer::CreateRemappingTable(stereo, mono), std::invalid_argument
+    );
+    EXPECT_THROW(
+      ChannelOrderTransformer::CreateRemappingTable(stereo, sides), std::invalid_argument
+    );
+    EXPECT_THROW(
+      ChannelOrderTransformer::CreateRemappingTable(duplicated, stereo), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Shared
 
@@ -0,0 +1,132 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/ChannelRemapper.h"
+#include "../../../Source/Storage/Shared/ChannelOrderTransformer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::int16_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks a remapper against the result of the generic gather loop</summary>
+  /// <param name="inputChannelLookup">Remapping table the remapper will be given</param>
+  /// <param name="expectSpecialized">Whether a specialized kernel should be picked</param>
+  void checkRemapper(
+    const std::vector<std::size_t> &inputChannelLookup, bool expectSpecialized
+  ) {
+    using Nuclex::Audio::Storage::Shared::ChannelRemapper;
+
+    const std::size_t frameCount = 37;
+    std::size_t channelCount = inputChannelLookup.size();
+
+    std::vector<float> floatSource(frameCount * channelCount);
+    std::vector<std::int16_t> integerSource(frameCount * channelCount);
+    for(std::size_t index = 0; index < floatSource.size(); ++index) {
+      floatSource[index] = static_cast<float>(index);
+      integerSource[index] = static_cast<std::int16_t>(index);
+    }
+
+    ChannelRemapper remapper(inputChannelLookup);
+    EXPECT_EQ(remapper.IsSpecialized(), expectSpecialized);
+
+    std::vector<float> floatTarget(floatSource.size());
+    std::vector<std::int16_t> integerTarget(integerSource.size());
+    remapper.RemapInterleaved(floatSource.data(), floatTarget.data(), frameCount);
+    remapper.RemapInterleaved(integerSource.data(), integerTarget.data(), frameCount);
+
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        std::size_t targetIndex = frameIndex * channelCount + channelIndex;
+        std::size_t sourceIndex = (
+          frameIndex * channelCount + inputChannelLookup[channelIndex]
+        );
+        EXPECT_EQ(floatTarget[targetIndex], floatSource[sourceIndex]);
+        EXPECT_EQ(integerTarget[targetIndex], integerSource[sourceIndex]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelRemapperTest, IdentityTablesAreCopied) {
+    checkRemapper({ 0, 1 }, true);
+    checkRemapper({ 0, 1, 2, 3, 4, 5 }, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelRemapperTest, KnownPermutationsUseSpecializedKernels) {
+    checkRemapper({ 1, 0 }, true);
+    checkRemapper({ 0, 2, 1 }, true);
+    checkRemapper({ 0, 2, 1, 4, 5, 3 }, true);
+    checkRemapper({ 0, 2, 1, 5, 3, 4 }, true);
+    checkRemapper({ 0, 2, 1, 6, 7, 4, 5, 3 }, true);
+    checkRemapper({ 0, 2, 1, 7, 5, 6, 3, 4 }, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelRemapperTest, ExoticPermutationsUseGenericLoop) {
+    checkRemapper({ 3, 2, 1, 0 }, false);
+    checkRemapper({ 5, 4, 3, 2, 1, 0 }, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChannelRemapperTest, WaveformatToVorbisSurroundIsSpecialized) {
+    std::vector<ChannelPlacement> waveformatOrder = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight,
+      ChannelPlacement::FrontCenter, ChannelPlacement::LowFrequencyEffects,
+      ChannelPlacement::BackLeft, ChannelPlacement::BackRight,
+      ChannelPlacement::SideLeft, ChannelPlacement::SideRight
+    };
+    std::vector<ChannelPlacement> vorbisOrder = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::FrontCenter,
+      ChannelPlacement::FrontRight, ChannelPlacement::SideLeft,
+      ChannelPlacement::SideRight, ChannelPlacement::BackLeft,
+      ChannelPlacement::BackRight, ChannelPlacement::LowFrequencyEffects
+    };
+
+    ChannelRemapper toVorbis(
+      ChannelOrderTransformer::CreateRemappingTable(waveformatOrder, vorbisOrder)
+    );
+    EXPECT_TRUE(toVorbis.IsSpecialized());
+
+    ChannelRemapper toWaveformat(
+      ChannelOrderTransformer::CreateRemappingTable(vorbisOrder, waveformatOrder)
+    );
+    EXPECT_TRUE(toWaveformat.IsSpecialized());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
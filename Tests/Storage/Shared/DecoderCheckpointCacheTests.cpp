@@ -0,0 +1,95 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/DecoderCheckpoint.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecoderCheckpointCacheTest, FirstSeekIsNotRepeated) {
+    DecoderCheckpointCache cache(4);
+    EXPECT_FALSE(cache.NoteSeek(44100));
+    EXPECT_TRUE(cache.NoteSeek(44100));
+    EXPECT_FALSE(cache.NoteSeek(88200));
+    EXPECT_EQ(cache.TryFindCheckpoint(44100), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecoderCheckpointCacheTest, FindsCheckpointForExactFrameOnly) {
+    DecoderCheckpointCache cache(4);
+    cache.AddCheckpoint(DecoderCheckpoint { 44100, 40000, 12345, true });
+
+    const DecoderCheckpoint *checkpoint = cache.TryFindCheckpoint(44100);
+    ASSERT_NE(checkpoint, nullptr);
+    EXPECT_EQ(checkpoint->ResumeFrameIndex, 40000U);
+    EXPECT_EQ(checkpoint->ByteOffset, 12345U);
+    EXPECT_TRUE(checkpoint->IsDirect);
+
+    EXPECT_EQ(cache.TryFindCheckpoint(44099), nullptr);
+    EXPECT_EQ(cache.TryFindCheckpoint(44101), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecoderCheckpointCacheTest, CheckpointCompletesNotedSeek) {
+    DecoderCheckpointCache cache(2);
+    EXPECT_FALSE(cache.NoteSeek(1000));
+    EXPECT_FALSE(cache.NoteSeek(2000));
+    cache.AddCheckpoint(DecoderCheckpoint { 1000, 500, 64, true });
+
+    // The checkpoint should have gone into the noted entry, not replaced another one
+    EXPECT_NE(cache.TryFindCheckpoint(1000), nullptr);
+    EXPECT_TRUE(cache.NoteSeek(2000));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecoderCheckpointCacheTest, OldestEntryIsReplacedWhenFull) {
+    DecoderCheckpointCache cache(2);
+    cache.AddCheckpoint(DecoderCheckpoint { 1000, 1000, 0, false });
+    cache.AddCheckpoint(DecoderCheckpoint { 2000, 2000, 0, false });
+    cache.AddCheckpoint(DecoderCheckpoint { 3000, 3000, 0, false });
+
+    EXPECT_EQ(cache.TryFindCheckpoint(1000), nullptr);
+    EXPECT_NE(cache.TryFindCheckpoint(2000), nullptr);
+    EXPECT_NE(cache.TryFindCheckpoint(3000), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DecoderCheckpointCacheTest, CanBeCleared) {
+    DecoderCheckpointCache cache(4);
+    cache.AddCheckpoint(DecoderCheckpoint { 44100, 40000, 12345, true });
+    EXPECT_FALSE(cache.NoteSeek(88200));
+
+    cache.Clear();
+    EXPECT_EQ(cache.TryFindCheckpoint(44100), nullptr);
+    EXPECT_FALSE(cache.NoteSeek(88200));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,139 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/EncoderCpuGovernor.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reports one second of audio that took the specified time to encode</summary>
+  /// <param name="governor">Governor to which the encoding time will be reported</param>
+  /// <param name="cpuFraction">Fraction of a CPU core the audio took to encode</param>
+  /// <returns>True if the governor changed any setting</returns>
+  bool recordSecond(
+    Nuclex::Audio::Storage::Shared::EncoderCpuGovernor &governor, double cpuFraction
+  ) {
+    bool isChanged = false;
+    for(std::size_t block = 0; block < 10; ++block) {
+      isChanged |= governor.Record(
+        std::chrono::nanoseconds(static_cast<std::int64_t>(cpuFraction * 1e8)), 4800
+      );
+    }
+    return isChanged;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EncoderCpuGovernorTest, RequiresPositiveBudget) {
+    EncoderCpuBudget budget = { 0.0f, false, false };
+    EXPECT_THROW(
+      EncoderCpuGovernor(budget, 48000, 10, 128.0f, { 20.0f }),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EncoderCpuGovernorTest, StaysPutWithinBudget) {
+    EncoderCpuBudget budget = { 0.1f, true, true };
+    EncoderCpuGovernor governor(budget, 48000, 10, 128.0f, { 20.0f, 40.0f });
+
+    for(std::size_t second = 0; second < 10; ++second) {
+      EXPECT_FALSE(recordSecond(governor, 0.08));
+    }
+
+    EncoderCpuMetrics metrics = governor.GetMetrics();
+    EXPECT_EQ(governor.GetComplexity(), 10U);
+    EXPECT_FLOAT_EQ(metrics.Effort, 1.0f);
+    EXPECT_NEAR(metrics.MeasuredCpuFraction, 0.08f, 0.001f);
+    EXPECT_EQ(metrics.AdjustmentCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EncoderCpuGovernorTest, LowersComplexityBeforeAnythingElse) {
+    EncoderCpuBudget budget = { 0.1f, true, true };
+    EncoderCpuGovernor governor(budget, 48000, 10, 128.0f, { 20.0f, 40.0f });
+
+    EXPECT_TRUE(recordSecond(governor, 0.12));
+    EXPECT_LT(governor.GetComplexity(), 10U);
+    EXPECT_EQ(governor.GetFrameDurationIndex(), 0U);
+    EXPECT_FLOAT_EQ(governor.GetKilobitsPerSecond(), 128.0f);
+
+    // Once complexity is exhausted, longer frames and then the bitrate are next
+    for(std::size_t second = 0; second < 20; ++second) {
+      recordSecond(governor, 0.5);
+    }
+    EXPECT_EQ(governor.GetComplexity(), 0U);
+    EXPECT_EQ(governor.GetFrameDurationIndex(), 1U);
+    EXPECT_FLOAT_EQ(governor.GetKilobitsPerSecond(), 64.0f);
+    EXPECT_FLOAT_EQ(governor.GetMetrics().FrameMilliseconds, 40.0f);
+    EXPECT_NEAR(governor.GetMetrics().PeakCpuFraction, 0.5f, 0.001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EncoderCpuGovernorTest, KeepsQualitySettingsUnlessAllowed) {
+    EncoderCpuBudget budget = { 0.1f, false, false };
+    EncoderCpuGovernor governor(budget, 48000, 10, 128.0f, { 20.0f, 40.0f });
+
+    for(std::size_t second = 0; second < 20; ++second) {
+      recordSecond(governor, 0.5);
+    }
+    EXPECT_EQ(governor.GetComplexity(), 0U);
+    EXPECT_EQ(governor.GetFrameDurationIndex(), 0U);
+    EXPECT_FLOAT_EQ(governor.GetKilobitsPerSecond(), 128.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EncoderCpuGovernorTest, RestoresConfiguredSettingsWithHeadroom) {
+    EncoderCpuBudget budget = { 0.1f, true, true };
+    EncoderCpuGovernor governor(budget, 48000, 8, 128.0f, { 20.0f, 40.0f });
+
+    for(std::size_t second = 0; second < 20; ++second) {
+      recordSecond(governor, 0.5);
+    }
+    ASSERT_EQ(governor.GetComplexity(), 0U);
+
+    for(std::size_t second = 0; second < 100; ++second) {
+      recordSecond(governor, 0.01);
+    }
+    EXPECT_EQ(governor.GetComplexity(), 8U);
+    EXPECT_EQ(governor.GetFrameDurationIndex(), 0U);
+    EXPECT_FLOAT_EQ(governor.GetKilobitsPerSecond(), 128.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,112 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/GainTagParser.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, NoTagsMeanNoGain) {
+    GainTagParser parser;
+    parser.ProcessComment(u8"TITLE=Overworld");
+    parser.ProcessComment(u8"REPLAYGAIN_TRACK_PEAK=0.5");
+    EXPECT_FALSE(parser.GetReplayGain().has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, ReplayGainTagsAreUnderstood) {
+    GainTagParser parser;
+    parser.ProcessComment(u8"replaygain_track_gain=-6.48 dB");
+    parser.ProcessComment(u8"REPLAYGAIN_TRACK_PEAK= 0.988547 ");
+    parser.ProcessComment(u8"REPLAYGAIN_ALBUM_GAIN=+1.5dB");
+
+    std::optional<ReplayGainInfo> replayGain = parser.GetReplayGain();
+    ASSERT_TRUE(replayGain.has_value());
+    ASSERT_TRUE(replayGain->TrackGain.has_value());
+    EXPECT_FLOAT_EQ(replayGain->TrackGain.value(), -6.48f);
+    ASSERT_TRUE(replayGain->TrackPeak.has_value());
+    EXPECT_FLOAT_EQ(replayGain->TrackPeak.value(), 0.988547f);
+    ASSERT_TRUE(replayGain->AlbumGain.has_value());
+    EXPECT_FLOAT_EQ(replayGain->AlbumGain.value(), 1.5f);
+    EXPECT_FALSE(replayGain->AlbumPeak.has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, R128GainsOverrideReplayGain) {
+    GainTagParser parser;
+    parser.ProcessComment(u8"REPLAYGAIN_TRACK_GAIN=-3.00 dB");
+    parser.ProcessComment(u8"R128_TRACK_GAIN=-1536");
+
+    std::optional<ReplayGainInfo> replayGain = parser.GetReplayGain();
+    ASSERT_TRUE(replayGain.has_value());
+    ASSERT_TRUE(replayGain->TrackGain.has_value());
+    EXPECT_FLOAT_EQ(replayGain->TrackGain.value(), -1.0f); // -6 dB at -23 LUFS
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, MalformedValuesAreIgnored) {
+    GainTagParser parser;
+    parser.ProcessComment(u8"REPLAYGAIN_TRACK_GAIN=loud");
+    parser.ProcessComment(u8"REPLAYGAIN_ALBUM_GAIN=1,5 dB");
+    parser.ProcessComment(u8"R128_TRACK_GAIN=-1.5");
+    parser.ProcessComment(u8"R128_ALBUM_GAIN=99999");
+    EXPECT_FALSE(parser.GetReplayGain().has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, GainIsLimitedByPeak) {
+    ReplayGainInfo replayGain;
+    replayGain.TrackGain = 12.0f;
+    replayGain.TrackPeak = 0.5f;
+    replayGain.AlbumGain = -4.0f;
+    replayGain.AlbumPeak = 0.5f;
+
+    std::optional<ReplayGainInfo> stored(replayGain);
+    EXPECT_NEAR(GainTagParser::GetGainDecibels(stored, ReplayGainMode::Track), 6.0206f, 0.001f);
+    EXPECT_FLOAT_EQ(GainTagParser::GetGainDecibels(stored, ReplayGainMode::Album), -4.0f);
+    EXPECT_FLOAT_EQ(GainTagParser::GetGainDecibels(stored, ReplayGainMode::Off), 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(GainTagParserTest, AlbumModeFallsBackToTrackGain) {
+    ReplayGainInfo replayGain;
+    replayGain.TrackGain = -2.5f;
+
+    std::optional<ReplayGainInfo> stored(replayGain);
+    EXPECT_FLOAT_EQ(GainTagParser::GetGainDecibels(stored, ReplayGainMode::Album), -2.5f);
+    EXPECT_FLOAT_EQ(
+      GainTagParser::GetGainDecibels(std::optional<ReplayGainInfo>(), ReplayGainMode::Track),
+      0.0f
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,76 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/LoopTagParser.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopTagParserTest, NoTagsMeanNoLoop) {
+    LoopTagParser parser;
+    parser.ProcessComment(u8"TITLE=Overworld");
+    EXPECT_FALSE(parser.GetLoop(44100).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopTagParserTest, LoopStartAndLengthAreUnderstood) {
+    LoopTagParser parser;
+    parser.ProcessComment(u8"LoopStart=1000");
+    parser.ProcessComment(u8"LOOPLENGTH= 2000 ");
+
+    std::optional<LoopRegion> loop = parser.GetLoop(44100);
+    ASSERT_TRUE(loop.has_value());
+    EXPECT_EQ(loop->StartFrame, 1000U);
+    EXPECT_EQ(loop->EndFrame, 3000U);
+    EXPECT_EQ(loop->PlayCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopTagParserTest, LoopEndIsClampedToTrackLength) {
+    LoopTagParser parser;
+    parser.ProcessComment(u8"LOOPSTART=1000");
+    parser.ProcessComment(u8"LOOPEND=99999");
+
+    std::optional<LoopRegion> loop = parser.GetLoop(44100);
+    ASSERT_TRUE(loop.has_value());
+    EXPECT_EQ(loop->EndFrame, 44100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LoopTagParserTest, MalformedValuesAreIgnored) {
+    LoopTagParser parser;
+    parser.ProcessComment(u8"LOOPSTART=soon");
+    EXPECT_FALSE(parser.GetLoop(44100).has_value());
+
+    parser.ProcessComment(u8"LOOPSTART=50000");
+    EXPECT_FALSE(parser.GetLoop(44100).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
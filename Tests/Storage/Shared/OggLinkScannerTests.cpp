@@ -0,0 +1,229 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/OggLinkScanner.h"
+#include "../../../Source/Storage/ConcatenatedFile.h"
+
+#include "../ByteArrayAsFile.h"
+#include "../ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a dummy Ogg page to a buffer</summary>
+  /// <param name="stream">Buffer the page will be appended to</param>
+  /// <param name="serialNumber">Serial number of the logical stream the page belongs to</param>
+  /// <param name="headerType">Header type flags of the page</param>
+  /// <param name="granulePosition">Granule position stored in the page</param>
+  /// <param name="bodyLength">Number of bytes in the page's body</param>
+  /// <returns>The offset at which the page was written into the buffer</returns>
+  std::uint64_t appendPage(
+    std::vector<std::byte> &stream, std::uint32_t serialNumber,
+    std::uint8_t headerType, std::uint64_t granulePosition, std::size_t bodyLength
+  ) {
+    std::uint64_t pageOffset = stream.size();
+
+    const char capturePattern[] = { 'O', 'g', 'g', 'S' };
+    for(char character : capturePattern) {
+      stream.push_back(static_cast<std::byte>(character));
+    }
+    stream.push_back(std::byte(0)); // version
+    stream.push_back(static_cast<std::byte>(headerType));
+    for(std::size_t index = 0; index < 8; ++index) {
+      stream.push_back(static_cast<std::byte>(granulePosition >> (index * 8)));
+    }
+    for(std::size_t index = 0; index < 4; ++index) {
+      stream.push_back(static_cast<std::byte>(serialNumber >> (index * 8)));
+    }
+    for(std::size_t index = 0; index < 8; ++index) {
+      stream.push_back(std::byte(0)); // page sequence number and CRC, not checked
+    }
+
+    std::size_t segmentCount = bodyLength / 255 + 1;
+    stream.push_back(static_cast<std::byte>(segmentCount));
+    for(std::size_t index = 0; index < segmentCount - 1; ++index) {
+      stream.push_back(std::byte(255));
+    }
+    stream.push_back(static_cast<std::byte>(bodyLength % 255));
+
+    stream.resize(stream.size() + bodyLength, std::byte(0xCD));
+    return pageOffset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a complete dummy Ogg stream with headers and audio pages</summary>
+  /// <param name="stream">Buffer the Ogg stream will be appended to</param>
+  /// <param name="serialNumber">Serial number of the logical stream</param>
+  /// <param name="audioPageCount">Number of audio pages that will be appended</param>
+  void appendLink(
+    std::vector<std::byte> &stream, std::uint32_t serialNumber, std::size_t audioPageCount
+  ) {
+    appendPage(stream, serialNumber, 0x02, 0, 19); // beginning-of-stream
+    appendPage(stream, serialNumber, 0x00, 0, 600); // comment and setup headers
+    for(std::size_t index = 0; index < audioPageCount; ++index) {
+      std::uint8_t headerType = (index + 1 == audioPageCount) ? 0x04 : 0x00;
+      appendPage(stream, serialNumber, headerType, (index + 1) * 1000, 300);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, FindsLinksOfChainedStream) {
+    std::vector<std::byte> stream;
+    appendLink(stream, 0x1111, 5);
+    std::uint64_t secondLinkOffset = stream.size();
+    appendLink(stream, 0x2222, 8);
+    std::uint64_t thirdLinkOffset = stream.size();
+    appendLink(stream, 0x1111, 3); // Serial numbers may repeat in later links
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    std::vector<OggLinkScanner::Link> links = OggLinkScanner::ScanLinks(file);
+    ASSERT_EQ(links.size(), 3U);
+
+    EXPECT_EQ(links[0].StartOffset, 0U);
+    EXPECT_EQ(links[0].Length, secondLinkOffset);
+    EXPECT_EQ(links[0].SerialNumber, 0x1111U);
+    EXPECT_EQ(links[0].LastGranulePosition, 5000U);
+
+    EXPECT_EQ(links[1].StartOffset, secondLinkOffset);
+    EXPECT_EQ(links[1].Length, thirdLinkOffset - secondLinkOffset);
+    EXPECT_EQ(links[1].SerialNumber, 0x2222U);
+    EXPECT_EQ(links[1].LastGranulePosition, 8000U);
+
+    EXPECT_EQ(links[2].StartOffset, thirdLinkOffset);
+    EXPECT_EQ(links[2].Length, stream.size() - thirdLinkOffset);
+    EXPECT_EQ(links[2].LastGranulePosition, 3000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, MultiplexedStreamsFormSingleLink) {
+    std::vector<std::byte> stream;
+    appendPage(stream, 0xA, 0x02, 0, 19);
+    appendPage(stream, 0xB, 0x02, 0, 42);
+    appendPage(stream, 0xA, 0x00, 1000, 300);
+    appendPage(stream, 0xB, 0x00, 77, 300);
+    appendPage(stream, 0xA, 0x04, 2000, 300); // First stream ends, second one goes on
+    appendPage(stream, 0xB, 0x04, 99, 300);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    std::vector<OggLinkScanner::Link> links = OggLinkScanner::ScanLinks(file);
+    ASSERT_EQ(links.size(), 1U);
+    EXPECT_EQ(links[0].Length, stream.size());
+    EXPECT_EQ(links[0].SerialNumber, 0xAU);
+    EXPECT_EQ(links[0].LastGranulePosition, 2000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, NewLinkBeginsEvenIfEndOfStreamWasMissing) {
+    std::vector<std::byte> stream;
+    appendPage(stream, 0x1, 0x02, 0, 19);
+    appendPage(stream, 0x1, 0x00, 1000, 300); // no end-of-stream flag
+    std::uint64_t secondLinkOffset = stream.size();
+    appendLink(stream, 0x2, 2);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    std::vector<OggLinkScanner::Link> links = OggLinkScanner::ScanLinks(file);
+    ASSERT_EQ(links.size(), 2U);
+    EXPECT_EQ(links[0].Length, secondLinkOffset);
+    EXPECT_EQ(links[1].StartOffset, secondLinkOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, TruncatedLinkEndsAtLastCompletePage) {
+    std::vector<std::byte> stream;
+    appendLink(stream, 0x1, 2);
+    std::uint64_t secondLinkOffset = stream.size();
+    appendLink(stream, 0x2, 4);
+    std::uint64_t fullLength = stream.size();
+    stream.resize(stream.size() - 100); // cut off the end of the final page
+
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    std::vector<OggLinkScanner::Link> links = OggLinkScanner::ScanLinks(file);
+    ASSERT_EQ(links.size(), 2U);
+    EXPECT_EQ(links[1].StartOffset, secondLinkOffset);
+    EXPECT_LT(links[1].Length, fullLength - secondLinkOffset);
+    EXPECT_EQ(links[1].LastGranulePosition, 3000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, SingleLinkFileIsOpenedDirectly) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg"
+    );
+
+    std::vector<OggLinkScanner::Link> links = OggLinkScanner::ScanLinks(*file);
+    ASSERT_EQ(links.size(), 1U);
+    EXPECT_EQ(links[0].StartOffset, 0U);
+    EXPECT_EQ(links[0].Length, file->GetSize());
+
+    std::vector<std::shared_ptr<const VirtualFile>> linkFiles = OggLinkScanner::OpenLinks(file);
+    ASSERT_EQ(linkFiles.size(), 1U);
+    EXPECT_EQ(linkFiles[0], file);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggLinkScannerTest, ChainedFilesAreSplitIntoLinks) {
+    std::shared_ptr<const VirtualFile> first = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg"
+    );
+    std::shared_ptr<const VirtualFile> second = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"opus-5dot1-v152.opus"
+    );
+    std::shared_ptr<const VirtualFile> chained = std::make_shared<ConcatenatedFile>(
+      std::vector<std::shared_ptr<const VirtualFile>> { first, second }
+    );
+
+    std::vector<std::shared_ptr<const VirtualFile>> linkFiles = OggLinkScanner::OpenLinks(
+      chained
+    );
+    ASSERT_EQ(linkFiles.size(), 2U);
+    EXPECT_EQ(linkFiles[0]->GetSize(), first->GetSize());
+    EXPECT_EQ(linkFiles[1]->GetSize(), second->GetSize());
+
+    std::byte firstLinkHeader[4], secondLinkHeader[4];
+    linkFiles[0]->ReadAt(0, 4, firstLinkHeader);
+    linkFiles[1]->ReadAt(0, 4, secondLinkHeader);
+    EXPECT_EQ(firstLinkHeader[0], std::byte('O'));
+    EXPECT_EQ(secondLinkHeader[0], std::byte('O'));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
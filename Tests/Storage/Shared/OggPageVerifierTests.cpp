@@ -0,0 +1,161 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/OggPageVerifier.h"
+
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+
+#include "../ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a dummy Ogg page with a correct CRC to a buffer</summary>
+  /// <param name="stream">Buffer the page will be appended to</param>
+  /// <param name="headerType">Header type flags of the page</param>
+  /// <param name="bodyLength">Number of bytes in the page's body</param>
+  void appendPage(std::vector<std::byte> &stream, std::uint8_t headerType, std::size_t bodyLength) {
+    std::size_t pageOffset = stream.size();
+
+    const char capturePattern[] = { 'O', 'g', 'g', 'S' };
+    for(char character : capturePattern) {
+      stream.push_back(static_cast<std::byte>(character));
+    }
+    stream.push_back(std::byte(0)); // version
+    stream.push_back(static_cast<std::byte>(headerType));
+    for(std::size_t index = 0; index < 20; ++index) {
+      stream.push_back(std::byte(index)); // granule, serial, sequence number, CRC
+    }
+
+    std::size_t segmentCount = bodyLength / 255 + 1;
+    stream.push_back(static_cast<std::byte>(segmentCount));
+    for(std::size_t index = 0; index < segmentCount - 1; ++index) {
+      stream.push_back(std::byte(255));
+    }
+    stream.push_back(static_cast<std::byte>(bodyLength % 255));
+
+    for(std::size_t index = 0; index < bodyLength; ++index) {
+      stream.push_back(static_cast<std::byte>(index * 7));
+    }
+
+    std::uint32_t crc = Nuclex::Audio::Storage::Shared::OggPageVerifier::CalculatePageCrc(
+      stream.data() + pageOffset, stream.size() - pageOffset
+    );
+    for(std::size_t index = 0; index < 4; ++index) {
+      stream[pageOffset + 22 + index] = static_cast<std::byte>(crc >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a dummy Ogg stream in which every page has a correct CRC</summary>
+  /// <returns>The dummy Ogg stream</returns>
+  std::vector<std::byte> makeStream() {
+    std::vector<std::byte> stream;
+    appendPage(stream, 0x02, 19); // beginning-of-stream
+    appendPage(stream, 0x00, 600);
+    appendPage(stream, 0x00, 300);
+    appendPage(stream, 0x04, 1000); // end-of-stream
+    return stream;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggPageVerifierTest, CalculatesReferenceCrc) {
+    const char data[] = "123456789";
+
+    // Bit-by-bit CRC-32 with the Ogg polynomial, no initial value and no final inversion.
+    // The CRC field at bytes 22 through 25 is left at zero, as the verifier treats it.
+    std::vector<std::byte> page(26, std::byte(0));
+    for(std::size_t index = 0; index < 9; ++index) {
+      page[index] = static_cast<std::byte>(data[index]);
+    }
+
+    std::uint32_t referenceCrc = 0;
+    for(std::size_t index = 0; index < page.size(); ++index) {
+      referenceCrc ^= static_cast<std::uint32_t>(page[index]) << 24;
+      for(std::size_t bit = 0; bit < 8; ++bit) {
+        referenceCrc = (referenceCrc << 1) ^ (((referenceCrc >> 31) != 0) ? 0x04c11db7U : 0U);
+      }
+    }
+
+    EXPECT_EQ(OggPageVerifier::CalculatePageCrc(page.data(), page.size()), referenceCrc);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggPageVerifierTest, AcceptsIntactStream) {
+    std::vector<std::byte> stream = makeStream();
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    CancellationToken cancellation;
+    EXPECT_EQ(OggPageVerifier::VerifyPages(file, cancellation), VerificationResult::Passed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggPageVerifierTest, DetectsCorruptedPage) {
+    std::vector<std::byte> stream = makeStream();
+    stream[stream.size() - 500] ^= std::byte(0x10);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    CancellationToken cancellation;
+    EXPECT_EQ(OggPageVerifier::VerifyPages(file, cancellation), VerificationResult::Failed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggPageVerifierTest, DetectsTruncatedStream) {
+    std::vector<std::byte> stream = makeStream();
+    ByteArrayAsFile file(stream.data(), stream.size() - 1);
+
+    CancellationToken cancellation;
+    EXPECT_EQ(OggPageVerifier::VerifyPages(file, cancellation), VerificationResult::Failed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggPageVerifierTest, ReportsCancellation) {
+    std::vector<std::byte> stream = makeStream();
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    CancellationToken cancellation;
+    cancellation.Cancel();
+    EXPECT_EQ(
+      OggPageVerifier::VerifyPages(file, cancellation), VerificationResult::NotChecked
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
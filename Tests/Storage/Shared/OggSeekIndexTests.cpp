@@ -0,0 +1,236 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/OggSeekIndex.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "../ByteArrayAsFile.h"
+
+#include <gtest/gtest.h>
+
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a dummy Ogg page to a buffer</summary>
+  /// <param name="stream">Buffer the page will be appended to</param>
+  /// <param name="headerType">Header type flags of the page</param>
+  /// <param name="granulePosition">Granule position stored in the page</param>
+  /// <param name="bodyLength">Number of bytes in the page's body</param>
+  /// <returns>The offset at which the page was written into the buffer</returns>
+  std::uint64_t appendPage(
+    std::vector<std::byte> &stream,
+    std::uint8_t headerType, std::uint64_t granulePosition, std::size_t bodyLength
+  ) {
+    std::uint64_t pageOffset = stream.size();
+
+    const char capturePattern[] = { 'O', 'g', 'g', 'S' };
+    for(char character : capturePattern) {
+      stream.push_back(static_cast<std::byte>(character));
+    }
+    stream.push_back(std::byte(0)); // version
+    stream.push_back(static_cast<std::byte>(headerType));
+    for(std::size_t index = 0; index < 8; ++index) {
+      stream.push_back(static_cast<std::byte>(granulePosition >> (index * 8)));
+    }
+    for(std::size_t index = 0; index < 4; ++index) {
+      stream.push_back(std::byte(0x5A)); // serial number
+    }
+    for(std::size_t index = 0; index < 8; ++index) {
+      stream.push_back(std::byte(0)); // page sequence number and CRC, not checked
+    }
+
+    std::size_t segmentCount = bodyLength / 255 + 1;
+    stream.push_back(static_cast<std::byte>(segmentCount));
+    for(std::size_t index = 0; index < segmentCount - 1; ++index) {
+      stream.push_back(std::byte(255));
+    }
+    stream.push_back(static_cast<std::byte>(bodyLength % 255));
+
+    stream.resize(stream.size() + bodyLength, std::byte(0xCD));
+    return pageOffset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a dummy Ogg stream with headers and 20 audio pages</summary>
+  /// <param name="stream">Buffer that will receive the stream</param>
+  /// <param name="audioPageOffsets">Receives the offsets of the audio pages</param>
+  void buildStream(std::vector<std::byte> &stream, std::vector<std::uint64_t> &audioPageOffsets) {
+    appendPage(stream, 0x02, 0, 19); // beginning-of-stream, identification header
+    appendPage(stream, 0x00, 0, 600); // comment and setup headers
+
+    for(std::size_t index = 0; index < 20; ++index) {
+      std::uint8_t headerType = (index == 19) ? 0x04 : 0x00;
+      audioPageOffsets.push_back(appendPage(stream, headerType, (index + 1) * 1000, 300));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, IndexesPagesAtInterval) {
+    std::vector<std::byte> stream;
+    std::vector<std::uint64_t> audioPageOffsets;
+    buildStream(stream, audioPageOffsets);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 2500);
+    index.ScanUntil(file, stream.size());
+    EXPECT_TRUE(index.IsComplete());
+
+    // The first entry points at the second audio page, then every third page follows
+    EXPECT_EQ(index.CountEntries(), 7U);
+    EXPECT_FALSE(index.TryFindEntry(999).has_value());
+
+    std::optional<OggSeekIndex::Entry> entry = index.TryFindEntry(5500);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry.value().GranulePosition, 4000U);
+    EXPECT_EQ(entry.value().ByteOffset, audioPageOffsets[4]);
+
+    entry = index.TryFindEntry(1000);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry.value().GranulePosition, 1000U);
+    EXPECT_EQ(entry.value().ByteOffset, audioPageOffsets[1]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, PagesContinuingPacketsAreNotIndexed) {
+    std::vector<std::byte> stream;
+    appendPage(stream, 0x02, 0, 19);
+    appendPage(stream, 0x00, 1000, 300);
+    appendPage(stream, 0x01, std::uint64_t(-1), 300); // continued, no packet ends here
+    appendPage(stream, 0x01, 2000, 300); // continued, last packet ends here
+    std::uint64_t resumeOffset = appendPage(stream, 0x00, 3000, 300);
+    appendPage(stream, 0x00, 4000, 300);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 1);
+    index.ScanUntil(file, stream.size());
+
+    EXPECT_EQ(index.CountEntries(), 2U);
+
+    std::optional<OggSeekIndex::Entry> entry = index.TryFindEntry(2500);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry.value().GranulePosition, 2000U);
+    EXPECT_EQ(entry.value().ByteOffset, resumeOffset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, CanBeBuiltIncrementally) {
+    std::vector<std::byte> stream;
+    std::vector<std::uint64_t> audioPageOffsets;
+    buildStream(stream, audioPageOffsets);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 2500);
+    index.ScanUntil(file, audioPageOffsets[5]);
+    EXPECT_FALSE(index.IsComplete());
+    EXPECT_EQ(index.CountEntries(), 2U);
+    EXPECT_TRUE(index.TryFindEntry(4500).has_value());
+    EXPECT_FALSE(index.TryFindEntry(15000).has_value()); // not scanned yet
+
+    for(std::size_t pageIndex = 6; pageIndex < audioPageOffsets.size(); ++pageIndex) {
+      index.ScanUntil(file, audioPageOffsets[pageIndex]);
+    }
+    index.ScanUntil(file, stream.size());
+
+    EXPECT_TRUE(index.IsComplete());
+    EXPECT_EQ(index.CountEntries(), 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, OnlyFollowsDecoderReadingBehindIndex) {
+    std::vector<std::byte> stream;
+    std::vector<std::uint64_t> audioPageOffsets;
+    buildStream(stream, audioPageOffsets);
+
+    // Pad the file so the decoder can be far away from the indexed range
+    stream.resize(stream.size() + 1048576, std::byte(0));
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 2500);
+    index.ScanBehindDecoder(file, stream.size());
+    EXPECT_EQ(index.CountEntries(), 0U);
+
+    index.ScanBehindDecoder(file, audioPageOffsets[5]);
+    EXPECT_EQ(index.CountEntries(), 2U);
+    EXPECT_FALSE(index.IsComplete());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, SurvivesSerializationRoundTrip) {
+    std::vector<std::byte> stream;
+    std::vector<std::uint64_t> audioPageOffsets;
+    buildStream(stream, audioPageOffsets);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 2500);
+    index.ScanUntil(file, stream.size());
+    std::vector<std::byte> serializedIndex = index.Serialize();
+
+    OggSeekIndex loadedIndex(stream.size(), 1000);
+    loadedIndex.Deserialize(serializedIndex);
+
+    EXPECT_TRUE(loadedIndex.IsComplete());
+    EXPECT_EQ(loadedIndex.CountEntries(), index.CountEntries());
+    std::optional<OggSeekIndex::Entry> entry = loadedIndex.TryFindEntry(15000);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry.value().GranulePosition, 13000U);
+    EXPECT_EQ(entry.value().ByteOffset, audioPageOffsets[13]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(OggSeekIndexTest, RejectsMismatchedOrDamagedSerializedIndex) {
+    std::vector<std::byte> stream;
+    std::vector<std::uint64_t> audioPageOffsets;
+    buildStream(stream, audioPageOffsets);
+    ByteArrayAsFile file(stream.data(), stream.size());
+
+    OggSeekIndex index(stream.size(), 2500);
+    index.ScanUntil(file, stream.size());
+    std::vector<std::byte> serializedIndex = index.Serialize();
+
+    OggSeekIndex otherFileIndex(stream.size() + 1, 2500);
+    EXPECT_THROW(otherFileIndex.Deserialize(serializedIndex), Errors::CorruptedFileError);
+
+    serializedIndex.pop_back();
+    OggSeekIndex sameFileIndex(stream.size(), 2500);
+    EXPECT_THROW(sameFileIndex.Deserialize(serializedIndex), Errors::CorruptedFileError);
+    EXPECT_EQ(sameFileIndex.CountEntries(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,99 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/SeekCheckpointCache.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCheckpointCacheTest, EmptyCacheFindsNothing) {
+    SeekCheckpointCache cache(8);
+    EXPECT_EQ(cache.CountCheckpoints(), 0U);
+    EXPECT_FALSE(cache.TryFindCheckpoint(1000).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCheckpointCacheTest, FindsClosestCheckpointBeforeFrame) {
+    SeekCheckpointCache cache(8);
+    cache.Remember(48000, 20000);
+    cache.Remember(12000, 5000);
+    cache.Remember(96000, 40000);
+
+    std::optional<SeekCheckpointCache::Checkpoint> checkpoint = cache.TryFindCheckpoint(50000);
+    ASSERT_TRUE(checkpoint.has_value());
+    EXPECT_EQ(checkpoint->FrameIndex, 48000U);
+    EXPECT_EQ(checkpoint->ByteOffset, 20000U);
+
+    checkpoint = cache.TryFindCheckpoint(12000);
+    ASSERT_TRUE(checkpoint.has_value());
+    EXPECT_EQ(checkpoint->ByteOffset, 5000U);
+
+    EXPECT_FALSE(cache.TryFindCheckpoint(11999).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCheckpointCacheTest, RememberingSameOffsetCorrectsFrame) {
+    SeekCheckpointCache cache(8);
+    cache.Remember(10000, 4096);
+    cache.Remember(10960, 4096);
+
+    EXPECT_EQ(cache.CountCheckpoints(), 1U);
+    EXPECT_FALSE(cache.TryFindCheckpoint(10959).has_value());
+    EXPECT_TRUE(cache.TryFindCheckpoint(10960).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCheckpointCacheTest, OldestCheckpointIsReplacedWhenFull) {
+    SeekCheckpointCache cache(2);
+    cache.Remember(1000, 100);
+    cache.Remember(2000, 200);
+    cache.Remember(3000, 300);
+
+    EXPECT_EQ(cache.CountCheckpoints(), 2U);
+    EXPECT_FALSE(cache.TryFindCheckpoint(1999).has_value());
+
+    std::optional<SeekCheckpointCache::Checkpoint> checkpoint = cache.TryFindCheckpoint(2500);
+    ASSERT_TRUE(checkpoint.has_value());
+    EXPECT_EQ(checkpoint->ByteOffset, 200U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCheckpointCacheTest, CanBeCleared) {
+    SeekCheckpointCache cache(8);
+    cache.Remember(48000, 20000);
+    cache.Remember(96000, 40000);
+
+    cache.Clear();
+    EXPECT_EQ(cache.CountCheckpoints(), 0U);
+    EXPECT_FALSE(cache.TryFindCheckpoint(50000).has_value());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,74 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Shared/SeekCostEstimator.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Shared {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCostEstimatorTest, ContinuingIsFree) {
+    SeekCostEstimator estimator(1000000, 500000, 4096);
+
+    SeekCost cost = estimator.Continue();
+    EXPECT_EQ(cost.ByteCount, 0U);
+    EXPECT_EQ(cost.DiscardedFrameCount, 0U);
+    EXPECT_EQ(cost.RandomAccessCount, 0U);
+    EXPECT_TRUE(cost.IsPrecise);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCostEstimatorTest, JumpDecodesForwardFromLandingFrame) {
+    SeekCostEstimator estimator(1000000, 500000, 4096); // 2 bytes per frame
+
+    SeekCost cost = estimator.Jump(1000, 5000);
+    EXPECT_EQ(cost.ByteCount, 8000U);
+    EXPECT_EQ(cost.DiscardedFrameCount, 4000U);
+    EXPECT_EQ(cost.RandomAccessCount, 1U);
+    EXPECT_TRUE(cost.IsPrecise);
+
+    // Landing right on or behind the target frame means nothing is thrown away
+    cost = estimator.Jump(6000, 5000, false);
+    EXPECT_EQ(cost.ByteCount, 0U);
+    EXPECT_EQ(cost.DiscardedFrameCount, 0U);
+    EXPECT_FALSE(cost.IsPrecise);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SeekCostEstimatorTest, BisectionReadsOneBlockPerStep) {
+    SeekCostEstimator estimator(1000000, 500000, 4096);
+
+    // 122 blocks take 7 steps to narrow down to one
+    SeekCost cost = estimator.Bisect(4096, 5000);
+    EXPECT_EQ(cost.RandomAccessCount, 7U);
+    EXPECT_EQ(cost.DiscardedFrameCount, 904U);
+    EXPECT_EQ(cost.ByteCount, 904U * 2U + 7U * 4096U * 2U);
+    EXPECT_FALSE(cost.IsPrecise);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Shared
@@ -0,0 +1,203 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SharedSampleCache.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono> // for std::chrono::steady_clock
+#include <string> // for std::to_string()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a decoder for the stereo 16 bit test file</summary>
+  /// <returns>A decoder for the stereo 16 bit test file</returns>
+  std::shared_ptr<Nuclex::Audio::Storage::AudioTrackDecoder> openStereoDecoder() {
+    using Nuclex::Audio::Storage::VirtualFile;
+    return std::make_shared<Nuclex::Audio::Storage::Waveform::WaveformTrackDecoder>(
+      VirtualFile::OpenRealFileForReading(
+        Nuclex::Audio::GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a cache name that no other test run will be using</summary>
+  /// <returns>A unique name for a shared sample cache</returns>
+  std::string getUniqueCacheName() {
+    return std::string(u8"nuclex-audio-test-") + std::to_string(
+      std::chrono::steady_clock::now().time_since_epoch().count()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Removes a shared sample cache when the scope is left</summary>
+  class CacheRemovalScope {
+
+    /// <summary>Initializes a new cache removal scope</summary>
+    /// <param name="name">Name of the cache that will be removed</param>
+    public: CacheRemovalScope(const std::string &name) : name(name) {}
+
+    /// <summary>Removes the cache</summary>
+    public: ~CacheRemovalScope() {
+      Nuclex::Audio::Storage::SharedSampleCache::Remove(this->name);
+    }
+
+    /// <summary>Name of the cache that will be removed</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SharedSampleCacheTest, LaterOpensUseGeometryOfCreator) {
+    std::string name = getUniqueCacheName();
+    CacheRemovalScope removalScope(name);
+
+    std::shared_ptr<SharedSampleCache> first = SharedSampleCache::Open(name, 1048576, 65536);
+    std::shared_ptr<SharedSampleCache> second = SharedSampleCache::Open(name, 4194304, 4096);
+
+    EXPECT_EQ(first->GetSlotSize(), 65536U);
+    EXPECT_GT(first->CountSlots(), 0U);
+    EXPECT_LE(first->CountSlots() * first->GetSlotSize(), 1048576U);
+    EXPECT_EQ(second->GetSlotSize(), first->GetSlotSize());
+    EXPECT_EQ(second->CountSlots(), first->CountSlots());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SharedSampleCacheTest, TooSmallCapacityIsRejected) {
+    EXPECT_THROW(
+      SharedSampleCache::Open(getUniqueCacheName(), 1000, 65536), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SharedSampleCacheTest, BlocksDecodedByOneUserAreFoundByAnother) {
+    std::string name = getUniqueCacheName();
+    CacheRemovalScope removalScope(name);
+
+    // Two separate mappings of the same region, just like two processes would have
+    std::shared_ptr<SharedSampleCache> first = SharedSampleCache::Open(name, 8388608, 16384);
+    std::shared_ptr<SharedSampleCache> second = SharedSampleCache::Open(name);
+
+    std::shared_ptr<AudioTrackDecoder> plain = openStereoDecoder();
+    std::size_t sampleCount = static_cast<std::size_t>(plain->CountFrames() * 2);
+    std::vector<float> expected(sampleCount);
+    plain->DecodeInterleaved<float>(expected.data(), 0, plain->CountFrames());
+
+    std::shared_ptr<AudioTrackDecoder> producer = AudioTrackDecoder::CreateSharedCached(
+      openStereoDecoder(), first, u8"stereo-test-file"
+    );
+    std::vector<float> produced(sampleCount);
+    producer->DecodeInterleaved<float>(produced.data(), 0, producer->CountFrames());
+    EXPECT_EQ(produced, expected);
+    EXPECT_EQ(first->CountHits(), 0U);
+    EXPECT_GT(first->CountMisses(), 0U);
+
+    std::shared_ptr<AudioTrackDecoder> consumer = AudioTrackDecoder::CreateSharedCached(
+      openStereoDecoder(), second, u8"stereo-test-file"
+    );
+    std::vector<float> consumed(sampleCount);
+    consumer->DecodeInterleaved<float>(consumed.data(), 0, consumer->CountFrames());
+    EXPECT_EQ(consumed, expected);
+    EXPECT_EQ(second->CountMisses(), 0U);
+    EXPECT_EQ(second->CountHits(), first->CountMisses());
+
+    // Conversions and separated channels come out of the same cached blocks
+    std::vector<std::int16_t> left(100), right(100), expectedLeft(100), expectedRight(100);
+    std::int16_t *buffers[] = { left.data(), right.data() };
+    std::int16_t *expectedBuffers[] = { expectedLeft.data(), expectedRight.data() };
+    consumer->DecodeSeparated<std::int16_t>(buffers, 5000, 100);
+    plain->DecodeSeparated<std::int16_t>(expectedBuffers, 5000, 100);
+    EXPECT_EQ(left, expectedLeft);
+    EXPECT_EQ(right, expectedRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SharedSampleCacheTest, DifferentIdentitiesDontShareBlocks) {
+    std::string name = getUniqueCacheName();
+    CacheRemovalScope removalScope(name);
+    std::shared_ptr<SharedSampleCache> cache = SharedSampleCache::Open(name, 8388608, 16384);
+
+    std::shared_ptr<AudioTrackDecoder> first = AudioTrackDecoder::CreateSharedCached(
+      openStereoDecoder(), cache, u8"first"
+    );
+    std::shared_ptr<AudioTrackDecoder> second = AudioTrackDecoder::CreateSharedCached(
+      openStereoDecoder(), cache, u8"second"
+    );
+
+    std::vector<float> samples(200);
+    first->DecodeInterleaved<float>(samples.data(), 0, 100);
+    second->DecodeInterleaved<float>(samples.data(), 0, 100);
+    EXPECT_EQ(cache->CountHits(), 0U);
+    EXPECT_EQ(cache->CountMisses(), 2U);
+
+    first->DecodeInterleaved<float>(samples.data(), 0, 100);
+    EXPECT_EQ(cache->CountHits(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SharedSampleCacheTest, TracksLargerThanCacheStillDecodeCorrectly) {
+    std::string name = getUniqueCacheName();
+    CacheRemovalScope removalScope(name);
+
+    // Only a couple of slots, so blocks keep evicting each other
+    std::shared_ptr<SharedSampleCache> cache = SharedSampleCache::Open(name, 16384, 4096);
+    ASSERT_LT(cache->CountSlots(), 4U);
+
+    std::shared_ptr<AudioTrackDecoder> plain = openStereoDecoder();
+    std::shared_ptr<AudioTrackDecoder> cached = AudioTrackDecoder::CreateSharedCached(
+      openStereoDecoder(), cache, u8"stereo-test-file"
+    );
+
+    std::size_t sampleCount = static_cast<std::size_t>(plain->CountFrames() * 2);
+    std::vector<float> expected(sampleCount), actual(sampleCount);
+    plain->DecodeInterleaved<float>(expected.data(), 0, plain->CountFrames());
+    for(std::size_t pass = 0; pass < 2; ++pass) {
+      cached->DecodeInterleaved<float>(actual.data(), 0, cached->CountFrames());
+      EXPECT_EQ(actual, expected);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,180 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/SoundBank.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Audio files from the test resources that will be packed into banks</summary>
+  const char *const ClipFileNames[] = {
+    u8"waveform-stereo-int16le-pcmwaveformat.wav",
+    u8"waveform-mono-uint8-pcmwaveformat.wav",
+    u8"waveform-stereo-float32le-pcmwaveformat.wav"
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SoundBankTest, ClipsCanBeDecodedByIndexAndName) {
+    AudioLoader loader;
+
+    SoundBankWriter writer;
+    for(const char *fileName : ClipFileNames) {
+      writer.Add(
+        loader, fileName,
+        VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + fileName),
+        u8"wav", AudioSampleFormat::Float_32
+      );
+    }
+    EXPECT_EQ(writer.CountClips(), 3U);
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    SoundBank bank(file);
+    ASSERT_EQ(bank.CountClips(), 3U);
+
+    for(std::size_t index = 0; index < 3; ++index) {
+      std::shared_ptr<const VirtualFile> original = VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + ClipFileNames[index]
+      );
+      std::shared_ptr<AudioTrackDecoder> expected = loader.OpenDecoder(original);
+
+      ASSERT_EQ(bank.TryFindClip(ClipFileNames[index]), std::optional<std::size_t>(index));
+
+      SoundBankClip clip = bank.GetClip(index);
+      EXPECT_EQ(clip.Name, ClipFileNames[index]);
+      EXPECT_EQ(clip.Extension, u8"wav");
+      EXPECT_EQ(clip.PreferredFormat, AudioSampleFormat::Float_32);
+      EXPECT_EQ(clip.ByteCount, original->GetSize());
+      EXPECT_EQ(clip.Info.ChannelCount, expected->CountChannels());
+
+      std::shared_ptr<AudioTrackDecoder> decoder = bank.OpenDecoder(
+        loader, std::string(ClipFileNames[index])
+      );
+      ASSERT_EQ(decoder->CountFrames(), expected->CountFrames());
+
+      std::size_t sampleCount = 100 * decoder->CountChannels();
+      std::vector<float> expectedSamples(sampleCount), actualSamples(sampleCount);
+      expected->DecodeInterleaved(expectedSamples.data(), 10, 100);
+      decoder->DecodeInterleaved(actualSamples.data(), 10, 100);
+      EXPECT_EQ(actualSamples, expectedSamples);
+    }
+
+    EXPECT_FALSE(bank.TryFindClip(u8"missing.wav").has_value());
+    EXPECT_THROW(bank.OpenDecoder(loader, std::string(u8"missing.wav")), std::out_of_range);
+    EXPECT_THROW(bank.GetClip(3), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SoundBankTest, ClipFilesAreViewsIntoTheBank) {
+    std::vector<std::byte> contents(1000);
+    for(std::size_t index = 0; index < contents.size(); ++index) {
+      contents[index] = static_cast<std::byte>(index);
+    }
+
+    SoundBankClip clip = SoundBankClip();
+    clip.Name = u8"raw";
+    clip.PreferredFormat = AudioSampleFormat::Unknown;
+
+    SoundBankWriter writer;
+    EXPECT_EQ(writer.Add(clip, contents), 0U);
+    EXPECT_THROW(writer.Add(clip, contents), std::invalid_argument);
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+
+    SoundBank bank(file);
+    std::shared_ptr<const VirtualFile> clipFile = bank.OpenClipFile(0);
+    ASSERT_EQ(clipFile->GetSize(), contents.size());
+
+    std::vector<std::byte> actual(contents.size());
+    clipFile->ReadAt(0, actual.size(), actual.data());
+    EXPECT_EQ(actual, contents);
+
+    // The memory file lends out its memory, so the view should pass that on
+    const std::byte *borrowed = clipFile->TryBorrowAt(0, contents.size());
+    ASSERT_NE(borrowed, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(borrowed) % 16, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SoundBankTest, DecodersCanBeReopenedOnOtherClips) {
+    AudioLoader loader;
+
+    SoundBankWriter writer;
+    for(const char *fileName : ClipFileNames) {
+      writer.Add(
+        loader, fileName,
+        VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + fileName)
+      );
+    }
+
+    std::shared_ptr<WritableMemoryFile> file = std::make_shared<WritableMemoryFile>();
+    writer.Save(*file);
+    SoundBank bank(file);
+
+    std::shared_ptr<AudioTrackDecoder> decoder;
+    for(std::size_t index = 0; index < bank.CountClips(); ++index) {
+      bank.ReopenDecoder(loader, decoder, index);
+      ASSERT_TRUE(static_cast<bool>(decoder));
+      EXPECT_EQ(decoder->CountChannels(), bank.GetClip(index).Info.ChannelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SoundBankTest, RejectsOtherFiles) {
+    EXPECT_THROW(
+      SoundBank bank(
+        VirtualFile::OpenRealFileForReading(
+          GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+        )
+      ),
+      Errors::CorruptedFileError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
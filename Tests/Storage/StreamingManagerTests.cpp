@@ -0,0 +1,179 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/StreamingManager.h"
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+#include "Nuclex/Audio/Storage/AudioLoader.h"
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "Nuclex/Audio/WorkStealingExecutor.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <thread> // for std::this_thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingManagerTest, VoicesOfTheSameFileShareReads) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav";
+
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(path);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    StreamingManager manager(loader);
+    std::shared_ptr<StreamingTrackReader> voices[] = {
+      manager.OpenVoice(path, 4096),
+      manager.OpenVoice(path, 4096)
+    };
+    EXPECT_EQ(manager.CountVoices(), 2U);
+
+    std::vector<float> results[2] = {
+      std::vector<float>(frameCount * channelCount),
+      std::vector<float>(frameCount * channelCount)
+    };
+    std::size_t readFrameCounts[2] = { 0, 0 };
+    while(!voices[0]->IsAtEnd() || !voices[1]->IsAtEnd()) {
+      for(std::size_t index = 0; index < 2; ++index) {
+        float *target = results[index].data() + readFrameCounts[index] * channelCount;
+        readFrameCounts[index] += voices[index]->Read(
+          target, voices[index]->CountReadableFrames()
+        );
+      }
+      std::this_thread::yield();
+    }
+
+    EXPECT_EQ(results[0], expected);
+    EXPECT_EQ(results[1], expected);
+    EXPECT_GT(manager.CountFileReads(), 0U);
+    EXPECT_GT(manager.CountCoalescedReads(), 0U);
+    EXPECT_EQ(manager.CountUnderruns(), 0U);
+
+    voices[0].reset();
+    EXPECT_EQ(manager.CountVoices(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingManagerTest, CountsUnderrunsOfAllVoices) {
+    AudioLoader loader;
+    StreamingManager manager(loader, 2);
+
+    std::shared_ptr<StreamingTrackReader> voice = manager.AddVoice(
+      loader.OpenDecoder(
+        GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+      ),
+      256
+    );
+    ASSERT_GT(voice->CountFrames(), 512U);
+
+    // Asking for more than the voice can ever buffer is always an underrun
+    std::vector<float> buffer(512 * voice->CountChannels());
+    voice->Read(buffer.data(), 512);
+    EXPECT_EQ(manager.CountUnderruns(), 1U);
+
+    // Underruns of voices that have been closed are still counted
+    voice.reset();
+    EXPECT_EQ(manager.CountVoices(), 0U);
+    EXPECT_EQ(manager.CountUnderruns(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingManagerTest, CanDecodeOnExecutor) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(path);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    StreamingManager manager(loader, std::make_shared<WorkStealingExecutor>(2));
+    std::shared_ptr<StreamingTrackReader> voice = manager.OpenVoice(path, 4096);
+
+    std::vector<float> result(frameCount * channelCount);
+    std::size_t readFrameCount = 0;
+    while(!voice->IsAtEnd()) {
+      readFrameCount += voice->Read(
+        result.data() + readFrameCount * channelCount, voice->CountReadableFrames()
+      );
+      std::this_thread::yield();
+    }
+
+    EXPECT_EQ(readFrameCount, frameCount);
+    EXPECT_EQ(result, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingManagerTest, VoicesStartFromCachedHeads) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav";
+
+    AudioLoader loader;
+    std::shared_ptr<AudioTrackDecoder> decoder = loader.OpenDecoder(path);
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    std::shared_ptr<HeadCache> headCache = std::make_shared<HeadCache>(20);
+    std::vector<std::string> paths = {
+      path, GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin"
+    };
+    EXPECT_EQ(headCache->Preload(loader, paths), 1U);
+
+    StreamingManager manager(loader);
+    manager.SetHeadCache(headCache);
+    std::shared_ptr<StreamingTrackReader> voice = manager.OpenVoice(path, 4096);
+
+    std::size_t headFrameCount = headCache->TryGetHead(path)->FrameCount;
+    EXPECT_GE(voice->CountReadableFrames(), headFrameCount);
+
+    std::vector<float> result(frameCount * channelCount);
+    std::size_t readFrameCount = 0;
+    while(!voice->IsAtEnd()) {
+      readFrameCount += voice->Read(
+        result.data() + readFrameCount * channelCount, voice->CountReadableFrames()
+      );
+      std::this_thread::yield();
+    }
+
+    EXPECT_EQ(readFrameCount, frameCount);
+    EXPECT_EQ(result, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,283 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/StreamingTrackReader.h"
+#include "Nuclex/Audio/Storage/StreamingThreadPool.h"
+#include "Nuclex/Audio/Storage/HeadCache.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
+#include <thread> // for std::this_thread::yield()
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, RequiresDecoderThreadPoolAndBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+    std::shared_ptr<StreamingThreadPool> threadPool = std::make_shared<StreamingThreadPool>();
+
+    EXPECT_THROW(
+      StreamingTrackReader reader(std::shared_ptr<AudioTrackDecoder>(), threadPool),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      StreamingTrackReader reader(decoder, std::shared_ptr<StreamingThreadPool>()),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      StreamingTrackReader reader(decoder, threadPool, 0),
+      std::invalid_argument
+    );
+    EXPECT_THROW(StreamingThreadPool pool(0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, DeliversSameSamplesAsDecoder) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+    const std::size_t startFrame = 123;
+
+    std::vector<float> expected((frameCount - startFrame) * channelCount);
+    decoder->Clone()->DecodeInterleaved(expected.data(), startFrame, frameCount - startFrame);
+
+    // Use an odd buffer size so that reads wrap around the ring buffer's end
+    StreamingTrackReader reader(
+      decoder, std::make_shared<StreamingThreadPool>(), 1000, startFrame
+    );
+    EXPECT_EQ(reader.GetReadPosition(), startFrame);
+
+    std::vector<float> actual((frameCount - startFrame) * channelCount);
+    std::size_t readFrameCount = 0;
+    while(!reader.IsAtEnd()) {
+      std::size_t chunkFrameCount = reader.Read(
+        actual.data() + readFrameCount * channelCount, 300
+      );
+      if(chunkFrameCount == 0) {
+        reader.RethrowPotentialException();
+        std::this_thread::yield();
+      }
+      readFrameCount += chunkFrameCount;
+    }
+
+    EXPECT_EQ(readFrameCount, frameCount - startFrame);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, ContinuesSeamlesslyAfterCachedHead) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav";
+    std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<Waveform::WaveformTrackDecoder>(
+      VirtualFile::OpenRealFileForReading(path)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // A nominal rate of 1000 Hz makes the head exactly 250 frames long
+    HeadCache headCache(250);
+    headCache.Add(path, *decoder, 1000);
+    std::shared_ptr<const CachedHead> head = headCache.TryGetHead(path);
+    ASSERT_TRUE(static_cast<bool>(head));
+    ASSERT_EQ(head->FrameCount, 250U);
+
+    std::shared_ptr<StreamingThreadPool> threadPool = std::make_shared<StreamingThreadPool>();
+    StreamingTrackReader reader(
+      head,
+      [path]() {
+        return std::make_shared<Waveform::WaveformTrackDecoder>(
+          VirtualFile::OpenRealFileForReading(path)
+        );
+      },
+      threadPool, 1000
+    );
+    EXPECT_EQ(reader.CountFrames(), frameCount);
+    EXPECT_GE(reader.CountReadableFrames(), 250U);
+
+    // The head is readable right away, whether or not the file has been opened yet
+    std::vector<float> actual(frameCount * channelCount);
+    ASSERT_EQ(reader.Read(actual.data(), 200), 200U);
+
+    // Reads straddling the head's end switch over to the decoded frames
+    std::size_t readFrameCount = 200;
+    while(!reader.IsAtEnd()) {
+      std::size_t chunkFrameCount = reader.Read(
+        actual.data() + readFrameCount * channelCount, 300
+      );
+      if(chunkFrameCount == 0) {
+        reader.RethrowPotentialException();
+        std::this_thread::yield();
+      }
+      readFrameCount += chunkFrameCount;
+    }
+
+    EXPECT_EQ(readFrameCount, frameCount);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, CachedHeadPlaysEvenIfFileFailsToOpen) {
+    std::string path = GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav";
+    Waveform::WaveformTrackDecoder decoder(VirtualFile::OpenRealFileForReading(path));
+
+    HeadCache headCache(100);
+    headCache.Add(path, decoder, 1000);
+
+    StreamingTrackReader reader(
+      headCache.TryGetHead(path),
+      []() -> std::shared_ptr<AudioTrackDecoder> {
+        throw std::runtime_error(u8"Simulated error opening the file");
+      },
+      std::make_shared<StreamingThreadPool>(), 1000
+    );
+
+    std::vector<float> buffer(200 * decoder.CountChannels());
+    EXPECT_EQ(reader.Read(buffer.data(), 200), 100U);
+    while(reader.Read(buffer.data(), 1) == 0) {
+      try {
+        reader.RethrowPotentialException();
+      }
+      catch(const std::runtime_error &) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+    EXPECT_THROW(reader.RethrowPotentialException(), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, SingleThreadCanServiceManyStreams) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::shared_ptr<AudioTrackDecoder> decoder = (
+      std::make_shared<Waveform::WaveformTrackDecoder>(file)
+    );
+
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    std::size_t channelCount = decoder->CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder->DecodeInterleaved(expected.data(), 0, frameCount);
+
+    const std::size_t streamCount = 100;
+    std::shared_ptr<StreamingThreadPool> threadPool = std::make_shared<StreamingThreadPool>(1);
+    std::vector<std::unique_ptr<StreamingTrackReader>> readers;
+    for(std::size_t index = 0; index < streamCount; ++index) {
+      readers.emplace_back(new StreamingTrackReader(decoder->Clone(), threadPool, 4096));
+    }
+    EXPECT_EQ(threadPool->CountStreams(), streamCount);
+
+    // Read from all streams round-robin like a mixer would
+    std::vector<std::vector<float>> results(
+      streamCount, std::vector<float>(frameCount * channelCount)
+    );
+    std::vector<std::size_t> readFrameCounts(streamCount, 0);
+    for(std::size_t finishedCount = 0; finishedCount < streamCount;) {
+      finishedCount = 0;
+      for(std::size_t index = 0; index < streamCount; ++index) {
+        if(readers[index]->IsAtEnd()) {
+          ++finishedCount;
+        } else {
+          float *target = results[index].data() + readFrameCounts[index] * channelCount;
+          readFrameCounts[index] += readers[index]->Read(target, 512);
+        }
+      }
+      std::this_thread::yield();
+    }
+
+    for(std::size_t index = 0; index < streamCount; ++index) {
+      EXPECT_EQ(readFrameCounts[index], frameCount);
+      EXPECT_EQ(results[index], expected);
+    }
+
+    readers.clear();
+    EXPECT_EQ(threadPool->CountStreams(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StreamingTrackReaderTest, ShortReadsCountAsUnderruns) {
+    std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<Waveform::WaveformTrackDecoder>(
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    std::size_t frameCount = static_cast<std::size_t>(decoder->CountFrames());
+    ASSERT_GT(frameCount, 2048U);
+
+    std::shared_ptr<StreamingThreadPool> threadPool = std::make_shared<StreamingThreadPool>(1);
+    StreamingTrackReader reader(decoder, threadPool, 1024);
+
+    // The ring buffer can never hold this many frames, so the read has to come up short
+    std::vector<float> buffer(frameCount * decoder->CountChannels());
+    std::size_t readFrameCount = reader.Read(buffer.data(), 2048);
+    EXPECT_LT(readFrameCount, 2048U);
+    EXPECT_EQ(reader.CountUnderruns(), 1U);
+
+    // Reading past the end of the track is not an underrun
+    while(!reader.IsAtEnd()) {
+      if(reader.CountReadableFrames() == frameCount - readFrameCount) {
+        readFrameCount += reader.Read(
+          buffer.data() + readFrameCount * decoder->CountChannels(), 2048
+        );
+      } else if(reader.CountReadableFrames() == reader.GetBufferedFrameCount()) {
+        readFrameCount += reader.Read(
+          buffer.data() + readFrameCount * decoder->CountChannels(),
+          reader.GetBufferedFrameCount()
+        );
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_EQ(readFrameCount, frameCount);
+    EXPECT_EQ(reader.CountUnderruns(), 1U);
+    EXPECT_EQ(threadPool->CountUnderruns(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
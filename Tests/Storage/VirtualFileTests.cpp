@@ -0,0 +1,532 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "./ResourceDirectoryLocator.h"
+#include "./ByteArrayAsFile.h"
+
+#include <Nuclex/Support/TemporaryDirectoryScope.h> // for TemporaryDirectoryScope
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::equal()
+#include <stdexcept> // for std::out_of_range
+#include <system_error> // for std::system_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Byte array file that counts how often it has been read from</summary>
+  class ReadCountingFile : public Nuclex::Audio::Storage::ByteArrayAsFile {
+
+    /// <summary>Initializes a new read counting file</summary>
+    /// <param name="data">Memory buffer the virtual file will access</param>
+    /// <param name="length">Size of the memory buffer in bytes</param>
+    public: ReadCountingFile(const std::byte *data, std::uint64_t length) :
+      ByteArrayAsFile(data, length),
+      ReadCount(0) {}
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      ++this->ReadCount;
+      ByteArrayAsFile::ReadAt(start, byteCount, buffer);
+    }
+
+    /// <summary>Pretends the file can't lend out its memory</summary>
+    /// <param name="start">Offset in the file at which the borrowed range begins</param>
+    /// <param name="byteCount">Number of bytes the borrowed range should cover</param>
+    /// <returns>Always a null pointer</returns>
+    public: const std::byte *TryBorrowAt(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      (void)start;
+      (void)byteCount;
+      return nullptr;
+    }
+
+    /// <summary>Number of times the file has been read from</summary>
+    public: mutable std::size_t ReadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>In-memory file that counts how often it has been written to</summary>
+  class WriteCountingFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Initializes a new, empty write counting file</summary>
+    public: WriteCountingFile() :
+      Contents(),
+      WriteCount(0) {}
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->Contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if((start > this->Contents.size()) || (this->Contents.size() - start < byteCount)) {
+        throw std::out_of_range(u8"Read past end of file");
+      }
+      std::copy_n(this->Contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->Contents.size()) {
+        throw std::out_of_range(u8"Write would leave a gap in the file");
+      }
+      ++this->WriteCount;
+      if(start + byteCount > this->Contents.size()) {
+        this->Contents.resize(start + byteCount);
+      }
+      std::copy_n(buffer, byteCount, this->Contents.data() + start);
+    }
+
+    /// <summary>Data that has been written into the file</summary>
+    public: std::vector<std::byte> Contents;
+    /// <summary>Number of times the file has been written to</summary>
+    public: std::size_t WriteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a recognizable pattern of bytes</summary>
+  /// <param name="length">Number of bytes that will be generated</param>
+  /// <returns>A memory buffer filled with the byte pattern</returns>
+  std::vector<std::byte> makeBytePattern(std::size_t length) {
+    std::vector<std::byte> bytes(length);
+    for(std::size_t index = 0; index < length; ++index) {
+      bytes[index] = static_cast<std::byte>((index * 7 + index / 256) & 0xFF);
+    }
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, MemoryMappedFileReadsSameDataAsRealFile) {
+    std::string path = GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin";
+
+    std::shared_ptr<const VirtualFile> realFile = VirtualFile::OpenRealFileForReading(
+      path, false, false
+    );
+    std::shared_ptr<const VirtualFile> mappedFile = VirtualFile::OpenRealFileForReading(
+      path, false, true
+    );
+    ASSERT_EQ(realFile->GetSize(), mappedFile->GetSize());
+
+    std::vector<std::byte> realBytes(4096);
+    std::vector<std::byte> mappedBytes(4096);
+    realFile->ReadAt(12345, 4096, realBytes.data());
+    mappedFile->ReadAt(12345, 4096, mappedBytes.data());
+
+    EXPECT_EQ(realBytes, mappedBytes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, MemoryMappedFileRejectsReadsPastEnd) {
+    std::shared_ptr<const VirtualFile> mappedFile = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin", false, true
+    );
+
+    std::vector<std::byte> bytes(16);
+    EXPECT_THROW(
+      mappedFile->ReadAt(mappedFile->GetSize() - 8, 16, bytes.data()),
+      std::system_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, FilesCanBeOpenedWithAllAccessPatterns) {
+    std::string path = GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin";
+
+    FileAccessPattern patterns[] = {
+      FileAccessPattern::Normal, FileAccessPattern::Sequential, FileAccessPattern::Random,
+      FileAccessPattern::Unbuffered
+    };
+    for(FileAccessPattern pattern : patterns) {
+      for(bool useMemoryMapping : { false, true }) {
+        std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+          path, pattern, useMemoryMapping
+        );
+
+        // Prefetching is only a hint and may not fail, not even for bogus ranges
+        EXPECT_NO_THROW(file->Prefetch(1000, 20000));
+        EXPECT_NO_THROW(file->Prefetch(file->GetSize() - 10, 20000));
+
+        std::vector<std::byte> bytes(256);
+        EXPECT_NO_THROW(file->ReadAt(4321, 256, bytes.data()));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, UnbufferedFilesRoundTripUnalignedData) {
+    Nuclex::Support::TemporaryDirectoryScope directory(u8"nuclex-audio-unbuffered");
+    std::string path = directory.GetPath(u8"unbuffered.bin");
+
+    // Odd length and odd write sizes so that nothing lines up with the sector size
+    // and the data spans several of the unbuffered file's 1 MiB blocks
+    std::vector<std::byte> pattern = makeBytePattern(2500001);
+    {
+      std::shared_ptr<VirtualFile> file = VirtualFile::OpenRealFileForWriting(
+        path, FileAccessPattern::Unbuffered
+      );
+      std::size_t offset = 0;
+      while(offset < pattern.size()) {
+        std::size_t chunkLength = std::min<std::size_t>(12345, pattern.size() - offset);
+        file->WriteAt(offset, chunkLength, pattern.data() + offset);
+        offset += chunkLength;
+      }
+
+      // Patch a header that has already been written out to disk, straddling a sector
+      std::vector<std::byte> header(100, std::byte(0xAB));
+      file->WriteAt(4050, header.size(), header.data());
+      std::copy(header.begin(), header.end(), pattern.begin() + 4050);
+
+      // Reading back works for both the written-out and the still buffered parts
+      std::vector<std::byte> bytes(200);
+      file->ReadAt(4000, 200, bytes.data());
+      EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 4000));
+      file->ReadAt(pattern.size() - 200, 200, bytes.data());
+      EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.end() - 200));
+
+      EXPECT_THROW(file->WriteAt(pattern.size() + 1, 1, bytes.data()), std::out_of_range);
+      file->Flush();
+    }
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      path, FileAccessPattern::Unbuffered
+    );
+    ASSERT_EQ(file->GetSize(), pattern.size());
+
+    // Sequential reads trigger the read-ahead, a jump back has to reload the block
+    std::vector<std::byte> bytes(pattern.size());
+    std::size_t offset = 0;
+    while(offset < pattern.size()) {
+      std::size_t chunkLength = std::min<std::size_t>(65537, pattern.size() - offset);
+      file->ReadAt(offset, chunkLength, bytes.data() + offset);
+      offset += chunkLength;
+    }
+    EXPECT_EQ(bytes, pattern);
+
+    file->ReadAt(1048000, 1000, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + 1000, pattern.begin() + 1048000));
+    EXPECT_THROW(file->ReadAt(pattern.size() - 10, 11, bytes.data()), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, PreallocatedFilesAreTrimmedToWrittenLength) {
+    Nuclex::Support::TemporaryDirectoryScope directory(u8"nuclex-audio-preallocated");
+
+    std::vector<std::byte> pattern = makeBytePattern(5000);
+
+    FileAccessPattern accessPatterns[] = {
+      FileAccessPattern::Normal, FileAccessPattern::Unbuffered
+    };
+    for(FileAccessPattern accessPattern : accessPatterns) {
+      std::string path = directory.GetPath(u8"preallocated.bin");
+      {
+        std::shared_ptr<VirtualFile> file = VirtualFile::OpenRealFileForWriting(
+          path, accessPattern, 10000000
+        );
+        EXPECT_EQ(file->GetSize(), 0U);
+
+        file->WriteAt(0, pattern.size(), pattern.data());
+        file->Flush();
+        EXPECT_EQ(file->GetSize(), pattern.size());
+
+        // More data written after flushing also has to survive
+        file->WriteAt(pattern.size(), 100, pattern.data());
+      }
+
+      std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path);
+      ASSERT_EQ(file->GetSize(), pattern.size() + 100);
+
+      std::vector<std::byte> bytes(pattern.size());
+      file->ReadAt(0, pattern.size(), bytes.data());
+      EXPECT_EQ(bytes, pattern);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, BatchedReadsDeliverSameDataAsIndividualReads) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin", false, false
+    );
+
+    // Use more requests than the io_uring holds so multiple batches are needed
+    const std::size_t requestCount = 100;
+    const std::size_t requestSize = 777;
+    std::vector<std::byte> batchedBytes(requestCount * requestSize);
+    std::vector<ReadRequest> requests(requestCount);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      requests[index].Start = (index * 7919) % (file->GetSize() - requestSize);
+      requests[index].ByteCount = requestSize;
+      requests[index].Buffer = batchedBytes.data() + (index * requestSize);
+    }
+    file->ReadManyAt(requests.data(), requestCount);
+
+    std::vector<std::byte> individualBytes(requestSize);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      file->ReadAt(requests[index].Start, requestSize, individualBytes.data());
+      EXPECT_TRUE(
+        std::equal(
+          individualBytes.begin(), individualBytes.end(),
+          batchedBytes.begin() + (index * requestSize)
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, BatchedReadsHandleAdjacentAndEmptyRequests) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin", false, false
+    );
+
+    // Adjacent requests given out of order, with an empty one in between
+    std::vector<std::byte> batchedBytes(3000);
+    ReadRequest requests[4] = {
+      { 2000, 1000, batchedBytes.data() + 2000 },
+      { 0, 1000, batchedBytes.data() },
+      { 1000, 0, batchedBytes.data() + 1000 },
+      { 1000, 1000, batchedBytes.data() + 1000 }
+    };
+    file->ReadManyAt(requests, 4);
+
+    std::vector<std::byte> individualBytes(3000);
+    file->ReadAt(0, 3000, individualBytes.data());
+    EXPECT_EQ(batchedBytes, individualBytes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, BatchedReadsPastEndThrow) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"one-hundred-kilobytes-of-random-bytes.bin", false, false
+    );
+
+    std::vector<std::byte> bytes(32);
+    ReadRequest requests[2] = {
+      { 0, 16, bytes.data() },
+      { file->GetSize() - 8, 16, bytes.data() + 16 }
+    };
+    EXPECT_THROW(file->ReadManyAt(requests, 2), std::system_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadAheadBufferCombinesSmallReads) {
+    std::vector<std::byte> pattern = makeBytePattern(65536);
+    std::shared_ptr<ReadCountingFile> countingFile = std::make_shared<ReadCountingFile>(
+      pattern.data(), pattern.size()
+    );
+    std::shared_ptr<const VirtualFile> bufferedFile = VirtualFile::WrapInReadAheadBuffer(
+      countingFile, 1024, 3
+    );
+    ASSERT_EQ(bufferedFile->GetSize(), pattern.size());
+
+    std::vector<std::byte> bytes(100);
+    for(std::size_t index = 0; index < 40; ++index) {
+      bufferedFile->ReadAt(1000 + index * 100, 100, bytes.data());
+      EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 1000 + index * 100));
+    }
+
+    // 4000 bytes starting at offset 1000 span the blocks 0 through 4, so with a window
+    // of 4 blocks, exactly two reads should have hit the wrapped file.
+    EXPECT_EQ(countingFile->ReadCount, 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadAheadBufferPassesLargeReadsThrough) {
+    std::vector<std::byte> pattern = makeBytePattern(65536);
+    std::shared_ptr<ReadCountingFile> countingFile = std::make_shared<ReadCountingFile>(
+      pattern.data(), pattern.size()
+    );
+    std::shared_ptr<const VirtualFile> bufferedFile = VirtualFile::WrapInReadAheadBuffer(
+      countingFile, 1024, 1
+    );
+
+    std::vector<std::byte> bytes(30000);
+    bufferedFile->ReadAt(12345, 30000, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 12345));
+
+    bufferedFile->ReadAt(65000, 536, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + 536, pattern.begin() + 65000));
+    EXPECT_EQ(countingFile->ReadCount, 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, WriteBufferCombinesSmallWrites) {
+    std::shared_ptr<WriteCountingFile> target = std::make_shared<WriteCountingFile>();
+    std::shared_ptr<VirtualFile> file = VirtualFile::WrapInWriteBuffer(target, 1024);
+
+    std::vector<std::byte> pattern = makeBytePattern(4000);
+    for(std::size_t offset = 0; offset < 4000; offset += 100) {
+      file->WriteAt(offset, 100, pattern.data() + offset);
+    }
+    EXPECT_EQ(file->GetSize(), 4000U);
+
+    // Three full 1024 byte blocks should have been written, the rest is still buffered
+    EXPECT_EQ(target->WriteCount, 3U);
+    EXPECT_EQ(target->Contents.size(), 3072U);
+
+    file->Flush();
+    EXPECT_EQ(target->WriteCount, 4U);
+    EXPECT_EQ(target->Contents, pattern);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, WriteBufferHandlesOverwritesAndReads) {
+    std::shared_ptr<WriteCountingFile> target = std::make_shared<WriteCountingFile>();
+    std::shared_ptr<VirtualFile> file = VirtualFile::WrapInWriteBuffer(target, 1024);
+
+    std::vector<std::byte> pattern = makeBytePattern(3000);
+    file->WriteAt(0, 3000, pattern.data()); // Larger than buffer, goes straight through
+    EXPECT_EQ(target->WriteCount, 1U);
+
+    // Patch the start of the file (like an encoder updating its header) and append
+    std::byte patch[4] = { std::byte(1), std::byte(2), std::byte(3), std::byte(4) };
+    file->WriteAt(8, 4, patch);
+    file->WriteAt(3000, 4, patch);
+
+    // Reading the patched range must see the patched bytes
+    std::byte readBack[4];
+    file->ReadAt(8, 4, readBack);
+    EXPECT_TRUE(std::equal(readBack, readBack + 4, patch));
+
+    file.reset(); // Destruction flushes the buffer
+    ASSERT_EQ(target->Contents.size(), 3004U);
+    EXPECT_TRUE(std::equal(patch, patch + 4, target->Contents.data() + 8));
+    EXPECT_TRUE(std::equal(patch, patch + 4, target->Contents.data() + 3000));
+    EXPECT_TRUE(std::equal(pattern.begin() + 12, pattern.end(), target->Contents.begin() + 12));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, SubRangeViewExposesPartOfFile) {
+    std::vector<std::byte> pattern = makeBytePattern(1000);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<const ByteArrayAsFile>(
+      pattern.data(), pattern.size()
+    );
+    std::shared_ptr<const VirtualFile> view = VirtualFile::CreateSubRangeView(file, 300, 200);
+    ASSERT_EQ(view->GetSize(), 200U);
+
+    std::vector<std::byte> bytes(50);
+    view->ReadAt(150, 50, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 450));
+
+    EXPECT_EQ(view->TryBorrowAt(10, 20), pattern.data() + 310);
+    EXPECT_EQ(view->TryBorrowAt(190, 20), nullptr);
+    EXPECT_THROW(view->ReadAt(190, 20, bytes.data()), std::out_of_range);
+    EXPECT_THROW(VirtualFile::CreateSubRangeView(file, 900, 200), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ConcatenatedViewSplicesFiles) {
+    std::vector<std::byte> pattern = makeBytePattern(1000);
+    std::vector<std::shared_ptr<const VirtualFile>> parts = {
+      std::make_shared<const ByteArrayAsFile>(pattern.data(), 300),
+      std::make_shared<const ByteArrayAsFile>(pattern.data() + 300, 0),
+      std::make_shared<const ByteArrayAsFile>(pattern.data() + 300, 500),
+      std::make_shared<const ByteArrayAsFile>(pattern.data() + 800, 200)
+    };
+    std::shared_ptr<const VirtualFile> view = VirtualFile::CreateConcatenatedView(parts);
+    ASSERT_EQ(view->GetSize(), 1000U);
+
+    // Read across all part boundaries, including the empty part
+    std::vector<std::byte> bytes(1000);
+    view->ReadAt(0, 1000, bytes.data());
+    EXPECT_EQ(bytes, pattern);
+
+    view->ReadAt(250, 600, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + 600, pattern.begin() + 250));
+
+    // Borrowing only works within a single part
+    EXPECT_EQ(view->TryBorrowAt(300, 100), pattern.data() + 300);
+    EXPECT_EQ(view->TryBorrowAt(250, 100), nullptr);
+    EXPECT_THROW(view->ReadAt(990, 20, bytes.data()), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, MemoryFileServesBufferWithoutCopying) {
+    std::vector<std::byte> pattern = makeBytePattern(1000);
+    std::shared_ptr<std::byte[]> memory(new std::byte[pattern.size()]);
+    std::copy(pattern.begin(), pattern.end(), memory.get());
+
+    std::shared_ptr<const VirtualFile> file = VirtualFile::FromMemory(memory, pattern.size());
+    ASSERT_EQ(file->GetSize(), 1000U);
+
+    std::vector<std::byte> bytes(100);
+    file->ReadAt(900, 100, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin() + 900));
+
+    EXPECT_EQ(file->TryBorrowAt(123, 456), memory.get() + 123);
+    EXPECT_EQ(file->TryBorrowAt(900, 101), nullptr);
+    EXPECT_THROW(file->ReadAt(900, 101, bytes.data()), std::out_of_range);
+
+    // The file keeps the buffer alive on its own
+    memory.reset();
+    file->ReadAt(0, 100, bytes.data());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), pattern.begin()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
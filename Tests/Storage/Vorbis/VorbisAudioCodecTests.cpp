@@ -24,12 +24,15 @@ limitations under the License.
 
 #if defined(NUCLEX_AUDIO_HAVE_VORBIS)
 
+#include "Nuclex/Audio/Storage/AudioTrackDecoder.h"
+#include "../../../Source/Storage/ConcatenatedFile.h"
 #include "../FailingVirtualFile.h"
 #include "../ResourceDirectoryLocator.h"
 
 #include <gtest/gtest.h>
 
 #include <cstdint> // for std::uint8_t
+#include <stdexcept> // for std::out_of_range
 
 namespace {
 
@@ -111,6 +114,38 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(VorbisAudioCodecTest, ReportsEachLinkOfChainedFileAsTrack) {
+    std::shared_ptr<const VirtualFile> stereoFile = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg"
+    );
+    std::shared_ptr<const VirtualFile> surroundFile = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-5dot1-v142.ogg"
+    );
+    std::shared_ptr<const VirtualFile> chainedFile = std::make_shared<ConcatenatedFile>(
+      std::vector<std::shared_ptr<const VirtualFile>> { stereoFile, surroundFile }
+    );
+
+    VorbisAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(chainedFile);
+
+    ASSERT_TRUE(info.has_value());
+    ASSERT_EQ(info.value().Tracks.size(), 2U);
+    EXPECT_EQ(info.value().Tracks.at(0).ChannelCount, 2U);
+    EXPECT_EQ(info.value().Tracks.at(1).ChannelCount, 6U);
+
+    std::shared_ptr<AudioTrackDecoder> decoder = codec.TryOpenDecoder(chainedFile, u8"ogg", 1);
+    ASSERT_TRUE(static_cast<bool>(decoder));
+    EXPECT_EQ(decoder->CountChannels(), 6U);
+    EXPECT_EQ(decoder->CountFrames(), info.value().Tracks.at(1).FrameCount);
+
+    EXPECT_THROW(
+      codec.TryOpenDecoder(chainedFile, u8"ogg", 2),
+      std::out_of_range
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Vorbis
 
 #endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,140 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Vorbis/VorbisSetupCache.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "../../../Source/Storage/Shared/OggPacketReader.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the three header packets of a Vorbis file</summary>
+  /// <param name="filename">Name of the Vorbis file in the resources directory</param>
+  /// <returns>The identification, comment and setup headers</returns>
+  std::vector<std::vector<std::byte>> readHeaders(const std::string &filename) {
+    using Nuclex::Audio::Storage::Shared::OggPacketReader;
+
+    std::shared_ptr<const Nuclex::Audio::Storage::VirtualFile> file = (
+      Nuclex::Audio::Storage::VirtualFile::OpenRealFileForReading(
+        Nuclex::Audio::GetResourcesDirectory() + filename
+      )
+    );
+
+    std::vector<std::vector<std::byte>> headers;
+    OggPacketReader reader(*file);
+    OggPacketReader::Packet packet;
+    while((headers.size() < 3) && reader.ReadPacket(packet)) {
+      headers.push_back(packet.Data);
+    }
+
+    return headers;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Acquires the setup for a set of Vorbis headers from the cache</summary>
+  /// <param name="headers">Identification, comment and setup headers</param>
+  /// <returns>The setup the cache provided</returns>
+  std::shared_ptr<::vorbis_info> acquire(const std::vector<std::vector<std::byte>> &headers) {
+    return Nuclex::Audio::Storage::Vorbis::VorbisSetupCache::Acquire(
+      headers[0].data(), headers[0].size(),
+      headers[1].data(), headers[1].size(),
+      headers[2].data(), headers[2].size()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisSetupCacheTest, IdenticalSetupsAreShared) {
+    std::vector<std::vector<std::byte>> headers = readHeaders(u8"vorbis-stereo-v142.ogg");
+    ASSERT_EQ(headers.size(), 3U);
+
+    std::size_t initialSetupCount = VorbisSetupCache::CountCachedSetups();
+    {
+      std::shared_ptr<::vorbis_info> first = acquire(headers);
+      ASSERT_TRUE(static_cast<bool>(first));
+      EXPECT_EQ(first->channels, 2);
+
+      // A different comment header (another clip's tags) still matches the setup
+      std::vector<std::vector<std::byte>> retagged = headers;
+      retagged[1] = readHeaders(u8"vorbis-5dot1-v142.ogg")[1];
+      std::shared_ptr<::vorbis_info> second = acquire(retagged);
+      EXPECT_EQ(first.get(), second.get());
+      EXPECT_EQ(VorbisSetupCache::CountCachedSetups(), initialSetupCount + 1);
+
+      // The setup can be used by several synthesis states at once
+      ::vorbis_dsp_state firstState, secondState;
+      ASSERT_EQ(::vorbis_synthesis_init(&firstState, first.get()), 0);
+      ASSERT_EQ(::vorbis_synthesis_init(&secondState, second.get()), 0);
+      ::vorbis_dsp_clear(&secondState);
+      ::vorbis_dsp_clear(&firstState);
+    }
+
+    // Once nobody uses the setup anymore, it is released
+    EXPECT_EQ(VorbisSetupCache::CountCachedSetups(), initialSetupCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisSetupCacheTest, DifferentSetupsAreKeptApart) {
+    std::shared_ptr<::vorbis_info> stereo = acquire(readHeaders(u8"vorbis-stereo-v142.ogg"));
+    std::shared_ptr<::vorbis_info> surround = acquire(readHeaders(u8"vorbis-5dot1-v142.ogg"));
+    ASSERT_TRUE(static_cast<bool>(stereo));
+    ASSERT_TRUE(static_cast<bool>(surround));
+
+    EXPECT_NE(stereo.get(), surround.get());
+    EXPECT_EQ(stereo->channels, 2);
+    EXPECT_EQ(surround->channels, 6);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisSetupCacheTest, InvalidHeadersProduceNoSetup) {
+    std::vector<std::vector<std::byte>> headers = readHeaders(u8"vorbis-stereo-v142.ogg");
+    ASSERT_EQ(headers.size(), 3U);
+
+    headers[2].resize(headers[2].size() / 2);
+    EXPECT_FALSE(static_cast<bool>(acquire(headers)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -101,6 +101,27 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(VorbisTrackDecoderTest, DecodesFromStartWithoutKnowingLength) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg"
+    );
+
+    VorbisTrackDecoder lazyDecoder(file);
+    EXPECT_GT(lazyDecoder.EstimateFrameCount(), 0U);
+
+    // Decoding the first few frames must work before the length has been looked up
+    std::vector<float> samples(1000 * lazyDecoder.CountChannels());
+    lazyDecoder.DecodeInterleaved(samples.data(), 0, 1000);
+
+    // Asking for the exact length afterwards must still deliver the true length
+    VorbisTrackDecoder referenceDecoder(file);
+    std::uint64_t frameCount = referenceDecoder.CountFrames();
+    EXPECT_EQ(lazyDecoder.CountFrames(), frameCount);
+    EXPECT_EQ(lazyDecoder.EstimateFrameCount(), frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(VorbisTrackDecoderTest, DecodesToSeparatedFloatingPoint) {
     std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
       GetResourcesDirectory() + u8"vorbis-stereo-v142.ogg"
@@ -226,6 +247,49 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(VorbisTrackDecoderTest, CanReorderChannelsWhileDecoding) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"vorbis-5dot1-v142.ogg"
+    );
+
+    VorbisTrackDecoder nativeDecoder(file);
+    VorbisTrackDecoder reorderingDecoder(file);
+
+    // Switch from the Vorbis channel order to the WaveformatExtensible channel order
+    std::vector<ChannelPlacement> waveformatExtensibleOrder = {
+      ChannelPlacement::FrontLeft,
+      ChannelPlacement::FrontRight,
+      ChannelPlacement::FrontCenter,
+      ChannelPlacement::LowFrequencyEffects,
+      ChannelPlacement::BackLeft,
+      ChannelPlacement::BackRight
+    };
+    ASSERT_TRUE(reorderingDecoder.TrySetChannelOrder(waveformatExtensibleOrder));
+    EXPECT_EQ(reorderingDecoder.GetChannelOrder(), waveformatExtensibleOrder);
+
+    const std::size_t frameCount = 1000;
+    std::vector<float> nativeSamples(frameCount * 6);
+    nativeDecoder.DecodeInterleaved(nativeSamples.data(), 0, frameCount);
+    std::vector<std::int16_t> reorderedSamples(frameCount * 6);
+    reorderingDecoder.DecodeInterleaved(reorderedSamples.data(), 0, frameCount);
+
+    // Vorbis order is FL, FC, FR, BL, BR, LFE
+    const std::size_t nativeIndices[] = { 0, 2, 1, 5, 3, 4 };
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      for(std::size_t channelIndex = 0; channelIndex < 6; ++channelIndex) {
+        float expected = nativeSamples[frameIndex * 6 + nativeIndices[channelIndex]];
+        float actual = static_cast<float>(reorderedSamples[frameIndex * 6 + channelIndex]);
+        EXPECT_NEAR(actual / 32767.0f, expected, 0.0001f);
+      }
+    }
+
+    // Clones should keep delivering the channels in the order they were set to
+    std::shared_ptr<AudioTrackDecoder> clone = reorderingDecoder.Clone();
+    EXPECT_EQ(clone->GetChannelOrder(), waveformatExtensibleOrder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Vorbis
 
 #endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,180 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Vorbis/VorbisTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_VORBIS)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../../../Source/Storage/Vorbis/VorbisTrackDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <cmath> // for std::sin()
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that grows a memory buffer as it is written to</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sums up the squares of all samples in a channel</summary>
+  /// <param name="samples">Samples whose energy will be calculated</param>
+  /// <returns>The sum of the squared samples</returns>
+  double calculateEnergy(const std::vector<float> &samples) {
+    double energy = 0.0;
+    for(float sample : samples) {
+      energy += static_cast<double>(sample) * static_cast<double>(sample);
+    }
+
+    return energy;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Vorbis {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisTrackEncoderBuilderTest, BuildThrowsExceptionWithoutInputChannels) {
+    std::shared_ptr<VorbisTrackEncoderBuilder> builder = (
+      std::make_shared<VorbisTrackEncoderBuilder>()
+    );
+
+    EXPECT_THROW(
+      builder->Build(std::shared_ptr<VirtualFile>()),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisTrackEncoderBuilderTest, OnlyAcceptsFloatingPointSampleFormat) {
+    VorbisTrackEncoderBuilder builder;
+    EXPECT_THROW(
+      builder.SetSampleFormat(AudioSampleFormat::SignedInteger_16), std::invalid_argument
+    );
+    EXPECT_NO_THROW(builder.SetSampleFormat(AudioSampleFormat::Float_32));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisTrackEncoderBuilderTest, RejectsChannelLayoutsOutsideOfVorbisSpecification) {
+    VorbisTrackEncoderBuilder builder;
+    EXPECT_THROW(
+      builder.SetChannels({ ChannelPlacement::FrontLeft, ChannelPlacement::FrontCenter }),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VorbisTrackEncoderBuilderTest, EncodedChannelsEndUpInVorbisOrder) {
+    const std::size_t frameCount = 48000;
+
+    // Feed the channels in reverse order with only the left channel carrying a signal
+    std::vector<float> left(frameCount), right(frameCount, 0.0f);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      left[index] = 0.5f * std::sin(static_cast<float>(index) * 0.0575f); // ~440 Hz
+    }
+
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+    {
+      VorbisTrackEncoderBuilder builder;
+      std::shared_ptr<AudioTrackEncoder> encoder = builder.
+        SetChannels({ ChannelPlacement::FrontRight, ChannelPlacement::FrontLeft }).
+        SetSampleRate(48000).
+        SetTargetBitrate(128.0f).
+        Build(file);
+
+      const float *buffers[] = { right.data(), left.data() };
+      encoder->EncodeSeparated(buffers, frameCount);
+      encoder->Flush();
+    }
+
+    std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<VorbisTrackDecoder>(file);
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+    ASSERT_EQ(decoder->CountFrames(), frameCount);
+
+    std::vector<float> decodedLeft(frameCount), decodedRight(frameCount);
+    float *decodedBuffers[] = { decodedLeft.data(), decodedRight.data() };
+    decoder->DecodeSeparated(decodedBuffers, 0, frameCount);
+
+    EXPECT_GT(calculateEnergy(decodedLeft), 1000.0);
+    EXPECT_LT(calculateEnergy(decodedRight), 1.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Vorbis
+
+#endif // defined(NUCLEX_AUDIO_HAVE_VORBIS)
@@ -0,0 +1,111 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/WavPack/WavPackBlockScanner.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+
+#include "../ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackBlockScannerTest, CanWalkAllBlocks) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"wavpack-stereo-int16-v416.wv"
+    );
+    WavPackBlockScanner scanner(*file);
+    EXPECT_EQ(scanner.CountTotalSamples(), 44100);
+
+    std::uint64_t nextSample = 0;
+    std::size_t blockCount = 0;
+
+    WavPackBlockScanner::Block block;
+    std::uint64_t offset = 0;
+    while(scanner.TryReadBlock(offset, block)) {
+      EXPECT_EQ(block.FirstSample, nextSample);
+      EXPECT_NE(block.Flags & WavPackBlockScanner::InitialBlockFlag, 0U);
+      nextSample += block.SampleCount;
+      offset = block.Offset + block.Length;
+      ++blockCount;
+    }
+
+    EXPECT_EQ(nextSample, 44100U);
+    EXPECT_EQ(blockCount, 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackBlockScannerTest, FindsFirstBlockOfGroupHoldingSample) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"wavpack-5dot1-int16-v416.wv"
+    );
+    WavPackBlockScanner scanner(*file);
+
+    WavPackBlockScanner::Block block = scanner.FindBlock(30000);
+    EXPECT_LE(block.FirstSample, 30000U);
+    EXPECT_GT(block.FirstSample + block.SampleCount, 30000U);
+    EXPECT_NE(block.Flags & WavPackBlockScanner::InitialBlockFlag, 0U);
+
+    EXPECT_THROW(scanner.FindBlock(44100), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackBlockScannerTest, RewritingBlockInPlaceKeepsItIntact) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"wavpack-stereo-int16-v416.wv"
+    );
+    WavPackBlockScanner scanner(*file);
+
+    // The second block carries no whole-file metadata, so rewriting it with its own
+    // index and total must reproduce it byte for byte, including its checksum
+    WavPackBlockScanner::Block block = scanner.FindBlock(30000);
+    std::vector<std::byte> blockData;
+    ASSERT_TRUE(scanner.TryReadBlock(block.Offset, block, &blockData));
+
+    std::vector<std::byte> rewritten;
+    WavPackBlockScanner::RewriteBlock(
+      blockData, block.FirstSample, 44100, std::vector<std::byte>(), rewritten
+    );
+    EXPECT_EQ(rewritten, blockData);
+
+    // Moving it somewhere else changes the header, but not the length
+    WavPackBlockScanner::RewriteBlock(
+      blockData, 1000, 23050, std::vector<std::byte>(), rewritten
+    );
+    EXPECT_EQ(rewritten.size(), blockData.size());
+    EXPECT_NE(rewritten, blockData);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -0,0 +1,207 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/WavPack/WavPackTrackEncoderBuilder.h"
+
+#if defined(NUCLEX_AUDIO_HAVE_WAVPACK)
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../../../Source/Storage/WavPack/WavPackTrackDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that grows a memory buffer as it is written to</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+    }
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a stereo test signal that does not compress too well</summary>
+  /// <param name="frameCount">Number of audio frames to generate</param>
+  /// <returns>Interleaved stereo samples with 12 bits of noise in them</returns>
+  std::vector<std::int16_t> generateNoise(std::size_t frameCount) {
+    std::vector<std::int16_t> samples(frameCount * 2);
+    std::uint32_t noise = 12345;
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      noise = noise * 1664525U + 1013904223U;
+      samples[index] = static_cast<std::int16_t>(noise >> 20); // 12 bits of noise
+    }
+
+    return samples;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace WavPack {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackTrackEncoderBuilderTest, BuildThrowsExceptionWithoutInputChannels) {
+    std::shared_ptr<WavPackTrackEncoderBuilder> builder = (
+      std::make_shared<WavPackTrackEncoderBuilder>()
+    );
+
+    EXPECT_THROW(
+      builder->Build(std::shared_ptr<VirtualFile>()),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackTrackEncoderBuilderTest, RejectsBitratesOutsideOfHybridRange) {
+    WavPackTrackEncoderBuilder builder;
+    EXPECT_THROW(builder.SetTargetBitrate(8.0f), std::invalid_argument);
+    EXPECT_THROW(builder.SetTargetBitrate(20000.0f), std::invalid_argument);
+    EXPECT_NO_THROW(builder.SetTargetBitrate(320.0f));
+    EXPECT_FALSE(builder.IsLossless());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackTrackEncoderBuilderTest, CorrectionFileRequiresHybridMode) {
+    WavPackTrackEncoderBuilder builder;
+    builder.SetStereoChannels().SetSampleRate(44100);
+    builder.SetCorrectionFile(std::make_shared<GrowingMemoryFile>());
+
+    EXPECT_THROW(builder.Build(std::make_shared<GrowingMemoryFile>()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackTrackEncoderBuilderTest, LosslessEncodingRoundTrips) {
+    std::vector<std::int16_t> samples = generateNoise(100000);
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+    {
+      WavPackTrackEncoderBuilder builder;
+      std::shared_ptr<AudioTrackEncoder> encoder = builder.
+        SetStereoChannels().
+        SetSampleRate(44100).
+        SetCompressionEffort(0.5f).
+        Build(file);
+
+      // Feed the samples in odd-sized pieces so they don't line up with any block
+      const std::size_t pieceFrameCount = 10007;
+      std::size_t frameCount = samples.size() / 2;
+      for(std::size_t start = 0; start < frameCount; start += pieceFrameCount) {
+        std::size_t count = std::min(pieceFrameCount, frameCount - start);
+        encoder->EncodeInterleaved(samples.data() + start * 2, count);
+      }
+      encoder->Flush();
+    }
+
+    std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<WavPackTrackDecoder>(file);
+    ASSERT_EQ(decoder->CountChannels(), 2U);
+    ASSERT_EQ(decoder->CountFrames(), samples.size() / 2);
+
+    std::vector<std::int16_t> decoded(samples.size());
+    decoder->DecodeInterleaved(decoded.data(), 0, samples.size() / 2);
+    EXPECT_EQ(decoded, samples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WavPackTrackEncoderBuilderTest, HybridModeWritesCorrectionFile) {
+    std::vector<std::int16_t> samples = generateNoise(100000);
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+    std::shared_ptr<GrowingMemoryFile> correctionFile = std::make_shared<GrowingMemoryFile>();
+    {
+      WavPackTrackEncoderBuilder builder;
+      builder.SetCorrectionFile(correctionFile);
+
+      std::shared_ptr<AudioTrackEncoder> encoder = builder.
+        SetStereoChannels().
+        SetSampleRate(44100).
+        SetTargetBitrate(192.0f).
+        Build(file);
+      EXPECT_TRUE(builder.IsLossless());
+
+      encoder->EncodeInterleaved(samples.data(), samples.size() / 2);
+      encoder->Flush();
+    }
+
+    // At 192 kbps, the main file holds about 54 KiB for the 2.27 seconds of audio,
+    // so most of the noise has to go into the correction file
+    EXPECT_GT(correctionFile->GetSize(), 0U);
+    EXPECT_LT(file->GetSize(), samples.size() * sizeof(std::int16_t) / 2);
+
+    // Without the correction file, the decoder still delivers the lossy version
+    std::shared_ptr<AudioTrackDecoder> decoder = std::make_shared<WavPackTrackDecoder>(file);
+    EXPECT_EQ(decoder->CountFrames(), samples.size() / 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::WavPack
+
+#endif // defined(NUCLEX_AUDIO_HAVE_WAVPACK)
@@ -21,16 +21,209 @@ limitations under the License.
 #define NUCLEX_AUDIO_SOURCE 1
 
 #include "../../../Source/Storage/Waveform/WaveformAudioCodec.h"
+#include "Nuclex/Audio/Errors/CorruptedFileError.h"
+#include "Nuclex/Audio/Storage/InstrumentedFile.h"
 #include "../FailingVirtualFile.h"
+#include "../ByteArrayAsFile.h"
 #include "../ResourceDirectoryLocator.h"
 
 #include <gtest/gtest.h>
 
 #include <cstdint> // for std::uint8_t
+#include <vector> // for std::vector
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a little endian 32-bit integer to a byte buffer</summary>
+  /// <param name="bytes">Buffer the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  void appendUInt32(std::vector<std::byte> &bytes, std::uint32_t value) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      bytes.push_back(static_cast<std::byte>((value >> (index * 8)) & 0xFF));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a FourCC to a byte buffer</summary>
+  /// <param name="bytes">Buffer the FourCC will be appended to</param>
+  /// <param name="fourCC">Four characters that will be appended</param>
+  void appendFourCC(std::vector<std::byte> &bytes, const char *fourCC) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      bytes.push_back(static_cast<std::byte>(fourCC[index]));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a chunk's FourCC and length to a byte buffer</summary>
+  /// <param name="bytes">Buffer the chunk header will be appended to</param>
+  /// <param name="fourCC">Four characters identifying the chunk</param>
+  /// <param name="length">Length of the chunk's contents</param>
+  void appendChunkHeader(std::vector<std::byte> &bytes, const char *fourCC, std::uint32_t length) {
+    appendFourCC(bytes, fourCC);
+    appendUInt32(bytes, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a silent 16-bit Waveform file with the specified format fields</summary>
+  /// <param name="channelCount">Number of channels stated in the 'fmt ' chunk</param>
+  /// <param name="sampleRate">Sample rate stated in the 'fmt ' chunk</param>
+  /// <param name="blockAlignment">Block alignment stated in the 'fmt ' chunk</param>
+  /// <param name="bitsPerSample">Bits per sample stated in the 'fmt ' chunk</param>
+  /// <returns>The contents of the Waveform file</returns>
+  std::vector<std::byte> makeWaveform(
+    std::uint16_t channelCount, std::uint32_t sampleRate,
+    std::uint16_t blockAlignment, std::uint16_t bitsPerSample
+  ) {
+    std::vector<std::byte> bytes;
+    appendChunkHeader(bytes, u8"RIFF", 4 + (8 + 16) + (8 + 400));
+    appendFourCC(bytes, u8"WAVE");
+
+    appendChunkHeader(bytes, u8"fmt ", 16);
+    appendUInt32(bytes, 0x0001 | (std::uint32_t(channelCount) << 16)); // PCM
+    appendUInt32(bytes, sampleRate);
+    appendUInt32(bytes, sampleRate * blockAlignment); // bytes per second
+    appendUInt32(bytes, blockAlignment | (std::uint32_t(bitsPerSample) << 16));
+
+    appendChunkHeader(bytes, u8"data", 400);
+    bytes.resize(bytes.size() + 400);
+
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a silent 16-bit mono Waveform file with a 'smpl' loop</summary>
+  /// <param name="frameCount">Number of frames of audio data in the file</param>
+  /// <param name="loopStart">First frame of the loop</param>
+  /// <param name="loopLast">Last frame of the loop (inclusive, as in the chunk)</param>
+  /// <returns>The contents of the Waveform file</returns>
+  std::vector<std::byte> makeLoopedWaveform(
+    std::uint32_t frameCount, std::uint32_t loopStart, std::uint32_t loopLast
+  ) {
+    std::vector<std::byte> bytes;
+    appendChunkHeader(bytes, u8"RIFF", 4 + (8 + 16) + (8 + frameCount * 2) + (8 + 60));
+    appendFourCC(bytes, u8"WAVE");
+
+    appendChunkHeader(bytes, u8"fmt ", 16);
+    appendUInt32(bytes, 0x00010001); // PCM, 1 channel
+    appendUInt32(bytes, 8000); // sample rate
+    appendUInt32(bytes, 16000); // bytes per second
+    appendUInt32(bytes, 0x00100002); // 2 bytes per frame, 16 bits per sample
+
+    appendChunkHeader(bytes, u8"data", frameCount * 2);
+    bytes.resize(bytes.size() + frameCount * 2);
+
+    appendChunkHeader(bytes, u8"smpl", 60);
+    for(std::size_t index = 0; index < 7; ++index) {
+      appendUInt32(bytes, 0); // manufacturer, product, period, MIDI and SMPTE fields
+    }
+    appendUInt32(bytes, 1); // loop count
+    appendUInt32(bytes, 0); // sampler data length
+    appendUInt32(bytes, 0); // cue point id
+    appendUInt32(bytes, 0); // forward loop
+    appendUInt32(bytes, loopStart);
+    appendUInt32(bytes, loopLast);
+    appendUInt32(bytes, 0); // fraction
+    appendUInt32(bytes, 0); // play forever
+
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a silent 16-bit mono Waveform file with three cue points</summary>
+  /// <returns>The contents of the Waveform file</returns>
+  /// <remarks>
+  ///   The associated data list comes before the 'cue ' chunk and the cue points are
+  ///   not stored in the order of their positions.
+  /// </remarks>
+  std::vector<std::byte> makeMarkedWaveform() {
+    const std::uint32_t listLength = 4 + (8 + 10) + (8 + 20) + (8 + 8);
+    const std::uint32_t cueLength = 4 + 3 * 24;
+
+    std::vector<std::byte> bytes;
+    appendChunkHeader(
+      bytes, u8"RIFF", 4 + (8 + 16) + (8 + listLength) + (8 + cueLength) + (8 + 200)
+    );
+    appendFourCC(bytes, u8"WAVE");
+
+    appendChunkHeader(bytes, u8"fmt ", 16);
+    appendUInt32(bytes, 0x00010001); // PCM, 1 channel
+    appendUInt32(bytes, 8000); // sample rate
+    appendUInt32(bytes, 16000); // bytes per second
+    appendUInt32(bytes, 0x00100002); // 2 bytes per frame, 16 bits per sample
+
+    appendChunkHeader(bytes, u8"LIST", listLength);
+    appendFourCC(bytes, u8"adtl");
+    appendChunkHeader(bytes, u8"labl", 10);
+    appendUInt32(bytes, 2); // cue point id
+    appendFourCC(bytes, u8"Jump");
+    bytes.push_back(std::byte(0));
+    bytes.push_back(std::byte(0)); // terminator + padding
+    appendChunkHeader(bytes, u8"ltxt", 20);
+    appendUInt32(bytes, 3); // cue point id
+    appendUInt32(bytes, 25); // region length in frames
+    appendFourCC(bytes, u8"rgn ");
+    appendUInt32(bytes, 0); // country and language
+    appendUInt32(bytes, 0); // dialect and code page
+    appendChunkHeader(bytes, u8"note", 8);
+    appendUInt32(bytes, 1); // cue point id
+    appendFourCC(bytes, u8"Hey!");
+
+    appendChunkHeader(bytes, u8"cue ", cueLength);
+    appendUInt32(bytes, 3); // cue point count
+    const std::uint32_t cuePoints[3][2] = { { 1, 80 }, { 2, 20 }, { 3, 50 } };
+    for(std::size_t index = 0; index < 3; ++index) {
+      appendUInt32(bytes, cuePoints[index][0]); // id
+      appendUInt32(bytes, 0); // play order position
+      appendFourCC(bytes, u8"data");
+      appendUInt32(bytes, 0); // chunk start
+      appendUInt32(bytes, 0); // block start
+      appendUInt32(bytes, cuePoints[index][1]); // sample offset
+    }
+
+    appendChunkHeader(bytes, u8"data", 200);
+    bytes.resize(bytes.size() + 200);
+
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a silent 16-bit mono Waveform file with huge chunks before its data</summary>
+  /// <param name="junkLength">Length of each of the chunks preceding the audio data</param>
+  /// <returns>The contents of the Waveform file</returns>
+  std::vector<std::byte> makeBloatedWaveform(std::uint32_t junkLength) {
+    std::vector<std::byte> bytes;
+    appendChunkHeader(
+      bytes, u8"RIFF", 4 + (8 + 16) + (8 + junkLength) + (8 + junkLength) + (8 + 200)
+    );
+    appendFourCC(bytes, u8"WAVE");
+
+    appendChunkHeader(bytes, u8"fmt ", 16);
+    appendUInt32(bytes, 0x00010001); // PCM, 1 channel
+    appendUInt32(bytes, 8000); // sample rate
+    appendUInt32(bytes, 16000); // bytes per second
+    appendUInt32(bytes, 0x00100002); // 2 bytes per frame, 16 bits per sample
+
+    appendChunkHeader(bytes, u8"LIST", junkLength);
+    appendFourCC(bytes, u8"INFO");
+    bytes.resize(bytes.size() + junkLength - 4);
+
+    appendChunkHeader(bytes, u8"iXML", junkLength);
+    bytes.resize(bytes.size() + junkLength);
+
+    appendChunkHeader(bytes, u8"data", 200);
+    bytes.resize(bytes.size() + 200);
+
+    return bytes;
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -104,4 +297,157 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+TEST(WaveformAudioCodecTest, ReadsLoopFromSamplerChunk) {
+    std::vector<std::byte> contents = makeLoopedWaveform(100, 10, 49);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+
+    const TrackInfo &track = info.value().Tracks.at(0);
+    EXPECT_EQ(track.FrameCount, 100U);
+    EXPECT_EQ(track.LeadingPaddingFrameCount, 0U);
+    ASSERT_TRUE(track.Loop.has_value());
+    EXPECT_EQ(track.Loop->StartFrame, 10U);
+    EXPECT_EQ(track.Loop->EndFrame, 50U);
+    EXPECT_EQ(track.Loop->PlayCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, HugeChunksAreSkippedWithoutReadingThem) {
+    const std::uint32_t junkLength = 4 * 1024 * 1024;
+    std::vector<std::byte> contents = makeBloatedWaveform(junkLength);
+    std::shared_ptr<InstrumentedFile> file = std::make_shared<InstrumentedFile>(
+      std::static_pointer_cast<const VirtualFile>(
+        std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+      )
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+    ASSERT_EQ(info.value().Tracks.size(), 1U);
+    EXPECT_EQ(info.value().Tracks[0].ChannelCount, 1U);
+    EXPECT_EQ(info.value().Tracks[0].SampleRate, 8000U);
+
+    // Only the RIFF header and the chunk headers should have been read
+    FileAccessSummary summary = file->GetSummary();
+    EXPECT_LE(summary.ReadCount, 4U);
+    EXPECT_LT(summary.ReadByteCount, 256U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, FilesWithoutChannelsOrSampleRateAreRejected) {
+    WaveformAudioCodec codec;
+
+    std::vector<std::byte> noChannels = makeWaveform(0, 8000, 2, 16);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      noChannels.data(), noChannels.size()
+    );
+    EXPECT_THROW(codec.TryReadInfo(file), Errors::CorruptedFileError);
+
+    std::vector<std::byte> noSampleRate = makeWaveform(1, 0, 2, 16);
+    file = std::make_shared<ByteArrayAsFile>(noSampleRate.data(), noSampleRate.size());
+    EXPECT_THROW(codec.TryReadInfo(file), Errors::CorruptedFileError);
+
+    std::vector<std::byte> noBits = makeWaveform(1, 8000, 0, 0);
+    file = std::make_shared<ByteArrayAsFile>(noBits.data(), noBits.size());
+    EXPECT_THROW(codec.TryReadInfo(file), Errors::CorruptedFileError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, FrameSizeFallsBackToBitsPerSampleForZeroBlockAlignment) {
+    std::vector<std::byte> contents = makeWaveform(2, 8000, 0, 16);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info.value().Tracks.at(0).FrameCount, 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, LoopsPastTheAudioDataAreCutOff) {
+    std::vector<std::byte> contents = makeLoopedWaveform(100, 10, 199);
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+
+    const TrackInfo &track = info.value().Tracks.at(0);
+    ASSERT_TRUE(track.Loop.has_value());
+    EXPECT_EQ(track.Loop->EndFrame, 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, ReadsMarkersFromCueChunkAndAssociatedData) {
+    std::vector<std::byte> contents = makeMarkedWaveform();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+
+    const TrackInfo &track = info.value().Tracks.at(0);
+    EXPECT_EQ(track.FrameCount, 100U);
+    ASSERT_EQ(track.Markers.size(), 3U);
+
+    EXPECT_EQ(track.Markers[0].Id, 2U);
+    EXPECT_EQ(track.Markers[0].StartFrame, 20U);
+    EXPECT_EQ(track.Markers[0].FrameCount, 0U);
+    ASSERT_TRUE(track.Markers[0].Label.has_value());
+    EXPECT_EQ(track.Markers[0].Label.value(), u8"Jump");
+
+    EXPECT_EQ(track.Markers[1].Id, 3U);
+    EXPECT_EQ(track.Markers[1].StartFrame, 50U);
+    EXPECT_EQ(track.Markers[1].FrameCount, 25U);
+    EXPECT_FALSE(track.Markers[1].Label.has_value());
+
+    EXPECT_EQ(track.Markers[2].Id, 1U);
+    EXPECT_EQ(track.Markers[2].StartFrame, 80U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformAudioCodecTest, MarkersCanBeLookedUpByRange) {
+    std::vector<std::byte> contents = makeMarkedWaveform();
+    std::shared_ptr<const VirtualFile> file = std::make_shared<ByteArrayAsFile>(
+      contents.data(), contents.size()
+    );
+
+    WaveformAudioCodec codec;
+    std::optional<ContainerInfo> info = codec.TryReadInfo(file);
+    ASSERT_TRUE(info.has_value());
+
+    const TrackInfo &track = info.value().Tracks.at(0);
+
+    std::pair<std::size_t, std::size_t> range = track.FindMarkers(20, 80);
+    EXPECT_EQ(range.first, 0U);
+    EXPECT_EQ(range.second, 2U);
+
+    range = track.FindMarkers(21, 100);
+    EXPECT_EQ(range.first, 1U);
+    EXPECT_EQ(range.second, 3U);
+
+    range = track.FindMarkers(81, 100);
+    EXPECT_EQ(range.first, range.second);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Waveform
@@ -42,6 +42,19 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Binary contents of a tiny BW64 file with a 'ds64' chunk</summary>
+  std::uint8_t smallBroadcastWave64File[84] = {
+    0x42, 0x57, 0x36, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0x57, 0x41, 0x56, 0x45,
+    0x64, 0x73, 0x36, 0x34, 0x1C, 0x00, 0x00, 0x00, 0x4C, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x66, 0x6D, 0x74, 0x20, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00,
+    0x44, 0xAC, 0x00, 0x00, 0x88, 0x58, 0x01, 0x00, 0x02, 0x00, 0x10, 0x00,
+    0x64, 0x61, 0x74, 0x61, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
@@ -71,4 +84,14 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(WaveformDetectionTest, DetectsRf64Files) {
+    const ByteArrayAsFile broadcastWave64File(
+      reinterpret_cast<const std::byte *>(smallBroadcastWave64File),
+      sizeof(smallBroadcastWave64File)
+    );
+    EXPECT_TRUE(Detection::CheckIfWaveformHeaderPresent(broadcastWave64File));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Audio::Storage::Waveform
@@ -28,12 +28,87 @@ limitations under the License.
 #include "../TestAudioVerifier.h"
 #include "../../Processing/SineWaveDetector.h"
 #include "../../ExpectRange.h"
+#include "../../AllocationCounter.h"
 
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Processing/Int24Packing.h"
 #include "Nuclex/Audio/Processing/SampleConverter.h"
+#include "Nuclex/Audio/Storage/DecodeLatencyTracker.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a 16-bit integer in big endian byte order</summary>
+  /// <param name="bytes">Byte array to which the integer will be appended</param>
+  /// <param name="value">Value that will be appended</param>
+  void appendBigEndian16(std::vector<std::byte> &bytes, std::uint16_t value) {
+    bytes.push_back(static_cast<std::byte>(value >> 8));
+    bytes.push_back(static_cast<std::byte>(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a 32-bit integer in big endian byte order</summary>
+  /// <param name="bytes">Byte array to which the integer will be appended</param>
+  /// <param name="value">Value that will be appended</param>
+  void appendBigEndian32(std::vector<std::byte> &bytes, std::uint32_t value) {
+    appendBigEndian16(bytes, static_cast<std::uint16_t>(value >> 16));
+    appendBigEndian16(bytes, static_cast<std::uint16_t>(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a FourCC tag to a byte array</summary>
+  /// <param name="bytes">Byte array to which the FourCC will be appended</param>
+  /// <param name="fourCC">FourCC that will be appended</param>
+  void appendFourCC(std::vector<std::byte> &bytes, const char *fourCC) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      bytes.push_back(static_cast<std::byte>(fourCC[index]));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a big endian (RIFX) Waveform file holding the specified samples</summary>
+  /// <param name="formatTag">1 for integer PCM, 3 for floating point PCM</param>
+  /// <param name="channelCount">Number of interleaved channels in the samples</param>
+  /// <param name="bitsPerSample">Number of bits in each sample</param>
+  /// <param name="samples">Samples, already in big endian byte order</param>
+  /// <returns>The contents of a Waveform file with the samples</returns>
+  std::vector<std::byte> makeBigEndianWaveform(
+    std::uint16_t formatTag, std::uint16_t channelCount, std::uint16_t bitsPerSample,
+    const std::vector<std::byte> &samples
+  ) {
+    std::uint16_t blockAlignment = static_cast<std::uint16_t>(
+      channelCount * ((bitsPerSample + 7) / 8)
+    );
+
+    std::vector<std::byte> file;
+    appendFourCC(file, "RIFX");
+    appendBigEndian32(file, static_cast<std::uint32_t>(4 + 8 + 16 + 8 + samples.size()));
+    appendFourCC(file, "WAVE");
+
+    appendFourCC(file, "fmt ");
+    appendBigEndian32(file, 16);
+    appendBigEndian16(file, formatTag);
+    appendBigEndian16(file, channelCount);
+    appendBigEndian32(file, 44100);
+    appendBigEndian32(file, 44100 * blockAlignment);
+    appendBigEndian16(file, blockAlignment);
+    appendBigEndian16(file, bitsPerSample);
+
+    appendFourCC(file, "data");
+    appendBigEndian32(file, static_cast<std::uint32_t>(samples.size()));
+    file.insert(file.end(), samples.begin(), samples.end());
+
+    return file;
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
@@ -115,6 +190,729 @@ namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
   }
 
   // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, OnlyAcceptsStandardFidelity) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    // Uncompressed audio has nothing to trade, it's always decoded exactly
+    EXPECT_TRUE(decoder.TrySetDecodeFidelity(DecodeFidelity::Standard));
+    EXPECT_FALSE(decoder.TrySetDecodeFidelity(DecodeFidelity::Reduced));
+    EXPECT_FALSE(decoder.TrySetDecodeFidelity(DecodeFidelity::Enhanced));
+    EXPECT_FALSE(decoder.TrySetDecodeSampleRate(22050));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, HasNoChecksumsToVerify) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    EXPECT_TRUE(decoder.TrySetVerificationPolicy(VerificationPolicy::Off));
+    EXPECT_FALSE(decoder.TrySetVerificationPolicy(VerificationPolicy::Immediate));
+    EXPECT_FALSE(decoder.TrySetVerificationPolicy(VerificationPolicy::Background));
+    EXPECT_EQ(decoder.GetVerificationResult(), VerificationResult::NotChecked);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesToHalfPrecisionFloats) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<float> expected(frameCount * channelCount);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Half precision floats have 11 significant bits, so they can't pass the sine wave
+    // verification's error threshold, but should be as close as their precision allows
+    std::vector<Float16> halves(frameCount * channelCount);
+    decoder.DecodeInterleaved(halves.data(), 0, frameCount);
+    std::vector<float> samples(frameCount * channelCount);
+    Processing::ConversionKernels::ConvertFromFloat16(
+      halves.data(), samples.data(), samples.size()
+    );
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      EXPECT_NEAR(samples[index], expected[index], 0.0005f);
+    }
+
+    // Brain floats only have 8 significant bits, but the full exponent range of floats
+    std::vector<BFloat16> leftChannel(frameCount);
+    BFloat16 *channels[] = { leftChannel.data(), nullptr };
+    decoder.DecodeSeparated(channels, 0, frameCount);
+    std::vector<float> leftSamples(frameCount);
+    Processing::ConversionKernels::ConvertFromBFloat16(
+      leftChannel.data(), leftSamples.data(), frameCount
+    );
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      EXPECT_NEAR(leftSamples[index], expected[index * 2], 0.004f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesToPackedInt24) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<std::int32_t> expected(frameCount * channelCount);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // The file stores 24-bit samples, so packing them again must be lossless. When widening
+    // to 32 bits, the decoder repeats the upper bits in the lowest byte, which is dropped.
+    std::vector<PackedInt24> packed(frameCount * channelCount);
+    decoder.DecodeInterleaved(packed.data(), 0, frameCount);
+    std::vector<std::int32_t> samples(frameCount * channelCount);
+    Processing::Int24Packing::UnpackToInt32(
+      reinterpret_cast<const std::byte *>(packed.data()), samples.data(), samples.size()
+    );
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      EXPECT_EQ(samples[index], expected[index] >> 8);
+    }
+
+    std::vector<PackedInt24> rightChannel(frameCount);
+    PackedInt24 *channels[] = { nullptr, rightChannel.data() };
+    decoder.DecodeSeparated(channels, 0, frameCount);
+    std::vector<std::int32_t> rightSamples(frameCount);
+    Processing::Int24Packing::UnpackToInt32(
+      reinterpret_cast<const std::byte *>(rightChannel.data()), rightSamples.data(), frameCount
+    );
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      EXPECT_EQ(rightSamples[index], expected[index * 2 + 1] >> 8);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesIntoSliceOfWiderBuffer) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::vector<float> expected(frameCount * 2);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    // Place the stereo track into channels 2 and 3 of an 8 channel bus
+    std::vector<float> bus(frameCount * 8, 0.25f);
+    decoder.DecodeInterleaved(bus.data(), 8, 2, 0, frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      ASSERT_EQ(bus[index * 8 + 1], 0.25f);
+      ASSERT_EQ(bus[index * 8 + 2], expected[index * 2]);
+      ASSERT_EQ(bus[index * 8 + 3], expected[index * 2 + 1]);
+      ASSERT_EQ(bus[index * 8 + 4], 0.25f);
+    }
+
+    // Mixing the same track in again should double the samples
+    decoder.DecodeInterleaved(bus.data(), 8, 2, 0, frameCount, true);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      ASSERT_EQ(bus[index * 8 + 2], expected[index * 2] * 2.0f);
+      ASSERT_EQ(bus[index * 8 + 3], expected[index * 2 + 1] * 2.0f);
+    }
+
+    std::vector<std::int16_t> narrowBus(frameCount * 3);
+    EXPECT_THROW(
+      decoder.DecodeInterleaved(narrowBus.data(), 3, 2, 0, frameCount),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, ClampsAccumulatedIntegerSamples) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::vector<std::int16_t> expected(frameCount * 2);
+    decoder.DecodeInterleaved(expected.data(), 0, frameCount);
+
+    std::vector<std::int16_t> bus(frameCount * 2, 30000);
+    decoder.DecodeInterleaved(bus.data(), 2, 0, 0, frameCount, true);
+    for(std::size_t index = 0; index < bus.size(); ++index) {
+      ASSERT_EQ(bus[index], std::min(30000 + expected[index], 32767));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, ClonesDecodeIndependently) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    std::shared_ptr<AudioTrackDecoder> clone = decoder.Clone();
+    ASSERT_TRUE(static_cast<bool>(clone));
+
+    EXPECT_EQ(clone->CountChannels(), decoder.CountChannels());
+    EXPECT_EQ(clone->CountFrames(), decoder.CountFrames());
+    EXPECT_EQ(clone->GetChannelOrder(), decoder.GetChannelOrder());
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    // Decode the second half first from the original so the clone's results can't
+    // depend on a shared position in the file
+    std::vector<float> originalSamples(frameCount * channelCount);
+    std::size_t halfFrameCount = frameCount / 2;
+    decoder.DecodeInterleaved(
+      originalSamples.data() + halfFrameCount * channelCount,
+      halfFrameCount,
+      frameCount - halfFrameCount
+    );
+
+    std::vector<float> clonedSamples(frameCount * channelCount);
+    clone->DecodeInterleaved(clonedSamples.data(), 0, frameCount);
+
+    decoder.DecodeInterleaved(originalSamples.data(), 0, halfFrameCount);
+
+    EXPECT_EQ(clonedSamples, originalSamples);
+    TestAudioVerifier::VerifyStereo(clonedSamples, channelCount, 44100);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, StatisticsStayZeroUnlessEnabled) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::vector<float> samples(frameCount * decoder.CountChannels());
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    DecoderStatistics statistics = decoder.GetStatistics();
+    EXPECT_EQ(statistics.DecodedFrameCount, 0U);
+    EXPECT_EQ(statistics.ReadByteCount, 0U);
+    EXPECT_EQ(statistics.DecodeTime.count(), 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, StatisticsCountDecodedFramesAndBytes) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    decoder.EnableStatistics();
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+    std::size_t halfFrameCount = frameCount / 2;
+
+    std::vector<float> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, halfFrameCount);
+    decoder.DecodeInterleaved(
+      samples.data() + halfFrameCount * channelCount,
+      halfFrameCount,
+      frameCount - halfFrameCount
+    );
+
+    DecoderStatistics statistics = decoder.GetStatistics();
+    EXPECT_EQ(statistics.DecodedFrameCount, frameCount);
+    EXPECT_EQ(statistics.ReadByteCount, frameCount * channelCount * sizeof(float));
+    EXPECT_EQ(statistics.SeekCount, 0U);
+    EXPECT_EQ(statistics.LockWaitTime.count(), 0);
+
+    // Clones inherit the setting but count on their own
+    std::shared_ptr<AudioTrackDecoder> clone = decoder.Clone();
+    clone->DecodeInterleaved(samples.data(), 0, halfFrameCount);
+    EXPECT_EQ(clone->GetStatistics().DecodedFrameCount, halfFrameCount);
+    EXPECT_EQ(decoder.GetStatistics().DecodedFrameCount, frameCount);
+
+    // Switching statistics back on starts over from zero
+    decoder.EnableStatistics(false);
+    decoder.EnableStatistics(true);
+    EXPECT_EQ(decoder.GetStatistics().DecodedFrameCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodeLatenciesAreRecordedPerCall) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    EXPECT_EQ(decoder.GetDecodeLatencies().CallCount, 0U);
+
+    decoder.EnableStatistics();
+
+    std::size_t channelCount = decoder.CountChannels();
+    std::vector<float> samples(64 * channelCount);
+    for(std::size_t index = 0; index < 3; ++index) {
+      decoder.DecodeInterleaved(samples.data(), index * 64, 64);
+    }
+
+    LatencyHistogram latencies = decoder.GetDecodeLatencies(true);
+    EXPECT_EQ(latencies.CallCount, 3U);
+    ASSERT_EQ(latencies.BucketCounts.size(), LatencyHistogram::BucketCount);
+    EXPECT_LE(latencies.GetPercentile(0.5), latencies.LongestTime);
+    EXPECT_LE(latencies.LongestTime, latencies.TotalTime);
+
+    // Resetting while taking the snapshot lets the next one start from zero
+    EXPECT_EQ(decoder.GetDecodeLatencies().CallCount, 0U);
+    EXPECT_TRUE(decoder.GetDecodeLatencies().BucketCounts.empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodeLatencyTrackerGroupsByCodecAndCallSize) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    std::size_t channelCount = decoder.CountChannels();
+    std::vector<float> samples(1000 * channelCount);
+
+    DecodeLatencyTracker::Enable();
+    decoder.DecodeInterleaved(samples.data(), 0, 32);
+    decoder.DecodeInterleaved(samples.data(), 0, 1000);
+    decoder.DecodeInterleaved(samples.data(), 0, 1000);
+    std::vector<DecodeLatencyGroup> groups = DecodeLatencyTracker::TakeSnapshot(true);
+    DecodeLatencyTracker::Enable(false);
+
+    ASSERT_EQ(groups.size(), 2U);
+    EXPECT_EQ(groups[0].CodecName, u8"Waveform");
+    EXPECT_EQ(groups[0].MinimumFrameCount, 0U);
+    EXPECT_GE(groups[0].MaximumFrameCount, 32U);
+    EXPECT_EQ(groups[0].Latencies.CallCount, 1U);
+    EXPECT_EQ(groups[1].CodecName, u8"Waveform");
+    EXPECT_LE(groups[1].MinimumFrameCount, 1000U);
+    EXPECT_GE(groups[1].MaximumFrameCount, 1000U);
+    EXPECT_EQ(groups[1].Latencies.CallCount, 2U);
+
+    // The decoder's own statistics were never enabled
+    EXPECT_EQ(decoder.GetDecodeLatencies().CallCount, 0U);
+    EXPECT_TRUE(DecodeLatencyTracker::TakeSnapshot().empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, ExplainsPassthroughFromBorrowedMemory) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+    std::vector<std::byte> contents(static_cast<std::size_t>(file->GetSize()));
+    file->ReadAt(0, contents.size(), contents.data());
+
+    WaveformTrackDecoder decoder(
+      std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+    );
+
+    // Floats in the stored format are copied straight out of the file's memory
+    DecodePath path = decoder.ExplainDecodePath(AudioSampleFormat::Float_32, true);
+    EXPECT_TRUE(path.IsZeroCopy);
+    EXPECT_EQ(path.PassCount, 1U);
+    EXPECT_EQ(path.ScratchBufferCount, 0U);
+    EXPECT_EQ(
+      path.ToString(),
+      u8"Waveform float32 little-endian -> copy, 1 pass, no scratch buffers, zero-copy"
+    );
+
+    // Integers need to be quantized, which happens in the same single pass
+    path = decoder.ExplainDecodePath(AudioSampleFormat::SignedInteger_16, true);
+    EXPECT_TRUE(path.IsZeroCopy);
+    EXPECT_EQ(path.PassCount, 1U);
+    ASSERT_EQ(path.Steps.size(), 1U);
+    EXPECT_EQ(path.Steps[0].find(u8"Quantize"), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, ExplainsReadBufferIfFileCannotLendMemory) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    DecodePath path = decoder.ExplainDecodePath(AudioSampleFormat::Float_32, true);
+    EXPECT_FALSE(path.IsZeroCopy);
+    EXPECT_EQ(path.PassCount, 2U);
+    EXPECT_EQ(path.ScratchBufferCount, 1U);
+    EXPECT_EQ(
+      path.ToString(),
+      u8"Waveform float32 little-endian -> read -> copy, 2 passes, 1 scratch buffer"
+    );
+
+    // Separating channels while converting doesn't add a pass, it's done in the same loop
+    path = decoder.ExplainDecodePath(AudioSampleFormat::SignedInteger_24, false);
+    EXPECT_EQ(path.PassCount, 2U);
+    ASSERT_EQ(path.Steps.size(), 3U);
+    EXPECT_EQ(path.Steps[2], u8"separate");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, NegotiatesStoredFormat) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    // The file stores interleaved floats, so these should win even if listed last
+    OutputFormat format = decoder.NegotiateOutputFormat(
+      {
+        { AudioSampleFormat::SignedInteger_16, false },
+        { AudioSampleFormat::SignedInteger_16, true },
+        { AudioSampleFormat::Float_32, true }
+      }
+    );
+    EXPECT_EQ(format.SampleFormat, AudioSampleFormat::Float_32);
+    EXPECT_TRUE(format.Interleaved);
+
+    // Between equally cheap formats, the caller's order decides
+    format = decoder.NegotiateOutputFormat(
+      {
+        { AudioSampleFormat::SignedInteger_32, false },
+        { AudioSampleFormat::SignedInteger_16, false }
+      }
+    );
+    EXPECT_EQ(format.SampleFormat, AudioSampleFormat::SignedInteger_32);
+    EXPECT_FALSE(format.Interleaved);
+
+    EXPECT_THROW(decoder.NegotiateOutputFormat({}), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, SeekingIsASingleDirectJump) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    SeekCost cost = decoder.EstimateSeekCost(decoder.CountFrames() / 2);
+    EXPECT_EQ(cost.ByteCount, 0U);
+    EXPECT_EQ(cost.DiscardedFrameCount, 0U);
+    EXPECT_EQ(cost.RandomAccessCount, 1U);
+    EXPECT_TRUE(cost.IsPrecise);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, BlocksCoverWholeTrack) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    std::uint64_t frameCount = decoder.CountFrames();
+
+    // Walking the track block by block must cover every frame exactly once
+    std::uint64_t frameIndex = 0;
+    while(frameIndex < frameCount) {
+      EXPECT_EQ(decoder.GetBlockStart(frameIndex), frameIndex);
+
+      std::size_t blockSize = decoder.GetBlockSize(frameIndex);
+      ASSERT_GT(blockSize, 0U);
+      EXPECT_EQ(decoder.GetBlockStart(frameIndex + blockSize - 1), frameIndex);
+      EXPECT_EQ(decoder.GetBlockSize(frameIndex + blockSize / 2), blockSize);
+
+      frameIndex += blockSize;
+    }
+
+    EXPECT_EQ(frameIndex, frameCount);
+    EXPECT_EQ(decoder.GetBlockSize(frameCount), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, SeparatedDecodingSkipsNullChannels) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+    ASSERT_EQ(channelCount, 2U);
+
+    std::vector<float> interleavedSamples(frameCount * channelCount);
+    decoder.DecodeInterleaved(interleavedSamples.data(), 0, frameCount);
+
+    // Only ask for the right channel, the left one must not be touched
+    std::vector<float> rightSamples(frameCount);
+    float *buffers[] = { nullptr, rightSamples.data() };
+    decoder.DecodeSeparated(buffers, 0, frameCount);
+
+    for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      EXPECT_EQ(rightSamples[frameIndex], interleavedSamples[frameIndex * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, SteadyStateDecodingDoesNotAllocate) {
+    const char *fileNames[] = {
+      u8"waveform-stereo-int16le-pcmwaveformat.wav",
+      u8"waveform-stereo-float32le-pcmwaveformat.wav"
+    };
+    for(const char *fileName : fileNames) {
+      WaveformTrackDecoder decoder(
+        VirtualFile::OpenRealFileForReading(GetResourcesDirectory() + fileName)
+      );
+      ASSERT_EQ(decoder.CountChannels(), 2U);
+
+      const std::size_t chunkFrameCount = 1024;
+      ASSERT_GE(decoder.CountFrames(), chunkFrameCount * 8);
+
+      std::vector<float> interleavedSamples(chunkFrameCount * 2);
+      std::vector<float> leftSamples(chunkFrameCount);
+      std::vector<float> rightSamples(chunkFrameCount);
+      float *channels[] = { leftSamples.data(), rightSamples.data() };
+
+      // The first calls may size internal buffers, only later ones have to be allocation-free
+      decoder.DecodeInterleaved(interleavedSamples.data(), 0, chunkFrameCount);
+      decoder.DecodeSeparated(channels, chunkFrameCount, chunkFrameCount);
+
+      AllocationCounter counter;
+      for(std::size_t chunkIndex = 2; chunkIndex < 8; chunkIndex += 2) {
+        decoder.DecodeInterleaved(
+          interleavedSamples.data(), chunkIndex * chunkFrameCount, chunkFrameCount
+        );
+        decoder.DecodeSeparated(channels, (chunkIndex + 1) * chunkFrameCount, chunkFrameCount);
+      }
+      EXPECT_EQ(counter.CountAllocations(), 0U) << fileName;
+      EXPECT_EQ(counter.CountAllocatedBytes(), 0U) << fileName;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, Decodes24BitQuantizedToFloat) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<float> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    TestAudioVerifier::VerifyStereo(samples, channelCount, 44100);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, Decodes24BitQuantizedToFloatSeparated) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+
+    std::vector<float> leftSamples(frameCount);
+    std::vector<float> rightSamples(frameCount);
+    float *channels[] = { leftSamples.data(), rightSamples.data() };
+    decoder.DecodeSeparated(channels, 0, frameCount);
+
+    TestAudioVerifier::VerifyStereo(leftSamples, rightSamples, 44100);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, Decodes24BitTo16BitQuantized) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int24le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<std::int16_t> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    {
+      std::vector<float> floatSamples(frameCount * channelCount);
+      Processing::SampleConverter::Reconstruct(
+        samples.data(), 16, floatSamples.data(), samples.size()
+      );
+      TestAudioVerifier::VerifyStereo(floatSamples, channelCount, 44100);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, Decodes16BitTo32BitQuantized) {
+    std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
+      GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+    );
+
+    WaveformTrackDecoder decoder(file);
+
+    std::size_t frameCount = decoder.CountFrames();
+    std::size_t channelCount = decoder.CountChannels();
+
+    std::vector<std::int32_t> samples(frameCount * channelCount);
+    decoder.DecodeInterleaved(samples.data(), 0, frameCount);
+
+    {
+      std::vector<float> floatSamples(frameCount * channelCount);
+      Processing::SampleConverter::Reconstruct(
+        samples.data(), 32, floatSamples.data(), samples.size()
+      );
+      TestAudioVerifier::VerifyStereo(floatSamples, channelCount, 44100);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesBigEndian16BitSamples) {
+    std::vector<std::int16_t> expected;
+    std::vector<std::byte> samples;
+    for(std::size_t index = 0; index < 100; ++index) {
+      std::int16_t value = static_cast<std::int16_t>(index * 653 - 32000);
+      expected.push_back(value);
+      appendBigEndian16(samples, static_cast<std::uint16_t>(value));
+    }
+
+    std::vector<std::byte> contents = makeBigEndianWaveform(1, 2, 16, samples);
+    WaveformTrackDecoder decoder(
+      std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+    );
+    ASSERT_EQ(decoder.CountFrames(), 50U);
+
+    std::vector<std::int16_t> decoded(100);
+    decoder.DecodeInterleaved(decoded.data(), 0, 50);
+
+    EXPECT_EQ(decoded, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesBigEndian24BitSamples) {
+    std::vector<std::int32_t> expected;
+    std::vector<std::byte> samples;
+    for(std::size_t index = 0; index < 100; ++index) {
+      std::int32_t value = static_cast<std::int32_t>(index * 167773) - 8388000;
+      expected.push_back(value);
+      samples.push_back(static_cast<std::byte>(value >> 16));
+      samples.push_back(static_cast<std::byte>(value >> 8));
+      samples.push_back(static_cast<std::byte>(value));
+    }
+
+    std::vector<std::byte> contents = makeBigEndianWaveform(1, 2, 24, samples);
+    WaveformTrackDecoder decoder(
+      std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+    );
+
+    std::vector<double> decoded(100);
+    decoder.DecodeInterleaved(decoded.data(), 0, 50);
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      EXPECT_DOUBLE_EQ(decoded[index], expected[index] / 8388607.0);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, DecodesBigEndianFloatSamples) {
+    std::vector<float> expected;
+    std::vector<std::byte> samples;
+    for(std::size_t index = 0; index < 100; ++index) {
+      float value = static_cast<float>(index) / 50.0f - 1.0f;
+      expected.push_back(value);
+
+      std::uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      appendBigEndian32(samples, bits);
+    }
+
+    std::vector<std::byte> contents = makeBigEndianWaveform(3, 2, 32, samples);
+    WaveformTrackDecoder decoder(
+      std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+    );
+
+    std::vector<float> decoded(100);
+    decoder.DecodeInterleaved(decoded.data(), 0, 50);
+    EXPECT_EQ(decoded, expected);
+
+    std::vector<float> left(50), right(50);
+    float *channels[] = { left.data(), right.data() };
+    decoder.DecodeSeparated(channels, 0, 50);
+    for(std::size_t index = 0; index < 50; ++index) {
+      EXPECT_EQ(left[index], expected[index * 2]);
+      EXPECT_EQ(right[index], expected[index * 2 + 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackDecoderTest, LargeDecodesMatchPiecewiseDecodes) {
+    const std::size_t frameCount = 600000; // large enough to be split into slices
+    std::vector<std::byte> samples;
+    samples.reserve(frameCount * 2 * 3);
+    for(std::size_t index = 0; index < frameCount * 2; ++index) {
+      std::int32_t value = static_cast<std::int32_t>((index * 2654435761U) >> 8) - 8388608;
+      samples.push_back(static_cast<std::byte>(value >> 16));
+      samples.push_back(static_cast<std::byte>(value >> 8));
+      samples.push_back(static_cast<std::byte>(value));
+    }
+
+    std::vector<std::byte> contents = makeBigEndianWaveform(1, 2, 24, samples);
+    WaveformTrackDecoder decoder(
+      std::make_shared<ByteArrayAsFile>(contents.data(), contents.size())
+    );
+    std::shared_ptr<AudioTrackDecoder> piecewiseDecoder = decoder.Clone();
+
+    std::vector<float> whole(frameCount * 2);
+    decoder.DecodeInterleaved(whole.data(), 0, frameCount);
+
+    std::vector<float> pieces(frameCount * 2);
+    for(std::size_t start = 0; start < frameCount; start += 4096) {
+      std::size_t count = std::min<std::size_t>(4096, frameCount - start);
+      piecewiseDecoder->DecodeInterleaved(pieces.data() + start * 2, start, count);
+    }
+    EXPECT_EQ(whole, pieces);
+
+    std::vector<float> left(frameCount - 1), right(frameCount - 1);
+    float *channels[] = { left.data(), right.data() };
+    decoder.DecodeSeparated(channels, 1, frameCount - 1);
+    for(std::size_t index = 0; index < frameCount - 1; ++index) {
+      ASSERT_EQ(left[index], pieces[index * 2 + 2]);
+      ASSERT_EQ(right[index], pieces[index * 2 + 3]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 #if 0
   TEST(WavPackTrackDecoderTest, DecodesFloatingPointSeparated) {
     std::shared_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(
@@ -0,0 +1,612 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "../../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "Nuclex/Audio/Storage/AudioTrackEncoder.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "Nuclex/Audio/Storage/CancellationToken.h"
+#include "Nuclex/Audio/Storage/EncodingProgressListener.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that keeps its contents in memory and grows when written</summary>
+  class GrowingMemoryFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~GrowingMemoryFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->contents.size()) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      std::copy_n(this->contents.data() + start, byteCount, buffer);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start + byteCount));
+      }
+      std::copy_n(buffer, byteCount, this->contents.data() + start);
+
+      ++this->WriteCount;
+      this->LastWrittenBuffer = buffer;
+    }
+
+    /// <summary>Accesses the bytes that have been written to the file</summary>
+    /// <returns>The contents of the file</returns>
+    public: const std::vector<std::byte> &GetContents() const { return this->contents; }
+
+    /// <summary>Number of times WriteAt() has been called</summary>
+    public: std::size_t WriteCount = 0;
+    /// <summary>Buffer that was handed to the most recent WriteAt() call</summary>
+    public: const std::byte *LastWrittenBuffer = nullptr;
+
+    /// <summary>Bytes that have been written to the file</summary>
+    private: std::vector<std::byte> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that only keeps its first few bytes and forgets the rest</summary>
+  /// <remarks>
+  ///   Lets the tests write files larger than 4 GiB without needing that much memory.
+  ///   Anything beyond the retained bytes reads back as zeros.
+  /// </remarks>
+  class ForgetfulFile : public Nuclex::Audio::Storage::VirtualFile {
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: ~ForgetfulFile() override = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->size; }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::byte *buffer
+    ) const override {
+      if(start + byteCount > this->size) {
+        throw std::out_of_range(u8"Read extends beyond the end of the file");
+      }
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        if(start + index < RetainedByteCount) {
+          buffer[index] = this->retainedBytes[static_cast<std::size_t>(start + index)];
+        } else {
+          buffer[index] = std::byte(0);
+        }
+      }
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::byte *buffer
+    ) override {
+      if(start > this->size) {
+        throw std::out_of_range(u8"Write begins beyond the end of the file");
+      }
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        if(start + index >= RetainedByteCount) {
+          break;
+        }
+        this->retainedBytes[static_cast<std::size_t>(start + index)] = buffer[index];
+      }
+      if(start + byteCount > this->size) {
+        this->size = start + byteCount;
+      }
+    }
+
+    /// <summary>Accesses the bytes that have been retained from the file's start</summary>
+    /// <returns>The first bytes of the file</returns>
+    public: std::vector<std::byte> GetRetainedBytes() const {
+      return std::vector<std::byte>(
+        this->retainedBytes, this->retainedBytes + RetainedByteCount
+      );
+    }
+
+    /// <summary>Number of bytes at the beginning of the file that will be kept</summary>
+    private: static const std::size_t RetainedByteCount = 256;
+
+    /// <summary>Bytes at the beginning of the file</summary>
+    private: std::byte retainedBytes[RetainedByteCount] = {};
+    /// <summary>Apparent size of the file</summary>
+    private: std::uint64_t size = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Progress listener that records each notification it receives</summary>
+  class RecordingProgressListener : public Nuclex::Audio::Storage::EncodingProgressListener {
+
+    /// <summary>Called when the encoder has finished another block of samples</summary>
+    /// <param name="consumedFrameCount">Number of frames the encoder was fed so far</param>
+    /// <param name="writtenByteCount">Number of bytes written to the output so far</param>
+    public: void ReportProgress(
+      std::uint64_t consumedFrameCount, std::uint64_t writtenByteCount
+    ) override {
+      this->ConsumedFrameCounts.push_back(consumedFrameCount);
+      this->WrittenByteCounts.push_back(writtenByteCount);
+    }
+
+    /// <summary>Frame counts of all notifications in the order they arrived</summary>
+    public: std::vector<std::uint64_t> ConsumedFrameCounts;
+    /// <summary>Byte counts of all notifications in the order they arrived</summary>
+    public: std::vector<std::uint64_t> WrittenByteCounts;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 16-bit little endian integer from a byte array</summary>
+  /// <param name="bytes">Byte array containing the integer</param>
+  /// <param name="offset">Offset of the integer in the byte array</param>
+  /// <returns>The integer stored at the specified offset</returns>
+  std::uint16_t readUInt16(const std::vector<std::byte> &bytes, std::size_t offset) {
+    return static_cast<std::uint16_t>(
+      static_cast<std::uint16_t>(bytes[offset]) |
+      (static_cast<std::uint16_t>(bytes[offset + 1]) << 8)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32-bit little endian integer from a byte array</summary>
+  /// <param name="bytes">Byte array containing the integer</param>
+  /// <param name="offset">Offset of the integer in the byte array</param>
+  /// <returns>The integer stored at the specified offset</returns>
+  std::uint32_t readUInt32(const std::vector<std::byte> &bytes, std::size_t offset) {
+    return (
+      static_cast<std::uint32_t>(readUInt16(bytes, offset)) |
+      (static_cast<std::uint32_t>(readUInt16(bytes, offset + 2)) << 16)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 64-bit little endian integer from a byte array</summary>
+  /// <param name="bytes">Byte array containing the integer</param>
+  /// <param name="offset">Offset of the integer in the byte array</param>
+  /// <returns>The integer stored at the specified offset</returns>
+  std::uint64_t readUInt64(const std::vector<std::byte> &bytes, std::size_t offset) {
+    return (
+      static_cast<std::uint64_t>(readUInt32(bytes, offset)) |
+      (static_cast<std::uint64_t>(readUInt32(bytes, offset + 4)) << 32)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio { namespace Storage { namespace Waveform {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, BuildThrowsExceptionWithoutInputChannels) {
+    WaveformTrackEncoderBuilder builder;
+    builder.SetSampleRate(48000);
+
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+    EXPECT_THROW(builder.Build(file), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, RejectsDuplicateChannels) {
+    WaveformTrackEncoderBuilder builder;
+    EXPECT_THROW(
+      builder.SetChannels({ ChannelPlacement::FrontLeft, ChannelPlacement::FrontLeft }),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, WritesMatchingSamplesWithoutCopying) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(44100).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_16).
+      Build(file);
+
+    std::vector<std::int16_t> samples(1000 * 2);
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      samples[index] = static_cast<std::int16_t>(index * 31 - 30000);
+    }
+
+    std::size_t writeCountBeforeEncoding = file->WriteCount;
+    encoder->EncodeInterleaved(samples.data(), 1000);
+    EXPECT_EQ(file->WriteCount, writeCountBeforeEncoding + 1);
+#if defined(NUCLEX_AUDIO_LITTLE_ENDIAN)
+    EXPECT_EQ(file->LastWrittenBuffer, reinterpret_cast<const std::byte *>(samples.data()));
+#endif
+
+    // Flushing should only need to update the header
+    std::size_t writeCountBeforeFlush = file->WriteCount;
+    encoder->Flush();
+    EXPECT_EQ(file->WriteCount, writeCountBeforeFlush + 1);
+
+    const std::vector<std::byte> &contents = file->GetContents();
+    ASSERT_EQ(contents.size(), 80U + 4000U);
+    EXPECT_EQ(readUInt32(contents, 4), 72U + 4000U); // RIFF chunk size
+    EXPECT_EQ(readUInt32(contents, 16), 28U); // 'JUNK' chunk reserving room for 'ds64'
+    EXPECT_EQ(readUInt16(contents, 56), 1U); // WAVE_FORMAT_PCM
+    EXPECT_EQ(readUInt32(contents, 76), 4000U); // 'data' chunk size
+
+    WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), 1000U);
+
+    std::vector<std::int16_t> decoded(1000 * 2);
+    decoder.DecodeInterleaved(decoded.data(), 0, 1000);
+    EXPECT_EQ(decoded, samples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, ReordersSurroundChannelsIntoWaveformOrder) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    // Vorbis-style 5.1 order, which differs from the Waveform order
+    std::vector<ChannelPlacement> inputChannelOrder = {
+      ChannelPlacement::FrontLeft, ChannelPlacement::FrontCenter,
+      ChannelPlacement::FrontRight, ChannelPlacement::BackLeft,
+      ChannelPlacement::BackRight, ChannelPlacement::LowFrequencyEffects
+    };
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetChannels(inputChannelOrder).
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_24).
+      Build(file);
+
+    // Only the upper 24 bits are stored, the decoder fills the lower 8 bits again
+    const std::size_t frameCount = 5000;
+    std::vector<std::int32_t> samples(frameCount * 6);
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      samples[index] = static_cast<std::int32_t>((index * 2654435761u) & 0xFFFFFF00u);
+    }
+
+    encoder->EncodeInterleaved(samples.data(), frameCount);
+    encoder->Flush();
+
+    const std::vector<std::byte> &contents = file->GetContents();
+    EXPECT_EQ(readUInt16(contents, 56), 65534U); // WAVE_FORMAT_EXTENSIBLE
+    EXPECT_EQ(readUInt32(contents, 76), 0x3FU); // channel mask
+
+    WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), frameCount);
+    ASSERT_EQ(decoder.GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_24);
+
+    const std::vector<ChannelPlacement> &decodedOrder = decoder.GetChannelOrder();
+    ASSERT_EQ(decodedOrder.size(), 6U);
+
+    std::vector<std::int32_t> decoded(frameCount * 6);
+    decoder.DecodeInterleaved(decoded.data(), 0, frameCount);
+
+    for(std::size_t channelIndex = 0; channelIndex < 6; ++channelIndex) {
+      std::size_t inputChannelIndex = static_cast<std::size_t>(
+        std::find(
+          inputChannelOrder.begin(), inputChannelOrder.end(), decodedOrder[channelIndex]
+        ) - inputChannelOrder.begin()
+      );
+      ASSERT_LT(inputChannelIndex, 6U);
+      for(std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        ASSERT_EQ(
+          decoded[frameIndex * 6 + channelIndex] >> 8,
+          samples[frameIndex * 6 + inputChannelIndex] >> 8
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, EncodesSeparatedFloatChannels) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::Float_32).
+      Build(file);
+
+    const std::size_t frameCount = 9000;
+    std::vector<float> left(frameCount), right(frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      left[index] = static_cast<float>(index) / static_cast<float>(frameCount);
+      right[index] = -left[index];
+    }
+
+    const float *channels[] = { left.data(), right.data() };
+    encoder->EncodeSeparated(channels, frameCount);
+    encoder->Flush();
+
+    const std::vector<std::byte> &contents = file->GetContents();
+    EXPECT_EQ(readUInt32(contents, 104), frameCount); // 'fact' sample count
+
+    WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), frameCount);
+    ASSERT_EQ(decoder.GetNativeSampleFormat(), AudioSampleFormat::Float_32);
+
+    std::vector<float> decoded(frameCount * 2);
+    decoder.DecodeInterleaved(decoded.data(), 0, frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      ASSERT_EQ(decoded[index * 2], left[index]);
+      ASSERT_EQ(decoded[index * 2 + 1], right[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, RoundTripsPackedInt24Samples) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_24).
+      Build(file);
+
+    // More frames than the encoder unpacks in one chunk so it has to loop
+    const std::size_t frameCount = 5000;
+    std::vector<PackedInt24> left(frameCount), right(frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      std::uint32_t bits = static_cast<std::uint32_t>(index * 2654435761u);
+      for(std::size_t byteIndex = 0; byteIndex < 3; ++byteIndex) {
+        left[index].Bytes[byteIndex] = static_cast<std::byte>(bits >> (byteIndex * 8));
+        right[index].Bytes[byteIndex] = static_cast<std::byte>(bits >> (byteIndex * 8 + 8));
+      }
+    }
+
+    const PackedInt24 *channels[] = { left.data(), right.data() };
+    encoder->EncodeSeparated(channels, frameCount);
+    encoder->Flush();
+
+    WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), frameCount);
+    ASSERT_EQ(decoder.GetNativeSampleFormat(), AudioSampleFormat::SignedInteger_24);
+
+    std::vector<PackedInt24> decoded(frameCount * 2);
+    decoder.DecodeInterleaved(decoded.data(), 0, frameCount);
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      for(std::size_t byteIndex = 0; byteIndex < 3; ++byteIndex) {
+        ASSERT_EQ(decoded[index * 2].Bytes[byteIndex], left[index].Bytes[byteIndex]);
+        ASSERT_EQ(decoded[index * 2 + 1].Bytes[byteIndex], right[index].Bytes[byteIndex]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, PadsOddSizedDataChunk) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetChannels({ ChannelPlacement::FrontCenter }).
+      SetSampleRate(8000).
+      SetSampleFormat(AudioSampleFormat::UnsignedInteger_8).
+      Build(file);
+
+    std::vector<std::uint8_t> samples(1001);
+    for(std::size_t index = 0; index < samples.size(); ++index) {
+      samples[index] = static_cast<std::uint8_t>(index);
+    }
+    encoder->EncodeInterleaved(samples.data(), samples.size());
+    encoder->Flush();
+
+    const std::vector<std::byte> &contents = file->GetContents();
+    ASSERT_EQ(contents.size(), 80U + 1002U);
+    EXPECT_EQ(readUInt32(contents, 4), 72U + 1002U); // RIFF size includes the pad byte
+    EXPECT_EQ(readUInt32(contents, 76), 1001U); // 'data' chunk size does not
+
+    WaveformTrackDecoder decoder(file);
+    ASSERT_EQ(decoder.CountFrames(), 1001U);
+
+    std::vector<std::uint8_t> decoded(1001);
+    decoder.DecodeInterleaved(decoded.data(), 0, 1001);
+    EXPECT_EQ(decoded, samples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, SwitchesToRf64BeyondFourGigabytes) {
+    std::shared_ptr<ForgetfulFile> file = std::make_shared<ForgetfulFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_16).
+      Build(file);
+
+    // 70 pieces of 64 MiB each add up to 4.375 GiB of audio data
+    const std::size_t pieceFrameCount = 16 * 1024 * 1024;
+    const std::size_t pieceCount = 70;
+    std::vector<std::int16_t> samples(pieceFrameCount * 2);
+    for(std::size_t index = 0; index < pieceCount; ++index) {
+      encoder->EncodeInterleaved(samples.data(), pieceFrameCount);
+    }
+    encoder->Flush();
+
+    std::uint64_t frameCount = static_cast<std::uint64_t>(pieceFrameCount) * pieceCount;
+    std::uint64_t dataByteCount = frameCount * 4;
+
+    std::vector<std::byte> header = file->GetRetainedBytes();
+    EXPECT_EQ(header[0], std::byte(0x52)); // R
+    EXPECT_EQ(header[1], std::byte(0x46)); // F
+    EXPECT_EQ(header[2], std::byte(0x36)); // 6
+    EXPECT_EQ(header[3], std::byte(0x34)); // 4
+    EXPECT_EQ(readUInt32(header, 4), 0xFFFFFFFFU);
+    EXPECT_EQ(header[12], std::byte(0x64)); // d
+    EXPECT_EQ(header[13], std::byte(0x73)); // s
+    EXPECT_EQ(readUInt64(header, 20), 72U + dataByteCount); // RIFF size
+    EXPECT_EQ(readUInt64(header, 28), dataByteCount); // 'data' chunk size
+    EXPECT_EQ(readUInt64(header, 36), frameCount); // sample count
+    EXPECT_EQ(readUInt32(header, 76), 0xFFFFFFFFU); // 32-bit 'data' chunk size
+    EXPECT_EQ(file->GetSize(), 80U + dataByteCount);
+
+    WaveformTrackDecoder decoder(file);
+    EXPECT_EQ(decoder.CountFrames(), frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, ReportsProgressBetweenBlocks) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_16).
+      Build(file);
+
+    std::shared_ptr<RecordingProgressListener> listener = (
+      std::make_shared<RecordingProgressListener>()
+    );
+    encoder->SetProgressListener(listener);
+
+    // 40000 frames are more than two blocks, so there should be three notifications
+    std::vector<std::int16_t> samples(40000 * 2);
+    encoder->EncodeInterleaved(samples.data(), 40000);
+
+    std::vector<std::uint64_t> expectedFrameCounts = { 16384, 32768, 40000 };
+    EXPECT_EQ(listener->ConsumedFrameCounts, expectedFrameCounts);
+    ASSERT_EQ(listener->WrittenByteCounts.size(), 3U);
+    EXPECT_GE(listener->WrittenByteCounts[2], 40000U * 4U);
+    EXPECT_EQ(encoder->CountConsumedFrames(), 40000U);
+
+    encoder->Flush();
+
+    WaveformTrackDecoder decoder(file);
+    EXPECT_EQ(decoder.CountFrames(), 40000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, StopsEncodingWhenCancelled) {
+    std::shared_ptr<GrowingMemoryFile> file = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(48000).
+      SetSampleFormat(AudioSampleFormat::Float_32).
+      Build(file);
+
+    std::shared_ptr<CancellationToken> token = std::make_shared<CancellationToken>();
+    encoder->SetCancellationToken(token);
+
+    std::vector<float> left(1000), right(1000);
+    const float *buffers[] = { left.data(), right.data() };
+    encoder->EncodeSeparated(buffers, 1000);
+    EXPECT_EQ(encoder->CountConsumedFrames(), 1000U);
+
+    token->Cancel();
+    EXPECT_THROW(encoder->EncodeSeparated(buffers, 1000), Errors::CancelledError);
+    EXPECT_EQ(encoder->CountConsumedFrames(), 1000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WaveformTrackEncoderTest, CanBeReopenedOnAnotherFile) {
+    std::shared_ptr<GrowingMemoryFile> first = std::make_shared<GrowingMemoryFile>();
+    std::shared_ptr<GrowingMemoryFile> second = std::make_shared<GrowingMemoryFile>();
+
+    WaveformTrackEncoderBuilder builder;
+    std::shared_ptr<AudioTrackEncoder> encoder = builder.
+      SetStereoChannels().
+      SetSampleRate(44100).
+      SetSampleFormat(AudioSampleFormat::SignedInteger_16).
+      Build(first);
+
+    std::vector<std::int16_t> firstSamples(1000 * 2, 1111);
+    encoder->EncodeInterleaved(firstSamples.data(), 1000);
+    encoder->Flush();
+
+    ASSERT_TRUE(encoder->TryReopen(second));
+    EXPECT_EQ(encoder->CountConsumedFrames(), 0U);
+
+    std::vector<std::int16_t> secondSamples(300 * 2, -2222);
+    encoder->EncodeInterleaved(secondSamples.data(), 300);
+    encoder->Flush();
+    EXPECT_EQ(encoder->CountConsumedFrames(), 300U);
+
+    // Both files must be complete on their own
+    WaveformTrackDecoder firstDecoder(first);
+    ASSERT_EQ(firstDecoder.CountFrames(), 1000U);
+    std::vector<std::int16_t> decoded(1000 * 2);
+    firstDecoder.DecodeInterleaved(decoded.data(), 0, 1000);
+    EXPECT_EQ(decoded, firstSamples);
+
+    WaveformTrackDecoder secondDecoder(second);
+    ASSERT_EQ(secondDecoder.CountFrames(), 300U);
+    decoded.resize(300 * 2);
+    secondDecoder.DecodeInterleaved(decoded.data(), 0, 300);
+    EXPECT_EQ(decoded, secondSamples);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Audio::Storage::Waveform
@@ -0,0 +1,139 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Storage/WritableMemoryFile.h"
+#include "Nuclex/Audio/Storage/LosslessTranscoder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackEncoderBuilder.h"
+#include "../../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "./ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Audio { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WritableMemoryFileTest, EstimateCoversBitrateTimesDuration) {
+    std::size_t byteCount = WritableMemoryFile::EstimateByteCount(128000, 60.0);
+    EXPECT_GE(byteCount, 128000U / 8U * 60U);
+    EXPECT_LT(byteCount, 128000U / 8U * 60U * 2U);
+
+    EXPECT_GT(WritableMemoryFile::EstimateByteCount(0, 0.0), 0U);
+    EXPECT_THROW(WritableMemoryFile::EstimateByteCount(128000, -1.0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WritableMemoryFileTest, GrowsGeometrically) {
+    WritableMemoryFile file;
+    EXPECT_EQ(file.GetSize(), 0U);
+    EXPECT_EQ(file.GetCapacity(), 0U);
+
+    // Appending a megabyte in small pieces should reallocate only a few times
+    std::vector<std::byte> page(100, std::byte(0x5a));
+    std::size_t reallocationCount = 0;
+    std::size_t previousCapacity = file.GetCapacity();
+    for(std::size_t index = 0; index < 10000; ++index) {
+      file.WriteAt(file.GetSize(), page.size(), page.data());
+      if(file.GetCapacity() != previousCapacity) {
+        previousCapacity = file.GetCapacity();
+        ++reallocationCount;
+      }
+    }
+
+    EXPECT_EQ(file.GetSize(), 1000000U);
+    EXPECT_LE(reallocationCount, 10U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WritableMemoryFileTest, ReservedCapacityAvoidsReallocation) {
+    WritableMemoryFile file(1000);
+    ASSERT_EQ(file.GetCapacity(), 1000U);
+
+    std::vector<std::byte> data(1000, std::byte(1));
+    file.WriteAt(0, data.size(), data.data());
+    EXPECT_EQ(file.GetCapacity(), 1000U);
+
+    file.Reserve(500);
+    EXPECT_EQ(file.GetCapacity(), 1000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WritableMemoryFileTest, WritingPastEndFillsGapWithZeros) {
+    WritableMemoryFile file;
+
+    const std::byte marker[] = { std::byte(0xff), std::byte(0xee) };
+    file.WriteAt(10, 2, marker);
+    ASSERT_EQ(file.GetSize(), 12U);
+
+    const std::byte *contents = file.TryBorrowAt(0, 12);
+    ASSERT_NE(contents, nullptr);
+    for(std::size_t index = 0; index < 10; ++index) {
+      EXPECT_EQ(contents[index], std::byte(0));
+    }
+    EXPECT_EQ(contents[10], std::byte(0xff));
+    EXPECT_EQ(contents[11], std::byte(0xee));
+
+    EXPECT_EQ(file.TryBorrowAt(8, 5), nullptr);
+
+    std::byte buffer[4];
+    EXPECT_THROW(file.ReadAt(10, 4, buffer), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WritableMemoryFileTest, EncodedContentsCanBeTakenAndDecoded) {
+    Waveform::WaveformTrackDecoder source(
+      VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-int16le-pcmwaveformat.wav"
+      )
+    );
+    std::shared_ptr<WritableMemoryFile> target = std::make_shared<WritableMemoryFile>(
+      WritableMemoryFile::EstimateByteCount(
+        44100 * 16 * 2, static_cast<double>(source.CountFrames()) / 44100.0
+      )
+    );
+    std::size_t reservedCapacity = target->GetCapacity();
+
+    Waveform::WaveformTrackEncoderBuilder builder;
+    builder.SetSampleRate(44100);
+    std::uint64_t frameCount = LosslessTranscoder::Transcode(source, builder, target);
+    EXPECT_EQ(target->GetCapacity(), reservedCapacity);
+
+    std::size_t length = 0;
+    std::shared_ptr<const std::byte[]> contents = target->TakeContents(length);
+    EXPECT_EQ(target->GetSize(), 0U);
+    EXPECT_EQ(target->GetCapacity(), 0U);
+
+    Waveform::WaveformTrackDecoder result(VirtualFile::FromMemory(contents, length));
+    EXPECT_EQ(result.CountFrames(), frameCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Audio::Storage
@@ -0,0 +1,135 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/TraceListener.h"
+#include "Nuclex/Audio/Processing/ConversionKernels.h"
+#include "Nuclex/Audio/Storage/VirtualFile.h"
+#include "../Source/Storage/Waveform/WaveformTrackDecoder.h"
+
+#include "./Storage/ResourceDirectoryLocator.h"
+
+#include <gtest/gtest.h>
+
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Trace listener that records the zones and markers it receives</summary>
+  class RecordingTraceListener : public Nuclex::Audio::TraceListener {
+
+    /// <summary>Installs the listener for as long as it is alive</summary>
+    public: RecordingTraceListener() { Install(this); }
+    /// <summary>Uninstalls the listener again before it is destroyed</summary>
+    public: ~RecordingTraceListener() override { Install(nullptr); }
+
+    /// <summary>Records the beginning of a zone</summary>
+    /// <param name="name">Static name describing the kind of work</param>
+    /// <param name="trackId">Id of the decoder or encoder doing the work</param>
+    public: void BeginZone(
+      const char *name, std::uintptr_t, std::uintptr_t trackId
+    ) override {
+      this->Events.push_back(std::string(u8"+") + name);
+      if(std::string(name) == u8"Decode Waveform") {
+        this->DecoderId = trackId;
+      }
+    }
+
+    /// <summary>Records the end of a zone</summary>
+    /// <param name="name">Static name the zone was begun with</param>
+    public: void EndZone(const char *name, std::uintptr_t, std::uintptr_t) override {
+      this->Events.push_back(std::string(u8"-") + name);
+    }
+
+    /// <summary>Records a marker</summary>
+    /// <param name="name">Static name describing the event</param>
+    public: void Mark(const char *name, std::uintptr_t, std::uintptr_t) override {
+      this->Events.push_back(std::string(u8"!") + name);
+    }
+
+    /// <summary>Zones and markers in the order they were reported</summary>
+    public: std::vector<std::string> Events;
+    /// <summary>Track id the decoding zone was reported with</summary>
+    public: std::uintptr_t DecoderId = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TraceListenerTest, NoListenerIsInstalledByDefault) {
+    EXPECT_EQ(TraceListener::GetInstalled(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TraceListenerTest, DecodingIsReportedAsZone) {
+    std::shared_ptr<const Storage::VirtualFile> file = (
+      Storage::VirtualFile::OpenRealFileForReading(
+        GetResourcesDirectory() + u8"waveform-stereo-float32le-pcmwaveformat.wav"
+      )
+    );
+    Storage::Waveform::WaveformTrackDecoder decoder(file);
+    std::vector<float> samples(256 * decoder.CountChannels());
+
+    RecordingTraceListener listener;
+    ASSERT_EQ(TraceListener::GetInstalled(), &listener);
+    decoder.DecodeInterleaved(samples.data(), 0, 256);
+
+    if(TraceListener::IsSupported()) {
+      ASSERT_GE(listener.Events.size(), 2U);
+      EXPECT_EQ(listener.Events.front(), u8"+Decode Waveform");
+      EXPECT_EQ(listener.Events.back(), u8"-Decode Waveform");
+      EXPECT_EQ(listener.DecoderId, reinterpret_cast<std::uintptr_t>(&decoder));
+    } else {
+      EXPECT_TRUE(listener.Events.empty());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TraceListenerTest, ConversionKernelsAreReportedAsZone) {
+    float values[4] = { 0.0f, 0.25f, 0.5f, 1.0f };
+    std::int32_t results[4];
+
+    RecordingTraceListener listener;
+    Processing::ConversionKernels::MultiplyToNearestInt32(values, 4.0f, results, 4);
+
+    if(TraceListener::IsSupported()) {
+      std::vector<std::string> expected = { u8"+Convert samples", u8"-Convert samples" };
+      EXPECT_EQ(listener.Events, expected);
+    } else {
+      EXPECT_TRUE(listener.Events.empty());
+    }
+    EXPECT_EQ(results[3], 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio
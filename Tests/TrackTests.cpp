@@ -0,0 +1,143 @@
+#pragma region Apache License 2.0
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2024 Markus Ewald / Nuclex Development Labs
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma endregion // Apache License 2.0
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_AUDIO_SOURCE 1
+
+#include "Nuclex/Audio/Track.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Audio {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, HasDefaultConstructor) {
+    Track track;
+    EXPECT_EQ(track.CountChannels(), 0U);
+    EXPECT_EQ(track.CountFrames(), 0U);
+    EXPECT_EQ(track.GetSamples(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, RequiresMatchingChannelOrder) {
+    EXPECT_THROW(Track track(0, 100, 44100), std::invalid_argument);
+    EXPECT_THROW(
+      Track track(2, 100, 44100, SampleLayout::Interleaved, { ChannelPlacement::FrontLeft }),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, InterleavedChannelsShareMemory) {
+    Track track(3, 10, 48000);
+    ASSERT_EQ(track.CountChannels(), 3U);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(track.GetSamples()) % 64, 0U);
+
+    for(std::size_t index = 0; index < 30; ++index) {
+      track.GetSamples()[index] = static_cast<float>(index);
+    }
+
+    Channel<float> second = track.GetChannel(1);
+    EXPECT_EQ(second.CountFrames(), 10U);
+    EXPECT_EQ(second.GetStride(), 3U);
+    EXPECT_EQ(second[0], 1.0f);
+    EXPECT_EQ(second[4], 13.0f);
+    EXPECT_EQ(second.GetNativeSampleFormat(), AudioSampleFormat::Float_32);
+
+    EXPECT_THROW(track.GetChannel(3), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, SeparatedChannelsAreAligned) {
+    Track track(
+      2, 37, 44100, SampleLayout::Separated,
+      { ChannelPlacement::FrontLeft, ChannelPlacement::FrontRight }
+    );
+    ASSERT_EQ(track.CountFrames(), 37U);
+    EXPECT_EQ(track.GetChannelSpacing() % 16, 0U);
+    EXPECT_GE(track.GetChannelSpacing(), 37U);
+
+    const Track &constantTrack = track;
+    for(std::size_t index = 0; index < 2; ++index) {
+      Channel<const float> channel = constantTrack.GetChannel(index);
+      EXPECT_EQ(channel.GetStride(), 1U);
+      EXPECT_EQ(reinterpret_cast<std::uintptr_t>(channel.GetSamples()) % 64, 0U);
+    }
+    EXPECT_EQ(track.GetChannel(1).GetPlacement(), ChannelPlacement::FrontRight);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, CanBeMoved) {
+    Track track(1, 100, 22050);
+    float *samples = track.GetSamples();
+
+    Track other(std::move(track));
+    EXPECT_EQ(other.GetSamples(), samples);
+    EXPECT_EQ(other.GetSampleRate(), 22050U);
+    EXPECT_EQ(track.GetSamples(), nullptr);
+
+    track = std::move(other);
+    EXPECT_EQ(track.GetSamples(), samples);
+    EXPECT_EQ(other.GetSamples(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TrackTest, ClonesShareSamplesUntilModified) {
+    Track track(2, 50, 44100, SampleLayout::Separated);
+    track.SetName(u8"Original");
+    for(std::size_t index = 0; index < track.GetChannelSpacing() * 2; ++index) {
+      track.GetSamples()[index] = static_cast<float>(index);
+    }
+    EXPECT_FALSE(track.IsShared());
+
+    Track clone = track.Clone();
+    EXPECT_TRUE(track.IsShared());
+    EXPECT_TRUE(clone.IsShared());
+    EXPECT_EQ(clone.CountChannels(), 2U);
+    EXPECT_EQ(clone.CountFrames(), 50U);
+    EXPECT_EQ(clone.GetLayout(), SampleLayout::Separated);
+    EXPECT_EQ(clone.GetName().value(), u8"Original");
+
+    const Track &constantClone = clone;
+    EXPECT_EQ(constantClone.GetSamples(), static_cast<const Track &>(track).GetSamples());
+    EXPECT_TRUE(track.IsShared());
+
+    Channel<float> channel = clone.GetChannel(1);
+    EXPECT_FALSE(track.IsShared());
+    EXPECT_FALSE(clone.IsShared());
+    EXPECT_NE(constantClone.GetSamples(), static_cast<const Track &>(track).GetSamples());
+
+    channel[3] = -1.0f;
+    EXPECT_EQ(channel[0], static_cast<float>(track.GetChannelSpacing()));
+    EXPECT_EQ(track.GetChannel(1)[3], static_cast<float>(track.GetChannelSpacing() + 3));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Audio